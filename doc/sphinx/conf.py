@@ -95,6 +95,8 @@ exclude_patterns = [
     'arm/hooks-lease-cmds.rst',
     'arm/hooks-lease-query.rst',
     'arm/hooks-limits.rst',
+    'arm/hooks-packet-trace.rst',
+    'arm/hooks-ping-check.rst',
     'arm/hooks-radius.rst',
     'arm/hooks-rbac.rst',
     'arm/hooks-run-script.rst',
@@ -214,6 +216,7 @@ man_pages = [
     ('man/kea-dhcp4.8', 'kea-dhcp4', 'DHCPv4 server in Kea', author, 8),
     ('man/kea-dhcp6.8', 'kea-dhcp6', 'DHCPv6 server in Kea', author, 8),
     ('man/kea-dhcp-ddns.8', 'kea-dhcp-ddns', 'DHCP-DDNS process in Kea', author, 8),
+    ('man/kea-lease-migrate.8', 'kea-lease-migrate', 'Lease migration tool in Kea', author, 8),
     ('man/kea-lfc.8', 'kea-lfc', 'Lease File Cleanup process in Kea', author, 8),
     ('man/kea-netconf.8', 'kea-netconf', 'NETCONF agent for configuring Kea', author, 8),
     ('man/kea-shell.8', 'kea-shell', 'Text client for Control Agent process', author, 8),
@@ -3,6 +3,7 @@ man8s += $(sphinxbuilddir)/man/kea-ctrl-agent.8
 man8s += $(sphinxbuilddir)/man/kea-dhcp4.8
 man8s += $(sphinxbuilddir)/man/kea-dhcp6.8
 man8s += $(sphinxbuilddir)/man/kea-dhcp-ddns.8
+man8s += $(sphinxbuilddir)/man/kea-lease-migrate.8
 man8s += $(sphinxbuilddir)/man/kea-lfc.8
 man8s += $(sphinxbuilddir)/man/kea-netconf.8
 man8s += $(sphinxbuilddir)/man/kea-shell.8
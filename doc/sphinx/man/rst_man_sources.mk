@@ -3,6 +3,7 @@ rst_man_sources += man/kea-ctrl-agent.8.rst
 rst_man_sources += man/kea-dhcp4.8.rst
 rst_man_sources += man/kea-dhcp6.8.rst
 rst_man_sources += man/kea-dhcp-ddns.8.rst
+rst_man_sources += man/kea-lease-migrate.8.rst
 rst_man_sources += man/kea-lfc.8.rst
 rst_man_sources += man/kea-netconf.8.rst
 rst_man_sources += man/kea-shell.8.rst
@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -65,15 +65,16 @@ CtrlAgentCommandMgr::handleCommand(const std::string& cmd_name,
                                    const isc::data::ConstElementPtr& params,
                                    const isc::data::ConstElementPtr& original_cmd) {
 
+    // The command manager is shared by the threads handling the requests
+    // so the remote address is kept locally.
+    std::string remote_addr = "(unknown)";
     ConstElementPtr raddr_ptr = original_cmd->get("remote-address");
     if (raddr_ptr && (raddr_ptr->getType() == Element::string)) {
-        remote_addr_ = raddr_ptr->stringValue();
-    } else {
-        remote_addr_ = "(unknown)";
+        remote_addr = raddr_ptr->stringValue();
     }
     LOG_INFO(agent_logger, CTRL_AGENT_COMMAND_RECEIVED)
         .arg(cmd_name)
-        .arg(remote_addr_);
+        .arg(remote_addr);
 
     ConstElementPtr services = Element::createList();
 
@@ -165,7 +166,7 @@ CtrlAgentCommandMgr::handleCommand(const std::string& cmd_name,
                     .arg(cmd_name).arg(services->get(i)->stringValue());
 
                 answer = forwardCommand(services->get(i)->stringValue(),
-                                        cmd_name, original_cmd);
+                                        cmd_name, original_cmd, remote_addr);
 
             } catch (const CommandForwardingError& ex) {
                 LOG_DEBUG(agent_logger, isc::log::DBGLVL_COMMAND,
@@ -181,10 +182,21 @@ CtrlAgentCommandMgr::handleCommand(const std::string& cmd_name,
     return (answer_list);
 }
 
+bool
+CtrlAgentCommandMgr::isLocalCommand(const isc::data::ConstElementPtr& cmd) {
+    if (!cmd || (cmd->getType() != Element::map)) {
+        return (true);
+    }
+    ConstElementPtr services = cmd->get("service");
+    return (!services || (services->getType() != Element::list) ||
+            services->empty());
+}
+
 ConstElementPtr
 CtrlAgentCommandMgr::forwardCommand(const std::string& service,
                                     const std::string& cmd_name,
-                                    const isc::data::ConstElementPtr& command) {
+                                    const isc::data::ConstElementPtr& command,
+                                    const std::string& remote_addr) {
     // Context will hold the server configuration.
     CtrlAgentCfgContextPtr ctx;
 
@@ -263,7 +275,7 @@ CtrlAgentCommandMgr::forwardCommand(const std::string& service,
         LOG_INFO(agent_logger, CTRL_AGENT_COMMAND_FORWARDED)
             .arg(cmd_name)
             .arg(service)
-            .arg(remote_addr_);
+            .arg(remote_addr);
 
     } catch (const std::exception& ex) {
         isc_throw(CommandForwardingError, "internal server error: unable to parse"
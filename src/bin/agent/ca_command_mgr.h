@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -86,6 +86,16 @@ public:
                   const isc::data::ConstElementPtr& params,
                   const isc::data::ConstElementPtr& original_cmd);
 
+    /// @brief Checks if a command is processed by the Control Agent itself.
+    ///
+    /// It is when it has no 'service' parameter or when this parameter
+    /// is not a non-empty list.
+    ///
+    /// @param cmd Pointer to the data element representing command in JSON
+    /// format.
+    /// @return true if the command is not forwarded.
+    static bool isLocalCommand(const isc::data::ConstElementPtr& cmd);
+
 private:
 
     /// @brief Tries to forward received control command to a specified server.
@@ -94,22 +104,20 @@ private:
     /// forwarded.
     /// @param cmd_name Command name.
     /// @param command Pointer to the object representing the forwarded command.
+    /// @param remote_addr Remote address of HTTP endpoint.
     ///
     /// @return Response to forwarded command.
     /// @throw CommandForwardingError when an error occurred during forwarding.
     isc::data::ConstElementPtr
     forwardCommand(const std::string& service, const std::string& cmd_name,
-                   const isc::data::ConstElementPtr& command);
+                   const isc::data::ConstElementPtr& command,
+                   const std::string& remote_addr);
 
     /// @brief Private constructor.
     ///
     /// The instance should be created using @ref CtrlAgentCommandMgr::instance,
     /// thus the constructor is private.
     CtrlAgentCommandMgr();
-
-    /// @brief Remote address of HTTP endpoint.
-    std::string remote_addr_;
-
 };
 
 } // end of namespace isc::agent
@@ -11,6 +11,9 @@
 #include <agent/ca_command_mgr.h>
 #include <agent/parser_context.h>
 #include <process/cfgrpt/config_report.h>
+
+#include <boost/lexical_cast.hpp>
+
 #include <functional>
 
 using namespace isc::process;
@@ -42,7 +45,10 @@ DProcessBase*
 CtrlAgentController::createProcess() {
     // Instantiate and return an instance of the D2 application process. Note
     // that the process is passed the controller's io_service.
-    return (new CtrlAgentProcess(getAppName().c_str(), getIOService()));
+    CtrlAgentProcess* process = new CtrlAgentProcess(getAppName().c_str(),
+                                                     getIOService());
+    process->setThreadPoolSize(thread_pool_size_);
+    return (process);
 }
 
 isc::data::ConstElementPtr
@@ -95,7 +101,33 @@ CtrlAgentController::deregisterCommands() {
 }
 
 CtrlAgentController::CtrlAgentController()
-    : DControllerBase(agent_app_name_, agent_bin_name_) {
+    : DControllerBase(agent_app_name_, agent_bin_name_),
+      thread_pool_size_(0) {
+}
+
+bool
+CtrlAgentController::customOption(int option, char* optarg) {
+    if (option != 'T') {
+        return (false);
+    }
+    try {
+        int size = boost::lexical_cast<int>(optarg ? optarg : "");
+        if ((size < 0) || (size > 65535)) {
+            isc_throw(BadValue, "out of range");
+        }
+        thread_pool_size_ = static_cast<uint16_t>(size);
+    } catch (const std::exception&) {
+        isc_throw(InvalidUsage, "invalid number of threads: "
+                  << (optarg ? optarg : ""));
+    }
+    return (true);
+}
+
+const std::string
+CtrlAgentController::getUsageText() const {
+    return ("  -T <number of threads> : optional, handle the HTTP requests"
+            " in a pool of threads\n    (0, the default, handles them in the"
+            " main thread)");
 }
 
 CtrlAgentController::~CtrlAgentController() {
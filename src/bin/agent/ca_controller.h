@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -57,6 +57,32 @@ public:
     /// @brief Deregister commands.
     void deregisterCommands();
 
+    /// @brief Returns the number of threads handling the HTTP requests.
+    ///
+    /// @return the value of the -T command line option, 0 (the default)
+    /// means that the requests are handled by the main thread.
+    uint16_t getThreadPoolSize() const {
+        return (thread_pool_size_);
+    }
+
+protected:
+
+    /// @brief Handles the -T command line option.
+    ///
+    /// @param option the option character.
+    /// @param optarg the number of threads handling the HTTP requests.
+    /// @return true if the option is -T.
+    /// @throw InvalidUsage if the number of threads is not valid.
+    virtual bool customOption(int option, char* optarg);
+
+    /// @brief Returns the usage text of the -T command line option.
+    virtual const std::string getUsageText() const;
+
+    /// @brief Returns the -T command line option.
+    virtual const std::string getCustomOpts() const {
+        return ("T:");
+    }
+
 private:
 
     /// @brief Creates an instance of the Control Agent application
@@ -74,6 +100,9 @@ private:
     /// @brief Constructor is declared private to maintain the integrity of
     /// the singleton instance.
     CtrlAgentController();
+
+    /// @brief The number of threads handling the HTTP requests.
+    uint16_t thread_pool_size_;
 };
 
 // @Defines a shared pointer to CtrlAgentController
@@ -14,13 +14,16 @@
 #include <asiolink/io_error.h>
 #include <cc/command_interpreter.h>
 #include <config/timeouts.h>
+#include <util/multi_threading_mgr.h>
 #include <boost/pointer_cast.hpp>
+#include <memory>
 
 using namespace isc::asiolink;
 using namespace isc::config;
 using namespace isc::data;
 using namespace isc::http;
 using namespace isc::process;
+using namespace isc::util;
 
 
 namespace isc {
@@ -29,10 +32,15 @@ namespace agent {
 CtrlAgentProcess::CtrlAgentProcess(const char* name,
                                    const asiolink::IOServicePtr& io_service)
     : DProcessBase(name, io_service, DCfgMgrBasePtr(new CtrlAgentCfgMgr())),
-      http_listeners_() {
+      http_listeners_(), thread_pool_size_(0), thread_io_service_(),
+      thread_pool_(), main_thread_id_(std::this_thread::get_id()),
+      request_mutex_(), listeners_mutex_() {
 }
 
 CtrlAgentProcess::~CtrlAgentProcess() {
+    if (thread_pool_) {
+        thread_pool_->stop();
+    }
 }
 
 void
@@ -115,6 +123,21 @@ CtrlAgentProcess::configure(isc::data::ConstElementPtr config_set,
     // of the listener (if required). The lambda code will throw an
     // exception if it fails and cause the simpleParseConfig to rollback
     // configuration changes and report an error.
+    //
+    // With a thread pool the configuration must not change while the
+    // threads process requests. The commands processed by the agent itself
+    // already hold the lock when they reconfigure it from a thread of the
+    // pool, so the lock is only taken by the main thread.
+    std::unique_ptr<WriteLockGuard> lock;
+    if (thread_pool_ && (std::this_thread::get_id() == main_thread_id_)) {
+        lock.reset(new WriteLockGuard(request_mutex_));
+    }
+
+    // The hooks libraries are checked for the multi-threading compatibility
+    // when the requests are handled by a pool of threads.
+    if (thread_pool_size_ > 0) {
+        MultiThreadingMgr::instance().setMode(true);
+    }
     ConstElementPtr answer = getCfgMgr()->simpleParseConfig(config_set,
                                                             check_only,
                                                             [this]() {
@@ -161,10 +184,20 @@ CtrlAgentProcess::configure(isc::data::ConstElementPtr config_set,
             // used to generate answer to specific request.
             HttpResponseCreatorFactoryPtr rcf(new CtrlAgentResponseCreatorFactory());
 
+            // With a thread pool the listeners use their own IO service
+            // driven by the threads of the pool.
+            IOServicePtr listener_io_service = getIoService();
+            if (thread_pool_size_ > 0) {
+                if (!thread_io_service_) {
+                    thread_io_service_.reset(new IOService());
+                }
+                listener_io_service = thread_io_service_;
+            }
+
             // Create http listener. It will open up a TCP socket and be
             // prepared to accept incoming connection.
             HttpListenerPtr http_listener
-                (new HttpListener(*getIoService(), server_address,
+                (new HttpListener(*listener_io_service, server_address,
                                   server_port, tls_context, rcf,
                                   HttpListener::RequestTimeout(TIMEOUT_AGENT_RECEIVE_COMMAND),
                                   HttpListener::IdleTimeout(TIMEOUT_AGENT_IDLE_CONNECTION_TIMEOUT)));
@@ -176,7 +209,18 @@ CtrlAgentProcess::configure(isc::data::ConstElementPtr config_set,
             // The new listener is running so add it to the collection of
             // active listeners. The next step will be to remove all other
             // active listeners, but we do it inside the main process loop.
-            http_listeners_.push_back(http_listener);
+            {
+                std::lock_guard<std::mutex> lk(listeners_mutex_);
+                http_listeners_.push_back(http_listener);
+            }
+
+            // Start the threads once there is a listener to drive.
+            if (thread_io_service_ && !thread_pool_) {
+                thread_pool_.reset(new IoServiceThreadPool(thread_io_service_,
+                                                           thread_pool_size_));
+                LOG_INFO(agent_logger, CTRL_AGENT_HTTP_THREAD_POOL_STARTED)
+                    .arg(thread_pool_size_);
+            }
         }
 
         // Ok, seems we're good to go.
@@ -199,7 +243,21 @@ CtrlAgentProcess::garbageCollectListeners(size_t leaving) {
     // We expect only one active listener. If there are more (most likely 2),
     // it means we have just reconfigured the server and need to shut down all
     // listeners except the most recently added.
-    if (http_listeners_.size() > leaving) {
+    size_t size = 0;
+    {
+        std::lock_guard<std::mutex> lk(listeners_mutex_);
+        size = http_listeners_.size();
+    }
+    if (size > leaving) {
+        // The listeners are driven by the threads of the pool which must
+        // not run while they are stopped.
+        if (thread_pool_) {
+            if (leaving == 0) {
+                thread_pool_->stop();
+            } else {
+                thread_pool_->pause();
+            }
+        }
         // Stop no longer used listeners.
         for (auto l = http_listeners_.begin();
              l != http_listeners_.end() - leaving;
@@ -209,9 +267,23 @@ CtrlAgentProcess::garbageCollectListeners(size_t leaving) {
         // We have stopped listeners but there may be some pending handlers
         // related to these listeners. Need to invoke these handlers.
         getIoService()->get_io_service().poll();
+        if (thread_io_service_) {
+            thread_io_service_->restart();
+            thread_io_service_->poll();
+        }
         // Finally, we're ready to remove no longer used listeners.
-        http_listeners_.erase(http_listeners_.begin(),
-                              http_listeners_.end() - leaving);
+        {
+            std::lock_guard<std::mutex> lk(listeners_mutex_);
+            http_listeners_.erase(http_listeners_.begin(),
+                                  http_listeners_.end() - leaving);
+        }
+        if (thread_pool_) {
+            if (leaving == 0) {
+                thread_pool_.reset();
+            } else {
+                thread_pool_->run();
+            }
+        }
     }
 }
 
@@ -224,6 +296,7 @@ CtrlAgentProcess::getCtrlAgentCfgMgr() {
 ConstHttpListenerPtr
 CtrlAgentProcess::getHttpListener() const {
     // Return the most recent listener or null.
+    std::lock_guard<std::mutex> lk(listeners_mutex_);
     return (http_listeners_.empty() ? ConstHttpListenerPtr() :
             http_listeners_.back());
 }
@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,8 +8,12 @@
 #define CTRL_AGENT_PROCESS_H
 
 #include <agent/ca_cfg_mgr.h>
+#include <asiolink/io_service_thread_pool.h>
 #include <http/listener.h>
 #include <process/d_process.h>
+#include <util/readwrite_mutex.h>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace isc {
@@ -121,6 +125,40 @@ public:
     /// @return true if the process is listening.
     bool isListening() const;
 
+    /// @brief Sets the number of threads handling the HTTP requests.
+    ///
+    /// When it is not 0 the HTTP listeners are driven by a pool of threads
+    /// of this size, so a slow forwarded command does not block the other
+    /// clients. It must be set before the first configuration.
+    ///
+    /// @param size the number of threads (0 means the main thread).
+    void setThreadPoolSize(uint16_t size) {
+        thread_pool_size_ = size;
+    }
+
+    /// @brief Returns the number of threads handling the HTTP requests.
+    uint16_t getThreadPoolSize() const {
+        return (thread_pool_size_);
+    }
+
+    /// @brief Returns the pool of threads handling the HTTP requests.
+    ///
+    /// @return the thread pool or null when the requests are handled by
+    /// the main thread.
+    asiolink::IoServiceThreadPoolPtr getThreadPool() const {
+        return (thread_pool_);
+    }
+
+    /// @brief Returns the mutex serializing the requests.
+    ///
+    /// With a thread pool the forwarded commands hold it for reading, so
+    /// they run concurrently, while the commands processed by the agent
+    /// itself, e.g. config-set or shutdown, and the reconfigurations from
+    /// the main thread hold it for writing.
+    util::ReadWriteMutex& getRequestMutex() {
+        return (request_mutex_);
+    }
+
 private:
 
     /// @brief Removes listeners which are no longer in use.
@@ -144,6 +182,23 @@ private:
     /// @brief Holds a list of pointers to the active listeners.
     std::vector<http::HttpListenerPtr> http_listeners_;
 
+    /// @brief The number of threads handling the HTTP requests.
+    uint16_t thread_pool_size_;
+
+    /// @brief The IO service of the listeners driven by the thread pool.
+    asiolink::IOServicePtr thread_io_service_;
+
+    /// @brief The pool of threads handling the HTTP requests.
+    asiolink::IoServiceThreadPoolPtr thread_pool_;
+
+    /// @brief The identifier of the main thread.
+    std::thread::id main_thread_id_;
+
+    /// @brief The mutex serializing the requests.
+    util::ReadWriteMutex request_mutex_;
+
+    /// @brief The mutex protecting the list of listeners.
+    mutable std::mutex listeners_mutex_;
 };
 
 /// @brief Defines a shared pointer to CtrlAgentProcess.
@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -17,12 +17,14 @@
 #include <hooks/hooks_manager.h>
 #include <http/post_request_json.h>
 #include <http/response_json.h>
+#include <util/readwrite_mutex.h>
 #include <boost/pointer_cast.hpp>
 #include <iostream>
 
 using namespace isc::data;
 using namespace isc::hooks;
 using namespace isc::http;
+using namespace isc::util;
 
 namespace {
 
@@ -87,6 +89,45 @@ createStockHttpResponseInternal(const HttpRequestPtr& request,
 HttpResponsePtr
 CtrlAgentResponseCreator::
 createDynamicHttpResponse(HttpRequestPtr request) {
+    CtrlAgentProcessPtr process;
+    boost::shared_ptr<CtrlAgentController> controller =
+        boost::dynamic_pointer_cast<CtrlAgentController>(CtrlAgentController::instance());
+    if (controller) {
+        process = controller->getCtrlAgentProcess();
+    }
+    if (!process || !process->getThreadPool()) {
+        return (createDynamicHttpResponseInternal(request));
+    }
+
+    // The commands processed by the Control Agent itself may change its
+    // configuration or reload the hooks libraries so no other request may
+    // be processed at the same time.
+    ConstElementPtr command;
+    PostHttpRequestJsonPtr request_json =
+        boost::dynamic_pointer_cast<PostHttpRequestJson>(request);
+    if (request_json) {
+        command = request_json->getBodyAsJson();
+    }
+    if (!CtrlAgentCommandMgr::isLocalCommand(command)) {
+        ReadLockGuard lock(process->getRequestMutex());
+        return (createDynamicHttpResponseInternal(request));
+    }
+
+    HttpResponsePtr http_response;
+    {
+        WriteLockGuard lock(process->getRequestMutex());
+        http_response = createDynamicHttpResponseInternal(request);
+    }
+
+    // Wake up the main thread so it removes the listeners replaced by
+    // a new configuration or notices a shutdown.
+    process->getIoService()->post([]() {});
+    return (http_response);
+}
+
+HttpResponsePtr
+CtrlAgentResponseCreator::
+createDynamicHttpResponseInternal(HttpRequestPtr request) {
     // First check authentication.
     HttpResponseJsonPtr http_response;
 
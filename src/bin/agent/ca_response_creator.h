@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -73,10 +73,22 @@ private:
 
     /// @brief Creates implementation specific HTTP response.
     ///
+    /// When the requests are handled by a pool of threads the forwarded
+    /// commands are processed concurrently and the commands processed by
+    /// the Control Agent itself exclusively.
+    ///
     /// @param request Pointer to an object representing HTTP request.
     /// @return Pointer to an object representing HTTP response.
     virtual http::HttpResponsePtr
     createDynamicHttpResponse(http::HttpRequestPtr request);
+
+    /// @brief Creates implementation specific HTTP response without
+    /// locking.
+    ///
+    /// @param request Pointer to an object representing HTTP request.
+    /// @return Pointer to an object representing HTTP response.
+    http::HttpResponsePtr
+    createDynamicHttpResponseInternal(http::HttpRequestPtr request);
 };
 
 } // end of namespace isc::agent
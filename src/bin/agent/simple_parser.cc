@@ -12,9 +12,11 @@
 #include <hooks/hooks_manager.h>
 #include <hooks/hooks_parser.h>
 #include <http/basic_auth_config.h>
+#include <util/multi_threading_mgr.h>
 #include <boost/foreach.hpp>
 
 using namespace isc::data;
+using namespace isc::util;
 
 namespace isc {
 namespace agent {
@@ -171,10 +173,13 @@ AgentSimpleParser::parse(const CtrlAgentCfgContextPtr& ctx,
     using namespace isc::hooks;
     HooksConfig& libraries = ctx->getHooksConfig();
     ConstElementPtr hooks = config->get("hooks-libraries");
+    // The requests are handled by a pool of threads in multi-threading mode.
+    bool multi_threading_enabled = MultiThreadingMgr::instance().getMode();
     if (hooks) {
         HooksLibrariesParser hooks_parser;
         hooks_parser.parse(libraries, hooks);
-        libraries.verifyLibraries(hooks->getPosition(), false);
+        libraries.verifyLibraries(hooks->getPosition(),
+                                  multi_threading_enabled);
     }
 
     if (!check_only) {
@@ -183,7 +188,7 @@ AgentSimpleParser::parse(const CtrlAgentCfgContextPtr& ctx,
         // change causes problems when trying to roll back.
         HooksManager::prepareUnloadLibraries();
         static_cast<void>(HooksManager::unloadLibraries());
-        libraries.loadLibraries(false);
+        libraries.loadLibraries(multi_threading_enabled);
     }
 }
 
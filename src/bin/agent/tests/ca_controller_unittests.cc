@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -215,6 +215,41 @@ TEST_F(CtrlAgentControllerTest, commandLineArgs) {
     EXPECT_THROW(parseArgs(argc, argv2), InvalidUsage);
 }
 
+// Tests the command line option setting the number of threads handling
+// the HTTP requests.
+TEST_F(CtrlAgentControllerTest, threadPoolSizeArg) {
+    CtrlAgentControllerPtr controller =
+        boost::dynamic_pointer_cast<CtrlAgentController>(getController());
+    ASSERT_TRUE(controller);
+    EXPECT_EQ(0, controller->getThreadPoolSize());
+
+    char* argv[] = { const_cast<char*>("progName"),
+                     const_cast<char*>("-c"),
+                     const_cast<char*>(DControllerTest::CFG_TEST_FILE),
+                     const_cast<char*>("-T"),
+                     const_cast<char*>("4") };
+    int argc = 5;
+    EXPECT_NO_THROW(parseArgs(argc, argv));
+    EXPECT_EQ(4, controller->getThreadPoolSize());
+
+    // The process gets the number of threads.
+    ASSERT_NO_THROW(initProcess());
+    ASSERT_TRUE(getCtrlAgentProcess());
+    EXPECT_EQ(4, getCtrlAgentProcess()->getThreadPoolSize());
+    EXPECT_FALSE(getCtrlAgentProcess()->getThreadPool());
+
+    // Invalid numbers are rejected.
+    char* argv2[] = { const_cast<char*>("progName"),
+                      const_cast<char*>("-T"),
+                      const_cast<char*>("-1") };
+    argc = 3;
+    EXPECT_THROW(parseArgs(argc, argv2), InvalidUsage);
+    char* argv3[] = { const_cast<char*>("progName"),
+                      const_cast<char*>("-T"),
+                      const_cast<char*>("many") };
+    EXPECT_THROW(parseArgs(argc, argv3), InvalidUsage);
+}
+
 // Tests application process creation and initialization.
 // Verifies that the process can be successfully created and initialized.
 TEST_F(CtrlAgentControllerTest, initProcessTesting) {
@@ -59,6 +59,7 @@ D2Process::D2Process(const char* name, const asiolink::IOServicePtr& io_service)
     // D2 will neither receive nor process NameChangeRequests.
     // Pass in IOService for NCR IO event processing.
     queue_mgr_.reset(new D2QueueMgr(getIoService()));
+    queue_mgr_->setCoalesce(true);
 
     // Instantiate update manager.
     // Pass in both queue manager and configuration manager.
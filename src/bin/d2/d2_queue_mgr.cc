@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,16 +8,40 @@
 #include <d2/d2_queue_mgr.h>
 #include <d2srv/d2_log.h>
 #include <dhcp_ddns/ncr_udp.h>
+#include <stats/stats_mgr.h>
 
 namespace isc {
 namespace d2 {
 
+namespace {
+
+/// @brief Checks if a request supersedes an older queued request.
+///
+/// The FQDN is the index key so it is not compared.
+///
+/// @param newer the newly received request.
+/// @param older a queued request with the same FQDN.
+/// @return true if processing the newer request alone leads to the same
+/// DNS content as processing both requests in order.
+bool
+supersedes(const dhcp_ddns::NameChangeRequest& newer,
+           const dhcp_ddns::NameChangeRequest& older) {
+    return ((newer.getDhcid() == older.getDhcid()) &&
+            (newer.getIpAddress() == older.getIpAddress()) &&
+            (newer.isForwardChange() == older.isForwardChange()) &&
+            (newer.isReverseChange() == older.isReverseChange()) &&
+            (newer.useConflictResolution() == older.useConflictResolution()));
+}
+
+}
+
 // Makes constant visible to Google test macros.
 const size_t D2QueueMgr::MAX_QUEUE_DEFAULT;
 
 D2QueueMgr::D2QueueMgr(asiolink::IOServicePtr& io_service, const size_t max_queue_size)
     : io_service_(io_service), max_queue_size_(max_queue_size),
-      mgr_state_(NOT_INITTED), target_stop_state_(NOT_INITTED) {
+      mgr_state_(NOT_INITTED), target_stop_state_(NOT_INITTED),
+      coalesce_(false) {
     if (!io_service_) {
         isc_throw(D2QueueMgrError, "IOServicePtr cannot be null");
     }
@@ -222,6 +246,7 @@ D2QueueMgr::dequeueAt(const size_t index) {
 
     RequestQueue::iterator pos = ncr_queue_.begin() + index;
     ncr_queue_.erase(pos);
+    updateQueueSizeStat();
 }
 
 
@@ -233,16 +258,42 @@ D2QueueMgr::dequeue() {
     }
 
     ncr_queue_.pop_front();
+    updateQueueSizeStat();
 }
 
 void
 D2QueueMgr::enqueue(dhcp_ddns::NameChangeRequestPtr& ncr) {
+    if (coalesce_) {
+        auto& index = ncr_queue_.get<1>();
+        auto range = index.equal_range(ncr->getFqdn());
+        for (auto it = range.first; it != range.second; ) {
+            if (supersedes(*ncr, **it)) {
+                LOG_DEBUG(dhcp_to_d2_logger, isc::log::DBGLVL_TRACE_DETAIL_DATA,
+                          DHCP_DDNS_QUEUE_MGR_REQUEST_COALESCED)
+                          .arg((*it)->getRequestId())
+                          .arg(ncr->getRequestId());
+                it = index.erase(it);
+                isc::stats::StatsMgr::instance().addValue("ncr-coalesced",
+                                                          static_cast<int64_t>(1));
+            } else {
+                ++it;
+            }
+        }
+    }
     ncr_queue_.push_back(ncr);
+    updateQueueSizeStat();
 }
 
 void
 D2QueueMgr::clearQueue() {
     ncr_queue_.clear();
+    updateQueueSizeStat();
+}
+
+void
+D2QueueMgr::updateQueueSizeStat() const {
+    isc::stats::StatsMgr::instance().setValue("ncr-queue-size",
+                                              static_cast<int64_t>(ncr_queue_.size()));
 }
 
 void
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015,2017,2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2015,2017,2021,2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,15 +14,37 @@
 #include <dhcp_ddns/ncr_msg.h>
 #include <dhcp_ddns/ncr_io.h>
 
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/indexed_by.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/random_access_index.hpp>
 #include <boost/noncopyable.hpp>
-#include <deque>
+#include <string>
 
 namespace isc {
 namespace d2 {
 
 /// @brief Defines a queue of requests.
-/// @todo This may be replaced with an actual class in the future.
-typedef std::deque<dhcp_ddns::NameChangeRequestPtr> RequestQueue;
+///
+/// The requests are kept in the order of reception and are also indexed
+/// by FQDN, so the queued requests superseded by a new one can be found
+/// without scanning the queue.
+typedef boost::multi_index_container<
+    // It holds pointers to the requests.
+    dhcp_ddns::NameChangeRequestPtr,
+    boost::multi_index::indexed_by<
+        // First index is the order of reception with positional access.
+        boost::multi_index::random_access<>,
+        // Second index is by FQDN.
+        boost::multi_index::hashed_non_unique<
+            boost::multi_index::const_mem_fun<
+                dhcp_ddns::NameChangeRequest, const std::string,
+                &dhcp_ddns::NameChangeRequest::getFqdn
+            >
+        >
+    >
+> RequestQueue;
 
 /// @brief Thrown if the queue manager encounters a general error.
 class D2QueueMgrError : public isc::Exception {
@@ -123,6 +145,18 @@ public:
 /// D2QueueMgr does not attempt to recover from stopped conditions, this is left
 /// to upper layers.
 ///
+/// When coalescing is enabled, a request queued while an older request
+/// for the same client (DHCID), FQDN, address and update directions is
+/// still waiting in the queue replaces this older request: the DNS
+/// changes of the newer request alone lead to the same result, so
+/// add/remove/add sequences of a flapping client are processed once.
+/// The number of removed requests is counted in the "ncr-coalesced"
+/// statistic. The requests for which a transaction was started are not
+/// in the queue and are never affected.
+///
+/// The current number of queued requests is kept in the "ncr-queue-size"
+/// statistic.
+///
 /// It is important to note that the queue contents are preserved between
 /// state transitions.  In other words entries in the queue remain there
 /// until they are removed explicitly via the deque() or implicitly by
@@ -263,6 +297,20 @@ public:
     /// queue.
     void setMaxQueueSize(const size_t max_queue_size);
 
+    /// @brief Returns true if the superseded requests are removed from the
+    /// queue.
+    bool getCoalesce() const {
+        return (coalesce_);
+    }
+
+    /// @brief Enables or disables the removal of the superseded requests.
+    ///
+    /// @param coalesce true if the queued requests superseded by a newer
+    /// request should be removed from the queue.
+    void setCoalesce(const bool coalesce) {
+        coalesce_ = coalesce;
+    }
+
     /// @brief Returns the current state.
     State getMgrState() const {
         return (mgr_state_);
@@ -307,6 +355,9 @@ public:
 
     /// @brief Adds a request to the end of the queue.
     ///
+    /// When coalescing is enabled, the queued requests superseded by this
+    /// request are removed from the queue.
+    ///
     /// @param ncr pointer to the NameChangeRequest to add to the queue.
     void enqueue(dhcp_ddns::NameChangeRequestPtr& ncr);
 
@@ -320,6 +371,9 @@ public:
     /// state and logs that the manager is stopped.
     void updateStopState();
 
+    /// @brief Sets the "ncr-queue-size" statistic to the queue size.
+    void updateQueueSizeStat() const;
+
     /// @brief IOService that our listener should use for IO management.
     asiolink::IOServicePtr io_service_;
 
@@ -337,6 +391,9 @@ public:
 
     /// @brief Tracks the state the manager should be in once stopped.
     State target_stop_state_;
+
+    /// @brief Remove the queued requests superseded by a newer one.
+    bool coalesce_;
 };
 
 /// @brief Defines a pointer for manager instances.
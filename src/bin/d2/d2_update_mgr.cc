@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -50,12 +50,10 @@ void D2UpdateMgr::sweep() {
     // cleanup finished transactions;
     checkFinishedTransactions();
 
-    // if the queue isn't empty, find the next suitable job and
-    // start a transaction for it.
-    // @todo - Do we want to queue max transactions? The logic here will only
-    // start one new transaction per invocation.  On the other hand a busy
-    // system will generate many IO events and this method will be called
-    // frequently.  It will likely achieve max transactions quickly on its own.
+    // if the queue isn't empty, find the suitable jobs and start
+    // transactions for them. Starting only one transaction per invocation
+    // limits the rate at which a large backlog of requests is drained to
+    // the rate of the IO events, so we fill up to max transactions here.
     if (getQueueCount() > 0)  {
         if (getTransactionCount() >= max_transactions_) {
             LOG_DEBUG(dhcp_to_d2_logger, isc::log::DBGLVL_TRACE_DETAIL_DATA,
@@ -65,8 +63,8 @@ void D2UpdateMgr::sweep() {
             return;
         }
 
-        // We are not at maximum transactions, so pick and start the next job.
-        pickNextJob();
+        // We are not at maximum transactions, so pick and start the next jobs.
+        pickNextJobs();
     }
 }
 
@@ -117,6 +115,36 @@ void D2UpdateMgr::pickNextJob() {
         .arg(getQueueCount()).arg(getTransactionCount());
 }
 
+size_t
+D2UpdateMgr::pickNextJobs() {
+    // Scan the queue once. Requests removed from the queue shift the
+    // following ones down, so the index only advances past the requests
+    // which are left in the queue.
+    size_t picked = 0;
+    size_t index = 0;
+    while ((index < getQueueCount()) &&
+           (getTransactionCount() < max_transactions_)) {
+        dhcp_ddns::NameChangeRequestPtr found_ncr = queue_mgr_->peekAt(index);
+        if (hasTransaction(found_ncr->getDhcid())) {
+            ++index;
+            continue;
+        }
+        queue_mgr_->dequeueAt(index);
+        makeTransaction(found_ncr);
+        ++picked;
+    }
+
+    if (!picked) {
+        // There were no eligible jobs. All of the current DHCIDs already have
+        // transactions pending.
+        LOG_DEBUG(dhcp_to_d2_logger, isc::log::DBGLVL_TRACE_DETAIL_DATA,
+                  DHCP_DDNS_NO_ELIGIBLE_JOBS)
+            .arg(getQueueCount()).arg(getTransactionCount());
+    }
+
+    return (picked);
+}
+
 void
 D2UpdateMgr::makeTransaction(dhcp_ddns::NameChangeRequestPtr& next_ncr) {
     // First lets ensure there is not a transaction in progress for this
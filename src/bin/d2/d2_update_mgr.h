@@ -96,9 +96,9 @@ public:
     ///
     /// - If the request queue is not empty and the number of transactions
     /// in the transaction list has not reached maximum allowed, then select
-    /// a request from the queue.
+    /// requests from the queue until the maximum is reached.
     ///
-    /// - If a request was selected, start a new transaction for it and
+    /// - For each selected request, start a new transaction for it and
     /// add the transaction to the list of transactions.
     void sweep();
 
@@ -125,6 +125,18 @@ protected:
     /// clients in quick succession.
     void pickNextJob();
 
+    /// @brief Starts transactions for the eligible requests in the queue.
+    ///
+    /// This method scans the request queue once from the front and starts
+    /// a transaction for each request for whose DHCID there is no current
+    /// transaction in progress, until the maximum number of transactions
+    /// is reached. The requests for a DHCID with a transaction in progress
+    /// are left in the queue in order, so the requests for the same client
+    /// are still processed one at a time in the order they were received.
+    ///
+    /// @return Number of requests removed from the queue.
+    size_t pickNextJobs();
+
     /// @brief Create a new transaction for the given request.
     ///
     /// This method will attempt to match the request to suitable DNS servers.
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -244,6 +244,11 @@ TEST_F(D2CfgMgrTest, validParamsEntry) {
     EXPECT_EQ(dhcp_ddns::NCR_UDP, d2_params_->getNcrProtocol());
     EXPECT_EQ(dhcp_ddns::FMT_JSON, d2_params_->getNcrFormat());
 
+    // Verify that the binary format is accepted.
+    config = makeParamsConfigString ("192.0.0.1", 777, 333, "UDP", "BINARY");
+    RUN_CONFIG_OK(config);
+    EXPECT_EQ(dhcp_ddns::FMT_BINARY, d2_params_->getNcrFormat());
+
     // Verify that ip_address can be valid v6 address.
     config = makeParamsConfigString ("3001::5", 777, 333, "UDP", "JSON");
     RUN_CONFIG_OK(config);
@@ -435,7 +440,7 @@ TEST_F(D2CfgMgrTest, invalidEntry) {
     // Invalid format
     config = makeParamsConfigString ("127.0.0.1", 777, 333, "UDP", "BOGUS");
     SYNTAX_ERROR(config, "<string>:1.115-121: syntax error,"
-                         " unexpected constant string, expecting JSON");
+                         " unexpected constant string, expecting JSON or BINARY");
 }
 
 // Control socket tests in d2_process_unittests.cc
@@ -754,6 +759,11 @@ TEST_F(D2CfgMgrTest, matchNoWildcard) {
 
     // Verify that a FQDN with no match, fails to match.
     EXPECT_FALSE(cfg_mgr_->matchForward("shouldbe.wildcard", match));
+
+    // Verify that only label boundaries match.
+    EXPECT_FALSE(cfg_mgr_->matchForward("blueexample.com", match));
+    EXPECT_TRUE(cfg_mgr_->matchForward("RED.anyone.EXAMPLE.com", match));
+    EXPECT_EQ("example.com", match->getName());
 }
 
 /// @brief Tests domain matching when there is ONLY a wild card domain.
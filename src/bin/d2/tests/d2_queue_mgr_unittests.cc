@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -195,6 +195,71 @@ TEST(D2QueueMgrBasicTest, basicQueue) {
                  D2QueueMgrInvalidIndex);
 }
 
+/// @brief Test fixture for the coalescing of the queued requests.
+class D2QueueMgrCoalesceTest : public ::testing::Test, public D2StatTest {
+};
+
+/// @brief Tests that superseded requests are removed from the queue
+/// when coalescing is enabled.
+TEST_F(D2QueueMgrCoalesceTest, coalesce) {
+    asiolink::IOServicePtr io_service(new isc::asiolink::IOService());
+    D2QueueMgrPtr queue_mgr;
+    ASSERT_NO_THROW(queue_mgr.reset(new D2QueueMgr(io_service)));
+    EXPECT_FALSE(queue_mgr->getCoalesce());
+
+    // Without coalescing the add and the remove of the same address
+    // are both queued.
+    NameChangeRequestPtr add_ncr;
+    NameChangeRequestPtr remove_ncr;
+    ASSERT_NO_THROW(add_ncr = NameChangeRequest::fromJSON(valid_msgs[0]));
+    ASSERT_NO_THROW(remove_ncr = NameChangeRequest::fromJSON(valid_msgs[1]));
+    queue_mgr->enqueue(add_ncr);
+    queue_mgr->enqueue(remove_ncr);
+    EXPECT_EQ(2, queue_mgr->getQueueSize());
+    queue_mgr->clearQueue();
+
+    queue_mgr->setCoalesce(true);
+    EXPECT_TRUE(queue_mgr->getCoalesce());
+
+    // Queue an add, an add of a different address for the same FQDN and
+    // a remove of the first address. The remove supersedes the first add.
+    NameChangeRequestPtr other_ncr;
+    ASSERT_NO_THROW(other_ncr = NameChangeRequest::fromJSON(valid_msgs[2]));
+    queue_mgr->enqueue(add_ncr);
+    queue_mgr->enqueue(other_ncr);
+    queue_mgr->enqueue(remove_ncr);
+    ASSERT_EQ(2, queue_mgr->getQueueSize());
+    EXPECT_EQ(other_ncr, queue_mgr->peekAt(0));
+    EXPECT_EQ(remove_ncr, queue_mgr->peekAt(1));
+
+    // The add of the first address again supersedes the remove.
+    NameChangeRequestPtr readd_ncr;
+    ASSERT_NO_THROW(readd_ncr = NameChangeRequest::fromJSON(valid_msgs[0]));
+    queue_mgr->enqueue(readd_ncr);
+    ASSERT_EQ(2, queue_mgr->getQueueSize());
+    EXPECT_EQ(other_ncr, queue_mgr->peekAt(0));
+    EXPECT_EQ(readd_ncr, queue_mgr->peekAt(1));
+
+    // A request for another client is not coalesced.
+    NameChangeRequestPtr client_ncr(new NameChangeRequest(*add_ncr));
+    client_ncr->setDhcid("AABBCCDDEEFF");
+    queue_mgr->enqueue(client_ncr);
+    EXPECT_EQ(3, queue_mgr->getQueueSize());
+
+    StatMap stats_ncr = {
+        { "ncr-coalesced", 2},
+        { "ncr-queue-size", 3}
+    };
+    checkStats(stats_ncr);
+
+    queue_mgr->dequeue();
+    queue_mgr->dequeueAt(1);
+    StatMap stats_queue = {
+        { "ncr-queue-size", 1}
+    };
+    checkStats(stats_queue);
+}
+
 /// @brief Compares two NameChangeRequests for equality.
 bool checkSendVsReceived(NameChangeRequestPtr sent_ncr,
                          NameChangeRequestPtr received_ncr) {
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -51,6 +51,7 @@ public:
     // Expose the protected methods to be tested.
     using D2UpdateMgr::checkFinishedTransactions;
     using D2UpdateMgr::pickNextJob;
+    using D2UpdateMgr::pickNextJobs;
     using D2UpdateMgr::makeTransaction;
 };
 
@@ -575,6 +576,56 @@ TEST_F(D2UpdateMgrTest, pickNextJob) {
     EXPECT_EQ(0, update_mgr_->getQueueCount());
 }
 
+/// @brief Tests D2UpdateManager's pickNextJobs method.
+/// This test verifies that:
+/// 1. pickNextJobs makes transactions for all eligible requests in one call.
+/// 2. It stops at the maximum number of transactions.
+/// 3. Requests for DHCIDs with transactions already in progress are left
+/// in the queue in order.
+TEST_F(D2UpdateMgrTest, pickNextJobs) {
+    // Ensure we have at least 4 canned requests with which to work.
+    ASSERT_TRUE(canned_count_ >= 4);
+
+    // Queue the requests with a second request for the first DHCID
+    // right behind the first one.
+    ASSERT_NO_THROW(queue_mgr_->enqueue(canned_ncrs_[0]));
+    dhcp_ddns::NameChangeRequestPtr
+        subsequent_ncr(new dhcp_ddns::NameChangeRequest(*(canned_ncrs_[0])));
+    ASSERT_NO_THROW(queue_mgr_->enqueue(subsequent_ncr));
+    for (int i = 1; i < canned_count_; i++) {
+        ASSERT_NO_THROW(queue_mgr_->enqueue(canned_ncrs_[i]));
+    }
+
+    // Limit the transactions so that the last request is not picked.
+    ASSERT_NO_THROW(update_mgr_->setMaxTransactions(canned_count_ - 1));
+    EXPECT_EQ(canned_count_ - 1, update_mgr_->pickNextJobs());
+    EXPECT_EQ(canned_count_ - 1, update_mgr_->getTransactionCount());
+    for (int i = 0; i < canned_count_ - 1; i++) {
+        EXPECT_TRUE(update_mgr_->hasTransaction(canned_ncrs_[i]->getDhcid()));
+    }
+
+    // The subsequent request and the last one are still queued in order.
+    ASSERT_EQ(2, update_mgr_->getQueueCount());
+    EXPECT_EQ(subsequent_ncr, queue_mgr_->peekAt(0));
+    EXPECT_EQ(canned_ncrs_[canned_count_ - 1], queue_mgr_->peekAt(1));
+
+    // At the maximum nothing is picked.
+    EXPECT_EQ(0, update_mgr_->pickNextJobs());
+
+    // Raising the maximum picks the last request but not the subsequent
+    // one while the transaction for its DHCID is in progress.
+    ASSERT_NO_THROW(update_mgr_->setMaxTransactions(canned_count_ + 1));
+    EXPECT_EQ(1, update_mgr_->pickNextJobs());
+    EXPECT_EQ(canned_count_, update_mgr_->getTransactionCount());
+    ASSERT_EQ(1, update_mgr_->getQueueCount());
+    EXPECT_EQ(subsequent_ncr, queue_mgr_->peekAt(0));
+
+    // Once the first transaction completes the subsequent request is picked.
+    update_mgr_->removeTransaction(canned_ncrs_[0]->getDhcid());
+    EXPECT_EQ(1, update_mgr_->pickNextJobs());
+    EXPECT_EQ(0, update_mgr_->getQueueCount());
+}
+
 /// @brief Tests D2UpdateManager's sweep method.
 /// Since sweep is primarily a wrapper around checkFinishedTransactions and
 /// pickNextJob, along with checks on maximum transaction limits, it mostly
@@ -593,11 +644,11 @@ TEST_F(D2UpdateMgrTest, sweep) {
         EXPECT_NO_THROW(queue_mgr_->enqueue(canned_ncrs_[i]));
     }
 
-    // Invoke sweep canned_count_ times which should create a
-    // transaction for each canned ncr.
+    // Invoke sweep once which should create a transaction for each
+    // canned ncr.
+    EXPECT_NO_THROW(update_mgr_->sweep());
+    EXPECT_EQ(canned_count_, update_mgr_->getTransactionCount());
     for (int i = 0; i < canned_count_; i++) {
-        EXPECT_NO_THROW(update_mgr_->sweep());
-        EXPECT_EQ(i + 1, update_mgr_->getTransactionCount());
         EXPECT_TRUE(update_mgr_->hasTransaction(canned_ncrs_[i]->getDhcid()));
     }
 
@@ -0,0 +1,667 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file dhcp4_bench.cc
+///
+/// In-process throughput harness of the DHCPv4 server. The synthetic
+/// queries are given to @c Dhcpv4Srv::processPacket directly, so the
+/// measurements do not include the socket and packet queue overheads
+/// and reflect the packet processing itself. The clients run four-way
+/// exchanges (DORA) and renewals in a configurable mix from one or more
+/// threads. The harness reports the throughput and, per processing stage,
+/// the CPU time and the number of memory allocations per packet.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <cc/command_interpreter.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/option.h>
+#include <dhcp/option_int_array.h>
+#include <dhcp/option_string.h>
+#include <dhcp/pkt4.h>
+#include <dhcp4/dhcp4_srv.h>
+#include <dhcp4/json_config_parser.h>
+#include <dhcp4/parser_context.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <exceptions/exceptions.h>
+#include <log/logger_support.h>
+#include <util/multi_threading_mgr.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <time.h>
+#include <unistd.h>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::util;
+using namespace std;
+
+namespace {
+
+/// @brief Number of memory allocations made by the current thread.
+thread_local uint64_t allocations = 0;
+
+} // end of anonymous namespace
+
+/// @brief Counts the allocations, the array and sized forms of the
+/// operators use these ones.
+void*
+operator new(size_t size) {
+    ++allocations;
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return (ptr);
+}
+
+void
+operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+namespace {
+
+const char* const BENCH_NAME = "kea-dhcp4-bench";
+
+/// @brief The configuration used when no configuration file is given.
+///
+/// The leases are held in memory and the relay address and the client
+/// addresses belong to the subnet. The server identifier is configured
+/// so the server accepts the DHCPREQUESTs without open sockets.
+const char* const DEFAULT_CONFIG =
+    "{ \"Dhcp4\": {"
+    "    \"lease-database\": { \"type\": \"memfile\", \"persist\": false },"
+    "    \"valid-lifetime\": 3600,"
+    "    \"renew-timer\": 900,"
+    "    \"rebind-timer\": 1800,"
+    "    \"subnet4\": [ {"
+    "        \"id\": 1,"
+    "        \"subnet\": \"10.0.0.0/8\","
+    "        \"pools\": [ { \"pool\": \"10.0.1.0 - 10.255.255.254\" } ],"
+    "        \"option-data\": ["
+    "            { \"name\": \"dhcp-server-identifier\", \"data\": \"10.0.0.254\" },"
+    "            { \"name\": \"routers\", \"data\": \"10.0.0.1\" },"
+    "            { \"name\": \"domain-name-servers\", \"data\": \"10.0.0.2\" },"
+    "            { \"name\": \"domain-name\", \"data\": \"example.org\" }"
+    "        ]"
+    "    } ]"
+    "} }";
+
+/// @brief Address of the relay agent.
+const IOAddress RELAY_ADDRESS("10.0.0.1");
+
+/// @brief Address of the server receiving the queries.
+const IOAddress SERVER_ADDRESS("10.0.0.254");
+
+/// @brief Processing stages.
+enum Stage {
+    /// @brief Creation of the query from the wire data.
+    STAGE_RECEIVE,
+    /// @brief @c Dhcpv4Srv::processPacket, including the unpacking.
+    STAGE_PROCESS,
+    /// @brief Packing of the response.
+    STAGE_PACK,
+    /// @brief Number of stages.
+    STAGE_COUNT
+};
+
+/// @brief Names of the stages.
+const char* const STAGE_NAMES[STAGE_COUNT] = { "receive", "process", "pack" };
+
+/// @brief Returns the CPU time used by the current thread.
+///
+/// @return The CPU time in nanoseconds.
+uint64_t
+threadCpuTime() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec);
+}
+
+/// @brief Measurements of a thread.
+struct Stats {
+    /// @brief Constructor.
+    Stats() : cpu_ns_(), allocations_(), transactions_(0), queries_(0),
+              responses_(0), naks_(0), failures_(0) {
+    }
+
+    /// @brief Adds the measurements of another thread.
+    ///
+    /// @param other The measurements to add.
+    void add(const Stats& other) {
+        for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+            cpu_ns_[stage] += other.cpu_ns_[stage];
+            allocations_[stage] += other.allocations_[stage];
+        }
+        transactions_ += other.transactions_;
+        queries_ += other.queries_;
+        responses_ += other.responses_;
+        naks_ += other.naks_;
+        failures_ += other.failures_;
+    }
+
+    /// @brief CPU time per stage in nanoseconds.
+    uint64_t cpu_ns_[STAGE_COUNT];
+
+    /// @brief Memory allocations per stage.
+    uint64_t allocations_[STAGE_COUNT];
+
+    /// @brief Number of exchanges (DORA or renewal).
+    uint64_t transactions_;
+
+    /// @brief Number of queries given to the server.
+    uint64_t queries_;
+
+    /// @brief Number of responses.
+    uint64_t responses_;
+
+    /// @brief Number of DHCPNAKs.
+    uint64_t naks_;
+
+    /// @brief Number of exchanges without the expected response.
+    uint64_t failures_;
+};
+
+/// @brief Adds the CPU time and the allocations of a scope to a stage.
+class StageTimer {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param stats The measurements of the current thread.
+    /// @param stage The measured stage.
+    StageTimer(Stats& stats, Stage stage)
+        : stats_(stats), stage_(stage), allocations_(allocations),
+          cpu_ns_(threadCpuTime()) {
+    }
+
+    /// @brief Destructor.
+    ~StageTimer() {
+        stats_.cpu_ns_[stage_] += threadCpuTime() - cpu_ns_;
+        stats_.allocations_[stage_] += allocations - allocations_;
+    }
+
+private:
+
+    /// @brief The measurements of the current thread.
+    Stats& stats_;
+
+    /// @brief The measured stage.
+    Stage stage_;
+
+    /// @brief Allocation count at the beginning of the scope.
+    uint64_t allocations_;
+
+    /// @brief CPU time at the beginning of the scope.
+    uint64_t cpu_ns_;
+};
+
+/// @brief A simulated client.
+struct Client {
+    /// @brief Constructor.
+    ///
+    /// @param index Index of the client, unique among all threads.
+    Client(uint32_t index)
+        : index_(index), address_(IOAddress::IPV4_ZERO_ADDRESS()) {
+    }
+
+    /// @brief Index of the client.
+    uint32_t index_;
+
+    /// @brief Leased address, zero when the client has no lease.
+    IOAddress address_;
+};
+
+/// @brief Creates a query of a client.
+///
+/// The query holds the client identifier, host name, parameter request
+/// list and vendor class identifier options as sent by a typical client.
+///
+/// @param client The client sending the query.
+/// @param type The message type.
+/// @param xid The transaction id.
+/// @return The query (not packed).
+Pkt4Ptr
+createQuery(const Client& client, uint8_t type, uint32_t xid) {
+    Pkt4Ptr query(new Pkt4(type, xid));
+    vector<uint8_t> mac = { 0x02, 0x00,
+                            static_cast<uint8_t>(client.index_ >> 24),
+                            static_cast<uint8_t>(client.index_ >> 16),
+                            static_cast<uint8_t>(client.index_ >> 8),
+                            static_cast<uint8_t>(client.index_) };
+    query->setHWAddr(HWAddrPtr(new HWAddr(mac, HTYPE_ETHER)));
+
+    vector<uint8_t> id = mac;
+    id.insert(id.begin(), HTYPE_ETHER);
+    query->addOption(OptionPtr(new Option(Option::V4,
+                                          DHO_DHCP_CLIENT_IDENTIFIER, id)));
+    query->addOption(OptionPtr(new OptionString(Option::V4, DHO_HOST_NAME,
+                                                "client.example.org")));
+    OptionUint8ArrayPtr prl(new OptionUint8Array(Option::V4,
+                                                 DHO_DHCP_PARAMETER_REQUEST_LIST));
+    for (uint8_t code : { DHO_SUBNET_MASK, DHO_ROUTERS,
+                          DHO_DOMAIN_NAME_SERVERS, DHO_DOMAIN_NAME,
+                          DHO_NTP_SERVERS }) {
+        prl->addValue(code);
+    }
+    query->addOption(prl);
+    query->addOption(OptionPtr(new OptionString(Option::V4,
+                                                DHO_VENDOR_CLASS_IDENTIFIER,
+                                                "PXEClient:Arch:00000:UNDI:002001")));
+
+    // The renewals are unicast by the client, the other queries are
+    // relayed.
+    if ((type == DHCPREQUEST) && !client.address_.isV4Zero()) {
+        query->setCiaddr(client.address_);
+    } else {
+        query->setGiaddr(RELAY_ADDRESS);
+        query->setHops(1);
+    }
+    return (query);
+}
+
+/// @brief Gives a query to the server as received from the network.
+///
+/// @param server The server.
+/// @param query The query (not packed).
+/// @param stats The measurements of the current thread.
+/// @return The response or null if the query was dropped.
+Pkt4Ptr
+exchange(Dhcpv4Srv& server, const Pkt4Ptr& query, Stats& stats) {
+    // The client side work is not measured.
+    query->pack();
+    const util::OutputBuffer& buffer = query->getBuffer();
+
+    Pkt4Ptr received;
+    {
+        StageTimer timer(stats, STAGE_RECEIVE);
+        received.reset(new Pkt4(static_cast<const uint8_t*>(buffer.getData()),
+                                buffer.getLength()));
+        received->setIface("eth0");
+        received->setIndex(1);
+        received->setLocalAddr(SERVER_ADDRESS);
+        received->setLocalPort(DHCP4_SERVER_PORT);
+        if (query->isRelayed()) {
+            received->setRemoteAddr(RELAY_ADDRESS);
+            received->setRemotePort(DHCP4_SERVER_PORT);
+        } else {
+            received->setRemoteAddr(query->getCiaddr());
+            received->setRemotePort(DHCP4_CLIENT_PORT);
+        }
+    }
+    ++stats.queries_;
+
+    Pkt4Ptr rsp;
+    {
+        StageTimer timer(stats, STAGE_PROCESS);
+        server.processPacket(received, rsp, false);
+    }
+    if (!rsp) {
+        return (rsp);
+    }
+
+    {
+        StageTimer timer(stats, STAGE_PACK);
+        rsp->pack();
+    }
+    ++stats.responses_;
+    if (rsp->getType() == DHCPNAK) {
+        ++stats.naks_;
+    }
+    return (rsp);
+}
+
+/// @brief Runs a four-way exchange of a client.
+///
+/// @param server The server.
+/// @param client The client.
+/// @param xid The transaction id.
+/// @param stats The measurements of the current thread.
+/// @return true if the client got a lease.
+bool
+dora(Dhcpv4Srv& server, Client& client, uint32_t xid, Stats& stats) {
+    client.address_ = IOAddress::IPV4_ZERO_ADDRESS();
+    Pkt4Ptr offer = exchange(server, createQuery(client, DHCPDISCOVER, xid),
+                             stats);
+    if (!offer || (offer->getType() != DHCPOFFER)) {
+        return (false);
+    }
+    OptionPtr server_id = offer->getOption(DHO_DHCP_SERVER_IDENTIFIER);
+    if (!server_id) {
+        return (false);
+    }
+
+    Pkt4Ptr request = createQuery(client, DHCPREQUEST, xid);
+    request->addOption(server_id);
+    request->addOption(OptionPtr(new Option(Option::V4,
+                                            DHO_DHCP_REQUESTED_ADDRESS,
+                                            offer->getYiaddr().toBytes())));
+
+    Pkt4Ptr ack = exchange(server, request, stats);
+    if (!ack || (ack->getType() != DHCPACK)) {
+        return (false);
+    }
+    client.address_ = ack->getYiaddr();
+    return (true);
+}
+
+/// @brief Runs a renewal of a client.
+///
+/// @param server The server.
+/// @param client The client, holding a lease.
+/// @param xid The transaction id.
+/// @param stats The measurements of the current thread.
+/// @return true if the lease was renewed.
+bool
+renew(Dhcpv4Srv& server, Client& client, uint32_t xid, Stats& stats) {
+    Pkt4Ptr ack = exchange(server, createQuery(client, DHCPREQUEST, xid),
+                           stats);
+    if (!ack || (ack->getType() != DHCPACK)) {
+        client.address_ = IOAddress::IPV4_ZERO_ADDRESS();
+        return (false);
+    }
+    return (true);
+}
+
+/// @brief Parameters of a run.
+struct Parameters {
+    /// @brief Constructor.
+    Parameters() : threads_(1), clients_(1000), transactions_(100000),
+                   renew_percent_(50), config_file_() {
+    }
+
+    /// @brief Number of threads giving queries to the server.
+    uint32_t threads_;
+
+    /// @brief Number of simulated clients.
+    uint32_t clients_;
+
+    /// @brief Number of exchanges.
+    uint64_t transactions_;
+
+    /// @brief Percentage of the exchanges which are renewals when the
+    /// client has a lease.
+    uint32_t renew_percent_;
+
+    /// @brief The configuration file, the built-in configuration is used
+    /// when empty.
+    string config_file_;
+};
+
+/// @brief Runs the exchanges of a thread.
+///
+/// @param server The server.
+/// @param params The parameters of the run.
+/// @param thread Index of the thread.
+/// @param stats The measurements of the thread.
+void
+runThread(Dhcpv4Srv& server, const Parameters& params, uint32_t thread,
+          Stats& stats) {
+    // Each thread has its own clients so a client never has concurrent
+    // exchanges.
+    uint32_t first = (params.clients_ * static_cast<uint64_t>(thread)) /
+                     params.threads_;
+    uint32_t last = (params.clients_ * static_cast<uint64_t>(thread + 1)) /
+                    params.threads_;
+    uint64_t transactions = params.transactions_ / params.threads_;
+    if (thread < params.transactions_ % params.threads_) {
+        ++transactions;
+    }
+    if (first == last) {
+        return;
+    }
+
+    vector<Client> clients;
+    clients.reserve(last - first);
+    for (uint32_t index = first; index < last; ++index) {
+        clients.push_back(Client(index + 1));
+    }
+
+    minstd_rand random(thread + 1);
+    uint32_t xid = thread << 24;
+    for (uint64_t count = 0; count < transactions; ++count) {
+        Client& client = clients[count % clients.size()];
+        bool success = false;
+        try {
+            if (!client.address_.isV4Zero() &&
+                (random() % 100 < params.renew_percent_)) {
+                success = renew(server, client, ++xid, stats);
+            } else {
+                success = dora(server, client, ++xid, stats);
+            }
+        } catch (const std::exception&) {
+            client.address_ = IOAddress::IPV4_ZERO_ADDRESS();
+        }
+        ++stats.transactions_;
+        if (!success) {
+            ++stats.failures_;
+        }
+    }
+}
+
+/// @brief Configures the server.
+///
+/// @param server The server.
+/// @param params The parameters of the run.
+void
+configure(Dhcpv4Srv& server, const Parameters& params) {
+    Parser4Context parser;
+    ElementPtr json;
+    if (params.config_file_.empty()) {
+        json = parser.parseString(DEFAULT_CONFIG, Parser4Context::PARSER_DHCP4);
+    } else {
+        json = parser.parseFile(params.config_file_,
+                                Parser4Context::PARSER_DHCP4);
+    }
+    ConstElementPtr dhcp4 = json ? json->get("Dhcp4") : ConstElementPtr();
+    if (!dhcp4) {
+        isc_throw(BadValue, "no Dhcp4 configuration found");
+    }
+
+    ConstElementPtr result = configureDhcp4Server(server, dhcp4);
+    int rcode;
+    ConstElementPtr comment = config::parseAnswer(rcode, result);
+    if (rcode != config::CONTROL_RESULT_SUCCESS) {
+        isc_throw(BadValue, "configuration failed: "
+                  << (comment ? comment->stringValue() : "no details available"));
+    }
+    CfgMgr::instance().commit();
+}
+
+/// @brief Prints the measurements.
+///
+/// @param params The parameters of the run.
+/// @param stats The measurements of all threads.
+/// @param elapsed The duration of the run in seconds.
+void
+report(const Parameters& params, const Stats& stats, double elapsed) {
+    cout << "threads:          " << params.threads_ << endl
+         << "clients:          " << params.clients_ << endl
+         << "renewals:         " << params.renew_percent_ << "%" << endl
+         << "exchanges:        " << stats.transactions_
+         << " (" << stats.failures_ << " failed)" << endl
+         << "queries:          " << stats.queries_ << endl
+         << "responses:        " << stats.responses_
+         << " (" << stats.naks_ << " DHCPNAK)" << endl
+         << "elapsed:          " << fixed << setprecision(3) << elapsed
+         << " s" << endl;
+    if (elapsed > 0) {
+        cout << "exchanges/s:      " << setprecision(0)
+             << stats.transactions_ / elapsed << endl
+             << "queries/s:        " << stats.queries_ / elapsed << endl;
+    }
+
+    if (!stats.queries_) {
+        return;
+    }
+    cout << endl
+         << left << setw(10) << "stage"
+         << right << setw(14) << "cpu (ms)"
+         << setw(16) << "cpu/query (us)"
+         << setw(18) << "allocs/query" << endl;
+    uint64_t total_cpu_ns = 0;
+    uint64_t total_allocations = 0;
+    for (int stage = 0; stage <= STAGE_COUNT; ++stage) {
+        uint64_t cpu_ns;
+        uint64_t allocs;
+        const char* name;
+        if (stage < STAGE_COUNT) {
+            cpu_ns = stats.cpu_ns_[stage];
+            allocs = stats.allocations_[stage];
+            name = STAGE_NAMES[stage];
+            total_cpu_ns += cpu_ns;
+            total_allocations += allocs;
+        } else {
+            cpu_ns = total_cpu_ns;
+            allocs = total_allocations;
+            name = "total";
+        }
+        cout << left << setw(10) << name
+             << right << setw(14) << setprecision(1) << cpu_ns / 1e6
+             << setw(16) << setprecision(2)
+             << cpu_ns / 1e3 / stats.queries_
+             << setw(18) << setprecision(1)
+             << static_cast<double>(allocs) / stats.queries_ << endl;
+    }
+}
+
+/// @brief Prints the usage and exits.
+void
+usage() {
+    cerr << "Usage: " << BENCH_NAME
+         << " [-c file] [-t threads] [-n exchanges] [-C clients] [-r percent]"
+         << endl;
+    cerr << "  -c file: server configuration file, the lease-database selects"
+         << " the backend" << endl;
+    cerr << "           (default: built-in with an in-memory memfile)" << endl;
+    cerr << "  -t threads: number of threads giving queries to the server, the"
+         << " multi-threading" << endl;
+    cerr << "           mode is enabled when more than one (default: 1)" << endl;
+    cerr << "  -n exchanges: number of DORA or renew exchanges (default: 100000)"
+         << endl;
+    cerr << "  -C clients: number of simulated clients (default: 1000)" << endl;
+    cerr << "  -r percent: percentage of renewals by the clients holding a"
+         << " lease (default: 50)" << endl;
+    exit(EXIT_FAILURE);
+}
+
+/// @brief Parses a positive integer argument.
+///
+/// @param option The option letter.
+/// @param arg The argument.
+/// @param min The minimum value.
+/// @param max The maximum value.
+/// @return The value.
+uint64_t
+parseValue(char option, const char* arg, uint64_t min, uint64_t max) {
+    int64_t value = 0;
+    try {
+        value = boost::lexical_cast<int64_t>(arg);
+    } catch (const boost::bad_lexical_cast&) {
+        value = -1;
+    }
+    if ((value < 0) || (static_cast<uint64_t>(value) < min) ||
+        (static_cast<uint64_t>(value) > max)) {
+        cerr << "Invalid -" << option << " value: [" << arg << "], "
+             << min << "-" << max << " allowed." << endl;
+        usage();
+    }
+    return (static_cast<uint64_t>(value));
+}
+
+} // end of anonymous namespace
+
+int
+main(int argc, char* argv[]) {
+    Parameters params;
+    int ch;
+    while ((ch = getopt(argc, argv, "c:t:n:C:r:")) != -1) {
+        switch (ch) {
+        case 'c':
+            params.config_file_ = optarg;
+            break;
+
+        case 't':
+            params.threads_ = parseValue(ch, optarg, 1, 1024);
+            break;
+
+        case 'n':
+            params.transactions_ = parseValue(ch, optarg, 1,
+                                              numeric_limits<int64_t>::max());
+            break;
+
+        case 'C':
+            params.clients_ = parseValue(ch, optarg, 1, 0xffffff);
+            break;
+
+        case 'r':
+            params.renew_percent_ = parseValue(ch, optarg, 0, 100);
+            break;
+
+        default:
+            usage();
+        }
+    }
+    if (argc > optind) {
+        usage();
+    }
+
+    // Only the warnings and errors are logged to not measure the logging.
+    isc::log::initLogger(BENCH_NAME, isc::log::WARN);
+
+    try {
+        MultiThreadingMgr::instance().setMode(params.threads_ > 1);
+
+        // The port 0 makes the server not open any socket.
+        Dhcpv4Srv server(0);
+        configure(server, params);
+
+        vector<Stats> stats(params.threads_);
+        auto start = chrono::steady_clock::now();
+        if (params.threads_ == 1) {
+            runThread(server, params, 0, stats[0]);
+        } else {
+            vector<thread> threads;
+            for (uint32_t i = 0; i < params.threads_; ++i) {
+                threads.push_back(thread(runThread, ref(server), cref(params),
+                                         i, ref(stats[i])));
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+        Stats total;
+        for (auto const& s : stats) {
+            total.add(s);
+        }
+        report(params, total, elapsed.count());
+
+        MultiThreadingMgr::instance().setMode(false);
+    } catch (const std::exception& ex) {
+        cerr << BENCH_NAME << ": " << ex.what() << endl;
+        return (EXIT_FAILURE);
+    }
+
+    return (EXIT_SUCCESS);
+}
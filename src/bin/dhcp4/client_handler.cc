@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,6 +12,8 @@
 #include <stats/stats_mgr.h>
 #include <util/multi_threading_mgr.h>
 
+#include <boost/functional/hash.hpp>
+
 using namespace std;
 using namespace isc::util;
 using namespace isc::log;
@@ -40,28 +42,70 @@ ClientHandler::Client::Client(Pkt4Ptr query, DuidPtr client_id,
     }
 }
 
-mutex ClientHandler::mutex_;
+const size_t ClientHandler::SHARDS;
+
+ClientHandler::Shard ClientHandler::shards_[SHARDS];
 
-ClientHandler::ClientByIdContainer ClientHandler::clients_client_id_;
+ClientHandler::ShardLocker::ShardLocker(Shard* first, Shard* second)
+    : first_(first), second_(second) {
+    // Lock a shard once and in the order of the shards in the array.
+    if (first_ == second_) {
+        second_ = 0;
+    } else if (!first_ || (second_ && (second_ < first_))) {
+        swap(first_, second_);
+    }
+    if (first_) {
+        first_->mutex_.lock();
+    }
+    if (second_) {
+        second_->mutex_.lock();
+    }
+}
 
-ClientHandler::ClientByHWAddrContainer ClientHandler::clients_hwaddr_;
+ClientHandler::ShardLocker::~ShardLocker() {
+    if (second_) {
+        second_->mutex_.unlock();
+    }
+    if (first_) {
+        first_->mutex_.unlock();
+    }
+}
+
+ClientHandler::Shard*
+ClientHandler::getShard(const DuidPtr& duid) {
+    if (!duid) {
+        return (0);
+    }
+    const vector<uint8_t>& bin = duid->getDuid();
+    return (&shards_[boost::hash_range(bin.begin(), bin.end()) % SHARDS]);
+}
+
+ClientHandler::Shard*
+ClientHandler::getShard(const HWAddrPtr& hwaddr) {
+    if (!hwaddr) {
+        return (0);
+    }
+    size_t seed = hwaddr->htype_;
+    boost::hash_range(seed, hwaddr->hwaddr_.begin(), hwaddr->hwaddr_.end());
+    return (&shards_[seed % SHARDS]);
+}
 
 ClientHandler::ClientPtr
-ClientHandler::lookup(const DuidPtr& duid) {
+ClientHandler::lookup(Shard& shard, const DuidPtr& duid) {
     // Sanity check.
     if (!duid) {
         isc_throw(InvalidParameter, "null duid in ClientHandler::lookup");
     }
 
-    auto it = clients_client_id_.find(duid->getDuid());
-    if (it == clients_client_id_.end()) {
+    auto it = shard.clients_client_id_.find(duid->getDuid());
+    if (it == shard.clients_client_id_.end()) {
         return (ClientPtr());
     }
     return (*it);
 }
 
 ClientHandler::ClientPtr
-ClientHandler::lookup(const HWAddrPtr& hwaddr) {
+ClientHandler::lookup(Shard& shard, const HWAddrPtr& hwaddr) {
     // Sanity checks.
     if (!hwaddr) {
         isc_throw(InvalidParameter, "null hwaddr in ClientHandler::lookup");
@@ -71,26 +115,26 @@ ClientHandler::lookup(const HWAddrPtr& hwaddr) {
     }
 
     auto key = boost::make_tuple(hwaddr->htype_, hwaddr->hwaddr_);
-    auto it = clients_hwaddr_.find(key);
-    if (it == clients_hwaddr_.end()) {
+    auto it = shard.clients_hwaddr_.find(key);
+    if (it == shard.clients_hwaddr_.end()) {
         return (ClientPtr());
     }
     return (*it);
 }
 
 void
-ClientHandler::addById(const ClientPtr& client) {
+ClientHandler::addById(Shard& shard, const ClientPtr& client) {
     // Sanity check.
     if (!client) {
         isc_throw(InvalidParameter, "null client in ClientHandler::addById");
     }
 
     // Assume insert will never fail so not checking its result.
-    clients_client_id_.insert(client);
+    shard.clients_client_id_.insert(client);
 }
 
 void
-ClientHandler::addByHWAddr(const ClientPtr& client) {
+ClientHandler::addByHWAddr(Shard& shard, const ClientPtr& client) {
     // Sanity check.
     if (!client) {
         isc_throw(InvalidParameter,
@@ -98,22 +142,22 @@ ClientHandler::addByHWAddr(const ClientPtr& client) {
     }
 
     // Assume insert will never fail so not checking its result.
-    clients_hwaddr_.insert(client);
+    shard.clients_hwaddr_.insert(client);
 }
 
 void
-ClientHandler::del(const DuidPtr& duid) {
+ClientHandler::del(Shard& shard, const DuidPtr& duid) {
     // Sanity check.
     if (!duid) {
         isc_throw(InvalidParameter, "null duid in ClientHandler::del");
     }
 
     // Assume erase will never fail so not checking its result.
-    clients_client_id_.erase(duid->getDuid());
+    shard.clients_client_id_.erase(duid->getDuid());
 }
 
 void
-ClientHandler::del(const HWAddrPtr& hwaddr) {
+ClientHandler::del(Shard& shard, const HWAddrPtr& hwaddr) {
     // Sanity checks.
     if (!hwaddr) {
         isc_throw(InvalidParameter, "null hwaddr in ClientHandler::del");
@@ -124,12 +168,12 @@ ClientHandler::del(const HWAddrPtr& hwaddr) {
 
     auto key = boost::make_tuple(hwaddr->htype_, hwaddr->hwaddr_);
     // Assume erase will never fail so not checking its result.
-    auto it = clients_hwaddr_.find(key);
-    if (it == clients_hwaddr_.end()) {
+    auto it = shard.clients_hwaddr_.find(key);
+    if (it == shard.clients_hwaddr_.end()) {
         // Should not happen.
         return;
     }
-    clients_hwaddr_.erase(it);
+    shard.clients_hwaddr_.erase(it);
 }
 
 ClientHandler::ClientHandler()
@@ -137,21 +181,25 @@ ClientHandler::ClientHandler()
 }
 
 ClientHandler::~ClientHandler() {
-    bool unlocked = false;
-    lock_guard<mutex> lk(mutex_);
+    if (!locked_client_id_ && !locked_hwaddr_) {
+        return;
+    }
+    // A handler waiting for this client modifies it holding the mutex of
+    // one of these shards.
+    Shard* shard_id = getShard(locked_client_id_);
+    Shard* shard_hw = getShard(locked_hwaddr_);
+    ShardLocker lk(shard_id, shard_hw);
     if (locked_client_id_) {
-        unlocked = true;
-        unLockById();
+        unLockById(*shard_id);
     }
     if (locked_hwaddr_) {
-        unlocked = true;
-        unLockByHWAddr();
+        unLockByHWAddr(*shard_hw);
     }
-    if (!unlocked || !client_ || !client_->cont_) {
+    if (!client_ || !client_->cont_) {
         return;
     }
-    // Try to process next query. As the caller holds the mutex of
-    // the handler class the continuation will be resumed after.
+    // Try to process next query. As the caller holds the mutexes of
+    // the shards the continuation will be resumed after.
     MultiThreadingMgr& mt_mgr = MultiThreadingMgr::instance();
     if (mt_mgr.getMode()) {
         if (!mt_mgr.getThreadPool().addFront(client_->cont_)) {
@@ -197,15 +245,19 @@ ClientHandler::tryLock(Pkt4Ptr query, ContinuationPtr cont) {
     client_.reset(new Client(query, duid, hwaddr));
 
     {
-        lock_guard<mutex> lk(mutex_);
+        // Lock the shards of both identifiers so the whole lookup is
+        // atomic as with a global mutex.
+        Shard* shard_id = getShard(duid);
+        Shard* shard_hw = getShard(hwaddr);
+        ShardLocker lk(shard_id, shard_hw);
         // Try first duid.
         if (duid) {
             // Try to acquire the by-client-id lock and return the holder
             // when it failed.
-            holder_id = lookup(duid);
+            holder_id = lookup(*shard_id, duid);
             if (!holder_id) {
                 locked_client_id_ = duid;
-                lockById();
+                lockById(*shard_id);
             } else if (cont) {
                 next_query_id = holder_id->next_query_;
                 holder_id->next_query_ = query;
@@ -218,10 +270,10 @@ ClientHandler::tryLock(Pkt4Ptr query, ContinuationPtr cont) {
             }
             // Try to acquire the by-hw-addr lock and return the holder
             // when it failed.
-            holder_hw = lookup(hwaddr);
+            holder_hw = lookup(*shard_hw, hwaddr);
             if (!holder_hw) {
                 locked_hwaddr_ = hwaddr;
-                lockByHWAddr();
+                lockByHWAddr(*shard_hw);
                 return (true);
             } else if (cont) {
                 next_query_hw = holder_hw->next_query_;
@@ -286,47 +338,47 @@ ClientHandler::tryLock(Pkt4Ptr query, ContinuationPtr cont) {
 }
 
 void
-ClientHandler::lockById() {
+ClientHandler::lockById(Shard& shard) {
     // Sanity check.
     if (!locked_client_id_) {
         isc_throw(Unexpected, "nothing to lock in ClientHandler::lockById");
     }
 
-    addById(client_);
+    addById(shard, client_);
 }
 
 void
-ClientHandler::lockByHWAddr() {
+ClientHandler::lockByHWAddr(Shard& shard) {
     // Sanity check.
     if (!locked_hwaddr_) {
         isc_throw(Unexpected,
                   "nothing to lock in ClientHandler::lockByHWAddr");
     }
 
-    addByHWAddr(client_);
+    addByHWAddr(shard, client_);
 }
 
 void
-ClientHandler::unLockById() {
+ClientHandler::unLockById(Shard& shard) {
     // Sanity check.
     if (!locked_client_id_) {
         isc_throw(Unexpected,
                   "nothing to unlock in ClientHandler::unLockById");
     }
 
-    del(locked_client_id_);
+    del(shard, locked_client_id_);
     locked_client_id_.reset();
 }
 
 void
-ClientHandler::unLockByHWAddr() {
+ClientHandler::unLockByHWAddr(Shard& shard) {
     // Sanity check.
     if (!locked_hwaddr_) {
         isc_throw(Unexpected,
                   "nothing to unlock in ClientHandler::unLockByHWAddr");
     }
 
-    del(locked_hwaddr_);
+    del(shard, locked_hwaddr_);
     locked_hwaddr_.reset();
 }
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -69,13 +69,13 @@ private:
         /// @brief The next query.
         ///
         /// @note This field can be modified from another handler
-        /// holding the mutex.
+        /// holding the mutex of a shard of the client.
         Pkt4Ptr next_query_;
 
         /// @brief The continuation to process next query for the client.
         ///
         /// @note This field can be modified from another handler
-        /// holding the mutex.
+        /// holding the mutex of a shard of the client.
         ContinuationPtr cont_;
     };
 
@@ -128,60 +128,115 @@ private:
         >
     > ClientByHWAddrContainer;
 
+    /// @brief Number of shards of the client containers.
+    ///
+    /// The clients are spread over the shards by a hash of their
+    /// identifiers so the threads processing different clients do not
+    /// wait for each other.
+    static const size_t SHARDS = 64;
+
+    /// @brief A shard of the client containers.
+    struct Shard {
+        /// @brief Mutex to protect the client containers of the shard.
+        std::mutex mutex_;
+
+        /// @brief The client-by-id container.
+        ClientByIdContainer clients_client_id_;
+
+        /// @brief The client-by-hwaddr container.
+        ClientByHWAddrContainer clients_hwaddr_;
+    };
+
+    /// @brief RAII locker of the shards holding the identifiers of a client.
+    ///
+    /// The mutexes are locked in a fixed order so handlers locking the
+    /// same two shards can't deadlock.
+    class ShardLocker : public boost::noncopyable {
+    public:
+        /// @brief Constructor.
+        ///
+        /// @param first The shard of the client ID or null.
+        /// @param second The shard of the hardware address or null.
+        ShardLocker(Shard* first, Shard* second);
+
+        /// @brief Destructor.
+        ///
+        /// Unlocks the mutexes.
+        ~ShardLocker();
+
+    private:
+        /// @brief The first locked shard or null.
+        Shard* first_;
+
+        /// @brief The second locked shard or null.
+        Shard* second_;
+    };
+
+    /// @brief Get the shard of a client ID.
+    ///
+    /// @param duid The client ID.
+    /// @return The shard holding the client ID, null if duid is null.
+    static Shard* getShard(const DuidPtr& duid);
+
+    /// @brief Get the shard of a hardware address.
+    ///
+    /// @param hwaddr The hardware address.
+    /// @return The shard holding the hardware address, null if hwaddr is
+    /// null.
+    static Shard* getShard(const HWAddrPtr& hwaddr);
+
     /// @brief Lookup a client by id.
     ///
-    /// The mutex must be held by the caller.
+    /// The mutex of the shard must be held by the caller.
     ///
+    /// @param shard The shard of the duid.
     /// @param duid The duid of the query from the client.
     /// @return The client found in the by client id container or null.
-    static ClientPtr lookup(const DuidPtr& duid);
+    static ClientPtr lookup(Shard& shard, const DuidPtr& duid);
 
     /// @brief Lookup a client by hwaddr.
     ///
-    /// The mutex must be held by the caller.
+    /// The mutex of the shard must be held by the caller.
     ///
+    /// @param shard The shard of the hwaddr.
     /// @param hwaddr The hardware address of the query from the client.
     /// @return The client found in the by hardware address container or null.
-    static ClientPtr lookup(const HWAddrPtr& hwaddr);
+    static ClientPtr lookup(Shard& shard, const HWAddrPtr& hwaddr);
 
     /// @brief Add a client by id.
     ///
-    /// The mutex must be held by the caller.
+    /// The mutex of the shard must be held by the caller.
     ///
+    /// @param shard The shard of the client ID.
     /// @param client The client to insert into the by id client container.
-    static void addById(const ClientPtr& client);
+    static void addById(Shard& shard, const ClientPtr& client);
 
     /// @brief Add a client by hwaddr.
     ///
-    /// The mutex must be held by the caller.
+    /// The mutex of the shard must be held by the caller.
     ///
+    /// @param shard The shard of the hardware address.
     /// @param client The client to insert into the by hwaddr client container.
-    static void addByHWAddr(const ClientPtr& client);
+    static void addByHWAddr(Shard& shard, const ClientPtr& client);
 
     /// @brief Delete a client by id.
     ///
-    /// The mutex must be held by the caller.
+    /// The mutex of the shard must be held by the caller.
     ///
+    /// @param shard The shard of the duid.
     /// @param duid The duid to delete from the by id client container.
-    static void del(const DuidPtr& duid);
+    static void del(Shard& shard, const DuidPtr& duid);
 
     /// @brief Delete a client by hwaddr.
     ///
-    /// The mutex must be held by the caller.
+    /// The mutex of the shard must be held by the caller.
     ///
+    /// @param shard The shard of the hwaddr.
     /// @param hwaddr The hwaddr to delete from the by hwaddr client container.
-    static void del(const HWAddrPtr& hwaddr);
+    static void del(Shard& shard, const HWAddrPtr& hwaddr);
 
-    /// @brief Mutex to protect client containers.
-    ///
-    /// The mutex is used only by public methods for guards.
-    static std::mutex mutex_;
-
-    /// @brief The client-by-id container.
-    static ClientByIdContainer clients_client_id_;
-
-    /// @brief The client-by-hwaddr container.
-    static ClientByHWAddrContainer clients_hwaddr_;
+    /// @brief The shards of the client containers.
+    static Shard shards_[SHARDS];
 
 public:
 
@@ -214,23 +269,31 @@ private:
 
     /// @brief Acquire a client by client ID option.
     ///
-    /// The mutex must be held by the caller.
-    void lockById();
+    /// The mutex of the shard must be held by the caller.
+    ///
+    /// @param shard The shard of the client ID.
+    void lockById(Shard& shard);
 
     /// @brief Acquire a client by hardware address.
     ///
-    /// The mutex must be held by the caller.
-    void lockByHWAddr();
+    /// The mutex of the shard must be held by the caller.
+    ///
+    /// @param shard The shard of the hardware address.
+    void lockByHWAddr(Shard& shard);
 
     /// @brief Release a client by client ID option.
     ///
-    /// The mutex must be held by the caller.
-    void unLockById();
+    /// The mutex of the shard must be held by the caller.
+    ///
+    /// @param shard The shard of the client ID.
+    void unLockById(Shard& shard);
 
     /// @brief Release a client by hardware address.
     ///
-    /// The mutex must be held by the caller.
-    void unLockByHWAddr();
+    /// The mutex of the shard must be held by the caller.
+    ///
+    /// @param shard The shard of the hardware address.
+    void unLockByHWAddr(Shard& shard);
 
     /// @brief Local client.
     ClientPtr client_;
@@ -9,6 +9,7 @@
 #include <cc/command_interpreter.h>
 #include <cc/data.h>
 #include <config/command_mgr.h>
+#include <dhcp/iface_mgr.h>
 #include <dhcp/libdhcp++.h>
 #include <dhcp4/ctrl_dhcp4_srv.h>
 #include <dhcp4/dhcp4_log.h>
@@ -18,6 +19,7 @@
 #include <dhcpsrv/cfg_db_access.h>
 #include <dhcpsrv/cfg_multi_threading.h>
 #include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/config_backend_dhcp4_mgr.h>
 #include <dhcpsrv/db_type.h>
 #include <dhcpsrv/host_mgr.h>
 #include <dhcpsrv/lease_mgr_factory.h>
@@ -28,6 +30,7 @@
 #include <util/multi_threading_mgr.h>
 
 #include <signal.h>
+#include <sys/resource.h>
 
 #include <sstream>
 
@@ -61,6 +64,19 @@ struct CtrlDhcp4Hooks {
 // module is called.
 CtrlDhcp4Hooks Hooks;
 
+/// @brief Number of threads processing the read-only commands in
+/// multi-threading mode.
+const uint32_t COMMAND_EXECUTOR_THREAD_COUNT = 2;
+
+/// @brief Name of the timer maintaining the memory of the subnets.
+const char* MEMORY_MAINTENANCE_TIMER_NAME = "Dhcp4MemoryMaintenanceTimer";
+
+/// @brief Interval of the memory maintenance in milliseconds.
+const long MEMORY_MAINTENANCE_INTERVAL = 60000;
+
+/// @brief Fragmentation above which an allocation state is compacted.
+const double MEMORY_COMPACTION_THRESHOLD = 0.5;
+
 /// @brief Signals handler for DHCPv4 server.
 ///
 /// This signal handler handles the following signals received by the DHCPv4
@@ -691,8 +707,8 @@ ControlledDhcpv4Srv::commandConfigBackendPullHandler(const std::string&,
         return (createAnswer(CONTROL_RESULT_EMPTY, "No config backend."));
     }
 
-    // stop thread pool (if running)
-    MultiThreadingCriticalSection cs;
+    // The thread pool is stopped only while the fetched updates are
+    // applied to the current configuration.
 
     // Reschedule the periodic CB fetch.
     if (TimerMgr::instance()->isTimerRegistered("Dhcp4CBFetchTimer")) {
@@ -718,6 +734,55 @@ ControlledDhcpv4Srv::commandConfigBackendPullHandler(const std::string&,
                          "On demand configuration update successful."));
 }
 
+ConstElementPtr
+ControlledDhcpv4Srv::commandMemoryStatsHandler(const string&,
+                                               ConstElementPtr /*args*/) {
+    ElementPtr stats = Element::createMap();
+
+    ElementPtr leases = Element::createMap();
+    if (LeaseMgrFactory::haveInstance()) {
+        leases = LeaseMgrFactory::instance().getMemoryStats();
+    }
+    if (alloc_engine_) {
+        leases->set("affinity", Element::create(static_cast<int64_t>(
+                        alloc_engine_->getLeaseAffinity().size())));
+    }
+    stats->set("leases", leases);
+
+    SrvConfigPtr cfg = CfgMgr::instance().getCurrentCfg();
+    ElementPtr hosts = Element::createMap();
+    hosts->set("configured", Element::create(static_cast<int64_t>(
+                   cfg->getCfgHosts()->size())));
+    hosts->set("cache", Element::create(static_cast<int64_t>(
+                   HostMgr::instance().getCacheSize())));
+    stats->set("hosts", hosts);
+
+    stats->set("subnets", Element::create(static_cast<int64_t>(
+                   cfg->getCfgSubnets4()->getAll()->size())));
+
+    ElementPtr caches = Element::createMap();
+    caches->set("requested-options", Element::create(static_cast<int64_t>(
+                    requested_options_cache_.size())));
+    caches->set("merged-options", Element::create(static_cast<int64_t>(
+                    merged_options_cache_.size())));
+    stats->set("option-caches", caches);
+
+    stats->set("statistics", Element::create(static_cast<int64_t>(
+                   StatsMgr::instance().count())));
+
+    // ru_maxrss is in kilobytes on Linux and the BSDs but in bytes on macOS.
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        int64_t max_rss = usage.ru_maxrss;
+#ifdef __APPLE__
+        max_rss /= 1024;
+#endif
+        stats->set("max-rss", Element::create(max_rss));
+    }
+
+    return (createAnswer(CONTROL_RESULT_SUCCESS, stats));
+}
+
 ConstElementPtr
 ControlledDhcpv4Srv::commandStatusGetHandler(const string&,
                                              ConstElementPtr /*args*/) {
@@ -958,6 +1023,9 @@ ControlledDhcpv4Srv::processConfig(isc::data::ConstElementPtr config) {
     try {
         data::ConstElementPtr qc;
         qc = CfgMgr::instance().getStagingCfg()->getDHCPQueueControl();
+        IfaceMgr::instance().setReceiverCpuAffinity(
+            CfgMultiThreading::extractCpuAffinity(CfgMgr::instance().getStagingCfg()->getDHCPMultiThreading(),
+                                                  "receiver-cpu-affinity"));
         if (IfaceMgr::instance().configureDHCPPacketQueue(AF_INET, qc)) {
             LOG_INFO(dhcp4_logger, DHCP4_CONFIG_PACKET_QUEUE)
                      .arg(IfaceMgr::instance().getPacketQueue4()->getInfoStr());
@@ -999,6 +1067,17 @@ ControlledDhcpv4Srv::processConfig(isc::data::ConstElementPtr config) {
         return (isc::config::createAnswer(CONTROL_RESULT_ERROR, err.str()));
     }
 
+    // Install the timer maintaining the memory of the subnets.
+    TimerMgr::instance()->registerTimer(MEMORY_MAINTENANCE_TIMER_NAME,
+                                        std::bind(&ControlledDhcpv4Srv::maintainMemory,
+                                                  server_),
+                                        MEMORY_MAINTENANCE_INTERVAL,
+                                        asiolink::IntervalTimer::ONE_SHOT);
+    TimerMgr::instance()->setup(MEMORY_MAINTENANCE_TIMER_NAME);
+
+    // The change notification sockets belong to the previous backends.
+    server_->cbUnwatchNotifications();
+
     // Setup config backend polling, if configured for it.
     auto ctl_info = CfgMgr::instance().getStagingCfg()->getConfigControlInfo();
     if (ctl_info) {
@@ -1024,6 +1103,11 @@ ControlledDhcpv4Srv::processConfig(isc::data::ConstElementPtr config) {
                               fetch_time,
                               asiolink::IntervalTimer::ONE_SHOT);
             TimerMgr::instance()->setup("Dhcp4CBFetchTimer");
+
+            // Fetch the updates as soon as they are notified by the
+            // backends supporting it.
+            server_->cbWatchNotifications(CfgMgr::instance().getStagingCfg(),
+                                          failure_count);
         }
     }
 
@@ -1039,15 +1123,30 @@ ControlledDhcpv4Srv::processConfig(isc::data::ConstElementPtr config) {
 
     // Initialize the allocators. If the user selected a Free Lease Queue Allocator
     // for any of the subnets, the server will now populate free leases to the queue.
-    // It may take a while!
+    // It may take a while! The unchanged subnets keep their allocation states
+    // from the current configuration, the ones using a Free Lease Queue
+    // Allocator only when the lease database did not change.
     try {
-        CfgMgr::instance().getStagingCfg()->getCfgSubnets4()->initAllocatorsAfterConfigure();
+        auto const& current_cfg = CfgMgr::instance().getCurrentCfg();
+        auto const& staging_cfg = CfgMgr::instance().getStagingCfg();
+        staging_cfg->getCfgSubnets4()->
+            initAllocatorsAfterConfigure(current_cfg->getCfgSubnets4(),
+                                         staging_cfg->sameLeaseDatabase(*current_cfg));
 
     } catch (const std::exception& ex) {
         err << "Error initializing the lease allocators: "
             << ex.what();
     }
 
+    // The sender is not thread safe when the multi-threading mode is
+    // disabled: stop its thread before applying the new settings.
+    try {
+        CfgMgr::instance().getD2ClientMgr().stopSenderThread();
+    } catch (const std::exception& ex) {
+        err << "Error stopping the DHCP-DDNS sender thread: " << ex.what();
+        return (isc::config::createAnswer(CONTROL_RESULT_ERROR, err.str()));
+    }
+
     // Apply multi threading settings.
     // @note These settings are applied/updated only if no errors occur while
     // applying the new configuration.
@@ -1060,6 +1159,26 @@ ControlledDhcpv4Srv::processConfig(isc::data::ConstElementPtr config) {
         return (isc::config::createAnswer(CONTROL_RESULT_ERROR, err.str()));
     }
 
+    // Process the read-only commands in their own threads so they don't
+    // stall the packet processing.
+    if (MultiThreadingMgr::instance().getMode()) {
+        try {
+            CommandMgr::instance().startCommandExecutor(COMMAND_EXECUTOR_THREAD_COUNT);
+        } catch (const std::exception& ex) {
+            err << "Error starting the command executor: " << ex.what();
+            return (isc::config::createAnswer(CONTROL_RESULT_ERROR, err.str()));
+        }
+
+        // Process the DHCP-DDNS sender IO in its own thread so the sends
+        // complete without waiting for the main loop.
+        try {
+            CfgMgr::instance().getD2ClientMgr().startSenderThread();
+        } catch (const std::exception& ex) {
+            err << "Error starting the DHCP-DDNS sender thread: " << ex.what();
+            return (isc::config::createAnswer(CONTROL_RESULT_ERROR, err.str()));
+        }
+    }
+
     return (answer);
 }
 
@@ -1139,6 +1258,15 @@ ControlledDhcpv4Srv::ControlledDhcpv4Srv(uint16_t server_port /*= DHCP4_SERVER_P
     CommandMgr::instance().registerCommand("build-report",
         std::bind(&ControlledDhcpv4Srv::commandBuildReportHandler, this, ph::_1, ph::_2));
 
+    CommandMgr::instance().registerCommand("callout-timing-get",
+        std::bind(&HooksManager::calloutTimingGetHandler, ph::_1, ph::_2));
+
+    CommandMgr::instance().registerCommand("callout-timing-reset",
+        std::bind(&HooksManager::calloutTimingResetHandler, ph::_1, ph::_2));
+
+    CommandMgr::instance().registerCommand("callout-timing-set",
+        std::bind(&HooksManager::calloutTimingSetHandler, ph::_1, ph::_2));
+
     CommandMgr::instance().registerCommand("config-backend-pull",
         std::bind(&ControlledDhcpv4Srv::commandConfigBackendPullHandler, this, ph::_1, ph::_2));
 
@@ -1169,6 +1297,9 @@ ControlledDhcpv4Srv::ControlledDhcpv4Srv(uint16_t server_port /*= DHCP4_SERVER_P
     CommandMgr::instance().registerCommand("leases-reclaim",
         std::bind(&ControlledDhcpv4Srv::commandLeasesReclaimHandler, this, ph::_1, ph::_2));
 
+    CommandMgr::instance().registerCommand("memory-stats",
+        std::bind(&ControlledDhcpv4Srv::commandMemoryStatsHandler, this, ph::_1, ph::_2));
+
     CommandMgr::instance().registerCommand("server-tag-get",
         std::bind(&ControlledDhcpv4Srv::commandServerTagGetHandler, this, ph::_1, ph::_2));
 
@@ -1194,6 +1325,9 @@ ControlledDhcpv4Srv::ControlledDhcpv4Srv(uint16_t server_port /*= DHCP4_SERVER_P
     CommandMgr::instance().registerCommand("statistic-get-all",
         std::bind(&StatsMgr::statisticGetAllHandler, ph::_1, ph::_2));
 
+    CommandMgr::instance().registerCommand("statistic-latency-get",
+        std::bind(&StatsMgr::statisticLatencyGetHandler, ph::_1, ph::_2));
+
     CommandMgr::instance().registerCommand("statistic-reset-all",
         std::bind(&StatsMgr::statisticResetAllHandler, ph::_1, ph::_2));
 
@@ -1211,6 +1345,29 @@ ControlledDhcpv4Srv::ControlledDhcpv4Srv(uint16_t server_port /*= DHCP4_SERVER_P
 
     CommandMgr::instance().registerCommand("statistic-sample-count-set-all",
         std::bind(&ControlledDhcpv4Srv::commandStatisticSetMaxSampleCountAllHandler, this, ph::_1, ph::_2));
+
+    // Declare the commands which can be processed beside the packets in
+    // multi-threading mode, including the read-only commands of the hooks
+    // libraries.
+    const char* read_only_commands[] = {
+        "build-report",
+        "config-get",
+        "memory-stats",
+        "server-tag-get",
+        "statistic-get",
+        "statistic-get-all",
+        "version-get",
+        "lease4-get",
+        "lease4-get-all",
+        "lease4-get-by-client-id",
+        "lease4-get-by-hostname",
+        "lease4-get-by-hw-address",
+        "lease4-get-page",
+        "stat-lease4-get"
+    };
+    for (auto cmd : read_only_commands) {
+        CommandMgr::instance().addReadOnlyCommand(cmd);
+    }
 }
 
 void ControlledDhcpv4Srv::shutdownServer(int exit_value) {
@@ -1221,6 +1378,8 @@ void ControlledDhcpv4Srv::shutdownServer(int exit_value) {
 
 ControlledDhcpv4Srv::~ControlledDhcpv4Srv() {
     try {
+        CommandMgr::instance().stopCommandExecutor();
+        CfgMgr::instance().getD2ClientMgr().stopSenderThread();
         MultiThreadingMgr::instance().apply(false, 0, 0);
         LeaseMgrFactory::destroy();
         HostMgr::create();
@@ -1234,11 +1393,16 @@ ControlledDhcpv4Srv::~ControlledDhcpv4Srv() {
 
         timer_mgr_->unregisterTimers();
 
+        cbUnwatchNotifications();
+
         // Close the command socket (if it exists).
         CommandMgr::instance().closeCommandSocket();
 
         // Deregister any registered commands (please keep in alphabetic order)
         CommandMgr::instance().deregisterCommand("build-report");
+        CommandMgr::instance().deregisterCommand("callout-timing-get");
+        CommandMgr::instance().deregisterCommand("callout-timing-reset");
+        CommandMgr::instance().deregisterCommand("callout-timing-set");
         CommandMgr::instance().deregisterCommand("config-backend-pull");
         CommandMgr::instance().deregisterCommand("config-get");
         CommandMgr::instance().deregisterCommand("config-reload");
@@ -1249,10 +1413,12 @@ ControlledDhcpv4Srv::~ControlledDhcpv4Srv() {
         CommandMgr::instance().deregisterCommand("dhcp-enable");
         CommandMgr::instance().deregisterCommand("leases-reclaim");
         CommandMgr::instance().deregisterCommand("libreload");
+        CommandMgr::instance().deregisterCommand("memory-stats");
         CommandMgr::instance().deregisterCommand("server-tag-get");
         CommandMgr::instance().deregisterCommand("shutdown");
         CommandMgr::instance().deregisterCommand("statistic-get");
         CommandMgr::instance().deregisterCommand("statistic-get-all");
+        CommandMgr::instance().deregisterCommand("statistic-latency-get");
         CommandMgr::instance().deregisterCommand("statistic-remove");
         CommandMgr::instance().deregisterCommand("statistic-remove-all");
         CommandMgr::instance().deregisterCommand("statistic-reset");
@@ -1285,9 +1451,12 @@ ControlledDhcpv4Srv::reclaimExpiredLeases(const size_t max_leases,
                                           const bool remove_lease,
                                           const uint16_t max_unwarned_cycles) {
     try {
+        // The reclamation runs in parallel with the packet processing
+        // when multi-threading is enabled.
         server_->alloc_engine_->reclaimExpiredLeases4(max_leases, timeout,
                                                       remove_lease,
-                                                      max_unwarned_cycles);
+                                                      max_unwarned_cycles,
+                                                      true);
     } catch (const std::exception& ex) {
         LOG_ERROR(dhcp4_logger, DHCP4_RECLAIM_EXPIRED_LEASES_FAIL)
             .arg(ex.what());
@@ -1303,6 +1472,25 @@ ControlledDhcpv4Srv::deleteExpiredReclaimedLeases(const uint32_t secs) {
     TimerMgr::instance()->setup(CfgExpiration::FLUSH_RECLAIMED_TIMER_NAME);
 }
 
+void
+ControlledDhcpv4Srv::maintainMemory() {
+    try {
+        auto subnets = CfgMgr::instance().getCurrentCfg()->getCfgSubnets4();
+        size_t released = subnets->compactAllocators(MEMORY_COMPACTION_THRESHOLD);
+        if (released > 0) {
+            LOG_DEBUG(dhcp4_logger, DBG_DHCP4_DETAIL,
+                      DHCP4_MEMORY_MAINTENANCE_COMPACTED)
+                .arg(released);
+        }
+        subnets->updateMemoryStatistics();
+    } catch (const std::exception& ex) {
+        LOG_ERROR(dhcp4_logger, DHCP4_MEMORY_MAINTENANCE_FAIL)
+            .arg(ex.what());
+    }
+    // We're using the ONE_SHOT timer so there is a need to re-schedule it.
+    TimerMgr::instance()->setup(MEMORY_MAINTENANCE_TIMER_NAME);
+}
+
 bool
 ControlledDhcpv4Srv::dbLostCallback(ReconnectCtlPtr db_reconnect_ctl) {
     if (!db_reconnect_ctl) {
@@ -1392,9 +1580,9 @@ ControlledDhcpv4Srv::openSocketsFailedCallback(ReconnectCtlPtr reconnect_ctl) {
 void
 ControlledDhcpv4Srv::cbFetchUpdates(const SrvConfigPtr& srv_cfg,
                                     boost::shared_ptr<unsigned> failure_count) {
-    // stop thread pool (if running)
-    MultiThreadingCriticalSection cs;
-
+    // The thread pool is stopped only while the fetched updates are
+    // applied to the current configuration, so it keeps running when
+    // there are no updates.
     try {
         // Fetch any configuration backend updates since our last fetch.
         server_->getCBControl()->databaseConfigFetch(srv_cfg,
@@ -1415,6 +1603,9 @@ ControlledDhcpv4Srv::cbFetchUpdates(const SrvConfigPtr& srv_cfg,
         }
     }
 
+    // Reopened listening connections have new sockets.
+    cbWatchNotifications(srv_cfg, failure_count);
+
     // Reschedule the timer to fetch new updates or re-try if
     // the previous attempt resulted in an error.
     if (TimerMgr::instance()->isTimerRegistered("Dhcp4CBFetchTimer")) {
@@ -1422,5 +1613,47 @@ ControlledDhcpv4Srv::cbFetchUpdates(const SrvConfigPtr& srv_cfg,
     }
 }
 
+void
+ControlledDhcpv4Srv::cbWatchNotifications(const SrvConfigPtr& srv_cfg,
+                                          boost::shared_ptr<unsigned> failure_count) {
+    std::vector<int> sockets =
+        ConfigBackendDHCPv4Mgr::instance().getPool()->getChangeNotificationSockets();
+    if (sockets == cb_notification_sockets_) {
+        return;
+    }
+
+    cbUnwatchNotifications();
+    for (auto socket : sockets) {
+        IfaceMgr::instance().addExternalSocket(socket,
+            std::bind(&ControlledDhcpv4Srv::cbNotified, this, srv_cfg,
+                      failure_count));
+    }
+    cb_notification_sockets_ = sockets;
+}
+
+void
+ControlledDhcpv4Srv::cbUnwatchNotifications() {
+    for (auto socket : cb_notification_sockets_) {
+        IfaceMgr::instance().deleteExternalSocket(socket);
+    }
+    cb_notification_sockets_.clear();
+}
+
+void
+ControlledDhcpv4Srv::cbNotified(const SrvConfigPtr& srv_cfg,
+                                boost::shared_ptr<unsigned> failure_count) {
+    if (!ConfigBackendDHCPv4Mgr::instance().getPool()->consumeChangeNotifications()) {
+        return;
+    }
+
+    LOG_DEBUG(dhcp4_logger, DBG_DHCP4_BASIC, DHCP4_CB_CHANGE_NOTIFIED);
+
+    // The periodic fetch is rescheduled after this one.
+    if (TimerMgr::instance()->isTimerRegistered("Dhcp4CBFetchTimer")) {
+        TimerMgr::instance()->cancel("Dhcp4CBFetchTimer");
+    }
+    cbFetchUpdates(srv_cfg, failure_count);
+}
+
 }  // namespace dhcp
 }  // namespace isc
@@ -15,6 +15,8 @@
 #include <dhcpsrv/timer_mgr.h>
 #include <dhcp4/dhcp4_srv.h>
 
+#include <vector>
+
 namespace isc {
 namespace dhcp {
 
@@ -336,6 +338,19 @@ private:
     commandConfigBackendPullHandler(const std::string& command,
                                     isc::data::ConstElementPtr args);
 
+    /// @brief handler for processing 'memory-stats' command
+    ///
+    /// This handler processes memory-stats command, which returns the
+    /// numbers of entries of the main in-memory containers of the server
+    /// and the maximum resident set size of the process.
+    ///
+    /// @param command (ignored)
+    /// @param args (ignored)
+    /// @return memory usage information wrapped in a response
+    isc::data::ConstElementPtr
+    commandMemoryStatsHandler(const std::string& command,
+                              isc::data::ConstElementPtr args);
+
     /// @brief handler for processing 'status-get' command
     ///
     /// This handler processes status-get command, which retrieves
@@ -404,6 +419,14 @@ private:
     /// deleted.
     void deleteExpiredReclaimedLeases(const uint32_t secs);
 
+    /// @brief Compacts the allocation states, updates the memory
+    /// statistics and reschedules the timer.
+    ///
+    /// This is the callback of the timer maintaining the memory of the
+    /// subnets: see @c CfgSubnets4::compactAllocators and
+    /// @c CfgSubnets4::updateMemoryStatistics.
+    void maintainMemory();
+
     /// @brief Callback DB backends should be invoked upon loss of the
     /// connectivity.
     ///
@@ -471,6 +494,36 @@ private:
     void cbFetchUpdates(const SrvConfigPtr& srv_cfg,
                         boost::shared_ptr<unsigned> failure_count);
 
+    /// @brief Watches the change notification sockets of the Config Backends.
+    ///
+    /// The sockets of the backends pushing configuration change
+    /// notifications are registered in the @c IfaceMgr so the updates are
+    /// fetched as soon as they are notified rather than at the next poll.
+    /// The registration is updated when the sockets have changed, e.g.
+    /// when a backend has reopened its listening connection.
+    ///
+    /// @param srv_cfg Server configuration holding the database credentials
+    /// and server tag.
+    /// @param failure_count pointer to the failure counter shared with
+    /// the periodic fetch.
+    void cbWatchNotifications(const SrvConfigPtr& srv_cfg,
+                              boost::shared_ptr<unsigned> failure_count);
+
+    /// @brief Stops watching the change notification sockets.
+    void cbUnwatchNotifications();
+
+    /// @brief Callback invoked when a change notification socket is readable.
+    ///
+    /// Consumes the notifications and fetches the configuration updates
+    /// when a change was notified.
+    ///
+    /// @param srv_cfg Server configuration holding the database credentials
+    /// and server tag.
+    /// @param failure_count pointer to the failure counter shared with
+    /// the periodic fetch.
+    void cbNotified(const SrvConfigPtr& srv_cfg,
+                    boost::shared_ptr<unsigned> failure_count);
+
     /// @brief Static pointer to the sole instance of the DHCP server.
     ///
     /// This is required for config and command handlers to gain access to
@@ -482,6 +535,9 @@ private:
     /// Shared pointer to the instance of timer @c TimerMgr is held here to
     /// make sure that the @c TimerMgr outlives instance of this class.
     TimerMgrPtr timer_mgr_;
+
+    /// @brief Watched change notification sockets of the Config Backends.
+    std::vector<int> cb_notification_sockets_;
 };
 
 }  // namespace dhcp
@@ -67,6 +67,10 @@ using namespace std;
   SERVICE_SOCKETS_REQUIRE_ALL "service-sockets-require-all"
   SERVICE_SOCKETS_RETRY_WAIT_TIME "service-sockets-retry-wait-time"
   SERVICE_SOCKETS_MAX_RETRIES "service-sockets-max-retries"
+  EVENT_HANDLER_TYPE "event-handler-type"
+  SELECT "select"
+  EPOLL "epoll"
+  ACCEPTED_RELAYS "accepted-relays"
 
   SANITY_CHECKS "sanity-checks"
   LEASE_CHECKS "lease-checks"
@@ -87,6 +91,7 @@ using namespace std;
   MEMFILE "memfile"
   MYSQL "mysql"
   POSTGRESQL "postgresql"
+  LMDB "lmdb"
   USER "user"
   PASSWORD "password"
   HOST "host"
@@ -109,6 +114,34 @@ using namespace std;
   CERT_FILE "cert-file"
   KEY_FILE "key-file"
   CIPHER_LIST "cipher-list"
+  LFC_MAX_LEASES "lfc-max-leases"
+  LFC_MODE "lfc-mode"
+  KEA_LFC "kea-lfc"
+  IN_PROCESS "in-process"
+  LOAD_THREADS "load-threads"
+  LEASE_FILE_FORMAT "lease-file-format"
+  CSV "csv"
+  BINARY "binary"
+  FSYNC_RECORDS "fsync-records"
+  WRITE_BEHIND "write-behind"
+  WRITE_BEHIND_QUEUE_SIZE "write-behind-queue-size"
+  LEASE_SNAPSHOT "lease-snapshot"
+  PIPELINE "pipeline"
+  ASYNC_THREADS "async-threads"
+  POOL_SIZE "pool-size"
+  WRITER_THREADS "writer-threads"
+  SINGLE_QUERY_ALLOCATION "single-query-allocation"
+  IN_MEMORY_LIMITS "in-memory-limits"
+  IN_MEMORY_STATS "in-memory-stats"
+  MAP_SIZE "map-size"
+  REPLICA_HOST "replica-host"
+  REPLICA_PORT "replica-port"
+  REPLICA_MAX_LAG "replica-max-lag"
+  CACHE_SIZE "cache-size"
+  CACHE_TTL "cache-ttl"
+  CACHE_NEGATIVE "cache-negative"
+  GLOBAL_HOSTS_IN_MEMORY "global-hosts-in-memory"
+  GLOBAL_HOSTS_REFRESH "global-hosts-refresh"
 
   VALID_LIFETIME "valid-lifetime"
   MIN_VALID_LIFETIME "min-valid-lifetime"
@@ -211,6 +244,8 @@ using namespace std;
   ENABLE_MULTI_THREADING "enable-multi-threading"
   THREAD_POOL_SIZE "thread-pool-size"
   PACKET_QUEUE_SIZE "packet-queue-size"
+  CPU_AFFINITY "cpu-affinity"
+  RECEIVER_CPU_AFFINITY "receiver-cpu-affinity"
 
   CONTROL_SOCKET "control-socket"
   SOCKET_TYPE "socket-type"
@@ -288,11 +323,15 @@ using namespace std;
 %type <ElementPtr> value
 %type <ElementPtr> map_value
 %type <ElementPtr> socket_type
+%type <ElementPtr> event_handler_type_value
 %type <ElementPtr> outbound_interface_value
 %type <ElementPtr> db_type
 %type <ElementPtr> on_fail_mode
+%type <ElementPtr> lfc_mode_value
+%type <ElementPtr> lease_file_format_value
 %type <ElementPtr> hr_mode
 %type <ElementPtr> ncr_protocol_value
+%type <ElementPtr> ncr_format_value
 %type <ElementPtr> ddns_replace_client_name_value
 
 %printer { yyoutput << $$; } <*>;
@@ -837,6 +876,8 @@ interfaces_config_param: interfaces_list
                        | service_sockets_max_retries
                        | user_context
                        | comment
+                       | event_handler_type
+                       | accepted_relays
                        | unknown_map_entry
                        ;
 
@@ -860,6 +901,29 @@ interfaces_list: INTERFACES {
     ctx.leave();
 };
 
+accepted_relays: ACCEPTED_RELAYS {
+    ctx.unique("accepted-relays", ctx.loc2pos(@1));
+    ElementPtr l(new ListElement(ctx.loc2pos(@1)));
+    ctx.stack_.back()->set("accepted-relays", l);
+    ctx.stack_.push_back(l);
+    ctx.enter(ctx.NO_KEYWORD);
+} COLON list_strings {
+    ctx.stack_.pop_back();
+    ctx.leave();
+};
+
+event_handler_type: EVENT_HANDLER_TYPE {
+    ctx.unique("event-handler-type", ctx.loc2pos(@1));
+    ctx.enter(ctx.EVENT_HANDLER_TYPE);
+} COLON event_handler_type_value {
+    ctx.stack_.back()->set("event-handler-type", $4);
+    ctx.leave();
+};
+
+event_handler_type_value: SELECT { $$ = ElementPtr(new StringElement("select", ctx.loc2pos(@1))); }
+                        | EPOLL { $$ = ElementPtr(new StringElement("epoll", ctx.loc2pos(@1))); }
+                        ;
+
 dhcp_socket_type: DHCP_SOCKET_TYPE {
     ctx.unique("dhcp-socket-type", ctx.loc2pos(@1));
     ctx.enter(ctx.DHCP_SOCKET_TYPE);
@@ -1055,6 +1119,30 @@ database_map_param: database_type
                   | cert_file
                   | key_file
                   | cipher_list
+                  | lfc_max_leases
+                  | lfc_mode
+                  | load_threads
+                  | lease_file_format
+                  | fsync_records
+                  | write_behind
+                  | write_behind_queue_size
+                  | lease_snapshot
+                  | pipeline
+                  | async_threads
+                  | pool_size
+                  | writer_threads
+                  | single_query_allocation
+                  | in_memory_limits
+                  | in_memory_stats
+                  | map_size
+                  | replica_host
+                  | replica_port
+                  | replica_max_lag
+                  | cache_size
+                  | cache_ttl
+                  | cache_negative
+                  | global_hosts_in_memory
+                  | global_hosts_refresh
                   | unknown_map_entry
                   ;
 
@@ -1069,6 +1157,7 @@ database_type: TYPE {
 db_type: MEMFILE { $$ = ElementPtr(new StringElement("memfile", ctx.loc2pos(@1))); }
        | MYSQL { $$ = ElementPtr(new StringElement("mysql", ctx.loc2pos(@1))); }
        | POSTGRESQL { $$ = ElementPtr(new StringElement("postgresql", ctx.loc2pos(@1))); }
+       | LMDB { $$ = ElementPtr(new StringElement("lmdb", ctx.loc2pos(@1))); }
        ;
 
 user: USER {
@@ -1222,6 +1311,165 @@ cipher_list: CIPHER_LIST {
     ctx.leave();
 };
 
+lfc_max_leases: LFC_MAX_LEASES COLON INTEGER {
+    ctx.unique("lfc-max-leases", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("lfc-max-leases", n);
+};
+
+lfc_mode: LFC_MODE {
+    ctx.unique("lfc-mode", ctx.loc2pos(@1));
+    ctx.enter(ctx.DATABASE_LFC_MODE);
+} COLON lfc_mode_value {
+    ctx.stack_.back()->set("lfc-mode", $4);
+    ctx.leave();
+};
+
+lfc_mode_value: KEA_LFC { $$ = ElementPtr(new StringElement("kea-lfc", ctx.loc2pos(@1))); }
+              | IN_PROCESS { $$ = ElementPtr(new StringElement("in-process", ctx.loc2pos(@1))); }
+              ;
+
+load_threads: LOAD_THREADS COLON INTEGER {
+    ctx.unique("load-threads", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("load-threads", n);
+};
+
+lease_file_format: LEASE_FILE_FORMAT {
+    ctx.unique("lease-file-format", ctx.loc2pos(@1));
+    ctx.enter(ctx.DATABASE_LEASE_FILE_FORMAT);
+} COLON lease_file_format_value {
+    ctx.stack_.back()->set("lease-file-format", $4);
+    ctx.leave();
+};
+
+lease_file_format_value: CSV { $$ = ElementPtr(new StringElement("csv", ctx.loc2pos(@1))); }
+                       | BINARY { $$ = ElementPtr(new StringElement("binary", ctx.loc2pos(@1))); }
+                       ;
+
+fsync_records: FSYNC_RECORDS COLON INTEGER {
+    ctx.unique("fsync-records", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("fsync-records", n);
+};
+
+write_behind: WRITE_BEHIND COLON BOOLEAN {
+    ctx.unique("write-behind", ctx.loc2pos(@1));
+    ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("write-behind", n);
+};
+
+write_behind_queue_size: WRITE_BEHIND_QUEUE_SIZE COLON INTEGER {
+    ctx.unique("write-behind-queue-size", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("write-behind-queue-size", n);
+};
+
+lease_snapshot: LEASE_SNAPSHOT COLON BOOLEAN {
+    ctx.unique("lease-snapshot", ctx.loc2pos(@1));
+    ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("lease-snapshot", n);
+};
+
+pipeline: PIPELINE COLON BOOLEAN {
+    ctx.unique("pipeline", ctx.loc2pos(@1));
+    ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("pipeline", n);
+};
+
+async_threads: ASYNC_THREADS COLON INTEGER {
+    ctx.unique("async-threads", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("async-threads", n);
+};
+
+pool_size: POOL_SIZE COLON INTEGER {
+    ctx.unique("pool-size", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("pool-size", n);
+};
+
+writer_threads: WRITER_THREADS COLON INTEGER {
+    ctx.unique("writer-threads", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("writer-threads", n);
+};
+
+single_query_allocation: SINGLE_QUERY_ALLOCATION COLON BOOLEAN {
+    ctx.unique("single-query-allocation", ctx.loc2pos(@1));
+    ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("single-query-allocation", n);
+};
+
+in_memory_limits: IN_MEMORY_LIMITS COLON BOOLEAN {
+    ctx.unique("in-memory-limits", ctx.loc2pos(@1));
+    ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("in-memory-limits", n);
+};
+
+in_memory_stats: IN_MEMORY_STATS COLON BOOLEAN {
+    ctx.unique("in-memory-stats", ctx.loc2pos(@1));
+    ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("in-memory-stats", n);
+};
+
+map_size: MAP_SIZE COLON INTEGER {
+    ctx.unique("map-size", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("map-size", n);
+};
+
+replica_host: REPLICA_HOST {
+    ctx.unique("replica-host", ctx.loc2pos(@1));
+    ctx.enter(ctx.NO_KEYWORD);
+} COLON STRING {
+    ElementPtr s(new StringElement($4, ctx.loc2pos(@4)));
+    ctx.stack_.back()->set("replica-host", s);
+    ctx.leave();
+};
+
+replica_port: REPLICA_PORT COLON INTEGER {
+    ctx.unique("replica-port", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("replica-port", n);
+};
+
+replica_max_lag: REPLICA_MAX_LAG COLON INTEGER {
+    ctx.unique("replica-max-lag", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("replica-max-lag", n);
+};
+
+cache_size: CACHE_SIZE COLON INTEGER {
+    ctx.unique("cache-size", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("cache-size", n);
+};
+
+cache_ttl: CACHE_TTL COLON INTEGER {
+    ctx.unique("cache-ttl", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("cache-ttl", n);
+};
+
+cache_negative: CACHE_NEGATIVE COLON BOOLEAN {
+    ctx.unique("cache-negative", ctx.loc2pos(@1));
+    ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("cache-negative", n);
+};
+
+global_hosts_in_memory: GLOBAL_HOSTS_IN_MEMORY COLON BOOLEAN {
+    ctx.unique("global-hosts-in-memory", ctx.loc2pos(@1));
+    ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("global-hosts-in-memory", n);
+};
+
+global_hosts_refresh: GLOBAL_HOSTS_REFRESH COLON INTEGER {
+    ctx.unique("global-hosts-refresh", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("global-hosts-refresh", n);
+};
+
 host_reservation_identifiers: HOST_RESERVATION_IDENTIFIERS {
     ctx.unique("host-reservation-identifiers", ctx.loc2pos(@1));
     ElementPtr l(new ListElement(ctx.loc2pos(@1)));
@@ -1299,6 +1547,8 @@ multi_threading_param: enable_multi_threading
                      | packet_queue_size
                      | user_context
                      | comment
+                     | cpu_affinity
+                     | receiver_cpu_affinity
                      | unknown_map_entry
                      ;
 
@@ -1320,6 +1570,24 @@ packet_queue_size: PACKET_QUEUE_SIZE COLON INTEGER {
     ctx.stack_.back()->set("packet-queue-size", prf);
 };
 
+cpu_affinity: CPU_AFFINITY {
+    ctx.unique("cpu-affinity", ctx.loc2pos(@1));
+    ctx.enter(ctx.NO_KEYWORD);
+} COLON STRING {
+    ElementPtr s(new StringElement($4, ctx.loc2pos(@4)));
+    ctx.stack_.back()->set("cpu-affinity", s);
+    ctx.leave();
+};
+
+receiver_cpu_affinity: RECEIVER_CPU_AFFINITY {
+    ctx.unique("receiver-cpu-affinity", ctx.loc2pos(@1));
+    ctx.enter(ctx.NO_KEYWORD);
+} COLON STRING {
+    ElementPtr s(new StringElement($4, ctx.loc2pos(@4)));
+    ctx.stack_.back()->set("receiver-cpu-affinity", s);
+    ctx.leave();
+};
+
 hooks_libraries: HOOKS_LIBRARIES {
     ctx.unique("hooks-libraries", ctx.loc2pos(@1));
     ElementPtr l(new ListElement(ctx.loc2pos(@1)));
@@ -2668,12 +2936,16 @@ ncr_protocol_value:
 ncr_format: NCR_FORMAT {
     ctx.unique("ncr-format", ctx.loc2pos(@1));
     ctx.enter(ctx.NCR_FORMAT);
-} COLON JSON {
-    ElementPtr json(new StringElement("JSON", ctx.loc2pos(@4)));
-    ctx.stack_.back()->set("ncr-format", json);
+} COLON ncr_format_value {
+    ctx.stack_.back()->set("ncr-format", $4);
     ctx.leave();
 };
 
+ncr_format_value:
+    JSON { $$ = ElementPtr(new StringElement("JSON", ctx.loc2pos(@1))); }
+  | BINARY { $$ = ElementPtr(new StringElement("BINARY", ctx.loc2pos(@1))); }
+  ;
+
 // Deprecated, moved to global/network scopes. Eventually it should be removed.
 dep_qualifying_suffix: QUALIFYING_SUFFIX {
     ctx.unique("qualifying-suffix", ctx.loc2pos(@1));
@@ -37,6 +37,7 @@
 #include <dhcpsrv/lease_mgr.h>
 #include <dhcpsrv/lease_mgr_factory.h>
 #include <dhcpsrv/ncr_generator.h>
+#include <dhcpsrv/pkt_latency_stats.h>
 #include <dhcpsrv/shared_network.h>
 #include <dhcpsrv/subnet.h>
 #include <dhcpsrv/subnet_selector.h>
@@ -48,6 +49,7 @@
 #include <hooks/hooks_manager.h>
 #include <stats/stats_mgr.h>
 #include <util/strutil.h>
+#include <util/recycling_allocator.h>
 #include <log/logger.h>
 #include <cryptolink/cryptolink.h>
 #include <process/cfgrpt/config_report.h>
@@ -58,6 +60,9 @@
 #ifdef HAVE_PGSQL
 #include <dhcpsrv/pgsql_lease_mgr.h>
 #endif
+#ifdef HAVE_LMDB
+#include <dhcpsrv/lmdb_lease_mgr.h>
+#endif
 #include <dhcpsrv/memfile_lease_mgr.h>
 
 #include <boost/algorithm/string.hpp>
@@ -90,6 +95,7 @@ struct Dhcp4Hooks {
     int hook_index_pkt4_receive_;      ///< index for "pkt4_receive" hook point
     int hook_index_subnet4_select_;    ///< index for "subnet4_select" hook point
     int hook_index_leases4_committed_; ///< index for "leases4_committed" hook point
+    int hook_index_lease4_offer_;      ///< index for "lease4_offer" hook point
     int hook_index_lease4_release_;    ///< index for "lease4_release" hook point
     int hook_index_pkt4_send_;         ///< index for "pkt4_send" hook point
     int hook_index_buffer4_send_;      ///< index for "buffer4_send" hook point
@@ -103,6 +109,7 @@ struct Dhcp4Hooks {
         hook_index_pkt4_receive_      = HooksManager::registerHook("pkt4_receive");
         hook_index_subnet4_select_    = HooksManager::registerHook("subnet4_select");
         hook_index_leases4_committed_ = HooksManager::registerHook("leases4_committed");
+        hook_index_lease4_offer_      = HooksManager::registerHook("lease4_offer");
         hook_index_lease4_release_    = HooksManager::registerHook("lease4_release");
         hook_index_pkt4_send_         = HooksManager::registerHook("pkt4_send");
         hook_index_buffer4_send_      = HooksManager::registerHook("buffer4_send");
@@ -112,6 +119,45 @@ struct Dhcp4Hooks {
     }
 };
 
+/// Structure that holds the counters of the packet statistics, which
+/// are incremented for each packet without locking the statistics manager
+struct Dhcp4Counters {
+    StatCounterPtr received_;          ///< "pkt4-received" counter
+    StatCounterPtr discover_received_; ///< "pkt4-discover-received" counter
+    StatCounterPtr offer_received_;    ///< "pkt4-offer-received" counter
+    StatCounterPtr request_received_;  ///< "pkt4-request-received" counter
+    StatCounterPtr ack_received_;      ///< "pkt4-ack-received" counter
+    StatCounterPtr nak_received_;      ///< "pkt4-nak-received" counter
+    StatCounterPtr release_received_;  ///< "pkt4-release-received" counter
+    StatCounterPtr decline_received_;  ///< "pkt4-decline-received" counter
+    StatCounterPtr inform_received_;   ///< "pkt4-inform-received" counter
+    StatCounterPtr unknown_received_;  ///< "pkt4-unknown-received" counter
+    StatCounterPtr sent_;              ///< "pkt4-sent" counter
+    StatCounterPtr offer_sent_;        ///< "pkt4-offer-sent" counter
+    StatCounterPtr ack_sent_;          ///< "pkt4-ack-sent" counter
+    StatCounterPtr nak_sent_;          ///< "pkt4-nak-sent" counter
+    PktLatencyStats latency_;          ///< "pkt4-*-latency" histograms
+
+    /// Constructor that registers the counters for DHCPv4 engine
+    Dhcp4Counters() : latency_("pkt4") {
+        StatsMgr& stats_mgr = StatsMgr::instance();
+        received_          = stats_mgr.registerCounter("pkt4-received");
+        discover_received_ = stats_mgr.registerCounter("pkt4-discover-received");
+        offer_received_    = stats_mgr.registerCounter("pkt4-offer-received");
+        request_received_  = stats_mgr.registerCounter("pkt4-request-received");
+        ack_received_      = stats_mgr.registerCounter("pkt4-ack-received");
+        nak_received_      = stats_mgr.registerCounter("pkt4-nak-received");
+        release_received_  = stats_mgr.registerCounter("pkt4-release-received");
+        decline_received_  = stats_mgr.registerCounter("pkt4-decline-received");
+        inform_received_   = stats_mgr.registerCounter("pkt4-inform-received");
+        unknown_received_  = stats_mgr.registerCounter("pkt4-unknown-received");
+        sent_              = stats_mgr.registerCounter("pkt4-sent");
+        offer_sent_        = stats_mgr.registerCounter("pkt4-offer-sent");
+        ack_sent_          = stats_mgr.registerCounter("pkt4-ack-sent");
+        nak_sent_          = stats_mgr.registerCounter("pkt4-nak-sent");
+    }
+};
+
 /// List of statistics which is initialized to 0 during the DHCPv4
 /// server startup.
 std::set<std::string> dhcp4_statistics = {
@@ -147,6 +193,46 @@ std::set<std::string> dhcp4_statistics = {
 // module is called.
 Dhcp4Hooks Hooks;
 
+// Declare the packet statistics counters.
+Dhcp4Counters Counters;
+
+namespace {
+
+/// @brief Returns the counter of the received packets of a type.
+///
+/// The counter is not copied to not contend on its reference count.
+///
+/// @param type The DHCPv4 message type.
+/// @return The counter, "pkt4-unknown-received" for other types.
+StatCounter*
+receivedCounter(int type) {
+    switch (type) {
+    case DHCPDISCOVER:
+        return (Counters.discover_received_.get());
+    case DHCPOFFER:
+        // Should not happen, but let's keep a counter for it
+        return (Counters.offer_received_.get());
+    case DHCPREQUEST:
+        return (Counters.request_received_.get());
+    case DHCPACK:
+        // Should not happen, but let's keep a counter for it
+        return (Counters.ack_received_.get());
+    case DHCPNAK:
+        // Should not happen, but let's keep a counter for it
+        return (Counters.nak_received_.get());
+    case DHCPRELEASE:
+        return (Counters.release_received_.get());
+    case DHCPDECLINE:
+        return (Counters.decline_received_.get());
+    case DHCPINFORM:
+        return (Counters.inform_received_.get());
+    default:
+        return (Counters.unknown_received_.get());
+    }
+}
+
+} // end of anonymous namespace
+
 namespace isc {
 namespace dhcp {
 
@@ -284,7 +370,7 @@ Dhcpv4Exchange::initResponse() {
     }
     // Only create a response if one is required.
     if (resp_type > 0) {
-        resp_.reset(new Pkt4(resp_type, getQuery()->getTransid()));
+        resp_ = makeRecycled<Pkt4>(resp_type, getQuery()->getTransid());
         copyDefaultFields();
         copyDefaultOptions();
 
@@ -423,14 +509,12 @@ Dhcpv4Exchange::setHostIdentifiers(AllocEngine::ClientContext4Ptr context) {
 
         case Host::IDENT_CIRCUIT_ID:
             {
-                OptionPtr rai = context->query_->getOption(DHO_DHCP_AGENT_OPTIONS);
-                if (rai) {
-                    OptionPtr circuit_id_opt = rai->getOption(RAI_OPTION_AGENT_CIRCUIT_ID);
-                    if (circuit_id_opt) {
-                        const OptionBuffer& circuit_id_vec = circuit_id_opt->getData();
-                        if (!circuit_id_vec.empty()) {
-                            context->addHostIdentifier(id_type, circuit_id_vec);
-                        }
+                OptionPtr circuit_id_opt =
+                    context->query_->getRAISubOption(RAI_OPTION_AGENT_CIRCUIT_ID);
+                if (circuit_id_opt) {
+                    const OptionBuffer& circuit_id_vec = circuit_id_opt->getData();
+                    if (!circuit_id_vec.empty()) {
+                        context->addHostIdentifier(id_type, circuit_id_vec);
                     }
                 }
             }
@@ -479,7 +563,7 @@ Dhcpv4Exchange::setHostIdentifiers(AllocEngine::ClientContext4Ptr context) {
                     LOG_DEBUG(packet4_logger, DBGLVL_TRACE_BASIC, DHCP4_FLEX_ID)
                         .arg(Host::getIdentifierAsText(type, &id[0], id.size()));
 
-                    context->addHostIdentifier(type, id);
+                    context->addHostIdentifier(type, std::move(id));
                 }
                 break;
             }
@@ -579,24 +663,12 @@ void Dhcpv4Exchange::evaluateClasses(const Pkt4Ptr& pkt, bool depend_on_known) {
     // Note getClientClassDictionary() cannot be null
     const ClientClassDictionaryPtr& dict =
         CfgMgr::instance().getCurrentCfg()->getClientClassDictionary();
-    const ClientClassDefListPtr& defs_ptr = dict->getClasses();
-    for (ClientClassDefList::const_iterator it = defs_ptr->cbegin();
-         it != defs_ptr->cend(); ++it) {
-        // Note second cannot be null
-        const ExpressionPtr& expr_ptr = (*it)->getMatchExpr();
-        // Nothing to do without an expression to evaluate
-        if (!expr_ptr) {
-            continue;
-        }
-        // Not the right time if only when required
-        if ((*it)->getRequired()) {
-            continue;
-        }
-        // Not the right pass.
-        if ((*it)->getDependOnKnown() != depend_on_known) {
-            continue;
-        }
-        (*it)->test(pkt, expr_ptr);
+    // The values of the option tokens shared by the expressions.
+    EvalCache cache;
+    // Only the classes of the pass with an expression to evaluate and
+    // not only evaluated when required.
+    for (auto const& c : dict->getEvaluatedClasses(depend_on_known)) {
+        c->test(pkt, c->getMatchExpr(), &cache);
     }
 }
 
@@ -609,6 +681,8 @@ Dhcpv4Srv::Dhcpv4Srv(uint16_t server_port, uint16_t client_port,
       alloc_engine_(), use_bcast_(use_bcast),
       network_state_(new NetworkState(NetworkState::DHCPv4)),
       cb_control_(new CBControlDHCPv4()),
+      durable_parking_lot_(new ParkingLot()), requested_options_cache_(),
+      merged_options_cache_(),
       test_send_responses_to_source_(false) {
 
     const char* env = std::getenv("KEA_TEST_SEND_RESPONSES_TO_SOURCE");
@@ -1055,6 +1129,7 @@ Dhcpv4Srv::run_one() {
         // point are: the interface, source address and destination addresses
         // and ports.
         if (query) {
+            query->setEventTime(Pkt::EVENT_RECEIVED);
             LOG_DEBUG(packet4_logger, DBG_DHCP4_BASIC, DHCP4_BUFFER_RECEIVED)
                 .arg(query->getRemoteAddr().toText())
                 .arg(query->getRemotePort())
@@ -1095,10 +1170,16 @@ Dhcpv4Srv::run_one() {
         return;
     } else {
         if (MultiThreadingMgr::instance().getMode()) {
+            QueryPreFilter::TicketPtr ticket;
+            if (!preFilterQuery(query, ticket)) {
+                return;
+            }
+            // The ticket is released with the callback.
             typedef function<void()> CallBack;
             boost::shared_ptr<CallBack> call_back =
-                boost::make_shared<CallBack>(std::bind(&Dhcpv4Srv::processPacketAndSendResponseNoThrow,
-                                                       this, query));
+                boost::make_shared<CallBack>([this, query, ticket]() mutable {
+                    processPacketAndSendResponseNoThrow(query);
+                });
             if (!MultiThreadingMgr::instance().getThreadPool().add(call_back)) {
                 LOG_DEBUG(dhcp4_logger, DBG_DHCP4_BASIC, DHCP4_PACKET_QUEUE_FULL);
             }
@@ -1108,6 +1189,52 @@ Dhcpv4Srv::run_one() {
     }
 }
 
+bool
+Dhcpv4Srv::preFilterQuery(const Pkt4Ptr& query, QueryPreFilter::TicketPtr& ticket) {
+    // The buffer4_receive callouts may handle queries which do not
+    // unpack, so only the duplicates are dropped when there are some.
+    bool check_content =
+        !HooksManager::calloutsPresent(Hooks.hook_index_buffer4_receive_);
+    int type = QueryPreFilter::UNKNOWN_TYPE;
+    QueryPreFilter::Result result =
+        query_pre_filter_.check(query, check_content, type, ticket);
+    if (result == QueryPreFilter::ACCEPT) {
+        return (true);
+    }
+
+    // Account the query as it would be by a worker.
+    Counters.received_->add();
+    switch (result) {
+    case QueryPreFilter::DROP_MALFORMED:
+        LOG_DEBUG(bad_packet4_logger, DBGLVL_PKT_HANDLING, DHCP4_PACKET_DROP_0001)
+            .arg(query->getRemoteAddr().toText())
+            .arg(query->getLocalAddr().toText())
+            .arg(query->getIface())
+            .arg("truncated packet or missing DHCP magic cookie");
+        isc::stats::StatsMgr::instance().addValue("pkt4-parse-failed",
+                                                  static_cast<int64_t>(1));
+        break;
+
+    case QueryPreFilter::DROP_TYPE:
+        receivedCounter(type)->add();
+        LOG_DEBUG(bad_packet4_logger, DBGLVL_PKT_HANDLING, DHCP4_PACKET_DROP_0015)
+            .arg(query->getRemoteAddr().toText())
+            .arg(query->getIface())
+            .arg(type);
+        break;
+
+    default:
+        receivedCounter(type)->add();
+        LOG_DEBUG(bad_packet4_logger, DBGLVL_PKT_HANDLING, DHCP4_PACKET_DROP_0016)
+            .arg(query->getRemoteAddr().toText())
+            .arg(query->getIface());
+        break;
+    }
+    isc::stats::StatsMgr::instance().addValue("pkt4-receive-drop",
+                                              static_cast<int64_t>(1));
+    return (false);
+}
+
 void
 Dhcpv4Srv::processPacketAndSendResponseNoThrow(Pkt4Ptr& query) {
     try {
@@ -1134,6 +1261,8 @@ Dhcpv4Srv::processPacketAndSendResponse(Pkt4Ptr& query) {
 
 void
 Dhcpv4Srv::processPacket(Pkt4Ptr& query, Pkt4Ptr& rsp, bool allow_packet_park) {
+    query->setEventTime(Pkt::EVENT_DEQUEUED);
+
     // All packets belong to ALL.
     query->addClass("ALL");
 
@@ -1141,8 +1270,7 @@ Dhcpv4Srv::processPacket(Pkt4Ptr& query, Pkt4Ptr& rsp, bool allow_packet_park) {
     // failures in unpacking will cause the packet to be dropped. We
     // will increase type specific statistic further down the road.
     // See processStatsReceived().
-    isc::stats::StatsMgr::instance().addValue("pkt4-received",
-                                              static_cast<int64_t>(1));
+    Counters.received_->add();
 
     bool skip_unpack = false;
 
@@ -1346,7 +1474,8 @@ Dhcpv4Srv::processDhcp4Query(Pkt4Ptr& query, Pkt4Ptr& rsp,
         }
     }
 
-    AllocEngine::ClientContext4Ptr ctx(new AllocEngine::ClientContext4());
+    AllocEngine::ClientContext4Ptr ctx =
+        makeRecycled<AllocEngine::ClientContext4>();
     if (!earlyGHRLookup(query, ctx)) {
         return;
     }
@@ -1382,6 +1511,11 @@ Dhcpv4Srv::processDhcp4Query(Pkt4Ptr& query, Pkt4Ptr& rsp,
             // "switch" statement.
             ;
         }
+
+        // Pass the event times to the response for the latency statistics.
+        if (rsp) {
+            rsp->copyEventTimes(*query);
+        }
     } catch (const std::exception& e) {
 
         // Catch-all exception (we used to call only isc::Exception, but
@@ -1401,7 +1535,8 @@ Dhcpv4Srv::processDhcp4Query(Pkt4Ptr& query, Pkt4Ptr& rsp,
     }
 
     CalloutHandlePtr callout_handle = getCalloutHandle(query);
-    if (ctx && HooksManager::calloutsPresent(Hooks.hook_index_leases4_committed_)) {
+    if (ctx && (query->getType() != DHCPDISCOVER) &&
+        HooksManager::calloutsPresent(Hooks.hook_index_leases4_committed_)) {
         // The ScopedCalloutHandleState class which guarantees that the task
         // is added to the thread pool after the response is reset (if needed)
         // and CalloutHandle state is reset. In ST it does nothing.
@@ -1528,12 +1663,161 @@ Dhcpv4Srv::processDhcp4Query(Pkt4Ptr& query, Pkt4Ptr& rsp,
         }
     }
 
+    // Give the hook libraries a chance to check the offered address, e.g.
+    // to verify it is not in use, before the offer is sent.
+    if (ctx && rsp && (query->getType() == DHCPDISCOVER) &&
+        HooksManager::calloutsPresent(Hooks.hook_index_lease4_offer_)) {
+        // See the leases4_committed comments above about the callout handle
+        // state.
+        std::shared_ptr<ScopedCalloutHandleState> callout_handle_state =
+                std::make_shared<ScopedCalloutHandleState>(callout_handle);
+
+        ScopedEnableOptionsCopy<Pkt4> query4_options_copy(query);
+
+        callout_handle->setArgument("query4", query);
+        callout_handle->setArgument("response4", rsp);
+
+        Lease4CollectionPtr new_leases(new Lease4Collection());
+        if (ctx->new_lease_) {
+            new_leases->push_back(ctx->new_lease_);
+        }
+        callout_handle->setArgument("leases4", new_leases);
+
+        // The lease the client already has, so a callout does not check
+        // the address the client is using.
+        callout_handle->setArgument("old_lease", ctx->old_lease_);
+
+        if (allow_packet_park) {
+            // Get the parking limit. Parsing should ensure the value is present.
+            uint32_t parked_packet_limit = 0;
+            data::ConstElementPtr ppl = CfgMgr::instance().getCurrentCfg()->
+                getConfiguredGlobal(CfgGlobals::PARKED_PACKET_LIMIT);
+            if (ppl) {
+                parked_packet_limit = ppl->intValue();
+            }
+
+            if (parked_packet_limit) {
+                const auto& parking_lot = ServerHooks::getServerHooks().
+                    getParkingLotPtr("lease4_offer");
+
+                if (parking_lot && (parking_lot->size() >= parked_packet_limit)) {
+                    LOG_DEBUG(packet4_logger, DBGLVL_PKT_HANDLING,
+                              DHCP4_HOOK_LEASE4_OFFER_PARKING_LOT_FULL)
+                              .arg(parked_packet_limit)
+                              .arg(query->getLabel());
+                    isc::stats::StatsMgr::instance().addValue("pkt4-receive-drop",
+                                                              static_cast<int64_t>(1));
+                    rsp.reset();
+                    return;
+                }
+            }
+
+            // The offer is not committed so there is nothing to wait for
+            // before it is sent when the packet is unparked.
+            HooksManager::park("lease4_offer", query,
+            [this, callout_handle, query, rsp, callout_handle_state]() mutable {
+                if (MultiThreadingMgr::instance().getMode()) {
+                    typedef function<void()> CallBack;
+                    boost::shared_ptr<CallBack> call_back =
+                        boost::make_shared<CallBack>(std::bind(&Dhcpv4Srv::sendResponseNoThrow,
+                                                               this, callout_handle, query, rsp));
+                    callout_handle_state->on_completion_ = [call_back]() {
+                        MultiThreadingMgr::instance().getThreadPool().add(call_back);
+                    };
+                } else {
+                    processPacketPktSend(callout_handle, query, rsp);
+                    processPacketBufferSend(callout_handle, rsp);
+                }
+            });
+        }
+
+        try {
+            HooksManager::callCallouts(Hooks.hook_index_lease4_offer_,
+                                       *callout_handle);
+        } catch (...) {
+            // Make sure we don't orphan a parked packet.
+            if (allow_packet_park) {
+                HooksManager::drop("lease4_offer", query);
+            }
+
+            throw;
+        }
+
+        if ((callout_handle->getStatus() == CalloutHandle::NEXT_STEP_PARK)
+            && allow_packet_park) {
+            LOG_DEBUG(hooks_logger, DBG_DHCP4_HOOKS, DHCP4_HOOK_LEASE4_OFFER_PARK)
+                      .arg(query->getLabel());
+            // The processing continues via the callback.
+            rsp.reset();
+        } else {
+            HooksManager::drop("lease4_offer", query);
+            if (callout_handle->getStatus() == CalloutHandle::NEXT_STEP_DROP) {
+                LOG_DEBUG(hooks_logger, DBGLVL_PKT_HANDLING, DHCP4_HOOK_LEASE4_OFFER_DROP)
+                          .arg(query->getLabel());
+                rsp.reset();
+            }
+        }
+    }
+
+    // Hold the response until the lease changes are on the disk.
+    if (rsp && allow_packet_park &&
+        parkUntilLeasesDurable(callout_handle, query, rsp)) {
+        rsp.reset();
+    }
+
     // If we have a response prep it for shipment.
     if (rsp) {
         processPacketPktSend(callout_handle, query, rsp);
     }
 }
 
+bool
+Dhcpv4Srv::parkUntilLeasesDurable(hooks::CalloutHandlePtr& callout_handle,
+                                  Pkt4Ptr& query, Pkt4Ptr& rsp) {
+    if (!MultiThreadingMgr::instance().getMode() ||
+        !LeaseMgrFactory::haveInstance()) {
+        return (false);
+    }
+
+    ParkingLotPtr parking_lot = durable_parking_lot_;
+    parking_lot->park(query, [this, callout_handle, query, rsp]() mutable {
+        typedef function<void()> CallBack;
+        boost::shared_ptr<CallBack> call_back =
+            boost::make_shared<CallBack>(std::bind(&Dhcpv4Srv::sendResponseNoThrow,
+                                                   this, callout_handle, query, rsp));
+        MultiThreadingMgr::instance().getThreadPool().add(call_back);
+    });
+
+    bool parked = false;
+    try {
+        parked = LeaseMgrFactory::instance().whenLeasesDurable(
+            [parking_lot, query](bool durable) {
+                if (durable) {
+                    parking_lot->unpark(query);
+                    return;
+                }
+                parking_lot->drop(query);
+                LOG_ERROR(packet4_logger, DHCP4_PACKET_DROP_LEASE_WRITE_FAILED)
+                    .arg(query->getLabel());
+                isc::stats::StatsMgr::instance().addValue("pkt4-receive-drop",
+                                                          static_cast<int64_t>(1));
+            });
+    } catch (...) {
+        parking_lot->drop(query);
+        throw;
+    }
+
+    if (!parked) {
+        // The changes are already durable: send the response now.
+        parking_lot->drop(query);
+        return (false);
+    }
+
+    LOG_DEBUG(packet4_logger, DBGLVL_PKT_HANDLING, DHCP4_PACKET_PARK_LEASE_WRITE)
+        .arg(query->getLabel());
+    return (true);
+}
+
 void
 Dhcpv4Srv::sendResponseNoThrow(hooks::CalloutHandlePtr& callout_handle,
                                Pkt4Ptr& query, Pkt4Ptr& rsp) {
@@ -1679,6 +1963,8 @@ Dhcpv4Srv::processPacketBufferSend(CalloutHandlePtr& callout_handle,
 
         // Update statistics accordingly for sent packet.
         processStatsSent(rsp);
+        rsp->setEventTime(Pkt::EVENT_SENT);
+        Counters.latency_.record(*rsp);
 
     } catch (const std::exception& e) {
         LOG_ERROR(packet4_logger, DHCP4_PACKET_SEND_FAIL)
@@ -1749,7 +2035,10 @@ Dhcpv4Srv::buildCfgOptionList(Dhcpv4Exchange& ex) {
         co_list.push_back(host->getCfgOption4());
     }
 
-    // Secondly, pool specific options.
+    // Secondly, pool specific options. The pool, subnet and shared
+    // network options only depend on the configuration so they are
+    // merged once in a single container.
+    CfgOptionList network_list;
     Pkt4Ptr resp = ex.getResponse();
     IOAddress addr = IOAddress::IPV4_ZERO_ADDRESS();
     if (resp) {
@@ -1758,20 +2047,30 @@ Dhcpv4Srv::buildCfgOptionList(Dhcpv4Exchange& ex) {
     if (!addr.isV4Zero()) {
         PoolPtr pool = subnet->getPool(Lease::TYPE_V4, addr, false);
         if (pool && !pool->getCfgOption()->empty()) {
-            co_list.push_back(pool->getCfgOption());
+            network_list.push_back(pool->getCfgOption());
         }
     }
 
     // Thirdly, subnet configured options.
     if (!subnet->getCfgOption()->empty()) {
-        co_list.push_back(subnet->getCfgOption());
+        network_list.push_back(subnet->getCfgOption());
     }
 
     // Fourthly, shared network specific options.
     SharedNetwork4Ptr network;
     subnet->getSharedNetwork(network);
     if (network && !network->getCfgOption()->empty()) {
-        co_list.push_back(network->getCfgOption());
+        network_list.push_back(network->getCfgOption());
+    }
+
+    ConstCfgOptionPtr merged;
+    if (network_list.size() > 1) {
+        merged = merged_options_cache_.get(network_list);
+    }
+    if (merged) {
+        co_list.push_back(merged);
+    } else {
+        co_list.insert(co_list.end(), network_list.begin(), network_list.end());
     }
 
     // Each class in the incoming packet
@@ -1827,7 +2126,7 @@ Dhcpv4Srv::appendRequestedOptions(Dhcpv4Exchange& ex) {
 
     Pkt4Ptr query = ex.getQuery();
     Pkt4Ptr resp = ex.getResponse();
-    set<uint8_t> requested_opts;
+    vector<uint8_t> prl;
 
     // try to get the 'Parameter Request List' option which holds the
     // codes of requested options.
@@ -1836,65 +2135,26 @@ Dhcpv4Srv::appendRequestedOptions(Dhcpv4Exchange& ex) {
 
     // Get the list of options that client requested.
     if (option_prl) {
-        for (uint16_t code : option_prl->getValues()) {
-            static_cast<void>(requested_opts.insert(code));
-        }
+        prl = option_prl->getValues();
     }
 
-    std::set<uint8_t> cancelled_opts;
-
-    // Iterate on the configured option list to add persistent and
-    // cancelled options.
-    for (auto const& copts : co_list) {
-        const OptionContainerPtr& opts = copts->getAll(DHCP4_OPTION_SPACE);
-        if (!opts) {
-            continue;
-        }
-        // Get persistent options.
-        const OptionContainerPersistIndex& pidx = opts->get<2>();
-        const OptionContainerPersistRange& prange = pidx.equal_range(true);
-        for (OptionContainerPersistIndex::const_iterator desc = prange.first;
-             desc != prange.second; ++desc) {
-            // Add the persistent option code to requested options.
-            if (desc->option_) {
-                uint8_t code = static_cast<uint8_t>(desc->option_->getType());
-                static_cast<void>(requested_opts.insert(code));
-            }
-        }
-        // Get cancelled options.
-        const OptionContainerCancelIndex& cidx = opts->get<5>();
-        const OptionContainerCancelRange& crange = cidx.equal_range(true);
-        for (OptionContainerCancelIndex::const_iterator desc = crange.first;
-             desc != crange.second; ++desc) {
-            // Add the cancelled option code to cancelled options.
-            if (desc->option_) {
-                uint8_t code = static_cast<uint8_t>(desc->option_->getType());
-                static_cast<void>(cancelled_opts.insert(code));
-            }
-        }
+    // Select the options to be returned to the client. The selection
+    // made for the same configured option list and requested options is
+    // reused, unless it depends on the host reservation.
+    RequestedOptionsCache::SelectionPtr selection;
+    const ConstHostPtr& host = ex.getContext()->currentHost();
+    if (host && !host->getCfgOption4()->empty()) {
+        selection = RequestedOptionsCache::select(co_list, prl);
+    } else {
+        selection = requested_options_cache_.get(co_list, prl);
     }
+    const set<uint8_t>& requested_opts = selection->requested_;
+    const set<uint8_t>& cancelled_opts = selection->cancelled_;
 
-    // For each requested option code get the first instance of the option
-    // to be returned to the client.
-    for (uint8_t opt : requested_opts) {
-        if (cancelled_opts.count(opt) > 0) {
-            continue;
-        }
-        // Skip special cases: DHO_VIVSO_SUBOPTIONS.
-        if (opt == DHO_VIVSO_SUBOPTIONS) {
-            continue;
-        }
-        // Add nothing when it is already there.
-        if (!resp->getOption(opt)) {
-            // Iterate on the configured option list
-            for (auto const& copts : co_list) {
-                OptionDescriptor desc = copts->get(DHCP4_OPTION_SPACE, opt);
-                // Got it: add it and jump to the outer loop
-                if (desc.option_) {
-                    resp->addOption(desc.option_);
-                    break;
-                }
-            }
+    // Add the selected options which are not already there.
+    for (auto const& opt : selection->options_) {
+        if (!resp->getOption(opt->getType())) {
+            resp->addOption(opt);
         }
     }
 
@@ -2647,11 +2907,12 @@ Dhcpv4Srv::assignLease(Dhcpv4Exchange& ex) {
         // of the last subnets).
         //
         // We now issue at most two queries: get all the leases for specific
-        // client-id and then get all leases for specific hw-address.
+        // client-id and then get all leases for specific hw-address. The
+        // context keeps their results for the allocation engine.
         if (client_id) {
 
             // Get all the leases for this client-id
-            Lease4Collection leases_client_id = LeaseMgrFactory::instance().getLease4(*client_id);
+            const Lease4Collection& leases_client_id = ctx->getLeases4ByClientId();
             if (!leases_client_id.empty()) {
                 Subnet4Ptr s = original_subnet;
 
@@ -2680,7 +2941,7 @@ Dhcpv4Srv::assignLease(Dhcpv4Exchange& ex) {
         if (!lease && hwaddr) {
 
             // Get all leases for this particular hw-address.
-            Lease4Collection leases_hwaddr = LeaseMgrFactory::instance().getLease4(*hwaddr);
+            const Lease4Collection& leases_hwaddr = ctx->getLeases4ByHWAddr();
             if (!leases_hwaddr.empty()) {
                 Subnet4Ptr s = original_subnet;
 
@@ -2750,7 +3011,9 @@ Dhcpv4Srv::assignLease(Dhcpv4Exchange& ex) {
     processClientName(ex);
 
     // Get a lease.
+    query->setEventTime(Pkt::EVENT_ALLOC_STARTED);
     Lease4Ptr lease = alloc_engine_->allocateLease4(*ctx);
+    query->setEventTime(Pkt::EVENT_ALLOC_FINISHED);
 
     // Tracks whether or not the client name (FQDN or host) has changed since
     // the lease was allocated.
@@ -3040,8 +3303,7 @@ Dhcpv4Srv::checkRelayPort(const Dhcpv4Exchange& ex) {
 
     // Look for a relay-port RAI sub-option in the query.
     const Pkt4Ptr& query = ex.getQuery();
-    const OptionPtr& rai = query->getOption(DHO_DHCP_AGENT_OPTIONS);
-    if (rai && rai->getOption(RAI_OPTION_RELAY_PORT)) {
+    if (query->getRAISubOption(RAI_OPTION_RELAY_PORT)) {
         // Got the sub-option so use the remote port set by the relay.
         return (query->getRemotePort());
     }
@@ -3422,6 +3684,10 @@ Dhcpv4Srv::processDiscover(Pkt4Ptr& discover, AllocEngine::ClientContext4Ptr& co
 
     appendServerID(ex);
 
+    // Return the pointer to the context, which will be required by the
+    // lease4_offer callouts.
+    context = ex.getContext();
+
     return (ex.getResponse());
 }
 
@@ -3664,6 +3930,14 @@ Dhcpv4Srv::processDecline(Pkt4Ptr& decline, AllocEngine::ClientContext4Ptr& cont
     // We could also extract client's address from ciaddr, but that's clearly
     // against RFC2131.
 
+    // An address declined again during its probation period no longer
+    // belongs to any client: there is no need to look up the lease.
+    if (alloc_engine_->getDeclineProbation().isOnProbation(addr)) {
+        LOG_DEBUG(lease4_logger, DBG_DHCP4_DETAIL, DHCP4_DECLINE_ON_PROBATION)
+            .arg(addr.toText()).arg(decline->getLabel());
+        return;
+    }
+
     // Now we need to check whether this address really belongs to the client
     // that attempts to decline it.
     const Lease4Ptr lease = LeaseMgrFactory::instance().getLease4(addr);
@@ -3774,6 +4048,9 @@ Dhcpv4Srv::declineLease(const Lease4Ptr& lease, const Pkt4Ptr& decline,
         return;
     }
 
+    // Remember the address until the end of its probation.
+    alloc_engine_->getDeclineProbation().add(lease->addr_, lease->valid_lft_);
+
     // Remove existing DNS entries for the lease, if any.
     // queueNCR will do the necessary checks and will skip the update, if not needed.
     queueNCR(CHG_REMOVE, old_values);
@@ -4028,12 +4305,9 @@ Dhcpv4Srv::acceptServerId(const Pkt4Ptr& query) const {
 
     // According to RFC5107, the RAI_OPTION_SERVER_ID_OVERRIDE option if
     // present, should match DHO_DHCP_SERVER_IDENTIFIER option.
-    OptionPtr rai_option = query->getOption(DHO_DHCP_AGENT_OPTIONS);
-    if (rai_option) {
-        OptionPtr rai_suboption = rai_option->getOption(RAI_OPTION_SERVER_ID_OVERRIDE);
-        if (rai_suboption && (server_id.toBytes() == rai_suboption->toBinary())) {
-            return (true);
-        }
+    OptionPtr rai_suboption = query->getRAISubOption(RAI_OPTION_SERVER_ID_OVERRIDE);
+    if (rai_suboption && (server_id.toBytes() == rai_suboption->toBinary())) {
+        return (true);
     }
 
     // Skip address check if configured to ignore the server id.
@@ -4378,6 +4652,9 @@ Dhcpv4Srv::getVersion(bool extended) {
 #endif
 #ifdef HAVE_PGSQL
         tmp << PgSqlLeaseMgr::getDBVersion() << endl;
+#endif
+#ifdef HAVE_LMDB
+        tmp << LmdbLeaseMgr::getDBVersion() << endl;
 #endif
         tmp << Memfile_LeaseMgr::getDBVersion(Memfile_LeaseMgr::V4);
 
@@ -4391,39 +4668,9 @@ void Dhcpv4Srv::processStatsReceived(const Pkt4Ptr& query) {
     // Note that we're not bumping pkt4-received statistic as it was
     // increased early in the packet reception code.
 
-    string stat_name = "pkt4-unknown-received";
+    int type = DHCP_NOTYPE;
     try {
-        switch (query->getType()) {
-        case DHCPDISCOVER:
-            stat_name = "pkt4-discover-received";
-            break;
-        case DHCPOFFER:
-            // Should not happen, but let's keep a counter for it
-            stat_name = "pkt4-offer-received";
-            break;
-        case DHCPREQUEST:
-            stat_name = "pkt4-request-received";
-            break;
-        case DHCPACK:
-            // Should not happen, but let's keep a counter for it
-            stat_name = "pkt4-ack-received";
-            break;
-        case DHCPNAK:
-            // Should not happen, but let's keep a counter for it
-            stat_name = "pkt4-nak-received";
-            break;
-        case DHCPRELEASE:
-            stat_name = "pkt4-release-received";
-        break;
-        case DHCPDECLINE:
-            stat_name = "pkt4-decline-received";
-            break;
-        case DHCPINFORM:
-            stat_name = "pkt4-inform-received";
-            break;
-        default:
-            ; // do nothing
-        }
+        type = query->getType();
     }
     catch (...) {
         // If the incoming packet doesn't have option 53 (message type)
@@ -4432,34 +4679,31 @@ void Dhcpv4Srv::processStatsReceived(const Pkt4Ptr& query) {
         // name of pkt4-unknown-received.
     }
 
-    isc::stats::StatsMgr::instance().addValue(stat_name,
-                                              static_cast<int64_t>(1));
+    receivedCounter(type)->add();
 }
 
 void Dhcpv4Srv::processStatsSent(const Pkt4Ptr& response) {
     // Increase generic counter for sent packets.
-    isc::stats::StatsMgr::instance().addValue("pkt4-sent",
-                                              static_cast<int64_t>(1));
+    Counters.sent_->add();
 
     // Increase packet type specific counter for packets sent.
-    string stat_name;
+    StatCounter* counter = 0;
     switch (response->getType()) {
     case DHCPOFFER:
-        stat_name = "pkt4-offer-sent";
+        counter = Counters.offer_sent_.get();
         break;
     case DHCPACK:
-        stat_name = "pkt4-ack-sent";
+        counter = Counters.ack_sent_.get();
         break;
     case DHCPNAK:
-        stat_name = "pkt4-nak-sent";
+        counter = Counters.nak_sent_.get();
         break;
     default:
         // That should never happen
         return;
     }
 
-    isc::stats::StatsMgr::instance().addValue(stat_name,
-                                              static_cast<int64_t>(1));
+    counter->add();
 }
 
 int Dhcpv4Srv::getHookIndexBuffer4Receive() {
@@ -4493,6 +4737,7 @@ int Dhcpv4Srv::getHookIndexLease4Decline() {
 void Dhcpv4Srv::discardPackets() {
     // Dump all of our current packets, anything that is mid-stream
     HooksManager::clearParkingLots();
+    durable_parking_lot_->clear();
 }
 
 std::list<std::list<std::string>> Dhcpv4Srv::jsonPathsToRedact() const {
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,6 +14,9 @@
 #include <dhcp/option4_client_fqdn.h>
 #include <dhcp/option_custom.h>
 #include <dhcp/pkt4.h>
+#include <dhcp4/merged_options_cache.h>
+#include <dhcp4/query_pre_filter.h>
+#include <dhcp4/requested_options_cache.h>
 #include <dhcp_ddns/ncr_msg.h>
 #include <dhcpsrv/alloc_engine.h>
 #include <dhcpsrv/callout_handle_store.h>
@@ -23,6 +26,7 @@
 #include <dhcpsrv/network_state.h>
 #include <dhcpsrv/subnet.h>
 #include <hooks/callout_handle.h>
+#include <hooks/parking_lots.h>
 #include <process/daemon.h>
 
 #include <functional>
@@ -177,7 +181,8 @@ public:
     /// @note Second part of the classification.
     ///
     /// Evaluate expressions of client classes: if it returns true the class
-    /// is added to the incoming packet.
+    /// is added to the incoming packet. The values of the option tokens
+    /// are computed once for all the expressions.
     ///
     /// @param pkt packet to be classified.
     /// @param depend_on_known if false classes depending on the KNOWN or
@@ -338,6 +343,20 @@ public:
     /// a response.
     void run_one();
 
+    /// @brief Checks a received query before it is queued.
+    ///
+    /// Used in multi-threading mode to drop without a worker thread the
+    /// queries which would be dropped after being unpacked, and the
+    /// retransmissions of the queries in flight. The statistics and the
+    /// logs of the dropped queries are the same as when they are dropped
+    /// by a worker.
+    ///
+    /// @param query The received query which was not unpacked yet.
+    /// @param [out] ticket The ticket holding the identity of the query
+    /// until its processing ends.
+    /// @return true if the query must be queued, false if it was dropped.
+    bool preFilterQuery(const Pkt4Ptr& query, QueryPreFilter::TicketPtr& ticket);
+
     /// @brief Process a single incoming DHCPv4 packet and sends the response.
     ///
     /// It verifies correctness of the passed packet, calls per-type processXXX
@@ -362,6 +381,24 @@ public:
     void sendResponseNoThrow(hooks::CalloutHandlePtr& callout_handle,
                              Pkt4Ptr& query, Pkt4Ptr& rsp);
 
+    /// @brief Holds the response until the lease changes are durable.
+    ///
+    /// When the lease backend writes the lease changes in background,
+    /// e.g. the memfile backend in the write-behind mode or the SQL
+    /// backends with asynchronous lease updates, the response is parked
+    /// until the changes made by the current thread are on the disk or
+    /// committed by the database. The response is then sent by a thread of the packet thread
+    /// pool, or dropped if the changes could not be written.
+    ///
+    /// @param callout_handle pointer to the callout handle.
+    /// @param query A pointer to the processed packet.
+    /// @param rsp A pointer to the response.
+    ///
+    /// @return true if the response was parked, false if it can be sent
+    /// immediately.
+    bool parkUntilLeasesDurable(hooks::CalloutHandlePtr& callout_handle,
+                                Pkt4Ptr& query, Pkt4Ptr& rsp);
+
     /// @brief Process a single incoming DHCPv4 packet.
     ///
     /// It verifies correctness of the passed packet, calls per-type processXXX
@@ -1140,6 +1177,21 @@ protected:
     /// @brief Controls access to the configuration backends.
     CBControlDHCPv4Ptr cb_control_;
 
+    /// @brief Holds the responses waiting for the lease changes to be
+    /// durable.
+    hooks::ParkingLotPtr durable_parking_lot_;
+
+    /// @brief Caches the configured options selected for the responses.
+    RequestedOptionsCache requested_options_cache_;
+
+    /// @brief Caches the pool, subnet and shared network options merged
+    /// in a single container.
+    MergedOptionsCache merged_options_cache_;
+
+    /// @brief Checks the received queries before they are queued in
+    /// multi-threading mode.
+    QueryPreFilter query_pre_filter_;
+
 private:
 
     /// @brief store value that defines if kea will send responses
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -54,30 +54,36 @@ void Dhcp4to6Ipc::open() {
 
 void Dhcp4to6Ipc::handler(int /* fd */) {
     Dhcp4to6Ipc& ipc = Dhcp4to6Ipc::instance();
-    Pkt6Ptr pkt;
 
-    try {
-        LOG_DEBUG(packet4_logger, DBG_DHCP4_DETAIL, DHCP4_DHCP4O6_RECEIVING);
-        // Receive message from the IPC socket.
-        pkt = ipc.receive();
+    // Process the messages already queued on the socket at once.
+    for (size_t count = 0; count < MAX_BATCH_SIZE; ++count) {
+        Pkt6Ptr pkt;
 
-        // from Dhcpv4Srv::run_one() after receivePacket()
-        if (pkt) {
+        try {
+            LOG_DEBUG(packet4_logger, DBG_DHCP4_DETAIL, DHCP4_DHCP4O6_RECEIVING);
+            // Receive message from the IPC socket.
+            pkt = ipc.receive();
+            if (!pkt) {
+                // No more queued message.
+                return;
+            }
+
+            // from Dhcpv4Srv::run_one() after receivePacket()
             LOG_DEBUG(packet4_logger, DBG_DHCP4_BASIC, DHCP4_DHCP4O6_PACKET_RECEIVED)
                 .arg(static_cast<int>(pkt->getType()))
                 .arg(pkt->getRemoteAddr().toText())
                 .arg(pkt->getRemotePort())
                 .arg(pkt->getIface());
+        } catch (const std::exception& e) {
+            LOG_DEBUG(packet4_logger, DBG_DHCP4_DETAIL, DHCP4_DHCP4O6_RECEIVE_FAIL)
+                .arg(e.what());
+            continue;
         }
-    } catch (const std::exception& e) {
-        LOG_DEBUG(packet4_logger, DBG_DHCP4_DETAIL, DHCP4_DHCP4O6_RECEIVE_FAIL)
-            .arg(e.what());
-    }
-
-    if (!pkt) {
-        return;
+        process(pkt);
     }
+}
 
+void Dhcp4to6Ipc::process(const Pkt6Ptr& pkt) {
     // Each message must contain option holding DHCPv4 message.
     OptionCollection msgs = pkt->getOptions(D6O_DHCPV4_MSG);
     if (msgs.empty()) {
@@ -175,7 +181,7 @@ void Dhcp4to6Ipc::handler(int /* fd */) {
             .arg(static_cast<int>(rsp6->getType()))
             .arg(rsp6->toText());
 
-        ipc.send(rsp6->getPkt6());
+        Dhcp4to6Ipc::instance().send(rsp6->getPkt6());
 
         // Update statistics accordingly for sent packet.
         Dhcpv4Srv::processStatsSent(rsp);
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -45,9 +45,18 @@ public:
 
     /// @brief On receive handler
     ///
-    /// The handler processes the DHCPv4-query DHCPv6 packet and
-    /// sends the DHCPv4-response DHCPv6 packet back to the DHCPv6 server
+    /// The handler processes the DHCPv4-query DHCPv6 packets queued on
+    /// the socket, up to @c MAX_BATCH_SIZE packets.
     static void handler(int /* fd */);
+
+private:
+    /// @brief Processes a received packet.
+    ///
+    /// Processes the DHCPv4-query DHCPv6 packet and sends the
+    /// DHCPv4-response DHCPv6 packet back to the DHCPv6 server.
+    ///
+    /// @param pkt The received packet.
+    static void process(const Pkt6Ptr& pkt);
 };
 
 } // namespace isc
@@ -0,0 +1,154 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcp/dhcp4.h>
+#include <dhcp/option_space.h>
+#include <dhcp4/merged_options_cache.h>
+#include <dhcpsrv/cfgmgr.h>
+
+#include <set>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+using namespace isc::dhcp;
+
+/// @brief Merges the options of an option space.
+///
+/// @tparam Selector Option space name or vendor identifier.
+/// @param co_list The configuration option containers in priority order.
+/// @param key The option space name or vendor identifier.
+/// @param space The option space name.
+/// @param merged The merged container.
+/// @return false when the options can't be merged.
+template<typename Selector>
+bool
+mergeSpace(const CfgOptionList& co_list, const Selector& key,
+           const string& space, CfgOption& merged) {
+    // Index of the container the instances of each option code are
+    // taken from.
+    map<uint16_t, size_t> owners;
+    size_t index = 0;
+    for (auto const& copts : co_list) {
+        OptionContainerPtr options = copts->getAll(key);
+        if (options) {
+            for (auto const& desc : *options) {
+                if (!desc.option_) {
+                    continue;
+                }
+                uint16_t code = desc.option_->getType();
+                auto owner = owners.insert(make_pair(code, index)).first;
+                if (owner->second == index) {
+                    merged.add(desc, space);
+                    continue;
+                }
+                // The instance is overridden: check it does not change
+                // the options sent to the clients.
+                if (desc.persistent_ || desc.cancelled_) {
+                    return (false);
+                }
+                if ((space == DHCP4_OPTION_SPACE) &&
+                    ((code == DHO_VIVCO_SUBOPTIONS) ||
+                     (code == DHO_VIVSO_SUBOPTIONS))) {
+                    return (false);
+                }
+            }
+        }
+        ++index;
+    }
+    return (true);
+}
+
+}
+
+namespace isc {
+namespace dhcp {
+
+const size_t MergedOptionsCache::DEFAULT_MAX_ENTRIES;
+
+MergedOptionsCache::MergedOptionsCache(size_t max_entries)
+    : entries_(), cfg_version_(0), max_entries_(max_entries) {
+}
+
+ConstCfgOptionPtr
+MergedOptionsCache::get(const CfgOptionList& co_list) {
+    Key key(co_list.begin(), co_list.end());
+
+    uint64_t cfg_version = CfgMgr::instance().getCurrentCfgVersion();
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (cfg_version_ != cfg_version) {
+            entries_.clear();
+            cfg_version_ = cfg_version;
+        }
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            return (it->second);
+        }
+    }
+
+    ConstCfgOptionPtr merged = merge(co_list);
+
+    lock_guard<mutex> lock(mutex_);
+    if (cfg_version_ == cfg_version) {
+        if (entries_.size() >= max_entries_) {
+            entries_.clear();
+        }
+        entries_[key] = merged;
+    }
+    return (merged);
+}
+
+ConstCfgOptionPtr
+MergedOptionsCache::merge(const CfgOptionList& co_list) {
+    set<string> spaces;
+    set<uint32_t> vendor_ids;
+    for (auto const& copts : co_list) {
+        for (auto const& space : copts->getOptionSpaceNames()) {
+            static_cast<void>(spaces.insert(space));
+        }
+        for (auto const& vendor_id : copts->getVendorIds()) {
+            static_cast<void>(vendor_ids.insert(vendor_id));
+        }
+    }
+
+    CfgOptionPtr merged(new CfgOption());
+    for (auto const& space : spaces) {
+        if (!mergeSpace(co_list, space, space, *merged)) {
+            return (ConstCfgOptionPtr());
+        }
+    }
+    for (auto const& vendor_id : vendor_ids) {
+        // Vendor space name is constructed as "vendor-XYZ" where XYZ is
+        // the vendor identifier.
+        ostringstream space;
+        space << "vendor-" << vendor_id;
+        if (!mergeSpace(co_list, vendor_id, space.str(), *merged)) {
+            return (ConstCfgOptionPtr());
+        }
+    }
+    return (merged);
+}
+
+void
+MergedOptionsCache::clear() {
+    lock_guard<mutex> lock(mutex_);
+    entries_.clear();
+}
+
+size_t
+MergedOptionsCache::size() const {
+    lock_guard<mutex> lock(mutex_);
+    return (entries_.size());
+}
+
+} // namespace isc::dhcp
+} // namespace isc
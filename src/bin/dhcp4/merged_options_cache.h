@@ -0,0 +1,98 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MERGED_OPTIONS_CACHE_H
+#define MERGED_OPTIONS_CACHE_H
+
+#include <dhcpsrv/cfg_option.h>
+#include <boost/noncopyable.hpp>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Cache of the pool, subnet and shared network options merged
+/// in a single container.
+///
+/// The configuration option containers of the pool, subnet and shared
+/// network selected for a client only depend on the configuration, so
+/// they are merged once into a container holding, for each option code,
+/// the instances of the container with the highest priority. The server
+/// looks up the requested options in the merged container instead of
+/// walking the three containers; only the host, class and global
+/// containers are kept separate because the class containers sit
+/// between the shared network and the global containers.
+///
+/// The containers are not merged when the merge would change the
+/// options sent to the clients: when an overridden instance is
+/// persistent or cancelled (the server collects these flags from all
+/// the containers) or when an overridden option is a Vendor-Identifying
+/// Vendor Class or Vendor-Specific Information option (the server sends
+/// the instances of all the containers).
+///
+/// The entries are dropped when the current configuration changes. The
+/// number of entries is bounded: the cache is emptied when it is full.
+class MergedOptionsCache : public boost::noncopyable {
+public:
+
+    /// @brief Default maximum number of entries.
+    static const size_t DEFAULT_MAX_ENTRIES = 4096;
+
+    /// @brief Constructor.
+    ///
+    /// @param max_entries Maximum number of entries.
+    explicit MergedOptionsCache(size_t max_entries = DEFAULT_MAX_ENTRIES);
+
+    /// @brief Returns the merged container for a list of configuration
+    /// option containers.
+    ///
+    /// The containers are merged when they are not in the cache yet.
+    ///
+    /// @param co_list The configuration option containers in priority
+    /// order.
+    /// @return The merged container or null when the containers can't
+    /// be merged.
+    ConstCfgOptionPtr get(const CfgOptionList& co_list);
+
+    /// @brief Merges configuration option containers.
+    ///
+    /// @param co_list The configuration option containers in priority
+    /// order.
+    /// @return The merged container or null when the containers can't
+    /// be merged.
+    static ConstCfgOptionPtr merge(const CfgOptionList& co_list);
+
+    /// @brief Removes all the entries.
+    void clear();
+
+    /// @brief Returns the number of entries.
+    size_t size() const;
+
+private:
+
+    /// @brief Key of an entry: the containers.
+    typedef std::vector<ConstCfgOptionPtr> Key;
+
+    /// @brief The entries.
+    std::map<Key, ConstCfgOptionPtr> entries_;
+
+    /// @brief Version of the current configuration the entries were made
+    /// for.
+    uint64_t cfg_version_;
+
+    /// @brief Maximum number of entries.
+    size_t max_entries_;
+
+    /// @brief Mutex protecting the entries.
+    mutable std::mutex mutex_;
+};
+
+} // namespace isc::dhcp
+} // namespace isc
+
+#endif // MERGED_OPTIONS_CACHE_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -161,6 +161,8 @@ Parser4Context::contextName() {
         return ("dhcp-socket-type");
     case OUTBOUND_INTERFACE:
         return ("outbound-interface");
+    case EVENT_HANDLER_TYPE:
+        return ("event-handler-type");
     case LEASE_DATABASE:
         return ("lease-database");
     case HOSTS_DATABASE:
@@ -169,6 +171,10 @@ Parser4Context::contextName() {
         return ("database-type");
     case DATABASE_ON_FAIL:
         return ("database-on-fail");
+    case DATABASE_LFC_MODE:
+        return ("database-lfc-mode");
+    case DATABASE_LEASE_FILE_FORMAT:
+        return ("database-lease-file-format");
     case HOST_RESERVATION_IDENTIFIERS:
         return ("host-reservation-identifiers");
     case HOOKS_LIBRARIES:
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -249,6 +249,9 @@ public:
         /// Used while parsing Dhcp4/interfaces/outbound-interface structures.
         OUTBOUND_INTERFACE,
 
+        /// Used while parsing Dhcp4/interfaces/event-handler-type structures.
+        EVENT_HANDLER_TYPE,
+
         /// Used while parsing Dhcp4/lease-database structures.
         LEASE_DATABASE,
 
@@ -261,6 +264,12 @@ public:
         /// Used while parsing Dhcp4/*-database/on-fail.
         DATABASE_ON_FAIL,
 
+        /// Used while parsing Dhcp4/lease-database/lfc-mode.
+        DATABASE_LFC_MODE,
+
+        /// Used while parsing Dhcp4/lease-database/lease-file-format.
+        DATABASE_LEASE_FILE_FORMAT,
+
         /// Used while parsing Dhcp4/host-reservation-identifiers.
         HOST_RESERVATION_IDENTIFIERS,
 
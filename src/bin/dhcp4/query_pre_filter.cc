@@ -0,0 +1,152 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcp/dhcp4.h>
+#include <dhcp4/query_pre_filter.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+/// @brief Offset of the hardware type in the fixed header.
+const size_t HTYPE_OFFSET = 1;
+
+/// @brief Offset of the hardware address length in the fixed header.
+const size_t HLEN_OFFSET = 2;
+
+/// @brief Offset of the transaction id in the fixed header.
+const size_t XID_OFFSET = 4;
+
+/// @brief Offset of the client hardware address in the fixed header.
+const size_t CHADDR_OFFSET = 28;
+
+}
+
+namespace isc {
+namespace dhcp {
+
+const int QueryPreFilter::UNKNOWN_TYPE;
+
+QueryPreFilter::Ticket::Ticket(const boost::shared_ptr<InFlight>& in_flight,
+                               const string& key)
+    : in_flight_(in_flight), key_(key) {
+}
+
+QueryPreFilter::Ticket::~Ticket() {
+    lock_guard<mutex> lock(in_flight_->mutex_);
+    in_flight_->keys_.erase(key_);
+}
+
+QueryPreFilter::QueryPreFilter() : in_flight_(new InFlight()) {
+}
+
+QueryPreFilter::Result
+QueryPreFilter::check(const Pkt4Ptr& query, bool check_content, int& type,
+                      TicketPtr& ticket) {
+    type = UNKNOWN_TYPE;
+    ticket.reset();
+    const vector<uint8_t>& data = query->data_;
+
+    // Without the fixed header nothing is known: the query fails to
+    // unpack unless callouts handle it.
+    if (data.size() < Pkt4::DHCPV4_PKT_HDR_LEN) {
+        return (check_content ? DROP_MALFORMED : ACCEPT);
+    }
+
+    if (check_content) {
+        if (data.size() < Pkt4::DHCPV4_PKT_HDR_LEN + 4) {
+            return (DROP_MALFORMED);
+        }
+        const uint8_t* cookie = &data[Pkt4::DHCPV4_PKT_HDR_LEN];
+        uint32_t magic = (static_cast<uint32_t>(cookie[0]) << 24) |
+                         (static_cast<uint32_t>(cookie[1]) << 16) |
+                         (static_cast<uint32_t>(cookie[2]) << 8) | cookie[3];
+        if (magic != DHCP_OPTIONS_COOKIE) {
+            return (DROP_MALFORMED);
+        }
+        type = getMessageType(data);
+        switch (type) {
+        case UNKNOWN_TYPE:
+        case DHCPDISCOVER:
+        case DHCPREQUEST:
+        case DHCPRELEASE:
+        case DHCPDECLINE:
+        case DHCPINFORM:
+            break;
+        default:
+            return (DROP_TYPE);
+        }
+    }
+
+    // The identity of the query is the client hardware address, the
+    // transaction id and the message type, so a DHCPREQUEST following
+    // a DHCPDISCOVER with the same transaction id is not a duplicate.
+    size_t hlen = min(static_cast<size_t>(data[HLEN_OFFSET]),
+                      Pkt4::MAX_CHADDR_LEN);
+    string key;
+    key.reserve(2 + 4 + 1 + hlen);
+    key.push_back(static_cast<char>(data[HTYPE_OFFSET]));
+    key.push_back(static_cast<char>(hlen));
+    key.append(reinterpret_cast<const char*>(&data[XID_OFFSET]), 4);
+    key.push_back(static_cast<char>(type));
+    key.append(reinterpret_cast<const char*>(&data[CHADDR_OFFSET]), hlen);
+
+    lock_guard<mutex> lock(in_flight_->mutex_);
+    if (!in_flight_->keys_.insert(key).second) {
+        return (DROP_DUPLICATE);
+    }
+    ticket.reset(new Ticket(in_flight_, key));
+    return (ACCEPT);
+}
+
+size_t
+QueryPreFilter::size() const {
+    lock_guard<mutex> lock(in_flight_->mutex_);
+    return (in_flight_->keys_.size());
+}
+
+int
+QueryPreFilter::getMessageType(const vector<uint8_t>& data) {
+    int type = DHCP_NOTYPE;
+    size_t offset = Pkt4::DHCPV4_PKT_HDR_LEN + 4;
+    while (offset < data.size()) {
+        uint8_t code = data[offset];
+        if (code == DHO_END) {
+            break;
+        }
+        if (code == DHO_PAD) {
+            ++offset;
+            continue;
+        }
+        if (offset + 2 > data.size()) {
+            return (UNKNOWN_TYPE);
+        }
+        size_t len = data[offset + 1];
+        if (offset + 2 + len > data.size()) {
+            return (UNKNOWN_TYPE);
+        }
+        if (code == DHO_DHCP_OPTION_OVERLOAD) {
+            // The message type may be in the sname or file fields.
+            return (UNKNOWN_TYPE);
+        }
+        if (code == DHO_DHCP_MESSAGE_TYPE) {
+            if ((len != 1) || (type != DHCP_NOTYPE)) {
+                // Malformed or split (RFC 3396) option.
+                return (UNKNOWN_TYPE);
+            }
+            type = data[offset + 2];
+        }
+        offset += 2 + len;
+    }
+    return (type);
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
@@ -0,0 +1,128 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef QUERY_PRE_FILTER_H
+#define QUERY_PRE_FILTER_H
+
+#include <dhcp/pkt4.h>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Checks of the received queries before they are queued.
+///
+/// In multi-threading mode the queries are unpacked and checked by the
+/// worker threads. The filter runs on the receiving thread before a query
+/// is queued and drops without a worker:
+/// - the queries which would fail to unpack because they are truncated
+///   or have no DHCP magic cookie,
+/// - the queries with a message type the server does not process, e.g.
+///   the responses of other servers,
+/// - the retransmissions of a query still queued or processed.
+///
+/// Only the fixed header and the message type option are decoded. When
+/// the message type can't be found cheaply, e.g. when the options are
+/// malformed or overloaded, the query is left to the worker.
+class QueryPreFilter : public boost::noncopyable {
+private:
+
+    /// @brief The identities of the queries in flight.
+    struct InFlight {
+        /// @brief The identities.
+        std::unordered_set<std::string> keys_;
+
+        /// @brief The mutex protecting the identities.
+        std::mutex mutex_;
+    };
+
+public:
+
+    /// @brief Result of the checks.
+    enum Result {
+        ACCEPT,         ///< The query is queued.
+        DROP_MALFORMED, ///< The query would fail to unpack.
+        DROP_TYPE,      ///< The message type is not processed.
+        DROP_DUPLICATE  ///< The query is a retransmission of a query in flight.
+    };
+
+    /// @brief Message type returned when it is not known before unpack.
+    static const int UNKNOWN_TYPE = -1;
+
+    /// @brief RAII holder of the identity of a query in flight.
+    ///
+    /// The identity is released when the ticket is destroyed, i.e. when
+    /// the processing of the query ends or when it is dropped from the
+    /// queue.
+    class Ticket : public boost::noncopyable {
+    public:
+
+        /// @brief Constructor.
+        ///
+        /// @param in_flight The identities of the queries in flight.
+        /// @param key The identity of the query.
+        Ticket(const boost::shared_ptr<InFlight>& in_flight,
+               const std::string& key);
+
+        /// @brief Destructor.
+        ///
+        /// Releases the identity.
+        ~Ticket();
+
+    private:
+
+        /// @brief The identities of the queries in flight.
+        boost::shared_ptr<InFlight> in_flight_;
+
+        /// @brief The identity of the query.
+        std::string key_;
+    };
+
+    /// @brief Type of shared pointers to tickets.
+    typedef boost::shared_ptr<Ticket> TicketPtr;
+
+    /// @brief Constructor.
+    QueryPreFilter();
+
+    /// @brief Checks a received query.
+    ///
+    /// @param query The query which was not unpacked yet.
+    /// @param check_content When false only the duplicate check is done:
+    /// it must be false when buffer4_receive callouts may transform the
+    /// query before it is unpacked.
+    /// @param [out] type The message type or @c UNKNOWN_TYPE.
+    /// @param [out] ticket Set to the ticket of the query when it is
+    /// accepted and its identity is known.
+    /// @return The result of the checks.
+    Result check(const Pkt4Ptr& query, bool check_content, int& type,
+                 TicketPtr& ticket);
+
+    /// @brief Returns the number of queries in flight.
+    size_t size() const;
+
+    /// @brief Looks for the message type in the wire data of a query.
+    ///
+    /// @param data The wire data of a query with a DHCP magic cookie.
+    /// @return The message type, @c DHCP_NOTYPE when the query has no
+    /// message type option or @c UNKNOWN_TYPE when it can't be found
+    /// without unpacking the query.
+    static int getMessageType(const std::vector<uint8_t>& data);
+
+private:
+
+    /// @brief The identities of the queries in flight.
+    boost::shared_ptr<InFlight> in_flight_;
+};
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // QUERY_PRE_FILTER_H
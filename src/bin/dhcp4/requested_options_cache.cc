@@ -0,0 +1,137 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcp/dhcp4.h>
+#include <dhcp4/requested_options_cache.h>
+#include <dhcpsrv/cfgmgr.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace isc {
+namespace dhcp {
+
+RequestedOptionsCache::RequestedOptionsCache(size_t max_entries)
+    : entries_(), cfg_version_(0), max_entries_(max_entries) {
+}
+
+RequestedOptionsCache::SelectionPtr
+RequestedOptionsCache::get(const CfgOptionList& co_list,
+                           const vector<uint8_t>& prl) {
+    Key key(vector<ConstCfgOptionPtr>(co_list.begin(), co_list.end()), prl);
+    sort(key.second.begin(), key.second.end());
+    key.second.erase(unique(key.second.begin(), key.second.end()),
+                     key.second.end());
+
+    uint64_t cfg_version = CfgMgr::instance().getCurrentCfgVersion();
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (cfg_version_ != cfg_version) {
+            entries_.clear();
+            cfg_version_ = cfg_version;
+        }
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            return (it->second);
+        }
+    }
+
+    SelectionPtr selection = select(co_list, prl);
+
+    lock_guard<mutex> lock(mutex_);
+    if (cfg_version_ == cfg_version) {
+        if (entries_.size() >= max_entries_) {
+            entries_.clear();
+        }
+        entries_[key] = selection;
+    }
+    return (selection);
+}
+
+RequestedOptionsCache::SelectionPtr
+RequestedOptionsCache::select(const CfgOptionList& co_list,
+                              const vector<uint8_t>& prl) {
+    boost::shared_ptr<Selection> selection(new Selection());
+    set<uint8_t>& requested_opts = selection->requested_;
+    set<uint8_t>& cancelled_opts = selection->cancelled_;
+
+    // Get the list of options that client requested.
+    for (uint8_t code : prl) {
+        static_cast<void>(requested_opts.insert(code));
+    }
+
+    // Iterate on the configured option list to add persistent and
+    // cancelled options.
+    for (auto const& copts : co_list) {
+        const OptionContainerPtr& opts = copts->getAll(DHCP4_OPTION_SPACE);
+        if (!opts) {
+            continue;
+        }
+        // Get persistent options.
+        const OptionContainerPersistIndex& pidx = opts->get<2>();
+        const OptionContainerPersistRange& prange = pidx.equal_range(true);
+        for (OptionContainerPersistIndex::const_iterator desc = prange.first;
+             desc != prange.second; ++desc) {
+            // Add the persistent option code to requested options.
+            if (desc->option_) {
+                uint8_t code = static_cast<uint8_t>(desc->option_->getType());
+                static_cast<void>(requested_opts.insert(code));
+            }
+        }
+        // Get cancelled options.
+        const OptionContainerCancelIndex& cidx = opts->get<5>();
+        const OptionContainerCancelRange& crange = cidx.equal_range(true);
+        for (OptionContainerCancelIndex::const_iterator desc = crange.first;
+             desc != crange.second; ++desc) {
+            // Add the cancelled option code to cancelled options.
+            if (desc->option_) {
+                uint8_t code = static_cast<uint8_t>(desc->option_->getType());
+                static_cast<void>(cancelled_opts.insert(code));
+            }
+        }
+    }
+
+    // For each requested option code get the first instance of the option
+    // to be returned to the client.
+    for (uint8_t opt : requested_opts) {
+        if (cancelled_opts.count(opt) > 0) {
+            continue;
+        }
+        // Skip special cases: DHO_VIVSO_SUBOPTIONS.
+        if (opt == DHO_VIVSO_SUBOPTIONS) {
+            continue;
+        }
+        // Iterate on the configured option list
+        for (auto const& copts : co_list) {
+            OptionDescriptor desc = copts->get(DHCP4_OPTION_SPACE, opt);
+            // Got it: add it and jump to the outer loop
+            if (desc.option_) {
+                selection->options_.push_back(desc.option_);
+                break;
+            }
+        }
+    }
+
+    return (selection);
+}
+
+void
+RequestedOptionsCache::clear() {
+    lock_guard<mutex> lock(mutex_);
+    entries_.clear();
+}
+
+size_t
+RequestedOptionsCache::size() const {
+    lock_guard<mutex> lock(mutex_);
+    return (entries_.size());
+}
+
+} // namespace isc::dhcp
+} // namespace isc
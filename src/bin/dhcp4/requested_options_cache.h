@@ -0,0 +1,111 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef REQUESTED_OPTIONS_CACHE_H
+#define REQUESTED_OPTIONS_CACHE_H
+
+#include <dhcp/option.h>
+#include <dhcpsrv/cfg_option.h>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Cache of the configured options selected for the responses.
+///
+/// The options sent to a client depend on the list of configuration
+/// option containers (pool, subnet, shared network, classes and global)
+/// and on the codes the client requested in its Parameter Request List.
+/// Many clients share both so the selection made for a client can be
+/// reused for the next ones: the cache is keyed by the list of containers
+/// and the requested codes.
+///
+/// The entries are dropped when the current configuration changes. The
+/// number of entries is bounded because the requested codes are chosen by
+/// the clients: the cache is emptied when it is full.
+class RequestedOptionsCache : public boost::noncopyable {
+public:
+
+    /// @brief Options selected for a response.
+    struct Selection {
+        /// @brief Codes of the requested and persistent options.
+        std::set<uint8_t> requested_;
+
+        /// @brief Codes of the cancelled options.
+        std::set<uint8_t> cancelled_;
+
+        /// @brief First configured instance of each requested option
+        /// which is not cancelled, in code order.
+        ///
+        /// The vendor options are handled separately by the server.
+        std::vector<OptionPtr> options_;
+    };
+
+    /// @brief Pointer to a selection.
+    typedef boost::shared_ptr<const Selection> SelectionPtr;
+
+    /// @brief Default maximum number of entries.
+    static const size_t DEFAULT_MAX_ENTRIES = 1024;
+
+    /// @brief Constructor.
+    ///
+    /// @param max_entries Maximum number of entries.
+    explicit RequestedOptionsCache(size_t max_entries = DEFAULT_MAX_ENTRIES);
+
+    /// @brief Returns the selection for a list of configuration option
+    /// containers and requested codes.
+    ///
+    /// The selection is made when it is not in the cache yet.
+    ///
+    /// @param co_list The configuration option containers.
+    /// @param prl The codes requested by the client.
+    /// @return The selection.
+    SelectionPtr get(const CfgOptionList& co_list,
+                     const std::vector<uint8_t>& prl);
+
+    /// @brief Makes a selection.
+    ///
+    /// @param co_list The configuration option containers.
+    /// @param prl The codes requested by the client.
+    /// @return The selection.
+    static SelectionPtr select(const CfgOptionList& co_list,
+                               const std::vector<uint8_t>& prl);
+
+    /// @brief Removes all the entries.
+    void clear();
+
+    /// @brief Returns the number of entries.
+    size_t size() const;
+
+private:
+
+    /// @brief Key of an entry: the containers and the sorted codes.
+    typedef std::pair<std::vector<ConstCfgOptionPtr>, std::vector<uint8_t>> Key;
+
+    /// @brief The entries.
+    std::map<Key, SelectionPtr> entries_;
+
+    /// @brief Version of the current configuration the entries were made
+    /// for.
+    uint64_t cfg_version_;
+
+    /// @brief Maximum number of entries.
+    size_t max_entries_;
+
+    /// @brief Mutex protecting the entries.
+    mutable std::mutex mutex_;
+};
+
+} // namespace isc::dhcp
+} // namespace isc
+
+#endif // REQUESTED_OPTIONS_CACHE_H
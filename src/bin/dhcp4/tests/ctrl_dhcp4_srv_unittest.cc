@@ -550,16 +550,21 @@ TEST_F(CtrlChannelDhcpv4SrvTest, commandsRegistration) {
 
     EXPECT_TRUE(command_list.find("\"list-commands\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"build-report\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"callout-timing-get\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"callout-timing-reset\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"callout-timing-set\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"config-backend-pull\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"config-get\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"config-set\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"config-write\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"leases-reclaim\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"libreload\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"memory-stats\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"server-tag-get\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"shutdown\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"statistic-get\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"statistic-get-all\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"statistic-latency-get\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"statistic-remove\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"statistic-remove-all\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"statistic-reset\"") != string::npos);
@@ -1096,6 +1101,52 @@ TEST_F(CtrlChannelDhcpv4SrvTest, serverTagGet) {
     expected = "{ \"arguments\": { \"server-tag\": \"foobar\" }, \"result\": 0 }";
 }
 
+// This test verifies that the DHCP server handles memory-stats commands
+TEST_F(CtrlChannelDhcpv4SrvTest, memoryStats) {
+    createUnixChannelServer();
+
+    std::string response_txt;
+    sendUnixCommand("{ \"command\": \"memory-stats\" }", response_txt);
+    ConstElementPtr response;
+    ASSERT_NO_THROW(response = Element::fromJSON(response_txt));
+    ASSERT_TRUE(response);
+    ASSERT_EQ(Element::map, response->getType());
+    ConstElementPtr result = response->get("result");
+    ASSERT_TRUE(result);
+    EXPECT_EQ(0, result->intValue());
+    ConstElementPtr arguments = response->get("arguments");
+    ASSERT_TRUE(arguments);
+    ASSERT_EQ(Element::map, arguments->getType());
+
+    ConstElementPtr leases = arguments->get("leases");
+    ASSERT_TRUE(leases);
+    ASSERT_EQ(Element::map, leases->getType());
+    ASSERT_TRUE(leases->get("leases4"));
+    EXPECT_EQ(0, leases->get("leases4")->intValue());
+    ASSERT_TRUE(leases->get("affinity"));
+
+    ConstElementPtr hosts = arguments->get("hosts");
+    ASSERT_TRUE(hosts);
+    ASSERT_TRUE(hosts->get("configured"));
+    EXPECT_EQ(0, hosts->get("configured")->intValue());
+    ASSERT_TRUE(hosts->get("cache"));
+    EXPECT_EQ(0, hosts->get("cache")->intValue());
+
+    ASSERT_TRUE(arguments->get("subnets"));
+    EXPECT_EQ(0, arguments->get("subnets")->intValue());
+
+    ConstElementPtr caches = arguments->get("option-caches");
+    ASSERT_TRUE(caches);
+    EXPECT_TRUE(caches->get("requested-options"));
+    EXPECT_TRUE(caches->get("merged-options"));
+
+    ASSERT_TRUE(arguments->get("statistics"));
+    EXPECT_LE(0, arguments->get("statistics")->intValue());
+
+    ASSERT_TRUE(arguments->get("max-rss"));
+    EXPECT_LT(0, arguments->get("max-rss")->intValue());
+}
+
 // This test verifies that the DHCP server handles status-get commands
 TEST_F(CtrlChannelDhcpv4SrvTest, statusGet) {
     createUnixChannelServer();
@@ -1415,6 +1466,9 @@ TEST_F(CtrlChannelDhcpv4SrvTest, listCommands) {
 
     // We expect the server to report at least the following commands:
     checkListCommands(rsp, "build-report");
+    checkListCommands(rsp, "callout-timing-get");
+    checkListCommands(rsp, "callout-timing-reset");
+    checkListCommands(rsp, "callout-timing-set");
     checkListCommands(rsp, "config-backend-pull");
     checkListCommands(rsp, "config-get");
     checkListCommands(rsp, "config-reload");
@@ -1424,11 +1478,13 @@ TEST_F(CtrlChannelDhcpv4SrvTest, listCommands) {
     checkListCommands(rsp, "list-commands");
     checkListCommands(rsp, "leases-reclaim");
     checkListCommands(rsp, "libreload");
+    checkListCommands(rsp, "memory-stats");
     checkListCommands(rsp, "version-get");
     checkListCommands(rsp, "server-tag-get");
     checkListCommands(rsp, "shutdown");
     checkListCommands(rsp, "statistic-get");
     checkListCommands(rsp, "statistic-get-all");
+    checkListCommands(rsp, "statistic-latency-get");
     checkListCommands(rsp, "statistic-remove");
     checkListCommands(rsp, "statistic-remove-all");
     checkListCommands(rsp, "statistic-reset");
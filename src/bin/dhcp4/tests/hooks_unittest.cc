@@ -846,6 +846,65 @@ public:
         return (0);
     }
 
+    /// @brief Test callback that stores callout name and passed parameters.
+    ///
+    /// @param callout_handle handle passed by the hooks framework
+    /// @return always 0
+    static int
+    lease4_offer_callout(CalloutHandle& callout_handle) {
+        callback_name_ = string("lease4_offer");
+
+        callout_handle.getArgument("query4", callback_qry_pkt4_);
+        callout_handle.getArgument("response4", callback_resp_pkt4_);
+        callout_handle.getArgument("old_lease", callback_old_lease4_);
+
+        Lease4CollectionPtr leases4;
+        callout_handle.getArgument("leases4", leases4);
+        if (leases4->size() > 0) {
+            callback_lease4_ = leases4->at(0);
+        }
+
+        callback_argument_names_ = callout_handle.getArgumentNames();
+        sort(callback_argument_names_.begin(), callback_argument_names_.end());
+
+        if (callback_qry_pkt4_) {
+            callback_qry_options_copy_ = callback_qry_pkt4_->isCopyRetrievedOptions();
+        }
+
+        return (0);
+    }
+
+    /// @brief Test callback which asks the server to drop the packet.
+    ///
+    /// @param callout_handle handle passed by the hooks framework
+    /// @return always 0
+    static int
+    lease4_offer_drop_callout(CalloutHandle& callout_handle) {
+        callout_handle.setStatus(CalloutHandle::NEXT_STEP_DROP);
+
+        return (lease4_offer_callout(callout_handle));
+    }
+
+    /// @brief Test callback which asks the server to park the packet.
+    ///
+    /// The packet is unparked when the IO service is polled.
+    ///
+    /// @param callout_handle handle passed by the hooks framework
+    /// @return always 0
+    static int
+    lease4_offer_park_callout(CalloutHandle& callout_handle) {
+        lease4_offer_callout(callout_handle);
+
+        io_service_->post(std::bind(&HooksDhcpv4SrvTest::leases4_committed_unpark_callout,
+                                    callout_handle.getParkingLotHandlePtr(),
+                                    callback_qry_pkt4_));
+
+        callout_handle.getParkingLotHandlePtr()->reference(callback_qry_pkt4_);
+        callout_handle.setStatus(CalloutHandle::NEXT_STEP_PARK);
+
+        return (0);
+    }
+
     /// @brief Test host4_identifier callback by setting identifier to "foo".
     ///
     /// @param callout_handle handle passed by the hooks framework
@@ -910,6 +969,7 @@ public:
         callback_subnet4_.reset();
         callback_lease4_.reset();
         callback_deleted_lease4_.reset();
+        callback_old_lease4_.reset();
         callback_hwaddr_.reset();
         callback_clientid_.reset();
         callback_subnet4collection_ = NULL;
@@ -954,6 +1014,9 @@ public:
     /// Pointer to lease4 structure returned in the leases4_committed callout
     static Lease4Ptr callback_deleted_lease4_;
 
+    /// Pointer to lease4 structure returned in the lease4_offer callout
+    static Lease4Ptr callback_old_lease4_;
+
     /// Hardware address returned in the callout
     static HWAddrPtr callback_hwaddr_;
 
@@ -990,6 +1053,7 @@ HWAddrPtr HooksDhcpv4SrvTest::callback_hwaddr_;
 ClientIdPtr HooksDhcpv4SrvTest::callback_clientid_;
 Lease4Ptr HooksDhcpv4SrvTest::callback_lease4_;
 Lease4Ptr HooksDhcpv4SrvTest::callback_deleted_lease4_;
+Lease4Ptr HooksDhcpv4SrvTest::callback_old_lease4_;
 vector<string> HooksDhcpv4SrvTest::callback_argument_names_;
 bool HooksDhcpv4SrvTest::callback_qry_options_copy_;
 bool HooksDhcpv4SrvTest::callback_resp_options_copy_;
@@ -2278,6 +2342,123 @@ TEST_F(HooksDhcpv4SrvTest, leases4CommittedParkRequests) {
     checkCalloutHandleReset(client2.getContext().query_);
 }
 
+// This test verifies that the lease4_offer hook point is triggered for
+// the DHCPDISCOVER with the offered lease.
+TEST_F(HooksDhcpv4SrvTest, lease4OfferDiscover) {
+    IfaceMgrTestConfig test_config(true);
+    IfaceMgr::instance().openSockets4();
+
+    ASSERT_NO_THROW(HooksManager::preCalloutsLibraryHandle().registerCallout(
+                    "lease4_offer", lease4_offer_callout));
+
+    Dhcp4Client client(Dhcp4Client::SELECTING);
+    client.setIfaceName("eth1");
+    client.setIfaceIndex(ETH1_INDEX);
+    ASSERT_NO_THROW(client.doDiscover(boost::shared_ptr<IOAddress>(new IOAddress("192.0.2.100"))));
+
+    // Make sure that we received a response
+    Pkt4Ptr rsp = client.getContext().response_;
+    ASSERT_TRUE(rsp);
+    EXPECT_EQ(DHCPOFFER, rsp->getType());
+
+    EXPECT_EQ("lease4_offer", callback_name_);
+
+    // Check if all expected parameters were really received
+    vector<string> expected_argument_names;
+    expected_argument_names.push_back("query4");
+    expected_argument_names.push_back("response4");
+    expected_argument_names.push_back("leases4");
+    expected_argument_names.push_back("old_lease");
+    sort(expected_argument_names.begin(), expected_argument_names.end());
+    EXPECT_TRUE(callback_argument_names_ == expected_argument_names);
+
+    // The offered lease should be passed to the callout.
+    ASSERT_TRUE(callback_lease4_);
+    EXPECT_EQ("192.0.2.100", callback_lease4_->addr_.toText());
+    ASSERT_TRUE(callback_resp_pkt4_);
+    EXPECT_EQ("192.0.2.100", callback_resp_pkt4_->getYiaddr().toText());
+
+    // The client has no lease yet.
+    EXPECT_FALSE(callback_old_lease4_);
+
+    // Pkt passed to a callout must be configured to copy retrieved options.
+    EXPECT_TRUE(callback_qry_options_copy_);
+
+    // The offered lease is not committed.
+    EXPECT_FALSE(LeaseMgrFactory::instance().getLease4(IOAddress("192.0.2.100")));
+
+    // Check if the callout handle state was reset after the callout.
+    checkCalloutHandleReset(client.getContext().query_);
+
+    // The callout is not called for the DHCPREQUEST.
+    resetCalloutBuffers();
+    ASSERT_NO_THROW(client.doRequest());
+    ASSERT_TRUE(client.getContext().response_);
+    EXPECT_EQ(DHCPACK, client.getContext().response_->getType());
+    EXPECT_TRUE(callback_name_.empty());
+
+    // The lease of the client is passed when it sends a new DHCPDISCOVER.
+    client.setState(Dhcp4Client::SELECTING);
+    ASSERT_NO_THROW(client.doDiscover());
+    ASSERT_TRUE(client.getContext().response_);
+    EXPECT_EQ(DHCPOFFER, client.getContext().response_->getType());
+    EXPECT_EQ("lease4_offer", callback_name_);
+    ASSERT_TRUE(callback_old_lease4_);
+    EXPECT_EQ("192.0.2.100", callback_old_lease4_->addr_.toText());
+}
+
+// This test verifies that a lease4_offer callout can drop the DHCPDISCOVER.
+TEST_F(HooksDhcpv4SrvTest, lease4OfferDrop) {
+    IfaceMgrTestConfig test_config(true);
+    IfaceMgr::instance().openSockets4();
+
+    ASSERT_NO_THROW(HooksManager::preCalloutsLibraryHandle().registerCallout(
+                    "lease4_offer", lease4_offer_drop_callout));
+
+    Dhcp4Client client(Dhcp4Client::SELECTING);
+    client.setIfaceName("eth1");
+    client.setIfaceIndex(ETH1_INDEX);
+    ASSERT_NO_THROW(client.doDiscover());
+
+    // The offer was not sent.
+    EXPECT_FALSE(client.getContext().response_);
+    EXPECT_EQ("lease4_offer", callback_name_);
+
+    // Check if the callout handle state was reset after the callout.
+    checkCalloutHandleReset(client.getContext().query_);
+}
+
+// This test verifies that it is possible to park a DHCPDISCOVER as a result
+// of the lease4_offer callouts.
+TEST_F(HooksDhcpv4SrvTest, lease4OfferPark) {
+    IfaceMgrTestConfig test_config(true);
+    IfaceMgr::instance().openSockets4();
+
+    ASSERT_NO_THROW(HooksManager::preCalloutsLibraryHandle().registerCallout(
+                    "lease4_offer", lease4_offer_park_callout));
+
+    Dhcp4Client client(Dhcp4Client::SELECTING);
+    client.setIfaceName("eth1");
+    client.setIfaceIndex(ETH1_INDEX);
+    ASSERT_NO_THROW(client.doDiscover(boost::shared_ptr<IOAddress>(new IOAddress("192.0.2.100"))));
+
+    // The offer is parked.
+    ASSERT_FALSE(client.getContext().response_);
+    EXPECT_EQ("lease4_offer", callback_name_);
+
+    // Check if the callout handle state was reset after the callout.
+    checkCalloutHandleReset(client.getContext().query_);
+
+    // The callout posted the unpark of the packet.
+    ASSERT_NO_THROW(io_service_->poll());
+
+    ASSERT_NO_THROW(client.receiveResponse());
+    Pkt4Ptr rsp = client.getContext().response_;
+    ASSERT_TRUE(rsp);
+    EXPECT_EQ(DHCPOFFER, rsp->getType());
+    EXPECT_EQ("192.0.2.100", rsp->getYiaddr().toText());
+}
+
 // This test verifies that incoming (positive) REQUEST/Renewing can be handled
 // properly and that callout installed on lease4_renew is triggered with
 // expected parameters.
@@ -0,0 +1,147 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/option.h>
+#include <dhcp4/merged_options_cache.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <gtest/gtest.h>
+
+using namespace isc;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture class for testing the merged options cache.
+class MergedOptionsCacheTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Creates a subnet and a shared network option container.
+    MergedOptionsCacheTest()
+        : subnet_(new CfgOption()), network_(new CfgOption()) {
+        CfgMgr::instance().clear();
+        subnet_->add(createOption(DHO_ROUTERS, 1), false, false,
+                     DHCP4_OPTION_SPACE);
+        subnet_->add(createOption(DHO_NTP_SERVERS, 2), true, false,
+                     DHCP4_OPTION_SPACE);
+        network_->add(createOption(DHO_ROUTERS, 3), false, false,
+                      DHCP4_OPTION_SPACE);
+        network_->add(createOption(DHO_DOMAIN_NAME_SERVERS, 4), false, false,
+                      DHCP4_OPTION_SPACE);
+        network_->add(createOption(1, 5), false, false, "vendor-4491");
+        co_list_.push_back(subnet_);
+        co_list_.push_back(network_);
+    }
+
+    /// @brief Destructor.
+    ~MergedOptionsCacheTest() {
+        CfgMgr::instance().clear();
+    }
+
+    /// @brief Creates an option.
+    ///
+    /// @param code Code of the option.
+    /// @param value Value of the option data.
+    OptionPtr createOption(uint16_t code, uint8_t value) {
+        return (OptionPtr(new Option(Option::V4, code, OptionBuffer(4, value))));
+    }
+
+    /// @brief Subnet options.
+    CfgOptionPtr subnet_;
+
+    /// @brief Shared network options.
+    CfgOptionPtr network_;
+
+    /// @brief Configured option list.
+    CfgOptionList co_list_;
+};
+
+// Verifies that the merged container holds the instances of the container
+// with the highest priority.
+TEST_F(MergedOptionsCacheTest, merge) {
+    ConstCfgOptionPtr merged = MergedOptionsCache::merge(co_list_);
+    ASSERT_TRUE(merged);
+
+    // Routers from the subnet.
+    OptionDescriptorList routers = merged->getList(DHCP4_OPTION_SPACE,
+                                                   DHO_ROUTERS);
+    ASSERT_EQ(1, routers.size());
+    EXPECT_EQ(1, routers[0].option_->getData()[0]);
+
+    // The persistent flag is kept.
+    OptionDescriptor desc = merged->get(DHCP4_OPTION_SPACE, DHO_NTP_SERVERS);
+    ASSERT_TRUE(desc.option_);
+    EXPECT_TRUE(desc.persistent_);
+
+    // DNS servers and the vendor option from the shared network.
+    desc = merged->get(DHCP4_OPTION_SPACE, DHO_DOMAIN_NAME_SERVERS);
+    ASSERT_TRUE(desc.option_);
+    EXPECT_EQ(4, desc.option_->getData()[0]);
+    desc = merged->get(4491, 1);
+    ASSERT_TRUE(desc.option_);
+    EXPECT_EQ(5, desc.option_->getData()[0]);
+}
+
+// Verifies that the containers are not merged when an overridden instance
+// is persistent or cancelled.
+TEST_F(MergedOptionsCacheTest, mergeOverriddenFlags) {
+    network_->add(createOption(DHO_NTP_SERVERS, 6), true, false,
+                  DHCP4_OPTION_SPACE);
+    EXPECT_FALSE(MergedOptionsCache::merge(co_list_));
+
+    CfgOptionPtr network(new CfgOption());
+    network->add(createOption(DHO_ROUTERS, 7), false, true,
+                 DHCP4_OPTION_SPACE);
+    CfgOptionList co_list;
+    co_list.push_back(subnet_);
+    co_list.push_back(network);
+    EXPECT_FALSE(MergedOptionsCache::merge(co_list));
+}
+
+// Verifies that the containers are not merged when a vendor option is
+// overridden.
+TEST_F(MergedOptionsCacheTest, mergeOverriddenVendor) {
+    subnet_->add(createOption(DHO_VIVSO_SUBOPTIONS, 8), false, false,
+                 DHCP4_OPTION_SPACE);
+    EXPECT_TRUE(MergedOptionsCache::merge(co_list_));
+
+    network_->add(createOption(DHO_VIVSO_SUBOPTIONS, 9), false, false,
+                  DHCP4_OPTION_SPACE);
+    EXPECT_FALSE(MergedOptionsCache::merge(co_list_));
+}
+
+// Verifies that the merged containers are cached by option list and
+// dropped when the configuration changes.
+TEST_F(MergedOptionsCacheTest, get) {
+    MergedOptionsCache cache;
+    ConstCfgOptionPtr merged = cache.get(co_list_);
+    ASSERT_TRUE(merged);
+    EXPECT_EQ(merged, cache.get(co_list_));
+    EXPECT_EQ(1, cache.size());
+
+    // Another option list makes another container.
+    CfgOptionList reversed;
+    reversed.push_back(network_);
+    reversed.push_back(subnet_);
+    ConstCfgOptionPtr other = cache.get(reversed);
+    ASSERT_TRUE(other);
+    EXPECT_NE(merged, other);
+    EXPECT_EQ(3, other->get(DHCP4_OPTION_SPACE, DHO_ROUTERS).option_->getData()[0]);
+    EXPECT_EQ(2, cache.size());
+
+    CfgMgr::instance().getStagingCfg();
+    CfgMgr::instance().commit();
+    EXPECT_NE(merged, cache.get(co_list_));
+    EXPECT_EQ(1, cache.size());
+
+    cache.clear();
+    EXPECT_EQ(0, cache.size());
+}
+
+}
@@ -334,6 +334,16 @@ TEST(ParserTest, outboundIface) {
     EXPECT_EQ("use-routing", tmp->stringValue());
 }
 
+// Test that the lmdb lease database type and its map-size parameter are
+// accepted.
+TEST(ParserTest, lmdbLeaseDatabase) {
+    string txt = "{ \"Dhcp4\": { \"lease-database\": {\n"
+        "    \"type\": \"lmdb\",\n"
+        "    \"name\": \"/var/lib/kea/kea-leases4.mdb\",\n"
+        "    \"map-size\": 2048 } } }";
+    testParser(txt, Parser4Context::PARSER_DHCP4);
+}
+
 /// @brief Tests error conditions in Dhcp4Parser
 ///
 /// @param txt text to be parsed
@@ -601,6 +611,83 @@ TEST(ParserTest, errors) {
               "<string>:2.2-17: got unexpected keyword "
               "\"valid_lifetime\" in Dhcp4 map.");
 
+    // unknown keyword in multi-threading
+    testError("{ \"Dhcp4\":{\n"
+              " \"multi-threading\": { \"cpu_affinity\": \"0\" }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:2.23-36: got unexpected keyword "
+              "\"cpu_affinity\" in multi-threading map.");
+
+    // unknown keyword in lease-database
+    testError("{ \"Dhcp4\":{\n"
+              " \"lease-database\": { \"load_threads\": 2 }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:2.22-35: got unexpected keyword "
+              "\"load_threads\" in lease-database map.");
+
+    // lease database parameter in hosts-database
+    testError("{ \"Dhcp4\":{\n"
+              " \"hosts-database\": { \"load-threads\": 2 }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:2.22-35: got unexpected keyword "
+              "\"load-threads\" in hosts-database map.");
+
+    // hosts database parameter in lease-database
+    testError("{ \"Dhcp4\":{\n"
+              " \"lease-database\": { \"cache-size\": 100 }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:2.22-33: got unexpected keyword "
+              "\"cache-size\" in lease-database map.");
+
+    // accepted relays not a list
+    testError("{ \"Dhcp4\":{\n"
+              " \"interfaces-config\": { \"accepted-relays\": \"192.0.2.1\" }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:2.44-54: syntax error, unexpected constant string, "
+              "expecting [");
+
+    // cpu affinity not a string
+    testError("{ \"Dhcp4\":{\n"
+              " \"multi-threading\": { \"cpu-affinity\": 1 }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:2.39: syntax error, unexpected integer, "
+              "expecting constant string");
+
+    // bad ncr format
+    testError("{ \"Dhcp4\":{\n"
+              " \"dhcp-ddns\": { \"ncr-format\": \"XML\" }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:2.31-35: syntax error, unexpected constant string, "
+              "expecting binary or JSON");
+
+    // bad event handler type
+    testError("{ \"Dhcp4\":{\n"
+              " \"interfaces-config\": { \"event-handler-type\": \"poll\" }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:2.47-52: syntax error, unexpected constant string, "
+              "expecting select or epoll");
+
+    // unknown database type
+    testError("{ \"Dhcp4\":{\n"
+              " \"lease-database\": { \"type\": \"rocksdb\" }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:2.30-38: syntax error, unexpected constant string, "
+              "expecting memfile or mysql or postgresql or lmdb");
+
+    // map-size in a host database
+    testError("{ \"Dhcp4\":{\n"
+              " \"hosts-database\": { \"map-size\": 1024 }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:2.22-31: got unexpected keyword "
+              "\"map-size\" in hosts-database map.");
+
+    // bad lease file format
+    testError("{ \"Dhcp4\":{\n"
+              " \"lease-database\": { \"lease-file-format\": \"json\" }}}\n",
+              Parser4Context::PARSER_DHCP4,
+              "<string>:2.43-48: syntax error, unexpected constant string, "
+              "expecting csv or binary");
+
     // missing parameter
     testError("{ \"name\": \"foo\",\n"
               "  \"code\": 123 }\n",
@@ -0,0 +1,155 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/option_int.h>
+#include <dhcp/pkt4.h>
+#include <dhcp4/query_pre_filter.h>
+#include <gtest/gtest.h>
+
+using namespace isc;
+using namespace isc::dhcp;
+using namespace std;
+
+namespace {
+
+/// @brief Builds a received query.
+///
+/// @param type The message type.
+/// @param transid The transaction id.
+/// @param mac The last byte of the hardware address.
+/// @return The query holding only its wire data.
+Pkt4Ptr
+buildQuery(uint8_t type, uint32_t transid, uint8_t mac = 1) {
+    Pkt4Ptr pkt(new Pkt4(type, transid));
+    vector<uint8_t> hwaddr = { 0, 1, 2, 3, 4, mac };
+    pkt->setHWAddr(HTYPE_ETHER, hwaddr.size(), hwaddr);
+    pkt->pack();
+    const uint8_t* data =
+        static_cast<const uint8_t*>(pkt->getBuffer().getData());
+    return (Pkt4Ptr(new Pkt4(data, pkt->getBuffer().getLength())));
+}
+
+// Checks the message type lookup.
+TEST(QueryPreFilterTest, getMessageType) {
+    EXPECT_EQ(DHCPDISCOVER,
+              QueryPreFilter::getMessageType(buildQuery(DHCPDISCOVER, 1)->data_));
+    EXPECT_EQ(DHCPACK,
+              QueryPreFilter::getMessageType(buildQuery(DHCPACK, 1)->data_));
+
+    // No option.
+    vector<uint8_t> data = buildQuery(DHCPREQUEST, 1)->data_;
+    data.resize(Pkt4::DHCPV4_PKT_HDR_LEN + 4);
+    EXPECT_EQ(DHCP_NOTYPE, QueryPreFilter::getMessageType(data));
+
+    // Padding then the message type.
+    data.push_back(DHO_PAD);
+    data.push_back(DHO_DHCP_MESSAGE_TYPE);
+    data.push_back(1);
+    data.push_back(DHCPINFORM);
+    data.push_back(DHO_END);
+    EXPECT_EQ(DHCPINFORM, QueryPreFilter::getMessageType(data));
+
+    // A second instance of the option.
+    data.pop_back();
+    data.push_back(DHO_DHCP_MESSAGE_TYPE);
+    data.push_back(1);
+    data.push_back(DHCPINFORM);
+    EXPECT_EQ(QueryPreFilter::UNKNOWN_TYPE,
+              QueryPreFilter::getMessageType(data));
+
+    // A truncated option.
+    data.resize(Pkt4::DHCPV4_PKT_HDR_LEN + 4);
+    data.push_back(DHO_ROUTERS);
+    data.push_back(4);
+    data.push_back(192);
+    EXPECT_EQ(QueryPreFilter::UNKNOWN_TYPE,
+              QueryPreFilter::getMessageType(data));
+
+    // Overloaded options.
+    Pkt4Ptr pkt(new Pkt4(DHCPDISCOVER, 1));
+    pkt->addOption(OptionPtr(new OptionInt<uint8_t>(Option::V4,
+                                                    DHO_DHCP_OPTION_OVERLOAD,
+                                                    1)));
+    pkt->pack();
+    const uint8_t* buf =
+        static_cast<const uint8_t*>(pkt->getBuffer().getData());
+    data.assign(buf, buf + pkt->getBuffer().getLength());
+    EXPECT_EQ(QueryPreFilter::UNKNOWN_TYPE,
+              QueryPreFilter::getMessageType(data));
+}
+
+// Checks that the queries which would not unpack or which are not
+// processed are dropped.
+TEST(QueryPreFilterTest, content) {
+    QueryPreFilter filter;
+    int type = 0;
+    QueryPreFilter::TicketPtr ticket;
+
+    Pkt4Ptr query = buildQuery(DHCPDISCOVER, 1);
+    EXPECT_EQ(QueryPreFilter::ACCEPT, filter.check(query, true, type, ticket));
+    EXPECT_EQ(DHCPDISCOVER, type);
+    EXPECT_TRUE(ticket);
+    ticket.reset();
+
+    query = buildQuery(DHCPOFFER, 1);
+    EXPECT_EQ(QueryPreFilter::DROP_TYPE, filter.check(query, true, type, ticket));
+    EXPECT_EQ(DHCPOFFER, type);
+    EXPECT_FALSE(ticket);
+
+    // Without the content checks the type is not known.
+    EXPECT_EQ(QueryPreFilter::ACCEPT, filter.check(query, false, type, ticket));
+    EXPECT_EQ(QueryPreFilter::UNKNOWN_TYPE, type);
+    ticket.reset();
+
+    // Missing magic cookie.
+    query = buildQuery(DHCPREQUEST, 1);
+    query->data_[Pkt4::DHCPV4_PKT_HDR_LEN] = 0;
+    EXPECT_EQ(QueryPreFilter::DROP_MALFORMED,
+              filter.check(query, true, type, ticket));
+
+    // Truncated header.
+    query->data_.resize(Pkt4::DHCPV4_PKT_HDR_LEN - 1);
+    EXPECT_EQ(QueryPreFilter::DROP_MALFORMED,
+              filter.check(query, true, type, ticket));
+    EXPECT_EQ(QueryPreFilter::ACCEPT, filter.check(query, false, type, ticket));
+    EXPECT_FALSE(ticket);
+    EXPECT_EQ(0, filter.size());
+}
+
+// Checks that the retransmissions of the queries in flight are dropped.
+TEST(QueryPreFilterTest, duplicates) {
+    QueryPreFilter filter;
+    int type = 0;
+    QueryPreFilter::TicketPtr ticket;
+    ASSERT_EQ(QueryPreFilter::ACCEPT,
+              filter.check(buildQuery(DHCPDISCOVER, 1), true, type, ticket));
+    EXPECT_EQ(1, filter.size());
+
+    QueryPreFilter::TicketPtr other;
+    EXPECT_EQ(QueryPreFilter::DROP_DUPLICATE,
+              filter.check(buildQuery(DHCPDISCOVER, 1), true, type, other));
+    EXPECT_FALSE(other);
+
+    // Another transaction id, message type or client is not a duplicate.
+    EXPECT_EQ(QueryPreFilter::ACCEPT,
+              filter.check(buildQuery(DHCPDISCOVER, 2), true, type, other));
+    EXPECT_EQ(QueryPreFilter::ACCEPT,
+              filter.check(buildQuery(DHCPREQUEST, 1), true, type, other));
+    EXPECT_EQ(QueryPreFilter::ACCEPT,
+              filter.check(buildQuery(DHCPDISCOVER, 1, 2), true, type, other));
+    other.reset();
+    EXPECT_EQ(1, filter.size());
+
+    // The end of the processing releases the query.
+    ticket.reset();
+    EXPECT_EQ(0, filter.size());
+    EXPECT_EQ(QueryPreFilter::ACCEPT,
+              filter.check(buildQuery(DHCPDISCOVER, 1), true, type, ticket));
+}
+
+} // end of anonymous namespace
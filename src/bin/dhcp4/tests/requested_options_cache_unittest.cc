@@ -0,0 +1,148 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/option.h>
+#include <dhcp4/requested_options_cache.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <gtest/gtest.h>
+
+using namespace isc;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture class for testing the requested options cache.
+class RequestedOptionsCacheTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Creates a subnet and a global option container.
+    RequestedOptionsCacheTest()
+        : subnet_(new CfgOption()), global_(new CfgOption()) {
+        CfgMgr::instance().clear();
+        subnet_->add(createOption(DHO_ROUTERS, 1), false, false,
+                     DHCP4_OPTION_SPACE);
+        global_->add(createOption(DHO_ROUTERS, 2), false, false,
+                     DHCP4_OPTION_SPACE);
+        global_->add(createOption(DHO_DOMAIN_NAME_SERVERS, 3), false, false,
+                     DHCP4_OPTION_SPACE);
+        global_->add(createOption(DHO_NTP_SERVERS, 4), true, false,
+                     DHCP4_OPTION_SPACE);
+        global_->add(createOption(DHO_DOMAIN_NAME, 5), false, true,
+                     DHCP4_OPTION_SPACE);
+        co_list_.push_back(subnet_);
+        co_list_.push_back(global_);
+    }
+
+    /// @brief Destructor.
+    ~RequestedOptionsCacheTest() {
+        CfgMgr::instance().clear();
+    }
+
+    /// @brief Creates an option.
+    ///
+    /// @param code Code of the option.
+    /// @param value Value of the option data.
+    OptionPtr createOption(uint16_t code, uint8_t value) {
+        return (OptionPtr(new Option(Option::V4, code, OptionBuffer(4, value))));
+    }
+
+    /// @brief Subnet options.
+    CfgOptionPtr subnet_;
+
+    /// @brief Global options.
+    CfgOptionPtr global_;
+
+    /// @brief Configured option list.
+    CfgOptionList co_list_;
+};
+
+// Verifies that the selection picks the first configured instance of the
+// requested and persistent options which are not cancelled.
+TEST_F(RequestedOptionsCacheTest, select) {
+    std::vector<uint8_t> prl = { DHO_DOMAIN_NAME_SERVERS, DHO_ROUTERS,
+                                 DHO_DOMAIN_NAME, DHO_HOST_NAME };
+    RequestedOptionsCache::SelectionPtr selection =
+        RequestedOptionsCache::select(co_list_, prl);
+    ASSERT_TRUE(selection);
+
+    EXPECT_EQ(5, selection->requested_.size());
+    EXPECT_EQ(1, selection->requested_.count(DHO_NTP_SERVERS));
+    EXPECT_EQ(1, selection->cancelled_.size());
+    EXPECT_EQ(1, selection->cancelled_.count(DHO_DOMAIN_NAME));
+
+    // Routers from the subnet, DNS servers and NTP servers from the
+    // global options, in code order.
+    ASSERT_EQ(3, selection->options_.size());
+    EXPECT_EQ(DHO_ROUTERS, selection->options_[0]->getType());
+    EXPECT_EQ(1, selection->options_[0]->getData()[0]);
+    EXPECT_EQ(DHO_DOMAIN_NAME_SERVERS, selection->options_[1]->getType());
+    EXPECT_EQ(DHO_NTP_SERVERS, selection->options_[2]->getType());
+}
+
+// Verifies that the selections are cached by option list and requested
+// codes.
+TEST_F(RequestedOptionsCacheTest, get) {
+    RequestedOptionsCache cache;
+    std::vector<uint8_t> prl = { DHO_DOMAIN_NAME_SERVERS, DHO_ROUTERS };
+    RequestedOptionsCache::SelectionPtr selection = cache.get(co_list_, prl);
+    ASSERT_TRUE(selection);
+    EXPECT_EQ(1, cache.size());
+
+    // The order of the requested codes does not matter.
+    std::vector<uint8_t> reversed = { DHO_ROUTERS, DHO_DOMAIN_NAME_SERVERS };
+    EXPECT_EQ(selection, cache.get(co_list_, reversed));
+    EXPECT_EQ(1, cache.size());
+
+    // Other codes make another selection.
+    std::vector<uint8_t> other = { DHO_ROUTERS };
+    RequestedOptionsCache::SelectionPtr other_selection =
+        cache.get(co_list_, other);
+    EXPECT_NE(selection, other_selection);
+    EXPECT_EQ(2, cache.size());
+
+    // Another option list makes another selection.
+    CfgOptionList global_list;
+    global_list.push_back(global_);
+    RequestedOptionsCache::SelectionPtr global_selection =
+        cache.get(global_list, prl);
+    ASSERT_TRUE(global_selection);
+    EXPECT_NE(selection, global_selection);
+    ASSERT_FALSE(global_selection->options_.empty());
+    EXPECT_EQ(2, global_selection->options_[0]->getData()[0]);
+    EXPECT_EQ(3, cache.size());
+
+    cache.clear();
+    EXPECT_EQ(0, cache.size());
+}
+
+// Verifies that the entries are dropped when the configuration changes.
+TEST_F(RequestedOptionsCacheTest, cfgChanged) {
+    RequestedOptionsCache cache;
+    std::vector<uint8_t> prl = { DHO_ROUTERS };
+    RequestedOptionsCache::SelectionPtr selection = cache.get(co_list_, prl);
+    EXPECT_EQ(selection, cache.get(co_list_, prl));
+
+    CfgMgr::instance().getStagingCfg();
+    CfgMgr::instance().commit();
+    EXPECT_NE(selection, cache.get(co_list_, prl));
+    EXPECT_EQ(1, cache.size());
+}
+
+// Verifies that the number of entries is bounded.
+TEST_F(RequestedOptionsCacheTest, maxEntries) {
+    RequestedOptionsCache cache(2);
+    for (uint8_t code = 1; code <= 5; ++code) {
+        std::vector<uint8_t> prl = { code };
+        ASSERT_TRUE(cache.get(co_list_, prl));
+        EXPECT_GE(2, cache.size());
+    }
+}
+
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,6 +12,8 @@
 #include <stats/stats_mgr.h>
 #include <util/multi_threading_mgr.h>
 
+#include <boost/functional/hash.hpp>
+
 using namespace std;
 using namespace isc::util;
 using namespace isc::log;
@@ -32,44 +34,50 @@ ClientHandler::Client::Client(Pkt6Ptr query, DuidPtr client_id)
     duid_ = client_id->getDuid();
 }
 
-mutex ClientHandler::mutex_;
+const size_t ClientHandler::SHARDS;
+
+ClientHandler::Shard ClientHandler::shards_[SHARDS];
 
-ClientHandler::ClientContainer ClientHandler::clients_;
+ClientHandler::Shard&
+ClientHandler::getShard(const DuidPtr& duid) {
+    const vector<uint8_t>& bin = duid->getDuid();
+    return (shards_[boost::hash_range(bin.begin(), bin.end()) % SHARDS]);
+}
 
 ClientHandler::ClientPtr
-ClientHandler::lookup(const DuidPtr& duid) {
+ClientHandler::lookup(Shard& shard, const DuidPtr& duid) {
     // Sanity check.
     if (!duid) {
         isc_throw(InvalidParameter, "null duid in ClientHandler::lookup");
     }
 
-    auto it = clients_.find(duid->getDuid());
-    if (it == clients_.end()) {
+    auto it = shard.clients_.find(duid->getDuid());
+    if (it == shard.clients_.end()) {
         return (ClientPtr());
     }
     return (*it);
 }
 
 void
-ClientHandler::add(const ClientPtr& client) {
+ClientHandler::add(Shard& shard, const ClientPtr& client) {
     // Sanity check.
     if (!client) {
         isc_throw(InvalidParameter, "null client in ClientHandler::add");
     }
 
     // Assume insert will never fail so not checking its result.
-    clients_.insert(client);
+    shard.clients_.insert(client);
 }
 
 void
-ClientHandler::del(const DuidPtr& duid) {
+ClientHandler::del(Shard& shard, const DuidPtr& duid) {
     // Sanity check.
     if (!duid) {
         isc_throw(InvalidParameter, "null duid in ClientHandler::del");
     }
 
     // Assume erase will never fail so not checking its result.
-    clients_.erase(duid->getDuid());
+    shard.clients_.erase(duid->getDuid());
 }
 
 ClientHandler::ClientHandler() : client_(), locked_() {
@@ -77,8 +85,9 @@ ClientHandler::ClientHandler() : client_(), locked_() {
 
 ClientHandler::~ClientHandler() {
     if (locked_) {
-        lock_guard<mutex> lk(mutex_);
-        unLock();
+        Shard& shard = getShard(locked_);
+        lock_guard<mutex> lk(shard.mutex_);
+        unLock(shard);
     }
 }
 
@@ -108,11 +117,14 @@ ClientHandler::tryLock(Pkt6Ptr query, ContinuationPtr cont) {
 
     {
         // Try to acquire the lock and return the holder when it failed.
-        lock_guard<mutex> lk(mutex_);
-        holder = lookup(duid);
+        // The client is identified by its DUID only so a single shard
+        // is locked.
+        Shard& shard = getShard(duid);
+        lock_guard<mutex> lk(shard.mutex_);
+        holder = lookup(shard, duid);
         if (!holder) {
             locked_ = duid;
-            lock();
+            lock(shard);
             return (true);
         }
         // This query can be a duplicate so put the continuation.
@@ -150,23 +162,23 @@ ClientHandler::tryLock(Pkt6Ptr query, ContinuationPtr cont) {
 }
 
 void
-ClientHandler::lock() {
+ClientHandler::lock(Shard& shard) {
     // Sanity check.
     if (!locked_) {
         isc_throw(Unexpected, "nothing to lock in ClientHandler::lock");
     }
 
-    add(client_);
+    add(shard, client_);
 }
 
 void
-ClientHandler::unLock() {
+ClientHandler::unLock(Shard& shard) {
     // Sanity check.
     if (!locked_) {
         isc_throw(Unexpected, "nothing to unlock in ClientHandler::unLock");
     }
 
-    del(locked_);
+    del(shard, locked_);
     locked_.reset();
 
     if (!client_ || !client_->cont_) {
@@ -174,7 +186,7 @@ ClientHandler::unLock() {
     }
 
     // Try to process next query. As the caller holds the mutex of
-    // the handler class the continuation will be resumed after.
+    // the shard the continuation will be resumed after.
     MultiThreadingMgr& mt_mgr = MultiThreadingMgr::instance();
     if (mt_mgr.getMode()) {
         if (!mt_mgr.getThreadPool().addFront(client_->cont_)) {
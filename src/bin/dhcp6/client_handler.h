@@ -1,4 +1,4 @@
-// Copyright (C) 2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -61,13 +61,13 @@ private:
         /// @brief The next query.
         ///
         /// @note This field can be modified from another handler
-        /// holding the mutex.
+        /// holding the mutex of the shard of the client.
         Pkt6Ptr next_query_;
 
         /// @brief The continuation to process next query for the client.
         ///
         /// @note This field can be modified from another handler
-        /// holding the mutex.
+        /// holding the mutex of the shard of the client.
         ContinuationPtr cont_;
     };
 
@@ -94,35 +94,55 @@ private:
         >
     > ClientContainer;
 
+    /// @brief Number of shards of the client container.
+    ///
+    /// The clients are spread over the shards by a hash of their DUID
+    /// so the threads processing different clients do not wait for each
+    /// other.
+    static const size_t SHARDS = 64;
+
+    /// @brief A shard of the client container.
+    struct Shard {
+        /// @brief Mutex to protect the client container of the shard.
+        std::mutex mutex_;
+
+        /// @brief The client container.
+        ClientContainer clients_;
+    };
+
+    /// @brief Get the shard of a DUID.
+    ///
+    /// @param duid The client DUID.
+    /// @return The shard holding the DUID.
+    static Shard& getShard(const DuidPtr& duid);
+
     /// @brief Lookup a client.
     ///
-    /// The mutex must be held by the caller.
+    /// The mutex of the shard must be held by the caller.
     ///
+    /// @param shard The shard of the duid.
     /// @param duid The duid of the query from the client.
     /// @return The client found in the container or null.
-    static ClientPtr lookup(const DuidPtr& duid);
+    static ClientPtr lookup(Shard& shard, const DuidPtr& duid);
 
     /// @brief Add a client.
     ///
-    /// The mutex must be held by the caller.
+    /// The mutex of the shard must be held by the caller.
     ///
+    /// @param shard The shard of the client DUID.
     /// @param client The client to insert into the client container.
-    static void add(const ClientPtr& client);
+    static void add(Shard& shard, const ClientPtr& client);
 
     /// @brief Delete a client.
     ///
-    /// The mutex must be held by the caller.
+    /// The mutex of the shard must be held by the caller.
     ///
+    /// @param shard The shard of the duid.
     /// @param duid The duid to delete from the client container.
-    static void del(const DuidPtr& duid);
+    static void del(Shard& shard, const DuidPtr& duid);
 
-    /// @brief Mutex to protect the client container.
-    ///
-    /// The mutex is used only by public methods for guards.
-    static std::mutex mutex_;
-
-    /// @brief The client container.
-    static ClientContainer clients_;
+    /// @brief The shards of the client container.
+    static Shard shards_[SHARDS];
 
 public:
 
@@ -155,16 +175,21 @@ private:
 
     /// @brief Acquire a client.
     ///
-    /// The mutex must be held by the caller.
-    void lock();
+    /// The mutex of the shard must be held by the caller.
+    ///
+    /// @param shard The shard of the client DUID.
+    void lock(Shard& shard);
 
     /// @brief Release a client.
     ///
     /// If the client has a continuation, push it at front of the thread
     /// packet queue.
     ///
-    /// The mutex must be held by the only caller: the destructor.
-    void unLock();
+    /// The mutex of the shard must be held by the only caller: the
+    /// destructor.
+    ///
+    /// @param shard The shard of the client DUID.
+    void unLock(Shard& shard);
 
     /// @brief Local client.
     ClientPtr client_;
@@ -9,6 +9,7 @@
 #include <cc/command_interpreter.h>
 #include <cc/data.h>
 #include <config/command_mgr.h>
+#include <dhcp/iface_mgr.h>
 #include <dhcp/libdhcp++.h>
 #include <dhcp6/ctrl_dhcp6_srv.h>
 #include <dhcp6/dhcp6_log.h>
@@ -18,6 +19,7 @@
 #include <dhcpsrv/cfg_db_access.h>
 #include <dhcpsrv/cfg_multi_threading.h>
 #include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/config_backend_dhcp6_mgr.h>
 #include <dhcpsrv/db_type.h>
 #include <dhcpsrv/host_mgr.h>
 #include <dhcpsrv/lease_mgr_factory.h>
@@ -61,6 +63,10 @@ struct CtrlDhcp6Hooks {
 // module is called.
 CtrlDhcp6Hooks Hooks;
 
+/// @brief Number of threads processing the read-only commands in
+/// multi-threading mode.
+const uint32_t COMMAND_EXECUTOR_THREAD_COUNT = 2;
+
 // Name of the file holding server identifier.
 static const char* SERVER_DUID_FILE = "kea-dhcp6-serverid";
 
@@ -694,8 +700,8 @@ ControlledDhcpv6Srv::commandConfigBackendPullHandler(const std::string&,
         return (createAnswer(CONTROL_RESULT_EMPTY, "No config backend."));
     }
 
-    // stop thread pool (if running)
-    MultiThreadingCriticalSection cs;
+    // The thread pool is stopped only while the fetched updates are
+    // applied to the current configuration.
 
     // Reschedule the periodic CB fetch.
     if (TimerMgr::instance()->isTimerRegistered("Dhcp6CBFetchTimer")) {
@@ -978,6 +984,9 @@ ControlledDhcpv6Srv::processConfig(isc::data::ConstElementPtr config) {
     try {
         data::ConstElementPtr qc;
         qc = CfgMgr::instance().getStagingCfg()->getDHCPQueueControl();
+        IfaceMgr::instance().setReceiverCpuAffinity(
+            CfgMultiThreading::extractCpuAffinity(CfgMgr::instance().getStagingCfg()->getDHCPMultiThreading(),
+                                                  "receiver-cpu-affinity"));
         if (IfaceMgr::instance().configureDHCPPacketQueue(AF_INET6, qc)) {
             LOG_INFO(dhcp6_logger, DHCP6_CONFIG_PACKET_QUEUE)
                      .arg(IfaceMgr::instance().getPacketQueue6()->getInfoStr());
@@ -1018,6 +1027,9 @@ ControlledDhcpv6Srv::processConfig(isc::data::ConstElementPtr config) {
         return (isc::config::createAnswer(CONTROL_RESULT_ERROR, err.str()));
     }
 
+    // The change notification sockets belong to the previous backends.
+    server_->cbUnwatchNotifications();
+
     // Setup config backend polling, if configured for it.
     auto ctl_info = CfgMgr::instance().getStagingCfg()->getConfigControlInfo();
     if (ctl_info) {
@@ -1043,6 +1055,11 @@ ControlledDhcpv6Srv::processConfig(isc::data::ConstElementPtr config) {
                               fetch_time,
                               asiolink::IntervalTimer::ONE_SHOT);
             TimerMgr::instance()->setup("Dhcp6CBFetchTimer");
+
+            // Fetch the updates as soon as they are notified by the
+            // backends supporting it.
+            server_->cbWatchNotifications(CfgMgr::instance().getStagingCfg(),
+                                          failure_count);
         }
     }
 
@@ -1057,14 +1074,29 @@ ControlledDhcpv6Srv::processConfig(isc::data::ConstElementPtr config) {
 
     // Initialize the allocators. If the user selected a Free Lease Queue Allocator
     // for any of the subnets, the server will now populate free leases to the queue.
-    // It may take a while!
+    // It may take a while! The unchanged subnets keep their allocation states
+    // from the current configuration, the ones using a Free Lease Queue
+    // Allocator only when the lease database did not change.
     try {
-        CfgMgr::instance().getStagingCfg()->getCfgSubnets6()->initAllocatorsAfterConfigure();
+        auto const& current_cfg = CfgMgr::instance().getCurrentCfg();
+        auto const& staging_cfg = CfgMgr::instance().getStagingCfg();
+        staging_cfg->getCfgSubnets6()->
+            initAllocatorsAfterConfigure(current_cfg->getCfgSubnets6(),
+                                         staging_cfg->sameLeaseDatabase(*current_cfg));
 
     } catch (const std::exception& ex) {
         err << "Error initializing the lease allocators: " << ex.what();
     }
 
+    // The sender is not thread safe when the multi-threading mode is
+    // disabled: stop its thread before applying the new settings.
+    try {
+        CfgMgr::instance().getD2ClientMgr().stopSenderThread();
+    } catch (const std::exception& ex) {
+        err << "Error stopping the DHCP-DDNS sender thread: " << ex.what();
+        return (isc::config::createAnswer(CONTROL_RESULT_ERROR, err.str()));
+    }
+
     // Apply multi threading settings.
     // @note These settings are applied/updated only if no errors occur while
     // applying the new configuration.
@@ -1077,6 +1109,26 @@ ControlledDhcpv6Srv::processConfig(isc::data::ConstElementPtr config) {
         return (isc::config::createAnswer(CONTROL_RESULT_ERROR, err.str()));
     }
 
+    // Process the read-only commands in their own threads so they don't
+    // stall the packet processing.
+    if (MultiThreadingMgr::instance().getMode()) {
+        try {
+            CommandMgr::instance().startCommandExecutor(COMMAND_EXECUTOR_THREAD_COUNT);
+        } catch (const std::exception& ex) {
+            err << "Error starting the command executor: " << ex.what();
+            return (isc::config::createAnswer(CONTROL_RESULT_ERROR, err.str()));
+        }
+
+        // Process the DHCP-DDNS sender IO in its own thread so the sends
+        // complete without waiting for the main loop.
+        try {
+            CfgMgr::instance().getD2ClientMgr().startSenderThread();
+        } catch (const std::exception& ex) {
+            err << "Error starting the DHCP-DDNS sender thread: " << ex.what();
+            return (isc::config::createAnswer(CONTROL_RESULT_ERROR, err.str()));
+        }
+    }
+
     return (answer);
 }
 
@@ -1156,6 +1208,15 @@ ControlledDhcpv6Srv::ControlledDhcpv6Srv(uint16_t server_port /*= DHCP6_SERVER_P
     CommandMgr::instance().registerCommand("build-report",
         std::bind(&ControlledDhcpv6Srv::commandBuildReportHandler, this, ph::_1, ph::_2));
 
+    CommandMgr::instance().registerCommand("callout-timing-get",
+        std::bind(&HooksManager::calloutTimingGetHandler, ph::_1, ph::_2));
+
+    CommandMgr::instance().registerCommand("callout-timing-reset",
+        std::bind(&HooksManager::calloutTimingResetHandler, ph::_1, ph::_2));
+
+    CommandMgr::instance().registerCommand("callout-timing-set",
+        std::bind(&HooksManager::calloutTimingSetHandler, ph::_1, ph::_2));
+
     CommandMgr::instance().registerCommand("config-backend-pull",
         std::bind(&ControlledDhcpv6Srv::commandConfigBackendPullHandler, this, ph::_1, ph::_2));
 
@@ -1211,6 +1272,9 @@ ControlledDhcpv6Srv::ControlledDhcpv6Srv(uint16_t server_port /*= DHCP6_SERVER_P
     CommandMgr::instance().registerCommand("statistic-get-all",
         std::bind(&StatsMgr::statisticGetAllHandler, ph::_1, ph::_2));
 
+    CommandMgr::instance().registerCommand("statistic-latency-get",
+        std::bind(&StatsMgr::statisticLatencyGetHandler, ph::_1, ph::_2));
+
     CommandMgr::instance().registerCommand("statistic-reset-all",
         std::bind(&StatsMgr::statisticResetAllHandler, ph::_1, ph::_2));
 
@@ -1228,6 +1292,27 @@ ControlledDhcpv6Srv::ControlledDhcpv6Srv(uint16_t server_port /*= DHCP6_SERVER_P
 
     CommandMgr::instance().registerCommand("statistic-sample-count-set-all",
         std::bind(&ControlledDhcpv6Srv::commandStatisticSetMaxSampleCountAllHandler, this, ph::_1, ph::_2));
+
+    // Declare the commands which can be processed beside the packets in
+    // multi-threading mode, including the read-only commands of the hooks
+    // libraries.
+    const char* read_only_commands[] = {
+        "build-report",
+        "config-get",
+        "server-tag-get",
+        "statistic-get",
+        "statistic-get-all",
+        "version-get",
+        "lease6-get",
+        "lease6-get-all",
+        "lease6-get-by-duid",
+        "lease6-get-by-hostname",
+        "lease6-get-page",
+        "stat-lease6-get"
+    };
+    for (auto cmd : read_only_commands) {
+        CommandMgr::instance().addReadOnlyCommand(cmd);
+    }
 }
 
 void ControlledDhcpv6Srv::shutdownServer(int exit_value) {
@@ -1238,6 +1323,8 @@ void ControlledDhcpv6Srv::shutdownServer(int exit_value) {
 
 ControlledDhcpv6Srv::~ControlledDhcpv6Srv() {
     try {
+        CommandMgr::instance().stopCommandExecutor();
+        CfgMgr::instance().getD2ClientMgr().stopSenderThread();
         MultiThreadingMgr::instance().apply(false, 0, 0);
         LeaseMgrFactory::destroy();
         HostMgr::create();
@@ -1251,11 +1338,16 @@ ControlledDhcpv6Srv::~ControlledDhcpv6Srv() {
 
         timer_mgr_->unregisterTimers();
 
+        cbUnwatchNotifications();
+
         // Close the command socket (if it exists).
         CommandMgr::instance().closeCommandSocket();
 
         // Deregister any registered commands (please keep in alphabetic order)
         CommandMgr::instance().deregisterCommand("build-report");
+        CommandMgr::instance().deregisterCommand("callout-timing-get");
+        CommandMgr::instance().deregisterCommand("callout-timing-reset");
+        CommandMgr::instance().deregisterCommand("callout-timing-set");
         CommandMgr::instance().deregisterCommand("config-backend-pull");
         CommandMgr::instance().deregisterCommand("config-get");
         CommandMgr::instance().deregisterCommand("config-reload");
@@ -1270,6 +1362,7 @@ ControlledDhcpv6Srv::~ControlledDhcpv6Srv() {
         CommandMgr::instance().deregisterCommand("shutdown");
         CommandMgr::instance().deregisterCommand("statistic-get");
         CommandMgr::instance().deregisterCommand("statistic-get-all");
+        CommandMgr::instance().deregisterCommand("statistic-latency-get");
         CommandMgr::instance().deregisterCommand("statistic-remove");
         CommandMgr::instance().deregisterCommand("statistic-remove-all");
         CommandMgr::instance().deregisterCommand("statistic-reset");
@@ -1409,9 +1502,9 @@ ControlledDhcpv6Srv::openSocketsFailedCallback(ReconnectCtlPtr reconnect_ctl) {
 void
 ControlledDhcpv6Srv::cbFetchUpdates(const SrvConfigPtr& srv_cfg,
                                     boost::shared_ptr<unsigned> failure_count) {
-    // stop thread pool (if running)
-    MultiThreadingCriticalSection cs;
-
+    // The thread pool is stopped only while the fetched updates are
+    // applied to the current configuration, so it keeps running when
+    // there are no updates.
     try {
         // Fetch any configuration backend updates since our last fetch.
         server_->getCBControl()->databaseConfigFetch(srv_cfg,
@@ -1432,6 +1525,9 @@ ControlledDhcpv6Srv::cbFetchUpdates(const SrvConfigPtr& srv_cfg,
         }
     }
 
+    // Reopened listening connections have new sockets.
+    cbWatchNotifications(srv_cfg, failure_count);
+
     // Reschedule the timer to fetch new updates or re-try if
     // the previous attempt resulted in an error.
     if (TimerMgr::instance()->isTimerRegistered("Dhcp6CBFetchTimer")) {
@@ -1439,5 +1535,47 @@ ControlledDhcpv6Srv::cbFetchUpdates(const SrvConfigPtr& srv_cfg,
     }
 }
 
+void
+ControlledDhcpv6Srv::cbWatchNotifications(const SrvConfigPtr& srv_cfg,
+                                          boost::shared_ptr<unsigned> failure_count) {
+    std::vector<int> sockets =
+        ConfigBackendDHCPv6Mgr::instance().getPool()->getChangeNotificationSockets();
+    if (sockets == cb_notification_sockets_) {
+        return;
+    }
+
+    cbUnwatchNotifications();
+    for (auto socket : sockets) {
+        IfaceMgr::instance().addExternalSocket(socket,
+            std::bind(&ControlledDhcpv6Srv::cbNotified, this, srv_cfg,
+                      failure_count));
+    }
+    cb_notification_sockets_ = sockets;
+}
+
+void
+ControlledDhcpv6Srv::cbUnwatchNotifications() {
+    for (auto socket : cb_notification_sockets_) {
+        IfaceMgr::instance().deleteExternalSocket(socket);
+    }
+    cb_notification_sockets_.clear();
+}
+
+void
+ControlledDhcpv6Srv::cbNotified(const SrvConfigPtr& srv_cfg,
+                                boost::shared_ptr<unsigned> failure_count) {
+    if (!ConfigBackendDHCPv6Mgr::instance().getPool()->consumeChangeNotifications()) {
+        return;
+    }
+
+    LOG_DEBUG(dhcp6_logger, DBG_DHCP6_BASIC, DHCP6_CB_CHANGE_NOTIFIED);
+
+    // The periodic fetch is rescheduled after this one.
+    if (TimerMgr::instance()->isTimerRegistered("Dhcp6CBFetchTimer")) {
+        TimerMgr::instance()->cancel("Dhcp6CBFetchTimer");
+    }
+    cbFetchUpdates(srv_cfg, failure_count);
+}
+
 }  // namespace dhcp
 }  // namespace isc
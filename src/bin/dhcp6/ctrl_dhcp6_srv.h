@@ -15,6 +15,8 @@
 #include <dhcpsrv/timer_mgr.h>
 #include <dhcp6/dhcp6_srv.h>
 
+#include <vector>
+
 namespace isc {
 namespace dhcp {
 
@@ -471,6 +473,36 @@ private:
     void cbFetchUpdates(const SrvConfigPtr& srv_cfg,
                         boost::shared_ptr<unsigned> failure_count);
 
+    /// @brief Watches the change notification sockets of the Config Backends.
+    ///
+    /// The sockets of the backends pushing configuration change
+    /// notifications are registered in the @c IfaceMgr so the updates are
+    /// fetched as soon as they are notified rather than at the next poll.
+    /// The registration is updated when the sockets have changed, e.g.
+    /// when a backend has reopened its listening connection.
+    ///
+    /// @param srv_cfg Server configuration holding the database credentials
+    /// and server tag.
+    /// @param failure_count pointer to the failure counter shared with
+    /// the periodic fetch.
+    void cbWatchNotifications(const SrvConfigPtr& srv_cfg,
+                              boost::shared_ptr<unsigned> failure_count);
+
+    /// @brief Stops watching the change notification sockets.
+    void cbUnwatchNotifications();
+
+    /// @brief Callback invoked when a change notification socket is readable.
+    ///
+    /// Consumes the notifications and fetches the configuration updates
+    /// when a change was notified.
+    ///
+    /// @param srv_cfg Server configuration holding the database credentials
+    /// and server tag.
+    /// @param failure_count pointer to the failure counter shared with
+    /// the periodic fetch.
+    void cbNotified(const SrvConfigPtr& srv_cfg,
+                    boost::shared_ptr<unsigned> failure_count);
+
     /// @brief Static pointer to the sole instance of the DHCP server.
     ///
     /// This is required for config and command handlers to gain access to
@@ -482,6 +514,9 @@ private:
     /// Shared pointer to the instance of timer @c TimerMgr is held here to
     /// make sure that the @c TimerMgr outlives instance of this class.
     TimerMgrPtr timer_mgr_;
+
+    /// @brief Watched change notification sockets of the Config Backends.
+    std::vector<int> cb_notification_sockets_;
 };
 
 }  // namespace dhcp
@@ -359,6 +359,16 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     return isc::dhcp::Dhcp6Parser::make_STRING(tmp, driver.loc_);
 }
 
+(?i:\"BINARY\") {
+    /* dhcp-ddns value keywords are case insensitive */
+    if (driver.ctx_ == isc::dhcp::Parser6Context::NCR_FORMAT) {
+        return isc::dhcp::Dhcp6Parser::make_BINARY(driver.loc_);
+    }
+    std::string tmp(yytext+1);
+    tmp.resize(tmp.size() - 1);
+    return isc::dhcp::Dhcp6Parser::make_STRING(tmp, driver.loc_);
+}
+
 (?i:\"when-present\") {
     /* dhcp-ddns value keywords are case insensitive */
     if (driver.ctx_ == isc::dhcp::Parser6Context::REPLACE_CLIENT_NAME) {
@@ -500,6 +510,33 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     }
 }
 
+\"event-handler-type\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::INTERFACES_CONFIG:
+        return isc::dhcp::Dhcp6Parser::make_EVENT_HANDLER_TYPE(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("event-handler-type", driver.loc_);
+    }
+}
+
+\"select\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::EVENT_HANDLER_TYPE:
+        return isc::dhcp::Dhcp6Parser::make_SELECT(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("select", driver.loc_);
+    }
+}
+
+\"epoll\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::EVENT_HANDLER_TYPE:
+        return isc::dhcp::Dhcp6Parser::make_EPOLL(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("epoll", driver.loc_);
+    }
+}
+
 \"sanity-checks\" {
     switch(driver.ctx_) {
     case isc::dhcp::Parser6Context::DHCP6:
@@ -630,6 +667,15 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     }
 }
 
+\"lmdb\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::DATABASE_TYPE:
+        return isc::dhcp::Dhcp6Parser::make_LMDB(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("lmdb", driver.loc_);
+    }
+}
+
 \"user\" {
     switch(driver.ctx_) {
     case isc::dhcp::Parser6Context::LEASE_DATABASE:
@@ -854,6 +900,244 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     }
 }
 
+\"lfc-max-leases\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_LFC_MAX_LEASES(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("lfc-max-leases", driver.loc_);
+    }
+}
+
+\"lfc-mode\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_LFC_MODE(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("lfc-mode", driver.loc_);
+    }
+}
+
+\"kea-lfc\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::DATABASE_LFC_MODE:
+        return isc::dhcp::Dhcp6Parser::make_KEA_LFC(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("kea-lfc", driver.loc_);
+    }
+}
+
+\"in-process\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::DATABASE_LFC_MODE:
+        return isc::dhcp::Dhcp6Parser::make_IN_PROCESS(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("in-process", driver.loc_);
+    }
+}
+
+\"load-threads\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_LOAD_THREADS(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("load-threads", driver.loc_);
+    }
+}
+
+\"lease-file-format\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_LEASE_FILE_FORMAT(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("lease-file-format", driver.loc_);
+    }
+}
+
+\"csv\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::DATABASE_LEASE_FILE_FORMAT:
+        return isc::dhcp::Dhcp6Parser::make_CSV(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("csv", driver.loc_);
+    }
+}
+
+\"binary\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::DATABASE_LEASE_FILE_FORMAT:
+    case isc::dhcp::Parser6Context::NCR_FORMAT:
+        return isc::dhcp::Dhcp6Parser::make_BINARY(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("binary", driver.loc_);
+    }
+}
+
+\"fsync-records\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_FSYNC_RECORDS(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("fsync-records", driver.loc_);
+    }
+}
+
+\"write-behind\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_WRITE_BEHIND(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("write-behind", driver.loc_);
+    }
+}
+
+\"write-behind-queue-size\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_WRITE_BEHIND_QUEUE_SIZE(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("write-behind-queue-size", driver.loc_);
+    }
+}
+
+\"pipeline\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_PIPELINE(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("pipeline", driver.loc_);
+    }
+}
+
+\"async-threads\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_ASYNC_THREADS(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("async-threads", driver.loc_);
+    }
+}
+
+\"pool-size\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_POOL_SIZE(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("pool-size", driver.loc_);
+    }
+}
+
+\"writer-threads\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_WRITER_THREADS(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("writer-threads", driver.loc_);
+    }
+}
+
+\"in-memory-limits\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_IN_MEMORY_LIMITS(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("in-memory-limits", driver.loc_);
+    }
+}
+
+\"in-memory-stats\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_IN_MEMORY_STATS(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("in-memory-stats", driver.loc_);
+    }
+}
+
+\"map-size\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_MAP_SIZE(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("map-size", driver.loc_);
+    }
+}
+
+\"replica-host\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+    case isc::dhcp::Parser6Context::HOSTS_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_REPLICA_HOST(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("replica-host", driver.loc_);
+    }
+}
+
+\"replica-port\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+    case isc::dhcp::Parser6Context::HOSTS_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_REPLICA_PORT(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("replica-port", driver.loc_);
+    }
+}
+
+\"replica-max-lag\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+    case isc::dhcp::Parser6Context::HOSTS_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_REPLICA_MAX_LAG(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("replica-max-lag", driver.loc_);
+    }
+}
+
+\"cache-size\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::HOSTS_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_CACHE_SIZE(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("cache-size", driver.loc_);
+    }
+}
+
+\"cache-ttl\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::HOSTS_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_CACHE_TTL(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("cache-ttl", driver.loc_);
+    }
+}
+
+\"cache-negative\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::HOSTS_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_CACHE_NEGATIVE(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("cache-negative", driver.loc_);
+    }
+}
+
+\"global-hosts-in-memory\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::HOSTS_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_GLOBAL_HOSTS_IN_MEMORY(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("global-hosts-in-memory", driver.loc_);
+    }
+}
+
+\"global-hosts-refresh\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::HOSTS_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_GLOBAL_HOSTS_REFRESH(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("global-hosts-refresh", driver.loc_);
+    }
+}
+
 \"preferred-lifetime\" {
     switch(driver.ctx_) {
     case isc::dhcp::Parser6Context::DHCP6:
@@ -2044,6 +2328,24 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     }
 }
 
+\"cpu-affinity\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::DHCP_MULTI_THREADING:
+        return isc::dhcp::Dhcp6Parser::make_CPU_AFFINITY(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("cpu-affinity", driver.loc_);
+    }
+}
+
+\"receiver-cpu-affinity\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::DHCP_MULTI_THREADING:
+        return isc::dhcp::Dhcp6Parser::make_RECEIVER_CPU_AFFINITY(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("receiver-cpu-affinity", driver.loc_);
+    }
+}
+
 \"control-socket\" {
     switch(driver.ctx_) {
     case isc::dhcp::Parser6Context::DHCP6:
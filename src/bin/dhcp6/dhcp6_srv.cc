@@ -37,6 +37,7 @@
 #include <dhcpsrv/lease_mgr.h>
 #include <dhcpsrv/lease_mgr_factory.h>
 #include <dhcpsrv/ncr_generator.h>
+#include <dhcpsrv/pkt_latency_stats.h>
 #include <dhcpsrv/subnet.h>
 #include <dhcpsrv/subnet_selector.h>
 #include <dhcpsrv/utils.h>
@@ -51,6 +52,7 @@
 #include <util/io_utilities.h>
 #include <util/pointer_util.h>
 #include <util/range_utilities.h>
+#include <util/recycling_allocator.h>
 #include <log/logger.h>
 #include <cryptolink/cryptolink.h>
 #include <process/cfgrpt/config_report.h>
@@ -61,6 +63,9 @@
 #ifdef HAVE_PGSQL
 #include <dhcpsrv/pgsql_lease_mgr.h>
 #endif
+#ifdef HAVE_LMDB
+#include <dhcpsrv/lmdb_lease_mgr.h>
+#endif
 #include <dhcpsrv/memfile_lease_mgr.h>
 
 #include <boost/foreach.hpp>
@@ -127,6 +132,58 @@ struct Dhcp6Hooks {
 // module is called.
 Dhcp6Hooks Hooks;
 
+/// Structure that holds the counters of the packet statistics, which
+/// are incremented for each packet without locking the statistics manager
+struct Dhcp6Counters {
+    StatCounterPtr received_;                 ///< "pkt6-received" counter
+    StatCounterPtr solicit_received_;         ///< "pkt6-solicit-received" counter
+    StatCounterPtr advertise_received_;       ///< "pkt6-advertise-received" counter
+    StatCounterPtr request_received_;         ///< "pkt6-request-received" counter
+    StatCounterPtr confirm_received_;         ///< "pkt6-confirm-received" counter
+    StatCounterPtr renew_received_;           ///< "pkt6-renew-received" counter
+    StatCounterPtr rebind_received_;          ///< "pkt6-rebind-received" counter
+    StatCounterPtr reply_received_;           ///< "pkt6-reply-received" counter
+    StatCounterPtr release_received_;         ///< "pkt6-release-received" counter
+    StatCounterPtr decline_received_;         ///< "pkt6-decline-received" counter
+    StatCounterPtr reconfigure_received_;     ///< "pkt6-reconfigure-received" counter
+    StatCounterPtr infrequest_received_;      ///< "pkt6-infrequest-received" counter
+    StatCounterPtr dhcpv4_query_received_;    ///< "pkt6-dhcpv4-query-received" counter
+    StatCounterPtr dhcpv4_response_received_; ///< "pkt6-dhcpv4-response-received" counter
+    StatCounterPtr unknown_received_;         ///< "pkt6-unknown-received" counter
+    StatCounterPtr sent_;                     ///< "pkt6-sent" counter
+    StatCounterPtr advertise_sent_;           ///< "pkt6-advertise-sent" counter
+    StatCounterPtr reply_sent_;               ///< "pkt6-reply-sent" counter
+    StatCounterPtr dhcpv4_response_sent_;     ///< "pkt6-dhcpv4-response-sent" counter
+    PktLatencyStats latency_;                 ///< "pkt6-*-latency" histograms
+
+    /// Constructor that registers the counters for DHCPv6 engine
+    Dhcp6Counters() : latency_("pkt6") {
+        StatsMgr& stats_mgr = StatsMgr::instance();
+        received_                 = stats_mgr.registerCounter("pkt6-received");
+        solicit_received_         = stats_mgr.registerCounter("pkt6-solicit-received");
+        advertise_received_       = stats_mgr.registerCounter("pkt6-advertise-received");
+        request_received_         = stats_mgr.registerCounter("pkt6-request-received");
+        confirm_received_         = stats_mgr.registerCounter("pkt6-confirm-received");
+        renew_received_           = stats_mgr.registerCounter("pkt6-renew-received");
+        rebind_received_          = stats_mgr.registerCounter("pkt6-rebind-received");
+        reply_received_           = stats_mgr.registerCounter("pkt6-reply-received");
+        release_received_         = stats_mgr.registerCounter("pkt6-release-received");
+        decline_received_         = stats_mgr.registerCounter("pkt6-decline-received");
+        reconfigure_received_     = stats_mgr.registerCounter("pkt6-reconfigure-received");
+        infrequest_received_      = stats_mgr.registerCounter("pkt6-infrequest-received");
+        dhcpv4_query_received_    = stats_mgr.registerCounter("pkt6-dhcpv4-query-received");
+        dhcpv4_response_received_ = stats_mgr.registerCounter("pkt6-dhcpv4-response-received");
+        unknown_received_         = stats_mgr.registerCounter("pkt6-unknown-received");
+        sent_                     = stats_mgr.registerCounter("pkt6-sent");
+        advertise_sent_           = stats_mgr.registerCounter("pkt6-advertise-sent");
+        reply_sent_               = stats_mgr.registerCounter("pkt6-reply-sent");
+        dhcpv4_response_sent_     = stats_mgr.registerCounter("pkt6-dhcpv4-response-sent");
+    }
+};
+
+// Declare the packet statistics counters.
+Dhcp6Counters Counters;
+
 /// @brief Creates instance of the Status Code option.
 ///
 /// This variant of the function is used when the Status Code option
@@ -216,7 +273,8 @@ Dhcpv6Srv::Dhcpv6Srv(uint16_t server_port, uint16_t client_port)
       client_port_(client_port), serverid_(), shutdown_(true),
       alloc_engine_(), name_change_reqs_(),
       network_state_(new NetworkState(NetworkState::DHCPv6)),
-      cb_control_(new CBControlDHCPv6()) {
+      cb_control_(new CBControlDHCPv6()),
+      durable_parking_lot_(new ParkingLot()) {
     LOG_DEBUG(dhcp6_logger, DBG_DHCP6_START, DHCP6_OPEN_SOCKET)
         .arg(server_port);
 
@@ -410,7 +468,7 @@ Dhcpv6Srv::setHostIdentifiers(AllocEngine::ClientContext6& ctx) {
                     LOG_DEBUG(packet6_logger, DBGLVL_TRACE_BASIC, DHCP6_FLEX_ID)
                         .arg(Host::getIdentifierAsText(type, &id[0], id.size()));
 
-                    ctx.addHostIdentifier(type, id);
+                    ctx.addHostIdentifier(type, std::move(id));
                 }
             }
             break;
@@ -643,6 +701,7 @@ void Dhcpv6Srv::run_one() {
         // point are: the interface, source address and destination addresses
         // and ports.
         if (query) {
+            query->setEventTime(Pkt::EVENT_RECEIVED);
             LOG_DEBUG(packet6_logger, DBG_DHCP6_BASIC, DHCP6_BUFFER_RECEIVED)
                 .arg(query->getRemoteAddr().toText())
                 .arg(query->getRemotePort())
@@ -654,7 +713,7 @@ void Dhcpv6Srv::run_one() {
             // any failures in unpacking will cause the packet to be dropped.
             // we will increase type specific packets further down the road.
             // See processStatsReceived().
-            StatsMgr::instance().addValue("pkt6-received", static_cast<int64_t>(1));
+            Counters.received_->add();
         }
 
         // We used to log that the wait was interrupted, but this is no longer
@@ -726,6 +785,8 @@ Dhcpv6Srv::processPacketAndSendResponse(Pkt6Ptr& query) {
 
 void
 Dhcpv6Srv::processPacket(Pkt6Ptr& query, Pkt6Ptr& rsp) {
+    query->setEventTime(Pkt::EVENT_DEQUEUED);
+
     // All packets belong to ALL.
     query->addClass("ALL");
 
@@ -1004,6 +1065,11 @@ Dhcpv6Srv::processDhcp6Query(Pkt6Ptr& query, Pkt6Ptr& rsp) {
             return;
         }
 
+        // Pass the event times to the response for the latency statistics.
+        if (rsp) {
+            rsp->copyEventTimes(*query);
+        }
+
     } catch (const std::exception& e) {
 
         // Catch-all exception (at least for ones based on the isc Exception
@@ -1207,12 +1273,64 @@ Dhcpv6Srv::processDhcp6Query(Pkt6Ptr& query, Pkt6Ptr& rsp) {
         }
     }
 
+    // Hold the response until the lease changes are on the disk.
+    if (rsp && parkUntilLeasesDurable(callout_handle, query, rsp)) {
+        rsp.reset();
+    }
+
     // If we have a response prep it for shipment.
     if (rsp) {
         processPacketPktSend(callout_handle, query, rsp);
     }
 }
 
+bool
+Dhcpv6Srv::parkUntilLeasesDurable(hooks::CalloutHandlePtr& callout_handle,
+                                  Pkt6Ptr& query, Pkt6Ptr& rsp) {
+    if (!MultiThreadingMgr::instance().getMode() ||
+        !LeaseMgrFactory::haveInstance()) {
+        return (false);
+    }
+
+    ParkingLotPtr parking_lot = durable_parking_lot_;
+    parking_lot->park(query, [this, callout_handle, query, rsp]() mutable {
+        typedef function<void()> CallBack;
+        boost::shared_ptr<CallBack> call_back =
+            boost::make_shared<CallBack>(std::bind(&Dhcpv6Srv::sendResponseNoThrow,
+                                                   this, callout_handle, query, rsp));
+        MultiThreadingMgr::instance().getThreadPool().add(call_back);
+    });
+
+    bool parked = false;
+    try {
+        parked = LeaseMgrFactory::instance().whenLeasesDurable(
+            [parking_lot, query](bool durable) {
+                if (durable) {
+                    parking_lot->unpark(query);
+                    return;
+                }
+                parking_lot->drop(query);
+                LOG_ERROR(packet6_logger, DHCP6_PACKET_DROP_LEASE_WRITE_FAILED)
+                    .arg(query->getLabel());
+                isc::stats::StatsMgr::instance().addValue("pkt6-receive-drop",
+                                                          static_cast<int64_t>(1));
+            });
+    } catch (...) {
+        parking_lot->drop(query);
+        throw;
+    }
+
+    if (!parked) {
+        // The changes are already durable: send the response now.
+        parking_lot->drop(query);
+        return (false);
+    }
+
+    LOG_DEBUG(packet6_logger, DBGLVL_PKT_HANDLING, DHCP6_PACKET_PARK_LEASE_WRITE)
+        .arg(query->getLabel());
+    return (true);
+}
+
 void
 Dhcpv6Srv::sendResponseNoThrow(hooks::CalloutHandlePtr& callout_handle,
                                Pkt6Ptr& query, Pkt6Ptr& rsp) {
@@ -1353,6 +1471,8 @@ Dhcpv6Srv::processPacketBufferSend(CalloutHandlePtr& callout_handle,
 
         // Update statistics accordingly for sent packet.
         processStatsSent(rsp);
+        rsp->setEventTime(Pkt::EVENT_SENT);
+        Counters.latency_.record(*rsp);
 
     } catch (const std::exception& e) {
         LOG_ERROR(packet6_logger, DHCP6_PACKET_SEND_FAIL).arg(e.what());
@@ -1996,6 +2116,8 @@ Dhcpv6Srv::assignLeases(const Pkt6Ptr& question, Pkt6Ptr& answer,
     // Save the originally selected subnet.
     Subnet6Ptr orig_subnet = ctx.subnet_;
 
+    question->setEventTime(Pkt::EVENT_ALLOC_STARTED);
+
     // We need to allocate addresses for all IA_NA options in the client's
     // question (i.e. SOLICIT or REQUEST) message.
     // @todo add support for IA_TA
@@ -2034,6 +2156,8 @@ Dhcpv6Srv::assignLeases(const Pkt6Ptr& question, Pkt6Ptr& answer,
         }
     }
 
+    question->setEventTime(Pkt::EVENT_ALLOC_FINISHED);
+
     // Subnet may be modified by the allocation engine, there are things
     // we need to do when that happens.
     checkDynamicSubnetChange(question, answer, ctx, orig_subnet);
@@ -2960,6 +3084,8 @@ Dhcpv6Srv::extendLeases(const Pkt6Ptr& query, Pkt6Ptr& reply,
     // Save the originally selected subnet.
     Subnet6Ptr orig_subnet = ctx.subnet_;
 
+    query->setEventTime(Pkt::EVENT_ALLOC_STARTED);
+
     for (const auto& opt : query->options_) {
         switch (opt.second->getType()) {
         case D6O_IA_NA: {
@@ -2987,6 +3113,8 @@ Dhcpv6Srv::extendLeases(const Pkt6Ptr& query, Pkt6Ptr& reply,
         }
     }
 
+    query->setEventTime(Pkt::EVENT_ALLOC_FINISHED);
+
     // Subnet may be modified by the allocation engine, there are things
     // we need to do when that happens.
     checkDynamicSubnetChange(query, reply, ctx, orig_subnet);
@@ -3446,7 +3574,8 @@ Pkt6Ptr
 Dhcpv6Srv::processSolicit(AllocEngine::ClientContext6& ctx) {
 
     Pkt6Ptr solicit = ctx.query_;
-    Pkt6Ptr response(new Pkt6(DHCPV6_ADVERTISE, solicit->getTransid()));
+    Pkt6Ptr response = makeRecycled<Pkt6>(DHCPV6_ADVERTISE,
+                                          solicit->getTransid());
 
     // Handle Rapid Commit option, if present.
     if (ctx.subnet_ && ctx.subnet_->getRapidCommit()) {
@@ -3512,7 +3641,7 @@ Pkt6Ptr
 Dhcpv6Srv::processRequest(AllocEngine::ClientContext6& ctx) {
 
     Pkt6Ptr request = ctx.query_;
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, request->getTransid()));
+    Pkt6Ptr reply = makeRecycled<Pkt6>(DHCPV6_REPLY, request->getTransid());
 
     processClientFqdn(request, reply, ctx);
 
@@ -3546,7 +3675,7 @@ Pkt6Ptr
 Dhcpv6Srv::processRenew(AllocEngine::ClientContext6& ctx) {
 
     Pkt6Ptr renew = ctx.query_;
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, renew->getTransid()));
+    Pkt6Ptr reply = makeRecycled<Pkt6>(DHCPV6_REPLY, renew->getTransid());
 
     processClientFqdn(renew, reply, ctx);
 
@@ -3580,7 +3709,7 @@ Pkt6Ptr
 Dhcpv6Srv::processRebind(AllocEngine::ClientContext6& ctx) {
 
     Pkt6Ptr rebind = ctx.query_;
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, rebind->getTransid()));
+    Pkt6Ptr reply = makeRecycled<Pkt6>(DHCPV6_REPLY, rebind->getTransid());
 
     processClientFqdn(rebind, reply, ctx);
 
@@ -3625,7 +3754,7 @@ Dhcpv6Srv::processConfirm(AllocEngine::ClientContext6& ctx) {
     }
 
     // The server sends Reply message in response to Confirm.
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, confirm->getTransid()));
+    Pkt6Ptr reply = makeRecycled<Pkt6>(DHCPV6_REPLY, confirm->getTransid());
     // Make sure that the necessary options are included.
     copyClientOptions(confirm, reply);
     CfgOptionList co_list;
@@ -3708,7 +3837,7 @@ Dhcpv6Srv::processRelease(AllocEngine::ClientContext6& ctx) {
     requiredClassify(release, ctx);
 
     // Create an empty Reply message.
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, release->getTransid()));
+    Pkt6Ptr reply = makeRecycled<Pkt6>(DHCPV6_REPLY, release->getTransid());
 
     // Copy client options (client-id, also relay information if present)
     copyClientOptions(release, reply);
@@ -3734,7 +3863,7 @@ Dhcpv6Srv::processDecline(AllocEngine::ClientContext6& ctx) {
     requiredClassify(decline, ctx);
 
     // Create an empty Reply message.
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, decline->getTransid()));
+    Pkt6Ptr reply = makeRecycled<Pkt6>(DHCPV6_REPLY, decline->getTransid());
 
     // Copy client options (client-id, also relay information if present)
     copyClientOptions(decline, reply);
@@ -4039,7 +4168,7 @@ Dhcpv6Srv::processInfRequest(AllocEngine::ClientContext6& ctx) {
     requiredClassify(inf_request, ctx);
 
     // Create a Reply packet, with the same trans-id as the client's.
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, inf_request->getTransid()));
+    Pkt6Ptr reply = makeRecycled<Pkt6>(DHCPV6_REPLY, inf_request->getTransid());
 
     // Copy client options (client-id, also relay information if present)
     copyClientOptions(inf_request, reply);
@@ -4120,24 +4249,12 @@ void Dhcpv6Srv::evaluateClasses(const Pkt6Ptr& pkt, bool depend_on_known) {
     // Note getClientClassDictionary() cannot be null
     const ClientClassDictionaryPtr& dict =
         CfgMgr::instance().getCurrentCfg()->getClientClassDictionary();
-    const ClientClassDefListPtr& defs_ptr = dict->getClasses();
-    for (ClientClassDefList::const_iterator it = defs_ptr->cbegin();
-         it != defs_ptr->cend(); ++it) {
-        // Note second cannot be null
-        const ExpressionPtr& expr_ptr = (*it)->getMatchExpr();
-        // Nothing to do without an expression to evaluate
-        if (!expr_ptr) {
-            continue;
-        }
-        // Not the right time if only when required
-        if ((*it)->getRequired()) {
-            continue;
-        }
-        // Not the right pass.
-        if ((*it)->getDependOnKnown() != depend_on_known) {
-            continue;
-        }
-        (*it)->test(pkt, expr_ptr);
+    // The values of the option tokens shared by the expressions.
+    EvalCache cache;
+    // Only the classes of the pass with an expression to evaluate and
+    // not only evaluated when required.
+    for (auto const& c : dict->getEvaluatedClasses(depend_on_known)) {
+        c->test(pkt, c->getMatchExpr(), &cache);
     }
 }
 
@@ -4449,6 +4566,9 @@ Dhcpv6Srv::getVersion(bool extended) {
 #endif
 #ifdef HAVE_PGSQL
         tmp << PgSqlLeaseMgr::getDBVersion() << endl;
+#endif
+#ifdef HAVE_LMDB
+        tmp << LmdbLeaseMgr::getDBVersion() << endl;
 #endif
         tmp << Memfile_LeaseMgr::getDBVersion(Memfile_LeaseMgr::V6);
 
@@ -4512,79 +4632,80 @@ void Dhcpv6Srv::processStatsReceived(const Pkt6Ptr& query) {
     // Note that we're not bumping pkt6-received statistic as it was
     // increased early in the packet reception code.
 
-    string stat_name = "pkt6-unknown-received";
+    // The counter is not copied to not contend on its reference count.
+    StatCounter* counter = Counters.unknown_received_.get();
     switch (query->getType()) {
     case DHCPV6_SOLICIT:
-        stat_name = "pkt6-solicit-received";
+        counter = Counters.solicit_received_.get();
         break;
     case DHCPV6_ADVERTISE:
         // Should not happen, but let's keep a counter for it
-        stat_name = "pkt6-advertise-received";
+        counter = Counters.advertise_received_.get();
         break;
     case DHCPV6_REQUEST:
-        stat_name = "pkt6-request-received";
+        counter = Counters.request_received_.get();
         break;
     case DHCPV6_CONFIRM:
-        stat_name = "pkt6-confirm-received";
+        counter = Counters.confirm_received_.get();
         break;
     case DHCPV6_RENEW:
-        stat_name = "pkt6-renew-received";
+        counter = Counters.renew_received_.get();
         break;
     case DHCPV6_REBIND:
-        stat_name = "pkt6-rebind-received";
+        counter = Counters.rebind_received_.get();
         break;
     case DHCPV6_REPLY:
         // Should not happen, but let's keep a counter for it
-        stat_name = "pkt6-reply-received";
+        counter = Counters.reply_received_.get();
         break;
     case DHCPV6_RELEASE:
-        stat_name = "pkt6-release-received";
+        counter = Counters.release_received_.get();
         break;
     case DHCPV6_DECLINE:
-        stat_name = "pkt6-decline-received";
+        counter = Counters.decline_received_.get();
         break;
     case DHCPV6_RECONFIGURE:
-        stat_name = "pkt6-reconfigure-received";
+        counter = Counters.reconfigure_received_.get();
         break;
     case DHCPV6_INFORMATION_REQUEST:
-        stat_name = "pkt6-infrequest-received";
+        counter = Counters.infrequest_received_.get();
         break;
     case DHCPV6_DHCPV4_QUERY:
-        stat_name = "pkt6-dhcpv4-query-received";
+        counter = Counters.dhcpv4_query_received_.get();
         break;
     case DHCPV6_DHCPV4_RESPONSE:
         // Should not happen, but let's keep a counter for it
-        stat_name = "pkt6-dhcpv4-response-received";
+        counter = Counters.dhcpv4_response_received_.get();
         break;
     default:
             ; // do nothing
     }
 
-    StatsMgr::instance().addValue(stat_name, static_cast<int64_t>(1));
+    counter->add();
 }
 
 void Dhcpv6Srv::processStatsSent(const Pkt6Ptr& response) {
     // Increase generic counter for sent packets.
-    StatsMgr::instance().addValue("pkt6-sent", static_cast<int64_t>(1));
+    Counters.sent_->add();
 
     // Increase packet type specific counter for packets sent.
-    string stat_name;
+    StatCounter* counter = 0;
     switch (response->getType()) {
     case DHCPV6_ADVERTISE:
-        stat_name = "pkt6-advertise-sent";
+        counter = Counters.advertise_sent_.get();
         break;
     case DHCPV6_REPLY:
-        stat_name = "pkt6-reply-sent";
+        counter = Counters.reply_sent_.get();
         break;
     case DHCPV6_DHCPV4_RESPONSE:
-        stat_name = "pkt6-dhcpv4-response-sent";
+        counter = Counters.dhcpv4_response_sent_.get();
         break;
     default:
         // That should never happen
         return;
     }
 
-    StatsMgr::instance().addValue(stat_name, static_cast<int64_t>(1));
+    counter->add();
 }
 
 int Dhcpv6Srv::getHookIndexBuffer6Send() {
@@ -4607,6 +4728,7 @@ Dhcpv6Srv::requestedInORO(const Pkt6Ptr& query, const uint16_t code) const {
 void Dhcpv6Srv::discardPackets() {
     // Dump all of our current packets, anything that is mid-stream
     HooksManager::clearParkingLots();
+    durable_parking_lot_->clear();
 }
 
 /// @todo This logic to be modified if we decide to support infinite lease times.
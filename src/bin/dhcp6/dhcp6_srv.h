@@ -26,6 +26,7 @@
 #include <dhcpsrv/network_state.h>
 #include <dhcpsrv/subnet.h>
 #include <hooks/callout_handle.h>
+#include <hooks/parking_lots.h>
 #include <process/daemon.h>
 
 #include <functional>
@@ -173,6 +174,24 @@ public:
     void sendResponseNoThrow(hooks::CalloutHandlePtr& callout_handle,
                              Pkt6Ptr& query, Pkt6Ptr& rsp);
 
+    /// @brief Holds the response until the lease changes are durable.
+    ///
+    /// When the lease backend writes the lease changes in background,
+    /// e.g. the memfile backend in the write-behind mode or the SQL
+    /// backends with asynchronous lease updates, the response is parked
+    /// until the changes made by the current thread are on the disk or
+    /// committed by the database. The response is then sent by a thread of the packet thread
+    /// pool, or dropped if the changes could not be written.
+    ///
+    /// @param callout_handle pointer to the callout handle.
+    /// @param query A pointer to the processed packet.
+    /// @param rsp A pointer to the response.
+    ///
+    /// @return true if the response was parked, false if it can be sent
+    /// immediately.
+    bool parkUntilLeasesDurable(hooks::CalloutHandlePtr& callout_handle,
+                                Pkt6Ptr& query, Pkt6Ptr& rsp);
+
     /// @brief Process a single incoming DHCPv6 packet.
     ///
     /// It verifies correctness of the passed packet, calls per-type processXXX
@@ -835,7 +854,8 @@ protected:
     /// @note Second part of the classification.
     ///
     /// Evaluate expressions of client classes: if it returns true the class
-    /// is added to the incoming packet.
+    /// is added to the incoming packet. The values of the option tokens
+    /// are computed once for all the expressions.
     ///
     /// @param pkt packet to be classified.
     /// @param depend_on_known if false classes depending on the KNOWN or
@@ -1191,6 +1211,10 @@ protected:
 
     /// @brief Controls access to the configuration backends.
     CBControlDHCPv6Ptr cb_control_;
+
+    /// @brief Holds the responses waiting for the lease changes to be
+    /// durable.
+    hooks::ParkingLotPtr durable_parking_lot_;
 };
 
 }  // namespace dhcp
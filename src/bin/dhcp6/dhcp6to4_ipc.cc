@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -56,29 +56,35 @@ void Dhcp6to4Ipc::open() {
 
 void Dhcp6to4Ipc::handler(int /* fd */) {
     Dhcp6to4Ipc& ipc = Dhcp6to4Ipc::instance();
-    Pkt6Ptr pkt;
 
-    try {
-        LOG_DEBUG(packet6_logger, DBG_DHCP6_DETAIL, DHCP6_DHCP4O6_RECEIVING);
-        // Receive message from IPC.
-        pkt = ipc.receive();
+    // Process the messages already queued on the socket at once.
+    for (size_t count = 0; count < MAX_BATCH_SIZE; ++count) {
+        Pkt6Ptr pkt;
+
+        try {
+            LOG_DEBUG(packet6_logger, DBG_DHCP6_DETAIL, DHCP6_DHCP4O6_RECEIVING);
+            // Receive message from IPC.
+            pkt = ipc.receive();
+            if (!pkt) {
+                // No more queued message.
+                return;
+            }
 
-        if (pkt) {
             LOG_DEBUG(packet6_logger, DBG_DHCP6_BASIC, DHCP6_DHCP4O6_PACKET_RECEIVED)
                 .arg(static_cast<int>(pkt->getType()))
                 .arg(pkt->getRemoteAddr().toText())
                 .arg(pkt->getRemotePort())
                 .arg(pkt->getIface());
+        } catch (const std::exception& e) {
+            LOG_DEBUG(packet6_logger,DBG_DHCP6_DETAIL, DHCP6_DHCP4O6_RECEIVE_FAIL)
+                .arg(e.what());
+            continue;
         }
-    } catch (const std::exception& e) {
-        LOG_DEBUG(packet6_logger,DBG_DHCP6_DETAIL, DHCP6_DHCP4O6_RECEIVE_FAIL)
-            .arg(e.what());
-    }
-
-    if (!pkt) {
-        return;
+        process(pkt);
     }
+}
 
+void Dhcp6to4Ipc::process(Pkt6Ptr pkt) {
     // Should we check it is a DHCPV6_DHCPV4_RESPONSE?
 
     // Handle relay port
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -43,12 +43,21 @@ public:
 
     /// @brief On receive handler
     ///
-    /// The handler sends the DHCPv6 packet back to the remote address
+    /// The handler forwards the DHCPv6 packets queued on the socket, up
+    /// to @c MAX_BATCH_SIZE packets.
     static void handler(int /* fd */);
 
     /// @param client_port UDP port where all responses are sent to.
     /// Not zero is mostly useful for testing purposes.
     static uint16_t client_port;
+
+private:
+    /// @brief Processes a received packet.
+    ///
+    /// Sends the DHCPv6 packet back to the remote address.
+    ///
+    /// @param pkt The received packet.
+    static void process(Pkt6Ptr pkt);
 };
 
 } // namespace isc
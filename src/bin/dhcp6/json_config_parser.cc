@@ -632,7 +632,7 @@ processDhcp6Config(isc::data::ConstElementPtr config_set) {
         ConstElementPtr lease_database = mutable_cfg->get("lease-database");
         if (lease_database) {
             parameter_name = "lease-database";
-            db::DbAccessParser parser;
+            db::DbAccessParser parser(db::DbAccessParser::LEASE_DB);
             std::string access_string;
             parser.parse(access_string, lease_database);
             CfgDbAccessPtr cfg_db_access = srv_config->getCfgDbAccess();
@@ -642,7 +642,7 @@ processDhcp6Config(isc::data::ConstElementPtr config_set) {
         ConstElementPtr hosts_database = mutable_cfg->get("hosts-database");
         if (hosts_database) {
             parameter_name = "hosts-database";
-            db::DbAccessParser parser;
+            db::DbAccessParser parser(db::DbAccessParser::HOSTS_DB);
             std::string access_string;
             parser.parse(access_string, hosts_database);
             CfgDbAccessPtr cfg_db_access = srv_config->getCfgDbAccess();
@@ -654,7 +654,7 @@ processDhcp6Config(isc::data::ConstElementPtr config_set) {
             parameter_name = "hosts-databases";
             CfgDbAccessPtr cfg_db_access = srv_config->getCfgDbAccess();
             for (auto it : hosts_databases->listValue()) {
-                db::DbAccessParser parser;
+                db::DbAccessParser parser(db::DbAccessParser::HOSTS_DB);
                 std::string access_string;
                 parser.parse(access_string, it);
                 cfg_db_access->setHostDbAccessString(access_string);
@@ -920,6 +920,9 @@ configureDhcp6Server(Dhcpv6Srv& server, isc::data::ConstElementPtr config_set,
                     try {
                         data::ConstElementPtr qc;
                         qc = CfgMgr::instance().getStagingCfg()->getDHCPQueueControl();
+                        IfaceMgr::instance().setReceiverCpuAffinity(
+                            CfgMultiThreading::extractCpuAffinity(CfgMgr::instance().getStagingCfg()->getDHCPMultiThreading(),
+                                                                  "receiver-cpu-affinity"));
                         if (IfaceMgr::instance().configureDHCPPacketQueue(AF_INET6, qc)) {
                             LOG_INFO(dhcp6_logger, DHCP6_CONFIG_PACKET_QUEUE)
                                      .arg(IfaceMgr::instance().getPacketQueue6()->getInfoStr());
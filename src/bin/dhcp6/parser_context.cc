@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -156,6 +156,8 @@ Parser6Context::contextName() {
         return ("Dhcp6");
     case INTERFACES_CONFIG:
         return ("interfaces-config");
+    case EVENT_HANDLER_TYPE:
+        return ("event-handler-type");
     case LEASE_DATABASE:
         return ("lease-database");
     case HOSTS_DATABASE:
@@ -164,6 +166,10 @@ Parser6Context::contextName() {
         return ("database-type");
     case DATABASE_ON_FAIL:
         return ("database-on-fail");
+    case DATABASE_LFC_MODE:
+        return ("database-lfc-mode");
+    case DATABASE_LEASE_FILE_FORMAT:
+        return ("database-lease-file-format");
     case MAC_SOURCES:
         return ("mac-sources");
     case HOST_RESERVATION_IDENTIFIERS:
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -243,6 +243,9 @@ public:
         /// Used while parsing Dhcp6/interfaces structures.
         INTERFACES_CONFIG,
 
+        /// Used while parsing Dhcp6/interfaces/event-handler-type structures.
+        EVENT_HANDLER_TYPE,
+
         /// Sanity checks.
         SANITY_CHECKS,
 
@@ -258,6 +261,12 @@ public:
         /// Used while parsing Dhcp6/*-database/on-fail.
         DATABASE_ON_FAIL,
 
+        /// Used while parsing Dhcp6/lease-database/lfc-mode.
+        DATABASE_LFC_MODE,
+
+        /// Used while parsing Dhcp6/lease-database/lease-file-format.
+        DATABASE_LEASE_FILE_FORMAT,
+
         /// Used while parsing Dhcp6/mac-sources structures.
         MAC_SOURCES,
 
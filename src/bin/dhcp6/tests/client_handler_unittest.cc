@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -492,4 +492,57 @@ TEST_F(ClientHandleTest, serializeThreeQueries) {
     EXPECT_TRUE(called3_);
 }
 
+// Verifies behavior with many clients spread over the shards.
+TEST_F(ClientHandleTest, manyClients) {
+    const size_t count = 256;
+    std::vector<Pkt6Ptr> queries;
+    std::vector<Pkt6Ptr> duplicates;
+    for (size_t i = 0; i < count; ++i) {
+        // Clients differ by their DUID.
+        OptionBuffer duid(8, 0);
+        duid[6] = i >> 8;
+        duid[7] = i & 0xff;
+        OptionPtr client_id(new Option(Option::V6, D6O_CLIENTID, duid));
+
+        Pkt6Ptr query(new Pkt6(DHCPV6_SOLICIT, 1000 + i));
+        query->addOption(client_id);
+        queries.push_back(query);
+
+        Pkt6Ptr duplicate(new Pkt6(DHCPV6_REQUEST, 2000 + i));
+        duplicate->addOption(client_id);
+        duplicates.push_back(duplicate);
+    }
+
+    try {
+        std::vector<boost::shared_ptr<ClientHandler> > handlers;
+        for (auto const& query : queries) {
+            boost::shared_ptr<ClientHandler> handler(new ClientHandler());
+            bool duplicate = true;
+            EXPECT_NO_THROW(duplicate = !handler->tryLock(query));
+            EXPECT_FALSE(duplicate);
+            handlers.push_back(handler);
+        }
+        for (auto const& query : duplicates) {
+            ClientHandler handler;
+            bool duplicate = false;
+            EXPECT_NO_THROW(duplicate = !handler.tryLock(query));
+            EXPECT_TRUE(duplicate);
+        }
+
+        // Release the clients: the duplicates are no longer duplicates.
+        handlers.clear();
+        for (auto const& query : duplicates) {
+            ClientHandler handler;
+            bool duplicate = true;
+            EXPECT_NO_THROW(duplicate = !handler.tryLock(query));
+            EXPECT_FALSE(duplicate);
+        }
+    } catch (const std::exception& ex) {
+        ADD_FAILURE() << "unexpected exception: " << ex.what();
+    }
+    ObservationPtr obs = StatsMgr::instance().getObservation("pkt6-receive-drop");
+    ASSERT_TRUE(obs);
+    EXPECT_EQ(count, obs->getInteger().first);
+}
+
 } // end of anonymous namespace
@@ -459,6 +459,17 @@ public:
         }
     }
 
+    /// @brief Configures the server with database maps.
+    ///
+    /// The database maps go through the configuration grammar and the
+    /// database access parser. The configuration must be valid.
+    ///
+    /// @param databases the database entries of the configuration
+    void configureDatabases(const std::string& databases) {
+        configure("{ " + genIfaceConfig() + ", " + databases + " }",
+                  CONTROL_RESULT_SUCCESS, "");
+    }
+
     /// @brief Checks if specified subnet is part of the collection
     ///
     /// @tparam CollectionType type of subnet6 collections i.e.
@@ -7371,6 +7382,278 @@ TEST_F(Dhcp6ParserTest, hostsDatabases) {
     EXPECT_EQ("name=keatest2 password=keatest type=mysql user=keatest", hal.back());
 }
 
+// This test checks the load-threads lease database parameter.
+TEST_F(Dhcp6ParserTest, leaseDatabaseLoadThreads) {
+    configureDatabases("\"lease-database\": { \"type\": \"memfile\","
+                       " \"persist\": false, \"load-threads\": 4 }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("load-threads=4 persist=false type=memfile",
+              cfgdb->getLeaseDbAccessString());
+}
+
+// This test checks the lease file format lease database parameters.
+TEST_F(Dhcp6ParserTest, leaseDatabaseFileFormat) {
+    configureDatabases("\"lease-database\": { \"type\": \"memfile\","
+                       " \"persist\": false, \"lease-file-format\": \"binary\","
+                       " \"fsync-records\": 100 }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("fsync-records=100 lease-file-format=binary persist=false"
+              " type=memfile", cfgdb->getLeaseDbAccessString());
+
+    // The value is checked by the database access parser.
+    configure("{ " + genIfaceConfig() + ", \"lease-database\": {"
+              " \"type\": \"memfile\", \"lease-file-format\": \"xml\" } }",
+              CONTROL_RESULT_ERROR);
+}
+
+// This test checks the write-behind lease database parameters.
+TEST_F(Dhcp6ParserTest, leaseDatabaseWriteBehind) {
+    configureDatabases("\"lease-database\": { \"type\": \"memfile\","
+                       " \"persist\": false, \"write-behind\": true,"
+                       " \"write-behind-queue-size\": 1000 }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("persist=false type=memfile write-behind=true"
+              " write-behind-queue-size=1000", cfgdb->getLeaseDbAccessString());
+
+    // The queue size must be positive.
+    configure("{ " + genIfaceConfig() + ", \"lease-database\": {"
+              " \"type\": \"memfile\", \"write-behind-queue-size\": 0 } }",
+              CONTROL_RESULT_ERROR);
+}
+
+// This test checks the pipeline lease database parameter.
+TEST_F(Dhcp6ParserTest, leaseDatabasePipeline) {
+    configureDatabases("\"lease-database\": { \"type\": \"postgresql\","
+                       " \"name\": \"keatest\", \"pipeline\": true }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("name=keatest pipeline=true type=postgresql",
+              cfgdb->getLeaseDbAccessString());
+
+    // The pipeline mode is only supported by the postgresql backend.
+    configure("{ " + genIfaceConfig() + ", "
+              "\"lease-database\": { \"type\": \"mysql\","
+              " \"name\": \"keatest\", \"pipeline\": true } }",
+              CONTROL_RESULT_ERROR);
+}
+
+// This test checks the async-threads lease database parameter.
+TEST_F(Dhcp6ParserTest, leaseDatabaseAsyncThreads) {
+    configureDatabases("\"lease-database\": { \"type\": \"mysql\","
+                       " \"name\": \"keatest\", \"async-threads\": 4 }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("async-threads=4 name=keatest type=mysql",
+              cfgdb->getLeaseDbAccessString());
+
+    // The asynchronous updates are only supported by the SQL backends.
+    configure("{ " + genIfaceConfig() + ", "
+              "\"lease-database\": { \"type\": \"memfile\","
+              " \"async-threads\": 4 } }",
+              CONTROL_RESULT_ERROR);
+}
+
+// This test checks the in-memory-limits lease database parameter.
+TEST_F(Dhcp6ParserTest, leaseDatabaseInMemoryLimits) {
+    configureDatabases("\"lease-database\": { \"type\": \"mysql\","
+                       " \"name\": \"keatest\", \"in-memory-limits\": true }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("in-memory-limits=true name=keatest type=mysql",
+              cfgdb->getLeaseDbAccessString());
+
+    // The memfile backend always counts the leases in memory.
+    configure("{ " + genIfaceConfig() + ", "
+              "\"lease-database\": { \"type\": \"memfile\","
+              " \"in-memory-limits\": true } }",
+              CONTROL_RESULT_ERROR);
+}
+
+// This test checks the host cache parameters of the hosts database.
+TEST_F(Dhcp6ParserTest, hostsDatabaseCache) {
+    configureDatabases("\"hosts-database\": { \"type\": \"mysql\","
+                       " \"name\": \"keatest\", \"cache-size\": 10000,"
+                       " \"cache-ttl\": 300, \"cache-negative\": true }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("cache-negative=true cache-size=10000 cache-ttl=300 "
+              "name=keatest type=mysql",
+              cfgdb->getHostDbAccessString());
+
+    // The cache parameters are checked by the database access parser.
+    configure("{ " + genIfaceConfig() + ", "
+              "\"hosts-database\": { \"type\": \"mysql\","
+              " \"name\": \"keatest\", \"cache-ttl\": -1 } }",
+              CONTROL_RESULT_ERROR);
+}
+
+// This test checks the in-memory-stats lease database parameter.
+TEST_F(Dhcp6ParserTest, leaseDatabaseInMemoryStats) {
+    configureDatabases("\"lease-database\": { \"type\": \"mysql\","
+                       " \"name\": \"keatest\", \"in-memory-stats\": true }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("in-memory-stats=true name=keatest type=mysql",
+              cfgdb->getLeaseDbAccessString());
+
+    // The value must be a boolean.
+    configure("{ " + genIfaceConfig() + ", "
+              "\"lease-database\": { \"type\": \"mysql\","
+              " \"name\": \"keatest\", \"in-memory-stats\": 1 } }",
+              CONTROL_RESULT_ERROR);
+}
+
+// This test checks the lfc-mode lease database parameter.
+TEST_F(Dhcp6ParserTest, leaseDatabaseLfcMode) {
+    configureDatabases("\"lease-database\": { \"type\": \"memfile\","
+                       " \"persist\": false, \"lfc-mode\": \"in-process\" }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("lfc-mode=in-process persist=false type=memfile",
+              cfgdb->getLeaseDbAccessString());
+
+    // The mode is checked by the database access parser.
+    configure("{ " + genIfaceConfig() + ", "
+              "\"lease-database\": { \"type\": \"memfile\","
+              " \"lfc-mode\": \"fork\" } }",
+              CONTROL_RESULT_ERROR);
+}
+
+// This test checks the lfc-max-leases lease database parameter.
+TEST_F(Dhcp6ParserTest, leaseDatabaseLfcMaxLeases) {
+    configureDatabases("\"lease-database\": { \"type\": \"memfile\","
+                       " \"persist\": false, \"lfc-max-leases\": 100000 }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("lfc-max-leases=100000 persist=false type=memfile",
+              cfgdb->getLeaseDbAccessString());
+
+    // The value must not be negative.
+    configure("{ " + genIfaceConfig() + ", "
+              "\"lease-database\": { \"type\": \"memfile\","
+              " \"lfc-max-leases\": -1 } }",
+              CONTROL_RESULT_ERROR);
+}
+
+// This test checks the pool-size lease database parameter.
+TEST_F(Dhcp6ParserTest, leaseDatabasePoolSize) {
+    configureDatabases("\"lease-database\": { \"type\": \"mysql\","
+                       " \"name\": \"keatest\", \"pool-size\": 8 }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("name=keatest pool-size=8 type=mysql",
+              cfgdb->getLeaseDbAccessString());
+
+    // The context pool is only supported by the SQL backends.
+    configure("{ " + genIfaceConfig() + ", "
+              "\"lease-database\": { \"type\": \"memfile\","
+              " \"pool-size\": 8 } }",
+              CONTROL_RESULT_ERROR);
+}
+
+// This test checks the writer-threads lease database parameter.
+TEST_F(Dhcp6ParserTest, leaseDatabaseWriterThreads) {
+    configureDatabases("\"lease-database\": { \"type\": \"postgresql\","
+                       " \"name\": \"keatest\", \"writer-threads\": 2 }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("name=keatest type=postgresql writer-threads=2",
+              cfgdb->getLeaseDbAccessString());
+
+    // The writer threads are only supported by the SQL backends.
+    configure("{ " + genIfaceConfig() + ", "
+              "\"lease-database\": { \"type\": \"memfile\","
+              " \"writer-threads\": 2 } }",
+              CONTROL_RESULT_ERROR);
+}
+
+// This test checks the read replica parameters of the databases.
+TEST_F(Dhcp6ParserTest, databaseReplica) {
+    configureDatabases("\"lease-database\": { \"type\": \"postgresql\","
+                       " \"name\": \"keatest\", \"host\": \"primary.example.org\","
+                       " \"replica-host\": \"replica.example.org\","
+                       " \"replica-port\": 5433, \"replica-max-lag\": 5 },"
+                       " \"hosts-database\": { \"type\": \"postgresql\","
+                       " \"name\": \"keatest\", \"replica-host\": \"replica.example.org\" }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("host=primary.example.org name=keatest "
+              "replica-host=replica.example.org replica-max-lag=5 "
+              "replica-port=5433 type=postgresql",
+              cfgdb->getLeaseDbAccessString());
+    EXPECT_EQ("name=keatest replica-host=replica.example.org "
+              "type=postgresql",
+              cfgdb->getHostDbAccessString());
+
+    // The replica parameters require the replica host.
+    configure("{ " + genIfaceConfig() + ", "
+              "\"lease-database\": { \"type\": \"postgresql\","
+              " \"name\": \"keatest\", \"replica-port\": 5433 } }",
+              CONTROL_RESULT_ERROR);
+}
+
+// This test checks the in-memory global reservation parameters.
+TEST_F(Dhcp6ParserTest, hostsDatabaseGlobalHostsInMemory) {
+    configureDatabases("\"hosts-database\": { \"type\": \"postgresql\","
+                       " \"name\": \"keatest\", \"global-hosts-in-memory\": true,"
+                       " \"global-hosts-refresh\": 60 }");
+    ConstCfgDbAccessPtr cfgdb =
+        CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+    ASSERT_TRUE(cfgdb);
+    EXPECT_EQ("global-hosts-in-memory=true global-hosts-refresh=60 "
+              "name=keatest type=postgresql",
+              cfgdb->getHostDbAccessString());
+
+    // The refresh interval must not be negative.
+    configure("{ " + genIfaceConfig() + ", "
+              "\"hosts-database\": { \"type\": \"postgresql\","
+              " \"name\": \"keatest\", \"global-hosts-refresh\": -1 } }",
+              CONTROL_RESULT_ERROR);
+}
+
+// This test checks that lease database parameters are rejected in a
+// host database and host database parameters in a lease database when
+// the configuration bypasses the bison parser.
+TEST_F(Dhcp6ParserTest, databaseParametersKind) {
+    string config = "{ " + genIfaceConfig() + ", "
+        "\"hosts-database\": { \"type\": \"mysql\","
+        " \"name\": \"keatest\", \"writer-threads\": 2 } }";
+
+    // Syntax is incorrect.
+    EXPECT_THROW(parseDHCP6(config), Dhcp6ParseError);
+    ConstElementPtr json;
+    ASSERT_NO_THROW(json = parseJSON(config));
+
+    ConstElementPtr status;
+    EXPECT_NO_THROW(status = Dhcpv6SrvTest::configure(srv_, json));
+    checkResult(status, 1);
+
+    config = "{ " + genIfaceConfig() + ", "
+        "\"lease-database\": { \"type\": \"memfile\","
+        " \"cache-size\": 1000 } }";
+
+    EXPECT_THROW(parseDHCP6(config), Dhcp6ParseError);
+    ASSERT_NO_THROW(json = parseJSON(config));
+    EXPECT_NO_THROW(status = Dhcpv6SrvTest::configure(srv_, json));
+    checkResult(status, 1);
+}
+
 // This test checks comments. Please keep it last.
 TEST_F(Dhcp6ParserTest, comments) {
 
@@ -208,6 +208,34 @@ public:
         out.close();
     }
 
+    /// @brief Initializes a server from a configuration file holding
+    /// a memfile lease database.
+    ///
+    /// @param params the lease database parameters after the type
+    /// @return the lease database access string of the configuration
+    string initLeaseDatabase(const string& params) {
+        string config =
+            "{ \"Dhcp6\": {"
+            "\"interfaces-config\": {"
+            "    \"interfaces\": [ ]"
+            "},"
+            "\"lease-database\": {"
+            "     \"type\": \"memfile\"," + params +
+            "},"
+            "\"subnet6\": [ ],"
+            "\"preferred-lifetime\": 3000, "
+        "\"valid-lifetime\": 4000 }"
+            "}";
+        writeFile(TEST_FILE, config);
+
+        boost::scoped_ptr<ControlledDhcpv6Srv> srv;
+        EXPECT_NO_THROW(srv.reset(new ControlledDhcpv6Srv(0)));
+        EXPECT_NO_THROW(srv->init(TEST_FILE));
+        EXPECT_TRUE(LeaseMgrFactory::haveInstance());
+        return (CfgMgr::instance().getCurrentCfg()->getCfgDbAccess()->
+                getLeaseDbAccessString());
+    }
+
     /// @brief Runs timers for specified time.
     ///
     /// @param io_service Pointer to the IO service to be ran.
@@ -892,6 +920,46 @@ TEST_F(JSONFileBackendTest, defaultLeaseDbBackend) {
     EXPECT_NO_THROW(static_cast<void>(LeaseMgrFactory::instance()));
 }
 
+// This test verifies that the lease database parameters without a keyword
+// in the grammar are accepted in the configuration file.
+TEST_F(JSONFileBackendTest, leaseDbLoadThreads) {
+    string access = initLeaseDatabase("\"persist\": false, \"load-threads\": 2");
+    EXPECT_NE(string::npos, access.find("load-threads=2")) << access;
+}
+
+// This test verifies that the lease file format parameters are accepted
+// in the configuration file.
+TEST_F(JSONFileBackendTest, leaseDbFileFormat) {
+    string access = initLeaseDatabase("\"persist\": false,"
+                                      " \"lease-file-format\": \"binary\","
+                                      " \"fsync-records\": 100");
+    EXPECT_NE(string::npos, access.find("lease-file-format=binary")) << access;
+    EXPECT_NE(string::npos, access.find("fsync-records=100")) << access;
+}
+
+// This test verifies that the write-behind parameters are accepted in
+// the configuration file.
+TEST_F(JSONFileBackendTest, leaseDbWriteBehind) {
+    string access = initLeaseDatabase("\"persist\": false, \"write-behind\": true,"
+                                      " \"write-behind-queue-size\": 1000");
+    EXPECT_NE(string::npos, access.find("write-behind=true")) << access;
+    EXPECT_NE(string::npos, access.find("write-behind-queue-size=1000")) << access;
+}
+
+// This test verifies that the lfc-mode parameter is accepted in the
+// configuration file.
+TEST_F(JSONFileBackendTest, leaseDbLfcMode) {
+    string access = initLeaseDatabase("\"persist\": false, \"lfc-mode\": \"in-process\"");
+    EXPECT_NE(string::npos, access.find("lfc-mode=in-process")) << access;
+}
+
+// This test verifies that the lfc-max-leases parameter is accepted in the
+// configuration file.
+TEST_F(JSONFileBackendTest, leaseDbLfcMaxLeases) {
+    string access = initLeaseDatabase("\"persist\": false, \"lfc-max-leases\": 100000");
+    EXPECT_NE(string::npos, access.find("lfc-max-leases=100000")) << access;
+}
+
 // This test verifies that the timer triggering configuration updates
 // is invoked according to the configured value of the
 // config-fetch-wait-time.
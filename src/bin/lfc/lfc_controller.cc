@@ -13,6 +13,7 @@
 #include <exceptions/exceptions.h>
 #include <dhcpsrv/csv_lease_file4.h>
 #include <dhcpsrv/csv_lease_file6.h>
+#include <dhcpsrv/lease_journal.h>
 #include <dhcpsrv/memfile_lease_mgr.h>
 #include <dhcpsrv/memfile_lease_storage.h>
 #include <dhcpsrv/lease_mgr.h>
@@ -21,13 +22,21 @@
 #include <log/logger_name.h>
 #include <process/cfgrpt/config_report.h>
 
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+
 #include <iostream>
+#include <limits>
+#include <map>
+#include <queue>
 #include <sstream>
+#include <vector>
 #include <unistd.h>
 #include <stdlib.h>
 #include <cerrno>
 
 using namespace std;
+using namespace isc::asiolink;
 using namespace isc::util;
 using namespace isc::dhcp;
 using namespace isc::log;
@@ -40,6 +49,347 @@ const uint32_t MAX_LEASE_ERRORS = 100;
 namespace isc {
 namespace lfc {
 
+namespace {
+
+/// @brief Statistics of the leases read from the lease files.
+struct ReadStats {
+    /// @brief Constructor.
+    ReadStats() : leases_(0), reads_(0), errs_(0) {
+    }
+
+    /// @brief Number of leases read.
+    uint32_t leases_;
+
+    /// @brief Number of read attempts.
+    uint32_t reads_;
+
+    /// @brief Number of read errors.
+    uint32_t errs_;
+};
+
+/// @brief Reads the leases from a lease file of a given type.
+///
+/// It does nothing if the file doesn't exist.
+///
+/// @param filename Name of the lease file.
+/// @param storage Storage the leases are added to.
+/// @param stats Statistics updated with the ones of the file.
+///
+/// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+/// @tparam LeaseFileType A lease file type, e.g. @c CSVLeaseFile4.
+/// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
+template<typename LeaseObjectType, typename LeaseFileType, typename StorageType>
+void
+loadLeaseFile(const std::string& filename, StorageType& storage,
+              ReadStats& stats) {
+    LeaseFileType lf(filename);
+    if (lf.exists()) {
+        LeaseFileLoader::load<LeaseObjectType>(lf, storage, MAX_LEASE_ERRORS);
+    }
+    stats.leases_ += lf.getReadLeases();
+    stats.reads_ += lf.getReads();
+    stats.errs_ += lf.getReadErrs();
+}
+
+/// @brief Reads the leases from a CSV lease file or a lease journal.
+///
+/// The format is detected using the beginning of the file.
+///
+/// @param filename Name of the lease file.
+/// @param storage Storage the leases are added to.
+/// @param stats Statistics updated with the ones of the file.
+///
+/// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+/// @tparam CSVFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+/// @tparam JournalType A @c LeaseJournal4 or @c LeaseJournal6.
+/// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
+///
+/// @return true if the file is a lease journal.
+template<typename LeaseObjectType, typename CSVFileType, typename JournalType,
+         typename StorageType>
+bool
+loadLeases(const std::string& filename, StorageType& storage,
+           ReadStats& stats) {
+    if (LeaseJournal::isJournal(filename)) {
+        loadLeaseFile<LeaseObjectType, JournalType>(filename, storage, stats);
+        return (true);
+    }
+    loadLeaseFile<LeaseObjectType, CSVFileType>(filename, storage, stats);
+    return (false);
+}
+
+/// @brief Writes the leases to a lease file of a given type.
+///
+/// @param filename Name of the output file.
+/// @param storage Storage holding the leases.
+///
+/// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+/// @tparam LeaseFileType A lease file type, e.g. @c CSVLeaseFile4.
+/// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
+template<typename LeaseObjectType, typename LeaseFileType, typename StorageType>
+void
+writeLeaseFile(const std::string& filename, const StorageType& storage) {
+    LeaseFileType lf_output(filename);
+    LeaseFileLoader::write<LeaseObjectType>(lf_output, storage);
+
+    // If desired log the stats
+    LOG_INFO(lfc_logger, LFC_WRITE_STATS)
+      .arg(lf_output.getWriteLeases())
+      .arg(lf_output.getWrites())
+      .arg(lf_output.getWriteErrs());
+}
+
+/// @brief Sorted run of the merge: the newest entry of each address,
+/// including the entries with a valid lifetime of 0 which remove the
+/// lease from the previous runs.
+///
+/// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+template<typename LeaseObjectType>
+using MergeRun = std::map<IOAddress, boost::shared_ptr<LeaseObjectType> >;
+
+/// @brief Writes a run to a temporary file.
+///
+/// @param run The run which is cleared after it has been written.
+/// @param output_file Name of the output file used to name the run file.
+/// @param [in,out] run_files Names of the run files in order.
+///
+/// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+/// @tparam LeaseFileType The lease file type of the run files.
+template<typename LeaseObjectType, typename LeaseFileType>
+void
+writeRun(MergeRun<LeaseObjectType>& run, const std::string& output_file,
+         std::vector<std::string>& run_files) {
+    std::ostringstream name;
+    name << output_file << ".run" << run_files.size();
+    if ((remove(name.str().c_str()) != 0) && (errno != ENOENT)) {
+        isc_throw(RunTimeFail, "Unable to delete run file '"
+                  << name.str() << "' error: " << strerror(errno));
+    }
+    run_files.push_back(name.str());
+
+    LeaseFileType lf_run(name.str());
+    lf_run.open();
+    for (auto const& entry : run) {
+        lf_run.append(*entry.second);
+    }
+    lf_run.close();
+
+    LOG_INFO(lfc_logger, LFC_MERGE_RUN)
+      .arg(name.str())
+      .arg(run.size());
+    run.clear();
+}
+
+/// @brief Reads the entries of a lease file of a given type into runs.
+///
+/// It does nothing if the file doesn't exist.
+///
+/// @param filename Name of the lease file.
+/// @param max_leases Maximum number of entries of a run.
+/// @param [in,out] run The current run, written when it is full.
+/// @param output_file Name of the output file used to name the run files.
+/// @param [in,out] run_files Names of the run files in order.
+/// @param stats Statistics updated with the ones of the file.
+///
+/// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+/// @tparam LeaseFileType A lease file type, e.g. @c CSVLeaseFile4.
+/// @tparam RunFileType The lease file type of the run files.
+template<typename LeaseObjectType, typename LeaseFileType, typename RunFileType>
+void
+readRuns(const std::string& filename, const uint32_t max_leases,
+         MergeRun<LeaseObjectType>& run, const std::string& output_file,
+         std::vector<std::string>& run_files, ReadStats& stats) {
+    LeaseFileType lf(filename);
+    if (lf.exists()) {
+        lf.open();
+        uint32_t errcnt = 0;
+        boost::shared_ptr<LeaseObjectType> lease;
+        while (true) {
+            if (!lf.next(lease)) {
+                // Skip the corrupted entry as the lease file loader.
+                if (++errcnt > MAX_LEASE_ERRORS) {
+                    lf.close();
+                    isc_throw(RunTimeFail, "exceeded maximum number of"
+                              " failures " << MAX_LEASE_ERRORS << " to read"
+                              " a lease from the lease file " << filename);
+                }
+                continue;
+            }
+            if (!lease) {
+                break;
+            }
+            // A later entry replaces the entry of the same address.
+            run[lease->addr_] = lease;
+            if (run.size() >= max_leases) {
+                writeRun<LeaseObjectType, RunFileType>(run, output_file,
+                                                       run_files);
+            }
+        }
+        lf.close();
+    }
+    stats.leases_ += lf.getReadLeases();
+    stats.reads_ += lf.getReads();
+    stats.errs_ += lf.getReadErrs();
+}
+
+/// @brief Merges the runs into the output file.
+///
+/// The runs hold unique addresses in ascending order and a later run has
+/// newer entries: for each address the entry of the latest run is kept
+/// and written when its valid lifetime is not 0. Only the first entry
+/// of each run is held in memory.
+///
+/// @param run_files Names of the run files in order.
+/// @param lf_output The output file.
+///
+/// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+/// @tparam LeaseFileType The lease file type of the run and output files.
+template<typename LeaseObjectType, typename LeaseFileType>
+void
+mergeRuns(const std::vector<std::string>& run_files,
+          LeaseFileType& lf_output) {
+    typedef boost::shared_ptr<LeaseObjectType> LeasePtrType;
+
+    // Address of the first entry of a run and the index of the run.
+    typedef std::pair<IOAddress, size_t> Head;
+
+    // The top of the queue is the lowest address of the latest run.
+    struct HeadCompare {
+        bool operator()(const Head& a, const Head& b) const {
+            if (a.first == b.first) {
+                return (a.second < b.second);
+            }
+            return (b.first < a.first);
+        }
+    };
+
+    std::vector<boost::shared_ptr<LeaseFileType> > runs;
+    std::vector<LeasePtrType> heads(run_files.size());
+    std::priority_queue<Head, std::vector<Head>, HeadCompare> queue;
+
+    // Reads the next entry of a run.
+    auto advance = [&runs, &heads, &queue](size_t index) {
+        if (!runs[index]->next(heads[index])) {
+            isc_throw(RunTimeFail, "Unable to read run file '"
+                      << runs[index]->getFilename() << "' error: "
+                      << runs[index]->getReadMsg());
+        }
+        if (heads[index]) {
+            queue.push(Head(heads[index]->addr_, index));
+        }
+    };
+
+    for (size_t index = 0; index < run_files.size(); ++index) {
+        runs.push_back(boost::shared_ptr<LeaseFileType>(new LeaseFileType(run_files[index])));
+        runs.back()->open();
+        advance(index);
+    }
+
+    lf_output.open();
+    while (!queue.empty()) {
+        Head head = queue.top();
+        queue.pop();
+        LeasePtrType lease = heads[head.second];
+        advance(head.second);
+
+        // Skip the older entries of the same address.
+        while (!queue.empty() && (queue.top().first == head.first)) {
+            size_t index = queue.top().second;
+            queue.pop();
+            advance(index);
+        }
+
+        if (lease->valid_lft_ > 0) {
+            lf_output.append(*lease);
+        }
+    }
+    lf_output.close();
+
+    for (auto const& run : runs) {
+        run->close();
+    }
+}
+
+/// @brief Removes the run files.
+///
+/// @param run_files Names of the run files.
+void
+removeRuns(const std::vector<std::string>& run_files) {
+    for (auto const& name : run_files) {
+        static_cast<void>(remove(name.c_str()));
+    }
+}
+
+/// @brief Merges the entries of the lease files into the output file.
+///
+/// @param filenames Names of the lease files from the oldest.
+/// @param output_file Name of the output file.
+/// @param max_leases Maximum number of entries held in memory.
+/// @param stats Statistics updated with the ones of the files.
+///
+/// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+/// @tparam CSVFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+/// @tparam JournalType A @c LeaseJournal4 or @c LeaseJournal6.
+/// @tparam OutputType The lease file type of the run and output files.
+template<typename LeaseObjectType, typename CSVFileType, typename JournalType,
+         typename OutputType>
+void
+mergeLeaseFiles(const std::vector<std::string>& filenames,
+                const std::string& output_file, const uint32_t max_leases,
+                ReadStats& stats) {
+    MergeRun<LeaseObjectType> run;
+    std::vector<std::string> run_files;
+    OutputType lf_output(output_file);
+    try {
+        for (auto const& filename : filenames) {
+            if (LeaseJournal::isJournal(filename)) {
+                readRuns<LeaseObjectType, JournalType,
+                         OutputType>(filename, max_leases, run, output_file,
+                                     run_files, stats);
+            } else {
+                readRuns<LeaseObjectType, CSVFileType,
+                         OutputType>(filename, max_leases, run, output_file,
+                                     run_files, stats);
+            }
+        }
+
+        LOG_INFO(lfc_logger, LFC_READ_STATS)
+          .arg(stats.leases_)
+          .arg(stats.reads_)
+          .arg(stats.errs_);
+
+        if (run_files.empty()) {
+            // All the entries fit in memory.
+            lf_output.open();
+            for (auto const& entry : run) {
+                if (entry.second->valid_lft_ > 0) {
+                    lf_output.append(*entry.second);
+                }
+            }
+            lf_output.close();
+        } else {
+            if (!run.empty()) {
+                writeRun<LeaseObjectType, OutputType>(run, output_file,
+                                                      run_files);
+            }
+            LOG_INFO(lfc_logger, LFC_MERGING).arg(run_files.size());
+            mergeRuns<LeaseObjectType>(run_files, lf_output);
+        }
+    } catch (...) {
+        removeRuns(run_files);
+        throw;
+    }
+    removeRuns(run_files);
+
+    // If desired log the stats
+    LOG_INFO(lfc_logger, LFC_WRITE_STATS)
+      .arg(lf_output.getWriteLeases())
+      .arg(lf_output.getWrites())
+      .arg(lf_output.getWriteErrs());
+}
+
+} // end of anonymous namespace
+
 /// @brief Defines the application name, it may be used to locate
 /// configuration data and appears in log statements.
 const char* LFCController::lfc_app_name_ = "DhcpLFC";
@@ -49,7 +399,8 @@ const char* LFCController::lfc_bin_name_ = "kea-lfc";
 
 LFCController::LFCController()
     : protocol_version_(0), verbose_(false), config_file_(""), previous_file_(""),
-      copy_file_(""), output_file_(""), finish_file_(""), pid_file_("") {
+      copy_file_(""), output_file_(""), finish_file_(""), pid_file_(""),
+      convert_format_(""), max_leases_(0) {
 }
 
 LFCController::~LFCController() {
@@ -79,6 +430,28 @@ LFCController::launch(int argc, char* argv[], const bool test_mode) {
 
     LOG_INFO(lfc_logger, LFC_START);
 
+    // The conversion of a lease file doesn't interfere with the server
+    // so it doesn't need the pid file and the rotation of the files.
+    if (!convert_format_.empty()) {
+        LOG_INFO(lfc_logger, LFC_CONVERTING)
+          .arg(copy_file_)
+          .arg(convert_format_)
+          .arg(output_file_);
+
+        try {
+            if (getProtocolVersion() == 4) {
+                convertLeases<Lease4, CSVLeaseFile4, LeaseJournal4, Lease4Storage>();
+            } else {
+                convertLeases<Lease6, CSVLeaseFile6, LeaseJournal6, Lease6Storage>();
+            }
+        } catch (const std::exception& proc_ex) {
+            LOG_FATAL(lfc_logger, LFC_FAIL_PROCESS).arg(proc_ex.what());
+        }
+
+        LOG_INFO(lfc_logger, LFC_TERMINATE);
+        return;
+    }
+
     // verify we are the only instance
     PIDFile pid_file(pid_file_);
 
@@ -107,9 +480,9 @@ LFCController::launch(int argc, char* argv[], const bool test_mode) {
 
         try {
             if (getProtocolVersion() == 4) {
-                processLeases<Lease4, CSVLeaseFile4, Lease4Storage>();
+                processLeases<Lease4, CSVLeaseFile4, LeaseJournal4, Lease4Storage>();
             } else {
-                processLeases<Lease6, CSVLeaseFile6, Lease6Storage>();
+                processLeases<Lease6, CSVLeaseFile6, LeaseJournal6, Lease6Storage>();
             }
         } catch (const std::exception& proc_ex) {
             // We don't want to do the cleanup but do want to get rid of the pid
@@ -148,7 +521,7 @@ LFCController::parseArgs(int argc, char* argv[]) {
 
     opterr = 0;
     optind = 1;
-    while ((ch = getopt(argc, argv, ":46dhvVWp:x:i:o:c:f:")) != -1) {
+    while ((ch = getopt(argc, argv, ":46dhvVWp:x:i:o:c:f:C:m:")) != -1) {
         switch (ch) {
         case '4':
             // Process DHCPv4 lease files.
@@ -228,6 +601,39 @@ LFCController::parseArgs(int argc, char* argv[]) {
             config_file_ = optarg;
             break;
 
+        case 'C':
+            // Convert the lease file to the given format.
+            if (optarg == NULL) {
+                isc_throw(InvalidUsage, "Output format missing");
+            }
+            convert_format_ = optarg;
+            if ((convert_format_ != "csv") && (convert_format_ != "binary")) {
+                isc_throw(InvalidUsage, "Unknown output format: "
+                          << convert_format_);
+            }
+            break;
+
+        case 'm': {
+            // Maximum number of leases held in memory.
+            if (optarg == NULL) {
+                isc_throw(InvalidUsage, "Maximum number of leases missing");
+            }
+            int64_t max_leases = 0;
+            try {
+                max_leases = boost::lexical_cast<int64_t>(optarg);
+            } catch (const boost::bad_lexical_cast&) {
+                isc_throw(InvalidUsage, "Invalid maximum number of leases: "
+                          << optarg);
+            }
+            if ((max_leases <= 0) ||
+                (max_leases > std::numeric_limits<uint32_t>::max())) {
+                isc_throw(InvalidUsage, "Invalid maximum number of leases: "
+                          << optarg);
+            }
+            max_leases_ = static_cast<uint32_t>(max_leases);
+            break;
+        }
+
         case 'h':
             usage("");
             exit(EXIT_SUCCESS);
@@ -257,14 +663,6 @@ LFCController::parseArgs(int argc, char* argv[]) {
         isc_throw(InvalidUsage, "DHCP version required");
     }
 
-    if (pid_file_.empty()) {
-        isc_throw(InvalidUsage, "PID file not specified");
-    }
-
-    if (previous_file_.empty()) {
-        isc_throw(InvalidUsage, "Previous file not specified");
-    }
-
     if (copy_file_.empty()) {
         isc_throw(InvalidUsage, "Copy file not specified");
     }
@@ -273,6 +671,26 @@ LFCController::parseArgs(int argc, char* argv[]) {
         isc_throw(InvalidUsage, "Output file not specified");
     }
 
+    // The conversion only uses the input and output files.
+    if (!convert_format_.empty()) {
+        if (verbose_) {
+            std::cout << "Protocol version:    DHCPv" << protocol_version_ << std::endl
+                      << "Input lease file:          " << copy_file_ << std::endl
+                      << "Output lease file:         " << output_file_ << std::endl
+                      << "Output format:             " << convert_format_ << std::endl
+                      << std::endl;
+        }
+        return;
+    }
+
+    if (pid_file_.empty()) {
+        isc_throw(InvalidUsage, "PID file not specified");
+    }
+
+    if (previous_file_.empty()) {
+        isc_throw(InvalidUsage, "Previous file not specified");
+    }
+
     if (finish_file_.empty()) {
         isc_throw(InvalidUsage, "Finish file not specified");
     }
@@ -289,8 +707,11 @@ LFCController::parseArgs(int argc, char* argv[]) {
                   << "Output lease file:         " << output_file_ << std::endl
                   << "Finish file:               " << finish_file_ << std::endl
                   << "Config file:               " << config_file_ << std::endl
-                  << "PID file:                  " << pid_file_ << std::endl
-                  << std::endl;
+                  << "PID file:                  " << pid_file_ << std::endl;
+        if (max_leases_ > 0) {
+            std::cout << "Max leases in memory:      " << max_leases_ << std::endl;
+        }
+        std::cout << std::endl;
     }
 }
 
@@ -301,7 +722,9 @@ LFCController::usage(const std::string& text) {
     }
 
     std::cerr << "Usage: " << lfc_bin_name_ << std::endl
-              << " [-4|-6] -p file -x file -i file -o file -f file -c file" << std::endl
+              << " [-4|-6] -p file -x file -i file -o file -f file -c file"
+              << " [-m leases]" << std::endl
+              << " [-4|-6] -C csv|binary -i file -o file" << std::endl
               << "   -4 or -6 clean a set of v4 or v6 lease files" << std::endl
               << "   -p <file>: PID file" << std::endl
               << "   -x <file>: previous or ex lease file" << std::endl
@@ -309,6 +732,10 @@ LFCController::usage(const std::string& text) {
               << "   -o <file>: output lease file" << std::endl
               << "   -f <file>: finish file" << std::endl
               << "   -c <file>: configuration file" << std::endl
+              << "   -m <leases>: merge sorted runs of at most this number"
+              << " of leases instead of loading all the leases" << std::endl
+              << "   -C <format>: convert the lease file given with -i to the"
+              << " format in the output file" << std::endl
               << "   -v: print version number and exit" << std::endl
               << "   -V: print extended version information and exit" << std::endl
               << "   -d: optional, verbose output " << std::endl
@@ -339,39 +766,42 @@ LFCController::getVersion(const bool extended) const{
     return (version_stream.str());
 }
 
-template<typename LeaseObjectType, typename LeaseFileType, typename StorageType>
+template<typename LeaseObjectType, typename CSVFileType, typename JournalType,
+         typename StorageType>
 void
 LFCController::processLeases() const {
+    if (max_leases_ > 0) {
+        mergeLeases<LeaseObjectType, CSVFileType, JournalType>();
+        return;
+    }
+
     StorageType storage;
+    ReadStats stats;
 
     // If a previous file exists read the entries into storage
-    LeaseFileType lf_prev(getPreviousFile());
-    if (lf_prev.exists()) {
-        LeaseFileLoader::load<LeaseObjectType>(lf_prev, storage,
-                                               MAX_LEASE_ERRORS);
-    }
+    bool binary = loadLeases<LeaseObjectType, CSVFileType,
+                             JournalType>(getPreviousFile(), storage, stats);
 
-    // Follow that with the copy of the current lease file
-    LeaseFileType lf_copy(getCopyFile());
+    // Follow that with the copy of the current lease file. The output
+    // file has the format of the current lease file when it exists.
+    CSVFile lf_copy(getCopyFile());
     if (lf_copy.exists()) {
-        LeaseFileLoader::load<LeaseObjectType>(lf_copy, storage,
-                                               MAX_LEASE_ERRORS);
+        binary = loadLeases<LeaseObjectType, CSVFileType,
+                            JournalType>(getCopyFile(), storage, stats);
     }
 
-    // Write the result out to the output file
-    LeaseFileType lf_output(getOutputFile());
-    LeaseFileLoader::write<LeaseObjectType>(lf_output, storage);
-
     // If desired log the stats
     LOG_INFO(lfc_logger, LFC_READ_STATS)
-      .arg(lf_prev.getReadLeases() + lf_copy.getReadLeases())
-      .arg(lf_prev.getReads() + lf_copy.getReads())
-      .arg(lf_prev.getReadErrs() + lf_copy.getReadErrs());
+      .arg(stats.leases_)
+      .arg(stats.reads_)
+      .arg(stats.errs_);
 
-    LOG_INFO(lfc_logger, LFC_WRITE_STATS)
-      .arg(lf_output.getWriteLeases())
-      .arg(lf_output.getWrites())
-      .arg(lf_output.getWriteErrs());
+    // Write the result out to the output file
+    if (binary) {
+        writeLeaseFile<LeaseObjectType, JournalType>(getOutputFile(), storage);
+    } else {
+        writeLeaseFile<LeaseObjectType, CSVFileType>(getOutputFile(), storage);
+    }
 
     // Once we've finished the output file move it to the complete file
     if (rename(getOutputFile().c_str(), getFinishFile().c_str()) != 0) {
@@ -381,6 +811,72 @@ LFCController::processLeases() const {
     }
 }
 
+template<typename LeaseObjectType, typename CSVFileType, typename JournalType>
+void
+LFCController::mergeLeases() const {
+    std::vector<std::string> filenames;
+    filenames.push_back(getPreviousFile());
+    filenames.push_back(getCopyFile());
+
+    // The output file has the format of the current lease file when it
+    // exists.
+    CSVFile lf_copy(getCopyFile());
+    bool binary = LeaseJournal::isJournal(lf_copy.exists() ? getCopyFile() :
+                                          getPreviousFile());
+
+    ReadStats stats;
+    if (binary) {
+        mergeLeaseFiles<LeaseObjectType, CSVFileType, JournalType,
+                        JournalType>(filenames, getOutputFile(),
+                                     max_leases_, stats);
+    } else {
+        mergeLeaseFiles<LeaseObjectType, CSVFileType, JournalType,
+                        CSVFileType>(filenames, getOutputFile(),
+                                     max_leases_, stats);
+    }
+
+    // Once we've finished the output file move it to the complete file
+    if (rename(getOutputFile().c_str(), getFinishFile().c_str()) != 0) {
+        isc_throw(RunTimeFail, "Unable to move output (" << output_file_
+                  << ") to complete (" << finish_file_
+                  << ") error: " << strerror(errno));
+    }
+}
+
+template<typename LeaseObjectType, typename CSVFileType, typename JournalType,
+         typename StorageType>
+void
+LFCController::convertLeases() const {
+    CSVFile lf_input(getCopyFile());
+    if (!lf_input.exists()) {
+        isc_throw(RunTimeFail, "Input file (" << copy_file_
+                  << ") does not exist");
+    }
+
+    // Leases would be appended to an existing output file.
+    CSVFile lf_output(getOutputFile());
+    if (lf_output.exists()) {
+        isc_throw(RunTimeFail, "Output file (" << output_file_
+                  << ") already exists");
+    }
+
+    StorageType storage;
+    ReadStats stats;
+    loadLeases<LeaseObjectType, CSVFileType,
+               JournalType>(getCopyFile(), storage, stats);
+
+    LOG_INFO(lfc_logger, LFC_READ_STATS)
+      .arg(stats.leases_)
+      .arg(stats.reads_)
+      .arg(stats.errs_);
+
+    if (convert_format_ == "binary") {
+        writeLeaseFile<LeaseObjectType, JournalType>(getOutputFile(), storage);
+    } else {
+        writeLeaseFile<LeaseObjectType, CSVFileType>(getOutputFile(), storage);
+    }
+}
+
 void
 LFCController::fileRotate() const {
     // Remove the old previous file
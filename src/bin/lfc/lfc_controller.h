@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2018 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -150,6 +150,22 @@ public:
     std::string getPidFile() const {
         return (pid_file_);
     }
+
+    /// @brief Gets the format of the converted lease file
+    ///
+    /// @return Returns "csv" or "binary" when converting a lease file
+    /// or an empty string otherwise
+    std::string getConvertFormat() const {
+        return (convert_format_);
+    }
+
+    /// @brief Gets the maximum number of leases held in memory
+    ///
+    /// @return Returns the value given with -m or 0 when all the leases
+    /// are loaded into memory
+    uint32_t getMaxLeases() const {
+        return (max_leases_);
+    }
     //@}
 
 private:
@@ -163,6 +179,8 @@ private:
     std::string output_file_;   ///< The path to the output file
     std::string finish_file_;   ///< The path to the finished output file
     std::string pid_file_;      ///< The path to the pid file
+    std::string convert_format_; ///< The format of the converted file (if any)
+    uint32_t max_leases_;       ///< The maximum number of leases in memory (if any)
 
     /// @brief Prints the program usage text to std error.
     ///
@@ -182,14 +200,60 @@ private:
     /// write the results out to the output file.  Upon completion of
     /// the write move the file to the finish file.
     ///
+    /// The files may be CSV lease files or lease journals. The output
+    /// file has the format of the copy file or of the previous file when
+    /// there is no copy file.
+    ///
+    /// When the maximum number of leases held in memory is set the files
+    /// are merged by @c mergeLeases instead of being loaded into memory.
+    ///
     /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
-    /// @tparam LeaseFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam CSVFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam JournalType A @c LeaseJournal4 or @c LeaseJournal6.
     /// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
     ///
     /// @throw RunTimeFail if we can't move the file.
-    template<typename LeaseObjectType, typename LeaseFileType, typename StorageType>
+    template<typename LeaseObjectType, typename CSVFileType,
+             typename JournalType, typename StorageType>
     void processLeases() const;
 
+    /// @brief Merge files.
+    ///
+    /// Read the entries of the previous & copy files in sorted runs of
+    /// at most the maximum number of leases held in memory and merge
+    /// the runs into the output file. The memory used doesn't depend on
+    /// the number of leases in the files.
+    ///
+    /// The runs are written to temporary files next to the output file
+    /// which are removed after the merge. When all the entries fit in
+    /// one run it is written directly to the output file.
+    ///
+    /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+    /// @tparam CSVFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam JournalType A @c LeaseJournal4 or @c LeaseJournal6.
+    ///
+    /// @throw RunTimeFail if a run can't be written or read back.
+    template<typename LeaseObjectType, typename CSVFileType,
+             typename JournalType>
+    void mergeLeases() const;
+
+    /// @brief Convert a lease file.
+    ///
+    /// Read in the leases from the copy file, which may be a CSV lease
+    /// file or a lease journal, and write them to the output file in the
+    /// format given by the -C option.
+    ///
+    /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+    /// @tparam CSVFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam JournalType A @c LeaseJournal4 or @c LeaseJournal6.
+    /// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
+    ///
+    /// @throw RunTimeFail if the input file doesn't exist or the output
+    /// file exists.
+    template<typename LeaseObjectType, typename CSVFileType,
+             typename JournalType, typename StorageType>
+    void convertLeases() const;
+
     ///@brief Start up the logging system
     ///
     /// @param test_mode indicates if we have have been started from the test
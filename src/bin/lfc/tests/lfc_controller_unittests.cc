@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,11 +7,13 @@
 #include <config.h>
 
 #include <lfc/lfc_controller.h>
+#include <dhcpsrv/lease_journal.h>
 #include <util/csv_file.h>
 #include <gtest/gtest.h>
 #include <fstream>
 #include <cerrno>
 
+using namespace isc::dhcp;
 using namespace isc::lfc;
 using namespace std;
 
@@ -146,6 +148,7 @@ TEST_F(LFCControllerTest, initialValues) {
     EXPECT_TRUE(lfc_controller.getOutputFile().empty());
     EXPECT_TRUE(lfc_controller.getFinishFile().empty());
     EXPECT_TRUE(lfc_controller.getPidFile().empty());
+    EXPECT_TRUE(lfc_controller.getConvertFormat().empty());
 }
 
 /// @todo verify that parsing -v/V/W/h works well without ASSERT_EXIT
@@ -185,6 +188,35 @@ TEST_F(LFCControllerTest, fullCommandLine) {
     EXPECT_EQ(lfc_controller.getPidFile(), "pid");
 }
 
+/// @brief Verify that parsing a conversion command line works.
+/// The conversion only requires the input and output files.
+TEST_F(LFCControllerTest, convertCommandLine) {
+    LFCController lfc_controller;
+
+    char* argv[] = { const_cast<char*>("progName"),
+                     const_cast<char*>("-6"),
+                     const_cast<char*>("-C"),
+                     const_cast<char*>("binary"),
+                     const_cast<char*>("-i"),
+                     const_cast<char*>("copy"),
+                     const_cast<char*>("-o"),
+                     const_cast<char*>("output") };
+    int argc = 8;
+
+    ASSERT_NO_THROW(lfc_controller.parseArgs(argc, argv));
+    EXPECT_EQ(lfc_controller.getProtocolVersion(), 6);
+    EXPECT_EQ(lfc_controller.getConvertFormat(), "binary");
+    EXPECT_EQ(lfc_controller.getCopyFile(), "copy");
+    EXPECT_EQ(lfc_controller.getOutputFile(), "output");
+
+    // The output file is required.
+    EXPECT_THROW(lfc_controller.parseArgs(6, argv), InvalidUsage);
+
+    // The format must be known.
+    argv[3] = const_cast<char*>("xml");
+    EXPECT_THROW(lfc_controller.parseArgs(argc, argv), InvalidUsage);
+}
+
 /// @brief Verify that parsing a correct but incomplete line fails.
 /// Parse a command line that is correctly formatted but isn't complete
 /// (doesn't include some options or an some option arguments).  We
@@ -671,6 +703,168 @@ TEST_F(LFCControllerTest, launch6) {
     EXPECT_TRUE(noExistIOFP());
 }
 
+/// @brief Verify that lease files are converted between the formats
+/// and that the lease journals are cleaned up.
+///
+/// A CSV file is converted to a lease journal and back. Then a CSV
+/// previous file is combined with a lease journal copy file and the
+/// result must be a lease journal.
+TEST_F(LFCControllerTest, launchJournal4) {
+    LFCController lfc_controller;
+
+    char* convert_argv[] = { const_cast<char*>("progName"),
+                             const_cast<char*>("-4"),
+                             const_cast<char*>("-C"),
+                             const_cast<char*>("binary"),
+                             const_cast<char*>("-i"),
+                             const_cast<char*>(fstr_.c_str()),
+                             const_cast<char*>("-o"),
+                             const_cast<char*>(istr_.c_str()) };
+    int convert_argc = 8;
+
+    char* argv[] = { const_cast<char*>("progName"),
+                     const_cast<char*>("-4"),
+                     const_cast<char*>("-x"),
+                     const_cast<char*>(xstr_.c_str()),
+                     const_cast<char*>("-i"),
+                     const_cast<char*>(istr_.c_str()),
+                     const_cast<char*>("-o"),
+                     const_cast<char*>(ostr_.c_str()),
+                     const_cast<char*>("-c"),
+                     const_cast<char*>(cstr_.c_str()),
+                     const_cast<char*>("-f"),
+                     const_cast<char*>(fstr_.c_str()),
+                     const_cast<char*>("-p"),
+                     const_cast<char*>(pstr_.c_str()) };
+    int argc = 14;
+    string test_str;
+
+    string a_1 = "192.0.2.1,06:07:08:09:0a:bc,,"
+                 "200,200,8,1,1,host.example.com,1,\n";
+    string a_3 = "192.0.2.1,06:07:08:09:0a:bc,,"
+                 "200,800,8,1,1,host.example.com,1,{ \"foo\": true }\n";
+    string b_1 = "192.0.3.15,dd:de:ba:0d:1b:2e:3e:4f,0a:00:01:04,"
+                 "100,100,7,0,0,,1,{ \"bar\": false }\n";
+    string b_3 = "192.0.3.15,dd:de:ba:0d:1b:2e:3e:4f,0a:00:01:04,"
+                 "100,150,7,0,0,,1,\n";
+
+    // Subtest 1: convert a CSV file to a lease journal and back.
+    writeFile(fstr_, v4_hdr_ + a_3 + b_3);
+    launch(lfc_controller, convert_argc, convert_argv);
+    EXPECT_TRUE(LeaseJournal::isJournal(istr_));
+
+    // The output file must not exist.
+    launch(lfc_controller, convert_argc, convert_argv);
+    EXPECT_TRUE(LeaseJournal::isJournal(istr_));
+
+    convert_argv[3] = const_cast<char*>("csv");
+    convert_argv[5] = const_cast<char*>(istr_.c_str());
+    convert_argv[7] = const_cast<char*>(ostr_.c_str());
+    ASSERT_TRUE(noExist(fstr_));
+    launch(lfc_controller, convert_argc, convert_argv);
+    EXPECT_EQ(readFile(ostr_), v4_hdr_ + a_3 + b_3);
+    ASSERT_TRUE(noExist(ostr_));
+
+    // Subtest 2: a CSV previous file and a lease journal copy file.
+    test_str = v4_hdr_ + a_1 + b_1;
+    writeFile(xstr_, test_str);
+
+    // Run the cleanup
+    launch(lfc_controller, argc, argv);
+
+    // The previous file was replaced by a lease journal holding the last
+    // lease for each ip.
+    EXPECT_TRUE(LeaseJournal::isJournal(xstr_));
+    EXPECT_TRUE(noExistIOFP());
+
+    convert_argv[5] = const_cast<char*>(xstr_.c_str());
+    launch(lfc_controller, convert_argc, convert_argv);
+    EXPECT_EQ(readFile(ostr_), v4_hdr_ + a_3 + b_3);
+}
+
+/// @brief Verify that the lease files are merged in sorted runs.
+///
+/// The maximum number of leases held in memory is set to 1 so each
+/// entry is written to its own run. The result must be the same as
+/// when all the leases are loaded into memory.
+TEST_F(LFCControllerTest, launchMerge4) {
+    LFCController lfc_controller;
+
+    char* argv[] = { const_cast<char*>("progName"),
+                     const_cast<char*>("-4"),
+                     const_cast<char*>("-x"),
+                     const_cast<char*>(xstr_.c_str()),
+                     const_cast<char*>("-i"),
+                     const_cast<char*>(istr_.c_str()),
+                     const_cast<char*>("-o"),
+                     const_cast<char*>(ostr_.c_str()),
+                     const_cast<char*>("-c"),
+                     const_cast<char*>(cstr_.c_str()),
+                     const_cast<char*>("-f"),
+                     const_cast<char*>(fstr_.c_str()),
+                     const_cast<char*>("-p"),
+                     const_cast<char*>(pstr_.c_str()),
+                     const_cast<char*>("-m"),
+                     const_cast<char*>("1") };
+    int argc = 16;
+    string test_str;
+
+    string a_1 = "192.0.2.1,06:07:08:09:0a:bc,,"
+                 "200,200,8,1,1,host.example.com,1,\n";
+    string a_2 = "192.0.2.1,06:07:08:09:0a:bc,,"
+                 "200,500,8,1,1,host.example.com,1,\n";
+    string a_3 = "192.0.2.1,06:07:08:09:0a:bc,,"
+                 "200,800,8,1,1,host.example.com,1,{ \"foo\": true }\n";
+
+    string b_1 = "192.0.3.15,dd:de:ba:0d:1b:2e:3e:4f,0a:00:01:04,"
+                 "100,100,7,0,0,,1,{ \"bar\": false }\n";
+    string b_2 = "192.0.3.15,dd:de:ba:0d:1b:2e:3e:4f,0a:00:01:04,"
+                 "100,135,7,0,0,,1,\n";
+    string b_3 = "192.0.3.15,dd:de:ba:0d:1b:2e:3e:4f,0a:00:01:04,"
+                 "100,150,7,0,0,,1,\n";
+
+    string d_1 = "192.0.2.5,16:17:18:19:1a:bc,,"
+                 "200,200,8,1,1,host.example.com,1,\n";
+    string d_2 = "192.0.2.5,16:17:18:19:1a:bc,,"
+                 "0,200,8,1,1,host.example.com,1,\n";
+
+    ASSERT_NO_THROW(lfc_controller.parseArgs(argc, argv));
+    EXPECT_EQ(1U, lfc_controller.getMaxLeases());
+
+    // Subtest 1: both previous and copy available, D is removed by
+    // the copy file.
+    test_str = v4_hdr_ + a_1 + b_1 + b_2 + a_2 + d_1;
+    writeFile(xstr_, test_str);
+    test_str = v4_hdr_ + a_3 + b_3 + d_2;
+    writeFile(istr_, test_str);
+
+    launch(lfc_controller, argc, argv);
+
+    test_str = v4_hdr_ + a_3 + b_3;
+    EXPECT_EQ(readFile(xstr_), test_str);
+    EXPECT_TRUE(noExistIOFP());
+    EXPECT_TRUE(noExist(ostr_ + ".run0"));
+    removeTestFile();
+
+    // Subtest 2: all the entries fit in one run.
+    argv[15] = const_cast<char*>("10");
+    test_str = v4_hdr_ + d_1 + a_1 + b_1 + b_3 + d_2 + a_3;
+    writeFile(istr_, test_str);
+
+    launch(lfc_controller, argc, argv);
+
+    test_str = v4_hdr_ + a_3 + b_3;
+    EXPECT_EQ(readFile(xstr_), test_str);
+    EXPECT_TRUE(noExistIOFP());
+    removeTestFile();
+
+    // Subtest 3: the maximum must be a positive number.
+    argv[15] = const_cast<char*>("0");
+    EXPECT_THROW(lfc_controller.parseArgs(argc, argv), InvalidUsage);
+    argv[15] = const_cast<char*>("many");
+    EXPECT_THROW(lfc_controller.parseArgs(argc, argv), InvalidUsage);
+}
+
 // @todo double launch (how to do that)
 
 } // end of anonymous namespace
@@ -0,0 +1,234 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <kea_version.h>
+
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/lease_migrator.h>
+#include <exceptions/exceptions.h>
+#include <log/logger_manager.h>
+#include <log/logger_name.h>
+#include <log/logger_support.h>
+#include <util/multi_threading_mgr.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+using namespace std;
+using namespace isc;
+using namespace isc::dhcp;
+using namespace isc::log;
+using namespace isc::util;
+
+/// This file contains the entry point (main() function) for the lease
+/// migration tool, kea-lease-migrate, component of the Kea software suite.
+/// It copies the leases from one lease database to another, e.g. from
+/// the memfile backend to PostgreSQL, reading the source by pages and
+/// adding the leases to the destination in parallel transactions.
+/// The exit value of the program will be EXIT_SUCCESS if there were no
+/// errors, EXIT_FAILURE otherwise.
+
+namespace {
+
+/// @brief Defines the application name used in the log messages.
+const char* MIGRATE_APP_NAME = "KeaLeaseMigrate";
+
+/// @brief Defines the executable name.
+const char* MIGRATE_BIN_NAME = "kea-lease-migrate";
+
+/// @brief Prints the usage text.
+///
+/// @param text Error text printed before the usage or an empty string.
+void
+usage(const string& text) {
+    if (!text.empty()) {
+        cerr << "Usage error: " << text << endl;
+    }
+
+    cerr << "Usage: " << MIGRATE_BIN_NAME << endl
+         << " -4|-6 -i access -o access [-p leases] [-t threads] [-d]"
+         << endl
+         << "   -4 or -6 migrate the v4 or v6 leases" << endl
+         << "   -i <access>: database access string of the source,"
+         << " e.g. \"type=memfile name=/var/lib/kea/kea-leases4.csv\""
+         << endl
+         << "   -o <access>: database access string of the destination,"
+         << " e.g. \"type=postgresql name=kea user=kea password=kea\""
+         << endl
+         << "   -p <leases>: number of leases read from the source at once"
+         << " (default " << LeaseMigrator::DEFAULT_PAGE_SIZE << ")" << endl
+         << "   -t <threads>: number of threads adding the leases to the"
+         << " destination (default 1)" << endl
+         << "   -v: print version number and exit" << endl
+         << "   -V: print extended version information and exit" << endl
+         << "   -d: optional, verbose output " << endl
+         << "   -h: print this message " << endl
+         << endl;
+}
+
+/// @brief Parses a positive number given on the command line.
+///
+/// @param name Name of the value used in the error message.
+/// @param text The text to parse.
+/// @return The number.
+/// @throw InvalidParameter if the text is not a positive number.
+size_t
+parsePositive(const string& name, const char* text) {
+    try {
+        int64_t value = boost::lexical_cast<int64_t>(text);
+        if (value > 0) {
+            return (static_cast<size_t>(value));
+        }
+    } catch (const boost::bad_lexical_cast&) {
+    }
+    isc_throw(InvalidParameter, name << " must be a positive number: "
+              << text);
+}
+
+/// @brief Starts the logging system on the console.
+///
+/// @param verbose Log at the debug level when true.
+void
+startLogger(const bool verbose) {
+    initLogger(MIGRATE_APP_NAME, INFO, 0, NULL, false);
+
+    LoggerSpecification spec(getRootLoggerName(),
+                             verbose ? keaLoggerSeverity(DEBUG) :
+                                       keaLoggerSeverity(INFO),
+                             verbose ? keaLoggerDbglevel(MAX_DEBUG_LEVEL) :
+                                       keaLoggerDbglevel(0));
+    OutputOption option;
+    option.destination = OutputOption::DEST_CONSOLE;
+    spec.addOutputOption(option);
+
+    LoggerManager manager;
+    manager.process(spec);
+}
+
+} // end of anonymous namespace
+
+int
+main(int argc, char* argv[]) {
+    uint16_t universe = 0;
+    string source_access;
+    string destination_access;
+    size_t page_size = LeaseMigrator::DEFAULT_PAGE_SIZE;
+    size_t thread_count = 1;
+    bool verbose = false;
+
+    try {
+        int ch;
+        opterr = 0;
+        optind = 1;
+        while ((ch = getopt(argc, argv, ":46dhvVi:o:p:t:")) != -1) {
+            switch (ch) {
+            case '4':
+                universe = 4;
+                break;
+
+            case '6':
+                universe = 6;
+                break;
+
+            case 'd':
+                verbose = true;
+                break;
+
+            case 'h':
+                usage("");
+                return (EXIT_SUCCESS);
+
+            case 'v':
+                cout << VERSION << endl;
+                return (EXIT_SUCCESS);
+
+            case 'V':
+                cout << VERSION << endl << EXTENDED_VERSION << endl;
+                return (EXIT_SUCCESS);
+
+            case 'i':
+                source_access = optarg;
+                break;
+
+            case 'o':
+                destination_access = optarg;
+                break;
+
+            case 'p':
+                page_size = parsePositive("page size", optarg);
+                break;
+
+            case 't':
+                thread_count = parsePositive("thread count", optarg);
+                break;
+
+            case ':':
+                isc_throw(InvalidParameter, "Missing option argument");
+
+            default:
+                isc_throw(InvalidParameter, "Unknown argument");
+            }
+        }
+
+        if (argc > optind) {
+            isc_throw(InvalidParameter, "Extraneous parameters.");
+        }
+        if (universe == 0) {
+            isc_throw(InvalidParameter, "DHCP version required");
+        }
+        if (source_access.empty()) {
+            isc_throw(InvalidParameter, "Source database access string required");
+        }
+        if (destination_access.empty()) {
+            isc_throw(InvalidParameter, "Destination database access string"
+                      " required");
+        }
+    } catch (const std::exception& ex) {
+        usage(ex.what());
+        return (EXIT_FAILURE);
+    }
+
+    try {
+        startLogger(verbose);
+
+        // The destination is shared by the threads adding the leases.
+        // The multi-threading mode must be set before the lease managers
+        // are created.
+        if (thread_count > 1) {
+            MultiThreadingMgr::instance().setMode(true);
+        }
+
+        // The memfile and LMDB backends take the DHCP version from the
+        // access string, as the servers do.
+        std::ostringstream prefix;
+        prefix << "universe=" << universe << " ";
+        TrackingLeaseMgrPtr source =
+            LeaseMgrFactory::createLeaseMgr(prefix.str() + source_access);
+        TrackingLeaseMgrPtr destination =
+            LeaseMgrFactory::createLeaseMgr(prefix.str() + destination_access);
+
+        LeaseMigrator migrator(*source, *destination, page_size, thread_count);
+        if (universe == 4) {
+            migrator.migrate4();
+        } else {
+            migrator.migrate6();
+        }
+
+        cout << migrator.getReadLeases() << " leases read, "
+             << migrator.getAddedLeases() << " leases added" << endl;
+    } catch (const std::exception& ex) {
+        cerr << MIGRATE_BIN_NAME << ": lease migration failed: "
+             << ex.what() << endl;
+        return (EXIT_FAILURE);
+    }
+
+    return (EXIT_SUCCESS);
+}
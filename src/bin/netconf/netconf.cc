@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -16,6 +16,9 @@
 #include <yang/translator_config.h>
 #include <yang/yang_revisions.h>
 
+#include <map>
+#include <mutex>
+#include <set>
 #include <sstream>
 #include <vector>
 
@@ -29,6 +32,71 @@ using namespace sysrepo;
 
 namespace {
 
+/// @brief The last configurations applied to the servers.
+///
+/// They are the base of the incremental translations of the changes of
+/// subnet entries.
+map<string, ConstElementPtr> applied_configs;
+
+/// @brief Protects the last applied configurations.
+mutex applied_configs_mutex;
+
+/// @brief Get the last configuration applied to a server.
+///
+/// @param server The server name.
+/// @return The configuration or null when not known.
+ConstElementPtr
+getAppliedConfig(string const& server) {
+    lock_guard<mutex> lock(applied_configs_mutex);
+    auto const it = applied_configs.find(server);
+    if (it == applied_configs.end()) {
+        return (ConstElementPtr());
+    }
+    return (it->second);
+}
+
+/// @brief Set or forget the last configuration applied to a server.
+///
+/// @param server The server name.
+/// @param config The configuration, null to forget it.
+void
+setAppliedConfig(string const& server, ConstElementPtr config) {
+    lock_guard<mutex> lock(applied_configs_mutex);
+    if (config) {
+        applied_configs[server] = config;
+    } else {
+        applied_configs.erase(server);
+    }
+}
+
+/// @brief Get the subnet entries holding the changes.
+///
+/// @param sess The running datastore session.
+/// @param model The model name.
+/// @param xpaths Filled with the xpaths of the changed subnet entries.
+/// @return true if all changes are in subnet entries, false if the whole
+/// datastore must be translated.
+bool
+getChangedSubnets(Session sess, string const& model, set<string>& xpaths) {
+    ostringstream stream;
+    stream << "/" << model << ":*//.";
+    ChangeCollection const changes(sess.getChanges(stream.str()));
+    for (Change const& change : changes) {
+        // The order of the subnets does not matter but the translation
+        // of the moved user ordered entries is not worth it.
+        if (change.operation == sysrepo::ChangeOperation::Moved) {
+            return (false);
+        }
+        string xpath;
+        if (!TranslatorConfig::getSubnetXpath(model, change.node.path(),
+                                              xpath)) {
+            return (false);
+        }
+        xpaths.insert(xpath);
+    }
+    return (!xpaths.empty());
+}
+
 /// @brief Module change subscription callback.
 class NetconfAgentCallback {
 public:
@@ -177,6 +245,10 @@ NetconfAgent::init(NetconfCfgMgrPtr cfg_mgr) {
 void
 NetconfAgent::clear() {
     subscriptions_.clear();
+    {
+        lock_guard<mutex> lock(applied_configs_mutex);
+        applied_configs.clear();
+    }
     running_sess_.reset();
     startup_sess_.reset();
 }
@@ -522,8 +594,7 @@ NetconfAgent::change(Session sess, const CfgServersMapPair& service_pair) {
         .arg(server);
     ElementPtr config;
     try {
-        TranslatorConfig tc(sess, configuration->getModel());
-        config = tc.getConfig();
+        config = getConfig(sess, service_pair, getAppliedConfig(server));
         if (!config) {
             ostringstream msg;
             msg << "YANG configuration for "
@@ -605,11 +676,15 @@ NetconfAgent::done(Session sess, const CfgServersMapPair& service_pair) {
     LOG_INFO(netconf_logger, NETCONF_UPDATE_CONFIG_STARTED)
         .arg(server);
 
+    // The last applied configuration is forgotten until the new one is
+    // applied.
+    ConstElementPtr applied = getAppliedConfig(server);
+    setAppliedConfig(server, ConstElementPtr());
+
     // Retrieve the configuration from SYSREPO first.
     ElementPtr config;
     try {
-        TranslatorConfig tc(sess, configuration->getModel());
-        config = tc.getConfig();
+        config = getConfig(sess, service_pair, applied);
         if (!config) {
             ostringstream msg;
             msg << "YANG configuration for "
@@ -673,11 +748,32 @@ NetconfAgent::done(Session sess, const CfgServersMapPair& service_pair) {
             .arg(msg.str());
         return (sysrepo::ErrorCode::ValidationFailed);
     }
+    setAppliedConfig(server, config);
     LOG_INFO(netconf_logger, NETCONF_UPDATE_CONFIG_COMPLETED)
         .arg(server);
     return (sysrepo::ErrorCode::Ok);
 }
 
+ElementPtr
+NetconfAgent::getConfig(Session sess, const CfgServersMapPair& service_pair,
+                        ConstElementPtr applied) {
+    string const& server(service_pair.first);
+    string const& model(service_pair.second->getModel());
+    TranslatorConfig tc(sess, model);
+    set<string> xpaths;
+    if (applied && getChangedSubnets(sess, model, xpaths)) {
+        ElementPtr config = tc.updateSubnets(applied, xpaths);
+        if (config) {
+            LOG_DEBUG(netconf_logger, NETCONF_DBG_TRACE,
+                      NETCONF_GET_CONFIG_INCREMENTAL)
+                .arg(server)
+                .arg(xpaths.size());
+            return (config);
+        }
+    }
+    return (tc.getConfig());
+}
+
 void
 NetconfAgent::logChanges(Session sess, string_view const& model) {
     ostringstream stream;
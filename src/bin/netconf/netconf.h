@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -93,6 +93,22 @@ public:
     /// @param model The model name.
     static void logChanges(sysrepo::Session sess, std::string_view const& model);
 
+    /// @brief Get the Kea configuration from the YANG datastore.
+    ///
+    /// When the last configuration applied to the server is given and
+    /// only subnet entries were changed, only these subnets are
+    /// translated and patched into the last configuration. Otherwise the
+    /// whole datastore is translated.
+    ///
+    /// @param sess The sysrepo running datastore session.
+    /// @param service_pair The service name and configuration pair.
+    /// @param applied The last configuration applied to the server or null.
+    /// @return The JSON configuration.
+    /// @throw NetconfError when sysrepo raises an error.
+    static isc::data::ElementPtr
+    getConfig(sysrepo::Session sess, const CfgServersMapPair& service_pair,
+              isc::data::ConstElementPtr applied);
+
 protected:
     /// @brief Get and display Kea server configuration.
     ///
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -45,6 +45,25 @@ public:
     /// \return execution status.
     int run() override;
 
+    /// \brief Sends and receives the packets until the exit conditions.
+    ///
+    /// This is the first part of \ref run. With several sender threads
+    /// each thread runs it with its own options and socket.
+    void runTraffic();
+
+    /// \brief Prints the statistics and the requested diagnostics.
+    ///
+    /// This is the second part of \ref run. With several sender threads
+    /// it is called once the statistics of the threads are merged.
+    ///
+    /// \return execution status.
+    int report();
+
+    /// \brief Returns the test control.
+    ///
+    /// \return the object controlling sending and receiving packets.
+    TestControl& getTestControl() { return (tc_); }
+
 protected:
     /// \brief A rate control class for Discover and Solicit messages.
     RateControl basic_rate_control_;
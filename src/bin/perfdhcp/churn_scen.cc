@@ -0,0 +1,195 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <perfdhcp/churn_scen.h>
+
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+using namespace std;
+using namespace boost::posix_time;
+using namespace isc;
+using namespace isc::dhcp;
+
+
+namespace isc {
+namespace perfdhcp {
+
+ChurnScen::ChurnScen(CommandOptions& options, BasePerfSocket &socket)
+    : AvalancheScen(options, socket), storm_sent_(4, 0) {
+    storm_rate_control_.setRate(options_.getRate());
+}
+
+void
+ChurnScen::acquireLeases(uint32_t clients_num) {
+    // The leases are acquired as in the avalanche scenario: the packets
+    // without responses are resent with a back off until all clients
+    // have their lease.
+    tc_.sendPackets(clients_num);
+
+    auto prev_cycle_time = microsec_clock::universal_time();
+    while (!tc_.interrupted()) {
+        tc_.consumeReceivedPackets();
+
+        usleep(100);
+
+        auto now = microsec_clock::universal_time();
+        if (now - prev_cycle_time > milliseconds(200)) {
+            prev_cycle_time = now;
+            int still_left_cnt = resendPackets(stage1_xchg_);
+            still_left_cnt += resendPackets(stage2_xchg_);
+            if (still_left_cnt == 0) {
+                break;
+            }
+        }
+    }
+}
+
+CommandOptions::ChurnMessage
+ChurnScen::drawMessage() const {
+    int total = 0;
+    for (int message = CommandOptions::CHURN_RENEW;
+         message <= CommandOptions::CHURN_NEW; ++message) {
+        total += options_.getChurnWeight(static_cast<CommandOptions::ChurnMessage>(message));
+    }
+    int draw = random() % total;
+    for (int message = CommandOptions::CHURN_RENEW;
+         message < CommandOptions::CHURN_NEW; ++message) {
+        draw -= options_.getChurnWeight(static_cast<CommandOptions::ChurnMessage>(message));
+        if (draw < 0) {
+            return (static_cast<CommandOptions::ChurnMessage>(message));
+        }
+    }
+    return (CommandOptions::CHURN_NEW);
+}
+
+CommandOptions::ChurnMessage
+ChurnScen::sendMessage(CommandOptions::ChurnMessage message) {
+    bool v4 = (options_.getIpVersion() == 4);
+    uint64_t sent = 0;
+    switch (message) {
+    case CommandOptions::CHURN_RENEW:
+        sent = (v4 ? tc_.sendMultipleMessages4(DHCPREQUEST, 1) :
+                tc_.sendMultipleMessages6(DHCPV6_RENEW, 1));
+        break;
+    case CommandOptions::CHURN_RELEASE:
+        sent = (v4 ? tc_.sendMultipleMessages4(DHCPRELEASE, 1) :
+                tc_.sendMultipleMessages6(DHCPV6_RELEASE, 1));
+        break;
+    case CommandOptions::CHURN_DECLINE:
+        sent = (v4 ? tc_.sendMultipleMessages4(DHCPDECLINE, 1) :
+                tc_.sendMultipleMessages6(DHCPV6_DECLINE, 1));
+        break;
+    default:
+        break;
+    }
+    if (sent > 0) {
+        return (message);
+    }
+
+    // No lease is left: a new client joins.
+    tc_.sendPackets(1);
+    return (CommandOptions::CHURN_NEW);
+}
+
+int
+ChurnScen::run() {
+    StatsMgr& stats_mgr(tc_.getStatsMgr());
+
+    tc_.start();
+
+    // First the leased clients get their leases.
+    auto start = microsec_clock::universal_time();
+    uint32_t leased_num = static_cast<uint64_t>(options_.getClientsNum()) *
+        options_.getChurnLeased() / 100;
+    if (leased_num > 0) {
+        acquireLeases(leased_num);
+    }
+    auto storm_start = microsec_clock::universal_time();
+    uint64_t leases_num = stats_mgr.getRcvdPacketsNum(stage2_xchg_);
+    std::cout << "It took " << (storm_start - start) << " to provision "
+              << leases_num << " leases." << std::endl;
+
+    // Then the storm.
+    uint64_t storm_num = leases_num;
+    if (!options_.getNumRequests().empty()) {
+        storm_num = options_.getNumRequests()[0];
+    }
+    uint64_t storm_total = 0;
+    while ((storm_total < storm_num) && !tc_.interrupted()) {
+        uint64_t due = storm_rate_control_.getOutboundMessageCount();
+        for (uint64_t i = 0; (i < due) && (storm_total < storm_num); ++i) {
+            ++storm_sent_[sendMessage(drawMessage())];
+            ++storm_total;
+        }
+
+        auto pkt_count = tc_.consumeReceivedPackets();
+        if ((due == 0) && (pkt_count == 0)) {
+            usleep(1);
+        }
+
+        if (options_.getReportDelay() > 0) {
+            tc_.printIntermediateStats();
+        }
+    }
+
+    // The late responses are still received during the drop time. The
+    // new clients finish their 4-way exchanges meanwhile.
+    auto storm_stop = microsec_clock::universal_time();
+    double drop_time = std::max(options_.getDropTime()[0],
+                                options_.getDropTime()[1]);
+    auto wait_end = storm_stop + microseconds(static_cast<int64_t>(drop_time * 1e6));
+    while ((microsec_clock::universal_time() < wait_end) &&
+           !tc_.interrupted()) {
+        if (tc_.consumeReceivedPackets() == 0) {
+            usleep(100);
+        }
+    }
+
+    tc_.stop();
+
+    tc_.printStats();
+
+    // Print packet timestamps
+    if (options_.testDiags('t')) {
+        stats_mgr.printTimestamps();
+    }
+
+    // Print server id.
+    if (options_.testDiags('s') && tc_.serverIdReceived()) {
+        std::cout << "Server id: " << tc_.getServerId() << std::endl;
+    }
+
+    // Diagnostics flag 'e' means show exit reason.
+    if (options_.testDiags('e') && tc_.interrupted()) {
+        std::cout << "Interrupted" << std::endl;
+    }
+
+    // Print any received leases.
+    if (options_.testDiags('l')) {
+        stats_mgr.printLeases();
+    }
+
+    std::cout << "It took " << (storm_stop - storm_start) << " to send "
+              << storm_total << " storm messages." << std::endl
+              << "Renews: " << storm_sent_[CommandOptions::CHURN_RENEW]
+              << std::endl
+              << "Releases: " << storm_sent_[CommandOptions::CHURN_RELEASE]
+              << std::endl
+              << "Declines: " << storm_sent_[CommandOptions::CHURN_DECLINE]
+              << std::endl
+              << "New clients: " << storm_sent_[CommandOptions::CHURN_NEW]
+              << std::endl
+              << "Requests resent before the storm: " << total_resent_
+              << std::endl;
+
+    return (0);
+}
+
+}
+}
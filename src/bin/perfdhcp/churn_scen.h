@@ -0,0 +1,77 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef CHURN_SCEN_H
+#define CHURN_SCEN_H
+
+#include <config.h>
+
+#include <perfdhcp/avalanche_scen.h>
+#include <perfdhcp/rate_control.h>
+
+
+namespace isc {
+namespace perfdhcp {
+
+/// \brief Churn Scenario class.
+///
+/// This class is used to run the performance test simulating a renewal
+/// storm, e.g. after a power outage. The test runs in two phases:
+/// - the clients with a lease (the --churn-leased percentage of the -R
+///   clients) first get their leases as in the avalanche scenario,
+/// - then the storm sends the -n messages (by default one per lease) at
+///   the -r rate, or as fast as possible without it. Each message is a
+///   Renew, a Release, a Decline or the first message of a new client,
+///   randomly chosen with the --churn-mix weights.
+///
+/// The renewed leases and the leases of the new clients can be used
+/// again by the following messages, the released and declined leases
+/// can't. When no lease is left, the message is sent by a new client.
+class ChurnScen : public AvalancheScen {
+public:
+    /// \brief Default and the only constructor of ChurnScen.
+    ///
+    /// \param options reference to command options,
+    /// \param socket reference to a socket.
+    ChurnScen(CommandOptions& options, BasePerfSocket &socket);
+
+    /// brief\ Run performance test.
+    ///
+    /// Method runs whole performance test.
+    ///
+    /// \return execution status.
+    int run() override;
+
+protected:
+
+    /// \brief Gets the leases of the leased clients.
+    ///
+    /// \param clients_num number of clients to get a lease for.
+    void acquireLeases(uint32_t clients_num);
+
+    /// \brief Sends one message of the storm.
+    ///
+    /// \param message the message drawn from the churn mix.
+    /// \return the message which was actually sent: \c CHURN_NEW when
+    /// there was no lease to renew, release or decline.
+    CommandOptions::ChurnMessage sendMessage(CommandOptions::ChurnMessage message);
+
+    /// \brief Draws a message from the churn mix.
+    ///
+    /// \return the message.
+    CommandOptions::ChurnMessage drawMessage() const;
+
+    /// \brief A rate control class for the storm messages.
+    RateControl storm_rate_control_;
+
+    /// \brief Number of storm messages sent for each message type.
+    std::vector<uint64_t> storm_sent_;
+};
+
+}
+}
+
+#endif // CHURN_SCEN_H
@@ -15,9 +15,11 @@
 #include <dhcp/option.h>
 #include <process/cfgrpt/config_report.h>
 #include <util/encode/hex.h>
+#include <util/strutil.h>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
 #include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
@@ -35,6 +37,35 @@ using namespace std;
 using namespace isc;
 using namespace isc::dhcp;
 
+namespace {
+
+/// \brief Returns the share of a sender thread.
+///
+/// \param total value to divide between the threads.
+/// \param index index of the thread.
+/// \param count number of threads.
+/// \return the share, the first threads get one more for the remainder.
+uint32_t
+threadShare(uint32_t total, uint32_t index, uint32_t count) {
+    return (total / count + (index < total % count ? 1 : 0));
+}
+
+/// \brief Adds a value to the trailing octets of an address template.
+///
+/// \param bytes the address template, e.g. a MAC address.
+/// \param value the value added to the template as a big endian number.
+void
+addToTemplate(std::vector<uint8_t>& bytes, uint32_t value) {
+    uint64_t carry = value;
+    for (auto it = bytes.rbegin(); (it != bytes.rend()) && (carry > 0); ++it) {
+        carry += *it;
+        *it = static_cast<uint8_t>(carry);
+        carry >>= 8;
+    }
+}
+
+} // end of anonymous namespace
+
 namespace isc {
 namespace perfdhcp {
 
@@ -163,6 +194,11 @@ CommandOptions::reset() {
         single_thread_mode_ = false;
     }
     scenario_ = Scenario::BASIC;
+    sender_threads_ = 1;
+    time_series_file_.clear();
+    int churn_mix[] = { 100, 0, 0, 0 };
+    churn_mix_.assign(churn_mix, churn_mix + 4);
+    churn_leased_ = 100;
 }
 
 bool
@@ -212,6 +248,10 @@ CommandOptions::parse(int argc, char** const argv, bool print_cmd_line) {
 }
 
 const int LONG_OPT_SCENARIO = 300;
+const int LONG_OPT_THREADS = 301;
+const int LONG_OPT_TIME_SERIES = 302;
+const int LONG_OPT_CHURN_MIX = 303;
+const int LONG_OPT_CHURN_LEASED = 304;
 
 bool
 CommandOptions::initialize(int argc, char** argv, bool print_cmd_line) {
@@ -232,6 +272,10 @@ CommandOptions::initialize(int argc, char** argv, bool print_cmd_line) {
 
     struct option long_options[] = {
         {"scenario", required_argument, 0, LONG_OPT_SCENARIO},
+        {"threads",  required_argument, 0, LONG_OPT_THREADS},
+        {"time-series", required_argument, 0, LONG_OPT_TIME_SERIES},
+        {"churn-mix", required_argument, 0, LONG_OPT_CHURN_MIX},
+        {"churn-leased", required_argument, 0, LONG_OPT_CHURN_LEASED},
         {0,          0,                 0, 0}
     };
 
@@ -588,11 +632,58 @@ CommandOptions::initialize(int argc, char** argv, bool print_cmd_line) {
                 scenario_ = Scenario::BASIC;
             } else if (optarg_text == "avalanche") {
                 scenario_ = Scenario::AVALANCHE;
+            } else if (optarg_text == "churn") {
+                scenario_ = Scenario::CHURN;
             } else {
-                isc_throw(InvalidParameter, "scenario value '" << optarg << "' is wrong - should be 'basic' or 'avalanche'");
+                isc_throw(InvalidParameter, "scenario value '" << optarg << "' is wrong - should be 'basic', 'avalanche' or 'churn'");
             }
             break;
         }
+
+        case LONG_OPT_THREADS:
+            sender_threads_ = positiveInteger("number of sender threads:"
+                                              " --threads<count> must be"
+                                              " a positive integer");
+            break;
+
+        case LONG_OPT_CHURN_MIX: {
+            std::vector<std::string> weights =
+                isc::util::str::tokens(std::string(optarg), ",", true);
+            check(weights.size() != 4,
+                  "--churn-mix<renew,release,decline,new> requires four"
+                  " comma separated weights");
+            int total = 0;
+            for (size_t i = 0; i < weights.size(); ++i) {
+                try {
+                    churn_mix_[i] = boost::lexical_cast<int>(weights[i]);
+                } catch (const boost::bad_lexical_cast&) {
+                    isc_throw(InvalidParameter, "value of the churn mix '"
+                              << weights[i] << "' must be a non negative"
+                              " integer");
+                }
+                check(churn_mix_[i] < 0, "value of the churn mix must be a"
+                      " non negative integer");
+                total += churn_mix_[i];
+            }
+            check(total == 0, "at least one value of the churn mix must be"
+                  " positive");
+            break;
+        }
+
+        case LONG_OPT_CHURN_LEASED:
+            churn_leased_ = nonNegativeInteger("percentage of leased clients:"
+                                               " --churn-leased<percent> must"
+                                               " be a non negative integer");
+            check(churn_leased_ > 100, "percentage of leased clients:"
+                  " --churn-leased<percent> must not exceed 100");
+            break;
+
+        case LONG_OPT_TIME_SERIES:
+            time_series_file_ = std::string(optarg);
+            check(time_series_file_.empty(),
+                  "--time-series<file> requires a file name");
+            break;
+
         default:
             isc_throw(isc::InvalidParameter, "wrong command line option");
         }
@@ -647,9 +738,13 @@ CommandOptions::initialize(int argc, char** argv, bool print_cmd_line) {
             std::cout << "Scenario: basic." << std::endl;
         } else if (scenario_ == Scenario::AVALANCHE) {
             std::cout << "Scenario: avalanche." << std::endl;
+        } else if (scenario_ == Scenario::CHURN) {
+            std::cout << "Scenario: churn." << std::endl;
         }
 
-        if (!isSingleThreaded()) {
+        if (sender_threads_ > 1) {
+            std::cout << "Sender threads: " << sender_threads_ << "." << std::endl;
+        } else if (!isSingleThreaded()) {
             std::cout << "Multi-thread mode enabled." << std::endl;
         }
     }
@@ -979,7 +1074,9 @@ CommandOptions::validate() {
     check((getWaitForElapsedTime() != -1 && getIncreaseElapsedTime() == -1),
 	  "Option -Y can't be used without -y");
     auto nthreads = std::thread::hardware_concurrency();
-    if (nthreads == 1 && isSingleThreaded() == false) {
+    if (sender_threads_ > 1) {
+        // Each sender thread receives its responses itself.
+    } else if (nthreads == 1 && isSingleThreaded() == false) {
         std::cout << "WARNING: Currently system can run only 1 thread in parallel." << std::endl
                   << "WARNING: Better results are achieved when run in single-threaded mode." << std::endl
                   << "WARNING: To switch use -g single option." << std::endl;
@@ -989,6 +1086,41 @@ CommandOptions::validate() {
                   << "WARNING: To switch use -g multi option." << std::endl;
     }
 
+    if (sender_threads_ > 1) {
+        check(scenario_ != Scenario::BASIC,
+              "--threads<count> is supported only in the basic scenario");
+        check(getClientsNum() < sender_threads_,
+              "-R<num-clients> must be set to at least the number of sender"
+              " threads to give each thread its own clients");
+        check((getRate() != 0) && (getRate() < sender_threads_),
+              "-r<rate> must be at least the number of sender threads");
+        check(!getNumRequests().empty() &&
+              (*std::min_element(getNumRequests().begin(),
+                                 getNumRequests().end()) <
+               static_cast<int>(sender_threads_)),
+              "-n<num-request> must be at least the number of sender threads");
+        check(!getTemplateFiles().empty(),
+              "-T<template-file> can't be used with --threads<count>");
+        check(!getMacListFile().empty(),
+              "-M<mac-list-file> can't be used with --threads<count>");
+        check(getReportDelay() > 0,
+              "-t<report> can't be used with --threads<count>");
+        check(testDiags('t') || testDiags('l'),
+              "-x<diagnostic-selector> 't' and 'l' can't be used with"
+              " --threads<count>");
+        check((getIpVersion() == 6) && !isUseRelayedV6(),
+              "-A<encapsulation-level> must be set with -6 and"
+              " --threads<count> for the server to respond to the port"
+              " of each thread");
+        uint32_t port = getLocalPort();
+        if (port == 0) {
+            port = (getIpVersion() == 4 ? DHCP4_SERVER_PORT : DHCP6_SERVER_PORT);
+        }
+        check(port + sender_threads_ - 1 > 65535,
+              "local ports of the sender threads (-L<local-port> plus the"
+              " thread index) must not exceed 65535");
+    }
+
     if (scenario_ == Scenario::AVALANCHE) {
         check(getClientsNum() <= 0,
               "in case of avalanche scenario number\nof clients must be specified"
@@ -1001,6 +1133,75 @@ CommandOptions::validate() {
             std::cout << "INFO: in avalanche scenario drop time is ignored" << std::endl;
         }
     }
+
+    if (scenario_ == Scenario::CHURN) {
+        check(getClientsNum() <= 0,
+              "in case of churn scenario number of clients must be specified"
+              " using -R option explicitly");
+        check(getExchangeMode() != DORA_SARR,
+              "-i can't be used in the churn scenario which needs leases");
+        check((getRenewRate() != 0) || (getReleaseRate() != 0),
+              "-f<renew-rate> and -F<release-rate> can't be used in the churn"
+              " scenario, use --churn-mix instead");
+        check((getChurnLeased() == 0) && getNumRequests().empty(),
+              "-n<num-request> must be specified in the churn scenario when"
+              " no client gets a lease before the storm");
+    }
+}
+
+void
+CommandOptions::setSenderThread(uint32_t index) {
+    const uint32_t count = sender_threads_;
+    if (index >= count) {
+        isc_throw(isc::OutOfRange, "sender thread index " << index
+                  << " out of range 0.." << count - 1);
+    }
+
+    rate_ = threadShare(rate_, index, count);
+    renew_rate_ = threadShare(renew_rate_, index, count);
+    release_rate_ = threadShare(release_rate_, index, count);
+    for (auto& num_request : num_request_) {
+        num_request = threadShare(num_request, index, count);
+    }
+    preload_ = threadShare(preload_, index, count);
+    for (auto& max_drop : max_drop_) {
+        max_drop = std::max(threadShare(max_drop, index, count), 1U);
+    }
+
+    // Give the thread the clients after the ones of the previous threads.
+    uint32_t first_client = 0;
+    for (uint32_t i = 0; i < index; ++i) {
+        first_client += threadShare(clients_num_, i, count);
+    }
+    clients_num_ = threadShare(clients_num_, index, count);
+    addToTemplate(mac_template_, first_client);
+    if (duid_template_.size() >= mac_template_.size()) {
+        // The randomized DUIDs end with the randomized MAC address.
+        std::vector<uint8_t> tail(duid_template_.end() - mac_template_.size(),
+                                  duid_template_.end());
+        addToTemplate(tail, first_client);
+        std::copy(tail.begin(), tail.end(),
+                  duid_template_.end() - mac_template_.size());
+    }
+
+    // The responses are sent back to the port of the thread socket.
+    if (local_port_ == 0) {
+        local_port_ = (ipversion_ == 4 ? DHCP4_SERVER_PORT : DHCP6_SERVER_PORT);
+    }
+    local_port_ += index;
+
+    // The thread receives its responses itself and the main thread runs
+    // the wrapped command.
+    single_thread_mode_ = true;
+    wrapped_.clear();
+}
+
+bool
+CommandOptions::isTimeSeriesJson() const {
+    const std::string suffix(".json");
+    return ((time_series_file_.size() >= suffix.size()) &&
+            (time_series_file_.compare(time_series_file_.size() - suffix.size(),
+                                       suffix.size(), suffix) == 0));
 }
 
 void
@@ -1171,8 +1372,11 @@ R"(perfdhcp [-1] [-4 | -6] [-A encapsulation-level] [-b base] [-B] [-c]
          [-n num-request] [-N remote-port] [-O random-offset]
          [-o code,hexstring] [-p test-period] [-P preload] [-r rate]
          [-R num-clients] [-s seed] [-S srvid-offset] [--scenario name]
-         [-t report] [-T template-file] [-u] [-v] [-W exit-wait-time]
-         [-w script_name] [-x diagnostic-selector] [-X xid-offset] [server]
+         [--churn-mix renew,release,decline,new] [--churn-leased percent]
+         [-t report] [-T template-file] [--threads count]
+         [--time-series file] [-u] [-v]
+         [-W exit-wait-time] [-w script_name] [-x diagnostic-selector]
+         [-X xid-offset] [server]
 
 The [server] argument is the name/address of the DHCP server to
 contact.  For DHCPv4 operation, exchanges are initiated by
@@ -1195,6 +1399,10 @@ The other scenario is an avalanche which is selected by
 messages as request in -R option then back off mechanism is used for
 each simulated client until all requests are answered. At the end
 time of whole scenario is reported.
+The churn scenario selected by --scenario churn simulates a renewal
+storm: the clients first get their leases as in the avalanche scenario,
+then they all send a mix of Renew, Release and Decline messages and
+new clients join at the -r rate or as fast as possible.
 
 Options:
 -1: Take the server-ID option from the first received message.
@@ -1267,11 +1475,29 @@ Options:
 -R<range>: Specify how many different clients are used. With 1
     (the default), all requests seem to come from the same client.
 -s<seed>: Specify the seed for randomization, making it repeatable.
---scenario <name>: where name is 'basic' (default) or 'avalanche'.
+--scenario <name>: where name is 'basic' (default), 'avalanche' or 'churn'.
+--churn-mix <renew,release,decline,new>: Weights of the messages sent
+    during the storm of the churn scenario, by default 100,0,0,0. The
+    renewed leases may be used again and the released or declined ones
+    are not. A new client does a 4-way exchange and its lease may be used
+    too. A message for which no lease is available is sent by a new client.
+--churn-leased <percent>: Percentage of the -R clients getting a lease
+    before the storm of the churn scenario, by default 100.
+    The storm sends -n messages, by default as many as leases.
 -S<srvid-offset>: Offset of the server-ID option in the
     (second/request) template.
 -T<template-file>: The name of a file containing the template to use
     as a stream of hexadecimal digits.
+--threads <count>: Send from <count> threads, each with its own socket
+    bound to the local port plus the thread index, its own clients and
+    its own statistics merged in the final report. The rates, -n, -P
+    and -D limits and -R clients are divided between the threads. The
+    server is asked to respond to the port of each thread (RFC 8357),
+    which requires -A with -6. Only in the basic scenario, not with -T,
+    -M, -t or the 't' and 'l' diagnostics.
+--time-series <file>: Write the numbers of sent and received packets of
+    each exchange for each second of the test in <file>, as CSV or as
+    JSON with the delay percentiles when the file name ends with ".json".
 -u: Enable checking address uniqueness. Lease valid lifetime should not be
     shorter than test duration and clients should not request address more than
     once without releasing it first.
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,7 +9,6 @@
 
 #include <dhcp/option.h>
 
-#include <boost/noncopyable.hpp>
 #include <stdint.h>
 #include <string>
 #include <vector>
@@ -19,15 +18,17 @@ namespace perfdhcp {
 
 enum class Scenario {
     BASIC,
-    AVALANCHE
+    AVALANCHE,
+    CHURN
 };
 
 /// \brief Command Options.
 ///
 /// This class is responsible for parsing the command-line and storing the
-/// specified options.
+/// specified options. The options are copied to derive the options of
+/// each sender thread (see \ref setSenderThread).
 ///
-class CommandOptions : public boost::noncopyable {
+class CommandOptions {
 public:
 
     /// \brief Default Constructor.
@@ -119,6 +120,14 @@ public:
         DORA_SARR
     };
 
+    /// Messages sent by the clients in the churn scenario (--churn-mix)
+    enum ChurnMessage {
+        CHURN_RENEW,
+        CHURN_RELEASE,
+        CHURN_DECLINE,
+        CHURN_NEW
+    };
+
     /// \brief Reset to defaults.
     ///
     /// Reset data members to default values. This is specifically
@@ -387,6 +396,50 @@ public:
     /// \return enum Scenario.
     Scenario getScenario() const { return scenario_; }
 
+    /// \brief Returns the number of sender threads.
+    ///
+    /// \return number of sender threads specified with --threads.
+    uint32_t getSenderThreads() const { return sender_threads_; }
+
+    /// \brief Adjusts the options to a sender thread.
+    ///
+    /// In the --threads mode each sender thread has its own copy of the
+    /// options adjusted by this function: the rates, the numbers of
+    /// requests, the preload and the maximum drops are divided between
+    /// the threads, the clients simulated by the thread start after the
+    /// clients of the previous threads and the thread socket is bound to
+    /// the local port incremented by the thread index. The thread receives
+    /// the responses itself and the wrapped command is left to the main
+    /// thread.
+    ///
+    /// \param index index of the thread from 0 to the number of threads minus 1.
+    void setSenderThread(uint32_t index);
+
+    /// \brief Returns the weight of a message in the churn scenario.
+    ///
+    /// \param message the message.
+    /// \return weight of the message specified with --churn-mix.
+    int getChurnWeight(ChurnMessage message) const {
+        return (churn_mix_[message]);
+    }
+
+    /// \brief Returns the percentage of clients with a lease before the
+    /// storm of the churn scenario.
+    ///
+    /// \return percentage specified with --churn-leased.
+    int getChurnLeased() const { return churn_leased_; }
+
+    /// \brief Returns the file for the per second statistics.
+    ///
+    /// \return name of the file specified with --time-series, empty if
+    /// none.
+    std::string getTimeSeriesFile() const { return time_series_file_; }
+
+    /// \brief Checks if the per second statistics are written in JSON.
+    ///
+    /// \return true if the --time-series file name ends with ".json".
+    bool isTimeSeriesJson() const;
+
     /// \brief Returns server name.
     ///
     /// \return server name.
@@ -756,6 +809,19 @@ private:
 
     /// @brief Selected performance scenario. Default is basic.
     Scenario scenario_;
+
+    /// @brief Number of sender threads, each with its own socket.
+    uint32_t sender_threads_;
+
+    /// @brief File where the per second statistics are written.
+    std::string time_series_file_;
+
+    /// @brief Weights of the renew, release, decline and new client
+    /// messages in the churn scenario.
+    std::vector<int> churn_mix_;
+
+    /// @brief Percentage of clients with a lease before the churn storm.
+    int churn_leased_;
 };
 
 }  // namespace perfdhcp
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,7 +8,9 @@
 
 #include <perfdhcp/avalanche_scen.h>
 #include <perfdhcp/basic_scen.h>
+#include <perfdhcp/churn_scen.h>
 #include <perfdhcp/command_options.h>
+#include <perfdhcp/threaded_scen.h>
 
 #include <exceptions/exceptions.h>
 
@@ -37,13 +39,21 @@ main(int argc, char* argv[]) {
         }
         parser_error = false;
         auto scenario = command_options.getScenario();
-        PerfSocket socket(command_options);
-        if (scenario == Scenario::BASIC) {
-            BasicScen scen(command_options, socket);
-            ret_code = scen.run();
-        } else if (scenario == Scenario::AVALANCHE) {
-            AvalancheScen scen(command_options, socket);
+        if (command_options.getSenderThreads() > 1) {
+            ThreadedScen scen(command_options);
             ret_code = scen.run();
+        } else {
+            PerfSocket socket(command_options);
+            if (scenario == Scenario::BASIC) {
+                BasicScen scen(command_options, socket);
+                ret_code = scen.run();
+            } else if (scenario == Scenario::AVALANCHE) {
+                AvalancheScen scen(command_options, socket);
+                ret_code = scen.run();
+            } else if (scenario == Scenario::CHURN) {
+                ChurnScen scen(command_options, socket);
+                ret_code = scen.run();
+            }
         }
     } catch (const std::exception& e) {
         ret_code = 1;
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,6 +13,8 @@
 #include <dhcp/pkt6.h>
 #include <dhcp/socket_info.h>
 #include <dhcp/iface_mgr.h>
+#include <dhcp/pkt_filter_inet.h>
+#include <dhcp/pkt_filter_inet6.h>
 
 namespace isc {
 namespace perfdhcp {
@@ -68,6 +70,10 @@ public:
     /// This constructor uses provided socket descriptor to
     /// find the name of the interface where socket has been
     /// bound to.
+    ///
+    /// With several sender threads (--threads) the packets are sent
+    /// and received through this socket only, instead of any socket
+    /// of the IfaceMgr which is not thread safe.
     PerfSocket(CommandOptions& options);
 
     /// \brief Destructor of the socket wrapper class.
@@ -135,6 +141,25 @@ protected:
     /// \throw isc::Unexpected if internal unexpected error occurred.
     /// \return socket descriptor.
     int openSocket(CommandOptions& options) const;
+
+    /// \brief Waits for data to read on the socket.
+    ///
+    /// \param timeout_sec number of seconds for waiting for data,
+    /// \param timeout_usec number of microseconds for waiting for data,
+    /// \return true if there is data to read.
+    bool waitForData(uint32_t timeout_sec, uint32_t timeout_usec) const;
+
+    /// \brief Indicates if the packets go through this socket only.
+    bool own_io_;
+
+    /// \brief Interface of the socket, used in the own_io_ mode.
+    dhcp::IfacePtr iface_;
+
+    /// \brief Packet filter used in the own_io_ mode for DHCPv4.
+    dhcp::PktFilterInet filter4_;
+
+    /// \brief Packet filter used in the own_io_ mode for DHCPv6.
+    dhcp::PktFilterInet6 filter6_;
 };
 
 }
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,6 +15,9 @@
 #include <perfdhcp/stats_mgr.h>
 #include <perfdhcp/test_control.h>
 
+#include <algorithm>
+#include <iomanip>
+
 using isc::dhcp::DHO_DHCP_CLIENT_IDENTIFIER;
 using isc::dhcp::DUID;
 using isc::dhcp::Option6IAAddr;
@@ -35,11 +38,13 @@ int dhcpVersion(ExchangeType const exchange_type) {
     case ExchangeType::RA:
     case ExchangeType::RNA:
     case ExchangeType::RLA:
+    case ExchangeType::DLA:
         return 4;
     case ExchangeType::SA:
     case ExchangeType::RR:
     case ExchangeType::RN:
     case ExchangeType::RL:
+    case ExchangeType::DL:
         return 6;
     default:
         isc_throw(BadValue,
@@ -58,6 +63,8 @@ std::ostream& operator<<(std::ostream& os, ExchangeType xchg_type)
         return(os << "REQUEST-ACK (renewal)");
     case ExchangeType::RLA:
         return(os << "RELEASE");
+    case ExchangeType::DLA:
+        return(os << "DECLINE");
     case ExchangeType::SA:
         return(os << "SOLICIT-ADVERTISE");
     case ExchangeType::RR:
@@ -66,6 +73,8 @@ std::ostream& operator<<(std::ostream& os, ExchangeType xchg_type)
         return(os << "RENEW-REPLY");
     case ExchangeType::RL:
         return(os << "RELEASE-REPLY");
+    case ExchangeType::DL:
+        return(os << "DECLINE-REPLY");
     default:
         return(os << "Unknown exchange type");
     }
@@ -86,6 +95,7 @@ ExchangeStats::ExchangeStats(const ExchangeType xchg_type,
       max_delay_(0.),
       sum_delay_(0.),
       sum_delay_squared_(0.),
+      delay_histogram_("delays"),
       orphans_(0),
       collected_(0),
       unordered_lookup_size_sum_(0),
@@ -149,6 +159,24 @@ ExchangeStats::updateDelays(const PktPtr& sent_packet,
     // mean delays.
     sum_delay_ += delta;
     sum_delay_squared_ += delta * delta;
+    delay_histogram_.record(static_cast<uint64_t>(period.length().total_microseconds()));
+}
+
+void
+ExchangeStats::countInSeries(std::vector<uint64_t>& series,
+                             const PktPtr& packet) {
+    boost::posix_time::ptime timestamp = packet->getTimestamp();
+    if (timestamp.is_not_a_date_time()) {
+        timestamp = boost::posix_time::microsec_clock::universal_time();
+    }
+    if (timestamp < boot_time_) {
+        return;
+    }
+    size_t second = (timestamp - boot_time_).total_seconds();
+    if (second >= series.size()) {
+        series.resize(second + 1, 0);
+    }
+    ++series[second];
 }
 
 PktPtr
@@ -212,6 +240,8 @@ ExchangeStats::matchPackets(const PktPtr& rcvd_packet) {
         bool non_expired_found = false;
         // Removal can be done only after the loop
         PktListRemovalQueue to_remove;
+        // The current time is the same for the whole bucket.
+        ptime now = microsec_clock::universal_time();
         for (PktListTransidHashIterator it = p.first; it != p.second; ++it) {
             // If transaction id is matching, we found the original
             // packet sent to the server. Therefore, we reset the
@@ -228,7 +258,6 @@ ExchangeStats::matchPackets(const PktPtr& rcvd_packet) {
             if (!non_expired_found) {
                 // Check if the packet should be removed due to timeout.
                 // This includes the packet matching the received one.
-                ptime now = microsec_clock::universal_time();
                 ptime packet_time = (*it)->getTimestamp();
                 time_period packet_period(packet_time, now);
                 if (!packet_period.is_null()) {
@@ -289,6 +318,7 @@ ExchangeStats::matchPackets(const PktPtr& rcvd_packet) {
     // Packet is matched so we count it. We don't count unmatched packets
     // as they are counted as orphans with a separate counter.
     ++rcvd_packets_num_;
+    countInSeries(rcvd_series_, rcvd_packet);
     PktPtr sent_packet(*next_sent_);
     // If packet was found, we assume it will be never searched
     // again. We want to delete this packet from the list to
@@ -363,28 +393,43 @@ StatsMgr::StatsMgr(CommandOptions& options) :
     // it so as StatsMgr preserves all packets.
     archive_enabled_ = options.testDiags('l') || options.testDiags('t');
 
+    // The churn scenario tracks the messages of its mix.
+    bool churn = (options.getScenario() == Scenario::CHURN);
+    bool renew = (options.getRenewRate() != 0) ||
+        (churn && options.getChurnWeight(CommandOptions::CHURN_RENEW) > 0);
+    bool release = (options.getReleaseRate() != 0) ||
+        (churn && options.getChurnWeight(CommandOptions::CHURN_RELEASE) > 0);
+    bool decline = churn &&
+        (options.getChurnWeight(CommandOptions::CHURN_DECLINE) > 0);
+
     if (options.getIpVersion() == 4) {
         addExchangeStats(ExchangeType::DO, options.getDropTime()[0]);
         if (options.getExchangeMode() == CommandOptions::DORA_SARR) {
             addExchangeStats(ExchangeType::RA, options.getDropTime()[1]);
         }
-        if (options.getRenewRate() != 0) {
+        if (renew) {
             addExchangeStats(ExchangeType::RNA);
         }
-        if (options.getReleaseRate() != 0) {
+        if (release) {
             addExchangeStats(ExchangeType::RLA);
         }
+        if (decline) {
+            addExchangeStats(ExchangeType::DLA);
+        }
     } else if (options.getIpVersion() == 6) {
         addExchangeStats(ExchangeType::SA, options.getDropTime()[0]);
         if (options.getExchangeMode() == CommandOptions::DORA_SARR) {
             addExchangeStats(ExchangeType::RR, options.getDropTime()[1]);
         }
-        if (options.getRenewRate() != 0) {
+        if (renew) {
             addExchangeStats(ExchangeType::RN);
         }
-        if (options.getReleaseRate() != 0) {
+        if (release) {
             addExchangeStats(ExchangeType::RL);
         }
+        if (decline) {
+            addExchangeStats(ExchangeType::DL);
+        }
     }
     if (options.testDiags('i')) {
         addCustomCounter("shortwait", "Short waits for packets");
@@ -458,6 +503,36 @@ ExchangeStats::printLeases() const {
     std::cout << receivedLeases() << std::endl;
 }
 
+void
+ExchangeStats::merge(const ExchangeStats& other) {
+    min_delay_ = std::min(min_delay_, other.min_delay_);
+    max_delay_ = std::max(max_delay_, other.max_delay_);
+    sum_delay_ += other.sum_delay_;
+    sum_delay_squared_ += other.sum_delay_squared_;
+    orphans_ += other.orphans_;
+    collected_ += other.collected_;
+    unordered_lookup_size_sum_ += other.unordered_lookup_size_sum_;
+    unordered_lookups_ += other.unordered_lookups_;
+    ordered_lookups_ += other.ordered_lookups_;
+    sent_packets_num_ += other.sent_packets_num_;
+    rcvd_packets_num_ += other.rcvd_packets_num_;
+    non_unique_addr_num_ += other.non_unique_addr_num_;
+    rejected_leases_num_ += other.rejected_leases_num_;
+    delay_histogram_.merge(other.delay_histogram_);
+    if (sent_series_.size() < other.sent_series_.size()) {
+        sent_series_.resize(other.sent_series_.size(), 0);
+    }
+    for (size_t i = 0; i < other.sent_series_.size(); ++i) {
+        sent_series_[i] += other.sent_series_[i];
+    }
+    if (rcvd_series_.size() < other.rcvd_series_.size()) {
+        rcvd_series_.resize(other.rcvd_series_.size(), 0);
+    }
+    for (size_t i = 0; i < other.rcvd_series_.size(); ++i) {
+        rcvd_series_[i] += other.rcvd_series_[i];
+    }
+}
+
 void StatsMgr::printLeases() const {
     for (auto const& exchange : exchanges_) {
         std::cout << "***Leases for " << exchange.first << "***" << std::endl;
@@ -467,7 +542,74 @@ void StatsMgr::printLeases() const {
     }
 }
 
-int ExchangeStats::malformed_pkts_{0};
+void
+StatsMgr::printTimeSeries(std::ostream& os, bool json) const {
+    if (!json) {
+        os << "second,exchange,sent,received" << std::endl;
+    } else {
+        os << "{ \"exchanges\": [";
+    }
+    bool first = true;
+    for (auto const& exchange : exchanges_) {
+        const std::vector<uint64_t>& sent = exchange.second->getSentSeries();
+        const std::vector<uint64_t>& rcvd = exchange.second->getRcvdSeries();
+        size_t seconds = std::max(sent.size(), rcvd.size());
+        if (!json) {
+            for (size_t i = 0; i < seconds; ++i) {
+                os << i << "," << exchange.first << ","
+                   << (i < sent.size() ? sent[i] : 0) << ","
+                   << (i < rcvd.size() ? rcvd[i] : 0) << std::endl;
+            }
+            continue;
+        }
+
+        if (!first) {
+            os << ",";
+        }
+        first = false;
+        os << std::endl << "  { \"exchange\": \"" << exchange.first << "\","
+           << std::endl << "    \"delay-percentiles-ms\": {";
+        const isc::stats::LatencyHistogram& histogram = exchange.second->getDelayHistogram();
+        if (histogram.getCount() > 0) {
+            os << std::fixed << std::setprecision(3)
+               << " \"p50\": " << histogram.getPercentile(50.) / 1e3
+               << ", \"p90\": " << histogram.getPercentile(90.) / 1e3
+               << ", \"p99\": " << histogram.getPercentile(99.) / 1e3
+               << ", \"p99.9\": " << histogram.getPercentile(99.9) / 1e3
+               << " ";
+        }
+        os << "}," << std::endl << "    \"series\": [";
+        for (size_t i = 0; i < seconds; ++i) {
+            os << (i == 0 ? " " : ", ")
+               << "{ \"second\": " << i
+               << ", \"sent\": " << (i < sent.size() ? sent[i] : 0)
+               << ", \"received\": " << (i < rcvd.size() ? rcvd[i] : 0)
+               << " }";
+        }
+        os << " ] }";
+    }
+    if (json) {
+        os << std::endl << "] }" << std::endl;
+    }
+}
+
+void
+StatsMgr::merge(const StatsMgr& other) {
+    for (auto const& exchange : other.exchanges_) {
+        auto it = exchanges_.find(exchange.first);
+        if (it != exchanges_.end()) {
+            it->second->merge(*exchange.second);
+        }
+    }
+    for (auto const& counter : other.custom_counters_) {
+        auto it = custom_counters_.find(counter.first);
+        if (it != custom_counters_.end()) {
+            *it->second += counter.second->getValue();
+        }
+    }
+}
+
+std::atomic<int> ExchangeStats::malformed_pkts_{0};
 
 }  // namespace perfdhcp
 }  // namespace isc
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,6 +10,7 @@
 #include <dhcp/pkt.h>
 #include <exceptions/exceptions.h>
 #include <perfdhcp/command_options.h>
+#include <stats/latency_histogram.h>
 
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
@@ -20,9 +21,11 @@
 #include <boost/multi_index/mem_fun.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <queue>
+#include <vector>
 
 
 namespace isc {
@@ -34,10 +37,12 @@ enum class ExchangeType {
     RA,  ///< DHCPv4 REQUEST-ACK
     RNA, ///< DHCPv4 REQUEST-ACK (renewal)
     RLA, ///< DHCPv4 RELEASE
+    DLA, ///< DHCPv4 DECLINE
     SA,  ///< DHCPv6 SOLICIT-ADVERTISE
     RR,  ///< DHCPv6 REQUEST-REPLY
     RN,  ///< DHCPv6 RENEW-REPLY
-    RL   ///< DHCPv6 RELEASE-REPLY
+    RL,  ///< DHCPv6 RELEASE-REPLY
+    DL   ///< DHCPv6 DECLINE-REPLY
 };
 
 /// \brief Get the DHCP version that fits the exchange type.
@@ -297,6 +302,7 @@ public:
         }
         static_cast<void>(sent_packets_.template get<0>().push_back(packet));
         ++sent_packets_num_;
+        countInSeries(sent_series_, packet);
     }
 
     /// \brief Add new packet to list of received packets.
@@ -389,6 +395,44 @@ public:
                     getAvgDelay() * getAvgDelay()));
     }
 
+    /// \brief Return the packet delay at a percentile.
+    ///
+    /// The delays are counted in a \ref isc::stats::LatencyHistogram
+    /// with a microsecond resolution and a relative error lower than
+    /// 6.25%.
+    ///
+    /// \param percentile the percentile in the [0, 100] range, e.g. 99.9.
+    /// \throw isc::InvalidOperation if no packets for this exchange
+    /// have been received yet.
+    /// \return delay in seconds at the percentile.
+    double getDelayPercentile(double percentile) const {
+        if (delay_histogram_.getCount() == 0) {
+            isc_throw(InvalidOperation, "no packets received");
+        }
+        return (delay_histogram_.getPercentile(percentile) / 1e6);
+    }
+
+    /// \brief Return the histogram of packet delays in microseconds.
+    const isc::stats::LatencyHistogram& getDelayHistogram() const {
+        return (delay_histogram_);
+    }
+
+    /// \brief Return the number of sent packets for each second.
+    ///
+    /// The element at index N is the number of packets sent during
+    /// the Nth second after the test was started.
+    const std::vector<uint64_t>& getSentSeries() const {
+        return (sent_series_);
+    }
+
+    /// \brief Return the number of received packets for each second.
+    ///
+    /// The element at index N is the number of matched packets received
+    /// during the Nth second after the test was started.
+    const std::vector<uint64_t>& getRcvdSeries() const {
+        return (rcvd_series_);
+    }
+
     /// \brief Return number of orphan packets.
     ///
     /// Method returns number of received packets that had no matching
@@ -498,6 +542,15 @@ public:
     /// Method increases total number of non unique addresses by one.
     void updateNonUniqueAddr() { ++non_unique_addr_num_; }
 
+    /// \brief Adds the statistics of another exchange of the same type.
+    ///
+    /// It is used to merge the statistics of the sender threads into
+    /// the final report. The counters and delays are merged, the lists
+    /// of packets are not.
+    ///
+    /// \param other statistics to add.
+    void merge(const ExchangeStats& other);
+
     /// \brief Print main statistics for packet exchange.
     ///
     /// Method prints main statistics for particular exchange.
@@ -542,6 +595,14 @@ public:
                  << "max delay: " << getMaxDelay() * 1e3 << " ms" << endl
                  << "std deviation: " << getStdDevDelay() * 1e3 << " ms"
                  << endl
+                 << "p50 delay: " << getDelayPercentile(50.) * 1e3 << " ms"
+                 << endl
+                 << "p90 delay: " << getDelayPercentile(90.) * 1e3 << " ms"
+                 << endl
+                 << "p99 delay: " << getDelayPercentile(99.) * 1e3 << " ms"
+                 << endl
+                 << "p99.9 delay: " << getDelayPercentile(99.9) * 1e3
+                 << " ms" << endl
                  << "collected packets: " << getCollectedNum() << endl;
         } catch (const Exception&) {
             // repeated output for easier automated parsing
@@ -549,6 +610,10 @@ public:
                  << "avg delay: n/a" << endl
                  << "max delay: n/a" << endl
                  << "std deviation: n/a" << endl
+                 << "p50 delay: n/a" << endl
+                 << "p90 delay: n/a" << endl
+                 << "p99 delay: n/a" << endl
+                 << "p99.9 delay: n/a" << endl
                  << "collected packets: 0" << endl;
         }
     }
@@ -582,7 +647,7 @@ public:
     /// \brief Print the list of received leases.
     void printLeases() const;
 
-    static int malformed_pkts_;
+    static std::atomic<int> malformed_pkts_;
 
 // Private stuff of ExchangeStats class
 private:
@@ -615,6 +680,13 @@ private:
         return(sent_packets_.template get<0>().erase(it));
     }
 
+    /// \brief Count a packet in a per second series.
+    ///
+    /// \param series the series to update.
+    /// \param packet the packet, its timestamp gives the second.
+    void countInSeries(std::vector<uint64_t>& series,
+                       const dhcp::PktPtr& packet);
+
     ExchangeType xchg_type_;             ///< Packet exchange type.
     PktList sent_packets_;               ///< List of sent packets.
 
@@ -656,6 +728,13 @@ private:
     double sum_delay_squared_;     ///< Squared sum of delays between
                                    ///< sent and received packets.
 
+    /// Histogram of the delays between sent and received packets
+    /// in microseconds.
+    isc::stats::LatencyHistogram delay_histogram_;
+
+    std::vector<uint64_t> sent_series_; ///< Sent packets per second.
+    std::vector<uint64_t> rcvd_series_; ///< Received packets per second.
+
     uint64_t orphans_;   ///< Number of orphan received packets.
 
     uint64_t collected_; ///< Number of garbage collected packets.
@@ -910,6 +989,20 @@ public:
         return(xchg_stats->getStdDevDelay());
     }
 
+    /// \brief Return the packet delay at a percentile.
+    ///
+    /// Method returns the packet delay at a percentile for specified
+    /// exchange type.
+    ///
+    /// \param xchg_type exchange type.
+    /// \param percentile the percentile in the [0, 100] range.
+    /// \return delay in seconds at the percentile.
+    double getDelayPercentile(const ExchangeType xchg_type,
+                              double percentile) const {
+        ExchangeStatsPtr xchg_stats = getExchangeStats(xchg_type);
+        return(xchg_stats->getDelayPercentile(percentile));
+    }
+
     /// \brief Return number of orphan packets.
     ///
     /// Method returns number of orphan packets for specified
@@ -1189,6 +1282,28 @@ public:
     /// \brief Delegate to all exchanges to print their leases.
     void printLeases() const;
 
+    /// \brief Print the number of sent and received packets per second.
+    ///
+    /// The CSV output has a header line and one line per exchange type
+    /// and second with the second, the exchange type and the numbers of
+    /// sent and received packets. The JSON output is an object with an
+    /// "exchanges" list holding the same series for each exchange type
+    /// and the delay percentiles in milliseconds.
+    ///
+    /// \param os the output stream.
+    /// \param json true to print JSON, false to print CSV.
+    void printTimeSeries(std::ostream& os, bool json) const;
+
+    /// \brief Adds the statistics of another Statistics Manager.
+    ///
+    /// The statistics of each sender thread are kept by its own
+    /// Statistics Manager and merged when the test is finished. The
+    /// exchanges and custom counters which are not tracked by this
+    /// Statistics Manager are ignored.
+    ///
+    /// \param other Statistics Manager of a sender thread.
+    void merge(const StatsMgr& other);
+
     /// \brief Print names and values of custom counters.
     ///
     /// Method prints names and values of custom counters. Custom counters
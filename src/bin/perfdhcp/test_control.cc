@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -42,7 +42,7 @@ using namespace isc::asiolink;
 namespace isc {
 namespace perfdhcp {
 
-bool TestControl::interrupted_ = false;
+std::atomic<bool> TestControl::interrupted_(false);
 
 bool
 TestControl::waitToExit() {
@@ -163,17 +163,19 @@ TestControl::byte2Hex(const uint8_t b) {
 Pkt4Ptr
 TestControl::createMessageFromAck(const uint16_t msg_type,
                                   const dhcp::Pkt4Ptr& ack) {
-    // Restrict messages to Release and Renew.
-    if (msg_type != DHCPREQUEST && msg_type != DHCPRELEASE) {
+    // Restrict messages to Renew, Release and Decline.
+    if (msg_type != DHCPREQUEST && msg_type != DHCPRELEASE &&
+        msg_type != DHCPDECLINE) {
         isc_throw(isc::BadValue, "invalid message type " << msg_type
-                  << " to be created from Reply, expected DHCPREQUEST or"
-                  " DHCPRELEASE");
+                  << " to be created from Reply, expected DHCPREQUEST,"
+                  " DHCPRELEASE or DHCPDECLINE");
     }
 
     // Get the string representation of the message - to be used for error
     // logging purposes.
     auto msg_type_str = [=]() -> const char* {
-        return (msg_type == DHCPREQUEST ? "Request" : "Release");
+        return (msg_type == DHCPREQUEST ? "Request" :
+                (msg_type == DHCPRELEASE ? "Release" : "Decline"));
     };
 
     if (!ack) {
@@ -187,11 +189,19 @@ TestControl::createMessageFromAck(const uint16_t msg_type,
                       << " from a DHCPACK message containing yiaddr of 0");
     }
     Pkt4Ptr msg(new Pkt4(msg_type, generateTransid()));
-    msg->setCiaddr(ack->getYiaddr());
+    if (msg_type == DHCPDECLINE) {
+        // RFC 2131: DHCPDECLINE carries the declined address in the
+        // requested IP address option and a zero ciaddr.
+        msg->addOption(OptionPtr(new Option(Option::V4,
+                                            DHO_DHCP_REQUESTED_ADDRESS,
+                                            ack->getYiaddr().toBytes())));
+    } else {
+        msg->setCiaddr(ack->getYiaddr());
+    }
     msg->setHWAddr(ack->getHWAddr());
     msg->addOption(generateClientId(msg->getHWAddr()));
-    if (msg_type == DHCPRELEASE) {
-        // RFC 2132: DHCPRELEASE MUST include server ID.
+    if (msg_type == DHCPRELEASE || msg_type == DHCPDECLINE) {
+        // RFC 2132: DHCPRELEASE and DHCPDECLINE MUST include server ID.
         if (options_.isUseFirst()) {
             // Honor the '-1' flag if it exists.
             if (first_packet_serverid_.empty()) {
@@ -224,17 +234,19 @@ TestControl::createMessageFromAck(const uint16_t msg_type,
 Pkt6Ptr
 TestControl::createMessageFromReply(const uint16_t msg_type,
                                     const dhcp::Pkt6Ptr& reply) {
-    // Restrict messages to Release and Renew.
-    if (msg_type != DHCPV6_RENEW && msg_type != DHCPV6_RELEASE) {
+    // Restrict messages to Renew, Release and Decline.
+    if (msg_type != DHCPV6_RENEW && msg_type != DHCPV6_RELEASE &&
+        msg_type != DHCPV6_DECLINE) {
         isc_throw(isc::BadValue, "invalid message type " << msg_type
-                  << " to be created from Reply, expected DHCPV6_RENEW or"
-                  " DHCPV6_RELEASE");
+                  << " to be created from Reply, expected DHCPV6_RENEW,"
+                  " DHCPV6_RELEASE or DHCPV6_DECLINE");
     }
 
     // Get the string representation of the message - to be used for error
     // logging purposes.
     auto msg_type_str = [=]() -> const char* {
-        return (msg_type == DHCPV6_RENEW ? "Renew" : "Release");
+        return (msg_type == DHCPV6_RENEW ? "Renew" :
+                (msg_type == DHCPV6_RELEASE ? "Release" : "Decline"));
     };
 
     // Reply message must be specified.
@@ -744,6 +756,14 @@ TestControl::printStats() const {
     if (options_.testDiags('i')) {
         stats_mgr_.printCustomCounters();
     }
+    if (!options_.getTimeSeriesFile().empty()) {
+        std::ofstream series_file(options_.getTimeSeriesFile().c_str());
+        if (!series_file.is_open()) {
+            isc_throw(BadValue, "unable to open time series file "
+                      << options_.getTimeSeriesFile());
+        }
+        stats_mgr_.printTimeSeries(series_file, options_.isTimeSeriesJson());
+    }
 }
 
 std::string
@@ -837,7 +857,8 @@ TestControl::processReceivedPacket4(const Pkt4Ptr& pkt4) {
             // Note that, DHCPACK messages hold the information about
             // leases assigned. We use this information to renew.
             if (stats_mgr_.hasExchangeStats(ExchangeType::RNA) ||
-                stats_mgr_.hasExchangeStats(ExchangeType::RLA)) {
+                stats_mgr_.hasExchangeStats(ExchangeType::RLA) ||
+                stats_mgr_.hasExchangeStats(ExchangeType::DLA)) {
                 // Renew or release messages are sent, because StatsMgr has the
                 // specific exchange type specified. Let's append the DHCPACK
                 // message to a storage.
@@ -849,7 +870,12 @@ TestControl::processReceivedPacket4(const Pkt4Ptr& pkt4) {
         // for renew specified, and if it has, if there is a corresponding
         // renew message for the received DHCPACK.
         } else if (stats_mgr_.hasExchangeStats(ExchangeType::RNA)) {
-            stats_mgr_.passRcvdPacket(ExchangeType::RNA, pkt4);
+            if (stats_mgr_.passRcvdPacket(ExchangeType::RNA, pkt4) &&
+                (options_.getScenario() == Scenario::CHURN)) {
+                // In the churn scenario the renewed lease may be renewed,
+                // released or declined again.
+                ack_storage_.append(pkt4);
+            }
         }
     }
 }
@@ -977,7 +1003,8 @@ TestControl::processReceivedPacket6(const Pkt6Ptr& pkt6) {
                 address6Uniqueness(pkt6, ExchangeType::RR);
                 // check if there is correct IA to continue with Renew/Release
                 if (stats_mgr_.hasExchangeStats(ExchangeType::RN) ||
-                    stats_mgr_.hasExchangeStats(ExchangeType::RL)) {
+                    stats_mgr_.hasExchangeStats(ExchangeType::RL) ||
+                    stats_mgr_.hasExchangeStats(ExchangeType::DL)) {
                     // Renew or Release messages are sent, because StatsMgr has the
                     // specific exchange type specified. Let's append the Reply
                     // message to a storage.
@@ -992,13 +1019,22 @@ TestControl::processReceivedPacket6(const Pkt6Ptr& pkt6) {
         // has exchange type for Renew specified, and if it has, if there is
         // a corresponding Renew message for the received Reply. If not,
         // we check that StatsMgr has exchange type for Release specified,
-        // as possibly the Reply has been sent in response to Release.
-        } else if (!(stats_mgr_.hasExchangeStats(ExchangeType::RN) &&
-                     stats_mgr_.passRcvdPacket(ExchangeType::RN, pkt6)) &&
-                   stats_mgr_.hasExchangeStats(ExchangeType::RL)) {
+        // as possibly the Reply has been sent in response to Release, and
+        // finally for Decline.
+        } else if (stats_mgr_.hasExchangeStats(ExchangeType::RN) &&
+                   stats_mgr_.passRcvdPacket(ExchangeType::RN, pkt6)) {
+            if ((options_.getScenario() == Scenario::CHURN) &&
+                validateIA(pkt6)) {
+                // In the churn scenario the renewed lease may be renewed,
+                // released or declined again.
+                reply_storage_.append(pkt6);
+            }
+        } else if (!(stats_mgr_.hasExchangeStats(ExchangeType::RL) &&
+                     stats_mgr_.passRcvdPacket(ExchangeType::RL, pkt6)) &&
+                   stats_mgr_.hasExchangeStats(ExchangeType::DL)) {
             // At this point, it is only possible that the Reply has been sent
-            // in response to a Release. Try to match the Reply with Release.
-            stats_mgr_.passRcvdPacket(ExchangeType::RL, pkt6);
+            // in response to a Decline.
+            stats_mgr_.passRcvdPacket(ExchangeType::DL, pkt6);
         }
     }
 }
@@ -1298,13 +1334,15 @@ TestControl::sendDiscover4(const std::vector<uint8_t>& template_buf,
 
 bool
 TestControl::sendMessageFromAck(const uint16_t msg_type) {
-    // We only permit Request or Release messages to be sent using this
-    // function.
-    if (msg_type != DHCPREQUEST && msg_type != DHCPRELEASE) {
+    // We only permit Request, Release or Decline messages to be sent using
+    // this function.
+    if (msg_type != DHCPREQUEST && msg_type != DHCPRELEASE &&
+        msg_type != DHCPDECLINE) {
         isc_throw(isc::BadValue,
                   "invalid message type "
                       << msg_type
-                      << " to be sent, expected DHCPREQUEST or DHCPRELEASE");
+                      << " to be sent, expected DHCPREQUEST, DHCPRELEASE"
+                      " or DHCPDECLINE");
     }
 
     // Get one of the recorded DHCPACK messages.
@@ -1330,7 +1368,8 @@ TestControl::sendMessageFromAck(const uint16_t msg_type) {
     socket_.send(msg);
     address4Uniqueness(msg, ExchangeType::RLA);
     stats_mgr_.passSentPacket((msg_type == DHCPREQUEST ? ExchangeType::RNA :
-                                                         ExchangeType::RLA),
+                               (msg_type == DHCPRELEASE ? ExchangeType::RLA :
+                                                          ExchangeType::DLA)),
                               msg);
     return (true);
 }
@@ -1338,10 +1377,13 @@ TestControl::sendMessageFromAck(const uint16_t msg_type) {
 
 bool
 TestControl::sendMessageFromReply(const uint16_t msg_type) {
-    // We only permit Release or Renew messages to be sent using this function.
-    if (msg_type != DHCPV6_RENEW && msg_type != DHCPV6_RELEASE) {
+    // We only permit Renew, Release or Decline messages to be sent using
+    // this function.
+    if (msg_type != DHCPV6_RENEW && msg_type != DHCPV6_RELEASE &&
+        msg_type != DHCPV6_DECLINE) {
         isc_throw(isc::BadValue, "invalid message type " << msg_type
-                  << " to be sent, expected DHCPV6_RENEW or DHCPV6_RELEASE");
+                  << " to be sent, expected DHCPV6_RENEW, DHCPV6_RELEASE"
+                  " or DHCPV6_DECLINE");
     }
 
     // Get one of the recorded DHCPV6_OFFER messages.
@@ -1362,8 +1404,10 @@ TestControl::sendMessageFromReply(const uint16_t msg_type) {
     // And send it.
     socket_.send(msg);
     address6Uniqueness(msg, ExchangeType::RL);
-    stats_mgr_.passSentPacket((msg_type == DHCPV6_RENEW ? ExchangeType::RN
-                                : ExchangeType::RL), msg);
+    stats_mgr_.passSentPacket((msg_type == DHCPV6_RENEW ? ExchangeType::RN :
+                               (msg_type == DHCPV6_RELEASE ? ExchangeType::RL :
+                                                             ExchangeType::DL)),
+                              msg);
     return (true);
 }
 
@@ -1842,6 +1886,19 @@ TestControl::setDefaults4(const Pkt4Ptr& pkt) {
     }
     // Pretend that we have one relay (which is us).
     pkt->setHops(1);
+    // The sender threads have their own ports so ask the server to
+    // respond to the source port (RFC 8357).
+    if (options_.getSenderThreads() > 1) {
+        OptionPtr rai = pkt->getOption(DHO_DHCP_AGENT_OPTIONS);
+        if (!rai) {
+            rai.reset(new Option(Option::V4, DHO_DHCP_AGENT_OPTIONS));
+            pkt->addOption(rai);
+        }
+        if (!rai->getOption(RAI_OPTION_RELAY_PORT)) {
+            rai->addOption(OptionPtr(new Option(Option::V4,
+                                                RAI_OPTION_RELAY_PORT)));
+        }
+    }
 }
 
 void
@@ -1880,6 +1937,16 @@ TestControl::setDefaults6(const Pkt6Ptr& pkt) {
           relay_info.linkaddr_ = IOAddress(socket_.addr_);
       }
       relay_info.peeraddr_ = IOAddress(socket_.addr_);
+      // The sender threads have their own ports so ask the server to
+      // respond to the source port (RFC 8357). The queries do not come
+      // from a downstream relay so the downstream port is 0.
+      if (options_.getSenderThreads() > 1) {
+          OptionPtr relay_port(new OptionInt<uint16_t>(Option::V6,
+                                                       D6O_RELAY_SOURCE_PORT,
+                                                       0));
+          relay_info.options_.insert(std::make_pair(D6O_RELAY_SOURCE_PORT,
+                                                    relay_port));
+      }
       pkt->addRelayInfo(relay_info);
     }
 }
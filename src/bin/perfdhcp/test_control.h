@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -25,6 +25,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -224,6 +225,11 @@ public:
     /// \brief Get interrupted flag.
     bool interrupted() const { return interrupted_; }
 
+    /// \brief Interrupts the test.
+    ///
+    /// It is used to stop all sender threads when one of them failed.
+    static void interrupt() { interrupted_ = true; }
+
     /// \brief Get stats manager.
     StatsMgr& getStatsMgr() { return stats_mgr_; };
 
@@ -269,8 +275,8 @@ public:
 
     /// \brief Send number of DHCPREQUEST (renew) messages to a server.
     ///
-    /// \param msg_type A type of the messages to be sent (DHCPREQUEST or
-    /// DHCPRELEASE).
+    /// \param msg_type A type of the messages to be sent (DHCPREQUEST,
+    /// DHCPRELEASE or DHCPDECLINE).
     /// \param msg_num A number of messages to be sent.
     ///
     /// \return A number of messages actually sent.
@@ -279,8 +285,8 @@ public:
 
     /// \brief Send number of DHCPv6 Renew or Release messages to the server.
     ///
-    /// \param msg_type A type of the messages to be sent (DHCPV6_RENEW or
-    /// DHCPV6_RELEASE).
+    /// \param msg_type A type of the messages to be sent (DHCPV6_RENEW,
+    /// DHCPV6_RELEASE or DHCPV6_DECLINE).
     /// \param msg_num A number of messages to be sent.
     ///
     /// \return A number of messages actually sent.
@@ -300,9 +306,11 @@ public:
 
     /// \brief Print performance statistics.
     ///
-    /// Method prints performance statistics.
+    /// Method prints performance statistics and writes the per second
+    /// statistics in the --time-series file.
     /// \throws isc::InvalidOperation if Statistics Manager was
     /// not initialized.
+    /// \throws isc::BadValue if the --time-series file can't be opened.
     void printStats() const;
 
     /// \brief Print templates information.
@@ -352,7 +360,8 @@ protected:
 
     /// \brief Creates DHCPREQUEST from a DHCPACK message.
     ///
-    /// @param msg_type the message type to be created (DHCPREQUEST or DHCPRELEASE)
+    /// @param msg_type the message type to be created (DHCPREQUEST,
+    /// DHCPRELEASE or DHCPDECLINE)
     /// \param ack An instance of the DHCPACK message to be used to
     /// create a new message.
     ///
@@ -362,17 +371,17 @@ protected:
 
     /// \brief Creates DHCPv6 message from the Reply packet.
     ///
-    /// This function creates DHCPv6 Renew or Release message using the
-    /// data from the Reply message by copying options from the Reply
+    /// This function creates DHCPv6 Renew, Release or Decline message using
+    /// the data from the Reply message by copying options from the Reply
     /// message.
     ///
     /// \param msg_type A type of the message to be created.
     /// \param reply An instance of the Reply packet which contents should
     /// be used to create an instance of the new message.
     ///
-    /// \return created Release or Renew message
-    /// \throw isc::BadValue if the msg_type is neither DHCPV6_RENEW nor
-    /// DHCPV6_RELEASE or if the reply is NULL.
+    /// \return created Release, Renew or Decline message
+    /// \throw isc::BadValue if the msg_type is not DHCPV6_RENEW,
+    /// DHCPV6_RELEASE or DHCPV6_DECLINE or if the reply is NULL.
     /// \throw isc::Unexpected if mandatory options are missing in the
     /// Reply message.
     dhcp::Pkt6Ptr createMessageFromReply(const uint16_t msg_type,
@@ -801,8 +810,8 @@ protected:
 
     /// \brief Send DHCPv4 renew (DHCPREQUEST).
     ///
-    /// \param msg_type A type of the message to be sent (DHCPREQUEST or
-    /// DHCPRELEASE).
+    /// \param msg_type A type of the message to be sent (DHCPREQUEST,
+    /// DHCPRELEASE or DHCPDECLINE).
     ///
     /// \return true if the message has been sent, false otherwise.
     bool sendMessageFromAck(const uint16_t msg_type);
@@ -813,8 +822,8 @@ protected:
     /// If there is no lease that can be renewed or released this method will
     /// return false.
     ///
-    /// \param msg_type A type of the message to be sent (DHCPV6_RENEW or
-    /// DHCPV6_RELEASE).
+    /// \param msg_type A type of the message to be sent (DHCPV6_RENEW,
+    /// DHCPV6_RELEASE or DHCPV6_DECLINE).
     ///
     /// \return true if the message has been sent, false otherwise.
     bool sendMessageFromReply(const uint16_t msg_type);
@@ -1103,8 +1112,8 @@ protected:
     /// \brief Template for v6.
     std::map<uint8_t, dhcp::Pkt6Ptr> template_packets_v6_;
 
-    /// \brief Program interrupted flag.
-    static bool interrupted_;
+    /// \brief Program interrupted flag, shared by the sender threads.
+    static std::atomic<bool> interrupted_;
 
     /// \brief Command options.
     CommandOptions& options_;
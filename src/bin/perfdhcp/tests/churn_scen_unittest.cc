@@ -0,0 +1,222 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include "command_options_helper.h"
+#include "../churn_scen.h"
+
+#include <asiolink/io_address.h>
+#include <exceptions/exceptions.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/pkt4.h>
+#include <dhcp/iface_mgr.h>
+#include <dhcp/option6_iaaddr.h>
+
+#include <list>
+#include <stdint.h>
+#include <string>
+#include <tuple>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace isc;
+using namespace isc::dhcp;
+using namespace isc::perfdhcp;
+
+namespace {
+
+/// \brief FakeChurnScenPerfSocket class that mocks PerfSocket.
+///
+/// It stubs send and receive operations and simulates DHCP server
+/// responses for sent packets, including the renewals, releases and
+/// declines.
+class FakeChurnScenPerfSocket: public BasePerfSocket {
+public:
+    /// \brief Default constructor for FakeChurnScenPerfSocket.
+    FakeChurnScenPerfSocket() :
+        iface_(boost::make_shared<Iface>("fake", 0)),
+        sent_cnt_(0) {};
+
+    IfacePtr iface_;  ///< Local fake interface.
+
+    int sent_cnt_;  ///< Counter of sent packets.
+
+    /// Number of sent packets by message type.
+    std::map<uint8_t, int> sent_types_;
+
+    /// List of pairs <msg_type, trans_id> containing responses
+    /// planned to send to perfdhcp.
+    std::list<std::tuple<uint8_t, uint32_t>> planned_responses_;
+
+    /// \brief Simulate receiving DHCPv4 packet.
+    virtual dhcp::Pkt4Ptr receive4(uint32_t, uint32_t) override {
+        if (planned_responses_.empty()) {
+            return Pkt4Ptr();
+        }
+        auto msg = planned_responses_.front();
+        planned_responses_.pop_front();
+        Pkt4Ptr pkt(new Pkt4(std::get<0>(msg), std::get<1>(msg)));
+        pkt->setYiaddr(asiolink::IOAddress("127.0.0.1"));
+        pkt->addOption(Option::factory(Option::V4, DHO_DHCP_SERVER_IDENTIFIER,
+                                       OptionBuffer(4, 1)));
+        pkt->updateTimestamp();
+        return (pkt);
+    };
+
+    /// \brief Simulate receiving DHCPv6 packet.
+    virtual dhcp::Pkt6Ptr receive6(uint32_t, uint32_t) override {
+        if (planned_responses_.empty()) {
+            return Pkt6Ptr();
+        }
+        auto msg = planned_responses_.front();
+        planned_responses_.pop_front();
+        Pkt6Ptr pkt(new Pkt6(std::get<0>(msg), std::get<1>(msg)));
+        OptionPtr opt_ia_na = Option::factory(Option::V6, D6O_IA_NA);
+        OptionPtr iaaddr(new Option6IAAddr(D6O_IAADDR,
+                                           asiolink::IOAddress("fe80::abcd"),
+                                           300, 500));
+        opt_ia_na->addOption(iaaddr);
+        pkt->addOption(opt_ia_na);
+        pkt->addOption(OptionPtr(new Option(Option::V6, D6O_SERVERID)));
+        std::vector<uint8_t> duid({0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+        pkt->addOption(Option::factory(Option::V6, D6O_CLIENTID, duid));
+        pkt->updateTimestamp();
+        return (pkt);
+    };
+
+    /// \brief Simulate sending DHCPv4 packet.
+    virtual bool send(const dhcp::Pkt4Ptr& pkt) override {
+        sent_cnt_++;
+        ++sent_types_[pkt->getType()];
+        pkt->updateTimestamp();
+        if (pkt->getType() == DHCPDISCOVER) {
+            planned_responses_.push_back(std::make_tuple(DHCPOFFER, pkt->getTransid()));
+        } else if (pkt->getType() == DHCPREQUEST) {
+            planned_responses_.push_back(std::make_tuple(DHCPACK, pkt->getTransid()));
+        }
+        // There is no response to DHCPRELEASE and DHCPDECLINE.
+        return true;
+    };
+
+    /// \brief Simulate sending DHCPv6 packet.
+    virtual bool send(const dhcp::Pkt6Ptr& pkt) override {
+        sent_cnt_++;
+        ++sent_types_[pkt->getType()];
+        pkt->updateTimestamp();
+        if (pkt->getType() == DHCPV6_SOLICIT) {
+            planned_responses_.push_back(std::make_tuple(DHCPV6_ADVERTISE, pkt->getTransid()));
+        } else {
+            planned_responses_.push_back(std::make_tuple(DHCPV6_REPLY, pkt->getTransid()));
+        }
+        return true;
+    };
+
+    /// \brief Override getting interface.
+    virtual IfacePtr getIface() override { return iface_; }
+};
+
+/// \brief NakedChurnScen class.
+///
+/// It exposes ChurnScen internals for UT.
+class NakedChurnScen: public ChurnScen {
+public:
+    using ChurnScen::tc_;
+    using ChurnScen::storm_sent_;
+
+    FakeChurnScenPerfSocket fake_sock_;
+
+    NakedChurnScen(CommandOptions &opt) : ChurnScen(opt, fake_sock_), fake_sock_() {};
+};
+
+/// \brief Parse command line string with CommandOptions.
+///
+/// \param cmdline command line string to be parsed.
+void processCmdLine(CommandOptions &opt, const std::string& cmdline) {
+    CommandOptionsHelper::process(opt, cmdline);
+}
+
+// A pure DHCPv4 renewal storm renews each lease once.
+TEST(ChurnScenTest, Packet4RenewalStorm) {
+    CommandOptions opt;
+    processCmdLine(opt, "perfdhcp -l fake -4 -R 10 -d 0.1 --scenario churn"
+                   " -g single 127.0.0.1");
+    NakedChurnScen cs(opt);
+
+    cs.run();
+
+    const StatsMgr& stats_mgr(cs.tc_.getStatsMgr());
+    EXPECT_EQ(10, stats_mgr.getSentPacketsNum(ExchangeType::DO));
+    EXPECT_EQ(10, stats_mgr.getRcvdPacketsNum(ExchangeType::RA));
+    EXPECT_EQ(10, stats_mgr.getSentPacketsNum(ExchangeType::RNA));
+    EXPECT_EQ(10, stats_mgr.getRcvdPacketsNum(ExchangeType::RNA));
+    EXPECT_EQ(10, cs.storm_sent_[CommandOptions::CHURN_RENEW]);
+    EXPECT_EQ(0, cs.storm_sent_[CommandOptions::CHURN_NEW]);
+    EXPECT_FALSE(stats_mgr.hasExchangeStats(ExchangeType::RLA));
+    EXPECT_FALSE(stats_mgr.hasExchangeStats(ExchangeType::DLA));
+}
+
+// The renewed leases can be renewed again.
+TEST(ChurnScenTest, Packet4LeaseReuse) {
+    CommandOptions opt;
+    processCmdLine(opt, "perfdhcp -l fake -4 -R 10 -d 0.1 -n 30"
+                   " --scenario churn -g single 127.0.0.1");
+    NakedChurnScen cs(opt);
+
+    cs.run();
+
+    const StatsMgr& stats_mgr(cs.tc_.getStatsMgr());
+    EXPECT_EQ(30, cs.storm_sent_[CommandOptions::CHURN_RENEW] +
+              cs.storm_sent_[CommandOptions::CHURN_NEW]);
+    EXPECT_EQ(cs.storm_sent_[CommandOptions::CHURN_RENEW],
+              stats_mgr.getSentPacketsNum(ExchangeType::RNA));
+    EXPECT_LT(10, stats_mgr.getSentPacketsNum(ExchangeType::RNA));
+}
+
+// The released and declined leases can't be used again so the messages
+// without lease are sent by new clients.
+TEST(ChurnScenTest, Packet4ReleaseDecline) {
+    CommandOptions opt;
+    processCmdLine(opt, "perfdhcp -l fake -4 -R 10 -d 0.1 -n 15"
+                   " --churn-mix 0,50,50,0 --scenario churn -g single"
+                   " 127.0.0.1");
+    NakedChurnScen cs(opt);
+
+    cs.run();
+
+    const StatsMgr& stats_mgr(cs.tc_.getStatsMgr());
+    uint64_t released = cs.storm_sent_[CommandOptions::CHURN_RELEASE];
+    uint64_t declined = cs.storm_sent_[CommandOptions::CHURN_DECLINE];
+    uint64_t new_clients = cs.storm_sent_[CommandOptions::CHURN_NEW];
+    EXPECT_EQ(15, released + declined + new_clients);
+    EXPECT_LE(5, new_clients);
+    EXPECT_EQ(released, stats_mgr.getSentPacketsNum(ExchangeType::RLA));
+    EXPECT_EQ(declined, stats_mgr.getSentPacketsNum(ExchangeType::DLA));
+    EXPECT_EQ(declined, cs.fake_sock_.sent_types_[DHCPDECLINE]);
+    EXPECT_EQ(10 + new_clients, stats_mgr.getSentPacketsNum(ExchangeType::DO));
+    EXPECT_FALSE(stats_mgr.hasExchangeStats(ExchangeType::RNA));
+}
+
+// A DHCPv6 storm mixing renewals and declines gets replies for both.
+TEST(ChurnScenTest, Packet6RenewDecline) {
+    CommandOptions opt;
+    processCmdLine(opt, "perfdhcp -l fake -6 -R 10 -d 0.1 -n 10"
+                   " --churn-mix 50,0,50,0 --scenario churn -g single ::1");
+    NakedChurnScen cs(opt);
+
+    cs.run();
+
+    const StatsMgr& stats_mgr(cs.tc_.getStatsMgr());
+    EXPECT_EQ(10, stats_mgr.getRcvdPacketsNum(ExchangeType::RR));
+    uint64_t renewed = cs.storm_sent_[CommandOptions::CHURN_RENEW];
+    uint64_t declined = cs.storm_sent_[CommandOptions::CHURN_DECLINE];
+    EXPECT_EQ(renewed, stats_mgr.getRcvdPacketsNum(ExchangeType::RN));
+    EXPECT_EQ(declined, stats_mgr.getRcvdPacketsNum(ExchangeType::DL));
+    EXPECT_EQ(declined, cs.fake_sock_.sent_types_[DHCPV6_DECLINE]);
+    EXPECT_FALSE(stats_mgr.hasExchangeStats(ExchangeType::RL));
+}
+
+}  // namespace
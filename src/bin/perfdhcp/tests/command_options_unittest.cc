@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -898,3 +898,127 @@ TEST_F(CommandOptionsTest, ElapsedTime) {
     EXPECT_EQ(3, opt.getIncreaseElapsedTime());
     EXPECT_EQ(10, opt.getWaitForElapsedTime());
 }
+
+TEST_F(CommandOptionsTest, SenderThreads) {
+    CommandOptions opt;
+    EXPECT_NO_THROW(process(opt, "perfdhcp -4 -R 10 -r 100 -n 50 --threads 3"
+                            " 192.168.0.1"));
+    EXPECT_EQ(3, opt.getSenderThreads());
+
+    // The first thread gets the remainders.
+    CommandOptions first(opt);
+    ASSERT_NO_THROW(first.setSenderThread(0));
+    EXPECT_EQ(34, first.getRate());
+    EXPECT_EQ(4, first.getClientsNum());
+    ASSERT_EQ(1, first.getNumRequests().size());
+    EXPECT_EQ(17, first.getNumRequests()[0]);
+    EXPECT_EQ(67, first.getLocalPort());
+    EXPECT_EQ(opt.getMacTemplate(), first.getMacTemplate());
+    EXPECT_TRUE(first.isSingleThreaded());
+
+    // The last thread gets the clients after the ones of the other threads.
+    CommandOptions last(opt);
+    ASSERT_NO_THROW(last.setSenderThread(2));
+    EXPECT_EQ(33, last.getRate());
+    EXPECT_EQ(3, last.getClientsNum());
+    EXPECT_EQ(16, last.getNumRequests()[0]);
+    EXPECT_EQ(69, last.getLocalPort());
+    std::vector<uint8_t> mac = opt.getMacTemplate();
+    mac.back() += 7;
+    EXPECT_EQ(mac, last.getMacTemplate());
+
+    CommandOptions invalid(opt);
+    EXPECT_THROW(invalid.setSenderThread(3), isc::OutOfRange);
+}
+
+TEST_F(CommandOptionsTest, SenderThreadsNegativeCases) {
+    CommandOptions opt;
+    // Less clients than threads.
+    EXPECT_THROW(process(opt, "perfdhcp -4 -R 2 --threads 3 192.168.0.1"),
+                 isc::InvalidParameter);
+    // Lower rate than threads.
+    EXPECT_THROW(process(opt, "perfdhcp -4 -R 10 -r 2 --threads 3 192.168.0.1"),
+                 isc::InvalidParameter);
+    // Templates are not supported.
+    EXPECT_THROW(process(opt, "perfdhcp -4 -R 10 -T file.x --threads 3"
+                         " 192.168.0.1"), isc::InvalidParameter);
+    // The IPv6 responses are sent back to the relay source port.
+    EXPECT_THROW(process(opt, "perfdhcp -6 -R 10 --threads 3 -l ethx all"),
+                 isc::InvalidParameter);
+}
+
+TEST_F(CommandOptionsTest, TimeSeries) {
+    CommandOptions opt;
+    EXPECT_NO_THROW(process(opt, "perfdhcp -4 --time-series series.csv"
+                            " 192.168.0.1"));
+    EXPECT_EQ("series.csv", opt.getTimeSeriesFile());
+    EXPECT_FALSE(opt.isTimeSeriesJson());
+
+    EXPECT_NO_THROW(process(opt, "perfdhcp -4 --time-series series.json"
+                            " 192.168.0.1"));
+    EXPECT_EQ("series.json", opt.getTimeSeriesFile());
+    EXPECT_TRUE(opt.isTimeSeriesJson());
+
+    EXPECT_NO_THROW(process(opt, "perfdhcp -4 192.168.0.1"));
+    EXPECT_TRUE(opt.getTimeSeriesFile().empty());
+}
+
+TEST_F(CommandOptionsTest, ChurnScenario) {
+    CommandOptions opt;
+    EXPECT_NO_THROW(process(opt, "perfdhcp -4 -R 100 --scenario churn"
+                            " 192.168.0.1"));
+    EXPECT_EQ(Scenario::CHURN, opt.getScenario());
+    // By default the storm only renews the leases of all clients.
+    EXPECT_EQ(100, opt.getChurnWeight(CommandOptions::CHURN_RENEW));
+    EXPECT_EQ(0, opt.getChurnWeight(CommandOptions::CHURN_RELEASE));
+    EXPECT_EQ(0, opt.getChurnWeight(CommandOptions::CHURN_DECLINE));
+    EXPECT_EQ(0, opt.getChurnWeight(CommandOptions::CHURN_NEW));
+    EXPECT_EQ(100, opt.getChurnLeased());
+
+    EXPECT_NO_THROW(process(opt, "perfdhcp -6 -R 100 --scenario churn"
+                            " --churn-mix 70,10,5,15 --churn-leased 80"
+                            " -l ethx all"));
+    EXPECT_EQ(70, opt.getChurnWeight(CommandOptions::CHURN_RENEW));
+    EXPECT_EQ(10, opt.getChurnWeight(CommandOptions::CHURN_RELEASE));
+    EXPECT_EQ(5, opt.getChurnWeight(CommandOptions::CHURN_DECLINE));
+    EXPECT_EQ(15, opt.getChurnWeight(CommandOptions::CHURN_NEW));
+    EXPECT_EQ(80, opt.getChurnLeased());
+
+    // Without leased clients the number of storm messages is required.
+    EXPECT_NO_THROW(process(opt, "perfdhcp -4 -R 100 --scenario churn"
+                            " --churn-leased 0 -n 50 192.168.0.1"));
+    EXPECT_EQ(0, opt.getChurnLeased());
+}
+
+TEST_F(CommandOptionsTest, ChurnScenarioNegativeCases) {
+    CommandOptions opt;
+    // The mix has four weights.
+    EXPECT_THROW(process(opt, "perfdhcp -4 -R 100 --scenario churn"
+                         " --churn-mix 70,30 192.168.0.1"),
+                 isc::InvalidParameter);
+    // The weights are not negative.
+    EXPECT_THROW(process(opt, "perfdhcp -4 -R 100 --scenario churn"
+                         " --churn-mix 70,-10,20,20 192.168.0.1"),
+                 isc::InvalidParameter);
+    // At least one weight is positive.
+    EXPECT_THROW(process(opt, "perfdhcp -4 -R 100 --scenario churn"
+                         " --churn-mix 0,0,0,0 192.168.0.1"),
+                 isc::InvalidParameter);
+    // The leased percentage is in the 0..100 range.
+    EXPECT_THROW(process(opt, "perfdhcp -4 -R 100 --scenario churn"
+                         " --churn-leased 101 192.168.0.1"),
+                 isc::InvalidParameter);
+    // The clients number is required.
+    EXPECT_THROW(process(opt, "perfdhcp -4 --scenario churn 192.168.0.1"),
+                 isc::InvalidParameter);
+    // The 4-way exchanges are required.
+    EXPECT_THROW(process(opt, "perfdhcp -4 -R 100 -i --scenario churn"
+                         " 192.168.0.1"), isc::InvalidParameter);
+    // The renew and release rates are not used.
+    EXPECT_THROW(process(opt, "perfdhcp -4 -R 100 -r 10 -f 5 --scenario churn"
+                         " 192.168.0.1"), isc::InvalidParameter);
+    // Without leased clients the number of storm messages is required.
+    EXPECT_THROW(process(opt, "perfdhcp -4 -R 100 --scenario churn"
+                         " --churn-leased 0 192.168.0.1"),
+                 isc::InvalidParameter);
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -491,6 +491,47 @@ TEST_F(StatsMgrTest, Delays) {
     EXPECT_GT(stats_mgr->getStdDevDelay(ExchangeType::DO), 0);
 }
 
+TEST_F(StatsMgrTest, DelayPercentiles) {
+    CommandOptions opt;
+    boost::shared_ptr<StatsMgr> stats_mgr(new StatsMgr(opt));
+    stats_mgr->addExchangeStats(ExchangeType::DO, 5);
+    EXPECT_THROW(stats_mgr->getDelayPercentile(ExchangeType::DO, 50.),
+                 isc::InvalidOperation);
+
+    // Pass 9 exchanges with 1s delay and one with 2s delay.
+    for (uint32_t i = 0; i < 9; ++i) {
+        passDOPacketsWithDelay(stats_mgr, 1, common_transid + i);
+    }
+    passDOPacketsWithDelay(stats_mgr, 2, common_transid + 9);
+
+    EXPECT_GE(stats_mgr->getDelayPercentile(ExchangeType::DO, 50.), 1.);
+    EXPECT_LT(stats_mgr->getDelayPercentile(ExchangeType::DO, 50.), 1.05);
+    EXPECT_LT(stats_mgr->getDelayPercentile(ExchangeType::DO, 90.), 1.05);
+    EXPECT_GE(stats_mgr->getDelayPercentile(ExchangeType::DO, 99.), 2.);
+    EXPECT_LT(stats_mgr->getDelayPercentile(ExchangeType::DO, 99.), 2.1);
+}
+
+TEST_F(StatsMgrTest, TimeSeries) {
+    CommandOptions opt;
+    boost::shared_ptr<StatsMgr> stats_mgr(new StatsMgr(opt));
+    stats_mgr->addExchangeStats(ExchangeType::DO, 5);
+    passDOPacketsWithDelay(stats_mgr, 0, common_transid);
+    passDOPacketsWithDelay(stats_mgr, 0, common_transid + 1);
+
+    // Packets were sent and received during the first second.
+    std::ostringstream csv;
+    stats_mgr->printTimeSeries(csv, false);
+    EXPECT_EQ("second,exchange,sent,received\n"
+              "0,DISCOVER-OFFER,2,2\n", csv.str());
+
+    std::ostringstream json;
+    stats_mgr->printTimeSeries(json, true);
+    EXPECT_NE(std::string::npos,
+              json.str().find("{ \"second\": 0, \"sent\": 2, \"received\": 2 }"))
+        << json.str();
+    EXPECT_NE(std::string::npos, json.str().find("\"p99.9\": ")) << json.str();
+}
+
 TEST_F(StatsMgrTest, CustomCounters) {
     CommandOptions opt;
     boost::scoped_ptr<StatsMgr> stats_mgr(new StatsMgr(opt));
@@ -531,6 +572,33 @@ TEST_F(StatsMgrTest, CustomCounters) {
 
 }
 
+TEST_F(StatsMgrTest, Merge) {
+    CommandOptions opt;
+    boost::shared_ptr<StatsMgr> stats_mgr(new StatsMgr(opt));
+    stats_mgr->addExchangeStats(ExchangeType::DO, 5);
+    stats_mgr->addCustomCounter("tooshort", "Too short packets");
+    passDOPacketsWithDelay(stats_mgr, 2, common_transid);
+
+    boost::shared_ptr<StatsMgr> other(new StatsMgr(opt));
+    other->addExchangeStats(ExchangeType::DO, 5);
+    other->addCustomCounter("tooshort", "Too short packets");
+    passDOPacketsWithDelay(other, 1, common_transid + 1);
+    other->incrementCounter("tooshort");
+
+    ASSERT_NO_THROW(stats_mgr->merge(*other));
+
+    // The counters are summed and the delays cover both exchanges.
+    EXPECT_EQ(2, stats_mgr->getSentPacketsNum(ExchangeType::DO));
+    EXPECT_EQ(2, stats_mgr->getRcvdPacketsNum(ExchangeType::DO));
+    EXPECT_LT(stats_mgr->getMinDelay(ExchangeType::DO), 2);
+    EXPECT_GT(stats_mgr->getMaxDelay(ExchangeType::DO), 2);
+    EXPECT_GT(stats_mgr->getStdDevDelay(ExchangeType::DO), 0);
+    EXPECT_EQ(1, stats_mgr->getCounter("tooshort")->getValue());
+
+    // The other statistics are not modified.
+    EXPECT_EQ(1, other->getSentPacketsNum(ExchangeType::DO));
+}
+
 TEST_F(StatsMgrTest, PrintStats) {
     std::cout << "This unit test is checking statistics printing "
               << "capabilities. It is expected that some counters "
@@ -1747,6 +1747,42 @@ TEST_F(TestControlTest, createRelease6) {
     testCreateRenewRelease6(DHCPV6_RELEASE);
 }
 
+// This test verifies that DHCPDECLINE is created correctly from the
+// DHCPACK message: the declined address is in the requested address
+// option and the ciaddr is zero.
+TEST_F(TestControlTest, createDecline4) {
+    CommandOptions opt;
+    processCmdLine(opt, "perfdhcp -4 -l lo -R 10 -L 10067 --scenario churn"
+                   " --churn-mix 0,0,100,0 127.0.0.1");
+    NakedTestControl tc(opt);
+
+    Pkt4Ptr ack = createAckPkt4(1);
+    Pkt4Ptr msg;
+    ASSERT_NO_THROW(msg = tc.createMessageFromAck(DHCPDECLINE, ack));
+    ASSERT_TRUE(msg);
+    EXPECT_EQ(DHCPDECLINE, msg->getType());
+    EXPECT_TRUE(msg->getCiaddr().isV4Zero());
+
+    OptionPtr requested = msg->getOption(DHO_DHCP_REQUESTED_ADDRESS);
+    ASSERT_TRUE(requested);
+    EXPECT_TRUE(ack->getYiaddr().toBytes() == requested->getData());
+
+    OptionPtr server_id = msg->getOption(DHO_DHCP_SERVER_IDENTIFIER);
+    ASSERT_TRUE(server_id);
+    EXPECT_TRUE(ack->getOption(DHO_DHCP_SERVER_IDENTIFIER)->getData() ==
+                server_id->getData());
+
+    // Creating message from null DHCPACK should fail.
+    EXPECT_THROW(tc.createMessageFromAck(DHCPDECLINE, Pkt4Ptr()),
+                 isc::BadValue);
+}
+
+// This test verifies that the DHCPv6 Decline message is created correctly
+// and that it comprises all required options.
+TEST_F(TestControlTest, createDecline6) {
+    testCreateRenewRelease6(DHCPV6_DECLINE);
+}
+
 // This test verifies that the counter of rejected leases in
 // Solicit-Advertise message exchange works correctly
 TEST_F(TestControlTest, rejectedLeasesAdv) {
@@ -0,0 +1,89 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <perfdhcp/threaded_scen.h>
+
+#include <exceptions/exceptions.h>
+
+#include <functional>
+#include <thread>
+
+using namespace std;
+using namespace isc;
+
+
+namespace isc {
+namespace perfdhcp {
+
+
+ThreadedScen::ThreadedScen(CommandOptions& options)
+    : options_(options), errors_(options.getSenderThreads()) {
+    for (uint32_t i = 0; i < options_.getSenderThreads(); ++i) {
+        boost::shared_ptr<CommandOptions> thread_options(new CommandOptions(options_));
+        thread_options->setSenderThread(i);
+        thread_options_.push_back(thread_options);
+        sockets_.push_back(boost::shared_ptr<PerfSocket>(new PerfSocket(*thread_options)));
+    }
+
+    // The scenario reporting the merged statistics is created first so
+    // its test period covers the ones of the threads. It does not send
+    // any packet so it can borrow the socket of the first thread.
+    report_scen_.reset(new BasicScen(options_, *sockets_[0]));
+    for (uint32_t i = 0; i < options_.getSenderThreads(); ++i) {
+        scens_.push_back(boost::shared_ptr<BasicScen>(new BasicScen(*thread_options_[i],
+                                                                    *sockets_[i])));
+    }
+}
+
+void
+ThreadedScen::runThread(size_t index) {
+    try {
+        scens_[index]->runTraffic();
+    } catch (const std::exception& ex) {
+        errors_[index] = ex.what();
+        // Stop the other threads.
+        TestControl::interrupt();
+    } catch (...) {
+        errors_[index] = "unknown error";
+        TestControl::interrupt();
+    }
+}
+
+int
+ThreadedScen::run() {
+    TestControl& tc = report_scen_->getTestControl();
+
+    // Fork and run command specified with -w<wrapped-command>
+    if (!options_.getWrapped().empty()) {
+        tc.runWrapped();
+    }
+
+    vector<thread> threads;
+    for (size_t i = 0; i < scens_.size(); ++i) {
+        threads.push_back(thread(bind(&ThreadedScen::runThread, this, i)));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (size_t i = 0; i < errors_.size(); ++i) {
+        if (!errors_[i].empty()) {
+            isc_throw(Unexpected, "sender thread " << i << " failed: "
+                      << errors_[i]);
+        }
+    }
+
+    StatsMgr& stats_mgr = tc.getStatsMgr();
+    for (auto const& scen : scens_) {
+        stats_mgr.merge(scen->getTestControl().getStatsMgr());
+    }
+    return (report_scen_->report());
+}
+
+}  // namespace perfdhcp
+}  // namespace isc
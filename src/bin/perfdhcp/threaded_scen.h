@@ -0,0 +1,82 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef THREADED_SCEN_H
+#define THREADED_SCEN_H
+
+#include <config.h>
+
+#include <perfdhcp/basic_scen.h>
+#include <perfdhcp/command_options.h>
+#include <perfdhcp/perf_socket.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace perfdhcp {
+
+
+/// \brief Basic scenario run by several sender threads.
+///
+/// A single thread can not send and receive fast enough to find the
+/// limits of a multi-threaded server. In the --threads mode each sender
+/// thread runs its own \ref BasicScen with its own copy of the command
+/// options (see \ref CommandOptions::setSenderThread), its own socket
+/// and its own range of clients, and keeps its own statistics. When all
+/// threads are finished, their statistics are merged and reported as
+/// for a single thread.
+class ThreadedScen : public boost::noncopyable {
+public:
+    /// \brief Constructor.
+    ///
+    /// Opens the sockets of the sender threads.
+    ///
+    /// \param options reference to command options.
+    ThreadedScen(CommandOptions& options);
+
+    /// \brief Run performance test.
+    ///
+    /// Runs the sender threads and reports the merged statistics.
+    ///
+    /// \throw isc::Unexpected if a sender thread failed.
+    /// \return execution status.
+    int run();
+
+private:
+    /// \brief Runs the traffic of a sender thread.
+    ///
+    /// \param index index of the thread.
+    void runThread(size_t index);
+
+    /// \brief Reference to command options.
+    CommandOptions& options_;
+
+    /// \brief Command options of the sender threads.
+    std::vector<boost::shared_ptr<CommandOptions> > thread_options_;
+
+    /// \brief Sockets of the sender threads.
+    std::vector<boost::shared_ptr<PerfSocket> > sockets_;
+
+    /// \brief Scenarios run by the sender threads.
+    std::vector<boost::shared_ptr<BasicScen> > scens_;
+
+    /// \brief Scenario with the original options reporting the merged
+    /// statistics.
+    boost::scoped_ptr<BasicScen> report_scen_;
+
+    /// \brief Errors of the sender threads.
+    std::vector<std::string> errors_;
+};
+
+}
+}
+
+#endif // THREADED_SCEN_H
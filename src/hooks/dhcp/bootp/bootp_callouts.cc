@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2019-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,13 +9,20 @@
 #include <bootp_log.h>
 #include <hooks/hooks.h>
 #include <dhcp/pkt4.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/host.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/shared_network.h>
+#include <dhcpsrv/subnet.h>
 #include <process/daemon.h>
 #include <stats/stats_mgr.h>
 
 #include <vector>
 
 using namespace isc;
+using namespace isc::asiolink;
 using namespace isc::bootp;
+using namespace isc::data;
 using namespace isc::dhcp;
 using namespace isc::hooks;
 using namespace isc::log;
@@ -49,6 +56,62 @@ const size_t BOOT_MIN_SIZE = Pkt4::DHCPV4_PKT_HDR_LEN + BOOT_VENDOR_SPACE_SIZE;
 // Check as compile time it is really 300!
 static_assert(BOOT_MIN_SIZE == 300, "BOOT_MIN_SIZE is not 300");
 
+// Name of the callout context holding the reserved address.
+const std::string STATIC_CONTEXT = "bootp-static";
+
+// Serve the BOOTP clients with a reservation without lease.
+bool static_leases = false;
+
+/// @brief Returns the address reserved for a BOOTP client.
+///
+/// Only the reservations by hardware address in the configuration are
+/// looked for: in the selected subnet, in the other subnets of its shared
+/// network and in the global reservations.
+///
+/// @param query The BOOTP query.
+/// @return The reserved address or the zero address when none.
+IOAddress
+getReservedAddress(const Pkt4Ptr& query) {
+    HWAddrPtr hwaddr = query->getHWAddr();
+    if (!hwaddr || hwaddr->hwaddr_.empty()) {
+        return (IOAddress::IPV4_ZERO_ADDRESS());
+    }
+    SrvConfigPtr cfg = CfgMgr::instance().getCurrentCfg();
+    ConstSubnet4Ptr subnet = cfg->getCfgSubnets4()->
+        selectSubnet(CfgSubnets4::initSelector(query));
+    if (!subnet) {
+        return (IOAddress::IPV4_ZERO_ADDRESS());
+    }
+    std::vector<ConstSubnet4Ptr> subnets;
+    SharedNetwork4Ptr network;
+    subnet->getSharedNetwork(network);
+    if (network) {
+        for (auto const& member : *network->getAllSubnets()) {
+            subnets.push_back(member);
+        }
+    } else {
+        subnets.push_back(subnet);
+    }
+    ConstCfgHostsPtr hosts = cfg->getCfgHosts();
+    const std::vector<uint8_t>& id = hwaddr->hwaddr_;
+    for (auto const& candidate : subnets) {
+        ConstHostPtr host;
+        if (candidate->getReservationsInSubnet()) {
+            host = hosts->get4(candidate->getID(), Host::IDENT_HWADDR,
+                               &id[0], id.size());
+        }
+        if (!host && candidate->getReservationsGlobal()) {
+            host = hosts->get4(SUBNET_ID_GLOBAL, Host::IDENT_HWADDR,
+                               &id[0], id.size());
+        }
+        if (host && !host->getIPv4Reservation().isV4Zero() &&
+            candidate->inRange(host->getIPv4Reservation())) {
+            return (host->getIPv4Reservation());
+        }
+    }
+    return (IOAddress::IPV4_ZERO_ADDRESS());
+}
+
 } // end of anonymous namespace.
 
 // Functions accessed by the hooks framework use C linkage to avoid the name
@@ -122,6 +185,83 @@ int buffer4_receive(CalloutHandle& handle) {
     return (0);
 }
 
+/// @brief This callout is called at the "pkt4_receive" hook.
+///
+/// When the static-leases parameter is true and the BOOTP client has
+/// a reserved address, set the message type to DHCPDISCOVER: the server
+/// then answers with the reserved address from the configuration
+/// without writing a lease into the lease database.
+///
+/// @param handle CalloutHandle.
+///
+/// @return 0 upon success, non-zero otherwise.
+int pkt4_receive(CalloutHandle& handle) {
+    CalloutHandle::CalloutNextStep status = handle.getStatus();
+    if (!static_leases || (status == CalloutHandle::NEXT_STEP_DROP)) {
+        return (0);
+    }
+
+    // Get the query message.
+    Pkt4Ptr query;
+    handle.getArgument("query4", query);
+
+    // Check if it is a BOOTP query.
+    if (!query->inClass("BOOTP") || (query->getType() != DHCPREQUEST)) {
+        return (0);
+    }
+
+    IOAddress address = getReservedAddress(query);
+    if (address.isV4Zero()) {
+        return (0);
+    }
+
+    query->setType(DHCPDISCOVER);
+    handle.setContext(STATIC_CONTEXT, address);
+
+    LOG_DEBUG(bootp_logger, DBGLVL_TRACE_BASIC, BOOTP_STATIC_QUERY)
+        .arg(query->getLabel())
+        .arg(address);
+
+    return (0);
+}
+
+/// @brief This callout is called at the "lease4_select" hook.
+///
+/// Refuse to offer another address than the reserved one to a BOOTP
+/// client served without lease: another address would be lost at the
+/// next query as there is no lease to remember it.
+///
+/// @param handle CalloutHandle.
+///
+/// @return 0 upon success, non-zero otherwise.
+int lease4_select(CalloutHandle& handle) {
+    CalloutHandle::CalloutNextStep status = handle.getStatus();
+    if (!static_leases || (status == CalloutHandle::NEXT_STEP_SKIP)) {
+        return (0);
+    }
+
+    IOAddress address = IOAddress::IPV4_ZERO_ADDRESS();
+    try {
+        handle.getContext(STATIC_CONTEXT, address);
+    } catch (const NoSuchCalloutContext&) {
+        return (0);
+    }
+
+    Lease4Ptr lease;
+    handle.getArgument("lease4", lease);
+    if (lease && (lease->addr_ != address)) {
+        Pkt4Ptr query;
+        handle.getArgument("query4", query);
+        LOG_DEBUG(bootp_logger, DBGLVL_TRACE_BASIC, BOOTP_STATIC_LEASE_MISMATCH)
+            .arg(query->getLabel())
+            .arg(lease->addr_)
+            .arg(address);
+        handle.setStatus(CalloutHandle::NEXT_STEP_SKIP);
+    }
+
+    return (0);
+}
+
 /// @brief This callout is called at the "pkt4_send" hook.
 ///
 /// Remove DHCP specific options and pad the buffer to 300 octets.
@@ -185,13 +325,22 @@ int pkt4_send(CalloutHandle& handle) {
 
 /// @brief This function is called when the library is loaded.
 ///
+/// @param handle library handle
 /// @return always 0.
-int load(LibraryHandle& /* handle */) {
+int load(LibraryHandle& handle) {
     const std::string& proc_name = Daemon::getProcName();
     if (proc_name != "kea-dhcp4") {
         isc_throw(isc::Unexpected, "Bad process name: " << proc_name
                   << ", expected kea-dhcp4");
     }
+    static_leases = false;
+    ConstElementPtr static_param = handle.getParameter("static-leases");
+    if (static_param) {
+        if (static_param->getType() != Element::boolean) {
+            isc_throw(BadValue, "'static-leases' parameter must be a boolean");
+        }
+        static_leases = static_param->boolValue();
+    }
     LOG_INFO(bootp_logger, BOOTP_LOAD);
     return (0);
 }
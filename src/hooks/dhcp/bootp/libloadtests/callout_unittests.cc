@@ -0,0 +1,179 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file This file contains tests which exercise the pkt4_receive and
+/// lease4_select callouts called by the bootp hook library with the
+/// static-leases parameter. In order to test the callouts one must be
+/// able to pass to the load function it hook library parameters because
+/// the only way to populate these parameters is by actually loading the
+/// library via HooksManager::loadLibraries().
+
+#include <config.h>
+
+#include <hooks/hooks.h>
+#include <hooks/hooks_manager.h>
+#include <dhcp/pkt4.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/host.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/subnet.h>
+#include <process/daemon.h>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::hooks;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::process;
+
+namespace {
+
+/// @brief Structure that holds registered hook indexes.
+struct TestHooks {
+    /// @brief Index of pkt4_receive callout.
+    int hook_index_pkt4_receive_;
+
+    /// @brief Index of lease4_select callout.
+    int hook_index_lease4_select_;
+
+    /// @brief Constructor
+    ///
+    /// The constructor registers hook points for callout tests.
+    TestHooks() {
+        hook_index_pkt4_receive_ = HooksManager::registerHook("pkt4_receive");
+        hook_index_lease4_select_ = HooksManager::registerHook("lease4_select");
+    }
+};
+
+TestHooks testHooks;
+
+/// @brief Test fixture for testing callouts called by the bootp library
+class CalloutTest : public ::testing::Test {
+public:
+    /// @brief Constructor
+    CalloutTest() {
+        reset();
+        configure();
+    }
+
+    /// @brief Destructor
+    virtual ~CalloutTest() {
+        reset();
+    }
+
+    /// @brief Unloads the libraries and clears the configuration.
+    virtual void reset() {
+        HooksManager::unloadLibraries();
+        CfgMgr::instance().clear();
+    }
+
+    /// @brief Configures a subnet with a reservation by hardware address.
+    void configure() {
+        SrvConfigPtr cfg = CfgMgr::instance().getStagingCfg();
+        Subnet4Ptr subnet = Subnet4::create(IOAddress("192.0.2.0"), 24,
+                                            1000, 2000, 3000, 1);
+        cfg->getCfgSubnets4()->add(subnet);
+        HostPtr host(new Host("01:02:03:04:05:06", "hw-address",
+                              SubnetID(1), SUBNET_ID_UNUSED,
+                              IOAddress("192.0.2.10")));
+        cfg->getCfgHosts()->add(host);
+        CfgMgr::instance().commit();
+    }
+
+    /// @brief Loads the library with the static-leases parameter.
+    ///
+    /// @param static_leases The value of the parameter.
+    void loadLib(bool static_leases) {
+        CfgMgr::instance().setFamily(AF_INET);
+        Daemon::setProcName("kea-dhcp4");
+        ElementPtr params = Element::createMap();
+        params->set("static-leases", Element::create(static_leases));
+        HookLibsCollection libraries;
+        libraries.push_back(make_pair(LIBDHCP_BOOTP_SO, params));
+        EXPECT_TRUE(HooksManager::loadLibraries(libraries));
+    }
+
+    /// @brief Returns a BOOTP query relayed from the subnet.
+    ///
+    /// @param mac The last byte of the hardware address.
+    Pkt4Ptr createQuery(uint8_t mac) {
+        Pkt4Ptr query(new Pkt4(DHCPREQUEST, 12345));
+        query->addClass("BOOTP");
+        query->setGiaddr(IOAddress("192.0.2.1"));
+        vector<uint8_t> hwaddr = { 1, 2, 3, 4, 5, mac };
+        query->setHWAddr(HWAddrPtr(new HWAddr(hwaddr, HTYPE_ETHER)));
+        return (query);
+    }
+};
+
+// Verifies that a BOOTP client with a reservation is served without lease.
+TEST_F(CalloutTest, staticLease) {
+    loadLib(true);
+
+    Pkt4Ptr query = createQuery(6);
+    CalloutHandlePtr handle = HooksManager::createCalloutHandle();
+    handle->setArgument("query4", query);
+    EXPECT_NO_THROW(HooksManager::callCallouts(testHooks.hook_index_pkt4_receive_,
+                                               *handle));
+    EXPECT_EQ(CalloutHandle::NEXT_STEP_CONTINUE, handle->getStatus());
+    EXPECT_EQ(DHCPDISCOVER, query->getType());
+
+    // The reserved address is accepted.
+    Lease4Ptr lease(new Lease4(IOAddress("192.0.2.10"), query->getHWAddr(),
+                               ClientIdPtr(), 0, time(0), 1));
+    handle->deleteAllArguments();
+    handle->setArgument("query4", query);
+    handle->setArgument("lease4", lease);
+    EXPECT_NO_THROW(HooksManager::callCallouts(testHooks.hook_index_lease4_select_,
+                                               *handle));
+    EXPECT_EQ(CalloutHandle::NEXT_STEP_CONTINUE, handle->getStatus());
+
+    // Another address is refused.
+    lease.reset(new Lease4(IOAddress("192.0.2.11"), query->getHWAddr(),
+                           ClientIdPtr(), 0, time(0), 1));
+    handle->setArgument("lease4", lease);
+    EXPECT_NO_THROW(HooksManager::callCallouts(testHooks.hook_index_lease4_select_,
+                                               *handle));
+    EXPECT_EQ(CalloutHandle::NEXT_STEP_SKIP, handle->getStatus());
+}
+
+// Verifies that a BOOTP client without reservation gets a lease.
+TEST_F(CalloutTest, noReservation) {
+    loadLib(true);
+
+    Pkt4Ptr query = createQuery(7);
+    CalloutHandlePtr handle = HooksManager::createCalloutHandle();
+    handle->setArgument("query4", query);
+    EXPECT_NO_THROW(HooksManager::callCallouts(testHooks.hook_index_pkt4_receive_,
+                                               *handle));
+    EXPECT_EQ(DHCPREQUEST, query->getType());
+
+    Lease4Ptr lease(new Lease4(IOAddress("192.0.2.11"), query->getHWAddr(),
+                               ClientIdPtr(), 0, time(0), 1));
+    handle->deleteAllArguments();
+    handle->setArgument("query4", query);
+    handle->setArgument("lease4", lease);
+    EXPECT_NO_THROW(HooksManager::callCallouts(testHooks.hook_index_lease4_select_,
+                                               *handle));
+    EXPECT_EQ(CalloutHandle::NEXT_STEP_CONTINUE, handle->getStatus());
+}
+
+// Verifies that the reservations are not used by default.
+TEST_F(CalloutTest, disabled) {
+    loadLib(false);
+
+    Pkt4Ptr query = createQuery(6);
+    CalloutHandlePtr handle = HooksManager::createCalloutHandle();
+    handle->setArgument("query4", query);
+    EXPECT_NO_THROW(HooksManager::callCallouts(testHooks.hook_index_pkt4_receive_,
+                                               *handle));
+    EXPECT_EQ(DHCPREQUEST, query->getType());
+}
+
+} // end of anonymous namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2022-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -49,6 +49,16 @@ TEST_F(BootpLibLoadTest, validLoad4) {
     validDaemonTest("kea-dhcp4");
 }
 
+// Checks the static-leases parameter.
+TEST_F(BootpLibLoadTest, staticLeases) {
+    ElementPtr params = Element::createMap();
+    params->set("static-leases", Element::create(true));
+    validDaemonTest("kea-dhcp4", AF_INET, params);
+
+    params->set("static-leases", Element::create("yes"));
+    invalidDaemonTest("kea-dhcp4", AF_INET, params);
+}
+
 // Simple V6 test that checks the library cannot by loaded by invalid daemons.
 TEST_F(BootpLibLoadTest, invalidDaemonLoad) {
     invalidDaemonTest("kea-dhcp6", AF_INET6);
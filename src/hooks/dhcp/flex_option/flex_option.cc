@@ -18,6 +18,8 @@
 #include <dhcpsrv/cfgmgr.h>
 #include <eval/eval_context.h>
 
+#include <chrono>
+
 using namespace isc;
 using namespace isc::data;
 using namespace isc::dhcp;
@@ -39,13 +41,15 @@ namespace {
 /// @param name The action name.
 /// @param action The action.
 /// @param parser_type The type of the parser of the expression.
+/// @param shared_tokens The option tokens shared by the expressions.
 void
 parseAction(ConstElementPtr option,
             FlexOptionImpl::OptionConfigPtr opt_cfg,
             Option::Universe universe,
             const string& name,
             FlexOptionImpl::Action action,
-            EvalContext::ParserType parser_type) {
+            EvalContext::ParserType parser_type,
+            SharedTokens& shared_tokens) {
     ConstElementPtr elem = option->get(name);
     if (elem) {
         string expr_text = elem->stringValue();
@@ -60,15 +64,82 @@ parseAction(ConstElementPtr option,
         try {
             EvalContext eval_ctx(universe);
             eval_ctx.parseString(expr_text, parser_type);
-            ExpressionPtr expr(new Expression(eval_ctx.expression));
+            ExpressionPtr expr(new Expression(compileExpression(eval_ctx.expression)));
+            shareTokens(*expr, shared_tokens);
             opt_cfg->setExpr(expr);
         } catch (const std::exception& ex) {
             isc_throw(BadValue, "can't parse " << name << " expression ["
                       << expr_text << "] error: " << ex.what());
         }
+        // Build the option once when the value does not depend on the
+        // query. A value which can't be converted is left to the
+        // processing which reports the error for each query.
+        string value;
+        if ((action != FlexOptionImpl::REMOVE) &&
+            evaluateConstant(*opt_cfg->getExpr(), value) && !value.empty()) {
+            try {
+                opt_cfg->setPrebuiltOption(opt_cfg->createOption(universe,
+                                                                 value));
+            } catch (const std::exception&) {
+            }
+        }
     }
 }
 
+/// @brief Logs the time taken by the evaluation of an expression.
+///
+/// The time is measured only when the message is logged.
+class EvalTimer {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param opt_cfg The option or sub-option config.
+    explicit EvalTimer(const FlexOptionImpl::OptionConfig& opt_cfg)
+        : opt_cfg_(opt_cfg),
+          enabled_(flex_option_logger.isDebugEnabled(DBGLVL_TRACE_DETAIL)) {
+        if (enabled_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Logs the time since the construction.
+    ~EvalTimer() {
+        if (!enabled_) {
+            return;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start_).count();
+        const FlexOptionImpl::SubOptionConfig* sub_cfg =
+            dynamic_cast<const FlexOptionImpl::SubOptionConfig*>(&opt_cfg_);
+        if (sub_cfg) {
+            LOG_DEBUG(flex_option_logger, DBGLVL_TRACE_DETAIL,
+                      FLEX_OPTION_PROCESS_SUB_EVAL_TIME)
+                .arg(sub_cfg->getCode())
+                .arg(sub_cfg->getContainerCode())
+                .arg(elapsed);
+        } else {
+            LOG_DEBUG(flex_option_logger, DBGLVL_TRACE_DETAIL,
+                      FLEX_OPTION_PROCESS_EVAL_TIME)
+                .arg(opt_cfg_.getCode())
+                .arg(elapsed);
+        }
+    }
+
+private:
+
+    /// @brief The option or sub-option config.
+    const FlexOptionImpl::OptionConfig& opt_cfg_;
+
+    /// @brief Indicates that the time is logged.
+    bool enabled_;
+
+    /// @brief The start of the evaluation.
+    std::chrono::steady_clock::time_point start_;
+};
+
 } // end of anonymous namespace
 
 namespace isc {
@@ -109,6 +180,20 @@ FlexOptionImpl::OptionConfig::OptionConfig(uint16_t code,
 FlexOptionImpl::OptionConfig::~OptionConfig() {
 }
 
+OptionPtr
+FlexOptionImpl::OptionConfig::createOption(Option::Universe universe,
+                                           const string& value) const {
+    if (prebuilt_option_) {
+        return (prebuilt_option_->clone());
+    }
+    if (def_) {
+        vector<string> split_vec = str::tokens(value, ",", true);
+        return (def_->optionFactory(universe, code_, split_vec));
+    }
+    OptionBuffer buffer(value.begin(), value.end());
+    return (OptionPtr(new Option(universe, code_, buffer)));
+}
+
 FlexOptionImpl::SubOptionConfig::SubOptionConfig(uint16_t code,
                                                  OptionDefinitionPtr def,
                                                  OptionConfigPtr container)
@@ -295,11 +380,14 @@ FlexOptionImpl::parseOptionConfig(ConstElementPtr option) {
         parseSubOptions(sub_options, opt_cfg, universe);
     } else {
         parseAction(option, opt_cfg, universe,
-                    "add", ADD, EvalContext::PARSER_STRING);
+                    "add", ADD, EvalContext::PARSER_STRING,
+                    shared_tokens_);
         parseAction(option, opt_cfg, universe,
-                    "supersede", SUPERSEDE, EvalContext::PARSER_STRING);
+                    "supersede", SUPERSEDE, EvalContext::PARSER_STRING,
+                    shared_tokens_);
         parseAction(option, opt_cfg, universe,
-                    "remove", REMOVE, EvalContext::PARSER_BOOL);
+                    "remove", REMOVE, EvalContext::PARSER_BOOL,
+                    shared_tokens_);
 
         if (opt_cfg->getAction() == NONE) {
             isc_throw(BadValue, "no action: " << option->str());
@@ -451,11 +539,14 @@ FlexOptionImpl::parseSubOption(ConstElementPtr sub_option,
 
     // sub_cfg initial action is NONE.
     parseAction(sub_option, sub_cfg, universe,
-                "add", ADD, EvalContext::PARSER_STRING);
+                "add", ADD, EvalContext::PARSER_STRING,
+                shared_tokens_);
     parseAction(sub_option, sub_cfg, universe,
-                "supersede", SUPERSEDE, EvalContext::PARSER_STRING);
+                "supersede", SUPERSEDE, EvalContext::PARSER_STRING,
+                shared_tokens_);
     parseAction(sub_option, sub_cfg, universe,
-                "remove", REMOVE, EvalContext::PARSER_BOOL);
+                "remove", REMOVE, EvalContext::PARSER_BOOL,
+                shared_tokens_);
 
     if (sub_cfg->getAction() == NONE) {
         isc_throw(BadValue, "no action: " << sub_option->str());
@@ -486,6 +577,20 @@ FlexOptionImpl::parseSubOption(ConstElementPtr sub_option,
     sub_map[code] = sub_cfg;
 }
 
+string
+FlexOptionImpl::evaluateString(const OptionConfig& opt_cfg, Pkt& query,
+                               EvalCache& cache) {
+    EvalTimer timer(opt_cfg);
+    return (isc::dhcp::evaluateString(*opt_cfg.getExpr(), query, &cache));
+}
+
+bool
+FlexOptionImpl::evaluateBool(const OptionConfig& opt_cfg, Pkt& query,
+                             EvalCache& cache) {
+    EvalTimer timer(opt_cfg);
+    return (isc::dhcp::evaluateBool(*opt_cfg.getExpr(), query, &cache));
+}
+
 void
 FlexOptionImpl::logClass(const ClientClass& client_class, uint16_t code) {
     LOG_DEBUG(flex_option_logger, DBGLVL_TRACE_BASIC,
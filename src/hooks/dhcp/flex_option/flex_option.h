@@ -134,6 +134,33 @@ public:
             return (class_);
         }
 
+        /// @brief Set the option built from the constant value of the
+        /// expression.
+        ///
+        /// @param option the option or null.
+        void setPrebuiltOption(const isc::dhcp::OptionPtr& option) {
+            prebuilt_option_ = option;
+        }
+
+        /// @brief Get the option built from the constant value of the
+        /// expression.
+        ///
+        /// @return the option or null.
+        const isc::dhcp::OptionPtr& getPrebuiltOption() const {
+            return (prebuilt_option_);
+        }
+
+        /// @brief Create the (sub-)option from the value of the expression.
+        ///
+        /// When the expression is constant the prebuilt option is copied
+        /// instead of converting the value again.
+        ///
+        /// @param universe the option universe.
+        /// @param value the value of the expression.
+        /// @return the option.
+        isc::dhcp::OptionPtr createOption(isc::dhcp::Option::Universe universe,
+                                          const std::string& value) const;
+
     private:
         /// @brief The code.
         uint16_t code_;
@@ -153,6 +180,10 @@ public:
 
         /// @brief The client class aka guard name.
         isc::dhcp::ClientClass class_;
+
+        /// @brief The option built from the constant value of the
+        /// expression.
+        isc::dhcp::OptionPtr prebuilt_option_;
     };
 
     /// @brief The type of shared pointers to option config.
@@ -286,6 +317,9 @@ public:
     template <typename PktType>
     void process(isc::dhcp::Option::Universe universe,
                  PktType query, PktType response) {
+        // The query is not modified so the values of the option tokens
+        // shared by the expressions are computed once.
+        isc::dhcp::EvalCache cache;
         for (auto pair : getOptionConfigMap()) {
             for (const OptionConfigPtr& opt_cfg : pair.second) {
                 const isc::dhcp::ClientClass& client_class =
@@ -297,10 +331,8 @@ public:
                     }
                 }
                 std::string value;
-                isc::dhcp::OptionBuffer buffer;
                 uint16_t code = opt_cfg->getCode();
                 isc::dhcp::OptionPtr opt = response->getOption(code);
-                isc::dhcp::OptionDefinitionPtr def = opt_cfg->getOptionDef();
                 switch (opt_cfg->getAction()) {
                 case NONE:
                     break;
@@ -310,44 +342,24 @@ public:
                         break;
                     }
                     // Do nothing is the expression evaluates to empty.
-                    value = isc::dhcp::evaluateString(*opt_cfg->getExpr(),
-                                                      *query);
+                    value = evaluateString(*opt_cfg, *query, cache);
                     if (value.empty()) {
                         break;
                     }
                     // Set the value.
-                    if (def) {
-                        std::vector<std::string> split_vec =
-                            isc::util::str::tokens(value, ",", true);
-                        opt = def->optionFactory(universe, code, split_vec);
-                    } else {
-                        buffer.assign(value.begin(), value.end());
-                        opt.reset(new isc::dhcp::Option(universe, code,
-                                                        buffer));
-                    }
+                    opt = opt_cfg->createOption(universe, value);
                     // Add the option.
                     response->addOption(opt);
                     logAction(ADD, code, value);
                     break;
                 case SUPERSEDE:
                     // Do nothing is the expression evaluates to empty.
-                    value = isc::dhcp::evaluateString(*opt_cfg->getExpr(),
-                                                      *query);
+                    value = evaluateString(*opt_cfg, *query, cache);
                     if (value.empty()) {
                         break;
                     }
                     // Set the value.
-                    if (def) {
-                        std::vector<std::string> split_vec =
-                            isc::util::str::tokens(value, ",", true);
-                        opt = def->optionFactory(universe, code,
-                                                 split_vec);
-                    } else {
-                        buffer.assign(value.begin(), value.end());
-                        opt.reset(new isc::dhcp::Option(universe,
-                                                        code,
-                                                        buffer));
-                    }
+                    opt = opt_cfg->createOption(universe, value);
                     // Remove the option if already there.
                     while (response->getOption(code)) {
                         response->delOption(code);
@@ -362,7 +374,7 @@ public:
                         break;
                     }
                     // Do nothing is the expression evaluates to false.
-                    if (!isc::dhcp::evaluateBool(*opt_cfg->getExpr(), *query)) {
+                    if (!evaluateBool(*opt_cfg, *query, cache)) {
                         break;
                     }
                     // Remove the option.
@@ -396,10 +408,8 @@ public:
                     }
                 }
                 std::string value;
-                isc::dhcp::OptionBuffer buffer;
                 isc::dhcp::OptionPtr opt = response->getOption(opt_code);
                 isc::dhcp::OptionPtr sub;
-                isc::dhcp::OptionDefinitionPtr def = sub_cfg->getOptionDef();
                 uint32_t vendor_id = sub_cfg->getVendorId();
                 switch (sub_cfg->getAction()) {
                 case NONE:
@@ -410,8 +420,7 @@ public:
                         break;
                     }
                     // Do nothing is the expression evaluates to empty.
-                    value = isc::dhcp::evaluateString(*sub_cfg->getExpr(),
-                                                      *query);
+                    value = evaluateString(*sub_cfg, *query, cache);
                     if (value.empty()) {
                         break;
                     }
@@ -424,16 +433,7 @@ public:
                         break;
                     }
                     // Set the value.
-                    if (def) {
-                        std::vector<std::string> split_vec =
-                            isc::util::str::tokens(value, ",", true);
-                        sub = def->optionFactory(universe, sub_code,
-                                                 split_vec);
-                    } else {
-                        buffer.assign(value.begin(), value.end());
-                        sub.reset(new isc::dhcp::Option(universe, sub_code,
-                                                        buffer));
-                    }
+                    sub = sub_cfg->createOption(universe, value);
                     // If the container does not exist add it.
                     if (!opt) {
                         if (!vendor_id) {
@@ -460,8 +460,7 @@ public:
                         break;
                     }
                     // Do nothing is the expression evaluates to empty.
-                    value = isc::dhcp::evaluateString(*sub_cfg->getExpr(),
-                                                      *query);
+                    value = evaluateString(*sub_cfg, *query, cache);
                     if (value.empty()) {
                         break;
                     }
@@ -470,16 +469,7 @@ public:
                         break;
                     }
                     // Set the value.
-                    if (def) {
-                        std::vector<std::string> split_vec =
-                            isc::util::str::tokens(value, ",", true);
-                        sub = def->optionFactory(universe, sub_code,
-                                                 split_vec);
-                    } else {
-                        buffer.assign(value.begin(), value.end());
-                        sub.reset(new isc::dhcp::Option(universe, sub_code,
-                                                        buffer));
-                    }
+                    sub = sub_cfg->createOption(universe, value);
                     // Remove the sub-option if already there.
                     if (opt) {
                         while (opt->getOption(sub_code)) {
@@ -517,7 +507,7 @@ public:
                         break;
                     }
                     // Do nothing is the expression evaluates to false.
-                    if (!isc::dhcp::evaluateBool(*sub_cfg->getExpr(), *query)) {
+                    if (!evaluateBool(*sub_cfg, *query, cache)) {
                         break;
                     }
                     // Check vendor id mismatch.
@@ -542,6 +532,30 @@ public:
     }
 
 
+    /// @brief Evaluate the string expression of an option config.
+    ///
+    /// The evaluation time is logged at the detail debug level.
+    ///
+    /// @param opt_cfg The option or sub-option config.
+    /// @param query The query packet.
+    /// @param cache The values of the option tokens evaluated for the query.
+    /// @return The value of the expression.
+    static std::string evaluateString(const OptionConfig& opt_cfg,
+                                      isc::dhcp::Pkt& query,
+                                      isc::dhcp::EvalCache& cache);
+
+    /// @brief Evaluate the boolean expression of an option config.
+    ///
+    /// The evaluation time is logged at the detail debug level.
+    ///
+    /// @param opt_cfg The option or sub-option config.
+    /// @param query The query packet.
+    /// @param cache The values of the option tokens evaluated for the query.
+    /// @return The value of the expression.
+    static bool evaluateBool(const OptionConfig& opt_cfg,
+                             isc::dhcp::Pkt& query,
+                             isc::dhcp::EvalCache& cache);
+
     /// @brief Log the client class for option.
     ///
     /// @param client_class The client class aka guard name.
@@ -616,6 +630,9 @@ private:
     /// @brief The sub-option config map of maps.
     SubOptionConfigMapMap sub_option_config_map_;
 
+    /// @brief The option tokens shared by the expressions.
+    isc::dhcp::SharedTokens shared_tokens_;
+
     /// @brief Parse an option config.
     ///
     /// @param option The element with option config.
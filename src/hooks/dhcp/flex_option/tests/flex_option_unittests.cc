@@ -738,16 +738,12 @@ TEST_F(FlexOptionTest, optionConfigRemove4) {
 
     ExpressionPtr expr = opt_cfg->getExpr();
     ASSERT_TRUE(expr);
-    ASSERT_EQ(3, expr->size());
+    // The constant expression is folded to its value.
+    ASSERT_EQ(1, expr->size());
     Pkt4Ptr pkt4(new Pkt4(DHCPDISCOVER, 12345));
     ValueStack values;
     EXPECT_NO_THROW(expr->at(0)->evaluate(*pkt4, values));
     ASSERT_EQ(1, values.size());
-    EXPECT_EQ("abc", values.top());
-    EXPECT_NO_THROW(expr->at(1)->evaluate(*pkt4, values));
-    ASSERT_EQ(2, values.size());
-    EXPECT_NO_THROW(expr->at(2)->evaluate(*pkt4, values));
-    ASSERT_EQ(1, values.size());
     EXPECT_EQ("true", values.top());
 }
 
@@ -780,16 +776,12 @@ TEST_F(FlexOptionTest, optionConfigRemove6) {
 
     ExpressionPtr expr = opt_cfg->getExpr();
     ASSERT_TRUE(expr);
-    ASSERT_EQ(3, expr->size());
+    // The constant expression is folded to its value.
+    ASSERT_EQ(1, expr->size());
     Pkt6Ptr pkt6(new Pkt6(DHCPV6_SOLICIT, 12345));
     ValueStack values;
     EXPECT_NO_THROW(expr->at(0)->evaluate(*pkt6, values));
     ASSERT_EQ(1, values.size());
-    EXPECT_EQ("abc", values.top());
-    EXPECT_NO_THROW(expr->at(1)->evaluate(*pkt6, values));
-    ASSERT_EQ(2, values.size());
-    EXPECT_NO_THROW(expr->at(2)->evaluate(*pkt6, values));
-    ASSERT_EQ(1, values.size());
     EXPECT_EQ("true", values.top());
 }
 
@@ -1056,6 +1048,56 @@ TEST_F(FlexOptionTest, processAddEmpty) {
     EXPECT_FALSE(response->getOption(DHO_HOST_NAME));
 }
 
+// Verify that the option of a constant ADD action is built once and
+// a copy is added to each response.
+TEST_F(FlexOptionTest, processAddPrebuilt) {
+    ElementPtr options = Element::createList();
+    ElementPtr option = Element::createMap();
+    options->add(option);
+    ElementPtr code = Element::create(DHO_HOST_NAME);
+    option->set("code", code);
+    ElementPtr add = Element::create(string("'ab' + 'c'"));
+    option->set("add", add);
+    option = Element::createMap();
+    options->add(option);
+    code = Element::create(DHO_DOMAIN_NAME);
+    option->set("code", code);
+    add = Element::create(string("hexstring(pkt4.mac, '')"));
+    option->set("add", add);
+    EXPECT_NO_THROW(impl_->testConfigure(options));
+    EXPECT_TRUE(impl_->getErrMsg().empty()) << impl_->getErrMsg();
+
+    auto map = impl_->getOptionConfigMap();
+    FlexOptionImpl::OptionConfigPtr opt_cfg;
+    ASSERT_NO_THROW(opt_cfg = map.at(DHO_HOST_NAME).front());
+    ASSERT_TRUE(opt_cfg);
+    OptionPtr prebuilt = opt_cfg->getPrebuiltOption();
+    ASSERT_TRUE(prebuilt);
+    const OptionBuffer& buffer = prebuilt->getData();
+    ASSERT_EQ(3, buffer.size());
+    EXPECT_EQ(0, memcmp(&buffer[0], "abc", 3));
+
+    // The value of the other option depends on the query.
+    ASSERT_NO_THROW(opt_cfg = map.at(DHO_DOMAIN_NAME).front());
+    ASSERT_TRUE(opt_cfg);
+    EXPECT_FALSE(opt_cfg->getPrebuiltOption());
+
+    Pkt4Ptr query(new Pkt4(DHCPDISCOVER, 12345));
+    Pkt4Ptr response1(new Pkt4(DHCPOFFER, 12345));
+    Pkt4Ptr response2(new Pkt4(DHCPOFFER, 12345));
+    EXPECT_NO_THROW(impl_->process<Pkt4Ptr>(Option::V4, query, response1));
+    EXPECT_NO_THROW(impl_->process<Pkt4Ptr>(Option::V4, query, response2));
+
+    OptionPtr opt1 = response1->getOption(DHO_HOST_NAME);
+    OptionPtr opt2 = response2->getOption(DHO_HOST_NAME);
+    ASSERT_TRUE(opt1);
+    ASSERT_TRUE(opt2);
+    EXPECT_NE(opt1, prebuilt);
+    EXPECT_NE(opt1, opt2);
+    EXPECT_TRUE(opt1->getData() == buffer);
+    EXPECT_TRUE(opt2->getData() == buffer);
+}
+
 // Verify that SUPERSEDE action supersedes the specified option in csv format.
 TEST_F(FlexOptionTest, processSupersedeEnableCSVFormat) {
     ElementPtr options = Element::createList();
@@ -22,6 +22,7 @@ unordered_set<string> CommandCreator::ha_commands4_ = {
     "list-commands", "status-get",
     "dhcp-disable", "dhcp-enable",
     "ha-reset", "ha-heartbeat",
+    "lease4-bulk-apply",
     "lease4-update", "lease4-del",
     "lease4-get-all", "lease4-get-page",
     "ha-maintenance-notify", "ha-sync-complete-notify"
@@ -127,6 +128,34 @@ CommandCreator::createLease4GetPage(const Lease4Ptr& last_lease4,
     return (command);
 }
 
+ConstElementPtr
+CommandCreator::createLease4BulkApply(const Lease4CollectionPtr& leases,
+                                      const Lease4CollectionPtr& deleted_leases) {
+    ElementPtr deleted_leases_list = Element::createList();
+    for (auto lease = deleted_leases->begin(); lease != deleted_leases->end();
+         ++lease) {
+        ElementPtr lease_as_json = (*lease)->toElement();
+        insertLeaseExpireTime(lease_as_json);
+        deleted_leases_list->add(lease_as_json);
+    }
+
+    ElementPtr leases_list = Element::createList();
+    for (auto lease = leases->begin(); lease != leases->end();
+         ++lease) {
+        ElementPtr lease_as_json = (*lease)->toElement();
+        insertLeaseExpireTime(lease_as_json);
+        leases_list->add(lease_as_json);
+    }
+
+    ElementPtr args = Element::createMap();
+    args->set("deleted-leases", deleted_leases_list);
+    args->set("leases", leases_list);
+
+    ConstElementPtr command = config::createCommand("lease4-bulk-apply", args);
+    insertService(command, HAServerType::DHCPv4);
+    return (command);
+}
+
 ConstElementPtr
 CommandCreator::createLease6BulkApply(const Lease6CollectionPtr& leases,
                                       const Lease6CollectionPtr& deleted_leases) {
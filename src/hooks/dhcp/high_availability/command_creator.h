@@ -95,6 +95,17 @@ public:
     createLease4GetPage(const dhcp::Lease4Ptr& lease4,
                         const uint32_t limit);
 
+    /// @brief Creates lease4-bulk-apply command.
+    ///
+    /// @param leases Pointer to the collection of leases to be created
+    /// or/and updated.
+    /// @param deleted_leases Pointer to the collection of leases to be
+    /// deleted.
+    /// @return Pointer to the JSON representation of the command.
+    static data::ConstElementPtr
+    createLease4BulkApply(const dhcp::Lease4CollectionPtr& leases,
+                          const dhcp::Lease4CollectionPtr& deleted_leases);
+
     /// @brief Creates lease6-bulk-apply command.
     ///
     /// @param leases Pointer to the collection of leases to be created
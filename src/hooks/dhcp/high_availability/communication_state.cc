@@ -22,6 +22,7 @@
 
 #include <boost/pointer_cast.hpp>
 
+#include <cmath>
 #include <ctime>
 #include <functional>
 #include <limits>
@@ -49,6 +50,12 @@ constexpr long TERM_CLOCK_SKEW = 60;
 /// @brief Minimum time between two consecutive clock skew warnings.
 constexpr long MIN_TIME_SINCE_CLOCK_SKEW_WARN = 60;
 
+/// @brief Maximum number of poke intervals used to compute the phi value.
+constexpr size_t MAX_POKE_INTERVALS = 100;
+
+/// @brief Minimum number of poke intervals required to compute the phi value.
+constexpr size_t MIN_POKE_INTERVALS = 5;
+
 }
 
 namespace isc {
@@ -58,7 +65,7 @@ CommunicationState::CommunicationState(const IOServicePtr& io_service,
                                        const HAConfigPtr& config)
     : io_service_(io_service), config_(config), timer_(), interval_(0),
       poke_time_(boost::posix_time::microsec_clock::universal_time()),
-      heartbeat_impl_(0), partner_state_(-1), partner_scopes_(),
+      poke_intervals_(), heartbeat_impl_(0), partner_state_(-1), partner_scopes_(),
       clock_skew_(0, 0, 0, 0), last_clock_skew_warn_(),
       my_time_at_skew_(), partner_time_at_skew_(),
       analyzed_messages_count_(0), unsent_update_count_(0),
@@ -279,6 +286,17 @@ CommunicationState::pokeInternal() {
     // Update poke time and compute duration.
     boost::posix_time::time_duration duration_since_poke = updatePokeTimeInternal();
 
+    // Record the interval for the failure detector. The intervals longer
+    // than the max-response-delay span a communication interruption and
+    // would skew the distribution.
+    int64_t interval = duration_since_poke.total_milliseconds();
+    if ((interval >= 0) && (interval <= config_->getMaxResponseDelay())) {
+        poke_intervals_.push_back(interval);
+        if (poke_intervals_.size() > MAX_POKE_INTERVALS) {
+            poke_intervals_.pop_front();
+        }
+    }
+
     // If we have been tracking the DHCP messages directed to the partner,
     // we need to clear any gathered information because the connection
     // seems to be (re)established.
@@ -318,7 +336,63 @@ CommunicationState::getDurationInMillisecsInternal() const {
 
 bool
 CommunicationState::isCommunicationInterrupted() const {
-    return (getDurationInMillisecs() > config_->getMaxResponseDelay());
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lk(*mutex_);
+        return (isCommunicationInterruptedInternal());
+    } else {
+        return (isCommunicationInterruptedInternal());
+    }
+}
+
+bool
+CommunicationState::isCommunicationInterruptedInternal() const {
+    if (getDurationInMillisecsInternal() > config_->getMaxResponseDelay()) {
+        return (true);
+    }
+    auto threshold = config_->getPhiAccrualThreshold();
+    return ((threshold > 0) && (partner_state_ == HA_UNAVAILABLE_ST) &&
+            (getPhiInternal() >= threshold));
+}
+
+double
+CommunicationState::getPhi() const {
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lk(*mutex_);
+        return (getPhiInternal());
+    } else {
+        return (getPhiInternal());
+    }
+}
+
+double
+CommunicationState::getPhiInternal() const {
+    if (poke_intervals_.size() < MIN_POKE_INTERVALS) {
+        return (0);
+    }
+    double sum = 0;
+    for (auto interval : poke_intervals_) {
+        sum += interval;
+    }
+    double mean = sum / poke_intervals_.size();
+    double variance = 0;
+    for (auto interval : poke_intervals_) {
+        variance += (interval - mean) * (interval - mean);
+    }
+    variance /= poke_intervals_.size();
+
+    // The heartbeat is only sent when there was no other communication
+    // for the heartbeat delay, so the partner is not expected to respond
+    // more often in an idle period.
+    mean = std::max(mean, static_cast<double>(config_->getHeartbeatDelay()));
+    double stddev = std::max(std::sqrt(variance), mean / 4);
+
+    // Logistic approximation of the normal cumulative distribution.
+    double y = (getDurationInMillisecsInternal() - mean) / stddev;
+    double e = std::exp(-y * (1.5976 + 0.070566 * y * y));
+    if (y > 0) {
+        return (-std::log10(e / (1.0 + e)));
+    }
+    return (-std::log10(1.0 - 1.0 / (1.0 + e)));
 }
 
 std::vector<uint8_t>
@@ -24,6 +24,7 @@
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <deque>
 #include <functional>
 #include <map>
 #include <mutex>
@@ -195,11 +196,47 @@ public:
     /// This method checks if the communication with the partner appears
     /// to be interrupted. This is the case when the time since last
     /// successful communication is longer than the configured
-    /// max-response-delay value.
+    /// max-response-delay value. When the phi-accrual-threshold is
+    /// configured, it is also the case when the partner is marked
+    /// unavailable (the last heartbeat failed) and the phi value returned
+    /// by @c getPhi reaches the threshold. This shortens the failure
+    /// detection when the partner normally responds at regular intervals.
     ///
     /// @return true if communication is interrupted, false otherwise.
     bool isCommunicationInterrupted() const;
 
+    /// @brief Returns the suspicion level of the partner failure.
+    ///
+    /// This is the phi value of the phi accrual failure detector computed
+    /// from the intervals between the recent successful communications
+    /// with the partner, assuming they are normally distributed: the
+    /// probability that the partner is still alive after the time elapsed
+    /// since last poke is 10 to the power of minus phi. The mean interval
+    /// is not lower than the heartbeat delay, as the heartbeat is sent only
+    /// when there is no other communication, and the standard deviation is
+    /// not lower than a quarter of the mean.
+    ///
+    /// @return Phi value or 0 if there are not enough intervals recorded.
+    double getPhi() const;
+
+private:
+
+    /// @brief Returns the suspicion level of the partner failure.
+    ///
+    /// Should be called in a thread safe context.
+    ///
+    /// @return Phi value or 0 if there are not enough intervals recorded.
+    double getPhiInternal() const;
+
+    /// @brief Checks if communication with the partner is interrupted.
+    ///
+    /// Should be called in a thread safe context.
+    ///
+    /// @return true if communication is interrupted, false otherwise.
+    bool isCommunicationInterruptedInternal() const;
+
+public:
+
 protected:
 
     /// @brief Convenience function attempting to retrieve client
@@ -698,6 +735,11 @@ protected:
     /// @brief Last poke time.
     boost::posix_time::ptime poke_time_;
 
+    /// @brief Recent intervals between the pokes in milliseconds.
+    ///
+    /// They are used to compute the phi value of the failure detector.
+    std::deque<int64_t> poke_intervals_;
+
     /// @brief Pointer to the function providing heartbeat implementation.
     std::function<void()> heartbeat_impl_;
 
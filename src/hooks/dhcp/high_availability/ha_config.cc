@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -162,10 +162,13 @@ HAConfig::StateMachineConfig::getStateConfig(const int state) {
 HAConfig::HAConfig()
     : this_server_name_(), ha_mode_(HOT_STANDBY), send_lease_updates_(true),
       sync_leases_(true), sync_timeout_(60000), sync_page_limit_(10000),
-      delayed_updates_limit_(0), heartbeat_delay_(10000), max_response_delay_(60000),
+      delayed_updates_limit_(0), delayed_updates_memory_limit_(0),
+      lease_updates_batch_window_(0),
+      heartbeat_delay_(10000), max_response_delay_(60000), phi_accrual_threshold_(0),
       max_ack_delay_(10000), max_unacked_clients_(10), max_rejected_lease_updates_(10),
       wait_backup_ack_(false), enable_multi_threading_(false),
       http_dedicated_listener_(false), http_listener_threads_(0), http_client_threads_(0),
+      http_client_per_peer_(false),
       trust_anchor_(), cert_file_(), key_file_(), require_client_certs_(true),
       restrict_commands_(false), peers_(),
       state_machine_(new StateMachineConfig()) {
@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -465,6 +465,26 @@ public:
         delayed_updates_limit_ = delayed_updates_limit;
     }
 
+    /// @brief Returns the memory limit of the lease updates held unsent in
+    /// the communication-recovery state.
+    ///
+    /// It limits the approximate amount of memory used by the lease updates
+    /// held unsent in addition to their number. A value of zero means no
+    /// memory limit.
+    ///
+    /// @return Memory limit of the lease backlog in bytes.
+    uint32_t getDelayedUpdatesMemoryLimit() const {
+        return (delayed_updates_memory_limit_);
+    }
+
+    /// @brief Sets new memory limit of the lease updates held unsent in the
+    /// communication-recovery state.
+    ///
+    /// @param delayed_updates_memory_limit new limit in bytes.
+    void setDelayedUpdatesMemoryLimit(const uint32_t delayed_updates_memory_limit) {
+        delayed_updates_memory_limit_ = delayed_updates_memory_limit;
+    }
+
     /// @brief Convenience function checking if communication recovery is allowed.
     ///
     /// Communication recovery is only allowed in load-balancing configurations.
@@ -476,6 +496,25 @@ public:
         return (delayed_updates_limit_ > 0);
     }
 
+    /// @brief Returns the DHCPv4 lease updates batch window in milliseconds.
+    ///
+    /// The DHCPv4 lease updates of the queries processed during this window
+    /// are sent to a partner in a single lease4-bulk-apply command. A value
+    /// of zero disables the batching: the lease updates are sent as soon as
+    /// the leases are committed.
+    ///
+    /// @return Lease updates batch window in milliseconds.
+    uint32_t getLeaseUpdatesBatchWindow() const {
+        return (lease_updates_batch_window_);
+    }
+
+    /// @brief Sets new DHCPv4 lease updates batch window in milliseconds.
+    ///
+    /// @param lease_updates_batch_window new lease updates batch window.
+    void setLeaseUpdatesBatchWindow(const uint32_t lease_updates_batch_window) {
+        lease_updates_batch_window_ = lease_updates_batch_window;
+    }
+
     /// @brief Returns heartbeat delay in milliseconds.
     ///
     /// This value indicates the delay in sending a heartbeat command after
@@ -518,6 +557,22 @@ public:
         max_response_delay_ = max_response_delay;
     }
 
+    /// @brief Returns the phi accrual failure detector threshold.
+    ///
+    /// A value of zero disables the failure detector and the
+    /// communication is deemed interrupted only after the max response
+    /// delay.
+    uint32_t getPhiAccrualThreshold() const {
+        return (phi_accrual_threshold_);
+    }
+
+    /// @brief Sets new phi accrual failure detector threshold.
+    ///
+    /// @param phi_accrual_threshold new threshold, 0 disables the detector.
+    void setPhiAccrualThreshold(const uint32_t phi_accrual_threshold) {
+        phi_accrual_threshold_ = phi_accrual_threshold;
+    }
+
     /// @brief Returns maximum time for a client trying to communicate with
     /// DHCP server to complete the transaction.
     ///
@@ -665,6 +720,22 @@ public:
         http_client_threads_ = http_client_threads;
     }
 
+    /// @brief Checks if the server uses an HTTP client per peer.
+    ///
+    /// @return true if each peer has its own HTTP client, thus its own
+    /// threads and connections, in multi-threading mode.
+    bool getHttpClientPerPeer() const {
+        return (http_client_per_peer_);
+    }
+
+    /// @brief Sets whether or not the server uses an HTTP client per peer.
+    ///
+    /// @param http_client_per_peer flag that enables an HTTP client per
+    /// peer when true.
+    void setHttpClientPerPeer(bool http_client_per_peer) {
+        http_client_per_peer_ = http_client_per_peer;
+    }
+
     /// @brief Returns global trust-anchor.
     util::Optional<std::string> getTrustAnchor() const {
         return (trust_anchor_);
@@ -797,8 +868,12 @@ public:
                                               ///< synchronizing leases.
     uint32_t delayed_updates_limit_;          ///< Maximum number of lease updates held
                                               ///< for later send in communication-recovery.
+    uint32_t delayed_updates_memory_limit_;   ///< Memory limit of the lease updates held
+                                              ///< for later send in communication-recovery.
+    uint32_t lease_updates_batch_window_;     ///< DHCPv4 lease updates batch window (ms).
     uint32_t heartbeat_delay_;                ///< Heartbeat delay in milliseconds.
     uint32_t max_response_delay_;             ///< Max delay in response to heartbeats.
+    uint32_t phi_accrual_threshold_;          ///< Phi accrual failure detector threshold.
     uint32_t max_ack_delay_;                  ///< Maximum DHCP message ack delay.
     uint32_t max_unacked_clients_;            ///< Maximum number of unacked clients.
     uint32_t max_rejected_lease_updates_;     ///< Limit of rejected lease updates before termination.
@@ -807,6 +882,7 @@ public:
     bool http_dedicated_listener_;            ///< Enable use of own HTTP listener.
     uint32_t http_listener_threads_;          ///< Number of HTTP listener threads.
     uint32_t http_client_threads_;            ///< Number of HTTP client threads.
+    bool http_client_per_peer_;               ///< Use an HTTP client per peer.
     util::Optional<std::string> trust_anchor_; ///< Trust anchor.
     util::Optional<std::string> cert_file_;    ///< Certificate file.
     util::Optional<std::string> key_file_;     ///< Private key file.
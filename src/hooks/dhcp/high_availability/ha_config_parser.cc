@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -26,24 +26,28 @@ const SimpleDefaults HA_CONFIG_LB_DEFAULTS = {
 
 /// @brief Default values for HA configuration.
 const SimpleDefaults HA_CONFIG_DEFAULTS = {
-    { "delayed-updates-limit",      Element::integer, "0" },
-    { "heartbeat-delay",            Element::integer, "10000" },
-    { "max-ack-delay",              Element::integer, "10000" },
-    { "max-response-delay",         Element::integer, "60000" },
-    { "max-unacked-clients",        Element::integer, "10" },
-    { "max-rejected-lease-updates", Element::integer, "10" },
-    { "require-client-certs",       Element::boolean, "true" },
-    { "restrict-commands",          Element::boolean, "false" },
-    { "send-lease-updates",         Element::boolean, "true" },
-    { "sync-leases",                Element::boolean, "true" },
-    { "sync-timeout",               Element::integer, "60000" },
-    { "sync-page-limit",            Element::integer, "10000" },
-    { "wait-backup-ack",            Element::boolean, "false" }
+    { "delayed-updates-limit",        Element::integer, "0" },
+    { "delayed-updates-memory-limit", Element::integer, "0" },
+    { "heartbeat-delay",              Element::integer, "10000" },
+    { "lease-updates-batch-window",   Element::integer, "0" },
+    { "max-ack-delay",                Element::integer, "10000" },
+    { "max-response-delay",           Element::integer, "60000" },
+    { "max-unacked-clients",          Element::integer, "10" },
+    { "max-rejected-lease-updates",   Element::integer, "10" },
+    { "phi-accrual-threshold",        Element::integer, "0" },
+    { "require-client-certs",         Element::boolean, "true" },
+    { "restrict-commands",            Element::boolean, "false" },
+    { "send-lease-updates",           Element::boolean, "true" },
+    { "sync-leases",                  Element::boolean, "true" },
+    { "sync-timeout",                 Element::integer, "60000" },
+    { "sync-page-limit",              Element::integer, "10000" },
+    { "wait-backup-ack",              Element::boolean, "false" }
 };
 
 /// @brief Default values for HA multi-threading configuration.
 const SimpleDefaults HA_CONFIG_MT_DEFAULTS = {
     { "enable-multi-threading",    Element::boolean, "true" },
+    { "http-client-per-peer",      Element::boolean, "false" },
     { "http-client-threads",       Element::integer, "0" },
     { "http-dedicated-listener",   Element::boolean, "true" },
     { "http-listener-threads",     Element::integer, "0" }
@@ -168,6 +172,15 @@ HAConfigParser::parseInternal(const HAConfigPtr& config_storage,
     uint32_t delayed_updates_limit = getAndValidateInteger<uint32_t>(c, "delayed-updates-limit");
     config_storage->setDelayedUpdatesLimit(delayed_updates_limit);
 
+    // Get 'delayed-updates-memory-limit'.
+    uint32_t delayed_updates_memory_limit =
+        getAndValidateInteger<uint32_t>(c, "delayed-updates-memory-limit");
+    config_storage->setDelayedUpdatesMemoryLimit(delayed_updates_memory_limit);
+
+    // Get 'lease-updates-batch-window'.
+    uint16_t batch_window = getAndValidateInteger<uint16_t>(c, "lease-updates-batch-window");
+    config_storage->setLeaseUpdatesBatchWindow(batch_window);
+
     // Get 'heartbeat-delay'.
     uint16_t heartbeat_delay = getAndValidateInteger<uint16_t>(c, "heartbeat-delay");
     config_storage->setHeartbeatDelay(heartbeat_delay);
@@ -176,6 +189,10 @@ HAConfigParser::parseInternal(const HAConfigPtr& config_storage,
     uint16_t max_response_delay = getAndValidateInteger<uint16_t>(c, "max-response-delay");
     config_storage->setMaxResponseDelay(max_response_delay);
 
+    // Get 'phi-accrual-threshold'.
+    uint32_t phi_accrual_threshold = getAndValidateInteger<uint32_t>(c, "phi-accrual-threshold");
+    config_storage->setPhiAccrualThreshold(phi_accrual_threshold);
+
     // Get 'max-ack-delay'.
     uint16_t max_ack_delay = getAndValidateInteger<uint16_t>(c, "max-ack-delay");
     config_storage->setMaxAckDelay(max_ack_delay);
@@ -218,6 +235,9 @@ HAConfigParser::parseInternal(const HAConfigPtr& config_storage,
     threads = getAndValidateInteger<uint32_t>(mt_config, "http-client-threads");
     config_storage->setHttpClientThreads(threads);
 
+    // Get 'http-client-per-peer'.
+    config_storage->setHttpClientPerPeer(getBoolean(mt_config, "http-client-per-peer"));
+
     // Get optional 'trust-anchor'.
     ConstElementPtr ca = c->get("trust-anchor");
     if (ca) {
@@ -34,6 +34,7 @@ using namespace isc::asiolink;
 using namespace isc::config;
 using namespace isc::data;
 using namespace isc::dhcp;
+using namespace isc::ha;
 using namespace isc::hooks;
 using namespace isc::http;
 using namespace isc::log;
@@ -56,6 +57,157 @@ public:
         CtrlChannelError(file, line, what) {}
 };
 
+/// @brief Returns the arguments of the response to a command.
+///
+/// @param response Pointer to the response.
+/// @return Pointer to the arguments map or null if there are none.
+ConstElementPtr
+getResponseArguments(const HttpResponsePtr& response) {
+    HttpResponseJsonPtr json_response =
+        boost::dynamic_pointer_cast<HttpResponseJson>(response);
+    if (!json_response) {
+        return (ConstElementPtr());
+    }
+    ConstElementPtr body = json_response->getBodyAsJson();
+    if (!body || (body->getType() != Element::list) || body->empty() ||
+        (body->get(0)->getType() != Element::map)) {
+        return (ConstElementPtr());
+    }
+    ConstElementPtr args = body->get(0)->get(CONTROL_ARGUMENTS);
+    if (!args || (args->getType() != Element::map)) {
+        return (ConstElementPtr());
+    }
+    return (args);
+}
+
+/// @brief Returns the failed leases of a bulk apply response having one
+/// of the given addresses.
+///
+/// @param args Arguments of the response. It may be null.
+/// @param addresses Addresses of the leases.
+/// @param [out] conflict Set to true when one of the returned leases
+/// failed because of a conflict.
+/// @return Arguments holding the "failed-deleted-leases" and "failed-leases"
+/// lists restricted to the addresses or null if there are none.
+ConstElementPtr
+filterFailedLeases(const ConstElementPtr& args,
+                   const std::set<std::string>& addresses,
+                   bool& conflict) {
+    conflict = false;
+    if (!args) {
+        return (ConstElementPtr());
+    }
+    ElementPtr filtered;
+    for (auto const& name : { "failed-deleted-leases", "failed-leases" }) {
+        ConstElementPtr failed_leases = args->get(name);
+        if (!failed_leases || (failed_leases->getType() != Element::list)) {
+            continue;
+        }
+        ElementPtr list;
+        for (auto const& lease : failed_leases->listValue()) {
+            if (lease->getType() != Element::map) {
+                continue;
+            }
+            ConstElementPtr ip_address = lease->get("ip-address");
+            if (!ip_address || (ip_address->getType() != Element::string) ||
+                (addresses.count(ip_address->stringValue()) == 0)) {
+                continue;
+            }
+            ConstElementPtr result = lease->get(CONTROL_RESULT);
+            if (result && (result->getType() == Element::integer) &&
+                (result->intValue() == CONTROL_RESULT_CONFLICT)) {
+                conflict = true;
+            }
+            if (!list) {
+                list = Element::createList();
+            }
+            list->add(boost::const_pointer_cast<Element>(lease));
+        }
+        if (list) {
+            if (!filtered) {
+                filtered = Element::createMap();
+            }
+            filtered->set(name, list);
+        }
+    }
+    return (filtered);
+}
+
+
+/// @brief Applies a page of synchronized leases to the lease database.
+///
+/// The leases are first added or updated at once. If it fails they are
+/// added or updated one by one so a bad lease doesn't prevent the other
+/// leases from being synchronized.
+///
+/// @tparam LeaseCollection One of the @c Lease4Collection or
+/// @c Lease6Collection.
+/// @param leases Leases to be added or updated.
+/// @param operation Name of the operation for logging.
+/// @param bulk Function adding or updating all the leases.
+/// @param single Function adding or updating one lease.
+template <typename LeaseCollection>
+void
+syncLeasesBulk(const LeaseCollection& leases, const std::string& operation,
+               const std::function<size_t(const LeaseCollection&)>& bulk,
+               const std::function<void(const typename LeaseCollection::value_type&)>& single) {
+    if (leases.empty()) {
+        return;
+    }
+    try {
+        bulk(leases);
+        return;
+    } catch (const std::exception& ex) {
+        LOG_DEBUG(ha_logger, DBGLVL_TRACE_BASIC, HA_LEASES_SYNC_BULK_FAILED)
+            .arg(operation)
+            .arg(leases.size())
+            .arg(ex.what());
+    }
+    for (auto const& lease : leases) {
+        try {
+            single(lease);
+        } catch (const std::exception& ex) {
+            LOG_WARN(ha_logger, HA_LEASE_SYNC_FAILED)
+                .arg(lease->toElement()->str())
+                .arg(ex.what());
+        }
+    }
+}
+
+/// @brief Fetches the local leases in the address range of a page of
+/// synchronized leases.
+///
+/// The partner returns the leases following the lower bound address in
+/// address order, so the local leases of the same range are fetched with
+/// a few paged queries rather than with a query per synchronized lease.
+///
+/// @tparam LeaseCollection One of the @c Lease4Collection or
+/// @c Lease6Collection.
+/// @param lower_bound Lower bound address used to fetch the page.
+/// @param upper_bound Address of the last lease on the page.
+/// @param page_size Size of the pages of local leases.
+/// @param get_page Function fetching a page of local leases.
+/// @return Local leases following the lower bound address up to at least
+/// the upper bound address.
+template <typename LeaseCollection>
+LeaseCollection
+getLocalLeases(IOAddress lower_bound, const IOAddress& upper_bound,
+               const size_t page_size,
+               const std::function<LeaseCollection(const IOAddress&,
+                                                   const LeasePageSize&)>& get_page) {
+    LeaseCollection local;
+    LeasePageSize lease_page_size(page_size);
+    for (;;) {
+        LeaseCollection page = get_page(lower_bound, lease_page_size);
+        local.insert(local.end(), page.begin(), page.end());
+        if ((page.size() < page_size) || (upper_bound <= page.back()->addr_)) {
+            break;
+        }
+        lower_bound = page.back()->addr_;
+    }
+    return (local);
+}
+
 }
 
 namespace isc {
@@ -76,8 +228,9 @@ HAService::HAService(const IOServicePtr& io_service, const NetworkStatePtr& netw
     : io_service_(io_service), network_state_(network_state), config_(config),
       server_type_(server_type), client_(), listener_(), communication_state_(),
       query_filter_(config), mutex_(), pending_requests_(),
-      lease_update_backlog_(config->getDelayedUpdatesLimit()),
-      sync_complete_notified_(false) {
+      lease_update_backlog_(config->getDelayedUpdatesLimit(),
+                            config->getDelayedUpdatesMemoryLimit()),
+      sync_complete_notified_(false), sync_progress_mutex_(), sync_progress_() {
 
     if (server_type == HAServerType::DHCPv4) {
         communication_state_.reset(new CommunicationState4(io_service_, config));
@@ -99,6 +252,19 @@ HAService::HAService(const IOServicePtr& io_service, const NetworkStatePtr& netw
         client_.reset(new HttpClient(*io_service_, true,
                       config_->getHttpClientThreads(), true));
 
+        // Create a client with its own threads and connections for each
+        // peer when configured.
+        if (config_->getHttpClientPerPeer()) {
+            auto const& this_name = config_->getThisServerName();
+            for (auto const& peer : config_->getAllServersConfig()) {
+                if (peer.first != this_name) {
+                    peer_clients_[peer.first].reset(new HttpClient(*io_service_, true,
+                                                    config_->getHttpClientThreads(),
+                                                    true));
+                }
+            }
+        }
+
         // If we're configured to use our own listener create and start it.
         if (config_->getHttpDedicatedListener()) {
             // Get the server address and port from this server's URL.
@@ -135,6 +301,18 @@ HAService::HAService(const IOServicePtr& io_service, const NetworkStatePtr& netw
         }
     }
 
+    // Batch the DHCPv4 lease updates when configured. The batches are sent
+    // by a timer on the HTTP client IO service so the lease updates of the
+    // batched queries are not delayed by the DHCP server main loop.
+    if ((server_type == HAServerType::DHCPv4) &&
+        (config_->getLeaseUpdatesBatchWindow() > 0) &&
+        client_->getThreadIOService()) {
+        batch_timer_.reset(new IntervalTimer(*client_->getThreadIOService()));
+        batch_timer_->setup(std::bind(&HAService::flushLeaseUpdateBatches, this),
+                            config_->getLeaseUpdatesBatchWindow(),
+                            IntervalTimer::REPEATING);
+    }
+
     LOG_INFO(ha_logger, HA_SERVICE_STARTED)
         .arg(HAConfig::HAModeToString(config->getHAMode()))
         .arg(HAConfig::PeerConfig::roleToString(config->getThisServerConfig()->getRole()));
@@ -144,6 +322,13 @@ HAService::~HAService() {
     // Stop client and/or listener.
     stopClientAndListener();
 
+    // The client threads are stopped so the batch timer callback is not
+    // running.
+    if (batch_timer_) {
+        batch_timer_->cancel();
+        batch_timer_.reset();
+    }
+
     network_state_->reset(NetworkState::Origin::HA_COMMAND);
 }
 
@@ -1202,16 +1387,23 @@ HAService::asyncSendLeaseUpdates(const dhcp::Pkt4Ptr& query,
             continue;
         }
 
-        // Lease updates for deleted leases.
-        for (auto l = deleted_leases->begin(); l != deleted_leases->end(); ++l) {
-            asyncSendLeaseUpdate(query, conf, CommandCreator::createLease4Delete(**l),
-                                 parking_lot);
-        }
+        if (batch_timer_) {
+            // The lease updates are sent with the updates of other queries
+            // when the batch window elapses.
+            batchLeaseUpdates(query, conf, leases, deleted_leases, parking_lot);
+
+        } else {
+            // Lease updates for deleted leases.
+            for (auto l = deleted_leases->begin(); l != deleted_leases->end(); ++l) {
+                asyncSendLeaseUpdate(query, conf, CommandCreator::createLease4Delete(**l),
+                                     parking_lot);
+            }
 
-        // Lease updates for new allocations and updated leases.
-        for (auto l = leases->begin(); l != leases->end(); ++l) {
-            asyncSendLeaseUpdate(query, conf, CommandCreator::createLease4Update(**l),
-                                 parking_lot);
+            // Lease updates for new allocations and updated leases.
+            for (auto l = leases->begin(); l != leases->end(); ++l) {
+                asyncSendLeaseUpdate(query, conf, CommandCreator::createLease4Update(**l),
+                                     parking_lot);
+            }
         }
 
         // If we're contacting a backup server from which we don't expect a
@@ -1363,8 +1555,9 @@ HAService::asyncSendLeaseUpdate(const QueryPtrType& query,
     boost::weak_ptr<typename QueryPtrType::element_type> weak_query(query);
 
     // Schedule asynchronous HTTP request.
-    client_->asyncSendRequest(config->getUrl(), config->getTlsContext(),
-                              request, response,
+    leaseUpdateSent(config);
+    getClient(config).asyncSendRequest(config->getUrl(), config->getTlsContext(),
+                                       request, response,
         [this, weak_query, parking_lot, config]
             (const boost::system::error_code& ec,
              const HttpResponsePtr& response,
@@ -1432,6 +1625,8 @@ HAService::asyncSendLeaseUpdate(const QueryPtrType& query,
                 }
             }
 
+            leaseUpdateDone(config, lease_update_success);
+
             // We don't care about the result of the lease update to the backup server.
             // It is a best effort update.
             if (config->getRole() != HAConfig::PeerConfig::BACKUP) {
@@ -1493,6 +1688,266 @@ HAService::asyncSendLeaseUpdate(const QueryPtrType& query,
     }
 }
 
+void
+HAService::batchLeaseUpdates(const Pkt4Ptr& query,
+                             const HAConfig::PeerConfigPtr& config,
+                             const Lease4CollectionPtr& leases,
+                             const Lease4CollectionPtr& deleted_leases,
+                             const ParkingLotHandlePtr& parking_lot) {
+    LeaseUpdateBatch4::Query batched_query;
+    batched_query.query_ = query;
+    batched_query.parking_lot_ = parking_lot;
+    for (auto const& lease : *deleted_leases) {
+        batched_query.addresses_.insert(lease->addr_.toText());
+    }
+    for (auto const& lease : *leases) {
+        batched_query.addresses_.insert(lease->addr_.toText());
+    }
+
+    // The batch may be sent by the timer as soon as the updates are added
+    // so the request counter of the query must be updated first.
+    if (config_->amWaitingBackupAck() || (config->getRole() != HAConfig::PeerConfig::BACKUP)) {
+        updatePendingRequest(query);
+    }
+
+    LeaseUpdateBatch4Ptr full_batch;
+    {
+        std::lock_guard<std::mutex> lk(batch_mutex_);
+        LeaseUpdateBatch4Ptr& batch = lease_update_batches_[config->getName()];
+        if (batch) {
+            // The peer applies the deleted leases before the other leases
+            // so the updates of an address already in the batch can't be
+            // added to it.
+            for (auto const& address : batched_query.addresses_) {
+                if (batch->addresses_.count(address) > 0) {
+                    full_batch = batch;
+                    batch.reset();
+                    break;
+                }
+            }
+        }
+        if (!batch) {
+            batch.reset(new LeaseUpdateBatch4(config));
+        }
+        batch->deleted_leases_->insert(batch->deleted_leases_->end(),
+                                       deleted_leases->begin(),
+                                       deleted_leases->end());
+        batch->leases_->insert(batch->leases_->end(), leases->begin(),
+                               leases->end());
+        batch->addresses_.insert(batched_query.addresses_.begin(),
+                                 batched_query.addresses_.end());
+        batch->queries_.push_back(batched_query);
+    }
+
+    if (full_batch) {
+        asyncSendLeaseUpdateBatch(full_batch);
+    }
+}
+
+void
+HAService::flushLeaseUpdateBatches() {
+    std::map<std::string, LeaseUpdateBatch4Ptr> batches;
+    {
+        std::lock_guard<std::mutex> lk(batch_mutex_);
+        batches.swap(lease_update_batches_);
+    }
+
+    for (auto const& batch : batches) {
+        asyncSendLeaseUpdateBatch(batch.second);
+    }
+}
+
+void
+HAService::asyncSendLeaseUpdateBatch(const LeaseUpdateBatch4Ptr& batch) {
+    HAConfig::PeerConfigPtr config = batch->config_;
+
+    // Create HTTP/1.1 request including our command.
+    PostHttpRequestJsonPtr request = boost::make_shared<PostHttpRequestJson>
+        (HttpRequest::Method::HTTP_POST, "/", HttpVersion::HTTP_11(),
+         HostHttpHeader(config->getUrl().getStrippedHostname()));
+    config->addBasicAuthHttpHeader(request);
+    request->setBodyAsJson(CommandCreator::createLease4BulkApply(batch->leases_,
+                                                                 batch->deleted_leases_));
+    request->finalize();
+
+    // Response object should also be created because the HTTP client needs
+    // to know the type of the expected response.
+    HttpResponseJsonPtr response = boost::make_shared<HttpResponseJson>();
+
+    // When possible we prefer to pass weak pointers to the queries, rather
+    // than shared pointers, to avoid memory leaks in case cross reference
+    // between the pointers.
+    typedef std::pair<boost::weak_ptr<Pkt4>, LeaseUpdateBatch4::Query> WeakQuery;
+    std::vector<WeakQuery> weak_queries;
+    for (auto const& batched_query : batch->queries_) {
+        WeakQuery weak_query(batched_query.query_, batched_query);
+        weak_query.second.query_.reset();
+        weak_queries.push_back(weak_query);
+    }
+
+    LOG_DEBUG(ha_logger, DBGLVL_TRACE_BASIC, HA_LEASE_UPDATE_BATCH_SEND)
+        .arg(weak_queries.size())
+        .arg(batch->leases_->size() + batch->deleted_leases_->size())
+        .arg(config->getLogLabel());
+
+    // Schedule asynchronous HTTP request.
+    try {
+        leaseUpdateSent(config);
+        getClient(config).asyncSendRequest(config->getUrl(), config->getTlsContext(),
+                                           request, response,
+            [this, weak_queries, config]
+                (const boost::system::error_code& ec,
+                 const HttpResponsePtr& response,
+                 const std::string& error_str) {
+                // Get the shared pointers of the queries. The server should keep
+                // the pointers to the queries and then park them. Therefore, we
+                // don't really expect them to be null. If one is null, something
+                // is really wrong.
+                std::vector<LeaseUpdateBatch4::Query> queries;
+                for (auto const& weak_query : weak_queries) {
+                    LeaseUpdateBatch4::Query batched_query = weak_query.second;
+                    batched_query.query_ = weak_query.first.lock();
+                    if (!batched_query.query_) {
+                        isc_throw(Unexpected, "query is null while receiving response from"
+                                  " HA peer. This is programmatic error");
+                    }
+                    queries.push_back(batched_query);
+                }
+
+                // The errors are grouped as in asyncSendLeaseUpdate. A failed
+                // lease update of a query doesn't fail the other queries.
+                bool lease_update_success = true;
+                bool lease_update_conflict = false;
+                std::string error_message;
+                ConstElementPtr args;
+
+                if (ec || !error_str.empty()) {
+                    error_message = ec ? ec.message() : error_str;
+                    lease_update_success = false;
+
+                    for (auto const& batched_query : queries) {
+                        LOG_WARN(ha_logger, HA_LEASE_UPDATE_COMMUNICATIONS_FAILED)
+                            .arg(batched_query.query_->getLabel())
+                            .arg(config->getLogLabel())
+                            .arg(error_message);
+                    }
+
+                } else {
+
+                    try {
+                        int rcode = 0;
+                        args = verifyAsyncResponse(response, rcode);
+
+                    } catch (const ConflictError& ex) {
+                        lease_update_conflict = true;
+                        error_message = ex.what();
+                        args = getResponseArguments(response);
+
+                    } catch (const std::exception& ex) {
+                        lease_update_success = false;
+
+                        for (auto const& batched_query : queries) {
+                            LOG_WARN(ha_logger, HA_LEASE_UPDATE_FAILED)
+                                .arg(batched_query.query_->getLabel())
+                                .arg(config->getLogLabel())
+                                .arg(ex.what());
+                        }
+                    }
+                }
+
+                leaseUpdateDone(config, lease_update_success);
+
+                bool complete = false;
+                bool partner_unavailable = false;
+                for (auto const& batched_query : queries) {
+                    Pkt4Ptr query = batched_query.query_;
+                    bool query_success = lease_update_success;
+                    if (lease_update_success) {
+                        bool conflict = false;
+                        auto failed_leases = filterFailedLeases(args, batched_query.addresses_,
+                                                                conflict);
+                        // A conflict of the whole command concerns all the queries.
+                        if (lease_update_conflict && (conflict || !args)) {
+                            query_success = false;
+                            communication_state_->reportRejectedLeaseUpdate(query);
+
+                            LOG_WARN(ha_logger, HA_LEASE_UPDATE_CONFLICT)
+                                .arg(query->getLabel())
+                                .arg(config->getLogLabel())
+                                .arg(error_message);
+                        } else {
+                            logFailedLeaseUpdates(query, failed_leases);
+                        }
+                    }
+
+                    // We don't care about the result of the lease update to the
+                    // backup server. It is a best effort update.
+                    if (config->getRole() != HAConfig::PeerConfig::BACKUP) {
+                        if (!lease_update_success) {
+                            partner_unavailable = true;
+                        } else if (query_success) {
+                            communication_state_->reportSuccessfulLeaseUpdate(query);
+                        }
+                    }
+
+                    if (config_->amWaitingBackupAck() || (config->getRole() != HAConfig::PeerConfig::BACKUP)) {
+                        if (!query_success) {
+                            batched_query.parking_lot_->drop(query);
+                        }
+                    } else {
+                        // This was a response from the backup server and we're
+                        // configured to not wait for their acknowledgments.
+                        continue;
+                    }
+
+                    if (leaseUpdateComplete(query, batched_query.parking_lot_)) {
+                        complete = true;
+                    }
+                }
+
+                // If we were unable to communicate with the partner we set
+                // partner's state as unavailable.
+                if (partner_unavailable) {
+                    communication_state_->setPartnerUnavailable();
+                }
+
+                if (complete) {
+                    // Run the state machine once for all the queries whose lease
+                    // updates are complete.
+                    runModel(HA_LEASE_UPDATES_COMPLETE_EVT);
+                }
+            },
+            HttpClient::RequestTimeout(TIMEOUT_DEFAULT_HTTP_CLIENT_REQUEST),
+            std::bind(&HAService::clientConnectHandler, this, ph::_1, ph::_2),
+            std::bind(&HAService::clientHandshakeHandler, this, ph::_1),
+            std::bind(&HAService::clientCloseHandler, this, ph::_1)
+        );
+    } catch (const std::exception& ex) {
+        // The batch is sent from the timer or on behalf of another query so
+        // the error can't be returned to the callouts: the batched queries
+        // are dropped instead.
+        LOG_ERROR(ha_logger, HA_LEASE_UPDATE_BATCH_FAILED)
+            .arg(batch->queries_.size())
+            .arg(config->getLogLabel())
+            .arg(ex.what());
+        leaseUpdateDone(config, false);
+
+        if (config_->amWaitingBackupAck() || (config->getRole() != HAConfig::PeerConfig::BACKUP)) {
+            bool complete = false;
+            for (auto const& batched_query : batch->queries_) {
+                Pkt4Ptr query = batched_query.query_;
+                batched_query.parking_lot_->drop(query);
+                if (leaseUpdateComplete(query, batched_query.parking_lot_)) {
+                    complete = true;
+                }
+            }
+            if (complete) {
+                runModel(HA_LEASE_UPDATES_COMPLETE_EVT);
+            }
+        }
+    }
+}
+
 bool
 HAService::shouldSendLeaseUpdates(const HAConfig::PeerConfigPtr& peer_config) const {
     // Never send lease updates if they are administratively disabled.
@@ -1614,6 +2069,26 @@ HAService::processStatusGet() const {
         list->add(Element::create(scope));
     }
     local->set("scopes", list);
+    ElementPtr sync_progress = getSyncProgressReport();
+    if (sync_progress) {
+        local->set("sync-progress", sync_progress);
+    }
+    // Report the lease updates held unsent in the communication-recovery
+    // state.
+    size_t backlog_size = lease_update_backlog_.size();
+    if (backlog_size > 0) {
+        ElementPtr backlog = Element::createMap();
+        backlog->set("size", Element::create(static_cast<int64_t>(backlog_size)));
+        backlog->set("memory",
+                     Element::create(static_cast<int64_t>(lease_update_backlog_.getMemoryUsage())));
+        backlog->set("age",
+                     Element::create(static_cast<int64_t>(lease_update_backlog_.getAge().total_seconds())));
+        local->set("lease-update-backlog", backlog);
+    }
+    ElementPtr lease_update_queues = getLeaseUpdateQueuesReport();
+    if (lease_update_queues) {
+        local->set("lease-update-queues", lease_update_queues);
+    }
     ha_servers->set("local", local);
 
     // Do not include remote server information if this is a backup server or
@@ -1639,6 +2114,58 @@ HAService::processStatusGet() const {
     return (ha_servers);
 }
 
+ElementPtr
+HAService::getSyncProgressReport() const {
+    std::lock_guard<std::mutex> lock(sync_progress_mutex_);
+    if (!sync_progress_.started_) {
+        return (ElementPtr());
+    }
+    boost::posix_time::ptime end_time = (sync_progress_.in_progress_ ?
+        boost::posix_time::microsec_clock::universal_time() :
+        sync_progress_.end_time_);
+    int64_t duration_ms = (end_time - sync_progress_.start_time_).total_milliseconds();
+    int64_t rate = 0;
+    if (duration_ms > 0) {
+        rate = static_cast<int64_t>(sync_progress_.leases_ * 1000 / duration_ms);
+    }
+    ElementPtr report = Element::createMap();
+    report->set("in-progress", Element::create(sync_progress_.in_progress_));
+    report->set("leases-received",
+                Element::create(static_cast<int64_t>(sync_progress_.leases_)));
+    report->set("pages-received",
+                Element::create(static_cast<int64_t>(sync_progress_.pages_)));
+    report->set("duration", Element::create(duration_ms / 1000));
+    report->set("leases-per-second", Element::create(rate));
+    return (report);
+}
+
+void
+HAService::startSyncProgress() {
+    std::lock_guard<std::mutex> lock(sync_progress_mutex_);
+    sync_progress_.started_ = true;
+    sync_progress_.in_progress_ = true;
+    sync_progress_.leases_ = 0;
+    sync_progress_.pages_ = 0;
+    sync_progress_.start_time_ = boost::posix_time::microsec_clock::universal_time();
+    sync_progress_.end_time_ = sync_progress_.start_time_;
+}
+
+void
+HAService::updateSyncProgress(const size_t leases) {
+    std::lock_guard<std::mutex> lock(sync_progress_mutex_);
+    sync_progress_.leases_ += leases;
+    ++sync_progress_.pages_;
+}
+
+void
+HAService::endSyncProgress() {
+    std::lock_guard<std::mutex> lock(sync_progress_mutex_);
+    if (sync_progress_.in_progress_) {
+        sync_progress_.in_progress_ = false;
+        sync_progress_.end_time_ = boost::posix_time::microsec_clock::universal_time();
+    }
+}
+
 ConstElementPtr
 HAService::processHeartbeat() {
     ElementPtr arguments = Element::createMap();
@@ -1699,9 +2226,9 @@ HAService::asyncSendHeartbeat() {
     HttpResponseJsonPtr response = boost::make_shared<HttpResponseJson>();
 
     // Schedule asynchronous HTTP request.
-    client_->asyncSendRequest(partner_config->getUrl(),
-                              partner_config->getTlsContext(),
-                              request, response,
+    getClient(partner_config).asyncSendRequest(partner_config->getUrl(),
+                                               partner_config->getTlsContext(),
+                                               request, response,
         [this, partner_config, sync_complete_notified]
             (const boost::system::error_code& ec,
              const HttpResponsePtr& response,
@@ -2020,7 +2547,8 @@ HAService::asyncSyncLeases() {
         dhcp_disable_timeout = 1;
     }
 
-    asyncSyncLeases(*client_, config_->getFailoverPeerConfig()->getName(),
+    asyncSyncLeases(getClient(config_->getFailoverPeerConfig()),
+                    config_->getFailoverPeerConfig()->getName(),
                     dhcp_disable_timeout, LeasePtr(), null_action);
 }
 
@@ -2031,6 +2559,11 @@ HAService::asyncSyncLeases(http::HttpClient& http_client,
                            const dhcp::LeasePtr& last_lease,
                            PostSyncCallback post_sync_action,
                            const bool dhcp_disabled) {
+    // The first page of leases is fetched without a last lease.
+    if (!last_lease) {
+        startSyncProgress();
+    }
+
     // Synchronization starts with a command to disable DHCP service of the
     // peer from which we're fetching leases. We don't want the other server
     // to allocate new leases while we fetch from it. The DHCP service will
@@ -2050,6 +2583,7 @@ HAService::asyncSyncLeases(http::HttpClient& http_client,
                                     last_lease, post_sync_action, true);
 
         } else {
+            endSyncProgress();
             post_sync_action(success, error_message, dhcp_disabled);
         }
     });
@@ -2084,12 +2618,18 @@ HAService::asyncSyncLeasesInternal(http::HttpClient& http_client,
     // to know the type of the expected response.
     HttpResponseJsonPtr response = boost::make_shared<HttpResponseJson>();
 
+    // The partner returns the leases following this address.
+    IOAddress lower_bound = (last_lease ? last_lease->addr_ :
+                             (server_type_ == HAServerType::DHCPv4 ?
+                              IOAddress::IPV4_ZERO_ADDRESS() :
+                              IOAddress::IPV6_ZERO_ADDRESS()));
+
     // Schedule asynchronous HTTP request.
     http_client.asyncSendRequest(partner_config->getUrl(),
                                  partner_config->getTlsContext(),
                                  request, response,
         [this, partner_config, post_sync_action, &http_client, server_name,
-         max_period, dhcp_disabled]
+         max_period, dhcp_disabled, lower_bound]
             (const boost::system::error_code& ec,
              const HttpResponsePtr& response,
              const std::string& error_str) {
@@ -2138,83 +2678,136 @@ HAService::asyncSyncLeasesInternal(http::HttpClient& http_client,
                     LOG_INFO(ha_logger, HA_LEASES_SYNC_LEASE_PAGE_RECEIVED)
                         .arg(leases_element.size())
                         .arg(server_name);
-
-                    for (auto l = leases_element.begin(); l != leases_element.end(); ++l) {
+                    updateSyncProgress(leases_element.size());
+
+                    // Parse the leases first. The partner returns them ordered by
+                    // address so the local leases in the same address range can
+                    // be fetched at once rather than one by one.
+                    Lease4Collection leases4;
+                    Lease6Collection leases6;
+                    for (auto const& l : leases_element) {
                         try {
-
                             if (server_type_ == HAServerType::DHCPv4) {
-                                Lease4Ptr lease = Lease4::fromElement(*l);
-
-                                // Check if there is such lease in the database already.
-                                Lease4Ptr existing_lease = LeaseMgrFactory::instance().getLease4(lease->addr_);
-                                if (!existing_lease) {
-                                    // There is no such lease, so let's add it.
-                                    LeaseMgrFactory::instance().addLease(lease);
-
-                                } else if (existing_lease->cltt_ < lease->cltt_) {
-                                    // If the existing lease is older than the fetched lease, update
-                                    // the lease in our local database.
-                                    // Update lease current expiration time with value received from the
-                                    // database. Some database backends reject operations on the lease if
-                                    // the current expiration time value does not match what is stored.
-                                    Lease::syncCurrentExpirationTime(*existing_lease, *lease);
-                                    LeaseMgrFactory::instance().updateLease4(lease);
-
-                                } else {
-                                    LOG_DEBUG(ha_logger, DBGLVL_TRACE_BASIC, HA_LEASE_SYNC_STALE_LEASE4_SKIP)
-                                        .arg(lease->addr_.toText())
-                                        .arg(lease->subnet_id_);
-                                }
-
-                                // If we're not on the last page and we're processing final lease on
-                                // this page, let's record the lease as input to the next
-                                // lease4-get-page command.
-                                if ((leases_element.size() >= config_->getSyncPageLimit()) &&
-                                    (l + 1 == leases_element.end())) {
-                                    last_lease = boost::dynamic_pointer_cast<Lease>(lease);
-                                }
+                                leases4.push_back(Lease4::fromElement(l));
 
                             } else {
-                                Lease6Ptr lease = Lease6::fromElement(*l);
-
-                                // Check if there is such lease in the database already.
-                                Lease6Ptr existing_lease = LeaseMgrFactory::instance().getLease6(lease->type_,
-                                                                                                 lease->addr_);
-                                if (!existing_lease) {
-                                    // There is no such lease, so let's add it.
-                                    LeaseMgrFactory::instance().addLease(lease);
-
-                                } else if (existing_lease->cltt_ < lease->cltt_) {
-                                    // If the existing lease is older than the fetched lease, update
-                                    // the lease in our local database.
-                                    // Update lease current expiration time with value received from the
-                                    // database. Some database backends reject operations on the lease if
-                                    // the current expiration time value does not match what is stored.
-                                    Lease::syncCurrentExpirationTime(*existing_lease, *lease);
-                                    LeaseMgrFactory::instance().updateLease6(lease);
-
-                                } else {
-                                    LOG_DEBUG(ha_logger, DBGLVL_TRACE_BASIC, HA_LEASE_SYNC_STALE_LEASE6_SKIP)
-                                        .arg(lease->addr_.toText())
-                                        .arg(lease->subnet_id_);
-                                }
-
-                                // If we're not on the last page and we're processing final lease on
-                                // this page, let's record the lease as input to the next
-                                // lease6-get-page command.
-                                if ((leases_element.size() >= config_->getSyncPageLimit()) &&
-                                    (l + 1 == leases_element.end())) {
-                                    last_lease = boost::dynamic_pointer_cast<Lease>(lease);
-                                }
+                                leases6.push_back(Lease6::fromElement(l));
                             }
 
                         } catch (const std::exception& ex) {
                             LOG_WARN(ha_logger, HA_LEASE_SYNC_FAILED)
-                                .arg((*l)->str())
+                                .arg(l->str())
                                 .arg(ex.what());
                         }
                     }
 
+                    // If we're not on the last page, let's record the last lease
+                    // as input to the next leaseX-get-page command.
+                    if (leases_element.size() >= config_->getSyncPageLimit()) {
+                        if (!leases4.empty()) {
+                            last_lease = boost::dynamic_pointer_cast<Lease>(leases4.back());
+
+                        } else if (!leases6.empty()) {
+                            last_lease = boost::dynamic_pointer_cast<Lease>(leases6.back());
+                        }
+                    }
+
+                    // The leases are collected and then added or updated at once.
+                    Lease4Collection leases4_to_add;
+                    Lease4Collection leases4_to_update;
+                    Lease6Collection leases6_to_add;
+                    Lease6Collection leases6_to_update;
+
+                    LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
+                    if (!leases4.empty()) {
+                        std::map<IOAddress, Lease4Ptr> existing_leases;
+                        Lease4Collection local = getLocalLeases<Lease4Collection>(
+                            lower_bound, leases4.back()->addr_, config_->getSyncPageLimit(),
+                            [&lease_mgr](const IOAddress& lower, const LeasePageSize& size) {
+                                return (lease_mgr.getLeases4(lower, size));
+                            });
+                        for (auto const& existing_lease : local) {
+                            existing_leases[existing_lease->addr_] = existing_lease;
+                        }
+
+                        for (auto const& lease : leases4) {
+                            // Check if there is such lease in the database already.
+                            auto existing = existing_leases.find(lease->addr_);
+                            if (existing == existing_leases.end()) {
+                                // There is no such lease, so let's add it.
+                                leases4_to_add.push_back(lease);
+
+                            } else if (existing->second->cltt_ < lease->cltt_) {
+                                // If the existing lease is older than the fetched lease, update
+                                // the lease in our local database.
+                                // Update lease current expiration time with value received from the
+                                // database. Some database backends reject operations on the lease if
+                                // the current expiration time value does not match what is stored.
+                                Lease::syncCurrentExpirationTime(*existing->second, *lease);
+                                leases4_to_update.push_back(lease);
+
+                            } else {
+                                LOG_DEBUG(ha_logger, DBGLVL_TRACE_BASIC, HA_LEASE_SYNC_STALE_LEASE4_SKIP)
+                                    .arg(lease->addr_.toText())
+                                    .arg(lease->subnet_id_);
+                            }
+                        }
+                    }
+
+                    if (!leases6.empty()) {
+                        std::map<std::pair<Lease::Type, IOAddress>, Lease6Ptr> existing_leases;
+                        Lease6Collection local = getLocalLeases<Lease6Collection>(
+                            lower_bound, leases6.back()->addr_, config_->getSyncPageLimit(),
+                            [&lease_mgr](const IOAddress& lower, const LeasePageSize& size) {
+                                return (lease_mgr.getLeases6(lower, size));
+                            });
+                        for (auto const& existing_lease : local) {
+                            existing_leases[std::make_pair(existing_lease->type_,
+                                                           existing_lease->addr_)] = existing_lease;
+                        }
+
+                        for (auto const& lease : leases6) {
+                            // Check if there is such lease in the database already.
+                            auto existing = existing_leases.find(std::make_pair(lease->type_,
+                                                                                lease->addr_));
+                            if (existing == existing_leases.end()) {
+                                // There is no such lease, so let's add it.
+                                leases6_to_add.push_back(lease);
+
+                            } else if (existing->second->cltt_ < lease->cltt_) {
+                                // If the existing lease is older than the fetched lease, update
+                                // the lease in our local database.
+                                // Update lease current expiration time with value received from the
+                                // database. Some database backends reject operations on the lease if
+                                // the current expiration time value does not match what is stored.
+                                Lease::syncCurrentExpirationTime(*existing->second, *lease);
+                                leases6_to_update.push_back(lease);
+
+                            } else {
+                                LOG_DEBUG(ha_logger, DBGLVL_TRACE_BASIC, HA_LEASE_SYNC_STALE_LEASE6_SKIP)
+                                    .arg(lease->addr_.toText())
+                                    .arg(lease->subnet_id_);
+                            }
+                        }
+                    }
+
+                    syncLeasesBulk<Lease4Collection>(leases4_to_add, "add",
+                        std::bind(&LeaseMgr::addLeases4, &lease_mgr, ph::_1),
+                        [&lease_mgr](const Lease4Ptr& lease) {
+                            lease_mgr.addLease(lease);
+                        });
+                    syncLeasesBulk<Lease4Collection>(leases4_to_update, "update",
+                        std::bind(&LeaseMgr::updateLeases4, &lease_mgr, ph::_1),
+                        std::bind(&LeaseMgr::updateLease4, &lease_mgr, ph::_1));
+                    syncLeasesBulk<Lease6Collection>(leases6_to_add, "add",
+                        std::bind(&LeaseMgr::addLeases6, &lease_mgr, ph::_1),
+                        [&lease_mgr](const Lease6Ptr& lease) {
+                            lease_mgr.addLease(lease);
+                        });
+                    syncLeasesBulk<Lease6Collection>(leases6_to_update, "update",
+                        std::bind(&LeaseMgr::updateLeases6, &lease_mgr, ph::_1),
+                        std::bind(&LeaseMgr::updateLease6, &lease_mgr, ph::_1));
+
                 } catch (const std::exception& ex) {
                     error_message = ex.what();
                     LOG_ERROR(ha_logger, HA_LEASES_SYNC_FAILED)
@@ -2236,6 +2829,8 @@ HAService::asyncSyncLeasesInternal(http::HttpClient& http_client,
                  return;
              }
 
+             endSyncProgress();
+
             // Invoke post synchronization action if it was specified.
             if (post_sync_action) {
                 post_sync_action(error_message.empty(),
@@ -3067,6 +3662,54 @@ HAService::verifyAsyncResponse(const HttpResponsePtr& response, int& rcode) {
     return (args);
 }
 
+ElementPtr
+HAService::getLeaseUpdateQueuesReport() const {
+    std::lock_guard<std::mutex> lock(lease_update_queues_mutex_);
+    if (lease_update_queues_.empty()) {
+        return (ElementPtr());
+    }
+    ElementPtr report = Element::createMap();
+    for (auto const& queue : lease_update_queues_) {
+        ElementPtr counters = Element::createMap();
+        counters->set("pending",
+                      Element::create(static_cast<int64_t>(queue.second.pending_)));
+        counters->set("sent",
+                      Element::create(static_cast<int64_t>(queue.second.sent_)));
+        counters->set("failed",
+                      Element::create(static_cast<int64_t>(queue.second.failed_)));
+        report->set(queue.first, counters);
+    }
+    return (report);
+}
+
+HttpClient&
+HAService::getClient(const HAConfig::PeerConfigPtr& config) {
+    auto it = peer_clients_.find(config->getName());
+    if (it != peer_clients_.end()) {
+        return (*it->second);
+    }
+    return (*client_);
+}
+
+void
+HAService::leaseUpdateSent(const HAConfig::PeerConfigPtr& config) {
+    std::lock_guard<std::mutex> lock(lease_update_queues_mutex_);
+    ++lease_update_queues_[config->getName()].pending_;
+}
+
+void
+HAService::leaseUpdateDone(const HAConfig::PeerConfigPtr& config, bool success) {
+    std::lock_guard<std::mutex> lock(lease_update_queues_mutex_);
+    LeaseUpdateQueue& queue = lease_update_queues_[config->getName()];
+    if (queue.pending_ > 0) {
+        --queue.pending_;
+    }
+    ++queue.sent_;
+    if (!success) {
+        ++queue.failed_;
+    }
+}
+
 bool
 HAService::clientConnectHandler(const boost::system::error_code& ec, int tcp_native_fd) {
 
@@ -3157,6 +3800,10 @@ HAService::checkPermissionsClientAndListener() {
             client_->checkPermissions();
         }
 
+        for (auto const& peer_client : peer_clients_) {
+            peer_client.second->checkPermissions();
+        }
+
         if (listener_) {
             listener_->checkPermissions();
         }
@@ -3184,6 +3831,10 @@ HAService::startClientAndListener() {
         client_->start();
     }
 
+    for (auto const& peer_client : peer_clients_) {
+        peer_client.second->start();
+    }
+
     if (listener_) {
         listener_->start();
     }
@@ -3198,6 +3849,10 @@ HAService::pauseClientAndListener() {
             client_->pause();
         }
 
+        for (auto const& peer_client : peer_clients_) {
+            peer_client.second->pause();
+        }
+
         if (listener_) {
             listener_->pause();
         }
@@ -3216,6 +3871,10 @@ HAService::resumeClientAndListener() {
             client_->resume();
         }
 
+        for (auto const& peer_client : peer_clients_) {
+            peer_client.second->resume();
+        }
+
         if (listener_) {
             listener_->resume();
         }
@@ -3234,6 +3893,10 @@ HAService::stopClientAndListener() {
         client_->stop();
     }
 
+    for (auto const& peer_client : peer_clients_) {
+        peer_client.second->stop();
+    }
+
     if (listener_) {
         listener_->stop();
     }
@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,6 +13,7 @@
 #include <lease_update_backlog.h>
 #include <query_filter.h>
 #include <asiolink/asio_wrapper.h>
+#include <asiolink/interval_timer.h>
 #include <asiolink/io_service.h>
 #include <asiolink/tls_socket.h>
 #include <cc/data.h>
@@ -25,11 +26,14 @@
 #include <http/client.h>
 #include <util/state_model.h>
 
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
 #include <functional>
 #include <map>
 #include <mutex>
+#include <set>
+#include <string>
 #include <vector>
 
 namespace isc {
@@ -532,6 +536,9 @@ public:
     /// the backup server fails, an error message is logged but the DHCP
     /// packet is not dropped.
     ///
+    /// When the lease updates batch window is configured, the lease updates
+    /// are added to the batches of the peers instead of being sent at once.
+    ///
     /// This method must be called only if there is at least one lease
     /// altered.
     ///
@@ -595,6 +602,87 @@ protected:
                               const data::ConstElementPtr& command,
                               const hooks::ParkingLotHandlePtr& parking_lot);
 
+    /// @brief DHCPv4 lease updates waiting to be sent to a peer in a single
+    /// lease4-bulk-apply command.
+    ///
+    /// The batches are used when the @c lease-updates-batch-window is not
+    /// zero and the HTTP client runs its own threads.
+    struct LeaseUpdateBatch4 {
+        /// @brief A query whose lease updates are in the batch.
+        struct Query {
+            /// @brief Pointer to the DHCP client's query.
+            dhcp::Pkt4Ptr query_;
+
+            /// @brief Parking lot where the query is parked.
+            hooks::ParkingLotHandlePtr parking_lot_;
+
+            /// @brief Addresses of the query leases.
+            std::set<std::string> addresses_;
+        };
+
+        /// @brief Constructor.
+        ///
+        /// @param config Pointer to the configuration of the peer.
+        explicit LeaseUpdateBatch4(const HAConfig::PeerConfigPtr& config)
+            : config_(config), leases_(new dhcp::Lease4Collection()),
+              deleted_leases_(new dhcp::Lease4Collection()), queries_(),
+              addresses_() {
+        }
+
+        /// @brief Pointer to the configuration of the peer.
+        HAConfig::PeerConfigPtr config_;
+
+        /// @brief New allocations and updated leases.
+        dhcp::Lease4CollectionPtr leases_;
+
+        /// @brief Deleted leases.
+        dhcp::Lease4CollectionPtr deleted_leases_;
+
+        /// @brief Queries whose lease updates are in the batch.
+        std::vector<Query> queries_;
+
+        /// @brief Addresses of all the leases in the batch.
+        std::set<std::string> addresses_;
+    };
+
+    /// @brief Pointer to the @c LeaseUpdateBatch4.
+    typedef boost::shared_ptr<LeaseUpdateBatch4> LeaseUpdateBatch4Ptr;
+
+    /// @brief Adds DHCPv4 lease updates to the batch of a peer.
+    ///
+    /// The pending request of the query is recorded before the updates
+    /// are added to the batch. When the batch already holds a lease with
+    /// one of the addresses the batch is sent first so the updates of an
+    /// address are applied by the peer in order.
+    ///
+    /// @param query Pointer to the DHCP client's query.
+    /// @param config Pointer to the configuration of the peer.
+    /// @param leases Pointer to a collection of the newly allocated or
+    /// updated leases.
+    /// @param deleted_leases Pointer to a collection of the released leases.
+    /// @param parking_lot Parking lot where the query is parked.
+    void batchLeaseUpdates(const dhcp::Pkt4Ptr& query,
+                           const HAConfig::PeerConfigPtr& config,
+                           const dhcp::Lease4CollectionPtr& leases,
+                           const dhcp::Lease4CollectionPtr& deleted_leases,
+                           const hooks::ParkingLotHandlePtr& parking_lot);
+
+    /// @brief Sends the batched DHCPv4 lease updates to the peers.
+    ///
+    /// It is called by the batch window timer.
+    void flushLeaseUpdateBatches();
+
+    /// @brief Asynchronously sends a batch of DHCPv4 lease updates to a peer.
+    ///
+    /// The response is processed for each query of the batch as
+    /// @c asyncSendLeaseUpdate does for a single query. The failed leases
+    /// reported by the peer are attributed to the queries by address so a
+    /// conflict only rejects the queries whose leases are in conflict.
+    ///
+    /// @param batch Pointer to the batch.
+    /// @throw Unexpected when an unexpected error occurs.
+    void asyncSendLeaseUpdateBatch(const LeaseUpdateBatch4Ptr& batch);
+
     /// @brief Log failed lease updates.
     ///
     /// Logs failed lease updates included in the "failed-deleted-leases"
@@ -666,6 +754,50 @@ public:
     /// HA servers status into the status-get response.
     data::ConstElementPtr processStatusGet() const;
 
+    /// @brief Returns the progress of the lease database synchronization.
+    ///
+    /// It is included in the status-get response when the server started
+    /// synchronizing its lease database at least once. The report is a map:
+    ///
+    /// @code
+    /// {
+    ///     "in-progress": true,
+    ///     "leases-received": 30000,
+    ///     "pages-received": 300,
+    ///     "duration": 12,
+    ///     "leases-per-second": 2500
+    /// }
+    /// @endcode
+    ///
+    /// The duration is in seconds. It covers the current synchronization if
+    /// it is in progress, the last one otherwise.
+    ///
+    /// @return Pointer to the report or null if the lease database was never
+    /// synchronized.
+    data::ElementPtr getSyncProgressReport() const;
+
+    /// @brief Returns the report of the lease updates sent to each peer.
+    ///
+    /// The report is included in the local part of the status-get
+    /// response, e.g.:
+    ///
+    /// @code
+    /// {
+    ///     "server2": {
+    ///         "pending": 3,
+    ///         "sent": 10000,
+    ///         "failed": 2
+    ///     }
+    /// }
+    /// @endcode
+    ///
+    /// The pending lease updates were sent and wait for the response of
+    /// the peer, the sent and failed ones are counted when the response
+    /// is received.
+    ///
+    /// @return Pointer to the report or null if no lease update was sent.
+    data::ElementPtr getLeaseUpdateQueuesReport() const;
+
     /// @brief Processes ha-reset command and returns a response.
     ///
     /// This method processes ha-reset command which instructs the server to
@@ -1106,6 +1238,24 @@ protected:
     data::ConstElementPtr verifyAsyncResponse(const http::HttpResponsePtr& response,
                                               int& rcode);
 
+    /// @brief Returns the HTTP client used to communicate with a peer.
+    ///
+    /// @param config configuration of the peer.
+    /// @return the client of the peer when the server uses an HTTP client
+    /// per peer, the common client otherwise.
+    http::HttpClient& getClient(const HAConfig::PeerConfigPtr& config);
+
+    /// @brief Counts a lease update sent to a peer.
+    ///
+    /// @param config configuration of the peer.
+    void leaseUpdateSent(const HAConfig::PeerConfigPtr& config);
+
+    /// @brief Counts the response to a lease update sent to a peer.
+    ///
+    /// @param config configuration of the peer.
+    /// @param success true when the lease update was successful.
+    void leaseUpdateDone(const HAConfig::PeerConfigPtr& config, bool success);
+
     /// @brief HttpClient connect callback handler
     ///
     /// Passed into HttpClient calls to allow registration of client's TCP socket
@@ -1169,6 +1319,13 @@ protected:
     /// @brief HTTP client instance used to send HA commands and lease updates.
     http::HttpClientPtr client_;
 
+    /// @brief HTTP client instances of the peers by name.
+    ///
+    /// They are used instead of the common client when the server uses
+    /// an HTTP client per peer, so each peer has its own threads and
+    /// connections and a slow peer does not delay the others.
+    std::map<std::string, http::HttpClientPtr> peer_clients_;
+
     /// @brief HTTP listener instance used to receive and respond to HA commands
     /// and lease updates.
     config::CmdHttpListenerPtr listener_;
@@ -1274,6 +1431,18 @@ private:
     /// @brief Mutex to protect the internal state.
     std::mutex mutex_;
 
+    /// @brief Mutex to protect the lease update batches.
+    std::mutex batch_mutex_;
+
+    /// @brief DHCPv4 lease update batches by peer name.
+    std::map<std::string, LeaseUpdateBatch4Ptr> lease_update_batches_;
+
+    /// @brief Timer sending the DHCPv4 lease update batches.
+    ///
+    /// It runs on the HTTP client IO service and is null when the lease
+    /// updates are not batched.
+    asiolink::IntervalTimerPtr batch_timer_;
+
     /// @brief Map holding a number of scheduled requests for a given packet.
     ///
     /// A single callout may send multiple requests at the same time, e.g.
@@ -1301,6 +1470,72 @@ protected:
     /// re-established. If the communication remains broken, the server clears
     /// this flag and enables DHCP service to continue the service.
     bool sync_complete_notified_;
+
+    /// @brief Records the start of the lease database synchronization.
+    void startSyncProgress();
+
+    /// @brief Records a page of synchronized leases.
+    ///
+    /// @param leases Number of leases on the page.
+    void updateSyncProgress(const size_t leases);
+
+    /// @brief Records the end of the lease database synchronization.
+    void endSyncProgress();
+
+    /// @brief Progress of the lease database synchronization.
+    struct SyncProgress {
+        /// @brief Constructor.
+        SyncProgress()
+            : started_(false), in_progress_(false), leases_(0), pages_(0),
+              start_time_(), end_time_() {
+        }
+
+        /// @brief Indicates if the synchronization was started at least once.
+        bool started_;
+
+        /// @brief Indicates if the synchronization is in progress.
+        bool in_progress_;
+
+        /// @brief Number of leases received.
+        uint64_t leases_;
+
+        /// @brief Number of pages of leases received.
+        uint64_t pages_;
+
+        /// @brief Time when the synchronization started.
+        boost::posix_time::ptime start_time_;
+
+        /// @brief Time when the synchronization ended.
+        boost::posix_time::ptime end_time_;
+    };
+
+    /// @brief Mutex to protect the synchronization progress.
+    mutable std::mutex sync_progress_mutex_;
+
+    /// @brief Progress of the current or last lease database synchronization.
+    SyncProgress sync_progress_;
+
+    /// @brief Counters of the lease updates sent to a peer.
+    struct LeaseUpdateQueue {
+        /// @brief Constructor.
+        LeaseUpdateQueue() : pending_(0), sent_(0), failed_(0) {
+        }
+
+        /// @brief Number of lease updates waiting for a response.
+        uint64_t pending_;
+
+        /// @brief Number of lease updates which got a response.
+        uint64_t sent_;
+
+        /// @brief Number of failed lease updates.
+        uint64_t failed_;
+    };
+
+    /// @brief Mutex to protect the lease update counters.
+    mutable std::mutex lease_update_queues_mutex_;
+
+    /// @brief Lease update counters by peer name.
+    std::map<std::string, LeaseUpdateQueue> lease_update_queues_;
 };
 
 /// @brief Pointer to the @c HAService class.
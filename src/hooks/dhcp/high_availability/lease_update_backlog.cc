@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,15 +7,19 @@
 #include <config.h>
 
 #include <lease_update_backlog.h>
+#include <dhcp/duid.h>
+#include <dhcp/hwaddr.h>
 #include <util/multi_threading_mgr.h>
+#include <boost/pointer_cast.hpp>
 
 using namespace isc::dhcp;
 
 namespace isc {
 namespace ha {
 
-LeaseUpdateBacklog::LeaseUpdateBacklog(const size_t limit)
-    : limit_(limit), overflown_(false), outstanding_updates_() {
+LeaseUpdateBacklog::LeaseUpdateBacklog(const size_t limit, const size_t memory_limit)
+    : limit_(limit), memory_limit_(memory_limit), overflown_(false),
+      outstanding_updates_(), memory_(0) {
 }
 
 bool
@@ -50,14 +54,17 @@ LeaseUpdateBacklog::clear() {
     if (util::MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(mutex_);
         outstanding_updates_.clear();
+        memory_ = 0;
         overflown_ = false;
+        return;
     }
     outstanding_updates_.clear();
+    memory_ = 0;
     overflown_ = false;
 }
 
 size_t
-LeaseUpdateBacklog::size() {
+LeaseUpdateBacklog::size() const {
     if (util::MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(mutex_);
         return (outstanding_updates_.size());
@@ -65,13 +72,89 @@ LeaseUpdateBacklog::size() {
     return (outstanding_updates_.size());
 }
 
+size_t
+LeaseUpdateBacklog::getMemoryUsage() const {
+    if (util::MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return (memory_);
+    }
+    return (memory_);
+}
+
+boost::posix_time::time_duration
+LeaseUpdateBacklog::getAge() const {
+    boost::posix_time::ptime oldest;
+    if (util::MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (outstanding_updates_.empty()) {
+            return (boost::posix_time::time_duration(0, 0, 0));
+        }
+        oldest = outstanding_updates_.front().time_;
+    } else {
+        if (outstanding_updates_.empty()) {
+            return (boost::posix_time::time_duration(0, 0, 0));
+        }
+        oldest = outstanding_updates_.front().time_;
+    }
+    return (boost::posix_time::microsec_clock::universal_time() - oldest);
+}
+
+size_t
+LeaseUpdateBacklog::getLeaseMemoryUsage(const LeasePtr& lease) {
+    if (!lease) {
+        return (0);
+    }
+    size_t memory = lease->hostname_.size();
+    if (lease->hwaddr_) {
+        memory += sizeof(HWAddr) + lease->hwaddr_->hwaddr_.size();
+    }
+    Lease6Ptr lease6 = boost::dynamic_pointer_cast<Lease6>(lease);
+    if (lease6) {
+        memory += sizeof(Lease6);
+        if (lease6->duid_) {
+            memory += sizeof(DUID) + lease6->duid_->getDuid().size();
+        }
+    } else {
+        memory += sizeof(Lease4);
+        Lease4Ptr lease4 = boost::dynamic_pointer_cast<Lease4>(lease);
+        if (lease4 && lease4->client_id_) {
+            memory += sizeof(ClientId) + lease4->client_id_->getClientId().size();
+        }
+    }
+    return (memory);
+}
+
 bool
 LeaseUpdateBacklog::pushInternal(const LeaseUpdateBacklog::OpType op_type, const LeasePtr& lease) {
-    if (outstanding_updates_.size() >= limit_) {
+    size_t memory = getLeaseMemoryUsage(lease);
+    int type = static_cast<int>(lease->getType());
+    auto& index = outstanding_updates_.get<1>();
+    auto existing = index.find(boost::make_tuple(type, lease->addr_));
+    if (existing != index.end()) {
+        // Replace the queued update for this lease.
+        size_t new_memory = memory_ - existing->memory_ + memory;
+        if ((memory_limit_ > 0) && (new_memory > memory_limit_)) {
+            overflown_ = true;
+            return (false);
+        }
+        Update update = *existing;
+        update.op_type_ = op_type;
+        update.lease_ = lease;
+        update.memory_ = memory;
+        static_cast<void>(index.replace(existing, update));
+        memory_ = new_memory;
+        return (true);
+    }
+
+    if ((outstanding_updates_.size() >= limit_) ||
+        ((memory_limit_ > 0) && (memory_ + memory > memory_limit_))) {
         overflown_ = true;
         return (false);
     }
-    outstanding_updates_.push_back(std::make_pair(op_type, lease));
+    Update update = { op_type, lease, type, lease->addr_,
+                      boost::posix_time::microsec_clock::universal_time(), memory };
+    outstanding_updates_.push_back(update);
+    memory_ += memory;
     return (true);
 }
 
@@ -82,8 +165,9 @@ LeaseUpdateBacklog::popInternal(LeaseUpdateBacklog::OpType& op_type) {
     }
     auto item = outstanding_updates_.front();
     outstanding_updates_.pop_front();
-    op_type = item.first;
-    return (item.second);
+    memory_ -= item.memory_;
+    op_type = item.op_type_;
+    return (item.lease_);
 }
 
 } // end of namespace isc::ha
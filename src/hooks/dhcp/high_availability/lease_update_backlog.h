@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,10 +7,15 @@
 #ifndef HA_LEASE_BACKLOG_H
 #define HA_LEASE_BACKLOG_H
 
+#include <asiolink/io_address.h>
 #include <dhcpsrv/lease.h>
-#include <deque>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
 #include <mutex>
-#include <utility>
 
 namespace isc {
 namespace ha {
@@ -27,21 +32,17 @@ namespace ha {
 /// This queue has configurable size. If the number of leases appended
 /// to the queue reaches the limit, no more updates can be added to it.
 /// This prevents inifinite growth of the queue and excessive memory
-/// consumption.
+/// consumption. The queue may also be limited by the approximate amount
+/// of memory used by the queued leases.
 ///
 /// There are two types of lease updates: "Add" and "Delete". The type
 /// is specified when the lease is appended to the queue.
 ///
 /// The backlog queue holds both "Add" and "Delete" lease updates in a
-/// single std::deque container, which allows for ordering them
-/// chronologically and using this ordering for queue optimizations in
-/// the future. For example, if the queue contains consecutive "Delete"
-/// updates for a particular IP address, the server could only delete
-/// the lease once. If the queue contains multiple "Delete" lease updates
-/// followed by an "Add" update, the server could skip sending "Delete"
-/// updates.
-///
-/// Queue optimizations will be subject to future work!
+/// single container, which orders them chronologically. Only the last
+/// update for a lease is relevant to the partner, so an update for a
+/// lease already in the queue replaces the queued update in place: the
+/// queue holds at most one update per lease address (and type in DHCPv6).
 class LeaseUpdateBacklog {
 public:
 
@@ -55,10 +56,16 @@ public:
     ///
     /// @param limit specifies the maximum number of lease updates which
     /// can be stored in the queue.
-    LeaseUpdateBacklog(const size_t limit);
+    /// @param memory_limit specifies the maximum amount of memory in bytes
+    /// used by the lease updates stored in the queue. The value of 0 means
+    /// no limit.
+    LeaseUpdateBacklog(const size_t limit, const size_t memory_limit = 0);
 
     /// @brief Appends lease update to the queue.
     ///
+    /// If the queue already holds an update for the lease, this update
+    /// replaces it.
+    ///
     /// @param op_type type of the lease update (operation type).
     /// @param lease pointer to the lease being added, or deleted.
     /// @return boolean value indicating whether the lease was successfully
@@ -93,7 +100,25 @@ public:
     void clear();
 
     /// @brief Returns the current size of the queue.
-    size_t size();
+    size_t size() const;
+
+    /// @brief Returns the approximate amount of memory used by the lease
+    /// updates in the queue.
+    ///
+    /// @return Memory usage in bytes.
+    size_t getMemoryUsage() const;
+
+    /// @brief Returns the age of the oldest lease update in the queue.
+    ///
+    /// @return Time elapsed since the oldest lease update was appended to
+    /// the queue, or zero if the queue is empty.
+    boost::posix_time::time_duration getAge() const;
+
+    /// @brief Returns the approximate amount of memory used by a lease.
+    ///
+    /// @param lease pointer to the lease.
+    /// @return Memory usage in bytes.
+    static size_t getLeaseMemoryUsage(const dhcp::LeasePtr& lease);
 
 private:
 
@@ -112,17 +137,65 @@ private:
     /// when the queue is empty.
     dhcp::LeasePtr popInternal(OpType& op_type);
 
+    /// @brief A lease update in the queue.
+    struct Update {
+        /// @brief Type of the lease update.
+        OpType op_type_;
+
+        /// @brief Pointer to the lease.
+        dhcp::LeasePtr lease_;
+
+        /// @brief Lease type.
+        int type_;
+
+        /// @brief Lease address.
+        asiolink::IOAddress address_;
+
+        /// @brief Time when the lease was appended to the queue.
+        ///
+        /// It is not changed when the update is replaced.
+        boost::posix_time::ptime time_;
+
+        /// @brief Approximate amount of memory used by the lease.
+        size_t memory_;
+    };
+
+    /// @brief Container of the lease updates.
+    ///
+    /// The first index is the order of the updates. The second index
+    /// finds the update for a lease.
+    typedef boost::multi_index_container<
+        Update,
+        boost::multi_index::indexed_by<
+            boost::multi_index::sequenced<>,
+            boost::multi_index::hashed_unique<
+                boost::multi_index::composite_key<
+                    Update,
+                    boost::multi_index::member<Update, int, &Update::type_>,
+                    boost::multi_index::member<Update, asiolink::IOAddress,
+                                               &Update::address_>
+                >
+            >
+        >
+    > UpdateContainer;
+
     /// @brief Holds the queue size limit.
     size_t limit_;
 
+    /// @brief Holds the queue memory limit.
+    size_t memory_limit_;
+
     /// @brief Remembers whether the queue was overflown.
     bool overflown_;
 
     /// @brief Actual queue of lease updates and their types.
-    std::deque<std::pair<OpType, dhcp::LeasePtr> > outstanding_updates_;
+    UpdateContainer outstanding_updates_;
+
+    /// @brief Approximate amount of memory used by the queued leases.
+    size_t memory_;
 
     /// @brief Mutex to protect internal state.
-    std::mutex mutex_;
+    mutable std::mutex mutex_;
 };
 
 } // end of namespace isc::ha
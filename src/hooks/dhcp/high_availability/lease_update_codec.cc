@@ -0,0 +1,364 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <lease_update_codec.h>
+#include <asiolink/io_address.h>
+#include <cc/data.h>
+#include <exceptions/exceptions.h>
+#include <limits>
+#include <string>
+
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::util;
+
+namespace {
+
+/// @brief FQDN flag set when the forward DNS update was performed.
+const uint8_t FQDN_FWD_FLAG = 0x01;
+
+/// @brief FQDN flag set when the reverse DNS update was performed.
+const uint8_t FQDN_REV_FLAG = 0x02;
+
+/// @brief Size of the header of an update message or an acknowledgment.
+const size_t HEADER_SIZE = sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint16_t);
+
+/// @brief Appends data preceded by its 1 byte length.
+///
+/// @param data data to append.
+/// @param buffer output buffer.
+/// @param what name of the data used in the error message.
+/// @throw BadValue if the data is too long.
+void
+writeData8(const std::vector<uint8_t>& data, OutputBuffer& buffer,
+           const char* what) {
+    if (data.size() > std::numeric_limits<uint8_t>::max()) {
+        isc_throw(isc::BadValue, what << " is too long: " << data.size());
+    }
+    buffer.writeUint8(static_cast<uint8_t>(data.size()));
+    buffer.writeData(data.data(), data.size());
+}
+
+/// @brief Appends a string preceded by its 2 bytes length.
+///
+/// @param data string to append.
+/// @param buffer output buffer.
+/// @param what name of the string used in the error message.
+/// @throw BadValue if the string is too long.
+void
+writeString16(const std::string& data, OutputBuffer& buffer,
+              const char* what) {
+    if (data.size() > std::numeric_limits<uint16_t>::max()) {
+        isc_throw(isc::BadValue, what << " is too long: " << data.size());
+    }
+    buffer.writeUint16(static_cast<uint16_t>(data.size()));
+    buffer.writeData(data.data(), data.size());
+}
+
+/// @brief Reads data preceded by its 1 byte length.
+///
+/// @param buffer input buffer.
+/// @return read data.
+std::vector<uint8_t>
+readData8(InputBuffer& buffer) {
+    std::vector<uint8_t> data;
+    uint8_t length = buffer.readUint8();
+    if (length > 0) {
+        buffer.readVector(data, length);
+    }
+    return (data);
+}
+
+/// @brief Reads a string preceded by its 2 bytes length.
+///
+/// @param buffer input buffer.
+/// @return read string.
+std::string
+readString16(InputBuffer& buffer) {
+    std::vector<uint8_t> data;
+    uint16_t length = buffer.readUint16();
+    if (length > 0) {
+        buffer.readVector(data, length);
+    }
+    return (std::string(data.begin(), data.end()));
+}
+
+/// @brief Checks the header of a message.
+///
+/// @param buffer input buffer positioned at the start of the message.
+/// @param kind expected kind of the message.
+/// @param [out] sequence sequence number of the message.
+/// @return the count following the sequence number.
+/// @throw BadValue if the message is not of the expected kind.
+uint16_t
+readHeader(InputBuffer& buffer, isc::ha::LeaseUpdateCodec::Kind kind,
+           uint32_t& sequence) {
+    uint8_t got = buffer.readUint8();
+    if (got != kind) {
+        isc_throw(isc::BadValue, "unexpected lease update message kind "
+                  << static_cast<unsigned>(got) << ", expected "
+                  << static_cast<unsigned>(kind));
+    }
+    sequence = buffer.readUint32();
+    return (buffer.readUint16());
+}
+
+} // end of anonymous namespace
+
+namespace isc {
+namespace ha {
+
+const size_t LeaseUpdateCodec::MAX_MESSAGE_SIZE;
+
+std::vector<uint8_t>
+LeaseUpdateCodec::encodeUpdates(uint32_t sequence, const Updates& updates,
+                                size_t first, size_t& encoded) {
+    OutputBuffer buffer(MAX_MESSAGE_SIZE);
+    buffer.writeUint8(UPDATE);
+    buffer.writeUint32(sequence);
+    // The count is written when known.
+    buffer.writeUint16(0);
+
+    encoded = 0;
+    OutputBuffer update_buffer(512);
+    for (size_t i = first; i < updates.size(); ++i) {
+        if (encoded == std::numeric_limits<uint16_t>::max()) {
+            break;
+        }
+        update_buffer.clear();
+        encodeUpdate(updates[i], update_buffer);
+        if (buffer.getLength() + update_buffer.getLength() > MAX_MESSAGE_SIZE) {
+            if (encoded == 0) {
+                isc_throw(BadValue, "lease update for "
+                          << updates[i].second->addr_
+                          << " does not fit in a message");
+            }
+            break;
+        }
+        buffer.writeData(update_buffer.getData(), update_buffer.getLength());
+        ++encoded;
+    }
+    buffer.writeUint16At(static_cast<uint16_t>(encoded),
+                         sizeof(uint8_t) + sizeof(uint32_t));
+
+    const uint8_t* data = static_cast<const uint8_t*>(buffer.getData());
+    return (std::vector<uint8_t>(data, data + buffer.getLength()));
+}
+
+uint32_t
+LeaseUpdateCodec::decodeUpdates(const uint8_t* data, size_t length,
+                                Updates& updates) {
+    updates.clear();
+    InputBuffer buffer(data, length);
+    uint32_t sequence = 0;
+    try {
+        uint16_t count = readHeader(buffer, UPDATE, sequence);
+        updates.reserve(count);
+        for (uint16_t i = 0; i < count; ++i) {
+            updates.push_back(decodeUpdate(buffer));
+        }
+    } catch (const InvalidBufferPosition&) {
+        isc_throw(BadValue, "truncated lease update message");
+    }
+    if (buffer.getPosition() != buffer.getLength()) {
+        isc_throw(BadValue, "trailing " << (buffer.getLength() - buffer.getPosition())
+                  << " bytes in lease update message");
+    }
+    return (sequence);
+}
+
+std::vector<uint8_t>
+LeaseUpdateCodec::encodeAck(uint32_t sequence,
+                            const std::vector<uint16_t>& failed) {
+    if (failed.size() > std::numeric_limits<uint16_t>::max()) {
+        isc_throw(BadValue, "too many failed lease updates: " << failed.size());
+    }
+    OutputBuffer buffer(HEADER_SIZE + failed.size() * sizeof(uint16_t));
+    buffer.writeUint8(ACK);
+    buffer.writeUint32(sequence);
+    buffer.writeUint16(static_cast<uint16_t>(failed.size()));
+    for (auto index : failed) {
+        buffer.writeUint16(index);
+    }
+
+    const uint8_t* data = static_cast<const uint8_t*>(buffer.getData());
+    return (std::vector<uint8_t>(data, data + buffer.getLength()));
+}
+
+uint32_t
+LeaseUpdateCodec::decodeAck(const uint8_t* data, size_t length,
+                            std::vector<uint16_t>& failed) {
+    failed.clear();
+    InputBuffer buffer(data, length);
+    uint32_t sequence = 0;
+    try {
+        uint16_t count = readHeader(buffer, ACK, sequence);
+        failed.reserve(count);
+        for (uint16_t i = 0; i < count; ++i) {
+            failed.push_back(buffer.readUint16());
+        }
+    } catch (const InvalidBufferPosition&) {
+        isc_throw(BadValue, "truncated lease update acknowledgment");
+    }
+    if (buffer.getPosition() != buffer.getLength()) {
+        isc_throw(BadValue, "trailing " << (buffer.getLength() - buffer.getPosition())
+                  << " bytes in lease update acknowledgment");
+    }
+    return (sequence);
+}
+
+LeaseUpdateCodec::Kind
+LeaseUpdateCodec::getKind(const uint8_t* data, size_t length) {
+    if (!data || (length == 0)) {
+        isc_throw(BadValue, "empty lease update message");
+    }
+    switch (data[0]) {
+    case UPDATE:
+        return (UPDATE);
+    case ACK:
+        return (ACK);
+    default:
+        isc_throw(BadValue, "unknown lease update message kind "
+                  << static_cast<unsigned>(data[0]));
+    }
+}
+
+void
+LeaseUpdateCodec::encodeUpdate(const Update& update, OutputBuffer& buffer) {
+    const LeasePtr& lease = update.second;
+    if (!lease) {
+        isc_throw(BadValue, "null lease in lease update");
+    }
+    Lease::Type type = lease->getType();
+
+    buffer.writeUint8(static_cast<uint8_t>(update.first));
+    buffer.writeUint8(static_cast<uint8_t>(type));
+    std::vector<uint8_t> addr = lease->addr_.toBytes();
+    buffer.writeData(addr.data(), addr.size());
+    buffer.writeUint32(lease->valid_lft_);
+    buffer.writeUint64(static_cast<uint64_t>(lease->cltt_));
+    buffer.writeUint32(lease->subnet_id_);
+    buffer.writeUint8((lease->fqdn_fwd_ ? FQDN_FWD_FLAG : 0) |
+                      (lease->fqdn_rev_ ? FQDN_REV_FLAG : 0));
+    buffer.writeUint32(lease->state_);
+    writeString16(lease->hostname_, buffer, "hostname");
+    if (lease->hwaddr_) {
+        buffer.writeUint16(lease->hwaddr_->htype_);
+        writeData8(lease->hwaddr_->hwaddr_, buffer, "hardware address");
+    } else {
+        buffer.writeUint16(0);
+        buffer.writeUint8(0);
+    }
+    ConstElementPtr ctx = lease->getContext();
+    writeString16(ctx ? ctx->str() : std::string(), buffer, "user context");
+
+    if (type == Lease::TYPE_V4) {
+        Lease4Ptr lease4 = boost::dynamic_pointer_cast<Lease4>(lease);
+        if (lease4 && lease4->client_id_) {
+            writeData8(lease4->client_id_->getClientId(), buffer,
+                       "client identifier");
+        } else {
+            buffer.writeUint8(0);
+        }
+
+    } else {
+        Lease6Ptr lease6 = boost::dynamic_pointer_cast<Lease6>(lease);
+        if (!lease6) {
+            isc_throw(BadValue, "lease " << lease->addr_ << " of type "
+                      << Lease::typeToText(type) << " is not an IPv6 lease");
+        }
+        buffer.writeUint8(lease6->prefixlen_);
+        buffer.writeUint32(lease6->iaid_);
+        buffer.writeUint32(lease6->preferred_lft_);
+        if (lease6->duid_) {
+            writeData8(lease6->duid_->getDuid(), buffer, "DUID");
+        } else {
+            buffer.writeUint8(0);
+        }
+    }
+}
+
+LeaseUpdateCodec::Update
+LeaseUpdateCodec::decodeUpdate(InputBuffer& buffer) {
+    uint8_t op_type = buffer.readUint8();
+    if ((op_type != LeaseUpdateBacklog::ADD) &&
+        (op_type != LeaseUpdateBacklog::DELETE)) {
+        isc_throw(BadValue, "unknown lease update operation type "
+                  << static_cast<unsigned>(op_type));
+    }
+    uint8_t type = buffer.readUint8();
+
+    LeasePtr lease;
+    uint8_t addr[V6ADDRESS_LEN];
+    if (type == Lease::TYPE_V4) {
+        buffer.readData(addr, V4ADDRESS_LEN);
+        lease.reset(new Lease4());
+        lease->addr_ = IOAddress::fromBytes(AF_INET, addr);
+
+    } else if ((type == Lease::TYPE_NA) || (type == Lease::TYPE_TA) ||
+               (type == Lease::TYPE_PD)) {
+        buffer.readData(addr, V6ADDRESS_LEN);
+        Lease6Ptr lease6(new Lease6());
+        lease6->type_ = static_cast<Lease::Type>(type);
+        lease = lease6;
+        lease->addr_ = IOAddress::fromBytes(AF_INET6, addr);
+
+    } else {
+        isc_throw(BadValue, "unknown lease type " << static_cast<unsigned>(type));
+    }
+
+    lease->valid_lft_ = buffer.readUint32();
+    lease->current_valid_lft_ = lease->valid_lft_;
+    uint64_t cltt = static_cast<uint64_t>(buffer.readUint32()) << 32;
+    cltt |= buffer.readUint32();
+    lease->cltt_ = static_cast<time_t>(cltt);
+    lease->current_cltt_ = lease->cltt_;
+    lease->subnet_id_ = buffer.readUint32();
+    uint8_t fqdn_flags = buffer.readUint8();
+    lease->fqdn_fwd_ = ((fqdn_flags & FQDN_FWD_FLAG) != 0);
+    lease->fqdn_rev_ = ((fqdn_flags & FQDN_REV_FLAG) != 0);
+    lease->state_ = buffer.readUint32();
+    lease->hostname_ = readString16(buffer);
+    uint16_t htype = buffer.readUint16();
+    std::vector<uint8_t> hwaddr = readData8(buffer);
+    if (!hwaddr.empty()) {
+        lease->hwaddr_.reset(new HWAddr(hwaddr, htype));
+    }
+    std::string ctx = readString16(buffer);
+    if (!ctx.empty()) {
+        try {
+            lease->setContext(Element::fromJSON(ctx));
+        } catch (const std::exception& ex) {
+            isc_throw(BadValue, "invalid user context of lease "
+                      << lease->addr_ << ": " << ex.what());
+        }
+    }
+
+    if (type == Lease::TYPE_V4) {
+        std::vector<uint8_t> client_id = readData8(buffer);
+        if (!client_id.empty()) {
+            boost::dynamic_pointer_cast<Lease4>(lease)->client_id_.reset(new ClientId(client_id));
+        }
+
+    } else {
+        Lease6Ptr lease6 = boost::dynamic_pointer_cast<Lease6>(lease);
+        lease6->prefixlen_ = buffer.readUint8();
+        lease6->iaid_ = buffer.readUint32();
+        lease6->preferred_lft_ = buffer.readUint32();
+        std::vector<uint8_t> duid = readData8(buffer);
+        if (!duid.empty()) {
+            lease6->duid_.reset(new DUID(duid));
+        }
+    }
+
+    return (std::make_pair(static_cast<LeaseUpdateBacklog::OpType>(op_type), lease));
+}
+
+} // end of namespace isc::ha
+} // end of namespace isc
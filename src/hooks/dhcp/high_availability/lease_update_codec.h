@@ -0,0 +1,145 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef HA_LEASE_UPDATE_CODEC_H
+#define HA_LEASE_UPDATE_CODEC_H
+
+#include <lease_update_backlog.h>
+#include <dhcpsrv/lease.h>
+#include <util/buffer.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace isc {
+namespace ha {
+
+/// @brief Compact binary encoding of the lease updates sent to the partner.
+///
+/// The lease updates are normally carried by the lease commands in JSON
+/// over HTTP. Building and parsing the JSON and the HTTP framing costs
+/// more than the lease allocation on a busy server. This codec provides
+/// a binary alternative carried in the length-prefixed messages of
+/// @c isc::tcp::TcpStreamRequest and @c isc::tcp::TcpStreamResponse,
+/// i.e. the encoded message must not be larger than @c MAX_MESSAGE_SIZE.
+///
+/// There are two kinds of messages:
+/// - an update message carrying a sequence number and a list of
+///   "Add" and "Delete" lease updates, IPv4 and IPv6 leases can be mixed,
+/// - an acknowledgment carrying the sequence number of the acknowledged
+///   update message and the indexes of the updates which failed.
+///
+/// Because the acknowledgments carry the sequence number the sender does
+/// not have to wait for an acknowledgment before sending the next update
+/// message, i.e. the acknowledgments can be pipelined.
+///
+/// All integers are in network order. The update message is:
+/// - kind (1 byte, @c UPDATE), sequence number (4 bytes), number of
+///   updates (2 bytes),
+/// - for each update: operation type (1 byte), lease type (1 byte),
+///   address (4 or 16 bytes), valid lifetime (4 bytes), cltt (8 bytes),
+///   subnet identifier (4 bytes), FQDN flags (1 byte), state (4 bytes),
+///   hostname (2 bytes length and data), hardware type (2 bytes) and
+///   hardware address (1 byte length and data), user context in JSON
+///   (2 bytes length and data),
+/// - for IPv4 leases: client identifier (1 byte length and data),
+/// - for IPv6 leases: prefix length (1 byte), IAID (4 bytes), preferred
+///   lifetime (4 bytes), DUID (1 byte length and data).
+///
+/// The acknowledgment is: kind (1 byte, @c ACK), sequence number (4 bytes),
+/// number of failed updates (2 bytes) and their indexes (2 bytes each).
+class LeaseUpdateCodec {
+public:
+
+    /// @brief Kind of a message.
+    enum Kind : uint8_t {
+        UPDATE = 1,
+        ACK = 2
+    };
+
+    /// @brief A lease update: the operation type and the lease.
+    typedef std::pair<LeaseUpdateBacklog::OpType, dhcp::LeasePtr> Update;
+
+    /// @brief A list of lease updates.
+    typedef std::vector<Update> Updates;
+
+    /// @brief Maximum size of an encoded message.
+    static const size_t MAX_MESSAGE_SIZE = 65535;
+
+    /// @brief Encodes an update message.
+    ///
+    /// The updates are encoded in order until the next one would make the
+    /// message larger than @c MAX_MESSAGE_SIZE. The caller sends the
+    /// remaining updates in the next messages.
+    ///
+    /// @param sequence sequence number of the message.
+    /// @param updates lease updates to encode.
+    /// @param first index of the first update to encode.
+    /// @param [out] encoded number of updates encoded in the message.
+    /// @return encoded message.
+    /// @throw BadValue if an update has no lease or the first update to
+    /// encode does not fit in a message.
+    static std::vector<uint8_t> encodeUpdates(uint32_t sequence,
+                                              const Updates& updates,
+                                              size_t first,
+                                              size_t& encoded);
+
+    /// @brief Decodes an update message.
+    ///
+    /// @param data pointer to the message.
+    /// @param length length of the message.
+    /// @param [out] updates decoded lease updates.
+    /// @return sequence number of the message.
+    /// @throw BadValue if the message is malformed.
+    static uint32_t decodeUpdates(const uint8_t* data, size_t length,
+                                  Updates& updates);
+
+    /// @brief Encodes an acknowledgment.
+    ///
+    /// @param sequence sequence number of the acknowledged message.
+    /// @param failed indexes of the updates which failed.
+    /// @return encoded acknowledgment.
+    /// @throw BadValue if there are too many failed updates.
+    static std::vector<uint8_t> encodeAck(uint32_t sequence,
+                                          const std::vector<uint16_t>& failed);
+
+    /// @brief Decodes an acknowledgment.
+    ///
+    /// @param data pointer to the acknowledgment.
+    /// @param length length of the acknowledgment.
+    /// @param [out] failed indexes of the updates which failed.
+    /// @return sequence number of the acknowledged message.
+    /// @throw BadValue if the acknowledgment is malformed.
+    static uint32_t decodeAck(const uint8_t* data, size_t length,
+                              std::vector<uint16_t>& failed);
+
+    /// @brief Returns the kind of a message.
+    ///
+    /// @param data pointer to the message.
+    /// @param length length of the message.
+    /// @return kind of the message.
+    /// @throw BadValue if the message is empty or of an unknown kind.
+    static Kind getKind(const uint8_t* data, size_t length);
+
+private:
+
+    /// @brief Encodes a lease update.
+    ///
+    /// @param update lease update to encode.
+    /// @param [out] buffer buffer to which the update is appended.
+    static void encodeUpdate(const Update& update, util::OutputBuffer& buffer);
+
+    /// @brief Decodes a lease update.
+    ///
+    /// @param buffer buffer from which the update is read.
+    /// @return decoded lease update.
+    static Update decodeUpdate(util::InputBuffer& buffer);
+};
+
+} // end of namespace isc::ha
+} // end of namespace isc
+
+#endif // HA_LEASE_UPDATE_CODEC_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -119,7 +119,8 @@ namespace isc {
 namespace ha {
 
 QueryFilter::QueryFilter(const HAConfigPtr& config)
-    : config_(config), peers_(), scopes_(), active_servers_(0),
+    : config_(config), peers_(), scopes_(), scope_classes_(),
+      served_scopes_(), active_servers_(0), bucket_owners_(),
       mutex_(new std::mutex) {
 
     // Make sure that the configuration is valid. We make certain
@@ -161,6 +162,19 @@ QueryFilter::QueryFilter(const HAConfigPtr& config)
         peers_.insert(peers_.end(), backup_peers.begin(), backup_peers.end());
     }
 
+    served_scopes_.reset(new std::atomic<bool>[peers_.size()]);
+    for (size_t i = 0; i < peers_.size(); ++i) {
+        scope_classes_.push_back(makeScopeClass(peers_[i]->getName()));
+        served_scopes_[i] = false;
+    }
+
+    // Spread the hash buckets across the active servers. They are at the
+    // beginning of the peers_ vector.
+    for (size_t bucket = 0; bucket < bucket_owners_.size(); ++bucket) {
+        bucket_owners_[bucket] = (active_servers_ > 0 ?
+                                  static_cast<uint8_t>(bucket % active_servers_) : 0);
+    }
+
     // The query filter is initially setup to serve default scopes, i.e. for the
     // load balancing case the primary and secondary are responsible for their
     // own scopes. The backup servers are not responding to any queries. In the
@@ -174,8 +188,10 @@ QueryFilter::serveScope(const std::string& scope_name) {
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
         serveScopeInternal(scope_name);
+        updateServedScopesInternal();
     } else {
         serveScopeInternal(scope_name);
+        updateServedScopesInternal();
     }
 }
 
@@ -190,8 +206,10 @@ QueryFilter::serveScopeOnly(const std::string& scope_name) {
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
         serveScopeOnlyInternal(scope_name);
+        updateServedScopesInternal();
     } else {
         serveScopeOnlyInternal(scope_name);
+        updateServedScopesInternal();
     }
 }
 
@@ -207,8 +225,10 @@ QueryFilter::serveScopes(const std::vector<std::string>& scopes) {
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
         serveScopesInternal(scopes);
+        updateServedScopesInternal();
     } else {
         serveScopesInternal(scopes);
+        updateServedScopesInternal();
     }
 }
 
@@ -236,8 +256,10 @@ QueryFilter::serveDefaultScopes() {
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
         serveDefaultScopesInternal();
+        updateServedScopesInternal();
     } else {
         serveDefaultScopesInternal();
+        updateServedScopesInternal();
     }
 }
 
@@ -263,8 +285,10 @@ QueryFilter::serveFailoverScopes() {
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
         serveFailoverScopesInternal();
+        updateServedScopesInternal();
     } else {
         serveFailoverScopesInternal();
+        updateServedScopesInternal();
     }
 }
 
@@ -294,8 +318,10 @@ QueryFilter::serveNoScopes() {
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
         serveNoScopesInternal();
+        updateServedScopesInternal();
     } else {
         serveNoScopesInternal();
+        updateServedScopesInternal();
     }
 }
 
@@ -309,6 +335,13 @@ QueryFilter::serveNoScopesInternal() {
     }
 }
 
+void
+QueryFilter::updateServedScopesInternal() {
+    for (size_t i = 0; i < peers_.size(); ++i) {
+        served_scopes_[i] = amServingScopeInternal(peers_[i]->getName());
+    }
+}
+
 bool
 QueryFilter::amServingScope(const std::string& scope_name) const {
     if (MultiThreadingMgr::instance().getMode()) {
@@ -361,22 +394,27 @@ QueryFilter::isHaType(const dhcp::Pkt6Ptr& query) {
 
 bool
 QueryFilter::inScope(const dhcp::Pkt4Ptr& query4, std::string& scope_class) const {
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
-        return (inScopeInternal(query4, scope_class));
-    } else {
-        return (inScopeInternal(query4, scope_class));
-    }
+    return (inScopeInternal(query4, scope_class));
 }
 
 bool
 QueryFilter::inScope(const dhcp::Pkt6Ptr& query6, std::string& scope_class) const {
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
-        return (inScopeInternal(query6, scope_class));
-    } else {
-        return (inScopeInternal(query6, scope_class));
+    return (inScopeInternal(query6, scope_class));
+}
+
+std::vector<uint8_t>
+QueryFilter::getScopeBuckets(const std::string& scope_name) const {
+    validateScopeName(scope_name);
+    std::vector<uint8_t> buckets;
+    if (config_->getHAMode() != HAConfig::LOAD_BALANCING) {
+        return (buckets);
+    }
+    for (size_t bucket = 0; bucket < bucket_owners_.size(); ++bucket) {
+        if (peers_[bucket_owners_[bucket]]->getName() == scope_name) {
+            buckets.push_back(static_cast<uint8_t>(bucket));
+        }
     }
+    return (buckets);
 }
 
 template<typename QueryPtrType>
@@ -390,8 +428,7 @@ QueryFilter::inScopeInternal(const QueryPtrType& query,
 
     // If it's not a type HA cares about, it's in scope for this peer.
     if (!isHaType(query)) {
-        auto scope = peers_[0]->getName();
-        scope_class = makeScopeClass(scope);
+        scope_class = scope_classes_[0];
         return (true);
     }
 
@@ -408,9 +445,8 @@ QueryFilter::inScopeInternal(const QueryPtrType& query,
         }
     }
 
-    auto scope = peers_[candidate_server]->getName();
-    scope_class = makeScopeClass(scope);
-    return ((candidate_server >= 0) && amServingScopeInternal(scope));
+    scope_class = scope_classes_[candidate_server];
+    return (served_scopes_[candidate_server]);
 }
 
 int
@@ -440,9 +476,8 @@ QueryFilter::loadBalance(const dhcp::Pkt4Ptr& query4) const {
         }
     }
 
-    // The hash value modulo number of active servers gives an index
-    // of the server to process the packet.
-    return (active_servers_ > 0 ? static_cast<int>(lb_hash % active_servers_) : -1);
+    // The owner of the hash bucket is the server to process the packet.
+    return (active_servers_ > 0 ? static_cast<int>(bucket_owners_[lb_hash]) : -1);
 }
 
 int
@@ -463,9 +498,8 @@ QueryFilter::loadBalance(const dhcp::Pkt6Ptr& query6) const {
         return (-1);
     }
 
-    // The hash value modulo number of active servers gives an index
-    // of the server to process the packet.
-    return (active_servers_ > 0 ? static_cast<int>(lb_hash % active_servers_) : -1);
+    // The owner of the hash bucket is the server to process the packet.
+    return (active_servers_ > 0 ? static_cast<int>(bucket_owners_[lb_hash]) : -1);
 }
 
 uint8_t
@@ -11,8 +11,11 @@
 #include <dhcp/pkt4.h>
 #include <dhcp/pkt6.h>
 
+#include <boost/scoped_array.hpp>
 #include <boost/scoped_ptr.hpp>
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <map>
 #include <mutex>
@@ -35,6 +38,12 @@ namespace ha {
 /// scopes named after servers responsible for processing packets belonging
 /// to those scopes, e.g. "server1" and "server2".
 ///
+/// The load balancing hash of a query selects one of 256 hash buckets and
+/// each bucket is owned by one of the active servers. The buckets are
+/// spread evenly across the active servers in the constructor, so the
+/// scope of a server is the set of buckets it owns. Enabling the scope of
+/// a failed server moves only the buckets of this server.
+///
 /// In the hot-standby mode, there is only one server processing incoming
 /// DHCP queries. Thus, there is only one scope named after the primary
 /// server, e.g. "server1".
@@ -156,6 +165,9 @@ public:
     /// in subnets, pools and network configurations to associate them with
     /// different servers.
     ///
+    /// This method does not take the mutex: it is called for every received
+    /// query and it only reads the served scopes flags which are atomic.
+    ///
     /// @return true if the specified query should be processed by this
     /// server, false otherwise.
     bool inScope(const dhcp::Pkt4Ptr& query4, std::string& scope_class) const;
@@ -180,10 +192,22 @@ public:
     /// in subnets, pools and network configurations to associate them with
     /// different servers.
     ///
+    /// This method does not take the mutex: it is called for every received
+    /// query and it only reads the served scopes flags which are atomic.
+    ///
     /// @return true if the specified query should be processed by this
     /// server, false otherwise.
     bool inScope(const dhcp::Pkt6Ptr& query6, std::string& scope_class) const;
 
+    /// @brief Returns the hash buckets owned by a scope.
+    ///
+    /// @param scope_name name of the scope/server.
+    /// @return Sorted list of the load balancing hash buckets owned by the
+    /// scope. It is empty in the hot-standby mode and for the servers not
+    /// responding to DHCP queries by default.
+    /// @throw BadValue if scope name doesn't match any of the server names.
+    std::vector<uint8_t> getScopeBuckets(const std::string& scope_name) const;
+
     /// @brief Determines if a DHCPv4 query is a message type HA should process.
     ///
     /// @param query4 DHCPv4 packet to test. Must not be null.
@@ -273,7 +297,9 @@ private:
     /// @brief Generic implementation of the @c inScope function for DHCPv4
     /// and DHCPv6 queries.
     ///
-    /// Should be called in a thread safe context.
+    /// It only reads the configuration, which does not change, and the
+    /// served scopes flags, which are atomic, so it may be called without
+    /// taking the mutex.
     ///
     /// @tparam QueryPtrType type of the query, i.e. DHCPv4 or DHCPv6 query.
     /// @param query pointer to the DHCP query instance.
@@ -293,9 +319,7 @@ protected:
     ///
     /// This method returns an index of the server configuration
     /// held within @c peers_ vector. This points to a server
-    /// which should process the given query. Currently, we only
-    /// support load balancing between two servers, therefore this
-    /// value should be 0 or 1.
+    /// which owns the hash bucket of the given query.
     ///
     /// @param query4 pointer to the DHCPv4 query instance.
     /// @return Index of the server which should process the query. It
@@ -307,9 +331,7 @@ protected:
     ///
     /// This method returns an index of the server configuration
     /// held within @c peers_ vector. This points to a server
-    /// which should process the given query. Currently, we only
-    /// support load balancing between two servers, therefore this
-    /// value should be 0 or 1.
+    /// which owns the hash bucket of the given query.
     ///
     /// @param query6 pointer to the DHCPv6 query instance.
     /// @return Index of the server which should process the query. It
@@ -329,6 +351,14 @@ protected:
     /// @return Computed hash value.
     uint8_t loadBalanceHash(const uint8_t* key, const size_t key_len) const;
 
+    /// @brief Copies the enabled scopes into the served scopes flags.
+    ///
+    /// It is called at the end of each change of the enabled scopes so the
+    /// flags never reflect the intermediate steps of the change.
+    ///
+    /// Should be called in a thread safe context.
+    void updateServedScopesInternal();
+
     /// @brief Checks if the scope name matches a name of any of the
     /// configured servers.
     ///
@@ -362,9 +392,23 @@ protected:
     /// if the scopes are enabled or disabled.
     std::map<std::string, bool> scopes_;
 
+    /// @brief Scope class names of the peers in the @c peers_ order.
+    std::vector<std::string> scope_classes_;
+
+    /// @brief Flags indicating if the scopes of the peers are enabled
+    /// in the @c peers_ order.
+    ///
+    /// They follow the @c scopes_ so the queries are checked without
+    /// taking the mutex.
+    boost::scoped_array<std::atomic<bool> > served_scopes_;
+
     /// @brief Number of the active servers in the given HA mode.
     int active_servers_;
 
+    /// @brief Indexes in the @c peers_ of the owners of the load
+    /// balancing hash buckets.
+    std::array<uint8_t, 256> bucket_owners_;
+
     /// @brief Mutex to protect the internal state.
     boost::scoped_ptr<std::mutex> mutex_;
 };
@@ -77,6 +77,10 @@ public:
     /// @brief Test that heartbeat function is triggered.
     void heartbeatTest();
 
+    /// @brief Verifies that the phi accrual failure detector deems the
+    /// communication interrupted before the max-response-delay.
+    void phiAccrualTest();
+
     /// @brief Test that invalid values provided to startHeartbeat are rejected.
     void startHeartbeatInvalidValuesTest();
 
@@ -276,6 +280,37 @@ CommunicationStateTest::pokeTest() {
     EXPECT_FALSE(state_.isCommunicationInterrupted());
 }
 
+// Verifies that the phi accrual failure detector deems the communication
+// interrupted before the max-response-delay.
+void
+CommunicationStateTest::phiAccrualTest() {
+    state_.config_->setHeartbeatDelay(1000);
+    state_.config_->setPhiAccrualThreshold(8);
+
+    // There are no intervals recorded yet.
+    EXPECT_EQ(0, state_.getPhi());
+
+    // Simulate regular heartbeats every second.
+    for (auto i = 0; i < 5; ++i) {
+        state_.modifyPokeTime(-1);
+        state_.poke();
+    }
+    EXPECT_LT(state_.getPhi(), 1);
+    EXPECT_FALSE(state_.isCommunicationInterrupted());
+
+    // Three seconds without response are very unlikely but the
+    // communication is only deemed interrupted when the heartbeat fails.
+    state_.modifyPokeTime(-3);
+    EXPECT_GE(state_.getPhi(), 8);
+    EXPECT_FALSE(state_.isCommunicationInterrupted());
+    state_.setPartnerUnavailable();
+    EXPECT_TRUE(state_.isCommunicationInterrupted());
+
+    // Disabling the detector reverts to the max-response-delay.
+    state_.config_->setPhiAccrualThreshold(0);
+    EXPECT_FALSE(state_.isCommunicationInterrupted());
+}
+
 // Test that heartbeat function is triggered.
 void
 CommunicationStateTest::heartbeatTest() {
@@ -1005,6 +1040,15 @@ TEST_F(CommunicationStateTest, pokeTestMultiThreading) {
     pokeTest();
 }
 
+TEST_F(CommunicationStateTest, phiAccrualTest) {
+    phiAccrualTest();
+}
+
+TEST_F(CommunicationStateTest, phiAccrualTestMultiThreading) {
+    MultiThreadingMgr::instance().setMode(true);
+    phiAccrualTest();
+}
+
 TEST_F(CommunicationStateTest, heartbeatTest) {
     heartbeatTest();
 }
@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -74,8 +74,11 @@ TEST_F(HAConfigTest, configureLoadBalancing) {
         "        \"sync-timeout\": 20000,"
         "        \"sync-page-limit\": 3,"
         "        \"delayed-updates-limit\": 111,"
+        "        \"delayed-updates-memory-limit\": 1000000,"
+        "        \"lease-updates-batch-window\": 7,"
         "        \"heartbeat-delay\": 8,"
         "        \"max-response-delay\": 11,"
+        "        \"phi-accrual-threshold\": 8,"
         "        \"max-ack-delay\": 5,"
         "        \"max-unacked-clients\": 20,"
         "        \"max-rejected-lease-updates\": 9,"
@@ -131,9 +134,12 @@ TEST_F(HAConfigTest, configureLoadBalancing) {
     EXPECT_EQ(20000, impl->getConfig()->getSyncTimeout());
     EXPECT_EQ(3, impl->getConfig()->getSyncPageLimit());
     EXPECT_EQ(111, impl->getConfig()->getDelayedUpdatesLimit());
+    EXPECT_EQ(1000000, impl->getConfig()->getDelayedUpdatesMemoryLimit());
     EXPECT_TRUE(impl->getConfig()->amAllowingCommRecovery());
+    EXPECT_EQ(7, impl->getConfig()->getLeaseUpdatesBatchWindow());
     EXPECT_EQ(8, impl->getConfig()->getHeartbeatDelay());
     EXPECT_EQ(11, impl->getConfig()->getMaxResponseDelay());
+    EXPECT_EQ(8, impl->getConfig()->getPhiAccrualThreshold());
     EXPECT_EQ(5, impl->getConfig()->getMaxAckDelay());
     EXPECT_EQ(20, impl->getConfig()->getMaxUnackedClients());
     EXPECT_EQ(9, impl->getConfig()->getMaxRejectedLeaseUpdates());
@@ -216,6 +222,7 @@ TEST_F(HAConfigTest, configureLoadBalancing) {
     EXPECT_TRUE(impl->getConfig()->getHttpDedicatedListener());
     EXPECT_EQ(hardware_threads_, impl->getConfig()->getHttpListenerThreads());
     EXPECT_EQ(hardware_threads_, impl->getConfig()->getHttpClientThreads());
+    EXPECT_FALSE(impl->getConfig()->getHttpClientPerPeer());
 }
 
 // Verifies that hot standby configuration is parsed correctly.
@@ -258,8 +265,11 @@ TEST_F(HAConfigTest, configureHotStandby) {
     EXPECT_EQ(60000, impl->getConfig()->getSyncTimeout());
     EXPECT_EQ(10000, impl->getConfig()->getSyncPageLimit());
     EXPECT_EQ(0, impl->getConfig()->getDelayedUpdatesLimit());
+    EXPECT_EQ(0, impl->getConfig()->getDelayedUpdatesMemoryLimit());
     EXPECT_FALSE(impl->getConfig()->amAllowingCommRecovery());
+    EXPECT_EQ(0, impl->getConfig()->getLeaseUpdatesBatchWindow());
     EXPECT_EQ(10000, impl->getConfig()->getHeartbeatDelay());
+    EXPECT_EQ(0, impl->getConfig()->getPhiAccrualThreshold());
     EXPECT_EQ(10000, impl->getConfig()->getMaxAckDelay());
     EXPECT_EQ(10, impl->getConfig()->getMaxUnackedClients());
     EXPECT_EQ(10, impl->getConfig()->getMaxRejectedLeaseUpdates());
@@ -534,6 +544,33 @@ TEST_F(HAConfigTest, largeHeartbeatDelay) {
         "'heartbeat-delay' must not be greater than 65535");
 }
 
+// Error should be returned when lease-updates-batch-window is too large.
+TEST_F(HAConfigTest, largeLeaseUpdatesBatchWindow) {
+    testInvalidConfig(
+        "["
+        "    {"
+        "        \"this-server-name\": \"server1\","
+        "        \"mode\": \"load-balancing\","
+        "        \"lease-updates-batch-window\": 65536,"
+        "        \"peers\": ["
+        "            {"
+        "                \"name\": \"server1\","
+        "                \"url\": \"http://127.0.0.1:8080/\","
+        "                \"role\": \"primary\","
+        "                \"auto-failover\": false"
+        "            },"
+        "            {"
+        "                \"name\": \"server2\","
+        "                \"url\": \"http://127.0.0.1:8080/\","
+        "                \"role\": \"secondary\","
+        "                \"auto-failover\": true"
+        "            }"
+        "        ]"
+        "    }"
+        "]",
+        "'lease-updates-batch-window' must not be greater than 65535");
+}
+
 // There must be at least two servers provided.
 TEST_F(HAConfigTest, singlePeer) {
     testInvalidConfig(
@@ -1876,4 +1913,45 @@ TEST_F(HAConfigTest, ipv6Url) {
     EXPECT_EQ(impl->getConfig()->getThisServerConfig()->getUrl().toText(), "http://[2001:db8::1]:8080/");
 }
 
+// Check that an HTTP client per peer can be configured.
+TEST_F(HAConfigTest, httpClientPerPeer) {
+    std::string const ha_config(R"(
+        [
+            {
+                "mode": "hot-standby",
+                "multi-threading": {
+                    "enable-multi-threading": true,
+                    "http-client-per-peer": true
+                },
+                "peers": [
+                    {
+                        "name": "server1",
+                        "role": "primary",
+                        "url": "http://127.0.0.1:8080/"
+                    },
+                    {
+                        "name": "server2",
+                        "role": "standby",
+                        "url": "http://127.0.0.1:8081/"
+                    },
+                    {
+                        "name": "server3",
+                        "role": "backup",
+                        "url": "http://127.0.0.1:8082/"
+                    }
+                ],
+                "this-server-name": "server1"
+            }
+        ]
+    )");
+
+    // Configure HA.
+    setDHCPMultiThreadingConfig(true, 4);
+    HAImplPtr impl(new HAImpl());
+    ASSERT_NO_THROW_LOG(impl->configure(Element::fromJSON(ha_config)));
+
+    EXPECT_TRUE(impl->getConfig()->getEnableMultiThreading());
+    EXPECT_TRUE(impl->getConfig()->getHttpClientPerPeer());
+}
+
 }  // namespace
@@ -45,6 +45,7 @@
 #include <boost/shared_ptr.hpp>
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <functional>
 #include <sstream>
 #include <set>
@@ -210,6 +211,9 @@ public:
     using HAService::query_filter_;
     using HAService::lease_update_backlog_;
     using HAService::client_;
+    using HAService::peer_clients_;
+    using HAService::getClient;
+    using HAService::getLeaseUpdateQueuesReport;
     using HAService::listener_;
 };
 
@@ -1155,6 +1159,19 @@ public:
         // Let's make sure they have been queued.
         EXPECT_EQ(2, service_->lease_update_backlog_.size());
 
+        // The queued updates are reported in the status.
+        ConstElementPtr ha_servers = service_->processStatusGet();
+        ASSERT_TRUE(ha_servers);
+        ASSERT_TRUE(ha_servers->get("local"));
+        ConstElementPtr backlog = ha_servers->get("local")->get("lease-update-backlog");
+        ASSERT_TRUE(backlog);
+        ASSERT_TRUE(backlog->get("size"));
+        EXPECT_EQ(2, backlog->get("size")->intValue());
+        ASSERT_TRUE(backlog->get("memory"));
+        EXPECT_EQ(service_->lease_update_backlog_.getMemoryUsage(),
+                  backlog->get("memory")->intValue());
+        EXPECT_TRUE(backlog->get("age"));
+
         // Make partner available.
         service_->communication_state_->poke();
         service_->communication_state_->setPartnerState("load-balancing");
@@ -2492,6 +2509,164 @@ TEST_F(HAServiceTest, sendUpdatesControlResultConflictMultiThreading) {
     testSendUpdatesControlResultConflict();
 }
 
+// Test scenario when the DHCPv4 lease updates of two queries are batched
+// in a single lease4-bulk-apply command.
+TEST_F(HAServiceTest, sendBatchedUpdatesMultiThreading) {
+    MultiThreadingMgr::instance().setMode(true);
+
+    // Start HTTP servers.
+    ASSERT_NO_THROW({
+            listener_->start();
+            listener2_->start();
+            listener3_->start();
+    });
+
+    // The window is large so both queries are in the same batch.
+    HAConfigPtr config_storage = createValidConfiguration();
+    config_storage->setEnableMultiThreading(true);
+    config_storage->setHttpClientThreads(2);
+    config_storage->setLeaseUpdatesBatchWindow(500);
+    setBasicAuth(config_storage);
+
+    ASSERT_NO_THROW_LOG(service_.reset(new TestHAService(io_service_, network_state_,
+                                                         config_storage)));
+    ASSERT_TRUE(service_->client_->getThreadIOService());
+    ASSERT_NO_THROW_LOG(service_->startClientAndListener());
+    service_->transition(HA_LOAD_BALANCING_ST, HAService::NOP_EVT);
+
+    ParkingLotPtr parking_lot(new ParkingLot());
+    ParkingLotHandlePtr parking_lot_handle(new ParkingLotHandle(parking_lot));
+    std::atomic<int> unparked(0);
+
+    HWAddrPtr hwaddr(new HWAddr(std::vector<uint8_t>(6, 1), HTYPE_ETHER));
+    std::vector<Pkt4Ptr> queries;
+    for (uint8_t i = 0; i < 2; ++i) {
+        Pkt4Ptr query(new Pkt4(DHCPREQUEST, 1234 + i));
+        queries.push_back(query);
+
+        Lease4CollectionPtr leases4(new Lease4Collection());
+        Lease4Ptr lease4(new Lease4(IOAddress(0xc0010203 + i), hwaddr,
+                                    static_cast<const uint8_t*>(0), 0,
+                                    60, 0, 1));
+        leases4->push_back(lease4);
+        Lease4CollectionPtr deleted_leases4(new Lease4Collection());
+
+        // The backup server acknowledgment is not expected.
+        EXPECT_EQ(1, service_->asyncSendLeaseUpdates(query, leases4, deleted_leases4,
+                                                     parking_lot_handle));
+        EXPECT_EQ(1, service_->getPendingRequest(query));
+
+        ASSERT_NO_THROW(parking_lot->park(query, [&unparked] { ++unparked; }));
+        ASSERT_NO_THROW(parking_lot->reference(query));
+    }
+
+    ASSERT_NO_THROW(runIOService(TEST_TIMEOUT, [this]() {
+        return (service_->pendingRequestSize() == 0);
+    }));
+
+    // Both queries were unparked by the same response.
+    EXPECT_EQ(2, unparked);
+
+    // Each peer received a single command with the leases of both queries.
+    EXPECT_EQ(1, factory2_->getResponseCreator()->getReceivedRequests().size());
+    EXPECT_TRUE(factory2_->getResponseCreator()->findRequest("lease4-bulk-apply",
+                                                             "192.1.2.3",
+                                                             "192.1.2.4"));
+    EXPECT_FALSE(factory2_->getResponseCreator()->findRequest("lease4-update",
+                                                              "192.1.2.3"));
+
+    // The backup server is updated too.
+    ASSERT_NO_THROW(runIOService(TEST_TIMEOUT, [this]() {
+        return (!factory3_->getResponseCreator()->getReceivedRequests().empty());
+    }));
+    EXPECT_TRUE(factory3_->getResponseCreator()->findRequest("lease4-bulk-apply",
+                                                             "192.1.2.3",
+                                                             "192.1.2.4"));
+
+    ASSERT_NO_THROW_LOG(service_->stopClientAndListener());
+}
+
+// Test scenario when each peer has its own HTTP client.
+TEST_F(HAServiceTest, sendUpdatesClientPerPeerMultiThreading) {
+    MultiThreadingMgr::instance().setMode(true);
+
+    // Start HTTP servers.
+    ASSERT_NO_THROW({
+            listener_->start();
+            listener2_->start();
+            listener3_->start();
+    });
+
+    HAConfigPtr config_storage = createValidConfiguration();
+    config_storage->setEnableMultiThreading(true);
+    config_storage->setHttpClientThreads(2);
+    config_storage->setHttpClientPerPeer(true);
+    setBasicAuth(config_storage);
+
+    ASSERT_NO_THROW_LOG(service_.reset(new TestHAService(io_service_, network_state_,
+                                                         config_storage)));
+
+    // The peers have their own clients.
+    ASSERT_EQ(2, service_->peer_clients_.size());
+    auto server2 = config_storage->getPeerConfig("server2");
+    auto server3 = config_storage->getPeerConfig("server3");
+    EXPECT_NE(service_->client_.get(), &service_->getClient(server2));
+    EXPECT_NE(&service_->getClient(server2), &service_->getClient(server3));
+
+    ASSERT_NO_THROW_LOG(service_->startClientAndListener());
+    service_->transition(HA_LOAD_BALANCING_ST, HAService::NOP_EVT);
+
+    // Nothing was sent yet.
+    EXPECT_FALSE(service_->getLeaseUpdateQueuesReport());
+
+    ParkingLotPtr parking_lot(new ParkingLot());
+    ParkingLotHandlePtr parking_lot_handle(new ParkingLotHandle(parking_lot));
+
+    HWAddrPtr hwaddr(new HWAddr(std::vector<uint8_t>(6, 1), HTYPE_ETHER));
+    Pkt4Ptr query(new Pkt4(DHCPREQUEST, 1234));
+    Lease4CollectionPtr leases4(new Lease4Collection());
+    leases4->push_back(Lease4Ptr(new Lease4(IOAddress("192.1.2.3"), hwaddr,
+                                            static_cast<const uint8_t*>(0), 0,
+                                            60, 0, 1)));
+    Lease4CollectionPtr deleted_leases4(new Lease4Collection());
+
+    // The backup server acknowledgment is not expected.
+    EXPECT_EQ(1, service_->asyncSendLeaseUpdates(query, leases4, deleted_leases4,
+                                                 parking_lot_handle));
+    ASSERT_NO_THROW(parking_lot->park(query, [] {}));
+    ASSERT_NO_THROW(parking_lot->reference(query));
+
+    // Wait for the responses of both peers.
+    ASSERT_NO_THROW(runIOService(TEST_TIMEOUT, [this]() {
+        auto report = service_->getLeaseUpdateQueuesReport();
+        return (report && report->get("server2") && report->get("server3") &&
+                (report->get("server2")->get("sent")->intValue() == 1) &&
+                (report->get("server3")->get("sent")->intValue() == 1));
+    }));
+
+    // The counters are reported by peer.
+    ConstElementPtr ha_servers = service_->processStatusGet();
+    ASSERT_TRUE(ha_servers);
+    ASSERT_TRUE(ha_servers->get("local"));
+    auto queues = ha_servers->get("local")->get("lease-update-queues");
+    ASSERT_TRUE(queues);
+    for (auto const& name : { "server2", "server3" }) {
+        SCOPED_TRACE(name);
+        auto queue = queues->get(name);
+        ASSERT_TRUE(queue);
+        EXPECT_EQ(0, queue->get("pending")->intValue());
+        EXPECT_EQ(1, queue->get("sent")->intValue());
+        EXPECT_EQ(0, queue->get("failed")->intValue());
+    }
+
+    EXPECT_TRUE(factory2_->getResponseCreator()->findRequest("lease4-update",
+                                                             "192.1.2.3"));
+    EXPECT_TRUE(factory3_->getResponseCreator()->findRequest("lease4-update",
+                                                             "192.1.2.3"));
+
+    ASSERT_NO_THROW_LOG(service_->stopClientAndListener());
+}
+
 // Test scenario when all lease updates are sent successfully.
 TEST_F(HAServiceTest, sendSuccessfulUpdates6) {
     testSendSuccessfulUpdates6();
@@ -3045,6 +3220,89 @@ TEST_F(HAServiceTest, asyncSyncLeases) {
     }
 }
 
+// This test verifies that the progress of the lease database synchronization
+// is reported.
+TEST_F(HAServiceTest, asyncSyncLeasesProgress) {
+    // Create lease manager.
+    ASSERT_NO_THROW(LeaseMgrFactory::create("universe=4 type=memfile persist=false"));
+
+    // Create IPv4 leases which will be fetched from the other server.
+    ASSERT_NO_THROW(generateTestLeases4());
+
+    // Add a copy of some leases to the local database, the synchronization
+    // must find them on the pages of local leases.
+    for (size_t i = 0; i < leases4_.size(); i += 3) {
+        Lease4Ptr lease_to_add(new Lease4(*leases4_[i]));
+        --lease_to_add->cltt_;
+        LeaseMgrFactory::instance().addLease(lease_to_add);
+    }
+
+    // Create HA configuration.
+    HAConfigPtr config_storage = createValidConfiguration();
+    setBasicAuth(config_storage);
+
+    // Leases are returned in 3-element chunks.
+    createPagedSyncResponses4();
+
+    // Start the servers.
+    ASSERT_NO_THROW({
+        listener_->start();
+        listener2_->start();
+        listener3_->start();
+    });
+
+    TestHAService service(io_service_, network_state_, config_storage);
+    config_storage->setHeartbeatDelay(0);
+
+    // There is no report before the first synchronization.
+    EXPECT_FALSE(service.getSyncProgressReport());
+    ConstElementPtr ha_servers = service.processStatusGet();
+    ASSERT_TRUE(ha_servers);
+    ASSERT_TRUE(ha_servers->get("local"));
+    EXPECT_FALSE(ha_servers->get("local")->get("sync-progress"));
+
+    // Start fetching leases asynchronously.
+    ASSERT_NO_THROW(service.asyncSyncLeases());
+
+    // The synchronization is in progress.
+    ElementPtr report = service.getSyncProgressReport();
+    ASSERT_TRUE(report);
+    ASSERT_TRUE(report->get("in-progress"));
+    EXPECT_TRUE(report->get("in-progress")->boolValue());
+
+    // Run IO service until the synchronization ends.
+    ASSERT_NO_THROW(runIOService(TEST_TIMEOUT, [&service]() {
+        ElementPtr report = service.getSyncProgressReport();
+        return (report && !report->get("in-progress")->boolValue());
+    }));
+
+    report = service.getSyncProgressReport();
+    ASSERT_TRUE(report);
+    EXPECT_FALSE(report->get("in-progress")->boolValue());
+    ASSERT_TRUE(report->get("leases-received"));
+    EXPECT_EQ(leases4_.size(), report->get("leases-received")->intValue());
+    ASSERT_TRUE(report->get("pages-received"));
+    EXPECT_EQ(4, report->get("pages-received")->intValue());
+    EXPECT_TRUE(report->get("duration"));
+    EXPECT_TRUE(report->get("leases-per-second"));
+
+    // The report is included in the status-get response.
+    ha_servers = service.processStatusGet();
+    ASSERT_TRUE(ha_servers);
+    ASSERT_TRUE(ha_servers->get("local"));
+    ConstElementPtr sync_progress = ha_servers->get("local")->get("sync-progress");
+    ASSERT_TRUE(sync_progress);
+    EXPECT_TRUE(sync_progress->equals(*report));
+
+    // All leases are in the database with the partner's cltt.
+    for (size_t i = 0; i < leases4_.size(); ++i) {
+        Lease4Ptr existing_lease = LeaseMgrFactory::instance().getLease4(leases4_[i]->addr_);
+        ASSERT_TRUE(existing_lease) << "lease " << leases4_[i]->addr_.toText()
+                                    << " not in the lease database";
+        EXPECT_EQ(leases4_[i]->cltt_, existing_lease->cltt_);
+    }
+}
+
 // This test verifies that IPv4 leases can be fetched from the peer and inserted
 // or updated in the local lease database.
 TEST_F(HAServiceTest, asyncSyncLeasesAuthorized) {
@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -88,4 +88,112 @@ TEST(LeaseUpdateBacklogTest, clear) {
     EXPECT_EQ(0, backlog.size());
 }
 
+// This test verifies that an update for a lease already in the queue
+// replaces the queued update.
+TEST(LeaseUpdateBacklogTest, replace) {
+    LeaseUpdateBacklog backlog(3);
+
+    // Add lease updates for 3 different addresses.
+    std::vector<Lease4Ptr> leases;
+    for (auto i = 0; i < 3; ++i) {
+        IOAddress address(i + 1);
+        HWAddrPtr hwaddr = boost::make_shared<HWAddr>(std::vector<uint8_t>(6, static_cast<uint8_t>(i)),
+                                                      HTYPE_ETHER);
+        Lease4Ptr lease = boost::make_shared<Lease4>(address, hwaddr, ClientIdPtr(), 60, 0, 1);
+        leases.push_back(lease);
+        ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::ADD, lease));
+    }
+    EXPECT_EQ(3, backlog.size());
+
+    // Delete the second lease and update the first one. The queue is full
+    // but these updates replace the queued ones.
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::DELETE, leases[1]));
+    Lease4Ptr updated = boost::make_shared<Lease4>(*leases[0]);
+    updated->valid_lft_ = 120;
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::ADD, updated));
+    EXPECT_EQ(3, backlog.size());
+    EXPECT_FALSE(backlog.wasOverflown());
+
+    // The updates are in the order of the first update for each lease.
+    LeaseUpdateBacklog::OpType op_type;
+    LeasePtr lease = backlog.pop(op_type);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(LeaseUpdateBacklog::ADD, op_type);
+    EXPECT_EQ(120, lease->valid_lft_);
+
+    lease = backlog.pop(op_type);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(LeaseUpdateBacklog::DELETE, op_type);
+    EXPECT_EQ(leases[1]->addr_, lease->addr_);
+
+    lease = backlog.pop(op_type);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(LeaseUpdateBacklog::ADD, op_type);
+    EXPECT_EQ(leases[2]->addr_, lease->addr_);
+
+    EXPECT_FALSE(backlog.pop(op_type));
+}
+
+// This test verifies that IPv6 leases of different types with the same
+// address are not replacing each other.
+TEST(LeaseUpdateBacklogTest, replace6) {
+    LeaseUpdateBacklog backlog(5);
+
+    DuidPtr duid = boost::make_shared<DUID>(std::vector<uint8_t>(8, 2));
+    Lease6Ptr lease_na = boost::make_shared<Lease6>(Lease::TYPE_NA, IOAddress("2001:db8:1::"),
+                                                    duid, 1, 30, 60, 1);
+    Lease6Ptr lease_pd = boost::make_shared<Lease6>(Lease::TYPE_PD, IOAddress("2001:db8:1::"),
+                                                    duid, 1, 30, 60, 1, HWAddrPtr(), 64);
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::ADD, lease_na));
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::ADD, lease_pd));
+    EXPECT_EQ(2, backlog.size());
+
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::DELETE, lease_pd));
+    EXPECT_EQ(2, backlog.size());
+}
+
+// This test verifies that the memory used by the lease updates is tracked
+// and limited.
+TEST(LeaseUpdateBacklogTest, memoryLimit) {
+    IOAddress address("192.0.2.1");
+    HWAddrPtr hwaddr = boost::make_shared<HWAddr>(std::vector<uint8_t>(6, 1), HTYPE_ETHER);
+    Lease4Ptr lease = boost::make_shared<Lease4>(address, hwaddr, ClientIdPtr(), 60, 0, 1);
+    size_t lease_memory = LeaseUpdateBacklog::getLeaseMemoryUsage(lease);
+    EXPECT_GT(lease_memory, sizeof(Lease4));
+
+    // Create the queue with room for 2 such leases.
+    LeaseUpdateBacklog backlog(100, 2 * lease_memory + lease_memory / 2);
+    EXPECT_EQ(0, backlog.getMemoryUsage());
+    EXPECT_EQ(0, backlog.getAge().total_microseconds());
+
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::ADD, lease));
+    EXPECT_EQ(lease_memory, backlog.getMemoryUsage());
+    EXPECT_GE(backlog.getAge().total_microseconds(), 0);
+
+    // Replacing the update does not change the memory usage.
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::DELETE, lease));
+    EXPECT_EQ(lease_memory, backlog.getMemoryUsage());
+
+    Lease4Ptr lease2 = boost::make_shared<Lease4>(IOAddress("192.0.2.2"), hwaddr,
+                                                  ClientIdPtr(), 60, 0, 1);
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::ADD, lease2));
+    EXPECT_EQ(2 * lease_memory, backlog.getMemoryUsage());
+
+    // The third lease exceeds the memory limit.
+    Lease4Ptr lease3 = boost::make_shared<Lease4>(IOAddress("192.0.2.3"), hwaddr,
+                                                  ClientIdPtr(), 60, 0, 1);
+    EXPECT_FALSE(backlog.push(LeaseUpdateBacklog::ADD, lease3));
+    EXPECT_TRUE(backlog.wasOverflown());
+    EXPECT_EQ(2, backlog.size());
+
+    // Popping releases the memory.
+    LeaseUpdateBacklog::OpType op_type;
+    ASSERT_TRUE(backlog.pop(op_type));
+    EXPECT_EQ(lease_memory, backlog.getMemoryUsage());
+
+    ASSERT_NO_THROW(backlog.clear());
+    EXPECT_EQ(0, backlog.getMemoryUsage());
+    EXPECT_EQ(0, backlog.size());
+}
+
 } // end of anonymous namespace
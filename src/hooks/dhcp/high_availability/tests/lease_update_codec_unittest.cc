@@ -0,0 +1,191 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <lease_update_codec.h>
+#include <asiolink/io_address.h>
+#include <cc/data.h>
+#include <dhcp/duid.h>
+#include <dhcp/hwaddr.h>
+#include <exceptions/exceptions.h>
+
+#include <boost/make_shared.hpp>
+#include <boost/pointer_cast.hpp>
+#include <gtest/gtest.h>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::ha;
+
+namespace {
+
+/// @brief Creates an IPv4 lease with all the encoded fields set.
+///
+/// @param address lease address.
+Lease4Ptr
+createLease4(const std::string& address) {
+    HWAddrPtr hwaddr = boost::make_shared<HWAddr>(std::vector<uint8_t>(6, 0xA),
+                                                  HTYPE_ETHER);
+    ClientIdPtr client_id = boost::make_shared<ClientId>(std::vector<uint8_t>(8, 0xB));
+    Lease4Ptr lease = boost::make_shared<Lease4>(IOAddress(address), hwaddr,
+                                                 client_id, 3600, 1685000000,
+                                                 10, true, false,
+                                                 "host.example.org");
+    lease->state_ = Lease::STATE_DECLINED;
+    lease->setContext(Element::fromJSON("{ \"foo\": \"bar\" }"));
+    return (lease);
+}
+
+/// @brief Creates an IPv6 lease with all the encoded fields set.
+///
+/// @param address lease address.
+Lease6Ptr
+createLease6(const std::string& address) {
+    DuidPtr duid = boost::make_shared<DUID>(std::vector<uint8_t>(10, 0xC));
+    Lease6Ptr lease = boost::make_shared<Lease6>(Lease::TYPE_PD, IOAddress(address),
+                                                 duid, 1234, 1800, 3600, 20,
+                                                 false, true, "",
+                                                 HWAddrPtr(), 56);
+    lease->cltt_ = 1685000001;
+    lease->current_cltt_ = lease->cltt_;
+    return (lease);
+}
+
+// This test verifies that lease updates of both families survive an
+// encoding and decoding round trip.
+TEST(LeaseUpdateCodecTest, updatesRoundTrip) {
+    LeaseUpdateCodec::Updates updates;
+    updates.push_back(std::make_pair(LeaseUpdateBacklog::ADD, createLease4("192.0.2.1")));
+    updates.push_back(std::make_pair(LeaseUpdateBacklog::DELETE, createLease6("2001:db8:1::")));
+    updates.push_back(std::make_pair(LeaseUpdateBacklog::ADD,
+                                     boost::make_shared<Lease4>(IOAddress("192.0.2.2"),
+                                                                HWAddrPtr(), ClientIdPtr(),
+                                                                60, 0, 1)));
+
+    size_t encoded = 0;
+    std::vector<uint8_t> message;
+    ASSERT_NO_THROW(message = LeaseUpdateCodec::encodeUpdates(17, updates, 0, encoded));
+    EXPECT_EQ(3, encoded);
+    EXPECT_EQ(LeaseUpdateCodec::UPDATE,
+              LeaseUpdateCodec::getKind(message.data(), message.size()));
+
+    LeaseUpdateCodec::Updates decoded;
+    uint32_t sequence = 0;
+    ASSERT_NO_THROW(sequence = LeaseUpdateCodec::decodeUpdates(message.data(),
+                                                               message.size(),
+                                                               decoded));
+    EXPECT_EQ(17, sequence);
+    ASSERT_EQ(3, decoded.size());
+
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        EXPECT_EQ(updates[i].first, decoded[i].first);
+        ASSERT_TRUE(decoded[i].second);
+        EXPECT_EQ(updates[i].second->getType(), decoded[i].second->getType());
+    }
+
+    Lease4Ptr lease4 = boost::dynamic_pointer_cast<Lease4>(decoded[0].second);
+    ASSERT_TRUE(lease4);
+    EXPECT_TRUE(*lease4 == *boost::dynamic_pointer_cast<Lease4>(updates[0].second));
+
+    Lease6Ptr lease6 = boost::dynamic_pointer_cast<Lease6>(decoded[1].second);
+    ASSERT_TRUE(lease6);
+    EXPECT_TRUE(*lease6 == *boost::dynamic_pointer_cast<Lease6>(updates[1].second));
+
+    lease4 = boost::dynamic_pointer_cast<Lease4>(decoded[2].second);
+    ASSERT_TRUE(lease4);
+    EXPECT_FALSE(lease4->hwaddr_);
+    EXPECT_FALSE(lease4->client_id_);
+    EXPECT_FALSE(lease4->getContext());
+}
+
+// This test verifies that the updates which do not fit in a message
+// are left for the next message.
+TEST(LeaseUpdateCodecTest, updatesSplit) {
+    LeaseUpdateCodec::Updates updates;
+    for (unsigned i = 0; i < 2000; ++i) {
+        updates.push_back(std::make_pair(LeaseUpdateBacklog::ADD,
+                                         createLease4(IOAddress(0xC0000000 + i).toText())));
+    }
+
+    size_t total = 0;
+    uint32_t sequence = 0;
+    while (total < updates.size()) {
+        size_t encoded = 0;
+        std::vector<uint8_t> message =
+            LeaseUpdateCodec::encodeUpdates(sequence, updates, total, encoded);
+        ASSERT_GT(encoded, 0);
+        EXPECT_LE(message.size(), LeaseUpdateCodec::MAX_MESSAGE_SIZE);
+
+        LeaseUpdateCodec::Updates decoded;
+        EXPECT_EQ(sequence, LeaseUpdateCodec::decodeUpdates(message.data(),
+                                                            message.size(),
+                                                            decoded));
+        ASSERT_EQ(encoded, decoded.size());
+        EXPECT_EQ(updates[total].second->addr_, decoded[0].second->addr_);
+        total += encoded;
+        ++sequence;
+    }
+    EXPECT_EQ(updates.size(), total);
+    EXPECT_GT(sequence, 1);
+}
+
+// This test verifies that malformed update messages are rejected.
+TEST(LeaseUpdateCodecTest, updatesMalformed) {
+    LeaseUpdateCodec::Updates updates;
+    updates.push_back(std::make_pair(LeaseUpdateBacklog::ADD, createLease4("192.0.2.1")));
+    size_t encoded = 0;
+    std::vector<uint8_t> message = LeaseUpdateCodec::encodeUpdates(1, updates, 0, encoded);
+
+    LeaseUpdateCodec::Updates decoded;
+    // Truncated.
+    EXPECT_THROW(LeaseUpdateCodec::decodeUpdates(message.data(), message.size() - 1,
+                                                 decoded), BadValue);
+    // Trailing data.
+    std::vector<uint8_t> longer(message);
+    longer.push_back(0);
+    EXPECT_THROW(LeaseUpdateCodec::decodeUpdates(longer.data(), longer.size(),
+                                                 decoded), BadValue);
+    // Unknown operation type.
+    std::vector<uint8_t> bad_op(message);
+    bad_op[7] = 5;
+    EXPECT_THROW(LeaseUpdateCodec::decodeUpdates(bad_op.data(), bad_op.size(),
+                                                 decoded), BadValue);
+    // Unknown lease type.
+    std::vector<uint8_t> bad_type(message);
+    bad_type[8] = 9;
+    EXPECT_THROW(LeaseUpdateCodec::decodeUpdates(bad_type.data(), bad_type.size(),
+                                                 decoded), BadValue);
+    // Not an update message.
+    std::vector<uint8_t> ack = LeaseUpdateCodec::encodeAck(1, std::vector<uint16_t>());
+    EXPECT_THROW(LeaseUpdateCodec::decodeUpdates(ack.data(), ack.size(),
+                                                 decoded), BadValue);
+    // Null lease.
+    updates.push_back(std::make_pair(LeaseUpdateBacklog::ADD, LeasePtr()));
+    EXPECT_THROW(LeaseUpdateCodec::encodeUpdates(1, updates, 1, encoded), BadValue);
+}
+
+// This test verifies that acknowledgments survive an encoding and
+// decoding round trip and malformed ones are rejected.
+TEST(LeaseUpdateCodecTest, ack) {
+    std::vector<uint16_t> failed = { 1, 5, 300 };
+    std::vector<uint8_t> ack = LeaseUpdateCodec::encodeAck(0xFFFFFFFF, failed);
+    EXPECT_EQ(LeaseUpdateCodec::ACK, LeaseUpdateCodec::getKind(ack.data(), ack.size()));
+
+    std::vector<uint16_t> decoded;
+    EXPECT_EQ(0xFFFFFFFF, LeaseUpdateCodec::decodeAck(ack.data(), ack.size(), decoded));
+    EXPECT_EQ(failed, decoded);
+
+    EXPECT_THROW(LeaseUpdateCodec::decodeAck(ack.data(), ack.size() - 1, decoded),
+                 BadValue);
+    EXPECT_THROW(LeaseUpdateCodec::getKind(ack.data(), 0), BadValue);
+    std::vector<uint8_t> unknown(1, 3);
+    EXPECT_THROW(LeaseUpdateCodec::getKind(unknown.data(), unknown.size()), BadValue);
+}
+
+} // end of anonymous namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -17,8 +17,12 @@
 #include <dhcp/hwaddr.h>
 #include <util/multi_threading_mgr.h>
 
+#include <atomic>
 #include <cstdint>
+#include <set>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace isc;
 using namespace isc::data;
@@ -1008,6 +1012,95 @@ TEST_F(QueryFilterTest, explicitlyServeScopesMultiThreading) {
     explicitlyServeScopes();
 }
 
+// This test verifies that the queries are checked consistently while the
+// served scopes are changed by another thread.
+TEST_F(QueryFilterTest, concurrentScopeChangesMultiThreading) {
+    MultiThreadingMgr::instance().setMode(true);
+
+    HAConfigPtr config = createValidConfiguration();
+    QueryFilter filter(config);
+
+    // Find the queries belonging to the server1 scope.
+    std::vector<Pkt4Ptr> queries;
+    std::string scope_class;
+    while (queries.size() < 100) {
+        Pkt4Ptr query4 = createQuery4(randomKey(HWAddr::ETHERNET_HWADDR_LEN));
+        if (filter.inScope(query4, scope_class)) {
+            queries.push_back(query4);
+        }
+    }
+
+    // The server1 scope remains served while the scope of the server2 is
+    // enabled and disabled, so these queries must always be in scope.
+    std::atomic<bool> done(false);
+    std::atomic<unsigned> out_of_scope(0);
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 4; ++i) {
+        threads.push_back(std::thread([&]() {
+            std::string scope_class;
+            while (!done) {
+                for (auto const& query4 : queries) {
+                    if (!filter.inScope(query4, scope_class) ||
+                        (scope_class != "HA_server1")) {
+                        ++out_of_scope;
+                    }
+                }
+            }
+        }));
+    }
+
+    for (auto i = 0; i < 1000; ++i) {
+        filter.serveFailoverScopes();
+        filter.serveDefaultScopes();
+    }
+    done = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(0, out_of_scope);
+    EXPECT_TRUE(filter.amServingScope("server1"));
+    EXPECT_FALSE(filter.amServingScope("server2"));
+}
+
+// This test verifies that the hash buckets are spread across the active
+// servers and only the buckets of the enabled scopes are served.
+TEST_F(QueryFilterTest, scopeBuckets) {
+    HAConfigPtr config = createValidConfiguration();
+    QueryFilter filter(config);
+
+    std::vector<uint8_t> buckets1 = filter.getScopeBuckets("server1");
+    std::vector<uint8_t> buckets2 = filter.getScopeBuckets("server2");
+    ASSERT_EQ(128, buckets1.size());
+    ASSERT_EQ(128, buckets2.size());
+    EXPECT_TRUE(filter.getScopeBuckets("server3").empty());
+    EXPECT_THROW(filter.getScopeBuckets("unknown"), BadValue);
+
+    // Each bucket has exactly one owner.
+    std::set<uint8_t> all_buckets(buckets1.begin(), buckets1.end());
+    all_buckets.insert(buckets2.begin(), buckets2.end());
+    EXPECT_EQ(256, all_buckets.size());
+
+    // The queries of the server2 buckets are not served until the scope
+    // of the server2 is enabled.
+    std::string scope_class;
+    for (auto i = 0; i < 100; ++i) {
+        Pkt4Ptr query4 = createQuery4(randomKey(HWAddr::ETHERNET_HWADDR_LEN));
+        bool in_scope = filter.inScope(query4, scope_class);
+        EXPECT_EQ(in_scope, scope_class == "HA_server1");
+    }
+    filter.serveScope("server2");
+    for (auto i = 0; i < 100; ++i) {
+        Pkt4Ptr query4 = createQuery4(randomKey(HWAddr::ETHERNET_HWADDR_LEN));
+        EXPECT_TRUE(filter.inScope(query4, scope_class));
+    }
+
+    // There are no buckets in the hot-standby mode.
+    config = createValidConfiguration(HAConfig::HOT_STANDBY);
+    QueryFilter hs_filter(config);
+    EXPECT_TRUE(hs_filter.getScopeBuckets("server1").empty());
+}
+
 TEST_F(QueryFilterTest, loadBalancingHaTypes4) {
     loadBalancingHaTypes4();
 }
@@ -24,6 +24,7 @@
 #include <exceptions/exceptions.h>
 #include <lease_cmds.h>
 #include <lease_cmds_exceptions.h>
+#include <lease_export.h>
 #include <lease_parser.h>
 #include <lease_cmds_log.h>
 #include <stats/stats_mgr.h>
@@ -33,8 +34,15 @@
 
 #include <boost/scoped_ptr.hpp>
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <map>
+#include <set>
 #include <string>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace isc::dhcp;
 using namespace isc::data;
@@ -149,6 +157,18 @@ public:
     int
     lease6BulkApplyHandler(CalloutHandle& handle);
 
+    /// @brief lease4-bulk-apply command handler
+    ///
+    /// Provides the implementation for the
+    /// @ref isc::lease_cmds::LeaseCmds::lease4BulkApplyHandler.
+    ///
+    /// @param handle Callout context - which is expected to contain the
+    /// add command JSON text in the "command" argument
+    ///
+    /// @return 0 upon success, non-zero otherwise
+    int
+    lease4BulkApplyHandler(CalloutHandle& handle);
+
     /// @brief lease4-get, lease6-get command handler
     ///
     /// Provides the implementation for @ref isc::lease_cmds::LeaseCmds::leaseGetHandler
@@ -338,6 +358,28 @@ public:
     int
     leaseWriteHandler(CalloutHandle& handle);
 
+    /// @brief lease4-export handler, lease6-export handler
+    ///
+    /// Provides the implementation for @ref isc::lease_cmds::LeaseCmds::leaseExportHandler
+    ///
+    /// @param handle Callout context - which is expected to contain the
+    /// export command JSON text in the "command" argument
+    ///
+    /// @return 0 upon success, non-zero otherwise
+    int
+    leaseExportHandler(CalloutHandle& handle);
+
+    /// @brief lease-export-status handler
+    ///
+    /// Provides the implementation for @ref isc::lease_cmds::LeaseCmds::leaseExportStatusHandler
+    ///
+    /// @param handle Callout context - which is expected to contain the
+    /// lease-export-status command JSON text in the "command" argument
+    ///
+    /// @return 0 upon success, non-zero otherwise
+    int
+    leaseExportStatusHandler(CalloutHandle& handle);
+
     /// @brief Extracts parameters required for reservation-get and reservation-del
     ///
     /// See @ref Parameters class for detailed description of what is expected
@@ -370,6 +412,20 @@ public:
     /// @throw InvalidOperation if the query type is unknown.
     Lease6Ptr getIPv6LeaseForDelete(const Parameters& parameters) const;
 
+    /// @brief Convenience function fetching IPv4 lease to be deleted.
+    ///
+    /// When the lease does not exist and the lease is specified by
+    /// address, a lease holding only this address is returned so it
+    /// can be reported as not found.
+    ///
+    /// @param parameters parameters extracted from the command.
+    ///
+    /// @return Lease of the lease to be deleted.
+    ///
+    /// @throw InvalidParameter if the query type is by DUID.
+    /// @throw InvalidOperation if the query type is unknown.
+    Lease4Ptr getIPv4LeaseForDelete(const Parameters& parameters) const;
+
     /// @brief Returns a map holding brief information about a lease which
     /// failed to be deleted, updated or added.
     ///
@@ -457,6 +513,62 @@ public:
     /// @return true if lease has been successfully added, false otherwise.
     static bool addOrUpdate6(Lease6Ptr lease, bool force_create);
 
+    /// @brief Prepares the update of an existing lease.
+    ///
+    /// @param existing The lease in the database.
+    /// @param lease The lease which will replace it.
+    static void prepareUpdate6(const Lease6Ptr& existing, Lease6Ptr lease);
+
+    /// @brief Number of leases parsed by thread by the bulk apply.
+    ///
+    /// The smaller lists are parsed by the calling thread.
+    static const size_t BULK_PARSE_CHUNK = 256;
+
+    /// @brief Parses the leases of a bulk apply.
+    ///
+    /// The large lists are parsed concurrently by several threads.
+    ///
+    /// @param config The current configuration.
+    /// @param leases The list of leases.
+    /// @return The leases, in the order of the list.
+    /// @throw the exception thrown when parsing the first malformed lease.
+    static Lease6Collection parseLeases6(ConstSrvConfigPtr& config,
+                                         const ConstElementPtr& leases);
+
+    /// @brief Adds or updates a lease of a bulk apply.
+    ///
+    /// @param lease The lease to be added or updated (if exists).
+    /// @param lock Flag to indicate if the lease must be locked in
+    /// multi-threading mode.
+    /// @param [out] success_count The number of applied leases.
+    /// @param [out] failed_leases_list The list of the failed leases, created
+    /// on the first failure.
+    void applyLease6(const Lease6Ptr& lease, bool lock, size_t& success_count,
+                     ElementPtr& failed_leases_list) const;
+
+    /// @brief Adds or updates the leases of a bulk apply.
+    ///
+    /// The existing leases are fetched with one query, then the new
+    /// leases are added by one batch and the existing leases are updated
+    /// by another, so the SQL backends use a transaction by batch rather
+    /// than by lease. The leases which appear more than once are applied
+    /// one by one after the batches.
+    ///
+    /// @param leases The leases to be added or updated.
+    /// @param [out] success_count The number of applied leases.
+    /// @param [out] failed_leases_list The list of the failed leases, created
+    /// on the first failure.
+    void applyLeases6(const Lease6Collection& leases, size_t& success_count,
+                      ElementPtr& failed_leases_list) const;
+
+    /// @brief Checks which leases of a batch were applied.
+    ///
+    /// @param leases The leases of the batch.
+    /// @param count The number of leases the backend applied.
+    /// @return A flag by lease, true when the lease was applied.
+    static std::vector<bool> checkApplied6(const Lease6Collection& leases,
+                                           size_t count);
+
     /// @brief Get DHCPv6 extended info.
     ///
     /// @param lease The lease to get extended info from.
@@ -714,21 +826,7 @@ LeaseCmdsImpl::addOrUpdate6(Lease6Ptr lease, bool force_create) {
         return (true);
     }
     if (existing) {
-        // Update lease current expiration time with value received from the
-        // database. Some database backends reject operations on the lease if
-        // the current expiration time value does not match what is stored.
-        Lease::syncCurrentExpirationTime(*existing, *lease);
-
-        // Check what is the action about extended info.
-        ConstElementPtr old_extended_info = getExtendedInfo6(existing);
-        ConstElementPtr extended_info = getExtendedInfo6(lease);
-        if ((!old_extended_info && !extended_info) ||
-            (old_extended_info && extended_info &&
-             (*old_extended_info == *extended_info))) {
-            // Leave the default Lease6::ACTION_IGNORE.
-        } else {
-            lease->extended_info_action_ = Lease6::ACTION_UPDATE;
-        }
+        prepareUpdate6(existing, lease);
     }
     try {
         LeaseMgrFactory::instance().updateLease6(lease);
@@ -743,6 +841,284 @@ LeaseCmdsImpl::addOrUpdate6(Lease6Ptr lease, bool force_create) {
     return (false);
 }
 
+void
+LeaseCmdsImpl::prepareUpdate6(const Lease6Ptr& existing, Lease6Ptr lease) {
+    // Update lease current expiration time with value received from the
+    // database. Some database backends reject operations on the lease if
+    // the current expiration time value does not match what is stored.
+    Lease::syncCurrentExpirationTime(*existing, *lease);
+
+    // Check what is the action about extended info.
+    ConstElementPtr old_extended_info = getExtendedInfo6(existing);
+    ConstElementPtr extended_info = getExtendedInfo6(lease);
+    if ((!old_extended_info && !extended_info) ||
+        (old_extended_info && extended_info &&
+         (*old_extended_info == *extended_info))) {
+        // Leave the default Lease6::ACTION_IGNORE.
+    } else {
+        lease->extended_info_action_ = Lease6::ACTION_UPDATE;
+    }
+}
+
+Lease6Collection
+LeaseCmdsImpl::parseLeases6(ConstSrvConfigPtr& config,
+                            const ConstElementPtr& leases) {
+    auto const& leases_list = leases->listValue();
+    Lease6Collection parsed(leases_list.size());
+    size_t chunks = (leases_list.size() + BULK_PARSE_CHUNK - 1) / BULK_PARSE_CHUNK;
+    size_t thread_count = std::min(chunks, static_cast<size_t>(
+        std::max(1U, std::thread::hardware_concurrency())));
+
+    // Each thread parses a contiguous range of leases into its own slots
+    // and stops at the first malformed lease.
+    std::vector<std::exception_ptr> errors(leases_list.size());
+    auto parse_range = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            try {
+                Lease6Parser parser;
+                bool force_update;
+                parsed[i] = parser.parse(config, leases_list[i], force_update);
+            } catch (...) {
+                errors[i] = std::current_exception();
+                return;
+            }
+        }
+    };
+    if (thread_count <= 1) {
+        parse_range(0, leases_list.size());
+    } else {
+        std::vector<std::thread> threads;
+        size_t range = (leases_list.size() + thread_count - 1) / thread_count;
+        for (size_t begin = 0; begin < leases_list.size(); begin += range) {
+            threads.emplace_back(parse_range, begin,
+                                 std::min(leases_list.size(), begin + range));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // If parsing a lease failed we throw, as it indicates that the
+    // command is malformed.
+    for (auto const& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return (parsed);
+}
+
+void
+LeaseCmdsImpl::applyLease6(const Lease6Ptr& lease, bool lock,
+                           size_t& success_count,
+                           ElementPtr& failed_leases_list) const {
+    auto result = CONTROL_RESULT_SUCCESS;
+    std::ostringstream text;
+    try {
+        if (!lock || !MultiThreadingMgr::instance().getMode()) {
+            // Not multi-threading or already locked.
+            addOrUpdate6(lease, true);
+        } else {
+            // Multi-threading, try to lock first to avoid a race.
+            ResourceHandler resource_handler;
+            if (resource_handler.tryLock(lease->type_, lease->addr_)) {
+                addOrUpdate6(lease, true);
+            } else {
+                isc_throw(LeaseCmdsConflict,
+                          "ResourceBusy: IP address:" << lease->addr_
+                          << " could not be updated.");
+            }
+        }
+
+        ++success_count;
+    } catch (const LeaseCmdsConflict& ex) {
+        result = CONTROL_RESULT_CONFLICT;
+        text << ex.what();
+
+    } catch (const std::exception& ex) {
+        result = CONTROL_RESULT_ERROR;
+        text << ex.what();
+    }
+    // Handle an error.
+    if (result != CONTROL_RESULT_SUCCESS) {
+        // Lazy creation of the list of leases which failed to add/update.
+        if (!failed_leases_list) {
+            failed_leases_list = Element::createList();
+        }
+        failed_leases_list->add(createFailedLeaseMap(lease->type_,
+                                                     lease->addr_,
+                                                     lease->duid_,
+                                                     result,
+                                                     text.str()));
+    }
+}
+
+void
+LeaseCmdsImpl::applyLeases6(const Lease6Collection& leases,
+                            size_t& success_count,
+                            ElementPtr& failed_leases_list) const {
+    auto fail = [&](const Lease6Ptr& lease, int result,
+                    const std::string& text) {
+        // Lazy creation of the list of leases which failed to add/update.
+        if (!failed_leases_list) {
+            failed_leases_list = Element::createList();
+        }
+        failed_leases_list->add(createFailedLeaseMap(lease->type_,
+                                                     lease->addr_,
+                                                     lease->duid_,
+                                                     result, text));
+    };
+
+    Lease6Collection duplicates;
+    {
+        // Lock the leases in multi-threading mode until they are applied.
+        bool multi_threading = MultiThreadingMgr::instance().getMode();
+        ResourceHandler resource_handler;
+        std::set<std::pair<Lease::Type, IOAddress> > seen;
+        std::map<Lease::Type, std::vector<IOAddress> > addresses;
+        Lease6Collection batch;
+        for (auto const& lease : leases) {
+            if (!seen.insert(std::make_pair(lease->type_, lease->addr_)).second) {
+                duplicates.push_back(lease);
+                continue;
+            }
+            if (multi_threading &&
+                !resource_handler.tryLock(lease->type_, lease->addr_)) {
+                std::ostringstream text;
+                text << "ResourceBusy: IP address:" << lease->addr_
+                     << " could not be updated.";
+                fail(lease, CONTROL_RESULT_CONFLICT, text.str());
+                continue;
+            }
+            batch.push_back(lease);
+            addresses[lease->type_].push_back(lease->addr_);
+        }
+
+        // Fetch the existing leases with one query by lease type.
+        LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
+        std::map<std::pair<Lease::Type, IOAddress>, Lease6Ptr> existing;
+        try {
+            for (auto const& type_addresses : addresses) {
+                auto const& found =
+                    lease_mgr.getLeases6ByAddresses(type_addresses.first,
+                                                    type_addresses.second);
+                for (auto const& lease : found) {
+                    existing[std::make_pair(lease->type_, lease->addr_)] = lease;
+                }
+            }
+        } catch (const std::exception&) {
+            // Report the errors by lease.
+            for (auto const& lease : batch) {
+                applyLease6(lease, false, success_count, failed_leases_list);
+            }
+            batch.clear();
+        }
+
+        Lease6Collection added;
+        Lease6Collection updated;
+        Lease6Collection previous;
+        for (auto const& lease : batch) {
+            auto it = existing.find(std::make_pair(lease->type_, lease->addr_));
+            if (it == existing.end()) {
+                added.push_back(lease);
+            } else {
+                prepareUpdate6(it->second, lease);
+                updated.push_back(lease);
+                previous.push_back(it->second);
+            }
+        }
+
+        if (!added.empty()) {
+            std::vector<bool> applied;
+            try {
+                applied = checkApplied6(added, lease_mgr.addLeases6(added));
+            } catch (const std::exception&) {
+                // The batch failed: apply the leases one by one to report
+                // the errors by lease.
+                for (auto const& lease : added) {
+                    applyLease6(lease, false, success_count, failed_leases_list);
+                }
+            }
+            for (size_t i = 0; i < applied.size(); ++i) {
+                if (applied[i]) {
+                    ++success_count;
+                    LeaseCmdsImpl::updateStatsOnAdd(added[i]);
+                } else {
+                    fail(added[i], CONTROL_RESULT_CONFLICT,
+                         "lost race between calls to get and add");
+                }
+            }
+        }
+
+        if (!updated.empty()) {
+            std::vector<bool> applied;
+            try {
+                applied = checkApplied6(updated, lease_mgr.updateLeases6(updated));
+            } catch (const std::exception&) {
+                // The batch failed: apply the leases one by one to report
+                // the errors by lease.
+                for (auto const& lease : updated) {
+                    applyLease6(lease, false, success_count, failed_leases_list);
+                }
+            }
+            for (size_t i = 0; i < applied.size(); ++i) {
+                if (applied[i]) {
+                    ++success_count;
+                    LeaseCmdsImpl::updateStatsOnUpdate(previous[i], updated[i]);
+                } else {
+                    std::ostringstream text;
+                    text << "failed to update the lease with address "
+                         << updated[i]->addr_ << " either because the lease "
+                         "has been deleted or it has changed in the database, "
+                         "in both cases a retry might succeed";
+                    fail(updated[i], CONTROL_RESULT_CONFLICT, text.str());
+                }
+            }
+        }
+    }
+
+    // Apply the duplicates in order, after the locks were released.
+    for (auto const& lease : duplicates) {
+        applyLease6(lease, true, success_count, failed_leases_list);
+    }
+}
+
+std::vector<bool>
+LeaseCmdsImpl::checkApplied6(const Lease6Collection& leases, size_t count) {
+    std::vector<bool> applied(leases.size(), true);
+    if (count == leases.size()) {
+        return (applied);
+    }
+
+    // Some leases were skipped because another writer added, updated or
+    // deleted them concurrently: look for the stored leases which are
+    // not the ones of the batch.
+    std::map<Lease::Type, std::vector<IOAddress> > addresses;
+    for (auto const& lease : leases) {
+        addresses[lease->type_].push_back(lease->addr_);
+    }
+    std::map<std::pair<Lease::Type, IOAddress>, Lease6Ptr> stored;
+    for (auto const& type_addresses : addresses) {
+        auto const& found =
+            LeaseMgrFactory::instance().getLeases6ByAddresses(type_addresses.first,
+                                                              type_addresses.second);
+        for (auto const& lease : found) {
+            stored[std::make_pair(lease->type_, lease->addr_)] = lease;
+        }
+    }
+    for (size_t i = 0; i < leases.size(); ++i) {
+        auto const& lease = leases[i];
+        auto it = stored.find(std::make_pair(lease->type_, lease->addr_));
+        applied[i] = ((it != stored.end()) &&
+                      (it->second->cltt_ == lease->cltt_) &&
+                      (it->second->valid_lft_ == lease->valid_lft_) &&
+                      (it->second->iaid_ == lease->iaid_) &&
+                      (it->second->duid_ && lease->duid_ &&
+                       (*it->second->duid_ == *lease->duid_)));
+    }
+    return (applied);
+}
+
 int
 LeaseCmdsImpl::leaseAddHandler(CalloutHandle& handle) {
     // Arbitrary defaulting to DHCPv4 or with other words extractCommand
@@ -1209,11 +1585,69 @@ LeaseCmdsImpl::leaseGetPageHandler(CalloutHandle& handle) {
         // Retrieve the desired page size.
         size_t page_limit_value = static_cast<size_t>(page_limit->intValue());
 
+        // The optional filters restrict the returned leases.
+        LeasePageFilter filter;
+        bool filtered = false;
+        ConstElementPtr subnet_id = cmd_args_->get("subnet-id");
+        if (subnet_id) {
+            if ((subnet_id->getType() != Element::integer) ||
+                (subnet_id->intValue() <= 0) ||
+                (subnet_id->intValue() > std::numeric_limits<uint32_t>::max())) {
+                isc_throw(BadValue, "'subnet-id' parameter must be a positive "
+                          "32 bit number");
+            }
+            filter.subnet_id_ = static_cast<SubnetID>(subnet_id->intValue());
+            filtered = true;
+        }
+        ConstElementPtr state = cmd_args_->get("state");
+        if (state) {
+            if ((state->getType() != Element::integer) ||
+                (state->intValue() < 0) ||
+                (state->intValue() > std::numeric_limits<uint32_t>::max())) {
+                isc_throw(BadValue, "'state' parameter must be a non-negative "
+                          "32 bit number");
+            }
+            filter.state_ = static_cast<uint32_t>(state->intValue());
+            filtered = true;
+        }
+        ConstElementPtr expire_min = cmd_args_->get("expire-min");
+        if (expire_min) {
+            if (expire_min->getType() != Element::integer) {
+                isc_throw(BadValue, "'expire-min' parameter must be a number");
+            }
+            filter.min_expire_ = expire_min->intValue();
+            filtered = true;
+        }
+        ConstElementPtr expire_max = cmd_args_->get("expire-max");
+        if (expire_max) {
+            if (expire_max->getType() != Element::integer) {
+                isc_throw(BadValue, "'expire-max' parameter must be a number");
+            }
+            filter.max_expire_ = expire_max->intValue();
+            filtered = true;
+        }
+        ConstElementPtr client_class = cmd_args_->get("client-class");
+        if (client_class) {
+            if ((client_class->getType() != Element::string) ||
+                client_class->stringValue().empty()) {
+                isc_throw(BadValue, "'client-class' parameter must be a "
+                          "non-empty string");
+            }
+            filter.client_class_ = client_class->stringValue();
+            filtered = true;
+        }
+        if (filtered && !v4) {
+            isc_throw(BadValue, "filters are not supported by the "
+                      << cmd_name_ << " command");
+        }
+
         ElementPtr leases_json = Element::createList();
 
         if (v4) {
             // Get page of IPv4 leases.
-            Lease4Collection leases =
+            Lease4Collection leases = filtered ?
+                LeaseMgrFactory::instance().getFilteredLeases4(filter, *from_address,
+                                                               LeasePageSize(page_limit_value)) :
                 LeaseMgrFactory::instance().getLeases4(*from_address,
                                                        LeasePageSize(page_limit_value));
 
@@ -1609,7 +2043,161 @@ LeaseCmdsImpl::lease6BulkApplyHandler(CalloutHandle& handle) {
 
         // Parse new/updated leases without affecting the database to detect
         // any errors that should cause an error response.
-        std::list<Lease6Ptr> parsed_leases_list;
+        Lease6Collection parsed_leases_list;
+        if (leases) {
+            ConstSrvConfigPtr config = CfgMgr::instance().getCurrentCfg();
+            parsed_leases_list = parseLeases6(config, leases);
+        }
+
+        // Count successful deletions and updates.
+        size_t success_count = 0;
+
+        ElementPtr failed_deleted_list;
+        if (!parsed_deleted_list.empty()) {
+
+            // Iterate over leases to be deleted.
+            for (auto lease_params_pair : parsed_deleted_list) {
+
+                // This part is outside of the try-catch because an exception
+                // indicates that the command is malformed.
+                Parameters p = lease_params_pair.first;
+                auto lease = lease_params_pair.second;
+
+                try {
+                    if (lease) {
+                        // This may throw if the lease couldn't be deleted for
+                        // any reason, but we still want to proceed with other
+                        // leases.
+                        if (LeaseMgrFactory::instance().deleteLease(lease)) {
+                            ++success_count;
+                            LeaseCmdsImpl::updateStatsOnDelete(lease);
+
+                        } else {
+                            // Lazy creation of the list of leases which failed to delete.
+                            if (!failed_deleted_list) {
+                                failed_deleted_list = Element::createList();
+                            }
+
+                            // If the lease doesn't exist we also want to put it
+                            // on the list of leases which failed to delete. That
+                            // corresponds to the lease6-del command which returns
+                            // an error when the lease doesn't exist.
+                            failed_deleted_list->add(createFailedLeaseMap(p.lease_type,
+                                                                          p.addr, p.duid,
+                                                                          CONTROL_RESULT_EMPTY,
+                                                                          "lease not found"));
+                        }
+                    }
+
+                } catch (const std::exception& ex) {
+                    // Lazy creation of the list of leases which failed to delete.
+                    if (!failed_deleted_list) {
+                         failed_deleted_list = Element::createList();
+                    }
+                    failed_deleted_list->add(createFailedLeaseMap(p.lease_type,
+                                                                  p.addr, p.duid,
+                                                                  CONTROL_RESULT_ERROR,
+                                                                  ex.what()));
+                }
+            }
+        }
+
+        // Process leases to be added or/and updated.
+        ElementPtr failed_leases_list;
+        if (!parsed_leases_list.empty()) {
+            applyLeases6(parsed_leases_list, success_count, failed_leases_list);
+        }
+
+        // Start preparing the response.
+        ElementPtr args;
+
+        if (failed_deleted_list || failed_leases_list) {
+            // If there are any failed leases, let's include them in the response.
+            args = Element::createMap();
+
+            // failed-deleted-leases
+            if (failed_deleted_list) {
+                args->set("failed-deleted-leases", failed_deleted_list);
+            }
+
+            // failed-leases
+            if (failed_leases_list) {
+                args->set("failed-leases", failed_leases_list);
+            }
+        }
+
+        // Send the success response and include failed leases.
+        std::ostringstream resp_text;
+        resp_text << "Bulk apply of " << success_count << " IPv6 leases completed.";
+        auto answer = createAnswer(success_count > 0 ? CONTROL_RESULT_SUCCESS :
+                                   CONTROL_RESULT_EMPTY, resp_text.str(), args);
+        setResponse(handle, answer);
+
+        LOG_DEBUG(lease_cmds_logger, LEASE_CMDS_DBG_COMMAND_DATA,
+                  LEASE_CMDS_BULK_APPLY6)
+            .arg(success_count);
+
+    } catch (const std::exception& ex) {
+        // Unable to parse the command and similar issues.
+        LOG_ERROR(lease_cmds_logger, LEASE_CMDS_BULK_APPLY6_FAILED)
+            .arg(cmd_args_ ? cmd_args_->str() : "<no args>")
+            .arg(ex.what());
+        setErrorResponse(handle, ex.what());
+        return (CONTROL_RESULT_ERROR);
+    }
+
+    return (0);
+}
+
+int
+LeaseCmdsImpl::lease4BulkApplyHandler(CalloutHandle& handle) {
+    try {
+        extractCommand(handle);
+
+        // Arguments are mandatory.
+        if (!cmd_args_ || (cmd_args_->getType() != Element::map)) {
+            isc_throw(BadValue, "Command arguments missing or a not a map.");
+        }
+
+        // At least one of the 'deleted-leases' or 'leases' must be present.
+        auto deleted_leases = cmd_args_->get("deleted-leases");
+        auto leases = cmd_args_->get("leases");
+
+        if (!deleted_leases && !leases) {
+            isc_throw(BadValue, "neither 'deleted-leases' nor 'leases' parameter"
+                      " specified");
+        }
+
+        // Make sure that 'deleted-leases' is a list, if present.
+        if (deleted_leases && (deleted_leases->getType() != Element::list)) {
+            isc_throw(BadValue, "the 'deleted-leases' parameter must be a list");
+        }
+
+        // Make sure that 'leases' is a list, if present.
+        if (leases && (leases->getType() != Element::list)) {
+            isc_throw(BadValue, "the 'leases' parameter must be a list");
+        }
+
+        // Parse deleted leases without deleting them from the database
+        // yet. If any of the deleted leases or new leases appears to be
+        // malformed we can easily rollback.
+        std::list<std::pair<Parameters, Lease4Ptr> > parsed_deleted_list;
+        if (deleted_leases) {
+            auto leases_list = deleted_leases->listValue();
+
+            // Iterate over leases to be deleted.
+            for (auto lease_params : leases_list) {
+                // Parsing the lease may throw and it means that the lease
+                // information is malformed.
+                Parameters p = getParameters(false, lease_params);
+                auto lease = getIPv4LeaseForDelete(p);
+                parsed_deleted_list.push_back(std::make_pair(p, lease));
+            }
+        }
+
+        // Parse new/updated leases without affecting the database to detect
+        // any errors that should cause an error response.
+        std::list<Lease4Ptr> parsed_leases_list;
         if (leases) {
             ConstSrvConfigPtr config = CfgMgr::instance().getCurrentCfg();
 
@@ -1617,13 +2205,13 @@ LeaseCmdsImpl::lease6BulkApplyHandler(CalloutHandle& handle) {
             auto leases_list = leases->listValue();
             for (auto lease_params : leases_list) {
 
-                Lease6Parser parser;
+                Lease4Parser parser;
                 bool force_update;
 
                 // If parsing the lease fails we throw, as it indicates that the
                 // command is malformed.
-                Lease6Ptr lease6 = parser.parse(config, lease_params, force_update);
-                parsed_leases_list.push_back(lease6);
+                Lease4Ptr lease4 = parser.parse(config, lease_params, force_update);
+                parsed_leases_list.push_back(lease4);
             }
         }
 
@@ -1658,10 +2246,11 @@ LeaseCmdsImpl::lease6BulkApplyHandler(CalloutHandle& handle) {
 
                             // If the lease doesn't exist we also want to put it
                             // on the list of leases which failed to delete. That
-                            // corresponds to the lease6-del command which returns
+                            // corresponds to the lease4-del command which returns
                             // an error when the lease doesn't exist.
-                            failed_deleted_list->add(createFailedLeaseMap(p.lease_type,
-                                                                          p.addr, p.duid,
+                            failed_deleted_list->add(createFailedLeaseMap(Lease::TYPE_V4,
+                                                                          lease->addr_,
+                                                                          DuidPtr(),
                                                                           CONTROL_RESULT_EMPTY,
                                                                           "lease not found"));
                         }
@@ -1672,8 +2261,9 @@ LeaseCmdsImpl::lease6BulkApplyHandler(CalloutHandle& handle) {
                     if (!failed_deleted_list) {
                          failed_deleted_list = Element::createList();
                     }
-                    failed_deleted_list->add(createFailedLeaseMap(p.lease_type,
-                                                                  p.addr, p.duid,
+                    failed_deleted_list->add(createFailedLeaseMap(Lease::TYPE_V4,
+                                                                  lease->addr_,
+                                                                  DuidPtr(),
                                                                   CONTROL_RESULT_ERROR,
                                                                   ex.what()));
                 }
@@ -1683,7 +2273,6 @@ LeaseCmdsImpl::lease6BulkApplyHandler(CalloutHandle& handle) {
         // Process leases to be added or/and updated.
         ElementPtr failed_leases_list;
         if (!parsed_leases_list.empty()) {
-            ConstSrvConfigPtr config = CfgMgr::instance().getCurrentCfg();
 
             // Iterate over all leases.
             for (auto lease : parsed_leases_list) {
@@ -1693,12 +2282,12 @@ LeaseCmdsImpl::lease6BulkApplyHandler(CalloutHandle& handle) {
                 try {
                     if (!MultiThreadingMgr::instance().getMode()) {
                         // Not multi-threading.
-                        addOrUpdate6(lease, true);
+                        addOrUpdate4(lease, true);
                     } else {
                         // Multi-threading, try to lock first to avoid a race.
-                        ResourceHandler resource_handler;
-                        if (resource_handler.tryLock(lease->type_, lease->addr_)) {
-                            addOrUpdate6(lease, true);
+                        ResourceHandler4 resource_handler;
+                        if (resource_handler.tryLock4(lease->addr_)) {
+                            addOrUpdate4(lease, true);
                         } else {
                             isc_throw(LeaseCmdsConflict,
                                       "ResourceBusy: IP address:" << lease->addr_
@@ -1721,9 +2310,9 @@ LeaseCmdsImpl::lease6BulkApplyHandler(CalloutHandle& handle) {
                     if (!failed_leases_list) {
                         failed_leases_list = Element::createList();
                     }
-                    failed_leases_list->add(createFailedLeaseMap(lease->type_,
+                    failed_leases_list->add(createFailedLeaseMap(Lease::TYPE_V4,
                                                                  lease->addr_,
-                                                                 lease->duid_,
+                                                                 DuidPtr(),
                                                                  result,
                                                                  text.str()));
                 }
@@ -1750,18 +2339,18 @@ LeaseCmdsImpl::lease6BulkApplyHandler(CalloutHandle& handle) {
 
         // Send the success response and include failed leases.
         std::ostringstream resp_text;
-        resp_text << "Bulk apply of " << success_count << " IPv6 leases completed.";
+        resp_text << "Bulk apply of " << success_count << " IPv4 leases completed.";
         auto answer = createAnswer(success_count > 0 ? CONTROL_RESULT_SUCCESS :
                                    CONTROL_RESULT_EMPTY, resp_text.str(), args);
         setResponse(handle, answer);
 
         LOG_DEBUG(lease_cmds_logger, LEASE_CMDS_DBG_COMMAND_DATA,
-                  LEASE_CMDS_BULK_APPLY6)
+                  LEASE_CMDS_BULK_APPLY4)
             .arg(success_count);
 
     } catch (const std::exception& ex) {
         // Unable to parse the command and similar issues.
-        LOG_ERROR(lease_cmds_logger, LEASE_CMDS_BULK_APPLY6_FAILED)
+        LOG_ERROR(lease_cmds_logger, LEASE_CMDS_BULK_APPLY4_FAILED)
             .arg(cmd_args_ ? cmd_args_->str() : "<no args>")
             .arg(ex.what());
         setErrorResponse(handle, ex.what());
@@ -2180,6 +2769,56 @@ LeaseCmdsImpl::getIPv6LeaseForDelete(const Parameters& parameters) const {
     return (lease6);
 }
 
+Lease4Ptr
+LeaseCmdsImpl::getIPv4LeaseForDelete(const Parameters& parameters) const {
+    Lease4Ptr lease4;
+
+    switch (parameters.query_type) {
+    case Parameters::TYPE_ADDR: {
+        // If address was specified explicitly, let's use it as is.
+
+        // Let's see if there's such a lease at all.
+        lease4 = LeaseMgrFactory::instance().getLease4(parameters.addr);
+        if (!lease4) {
+            lease4.reset(new Lease4());
+            lease4->addr_ = parameters.addr;
+        }
+        break;
+    }
+    case Parameters::TYPE_HWADDR: {
+        if (!parameters.hwaddr) {
+            isc_throw(InvalidParameter, "Program error: Query by hw-address "
+                      "requires hwaddr to be specified");
+        }
+
+        // Let's see if there's such a lease at all.
+        lease4 = LeaseMgrFactory::instance().getLease4(*parameters.hwaddr,
+                                                       parameters.subnet_id);
+        break;
+    }
+    case Parameters::TYPE_CLIENT_ID: {
+        if (!parameters.client_id) {
+            isc_throw(InvalidParameter, "Program error: Query by client-id "
+                      "requires client-id to be specified");
+        }
+
+        // Let's see if there's such a lease at all.
+        lease4 = LeaseMgrFactory::instance().getLease4(*parameters.client_id,
+                                                       parameters.subnet_id);
+        break;
+    }
+    case Parameters::TYPE_DUID: {
+        isc_throw(InvalidParameter, "Delete by duid is not allowed in v4.");
+        break;
+    }
+    default:
+        isc_throw(InvalidOperation, "Unknown query type: "
+                  << static_cast<int>(parameters.query_type));
+    }
+
+    return (lease4);
+}
+
 IOAddress
 LeaseCmdsImpl::getAddressParam(ConstElementPtr params, const std::string name,
                                short family) const {
@@ -2370,6 +3009,101 @@ LeaseCmdsImpl::leaseWriteHandler(CalloutHandle& handle) {
     return (0);
 }
 
+int
+LeaseCmdsImpl::leaseExportHandler(CalloutHandle& handle) {
+    bool v4 = true;
+    try {
+        extractCommand(handle);
+        v4 = (cmd_name_ == "lease4-export");
+
+        if (!cmd_args_) {
+            isc_throw(isc::BadValue, "no parameters specified for the command");
+        }
+
+        ConstElementPtr file = cmd_args_->get("filename");
+        if (!file) {
+            isc_throw(BadValue, "'filename' parameter not specified");
+        }
+        if (file->getType() != Element::string) {
+            isc_throw(BadValue, "'filename' parameter must be a string");
+        }
+        string filename = file->stringValue();
+        if (filename.empty()) {
+            isc_throw(BadValue, "'filename' parameter is empty");
+        }
+
+        LeaseExport::Format format = LeaseExport::CSV;
+        ConstElementPtr format_elem = cmd_args_->get("format");
+        if (format_elem) {
+            if (format_elem->getType() != Element::string) {
+                isc_throw(BadValue, "'format' parameter must be a string");
+            }
+            format = LeaseExport::stringToFormat(format_elem->stringValue());
+        }
+
+        size_t page_size = 1000;
+        ConstElementPtr page_size_elem = cmd_args_->get("page-size");
+        if (page_size_elem) {
+            if (page_size_elem->getType() != Element::integer) {
+                isc_throw(BadValue, "'page-size' parameter must be a number");
+            }
+            int64_t value = page_size_elem->intValue();
+            if ((value <= 0) || (value > numeric_limits<uint32_t>::max())) {
+                isc_throw(BadValue, "'page-size' parameter must be between 1"
+                          " and " << numeric_limits<uint32_t>::max());
+            }
+            page_size = static_cast<size_t>(value);
+        }
+
+        if (LeaseExportPtr last = LeaseExportMgr::getLast()) {
+            if (last->getState() == LeaseExport::RUNNING) {
+                isc_throw(InvalidOperation, "a lease export is already running");
+            }
+        }
+        LeaseExportPtr lease_export(new LeaseExport(v4, filename, format,
+                                                    page_size));
+        LeaseExportMgr::start(lease_export);
+
+        LOG_INFO(lease_cmds_logger, LEASE_CMDS_EXPORT_STARTED)
+            .arg(filename)
+            .arg(LeaseExport::formatToString(format));
+
+        ostringstream s;
+        s << (v4 ? "IPv4" : "IPv6")
+          << " lease database export into '"
+          << filename << "' started.";
+        ConstElementPtr response = createAnswer(CONTROL_RESULT_SUCCESS, s.str());
+        setResponse(handle, response);
+    } catch (const std::exception& ex) {
+        setErrorResponse(handle, ex.what());
+        return (CONTROL_RESULT_ERROR);
+    }
+
+    return (0);
+}
+
+int
+LeaseCmdsImpl::leaseExportStatusHandler(CalloutHandle& handle) {
+    try {
+        extractCommand(handle);
+
+        ConstElementPtr response;
+        LeaseExportPtr last = LeaseExportMgr::getLast();
+        if (!last) {
+            response = createAnswer(CONTROL_RESULT_EMPTY, "no lease export");
+        } else {
+            response = createAnswer(CONTROL_RESULT_SUCCESS,
+                                    "lease export status", last->toElement());
+        }
+        setResponse(handle, response);
+    } catch (const std::exception& ex) {
+        setErrorResponse(handle, ex.what());
+        return (CONTROL_RESULT_ERROR);
+    }
+
+    return (0);
+}
+
 int
 LeaseCmds::leaseAddHandler(CalloutHandle& handle) {
     return (impl_->leaseAddHandler(handle));
@@ -2380,6 +3114,11 @@ LeaseCmds::lease6BulkApplyHandler(CalloutHandle& handle) {
     return (impl_->lease6BulkApplyHandler(handle));
 }
 
+int
+LeaseCmds::lease4BulkApplyHandler(CalloutHandle& handle) {
+    return (impl_->lease4BulkApplyHandler(handle));
+}
+
 int
 LeaseCmds::leaseGetHandler(CalloutHandle& handle) {
     return (impl_->leaseGetHandler(handle));
@@ -2462,6 +3201,16 @@ LeaseCmds::leaseWriteHandler(CalloutHandle& handle) {
     return (impl_->leaseWriteHandler(handle));
 }
 
+int
+LeaseCmds::leaseExportHandler(CalloutHandle& handle) {
+    return (impl_->leaseExportHandler(handle));
+}
+
+int
+LeaseCmds::leaseExportStatusHandler(CalloutHandle& handle) {
+    return (impl_->leaseExportStatusHandler(handle));
+}
+
 LeaseCmds::LeaseCmds()
     :impl_(new LeaseCmdsImpl()) {
 }
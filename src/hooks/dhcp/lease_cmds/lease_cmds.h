@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -166,6 +166,47 @@ public:
     int
     lease6BulkApplyHandler(hooks::CalloutHandle& handle);
 
+    /// @brief lease4-bulk-apply command handler
+    ///
+    /// This command is the DHCPv4 counterpart of the lease6-bulk-apply
+    /// command. It conveys information about multiple IPv4 leases to be
+    /// added, updated or deleted. The High Availability hook library uses it
+    /// to send the lease updates for several DHCPv4 queries at once.
+    ///
+    /// @note Unlike lease4-del, this command does not support "update-ddns" and
+    /// this will not generate CHG_REMOVEs for deleted leases.
+    ///
+    /// Example structure of the command:
+    ///
+    /// {
+    ///     "command": "lease4-bulk-apply",
+    ///     "arguments": {
+    ///         "deleted-leases": [
+    ///             {
+    ///                 "ip-address": "192.0.2.1",
+    ///                 ...
+    ///             }
+    ///         ],
+    ///         "leases": [
+    ///             {
+    ///                 "subnet-id": 44,
+    ///                 "ip-address": "192.0.2.2",
+    ///                 "hw-address": "1a:1b:1c:1d:1e:1f",
+    ///                 ...
+    ///             }
+    ///         ]
+    ///     }
+    /// }
+    ///
+    /// The response has the same format as the lease6-bulk-apply response.
+    /// The failed leases are identified by their addresses.
+    ///
+    /// @param handle Callout context - which is expected to contain the
+    /// add command JSON text in the "command" argument
+    /// @return result of the operation
+    int
+    lease4BulkApplyHandler(hooks::CalloutHandle& handle);
+
     /// @brief lease4-get, lease6-get command handler
     ///
     /// This command attempts to retrieve a lease that match selected criteria.
@@ -605,6 +646,53 @@ public:
     int
     leaseWriteHandler(hooks::CalloutHandle& handle);
 
+    /// @brief lease4-export handler, lease6-export handler
+    ///
+    /// This command starts an export of the lease database into a file.
+    /// The leases are fetched page by page from the lease database backend
+    /// in the background, so the command returns before the file is
+    /// written: the lease-export-status command reports the end of the
+    /// export. Only one export may run at a time.
+    /// It extracts the command name and arguments from the given Callouthandle,
+    /// attempts to process them, and then set's the handle's "response"
+    /// argument accordingly.
+    ///
+    /// Example command:
+    /// {
+    ///     "command": "lease4-export",
+    ///     "arguments": {
+    ///         "filename": "leases.json",
+    ///         "format": "json",
+    ///         "page-size": 1000
+    ///     }
+    /// }";
+    ///
+    /// The format is "csv" (default) or "json" (one lease per line).
+    ///
+    /// @param handle Callout context - which is expected to contain the
+    /// export command JSON text in the "command" argument
+    /// @return result of the operation
+    int
+    leaseExportHandler(hooks::CalloutHandle& handle);
+
+    /// @brief lease-export-status handler
+    ///
+    /// This command returns the status of the running or last finished
+    /// lease export: the file name, the format, the state ("running",
+    /// "completed" or "failed"), the number of exported leases and the
+    /// error of a failed export.
+    ///
+    /// Example command:
+    /// {
+    ///     "command": "lease-export-status"
+    /// }";
+    ///
+    /// @param handle Callout context - which is expected to contain the
+    /// lease-export-status command JSON text in the "command" argument
+    /// @return result of the operation
+    int
+    leaseExportStatusHandler(hooks::CalloutHandle& handle);
+
 private:
     /// Pointer to the actual implementation
     boost::shared_ptr<LeaseCmdsImpl> impl_;
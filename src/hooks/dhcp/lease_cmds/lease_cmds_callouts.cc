@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,6 +12,7 @@
 
 #include <lease_cmds.h>
 #include <lease_cmds_log.h>
+#include <lease_export.h>
 #include <cc/command_interpreter.h>
 #include <dhcpsrv/cfgmgr.h>
 #include <hooks/hooks.h>
@@ -48,6 +49,17 @@ int lease6_add(CalloutHandle& handle) {
     return(lease_cmds.leaseAddHandler(handle));
 }
 
+/// @brief This is a command callout for 'lease4-bulk-apply' command.
+///
+/// @param handle Callout handle used to retrieve a command and
+/// provide a response.
+/// @return 0 if this callout has been invoked successfully,
+/// 1 otherwise.
+int lease4_bulk_apply(CalloutHandle& handle) {
+    LeaseCmds lease_cmds;
+    return (lease_cmds.lease4BulkApplyHandler(handle));
+}
+
 /// @brief This is a command callout for 'lease6-bulk-apply' command.
 ///
 /// @param handle Callout handle used to retrieve a command and
@@ -290,6 +302,39 @@ int lease6_write(CalloutHandle& handle) {
     return(lease_cmds.leaseWriteHandler(handle));
 }
 
+/// @brief This is a command callout for 'lease4-export' command.
+///
+/// @param handle Callout handle used to retrieve a command and
+/// provide a response.
+/// @return 0 if this callout has been invoked successfully,
+/// 1 otherwise.
+int lease4_export(CalloutHandle& handle) {
+    LeaseCmds lease_cmds;
+    return(lease_cmds.leaseExportHandler(handle));
+}
+
+/// @brief This is a command callout for 'lease6-export' command.
+///
+/// @param handle Callout handle used to retrieve a command and
+/// provide a response.
+/// @return 0 if this callout has been invoked successfully,
+/// 1 otherwise.
+int lease6_export(CalloutHandle& handle) {
+    LeaseCmds lease_cmds;
+    return(lease_cmds.leaseExportHandler(handle));
+}
+
+/// @brief This is a command callout for 'lease-export-status' command.
+///
+/// @param handle Callout handle used to retrieve a command and
+/// provide a response.
+/// @return 0 if this callout has been invoked successfully,
+/// 1 otherwise.
+int lease_export_status(CalloutHandle& handle) {
+    LeaseCmds lease_cmds;
+    return(lease_cmds.leaseExportStatusHandler(handle));
+}
+
 /// @brief This function is called when the library is loaded.
 ///
 /// @param handle library handle
@@ -312,6 +357,7 @@ int load(LibraryHandle& handle) {
 
     handle.registerCommandCallout("lease4-add", lease4_add);
     handle.registerCommandCallout("lease6-add", lease6_add);
+    handle.registerCommandCallout("lease4-bulk-apply", lease4_bulk_apply);
     handle.registerCommandCallout("lease6-bulk-apply", lease6_bulk_apply);
     handle.registerCommandCallout("lease4-get", lease4_get);
     handle.registerCommandCallout("lease6-get", lease6_get);
@@ -338,6 +384,9 @@ int load(LibraryHandle& handle) {
     handle.registerCommandCallout("lease6-resend-ddns", lease6_resend_ddns);
     handle.registerCommandCallout("lease4-write", lease4_write);
     handle.registerCommandCallout("lease6-write", lease6_write);
+    handle.registerCommandCallout("lease4-export", lease4_export);
+    handle.registerCommandCallout("lease6-export", lease6_export);
+    handle.registerCommandCallout("lease-export-status", lease_export_status);
 
     LOG_INFO(lease_cmds_logger, LEASE_CMDS_INIT_OK);
     return (0);
@@ -347,6 +396,8 @@ int load(LibraryHandle& handle) {
 ///
 /// @return 0 if deregistration was successful, 1 otherwise
 int unload() {
+    // The export timer must not run the library code after its unload.
+    LeaseExportMgr::cancel();
     LOG_INFO(lease_cmds_logger, LEASE_CMDS_DEINIT_OK);
     return (0);
 }
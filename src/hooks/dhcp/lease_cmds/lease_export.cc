@@ -0,0 +1,261 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/interval_timer.h>
+#include <dhcpsrv/lease_mgr.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/timer_mgr.h>
+#include <exceptions/exceptions.h>
+#include <lease_cmds_log.h>
+#include <lease_export.h>
+
+#include <cstdio>
+#include <sstream>
+
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace std;
+
+namespace {
+
+/// @brief Interval between two pages in milliseconds.
+const long EXPORT_INTERVAL = 1;
+
+/// @brief The running or last finished export.
+isc::lease_cmds::LeaseExportPtr last_export;
+
+/// @brief The mutex protecting the last export.
+std::mutex last_export_mutex;
+
+}
+
+namespace isc {
+namespace lease_cmds {
+
+const string LeaseExportMgr::TIMER_NAME = "LeaseExport";
+
+LeaseExport::Format
+LeaseExport::stringToFormat(const string& format) {
+    if (format == "csv") {
+        return (CSV);
+    } else if (format == "json") {
+        return (JSON);
+    }
+    isc_throw(BadValue, "unsupported export format '" << format
+              << "', expected csv or json");
+}
+
+string
+LeaseExport::formatToString(Format format) {
+    return (format == CSV ? "csv" : "json");
+}
+
+LeaseExport::LeaseExport(bool v4, const string& filename, Format format,
+                         size_t page_size)
+    : v4_(v4), filename_(filename), tmp_filename_(filename + ".tmp"),
+      format_(format), page_size_(page_size),
+      lower_bound_(v4 ? IOAddress::IPV4_ZERO_ADDRESS() :
+                   IOAddress::IPV6_ZERO_ADDRESS()),
+      csv4_(), csv6_(), json_(), count_(0), state_(RUNNING), error_(),
+      mutex_() {
+    if (page_size_ == 0) {
+        isc_throw(BadValue, "page size of the lease export must be positive");
+    }
+    try {
+        if (format_ == JSON) {
+            json_.open(tmp_filename_.c_str(), ios::out | ios::trunc);
+            if (!json_.is_open()) {
+                isc_throw(BadValue, "unable to open '" << tmp_filename_ << "'");
+            }
+        } else if (v4_) {
+            csv4_.reset(new CSVLeaseFile4(tmp_filename_));
+            csv4_->recreate();
+        } else {
+            csv6_.reset(new CSVLeaseFile6(tmp_filename_));
+            csv6_->recreate();
+        }
+    } catch (const BadValue&) {
+        throw;
+    } catch (const std::exception& ex) {
+        isc_throw(BadValue, ex.what());
+    }
+}
+
+LeaseExport::~LeaseExport() {
+    lock_guard<mutex> lock(mutex_);
+    if (state_ == RUNNING) {
+        finish(FAILED, "export cancelled");
+    }
+}
+
+bool
+LeaseExport::exportPage() {
+    lock_guard<mutex> lock(mutex_);
+    if (state_ != RUNNING) {
+        return (false);
+    }
+    try {
+        if (writePage() < page_size_) {
+            finish(COMPLETED, "");
+            if (::rename(tmp_filename_.c_str(), filename_.c_str()) != 0) {
+                state_ = FAILED;
+                error_ = "unable to rename '" + tmp_filename_ + "' to '" +
+                    filename_ + "'";
+                ::remove(tmp_filename_.c_str());
+            }
+        }
+    } catch (const std::exception& ex) {
+        finish(FAILED, ex.what());
+    }
+    return (state_ == RUNNING);
+}
+
+size_t
+LeaseExport::writePage() {
+    LeasePageSize page_size(page_size_);
+    size_t written = 0;
+    if (v4_) {
+        Lease4Collection leases =
+            LeaseMgrFactory::instance().getLeases4(lower_bound_, page_size);
+        for (auto const& lease : leases) {
+            if (csv4_) {
+                csv4_->append(*lease);
+            } else {
+                json_ << lease->toElement()->str() << "\n";
+            }
+            lower_bound_ = lease->addr_;
+            ++written;
+        }
+    } else {
+        Lease6Collection leases =
+            LeaseMgrFactory::instance().getLeases6(lower_bound_, page_size);
+        for (auto const& lease : leases) {
+            if (csv6_) {
+                csv6_->append(*lease);
+            } else {
+                json_ << lease->toElement()->str() << "\n";
+            }
+            lower_bound_ = lease->addr_;
+            ++written;
+        }
+    }
+    if (json_.is_open() && !json_.good()) {
+        isc_throw(Unexpected, "unable to write into '" << tmp_filename_ << "'");
+    }
+    count_ += written;
+    return (written);
+}
+
+void
+LeaseExport::finish(State state, const string& error) {
+    state_ = state;
+    error_ = error;
+    if (csv4_) {
+        csv4_->close();
+    }
+    if (csv6_) {
+        csv6_->close();
+    }
+    if (json_.is_open()) {
+        json_.close();
+        if (json_.fail() && (state_ == COMPLETED)) {
+            state_ = FAILED;
+            error_ = "unable to write into '" + tmp_filename_ + "'";
+        }
+    }
+    if (state_ != COMPLETED) {
+        ::remove(tmp_filename_.c_str());
+    }
+}
+
+LeaseExport::State
+LeaseExport::getState() const {
+    lock_guard<mutex> lock(mutex_);
+    return (state_);
+}
+
+ElementPtr
+LeaseExport::toElement() const {
+    lock_guard<mutex> lock(mutex_);
+    ElementPtr status = Element::createMap();
+    status->set("filename", Element::create(filename_));
+    status->set("format", Element::create(formatToString(format_)));
+    status->set("leases", Element::create(static_cast<int64_t>(count_)));
+    switch (state_) {
+    case RUNNING:
+        status->set("state", Element::create("running"));
+        break;
+    case COMPLETED:
+        status->set("state", Element::create("completed"));
+        break;
+    default:
+        status->set("state", Element::create("failed"));
+        status->set("error", Element::create(error_));
+    }
+    return (status);
+}
+
+void
+LeaseExportMgr::start(const LeaseExportPtr& lease_export) {
+    {
+        lock_guard<mutex> lock(last_export_mutex);
+        if (last_export && (last_export->getState() == LeaseExport::RUNNING)) {
+            isc_throw(InvalidOperation, "a lease export is already running");
+        }
+        last_export = lease_export;
+    }
+    const TimerMgrPtr& timer_mgr = TimerMgr::instance();
+    if (!timer_mgr->isTimerRegistered(TIMER_NAME)) {
+        timer_mgr->registerTimer(TIMER_NAME, &LeaseExportMgr::run,
+                                 EXPORT_INTERVAL, IntervalTimer::ONE_SHOT);
+    }
+    timer_mgr->setup(TIMER_NAME);
+}
+
+void
+LeaseExportMgr::cancel() {
+    const TimerMgrPtr& timer_mgr = TimerMgr::instance();
+    if (timer_mgr->isTimerRegistered(TIMER_NAME)) {
+        timer_mgr->unregisterTimer(TIMER_NAME);
+    }
+    lock_guard<mutex> lock(last_export_mutex);
+    last_export.reset();
+}
+
+LeaseExportPtr
+LeaseExportMgr::getLast() {
+    lock_guard<mutex> lock(last_export_mutex);
+    return (last_export);
+}
+
+void
+LeaseExportMgr::run() {
+    LeaseExportPtr lease_export = getLast();
+    if (!lease_export) {
+        return;
+    }
+    if (lease_export->exportPage()) {
+        TimerMgr::instance()->setup(TIMER_NAME);
+        return;
+    }
+    ConstElementPtr status = lease_export->toElement();
+    if (lease_export->getState() == LeaseExport::COMPLETED) {
+        LOG_INFO(lease_cmds_logger, LEASE_CMDS_EXPORT_COMPLETED)
+            .arg(status->get("filename")->stringValue())
+            .arg(status->get("leases")->intValue());
+    } else {
+        LOG_ERROR(lease_cmds_logger, LEASE_CMDS_EXPORT_FAILED)
+            .arg(status->get("filename")->stringValue())
+            .arg(status->get("leases")->intValue())
+            .arg(status->get("error")->stringValue());
+    }
+}
+
+} // end of namespace isc::lease_cmds
+} // end of namespace isc
@@ -0,0 +1,185 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_EXPORT_H
+#define LEASE_EXPORT_H
+
+#include <asiolink/io_address.h>
+#include <cc/data.h>
+#include <dhcpsrv/csv_lease_file4.h>
+#include <dhcpsrv/csv_lease_file6.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace isc {
+namespace lease_cmds {
+
+/// @brief Export of the lease database into a file.
+///
+/// The leases are fetched page by page from the lease database backend
+/// and written into a temporary file which is renamed to the export
+/// file when all the leases were written. The leases added or updated
+/// during the export may or may not be included.
+class LeaseExport : public boost::noncopyable {
+public:
+
+    /// @brief Formats of the export file.
+    enum Format {
+        CSV,    ///< The memfile lease file format.
+        JSON    ///< One JSON lease map per line.
+    };
+
+    /// @brief States of the export.
+    enum State {
+        RUNNING,
+        COMPLETED,
+        FAILED
+    };
+
+    /// @brief Converts a format name.
+    ///
+    /// @param format The format name: "csv" or "json".
+    /// @return The format.
+    /// @throw BadValue if the name is not a format name.
+    static Format stringToFormat(const std::string& format);
+
+    /// @brief Returns the name of a format.
+    ///
+    /// @param format The format.
+    /// @return The format name.
+    static std::string formatToString(Format format);
+
+    /// @brief Constructor.
+    ///
+    /// Creates the temporary file.
+    ///
+    /// @param v4 true to export the IPv4 leases, false for the IPv6 ones.
+    /// @param filename The path of the export file.
+    /// @param format The format of the export file.
+    /// @param page_size The number of leases fetched at once.
+    /// @throw BadValue if the page size is 0 or if the temporary file
+    /// can't be created.
+    LeaseExport(bool v4, const std::string& filename, Format format,
+                size_t page_size);
+
+    /// @brief Destructor.
+    ///
+    /// Removes the temporary file of an unfinished export.
+    ~LeaseExport();
+
+    /// @brief Exports the next page of leases.
+    ///
+    /// The temporary file is renamed when the last page was exported.
+    /// The export fails when an error occurs.
+    ///
+    /// @return true if the export is still running.
+    bool exportPage();
+
+    /// @brief Returns the state of the export.
+    State getState() const;
+
+    /// @brief Returns the status of the export.
+    ///
+    /// @return A map with the file name, the format, the state, the
+    /// number of exported leases and the error of a failed export.
+    data::ElementPtr toElement() const;
+
+private:
+
+    /// @brief Writes the next page of leases.
+    ///
+    /// @return The number of written leases.
+    size_t writePage();
+
+    /// @brief Ends the export, closing and removing the temporary file.
+    ///
+    /// @param state The final state.
+    /// @param error The error of a failed export.
+    void finish(State state, const std::string& error);
+
+    /// @brief Lease family.
+    bool v4_;
+
+    /// @brief The path of the export file.
+    std::string filename_;
+
+    /// @brief The path of the temporary file.
+    std::string tmp_filename_;
+
+    /// @brief The format of the export file.
+    Format format_;
+
+    /// @brief The number of leases fetched at once.
+    size_t page_size_;
+
+    /// @brief The address after which the next page begins.
+    asiolink::IOAddress lower_bound_;
+
+    /// @brief The temporary file in the CSV format of IPv4 leases.
+    boost::scoped_ptr<dhcp::CSVLeaseFile4> csv4_;
+
+    /// @brief The temporary file in the CSV format of IPv6 leases.
+    boost::scoped_ptr<dhcp::CSVLeaseFile6> csv6_;
+
+    /// @brief The temporary file in the JSON format.
+    std::ofstream json_;
+
+    /// @brief The number of exported leases.
+    size_t count_;
+
+    /// @brief The state of the export.
+    State state_;
+
+    /// @brief The error of a failed export.
+    std::string error_;
+
+    /// @brief The mutex protecting the state.
+    mutable std::mutex mutex_;
+};
+
+/// @brief Type of pointers to lease exports.
+typedef boost::shared_ptr<LeaseExport> LeaseExportPtr;
+
+/// @brief Runs the lease exports in the background.
+///
+/// One page is exported by each run of a one shot timer of the timer
+/// manager, so the packet processing goes on between two pages. Only
+/// one export may run at a time.
+class LeaseExportMgr {
+public:
+
+    /// @brief Name of the timer running the exports.
+    static const std::string TIMER_NAME;
+
+    /// @brief Starts an export.
+    ///
+    /// @param lease_export The export.
+    /// @throw InvalidOperation if an export is running.
+    static void start(const LeaseExportPtr& lease_export);
+
+    /// @brief Cancels the running export and unregisters the timer.
+    static void cancel();
+
+    /// @brief Returns the last export.
+    ///
+    /// @return The running or last finished export, null if none.
+    static LeaseExportPtr getLast();
+
+private:
+
+    /// @brief Exports a page of the running export.
+    static void run();
+};
+
+} // end of namespace isc::lease_cmds
+} // end of namespace isc
+
+#endif // LEASE_EXPORT_H
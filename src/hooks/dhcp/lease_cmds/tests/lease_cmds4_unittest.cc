@@ -14,6 +14,7 @@
 #include <dhcpsrv/ncr_generator.h>
 #include <dhcpsrv/cfgmgr.h>
 #include <dhcpsrv/resource_handler.h>
+#include <dhcpsrv/timer_mgr.h>
 #include <cc/command_interpreter.h>
 #include <cc/data.h>
 #include <lease_cmds_unittest.h>
@@ -24,6 +25,7 @@
 #include <gtest/gtest.h>
 
 #include <errno.h>
+#include <fstream>
 #include <set>
 
 using namespace std;
@@ -240,6 +242,13 @@ public:
     /// @brief Verifies that limit is mandatory.
     void testLease4GetPagedNoLimit();
 
+    /// @brief Check that lease4-get-page returns the leases matching
+    /// the filters.
+    void testLease4GetPagedFilter();
+
+    /// @brief Verifies that invalid filters are rejected.
+    void testLease4GetPagedInvalidFilter();
+
     /// @brief Verifies that the limit must be a number.
     void testLease4GetPagedLimitNotNumber();
 
@@ -368,6 +377,18 @@ public:
     /// identifier.
     void testLease4DelByClientId();
 
+    /// @brief This test verifies that it is possible to add two leases and
+    /// delete two leases as a result of the single lease4-bulk-apply command.
+    void testLease4BulkApply();
+
+    /// @brief This test verifies that deleting non existing leases with the
+    /// lease4-bulk-apply returns an 'empty' result.
+    void testLease4BulkApplyDeleteNonExisting();
+
+    /// @brief Check that changes for other leases are not applied if one of the
+    /// leases is malformed.
+    void testLease4BulkApplyRollback();
+
     /// @brief Check that lease4-wipe can remove leases.
     void testLease4Wipe();
 
@@ -433,6 +454,9 @@ public:
 
     /// @brief Check that lease4-write works as expected.
     void testLease4Write();
+
+    /// @brief Check that lease4-export works as expected.
+    void testLease4Export();
 };
 
 void Lease4CmdsTest::testLease4AddMissingParams() {
@@ -1587,6 +1611,95 @@ void Lease4CmdsTest::testLease4GetPagedNoLimit() {
     testCommand(cmd, CONTROL_RESULT_ERROR, exp_rsp);
 }
 
+void Lease4CmdsTest::testLease4GetPagedFilter() {
+    // Initialize lease manager (false = v4, true = add leases)
+    initLeaseMgr(false, true);
+
+    // Query for a page of leases of the subnet 88.
+    string cmd =
+        "{\n"
+        "    \"command\": \"lease4-get-page\",\n"
+        "    \"arguments\": {"
+        "        \"from\": \"start\","
+        "        \"limit\": 10,"
+        "        \"subnet-id\": 88"
+        "    }"
+        "}";
+
+    string exp_rsp = "2 IPv4 lease(s) found.";
+    ConstElementPtr rsp = testCommand(cmd, CONTROL_RESULT_SUCCESS, exp_rsp);
+    ASSERT_TRUE(rsp);
+    ConstElementPtr args = rsp->get("arguments");
+    ASSERT_TRUE(args);
+    ConstElementPtr leases = args->get("leases");
+    ASSERT_TRUE(leases);
+    ASSERT_EQ(Element::list, leases->getType());
+    ASSERT_EQ(2, leases->size());
+    checkLease4(leases, "192.0.3.1", 88, "08:08:08:08:08:08", true);
+    checkLease4(leases, "192.0.3.2", 88, "09:09:09:09:09:09", true);
+
+    // Continue after the first lease of the subnet.
+    cmd =
+        "{\n"
+        "    \"command\": \"lease4-get-page\",\n"
+        "    \"arguments\": {"
+        "        \"from\": \"192.0.3.1\","
+        "        \"limit\": 10,"
+        "        \"subnet-id\": 88"
+        "    }"
+        "}";
+
+    exp_rsp = "1 IPv4 lease(s) found.";
+    testCommand(cmd, CONTROL_RESULT_SUCCESS, exp_rsp);
+
+    // No lease is declined.
+    cmd =
+        "{\n"
+        "    \"command\": \"lease4-get-page\",\n"
+        "    \"arguments\": {"
+        "        \"from\": \"start\","
+        "        \"limit\": 10,"
+        "        \"state\": 1"
+        "    }"
+        "}";
+
+    exp_rsp = "0 IPv4 lease(s) found.";
+    testCommand(cmd, CONTROL_RESULT_EMPTY, exp_rsp);
+}
+
+void Lease4CmdsTest::testLease4GetPagedInvalidFilter() {
+    // Initialize lease manager (false = v4, true = add leases)
+    initLeaseMgr(false, true);
+
+    // The subnet identifier must be positive.
+    string cmd =
+        "{\n"
+        "    \"command\": \"lease4-get-page\",\n"
+        "    \"arguments\": {"
+        "        \"from\": \"start\","
+        "        \"limit\": 2,"
+        "        \"subnet-id\": 0"
+        "    }"
+        "}";
+
+    string exp_rsp = "'subnet-id' parameter must be a positive 32 bit number";
+    testCommand(cmd, CONTROL_RESULT_ERROR, exp_rsp);
+
+    // The client class must be a string.
+    cmd =
+        "{\n"
+        "    \"command\": \"lease4-get-page\",\n"
+        "    \"arguments\": {"
+        "        \"from\": \"start\","
+        "        \"limit\": 2,"
+        "        \"client-class\": 1"
+        "    }"
+        "}";
+
+    exp_rsp = "'client-class' parameter must be a non-empty string";
+    testCommand(cmd, CONTROL_RESULT_ERROR, exp_rsp);
+}
+
 void Lease4CmdsTest::testLease4GetPagedLimitNotNumber() {
     // Initialize lease manager (false = v6, true = add leases)
     initLeaseMgr(false, true);
@@ -2701,6 +2814,157 @@ void Lease4CmdsTest::testLease4DelByClientId() {
     EXPECT_FALSE(lmptr_->getLease4(IOAddress("192.0.2.1")));
 }
 
+void Lease4CmdsTest::testLease4BulkApply() {
+    // Initialize lease manager (false = v4, true = add leases)
+    initLeaseMgr(false, true);
+
+    checkLease4Stats(44, 2, 0);
+
+    checkLease4Stats(88, 2, 0);
+
+    // Now send the command.
+    string cmd =
+        "{\n"
+        "    \"command\": \"lease4-bulk-apply\",\n"
+        "    \"arguments\": {"
+        "        \"deleted-leases\": ["
+        "            {"
+        "                \"ip-address\": \"192.0.2.1\""
+        "            },"
+        "            {"
+        "                \"ip-address\": \"192.0.2.2\""
+        "            }"
+        "        ],"
+        "        \"leases\": ["
+        "            {"
+        "                \"subnet-id\": 44,\n"
+        "                \"ip-address\": \"192.0.2.202\",\n"
+        "                \"hw-address\": \"1a:1b:1c:1d:1e:1f\"\n"
+        "            },"
+        "            {"
+        "                \"subnet-id\": 88,\n"
+        "                \"ip-address\": \"192.0.3.202\",\n"
+        "                \"hw-address\": \"2a:2b:2c:2d:2e:2f\"\n"
+        "            }"
+        "        ]"
+        "    }"
+        "}";
+    string exp_rsp = "Bulk apply of 4 IPv4 leases completed.";
+
+    // The status expected is success.
+    testCommand(cmd, CONTROL_RESULT_SUCCESS, exp_rsp);
+
+    checkLease4Stats(44, 1, 0);
+
+    checkLease4Stats(88, 3, 0);
+
+    //  Check that the leases we inserted are stored.
+    EXPECT_TRUE(lmptr_->getLease4(IOAddress("192.0.2.202")));
+    EXPECT_TRUE(lmptr_->getLease4(IOAddress("192.0.3.202")));
+
+    // Check that the leases we deleted are gone,
+    EXPECT_FALSE(lmptr_->getLease4(IOAddress("192.0.2.1")));
+    EXPECT_FALSE(lmptr_->getLease4(IOAddress("192.0.2.2")));
+}
+
+void Lease4CmdsTest::testLease4BulkApplyDeleteNonExisting() {
+    // Initialize lease manager (false = v4, true = add leases)
+    initLeaseMgr(false, true);
+
+    // Now send the command.
+    string cmd =
+        "{\n"
+        "    \"command\": \"lease4-bulk-apply\",\n"
+        "    \"arguments\": {"
+        "        \"deleted-leases\": ["
+        "            {"
+        "                \"ip-address\": \"192.0.2.123\""
+        "            },"
+        "            {"
+        "                \"ip-address\": \"192.0.2.234\""
+        "            }"
+        "        ]"
+        "    }"
+        "}";
+    string exp_rsp = "Bulk apply of 0 IPv4 leases completed.";
+
+    // The status expected is empty.
+    auto resp = testCommand(cmd, CONTROL_RESULT_EMPTY, exp_rsp);
+    ASSERT_TRUE(resp);
+    ASSERT_EQ(Element::map, resp->getType());
+
+    checkLease4Stats(44, 2, 0);
+
+    checkLease4Stats(88, 2, 0);
+
+    auto args = resp->get("arguments");
+    ASSERT_TRUE(args);
+    ASSERT_EQ(Element::map, args->getType());
+
+    auto failed_deleted_leases = args->get("failed-deleted-leases");
+    ASSERT_TRUE(failed_deleted_leases);
+    ASSERT_EQ(Element::list, failed_deleted_leases->getType());
+    ASSERT_EQ(2, failed_deleted_leases->size());
+
+    {
+        SCOPED_TRACE("lease address 192.0.2.123");
+        checkFailedLease(failed_deleted_leases, "V4", "192.0.2.123",
+                         CONTROL_RESULT_EMPTY, "lease not found");
+    }
+
+    {
+        SCOPED_TRACE("lease address 192.0.2.234");
+        checkFailedLease(failed_deleted_leases, "V4", "192.0.2.234",
+                         CONTROL_RESULT_EMPTY, "lease not found");
+    }
+}
+
+void Lease4CmdsTest::testLease4BulkApplyRollback() {
+    // Initialize lease manager (false = v4, true = add leases)
+    initLeaseMgr(false, true);
+
+    checkLease4Stats(44, 2, 0);
+
+    checkLease4Stats(88, 2, 0);
+
+    // Now send the command.
+    string cmd =
+        "{\n"
+        "    \"command\": \"lease4-bulk-apply\",\n"
+        "    \"arguments\": {"
+        "        \"deleted-leases\": ["
+        "            {"
+        "                \"ip-address\": \"192.0.2.1\""
+        "            }"
+        "        ],"
+        "        \"leases\": ["
+        "            {"
+        "                \"subnet-id\": 44,\n"
+        "                \"ip-address\": \"192.0.2.202\","
+        "                \"hw-address\": \"1a:1b:1c:1d:1e:1f\""
+        "            },"
+        "            {"
+        "                \"subnet-id\": -1,"
+        "                \"ip-address\": \"192.0.3.202\","
+        "                \"hw-address\": \"2a:2b:2c:2d:2e:2f\""
+        "            }"
+        "        ]"
+        "    }"
+        "}";
+    string exp_rsp = "out of range value (-1) specified for parameter 'subnet-id' (<string>:4:150)";
+
+    // The status expected is an error.
+    testCommand(cmd, CONTROL_RESULT_ERROR, exp_rsp);
+
+    checkLease4Stats(44, 2, 0);
+
+    checkLease4Stats(88, 2, 0);
+
+    EXPECT_TRUE(lmptr_->getLease4(IOAddress("192.0.2.1")));
+    EXPECT_FALSE(lmptr_->getLease4(IOAddress("192.0.2.202")));
+    EXPECT_FALSE(lmptr_->getLease4(IOAddress("192.0.3.202")));
+}
+
 void Lease4CmdsTest::testLease4Wipe() {
     // Initialize lease manager (false = v4, true = add leases)
     initLeaseMgr(false, true);
@@ -3332,6 +3596,113 @@ void Lease4CmdsTest::testLease4Write() {
     testCommand(txt, CONTROL_RESULT_ERROR, exp_rsp);
 }
 
+void Lease4CmdsTest::testLease4Export() {
+    // Initialize lease manager (false = v4, true = add leases)
+    initLeaseMgr(false, true);
+
+    // No export yet.
+    string status_txt =
+        "{\n"
+        "    \"command\": \"lease-export-status\"\n"
+        "}";
+    testCommand(status_txt, CONTROL_RESULT_EMPTY, "no lease export");
+
+    // Filename is missing.
+    string txt =
+        "{\n"
+        "    \"command\": \"lease4-export\",\n"
+        "    \"arguments\": {"
+        "    }\n"
+        "}";
+    string exp_rsp = "'filename' parameter not specified";
+    testCommand(txt, CONTROL_RESULT_ERROR, exp_rsp);
+
+    // Unknown format.
+    const string filename = "lease4-export-test.json";
+    txt =
+        "{\n"
+        "    \"command\": \"lease4-export\",\n"
+        "    \"arguments\": {"
+        "        \"filename\": \"" + filename + "\",\n"
+        "        \"format\": \"xml\"\n"
+        "    }\n"
+        "}";
+    exp_rsp = "unsupported export format 'xml', expected csv or json";
+    testCommand(txt, CONTROL_RESULT_ERROR, exp_rsp);
+
+    // Null page size.
+    txt =
+        "{\n"
+        "    \"command\": \"lease4-export\",\n"
+        "    \"arguments\": {"
+        "        \"filename\": \"" + filename + "\",\n"
+        "        \"page-size\": 0\n"
+        "    }\n"
+        "}";
+    exp_rsp = "'page-size' parameter must be between 1 and 4294967295";
+    testCommand(txt, CONTROL_RESULT_ERROR, exp_rsp);
+
+    // Export the leases one by one.
+    IOServicePtr io_service(new IOService());
+    TimerMgr::instance()->setIOService(io_service);
+    txt =
+        "{\n"
+        "    \"command\": \"lease4-export\",\n"
+        "    \"arguments\": {"
+        "        \"filename\": \"" + filename + "\",\n"
+        "        \"format\": \"json\",\n"
+        "        \"page-size\": 1\n"
+        "    }\n"
+        "}";
+    exp_rsp = "IPv4 lease database export into '" + filename + "' started.";
+    testCommand(txt, CONTROL_RESULT_SUCCESS, exp_rsp);
+
+    // Only one export runs at a time.
+    exp_rsp = "a lease export is already running";
+    testCommand(txt, CONTROL_RESULT_ERROR, exp_rsp);
+
+    ConstElementPtr rsp = testCommand(status_txt, CONTROL_RESULT_SUCCESS,
+                                      "lease export status");
+    ConstElementPtr args = rsp->get("arguments");
+    ASSERT_TRUE(args);
+    EXPECT_EQ("running", args->get("state")->stringValue());
+
+    // Run the export until its end: the 4 leases take 5 pages.
+    for (int i = 0; i < 100; ++i) {
+        io_service->run_one();
+        rsp = testCommand(status_txt, CONTROL_RESULT_SUCCESS,
+                          "lease export status");
+        args = rsp->get("arguments");
+        ASSERT_TRUE(args);
+        if (args->get("state")->stringValue() != "running") {
+            break;
+        }
+    }
+    EXPECT_EQ("completed", args->get("state")->stringValue());
+    EXPECT_EQ(filename, args->get("filename")->stringValue());
+    EXPECT_EQ("json", args->get("format")->stringValue());
+    EXPECT_EQ(4, args->get("leases")->intValue());
+
+    // Each line of the file is a lease.
+    ifstream file(filename.c_str());
+    ASSERT_TRUE(file.is_open());
+    string line;
+    size_t count = 0;
+    while (getline(file, line)) {
+        ConstElementPtr lease;
+        ASSERT_NO_THROW(lease = Element::fromJSON(line)) << line;
+        ASSERT_TRUE(lease);
+        EXPECT_TRUE(lease->get("ip-address"));
+        ++count;
+    }
+    EXPECT_EQ(4, count);
+    file.close();
+    static_cast<void>(remove(filename.c_str()));
+
+    TimerMgr::instance()->unregisterTimers();
+    TimerMgr::instance()->setIOService(IOServicePtr());
+}
+
 TEST_F(Lease4CmdsTest, lease4AddMissingParams) {
     testLease4AddMissingParams();
 }
@@ -3593,6 +3964,24 @@ TEST_F(Lease4CmdsTest, lease4GetPagedZeroAddressMultiThreading) {
     testLease4GetPagedZeroAddress();
 }
 
+TEST_F(Lease4CmdsTest, lease4GetPagedFilter) {
+    testLease4GetPagedFilter();
+}
+
+TEST_F(Lease4CmdsTest, lease4GetPagedFilterMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease4GetPagedFilter();
+}
+
+TEST_F(Lease4CmdsTest, lease4GetPagedInvalidFilter) {
+    testLease4GetPagedInvalidFilter();
+}
+
+TEST_F(Lease4CmdsTest, lease4GetPagedInvalidFilterMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease4GetPagedInvalidFilter();
+}
+
 TEST_F(Lease4CmdsTest, lease4GetPagedIPv6Address) {
     testLease4GetPagedIPv6Address();
 }
@@ -3908,6 +4297,33 @@ TEST_F(Lease4CmdsTest, lease4DelByClientIdMultiThreading) {
     testLease4DelByClientId();
 }
 
+TEST_F(Lease4CmdsTest, lease4BulkApply) {
+    testLease4BulkApply();
+}
+
+TEST_F(Lease4CmdsTest, lease4BulkApplyMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease4BulkApply();
+}
+
+TEST_F(Lease4CmdsTest, lease4BulkApplyDeleteNonExisting) {
+    testLease4BulkApplyDeleteNonExisting();
+}
+
+TEST_F(Lease4CmdsTest, lease4BulkApplyDeleteNonExistingMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease4BulkApplyDeleteNonExisting();
+}
+
+TEST_F(Lease4CmdsTest, lease4BulkApplyRollback) {
+    testLease4BulkApplyRollback();
+}
+
+TEST_F(Lease4CmdsTest, lease4BulkApplyRollbackMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease4BulkApplyRollback();
+}
+
 TEST_F(Lease4CmdsTest, lease4Wipe) {
     testLease4Wipe();
 }
@@ -4052,4 +4468,13 @@ TEST_F(Lease4CmdsTest, lease4WriteMultiThreading) {
     testLease4Write();
 }
 
+TEST_F(Lease4CmdsTest, lease4Export) {
+    testLease4Export();
+}
+
+TEST_F(Lease4CmdsTest, lease4ExportMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease4Export();
+}
+
 } // end of anonymous namespace
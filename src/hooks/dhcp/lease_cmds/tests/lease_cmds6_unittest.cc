@@ -248,6 +248,9 @@ public:
     /// @brief Verifies that limit is mandatory.
     void testLease6GetPagedNoLimit();
 
+    /// @brief Verifies that filters are rejected.
+    void testLease6GetPagedFilter();
+
     /// @brief Verifies that the limit must be a number.
     void testLease6GetPagedLimitNotNumber();
 
@@ -406,6 +409,10 @@ public:
     /// extended info with the lease6-bulk-apply.
     void testLease6BulkApplyUpdatesOnlyExtendedInfo();
 
+    /// @brief Check that lease6-bulk-apply applies many leases, including
+    /// leases listed more than once.
+    void testLease6BulkApplyMany();
+
     /// @brief This test verifies that it is possible to only delete leases with
     /// the lease6-bulk-apply.
     void testLease6BulkApplyDeletesOnly();
@@ -1679,6 +1686,25 @@ void Lease6CmdsTest::testLease6GetPagedNoLimit() {
     testCommand(cmd, CONTROL_RESULT_ERROR, exp_rsp);
 }
 
+void Lease6CmdsTest::testLease6GetPagedFilter() {
+    // Initialize lease manager (true = v6, true = add leases)
+    initLeaseMgr(true, true);
+
+    // Query for a page of leases of a subnet.
+    string cmd =
+        "{\n"
+        "    \"command\": \"lease6-get-page\",\n"
+        "    \"arguments\": {"
+        "        \"from\": \"start\","
+        "        \"limit\": 2,"
+        "        \"subnet-id\": 66"
+        "    }"
+        "}";
+
+    string exp_rsp = "filters are not supported by the lease6-get-page command";
+    testCommand(cmd, CONTROL_RESULT_ERROR, exp_rsp);
+}
+
 void Lease6CmdsTest::testLease6GetPagedLimitNotNumber() {
     // Initialize lease manager (true = v6, true = add leases)
     initLeaseMgr(true, true);
@@ -3283,6 +3309,67 @@ void Lease6CmdsTest::testLease6BulkApplyUpdatesOnlyExtendedInfo() {
     EXPECT_EQ(*lease2, *lx);
 }
 
+void Lease6CmdsTest::testLease6BulkApplyMany() {
+    // Initialize lease manager (true = v6, true = add leases)
+    initLeaseMgr(true, true);
+
+    checkLease6Stats(66, 2, 0, 0);
+
+    // Build enough new leases to be parsed by several threads, an update
+    // of an existing lease and a second update of a new lease.
+    const size_t count = 600;
+    ostringstream leases;
+    for (size_t i = 0; i < count; ++i) {
+        leases << "            {"
+               << "                \"subnet-id\": 66,\n"
+               << "                \"ip-address\": \"2001:db8:1::"
+               << hex << (0x1000 + i) << dec << "\",\n"
+               << "                \"duid\": \"11:11:11:11:11:11\",\n"
+               << "                \"iaid\": " << i << "\n"
+               << "            },";
+    }
+    leases << "            {"
+           << "                \"subnet-id\": 66,\n"
+           << "                \"ip-address\": \"2001:db8:1::1\",\n"
+           << "                \"duid\": \"11:11:11:11:11:11\",\n"
+           << "                \"iaid\": 1234\n"
+           << "            },";
+    leases << "            {"
+           << "                \"subnet-id\": 66,\n"
+           << "                \"ip-address\": \"2001:db8:1::1000\",\n"
+           << "                \"duid\": \"11:11:11:11:11:11\",\n"
+           << "                \"iaid\": 4321\n"
+           << "            }";
+    string cmd =
+        "{\n"
+        "    \"command\": \"lease6-bulk-apply\",\n"
+        "    \"arguments\": {"
+        "        \"leases\": [" + leases.str() +
+        "        ]"
+        "    }"
+        "}";
+    ostringstream exp_rsp;
+    exp_rsp << "Bulk apply of " << count + 2 << " IPv6 leases completed.";
+
+    // The status expected is success.
+    testCommand(cmd, CONTROL_RESULT_SUCCESS, exp_rsp.str());
+
+    checkLease6Stats(66, count + 2, 0, 0);
+
+    // Check the leases.
+    Lease6Ptr lease = lmptr_->getLease6(Lease::TYPE_NA, IOAddress("2001:db8:1::1"));
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(1234, lease->iaid_);
+    lease = lmptr_->getLease6(Lease::TYPE_NA, IOAddress("2001:db8:1::1001"));
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(1, lease->iaid_);
+
+    // The last occurrence wins.
+    lease = lmptr_->getLease6(Lease::TYPE_NA, IOAddress("2001:db8:1::1000"));
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(4321, lease->iaid_);
+}
+
 void Lease6CmdsTest::testLease6BulkApplyDeletesOnly() {
     // Initialize lease manager (true = v6, true = add leases)
     initLeaseMgr(true, true);
@@ -4254,6 +4341,15 @@ TEST_F(Lease6CmdsTest, lease6GetPagedNoLimitMultiThreading) {
     testLease6GetPagedNoLimit();
 }
 
+TEST_F(Lease6CmdsTest, lease6GetPagedFilter) {
+    testLease6GetPagedFilter();
+}
+
+TEST_F(Lease6CmdsTest, lease6GetPagedFilterMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease6GetPagedFilter();
+}
+
 TEST_F(Lease6CmdsTest, lease6GetPagedLimitNotNumber) {
     testLease6GetPagedLimitNotNumber();
 }
@@ -4604,6 +4700,15 @@ TEST_F(Lease6CmdsTest, lease6BulkApplyUpdatesOnlyMultiThreading) {
     testLease6BulkApplyUpdatesOnly();
 }
 
+TEST_F(Lease6CmdsTest, lease6BulkApplyMany) {
+    testLease6BulkApplyMany();
+}
+
+TEST_F(Lease6CmdsTest, lease6BulkApplyManyMultiThreading) {
+    MultiThreadingTest mt(true);
+    testLease6BulkApplyMany();
+}
+
 TEST_F(Lease6CmdsTest, lease6BulkApplyDeletesOnly) {
     testLease6BulkApplyDeletesOnly();
 }
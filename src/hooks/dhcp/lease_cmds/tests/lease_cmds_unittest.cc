@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -52,7 +52,9 @@ TEST_F(LeaseCmdsTest, commands) {
         "lease4-del",               "lease6-del",
         "lease4-update",            "lease6-update",
         "lease4-wipe",              "lease6-wipe",
-        "lease4-resend-ddns",       "lease6-resend-ddns"
+        "lease4-resend-ddns",       "lease6-resend-ddns",
+        "lease4-export",            "lease6-export",
+        "lease-export-status"
     };
     setFamily(AF_INET);
     testCommands(cmds);
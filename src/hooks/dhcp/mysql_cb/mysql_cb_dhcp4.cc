@@ -3723,6 +3723,11 @@ MySqlConfigBackendDHCPv4::getParameters() const {
     return (impl_->getParameters());
 }
 
+bool
+MySqlConfigBackendDHCPv4::supportsParallelFetch() const {
+    return (true);
+}
+
 Subnet4Ptr
 MySqlConfigBackendDHCPv4::getSubnet4(const ServerSelector& server_selector,
                                      const std::string& subnet_prefix) const {
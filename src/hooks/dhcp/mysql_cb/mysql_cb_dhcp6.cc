@@ -4179,6 +4179,11 @@ MySqlConfigBackendDHCPv6::getParameters() const {
     return (impl_->getParameters());
 }
 
+bool
+MySqlConfigBackendDHCPv6::supportsParallelFetch() const {
+    return (true);
+}
+
 Subnet6Ptr
 MySqlConfigBackendDHCPv6::getSubnet6(const ServerSelector& server_selector,
                                      const std::string& subnet_prefix) const {
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2019-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -644,6 +644,12 @@ public:
     /// @return Parameters of the backend.
     isc::db::DatabaseConnection::ParameterMap getParameters() const;
 
+    /// @brief Checks if the configuration can be fetched in parallel.
+    ///
+    /// @return true, the new instances open their own connection to the
+    /// same database.
+    virtual bool supportsParallelFetch() const;
+
 protected:
 
     /// @brief Pointer to the implementation of the @c MySqlConfigBackendDHCPv6
@@ -0,0 +1,206 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <packet_trace.h>
+#include <packet_trace_log.h>
+#include <cc/data.h>
+#include <exceptions/exceptions.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <sstream>
+
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::hooks;
+using namespace isc::util;
+using namespace boost::posix_time;
+using namespace std;
+
+namespace isc {
+namespace packet_trace {
+
+namespace {
+
+/// @brief Converts a time to microseconds since the epoch.
+uint64_t toMicroseconds(const ptime& time) {
+    static const ptime epoch(boost::gregorian::date(1970, 1, 1));
+    return (static_cast<uint64_t>((time - epoch).total_microseconds()));
+}
+
+} // end of anonymous namespace
+
+const size_t PacketTraceImpl::DEFAULT_QUEUE_SIZE;
+
+PacketTraceWriter::PacketTraceWriter(const string& path, size_t queue_size)
+    : path_(path), queue_size_(queue_size), writing_(0), stopping_(false),
+      dropped_(0), reported_(0) {
+    if (queue_size_ == 0) {
+        isc_throw(BadValue, "the queue size must be greater than 0");
+    }
+    file_.open(path_.c_str(), ios::out | ios::binary | ios::app);
+    if (!file_.is_open()) {
+        isc_throw(Unexpected, "unable to open trace file '" << path_ << "'");
+    }
+    OutputBuffer buf(64);
+    PcapngWriter::writeHeader(buf);
+    file_.write(static_cast<const char*>(buf.getData()), buf.getLength());
+    file_.flush();
+    thread_.reset(new thread(&PacketTraceWriter::run, this));
+}
+
+PacketTraceWriter::~PacketTraceWriter() {
+    {
+        lock_guard<mutex> lk(mutex_);
+        stopping_ = true;
+        wake_cv_.notify_one();
+    }
+    thread_->join();
+    file_.close();
+}
+
+bool
+PacketTraceWriter::push(const TracedPacketPtr& packet) {
+    lock_guard<mutex> lk(mutex_);
+    if (queue_.size() >= queue_size_) {
+        ++dropped_;
+        return (false);
+    }
+    queue_.push_back(packet);
+    if (queue_.size() == 1) {
+        wake_cv_.notify_one();
+    }
+    return (true);
+}
+
+void
+PacketTraceWriter::flush() {
+    unique_lock<mutex> lk(mutex_);
+    flushed_cv_.wait(lk, [this]() {
+        return (queue_.empty() && (writing_ == 0));
+    });
+}
+
+void
+PacketTraceWriter::run() {
+    deque<TracedPacketPtr> batch;
+    OutputBuffer buf(65536);
+    for (;;) {
+        {
+            unique_lock<mutex> lk(mutex_);
+            writing_ = 0;
+            flushed_cv_.notify_all();
+            wake_cv_.wait(lk, [this]() {
+                return (stopping_ || !queue_.empty());
+            });
+            if (queue_.empty()) {
+                // Stopping and everything was written.
+                return;
+            }
+            batch.swap(queue_);
+            writing_ = batch.size();
+        }
+
+        buf.clear();
+        for (auto const& packet : batch) {
+            try {
+                PcapngWriter::writePacket(buf, *packet);
+            } catch (const exception& ex) {
+                LOG_ERROR(packet_trace_logger, PACKET_TRACE_WRITE_ERROR)
+                    .arg(path_)
+                    .arg(ex.what());
+            }
+        }
+        batch.clear();
+        file_.write(static_cast<const char*>(buf.getData()), buf.getLength());
+        file_.flush();
+        if (!file_.good()) {
+            LOG_ERROR(packet_trace_logger, PACKET_TRACE_WRITE_ERROR)
+                .arg(path_)
+                .arg("write failed");
+            file_.clear();
+        }
+
+        const uint64_t dropped = dropped_;
+        if (dropped > reported_) {
+            LOG_WARN(packet_trace_logger, PACKET_TRACE_DROPPED)
+                .arg(dropped - reported_);
+            reported_ = dropped;
+        }
+    }
+}
+
+void
+PacketTraceImpl::configure(LibraryHandle& handle) {
+    ConstElementPtr output = handle.getParameter("output");
+    if (!output) {
+        isc_throw(BadValue, "the 'output' parameter is mandatory");
+    }
+    if ((output->getType() != Element::string) ||
+        output->stringValue().empty()) {
+        isc_throw(BadValue, "the 'output' parameter must be a non empty"
+                  " string");
+    }
+    size_t queue_size = DEFAULT_QUEUE_SIZE;
+    ConstElementPtr queue = handle.getParameter("queue-size");
+    if (queue) {
+        if ((queue->getType() != Element::integer) ||
+            (queue->intValue() <= 0)) {
+            isc_throw(BadValue, "the 'queue-size' parameter must be a"
+                      " positive integer");
+        }
+        queue_size = static_cast<size_t>(queue->intValue());
+    }
+    writer_.reset(new PacketTraceWriter(output->stringValue(), queue_size));
+}
+
+TracedPacketPtr
+PacketTraceImpl::traceQuery(const Pkt4Ptr& query) {
+    TracedPacketPtr packet(new TracedPacket());
+    packet->timestamp_ = toMicroseconds(query->getTimestamp());
+    packet->source_ = query->getRemoteAddr();
+    packet->source_port_ = query->getRemotePort();
+    packet->destination_ = query->getLocalAddr();
+    packet->destination_port_ = query->getLocalPort();
+    packet->data_ = query->data_;
+    return (packet);
+}
+
+TracedPacketPtr
+PacketTraceImpl::traceResponse(const Pkt4Ptr& response) {
+    TracedPacketPtr packet(new TracedPacket());
+    packet->timestamp_ = toMicroseconds(microsec_clock::universal_time());
+    packet->source_ = response->getLocalAddr();
+    packet->source_port_ = response->getLocalPort();
+    packet->destination_ = response->getRemoteAddr();
+    packet->destination_port_ = response->getRemotePort();
+    const OutputBuffer& buf = response->getBuffer();
+    const uint8_t* data = static_cast<const uint8_t*>(buf.getData());
+    packet->data_.assign(data, data + buf.getLength());
+    return (packet);
+}
+
+string
+PacketTraceImpl::describe(const Pkt4Ptr& query, const Pkt4Ptr& response,
+                          SubnetID subnet_id, const Lease4Ptr& lease) {
+    ostringstream s;
+    s << (response ? response->getName() : "no-response");
+    if (subnet_id != 0) {
+        s << " subnet-id=" << subnet_id;
+    }
+    if (!query->getClasses().empty()) {
+        s << " classes=" << query->getClasses().toText(",");
+    }
+    if (lease) {
+        s << " lease=" << lease->addr_ << " valid-lft=" << lease->valid_lft_;
+    }
+    return (s.str());
+}
+
+} // end of namespace isc::packet_trace
+} // end of namespace isc
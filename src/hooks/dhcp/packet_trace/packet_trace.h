@@ -0,0 +1,162 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PACKET_TRACE_H
+#define PACKET_TRACE_H
+
+#include <pcapng_writer.h>
+#include <dhcp/pkt4.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/subnet_id.h>
+#include <hooks/library_handle.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace isc {
+namespace packet_trace {
+
+/// @brief Bounded asynchronous writer of the trace file.
+///
+/// The packets are queued by the packet processing threads and written
+/// by a dedicated thread, so the processing never waits for the file.
+/// When the queue is full the packets are dropped and counted.
+class PacketTraceWriter : public boost::noncopyable {
+public:
+    /// @brief Constructor.
+    ///
+    /// Opens the trace file in append mode and writes a new pcapng section
+    /// header so restarting the server appends a new section.
+    ///
+    /// @param path path of the trace file.
+    /// @param queue_size maximum number of queued packets.
+    /// @throw BadValue if the queue size is 0.
+    /// @throw Unexpected if the file can't be opened.
+    PacketTraceWriter(const std::string& path, size_t queue_size);
+
+    /// @brief Destructor.
+    ///
+    /// Writes the queued packets and stops the writer thread.
+    ~PacketTraceWriter();
+
+    /// @brief Queues a packet.
+    ///
+    /// @param packet the packet.
+    /// @return false if the packet was dropped because the queue is full.
+    bool push(const TracedPacketPtr& packet);
+
+    /// @brief Waits for the queued packets to be written.
+    void flush();
+
+    /// @brief Returns the number of dropped packets.
+    uint64_t getDroppedCount() const {
+        return (dropped_);
+    }
+
+private:
+    /// @brief The writer thread.
+    void run();
+
+    /// @brief Path of the trace file.
+    std::string path_;
+
+    /// @brief Maximum number of queued packets.
+    size_t queue_size_;
+
+    /// @brief The trace file.
+    std::ofstream file_;
+
+    /// @brief The queued packets.
+    std::deque<TracedPacketPtr> queue_;
+
+    /// @brief Number of packets popped but not yet written.
+    size_t writing_;
+
+    /// @brief Protects the queue.
+    std::mutex mutex_;
+
+    /// @brief Wakes up the writer thread.
+    std::condition_variable wake_cv_;
+
+    /// @brief Wakes up the threads waiting in flush.
+    std::condition_variable flushed_cv_;
+
+    /// @brief Flag set when the writer thread must exit.
+    bool stopping_;
+
+    /// @brief Number of dropped packets.
+    std::atomic<uint64_t> dropped_;
+
+    /// @brief Number of dropped packets already reported.
+    uint64_t reported_;
+
+    /// @brief The writer thread.
+    boost::scoped_ptr<std::thread> thread_;
+};
+
+/// @brief Implementation of the packet trace hooks library.
+class PacketTraceImpl : public boost::noncopyable {
+public:
+    /// @brief Default size of the queue.
+    static const size_t DEFAULT_QUEUE_SIZE = 4096;
+
+    /// @brief Configures the library and starts the writer.
+    ///
+    /// @param handle the library handle holding the parameters.
+    /// @throw BadValue if a parameter is invalid.
+    void configure(hooks::LibraryHandle& handle);
+
+    /// @brief Returns the writer.
+    PacketTraceWriter& getWriter() {
+        return (*writer_);
+    }
+
+    /// @brief Creates the traced query.
+    ///
+    /// @param query the received query.
+    /// @return the traced packet holding the received wire data.
+    static TracedPacketPtr traceQuery(const dhcp::Pkt4Ptr& query);
+
+    /// @brief Creates the traced response.
+    ///
+    /// @param response the packed response.
+    /// @return the traced packet holding the wire data of the response.
+    static TracedPacketPtr traceResponse(const dhcp::Pkt4Ptr& response);
+
+    /// @brief Describes the processing of a query.
+    ///
+    /// @param query the query.
+    /// @param response the response.
+    /// @param subnet_id identifier of the selected subnet, 0 if none.
+    /// @param lease the committed lease, null if none.
+    /// @return the description, e.g. "DHCPACK subnet-id=1
+    /// classes=ALL,KNOWN lease=192.0.2.10 valid-lft=3600".
+    static std::string describe(const dhcp::Pkt4Ptr& query,
+                                const dhcp::Pkt4Ptr& response,
+                                dhcp::SubnetID subnet_id,
+                                const dhcp::Lease4Ptr& lease);
+
+private:
+    /// @brief The writer.
+    boost::scoped_ptr<PacketTraceWriter> writer_;
+};
+
+/// @brief Pointer to the implementation.
+typedef boost::shared_ptr<PacketTraceImpl> PacketTraceImplPtr;
+
+} // end of namespace isc::packet_trace
+} // end of namespace isc
+
+#endif // PACKET_TRACE_H
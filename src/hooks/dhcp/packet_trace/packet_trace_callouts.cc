@@ -0,0 +1,215 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <hooks/hooks.h>
+#include <packet_trace.h>
+#include <packet_trace_log.h>
+#include <dhcp/pkt4.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/subnet.h>
+#include <process/daemon.h>
+
+#include <string>
+
+namespace isc {
+namespace packet_trace {
+
+PacketTraceImplPtr impl;
+
+} // namespace packet_trace
+} // namespace isc
+
+using namespace isc;
+using namespace isc::dhcp;
+using namespace isc::hooks;
+using namespace isc::packet_trace;
+using namespace isc::process;
+using namespace std;
+
+namespace {
+
+/// @brief Name of the context holding the selected subnet identifier.
+const string SUBNET_CONTEXT("packet-trace-subnet-id");
+
+/// @brief Name of the context holding the committed lease.
+const string LEASE_CONTEXT("packet-trace-lease");
+
+/// @brief Name of the context holding the traced query.
+const string QUERY_CONTEXT("packet-trace-query");
+
+/// @brief Name of the context holding the description of the processing.
+const string COMMENT_CONTEXT("packet-trace-comment");
+
+/// @brief Gets a value from the callout context.
+///
+/// @param handle the callout handle.
+/// @param name name of the context.
+/// @param value filled with the value if the context exists.
+template <typename T>
+void getOptionalContext(CalloutHandle& handle, const string& name, T& value) {
+    try {
+        handle.getContext(name, value);
+    } catch (const NoSuchCalloutContext&) {
+        // Not set for this packet.
+    }
+}
+
+} // end of anonymous namespace
+
+// Functions accessed by the hooks framework use C linkage to avoid the name
+// mangling that accompanies use of the C++ compiler as well as to avoid
+// issues related to namespaces.
+extern "C" {
+
+/// @brief This function is called when the library is loaded.
+///
+/// @param handle library handle
+/// @return 0 when initialization is successful, 1 otherwise
+int load(LibraryHandle& handle) {
+    try {
+        // Make the hook library loadable only by kea-dhcp4.
+        uint16_t family = CfgMgr::instance().getFamily();
+        const string& proc_name = Daemon::getProcName();
+        if ((family != AF_INET) || (proc_name != "kea-dhcp4")) {
+            isc_throw(isc::Unexpected, "Bad process name: " << proc_name
+                      << ", expected kea-dhcp4");
+        }
+
+        impl.reset(new PacketTraceImpl());
+        impl->configure(handle);
+    } catch (const exception& ex) {
+        impl.reset();
+        LOG_ERROR(packet_trace_logger, PACKET_TRACE_LOAD_ERROR)
+            .arg(ex.what());
+        return (1);
+    }
+
+    LOG_INFO(packet_trace_logger, PACKET_TRACE_LOAD);
+    return (0);
+}
+
+/// @brief This function is called when the library is unloaded.
+///
+/// The destruction of the implementation writes the queued packets.
+///
+/// @return always 0.
+int unload() {
+    impl.reset();
+    LOG_INFO(packet_trace_logger, PACKET_TRACE_UNLOAD);
+    return (0);
+}
+
+/// @brief This callout is called at the "subnet4_select" hook.
+///
+/// Remembers the selected subnet.
+///
+/// @param handle the callout handle.
+/// @return always 0.
+int subnet4_select(CalloutHandle& handle) {
+    Subnet4Ptr subnet;
+    handle.getArgument("subnet4", subnet);
+    handle.setContext(SUBNET_CONTEXT, subnet ? subnet->getID() : SubnetID(0));
+    return (0);
+}
+
+/// @brief This callout is called at the "leases4_committed" hook.
+///
+/// Remembers the committed lease.
+///
+/// @param handle the callout handle.
+/// @return always 0.
+int leases4_committed(CalloutHandle& handle) {
+    Lease4CollectionPtr leases;
+    handle.getArgument("leases4", leases);
+    if (leases && !leases->empty()) {
+        handle.setContext(LEASE_CONTEXT, leases->front());
+    }
+    return (0);
+}
+
+/// @brief This callout is called at the "pkt4_send" hook.
+///
+/// Copies the received query and describes its processing: the response
+/// is traced after it is packed in the buffer4_send callout. Nothing is
+/// kept to the query itself which owns the callout handle.
+///
+/// @param handle the callout handle.
+/// @return 0 on success, 1 otherwise.
+int pkt4_send(CalloutHandle& handle) {
+    Pkt4Ptr query;
+    Pkt4Ptr response;
+    try {
+        handle.getArgument("query4", query);
+        handle.getArgument("response4", response);
+        if (!impl || !query) {
+            return (0);
+        }
+        SubnetID subnet_id(0);
+        getOptionalContext(handle, SUBNET_CONTEXT, subnet_id);
+        Lease4Ptr lease;
+        getOptionalContext(handle, LEASE_CONTEXT, lease);
+
+        TracedPacketPtr traced = PacketTraceImpl::traceQuery(query);
+        handle.setContext(QUERY_CONTEXT, traced);
+        handle.setContext(COMMENT_CONTEXT,
+                          PacketTraceImpl::describe(query, response,
+                                                    subnet_id, lease));
+    } catch (const exception& ex) {
+        LOG_ERROR(packet_trace_logger, PACKET_TRACE_CALLOUT_ERROR)
+            .arg(query ? query->getLabel() : "unknown")
+            .arg("pkt4_send")
+            .arg(ex.what());
+        return (1);
+    }
+    return (0);
+}
+
+/// @brief This callout is called at the "buffer4_send" hook.
+///
+/// Queues the traced query and response.
+///
+/// @param handle the callout handle.
+/// @return 0 on success, 1 otherwise.
+int buffer4_send(CalloutHandle& handle) {
+    Pkt4Ptr response;
+    try {
+        handle.getArgument("response4", response);
+        TracedPacketPtr query;
+        getOptionalContext(handle, QUERY_CONTEXT, query);
+        if (!impl || !response || !query) {
+            return (0);
+        }
+        string comment;
+        getOptionalContext(handle, COMMENT_CONTEXT, comment);
+        handle.deleteContext(QUERY_CONTEXT);
+        handle.deleteContext(COMMENT_CONTEXT);
+
+        TracedPacketPtr traced = PacketTraceImpl::traceResponse(response);
+        query->comment_ = "query " + comment;
+        traced->comment_ = "response " + comment;
+        impl->getWriter().push(query);
+        impl->getWriter().push(traced);
+    } catch (const exception& ex) {
+        LOG_ERROR(packet_trace_logger, PACKET_TRACE_CALLOUT_ERROR)
+            .arg(response ? response->getLabel() : "unknown")
+            .arg("buffer4_send")
+            .arg(ex.what());
+        return (1);
+    }
+    return (0);
+}
+
+/// @brief This function is called to retrieve the multi-threading compatibility.
+///
+/// @return 1 which means compatible with multi-threading.
+int multi_threading_compatible() {
+    return (1);
+}
+
+} // end extern "C"
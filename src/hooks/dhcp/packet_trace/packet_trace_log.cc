@@ -0,0 +1,17 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <packet_trace_log.h>
+
+namespace isc {
+namespace packet_trace {
+
+isc::log::Logger packet_trace_logger("packet-trace-hooks");
+
+} // namespace packet_trace
+} // namespace isc
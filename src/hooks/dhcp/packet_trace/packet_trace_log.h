@@ -0,0 +1,22 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PACKET_TRACE_LOG_H
+#define PACKET_TRACE_LOG_H
+
+#include <log/logger_support.h>
+#include <log/macros.h>
+#include <log/log_dbglevels.h>
+#include <packet_trace_messages.h>
+
+namespace isc {
+namespace packet_trace {
+
+extern isc::log::Logger packet_trace_logger;
+
+} // namespace packet_trace
+} // namespace isc
+#endif
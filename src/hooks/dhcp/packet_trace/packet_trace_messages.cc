@@ -0,0 +1,29 @@
+// File created from ../../../../src/hooks/dhcp/packet_trace/packet_trace_messages.mes
+
+#include <cstddef>
+#include <log/message_types.h>
+#include <log/message_initializer.h>
+
+extern const isc::log::MessageID PACKET_TRACE_CALLOUT_ERROR = "PACKET_TRACE_CALLOUT_ERROR";
+extern const isc::log::MessageID PACKET_TRACE_DROPPED = "PACKET_TRACE_DROPPED";
+extern const isc::log::MessageID PACKET_TRACE_LOAD = "PACKET_TRACE_LOAD";
+extern const isc::log::MessageID PACKET_TRACE_LOAD_ERROR = "PACKET_TRACE_LOAD_ERROR";
+extern const isc::log::MessageID PACKET_TRACE_UNLOAD = "PACKET_TRACE_UNLOAD";
+extern const isc::log::MessageID PACKET_TRACE_WRITE_ERROR = "PACKET_TRACE_WRITE_ERROR";
+
+namespace {
+
+const char* values[] = {
+    "PACKET_TRACE_CALLOUT_ERROR", "error tracing packet %1 in %2 callout: %3",
+    "PACKET_TRACE_DROPPED", "%1 packets were dropped from the trace",
+    "PACKET_TRACE_LOAD", "Packet Trace hooks library has been loaded",
+    "PACKET_TRACE_LOAD_ERROR", "Packet Trace hooks library failed: %1",
+    "PACKET_TRACE_UNLOAD", "Packet Trace hooks library has been unloaded",
+    "PACKET_TRACE_WRITE_ERROR", "error writing trace file %1: %2",
+    NULL
+};
+
+const isc::log::MessageInitializer initializer(values);
+
+} // Anonymous namespace
+
@@ -0,0 +1,15 @@
+// File created from ../../../../src/hooks/dhcp/packet_trace/packet_trace_messages.mes
+
+#ifndef PACKET_TRACE_MESSAGES_H
+#define PACKET_TRACE_MESSAGES_H
+
+#include <log/message_types.h>
+
+extern const isc::log::MessageID PACKET_TRACE_CALLOUT_ERROR;
+extern const isc::log::MessageID PACKET_TRACE_DROPPED;
+extern const isc::log::MessageID PACKET_TRACE_LOAD;
+extern const isc::log::MessageID PACKET_TRACE_LOAD_ERROR;
+extern const isc::log::MessageID PACKET_TRACE_UNLOAD;
+extern const isc::log::MessageID PACKET_TRACE_WRITE_ERROR;
+
+#endif // PACKET_TRACE_MESSAGES_H
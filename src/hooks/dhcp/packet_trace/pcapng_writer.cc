@@ -0,0 +1,145 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <pcapng_writer.h>
+#include <exceptions/exceptions.h>
+
+#include <algorithm>
+
+using namespace isc::util;
+
+namespace isc {
+namespace packet_trace {
+
+namespace {
+
+/// @brief Length of a field padded to 32 bits.
+size_t padded(size_t len) {
+    return ((len + 3) & ~static_cast<size_t>(3));
+}
+
+} // end of anonymous namespace
+
+const uint32_t PcapngWriter::SECTION_HEADER_BLOCK;
+const uint32_t PcapngWriter::INTERFACE_DESCRIPTION_BLOCK;
+const uint32_t PcapngWriter::ENHANCED_PACKET_BLOCK;
+const uint32_t PcapngWriter::BYTE_ORDER_MAGIC;
+const uint16_t PcapngWriter::LINKTYPE_IPV4;
+const uint16_t PcapngWriter::OPT_COMMENT;
+const size_t PcapngWriter::HEADERS_SIZE;
+
+void
+PcapngWriter::writePadding(OutputBuffer& buf, size_t len) {
+    for (size_t i = len; i < padded(len); ++i) {
+        buf.writeUint8(0);
+    }
+}
+
+uint16_t
+PcapngWriter::checksum(const uint8_t* header, size_t len) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i + 1 < len; i += 2) {
+        sum += (header[i] << 8) | header[i + 1];
+    }
+    if (len & 1) {
+        sum += header[len - 1] << 8;
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return (static_cast<uint16_t>(~sum));
+}
+
+void
+PcapngWriter::writeHeader(OutputBuffer& buf) {
+    // Section header block: no options, unknown section length.
+    buf.writeUint32(SECTION_HEADER_BLOCK);
+    buf.writeUint32(28);
+    buf.writeUint32(BYTE_ORDER_MAGIC);
+    buf.writeUint16(1);
+    buf.writeUint16(0);
+    buf.writeUint64(0xffffffffffffffffULL);
+    buf.writeUint32(28);
+
+    // Interface description block: no snap length, no options so the
+    // time stamps are in microseconds.
+    buf.writeUint32(INTERFACE_DESCRIPTION_BLOCK);
+    buf.writeUint32(20);
+    buf.writeUint16(LINKTYPE_IPV4);
+    buf.writeUint16(0);
+    buf.writeUint32(0);
+    buf.writeUint32(20);
+}
+
+void
+PcapngWriter::writePacket(OutputBuffer& buf, const TracedPacket& packet) {
+    if (!packet.source_.isV4() || !packet.destination_.isV4()) {
+        isc_throw(BadValue, "traced packet addresses must be IPv4 addresses");
+    }
+    const size_t ip_len = HEADERS_SIZE + packet.data_.size();
+    if (ip_len > 0xffff) {
+        isc_throw(BadValue, "traced packet is too large: "
+                  << packet.data_.size() << " bytes");
+    }
+
+    size_t options_len = 0;
+    if (!packet.comment_.empty()) {
+        // Comment option and end of options.
+        options_len = 4 + padded(packet.comment_.size()) + 4;
+    }
+    const uint32_t block_len = 32 + padded(ip_len) + options_len;
+
+    buf.writeUint32(ENHANCED_PACKET_BLOCK);
+    buf.writeUint32(block_len);
+    // Interface id.
+    buf.writeUint32(0);
+    buf.writeUint32(static_cast<uint32_t>(packet.timestamp_ >> 32));
+    buf.writeUint32(static_cast<uint32_t>(packet.timestamp_));
+    // Captured and original lengths.
+    buf.writeUint32(ip_len);
+    buf.writeUint32(ip_len);
+
+    // IPv4 header: no options, don't fragment, TTL 64, UDP.
+    uint8_t ip[20] = {
+        0x45, 0, static_cast<uint8_t>(ip_len >> 8),
+        static_cast<uint8_t>(ip_len), 0, 0, 0x40, 0, 64, 17, 0, 0
+    };
+    const std::vector<uint8_t>& src = packet.source_.toBytes();
+    const std::vector<uint8_t>& dst = packet.destination_.toBytes();
+    std::copy(src.begin(), src.end(), ip + 12);
+    std::copy(dst.begin(), dst.end(), ip + 16);
+    const uint16_t sum = checksum(ip, sizeof(ip));
+    ip[10] = static_cast<uint8_t>(sum >> 8);
+    ip[11] = static_cast<uint8_t>(sum);
+    buf.writeData(ip, sizeof(ip));
+
+    // UDP header: the checksum is optional over IPv4.
+    buf.writeUint16(packet.source_port_);
+    buf.writeUint16(packet.destination_port_);
+    buf.writeUint16(static_cast<uint16_t>(ip_len - sizeof(ip)));
+    buf.writeUint16(0);
+
+    if (!packet.data_.empty()) {
+        buf.writeData(&packet.data_[0], packet.data_.size());
+    }
+    writePadding(buf, ip_len);
+
+    if (!packet.comment_.empty()) {
+        buf.writeUint16(OPT_COMMENT);
+        buf.writeUint16(packet.comment_.size());
+        buf.writeData(packet.comment_.c_str(), packet.comment_.size());
+        writePadding(buf, packet.comment_.size());
+        // End of options.
+        buf.writeUint32(0);
+    }
+
+    buf.writeUint32(block_len);
+}
+
+} // end of namespace isc::packet_trace
+} // end of namespace isc
@@ -0,0 +1,122 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PCAPNG_WRITER_H
+#define PCAPNG_WRITER_H
+
+#include <asiolink/io_address.h>
+#include <util/buffer.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace packet_trace {
+
+/// @brief A traced packet.
+struct TracedPacket {
+    /// @brief Constructor.
+    TracedPacket()
+        : timestamp_(0), source_(asiolink::IOAddress::IPV4_ZERO_ADDRESS()),
+          source_port_(0),
+          destination_(asiolink::IOAddress::IPV4_ZERO_ADDRESS()),
+          destination_port_(0) {
+    }
+
+    /// @brief Time of the packet in microseconds since the epoch.
+    uint64_t timestamp_;
+
+    /// @brief Source address.
+    asiolink::IOAddress source_;
+
+    /// @brief Source UDP port.
+    uint16_t source_port_;
+
+    /// @brief Destination address.
+    asiolink::IOAddress destination_;
+
+    /// @brief Destination UDP port.
+    uint16_t destination_port_;
+
+    /// @brief DHCP message in wire format.
+    std::vector<uint8_t> data_;
+
+    /// @brief Processing metadata, written in the packet comment.
+    std::string comment_;
+};
+
+/// @brief Pointer to a traced packet.
+typedef boost::shared_ptr<TracedPacket> TracedPacketPtr;
+
+/// @brief Encoder of the pcapng (PCAP Next Generation) blocks.
+///
+/// The trace is a pcapng file so the standard tools (wireshark, tshark,
+/// editcap...) decode it: each trace starts a new section with one
+/// interface of the raw IPv4 link type, and each packet is an enhanced
+/// packet block holding the DHCP message behind synthesized IPv4 and UDP
+/// headers, with the processing metadata in the comment option.
+///
+/// The blocks are written in network byte order, which pcapng readers
+/// detect with the byte order magic of the section header.
+class PcapngWriter {
+public:
+    /// @brief Section header block type.
+    static const uint32_t SECTION_HEADER_BLOCK = 0x0A0D0D0A;
+
+    /// @brief Interface description block type.
+    static const uint32_t INTERFACE_DESCRIPTION_BLOCK = 1;
+
+    /// @brief Enhanced packet block type.
+    static const uint32_t ENHANCED_PACKET_BLOCK = 6;
+
+    /// @brief Byte order magic of the section header block.
+    static const uint32_t BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+
+    /// @brief Link type of the raw IPv4 packets.
+    static const uint16_t LINKTYPE_IPV4 = 228;
+
+    /// @brief Comment option code.
+    static const uint16_t OPT_COMMENT = 1;
+
+    /// @brief Size of the synthesized IPv4 and UDP headers.
+    static const size_t HEADERS_SIZE = 28;
+
+    /// @brief Writes the section header and interface description blocks.
+    ///
+    /// @param buf buffer receiving the blocks.
+    static void writeHeader(util::OutputBuffer& buf);
+
+    /// @brief Writes an enhanced packet block.
+    ///
+    /// @param buf buffer receiving the block.
+    /// @param packet the packet.
+    /// @throw BadValue if an address is not an IPv4 address or the
+    /// packet is too large for an IPv4 packet.
+    static void writePacket(util::OutputBuffer& buf,
+                            const TracedPacket& packet);
+
+    /// @brief Computes the IPv4 header checksum.
+    ///
+    /// @param header the header.
+    /// @param len length of the header.
+    /// @return the checksum.
+    static uint16_t checksum(const uint8_t* header, size_t len);
+
+private:
+    /// @brief Writes the padding to the next 32 bits boundary.
+    ///
+    /// @param buf the buffer.
+    /// @param len length of the padded field.
+    static void writePadding(util::OutputBuffer& buf, size_t len);
+};
+
+} // end of namespace isc::packet_trace
+} // end of namespace isc
+
+#endif // PCAPNG_WRITER_H
@@ -0,0 +1,170 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <packet_trace.h>
+#include <dhcp/dhcp4.h>
+#include <exceptions/exceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+using namespace isc::packet_trace;
+using namespace std;
+
+namespace {
+
+/// @brief Path of the trace file.
+const string TRACE_FILE = string(TEST_DATA_BUILDDIR) + "/test.pcapng";
+
+/// @brief Test fixture removing the trace file.
+class PacketTraceTest : public ::testing::Test {
+public:
+    /// @brief Constructor.
+    PacketTraceTest() {
+        static_cast<void>(remove(TRACE_FILE.c_str()));
+    }
+
+    /// @brief Destructor.
+    virtual ~PacketTraceTest() {
+        static_cast<void>(remove(TRACE_FILE.c_str()));
+    }
+
+    /// @brief Reads the trace file.
+    ///
+    /// @return the content of the trace file.
+    vector<uint8_t> readTrace() {
+        ifstream file(TRACE_FILE.c_str(), ios::binary);
+        return (vector<uint8_t>(istreambuf_iterator<char>(file),
+                                istreambuf_iterator<char>()));
+    }
+
+    /// @brief Returns a traced packet of the given payload size.
+    TracedPacketPtr makePacket(size_t size) {
+        TracedPacketPtr packet(new TracedPacket());
+        packet->source_ = IOAddress("192.0.2.1");
+        packet->source_port_ = 68;
+        packet->destination_ = IOAddress("192.0.2.254");
+        packet->destination_port_ = 67;
+        packet->data_.resize(size, 0xaa);
+        return (packet);
+    }
+};
+
+// Verifies that the writer rejects invalid parameters.
+TEST_F(PacketTraceTest, badWriter) {
+    EXPECT_THROW(PacketTraceWriter(TRACE_FILE, 0), BadValue);
+    EXPECT_THROW(PacketTraceWriter("/no-such-dir/trace.pcapng", 16),
+                 Unexpected);
+}
+
+// Verifies that the writer writes the header and the queued packets.
+TEST_F(PacketTraceTest, writer) {
+    {
+        PacketTraceWriter writer(TRACE_FILE, 16);
+        EXPECT_EQ(48, readTrace().size());
+        EXPECT_TRUE(writer.push(makePacket(4)));
+        EXPECT_TRUE(writer.push(makePacket(8)));
+        writer.flush();
+        // 48 bytes of header and two packets of 64 and 68 bytes.
+        EXPECT_EQ(48 + 64 + 68, readTrace().size());
+        EXPECT_TRUE(writer.push(makePacket(4)));
+    }
+    // The destructor writes the queued packets.
+    vector<uint8_t> trace = readTrace();
+    ASSERT_EQ(48 + 64 + 68 + 64, trace.size());
+    EXPECT_EQ(0x0a, trace[0]);
+    EXPECT_EQ(6, trace[51]);
+    EXPECT_EQ(6, trace[48 + 64 + 3]);
+    EXPECT_EQ(6, trace[48 + 64 + 68 + 3]);
+
+    // Opening again appends a new section.
+    { PacketTraceWriter writer(TRACE_FILE, 16); }
+    trace = readTrace();
+    ASSERT_EQ(48 + 64 + 68 + 64 + 48, trace.size());
+    EXPECT_EQ(0x0a, trace[48 + 64 + 68 + 64]);
+}
+
+// Verifies that no packet is lost with a small queue, or is counted as
+// dropped.
+TEST_F(PacketTraceTest, smallQueue) {
+    size_t pushed = 0;
+    uint64_t dropped = 0;
+    {
+        PacketTraceWriter writer(TRACE_FILE, 1);
+        for (int i = 0; i < 1000; ++i) {
+            if (writer.push(makePacket(4))) {
+                ++pushed;
+            }
+        }
+        dropped = writer.getDroppedCount();
+    }
+    EXPECT_LE(1, pushed);
+    EXPECT_EQ(1000, pushed + dropped);
+    EXPECT_EQ(48 + 64 * pushed, readTrace().size());
+}
+
+// Verifies the traced query and response.
+TEST_F(PacketTraceTest, trace) {
+    Pkt4Ptr query(new Pkt4(DHCPREQUEST, 1234));
+    query->setRemoteAddr(IOAddress("192.0.2.1"));
+    query->setRemotePort(68);
+    query->setLocalAddr(IOAddress("192.0.2.254"));
+    query->setLocalPort(67);
+    query->data_ = { 1, 2, 3 };
+    TracedPacketPtr traced = PacketTraceImpl::traceQuery(query);
+    ASSERT_TRUE(traced);
+    EXPECT_EQ("192.0.2.1", traced->source_.toText());
+    EXPECT_EQ(68, traced->source_port_);
+    EXPECT_EQ("192.0.2.254", traced->destination_.toText());
+    EXPECT_EQ(67, traced->destination_port_);
+    EXPECT_EQ(query->data_, traced->data_);
+    EXPECT_LT(0, traced->timestamp_);
+
+    Pkt4Ptr response(new Pkt4(DHCPACK, 1234));
+    response->setLocalAddr(IOAddress("192.0.2.254"));
+    response->setLocalPort(67);
+    response->setRemoteAddr(IOAddress("192.0.2.1"));
+    response->setRemotePort(68);
+    ASSERT_NO_THROW(response->pack());
+    traced = PacketTraceImpl::traceResponse(response);
+    ASSERT_TRUE(traced);
+    EXPECT_EQ("192.0.2.254", traced->source_.toText());
+    EXPECT_EQ(67, traced->source_port_);
+    EXPECT_EQ("192.0.2.1", traced->destination_.toText());
+    EXPECT_EQ(68, traced->destination_port_);
+    EXPECT_EQ(response->getBuffer().getLength(), traced->data_.size());
+    EXPECT_LT(0, traced->timestamp_);
+}
+
+// Verifies the description of the processing.
+TEST_F(PacketTraceTest, describe) {
+    Pkt4Ptr query(new Pkt4(DHCPREQUEST, 1234));
+    Pkt4Ptr response(new Pkt4(DHCPACK, 1234));
+    EXPECT_EQ("no-response",
+              PacketTraceImpl::describe(query, Pkt4Ptr(), 0, Lease4Ptr()));
+    EXPECT_EQ("DHCPACK",
+              PacketTraceImpl::describe(query, response, 0, Lease4Ptr()));
+
+    query->addClass("ALL");
+    query->addClass("KNOWN");
+    Lease4Ptr lease(new Lease4());
+    lease->addr_ = IOAddress("192.0.2.10");
+    lease->valid_lft_ = 3600;
+    EXPECT_EQ("DHCPACK subnet-id=1 classes=ALL,KNOWN lease=192.0.2.10"
+              " valid-lft=3600",
+              PacketTraceImpl::describe(query, response, 1, lease));
+}
+
+} // end of anonymous namespace
@@ -0,0 +1,139 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <pcapng_writer.h>
+#include <exceptions/exceptions.h>
+#include <util/buffer.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::packet_trace;
+using namespace isc::util;
+using namespace std;
+
+namespace {
+
+/// @brief Reads a 32 bits integer in network byte order.
+uint32_t readUint32(const uint8_t* data) {
+    return ((data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]);
+}
+
+/// @brief Reads a 16 bits integer in network byte order.
+uint16_t readUint16(const uint8_t* data) {
+    return ((data[0] << 8) | data[1]);
+}
+
+/// @brief Returns a traced packet.
+TracedPacket makePacket() {
+    TracedPacket packet;
+    packet.timestamp_ = 0x0000000512345678ULL;
+    packet.source_ = IOAddress("192.0.2.1");
+    packet.source_port_ = 68;
+    packet.destination_ = IOAddress("192.0.2.254");
+    packet.destination_port_ = 67;
+    packet.data_ = { 1, 2, 3, 4, 5 };
+    return (packet);
+}
+
+// Verifies the section header and interface description blocks.
+TEST(PcapngWriterTest, header) {
+    OutputBuffer buf(0);
+    PcapngWriter::writeHeader(buf);
+    ASSERT_EQ(48, buf.getLength());
+    const uint8_t* data = static_cast<const uint8_t*>(buf.getData());
+
+    EXPECT_EQ(PcapngWriter::SECTION_HEADER_BLOCK, readUint32(data));
+    EXPECT_EQ(28, readUint32(data + 4));
+    EXPECT_EQ(PcapngWriter::BYTE_ORDER_MAGIC, readUint32(data + 8));
+    EXPECT_EQ(1, readUint16(data + 12));
+    EXPECT_EQ(0, readUint16(data + 14));
+    EXPECT_EQ(28, readUint32(data + 24));
+
+    EXPECT_EQ(PcapngWriter::INTERFACE_DESCRIPTION_BLOCK, readUint32(data + 28));
+    EXPECT_EQ(20, readUint32(data + 32));
+    EXPECT_EQ(PcapngWriter::LINKTYPE_IPV4, readUint16(data + 36));
+    EXPECT_EQ(20, readUint32(data + 44));
+}
+
+// Verifies an enhanced packet block without comment.
+TEST(PcapngWriterTest, packet) {
+    OutputBuffer buf(0);
+    TracedPacket packet = makePacket();
+    ASSERT_NO_THROW(PcapngWriter::writePacket(buf, packet));
+    // 28 bytes of block fields, 28 + 5 bytes of packet padded to 36 and
+    // 4 bytes of trailing length.
+    ASSERT_EQ(68, buf.getLength());
+    const uint8_t* data = static_cast<const uint8_t*>(buf.getData());
+
+    EXPECT_EQ(PcapngWriter::ENHANCED_PACKET_BLOCK, readUint32(data));
+    EXPECT_EQ(68, readUint32(data + 4));
+    EXPECT_EQ(0, readUint32(data + 8));
+    EXPECT_EQ(5, readUint32(data + 12));
+    EXPECT_EQ(0x12345678, readUint32(data + 16));
+    EXPECT_EQ(33, readUint32(data + 20));
+    EXPECT_EQ(33, readUint32(data + 24));
+    EXPECT_EQ(68, readUint32(data + 64));
+
+    // IPv4 header with a valid checksum.
+    const uint8_t* ip = data + 28;
+    EXPECT_EQ(0x45, ip[0]);
+    EXPECT_EQ(33, readUint16(ip + 2));
+    EXPECT_EQ(17, ip[9]);
+    EXPECT_EQ(0, PcapngWriter::checksum(ip, 20));
+    EXPECT_EQ(vector<uint8_t>({ 192, 0, 2, 1 }), vector<uint8_t>(ip + 12, ip + 16));
+    EXPECT_EQ(vector<uint8_t>({ 192, 0, 2, 254 }), vector<uint8_t>(ip + 16, ip + 20));
+
+    // UDP header and payload.
+    const uint8_t* udp = ip + 20;
+    EXPECT_EQ(68, readUint16(udp));
+    EXPECT_EQ(67, readUint16(udp + 2));
+    EXPECT_EQ(13, readUint16(udp + 4));
+    EXPECT_EQ(packet.data_, vector<uint8_t>(udp + 8, udp + 13));
+    // Padding.
+    EXPECT_EQ(vector<uint8_t>(3, 0), vector<uint8_t>(udp + 13, udp + 16));
+}
+
+// Verifies the comment option.
+TEST(PcapngWriterTest, comment) {
+    OutputBuffer buf(0);
+    TracedPacket packet = makePacket();
+    packet.comment_ = "query DHCPACK";
+    ASSERT_NO_THROW(PcapngWriter::writePacket(buf, packet));
+    // The comment of 13 bytes is padded to 16 and followed by the end of
+    // options.
+    ASSERT_EQ(68 + 4 + 16 + 4, buf.getLength());
+    const uint8_t* data = static_cast<const uint8_t*>(buf.getData());
+    EXPECT_EQ(92, readUint32(data + 4));
+    EXPECT_EQ(92, readUint32(data + 88));
+
+    const uint8_t* option = data + 64;
+    EXPECT_EQ(PcapngWriter::OPT_COMMENT, readUint16(option));
+    EXPECT_EQ(13, readUint16(option + 2));
+    EXPECT_EQ(packet.comment_, string(option + 4, option + 17));
+    EXPECT_EQ(0, readUint32(option + 20));
+}
+
+// Verifies that only IPv4 packets can be written.
+TEST(PcapngWriterTest, badPacket) {
+    OutputBuffer buf(0);
+    TracedPacket packet = makePacket();
+    packet.source_ = IOAddress("2001:db8::1");
+    EXPECT_THROW(PcapngWriter::writePacket(buf, packet), BadValue);
+
+    packet = makePacket();
+    packet.data_.resize(65536);
+    EXPECT_THROW(PcapngWriter::writePacket(buf, packet), BadValue);
+    EXPECT_EQ(0, buf.getLength());
+}
+
+} // end of anonymous namespace
@@ -4573,6 +4573,9 @@ PgSqlConfigBackendDHCPv4Impl::PgSqlConfigBackendDHCPv4Impl(const DatabaseConnect
 
     // Create ReconnectCtl for this connection.
     conn_.makeReconnectCtl(timer_name_);
+
+    // Channel notified on the configuration changes.
+    notify_channel_ = "kea_dhcp4_config";
 }
 
 PgSqlConfigBackendDHCPv4Impl::~PgSqlConfigBackendDHCPv4Impl() {
@@ -4602,6 +4605,21 @@ PgSqlConfigBackendDHCPv4::getParameters() const {
     return (impl_->getParameters());
 }
 
+bool
+PgSqlConfigBackendDHCPv4::supportsParallelFetch() const {
+    return (true);
+}
+
+int
+PgSqlConfigBackendDHCPv4::getChangeNotificationSocket() {
+    return (impl_->getChangeNotificationSocket());
+}
+
+bool
+PgSqlConfigBackendDHCPv4::consumeChangeNotifications() {
+    return (impl_->consumeChangeNotifications());
+}
+
 Subnet4Ptr
 PgSqlConfigBackendDHCPv4::getSubnet4(const ServerSelector& server_selector,
                                      const std::string& subnet_prefix) const {
@@ -5034,6 +5034,9 @@ PgSqlConfigBackendDHCPv6Impl::PgSqlConfigBackendDHCPv6Impl(const DatabaseConnect
 
     // Create ReconnectCtl for this connection.
     conn_.makeReconnectCtl(timer_name_);
+
+    // Channel notified on the configuration changes.
+    notify_channel_ = "kea_dhcp6_config";
 }
 
 PgSqlConfigBackendDHCPv6Impl::~PgSqlConfigBackendDHCPv6Impl() {
@@ -5063,6 +5066,21 @@ PgSqlConfigBackendDHCPv6::getParameters() const {
     return (impl_->getParameters());
 }
 
+bool
+PgSqlConfigBackendDHCPv6::supportsParallelFetch() const {
+    return (true);
+}
+
+int
+PgSqlConfigBackendDHCPv6::getChangeNotificationSocket() {
+    return (impl_->getChangeNotificationSocket());
+}
+
+bool
+PgSqlConfigBackendDHCPv6::consumeChangeNotifications() {
+    return (impl_->consumeChangeNotifications());
+}
+
 Subnet6Ptr
 PgSqlConfigBackendDHCPv6::getSubnet6(const ServerSelector& server_selector,
                                      const std::string& subnet_prefix) const {
@@ -1,4 +1,4 @@
-// Copyright (C) 2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2022-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -644,6 +644,23 @@ public:
     /// @return Parameters of the backend.
     isc::db::DatabaseConnection::ParameterMap getParameters() const;
 
+    /// @brief Checks if the configuration can be fetched in parallel.
+    ///
+    /// @return true, the new instances open their own connection to the
+    /// same database.
+    virtual bool supportsParallelFetch() const;
+
+    /// @brief Returns the socket notifying about configuration changes.
+    ///
+    /// @return Socket descriptor of the connection listening on the
+    /// change notification channel or -1 if it could not be opened.
+    virtual int getChangeNotificationSocket();
+
+    /// @brief Consumes the pending configuration change notifications.
+    ///
+    /// @return true if at least one change was notified, false otherwise.
+    virtual bool consumeChangeNotifications();
+
 protected:
 
     /// @brief Pointer to the implementation of the @c PgSqlConfigBackendDHCPv6
@@ -150,6 +150,12 @@ PgSqlConfigBackendImpl::createAuditRevision(const int index,
     in_bindings.add(cascade_transaction);
 
     insertQuery(index, in_bindings);
+
+    // Notify the listening servers. The notification is delivered when
+    // the transaction is committed.
+    if (!notify_channel_.empty()) {
+        conn_.executeSQL("NOTIFY " + notify_channel_);
+    }
 }
 
 void
@@ -160,6 +166,58 @@ PgSqlConfigBackendImpl::clearAuditRevision() {
     --audit_revision_ref_count_;
 }
 
+int
+PgSqlConfigBackendImpl::getChangeNotificationSocket() {
+    if (notify_channel_.empty()) {
+        return (-1);
+    }
+
+    if (!listen_conn_) {
+        try {
+            listen_conn_.reset(new PgSqlConnection(parameters_));
+            listen_conn_->openDatabase();
+            listen_conn_->executeSQL("LISTEN " + notify_channel_);
+            LOG_INFO(pgsql_cb_logger, PGSQL_CB_LISTEN)
+                .arg(notify_channel_);
+
+        } catch (const std::exception& ex) {
+            LOG_WARN(pgsql_cb_logger, PGSQL_CB_LISTEN_FAILED)
+                .arg(notify_channel_)
+                .arg(ex.what());
+            listen_conn_.reset();
+            return (-1);
+        }
+    }
+
+    return (PQsocket(*listen_conn_));
+}
+
+bool
+PgSqlConfigBackendImpl::consumeChangeNotifications() {
+    if (!listen_conn_) {
+        return (false);
+    }
+
+    if (!PQconsumeInput(*listen_conn_)) {
+        // The connection is reopened by the next call to
+        // getChangeNotificationSocket. Meanwhile the changes may be missed
+        // so let the caller fetch them.
+        LOG_WARN(pgsql_cb_logger, PGSQL_CB_LISTEN_LOST)
+            .arg(notify_channel_)
+            .arg(PQerrorMessage(*listen_conn_));
+        listen_conn_.reset();
+        return (true);
+    }
+
+    bool changed = false;
+    PGnotify* notify;
+    while ((notify = PQnotifies(*listen_conn_)) != 0) {
+        changed = true;
+        PQfreemem(notify);
+    }
+    return (changed);
+}
+
 void
 PgSqlConfigBackendImpl::getRecentAuditEntries(const int index,
                                               const db::ServerSelector& server_selector,
@@ -23,6 +23,8 @@
 #include <pgsql/pgsql_connection.h>
 #include <pgsql/pgsql_exchange.h>
 
+#include <boost/scoped_ptr.hpp>
+
 #include <set>
 #include <sstream>
 #include <string>
@@ -800,6 +802,26 @@ public:
         return (parameters_);
     }
 
+    /// @brief Returns the socket notifying about configuration changes.
+    ///
+    /// Opens a dedicated connection listening on the change notification
+    /// channel if it is not opened yet. The channel is notified by the
+    /// @c createAuditRevision function so the notifications are delivered
+    /// when the configuration changes are committed.
+    ///
+    /// @return Socket descriptor of the listening connection or -1 if
+    /// it could not be opened.
+    int getChangeNotificationSocket();
+
+    /// @brief Consumes the pending configuration change notifications.
+    ///
+    /// If the listening connection has failed it is closed and the
+    /// function returns true so the caller fetches the changes which
+    /// may have been missed.
+    ///
+    /// @return true if at least one change was notified, false otherwise.
+    bool consumeChangeNotifications();
+
     /// @brief Sets IO service to be used by the PostgreSQL config backend.
     ///
     /// @param IOService object, used for all ASIO operations.
@@ -880,6 +902,11 @@ protected:
     /// @brief Timer name used to register database reconnect timer.
     std::string timer_name_;
 
+    /// @brief Name of the configuration change notification channel.
+    ///
+    /// The notifications are disabled when it is empty.
+    std::string notify_channel_;
+
 private:
 
     /// @brief Reference counter for @ScopedAuditRevision instances.
@@ -888,6 +915,9 @@ private:
     /// @brief Connection parameters
     isc::db::DatabaseConnection::ParameterMap parameters_;
 
+    /// @brief Connection listening on the change notification channel.
+    boost::scoped_ptr<db::PgSqlConnection> listen_conn_;
+
     /// @brief The IOService object, used for all ASIO operations.
     static isc::asiolink::IOServicePtr io_service_;
 
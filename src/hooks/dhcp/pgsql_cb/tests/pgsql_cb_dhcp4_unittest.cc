@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -21,8 +21,10 @@
 #include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
 #include <gtest/gtest.h>
+#include <chrono>
 #include <map>
 #include <sstream>
+#include <thread>
 
 using namespace isc;
 using namespace isc::asiolink;
@@ -129,6 +131,29 @@ TEST_F(PgSqlConfigBackendDHCPv4Test, getPort) {
     getPortTest();
 }
 
+// Verifies that the committed configuration changes are notified.
+TEST_F(PgSqlConfigBackendDHCPv4Test, changeNotifications) {
+    int socket = cbptr_->getChangeNotificationSocket();
+    ASSERT_GE(socket, 0);
+    EXPECT_EQ(socket, cbptr_->getChangeNotificationSocket());
+    EXPECT_FALSE(cbptr_->consumeChangeNotifications());
+
+    StampedValuePtr global_parameter = StampedValue::create("global", "whale");
+    ASSERT_NO_THROW(cbptr_->createUpdateGlobalParameter4(ServerSelector::ALL(),
+                                                         global_parameter));
+
+    // The notification is delivered asynchronously.
+    bool notified = false;
+    for (int i = 0; (i < 100) && !notified; ++i) {
+        notified = cbptr_->consumeChangeNotifications();
+        if (!notified) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    EXPECT_TRUE(notified);
+    EXPECT_FALSE(cbptr_->consumeChangeNotifications());
+}
+
 TEST_F(PgSqlConfigBackendDHCPv4Test, createUpdateDeleteServerTest) {
     createUpdateDeleteServerTest();
 }
@@ -0,0 +1,89 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <icmp_msg.h>
+
+#include <netinet/in.h>
+
+using namespace isc::asiolink;
+using namespace std;
+
+namespace isc {
+namespace ping_check {
+
+const size_t ICMPMsg::ICMP_HEADER_SIZE;
+const size_t ICMPMsg::IP_HEADER_SIZE;
+
+ICMPMsg::ICMPMsg(uint8_t type, uint16_t id, uint16_t sequence)
+    : type_(type), code_(0), id_(id), sequence_(sequence),
+      source_(IOAddress::IPV4_ZERO_ADDRESS()), payload_() {
+}
+
+vector<uint8_t>
+ICMPMsg::pack() const {
+    vector<uint8_t> wire(ICMP_HEADER_SIZE);
+    wire[0] = type_;
+    wire[1] = code_;
+    wire[4] = static_cast<uint8_t>(id_ >> 8);
+    wire[5] = static_cast<uint8_t>(id_ & 0xff);
+    wire[6] = static_cast<uint8_t>(sequence_ >> 8);
+    wire[7] = static_cast<uint8_t>(sequence_ & 0xff);
+    wire.insert(wire.end(), payload_.begin(), payload_.end());
+    uint16_t checksum = calcChecksum(&wire[0], wire.size());
+    wire[2] = static_cast<uint8_t>(checksum >> 8);
+    wire[3] = static_cast<uint8_t>(checksum & 0xff);
+    return (wire);
+}
+
+ICMPMsgPtr
+ICMPMsg::unpack(const uint8_t* data, size_t length) {
+    if (!data || (length < IP_HEADER_SIZE)) {
+        return (ICMPMsgPtr());
+    }
+    // The IPv4 header length is in 32 bit words.
+    size_t ip_length = (data[0] & 0x0f) * 4;
+    if (((data[0] >> 4) != 4) || (ip_length < IP_HEADER_SIZE) ||
+        (data[9] != IPPROTO_ICMP) ||
+        (length < ip_length + ICMP_HEADER_SIZE)) {
+        return (ICMPMsgPtr());
+    }
+    const uint8_t* icmp = data + ip_length;
+    size_t icmp_length = length - ip_length;
+    if (calcChecksum(icmp, icmp_length) != 0) {
+        return (ICMPMsgPtr());
+    }
+    ICMPMsgPtr msg(new ICMPMsg(icmp[0],
+                               static_cast<uint16_t>((icmp[4] << 8) | icmp[5]),
+                               static_cast<uint16_t>((icmp[6] << 8) | icmp[7])));
+    msg->code_ = icmp[1];
+    msg->source_ = IOAddress((static_cast<uint32_t>(data[12]) << 24) |
+                             (static_cast<uint32_t>(data[13]) << 16) |
+                             (static_cast<uint32_t>(data[14]) << 8) |
+                             static_cast<uint32_t>(data[15]));
+    msg->payload_.assign(icmp + ICMP_HEADER_SIZE, icmp + icmp_length);
+    return (msg);
+}
+
+uint16_t
+ICMPMsg::calcChecksum(const uint8_t* data, size_t length) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i + 1 < length; i += 2) {
+        sum += (static_cast<uint32_t>(data[i]) << 8) | data[i + 1];
+    }
+    // Pad an odd byte with zero.
+    if (length & 1) {
+        sum += static_cast<uint32_t>(data[length - 1]) << 8;
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return (static_cast<uint16_t>(~sum & 0xffff));
+}
+
+} // end of namespace isc::ping_check
+} // end of namespace isc
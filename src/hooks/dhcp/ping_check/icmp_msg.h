@@ -0,0 +1,134 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef ICMP_MSG_H
+#define ICMP_MSG_H
+
+#include <asiolink/io_address.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+#include <stdint.h>
+
+namespace isc {
+namespace ping_check {
+
+/// @brief ICMP echo message.
+///
+/// Only the echo request and echo reply messages (RFC 792) are used
+/// by the ping check: they share the same layout.
+class ICMPMsg {
+public:
+    /// @brief ICMP message types.
+    enum MsgType {
+        ECHO_REPLY = 0,
+        ECHO_REQUEST = 8
+    };
+
+    /// @brief Size of the ICMP echo header.
+    static const size_t ICMP_HEADER_SIZE = 8;
+
+    /// @brief Minimum size of the IPv4 header.
+    static const size_t IP_HEADER_SIZE = 20;
+
+    /// @brief Constructor.
+    ///
+    /// @param type the message type.
+    /// @param id the echo identifier.
+    /// @param sequence the echo sequence number.
+    ICMPMsg(uint8_t type = ECHO_REQUEST, uint16_t id = 0,
+            uint16_t sequence = 0);
+
+    /// @brief Returns the message type.
+    uint8_t getType() const {
+        return (type_);
+    }
+
+    /// @brief Returns the message code.
+    uint8_t getCode() const {
+        return (code_);
+    }
+
+    /// @brief Returns the echo identifier.
+    uint16_t getId() const {
+        return (id_);
+    }
+
+    /// @brief Returns the echo sequence number.
+    uint16_t getSequence() const {
+        return (sequence_);
+    }
+
+    /// @brief Returns the source address of a received message.
+    const asiolink::IOAddress& getSource() const {
+        return (source_);
+    }
+
+    /// @brief Returns the payload.
+    const std::vector<uint8_t>& getPayload() const {
+        return (payload_);
+    }
+
+    /// @brief Sets the payload.
+    ///
+    /// @param payload the payload.
+    void setPayload(const std::vector<uint8_t>& payload) {
+        payload_ = payload;
+    }
+
+    /// @brief Builds the wire format of the message.
+    ///
+    /// The raw socket adds the IPv4 header.
+    ///
+    /// @return the ICMP header followed by the payload, with the checksum.
+    std::vector<uint8_t> pack() const;
+
+    /// @brief Parses a message received on a raw ICMP socket.
+    ///
+    /// @param data the received data, beginning with the IPv4 header.
+    /// @param length the length of the data.
+    /// @return the message or null if the data is not a valid ICMP message:
+    /// too short, not ICMP or with a bad checksum.
+    static boost::shared_ptr<ICMPMsg> unpack(const uint8_t* data,
+                                             size_t length);
+
+    /// @brief Computes the internet checksum (RFC 1071).
+    ///
+    /// @param data the data.
+    /// @param length the length of the data.
+    /// @return the checksum in host byte order: 0 when a message holding
+    /// its checksum is valid.
+    static uint16_t calcChecksum(const uint8_t* data, size_t length);
+
+private:
+    /// @brief The message type.
+    uint8_t type_;
+
+    /// @brief The message code.
+    uint8_t code_;
+
+    /// @brief The echo identifier.
+    uint16_t id_;
+
+    /// @brief The echo sequence number.
+    uint16_t sequence_;
+
+    /// @brief The source address of a received message.
+    asiolink::IOAddress source_;
+
+    /// @brief The payload.
+    std::vector<uint8_t> payload_;
+};
+
+/// @brief Pointer to an ICMP message.
+typedef boost::shared_ptr<ICMPMsg> ICMPMsgPtr;
+
+} // end of namespace isc::ping_check
+} // end of namespace isc
+
+#endif // ICMP_MSG_H
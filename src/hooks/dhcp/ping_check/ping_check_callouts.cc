@@ -0,0 +1,121 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <hooks/hooks.h>
+#include <ping_check_log.h>
+#include <ping_check_mgr.h>
+#include <dhcp/pkt4.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/lease.h>
+#include <process/daemon.h>
+
+#include <string>
+
+namespace isc {
+namespace ping_check {
+
+PingCheckMgrPtr mgr;
+
+} // namespace ping_check
+} // namespace isc
+
+using namespace isc;
+using namespace isc::dhcp;
+using namespace isc::hooks;
+using namespace isc::ping_check;
+using namespace isc::process;
+using namespace std;
+
+// Functions accessed by the hooks framework use C linkage to avoid the name
+// mangling that accompanies use of the C++ compiler as well as to avoid
+// issues related to namespaces.
+extern "C" {
+
+/// @brief This function is called when the library is loaded.
+///
+/// @param handle library handle
+/// @return 0 when initialization is successful, 1 otherwise
+int load(LibraryHandle& handle) {
+    try {
+        // Make the hook library loadable only by kea-dhcp4.
+        uint16_t family = CfgMgr::instance().getFamily();
+        const string& proc_name = Daemon::getProcName();
+        if ((family != AF_INET) || (proc_name != "kea-dhcp4")) {
+            isc_throw(isc::Unexpected, "Bad process name: " << proc_name
+                      << ", expected kea-dhcp4");
+        }
+
+        mgr.reset(new PingCheckMgr());
+        mgr->configure(handle);
+        mgr->start();
+    } catch (const exception& ex) {
+        mgr.reset();
+        LOG_ERROR(ping_check_logger, PING_CHECK_LOAD_ERROR)
+            .arg(ex.what());
+        return (1);
+    }
+
+    LOG_INFO(ping_check_logger, PING_CHECK_LOAD);
+    return (0);
+}
+
+/// @brief This function is called when the library is unloaded.
+///
+/// The parked queries are dropped.
+///
+/// @return always 0.
+int unload() {
+    mgr.reset();
+    LOG_INFO(ping_check_logger, PING_CHECK_UNLOAD);
+    return (0);
+}
+
+/// @brief This callout is called at the "lease4_offer" hook.
+///
+/// Parks the DHCPDISCOVER until the offered address is checked. The
+/// address of the current lease of the client is not checked.
+///
+/// @param handle the callout handle.
+/// @return 0 on success, 1 otherwise.
+int lease4_offer(CalloutHandle& handle) {
+    CalloutHandle::CalloutNextStep status = handle.getStatus();
+    if ((status == CalloutHandle::NEXT_STEP_DROP) || !mgr) {
+        return (0);
+    }
+
+    Pkt4Ptr query;
+    try {
+        handle.getArgument("query4", query);
+        Lease4CollectionPtr leases;
+        handle.getArgument("leases4", leases);
+        if (!leases || leases->empty()) {
+            return (0);
+        }
+        Lease4Ptr old_lease;
+        handle.getArgument("old_lease", old_lease);
+        if (mgr->startPing(leases->front(), old_lease, query,
+                           handle.getParkingLotHandlePtr())) {
+            handle.setStatus(CalloutHandle::NEXT_STEP_PARK);
+        }
+    } catch (const exception& ex) {
+        LOG_ERROR(ping_check_logger, PING_CHECK_CALLOUT_ERROR)
+            .arg(query ? query->getLabel() : "unknown")
+            .arg(ex.what());
+        return (1);
+    }
+    return (0);
+}
+
+/// @brief This function is called to retrieve the multi-threading compatibility.
+///
+/// @return 1 which means compatible with multi-threading.
+int multi_threading_compatible() {
+    return (1);
+}
+
+} // end extern "C"
@@ -0,0 +1,17 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <ping_check_log.h>
+
+namespace isc {
+namespace ping_check {
+
+isc::log::Logger ping_check_logger("ping-check-hooks");
+
+} // namespace ping_check
+} // namespace isc
@@ -0,0 +1,35 @@
+// File created from ../../../../src/hooks/dhcp/ping_check/ping_check_messages.mes
+
+#include <cstddef>
+#include <log/message_types.h>
+#include <log/message_initializer.h>
+
+extern const isc::log::MessageID PING_CHECK_ADDRESS_FREE = "PING_CHECK_ADDRESS_FREE";
+extern const isc::log::MessageID PING_CHECK_ADDRESS_IN_USE = "PING_CHECK_ADDRESS_IN_USE";
+extern const isc::log::MessageID PING_CHECK_CALLOUT_ERROR = "PING_CHECK_CALLOUT_ERROR";
+extern const isc::log::MessageID PING_CHECK_DECLINE_FAILED = "PING_CHECK_DECLINE_FAILED";
+extern const isc::log::MessageID PING_CHECK_LOAD = "PING_CHECK_LOAD";
+extern const isc::log::MessageID PING_CHECK_LOAD_ERROR = "PING_CHECK_LOAD_ERROR";
+extern const isc::log::MessageID PING_CHECK_RECEIVE_FAILED = "PING_CHECK_RECEIVE_FAILED";
+extern const isc::log::MessageID PING_CHECK_SEND_FAILED = "PING_CHECK_SEND_FAILED";
+extern const isc::log::MessageID PING_CHECK_UNLOAD = "PING_CHECK_UNLOAD";
+
+namespace {
+
+const char* values[] = {
+    "PING_CHECK_ADDRESS_FREE", "address %1 did not answer the ping check, offering it",
+    "PING_CHECK_ADDRESS_IN_USE", "address %1 offered to %2 answered the ping check, declining it",
+    "PING_CHECK_CALLOUT_ERROR", "error checking the address offered to %1: %2",
+    "PING_CHECK_DECLINE_FAILED", "failed to decline address %1: %2",
+    "PING_CHECK_LOAD", "Ping Check hooks library has been loaded",
+    "PING_CHECK_LOAD_ERROR", "Ping Check hooks library failed: %1",
+    "PING_CHECK_RECEIVE_FAILED", "error reading the ICMP socket: %1",
+    "PING_CHECK_SEND_FAILED", "error sending the echo request to %1: %2",
+    "PING_CHECK_UNLOAD", "Ping Check hooks library has been unloaded",
+    NULL
+};
+
+const isc::log::MessageInitializer initializer(values);
+
+} // Anonymous namespace
+
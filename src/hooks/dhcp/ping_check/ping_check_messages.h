@@ -0,0 +1,18 @@
+// File created from ../../../../src/hooks/dhcp/ping_check/ping_check_messages.mes
+
+#ifndef PING_CHECK_MESSAGES_H
+#define PING_CHECK_MESSAGES_H
+
+#include <log/message_types.h>
+
+extern const isc::log::MessageID PING_CHECK_ADDRESS_FREE;
+extern const isc::log::MessageID PING_CHECK_ADDRESS_IN_USE;
+extern const isc::log::MessageID PING_CHECK_CALLOUT_ERROR;
+extern const isc::log::MessageID PING_CHECK_DECLINE_FAILED;
+extern const isc::log::MessageID PING_CHECK_LOAD;
+extern const isc::log::MessageID PING_CHECK_LOAD_ERROR;
+extern const isc::log::MessageID PING_CHECK_RECEIVE_FAILED;
+extern const isc::log::MessageID PING_CHECK_SEND_FAILED;
+extern const isc::log::MessageID PING_CHECK_UNLOAD;
+
+#endif // PING_CHECK_MESSAGES_H
@@ -0,0 +1,425 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <ping_check_mgr.h>
+#include <ping_check_log.h>
+#include <cc/data.h>
+#include <dhcp/iface_mgr.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/timer_mgr.h>
+#include <exceptions/exceptions.h>
+#include <stats/stats_mgr.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::hooks;
+using namespace isc::log;
+using namespace isc::stats;
+using namespace std;
+
+namespace isc {
+namespace ping_check {
+
+PingCache::PingCache(uint32_t lifetime)
+    : lifetime_(lifetime), entries_(), mutex_(new mutex()) {
+}
+
+void
+PingCache::setFree(const IOAddress& address, time_t now) {
+    if (lifetime_ == 0) {
+        return;
+    }
+    lock_guard<mutex> lk(*mutex_);
+    entries_[address.toUint32()] = now;
+}
+
+bool
+PingCache::isFree(const IOAddress& address, time_t now) {
+    lock_guard<mutex> lk(*mutex_);
+    auto it = entries_.find(address.toUint32());
+    if (it == entries_.end()) {
+        return (false);
+    }
+    if (now - it->second < static_cast<time_t>(lifetime_)) {
+        return (true);
+    }
+    entries_.erase(it);
+    return (false);
+}
+
+void
+PingCache::remove(const IOAddress& address) {
+    lock_guard<mutex> lk(*mutex_);
+    entries_.erase(address.toUint32());
+}
+
+void
+PingCache::prune(time_t now) {
+    lock_guard<mutex> lk(*mutex_);
+    for (auto it = entries_.begin(); it != entries_.end(); ) {
+        if (now - it->second >= static_cast<time_t>(lifetime_)) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t
+PingCache::size() const {
+    lock_guard<mutex> lk(*mutex_);
+    return (entries_.size());
+}
+
+const long PingCheckMgr::DEFAULT_PING_TIMEOUT;
+const uint32_t PingCheckMgr::DEFAULT_CACHE_LIFETIME;
+const char* PingCheckMgr::ENABLE_PARAM = "enable-ping-check";
+
+PingCheckMgr::PingCheckMgr()
+    : enable_(true), ping_timeout_(DEFAULT_PING_TIMEOUT),
+      cache_(new PingCache(DEFAULT_CACHE_LIFETIME)), socket_(-1),
+      id_(static_cast<uint16_t>(getpid() & 0xffff)), sequence_(0),
+      probes_(), mutex_(new mutex()) {
+}
+
+PingCheckMgr::~PingCheckMgr() {
+    stop();
+}
+
+void
+PingCheckMgr::configure(LibraryHandle& handle) {
+    ConstElementPtr enable = handle.getParameter(ENABLE_PARAM);
+    if (enable) {
+        if (enable->getType() != Element::boolean) {
+            isc_throw(BadValue, "the '" << ENABLE_PARAM
+                      << "' parameter must be a boolean");
+        }
+        enable_ = enable->boolValue();
+    }
+    ConstElementPtr timeout = handle.getParameter("ping-timeout");
+    if (timeout) {
+        if ((timeout->getType() != Element::integer) ||
+            (timeout->intValue() <= 0) || (timeout->intValue() > 10000)) {
+            isc_throw(BadValue, "the 'ping-timeout' parameter must be an"
+                      " integer between 1 and 10000 milliseconds");
+        }
+        ping_timeout_ = static_cast<long>(timeout->intValue());
+    }
+    uint32_t lifetime = DEFAULT_CACHE_LIFETIME;
+    ConstElementPtr cache = handle.getParameter("ping-cache-lifetime");
+    if (cache) {
+        if ((cache->getType() != Element::integer) ||
+            (cache->intValue() < 0) || (cache->intValue() > 86400)) {
+            isc_throw(BadValue, "the 'ping-cache-lifetime' parameter must be"
+                      " an integer between 0 and 86400 seconds");
+        }
+        lifetime = static_cast<uint32_t>(cache->intValue());
+    }
+    cache_.reset(new PingCache(lifetime));
+}
+
+void
+PingCheckMgr::start() {
+    if (socket_ >= 0) {
+        return;
+    }
+    int fd = socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+    if (fd < 0) {
+        isc_throw(Unexpected, "unable to open the raw ICMP socket: "
+                  << strerror(errno));
+    }
+    // The socket is read by the main thread until there is no more data.
+    if ((fcntl(fd, F_SETFL, O_NONBLOCK) < 0) ||
+        (fcntl(fd, F_SETFD, FD_CLOEXEC) < 0)) {
+        int err = errno;
+        close(fd);
+        isc_throw(Unexpected, "unable to set the raw ICMP socket flags: "
+                  << strerror(err));
+    }
+    socket_ = fd;
+    IfaceMgr::instance().addExternalSocket(socket_,
+                                           [this](int) { receive(); });
+}
+
+void
+PingCheckMgr::stop() {
+    if (socket_ >= 0) {
+        IfaceMgr::instance().deleteExternalSocket(socket_);
+        close(socket_);
+        socket_ = -1;
+    }
+    ProbeMap probes;
+    {
+        lock_guard<mutex> lk(*mutex_);
+        probes.swap(probes_);
+    }
+    if (probes.empty()) {
+        return;
+    }
+    TimerWheelPtr wheel = TimerMgr::instance()->getTimerWheel();
+    for (auto const& it : probes) {
+        wheel->cancel(it.second.timer_id_);
+        for (auto const& query : it.second.queries_) {
+            it.second.parking_lot_->drop(query);
+        }
+    }
+}
+
+bool
+PingCheckMgr::isEnabled(const Lease4Ptr& lease) const {
+    if (!lease) {
+        return (false);
+    }
+    ConstSubnet4Ptr subnet = CfgMgr::instance().getCurrentCfg()->
+        getCfgSubnets4()->getBySubnetId(lease->subnet_id_);
+    if (subnet) {
+        ConstElementPtr context = subnet->getContext();
+        if (context && (context->getType() == Element::map)) {
+            ConstElementPtr enable = context->get(ENABLE_PARAM);
+            if (enable && (enable->getType() == Element::boolean)) {
+                return (enable->boolValue());
+            }
+        }
+    }
+    return (enable_);
+}
+
+bool
+PingCheckMgr::shouldPing(const Lease4Ptr& lease, const Lease4Ptr& old_lease) {
+    if (!isEnabled(lease)) {
+        return (false);
+    }
+    // The client is using the address: it answers.
+    if (old_lease && (old_lease->addr_ == lease->addr_) &&
+        old_lease->belongsToClient(lease->hwaddr_, lease->client_id_)) {
+        return (false);
+    }
+    return (!cache_->isFree(lease->addr_, time(0)));
+}
+
+bool
+PingCheckMgr::startPing(const Lease4Ptr& lease, const Lease4Ptr& old_lease,
+                        const Pkt4Ptr& query,
+                        const ParkingLotHandlePtr& parking_lot) {
+    if ((socket_ < 0) || !shouldPing(lease, old_lease)) {
+        return (false);
+    }
+    uint32_t key = lease->addr_.toUint32();
+    uint16_t sequence = 0;
+    {
+        lock_guard<mutex> lk(*mutex_);
+        auto it = probes_.find(key);
+        if (it != probes_.end()) {
+            // The address is already being checked for another query.
+            parking_lot->reference(query);
+            it->second.queries_.push_back(query);
+            return (true);
+        }
+        sequence = ++sequence_;
+        Probe& probe = probes_[key];
+        probe.sequence_ = sequence;
+        probe.timer_id_ = 0;
+        probe.lease_ = lease;
+        probe.queries_.push_back(query);
+        probe.parking_lot_ = parking_lot;
+        parking_lot->reference(query);
+    }
+
+    IOAddress address = lease->addr_;
+    TimerWheel::TimerId timer_id = 0;
+    try {
+        timer_id = TimerMgr::instance()->getTimerWheel()->schedule(ping_timeout_,
+            [this, address, sequence]() { expire(address, sequence); });
+    } catch (...) {
+        // Do not leave a check which would never expire: the queries
+        // added in the meantime get the offer without the check.
+        vector<Pkt4Ptr> queries;
+        {
+            lock_guard<mutex> lk(*mutex_);
+            auto it = probes_.find(key);
+            if (it != probes_.end()) {
+                queries.swap(it->second.queries_);
+                probes_.erase(it);
+            }
+        }
+        parking_lot->dereference(query);
+        for (auto const& other : queries) {
+            if (other != query) {
+                parking_lot->unpark(other);
+            }
+        }
+        throw;
+    }
+    bool sent = sendEcho(address, sequence);
+    {
+        lock_guard<mutex> lk(*mutex_);
+        auto it = probes_.find(key);
+        if (it != probes_.end() && (it->second.sequence_ == sequence)) {
+            it->second.timer_id_ = timer_id;
+        }
+    }
+    if (!sent) {
+        // Do not delay the offer when the request can't be sent.
+        TimerMgr::instance()->getTimerWheel()->cancel(timer_id);
+        expire(address, sequence);
+    }
+    return (true);
+}
+
+bool
+PingCheckMgr::sendEcho(const IOAddress& address, uint16_t sequence) {
+    ICMPMsg msg(ICMPMsg::ECHO_REQUEST, id_, sequence);
+    vector<uint8_t> payload(8);
+    uint32_t addr = address.toUint32();
+    for (size_t i = 0; i < 4; ++i) {
+        payload[i] = static_cast<uint8_t>(addr >> (24 - 8 * i));
+    }
+    msg.setPayload(payload);
+    vector<uint8_t> wire = msg.pack();
+
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = htonl(addr);
+    ssize_t sent = sendto(socket_, &wire[0], wire.size(), 0,
+                          reinterpret_cast<struct sockaddr*>(&to), sizeof(to));
+    if (sent < 0) {
+        LOG_ERROR(ping_check_logger, PING_CHECK_SEND_FAILED)
+            .arg(address.toText())
+            .arg(strerror(errno));
+        return (false);
+    }
+    return (true);
+}
+
+void
+PingCheckMgr::receive() {
+    uint8_t buf[1500];
+    for (;;) {
+        ssize_t length = recv(socket_, buf, sizeof(buf), 0);
+        if (length < 0) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK) &&
+                (errno != EINTR)) {
+                LOG_ERROR(ping_check_logger, PING_CHECK_RECEIVE_FAILED)
+                    .arg(strerror(errno));
+            }
+            return;
+        }
+        handleMessage(ICMPMsg::unpack(buf, static_cast<size_t>(length)));
+    }
+}
+
+void
+PingCheckMgr::handleMessage(const ICMPMsgPtr& msg) {
+    // The raw socket receives all the ICMP messages.
+    if (!msg || (msg->getType() != ICMPMsg::ECHO_REPLY) ||
+        (msg->getId() != id_)) {
+        return;
+    }
+    Probe probe;
+    {
+        lock_guard<mutex> lk(*mutex_);
+        auto it = probes_.find(msg->getSource().toUint32());
+        if ((it == probes_.end()) ||
+            (it->second.sequence_ != msg->getSequence())) {
+            return;
+        }
+        probe = it->second;
+        probes_.erase(it);
+    }
+    TimerMgr::instance()->getTimerWheel()->cancel(probe.timer_id_);
+    cache_->remove(probe.lease_->addr_);
+    LOG_WARN(ping_check_logger, PING_CHECK_ADDRESS_IN_USE)
+        .arg(probe.lease_->addr_.toText())
+        .arg(probe.queries_.front()->getLabel());
+    declineLease(probe.lease_);
+    for (auto const& query : probe.queries_) {
+        probe.parking_lot_->drop(query);
+    }
+}
+
+void
+PingCheckMgr::expire(const IOAddress& address, uint16_t sequence) {
+    Probe probe;
+    {
+        lock_guard<mutex> lk(*mutex_);
+        auto it = probes_.find(address.toUint32());
+        if ((it == probes_.end()) || (it->second.sequence_ != sequence)) {
+            return;
+        }
+        probe = it->second;
+        probes_.erase(it);
+    }
+    cache_->setFree(address, time(0));
+    LOG_DEBUG(ping_check_logger, DBGLVL_TRACE_BASIC, PING_CHECK_ADDRESS_FREE)
+        .arg(address.toText());
+    for (auto const& query : probe.queries_) {
+        probe.parking_lot_->unpark(query);
+    }
+}
+
+void
+PingCheckMgr::declineLease(const Lease4Ptr& lease) {
+    Lease4Ptr declined(new Lease4(*lease));
+    declined->decline(CfgMgr::instance().getCurrentCfg()->getDeclinePeriod());
+    bool assigned = false;
+    try {
+        Lease4Ptr existing =
+            LeaseMgrFactory::instance().getLease4(declined->addr_);
+        if (existing) {
+            // An expired lease which was not reclaimed is still counted.
+            assigned = existing->stateExpiredReclaimed();
+            // The lease managers check the lease did not change since it
+            // was read.
+            Lease::syncCurrentExpirationTime(*existing, *declined);
+            LeaseMgrFactory::instance().updateLease4(declined);
+        } else if (LeaseMgrFactory::instance().addLease(declined)) {
+            assigned = true;
+        } else {
+            isc_throw(Unexpected, "the lease already exists");
+        }
+    } catch (const std::exception& ex) {
+        LOG_ERROR(ping_check_logger, PING_CHECK_DECLINE_FAILED)
+            .arg(declined->addr_.toText())
+            .arg(ex.what());
+        return;
+    }
+
+    // The reclamation of the declined lease decreases both counters.
+    if (assigned) {
+        StatsMgr::instance().addValue(
+            StatsMgr::generateName("subnet", declined->subnet_id_,
+                                   "assigned-addresses"),
+            static_cast<int64_t>(1));
+    }
+    StatsMgr::instance().addValue(
+        StatsMgr::generateName("subnet", declined->subnet_id_,
+                               "declined-addresses"),
+        static_cast<int64_t>(1));
+    StatsMgr::instance().addValue("declined-addresses",
+                                  static_cast<int64_t>(1));
+}
+
+size_t
+PingCheckMgr::getPendingCount() const {
+    lock_guard<mutex> lk(*mutex_);
+    return (probes_.size());
+}
+
+} // end of namespace isc::ping_check
+} // end of namespace isc
@@ -0,0 +1,271 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PING_CHECK_MGR_H
+#define PING_CHECK_MGR_H
+
+#include <icmp_msg.h>
+#include <asiolink/timer_wheel.h>
+#include <dhcp/pkt4.h>
+#include <dhcpsrv/lease.h>
+#include <hooks/library_handle.h>
+#include <hooks/parking_lots.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <time.h>
+
+namespace isc {
+namespace ping_check {
+
+/// @brief Cache of the recent ping check results.
+///
+/// An address which did not answer is not checked again until the
+/// cache lifetime elapses, so a client retrying its DHCPDISCOVER is not
+/// delayed again. Only the free addresses are cached: an address in use
+/// is declined and is not offered during the probation period.
+class PingCache : public boost::noncopyable {
+public:
+    /// @brief Constructor.
+    ///
+    /// @param lifetime the lifetime of the entries in seconds, 0 disables
+    /// the cache.
+    explicit PingCache(uint32_t lifetime);
+
+    /// @brief Records that an address did not answer.
+    ///
+    /// @param address the address.
+    /// @param now the current time.
+    void setFree(const asiolink::IOAddress& address, time_t now);
+
+    /// @brief Checks if an address recently did not answer.
+    ///
+    /// The expired entry of the address is removed.
+    ///
+    /// @param address the address.
+    /// @param now the current time.
+    /// @return true if the address was found free less than the lifetime
+    /// ago.
+    bool isFree(const asiolink::IOAddress& address, time_t now);
+
+    /// @brief Removes an address.
+    ///
+    /// @param address the address.
+    void remove(const asiolink::IOAddress& address);
+
+    /// @brief Removes the expired entries.
+    ///
+    /// @param now the current time.
+    void prune(time_t now);
+
+    /// @brief Returns the number of entries.
+    size_t size() const;
+
+    /// @brief Returns the lifetime in seconds.
+    uint32_t getLifetime() const {
+        return (lifetime_);
+    }
+
+private:
+    /// @brief The lifetime in seconds.
+    uint32_t lifetime_;
+
+    /// @brief The time of the last check of the addresses.
+    std::unordered_map<uint32_t, time_t> entries_;
+
+    /// @brief Protects the entries.
+    boost::scoped_ptr<std::mutex> mutex_;
+};
+
+/// @brief Manages the ping checks of the offered addresses.
+///
+/// The echo requests are sent on a raw ICMP socket by the packet
+/// processing threads which park the DHCPDISCOVER. The socket is
+/// registered as an external socket of the interface manager so the
+/// replies are read by the main thread, and the timeouts are timers of
+/// the timing wheel of the timer manager which also run in the main
+/// thread: a worker thread never waits for a reply.
+///
+/// When the timeout elapses without a reply the address is cached as
+/// free and the query is unparked, so the offer is sent. When a reply is
+/// received the address is declined for the decline probation period and
+/// the query is dropped: the client retries and gets another address.
+class PingCheckMgr : public boost::noncopyable {
+public:
+    /// @brief Default ping timeout in milliseconds.
+    static const long DEFAULT_PING_TIMEOUT = 100;
+
+    /// @brief Default cache lifetime in seconds.
+    static const uint32_t DEFAULT_CACHE_LIFETIME = 60;
+
+    /// @brief Name of the subnet user context enabling the ping check.
+    static const char* ENABLE_PARAM;
+
+    /// @brief Constructor.
+    PingCheckMgr();
+
+    /// @brief Destructor.
+    ///
+    /// Stops the manager.
+    ~PingCheckMgr();
+
+    /// @brief Configures the manager.
+    ///
+    /// @param handle the library handle holding the parameters.
+    /// @throw BadValue if a parameter is invalid.
+    void configure(hooks::LibraryHandle& handle);
+
+    /// @brief Opens the raw socket and registers it.
+    ///
+    /// @throw Unexpected if the socket can't be opened, e.g. without the
+    /// privilege to open raw sockets.
+    void start();
+
+    /// @brief Closes the socket and drops the parked queries.
+    void stop();
+
+    /// @brief Checks if the ping check is enabled for a lease.
+    ///
+    /// The "enable-ping-check" entry of the subnet user context overrides
+    /// the library parameter.
+    ///
+    /// @param lease the offered lease.
+    /// @return true if the address of the lease must be checked.
+    bool isEnabled(const dhcp::Lease4Ptr& lease) const;
+
+    /// @brief Checks if an offered address must be checked.
+    ///
+    /// The address is not checked when the check is disabled, when it
+    /// is the address of the current lease of the client, which is
+    /// expected to answer, or when it recently did not answer.
+    ///
+    /// @param lease the offered lease.
+    /// @param old_lease the current lease of the client, may be null.
+    /// @return true if the address of the lease must be checked.
+    bool shouldPing(const dhcp::Lease4Ptr& lease,
+                    const dhcp::Lease4Ptr& old_lease);
+
+    /// @brief Checks an offered address.
+    ///
+    /// @param lease the offered lease.
+    /// @param old_lease the current lease of the client, may be null.
+    /// @param query the DHCPDISCOVER.
+    /// @param parking_lot the parking lot holding the query.
+    /// @return true if the query is parked until the end of the check,
+    /// false if the address does not need to be checked.
+    bool startPing(const dhcp::Lease4Ptr& lease,
+                   const dhcp::Lease4Ptr& old_lease,
+                   const dhcp::Pkt4Ptr& query,
+                   const hooks::ParkingLotHandlePtr& parking_lot);
+
+    /// @brief Handles a received message.
+    ///
+    /// @param msg the message.
+    void handleMessage(const ICMPMsgPtr& msg);
+
+    /// @brief Handles the expiration of a check.
+    ///
+    /// @param address the checked address.
+    /// @param sequence the sequence number of the echo request.
+    void expire(const asiolink::IOAddress& address, uint16_t sequence);
+
+    /// @brief Returns the number of pending checks.
+    size_t getPendingCount() const;
+
+    /// @brief Returns the ping timeout in milliseconds.
+    long getPingTimeout() const {
+        return (ping_timeout_);
+    }
+
+    /// @brief Returns the cache.
+    PingCache& getCache() {
+        return (*cache_);
+    }
+
+protected:
+    /// @brief Declines an address in use.
+    ///
+    /// The lease is added, or the existing lease of the address updated,
+    /// in the declined state. The assigned addresses statistic is only
+    /// increased when the address was not assigned, i.e. when there was
+    /// no lease or the lease was reclaimed, as it is decreased by the
+    /// reclamation of the declined lease.
+    ///
+    /// @param lease the offered lease.
+    void declineLease(const dhcp::Lease4Ptr& lease);
+
+private:
+    /// @brief A pending check.
+    struct Probe {
+        /// @brief The sequence number of the echo request.
+        uint16_t sequence_;
+
+        /// @brief The timer of the check.
+        asiolink::TimerWheel::TimerId timer_id_;
+
+        /// @brief The offered lease.
+        dhcp::Lease4Ptr lease_;
+
+        /// @brief The parked queries offered the address.
+        std::vector<dhcp::Pkt4Ptr> queries_;
+
+        /// @brief The parking lot holding the queries.
+        hooks::ParkingLotHandlePtr parking_lot_;
+    };
+
+    /// @brief Type of the pending checks indexed by address.
+    typedef std::unordered_map<uint32_t, Probe> ProbeMap;
+
+    /// @brief Sends an echo request.
+    ///
+    /// @param address the destination.
+    /// @param sequence the sequence number.
+    /// @return true if the request was sent.
+    bool sendEcho(const asiolink::IOAddress& address, uint16_t sequence);
+
+    /// @brief Reads the received messages.
+    ///
+    /// Called by the interface manager when the socket is readable.
+    void receive();
+
+    /// @brief Enables the ping check when the subnet does not say.
+    bool enable_;
+
+    /// @brief The ping timeout in milliseconds.
+    long ping_timeout_;
+
+    /// @brief The cache of the free addresses.
+    boost::scoped_ptr<PingCache> cache_;
+
+    /// @brief The raw ICMP socket, -1 when closed.
+    int socket_;
+
+    /// @brief The echo identifier.
+    uint16_t id_;
+
+    /// @brief The last sequence number.
+    uint16_t sequence_;
+
+    /// @brief The pending checks.
+    ProbeMap probes_;
+
+    /// @brief Protects the pending checks.
+    boost::scoped_ptr<std::mutex> mutex_;
+};
+
+/// @brief Pointer to the ping check manager.
+typedef boost::shared_ptr<PingCheckMgr> PingCheckMgrPtr;
+
+} // end of namespace isc::ping_check
+} // end of namespace isc
+
+#endif // PING_CHECK_MGR_H
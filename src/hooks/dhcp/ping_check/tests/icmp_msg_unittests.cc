@@ -0,0 +1,120 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <icmp_msg.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace isc;
+using namespace isc::ping_check;
+using namespace std;
+
+namespace {
+
+/// @brief Prepends an IPv4 header to an ICMP message.
+///
+/// @param icmp the ICMP message.
+/// @param source the source address in host byte order.
+/// @return the IPv4 packet.
+vector<uint8_t> addIpHeader(const vector<uint8_t>& icmp, uint32_t source) {
+    vector<uint8_t> packet(ICMPMsg::IP_HEADER_SIZE);
+    packet[0] = 0x45;
+    packet[8] = 64;
+    packet[9] = 1;
+    packet[12] = static_cast<uint8_t>(source >> 24);
+    packet[13] = static_cast<uint8_t>(source >> 16);
+    packet[14] = static_cast<uint8_t>(source >> 8);
+    packet[15] = static_cast<uint8_t>(source);
+    packet.insert(packet.end(), icmp.begin(), icmp.end());
+    return (packet);
+}
+
+// Checks the internet checksum with the RFC 1071 example.
+TEST(ICMPMsgTest, checksum) {
+    const uint8_t data[] = { 0x00, 0x01, 0xf2, 0x03, 0xf4, 0xf5, 0xf6, 0xf7 };
+    EXPECT_EQ(0x220d, ICMPMsg::calcChecksum(data, sizeof(data)));
+
+    // An odd byte is padded with zero.
+    const uint8_t odd[] = { 0x12, 0x34, 0x56 };
+    EXPECT_EQ(static_cast<uint16_t>(~(0x1234 + 0x5600)),
+              ICMPMsg::calcChecksum(odd, sizeof(odd)));
+}
+
+// Checks the wire format of an echo request.
+TEST(ICMPMsgTest, pack) {
+    ICMPMsg msg(ICMPMsg::ECHO_REQUEST, 0x1234, 0x0506);
+    msg.setPayload(vector<uint8_t>{ 0xc0, 0x00, 0x02, 0x01 });
+    vector<uint8_t> wire = msg.pack();
+    ASSERT_EQ(ICMPMsg::ICMP_HEADER_SIZE + 4, wire.size());
+    EXPECT_EQ(8, wire[0]);
+    EXPECT_EQ(0, wire[1]);
+    EXPECT_EQ(0x12, wire[4]);
+    EXPECT_EQ(0x34, wire[5]);
+    EXPECT_EQ(0x05, wire[6]);
+    EXPECT_EQ(0x06, wire[7]);
+    EXPECT_EQ(0xc0, wire[8]);
+    // The message holding its checksum sums to zero.
+    EXPECT_EQ(0, ICMPMsg::calcChecksum(&wire[0], wire.size()));
+}
+
+// Checks the parsing of an echo reply.
+TEST(ICMPMsgTest, unpack) {
+    ICMPMsg reply(ICMPMsg::ECHO_REPLY, 0x1234, 7);
+    reply.setPayload(vector<uint8_t>{ 1, 2, 3 });
+    vector<uint8_t> packet = addIpHeader(reply.pack(), 0xc0000265);
+
+    ICMPMsgPtr msg = ICMPMsg::unpack(&packet[0], packet.size());
+    ASSERT_TRUE(msg);
+    EXPECT_EQ(ICMPMsg::ECHO_REPLY, msg->getType());
+    EXPECT_EQ(0, msg->getCode());
+    EXPECT_EQ(0x1234, msg->getId());
+    EXPECT_EQ(7, msg->getSequence());
+    EXPECT_EQ("192.0.2.101", msg->getSource().toText());
+    EXPECT_EQ(vector<uint8_t>({ 1, 2, 3 }), msg->getPayload());
+}
+
+// Checks that the invalid packets are rejected.
+TEST(ICMPMsgTest, unpackInvalid) {
+    ICMPMsg reply(ICMPMsg::ECHO_REPLY, 1, 1);
+    vector<uint8_t> packet = addIpHeader(reply.pack(), 0xc0000265);
+
+    EXPECT_FALSE(ICMPMsg::unpack(0, 0));
+    // Too short.
+    EXPECT_FALSE(ICMPMsg::unpack(&packet[0], ICMPMsg::IP_HEADER_SIZE));
+    EXPECT_FALSE(ICMPMsg::unpack(&packet[0], packet.size() - 1));
+
+    // Not ICMP.
+    vector<uint8_t> udp = packet;
+    udp[9] = 17;
+    EXPECT_FALSE(ICMPMsg::unpack(&udp[0], udp.size()));
+
+    // Not IPv4.
+    vector<uint8_t> ipv6 = packet;
+    ipv6[0] = 0x65;
+    EXPECT_FALSE(ICMPMsg::unpack(&ipv6[0], ipv6.size()));
+
+    // Bad checksum.
+    vector<uint8_t> bad = packet;
+    bad[ICMPMsg::IP_HEADER_SIZE + 7] ^= 0xff;
+    EXPECT_FALSE(ICMPMsg::unpack(&bad[0], bad.size()));
+
+    // IPv4 options are skipped.
+    vector<uint8_t> options(packet.begin(),
+                            packet.begin() + ICMPMsg::IP_HEADER_SIZE);
+    options[0] = 0x46;
+    options.insert(options.end(), 4, 0);
+    options.insert(options.end(), packet.begin() + ICMPMsg::IP_HEADER_SIZE,
+                   packet.end());
+    ICMPMsgPtr msg = ICMPMsg::unpack(&options[0], options.size());
+    ASSERT_TRUE(msg);
+    EXPECT_EQ(1, msg->getSequence());
+}
+
+}
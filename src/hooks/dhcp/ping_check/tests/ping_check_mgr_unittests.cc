@@ -0,0 +1,267 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <ping_check_mgr.h>
+#include <cc/data.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/subnet.h>
+#include <stats/stats_mgr.h>
+
+#include <gtest/gtest.h>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::ping_check;
+using namespace isc::stats;
+using namespace std;
+
+namespace {
+
+/// @brief A derivation of the ping check manager exposing protected methods.
+class NakedPingCheckMgr : public PingCheckMgr {
+public:
+    using PingCheckMgr::declineLease;
+};
+
+// Checks the cache of the free addresses.
+TEST(PingCacheTest, basic) {
+    PingCache cache(60);
+    EXPECT_EQ(60, cache.getLifetime());
+    IOAddress addr("192.0.2.1");
+    time_t now = 1000;
+    EXPECT_FALSE(cache.isFree(addr, now));
+
+    cache.setFree(addr, now);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_TRUE(cache.isFree(addr, now + 59));
+    EXPECT_FALSE(cache.isFree(IOAddress("192.0.2.2"), now));
+
+    // The expired entry is removed.
+    EXPECT_FALSE(cache.isFree(addr, now + 60));
+    EXPECT_EQ(0, cache.size());
+
+    cache.setFree(addr, now);
+    cache.remove(addr);
+    EXPECT_FALSE(cache.isFree(addr, now));
+}
+
+// Checks the removal of the expired entries.
+TEST(PingCacheTest, prune) {
+    PingCache cache(10);
+    cache.setFree(IOAddress("192.0.2.1"), 100);
+    cache.setFree(IOAddress("192.0.2.2"), 105);
+    cache.prune(112);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_TRUE(cache.isFree(IOAddress("192.0.2.2"), 112));
+}
+
+// Checks that a null lifetime disables the cache.
+TEST(PingCacheTest, disabled) {
+    PingCache cache(0);
+    cache.setFree(IOAddress("192.0.2.1"), 100);
+    EXPECT_EQ(0, cache.size());
+    EXPECT_FALSE(cache.isFree(IOAddress("192.0.2.1"), 100));
+}
+
+/// @brief Test fixture for the ping check manager.
+class PingCheckMgrTest : public ::testing::Test {
+public:
+    /// @brief Constructor.
+    PingCheckMgrTest() {
+        CfgMgr::instance().clear();
+        StatsMgr::instance().removeAll();
+    }
+
+    /// @brief Destructor.
+    ~PingCheckMgrTest() {
+        LeaseMgrFactory::destroy();
+        StatsMgr::instance().removeAll();
+        CfgMgr::instance().clear();
+    }
+
+    /// @brief Adds a subnet to the current configuration.
+    ///
+    /// @param id the subnet identifier.
+    /// @param context the user context of the subnet.
+    void addSubnet(SubnetID id, const string& context) {
+        Subnet4Ptr subnet(new Subnet4(IOAddress("192.0.2.0"), 24, 60, 90,
+                                      120, id));
+        if (!context.empty()) {
+            subnet->setContext(Element::fromJSON(context));
+        }
+        CfgMgr::instance().getCurrentCfg()->getCfgSubnets4()->add(subnet);
+    }
+
+    /// @brief Returns a lease.
+    ///
+    /// @param id the subnet identifier.
+    /// @param address the address of the lease.
+    /// @param mac the last byte of the hardware address.
+    Lease4Ptr makeLease(SubnetID id, const string& address = "192.0.2.10",
+                        uint8_t mac = 1) {
+        vector<uint8_t> hw(6, 1);
+        hw[5] = mac;
+        HWAddrPtr hwaddr(new HWAddr(hw, HTYPE_ETHER));
+        return (Lease4Ptr(new Lease4(IOAddress(address), hwaddr, 0, 0,
+                                     3600, time(0), id)));
+    }
+
+    /// @brief Checks the address statistics of a subnet.
+    ///
+    /// @param id the subnet identifier.
+    /// @param assigned the expected number of assigned addresses.
+    /// @param declined the expected number of declined addresses.
+    void checkStats(SubnetID id, int64_t assigned, int64_t declined) {
+        ObservationPtr obs = StatsMgr::instance().getObservation(
+            StatsMgr::generateName("subnet", id, "assigned-addresses"));
+        ASSERT_TRUE(obs);
+        EXPECT_EQ(assigned, obs->getInteger().first);
+        obs = StatsMgr::instance().getObservation(
+            StatsMgr::generateName("subnet", id, "declined-addresses"));
+        ASSERT_TRUE(obs);
+        EXPECT_EQ(declined, obs->getInteger().first);
+    }
+
+    /// @brief Creates the lease manager and the subnet statistics.
+    ///
+    /// @param assigned the initial number of assigned addresses.
+    void initLeases(int64_t assigned) {
+        LeaseMgrFactory::create("universe=4 type=memfile persist=false");
+        addSubnet(1, "");
+        StatsMgr::instance().setValue(
+            StatsMgr::generateName("subnet", 1, "assigned-addresses"),
+            assigned);
+        StatsMgr::instance().setValue(
+            StatsMgr::generateName("subnet", 1, "declined-addresses"),
+            static_cast<int64_t>(0));
+    }
+};
+
+// Checks the per subnet enablement.
+TEST_F(PingCheckMgrTest, isEnabled) {
+    PingCheckMgr mgr;
+    EXPECT_EQ(PingCheckMgr::DEFAULT_PING_TIMEOUT, mgr.getPingTimeout());
+    EXPECT_EQ(PingCheckMgr::DEFAULT_CACHE_LIFETIME,
+              mgr.getCache().getLifetime());
+    EXPECT_FALSE(mgr.isEnabled(Lease4Ptr()));
+
+    addSubnet(1, "");
+    addSubnet(2, "{ \"enable-ping-check\": false }");
+    addSubnet(3, "{ \"enable-ping-check\": true }");
+    addSubnet(4, "{ \"enable-ping-check\": \"no\" }");
+
+    EXPECT_TRUE(mgr.isEnabled(makeLease(1)));
+    EXPECT_FALSE(mgr.isEnabled(makeLease(2)));
+    EXPECT_TRUE(mgr.isEnabled(makeLease(3)));
+    // Invalid values are ignored.
+    EXPECT_TRUE(mgr.isEnabled(makeLease(4)));
+    // Unknown subnet.
+    EXPECT_TRUE(mgr.isEnabled(makeLease(5)));
+}
+
+// Checks that no check is started without the socket.
+TEST_F(PingCheckMgrTest, notStarted) {
+    PingCheckMgr mgr;
+    addSubnet(1, "");
+    Pkt4Ptr query(new Pkt4(DHCPDISCOVER, 1234));
+    EXPECT_FALSE(mgr.startPing(makeLease(1), Lease4Ptr(), query,
+                               hooks::ParkingLotHandlePtr()));
+    EXPECT_EQ(0, mgr.getPendingCount());
+}
+
+// Checks that the current address of the client is not checked.
+TEST_F(PingCheckMgrTest, shouldPing) {
+    PingCheckMgr mgr;
+    addSubnet(1, "");
+    addSubnet(2, "{ \"enable-ping-check\": false }");
+    Lease4Ptr lease = makeLease(1);
+
+    // The client has no lease.
+    EXPECT_TRUE(mgr.shouldPing(lease, Lease4Ptr()));
+
+    // The client has the offered address.
+    EXPECT_FALSE(mgr.shouldPing(lease, makeLease(1)));
+
+    // The client has another address.
+    EXPECT_TRUE(mgr.shouldPing(lease, makeLease(1, "192.0.2.11")));
+
+    // The expired lease of another client is reused.
+    EXPECT_TRUE(mgr.shouldPing(lease, makeLease(1, "192.0.2.10", 2)));
+
+    // The check is disabled for the subnet.
+    EXPECT_FALSE(mgr.shouldPing(makeLease(2), Lease4Ptr()));
+
+    // The address recently did not answer.
+    mgr.getCache().setFree(lease->addr_, time(0));
+    EXPECT_FALSE(mgr.shouldPing(lease, Lease4Ptr()));
+}
+
+// Checks the decline of an address without lease.
+TEST_F(PingCheckMgrTest, declineNewLease) {
+    ASSERT_NO_FATAL_FAILURE(initLeases(0));
+    NakedPingCheckMgr mgr;
+    mgr.declineLease(makeLease(1));
+
+    Lease4Ptr lease =
+        LeaseMgrFactory::instance().getLease4(IOAddress("192.0.2.10"));
+    ASSERT_TRUE(lease);
+    EXPECT_TRUE(lease->stateDeclined());
+    checkStats(1, 1, 1);
+}
+
+// Checks the decline of an address with a reclaimed lease.
+TEST_F(PingCheckMgrTest, declineReclaimedLease) {
+    ASSERT_NO_FATAL_FAILURE(initLeases(0));
+    Lease4Ptr reclaimed = makeLease(1, "192.0.2.10", 2);
+    reclaimed->state_ = Lease::STATE_EXPIRED_RECLAIMED;
+    ASSERT_TRUE(LeaseMgrFactory::instance().addLease(reclaimed));
+
+    NakedPingCheckMgr mgr;
+    mgr.declineLease(makeLease(1));
+
+    Lease4Ptr lease =
+        LeaseMgrFactory::instance().getLease4(IOAddress("192.0.2.10"));
+    ASSERT_TRUE(lease);
+    EXPECT_TRUE(lease->stateDeclined());
+    checkStats(1, 1, 1);
+}
+
+// Checks the decline of an address with an expired lease not yet
+// reclaimed, which is still counted as assigned.
+TEST_F(PingCheckMgrTest, declineExpiredLease) {
+    ASSERT_NO_FATAL_FAILURE(initLeases(1));
+    Lease4Ptr expired = makeLease(1, "192.0.2.10", 2);
+    expired->cltt_ = time(0) - 7200;
+    expired->current_cltt_ = expired->cltt_;
+    ASSERT_TRUE(LeaseMgrFactory::instance().addLease(expired));
+
+    NakedPingCheckMgr mgr;
+    mgr.declineLease(makeLease(1));
+
+    Lease4Ptr lease =
+        LeaseMgrFactory::instance().getLease4(IOAddress("192.0.2.10"));
+    ASSERT_TRUE(lease);
+    EXPECT_TRUE(lease->stateDeclined());
+    checkStats(1, 1, 1);
+}
+
+// Checks that the unexpected messages are ignored.
+TEST_F(PingCheckMgrTest, unexpectedMessages) {
+    PingCheckMgr mgr;
+    EXPECT_NO_THROW(mgr.handleMessage(ICMPMsgPtr()));
+    EXPECT_NO_THROW(mgr.handleMessage(ICMPMsgPtr(new ICMPMsg(ICMPMsg::ECHO_REQUEST))));
+    EXPECT_NO_THROW(mgr.handleMessage(ICMPMsgPtr(new ICMPMsg(ICMPMsg::ECHO_REPLY))));
+    EXPECT_NO_THROW(mgr.expire(IOAddress("192.0.2.10"), 1));
+    EXPECT_EQ(0, mgr.getPendingCount());
+    EXPECT_EQ(0, mgr.getCache().size());
+}
+
+}
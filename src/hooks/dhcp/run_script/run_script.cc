@@ -1,4 +1,4 @@
-// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -18,9 +18,8 @@ using namespace std;
 namespace isc {
 namespace run_script {
 
-IOServicePtr RunScriptImpl::io_service_;
 
-RunScriptImpl::RunScriptImpl() : name_(), sync_(false) {
+RunScriptImpl::RunScriptImpl() : name_(), sync_(false), worker_() {
 }
 
 void
@@ -33,7 +32,7 @@ RunScriptImpl::configure(LibraryHandle& handle) {
         isc_throw(InvalidParameter, "The 'name' parameter must be a string");
     }
     try {
-        ProcessSpawn process(IOServicePtr(), name->stringValue());
+        ProcessSpawn process(name->stringValue());
     } catch (const isc::Exception& ex) {
         isc_throw(InvalidParameter, "Invalid 'name' parameter: " << ex.what());
     }
@@ -45,11 +44,36 @@ RunScriptImpl::configure(LibraryHandle& handle) {
         }
         setSync(sync->boolValue());
     }
+    bool worker_mode = false;
+    ConstElementPtr worker = handle.getParameter("worker");
+    if (worker) {
+        if (worker->getType() != Element::boolean) {
+            isc_throw(InvalidParameter, "The 'worker' parameter must be a boolean");
+        }
+        worker_mode = worker->boolValue();
+    }
+    size_t queue_size = RunScriptWorker::DEFAULT_QUEUE_SIZE;
+    ConstElementPtr worker_queue_size = handle.getParameter("worker-queue-size");
+    if (worker_queue_size) {
+        if ((worker_queue_size->getType() != Element::integer) ||
+            (worker_queue_size->intValue() <= 0)) {
+            isc_throw(InvalidParameter, "The 'worker-queue-size' parameter "
+                      "must be a positive integer");
+        }
+        queue_size = static_cast<size_t>(worker_queue_size->intValue());
+    }
+    if (worker_mode) {
+        worker_.reset(new RunScriptWorker(name_, queue_size));
+    }
 }
 
 void
 RunScriptImpl::runScript(const ProcessArgs& args, const ProcessEnvVars& vars) {
-    ProcessSpawn process(getIOService(), name_, args, vars);
+    if (worker_) {
+        worker_->send(args, vars);
+        return;
+    }
+    ProcessSpawn process(name_, args, vars);
     process.spawn(true);
 }
 
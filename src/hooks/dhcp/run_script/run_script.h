@@ -1,4 +1,4 @@
-// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -16,6 +16,7 @@
 #include <dhcpsrv/lease.h>
 #include <dhcpsrv/subnet.h>
 #include <hooks/library_handle.h>
+#include <run_script_worker.h>
 #include <string>
 
 namespace isc {
@@ -30,20 +31,6 @@ public:
     /// @brief Destructor.
     ~RunScriptImpl() = default;
 
-    /// @brief Sets IO service to be used by the @ref ProcessSpawn instance.
-    ///
-    /// @param io_service The IOService object, used for all ASIO operations.
-    static void setIOService(const isc::asiolink::IOServicePtr& io_service) {
-        io_service_ = io_service;
-    }
-
-    /// @brief Gets IO service to be used by the @ref ProcessSpawn instance.
-    ///
-    /// @return The IOService object, used for all ASIO operations.
-    static isc::asiolink::IOServicePtr getIOService() {
-        return (io_service_);
-    }
-
     /// @brief Extract boolean data and append to environment.
     ///
     /// @param value The value to be exported to target script environment.
@@ -209,6 +196,9 @@ public:
 
     /// @brief Run Script with specified arguments and environment parameters.
     ///
+    /// In worker mode the arguments and environment variables are sent
+    /// to the persistent worker instead.
+    ///
     /// @param args The arguments for the target script.
     /// @param vars The environment variables made available for the target
     /// script.
@@ -243,6 +233,14 @@ public:
         return (sync_);
     }
 
+    /// @brief Get the persistent worker.
+    ///
+    /// @return The worker or null when the script is spawned for each
+    /// hook call.
+    RunScriptWorkerPtr getWorker() const {
+        return (worker_);
+    }
+
     /// @brief This function parses and applies configuration parameters.
     void configure(isc::hooks::LibraryHandle& handle);
 
@@ -257,8 +255,8 @@ private:
     /// started.
     bool sync_;
 
-    /// @brief The IOService object, used for all ASIO operations.
-    static isc::asiolink::IOServicePtr io_service_;
+    /// @brief The persistent worker or null.
+    RunScriptWorkerPtr worker_;
 };
 
 /// @brief The type of shared pointers to Run Script implementations.
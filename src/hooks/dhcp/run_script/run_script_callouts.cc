@@ -81,61 +81,10 @@ int load(LibraryHandle& handle) {
 /// @return always 0.
 int unload() {
     impl.reset();
-    RunScriptImpl::setIOService(IOServicePtr());
     LOG_INFO(run_script_logger, RUN_SCRIPT_UNLOAD);
     return (0);
 }
 
-/// @brief dhcp4_srv_configured callout implementation.
-///
-/// @param handle callout handle.
-int dhcp4_srv_configured(CalloutHandle& handle) {
-    try {
-        isc::asiolink::IOServicePtr io_service;
-        handle.getArgument("io_context", io_service);
-        if (!io_service) {
-            // Should not happen!
-            handle.setStatus(isc::hooks::CalloutHandle::NEXT_STEP_DROP);
-            const string error("Error: io_context is null");
-            handle.setArgument("error", error);
-            return (1);
-        }
-        RunScriptImpl::setIOService(io_service);
-
-    } catch (const exception& ex) {
-        LOG_ERROR(run_script_logger, RUN_SCRIPT_LOAD_ERROR)
-            .arg(ex.what());
-        handle.setStatus(isc::hooks::CalloutHandle::NEXT_STEP_DROP);
-        return (1);
-    }
-    return (0);
-}
-
-/// @brief dhcp6_srv_configured callout implementation.
-///
-/// @param handle callout handle.
-int dhcp6_srv_configured(CalloutHandle& handle) {
-    try {
-        isc::asiolink::IOServicePtr io_service;
-        handle.getArgument("io_context", io_service);
-        if (!io_service) {
-            // Should not happen!
-            handle.setStatus(isc::hooks::CalloutHandle::NEXT_STEP_DROP);
-            const string error("Error: io_context is null");
-            handle.setArgument("error", error);
-            return (1);
-        }
-        RunScriptImpl::setIOService(io_service);
-
-    } catch (const exception& ex) {
-        LOG_ERROR(run_script_logger, RUN_SCRIPT_LOAD_ERROR)
-            .arg(ex.what());
-        handle.setStatus(isc::hooks::CalloutHandle::NEXT_STEP_DROP);
-        return (1);
-    }
-    return (0);
-}
-
 /// @brief handle @ref lease4_renew hook and set environment parameters for the
 /// script.
 /// IN: query4 subnet4 clientid hwaddr lease4
@@ -0,0 +1,195 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <run_script.h>
+#include <run_script_log.h>
+#include <run_script_worker.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace isc::asiolink;
+using namespace std;
+
+namespace isc {
+namespace run_script {
+
+const size_t RunScriptWorker::DEFAULT_QUEUE_SIZE;
+
+RunScriptWorker::RunScriptWorker(const string& name, size_t queue_size)
+    : name_(name), queue_size_(queue_size), queue_(), stopping_(false),
+      fd_(-1) {
+    if (queue_size_ == 0) {
+        isc_throw(BadValue, "the worker queue size must not be 0");
+    }
+    thread_.reset(new thread(&RunScriptWorker::run, this));
+}
+
+RunScriptWorker::~RunScriptWorker() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cond_.notify_all();
+    thread_->join();
+    thread_.reset();
+    stopWorker();
+}
+
+void
+RunScriptWorker::send(const ProcessArgs& args, const ProcessEnvVars& vars) {
+    string record = formatRecord(args, vars);
+    unique_lock<mutex> lock(mutex_);
+    cond_.wait(lock, [this]() { return (queue_.size() < queue_size_); });
+    queue_.push_back(record);
+    lock.unlock();
+    cond_.notify_all();
+}
+
+string
+RunScriptWorker::formatRecord(const ProcessArgs& args,
+                              const ProcessEnvVars& vars) {
+    string record;
+    for (auto const& arg : args) {
+        if (!record.empty()) {
+            record += ' ';
+        }
+        record += arg;
+    }
+    for (auto const& var : vars) {
+        record += '\t';
+        for (auto const c : var) {
+            switch (c) {
+            case '\\':
+                record += "\\\\";
+                break;
+            case '\t':
+                record += "\\t";
+                break;
+            case '\n':
+                record += "\\n";
+                break;
+            default:
+                record += c;
+            }
+        }
+    }
+    record += '\n';
+    return (record);
+}
+
+void
+RunScriptWorker::run() {
+    for (;;) {
+        string batch;
+        size_t count = 0;
+        {
+            unique_lock<mutex> lock(mutex_);
+            cond_.wait(lock, [this]() {
+                return (stopping_ || !queue_.empty());
+            });
+            if (queue_.empty()) {
+                return;
+            }
+            // Take all the queued records so they are written at once.
+            for (auto const& record : queue_) {
+                batch += record;
+            }
+            count = queue_.size();
+            queue_.clear();
+        }
+        // The threads waiting for room in the queue can go on.
+        cond_.notify_all();
+        write(batch, count);
+    }
+}
+
+void
+RunScriptWorker::write(const string& batch, size_t count) {
+    try {
+        if (fd_ < 0) {
+            startWorker();
+        }
+        const char* data = batch.c_str();
+        size_t left = batch.size();
+        while (left > 0) {
+            int flags = 0;
+#ifdef MSG_NOSIGNAL
+            // The script may have exited: do not raise SIGPIPE.
+            flags = MSG_NOSIGNAL;
+#endif
+            ssize_t ret = ::send(fd_, data, left, flags);
+            if (ret < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                isc_throw(Unexpected, "write to " << name_ << " failed: "
+                          << strerror(errno));
+            }
+            data += ret;
+            left -= ret;
+        }
+    } catch (const exception& ex) {
+        // Start the script again with the next records.
+        stopWorker();
+        LOG_ERROR(run_script_logger, RUN_SCRIPT_WORKER_ERROR)
+            .arg(count)
+            .arg(ex.what());
+    }
+}
+
+void
+RunScriptWorker::startWorker() {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+        isc_throw(Unexpected, "socketpair failed: " << strerror(errno));
+    }
+    // The server side must not be inherited by the script, so the script
+    // gets an end-of-file when the server closes it. The script side
+    // becomes its standard input.
+    static_cast<void>(fcntl(fds[0], F_SETFD, FD_CLOEXEC));
+    static_cast<void>(fcntl(fds[1], F_SETFD, FD_CLOEXEC));
+#if !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+    int on = 1;
+    static_cast<void>(setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE,
+                                 &on, sizeof(on)));
+#endif
+    // The script can't write to the server.
+    static_cast<void>(shutdown(fds[0], SHUT_RD));
+    pid_t pid;
+    try {
+        ProcessArgs args;
+        args.push_back("worker");
+        ProcessSpawn process(name_, args);
+        pid = process.spawn(true, fds[1]);
+    } catch (...) {
+        static_cast<void>(close(fds[0]));
+        static_cast<void>(close(fds[1]));
+        throw;
+    }
+    static_cast<void>(close(fds[1]));
+    fd_ = fds[0];
+    LOG_INFO(run_script_logger, RUN_SCRIPT_WORKER_STARTED)
+        .arg(name_)
+        .arg(pid);
+}
+
+void
+RunScriptWorker::stopWorker() {
+    if (fd_ >= 0) {
+        static_cast<void>(close(fd_));
+        fd_ = -1;
+    }
+}
+
+} // namespace run_script
+} // namespace isc
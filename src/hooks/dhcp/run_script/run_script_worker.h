@@ -0,0 +1,132 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef RUN_SCRIPT_WORKER_H
+#define RUN_SCRIPT_WORKER_H
+
+#include <asiolink/process_spawn.h>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace isc {
+namespace run_script {
+
+/// @brief Persistent worker process receiving the hook events.
+///
+/// Spawning the script for each hook call creates a process for each
+/// lease event. In worker mode the script is started once, with the
+/// "worker" argument, and reads the events from its standard input, one
+/// record per line: the hook point name followed by the environment
+/// variables, separated by tabulations. The backslash, tabulation and
+/// newline characters of the values are escaped as "\\", "\t" and "\n".
+///
+/// The threads calling the hooks push the records in a bounded queue: when
+/// the queue is full they wait, so a slow script slows down the server
+/// instead of consuming its memory. A writer thread writes all the queued
+/// records at once and restarts the script when it exits: the records
+/// which could not be written are lost and reported by an error message.
+class RunScriptWorker : public boost::noncopyable {
+public:
+
+    /// @brief Default maximum number of queued records.
+    static const size_t DEFAULT_QUEUE_SIZE = 1024;
+
+    /// @brief Constructor.
+    ///
+    /// Starts the writer thread. The script is started with the first
+    /// record.
+    ///
+    /// @param name The name of the script.
+    /// @param queue_size The maximum number of queued records.
+    /// @throw BadValue if the queue size is 0.
+    RunScriptWorker(const std::string& name,
+                    size_t queue_size = DEFAULT_QUEUE_SIZE);
+
+    /// @brief Destructor.
+    ///
+    /// Writes the queued records, stops the writer thread and closes the
+    /// standard input of the script which should then exit.
+    ~RunScriptWorker();
+
+    /// @brief Queues the record of a hook event.
+    ///
+    /// Waits while the queue is full.
+    ///
+    /// @param args The arguments: the name of the hook point.
+    /// @param vars The environment variables.
+    void send(const isc::asiolink::ProcessArgs& args,
+              const isc::asiolink::ProcessEnvVars& vars);
+
+    /// @brief Formats the record of a hook event.
+    ///
+    /// @param args The arguments: the name of the hook point.
+    /// @param vars The environment variables.
+    /// @return The record including the ending newline.
+    static std::string formatRecord(const isc::asiolink::ProcessArgs& args,
+                                    const isc::asiolink::ProcessEnvVars& vars);
+
+    /// @brief Returns the maximum number of queued records.
+    size_t getQueueSize() const {
+        return (queue_size_);
+    }
+
+private:
+
+    /// @brief Writer thread body.
+    void run();
+
+    /// @brief Writes a batch of records, starting the script if needed.
+    ///
+    /// @param batch The records.
+    /// @param count The number of records.
+    void write(const std::string& batch, size_t count);
+
+    /// @brief Starts the script.
+    ///
+    /// @throw Unexpected or ProcessSpawnError on error.
+    void startWorker();
+
+    /// @brief Closes the standard input of the script.
+    void stopWorker();
+
+    /// @brief The name of the script.
+    std::string name_;
+
+    /// @brief The maximum number of queued records.
+    size_t queue_size_;
+
+    /// @brief The queued records.
+    std::deque<std::string> queue_;
+
+    /// @brief The flag set when the writer thread must stop.
+    bool stopping_;
+
+    /// @brief The mutex protecting the queue.
+    std::mutex mutex_;
+
+    /// @brief The condition signaled when the queue changes.
+    std::condition_variable cond_;
+
+    /// @brief The socket connected to the standard input of the script
+    /// or -1 when the script is not running.
+    int fd_;
+
+    /// @brief The writer thread.
+    boost::scoped_ptr<std::thread> thread_;
+};
+
+/// @brief The type of shared pointers to Run Script workers.
+typedef boost::shared_ptr<RunScriptWorker> RunScriptWorkerPtr;
+
+} // namespace run_script
+} // namespace isc
+#endif
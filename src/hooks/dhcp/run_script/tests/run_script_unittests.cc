@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,7 +9,6 @@
 #include <run_script.h>
 
 #include <asiolink/io_address.h>
-#include <asiolink/io_service.h>
 #include <cc/data.h>
 #include <dhcp/dhcp6.h>
 #include <dhcp/option.h>
@@ -335,6 +334,20 @@ TEST(RunScript, testSetSyncGetSync) {
     EXPECT_EQ(sync, script.getSync());
 }
 
+/// @brief Tests the records sent to the worker.
+TEST(RunScript, formatRecord) {
+    ProcessArgs args;
+    args.push_back("lease4_renew");
+    ProcessEnvVars vars;
+    vars.push_back("LEASE4_ADDRESS=192.0.2.1");
+    vars.push_back("LEASE4_HOSTNAME=a\tb\\c\nd");
+    EXPECT_EQ("lease4_renew\tLEASE4_ADDRESS=192.0.2.1"
+              "\tLEASE4_HOSTNAME=a\\tb\\\\c\\nd\n",
+              RunScriptWorker::formatRecord(args, vars));
+    EXPECT_EQ("lease4_renew\n",
+              RunScriptWorker::formatRecord(args, ProcessEnvVars()));
+}
+
 /// @brief Tests the extractBoolean method works as expected.
 TEST(RunScript, extractBoolean) {
     ProcessEnvVars vars;
@@ -778,15 +791,12 @@ class RunScriptTest : public ::testing::Test {
 public:
 
     /// @brief Constructor.
-    RunScriptTest() :
-        co_manager_(new CalloutManager(1)), io_service_(new IOService()) {
-        RunScriptImpl::setIOService(io_service_);
+    RunScriptTest() : co_manager_(new CalloutManager(1)) {
         clearLogFile();
     }
 
     /// @brief Destructor.
     ~RunScriptTest() {
-        RunScriptImpl::setIOService(IOServicePtr());
         clearLogFile();
     }
 
@@ -815,6 +825,28 @@ public:
         ASSERT_EQ(join(extracted_lines), "SUCCESS\n");
     }
 
+    /// @brief Checks the hook points logged by the worker.
+    ///
+    /// @param expected The expected hook points.
+    void checkWorkerResult(const string& expected) {
+        ifstream test_log;
+        string line;
+        time_t now(time(NULL));
+        while (true) {
+            test_log.open(TEST_LOG_FILE);
+            if (!test_log.fail()) {
+                bool done = static_cast<bool>(getline(test_log, line));
+                test_log.close();
+                if (done) {
+                    break;
+                }
+            }
+            ASSERT_LT(time(NULL), now + 3) << "timeout";
+            usleep(100000);
+        }
+        EXPECT_EQ(expected, line);
+    }
+
     /// @brief Fetches the callout manager instance.
     boost::shared_ptr<CalloutManager>getCalloutManager() {
         return (co_manager_);
@@ -823,11 +855,26 @@ public:
 private:
     /// @brief Callout manager accessed by this CalloutHandle.
     boost::shared_ptr<CalloutManager> co_manager_;
-
-    /// @brief IOService instance to process IO.
-    isc::asiolink::IOServicePtr io_service_;
 };
 
+// Verifies that the worker receives the records on its standard input and
+// exits when the worker is destroyed.
+TEST_F(RunScriptTest, worker) {
+    RunScriptWorkerPtr worker(new RunScriptWorker(RUN_SCRIPT_TEST_SH, 2));
+    EXPECT_EQ(2, worker->getQueueSize());
+    ProcessEnvVars vars;
+    vars.push_back("LEASE4_ADDRESS=192.0.2.1");
+    ProcessArgs args;
+    args.push_back("lease4_renew");
+    worker->send(args, vars);
+    args[0] = "lease4_expire";
+    worker->send(args, vars);
+    args[0] = "lease4_release";
+    worker->send(args, vars);
+    worker.reset();
+    checkWorkerResult("lease4_renew lease4_expire lease4_release ");
+}
+
 TEST_F(RunScriptTest, lease4Renew) {
     impl.reset(new RunScriptImpl());
     impl->setName(RUN_SCRIPT_TEST_SH);
@@ -0,0 +1,98 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <metrics_listener.h>
+#include <http/request.h>
+#include <http/response.h>
+#include <stats/open_metrics.h>
+#include <stats/stats_mgr.h>
+
+#include <sstream>
+
+using namespace isc::asiolink;
+using namespace isc::http;
+using namespace isc::stats;
+using namespace std;
+
+namespace isc {
+namespace stat_cmds {
+
+HttpRequestPtr
+MetricsResponseCreator::createNewHttpRequest() const {
+    HttpRequestPtr request(new HttpRequest());
+    request->requireHttpMethod(HttpRequest::Method::HTTP_GET);
+    return (request);
+}
+
+HttpResponsePtr
+MetricsResponseCreator::createStockHttpResponse(const HttpRequestPtr& request,
+                                                const HttpStatusCode& status_code) const {
+    // The request may not be finalized so the version is taken from
+    // the context. Only HTTP 1.0 and 1.1 are accepted.
+    HttpVersion http_version(request->context()->http_version_major_,
+                             request->context()->http_version_minor_);
+    if ((http_version < HttpVersion(1, 0)) || (HttpVersion(1, 1) < http_version)) {
+        http_version = HttpVersion::HTTP_10();
+    }
+    HttpResponsePtr response(new HttpResponse(http_version, status_code));
+    response->finalize();
+    return (response);
+}
+
+HttpResponsePtr
+MetricsResponseCreator::createDynamicHttpResponse(HttpRequestPtr request) {
+    string uri = request->getUri();
+    size_t query = uri.find('?');
+    if (query != string::npos) {
+        uri.erase(query);
+    }
+    if (uri != "/metrics") {
+        return (createStockHttpResponse(request, HttpStatusCode::NOT_FOUND));
+    }
+
+    ostringstream body;
+    StatsMgr::instance().writeOpenMetrics(body, prefix_);
+
+    HttpResponsePtr response(new HttpResponse(request->getHttpVersion(),
+                                              HttpStatusCode::OK));
+    response->context()->headers_.push_back(HttpHeaderContext("Content-Type",
+                                                              OpenMetricsWriter::CONTENT_TYPE));
+    response->context()->body_ = body.str();
+    response->finalize();
+    return (response);
+}
+
+MetricsListener::MetricsListener(IOService& io_service,
+                                 const IOAddress& address,
+                                 const uint16_t port,
+                                 const string& prefix) {
+    HttpResponseCreatorFactoryPtr factory(new MetricsResponseCreatorFactory(prefix));
+    listener_.reset(new HttpListener(io_service, address, port, TlsContextPtr(),
+                                     factory,
+                                     HttpListener::RequestTimeout(REQUEST_TIMEOUT),
+                                     HttpListener::IdleTimeout(IDLE_TIMEOUT)));
+}
+
+MetricsListener::~MetricsListener() {
+    stop();
+}
+
+void
+MetricsListener::start() {
+    listener_->start();
+}
+
+void
+MetricsListener::stop() {
+    if (listener_) {
+        listener_->stop();
+    }
+}
+
+} // end of namespace isc::stat_cmds
+} // end of namespace isc
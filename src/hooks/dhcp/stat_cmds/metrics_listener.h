@@ -0,0 +1,140 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef METRICS_LISTENER_H
+#define METRICS_LISTENER_H
+
+#include <asiolink/io_address.h>
+#include <asiolink/io_service.h>
+#include <http/listener.h>
+#include <http/response_creator.h>
+#include <http/response_creator_factory.h>
+
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+namespace isc {
+namespace stat_cmds {
+
+/// @brief HTTP response creator serving the statistics in the OpenMetrics
+/// text format.
+///
+/// The creator answers GET requests for the "/metrics" path with all the
+/// statistics written by @ref isc::stats::StatsMgr::writeOpenMetrics, i.e.
+/// directly from the statistics manager without building the JSON
+/// structures used by the statistic-get-all command. The requests for
+/// other paths are answered with 404.
+class MetricsResponseCreator : public http::HttpResponseCreator {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param prefix prefix of the metric family names.
+    explicit MetricsResponseCreator(const std::string& prefix)
+        : prefix_(prefix) {
+    }
+
+    /// @brief Creates a new request accepting only the GET method.
+    ///
+    /// @return Pointer to the new instance of the @ref isc::http::HttpRequest.
+    virtual http::HttpRequestPtr createNewHttpRequest() const;
+
+    /// @brief Creates stock HTTP response.
+    ///
+    /// @param request Pointer to an object representing HTTP request.
+    /// @param status_code Status code of the response.
+    /// @return Pointer to the response with an empty body.
+    virtual http::HttpResponsePtr
+    createStockHttpResponse(const http::HttpRequestPtr& request,
+                            const http::HttpStatusCode& status_code) const;
+
+private:
+
+    /// @brief Creates the response holding the metrics.
+    ///
+    /// @param request Pointer to an object representing HTTP request.
+    /// @return Pointer to an object representing HTTP response.
+    virtual http::HttpResponsePtr
+    createDynamicHttpResponse(http::HttpRequestPtr request);
+
+    /// @brief Prefix of the metric family names.
+    std::string prefix_;
+};
+
+/// @brief HTTP response creator factory for the metrics listener.
+///
+/// This class always returns the same instance of the
+/// @ref MetricsResponseCreator.
+class MetricsResponseCreatorFactory : public http::HttpResponseCreatorFactory {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param prefix prefix of the metric family names.
+    explicit MetricsResponseCreatorFactory(const std::string& prefix)
+        : sole_creator_(new MetricsResponseCreator(prefix)) {
+    }
+
+    /// @brief Returns the instance of the @ref MetricsResponseCreator.
+    virtual http::HttpResponseCreatorPtr create() const {
+        return (sole_creator_);
+    }
+
+private:
+
+    /// @brief Instance of the @ref MetricsResponseCreator returned.
+    http::HttpResponseCreatorPtr sole_creator_;
+};
+
+/// @brief HTTP listener serving the OpenMetrics endpoint.
+///
+/// The listener runs on the IO service of the server so the requests are
+/// handled by the main thread, between the packet processing in the
+/// single threaded mode.
+class MetricsListener {
+public:
+
+    /// @brief Timeout for the reception of a request in milliseconds.
+    static const long REQUEST_TIMEOUT = 10000;
+
+    /// @brief Timeout of an idle persistent connection in milliseconds.
+    static const long IDLE_TIMEOUT = 30000;
+
+    /// @brief Constructor.
+    ///
+    /// @param io_service IO service used by the listener.
+    /// @param address address on which the listener accepts connections.
+    /// @param port port on which the listener accepts connections.
+    /// @param prefix prefix of the metric family names.
+    MetricsListener(asiolink::IOService& io_service,
+                    const asiolink::IOAddress& address,
+                    const uint16_t port,
+                    const std::string& prefix);
+
+    /// @brief Destructor.
+    ///
+    /// Stops the listener.
+    ~MetricsListener();
+
+    /// @brief Starts accepting connections.
+    void start();
+
+    /// @brief Stops the listener and closes the connections.
+    void stop();
+
+private:
+
+    /// @brief The HTTP listener.
+    http::HttpListenerPtr listener_;
+};
+
+/// @brief Pointer to the @ref MetricsListener.
+typedef boost::shared_ptr<MetricsListener> MetricsListenerPtr;
+
+} // end of namespace isc::stat_cmds
+} // end of namespace isc
+
+#endif // METRICS_LISTENER_H
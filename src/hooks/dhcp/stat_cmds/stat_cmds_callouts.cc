@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,18 +10,104 @@
 
 #include <config.h>
 
+#include <metrics_listener.h>
 #include <stat_cmds.h>
 #include <stat_cmds_log.h>
+#include <asiolink/io_address.h>
+#include <asiolink/io_service.h>
 #include <cc/command_interpreter.h>
 #include <dhcpsrv/cfgmgr.h>
 #include <hooks/hooks.h>
 #include <process/daemon.h>
 
+using namespace isc::asiolink;
+using namespace isc::data;
 using namespace isc::dhcp;
 using namespace isc::hooks;
 using namespace isc::process;
 using namespace isc::stat_cmds;
 
+namespace {
+
+/// @brief Address of the OpenMetrics endpoint.
+IOAddress metrics_address("127.0.0.1");
+
+/// @brief Port of the OpenMetrics endpoint, 0 when it is disabled.
+uint16_t metrics_port = 0;
+
+/// @brief The OpenMetrics endpoint listener.
+MetricsListenerPtr metrics_listener;
+
+/// @brief Parses the OpenMetrics endpoint parameters.
+///
+/// @param handle library handle.
+/// @throw BadValue if a parameter is invalid.
+void
+parseMetricsParameters(LibraryHandle& handle) {
+    metrics_address = IOAddress("127.0.0.1");
+    metrics_port = 0;
+
+    ConstElementPtr address = handle.getParameter("openmetrics-address");
+    if (address) {
+        if (address->getType() != Element::string) {
+            isc_throw(isc::BadValue, "'openmetrics-address' must be a string");
+        }
+        try {
+            metrics_address = IOAddress(address->stringValue());
+        } catch (const std::exception& ex) {
+            isc_throw(isc::BadValue, "invalid 'openmetrics-address' "
+                      << address->stringValue() << ": " << ex.what());
+        }
+    }
+
+    ConstElementPtr port = handle.getParameter("openmetrics-port");
+    if (port) {
+        if ((port->getType() != Element::integer) ||
+            (port->intValue() <= 0) || (port->intValue() > 65535)) {
+            isc_throw(isc::BadValue, "'openmetrics-port' must be an integer "
+                      "between 1 and 65535");
+        }
+        metrics_port = static_cast<uint16_t>(port->intValue());
+    }
+}
+
+/// @brief Starts the OpenMetrics endpoint when it is enabled.
+///
+/// @param handle callout handle.
+/// @param prefix prefix of the metric family names.
+/// @return 0 on success, 1 otherwise.
+int
+startMetricsListener(CalloutHandle& handle, const std::string& prefix) {
+    if (!metrics_port || metrics_listener) {
+        return (0);
+    }
+    try {
+        IOServicePtr io_service;
+        handle.getArgument("io_context", io_service);
+        if (!io_service) {
+            isc_throw(isc::Unexpected, "io_context is null");
+        }
+        metrics_listener.reset(new MetricsListener(*io_service, metrics_address,
+                                                   metrics_port, prefix));
+        metrics_listener->start();
+        LOG_INFO(stat_cmds_logger, STAT_CMDS_OPENMETRICS_STARTED)
+            .arg(metrics_address)
+            .arg(metrics_port);
+    } catch (const std::exception& ex) {
+        metrics_listener.reset();
+        LOG_ERROR(stat_cmds_logger, STAT_CMDS_OPENMETRICS_FAILED)
+            .arg(ex.what());
+        handle.setStatus(CalloutHandle::NEXT_STEP_DROP);
+        std::string error("Error: ");
+        error += ex.what();
+        handle.setArgument("error", error);
+        return (1);
+    }
+    return (0);
+}
+
+} // end of anonymous namespace
+
 extern "C" {
 
 /// @brief This is a command callout for 'stat-lease4-get' command.
@@ -46,6 +132,26 @@ int stat_lease6_get(CalloutHandle& handle) {
     return(stat_cmds.statLease6GetHandler(handle));
 }
 
+/// @brief dhcp4_srv_configured callout implementation.
+///
+/// Starts the OpenMetrics endpoint when it is enabled.
+///
+/// @param handle callout handle.
+/// @return 0 on success, 1 otherwise.
+int dhcp4_srv_configured(CalloutHandle& handle) {
+    return (startMetricsListener(handle, "kea_dhcp4"));
+}
+
+/// @brief dhcp6_srv_configured callout implementation.
+///
+/// Starts the OpenMetrics endpoint when it is enabled.
+///
+/// @param handle callout handle.
+/// @return 0 on success, 1 otherwise.
+int dhcp6_srv_configured(CalloutHandle& handle) {
+    return (startMetricsListener(handle, "kea_dhcp6"));
+}
+
 /// @brief This function is called when the library is loaded.
 ///
 /// @param handle library handle
@@ -66,6 +172,13 @@ int load(LibraryHandle& handle) {
         }
     }
 
+    try {
+        parseMetricsParameters(handle);
+    } catch (const std::exception& ex) {
+        LOG_ERROR(stat_cmds_logger, STAT_CMDS_INIT_FAILED).arg(ex.what());
+        return (1);
+    }
+
     handle.registerCommandCallout("stat-lease4-get", stat_lease4_get);
     handle.registerCommandCallout("stat-lease6-get", stat_lease6_get);
     LOG_INFO(stat_cmds_logger, STAT_CMDS_INIT_OK);
@@ -76,6 +189,10 @@ int load(LibraryHandle& handle) {
 ///
 /// @return 0 if deregistration was successful, 1 otherwise
 int unload() {
+    if (metrics_listener) {
+        metrics_listener->stop();
+        metrics_listener.reset();
+    }
     LOG_INFO(stat_cmds_logger, STAT_CMDS_DEINIT_OK);
     return (0);
 }
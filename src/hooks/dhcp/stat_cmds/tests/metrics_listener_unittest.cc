@@ -0,0 +1,100 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <metrics_listener.h>
+#include <http/request.h>
+#include <http/response.h>
+#include <stats/stats_mgr.h>
+
+#include <gtest/gtest.h>
+
+using namespace isc;
+using namespace isc::http;
+using namespace isc::stats;
+using namespace isc::stat_cmds;
+using namespace std;
+
+namespace {
+
+/// @brief Test fixture for the @ref MetricsResponseCreator.
+class MetricsResponseCreatorTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    MetricsResponseCreatorTest() : creator_("kea_dhcp4") {
+        StatsMgr::instance().removeAll();
+    }
+
+    /// @brief Destructor.
+    ~MetricsResponseCreatorTest() {
+        StatsMgr::instance().removeAll();
+    }
+
+    /// @brief Creates a finalized request.
+    ///
+    /// @param method HTTP method.
+    /// @param uri request URI.
+    HttpRequestPtr createRequest(const string& method, const string& uri) {
+        HttpRequestPtr request = creator_.createNewHttpRequest();
+        request->context()->method_ = method;
+        request->context()->uri_ = uri;
+        request->context()->http_version_major_ = 1;
+        request->context()->http_version_minor_ = 1;
+        request->finalize();
+        return (request);
+    }
+
+    /// @brief The creator under test.
+    MetricsResponseCreator creator_;
+};
+
+// This test verifies that the metrics are returned for the /metrics path.
+TEST_F(MetricsResponseCreatorTest, metrics) {
+    StatsMgr::instance().setValue("subnet[1].assigned-addresses",
+                                  static_cast<int64_t>(3));
+    HttpResponsePtr response;
+    ASSERT_NO_THROW(response = creator_.createHttpResponse(createRequest("GET",
+                                                                         "/metrics")));
+    ASSERT_TRUE(response);
+    EXPECT_EQ(HttpStatusCode::OK, response->getStatusCode());
+    EXPECT_EQ("application/openmetrics-text; version=1.0.0; charset=utf-8",
+              response->getHeaderValue("Content-Type"));
+    EXPECT_EQ("# TYPE kea_dhcp4_subnet_assigned_addresses unknown\n"
+              "kea_dhcp4_subnet_assigned_addresses{subnet=\"1\"} 3\n"
+              "# EOF\n", response->getBody());
+
+    // The query is ignored.
+    ASSERT_NO_THROW(response = creator_.createHttpResponse(createRequest("GET",
+                                                                         "/metrics?x=1")));
+    EXPECT_EQ(HttpStatusCode::OK, response->getStatusCode());
+}
+
+// This test verifies that the other paths are not found.
+TEST_F(MetricsResponseCreatorTest, notFound) {
+    HttpResponsePtr response;
+    ASSERT_NO_THROW(response = creator_.createHttpResponse(createRequest("GET", "/")));
+    ASSERT_TRUE(response);
+    EXPECT_EQ(HttpStatusCode::NOT_FOUND, response->getStatusCode());
+}
+
+// This test verifies that only the GET method is accepted.
+TEST_F(MetricsResponseCreatorTest, badMethod) {
+    HttpRequestPtr request = creator_.createNewHttpRequest();
+    request->context()->method_ = "POST";
+    request->context()->uri_ = "/metrics";
+    request->context()->http_version_major_ = 1;
+    request->context()->http_version_minor_ = 1;
+    EXPECT_THROW(request->finalize(), HttpRequestError);
+
+    HttpResponsePtr response;
+    ASSERT_NO_THROW(response = creator_.createHttpResponse(request));
+    ASSERT_TRUE(response);
+    EXPECT_EQ(HttpStatusCode::BAD_REQUEST, response->getStatusCode());
+}
+
+} // end of anonymous namespace
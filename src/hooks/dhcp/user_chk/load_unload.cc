@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,22 +9,19 @@
 #include <config.h>
 
 #include <hooks/hooks.h>
+#include <outcome_writer.h>
 #include <user_chk_log.h>
 #include <user_registry.h>
 #include <user_file.h>
 
-#include <iostream>
-#include <fstream>
-#include <errno.h>
-
 using namespace isc::hooks;
 using namespace user_chk;
 
 /// @brief Pointer to the registry instance.
 UserRegistryPtr user_registry;
 
-/// @brief Output filestream for recording user check outcomes.
-std::fstream user_chk_output;
+/// @brief Background writer recording user check outcomes.
+OutcomeWriterPtr user_chk_output;
 
 /// @brief User registry input file name.
 /// @todo Hard-coded for now, this should be configurable.
@@ -34,6 +31,11 @@ const char* registry_fname = "/tmp/user_chk_registry.txt";
 /// @todo Hard-coded for now, this should be configurable.
 const char* user_chk_output_fname = "/tmp/user_chk_outcome.txt";
 
+/// @brief Interval in milliseconds between two checks of the user
+/// registry input file.
+/// @todo Hard-coded for now, this should be configurable.
+const long registry_refresh_interval = 1000;
+
 /// @brief Text label of user id in the inbound query in callout context
 const char* query_user_id_label = "query_user_id";
 
@@ -59,8 +61,8 @@ extern "C" {
 
 /// @brief Called by the Hooks library manager when the library is loaded.
 ///
-/// Instantiates the UserRegistry and opens the outcome file. Failure in
-/// either results in a failed return code.
+/// Instantiates the UserRegistry, starts its background refresh and opens
+/// the outcome file. Failure in either results in a failed return code.
 ///
 /// @return Returns 0 upon success, non-zero upon failure.
 int load(LibraryHandle&) {
@@ -84,20 +86,11 @@ int load(LibraryHandle&) {
         // Do an initial load of the registry.
         user_registry->refresh();
 
-        // zero out the errno to be safe
-        errno = 0;
+        // Reload the registry in the background when the file changes.
+        user_registry->startRefresh(registry_refresh_interval);
 
         // Open up the output file for user_chk results.
-        user_chk_output.open(user_chk_output_fname,
-                     std::fstream::out | std::fstream::app);
-
-        if (!user_chk_output) {
-            // Grab the system error message.
-            const char* errmsg = strerror(errno);
-            isc_throw(isc::Unexpected, "Cannot open output file: "
-                                       << user_chk_output_fname
-                                       << " reason: " << errmsg);
-        }
+        user_chk_output.reset(new OutcomeWriter(user_chk_output_fname));
     }
     catch (const std::exception& ex) {
         // Log the error and return failure.
@@ -111,15 +104,14 @@ int load(LibraryHandle&) {
 
 /// @brief Called by the Hooks library manager when the library is unloaded.
 ///
-/// Destroys the UserRegistry and closes the outcome file.
+/// Destroys the UserRegistry, writes the pending outcomes and closes the
+/// outcome file.
 ///
 /// @return Always returns 0.
 int unload() {
     try {
         user_registry.reset();
-        if (user_chk_output.is_open()) {
-            user_chk_output.close();
-        }
+        user_chk_output.reset();
     } catch (const std::exception& ex) {
         // On the off chance something goes awry, catch it and log it.
         // @todo Not sure if we should return a non-zero result or not.
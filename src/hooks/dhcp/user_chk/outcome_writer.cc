@@ -0,0 +1,92 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <outcome_writer.h>
+
+#include <cstring>
+#include <errno.h>
+
+namespace user_chk {
+
+const size_t OutcomeWriter::DEFAULT_MAX_PENDING;
+
+OutcomeWriter::OutcomeWriter(const std::string& fname, size_t max_pending)
+    : fname_(fname), file_(), max_pending_(max_pending), pending_(),
+      pending_count_(0), writing_(false), stopping_(false) {
+    if (max_pending_ == 0) {
+        isc_throw(OutcomeWriterError, "maximum number of pending records"
+                  " cannot be 0");
+    }
+
+    // zero out the errno to be safe
+    errno = 0;
+    file_.open(fname_.c_str(), std::ofstream::out | std::ofstream::app);
+    if (!file_) {
+        // Grab the system error message.
+        const char* errmsg = strerror(errno);
+        isc_throw(OutcomeWriterError, "Cannot open output file: " << fname_
+                  << " reason: " << errmsg);
+    }
+
+    thread_.reset(new std::thread(&OutcomeWriter::run, this));
+}
+
+OutcomeWriter::~OutcomeWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cond_.notify_all();
+    thread_->join();
+    thread_.reset();
+    file_.close();
+}
+
+void
+OutcomeWriter::write(const std::string& record) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this]() { return (pending_count_ < max_pending_); });
+    pending_ += record;
+    ++pending_count_;
+    lock.unlock();
+    cond_.notify_all();
+}
+
+void
+OutcomeWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this]() { return ((pending_count_ == 0) && !writing_); });
+}
+
+void
+OutcomeWriter::run() {
+    std::string batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            writing_ = false;
+            cond_.notify_all();
+            cond_.wait(lock, [this]() {
+                return (stopping_ || (pending_count_ > 0));
+            });
+            if (pending_count_ == 0) {
+                return;
+            }
+            // Take all the buffered records so they are written at once.
+            batch.clear();
+            batch.swap(pending_);
+            pending_count_ = 0;
+            writing_ = true;
+        }
+        cond_.notify_all();
+        file_ << batch;
+        file_.flush();
+    }
+}
+
+} // namespace user_chk
@@ -0,0 +1,109 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef _OUTCOME_WRITER_H
+#define _OUTCOME_WRITER_H
+
+/// @file outcome_writer.h Defines the class, OutcomeWriter.
+
+#include <exceptions/exceptions.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace user_chk {
+
+/// @brief Thrown if OutcomeWriter encounters an error.
+class OutcomeWriterError : public isc::Exception {
+public:
+    OutcomeWriterError(const char* file, size_t line, const char* what) :
+        isc::Exception(file, line, what)
+    {}
+};
+
+/// @brief Writes the user check outcome records in the background.
+///
+/// The callouts append their records to a buffer and a writer thread
+/// writes and flushes the buffered records at once, so the packet
+/// processing does not wait for the file. When the buffer holds the
+/// maximum number of records the callouts wait for the writer thread.
+class OutcomeWriter : public boost::noncopyable {
+public:
+    /// @brief Default maximum number of buffered records.
+    static const size_t DEFAULT_MAX_PENDING = 4096;
+
+    /// @brief Constructor
+    ///
+    /// Opens the output file for appending and starts the writer thread.
+    ///
+    /// @param fname pathname of the output file.
+    /// @param max_pending maximum number of buffered records.
+    ///
+    /// @throw OutcomeWriterError if the file cannot be opened or the
+    /// maximum number of buffered records is 0.
+    OutcomeWriter(const std::string& fname,
+                  size_t max_pending = DEFAULT_MAX_PENDING);
+
+    /// @brief Destructor
+    ///
+    /// Writes the buffered records and closes the file.
+    ~OutcomeWriter();
+
+    /// @brief Buffers a record.
+    ///
+    /// @param record The record text.
+    void write(const std::string& record);
+
+    /// @brief Waits until the buffered records have been written.
+    void flush();
+
+private:
+    /// @brief The writer thread body.
+    void run();
+
+    /// @brief Pathname of the output file.
+    std::string fname_;
+
+    /// @brief Output file stream.
+    std::ofstream file_;
+
+    /// @brief Maximum number of buffered records.
+    size_t max_pending_;
+
+    /// @brief The buffered records.
+    std::string pending_;
+
+    /// @brief Number of buffered records.
+    size_t pending_count_;
+
+    /// @brief Flag set while the writer thread writes a batch.
+    bool writing_;
+
+    /// @brief Flag set when the writer thread must stop.
+    bool stopping_;
+
+    /// @brief Mutex protecting the buffer.
+    std::mutex mutex_;
+
+    /// @brief Condition signaled when the buffer changes.
+    std::condition_variable cond_;
+
+    /// @brief The writer thread.
+    boost::scoped_ptr<std::thread> thread_;
+};
+
+/// @brief Defines a smart pointer to an OutcomeWriter.
+typedef boost::shared_ptr<OutcomeWriter> OutcomeWriterPtr;
+
+} // namespace user_chk
+
+#endif
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -27,12 +27,12 @@ extern "C" {
 ///
 /// This function determines if the DHCP client identified by the inbound
 /// DHCP query packet is in the user registry.
-/// Upon entry, the registry is refreshed. Next the hardware address is
-/// extracted from query and saved to the context as the "query_user_id".
-/// This id is then used to search the user registry.  The resultant UserPtr
-/// whether the user is found or not, is saved to the callout context as
-/// "registered_user".   This makes the registered user, if not null, available
-/// to subsequent callouts.
+/// The hardware address is extracted from query and saved to the context as
+/// the "query_user_id". This id is then used to search the user registry.
+/// The resultant UserPtr whether the user is found or not, is saved to the
+/// callout context as "registered_user".   This makes the registered user,
+/// if not null, available to subsequent callouts. The registry is kept up
+/// to date by its background refresh.
 ///
 /// @param handle CalloutHandle which provides access to context.
 ///
@@ -51,9 +51,6 @@ int pkt4_receive(CalloutHandle& handle) {
     }
 
     try {
-        // Refresh the registry.
-        user_registry->refresh();
-
         // Get the HWAddress to use as the user identifier.
         Pkt4Ptr query;
         handle.getArgument("query4", query);
@@ -85,12 +82,12 @@ int pkt4_receive(CalloutHandle& handle) {
 ///
 /// This function determines if the DHCP client identified by the inbound
 /// DHCP query packet is in the user registry.
-/// Upon entry, the registry is refreshed. Next the DUID is extracted from
-/// query and saved to the context as the "query_user_id". This id is then
-/// used to search the user registry.  The resultant UserPtr whether the user
-/// is found or not, is saved to the callout context as "registered_user".
-/// This makes the registered user, if not null, available to subsequent
-/// callouts.
+/// The DUID is extracted from query and saved to the context as the
+/// "query_user_id". This id is then used to search the user registry.  The
+/// resultant UserPtr whether the user is found or not, is saved to the
+/// callout context as "registered_user". This makes the registered user, if
+/// not null, available to subsequent callouts. The registry is kept up to
+/// date by its background refresh.
 ///
 /// @param handle CalloutHandle which provides access to context.
 ///
@@ -109,9 +106,6 @@ int pkt6_receive(CalloutHandle& handle) {
     }
 
     try {
-        // Refresh the registry.
-        user_registry->refresh();
-
         // Fetch the inbound packet.
         Pkt6Ptr query;
         handle.getArgument("query6", query);
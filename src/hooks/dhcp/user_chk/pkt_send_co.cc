@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -21,6 +21,8 @@
 #include <dhcp/pkt6.h>
 #include <user_chk.h>
 
+#include <sstream>
+
 using namespace isc::dhcp;
 using namespace isc::hooks;
 using namespace user_chk;
@@ -40,8 +42,8 @@ void add4Options(Pkt4Ptr& response, const UserPtr& user);
 void add4Option(Pkt4Ptr& response, uint8_t opt_code, std::string& opt_value);
 void add6Options(Pkt6Ptr& response, const UserPtr& user);
 void add6Option(OptionPtr& vendor, uint8_t opt_code, std::string& opt_value);
-const UserPtr& getDefaultUser4();
-const UserPtr& getDefaultUser6();
+UserPtr getDefaultUser4();
+UserPtr getDefaultUser6();
 
 // Functions accessed by the hooks framework use C linkage to avoid the name
 // mangling that accompanies use of the C++ compiler as well as to avoid
@@ -330,6 +332,9 @@ void add6Option(OptionPtr& vendor, uint8_t opt_code, std::string& opt_value) {
 /// @todo This ought to be replaced with an abstract output similar to
 /// UserDataSource to allow greater flexibility.
 ///
+/// The entry is handed to the outcome writer which appends it to the file
+/// in the background.
+///
 /// Each user entry is written in an ini-like format, with one name-value pair
 /// per line as follows:
 ///
@@ -375,16 +380,15 @@ void generate_output_record(const std::string& id_type_str,
                             const std::string& addr_str,
                             const bool& registered)
 {
-    user_chk_output << "id_type=" << id_type_str << std::endl
-                    << "client=" << id_val_str << std::endl
-                    << "addr=" << addr_str << std::endl
-                    << "registered=" << (registered ? "yes" : "no")
-                    << std::endl
-                    << std::endl;   // extra line in between
-
-    // @todo Flush is here to ensure output is immediate for demo purposes.
-    // Performance would generally dictate not using it.
-    flush(user_chk_output);
+    std::ostringstream record;
+    record << "id_type=" << id_type_str << std::endl
+           << "client=" << id_val_str << std::endl
+           << "addr=" << addr_str << std::endl
+           << "registered=" << (registered ? "yes" : "no")
+           << std::endl
+           << std::endl;   // extra line in between
+
+    user_chk_output->write(record.str());
 }
 
 /// @brief Stringify the lease address or prefix IPv6 response packet
@@ -535,7 +539,7 @@ bool checkIAStatus(boost::shared_ptr<Option6IA>& ia) {
 /// The default user may be used to provide default property values.
 ///
 /// @return A pointer to the IPv4 user or null if not defined.
-const UserPtr& getDefaultUser4() {
+UserPtr getDefaultUser4() {
    return (user_registry->findUser(UserId(UserId::HW_ADDRESS,
                                           default_user4_id_str)));
 }
@@ -545,7 +549,7 @@ const UserPtr& getDefaultUser4() {
 /// The default user may be used to provide default property values.
 ///
 /// @return A pointer to the IPv6 user or null if not defined.
-const UserPtr& getDefaultUser6() {
+UserPtr getDefaultUser6() {
    return (user_registry->findUser(UserId(UserId::DUID,
                                           default_user6_id_str)));
 }
@@ -0,0 +1,114 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <outcome_writer.h>
+#include <test_data_files_config.h>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace std;
+using namespace user_chk;
+
+namespace {
+
+/// @brief Returns the content of a file.
+///
+/// @param fname pathname of the file
+std::string readFile(const std::string& fname) {
+    std::ifstream in(fname.c_str());
+    std::ostringstream content;
+    content << in.rdbuf();
+    return (content.str());
+}
+
+/// @brief Tests the OutcomeWriter constructor.
+TEST(OutcomeWriter, construction) {
+    std::string fname = std::string(USER_CHK_TEST_BUILDDIR) +
+                        "/outcome_writer.tmp";
+
+    // Verify that a file which can't be opened is rejected.
+    ASSERT_THROW(OutcomeWriter("/no/such/dir/outcome.txt"),
+                 OutcomeWriterError);
+
+    // Verify that no buffered records is rejected.
+    ASSERT_THROW(OutcomeWriter(fname, 0), OutcomeWriterError);
+
+    OutcomeWriterPtr writer;
+    ASSERT_NO_THROW(writer.reset(new OutcomeWriter(fname)));
+    writer.reset();
+    static_cast<void>(unlink(fname.c_str()));
+}
+
+/// @brief Tests the records are appended to the file.
+TEST(OutcomeWriter, write) {
+    std::string fname = std::string(USER_CHK_TEST_BUILDDIR) +
+                        "/outcome_writer.tmp";
+    static_cast<void>(unlink(fname.c_str()));
+
+    OutcomeWriterPtr writer;
+    ASSERT_NO_THROW(writer.reset(new OutcomeWriter(fname)));
+    ASSERT_NO_THROW(writer->write("first\n"));
+    ASSERT_NO_THROW(writer->write("second\n"));
+    ASSERT_NO_THROW(writer->flush());
+    EXPECT_EQ("first\nsecond\n", readFile(fname));
+
+    // The destructor writes the buffered records.
+    ASSERT_NO_THROW(writer->write("third\n"));
+    writer.reset();
+    EXPECT_EQ("first\nsecond\nthird\n", readFile(fname));
+
+    // The file is appended.
+    ASSERT_NO_THROW(writer.reset(new OutcomeWriter(fname)));
+    ASSERT_NO_THROW(writer->write("fourth\n"));
+    writer.reset();
+    EXPECT_EQ("first\nsecond\nthird\nfourth\n", readFile(fname));
+
+    static_cast<void>(unlink(fname.c_str()));
+}
+
+/// @brief Tests concurrent writers with a small buffer.
+TEST(OutcomeWriter, concurrentWrite) {
+    std::string fname = std::string(USER_CHK_TEST_BUILDDIR) +
+                        "/outcome_writer.tmp";
+    static_cast<void>(unlink(fname.c_str()));
+
+    OutcomeWriterPtr writer(new OutcomeWriter(fname, 2));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.push_back(std::thread([&writer]() {
+            for (int j = 0; j < 100; ++j) {
+                writer->write("record\n");
+            }
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    writer->flush();
+
+    std::string content = readFile(fname);
+    size_t count = 0;
+    for (auto const c : content) {
+        if (c == '\n') {
+            ++count;
+        }
+    }
+    EXPECT_EQ(400, count);
+    EXPECT_EQ(400 * std::string("record\n").size(), content.size());
+
+    writer.reset();
+    static_cast<void>(unlink(fname.c_str()));
+}
+
+} // end of anonymous namespace
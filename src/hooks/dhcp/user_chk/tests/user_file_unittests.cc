@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,6 +13,9 @@
 #include <boost/shared_ptr.hpp>
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <unistd.h>
+
 using namespace std;
 using namespace user_chk;
 
@@ -72,6 +75,43 @@ TEST(UserFile, openFile) {
 }
 
 
+/// @brief Tests the detection of changes of the file
+TEST(UserFile, hasChanged) {
+    std::string fname = std::string(USER_CHK_TEST_BUILDDIR) +
+                        "/user_file_changed.tmp";
+    std::ofstream out(fname.c_str(), std::ofstream::trunc);
+    out << "{ \"type\" : \"HW_ADDR\", \"id\" : \"01AC00F03344\" }"
+        << std::endl;
+    out.close();
+
+    UserFilePtr user_file;
+    ASSERT_NO_THROW(user_file.reset(new UserFile(fname)));
+
+    // A file never opened has changed.
+    EXPECT_TRUE(user_file->hasChanged());
+
+    // Once read the file has not changed.
+    ASSERT_NO_THROW(user_file->open());
+    ASSERT_NO_THROW(user_file->close());
+    EXPECT_FALSE(user_file->hasChanged());
+
+    // Append a user: the size changes.
+    out.open(fname.c_str(), std::ofstream::app);
+    out << "{ \"type\" : \"DUID\", \"id\" : \"225060de0a0b\" }"
+        << std::endl;
+    out.close();
+    EXPECT_TRUE(user_file->hasChanged());
+
+    // Reading it again clears the change.
+    ASSERT_NO_THROW(user_file->open());
+    ASSERT_NO_THROW(user_file->close());
+    EXPECT_FALSE(user_file->hasChanged());
+
+    // A removed file has changed.
+    static_cast<void>(unlink(fname.c_str()));
+    EXPECT_TRUE(user_file->hasChanged());
+}
+
 /// @brief Tests makeUser with invalid user strings
 TEST(UserFile, makeUser) {
     const char* invalid_strs[]= {
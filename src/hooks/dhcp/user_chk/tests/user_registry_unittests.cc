@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,6 +15,11 @@
 #include <boost/shared_ptr.hpp>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
 using namespace std;
 using namespace user_chk;
 
@@ -30,6 +35,18 @@ std::string testFilePath(const std::string& name) {
     return (std::string(USER_CHK_TEST_DIR) + "/" + name);
 }
 
+/// @brief Writes a user file with the given number of HW address users.
+///
+/// @param fname pathname of the file
+/// @param count number of users, their ids end with 0 to count - 1
+void writeUserFile(const std::string& fname, int count) {
+    std::ofstream out(fname.c_str(), std::ofstream::trunc);
+    for (int i = 0; i < count; ++i) {
+        out << "{ \"type\" : \"HW_ADDR\", \"id\" : \"01ac00f0330" << i
+            << "\" }" << std::endl;
+    }
+}
+
 /// @brief Tests UserRegistry construction.
 TEST(UserRegistry, constructor) {
     // Currently there is only the default constructor which does not throw.
@@ -206,4 +223,70 @@ TEST(UserRegistry, refreshFail) {
     EXPECT_TRUE(reg->findUser(*id2));
 }
 
+/// @brief Tests the registry is reloaded only when its source changed.
+TEST(UserRegistry, refreshIfChanged) {
+    std::string fname = std::string(USER_CHK_TEST_BUILDDIR) +
+                        "/user_registry_changed.tmp";
+    writeUserFile(fname, 1);
+
+    UserRegistryPtr reg(new UserRegistry());
+    UserDataSourcePtr user_file(new UserFile(fname));
+    ASSERT_NO_THROW(reg->setSource(user_file));
+    ASSERT_NO_THROW(reg->refresh());
+
+    UserId id0(UserId::HW_ADDRESS, "01ac00f03300");
+    UserId id1(UserId::HW_ADDRESS, "01ac00f03301");
+    EXPECT_TRUE(reg->findUser(id0));
+    EXPECT_FALSE(reg->findUser(id1));
+
+    // The file did not change.
+    bool refreshed = true;
+    ASSERT_NO_THROW(refreshed = reg->refreshIfChanged());
+    EXPECT_FALSE(refreshed);
+
+    // Add a user.
+    writeUserFile(fname, 2);
+    ASSERT_NO_THROW(refreshed = reg->refreshIfChanged());
+    EXPECT_TRUE(refreshed);
+    EXPECT_TRUE(reg->findUser(id0));
+    EXPECT_TRUE(reg->findUser(id1));
+
+    static_cast<void>(unlink(fname.c_str()));
+}
+
+/// @brief Tests the background refresh of the registry.
+TEST(UserRegistry, startRefresh) {
+    std::string fname = std::string(USER_CHK_TEST_BUILDDIR) +
+                        "/user_registry_refresh.tmp";
+    writeUserFile(fname, 1);
+
+    UserRegistryPtr reg(new UserRegistry());
+    UserDataSourcePtr user_file(new UserFile(fname));
+    ASSERT_NO_THROW(reg->setSource(user_file));
+    ASSERT_NO_THROW(reg->refresh());
+    ASSERT_NO_THROW(reg->startRefresh(10));
+
+    // Add two users and wait for the reload.
+    writeUserFile(fname, 3);
+    UserId id2(UserId::HW_ADDRESS, "01ac00f03302");
+    for (int i = 0; (i < 500) && !reg->findUser(id2); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_TRUE(reg->findUser(id2));
+
+    // An invalid file keeps the users.
+    {
+        std::ofstream out(fname.c_str(), std::ofstream::app);
+        out << "{ bogus }" << std::endl;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_TRUE(reg->findUser(id2));
+
+    ASSERT_NO_THROW(reg->stopRefresh());
+    // Stopping twice is harmless.
+    ASSERT_NO_THROW(reg->stopRefresh());
+
+    static_cast<void>(unlink(fname.c_str()));
+}
+
 } // end of anonymous namespace
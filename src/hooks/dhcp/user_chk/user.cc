@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015,2017 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2015,2017,2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,6 +13,8 @@
 
 #include <user.h>
 
+#include <boost/functional/hash.hpp>
+
 #include <iomanip>
 #include <sstream>
 
@@ -115,6 +117,14 @@ UserId::operator <(const UserId & other) const {
             ((this->id_type_ == other.id_type_) && (this->id_ < other.id_)));
 }
 
+size_t
+UserIdHash::operator()(const UserId& user_id) const {
+    size_t seed = boost::hash_range(user_id.getId().begin(),
+                                    user_id.getId().end());
+    boost::hash_combine(seed, static_cast<int>(user_id.getType()));
+    return (seed);
+}
+
 std::string
 UserId::lookupTypeStr(UserIdType type) {
     const char* tmp = NULL;
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -122,6 +122,15 @@ private:
 
 };
 
+/// @brief Hashes a UserId so it can be used as the key of unordered
+/// containers.
+struct UserIdHash {
+    /// @brief Returns the hash of a UserId.
+    ///
+    /// @param user_id The user id to hash.
+    size_t operator()(const UserId& user_id) const;
+};
+
 /// @brief Outputs the UserId contents in a string to the given stream.
 ///
 /// The output string has the form "<type>=<id>" where:
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2015,2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -6,8 +6,8 @@
 #ifndef USER_CHK_H
 #define USER_CHK_H
 
+#include <outcome_writer.h>
 #include <user_registry.h>
-#include <fstream>
 #include <string>
 
 // The following constants are used throughout the library.  They are defined
@@ -16,8 +16,8 @@
 /// @brief Pointer to the registry instance.
 extern user_chk::UserRegistryPtr user_registry;
 
-/// @brief Output filestream for recording user check outcomes.
-extern std::fstream user_chk_output;
+/// @brief Background writer recording user check outcomes.
+extern user_chk::OutcomeWriterPtr user_chk_output;
 
 /// @brief User registry input file name.
 extern const char* registry_fname;
@@ -25,6 +25,10 @@ extern const char* registry_fname;
 /// @brief User check outcome file name.
 extern const char* user_chk_output_fname;
 
+/// @brief Interval in milliseconds between two checks of the user
+/// registry input file.
+extern const long registry_refresh_interval;
+
 /// @brief Text label of user id in the inbound query in callout context
 extern const char* query_user_id_label;
 
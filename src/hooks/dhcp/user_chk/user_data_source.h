@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2015,2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -61,6 +61,17 @@ public:
     ///
     /// It is assumed to be exception safe.
     virtual bool isOpen() const = 0;
+
+    /// @brief Returns true if the content may have changed since the
+    /// data source was last opened.
+    ///
+    /// The registry is refreshed in the background only when the content
+    /// may have changed. The default implementation always returns true.
+    ///
+    /// It is assumed to be exception safe.
+    virtual bool hasChanged() const {
+        return (true);
+    }
 };
 
 /// @brief Defines a smart pointer to a UserDataSource.
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,10 +13,12 @@
 #include <boost/foreach.hpp>
 #include <errno.h>
 #include <iostream>
+#include <sys/stat.h>
 
 namespace user_chk {
 
-UserFile::UserFile(const std::string& fname) : fname_(fname), file_() {
+UserFile::UserFile(const std::string& fname)
+    : fname_(fname), file_(), mtime_(-1), size_(0) {
     if (fname_.empty()) {
         isc_throw(UserFileError, "file name cannot be blank");
     }
@@ -32,12 +34,33 @@ UserFile::open() {
         isc_throw(UserFileError, "file is already open");
     }
 
+    // Get the file state before it is read so a change during the read
+    // is seen by the next call to hasChanged.
+    struct stat st;
+    bool have_stat = (stat(fname_.c_str(), &st) == 0);
+
     file_.open(fname_.c_str(), std::ifstream::in);
     int sav_error = errno;
     if (!file_.is_open()) {
         isc_throw(UserFileError, "cannot open file:" << fname_
                                  << " reason: " << strerror(sav_error));
     }
+
+    if (have_stat) {
+        mtime_ = st.st_mtime;
+        size_ = st.st_size;
+    } else {
+        mtime_ = -1;
+    }
+}
+
+bool
+UserFile::hasChanged() const {
+    struct stat st;
+    if ((mtime_ < 0) || (stat(fname_.c_str(), &st) != 0)) {
+        return (true);
+    }
+    return ((st.st_mtime != mtime_) || (st.st_size != size_));
 }
 
 UserPtr
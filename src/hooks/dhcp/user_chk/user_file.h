@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015,2017 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2015,2017,2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,6 +14,7 @@
 #include <boost/shared_ptr.hpp>
 #include <fstream>
 #include <string>
+#include <sys/types.h>
 
 namespace user_chk {
 
@@ -104,6 +105,16 @@ public:
     /// @return True if the underlying file is open, false otherwise.
     virtual bool isOpen() const;
 
+    /// @brief Returns true if the file may have changed since it was last
+    /// opened.
+    ///
+    /// The modification time and size of the file are compared with the
+    /// ones of the last open. A file which can't be examined is reported
+    /// as changed so the error is reported by the next open.
+    ///
+    /// @return True if the file was never opened or may have changed.
+    virtual bool hasChanged() const;
+
     /// @brief Creates a new User instance from JSON text.
     ///
     /// @param user_string string the JSON text for a user entry.
@@ -120,6 +131,12 @@ private:
     /// @brief Input file stream.
     std::ifstream file_;
 
+    /// @brief Modification time of the file at the last open or -1.
+    time_t mtime_;
+
+    /// @brief Size of the file at the last open.
+    off_t size_;
+
 };
 
 /// @brief Defines a smart pointer to a UserFile.
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015,2017 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2015,2017,2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -6,15 +6,19 @@
 
 #include <config.h>
 
+#include <user_chk_log.h>
 #include <user_registry.h>
 #include <user.h>
 
+#include <chrono>
+
 namespace user_chk {
 
-UserRegistry::UserRegistry() {
+UserRegistry::UserRegistry() : users_(new UserMap()), stopping_(false) {
 }
 
 UserRegistry::~UserRegistry(){
+    stopRefresh();
 }
 
 void
@@ -23,49 +27,44 @@ UserRegistry::addUser(UserPtr& user) {
         isc_throw (UserRegistryError, "UserRegistry cannot add blank user");
     }
 
-    UserPtr found_user;
-    if ((found_user = findUser(user->getUserId()))) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!users_->insert(std::make_pair(user->getUserId(), user)).second) {
         isc_throw (UserRegistryError, "UserRegistry duplicate user: "
                    << user->getUserId());
     }
-
-    users_[user->getUserId()] = user;
 }
 
-const UserPtr&
+UserPtr
 UserRegistry::findUser(const UserId& id) const {
-    static UserPtr empty;
-    UserMap::const_iterator it = users_.find(id);
-    if (it != users_.end()) {
-        const UserPtr tmp = (*it).second;
+    std::lock_guard<std::mutex> lock(mutex_);
+    UserMap::const_iterator it = users_->find(id);
+    if (it != users_->end()) {
         return ((*it).second);
     }
 
-    return empty;
+    return (UserPtr());
 }
 
 void
 UserRegistry::removeUser(const UserId& id) {
-    static UserPtr empty;
-    UserMap::iterator it = users_.find(id);
-    if (it != users_.end()) {
-        users_.erase(it);
-    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    static_cast<void>(users_->erase(id));
 }
 
-const UserPtr&
+UserPtr
 UserRegistry::findUser(const isc::dhcp::HWAddr& hwaddr) const {
     UserId id(UserId::HW_ADDRESS, hwaddr.hwaddr_);
     return (findUser(id));
 }
 
-const UserPtr&
+UserPtr
 UserRegistry::findUser(const isc::dhcp::DUID& duid) const {
     UserId id(UserId::DUID, duid.getDuid());
     return (findUser(id));
 }
 
 void UserRegistry::refresh() {
+    std::lock_guard<std::mutex> source_lock(source_mutex_);
     if (!source_) {
         isc_throw(UserRegistryError,
                   "UserRegistry: cannot refresh, no data source");
@@ -76,19 +75,19 @@ void UserRegistry::refresh() {
         source_->open();
     }
 
-    // Make a copy in case something goes wrong midstream.
-    UserMap backup(users_);
-
-    // Empty the registry then read users from source until source is empty.
-    clearall();
+    // Read users from source into a new list until source is empty, so
+    // the registry is usable during the read and unchanged on error.
+    UserMapPtr users(new UserMap());
     try {
         UserPtr user;
         while ((user = source_->readNextUser())) {
-            addUser(user);
+            if (!users->insert(std::make_pair(user->getUserId(),
+                                              user)).second) {
+                isc_throw (UserRegistryError, "UserRegistry duplicate user: "
+                           << user->getUserId());
+            }
         }
     } catch (const std::exception& ex) {
-        // Source was compromised so restore registry from backup.
-        users_ = backup;
         // Close the source.
         source_->close();
         isc_throw (UserRegistryError, "UserRegistry: refresh failed during read"
@@ -97,10 +96,83 @@ void UserRegistry::refresh() {
 
     // Close the source.
     source_->close();
+
+    // Replace the registry contents.
+    std::lock_guard<std::mutex> lock(mutex_);
+    users_.swap(users);
+}
+
+bool UserRegistry::refreshIfChanged() {
+    {
+        std::lock_guard<std::mutex> source_lock(source_mutex_);
+        if (source_ && !source_->hasChanged()) {
+            return (false);
+        }
+    }
+    refresh();
+    return (true);
+}
+
+void UserRegistry::startRefresh(long interval) {
+    if (interval <= 0) {
+        isc_throw(UserRegistryError,
+                  "UserRegistry: refresh interval must be positive");
+    }
+    {
+        std::lock_guard<std::mutex> source_lock(source_mutex_);
+        if (!source_) {
+            isc_throw(UserRegistryError,
+                      "UserRegistry: cannot refresh, no data source");
+        }
+    }
+    std::lock_guard<std::mutex> lock(refresh_mutex_);
+    if (refresh_thread_) {
+        isc_throw(UserRegistryError,
+                  "UserRegistry: background refresh already running");
+    }
+    stopping_ = false;
+    refresh_thread_.reset(new std::thread(&UserRegistry::runRefresh, this,
+                                          interval));
+}
+
+void UserRegistry::stopRefresh() {
+    {
+        std::lock_guard<std::mutex> lock(refresh_mutex_);
+        if (!refresh_thread_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    refresh_cond_.notify_all();
+    refresh_thread_->join();
+    refresh_thread_.reset();
+}
+
+void UserRegistry::runRefresh(long interval) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(refresh_mutex_);
+            if (refresh_cond_.wait_for(lock,
+                                       std::chrono::milliseconds(interval),
+                                       [this]() { return (stopping_); })) {
+                return;
+            }
+        }
+        try {
+            if (refreshIfChanged()) {
+                LOG_DEBUG(user_chk_logger, isc::log::DBGLVL_TRACE_BASIC,
+                          USER_CHK_REGISTRY_REFRESHED);
+            }
+        } catch (const std::exception& ex) {
+            LOG_ERROR(user_chk_logger, USER_CHK_REGISTRY_REFRESH_ERROR)
+                .arg(ex.what());
+        }
+    }
 }
 
 void UserRegistry::clearall() {
-    users_.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    users_.reset(new UserMap());
 }
 
 void UserRegistry::setSource(UserDataSourcePtr& source) {
@@ -109,6 +181,7 @@ void UserRegistry::setSource(UserDataSourcePtr& source) {
                    "UserRegistry: data source cannot be set to null");
     }
 
+    std::lock_guard<std::mutex> source_lock(source_mutex_);
     source_ = source;
 }
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015,2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,7 +14,14 @@
 #include <user.h>
 #include <user_data_source.h>
 
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 
 namespace user_chk {
 
@@ -26,8 +33,11 @@ public:
     {}
 };
 
-/// @brief Defines a map of unique Users keyed by UserId.
-typedef std::map<UserId,UserPtr> UserMap;
+/// @brief Defines a hash map of unique Users keyed by UserId.
+typedef std::unordered_map<UserId, UserPtr, UserIdHash> UserMap;
+
+/// @brief Defines a smart pointer to a UserMap.
+typedef boost::shared_ptr<UserMap> UserMapPtr;
 
 /// @brief Embodies an update-able, searchable list of unique users
 /// This class provides the means to create and maintain a searchable list
@@ -35,6 +45,12 @@ typedef std::map<UserId,UserPtr> UserMap;
 /// by their UserIds.
 /// Users may be added and removed from the list individually or the list
 /// may be updated by loading it from a data source, such as a file.
+///
+/// The registry is thread safe: a refresh reads the data source into a
+/// new list which replaces the current one at once, so the lookups never
+/// wait for the data source. The refresh can be done periodically by a
+/// background thread which reads the data source only when it has
+/// changed.
 class UserRegistry {
 public:
     /// @brief Constructor
@@ -58,7 +74,7 @@ public:
     /// @param id The user id for which to search
     ///
     /// @return A pointer to the user if found or an null pointer if not.
-    const UserPtr& findUser(const UserId& id) const;
+    UserPtr findUser(const UserId& id) const;
 
     /// @brief Removes a user from the registry by user id
     ///
@@ -72,27 +88,52 @@ public:
     /// @param hwaddr The hardware address for which to search
     ///
     /// @return A pointer to the user if found or an null pointer if not.
-    const UserPtr& findUser(const isc::dhcp::HWAddr& hwaddr) const;
+    UserPtr findUser(const isc::dhcp::HWAddr& hwaddr) const;
 
     /// @brief Finds a user in the registry by DUID
     ///
     /// @param duid The DUID for which to search
     ///
     /// @return A pointer to the user if found or an null pointer if not.
-    const UserPtr& findUser(const isc::dhcp::DUID& duid) const;
+    UserPtr findUser(const isc::dhcp::DUID& duid) const;
 
     /// @brief Updates the registry from its data source.
     ///
     /// This method will replace the contents of the registry with new content
     /// read from its data source.  It will attempt to open the source and
-    /// then add users from the source to the registry until the source is
-    /// exhausted.  If an error occurs accessing the source the registry
-    /// contents will be restored to that of before the call to refresh.
+    /// then add users from the source to a new list until the source is
+    /// exhausted. The new list then replaces the contents of the registry.
+    /// If an error occurs accessing the source the registry contents are
+    /// left unchanged.
     ///
     /// @throw UserRegistryError if the data source has not been set (is null)
     /// or if an error occurs accessing the data source.
     void refresh();
 
+    /// @brief Updates the registry from its data source if the data source
+    /// has changed.
+    ///
+    /// @return True if the registry was refreshed.
+    /// @throw UserRegistryError if the data source has not been set (is null)
+    /// or if an error occurs accessing the data source.
+    bool refreshIfChanged();
+
+    /// @brief Starts the background refresh.
+    ///
+    /// A thread periodically calls @ref refreshIfChanged. The errors are
+    /// logged and the registry contents are left unchanged.
+    ///
+    /// @param interval The interval between two checks in milliseconds.
+    ///
+    /// @throw UserRegistryError if the data source has not been set, the
+    /// interval is 0 or the background refresh is already running.
+    void startRefresh(long interval);
+
+    /// @brief Stops the background refresh.
+    ///
+    /// Does nothing if the background refresh is not running.
+    void stopRefresh();
+
     /// @brief Removes all entries from the registry.
     void clearall();
 
@@ -107,11 +148,34 @@ public:
     void setSource(UserDataSourcePtr& source);
 
 private:
+    /// @brief The background refresh thread body.
+    ///
+    /// @param interval The interval between two checks in milliseconds.
+    void runRefresh(long interval);
+
     /// @brief The registry of users.
-    UserMap users_;
+    UserMapPtr users_;
 
     /// @brief The current data source of users.
     UserDataSourcePtr source_;
+
+    /// @brief Mutex protecting the registry of users.
+    mutable std::mutex mutex_;
+
+    /// @brief Mutex serializing the accesses to the data source.
+    std::mutex source_mutex_;
+
+    /// @brief Mutex protecting the background refresh state.
+    std::mutex refresh_mutex_;
+
+    /// @brief Condition signaled to stop the background refresh.
+    std::condition_variable refresh_cond_;
+
+    /// @brief Flag set when the background refresh must stop.
+    bool stopping_;
+
+    /// @brief The background refresh thread.
+    boost::scoped_ptr<std::thread> refresh_thread_;
 };
 
 /// @brief Define a smart pointer to a UserRegistry.
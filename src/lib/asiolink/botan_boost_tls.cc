@@ -1,4 +1,4 @@
-// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -183,8 +183,9 @@ public:
 };
 
 
-// Kea session manager.
-using KeaSessionManager = Botan::TLS::Session_Manager_Noop;
+// Kea session manager: the sessions are kept in memory so they can be
+// resumed.
+using KeaSessionManager = Botan::TLS::Session_Manager_In_Memory;
 
 // Allowed signature methods which prefers RSA.
 const std::vector<std::string>
@@ -198,7 +199,7 @@ KeaPolicy::AllowedSignatureMethodsECDSA = { "ECDSA", "RSA", "DSA" };
 class TlsContextImpl {
 public:
     // Constructor.
-    TlsContextImpl() : cred_mgr_(), rng_(), sess_mgr_(), policy_() {
+    TlsContextImpl() : cred_mgr_(), rng_(), sess_mgr_(rng_), policy_() {
     }
 
     // Destructor.
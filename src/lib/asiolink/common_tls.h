@@ -1,4 +1,4 @@
-// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -77,6 +77,25 @@ public:
     /// are optional.
     virtual bool getCertRequired() const = 0;
 
+    /// @brief Get the number of completed handshakes.
+    ///
+    /// @return The number of handshakes completed with this context or
+    /// 0 when the backend does not count them.
+    virtual uint64_t getHandshakeCount() const {
+        return (0);
+    }
+
+    /// @brief Get the number of resumed sessions.
+    ///
+    /// A resumed session uses an abbreviated handshake with a session
+    /// ticket or identifier of a previous connection.
+    ///
+    /// @return The number of handshakes which resumed a session or 0
+    /// when the backend does not count them.
+    virtual uint64_t getResumedCount() const {
+        return (0);
+    }
+
 protected:
     /// @brief Set the peer certificate requirement mode.
     ///
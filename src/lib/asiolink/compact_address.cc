@@ -0,0 +1,43 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/asio_wrapper.h>
+#include <asiolink/compact_address.h>
+
+using namespace boost::asio;
+
+namespace isc {
+namespace asiolink {
+
+CompactAddress::CompactAddress(const IOAddress& address)
+    : high_(0), low_(0), v6_(address.asio_address_.is_v6()) {
+    if (!v6_) {
+        low_ = address.asio_address_.to_v4().to_ulong();
+        return;
+    }
+    auto bytes = address.asio_address_.to_v6().to_bytes();
+    for (size_t i = 0; i < 8; ++i) {
+        high_ = (high_ << 8) | bytes[i];
+        low_ = (low_ << 8) | bytes[i + 8];
+    }
+}
+
+IOAddress
+CompactAddress::toIOAddress() const {
+    if (!v6_) {
+        return (IOAddress(static_cast<uint32_t>(low_)));
+    }
+    ip::address_v6::bytes_type bytes;
+    for (size_t i = 0; i < 8; ++i) {
+        bytes[7 - i] = static_cast<uint8_t>(high_ >> (8 * i));
+        bytes[15 - i] = static_cast<uint8_t>(low_ >> (8 * i));
+    }
+    return (IOAddress(ip::address(ip::address_v6(bytes))));
+}
+
+} // namespace asiolink
+} // namespace isc
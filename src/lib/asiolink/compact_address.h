@@ -0,0 +1,142 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef COMPACT_ADDRESS_H
+#define COMPACT_ADDRESS_H 1
+
+#include <asiolink/io_address.h>
+#include <stdint.h>
+#include <cstddef>
+
+namespace isc {
+namespace asiolink {
+
+/// @brief A compact representation of an IP address.
+///
+/// The @c IOAddress wraps the ASIO address which holds room for both
+/// address families and the IPv6 scope identifier. This class holds the
+/// 128 bits of an address as two integers and a family flag, and compares
+/// and hashes them without going through ASIO. It is meant for the
+/// containers holding many addresses, e.g. the allocator states, with
+/// conversions from and to the @c IOAddress at their boundaries.
+///
+/// The IPv4 addresses are held in the low integer. The addresses are
+/// ordered as by the @c IOAddress: the IPv4 addresses precede the IPv6
+/// addresses and the addresses of the same family are in increasing order.
+/// The IPv6 scope identifier is not retained.
+class CompactAddress {
+public:
+
+    /// @brief A @c CompactAddress hash enabling the use in the unordered
+    /// STL containers.
+    struct Hash {
+        /// @brief A hashing operator.
+        ///
+        /// @param address an address to be hashed.
+        /// @return a hashing result.
+        size_t operator()(const CompactAddress& address) const {
+            return (address.hash());
+        }
+    };
+
+    /// @brief Default constructor.
+    ///
+    /// Creates the IPv4 zero address.
+    constexpr CompactAddress() : high_(0), low_(0), v6_(false) {
+    }
+
+    /// @brief Constructor from an @c IOAddress.
+    ///
+    /// @param address The address to be converted.
+    explicit CompactAddress(const IOAddress& address);
+
+    /// @brief Converts the address to an @c IOAddress.
+    ///
+    /// @return the converted address.
+    IOAddress toIOAddress() const;
+
+    /// @brief Convenience function to check for an IPv4 address.
+    ///
+    /// @return true if the address is a V4 address.
+    constexpr bool isV4() const {
+        return (!v6_);
+    }
+
+    /// @brief Convenience function to check for an IPv6 address.
+    ///
+    /// @return true if the address is a V6 address.
+    constexpr bool isV6() const {
+        return (v6_);
+    }
+
+    /// @brief Compare addresses for equality.
+    ///
+    /// @param other Address to compare against.
+    /// @return true if addresses are equal, false if not.
+    constexpr bool operator==(const CompactAddress& other) const {
+        return ((low_ == other.low_) && (high_ == other.high_) && (v6_ == other.v6_));
+    }
+
+    /// @brief Compare addresses for inequality.
+    ///
+    /// @param other Address to compare against.
+    /// @return false if addresses are equal, true if not.
+    constexpr bool operator!=(const CompactAddress& other) const {
+        return (!(*this == other));
+    }
+
+    /// @brief Checks if one address is smaller than the other.
+    ///
+    /// @param other Address to compare against.
+    constexpr bool operator<(const CompactAddress& other) const {
+        return ((v6_ != other.v6_) ? other.v6_ :
+                ((high_ != other.high_) ? (high_ < other.high_) : (low_ < other.low_)));
+    }
+
+    /// @brief Checks if one address is smaller or equal than the other.
+    ///
+    /// @param other Address to compare against.
+    constexpr bool operator<=(const CompactAddress& other) const {
+        return (!(other < *this));
+    }
+
+    /// @brief Returns the hash of the address.
+    ///
+    /// @return the hash mixing the bits of the address and its family.
+    size_t hash() const {
+        uint64_t value = (high_ * 0x9e3779b97f4a7c15ULL) ^ low_ ^ (v6_ ? 1 : 0);
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return (static_cast<size_t>(value ^ (value >> 31)));
+    }
+
+private:
+
+    /// @brief The 64 most significant bits of an IPv6 address.
+    uint64_t high_;
+
+    /// @brief The 64 least significant bits of an IPv6 address or
+    /// an IPv4 address.
+    uint64_t low_;
+
+    /// @brief Indicates if the address is an IPv6 address.
+    bool v6_;
+};
+
+/// @brief Hash the CompactAddress.
+///
+/// This function allows boost multi-index hashed indexes on compact
+/// addresses.
+///
+/// @param address A @c CompactAddress to hash.
+/// @return The hash of the address.
+inline size_t hash_value(const CompactAddress& address) {
+    return (address.hash());
+}
+
+} // namespace asiolink
+} // namespace isc
+#endif // COMPACT_ADDRESS_H
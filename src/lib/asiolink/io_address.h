@@ -294,6 +294,9 @@ public:
     //@}
 
 private:
+    /// @brief The compact address converts to and from the ASIO address.
+    friend class CompactAddress;
+
     boost::asio::ip::address asio_address_;
 };
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -17,6 +17,24 @@
 
 #include <openssl/opensslv.h>
 
+namespace {
+
+/// @brief The session identifier context of the servers.
+///
+/// Required to resume sessions when peer certificates are verified.
+const unsigned char SESSION_ID_CONTEXT[] = "kea";
+
+/// @brief Get the index of the TLS context in the SSL context extra data.
+///
+/// The application data is used by boost for the verify callback.
+int
+getExIndex() {
+    static const int index = ::SSL_CTX_get_ex_new_index(0, 0, 0, 0, 0);
+    return (index);
+}
+
+}
+
 using namespace boost::asio;
 using namespace boost::asio::ssl;
 using namespace boost::system;
@@ -38,9 +56,33 @@ TlsContext::TlsContext(TlsRole role)
       context_(context::method::tlsv1)
 #endif
 #endif
+      , session_(0)
 {
     // Not leave the verify mode to OpenSSL default.
     setCertRequired(true);
+
+    ::SSL_CTX* ctx = context_.native_handle();
+    if (::SSL_CTX_set_ex_data(ctx, getExIndex(), this) != 1) {
+        isc_throw(LibraryError, "unable to set the TLS context");
+    }
+    if (role == TlsRole::CLIENT) {
+        // The client keeps only the last session, outside the cache.
+        ::SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT |
+                                         SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        ::SSL_CTX_sess_set_new_cb(ctx, &TlsContext::newClientSession);
+    } else {
+        // Session tickets are enabled by default.
+        if (::SSL_CTX_set_session_id_context(ctx, SESSION_ID_CONTEXT,
+                                             sizeof(SESSION_ID_CONTEXT) - 1) != 1) {
+            isc_throw(LibraryError, "unable to set the session id context");
+        }
+    }
+}
+
+TlsContext::~TlsContext() {
+    if (session_) {
+        ::SSL_SESSION_free(session_);
+    }
 }
 
 boost::asio::ssl::context&
@@ -76,6 +118,75 @@ TlsContext::getCertRequired() const {
     return (cert_required_);
 }
 
+uint64_t
+TlsContext::getHandshakeCount() const {
+    ::SSL_CTX* ctx = const_cast<context&>(context_).native_handle();
+    if (getRole() == TlsRole::CLIENT) {
+        return (::SSL_CTX_sess_connect_good(ctx));
+    } else {
+        return (::SSL_CTX_sess_accept_good(ctx));
+    }
+}
+
+uint64_t
+TlsContext::getResumedCount() const {
+    ::SSL_CTX* ctx = const_cast<context&>(context_).native_handle();
+    return (::SSL_CTX_sess_hits(ctx));
+}
+
+TlsContext*
+TlsContext::getTlsContext(::SSL_CTX* ctx) {
+    return (static_cast<TlsContext*>(::SSL_CTX_get_ex_data(ctx, getExIndex())));
+}
+
+void
+TlsContext::setClientSession(::SSL* ssl) {
+    TlsContext* tls_context = getTlsContext(::SSL_get_SSL_CTX(ssl));
+    if (!tls_context) {
+        return;
+    }
+    std::lock_guard<std::mutex> lk(tls_context->session_mutex_);
+    if (!tls_context->session_) {
+        return;
+    }
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    // The connections are closed without TLS shutdown so OpenSSL marks
+    // their session as not resumable: give them a copy.
+    ::SSL_SESSION* session = ::SSL_SESSION_dup(tls_context->session_);
+    if (session) {
+        static_cast<void>(::SSL_set_session(ssl, session));
+        ::SSL_SESSION_free(session);
+    }
+#else
+    static_cast<void>(::SSL_set_session(ssl, tls_context->session_));
+#endif
+}
+
+int
+TlsContext::newClientSession(::SSL* ssl, ::SSL_SESSION* session) {
+    TlsContext* tls_context = getTlsContext(::SSL_get_SSL_CTX(ssl));
+    if (!tls_context) {
+        return (0);
+    }
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    // Keep a copy which can't be marked as not resumable.
+    ::SSL_SESSION* copy = ::SSL_SESSION_dup(session);
+    if (!copy) {
+        return (0);
+    }
+    int ret = 0;
+#else
+    ::SSL_SESSION* copy = session;
+    int ret = 1;
+#endif
+    std::lock_guard<std::mutex> lk(tls_context->session_mutex_);
+    if (tls_context->session_) {
+        ::SSL_SESSION_free(tls_context->session_);
+    }
+    tls_context->session_ = copy;
+    return (ret);
+}
+
 void
 TlsContext::loadCaFile(const std::string& ca_file) {
     error_code ec;
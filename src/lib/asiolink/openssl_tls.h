@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -20,6 +20,8 @@
 
 #include <boost/asio/ssl.hpp>
 
+#include <mutex>
+
 namespace isc {
 namespace asiolink {
 
@@ -37,10 +39,13 @@ class TlsContext : public TlsContextBase {
 public:
 
     /// @brief Destructor.
-    virtual ~TlsContext() { }
+    virtual ~TlsContext();
 
     /// @brief Create a fresh context.
     ///
+    /// A server context accepts to resume sessions. A client context
+    /// keeps the last session so a new connection resumes it.
+    ///
     /// @param role The TLS role client or server.
     explicit TlsContext(TlsRole role);
 
@@ -59,6 +64,24 @@ public:
     /// are optional.
     virtual bool getCertRequired() const;
 
+    /// @brief Get the number of completed handshakes.
+    ///
+    /// @return The number of handshakes completed with this context.
+    virtual uint64_t getHandshakeCount() const;
+
+    /// @brief Get the number of resumed sessions.
+    ///
+    /// @return The number of handshakes which resumed a session.
+    virtual uint64_t getResumedCount() const;
+
+    /// @brief Set the session of a client connection.
+    ///
+    /// Called before the handshake to resume the last session of the
+    /// client context of the connection.
+    ///
+    /// @param ssl The SSL object of the connection.
+    static void setClientSession(::SSL* ssl);
+
     /// @brief Get the error message.
     ///
     /// @note Wrapper against OpenSSL 3.x not returning error messages
@@ -95,12 +118,33 @@ protected:
     /// @param key_file The private key file name.
     virtual void loadKeyFile(const std::string& key_file);
 
+    /// @brief Get the TLS context of an SSL context.
+    ///
+    /// @param ctx The SSL context.
+    /// @return The TLS context or null.
+    static TlsContext* getTlsContext(::SSL_CTX* ctx);
+
+    /// @brief New client session callback.
+    ///
+    /// Keeps a copy of the new session in the client context.
+    ///
+    /// @param ssl The SSL object of the connection.
+    /// @param session The new session.
+    /// @return 1 when the reference to the session is kept, 0 otherwise.
+    static int newClientSession(::SSL* ssl, ::SSL_SESSION* session);
+
     /// @brief Cached cert_required value.
     bool cert_required_;
 
     /// @brief Boost ASIO SSL object.
     boost::asio::ssl::context context_;
 
+    /// @brief The last session of a client context.
+    ::SSL_SESSION* session_;
+
+    /// @brief The mutex protecting the session.
+    std::mutex session_mutex_;
+
     /// @brief Allow access to protected methods by the base class.
     friend class TlsContextBase;
 };
@@ -148,6 +192,9 @@ public:
     ///
     /// @param callback Callback object.
     virtual void handshake(Callback& callback) {
+        if (Base::getRole() == TlsRole::CLIENT) {
+            TlsContext::setClientSession(this->native_handle());
+        }
         Base::async_handshake(roleToImpl(Base::getRole()), callback);
     }
 
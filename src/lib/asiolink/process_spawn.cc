@@ -6,24 +6,26 @@
 
 #include <config.h>
 
-#include <asiolink/io_service_signal.h>
 #include <asiolink/process_spawn.h>
 #include <exceptions/exceptions.h>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <set>
 #include <signal.h>
+#include <spawn.h>
 #include <stdlib.h>
+#include <thread>
 #include <errno.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 
-#include <boost/make_shared.hpp>
-
 using namespace std;
-namespace ph = std::placeholders;
 
 namespace isc {
 namespace asiolink {
@@ -59,13 +61,13 @@ typedef std::map<const ProcessSpawnImpl*, ProcessStates> ProcessCollection;
 ///
 /// This pimpl idiom is used by the @c ProcessSpawn in this case to
 /// avoid exposing the internals of the implementation, such as
-/// custom handling of a SIGCHLD signal, and the conversion of the
-/// arguments of the executable from the STL container to the array.
+/// the thread collecting the child processes, and the conversion of
+/// the arguments of the executable from the STL container to the array.
 ///
 /// This class is made noncopyable so that we don't have attempts
 /// to make multiple copies of an object.  This avoid problems
 /// with multiple copies of objects for a single global resource
-/// such as the SIGCHLD signal handler. In addition making it
+/// such as the reaper thread. In addition making it
 /// noncopyable keeps the static check code from flagging the
 /// lack of a copy constructor as an issue.
 class ProcessSpawnImpl : boost::noncopyable {
@@ -73,16 +75,17 @@ public:
 
     /// @brief Constructor.
     ///
-    /// @param io_service The IOService which handles signal handlers.
     /// @param executable A full path to the program to be executed.
     /// @param args Arguments for the program to be executed.
     /// @param vars Environment variables for the program to be executed.
-    ProcessSpawnImpl(IOServicePtr io_service,
-                     const std::string& executable,
+    ProcessSpawnImpl(const std::string& executable,
                      const ProcessArgs& args,
                      const ProcessEnvVars& vars);
 
     /// @brief Destructor.
+    ///
+    /// The reaper thread is stopped and joined when the last instance
+    /// is destroyed.
     ~ProcessSpawnImpl();
 
     /// @brief Returns full command line, including arguments, for the process.
@@ -90,19 +93,17 @@ public:
 
     /// @brief Spawn the new process.
     ///
-    /// This method forks the current process and executes the specified
-    /// binary with arguments within the child process.
-    ///
-    /// The child process will return EXIT_FAILURE if the method was unable
-    /// to start the executable, e.g. as a result of insufficient permissions
-    /// or when the executable does not exist. If the process ends successfully
-    /// the EXIT_SUCCESS is returned.
+    /// This method creates a child process which executes the specified
+    /// binary with arguments.
     ///
     /// @param dismiss The flag which indicated if the process status can be
     /// disregarded.
+    /// @param input_fd The descriptor used as the standard input of the
+    /// child process or -1 to inherit the standard input.
     /// @return PID of the spawned process.
-    /// @throw ProcessSpawnError if forking a current process failed.
-    pid_t spawn(bool dismiss);
+    /// @throw ProcessSpawnError if the process could not be created or the
+    /// executable could not be started.
+    pid_t spawn(bool dismiss, int input_fd);
 
     /// @brief Checks if the process is still running.
     ///
@@ -136,52 +137,12 @@ public:
 
 private:
 
-    /// @brief Initializer class for the SIGCHLD signal handler.
-    ///
-    /// This is a singleton class used to initialize the SIGCHLD signal handler
-    /// only on the first call of @ref initIOSignalSet which happens on each
-    /// call of @ref ProcessSpawn::spawn.
-    class IOSignalSetInitializer {
-    private:
-
-        /// @brief Constructor
-        ///
-        /// @param io_service The IOService which handles signal handlers.
-        IOSignalSetInitializer(IOServicePtr io_service) {
-            if (!io_service) {
-                isc_throw(ProcessSpawnError, "NULL IOService instance");
-            }
-            io_signal_set_ = boost::make_shared<IOSignalSet>(io_service,
-                    std::bind(&ProcessSpawnImpl::waitForProcess, ph::_1));
-            io_signal_set_->add(SIGCHLD);
-        }
-
-        /// @brief Destructor
-        ~IOSignalSetInitializer() {
-            io_signal_set_->remove(SIGCHLD);
-        }
-
-    public:
-
-        /// @brief Initialize the SIGCHLD signal handler.
-        ///
-        /// It creates the single instance of @ref IOSignalSetInitializer.
-        ///
-        /// @param io_service The IOService which handles signal handlers.
-        static void initIOSignalSet(IOServicePtr io_service);
-
-    private:
-
-        /// @brief ASIO signal set.
-        IOSignalSetPtr io_signal_set_;
-    };
-
     /// @brief Copies the argument specified as a C++ string to the new
     /// C string.
     ///
     /// This method is used to convert arguments specified as an STL container
     /// holding @c std::string objects to an array of C strings, used by the
-    /// @c execve function in the @c ProcessSpawnImpl::spawn. It allocates a
+    /// @c posix_spawn function in the @c ProcessSpawnImpl::spawn. It allocates a
     /// new C string and copies the contents of the @c src to it.
     /// The data is stored in an internal container so that the caller of the
     /// function can be exception safe.
@@ -191,14 +152,42 @@ private:
     /// @return Allocated C string holding the data from @c src.
     char* allocateInternal(const std::string& src);
 
-    /// @brief Signal handler for SIGCHLD.
+    /// @brief Starts the reaper thread if it is not running yet.
+    ///
+    /// Must be called with the mutex held.
+    static void startReaper();
+
+    /// @brief The reaper thread body.
+    ///
+    /// The thread periodically collects the exited child processes
+    /// spawned by this class and records their exit status, so the exited
+    /// processes do not stay zombies and no IOService has to handle the
+    /// SIGCHLD signal. It sleeps until the next spawn when there is no
+    /// child process to wait for.
+    ///
+    /// @param generation The generation of the thread: the thread exits
+    /// when the reaper generation changes.
+    static void reap(uint64_t generation);
+
+    /// @brief Collects the exited child processes spawned by this class.
+    ///
+    /// Only the processes spawned by this class are waited for, by pid,
+    /// so the children of other owners, e.g. the system function, are
+    /// left to them.
+    ///
+    /// Must be called with the mutex held.
+    ///
+    /// @return true if some child processes are still running.
+    static bool collect();
+
+    /// @brief Collects the exit status of a child process which has exited
+    /// but was not collected by the reaper thread yet.
     ///
-    /// This handler waits for the child process to finish and retrieves
-    /// its exit code into the @c status_ member.
+    /// Must be called with the mutex held.
     ///
-    /// @return true if the processed signal was SIGCHLD or false if it
-    /// was a different signal.
-    static bool waitForProcess(int signum);
+    /// @param pid ID of the child process.
+    /// @param state The state of the child process.
+    static void updateState(pid_t pid, ProcessState& state);
 
     /// @brief A map holding the status codes of executed processes.
     static ProcessCollection process_collection_;
@@ -224,23 +213,48 @@ private:
     /// @brief Mutex to protect internal state.
     static std::mutex mutex_;
 
-    /// @brief The IOService which handles IO operations.
-    IOServicePtr io_service_;
+    /// @brief Returns the condition signaled when a process is spawned or
+    /// the reaper thread must stop.
+    ///
+    /// The condition is never destroyed: an instance may be destroyed
+    /// while the current process exits.
+    static std::condition_variable& reaperCondition() {
+        static std::condition_variable* condition = new std::condition_variable();
+        return (*condition);
+    }
+
+    /// @brief The running processes whose status is disregarded.
+    static std::set<pid_t> dismissed_;
+
+    /// @brief The number of instances of this class.
+    static size_t instance_count_;
+
+    /// @brief The reaper thread, null when it is not running.
+    ///
+    /// The thread object is not destroyed with the static variables: a
+    /// thread still running when the current process exits is not joined.
+    static std::thread* reaper_;
+
+    /// @brief The generation of the reaper thread, incremented to stop it.
+    static uint64_t reaper_generation_;
 };
 
+/// @brief The interval between two collections of the exited child
+/// processes, in milliseconds.
+const long REAP_INTERVAL = 100;
+
 ProcessCollection ProcessSpawnImpl::process_collection_;
 std::mutex ProcessSpawnImpl::mutex_;
+std::set<pid_t> ProcessSpawnImpl::dismissed_;
+size_t ProcessSpawnImpl::instance_count_ = 0;
+std::thread* ProcessSpawnImpl::reaper_ = 0;
+uint64_t ProcessSpawnImpl::reaper_generation_ = 0;
 
-void ProcessSpawnImpl::IOSignalSetInitializer::initIOSignalSet(IOServicePtr io_service) {
-    static IOSignalSetInitializer init(io_service);
-}
-
-ProcessSpawnImpl::ProcessSpawnImpl(IOServicePtr io_service,
-                                   const std::string& executable,
+ProcessSpawnImpl::ProcessSpawnImpl(const std::string& executable,
                                    const ProcessArgs& args,
                                    const ProcessEnvVars& vars)
     : executable_(executable), args_(new char*[args.size() + 2]),
-      vars_(new char*[vars.size() + 1]), store_(false), io_service_(io_service) {
+      vars_(new char*[vars.size() + 1]), store_(false) {
 
     struct stat st;
 
@@ -267,12 +281,36 @@ ProcessSpawnImpl::ProcessSpawnImpl(IOServicePtr io_service,
     for (int i = 0; i < vars.size(); ++i) {
         vars_[i] = allocateInternal(vars[i]);
     }
+    lock_guard<std::mutex> lk(mutex_);
+    ++instance_count_;
 }
 
 ProcessSpawnImpl::~ProcessSpawnImpl() {
-    if (store_) {
+    std::unique_ptr<std::thread> reaper;
+    {
         lock_guard<std::mutex> lk(mutex_);
-        process_collection_.erase(this);
+        if (store_) {
+            // The processes still running are collected with the
+            // dismissed processes.
+            for (auto const& proc : process_collection_[this]) {
+                if (proc.second->running_) {
+                    static_cast<void>(dismissed_.insert(proc.first));
+                }
+            }
+            process_collection_.erase(this);
+        }
+        if (--instance_count_ == 0) {
+            // Stop the reaper thread. The processes still running are
+            // collected by the next one.
+            static_cast<void>(collect());
+            ++reaper_generation_;
+            reaper.reset(reaper_);
+            reaper_ = 0;
+        }
+    }
+    if (reaper) {
+        reaperCondition().notify_all();
+        reaper->join();
     }
 }
 
@@ -292,31 +330,44 @@ ProcessSpawnImpl::getCommandLine() const {
 }
 
 pid_t
-ProcessSpawnImpl::spawn(bool dismiss) {
+ProcessSpawnImpl::spawn(bool dismiss, int input_fd) {
     lock_guard<std::mutex> lk(mutex_);
-    ProcessSpawnImpl::IOSignalSetInitializer::initIOSignalSet(io_service_);
-    // Create the child
-    pid_t pid = fork();
-    if (pid < 0) {
-        isc_throw(ProcessSpawnError, "unable to fork current process");
-
-    } else if (pid == 0) {
-        // Reset masked signals for the child process.
-        sigset_t sset;
-        sigemptyset(&sset);
-        pthread_sigmask(SIG_SETMASK, &sset, 0);
-        // Run the executable.
-        execve(executable_.c_str(), args_.get(), vars_.get());
-        // We may end up here if the execve failed, e.g. as a result
-        // of issue with permissions or invalid executable name.
-        _exit(EXIT_FAILURE);
+    startReaper();
+    // Create the child with posix_spawn rather than fork: the child does
+    // not duplicate the page tables of the server, which is expensive
+    // for a large multi-threaded process and done for each hook call.
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawnattr_init(&attr);
+    // Reset masked signals for the child process.
+    sigset_t sset;
+    sigemptyset(&sset);
+    posix_spawnattr_setsigmask(&attr, &sset);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+    if ((input_fd >= 0) && (input_fd != STDIN_FILENO)) {
+        posix_spawn_file_actions_adddup2(&actions, input_fd, STDIN_FILENO);
+    }
+    pid_t pid = 0;
+    int ret = posix_spawn(&pid, executable_.c_str(), &actions, &attr,
+                          args_.get(), vars_.get());
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    if (ret != 0) {
+        // E.g. the process limit was reached or the executable format
+        // is not recognized.
+        isc_throw(ProcessSpawnError, "unable to spawn " << executable_
+                  << ": " << strerror(ret));
     }
 
     // We're in the parent process.
     if (!dismiss) {
         store_ = true;
         process_collection_[this].insert(std::pair<pid_t, ProcessStatePtr>(pid, ProcessStatePtr(new ProcessState())));
+    } else {
+        static_cast<void>(dismissed_.insert(pid));
     }
+    reaperCondition().notify_all();
     return (pid);
 }
 
@@ -330,6 +381,7 @@ ProcessSpawnImpl::isRunning(const pid_t pid) const {
                   << "' hasn't been spawned and it status cannot be"
                   " returned");
     }
+    updateState(pid, *proc->second);
     return (proc->second->running_);
 }
 
@@ -338,6 +390,7 @@ ProcessSpawnImpl::isAnyRunning() const {
     lock_guard<std::mutex> lk(mutex_);
     if (process_collection_.find(this) != process_collection_.end()) {
         for (auto const& proc : process_collection_[this]) {
+            updateState(proc.first, *proc.second);
             if (proc.second->running_) {
                 return (true);
             }
@@ -356,6 +409,7 @@ ProcessSpawnImpl::getExitStatus(const pid_t pid) const {
                   << "' hasn't been spawned and it status cannot be"
                   " returned");
     }
+    updateState(pid, *proc->second);
     return (WEXITSTATUS(proc->second->status_));
 }
 
@@ -372,27 +426,60 @@ ProcessSpawnImpl::allocateInternal(const std::string& src) {
     return (dest);
 }
 
+void
+ProcessSpawnImpl::startReaper() {
+    if (!reaper_) {
+        reaper_ = new std::thread(&ProcessSpawnImpl::reap, reaper_generation_);
+    }
+}
+
+void
+ProcessSpawnImpl::reap(uint64_t generation) {
+    unique_lock<std::mutex> lk(mutex_);
+    while (generation == reaper_generation_) {
+        if (collect()) {
+            static_cast<void>(reaperCondition().wait_for(lk,
+                chrono::milliseconds(REAP_INTERVAL)));
+        } else {
+            reaperCondition().wait(lk);
+        }
+    }
+}
+
 bool
-ProcessSpawnImpl::waitForProcess(int) {
-    lock_guard<std::mutex> lk(mutex_);
-    for (;;) {
+ProcessSpawnImpl::collect() {
+    bool running = false;
+    for (auto pid = dismissed_.begin(); pid != dismissed_.end(); ) {
         int status = 0;
-        pid_t pid = waitpid(-1, &status, WNOHANG);
-        if (pid <= 0) {
-            break;
+        pid_t ret = waitpid(*pid, &status, WNOHANG);
+        if ((ret == *pid) || ((ret < 0) && (errno == ECHILD))) {
+            pid = dismissed_.erase(pid);
+        } else {
+            running = true;
+            ++pid;
         }
-        for (auto const& instance : process_collection_) {
-            auto const& proc = instance.second.find(pid);
-            /// Check that the terminating process was started
-            /// by our instance of ProcessSpawn
-            if (proc != instance.second.end()) {
-                // In this order please
-                proc->second->status_ = status;
-                proc->second->running_ = false;
+    }
+    for (auto const& instance : process_collection_) {
+        for (auto const& proc : instance.second) {
+            updateState(proc.first, *proc.second);
+            if (proc.second->running_) {
+                running = true;
             }
         }
     }
-    return (true);
+    return (running);
+}
+
+void
+ProcessSpawnImpl::updateState(pid_t pid, ProcessState& state) {
+    if (!state.running_) {
+        return;
+    }
+    int status = 0;
+    if (waitpid(pid, &status, WNOHANG) == pid) {
+        state.status_ = status;
+        state.running_ = false;
+    }
 }
 
 void
@@ -407,11 +494,10 @@ ProcessSpawnImpl::clearState(const pid_t pid) {
     }
 }
 
-ProcessSpawn::ProcessSpawn(IOServicePtr io_service,
-                           const std::string& executable,
+ProcessSpawn::ProcessSpawn(const std::string& executable,
                            const ProcessArgs& args,
                            const ProcessEnvVars& vars)
-    : impl_(new ProcessSpawnImpl(io_service, executable, args, vars)) {
+    : impl_(new ProcessSpawnImpl(executable, args, vars)) {
 }
 
 std::string
@@ -420,8 +506,8 @@ ProcessSpawn::getCommandLine() const {
 }
 
 pid_t
-ProcessSpawn::spawn(bool dismiss) {
-    return (impl_->spawn(dismiss));
+ProcessSpawn::spawn(bool dismiss, int input_fd) {
+    return (impl_->spawn(dismiss, input_fd));
 }
 
 bool
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,7 +7,6 @@
 #ifndef PROCESS_SPAWN_H
 #define PROCESS_SPAWN_H
 
-#include <asiolink/io_service.h>
 #include <exceptions/exceptions.h>
 #include <boost/noncopyable.hpp>
 #include <string>
@@ -42,18 +41,19 @@ typedef std::vector<std::string> ProcessEnvVars;
 
 /// @brief Utility class for spawning new processes.
 ///
-/// This class is used to spawn new process by Kea. It forks the current
-/// process and then uses the @c execve function to execute the specified
-/// binary with parameters. The @c ProcessSpawn installs the handler for
-/// the SIGCHLD signal, which is executed when the child process ends.
-/// The handler checks the exit code returned by the process and records
-/// it. The exit code can be retrieved by the caller using the
-/// @c ProcessSpawn::getExitStatus method.
+/// This class is used to spawn new process by Kea. It uses the
+/// @c posix_spawn function to execute the specified binary with
+/// parameters in a new process. A dedicated thread, started with the
+/// first process, periodically collects the child processes which have
+/// ended and records their exit code, so the main IOService does not have
+/// to handle the SIGCHLD signal. The thread is stopped and joined when
+/// the last @c ProcessSpawn object is destroyed. The exit code can be
+/// retrieved by the caller using the @c ProcessSpawn::getExitStatus method.
 ///
 /// This class is made noncopyable so that we don't have attempts
 /// to make multiple copies of an object.  This avoid problems
 /// with multiple copies of objects for a single global resource
-/// such as the SIGCHLD signal handler. In addition making it
+/// such as the reaper thread. In addition making it
 /// noncopyable keeps the static check code from flagging the
 /// lack of a copy constructor as an issue.
 ///
@@ -63,12 +63,10 @@ public:
 
     /// @brief Constructor.
     ///
-    /// @param io_service The IOService which handles signal handlers.
     /// @param executable A full path to the program to be executed.
     /// @param args Arguments for the program to be executed.
     /// @param vars Environment variables for the program to be executed.
-    ProcessSpawn(isc::asiolink::IOServicePtr io_service,
-                 const std::string& executable,
+    ProcessSpawn(const std::string& executable,
                  const ProcessArgs& args = ProcessArgs(),
                  const ProcessEnvVars& vars = ProcessEnvVars());
 
@@ -80,18 +78,20 @@ public:
 
     /// @brief Spawn the new process.
     ///
-    /// This method forks the current process and executes the specified
-    /// binary with arguments within the child process.
-    ///
-    /// The child process will return EXIT_FAILURE if the method was unable
-    /// to start the executable, e.g. as a result of insufficient permissions
-    /// or when the executable does not exist. If the process ends successfully
-    /// the EXIT_SUCCESS is returned.
+    /// This method creates a child process which executes the specified
+    /// binary with arguments. The child is created with @c posix_spawn
+    /// which does not copy the address space of the current process.
     ///
     /// @param dismiss The flag which indicated if the process status can be
     /// disregarded.
-    /// @throw ProcessSpawnError if forking a current process failed.
-    pid_t spawn(bool dismiss = false);
+    /// @param input_fd The descriptor used as the standard input of the
+    /// child process, e.g. the read end of a pipe, or -1 to inherit the
+    /// standard input of the current process.
+    /// @return PID of the spawned process.
+    /// @throw ProcessSpawnError if the process could not be created or the
+    /// executable could not be started, e.g. as a result of insufficient
+    /// permissions.
+    pid_t spawn(bool dismiss = false, int input_fd = -1);
 
     /// @brief Checks if the process is still running.
     ///
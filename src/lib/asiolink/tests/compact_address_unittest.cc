@@ -0,0 +1,86 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/compact_address.h>
+#include <gtest/gtest.h>
+#include <boost/functional/hash.hpp>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace isc::asiolink;
+
+namespace {
+
+// Checks that the addresses are converted back and forth.
+TEST(CompactAddressTest, conversions) {
+    std::vector<std::string> addresses = {
+        "0.0.0.0", "192.0.2.1", "255.255.255.255",
+        "::", "2001:db8::1", "2001:db8:1:2:3:4:5:6", "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff"
+    };
+    for (auto const& text : addresses) {
+        IOAddress address(text);
+        CompactAddress compact(address);
+        EXPECT_EQ(address.isV4(), compact.isV4()) << text;
+        EXPECT_EQ(address.isV6(), compact.isV6()) << text;
+        EXPECT_EQ(address, compact.toIOAddress()) << text;
+    }
+}
+
+// Checks that the default constructor creates the IPv4 zero address.
+TEST(CompactAddressTest, defaultConstructor) {
+    constexpr CompactAddress compact;
+    static_assert(compact.isV4(), "default compact address is not IPv4");
+    EXPECT_TRUE(compact.toIOAddress().isV4Zero());
+    EXPECT_TRUE(compact == CompactAddress(IOAddress::IPV4_ZERO_ADDRESS()));
+    EXPECT_TRUE(compact != CompactAddress(IOAddress::IPV6_ZERO_ADDRESS()));
+}
+
+// Checks that the addresses are ordered as the IOAddress objects.
+TEST(CompactAddressTest, comparisons) {
+    std::vector<std::string> addresses = {
+        "0.0.0.0", "0.0.0.1", "192.0.2.1", "192.0.3.0", "255.255.255.255",
+        "::", "::1", "::1:0:0:0:0", "2001:db8::1", "2001:db8::1:0", "ffff::"
+    };
+    for (auto const& left : addresses) {
+        for (auto const& right : addresses) {
+            IOAddress left_address(left);
+            IOAddress right_address(right);
+            CompactAddress left_compact(left_address);
+            CompactAddress right_compact(right_address);
+            EXPECT_EQ(left_address == right_address, left_compact == right_compact)
+                << left << " == " << right;
+            EXPECT_EQ(left_address != right_address, left_compact != right_compact)
+                << left << " != " << right;
+            EXPECT_EQ(left_address < right_address, left_compact < right_compact)
+                << left << " < " << right;
+            EXPECT_EQ(left_address <= right_address, left_compact <= right_compact)
+                << left << " <= " << right;
+        }
+    }
+}
+
+// Checks that the addresses can be held in the hashed containers.
+TEST(CompactAddressTest, hash) {
+    std::unordered_set<CompactAddress, CompactAddress::Hash> set;
+    std::unordered_set<CompactAddress, boost::hash<CompactAddress>> boost_set;
+    for (auto const& text : { "0.0.0.1", "::1", "192.0.2.1", "::c000:201", "2001:db8::1" }) {
+        EXPECT_TRUE(set.insert(CompactAddress(IOAddress(text))).second) << text;
+        EXPECT_TRUE(boost_set.insert(CompactAddress(IOAddress(text))).second) << text;
+    }
+    EXPECT_EQ(5, set.size());
+    EXPECT_EQ(5, boost_set.size());
+    EXPECT_EQ(1, set.count(CompactAddress(IOAddress("::c000:201"))));
+    EXPECT_EQ(0, set.count(CompactAddress(IOAddress("192.0.2.2"))));
+}
+
+// Checks that the compact address is smaller than the IOAddress.
+TEST(CompactAddressTest, size) {
+    EXPECT_LE(sizeof(CompactAddress), 24);
+}
+
+} // end of anonymous namespace
@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include <errno.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 #include <testutils/gtest_utils.h>
@@ -108,7 +109,7 @@ TEST_F(ProcessSpawnTest, spawnWithArgs) {
     args.push_back("-e");
     args.push_back("64");
 
-    ProcessSpawn process(io_service_, TEST_SCRIPT_SH, args);
+    ProcessSpawn process(TEST_SCRIPT_SH, args);
     pid_t pid = 0;
     ASSERT_NO_THROW(pid = process.spawn());
 
@@ -141,7 +142,7 @@ TEST_F(ProcessSpawnTest, spawnWithArgsAndEnvVars) {
     args.push_back("TEST_VARIABLE_VALUE");
     vars.push_back("TEST_VARIABLE_NAME=TEST_VARIABLE_VALUE");
 
-    ProcessSpawn process(io_service_, TEST_SCRIPT_SH, args, vars);
+    ProcessSpawn process(TEST_SCRIPT_SH, args, vars);
     pid_t pid = 0;
     ASSERT_NO_THROW(pid = process.spawn());
 
@@ -172,7 +173,7 @@ TEST_F(ProcessSpawnTest, spawnTwoProcesses) {
     vector<string> args;
     args.push_back("-p");
 
-    ProcessSpawn process(io_service_, TEST_SCRIPT_SH, args);
+    ProcessSpawn process(TEST_SCRIPT_SH, args);
     pid_t pid1 = 0;
     ASSERT_NO_THROW(pid1 = process.spawn());
 
@@ -225,7 +226,7 @@ TEST_F(ProcessSpawnTest, spawnTwoProcesses) {
 // This test verifies that the external application can be ran without
 // arguments and that the exit code is gathered.
 TEST_F(ProcessSpawnTest, spawnNoArgs) {
-    ProcessSpawn process(io_service_, TEST_SCRIPT_SH);
+    ProcessSpawn process(TEST_SCRIPT_SH);
     pid_t pid = 0;
     ASSERT_NO_THROW(pid = process.spawn());
 
@@ -269,18 +270,105 @@ TEST_F(ProcessSpawnTest, spawnNoArgs) {
     EXPECT_THROW(process.getExitStatus(pid), InvalidOperation);
 }
 
+// This test verifies that the standard input of the application can be
+// redirected.
+TEST_F(ProcessSpawnTest, spawnWithInput) {
+    vector<string> args;
+    args.push_back("-i");
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    ASSERT_EQ(3, write(fds[1], "48\n", 3));
+    close(fds[1]);
+
+    ProcessSpawn process(TEST_SCRIPT_SH, args);
+    pid_t pid = 0;
+    ASSERT_NO_THROW(pid = process.spawn(false, fds[0]));
+    close(fds[0]);
+
+    // Set test fail safe.
+    setTestTime(1000);
+
+    // The next handler executed is IOSignal's handler.
+    io_service_->run_one();
+
+    // The first handler executed is the IOSignal's internal timer expire
+    // callback.
+    io_service_->run_one();
+
+    // Polling once to be sure.
+    io_service_->poll();
+
+    ASSERT_EQ(1, processed_signals_.size());
+    ASSERT_EQ(SIGCHLD, processed_signals_[0]);
+
+    EXPECT_EQ(48, process.getExitStatus(pid));
+}
+
+// This test verifies that the exit code is gathered without running the
+// IOService.
+TEST_F(ProcessSpawnTest, spawnWithoutIOService) {
+    vector<string> args;
+    args.push_back("-e");
+    args.push_back("16");
+
+    ProcessSpawn process(TEST_SCRIPT_SH, args);
+    pid_t pid = 0;
+    ASSERT_NO_THROW(pid = process.spawn());
+
+    time_t start = time(0);
+    while (process.isRunning(pid)) {
+        ASSERT_LT(time(0), start + 3) << "timeout";
+        usleep(1000);
+    }
+    EXPECT_EQ(16, process.getExitStatus(pid));
+}
+
+// This test verifies that a dismissed process is collected and that a
+// child process not spawned by ProcessSpawn is left to its owner.
+TEST_F(ProcessSpawnTest, foreignChild) {
+    // Fork a child process which exits immediately.
+    pid_t foreign = fork();
+    ASSERT_GE(foreign, 0);
+    if (foreign == 0) {
+        _exit(5);
+    }
+
+    vector<string> args;
+    args.push_back("-e");
+    args.push_back("0");
+
+    ProcessSpawn process(TEST_SCRIPT_SH, args);
+    pid_t pid = 0;
+    ASSERT_NO_THROW(pid = process.spawn(true));
+
+    // The dismissed process is collected: it does not stay a zombie.
+    time_t start = time(0);
+    while (kill(pid, 0) == 0) {
+        ASSERT_LT(time(0), start + 3) << "timeout";
+        usleep(1000);
+    }
+    EXPECT_EQ(ESRCH, errno);
+
+    // The foreign child process can still be collected by its owner.
+    int status = 0;
+    ASSERT_EQ(foreign, waitpid(foreign, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(5, WEXITSTATUS(status));
+}
+
 // This test verifies that the EXIT_FAILURE code is returned when
 // application can't be executed.
 TEST_F(ProcessSpawnTest, invalidExecutable) {
     std::string expected = "File not found: foo";
-    ASSERT_THROW_MSG(ProcessSpawn process(io_service_, "foo"),
+    ASSERT_THROW_MSG(ProcessSpawn process("foo"),
                      ProcessSpawnError, expected);
 
     std::string name = INVALID_TEST_SCRIPT_SH;
 
     expected = "File not executable: ";
     expected += name;
-    ASSERT_THROW_MSG(ProcessSpawn process(io_service_, name),
+    ASSERT_THROW_MSG(ProcessSpawn process(name),
                      ProcessSpawnError, expected);
 }
 
@@ -299,7 +387,7 @@ TEST_F(ProcessSpawnTest, getCommandLine) {
         args.push_back("-y");
         args.push_back("foo");
         args.push_back("bar");
-        ProcessSpawn process(io_service_, TEST_SCRIPT_SH, args);
+        ProcessSpawn process(TEST_SCRIPT_SH, args);
         std::string expected = TEST_SCRIPT_SH;
         expected += " -x -y foo bar";
         EXPECT_EQ(expected, process.getCommandLine());
@@ -307,7 +395,7 @@ TEST_F(ProcessSpawnTest, getCommandLine) {
 
     {
         // Case 2: no arguments.
-        ProcessSpawn process(io_service_, TEST_SCRIPT_SH);
+        ProcessSpawn process(TEST_SCRIPT_SH);
         EXPECT_EQ(TEST_SCRIPT_SH, process.getCommandLine());
     }
 }
@@ -321,7 +409,7 @@ TEST_F(ProcessSpawnTest, isRunning) {
     args.push_back("-s");
     args.push_back("10");
 
-    ProcessSpawn process(io_service_, TEST_SCRIPT_SH, args);
+    ProcessSpawn process(TEST_SCRIPT_SH, args);
     pid_t pid = 0;
     ASSERT_NO_THROW(pid = process.spawn());
 
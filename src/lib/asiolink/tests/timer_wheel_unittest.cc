@@ -0,0 +1,196 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/interval_timer.h>
+#include <asiolink/io_service.h>
+#include <asiolink/timer_wheel.h>
+#include <exceptions/exceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace std;
+
+namespace {
+
+/// @brief Test fixture for the timing wheel.
+///
+/// The wheel is driven by the clock given to advance: the IO service is
+/// not run unless a test does it.
+class TimerWheelTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    TimerWheelTest() : io_service_(new IOService()), fired_() {
+    }
+
+    /// @brief Returns a callback recording its value when it is run.
+    ///
+    /// @param value The value.
+    TimerWheel::Callback record(int value) {
+        return ([this, value]() { fired_.push_back(value); });
+    }
+
+    /// @brief Returns the time after the given number of milliseconds.
+    ///
+    /// @param start The start time.
+    /// @param ms The number of milliseconds.
+    static TimerWheel::Clock::time_point
+    after(const TimerWheel::Clock::time_point& start, long ms) {
+        return (start + chrono::milliseconds(ms));
+    }
+
+    /// @brief The IO service.
+    IOServicePtr io_service_;
+
+    /// @brief The values of the run callbacks.
+    vector<int> fired_;
+};
+
+// Checks the constructor parameters.
+TEST_F(TimerWheelTest, constructor) {
+    EXPECT_THROW(TimerWheel(io_service_, 0), BadValue);
+    EXPECT_THROW(TimerWheel(io_service_, 100, 0), BadValue);
+
+    TimerWheel wheel(io_service_);
+    EXPECT_EQ(TimerWheel::DEFAULT_TICK, wheel.getTick());
+    EXPECT_EQ(TimerWheel::DEFAULT_SLOTS, wheel.getSlots());
+    EXPECT_EQ(0, wheel.size());
+
+    EXPECT_THROW(wheel.schedule(-1, record(1)), BadValue);
+    EXPECT_THROW(wheel.schedule(100, TimerWheel::Callback()), BadValue);
+}
+
+// Checks that the timers run when they expire, never before.
+TEST_F(TimerWheelTest, expire) {
+    TimerWheel wheel(io_service_, 100, 16);
+    auto start = TimerWheel::Clock::now();
+    TimerWheel::TimerId id1 = wheel.schedule(250, record(1));
+    TimerWheel::TimerId id2 = wheel.schedule(450, record(2));
+    EXPECT_NE(0, id1);
+    EXPECT_NE(0, id2);
+    EXPECT_NE(id1, id2);
+    EXPECT_EQ(2, wheel.size());
+
+    EXPECT_EQ(0, wheel.advance(after(start, 200)));
+    EXPECT_TRUE(fired_.empty());
+
+    EXPECT_EQ(1, wheel.advance(after(start, 400)));
+    ASSERT_EQ(1, fired_.size());
+    EXPECT_EQ(1, fired_[0]);
+    EXPECT_EQ(1, wheel.size());
+
+    // Going back in time does nothing.
+    EXPECT_EQ(0, wheel.advance(after(start, 300)));
+
+    EXPECT_EQ(1, wheel.advance(after(start, 600)));
+    ASSERT_EQ(2, fired_.size());
+    EXPECT_EQ(2, fired_[1]);
+    EXPECT_EQ(0, wheel.size());
+
+    // A run timer can't be cancelled.
+    EXPECT_FALSE(wheel.cancel(id1));
+}
+
+// Checks that cancelled timers do not run.
+TEST_F(TimerWheelTest, cancel) {
+    TimerWheel wheel(io_service_, 100, 16);
+    auto start = TimerWheel::Clock::now();
+    TimerWheel::TimerId id1 = wheel.schedule(250, record(1));
+    wheel.schedule(250, record(2));
+    EXPECT_TRUE(wheel.cancel(id1));
+    EXPECT_FALSE(wheel.cancel(id1));
+    EXPECT_FALSE(wheel.cancel(0));
+    EXPECT_EQ(1, wheel.size());
+
+    EXPECT_EQ(1, wheel.advance(after(start, 400)));
+    ASSERT_EQ(1, fired_.size());
+    EXPECT_EQ(2, fired_[0]);
+
+    wheel.schedule(250, record(3));
+    wheel.schedule(350, record(4));
+    wheel.clear();
+    EXPECT_EQ(0, wheel.size());
+    EXPECT_EQ(0, wheel.advance(after(start, 1000)));
+    EXPECT_EQ(1, fired_.size());
+}
+
+// Checks the timers expiring after more than one wheel revolution.
+TEST_F(TimerWheelTest, rounds) {
+    TimerWheel wheel(io_service_, 100, 4);
+    auto start = TimerWheel::Clock::now();
+    // Both timers are in the same slot.
+    wheel.schedule(150, record(1));
+    wheel.schedule(1350, record(2));
+
+    EXPECT_EQ(1, wheel.advance(after(start, 250)));
+    EXPECT_EQ(0, wheel.advance(after(start, 650)));
+    EXPECT_EQ(0, wheel.advance(after(start, 1050)));
+    EXPECT_EQ(1, wheel.size());
+    EXPECT_EQ(1, wheel.advance(after(start, 1450)));
+    ASSERT_EQ(2, fired_.size());
+    EXPECT_EQ(1, fired_[0]);
+    EXPECT_EQ(2, fired_[1]);
+}
+
+// Checks that all the expired timers run after a long delay.
+TEST_F(TimerWheelTest, lateAdvance) {
+    TimerWheel wheel(io_service_, 10, 8);
+    auto start = TimerWheel::Clock::now();
+    for (int i = 0; i < 1000; ++i) {
+        wheel.schedule(i, record(i));
+    }
+    wheel.schedule(60000, record(-1));
+    EXPECT_EQ(1000, wheel.advance(after(start, 20000)));
+    EXPECT_EQ(1000, fired_.size());
+    EXPECT_EQ(1, wheel.size());
+}
+
+// Checks that the callbacks can schedule timers and that an exception
+// does not prevent the other timers from running.
+TEST_F(TimerWheelTest, callbacks) {
+    TimerWheel wheel(io_service_, 100, 16);
+    auto start = TimerWheel::Clock::now();
+    wheel.schedule(50, []() { isc_throw(Unexpected, "callback error"); });
+    wheel.schedule(50, [this, &wheel]() {
+        fired_.push_back(1);
+        wheel.schedule(0, record(2));
+    });
+
+    EXPECT_EQ(2, wheel.advance(after(start, 150)));
+    ASSERT_EQ(1, fired_.size());
+    EXPECT_EQ(1, wheel.size());
+
+    // The new timer expires at the next tick.
+    EXPECT_EQ(1, wheel.advance(after(start, 1000)));
+    ASSERT_EQ(2, fired_.size());
+    EXPECT_EQ(2, fired_[1]);
+}
+
+// Checks that the IO service drives the wheel.
+TEST_F(TimerWheelTest, ioService) {
+    TimerWheel wheel(io_service_, 10);
+    wheel.schedule(30, [this]() {
+        fired_.push_back(1);
+        io_service_->stop();
+    });
+
+    // Do not wait forever if the timer does not run.
+    IntervalTimer guard(*io_service_);
+    guard.setup([this]() { io_service_->stop(); }, 2000,
+                IntervalTimer::ONE_SHOT);
+    io_service_->run();
+    ASSERT_EQ(1, fired_.size());
+    EXPECT_EQ(0, wheel.size());
+}
+
+}
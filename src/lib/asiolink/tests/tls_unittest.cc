@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -2250,6 +2250,122 @@ TEST(TLSTest, trustedSelfSigned) {
 }
 #endif // WITH_OPENSSL
 
+#ifdef WITH_OPENSSL
+/// @brief Connects a client to a server and exchanges one byte.
+///
+/// The byte is sent by the server so the client receives the session
+/// tickets sent after the handshake. The connection is closed without
+/// TLS shutdown.
+///
+/// @param service The IO service.
+/// @param server_ctx The server context.
+/// @param client_ctx The client context.
+/// @param resumed Set to the session reused flag of the client.
+void
+connectAndExchange(IOService& service, TlsContextPtr server_ctx,
+                   TlsContextPtr client_ctx, bool& resumed) {
+    TlsStream<TestCallback> server(service, server_ctx);
+
+    // Accept a client.
+    tcp::endpoint server_ep(tcp::endpoint(address::from_string(SERVER_ADDRESS),
+                                          SERVER_PORT));
+    tcp::acceptor acceptor(service.get_io_service(), server_ep);
+    acceptor.set_option(tcp::acceptor::reuse_address(true));
+    TestCallback accept_cb;
+    acceptor.async_accept(server.lowest_layer(), accept_cb);
+
+    TlsStream<TestCallback> client(service, client_ctx);
+
+    // Connect to.
+    client.lowest_layer().open(tcp::v4());
+    TestCallback connect_cb;
+    client.lowest_layer().async_connect(server_ep, connect_cb);
+
+    // Run accept and connect.
+    while (!accept_cb.getCalled() || !connect_cb.getCalled()) {
+        service.run_one();
+    }
+    ASSERT_FALSE(accept_cb.getCode());
+    // Possible EINPROGRESS for the client.
+    if (connect_cb.getCode() &&
+        (connect_cb.getCode().value() != EINPROGRESS)) {
+        FAIL() << "connect error " << connect_cb.getCode().value()
+               << " '" << connect_cb.getCode().message() << "'";
+    }
+
+    // Setup a timeout.
+    IntervalTimer timer(service);
+    bool timeout = false;
+    timer.setup([&timeout] { timeout = true; }, 100, IntervalTimer::ONE_SHOT);
+
+    // Perform TLS handshakes using the stream handshake method which
+    // sets the client session.
+    TestCallback server_cb;
+    server.handshake(server_cb);
+    TestCallback client_cb;
+    client.handshake(client_cb);
+    while (!timeout && (!server_cb.getCalled() || !client_cb.getCalled())) {
+        service.run_one();
+    }
+    ASSERT_FALSE(timeout);
+    ASSERT_FALSE(server_cb.getCode());
+    ASSERT_FALSE(client_cb.getCode());
+
+    // Exchange one byte.
+    char send_buf[1] = { 'x' };
+    char receive_buf[1] = { 0 };
+    TestCallback write_cb;
+    boost::asio::async_write(server, boost::asio::buffer(send_buf), write_cb);
+    TestCallback read_cb;
+    boost::asio::async_read(client, boost::asio::buffer(receive_buf), read_cb);
+    while (!timeout && (!write_cb.getCalled() || !read_cb.getCalled())) {
+        service.run_one();
+    }
+    timer.cancel();
+    ASSERT_FALSE(timeout);
+    ASSERT_FALSE(read_cb.getCode());
+    EXPECT_EQ('x', receive_buf[0]);
+
+    resumed = (::SSL_session_reused(client.native_handle()) == 1);
+
+    // Close client and server.
+    EXPECT_NO_THROW(client.lowest_layer().close());
+    EXPECT_NO_THROW(server.lowest_layer().close());
+}
+
+// Test that a new connection of a client resumes the session of the
+// previous one.
+TEST(TLSTest, sessionResumption) {
+    IOService service;
+
+    // Server part.
+    TlsContextPtr server_ctx;
+    test::configServer(server_ctx);
+
+    // Client part.
+    TlsContextPtr client_ctx;
+    test::configClient(client_ctx);
+
+    // First connection does a full handshake.
+    bool resumed = true;
+    connectAndExchange(service, server_ctx, client_ctx, resumed);
+    EXPECT_FALSE(resumed);
+    EXPECT_EQ(1, client_ctx->getHandshakeCount());
+    EXPECT_EQ(0, client_ctx->getResumedCount());
+    EXPECT_EQ(1, server_ctx->getHandshakeCount());
+    EXPECT_EQ(0, server_ctx->getResumedCount());
+
+    // Second connection resumes the session.
+    connectAndExchange(service, server_ctx, client_ctx, resumed);
+    EXPECT_TRUE(resumed);
+    EXPECT_EQ(2, client_ctx->getHandshakeCount());
+    EXPECT_EQ(1, client_ctx->getResumedCount());
+    EXPECT_EQ(2, server_ctx->getHandshakeCount());
+    EXPECT_EQ(1, server_ctx->getResumedCount());
+}
+#endif // WITH_OPENSSL
+
+
 ////////////////////////////////////////////////////////////////////////
 //                              TLS shutdown                          //
 ////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,142 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/timer_wheel.h>
+#include <exceptions/exceptions.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace isc {
+namespace asiolink {
+
+const long TimerWheel::DEFAULT_TICK;
+const size_t TimerWheel::DEFAULT_SLOTS;
+
+TimerWheel::TimerWheel(const IOServicePtr& io_service, long tick,
+                       size_t slots)
+    : io_service_(io_service), tick_(tick), start_(Clock::now()),
+      current_(0), last_id_(0), slots_(), timers_(), mutex_(new mutex()),
+      interval_timer_(*io_service) {
+    if (tick_ <= 0) {
+        isc_throw(BadValue, "the timer wheel tick must be positive");
+    }
+    if (slots == 0) {
+        isc_throw(BadValue, "the timer wheel must have at least one slot");
+    }
+    slots_.resize(slots);
+    interval_timer_.setup([this]() { static_cast<void>(advance(Clock::now())); },
+                          tick_, IntervalTimer::REPEATING);
+}
+
+TimerWheel::~TimerWheel() {
+    interval_timer_.cancel();
+    clear();
+}
+
+uint64_t
+TimerWheel::getTicks(const Clock::time_point& now, bool round_up) const {
+    if (now <= start_) {
+        return (0);
+    }
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(now - start_);
+    uint64_t ms = static_cast<uint64_t>(elapsed.count());
+    if (round_up) {
+        ms += tick_ - 1;
+    }
+    return (ms / tick_);
+}
+
+TimerWheel::TimerId
+TimerWheel::schedule(long delay, const Callback& callback) {
+    if (delay < 0) {
+        isc_throw(BadValue, "the timer delay must not be negative");
+    }
+    if (!callback) {
+        isc_throw(BadValue, "the timer callback must not be empty");
+    }
+    Clock::time_point expire = Clock::now() + chrono::milliseconds(delay);
+    lock_guard<mutex> lock(*mutex_);
+    // A timer is never run at the current tick, which may be processed.
+    uint64_t tick = max(getTicks(expire, true), current_ + 1);
+    size_t index = tick % slots_.size();
+    Slot& slot = slots_[index];
+    TimerId id = ++last_id_;
+    slot.push_back(Entry{ id, tick, callback });
+    timers_[id] = Location(index, --slot.end());
+    return (id);
+}
+
+bool
+TimerWheel::cancel(TimerId id) {
+    lock_guard<mutex> lock(*mutex_);
+    auto it = timers_.find(id);
+    if (it == timers_.end()) {
+        return (false);
+    }
+    slots_[it->second.first].erase(it->second.second);
+    timers_.erase(it);
+    return (true);
+}
+
+void
+TimerWheel::clear() {
+    // The callbacks are destroyed outside of the lock.
+    vector<Slot> slots(slots_.size());
+    {
+        lock_guard<mutex> lock(*mutex_);
+        slots_.swap(slots);
+        timers_.clear();
+    }
+}
+
+size_t
+TimerWheel::size() const {
+    lock_guard<mutex> lock(*mutex_);
+    return (timers_.size());
+}
+
+size_t
+TimerWheel::advance(const Clock::time_point& now) {
+    Slot expired;
+    {
+        lock_guard<mutex> lock(*mutex_);
+        uint64_t target = getTicks(now, false);
+        if (target <= current_) {
+            return (0);
+        }
+        // Visit each slot at most once even after a long delay.
+        uint64_t count = min(target - current_,
+                             static_cast<uint64_t>(slots_.size()));
+        for (uint64_t tick = current_ + 1; tick <= current_ + count; ++tick) {
+            Slot& slot = slots_[tick % slots_.size()];
+            for (auto it = slot.begin(); it != slot.end(); ) {
+                auto cur = it++;
+                if (cur->expire_ <= target) {
+                    timers_.erase(cur->id_);
+                    expired.splice(expired.end(), slot, cur);
+                }
+            }
+        }
+        current_ = target;
+    }
+
+    // The callbacks may schedule or cancel timers.
+    for (auto const& entry : expired) {
+        try {
+            entry.callback_();
+        } catch (...) {
+            // Ignore the error so the other timers are run.
+        }
+    }
+    return (expired.size());
+}
+
+} // namespace asiolink
+} // namespace isc
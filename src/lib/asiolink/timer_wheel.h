@@ -0,0 +1,183 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef ASIOLINK_TIMER_WHEEL_H
+#define ASIOLINK_TIMER_WHEEL_H
+
+#include <asiolink/interval_timer.h>
+#include <asiolink/io_service.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <chrono>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <stdint.h>
+
+namespace isc {
+namespace asiolink {
+
+/// @brief Hashed timing wheel for large numbers of short lived timers.
+///
+/// An @c IntervalTimer holds an asio deadline timer and is too expensive
+/// for per lease or per client timers. The timing wheel is an array of
+/// slots, each slot holding the timers expiring at a given tick modulo
+/// the number of slots. Scheduling and cancelling a timer is done in
+/// constant time and one @c IntervalTimer drives the wheel: at each tick
+/// the timers of the current slot which have expired are run.
+///
+/// The expiration is rounded up to the next tick so a timer never runs
+/// early, and it runs at most one tick late when the IO service is not
+/// busy. The timers are one shot: a callback can schedule a new timer.
+///
+/// The timers can be scheduled and cancelled from any thread. The
+/// callbacks are run by the thread running the IO service without any
+/// lock held. They must not throw: the exceptions are caught and
+/// ignored, so they do not prevent the other expired timers from running.
+class TimerWheel : public boost::noncopyable {
+public:
+
+    /// @brief The type of the timer callbacks.
+    typedef std::function<void()> Callback;
+
+    /// @brief The type of the timer identifiers.
+    ///
+    /// The identifiers are never reused: 0 is not a valid identifier.
+    typedef uint64_t TimerId;
+
+    /// @brief The clock used by the wheel.
+    typedef std::chrono::steady_clock Clock;
+
+    /// @brief Default tick in milliseconds.
+    static const long DEFAULT_TICK = 100;
+
+    /// @brief Default number of slots.
+    static const size_t DEFAULT_SLOTS = 1024;
+
+    /// @brief Constructor.
+    ///
+    /// Starts the interval timer driving the wheel.
+    ///
+    /// @param io_service The IO service running the timers.
+    /// @param tick The tick in milliseconds.
+    /// @param slots The number of slots.
+    /// @throw BadValue if the IO service is null, the tick or the number
+    /// of slots is 0.
+    TimerWheel(const IOServicePtr& io_service, long tick = DEFAULT_TICK,
+               size_t slots = DEFAULT_SLOTS);
+
+    /// @brief Destructor.
+    ///
+    /// Cancels all the timers.
+    ~TimerWheel();
+
+    /// @brief Schedules a timer.
+    ///
+    /// @param delay The delay in milliseconds before the callback is run.
+    /// @param callback The callback.
+    /// @return The identifier of the timer.
+    /// @throw BadValue if the delay is negative or the callback empty.
+    TimerId schedule(long delay, const Callback& callback);
+
+    /// @brief Cancels a timer.
+    ///
+    /// @param id The identifier of the timer.
+    /// @return true if the timer was cancelled, false if it is unknown,
+    /// already run or cancelled.
+    bool cancel(TimerId id);
+
+    /// @brief Cancels all the timers.
+    void clear();
+
+    /// @brief Returns the number of scheduled timers.
+    size_t size() const;
+
+    /// @brief Returns the tick in milliseconds.
+    long getTick() const {
+        return (tick_);
+    }
+
+    /// @brief Returns the number of slots.
+    size_t getSlots() const {
+        return (slots_.size());
+    }
+
+    /// @brief Runs the timers which have expired.
+    ///
+    /// Called by the interval timer at each tick. It is public so the
+    /// wheel can be driven by a given clock in the unit tests.
+    ///
+    /// @param now The current time.
+    /// @return The number of run timers.
+    size_t advance(const Clock::time_point& now);
+
+private:
+
+    /// @brief A scheduled timer.
+    struct Entry {
+        /// @brief The identifier.
+        TimerId id_;
+
+        /// @brief The tick when the timer expires.
+        uint64_t expire_;
+
+        /// @brief The callback.
+        Callback callback_;
+    };
+
+    /// @brief The type of the slots.
+    typedef std::list<Entry> Slot;
+
+    /// @brief The location of a timer in the wheel.
+    typedef std::pair<size_t, Slot::iterator> Location;
+
+    /// @brief Returns the number of ticks elapsed since the creation.
+    ///
+    /// @param now The current time.
+    /// @param round_up Round up to the next tick when true.
+    uint64_t getTicks(const Clock::time_point& now, bool round_up) const;
+
+    /// @brief The IO service.
+    IOServicePtr io_service_;
+
+    /// @brief The tick in milliseconds.
+    long tick_;
+
+    /// @brief The creation time.
+    Clock::time_point start_;
+
+    /// @brief The last processed tick.
+    uint64_t current_;
+
+    /// @brief The last timer identifier.
+    TimerId last_id_;
+
+    /// @brief The slots.
+    std::vector<Slot> slots_;
+
+    /// @brief The location of the scheduled timers.
+    std::unordered_map<TimerId, Location> timers_;
+
+    /// @brief The mutex protecting the wheel.
+    boost::scoped_ptr<std::mutex> mutex_;
+
+    /// @brief The interval timer driving the wheel.
+    IntervalTimer interval_timer_;
+};
+
+/// @brief The type of shared pointers to timing wheels.
+typedef boost::shared_ptr<TimerWheel> TimerWheelPtr;
+
+} // namespace asiolink
+} // namespace isc
+
+#endif // ASIOLINK_TIMER_WHEEL_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,12 +7,14 @@
 #include <config.h>
 
 #include <cc/data.h>
+#include <cc/json_parser.h>
 
 #include <cstring>
 #include <cassert>
 #include <climits>
 #include <list>
 #include <map>
+#include <mutex>
 #include <cstdio>
 #include <iostream>
 #include <iomanip>
@@ -20,8 +22,10 @@
 #include <sstream>
 #include <fstream>
 #include <cerrno>
+#include <unordered_set>
 
 #include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
 
 #include <cmath>
 
@@ -47,6 +51,26 @@ operator<<(std::ostream& out, const Element::Position& pos) {
     return (out);
 }
 
+const std::string*
+Element::internFile(const std::string& file) {
+    static const std::string empty;
+    if (file.empty()) {
+        return (&empty);
+    }
+    // Elements are usually created in a row from the same file.
+    static thread_local const std::string* last = 0;
+    if (last && (*last == file)) {
+        return (last);
+    }
+    // Never destroyed: elements may outlive the static objects.
+    static std::mutex* mutex = new std::mutex();
+    static std::unordered_set<std::string>* files =
+        new std::unordered_set<std::string>();
+    std::lock_guard<std::mutex> lock(*mutex);
+    last = &*files->insert(file).first;
+    return (last);
+}
+
 std::string
 Element::str() const {
     std::stringstream ss;
@@ -239,12 +263,12 @@ operator<(Element const& a, Element const& b) {
 //
 ElementPtr
 Element::create(const Position& pos) {
-    return (ElementPtr(new NullElement(pos)));
+    return (boost::make_shared<NullElement>(pos));
 }
 
 ElementPtr
 Element::create(const long long int i, const Position& pos) {
-    return (ElementPtr(new IntElement(static_cast<int64_t>(i), pos)));
+    return (boost::make_shared<IntElement>(static_cast<int64_t>(i), pos));
 }
 
 ElementPtr
@@ -264,17 +288,17 @@ Element::create(const uint32_t i, const Position& pos) {
 
 ElementPtr
 Element::create(const double d, const Position& pos) {
-    return (ElementPtr(new DoubleElement(d, pos)));
+    return (boost::make_shared<DoubleElement>(d, pos));
 }
 
 ElementPtr
 Element::create(const bool b, const Position& pos) {
-    return (ElementPtr(new BoolElement(b, pos)));
+    return (boost::make_shared<BoolElement>(b, pos));
 }
 
 ElementPtr
 Element::create(const std::string& s, const Position& pos) {
-    return (ElementPtr(new StringElement(s, pos)));
+    return (boost::make_shared<StringElement>(s, pos));
 }
 
 ElementPtr
@@ -284,12 +308,12 @@ Element::create(const char *s, const Position& pos) {
 
 ElementPtr
 Element::createList(const Position& pos) {
-    return (ElementPtr(new ListElement(pos)));
+    return (boost::make_shared<ListElement>(pos));
 }
 
 ElementPtr
 Element::createMap(const Position& pos) {
-    return (ElementPtr(new MapElement(pos)));
+    return (boost::make_shared<MapElement>(pos));
 }
 
 
@@ -762,21 +786,15 @@ Element::fromJSON(std::istream& in, const std::string& file, int& line,
 
 ElementPtr
 Element::fromJSON(const std::string& in, bool preproc) {
+    if (!preproc) {
+        return (JSONParser::parse(in));
+    }
     std::stringstream ss;
     ss << in;
-
-    int line = 1, pos = 1;
     stringstream filtered;
-    if (preproc) {
-        preprocess(ss, filtered);
-    }
-    ElementPtr result(fromJSON(preproc ? filtered : ss, "<string>", line, pos));
-    skipChars(ss, WHITESPACE, line, pos);
-    // ss must now be at end
-    if (ss.peek() != EOF) {
-        throwJSONError("Extra data", "<string>", line, pos);
-    }
-    return result;
+    preprocess(ss, filtered);
+    // As before, what follows the value is not checked when preprocessing.
+    return (JSONParser::parse(filtered.str(), "<string>", false));
 }
 
 ElementPtr
@@ -791,7 +809,15 @@ Element::fromJSONFile(const std::string& file_name, bool preproc) {
                   << "': " << error);
     }
 
-    return (fromJSON(infile, file_name, preproc));
+    // Read the whole file and parse it from memory, which is much faster
+    // than reading it character by character from the stream.
+    stringstream content;
+    if (preproc) {
+        preprocess(infile, content);
+    } else {
+        content << infile.rdbuf();
+    }
+    return (JSONParser::parse(content.str(), file_name, false));
 }
 
 // to JSON format
@@ -833,10 +859,20 @@ NullElement::toJSON(std::ostream& ss) const {
 
 void
 StringElement::toJSON(std::ostream& ss) const {
+    static const char hex_digits[] = "0123456789abcdef";
     ss << "\"";
     const std::string& str = stringValue();
-    for (size_t i = 0; i < str.size(); ++i) {
-        const char c = str[i];
+    const char* run = str.data();
+    const char* const end = run + str.size();
+    for (const char* cur = run; cur != end; ++cur) {
+        const char c = *cur;
+        // Printable characters other than quote and backslash are
+        // written by runs.
+        if ((c >= 0x20) && (c < 0x7f) && (c != '"') && (c != '\\')) {
+            continue;
+        }
+        ss.write(run, cur - run);
+        run = cur + 1;
         // Escape characters as defined in JSON spec
         // Note that we do not escape forward slash; this
         // is allowed, but not mandatory.
@@ -862,20 +898,15 @@ StringElement::toJSON(std::ostream& ss) const {
         case '\t':
             ss << '\\' << 't';
             break;
-        default:
-            if (((c >= 0) && (c < 0x20)) || (c < 0) || (c >= 0x7f)) {
-                std::ostringstream esc;
-                esc << "\\u"
-                    << hex
-                    << setw(4)
-                    << setfill('0')
-                    << (static_cast<unsigned>(c) & 0xff);
-                ss << esc.str();
-            } else {
-                ss << c;
-            }
+        default: {
+            const unsigned u = static_cast<unsigned>(c) & 0xff;
+            const char esc[] = { '\\', 'u', '0', '0',
+                                 hex_digits[u >> 4], hex_digits[u & 0xf] };
+            ss.write(esc, sizeof(esc));
+        }
         }
     }
+    ss.write(run, end - run);
     ss << "\"";
 }
 
@@ -938,10 +969,10 @@ MapElement::find(const std::string& id) const {
 
 ElementPtr
 Element::fromWire(const std::string& s) {
-    std::stringstream ss;
-    ss << s;
-    int line = 0, pos = 0;
-    return (fromJSON(ss, "<wire>", line, pos));
+    JSONParser parser(s.data(), s.size(), "<wire>", 0, 0);
+    ElementBuilder builder;
+    parser.parse(builder);
+    return (builder.getResult());
 }
 
 ElementPtr
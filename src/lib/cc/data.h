@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -132,8 +132,25 @@ private:
     // function getType?
     int type_;
 
-    /// @brief Position of the element in the configuration string.
-    Position position_;
+    /// @brief Name of the file the element was read from.
+    ///
+    /// The name is interned: all the elements read from the same file
+    /// share the same string, so large configurations do not hold a
+    /// copy of the file name per element.
+    const std::string* file_;
+
+    /// @brief Line number of the element in the configuration string.
+    uint32_t line_;
+
+    /// @brief Position of the element within the line.
+    uint32_t pos_;
+
+    /// @brief Returns the interned copy of a file name.
+    ///
+    /// @param file The file name.
+    /// @return A pointer to a string equal to the file name which is
+    /// never freed.
+    static const std::string* internFile(const std::string& file);
 
 protected:
 
@@ -144,7 +161,8 @@ protected:
     /// It comprises the line number and the position within this line. The values
     /// held in this structure are used for error logging purposes.
     Element(int t, const Position& pos = ZERO_POSITION())
-        : type_(t), position_(pos) {
+        : type_(t), file_(internFile(pos.file_)), line_(pos.line_),
+          pos_(pos.pos_) {
     }
 
 
@@ -162,9 +180,9 @@ public:
     /// @brief Returns position where the data element's value starts in a
     /// configuration string.
     ///
-    /// @warning The returned reference is valid as long as the object which
-    /// created it lives.
-    const Position& getPosition() const { return (position_); }
+    /// The position is built from the compact form stored in the element
+    /// so it is returned by value.
+    Position getPosition() const { return (Position(*file_, line_, pos_)); }
 
     /// Returns a string representing the Element and all its
     /// child elements; note that this is different from stringValue(),
@@ -187,10 +205,10 @@ public:
 #define throwTypeError(error)                   \
     {                                           \
         std::string msg_ = error;               \
-        if ((position_.file_ != "") ||          \
-            (position_.line_ != 0) ||           \
-            (position_.pos_ != 0)) {            \
-            msg_ += " in (" + position_.str() + ")";   \
+        if (!file_->empty() ||                  \
+            (line_ != 0) ||                     \
+            (pos_ != 0)) {                      \
+            msg_ += " in (" + getPosition().str() + ")";   \
         }                                       \
         isc_throw(TypeError, msg_);             \
     }
@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,6 +13,40 @@
 using namespace isc::data;
 using namespace isc::util;
 
+namespace {
+
+/// @brief Checks if a character may change the state inside JSON.
+///
+/// @param c The character.
+/// @return true for the braces, square brackets, quote and comment
+/// starts.
+inline bool
+isInnerSpecial(char c) {
+    switch (c) {
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case '"':
+    case '#':
+    case '/':
+        return (true);
+    default:
+        return (false);
+    }
+}
+
+/// @brief Checks if a character may change the state inside a JSON string.
+///
+/// @param c The character.
+/// @return true for the quote and the backslash.
+inline bool
+isStringSpecial(char c) {
+    return ((c == '"') || (c == '\\'));
+}
+
+}
+
 namespace isc {
 namespace config {
 
@@ -185,6 +219,17 @@ JSONFeed::onModelFailure(const std::string& explanation) {
     }
 }
 
+void
+JSONFeed::copyRun(bool (*special)(char)) {
+    const size_t start = data_ptr_;
+    while ((data_ptr_ < buffer_.size()) && !special(buffer_[data_ptr_])) {
+        ++data_ptr_;
+    }
+    if (data_ptr_ > start) {
+        output_.append(&buffer_[start], data_ptr_ - start);
+    }
+}
+
 bool
 JSONFeed::popNextFromBuffer(char& next) {
     // If there are any characters in the buffer, pop next.
@@ -425,6 +470,7 @@ JSONFeed::innerJSONHandler() {
 
         default:
             output_.push_back(c);
+            copyRun(isInnerSpecial);
             postNextEvent(DATA_READ_OK_EVT);
         }
     }
@@ -446,6 +492,7 @@ JSONFeed::stringJSONHandler() {
             break;
 
         default:
+            copyRun(isStringSpecial);
             transition(getCurrState(), DATA_READ_OK_EVT);
         }
     }
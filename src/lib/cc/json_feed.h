@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -68,6 +68,11 @@ public:
 /// is well formed. The structure is validated when @ref JSONFeed::toElement
 /// is called to retrieve the data structures encapsulated with
 /// @ref isc::data::Element objects.
+///
+/// The state handlers for the JSON content and for the JSON strings copy
+/// at once the run of characters which can't change the state, so the
+/// state model is run for the structural characters only and not for
+/// each byte of the payload.
 class JSONFeed : public util::StateModel {
 public:
 
@@ -280,6 +285,15 @@ private:
     /// @return true if character was successfully read, false otherwise.
     bool popNextFromBuffer(char& next);
 
+    /// @brief Copies the characters which don't change the state.
+    ///
+    /// Appends to the output the characters from the buffer up to the
+    /// first special one or the end of the buffer.
+    ///
+    /// @param special Function returning true for the characters which
+    /// end the run.
+    void copyRun(bool (*special)(char));
+
     /// @name State handlers.
     ///
     //@{
@@ -0,0 +1,402 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <cc/json_parser.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace {
+const char* const WHITESPACE = " \b\f\n\r\t";
+
+bool
+charIn(const int c, const char* chars) {
+    for (; *chars != 0; ++chars) {
+        if (*chars == c) {
+            return (true);
+        }
+    }
+    return (false);
+}
+} // end anonymous namespace
+
+namespace isc {
+namespace data {
+
+void
+ElementBuilder::startMap(const Element::Position& pos) {
+    ElementPtr map = Element::createMap(pos);
+    add(map);
+    stack_.push_back(map);
+}
+
+void
+ElementBuilder::key(const std::string& key) {
+    key_ = key;
+}
+
+void
+ElementBuilder::endMap() {
+    stack_.pop_back();
+}
+
+void
+ElementBuilder::startList(const Element::Position& pos) {
+    ElementPtr list = Element::createList(pos);
+    add(list);
+    stack_.push_back(list);
+}
+
+void
+ElementBuilder::endList() {
+    stack_.pop_back();
+}
+
+void
+ElementBuilder::value(ElementPtr value) {
+    add(value);
+}
+
+void
+ElementBuilder::add(const ElementPtr& element) {
+    if (stack_.empty()) {
+        result_ = element;
+    } else if (stack_.back()->getType() == Element::map) {
+        stack_.back()->set(key_, element);
+    } else {
+        stack_.back()->add(element);
+    }
+}
+
+JSONParser::JSONParser(const char* data, size_t size, const std::string& file,
+                       int line, int pos)
+    : cur_(data), end_(data + size), file_(file), line_(line), pos_(pos) {
+}
+
+void
+JSONParser::parse(JSONHandler& handler) {
+    parseValue(handler);
+}
+
+void
+JSONParser::checkEnd() {
+    skipChars(WHITESPACE);
+    if (peek() != EOF) {
+        throwError("Extra data", pos_);
+    }
+}
+
+ElementPtr
+JSONParser::parse(const std::string& text, const std::string& file,
+                  bool check_end) {
+    JSONParser parser(text.data(), text.size(), file);
+    ElementBuilder builder;
+    parser.parse(builder);
+    if (check_end) {
+        parser.checkEnd();
+    }
+    return (builder.getResult());
+}
+
+void
+JSONParser::throwError(const std::string& error, int pos) const {
+    std::stringstream ss;
+    ss << error << " in " + file_ + ":" << line_ << ":" << pos;
+    isc_throw(JSONError, ss.str());
+}
+
+void
+JSONParser::skipChars(const char* chars) {
+    int c = peek();
+    while ((c != EOF) && charIn(c, chars)) {
+        if (c == '\n') {
+            ++line_;
+            pos_ = 1;
+        } else {
+            ++pos_;
+        }
+        ++cur_;
+        c = peek();
+    }
+}
+
+int
+JSONParser::skipTo(const char* chars, const char* may_skip) {
+    int c = get();
+    ++pos_;
+    while (c != EOF) {
+        if (c == '\n') {
+            pos_ = 1;
+            ++line_;
+        }
+        if (charIn(c, may_skip)) {
+            c = get();
+            ++pos_;
+        } else if (charIn(c, chars)) {
+            skipChars(may_skip);
+            return (c);
+        } else {
+            throwError(std::string("'") + std::string(1, c) +
+                       "' read, one of \"" + chars + "\" expected", pos_);
+        }
+    }
+    throwError(std::string("EOF read, one of \"") + chars + "\" expected",
+               pos_);
+    return (c);
+}
+
+void
+JSONParser::parseValue(JSONHandler& handler) {
+    skipChars(WHITESPACE);
+    int c = peek();
+    switch (c) {
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+    case '0':
+    case '-':
+    case '+':
+    case '.':
+        handler.value(parseNumber());
+        break;
+    case 't':
+    case 'f':
+    case 'n':
+        handler.value(parseWord(c));
+        break;
+    case '"': {
+        // Remember position where the value starts.
+        const int start_pos = pos_;
+        const std::string value = parseString();
+        handler.value(Element::create(value, Element::Position(file_, line_,
+                                                               start_pos)));
+        break;
+    }
+    case '[':
+        ++cur_;
+        ++pos_;
+        parseList(handler);
+        break;
+    case '{':
+        ++cur_;
+        ++pos_;
+        parseMap(handler);
+        break;
+    case EOF:
+        isc_throw(JSONError, "nothing read");
+    default:
+        throwError(std::string("error: unexpected character ") +
+                   std::string(1, c), pos_ + 1);
+    }
+}
+
+void
+JSONParser::parseList(JSONHandler& handler) {
+    handler.startList(Element::Position(file_, line_, pos_));
+    skipChars(WHITESPACE);
+    int c = 0;
+    while ((c != EOF) && (c != ']')) {
+        if (peek() != ']') {
+            parseValue(handler);
+            c = skipTo(",]", WHITESPACE);
+        } else {
+            c = get();
+            ++pos_;
+        }
+    }
+    handler.endList();
+}
+
+void
+JSONParser::parseMap(JSONHandler& handler) {
+    handler.startMap(Element::Position(file_, line_, pos_));
+    skipChars(WHITESPACE);
+    int c = peek();
+    if (c == EOF) {
+        throwError("Unterminated map, <string> or } expected", pos_);
+    } else if (c == '}') {
+        // Empty map, skip the closing curly bracket.
+        ignore();
+    } else {
+        while ((c != EOF) && (c != '}')) {
+            handler.key(parseString());
+            skipTo(":", WHITESPACE);
+            parseValue(handler);
+            c = skipTo(",}", WHITESPACE);
+        }
+    }
+    handler.endMap();
+}
+
+ElementPtr
+JSONParser::parseNumber() {
+    const int start_pos = pos_;
+    const char* start = cur_;
+    while ((cur_ < end_) &&
+           (isdigit(static_cast<unsigned char>(*cur_)) ||
+            (*cur_ == '+') || (*cur_ == '-') || (*cur_ == '.') ||
+            (*cur_ == 'e') || (*cur_ == 'E'))) {
+        ++cur_;
+    }
+    const std::string number(start, cur_ - start);
+    pos_ += number.size();
+
+    try {
+        if (number.find_first_of(".eE") < number.size()) {
+            return (Element::create(boost::lexical_cast<double>(number),
+                                    Element::Position(file_, line_,
+                                                      start_pos)));
+        }
+        return (Element::create(boost::lexical_cast<int64_t>(number),
+                                Element::Position(file_, line_, start_pos)));
+    } catch (const boost::bad_lexical_cast&) {
+        throwError(std::string("Number overflow: ") + number, start_pos);
+    }
+    return (ElementPtr());
+}
+
+ElementPtr
+JSONParser::parseWord(int c) {
+    const int start_pos = pos_;
+    const char* start = cur_;
+    while ((cur_ < end_) && isalpha(static_cast<unsigned char>(*cur_))) {
+        ++cur_;
+    }
+    const std::string word(start, cur_ - start);
+    pos_ += word.size();
+
+    const Element::Position pos(file_, line_, start_pos);
+    if (c == 'n') {
+        if (word == "null") {
+            return (Element::create(pos));
+        }
+        throwError(std::string("Bad null value: ") + word, start_pos);
+    } else if (word == "true") {
+        return (Element::create(true, pos));
+    } else if (word == "false") {
+        return (Element::create(false, pos));
+    }
+    throwError(std::string("Bad boolean value: ") + word, start_pos);
+    return (ElementPtr());
+}
+
+std::string
+JSONParser::parseString() {
+    int c = get();
+    ++pos_;
+    if (c != '"') {
+        throwError("String expected", pos_);
+    }
+
+    std::string result;
+    for (;;) {
+        // Copy the run of unescaped characters at once.
+        const char* start = cur_;
+        while ((cur_ < end_) && (*cur_ != '"') && (*cur_ != '\\')) {
+            ++cur_;
+        }
+        result.append(start, cur_ - start);
+        pos_ += cur_ - start;
+
+        c = get();
+        ++pos_;
+        if (c == EOF) {
+            throwError("Unterminated string", pos_);
+        } else if (c == '"') {
+            return (result);
+        }
+
+        // See the spec for allowed escape characters.
+        int d;
+        switch (peek()) {
+        case '"':
+            c = '"';
+            break;
+        case '/':
+            c = '/';
+            break;
+        case '\\':
+            c = '\\';
+            break;
+        case 'b':
+            c = '\b';
+            break;
+        case 'f':
+            c = '\f';
+            break;
+        case 'n':
+            c = '\n';
+            break;
+        case 'r':
+            c = '\r';
+            break;
+        case 't':
+            c = '\t';
+            break;
+        case 'u':
+            // Skip the first 0.
+            ignore();
+            ++pos_;
+            if (peek() != '0') {
+                throwError("Unsupported unicode escape", pos_);
+            }
+            // Skip the second 0.
+            ignore();
+            ++pos_;
+            if (peek() != '0') {
+                throwError("Unsupported unicode escape", pos_ - 2);
+            }
+            // Get the first digit.
+            ignore();
+            ++pos_;
+            d = peek();
+            if ((d >= '0') && (d <= '9')) {
+                c = (d - '0') << 4;
+            } else if ((d >= 'A') && (d <= 'F')) {
+                c = (d - 'A' + 10) << 4;
+            } else if ((d >= 'a') && (d <= 'f')) {
+                c = (d - 'a' + 10) << 4;
+            } else {
+                throwError("Not hexadecimal in unicode escape", pos_ - 3);
+            }
+            // Get the second digit.
+            ignore();
+            ++pos_;
+            d = peek();
+            if ((d >= '0') && (d <= '9')) {
+                c |= d - '0';
+            } else if ((d >= 'A') && (d <= 'F')) {
+                c |= d - 'A' + 10;
+            } else if ((d >= 'a') && (d <= 'f')) {
+                c |= d - 'a' + 10;
+            } else {
+                throwError("Not hexadecimal in unicode escape", pos_ - 4);
+            }
+            break;
+        default:
+            throwError("Bad escape", pos_);
+        }
+        // Drop the escaped character.
+        ignore();
+        ++pos_;
+        result.push_back(static_cast<char>(c));
+    }
+}
+
+} // end of namespace isc::data
+} // end of namespace isc
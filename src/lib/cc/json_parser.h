@@ -0,0 +1,245 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSON_PARSER_H
+#define JSON_PARSER_H
+
+#include <cc/data.h>
+
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace data {
+
+/// @brief Receiver of the events produced by the @c JSONParser.
+///
+/// The parser calls the handler for each map, list and scalar value it
+/// reads, in document order. A handler can process a large document,
+/// e.g. a long list of host reservations, without building the whole
+/// tree of elements.
+class JSONHandler {
+public:
+
+    /// @brief Destructor.
+    virtual ~JSONHandler() {
+    }
+
+    /// @brief A map begins.
+    ///
+    /// @param pos position of the map (after the opening curly bracket).
+    virtual void startMap(const Element::Position& pos) = 0;
+
+    /// @brief The key of the next map entry was read.
+    ///
+    /// @param key the key.
+    virtual void key(const std::string& key) = 0;
+
+    /// @brief The current map ends.
+    virtual void endMap() = 0;
+
+    /// @brief A list begins.
+    ///
+    /// @param pos position of the list (after the opening bracket).
+    virtual void startList(const Element::Position& pos) = 0;
+
+    /// @brief The current list ends.
+    virtual void endList() = 0;
+
+    /// @brief A scalar value was read.
+    ///
+    /// @param value the scalar element (integer, real, boolean, string
+    /// or null).
+    virtual void value(ElementPtr value) = 0;
+};
+
+/// @brief Handler building the tree of elements.
+class ElementBuilder : public JSONHandler {
+public:
+
+    /// @brief Constructor.
+    ElementBuilder() {
+    }
+
+    /// @brief Creates the map and adds it to the current container.
+    ///
+    /// @param pos position of the map.
+    virtual void startMap(const Element::Position& pos);
+
+    /// @brief Remembers the key of the next map entry.
+    ///
+    /// @param key the key.
+    virtual void key(const std::string& key);
+
+    /// @brief Returns to the parent container.
+    virtual void endMap();
+
+    /// @brief Creates the list and adds it to the current container.
+    ///
+    /// @param pos position of the list.
+    virtual void startList(const Element::Position& pos);
+
+    /// @brief Returns to the parent container.
+    virtual void endList();
+
+    /// @brief Adds the value to the current container.
+    ///
+    /// @param value the scalar element.
+    virtual void value(ElementPtr value);
+
+    /// @brief Returns the built element (null if nothing was read).
+    ElementPtr getResult() const {
+        return (result_);
+    }
+
+private:
+
+    /// @brief Adds an element to the current container.
+    ///
+    /// @param element the element.
+    void add(const ElementPtr& element);
+
+    /// @brief The containers being built, innermost last.
+    std::vector<ElementPtr> stack_;
+
+    /// @brief The key of the next map entry.
+    std::string key_;
+
+    /// @brief The top-level element.
+    ElementPtr result_;
+};
+
+/// @brief JSON parser working on a memory buffer.
+///
+/// It accepts exactly the same syntax as @c Element::fromJSON with
+/// a stream and reports the same positions and errors but it reads the
+/// characters directly from the buffer and copies the strings by runs
+/// instead of going through the stream functions for each character.
+/// The buffer must remain valid while the parser is used.
+class JSONParser {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param data pointer to the JSON text.
+    /// @param size size of the JSON text.
+    /// @param file the name of the file (used in positions and errors).
+    /// @param line the number of the first line.
+    /// @param pos the position of the first character in the line.
+    JSONParser(const char* data, size_t size,
+               const std::string& file = "<string>",
+               int line = 1, int pos = 1);
+
+    /// @brief Parses one JSON value.
+    ///
+    /// Leading whitespace is skipped. What follows the value is not read.
+    ///
+    /// @param handler the handler receiving the events.
+    /// @throw JSONError on a syntax error.
+    void parse(JSONHandler& handler);
+
+    /// @brief Checks that only whitespace follows the parsed value.
+    ///
+    /// @throw JSONError when there is extra data.
+    void checkEnd();
+
+    /// @brief Parses a JSON text into an element.
+    ///
+    /// @param text the JSON text.
+    /// @param file the name of the file (used in positions and errors).
+    /// @param check_end check that nothing follows the value when true.
+    /// @return the element.
+    /// @throw JSONError on a syntax error.
+    static ElementPtr parse(const std::string& text,
+                            const std::string& file = "<string>",
+                            bool check_end = true);
+
+private:
+
+    /// @brief Returns the next character or EOF without consuming it.
+    int peek() const {
+        return (cur_ < end_ ? static_cast<unsigned char>(*cur_) : EOF);
+    }
+
+    /// @brief Returns and consumes the next character or returns EOF.
+    int get() {
+        return (cur_ < end_ ? static_cast<unsigned char>(*cur_++) : EOF);
+    }
+
+    /// @brief Consumes the next character if any.
+    void ignore() {
+        if (cur_ < end_) {
+            ++cur_;
+        }
+    }
+
+    /// @brief Skips the characters in a set.
+    ///
+    /// @param chars the set of characters to skip.
+    void skipChars(const char* chars);
+
+    /// @brief Skips to one of the characters in a set.
+    ///
+    /// @param chars the set of expected characters.
+    /// @param may_skip the set of characters which can be skipped.
+    /// @return the found character.
+    /// @throw JSONError if another character or the end is found.
+    int skipTo(const char* chars, const char* may_skip = "");
+
+    /// @brief Parses a value.
+    ///
+    /// @param handler the handler receiving the events.
+    void parseValue(JSONHandler& handler);
+
+    /// @brief Parses the entries of a list.
+    ///
+    /// @param handler the handler receiving the events.
+    void parseList(JSONHandler& handler);
+
+    /// @brief Parses the entries of a map.
+    ///
+    /// @param handler the handler receiving the events.
+    void parseMap(JSONHandler& handler);
+
+    /// @brief Parses a number.
+    ElementPtr parseNumber();
+
+    /// @brief Parses a boolean or null according to the expected word.
+    ///
+    /// @param c the first character of the word.
+    ElementPtr parseWord(int c);
+
+    /// @brief Parses a string.
+    ///
+    /// @return the unescaped string.
+    std::string parseString();
+
+    /// @brief Throws a JSONError at the current line.
+    ///
+    /// @param error the error message.
+    /// @param pos the position in the line.
+    void throwError(const std::string& error, int pos) const;
+
+    /// @brief The current character.
+    const char* cur_;
+
+    /// @brief The end of the buffer.
+    const char* end_;
+
+    /// @brief The name of the file.
+    std::string file_;
+
+    /// @brief The current line.
+    int line_;
+
+    /// @brief The current position in the line.
+    int pos_;
+};
+
+} // end of namespace isc::data
+} // end of namespace isc
+
+#endif // JSON_PARSER_H
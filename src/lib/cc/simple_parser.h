@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -144,7 +144,7 @@ public:
     /// @param name position of that element will be returned
     /// @param parent parent element (optional)
     /// @return position of the element specified.
-    static const data::Element::Position&
+    static data::Element::Position
     getPosition(const std::string& name, const data::ConstElementPtr parent);
 
     /// @brief Returns a string parameter from a scope
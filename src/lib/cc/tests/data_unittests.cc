@@ -1,4 +1,4 @@
-// Copyright (C) 2009-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2009-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -775,6 +775,51 @@ TEST(Element, to_and_from_wire) {
     EXPECT_THROW(Element::fromJSON("[ \"a\": \"b\" ]"), isc::data::JSONError);
 }
 
+/// @brief Returns the message of the error raised by fromWire.
+///
+/// @param wire the wire format text.
+/// @return the error message or "no error".
+std::string
+fromWireError(const std::string& wire) {
+    try {
+        Element::fromWire(wire);
+    } catch (const isc::data::JSONError& ex) {
+        return (ex.what());
+    }
+    return ("no error");
+}
+
+TEST(Element, from_wire_errors) {
+    // The positions start at line 0 and character 0 of "<wire>".
+    EXPECT_EQ("Unterminated map, <string> or } expected in <wire>:0:2",
+              fromWireError("{ "));
+    EXPECT_EQ("EOF read, one of \":\" expected in <wire>:0:7",
+              fromWireError("{ \"a\" "));
+    EXPECT_EQ("'2' read, one of \",]\" expected in <wire>:1:8",
+              fromWireError("\n  [ 1 2 ]"));
+    EXPECT_EQ("error: unexpected character x in <wire>:0:1",
+              fromWireError("x"));
+    EXPECT_EQ("nothing read", fromWireError(""));
+    EXPECT_EQ("nothing read", fromWireError("[ 1, "));
+
+    // The elements have wire positions.
+    ElementPtr el = Element::fromWire("{\n \"a\": [ 1,\n  \"b\" ] }");
+    ASSERT_TRUE(el);
+    EXPECT_EQ("<wire>:0:1", el->getPosition().str());
+    ASSERT_TRUE(el->get("a"));
+    EXPECT_EQ("<wire>:1:8", el->get("a")->getPosition().str());
+    ASSERT_TRUE(el->get("a")->get(1));
+    EXPECT_EQ("<wire>:2:3", el->get("a")->get(1)->getPosition().str());
+
+    // The data following the first value is ignored.
+    el = Element::fromWire("{ \"a\": 1 } x");
+    ASSERT_TRUE(el);
+    EXPECT_EQ("{ \"a\": 1 }", el->str());
+    el = Element::fromWire("1 2");
+    ASSERT_TRUE(el);
+    EXPECT_EQ("1", el->str());
+}
+
 ConstElementPtr
 efs(const std::string& str) {
     return (Element::fromJSON(str));
@@ -1326,6 +1371,33 @@ TEST(Element, getPosition) {
 }
 
 // Tests whether position is returned properly for a commented input JSON text.
+// Verifies that the elements keep their file name when it is long and
+// when elements of several files are interleaved.
+TEST(Element, getPositionFileName) {
+    ElementPtr el1;
+    ElementPtr el2;
+    ElementPtr el3;
+    {
+        std::string file1("/a/very/long/path/to/the/first/kea-dhcp4.conf");
+        std::string file2("/a/very/long/path/to/the/second/kea-dhcp4.conf");
+        el1 = Element::create(1, Element::Position(file1, 1, 2));
+        el2 = Element::create(2, Element::Position(file2, 3, 4));
+        el3 = Element::create(3, Element::Position(file1, 5, 6));
+    }
+    EXPECT_EQ("/a/very/long/path/to/the/first/kea-dhcp4.conf:1:2",
+              el1->getPosition().str());
+    EXPECT_EQ("/a/very/long/path/to/the/second/kea-dhcp4.conf:3:4",
+              el2->getPosition().str());
+    EXPECT_EQ("/a/very/long/path/to/the/first/kea-dhcp4.conf:5:6",
+              el3->getPosition().str());
+
+    // The default position has an empty file name.
+    ElementPtr el4 = Element::create(4);
+    EXPECT_TRUE(el4->getPosition().file_.empty());
+    EXPECT_EQ(0, el4->getPosition().line_);
+    EXPECT_EQ(0, el4->getPosition().pos_);
+}
+
 TEST(Element, getPositionCommented) {
     std::istringstream ss("{\n"
                           "    \"a\":  2,\n"
@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -446,4 +446,26 @@ TEST_F(JSONFeedTest, multilineComments6) {
     EXPECT_NO_THROW(feed.toElement());
 }
 
+// This test verifies that the runs of ordinary characters are copied
+// across the chunks and that the data after the closing brace is left.
+TEST_F(JSONFeedTest, longRuns) {
+    std::string value(1000, 'x');
+    value[500] = '}';
+    std::string json = "{ \"long\": \"" + value + "\", \"number\": 1234567890 }";
+    ElementPtr expected = Element::createMap();
+    expected->set("long", Element::create(value));
+    expected->set("number", Element::create(1234567890));
+    testRead(json, expected);
+
+    JSONFeed feed;
+    ASSERT_NO_THROW(feed.initModel());
+    json += " { \"next\": 1 }";
+    feed.postBuffer(&json[0], json.size());
+    feed.poll();
+    EXPECT_TRUE(feed.feedOk());
+    ConstElementPtr element_from_feed = feed.toElement();
+    ASSERT_TRUE(element_from_feed);
+    EXPECT_TRUE(element_from_feed->equals(*expected));
+}
+
 } // end of anonymous namespace.
@@ -0,0 +1,146 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <cc/data.h>
+#include <cc/json_parser.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace isc::data;
+using namespace std;
+
+namespace {
+
+/// @brief Handler recording the parsing events.
+class RecordingHandler : public JSONHandler {
+public:
+
+    void startMap(const Element::Position& pos) {
+        events_.push_back("{@" + pos.str());
+    }
+
+    void key(const string& key) {
+        events_.push_back("key " + key);
+    }
+
+    void endMap() {
+        events_.push_back("}");
+    }
+
+    void startList(const Element::Position& pos) {
+        events_.push_back("[@" + pos.str());
+    }
+
+    void endList() {
+        events_.push_back("]");
+    }
+
+    void value(ElementPtr value) {
+        events_.push_back(value->str() + "@" + value->getPosition().str());
+    }
+
+    /// @brief The recorded events.
+    vector<string> events_;
+};
+
+// Verifies the events and their positions.
+TEST(JSONParserTest, events) {
+    string text = "{ \"a\": [ 1, 2.5 ],\n  \"b\": { },\n  \"c\": null }";
+    JSONParser parser(text.data(), text.size(), "test");
+    RecordingHandler handler;
+    ASSERT_NO_THROW(parser.parse(handler));
+    EXPECT_NO_THROW(parser.checkEnd());
+
+    vector<string> expected = {
+        "{@test:1:2",
+        "key a",
+        "[@test:1:9",
+        "1@test:1:10",
+        "2.5@test:1:13",
+        "]",
+        "key b",
+        "{@test:2:9",
+        "}",
+        "key c",
+        "null@test:3:8",
+        "}"
+    };
+    EXPECT_EQ(expected, handler.events_);
+}
+
+// Verifies that the parser builds the same elements and throws the same
+// errors as the stream parser.
+TEST(JSONParserTest, sameAsStream) {
+    vector<string> texts = {
+        "1", "-12", "+3", "1.5e3", "true", "false", "null",
+        "\"foo\"", "\"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\"", "\"\\u0041\\u00e9\"",
+        "[]", "[ ]", "[1, 2, ]", "[[1], [\"a\", [true]]]",
+        "{}", "{ }", "{\"a\": 1, \"a\": 2}",
+        "{\n  \"a\": [\n    { \"b\": \"c\" }\n  ],\n  \"d\": 1.0\n}",
+        // Errors.
+        "", "   ", "{1}", "[1 2]", "{\"a\" 1}", "{\"a\": 1 \"b\": 2}",
+        "tru", "nul", "12345678901234567890", "1.2.3", "\"abc",
+        "\"\\x\"", "\"\\u0100\"", "\"\\u00g0\"", "\"\\u00ag\"",
+        "[1, 2", "{\"a\": 1", "{", "}", "\n{\n\"a\" :\n#\n}"
+    };
+    for (auto const& text : texts) {
+        SCOPED_TRACE(text);
+        string expected;
+        string expected_error;
+        try {
+            istringstream ss(text);
+            expected = Element::fromJSON(ss, string("<string>"))->str();
+        } catch (const JSONError& ex) {
+            expected_error = ex.what();
+        }
+        string got;
+        string got_error;
+        try {
+            got = JSONParser::parse(text, "<string>", false)->str();
+        } catch (const JSONError& ex) {
+            got_error = ex.what();
+        }
+        EXPECT_EQ(expected, got);
+        EXPECT_EQ(expected_error, got_error);
+    }
+}
+
+// Verifies the check of the extra data.
+TEST(JSONParserTest, extraData) {
+    EXPECT_NO_THROW(JSONParser::parse("{ }  \n "));
+    EXPECT_NO_THROW(JSONParser::parse("[ 1 ] 2", "<string>", false));
+    try {
+        JSONParser::parse("[ 1 ] 2");
+        ADD_FAILURE() << "expected JSONError";
+    } catch (const JSONError& ex) {
+        EXPECT_EQ("Extra data in <string>:1:7", string(ex.what()));
+    }
+}
+
+// Verifies that a large list is parsed.
+TEST(JSONParserTest, largeList) {
+    ostringstream text;
+    text << "[";
+    const size_t count = 100000;
+    for (size_t i = 0; i < count; ++i) {
+        text << "{ \"hw-address\": \"01:02:03:04:05:06\", \"id\": " << i
+             << " },\n";
+    }
+    text << "]";
+    ConstElementPtr list;
+    ASSERT_NO_THROW(list = JSONParser::parse(text.str()));
+    ASSERT_EQ(count, list->size());
+    EXPECT_EQ(count - 1, list->get(count - 1)->get("id")->intValue());
+    EXPECT_EQ(count, list->get(count - 1)->getPosition().line_);
+}
+
+} // end of anonymous namespace
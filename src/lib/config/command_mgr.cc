@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -19,10 +19,14 @@
 #include <dhcp/iface_mgr.h>
 #include <config/config_log.h>
 #include <config/timeouts.h>
+#include <util/multi_threading_mgr.h>
+#include <util/thread_pool.h>
 #include <util/watch_socket.h>
 #include <boost/enable_shared_from_this.hpp>
+#include <boost/make_shared.hpp>
 #include <array>
 #include <functional>
+#include <set>
 #include <unistd.h>
 #include <sys/file.h>
 
@@ -30,6 +34,7 @@ using namespace isc;
 using namespace isc::asiolink;
 using namespace isc::config;
 using namespace isc::data;
+using namespace isc::util;
 namespace ph = std::placeholders;
 
 namespace {
@@ -37,6 +42,153 @@ namespace {
 /// @brief Maximum size of the data chunk sent/received over the socket.
 const size_t BUF_SIZE = 32768;
 
+/// @brief Size of the length header of a framed command or response.
+const size_t FRAME_HEADER_SIZE = 4;
+
+/// @brief Maximum length of a framed command.
+///
+/// The first byte of the header of a framed command is always 0, which
+/// can't start a JSON text, so the framing is detected from the first
+/// byte received over a connection.
+const size_t MAX_FRAME_SIZE = 0xffffff;
+
+/// @brief Name of the critical section callbacks of the command executor.
+const std::string EXECUTOR_CS_CALLBACKS_NAME = "CommandMgr";
+
+/// @brief Set in the threads of the command executor.
+thread_local bool executor_thread = false;
+
+/// @brief Processes the read-only commands in a pool of threads.
+class CommandExecutor {
+public:
+
+    /// @brief Type of the work items.
+    typedef std::function<void()> WorkItem;
+
+    /// @brief Constructor.
+    CommandExecutor() : thread_pool_(), thread_count_(0), read_only_() {
+    }
+
+    /// @brief Starts the threads.
+    ///
+    /// @param thread_count Number of threads.
+    void start(uint32_t thread_count) {
+        if (!thread_count) {
+            isc_throw(InvalidParameter, "command executor thread count is 0");
+        }
+        if (thread_count == thread_count_) {
+            return;
+        }
+        stop();
+        thread_count_ = thread_count;
+        MultiThreadingMgr::instance().addCriticalSectionCallbacks(
+            EXECUTOR_CS_CALLBACKS_NAME,
+            std::bind(&CommandExecutor::checkPermissions, this),
+            std::bind(&CommandExecutor::pause, this),
+            std::bind(&CommandExecutor::resume, this));
+        // Inside a critical section the threads are started on exit.
+        if (!MultiThreadingMgr::instance().isInCriticalSection()) {
+            resume();
+        }
+    }
+
+    /// @brief Stops the threads.
+    ///
+    /// The commands not yet processed are dropped.
+    void stop() {
+        if (!thread_count_) {
+            return;
+        }
+        MultiThreadingMgr::instance().removeCriticalSectionCallbacks(
+            EXECUTOR_CS_CALLBACKS_NAME);
+        thread_pool_.reset();
+        thread_count_ = 0;
+    }
+
+    /// @brief Returns the number of threads.
+    uint32_t getThreadCount() const {
+        return (thread_count_);
+    }
+
+    /// @brief Declares a command as read-only.
+    ///
+    /// @param cmd_name Name of the command.
+    void addReadOnly(const std::string& cmd_name) {
+        read_only_.insert(cmd_name);
+    }
+
+    /// @brief Checks if a command was declared as read-only.
+    ///
+    /// @param cmd_name Name of the command.
+    bool isReadOnly(const std::string& cmd_name) const {
+        return (read_only_.count(cmd_name) > 0);
+    }
+
+    /// @brief Checks if a command can be processed by the threads.
+    ///
+    /// @param cmd The command.
+    /// @return true if the threads are started, the multi-threading mode
+    /// is enabled and the command is read-only.
+    bool accepts(const ConstElementPtr& cmd) const {
+        if (!thread_count_ || !MultiThreadingMgr::instance().getMode() ||
+            !cmd || (cmd->getType() != Element::map)) {
+            return (false);
+        }
+        ConstElementPtr name = cmd->get(CONTROL_COMMAND);
+        return (name && (name->getType() == Element::string) &&
+                isReadOnly(name->stringValue()));
+    }
+
+    /// @brief Adds a work item.
+    ///
+    /// @param item The work item.
+    void add(const WorkItem& item) {
+        thread_pool_.add(boost::make_shared<WorkItem>([item]() {
+            executor_thread = true;
+            item();
+        }));
+    }
+
+private:
+
+    /// @brief Forbids the critical sections in the threads.
+    ///
+    /// The critical section would wait for the thread entering it.
+    ///
+    /// @throw MultiThreadingInvalidOperation in a thread of the executor.
+    void checkPermissions() {
+        if (executor_thread) {
+            isc_throw(MultiThreadingInvalidOperation,
+                      "critical section entered by a command executor thread");
+        }
+    }
+
+    /// @brief Waits for the current commands and stops the threads.
+    ///
+    /// The commands not yet processed stay in the queue.
+    void pause() {
+        if (thread_pool_.size()) {
+            thread_pool_.stop();
+        }
+    }
+
+    /// @brief Starts the threads again.
+    void resume() {
+        if (thread_count_ && !thread_pool_.size()) {
+            thread_pool_.start(thread_count_);
+        }
+    }
+
+    /// @brief The pool of threads.
+    ThreadPool<WorkItem> thread_pool_;
+
+    /// @brief Number of threads (0 when stopped).
+    uint32_t thread_count_;
+
+    /// @brief Names of the read-only commands.
+    std::set<std::string> read_only_;
+};
+
 class ConnectionPool;
 
 /// @brief Represents a single connection over control socket.
@@ -62,14 +214,20 @@ public:
     /// for data transmission.
     /// @param connection_pool Reference to the connection pool to which this
     /// connection belongs.
+    /// @param executor Reference to the executor of the read-only commands.
     /// @param timeout Connection timeout (in seconds).
     Connection(const IOServicePtr& io_service,
                const boost::shared_ptr<UnixDomainSocket>& socket,
                ConnectionPool& connection_pool,
+               CommandExecutor& executor,
                const long timeout)
-        : socket_(socket), timeout_timer_(*io_service), timeout_(timeout),
-          buf_(), response_(), connection_pool_(connection_pool), feed_(),
-          response_in_progress_(false), watch_socket_(new util::WatchSocket()) {
+        : io_service_(io_service), socket_(socket),
+          timeout_timer_(*io_service), timeout_(timeout),
+          buf_(), response_(), response_sent_(0), connection_pool_(connection_pool),
+          executor_(executor), feed_(), response_in_progress_(false),
+          mode_known_(false), framed_(false), frame_(),
+          close_after_response_(false),
+          watch_socket_(new util::WatchSocket()) {
 
         LOG_DEBUG(command_logger, DBG_COMMAND, COMMAND_SOCKET_CONNECTION_OPENED)
             .arg(socket_->getNative());
@@ -150,8 +308,9 @@ public:
     /// close the connection gracefully if all data has been sent, or will
     /// call @ref doSend() again to send the next chunk of data.
     void doSend() {
-        size_t chunk_size = (response_.size() < BUF_SIZE) ? response_.size() : BUF_SIZE;
-        socket_->asyncSend(&response_[0], chunk_size,
+        const size_t left = response_.size() - response_sent_;
+        size_t chunk_size = (left < BUF_SIZE) ? left : BUF_SIZE;
+        socket_->asyncSend(&response_[response_sent_], chunk_size,
            std::bind(&Connection::sendHandler, shared_from_this(), ph::_1, ph::_2));
 
         // Asynchronous send has been scheduled and we need to indicate this
@@ -169,24 +328,79 @@ public:
     /// @brief Handler invoked when the data is received over the control
     /// socket.
     ///
-    /// It collects received data into the @c isc::config::JSONFeed object and
-    /// schedules additional asynchronous read of data if this object signals
-    /// that command is incomplete. When the entire command is received, the
-    /// handler processes this command and asynchronously responds to the
-    /// controlling client.
-    //
+    /// The first received byte selects the mode of the connection: 0 for
+    /// the framed mode, anything else for the JSON mode.
+    ///
+    /// In the JSON mode it collects received data into the
+    /// @c isc::config::JSONFeed object and schedules additional asynchronous
+    /// read of data if this object signals that command is incomplete. When
+    /// the entire command is received, the handler processes this command
+    /// and asynchronously responds to the controlling client.
+    ///
+    /// In the framed mode the received data is appended to the frame buffer
+    /// and processed by @ref processFrame().
     ///
     /// @param ec Error code.
     /// @param bytes_transferred Number of bytes received.
     void receiveHandler(const boost::system::error_code& ec,
                         size_t bytes_transferred);
 
+    /// @brief Processes the next framed command.
+    ///
+    /// In the framed mode each command and each response is preceded by
+    /// its length as a 32 bit unsigned integer in network byte order and
+    /// the connection stays open after the response so the client can send
+    /// many commands over it. Commands sent before the previous response
+    /// was received are processed in order.
+    ///
+    /// Schedules another asynchronous read when the frame buffer does not
+    /// hold a complete command. A command larger than @c MAX_FRAME_SIZE
+    /// is rejected and the connection closed after the error response.
+    void processFrame();
+
+    /// @brief Processes a received command.
+    ///
+    /// Read-only commands are handed to the executor threads, if any,
+    /// which send the response themselves.
+    ///
+    /// @param cmd The command.
+    /// @param [out] rsp The response of a command processed by the main
+    /// thread.
+    /// @return true if the command was handed to the executor.
+    bool handleCommand(const ConstElementPtr& cmd, ConstElementPtr& rsp);
+
+    /// @brief Sets the response to be sent.
+    ///
+    /// The length header is prepended in the framed mode.
+    ///
+    /// @param text The response text.
+    void setResponse(const std::string& text);
+
+    /// @brief Returns the size of the partially received command.
+    size_t partialSize() const {
+        return (framed_ ? frame_.size() : feed_.getProcessedText().size());
+    }
+
+    /// @brief Processes a command in a thread of the executor.
+    ///
+    /// The response is sent by the main thread which is woken up by the
+    /// watch socket.
+    ///
+    /// @param cmd The command.
+    void executeCommand(const ConstElementPtr& cmd);
+
+    /// @brief Asynchronously responds to the controlling client.
+    ///
+    /// @param cmd The command (null if it could not be parsed).
+    /// @param rsp The response (null if none was generated).
+    void sendResponse(const ConstElementPtr& cmd, ConstElementPtr rsp);
 
     /// @brief Handler invoked when the data is sent over the control socket.
     ///
     /// If there are still data to be sent, another asynchronous send is
     /// scheduled. When the entire command is sent, the connection is shutdown
-    /// and closed.
+    /// and closed, except in the framed mode where the next command is
+    /// processed.
     ///
     /// @param ec Error code.
     /// @param bytes_transferred Number of bytes sent.
@@ -196,11 +410,15 @@ public:
     /// @brief Handler invoked when timeout has occurred.
     ///
     /// Asynchronously sends a response to the client indicating that the
-    /// timeout has occurred.
+    /// timeout has occurred. An idle connection in the framed mode is
+    /// closed without a response.
     void timeoutHandler();
 
 private:
 
+    /// @brief Pointer to the IO service used to send the response.
+    IOServicePtr io_service_;
+
     /// @brief Pointer to the socket used for transmission.
     boost::shared_ptr<UnixDomainSocket> socket_;
 
@@ -216,9 +434,18 @@ private:
     /// @brief Response created by the server.
     std::string response_;
 
+    /// @brief Number of bytes of the response already sent.
+    ///
+    /// The sent data is not erased from the response because moving
+    /// the rest of a large response after each chunk is quadratic.
+    size_t response_sent_;
+
     /// @brief Reference to the pool of connections.
     ConnectionPool& connection_pool_;
 
+    /// @brief Reference to the executor of the read-only commands.
+    CommandExecutor& executor_;
+
     /// @brief State model used to receive data over the connection and detect
     /// when the command ends.
     JSONFeed feed_;
@@ -227,6 +454,19 @@ private:
     /// result of server reconfiguration.
     bool response_in_progress_;
 
+    /// @brief Set when the first byte was received and the mode is known.
+    bool mode_known_;
+
+    /// @brief Set in the framed mode.
+    bool framed_;
+
+    /// @brief Received data not yet processed in the framed mode.
+    std::string frame_;
+
+    /// @brief Set when the connection is closed after the response in the
+    /// framed mode.
+    bool close_after_response_;
+
     /// @brief Pointer to watch socket instance used to signal that the socket
     /// is ready for read or write.
     util::WatchSocketPtr watch_socket_;
@@ -293,11 +533,11 @@ Connection::receiveHandler(const boost::system::error_code& ec,
     if (ec) {
         if (ec.value() == boost::asio::error::eof) {
             std::stringstream os;
-            if (feed_.getProcessedText().empty()) {
+            if (partialSize() == 0) {
                os << "no input data to discard";
             } else {
                os << "discarding partial command of "
-                  << feed_.getProcessedText().size() << " bytes";
+                  << partialSize() << " bytes";
             }
 
             // Foreign host has closed the connection. We should remove it from the
@@ -324,6 +564,17 @@ Connection::receiveHandler(const boost::system::error_code& ec,
     // Reschedule the timer because the transaction is ongoing.
     scheduleTimer();
 
+    if (!mode_known_) {
+        mode_known_ = true;
+        framed_ = (buf_[0] == 0);
+    }
+
+    if (framed_) {
+        frame_.append(&buf_[0], bytes_transferred);
+        processFrame();
+        return;
+    }
+
     ConstElementPtr cmd;
     ConstElementPtr rsp;
 
@@ -341,16 +592,11 @@ Connection::receiveHandler(const boost::system::error_code& ec,
         // Received entire command. Parse the command into JSON.
         if (feed_.feedOk()) {
             cmd = feed_.toElement();
-            response_in_progress_ = true;
-
-            // Cancel the timer to make sure that long lasting command
-            // processing doesn't cause the timeout.
-            timeout_timer_.cancel();
 
             // If successful, then process it as a command.
-            rsp = CommandMgr::instance().processCommand(cmd);
-
-            response_in_progress_ = false;
+            if (handleCommand(cmd, rsp)) {
+                return;
+            }
 
         } else {
             // Failed to parse command as JSON or process the received command.
@@ -364,6 +610,128 @@ Connection::receiveHandler(const boost::system::error_code& ec,
         rsp = createAnswer(CONTROL_RESULT_ERROR, std::string(ex.what()));
     }
 
+    sendResponse(cmd, rsp);
+}
+
+void
+Connection::processFrame() {
+    if (frame_.size() < FRAME_HEADER_SIZE) {
+        doReceive();
+        return;
+    }
+
+    size_t length = 0;
+    for (size_t i = 0; i < FRAME_HEADER_SIZE; ++i) {
+        length = (length << 8) | static_cast<uint8_t>(frame_[i]);
+    }
+
+    ConstElementPtr cmd;
+    ConstElementPtr rsp;
+
+    if (length > MAX_FRAME_SIZE) {
+        std::stringstream os;
+        os << "framed command of " << length << " bytes exceeds the maximum of "
+           << MAX_FRAME_SIZE << " bytes";
+        LOG_WARN(command_logger, COMMAND_PROCESS_ERROR1).arg(os.str());
+        rsp = createAnswer(CONTROL_RESULT_ERROR, os.str());
+        frame_.clear();
+        close_after_response_ = true;
+        sendResponse(cmd, rsp);
+        return;
+    }
+
+    if (frame_.size() < FRAME_HEADER_SIZE + length) {
+        doReceive();
+        return;
+    }
+
+    std::string text = frame_.substr(FRAME_HEADER_SIZE, length);
+    frame_.erase(0, FRAME_HEADER_SIZE + length);
+
+    try {
+        cmd = Element::fromJSON(text);
+        if (handleCommand(cmd, rsp)) {
+            return;
+        }
+
+    } catch (const Exception& ex) {
+        LOG_WARN(command_logger, COMMAND_PROCESS_ERROR1).arg(ex.what());
+        rsp = createAnswer(CONTROL_RESULT_ERROR, std::string(ex.what()));
+    }
+
+    sendResponse(cmd, rsp);
+}
+
+bool
+Connection::handleCommand(const ConstElementPtr& cmd, ConstElementPtr& rsp) {
+    response_in_progress_ = true;
+
+    // Cancel the timer to make sure that long lasting command
+    // processing doesn't cause the timeout.
+    timeout_timer_.cancel();
+
+    // Read-only commands are processed by the executor threads,
+    // if any, so they don't stall the main thread.
+    if (executor_.accepts(cmd)) {
+        executor_.add(std::bind(&Connection::executeCommand,
+                                shared_from_this(), cmd));
+        return (true);
+    }
+
+    try {
+        rsp = CommandMgr::instance().processCommand(cmd);
+    } catch (...) {
+        response_in_progress_ = false;
+        throw;
+    }
+
+    response_in_progress_ = false;
+    return (false);
+}
+
+void
+Connection::setResponse(const std::string& text) {
+    response_.clear();
+    if (framed_) {
+        uint32_t length = static_cast<uint32_t>(text.size());
+        response_.reserve(FRAME_HEADER_SIZE + text.size());
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            response_.push_back(static_cast<char>((length >> shift) & 0xff));
+        }
+    }
+    response_.append(text);
+    response_sent_ = 0;
+}
+
+void
+Connection::executeCommand(const ConstElementPtr& cmd) {
+    ConstElementPtr rsp;
+    try {
+        rsp = CommandMgr::instance().processCommand(cmd);
+    } catch (const Exception& ex) {
+        LOG_WARN(command_logger, COMMAND_PROCESS_ERROR1).arg(ex.what());
+        rsp = createAnswer(CONTROL_RESULT_ERROR, std::string(ex.what()));
+    }
+
+    // Wake up the main thread before posting the response so the watch
+    // socket is not marked after the main thread has closed it.
+    try {
+        watch_socket_->markReady();
+
+    } catch (const std::exception& ex) {
+        LOG_ERROR(command_logger, COMMAND_WATCH_SOCKET_MARK_READY_ERROR)
+            .arg(ex.what());
+    }
+
+    ConnectionPtr self = shared_from_this();
+    io_service_->post([self, cmd, rsp]() {
+        self->response_in_progress_ = false;
+        self->sendResponse(cmd, rsp);
+    });
+}
+
+void
+Connection::sendResponse(const ConstElementPtr& cmd, ConstElementPtr rsp) {
     // No response generated. Connection will be closed.
     if (!rsp) {
         LOG_WARN(command_logger, COMMAND_RESPONSE_ERROR)
@@ -379,7 +747,7 @@ Connection::receiveHandler(const boost::system::error_code& ec,
 
         // Let's convert JSON response to text. Note that at this stage
         // the rsp pointer is always set.
-        response_ = rsp->str();
+        setResponse(rsp->str());
 
         doSend();
         return;
@@ -415,20 +783,30 @@ Connection::sendHandler(const boost::system::error_code& ec,
         scheduleTimer();
 
         // No error. We are in a process of sending a response. Need to
-        // remove the chunk that we have managed to sent with the previous
+        // skip the chunk that we have managed to sent with the previous
         // attempt.
-        response_.erase(0, bytes_transferred);
+        response_sent_ += bytes_transferred;
+        if (response_sent_ > response_.size()) {
+            response_sent_ = response_.size();
+        }
 
         LOG_DEBUG(command_logger, DBG_COMMAND, COMMAND_SOCKET_WRITE)
-            .arg(bytes_transferred).arg(response_.size())
+            .arg(bytes_transferred).arg(response_.size() - response_sent_)
             .arg(socket_->getNative());
 
         // Check if there is any data left to be sent and sent it.
-        if (!response_.empty()) {
+        if (response_sent_ < response_.size()) {
             doSend();
             return;
         }
 
+        // In the framed mode the connection stays open for the next
+        // command.
+        if (framed_ && !close_after_response_) {
+            processFrame();
+            return;
+        }
+
         // Gracefully shutdown the connection and close the socket if
         // we have sent the whole response.
         terminate();
@@ -452,15 +830,23 @@ Connection::timeoutHandler() {
             .arg(ex.what());
     }
 
+    // An idle framed connection is closed by the handler of the
+    // canceled receive.
+    if (framed_ && frame_.empty()) {
+        return;
+    }
+
     std::stringstream os;
     os << "Connection over control channel timed out";
-    if (!feed_.getProcessedText().empty()) {
+    if (partialSize() > 0) {
         os << ", discarded partial command of "
-           << feed_.getProcessedText().size() << " bytes";
+           << partialSize() << " bytes";
     }
 
     ConstElementPtr rsp = createAnswer(CONTROL_RESULT_ERROR, os.str());
-    response_ = rsp->str();
+    frame_.clear();
+    close_after_response_ = true;
+    setResponse(rsp->str());
     doSend();
 }
 
@@ -477,7 +863,8 @@ public:
     /// @brief Constructor.
     CommandMgrImpl()
         : io_service_(), acceptor_(), socket_(), socket_name_(),
-          connection_pool_(), timeout_(TIMEOUT_DHCP_SERVER_RECEIVE_COMMAND) {
+          connection_pool_(), executor_(),
+          timeout_(TIMEOUT_DHCP_SERVER_RECEIVE_COMMAND) {
     }
 
     /// @brief Opens acceptor service allowing the control clients to connect.
@@ -513,6 +900,9 @@ public:
     /// @brief Pool of connections.
     ConnectionPool connection_pool_;
 
+    /// @brief Executor of the read-only commands.
+    CommandExecutor executor_;
+
     /// @brief Connection timeout
     long timeout_;
 };
@@ -600,6 +990,7 @@ CommandMgrImpl::doAccept() {
             // New connection is arriving. Start asynchronous transmission.
             ConnectionPtr connection(new Connection(io_service_, socket_,
                                                     connection_pool_,
+                                                    executor_,
                                                     timeout_));
             connection_pool_.start(connection);
 
@@ -662,6 +1053,31 @@ CommandMgr::setConnectionTimeout(const long timeout) {
     impl_->timeout_ = timeout;
 }
 
+void
+CommandMgr::addReadOnlyCommand(const std::string& cmd_name) {
+    impl_->executor_.addReadOnly(cmd_name);
+}
+
+bool
+CommandMgr::isReadOnlyCommand(const std::string& cmd_name) const {
+    return (impl_->executor_.isReadOnly(cmd_name));
+}
+
+void
+CommandMgr::startCommandExecutor(uint32_t thread_count) {
+    impl_->executor_.start(thread_count);
+}
+
+void
+CommandMgr::stopCommandExecutor() {
+    impl_->executor_.stop();
+}
+
+uint32_t
+CommandMgr::getCommandExecutorThreadCount() const {
+    return (impl_->executor_.getThreadCount());
+}
+
 
 }; // end of isc::config
 }; // end of isc
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2018 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -79,6 +79,46 @@ public:
     /// This method should be used only in tests.
     int getControlSocketFD();
 
+    /// @brief Declares a command as read-only.
+    ///
+    /// A read-only command does not change the server state and does not
+    /// need a @c MultiThreadingCriticalSection, e.g. config-get or
+    /// lease4-get-all. When the command executor is started and the
+    /// multi-threading mode is enabled such commands received over the
+    /// control socket are processed by the executor threads so they don't
+    /// stall the main thread.
+    ///
+    /// @param cmd_name Name of the command.
+    void addReadOnlyCommand(const std::string& cmd_name);
+
+    /// @brief Checks if a command was declared as read-only.
+    ///
+    /// @param cmd_name Name of the command.
+    /// @return true if the command is read-only.
+    bool isReadOnlyCommand(const std::string& cmd_name) const;
+
+    /// @brief Starts the threads processing the read-only commands.
+    ///
+    /// The threads are paused while a @c MultiThreadingCriticalSection
+    /// is active. A read-only command trying to enter a critical section
+    /// gets a @c MultiThreadingInvalidOperation exception. The executor
+    /// is restarted when the number of threads changes.
+    ///
+    /// @param thread_count Number of threads.
+    /// @throw InvalidParameter if the number of threads is 0.
+    void startCommandExecutor(uint32_t thread_count);
+
+    /// @brief Stops the threads processing the read-only commands.
+    ///
+    /// The read-only commands are then processed by the main thread.
+    void stopCommandExecutor();
+
+    /// @brief Returns the number of threads processing the read-only
+    /// commands.
+    ///
+    /// @return the number of threads (0 when the executor is stopped).
+    uint32_t getCommandExecutorThreadCount() const;
+
 private:
 
     /// @brief Private constructor
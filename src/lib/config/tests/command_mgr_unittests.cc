@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -17,13 +17,19 @@
 #include <hooks/hooks_manager.h>
 #include <hooks/callout_handle.h>
 #include <hooks/library_handle.h>
+#include <testutils/unix_control_client.h>
+#include <util/multi_threading_mgr.h>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
+#include <unistd.h>
 
 using namespace isc::asiolink;
 using namespace isc::config;
 using namespace isc::data;
 using namespace isc::hooks;
+using namespace isc::util;
 using namespace std;
 
 // Test class for Command Manager
@@ -568,3 +574,195 @@ TEST_F(CommandMgrTest, exclusiveOpen) {
     // Now let's close it.
     EXPECT_NO_THROW(CommandMgr::instance().closeCommandSocket());
 }
+
+// Verifies the declaration of the read-only commands and the start and stop
+// of the command executor.
+TEST_F(CommandMgrTest, commandExecutor) {
+    EXPECT_FALSE(CommandMgr::instance().isReadOnlyCommand("foo-get"));
+    CommandMgr::instance().addReadOnlyCommand("foo-get");
+    EXPECT_TRUE(CommandMgr::instance().isReadOnlyCommand("foo-get"));
+    EXPECT_FALSE(CommandMgr::instance().isReadOnlyCommand("foo-set"));
+
+    EXPECT_EQ(0, CommandMgr::instance().getCommandExecutorThreadCount());
+    EXPECT_THROW(CommandMgr::instance().startCommandExecutor(0),
+                 isc::InvalidParameter);
+    EXPECT_NO_THROW(CommandMgr::instance().startCommandExecutor(2));
+    EXPECT_EQ(2, CommandMgr::instance().getCommandExecutorThreadCount());
+    EXPECT_NO_THROW(CommandMgr::instance().startCommandExecutor(3));
+    EXPECT_EQ(3, CommandMgr::instance().getCommandExecutorThreadCount());
+    EXPECT_NO_THROW(CommandMgr::instance().stopCommandExecutor());
+    EXPECT_EQ(0, CommandMgr::instance().getCommandExecutorThreadCount());
+    EXPECT_NO_THROW(CommandMgr::instance().stopCommandExecutor());
+}
+
+/// @brief Handler reporting the thread it was invoked in.
+///
+/// @param main_id Identifier of the main thread.
+/// @return An answer telling if the handler ran in the main thread and
+/// if it was denied a critical section.
+ConstElementPtr
+threadHandler(std::thread::id main_id) {
+    ElementPtr args = Element::createMap();
+    args->set("main", Element::create(std::this_thread::get_id() == main_id));
+    bool denied = false;
+    try {
+        MultiThreadingCriticalSection cs;
+    } catch (const isc::MultiThreadingInvalidOperation&) {
+        denied = true;
+    }
+    args->set("critical-section-denied", Element::create(denied));
+    return (createAnswer(CONTROL_RESULT_SUCCESS, args));
+}
+
+// Verifies that the read-only commands received over the control socket are
+// processed by the command executor in multi-threading mode.
+TEST_F(CommandMgrTest, executeReadOnlyCommand) {
+    ElementPtr socket_info = Element::createMap();
+    socket_info->set("socket-type", Element::create("unix"));
+    socket_info->set("socket-name", Element::create(getSocketPath()));
+    ASSERT_NO_THROW(CommandMgr::instance().openCommandSocket(socket_info));
+
+    std::thread::id main_id = std::this_thread::get_id();
+    CommandMgr::instance().registerCommand("thread-get",
+        std::bind(&threadHandler, main_id));
+    CommandMgr::instance().registerCommand("thread-set",
+        std::bind(&threadHandler, main_id));
+    CommandMgr::instance().addReadOnlyCommand("thread-get");
+    MultiThreadingMgr::instance().setMode(true);
+    ASSERT_NO_THROW(CommandMgr::instance().startCommandExecutor(1));
+
+    // Sends a command and returns the response.
+    auto send = [this](const std::string& command) -> std::string {
+        isc::dhcp::test::UnixControlClient client;
+        EXPECT_TRUE(client.connectToServer(getSocketPath()));
+        EXPECT_TRUE(client.sendCommand(command));
+        std::string response;
+        for (int i = 0; (i < 500) && response.empty(); ++i) {
+            io_service_->poll();
+            if (!client.getResponse(response)) {
+                usleep(10000);
+            }
+        }
+        return (response);
+    };
+
+    EXPECT_EQ("{ \"arguments\": { \"critical-section-denied\": true, "
+              "\"main\": false }, \"result\": 0 }",
+              send("{ \"command\": \"thread-get\" }"));
+    EXPECT_EQ("{ \"arguments\": { \"critical-section-denied\": false, "
+              "\"main\": true }, \"result\": 0 }",
+              send("{ \"command\": \"thread-set\" }"));
+
+    // Without multi-threading the main thread processes all commands.
+    MultiThreadingMgr::instance().setMode(false);
+    EXPECT_EQ("{ \"arguments\": { \"critical-section-denied\": false, "
+              "\"main\": true }, \"result\": 0 }",
+              send("{ \"command\": \"thread-get\" }"));
+
+    CommandMgr::instance().stopCommandExecutor();
+    CommandMgr::instance().closeCommandSocket();
+}
+
+/// @brief Returns a framed command or response.
+///
+/// @param text The JSON text.
+std::string
+frame(const std::string& text) {
+    std::string framed;
+    uint32_t length = text.size();
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        framed.push_back(static_cast<char>((length >> shift) & 0xff));
+    }
+    return (framed + text);
+}
+
+// Verifies that many framed commands are processed over one connection.
+TEST_F(CommandMgrTest, framedCommands) {
+    ElementPtr socket_info = Element::createMap();
+    socket_info->set("socket-type", Element::create("unix"));
+    socket_info->set("socket-name", Element::create(getSocketPath()));
+    ASSERT_NO_THROW(CommandMgr::instance().openCommandSocket(socket_info));
+
+    isc::dhcp::test::UnixControlClient client;
+    ASSERT_TRUE(client.connectToServer(getSocketPath()));
+
+    // Receives the given number of bytes.
+    auto receive = [this, &client](size_t size) -> std::string {
+        std::string received;
+        for (int i = 0; (i < 500) && (received.size() < size); ++i) {
+            io_service_->poll();
+            std::string response;
+            if (client.getResponse(response) && !response.empty()) {
+                received += response;
+            } else {
+                usleep(10000);
+            }
+        }
+        return (received);
+    };
+
+    // The second command is sent before the first response is received
+    // and the third one is not valid JSON.
+    std::string list = frame("{ \"command\": \"list-commands\" }");
+    ASSERT_TRUE(client.sendCommand(list + list + frame("{ \"command\"")));
+
+    std::string list_response = frame(
+        "{ \"arguments\": [ \"list-commands\" ], \"result\": 0 }");
+    EXPECT_EQ(list_response + list_response, receive(2 * list_response.size()));
+
+    // A parse error does not close the connection.
+    std::string error = receive(4);
+    ASSERT_EQ(4, error.size());
+    error = receive(static_cast<uint8_t>(error[3]));
+    EXPECT_NE(std::string::npos, error.find("\"result\": 1"));
+
+    ASSERT_TRUE(client.sendCommand(list));
+    EXPECT_EQ(list_response, receive(list_response.size()));
+
+    CommandMgr::instance().closeCommandSocket();
+}
+
+/// @brief Returns a response larger than several buffers.
+///
+/// @return An answer with a text of about 100 kB.
+ConstElementPtr
+largeHandler() {
+    std::ostringstream text;
+    for (int i = 0; text.tellp() < 100000; ++i) {
+        text << i << " ";
+    }
+    return (createAnswer(CONTROL_RESULT_SUCCESS, text.str()));
+}
+
+// Verifies that a response larger than the socket buffer is sent in
+// several chunks without losing or reordering the data.
+TEST_F(CommandMgrTest, largeResponse) {
+    ElementPtr socket_info = Element::createMap();
+    socket_info->set("socket-type", Element::create("unix"));
+    socket_info->set("socket-name", Element::create(getSocketPath()));
+    ASSERT_NO_THROW(CommandMgr::instance().openCommandSocket(socket_info));
+
+    CommandMgr::instance().registerCommand("large-get",
+        std::bind(&largeHandler));
+    const std::string expected = largeHandler()->str();
+    ASSERT_LT(3 * 32768, expected.size());
+
+    isc::dhcp::test::UnixControlClient client;
+    ASSERT_TRUE(client.connectToServer(getSocketPath()));
+    ASSERT_TRUE(client.sendCommand("{ \"command\": \"large-get\" }"));
+
+    std::string received;
+    for (int i = 0; (i < 500) && (received.size() < expected.size()); ++i) {
+        io_service_->poll();
+        std::string response;
+        if (client.getResponse(response) && !response.empty()) {
+            received += response;
+        } else {
+            usleep(10000);
+        }
+    }
+    EXPECT_EQ(expected.size(), received.size());
+    EXPECT_TRUE(expected == received);
+
+    CommandMgr::instance().closeCommandSocket();
+}
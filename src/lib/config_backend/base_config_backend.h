@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -76,6 +76,46 @@ public:
     virtual isc::db::DatabaseConnection::ParameterMap getParameters() const {
         return (isc::db::DatabaseConnection::ParameterMap());
     }
+
+    /// @brief Returns the socket notifying about configuration changes.
+    ///
+    /// Backends able to push configuration change notifications return
+    /// a socket descriptor which becomes readable when the configuration
+    /// in the database has been modified. The server watches this socket
+    /// and fetches the configuration updates when it becomes readable
+    /// rather than waiting for the next periodic poll of the audit
+    /// entries. The default implementation returns -1, i.e. the backend
+    /// only supports polling.
+    ///
+    /// @return Socket descriptor or -1 if the notifications are not
+    /// supported.
+    virtual int getChangeNotificationSocket() {
+        return (-1);
+    }
+
+    /// @brief Consumes the pending configuration change notifications.
+    ///
+    /// This is called when the socket returned by
+    /// @c getChangeNotificationSocket is readable.
+    ///
+    /// @return true if at least one configuration change was notified,
+    /// false otherwise.
+    virtual bool consumeChangeNotifications() {
+        return (false);
+    }
+
+    /// @brief Checks if the configuration can be fetched in parallel.
+    ///
+    /// Database backends return true: a new instance created with the
+    /// same parameters opens its own connection to the same database, so
+    /// several instances can fetch the configuration concurrently. The
+    /// default implementation returns false, e.g. for backends holding
+    /// their data in the instance.
+    ///
+    /// @return true if the new instances of the backend share its data.
+    virtual bool supportsParallelFetch() const {
+        return (false);
+    }
 };
 
 /// @brief Shared pointer to the @c BaseConfigBackend.
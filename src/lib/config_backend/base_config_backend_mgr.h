@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -177,6 +177,36 @@ public:
         pool_->addBackend(backend);
     }
 
+    /// @brief Creates a pool of new instances of the backends.
+    ///
+    /// The backends are created by their factories with the parameters of
+    /// the backends in the pool, so the database backends of the new pool
+    /// use their own connections. This allows for fetching the
+    /// configuration over several connections.
+    ///
+    /// @return Pointer to the new pool.
+    /// @throw db::InvalidType if a factory is no longer registered.
+    /// @throw Unexpected if a backend factory function returned NULL.
+    ConfigBackendPoolPtr createPool() const {
+        ConfigBackendPoolPtr pool(new ConfigBackendPoolType());
+        for (auto const& parameters : pool_->getAllParameters()) {
+            auto it = parameters.find("type");
+            std::string db_type = (it != parameters.end() ? it->second : "");
+            auto index = factories_.find(db_type);
+            if (index == factories_.end()) {
+                isc_throw(db::InvalidType, "The type of the configuration backend: '" <<
+                          db_type << "' is not supported");
+            }
+            auto backend = index->second(parameters);
+            if (!backend) {
+                isc_throw(Unexpected, "Config database " << db_type <<
+                          " factory returned NULL");
+            }
+            pool->addBackend(backend);
+        }
+        return (pool);
+    }
+
     /// @brief Removes all backends from the pool.
     void delAllBackends() {
         pool_->delAllBackends();
@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -16,6 +16,7 @@
 #include <functional>
 #include <list>
 #include <string>
+#include <vector>
 
 namespace isc {
 namespace cb {
@@ -111,6 +112,62 @@ public:
         return (deleted);
     }
 
+    /// @brief Returns the change notification sockets of the backends.
+    ///
+    /// @return Socket descriptors of the backends supporting the
+    /// configuration change notifications.
+    std::vector<int> getChangeNotificationSockets() {
+        std::vector<int> sockets;
+        for (auto const& backend : backends_) {
+            int socket = backend->getChangeNotificationSocket();
+            if (socket >= 0) {
+                sockets.push_back(socket);
+            }
+        }
+        return (sockets);
+    }
+
+    /// @brief Consumes the pending change notifications of all backends.
+    ///
+    /// @return true if at least one backend notified a configuration
+    /// change, false otherwise.
+    bool consumeChangeNotifications() {
+        bool changed = false;
+        for (auto const& backend : backends_) {
+            if (backend->consumeChangeNotifications()) {
+                changed = true;
+            }
+        }
+        return (changed);
+    }
+
+    /// @brief Checks if the configuration can be fetched in parallel.
+    ///
+    /// @return true if the pool is not empty and all its backends support
+    /// the parallel fetch, false otherwise.
+    bool supportsParallelFetch() const {
+        if (backends_.empty()) {
+            return (false);
+        }
+        for (auto const& backend : backends_) {
+            if (!backend->supportsParallelFetch()) {
+                return (false);
+            }
+        }
+        return (true);
+    }
+
+    /// @brief Returns the parameters of the backends.
+    ///
+    /// @return Parameters of the backends in the pool order.
+    std::vector<isc::db::DatabaseConnection::ParameterMap> getAllParameters() const {
+        std::vector<isc::db::DatabaseConnection::ParameterMap> parameters;
+        for (auto const& backend : backends_) {
+            parameters.push_back(backend->getParameters());
+        }
+        return (parameters);
+    }
+
 protected:
 
     /// @brief Retrieve a single configuration property from the pool.
@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -187,6 +187,37 @@ public:
 /// @brief Shared pointer to the @c TestConfigBackendImpl2.
 typedef boost::shared_ptr<TestConfigBackendImpl2> TestConfigBackendImpl2Ptr;
 
+/// @brief Test config backend pushing change notifications.
+class TestNotifyingConfigBackend : public TestConfigBackendImpl2 {
+public:
+
+    /// @brief Constructor.
+    TestNotifyingConfigBackend() : pending_(0) {
+    }
+
+    /// @brief Returns a fake change notification socket.
+    ///
+    /// @return Socket descriptor 42.
+    virtual int getChangeNotificationSocket() {
+        return (42);
+    }
+
+    /// @brief Consumes the pending notifications.
+    ///
+    /// @return true if there were pending notifications.
+    virtual bool consumeChangeNotifications() {
+        bool changed = (pending_ > 0);
+        pending_ = 0;
+        return (changed);
+    }
+
+    /// @brief Number of pending notifications.
+    int pending_;
+};
+
+/// @brief Shared pointer to the @c TestNotifyingConfigBackend.
+typedef boost::shared_ptr<TestNotifyingConfigBackend> TestNotifyingConfigBackendPtr;
+
 /// @brief Implements test pool of configuration backends.
 ///
 /// @c BaseConfigBackendPool template provides mechanics for managing the data
@@ -553,4 +584,30 @@ TEST_F(ConfigBackendMgrTest, unregister) {
                  NoSuchDatabase);
 }
 
+// Verify that the change notification sockets of the backends are
+// returned and their notifications consumed.
+TEST_F(ConfigBackendMgrTest, changeNotifications) {
+    addTestMySQLBackend();
+
+    // The MySQL test backend only supports polling.
+    EXPECT_TRUE(config_mgr_.getPool()->getChangeNotificationSockets().empty());
+    EXPECT_FALSE(config_mgr_.getPool()->consumeChangeNotifications());
+
+    TestNotifyingConfigBackendPtr backend(new TestNotifyingConfigBackend());
+    config_mgr_.registerBackendFactory("postgresql", [backend](const DatabaseConnection::ParameterMap&)
+                                      -> TestConfigBackendPtr {
+        return (backend);
+    });
+    config_mgr_.addBackend("type=postgresql");
+
+    std::vector<int> sockets = config_mgr_.getPool()->getChangeNotificationSockets();
+    ASSERT_EQ(1, sockets.size());
+    EXPECT_EQ(42, sockets[0]);
+
+    EXPECT_FALSE(config_mgr_.getPool()->consumeChangeNotifications());
+    backend->pending_ = 2;
+    EXPECT_TRUE(config_mgr_.getPool()->consumeChangeNotifications());
+    EXPECT_FALSE(config_mgr_.getPool()->consumeChangeNotifications());
+}
+
 }
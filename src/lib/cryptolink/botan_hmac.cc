@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -185,6 +185,19 @@ public:
         }
     }
 
+    /// @brief Reset the digest
+    ///
+    /// See @ref isc::cryptolink::HMAC::reset() for details.
+    void reset() {
+        // Botan resets the state keeping the key after the final step.
+        try {
+            static_cast<void>(hmac_->final());
+            digest_.clear();
+        } catch (const Botan::Exception& exc) {
+            isc_throw(LibraryError, "Botan error: " << exc.what());
+        }
+    }
+
 private:
     /// @brief The hash algorithm
     HashAlgorithm hash_algorithm_;
@@ -241,5 +254,10 @@ HMAC::verify(const void* sig, const size_t len) {
     return (impl_->verify(sig, len));
 }
 
+void
+HMAC::reset() {
+    impl_->reset();
+}
+
 } // namespace cryptolink
 } // namespace isc
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -129,6 +129,17 @@ public:
     /// called multiple times with different signatures.
     bool verify(const void* sig, size_t len);
 
+    /// \brief Reset the digest
+    ///
+    /// Discards the data added since the creation or the previous reset,
+    /// so the object can sign or verify another message with the same
+    /// secret. This is cheaper than creating a new object which derives
+    /// the key again.
+    ///
+    /// \exception LibraryError if there was any unexpected exception
+    ///                         in the underlying library
+    void reset();
+
 private:
     HMACImpl* impl_;
 };
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -36,7 +36,7 @@ public:
     /// @param hash_algorithm The hash algorithm
     explicit HMACImpl(const void* secret, size_t secret_len,
                       const HashAlgorithm hash_algorithm)
-        : hash_algorithm_(hash_algorithm), md_(), digest_() {
+        : hash_algorithm_(hash_algorithm), md_(), init_(), digest_() {
         const EVP_MD* algo = ossl::getHashAlgorithm(hash_algorithm);
         if (algo == 0) {
             isc_throw(UnsupportedAlgorithm,
@@ -68,6 +68,16 @@ public:
         }
 
         EVP_PKEY_free(pkey);
+
+        // Keep the keyed context to reset the digest without deriving
+        // the key again.
+        init_ = EVP_MD_CTX_new();
+        if (init_ == 0) {
+            isc_throw(LibraryError, "OpenSSL EVP_MD_CTX_new() failed");
+        }
+        if (!EVP_MD_CTX_copy_ex(init_, md_)) {
+            isc_throw(LibraryError, "OpenSSL EVP_MD_CTX_copy_ex() failed");
+        }
     }
 
     /// @brief Destructor
@@ -76,6 +86,10 @@ public:
             EVP_MD_CTX_free(md_);
         }
         md_ = 0;
+        if (init_) {
+            EVP_MD_CTX_free(init_);
+        }
+        init_ = 0;
     }
 
     /// @brief Returns the HashAlgorithm of the object
@@ -185,6 +199,16 @@ public:
         return (digest_.same(sig, len));
     }
 
+    /// @brief Reset the digest
+    ///
+    /// See @ref isc::cryptolink::HMAC::reset() for details.
+    void reset() {
+        if (!EVP_MD_CTX_copy_ex(md_, init_)) {
+            isc_throw(LibraryError, "OpenSSL EVP_MD_CTX_copy_ex() failed");
+        }
+        digest_.clear();
+    }
+
 private:
     /// @brief The hash algorithm
     HashAlgorithm hash_algorithm_;
@@ -192,6 +216,9 @@ private:
     /// @brief The protected pointer to the OpenSSL EVP_MD_CTX structure
     EVP_MD_CTX* md_;
 
+    /// @brief The keyed initial context
+    EVP_MD_CTX* init_;
+
     /// @brief The digest cache for multiple verify
     ossl::SecBuf<unsigned char> digest_;
 };
@@ -241,5 +268,10 @@ HMAC::verify(const void* sig, const size_t len) {
     return (impl_->verify(sig, len));
 }
 
+void
+HMAC::reset() {
+    impl_->reset();
+}
+
 } // namespace cryptolink
 } // namespace isc
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -692,6 +692,36 @@ TEST(HMACTest, HMACSigLengthArgument) {
     EXPECT_EQ(32, sigBufferLength(SHA256, 3200));
 }
 
+// Checks that a reset HMAC signs and verifies as a new one.
+TEST(HMACTest, reset) {
+    CryptoLink& crypto = CryptoLink::getCryptoLink();
+    boost::shared_ptr<HMAC> hmac(crypto.createHMAC("secret", 6, SHA256),
+                                 deleteHMAC);
+    hmac->update("some data", 9);
+    const std::vector<uint8_t> sig = hmac->sign(32);
+
+    // Reset after a sign.
+    ASSERT_NO_THROW(hmac->reset());
+    hmac->update("some data", 9);
+    EXPECT_TRUE(sig == hmac->sign(32));
+
+    // Reset after some data.
+    ASSERT_NO_THROW(hmac->reset());
+    hmac->update("other data", 10);
+    ASSERT_NO_THROW(hmac->reset());
+    hmac->update("some data", 9);
+    EXPECT_TRUE(hmac->verify(&sig[0], sig.size()));
+
+    // Reset after a verify.
+    ASSERT_NO_THROW(hmac->reset());
+    hmac->update("other data", 10);
+    EXPECT_FALSE(hmac->verify(&sig[0], sig.size()));
+    ASSERT_NO_THROW(hmac->reset());
+    hmac->update("some ", 5);
+    hmac->update("data", 4);
+    EXPECT_TRUE(hmac->verify(&sig[0], sig.size()));
+}
+
 // Error cases (not only BadKey)
 TEST(HMACTest, BadKey) {
     OutputBuffer data_buf(0);
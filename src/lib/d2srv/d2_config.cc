@@ -14,6 +14,7 @@
 
 #include <boost/foreach.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 
 #include <sstream>
@@ -66,7 +67,8 @@ D2Params::validateContents() {
                   "D2Params: DNS server timeout must be larger than 0");
     }
 
-    if (ncr_format_ != dhcp_ddns::FMT_JSON) {
+    if ((ncr_format_ != dhcp_ddns::FMT_JSON) &&
+        (ncr_format_ != dhcp_ddns::FMT_BINARY)) {
         isc_throw(D2CfgError, "D2Params: NCR Format:"
                   << dhcp_ddns::ncrFormatToString(ncr_format_)
                   << " is not yet supported");
@@ -297,7 +299,7 @@ DdnsDomain::toElement() const {
 const char* DdnsDomainListMgr::wildcard_domain_name_ = "*";
 
 DdnsDomainListMgr::DdnsDomainListMgr(const std::string& name) : name_(name),
-    domains_(new DdnsDomainMap()) {
+    domains_(new DdnsDomainMap()), index_() {
 }
 
 
@@ -320,6 +322,15 @@ DdnsDomainListMgr::setDomains(DdnsDomainMapPtr domains) {
     if (gotit != domains_->end()) {
             wildcard_domain_ = gotit->second;
     }
+
+    // Index the domains by lower case name. When names differ only by
+    // the case the first one in the map order is kept.
+    index_.clear();
+    index_.reserve(domains_->size());
+    for (auto const& map_pair : *domains_) {
+        index_.emplace(boost::algorithm::to_lower_copy(map_pair.first),
+                       map_pair.second);
+    }
 }
 
 bool
@@ -330,44 +341,19 @@ DdnsDomainListMgr::matchDomain(const std::string& fqdn, DdnsDomainPtr& domain) {
         return (true);
     }
 
-    // Iterate over the domain map looking for the domain which matches
-    // the longest portion of the given fqdn.
-
-    size_t req_len = fqdn.size();
-    size_t match_len = 0;
-    DdnsDomainMapPair map_pair;
+    // Look for the fqdn then for its suffixes starting at a label
+    // boundary, longest first. This prevents "onetwo.net" from matching
+    // "two.net".
+    const std::string name = boost::algorithm::to_lower_copy(fqdn);
     DdnsDomainPtr best_match;
-    BOOST_FOREACH (map_pair, *domains_) {
-        std::string domain_name = map_pair.first;
-        size_t dom_len = domain_name.size();
-
-        // If the domain name is longer than the fqdn, then it cant be match.
-        if (req_len < dom_len) {
+    for (size_t offset = 0; offset <= name.size(); ++offset) {
+        if ((offset > 0) && (name[offset - 1] != '.')) {
             continue;
         }
-
-        // If the lengths are identical and the names match we're done.
-        if (req_len == dom_len) {
-            if (boost::iequals(fqdn, domain_name)) {
-                // exact match, done
-                domain = map_pair.second;
-                return (true);
-            }
-        } else {
-            // The fqdn is longer than the domain name.  Adjust the start
-            // point of comparison by the excess in length.  Only do the
-            // comparison if the adjustment lands on a boundary. This
-            // prevents "onetwo.net" from matching "two.net".
-            size_t offset = req_len - dom_len;
-            if ((fqdn[offset - 1] == '.')  &&
-               (boost::iequals(fqdn.substr(offset), domain_name))) {
-                // Fqdn contains domain name, keep it if its better than
-                // any we have matched so far.
-                if (dom_len > match_len) {
-                    match_len = dom_len;
-                    best_match = map_pair.second;
-                }
-            }
+        auto found = index_.find(name.substr(offset));
+        if (found != index_.end()) {
+            best_match = found->second;
+            break;
         }
     }
 
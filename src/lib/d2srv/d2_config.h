@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -21,6 +21,7 @@
 
 #include <stdint.h>
 #include <string>
+#include <unordered_map>
 
 namespace isc {
 namespace d2 {
@@ -156,7 +157,7 @@ public:
     /// -# port is 0
     /// -# dns_server_timeout is < 1
     /// -# ncr_protocol is invalid, currently only NCR_UDP is supported
-    /// -# ncr_format is invalid, currently only FMT_JSON is supported
+    /// -# ncr_format is invalid, currently FMT_JSON and FMT_BINARY are supported
     D2Params(const isc::asiolink::IOAddress& ip_address,
                    const size_t port,
                    const size_t dns_server_timeout,
@@ -242,7 +243,7 @@ private:
     dhcp_ddns::NameChangeProtocol ncr_protocol_;
 
     /// @brief Format of the inbound requests (NCRs).
-    /// Currently only JSON format is supported.
+    /// Currently JSON and BINARY formats are supported.
     dhcp_ddns::NameChangeFormat ncr_format_;
 };
 
@@ -620,6 +621,10 @@ typedef std::pair<std::string, DdnsDomainPtr> DdnsDomainMapPair;
 /// @brief Defines a pointer to DdnsDomain storage containers.
 typedef boost::shared_ptr<DdnsDomainMap> DdnsDomainMapPtr;
 
+/// @brief Defines an index of DdnsDomains, keyed by the lower case
+/// domain name.
+typedef std::unordered_map<std::string, DdnsDomainPtr> DdnsDomainIndex;
+
 /// @brief Provides storage for and management of a list of DNS domains.
 /// In addition to housing the domain list storage, it provides domain matching
 /// services.  These services are used to match a FQDN to a domain.  Currently
@@ -648,7 +653,9 @@ public:
     /// scheme.
     ///
     /// Given a FQDN, search the list of domains, successively removing a
-    /// sub-domain from the FQDN until a match is found.  If no match is found
+    /// sub-domain from the FQDN until a match is found.  Each candidate is
+    /// looked up in an index so the cost depends on the number of labels
+    /// of the FQDN, not on the number of domains.  If no match is found
     /// and the wild card domain is present in the list, then return it as the
     /// match.  If the wild card domain is the only domain in the list, then
     /// it will be returned immediately for any FQDN.
@@ -695,7 +702,9 @@ public:
 
     /// @brief Sets the manger's domain list to the given list of domains.
     /// This method will scan the inbound list for the wild card domain and
-    /// set the internal wild card domain pointer accordingly.
+    /// set the internal wild card domain pointer accordingly.  It also
+    /// builds the index used by @ref matchDomain so the list must not be
+    /// changed afterwards.
     void setDomains(DdnsDomainMapPtr domains);
 
     /// @brief Unparse a configuration object
@@ -712,6 +721,9 @@ private:
 
     /// @brief Pointer to the wild card domain.
     DdnsDomainPtr wildcard_domain_;
+
+    /// @brief Index of the domains used by the matches.
+    DdnsDomainIndex index_;
 };
 
 /// @brief Defines a pointer for DdnsDomain instances.
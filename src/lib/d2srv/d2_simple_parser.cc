@@ -258,7 +258,8 @@ void D2SimpleParser::parse(const D2CfgContextPtr& ctx,
     }
 
     ncr_format = getFormat(config, "ncr-format");
-    if (ncr_format != dhcp_ddns::FMT_JSON) {
+    if ((ncr_format != dhcp_ddns::FMT_JSON) &&
+        (ncr_format != dhcp_ddns::FMT_BINARY)) {
         isc_throw(D2CfgError, "NCR Format:"
                   << dhcp_ddns::ncrFormatToString(ncr_format)
                   << " is not yet supported"
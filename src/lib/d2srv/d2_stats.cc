@@ -1,4 +1,4 @@
-// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -21,7 +21,9 @@ const list<string>
 D2Stats::ncr = {
     "ncr-received",
     "ncr-invalid",
-    "ncr-error"
+    "ncr-error",
+    "ncr-coalesced",
+    "ncr-queue-size"
 };
 
 const list<string>
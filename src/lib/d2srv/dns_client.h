@@ -37,13 +37,14 @@ class DNSClientImpl;
 /// encapsulate DNS response, through class constructor. An exception will be
 /// thrown if the pointer is not initialized by the caller.
 ///
-/// @todo Ultimately, this class will support both TCP and UDP Transport.
-/// Currently only UDP is supported and can be specified as a preferred
-/// protocol. @c DNSClient constructor will throw an exception if TCP is
-/// specified. Once both protocols are supported, the @c DNSClient logic will
-/// try to obey caller's preference. However, it may use the other protocol if
-/// on its own discretion, when there is a legitimate reason to do so. For
-/// example, if communication with the server using preferred protocol fails.
+/// Both UDP and TCP are supported and can be specified as a preferred
+/// protocol. Over TCP each message exchange opens its own connection and
+/// the message is preceded by the two byte length field (RFC 1035,
+/// section 4.2.2), which lifts the 512 bytes limit of the UDP messages.
+///
+/// @todo The @c DNSClient logic could use the other protocol on its own
+/// discretion, when there is a legitimate reason to do so. For example,
+/// if communication with the server using preferred protocol fails.
 class DNSClient {
 public:
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,7 +15,10 @@
 #include <d2srv/testutils/stats_test_utils.h>
 #include <dns/messagerenderer.h>
 
+#include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ip/udp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
 #include <boost/asio/socket_base.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <functional>
@@ -300,12 +303,7 @@ public:
     /// callback object is NULL.
     void runConstructorTest() {
         EXPECT_NO_THROW(DNSClient(response_, NULL, DNSClient::UDP));
-
-        // The TCP Transport is not supported right now. So, we return exception
-        // if caller specified TCP as a preferred protocol. This test will be
-        // removed once TCP is supported.
-        EXPECT_THROW(DNSClient(response_, NULL, DNSClient::TCP),
-                     isc::NotImplemented);
+        EXPECT_NO_THROW(DNSClient(response_, NULL, DNSClient::TCP));
     }
 
     /// @brief This test verifies that it accepted timeout values belong to the
@@ -448,6 +446,74 @@ public:
         service_.get_io_service().reset();
     }
 
+    /// @brief Handler invoked when the length of a TCP request is received
+    ///
+    /// This callback handler reads the request which length is in the
+    /// first two bytes of the receive buffer and sends back the response
+    /// preceded by its length.
+    ///
+    /// @param socket A pointer to a connected socket used to receive the
+    /// request and send the response.
+    void tcpLengthHandler(tcp::socket* socket) {
+        size_t length = (receive_buffer_[0] << 8) | receive_buffer_[1];
+        ASSERT_LE(length, sizeof(receive_buffer_));
+        boost::system::error_code ec;
+        boost::asio::read(*socket, boost::asio::buffer(receive_buffer_, length),
+                          ec);
+        ASSERT_FALSE(ec);
+
+        // Copy the request and set the QR bit as in udpReceiveHandler.
+        OutputBuffer response_buf(length + 2);
+        response_buf.writeUint16(length);
+        response_buf.writeData(receive_buffer_, length);
+        response_buf.writeUint8At(0xA8, 4);
+        boost::asio::write(*socket, boost::asio::buffer(response_buf.getData(),
+                                                        response_buf.getLength()),
+                           ec);
+        ASSERT_FALSE(ec);
+    }
+
+    /// @brief This test verifies that DNSClient can send DNS Update and receive
+    /// a corresponding response from a server over TCP.
+    void runSendReceiveTcpTest() {
+        // Create a request DNS Update message.
+        D2UpdateMessage message(D2UpdateMessage::OUTBOUND);
+        ASSERT_NO_THROW(message.setRcode(Rcode(Rcode::NOERROR_CODE)));
+        ASSERT_NO_THROW(message.setZone(Name("example.com"), RRClass::IN()));
+
+        // Emulate the server: accept the connection, read the length of the
+        // request and continue in tcpLengthHandler.
+        tcp::acceptor acceptor(service_.get_io_service(),
+                               tcp::endpoint(address::from_string(TEST_ADDRESS),
+                                             TEST_PORT), true);
+        tcp::socket server_socket(service_.get_io_service());
+        acceptor.async_accept(server_socket,
+                              [this, &server_socket]
+                              (const boost::system::error_code& ec) {
+            ASSERT_FALSE(ec);
+            boost::asio::async_read(server_socket,
+                                    boost::asio::buffer(receive_buffer_, 2),
+                                    [this, &server_socket]
+                                    (const boost::system::error_code& ec,
+                                     size_t) {
+                ASSERT_FALSE(ec);
+                tcpLengthHandler(&server_socket);
+            });
+        });
+
+        DNSClientPtr tcp_client(new DNSClient(response_, this, DNSClient::TCP));
+        const int timeout = 500;
+        expected_++;
+        tcp_client->doUpdate(service_, IOAddress(TEST_ADDRESS), TEST_PORT,
+                             message, timeout);
+
+        service_.run();
+
+        server_socket.close();
+        acceptor.close();
+        service_.get_io_service().reset();
+    }
+
     /// @brief Performs a single request-response exchange with or without TSIG.
     ///
     /// @param client_key TSIG passed to dns_client and also used by the
@@ -619,6 +685,21 @@ TEST_F(DNSClientTest, sendReceive) {
     checkStats(stats_upd);
 }
 
+// Verify that the DNSClient receives the response from DNS over TCP.
+TEST_F(DNSClientTest, sendReceiveTcp) {
+    runSendReceiveTcpTest();
+    EXPECT_EQ(1, received_);
+    StatMap stats_upd = {
+        { "update-sent", 1},
+        { "update-signed", 0},
+        { "update-unsigned", 1},
+        { "update-success", 1},
+        { "update-timeout", 0},
+        { "update-error", 0}
+    };
+    checkStats(stats_upd);
+}
+
 // Verify that the DNSClient reports an error when the response is received from
 // a DNS and this response is corrupted.
 TEST_F(DNSClientTest, sendReceiveCorrupted) {
@@ -26,6 +26,8 @@ namespace db {
 
 const time_t DatabaseConnection::MAX_DB_TIME = 2147483647;
 
+const time_t DatabaseConnection::REPLICA_RETRY_INTERVAL = 10;
+
 std::string
 DatabaseConnection::getParameter(const std::string& name) const {
     ParameterMap::const_iterator param = parameters_.find(name);
@@ -129,6 +131,39 @@ DatabaseConnection::redactedAccessString(const ParameterMap& parameters) {
     return (access);
 }
 
+DatabaseConnection::ParameterMap
+DatabaseConnection::getReplicaParameters(const ParameterMap& parameters) {
+    ParameterMap replica;
+    auto host = parameters.find("replica-host");
+    if ((host == parameters.end()) || host->second.empty()) {
+        return (replica);
+    }
+    replica = parameters;
+    replica["host"] = host->second;
+    auto port = parameters.find("replica-port");
+    if (port != parameters.end()) {
+        replica["port"] = port->second;
+    }
+    replica.erase("replica-host");
+    replica.erase("replica-port");
+    replica.erase("replica-max-lag");
+    return (replica);
+}
+
+uint32_t
+DatabaseConnection::getReplicaMaxLag(const ParameterMap& parameters) {
+    auto param = parameters.find("replica-max-lag");
+    if (param == parameters.end()) {
+        return (0);
+    }
+    try {
+        return (boost::lexical_cast<uint32_t>(param->second));
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(BadValue, "invalid value of the replica-max-lag "
+                  << param->second << " specified");
+    }
+}
+
 bool
 DatabaseConnection::configuredReadOnly() const {
     std::string readonly_value = "false";
@@ -231,6 +266,8 @@ DatabaseConnection::toElement(const ParameterMap& params) {
             (keyword == "reconnect-wait-time") ||
             (keyword == "max-reconnect-tries") ||
             (keyword == "port") ||
+            (keyword == "replica-port") ||
+            (keyword == "replica-max-lag") ||
             (keyword == "max-row-errors")) {
             // integer parameters
             int64_t int_value;
@@ -255,6 +292,7 @@ DatabaseConnection::toElement(const ParameterMap& params) {
                    (keyword == "user") ||
                    (keyword == "password") ||
                    (keyword == "host") ||
+                   (keyword == "replica-host") ||
                    (keyword == "name") ||
                    (keyword == "on-fail") ||
                    (keyword == "trust-anchor") ||
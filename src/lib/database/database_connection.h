@@ -120,6 +120,10 @@ public:
     /// If I'm still alive I'll be too old to care. You fix it.
     static const time_t MAX_DB_TIME;
 
+    /// @brief Delay in seconds before a read replica is used again after
+    /// a failure to connect to it or to check its replication lag.
+    static const time_t REPLICA_RETRY_INTERVAL;
+
     /// @brief Database configuration parameter map
     typedef std::map<std::string, std::string> ParameterMap;
 
@@ -177,6 +181,28 @@ public:
     /// @return Redacted database access string.
     static std::string redactedAccessString(const ParameterMap& parameters);
 
+    /// @brief Returns the access parameters of the read replica.
+    ///
+    /// The read replica is configured with the "replica-host" and the
+    /// optional "replica-port" parameters. The returned parameters are
+    /// a copy of the primary ones with the host and the port replaced
+    /// and without the replica specific parameters.
+    ///
+    /// @param parameters Database access parameters of the primary.
+    ///
+    /// @return The replica access parameters or an empty map when no
+    /// read replica is configured.
+    static ParameterMap getReplicaParameters(const ParameterMap& parameters);
+
+    /// @brief Returns the replication lag tolerated for the read replica.
+    ///
+    /// @param parameters Database access parameters.
+    ///
+    /// @return The "replica-max-lag" value in seconds, 0 when the lag
+    /// of the replica is not checked.
+    /// @throw BadValue if the value is not a valid number.
+    static uint32_t getReplicaMaxLag(const ParameterMap& parameters);
+
     /// @brief Convenience method checking if database should be opened with
     /// read only access.
     ///
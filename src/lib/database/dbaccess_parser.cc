@@ -15,6 +15,7 @@
 #include <map>
 #include <string>
 #include <utility>
+#include <vector>
 
 using namespace std;
 using namespace isc::data;
@@ -24,8 +25,8 @@ namespace db {
 
 
 // Factory function to build the parser
-DbAccessParser::DbAccessParser()
-    : values_() {
+DbAccessParser::DbAccessParser(DBType db_type)
+    : db_type_(db_type), values_() {
 }
 
 // Parse the configuration and check that the various keywords are consistent.
@@ -48,20 +49,41 @@ DbAccessParser::parse(std::string& access_string,
     DatabaseConnection::ParameterMap values_copy = values_;
 
     int64_t lfc_interval = 0;
+    int64_t lfc_max_leases = 0;
     int64_t connect_timeout = 0;
     int64_t read_timeout = 0;
     int64_t write_timeout = 0;
     int64_t tcp_user_timeout = 0;
     int64_t port = 0;
+    int64_t replica_port = 0;
+    int64_t replica_max_lag = 0;
     int64_t max_reconnect_tries = 0;
     int64_t reconnect_wait_time = 0;
     int64_t max_row_errors = 0;
+    int64_t load_threads = 0;
+    int64_t async_threads = 0;
+    int64_t pool_size = 0;
+    int64_t writer_threads = 0;
+    int64_t fsync_records = 0;
+    int64_t write_behind_queue_size = 1;
+    int64_t cache_size = 0;
+    int64_t cache_ttl = 0;
+    int64_t global_hosts_refresh = 0;
+    int64_t map_size = 0;
 
     // 2. Update the copy with the passed keywords.
     for (std::pair<std::string, ConstElementPtr> param : database_config->mapValue()) {
         try {
             if ((param.first == "persist") ||
-                (param.first == "readonly")) {
+                (param.first == "readonly") ||
+                (param.first == "write-behind") ||
+                (param.first == "lease-snapshot") ||
+                (param.first == "pipeline") ||
+                (param.first == "single-query-allocation") ||
+                (param.first == "in-memory-limits") ||
+                (param.first == "in-memory-stats") ||
+                (param.first == "cache-negative") ||
+                (param.first == "global-hosts-in-memory")) {
                 values_copy[param.first] = (param.second->boolValue() ?
                                             "true" : "false");
 
@@ -70,6 +92,11 @@ DbAccessParser::parse(std::string& access_string,
                 values_copy[param.first] =
                     boost::lexical_cast<std::string>(lfc_interval);
 
+            } else if (param.first == "lfc-max-leases") {
+                lfc_max_leases = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(lfc_max_leases);
+
             } else if (param.first == "connect-timeout") {
                 connect_timeout = param.second->intValue();
                 values_copy[param.first] =
@@ -105,10 +132,70 @@ DbAccessParser::parse(std::string& access_string,
                 values_copy[param.first] =
                     boost::lexical_cast<std::string>(port);
 
+            } else if (param.first == "replica-port") {
+                replica_port = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(replica_port);
+
+            } else if (param.first == "replica-max-lag") {
+                replica_max_lag = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(replica_max_lag);
+
             } else if (param.first == "max-row-errors") {
                 max_row_errors = param.second->intValue();
                 values_copy[param.first] =
                     boost::lexical_cast<std::string>(max_row_errors);
+
+            } else if (param.first == "load-threads") {
+                load_threads = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(load_threads);
+
+            } else if (param.first == "async-threads") {
+                async_threads = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(async_threads);
+
+            } else if (param.first == "pool-size") {
+                pool_size = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(pool_size);
+
+            } else if (param.first == "writer-threads") {
+                writer_threads = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(writer_threads);
+
+            } else if (param.first == "fsync-records") {
+                fsync_records = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(fsync_records);
+
+            } else if (param.first == "write-behind-queue-size") {
+                write_behind_queue_size = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(write_behind_queue_size);
+
+            } else if (param.first == "cache-size") {
+                cache_size = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(cache_size);
+
+            } else if (param.first == "cache-ttl") {
+                cache_ttl = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(cache_ttl);
+
+            } else if (param.first == "global-hosts-refresh") {
+                global_hosts_refresh = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(global_hosts_refresh);
+
+            } else if (param.first == "map-size") {
+                map_size = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(map_size);
             } else {
 
                 // all remaining string parameters
@@ -116,12 +203,15 @@ DbAccessParser::parse(std::string& access_string,
                 // user
                 // password
                 // host
+                // replica-host
                 // name
                 // on-fail
                 // trust-anchor
                 // cert-file
                 // key-file
                 // cipher-list
+                // lease-file-format
+                // lfc-mode
                 values_copy[param.first] = param.second->stringValue();
             }
         } catch (const isc::data::TypeError& ex) {
@@ -134,6 +224,38 @@ DbAccessParser::parse(std::string& access_string,
 
     // 3. Perform validation checks on the updated set of keyword/values.
     //
+    // Check that the lease and host database parameters are used only in
+    // the database they apply to.
+    static const std::vector<std::string> lease_keywords = {
+        "lfc-max-leases", "lfc-mode", "load-threads", "lease-file-format",
+        "fsync-records", "write-behind", "write-behind-queue-size",
+        "lease-snapshot", "pipeline", "async-threads", "pool-size",
+        "writer-threads", "single-query-allocation", "in-memory-limits",
+        "in-memory-stats", "map-size"
+    };
+    static const std::vector<std::string> host_keywords = {
+        "cache-size", "cache-ttl", "cache-negative", "global-hosts-in-memory",
+        "global-hosts-refresh"
+    };
+    if (db_type_ != ANY_DB) {
+        for (auto const& keyword : lease_keywords) {
+            ConstElementPtr value = database_config->get(keyword);
+            if (value && (db_type_ != LEASE_DB)) {
+                isc_throw(DbConfigError, keyword << " is only supported by"
+                          << " the lease database (" << value->getPosition()
+                          << ")");
+            }
+        }
+        for (auto const& keyword : host_keywords) {
+            ConstElementPtr value = database_config->get(keyword);
+            if (value && (db_type_ != HOSTS_DB)) {
+                isc_throw(DbConfigError, keyword << " is only supported by"
+                          << " the hosts database (" << value->getPosition()
+                          << ")");
+            }
+        }
+    }
+
     // a. Check if the "type" keyword exists and thrown an exception if not.
     auto type_ptr = values_copy.find("type");
     if (type_ptr == values_copy.end()) {
@@ -150,7 +272,8 @@ DbAccessParser::parse(std::string& access_string,
     string dbtype = type_ptr->second;
     if ((dbtype != "memfile") &&
         (dbtype != "mysql") &&
-        (dbtype != "postgresql")) {
+        (dbtype != "postgresql") &&
+        (dbtype != "lmdb")) {
         ConstElementPtr value = database_config->get("type");
         isc_throw(DbConfigError, "unknown backend database type: " << dbtype
                   << " (" << value->getPosition() << ")");
@@ -166,6 +289,16 @@ DbAccessParser::parse(std::string& access_string,
                   << " (" << value->getPosition() << ")");
     }
 
+    // Check that the lfc-max-leases is within a reasonable range.
+    if ((lfc_max_leases < 0) ||
+        (lfc_max_leases > std::numeric_limits<uint32_t>::max())) {
+        ConstElementPtr value = database_config->get("lfc-max-leases");
+        isc_throw(DbConfigError, "lfc-max-leases value: " << lfc_max_leases
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint32_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
     // d. Check that the timeouts are within a reasonable range.
     if ((connect_timeout < 0) ||
         (connect_timeout > std::numeric_limits<uint32_t>::max())) {
@@ -235,6 +368,255 @@ DbAccessParser::parse(std::string& access_string,
                   << " (" << value->getPosition() << ")");
     }
 
+    // Check that the load-threads is within a reasonable range.
+    if ((load_threads < 0) ||
+        (load_threads > std::numeric_limits<uint16_t>::max())) {
+        ConstElementPtr value = database_config->get("load-threads");
+        isc_throw(DbConfigError, "load-threads value: " << load_threads
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint16_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the replica-port is within a reasonable range.
+    if ((replica_port < 0) ||
+        (replica_port > std::numeric_limits<uint16_t>::max())) {
+        ConstElementPtr value = database_config->get("replica-port");
+        isc_throw(DbConfigError, "replica-port value: " << replica_port
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint16_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the replica-max-lag is within a reasonable range.
+    if ((replica_max_lag < 0) ||
+        (replica_max_lag > std::numeric_limits<uint32_t>::max())) {
+        ConstElementPtr value = database_config->get("replica-max-lag");
+        isc_throw(DbConfigError, "replica-max-lag value: " << replica_max_lag
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint32_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the read replica is used only with the postgresql backend
+    // and that the replica parameters come with the replica host.
+    static const std::vector<std::string> replica_keywords = {
+        "replica-host", "replica-port", "replica-max-lag"
+    };
+    for (auto const& keyword : replica_keywords) {
+        if (values_copy.count(keyword) == 0) {
+            continue;
+        }
+        ConstElementPtr value = database_config->get(keyword);
+        if (!value) {
+            value = database_config;
+        }
+        if (dbtype != "postgresql") {
+            isc_throw(DbConfigError, keyword << " is only supported by the"
+                      << " postgresql backend (" << value->getPosition() << ")");
+        }
+        if (values_copy.count("replica-host") == 0) {
+            isc_throw(DbConfigError, keyword << " requires replica-host ("
+                      << value->getPosition() << ")");
+        }
+    }
+
+    // Check that the async-threads is within a reasonable range.
+    if ((async_threads < 0) ||
+        (async_threads > std::numeric_limits<uint16_t>::max())) {
+        ConstElementPtr value = database_config->get("async-threads");
+        isc_throw(DbConfigError, "async-threads value: " << async_threads
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint16_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the asynchronous lease updates are used only with the
+    // SQL backends.
+    if ((async_threads > 0) && (dbtype != "mysql") && (dbtype != "postgresql")) {
+        ConstElementPtr value = database_config->get("async-threads");
+        isc_throw(DbConfigError, "async-threads is only supported by the mysql"
+                  << " and postgresql backends (" << value->getPosition() << ")");
+    }
+
+    // Check that the pool-size is within a reasonable range.
+    if ((pool_size < 0) ||
+        (pool_size > std::numeric_limits<uint16_t>::max())) {
+        ConstElementPtr value = database_config->get("pool-size");
+        isc_throw(DbConfigError, "pool-size value: " << pool_size
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint16_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the context pool is used only with the SQL backends.
+    if ((pool_size > 0) && (dbtype != "mysql") && (dbtype != "postgresql")) {
+        ConstElementPtr value = database_config->get("pool-size");
+        isc_throw(DbConfigError, "pool-size is only supported by the mysql"
+                  << " and postgresql backends (" << value->getPosition() << ")");
+    }
+
+    // Check that the writer-threads is within a reasonable range.
+    if ((writer_threads < 0) ||
+        (writer_threads > std::numeric_limits<uint16_t>::max())) {
+        ConstElementPtr value = database_config->get("writer-threads");
+        isc_throw(DbConfigError, "writer-threads value: " << writer_threads
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint16_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the writer threads are used only with the SQL backends.
+    if ((writer_threads > 0) && (dbtype != "mysql") && (dbtype != "postgresql")) {
+        ConstElementPtr value = database_config->get("writer-threads");
+        isc_throw(DbConfigError, "writer-threads is only supported by the mysql"
+                  << " and postgresql backends (" << value->getPosition() << ")");
+    }
+
+    // Check that the fsync-records is within a reasonable range.
+    if ((fsync_records < 0) ||
+        (fsync_records > std::numeric_limits<uint32_t>::max())) {
+        ConstElementPtr value = database_config->get("fsync-records");
+        isc_throw(DbConfigError, "fsync-records value: " << fsync_records
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint32_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the write-behind-queue-size is within a reasonable range.
+    if ((write_behind_queue_size <= 0) ||
+        (write_behind_queue_size > std::numeric_limits<uint32_t>::max())) {
+        ConstElementPtr value = database_config->get("write-behind-queue-size");
+        isc_throw(DbConfigError, "write-behind-queue-size value: "
+                  << write_behind_queue_size
+                  << " is out of range, expected value: 1.."
+                  << std::numeric_limits<uint32_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the pipeline mode is used only with the postgresql backend.
+    auto pipeline_ptr = values_copy.find("pipeline");
+    if ((pipeline_ptr != values_copy.end()) &&
+        (pipeline_ptr->second == "true") && (dbtype != "postgresql")) {
+        ConstElementPtr value = database_config->get("pipeline");
+        isc_throw(DbConfigError, "pipeline is only supported by the postgresql backend"
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the single query allocation is used only with the
+    // postgresql backend.
+    auto single_query_ptr = values_copy.find("single-query-allocation");
+    if ((single_query_ptr != values_copy.end()) &&
+        (single_query_ptr->second == "true") && (dbtype != "postgresql")) {
+        ConstElementPtr value = database_config->get("single-query-allocation");
+        isc_throw(DbConfigError, "single-query-allocation is only supported by"
+                  << " the postgresql backend (" << value->getPosition() << ")");
+    }
+
+    // Check that the in-memory lease limits are used only with the SQL
+    // backends. The memfile backend always counts the leases in memory.
+    auto limits_ptr = values_copy.find("in-memory-limits");
+    if ((limits_ptr != values_copy.end()) && (limits_ptr->second == "true") &&
+        (dbtype != "mysql") && (dbtype != "postgresql")) {
+        ConstElementPtr value = database_config->get("in-memory-limits");
+        isc_throw(DbConfigError, "in-memory-limits is only supported by the mysql"
+                  << " and postgresql backends (" << value->getPosition() << ")");
+    }
+
+    // Check that the host cache parameters are within a reasonable range.
+    if ((cache_size < 0) ||
+        (cache_size > std::numeric_limits<uint32_t>::max())) {
+        ConstElementPtr value = database_config->get("cache-size");
+        isc_throw(DbConfigError, "cache-size value: " << cache_size
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint32_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+    if ((cache_ttl < 0) ||
+        (cache_ttl > std::numeric_limits<uint32_t>::max())) {
+        ConstElementPtr value = database_config->get("cache-ttl");
+        isc_throw(DbConfigError, "cache-ttl value: " << cache_ttl
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint32_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the host cache is used only with the SQL backends.
+    if ((cache_size > 0) && (dbtype != "mysql") && (dbtype != "postgresql")) {
+        ConstElementPtr value = database_config->get("cache-size");
+        isc_throw(DbConfigError, "cache-size is only supported by the mysql"
+                  << " and postgresql backends (" << value->getPosition() << ")");
+    }
+
+    // Check that the global-hosts-refresh is within a reasonable range.
+    if ((global_hosts_refresh < 0) ||
+        (global_hosts_refresh > std::numeric_limits<uint32_t>::max() / 1000)) {
+        ConstElementPtr value = database_config->get("global-hosts-refresh");
+        isc_throw(DbConfigError, "global-hosts-refresh value: "
+                  << global_hosts_refresh
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint32_t>::max() / 1000
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the in-memory global hosts are used only with the SQL
+    // backends.
+    auto global_hosts = values_copy.find("global-hosts-in-memory");
+    if ((global_hosts != values_copy.end()) && (global_hosts->second == "true") &&
+        (dbtype != "mysql") && (dbtype != "postgresql")) {
+        ConstElementPtr value = database_config->get("global-hosts-in-memory");
+        isc_throw(DbConfigError, "global-hosts-in-memory is only supported by"
+                  << " the mysql and postgresql backends ("
+                  << value->getPosition() << ")");
+    }
+
+    // Check that the lease-file-format is known.
+    auto format_ptr = values_copy.find("lease-file-format");
+    if ((format_ptr != values_copy.end()) &&
+        (format_ptr->second != "csv") && (format_ptr->second != "binary")) {
+        ConstElementPtr value = database_config->get("lease-file-format");
+        isc_throw(DbConfigError, "unknown lease-file-format: "
+                  << format_ptr->second << ", expected csv or binary"
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the lease snapshot is used only with the memfile backend.
+    auto snapshot_ptr = values_copy.find("lease-snapshot");
+    if ((snapshot_ptr != values_copy.end()) &&
+        (snapshot_ptr->second == "true") && (dbtype != "memfile")) {
+        ConstElementPtr value = database_config->get("lease-snapshot");
+        isc_throw(DbConfigError, "lease-snapshot is only supported by the"
+                  << " memfile backend (" << value->getPosition() << ")");
+    }
+
+    // Check that the map-size is within a reasonable range.
+    if ((map_size < 0) ||
+        (map_size > std::numeric_limits<uint32_t>::max())) {
+        ConstElementPtr value = database_config->get("map-size");
+        isc_throw(DbConfigError, "map-size value: " << map_size
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint32_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the map-size is used only with the lmdb backend.
+    if ((map_size > 0) && (dbtype != "lmdb")) {
+        ConstElementPtr value = database_config->get("map-size");
+        isc_throw(DbConfigError, "map-size is only supported by the lmdb"
+                  << " backend (" << value->getPosition() << ")");
+    }
+
+    // Check that the lfc-mode is known.
+    auto lfc_mode_ptr = values_copy.find("lfc-mode");
+    if ((lfc_mode_ptr != values_copy.end()) &&
+        (lfc_mode_ptr->second != "kea-lfc") &&
+        (lfc_mode_ptr->second != "in-process")) {
+        ConstElementPtr value = database_config->get("lfc-mode");
+        isc_throw(DbConfigError, "unknown lfc-mode: "
+                  << lfc_mode_ptr->second << ", expected kea-lfc or in-process"
+                  << " (" << value->getPosition() << ")");
+    }
+
     // Check that the max-reconnect-tries is reasonable.
     if (max_reconnect_tries < 0) {
         ConstElementPtr value = database_config->get("max-reconnect-tries");
@@ -24,8 +24,23 @@ namespace db {
 /// "config-database" elements, and comprises a map of strings.
 class DbAccessParser: public isc::data::SimpleParser {
 public:
+
+    /// @brief Specifies the database type.
+    ///
+    /// The lease and host databases accept parameters which are specific
+    /// to them: these parameters are rejected when the database type is
+    /// not the right one. @c ANY_DB accepts all the parameters.
+    enum DBType {
+        ANY_DB,
+        LEASE_DB,
+        HOSTS_DB,
+        CONFIG_DB
+    };
+
     /// @brief Constructor
-    DbAccessParser();
+    ///
+    /// @param db_type The type of the parsed database.
+    explicit DbAccessParser(DBType db_type = ANY_DB);
 
     /// The destructor.
     virtual ~DbAccessParser()
@@ -40,6 +55,8 @@ public:
     /// - "lfc-interval" is a number from the range of 0 to 4294967295.
     /// - "connect-timeout" is a number from the range of 0 to 4294967295.
     /// - "port" is a number from the range of 0 to 65535.
+    /// - the lease database parameters are used only in a lease database
+    ///   and the host database parameters only in a host database.
     ///
     /// Once all has been validated, constructs the database access string.
     ///
@@ -74,6 +91,8 @@ protected:
 
 private:
 
+    DBType db_type_; ///< The type of the parsed database
+
     DatabaseConnection::ParameterMap values_; ///< Stored parameter values
 };
 
@@ -519,6 +519,41 @@ TEST(DatabaseConnectionTest, redactAccessStringNoPassword) {
     EXPECT_EQ("mysql", parameters["type"]);
 }
 
+/// @brief getReplicaParameters test
+///
+/// Checks that the replica parameters are derived from the primary ones.
+TEST(DatabaseConnectionTest, getReplicaParameters) {
+    DatabaseConnection::ParameterMap parameters =
+        DatabaseConnection::parse("type=postgresql name=kea host=primary "
+                                  "port=5432 user=me");
+
+    // No read replica.
+    EXPECT_TRUE(DatabaseConnection::getReplicaParameters(parameters).empty());
+    EXPECT_EQ(0, DatabaseConnection::getReplicaMaxLag(parameters));
+
+    // The replica host replaces the host, the port is kept.
+    parameters["replica-host"] = "replica";
+    parameters["replica-max-lag"] = "5";
+    DatabaseConnection::ParameterMap replica =
+        DatabaseConnection::getReplicaParameters(parameters);
+    EXPECT_EQ(5, replica.size());
+    EXPECT_EQ("replica", replica["host"]);
+    EXPECT_EQ("5432", replica["port"]);
+    EXPECT_EQ("kea", replica["name"]);
+    EXPECT_EQ("me", replica["user"]);
+    EXPECT_EQ(5, DatabaseConnection::getReplicaMaxLag(parameters));
+
+    // The replica port replaces the port.
+    parameters["replica-port"] = "5433";
+    replica = DatabaseConnection::getReplicaParameters(parameters);
+    EXPECT_EQ(5, replica.size());
+    EXPECT_EQ("5433", replica["port"]);
+
+    // Bad lag value.
+    parameters["replica-max-lag"] = "soon";
+    EXPECT_THROW(DatabaseConnection::getReplicaMaxLag(parameters), isc::BadValue);
+}
+
 // Check that the toElementDbAccessString() handles all valid parameters
 // Note that because toElementDbAccessString() utilizes
 // toElement() this tests both.
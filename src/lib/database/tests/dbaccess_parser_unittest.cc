@@ -11,6 +11,7 @@
 #include <database/db_exceptions.h>
 #include <database/dbaccess_parser.h>
 #include <log/logger_support.h>
+#include <testutils/gtest_utils.h>
 
 #include <gtest/gtest.h>
 
@@ -166,12 +167,32 @@ private:
     /// @return true if the value of the parameter should be quoted.
      bool quoteValue(const std::string& parameter) const {
          return ((parameter != "persist") && (parameter != "lfc-interval") &&
+                 (parameter != "lfc-max-leases") &&
                  (parameter != "connect-timeout") &&
                  (parameter != "read-timeout") &&
                  (parameter != "write-timeout") &&
                  (parameter != "tcp-user-timeout") &&
                  (parameter != "port") &&
+                 (parameter != "replica-port") &&
+                 (parameter != "replica-max-lag") &&
                  (parameter != "max-row-errors") &&
+                 (parameter != "load-threads") &&
+                 (parameter != "async-threads") &&
+                 (parameter != "pool-size") &&
+                 (parameter != "writer-threads") &&
+                 (parameter != "fsync-records") &&
+                 (parameter != "write-behind") &&
+                 (parameter != "lease-snapshot") &&
+                 (parameter != "write-behind-queue-size") &&
+                 (parameter != "pipeline") &&
+                 (parameter != "single-query-allocation") &&
+                 (parameter != "in-memory-limits") &&
+                 (parameter != "cache-size") &&
+                 (parameter != "cache-ttl") &&
+                 (parameter != "map-size") &&
+                 (parameter != "cache-negative") &&
+                 (parameter != "global-hosts-in-memory") &&
+                 (parameter != "global-hosts-refresh") &&
                  (parameter != "readonly"));
     }
 
@@ -187,8 +208,10 @@ class TestDbAccessParser : public DbAccessParser {
 public:
 
     /// @brief Constructor
-    TestDbAccessParser()
-        : DbAccessParser()
+    ///
+    /// @param db_type The type of the parsed database.
+    TestDbAccessParser(DBType db_type = ANY_DB)
+        : DbAccessParser(db_type)
     {}
 
     /// @brief Destructor
@@ -556,6 +579,512 @@ TEST_F(DbAccessParserTest, largeTcpUserTimeout) {
     EXPECT_THROW(parser.parse(json_elements), DbConfigError);
 }
 
+// This test checks that the parser accepts the pipeline parameter for
+// the postgresql backend.
+TEST_F(DbAccessParserTest, validPipeline) {
+    const char* config[] = {"type", "postgresql",
+                            "name", "keatest",
+                            "pipeline", "true",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid pipeline", parser.getDbAccessParameters(),
+                      config);
+}
+
+// This test verifies that enabling the pipeline mode for the mysql
+// backend is not allowed.
+TEST_F(DbAccessParserTest, mysqlPipeline) {
+    const char* config[] = {"type", "mysql",
+                            "name", "keatest",
+                            "pipeline", "true",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+}
+
+// This test checks that the parser accepts the single-query-allocation
+// parameter for the postgresql backend.
+TEST_F(DbAccessParserTest, validSingleQueryAllocation) {
+    const char* config[] = {"type", "postgresql",
+                            "name", "keatest",
+                            "single-query-allocation", "true",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid single query allocation",
+                      parser.getDbAccessParameters(), config);
+}
+
+// This test verifies that the single query allocation is not allowed
+// for the mysql backend.
+TEST_F(DbAccessParserTest, mysqlSingleQueryAllocation) {
+    const char* config[] = {"type", "mysql",
+                            "name", "keatest",
+                            "single-query-allocation", "true",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+}
+
+// This test checks that the parser accepts the in-memory-limits parameter
+// for the SQL backends.
+TEST_F(DbAccessParserTest, validInMemoryLimits) {
+    const char* config[] = {"type", "mysql",
+                            "name", "keatest",
+                            "in-memory-limits", "true",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid in-memory-limits", parser.getDbAccessParameters(),
+                      config);
+}
+
+// This test verifies that enabling the in-memory lease limits for the
+// memfile backend is not allowed.
+TEST_F(DbAccessParserTest, memfileInMemoryLimits) {
+    const char* config[] = {"type", "memfile",
+                            "name", "/opt/var/lib/kea/kea-leases6.csv",
+                            "in-memory-limits", "true",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+}
+
+// This test checks that the parser accepts the host cache parameters
+// for the SQL backends.
+TEST_F(DbAccessParserTest, validHostCache) {
+    const char* config[] = {"type", "postgresql",
+                            "name", "keatest",
+                            "cache-size", "1000",
+                            "cache-ttl", "60",
+                            "cache-negative", "true",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid host cache", parser.getDbAccessParameters(),
+                      config);
+}
+
+// This test verifies that invalid host cache parameters are rejected.
+TEST_F(DbAccessParserTest, invalidHostCache) {
+    const char* negative[] = {"type", "mysql",
+                              "name", "keatest",
+                              "cache-size", "-1",
+                              NULL};
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(Element::fromJSON(toJson(negative))),
+                 DbConfigError);
+
+    const char* ttl[] = {"type", "mysql",
+                         "name", "keatest",
+                         "cache-ttl", "4294967296",
+                         NULL};
+    EXPECT_THROW(parser.parse(Element::fromJSON(toJson(ttl))),
+                 DbConfigError);
+
+    const char* memfile[] = {"type", "memfile",
+                             "name", "/opt/var/lib/kea/kea-leases6.csv",
+                             "cache-size", "100",
+                             NULL};
+    EXPECT_THROW(parser.parse(Element::fromJSON(toJson(memfile))),
+                 DbConfigError);
+}
+
+// This test checks that the parser accepts the in-memory global hosts
+// parameters for the SQL backends.
+TEST_F(DbAccessParserTest, validGlobalHostsInMemory) {
+    const char* config[] = {"type", "mysql",
+                            "name", "keatest",
+                            "global-hosts-in-memory", "true",
+                            "global-hosts-refresh", "60",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid global hosts in memory",
+                      parser.getDbAccessParameters(), config);
+}
+
+// This test verifies that invalid in-memory global hosts parameters are
+// rejected.
+TEST_F(DbAccessParserTest, invalidGlobalHostsInMemory) {
+    const char* refresh[] = {"type", "postgresql",
+                             "name", "keatest",
+                             "global-hosts-refresh", "4294968",
+                             NULL};
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(Element::fromJSON(toJson(refresh))),
+                 DbConfigError);
+
+    const char* memfile[] = {"type", "memfile",
+                             "name", "/opt/var/lib/kea/kea-leases6.csv",
+                             "global-hosts-in-memory", "true",
+                             NULL};
+    EXPECT_THROW(parser.parse(Element::fromJSON(toJson(memfile))),
+                 DbConfigError);
+}
+
+// This test verifies that the lease and host database parameters are
+// accepted only by the database they apply to.
+TEST_F(DbAccessParserTest, databaseType) {
+    const char* lease[] = {"type", "mysql",
+                           "name", "keatest",
+                           "writer-threads", "2",
+                           NULL};
+    ConstElementPtr lease_config = Element::fromJSON(toJson(lease));
+    const char* hosts[] = {"type", "mysql",
+                           "name", "keatest",
+                           "cache-size", "1000",
+                           NULL};
+    ConstElementPtr hosts_config = Element::fromJSON(toJson(hosts));
+
+    // All the parameters are accepted when the type is not known.
+    TestDbAccessParser any_parser;
+    EXPECT_NO_THROW(any_parser.parse(lease_config));
+    EXPECT_NO_THROW(any_parser.parse(hosts_config));
+
+    TestDbAccessParser lease_parser(DbAccessParser::LEASE_DB);
+    EXPECT_NO_THROW(lease_parser.parse(lease_config));
+    EXPECT_THROW_MSG(lease_parser.parse(hosts_config), DbConfigError,
+                     "cache-size is only supported by the hosts database"
+                     " (<string>:1:53)");
+
+    TestDbAccessParser hosts_parser(DbAccessParser::HOSTS_DB);
+    EXPECT_NO_THROW(hosts_parser.parse(hosts_config));
+    EXPECT_THROW_MSG(hosts_parser.parse(lease_config), DbConfigError,
+                     "writer-threads is only supported by the lease database"
+                     " (<string>:1:57)");
+
+    TestDbAccessParser config_parser(DbAccessParser::CONFIG_DB);
+    EXPECT_THROW(config_parser.parse(lease_config), DbConfigError);
+    EXPECT_THROW(config_parser.parse(hosts_config), DbConfigError);
+
+    // The parameters which are not specific to a database are accepted.
+    const char* replica[] = {"type", "postgresql",
+                             "name", "keatest",
+                             "replica-host", "replica.example.org",
+                             NULL};
+    ConstElementPtr replica_config = Element::fromJSON(toJson(replica));
+    EXPECT_NO_THROW(TestDbAccessParser(DbAccessParser::LEASE_DB).parse(replica_config));
+    EXPECT_NO_THROW(TestDbAccessParser(DbAccessParser::HOSTS_DB).parse(replica_config));
+
+    // The lmdb map-size is a lease database parameter.
+    const char* lmdb[] = {"type", "lmdb",
+                          "name", "kea-leases4.mdb",
+                          "map-size", "2048",
+                          NULL};
+    ConstElementPtr lmdb_config = Element::fromJSON(toJson(lmdb));
+    EXPECT_NO_THROW(TestDbAccessParser(DbAccessParser::LEASE_DB).parse(lmdb_config));
+    EXPECT_THROW(TestDbAccessParser(DbAccessParser::HOSTS_DB).parse(lmdb_config),
+                 DbConfigError);
+}
+
+// This test checks that the parser accepts the async-threads parameter
+// for the SQL backends.
+TEST_F(DbAccessParserTest, validAsyncThreads) {
+    const char* config[] = {"type", "mysql",
+                            "name", "keatest",
+                            "async-threads", "4",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid async threads", parser.getDbAccessParameters(),
+                      config);
+}
+
+// This test checks that the parser rejects an out of range value of
+// the async-threads parameter.
+TEST_F(DbAccessParserTest, invalidAsyncThreads) {
+    const char* config[] = {"type", "postgresql",
+                            "name", "keatest",
+                            "async-threads", "-1",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+
+    const char* large_config[] = {"type", "postgresql",
+                                  "name", "keatest",
+                                  "async-threads", "65536",
+                                  NULL};
+
+    json_config = toJson(large_config);
+    json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser large_parser;
+    EXPECT_THROW(large_parser.parse(json_elements), DbConfigError);
+}
+
+// This test verifies that the asynchronous lease updates are not allowed
+// for the memfile backend.
+TEST_F(DbAccessParserTest, memfileAsyncThreads) {
+    const char* config[] = {"type", "memfile",
+                            "name", "/opt/var/lib/kea/kea-leases6.csv",
+                            "async-threads", "4",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+}
+
+// This test checks that the parser accepts the pool-size parameter
+// for the SQL backends.
+TEST_F(DbAccessParserTest, validPoolSize) {
+    const char* config[] = {"type", "postgresql",
+                            "name", "keatest",
+                            "pool-size", "8",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid pool size", parser.getDbAccessParameters(),
+                      config);
+}
+
+// This test checks that the parser rejects an out of range value of
+// the pool-size parameter.
+TEST_F(DbAccessParserTest, invalidPoolSize) {
+    const char* config[] = {"type", "mysql",
+                            "name", "keatest",
+                            "pool-size", "-1",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+
+    const char* large_config[] = {"type", "mysql",
+                                  "name", "keatest",
+                                  "pool-size", "65536",
+                                  NULL};
+
+    json_config = toJson(large_config);
+    json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser large_parser;
+    EXPECT_THROW(large_parser.parse(json_elements), DbConfigError);
+}
+
+// This test verifies that the context pool is not allowed for the
+// memfile backend.
+TEST_F(DbAccessParserTest, memfilePoolSize) {
+    const char* config[] = {"type", "memfile",
+                            "name", "/opt/var/lib/kea/kea-leases6.csv",
+                            "pool-size", "4",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+}
+
+// This test checks that the parser accepts the read replica parameters
+// for the postgresql backend.
+TEST_F(DbAccessParserTest, validReplica) {
+    const char* config[] = {"type", "postgresql",
+                            "name", "keatest",
+                            "replica-host", "replica.example.org",
+                            "replica-port", "5433",
+                            "replica-max-lag", "10",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid replica", parser.getDbAccessParameters(),
+                      config);
+}
+
+// This test checks that the parser rejects invalid read replica parameters.
+TEST_F(DbAccessParserTest, invalidReplica) {
+    // The replica port is out of range.
+    const char* port_config[] = {"type", "postgresql",
+                                 "name", "keatest",
+                                 "replica-host", "replica.example.org",
+                                 "replica-port", "65536",
+                                 NULL};
+
+    string json_config = toJson(port_config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser port_parser;
+    EXPECT_THROW(port_parser.parse(json_elements), DbConfigError);
+
+    // The maximum lag is negative.
+    const char* lag_config[] = {"type", "postgresql",
+                                "name", "keatest",
+                                "replica-host", "replica.example.org",
+                                "replica-max-lag", "-1",
+                                NULL};
+
+    json_config = toJson(lag_config);
+    json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser lag_parser;
+    EXPECT_THROW(lag_parser.parse(json_elements), DbConfigError);
+
+    // The replica port without the replica host.
+    const char* host_config[] = {"type", "postgresql",
+                                 "name", "keatest",
+                                 "replica-port", "5433",
+                                 NULL};
+
+    json_config = toJson(host_config);
+    json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser host_parser;
+    EXPECT_THROW(host_parser.parse(json_elements), DbConfigError);
+}
+
+// This test verifies that the read replica is not allowed for the
+// mysql backend.
+TEST_F(DbAccessParserTest, mysqlReplica) {
+    const char* config[] = {"type", "mysql",
+                            "name", "keatest",
+                            "replica-host", "replica.example.org",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+}
+
+// This test checks that the parser accepts the writer-threads parameter
+// for the SQL backends.
+TEST_F(DbAccessParserTest, validWriterThreads) {
+    const char* config[] = {"type", "mysql",
+                            "name", "keatest",
+                            "writer-threads", "4",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid writer threads", parser.getDbAccessParameters(),
+                      config);
+}
+
+// This test checks that the parser rejects an out of range value of
+// the writer-threads parameter.
+TEST_F(DbAccessParserTest, invalidWriterThreads) {
+    const char* config[] = {"type", "postgresql",
+                            "name", "keatest",
+                            "writer-threads", "-1",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+
+    const char* large_config[] = {"type", "postgresql",
+                                  "name", "keatest",
+                                  "writer-threads", "65536",
+                                  NULL};
+
+    json_config = toJson(large_config);
+    json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser large_parser;
+    EXPECT_THROW(large_parser.parse(json_elements), DbConfigError);
+}
+
+// This test verifies that the writer threads are not allowed for the
+// memfile backend.
+TEST_F(DbAccessParserTest, memfileWriterThreads) {
+    const char* config[] = {"type", "memfile",
+                            "name", "/opt/var/lib/kea/kea-leases4.csv",
+                            "writer-threads", "2",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+}
+
 // This test verifies that specifying the tcp-user-timeout for the
 // memfile backend is not allowed.
 TEST_F(DbAccessParserTest, memfileTcpUserTimeout) {
@@ -771,6 +1300,241 @@ TEST_F(DbAccessParserTest, largeMaxRowErrors) {
     EXPECT_THROW(parser.parse(json_elements), DbConfigError);
 }
 
+// This test checks that the parser accepts the valid value of the
+// load-threads parameter.
+TEST_F(DbAccessParserTest, validLoadThreads) {
+    const char* config[] = {"type", "memfile",
+                            "name", "/opt/var/lib/kea/kea-leases6.csv",
+                            "load-threads", "4",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid load-threads", parser.getDbAccessParameters(),
+                      config);
+}
+
+// This test checks that the parser rejects the out of range values of
+// the load-threads parameter.
+TEST_F(DbAccessParserTest, invalidLoadThreads) {
+    const char* config[] = {"type", "memfile",
+                            "name", "/opt/var/lib/kea/kea-leases6.csv",
+                            "load-threads", "-1",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+
+    const char* large_config[] = {"type", "memfile",
+                                  "name", "/opt/var/lib/kea/kea-leases6.csv",
+                                  "load-threads", "65536",
+                                  NULL};
+
+    json_config = toJson(large_config);
+    json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+}
+
+// This test checks that the parser accepts the lease journal parameters.
+TEST_F(DbAccessParserTest, validLeaseJournal) {
+    const char* config[] = {"type", "memfile",
+                            "name", "/opt/var/lib/kea/kea-leases6.journal",
+                            "lease-file-format", "binary",
+                            "fsync-records", "100",
+                            "write-behind", "true",
+                            "write-behind-queue-size", "1024",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid lease journal", parser.getDbAccessParameters(),
+                      config);
+}
+
+// This test checks that the parser accepts the lease snapshot only with
+// the memfile backend.
+TEST_F(DbAccessParserTest, leaseSnapshot) {
+    const char* config[] = {"type", "memfile",
+                            "name", "/opt/var/lib/kea/kea-leases4.csv",
+                            "lease-snapshot", "true",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid lease snapshot", parser.getDbAccessParameters(),
+                      config);
+
+    const char* mysql_config[] = {"type", "mysql",
+                                  "name", "keatest",
+                                  "lease-snapshot", "true",
+                                  NULL};
+
+    json_config = toJson(mysql_config);
+    json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser mysql_parser;
+    EXPECT_THROW(mysql_parser.parse(json_elements), DbConfigError);
+}
+
+// This test checks that the parser accepts the lmdb backend and its map
+// size, and rejects the map size with the other backends.
+TEST_F(DbAccessParserTest, lmdbMapSize) {
+    const char* config[] = {"type", "lmdb",
+                            "name", "/opt/var/lib/kea/kea-leases4.mdb",
+                            "map-size", "4096",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid lmdb map size", parser.getDbAccessParameters(),
+                      config);
+
+    const char* negative_config[] = {"type", "lmdb",
+                                     "map-size", "-1",
+                                     NULL};
+
+    json_config = toJson(negative_config);
+    json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser negative_parser;
+    EXPECT_THROW(negative_parser.parse(json_elements), DbConfigError);
+
+    const char* memfile_config[] = {"type", "memfile",
+                                    "name", "/opt/var/lib/kea/kea-leases4.csv",
+                                    "map-size", "4096",
+                                    NULL};
+
+    json_config = toJson(memfile_config);
+    json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser memfile_parser;
+    EXPECT_THROW(memfile_parser.parse(json_elements), DbConfigError);
+}
+
+// This test checks that the parser accepts the known lfc-mode values and
+// rejects the others.
+TEST_F(DbAccessParserTest, lfcMode) {
+    const char* config[] = {"type", "memfile",
+                            "name", "/opt/var/lib/kea/kea-leases4.csv",
+                            "lfc-interval", "3600",
+                            "lfc-mode", "in-process",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid lfc-mode", parser.getDbAccessParameters(),
+                      config);
+
+    const char* invalid_config[] = {"type", "memfile",
+                                    "name", "/opt/var/lib/kea/kea-leases4.csv",
+                                    "lfc-mode", "fork",
+                                    NULL};
+
+    json_config = toJson(invalid_config);
+    json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser2;
+    EXPECT_THROW(parser2.parse(json_elements), DbConfigError);
+}
+
+// This test checks that the parser checks the range of lfc-max-leases.
+TEST_F(DbAccessParserTest, lfcMaxLeases) {
+    const char* config[] = {"type", "memfile",
+                            "name", "/opt/var/lib/kea/kea-leases6.csv",
+                            "lfc-max-leases", "1000000",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid lfc-max-leases", parser.getDbAccessParameters(),
+                      config);
+
+    const char* negative_config[] = {"type", "memfile",
+                                     "name", "/opt/var/lib/kea/kea-leases6.csv",
+                                     "lfc-max-leases", "-1",
+                                     NULL};
+
+    json_config = toJson(negative_config);
+    json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser2;
+    EXPECT_THROW(parser2.parse(json_elements), DbConfigError);
+}
+
+// This test checks that the parser rejects invalid values of the lease
+// journal parameters.
+TEST_F(DbAccessParserTest, invalidLeaseJournal) {
+    const char* config[] = {"type", "memfile",
+                            "name", "/opt/var/lib/kea/kea-leases6.journal",
+                            "lease-file-format", "xml",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+
+    const char* negative_config[] = {"type", "memfile",
+                                     "name", "/opt/var/lib/kea/kea-leases6.journal",
+                                     "fsync-records", "-1",
+                                     NULL};
+
+    json_config = toJson(negative_config);
+    json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+
+    const char* zero_queue_config[] = {"type", "memfile",
+                                       "name", "/opt/var/lib/kea/kea-leases6.journal",
+                                       "write-behind", "true",
+                                       "write-behind-queue-size", "0",
+                                       NULL};
+
+    json_config = toJson(zero_queue_config);
+    json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+}
+
 // Check that the parser works with a valid MySQL configuration
 TEST_F(DbAccessParserTest, validTypeMysql) {
     const char* config[] = {"type",     "mysql",
@@ -8,22 +8,50 @@
 
 #include <cc/data.h>
 #include <dhcp/classify.h>
+#include <util/multi_threading_mgr.h>
 #include <util/strutil.h>
 
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/constants.hpp>
 #include <boost/algorithm/string/split.hpp>
 
+#include <algorithm>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 namespace isc {
 namespace dhcp {
 
 using namespace isc::data;
+using namespace isc::util;
+
+namespace {
+
+/// @brief The interned class names.
+struct InternedClasses {
+    /// @brief The identifiers by name.
+    std::unordered_map<ClientClass, ClientClassId> ids_;
+
+    /// @brief The names by identifier.
+    std::vector<ClientClass> names_;
+
+    /// @brief The mutex protecting the names.
+    std::mutex mutex_;
+};
+
+/// @brief Returns the interned class names.
+InternedClasses&
+getInternedClasses() {
+    static InternedClasses interned;
+    return (interned);
+}
+
+}
 
 ClientClasses::ClientClasses(const std::string& class_names)
-    : container_() {
+    : container_(), ids_(), known_ids_(NO_UNKNOWN_ID) {
     std::vector<std::string> split_text;
     boost::split(split_text, class_names, boost::is_any_of(","),
                  boost::algorithm::token_compress_off);
@@ -40,9 +68,62 @@ void
 ClientClasses::erase(const ClientClass& class_name) {
     auto& idx = container_.get<ClassNameTag>();
     auto it = idx.find(class_name);
-    if (it != idx.end()) {
-        static_cast<void>(idx.erase(it));
+    if (it == idx.end()) {
+        return;
+    }
+    static_cast<void>(idx.erase(it));
+
+    InternedClasses& interned = getInternedClasses();
+    MultiThreadingLock lock(interned.mutex_);
+    auto id = interned.ids_.find(class_name);
+    if ((id != interned.ids_.end()) && (id->second < ids_.size())) {
+        ids_.reset(id->second);
+    }
+}
+
+void
+ClientClasses::insertId(const ClientClass& class_name) {
+    InternedClasses& interned = getInternedClasses();
+    MultiThreadingLock lock(interned.mutex_);
+    auto id = interned.ids_.find(class_name);
+    if (id == interned.ids_.end()) {
+        // The class can be interned later.
+        known_ids_ = std::min(known_ids_,
+                              static_cast<ClientClassId>(interned.names_.size()));
+        return;
+    }
+    if (id->second >= ids_.size()) {
+        ids_.resize(id->second + 1);
+    }
+    ids_.set(id->second);
+}
+
+bool
+ClientClasses::containsSlow(ClientClassId id) const {
+    ClientClass class_name;
+    {
+        InternedClasses& interned = getInternedClasses();
+        MultiThreadingLock lock(interned.mutex_);
+        if (id >= interned.names_.size()) {
+            return (false);
+        }
+        class_name = interned.names_[id];
+    }
+    return (contains(class_name));
+}
+
+ClientClassId
+ClientClasses::intern(const ClientClass& class_name) {
+    InternedClasses& interned = getInternedClasses();
+    MultiThreadingLock lock(interned.mutex_);
+    auto id = interned.ids_.find(class_name);
+    if (id != interned.ids_.end()) {
+        return (id->second);
     }
+    ClientClassId new_id = static_cast<ClientClassId>(interned.names_.size());
+    interned.ids_[class_name] = new_id;
+    interned.names_.push_back(class_name);
+    return (new_id);
 }
 
 bool
@@ -15,7 +15,9 @@
 #include <boost/multi_index/identity.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/sequenced_index.hpp>
+#include <boost/dynamic_bitset.hpp>
 
+#include <cstdint>
 #include <string>
 
 /// @file   classify.h
@@ -41,6 +43,9 @@ namespace dhcp {
     /// @brief Defines a single class name.
     typedef std::string ClientClass;
 
+    /// @brief Defines the identifier of an interned class name.
+    typedef uint32_t ClientClassId;
+
     /// @brief Tag for the sequence index.
     struct ClassSequenceTag { };
 
@@ -105,6 +110,10 @@ namespace dhcp {
     ///
     /// Both a list to iterate on it in insert order and unordered
     /// set of names for existence.
+    ///
+    /// The names interned with @c intern, e.g. the classes the subnets
+    /// and pools are guarded by, are also kept in a bitset indexed by
+    /// their identifiers so checking them is a bit test.
     class ClientClasses {
     public:
 
@@ -113,7 +122,7 @@ namespace dhcp {
         typedef ClientClassContainer::iterator iterator;
 
         /// @brief Default constructor.
-        ClientClasses() : container_() {
+        ClientClasses() : container_(), ids_(), known_ids_(NO_UNKNOWN_ID) {
         }
 
         /// @brief Constructor from comma separated values.
@@ -126,7 +135,9 @@ namespace dhcp {
         ///
         /// @param class_name The name of the class to insert
         void insert(const ClientClass& class_name) {
-            static_cast<void>(container_.push_back(class_name));
+            if (container_.push_back(class_name).second) {
+                insertId(class_name);
+            }
         }
 
         /// @brief Erase element by name.
@@ -179,9 +190,22 @@ namespace dhcp {
         /// @return true if x belongs to the classes
         bool contains(const ClientClass& x) const;
 
+        /// @brief returns if an interned class belongs to the defined classes
+        ///
+        /// @param id identifier of the client class to be checked
+        /// @return true if the class belongs to the classes
+        bool contains(ClientClassId id) const {
+            if (id < known_ids_) {
+                return ((id < ids_.size()) && ids_.test(id));
+            }
+            return (containsSlow(id));
+        }
+
         /// @brief Clears containers.
         void clear() {
             container_.clear();
+            ids_.clear();
+            known_ids_ = NO_UNKNOWN_ID;
         }
 
         /// @brief Returns all class names as text
@@ -198,9 +222,46 @@ namespace dhcp {
         /// @return the list
         isc::data::ElementPtr toElement() const;
 
+        /// @brief Interns a class name.
+        ///
+        /// The identifier of a name is the same for the life of the process
+        /// so names should be interned only by the configuration, e.g. not
+        /// for spawned classes.
+        ///
+        /// @param class_name the name of the class
+        /// @return the identifier of the name
+        static ClientClassId intern(const ClientClass& class_name);
+
     private:
+        /// @brief Sets the bit of an inserted class.
+        ///
+        /// @param class_name the name of the inserted class
+        void insertId(const ClientClass& class_name);
+
+        /// @brief Checks an interned class by name.
+        ///
+        /// Used for the classes interned after the insertion of a class
+        /// which was not interned yet.
+        ///
+        /// @param id identifier of the client class to be checked
+        /// @return true if the class belongs to the classes
+        bool containsSlow(ClientClassId id) const;
+
+        /// @brief Value of @c known_ids_ when all the classes are interned.
+        static const ClientClassId NO_UNKNOWN_ID = 0xffffffff;
+
         /// @brief container part
         ClientClassContainer container_;
+
+        /// @brief bitset of the identifiers of the classes
+        boost::dynamic_bitset<uint64_t> ids_;
+
+        /// @brief the bitset is exact for identifiers lower than this value
+        ///
+        /// A class which is not interned at insertion can be interned
+        /// later with an identifier greater or equal to the number of
+        /// interned names at the insertion.
+        ClientClassId known_ids_;
     };
 }
 }
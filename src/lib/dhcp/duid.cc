@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,7 +10,6 @@
 #include <exceptions/exceptions.h>
 #include <util/io_utilities.h>
 #include <util/strutil.h>
-#include <iomanip>
 #include <cctype>
 #include <sstream>
 #include <vector>
@@ -73,18 +72,7 @@ DUID::EMPTY() {
 }
 
 std::string DUID::toText() const {
-    std::stringstream tmp;
-    tmp << std::hex;
-    bool delim = false;
-    for (std::vector<uint8_t>::const_iterator it = duid_.begin();
-         it != duid_.end(); ++it) {
-        if (delim) {
-            tmp << ":";
-        }
-        tmp << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(*it);
-        delim = true;
-    }
-    return (tmp.str());
+    return (util::str::dumpAsHex(duid_.data(), duid_.size()));
 }
 
 bool DUID::operator==(const DUID& other) const {
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,7 +10,6 @@
 #include <dhcp/dhcp4.h>
 #include <exceptions/exceptions.h>
 #include <util/strutil.h>
-#include <iomanip>
 #include <sstream>
 #include <vector>
 #include <string.h>
@@ -49,21 +48,13 @@ HWAddr::HWAddr(const std::vector<uint8_t>& hwaddr, uint16_t htype)
 }
 
 std::string HWAddr::toText(bool include_htype) const {
-    std::stringstream tmp;
+    std::string text = util::str::dumpAsHex(hwaddr_.data(), hwaddr_.size());
     if (include_htype) {
-        tmp << "hwtype=" << static_cast<unsigned int>(htype_) << " ";
+        std::stringstream tmp;
+        tmp << "hwtype=" << static_cast<unsigned int>(htype_) << " " << text;
+        return (tmp.str());
     }
-    tmp << std::hex;
-    bool delim = false;
-    for (std::vector<uint8_t>::const_iterator it = hwaddr_.begin();
-         it != hwaddr_.end(); ++it) {
-        if (delim) {
-            tmp << ":";
-        }
-        tmp << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(*it);
-        delim = true;
-    }
-    return (tmp.str());
+    return (text);
 }
 
 HWAddr
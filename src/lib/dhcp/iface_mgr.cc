@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,30 +15,25 @@
 #include <dhcp/pkt_filter_inet.h>
 #include <dhcp/pkt_filter_inet6.h>
 #include <exceptions/exceptions.h>
+#include <util/fd_event_handler_factory.h>
 #include <util/io/pktinfo_utilities.h>
 #include <util/multi_threading_mgr.h>
 
 #include <boost/scoped_ptr.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <errno.h>
 #include <fstream>
 #include <functional>
 #include <limits>
+#include <map>
 #include <sstream>
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <string.h>
 #include <sys/ioctl.h>
-#include <sys/select.h>
-
-#ifndef FD_COPY
-#define FD_COPY(orig, copy) \
-    do { \
-        memmove(copy, orig, sizeof(fd_set)); \
-    } while (0)
-#endif
 
 using namespace std;
 using namespace isc::asiolink;
@@ -186,7 +181,10 @@ IfaceMgr::IfaceMgr()
     : packet_filter_(new PktFilterInet()),
       packet_filter6_(new PktFilterInet6()),
       test_mode_(false),
-      allow_loopback_(false) {
+      allow_loopback_(false),
+      receiver_threads_count_(1), receiver_sockets_count_(1),
+      fd_event_handler_(FDEventHandlerFactory::factoryFDEventHandler()),
+      fd_event_handler_reset_(false) {
 
     // Ensure that PQMs have been created to guarantee we have
     // default packet queues in place.
@@ -294,14 +292,27 @@ void IfaceMgr::closeSockets() {
     for (IfacePtr iface : ifaces_) {
         iface->closeSockets();
     }
+
+    // Closed socket descriptors may be reused.
+    resetEventHandler();
 }
 
 void IfaceMgr::stopDHCPReceiver() {
+    // The additional receivers signal through the main one so they
+    // are stopped first.
+    for (auto const& receiver : extra_receivers_) {
+        if (receiver->isRunning()) {
+            receiver->stop();
+        }
+    }
+    extra_receivers_.clear();
+
     if (isDHCPReceiverRunning()) {
         dhcp_receiver_->stop();
     }
 
     dhcp_receiver_.reset();
+    resetEventHandler();
 
     if (getPacketQueue4()) {
         getPacketQueue4()->clear();
@@ -333,6 +344,8 @@ IfaceMgr::addExternalSocket(int socketfd, SocketCallback callback) {
         // Update the callback and we're done
         if (s.socket_ == socketfd) {
             s.callback_ = callback;
+            // The descriptor may have been closed and reopened.
+            resetEventHandler();
             return;
         }
     }
@@ -342,6 +355,7 @@ IfaceMgr::addExternalSocket(int socketfd, SocketCallback callback) {
     x.socket_ = socketfd;
     x.callback_ = callback;
     callbacks_.push_back(x);
+    resetEventHandler();
 }
 
 void
@@ -356,6 +370,7 @@ IfaceMgr::deleteExternalSocketInternal(int socketfd) {
          s != callbacks_.end(); ++s) {
         if (s->socket_ == socketfd) {
             callbacks_.erase(s);
+            resetEventHandler();
             return;
         }
     }
@@ -383,6 +398,30 @@ void
 IfaceMgr::deleteAllExternalSockets() {
     std::lock_guard<std::mutex> lock(callbacks_mutex_);
     callbacks_.clear();
+    resetEventHandler();
+}
+
+void
+IfaceMgr::setEventHandlerType(FDEventHandler::HandlerType type) {
+    if (isDHCPReceiverRunning()) {
+        isc_throw(InvalidOperation, "can't change the event handler type"
+                  " while the receiver thread is running");
+    }
+    fd_event_handler_ = FDEventHandlerFactory::factoryFDEventHandler(type);
+    fd_event_handler_reset_ = false;
+}
+
+void
+IfaceMgr::resetEventHandler() {
+    fd_event_handler_reset_ = true;
+}
+
+void
+IfaceMgr::prepareEventHandler() {
+    if (fd_event_handler_reset_.exchange(false)) {
+        fd_event_handler_->reset();
+    }
+    fd_event_handler_->clear();
 }
 
 void
@@ -522,6 +561,17 @@ IfaceMgr::openSockets4(const uint16_t port, const bool use_bcast,
     int count = 0;
     int bcast_num = 0;
 
+    // Open many sockets bound to each address when many receiver threads
+    // are used and the packet filter lets the kernel spread the packets
+    // between them.
+    receiver_sockets_count_ = 1;
+    if ((receiver_threads_count_ > 1) && getPacketQueue4() &&
+        packet_filter_->isSocketReusePortSupported()) {
+        receiver_sockets_count_ = receiver_threads_count_;
+    }
+    packet_filter_->setSocketReusePort(receiver_sockets_count_ > 1);
+    packet_filter_->setAcceptedRelays(accepted_relays_);
+
     for (IfacePtr iface : ifaces_) {
         // Clear any errors from previous socket opening.
         iface->clearErrors();
@@ -609,9 +659,11 @@ IfaceMgr::openSockets4(const uint16_t port, const bool use_bcast,
                     // We haven't open any broadcast sockets yet, so we can
                     // open at least one more or
                     // not broadcast capable, do not set broadcast flags.
-                    IfaceMgr::openSocket(iface->getName(), addr.get(), port,
-                                         is_open_as_broadcast,
-                                         is_open_as_broadcast);
+                    for (size_t i = 0; i < receiver_sockets_count_; ++i) {
+                        IfaceMgr::openSocket(iface->getName(), addr.get(), port,
+                                             is_open_as_broadcast,
+                                             is_open_as_broadcast);
+                    }
                 } catch (const Exception& ex) {
                     IFACEMGR_ERROR(SocketConfigError, error_handler, iface,
                         "Failed to open socket on interface "
@@ -775,8 +827,19 @@ IfaceMgr::startDHCPReceiver(const uint16_t family) {
             return;
         }
 
+        // All the receivers must exist before any of them is started
+        // because they signal through the first one.
         dhcp_receiver_.reset(new WatchedThread());
-        dhcp_receiver_->start(std::bind(&IfaceMgr::receiveDHCP4Packets, this));
+        for (size_t i = 1; i < receiver_sockets_count_; ++i) {
+            extra_receivers_.push_back(WatchedThreadPtr(new WatchedThread()));
+        }
+        dhcp_receiver_->start(std::bind(&IfaceMgr::receiveDHCP4Packets,
+                                        this, 0));
+        for (size_t i = 0; i < extra_receivers_.size(); ++i) {
+            extra_receivers_[i]->start(std::bind(&IfaceMgr::receiveDHCP4Packets,
+                                                 this, i + 1));
+        }
+        resetEventHandler();
         break;
     case AF_INET6:
         // If the queue doesn't exist, packet queing has been configured
@@ -787,6 +850,7 @@ IfaceMgr::startDHCPReceiver(const uint16_t family) {
 
         dhcp_receiver_.reset(new WatchedThread());
         dhcp_receiver_->start(std::bind(&IfaceMgr::receiveDHCP6Packets, this));
+        resetEventHandler();
         break;
     default:
         isc_throw (BadValue, "startDHCPReceiver: invalid family: " << family);
@@ -926,6 +990,7 @@ IfaceMgr::getIface(const PktPtr& pkt) {
 void
 IfaceMgr::clearIfaces() {
     ifaces_.clear();
+    resetEventHandler();
 }
 
 void
@@ -1118,6 +1183,7 @@ IfaceMgr::openSocket4(Iface& iface, const IOAddress& addr, const uint16_t port,
     SocketInfo info = packet_filter_->openSocket(iface, addr, port,
                                                  receive_bcast, send_bcast);
     iface.addSocket(info);
+    resetEventHandler();
 
     return (info.sockfd_);
 }
@@ -1135,6 +1201,34 @@ IfaceMgr::send(const Pkt6Ptr& pkt) {
     return (packet_filter6_->send(*iface, getSocket(pkt), pkt) == 0);
 }
 
+size_t
+IfaceMgr::send(const std::vector<Pkt6Ptr>& pkts) {
+    size_t sent = 0;
+    std::vector<Pkt6Ptr> batch;
+    IfacePtr batch_iface;
+    int batch_sockfd = -1;
+    for (auto const& pkt : pkts) {
+        IfacePtr iface = getIface(pkt);
+        if (!iface) {
+            isc_throw(BadValue, "Unable to send DHCPv6 message. Invalid interface ("
+                      << pkt->getIface() << ") specified.");
+        }
+        int sockfd = getSocket(pkt);
+        if (!batch.empty() &&
+            ((iface != batch_iface) || (sockfd != batch_sockfd))) {
+            sent += packet_filter6_->sendBatch(*batch_iface, batch_sockfd, batch);
+            batch.clear();
+        }
+        batch_iface = iface;
+        batch_sockfd = sockfd;
+        batch.push_back(pkt);
+    }
+    if (!batch.empty()) {
+        sent += packet_filter6_->sendBatch(*batch_iface, batch_sockfd, batch);
+    }
+    return (sent);
+}
+
 bool
 IfaceMgr::send(const Pkt4Ptr& pkt) {
     IfacePtr iface = getIface(pkt);
@@ -1148,6 +1242,34 @@ IfaceMgr::send(const Pkt4Ptr& pkt) {
     return (packet_filter_->send(*iface, getSocket(pkt).sockfd_, pkt) == 0);
 }
 
+size_t
+IfaceMgr::send(const std::vector<Pkt4Ptr>& pkts) {
+    size_t sent = 0;
+    std::vector<Pkt4Ptr> batch;
+    IfacePtr batch_iface;
+    int batch_sockfd = -1;
+    for (auto const& pkt : pkts) {
+        IfacePtr iface = getIface(pkt);
+        if (!iface) {
+            isc_throw(BadValue, "Unable to send DHCPv4 message. Invalid interface ("
+                      << pkt->getIface() << ") specified.");
+        }
+        int sockfd = getSocket(pkt).sockfd_;
+        if (!batch.empty() &&
+            ((iface != batch_iface) || (sockfd != batch_sockfd))) {
+            sent += packet_filter_->sendBatch(*batch_iface, batch_sockfd, batch);
+            batch.clear();
+        }
+        batch_iface = iface;
+        batch_sockfd = sockfd;
+        batch.push_back(pkt);
+    }
+    if (!batch.empty()) {
+        sent += packet_filter_->sendBatch(*batch_iface, batch_sockfd, batch);
+    }
+    return (sent);
+}
+
 Pkt4Ptr IfaceMgr::receive4(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */) {
     if (isDHCPReceiverRunning()) {
         return (receive4Indirect(timeout_sec, timeout_usec));
@@ -1163,10 +1285,8 @@ Pkt4Ptr IfaceMgr::receive4Indirect(uint32_t timeout_sec, uint32_t timeout_usec /
                   " one million microseconds");
     }
 
-    fd_set sockets;
-    int maxfd = 0;
-
-    FD_ZERO(&sockets);
+    // Rebuild the set of watched sockets.
+    prepareEventHandler();
 
     // if there are any callbacks for external sockets registered...
     {
@@ -1174,42 +1294,38 @@ Pkt4Ptr IfaceMgr::receive4Indirect(uint32_t timeout_sec, uint32_t timeout_usec /
         if (!callbacks_.empty()) {
             for (SocketCallbackInfo s : callbacks_) {
                 // Add this socket to listening set
-                addFDtoSet(s.socket_, maxfd, &sockets);
+                fd_event_handler_->add(s.socket_);
             }
         }
     }
 
     // Add Receiver ready watch socket
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::READY), maxfd, &sockets);
+    fd_event_handler_->add(dhcp_receiver_->getWatchFd(WatchedThread::READY));
 
     // Add Receiver error watch socket
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::ERROR), maxfd, &sockets);
+    fd_event_handler_->add(dhcp_receiver_->getWatchFd(WatchedThread::ERROR));
 
-    // Set timeout for our next select() call.  If there are
+    // Set timeout for our next wait call.  If there are
     // no DHCP packets to read, then we'll wait for a finite
     // amount of time for an IO event.  Otherwise, we'll
     // poll (timeout = 0 secs).  We need to poll, even if
     // DHCP packets are waiting so we don't starve external
     // sockets under heavy DHCP load.
-    struct timeval select_timeout;
-    if (getPacketQueue4()->empty()) {
-        select_timeout.tv_sec = timeout_sec;
-        select_timeout.tv_usec = timeout_usec;
-    } else {
-        select_timeout.tv_sec = 0;
-        select_timeout.tv_usec = 0;
+    if (!getPacketQueue4()->empty()) {
+        timeout_sec = 0;
+        timeout_usec = 0;
     }
 
     // zero out the errno to be safe
     errno = 0;
 
-    int result = select(maxfd + 1, &sockets, 0, 0, &select_timeout);
+    int result = fd_event_handler_->waitEvent(timeout_sec, timeout_usec);
 
     if ((result == 0) && getPacketQueue4()->empty()) {
         // nothing received and timeout has been reached
         return (Pkt4Ptr());
     } else if (result < 0) {
-        // In most cases we would like to know whether select() returned
+        // In most cases we would like to know whether the wait returned
         // an error because of a signal being received  or for some other
         // reason. This is because DHCP servers use signals to trigger
         // certain actions, like reconfiguration or graceful shutdown.
@@ -1228,7 +1344,7 @@ Pkt4Ptr IfaceMgr::receive4Indirect(uint32_t timeout_sec, uint32_t timeout_usec /
         }
     }
 
-    // We only check external sockets if select detected an event.
+    // We only check external sockets if the wait detected an event.
     if (result > 0) {
         // Check for receiver thread read errors.
         if (dhcp_receiver_->isReady(WatchedThread::ERROR)) {
@@ -1243,7 +1359,7 @@ Pkt4Ptr IfaceMgr::receive4Indirect(uint32_t timeout_sec, uint32_t timeout_usec /
         {
             std::lock_guard<std::mutex> lock(callbacks_mutex_);
             for (SocketCallbackInfo s : callbacks_) {
-                if (!FD_ISSET(s.socket_, &sockets)) {
+                if (!fd_event_handler_->readReady(s.socket_)) {
                     continue;
                 }
                 found = true;
@@ -1285,20 +1401,15 @@ Pkt4Ptr IfaceMgr::receive4Direct(uint32_t timeout_sec, uint32_t timeout_usec /*
                   " one million microseconds");
     }
     boost::scoped_ptr<SocketInfo> candidate;
-    fd_set sockets;
-    int maxfd = 0;
-
-    FD_ZERO(&sockets);
+    // Rebuild the set of watched sockets.
+    prepareEventHandler();
 
-    /// @todo: marginal performance optimization. We could create the set once
-    /// and then use its copy for select(). Please note that select() modifies
-    /// provided set to indicated which sockets have something to read.
     for (IfacePtr iface : ifaces_) {
         for (SocketInfo s : iface->getSockets()) {
             // Only deal with IPv4 addresses.
             if (s.addr_.isV4()) {
                 // Add this socket to listening set
-                addFDtoSet(s.sockfd_, maxfd, &sockets);
+                fd_event_handler_->add(s.sockfd_);
             }
         }
     }
@@ -1309,26 +1420,22 @@ Pkt4Ptr IfaceMgr::receive4Direct(uint32_t timeout_sec, uint32_t timeout_usec /*
         if (!callbacks_.empty()) {
             for (SocketCallbackInfo s : callbacks_) {
                 // Add this socket to listening set
-                addFDtoSet(s.socket_, maxfd, &sockets);
+                fd_event_handler_->add(s.socket_);
             }
         }
     }
 
-    struct timeval select_timeout;
-    select_timeout.tv_sec = timeout_sec;
-    select_timeout.tv_usec = timeout_usec;
-
     // zero out the errno to be safe
     errno = 0;
 
-    int result = select(maxfd + 1, &sockets, 0, 0, &select_timeout);
+    int result = fd_event_handler_->waitEvent(timeout_sec, timeout_usec);
 
     if (result == 0) {
         // nothing received and timeout has been reached
         return (Pkt4Ptr()); // null
 
     } else if (result < 0) {
-        // In most cases we would like to know whether select() returned
+        // In most cases we would like to know whether the wait returned
         // an error because of a signal being received  or for some other
         // reason. This is because DHCP servers use signals to trigger
         // certain actions, like reconfiguration or graceful shutdown.
@@ -1353,7 +1460,7 @@ Pkt4Ptr IfaceMgr::receive4Direct(uint32_t timeout_sec, uint32_t timeout_usec /*
     {
         std::lock_guard<std::mutex> lock(callbacks_mutex_);
         for (SocketCallbackInfo s : callbacks_) {
-            if (!FD_ISSET(s.socket_, &sockets)) {
+            if (!fd_event_handler_->readReady(s.socket_)) {
                 continue;
             }
             found = true;
@@ -1382,7 +1489,7 @@ Pkt4Ptr IfaceMgr::receive4Direct(uint32_t timeout_sec, uint32_t timeout_usec /*
     IfacePtr recv_if;
     for (IfacePtr iface : ifaces_) {
         for (SocketInfo s : iface->getSockets()) {
-            if (FD_ISSET(s.sockfd_, &sockets)) {
+            if (fd_event_handler_->readReady(s.sockfd_)) {
                 candidate.reset(new SocketInfo(s));
                 break;
             }
@@ -1411,18 +1518,6 @@ IfaceMgr::receive6(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */) {
     return (receive6Direct(timeout_sec, timeout_usec));
 }
 
-void
-IfaceMgr::addFDtoSet(int fd, int& maxfd, fd_set* sockets) {
-    if (!sockets) {
-        isc_throw(BadValue, "addFDtoSet: sockets can't be null");
-    }
-
-    FD_SET(fd, sockets);
-    if (maxfd < fd) {
-        maxfd = fd;
-    }
-}
-
 Pkt6Ptr
 IfaceMgr::receive6Direct(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */ ) {
     // Sanity check for microsecond timeout.
@@ -1432,20 +1527,15 @@ IfaceMgr::receive6Direct(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */ )
     }
 
     boost::scoped_ptr<SocketInfo> candidate;
-    fd_set sockets;
-    int maxfd = 0;
-
-    FD_ZERO(&sockets);
+    // Rebuild the set of watched sockets.
+    prepareEventHandler();
 
-    /// @todo: marginal performance optimization. We could create the set once
-    /// and then use its copy for select(). Please note that select() modifies
-    /// provided set to indicated which sockets have something to read.
     for (IfacePtr iface : ifaces_) {
         for (SocketInfo s : iface->getSockets()) {
             // Only deal with IPv6 addresses.
             if (s.addr_.isV6()) {
                 // Add this socket to listening set
-                addFDtoSet(s.sockfd_, maxfd, &sockets);
+                fd_event_handler_->add(s.sockfd_);
             }
         }
     }
@@ -1456,26 +1546,22 @@ IfaceMgr::receive6Direct(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */ )
         if (!callbacks_.empty()) {
             for (SocketCallbackInfo s : callbacks_) {
                 // Add this socket to listening set
-                addFDtoSet(s.socket_, maxfd, &sockets);
+                fd_event_handler_->add(s.socket_);
             }
         }
     }
 
-    struct timeval select_timeout;
-    select_timeout.tv_sec = timeout_sec;
-    select_timeout.tv_usec = timeout_usec;
-
     // zero out the errno to be safe
     errno = 0;
 
-    int result = select(maxfd + 1, &sockets, 0, 0, &select_timeout);
+    int result = fd_event_handler_->waitEvent(timeout_sec, timeout_usec);
 
     if (result == 0) {
         // nothing received and timeout has been reached
         return (Pkt6Ptr()); // null
 
     } else if (result < 0) {
-        // In most cases we would like to know whether select() returned
+        // In most cases we would like to know whether the wait returned
         // an error because of a signal being received  or for some other
         // reason. This is because DHCP servers use signals to trigger
         // certain actions, like reconfiguration or graceful shutdown.
@@ -1500,7 +1586,7 @@ IfaceMgr::receive6Direct(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */ )
     {
         std::lock_guard<std::mutex> lock(callbacks_mutex_);
         for (SocketCallbackInfo s : callbacks_) {
-            if (!FD_ISSET(s.socket_, &sockets)) {
+            if (!fd_event_handler_->readReady(s.socket_)) {
                 continue;
             }
             found = true;
@@ -1528,7 +1614,7 @@ IfaceMgr::receive6Direct(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */ )
     // Let's find out which interface/socket has the data
     for (IfacePtr iface : ifaces_) {
         for (SocketInfo s : iface->getSockets()) {
-            if (FD_ISSET(s.sockfd_, &sockets)) {
+            if (fd_event_handler_->readReady(s.sockfd_)) {
                 candidate.reset(new SocketInfo(s));
                 break;
             }
@@ -1553,10 +1639,8 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
                   " one million microseconds");
     }
 
-    fd_set sockets;
-    int maxfd = 0;
-
-    FD_ZERO(&sockets);
+    // Rebuild the set of watched sockets.
+    prepareEventHandler();
 
     // if there are any callbacks for external sockets registered...
     {
@@ -1564,42 +1648,38 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
         if (!callbacks_.empty()) {
             for (SocketCallbackInfo s : callbacks_) {
                 // Add this socket to listening set
-                addFDtoSet(s.socket_, maxfd, &sockets);
+                fd_event_handler_->add(s.socket_);
             }
         }
     }
 
     // Add Receiver ready watch socket
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::READY), maxfd, &sockets);
+    fd_event_handler_->add(dhcp_receiver_->getWatchFd(WatchedThread::READY));
 
     // Add Receiver error watch socket
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::ERROR), maxfd, &sockets);
+    fd_event_handler_->add(dhcp_receiver_->getWatchFd(WatchedThread::ERROR));
 
-    // Set timeout for our next select() call.  If there are
+    // Set timeout for our next wait call.  If there are
     // no DHCP packets to read, then we'll wait for a finite
     // amount of time for an IO event.  Otherwise, we'll
     // poll (timeout = 0 secs).  We need to poll, even if
     // DHCP packets are waiting so we don't starve external
     // sockets under heavy DHCP load.
-    struct timeval select_timeout;
-    if (getPacketQueue6()->empty()) {
-        select_timeout.tv_sec = timeout_sec;
-        select_timeout.tv_usec = timeout_usec;
-    } else {
-        select_timeout.tv_sec = 0;
-        select_timeout.tv_usec = 0;
+    if (!getPacketQueue6()->empty()) {
+        timeout_sec = 0;
+        timeout_usec = 0;
     }
 
     // zero out the errno to be safe
     errno = 0;
 
-    int result = select(maxfd + 1, &sockets, 0, 0, &select_timeout);
+    int result = fd_event_handler_->waitEvent(timeout_sec, timeout_usec);
 
     if ((result == 0) && getPacketQueue6()->empty()) {
         // nothing received and timeout has been reached
         return (Pkt6Ptr());
     } else if (result < 0) {
-        // In most cases we would like to know whether select() returned
+        // In most cases we would like to know whether the wait returned
         // an error because of a signal being received  or for some other
         // reason. This is because DHCP servers use signals to trigger
         // certain actions, like reconfiguration or graceful shutdown.
@@ -1618,7 +1698,7 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
         }
     }
 
-    // We only check external sockets if select detected an event.
+    // We only check external sockets if the wait detected an event.
     if (result > 0) {
         // Check for receiver thread read errors.
         if (dhcp_receiver_->isReady(WatchedThread::ERROR)) {
@@ -1633,7 +1713,7 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
         {
             std::lock_guard<std::mutex> lock(callbacks_mutex_);
             for (SocketCallbackInfo s : callbacks_) {
-                if (!FD_ISSET(s.socket_, &sockets)) {
+                if (!fd_event_handler_->readReady(s.socket_)) {
                     continue;
                 }
                 found = true;
@@ -1669,43 +1749,70 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
 }
 
 void
-IfaceMgr::receiveDHCP4Packets() {
-    fd_set sockets;
-    int maxfd = 0;
+IfaceMgr::receiveDHCP4Packets(size_t index) {
+    WatchedThreadPtr receiver =
+        (index == 0 ? dhcp_receiver_ : extra_receivers_[index - 1]);
 
-    FD_ZERO(&sockets);
+    // Bind the thread first so its buffers are allocated on the local
+    // NUMA node. The thread runs on any CPU when it can't be bound.
+    bool bound = false;
+    unsigned cpu = 0;
+    if (!receiver_cpus_.empty()) {
+        cpu = receiver_cpus_[index % receiver_cpus_.size()];
+        bound = setThreadCpuAffinity(cpu);
+    }
+
+    // The receiver thread uses its own event handler. The set of sockets
+    // does not change while the thread is running.
+    FDEventHandlerPtr handler =
+        FDEventHandlerFactory::factoryFDEventHandler(fd_event_handler_->type());
 
     // Add terminate watch socket.
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::TERMINATE), maxfd, &sockets);
+    handler->add(receiver->getWatchFd(WatchedThread::TERMINATE));
 
     // Add Interface sockets.
     for (IfacePtr iface : ifaces_) {
+        // Rank of the sockets among those bound to the same address.
+        std::map<IOAddress, size_t> ranks;
         for (SocketInfo s : iface->getSockets()) {
             // Only deal with IPv4 addresses.
             if (s.addr_.isV4()) {
+                // Skip the sockets read by the other receivers.
+                if ((ranks[s.addr_]++ % receiver_sockets_count_) != index) {
+                    continue;
+                }
+#ifdef SO_INCOMING_CPU
+                // Ask the kernel to select this socket among those bound
+                // to the same address for packets processed by the CPU.
+                if (bound && (receiver_sockets_count_ > 1)) {
+                    int value = static_cast<int>(cpu);
+                    static_cast<void>(setsockopt(s.sockfd_, SOL_SOCKET,
+                                                 SO_INCOMING_CPU, &value,
+                                                 sizeof(value)));
+                }
+#else
+                static_cast<void>(bound);
+#endif
                 // Add this socket to listening set.
-                addFDtoSet(s.sockfd_, maxfd, &sockets);
+                handler->add(s.sockfd_);
             }
         }
     }
 
     for (;;) {
         // Check the watch socket.
-        if (dhcp_receiver_->shouldTerminate()) {
+        if (receiver->shouldTerminate()) {
             return;
         }
 
-        fd_set rd_set;
-        FD_COPY(&sockets, &rd_set);
-
         // zero out the errno to be safe.
         errno = 0;
 
         // Select with null timeouts to wait indefinitely an event
-        int result = select(maxfd + 1, &rd_set, 0, 0, 0);
+        int result = handler->waitEvent(0, 0, false);
 
         // Re-check the watch socket.
-        if (dhcp_receiver_->shouldTerminate()) {
+        if (receiver->shouldTerminate()) {
             return;
         }
 
@@ -1717,7 +1824,10 @@ IfaceMgr::receiveDHCP4Packets() {
             // This thread should not get signals?
             if (errno != EINTR) {
                 // Signal the error to receive4.
-                dhcp_receiver_->setError(strerror(errno));
+                {
+                    std::lock_guard<std::mutex> lock(receiver_mutex_);
+                    dhcp_receiver_->setError(strerror(errno));
+                }
                 // We need to sleep in case of the error condition to
                 // prevent the thread from tight looping when result
                 // gets negative.
@@ -1729,10 +1839,10 @@ IfaceMgr::receiveDHCP4Packets() {
         // Let's find out which interface/socket has data.
         for (IfacePtr iface : ifaces_) {
             for (SocketInfo s : iface->getSockets()) {
-                if (FD_ISSET(s.sockfd_, &sockets)) {
+                if (handler->readReady(s.sockfd_)) {
                     receiveDHCP4Packet(*iface, s);
                     // Can take time so check one more time the watch socket.
-                    if (dhcp_receiver_->shouldTerminate()) {
+                    if (receiver->shouldTerminate()) {
                         return;
                     }
                 }
@@ -1744,13 +1854,19 @@ IfaceMgr::receiveDHCP4Packets() {
 
 void
 IfaceMgr::receiveDHCP6Packets() {
-    fd_set sockets;
-    int maxfd = 0;
+    // Bind the thread first so its buffers are allocated on the local
+    // NUMA node. The thread runs on any CPU when it can't be bound.
+    if (!receiver_cpus_.empty()) {
+        static_cast<void>(setThreadCpuAffinity(receiver_cpus_[0]));
+    }
 
-    FD_ZERO(&sockets);
+    // The receiver thread uses its own event handler. The set of sockets
+    // does not change while the thread is running.
+    FDEventHandlerPtr handler =
+        FDEventHandlerFactory::factoryFDEventHandler(fd_event_handler_->type());
 
     // Add terminate watch socket.
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::TERMINATE), maxfd, &sockets);
+    handler->add(dhcp_receiver_->getWatchFd(WatchedThread::TERMINATE));
 
     // Add Interface sockets.
     for (IfacePtr iface : ifaces_) {
@@ -1758,7 +1874,7 @@ IfaceMgr::receiveDHCP6Packets() {
             // Only deal with IPv6 addresses.
             if (s.addr_.isV6()) {
                 // Add this socket to listening set.
-                addFDtoSet(s.sockfd_ , maxfd, &sockets);
+                handler->add(s.sockfd_);
             }
         }
     }
@@ -1769,14 +1885,11 @@ IfaceMgr::receiveDHCP6Packets() {
             return;
         }
 
-        fd_set rd_set;
-        FD_COPY(&sockets, &rd_set);
-
         // zero out the errno to be safe.
         errno = 0;
 
         // Note we wait until something happen.
-        int result = select(maxfd + 1, &rd_set, 0, 0, 0);
+        int result = handler->waitEvent(0, 0, false);
 
         // Re-check the watch socket.
         if (dhcp_receiver_->shouldTerminate()) {
@@ -1802,7 +1915,7 @@ IfaceMgr::receiveDHCP6Packets() {
         // Let's find out which interface/socket has data.
         for (IfacePtr iface : ifaces_) {
             for (SocketInfo s : iface->getSockets()) {
-                if (FD_ISSET(s.sockfd_, &sockets)) {
+                if (handler->readReady(s.sockfd_)) {
                     receiveDHCP6Packet(s);
                     // Can take time so check one more time the watch socket.
                     if (dhcp_receiver_->shouldTerminate()) {
@@ -1821,26 +1934,39 @@ IfaceMgr::receiveDHCP4Packet(Iface& iface, const SocketInfo& socket_info) {
     int result = ioctl(socket_info.sockfd_, FIONREAD, &len);
     if (result < 0) {
         // Signal the error to receive4.
+        std::lock_guard<std::mutex> lock(receiver_mutex_);
         dhcp_receiver_->setError(strerror(errno));
         return;
     }
-    if (len == 0) {
+    if ((len == 0) && !packet_filter_->isReceiveRingSupported()) {
         // Nothing to read.
         return;
     }
 
-    Pkt4Ptr pkt;
+    std::vector<Pkt4Ptr> pkts;
 
     try {
-        pkt = packet_filter_->receive(iface, socket_info);
+        packet_filter_->receiveBatch(iface, socket_info, pkts,
+                                     RECEIVE_BATCH_SIZE);
     } catch (const std::exception& ex) {
+        std::lock_guard<std::mutex> lock(receiver_mutex_);
         dhcp_receiver_->setError(strerror(errno));
     } catch (...) {
+        std::lock_guard<std::mutex> lock(receiver_mutex_);
         dhcp_receiver_->setError("packet filter receive() failed");
     }
 
-    if (pkt) {
-        getPacketQueue4()->enqueuePacket(pkt, socket_info);
+    if (rate_limiter_ && !pkts.empty()) {
+        pkts.erase(std::remove_if(pkts.begin(), pkts.end(),
+                                  [this](const Pkt4Ptr& pkt) {
+                                      return (!rate_limiter_->allow(pkt));
+                                  }),
+                   pkts.end());
+    }
+
+    if (!pkts.empty()) {
+        getPacketQueue4()->enqueuePackets(pkts, socket_info);
+        std::lock_guard<std::mutex> lock(receiver_mutex_);
         dhcp_receiver_->markReady(WatchedThread::READY);
     }
 }
@@ -1860,18 +1986,26 @@ IfaceMgr::receiveDHCP6Packet(const SocketInfo& socket_info) {
         return;
     }
 
-    Pkt6Ptr pkt;
+    std::vector<Pkt6Ptr> pkts;
 
     try {
-        pkt = packet_filter6_->receive(socket_info);
+        packet_filter6_->receiveBatch(socket_info, pkts, RECEIVE_BATCH_SIZE);
     } catch (const std::exception& ex) {
         dhcp_receiver_->setError(ex.what());
     } catch (...) {
         dhcp_receiver_->setError("packet filter receive() failed");
     }
 
-    if (pkt) {
-        getPacketQueue6()->enqueuePacket(pkt, socket_info);
+    if (rate_limiter_ && !pkts.empty()) {
+        pkts.erase(std::remove_if(pkts.begin(), pkts.end(),
+                                  [this](const Pkt6Ptr& pkt) {
+                                      return (!rate_limiter_->allow(pkt));
+                                  }),
+                   pkts.end());
+    }
+
+    if (!pkts.empty()) {
+        getPacketQueue6()->enqueuePackets(pkts, socket_info);
         dhcp_receiver_->markReady(WatchedThread::READY);
     }
 }
@@ -1966,6 +2100,36 @@ IfaceMgr::getSocket(const isc::dhcp::Pkt4Ptr& pkt) {
     return (*candidate);
 }
 
+void
+IfaceMgr::setReceiverThreadsCount(size_t count) {
+    if (count == 0) {
+        isc_throw(BadValue, "the number of receiver threads must be positive");
+    }
+    if (isDHCPReceiverRunning()) {
+        isc_throw(InvalidOperation, "Cannot change the number of receiver"
+                  " threads while DHCP receiver thread is running");
+    }
+    receiver_threads_count_ = count;
+}
+
+void
+IfaceMgr::setReceiverCpuAffinity(const CpuList& cpus) {
+    if (isDHCPReceiverRunning()) {
+        isc_throw(InvalidOperation, "Cannot change the CPU affinity of the"
+                  " receiver threads while DHCP receiver thread is running");
+    }
+    receiver_cpus_ = cpus;
+}
+
+void
+IfaceMgr::setPacketRateLimiter(const PacketRateLimiterPtr& limiter) {
+    if (isDHCPReceiverRunning()) {
+        isc_throw(InvalidOperation, "Cannot change the rate limiter"
+                  " while DHCP receiver thread is running");
+    }
+    rate_limiter_ = limiter;
+}
+
 bool
 IfaceMgr::configureDHCPPacketQueue(uint16_t family, data::ConstElementPtr queue_control) {
     if (isDHCPReceiverRunning()) {
@@ -1984,19 +2148,40 @@ IfaceMgr::configureDHCPPacketQueue(uint16_t family, data::ConstElementPtr queue_
     }
 
     if (enable_queue) {
+        PacketRateLimiterPtr limiter;
+        data::ConstElementPtr rate_limit = queue_control->get("rate-limit");
+        if (rate_limit) {
+            limiter = PacketRateLimiter::create(rate_limit);
+            if (!limiter->isEnabled()) {
+                limiter.reset();
+            }
+        }
         // Try to create the queue as configured.
         if (family == AF_INET) {
+            size_t receiver_threads = 1;
+            if (queue_control->contains("receiver-threads")) {
+                int64_t value = data::SimpleParser::getInteger(queue_control,
+                                                               "receiver-threads");
+                if (value <= 0) {
+                    isc_throw(BadValue, "receiver-threads must be positive");
+                }
+                receiver_threads = static_cast<size_t>(value);
+            }
             packet_queue_mgr4_->createPacketQueue(queue_control);
+            receiver_threads_count_ = receiver_threads;
         } else {
             packet_queue_mgr6_->createPacketQueue(queue_control);
         }
+        rate_limiter_ = limiter;
     } else {
         // Destroy the current queue (if one), this inherently disables threading.
         if (family == AF_INET) {
             packet_queue_mgr4_->destroyPacketQueue();
+            receiver_threads_count_ = 1;
         } else {
             packet_queue_mgr6_->destroyPacketQueue();
         }
+        rate_limiter_.reset();
     }
 
     return (enable_queue);
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,8 +14,11 @@
 #include <dhcp/pkt6.h>
 #include <dhcp/packet_queue_mgr4.h>
 #include <dhcp/packet_queue_mgr6.h>
+#include <dhcp/packet_rate_limiter.h>
 #include <dhcp/pkt_filter.h>
 #include <dhcp/pkt_filter6.h>
+#include <util/cpu_affinity.h>
+#include <util/fd_event_handler.h>
 #include <util/optional.h>
 #include <util/watch_socket.h>
 #include <util/watched_thread.h>
@@ -28,6 +31,7 @@
 #include <boost/scoped_array.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <atomic>
 #include <functional>
 #include <list>
 #include <vector>
@@ -680,6 +684,10 @@ public:
     /// we don't support packets larger than 1500.
     static const uint32_t RCVBUFSIZE = 1500;
 
+    /// Maximum number of packets read from a socket at once by the
+    /// receiver thread.
+    static const size_t RECEIVE_BATCH_SIZE = 32;
+
     /// IfaceMgr is a singleton class. This method returns reference
     /// to its sole instance.
     ///
@@ -855,6 +863,20 @@ public:
     /// @return true if sending was successful
     bool send(const Pkt6Ptr& pkt);
 
+    /// @brief Sends a batch of IPv6 packets.
+    ///
+    /// The consecutive packets which are sent over the same socket are
+    /// passed at once to the packet filter, which may send them with a
+    /// single system call.
+    ///
+    /// @param pkts packets to be sent
+    ///
+    /// @throw isc::BadValue if invalid interface specified in a packet.
+    /// @throw isc::dhcp::SocketWriteError if the packet filter failed to
+    /// send packets.
+    /// @return number of sent packets
+    size_t send(const std::vector<Pkt6Ptr>& pkts);
+
     /// @brief Sends an IPv4 packet.
     ///
     /// Sends an IPv4 packet. All parameters for actual transmission are specified
@@ -868,6 +890,20 @@ public:
     /// @return true if sending was successful
     bool send(const Pkt4Ptr& pkt);
 
+    /// @brief Sends a batch of IPv4 packets.
+    ///
+    /// The consecutive packets which are sent over the same socket are
+    /// passed at once to the packet filter, which may send them with a
+    /// single system call.
+    ///
+    /// @param pkts packets to be sent
+    ///
+    /// @throw isc::BadValue if invalid interface specified in a packet.
+    /// @throw isc::dhcp::SocketWriteError if the packet filter failed to
+    /// send packets.
+    /// @return number of sent packets
+    size_t send(const std::vector<Pkt4Ptr>& pkts);
+
     /// @brief Receive IPv4 packets or data from external sockets
     ///
     /// Wrapper around calls to either @c receive4Direct or @c
@@ -1293,7 +1329,11 @@ public:
     /// If the given configuration enables packet queueing, then the
     /// appropriate queue is created. Otherwise, the existing queue is
     /// destroyed. If the receiver thread is running when this function
-    /// is invoked, it will throw.
+    /// is invoked, it will throw. For DHCPv4 the optional
+    /// "receiver-threads" parameter sets the number of receiver threads,
+    /// see @c setReceiverThreadsCount. The optional "rate-limit" map
+    /// configures the rate limiter applied before the packets are queued,
+    /// see @c PacketRateLimiter::create.
     ///
     /// @param family indicates which receiver to start,
     /// (AF_INET or AF_INET6)
@@ -1304,14 +1344,99 @@ public:
     bool configureDHCPPacketQueue(const uint16_t family,
                                   data::ConstElementPtr queue_control);
 
-    /// @brief Convenience method for adding an descriptor to a set
+    /// @brief Sets the type of the event handler used to wait for data
+    /// on the sockets.
+    ///
+    /// The new type is also used by the receiver thread on its next start.
+    /// The servers set the "event-handler-type" of the interfaces
+    /// configuration when they open the sockets, unless the
+    /// KEA_EVENT_HANDLER_TYPE environment variable overrides it, see
+    /// @ref isc::util::FDEventHandlerFactory.
+    ///
+    /// @note The epoll handler does not report external sockets which
+    /// were closed without being deleted so they are not purged: they
+    /// simply never become ready.
     ///
-    /// @param fd descriptor to add
-    /// @param[out] maxfd maximum fd value in the set.  If the new fd is
-    /// larger than it's current value, it will be updated to new fd value
-    /// @param sockets pointer to the set of sockets
-    /// @throw BadValue if sockets is null
-    static void addFDtoSet(int fd, int& maxfd, fd_set* sockets);
+    /// @param type The event handler type.
+    /// @throw InvalidOperation if the receiver thread is currently running.
+    void setEventHandlerType(isc::util::FDEventHandler::HandlerType type);
+
+    /// @brief Returns the type of the event handler used to wait for data
+    /// on the sockets.
+    isc::util::FDEventHandler::HandlerType getEventHandlerType() const {
+        return (fd_event_handler_->type());
+    }
+
+    /// @brief Sets the number of DHCPv4 receiver threads.
+    ///
+    /// When more than one thread is requested and the packet filter
+    /// supports it, @c openSockets4 opens this number of sockets bound
+    /// with the SO_REUSEPORT option to each address, so the kernel
+    /// spreads the incoming packets between them. Each receiver thread
+    /// then reads its own share of the sockets and adds the packets to
+    /// the packet queue. It is only used when packet queueing is enabled.
+    /// The new value is applied when the sockets are opened again.
+    ///
+    /// @param count The number of receiver threads.
+    /// @throw BadValue if the number is zero.
+    /// @throw InvalidOperation if the receiver thread is currently running.
+    void setReceiverThreadsCount(size_t count);
+
+    /// @brief Returns the number of DHCPv4 receiver threads.
+    size_t getReceiverThreadsCount() const {
+        return (receiver_threads_count_);
+    }
+
+    /// @brief Sets the CPUs the DHCP receiver threads are bound to.
+    ///
+    /// The DHCPv4 receiver thread of index i is bound to the CPU of index
+    /// i modulo the number of CPUs, the DHCPv6 receiver thread to the
+    /// first CPU. With many DHCPv4 receiver threads the SO_INCOMING_CPU
+    /// option of each socket is set to the CPU of its thread so kernels
+    /// supporting it deliver the packets to the socket of the thread
+    /// running on the CPU which processed them.
+    /// The new value is applied when the receiver thread is started again.
+    ///
+    /// @param cpus The CPU list, empty to not bind the threads.
+    /// @throw InvalidOperation if the receiver thread is currently running.
+    void setReceiverCpuAffinity(const isc::util::CpuList& cpus);
+
+    /// @brief Returns the CPUs the DHCP receiver threads are bound to.
+    const isc::util::CpuList& getReceiverCpuAffinity() const {
+        return (receiver_cpus_);
+    }
+
+    /// @brief Sets the relays the DHCPv4 messages of which are received.
+    ///
+    /// The prefixes are given to the packet filter by @c openSockets4.
+    /// The packet filters supporting it drop the relayed messages the
+    /// giaddr of which does not belong to one of the prefixes in the
+    /// kernel, see @c PktFilter::setAcceptedRelays.
+    ///
+    /// @param prefixes the prefixes of the accepted relays, empty to
+    /// accept all the relays.
+    void setAcceptedRelays(const RelayPrefixes& prefixes) {
+        accepted_relays_ = prefixes;
+    }
+
+    /// @brief Returns the prefixes of the accepted relays.
+    const RelayPrefixes& getAcceptedRelays() const {
+        return (accepted_relays_);
+    }
+
+    /// @brief Sets the rate limiter of the DHCP receiver threads.
+    ///
+    /// The receiver threads drop the packets rejected by the limiter
+    /// instead of adding them to the packet queue.
+    ///
+    /// @param limiter The rate limiter, null to accept all the packets.
+    /// @throw InvalidOperation if the receiver thread is currently running.
+    void setPacketRateLimiter(const PacketRateLimiterPtr& limiter);
+
+    /// @brief Returns the rate limiter of the DHCP receiver threads.
+    const PacketRateLimiterPtr& getPacketRateLimiter() const {
+        return (rate_limiter_);
+    }
 
     // don't use private, we need derived classes in tests
 protected:
@@ -1355,7 +1480,7 @@ protected:
     /// @throw isc::BadValue if timeout_usec is greater than one million
     /// @throw isc::dhcp::SocketReadError if error occurred when receiving a
     /// packet.
-    /// @throw isc::dhcp::SignalInterruptOnSelect when a call to select() is
+    /// @throw isc::dhcp::SignalInterruptOnSelect when a wait for socket events is
     /// interrupted by a signal.
     ///
     /// @return Pkt4 object representing received packet (or null)
@@ -1377,7 +1502,7 @@ protected:
     /// @throw isc::BadValue if timeout_usec is greater than one million
     /// @throw isc::dhcp::SocketReadError if error occurred when receiving a
     /// packet.
-    /// @throw isc::dhcp::SignalInterruptOnSelect when a call to select() is
+    /// @throw isc::dhcp::SignalInterruptOnSelect when a wait for socket events is
     /// interrupted by a signal.
     ///
     /// @return Pkt4 object representing received packet (or null)
@@ -1416,7 +1541,7 @@ protected:
     /// @throw isc::BadValue if timeout_usec is greater than one million
     /// @throw isc::dhcp::SocketReadError if error occurred when receiving a
     /// packet.
-    /// @throw isc::dhcp::SignalInterruptOnSelect when a call to select() is
+    /// @throw isc::dhcp::SignalInterruptOnSelect when a wait for socket events is
     /// interrupted by a signal.
     ///
     /// @return Pkt6 object representing received packet (or null)
@@ -1438,7 +1563,7 @@ protected:
     /// @throw isc::BadValue if timeout_usec is greater than one million
     /// @throw isc::dhcp::SocketReadError if error occurred when receiving a
     /// packet.
-    /// @throw isc::dhcp::SignalInterruptOnSelect when a call to select() is
+    /// @throw isc::dhcp::SignalInterruptOnSelect when a wait for socket events is
     /// interrupted by a signal.
     ///
     /// @return Pkt6 object representing received packet (or null)
@@ -1517,17 +1642,26 @@ private:
     /// and adds them to the packet queue.  It monitors the "terminate"
     /// watch socket, and exits if it is marked ready.  This is method
     /// is used as the worker function in the thread created by @c
-    /// startDHCP4Receiver().  It currently uses select() to monitor
-    /// socket readiness.  If the select errors out (other than EINTR),
-    /// it marks the "error" watch socket as ready.
-    void receiveDHCP4Packets();
+    /// startDHCP4Receiver().  It uses the event handler selected
+    /// by @c setEventHandlerType to monitor socket readiness.  If the
+    /// wait errors out (other than EINTR), it marks the "error" watch
+    /// socket as ready.
+    ///
+    /// When many sockets are bound to each address, the n-th thread reads
+    /// the sockets whose rank among the sockets bound to the same address
+    /// modulo the number of threads is n.
+    ///
+    /// @param index The index of the receiver thread, 0 being
+    /// @c dhcp_receiver_.
+    void receiveDHCP4Packets(size_t index);
 
     /// @brief Receives a single DHCPv4 packet from an interface socket
     ///
     /// Called by @c receiveDHPC4Packets when a socket fd is flagged as
-    /// ready. It uses the DHCPv4 packet filter to receive a single packet
-    /// from the given interface socket, adds it to the packet queue, and
-    /// marks the "receive" watch socket ready. If an error occurs during
+    /// ready. It uses the DHCPv4 packet filter to receive a batch of up
+    /// to @c RECEIVE_BATCH_SIZE packets from the given interface socket,
+    /// adds them to the packet queue at once, and marks the "receive"
+    /// watch socket ready. If an error occurs during
     /// the read, the "error" watch socket is marked ready.
     ///
     /// @param iface interface
@@ -1540,17 +1674,18 @@ private:
     /// and adds them to the packet queue.  It monitors the "terminate"
     /// watch socket, and exits if it is marked ready.  This is method
     /// is used as the worker function in the thread created by @c
-    /// startDHCP6Receiver().  It currently uses select() to monitor
-    /// socket readiness.  If the select errors out (other than EINTR),
-    /// it marks the "error" watch socket as ready.
+    /// startDHCP6Receiver().  It uses the event handler selected
+    /// by @c setEventHandlerType to monitor socket readiness.  If the
+    /// wait errors out (other than EINTR), it marks the "error" watch
+    /// socket as ready.
     void receiveDHCP6Packets();
 
     /// @brief Receives a single DHCPv6 packet from an interface socket
     ///
     /// Called by @c receiveDHPC6Packets when a socket fd is flagged as
-    /// ready. It uses the DHCPv6 packet filter to receive a single packet
-    /// from the given interface socket, adds it to the packet queue, and
-    /// marks the "receive" watch socket ready. If an error occurs during
+    /// ready. It uses the DHCPv6 packet filter to receive up to
+    /// @c RECEIVE_BATCH_SIZE packets from the given interface socket, adds
+    /// them to the packet queue, and marks the "receive" watch socket ready. If an error occurs during
     /// the read, the "error" watch socket is marked ready.
     ///
     /// @param socket_info structure holding socket information
@@ -1561,6 +1696,18 @@ private:
     /// @param socketfd socket descriptor
     void deleteExternalSocketInternal(int socketfd);
 
+    /// @brief Marks the event handler state as outdated.
+    ///
+    /// Called when sockets are opened or closed, so that a descriptor
+    /// reused after being closed is registered again by the next wait.
+    void resetEventHandler();
+
+    /// @brief Prepares the event handler for a new set of sockets.
+    ///
+    /// Resets the event handler when it was marked as outdated and
+    /// clears the set of watched sockets.
+    void prepareEventHandler();
+
     /// Holds instance of a class derived from PktFilter, used by the
     /// IfaceMgr to open sockets and send/receive packets through these
     /// sockets. It is possible to supply custom object using
@@ -1597,6 +1744,39 @@ private:
 
     /// @brief DHCP packet receiver.
     isc::util::WatchedThreadPtr dhcp_receiver_;
+
+    /// @brief Additional DHCPv4 packet receivers reading from the
+    /// SO_REUSEPORT sockets.
+    std::vector<isc::util::WatchedThreadPtr> extra_receivers_;
+
+    /// @brief Mutex serializing the signaling of @c dhcp_receiver_ watch
+    /// sockets by the receiver threads.
+    std::mutex receiver_mutex_;
+
+    /// @brief The configured number of DHCPv4 receiver threads.
+    size_t receiver_threads_count_;
+
+    /// @brief The number of DHCPv4 sockets bound to each address by the
+    /// last call to @c openSockets4.
+    size_t receiver_sockets_count_;
+
+    /// @brief The CPUs the DHCP receiver threads are bound to.
+    isc::util::CpuList receiver_cpus_;
+
+    /// @brief The prefixes of the relays the DHCPv4 messages of which are
+    /// received.
+    RelayPrefixes accepted_relays_;
+
+    /// @brief The rate limiter of the DHCP receiver threads.
+    PacketRateLimiterPtr rate_limiter_;
+
+    /// @brief The event handler used to wait for data on the sockets
+    /// by the receive functions.
+    isc::util::FDEventHandlerPtr fd_event_handler_;
+
+    /// @brief Indicates that the event handler must be reset before
+    /// its next use.
+    std::atomic<bool> fd_event_handler_reset_;
 };
 
 }  // namespace isc::dhcp
@@ -609,6 +609,7 @@ IfaceMgr::openSocket6(Iface& iface, const IOAddress& addr, uint16_t port,
     SocketInfo info = packet_filter6_->openSocket(iface, addr, port,
                                                   join_multicast);
     iface.addSocket(info);
+    resetEventHandler();
 
     return (info.sockfd_);
 }
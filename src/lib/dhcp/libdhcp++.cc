@@ -23,9 +23,11 @@
 #include <util/buffer.h>
 
 #include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/shared_array.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <iterator>
 #include <limits>
 #include <list>
 
@@ -57,6 +59,36 @@ const OptionDefParamsEncapsulation OPTION_DEF_PARAMS[] = {
     { NULL,                                 0,                                       ""                          }
 };
 
+/// @brief Looks up the option definition of a code in the containers.
+///
+/// The standard option definitions take precedence over the runtime
+/// option definitions.
+///
+/// @param idx Index by code of the standard option definitions.
+/// @param runtime_idx Index by code of the runtime option definitions.
+/// @param code Option code.
+/// @param [out] def First found definition or null.
+/// @param [out] num_defs Number of found definitions.
+void
+findOptionDef(const OptionDefContainerTypeIndex& idx,
+              const OptionDefContainerTypeIndex& runtime_idx,
+              const uint16_t code, OptionDefinitionPtr& def,
+              size_t& num_defs) {
+    OptionDefContainerTypeRange range = idx.equal_range(code);
+    num_defs = std::distance(range.first, range.second);
+
+    // Standard option definitions do not include the definition for
+    // our option or we're searching for non-standard option. Try to
+    // find the definition among runtime option definitions.
+    if (num_defs == 0) {
+        range = runtime_idx.equal_range(code);
+        num_defs = std::distance(range.first, range.second);
+    }
+    if (num_defs > 0) {
+        def = *range.first;
+    }
+}
+
 }  // namespace
 
 }  // namespace dhcp
@@ -71,9 +103,17 @@ map<unsigned short, Option::Factory*> LibDHCP::v6factories_;
 // Static container with option definitions grouped by option space.
 OptionDefContainers LibDHCP::option_defs_;
 
+// Static containers with vendor option definitions grouped by vendor id.
+VendorOptionDefContainers LibDHCP::vendor4_defs_;
+VendorOptionDefContainers LibDHCP::vendor6_defs_;
+
 // Static container with option definitions created in runtime.
 StagedValue<OptionDefSpaceContainer> LibDHCP::runtime_option_defs_;
 
+// Static tables of the option definitions by code.
+OptionDefCodeTablePtr LibDHCP::v4_code_table_;
+OptionDefCodeTablePtr LibDHCP::v6_code_table_;
+
 // Null container.
 const OptionDefContainerPtr null_option_def_container_(new OptionDefContainer());
 
@@ -105,16 +145,11 @@ LibDHCP::getOptionDefs(const string& space) {
 
 const OptionDefContainerPtr
 LibDHCP::getVendorOptionDefs(const Option::Universe u, const uint32_t vendor_id) {
-    if (Option::V4 == u) {
-        if (VENDOR_ID_CABLE_LABS == vendor_id) {
-            return getOptionDefs(DOCSIS3_V4_OPTION_SPACE);
-        }
-    } else if (Option::V6 == u) {
-        if (VENDOR_ID_CABLE_LABS == vendor_id) {
-            return getOptionDefs(DOCSIS3_V6_OPTION_SPACE);
-        } else if (ENTERPRISE_ID_ISC == vendor_id) {
-            return getOptionDefs(ISC_V6_OPTION_SPACE);
-        }
+    const VendorOptionDefContainers& defs =
+        (Option::V4 == u ? vendor4_defs_ : vendor6_defs_);
+    auto const& container = defs.find(vendor_id);
+    if (container != defs.end()) {
+        return (container->second);
     }
 
     return (null_option_def_container_);
@@ -122,6 +157,13 @@ LibDHCP::getVendorOptionDefs(const Option::Universe u, const uint32_t vendor_id)
 
 OptionDefinitionPtr
 LibDHCP::getOptionDef(const string& space, const uint16_t code) {
+    OptionDefCodeTablePtr table = getOptionDefCodeTable(space);
+    OptionDefinitionPtr def;
+    size_t count = 0;
+    if (table && table->findStandard(code, def, count)) {
+        return (def);
+    }
+
     const OptionDefContainerPtr& defs = getOptionDefs(space);
     const OptionDefContainerTypeIndex& idx = defs->get<1>();
     const OptionDefContainerTypeRange& range = idx.equal_range(code);
@@ -185,6 +227,13 @@ LibDHCP::getVendorOptionDef(const Option::Universe u, const uint32_t vendor_id,
 
 OptionDefinitionPtr
 LibDHCP::getRuntimeOptionDef(const string& space, const uint16_t code) {
+    OptionDefCodeTablePtr table = getOptionDefCodeTable(space);
+    OptionDefinitionPtr def;
+    size_t count = 0;
+    if (table && table->findRuntime(code, def, count)) {
+        return (def);
+    }
+
     OptionDefContainerPtr container = runtime_option_defs_.getValue().getItems(space);
     const OptionDefContainerTypeIndex& index = container->get<1>();
     const OptionDefContainerTypeRange& range = index.equal_range(code);
@@ -224,21 +273,49 @@ LibDHCP::setRuntimeOptionDefs(const OptionDefSpaceContainer& defs) {
         }
     }
     runtime_option_defs_ = defs_copy;
+    updateOptionDefCodeTables();
 }
 
 void
 LibDHCP::clearRuntimeOptionDefs() {
     runtime_option_defs_.reset();
+    updateOptionDefCodeTables();
 }
 
 void
 LibDHCP::revertRuntimeOptionDefs() {
     runtime_option_defs_.revert();
+    updateOptionDefCodeTables();
 }
 
 void
 LibDHCP::commitRuntimeOptionDefs() {
     runtime_option_defs_.commit();
+    updateOptionDefCodeTables();
+}
+
+OptionDefCodeTablePtr
+LibDHCP::getOptionDefCodeTable(const string& space) {
+    if (space == DHCP4_OPTION_SPACE) {
+        return (boost::atomic_load(&v4_code_table_));
+    } else if (space == DHCP6_OPTION_SPACE) {
+        return (boost::atomic_load(&v6_code_table_));
+    }
+    return (OptionDefCodeTablePtr());
+}
+
+void
+LibDHCP::updateOptionDefCodeTables() {
+    const OptionDefSpaceContainer& runtime_defs = runtime_option_defs_.getValue();
+    // The DHCPv4 option codes are single bytes.
+    OptionDefCodeTablePtr v4_table(new OptionDefCodeTable(
+        getOptionDefs(DHCP4_OPTION_SPACE),
+        runtime_defs.getItems(DHCP4_OPTION_SPACE), 256));
+    OptionDefCodeTablePtr v6_table(new OptionDefCodeTable(
+        getOptionDefs(DHCP6_OPTION_SPACE),
+        runtime_defs.getItems(DHCP6_OPTION_SPACE)));
+    boost::atomic_store(&v4_code_table_, v4_table);
+    boost::atomic_store(&v6_code_table_, v6_table);
 }
 
 OptionDefinitionPtr
@@ -310,8 +387,19 @@ LibDHCP::unpackOptions6(const OptionBuffer& buf, const string& option_space,
                         OptionCollection& options,
                         size_t* relay_msg_offset /* = 0 */,
                         size_t* relay_msg_len /* = 0 */) {
+    return (unpackOptions6(buf.begin(), buf.end(), option_space, options,
+                           relay_msg_offset, relay_msg_len));
+}
+
+size_t
+LibDHCP::unpackOptions6(OptionBuffer::const_iterator begin,
+                        OptionBuffer::const_iterator end,
+                        const string& option_space,
+                        OptionCollection& options,
+                        size_t* relay_msg_offset /* = 0 */,
+                        size_t* relay_msg_len /* = 0 */) {
     size_t offset = 0;
-    size_t length = buf.size();
+    size_t length = std::distance(begin, end);
     size_t last_offset = 0;
 
     // Get the list of standard option definitions.
@@ -329,6 +417,9 @@ LibDHCP::unpackOptions6(const OptionBuffer& buf, const string& option_space,
     const OptionDefContainerTypeIndex& idx = option_defs->get<1>();
     const OptionDefContainerTypeIndex& runtime_idx = runtime_option_defs->get<1>();
 
+    // The table of the definitions by code, if the space has one.
+    OptionDefCodeTablePtr code_table = LibDHCP::getOptionDefCodeTable(option_space);
+
     // The buffer being read comprises a set of options, each starting with
     // a two-byte type code and a two-byte length field.
     while (offset < length) {
@@ -342,10 +433,10 @@ LibDHCP::unpackOptions6(const OptionBuffer& buf, const string& option_space,
         }
 
         // Parse the option header
-        uint16_t opt_type = readUint16(&buf[offset], 2);
+        uint16_t opt_type = readUint16(&begin[offset], 2);
         offset += 2;
 
-        uint16_t opt_len = readUint16(&buf[offset], 2);
+        uint16_t opt_len = readUint16(&begin[offset], 2);
         offset += 2;
 
         if (offset + opt_len > length) {
@@ -379,8 +470,8 @@ LibDHCP::unpackOptions6(const OptionBuffer& buf, const string& option_space,
             }
 
             // Parse this as vendor option
-            OptionPtr vendor_opt(new OptionVendor(Option::V6, buf.begin() + offset,
-                                                  buf.begin() + offset + opt_len));
+            OptionPtr vendor_opt(new OptionVendor(Option::V6, begin + offset,
+                                                  begin + offset + opt_len));
             options.insert(std::make_pair(opt_type, vendor_opt));
 
             offset += opt_len;
@@ -392,21 +483,14 @@ LibDHCP::unpackOptions6(const OptionBuffer& buf, const string& option_space,
         // however at this point we expect to get one option
         // definition with the particular code. If more are returned
         // we report an error.
-        OptionDefContainerTypeRange range;
+        OptionDefinitionPtr def;
         // Number of option definitions returned.
         size_t num_defs = 0;
 
         // We previously did the lookup only for dhcp6 option space, but with the
         // addition of S46 options, we now do it for every space.
-        range = idx.equal_range(opt_type);
-        num_defs = std::distance(range.first, range.second);
-
-        // Standard option definitions do not include the definition for
-        // our option or we're searching for non-standard option. Try to
-        // find the definition among runtime option definitions.
-        if (num_defs == 0) {
-            range = runtime_idx.equal_range(opt_type);
-            num_defs = std::distance(range.first, range.second);
+        if (!code_table || !code_table->find(opt_type, def, num_defs)) {
+            findOptionDef(idx, runtime_idx, opt_type, def, num_defs);
         }
 
         OptionPtr opt;
@@ -425,17 +509,16 @@ LibDHCP::unpackOptions6(const OptionBuffer& buf, const string& option_space,
             // all options and we will remove this elseif. For now,
             // return generic option.
             opt = OptionPtr(new Option(Option::V6, opt_type,
-                                       buf.begin() + offset,
-                                       buf.begin() + offset + opt_len));
+                                       begin + offset,
+                                       begin + offset + opt_len));
         } else {
             try {
                 // The option definition has been found. Use it to create
                 // the option instance from the provided buffer chunk.
-                const OptionDefinitionPtr& def = *(range.first);
                 isc_throw_assert(def);
                 opt = def->optionFactory(Option::V6, opt_type,
-                                         buf.begin() + offset,
-                                         buf.begin() + offset + opt_len);
+                                         begin + offset,
+                                         begin + offset + opt_len);
             } catch (const SkipThisOptionError&)  {
                 opt.reset();
             }
@@ -474,6 +557,9 @@ LibDHCP::unpackOptions4(const OptionBuffer& buf, const string& option_space,
     const OptionDefContainerTypeIndex& idx = option_defs->get<1>();
     const OptionDefContainerTypeIndex& runtime_idx = runtime_option_defs->get<1>();
 
+    // The table of the definitions by code, if the space has one.
+    OptionDefCodeTablePtr code_table = LibDHCP::getOptionDefCodeTable(option_space);
+
     // Flexible PAD and END parsing.
     bool flex_pad = (check && (runtime_idx.count(DHO_PAD) == 0));
     bool flex_end = (check && (runtime_idx.count(DHO_END) == 0));
@@ -539,22 +625,15 @@ LibDHCP::unpackOptions4(const OptionBuffer& buf, const string& option_space,
         // however at this point we expect to get one option
         // definition with the particular code. If more are returned
         // we report an error.
-        OptionDefContainerTypeRange range;
+        OptionDefinitionPtr def;
         // Number of option definitions returned.
         size_t num_defs = 0;
 
         // Previously we did the lookup only for "dhcp4" option space, but there
         // may be standard options in other spaces (e.g. radius). So we now do
         // the lookup for every space.
-        range = idx.equal_range(opt_type);
-        num_defs = std::distance(range.first, range.second);
-
-        // Standard option definitions do not include the definition for
-        // our option or we're searching for non-standard option. Try to
-        // find the definition among runtime option definitions.
-        if (num_defs == 0) {
-            range = runtime_idx.equal_range(opt_type);
-            num_defs = std::distance(range.first, range.second);
+        if (!code_table || !code_table->find(opt_type, def, num_defs)) {
+            findOptionDef(idx, runtime_idx, opt_type, def, num_defs);
         }
 
         // Check if option unpacking must be deferred
@@ -590,15 +669,15 @@ LibDHCP::unpackOptions4(const OptionBuffer& buf, const string& option_space,
                       " This will be supported once support for option spaces"
                       " is implemented");
         } else if (num_defs == 0) {
-            opt = OptionPtr(new Option(Option::V4, opt_type,
-                                       buf.begin() + offset,
-                                       buf.begin() + offset + opt_len));
+            // Allocate the option and its reference counter at once.
+            opt = boost::make_shared<Option>(Option::V4, opt_type,
+                                             buf.begin() + offset,
+                                             buf.begin() + offset + opt_len);
             opt->setEncapsulatedSpace(DHCP4_OPTION_SPACE);
         } else {
             try {
                 // The option definition has been found. Use it to create
                 // the option instance from the provided buffer chunk.
-                const OptionDefinitionPtr& def = *(range.first);
                 isc_throw_assert(def);
                 opt = def->optionFactory(Option::V4, opt_type,
                                          buf.begin() + offset,
@@ -608,9 +687,11 @@ LibDHCP::unpackOptions4(const OptionBuffer& buf, const string& option_space,
             }
         }
 
-        // If we have the option, insert it
+        // If we have the option, insert it. The end hint keeps the order
+        // of the options with the same code and makes the insertion
+        // constant time when the options are sorted by code.
         if (opt) {
-            options.insert(std::make_pair(opt_type, opt));
+            options.insert(options.end(), std::make_pair(opt_type, opt));
         }
 
         offset += opt_len;
@@ -622,6 +703,26 @@ LibDHCP::unpackOptions4(const OptionBuffer& buf, const string& option_space,
 bool
 LibDHCP::fuseOptions4(OptionCollection& options) {
     bool result = false;
+    // Most collections hold at most one option per code: only the
+    // suboptions may need fusing then, and it is done without copying
+    // the collection.
+    bool duplicates = false;
+    for (auto it = options.begin(); it != options.end(); ++it) {
+        auto next = std::next(it);
+        if ((next != options.end()) && (next->first == it->first)) {
+            duplicates = true;
+            break;
+        }
+    }
+    if (!duplicates) {
+        for (auto const& option : options) {
+            OptionCollection& sub_options = option.second->getMutableOptions();
+            if (!sub_options.empty() && LibDHCP::fuseOptions4(sub_options)) {
+                result = true;
+            }
+        }
+        return (result);
+    }
     // We need to loop until all options have been fused.
     for (;;) {
         uint32_t found = 0;
@@ -663,8 +764,9 @@ LibDHCP::fuseOptions4(OptionCollection& options) {
                 // new option is present.
                 copy.erase(option.first);
                 // Create new option with entire data.
-                OptionPtr new_option(new Option(candidate->getUniverse(),
-                                                candidate->getType(), data));
+                OptionPtr new_option =
+                    boost::make_shared<Option>(candidate->getUniverse(),
+                                               candidate->getType(), data);
                 // Recreate suboptions container.
                 new_option->getMutableOptions() = suboptions;
                 // Add the new option to the new container.
@@ -1243,22 +1345,28 @@ LibDHCP::initOptionDefs() {
                         OPTION_DEF_PARAMS[i].size);
     }
 
+    // Index the vendor option spaces by vendor id so the vendor options
+    // are parsed without building the option space names.
+    vendor4_defs_[VENDOR_ID_CABLE_LABS] = option_defs_[DOCSIS3_V4_OPTION_SPACE];
+    vendor6_defs_[VENDOR_ID_CABLE_LABS] = option_defs_[DOCSIS3_V6_OPTION_SPACE];
+    vendor6_defs_[ENTERPRISE_ID_ISC] = option_defs_[ISC_V6_OPTION_SPACE];
+    updateOptionDefCodeTables();
+
     return (true);
 }
 
 uint32_t
 LibDHCP::optionSpaceToVendorId(const string& option_space) {
     // 8 is a minimal length of "vendor-X" format
-    if ((option_space.size() < 8) || (option_space.substr(0,7) != "vendor-")) {
+    if ((option_space.size() < 8) || (option_space.compare(0, 7, "vendor-") != 0)) {
         return (0);
     }
 
     int64_t check;
     try {
         // text after "vendor-", supposedly numbers only
-        string x = option_space.substr(7);
-
-        check = boost::lexical_cast<int64_t>(x);
+        check = boost::lexical_cast<int64_t>(option_space.c_str() + 7,
+                                             option_space.size() - 7);
     } catch (const boost::bad_lexical_cast &) {
         return (0);
     }
@@ -7,6 +7,7 @@
 #ifndef LIBDHCP_H
 #define LIBDHCP_H
 
+#include <dhcp/option_def_code_table.h>
 #include <dhcp/option_definition.h>
 #include <dhcp/option_space_container.h>
 #include <dhcp/option_space.h>
@@ -291,6 +292,35 @@ public:
                                  size_t* relay_msg_offset = 0,
                                  size_t* relay_msg_len = 0);
 
+    /// @brief Parses a range of a buffer as DHCPv6 options and creates
+    /// Option objects.
+    ///
+    /// This variant parses the options in place, e.g. the options of the
+    /// relay encapsulations and of the inner message of a relayed packet,
+    /// without copying them to a new buffer first.
+    ///
+    /// @param begin Iterator pointing to the beginning of the options.
+    /// @param end Iterator pointing to the end of the options.
+    /// @param option_space A name of the option space which holds definitions
+    ///        to be used to parse options in the packets.
+    /// @param options Reference to option container. Options will be
+    ///        put here.
+    /// @param relay_msg_offset reference to a size_t structure. If specified,
+    ///        offset to beginning of relay_msg option relative to @c begin
+    ///        will be stored in it.
+    /// @param relay_msg_len reference to a size_t structure. If specified,
+    ///        length of the relay_msg option will be stored in it.
+    /// @return offset relative to @c begin to the first byte after the last
+    /// successfully parsed option
+    ///
+    /// The unpackOptions6 note applies too.
+    static size_t unpackOptions6(OptionBuffer::const_iterator begin,
+                                 OptionBuffer::const_iterator end,
+                                 const std::string& option_space,
+                                 isc::dhcp::OptionCollection& options,
+                                 size_t* relay_msg_offset = 0,
+                                 size_t* relay_msg_len = 0);
+
     /// @brief Fuse multiple options with the same option code in long options
     /// (RFC3396).
     ///
@@ -426,8 +456,25 @@ public:
     /// @return vendor id.
     static uint32_t optionSpaceToVendorId(const std::string& option_space);
 
+    /// @brief Returns the option definitions of a space indexed by code.
+    ///
+    /// The tables of the DHCPv4 and DHCPv6 option spaces hold both the
+    /// standard and the runtime option definitions. They are rebuilt and
+    /// atomically replaced each time the runtime option definitions change,
+    /// e.g. when a new configuration is committed.
+    ///
+    /// @param space Option space name.
+    /// @return The table of the "dhcp4" or "dhcp6" space or null for other
+    /// spaces.
+    static OptionDefCodeTablePtr getOptionDefCodeTable(const std::string& space);
+
 private:
 
+    /// @brief Rebuilds the option definition code tables.
+    ///
+    /// Called when the runtime option definitions change.
+    static void updateOptionDefCodeTables();
+
     /// Initialize DHCP option definitions.
     ///
     /// The method creates option definitions for all DHCP options.
@@ -449,8 +496,20 @@ private:
     /// Container that holds option definitions for various option spaces.
     static OptionDefContainers option_defs_;
 
+    /// Container that holds DHCPv4 vendor option definitions by vendor id.
+    static VendorOptionDefContainers vendor4_defs_;
+
+    /// Container that holds DHCPv6 vendor option definitions by vendor id.
+    static VendorOptionDefContainers vendor6_defs_;
+
     /// Container for additional option definitions created in runtime.
     static util::StagedValue<OptionDefSpaceContainer> runtime_option_defs_;
+
+    /// Option definitions of the DHCPv4 option space indexed by code.
+    static OptionDefCodeTablePtr v4_code_table_;
+
+    /// Option definitions of the DHCPv6 option space indexed by code.
+    static OptionDefCodeTablePtr v6_code_table_;
 };
 
 }
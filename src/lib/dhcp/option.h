@@ -11,6 +11,12 @@
 
 #include <boost/shared_ptr.hpp>
 
+#ifdef FLAT_OPTION_COLLECTION
+#include <boost/container/flat_map.hpp>
+#include <boost/container/small_vector.hpp>
+#include <boost/version.hpp>
+#endif
+
 #include <map>
 #include <string>
 #include <vector>
@@ -36,9 +42,70 @@ typedef boost::shared_ptr<OptionBuffer> OptionBufferPtr;
 class Option;
 typedef boost::shared_ptr<Option> OptionPtr;
 
+#ifdef FLAT_OPTION_COLLECTION
+
+#if BOOST_VERSION < 106600
+#error "the flat option collection requires Boost 1.66 or later"
+#endif
+
+#ifndef FLAT_OPTION_COLLECTION_INLINE
+/// @brief Number of options stored in the flat option collection
+/// without a memory allocation.
+#define FLAT_OPTION_COLLECTION_INLINE 4
+#endif
+
+/// A collection of DHCP (v4 or v6) options
+///
+/// This variant is a sorted vector with inline storage for the first
+/// options. It has the semantics of the std::multimap (the options with
+/// the same code are kept in the insertion order) but it invalidates the
+/// iterators following an inserted or erased option.
+class OptionCollection : public boost::container::flat_multimap<unsigned int, OptionPtr,
+    std::less<unsigned int>,
+    boost::container::small_vector<std::pair<unsigned int, OptionPtr>,
+                                   FLAT_OPTION_COLLECTION_INLINE> > {
+public:
+
+    /// @brief The underlying container.
+    typedef boost::container::flat_multimap<unsigned int, OptionPtr,
+        std::less<unsigned int>,
+        boost::container::small_vector<std::pair<unsigned int, OptionPtr>,
+                                       FLAT_OPTION_COLLECTION_INLINE> > Base;
+
+    using Base::Base;
+    using Base::insert;
+
+    /// @brief Inserts an option with a code of any integer type.
+    ///
+    /// The std::multimap accepts a pair convertible to its value type:
+    /// this overload keeps its call sites unchanged.
+    ///
+    /// @param value The code and the option.
+    /// @return An iterator to the inserted option.
+    template<typename Code, typename Pointer>
+    iterator insert(const std::pair<Code, Pointer>& value) {
+        return (Base::insert(value_type(value.first, value.second)));
+    }
+
+    /// @brief Inserts an option with a code of any integer type using
+    /// a hint.
+    ///
+    /// @param hint The position the option is inserted before if possible.
+    /// @param value The code and the option.
+    /// @return An iterator to the inserted option.
+    template<typename Code, typename Pointer>
+    iterator insert(const_iterator hint, const std::pair<Code, Pointer>& value) {
+        return (Base::insert(hint, value_type(value.first, value.second)));
+    }
+};
+
+#else
+
 /// A collection of DHCP (v4 or v6) options
 typedef std::multimap<unsigned int, OptionPtr> OptionCollection;
 
+#endif // FLAT_OPTION_COLLECTION
+
 /// A pointer to an OptionCollection
 typedef boost::shared_ptr<OptionCollection> OptionCollectionPtr;
 
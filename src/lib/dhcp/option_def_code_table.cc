@@ -0,0 +1,61 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcp/option_def_code_table.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace isc {
+namespace dhcp {
+
+const size_t OptionDefCodeTable::MAX_SIZE;
+
+OptionDefCodeTable::OptionDefCodeTable(const OptionDefContainerPtr& defs,
+                                       const OptionDefContainerPtr& runtime_defs,
+                                       size_t size)
+    : entries_() {
+    if (size == 0) {
+        for (auto const& container : { defs, runtime_defs }) {
+            if (!container) {
+                continue;
+            }
+            for (auto const& def : *container) {
+                size = std::max(size, static_cast<size_t>(def->getCode()) + 1);
+            }
+        }
+    }
+    entries_.resize(std::min(size, MAX_SIZE));
+
+    // The first definition of a code is the one returned by the lookups
+    // in the containers.
+    if (defs) {
+        const OptionDefContainerTypeIndex& idx = defs->get<1>();
+        for (auto const& def : *defs) {
+            uint16_t code = def->getCode();
+            if ((code < entries_.size()) && (entries_[code].count_ == 0)) {
+                const OptionDefContainerTypeRange& range = idx.equal_range(code);
+                entries_[code].def_ = *range.first;
+                entries_[code].count_ = std::distance(range.first, range.second);
+            }
+        }
+    }
+    if (runtime_defs) {
+        const OptionDefContainerTypeIndex& idx = runtime_defs->get<1>();
+        for (auto const& def : *runtime_defs) {
+            uint16_t code = def->getCode();
+            if ((code < entries_.size()) && (entries_[code].runtime_count_ == 0)) {
+                const OptionDefContainerTypeRange& range = idx.equal_range(code);
+                entries_[code].runtime_def_ = *range.first;
+                entries_[code].runtime_count_ = std::distance(range.first, range.second);
+            }
+        }
+    }
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
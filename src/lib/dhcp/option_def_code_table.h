@@ -0,0 +1,141 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPTION_DEF_CODE_TABLE_H
+#define OPTION_DEF_CODE_TABLE_H
+
+#include <dhcp/option_definition.h>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Option definitions of an option space indexed by option code.
+///
+/// The options are unpacked by looking up the definition of each option
+/// code in the standard definitions and then in the runtime definitions.
+/// This table holds the result of both lookups in an array indexed by
+/// the option code, so the unpacking of an option does not search the
+/// definition containers.
+///
+/// The table is built from the standard and runtime definitions of a
+/// space and is immutable: it is rebuilt and replaced when the runtime
+/// definitions change. The codes beyond the size of the table are not
+/// indexed and must be looked up in the definition containers.
+class OptionDefCodeTable {
+public:
+
+    /// @brief Maximum number of codes indexed by the table.
+    static const size_t MAX_SIZE = 4096;
+
+    /// @brief Constructor.
+    ///
+    /// @param defs Standard option definitions of the space.
+    /// @param runtime_defs Runtime option definitions of the space.
+    /// @param size Number of codes indexed by the table. When 0 the table
+    /// indexes the codes up to the highest code of the definitions, within
+    /// the @c MAX_SIZE limit.
+    OptionDefCodeTable(const OptionDefContainerPtr& defs,
+                       const OptionDefContainerPtr& runtime_defs,
+                       size_t size = 0);
+
+    /// @brief Returns the number of codes indexed by the table.
+    size_t size() const {
+        return (entries_.size());
+    }
+
+    /// @brief Looks up the standard option definition of a code.
+    ///
+    /// @param code Option code.
+    /// @param [out] def First standard definition of the code or null.
+    /// @param [out] count Number of standard definitions of the code.
+    /// @return false if the code is not indexed by the table.
+    bool findStandard(const uint16_t code, OptionDefinitionPtr& def,
+                      size_t& count) const {
+        if (code >= entries_.size()) {
+            return (false);
+        }
+        def = entries_[code].def_;
+        count = entries_[code].count_;
+        return (true);
+    }
+
+    /// @brief Looks up the runtime option definition of a code.
+    ///
+    /// @param code Option code.
+    /// @param [out] def First runtime definition of the code or null.
+    /// @param [out] count Number of runtime definitions of the code.
+    /// @return false if the code is not indexed by the table.
+    bool findRuntime(const uint16_t code, OptionDefinitionPtr& def,
+                     size_t& count) const {
+        if (code >= entries_.size()) {
+            return (false);
+        }
+        def = entries_[code].runtime_def_;
+        count = entries_[code].runtime_count_;
+        return (true);
+    }
+
+    /// @brief Looks up the option definition used to unpack a code.
+    ///
+    /// The standard definitions take precedence over the runtime
+    /// definitions.
+    ///
+    /// @param code Option code.
+    /// @param [out] def First standard definition of the code or, if
+    /// none, first runtime definition of the code or null.
+    /// @param [out] count Number of the returned definitions.
+    /// @return false if the code is not indexed by the table.
+    bool find(const uint16_t code, OptionDefinitionPtr& def,
+              size_t& count) const {
+        if (code >= entries_.size()) {
+            return (false);
+        }
+        const Entry& entry = entries_[code];
+        if (entry.count_ > 0) {
+            def = entry.def_;
+            count = entry.count_;
+        } else {
+            def = entry.runtime_def_;
+            count = entry.runtime_count_;
+        }
+        return (true);
+    }
+
+private:
+
+    /// @brief Option definitions of a code.
+    struct Entry {
+        /// @brief Constructor.
+        Entry() : def_(), count_(0), runtime_def_(), runtime_count_(0) {
+        }
+
+        /// @brief First standard definition.
+        OptionDefinitionPtr def_;
+
+        /// @brief Number of standard definitions.
+        size_t count_;
+
+        /// @brief First runtime definition.
+        OptionDefinitionPtr runtime_def_;
+
+        /// @brief Number of runtime definitions.
+        size_t runtime_count_;
+    };
+
+    /// @brief Entries indexed by option code.
+    std::vector<Entry> entries_;
+};
+
+/// @brief Pointer to an option definition code table.
+typedef boost::shared_ptr<const OptionDefCodeTable> OptionDefCodeTablePtr;
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // OPTION_DEF_CODE_TABLE_H
@@ -53,11 +53,13 @@ OptionDefinition::OptionDefinition(const std::string& name,
       encapsulated_space_(""),
       record_fields_(),
       user_context_(),
-      option_space_name_(space) {
+      option_space_name_(space),
+      special_format_(false) {
     // Data type is held as enum value by this class.
     // Use the provided option type string to get the
     // corresponding enum value.
     type_ = OptionDataTypeUtil::getDataType(type);
+    special_format_ = checkSpecialFormat();
 }
 
 OptionDefinition::OptionDefinition(const std::string& name,
@@ -70,7 +72,8 @@ OptionDefinition::OptionDefinition(const std::string& name,
       type_(type),
       array_type_(array_type),
       encapsulated_space_(""),
-      option_space_name_(space){
+      option_space_name_(space),
+      special_format_(checkSpecialFormat()) {
 }
 
 OptionDefinition::OptionDefinition(const std::string& name,
@@ -88,7 +91,8 @@ OptionDefinition::OptionDefinition(const std::string& name,
       encapsulated_space_(encapsulated_space),
       record_fields_(),
       user_context_(),
-      option_space_name_(space) {
+      option_space_name_(space),
+      special_format_(checkSpecialFormat()) {
 }
 
 OptionDefinition::OptionDefinition(const std::string& name,
@@ -103,7 +107,8 @@ OptionDefinition::OptionDefinition(const std::string& name,
       encapsulated_space_(encapsulated_space),
       record_fields_(),
       user_context_(),
-      option_space_name_(space) {
+      option_space_name_(space),
+      special_format_(checkSpecialFormat()) {
 }
 
 OptionDefinitionPtr
@@ -190,14 +195,18 @@ OptionDefinition::optionFactory(Option::Universe u, uint16_t type,
         // type to be returned. Therefore, we first check that if we are dealing
         // with such an option. If the instance is returned we just exit at this
         // point. If not, we will search for a generic option type to return.
-        OptionPtr option = factorySpecialFormatOption(u, begin, end);
-        if (option) {
-            return (option);
+        // The check is skipped for the definitions which can't have a
+        // special format, i.e. most of them.
+        if (special_format_) {
+            OptionPtr option = factorySpecialFormatOption(u, begin, end);
+            if (option) {
+                return (option);
+            }
         }
 
         switch (type_) {
         case OPT_EMPTY_TYPE:
-            if (getEncapsulatedSpace().empty()) {
+            if (encapsulated_space_.empty()) {
                 return (factoryEmpty(u, type));
             } else {
                 return (OptionPtr(new OptionCustom(*this, u, begin, end)));
@@ -209,37 +218,37 @@ OptionDefinition::optionFactory(Option::Universe u, uint16_t type,
         case OPT_UINT8_TYPE:
             return (array_type_ ?
                     factoryIntegerArray<uint8_t>(u, type, begin, end) :
-                    factoryInteger<uint8_t>(u, type, getEncapsulatedSpace(),
+                    factoryInteger<uint8_t>(u, type, encapsulated_space_,
                                             begin, end));
 
         case OPT_INT8_TYPE:
             return (array_type_ ?
                     factoryIntegerArray<int8_t>(u, type, begin, end) :
-                    factoryInteger<int8_t>(u, type, getEncapsulatedSpace(),
+                    factoryInteger<int8_t>(u, type, encapsulated_space_,
                                            begin, end));
 
         case OPT_UINT16_TYPE:
             return (array_type_ ?
                     factoryIntegerArray<uint16_t>(u, type, begin, end) :
-                    factoryInteger<uint16_t>(u, type, getEncapsulatedSpace(),
+                    factoryInteger<uint16_t>(u, type, encapsulated_space_,
                                              begin, end));
 
         case OPT_INT16_TYPE:
             return (array_type_ ?
                     factoryIntegerArray<uint16_t>(u, type, begin, end) :
-                    factoryInteger<int16_t>(u, type, getEncapsulatedSpace(),
+                    factoryInteger<int16_t>(u, type, encapsulated_space_,
                                             begin, end));
 
         case OPT_UINT32_TYPE:
             return (array_type_ ?
                     factoryIntegerArray<uint32_t>(u, type, begin, end) :
-                    factoryInteger<uint32_t>(u, type, getEncapsulatedSpace(),
+                    factoryInteger<uint32_t>(u, type, encapsulated_space_,
                                              begin, end));
 
         case OPT_INT32_TYPE:
             return (array_type_ ?
                     factoryIntegerArray<uint32_t>(u, type, begin, end) :
-                    factoryInteger<int32_t>(u, type, getEncapsulatedSpace(),
+                    factoryInteger<int32_t>(u, type, encapsulated_space_,
                                             begin, end));
 
         case OPT_IPV4_ADDRESS_TYPE:
@@ -262,7 +271,7 @@ OptionDefinition::optionFactory(Option::Universe u, uint16_t type,
             break;
 
         case OPT_STRING_TYPE:
-            return (OptionPtr(new OptionString(u, type, begin, end)));
+            return (boost::make_shared<OptionString>(u, type, begin, end));
 
         case OPT_TUPLE_TYPE:
             // Handle array type only here (see comments for
@@ -443,6 +452,40 @@ OptionDefinition::haveCompressedFqdnListFormat() const {
     return (haveType(OPT_FQDN_TYPE) && getArrayType());
 }
 
+bool
+OptionDefinition::checkSpecialFormat() const {
+    // The codes must match the ones of factorySpecialFormatOption.
+    if (haveSpace(DHCP6_OPTION_SPACE)) {
+        switch (code_) {
+        case D6O_IA_NA:
+        case D6O_IA_PD:
+        case D6O_IAADDR:
+        case D6O_IAPREFIX:
+        case D6O_CLIENT_FQDN:
+        case D6O_VENDOR_OPTS:
+        case D6O_VENDOR_CLASS:
+        case D6O_STATUS_CODE:
+        case D6O_BOOTFILE_PARAM:
+        case D6O_PD_EXCLUDE:
+            return (true);
+        default:
+            break;
+        }
+    } else if (haveSpace(DHCP4_OPTION_SPACE)) {
+        switch (code_) {
+        case DHO_SERVICE_SCOPE:
+        case DHO_FQDN:
+        case DHO_VIVCO_SUBOPTIONS:
+        case DHO_VIVSO_SUBOPTIONS:
+        case DHO_V4_SZTP_REDIRECT:
+            return (true);
+        default:
+            break;
+        }
+    }
+    return (haveCompressedFqdnListFormat());
+}
+
 bool
 OptionDefinition::convertToBool(const std::string& value_str) const {
     // Case-insensitive check that the input is one of: "true" or "false".
@@ -694,8 +737,8 @@ OptionPtr
 OptionDefinition::factoryAddrList4(uint16_t type,
                                   OptionBufferConstIter begin,
                                   OptionBufferConstIter end) {
-    boost::shared_ptr<Option4AddrLst> option(new Option4AddrLst(type, begin,
-                                                                end));
+    boost::shared_ptr<Option4AddrLst> option =
+        boost::make_shared<Option4AddrLst>(type, begin, end);
     return (option);
 }
 
@@ -703,15 +746,15 @@ OptionPtr
 OptionDefinition::factoryAddrList6(uint16_t type,
                                    OptionBufferConstIter begin,
                                    OptionBufferConstIter end) {
-    boost::shared_ptr<Option6AddrLst> option(new Option6AddrLst(type, begin,
-                                                                end));
+    boost::shared_ptr<Option6AddrLst> option =
+        boost::make_shared<Option6AddrLst>(type, begin, end);
     return (option);
 }
 
 
 OptionPtr
 OptionDefinition::factoryEmpty(Option::Universe u, uint16_t type) {
-    OptionPtr option(new Option(u, type));
+    OptionPtr option(boost::make_shared<Option>(u, type));
     return (option);
 }
 
@@ -719,7 +762,7 @@ OptionPtr
 OptionDefinition::factoryGeneric(Option::Universe u, uint16_t type,
                                  OptionBufferConstIter begin,
                                  OptionBufferConstIter end) {
-    OptionPtr option(new Option(u, type, begin, end));
+    OptionPtr option(boost::make_shared<Option>(u, type, begin, end));
     return (option);
 }
 
@@ -822,6 +865,7 @@ OptionPtr
 OptionDefinition::factorySpecialFormatOption(Option::Universe u,
                                              OptionBufferConstIter begin,
                                              OptionBufferConstIter end) const {
+    // The codes must match the ones of checkSpecialFormat.
     if ((u == Option::V6) && haveSpace(DHCP6_OPTION_SPACE)) {
         switch (getCode()) {
         case D6O_IA_NA:
@@ -17,6 +17,7 @@
 #include <boost/multi_index/mem_fun.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/sequenced_index.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/shared_ptr.hpp>
 #include <map>
@@ -616,7 +617,7 @@ public:
                                     const std::string& encapsulated_space,
                                     OptionBufferConstIter begin,
                                     OptionBufferConstIter end) {
-        OptionPtr option(new OptionInt<T>(u, type, 0));
+        OptionPtr option(boost::make_shared<OptionInt<T> >(u, type, 0));
         option->setEncapsulatedSpace(encapsulated_space);
         option->unpack(begin, end);
         return (option);
@@ -636,7 +637,8 @@ public:
                                          uint16_t type,
                                          OptionBufferConstIter begin,
                                          OptionBufferConstIter end) {
-        OptionPtr option(new OptionIntArray<T>(u, type, begin, end));
+        OptionPtr option(boost::make_shared<OptionIntArray<T> >(u, type,
+                                                                begin, end));
         return (option);
     }
 
@@ -645,6 +647,15 @@ private:
     /// @brief Check if the option has format of CompressedFqdnList options.
     bool haveCompressedFqdnListFormat() const;
 
+    /// @brief Check if the options may be created by the specialized classes.
+    ///
+    /// It only depends on constructor parameters so it is called once by
+    /// the constructors, sparing the checks of @c factorySpecialFormatOption
+    /// to the options of the other definitions.
+    ///
+    /// @return true if @c factorySpecialFormatOption may return an option.
+    bool checkSpecialFormat() const;
+
     /// @brief Factory function to create option with a compressed FQDN list.
     ///
     /// @param u universe (V4 or V6).
@@ -762,6 +773,8 @@ private:
     data::UserContext user_context_;
     /// Option space name
     std::string option_space_name_;
+    /// Indicates whether options may be created by the specialized classes.
+    bool special_format_;
 };
 
 
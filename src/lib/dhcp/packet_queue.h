@@ -13,6 +13,7 @@
 #include <dhcp/pkt6.h>
 
 #include <sstream>
+#include <vector>
 
 namespace isc {
 
@@ -68,6 +69,20 @@ public:
     /// @param source socket the packet came from
     virtual void enqueuePacket(PacketTypePtr packet, const SocketInfo& source) = 0;
 
+    /// @brief Adds a batch of packets to the queue
+    ///
+    /// The default implementation calls @c enqueuePacket for each packet.
+    /// Derivations may override it to add the packets at once.
+    ///
+    /// @param packets packets to enqueue
+    /// @param source socket the packets came from
+    virtual void enqueuePackets(const std::vector<PacketTypePtr>& packets,
+                                const SocketInfo& source) {
+        for (auto const& packet : packets) {
+            enqueuePacket(packet, source);
+        }
+    }
+
     /// @brief Dequeues the next packet from the queue
     ///
     /// Dequeues the next packet (if any) and returns it. Derivations determine
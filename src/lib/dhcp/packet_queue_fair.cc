@@ -0,0 +1,56 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcp/dhcp6.h>
+#include <dhcp/packet_queue_fair.h>
+
+using namespace isc::asiolink;
+using namespace std;
+
+namespace {
+
+/// @brief Offset of the giaddr field in a DHCPv4 packet.
+const size_t GIADDR_OFFSET = 24;
+
+}
+
+namespace isc {
+namespace dhcp {
+
+string
+PacketQueueFair4::getIngress(const Pkt4Ptr& packet) const {
+    if (!packet) {
+        return ("");
+    }
+    const OptionBuffer& data = packet->data_;
+    if (data.size() >= GIADDR_OFFSET + 4) {
+        const uint32_t giaddr = (data[GIADDR_OFFSET] << 24) |
+            (data[GIADDR_OFFSET + 1] << 16) | (data[GIADDR_OFFSET + 2] << 8) |
+            data[GIADDR_OFFSET + 3];
+        if (giaddr != 0) {
+            return (IOAddress(giaddr).toText());
+        }
+    }
+    return (packet->getIface());
+}
+
+string
+PacketQueueFair6::getIngress(const Pkt6Ptr& packet) const {
+    if (!packet) {
+        return ("");
+    }
+    const OptionBuffer& data = packet->data_;
+    if (!data.empty() && (data[0] == DHCPV6_RELAY_FORW)) {
+        return (packet->getRemoteAddr().toText());
+    }
+    return (packet->getIface());
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
@@ -0,0 +1,416 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PACKET_QUEUE_FAIR_H
+#define PACKET_QUEUE_FAIR_H
+
+#include <dhcp/packet_queue.h>
+#include <exceptions/exceptions.h>
+
+#include <boost/scoped_ptr.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Provides a fair queueing implementation of the PacketQueue
+/// interface.
+///
+/// The packets are sorted by ingress, i.e. by relay or by interface for
+/// the packets received directly from the clients, into per-ingress
+/// sub-queues. The sub-queues holding packets are served in deficit round
+/// robin order: each gets the quantum of packets per round, so a flooding
+/// ingress can not take more than its share of the worker threads while
+/// other ingresses have packets waiting.
+///
+/// A sub-queue holds at most the ingress capacity packets: further
+/// packets from this ingress are dropped. When the queue is full the
+/// oldest packet of the longest sub-queue is dropped to make room, or the
+/// new packet itself when its sub-queue is the longest. The drops are
+/// counted per ingress.
+///
+/// The packets have not been unpacked when they are queued so the
+/// derivations read the ingress from the raw data.
+///
+/// @tparam PacketTypePtr Type of packet the queue contains.
+/// This expected to be either isc::dhcp::Pkt4Ptr or isc::dhcp::Pkt6Ptr
+template<typename PacketTypePtr>
+class PacketQueueFair : public PacketQueue<PacketTypePtr> {
+public:
+    /// @brief Minimum queue capacity permitted.
+    static const size_t MIN_CAPACITY = 5;
+
+    /// @brief Number of ingresses above which the ingresses without
+    /// queued packets are forgotten.
+    static const size_t MAX_INGRESS_COUNT = 1024;
+
+    /// @brief Constructor
+    ///
+    /// The ingress capacity defaults to the capacity and the quantum to
+    /// one packet.
+    ///
+    /// @param queue_type logical name of the queue implementation
+    /// @param capacity maximum number of packets the queue can hold
+    /// @throw BadValue if capacity is too low.
+    PacketQueueFair(const std::string& queue_type, size_t capacity)
+        : PacketQueue<PacketTypePtr>(queue_type), capacity_(capacity),
+          ingress_capacity_(capacity), quantum_(1), size_(0), ingresses_(),
+          active_(), mutex_(new std::mutex) {
+        if (capacity < MIN_CAPACITY) {
+            isc_throw(BadValue, "Queue capacity of " << capacity
+                      << " is invalid.  It must be at least " << MIN_CAPACITY);
+        }
+    }
+
+    /// @brief virtual Destructor
+    virtual ~PacketQueueFair() {
+    }
+
+    /// @brief Adds a packet to the queue
+    ///
+    /// @param packet packet to enqueue
+    /// @param source socket the packet came from
+    virtual void enqueuePacket(PacketTypePtr packet, const SocketInfo& /* source */) {
+        const std::string ingress = getIngress(packet);
+        std::lock_guard<std::mutex> lock(*mutex_);
+        pushPacket(packet, ingress);
+    }
+
+    /// @brief Adds a batch of packets to the queue
+    ///
+    /// The queue's Mutex is taken only once.
+    ///
+    /// @param packets packets to enqueue
+    /// @param source socket the packets came from
+    virtual void enqueuePackets(const std::vector<PacketTypePtr>& packets,
+                                const SocketInfo& /* source */) {
+        std::vector<std::string> ingresses;
+        ingresses.reserve(packets.size());
+        for (auto const& packet : packets) {
+            ingresses.push_back(getIngress(packet));
+        }
+        std::lock_guard<std::mutex> lock(*mutex_);
+        for (size_t i = 0; i < packets.size(); ++i) {
+            pushPacket(packets[i], ingresses[i]);
+        }
+    }
+
+    /// @brief Dequeues the next packet from the queue
+    ///
+    /// @return A pointer to dequeued packet, or an empty pointer
+    /// if the queue is empty.
+    virtual PacketTypePtr dequeuePacket() {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        PacketTypePtr packet;
+        if (active_.empty()) {
+            return (packet);
+        }
+        Ingress* ingress = active_.front();
+        if (ingress->deficit_ == 0) {
+            // The ingress starts its turn of the round.
+            ingress->deficit_ = quantum_;
+        }
+        packet = ingress->packets_.front();
+        ingress->packets_.pop_front();
+        --ingress->deficit_;
+        --size_;
+        if (ingress->packets_.empty()) {
+            ingress->deficit_ = 0;
+            ingress->active_ = false;
+            active_.pop_front();
+        } else if (ingress->deficit_ == 0) {
+            active_.pop_front();
+            active_.push_back(ingress);
+        }
+        return (packet);
+    }
+
+    /// @brief Returns True if the queue is empty.
+    virtual bool empty() const {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        return (size_ == 0);
+    }
+
+    /// @brief Returns the current number of packets in the queue.
+    virtual size_t getSize() const {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        return (size_);
+    }
+
+    /// @brief Returns the current number of packets of an ingress.
+    ///
+    /// @param ingress the ingress
+    size_t getSize(const std::string& ingress) const {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        auto it = ingresses_.find(ingress);
+        return (it == ingresses_.end() ? 0 : it->second.packets_.size());
+    }
+
+    /// @brief Returns the number of dropped packets of an ingress.
+    ///
+    /// @param ingress the ingress
+    uint64_t getDropCount(const std::string& ingress) const {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        auto it = ingresses_.find(ingress);
+        return (it == ingresses_.end() ? 0 : it->second.drops_);
+    }
+
+    /// @brief Discards all packets currently in the queue.
+    ///
+    /// The drop counts are kept.
+    virtual void clear() {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        for (auto& ingress : ingresses_) {
+            ingress.second.packets_.clear();
+            ingress.second.deficit_ = 0;
+            ingress.second.active_ = false;
+        }
+        active_.clear();
+        size_ = 0;
+    }
+
+    /// @brief Returns the maximum number of packets allowed in the queue.
+    size_t getCapacity() const {
+        return (capacity_);
+    }
+
+    /// @brief Sets the maximum number of packets of an ingress.
+    ///
+    /// @param ingress_capacity the maximum number of packets
+    /// @throw BadValue if the ingress capacity is zero.
+    void setIngressCapacity(size_t ingress_capacity) {
+        if (ingress_capacity == 0) {
+            isc_throw(BadValue, "Ingress capacity must be positive");
+        }
+        std::lock_guard<std::mutex> lock(*mutex_);
+        ingress_capacity_ = ingress_capacity;
+    }
+
+    /// @brief Returns the maximum number of packets of an ingress.
+    size_t getIngressCapacity() const {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        return (ingress_capacity_);
+    }
+
+    /// @brief Sets the quantum.
+    ///
+    /// @param quantum the number of packets an ingress can dequeue in
+    /// a round
+    /// @throw BadValue if the quantum is zero.
+    void setQuantum(uint32_t quantum) {
+        if (quantum == 0) {
+            isc_throw(BadValue, "Quantum must be positive");
+        }
+        std::lock_guard<std::mutex> lock(*mutex_);
+        quantum_ = quantum;
+    }
+
+    /// @brief Returns the quantum.
+    uint32_t getQuantum() const {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        return (quantum_);
+    }
+
+    /// @brief Fetches pertinent information
+    ///
+    /// In addition to the capacity and size it gives the ingress capacity,
+    /// the quantum and the size and drop count of each ingress.
+    virtual data::ElementPtr getInfo() const {
+        data::ElementPtr info = PacketQueue<PacketTypePtr>::getInfo();
+        std::lock_guard<std::mutex> lock(*mutex_);
+        info->set("capacity", data::Element::create(static_cast<int64_t>(capacity_)));
+        info->set("size", data::Element::create(static_cast<int64_t>(size_)));
+        info->set("ingress-capacity",
+                  data::Element::create(static_cast<int64_t>(ingress_capacity_)));
+        info->set("quantum", data::Element::create(static_cast<int64_t>(quantum_)));
+        data::ElementPtr ingresses = data::Element::createMap();
+        for (auto const& ingress : ingresses_) {
+            data::ElementPtr stats = data::Element::createMap();
+            stats->set("size", data::Element::create(static_cast<int64_t>(
+                ingress.second.packets_.size())));
+            stats->set("drops", data::Element::create(static_cast<int64_t>(
+                ingress.second.drops_)));
+            ingresses->set(ingress.first, stats);
+        }
+        info->set("ingresses", ingresses);
+        return (info);
+    }
+
+    /// @brief Returns the ingress of a packet.
+    ///
+    /// @param packet the packet, not yet unpacked
+    /// @return the relay address or the interface name
+    virtual std::string getIngress(const PacketTypePtr& packet) const = 0;
+
+private:
+    /// @brief The sub-queue and the statistics of an ingress.
+    struct Ingress {
+        /// @brief Constructor.
+        Ingress() : packets_(), deficit_(0), drops_(0), active_(false) {
+        }
+
+        /// @brief The queued packets.
+        std::deque<PacketTypePtr> packets_;
+
+        /// @brief The number of packets which can still be dequeued in
+        /// the current turn.
+        uint32_t deficit_;
+
+        /// @brief The number of dropped packets.
+        uint64_t drops_;
+
+        /// @brief True when the ingress is in the active list.
+        bool active_;
+    };
+
+    /// @brief Adds a packet with the Mutex held.
+    ///
+    /// @param packet the packet
+    /// @param key the ingress of the packet
+    void pushPacket(const PacketTypePtr& packet, const std::string& key) {
+        auto it = ingresses_.find(key);
+        if (it == ingresses_.end()) {
+            if (ingresses_.size() >= MAX_INGRESS_COUNT) {
+                forgetIdleIngresses();
+            }
+            it = ingresses_.emplace(key, Ingress()).first;
+        }
+        Ingress& ingress = it->second;
+        if (ingress.packets_.size() >= ingress_capacity_) {
+            ++ingress.drops_;
+            return;
+        }
+        if (size_ >= capacity_) {
+            // Make room by dropping the oldest packet of the longest
+            // sub-queue, or the new packet when it would be the longest.
+            Ingress* longest = 0;
+            for (auto const& active : active_) {
+                if (!longest || (active->packets_.size() > longest->packets_.size())) {
+                    longest = active;
+                }
+            }
+            if (!longest || (longest->packets_.size() <= ingress.packets_.size())) {
+                ++ingress.drops_;
+                return;
+            }
+            longest->packets_.pop_front();
+            ++longest->drops_;
+            --size_;
+            if (longest->packets_.empty()) {
+                longest->deficit_ = 0;
+                longest->active_ = false;
+                active_.erase(std::find(active_.begin(), active_.end(), longest));
+            }
+        }
+        ingress.packets_.push_back(packet);
+        ++size_;
+        if (!ingress.active_) {
+            ingress.active_ = true;
+            active_.push_back(&ingress);
+        }
+    }
+
+    /// @brief Removes the ingresses without queued packets with the
+    /// Mutex held.
+    void forgetIdleIngresses() {
+        for (auto it = ingresses_.begin(); it != ingresses_.end(); ) {
+            if (it->second.active_) {
+                ++it;
+            } else {
+                it = ingresses_.erase(it);
+            }
+        }
+    }
+
+    /// @brief The maximum number of packets.
+    size_t capacity_;
+
+    /// @brief The maximum number of packets of an ingress.
+    size_t ingress_capacity_;
+
+    /// @brief The number of packets an ingress can dequeue in a round.
+    uint32_t quantum_;
+
+    /// @brief The number of queued packets.
+    size_t size_;
+
+    /// @brief The ingresses by name.
+    std::unordered_map<std::string, Ingress> ingresses_;
+
+    /// @brief The ingresses with queued packets in round robin order.
+    std::deque<Ingress*> active_;
+
+    /// @brief Mutex for protecting queue accesses.
+    boost::scoped_ptr<std::mutex> mutex_;
+};
+
+template<typename PacketTypePtr>
+const size_t PacketQueueFair<PacketTypePtr>::MIN_CAPACITY;
+
+template<typename PacketTypePtr>
+const size_t PacketQueueFair<PacketTypePtr>::MAX_INGRESS_COUNT;
+
+/// @brief DHCPv4 fair packet queue implementation
+///
+/// The ingress of a relayed packet is the relay agent address (giaddr),
+/// otherwise it is the name of the interface the packet was received on.
+class PacketQueueFair4 : public PacketQueueFair<Pkt4Ptr> {
+public:
+    /// @brief Constructor
+    ///
+    /// @param queue_type logical name of the queue implementation
+    /// @param capacity maximum number of packets the queue can hold
+    PacketQueueFair4(const std::string& queue_type, size_t capacity)
+        : PacketQueueFair(queue_type, capacity) {
+    }
+
+    /// @brief virtual Destructor
+    virtual ~PacketQueueFair4() {
+    }
+
+    /// @brief Returns the ingress of a packet.
+    ///
+    /// @param packet the packet, not yet unpacked
+    /// @return the giaddr or the interface name
+    virtual std::string getIngress(const Pkt4Ptr& packet) const;
+};
+
+/// @brief DHCPv6 fair packet queue implementation
+///
+/// The ingress of a relayed packet is the address of the relay agent
+/// the packet was received from, otherwise it is the name of the interface
+/// the packet was received on.
+class PacketQueueFair6 : public PacketQueueFair<Pkt6Ptr> {
+public:
+    /// @brief Constructor
+    ///
+    /// @param queue_type logical name of the queue implementation
+    /// @param capacity maximum number of packets the queue can hold
+    PacketQueueFair6(const std::string& queue_type, size_t capacity)
+        : PacketQueueFair(queue_type, capacity) {
+    }
+
+    /// @brief virtual Destructor
+    virtual ~PacketQueueFair6() {
+    }
+
+    /// @brief Returns the ingress of a packet.
+    ///
+    /// @param packet the packet, not yet unpacked
+    /// @return the relay address or the interface name
+    virtual std::string getIngress(const Pkt6Ptr& packet) const;
+};
+
+}; // namespace isc::dhcp
+}; // namespace isc
+
+#endif // PACKET_QUEUE_FAIR_H
@@ -1,10 +1,12 @@
-// Copyright (C) 2018 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include <config.h>
+#include <dhcp/packet_queue_fair.h>
+#include <dhcp/packet_queue_priority.h>
 #include <dhcp/packet_queue_ring.h>
 #include <dhcp/packet_queue_mgr4.h>
 
@@ -14,6 +16,8 @@ namespace isc {
 namespace dhcp {
 
 const std::string PacketQueueMgr4::DEFAULT_QUEUE_TYPE4 = "kea-ring4";
+const std::string PacketQueueMgr4::PRIORITY_QUEUE_TYPE4 = "kea-priority4";
+const std::string PacketQueueMgr4::FAIR_QUEUE_TYPE4 = "kea-fair4";
 
 PacketQueueMgr4::PacketQueueMgr4() {
     // Register default queue factory
@@ -30,6 +34,93 @@ PacketQueueMgr4::PacketQueueMgr4() {
             PacketQueue4Ptr queue(new PacketQueueRing4(DEFAULT_QUEUE_TYPE4, capacity));
             return (queue);
         });
+
+    // Register priority queue factory
+    registerPacketQueueFactory(PRIORITY_QUEUE_TYPE4, [](data::ConstElementPtr parameters)
+                                          -> PacketQueue4Ptr {
+            size_t capacity;
+            try {
+                capacity = data::SimpleParser::getInteger(parameters, "capacity");
+            } catch (const std::exception& ex) {
+                isc_throw(InvalidQueueParameter, PRIORITY_QUEUE_TYPE4 << " factory:"
+                          " 'capacity' parameter is missing/invalid: " << ex.what());
+            }
+
+            boost::shared_ptr<PacketQueuePriority4> queue;
+            try {
+                queue.reset(new PacketQueuePriority4(PRIORITY_QUEUE_TYPE4, capacity));
+                if (parameters->contains("target-delay")) {
+                    queue->setTargetDelay(data::SimpleParser::getInteger(parameters,
+                                                                         "target-delay",
+                                                                         0, 60000));
+                }
+                if (parameters->contains("interval")) {
+                    queue->setInterval(data::SimpleParser::getInteger(parameters,
+                                                                      "interval",
+                                                                      1, 60000));
+                }
+                data::ConstElementPtr weights = parameters->get("weights");
+                if (weights) {
+                    if (weights->getType() != data::Element::map) {
+                        isc_throw(BadValue, "'weights' parameter must be a map");
+                    }
+                    for (auto const& weight : weights->mapValue()) {
+                        size_t i = 0;
+                        for (; i < PacketQueuePriority4::CLASS_COUNT; ++i) {
+                            auto packet_class = static_cast<PacketQueuePriority4::PacketClass>(i);
+                            if (weight.first == PacketQueuePriority4::className(packet_class)) {
+                                queue->setWeight(packet_class,
+                                                 data::SimpleParser::getInteger(weights,
+                                                                                weight.first,
+                                                                                1, 1000));
+                                break;
+                            }
+                        }
+                        if (i == PacketQueuePriority4::CLASS_COUNT) {
+                            isc_throw(BadValue, "unknown packet class '" << weight.first
+                                      << "' in 'weights' parameter");
+                        }
+                    }
+                }
+            } catch (const std::exception& ex) {
+                isc_throw(InvalidQueueParameter, PRIORITY_QUEUE_TYPE4 << " factory: "
+                          << ex.what());
+            }
+
+            return (queue);
+        });
+
+    // Register fair queue factory
+    registerPacketQueueFactory(FAIR_QUEUE_TYPE4, [](data::ConstElementPtr parameters)
+                                          -> PacketQueue4Ptr {
+            size_t capacity;
+            try {
+                capacity = data::SimpleParser::getInteger(parameters, "capacity");
+            } catch (const std::exception& ex) {
+                isc_throw(InvalidQueueParameter, FAIR_QUEUE_TYPE4 << " factory:"
+                          " 'capacity' parameter is missing/invalid: " << ex.what());
+            }
+
+            boost::shared_ptr<PacketQueueFair4> queue;
+            try {
+                queue.reset(new PacketQueueFair4(FAIR_QUEUE_TYPE4, capacity));
+                if (parameters->contains("ingress-capacity")) {
+                    queue->setIngressCapacity(data::SimpleParser::getInteger(parameters,
+                                                                             "ingress-capacity",
+                                                                             1, capacity));
+                }
+                if (parameters->contains("quantum")) {
+                    queue->setQuantum(data::SimpleParser::getInteger(parameters,
+                                                                     "quantum",
+                                                                     1, 1000));
+                }
+            } catch (const std::exception& ex) {
+                isc_throw(InvalidQueueParameter, FAIR_QUEUE_TYPE4 << " factory: "
+                          << ex.what());
+            }
+
+            return (queue);
+        });
 }
 
 } // end of isc::dhcp namespace
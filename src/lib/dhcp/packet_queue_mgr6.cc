@@ -1,10 +1,11 @@
-// Copyright (C) 2018 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include <config.h>
+#include <dhcp/packet_queue_fair.h>
 #include <dhcp/packet_queue_ring.h>
 #include <dhcp/packet_queue_mgr6.h>
 
@@ -14,6 +15,7 @@ namespace isc {
 namespace dhcp {
 
 const std::string PacketQueueMgr6::DEFAULT_QUEUE_TYPE6 = "kea-ring6";
+const std::string PacketQueueMgr6::FAIR_QUEUE_TYPE6 = "kea-fair6";
 
 PacketQueueMgr6::PacketQueueMgr6() {
     // Register default queue factory
@@ -30,6 +32,38 @@ PacketQueueMgr6::PacketQueueMgr6() {
             PacketQueue6Ptr queue(new PacketQueueRing6(DEFAULT_QUEUE_TYPE6, capacity));
             return (queue);
         });
+
+    // Register fair queue factory
+    registerPacketQueueFactory(FAIR_QUEUE_TYPE6, [](data::ConstElementPtr parameters)
+                                          -> PacketQueue6Ptr {
+            size_t capacity;
+            try {
+                capacity = data::SimpleParser::getInteger(parameters, "capacity");
+            } catch (const std::exception& ex) {
+                isc_throw(InvalidQueueParameter, FAIR_QUEUE_TYPE6 << " factory:"
+                          " 'capacity' parameter is missing/invalid: " << ex.what());
+            }
+
+            boost::shared_ptr<PacketQueueFair6> queue;
+            try {
+                queue.reset(new PacketQueueFair6(FAIR_QUEUE_TYPE6, capacity));
+                if (parameters->contains("ingress-capacity")) {
+                    queue->setIngressCapacity(data::SimpleParser::getInteger(parameters,
+                                                                             "ingress-capacity",
+                                                                             1, capacity));
+                }
+                if (parameters->contains("quantum")) {
+                    queue->setQuantum(data::SimpleParser::getInteger(parameters,
+                                                                     "quantum",
+                                                                     1, 1000));
+                }
+            } catch (const std::exception& ex) {
+                isc_throw(InvalidQueueParameter, FAIR_QUEUE_TYPE6 << " factory: "
+                          << ex.what());
+            }
+
+            return (queue);
+        });
 }
 
 } // end of isc::dhcp namespace
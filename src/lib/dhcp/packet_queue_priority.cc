@@ -0,0 +1,446 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcp/dhcp4.h>
+#include <dhcp/packet_queue_priority.h>
+#include <exceptions/exceptions.h>
+
+#include <cmath>
+
+using namespace isc::data;
+using namespace std;
+
+namespace isc {
+namespace dhcp {
+
+const size_t PacketQueuePriority4::MIN_CAPACITY;
+const uint32_t PacketQueuePriority4::DEFAULT_TARGET_DELAY;
+const uint32_t PacketQueuePriority4::DEFAULT_INTERVAL;
+
+PacketQueuePriority4::SubQueue::SubQueue()
+    : entries_(), weight_(1), credits_(0), first_above_time_(),
+      drop_next_(), count_(0), last_count_(0), dropping_(false) {
+    for (size_t i = 0; i < REASON_COUNT; ++i) {
+        drops_[i] = 0;
+    }
+}
+
+PacketQueuePriority4::PacketQueuePriority4(const string& queue_type,
+                                           size_t capacity)
+    : PacketQueue<Pkt4Ptr>(queue_type), capacity_(capacity), size_(0),
+      current_(CLASS_COUNT - 1),
+      target_delay_(chrono::milliseconds(DEFAULT_TARGET_DELAY)),
+      interval_(chrono::milliseconds(DEFAULT_INTERVAL)),
+      mutex_(new mutex) {
+    if (capacity < MIN_CAPACITY) {
+        isc_throw(BadValue, "Queue capacity of " << capacity
+                  << " is invalid.  It must be at least " << MIN_CAPACITY);
+    }
+    queues_[RENEW].weight_ = 8;
+    queues_[REQUEST].weight_ = 4;
+    queues_[OTHER].weight_ = 2;
+    queues_[DISCOVER].weight_ = 1;
+}
+
+void
+PacketQueuePriority4::enqueuePacket(Pkt4Ptr packet, const SocketInfo&) {
+    const Clock::time_point time = now();
+    lock_guard<mutex> lock(*mutex_);
+    pushPacket(packet, time);
+}
+
+void
+PacketQueuePriority4::enqueuePackets(const vector<Pkt4Ptr>& packets,
+                                     const SocketInfo&) {
+    const Clock::time_point time = now();
+    lock_guard<mutex> lock(*mutex_);
+    for (auto const& packet : packets) {
+        pushPacket(packet, time);
+    }
+}
+
+void
+PacketQueuePriority4::pushPacket(const Pkt4Ptr& packet,
+                                 Clock::time_point time) {
+    const size_t index = classify(packet);
+    if (size_ >= capacity_) {
+        // Make room by dropping the oldest packet of the least important
+        // class which is not more important than the new packet.
+        size_t victim = CLASS_COUNT;
+        for (size_t i = 0; i < CLASS_COUNT; ++i) {
+            if (queues_[i].entries_.empty() ||
+                (queues_[i].weight_ > queues_[index].weight_)) {
+                continue;
+            }
+            if ((victim == CLASS_COUNT) ||
+                (queues_[i].weight_ <= queues_[victim].weight_)) {
+                victim = i;
+            }
+        }
+        if (victim == CLASS_COUNT) {
+            ++queues_[index].drops_[DROP_OVERFLOW];
+            return;
+        }
+        queues_[victim].entries_.pop_front();
+        ++queues_[victim].drops_[DROP_OVERFLOW];
+        --size_;
+    }
+    Entry entry;
+    entry.packet_ = packet;
+    entry.enqueued_ = time;
+    queues_[index].entries_.push_back(entry);
+    ++size_;
+}
+
+Pkt4Ptr
+PacketQueuePriority4::dequeuePacket() {
+    const Clock::time_point time = now();
+    lock_guard<mutex> lock(*mutex_);
+    for (;;) {
+        const size_t index = selectSubQueue();
+        if (index == CLASS_COUNT) {
+            return (Pkt4Ptr());
+        }
+        Pkt4Ptr packet = codelDequeue(index, time);
+        if (packet) {
+            return (packet);
+        }
+        // All the packets of the sub-queue were dropped: try the others.
+    }
+}
+
+size_t
+PacketQueuePriority4::selectSubQueue() {
+    if (size_ == 0) {
+        return (CLASS_COUNT);
+    }
+    // Continue with the current sub-queue while it has credits.
+    if (queues_[current_].credits_ > 0 &&
+        !queues_[current_].entries_.empty()) {
+        --queues_[current_].credits_;
+        return (current_);
+    }
+    for (size_t i = 1; i <= CLASS_COUNT; ++i) {
+        const size_t index = (current_ + i) % CLASS_COUNT;
+        if (queues_[index].entries_.empty()) {
+            queues_[index].credits_ = 0;
+            continue;
+        }
+        current_ = index;
+        queues_[index].credits_ = queues_[index].weight_ - 1;
+        return (index);
+    }
+    // Not reached: size_ is not zero.
+    return (CLASS_COUNT);
+}
+
+Pkt4Ptr
+PacketQueuePriority4::codelPop(size_t index, Clock::time_point time,
+                               bool& ok_to_drop) {
+    SubQueue& queue = queues_[index];
+    ok_to_drop = false;
+    if (queue.entries_.empty()) {
+        queue.first_above_time_ = Clock::time_point();
+        return (Pkt4Ptr());
+    }
+    Entry entry = queue.entries_.front();
+    queue.entries_.pop_front();
+    --size_;
+    if (target_delay_ == Clock::duration::zero()) {
+        return (entry.packet_);
+    }
+    const Clock::duration sojourn = time - entry.enqueued_;
+    if (sojourn < target_delay_) {
+        // Went below the target delay: stay below for at least an
+        // interval.
+        queue.first_above_time_ = Clock::time_point();
+    } else if (queue.first_above_time_ == Clock::time_point()) {
+        // Just went above the target delay: drop if it lasts an interval.
+        queue.first_above_time_ = time + interval_;
+    } else if (time >= queue.first_above_time_) {
+        ok_to_drop = true;
+    }
+    return (entry.packet_);
+}
+
+PacketQueuePriority4::Clock::time_point
+PacketQueuePriority4::controlLaw(Clock::time_point time,
+                                 uint32_t count) const {
+    return (time + chrono::duration_cast<Clock::duration>(
+                interval_ / sqrt(static_cast<double>(count))));
+}
+
+Pkt4Ptr
+PacketQueuePriority4::codelDequeue(size_t index, Clock::time_point time) {
+    SubQueue& queue = queues_[index];
+    bool ok_to_drop;
+    Pkt4Ptr packet = codelPop(index, time, ok_to_drop);
+    if (!packet) {
+        queue.dropping_ = false;
+        return (packet);
+    }
+    if (queue.dropping_) {
+        if (!ok_to_drop) {
+            // Sojourn time went below the target: leave dropping state.
+            queue.dropping_ = false;
+        }
+        while (queue.dropping_ && (time >= queue.drop_next_)) {
+            ++queue.drops_[DROP_SOJOURN];
+            ++queue.count_;
+            packet = codelPop(index, time, ok_to_drop);
+            if (!packet) {
+                queue.dropping_ = false;
+                return (packet);
+            }
+            if (!ok_to_drop) {
+                queue.dropping_ = false;
+            } else {
+                queue.drop_next_ = controlLaw(queue.drop_next_, queue.count_);
+            }
+        }
+    } else if (ok_to_drop) {
+        // Enter dropping state, drop this packet and deliver the next one.
+        ++queue.drops_[DROP_SOJOURN];
+        packet = codelPop(index, time, ok_to_drop);
+        queue.dropping_ = true;
+        // Restart from the previous drop rate if dropping state was left
+        // recently.
+        const uint32_t delta = queue.count_ - queue.last_count_;
+        if ((delta > 1) && (time - queue.drop_next_ < 16 * interval_)) {
+            queue.count_ = delta;
+        } else {
+            queue.count_ = 1;
+        }
+        queue.drop_next_ = controlLaw(time, queue.count_);
+        queue.last_count_ = queue.count_;
+    }
+    return (packet);
+}
+
+bool
+PacketQueuePriority4::empty() const {
+    lock_guard<mutex> lock(*mutex_);
+    return (size_ == 0);
+}
+
+size_t
+PacketQueuePriority4::getSize() const {
+    lock_guard<mutex> lock(*mutex_);
+    return (size_);
+}
+
+size_t
+PacketQueuePriority4::getSize(PacketClass packet_class) const {
+    if (packet_class >= CLASS_COUNT) {
+        isc_throw(BadValue, "invalid packet class " << packet_class);
+    }
+    lock_guard<mutex> lock(*mutex_);
+    return (queues_[packet_class].entries_.size());
+}
+
+void
+PacketQueuePriority4::clear() {
+    lock_guard<mutex> lock(*mutex_);
+    for (size_t i = 0; i < CLASS_COUNT; ++i) {
+        queues_[i].entries_.clear();
+        queues_[i].credits_ = 0;
+        queues_[i].first_above_time_ = Clock::time_point();
+        queues_[i].dropping_ = false;
+    }
+    size_ = 0;
+    current_ = CLASS_COUNT - 1;
+}
+
+void
+PacketQueuePriority4::setWeight(PacketClass packet_class, uint32_t weight) {
+    if (packet_class >= CLASS_COUNT) {
+        isc_throw(BadValue, "invalid packet class " << packet_class);
+    }
+    if (weight == 0) {
+        isc_throw(BadValue, "the weight of the " << className(packet_class)
+                  << " packets must be greater than 0");
+    }
+    lock_guard<mutex> lock(*mutex_);
+    queues_[packet_class].weight_ = weight;
+    if (queues_[packet_class].credits_ >= weight) {
+        queues_[packet_class].credits_ = weight - 1;
+    }
+}
+
+uint32_t
+PacketQueuePriority4::getWeight(PacketClass packet_class) const {
+    if (packet_class >= CLASS_COUNT) {
+        isc_throw(BadValue, "invalid packet class " << packet_class);
+    }
+    lock_guard<mutex> lock(*mutex_);
+    return (queues_[packet_class].weight_);
+}
+
+void
+PacketQueuePriority4::setTargetDelay(uint32_t target_delay) {
+    lock_guard<mutex> lock(*mutex_);
+    target_delay_ = chrono::milliseconds(target_delay);
+}
+
+uint32_t
+PacketQueuePriority4::getTargetDelay() const {
+    lock_guard<mutex> lock(*mutex_);
+    return (chrono::duration_cast<chrono::milliseconds>(target_delay_).count());
+}
+
+void
+PacketQueuePriority4::setInterval(uint32_t interval) {
+    if (interval == 0) {
+        isc_throw(BadValue, "the interval must be greater than 0");
+    }
+    lock_guard<mutex> lock(*mutex_);
+    interval_ = chrono::milliseconds(interval);
+}
+
+uint32_t
+PacketQueuePriority4::getInterval() const {
+    lock_guard<mutex> lock(*mutex_);
+    return (chrono::duration_cast<chrono::milliseconds>(interval_).count());
+}
+
+uint64_t
+PacketQueuePriority4::getDropCount(PacketClass packet_class,
+                                   DropReason reason) const {
+    if (packet_class >= CLASS_COUNT) {
+        isc_throw(BadValue, "invalid packet class " << packet_class);
+    }
+    if (reason >= REASON_COUNT) {
+        isc_throw(BadValue, "invalid drop reason " << reason);
+    }
+    lock_guard<mutex> lock(*mutex_);
+    return (queues_[packet_class].drops_[reason]);
+}
+
+ElementPtr
+PacketQueuePriority4::getInfo() const {
+    ElementPtr info = PacketQueue<Pkt4Ptr>::getInfo();
+    lock_guard<mutex> lock(*mutex_);
+    info->set("capacity", Element::create(static_cast<int64_t>(capacity_)));
+    info->set("size", Element::create(static_cast<int64_t>(size_)));
+    info->set("target-delay", Element::create(static_cast<int64_t>(
+        chrono::duration_cast<chrono::milliseconds>(target_delay_).count())));
+    info->set("interval", Element::create(static_cast<int64_t>(
+        chrono::duration_cast<chrono::milliseconds>(interval_).count())));
+    ElementPtr sizes = Element::createMap();
+    ElementPtr weights = Element::createMap();
+    ElementPtr drops = Element::createMap();
+    ElementPtr reasons[REASON_COUNT];
+    for (size_t i = 0; i < REASON_COUNT; ++i) {
+        reasons[i] = Element::createMap();
+        drops->set(reasonName(static_cast<DropReason>(i)), reasons[i]);
+    }
+    for (size_t i = 0; i < CLASS_COUNT; ++i) {
+        const string name = className(static_cast<PacketClass>(i));
+        sizes->set(name, Element::create(static_cast<int64_t>(
+            queues_[i].entries_.size())));
+        weights->set(name, Element::create(static_cast<int64_t>(
+            queues_[i].weight_)));
+        for (size_t j = 0; j < REASON_COUNT; ++j) {
+            reasons[j]->set(name, Element::create(static_cast<int64_t>(
+                queues_[i].drops_[j])));
+        }
+    }
+    info->set("sizes", sizes);
+    info->set("weights", weights);
+    info->set("drops", drops);
+    return (info);
+}
+
+PacketQueuePriority4::PacketClass
+PacketQueuePriority4::classify(const Pkt4Ptr& packet) {
+    if (!packet) {
+        return (OTHER);
+    }
+    const OptionBuffer& data = packet->data_;
+    const size_t cookie_offset = Pkt4::DHCPV4_PKT_HDR_LEN;
+    if (data.size() < cookie_offset + 4) {
+        return (OTHER);
+    }
+    const uint32_t cookie = (data[cookie_offset] << 24) |
+        (data[cookie_offset + 1] << 16) | (data[cookie_offset + 2] << 8) |
+        data[cookie_offset + 3];
+    if (cookie != DHCP_OPTIONS_COOKIE) {
+        // BOOTP.
+        return (OTHER);
+    }
+    // Look for the message type option.
+    size_t offset = cookie_offset + 4;
+    while (offset < data.size()) {
+        const uint8_t code = data[offset];
+        if (code == DHO_PAD) {
+            ++offset;
+            continue;
+        }
+        if ((code == DHO_END) || (offset + 1 >= data.size())) {
+            break;
+        }
+        const size_t len = data[offset + 1];
+        if (offset + 2 + len > data.size()) {
+            break;
+        }
+        if (code != DHO_DHCP_MESSAGE_TYPE) {
+            offset += 2 + len;
+            continue;
+        }
+        if (len != 1) {
+            break;
+        }
+        switch (data[offset + 2]) {
+        case DHCPDISCOVER:
+            return (DISCOVER);
+        case DHCPREQUEST:
+            // A client renewing or rebinding its lease fills the client
+            // address field (offset 12 in the header).
+            for (size_t i = 12; i < 16; ++i) {
+                if (data[i] != 0) {
+                    return (RENEW);
+                }
+            }
+            return (REQUEST);
+        default:
+            return (OTHER);
+        }
+    }
+    return (OTHER);
+}
+
+string
+PacketQueuePriority4::className(PacketClass packet_class) {
+    switch (packet_class) {
+    case RENEW:
+        return ("renew");
+    case REQUEST:
+        return ("request");
+    case OTHER:
+        return ("other");
+    case DISCOVER:
+        return ("discover");
+    default:
+        return ("unknown");
+    }
+}
+
+string
+PacketQueuePriority4::reasonName(DropReason reason) {
+    switch (reason) {
+    case DROP_OVERFLOW:
+        return ("overflow");
+    case DROP_SOJOURN:
+        return ("sojourn");
+    default:
+        return ("unknown");
+    }
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
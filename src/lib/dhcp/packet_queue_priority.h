@@ -0,0 +1,312 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PACKET_QUEUE_PRIORITY_H
+#define PACKET_QUEUE_PRIORITY_H
+
+#include <dhcp/packet_queue.h>
+
+#include <boost/scoped_ptr.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Provides a priority aware implementation of the PacketQueue
+/// interface for DHCPv4 packets.
+///
+/// The packets are classified by their message type into sub-queues:
+///  - RENEW: DHCPREQUEST with a client address, i.e. sent by a client
+///    renewing or rebinding a lease it already holds,
+///  - REQUEST: other DHCPREQUEST,
+///  - OTHER: DHCPRELEASE, DHCPDECLINE, DHCPINFORM, BOOTP and packets
+///    which can't be classified,
+///  - DISCOVER: DHCPDISCOVER.
+///
+/// The packets are dequeued from the sub-queues in weighted round robin
+/// order. When the queue is full the oldest packet of the least important
+/// sub-queue, i.e. the sub-queue with the lowest weight, is dropped to make
+/// room, or the new packet itself when it is less important than all the
+/// queued packets.
+///
+/// Each sub-queue also drops packets which wait too long using the CoDel
+/// (RFC 8289) control law: when the sojourn time of the packets stays
+/// above the target delay for an interval, packets are dropped at the
+/// head of the sub-queue at an increasing rate until the sojourn time
+/// goes back below the target.
+///
+/// The packets have not been unpacked when they are queued so the
+/// classification reads the message type option from the raw data.
+class PacketQueuePriority4 : public PacketQueue<Pkt4Ptr> {
+public:
+    /// @brief Packet classes, in decreasing default importance.
+    enum PacketClass {
+        RENEW = 0,
+        REQUEST = 1,
+        OTHER = 2,
+        DISCOVER = 3,
+        CLASS_COUNT = 4
+    };
+
+    /// @brief Reasons a packet is dropped.
+    enum DropReason {
+        /// @brief The queue was full.
+        DROP_OVERFLOW = 0,
+        /// @brief The packet waited too long in the queue.
+        DROP_SOJOURN = 1,
+        REASON_COUNT = 2
+    };
+
+    /// @brief Type of the clock used to measure the sojourn time.
+    typedef std::chrono::steady_clock Clock;
+
+    /// @brief Minimum queue capacity permitted.
+    static const size_t MIN_CAPACITY = 5;
+
+    /// @brief Default target delay in milliseconds.
+    static const uint32_t DEFAULT_TARGET_DELAY = 50;
+
+    /// @brief Default interval in milliseconds.
+    static const uint32_t DEFAULT_INTERVAL = 500;
+
+    /// @brief Constructor
+    ///
+    /// The default weights are 8, 4, 2 and 1 for the RENEW, REQUEST, OTHER
+    /// and DISCOVER classes.
+    ///
+    /// @param queue_type logical name of the queue implementation
+    /// @param capacity maximum number of packets the queue can hold
+    /// @throw BadValue if capacity is too low.
+    PacketQueuePriority4(const std::string& queue_type, size_t capacity);
+
+    /// @brief virtual Destructor
+    virtual ~PacketQueuePriority4() {
+    }
+
+    /// @brief Adds a packet to the queue
+    ///
+    /// @param packet packet to enqueue
+    /// @param source socket the packet came from
+    virtual void enqueuePacket(Pkt4Ptr packet, const SocketInfo& source);
+
+    /// @brief Adds a batch of packets to the queue
+    ///
+    /// The queue's Mutex is taken only once.
+    ///
+    /// @param packets packets to enqueue
+    /// @param source socket the packets came from
+    virtual void enqueuePackets(const std::vector<Pkt4Ptr>& packets,
+                                const SocketInfo& source);
+
+    /// @brief Dequeues the next packet from the queue
+    ///
+    /// @return A pointer to dequeued packet, or an empty pointer
+    /// if the queue is empty.
+    virtual Pkt4Ptr dequeuePacket();
+
+    /// @brief Returns True if the queue is empty.
+    virtual bool empty() const;
+
+    /// @brief Returns the current number of packets in the queue.
+    virtual size_t getSize() const;
+
+    /// @brief Returns the current number of packets of a class.
+    ///
+    /// @param packet_class the packet class
+    size_t getSize(PacketClass packet_class) const;
+
+    /// @brief Discards all packets currently in the queue.
+    virtual void clear();
+
+    /// @brief Returns the maximum number of packets allowed in the queue.
+    size_t getCapacity() const {
+        return (capacity_);
+    }
+
+    /// @brief Sets the weight of a packet class.
+    ///
+    /// @param packet_class the packet class
+    /// @param weight the number of packets of the class dequeued in a
+    /// round
+    /// @throw BadValue if the class is invalid or the weight is zero.
+    void setWeight(PacketClass packet_class, uint32_t weight);
+
+    /// @brief Returns the weight of a packet class.
+    ///
+    /// @param packet_class the packet class
+    uint32_t getWeight(PacketClass packet_class) const;
+
+    /// @brief Sets the CoDel target delay.
+    ///
+    /// @param target_delay the acceptable sojourn time in milliseconds,
+    /// 0 disables the sojourn time dropping
+    void setTargetDelay(uint32_t target_delay);
+
+    /// @brief Returns the CoDel target delay in milliseconds.
+    uint32_t getTargetDelay() const;
+
+    /// @brief Sets the CoDel interval.
+    ///
+    /// @param interval the time in milliseconds the sojourn time must stay
+    /// above the target delay before packets are dropped
+    /// @throw BadValue if the interval is zero.
+    void setInterval(uint32_t interval);
+
+    /// @brief Returns the CoDel interval in milliseconds.
+    uint32_t getInterval() const;
+
+    /// @brief Returns the number of dropped packets.
+    ///
+    /// @param packet_class the class of the dropped packets
+    /// @param reason the reason of the drops
+    uint64_t getDropCount(PacketClass packet_class, DropReason reason) const;
+
+    /// @brief Fetches pertinent information
+    ///
+    /// In addition to the capacity and size it gives the weights, the
+    /// CoDel parameters, the size of each class and the drop counts by
+    /// reason and class.
+    virtual data::ElementPtr getInfo() const;
+
+    /// @brief Classifies a packet.
+    ///
+    /// @param packet the packet, not yet unpacked
+    /// @return the class of the packet
+    static PacketClass classify(const Pkt4Ptr& packet);
+
+    /// @brief Returns the name of a packet class.
+    ///
+    /// @param packet_class the packet class
+    /// @return "renew", "request", "other" or "discover"
+    static std::string className(PacketClass packet_class);
+
+    /// @brief Returns the name of a drop reason.
+    ///
+    /// @param reason the drop reason
+    /// @return "overflow" or "sojourn"
+    static std::string reasonName(DropReason reason);
+
+protected:
+    /// @brief Returns the current time.
+    ///
+    /// Derivations can override it for testing.
+    virtual Clock::time_point now() const {
+        return (Clock::now());
+    }
+
+private:
+    /// @brief A queued packet.
+    struct Entry {
+        /// @brief The packet.
+        Pkt4Ptr packet_;
+
+        /// @brief The time the packet was queued.
+        Clock::time_point enqueued_;
+    };
+
+    /// @brief A sub-queue with its CoDel state.
+    struct SubQueue {
+        /// @brief Constructor.
+        SubQueue();
+
+        /// @brief The queued packets.
+        std::deque<Entry> entries_;
+
+        /// @brief The weight of the class.
+        uint32_t weight_;
+
+        /// @brief The number of packets which can still be dequeued in
+        /// the current round.
+        uint32_t credits_;
+
+        /// @brief The time the sojourn time went above the target plus
+        /// the interval or the epoch.
+        Clock::time_point first_above_time_;
+
+        /// @brief The time of the next drop in dropping state.
+        Clock::time_point drop_next_;
+
+        /// @brief The number of drops since entering dropping state.
+        uint32_t count_;
+
+        /// @brief The value of count_ when leaving dropping state.
+        uint32_t last_count_;
+
+        /// @brief The dropping state.
+        bool dropping_;
+
+        /// @brief The drop counts by reason.
+        uint64_t drops_[REASON_COUNT];
+    };
+
+    /// @brief Adds a packet with the Mutex held.
+    ///
+    /// @param packet the packet
+    /// @param time the current time
+    void pushPacket(const Pkt4Ptr& packet, Clock::time_point time);
+
+    /// @brief Selects the sub-queue to dequeue from in weighted round
+    /// robin order with the Mutex held.
+    ///
+    /// @return the index of the sub-queue or CLASS_COUNT if all the
+    /// sub-queues are empty
+    size_t selectSubQueue();
+
+    /// @brief Takes the head packet of a sub-queue applying the CoDel
+    /// control law with the Mutex held.
+    ///
+    /// @param index the index of the sub-queue
+    /// @param time the current time
+    /// @return the packet or an empty pointer if all the packets of the
+    /// sub-queue were dropped
+    Pkt4Ptr codelDequeue(size_t index, Clock::time_point time);
+
+    /// @brief Pops the head packet of a sub-queue and checks its sojourn
+    /// time with the Mutex held.
+    ///
+    /// @param index the index of the sub-queue
+    /// @param time the current time
+    /// @param ok_to_drop set to true when the packet can be dropped
+    /// @return the packet or an empty pointer if the sub-queue is empty
+    Pkt4Ptr codelPop(size_t index, Clock::time_point time, bool& ok_to_drop);
+
+    /// @brief Returns the CoDel next drop time.
+    ///
+    /// @param time the reference time
+    /// @param count the number of drops
+    Clock::time_point controlLaw(Clock::time_point time, uint32_t count) const;
+
+    /// @brief The maximum number of packets.
+    size_t capacity_;
+
+    /// @brief The number of queued packets.
+    size_t size_;
+
+    /// @brief The sub-queues.
+    SubQueue queues_[CLASS_COUNT];
+
+    /// @brief The sub-queue dequeued from last.
+    size_t current_;
+
+    /// @brief The CoDel target delay.
+    Clock::duration target_delay_;
+
+    /// @brief The CoDel interval.
+    Clock::duration interval_;
+
+    /// @brief Mutex for protecting queue accesses.
+    boost::scoped_ptr<std::mutex> mutex_;
+};
+
+}; // namespace isc::dhcp
+}; // namespace isc
+
+#endif // PACKET_QUEUE_PRIORITY_H
@@ -56,6 +56,32 @@ public:
         }
     }
 
+    /// @brief Adds a batch of packets to the queue
+    ///
+    /// Calls @c shouldDropPacket for each packet and adds the packets
+    /// which should be queued to the back of the queue with the queue's
+    /// Mutex taken only once.
+    ///
+    /// @param packets packets to enqueue
+    /// @param source socket the packets came from
+    virtual void enqueuePackets(const std::vector<PacketTypePtr>& packets,
+                                const SocketInfo& source) {
+        std::vector<PacketTypePtr> kept;
+        kept.reserve(packets.size());
+        for (auto const& packet : packets) {
+            if (!shouldDropPacket(packet, source)) {
+                kept.push_back(packet);
+            }
+        }
+        if (kept.empty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(*mutex_);
+        for (auto const& packet : kept) {
+            queue_.push_back(packet);
+        }
+    }
+
     /// @brief Dequeues the next packet from the queue
     ///
     /// Dequeues the next packet (if any) and returns it.
@@ -0,0 +1,398 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <cc/simple_parser.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/dhcp6.h>
+#include <dhcp/packet_rate_limiter.h>
+#include <exceptions/exceptions.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace std;
+
+namespace {
+
+/// @brief Tag of a relay key built from a relay identifier.
+const uint8_t RELAY_ID_TAG = 1;
+
+/// @brief Tag of a relay key built from a relay address.
+const uint8_t RELAY_ADDRESS_TAG = 2;
+
+/// @brief Offset of the DHCPv6 relay message options.
+const size_t DHCPV6_RELAY_HDR_LEN = 34;
+
+/// @brief Offset of the DHCPv6 client message options.
+const size_t DHCPV6_HDR_LEN = 4;
+
+/// @brief Returns the FNV-1a hash of a key.
+///
+/// @param key the key.
+uint64_t
+hashKey(const vector<uint8_t>& key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (auto const& c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return (hash);
+}
+
+/// @brief Looks for a DHCPv4 option in a buffer of options.
+///
+/// @param data the buffer.
+/// @param begin the offset of the first option.
+/// @param end the offset after the last option.
+/// @param code the option code.
+/// @param offset set to the offset of the option data.
+/// @param len set to the length of the option data.
+/// @return true if the option was found.
+bool
+findOption4(const OptionBuffer& data, size_t begin, size_t end,
+            uint8_t code, size_t& offset, size_t& len) {
+    while (begin < end) {
+        const uint8_t current = data[begin];
+        if (current == DHO_PAD) {
+            ++begin;
+            continue;
+        }
+        if ((current == DHO_END) || (begin + 1 >= end)) {
+            return (false);
+        }
+        len = data[begin + 1];
+        if (begin + 2 + len > end) {
+            return (false);
+        }
+        if (current == code) {
+            offset = begin + 2;
+            return (true);
+        }
+        begin += 2 + len;
+    }
+    return (false);
+}
+
+/// @brief Looks for a DHCPv6 option in a buffer of options.
+///
+/// @param data the buffer.
+/// @param begin the offset of the first option.
+/// @param end the offset after the last option.
+/// @param code the option code.
+/// @param offset set to the offset of the option data.
+/// @param len set to the length of the option data.
+/// @return true if the option was found.
+bool
+findOption6(const OptionBuffer& data, size_t begin, size_t end,
+            uint16_t code, size_t& offset, size_t& len) {
+    while (begin + 4 <= end) {
+        const uint16_t current = (data[begin] << 8) | data[begin + 1];
+        len = (data[begin + 2] << 8) | data[begin + 3];
+        if (begin + 4 + len > end) {
+            return (false);
+        }
+        if (current == code) {
+            offset = begin + 4;
+            return (true);
+        }
+        begin += 4 + len;
+    }
+    return (false);
+}
+
+}
+
+namespace isc {
+namespace dhcp {
+
+const size_t PacketRateLimiter::ROWS;
+const size_t PacketRateLimiter::DEFAULT_BUCKETS;
+
+PacketRateLimiter::PacketRateLimiter(size_t buckets)
+    : buckets_(buckets) {
+    if (buckets == 0) {
+        isc_throw(BadValue, "the number of buckets must be greater than 0");
+    }
+    for (size_t i = 0; i < KEY_TYPE_COUNT; ++i) {
+        limits_[i].rate_ = 0;
+        limits_[i].burst_ = 0;
+        limits_[i].drops_ = 0;
+    }
+}
+
+PacketRateLimiterPtr
+PacketRateLimiter::create(ConstElementPtr config) {
+    if (!config || (config->getType() != Element::map)) {
+        isc_throw(BadValue, "rate-limit must be a map");
+    }
+    const uint32_t max = numeric_limits<uint32_t>::max();
+    PacketRateLimiterPtr limiter;
+    try {
+        size_t buckets = DEFAULT_BUCKETS;
+        if (config->contains("buckets")) {
+            buckets = SimpleParser::getInteger(config, "buckets", 1, 1 << 24);
+        }
+        limiter.reset(new PacketRateLimiter(buckets));
+        const char* names[KEY_TYPE_COUNT] = { "client", "relay" };
+        for (size_t i = 0; i < KEY_TYPE_COUNT; ++i) {
+            const string name(names[i]);
+            uint32_t rate = 0;
+            if (config->contains(name + "-rate")) {
+                rate = SimpleParser::getInteger(config, name + "-rate", 0, max);
+            }
+            uint32_t burst = rate;
+            if (config->contains(name + "-burst")) {
+                burst = SimpleParser::getInteger(config, name + "-burst", 1, max);
+            }
+            limiter->setLimit(static_cast<KeyType>(i), rate, burst);
+        }
+    } catch (const std::exception& ex) {
+        isc_throw(BadValue, "invalid rate-limit: " << ex.what());
+    }
+    return (limiter);
+}
+
+void
+PacketRateLimiter::setLimit(KeyType key_type, uint32_t rate, uint32_t burst) {
+    if (key_type >= KEY_TYPE_COUNT) {
+        isc_throw(BadValue, "invalid key type " << key_type);
+    }
+    if ((rate != 0) && (burst == 0)) {
+        isc_throw(BadValue, "the burst must be greater than 0");
+    }
+    lock_guard<mutex> lock(mutex_);
+    Limit& limit = limits_[key_type];
+    limit.rate_ = rate;
+    limit.burst_ = burst;
+    if (rate == 0) {
+        limit.buckets_.clear();
+        limit.buckets_.shrink_to_fit();
+    } else {
+        Bucket empty;
+        empty.level_ = 0.;
+        empty.last_ = Clock::time_point();
+        limit.buckets_.assign(ROWS * buckets_, empty);
+    }
+}
+
+uint32_t
+PacketRateLimiter::getRate(KeyType key_type) const {
+    if (key_type >= KEY_TYPE_COUNT) {
+        isc_throw(BadValue, "invalid key type " << key_type);
+    }
+    lock_guard<mutex> lock(mutex_);
+    return (limits_[key_type].rate_);
+}
+
+uint32_t
+PacketRateLimiter::getBurst(KeyType key_type) const {
+    if (key_type >= KEY_TYPE_COUNT) {
+        isc_throw(BadValue, "invalid key type " << key_type);
+    }
+    lock_guard<mutex> lock(mutex_);
+    return (limits_[key_type].burst_);
+}
+
+bool
+PacketRateLimiter::isEnabled() const {
+    lock_guard<mutex> lock(mutex_);
+    for (size_t i = 0; i < KEY_TYPE_COUNT; ++i) {
+        if (limits_[i].rate_ != 0) {
+            return (true);
+        }
+    }
+    return (false);
+}
+
+uint64_t
+PacketRateLimiter::getDropCount(KeyType key_type) const {
+    if (key_type >= KEY_TYPE_COUNT) {
+        isc_throw(BadValue, "invalid key type " << key_type);
+    }
+    lock_guard<mutex> lock(mutex_);
+    return (limits_[key_type].drops_);
+}
+
+ElementPtr
+PacketRateLimiter::getInfo() const {
+    ElementPtr info = Element::createMap();
+    const char* names[KEY_TYPE_COUNT] = { "client", "relay" };
+    lock_guard<mutex> lock(mutex_);
+    info->set("buckets", Element::create(static_cast<int64_t>(buckets_)));
+    for (size_t i = 0; i < KEY_TYPE_COUNT; ++i) {
+        const string name(names[i]);
+        info->set(name + "-rate",
+                  Element::create(static_cast<int64_t>(limits_[i].rate_)));
+        info->set(name + "-burst",
+                  Element::create(static_cast<int64_t>(limits_[i].burst_)));
+        info->set(name + "-drops",
+                  Element::create(static_cast<int64_t>(limits_[i].drops_)));
+    }
+    return (info);
+}
+
+bool
+PacketRateLimiter::allow(const Pkt4Ptr& pkt) {
+    if (!pkt) {
+        return (true);
+    }
+    vector<uint8_t> client;
+    vector<uint8_t> relay;
+    getKeys4(pkt->data_, client, relay);
+    return (allowKeys(client, relay));
+}
+
+bool
+PacketRateLimiter::allow(const Pkt6Ptr& pkt) {
+    if (!pkt) {
+        return (true);
+    }
+    vector<uint8_t> client;
+    vector<uint8_t> relay;
+    getKeys6(pkt->data_, pkt->getRemoteAddr(), client, relay);
+    return (allowKeys(client, relay));
+}
+
+bool
+PacketRateLimiter::allowKey(KeyType key_type, const vector<uint8_t>& key) {
+    if (key_type >= KEY_TYPE_COUNT) {
+        isc_throw(BadValue, "invalid key type " << key_type);
+    }
+    const Clock::time_point time = now();
+    lock_guard<mutex> lock(mutex_);
+    return (allowKeyInternal(key_type, key, time));
+}
+
+bool
+PacketRateLimiter::allowKeys(const vector<uint8_t>& client,
+                             const vector<uint8_t>& relay) {
+    const Clock::time_point time = now();
+    lock_guard<mutex> lock(mutex_);
+    // The client is checked first so the packets of a flooding client
+    // behind a relay do not use the relay tokens.
+    return (allowKeyInternal(CLIENT, client, time) &&
+            allowKeyInternal(RELAY, relay, time));
+}
+
+bool
+PacketRateLimiter::allowKeyInternal(KeyType key_type, const vector<uint8_t>& key,
+                                    Clock::time_point time) {
+    Limit& limit = limits_[key_type];
+    if ((limit.rate_ == 0) || key.empty()) {
+        return (true);
+    }
+    const uint64_t hash = hashKey(key);
+    Bucket* buckets[ROWS];
+    double level = numeric_limits<double>::max();
+    for (size_t row = 0; row < ROWS; ++row) {
+        const size_t index = static_cast<uint32_t>(hash >> (32 * row)) % buckets_;
+        Bucket& bucket = limit.buckets_[row * buckets_ + index];
+        // Leak the bucket since its last update.
+        const double elapsed =
+            chrono::duration_cast<chrono::duration<double>>(time - bucket.last_).count();
+        if (elapsed > 0.) {
+            bucket.level_ = max(0., bucket.level_ - elapsed * limit.rate_);
+            bucket.last_ = time;
+        }
+        level = min(level, bucket.level_);
+        buckets[row] = &bucket;
+    }
+    if (level + 1. > limit.burst_) {
+        ++limit.drops_;
+        return (false);
+    }
+    // Conservative update: raise only the buckets at the minimum.
+    for (size_t row = 0; row < ROWS; ++row) {
+        buckets[row]->level_ = max(buckets[row]->level_, level + 1.);
+    }
+    return (true);
+}
+
+void
+PacketRateLimiter::getKeys4(const OptionBuffer& data, vector<uint8_t>& client,
+                            vector<uint8_t>& relay) {
+    client.clear();
+    relay.clear();
+    if (data.size() < Pkt4::DHCPV4_PKT_HDR_LEN) {
+        return;
+    }
+    // Hardware type at offset 1, length at offset 2 and address at 28.
+    const size_t hlen = min(static_cast<size_t>(data[2]),
+                            static_cast<size_t>(Pkt4::MAX_CHADDR_LEN));
+    if (hlen > 0) {
+        client.push_back(data[1]);
+        client.insert(client.end(), data.begin() + 28, data.begin() + 28 + hlen);
+    }
+    // The relay identifier sub-option of the relay agent information.
+    const size_t options = Pkt4::DHCPV4_PKT_HDR_LEN + 4;
+    size_t offset;
+    size_t len;
+    if ((data.size() >= options) &&
+        findOption4(data, options, data.size(), DHO_DHCP_AGENT_OPTIONS,
+                    offset, len) &&
+        findOption4(data, offset, offset + len, RAI_OPTION_RELAY_ID,
+                    offset, len) && (len > 0)) {
+        relay.push_back(RELAY_ID_TAG);
+        relay.insert(relay.end(), data.begin() + offset,
+                     data.begin() + offset + len);
+        return;
+    }
+    // The giaddr at offset 24.
+    if ((data[24] | data[25] | data[26] | data[27]) != 0) {
+        relay.push_back(RELAY_ADDRESS_TAG);
+        relay.insert(relay.end(), data.begin() + 24, data.begin() + 28);
+    }
+}
+
+void
+PacketRateLimiter::getKeys6(const OptionBuffer& data, const IOAddress& source,
+                            vector<uint8_t>& client, vector<uint8_t>& relay) {
+    client.clear();
+    relay.clear();
+    size_t begin = 0;
+    size_t end = data.size();
+    size_t offset;
+    size_t len;
+    if ((end > 0) && (data[0] == DHCPV6_RELAY_FORW)) {
+        // Use the relay identifier of the relay next to the server or
+        // its address.
+        if ((end >= DHCPV6_RELAY_HDR_LEN) &&
+            findOption6(data, DHCPV6_RELAY_HDR_LEN, end, D6O_RELAY_ID,
+                        offset, len) && (len > 0)) {
+            relay.push_back(RELAY_ID_TAG);
+            relay.insert(relay.end(), data.begin() + offset,
+                         data.begin() + offset + len);
+        } else {
+            relay.push_back(RELAY_ADDRESS_TAG);
+            const vector<uint8_t>& bytes = source.toBytes();
+            relay.insert(relay.end(), bytes.begin(), bytes.end());
+        }
+        // Go down to the client message.
+        while ((end - begin > 0) && (data[begin] == DHCPV6_RELAY_FORW)) {
+            if ((end - begin < DHCPV6_RELAY_HDR_LEN) ||
+                !findOption6(data, begin + DHCPV6_RELAY_HDR_LEN, end,
+                             D6O_RELAY_MSG, offset, len)) {
+                return;
+            }
+            begin = offset;
+            end = offset + len;
+        }
+    }
+    if ((end - begin >= DHCPV6_HDR_LEN) &&
+        findOption6(data, begin + DHCPV6_HDR_LEN, end, D6O_CLIENTID,
+                    offset, len)) {
+        client.insert(client.end(), data.begin() + offset,
+                      data.begin() + offset + len);
+    }
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
@@ -0,0 +1,231 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PACKET_RATE_LIMITER_H
+#define PACKET_RATE_LIMITER_H
+
+#include <cc/data.h>
+#include <dhcp/pkt4.h>
+#include <dhcp/pkt6.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Early rate limiter of the received packets.
+///
+/// The DHCP receiver threads check each packet with this limiter before
+/// adding it to the packet queue, so floods from misbehaving clients or
+/// relays are dropped before they consume the time of the packet
+/// processing threads. The packets have not been unpacked yet so the keys
+/// are read from the raw data:
+///  - client: the hardware type and address in DHCPv4, the client
+///    identifier (DUID) in DHCPv6,
+///  - relay: the relay identifier (sub-option 12 of the relay agent
+///    information option in DHCPv4, option 53 of the outer relay in
+///    DHCPv6) or else the giaddr in DHCPv4 and the source address of the
+///    relayed packets in DHCPv6.
+///
+/// Each key type has a token bucket rate and burst shared by all the keys
+/// of the type. The per-key buckets are kept in a fixed size count-min
+/// sketch: each key is hashed to a bucket in each of the @c ROWS rows,
+/// its level is the minimum of the levels of its buckets and only the
+/// buckets at this minimum are increased (conservative update). The
+/// levels leak at the rate so a bucket at the burst level rejects the
+/// packets until some time has passed. The memory used does not depend on
+/// the number of keys: colliding keys can only be limited earlier, never
+/// later, than configured.
+class PacketRateLimiter : public boost::noncopyable {
+public:
+    /// @brief Key types.
+    enum KeyType {
+        CLIENT = 0,
+        RELAY = 1,
+        KEY_TYPE_COUNT = 2
+    };
+
+    /// @brief Type of the clock used to leak the buckets.
+    typedef std::chrono::steady_clock Clock;
+
+    /// @brief The number of rows of the sketch.
+    static const size_t ROWS = 2;
+
+    /// @brief Default number of buckets per row.
+    static const size_t DEFAULT_BUCKETS = 4096;
+
+    /// @brief Constructor.
+    ///
+    /// The limiter is created with all the rates at 0 i.e. it accepts all
+    /// the packets.
+    ///
+    /// @param buckets the number of buckets per row and key type.
+    /// @throw BadValue if buckets is zero.
+    explicit PacketRateLimiter(size_t buckets = DEFAULT_BUCKETS);
+
+    /// @brief Destructor.
+    virtual ~PacketRateLimiter() {
+    }
+
+    /// @brief Creates a limiter from its configuration.
+    ///
+    /// The configuration is a map with the optional "client-rate",
+    /// "client-burst", "relay-rate", "relay-burst" and "buckets" integer
+    /// entries. The rates are in packets per second, 0 disables the
+    /// limit, and the bursts default to the rates.
+    ///
+    /// @param config the "rate-limit" map.
+    /// @return the limiter.
+    /// @throw BadValue if the configuration is invalid.
+    static boost::shared_ptr<PacketRateLimiter> create(data::ConstElementPtr config);
+
+    /// @brief Returns the number of buckets per row.
+    size_t getBuckets() const {
+        return (buckets_);
+    }
+
+    /// @brief Sets the limit of a key type.
+    ///
+    /// @param key_type the key type.
+    /// @param rate the refill rate in packets per second, 0 disables the
+    /// limit.
+    /// @param burst the bucket size in packets.
+    /// @throw BadValue if the key type is invalid or burst is lower than 1
+    /// with a rate which is not 0.
+    void setLimit(KeyType key_type, uint32_t rate, uint32_t burst);
+
+    /// @brief Returns the rate of a key type.
+    ///
+    /// @param key_type the key type.
+    uint32_t getRate(KeyType key_type) const;
+
+    /// @brief Returns the burst of a key type.
+    ///
+    /// @param key_type the key type.
+    uint32_t getBurst(KeyType key_type) const;
+
+    /// @brief Returns true when at least one limit is enabled.
+    bool isEnabled() const;
+
+    /// @brief Checks a DHCPv4 packet.
+    ///
+    /// @param pkt the received packet, not yet unpacked.
+    /// @return true if the packet is accepted, false if it must be dropped.
+    bool allow(const Pkt4Ptr& pkt);
+
+    /// @brief Checks a DHCPv6 packet.
+    ///
+    /// @param pkt the received packet, not yet unpacked.
+    /// @return true if the packet is accepted, false if it must be dropped.
+    bool allow(const Pkt6Ptr& pkt);
+
+    /// @brief Checks a key.
+    ///
+    /// @param key_type the key type.
+    /// @param key the key, empty keys are always accepted.
+    /// @return true if the key is under its limit.
+    bool allowKey(KeyType key_type, const std::vector<uint8_t>& key);
+
+    /// @brief Returns the number of packets dropped by a key type limit.
+    ///
+    /// @param key_type the key type.
+    uint64_t getDropCount(KeyType key_type) const;
+
+    /// @brief Returns the limiter parameters and drop counts.
+    data::ElementPtr getInfo() const;
+
+    /// @brief Extracts the keys of a DHCPv4 packet.
+    ///
+    /// @param data the raw packet.
+    /// @param client set to the client key or empty.
+    /// @param relay set to the relay key or empty.
+    static void getKeys4(const OptionBuffer& data, std::vector<uint8_t>& client,
+                         std::vector<uint8_t>& relay);
+
+    /// @brief Extracts the keys of a DHCPv6 packet.
+    ///
+    /// @param data the raw packet.
+    /// @param source the source address of the packet.
+    /// @param client set to the client key or empty.
+    /// @param relay set to the relay key or empty.
+    static void getKeys6(const OptionBuffer& data,
+                         const isc::asiolink::IOAddress& source,
+                         std::vector<uint8_t>& client,
+                         std::vector<uint8_t>& relay);
+
+protected:
+    /// @brief Returns the current time.
+    ///
+    /// Derivations can override it for testing.
+    virtual Clock::time_point now() const {
+        return (Clock::now());
+    }
+
+private:
+    /// @brief A bucket of the sketch.
+    struct Bucket {
+        /// @brief The level in packets at the last update.
+        double level_;
+
+        /// @brief The time of the last update.
+        Clock::time_point last_;
+    };
+
+    /// @brief The limit and state of a key type.
+    struct Limit {
+        /// @brief The refill rate in packets per second.
+        uint32_t rate_;
+
+        /// @brief The bucket size in packets.
+        uint32_t burst_;
+
+        /// @brief The number of dropped packets.
+        uint64_t drops_;
+
+        /// @brief The buckets, @c ROWS rows of @c buckets_ buckets.
+        std::vector<Bucket> buckets_;
+    };
+
+    /// @brief Checks the keys of a packet.
+    ///
+    /// @param client the client key.
+    /// @param relay the relay key.
+    /// @return true if both keys are under their limits.
+    bool allowKeys(const std::vector<uint8_t>& client,
+                   const std::vector<uint8_t>& relay);
+
+    /// @brief Checks a key with the mutex held.
+    ///
+    /// @param key_type the key type.
+    /// @param key the key.
+    /// @param time the current time.
+    /// @return true if the key is under its limit.
+    bool allowKeyInternal(KeyType key_type, const std::vector<uint8_t>& key,
+                          Clock::time_point time);
+
+    /// @brief The number of buckets per row.
+    size_t buckets_;
+
+    /// @brief The limits indexed by key type.
+    Limit limits_[KEY_TYPE_COUNT];
+
+    /// @brief Mutex protecting the buckets and counters.
+    mutable std::mutex mutex_;
+};
+
+/// @brief Type of pointers to packet rate limiters.
+typedef boost::shared_ptr<PacketRateLimiter> PacketRateLimiterPtr;
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // PACKET_RATE_LIMITER_H
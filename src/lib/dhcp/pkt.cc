@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -19,7 +19,8 @@ Pkt::Pkt(uint32_t transid, const isc::asiolink::IOAddress& local_addr,
          uint16_t remote_port)
     : transid_(transid), iface_(""), ifindex_(-1), local_addr_(local_addr),
       remote_addr_(remote_addr), local_port_(local_port),
-      remote_port_(remote_port), buffer_out_(0), copy_retrieved_options_(false) {
+      remote_port_(remote_port), buffer_out_(0), copy_retrieved_options_(false),
+      event_times_() {
 }
 
 Pkt::Pkt(const uint8_t* buf, uint32_t len, const isc::asiolink::IOAddress& local_addr,
@@ -27,7 +28,8 @@ Pkt::Pkt(const uint8_t* buf, uint32_t len, const isc::asiolink::IOAddress& local
          uint16_t remote_port)
     : transid_(0), iface_(""), ifindex_(-1), local_addr_(local_addr),
       remote_addr_(remote_addr), local_port_(local_port),
-      remote_port_(remote_port), buffer_out_(0), copy_retrieved_options_(false) {
+      remote_port_(remote_port), buffer_out_(0), copy_retrieved_options_(false),
+      event_times_() {
     if (len != 0) {
         if (buf == NULL) {
             isc_throw(InvalidParameter, "data buffer passed to Pkt is NULL");
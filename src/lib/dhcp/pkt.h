@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -17,6 +17,8 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <array>
+#include <chrono>
 #include <utility>
 
 namespace isc {
@@ -448,6 +450,49 @@ public:
         timestamp_ = timestamp;
     }
 
+    /// @brief Packet processing events timed for the latency statistics.
+    enum Event {
+        EVENT_RECEIVED,       ///< read from the socket
+        EVENT_DEQUEUED,       ///< processing started
+        EVENT_ALLOC_STARTED,  ///< lease allocation started
+        EVENT_ALLOC_FINISHED, ///< lease allocation finished
+        EVENT_SENT,           ///< response sent
+        EVENT_MAX             ///< number of events
+    };
+
+    /// @brief Type of the event times.
+    ///
+    /// The default value, i.e. the clock epoch, means that the event
+    /// did not occur.
+    typedef std::chrono::steady_clock::time_point EventTime;
+
+    /// @brief Records the time of an event.
+    ///
+    /// Unlike the timestamp the event times are taken from a monotonic
+    /// clock so they can be subtracted.
+    ///
+    /// @param event event which occurred now.
+    void setEventTime(Event event) {
+        event_times_[event] = std::chrono::steady_clock::now();
+    }
+
+    /// @brief Returns the time of an event.
+    ///
+    /// @param event event.
+    /// @return the time of the event, the clock epoch if it did not occur.
+    const EventTime& getEventTime(Event event) const {
+        return (event_times_[event]);
+    }
+
+    /// @brief Copies the event times of another packet.
+    ///
+    /// It is used to pass the event times of a query to its response.
+    ///
+    /// @param pkt packet from which the event times are copied.
+    void copyEventTimes(const Pkt& pkt) {
+        event_times_ = pkt.event_times_;
+    }
+
     /// @brief Copies content of input buffer to output buffer.
     ///
     /// This is mostly a diagnostic function. It is being used for sending
@@ -828,6 +873,9 @@ protected:
     /// packet timestamp
     boost::posix_time::ptime timestamp_;
 
+    /// @brief Times of the processing events.
+    std::array<EventTime, EVENT_MAX> event_times_;
+
     // remote HW address (src if receiving packet, dst if sending packet)
     HWAddrPtr remote_hwaddr_;
 
@@ -33,7 +33,7 @@ Pkt4::Pkt4(uint8_t msg_type, uint32_t transid)
     : Pkt(transid, DEFAULT_ADDRESS, DEFAULT_ADDRESS, DHCP4_SERVER_PORT, DHCP4_CLIENT_PORT),
       op_(DHCPTypeToBootpType(msg_type)), hwaddr_(new HWAddr()), hops_(0), secs_(0), flags_(0),
       ciaddr_(DEFAULT_ADDRESS), yiaddr_(DEFAULT_ADDRESS), siaddr_(DEFAULT_ADDRESS),
-      giaddr_(DEFAULT_ADDRESS) {
+      giaddr_(DEFAULT_ADDRESS), rai_indexed_(), rai_indexed_count_(0) {
     memset(sname_, 0, MAX_SNAME_LEN);
     memset(file_, 0, MAX_FILE_LEN);
 
@@ -44,7 +44,7 @@ Pkt4::Pkt4(const uint8_t* data, size_t len)
     : Pkt(data, len, DEFAULT_ADDRESS, DEFAULT_ADDRESS, DHCP4_SERVER_PORT, DHCP4_CLIENT_PORT),
       op_(BOOTREQUEST), hwaddr_(new HWAddr()), hops_(0), secs_(0), flags_(0),
       ciaddr_(DEFAULT_ADDRESS), yiaddr_(DEFAULT_ADDRESS), siaddr_(DEFAULT_ADDRESS),
-      giaddr_(DEFAULT_ADDRESS) {
+      giaddr_(DEFAULT_ADDRESS), rai_indexed_(), rai_indexed_count_(0) {
 
     if (len < DHCPV4_PKT_HDR_LEN) {
         isc_throw(OutOfRange, "Truncated DHCPv4 packet (len=" << len
@@ -602,5 +602,40 @@ Pkt4::isRelayed() const {
     return (!giaddr_.isV4Zero() && !giaddr_.isV4Bcast());
 }
 
+OptionPtr
+Pkt4::getRAISubOption(uint16_t code) {
+    // The copied options must be cloned by getOption.
+    if (copy_retrieved_options_ || (code >= RAI_INDEX_SIZE)) {
+        OptionPtr rai = getOption(DHO_DHCP_AGENT_OPTIONS);
+        return (rai ? rai->getOption(code) : OptionPtr());
+    }
+
+    auto it = options_.find(DHO_DHCP_AGENT_OPTIONS);
+    if (it == options_.end()) {
+        return (OptionPtr());
+    }
+    const OptionPtr& rai = it->second;
+    if ((rai != rai_indexed_) ||
+        (rai->getOptions().size() != rai_indexed_count_)) {
+        indexRAI(rai);
+    }
+    return (rai_index_[code]);
+}
+
+void
+Pkt4::indexRAI(const OptionPtr& rai) {
+    rai_index_.fill(OptionPtr());
+    const OptionCollection& sub_options = rai->getOptions();
+    // The sub-options are ordered by code so the first one of a code
+    // is kept, as by getOption.
+    for (auto const& sub_option : sub_options) {
+        if ((sub_option.first < RAI_INDEX_SIZE) && !rai_index_[sub_option.first]) {
+            rai_index_[sub_option.first] = sub_option.second;
+        }
+    }
+    rai_indexed_ = rai;
+    rai_indexed_count_ = sub_options.size();
+}
+
 } // end of namespace isc::dhcp
 } // end of namespace isc
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,6 +8,7 @@
 #define PKT4_H
 
 #include <asiolink/io_address.h>
+#include <dhcp/dhcp4.h>
 #include <dhcp/duid.h>
 #include <util/buffer.h>
 #include <dhcp/option.h>
@@ -16,6 +17,7 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <array>
 #include <iostream>
 #include <vector>
 #include <set>
@@ -390,6 +392,24 @@ public:
     /// (true) or non-relayed (false).
     bool isRelayed() const;
 
+    /// @brief Returns a sub-option of the relay agent information option.
+    ///
+    /// The relay agent information option (option 82) sub-options are
+    /// looked up by the subnet selection, the host identifiers, the
+    /// classification, the lease extended info, etc. The most common
+    /// sub-options, i.e. up to the relay-port, are indexed by code the
+    /// first time one of them is looked up, so the later lookups are
+    /// direct. The index is rebuilt when the option 82 is replaced or when
+    /// its sub-options are added or removed.
+    ///
+    /// The sub-option data can be read in place with @c Option::getData.
+    /// When the retrieved options are copied, e.g. during the callouts,
+    /// the index is not used.
+    ///
+    /// @param code code of the sub-option.
+    /// @return the first sub-option with the code or null.
+    OptionPtr getRAISubOption(uint16_t code);
+
     /// @brief Checks if a DHCPv4 message has been transported over DHCPv6
     ///
     /// @return Boolean value which indicates whether the message is
@@ -415,6 +435,23 @@ private:
                                  const std::vector<uint8_t>& mac_addr,
                                  HWAddrPtr& hw_addr);
 
+    /// @brief Number of indexed relay agent information sub-options.
+    static const size_t RAI_INDEX_SIZE = RAI_OPTION_RELAY_PORT + 1;
+
+    /// @brief Indexes the sub-options of a relay agent information option.
+    ///
+    /// @param rai the relay agent information option.
+    void indexRAI(const OptionPtr& rai);
+
+    /// @brief The indexed relay agent information option, null if none.
+    OptionPtr rai_indexed_;
+
+    /// @brief Number of sub-options of the indexed option.
+    size_t rai_indexed_count_;
+
+    /// @brief The indexed sub-options by code.
+    std::array<OptionPtr, RAI_INDEX_SIZE> rai_index_;
+
 protected:
 
     /// converts DHCP message type to BOOTP op type
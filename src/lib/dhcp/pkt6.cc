@@ -523,11 +523,9 @@ Pkt6::unpackMsg(OptionBuffer::const_iterator begin,
     // perhaps for stats gathering we can uncomment this.
     //    size -= sizeof(uint32_t); // We just parsed 4 bytes header
 
-    OptionBuffer opt_buffer(begin, end);
-
-    // If custom option parsing function has been set, use this function
-    // to parse options. Otherwise, use standard function from libdhcp.
-    size_t offset = LibDHCP::unpackOptions6(opt_buffer, DHCP6_OPTION_SPACE, options_);
+    // Parse the options in place: there is no need for a copy.
+    size_t offset = LibDHCP::unpackOptions6(begin, end, DHCP6_OPTION_SPACE,
+                                            options_);
 
     // If offset is not equal to the size, then something is wrong here. We
     // either parsed past input buffer (bug in our code) or we haven't parsed
@@ -572,12 +570,11 @@ Pkt6::unpackRelayMsg() {
         offset += isc::asiolink::V6ADDRESS_LEN;
         bufsize -= DHCPV6_RELAY_HDR_LEN; // 34 bytes (1+1+16+16)
 
-        // parse the rest as options
-        OptionBuffer opt_buffer(&data_[offset], &data_[offset] + bufsize);
-
-        // If custom option parsing function has been set, use this function
-        // to parse options. Otherwise, use standard function from libdhcp.
-        LibDHCP::unpackOptions6(opt_buffer, DHCP6_OPTION_SPACE, relay.options_,
+        // parse the rest as options in place, so the nested relay
+        // encapsulations are not copied at each level.
+        LibDHCP::unpackOptions6(data_.begin() + offset,
+                                data_.begin() + offset + bufsize,
+                                DHCP6_OPTION_SPACE, relay.options_,
                                 &relay_msg_offset, &relay_msg_len);
 
         /// @todo: check that each option appears at most once
@@ -590,7 +587,7 @@ Pkt6::unpackRelayMsg() {
         }
 
         // store relay information parsed so far
-        addRelayInfo(relay);
+        addRelayInfo(std::move(relay));
 
         /// @todo: implement ERO (Echo Request Option, RFC 4994) here
 
@@ -633,6 +630,15 @@ Pkt6::addRelayInfo(const RelayInfo& relay) {
     relay_info_.push_back(relay);
 }
 
+void
+Pkt6::addRelayInfo(RelayInfo&& relay) {
+    if (relay_info_.size() > HOP_COUNT_LIMIT) {
+        isc_throw(BadValue, "Massage cannot be encapsulated more than 32 times");
+    }
+
+    relay_info_.push_back(std::move(relay));
+}
+
 void
 Pkt6::unpackTCP() {
     isc_throw(Unexpected, "DHCPv6 over TCP (bulk leasequery and failover) "
@@ -426,6 +426,14 @@ public:
     /// @param relay structure with necessary relay information
     void addRelayInfo(const RelayInfo& relay);
 
+    /// @brief add information about one traversed relay
+    ///
+    /// This variant moves the relay information, e.g. the relay options,
+    /// instead of copying it.
+    ///
+    /// @param relay structure with necessary relay information
+    void addRelayInfo(RelayInfo&& relay);
+
     /// @brief Returns name of the DHCPv6 message for a given type number.
     ///
     /// As the operation of the method does not depend on any server state, it
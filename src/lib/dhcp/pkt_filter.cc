@@ -14,6 +14,29 @@
 namespace isc {
 namespace dhcp {
 
+size_t
+PktFilter::receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                        std::vector<Pkt4Ptr>& pkts, size_t max_count) {
+    if (max_count == 0) {
+        return (0);
+    }
+    Pkt4Ptr pkt = receive(iface, socket_info);
+    if (!pkt) {
+        return (0);
+    }
+    pkts.push_back(pkt);
+    return (1);
+}
+
+size_t
+PktFilter::sendBatch(const Iface& iface, uint16_t sockfd,
+                     const std::vector<Pkt4Ptr>& pkts) {
+    for (auto const& pkt : pkts) {
+        send(iface, sockfd, pkt);
+    }
+    return (pkts.size());
+}
+
 int
 PktFilter::openFallbackSocket(const isc::asiolink::IOAddress& addr,
                               const uint16_t port) {
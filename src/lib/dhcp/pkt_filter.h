@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,6 +11,9 @@
 #include <asiolink/io_address.h>
 #include <boost/shared_ptr.hpp>
 
+#include <utility>
+#include <vector>
+
 namespace isc {
 namespace dhcp {
 
@@ -21,6 +24,14 @@ public:
         isc::Exception(file, line, what) { };
 };
 
+/// @brief Prefixes of the relay agent addresses, as address and length.
+typedef std::vector<std::pair<asiolink::IOAddress, uint8_t> > RelayPrefixes;
+
+/// @brief Maximum number of prefixes of the accepted relays.
+///
+/// It bounds the size of the filter programs checking the relays.
+static const size_t MAX_ACCEPTED_RELAYS = 64;
+
 /// Forward declaration to the structure describing a socket.
 struct SocketInfo;
 
@@ -103,6 +114,85 @@ public:
     virtual int send(const Iface& iface, uint16_t sockfd,
                      const Pkt4Ptr& pkt) = 0;
 
+    /// @brief Receive a batch of packets over specified socket.
+    ///
+    /// This function is called when the socket is known to have data to
+    /// read. It reads up to @c max_count packets which are already queued
+    /// on the socket without blocking for more. The default implementation
+    /// calls @c receive once. The derived classes may override it to read
+    /// many packets with a single system call.
+    ///
+    /// @param iface interface
+    /// @param socket_info structure holding socket information
+    /// @param[out] pkts vector to which the received packets are appended
+    /// @param max_count maximum number of packets to read
+    ///
+    /// @return The number of appended packets.
+    virtual size_t receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                                std::vector<Pkt4Ptr>& pkts,
+                                size_t max_count);
+
+    /// @brief Send a batch of packets over specified socket.
+    ///
+    /// The default implementation calls @c send for each packet. The
+    /// derived classes may override it to send many packets with a single
+    /// system call.
+    ///
+    /// @param iface interface to be used to send packets
+    /// @param sockfd socket descriptor
+    /// @param pkts packets to be sent
+    ///
+    /// @return The number of sent packets.
+    virtual size_t sendBatch(const Iface& iface, uint16_t sockfd,
+                             const std::vector<Pkt4Ptr>& pkts);
+
+    /// @brief Check if the received frames may be queued outside of the
+    /// socket receive queue.
+    ///
+    /// When this capability is supported, the socket may be readable while
+    /// the FIONREAD ioctl reports no queued data, e.g. when the frames are
+    /// delivered through a memory mapped ring. The sockets of such filters
+    /// must be non-blocking.
+    ///
+    /// @return true if the frames may be queued outside of the socket.
+    virtual bool isReceiveRingSupported() const {
+        return (false);
+    }
+
+    /// @brief Check if many sockets can be bound to the same address and
+    /// port.
+    ///
+    /// When this capability is supported, the kernel spreads the incoming
+    /// packets between the sockets bound with the SO_REUSEPORT option so
+    /// they can be read by different threads.
+    ///
+    /// @return true if the packet filter supports SO_REUSEPORT sockets.
+    virtual bool isSocketReusePortSupported() const {
+        return (false);
+    }
+
+    /// @brief Enables or disables the SO_REUSEPORT option on the sockets
+    /// opened by subsequent calls to @c openSocket.
+    ///
+    /// The default implementation does nothing.
+    ///
+    /// @param reuse_port true if the option should be set.
+    virtual void setSocketReusePort(const bool /* reuse_port */) {
+    }
+
+    /// @brief Sets the relays the messages of which are received by the
+    /// sockets opened by subsequent calls to @c openSocket.
+    ///
+    /// The packet filters running a filter program in the kernel can drop
+    /// the relayed messages the giaddr of which does not belong to one of
+    /// the prefixes before they are copied to the server. The default
+    /// implementation does nothing.
+    ///
+    /// @param prefixes the prefixes of the accepted relays, empty to
+    /// accept all the relays.
+    virtual void setAcceptedRelays(const RelayPrefixes& /* prefixes */) {
+    }
+
 protected:
 
     /// @brief Default implementation to open a fallback socket.
@@ -11,6 +11,29 @@
 namespace isc {
 namespace dhcp {
 
+size_t
+PktFilter6::receiveBatch(const SocketInfo& socket_info,
+                         std::vector<Pkt6Ptr>& pkts, size_t max_count) {
+    if (max_count == 0) {
+        return (0);
+    }
+    Pkt6Ptr pkt = receive(socket_info);
+    if (!pkt) {
+        return (0);
+    }
+    pkts.push_back(pkt);
+    return (1);
+}
+
+size_t
+PktFilter6::sendBatch(const Iface& iface, uint16_t sockfd,
+                      const std::vector<Pkt6Ptr>& pkts) {
+    for (auto const& pkt : pkts) {
+        send(iface, sockfd, pkt);
+    }
+    return (pkts.size());
+}
+
 bool
 PktFilter6::joinMulticast(int sock, const std::string& ifname,
                           const std::string & mcast) {
@@ -10,6 +10,8 @@
 #include <asiolink/io_address.h>
 #include <dhcp/pkt6.h>
 
+#include <vector>
+
 namespace isc {
 namespace dhcp {
 
@@ -115,6 +117,38 @@ public:
     virtual int send(const Iface& iface, uint16_t sockfd,
                      const Pkt6Ptr& pkt) = 0;
 
+    /// @brief Receives a batch of DHCPv6 messages.
+    ///
+    /// This function is called when the socket is known to have data to
+    /// read. It reads up to @c max_count messages which are already queued
+    /// on the socket without blocking for more. The default implementation
+    /// calls @c receive once. The derived classes may override it to read
+    /// many messages with a single system call.
+    ///
+    /// @param socket_info A structure holding socket information.
+    /// @param[out] pkts Vector to which the received messages are appended.
+    /// @param max_count Maximum number of messages to read.
+    ///
+    /// @return The number of appended messages.
+    virtual size_t receiveBatch(const SocketInfo& socket_info,
+                                std::vector<Pkt6Ptr>& pkts,
+                                size_t max_count);
+
+    /// @brief Sends a batch of DHCPv6 messages through a specified
+    /// interface and socket.
+    ///
+    /// The default implementation calls @c send for each message. The
+    /// derived classes may override it to send many messages with a single
+    /// system call.
+    ///
+    /// @param iface Interface to be used to send the messages.
+    /// @param sockfd A socket descriptor
+    /// @param pkts Messages to be sent.
+    ///
+    /// @return The number of sent messages.
+    virtual size_t sendBatch(const Iface& iface, uint16_t sockfd,
+                             const std::vector<Pkt6Ptr>& pkts);
+
     /// @brief Joins IPv6 multicast group on a socket.
     ///
     /// This function joins the socket to the specified multicast group.
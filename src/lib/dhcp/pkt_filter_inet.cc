@@ -8,7 +8,9 @@
 #include <dhcp/iface_mgr.h>
 #include <dhcp/pkt4.h>
 #include <dhcp/pkt_filter_inet.h>
+#include <util/recycling_allocator.h>
 #include <errno.h>
+#include <algorithm>
 #include <cstring>
 #include <fcntl.h>
 
@@ -20,6 +22,116 @@ namespace dhcp {
 const size_t
 PktFilterInet::CONTROL_BUF_LEN = CMSG_SPACE(sizeof(struct in6_pktinfo));
 
+const size_t
+PktFilterInet::MAX_BATCH_SIZE = 32;
+
+/// @brief Preallocated buffers used to receive a batch of packets.
+struct PktFilterInet::ReceiveBuffers {
+    /// @brief Constructor.
+    ///
+    /// @param count number of packets in a batch.
+    explicit ReceiveBuffers(size_t count)
+        : data_(count * IfaceMgr::RCVBUFSIZE),
+          control_(count * CONTROL_BUF_LEN), from_(count), iov_(count),
+          msgs_(count) {
+    }
+
+    /// @brief Packet data buffers.
+    std::vector<uint8_t> data_;
+
+    /// @brief Control message buffers.
+    std::vector<uint8_t> control_;
+
+    /// @brief Source addresses.
+    std::vector<struct sockaddr_in> from_;
+
+    /// @brief Scatter-gather entries.
+    std::vector<struct iovec> iov_;
+
+#if defined (OS_LINUX)
+    /// @brief Message headers for recvmmsg().
+    std::vector<struct mmsghdr> msgs_;
+#else
+    /// @brief Message headers.
+    std::vector<struct msghdr> msgs_;
+#endif
+};
+
+namespace {
+
+/// @brief Initializes the message header for sending a packet.
+///
+/// @param pkt packet to be sent
+/// @param[out] to destination address storage
+/// @param[out] v scatter-gather entry
+/// @param control_buf control buffer of CONTROL_BUF_LEN bytes
+/// @param control_buf_len length of the control buffer
+/// @param[out] m message header
+void
+prepareSend(const Pkt4Ptr& pkt, sockaddr_in& to, struct iovec& v,
+            uint8_t* control_buf, size_t control_buf_len, struct msghdr& m) {
+    memset(control_buf, 0, control_buf_len);
+
+    // Set the target address we're sending to.
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(pkt->getRemotePort());
+    to.sin_addr.s_addr = htonl(pkt->getRemoteAddr().toUint32());
+
+    // Initialize our message header structure.
+    memset(&m, 0, sizeof(m));
+    m.msg_name = &to;
+    m.msg_namelen = sizeof(to);
+
+    // Set the data buffer we're sending. (Using this wacky
+    // "scatter-gather" stuff... we only have a single chunk
+    // of data to send, so we declare a single vector entry.)
+    memset(&v, 0, sizeof(v));
+    // iov_base field is of void * type. We use it for packet
+    // transmission, so this buffer will not be modified.
+    v.iov_base = const_cast<void *>(pkt->getBuffer().getData());
+    v.iov_len = pkt->getBuffer().getLength();
+    m.msg_iov = &v;
+    m.msg_iovlen = 1;
+
+// In the future the OS-specific code may be abstracted to a different
+// file but for now we keep it here because there is no code yet, which
+// is specific to non-Linux systems.
+#if defined (IP_PKTINFO) && defined (OS_LINUX)
+    // Setting the interface is a bit more involved.
+    //
+    // We have to create a "control message", and set that to
+    // define the IPv4 packet information. We set the source address
+    // to handle correctly interfaces with multiple addresses.
+    m.msg_control = control_buf;
+    m.msg_controllen = control_buf_len;
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
+    cmsg->cmsg_level = IPPROTO_IP;
+    cmsg->cmsg_type = IP_PKTINFO;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(struct in_pktinfo));
+    struct in_pktinfo* pktinfo =(struct in_pktinfo *)CMSG_DATA(cmsg);
+    memset(pktinfo, 0, sizeof(struct in_pktinfo));
+
+    // In some cases the index of the outbound interface is not set. This
+    // is a matter of configuration. When the server is configured to
+    // determine the outbound interface based on routing information,
+    // the index is left unset (negative).
+    if (pkt->indexSet()) {
+        pktinfo->ipi_ifindex = pkt->getIndex();
+    }
+
+    // When the DHCP server is using routing to determine the outbound
+    // interface, the local address is also left unset.
+    if (!pkt->getLocalAddr().isV4Zero()) {
+        pktinfo->ipi_spec_dst.s_addr = htonl(pkt->getLocalAddr().toUint32());
+    }
+
+    m.msg_controllen = CMSG_SPACE(sizeof(struct in_pktinfo));
+#endif
+}
+
+} // end of anonymous namespace
+
 SocketInfo
 PktFilterInet::openSocket(Iface& iface,
                           const isc::asiolink::IOAddress& addr,
@@ -73,6 +185,19 @@ PktFilterInet::openSocket(Iface& iface,
         }
     }
 
+#ifdef SO_REUSEPORT
+    if (reuse_port_) {
+        // Allow other sockets to be bound to the same address and port.
+        // The kernel spreads the incoming packets between them.
+        int flag = 1;
+        if (setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &flag, sizeof(flag)) < 0) {
+            close(sock);
+            isc_throw(SocketConfigError, "Failed to set SO_REUSEPORT option"
+                      << " on socket " << sock);
+        }
+    }
+#endif
+
     if (bind(sock, (struct sockaddr *)&addr4, sizeof(addr4)) < 0) {
         close(sock);
         isc_throw(SocketConfigError, "Failed to bind socket " << sock
@@ -140,8 +265,16 @@ PktFilterInet::receive(Iface& iface, const SocketInfo& socket_info) {
         isc_throw(SocketReadError, "failed to receive UDP4 data");
     }
 
+    return (createPacket(iface, socket_info, buf, result, from_addr, m));
+}
+
+Pkt4Ptr
+PktFilterInet::createPacket(Iface& iface, const SocketInfo& socket_info,
+                            const uint8_t* buf, size_t len,
+                            const struct sockaddr_in& from_addr,
+                            struct msghdr& m) {
     // We have all data let's create Pkt4 object.
-    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(buf, result));
+    Pkt4Ptr pkt = isc::util::makeRecycled<Pkt4>(buf, len);
 
     pkt->updateTimestamp();
 
@@ -205,70 +338,101 @@ PktFilterInet::receive(Iface& iface, const SocketInfo& socket_info) {
     return (pkt);
 }
 
-int
-PktFilterInet::send(const Iface&, uint16_t sockfd, const Pkt4Ptr& pkt) {
-    uint8_t control_buf[CONTROL_BUF_LEN];
-    memset(&control_buf[0], 0, CONTROL_BUF_LEN);
-
-    // Set the target address we're sending to.
-    sockaddr_in to;
-    memset(&to, 0, sizeof(to));
-    to.sin_family = AF_INET;
-    to.sin_port = htons(pkt->getRemotePort());
-    to.sin_addr.s_addr = htonl(pkt->getRemoteAddr().toUint32());
-
-    struct msghdr m;
-    // Initialize our message header structure.
-    memset(&m, 0, sizeof(m));
-    m.msg_name = &to;
-    m.msg_namelen = sizeof(to);
+size_t
+PktFilterInet::receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                            std::vector<Pkt4Ptr>& pkts, size_t max_count) {
+#if defined (OS_LINUX)
+    size_t count = std::min(max_count, MAX_BATCH_SIZE);
+    if (count <= 1) {
+        return (PktFilter::receiveBatch(iface, socket_info, pkts, max_count));
+    }
 
-    // Set the data buffer we're sending. (Using this wacky
-    // "scatter-gather" stuff... we only have a single chunk
-    // of data to send, so we declare a single vector entry.)
-    struct iovec v;
-    memset(&v, 0, sizeof(v));
-    // iov_base field is of void * type. We use it for packet
-    // transmission, so this buffer will not be modified.
-    v.iov_base = const_cast<void *>(pkt->getBuffer().getData());
-    v.iov_len = pkt->getBuffer().getLength();
-    m.msg_iov = &v;
-    m.msg_iovlen = 1;
+    ReceiveBuffersPtr buffers = acquireReceiveBuffers();
+    ReceiveBuffers& rb = *buffers;
+
+    // The kernel updates the lengths so the headers are initialized
+    // before each call.
+    memset(&rb.control_[0], 0, count * CONTROL_BUF_LEN);
+    for (size_t i = 0; i < count; ++i) {
+        memset(&rb.from_[i], 0, sizeof(rb.from_[i]));
+        rb.iov_[i].iov_base = &rb.data_[i * IfaceMgr::RCVBUFSIZE];
+        rb.iov_[i].iov_len = IfaceMgr::RCVBUFSIZE;
+        struct msghdr& m = rb.msgs_[i].msg_hdr;
+        memset(&rb.msgs_[i], 0, sizeof(rb.msgs_[i]));
+        m.msg_name = &rb.from_[i];
+        m.msg_namelen = sizeof(rb.from_[i]);
+        m.msg_iov = &rb.iov_[i];
+        m.msg_iovlen = 1;
+        m.msg_control = &rb.control_[i * CONTROL_BUF_LEN];
+        m.msg_controllen = CONTROL_BUF_LEN;
+    }
 
-// In the future the OS-specific code may be abstracted to a different
-// file but for now we keep it here because there is no code yet, which
-// is specific to non-Linux systems.
-#if defined (IP_PKTINFO) && defined (OS_LINUX)
-    // Setting the interface is a bit more involved.
-    //
-    // We have to create a "control message", and set that to
-    // define the IPv4 packet information. We set the source address
-    // to handle correctly interfaces with multiple addresses.
-    m.msg_control = &control_buf[0];
-    m.msg_controllen = CONTROL_BUF_LEN;
-    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
-    cmsg->cmsg_level = IPPROTO_IP;
-    cmsg->cmsg_type = IP_PKTINFO;
-    cmsg->cmsg_len = CMSG_LEN(sizeof(struct in_pktinfo));
-    struct in_pktinfo* pktinfo =(struct in_pktinfo *)CMSG_DATA(cmsg);
-    memset(pktinfo, 0, sizeof(struct in_pktinfo));
+    // Get the packets which are already queued on the socket.
+    int result = recvmmsg(socket_info.sockfd_, &rb.msgs_[0], count,
+                          MSG_DONTWAIT, 0);
+    if (result < 0) {
+        releaseReceiveBuffers(buffers);
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            return (0);
+        }
+        isc_throw(SocketReadError, "failed to receive UDP4 data");
+    }
 
-    // In some cases the index of the outbound interface is not set. This
-    // is a matter of configuration. When the server is configured to
-    // determine the outbound interface based on routing information,
-    // the index is left unset (negative).
-    if (pkt->indexSet()) {
-        pktinfo->ipi_ifindex = pkt->getIndex();
+    size_t received = 0;
+    for (int i = 0; i < result; ++i) {
+        try {
+            pkts.push_back(createPacket(iface, socket_info,
+                                        &rb.data_[i * IfaceMgr::RCVBUFSIZE],
+                                        rb.msgs_[i].msg_len, rb.from_[i],
+                                        rb.msgs_[i].msg_hdr));
+            ++received;
+        } catch (const std::exception&) {
+            // Truncated packets are dropped so they do not affect
+            // the other packets of the batch.
+        }
     }
+    releaseReceiveBuffers(buffers);
+    return (received);
+#else
+    return (PktFilter::receiveBatch(iface, socket_info, pkts, max_count));
+#endif
+}
 
-    // When the DHCP server is using routing to determine the outbound
-    // interface, the local address is also left unset.
-    if (!pkt->getLocalAddr().isV4Zero()) {
-        pktinfo->ipi_spec_dst.s_addr = htonl(pkt->getLocalAddr().toUint32());
+PktFilterInet::ReceiveBuffersPtr
+PktFilterInet::acquireReceiveBuffers() {
+    {
+        std::lock_guard<std::mutex> lock(receive_mutex_);
+        if (!free_buffers_.empty()) {
+            ReceiveBuffersPtr buffers = free_buffers_.back();
+            free_buffers_.pop_back();
+            return (buffers);
+        }
     }
+    return (ReceiveBuffersPtr(new ReceiveBuffers(MAX_BATCH_SIZE)));
+}
 
-    m.msg_controllen = CMSG_SPACE(sizeof(struct in_pktinfo));
+void
+PktFilterInet::releaseReceiveBuffers(const ReceiveBuffersPtr& buffers) {
+    std::lock_guard<std::mutex> lock(receive_mutex_);
+    free_buffers_.push_back(buffers);
+}
+
+bool
+PktFilterInet::isSocketReusePortSupported() const {
+#ifdef SO_REUSEPORT
+    return (true);
+#else
+    return (false);
 #endif
+}
+
+int
+PktFilterInet::send(const Iface&, uint16_t sockfd, const Pkt4Ptr& pkt) {
+    uint8_t control_buf[CONTROL_BUF_LEN];
+    sockaddr_in to;
+    struct iovec v;
+    struct msghdr m;
+    prepareSend(pkt, to, v, &control_buf[0], CONTROL_BUF_LEN, m);
 
     pkt->updateTimestamp();
 
@@ -281,5 +445,42 @@ PktFilterInet::send(const Iface&, uint16_t sockfd, const Pkt4Ptr& pkt) {
     return (0);
 }
 
+size_t
+PktFilterInet::sendBatch(const Iface& iface, uint16_t sockfd,
+                         const std::vector<Pkt4Ptr>& pkts) {
+#if defined (OS_LINUX)
+    size_t count = pkts.size();
+    if (count <= 1) {
+        return (PktFilter::sendBatch(iface, sockfd, pkts));
+    }
+
+    std::vector<uint8_t> control(count * CONTROL_BUF_LEN);
+    std::vector<sockaddr_in> to(count);
+    std::vector<struct iovec> iov(count);
+    std::vector<struct mmsghdr> msgs(count);
+    memset(&msgs[0], 0, count * sizeof(struct mmsghdr));
+    for (size_t i = 0; i < count; ++i) {
+        prepareSend(pkts[i], to[i], iov[i], &control[i * CONTROL_BUF_LEN],
+                    CONTROL_BUF_LEN, msgs[i].msg_hdr);
+        pkts[i]->updateTimestamp();
+    }
+
+    // The kernel may send less packets than requested so loop until
+    // all of them are sent.
+    size_t sent = 0;
+    while (sent < count) {
+        int result = sendmmsg(sockfd, &msgs[sent], count - sent, 0);
+        if (result < 0) {
+            isc_throw(SocketWriteError, "pkt4 send failed: sendmmsg() returned "
+                      " with an error: " << strerror(errno));
+        }
+        sent += result;
+    }
+    return (sent);
+#else
+    return (PktFilter::sendBatch(iface, sockfd, pkts));
+#endif
+}
+
 } // end of isc::dhcp namespace
 } // end of isc namespace
@@ -9,6 +9,13 @@
 
 #include <dhcp/pkt_filter.h>
 #include <boost/scoped_array.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <mutex>
+#include <vector>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
 
 namespace isc {
 namespace dhcp {
@@ -20,6 +27,10 @@ namespace dhcp {
 class PktFilterInet : public PktFilter {
 public:
 
+    /// @brief Constructor.
+    PktFilterInet() : reuse_port_(false) {
+    }
+
     /// @brief Check if packet can be sent to the host without address directly.
     ///
     /// This Packet Filter sends packets through AF_INET datagram sockets, so
@@ -78,9 +89,102 @@ public:
     /// a DHCP message through the socket.
     virtual int send(const Iface& iface, uint16_t sockfd, const Pkt4Ptr& pkt);
 
+    /// @brief Receive a batch of packets over specified socket.
+    ///
+    /// On Linux it uses recvmmsg() with preallocated buffers to read up
+    /// to @c MAX_BATCH_SIZE packets in a single system call. Packets which
+    /// are too short to be DHCPv4 messages are dropped. On other systems
+    /// it reads a single packet.
+    ///
+    /// @param iface interface
+    /// @param socket_info structure holding socket information
+    /// @param[out] pkts vector to which the received packets are appended
+    /// @param max_count maximum number of packets to read
+    ///
+    /// @return The number of appended packets.
+    /// @throw isc::dhcp::SocketReadError if an error occurs during reception
+    /// of the packets.
+    virtual size_t receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                                std::vector<Pkt4Ptr>& pkts,
+                                size_t max_count);
+
+    /// @brief Send a batch of packets over specified socket.
+    ///
+    /// On Linux it uses sendmmsg() to send the packets in as few system
+    /// calls as possible. On other systems the packets are sent one by one.
+    ///
+    /// @param iface interface to be used to send packets
+    /// @param sockfd socket descriptor
+    /// @param pkts packets to be sent
+    ///
+    /// @return The number of sent packets.
+    /// @throw isc::dhcp::SocketWriteError if an error occurs during sending
+    /// the packets through the socket.
+    virtual size_t sendBatch(const Iface& iface, uint16_t sockfd,
+                             const std::vector<Pkt4Ptr>& pkts);
+
+    /// @brief Check if many sockets can be bound to the same address and
+    /// port.
+    ///
+    /// @return true if the SO_REUSEPORT socket option is available.
+    virtual bool isSocketReusePortSupported() const;
+
+    /// @brief Enables or disables the SO_REUSEPORT option on the sockets
+    /// opened by subsequent calls to @c openSocket.
+    ///
+    /// @param reuse_port true if the option should be set.
+    virtual void setSocketReusePort(const bool reuse_port) {
+        reuse_port_ = reuse_port;
+    }
+
+    /// @brief Maximum number of packets read by one @c receiveBatch call.
+    static const size_t MAX_BATCH_SIZE;
+
 private:
+    /// @brief Creates a packet from a received message.
+    ///
+    /// @param iface interface
+    /// @param socket_info structure holding socket information
+    /// @param buf received data
+    /// @param len length of the received data
+    /// @param from_addr source address of the message
+    /// @param m message header holding the control messages
+    ///
+    /// @return Received packet
+    Pkt4Ptr createPacket(Iface& iface, const SocketInfo& socket_info,
+                         const uint8_t* buf, size_t len,
+                         const struct sockaddr_in& from_addr,
+                         struct msghdr& m);
+
     /// Length of the socket control buffer.
     static const size_t CONTROL_BUF_LEN;
+
+    /// @brief Buffers used to receive a batch of packets.
+    struct ReceiveBuffers;
+
+    /// @brief Pointer to the buffers used to receive a batch of packets.
+    typedef boost::shared_ptr<ReceiveBuffers> ReceiveBuffersPtr;
+
+    /// @brief Returns buffers which are not used by another thread.
+    ///
+    /// The buffers are allocated on first use and then recycled so
+    /// many receiver threads can read from different sockets at the
+    /// same time.
+    ReceiveBuffersPtr acquireReceiveBuffers();
+
+    /// @brief Returns buffers obtained by @c acquireReceiveBuffers.
+    ///
+    /// @param buffers buffers which are no longer used.
+    void releaseReceiveBuffers(const ReceiveBuffersPtr& buffers);
+
+    /// @brief Buffers which are not currently used.
+    std::vector<ReceiveBuffersPtr> free_buffers_;
+
+    /// @brief Mutex protecting the free buffers.
+    std::mutex receive_mutex_;
+
+    /// @brief Set the SO_REUSEPORT option on the opened sockets.
+    bool reuse_port_;
 };
 
 } // namespace isc::dhcp
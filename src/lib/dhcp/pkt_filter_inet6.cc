@@ -11,7 +11,9 @@
 #include <dhcp/pkt_filter_inet6.h>
 #include <exceptions/isc_assert.h>
 #include <util/io/pktinfo_utilities.h>
+#include <util/recycling_allocator.h>
 
+#include <algorithm>
 #include <fcntl.h>
 #include <netinet/in.h>
 
@@ -23,6 +25,123 @@ namespace dhcp {
 const size_t
 PktFilterInet6::CONTROL_BUF_LEN = CMSG_SPACE(sizeof(struct in6_pktinfo));
 
+const size_t
+PktFilterInet6::MAX_BATCH_SIZE = 32;
+
+/// @brief Preallocated buffers used to receive a batch of messages.
+struct PktFilterInet6::ReceiveBuffers {
+    /// @brief Constructor.
+    ///
+    /// @param count number of messages in a batch.
+    explicit ReceiveBuffers(size_t count)
+        : data_(count * IfaceMgr::RCVBUFSIZE),
+          control_(count * CONTROL_BUF_LEN), from_(count), iov_(count),
+          msgs_(count) {
+    }
+
+    /// @brief Message data buffers.
+    std::vector<uint8_t> data_;
+
+    /// @brief Control message buffers.
+    std::vector<uint8_t> control_;
+
+    /// @brief Source addresses.
+    std::vector<struct sockaddr_in6> from_;
+
+    /// @brief Scatter-gather entries.
+    std::vector<struct iovec> iov_;
+
+#if defined (OS_LINUX)
+    /// @brief Message headers for recvmmsg().
+    std::vector<struct mmsghdr> msgs_;
+#else
+    /// @brief Message headers.
+    std::vector<struct msghdr> msgs_;
+#endif
+};
+
+namespace {
+
+/// @brief Initializes the message header for sending a message.
+///
+/// @param pkt message to be sent
+/// @param[out] to destination address storage
+/// @param[out] v scatter-gather entry
+/// @param control_buf control buffer
+/// @param control_buf_len length of the control buffer
+/// @param[out] m message header
+void
+prepareSend(const Pkt6Ptr& pkt, sockaddr_in6& to, struct iovec& v,
+            uint8_t* control_buf, size_t control_buf_len, struct msghdr& m) {
+    memset(control_buf, 0, control_buf_len);
+
+    // Set the target address we're sending to.
+    memset(&to, 0, sizeof(to));
+    to.sin6_family = AF_INET6;
+    to.sin6_port = htons(pkt->getRemotePort());
+    memcpy(&to.sin6_addr,
+           &pkt->getRemoteAddr().toBytes()[0],
+           16);
+    to.sin6_scope_id = pkt->getIndex();
+
+    // Initialize our message header structure.
+    memset(&m, 0, sizeof(m));
+    m.msg_name = &to;
+    m.msg_namelen = sizeof(to);
+
+    // Set the data buffer we're sending. (Using this wacky
+    // "scatter-gather" stuff... we only have a single chunk
+    // of data to send, so we declare a single vector entry.)
+
+    // As v structure is a C-style is used for both sending and
+    // receiving data, it is shared between sending and receiving
+    // (sendmsg and recvmsg). It is also defined in system headers,
+    // so we have no control over its definition. To set iov_base
+    // (defined as void*) we must use const cast from void *.
+    // Otherwise C++ compiler would complain that we are trying
+    // to assign const void* to void*.
+    memset(&v, 0, sizeof(v));
+    v.iov_base = const_cast<void *>(pkt->getBuffer().getData());
+    v.iov_len = pkt->getBuffer().getLength();
+    m.msg_iov = &v;
+    m.msg_iovlen = 1;
+
+    // Setting the interface is a bit more involved.
+    //
+    // We have to create a "control message", and set that to
+    // define the IPv6 packet information. We could set the
+    // source address if we wanted, but we can safely let the
+    // kernel decide what that should be.
+    m.msg_control = control_buf;
+    m.msg_controllen = control_buf_len;
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&m);
+
+    // FIXME: Code below assumes that cmsg is not NULL, but
+    // CMSG_FIRSTHDR() is coded to return NULL as a possibility.  The
+    // following assertion should never fail, but if it did and you came
+    // here, fix the code. :)
+    isc_throw_assert(cmsg != NULL);
+
+    cmsg->cmsg_level = IPPROTO_IPV6;
+    cmsg->cmsg_type = IPV6_PKTINFO;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(struct in6_pktinfo));
+    struct in6_pktinfo *pktinfo =
+        util::io::internal::convertPktInfo6(CMSG_DATA(cmsg));
+    memset(pktinfo, 0, sizeof(struct in6_pktinfo));
+    pktinfo->ipi6_ifindex = pkt->getIndex();
+    // According to RFC3542, section 20.2, the msg_controllen field
+    // may be set using CMSG_SPACE (which includes padding) or
+    // using CMSG_LEN. Both forms appear to work fine on Linux, FreeBSD,
+    // NetBSD, but OpenBSD appears to have a bug, discussed here:
+    // http://www.archivum.info/mailing.openbsd.bugs/2009-02/00017/
+    // kernel-6080-msg_controllen-of-IPV6_PKTINFO.html
+    // which causes sendmsg to return EINVAL if the CMSG_LEN is
+    // used to set the msg_controllen value.
+    m.msg_controllen = CMSG_SPACE(sizeof(struct in6_pktinfo));
+}
+
+}
+
 SocketInfo
 PktFilterInet6::openSocket(const Iface& iface,
                            const isc::asiolink::IOAddress& addr,
@@ -178,39 +297,43 @@ PktFilterInet6::receive(const SocketInfo& socket_info) {
     m.msg_controllen = CONTROL_BUF_LEN;
 
     int result = recvmsg(socket_info.sockfd_, &m, 0);
+    if (result < 0) {
+        isc_throw(SocketReadError, "failed to receive data");
+    }
+
+    return (createPacket(socket_info, buf, result, from, m));
+}
 
+Pkt6Ptr
+PktFilterInet6::createPacket(const SocketInfo& socket_info, const uint8_t* buf,
+                             size_t len, const struct sockaddr_in6& from,
+                             struct msghdr& m) {
     struct in6_addr to_addr;
     memset(&to_addr, 0, sizeof(to_addr));
 
     int ifindex = -1;
-    if (result >= 0) {
-        struct in6_pktinfo* pktinfo = NULL;
-
-
-        // If we did read successfully, then we need to loop
-        // through the control messages we received and
-        // find the one with our destination address.
-        //
-        // We also keep a flag to see if we found it. If we
-        // didn't, then we consider this to be an error.
-        bool found_pktinfo = false;
-        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
-        while (cmsg != NULL) {
-            if ((cmsg->cmsg_level == IPPROTO_IPV6) &&
-                (cmsg->cmsg_type == IPV6_PKTINFO)) {
-                pktinfo = util::io::internal::convertPktInfo6(CMSG_DATA(cmsg));
-                to_addr = pktinfo->ipi6_addr;
-                ifindex = pktinfo->ipi6_ifindex;
-                found_pktinfo = true;
-                break;
-            }
-            cmsg = CMSG_NXTHDR(&m, cmsg);
-        }
-        if (!found_pktinfo) {
-            isc_throw(SocketReadError, "unable to find pktinfo");
+    struct in6_pktinfo* pktinfo = NULL;
+
+    // We need to loop through the control messages we received and
+    // find the one with our destination address.
+    //
+    // We also keep a flag to see if we found it. If we
+    // didn't, then we consider this to be an error.
+    bool found_pktinfo = false;
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
+    while (cmsg != NULL) {
+        if ((cmsg->cmsg_level == IPPROTO_IPV6) &&
+            (cmsg->cmsg_type == IPV6_PKTINFO)) {
+            pktinfo = util::io::internal::convertPktInfo6(CMSG_DATA(cmsg));
+            to_addr = pktinfo->ipi6_addr;
+            ifindex = pktinfo->ipi6_ifindex;
+            found_pktinfo = true;
+            break;
         }
-    } else {
-        isc_throw(SocketReadError, "failed to receive data");
+        cmsg = CMSG_NXTHDR(&m, cmsg);
+    }
+    if (!found_pktinfo) {
+        isc_throw(SocketReadError, "unable to find pktinfo");
     }
 
     // Filter out packets sent to global unicast address (not link local and
@@ -227,15 +350,14 @@ PktFilterInet6::receive(const SocketInfo& socket_info) {
     // Let's create a packet.
     Pkt6Ptr pkt;
     try {
-        pkt = Pkt6Ptr(new Pkt6(buf, result));
+        pkt = isc::util::makeRecycled<Pkt6>(buf, len);
     } catch (const std::exception& ex) {
         isc_throw(SocketReadError, "failed to create new packet");
     }
 
     pkt->updateTimestamp();
 
-    pkt->setLocalAddr(IOAddress::fromBytes(AF_INET6,
-                      reinterpret_cast<const uint8_t*>(&to_addr)));
+    pkt->setLocalAddr(local_addr);
     pkt->setRemoteAddr(IOAddress::fromBytes(AF_INET6,
                        reinterpret_cast<const uint8_t*>(&from.sin6_addr)));
     pkt->setRemotePort(ntohs(from.sin6_port));
@@ -253,77 +375,95 @@ PktFilterInet6::receive(const SocketInfo& socket_info) {
 
 }
 
-int
-PktFilterInet6::send(const Iface&, uint16_t sockfd, const Pkt6Ptr& pkt) {
-    uint8_t control_buf[CONTROL_BUF_LEN];
-    memset(&control_buf[0], 0, CONTROL_BUF_LEN);
-
-    // Set the target address we're sending to.
-    sockaddr_in6 to;
-    memset(&to, 0, sizeof(to));
-    to.sin6_family = AF_INET6;
-    to.sin6_port = htons(pkt->getRemotePort());
-    memcpy(&to.sin6_addr,
-           &pkt->getRemoteAddr().toBytes()[0],
-           16);
-    to.sin6_scope_id = pkt->getIndex();
+size_t
+PktFilterInet6::receiveBatch(const SocketInfo& socket_info,
+                             std::vector<Pkt6Ptr>& pkts, size_t max_count) {
+#if defined (OS_LINUX)
+    size_t count = std::min(max_count, MAX_BATCH_SIZE);
+    if (count <= 1) {
+        return (PktFilter6::receiveBatch(socket_info, pkts, max_count));
+    }
 
-    // Initialize our message header structure.
-    struct msghdr m;
-    memset(&m, 0, sizeof(m));
-    m.msg_name = &to;
-    m.msg_namelen = sizeof(to);
+    ReceiveBuffersPtr buffers = acquireReceiveBuffers();
+    ReceiveBuffers& rb = *buffers;
+
+    // The kernel updates the lengths so the headers are initialized
+    // before each call.
+    memset(&rb.control_[0], 0, count * CONTROL_BUF_LEN);
+    for (size_t i = 0; i < count; ++i) {
+        memset(&rb.from_[i], 0, sizeof(rb.from_[i]));
+        rb.iov_[i].iov_base = &rb.data_[i * IfaceMgr::RCVBUFSIZE];
+        rb.iov_[i].iov_len = IfaceMgr::RCVBUFSIZE;
+        struct msghdr& m = rb.msgs_[i].msg_hdr;
+        memset(&rb.msgs_[i], 0, sizeof(rb.msgs_[i]));
+        m.msg_name = &rb.from_[i];
+        m.msg_namelen = sizeof(rb.from_[i]);
+        m.msg_iov = &rb.iov_[i];
+        m.msg_iovlen = 1;
+        m.msg_control = &rb.control_[i * CONTROL_BUF_LEN];
+        m.msg_controllen = CONTROL_BUF_LEN;
+    }
 
-    // Set the data buffer we're sending. (Using this wacky
-    // "scatter-gather" stuff... we only have a single chunk
-    // of data to send, so we declare a single vector entry.)
+    // Get the messages which are already queued on the socket.
+    int result = recvmmsg(socket_info.sockfd_, &rb.msgs_[0], count,
+                          MSG_DONTWAIT, 0);
+    if (result < 0) {
+        releaseReceiveBuffers(buffers);
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            return (0);
+        }
+        isc_throw(SocketReadError, "failed to receive data");
+    }
 
-    // As v structure is a C-style is used for both sending and
-    // receiving data, it is shared between sending and receiving
-    // (sendmsg and recvmsg). It is also defined in system headers,
-    // so we have no control over its definition. To set iov_base
-    // (defined as void*) we must use const cast from void *.
-    // Otherwise C++ compiler would complain that we are trying
-    // to assign const void* to void*.
-    struct iovec v;
-    memset(&v, 0, sizeof(v));
-    v.iov_base = const_cast<void *>(pkt->getBuffer().getData());
-    v.iov_len = pkt->getBuffer().getLength();
-    m.msg_iov = &v;
-    m.msg_iovlen = 1;
+    size_t received = 0;
+    for (int i = 0; i < result; ++i) {
+        try {
+            Pkt6Ptr pkt = createPacket(socket_info,
+                                       &rb.data_[i * IfaceMgr::RCVBUFSIZE],
+                                       rb.msgs_[i].msg_len, rb.from_[i],
+                                       rb.msgs_[i].msg_hdr);
+            if (pkt) {
+                pkts.push_back(pkt);
+                ++received;
+            }
+        } catch (const std::exception&) {
+            // Invalid messages are dropped so they do not affect the
+            // other messages of the batch.
+        }
+    }
+    releaseReceiveBuffers(buffers);
+    return (received);
+#else
+    return (PktFilter6::receiveBatch(socket_info, pkts, max_count));
+#endif
+}
 
-    // Setting the interface is a bit more involved.
-    //
-    // We have to create a "control message", and set that to
-    // define the IPv6 packet information. We could set the
-    // source address if we wanted, but we can safely let the
-    // kernel decide what that should be.
-    m.msg_control = &control_buf[0];
-    m.msg_controllen = CONTROL_BUF_LEN;
-    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&m);
+PktFilterInet6::ReceiveBuffersPtr
+PktFilterInet6::acquireReceiveBuffers() {
+    {
+        std::lock_guard<std::mutex> lock(receive_mutex_);
+        if (!free_buffers_.empty()) {
+            ReceiveBuffersPtr buffers = free_buffers_.back();
+            free_buffers_.pop_back();
+            return (buffers);
+        }
+    }
+    return (ReceiveBuffersPtr(new ReceiveBuffers(MAX_BATCH_SIZE)));
+}
 
-    // FIXME: Code below assumes that cmsg is not NULL, but
-    // CMSG_FIRSTHDR() is coded to return NULL as a possibility.  The
-    // following assertion should never fail, but if it did and you came
-    // here, fix the code. :)
-    isc_throw_assert(cmsg != NULL);
+void
+PktFilterInet6::releaseReceiveBuffers(const ReceiveBuffersPtr& buffers) {
+    std::lock_guard<std::mutex> lock(receive_mutex_);
+    free_buffers_.push_back(buffers);
+}
 
-    cmsg->cmsg_level = IPPROTO_IPV6;
-    cmsg->cmsg_type = IPV6_PKTINFO;
-    cmsg->cmsg_len = CMSG_LEN(sizeof(struct in6_pktinfo));
-    struct in6_pktinfo *pktinfo =
-        util::io::internal::convertPktInfo6(CMSG_DATA(cmsg));
-    memset(pktinfo, 0, sizeof(struct in6_pktinfo));
-    pktinfo->ipi6_ifindex = pkt->getIndex();
-    // According to RFC3542, section 20.2, the msg_controllen field
-    // may be set using CMSG_SPACE (which includes padding) or
-    // using CMSG_LEN. Both forms appear to work fine on Linux, FreeBSD,
-    // NetBSD, but OpenBSD appears to have a bug, discussed here:
-    // http://www.archivum.info/mailing.openbsd.bugs/2009-02/00017/
-    // kernel-6080-msg_controllen-of-IPV6_PKTINFO.html
-    // which causes sendmsg to return EINVAL if the CMSG_LEN is
-    // used to set the msg_controllen value.
-    m.msg_controllen = CMSG_SPACE(sizeof(struct in6_pktinfo));
+int
+PktFilterInet6::send(const Iface&, uint16_t sockfd, const Pkt6Ptr& pkt) {
+    uint8_t control_buf[CONTROL_BUF_LEN];
+    sockaddr_in6 to;
+    struct iovec v;
+    struct msghdr m;
+    prepareSend(pkt, to, v, &control_buf[0], CONTROL_BUF_LEN, m);
 
     pkt->updateTimestamp();
 
@@ -336,5 +476,42 @@ PktFilterInet6::send(const Iface&, uint16_t sockfd, const Pkt6Ptr& pkt) {
     return (0);
 }
 
+size_t
+PktFilterInet6::sendBatch(const Iface& iface, uint16_t sockfd,
+                          const std::vector<Pkt6Ptr>& pkts) {
+#if defined (OS_LINUX)
+    size_t count = pkts.size();
+    if (count <= 1) {
+        return (PktFilter6::sendBatch(iface, sockfd, pkts));
+    }
+
+    std::vector<uint8_t> control(count * CONTROL_BUF_LEN);
+    std::vector<sockaddr_in6> to(count);
+    std::vector<struct iovec> iov(count);
+    std::vector<struct mmsghdr> msgs(count);
+    memset(&msgs[0], 0, count * sizeof(struct mmsghdr));
+    for (size_t i = 0; i < count; ++i) {
+        prepareSend(pkts[i], to[i], iov[i], &control[i * CONTROL_BUF_LEN],
+                    CONTROL_BUF_LEN, msgs[i].msg_hdr);
+        pkts[i]->updateTimestamp();
+    }
+
+    // The kernel may send less messages than requested so loop until
+    // all of them are sent.
+    size_t sent = 0;
+    while (sent < count) {
+        int result = sendmmsg(sockfd, &msgs[sent], count - sent, 0);
+        if (result < 0) {
+            isc_throw(SocketWriteError, "pkt6 send failed: sendmmsg() returned"
+                      " with an error: " << strerror(errno));
+        }
+        sent += result;
+    }
+    return (sent);
+#else
+    return (PktFilter6::sendBatch(iface, sockfd, pkts));
+#endif
+}
+
 }
 }
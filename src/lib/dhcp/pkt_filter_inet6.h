@@ -9,6 +9,13 @@
 
 #include <dhcp/pkt_filter6.h>
 #include <boost/scoped_array.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <mutex>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
 
 namespace isc {
 namespace dhcp {
@@ -77,9 +84,84 @@ public:
     /// packet.
     virtual int send(const Iface& iface, uint16_t sockfd, const Pkt6Ptr& pkt);
 
+    /// @brief Receives a batch of DHCPv6 messages.
+    ///
+    /// On Linux it uses recvmmsg() with preallocated buffers to read up
+    /// to @c MAX_BATCH_SIZE messages in a single system call. The messages
+    /// which would be dropped by @c receive or which can't be parsed are
+    /// dropped. On other systems it reads a single message.
+    ///
+    /// @param socket_info A structure holding socket information.
+    /// @param[out] pkts Vector to which the received messages are appended.
+    /// @param max_count Maximum number of messages to read.
+    ///
+    /// @return The number of appended messages.
+    /// @throw isc::dhcp::SocketReadError if error occurred during packet
+    /// reception.
+    virtual size_t receiveBatch(const SocketInfo& socket_info,
+                                std::vector<Pkt6Ptr>& pkts,
+                                size_t max_count);
+
+    /// @brief Sends a batch of DHCPv6 messages through a specified
+    /// interface and socket.
+    ///
+    /// On Linux it uses sendmmsg() to send the messages in as few system
+    /// calls as possible. On other systems the messages are sent one by one.
+    ///
+    /// @param iface Interface to be used to send the messages.
+    /// @param sockfd A socket descriptor
+    /// @param pkts Messages to be sent.
+    ///
+    /// @return The number of sent messages.
+    /// @throw isc::dhcp::SocketWriteError if error occurred when sending
+    /// the messages.
+    virtual size_t sendBatch(const Iface& iface, uint16_t sockfd,
+                             const std::vector<Pkt6Ptr>& pkts);
+
+    /// @brief Maximum number of messages read by one @c receiveBatch call.
+    static const size_t MAX_BATCH_SIZE;
+
 private:
+    /// @brief Creates a packet from a received message.
+    ///
+    /// @param socket_info A structure holding socket information.
+    /// @param buf Received data.
+    /// @param len Length of the received data.
+    /// @param from Source address of the message.
+    /// @param m Message header holding the control messages.
+    ///
+    /// @return A pointer to received message or null if the message is
+    /// dropped.
+    /// @throw isc::dhcp::SocketReadError if the message has no packet
+    /// information or was received over an unknown interface.
+    Pkt6Ptr createPacket(const SocketInfo& socket_info, const uint8_t* buf,
+                         size_t len, const struct sockaddr_in6& from,
+                         struct msghdr& m);
+
     /// Length of the socket control buffer.
     static const size_t CONTROL_BUF_LEN;
+
+    /// @brief Buffers used to receive a batch of messages.
+    struct ReceiveBuffers;
+
+    /// @brief Pointer to the buffers used to receive a batch of messages.
+    typedef boost::shared_ptr<ReceiveBuffers> ReceiveBuffersPtr;
+
+    /// @brief Returns buffers which are not used by another thread.
+    ///
+    /// The buffers are allocated on first use and then recycled.
+    ReceiveBuffersPtr acquireReceiveBuffers();
+
+    /// @brief Returns buffers obtained by @c acquireReceiveBuffers.
+    ///
+    /// @param buffers buffers which are no longer used.
+    void releaseReceiveBuffers(const ReceiveBuffersPtr& buffers);
+
+    /// @brief Buffers which are not currently used.
+    std::vector<ReceiveBuffersPtr> free_buffers_;
+
+    /// @brief Mutex protecting the free buffers.
+    std::mutex receive_mutex_;
 };
 
 } // namespace isc::dhcp
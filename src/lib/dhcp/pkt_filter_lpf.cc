@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,114 +11,147 @@
 #include <dhcp/pkt_filter_lpf.h>
 #include <dhcp/protocol_util.h>
 #include <exceptions/exceptions.h>
+#include <util/recycling_allocator.h>
+#include <algorithm>
 #include <fcntl.h>
 #include <net/ethernet.h>
 #include <linux/filter.h>
 #include <linux/if_ether.h>
 #include <linux/if_packet.h>
+#include <sys/mman.h>
 
 namespace {
 
 using namespace isc::dhcp;
 
-/// The following structure defines a Berkeley Packet Filter program to perform
-/// packet filtering. The program operates on Ethernet packets.  To help with
-/// interpretation of the program, for the types of Ethernet packets we are
-/// interested in, the header layout is:
-///
-///   6 bytes  Destination Ethernet Address
-///   6 bytes  Source Ethernet Address
-///   2 bytes  Ethernet packet type
-///
-///  20 bytes  Fixed part of IP header
-///  variable  Variable part of IP header
-///
-///   2 bytes  UDP Source port
-///   2 bytes  UDP destination port
-///   4 bytes  Rest of UDP header
-///
-/// Each instruction is preceded with the comments giving the instruction
-/// number within a BPF program, in the following format: #123.
+/// Offset of the length in the UDP header.
+const size_t UDP_LEN_OFFSET = 4;
+
+/// Offset of the op field in the DHCPv4 message.
+const size_t DHCPV4_OP_OFFSET = 0;
+
+/// Offset of the giaddr field in the DHCPv4 message.
+const size_t DHCPV4_GIADDR_OFFSET = 24;
+
+/// Length of the ethernet, IP and UDP headers of a sent frame.
+const size_t FRAME_HEADER_LEN = ETHERNET_HEADER_LEN + MIN_IP_HEADER_LEN +
+                                UDP_HEADER_LEN;
+
+/// @brief Sets the scatter-gather entries of a frame.
 ///
-/// @todo We may want to extend the filter to receive packets sent
-/// to the particular IP address assigned to the interface or
-/// broadcast address.
-struct sock_filter dhcp_sock_filter [] = {
-    // Make sure this is an IP packet: check the half-word (two bytes)
-    // at offset 12 in the packet (the Ethernet packet type).  If it
-    // is, advance to the next instruction.  If not, advance 11
-    // instructions (which takes execution to the last instruction in
-    // the sequence: "drop it").
-    // #0
-    BPF_STMT(BPF_LD + BPF_H + BPF_ABS, ETHERNET_PACKET_TYPE_OFFSET),
-    // #1
-    BPF_JUMP(BPF_JMP + BPF_JEQ + BPF_K, ETHERTYPE_IP, 0, 11),
-
-    // Make sure it's a UDP packet.  The IP protocol is at offset
-    // 9 in the IP header so, adding the Ethernet packet header size
-    // of 14 bytes gives an absolute byte offset in the packet of 23.
-    // #2
-    BPF_STMT(BPF_LD + BPF_B + BPF_ABS,
-             ETHERNET_HEADER_LEN + IP_PROTO_TYPE_OFFSET),
-    // #3
-    BPF_JUMP(BPF_JMP + BPF_JEQ + BPF_K, IPPROTO_UDP, 0, 9),
+/// @param header frame header buffer
+/// @param pkt packet holding the DHCPv4 message
+/// @param[out] iov array of the two scatter-gather entries
+void
+setFrameIov(const isc::util::OutputBuffer& header, const Pkt4Ptr& pkt,
+            struct iovec* iov) {
+    iov[0].iov_base = const_cast<void*>(header.getData());
+    iov[0].iov_len = header.getLength();
+    iov[1].iov_base = const_cast<void*>(pkt->getBuffer().getData());
+    iov[1].iov_len = pkt->getBuffer().getLength();
+}
 
-    // Make sure this isn't a fragment by checking that the fragment
-    // offset field in the IP header is zero.  This field is the
-    // least-significant 13 bits in the bytes at offsets 6 and 7 in
-    // the IP header, so the half-word at offset 20 (6 + size of
-    // Ethernet header) is loaded and an appropriate mask applied.
-    // #4
-    BPF_STMT(BPF_LD + BPF_H + BPF_ABS, ETHERNET_HEADER_LEN + IP_FLAGS_OFFSET),
-    // #5
-    BPF_JUMP(BPF_JMP + BPF_JSET + BPF_K, 0x1fff, 7, 0),
-
-    // Check the packet's destination address. The program will only
-    // allow the packets sent to the broadcast address or unicast
-    // to the specific address on the interface. By default, this
-    // address is set to 0 and must be set to the specific value
-    // when the raw socket is created and the program is attached
-    // to it. The caller must assign the address to the
-    // prog.bf_insns[8].k in the network byte order.
-    // #6
-    BPF_STMT(BPF_LD + BPF_W + BPF_ABS,
-             ETHERNET_HEADER_LEN + IP_DEST_ADDR_OFFSET),
-    // If this is a broadcast address, skip the next check.
-    // #7
-    BPF_JUMP(BPF_JMP + BPF_JEQ + BPF_K, 0xffffffff, 1, 0),
-    // If this is not broadcast address, compare it with the unicast
-    // address specified for the interface.
-    // #8
-    BPF_JUMP(BPF_JMP + BPF_JEQ + BPF_K, 0x00000000, 0, 4),
-
-    // Get the IP header length.  This is achieved by the following
-    // (special) instruction that, given the offset of the start
-    // of the IP header (offset 14) loads the IP header length.
-    // #9
-    BPF_STMT(BPF_LDX + BPF_B + BPF_MSH, ETHERNET_HEADER_LEN),
-
-    // Make sure it's to the right port.  The following instruction
-    // adds the previously extracted IP header length to the given
-    // offset to locate the correct byte.  The given offset of 16
-    // comprises the length of the Ethernet header (14) plus the offset
-    // of the UDP destination port (2) within the UDP header.
-    // #10
-    BPF_STMT(BPF_LD + BPF_H + BPF_IND, ETHERNET_HEADER_LEN + UDP_DEST_PORT),
-    // The following instruction tests against the default DHCP server port,
-    // but the action port is actually set in PktFilterBPF::openSocket().
-    // N.B. The code in that method assumes that this instruction is at
-    // offset 11 in the program.  If this is changed, openSocket() must be
-    // updated.
-    // #11
-    BPF_JUMP(BPF_JMP + BPF_JEQ + BPF_K, DHCP4_SERVER_PORT, 0, 1),
-
-    // If we passed all the tests, ask for the whole packet.
-    // #12
-    BPF_STMT(BPF_RET + BPF_K, (u_int)-1),
-
-    // Otherwise, drop it.
-    // #13
-    BPF_STMT(BPF_RET + BPF_K, 0),
+/// @brief Targets of the jumps of the filter program.
+enum JumpTarget {
+    // The next instruction.
+    NEXT,
+    // The instruction after the next one.
+    SKIP_ONE,
+    // The instruction accepting the frame.
+    ACCEPT,
+    // The instruction dropping the frame.
+    DROP
+};
+
+/// @brief Builder of a filter program with symbolic jump targets.
+class FilterProgram {
+public:
+
+    /// @brief Appends a statement.
+    ///
+    /// @param code instruction code
+    /// @param k instruction argument
+    void stmt(uint16_t code, uint32_t k) {
+        struct sock_filter insn = BPF_STMT(code, k);
+        insns_.push_back(insn);
+    }
+
+    /// @brief Appends a jump.
+    ///
+    /// @param code instruction code
+    /// @param k instruction argument
+    /// @param jt target when the condition is true
+    /// @param jf target when the condition is false
+    void jump(uint16_t code, uint32_t k, JumpTarget jt, JumpTarget jf) {
+        jumps_.push_back(Jump{insns_.size(), jt, jf});
+        struct sock_filter insn = BPF_JUMP(code, k, 0, 0);
+        insns_.push_back(insn);
+    }
+
+    /// @brief Appends the accept and drop instructions and resolves
+    /// the jumps.
+    ///
+    /// @return the program.
+    std::vector<struct sock_filter> finish() {
+        size_t accept = insns_.size();
+        stmt(BPF_RET + BPF_K, static_cast<uint32_t>(-1));
+        size_t drop = insns_.size();
+        stmt(BPF_RET + BPF_K, 0);
+        for (auto const& jump : jumps_) {
+            insns_[jump.index_].jt = offset(jump.index_, jump.jt_, accept, drop);
+            insns_[jump.index_].jf = offset(jump.index_, jump.jf_, accept, drop);
+        }
+        return (insns_);
+    }
+
+private:
+
+    /// @brief Returns the offset of a jump.
+    ///
+    /// @param index index of the jump
+    /// @param target target of the jump
+    /// @param accept index of the accept instruction
+    /// @param drop index of the drop instruction
+    /// @throw isc::Unexpected if the target is too far.
+    static uint8_t offset(size_t index, JumpTarget target, size_t accept,
+                          size_t drop) {
+        size_t off = 0;
+        switch (target) {
+        case NEXT:
+            break;
+        case SKIP_ONE:
+            off = 1;
+            break;
+        case ACCEPT:
+            off = accept - index - 1;
+            break;
+        case DROP:
+            off = drop - index - 1;
+            break;
+        }
+        if (off > 255) {
+            isc_throw(isc::Unexpected, "filter program jump too far");
+        }
+        return (static_cast<uint8_t>(off));
+    }
+
+    /// @brief A jump to resolve.
+    struct Jump {
+        /// @brief Index of the jump.
+        size_t index_;
+
+        /// @brief Target when the condition is true.
+        JumpTarget jt_;
+
+        /// @brief Target when the condition is false.
+        JumpTarget jf_;
+    };
+
+    /// @brief The instructions.
+    std::vector<struct sock_filter> insns_;
+
+    /// @brief The jumps to resolve.
+    std::vector<Jump> jumps_;
 };
 
 }
@@ -128,6 +161,26 @@ using namespace isc::util;
 namespace isc {
 namespace dhcp {
 
+const size_t
+PktFilterLPF::MAX_BATCH_SIZE = 32;
+
+const size_t
+PktFilterLPF::RX_RING_BLOCK_SIZE = 1 << 17;
+
+const size_t
+PktFilterLPF::RX_RING_BLOCK_NR = 8;
+
+const unsigned int
+PktFilterLPF::RX_RING_BLOCK_TIMEOUT = 1;
+
+PktFilterLPF::RxRing::RxRing(uint8_t* map, size_t size)
+    : map_(map), size_(size), block_(0), frame_(0), next_(0) {
+}
+
+PktFilterLPF::RxRing::~RxRing() {
+    munmap(map_, size_);
+}
+
 SocketInfo
 PktFilterLPF::openSocket(Iface& iface,
                          const isc::asiolink::IOAddress& addr,
@@ -140,13 +193,21 @@ PktFilterLPF::openSocket(Iface& iface,
     // raw socket below.
     int fallback = openFallbackSocket(addr, port);
 
-    // The fallback is open, so we are good to open primary socket.
-    int sock = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+    // The fallback is open, so we are good to open primary socket. Only
+    // the IP frames are delivered to the socket so the filter program does
+    // not run for the other protocols.
+    int sock = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_IP));
     if (sock < 0) {
         close(fallback);
         isc_throw(SocketConfigError, "Failed to create raw LPF socket");
     }
 
+    // Forget the ring of a closed socket which had the same descriptor.
+    {
+        std::lock_guard<std::mutex> lock(rx_rings_mutex_);
+        rx_rings_.erase(sock);
+    }
+
     // Set the close-on-exec flag.
     if (fcntl(sock, F_SETFD, FD_CLOEXEC) < 0) {
         close(sock);
@@ -157,20 +218,16 @@ PktFilterLPF::openSocket(Iface& iface,
 
     // Create socket filter program. This program will only allow incoming UDP
     // traffic which arrives on the specific (DHCP) port). It will also filter
-    // out all fragmented packets.
+    // out all fragmented packets, the messages which are not DHCPv4 requests
+    // and, when configured, the messages of the relays which are not
+    // accepted.
+    std::vector<struct sock_filter> program =
+        buildFilterProgram(addr, port, accepted_relays_);
     struct sock_fprog filter_program;
     memset(&filter_program, 0, sizeof(filter_program));
+    filter_program.filter = &program[0];
+    filter_program.len = program.size();
 
-    filter_program.filter = dhcp_sock_filter;
-    filter_program.len = sizeof(dhcp_sock_filter) / sizeof(struct sock_filter);
-
-    // Configure the filter program to receive unicast packets sent to the
-    // specified address. The program will also allow packets sent to the
-    // 255.255.255.255 broadcast address.
-    dhcp_sock_filter[8].k = addr.toUint32();
-
-    // Override the default port value.
-    dhcp_sock_filter[11].k = port;
     // Apply the filter.
     if (setsockopt(sock, SOL_SOCKET, SO_ATTACH_FILTER, &filter_program,
                    sizeof(filter_program)) < 0) {
@@ -180,10 +237,24 @@ PktFilterLPF::openSocket(Iface& iface,
                   << " on the socket " << sock);
     }
 
+    // Map the receive ring before the socket is bound so all the frames
+    // go to the ring. The frames are read from the socket without it.
+    openRxRing(sock);
+
+#ifdef PACKET_IGNORE_OUTGOING
+    // Do not loop back the frames sent by the server through the socket:
+    // they would only be dropped by the filter program. The option is not
+    // supported by kernels older than 4.20 so its failure is ignored.
+    int ignore_outgoing = 1;
+    static_cast<void>(setsockopt(sock, SOL_PACKET, PACKET_IGNORE_OUTGOING,
+                                 &ignore_outgoing, sizeof(ignore_outgoing)));
+#endif
+
     struct sockaddr_ll sa;
     memset(&sa, 0, sizeof(sockaddr_ll));
     sa.sll_family = AF_PACKET;
     sa.sll_ifindex = iface.getIndex();
+    sa.sll_protocol = htons(ETH_P_IP);
 
     // For raw sockets we construct IP headers on our own, so we don't bind
     // socket to IP address but to the interface. We will later use the
@@ -213,6 +284,210 @@ PktFilterLPF::openSocket(Iface& iface,
 
 }
 
+std::vector<struct sock_filter>
+PktFilterLPF::buildFilterProgram(const isc::asiolink::IOAddress& addr,
+                                 const uint16_t port,
+                                 const RelayPrefixes& relays) {
+    if (relays.size() > MAX_ACCEPTED_RELAYS) {
+        isc_throw(BadValue, "too many accepted relays " << relays.size()
+                  << " for the LPF filter program, the maximum is "
+                  << MAX_ACCEPTED_RELAYS);
+    }
+
+    // The program operates on Ethernet frames. For the frames we are
+    // interested in, the layout is:
+    //
+    //   6 bytes  Destination Ethernet Address
+    //   6 bytes  Source Ethernet Address
+    //   2 bytes  Ethernet packet type
+    //
+    //  20 bytes  Fixed part of IP header
+    //  variable  Variable part of IP header
+    //
+    //   2 bytes  UDP Source port
+    //   2 bytes  UDP destination port
+    //   2 bytes  UDP length
+    //   2 bytes  UDP checksum
+    //
+    //   1 byte   DHCPv4 op
+    //  23 bytes  Other fixed DHCPv4 fields
+    //   4 bytes  DHCPv4 giaddr
+    FilterProgram prog;
+
+    // Make sure this is an IP packet: check the half-word (two bytes)
+    // at offset 12 in the packet (the Ethernet packet type).
+    prog.stmt(BPF_LD + BPF_H + BPF_ABS, ETHERNET_PACKET_TYPE_OFFSET);
+    prog.jump(BPF_JMP + BPF_JEQ + BPF_K, ETHERTYPE_IP, NEXT, DROP);
+
+    // Make sure it's a UDP packet. The IP protocol is at offset 9 in the
+    // IP header.
+    prog.stmt(BPF_LD + BPF_B + BPF_ABS,
+              ETHERNET_HEADER_LEN + IP_PROTO_TYPE_OFFSET);
+    prog.jump(BPF_JMP + BPF_JEQ + BPF_K, IPPROTO_UDP, NEXT, DROP);
+
+    // Make sure this isn't a fragment by checking that the fragment
+    // offset field in the IP header is zero. This field is the
+    // least-significant 13 bits in the bytes at offsets 6 and 7 in
+    // the IP header.
+    prog.stmt(BPF_LD + BPF_H + BPF_ABS, ETHERNET_HEADER_LEN + IP_FLAGS_OFFSET);
+    prog.jump(BPF_JMP + BPF_JSET + BPF_K, 0x1fff, DROP, NEXT);
+
+    // Only allow the packets sent to the broadcast address or unicast
+    // to the specific address on the interface.
+    prog.stmt(BPF_LD + BPF_W + BPF_ABS,
+              ETHERNET_HEADER_LEN + IP_DEST_ADDR_OFFSET);
+    prog.jump(BPF_JMP + BPF_JEQ + BPF_K, 0xffffffff, SKIP_ONE, NEXT);
+    prog.jump(BPF_JMP + BPF_JEQ + BPF_K, addr.toUint32(), NEXT, DROP);
+
+    // Get the IP header length. This (special) instruction, given the
+    // offset of the start of the IP header, loads the IP header length
+    // in the index register so the next loads are relative to the UDP
+    // header.
+    prog.stmt(BPF_LDX + BPF_B + BPF_MSH, ETHERNET_HEADER_LEN);
+
+    // Make sure it's to the right port.
+    prog.stmt(BPF_LD + BPF_H + BPF_IND, ETHERNET_HEADER_LEN + UDP_DEST_PORT);
+    prog.jump(BPF_JMP + BPF_JEQ + BPF_K, port, NEXT, DROP);
+
+    // Drop the datagrams too short to hold the fixed DHCPv4 fields: they
+    // would be rejected when unpacked.
+    prog.stmt(BPF_LD + BPF_H + BPF_IND, ETHERNET_HEADER_LEN + UDP_LEN_OFFSET);
+    prog.jump(BPF_JMP + BPF_JGE + BPF_K,
+              UDP_HEADER_LEN + Pkt4::DHCPV4_PKT_HDR_LEN, NEXT, DROP);
+
+    // Drop the BOOTREPLY messages: they are meant to the clients.
+    prog.stmt(BPF_LD + BPF_B + BPF_IND, ETHERNET_HEADER_LEN + UDP_HEADER_LEN +
+              DHCPV4_OP_OFFSET);
+    prog.jump(BPF_JMP + BPF_JEQ + BPF_K, BOOTREQUEST, NEXT, DROP);
+
+    // Accept the messages which are not relayed and the messages of the
+    // accepted relays.
+    if (!relays.empty()) {
+        prog.stmt(BPF_LD + BPF_W + BPF_IND, ETHERNET_HEADER_LEN +
+                  UDP_HEADER_LEN + DHCPV4_GIADDR_OFFSET);
+        prog.jump(BPF_JMP + BPF_JEQ + BPF_K, 0, ACCEPT, NEXT);
+        prog.stmt(BPF_ST, 0);
+        for (auto const& relay : relays) {
+            uint32_t mask = (relay.second == 0 ? 0 :
+                             0xffffffff << (32 - relay.second));
+            prog.stmt(BPF_LD + BPF_MEM, 0);
+            prog.stmt(BPF_ALU + BPF_AND + BPF_K, mask);
+            prog.jump(BPF_JMP + BPF_JEQ + BPF_K,
+                      relay.first.toUint32() & mask, ACCEPT, NEXT);
+        }
+        prog.stmt(BPF_RET + BPF_K, 0);
+    }
+
+    return (prog.finish());
+}
+
+bool
+PktFilterLPF::openRxRing(int sock) {
+    int version = TPACKET_V3;
+    if (setsockopt(sock, SOL_PACKET, PACKET_VERSION, &version,
+                   sizeof(version)) < 0) {
+        return (false);
+    }
+
+    struct tpacket_req3 req;
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = RX_RING_BLOCK_SIZE;
+    req.tp_block_nr = RX_RING_BLOCK_NR;
+    req.tp_frame_size = TPACKET_ALIGN(TPACKET3_HDRLEN + ETHERNET_HEADER_LEN +
+                                      IfaceMgr::RCVBUFSIZE);
+    req.tp_frame_nr = (RX_RING_BLOCK_SIZE / req.tp_frame_size) *
+                      RX_RING_BLOCK_NR;
+    req.tp_retire_blk_tov = RX_RING_BLOCK_TIMEOUT;
+    if (setsockopt(sock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+        return (false);
+    }
+
+    size_t size = RX_RING_BLOCK_SIZE * RX_RING_BLOCK_NR;
+    void* map = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, sock, 0);
+    if (map == MAP_FAILED) {
+        // Remove the ring so the frames are queued on the socket.
+        memset(&req, 0, sizeof(req));
+        static_cast<void>(setsockopt(sock, SOL_PACKET, PACKET_RX_RING, &req,
+                                     sizeof(req)));
+        return (false);
+    }
+
+    RxRingPtr ring(new RxRing(static_cast<uint8_t*>(map), size));
+    std::lock_guard<std::mutex> lock(rx_rings_mutex_);
+    rx_rings_[sock] = ring;
+    return (true);
+}
+
+PktFilterLPF::RxRingPtr
+PktFilterLPF::getRxRing(int sock) {
+    std::lock_guard<std::mutex> lock(rx_rings_mutex_);
+    auto it = rx_rings_.find(sock);
+    if (it == rx_rings_.end()) {
+        return (RxRingPtr());
+    }
+    return (it->second);
+}
+
+Pkt4Ptr
+PktFilterLPF::receiveFromRing(Iface& iface, RxRing& ring) {
+    for (;;) {
+        struct tpacket_block_desc* block =
+            reinterpret_cast<struct tpacket_block_desc*>(ring.map_ +
+                                                         ring.block_ *
+                                                         RX_RING_BLOCK_SIZE);
+        // The block belongs to the kernel until it sets the user status.
+        uint32_t status = __atomic_load_n(&block->hdr.bh1.block_status,
+                                          __ATOMIC_ACQUIRE);
+        if ((status & TP_STATUS_USER) == 0) {
+            return (Pkt4Ptr());
+        }
+
+        uint32_t num_pkts = block->hdr.bh1.num_pkts;
+        if (ring.frame_ == 0) {
+            ring.next_ = reinterpret_cast<uint8_t*>(block) +
+                         block->hdr.bh1.offset_to_first_pkt;
+        }
+
+        const uint8_t* data = 0;
+        size_t data_len = 0;
+        if (ring.frame_ < num_pkts) {
+            struct tpacket3_hdr* hdr =
+                reinterpret_cast<struct tpacket3_hdr*>(ring.next_);
+            data = ring.next_ + hdr->tp_mac;
+            data_len = hdr->tp_snaplen;
+            ring.next_ += hdr->tp_next_offset;
+            ++ring.frame_;
+        }
+
+        // The decoded packet holds a copy of the frame so the block is
+        // returned to the kernel after its last frame is decoded, even
+        // when the decoding fails.
+        auto release = [&ring, block, num_pkts]() {
+            if (ring.frame_ >= num_pkts) {
+                ring.frame_ = 0;
+                ring.block_ = (ring.block_ + 1) % RX_RING_BLOCK_NR;
+                __atomic_store_n(&block->hdr.bh1.block_status,
+                                 TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+            }
+        };
+
+        if (!data) {
+            release();
+            continue;
+        }
+
+        Pkt4Ptr pkt;
+        try {
+            pkt = decodePacket(iface, data, data_len);
+        } catch (...) {
+            release();
+            throw;
+        }
+        release();
+        return (pkt);
+    }
+}
+
 Pkt4Ptr
 PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
     uint8_t raw_buf[IfaceMgr::RCVBUFSIZE];
@@ -237,6 +512,12 @@ PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
 
     // Now that we finished getting data from the fallback socket, we
     // have to get the data from the raw socket too.
+    RxRingPtr ring = getRxRing(socket_info.sockfd_);
+    if (ring) {
+        std::lock_guard<std::mutex> lock(receive_mutex_);
+        return (receiveFromRing(iface, *ring));
+    }
+
     int data_len = read(socket_info.sockfd_, raw_buf, sizeof(raw_buf));
     // If negative value is returned by read(), it indicates that an
     // error occurred. If returned value is 0, no data was read from the
@@ -247,6 +528,12 @@ PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
         return Pkt4Ptr();
     }
 
+    return (decodePacket(iface, raw_buf, data_len));
+}
+
+Pkt4Ptr
+PktFilterLPF::decodePacket(Iface& iface, const uint8_t* raw_buf,
+                           size_t data_len) {
     InputBuffer buf(raw_buf, data_len);
 
     // @todo: This is awkward way to solve the chicken and egg problem
@@ -272,7 +559,7 @@ PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
     buf.readVector(dhcp_buf, buf.getLength() - buf.getPosition());
 
     // Decode DHCP data into the Pkt4 object.
-    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(&dhcp_buf[0], dhcp_buf.size()));
+    Pkt4Ptr pkt = makeRecycled<Pkt4>(&dhcp_buf[0], dhcp_buf.size());
 
     // Set the appropriate packet members using data collected from
     // the decoded headers.
@@ -288,10 +575,168 @@ PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
     return (pkt);
 }
 
+size_t
+PktFilterLPF::receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                           std::vector<Pkt4Ptr>& pkts, size_t max_count) {
+    RxRingPtr ring = getRxRing(socket_info.sockfd_);
+    if (ring) {
+        // Drain the fallback socket as in receive().
+        uint8_t raw_buf[IfaceMgr::RCVBUFSIZE];
+        int datalen;
+        do {
+            datalen = recv(socket_info.fallbackfd_, raw_buf, sizeof(raw_buf),
+                           0);
+        } while (datalen > 0);
+
+        // The frames are read from the ring until it is empty.
+        std::lock_guard<std::mutex> lock(receive_mutex_);
+        size_t received = 0;
+        while (received < max_count) {
+            Pkt4Ptr pkt;
+            try {
+                pkt = receiveFromRing(iface, *ring);
+            } catch (const std::exception&) {
+                // Frames which can't be decoded are dropped so they do
+                // not affect the other packets of the batch.
+                continue;
+            }
+            if (!pkt) {
+                break;
+            }
+            pkts.push_back(pkt);
+            ++received;
+        }
+        return (received);
+    }
+
+    size_t count = std::min(max_count, MAX_BATCH_SIZE);
+    if (count <= 1) {
+        return (PktFilter::receiveBatch(iface, socket_info, pkts, max_count));
+    }
+
+    std::lock_guard<std::mutex> lock(receive_mutex_);
+    if (receive_data_.empty()) {
+        receive_data_.resize(MAX_BATCH_SIZE * IfaceMgr::RCVBUFSIZE);
+        receive_iov_.resize(MAX_BATCH_SIZE);
+        receive_msgs_.resize(MAX_BATCH_SIZE);
+    }
+
+    // Drain the fallback socket as in receive().
+    int datalen;
+    do {
+        datalen = recv(socket_info.fallbackfd_, &receive_data_[0],
+                       IfaceMgr::RCVBUFSIZE, 0);
+    } while (datalen > 0);
+
+    for (size_t i = 0; i < count; ++i) {
+        memset(&receive_msgs_[i], 0, sizeof(receive_msgs_[i]));
+        receive_iov_[i].iov_base = &receive_data_[i * IfaceMgr::RCVBUFSIZE];
+        receive_iov_[i].iov_len = IfaceMgr::RCVBUFSIZE;
+        receive_msgs_[i].msg_hdr.msg_iov = &receive_iov_[i];
+        receive_msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // The socket is non-blocking so only the frames which are already
+    // queued are read.
+    int result = recvmmsg(socket_info.sockfd_, &receive_msgs_[0], count,
+                          MSG_DONTWAIT, 0);
+    if (result <= 0) {
+        return (0);
+    }
+
+    size_t received = 0;
+    for (int i = 0; i < result; ++i) {
+        try {
+            pkts.push_back(decodePacket(iface,
+                                        &receive_data_[i * IfaceMgr::RCVBUFSIZE],
+                                        receive_msgs_[i].msg_len));
+            ++received;
+        } catch (const std::exception&) {
+            // Frames which can't be decoded are dropped so they do not
+            // affect the other packets of the batch.
+        }
+    }
+    return (received);
+}
+
 int
 PktFilterLPF::send(const Iface& iface, uint16_t sockfd, const Pkt4Ptr& pkt) {
 
-    OutputBuffer buf(14);
+    OutputBuffer header(FRAME_HEADER_LEN);
+    buildFrameHeader(iface, pkt, header);
+
+    sockaddr_ll sa;
+    memset(&sa, 0x0, sizeof(sa));
+    sa.sll_family = AF_PACKET;
+    sa.sll_ifindex = iface.getIndex();
+    sa.sll_protocol = htons(ETH_P_IP);
+    sa.sll_halen = 6;
+
+    struct iovec iov[2];
+    setFrameIov(header, pkt, iov);
+
+    struct msghdr m;
+    memset(&m, 0, sizeof(m));
+    m.msg_name = &sa;
+    m.msg_namelen = sizeof(sa);
+    m.msg_iov = iov;
+    m.msg_iovlen = 2;
+
+    int result = sendmsg(sockfd, &m, 0);
+    if (result < 0) {
+        isc_throw(SocketWriteError, "failed to send DHCPv4 packet, errno="
+                  << errno << " (check errno.h)");
+    }
+
+    return (0);
+
+}
+
+size_t
+PktFilterLPF::sendBatch(const Iface& iface, uint16_t sockfd,
+                        const std::vector<Pkt4Ptr>& pkts) {
+    size_t count = pkts.size();
+    if (count <= 1) {
+        return (PktFilter::sendBatch(iface, sockfd, pkts));
+    }
+
+    sockaddr_ll sa;
+    memset(&sa, 0x0, sizeof(sa));
+    sa.sll_family = AF_PACKET;
+    sa.sll_ifindex = iface.getIndex();
+    sa.sll_protocol = htons(ETH_P_IP);
+    sa.sll_halen = 6;
+
+    std::vector<OutputBuffer> headers(count, OutputBuffer(FRAME_HEADER_LEN));
+    std::vector<struct iovec> iov(2 * count);
+    std::vector<struct mmsghdr> msgs(count);
+    memset(&msgs[0], 0, count * sizeof(struct mmsghdr));
+    for (size_t i = 0; i < count; ++i) {
+        buildFrameHeader(iface, pkts[i], headers[i]);
+        setFrameIov(headers[i], pkts[i], &iov[2 * i]);
+        msgs[i].msg_hdr.msg_name = &sa;
+        msgs[i].msg_hdr.msg_namelen = sizeof(sa);
+        msgs[i].msg_hdr.msg_iov = &iov[2 * i];
+        msgs[i].msg_hdr.msg_iovlen = 2;
+    }
+
+    // The kernel may send less frames than requested so loop until
+    // all of them are sent.
+    size_t sent = 0;
+    while (sent < count) {
+        int result = sendmmsg(sockfd, &msgs[sent], count - sent, 0);
+        if (result < 0) {
+            isc_throw(SocketWriteError, "failed to send DHCPv4 packets, errno="
+                      << errno << " (check errno.h)");
+        }
+        sent += result;
+    }
+    return (sent);
+}
+
+void
+PktFilterLPF::buildFrameHeader(const Iface& iface, const Pkt4Ptr& pkt,
+                               OutputBuffer& buf) {
 
     // Some interfaces may have no HW address - e.g. loopback interface.
     // For these interfaces the HW address length is 0. If this is the case,
@@ -312,27 +757,6 @@ PktFilterLPF::send(const Iface& iface, uint16_t sockfd, const Pkt4Ptr& pkt) {
 
     // IP and UDP header
     writeIpUdpHeader(pkt, buf);
-
-    // DHCPv4 message
-    buf.writeData(pkt->getBuffer().getData(), pkt->getBuffer().getLength());
-
-    sockaddr_ll sa;
-    memset(&sa, 0x0, sizeof(sa));
-    sa.sll_family = AF_PACKET;
-    sa.sll_ifindex = iface.getIndex();
-    sa.sll_protocol = htons(ETH_P_IP);
-    sa.sll_halen = 6;
-
-    int result = sendto(sockfd, buf.getData(), buf.getLength(), 0,
-                        reinterpret_cast<const struct sockaddr*>(&sa),
-                        sizeof(sockaddr_ll));
-    if (result < 0) {
-        isc_throw(SocketWriteError, "failed to send DHCPv4 packet, errno="
-                  << errno << " (check errno.h)");
-    }
-
-    return (0);
-
 }
 
 
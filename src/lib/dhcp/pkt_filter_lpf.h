@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,6 +11,15 @@
 
 #include <util/buffer.h>
 
+#include <boost/shared_ptr.hpp>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <linux/filter.h>
+#include <sys/socket.h>
+
 namespace isc {
 namespace dhcp {
 
@@ -20,6 +29,12 @@ namespace dhcp {
 /// sockets and Linux Packet Filtering. It is used by @c isc::dhcp::IfaceMgr
 /// to send DHCPv4 messages to the hosts which don't have an IPv4 address
 /// assigned yet.
+///
+/// When the kernel supports it, the frames are received through a
+/// TPACKET_V3 ring memory mapped for each raw socket: the kernel fills
+/// blocks of frames and the frames are read from the ring without a
+/// system call. The filter falls back to reading the socket when the
+/// ring can't be set up.
 class PktFilterLPF : public PktFilter {
 public:
 
@@ -32,6 +47,48 @@ public:
         return (true);
     }
 
+    /// @brief Check if the received frames may be queued outside of the
+    /// socket receive queue.
+    ///
+    /// The frames are delivered through the receive ring when it could be
+    /// set up.
+    ///
+    /// @return true always.
+    virtual bool isReceiveRingSupported() const {
+        return (true);
+    }
+
+    /// @brief Sets the relays the messages of which are received by the
+    /// sockets opened by subsequent calls to @c openSocket.
+    ///
+    /// @param prefixes the prefixes of the accepted relays, empty to
+    /// accept all the relays.
+    virtual void setAcceptedRelays(const RelayPrefixes& prefixes) {
+        accepted_relays_ = prefixes;
+    }
+
+    /// @brief Builds the filter program attached to the raw sockets.
+    ///
+    /// The program accepts the non fragmented UDP datagrams sent to the
+    /// given port and to the broadcast address or the given address,
+    /// which are long enough to hold a DHCPv4 message and hold a
+    /// BOOTREQUEST. When relays are given, the relayed messages must also
+    /// have a giaddr belonging to one of the relay prefixes. The other
+    /// frames are dropped by the kernel before they are copied to the
+    /// server.
+    ///
+    /// @param addr Address on the interface.
+    /// @param port Port number.
+    /// @param relays Prefixes of the accepted relays, empty to accept all
+    /// the relays.
+    /// @return The program.
+    /// @throw isc::BadValue if there are more than @c MAX_ACCEPTED_RELAYS
+    /// relay prefixes.
+    static std::vector<struct sock_filter>
+    buildFilterProgram(const isc::asiolink::IOAddress& addr,
+                       const uint16_t port,
+                       const RelayPrefixes& relays);
+
     /// @brief Open primary and fallback socket.
     ///
     /// @param iface Interface descriptor.
@@ -67,6 +124,152 @@ public:
     virtual int send(const Iface& iface, uint16_t sockfd,
                      const Pkt4Ptr& pkt);
 
+    /// @brief Receive a batch of packets over specified socket.
+    ///
+    /// Reads up to @c max_count frames from the receive ring of the socket
+    /// or, when the socket has no ring, uses recvmmsg() with preallocated
+    /// buffers to read up to @c MAX_BATCH_SIZE frames from the raw socket
+    /// in a single system call. Frames which can't be decoded are dropped.
+    ///
+    /// @param iface interface
+    /// @param socket_info structure holding socket information
+    /// @param[out] pkts vector to which the received packets are appended
+    /// @param max_count maximum number of packets to read
+    ///
+    /// @return The number of appended packets.
+    virtual size_t receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                                std::vector<Pkt4Ptr>& pkts,
+                                size_t max_count);
+
+    /// @brief Send a batch of packets over specified socket.
+    ///
+    /// Uses sendmmsg() to send the frames in as few system calls as
+    /// possible.
+    ///
+    /// @param iface interface to be used to send packets
+    /// @param sockfd socket descriptor
+    /// @param pkts packets to be sent
+    ///
+    /// @return The number of sent packets.
+    /// @throw isc::dhcp::SocketWriteError if an error occurs during sending
+    /// the packets through the socket.
+    virtual size_t sendBatch(const Iface& iface, uint16_t sockfd,
+                             const std::vector<Pkt4Ptr>& pkts);
+
+    /// @brief Maximum number of packets read by one @c receiveBatch call.
+    static const size_t MAX_BATCH_SIZE;
+
+    /// @brief Size of a block of the receive ring.
+    static const size_t RX_RING_BLOCK_SIZE;
+
+    /// @brief Number of blocks of the receive ring.
+    static const size_t RX_RING_BLOCK_NR;
+
+    /// @brief Timeout in milliseconds after which the kernel hands out a
+    /// block of the receive ring which is not full.
+    static const unsigned int RX_RING_BLOCK_TIMEOUT;
+
+private:
+    /// @brief TPACKET_V3 receive ring mapped for a raw socket.
+    struct RxRing {
+        /// @brief Constructor.
+        ///
+        /// @param map address of the mapped ring
+        /// @param size size of the mapped ring
+        RxRing(uint8_t* map, size_t size);
+
+        /// @brief Destructor.
+        ///
+        /// Unmaps the ring.
+        ~RxRing();
+
+        /// @brief Address of the mapped ring.
+        uint8_t* map_;
+
+        /// @brief Size of the mapped ring.
+        size_t size_;
+
+        /// @brief Index of the block being read.
+        size_t block_;
+
+        /// @brief Index of the next frame to read in the block.
+        uint32_t frame_;
+
+        /// @brief Next frame to read in the block.
+        uint8_t* next_;
+    };
+
+    /// @brief Pointer to a receive ring.
+    typedef boost::shared_ptr<RxRing> RxRingPtr;
+
+    /// @brief Sets up the receive ring of a raw socket.
+    ///
+    /// @param sock raw socket descriptor
+    /// @return true if the ring was set up, false if the frames must be
+    /// read from the socket.
+    bool openRxRing(int sock);
+
+    /// @brief Returns the receive ring of a raw socket.
+    ///
+    /// @param sock raw socket descriptor
+    /// @return The receive ring or null when the socket has no ring.
+    RxRingPtr getRxRing(int sock);
+
+    /// @brief Reads the next frame from a receive ring.
+    ///
+    /// The block holding the frame is returned to the kernel once its
+    /// last frame is read. The receive mutex must be held.
+    ///
+    /// @param iface interface
+    /// @param ring receive ring
+    /// @return Received packet or null when no frame is ready.
+    Pkt4Ptr receiveFromRing(Iface& iface, RxRing& ring);
+
+    /// @brief Decodes a received frame.
+    ///
+    /// @param iface interface
+    /// @param raw_buf received frame
+    /// @param data_len length of the received frame
+    ///
+    /// @return Received packet
+    Pkt4Ptr decodePacket(Iface& iface, const uint8_t* raw_buf,
+                         size_t data_len);
+
+    /// @brief Builds the headers of the frame to be sent.
+    ///
+    /// The frame is sent as the ethernet, IP and UDP headers followed by
+    /// the packet buffer, so the DHCPv4 message is not copied.
+    ///
+    /// @param iface interface to be used to send the packet
+    /// @param pkt packet to be sent
+    /// @param[out] buf frame header buffer
+    void buildFrameHeader(const Iface& iface, const Pkt4Ptr& pkt,
+                          isc::util::OutputBuffer& buf);
+
+    /// @brief Batch receive data buffers.
+    std::vector<uint8_t> receive_data_;
+
+    /// @brief Batch receive scatter-gather entries.
+    std::vector<struct iovec> receive_iov_;
+
+    /// @brief Batch receive message headers.
+    std::vector<struct mmsghdr> receive_msgs_;
+
+    /// @brief Mutex protecting the batch receive buffers and the reading
+    /// of the receive rings.
+    std::mutex receive_mutex_;
+
+    /// @brief Receive rings indexed by raw socket descriptor.
+    ///
+    /// The ring of a closed socket is unmapped when the descriptor is
+    /// reused by a new raw socket or when the filter is destroyed.
+    std::map<int, RxRingPtr> rx_rings_;
+
+    /// @brief Mutex protecting the receive rings container.
+    std::mutex rx_rings_mutex_;
+
+    /// @brief Prefixes of the accepted relays.
+    RelayPrefixes accepted_relays_;
 };
 
 } // namespace isc::dhcp
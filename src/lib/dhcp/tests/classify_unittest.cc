@@ -169,3 +169,47 @@ TEST(ClassifyTest, Erase) {
     EXPECT_FALSE(classes.contains("alpha"));
     EXPECT_FALSE(classes.contains("beta"));
 }
+
+// Check the lookups of interned classes.
+TEST(ClassifyTest, Interned) {
+    ClientClassId alpha = ClientClasses::intern("interned-alpha");
+    ClientClassId beta = ClientClasses::intern("interned-beta");
+    EXPECT_NE(alpha, beta);
+    EXPECT_EQ(alpha, ClientClasses::intern("interned-alpha"));
+
+    ClientClasses classes;
+    EXPECT_FALSE(classes.contains(alpha));
+    EXPECT_FALSE(classes.contains(beta));
+
+    classes.insert("interned-alpha");
+    EXPECT_TRUE(classes.contains(alpha));
+    EXPECT_FALSE(classes.contains(beta));
+
+    // Copies have the same classes.
+    ClientClasses copy(classes);
+    EXPECT_TRUE(copy.contains(alpha));
+
+    classes.erase("interned-alpha");
+    EXPECT_FALSE(classes.contains(alpha));
+
+    classes.insert("interned-beta");
+    EXPECT_FALSE(classes.contains(alpha));
+    EXPECT_TRUE(classes.contains(beta));
+
+    classes.clear();
+    EXPECT_FALSE(classes.contains(beta));
+}
+
+// Check the lookups of classes interned after their insertion.
+TEST(ClassifyTest, InternedLater) {
+    ClientClasses classes("interned-later, interned-first");
+    ClientClassId first = ClientClasses::intern("interned-first");
+    ClientClassId later = ClientClasses::intern("interned-later");
+    ClientClassId other = ClientClasses::intern("interned-other");
+    EXPECT_TRUE(classes.contains(first));
+    EXPECT_TRUE(classes.contains(later));
+    EXPECT_FALSE(classes.contains(other));
+
+    // Unknown identifiers are not contained.
+    EXPECT_FALSE(classes.contains(other + 1000));
+}
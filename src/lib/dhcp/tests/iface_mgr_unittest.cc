@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -36,6 +36,7 @@ using namespace isc::asiolink;
 using namespace isc::dhcp;
 using namespace isc::dhcp::test;
 using boost::scoped_ptr;
+using isc::util::FDEventHandler;
 namespace ph = std::placeholders;
 
 namespace {
@@ -3134,6 +3135,107 @@ TEST_F(IfaceMgrTest, purgeExternalSockets4Indirect) {
     purgeExternalSockets4Test(true);
 }
 
+#if defined(OS_LINUX)
+// Tests that external sockets are supported by receive4() when the
+// epoll event handler is used, including a descriptor which is closed,
+// reopened under the same number and registered again.
+TEST_F(IfaceMgrTest, ExternalSockets4EPoll) {
+
+    callback_ok = false;
+    callback2_ok = false;
+
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+    ASSERT_NO_THROW(ifacemgr->setEventHandlerType(FDEventHandler::TYPE_EPOLL));
+    EXPECT_EQ(FDEventHandler::TYPE_EPOLL, ifacemgr->getEventHandlerType());
+
+    // Create two pipes and register them as extra sockets
+    int pipefd[2];
+    EXPECT_TRUE(pipe(pipefd) == 0);
+    EXPECT_NO_THROW(ifacemgr->addExternalSocket(pipefd[0], my_callback));
+    int secondpipe[2];
+    EXPECT_TRUE(pipe(secondpipe) == 0);
+    EXPECT_NO_THROW(ifacemgr->addExternalSocket(secondpipe[0], my_callback2));
+
+    Pkt4Ptr pkt4;
+    ASSERT_NO_THROW(pkt4 = ifacemgr->receive4(RECEIVE_WAIT_MS(10)));
+    EXPECT_FALSE(callback_ok);
+    EXPECT_FALSE(callback2_ok);
+    EXPECT_FALSE(pkt4);
+
+    // Send some data over the second pipe.
+    EXPECT_EQ(38, write(secondpipe[1], "Hi, this is a message sent over a pipe", 38));
+    ASSERT_NO_THROW(pkt4 = ifacemgr->receive4(RECEIVE_WAIT_MS(10)));
+    EXPECT_FALSE(callback_ok);
+    EXPECT_TRUE(callback2_ok);
+    EXPECT_FALSE(pkt4);
+
+    // Replace the first pipe by a new one using the same descriptor.
+    int fd0 = pipefd[0];
+    EXPECT_NO_THROW(ifacemgr->deleteExternalSocket(pipefd[0]));
+    close(pipefd[1]);
+    close(pipefd[0]);
+    EXPECT_TRUE(pipe(pipefd) == 0);
+    ASSERT_EQ(fd0, pipefd[0]);
+    EXPECT_NO_THROW(ifacemgr->addExternalSocket(pipefd[0], my_callback));
+
+    // Drain the second pipe and send data over the new first pipe.
+    char buf[80];
+    EXPECT_EQ(38, read(secondpipe[0], buf, 80));
+    callback2_ok = false;
+    EXPECT_EQ(38, write(pipefd[1], "Hi, this is a message sent over a pipe", 38));
+    ASSERT_NO_THROW(pkt4 = ifacemgr->receive4(RECEIVE_WAIT_MS(10)));
+    EXPECT_TRUE(callback_ok);
+    EXPECT_FALSE(callback2_ok);
+    EXPECT_FALSE(pkt4);
+
+    // close both pipe ends
+    close(pipefd[1]);
+    close(pipefd[0]);
+
+    close(secondpipe[1]);
+    close(secondpipe[0]);
+}
+
+// Tests that the epoll event handler is used by the receiver thread
+// and the receive4() method when queuing is enabled.
+TEST_F(IfaceMgrTest, ExternalSockets4EPollIndirect) {
+
+    callback_ok = false;
+
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+    ASSERT_NO_THROW(ifacemgr->setEventHandlerType(FDEventHandler::TYPE_EPOLL));
+
+    bool queue_enabled = false;
+    data::ConstElementPtr config = makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500);
+    ASSERT_NO_THROW(queue_enabled = ifacemgr->configureDHCPPacketQueue(AF_INET, config));
+    ASSERT_TRUE(queue_enabled);
+    ASSERT_NO_THROW(ifacemgr->startDHCPReceiver(AF_INET));
+
+    // The type can't be changed while the receiver is running.
+    EXPECT_THROW(ifacemgr->setEventHandlerType(FDEventHandler::TYPE_SELECT),
+                 InvalidOperation);
+
+    int pipefd[2];
+    EXPECT_TRUE(pipe(pipefd) == 0);
+    EXPECT_NO_THROW(ifacemgr->addExternalSocket(pipefd[0], my_callback));
+
+    Pkt4Ptr pkt4;
+    ASSERT_NO_THROW(pkt4 = ifacemgr->receive4(RECEIVE_WAIT_MS(10)));
+    EXPECT_FALSE(callback_ok);
+    EXPECT_FALSE(pkt4);
+
+    EXPECT_EQ(38, write(pipefd[1], "Hi, this is a message sent over a pipe", 38));
+    ASSERT_NO_THROW(pkt4 = ifacemgr->receive4(RECEIVE_WAIT_MS(10)));
+    EXPECT_TRUE(callback_ok);
+    EXPECT_FALSE(pkt4);
+
+    close(pipefd[1]);
+    close(pipefd[0]);
+
+    ASSERT_NO_THROW(ifacemgr->stopDHCPReceiver());
+}
+#endif
+
 // Tests if a single external socket and its callback can be passed and
 // it is supported properly by receive6() method.
 TEST_F(IfaceMgrTest, SingleExternalSocket6) {
@@ -3500,6 +3602,108 @@ TEST_F(IfaceMgrTest, configureDHCPPacketQueueTest4) {
     ASSERT_FALSE(ifacemgr->isDHCPReceiverRunning());
 }
 
+// Verifies that configureDHCPPacketQueue() sets the number of DHCPv4
+// receiver threads.
+TEST_F(IfaceMgrTest, configureReceiverThreads4) {
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+    EXPECT_EQ(1, ifacemgr->getReceiverThreadsCount());
+
+    // Zero is not a valid number of threads.
+    EXPECT_THROW(ifacemgr->setReceiverThreadsCount(0), BadValue);
+    EXPECT_NO_THROW(ifacemgr->setReceiverThreadsCount(2));
+    EXPECT_EQ(2, ifacemgr->getReceiverThreadsCount());
+
+    // The number is taken from the queue control.
+    data::ElementPtr queue_control =
+        makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, true);
+    queue_control->set("receiver-threads", data::Element::create(4));
+    bool queue_enabled = false;
+    ASSERT_NO_THROW(queue_enabled = ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    ASSERT_TRUE(queue_enabled);
+    EXPECT_EQ(4, ifacemgr->getReceiverThreadsCount());
+
+    // The number can't be changed while the receiver is running.
+    ASSERT_NO_THROW(ifacemgr->startDHCPReceiver(AF_INET));
+    ASSERT_TRUE(ifacemgr->isDHCPReceiverRunning());
+    EXPECT_THROW(ifacemgr->setReceiverThreadsCount(2), InvalidOperation);
+    ASSERT_NO_THROW(ifacemgr->stopDHCPReceiver());
+
+    // Negative values are rejected.
+    queue_control->set("receiver-threads", data::Element::create(-1));
+    EXPECT_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control),
+                 BadValue);
+
+    // Disabling the queue goes back to a single receiver.
+    queue_control = makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, false);
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_EQ(1, ifacemgr->getReceiverThreadsCount());
+}
+
+// Verifies that configureDHCPPacketQueue() sets the rate limiter.
+TEST_F(IfaceMgrTest, configureRateLimiter) {
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+    EXPECT_FALSE(ifacemgr->getPacketRateLimiter());
+
+    data::ElementPtr queue_control =
+        makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, true);
+    queue_control->set("rate-limit",
+                       data::Element::fromJSON("{ \"client-rate\": 10 }"));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    ASSERT_TRUE(ifacemgr->getPacketRateLimiter());
+    EXPECT_EQ(10, ifacemgr->getPacketRateLimiter()->getRate(PacketRateLimiter::CLIENT));
+
+    // The limiter can't be changed while the receiver is running.
+    ASSERT_NO_THROW(ifacemgr->startDHCPReceiver(AF_INET));
+    ASSERT_TRUE(ifacemgr->isDHCPReceiverRunning());
+    EXPECT_THROW(ifacemgr->setPacketRateLimiter(PacketRateLimiterPtr()),
+                 InvalidOperation);
+    ASSERT_NO_THROW(ifacemgr->stopDHCPReceiver());
+
+    // A limiter without limits is not used.
+    queue_control->set("rate-limit", data::Element::createMap());
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_FALSE(ifacemgr->getPacketRateLimiter());
+
+    // Invalid values are rejected.
+    queue_control->set("rate-limit",
+                       data::Element::fromJSON("{ \"relay-rate\": -1 }"));
+    EXPECT_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control),
+                 BadValue);
+
+    // Disabling the queue removes the limiter.
+    ASSERT_NO_THROW(ifacemgr->setPacketRateLimiter(PacketRateLimiterPtr(new PacketRateLimiter())));
+    queue_control = makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, false);
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_FALSE(ifacemgr->getPacketRateLimiter());
+}
+
+// Verifies that the CPU affinity of the receiver threads can be set.
+TEST_F(IfaceMgrTest, receiverCpuAffinity) {
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+    EXPECT_TRUE(ifacemgr->getReceiverCpuAffinity().empty());
+
+    util::CpuList cpus = util::getAvailableCpus();
+    if (cpus.empty()) {
+        cpus.push_back(0);
+    }
+    EXPECT_NO_THROW(ifacemgr->setReceiverCpuAffinity(cpus));
+    EXPECT_EQ(cpus, ifacemgr->getReceiverCpuAffinity());
+
+    // The affinity can't be changed while the receiver is running.
+    data::ElementPtr queue_control =
+        makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, true);
+    queue_control->set("receiver-threads", data::Element::create(2));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    ASSERT_NO_THROW(ifacemgr->startDHCPReceiver(AF_INET));
+    ASSERT_TRUE(ifacemgr->isDHCPReceiverRunning());
+    EXPECT_THROW(ifacemgr->setReceiverCpuAffinity(util::CpuList()),
+                 InvalidOperation);
+    ASSERT_NO_THROW(ifacemgr->stopDHCPReceiver());
+
+    EXPECT_NO_THROW(ifacemgr->setReceiverCpuAffinity(util::CpuList()));
+    EXPECT_TRUE(ifacemgr->getReceiverCpuAffinity().empty());
+}
+
 // Verifies DHCPv6 behavior of configureDHCPPacketQueue()
 TEST_F(IfaceMgrTest, configureDHCPPacketQueueTest6) {
     scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
@@ -542,6 +542,43 @@ TEST_F(LibDhcpTest, unpackOptions6) {
     EXPECT_TRUE(x == options.end()); // option 32000 not found */
 }
 
+// Check that the options are parsed in place from a range of a buffer.
+TEST_F(LibDhcpTest, unpackOptions6Range) {
+    // Surround the options with bytes which must not be parsed.
+    OptionBuffer buf(3, 0xff);
+    buf.insert(buf.end(), v6packed, v6packed + sizeof(v6packed));
+    buf.insert(buf.end(), 5, 0xff);
+
+    isc::dhcp::OptionCollection options;
+    size_t offset = 0;
+    ASSERT_NO_THROW(offset = LibDHCP::unpackOptions6(buf.begin() + 3,
+                                                     buf.begin() + 3 + sizeof(v6packed),
+                                                     DHCP6_OPTION_SPACE, options));
+    EXPECT_EQ(sizeof(v6packed), offset);
+    ASSERT_EQ(6, options.size());
+
+    isc::dhcp::OptionCollection::const_iterator x = options.find(1);
+    ASSERT_FALSE(x == options.end());
+    ASSERT_EQ(5, x->second->getData().size());
+    EXPECT_EQ(0, memcmp(&x->second->getData()[0], v6packed + 4, 5));
+
+    // The relay-msg option is located relative to the range.
+    const uint8_t relay_msg[] = { 0, D6O_RELAY_MSG, 0, 2, 1, 2 };
+    buf.insert(buf.begin() + 3 + sizeof(v6packed), relay_msg,
+               relay_msg + sizeof(relay_msg));
+    options.clear();
+    size_t relay_msg_offset = 0;
+    size_t relay_msg_len = 0;
+    ASSERT_NO_THROW(LibDHCP::unpackOptions6(buf.begin() + 3,
+                                            buf.begin() + 3 + sizeof(v6packed) +
+                                            sizeof(relay_msg),
+                                            DHCP6_OPTION_SPACE, options,
+                                            &relay_msg_offset, &relay_msg_len));
+    EXPECT_EQ(6, options.size());
+    EXPECT_EQ(sizeof(v6packed) + 4, relay_msg_offset);
+    EXPECT_EQ(2, relay_msg_len);
+}
+
 // Check parsing of an empty DHCPv6 option.
 TEST_F(LibDhcpTest, unpackEmptyOption6) {
     // Create option definition for the option code 1024 without fields.
@@ -1081,6 +1118,35 @@ TEST_F(LibDhcpTest, fuseLongOptionWithLongSuboption) {
     }
 }
 
+// This test verifies that fuse options for v4 leaves the options with
+// a unique code as they are and still fuses their suboptions.
+TEST_F(LibDhcpTest, fuseUniqueOptions) {
+    OptionCollection col;
+
+    OptionPtr opt1(new Option(Option::V4, 1, OptionBuffer(4, 1)));
+    OptionPtr opt2(new Option(Option::V4, 2, OptionBuffer(4, 2)));
+    col.insert(std::make_pair(1, opt1));
+    col.insert(std::make_pair(2, opt2));
+
+    // Nothing to fuse: the same instances are kept.
+    EXPECT_FALSE(LibDHCP::fuseOptions4(col));
+    ASSERT_EQ(2, col.size());
+    EXPECT_EQ(opt1, col.find(1)->second);
+    EXPECT_EQ(opt2, col.find(2)->second);
+
+    // The suboptions of a unique option are fused.
+    OptionPtr sub1(new Option(Option::V4, 5, OptionBuffer(2, 5)));
+    OptionPtr sub2(new Option(Option::V4, 5, OptionBuffer(3, 6)));
+    opt2->addOption(sub1);
+    opt2->addOption(sub2);
+    EXPECT_TRUE(LibDHCP::fuseOptions4(col));
+    ASSERT_EQ(2, col.size());
+    EXPECT_EQ(opt2, col.find(2)->second);
+    ASSERT_EQ(1, opt2->getOptions().size());
+    OptionBuffer expected = { 5, 5, 6, 6, 6 };
+    EXPECT_EQ(expected, opt2->getOptions().begin()->second->getData());
+}
+
 // This test checks that the server can receive multiple vendor options
 // (code 124) with some using the same enterprise ID and some using a different
 // enterprise ID. It should also be able to extend one option which contains
@@ -1508,6 +1574,60 @@ TEST_F(LibDhcpTest, unpackEmptyOption4) {
     EXPECT_EQ(2, option_empty->len());
 }
 
+// Check that the code tables follow the runtime option definitions.
+TEST_F(LibDhcpTest, optionDefCodeTables) {
+    OptionDefCodeTablePtr table4 = LibDHCP::getOptionDefCodeTable(DHCP4_OPTION_SPACE);
+    ASSERT_TRUE(table4);
+    EXPECT_EQ(256, table4->size());
+    OptionDefCodeTablePtr table6 = LibDHCP::getOptionDefCodeTable(DHCP6_OPTION_SPACE);
+    ASSERT_TRUE(table6);
+    EXPECT_FALSE(LibDHCP::getOptionDefCodeTable("foobar"));
+
+    // Standard definitions are found by code.
+    OptionDefinitionPtr def;
+    size_t count = 0;
+    ASSERT_TRUE(table4->find(DHO_SUBNET_MASK, def, count));
+    EXPECT_EQ(1, count);
+    ASSERT_TRUE(def);
+    EXPECT_EQ("subnet-mask", def->getName());
+    ASSERT_TRUE(table6->find(D6O_CLIENTID, def, count));
+    EXPECT_EQ(1, count);
+    ASSERT_TRUE(def);
+    EXPECT_EQ("client-id", def->getName());
+    EXPECT_EQ(LibDHCP::getOptionDef(DHCP6_OPTION_SPACE, D6O_CLIENTID), def);
+
+    // Codes without definitions are indexed too.
+    ASSERT_TRUE(table4->find(254, def, count));
+    EXPECT_EQ(0, count);
+    EXPECT_FALSE(def);
+
+    // Runtime definitions are added to a new table.
+    OptionDefinitionPtr opt_def(new OptionDefinition("option-empty", 254,
+                                                     DHCP4_OPTION_SPACE,
+                                                     "empty", false));
+    OptionDefSpaceContainer defs;
+    defs.addItem(opt_def);
+    LibDHCP::setRuntimeOptionDefs(defs);
+    OptionDefCodeTablePtr staged4 = LibDHCP::getOptionDefCodeTable(DHCP4_OPTION_SPACE);
+    ASSERT_TRUE(staged4);
+    EXPECT_NE(table4, staged4);
+    ASSERT_TRUE(staged4->find(254, def, count));
+    EXPECT_EQ(1, count);
+    ASSERT_TRUE(def);
+    EXPECT_EQ("option-empty", def->getName());
+    EXPECT_EQ(def, LibDHCP::getRuntimeOptionDef(DHCP4_OPTION_SPACE, 254));
+
+    // The previous table is unchanged.
+    ASSERT_TRUE(table4->find(254, def, count));
+    EXPECT_EQ(0, count);
+
+    // Reverting removes the runtime definitions.
+    LibDHCP::revertRuntimeOptionDefs();
+    ASSERT_TRUE(LibDHCP::getOptionDefCodeTable(DHCP4_OPTION_SPACE)->find(254, def, count));
+    EXPECT_EQ(0, count);
+    EXPECT_FALSE(LibDHCP::getRuntimeOptionDef(DHCP4_OPTION_SPACE, 254));
+}
+
 // This test verifies that the following option structure can be parsed:
 // - option (option space 'foobar')
 //   - sub option (option space 'foo')
@@ -2750,6 +2870,41 @@ TEST_F(LibDhcpTest, getVendorOptionDefByName4) {
     }
 }
 
+// This test checks that the vendor option definitions are indexed
+// by vendor id and match the definitions of the vendor option spaces.
+TEST_F(LibDhcpTest, getVendorOptionDefs) {
+    EXPECT_EQ(LibDHCP::getOptionDefs(DOCSIS3_V4_OPTION_SPACE),
+              LibDHCP::getVendorOptionDefs(Option::V4, VENDOR_ID_CABLE_LABS));
+    EXPECT_EQ(LibDHCP::getOptionDefs(DOCSIS3_V6_OPTION_SPACE),
+              LibDHCP::getVendorOptionDefs(Option::V6, VENDOR_ID_CABLE_LABS));
+    EXPECT_EQ(LibDHCP::getOptionDefs(ISC_V6_OPTION_SPACE),
+              LibDHCP::getVendorOptionDefs(Option::V6, ENTERPRISE_ID_ISC));
+
+    // Unknown vendors have no definitions.
+    OptionDefContainerPtr defs =
+        LibDHCP::getVendorOptionDefs(Option::V4, ENTERPRISE_ID_ISC);
+    ASSERT_TRUE(defs);
+    EXPECT_TRUE(defs->empty());
+    defs = LibDHCP::getVendorOptionDefs(Option::V6, 1234);
+    ASSERT_TRUE(defs);
+    EXPECT_TRUE(defs->empty());
+}
+
+// This test checks the conversion of vendor option space names to
+// vendor ids.
+TEST_F(LibDhcpTest, optionSpaceToVendorId) {
+    EXPECT_EQ(4491, LibDHCP::optionSpaceToVendorId("vendor-4491"));
+    EXPECT_EQ(1, LibDHCP::optionSpaceToVendorId("vendor-1"));
+    EXPECT_EQ(4294967295u, LibDHCP::optionSpaceToVendorId("vendor-4294967295"));
+    EXPECT_EQ(0, LibDHCP::optionSpaceToVendorId("vendor-4294967296"));
+    EXPECT_EQ(0, LibDHCP::optionSpaceToVendorId("vendor-"));
+    EXPECT_EQ(0, LibDHCP::optionSpaceToVendorId("vendor-a"));
+    EXPECT_EQ(0, LibDHCP::optionSpaceToVendorId("vendor-12a"));
+    EXPECT_EQ(0, LibDHCP::optionSpaceToVendorId("vendor--1"));
+    EXPECT_EQ(0, LibDHCP::optionSpaceToVendorId("vendors-1"));
+    EXPECT_EQ(0, LibDHCP::optionSpaceToVendorId(DHCP4_OPTION_SPACE));
+}
+
 // This test checks handling of uncompressed FQDN list.
 TEST_F(LibDhcpTest, fqdnList) {
     OptionDefinitionPtr def = LibDHCP::getOptionDef(DHCP4_OPTION_SPACE,
@@ -18,6 +18,7 @@
 #include <dhcp/option_int.h>
 #include <dhcp/option_int_array.h>
 #include <dhcp/option_string.h>
+#include <dhcp/option_vendor.h>
 #include <dhcp/option_opaque_data_tuples.h>
 #include <exceptions/exceptions.h>
 
@@ -1068,6 +1069,52 @@ TEST_F(OptionDefinitionTest, uint8) {
     // @todo Add more cases for DHCPv4
 }
 
+// The purpose of this test is to verify that the specialized classes are
+// only used for the options of the standard option spaces.
+TEST_F(OptionDefinitionTest, specialFormat) {
+    OptionBuffer buf(1, 1);
+    OptionPtr option;
+
+    // Option 125 in the standard option space is a vendor option.
+    OptionDefinition vivso_def("vivso-suboptions", DHO_VIVSO_SUBOPTIONS,
+                               DHCP4_OPTION_SPACE, "uint32");
+    OptionBuffer vivso_buf(5, 0);
+    ASSERT_NO_THROW(option = vivso_def.optionFactory(Option::V4,
+                                                     DHO_VIVSO_SUBOPTIONS,
+                                                     vivso_buf));
+    ASSERT_TRUE(option);
+    const Option* optptr = option.get();
+    EXPECT_TRUE(typeid(*optptr) == typeid(OptionVendor));
+
+    // The same option code in another option space is not.
+    OptionDefinition uint8_def("foo", DHO_VIVSO_SUBOPTIONS, "isc", "uint8");
+    ASSERT_NO_THROW(option = uint8_def.optionFactory(Option::V4,
+                                                     DHO_VIVSO_SUBOPTIONS,
+                                                     buf));
+    ASSERT_TRUE(option);
+    optptr = option.get();
+    ASSERT_TRUE(typeid(*optptr) == typeid(OptionInt<uint8_t>));
+    EXPECT_EQ(1, boost::static_pointer_cast<OptionInt<uint8_t> >(option)->getValue());
+
+    // Nor is another option code in the standard option space.
+    OptionDefinition ttl_def("default-ip-ttl", DHO_DEFAULT_IP_TTL,
+                             DHCP4_OPTION_SPACE, "uint8");
+    ASSERT_NO_THROW(option = ttl_def.optionFactory(Option::V4,
+                                                   DHO_DEFAULT_IP_TTL, buf));
+    ASSERT_TRUE(option);
+    optptr = option.get();
+    EXPECT_TRUE(typeid(*optptr) == typeid(OptionInt<uint8_t>));
+
+    // A copy of a definition keeps its format.
+    OptionDefinition vivso_copy(vivso_def);
+    ASSERT_NO_THROW(option = vivso_copy.optionFactory(Option::V4,
+                                                      DHO_VIVSO_SUBOPTIONS,
+                                                      vivso_buf));
+    ASSERT_TRUE(option);
+    optptr = option.get();
+    EXPECT_TRUE(typeid(*optptr) == typeid(OptionVendor));
+}
+
 // The purpose of this test is to verify that definition for option that
 // comprises single uint8 value can be created and that this definition
 // can be used to create an option with single uint8 value.
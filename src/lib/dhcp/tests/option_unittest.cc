@@ -648,4 +648,45 @@ TEST_F(OptionTest, optionsCannotContainThemselves) {
         "  type=124, len=002: cc:dd");
 }
 
+// Verifies that the option collection keeps the multimap semantics
+// whatever its implementation is.
+TEST(OptionCollectionTest, multimapSemantics) {
+    OptionCollection col;
+    std::vector<OptionPtr> opts;
+    for (uint16_t code : { 5, 3, 5, 1, 5, 3 }) {
+        opts.push_back(OptionPtr(new Option(Option::V4, code)));
+        col.insert(std::make_pair(code, opts.back()));
+    }
+    ASSERT_EQ(6, col.size());
+
+    // The options are sorted by code.
+    std::vector<unsigned int> codes;
+    for (auto const& it : col) {
+        codes.push_back(it.first);
+    }
+    std::vector<unsigned int> expected = { 1, 3, 3, 5, 5, 5 };
+    EXPECT_EQ(expected, codes);
+
+    // The options with the same code are kept in the insertion order.
+    auto range = col.equal_range(5);
+    ASSERT_EQ(3, std::distance(range.first, range.second));
+    EXPECT_EQ(opts[0], range.first->second);
+    EXPECT_EQ(opts[2], (++range.first)->second);
+    EXPECT_EQ(opts[4], (++range.first)->second);
+
+    // The hinted insertion keeps the order too.
+    OptionPtr last(new Option(Option::V4, 3));
+    col.insert(col.end(), std::make_pair(3, last));
+    range = col.equal_range(3);
+    ASSERT_EQ(3, std::distance(range.first, range.second));
+    EXPECT_EQ(opts[1], range.first->second);
+    EXPECT_EQ(last, (--range.second)->second);
+
+    // Find returns the first option and erase removes all of them.
+    EXPECT_EQ(opts[0], col.find(5)->second);
+    EXPECT_EQ(3, col.erase(5));
+    EXPECT_TRUE(col.find(5) == col.end());
+    EXPECT_EQ(4, col.size());
+}
+
 }
@@ -263,6 +263,42 @@ TEST(TestQueue4, shouldDropPacketTest) {
     ASSERT_FALSE(pkt);
 }
 
+// Verifies that a batch of packets is enqueued in order and that the
+// drop logic is applied to each packet of the batch.
+TEST(TestQueue4, enqueuePacketsTest) {
+    TestQueue4 q(100);
+    EXPECT_TRUE(q.empty());
+
+    SocketInfo sock_odd(isc::asiolink::IOAddress("127.0.0.1"), 777, 11);
+
+    std::vector<Pkt4Ptr> pkts;
+    for (uint32_t transid = 1000; transid < 1006; ++transid) {
+        pkts.push_back(Pkt4Ptr(new Pkt4(DHCPDISCOVER, transid)));
+    }
+
+    // Drop is not enabled so all packets are added.
+    ASSERT_NO_THROW(q.enqueuePackets(pkts, sock_odd));
+    ASSERT_EQ(6, q.getSize());
+    q.clear();
+
+    // Enable drop logic: only the odd transids are added.
+    q.drop_enabled_ = true;
+    ASSERT_NO_THROW(q.enqueuePackets(pkts, sock_odd));
+    ASSERT_EQ(3, q.getSize());
+
+    Pkt4Ptr pkt;
+    for (uint32_t transid = 1001; transid < 1006; transid += 2) {
+        ASSERT_NO_THROW(pkt = q.dequeuePacket());
+        ASSERT_TRUE(pkt);
+        EXPECT_EQ(transid, pkt->getTransid());
+    }
+    EXPECT_TRUE(q.empty());
+
+    // An empty batch is fine.
+    ASSERT_NO_THROW(q.enqueuePackets(std::vector<Pkt4Ptr>(), sock_odd));
+    EXPECT_TRUE(q.empty());
+}
+
 // Verifies dequeuing operations when eat packets is enabled.
 // This accesses it's queue instance as a TestQueue4, rather than
 // a PacketQueue4Ptr, to provide access to TestQueue4 specifics.
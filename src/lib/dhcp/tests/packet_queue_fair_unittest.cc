@@ -0,0 +1,213 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcp/dhcp6.h>
+#include <dhcp/packet_queue_fair.h>
+#include <dhcp/packet_queue_mgr4.h>
+#include <dhcp/packet_queue_mgr6.h>
+#include <dhcp/tests/packet_queue_testutils.h>
+#include <exceptions/exceptions.h>
+
+#include <boost/shared_ptr.hpp>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::dhcp::test;
+
+namespace {
+
+/// @brief Returns a received DHCPv4 packet, i.e. not yet unpacked.
+///
+/// @param transid the transaction id
+/// @param giaddr the relay agent address
+/// @param iface the name of the interface
+Pkt4Ptr makePacket4(uint32_t transid, const string& giaddr,
+                    const string& iface = "eth0") {
+    Pkt4 pkt(DHCPDISCOVER, transid);
+    pkt.setGiaddr(IOAddress(giaddr));
+    pkt.pack();
+    const uint8_t* data = static_cast<const uint8_t*>(pkt.getBuffer().getData());
+    Pkt4Ptr received(new Pkt4(data, pkt.getBuffer().getLength()));
+    received->setIface(iface);
+    return (received);
+}
+
+/// @brief Returns the transaction id of a received packet.
+///
+/// @param pkt the packet
+uint32_t getTransid(const Pkt4Ptr& pkt) {
+    pkt->unpack();
+    return (pkt->getTransid());
+}
+
+/// @brief The socket the packets come from.
+const SocketInfo sock(IOAddress("127.0.0.1"), 777, 10);
+
+// Verifies the ingress of the DHCPv4 packets.
+TEST(PacketQueueFair4, ingress) {
+    PacketQueueFair4 q("kea-fair4", 100);
+    EXPECT_EQ("192.0.2.1", q.getIngress(makePacket4(1, "192.0.2.1")));
+    EXPECT_EQ("eth1", q.getIngress(makePacket4(1, "0.0.0.0", "eth1")));
+    EXPECT_EQ("", q.getIngress(Pkt4Ptr()));
+}
+
+// Verifies the ingress of the DHCPv6 packets.
+TEST(PacketQueueFair6, ingress) {
+    PacketQueueFair6 q("kea-fair6", 100);
+    vector<uint8_t> data(40, 0);
+    data[0] = DHCPV6_RELAY_FORW;
+    Pkt6Ptr relayed(new Pkt6(&data[0], data.size()));
+    relayed->setRemoteAddr(IOAddress("2001:db8::1"));
+    relayed->setIface("eth0");
+    EXPECT_EQ("2001:db8::1", q.getIngress(relayed));
+
+    data[0] = DHCPV6_SOLICIT;
+    Pkt6Ptr direct(new Pkt6(&data[0], data.size()));
+    direct->setRemoteAddr(IOAddress("fe80::1"));
+    direct->setIface("eth1");
+    EXPECT_EQ("eth1", q.getIngress(direct));
+}
+
+// Verifies the construction and the parameters.
+TEST(PacketQueueFair4, basics) {
+    EXPECT_THROW(PacketQueueFair4("kea-fair4", 4), BadValue);
+
+    PacketQueueFair4 q("kea-fair4", 100);
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(100, q.getCapacity());
+    EXPECT_EQ(100, q.getIngressCapacity());
+    EXPECT_EQ(1, q.getQuantum());
+    EXPECT_THROW(q.setIngressCapacity(0), BadValue);
+    EXPECT_THROW(q.setQuantum(0), BadValue);
+    EXPECT_NO_THROW(q.setIngressCapacity(10));
+    EXPECT_NO_THROW(q.setQuantum(2));
+
+    ASSERT_NO_THROW(q.enqueuePacket(makePacket4(1, "192.0.2.1"), sock));
+    CHECK_QUEUE_INFO(&q, "{ \"capacity\": 100, \"queue-type\": \"kea-fair4\","
+                     " \"size\": 1, \"ingress-capacity\": 10, \"quantum\": 2,"
+                     " \"ingresses\": { \"192.0.2.1\": { \"size\": 1,"
+                     " \"drops\": 0 } } }");
+    q.clear();
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(0, q.getSize("192.0.2.1"));
+    EXPECT_FALSE(q.dequeuePacket());
+}
+
+// Verifies the deficit round robin dequeue order.
+TEST(PacketQueueFair4, roundRobin) {
+    PacketQueueFair4 q("kea-fair4", 100);
+    q.setQuantum(2);
+
+    // A flooding relay queues 10 packets before two other relays.
+    vector<Pkt4Ptr> flood;
+    for (uint32_t i = 0; i < 10; ++i) {
+        flood.push_back(makePacket4(100 + i, "192.0.2.1"));
+    }
+    ASSERT_NO_THROW(q.enqueuePackets(flood, sock));
+    ASSERT_NO_THROW(q.enqueuePacket(makePacket4(200, "192.0.2.2"), sock));
+    ASSERT_NO_THROW(q.enqueuePacket(makePacket4(300, "0.0.0.0"), sock));
+    ASSERT_NO_THROW(q.enqueuePacket(makePacket4(301, "0.0.0.0"), sock));
+    ASSERT_NO_THROW(q.enqueuePacket(makePacket4(302, "0.0.0.0"), sock));
+    EXPECT_EQ(14, q.getSize());
+    EXPECT_EQ(10, q.getSize("192.0.2.1"));
+    EXPECT_EQ(3, q.getSize("eth0"));
+
+    // Each ingress dequeues up to 2 packets per round.
+    const uint32_t expected[] = { 100, 101, 200, 300, 301, 102, 103, 302,
+                                  104, 105, 106, 107, 108, 109 };
+    for (auto transid : expected) {
+        Pkt4Ptr pkt = q.dequeuePacket();
+        ASSERT_TRUE(pkt);
+        EXPECT_EQ(transid, getTransid(pkt));
+    }
+    EXPECT_EQ(0, q.getSize());
+    EXPECT_TRUE(q.empty());
+}
+
+// Verifies the drops of the ingress capacity and the queue capacity.
+TEST(PacketQueueFair4, overflow) {
+    PacketQueueFair4 q("kea-fair4", 10);
+    q.setIngressCapacity(6);
+
+    // The flooding relay is limited to 6 packets.
+    for (uint32_t i = 0; i < 8; ++i) {
+        ASSERT_NO_THROW(q.enqueuePacket(makePacket4(100 + i, "192.0.2.1"), sock));
+    }
+    EXPECT_EQ(6, q.getSize("192.0.2.1"));
+    EXPECT_EQ(2, q.getDropCount("192.0.2.1"));
+
+    // The other relays fill the queue.
+    for (uint32_t i = 0; i < 4; ++i) {
+        ASSERT_NO_THROW(q.enqueuePacket(makePacket4(200 + i, "192.0.2.2"), sock));
+    }
+    EXPECT_EQ(10, q.getSize());
+
+    // The queue is full: the oldest packets of the longest sub-queue
+    // make room for the new packets.
+    ASSERT_NO_THROW(q.enqueuePacket(makePacket4(300, "192.0.2.3"), sock));
+    ASSERT_NO_THROW(q.enqueuePacket(makePacket4(204, "192.0.2.2"), sock));
+    EXPECT_EQ(10, q.getSize());
+    EXPECT_EQ(4, q.getSize("192.0.2.1"));
+    EXPECT_EQ(4, q.getDropCount("192.0.2.1"));
+    EXPECT_EQ(5, q.getSize("192.0.2.2"));
+    EXPECT_EQ(1, q.getSize("192.0.2.3"));
+
+    // The new packet is dropped when its sub-queue is the longest.
+    ASSERT_NO_THROW(q.enqueuePacket(makePacket4(205, "192.0.2.2"), sock));
+    EXPECT_EQ(5, q.getSize("192.0.2.2"));
+    EXPECT_EQ(1, q.getDropCount("192.0.2.2"));
+
+    Pkt4Ptr pkt = q.dequeuePacket();
+    ASSERT_TRUE(pkt);
+    EXPECT_EQ(102, getTransid(pkt));
+}
+
+// Verifies the creation of the DHCPv4 queues by the manager.
+TEST(PacketQueueFair4, factory) {
+    PacketQueueMgr4 mgr;
+    ElementPtr config = makeQueueConfig(PacketQueueMgr4::FAIR_QUEUE_TYPE4, 500);
+    config->set("ingress-capacity", Element::create(50));
+    config->set("quantum", Element::create(4));
+    ASSERT_NO_THROW(mgr.createPacketQueue(config));
+    PacketQueue4Ptr queue = mgr.getPacketQueue();
+    ASSERT_TRUE(queue);
+    checkIntStat(queue, "capacity", 500);
+    checkIntStat(queue, "ingress-capacity", 50);
+    checkIntStat(queue, "quantum", 4);
+
+    // Invalid parameters.
+    config->set("quantum", Element::create(0));
+    EXPECT_THROW(mgr.createPacketQueue(config), InvalidQueueParameter);
+    config->set("quantum", Element::create(4));
+    config->set("ingress-capacity", Element::create(501));
+    EXPECT_THROW(mgr.createPacketQueue(config), InvalidQueueParameter);
+    config = makeQueueConfig(PacketQueueMgr4::FAIR_QUEUE_TYPE4, 2);
+    EXPECT_THROW(mgr.createPacketQueue(config), InvalidQueueParameter);
+}
+
+// Verifies the creation of the DHCPv6 queues by the manager.
+TEST(PacketQueueFair6, factory) {
+    PacketQueueMgr6 mgr;
+    ElementPtr config = makeQueueConfig(PacketQueueMgr6::FAIR_QUEUE_TYPE6, 500);
+    config->set("ingress-capacity", Element::create(50));
+    ASSERT_NO_THROW(mgr.createPacketQueue(config));
+    PacketQueue6Ptr queue = mgr.getPacketQueue();
+    ASSERT_TRUE(queue);
+    checkIntStat(queue, "capacity", 500);
+    checkIntStat(queue, "ingress-capacity", 50);
+    checkIntStat(queue, "quantum", 1);
+
+    config->set("ingress-capacity", Element::create(0));
+    EXPECT_THROW(mgr.createPacketQueue(config), InvalidQueueParameter);
+}
+
+} // end of anonymous namespace
@@ -0,0 +1,311 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcp/packet_queue_priority.h>
+#include <dhcp/packet_queue_mgr4.h>
+#include <dhcp/tests/packet_queue_testutils.h>
+#include <exceptions/exceptions.h>
+
+#include <boost/shared_ptr.hpp>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::dhcp::test;
+
+namespace {
+
+/// @brief Priority queue with a test clock.
+class TestQueuePriority4 : public PacketQueuePriority4 {
+public:
+    /// @brief Constructor
+    ///
+    /// @param capacity maximum number of packets the queue can hold
+    TestQueuePriority4(size_t capacity)
+        : PacketQueuePriority4("kea-priority4", capacity), time_() {
+    }
+
+    /// @brief Advances the test clock.
+    ///
+    /// @param ms the number of milliseconds
+    void advance(uint32_t ms) {
+        time_ += chrono::milliseconds(ms);
+    }
+
+protected:
+    /// @brief Returns the test clock.
+    virtual Clock::time_point now() const {
+        return (time_);
+    }
+
+private:
+    /// @brief The test clock.
+    Clock::time_point time_;
+};
+
+/// @brief Returns a received packet, i.e. not yet unpacked.
+///
+/// @param type the message type
+/// @param transid the transaction id
+/// @param ciaddr the client address
+Pkt4Ptr makePacket(uint8_t type, uint32_t transid,
+                   const string& ciaddr = "0.0.0.0") {
+    Pkt4 pkt(type, transid);
+    pkt.setCiaddr(IOAddress(ciaddr));
+    pkt.pack();
+    const uint8_t* data = static_cast<const uint8_t*>(pkt.getBuffer().getData());
+    return (Pkt4Ptr(new Pkt4(data, pkt.getBuffer().getLength())));
+}
+
+/// @brief Returns the transaction id of a received packet.
+///
+/// @param pkt the packet
+uint32_t getTransid(const Pkt4Ptr& pkt) {
+    pkt->unpack();
+    return (pkt->getTransid());
+}
+
+/// @brief The socket the packets come from.
+const SocketInfo sock(IOAddress("127.0.0.1"), 777, 10);
+
+// Verifies the classification of the packets.
+TEST(PacketQueuePriority4, classify) {
+    EXPECT_EQ(PacketQueuePriority4::DISCOVER,
+              PacketQueuePriority4::classify(makePacket(DHCPDISCOVER, 1)));
+    EXPECT_EQ(PacketQueuePriority4::REQUEST,
+              PacketQueuePriority4::classify(makePacket(DHCPREQUEST, 1)));
+    EXPECT_EQ(PacketQueuePriority4::RENEW,
+              PacketQueuePriority4::classify(makePacket(DHCPREQUEST, 1,
+                                                        "192.0.2.1")));
+    EXPECT_EQ(PacketQueuePriority4::OTHER,
+              PacketQueuePriority4::classify(makePacket(DHCPRELEASE, 1,
+                                                        "192.0.2.1")));
+    EXPECT_EQ(PacketQueuePriority4::OTHER,
+              PacketQueuePriority4::classify(makePacket(DHCPINFORM, 1)));
+
+    // BOOTP packet i.e. without the magic cookie.
+    const vector<uint8_t> bootp(300, 0);
+    EXPECT_EQ(PacketQueuePriority4::OTHER,
+              PacketQueuePriority4::classify(Pkt4Ptr(new Pkt4(&bootp[0], bootp.size()))));
+    EXPECT_EQ(PacketQueuePriority4::OTHER,
+              PacketQueuePriority4::classify(Pkt4Ptr()));
+}
+
+// Verifies the construction and the parameters.
+TEST(PacketQueuePriority4, basics) {
+    EXPECT_THROW(PacketQueuePriority4("kea-priority4", 4), BadValue);
+
+    PacketQueuePriority4 q("kea-priority4", 100);
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(100, q.getCapacity());
+    EXPECT_EQ(8, q.getWeight(PacketQueuePriority4::RENEW));
+    EXPECT_EQ(4, q.getWeight(PacketQueuePriority4::REQUEST));
+    EXPECT_EQ(2, q.getWeight(PacketQueuePriority4::OTHER));
+    EXPECT_EQ(1, q.getWeight(PacketQueuePriority4::DISCOVER));
+    EXPECT_EQ(PacketQueuePriority4::DEFAULT_TARGET_DELAY, q.getTargetDelay());
+    EXPECT_EQ(PacketQueuePriority4::DEFAULT_INTERVAL, q.getInterval());
+
+    EXPECT_THROW(q.setWeight(PacketQueuePriority4::RENEW, 0), BadValue);
+    EXPECT_THROW(q.setWeight(PacketQueuePriority4::CLASS_COUNT, 1), BadValue);
+    EXPECT_THROW(q.setInterval(0), BadValue);
+    EXPECT_NO_THROW(q.setWeight(PacketQueuePriority4::DISCOVER, 3));
+    EXPECT_NO_THROW(q.setTargetDelay(0));
+    EXPECT_NO_THROW(q.setInterval(100));
+
+    CHECK_QUEUE_INFO(&q, "{ \"capacity\": 100, \"queue-type\": \"kea-priority4\","
+                     " \"size\": 0, \"target-delay\": 0, \"interval\": 100,"
+                     " \"sizes\": { \"renew\": 0, \"request\": 0, \"other\": 0,"
+                     " \"discover\": 0 },"
+                     " \"weights\": { \"renew\": 8, \"request\": 4, \"other\": 2,"
+                     " \"discover\": 3 },"
+                     " \"drops\": { \"overflow\": { \"renew\": 0, \"request\": 0,"
+                     " \"other\": 0, \"discover\": 0 },"
+                     " \"sojourn\": { \"renew\": 0, \"request\": 0,"
+                     " \"other\": 0, \"discover\": 0 } } }");
+}
+
+// Verifies the weighted round robin dequeue order.
+TEST(PacketQueuePriority4, weightedDequeue) {
+    TestQueuePriority4 q(100);
+    q.setTargetDelay(0);
+    q.setWeight(PacketQueuePriority4::RENEW, 2);
+    q.setWeight(PacketQueuePriority4::REQUEST, 1);
+    q.setWeight(PacketQueuePriority4::DISCOVER, 1);
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        q.enqueuePacket(makePacket(DHCPDISCOVER, 100 + i), sock);
+        q.enqueuePacket(makePacket(DHCPREQUEST, 200 + i), sock);
+        q.enqueuePacket(makePacket(DHCPREQUEST, 300 + i, "192.0.2.1"), sock);
+    }
+    EXPECT_EQ(12, q.getSize());
+    EXPECT_EQ(4, q.getSize(PacketQueuePriority4::RENEW));
+    EXPECT_EQ(4, q.getSize(PacketQueuePriority4::REQUEST));
+    EXPECT_EQ(4, q.getSize(PacketQueuePriority4::DISCOVER));
+
+    const vector<uint32_t> expected = {
+        300, 301, 200, 100, 302, 303, 201, 101, 202, 102, 203, 103
+    };
+    for (auto transid : expected) {
+        Pkt4Ptr pkt = q.dequeuePacket();
+        ASSERT_TRUE(pkt);
+        EXPECT_EQ(transid, getTransid(pkt));
+    }
+    EXPECT_TRUE(q.empty());
+    EXPECT_FALSE(q.dequeuePacket());
+}
+
+// Verifies that the least important packets are dropped when the queue
+// is full.
+TEST(PacketQueuePriority4, overflow) {
+    TestQueuePriority4 q(5);
+    q.setTargetDelay(0);
+
+    vector<Pkt4Ptr> packets;
+    for (uint32_t i = 0; i < 5; ++i) {
+        packets.push_back(makePacket(DHCPDISCOVER, 100 + i));
+    }
+    q.enqueuePackets(packets, sock);
+    EXPECT_EQ(5, q.getSize());
+
+    // A renew replaces the oldest discover.
+    q.enqueuePacket(makePacket(DHCPREQUEST, 200, "192.0.2.1"), sock);
+    EXPECT_EQ(5, q.getSize());
+    EXPECT_EQ(1, q.getSize(PacketQueuePriority4::RENEW));
+    EXPECT_EQ(4, q.getSize(PacketQueuePriority4::DISCOVER));
+    EXPECT_EQ(1, q.getDropCount(PacketQueuePriority4::DISCOVER,
+                                PacketQueuePriority4::DROP_OVERFLOW));
+
+    // A discover replaces the oldest discover too.
+    q.enqueuePacket(makePacket(DHCPDISCOVER, 105), sock);
+    EXPECT_EQ(2, q.getDropCount(PacketQueuePriority4::DISCOVER,
+                                PacketQueuePriority4::DROP_OVERFLOW));
+
+    // Fill the queue with renews.
+    for (uint32_t i = 1; i < 5; ++i) {
+        q.enqueuePacket(makePacket(DHCPREQUEST, 200 + i, "192.0.2.1"), sock);
+    }
+    EXPECT_EQ(5, q.getSize(PacketQueuePriority4::RENEW));
+    EXPECT_EQ(6, q.getDropCount(PacketQueuePriority4::DISCOVER,
+                                PacketQueuePriority4::DROP_OVERFLOW));
+
+    // Now a discover is dropped itself.
+    q.enqueuePacket(makePacket(DHCPDISCOVER, 106), sock);
+    EXPECT_EQ(0, q.getSize(PacketQueuePriority4::DISCOVER));
+    EXPECT_EQ(7, q.getDropCount(PacketQueuePriority4::DISCOVER,
+                                PacketQueuePriority4::DROP_OVERFLOW));
+    EXPECT_EQ(0, q.getDropCount(PacketQueuePriority4::RENEW,
+                                PacketQueuePriority4::DROP_OVERFLOW));
+
+    // The oldest renew is dropped by a new renew.
+    q.enqueuePacket(makePacket(DHCPREQUEST, 205, "192.0.2.1"), sock);
+    EXPECT_EQ(1, q.getDropCount(PacketQueuePriority4::RENEW,
+                                PacketQueuePriority4::DROP_OVERFLOW));
+    Pkt4Ptr pkt = q.dequeuePacket();
+    ASSERT_TRUE(pkt);
+    EXPECT_EQ(201, getTransid(pkt));
+
+    q.clear();
+    EXPECT_TRUE(q.empty());
+    checkIntStat(&q, "size", 0);
+}
+
+// Verifies the sojourn time dropping.
+TEST(PacketQueuePriority4, sojourn) {
+    TestQueuePriority4 q(100);
+    q.setTargetDelay(10);
+    q.setInterval(100);
+
+    for (uint32_t i = 0; i < 50; ++i) {
+        q.enqueuePacket(makePacket(DHCPDISCOVER, 100 + i), sock);
+    }
+
+    // Packets below the target delay are not dropped.
+    q.advance(5);
+    Pkt4Ptr pkt = q.dequeuePacket();
+    ASSERT_TRUE(pkt);
+    EXPECT_EQ(100, getTransid(pkt));
+
+    // Going above the target delay starts the interval.
+    q.advance(10);
+    pkt = q.dequeuePacket();
+    ASSERT_TRUE(pkt);
+    EXPECT_EQ(101, getTransid(pkt));
+    pkt = q.dequeuePacket();
+    ASSERT_TRUE(pkt);
+    EXPECT_EQ(102, getTransid(pkt));
+    EXPECT_EQ(0, q.getDropCount(PacketQueuePriority4::DISCOVER,
+                                PacketQueuePriority4::DROP_SOJOURN));
+
+    // After the interval a packet is dropped.
+    q.advance(100);
+    pkt = q.dequeuePacket();
+    ASSERT_TRUE(pkt);
+    EXPECT_EQ(104, getTransid(pkt));
+    EXPECT_EQ(1, q.getDropCount(PacketQueuePriority4::DISCOVER,
+                                PacketQueuePriority4::DROP_SOJOURN));
+
+    // The next drop is after interval / sqrt(count) i.e. 100 ms.
+    q.advance(50);
+    pkt = q.dequeuePacket();
+    ASSERT_TRUE(pkt);
+    EXPECT_EQ(105, getTransid(pkt));
+    EXPECT_EQ(1, q.getDropCount(PacketQueuePriority4::DISCOVER,
+                                PacketQueuePriority4::DROP_SOJOURN));
+    q.advance(50);
+    pkt = q.dequeuePacket();
+    ASSERT_TRUE(pkt);
+    EXPECT_EQ(107, getTransid(pkt));
+    EXPECT_EQ(2, q.getDropCount(PacketQueuePriority4::DISCOVER,
+                                PacketQueuePriority4::DROP_SOJOURN));
+
+    // Fresh packets in another class are not affected.
+    q.enqueuePacket(makePacket(DHCPREQUEST, 200, "192.0.2.1"), sock);
+    pkt = q.dequeuePacket();
+    ASSERT_TRUE(pkt);
+    EXPECT_EQ(200, getTransid(pkt));
+    EXPECT_EQ(0, q.getDropCount(PacketQueuePriority4::RENEW,
+                                PacketQueuePriority4::DROP_SOJOURN));
+}
+
+// Verifies the priority queue factory of the manager.
+TEST(PacketQueuePriority4, factory) {
+    PacketQueueMgr4 mgr;
+    ElementPtr config = makeQueueConfig(PacketQueueMgr4::PRIORITY_QUEUE_TYPE4, 500);
+    config->set("target-delay", Element::create(20));
+    config->set("interval", Element::create(200));
+    config->set("weights", Element::fromJSON("{ \"discover\": 5, \"renew\": 10 }"));
+    ASSERT_NO_THROW(mgr.createPacketQueue(config));
+    PacketQueue4Ptr queue = mgr.getPacketQueue();
+    ASSERT_TRUE(queue);
+    checkIntStat(queue, "capacity", 500);
+    checkIntStat(queue, "target-delay", 20);
+    checkIntStat(queue, "interval", 200);
+    auto priority = boost::dynamic_pointer_cast<PacketQueuePriority4>(queue);
+    ASSERT_TRUE(priority);
+    EXPECT_EQ(10, priority->getWeight(PacketQueuePriority4::RENEW));
+    EXPECT_EQ(4, priority->getWeight(PacketQueuePriority4::REQUEST));
+    EXPECT_EQ(5, priority->getWeight(PacketQueuePriority4::DISCOVER));
+
+    // Invalid parameters.
+    config->set("weights", Element::fromJSON("{ \"foo\": 5 }"));
+    EXPECT_THROW(mgr.createPacketQueue(config), InvalidQueueParameter);
+    config->set("weights", Element::fromJSON("{ \"renew\": 0 }"));
+    EXPECT_THROW(mgr.createPacketQueue(config), InvalidQueueParameter);
+    config->set("weights", Element::fromJSON("[ 1 ]"));
+    EXPECT_THROW(mgr.createPacketQueue(config), InvalidQueueParameter);
+    config->remove("weights");
+    config->set("interval", Element::create(0));
+    EXPECT_THROW(mgr.createPacketQueue(config), InvalidQueueParameter);
+    config = makeQueueConfig(PacketQueueMgr4::PRIORITY_QUEUE_TYPE4, 2);
+    EXPECT_THROW(mgr.createPacketQueue(config), InvalidQueueParameter);
+}
+
+} // end of anonymous namespace
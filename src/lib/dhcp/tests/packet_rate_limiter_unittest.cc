@@ -0,0 +1,301 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcp/dhcp6.h>
+#include <dhcp/option.h>
+#include <dhcp/pkt6.h>
+#include <dhcp/packet_rate_limiter.h>
+#include <exceptions/exceptions.h>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Rate limiter with a test clock.
+class TestPacketRateLimiter : public PacketRateLimiter {
+public:
+    /// @brief Constructor.
+    ///
+    /// @param buckets the number of buckets per row.
+    TestPacketRateLimiter(size_t buckets = DEFAULT_BUCKETS)
+        : PacketRateLimiter(buckets), time_(Clock::time_point() + chrono::hours(1)) {
+    }
+
+    /// @brief Advances the test clock.
+    ///
+    /// @param ms the number of milliseconds.
+    void advance(uint32_t ms) {
+        time_ += chrono::milliseconds(ms);
+    }
+
+protected:
+    /// @brief Returns the test clock.
+    virtual Clock::time_point now() const {
+        return (time_);
+    }
+
+private:
+    /// @brief The test clock.
+    Clock::time_point time_;
+};
+
+/// @brief Returns a received DHCPv4 packet, i.e. not yet unpacked.
+///
+/// @param mac the last byte of the hardware address.
+/// @param giaddr the relay address.
+/// @param relay_id the relay identifier, empty for none.
+Pkt4Ptr makePacket4(uint8_t mac, const string& giaddr = "0.0.0.0",
+                    const vector<uint8_t>& relay_id = vector<uint8_t>()) {
+    Pkt4 pkt(DHCPDISCOVER, 1234);
+    pkt.setHWAddr(HTYPE_ETHER, 6, { 0, 1, 2, 3, 4, mac });
+    pkt.setGiaddr(IOAddress(giaddr));
+    if (!relay_id.empty()) {
+        OptionPtr rai(new Option(Option::V4, DHO_DHCP_AGENT_OPTIONS));
+        rai->addOption(OptionPtr(new Option(Option::V4, RAI_OPTION_RELAY_ID,
+                                            relay_id)));
+        pkt.addOption(rai);
+    }
+    pkt.pack();
+    const uint8_t* data = static_cast<const uint8_t*>(pkt.getBuffer().getData());
+    return (Pkt4Ptr(new Pkt4(data, pkt.getBuffer().getLength())));
+}
+
+/// @brief Returns the raw data of a DHCPv6 client message.
+///
+/// @param duid the client identifier.
+OptionBuffer makeData6(const vector<uint8_t>& duid) {
+    Pkt6 pkt(DHCPV6_SOLICIT, 1234);
+    pkt.addOption(OptionPtr(new Option(Option::V6, D6O_CLIENTID, duid)));
+    pkt.pack();
+    const uint8_t* data = static_cast<const uint8_t*>(pkt.getBuffer().getData());
+    return (OptionBuffer(data, data + pkt.getBuffer().getLength()));
+}
+
+/// @brief Appends a DHCPv6 option to raw data.
+///
+/// @param data the raw data.
+/// @param code the option code.
+/// @param value the option data.
+void appendOption6(OptionBuffer& data, uint16_t code,
+                   const vector<uint8_t>& value) {
+    data.push_back(code >> 8);
+    data.push_back(code & 0xff);
+    data.push_back(value.size() >> 8);
+    data.push_back(value.size() & 0xff);
+    data.insert(data.end(), value.begin(), value.end());
+}
+
+/// @brief Wraps raw DHCPv6 data in a relay forward message.
+///
+/// @param inner the relayed message.
+/// @param relay_id the relay identifier, empty for none.
+OptionBuffer relay6(const OptionBuffer& inner,
+                    const vector<uint8_t>& relay_id = vector<uint8_t>()) {
+    OptionBuffer data(34, 0);
+    data[0] = DHCPV6_RELAY_FORW;
+    if (!relay_id.empty()) {
+        appendOption6(data, D6O_RELAY_ID, relay_id);
+    }
+    appendOption6(data, D6O_RELAY_MSG, inner);
+    return (data);
+}
+
+// Verifies the construction and the limits.
+TEST(PacketRateLimiterTest, basics) {
+    EXPECT_THROW(PacketRateLimiter(0), BadValue);
+
+    PacketRateLimiter limiter(16);
+    EXPECT_EQ(16, limiter.getBuckets());
+    EXPECT_FALSE(limiter.isEnabled());
+    EXPECT_EQ(0, limiter.getRate(PacketRateLimiter::CLIENT));
+    EXPECT_THROW(limiter.setLimit(PacketRateLimiter::CLIENT, 10, 0), BadValue);
+    EXPECT_THROW(limiter.setLimit(PacketRateLimiter::KEY_TYPE_COUNT, 10, 10),
+                 BadValue);
+    EXPECT_NO_THROW(limiter.setLimit(PacketRateLimiter::RELAY, 100, 200));
+    EXPECT_TRUE(limiter.isEnabled());
+    EXPECT_EQ(100, limiter.getRate(PacketRateLimiter::RELAY));
+    EXPECT_EQ(200, limiter.getBurst(PacketRateLimiter::RELAY));
+    EXPECT_EQ("{ \"buckets\": 16, \"client-burst\": 0, \"client-drops\": 0, "
+              "\"client-rate\": 0, \"relay-burst\": 200, \"relay-drops\": 0, "
+              "\"relay-rate\": 100 }", limiter.getInfo()->str());
+}
+
+// Verifies the token bucket behavior of a key.
+TEST(PacketRateLimiterTest, tokenBucket) {
+    TestPacketRateLimiter limiter;
+    limiter.setLimit(PacketRateLimiter::CLIENT, 10, 5);
+    const vector<uint8_t> key = { 1, 2, 3 };
+    const vector<uint8_t> other = { 4, 5, 6 };
+
+    // The burst is accepted, then the packets are dropped.
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(limiter.allowKey(PacketRateLimiter::CLIENT, key));
+    }
+    EXPECT_FALSE(limiter.allowKey(PacketRateLimiter::CLIENT, key));
+    EXPECT_EQ(1, limiter.getDropCount(PacketRateLimiter::CLIENT));
+
+    // Other keys are not affected.
+    EXPECT_TRUE(limiter.allowKey(PacketRateLimiter::CLIENT, other));
+
+    // A token comes back after 100 ms.
+    limiter.advance(100);
+    EXPECT_TRUE(limiter.allowKey(PacketRateLimiter::CLIENT, key));
+    EXPECT_FALSE(limiter.allowKey(PacketRateLimiter::CLIENT, key));
+    EXPECT_EQ(2, limiter.getDropCount(PacketRateLimiter::CLIENT));
+
+    // The bucket does not fill above the burst.
+    limiter.advance(10000);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(limiter.allowKey(PacketRateLimiter::CLIENT, key));
+    }
+    EXPECT_FALSE(limiter.allowKey(PacketRateLimiter::CLIENT, key));
+
+    // Empty keys and disabled limits always pass.
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(limiter.allowKey(PacketRateLimiter::CLIENT, vector<uint8_t>()));
+        EXPECT_TRUE(limiter.allowKey(PacketRateLimiter::RELAY, key));
+    }
+}
+
+// Verifies that the sketch stays accurate with many more keys than
+// buckets when only few keys are over their limit.
+TEST(PacketRateLimiterTest, sketch) {
+    TestPacketRateLimiter limiter(1024);
+    limiter.setLimit(PacketRateLimiter::CLIENT, 1, 2);
+
+    // A flooding key is limited.
+    const vector<uint8_t> flood = { 0xff, 0xff };
+    size_t accepted = 0;
+    for (int i = 0; i < 100; ++i) {
+        if (limiter.allowKey(PacketRateLimiter::CLIENT, flood)) {
+            ++accepted;
+        }
+    }
+    EXPECT_EQ(2, accepted);
+
+    // Well behaving keys sending one packet each are accepted: with two
+    // rows the flooding key shares both its buckets with a few keys only.
+    accepted = 0;
+    for (uint16_t i = 0; i < 512; ++i) {
+        vector<uint8_t> key = { static_cast<uint8_t>(i >> 8),
+                                static_cast<uint8_t>(i & 0xff) };
+        if (limiter.allowKey(PacketRateLimiter::CLIENT, key)) {
+            ++accepted;
+        }
+    }
+    EXPECT_LE(510, accepted);
+}
+
+// Verifies the DHCPv4 keys.
+TEST(PacketRateLimiterTest, keys4) {
+    vector<uint8_t> client;
+    vector<uint8_t> relay;
+    PacketRateLimiter::getKeys4(makePacket4(5)->data_, client, relay);
+    EXPECT_EQ(vector<uint8_t>({ HTYPE_ETHER, 0, 1, 2, 3, 4, 5 }), client);
+    EXPECT_TRUE(relay.empty());
+
+    PacketRateLimiter::getKeys4(makePacket4(6, "192.0.2.1")->data_, client, relay);
+    EXPECT_EQ(vector<uint8_t>({ HTYPE_ETHER, 0, 1, 2, 3, 4, 6 }), client);
+    EXPECT_EQ(vector<uint8_t>({ 2, 192, 0, 2, 1 }), relay);
+
+    PacketRateLimiter::getKeys4(makePacket4(6, "192.0.2.1", { 9, 8 })->data_,
+                                client, relay);
+    EXPECT_EQ(vector<uint8_t>({ 1, 9, 8 }), relay);
+
+    PacketRateLimiter::getKeys4(OptionBuffer(10, 0), client, relay);
+    EXPECT_TRUE(client.empty());
+    EXPECT_TRUE(relay.empty());
+}
+
+// Verifies the DHCPv6 keys.
+TEST(PacketRateLimiterTest, keys6) {
+    vector<uint8_t> client;
+    vector<uint8_t> relay;
+    const vector<uint8_t> duid = { 0, 1, 2, 3, 4, 5 };
+    const IOAddress source("2001:db8::1");
+    PacketRateLimiter::getKeys6(makeData6(duid), source, client, relay);
+    EXPECT_EQ(duid, client);
+    EXPECT_TRUE(relay.empty());
+
+    // Relayed twice, without relay identifier.
+    PacketRateLimiter::getKeys6(relay6(relay6(makeData6(duid))), source,
+                                client, relay);
+    EXPECT_EQ(duid, client);
+    vector<uint8_t> expected = source.toBytes();
+    expected.insert(expected.begin(), 2);
+    EXPECT_EQ(expected, relay);
+
+    // With a relay identifier.
+    PacketRateLimiter::getKeys6(relay6(makeData6(duid), { 7, 7 }), source,
+                                client, relay);
+    EXPECT_EQ(duid, client);
+    EXPECT_EQ(vector<uint8_t>({ 1, 7, 7 }), relay);
+
+    // Truncated relay.
+    PacketRateLimiter::getKeys6(OptionBuffer(1, DHCPV6_RELAY_FORW), source,
+                                client, relay);
+    EXPECT_TRUE(client.empty());
+    EXPECT_EQ(expected, relay);
+}
+
+// Verifies that the packets are checked against both limits.
+TEST(PacketRateLimiterTest, allow4) {
+    TestPacketRateLimiter limiter;
+    limiter.setLimit(PacketRateLimiter::CLIENT, 1, 2);
+    limiter.setLimit(PacketRateLimiter::RELAY, 1, 3);
+
+    EXPECT_TRUE(limiter.allow(makePacket4(1, "192.0.2.1")));
+    EXPECT_TRUE(limiter.allow(makePacket4(1, "192.0.2.1")));
+    EXPECT_FALSE(limiter.allow(makePacket4(1, "192.0.2.1")));
+    EXPECT_EQ(1, limiter.getDropCount(PacketRateLimiter::CLIENT));
+    EXPECT_EQ(0, limiter.getDropCount(PacketRateLimiter::RELAY));
+
+    // The relay has one token left.
+    EXPECT_TRUE(limiter.allow(makePacket4(2, "192.0.2.1")));
+    EXPECT_FALSE(limiter.allow(makePacket4(3, "192.0.2.1")));
+    EXPECT_EQ(1, limiter.getDropCount(PacketRateLimiter::RELAY));
+
+    // Not relayed packets are only limited by client.
+    EXPECT_TRUE(limiter.allow(makePacket4(3)));
+    EXPECT_TRUE(limiter.allow(Pkt4Ptr()));
+}
+
+// Verifies the creation from the configuration.
+TEST(PacketRateLimiterTest, create) {
+    PacketRateLimiterPtr limiter;
+    ASSERT_NO_THROW(limiter = PacketRateLimiter::create(Element::fromJSON(
+        "{ \"client-rate\": 10, \"relay-rate\": 1000, \"relay-burst\": 2000,"
+        " \"buckets\": 256 }")));
+    ASSERT_TRUE(limiter);
+    EXPECT_EQ(256, limiter->getBuckets());
+    EXPECT_EQ(10, limiter->getRate(PacketRateLimiter::CLIENT));
+    EXPECT_EQ(10, limiter->getBurst(PacketRateLimiter::CLIENT));
+    EXPECT_EQ(1000, limiter->getRate(PacketRateLimiter::RELAY));
+    EXPECT_EQ(2000, limiter->getBurst(PacketRateLimiter::RELAY));
+
+    ASSERT_NO_THROW(limiter = PacketRateLimiter::create(Element::createMap()));
+    EXPECT_FALSE(limiter->isEnabled());
+    EXPECT_EQ(PacketRateLimiter::DEFAULT_BUCKETS, limiter->getBuckets());
+
+    EXPECT_THROW(PacketRateLimiter::create(ConstElementPtr()), BadValue);
+    EXPECT_THROW(PacketRateLimiter::create(Element::fromJSON("[ ]")), BadValue);
+    EXPECT_THROW(PacketRateLimiter::create(Element::fromJSON(
+        "{ \"client-rate\": -1 }")), BadValue);
+    EXPECT_THROW(PacketRateLimiter::create(Element::fromJSON(
+        "{ \"client-rate\": 1, \"client-burst\": 0 }")), BadValue);
+    EXPECT_THROW(PacketRateLimiter::create(Element::fromJSON(
+        "{ \"buckets\": 0 }")), BadValue);
+}
+
+} // end of anonymous namespace
@@ -633,12 +633,12 @@ TEST_F(Pkt4Test, getOptions) {
     // Make sure that the first option is returned. We're using the pointer
     // to opt1 to find the option.
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(1, opt1));
+                       OptionCollection::value_type(1, opt1));
     EXPECT_TRUE(opt_it != options.end());
 
     // Make sure that the second option is returned.
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(1, opt2));
+                       OptionCollection::value_type(1, opt2));
     EXPECT_TRUE(opt_it != options.end());
 
     // Retrieve options with option code 2.
@@ -647,11 +647,11 @@ TEST_F(Pkt4Test, getOptions) {
 
     // opt3 and opt4 should exist.
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(2, opt3));
+                       OptionCollection::value_type(2, opt3));
     EXPECT_TRUE(opt_it != options.end());
 
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(2, opt4));
+                       OptionCollection::value_type(2, opt4));
     EXPECT_TRUE(opt_it != options.end());
 
     // Enable copying options when they are retrieved.
@@ -664,11 +664,11 @@ TEST_F(Pkt4Test, getOptions) {
     // using option pointer should fail. Original pointers should have
     // been replaced with new instances.
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(1, opt1));
+                       OptionCollection::value_type(1, opt1));
     EXPECT_TRUE(opt_it == options.end());
 
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(1, opt2));
+                       OptionCollection::value_type(1, opt2));
     EXPECT_TRUE(opt_it == options.end());
 
     // Return instances of options with the option code 1 and make sure
@@ -688,11 +688,11 @@ TEST_F(Pkt4Test, getOptions) {
     ASSERT_EQ(2, options.size());
 
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(2, opt3));
+                       OptionCollection::value_type(2, opt3));
     EXPECT_TRUE(opt_it != options.end());
 
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(2, opt4));
+                       OptionCollection::value_type(2, opt4));
     EXPECT_TRUE(opt_it != options.end());
 }
 
@@ -924,6 +924,32 @@ TEST_F(Pkt4Test, Timestamp) {
     EXPECT_TRUE(ts_period.length().total_microseconds() >= 0);
 }
 
+// Checks that the event times are recorded and copied.
+TEST_F(Pkt4Test, eventTimes) {
+    Pkt4 query(DHCPDISCOVER, 1234);
+    const Pkt::EventTime unset;
+
+    // Initially no event occurred.
+    for (int event = 0; event < Pkt::EVENT_MAX; ++event) {
+        EXPECT_TRUE(query.getEventTime(static_cast<Pkt::Event>(event)) == unset);
+    }
+
+    query.setEventTime(Pkt::EVENT_RECEIVED);
+    query.setEventTime(Pkt::EVENT_DEQUEUED);
+    EXPECT_FALSE(query.getEventTime(Pkt::EVENT_RECEIVED) == unset);
+    EXPECT_TRUE(query.getEventTime(Pkt::EVENT_RECEIVED) <=
+                query.getEventTime(Pkt::EVENT_DEQUEUED));
+    EXPECT_TRUE(query.getEventTime(Pkt::EVENT_SENT) == unset);
+
+    Pkt4 response(DHCPOFFER, 1234);
+    response.copyEventTimes(query);
+    EXPECT_TRUE(response.getEventTime(Pkt::EVENT_RECEIVED) ==
+                query.getEventTime(Pkt::EVENT_RECEIVED));
+    EXPECT_TRUE(response.getEventTime(Pkt::EVENT_DEQUEUED) ==
+                query.getEventTime(Pkt::EVENT_DEQUEUED));
+    EXPECT_TRUE(response.getEventTime(Pkt::EVENT_ALLOC_STARTED) == unset);
+}
+
 TEST_F(Pkt4Test, hwaddr) {
     scoped_ptr<Pkt4> pkt(new Pkt4(DHCPOFFER, 1234));
     const uint8_t hw[] = { 2, 4, 6, 8, 10, 12 }; // MAC
@@ -1011,6 +1037,51 @@ TEST_F(Pkt4Test, isRelayed) {
     EXPECT_FALSE(pkt.isRelayed());
 }
 
+// This test verifies the lookups of the relay agent information sub-options.
+TEST_F(Pkt4Test, getRAISubOption) {
+    Pkt4 pkt(DHCPDISCOVER, 1234);
+    EXPECT_FALSE(pkt.getRAISubOption(RAI_OPTION_AGENT_CIRCUIT_ID));
+
+    OptionPtr rai(new Option(Option::V4, DHO_DHCP_AGENT_OPTIONS));
+    OptionPtr circuit_id(new Option(Option::V4, RAI_OPTION_AGENT_CIRCUIT_ID,
+                                    OptionBuffer(3, 1)));
+    rai->addOption(circuit_id);
+    OptionPtr vss(new Option(Option::V4, RAI_OPTION_VIRTUAL_SUBNET_SELECT,
+                             OptionBuffer(2, 2)));
+    rai->addOption(vss);
+    pkt.addOption(rai);
+
+    EXPECT_EQ(circuit_id, pkt.getRAISubOption(RAI_OPTION_AGENT_CIRCUIT_ID));
+    EXPECT_FALSE(pkt.getRAISubOption(RAI_OPTION_REMOTE_ID));
+    // The codes after the relay-port are not indexed.
+    EXPECT_EQ(vss, pkt.getRAISubOption(RAI_OPTION_VIRTUAL_SUBNET_SELECT));
+
+    // An added sub-option is found.
+    OptionPtr remote_id(new Option(Option::V4, RAI_OPTION_REMOTE_ID,
+                                   OptionBuffer(4, 3)));
+    rai->addOption(remote_id);
+    EXPECT_EQ(remote_id, pkt.getRAISubOption(RAI_OPTION_REMOTE_ID));
+
+    // A replaced option is indexed again.
+    OptionPtr rai2(new Option(Option::V4, DHO_DHCP_AGENT_OPTIONS));
+    OptionPtr circuit_id2(new Option(Option::V4, RAI_OPTION_AGENT_CIRCUIT_ID,
+                                     OptionBuffer(3, 4)));
+    rai2->addOption(circuit_id2);
+    ASSERT_TRUE(pkt.delOption(DHO_DHCP_AGENT_OPTIONS));
+    EXPECT_FALSE(pkt.getRAISubOption(RAI_OPTION_AGENT_CIRCUIT_ID));
+    pkt.addOption(rai2);
+    EXPECT_EQ(circuit_id2, pkt.getRAISubOption(RAI_OPTION_AGENT_CIRCUIT_ID));
+    EXPECT_FALSE(pkt.getRAISubOption(RAI_OPTION_REMOTE_ID));
+
+    // The retrieved options are copied when configured.
+    pkt.setCopyRetrievedOptions(true);
+    OptionPtr copy = pkt.getRAISubOption(RAI_OPTION_AGENT_CIRCUIT_ID);
+    ASSERT_TRUE(copy);
+    EXPECT_NE(circuit_id2, copy);
+    EXPECT_EQ(circuit_id2->getData(), copy->getData());
+    pkt.setCopyRetrievedOptions(false);
+}
+
 // Tests whether a packet can be assigned to a class and later
 // checked if it belongs to a given class
 TEST_F(Pkt4Test, clientClasses) {
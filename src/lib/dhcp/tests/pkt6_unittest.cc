@@ -511,12 +511,12 @@ TEST_F(Pkt6Test, getOptions) {
     // Make sure that the first option is returned. We're using the pointer
     // to opt1 to find the option.
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(1, opt1));
+                       OptionCollection::value_type(1, opt1));
     EXPECT_TRUE(opt_it != options.end());
 
     // Make sure that the second option is returned.
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(1, opt2));
+                       OptionCollection::value_type(1, opt2));
     EXPECT_TRUE(opt_it != options.end());
 
     // Retrieve options with option code 2.
@@ -524,11 +524,11 @@ TEST_F(Pkt6Test, getOptions) {
 
     // opt3 and opt4 should exist.
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(2, opt3));
+                       OptionCollection::value_type(2, opt3));
     EXPECT_TRUE(opt_it != options.end());
 
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(2, opt4));
+                       OptionCollection::value_type(2, opt4));
     EXPECT_TRUE(opt_it != options.end());
 
     // Enable copying options when they are retrieved.
@@ -541,11 +541,11 @@ TEST_F(Pkt6Test, getOptions) {
     // using option pointer should fail. Original pointers should have
     // been replaced with new instances.
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(1, opt1));
+                       OptionCollection::value_type(1, opt1));
     EXPECT_TRUE(opt_it == options.end());
 
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(1, opt2));
+                       OptionCollection::value_type(1, opt2));
     EXPECT_TRUE(opt_it == options.end());
 
     // Return instances of options with the option code 1 and make sure
@@ -564,11 +564,11 @@ TEST_F(Pkt6Test, getOptions) {
     ASSERT_EQ(2, options.size());
 
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(2, opt3));
+                       OptionCollection::value_type(2, opt3));
     EXPECT_TRUE(opt_it != options.end());
 
     opt_it = std::find(options.begin(), options.end(),
-                       std::pair<const unsigned int, OptionPtr>(2, opt4));
+                       OptionCollection::value_type(2, opt4));
     EXPECT_TRUE(opt_it != options.end());
 }
 
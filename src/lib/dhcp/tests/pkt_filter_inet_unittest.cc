@@ -14,6 +14,7 @@
 #include <gtest/gtest.h>
 
 #include <sys/socket.h>
+#include <unistd.h>
 
 using namespace isc::asiolink;
 using namespace isc::dhcp;
@@ -64,6 +65,33 @@ TEST_F(PktFilterInetTest, openSocket) {
     testDgramSocket(sock_info_.sockfd_);
 }
 
+#ifdef SO_REUSEPORT
+// This test verifies that many sockets can be bound to the same address
+// and port when the SO_REUSEPORT option is enabled.
+TEST_F(PktFilterInetTest, openSocketReusePort) {
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("127.0.0.1");
+
+    PktFilterInet pkt_filter;
+    EXPECT_TRUE(pkt_filter.isSocketReusePortSupported());
+    pkt_filter.setSocketReusePort(true);
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, false, false);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+
+    SocketInfo sock_info2(addr, PORT, -1);
+    ASSERT_NO_THROW(sock_info2 = pkt_filter.openSocket(iface, addr, PORT,
+                                                       false, false));
+    ASSERT_GE(sock_info2.sockfd_, 0);
+    testDgramSocket(sock_info2.sockfd_);
+    close(sock_info2.sockfd_);
+
+    // Without the option the address is already in use.
+    pkt_filter.setSocketReusePort(false);
+    EXPECT_THROW(pkt_filter.openSocket(iface, addr, PORT, false, false),
+                 SocketConfigError);
+}
+#endif
+
 // This test verifies that the packet is correctly sent over the INET
 // datagram socket.
 TEST_F(PktFilterInetTest, send) {
@@ -145,4 +173,92 @@ TEST_F(PktFilterInetTest, receive) {
     testRcvdMessageAddressPort(rcvd_pkt);
 }
 
+#if defined (OS_LINUX)
+// This test verifies that a batch of DHCPv4 packets is correctly received
+// via INET datagram socket with a single call.
+TEST_F(PktFilterInetTest, receiveBatch) {
+
+    // Packets will be received over loopback interface.
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("127.0.0.1");
+
+    // Create an instance of the class which we are testing.
+    PktFilterInet pkt_filter;
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, false, false);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+
+    // Send three DHCPv4 messages to the local loopback address and
+    // server's port.
+    sendMessage();
+    sendMessage();
+    sendMessage();
+
+    // Receive at most two packets.
+    std::vector<Pkt4Ptr> pkts;
+    ASSERT_NO_THROW(pkt_filter.receiveBatch(iface, sock_info_, pkts, 2));
+    ASSERT_EQ(2, pkts.size());
+
+    // Receive the remaining packet.
+    size_t count = 0;
+    ASSERT_NO_THROW(count = pkt_filter.receiveBatch(iface, sock_info_, pkts, 10));
+    EXPECT_EQ(1, count);
+    ASSERT_EQ(3, pkts.size());
+
+    for (auto const& rcvd_pkt : pkts) {
+        ASSERT_TRUE(rcvd_pkt);
+        ASSERT_NO_THROW(rcvd_pkt->unpack());
+        testRcvdMessage(rcvd_pkt);
+        testRcvdMessageAddressPort(rcvd_pkt);
+    }
+
+    // There is no more data and the call does not block.
+    ASSERT_NO_THROW(count = pkt_filter.receiveBatch(iface, sock_info_, pkts, 10));
+    EXPECT_EQ(0, count);
+    EXPECT_EQ(3, pkts.size());
+}
+#endif
+
+// This test verifies that a batch of packets is correctly sent over the
+// INET datagram socket.
+TEST_F(PktFilterInetTest, sendBatch) {
+    // Packets will be sent over loopback interface.
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("127.0.0.1");
+
+    // Create an instance of the class which we are testing.
+    PktFilterInet pkt_filter;
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, false, false);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+
+    // Send the same packet three times over the socket.
+    std::vector<Pkt4Ptr> pkts(3, test_message_);
+    size_t sent = 0;
+    ASSERT_NO_THROW(sent = pkt_filter.sendBatch(iface, sock_info_.sockfd_, pkts));
+    ASSERT_EQ(3, sent);
+
+    // Read the data from socket.
+    for (size_t i = 0; i < sent; ++i) {
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(sock_info_.sockfd_, &readfds);
+
+        struct timeval timeout;
+        timeout.tv_sec = 5;
+        timeout.tv_usec = 0;
+        int result = select(sock_info_.sockfd_ + 1, &readfds, NULL, NULL, &timeout);
+        // We should receive some data from loopback interface.
+        ASSERT_GT(result, 0);
+
+        // Get the actual data.
+        uint8_t rcv_buf[RECV_BUF_SIZE];
+        result = recv(sock_info_.sockfd_, rcv_buf, RECV_BUF_SIZE, 0);
+        ASSERT_GT(result, 0);
+
+        // Create the DHCPv4 packet from the received data and check it.
+        Pkt4Ptr rcvd_pkt(new Pkt4(rcv_buf, result));
+        ASSERT_NO_THROW(rcvd_pkt->unpack());
+        testRcvdMessage(rcvd_pkt);
+    }
+}
+
 } // anonymous namespace
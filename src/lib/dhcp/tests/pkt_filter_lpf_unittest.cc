@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -6,18 +6,23 @@
 
 #include <config.h>
 #include <asiolink/io_address.h>
+#include <dhcp/dhcp4.h>
 #include <dhcp/iface_mgr.h>
 #include <dhcp/pkt4.h>
 #include <dhcp/pkt_filter_lpf.h>
 #include <dhcp/protocol_util.h>
 #include <dhcp/tests/pkt_filter_test_utils.h>
+#include <exceptions/exceptions.h>
 #include <util/buffer.h>
 
 #include <gtest/gtest.h>
 
+#include <linux/filter.h>
 #include <linux/if_packet.h>
+#include <sys/select.h>
 #include <sys/socket.h>
 
+using namespace isc;
 using namespace isc::asiolink;
 using namespace isc::dhcp;
 using namespace isc::util;
@@ -29,6 +34,133 @@ const uint16_t PORT = 10067;
 /// Size of the buffer holding received packets.
 const size_t RECV_BUF_SIZE = 2048;
 
+/// @brief Runs a filter program on a frame.
+///
+/// Interprets the subset of the classic BPF instructions used by the
+/// programs of @c PktFilterLPF.
+///
+/// @param program the filter program
+/// @param frame the frame
+/// @return the number of bytes of the frame accepted by the program.
+uint32_t
+runFilterProgram(const std::vector<struct sock_filter>& program,
+                 const std::vector<uint8_t>& frame) {
+    uint32_t a = 0;
+    uint32_t x = 0;
+    uint32_t mem[BPF_MEMWORDS] = { 0 };
+    auto load = [&frame](uint32_t offset, size_t size, uint32_t& value) {
+        if (offset + size > frame.size()) {
+            return (false);
+        }
+        value = 0;
+        for (size_t i = 0; i < size; ++i) {
+            value = (value << 8) | frame[offset + i];
+        }
+        return (true);
+    };
+    for (size_t pc = 0; pc < program.size(); ++pc) {
+        const struct sock_filter& insn = program[pc];
+        size_t size = (BPF_SIZE(insn.code) == BPF_W ? 4 :
+                       (BPF_SIZE(insn.code) == BPF_H ? 2 : 1));
+        switch (BPF_CLASS(insn.code)) {
+        case BPF_LD:
+            if (BPF_MODE(insn.code) == BPF_MEM) {
+                a = mem[insn.k];
+            } else if (!load((BPF_MODE(insn.code) == BPF_IND ? x : 0) + insn.k,
+                             size, a)) {
+                return (0);
+            }
+            break;
+        case BPF_LDX:
+            if (!load(insn.k, 1, x)) {
+                return (0);
+            }
+            x = (x & 0xf) << 2;
+            break;
+        case BPF_ST:
+            mem[insn.k] = a;
+            break;
+        case BPF_ALU:
+            EXPECT_EQ(BPF_AND, BPF_OP(insn.code));
+            a &= insn.k;
+            break;
+        case BPF_JMP: {
+            bool cond = false;
+            switch (BPF_OP(insn.code)) {
+            case BPF_JEQ:
+                cond = (a == insn.k);
+                break;
+            case BPF_JGE:
+                cond = (a >= insn.k);
+                break;
+            case BPF_JSET:
+                cond = ((a & insn.k) != 0);
+                break;
+            default:
+                ADD_FAILURE() << "unexpected jump " << insn.code;
+                return (0);
+            }
+            pc += (cond ? insn.jt : insn.jf);
+            break;
+        }
+        case BPF_RET:
+            return (insn.k);
+        default:
+            ADD_FAILURE() << "unexpected instruction " << insn.code;
+            return (0);
+        }
+    }
+    ADD_FAILURE() << "the program does not return";
+    return (0);
+}
+
+/// @brief Builds an Ethernet frame holding a DHCPv4 message.
+///
+/// @param dst_addr destination IP address
+/// @param dst_port destination UDP port
+/// @param op DHCPv4 op field
+/// @param giaddr DHCPv4 giaddr field
+/// @param dhcp_len length of the DHCPv4 message
+std::vector<uint8_t>
+buildFrame(const IOAddress& dst_addr, uint16_t dst_port, uint8_t op,
+           const IOAddress& giaddr, size_t dhcp_len = 300) {
+    OutputBuffer buf(0);
+    // Ethernet header.
+    for (int i = 0; i < 12; ++i) {
+        buf.writeUint8(i);
+    }
+    buf.writeUint16(ETHERNET_TYPE_IP);
+    // IP header without options.
+    buf.writeUint8(0x45);
+    buf.writeUint8(0);
+    buf.writeUint16(20 + 8 + dhcp_len);
+    buf.writeUint32(0);
+    buf.writeUint8(128);
+    buf.writeUint8(IPPROTO_UDP);
+    buf.writeUint16(0);
+    buf.writeUint32(IOAddress("192.0.2.254").toUint32());
+    buf.writeUint32(dst_addr.toUint32());
+    // UDP header.
+    buf.writeUint16(DHCP4_CLIENT_PORT);
+    buf.writeUint16(dst_port);
+    buf.writeUint16(8 + dhcp_len);
+    buf.writeUint16(0);
+    // DHCPv4 message.
+    std::vector<uint8_t> dhcp(dhcp_len, 0);
+    if (dhcp_len > 0) {
+        dhcp[0] = op;
+    }
+    if (dhcp_len >= 28) {
+        uint32_t value = giaddr.toUint32();
+        for (int i = 0; i < 4; ++i) {
+            dhcp[24 + i] = static_cast<uint8_t>(value >> (24 - 8 * i));
+        }
+    }
+    buf.writeData(&dhcp[0], dhcp.size());
+    const uint8_t* data = static_cast<const uint8_t*>(buf.getData());
+    return (std::vector<uint8_t>(data, data + buf.getLength()));
+}
+
 // Test fixture class inherits from the class common for all packet
 // filter tests.
 class PktFilterLPFTest : public isc::dhcp::test::PktFilterTest {
@@ -46,6 +178,90 @@ TEST_F(PktFilterLPFTest, isDirectResponseSupported) {
     EXPECT_TRUE(pkt_filter.isDirectResponseSupported());
 }
 
+// This test verifies that the PktFilterLPF class reports that the frames
+// may be received through a ring.
+TEST_F(PktFilterLPFTest, isReceiveRingSupported) {
+    // Create object under test.
+    PktFilterLPF pkt_filter;
+    // The frames may be queued to the receive ring.
+    EXPECT_TRUE(pkt_filter.isReceiveRingSupported());
+}
+
+// This test verifies that the filter program accepts the DHCPv4 requests
+// and drops the other frames.
+TEST_F(PktFilterLPFTest, buildFilterProgram) {
+    IOAddress addr("192.0.2.1");
+    IOAddress bcast("255.255.255.255");
+    IOAddress zero("0.0.0.0");
+    std::vector<struct sock_filter> program =
+        PktFilterLPF::buildFilterProgram(addr, PORT, RelayPrefixes());
+
+    // Broadcast and unicast requests are accepted.
+    EXPECT_NE(0, runFilterProgram(program, buildFrame(bcast, PORT, BOOTREQUEST,
+                                                      zero)));
+    EXPECT_NE(0, runFilterProgram(program, buildFrame(addr, PORT, BOOTREQUEST,
+                                                      IOAddress("10.1.2.3"))));
+
+    // Other destination address or port.
+    EXPECT_EQ(0, runFilterProgram(program,
+                                  buildFrame(IOAddress("192.0.2.2"), PORT,
+                                             BOOTREQUEST, zero)));
+    EXPECT_EQ(0, runFilterProgram(program, buildFrame(bcast, PORT + 1,
+                                                      BOOTREQUEST, zero)));
+
+    // Replies and datagrams too short for a DHCPv4 message.
+    EXPECT_EQ(0, runFilterProgram(program, buildFrame(bcast, PORT, BOOTREPLY,
+                                                      zero)));
+    EXPECT_EQ(0, runFilterProgram(program, buildFrame(bcast, PORT, BOOTREQUEST,
+                                                      zero, 100)));
+}
+
+// This test verifies that the filter program only accepts the relayed
+// messages of the accepted relays.
+TEST_F(PktFilterLPFTest, buildFilterProgramAcceptedRelays) {
+    IOAddress bcast("255.255.255.255");
+    RelayPrefixes relays;
+    relays.push_back(std::make_pair(IOAddress("10.0.0.0"), 8));
+    relays.push_back(std::make_pair(IOAddress("192.0.2.128"), 25));
+    std::vector<struct sock_filter> program =
+        PktFilterLPF::buildFilterProgram(IOAddress("192.0.2.1"), PORT, relays);
+
+    // The messages which are not relayed are accepted.
+    EXPECT_NE(0, runFilterProgram(program, buildFrame(bcast, PORT, BOOTREQUEST,
+                                                      IOAddress("0.0.0.0"))));
+
+    EXPECT_NE(0, runFilterProgram(program,
+                                  buildFrame(bcast, PORT, BOOTREQUEST,
+                                             IOAddress("10.20.30.40"))));
+    EXPECT_NE(0, runFilterProgram(program,
+                                  buildFrame(bcast, PORT, BOOTREQUEST,
+                                             IOAddress("192.0.2.200"))));
+    EXPECT_EQ(0, runFilterProgram(program,
+                                  buildFrame(bcast, PORT, BOOTREQUEST,
+                                             IOAddress("192.0.2.100"))));
+    EXPECT_EQ(0, runFilterProgram(program,
+                                  buildFrame(bcast, PORT, BOOTREQUEST,
+                                             IOAddress("11.0.0.1"))));
+
+    // A null prefix length accepts all the relays.
+    relays.clear();
+    relays.push_back(std::make_pair(IOAddress("0.0.0.0"), 0));
+    program = PktFilterLPF::buildFilterProgram(IOAddress("192.0.2.1"), PORT,
+                                               relays);
+    EXPECT_NE(0, runFilterProgram(program,
+                                  buildFrame(bcast, PORT, BOOTREQUEST,
+                                             IOAddress("11.0.0.1"))));
+
+    // The maximum number of relays is enforced.
+    relays.assign(MAX_ACCEPTED_RELAYS,
+                  std::make_pair(IOAddress("10.0.0.0"), 8));
+    EXPECT_NO_THROW(PktFilterLPF::buildFilterProgram(IOAddress("192.0.2.1"),
+                                                     PORT, relays));
+    relays.push_back(std::make_pair(IOAddress("10.0.0.0"), 8));
+    EXPECT_THROW(PktFilterLPF::buildFilterProgram(IOAddress("192.0.2.1"),
+                                                  PORT, relays), BadValue);
+}
+
 // All tests below require root privileges to execute successfully. If
 // they are run as non-root user they will fail due to insufficient privileges
 // to open raw network sockets. Therefore, they should remain disabled by default
@@ -169,6 +385,14 @@ TEST_F(PktFilterLPFTest, DISABLED_receive) {
     // Send DHCPv4 message to the local loopback address and server's port.
     sendMessage();
 
+    // The receive ring hands out the frames when a block is retired so
+    // wait for the socket to become readable.
+    fd_set readfds;
+    FD_ZERO(&readfds);
+    FD_SET(sock_info_.sockfd_, &readfds);
+    struct timeval timeout = { 1, 0 };
+    ASSERT_GT(select(sock_info_.sockfd_ + 1, &readfds, 0, 0, &timeout), 0);
+
     // Receive the packet using LPF packet filter.
     Pkt4Ptr rcvd_pkt = pkt_filter.receive(iface, sock_info_);
     // Check that the packet has been correctly received.
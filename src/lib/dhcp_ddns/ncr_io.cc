@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -268,6 +268,42 @@ NameChangeSender::sendRequestInternal(NameChangeRequestPtr& ncr) {
     sendNext();
 }
 
+size_t
+NameChangeSender::sendRequests(const std::vector<NameChangeRequestPtr>& ncrs) {
+    if (!amSending()) {
+        isc_throw(NcrSenderError, "sender is not ready to send");
+    }
+
+    for (auto const& ncr : ncrs) {
+        if (!ncr) {
+            isc_throw(NcrSenderError, "request to send is empty");
+        }
+    }
+
+    if (MultiThreadingMgr::instance().getMode()) {
+        lock_guard<mutex> lock(*mutex_);
+        return (sendRequestsInternal(ncrs));
+    } else {
+        return (sendRequestsInternal(ncrs));
+    }
+}
+
+size_t
+NameChangeSender::sendRequestsInternal(const std::vector<NameChangeRequestPtr>& ncrs) {
+    size_t queued = 0;
+    for (auto const& ncr : ncrs) {
+        if (send_queue_.size() >= send_queue_max_) {
+            break;
+        }
+        send_queue_.push_back(ncr);
+        ++queued;
+    }
+
+    // Call sendNext to schedule the next one to go.
+    sendNext();
+    return (queued);
+}
+
 void
 NameChangeSender::sendNext() {
     if (ncr_to_send_) {
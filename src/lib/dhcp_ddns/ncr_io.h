@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -56,6 +56,7 @@
 
 #include <deque>
 #include <mutex>
+#include <vector>
 
 namespace isc {
 namespace dhcp_ddns {
@@ -549,6 +550,20 @@ public:
     /// capacity.
     void sendRequest(NameChangeRequestPtr& ncr);
 
+    /// @brief Queues the given requests to be sent.
+    ///
+    /// The requests are placed at the back of the send queue in order,
+    /// under one lock, until the queue reaches its capacity, and then
+    /// sendNext is invoked.
+    ///
+    /// @param ncrs are the NameChangeRequests to send.
+    ///
+    /// @return The number of requests queued, the remaining ones are
+    /// rejected as the send queue reached capacity.
+    /// @throw NcrSenderError if the sender is not in sending state or
+    /// a request is empty.
+    size_t sendRequests(const std::vector<NameChangeRequestPtr>& ncrs);
+
     /// @brief Move all queued requests from a given sender into the send queue
     ///
     /// Moves all of the entries in the given sender's queue and places them
@@ -597,6 +612,13 @@ private:
     /// @throw NcrSenderQueueFull if the send queue has reached capacity.
     void sendRequestInternal(NameChangeRequestPtr& ncr);
 
+    /// @brief Queues the given requests to be sent in a thread safe context.
+    ///
+    /// @param ncrs are the NameChangeRequests to send.
+    ///
+    /// @return The number of requests queued.
+    size_t sendRequestsInternal(const std::vector<NameChangeRequestPtr>& ncrs);
+
     /// @brief Move all queued requests from a given sender into the send queue
     /// in a thread safe context.
     ///
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -28,6 +28,10 @@ NameChangeFormat stringToNcrFormat(const std::string& fmt_str) {
         return FMT_JSON;
     }
 
+    if (boost::iequals(fmt_str, "BINARY")) {
+        return FMT_BINARY;
+    }
+
     isc_throw(BadValue, "Invalid NameChangeRequest format: " << fmt_str);
 }
 
@@ -37,6 +41,10 @@ std::string ncrFormatToString(NameChangeFormat format) {
         return ("JSON");
     }
 
+    if (format == FMT_BINARY) {
+        return ("BINARY");
+    }
+
     std::ostringstream stream;
     stream  << "UNKNOWN(" << format << ")";
     return (stream.str());
@@ -55,6 +63,18 @@ const uint8_t DHCID_ID_HWADDR   = 0x0;
 const uint8_t DHCID_ID_CLIENTID = 0x1;
 /// DHCID created from DUID.
 const uint8_t DHCID_ID_DUID     = 0x2;
+//@}
+
+///
+/// @name Flags of the binary NameChangeRequest format
+//@{
+/// Forward DNS zone should be updated.
+const uint8_t BINARY_FORWARD_CHANGE      = 0x01;
+/// Reverse DNS zone should be updated.
+const uint8_t BINARY_REVERSE_CHANGE      = 0x02;
+/// Conflict resolution is enabled.
+const uint8_t BINARY_CONFLICT_RESOLUTION = 0x04;
+//@}
 
 }
 
@@ -282,6 +302,33 @@ NameChangeRequest::fromFormat(const NameChangeFormat format,
                       << ex.what());
         }
 
+        break;
+        }
+    case FMT_BINARY: {
+        try {
+            // Get the length of the binary data.
+            size_t len = buffer.readUint16();
+
+            // Read the data from the buffer into a vector.
+            std::vector<uint8_t> vec;
+            buffer.readVector(vec, len);
+
+            // Pass the data into the binary factory to create the
+            // NameChangeRequest instance. The data must be consumed
+            // entirely.
+            isc::util::InputBuffer data(vec.data(), vec.size());
+            ncr = NameChangeRequest::fromBinary(data);
+            if (data.getLength() != data.getPosition()) {
+                isc_throw(NcrMessageError, "fromFormat: "
+                          << data.getLength() - data.getPosition()
+                          << " trailing bytes in binary request");
+            }
+        } catch (const isc::util::InvalidBufferPosition& ex) {
+            // Read error accessing data in InputBuffer.
+            isc_throw(NcrMessageError, "fromFormat: buffer read error: "
+                      << ex.what());
+        }
+
         break;
         }
     default:
@@ -310,6 +357,21 @@ NameChangeRequest::toFormat(const NameChangeFormat format,
         buffer.writeData(json.c_str(), length);
         break;
         }
+    case FMT_BINARY: {
+        // Invoke toBinary to render this request's contents.
+        isc::util::OutputBuffer data(0);
+        toBinary(data);
+        if (data.getLength() > std::numeric_limits<uint16_t>::max()) {
+            isc_throw(NcrMessageError, "toFormat: binary request too long: "
+                      << data.getLength());
+        }
+
+        // Write the length of the binary data to the OutputBuffer first,
+        // then write the data itself.
+        buffer.writeUint16(static_cast<uint16_t>(data.getLength()));
+        buffer.writeData(data.getData(), data.getLength());
+        break;
+        }
     default:
         // Programmatic error, shouldn't happen.
         isc_throw(NcrMessageError, "toFormat - invalid format");
@@ -410,6 +472,88 @@ NameChangeRequest::toJSON() const  {
     return (stream.str());
 }
 
+NameChangeRequestPtr
+NameChangeRequest::fromBinary(isc::util::InputBuffer& buffer) {
+    // Use default constructor to create a "blank" NameChangeRequest.
+    NameChangeRequestPtr ncr(new NameChangeRequest());
+
+    try {
+        uint8_t change_type = buffer.readUint8();
+        if (change_type > CHG_REMOVE) {
+            isc_throw(NcrMessageError, "Invalid data value for change_type: "
+                      << static_cast<unsigned>(change_type));
+        }
+        ncr->setChangeType(static_cast<NameChangeType>(change_type));
+
+        uint8_t flags = buffer.readUint8();
+        ncr->setForwardChange(flags & BINARY_FORWARD_CHANGE);
+        ncr->setReverseChange(flags & BINARY_REVERSE_CHANGE);
+        ncr->setConflictResolution(flags & BINARY_CONFLICT_RESOLUTION);
+
+        uint8_t addr_len = buffer.readUint8();
+        if ((addr_len != 4) && (addr_len != 16)) {
+            isc_throw(NcrMessageError, "Invalid ip address length: "
+                      << static_cast<unsigned>(addr_len));
+        }
+        std::vector<uint8_t> addr;
+        buffer.readVector(addr, addr_len);
+        ncr->ip_io_address_ =
+            asiolink::IOAddress::fromBytes(addr_len == 4 ? AF_INET : AF_INET6,
+                                           addr.data());
+
+        std::vector<uint8_t> fqdn;
+        buffer.readVector(fqdn, buffer.readUint16());
+        ncr->setFqdn(std::string(fqdn.begin(), fqdn.end()));
+
+        std::vector<uint8_t> dhcid;
+        buffer.readVector(dhcid, buffer.readUint16());
+        ncr->dhcid_.fromBytes(dhcid);
+
+        uint64_t expires_on = buffer.readUint32();
+        expires_on = (expires_on << 32) | buffer.readUint32();
+        ncr->lease_expires_on_ = expires_on;
+
+        ncr->setLeaseLength(buffer.readUint32());
+    } catch (const isc::util::InvalidBufferPosition& ex) {
+        isc_throw(NcrMessageError,
+                  "Malformed NameChangeRequest binary data: " << ex.what());
+    }
+
+    // Validate the overall content semantically.  This will throw an
+    // NcrMessageError if anything is amiss.
+    ncr->validateContent();
+
+    return (ncr);
+}
+
+void
+NameChangeRequest::toBinary(isc::util::OutputBuffer& buffer) const {
+    const std::vector<uint8_t>& dhcid = getDhcid().getBytes();
+    if ((fqdn_.size() > std::numeric_limits<uint16_t>::max()) ||
+        (dhcid.size() > std::numeric_limits<uint16_t>::max())) {
+        isc_throw(NcrMessageError, "toBinary: FQDN or DHCID too long");
+    }
+
+    buffer.writeUint8(static_cast<uint8_t>(change_type_));
+    buffer.writeUint8((forward_change_ ? BINARY_FORWARD_CHANGE : 0) |
+                      (reverse_change_ ? BINARY_REVERSE_CHANGE : 0) |
+                      (conflict_resolution_ ? BINARY_CONFLICT_RESOLUTION : 0));
+
+    std::vector<uint8_t> addr = ip_io_address_.toBytes();
+    buffer.writeUint8(static_cast<uint8_t>(addr.size()));
+    buffer.writeData(addr.data(), addr.size());
+
+    buffer.writeUint16(static_cast<uint16_t>(fqdn_.size()));
+    buffer.writeData(fqdn_.data(), fqdn_.size());
+
+    buffer.writeUint16(static_cast<uint16_t>(dhcid.size()));
+    if (!dhcid.empty()) {
+        buffer.writeData(dhcid.data(), dhcid.size());
+    }
+
+    buffer.writeUint64(lease_expires_on_);
+    buffer.writeUint32(lease_length_);
+}
 
 void
 NameChangeRequest::validateContent() {
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -58,13 +58,14 @@ enum NameChangeStatus  {
 
 /// @brief Defines the list of data wire formats supported.
 enum NameChangeFormat {
-  FMT_JSON
+  FMT_JSON,
+  FMT_BINARY
 };
 
 /// @brief Function which converts labels to  NameChangeFormat enum values.
 ///
 /// @param fmt_str text to convert to an enum.
-/// Valid string values: "JSON"
+/// Valid string values: "JSON", "BINARY"
 ///
 /// @return NameChangeFormat value which maps to the given string.
 ///
@@ -138,6 +139,13 @@ public:
     /// or there is an odd number of digits.
     void fromStr(const std::string& data);
 
+    /// @brief Sets the DHCID value to the given bytes.
+    ///
+    /// @param bytes the DHCID value in unsigned bytes.
+    void fromBytes(const std::vector<uint8_t>& bytes) {
+        bytes_ = bytes;
+    }
+
     /// @brief Sets the DHCID value based on the Client Identifier.
     ///
     /// @param clientid_data Holds the raw bytes representing client identifier.
@@ -220,8 +228,10 @@ typedef std::map<std::string, isc::data::ConstElementPtr> ElementMap;
 /// This class is used by DHCP-DDNS clients (e.g. DHCP4, DHCP6) to
 /// request DNS updates.  Each message contains a single DNS change (either an
 /// add/update or a remove) for a single FQDN.  It provides marshalling services
-/// for moving instances to and from the wire.  Currently, the only format
-/// supported is JSON detailed here isc::dhcp_ddns::NameChangeRequest::fromJSON
+/// for moving instances to and from the wire.  The supported formats are
+/// JSON detailed here isc::dhcp_ddns::NameChangeRequest::fromJSON and a
+/// compact binary format detailed here
+/// isc::dhcp_ddns::NameChangeRequest::fromBinary
 /// The class provides an interface such that other formats can be readily
 /// supported.
 class NameChangeRequest {
@@ -275,7 +285,10 @@ public:
     /// is than treated as JSON which is then parsed into the data needed
     /// to create a request instance.
     ///
-    /// (NOTE currently only JSON is supported.)
+    /// BINARY: The buffer is expected to contain a two byte unsigned integer
+    /// which specifies the length of the binary data; followed by the binary
+    /// data itself, described under
+    /// isc::dhcp_ddns::NameChangeRequest::fromBinary
     ///
     /// @param format indicates the data format to use
     /// @param buffer is the input buffer containing the marshalled request
@@ -300,7 +313,10 @@ public:
     /// is identical that described under
     /// isc::dhcp_ddns::NameChangeRequest::fromJSON
     ///
-    /// (NOTE currently only JSON is supported.)
+    /// BINARY: Upon completion, the buffer will contain a two byte unsigned
+    /// integer which specifies the length of the binary data; followed by
+    /// the binary data itself as described under
+    /// isc::dhcp_ddns::NameChangeRequest::fromBinary
     ///
     /// @param format indicates the data format to use
     /// @param buffer is the output buffer to which the request should be
@@ -411,6 +427,40 @@ public:
     /// @return a string containing the JSON rendition of the request
     std::string toJSON() const;
 
+    /// @brief Static method for creating a NameChangeRequest from a
+    /// buffer containing a binary rendition of a request.
+    ///
+    /// The binary format carries the same members as the JSON format
+    /// without the cost of producing and parsing text. All integers are
+    /// in network order:
+    ///
+    /// - change-type (1 byte): 0 for add/update and 1 for remove.
+    /// - flags (1 byte): 0x01 for forward-change, 0x02 for reverse-change
+    ///   and 0x04 for use-conflict-resolution.
+    /// - ip-address (1 byte length, 4 or 16, followed by the address).
+    /// - fqdn (2 bytes length followed by the domain name text).
+    /// - dhcid (2 bytes length followed by the DHCID bytes).
+    /// - lease-expires-on (8 bytes): seconds since the epoch.
+    /// - lease-length (4 bytes): length of the lease in seconds.
+    ///
+    /// @param buffer is the input buffer positioned at the first byte of
+    /// the binary rendition.
+    ///
+    /// @return a pointer to the new NameChangeRequest
+    ///
+    /// @throw NcrMessageError if an error occurs creating new request.
+    static NameChangeRequestPtr fromBinary(isc::util::InputBuffer& buffer);
+
+    /// @brief Instance method for marshalling the contents of the request
+    /// into the binary format described under
+    /// isc::dhcp_ddns::NameChangeRequest::fromBinary
+    ///
+    /// @param buffer is the output buffer to which the request should be
+    /// marshalled.
+    ///
+    /// @throw NcrMessageError if the FQDN or the DHCID is too long.
+    void toBinary(isc::util::OutputBuffer& buffer) const;
+
     /// @brief Validates the content of a populated request.  This method is
     /// used by both the full constructor and from-wire marshalling to ensure
     /// that the request is content valid.  Currently it enforces the
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -301,16 +301,19 @@ NameChangeUDPSender::doSend(NameChangeRequestPtr& ncr) {
     send_callback_->putData(static_cast<const uint8_t*>(ncr_buffer.getData()),
                             ncr_buffer.getLength());
 
-    // Call the socket's asynchronous send, passing our callback
-    socket_->asyncSend(send_callback_->getData(), send_callback_->getPutLen(),
-                       send_callback_->getDataSource().get(), *send_callback_);
-
     // Set IO ready marker so sender activity is visible to select() or poll().
     // Note, if this call throws it will manifest itself as a throw from
     // from sendRequest() which the application calls directly and is documented
     // as throwing exceptions; or caught inside invokeSendHandler() which
     // will invoke the application's send_handler with an error status.
+    // The marker is set before the send: when the IO service is run by
+    // another thread the send may complete, and clear the marker, before
+    // the asynchronous send returns.
     watch_socket_->markReady();
+
+    // Call the socket's asynchronous send, passing our callback
+    socket_->asyncSend(send_callback_->getData(), send_callback_->getPutLen(),
+                       send_callback_->getDataSource().get(), *send_callback_);
 }
 
 void
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -666,6 +666,77 @@ TEST(NameChangeRequestTest, toFromBufferTest) {
     ASSERT_EQ(final_str, msg_str);
 }
 
+/// @brief Tests converting to and from the binary format via isc::util
+/// buffer classes.
+/// This test verifies that all the valid JSON requests survive a binary
+/// round trip and that malformed binary data is rejected.
+TEST(NameChangeRequestTest, toFromBinaryTest) {
+    int num_msgs = sizeof(valid_msgs)/sizeof(char*);
+    for (int i = 0; i < num_msgs; i++) {
+        NameChangeRequestPtr ncr;
+        ASSERT_NO_THROW(ncr = NameChangeRequest::fromJSON(valid_msgs[i]));
+
+        isc::util::OutputBuffer output_buffer(1024);
+        ASSERT_NO_THROW(ncr->toFormat(FMT_BINARY, output_buffer));
+
+        isc::util::InputBuffer input_buffer(output_buffer.getData(),
+                                            output_buffer.getLength());
+        NameChangeRequestPtr ncr2;
+        ASSERT_NO_THROW(ncr2 =
+                        NameChangeRequest::fromFormat(FMT_BINARY, input_buffer))
+            << "Binary round trip failed, message idx: " << i;
+        EXPECT_TRUE(*ncr == *ncr2);
+        EXPECT_EQ(ncr->toJSON(), ncr2->toJSON());
+    }
+
+    NameChangeRequestPtr ncr;
+    ASSERT_NO_THROW(ncr = NameChangeRequest::fromJSON(valid_msgs[0]));
+    isc::util::OutputBuffer output_buffer(1024);
+    ASSERT_NO_THROW(ncr->toFormat(FMT_BINARY, output_buffer));
+    std::vector<uint8_t> data(static_cast<const uint8_t*>(output_buffer.getData()),
+                              static_cast<const uint8_t*>(output_buffer.getData()) +
+                              output_buffer.getLength());
+
+    // Truncated data.
+    isc::util::InputBuffer truncated(data.data(), data.size() - 1);
+    EXPECT_THROW(NameChangeRequest::fromFormat(FMT_BINARY, truncated),
+                 NcrMessageError);
+
+    // Invalid change type, right after the two bytes of length.
+    std::vector<uint8_t> bad_type(data);
+    bad_type[2] = 2;
+    isc::util::InputBuffer bad_type_buffer(bad_type.data(), bad_type.size());
+    EXPECT_THROW(NameChangeRequest::fromFormat(FMT_BINARY, bad_type_buffer),
+                 NcrMessageError);
+
+    // Neither forward nor reverse change.
+    std::vector<uint8_t> bad_flags(data);
+    bad_flags[3] = 0;
+    isc::util::InputBuffer bad_flags_buffer(bad_flags.data(), bad_flags.size());
+    EXPECT_THROW(NameChangeRequest::fromFormat(FMT_BINARY, bad_flags_buffer),
+                 NcrMessageError);
+
+    // Invalid address length.
+    std::vector<uint8_t> bad_addr(data);
+    bad_addr[4] = 5;
+    isc::util::InputBuffer bad_addr_buffer(bad_addr.data(), bad_addr.size());
+    EXPECT_THROW(NameChangeRequest::fromFormat(FMT_BINARY, bad_addr_buffer),
+                 NcrMessageError);
+
+    // Trailing data inside the length.
+    std::vector<uint8_t> trailing(data);
+    trailing.push_back(0);
+    trailing[1] += 1;
+    isc::util::InputBuffer trailing_buffer(trailing.data(), trailing.size());
+    EXPECT_THROW(NameChangeRequest::fromFormat(FMT_BINARY, trailing_buffer),
+                 NcrMessageError);
+
+    // A binary request is not valid JSON.
+    isc::util::InputBuffer json_buffer(data.data(), data.size());
+    EXPECT_THROW(NameChangeRequest::fromFormat(FMT_JSON, json_buffer),
+                 NcrMessageError);
+}
+
 /// @brief Tests ip address modification and validation
 TEST(NameChangeRequestTest, ipAddresses) {
     NameChangeRequest ncr;
@@ -692,9 +763,12 @@ TEST(NameChangeRequestTest, ipAddresses) {
 TEST(NameChangeFormatTest, formatEnumConversion){
     ASSERT_EQ(stringToNcrFormat("JSON"), dhcp_ddns::FMT_JSON);
     ASSERT_EQ(stringToNcrFormat("jSoN"), dhcp_ddns::FMT_JSON);
+    ASSERT_EQ(stringToNcrFormat("BINARY"), dhcp_ddns::FMT_BINARY);
+    ASSERT_EQ(stringToNcrFormat("Binary"), dhcp_ddns::FMT_BINARY);
     ASSERT_THROW(stringToNcrFormat("bogus"), isc::BadValue);
 
     ASSERT_EQ(ncrFormatToString(dhcp_ddns::FMT_JSON), "JSON");
+    ASSERT_EQ(ncrFormatToString(dhcp_ddns::FMT_BINARY), "BINARY");
 }
 
 /// @brief Tests conversion of NameChangeProtocol between enum and strings.
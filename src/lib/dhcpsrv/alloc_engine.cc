@@ -9,6 +9,7 @@
 #include <dhcp/dhcp6.h>
 #include <dhcp/pkt4.h>
 #include <dhcp/pkt6.h>
+#include <dhcp/option6_ia.h>
 #include <dhcp/option_int.h>
 #include <dhcp_ddns/ncr_msg.h>
 #include <dhcpsrv/alloc_engine.h>
@@ -35,10 +36,13 @@
 #include <boost/make_shared.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <limits>
+#include <set>
 #include <sstream>
 #include <stdint.h>
 #include <string.h>
+#include <map>
 #include <utility>
 #include <vector>
 
@@ -91,7 +95,7 @@ namespace isc {
 namespace dhcp {
 
 AllocEngine::AllocEngine(uint64_t attempts)
-    : attempts_(attempts), incomplete_v4_reclamations_(0),
+    : attempts_(attempts), reclamation4_(new Reclamation4(this)),
       incomplete_v6_reclamations_(0) {
 
     // Register hook points
@@ -99,6 +103,12 @@ AllocEngine::AllocEngine(uint64_t attempts)
     hook_index_lease6_select_ = Hooks.hook_index_lease6_select_;
 }
 
+AllocEngine::~AllocEngine() {
+    // Pending parallel reclamation tasks must not use this engine.
+    WriteLockGuard exclusive(reclamation4_->mutex_);
+    reclamation4_->engine_ = 0;
+}
+
 } // end of namespace isc::dhcp
 } // end of namespace isc
 
@@ -174,6 +184,113 @@ inAllowedPool(AllocEngine::ClientContext6& ctx, const Lease::Type& lease_type,
     return (false);
 }
 
+/// @brief Returns the lease of a reserved address or prefix.
+///
+/// The first call for a lease type fetches the leases of all the reserved
+/// addresses or prefixes of this type in the client hosts with a single
+/// lease database call and caches them in the context.
+///
+/// @param ctx Client context holding the client hosts.
+/// @param lease_type Type of the lease.
+/// @param address Reserved IPv6 address or prefix.
+///
+/// @return the lease of the address or prefix, null if it is free.
+Lease6Ptr
+getReservedLease6(AllocEngine::ClientContext6& ctx, const Lease::Type& lease_type,
+                  const IOAddress& address) {
+    auto cached = ctx.reserved_leases_.find(lease_type);
+    if (cached == ctx.reserved_leases_.end()) {
+        IPv6Resrv::Type type = lease_type == Lease::TYPE_NA ?
+            IPv6Resrv::TYPE_NA : IPv6Resrv::TYPE_PD;
+        std::map<IOAddress, Lease6Ptr> leases;
+        std::vector<IOAddress> addresses;
+        for (auto const& host : ctx.hosts_) {
+            if (!host.second) {
+                continue;
+            }
+            const IPv6ResrvRange& reservs = host.second->getIPv6Reservations(type);
+            BOOST_FOREACH(IPv6ResrvTuple type_lease_tuple, reservs) {
+                const IOAddress& addr = type_lease_tuple.second.getPrefix();
+                if (leases.emplace(addr, Lease6Ptr()).second) {
+                    addresses.push_back(addr);
+                }
+            }
+        }
+        Lease6Collection existing = LeaseMgrFactory::instance().
+            getLeases6ByAddresses(lease_type, addresses);
+        for (auto const& lease : existing) {
+            leases[lease->addr_] = lease;
+        }
+        cached = ctx.reserved_leases_.emplace(lease_type, leases).first;
+    }
+
+    auto lease = cached->second.find(address);
+    if (lease == cached->second.end()) {
+        // Not one of the reservations which were fetched.
+        return (LeaseMgrFactory::instance().getLease6(lease_type, address));
+    }
+    return (lease->second);
+}
+
+/// @brief Checks if the leases of the client IAs are fetched at once.
+///
+/// This is worth it when the query holds several IAs, e.g. a CPE asking
+/// for an address and a few prefixes, as long as the IAs have distinct
+/// types or IAIDs.
+///
+/// @param ctx Client context holding the query.
+///
+/// @return true when the leases of the client DUID should be fetched by
+/// a single lease database call.
+bool
+fetchClientLeases6(const AllocEngine::ClientContext6& ctx) {
+    if (!ctx.query_) {
+        return (false);
+    }
+    std::set<std::pair<uint16_t, uint32_t> > ias;
+    for (uint16_t code : { D6O_IA_NA, D6O_IA_PD }) {
+        for (auto const& option : ctx.query_->getOptions(code)) {
+            Option6IAPtr ia = boost::dynamic_pointer_cast<Option6IA>(option.second);
+            if (!ia || !ias.emplace(code, ia->getIAID()).second) {
+                return (false);
+            }
+        }
+    }
+    return (ias.size() > 1);
+}
+
+/// @brief Returns the leases of the current IA of the client.
+///
+/// When the client sent several IAs the leases of its DUID are fetched
+/// by the first call and cached in the context, the next calls filtering
+/// them by lease type and IAID. The leases reused by the previous IAs of
+/// the query are skipped.
+///
+/// @param ctx Client context.
+///
+/// @return the leases of the client IA in all subnets.
+Lease6Collection
+getIALeases6(AllocEngine::ClientContext6& ctx) {
+    const AllocEngine::ClientContext6::IAContext& ia = ctx.currentIA();
+    if (!ctx.client_leases_) {
+        if (!fetchClientLeases6(ctx)) {
+            return (LeaseMgrFactory::instance().getLeases6(ia.type_, *ctx.duid_,
+                                                           ia.iaid_));
+        }
+        ctx.client_leases_.reset(new Lease6Collection(LeaseMgrFactory::instance().
+                                                      getLeases6(*ctx.duid_)));
+    }
+
+    Lease6Collection leases;
+    for (auto const& lease : *ctx.client_leases_) {
+        if ((lease->type_ == ia.type_) && (lease->iaid_ == ia.iaid_) &&
+            !ctx.isAllocated(lease->addr_, lease->prefixlen_)) {
+            leases.push_back(lease);
+        }
+    }
+    return (leases);
+}
+
 }
 
 // ##########################################################################
@@ -401,17 +518,13 @@ AllocEngine::findReservation(ClientContext6& ctx) {
                     ctx.hosts_[subnet->getID()] = host_map[subnet->getID()];
                 }
             } else {
-                for (const IdentifierPair& id_pair : ctx.host_identifiers_) {
-                    // Attempt to find a host using a specified identifier.
-                    ConstHostPtr host = HostMgr::instance().get6(subnet->getID(),
-                                                                 id_pair.first,
-                                                                 &id_pair.second[0],
-                                                                 id_pair.second.size());
-                    // If we found matching host for this subnet.
-                    if (host) {
-                        ctx.hosts_[subnet->getID()] = host;
-                        break;
-                    }
+                // Look for all identifiers at once so the SQL host backends
+                // need a single query.
+                ConstHostPtr host = HostMgr::instance().get6(subnet->getID(),
+                                                             ctx.host_identifiers_);
+                // If we found matching host for this subnet.
+                if (host) {
+                    ctx.hosts_[subnet->getID()] = host;
                 }
             }
         }
@@ -425,19 +538,9 @@ AllocEngine::findReservation(ClientContext6& ctx) {
 
 ConstHostPtr
 AllocEngine::findGlobalReservation(ClientContext6& ctx) {
-    ConstHostPtr host;
-    for (const IdentifierPair& id_pair : ctx.host_identifiers_) {
-        // Attempt to find a host using a specified identifier.
-        host = HostMgr::instance().get6(SUBNET_ID_GLOBAL, id_pair.first,
-                                        &id_pair.second[0], id_pair.second.size());
-
-        // If we found matching global host we're done.
-        if (host) {
-            break;
-        }
-    }
-
-    return (host);
+    // Attempt to find a host using the identifiers in the order of
+    // preference.
+    return (HostMgr::instance().get6(SUBNET_ID_GLOBAL, ctx.host_identifiers_));
 }
 
 Lease6Collection
@@ -454,10 +557,7 @@ AllocEngine::allocateLeases6(ClientContext6& ctx) {
         // Check if there are existing leases for that shared network and
         // DUID/IAID.
         Subnet6Ptr subnet = ctx.subnet_;
-        Lease6Collection all_leases =
-            LeaseMgrFactory::instance().getLeases6(ctx.currentIA().type_,
-                                                   *ctx.duid_,
-                                                   ctx.currentIA().iaid_);
+        Lease6Collection all_leases = getIALeases6(ctx);
 
         // Iterate over the leases and eliminate those that are outside of
         // our shared network.
@@ -992,6 +1092,16 @@ AllocEngine::allocateBestMatch(ClientContext6& ctx,
             continue;
         }
 
+        auto allocator = subnet->getAllocator(ctx.currentIA().type_);
+
+        // The allocators tracking the free leases (e.g. flq) know when
+        // the pools allowed for the client are exhausted. In this case,
+        // move straight to the next subnet rather than asking the allocator
+        // for candidates it does not have.
+        if (allocator->getFreeLeaseCount(classes) == 0) {
+            continue;
+        }
+
         bool in_subnet = subnet->getReservationsInSubnet();
         bool out_of_pool = subnet->getReservationsOutOfPool();
 
@@ -1005,7 +1115,6 @@ AllocEngine::allocateBestMatch(ClientContext6& ctx,
         for (uint64_t i = 0; i < max_attempts; ++i) {
             ++total_attempts;
 
-            auto allocator = subnet->getAllocator(ctx.currentIA().type_);
             IOAddress candidate("::");
 
             // The first step is to find out prefix length. It is 128 for
@@ -1022,6 +1131,14 @@ AllocEngine::allocateBestMatch(ClientContext6& ctx,
                 candidate = allocator->pickAddress(classes, ctx.duid_, hint);
             }
 
+            // The allocators return the zero address when they have no
+            // candidate: stop at once when the pools got exhausted rather
+            // than asking again until the maximum number of attempts.
+            if (candidate.isV6Zero() &&
+                (allocator->getFreeLeaseCount(classes) == 0)) {
+                break;
+            }
+
             // First check for reservation when it is the choice.
             if (check_reservation_first && in_subnet && !out_of_pool) {
                 auto hosts = getIPv6Resrv(subnet->getID(), candidate);
@@ -1215,8 +1332,7 @@ AllocEngine::allocateReservedLeases6(ClientContext6& ctx,
 
             // If there's a lease for this address, let's not create it.
             // It doesn't matter whether it is for this client or for someone else.
-            if (!LeaseMgrFactory::instance().getLease6(ctx.currentIA().type_,
-                                                       addr)) {
+            if (!getReservedLease6(ctx, ctx.currentIA().type_, addr)) {
 
                 // Let's remember the subnet from which the reserved address has been
                 // allocated. We'll use this subnet for allocating other reserved
@@ -1248,6 +1364,9 @@ AllocEngine::allocateReservedLeases6(ClientContext6& ctx,
                 CalloutHandle::CalloutNextStep callout_status = CalloutHandle::NEXT_STEP_CONTINUE;
                 Lease6Ptr lease = createLease6(ctx, addr, prefix_len, callout_status);
 
+                // The reserved resource is no longer free.
+                ctx.reserved_leases_[ctx.currentIA().type_].erase(addr);
+
                 // ... and add it to the existing leases list.
                 existing_leases.push_back(lease);
 
@@ -1344,7 +1463,7 @@ AllocEngine::allocateGlobalReservedLeases6(ClientContext6& ctx,
 
         // If there's a lease for this address, let's not create it.
         // It doesn't matter whether it is for this client or for someone else.
-        if (!LeaseMgrFactory::instance().getLease6(ctx.currentIA().type_, addr)) {
+        if (!getReservedLease6(ctx, ctx.currentIA().type_, addr)) {
 
             // Check the feasibility of this address within this shared-network.
             // Assign the context's subnet accordingly.
@@ -1394,6 +1513,9 @@ AllocEngine::allocateGlobalReservedLeases6(ClientContext6& ctx,
             CalloutHandle::CalloutNextStep callout_status = CalloutHandle::NEXT_STEP_CONTINUE;
             Lease6Ptr lease = createLease6(ctx, addr, prefix_len, callout_status);
 
+            // The reserved resource is no longer free.
+            ctx.reserved_leases_[ctx.currentIA().type_].erase(addr);
+
             // ... and add it to the existing leases list.
             existing_leases.push_back(lease);
 
@@ -1758,17 +1880,12 @@ AllocEngine::reuseExpiredLease(Lease6Ptr& expired, ClientContext6& ctx,
         // If the lease is in the current subnet we need to account
         // for the re-assignment of The lease.
         if (ctx.subnet_->inPool(ctx.currentIA().type_, expired->addr_)) {
-            StatsMgr::instance().addValue(
-                StatsMgr::generateName("subnet", ctx.subnet_->getID(),
-                                       ctx.currentIA().type_ == Lease::TYPE_NA ?
-                                       "assigned-nas" : "assigned-pds"),
-                static_cast<int64_t>(1));
-            StatsMgr::instance().addValue(
-                StatsMgr::generateName("subnet", ctx.subnet_->getID(),
-                                       ctx.currentIA().type_ == Lease::TYPE_NA ?
-                                       "cumulative-assigned-nas" :
-                                       "cumulative-assigned-pds"),
-                static_cast<int64_t>(1));
+            ctx.subnet_->addLeaseStat(ctx.currentIA().type_ == Lease::TYPE_NA ?
+                                      Subnet::STAT_ASSIGNED :
+                                      Subnet::STAT_ASSIGNED_PDS, 1);
+            ctx.subnet_->addLeaseStat(ctx.currentIA().type_ == Lease::TYPE_NA ?
+                                      Subnet::STAT_CUMULATIVE_ASSIGNED :
+                                      Subnet::STAT_CUMULATIVE_ASSIGNED_PDS, 1);
             StatsMgr::instance().addValue(ctx.currentIA().type_ == Lease::TYPE_NA ?
                                           "cumulative-assigned-nas" :
                                           "cumulative-assigned-pds",
@@ -1920,17 +2037,12 @@ Lease6Ptr AllocEngine::createLease6(ClientContext6& ctx,
             // The lease insertion succeeded - if the lease is in the
             // current subnet lets bump up the statistic.
             if (ctx.subnet_->inPool(ctx.currentIA().type_, addr)) {
-                StatsMgr::instance().addValue(
-                    StatsMgr::generateName("subnet", ctx.subnet_->getID(),
-                                           ctx.currentIA().type_ == Lease::TYPE_NA ?
-                                           "assigned-nas" : "assigned-pds"),
-                    static_cast<int64_t>(1));
-                StatsMgr::instance().addValue(
-                    StatsMgr::generateName("subnet", ctx.subnet_->getID(),
-                                           ctx.currentIA().type_ == Lease::TYPE_NA ?
-                                           "cumulative-assigned-nas" :
-                                           "cumulative-assigned-pds"),
-                    static_cast<int64_t>(1));
+                ctx.subnet_->addLeaseStat(ctx.currentIA().type_ == Lease::TYPE_NA ?
+                                          Subnet::STAT_ASSIGNED :
+                                          Subnet::STAT_ASSIGNED_PDS, 1);
+                ctx.subnet_->addLeaseStat(ctx.currentIA().type_ == Lease::TYPE_NA ?
+                                          Subnet::STAT_CUMULATIVE_ASSIGNED :
+                                          Subnet::STAT_CUMULATIVE_ASSIGNED_PDS, 1);
                 StatsMgr::instance().addValue(ctx.currentIA().type_ == Lease::TYPE_NA ?
                                               "cumulative-assigned-nas" :
                                               "cumulative-assigned-pds",
@@ -1971,15 +2083,28 @@ AllocEngine::renewLeases6(ClientContext6& ctx) {
         // Check if there are any leases for this client.
         Subnet6Ptr subnet = ctx.subnet_;
         Lease6Collection leases;
-        while (subnet) {
-            Lease6Collection leases_subnet =
-                LeaseMgrFactory::instance().getLeases6(ctx.currentIA().type_,
-                                                       *ctx.duid_,
-                                                       ctx.currentIA().iaid_,
-                                                       subnet->getID());
-            leases.insert(leases.end(), leases_subnet.begin(), leases_subnet.end());
+        if (fetchClientLeases6(ctx)) {
+            Lease6Collection all_leases = getIALeases6(ctx);
+            while (subnet) {
+                for (auto const& l : all_leases) {
+                    if (l->subnet_id_ == subnet->getID()) {
+                        leases.push_back(l);
+                    }
+                }
 
-            subnet = subnet->getNextSubnet(ctx.subnet_);
+                subnet = subnet->getNextSubnet(ctx.subnet_);
+            }
+        } else {
+            while (subnet) {
+                Lease6Collection leases_subnet =
+                    LeaseMgrFactory::instance().getLeases6(ctx.currentIA().type_,
+                                                           *ctx.duid_,
+                                                           ctx.currentIA().iaid_,
+                                                           subnet->getID());
+                leases.insert(leases.end(), leases_subnet.begin(), leases_subnet.end());
+
+                subnet = subnet->getNextSubnet(ctx.subnet_);
+            }
         }
 
         if (!leases.empty()) {
@@ -2099,9 +2224,7 @@ AllocEngine::extendLease6(ClientContext6& ctx, Lease6Ptr lease) {
         queueNCR(CHG_REMOVE, lease);
 
         // Need to decrease statistic for assigned addresses.
-        StatsMgr::instance().addValue(
-            StatsMgr::generateName("subnet", ctx.subnet_->getID(), "assigned-nas"),
-            static_cast<int64_t>(-1));
+        ctx.subnet_->addLeaseStat(Subnet::STAT_ASSIGNED, -1);
 
         // Add it to the removed leases list.
         ctx.currentIA().old_leases_.push_back(lease);
@@ -2232,17 +2355,12 @@ AllocEngine::extendLease6(ClientContext6& ctx, Lease6Ptr lease) {
         }
 
         if (update_stats) {
-            StatsMgr::instance().addValue(
-                StatsMgr::generateName("subnet", ctx.subnet_->getID(),
-                                       ctx.currentIA().type_ == Lease::TYPE_NA ?
-                                       "assigned-nas" : "assigned-pds"),
-                static_cast<int64_t>(1));
-            StatsMgr::instance().addValue(
-                StatsMgr::generateName("subnet", ctx.subnet_->getID(),
-                                       ctx.currentIA().type_ == Lease::TYPE_NA ?
-                                       "cumulative-assigned-nas" :
-                                       "cumulative-assigned-pds"),
-                static_cast<int64_t>(1));
+            ctx.subnet_->addLeaseStat(ctx.currentIA().type_ == Lease::TYPE_NA ?
+                                      Subnet::STAT_ASSIGNED :
+                                      Subnet::STAT_ASSIGNED_PDS, 1);
+            ctx.subnet_->addLeaseStat(ctx.currentIA().type_ == Lease::TYPE_NA ?
+                                      Subnet::STAT_CUMULATIVE_ASSIGNED :
+                                      Subnet::STAT_CUMULATIVE_ASSIGNED_PDS, 1);
             StatsMgr::instance().addValue(ctx.currentIA().type_ == Lease::TYPE_NA ?
                                           "cumulative-assigned-nas" :
                                           "cumulative-assigned-pds",
@@ -2307,7 +2425,16 @@ AllocEngine::updateLeaseData(ClientContext6& ctx, const Lease6Collection& leases
             }
             if (lease->reuseable_valid_lft_ == 0) {
                 ctx.currentIA().changed_leases_.push_back(*lease_it);
-                LeaseMgrFactory::instance().updateLease6(lease);
+                // The extension of a valid lease can be written
+                // asynchronously: the server waits for the write before
+                // sending the response.
+                LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
+                if (lease_mgr.isAsync() && !update_stats &&
+                    ((*lease_it)->state_ == Lease::STATE_DEFAULT)) {
+                    lease_mgr.updateLease6Async(lease, LeaseMgr::AsyncCallback());
+                } else {
+                    lease_mgr.updateLease6(lease);
+                }
             }
 
             if (update_stats) {
@@ -2502,7 +2629,8 @@ void
 AllocEngine::reclaimExpiredLeases4(const size_t max_leases,
                                    const uint16_t timeout,
                                    const bool remove_lease,
-                                   const uint16_t max_unwarned_cycles) {
+                                   const uint16_t max_unwarned_cycles,
+                                   const bool parallel) {
 
     LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
               ALLOC_ENGINE_V4_LEASES_RECLAMATION_START)
@@ -2511,7 +2639,7 @@ AllocEngine::reclaimExpiredLeases4(const size_t max_leases,
 
     try {
         reclaimExpiredLeases4Internal(max_leases, timeout, remove_lease,
-                                      max_unwarned_cycles);
+                                      max_unwarned_cycles, parallel);
     } catch (const std::exception& ex) {
         LOG_ERROR(alloc_engine_logger,
                   ALLOC_ENGINE_V4_LEASES_RECLAMATION_FAILED)
@@ -2519,11 +2647,108 @@ AllocEngine::reclaimExpiredLeases4(const size_t max_leases,
     }
 }
 
+/// @brief A parallel DHCPv4 lease reclamation cycle.
+///
+/// The cycle is shared by the tasks reclaiming the leases of the subnets.
+/// It ends when the last reference is released i.e. when all the tasks
+/// were run or discarded by the thread pool.
+struct AllocEngine::ReclamationCycle4 {
+    /// @brief Constructor.
+    ///
+    /// @param reclamation The engine reclamation state.
+    /// @param timeout The timeout in milliseconds, 0 for none.
+    /// @param remove_lease Remove the reclaimed leases.
+    /// @param max_unwarned_cycles The number of incomplete reclamations
+    /// after which a warning is issued.
+    /// @param incomplete True when there are more expired leases.
+    ReclamationCycle4(const Reclamation4Ptr& reclamation, uint16_t timeout,
+                      bool remove_lease, uint16_t max_unwarned_cycles,
+                      bool incomplete)
+        : reclamation_(reclamation), stopwatch_(),
+          deadline_(std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(timeout)),
+          timeout_(timeout), remove_lease_(remove_lease),
+          max_unwarned_cycles_(max_unwarned_cycles), processed_(0),
+          incomplete_(incomplete), timed_out_(false) {
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Ends the cycle.
+    ~ReclamationCycle4() {
+        stopwatch_.stop();
+        try {
+            ReadLockGuard share(reclamation_->mutex_);
+            if (reclamation_->engine_) {
+                reclamation_->engine_->finishReclamation4(processed_,
+                                                          incomplete_,
+                                                          stopwatch_.logFormatTotalDuration(),
+                                                          max_unwarned_cycles_);
+            }
+        } catch (...) {
+            // Destructors must not throw.
+        }
+        reclamation_->in_progress_ = false;
+    }
+
+    /// @brief The engine reclamation state.
+    Reclamation4Ptr reclamation_;
+
+    /// @brief The stopwatch measuring the cycle duration.
+    util::Stopwatch stopwatch_;
+
+    /// @brief The time the reclamation must stop at when there is a timeout.
+    std::chrono::steady_clock::time_point deadline_;
+
+    /// @brief The timeout in milliseconds, 0 for none.
+    uint16_t timeout_;
+
+    /// @brief Remove the reclaimed leases.
+    bool remove_lease_;
+
+    /// @brief The number of incomplete reclamations after which a warning
+    /// is issued.
+    uint16_t max_unwarned_cycles_;
+
+    /// @brief The number of reclaimed leases.
+    std::atomic<size_t> processed_;
+
+    /// @brief True when there are still expired leases.
+    std::atomic<bool> incomplete_;
+
+    /// @brief True when the timeout was hit.
+    std::atomic<bool> timed_out_;
+};
+
 void
 AllocEngine::reclaimExpiredLeases4Internal(const size_t max_leases,
                                            const uint16_t timeout,
                                            const bool remove_lease,
-                                           const uint16_t max_unwarned_cycles) {
+                                           const uint16_t max_unwarned_cycles,
+                                           const bool parallel) {
+
+    // The reclamation runs in the packet processing threads when
+    // requested and the thread pool is running.
+    auto& mt_mgr = MultiThreadingMgr::instance();
+    const bool use_pool = parallel && mt_mgr.getMode() &&
+        (mt_mgr.getThreadPool().size() > 0);
+    if (use_pool) {
+        bool expected = false;
+        if (!reclamation4_->in_progress_.compare_exchange_strong(expected, true)) {
+            LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+                      ALLOC_ENGINE_V4_LEASES_RECLAMATION_IN_PROGRESS);
+            return;
+        }
+    }
+
+    // Without callouts to call for each lease the batch is reclaimed at
+    // once by the lease manager.
+    if (!use_pool &&
+        !HooksManager::calloutsPresent(Hooks.hook_index_lease4_expire_) &&
+        !HooksManager::calloutsPresent(Hooks.hook_index_lease4_recover_)) {
+        reclaimExpiredLeases4Bulk(max_leases, remove_lease, max_unwarned_cycles);
+        return;
+    }
 
     // Create stopwatch and automatically start it to measure the time
     // taken by the routine.
@@ -2535,26 +2760,61 @@ AllocEngine::reclaimExpiredLeases4Internal(const size_t max_leases,
     // leases in this pass.
     bool incomplete_reclamation = false;
     Lease4Collection leases;
-    // The value of 0 has a special meaning - reclaim all.
-    if (max_leases > 0) {
-        // If the value is non-zero, the caller has limited the number of
-        // leases to reclaim. We obtain one lease more to see if there will
-        // be still leases left after this pass.
-        lease_mgr.getExpiredLeases4(leases, max_leases + 1);
-        // There are more leases expired leases than we will process in this
-        // pass, so we should mark it as an incomplete reclamation. We also
-        // remove this extra lease (which we don't want to process anyway)
-        // from the collection.
-        if (leases.size() > max_leases) {
-            leases.pop_back();
-            incomplete_reclamation = true;
+    try {
+        // The value of 0 has a special meaning - reclaim all.
+        if (max_leases > 0) {
+            // If the value is non-zero, the caller has limited the number of
+            // leases to reclaim. We obtain one lease more to see if there will
+            // be still leases left after this pass.
+            lease_mgr.getExpiredLeases4(leases, max_leases + 1);
+            // There are more leases expired leases than we will process in this
+            // pass, so we should mark it as an incomplete reclamation. We also
+            // remove this extra lease (which we don't want to process anyway)
+            // from the collection.
+            if (leases.size() > max_leases) {
+                leases.pop_back();
+                incomplete_reclamation = true;
+            }
+
+        } else {
+            // If there is no limitation on the number of leases to reclaim,
+            // we will try to process all. Hence, we don't mark it as incomplete
+            // reclamation just yet.
+            lease_mgr.getExpiredLeases4(leases, max_leases);
+        }
+    } catch (...) {
+        if (use_pool) {
+            reclamation4_->in_progress_ = false;
         }
+        throw;
+    }
 
-    } else {
-        // If there is no limitation on the number of leases to reclaim,
-        // we will try to process all. Hence, we don't mark it as incomplete
-        // reclamation just yet.
-        lease_mgr.getExpiredLeases4(leases, max_leases);
+    if (use_pool) {
+        // Partition the leases by subnet.
+        std::map<SubnetID, boost::shared_ptr<Lease4Collection>> subnets;
+        for (auto const& lease : leases) {
+            auto& subnet_leases = subnets[lease->subnet_id_];
+            if (!subnet_leases) {
+                subnet_leases.reset(new Lease4Collection());
+            }
+            subnet_leases->push_back(lease);
+        }
+
+        // The cycle ends when the last task releases it, or now when
+        // there is no lease to reclaim.
+        ReclamationCycle4Ptr cycle(new ReclamationCycle4(reclamation4_,
+                                                         timeout,
+                                                         remove_lease,
+                                                         max_unwarned_cycles,
+                                                         incomplete_reclamation));
+        for (auto const& subnet : subnets) {
+            auto const& subnet_leases = subnet.second;
+            mt_mgr.getThreadPool().add(
+                boost::make_shared<std::function<void()>>([cycle, subnet_leases]() {
+                    reclaimSubnetLeases4(cycle, *subnet_leases);
+                }));
+        }
+        return;
     }
 
     // Do not initialize the callout handle until we know if there are any
@@ -2610,29 +2870,184 @@ AllocEngine::reclaimExpiredLeases4Internal(const size_t max_leases,
     // Stop measuring the time.
     stopwatch.stop();
 
+    finishReclamation4(leases_processed, incomplete_reclamation,
+                       stopwatch.logFormatTotalDuration(), max_unwarned_cycles);
+}
+
+void
+AllocEngine::reclaimExpiredLeases4Bulk(const size_t max_leases,
+                                       const bool remove_lease,
+                                       const uint16_t max_unwarned_cycles) {
+    // Create stopwatch and automatically start it to measure the time
+    // taken by the routine.
+    util::Stopwatch stopwatch;
+
+    LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
+    Lease4Collection leases;
+    // The subnets are looked up once per batch to update their statistics.
+    ConstCfgSubnets4Ptr subnets =
+        CfgMgr::instance().getCurrentCfg()->getCfgSubnets4();
+    auto reclaim = [&]() {
+        lease_mgr.reclaimExpiredLeases4(leases, max_leases, remove_lease);
+        ConstSubnet4Ptr subnet;
+        for (auto const& lease : leases) {
+            try {
+                LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+                          ALLOC_ENGINE_V4_LEASE_RECLAIM)
+                    .arg(Pkt4::makeLabel(lease->hwaddr_, lease->client_id_))
+                    .arg(lease->addr_.toText());
+
+                // Generate removal name change request for D2, if required.
+                queueNCR(CHG_REMOVE, lease);
+
+                // A declined lease is not kept after its reclamation.
+                if (lease->state_ == Lease::STATE_DECLINED) {
+                    if (reclaimDeclined(lease) && !remove_lease) {
+                        lease_mgr.deleteLease(lease);
+                    }
+                } else {
+                    addLeaseAffinity(lease);
+                }
+            } catch (const std::exception& ex) {
+                LOG_ERROR(alloc_engine_logger, ALLOC_ENGINE_V4_LEASE_RECLAMATION_FAILED)
+                    .arg(lease->addr_.toText())
+                    .arg(ex.what());
+            }
+
+            // Update statistics.
+            StatsMgr::instance().addValue("reclaimed-leases", int64_t(1));
+            if (!subnet || (subnet->getID() != lease->subnet_id_)) {
+                subnet = subnets->getBySubnetId(lease->subnet_id_);
+            }
+            if (subnet) {
+                subnet->addLeaseStat(Subnet::STAT_ASSIGNED, -1);
+                subnet->addLeaseStat(Subnet::STAT_RECLAIMED, 1);
+            } else {
+                StatsMgr::instance().addValue(StatsMgr::generateName("subnet",
+                                                                     lease->subnet_id_,
+                                                                     "assigned-addresses"),
+                                              int64_t(-1));
+                StatsMgr::instance().addValue(StatsMgr::generateName("subnet",
+                                                                     lease->subnet_id_,
+                                                                     "reclaimed-leases"),
+                                              int64_t(1));
+            }
+        }
+    };
+    if (MultiThreadingMgr::instance().getMode()) {
+        // The reclamation is exclusive of packet processing.
+        WriteLockGuard exclusive(rw_mutex_);
+        reclaim();
+    } else {
+        reclaim();
+    }
+
+    // A full batch may leave expired leases.
+    bool incomplete_reclamation = false;
+    if ((max_leases > 0) && (leases.size() >= max_leases)) {
+        Lease4Collection remaining;
+        lease_mgr.getExpiredLeases4(remaining, 1);
+        incomplete_reclamation = !remaining.empty();
+    }
+
+    // Stop measuring the time.
+    stopwatch.stop();
+
+    finishReclamation4(leases.size(), incomplete_reclamation,
+                       stopwatch.logFormatTotalDuration(), max_unwarned_cycles);
+}
+
+void
+AllocEngine::reclaimSubnetLeases4(const ReclamationCycle4Ptr& cycle,
+                                  const Lease4Collection& leases) {
+    // Keep the engine alive while it is used.
+    ReadLockGuard share(cycle->reclamation_->mutex_);
+    AllocEngine* engine = cycle->reclamation_->engine_;
+    if (!engine) {
+        return;
+    }
+
+    // Each task has its own callout handle.
+    CalloutHandlePtr callout_handle;
+    if (HooksManager::calloutsPresent(Hooks.hook_index_lease4_expire_)) {
+        callout_handle = HooksManager::createCalloutHandle();
+    }
+
+    LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
+    for (auto const& lease : leases) {
+        // Always allow reclaiming at least one lease per subnet.
+        if (cycle->timed_out_) {
+            cycle->incomplete_ = true;
+            break;
+        }
+
+        try {
+            // Leave the leases being allocated or renewed to the packet
+            // processing.
+            ResourceHandler4 resource_handler;
+            if (!resource_handler.tryLock4(lease->addr_)) {
+                cycle->incomplete_ = true;
+                continue;
+            }
+
+            // The lease may have been renewed or reused since it was fetched.
+            Lease4Ptr current = lease_mgr.getLease4(lease->addr_);
+            if (current && current->expired() &&
+                !current->stateExpiredReclaimed()) {
+                engine->reclaimExpiredLease(current, cycle->remove_lease_,
+                                            callout_handle);
+                ++cycle->processed_;
+            }
+        } catch (const std::exception& ex) {
+            LOG_ERROR(alloc_engine_logger, ALLOC_ENGINE_V4_LEASE_RECLAMATION_FAILED)
+                .arg(lease->addr_.toText())
+                .arg(ex.what());
+        }
+
+        if ((cycle->timeout_ > 0) &&
+            (std::chrono::steady_clock::now() >= cycle->deadline_)) {
+            if (!cycle->timed_out_.exchange(true)) {
+                LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+                          ALLOC_ENGINE_V4_LEASES_RECLAMATION_TIMEOUT)
+                    .arg(cycle->timeout_);
+            }
+            if (&lease != &leases.back()) {
+                cycle->incomplete_ = true;
+            }
+            break;
+        }
+    }
+}
+
+void
+AllocEngine::finishReclamation4(size_t leases_processed,
+                                bool incomplete_reclamation,
+                                const std::string& duration,
+                                const uint16_t max_unwarned_cycles) {
     // Mark completion of the lease reclamation routine and present some stats.
     LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
               ALLOC_ENGINE_V4_LEASES_RECLAMATION_COMPLETE)
         .arg(leases_processed)
-        .arg(stopwatch.logFormatTotalDuration());
+        .arg(duration);
 
     // Check if this was an incomplete reclamation and increase the number of
     // consecutive incomplete reclamations.
+    uint16_t& incomplete_v4_reclamations = reclamation4_->incomplete_;
     if (incomplete_reclamation) {
-        ++incomplete_v4_reclamations_;
+        ++incomplete_v4_reclamations;
         // If the number of incomplete reclamations is beyond the threshold, we
         // need to issue a warning.
         if ((max_unwarned_cycles > 0) &&
-            (incomplete_v4_reclamations_ > max_unwarned_cycles)) {
+            (incomplete_v4_reclamations > max_unwarned_cycles)) {
             LOG_WARN(alloc_engine_logger, ALLOC_ENGINE_V4_LEASES_RECLAMATION_SLOW)
                 .arg(max_unwarned_cycles);
             // We issued a warning, so let's now reset the counter.
-            incomplete_v4_reclamations_ = 0;
+            incomplete_v4_reclamations = 0;
         }
 
     } else {
         // This was a complete reclamation, so let's reset the counter.
-        incomplete_v4_reclamations_ = 0;
+        incomplete_v4_reclamations = 0;
 
         LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
                   ALLOC_ENGINE_V4_NO_MORE_EXPIRED_LEASES);
@@ -2659,6 +3074,33 @@ AllocEngine::reclaimExpiredLease(const LeasePtrType& lease,
     }
 }
 
+void
+AllocEngine::reclaimExpiredLease(const Lease4Ptr& lease,
+                                 const CalloutHandlePtr& callout_handle) {
+    // This variant of the method is used by the code which allocates or
+    // renews leases. It may be the case that the lease has already been
+    // reclaimed, so there is nothing to do.
+    if (lease->stateExpiredReclaimed()) {
+        return;
+    }
+    ResourceHandler4 resource_handler;
+    if (MultiThreadingMgr::instance().getMode() &&
+        resource_handler.lockOrWait4(lease->addr_)) {
+        // The lease could be being reclaimed in parallel: check it was
+        // not reclaimed meanwhile.
+        Lease4Ptr current = LeaseMgrFactory::instance().getLease4(lease->addr_);
+        if (!current || current->stateExpiredReclaimed()) {
+            // Apply the effects of the reclamation to the lease.
+            lease->hostname_.clear();
+            lease->fqdn_fwd_ = false;
+            lease->fqdn_rev_ = false;
+            lease->state_ = Lease::STATE_EXPIRED_RECLAIMED;
+            return;
+        }
+    }
+    reclaimExpiredLease(lease, DB_RECLAIM_LEAVE_UNCHANGED, callout_handle);
+}
+
 void
 AllocEngine::reclaimExpiredLease(const Lease6Ptr& lease,
                                  const DbReclaimMode& reclaim_mode,
@@ -2816,6 +3258,11 @@ AllocEngine::reclaimExpiredLease(const Lease4Ptr& lease,
             // identifying information anymore.  So we'll flag it for
             // removal unless the hook has set the skip flag.
             remove_lease = reclaimDeclined(lease);
+
+        } else if (reclaim_mode != DB_RECLAIM_LEAVE_UNCHANGED) {
+            // Remember the address for the client returning after the
+            // removal of the reclaimed lease.
+            addLeaseAffinity(lease);
         }
 
         if (reclaim_mode != DB_RECLAIM_LEAVE_UNCHANGED) {
@@ -2846,6 +3293,13 @@ AllocEngine::reclaimExpiredLease(const Lease4Ptr& lease,
                                   int64_t(1));
 }
 
+void
+AllocEngine::addLeaseAffinity(const Lease4Ptr& lease) {
+    uint32_t period = CfgMgr::instance().getCurrentCfg()->
+        getCfgExpiration()->getHoldReclaimedTime();
+    lease_affinity_.add(*lease, std::max(lease->valid_lft_, period));
+}
+
 void
 AllocEngine::deleteExpiredReclaimedLeases4(const uint32_t secs) {
     LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
@@ -2903,6 +3357,8 @@ AllocEngine::reclaimDeclined(const Lease4Ptr& lease) {
         .arg(lease->addr_.toText())
         .arg(lease->valid_lft_);
 
+    decline_probation_.remove(lease->addr_);
+
     StatsMgr& stats_mgr = StatsMgr::instance();
 
     // Decrease subnet specific counter for currently declined addresses
@@ -3207,8 +3663,6 @@ hasAddressReservation(AllocEngine::ClientContext4& ctx) {
 /// @param [out] client_lease A pointer to the lease returned by this function
 /// or null value if no has been lease found.
 void findClientLease(AllocEngine::ClientContext4& ctx, Lease4Ptr& client_lease) {
-    LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
-
     Subnet4Ptr original_subnet = ctx.subnet_;
 
     auto const& classes = ctx.query_->getClasses();
@@ -3223,7 +3677,8 @@ void findClientLease(AllocEngine::ClientContext4& ctx, Lease4Ptr& client_lease)
         // Get all leases for this client identifier. When shared networks are
         // in use it is more efficient to make a single query rather than
         // multiple queries, one for each subnet.
-        Lease4Collection leases_client_id = lease_mgr.getLease4(*ctx.clientid_);
+        // The server may have fetched them already.
+        const Lease4Collection& leases_client_id = ctx.getLeases4ByClientId();
 
         // Iterate over the subnets within the shared network to see if any client's
         // lease belongs to them.
@@ -3251,7 +3706,7 @@ void findClientLease(AllocEngine::ClientContext4& ctx, Lease4Ptr& client_lease)
     if (!client_lease && ctx.hwaddr_) {
 
         // Get all leases for this HW address.
-        Lease4Collection leases_hw_address = lease_mgr.getLease4(*ctx.hwaddr_);
+        const Lease4Collection& leases_hw_address = ctx.getLeases4ByHWAddr();
 
         for (Subnet4Ptr subnet = original_subnet; subnet;
              subnet = subnet->getNextSubnet(original_subnet, classes)) {
@@ -3279,6 +3734,48 @@ void findClientLease(AllocEngine::ClientContext4& ctx, Lease4Ptr& client_lease)
     }
 }
 
+/// @brief Finds the lease of the address requested by a renewing client.
+///
+/// A renewing client requests the address of its lease, so a lookup by
+/// address is enough to find the lease: it is cheaper than the lookups of
+/// all the leases of the client by client identifier and by HW address
+/// done by @c findClientLease.
+///
+/// @param [out] ctx Context holding data extracted from the client's message,
+/// including the requested address. The current subnet may be modified by
+/// this function if it belongs to a shared network.
+/// @param [out] requested_lease A pointer to the lease of the requested
+/// address or null value if the address is not leased.
+/// @return true if the lease of the requested address is not expired,
+/// belongs to the client and to a subnet allowed for the client.
+bool findRequestedLease(AllocEngine::ClientContext4& ctx,
+                        Lease4Ptr& requested_lease) {
+    requested_lease = ctx.getLease4(ctx.requested_address_);
+    if (!requested_lease || requested_lease->expired()) {
+        return (false);
+    }
+
+    Subnet4Ptr original_subnet = ctx.subnet_;
+    auto const& classes = ctx.query_->getClasses();
+
+    for (Subnet4Ptr subnet = original_subnet; subnet;
+         subnet = subnet->getNextSubnet(original_subnet, classes)) {
+        if (requested_lease->subnet_id_ != subnet->getID()) {
+            continue;
+        }
+        ClientIdPtr client_id;
+        if (subnet->getMatchClientId()) {
+            client_id = ctx.clientid_;
+        }
+        if (!requested_lease->belongsToClient(ctx.hwaddr_, client_id)) {
+            return (false);
+        }
+        ctx.subnet_ = subnet;
+        return (true);
+    }
+    return (false);
+}
+
 /// @brief Checks if the specified address belongs to one of the subnets
 /// within a shared network.
 ///
@@ -3326,7 +3823,8 @@ AllocEngine::ClientContext4::ClientContext4()
       hostname_(""), callout_handle_(), fake_allocation_(false), offer_lft_(0),
       old_lease_(), new_lease_(), hosts_(), conflicting_lease_(),
       query_(), host_identifiers_(), unknown_requested_addr_(false),
-      ddns_params_() {
+      ddns_params_(), cached_clientid_(), leases_by_clientid_(),
+      cached_hwaddr_(), leases_by_hwaddr_(), leases_by_address_() {
 
 }
 
@@ -3346,7 +3844,8 @@ AllocEngine::ClientContext4::ClientContext4(const Subnet4Ptr& subnet,
       hostname_(hostname), callout_handle_(),
       fake_allocation_(fake_allocation), offer_lft_(offer_lft), old_lease_(), new_lease_(),
       hosts_(), host_identifiers_(), unknown_requested_addr_(false),
-      ddns_params_(new DdnsParams()) {
+      ddns_params_(new DdnsParams()), cached_clientid_(), leases_by_clientid_(),
+      cached_hwaddr_(), leases_by_hwaddr_(), leases_by_address_() {
 
     // Initialize host identifiers.
     if (hwaddr) {
@@ -3396,6 +3895,50 @@ AllocEngine::ClientContext4::getDdnsParams() {
     return (DdnsParamsPtr(new DdnsParams()));
 }
 
+const Lease4Collection&
+AllocEngine::ClientContext4::getLeases4ByClientId() {
+    if (!clientid_) {
+        leases_by_clientid_.clear();
+        cached_clientid_.reset();
+    } else if (!cached_clientid_ || !(*cached_clientid_ == *clientid_)) {
+        leases_by_clientid_ = LeaseMgrFactory::instance().getLease4(*clientid_);
+        cached_clientid_ = clientid_;
+    }
+    return (leases_by_clientid_);
+}
+
+const Lease4Collection&
+AllocEngine::ClientContext4::getLeases4ByHWAddr() {
+    if (!hwaddr_) {
+        leases_by_hwaddr_.clear();
+        cached_hwaddr_.reset();
+    } else if (!cached_hwaddr_ || !(*cached_hwaddr_ == *hwaddr_)) {
+        leases_by_hwaddr_ = LeaseMgrFactory::instance().getLease4(*hwaddr_);
+        cached_hwaddr_ = hwaddr_;
+    }
+    return (leases_by_hwaddr_);
+}
+
+Lease4Ptr
+AllocEngine::ClientContext4::getLease4(const IOAddress& address) {
+    auto it = leases_by_address_.find(address);
+    if (it != leases_by_address_.end()) {
+        return (it->second);
+    }
+    Lease4Ptr lease = LeaseMgrFactory::instance().getLease4(address);
+    leases_by_address_[address] = lease;
+    return (lease);
+}
+
+void
+AllocEngine::ClientContext4::clearLeaseCache() {
+    cached_clientid_.reset();
+    leases_by_clientid_.clear();
+    cached_hwaddr_.reset();
+    leases_by_hwaddr_.clear();
+    leases_by_address_.clear();
+}
+
 Lease4Ptr
 AllocEngine::allocateLease4(ClientContext4& ctx) {
     // The NULL pointer indicates that the old lease didn't exist. It may
@@ -3415,6 +3958,7 @@ AllocEngine::allocateLease4(ClientContext4& ctx) {
         ctx.subnet_ = subnet->getNextSubnet(subnet, classes);
     }
 
+    Lease4Ptr lease;
     try {
         if (!ctx.subnet_) {
             isc_throw(BadValue, "Can't allocate IPv4 address without subnet");
@@ -3425,9 +3969,10 @@ AllocEngine::allocateLease4(ClientContext4& ctx) {
         }
 
         if (ctx.fake_allocation_) {
-            return (discoverLease4(ctx));
+            lease = discoverLease4(ctx);
         } else {
             ctx.new_lease_ = requestLease4(ctx);
+            lease = ctx.new_lease_;
         }
 
     } catch (const isc::Exception& e) {
@@ -3437,7 +3982,10 @@ AllocEngine::allocateLease4(ClientContext4& ctx) {
             .arg(e.what());
     }
 
-    return (ctx.new_lease_);
+    // The allocation may have changed the leases fetched so far.
+    ctx.clearLeaseCache();
+
+    return (lease);
 }
 
 void
@@ -3514,17 +4062,13 @@ AllocEngine::findReservation(ClientContext4& ctx) {
                     ctx.hosts_[subnet->getID()] = host_map[subnet->getID()];
                 }
             } else {
-                for (const IdentifierPair& id_pair : ctx.host_identifiers_) {
-                    // Attempt to find a host using a specified identifier.
-                    ConstHostPtr host = HostMgr::instance().get4(subnet->getID(),
-                                                                 id_pair.first,
-                                                                 &id_pair.second[0],
-                                                                 id_pair.second.size());
-                    // If we found matching host for this subnet.
-                    if (host) {
-                        ctx.hosts_[subnet->getID()] = host;
-                        break;
-                    }
+                // Look for all identifiers at once so the SQL host backends
+                // need a single query.
+                ConstHostPtr host = HostMgr::instance().get4(subnet->getID(),
+                                                             ctx.host_identifiers_);
+                // If we found matching host for this subnet.
+                if (host) {
+                    ctx.hosts_[subnet->getID()] = host;
                 }
             }
         }
@@ -3538,19 +4082,9 @@ AllocEngine::findReservation(ClientContext4& ctx) {
 
 ConstHostPtr
 AllocEngine::findGlobalReservation(ClientContext4& ctx) {
-    ConstHostPtr host;
-    for (const IdentifierPair& id_pair : ctx.host_identifiers_) {
-        // Attempt to find a host using a specified identifier.
-        host = HostMgr::instance().get4(SUBNET_ID_GLOBAL, id_pair.first,
-                                        &id_pair.second[0], id_pair.second.size());
-
-        // If we found matching global host we're done.
-        if (host) {
-            break;
-        }
-    }
-
-    return (host);
+    // Attempt to find a host using the identifiers in the order of
+    // preference.
+    return (HostMgr::instance().get4(SUBNET_ID_GLOBAL, ctx.host_identifiers_));
 }
 
 Lease4Ptr
@@ -3659,6 +4193,12 @@ AllocEngine::discoverLease4(AllocEngine::ClientContext4& ctx) {
                                           callout_status);
     }
 
+    // The client without lease may have had one which was reclaimed:
+    // try to offer its previous address.
+    if (!new_lease && !client_lease) {
+        new_lease = allocateAffinityLease4(ctx, callout_status);
+    }
+
     // The allocation engine failed to allocate all of the candidate
     // addresses. We will now use the allocator to pick the address
     // from the dynamic pool.
@@ -3684,11 +4224,23 @@ AllocEngine::discoverLease4(AllocEngine::ClientContext4& ctx) {
 
 Lease4Ptr
 AllocEngine::requestLease4(AllocEngine::ClientContext4& ctx) {
+    // When the client renews the lease of the requested address there is
+    // no need to look for all its leases: the lease of the requested
+    // address is the client lease.
+    Lease4Ptr client_lease;
+    Lease4Ptr requested_lease;
+    if (!ctx.requested_address_.isV4Zero()) {
+        if (findRequestedLease(ctx, requested_lease)) {
+            client_lease = requested_lease;
+        }
+    }
+
     // Find an existing lease for this client. This function will return null
     // if there is a conflict with existing lease and the allocation should
     // not be continued.
-    Lease4Ptr client_lease;
-    findClientLease(ctx, client_lease);
+    if (!client_lease) {
+        findClientLease(ctx, client_lease);
+    }
 
     // When the client sends the DHCPREQUEST, it should always specify the
     // address which it is requesting or renewing. That is, the client should
@@ -3725,8 +4277,10 @@ AllocEngine::requestLease4(AllocEngine::ClientContext4& ctx) {
 
     if (!ctx.requested_address_.isV4Zero()) {
         // There is a specific address to be allocated. Let's find out if
-        // the address is in use.
-        Lease4Ptr existing = LeaseMgrFactory::instance().getLease4(ctx.requested_address_);
+        // the address is in use. The context caches the lease of each
+        // address it looked up, so the lease database is queried only the
+        // first time the address is checked for this packet.
+        Lease4Ptr existing = ctx.getLease4(ctx.requested_address_);
         // If the address is in use (allocated and not expired), we check
         // if the address is in use by our client or another client.
         // If it is in use by another client, the address can't be
@@ -3749,8 +4303,7 @@ AllocEngine::requestLease4(AllocEngine::ClientContext4& ctx) {
         // check if the address is in use.
         if (hasAddressReservation(ctx) &&
             (ctx.currentHost()->getIPv4Reservation() != ctx.requested_address_)) {
-            existing =
-                LeaseMgrFactory::instance().getLease4(ctx.currentHost()->getIPv4Reservation());
+            existing = ctx.getLease4(ctx.currentHost()->getIPv4Reservation());
             // If the reserved address is not in use, i.e. the lease doesn't
             // exist or is expired, and the client is requesting a different
             // address, return NULL. The client should go back to the
@@ -3839,8 +4392,15 @@ AllocEngine::requestLease4(AllocEngine::ClientContext4& ctx) {
 
         // We will only get here if the client didn't specify which
         // address it wanted to be allocated. The allocation engine will
-        // to pick the address from the dynamic pool.
-        new_lease = allocateUnreservedLease4(ctx);
+        // to pick the address from the dynamic pool, unless the previous
+        // address of the client without lease is available.
+        if (!client_lease) {
+            CalloutHandle::CalloutNextStep callout_status = CalloutHandle::NEXT_STEP_CONTINUE;
+            new_lease = allocateAffinityLease4(ctx, callout_status);
+        }
+        if (!new_lease) {
+            new_lease = allocateUnreservedLease4(ctx);
+        }
     }
 
     // If we allocated the lease for the client, but the client already had a
@@ -4053,14 +4613,8 @@ AllocEngine::createLease4(const ClientContext4& ctx, const IOAddress& addr,
         if (status) {
 
             // The lease insertion succeeded, let's bump up the statistic.
-            StatsMgr::instance().addValue(
-                StatsMgr::generateName("subnet", ctx.subnet_->getID(),
-                                       "assigned-addresses"),
-                static_cast<int64_t>(1));
-            StatsMgr::instance().addValue(
-                StatsMgr::generateName("subnet", ctx.subnet_->getID(),
-                                       "cumulative-assigned-addresses"),
-                static_cast<int64_t>(1));
+            ctx.subnet_->addLeaseStat(Subnet::STAT_ASSIGNED, 1);
+            ctx.subnet_->addLeaseStat(Subnet::STAT_CUMULATIVE_ASSIGNED, 1);
             StatsMgr::instance().addValue("cumulative-assigned-addresses",
                                           static_cast<int64_t>(1));
 
@@ -4080,6 +4634,82 @@ AllocEngine::createLease4(const ClientContext4& ctx, const IOAddress& addr,
     }
 }
 
+Lease4Ptr
+AllocEngine::addFreeLease4(ClientContext4& ctx) {
+    // The lease is inserted so only for actual allocations.
+    if (ctx.fake_allocation_ && !ctx.offer_lft_) {
+        return (Lease4Ptr());
+    }
+
+    // The callouts must see the candidate addresses.
+    if (ctx.callout_handle_ &&
+        HooksManager::calloutsPresent(hook_index_lease4_select_)) {
+        return (Lease4Ptr());
+    }
+
+    // The addresses reserved in the pools must not be allocated.
+    Subnet4Ptr subnet = ctx.subnet_;
+    if (subnet->getReservationsInSubnet() &&
+        !subnet->getReservationsOutOfPool()) {
+        return (Lease4Ptr());
+    }
+
+    LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
+    if (!lease_mgr.canAddFreeLease4()) {
+        return (Lease4Ptr());
+    }
+
+    if (!ctx.hwaddr_) {
+        isc_throw(BadValue, "Can't create a lease with NULL HW address");
+    }
+
+    // Get the context appropriate lifetime.
+    uint32_t valid_lft = (ctx.offer_lft_ ? ctx.offer_lft_ :  getValidLft(ctx));
+
+    ClientIdPtr client_id;
+    if (subnet->getMatchClientId()) {
+        client_id = ctx.clientid_;
+    }
+
+    auto const& classes = ctx.query_->getClasses();
+    for (auto const& pool : subnet->getPools(Lease::TYPE_V4)) {
+        if (!pool->clientSupported(classes)) {
+            continue;
+        }
+
+        // The address is picked by the lease backend.
+        Lease4Ptr lease(new Lease4(pool->getFirstAddress(), ctx.hwaddr_,
+                                   client_id, valid_lft, time(NULL),
+                                   subnet->getID()));
+
+        // Set FQDN specific lease parameters, see createLease4.
+        if (ctx.fake_allocation_) {
+            lease->fqdn_fwd_ = false;
+            lease->fqdn_rev_ = false;
+        } else {
+            lease->fqdn_fwd_ = ctx.fwd_dns_update_;
+            lease->fqdn_rev_ = ctx.rev_dns_update_;
+        }
+        lease->hostname_ = ctx.hostname_;
+
+        // Add(update) the extended information on the lease.
+        static_cast<void>(updateLease4ExtendedInfo(lease, ctx));
+
+        if (lease_mgr.addFreeLease4(lease, pool->getFirstAddress(),
+                                    pool->getLastAddress())) {
+            // The lease insertion succeeded, let's bump up the statistic.
+            subnet->addLeaseStat(Subnet::STAT_ASSIGNED, 1);
+            subnet->addLeaseStat(Subnet::STAT_CUMULATIVE_ASSIGNED, 1);
+            StatsMgr::instance().addValue("cumulative-assigned-addresses",
+                                          static_cast<int64_t>(1));
+
+            return (lease);
+        }
+    }
+
+    return (Lease4Ptr());
+}
+
 Lease4Ptr
 AllocEngine::renewLease4(const Lease4Ptr& lease,
                          AllocEngine::ClientContext4& ctx) {
@@ -4162,19 +4792,21 @@ AllocEngine::renewLease4(const Lease4Ptr& lease,
     }
 
     if ((!ctx.fake_allocation_ || ctx.offer_lft_) && !skip && (lease->reuseable_valid_lft_ == 0)) {
-        // for REQUEST we do update the lease
-        LeaseMgrFactory::instance().updateLease4(lease);
+        // for REQUEST we do update the lease. The renewal of a valid
+        // lease can be written asynchronously: the server waits for the
+        // write before sending the response.
+        LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
+        if (lease_mgr.isAsync() && !ctx.old_lease_->expired() &&
+            (ctx.old_lease_->state_ == Lease::STATE_DEFAULT)) {
+            lease_mgr.updateLease4Async(lease, LeaseMgr::AsyncCallback());
+        } else {
+            lease_mgr.updateLease4(lease);
+        }
 
         // We need to account for the re-assignment of The lease.
         if (ctx.old_lease_->expired() || ctx.old_lease_->state_ == Lease::STATE_EXPIRED_RECLAIMED) {
-            StatsMgr::instance().addValue(
-                StatsMgr::generateName("subnet", ctx.subnet_->getID(),
-                                       "assigned-addresses"),
-                static_cast<int64_t>(1));
-            StatsMgr::instance().addValue(
-                StatsMgr::generateName("subnet", ctx.subnet_->getID(),
-                                       "cumulative-assigned-addresses"),
-                static_cast<int64_t>(1));
+            ctx.subnet_->addLeaseStat(Subnet::STAT_ASSIGNED, 1);
+            ctx.subnet_->addLeaseStat(Subnet::STAT_CUMULATIVE_ASSIGNED, 1);
             StatsMgr::instance().addValue("cumulative-assigned-addresses",
                                           static_cast<int64_t>(1));
         }
@@ -4273,14 +4905,8 @@ AllocEngine::reuseExpiredLease4(Lease4Ptr& expired,
         LeaseMgrFactory::instance().updateLease4(expired);
 
         // We need to account for the re-assignment of The lease.
-        StatsMgr::instance().addValue(
-                StatsMgr::generateName("subnet", ctx.subnet_->getID(),
-                                       "assigned-addresses"),
-                static_cast<int64_t>(1));
-        StatsMgr::instance().addValue(
-                StatsMgr::generateName("subnet", ctx.subnet_->getID(),
-                                       "cumulative-assigned-addresses"),
-                static_cast<int64_t>(1));
+        ctx.subnet_->addLeaseStat(Subnet::STAT_ASSIGNED, 1);
+        ctx.subnet_->addLeaseStat(Subnet::STAT_CUMULATIVE_ASSIGNED, 1);
         StatsMgr::instance().addValue("cumulative-assigned-addresses",
                                       static_cast<int64_t>(1));
     }
@@ -4298,7 +4924,9 @@ AllocEngine::allocateOrReuseLease4(const IOAddress& candidate, ClientContext4& c
                                    CalloutHandle::CalloutNextStep& callout_status) {
     ctx.conflicting_lease_.reset();
 
-    Lease4Ptr exist_lease = LeaseMgrFactory::instance().getLease4(candidate);
+    // The candidate is the requested or the reserved address which may
+    // have been fetched already.
+    Lease4Ptr exist_lease = ctx.getLease4(candidate);
     if (exist_lease) {
         if (exist_lease->expired()) {
             ctx.old_lease_ = Lease4Ptr(new Lease4(*exist_lease));
@@ -4323,6 +4951,49 @@ AllocEngine::allocateOrReuseLease4(const IOAddress& candidate, ClientContext4& c
     return (Lease4Ptr());
 }
 
+Lease4Ptr
+AllocEngine::allocateAffinityLease4(ClientContext4& ctx,
+                                    CalloutHandle::CalloutNextStep& callout_status) {
+    if (lease_affinity_.size() == 0) {
+        return (Lease4Ptr());
+    }
+
+    // The client identifier is ignored when the subnet does not match it.
+    ClientIdPtr client_id;
+    if (ctx.subnet_->getMatchClientId()) {
+        client_id = ctx.clientid_;
+    }
+    SubnetID subnet_id = 0;
+    IOAddress address = lease_affinity_.get(client_id, ctx.hwaddr_, subnet_id);
+    if (address.isV4Zero()) {
+        return (Lease4Ptr());
+    }
+
+    // The selected subnet is updated by inAllowedPool.
+    Subnet4Ptr subnet = ctx.subnet_;
+    if (!inAllowedPool(ctx, address) || addressReserved(address, ctx)) {
+        ctx.subnet_ = subnet;
+        return (Lease4Ptr());
+    }
+
+    LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+              ALLOC_ENGINE_V4_ALLOC_AFFINITY)
+        .arg(ctx.query_->getLabel())
+        .arg(address.toText())
+        .arg(subnet_id);
+
+    // The address is checked in the lease database: it may have been
+    // assigned to another client.
+    Lease4Ptr new_lease = allocateOrReuseLease4(address, ctx, callout_status);
+    if (!new_lease) {
+        ctx.conflicting_lease_.reset();
+        ctx.subnet_ = subnet;
+    } else if (!ctx.fake_allocation_) {
+        lease_affinity_.remove(client_id, ctx.hwaddr_);
+    }
+    return (new_lease);
+}
+
 Lease4Ptr
 AllocEngine::allocateUnreservedLease4(ClientContext4& ctx) {
     Lease4Ptr new_lease;
@@ -4392,20 +5063,49 @@ AllocEngine::allocateUnreservedLease4(ClientContext4& ctx) {
             ++subnets_with_unavail_pools;
         }
 
+        auto allocator = subnet->getAllocator(Lease::TYPE_V4);
+
+        // The allocators tracking the free leases (e.g. flq) know when
+        // the pools allowed for the client are exhausted. In this case,
+        // move straight to the next subnet rather than asking the allocator
+        // for candidates it does not have. It avoids walking over the
+        // exhausted subnets of a large shared network.
+        if ((max_attempts > 0) && (allocator->getFreeLeaseCount(classes) == 0)) {
+            max_attempts = 0;
+        }
+
         bool exclude_first_last_24 = ((subnet->get().second <= 24) &&
             CfgMgr::instance().getCurrentCfg()->getExcludeFirstLast24());
 
         CalloutHandle::CalloutNextStep callout_status = CalloutHandle::NEXT_STEP_CONTINUE;
 
+        // Let the lease backend pick and insert a free address when it can
+        // do it in a single operation. The regular allocation below still
+        // handles the pools without a free address, e.g. to reuse expired
+        // leases.
+        if ((max_attempts > 0) && !exclude_first_last_24) {
+            new_lease = addFreeLease4(ctx);
+            if (new_lease) {
+                return (new_lease);
+            }
+        }
+
         for (uint64_t i = 0; i < max_attempts; ++i) {
 
             ++total_attempts;
 
-            auto allocator = subnet->getAllocator(Lease::TYPE_V4);
             IOAddress candidate = allocator->pickAddress(classes,
                                                          client_id,
                                                          ctx.requested_address_);
 
+            // The allocators return the zero address when they have no
+            // candidate: stop at once when the pools got exhausted rather
+            // than asking again until the maximum number of attempts.
+            if (candidate.isV4Zero() &&
+                (allocator->getFreeLeaseCount(classes) == 0)) {
+                break;
+            }
+
             if (exclude_first_last_24) {
                 // Exclude .0 and .255 addresses.
                 auto const& bytes = candidate.toBytes();
@@ -4416,6 +5116,19 @@ AllocEngine::allocateUnreservedLease4(ClientContext4& ctx) {
                 }
             }
 
+            // Skip the candidates the allocator knows to be in use
+            // without looking up the lease database.
+            if (allocator->isInUse(candidate)) {
+                // Don't allocate.
+                continue;
+            }
+
+            // Skip the candidates declined by the clients.
+            if (decline_probation_.isOnProbation(candidate)) {
+                // Don't allocate.
+                continue;
+            }
+
             // First check for reservation when it is the choice.
             if (check_reservation_first && addressReserved(candidate, ctx)) {
                 // Don't allocate.
@@ -4503,7 +5216,7 @@ AllocEngine::allocateUnreservedLease4(ClientContext4& ctx) {
                                    "v4-allocation-fail-subnet"),
                                    static_cast<int64_t>(1));
     }
-    if (total_attempts == 0) {
+    if (subnets_with_unavail_leases == 0) {
         // In this case, it seems that none of the pools in the subnets could
         // be used for that client, both in case the client is connected to
         // a shared network or to a single subnet. Apparently, the client was
@@ -4518,9 +5231,9 @@ AllocEngine::allocateUnreservedLease4(ClientContext4& ctx) {
                                    static_cast<int64_t>(1));
     } else {
         // This is an old log message which provides a number of attempts
-        // made by the allocation engine to allocate a lease. The only case
-        // when we don't want to log this message is when the number of
-        // attempts is zero (condition above), because it would look silly.
+        // made by the allocation engine to allocate a lease. The number
+        // of attempts is zero when the allocators reported no free leases
+        // in the pools allowed for the client.
         LOG_WARN(alloc_engine_logger, ALLOC_ENGINE_V4_ALLOC_FAIL)
             .arg(ctx.query_->getLabel())
             .arg(total_attempts);
@@ -4621,7 +5334,7 @@ AllocEngine::updateLease4ExtendedInfo(const Lease4Ptr& lease,
     ElementPtr extended_info = Element::createMap();
     extended_info->set("sub-options", relay_agent);
 
-    OptionPtr remote_id = rai->getOption(RAI_OPTION_REMOTE_ID);
+    OptionPtr remote_id = ctx.query_->getRAISubOption(RAI_OPTION_REMOTE_ID);
     if (remote_id) {
         std::vector<uint8_t> bytes = remote_id->toBinary(false);
         lease->remote_id_ = bytes;
@@ -4631,7 +5344,7 @@ AllocEngine::updateLease4ExtendedInfo(const Lease4Ptr& lease,
         }
     }
 
-    OptionPtr relay_id = rai->getOption(RAI_OPTION_RELAY_ID);
+    OptionPtr relay_id = ctx.query_->getRAISubOption(RAI_OPTION_RELAY_ID);
     if (relay_id) {
         std::vector<uint8_t> bytes = relay_id->toBinary(false);
         lease->relay_id_ = bytes;
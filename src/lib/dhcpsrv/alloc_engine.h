@@ -18,7 +18,9 @@
 #include <dhcp/option6_iaprefix.h>
 #include <dhcpsrv/allocator.h>
 #include <dhcpsrv/d2_client_cfg.h>
+#include <dhcpsrv/decline_probation.h>
 #include <dhcpsrv/host.h>
+#include <dhcpsrv/lease_affinity.h>
 #include <dhcpsrv/subnet.h>
 #include <dhcpsrv/lease_mgr.h>
 #include <dhcpsrv/srv_config.h>
@@ -59,7 +61,10 @@ public:
     AllocEngine(uint64_t attempts);
 
     /// @brief Destructor.
-    virtual ~AllocEngine() { }
+    ///
+    /// Detaches the engine from the pending parallel lease reclamation
+    /// tasks.
+    virtual ~AllocEngine();
 
 private:
 
@@ -287,6 +292,22 @@ public:
         /// @brief A collection of newly allocated leases.
         Lease6Collection new_leases_;
 
+        /// @brief Leases of the reserved addresses and prefixes by lease type.
+        ///
+        /// The reserved addresses or prefixes of a lease type in all the
+        /// client hosts are checked with a single lease database call when
+        /// the first of them is checked. A null lease means that the reserved
+        /// address or prefix is free.
+        std::map<Lease::Type, std::map<asiolink::IOAddress, Lease6Ptr> > reserved_leases_;
+
+        /// @brief Leases of the client DUID.
+        ///
+        /// When the client sends several IAs all its leases are fetched
+        /// with a single lease database call when the first IA is
+        /// processed, and the leases of each IA are taken from them.
+        /// Null until fetched.
+        boost::shared_ptr<Lease6Collection> client_leases_;
+
         //@}
 
         /// @brief Parameters pertaining to individual IAs.
@@ -412,6 +433,16 @@ public:
             host_identifiers_.push_back(IdentifierPair(id_type, identifier));
         }
 
+        /// @brief Convenience function moving host identifier into
+        /// @ref host_identifiers_ list.
+        ///
+        /// @param id_type Identifier type.
+        /// @param identifier Identifier value, left empty.
+        void addHostIdentifier(const Host::IdentifierType& id_type,
+                               std::vector<uint8_t>&& identifier) {
+            host_identifiers_.emplace_back(id_type, std::move(identifier));
+        }
+
         /// @brief Returns IA specific context for the currently processed IA.
         ///
         /// If IA specific context doesn't exist, it is created.
@@ -725,9 +756,18 @@ public:
     /// of expired leases, after which the system issues a warning if there
     /// are still expired leases in the database. If this value is 0, the
     /// warning is never issued.
+    /// @param parallel When true and the multi-threading thread pool is
+    /// running, the leases are reclaimed by the packet processing threads
+    /// concurrently with packet processing: the leases are partitioned by
+    /// subnet, each subnet is reclaimed by a task and the method returns
+    /// without waiting for the tasks. Each lease is protected by the
+    /// resource handler instead of the read-write mutex and a lease in use
+    /// is left to the next cycle. A cycle is skipped when the previous one
+    /// is still running.
     void reclaimExpiredLeases4(const size_t max_leases, const uint16_t timeout,
                                const bool remove_lease,
-                               const uint16_t max_unwarned_cycles = 0);
+                               const uint16_t max_unwarned_cycles = 0,
+                               const bool parallel = false);
 
     /// @brief Body of reclaimExpiredLeases4.
     ///
@@ -741,10 +781,13 @@ public:
     /// of expired leases, after which the system issues a warning if there
     /// are still expired leases in the database. If this value is 0, the
     /// warning is never issued.
+    /// @param parallel Reclaim the leases in parallel with packet
+    /// processing.
     void reclaimExpiredLeases4Internal(const size_t max_leases,
                                        const uint16_t timeout,
                                        const bool remove_lease,
-                                       const uint16_t max_unwarned_cycles = 0);
+                                       const uint16_t max_unwarned_cycles = 0,
+                                       const bool parallel = false);
 
     /// @brief Deletes reclaimed leases expired more than specified amount
     /// of time ago.
@@ -1124,6 +1167,17 @@ private:
     void reclaimExpiredLease(const LeasePtrType& lease,
                              const hooks::CalloutHandlePtr& callout_handle);
 
+    /// @brief Reclaim DHCPv4 lease without updating lease database.
+    ///
+    /// Variant of the previous method for DHCPv4. With multi-threading it
+    /// waits for the lease to be released by the parallel reclamation and
+    /// does nothing when the lease was reclaimed meanwhile.
+    ///
+    /// @param lease Pointer to the DHCPv4 lease.
+    /// @param callout_handle Pointer to the callout handle.
+    void reclaimExpiredLease(const Lease4Ptr& lease,
+                             const hooks::CalloutHandlePtr& callout_handle);
+
     /// @brief Reclaim DHCPv6 lease.
     ///
     /// This method variant accepts the @c reclaim_mode parameter which
@@ -1190,6 +1244,15 @@ private:
     ///         to keep it)
     bool reclaimDeclined(const Lease4Ptr& lease);
 
+    /// @brief Remembers the address of a reclaimed IPv4 lease for the
+    /// lease affinity.
+    ///
+    /// The address is remembered for the valid lifetime of the lease or
+    /// for the @c hold-reclaimed-time if it is longer.
+    ///
+    /// @param lease the reclaimed lease.
+    void addLeaseAffinity(const Lease4Ptr& lease);
+
     /// @anchor reclaimDeclinedLease6
     /// @brief Conducts steps necessary for reclaiming declined IPv6 lease.
     ///
@@ -1324,6 +1387,16 @@ public:
             host_identifiers_.push_back(IdentifierPair(id_type, identifier));
         }
 
+        /// @brief Convenience function moving host identifier into
+        /// @ref host_identifiers_ list.
+        ///
+        /// @param id_type Identifier type.
+        /// @param identifier Identifier value, left empty.
+        void addHostIdentifier(const Host::IdentifierType& id_type,
+                               std::vector<uint8_t>&& identifier) {
+            host_identifiers_.emplace_back(id_type, std::move(identifier));
+        }
+
         /// @brief Returns host for currently selected subnet.
         ///
         /// If there is no such host and global reservations are enabled
@@ -1342,6 +1415,41 @@ public:
         /// @return Pointer to the host object.
         ConstHostPtr globalHost() const;
 
+        /// @brief Returns the leases of the client identifier.
+        ///
+        /// The leases are fetched from the lease database at the first
+        /// call and kept in the context until @c clearLeaseCache is
+        /// called, so the server and the allocation engine make the
+        /// lookup once per packet exchange.
+        ///
+        /// @return The leases of the client identifier or an empty
+        /// collection when the context has no client identifier.
+        const Lease4Collection& getLeases4ByClientId();
+
+        /// @brief Returns the leases of the HW address.
+        ///
+        /// The leases are cached as by @c getLeases4ByClientId.
+        ///
+        /// @return The leases of the HW address or an empty collection
+        /// when the context has no HW address.
+        const Lease4Collection& getLeases4ByHWAddr();
+
+        /// @brief Returns the lease of an address.
+        ///
+        /// The lease is cached as by @c getLeases4ByClientId, including
+        /// the absence of a lease. It is the same object as the lease
+        /// returned by a previous call for the address.
+        ///
+        /// @param address The address.
+        /// @return The lease or null when the address is not leased.
+        Lease4Ptr getLease4(const asiolink::IOAddress& address);
+
+        /// @brief Forgets the leases fetched from the lease database.
+        ///
+        /// Called when the leases of the client may have changed, e.g.
+        /// at the end of the allocation.
+        void clearLeaseCache();
+
         /// @brief Default constructor.
         ClientContext4();
 
@@ -1372,6 +1480,24 @@ public:
             /// subnet.  Set by the first call to getDdnsParams() made when
             /// the context has a selected subnet (i.e. subnet_ is not empty).
             DdnsParamsPtr ddns_params_;
+
+            /// @brief Client identifier of the cached leases by client
+            /// identifier, null when they were not fetched.
+            ClientIdPtr cached_clientid_;
+
+            /// @brief Cached leases by client identifier.
+            Lease4Collection leases_by_clientid_;
+
+            /// @brief HW address of the cached leases by HW address, null
+            /// when they were not fetched.
+            HWAddrPtr cached_hwaddr_;
+
+            /// @brief Cached leases by HW address.
+            Lease4Collection leases_by_hwaddr_;
+
+            /// @brief Cached leases by address, null when the address is
+            /// not leased.
+            std::map<asiolink::IOAddress, Lease4Ptr> leases_by_address_;
     };
 
     /// @brief Pointer to the @c ClientContext4.
@@ -1724,6 +1850,38 @@ private:
     /// was not successful.
     Lease4Ptr allocateUnreservedLease4(ClientContext4& ctx);
 
+    /// @brief Allocates the previous address of a client without lease.
+    ///
+    /// The previous address is taken from the index of the reclaimed
+    /// leases. It is allocated when it is in a pool allowed for the
+    /// client, is not reserved and has no valid lease.
+    ///
+    /// @param ctx Client context holding the data extracted from the
+    /// client's message.
+    /// @param [out] callout_status callout returned by the lease4_select
+    ///
+    /// @return A pointer to the allocated lease or NULL if the allocation
+    /// was not successful.
+    Lease4Ptr
+    allocateAffinityLease4(ClientContext4& ctx,
+                           hooks::CalloutHandle::CalloutNextStep& callout_status);
+
+    /// @brief Allocates a free lease of the subnet pools in one operation.
+    ///
+    /// When the lease backend supports it (see @c LeaseMgr::addFreeLease4)
+    /// the lease is inserted by the backend for the lowest address without
+    /// a lease of the first pool allowed for the client which has one.
+    /// It skips the lookups made for each candidate, so it is used only for
+    /// the actual allocations when no lease4_select callout and no in-pool
+    /// reservation have to see the candidates.
+    ///
+    /// @param ctx Client context holding the data extracted from the
+    /// client's message.
+    ///
+    /// @return A pointer to the allocated lease or null when the backend
+    /// did not allocate it: the caller must use the regular allocation.
+    Lease4Ptr addFreeLease4(ClientContext4& ctx);
+
     /// @brief Updates the specified lease with the information from a context.
     ///
     /// The context, specified as an argument to this method, holds various
@@ -1835,9 +1993,81 @@ private:
 
 private:
 
-    /// @brief Number of consecutive DHCPv4 leases' reclamations after
-    /// which there are still expired leases in the database.
-    uint16_t incomplete_v4_reclamations_;
+    /// @brief State of the DHCPv4 lease reclamation shared with the
+    /// parallel reclamation tasks.
+    struct Reclamation4 {
+        /// @brief Constructor.
+        ///
+        /// @param engine The engine.
+        Reclamation4(AllocEngine* engine)
+            : engine_(engine), in_progress_(false), incomplete_(0) {
+        }
+
+        /// @brief The engine, null once it was destroyed.
+        AllocEngine* engine_;
+
+        /// @brief Mutex protecting the engine pointer: the tasks hold it
+        /// for reading while they use the engine.
+        isc::util::ReadWriteMutex mutex_;
+
+        /// @brief True when a parallel reclamation is in progress.
+        std::atomic<bool> in_progress_;
+
+        /// @brief Number of consecutive DHCPv4 leases' reclamations after
+        /// which there are still expired leases in the database.
+        uint16_t incomplete_;
+    };
+
+    /// @brief Type of pointers to the DHCPv4 lease reclamation state.
+    typedef boost::shared_ptr<Reclamation4> Reclamation4Ptr;
+
+    /// @brief A parallel DHCPv4 lease reclamation cycle.
+    struct ReclamationCycle4;
+
+    /// @brief Type of pointers to parallel DHCPv4 lease reclamation cycles.
+    typedef boost::shared_ptr<ReclamationCycle4> ReclamationCycle4Ptr;
+
+    /// @brief Reclaims the expired leases of a subnet.
+    ///
+    /// Body of the parallel DHCPv4 lease reclamation tasks.
+    ///
+    /// @param cycle The reclamation cycle.
+    /// @param leases The expired leases of the subnet.
+    static void reclaimSubnetLeases4(const ReclamationCycle4Ptr& cycle,
+                                     const Lease4Collection& leases);
+
+    /// @brief Reclaims a batch of expired DHCPv4 leases at once.
+    ///
+    /// Used when no lease4_expire nor lease4_recover callouts are
+    /// installed: the lease manager reclaims the batch in the database
+    /// and the engine then removes the DNS entries, removes the declined
+    /// leases and updates the statistics of the reclaimed leases.
+    ///
+    /// @param max_leases Maximum number of leases to be reclaimed, 0 for
+    /// all.
+    /// @param remove_lease Delete the leases rather than setting their state
+    /// to expired-reclaimed.
+    /// @param max_unwarned_cycles The number of incomplete reclamations after
+    /// which a warning is issued, 0 for never.
+    void reclaimExpiredLeases4Bulk(const size_t max_leases,
+                                   const bool remove_lease,
+                                   const uint16_t max_unwarned_cycles);
+
+    /// @brief Logs the end of a DHCPv4 lease reclamation and counts the
+    /// incomplete reclamations.
+    ///
+    /// @param leases_processed The number of reclaimed leases.
+    /// @param incomplete_reclamation True if there are still expired leases.
+    /// @param duration The duration of the reclamation.
+    /// @param max_unwarned_cycles The number of incomplete reclamations after
+    /// which a warning is issued, 0 for never.
+    void finishReclamation4(size_t leases_processed,
+                            bool incomplete_reclamation,
+                            const std::string& duration,
+                            const uint16_t max_unwarned_cycles);
+
+    /// @brief The DHCPv4 lease reclamation state.
+    Reclamation4Ptr reclamation4_;
 
     /// @brief Number of consecutive DHCPv6 leases' reclamations after
     /// which there are still expired leases in the database.
@@ -1857,6 +2087,33 @@ public:
     /// @brief The read-write mutex.
     isc::util::ReadWriteMutex rw_mutex_;
 
+    /// @brief Returns the table of the addresses on decline probation.
+    ///
+    /// The DHCPv4 server puts the declined addresses in the table, the
+    /// allocation engine skips them when looking for a free address and
+    /// removes them when their declined lease is reclaimed.
+    ///
+    /// @return A reference to the table.
+    DeclineProbation& getDeclineProbation() {
+        return (decline_probation_);
+    }
+
+    /// @brief The addresses on decline probation.
+    DeclineProbation decline_probation_;
+
+    /// @brief Returns the index of the reclaimed IPv4 leases.
+    ///
+    /// The allocation engine adds the reclaimed leases to the index and
+    /// offers their previous address to the returning clients.
+    ///
+    /// @return A reference to the index.
+    LeaseAffinity4& getLeaseAffinity() {
+        return (lease_affinity_);
+    }
+
+    /// @brief The index of the reclaimed IPv4 leases.
+    LeaseAffinity4 lease_affinity_;
+
     /// @brief Generates a label for subnet or shared-network from subnet
     ///
     /// Creates a string for the subnet and its ID for stand alone subnets
@@ -8,8 +8,17 @@
 #include <dhcpsrv/allocator.h>
 #include <dhcpsrv/lease_mgr_factory.h>
 #include <dhcpsrv/dhcpsrv_log.h>
+#include <dhcpsrv/subnet.h>
 
+using namespace isc::asiolink;
 using namespace isc::util;
+using namespace std;
+
+namespace {
+/// @brief An owner string used in the callbacks installed in
+/// the lease manager.
+const string OCCUPANCY_OWNER = "occupancy";
+}
 
 namespace isc {
 namespace dhcp {
@@ -65,6 +74,29 @@ Allocator::isValidPrefixPool(Allocator::PrefixLenMatchType prefix_length_match,
     return (true);
 }
 
+uint64_t
+Allocator::getFreeLeaseCountInternal(const ClientClasses& client_classes) const {
+    auto subnet = subnet_.lock();
+    if (!subnet) {
+        return (0);
+    }
+    return (subnet->getPoolCapacity(pool_type_, client_classes));
+}
+
+size_t
+Allocator::compact(double threshold) {
+    auto subnet = subnet_.lock();
+    if (!subnet) {
+        return (0);
+    }
+    size_t released = 0;
+    for (auto const& pool : subnet->getPools(pool_type_)) {
+        MultiThreadingLock lock(mutex_);
+        released += compactInternal(pool, threshold);
+    }
+    return (released);
+}
+
 void
 Allocator::initAfterConfigure() {
     if (inited_) {
@@ -79,5 +111,123 @@ Allocator::initAfterConfigure() {
     inited_ = true;
 }
 
+void
+Allocator::initOccupancyFilter() {
+    if ((pool_type_ != Lease::TYPE_V4) || !LeaseMgrFactory::haveInstance()) {
+        return;
+    }
+    auto& lease_mgr = LeaseMgrFactory::instance();
+    auto subnet = subnet_.lock();
+    auto pools = subnet->getPools(pool_type_);
+    if (pools.empty()) {
+        return;
+    }
+    occupancy_.clear();
+    for (auto const& pool : pools) {
+        auto occupancy = PoolBitmapAllocationState::create(pool);
+        occupancy->addAllFreeLeases();
+        occupancy_[pool] = occupancy;
+    }
+    for (auto const& lease : lease_mgr.getLeases4(subnet->getID())) {
+        if (!lease->expired() && !lease->stateExpiredReclaimed()) {
+            auto occupancy = getOccupancy(lease);
+            if (occupancy) {
+                occupancy->deleteFreeLease(lease->addr_);
+            }
+        }
+    }
+    lease_mgr.registerCallback(TrackingLeaseMgr::TRACK_ADD_LEASE, OCCUPANCY_OWNER,
+                               subnet->getID(), pool_type_,
+                               std::bind(&Allocator::occupancyAddLeaseCallback, this,
+                                         std::placeholders::_1,
+                                         std::placeholders::_2));
+    lease_mgr.registerCallback(TrackingLeaseMgr::TRACK_UPDATE_LEASE, OCCUPANCY_OWNER,
+                               subnet->getID(), pool_type_,
+                               std::bind(&Allocator::occupancyUpdateLeaseCallback, this,
+                                         std::placeholders::_1,
+                                         std::placeholders::_2));
+    lease_mgr.registerCallback(TrackingLeaseMgr::TRACK_DELETE_LEASE, OCCUPANCY_OWNER,
+                               subnet->getID(), pool_type_,
+                               std::bind(&Allocator::occupancyDeleteLeaseCallback, this,
+                                         std::placeholders::_1,
+                                         std::placeholders::_2));
+}
+
+bool
+Allocator::isInUseInternal(const IOAddress& address) const {
+    auto subnet = subnet_.lock();
+    if (!subnet) {
+        return (false);
+    }
+    auto pool = subnet->getPool(pool_type_, address, false);
+    if (!pool) {
+        return (false);
+    }
+    auto occupancy = occupancy_.find(pool);
+    if (occupancy == occupancy_.end()) {
+        return (false);
+    }
+    return (!occupancy->second->isFreeLease(address));
+}
+
+PoolBitmapAllocationStatePtr
+Allocator::getOccupancy(const LeasePtr& lease) const {
+    auto subnet = subnet_.lock();
+    if (!subnet) {
+        return (PoolBitmapAllocationStatePtr());
+    }
+    auto pool = subnet->getPool(pool_type_, lease->addr_, false);
+    if (!pool) {
+        return (PoolBitmapAllocationStatePtr());
+    }
+    auto occupancy = occupancy_.find(pool);
+    if (occupancy == occupancy_.end()) {
+        return (PoolBitmapAllocationStatePtr());
+    }
+    return (occupancy->second);
+}
+
+void
+Allocator::occupancyAddLeaseCallback(LeasePtr lease, bool mt_safe) {
+    if (lease->expired()) {
+        return;
+    }
+    updateOccupancy(lease, false, mt_safe);
+}
+
+void
+Allocator::occupancyUpdateLeaseCallback(LeasePtr lease, bool mt_safe) {
+    updateOccupancy(lease, lease->stateExpiredReclaimed() || lease->expired(),
+                    mt_safe);
+}
+
+void
+Allocator::occupancyDeleteLeaseCallback(LeasePtr lease, bool mt_safe) {
+    updateOccupancy(lease, true, mt_safe);
+}
+
+void
+Allocator::updateOccupancy(const LeasePtr& lease, bool free, bool mt_safe) {
+    if (!mt_safe) {
+        MultiThreadingLock lock(mutex_);
+        updateOccupancyInternal(lease, free);
+        return;
+    }
+    updateOccupancyInternal(lease, free);
+}
+
+void
+Allocator::updateOccupancyInternal(const LeasePtr& lease, bool free) {
+    auto occupancy = getOccupancy(lease);
+    if (!occupancy) {
+        return;
+    }
+    if (free) {
+        occupancy->addFreeLease(lease->addr_);
+    } else {
+        occupancy->deleteFreeLease(lease->addr_);
+    }
+}
+
 }
 }
@@ -11,12 +11,14 @@
 #include <dhcp/classify.h>
 #include <dhcp/duid.h>
 #include <exceptions/exceptions.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
 #include <dhcpsrv/lease.h>
 #include <dhcpsrv/subnet_id.h>
 #include <dhcpsrv/pool.h>
 #include <util/multi_threading_mgr.h>
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
+#include <map>
 #include <mutex>
 
 namespace isc {
@@ -140,6 +142,63 @@ public:
                                    hint_prefix_length));
     }
 
+    /// @brief Returns the number of free leases in the pools allowed for
+    /// the client classes.
+    ///
+    /// The allocation engine uses this number to skip the subnets of a
+    /// shared network which have no free leases for the client rather than
+    /// walking over their pools. The allocators which don't track the free
+    /// leases return the capacity of the pools, i.e. an upper bound.
+    ///
+    /// @param client_classes list of classes client belongs to.
+    ///
+    /// @return the number of free leases or its upper bound.
+    uint64_t getFreeLeaseCount(const ClientClasses& client_classes) {
+        util::MultiThreadingLock lock(mutex_);
+        return (getFreeLeaseCountInternal(client_classes));
+    }
+
+    /// @brief Checks if an address is known to be in use.
+    ///
+    /// The allocation engine uses this function to skip the candidates
+    /// known to be in use without looking up the lease database. The
+    /// allocators maintaining an occupancy filter (see
+    /// @c initOccupancyFilter) return true for the addresses of the valid
+    /// leases. Other allocators always return false.
+    ///
+    /// @param address candidate address.
+    ///
+    /// @return true if the address is known to be in use, false otherwise.
+    bool isInUse(const asiolink::IOAddress& address) {
+        if (occupancy_.empty()) {
+            return (false);
+        }
+        util::MultiThreadingLock lock(mutex_);
+        return (isInUseInternal(address));
+    }
+
+    /// @brief Returns an estimate of the memory used by the allocation
+    /// state of a pool.
+    ///
+    /// @param pool pool of the subnet owning the allocator.
+    ///
+    /// @return the memory used in bytes, 0 when not known.
+    size_t getMemoryUsage(const PoolPtr& pool) {
+        util::MultiThreadingLock lock(mutex_);
+        return (getMemoryUsageInternal(pool));
+    }
+
+    /// @brief Compacts the allocation states of the fragmented pools.
+    ///
+    /// Each pool is compacted in its own critical section so the
+    /// allocations are not blocked for the whole subnet.
+    ///
+    /// @param threshold fragmentation, between 0 and 1, above which the
+    /// allocation state of a pool is compacted.
+    ///
+    /// @return the estimated number of released bytes.
+    size_t compact(double threshold);
+
     /// @brief Check if the pool matches the selection criteria relative to the
     /// provided hint prefix length.
     ///
@@ -163,6 +222,21 @@ public:
     /// In this function, the allocators can also re-build their allocation states.
     void initAfterConfigure();
 
+    /// @brief Checks if the allocation states can be reused.
+    ///
+    /// After a reconfiguration the allocation states of an unchanged
+    /// subnet and its pools can be moved to the new subnet instance. The
+    /// allocators which rebuild their states from the lease database in
+    /// @c initAfterConfigure can only reuse them when the recreated lease
+    /// manager uses the same lease database.
+    ///
+    /// @param same_leases true when the lease database is the same as in
+    /// the previous configuration.
+    /// @return true when the allocation states can be reused.
+    virtual bool canReuseStates(bool same_leases) const {
+        return (true);
+    }
+
 protected:
 
     /// @brief Allocator-specific initialization function.
@@ -171,6 +245,20 @@ protected:
     /// derived allocators.
     virtual void initAfterConfigureInternal() {};
 
+    /// @brief Populates the occupancy filter of the IPv4 pools.
+    ///
+    /// The occupancy filter is a bitmap per pool tracking the addresses of
+    /// the valid leases. It is populated from the lease database and kept
+    /// up to date by the callbacks installed in the lease manager. It makes
+    /// sense for the allocators returning candidates which can be in use,
+    /// i.e. the iterative and random allocators, when the lease database
+    /// lookups are costly, i.e. for the SQL backends. It does nothing for
+    /// the lease types other than @c Lease::TYPE_V4.
+    ///
+    /// The addresses of the leases expiring without being reclaimed remain
+    /// in use for the filter until these leases are reclaimed.
+    void initOccupancyFilter();
+
 private:
 
     /// @brief Picks an address.
@@ -189,6 +277,45 @@ private:
                         const DuidPtr& duid,
                         const isc::asiolink::IOAddress& hint) = 0;
 
+    /// @brief Returns the number of free leases in the pools allowed for
+    /// the client classes.
+    ///
+    /// Internal thread-unsafe implementation of the @c getFreeLeaseCount.
+    /// The default implementation returns the capacity of the pools.
+    ///
+    /// @param client_classes list of classes client belongs to.
+    ///
+    /// @return the number of free leases or its upper bound.
+    virtual uint64_t
+    getFreeLeaseCountInternal(const ClientClasses& client_classes) const;
+
+    /// @brief Returns an estimate of the memory used by the allocation
+    /// state of a pool.
+    ///
+    /// Internal thread-unsafe implementation of the @c getMemoryUsage.
+    /// The default implementation returns 0.
+    ///
+    /// @param pool pool of the subnet owning the allocator.
+    ///
+    /// @return the memory used in bytes.
+    virtual size_t getMemoryUsageInternal(const PoolPtr& /* pool */) const {
+        return (0);
+    }
+
+    /// @brief Compacts the allocation state of a pool when it is fragmented.
+    ///
+    /// Internal thread-unsafe implementation of the @c compact for a pool.
+    /// The default implementation does nothing.
+    ///
+    /// @param pool pool of the subnet owning the allocator.
+    /// @param threshold fragmentation above which the state is compacted.
+    ///
+    /// @return the estimated number of released bytes.
+    virtual size_t compactInternal(const PoolPtr& /* pool */,
+                                   double /* threshold */) {
+        return (0);
+    }
+
     /// @brief Picks a delegated prefix.
     ///
     /// Internal thread-unsafe implementation of the @c pickPrefix.
@@ -214,6 +341,66 @@ private:
                        const isc::asiolink::IOAddress& hint,
                        uint8_t hint_prefix_length) = 0;
 
+    /// @brief Checks if an address is known to be in use.
+    ///
+    /// Internal thread-unsafe implementation of the @c isInUse.
+    ///
+    /// @param address candidate address.
+    ///
+    /// @return true if the address is in use for the occupancy filter.
+    bool isInUseInternal(const asiolink::IOAddress& address) const;
+
+    /// @brief Returns the occupancy filter of the pool a lease belongs to.
+    ///
+    /// @param lease lease instance.
+    /// @return the occupancy filter or null pointer if the lease does not
+    /// belong to a pool with a filter.
+    PoolBitmapAllocationStatePtr getOccupancy(const LeasePtr& lease) const;
+
+    /// @brief Callback for adding a lease to the occupancy filter.
+    ///
+    /// Marks the lease address in use unless the lease is expired.
+    ///
+    /// @param lease added lease.
+    /// @param mt_safe a boolean flag indicating if the callback
+    /// has been invoked in the MT-safe context.
+    void occupancyAddLeaseCallback(LeasePtr lease, bool mt_safe);
+
+    /// @brief Callback for updating a lease in the occupancy filter.
+    ///
+    /// Marks the lease address free if the lease is reclaimed or expired.
+    /// Otherwise it is marked in use.
+    ///
+    /// @param lease updated lease.
+    /// @param mt_safe a boolean flag indicating if the callback
+    /// has been invoked in the MT-safe context.
+    void occupancyUpdateLeaseCallback(LeasePtr lease, bool mt_safe);
+
+    /// @brief Callback for deleting a lease from the occupancy filter.
+    ///
+    /// Marks the lease address free.
+    ///
+    /// @param lease deleted lease.
+    /// @param mt_safe a boolean flag indicating if the callback
+    /// has been invoked in the MT-safe context.
+    void occupancyDeleteLeaseCallback(LeasePtr lease, bool mt_safe);
+
+    /// @brief Thread safe update of the occupancy filter.
+    ///
+    /// @param lease lease instance.
+    /// @param free true if the lease address should be marked free, false
+    /// if it should be marked in use.
+    /// @param mt_safe a boolean flag indicating if the callback
+    /// has been invoked in the MT-safe context.
+    void updateOccupancy(const LeasePtr& lease, bool free, bool mt_safe);
+
+    /// @brief Thread unsafe update of the occupancy filter.
+    ///
+    /// @param lease lease instance.
+    /// @param free true if the lease address should be marked free, false
+    /// if it should be marked in use.
+    void updateOccupancyInternal(const LeasePtr& lease, bool free);
+
 protected:
 
     /// @brief Indicates if the allocator has been initialized.
@@ -233,6 +420,11 @@ protected:
 
     /// @brief The mutex to protect the allocated lease.
     std::mutex mutex_;
+
+    /// @brief The occupancy filters of the pools.
+    ///
+    /// The bits of the filters are set for the free addresses.
+    std::map<PoolPtr, PoolBitmapAllocationStatePtr> occupancy_;
 };
 
 /// Defines a pointer to an allocator.
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,6 +13,8 @@
 #include <exceptions/exceptions.h>
 #include <boost/shared_ptr.hpp>
 
+#include <list>
+#include <utility>
 #include <vector>
 
 namespace isc {
@@ -41,6 +43,12 @@ public:
         isc::BadValue(file, line, what) { };
 };
 
+/// @brief Host identifier type and value.
+typedef std::pair<Host::IdentifierType, std::vector<uint8_t> > HostIdentifier;
+
+/// @brief Host identifiers in the order of preference.
+typedef std::list<HostIdentifier> HostIdentifierList;
+
 /// @brief Wraps value holding size of the page with host reservations.
 class HostPageSize {
 public:
@@ -94,6 +102,9 @@ public:
         ID_DUID = 1    ///< DUID/client-id
     };
 
+    /// @brief Number of hosts added by transaction by @c addHosts.
+    static const size_t HOSTS_BATCH_SIZE = 1000;
+
     /// @brief Default destructor implementation.
     virtual ~BaseHostDataSource() { }
 
@@ -291,6 +302,34 @@ public:
          const uint8_t* identifier_begin,
          const size_t identifier_len) const = 0;
 
+    /// @brief Returns the hosts connected to the IPv4 subnet using any of
+    /// the identifiers.
+    ///
+    /// The default implementation calls @c get4 for each identifier. The
+    /// SQL backends override it to look for all identifiers in a single
+    /// query, i.e. one database round trip per lookup instead of one per
+    /// identifier type.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Identifiers to look for.
+    ///
+    /// @return Collection of const @c Host objects, at most one for each
+    /// identifier, in no particular order.
+    virtual ConstHostCollection
+    getAllbyIdentifiers4(const SubnetID& subnet_id,
+                         const HostIdentifierList& identifiers) const {
+        ConstHostCollection hosts;
+        for (auto const& identifier : identifiers) {
+            ConstHostPtr host = get4(subnet_id, identifier.first,
+                                     identifier.second.data(),
+                                     identifier.second.size());
+            if (host) {
+                hosts.push_back(host);
+            }
+        }
+        return (hosts);
+    }
+
     /// @brief Returns a host connected to the IPv4 subnet and having
     /// a reservation for a specified IPv4 address.
     ///
@@ -354,6 +393,34 @@ public:
          const uint8_t* identifier_begin,
          const size_t identifier_len) const = 0;
 
+    /// @brief Returns the hosts connected to the IPv6 subnet using any of
+    /// the identifiers.
+    ///
+    /// The default implementation calls @c get6 for each identifier. The
+    /// SQL backends override it to look for all identifiers in a single
+    /// query, i.e. one database round trip per lookup instead of one per
+    /// identifier type.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Identifiers to look for.
+    ///
+    /// @return Collection of const @c Host objects, at most one for each
+    /// identifier, in no particular order.
+    virtual ConstHostCollection
+    getAllbyIdentifiers6(const SubnetID& subnet_id,
+                         const HostIdentifierList& identifiers) const {
+        ConstHostCollection hosts;
+        for (auto const& identifier : identifiers) {
+            ConstHostPtr host = get6(subnet_id, identifier.first,
+                                     identifier.second.data(),
+                                     identifier.second.size());
+            if (host) {
+                hosts.push_back(host);
+            }
+        }
+        return (hosts);
+    }
+
     /// @brief Returns a host using the specified IPv6 prefix.
     ///
     /// @param prefix IPv6 prefix for which the @c Host object is searched.
@@ -412,6 +479,19 @@ public:
     /// @param host Pointer to the new @c Host object being added.
     virtual void add(const HostPtr& host) = 0;
 
+    /// @brief Adds a collection of new hosts.
+    ///
+    /// This is the bulk import path: the SQL backends override it to
+    /// insert many hosts per transaction. The default implementation
+    /// adds the hosts one by one, stopping at the first failure.
+    ///
+    /// @param hosts Collection of the new @c Host objects being added.
+    virtual void addHosts(const HostCollection& hosts) {
+        for (auto const& host : hosts) {
+            add(host);
+        }
+    }
+
     /// @brief Attempts to delete hosts by (subnet-id, address)
     ///
     /// This method supports both v4 and v6.
@@ -0,0 +1,95 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcp/dhcp4.h>
+#include <dhcpsrv/alloc_engine.h>
+#include <dhcpsrv/benchmarks/benchmark_utils.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/host_mgr.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/pool.h>
+#include <dhcpsrv/subnet.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+using namespace isc::dhcp::bench;
+
+namespace {
+
+/// @brief Configures a subnet with a large pool and an empty memfile
+/// lease database.
+///
+/// @return The configured subnet.
+Subnet4Ptr
+configure() {
+    CfgMgr::instance().clear();
+    Subnet4Ptr subnet = Subnet4::create(IOAddress("10.0.0.0"), 8, 1800, 2700,
+                                        3600, 1);
+    subnet->addPool(Pool4Ptr(new Pool4(IOAddress("10.0.0.1"),
+                                       IOAddress("10.255.255.254"))));
+    CfgMgr::instance().getStagingCfg()->getCfgSubnets4()->add(subnet);
+    CfgMgr::instance().commit();
+
+    LeaseMgrFactory::create("type=memfile universe=4 persist=false");
+    HostMgr::instance().create();
+    return (subnet);
+}
+
+/// @brief Allocates a lease to a client.
+///
+/// @param engine The allocation engine.
+/// @param subnet The subnet of the client.
+/// @param index Index of the client.
+Lease4Ptr
+allocate(AllocEngine& engine, const Subnet4Ptr& subnet, uint32_t index) {
+    AllocEngine::ClientContext4 ctx(subnet, createClientId(index),
+                                    createHWAddr(index),
+                                    IOAddress::IPV4_ZERO_ADDRESS(),
+                                    false, false, "", false);
+    ctx.query_.reset(new Pkt4(DHCPREQUEST, index));
+    return (engine.allocateLease4(ctx));
+}
+
+/// @brief Measures the allocation of leases to new clients.
+void
+BM_AllocateLease4(benchmark::State& state) {
+    Subnet4Ptr subnet = configure();
+    AllocEngine engine(0);
+    uint32_t index = 0;
+    for (auto _ : state) {
+        Lease4Ptr lease = allocate(engine, subnet, ++index);
+        benchmark::DoNotOptimize(lease);
+    }
+    state.SetItemsProcessed(state.iterations());
+    LeaseMgrFactory::destroy();
+}
+
+/// @brief Measures the renewals of the lease of a client.
+void
+BM_RenewLease4(benchmark::State& state) {
+    Subnet4Ptr subnet = configure();
+    AllocEngine engine(0);
+    if (!allocate(engine, subnet, 1)) {
+        state.SkipWithError("unable to allocate the lease");
+        return;
+    }
+    for (auto _ : state) {
+        Lease4Ptr lease = allocate(engine, subnet, 1);
+        benchmark::DoNotOptimize(lease);
+    }
+    state.SetItemsProcessed(state.iterations());
+    LeaseMgrFactory::destroy();
+}
+
+} // end of anonymous namespace
+
+BENCHMARK(BM_AllocateLease4);
+BENCHMARK(BM_RenewLease4);
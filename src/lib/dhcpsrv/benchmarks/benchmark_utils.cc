@@ -0,0 +1,68 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/option_int_array.h>
+#include <dhcp/option_string.h>
+#include <dhcpsrv/benchmarks/benchmark_utils.h>
+
+#include <vector>
+
+using namespace isc::asiolink;
+
+namespace isc {
+namespace dhcp {
+namespace bench {
+
+HWAddrPtr
+createHWAddr(uint32_t index) {
+    std::vector<uint8_t> mac = { 0x02, 0x00,
+                                 static_cast<uint8_t>(index >> 24),
+                                 static_cast<uint8_t>(index >> 16),
+                                 static_cast<uint8_t>(index >> 8),
+                                 static_cast<uint8_t>(index) };
+    return (HWAddrPtr(new HWAddr(mac, HTYPE_ETHER)));
+}
+
+ClientIdPtr
+createClientId(uint32_t index) {
+    std::vector<uint8_t> id = createHWAddr(index)->hwaddr_;
+    id.insert(id.begin(), HTYPE_ETHER);
+    return (ClientIdPtr(new ClientId(id)));
+}
+
+Pkt4Ptr
+createDiscover4(uint32_t index) {
+    Pkt4Ptr pkt(new Pkt4(DHCPDISCOVER, index));
+    pkt->setHWAddr(createHWAddr(index));
+    pkt->setGiaddr(IOAddress("10.0.0.1"));
+    pkt->setHops(1);
+
+    std::vector<uint8_t> id = createClientId(index)->getClientId();
+    pkt->addOption(OptionPtr(new Option(Option::V4,
+                                        DHO_DHCP_CLIENT_IDENTIFIER, id)));
+    pkt->addOption(OptionPtr(new OptionString(Option::V4, DHO_HOST_NAME,
+                                              "client.example.org")));
+    OptionUint8ArrayPtr prl(new OptionUint8Array(Option::V4,
+                                                 DHO_DHCP_PARAMETER_REQUEST_LIST));
+    for (uint8_t code : { DHO_SUBNET_MASK, DHO_ROUTERS,
+                          DHO_DOMAIN_NAME_SERVERS, DHO_DOMAIN_NAME,
+                          DHO_NTP_SERVERS }) {
+        prl->addValue(code);
+    }
+    pkt->addOption(prl);
+    pkt->addOption(OptionPtr(new OptionString(Option::V4,
+                                              DHO_VENDOR_CLASS_IDENTIFIER,
+                                              "PXEClient:Arch:00000:UNDI:002001")));
+    return (pkt);
+}
+
+} // end of namespace isc::dhcp::bench
+} // end of namespace isc::dhcp
+} // end of namespace isc
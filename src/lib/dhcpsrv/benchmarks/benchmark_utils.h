@@ -0,0 +1,45 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef BENCHMARK_UTILS_H
+#define BENCHMARK_UTILS_H
+
+#include <dhcp/duid.h>
+#include <dhcp/hwaddr.h>
+#include <dhcp/pkt4.h>
+
+#include <stdint.h>
+
+namespace isc {
+namespace dhcp {
+namespace bench {
+
+/// @brief Creates a hardware address unique for an index.
+///
+/// @param index Index of the client.
+/// @return Ethernet address ending with the index.
+HWAddrPtr createHWAddr(uint32_t index);
+
+/// @brief Creates a client identifier unique for an index.
+///
+/// @param index Index of the client.
+/// @return Client identifier of type 1 holding the hardware address.
+ClientIdPtr createClientId(uint32_t index);
+
+/// @brief Creates a relayed DHCPDISCOVER as sent by a typical client.
+///
+/// The packet holds the client identifier, host name, parameter request
+/// list and vendor class identifier options.
+///
+/// @param index Index of the client, used as the transaction id.
+/// @return The DHCPDISCOVER (not packed).
+Pkt4Ptr createDiscover4(uint32_t index);
+
+} // end of namespace isc::dhcp::bench
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // BENCHMARK_UTILS_H
@@ -0,0 +1,46 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/cfg_subnets4.h>
+#include <dhcpsrv/subnet.h>
+#include <dhcpsrv/subnet_selector.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Measures the selection of a subnet by the relay address.
+///
+/// The configuration holds the number of /24 subnets given by the
+/// benchmark argument and the relay address belongs to the last one.
+void
+BM_SelectSubnet4(benchmark::State& state) {
+    const uint32_t count = static_cast<uint32_t>(state.range(0));
+    const uint32_t first = IOAddress("10.0.0.0").toUint32();
+    CfgSubnets4 cfg;
+    for (uint32_t i = 0; i < count; ++i) {
+        cfg.add(Subnet4::create(IOAddress(first + (i << 8)), 24, 1000, 2000,
+                                3000, i + 1));
+    }
+
+    SubnetSelector selector;
+    selector.giaddr_ = IOAddress(first + ((count - 1) << 8) + 1);
+    for (auto _ : state) {
+        Subnet4Ptr subnet = cfg.selectSubnet(selector);
+        benchmark::DoNotOptimize(subnet);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // end of anonymous namespace
+
+BENCHMARK(BM_SelectSubnet4)->Arg(10)->Arg(1000)->Arg(50000);
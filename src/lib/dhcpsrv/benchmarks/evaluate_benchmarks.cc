@@ -0,0 +1,48 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/benchmarks/benchmark_utils.h>
+#include <eval/eval_context.h>
+#include <eval/evaluate.h>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+using namespace isc::dhcp;
+using namespace isc::dhcp::bench;
+
+namespace {
+
+/// @brief Measures the evaluation of a client class test expression
+/// against a typical DHCPDISCOVER.
+///
+/// @param expression The test expression.
+void
+BM_EvaluateBool(benchmark::State& state, const std::string& expression) {
+    EvalContext eval_ctx(Option::V4);
+    if (!eval_ctx.parseString(expression)) {
+        state.SkipWithError("unable to parse the expression");
+        return;
+    }
+    Pkt4Ptr pkt = createDiscover4(1);
+    for (auto _ : state) {
+        bool result = evaluateBool(eval_ctx.expression, *pkt);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // end of anonymous namespace
+
+BENCHMARK_CAPTURE(BM_EvaluateBool, vendor_class,
+                  std::string("substring(option[60].hex,0,9) == 'PXEClient'"));
+BENCHMARK_CAPTURE(BM_EvaluateBool, relay_and_hostname,
+                  std::string("option[12].exists and pkt4.giaddr == 10.0.0.1"));
+BENCHMARK_CAPTURE(BM_EvaluateBool, mac_address,
+                  std::string("hexstring(pkt4.mac, ':') == '02:00:00:00:00:01'"));
@@ -0,0 +1,121 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <database/database_connection.h>
+#include <dhcpsrv/benchmarks/benchmark_utils.h>
+#include <dhcpsrv/memfile_lease_mgr.h>
+
+#include <benchmark/benchmark.h>
+
+#include <boost/scoped_ptr.hpp>
+
+#include <ctime>
+#include <vector>
+
+using namespace isc::asiolink;
+using namespace isc::db;
+using namespace isc::dhcp;
+using namespace isc::dhcp::bench;
+
+namespace {
+
+/// @brief Creates a memfile lease manager which doesn't persist leases.
+Memfile_LeaseMgr*
+createLeaseMgr() {
+    DatabaseConnection::ParameterMap pmap;
+    pmap["type"] = "memfile";
+    pmap["universe"] = "4";
+    pmap["persist"] = "false";
+    return (new Memfile_LeaseMgr(pmap));
+}
+
+/// @brief Creates leases of distinct clients and addresses.
+///
+/// @param count Number of leases.
+std::vector<Lease4Ptr>
+createLeases4(uint32_t count) {
+    std::vector<Lease4Ptr> leases;
+    const uint32_t first = IOAddress("10.0.0.1").toUint32();
+    const time_t now = time(0);
+    for (uint32_t i = 0; i < count; ++i) {
+        leases.push_back(Lease4Ptr(new Lease4(IOAddress(first + i),
+                                              createHWAddr(i),
+                                              createClientId(i),
+                                              3600, now, 1)));
+    }
+    return (leases);
+}
+
+/// @brief Measures the addition of leases to an empty lease manager.
+///
+/// The benchmark argument is the number of added leases.
+void
+BM_MemfileAddLease4(benchmark::State& state) {
+    std::vector<Lease4Ptr> leases =
+        createLeases4(static_cast<uint32_t>(state.range(0)));
+    boost::scoped_ptr<Memfile_LeaseMgr> lease_mgr;
+    for (auto _ : state) {
+        state.PauseTiming();
+        lease_mgr.reset(createLeaseMgr());
+        state.ResumeTiming();
+        for (auto const& lease : leases) {
+            lease_mgr->addLease(lease);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * leases.size());
+}
+
+/// @brief Measures the lookups of leases by address.
+///
+/// The benchmark argument is the number of leases in the lease manager.
+void
+BM_MemfileGetLease4(benchmark::State& state) {
+    std::vector<Lease4Ptr> leases =
+        createLeases4(static_cast<uint32_t>(state.range(0)));
+    boost::scoped_ptr<Memfile_LeaseMgr> lease_mgr(createLeaseMgr());
+    for (auto const& lease : leases) {
+        lease_mgr->addLease(lease);
+    }
+    size_t index = 0;
+    for (auto _ : state) {
+        Lease4Ptr lease = lease_mgr->getLease4(leases[index]->addr_);
+        benchmark::DoNotOptimize(lease);
+        index = (index + 1) % leases.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief Measures the renewals of leases.
+///
+/// The benchmark argument is the number of leases in the lease manager.
+void
+BM_MemfileUpdateLease4(benchmark::State& state) {
+    std::vector<Lease4Ptr> leases =
+        createLeases4(static_cast<uint32_t>(state.range(0)));
+    boost::scoped_ptr<Memfile_LeaseMgr> lease_mgr(createLeaseMgr());
+    for (auto const& lease : leases) {
+        lease_mgr->addLease(lease);
+    }
+    size_t index = 0;
+    for (auto _ : state) {
+        // The stored lease must not be modified in place.
+        Lease4Ptr lease(new Lease4(*leases[index]));
+        ++lease->cltt_;
+        lease_mgr->updateLease4(lease);
+        leases[index] = lease;
+        index = (index + 1) % leases.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // end of anonymous namespace
+
+BENCHMARK(BM_MemfileAddLease4)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_MemfileGetLease4)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_MemfileUpdateLease4)->Arg(1000)->Arg(100000);
@@ -0,0 +1,75 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcp/dhcp4.h>
+#include <dhcp/libdhcp++.h>
+#include <dhcpsrv/benchmarks/benchmark_utils.h>
+
+#include <benchmark/benchmark.h>
+
+#include <list>
+#include <vector>
+
+using namespace isc::dhcp;
+using namespace isc::dhcp::bench;
+
+namespace {
+
+/// @brief Returns the wire format of a typical DHCPDISCOVER.
+std::vector<uint8_t>
+discoverWire() {
+    Pkt4Ptr pkt = createDiscover4(1);
+    pkt->pack();
+    const uint8_t* data =
+        static_cast<const uint8_t*>(pkt->getBuffer().getData());
+    return (std::vector<uint8_t>(data, data + pkt->getBuffer().getLength()));
+}
+
+/// @brief Measures the packing of a DHCPDISCOVER.
+void
+BM_Pkt4Pack(benchmark::State& state) {
+    Pkt4Ptr pkt = createDiscover4(1);
+    for (auto _ : state) {
+        pkt->pack();
+        benchmark::DoNotOptimize(pkt->getBuffer().getLength());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief Measures the parsing of a received DHCPDISCOVER.
+void
+BM_Pkt4Unpack(benchmark::State& state) {
+    std::vector<uint8_t> wire = discoverWire();
+    for (auto _ : state) {
+        Pkt4Ptr pkt(new Pkt4(&wire[0], wire.size()));
+        pkt->unpack();
+        benchmark::DoNotOptimize(pkt);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief Measures the parsing of the options of a DHCPDISCOVER.
+void
+BM_UnpackOptions4(benchmark::State& state) {
+    std::vector<uint8_t> wire = discoverWire();
+    // Skip the fixed header and the magic cookie.
+    OptionBuffer buf(wire.begin() + Pkt4::DHCPV4_PKT_HDR_LEN + 4, wire.end());
+    for (auto _ : state) {
+        OptionCollection options;
+        std::list<uint16_t> deferred;
+        LibDHCP::unpackOptions4(buf, DHCP4_OPTION_SPACE, options, deferred);
+        benchmark::DoNotOptimize(options);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // end of anonymous namespace
+
+BENCHMARK(BM_Pkt4Pack);
+BENCHMARK(BM_Pkt4Unpack);
+BENCHMARK(BM_UnpackOptions4);
@@ -0,0 +1,196 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
+#include <boost/make_shared.hpp>
+
+using namespace isc::asiolink;
+
+namespace {
+
+/// @brief Returns the position of the lowest set bit of a non-zero word.
+inline uint64_t
+lowestBit(uint64_t word) {
+    return (static_cast<uint64_t>(__builtin_ctzll(word)));
+}
+
+}
+
+namespace isc {
+namespace dhcp {
+
+const uint64_t PoolBitmapAllocationState::WORD_BITS;
+
+PoolBitmapAllocationStatePtr
+PoolBitmapAllocationState::create(const PoolPtr& pool) {
+    if (pool->getType() != Lease::TYPE_V4) {
+        isc_throw(BadValue, "bitmap allocation state can only be created"
+                  " for IPv4 pools");
+    }
+    return (boost::make_shared<PoolBitmapAllocationState>(pool->getFirstAddress(),
+                                                          pool->getLastAddress()));
+}
+
+PoolBitmapAllocationState::PoolBitmapAllocationState(const IOAddress& first,
+                                                     const IOAddress& last)
+    : AllocationState(), first_(0), capacity_(0), levels_(), sizes_(),
+      free_count_(0), cursor_(0) {
+    if (!first.isV4() || !last.isV4() || (last < first)) {
+        isc_throw(BadValue, "invalid IPv4 address range " << first
+                  << " - " << last << " for the bitmap allocation state");
+    }
+    first_ = first.toUint32();
+    capacity_ = static_cast<uint64_t>(last.toUint32()) - first_ + 1;
+
+    // Each level summarizes the words of the level below until a level
+    // fits in a single word.
+    uint64_t size = capacity_;
+    for (;;) {
+        uint64_t words = (size + WORD_BITS - 1) / WORD_BITS;
+        sizes_.push_back(size);
+        levels_.push_back(std::vector<uint64_t>(words, 0));
+        if (words == 1) {
+            break;
+        }
+        size = words;
+    }
+}
+
+bool
+PoolBitmapAllocationState::exhausted() const {
+    return (free_count_ == 0);
+}
+
+bool
+PoolBitmapAllocationState::getIndex(const IOAddress& address,
+                                    uint64_t& index) const {
+    if (!address.isV4()) {
+        return (false);
+    }
+    uint32_t value = address.toUint32();
+    if (value < first_) {
+        return (false);
+    }
+    index = static_cast<uint64_t>(value) - first_;
+    return (index < capacity_);
+}
+
+void
+PoolBitmapAllocationState::setBit(size_t level, uint64_t index) {
+    uint64_t& word = levels_[level][index / WORD_BITS];
+    bool was_empty = (word == 0);
+    word |= (static_cast<uint64_t>(1) << (index % WORD_BITS));
+    if (was_empty && (level + 1 < levels_.size())) {
+        setBit(level + 1, index / WORD_BITS);
+    }
+}
+
+void
+PoolBitmapAllocationState::clearBit(size_t level, uint64_t index) {
+    uint64_t& word = levels_[level][index / WORD_BITS];
+    word &= ~(static_cast<uint64_t>(1) << (index % WORD_BITS));
+    if ((word == 0) && (level + 1 < levels_.size())) {
+        clearBit(level + 1, index / WORD_BITS);
+    }
+}
+
+uint64_t
+PoolBitmapAllocationState::findNext(size_t level, uint64_t index) const {
+    const uint64_t size = sizes_[level];
+    if (index >= size) {
+        return (size);
+    }
+    const std::vector<uint64_t>& words = levels_[level];
+    uint64_t pos = index / WORD_BITS;
+    uint64_t word = words[pos] & (~static_cast<uint64_t>(0) << (index % WORD_BITS));
+    if (word != 0) {
+        return (pos * WORD_BITS + lowestBit(word));
+    }
+    if (level + 1 >= levels_.size()) {
+        // The top level has a single word.
+        return (size);
+    }
+    // Find the next non-empty word using the upper level.
+    pos = findNext(level + 1, pos + 1);
+    if (pos >= sizes_[level + 1]) {
+        return (size);
+    }
+    return (pos * WORD_BITS + lowestBit(words[pos]));
+}
+
+void
+PoolBitmapAllocationState::addFreeLease(const IOAddress& address) {
+    uint64_t index;
+    if (!getIndex(address, index)) {
+        return;
+    }
+    if (levels_[0][index / WORD_BITS] & (static_cast<uint64_t>(1) << (index % WORD_BITS))) {
+        return;
+    }
+    setBit(0, index);
+    ++free_count_;
+}
+
+void
+PoolBitmapAllocationState::addAllFreeLeases() {
+    for (size_t level = 0; level < levels_.size(); ++level) {
+        std::vector<uint64_t>& words = levels_[level];
+        std::fill(words.begin(), words.end(), ~static_cast<uint64_t>(0));
+        uint64_t tail = sizes_[level] % WORD_BITS;
+        if (tail != 0) {
+            words.back() = (static_cast<uint64_t>(1) << tail) - 1;
+        }
+    }
+    free_count_ = capacity_;
+}
+
+void
+PoolBitmapAllocationState::deleteFreeLease(const IOAddress& address) {
+    uint64_t index;
+    if (!getIndex(address, index)) {
+        return;
+    }
+    if (!(levels_[0][index / WORD_BITS] & (static_cast<uint64_t>(1) << (index % WORD_BITS)))) {
+        return;
+    }
+    clearBit(0, index);
+    --free_count_;
+}
+
+bool
+PoolBitmapAllocationState::isFreeLease(const IOAddress& address) const {
+    uint64_t index;
+    if (!getIndex(address, index)) {
+        return (true);
+    }
+    return (levels_[0][index / WORD_BITS] & (static_cast<uint64_t>(1) << (index % WORD_BITS)));
+}
+
+IOAddress
+PoolBitmapAllocationState::offerFreeLease() {
+    if (free_count_ == 0) {
+        return (IOAddress::IPV4_ZERO_ADDRESS());
+    }
+    uint64_t index = findNext(0, cursor_);
+    if (index >= capacity_) {
+        // Wrap around.
+        index = findNext(0, 0);
+    }
+    cursor_ = index + 1;
+    if (cursor_ >= capacity_) {
+        cursor_ = 0;
+    }
+    return (IOAddress(static_cast<uint32_t>(first_ + index)));
+}
+
+size_t
+PoolBitmapAllocationState::getFreeLeaseCount() const {
+    return (static_cast<size_t>(free_count_));
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
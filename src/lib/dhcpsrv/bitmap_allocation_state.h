@@ -0,0 +1,154 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef BITMAP_ALLOCATION_STATE_H
+#define BITMAP_ALLOCATION_STATE_H
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/allocation_state.h>
+#include <dhcpsrv/pool.h>
+#include <boost/shared_ptr.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Forward declaration of the @c PoolBitmapAllocationState.
+class PoolBitmapAllocationState;
+
+/// @brief Type of the pointer to the @c PoolBitmapAllocationState.
+typedef boost::shared_ptr<PoolBitmapAllocationState> PoolBitmapAllocationStatePtr;
+
+/// @brief Pool allocation state used by the bitmap allocator.
+///
+/// It tracks the free addresses of an IPv4 pool with one bit per address.
+/// The words of the bitmap are summarized in upper levels where each bit
+/// indicates that the corresponding word of the level below has a free
+/// address. Finding the next free address from any position only inspects
+/// one word per level, i.e. at most four words for the largest pools.
+///
+/// The free addresses are offered in the increasing order, starting after
+/// the last offered address and wrapping around at the end of the pool.
+class PoolBitmapAllocationState : public AllocationState {
+public:
+
+    /// @brief Factory function creating the state instance from a pool.
+    ///
+    /// @param pool instance of the IPv4 pool for which the allocation state
+    /// should be instantiated.
+    /// @return new allocation state instance.
+    /// @throw BadValue if the pool is not an IPv4 pool.
+    static PoolBitmapAllocationStatePtr create(const PoolPtr& pool);
+
+    /// @brief Constructor.
+    ///
+    /// All the addresses are initially in use.
+    ///
+    /// @param first first address of the pool.
+    /// @param last last address of the pool.
+    /// @throw BadValue if the addresses are not IPv4 or the last address
+    /// is lower than the first address.
+    PoolBitmapAllocationState(const asiolink::IOAddress& first,
+                              const asiolink::IOAddress& last);
+
+    /// @brief Checks if the pool has run out of free leases.
+    ///
+    /// @return true if the pool has no free leases, false otherwise.
+    bool exhausted() const;
+
+    /// @brief Marks an address free.
+    ///
+    /// Addresses out of the pool are ignored.
+    ///
+    /// @param address lease address.
+    void addFreeLease(const asiolink::IOAddress& address);
+
+    /// @brief Marks all the addresses of the pool free.
+    void addAllFreeLeases();
+
+    /// @brief Marks an address in use.
+    ///
+    /// Addresses out of the pool are ignored.
+    ///
+    /// @param address lease address.
+    void deleteFreeLease(const asiolink::IOAddress& address);
+
+    /// @brief Checks if an address is free.
+    ///
+    /// @param address lease address.
+    /// @return true if the address is free or out of the pool, false
+    /// if it is in use.
+    bool isFreeLease(const asiolink::IOAddress& address) const;
+
+    /// @brief Returns next available lease.
+    ///
+    /// The address remains free until it is deleted, e.g. when a lease
+    /// is allocated for it.
+    ///
+    /// @return next free lease address or IPv4 zero address when there
+    /// are no free leases.
+    asiolink::IOAddress offerFreeLease();
+
+    /// @brief Returns the current number of free leases.
+    ///
+    /// @return the number of free leases.
+    size_t getFreeLeaseCount() const;
+
+private:
+
+    /// @brief Returns the position of an address in the pool.
+    ///
+    /// @param address lease address.
+    /// @param[out] index position of the address.
+    /// @return false if the address is out of the pool.
+    bool getIndex(const asiolink::IOAddress& address, uint64_t& index) const;
+
+    /// @brief Sets a bit in a level and propagates it to the upper levels.
+    ///
+    /// @param level level of the bit.
+    /// @param index position of the bit in the level.
+    void setBit(size_t level, uint64_t index);
+
+    /// @brief Clears a bit in a level and propagates it to the upper levels.
+    ///
+    /// @param level level of the bit.
+    /// @param index position of the bit in the level.
+    void clearBit(size_t level, uint64_t index);
+
+    /// @brief Returns the first set bit at or after a position in a level.
+    ///
+    /// @param level level to search.
+    /// @param index position to search from.
+    /// @return the position of the bit or the size of the level if none.
+    uint64_t findNext(size_t level, uint64_t index) const;
+
+    /// @brief Number of bits in a word.
+    static const uint64_t WORD_BITS = 64;
+
+    /// @brief First address of the pool.
+    uint32_t first_;
+
+    /// @brief Number of addresses in the pool.
+    uint64_t capacity_;
+
+    /// @brief The bitmap of the free addresses followed by its summaries.
+    std::vector<std::vector<uint64_t> > levels_;
+
+    /// @brief Number of bits in each level.
+    std::vector<uint64_t> sizes_;
+
+    /// @brief Number of free addresses.
+    uint64_t free_count_;
+
+    /// @brief Position from which the next address is searched.
+    uint64_t cursor_;
+};
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // BITMAP_ALLOCATION_STATE_H
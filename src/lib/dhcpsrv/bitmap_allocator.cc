@@ -0,0 +1,255 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/bitmap_allocator.h>
+#include <dhcpsrv/dhcpsrv_log.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/subnet.h>
+#include <util/stopwatch.h>
+
+using namespace isc::asiolink;
+using namespace isc::util;
+using namespace std;
+
+namespace {
+/// @brief An owner string used in the callbacks installed in
+/// the lease manager.
+const string BITMAP_OWNER = "bitmap";
+}
+
+namespace isc {
+namespace dhcp {
+
+BitmapAllocator::BitmapAllocator(Lease::Type type, const WeakSubnetPtr& subnet)
+    : Allocator(type, subnet), generator_() {
+    if (type != Lease::TYPE_V4) {
+        isc_throw(BadValue, "bitmap allocator supports IPv4 addresses only");
+    }
+    random_device rd;
+    generator_.seed(rd());
+}
+
+IOAddress
+BitmapAllocator::pickAddressInternal(const ClientClasses& client_classes,
+                                     const DuidPtr&,
+                                     const IOAddress&) {
+    auto subnet = subnet_.lock();
+    auto pools = subnet->getPools(pool_type_);
+    if (pools.empty()) {
+        // No pools, no allocation.
+        return (IOAddress::IPV4_ZERO_ADDRESS());
+    }
+    // Let's first iterate over the pools and identify the ones that
+    // meet client class criteria and are not exhausted.
+    std::vector<uint64_t> available;
+    for (auto i = 0; i < pools.size(); ++i) {
+        // Check if the pool is allowed for the client's classes.
+        if (pools[i]->clientSupported(client_classes)) {
+            // Get or create the pool state.
+            auto pool_state = getPoolState(pools[i]);
+            if (!pool_state->exhausted()) {
+                // There are still available addresses in this pool.
+                available.push_back(i);
+            }
+        }
+    }
+    if (available.empty()) {
+        // No pool meets the client class criteria or all are exhausted.
+        return (IOAddress::IPV4_ZERO_ADDRESS());
+    }
+    // Get a random pool from the available ones.
+    auto pool = pools[available[getRandomNumber(available.size()-1)]];
+
+    // The pool should still offer some leases.
+    return (getPoolState(pool)->offerFreeLease());
+}
+
+IOAddress
+BitmapAllocator::pickPrefixInternal(const ClientClasses&,
+                                    Pool6Ptr&,
+                                    const DuidPtr&,
+                                    PrefixLenMatchType,
+                                    const IOAddress&,
+                                    uint8_t) {
+    isc_throw(NotImplemented, "bitmap allocator does not support delegated prefixes");
+}
+
+uint64_t
+BitmapAllocator::getFreeLeaseCountInternal(const ClientClasses& client_classes) const {
+    auto subnet = subnet_.lock();
+    if (!subnet) {
+        return (0);
+    }
+    uint64_t free_lease_count = 0;
+    for (auto const& pool : subnet->getPools(pool_type_)) {
+        if (pool->clientSupported(client_classes)) {
+            free_lease_count += getPoolState(pool)->getFreeLeaseCount();
+        }
+    }
+    return (free_lease_count);
+}
+
+void
+BitmapAllocator::initAfterConfigureInternal() {
+    auto subnet = subnet_.lock();
+    auto pools = subnet->getPools(pool_type_);
+    if (pools.empty()) {
+        // If there are no pools there is nothing to do.
+        return;
+    }
+    auto& lease_mgr = LeaseMgrFactory::instance();
+    populateFreeAddressLeases(lease_mgr.getLeases4(subnet->getID()), pools);
+
+    // Install the callbacks for lease add, update and delete in the interface manager.
+    // These callbacks will ensure that we have up-to-date free addresses bitmaps.
+    lease_mgr.registerCallback(TrackingLeaseMgr::TRACK_ADD_LEASE, BITMAP_OWNER, subnet->getID(), pool_type_,
+                               std::bind(&BitmapAllocator::addLeaseCallback, this,
+                                         std::placeholders::_1,
+                                         std::placeholders::_2));
+    lease_mgr.registerCallback(TrackingLeaseMgr::TRACK_UPDATE_LEASE, BITMAP_OWNER, subnet->getID(), pool_type_,
+                               std::bind(&BitmapAllocator::updateLeaseCallback, this,
+                                         std::placeholders::_1,
+                                         std::placeholders::_2));
+    lease_mgr.registerCallback(TrackingLeaseMgr::TRACK_DELETE_LEASE, BITMAP_OWNER, subnet->getID(), pool_type_,
+                               std::bind(&BitmapAllocator::deleteLeaseCallback, this,
+                                         std::placeholders::_1,
+                                         std::placeholders::_2));
+}
+
+void
+BitmapAllocator::populateFreeAddressLeases(const Lease4Collection& leases, const PoolCollection& pools) {
+    auto subnet = subnet_.lock();
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_CFGMGR_BITMAP_POPULATE_FREE_ADDRESS_LEASES)
+        .arg(subnet->toText());
+
+    Stopwatch stopwatch;
+
+    // Start with all addresses free. Setting the whole bitmaps is much
+    // faster than checking each address against the leases.
+    for (auto pool : pools) {
+        getPoolState(pool)->addAllFreeLeases();
+    }
+
+    // Mark the addresses of the valid leases in use. The expired leases
+    // and those in the expired-reclaimed state remain free.
+    for (auto lease : leases) {
+        if ((lease->getType() == pool_type_) && (!lease->expired()) && (!lease->stateExpiredReclaimed())) {
+            auto pool = subnet->getPool(pool_type_, lease->addr_, false);
+            if (pool) {
+                getPoolState(pool)->deleteFreeLease(lease->addr_);
+            }
+        }
+    }
+
+    size_t free_lease_count = 0;
+    for (auto pool : pools) {
+        free_lease_count += getPoolState(pool)->getFreeLeaseCount();
+    }
+
+    stopwatch.stop();
+
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_CFGMGR_BITMAP_POPULATE_FREE_ADDRESS_LEASES_DONE)
+        .arg(free_lease_count)
+        .arg(subnet->toText())
+        .arg(stopwatch.logFormatLastDuration());
+}
+
+PoolBitmapAllocationStatePtr
+BitmapAllocator::getPoolState(const PoolPtr& pool) const {
+    if (!pool->getAllocationState()) {
+        pool->setAllocationState(PoolBitmapAllocationState::create(pool));
+    }
+    return (boost::dynamic_pointer_cast<PoolBitmapAllocationState>(pool->getAllocationState()));
+}
+
+PoolPtr
+BitmapAllocator::getLeasePool(const LeasePtr& lease) const {
+    auto subnet = subnet_.lock();
+    if (!subnet) {
+        return (PoolPtr());
+    }
+    return (subnet->getPool(pool_type_, lease->addr_, false));
+}
+
+void
+BitmapAllocator::addLeaseCallback(LeasePtr lease, bool mt_safe) {
+    if (!mt_safe) {
+        MultiThreadingLock lock(mutex_);
+        addLeaseCallbackInternal(lease);
+        return;
+    }
+    addLeaseCallbackInternal(lease);
+}
+
+void
+BitmapAllocator::addLeaseCallbackInternal(LeasePtr lease) {
+    if (lease->expired()) {
+        return;
+    }
+    auto pool = getLeasePool(lease);
+    if (!pool) {
+        return;
+    }
+    getPoolState(pool)->deleteFreeLease(lease->addr_);
+}
+
+void
+BitmapAllocator::updateLeaseCallback(LeasePtr lease, bool mt_safe) {
+    if (!mt_safe) {
+        MultiThreadingLock lock(mutex_);
+        updateLeaseCallbackInternal(lease);
+        return;
+    }
+    updateLeaseCallbackInternal(lease);
+}
+
+void
+BitmapAllocator::updateLeaseCallbackInternal(LeasePtr lease) {
+    auto pool = getLeasePool(lease);
+    if (!pool) {
+        return;
+    }
+    auto pool_state = getPoolState(pool);
+    if (lease->stateExpiredReclaimed() || (lease->expired())) {
+        pool_state->addFreeLease(lease->addr_);
+    } else {
+        pool_state->deleteFreeLease(lease->addr_);
+    }
+}
+
+void
+BitmapAllocator::deleteLeaseCallback(LeasePtr lease, bool mt_safe) {
+    if (!mt_safe) {
+        MultiThreadingLock lock(mutex_);
+        deleteLeaseCallbackInternal(lease);
+        return;
+    }
+    deleteLeaseCallbackInternal(lease);
+}
+
+void
+BitmapAllocator::deleteLeaseCallbackInternal(LeasePtr lease) {
+    auto pool = getLeasePool(lease);
+    if (!pool) {
+        return;
+    }
+    getPoolState(pool)->addFreeLease(lease->addr_);
+}
+
+uint64_t
+BitmapAllocator::getRandomNumber(uint64_t limit) {
+    // Take the short path if there is only one number to randomize from.
+    if (limit == 0) {
+        return (0);
+    }
+    std::uniform_int_distribution<uint64_t> dist(0, limit);
+    return (dist(generator_));
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
@@ -0,0 +1,190 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef BITMAP_ALLOCATOR_H
+#define BITMAP_ALLOCATOR_H
+
+#include <dhcpsrv/allocator.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
+#include <dhcpsrv/lease.h>
+#include <cstdint>
+#include <random>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief An allocator maintaining a bitmap of free IPv4 addresses.
+///
+/// This allocator is similar to the @c FreeLeaseQueueAllocator. It populates
+/// the free addresses during the initialization and installs the callbacks
+/// in the @c LeaseMgr to track the subsequent lease changes. However, it
+/// keeps one bit per address in each pool rather than a container entry
+/// per free address. It makes it suitable for large IPv4 pools, e.g. /12
+/// or /8, for which the free leases queue takes significant memory and
+/// time to populate.
+///
+/// The free addresses of a pool are offered in the increasing order,
+/// starting after the last offered address. The pool is selected randomly
+/// among the pools which are not exhausted.
+///
+/// This allocator supports IPv4 address pools only.
+class BitmapAllocator : public Allocator {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param type specifies the type of allocated leases.
+    /// @param subnet weak pointer to the subnet owning the allocator.
+    /// @throw BadValue if the lease type is not @c Lease::TYPE_V4.
+    BitmapAllocator(Lease::Type type, const WeakSubnetPtr& subnet);
+
+    /// @brief Returns the allocator type string.
+    ///
+    /// @return bitmap string.
+    virtual std::string getType() const {
+        return ("bitmap");
+    }
+
+    /// @brief Checks if the allocation states can be reused.
+    ///
+    /// @return false, the states are rebuilt from the lease database.
+    virtual bool canReuseStates(bool) const {
+        return (false);
+    }
+
+private:
+
+    /// @brief Performs allocator initialization after server's reconfiguration.
+    ///
+    /// The allocator installs the callbacks in the lease manager to keep track of
+    /// the lease allocations and maintain the free addresses bitmaps.
+    virtual void initAfterConfigureInternal();
+
+    /// @brief Populates the bitmaps of free addresses.
+    ///
+    /// It marks all addresses of the subnet pools free and then marks in
+    /// use the addresses of the valid leases.
+    ///
+    /// @param leases collection of leases in the database for a subnet.
+    /// @param pools collection of pools in the subnet.
+    void populateFreeAddressLeases(const Lease4Collection& leases, const PoolCollection& pools);
+
+    /// @brief Returns next available address from the bitmaps.
+    ///
+    /// Internal thread-unsafe implementation of the @c pickAddress.
+    ///
+    /// @param client_classes list of classes client belongs to.
+    /// @param duid client DUID (ignored).
+    /// @param hint client hint (ignored).
+    ///
+    /// @return next offered address.
+    virtual asiolink::IOAddress pickAddressInternal(const ClientClasses& client_classes,
+                                                    const DuidPtr& duid,
+                                                    const asiolink::IOAddress& hint);
+
+    /// @brief Delegated prefixes are not supported by this allocator.
+    ///
+    /// @param client_classes list of classes client belongs to (ignored).
+    /// @param pool the selected pool (ignored).
+    /// @param duid Client's DUID (ignored).
+    /// @param prefix_length_match type which indicates the selection criteria
+    ///        for the pools relative to the provided hint prefix length (ignored).
+    /// @param hint Client's hint (ignored).
+    /// @param hint_prefix_length the hint prefix length (ignored).
+    ///
+    /// @throw NotImplemented always.
+    virtual isc::asiolink::IOAddress
+    pickPrefixInternal(const ClientClasses& client_classes,
+                       Pool6Ptr& pool,
+                       const DuidPtr& duid,
+                       PrefixLenMatchType prefix_length_match,
+                       const isc::asiolink::IOAddress& hint,
+                       uint8_t hint_prefix_length);
+
+    /// @brief Returns the number of free leases in the pools allowed for
+    /// the client classes.
+    ///
+    /// Internal thread-unsafe implementation of the @c getFreeLeaseCount.
+    ///
+    /// @param client_classes list of classes client belongs to.
+    ///
+    /// @return the sum of the free leases in the pool bitmaps.
+    virtual uint64_t
+    getFreeLeaseCountInternal(const ClientClasses& client_classes) const;
+
+    /// @brief Convenience function returning pool allocation state instance.
+    ///
+    /// It creates a new pool state instance and assigns it to the pool
+    /// if it hasn't been initialized.
+    ///
+    /// @param pool pool instance.
+    /// @return allocation state instance for the pool.
+    PoolBitmapAllocationStatePtr getPoolState(const PoolPtr& pool) const;
+
+    /// @brief Returns a pool in the subnet the lease belongs to.
+    ///
+    /// @param lease lease instance for which the pool should be returned.
+    /// @return A pool found for a lease or null pointer if such a pool does
+    /// not exist.
+    PoolPtr getLeasePool(const LeasePtr& lease) const;
+
+    /// @brief Thread safe callback for adding a lease.
+    ///
+    /// Marks the lease address in use.
+    ///
+    /// @param lease added lease.
+    /// @param mt_safe a boolean flag indicating if the callback
+    /// has been invoked in the MT-safe context.
+    void addLeaseCallback(LeasePtr lease, bool mt_safe);
+
+    /// @brief Thread unsafe callback for adding a lease.
+    ///
+    /// @param lease added lease.
+    void addLeaseCallbackInternal(LeasePtr lease);
+
+    /// @brief Thread safe callback for updating a lease.
+    ///
+    /// If the lease is reclaimed or expired the address is marked free.
+    /// Otherwise it is marked in use.
+    ///
+    /// @param lease updated lease.
+    /// @param mt_safe a boolean flag indicating if the callback
+    /// has been invoked in the MT-safe context.
+    void updateLeaseCallback(LeasePtr lease, bool mt_safe);
+
+    /// @brief Thread unsafe callback for updating a lease.
+    ///
+    /// @param lease updated lease.
+    void updateLeaseCallbackInternal(LeasePtr lease);
+
+    /// @brief Thread safe callback for deleting a lease.
+    ///
+    /// Marks the lease address free.
+    ///
+    /// @param lease deleted lease.
+    /// @param mt_safe a boolean flag indicating if the callback
+    /// has been invoked in the MT-safe context.
+    void deleteLeaseCallback(LeasePtr lease, bool mt_safe);
+
+    /// @brief Thread unsafe callback for deleting a lease.
+    ///
+    /// @param lease deleted lease.
+    void deleteLeaseCallbackInternal(LeasePtr lease);
+
+    /// @brief Convenience function returning a random number.
+    ///
+    /// @param limit upper bound of the range.
+    /// @returns random number between 0 and limit.
+    uint64_t getRandomNumber(uint64_t limit);
+
+    /// @brief Random generator used by this class.
+    std::mt19937 generator_;
+};
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // BITMAP_ALLOCATOR_H
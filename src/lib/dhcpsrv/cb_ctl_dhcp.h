@@ -1,4 +1,4 @@
-// Copyright (C) 2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2019-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,6 +10,12 @@
 #include <cc/stamped_value.h>
 #include <process/cb_ctl_base.h>
 #include <dhcpsrv/srv_config.h>
+#include <util/hash.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <map>
+#include <string>
+#include <utility>
 
 namespace isc {
 namespace dhcp {
@@ -29,11 +35,71 @@ public:
 
     /// @brief Constructor.
     CBControlDHCP()
-        : process::CBControlBase<ConfigBackendMgrType>() {
+        : process::CBControlBase<ConfigBackendMgrType>(),
+          applied_contents_(), pending_contents_() {
     }
 
 protected:
 
+    /// @brief Checks if a configuration element fetched from the config
+    /// backend differs from the one applied by a previous update.
+    ///
+    /// The elements applied by the updates are remembered by object type
+    /// and identifier with their modification time and a hash of their
+    /// unparsed content. An element with the same modification time or
+    /// the same content hash is unchanged, e.g. a subnet fetched again
+    /// because an option of its shared network was modified. The new
+    /// modification time and hash are recorded as pending until
+    /// @c commitContents is called.
+    ///
+    /// @param object_type The object type in the audit entries.
+    /// @param object_id The identifier of the element.
+    /// @param modification_time The modification time of the element.
+    /// @param content The unparsed element.
+    /// @return true if the element was not applied or has changed.
+    bool contentChanged(const std::string& object_type, uint64_t object_id,
+                        const boost::posix_time::ptime& modification_time,
+                        const data::ConstElementPtr& content) {
+        auto key = std::make_pair(object_type, object_id);
+        auto applied = applied_contents_.find(key);
+        if ((applied != applied_contents_.end()) &&
+            (applied->second.modification_time_ == modification_time)) {
+            return (false);
+        }
+        uint64_t hash = util::Hash64::hash(content->str());
+        pending_contents_[key] = AppliedContent{ modification_time, hash };
+        return ((applied == applied_contents_.end()) ||
+                (applied->second.hash_ != hash));
+    }
+
+    /// @brief Remembers the contents checked since the last call as
+    /// applied.
+    ///
+    /// It must be called once the fetched elements have been merged into
+    /// the current configuration.
+    void commitContents() {
+        for (auto const& content : pending_contents_) {
+            applied_contents_[content.first] = content.second;
+        }
+        pending_contents_.clear();
+    }
+
+    /// @brief Forgets the pending contents.
+    ///
+    /// It must be called when an update begins, so the contents checked
+    /// by a failed update are not committed.
+    void discardContents() {
+        pending_contents_.clear();
+    }
+
+    /// @brief Forgets the applied and pending contents.
+    ///
+    /// It must be called when the whole configuration is fetched again.
+    void clearContents() {
+        applied_contents_.clear();
+        pending_contents_.clear();
+    }
+
     /// @brief Adds globals fetched from config backend(s) to a SrvConfig instance
     ///
     /// Iterates over the given collection of global parameters and adds them to the
@@ -55,6 +121,26 @@ protected:
                                               (*cb_global)->getElementValue());
         }
     }
+
+private:
+
+    /// @brief The content of an applied element.
+    struct AppliedContent {
+        /// @brief The modification time of the element.
+        boost::posix_time::ptime modification_time_;
+
+        /// @brief The hash of the unparsed element.
+        uint64_t hash_;
+    };
+
+    /// @brief Type of the contents by object type and identifier.
+    typedef std::map<std::pair<std::string, uint64_t>, AppliedContent> AppliedContentMap;
+
+    /// @brief The contents of the elements applied by the updates.
+    AppliedContentMap applied_contents_;
+
+    /// @brief The contents of the elements checked by the running update.
+    AppliedContentMap pending_contents_;
 };
 
 } // end of namespace isc::dhcp
@@ -12,11 +12,15 @@
 #include <dhcpsrv/parsers/simple_parser6.h>
 #include <hooks/callout_handle.h>
 #include <hooks/hooks_manager.h>
+#include <util/multi_threading_mgr.h>
+
+#include <boost/scoped_ptr.hpp>
 
 using namespace isc::db;
 using namespace isc::data;
 using namespace isc::process;
 using namespace isc::hooks;
+using namespace isc::util;
 
 namespace {
 
@@ -41,6 +45,22 @@ CbCtlHooks hooks_;
 namespace isc {
 namespace dhcp {
 
+namespace {
+
+/// @brief Returns the content of a subnet fetched from the config backend.
+///
+/// @param subnet The subnet.
+/// @return The unparsed subnet with the name of its shared network.
+ConstElementPtr
+subnetContent(const Subnet6Ptr& subnet) {
+    ElementPtr content = subnet->toElement();
+    content->set("shared-network-name",
+                 Element::create(subnet->getSharedNetworkName()));
+    return (content);
+}
+
+} // end of anonymous namespace
+
 void
 CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector,
                                      const db::ServerSelector& server_selector,
@@ -51,14 +71,20 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
     auto cb_update = !reconfig;
     auto current_cfg = CfgMgr::instance().getCurrentCfg();
     auto staging_cfg = CfgMgr::instance().getStagingCfg();
+    SrvConfigPtr globals_cfg;
+
+    // The contents of the elements applied by the previous updates are
+    // only valid until the whole configuration is fetched again.
+    if (reconfig) {
+        clearContents();
+    } else {
+        discardContents();
+    }
 
-    // Let's first delete all the configuration elements for which DELETE audit
-    // entries are found. Although, this may break chronology of the audit in
-    // some cases it should not affect the end result of the data fetch. If the
-    // object was created and then subsequently deleted, we will first try to
-    // delete this object from the local configuration (which will fail because
-    // the object does not exist) and then we will try to fetch it from the
-    // database which will return no result.
+    // All the database queries are made before the current configuration
+    // is changed so the packet processing threads are stopped only while the
+    // fetched updates are applied. When the global parameters have been
+    // deleted all of them are fetched again and replace the existing ones.
     if (cb_update) {
 
         auto external_cfg = CfgMgr::instance().createExternalCfg();
@@ -85,74 +111,53 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
             external_cfg->sanityChecksLifetime("preferred-lifetime");
             external_cfg->sanityChecksLifetime("valid-lifetime");
 
-            // Now that we successfully fetched the new global parameters, let's
-            // remove existing ones and merge them into the current configuration.
-            current_cfg->clearConfiguredGlobals();
-            CfgMgr::instance().mergeIntoCurrentCfg(external_cfg->getSequence());
+            // Now that we successfully fetched the new global parameters, they
+            // replace the existing ones when the updates are applied.
+            globals_cfg = external_cfg;
             globals_fetched = true;
         }
-
-        try {
-            // Get audit entries for deleted option definitions and delete each
-            // option definition from the current configuration for which the
-            // audit entry is found.
-            range = index.equal_range(boost::make_tuple("dhcp6_option_def",
-                                                        AuditEntry::ModificationType::DELETE));
-            for (auto entry = range.first; entry != range.second; ++entry) {
-                current_cfg->getCfgOptionDef()->del((*entry)->getObjectId());
-            }
-
-            // Repeat the same for other configuration elements.
-
-            range = index.equal_range(boost::make_tuple("dhcp6_options",
-                                                        AuditEntry::ModificationType::DELETE));
-            for (auto entry = range.first; entry != range.second; ++entry) {
-                current_cfg->getCfgOption()->del((*entry)->getObjectId());
-            }
-
-            range = index.equal_range(boost::make_tuple("dhcp6_client_class",
-                                                        AuditEntry::ModificationType::DELETE));
-            for (auto entry = range.first; entry != range.second; ++entry) {
-                current_cfg->getClientClassDictionary()->removeClass((*entry)->getObjectId());
-            }
-
-            range = index.equal_range(boost::make_tuple("dhcp6_shared_network",
-                                                        AuditEntry::ModificationType::DELETE));
-            for (auto entry = range.first; entry != range.second; ++entry) {
-                current_cfg->getCfgSharedNetworks6()->del((*entry)->getObjectId());
-            }
-
-            range = index.equal_range(boost::make_tuple("dhcp6_subnet",
-                                                        AuditEntry::ModificationType::DELETE));
-            for (auto entry = range.first; entry != range.second; ++entry) {
-                // If the deleted subnet belongs to a shared network and the
-                // shared network is not being removed, we need to detach the
-                // subnet from the shared network.
-                auto subnet = current_cfg->getCfgSubnets6()->getBySubnetId((*entry)->getObjectId());
-                if (subnet) {
-                    // Check if the subnet belongs to a shared network.
-                    SharedNetwork6Ptr network;
-                    subnet->getSharedNetwork(network);
-                    if (network) {
-                        // Detach the subnet from the shared network.
-                        network->del(subnet->getID());
-                    }
-                    // Actually delete the subnet from the configuration.
-                    current_cfg->getCfgSubnets6()->del((*entry)->getObjectId());
-                }
-            }
-
-        } catch (...) {
-            // Ignore errors thrown when attempting to delete a non-existing
-            // configuration entry. There is no guarantee that the deleted
-            // entry is actually there as we're not processing the audit
-            // chronologically.
-        }
     }
 
     // Create the external config into which we'll fetch backend config data.
     SrvConfigPtr external_cfg = CfgMgr::instance().createExternalCfg();
 
+    // The server (re)configuration fetches all the configuration elements.
+    // When the backends support it, the elements are fetched in parallel,
+    // each over its own database connection.
+    data::StampedValueCollection globals;
+    OptionDefContainer option_defs;
+    OptionContainer options;
+    ClientClassDictionary client_classes;
+    SharedNetwork6Collection networks;
+    Subnet6Collection subnets;
+    auto prefetched = false;
+    if (reconfig && !globals_fetched && getMgr().getPool()->supportsParallelFetch()) {
+        parallelConfigFetch({
+            [&](const ConfigBackendPoolDHCPv6Ptr& pool) {
+                globals = pool->getModifiedGlobalParameters6(backend_selector, server_selector,
+                                                             lb_modification_time);
+            },
+            [&](const ConfigBackendPoolDHCPv6Ptr& pool) {
+                option_defs = pool->getModifiedOptionDefs6(backend_selector, server_selector,
+                                                           lb_modification_time);
+            },
+            [&](const ConfigBackendPoolDHCPv6Ptr& pool) {
+                options = pool->getModifiedOptions6(backend_selector, server_selector,
+                                                    lb_modification_time);
+            },
+            [&](const ConfigBackendPoolDHCPv6Ptr& pool) {
+                client_classes = pool->getAllClientClasses6(backend_selector, server_selector);
+            },
+            [&](const ConfigBackendPoolDHCPv6Ptr& pool) {
+                networks = pool->getAllSharedNetworks6(backend_selector, server_selector);
+            },
+            [&](const ConfigBackendPoolDHCPv6Ptr& pool) {
+                subnets = pool->getAllSubnets6(backend_selector, server_selector);
+            }
+        });
+        prefetched = true;
+    }
+
     // First let's fetch the globals and add them to external config.
     AuditEntryCollection updated_entries;
     if (!globals_fetched) {
@@ -160,9 +165,10 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
             updated_entries = fetchConfigElement(audit_entries, "dhcp6_global_parameter");
         }
         if (reconfig || !updated_entries.empty()) {
-            data::StampedValueCollection globals;
-            globals = getMgr().getPool()->getModifiedGlobalParameters6(backend_selector, server_selector,
-                                                                       lb_modification_time);
+            if (!prefetched) {
+                globals = getMgr().getPool()->getModifiedGlobalParameters6(backend_selector, server_selector,
+                                                                           lb_modification_time);
+            }
             addGlobalsToConfig(external_cfg, globals);
             globals_fetched = true;
         }
@@ -173,9 +179,10 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
         updated_entries = fetchConfigElement(audit_entries, "dhcp6_option_def");
     }
     if (reconfig || !updated_entries.empty()) {
-        OptionDefContainer option_defs =
-            getMgr().getPool()->getModifiedOptionDefs6(backend_selector, server_selector,
-                                                       lb_modification_time);
+        if (!prefetched) {
+            option_defs = getMgr().getPool()->getModifiedOptionDefs6(backend_selector, server_selector,
+                                                                     lb_modification_time);
+        }
         for (auto option_def = option_defs.begin(); option_def != option_defs.end(); ++option_def) {
             if (!audit_entries.empty() && !hasObjectId(updated_entries, (*option_def)->getId())) {
                 continue;
@@ -189,9 +196,11 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
         updated_entries = fetchConfigElement(audit_entries, "dhcp6_options");
     }
     if (reconfig || !updated_entries.empty()) {
-        OptionContainer options = getMgr().getPool()->getModifiedOptions6(backend_selector,
-                                                                          server_selector,
-                                                                          lb_modification_time);
+        if (!prefetched) {
+            options = getMgr().getPool()->getModifiedOptions6(backend_selector,
+                                                              server_selector,
+                                                              lb_modification_time);
+        }
         for (auto option = options.begin(); option != options.end(); ++option) {
             if (!audit_entries.empty() && !hasObjectId(updated_entries, (*option).getId())) {
                 continue;
@@ -205,8 +214,10 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
         updated_entries = fetchConfigElement(audit_entries, "dhcp6_client_class");
     }
     if (reconfig || !updated_entries.empty()) {
-        ClientClassDictionary client_classes = getMgr().getPool()->getAllClientClasses6(backend_selector,
-                                                                                        server_selector);
+        if (!prefetched) {
+            client_classes = getMgr().getPool()->getAllClientClasses6(backend_selector,
+                                                                      server_selector);
+        }
         // Match expressions are not initialized for classes returned from the config backend.
         // We have to ensure to initialize them before they can be used by the server.
         client_classes.initMatchExpr(AF_INET6);
@@ -240,7 +251,8 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
     // We're only affected by the allocator change if this is the update from
     // the configuration backend.
     if (cb_update) {
-        auto allocator = CfgMgr::instance().getCurrentCfg()->getConfiguredGlobal(CfgGlobals::ALLOCATOR);
+        auto allocator = (globals_cfg ? globals_cfg : CfgMgr::instance().getCurrentCfg())->
+            getConfiguredGlobal(CfgGlobals::ALLOCATOR);
         if (allocator && (allocator->getType() == Element::string)) {
             allocator_changed = (global_allocator != allocator->stringValue());
         }
@@ -248,7 +260,8 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
         // The address allocator hasn't changed. So, let's check if the PD allocator
         // has changed.
         if (!allocator_changed) {
-            auto allocator = CfgMgr::instance().getCurrentCfg()->getConfiguredGlobal(CfgGlobals::PD_ALLOCATOR);
+            auto allocator = (globals_cfg ? globals_cfg : CfgMgr::instance().getCurrentCfg())->
+                getConfiguredGlobal(CfgGlobals::PD_ALLOCATOR);
             if (allocator && (allocator->getType() == Element::string)) {
                 allocator_changed = (global_pd_allocator != allocator->stringValue());
             }
@@ -259,8 +272,10 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
     if (cb_update) {
         updated_entries = fetchConfigElement(audit_entries, "dhcp6_shared_network");
     }
-    SharedNetwork6Collection networks;
-    if (allocator_changed || reconfig) {
+    if (prefetched) {
+        // All shared networks have been fetched above.
+
+    } else if (allocator_changed || reconfig) {
         // A change of the allocator or the server reconfiguration can affect all
         // shared networks. Get all shared networks.
         networks = getMgr().getPool()->getAllSharedNetworks6(backend_selector, server_selector);
@@ -280,6 +295,16 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
         });
         (*network)->setDefaultAllocatorType(global_allocator);
         (*network)->setDefaultPdAllocatorType(global_pd_allocator);
+        // Skip the shared networks which have not changed since they were
+        // applied by a previous update.
+        if (cb_update &&
+            !contentChanged("dhcp6_shared_network", (*network)->getId(),
+                            (*network)->getModificationTime(),
+                            (*network)->toElement()) &&
+            !allocator_changed &&
+            current_cfg->getCfgSharedNetworks6()->getByName((*network)->getName())) {
+            continue;
+        }
         external_cfg->getCfgSharedNetworks6()->add((*network));
     }
 
@@ -287,8 +312,10 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
     if (cb_update) {
         updated_entries = fetchConfigElement(audit_entries, "dhcp6_subnet");
     }
-    Subnet6Collection subnets;
-    if (allocator_changed || reconfig) {
+    if (prefetched) {
+        // All subnets have been fetched above.
+
+    } else if (allocator_changed || reconfig) {
         // A change of the allocator or the server reconfiguration can affect all
         // subnets. Get all subnets.
         subnets = getMgr().getPool()->getAllSubnets6(backend_selector, server_selector);
@@ -313,9 +340,22 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
         });
         (*subnet)->setDefaultAllocatorType(global_allocator);
         (*subnet)->setDefaultPdAllocatorType(global_pd_allocator);
+        // Skip the subnets which have not changed since they were applied
+        // by a previous update, e.g. the subnets of a shared network fetched
+        // again because an option of the network was modified.
+        if (cb_update &&
+            !contentChanged("dhcp6_subnet", (*subnet)->getID(),
+                            (*subnet)->getModificationTime(),
+                            subnetContent(*subnet)) &&
+            !allocator_changed &&
+            current_cfg->getCfgSubnets6()->getBySubnetId((*subnet)->getID())) {
+            continue;
+        }
         external_cfg->getCfgSubnets6()->add((*subnet));
     }
 
+    // Stops the packet processing threads while the updates are applied.
+    boost::scoped_ptr<MultiThreadingCriticalSection> cs;
     if (reconfig) {
         // If we're configuring the server after startup, we do not apply the
         // ip-reservations-unique setting here. It will be applied when the
@@ -326,6 +366,82 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
         CfgMgr::instance().mergeIntoStagingCfg(external_cfg->getSequence());
 
     } else {
+        // All the updates have been fetched from the database: the packet
+        // processing threads are stopped only while they are applied to the
+        // current configuration.
+        cs.reset(new MultiThreadingCriticalSection());
+
+        if (globals_cfg) {
+            // Replace the existing global parameters.
+            current_cfg->clearConfiguredGlobals();
+            CfgMgr::instance().mergeIntoCurrentCfg(globals_cfg->getSequence());
+        }
+
+        // Let's delete all the configuration elements for which DELETE audit
+        // entries are found. Although, this may break chronology of the
+        // audit in some cases it should not affect the end result of the data
+        // fetch. If the object was created and then subsequently deleted, we
+        // will first try to delete this object from the local configuration
+        // (which will fail because the object does not exist) and then we will
+        // try to fetch it from the database which will return no result.
+        const auto& index = audit_entries.get<AuditEntryObjectTypeTag>();
+        try {
+            // Get audit entries for deleted option definitions and delete each
+            // option definition from the current configuration for which the
+            // audit entry is found.
+            auto range = index.equal_range(boost::make_tuple("dhcp6_option_def",
+                                                             AuditEntry::ModificationType::DELETE));
+            for (auto entry = range.first; entry != range.second; ++entry) {
+                current_cfg->getCfgOptionDef()->del((*entry)->getObjectId());
+            }
+
+            // Repeat the same for other configuration elements.
+
+            range = index.equal_range(boost::make_tuple("dhcp6_options",
+                                                        AuditEntry::ModificationType::DELETE));
+            for (auto entry = range.first; entry != range.second; ++entry) {
+                current_cfg->getCfgOption()->del((*entry)->getObjectId());
+            }
+
+            range = index.equal_range(boost::make_tuple("dhcp6_client_class",
+                                                        AuditEntry::ModificationType::DELETE));
+            for (auto entry = range.first; entry != range.second; ++entry) {
+                current_cfg->getClientClassDictionary()->removeClass((*entry)->getObjectId());
+            }
+
+            range = index.equal_range(boost::make_tuple("dhcp6_shared_network",
+                                                        AuditEntry::ModificationType::DELETE));
+            for (auto entry = range.first; entry != range.second; ++entry) {
+                current_cfg->getCfgSharedNetworks6()->del((*entry)->getObjectId());
+            }
+
+            range = index.equal_range(boost::make_tuple("dhcp6_subnet",
+                                                        AuditEntry::ModificationType::DELETE));
+            for (auto entry = range.first; entry != range.second; ++entry) {
+                // If the deleted subnet belongs to a shared network and the
+                // shared network is not being removed, we need to detach the
+                // subnet from the shared network.
+                auto subnet = current_cfg->getCfgSubnets6()->getBySubnetId((*entry)->getObjectId());
+                if (subnet) {
+                    // Check if the subnet belongs to a shared network.
+                    SharedNetwork6Ptr network;
+                    subnet->getSharedNetwork(network);
+                    if (network) {
+                        // Detach the subnet from the shared network.
+                        network->del(subnet->getID());
+                    }
+                    // Actually delete the subnet from the configuration.
+                    current_cfg->getCfgSubnets6()->del((*entry)->getObjectId());
+                }
+            }
+
+        } catch (...) {
+            // Ignore errors thrown when attempting to delete a non-existing
+            // configuration entry. There is no guarantee that the deleted
+            // entry is actually there as we're not processing the audit
+            // chronologically.
+        }
+
         if (globals_fetched) {
             // ip-reservations-unique parameter requires special handling because
             // setting it to false may be unsupported by some host backends.
@@ -348,6 +464,11 @@ CBControlDHCPv6::databaseConfigApply(const db::BackendSelector& backend_selector
         external_cfg->sanityChecksLifetime(*cfg, "valid-lifetime");
         CfgMgr::instance().mergeIntoCurrentCfg(external_cfg->getSequence());
         CfgMgr::instance().getCurrentCfg()->getCfgSubnets6()->initAllocatorsAfterConfigure();
+        // The fetched elements are now applied.
+        commitContents();
+        // The cached host lookups may depend on the updated subnets and
+        // global parameters, e.g. on reservations-in-subnet.
+        HostMgr::instance().flushCache();
     }
     LOG_INFO(dhcpsrv_logger, DHCPSRV_CFGMGR_CONFIG6_MERGED);
 
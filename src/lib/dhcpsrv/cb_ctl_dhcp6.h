@@ -1,4 +1,4 @@
-// Copyright (C) 2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2019-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -29,6 +29,11 @@ protected:
     /// @brief DHCPv6 server specific method to fetch and apply back end
     /// configuration into the local configuration.
     ///
+    /// When the updates are applied to the current configuration this
+    /// method enters a critical section, stopping the packet processing
+    /// threads, only after all the updated elements have been fetched
+    /// from the database.
+    ///
     /// @param backend_selector Backend selector.
     /// @param server_selector Server selector.
     /// @param lb_modification_time Lower bound modification time for the
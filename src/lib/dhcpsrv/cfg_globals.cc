@@ -6,6 +6,7 @@
 
 #include <config.h>
 #include <dhcpsrv/cfg_globals.h>
+#include <dhcpsrv/network.h>
 
 using namespace isc::data;
 
@@ -110,7 +111,7 @@ struct CfgGlobalsChecks {
 CfgGlobalsChecks check;
 } // end of anonymous namespace
 
-CfgGlobals::CfgGlobals() : values_(SIZE) {
+CfgGlobals::CfgGlobals() : values_(SIZE), version_(0) {
 }
 
 ConstElementPtr
@@ -145,6 +146,8 @@ CfgGlobals::set(int index, ConstElementPtr value) {
         isc_throw(OutOfRange, "invalid global parameter index " << index);
     }
     values_[index] = value;
+    ++version_;
+    Network::invalidateResolvedProperties();
 }
 
 void
@@ -154,6 +157,8 @@ CfgGlobals::clear() {
             values_[idx] = ConstElementPtr();
         }
     }
+    ++version_;
+    Network::invalidateResolvedProperties();
 }
 
 const CfgGlobals::MapType
@@ -137,6 +137,15 @@ public:
     /// @brief Clear configured parameter values.
     void clear();
 
+    /// @brief Returns the version of the configured parameter values.
+    ///
+    /// The version is incremented each time the values are modified.
+    ///
+    /// @return The version of the configured parameter values.
+    uint64_t getVersion() const {
+        return (version_);
+    }
+
     /// @brief Type of name and value map.
     typedef std::map<std::string, isc::data::ConstElementPtr> MapType;
 
@@ -154,6 +163,9 @@ public:
 protected:
     /// @brief Vectors of values.
     std::vector<isc::data::ConstElementPtr> values_;
+
+    /// @brief Version of the values.
+    uint64_t version_;
 };
 
 /// @brief Non-const shared pointer to a CfgGlobals instance.
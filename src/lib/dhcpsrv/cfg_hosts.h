@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -598,6 +598,13 @@ public:
         return (std::string("configuration file"));
     }
 
+    /// @brief Returns the number of hosts.
+    ///
+    /// @return the number of hosts in the host container.
+    size_t size() const {
+        return (hosts_.size());
+    }
+
     /// @brief Controls whether IP reservations are unique or non-unique.
     ///
     /// In a typical case, the IP reservations are unique and backends verify
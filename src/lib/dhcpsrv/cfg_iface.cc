@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,6 +9,7 @@
 #include <dhcpsrv/dhcpsrv_log.h>
 #include <dhcpsrv/cfg_iface.h>
 #include <dhcpsrv/timer_mgr.h>
+#include <util/fd_event_handler_factory.h>
 #include <util/reconnect_ctl.h>
 #include <util/multi_threading_mgr.h>
 #include <util/strutil.h>
@@ -30,7 +31,8 @@ CfgIface::OpenSocketsFailedCallback CfgIface::open_sockets_failed_callback_ = 0;
 CfgIface::CfgIface()
     : wildcard_used_(false), socket_type_(SOCKET_RAW), re_detect_(false),
       service_socket_require_all_(false), service_sockets_retry_wait_time_(5000),
-      service_sockets_max_retries_(0),
+      service_sockets_max_retries_(0), accepted_relays_(),
+      event_handler_type_(FDEventHandler::TYPE_UNKNOWN),
       outbound_iface_(SAME_AS_INBOUND) {
 }
 
@@ -44,7 +46,9 @@ CfgIface::equals(const CfgIface& other) const {
     return (iface_set_ == other.iface_set_ &&
             address_map_ == other.address_map_ &&
             wildcard_used_ == other.wildcard_used_ &&
-            socket_type_ == other.socket_type_);
+            socket_type_ == other.socket_type_ &&
+            accepted_relays_ == other.accepted_relays_ &&
+            event_handler_type_ == other.event_handler_type_);
 }
 
 bool
@@ -96,6 +100,14 @@ CfgIface::openSockets(const uint16_t family, const uint16_t port,
     iface_mgr.clearUnicasts();
     // Allow the loopback interface when required.
     iface_mgr.setAllowLoopBack(loopback_used_);
+    // Select the event handler, the receiver thread was stopped with the
+    // sockets. The environment variable overrides the configured type.
+    FDEventHandlerFactory::setDefaultType(event_handler_type_);
+    FDEventHandler::HandlerType handler_type =
+        FDEventHandlerFactory::getDefaultType();
+    if (iface_mgr.getEventHandlerType() != handler_type) {
+        iface_mgr.setEventHandlerType(handler_type);
+    }
     // For the DHCPv4 server, if the user has selected that raw sockets
     // should be used, we will try to configure the Interface Manager to
     // support the direct responses to the clients that don't have the
@@ -104,6 +116,7 @@ CfgIface::openSockets(const uint16_t family, const uint16_t port,
     // systems, so there is no guarantee.
     if ((family == AF_INET) && (!IfaceMgr::instance().isTestMode())) {
         iface_mgr.setMatchingPacketFilter(socket_type_ == SOCKET_RAW);
+        iface_mgr.setAcceptedRelays(accepted_relays_);
         if ((socket_type_ == SOCKET_RAW) &&
             !iface_mgr.isDirectResponseSupported()) {
             LOG_WARN(dhcpsrv_logger, DHCPSRV_CFGMGR_SOCKET_RAW_UNSUPPORTED);
@@ -375,6 +388,19 @@ CfgIface::textToOutboundIface(const std::string& txt) {
     }
 }
 
+void
+CfgIface::addAcceptedRelay(const IOAddress& prefix, uint8_t len) {
+    if (!prefix.isV4() || (len > 32)) {
+        isc_throw(BadValue, "invalid accepted relay prefix "
+                  << prefix << "/" << static_cast<unsigned>(len));
+    }
+    if (accepted_relays_.size() >= MAX_ACCEPTED_RELAYS) {
+        isc_throw(BadValue, "too many accepted relays, the maximum is "
+                  << MAX_ACCEPTED_RELAYS);
+    }
+    accepted_relays_.push_back(std::make_pair(prefix, len));
+}
+
 void
 CfgIface::setOutboundIface(const OutboundIface& outbound_iface) {
     outbound_iface_ = outbound_iface;
@@ -600,6 +626,22 @@ CfgIface::toElement() const {
         result->set("service-sockets-retry-wait-time", Element::create(static_cast<int>(service_sockets_retry_wait_time_)));
     }
 
+    // Set accepted-relays
+    if (!accepted_relays_.empty()) {
+        ElementPtr relays = Element::createList();
+        for (auto const& relay : accepted_relays_) {
+            relays->add(Element::create(relay.first.toText() + "/" +
+                                        std::to_string(relay.second)));
+        }
+        result->set("accepted-relays", relays);
+    }
+
+    // Set event-handler-type
+    if (event_handler_type_ != FDEventHandler::TYPE_UNKNOWN) {
+        result->set("event-handler-type",
+                    Element::create(FDEventHandlerFactory::typeToText(event_handler_type_)));
+    }
+
     return (result);
 }
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,6 +9,7 @@
 
 #include <asiolink/io_address.h>
 #include <dhcp/iface_mgr.h>
+#include <util/fd_event_handler.h>
 #include <util/reconnect_ctl.h>
 #include <cc/cfg_to_element.h>
 #include <cc/user_context.h>
@@ -345,6 +346,44 @@ public:
         return (service_sockets_max_retries_);
     }
 
+    /// @brief Adds the prefix of an accepted relay.
+    ///
+    /// When relays are accepted, the DHCPv4 raw sockets drop the relayed
+    /// messages the giaddr of which does not belong to one of the accepted
+    /// prefixes in the kernel.
+    ///
+    /// @param prefix the IPv4 prefix.
+    /// @param len the prefix length.
+    /// @throw BadValue if the prefix is not an IPv4 prefix or the maximum
+    /// number of prefixes is reached.
+    void addAcceptedRelay(const asiolink::IOAddress& prefix, uint8_t len);
+
+    /// @brief Returns the prefixes of the accepted relays.
+    ///
+    /// @return the prefixes, empty when all the relays are accepted.
+    const RelayPrefixes& getAcceptedRelays() const {
+        return (accepted_relays_);
+    }
+
+    /// @brief Sets the type of the event handler waiting for data on the
+    /// sockets.
+    ///
+    /// The type is applied by @c openSockets unless the
+    /// KEA_EVENT_HANDLER_TYPE environment variable overrides it.
+    ///
+    /// @param type the event handler type, TYPE_UNKNOWN when not
+    /// configured.
+    void setEventHandlerType(util::FDEventHandler::HandlerType type) {
+        event_handler_type_ = type;
+    }
+
+    /// @brief Returns the configured type of the event handler.
+    ///
+    /// @return the event handler type, TYPE_UNKNOWN when not configured.
+    util::FDEventHandler::HandlerType getEventHandlerType() const {
+        return (event_handler_type_);
+    }
+
     /// @brief Get the reconnect controller.
     ///
     /// @return the reconnect controller
@@ -490,6 +529,12 @@ private:
     /// @brief A maximum number of attempts to bind the service sockets.
     uint32_t service_sockets_max_retries_;
 
+    /// @brief The prefixes of the accepted relays.
+    RelayPrefixes accepted_relays_;
+
+    /// @brief The configured type of the event handler.
+    util::FDEventHandler::HandlerType event_handler_type_;
+
     /// @brief Indicates how outbound interface is selected for relayed traffic.
     OutboundIface outbound_iface_;
 
@@ -24,6 +24,8 @@ CfgMultiThreading::apply(ConstElementPtr value) {
     uint32_t thread_count = 0;
     uint32_t queue_size = 0;
     CfgMultiThreading::extract(value, enabled, thread_count, queue_size);
+    // The CPU affinity is applied when apply (re)starts the thread pool.
+    MultiThreadingMgr::instance().setCpuAffinity(extractCpuAffinity(value, "cpu-affinity"));
     MultiThreadingMgr::instance().apply(enabled, thread_count, queue_size);
 }
 
@@ -48,5 +50,14 @@ CfgMultiThreading::extract(ConstElementPtr value, bool& enabled,
     }
 }
 
+CpuList
+CfgMultiThreading::extractCpuAffinity(ConstElementPtr value,
+                                      const std::string& name) {
+    if (!value || !value->get(name)) {
+        return (CpuList());
+    }
+    return (parseCpuList(SimpleParser::getString(value, name)));
+}
+
 }  // namespace dhcp
 }  // namespace isc
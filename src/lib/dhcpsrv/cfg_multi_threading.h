@@ -8,6 +8,9 @@
 #define CFG_MULTI_THREADING_H
 
 #include <cc/data.h>
+#include <util/cpu_affinity.h>
+
+#include <string>
 
 namespace isc {
 namespace dhcp {
@@ -34,6 +37,17 @@ public:
     /// @param[out] queue_size The queue size
     static void extract(data::ConstElementPtr value, bool& enabled,
                         uint32_t& thread_count, uint32_t& queue_size);
+
+    /// @brief Extract a CPU affinity parameter from a given configuration.
+    ///
+    /// @param value The multi-threading configuration
+    /// @param name The name of the parameter: "cpu-affinity" for the
+    /// thread pool threads or "receiver-cpu-affinity" for the receiver
+    /// threads
+    /// @return The CPU list, empty when the parameter is not set
+    /// @throw BadValue if the CPU list is not valid
+    static util::CpuList extractCpuAffinity(data::ConstElementPtr value,
+                                            const std::string& name);
 };
 
 }  // namespace dhcp
@@ -11,6 +11,7 @@
 #include <dhcpsrv/cfg_subnets4.h>
 #include <dhcpsrv/dhcpsrv_log.h>
 #include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/memfile_lease_mgr.h>
 #include <dhcpsrv/shared_network.h>
 #include <dhcpsrv/subnet_id.h>
 #include <asiolink/io_address.h>
@@ -40,6 +41,7 @@ CfgSubnets4::add(const Subnet4Ptr& subnet) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_ADD_SUBNET4)
               .arg(subnet->toText());
     static_cast<void>(subnets_.insert(subnet));
+    prefix_index_.add(subnet);
 }
 
 Subnet4Ptr
@@ -53,6 +55,10 @@ CfgSubnets4::replace(const Subnet4Ptr& subnet) {
     }
     Subnet4Ptr old = *subnet_it;
     bool ret = index.replace(subnet_it, subnet);
+    if (ret) {
+        prefix_index_.del(old);
+        prefix_index_.add(subnet);
+    }
 
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_UPDATE_SUBNET4)
         .arg(subnet_id).arg(ret);
@@ -80,6 +86,7 @@ CfgSubnets4::del(const SubnetID& subnet_id) {
     Subnet4Ptr subnet = *subnet_it;
 
     index.erase(subnet_it);
+    prefix_index_.del(subnet);
 
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_DEL_SUBNET4)
         .arg(subnet->toText());
@@ -124,6 +131,7 @@ CfgSubnets4::merge(CfgOptionDefPtr cfg_def, CfgSharedNetworks4Ptr networks,
             }
 
             // Now we remove the existing subnet.
+            prefix_index_.del(existing_subnet);
             index_id.erase(subnet_id_it);
         }
 
@@ -148,6 +156,7 @@ CfgSubnets4::merge(CfgOptionDefPtr cfg_def, CfgSharedNetworks4Ptr networks,
             }
 
             // Now we remove the existing subnet.
+            prefix_index_.del(existing_subnet);
             index_prefix.erase(subnet_prefix_it);
         }
 
@@ -161,6 +170,7 @@ CfgSubnets4::merge(CfgOptionDefPtr cfg_def, CfgSharedNetworks4Ptr networks,
 
         // Add the "other" subnet to the our collection of subnets.
         static_cast<void>(subnets_.insert(other_subnet));
+        prefix_index_.add(other_subnet);
 
         // If it belongs to a shared network, find the network and
         // add the subnet to it
@@ -234,9 +244,9 @@ CfgSubnets4::initSelector(const Pkt4Ptr& query) {
                                    getIgnoreRAILinkSelection();
             if (!ignore_link_sel) {
                 OptionPtr link_select =
-                    rai_custom->getOption(RAI_OPTION_LINK_SELECTION);
+                    query->getRAISubOption(RAI_OPTION_LINK_SELECTION);
                 if (link_select) {
-                    OptionBuffer link_select_buf = link_select->getData();
+                    const OptionBuffer& link_select_buf = link_select->getData();
                     if (link_select_buf.size() == sizeof(uint32_t)) {
                         selector.option_select_ =
                             IOAddress::fromBytes(AF_INET, &link_select_buf[0]);
@@ -473,12 +483,8 @@ CfgSubnets4::getSubnet(const SubnetID id) const {
 Subnet4Ptr
 CfgSubnets4::selectSubnet(const IOAddress& address,
                           const ClientClasses& client_classes) const {
-    for (auto const& subnet : subnets_) {
-
-        // Address is in range for the subnet prefix, so return it.
-        if (!subnet->inRange(address)) {
-            continue;
-        }
+    // The index returns the subnets the address is in range for.
+    for (auto const& subnet : prefix_index_.getAll(address)) {
 
         // If a subnet meets the client class criteria return it.
         if (subnet->clientSupported(client_classes)) {
@@ -501,10 +507,7 @@ SubnetIDSet
 CfgSubnets4::getLinks(const IOAddress& link_addr, uint8_t& link_len) const {
     SubnetIDSet links;
     bool link_len_set = false;
-    for (auto const& subnet : subnets_) {
-        if (!subnet->inRange(link_addr)) {
-            continue;
-        }
+    for (auto const& subnet : prefix_index_.getAll(link_addr)) {
         uint8_t plen = subnet->get().second;
         if (!link_len_set || (plen < link_len)) {
             link_len_set = true;
@@ -517,34 +520,103 @@ CfgSubnets4::getLinks(const IOAddress& link_addr, uint8_t& link_len) const {
 
 void
 CfgSubnets4::removeStatistics() {
+    // For each v4 subnet currently configured, remove the statistic.
+    for (auto const& subnet4 : subnets_) {
+        removeSubnetStatistics(subnet4->getID());
+    }
+}
+
+void
+CfgSubnets4::removeSubnetStatistics(const SubnetID& subnet_id) {
     using namespace isc::stats;
 
-    // For each v4 subnet currently configured, remove the statistic.
     StatsMgr& stats_mgr = StatsMgr::instance();
-    for (auto const& subnet4 : subnets_) {
-        SubnetID subnet_id = subnet4->getID();
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
-                                             "total-addresses"));
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "total-addresses"));
 
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
-                                             "assigned-addresses"));
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "assigned-addresses"));
 
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
-                                             "cumulative-assigned-addresses"));
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "cumulative-assigned-addresses"));
 
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
-                                             "declined-addresses"));
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "declined-addresses"));
 
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
-                                             "reclaimed-declined-addresses"));
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "reclaimed-declined-addresses"));
 
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
-                                             "reclaimed-leases"));
-    }
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "reclaimed-leases"));
+
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "allocator-memory"));
+
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "lease-memory"));
 }
 
 void
 CfgSubnets4::updateStatistics() {
+    updateSubnetStatistics();
+
+    // Only recount the stats if we have subnets.
+    if (subnets_.begin() != subnets_.end()) {
+        LeaseMgrFactory::instance().recountLeaseStats4();
+    }
+}
+
+void
+CfgSubnets4::updateStatistics(const Subnet4Collection& previous) {
+    using namespace isc::stats;
+
+    StatsMgr& stats_mgr = StatsMgr::instance();
+
+    // Remove the statistics of the previous subnets which were removed
+    // or which prefix changed. The lease statistics of the others
+    // remain valid.
+    const auto& index = subnets_.get<SubnetSubnetIdIndexTag>();
+    SubnetIDSet retained;
+    for (auto const& subnet4 : previous) {
+        SubnetID subnet_id = subnet4->getID();
+        auto current = index.find(subnet_id);
+        if ((current != index.end()) &&
+            ((*current)->toText() == subnet4->toText())) {
+            static_cast<void>(retained.insert(subnet_id));
+            continue;
+        }
+        ObservationPtr declined =
+            stats_mgr.getObservation(StatsMgr::generateName("subnet", subnet_id,
+                                                            "declined-addresses"));
+        if (declined) {
+            stats_mgr.addValue("declined-addresses",
+                               -declined->getInteger().first);
+        }
+        removeSubnetStatistics(subnet_id);
+    }
+
+    updateSubnetStatistics();
+
+    // Recount the new and changed subnets.
+    SubnetIDSet recount;
+    for (auto const& subnet4 : subnets_) {
+        if (retained.count(subnet4->getID()) == 0) {
+            static_cast<void>(recount.insert(subnet4->getID()));
+        }
+    }
+    if (recount.empty()) {
+        return;
+    }
+    if (recount.size() == subnets_.size()) {
+        // A single query is faster when all the subnets are recounted.
+        LeaseMgrFactory::instance().recountLeaseStats4();
+    } else {
+        LeaseMgrFactory::instance().recountLeaseStats4(recount);
+    }
+}
+
+void
+CfgSubnets4::updateSubnetStatistics() {
     using namespace isc::stats;
 
     StatsMgr& stats_mgr = StatsMgr::instance();
@@ -565,14 +637,71 @@ CfgSubnets4::updateStatistics() {
         if (!stats_mgr.getObservation(name)) {
             stats_mgr.setValue(name, static_cast<int64_t>(0));
         }
+
+        // Bind the lease statistics so the lease events don't build
+        // their names.
+        subnet4->bindLeaseStats();
     }
+}
 
-    // Only recount the stats if we have subnets.
-    if (subnets_.begin() != subnets_.end()) {
-        LeaseMgrFactory::instance().recountLeaseStats4();
+namespace {
+
+/// @brief Returns the allocator of a subnet.
+///
+/// @param subnet4 the subnet.
+/// @return the allocator or null when the subnet has none.
+AllocatorPtr
+getAllocator4(const Subnet4Ptr& subnet4) {
+    try {
+        return (subnet4->getAllocator(Lease::TYPE_V4));
+    } catch (const BadValue&) {
+        return (AllocatorPtr());
+    }
+}
+
+}
+
+void
+CfgSubnets4::updateMemoryStatistics() const {
+    using namespace isc::stats;
+
+    StatsMgr& stats_mgr = StatsMgr::instance();
+    const Memfile_LeaseMgr* memfile = 0;
+    if (LeaseMgrFactory::haveInstance()) {
+        memfile = dynamic_cast<const Memfile_LeaseMgr*>(&LeaseMgrFactory::instance());
+    }
+    for (auto const& subnet4 : subnets_) {
+        SubnetID subnet_id = subnet4->getID();
+        size_t usage = 0;
+        auto allocator = getAllocator4(subnet4);
+        if (allocator) {
+            for (auto const& pool : subnet4->getPools(Lease::TYPE_V4)) {
+                usage += allocator->getMemoryUsage(pool);
+            }
+        }
+        stats_mgr.setValue(StatsMgr::generateName("subnet", subnet_id,
+                                                  "allocator-memory"),
+                           static_cast<int64_t>(usage));
+        if (memfile) {
+            stats_mgr.setValue(StatsMgr::generateName("subnet", subnet_id,
+                                                      "lease-memory"),
+                               static_cast<int64_t>(memfile->getLeaseMemoryUsage4(subnet_id)));
+        }
     }
 }
 
+size_t
+CfgSubnets4::compactAllocators(double threshold) const {
+    size_t released = 0;
+    for (auto const& subnet4 : subnets_) {
+        auto allocator = getAllocator4(subnet4);
+        if (allocator) {
+            released += allocator->compact(threshold);
+        }
+    }
+    return (released);
+}
+
 void
 CfgSubnets4::initAllocatorsAfterConfigure() {
     for (auto subnet : subnets_) {
@@ -580,6 +709,26 @@ CfgSubnets4::initAllocatorsAfterConfigure() {
     }
 }
 
+size_t
+CfgSubnets4::initAllocatorsAfterConfigure(const ConstCfgSubnets4Ptr& previous,
+                                           bool same_leases) {
+    size_t reused = 0;
+    for (auto subnet : subnets_) {
+        if (previous) {
+            auto prev = previous->getBySubnetId(subnet->getID());
+            if (prev && subnet->reuseAllocationStates(*prev, same_leases)) {
+                ++reused;
+            }
+        }
+        subnet->initAllocatorsAfterConfigure();
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
+              DHCPSRV_CFGMGR_REUSE_ALLOCATION_STATES)
+        .arg(reused)
+        .arg(subnets_.size());
+    return (reused);
+}
+
 ElementPtr
 CfgSubnets4::toElement() const {
     ElementPtr result = Element::createList();
@@ -13,6 +13,7 @@
 #include <dhcpsrv/cfg_shared_networks.h>
 #include <dhcpsrv/subnet.h>
 #include <dhcpsrv/subnet_id.h>
+#include <dhcpsrv/subnet_prefix_index.h>
 #include <dhcpsrv/subnet_selector.h>
 #include <boost/shared_ptr.hpp>
 #include <string>
@@ -33,6 +34,10 @@ namespace dhcp {
 class CfgSubnets4 : public isc::data::CfgToElement {
 public:
 
+    /// @brief Constructor.
+    CfgSubnets4() : prefix_index_(AF_INET) {
+    }
+
     /// @brief Adds new subnet to the configuration.
     ///
     /// @param subnet Pointer to the subnet being added.
@@ -327,9 +332,50 @@ public:
     /// configuration and also subnet-ids may change.
     void removeStatistics();
 
+    /// @brief Updates statistics after a configuration change.
+    ///
+    /// The statistics of the previous subnets which are not in this
+    /// configuration with the same identifier and prefix are removed.
+    /// The lease statistics of the other previous subnets are kept
+    /// and only the new subnets are recounted from the lease database,
+    /// which must be the same as for the previous configuration.
+    ///
+    /// @param previous the subnets of the previous configuration.
+    void updateStatistics(const Subnet4Collection& previous);
+
+    /// @brief Updates the memory statistics of the subnets.
+    ///
+    /// Sets "subnet[id].allocator-memory" to the estimated memory used by
+    /// the allocation states of the subnet pools and, when the leases are
+    /// held by the memfile backend, "subnet[id].lease-memory" to the
+    /// estimated memory used by the leases of the subnet.
+    void updateMemoryStatistics() const;
+
+    /// @brief Compacts the fragmented allocation states of the subnets.
+    ///
+    /// @param threshold fragmentation, between 0 and 1, above which the
+    /// allocation state of a pool is compacted.
+    /// @return the estimated number of released bytes.
+    size_t compactAllocators(double threshold) const;
+
     /// @brief Calls @c initAllocatorsAfterConfigure for each subnet.
     void initAllocatorsAfterConfigure();
 
+    /// @brief Calls @c initAllocatorsAfterConfigure for each subnet
+    /// reusing the allocation states of the unchanged subnets.
+    ///
+    /// The subnets with the same identifier and configuration as in the
+    /// previous configuration take over the allocation states of their
+    /// previous instance, the other ones start with fresh states.
+    ///
+    /// @param previous subnets of the configuration being replaced.
+    /// @param same_leases true when the lease database is the same as in
+    /// the configuration being replaced.
+    /// @return number of subnets which reused their allocation states.
+    size_t
+    initAllocatorsAfterConfigure(const boost::shared_ptr<const CfgSubnets4>&
+                                 previous, bool same_leases = false);
+
     /// @brief Unparse a configuration object
     ///
     /// @return a pointer to unparsed configuration
@@ -337,9 +383,23 @@ public:
 
 private:
 
+    /// @brief Removes the statistics of a subnet.
+    ///
+    /// @param subnet_id the identifier of the subnet.
+    static void removeSubnetStatistics(const SubnetID& subnet_id);
+
+    /// @brief Updates the statistics which depend only on the configuration.
+    ///
+    /// It also binds the lease statistics of the subnets.
+    void updateSubnetStatistics();
+
     /// @brief A container for IPv4 subnets.
     Subnet4Collection subnets_;
 
+    /// @brief Index of the subnets by prefix used for the selection by
+    /// address.
+    SubnetPrefixIndex<Subnet4Ptr> prefix_index_;
+
 };
 
 /// @name Pointer to the @c CfgSubnets4 objects.
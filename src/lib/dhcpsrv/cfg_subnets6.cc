@@ -39,6 +39,8 @@ CfgSubnets6::add(const Subnet6Ptr& subnet) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_ADD_SUBNET6)
               .arg(subnet->toText());
     static_cast<void>(subnets_.insert(subnet));
+    prefix_index_.add(subnet);
+    invalidateSelectionIndex();
 }
 
 Subnet6Ptr
@@ -52,6 +54,11 @@ CfgSubnets6::replace(const Subnet6Ptr& subnet) {
     }
     Subnet6Ptr old = *subnet_it;
     bool ret = index.replace(subnet_it, subnet);
+    if (ret) {
+        prefix_index_.del(old);
+        prefix_index_.add(subnet);
+        invalidateSelectionIndex();
+    }
 
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_UPDATE_SUBNET6)
         .arg(subnet_id).arg(ret);
@@ -79,6 +86,8 @@ CfgSubnets6::del(const SubnetID& subnet_id) {
     Subnet6Ptr subnet = *subnet_it;
 
     index.erase(subnet_it);
+    prefix_index_.del(subnet);
+    invalidateSelectionIndex();
 
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_DEL_SUBNET6)
         .arg(subnet->toText());
@@ -87,6 +96,9 @@ CfgSubnets6::del(const SubnetID& subnet_id) {
 void
 CfgSubnets6::merge(CfgOptionDefPtr cfg_def, CfgSharedNetworks6Ptr networks,
                    CfgSubnets6& other) {
+    // The merged shared networks may change the inherited interfaces.
+    invalidateSelectionIndex();
+
     auto& index_id = subnets_.get<SubnetSubnetIdIndexTag>();
     auto& index_prefix = subnets_.get<SubnetPrefixIndexTag>();
 
@@ -119,6 +131,7 @@ CfgSubnets6::merge(CfgOptionDefPtr cfg_def, CfgSharedNetworks6Ptr networks,
             }
 
             // Now we remove the existing subnet.
+            prefix_index_.del(existing_subnet);
             index_id.erase(subnet_it);
         }
 
@@ -143,6 +156,7 @@ CfgSubnets6::merge(CfgOptionDefPtr cfg_def, CfgSharedNetworks6Ptr networks,
             }
 
             // Now we remove the existing subnet.
+            prefix_index_.del(existing_subnet);
             index_prefix.erase(subnet_prefix_it);
         }
 
@@ -161,6 +175,7 @@ CfgSubnets6::merge(CfgOptionDefPtr cfg_def, CfgSharedNetworks6Ptr networks,
 
         // Add the "other" subnet to the our collection of subnets.
         static_cast<void>(subnets_.insert(other_subnet));
+        prefix_index_.add(other_subnet);
 
         // If it belongs to a shared network, find the network and
         // add the subnet to it
@@ -298,8 +313,8 @@ CfgSubnets6::selectSubnet(const asiolink::IOAddress& address,
 
     // No success so far. Check if the specified address is in range
     // with any subnet.
-    for (auto const& subnet : subnets_) {
-        if (subnet->inRange(address) && subnet->clientSupported(client_classes)) {
+    for (auto const& subnet : prefix_index_.getAll(address)) {
+        if (subnet->clientSupported(client_classes)) {
             LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE, DHCPSRV_CFGMGR_SUBNET6)
                       .arg(subnet->toText()).arg(address.toText());
             return (subnet);
@@ -319,17 +334,19 @@ CfgSubnets6::selectSubnet(const std::string& iface_name,
                           const ClientClasses& client_classes) const {
     // If empty interface specified, we can't select subnet by interface.
     if (!iface_name.empty()) {
-        for (auto const& subnet : subnets_) {
-
-            // If interface name matches with the one specified for the subnet
-            // and the client is not rejected based on the classification,
-            // return the subnet.
-            if ((subnet->getIface() == iface_name) &&
-                subnet->clientSupported(client_classes)) {
-                LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
-                          DHCPSRV_CFGMGR_SUBNET6_IFACE)
-                    .arg(subnet->toText()).arg(iface_name);
-                return (subnet);
+        ConstSelectionIndexPtr selection_index = getSelectionIndex();
+        auto bucket = selection_index->by_iface_.find(iface_name);
+        if (bucket != selection_index->by_iface_.end()) {
+            for (auto const& subnet : bucket->second) {
+
+                // If the client is not rejected based on the classification,
+                // return the subnet.
+                if (subnet->clientSupported(client_classes)) {
+                    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
+                              DHCPSRV_CFGMGR_SUBNET6_IFACE)
+                        .arg(subnet->toText()).arg(iface_name);
+                    return (subnet);
+                }
             }
         }
     }
@@ -348,18 +365,23 @@ CfgSubnets6::selectSubnet(const OptionPtr& interface_id,
     // We can only select subnet using an interface id, if the interface
     // id is known.
     if (interface_id) {
-        for (auto const& subnet : subnets_) {
-
-            // If interface id matches for the subnet and the subnet is not
-            // rejected based on the classification.
-            if (subnet->getInterfaceId() &&
-                subnet->getInterfaceId()->equals(interface_id) &&
-                subnet->clientSupported(client_classes)) {
-
-                LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
-                      DHCPSRV_CFGMGR_SUBNET6_IFACE_ID)
-                    .arg(subnet->toText());
-                return (subnet);
+        ConstSelectionIndexPtr selection_index = getSelectionIndex();
+        const OptionBuffer& data = interface_id->getData();
+        auto bucket = selection_index->by_interface_id_.find(
+            std::string(data.begin(), data.end()));
+        if (bucket != selection_index->by_interface_id_.end()) {
+            for (auto const& subnet : bucket->second) {
+
+                // If interface id matches for the subnet and the subnet is not
+                // rejected based on the classification.
+                if (subnet->getInterfaceId()->equals(interface_id) &&
+                    subnet->clientSupported(client_classes)) {
+
+                    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
+                          DHCPSRV_CFGMGR_SUBNET6_IFACE_ID)
+                        .arg(subnet->toText());
+                    return (subnet);
+                }
             }
         }
 
@@ -372,6 +394,36 @@ CfgSubnets6::selectSubnet(const OptionPtr& interface_id,
     return (Subnet6Ptr());
 }
 
+CfgSubnets6::ConstSelectionIndexPtr
+CfgSubnets6::getSelectionIndex() const {
+    std::lock_guard<std::mutex> lock(selection_mutex_);
+    if (selection_index_) {
+        return (selection_index_);
+    }
+    boost::shared_ptr<SelectionIndex> selection_index(new SelectionIndex());
+    for (auto const& subnet : subnets_) {
+        std::string iface = subnet->getIface();
+        if (!iface.empty()) {
+            selection_index->by_iface_[iface].push_back(subnet);
+        }
+        OptionPtr interface_id = subnet->getInterfaceId();
+        if (interface_id) {
+            const OptionBuffer& data = interface_id->getData();
+            selection_index->by_interface_id_[std::string(data.begin(),
+                                                          data.end())].
+                push_back(subnet);
+        }
+    }
+    selection_index_ = selection_index;
+    return (selection_index_);
+}
+
+void
+CfgSubnets6::invalidateSelectionIndex() {
+    std::lock_guard<std::mutex> lock(selection_mutex_);
+    selection_index_.reset();
+}
+
 Subnet6Ptr
 CfgSubnets6::getSubnet(const SubnetID id) const {
     /// @todo: Once this code is migrated to multi-index container, use
@@ -388,10 +440,7 @@ SubnetIDSet
 CfgSubnets6::getLinks(const IOAddress& link_addr, uint8_t& link_len) const {
     SubnetIDSet links;
     bool link_len_set = false;
-    for (auto const& subnet : subnets_) {
-        if (!subnet->inRange(link_addr)) {
-            continue;
-        }
+    for (auto const& subnet : prefix_index_.getAll(link_addr)) {
         uint8_t plen = subnet->get().second;
         if (!link_len_set || (plen < link_len)) {
             link_len_set = true;
@@ -404,41 +453,104 @@ CfgSubnets6::getLinks(const IOAddress& link_addr, uint8_t& link_len) const {
 
 void
 CfgSubnets6::removeStatistics() {
+    // For each v6 subnet currently configured, remove the statistics.
+    for (auto const& subnet6 : subnets_) {
+        removeSubnetStatistics(subnet6->getID());
+    }
+}
+
+void
+CfgSubnets6::removeSubnetStatistics(const SubnetID& subnet_id) {
     using namespace isc::stats;
 
     StatsMgr& stats_mgr = StatsMgr::instance();
-    // For each v6 subnet currently configured, remove the statistics.
-    for (auto const& subnet6 : subnets_) {
-        SubnetID subnet_id = subnet6->getID();
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id, "total-nas"));
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id, "total-nas"));
 
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
-                                             "assigned-nas"));
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "assigned-nas"));
 
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
-                                             "cumulative-assigned-nas"));
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "cumulative-assigned-nas"));
 
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id, "total-pds"));
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id, "total-pds"));
 
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
-                                             "assigned-pds"));
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "assigned-pds"));
 
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
-                                             "cumulative-assigned-pds"));
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "cumulative-assigned-pds"));
 
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
-                                             "declined-addresses"));
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "declined-addresses"));
 
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
-                                             "reclaimed-declined-addresses"));
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "reclaimed-declined-addresses"));
 
-        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
-                                             "reclaimed-leases"));
-    }
+    stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                         "reclaimed-leases"));
 }
 
 void
 CfgSubnets6::updateStatistics() {
+    updateSubnetStatistics();
+
+    // Only recount the stats if we have subnets.
+    if (subnets_.begin() != subnets_.end()) {
+        LeaseMgrFactory::instance().recountLeaseStats6();
+    }
+}
+
+void
+CfgSubnets6::updateStatistics(const Subnet6Collection& previous) {
+    using namespace isc::stats;
+
+    StatsMgr& stats_mgr = StatsMgr::instance();
+
+    // Remove the statistics of the previous subnets which were removed
+    // or which prefix changed. The lease statistics of the others
+    // remain valid.
+    const auto& index = subnets_.get<SubnetSubnetIdIndexTag>();
+    SubnetIDSet retained;
+    for (auto const& subnet6 : previous) {
+        SubnetID subnet_id = subnet6->getID();
+        auto current = index.find(subnet_id);
+        if ((current != index.end()) &&
+            ((*current)->toText() == subnet6->toText())) {
+            static_cast<void>(retained.insert(subnet_id));
+            continue;
+        }
+        ObservationPtr declined =
+            stats_mgr.getObservation(StatsMgr::generateName("subnet", subnet_id,
+                                                            "declined-addresses"));
+        if (declined) {
+            stats_mgr.addValue("declined-addresses",
+                               -declined->getInteger().first);
+        }
+        removeSubnetStatistics(subnet_id);
+    }
+
+    updateSubnetStatistics();
+
+    // Recount the new and changed subnets.
+    SubnetIDSet recount;
+    for (auto const& subnet6 : subnets_) {
+        if (retained.count(subnet6->getID()) == 0) {
+            static_cast<void>(recount.insert(subnet6->getID()));
+        }
+    }
+    if (recount.empty()) {
+        return;
+    }
+    if (recount.size() == subnets_.size()) {
+        // A single query is faster when all the subnets are recounted.
+        LeaseMgrFactory::instance().recountLeaseStats6();
+    } else {
+        LeaseMgrFactory::instance().recountLeaseStats6(recount);
+    }
+}
+
+void
+CfgSubnets6::updateSubnetStatistics() {
     using namespace isc::stats;
 
     StatsMgr& stats_mgr = StatsMgr::instance();
@@ -467,11 +579,10 @@ CfgSubnets6::updateStatistics() {
         if (!stats_mgr.getObservation(name_pds)) {
             stats_mgr.setValue(name_pds, static_cast<int64_t>(0));
         }
-    }
 
-    // Only recount the stats if we have subnets.
-    if (subnets_.begin() != subnets_.end()) {
-        LeaseMgrFactory::instance().recountLeaseStats6();
+        // Bind the lease statistics so the lease events don't build
+        // their names.
+        subnet6->bindLeaseStats();
     }
 }
 
@@ -482,6 +593,26 @@ CfgSubnets6::initAllocatorsAfterConfigure() {
     }
 }
 
+size_t
+CfgSubnets6::initAllocatorsAfterConfigure(const ConstCfgSubnets6Ptr& previous,
+                                           bool same_leases) {
+    size_t reused = 0;
+    for (auto subnet : subnets_) {
+        if (previous) {
+            auto prev = previous->getBySubnetId(subnet->getID());
+            if (prev && subnet->reuseAllocationStates(*prev, same_leases)) {
+                ++reused;
+            }
+        }
+        subnet->initAllocatorsAfterConfigure();
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
+              DHCPSRV_CFGMGR_REUSE_ALLOCATION_STATES)
+        .arg(reused)
+        .arg(subnets_.size());
+    return (reused);
+}
+
 ElementPtr
 CfgSubnets6::toElement() const {
     ElementPtr result = Element::createList();
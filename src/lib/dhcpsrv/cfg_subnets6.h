@@ -14,10 +14,14 @@
 #include <dhcpsrv/cfg_shared_networks.h>
 #include <dhcpsrv/subnet.h>
 #include <dhcpsrv/subnet_id.h>
+#include <dhcpsrv/subnet_prefix_index.h>
 #include <dhcpsrv/subnet_selector.h>
 #include <util/optional.h>
 #include <boost/shared_ptr.hpp>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace isc {
 namespace dhcp {
@@ -34,6 +38,11 @@ namespace dhcp {
 class CfgSubnets6 : public isc::data::CfgToElement {
 public:
 
+    /// @brief Constructor.
+    CfgSubnets6()
+        : prefix_index_(AF_INET6), selection_index_(), selection_mutex_() {
+    }
+
     /// @brief Adds new subnet to the configuration.
     ///
     /// @param subnet Pointer to the subnet being added.
@@ -277,9 +286,35 @@ public:
     /// configuration and also subnet-ids may change.
     void removeStatistics();
 
+    /// @brief Updates statistics after a configuration change.
+    ///
+    /// The statistics of the previous subnets which are not in this
+    /// configuration with the same identifier and prefix are removed.
+    /// The lease statistics of the other previous subnets are kept
+    /// and only the new subnets are recounted from the lease database,
+    /// which must be the same as for the previous configuration.
+    ///
+    /// @param previous the subnets of the previous configuration.
+    void updateStatistics(const Subnet6Collection& previous);
+
     /// @brief Calls @c initAllocatorsAfterConfigure for each subnet.
     void initAllocatorsAfterConfigure();
 
+    /// @brief Calls @c initAllocatorsAfterConfigure for each subnet
+    /// reusing the allocation states of the unchanged subnets.
+    ///
+    /// The subnets with the same identifier and configuration as in the
+    /// previous configuration take over the allocation states of their
+    /// previous instance, the other ones start with fresh states.
+    ///
+    /// @param previous subnets of the configuration being replaced.
+    /// @param same_leases true when the lease database is the same as in
+    /// the configuration being replaced.
+    /// @return number of subnets which reused their allocation states.
+    size_t
+    initAllocatorsAfterConfigure(const boost::shared_ptr<const CfgSubnets6>&
+                                 previous, bool same_leases = false);
+
     /// @brief Unparse a configuration object
     ///
     /// @return a pointer to unparsed configuration
@@ -335,9 +370,56 @@ private:
     selectSubnet(const OptionPtr& interface_id,
                  const ClientClasses& client_classes) const;
 
+    /// @brief Removes the statistics of a subnet.
+    ///
+    /// @param subnet_id the identifier of the subnet.
+    static void removeSubnetStatistics(const SubnetID& subnet_id);
+
+    /// @brief Updates the statistics which depend only on the configuration.
+    ///
+    /// It also binds the lease statistics of the subnets.
+    void updateSubnetStatistics();
+
+    /// @brief Index of the subnets by interface name and by interface-id.
+    ///
+    /// The subnets are kept in the order of the subnet collection so the
+    /// selection returns the same subnet as a scan of the subnets.
+    struct SelectionIndex {
+        /// @brief Subnets by interface name.
+        std::unordered_map<std::string, std::vector<Subnet6Ptr> > by_iface_;
+
+        /// @brief Subnets by interface-id option data.
+        std::unordered_map<std::string, std::vector<Subnet6Ptr> > by_interface_id_;
+    };
+
+    /// @brief Pointer to the selection index.
+    typedef boost::shared_ptr<const SelectionIndex> ConstSelectionIndexPtr;
+
+    /// @brief Returns the selection index, building it when needed.
+    ///
+    /// The interface name and interface-id of a subnet may be inherited
+    /// from its shared network, so the index is built lazily at the first
+    /// selection after the subnets have changed rather than maintained by
+    /// @c add.
+    ConstSelectionIndexPtr getSelectionIndex() const;
+
+    /// @brief Discards the selection index after a change of the subnets.
+    void invalidateSelectionIndex();
+
     /// @brief A container for IPv6 subnets.
     Subnet6Collection subnets_;
 
+    /// @brief Index of the subnets by prefix used for the selection by
+    /// address.
+    SubnetPrefixIndex<Subnet6Ptr> prefix_index_;
+
+    /// @brief Index of the subnets used for the selection by interface
+    /// name and by interface-id, null when it must be rebuilt.
+    mutable ConstSelectionIndexPtr selection_index_;
+
+    /// @brief Mutex protecting the selection index.
+    mutable std::mutex selection_mutex_;
+
 };
 
 /// @name Pointer to the @c CfgSubnets6 objects.
@@ -84,16 +84,18 @@ CfgMgr::clear() {
     external_configs_.clear();
     D2ClientConfigPtr d2_default_conf(new D2ClientConfig());
     setD2ClientConfig(d2_default_conf);
+    ++current_cfg_version_;
+    Network::invalidateResolvedProperties();
 }
 
 void
 CfgMgr::commit() {
     ensureCurrentAllocated();
 
-    // First we need to remove statistics. The new configuration can have fewer
-    // subnets. Also, it may change subnet-ids. So we need to remove them all
-    // and add it back.
-    configuration_->removeStatistics();
+    // The new configuration can have fewer subnets. Also, it may change
+    // subnet-ids. The statistics of the previous configuration are updated
+    // once the new configuration is current.
+    SrvConfigPtr previous = configuration_;
 
     if (!configs_.back()->sequenceEquals(*configuration_)) {
         configuration_ = configs_.back();
@@ -109,9 +111,17 @@ CfgMgr::commit() {
     // Set the last commit timestamp.
     auto now = boost::posix_time::second_clock::universal_time();
     configuration_->setLastCommitTime(now);
+    ++current_cfg_version_;
+    Network::invalidateResolvedProperties();
 
-    // Now we need to set the statistics back.
-    configuration_->updateStatistics();
+    // Now we need to set the statistics back. Only the subnets which
+    // changed are recounted when the lease database did not change.
+    configuration_->updateStatistics(*previous);
+
+    // Resolve the DDNS parameters and the subnet properties once instead
+    // of for each packet.
+    configuration_->resolveDdnsParams();
+    configuration_->resolveNetworkProperties();
 
     configuration_->configureLowerLevelLibraries();
 }
@@ -193,17 +203,25 @@ CfgMgr::mergeIntoStagingCfg(const uint32_t seq) {
 
 void
 CfgMgr::mergeIntoCurrentCfg(const uint32_t seq) {
+    // Keep the subnets before the merge so only the statistics of the
+    // subnets the merge changes are recounted.
+    const Subnet4Collection subnets4 = *getCurrentCfg()->getCfgSubnets4()->getAll();
+    const Subnet6Collection subnets6 = *getCurrentCfg()->getCfgSubnets6()->getAll();
     try {
-        // First we need to remove statistics.
-        getCurrentCfg()->removeStatistics();
         mergeIntoCfg(getCurrentCfg(), seq);
 
     } catch (...) {
         // Make sure the statistics is updated even if the merge failed.
-        getCurrentCfg()->updateStatistics();
+        getCurrentCfg()->updateStatistics(subnets4, subnets6);
+        getCurrentCfg()->resolveDdnsParams();
+        getCurrentCfg()->resolveNetworkProperties();
+        ++current_cfg_version_;
         throw;
     }
-    getCurrentCfg()->updateStatistics();
+    getCurrentCfg()->updateStatistics(subnets4, subnets6);
+    getCurrentCfg()->resolveDdnsParams();
+    getCurrentCfg()->resolveNetworkProperties();
+    ++current_cfg_version_;
 }
 
 void
@@ -220,7 +238,8 @@ CfgMgr::mergeIntoCfg(const SrvConfigPtr& target_config, const uint32_t seq) {
 }
 
 CfgMgr::CfgMgr()
-    : datadir_(DHCP_DATA_DIR, true), d2_client_mgr_(), family_(AF_INET) {
+    : datadir_(DHCP_DATA_DIR, true), d2_client_mgr_(), family_(AF_INET),
+      current_cfg_version_(0) {
     // DHCP_DATA_DIR must be set set with -DDHCP_DATA_DIR="..." in Makefile.am
     // Note: the definition of DHCP_DATA_DIR needs to include quotation marks
     // See AM_CPPFLAGS definition in Makefile.am
@@ -219,6 +219,18 @@ public:
     /// @return Non-null pointer to the current configuration.
     SrvConfigPtr getCurrentCfg();
 
+    /// @brief Returns the version of the current configuration.
+    ///
+    /// The version changes each time the current configuration is
+    /// committed, cleared or merged with an external configuration, so the
+    /// data derived from the current configuration can be cached until it
+    /// changes.
+    ///
+    /// @return The version of the current configuration.
+    uint64_t getCurrentCfgVersion() const {
+        return (current_cfg_version_);
+    }
+
     /// @brief Returns a pointer to the staging configuration.
     ///
     /// The staging configuration is used by the configuration parsers to
@@ -349,6 +361,9 @@ private:
 
     /// @brief Address family.
     uint16_t family_;
+
+    /// @brief Version of the current configuration.
+    uint64_t current_cfg_version_;
 };
 
 } // namespace isc::dhcp
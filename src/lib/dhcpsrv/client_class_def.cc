@@ -15,6 +15,7 @@
 #include <dhcpsrv/parsers/client_class_def_parser.h>
 #include <boost/foreach.hpp>
 
+#include <chrono>
 #include <queue>
 
 using namespace isc::data;
@@ -22,6 +23,51 @@ using namespace isc::data;
 namespace isc {
 namespace dhcp {
 
+namespace {
+
+/// @brief Logs the time taken by the evaluation of a class expression.
+///
+/// The time is measured only when the message is logged.
+class EvalTimer {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param def The class.
+    explicit EvalTimer(const ClientClassDef& def)
+        : def_(def),
+          enabled_(dhcpsrv_logger.isDebugEnabled(DHCPSRV_DBG_TRACE_DETAIL)) {
+        if (enabled_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Logs the time since the construction.
+    ~EvalTimer() {
+        if (enabled_) {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, EVAL_TIME)
+                .arg(def_.getName())
+                .arg(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        }
+    }
+
+private:
+
+    /// @brief The class.
+    const ClientClassDef& def_;
+
+    /// @brief Indicates that the time is logged.
+    bool enabled_;
+
+    /// @brief The start of the evaluation.
+    std::chrono::steady_clock::time_point start_;
+};
+
+}
+
 //********** ClientClassDef ******************//
 
 ClientClassDef::ClientClassDef(const std::string& name,
@@ -43,6 +89,10 @@ ClientClassDef::ClientClassDef(const std::string& name,
     if (!cfg_option_) {
         cfg_option_.reset(new CfgOption());
     }
+
+    if (match_expr_) {
+        member_prerequisites_ = getMemberPrerequisites(*match_expr_);
+    }
 }
 
 ClientClassDef::ClientClassDef(const ClientClassDef& rhs)
@@ -56,6 +106,7 @@ ClientClassDef::ClientClassDef(const ClientClassDef& rhs)
     if (rhs.match_expr_) {
         match_expr_.reset(new Expression());
         *match_expr_ = *(rhs.match_expr_);
+        member_prerequisites_ = rhs.member_prerequisites_;
     }
 
     if (rhs.cfg_option_def_) {
@@ -89,6 +140,10 @@ ClientClassDef::getMatchExpr() const {
 void
 ClientClassDef::setMatchExpr(const ExpressionPtr& match_expr) {
     match_expr_ = match_expr;
+    member_prerequisites_.clear();
+    if (match_expr_) {
+        member_prerequisites_ = getMemberPrerequisites(*match_expr_);
+    }
 }
 
 std::string
@@ -142,11 +197,26 @@ ClientClassDef::setCfgOption(const CfgOptionPtr& cfg_option) {
 }
 
 void
-ClientClassDef::test(PktPtr pkt, const ExpressionPtr& expr_ptr) {
+ClientClassDef::test(PktPtr pkt, const ExpressionPtr& expr_ptr,
+                     EvalCache* cache) {
+    // The match expression can't be true when the packet is not a member
+    // of the classes it needs.
+    if (expr_ptr == match_expr_) {
+        for (auto const& name : member_prerequisites_) {
+            if (!pkt->inClass(name)) {
+                LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, EVAL_RESULT)
+                    .arg(getName())
+                    .arg(false);
+                return;
+            }
+        }
+    }
+
+    EvalTimer timer(*this);
     // Evaluate the expression which can return false (no match),
     // true (match) or raise an exception (error)
     try {
-        bool status = evaluateBool(*expr_ptr, *pkt);
+        bool status = evaluateBool(*expr_ptr, *pkt, cache);
         if (status) {
             LOG_INFO(dhcpsrv_logger, EVAL_RESULT)
                 .arg(getName())
@@ -178,11 +248,13 @@ TemplateClientClassDef::TemplateClientClassDef(const std::string& name,
 }
 
 void
-TemplateClientClassDef::test(PktPtr pkt, const ExpressionPtr& expr_ptr) {
+TemplateClientClassDef::test(PktPtr pkt, const ExpressionPtr& expr_ptr,
+                             EvalCache* cache) {
+    EvalTimer timer(*this);
     // Evaluate the expression which can return false (no match),
     // true (match) or raise an exception (error)
     try {
-        std::string subclass = evaluateString(*expr_ptr, *pkt);
+        std::string subclass = evaluateString(*expr_ptr, *pkt, cache);
         if (!subclass.empty()) {
             LOG_INFO(dhcpsrv_logger, EVAL_RESULT)
                 .arg(getName())
@@ -325,11 +397,13 @@ std::ostream& operator<<(std::ostream& os, const ClientClassDef& x) {
 //********** ClientClassDictionary ******************//
 
 ClientClassDictionary::ClientClassDictionary()
-    : map_(new ClientClassDefMap()), list_(new ClientClassDefList()) {
+    : map_(new ClientClassDefMap()), list_(new ClientClassDefList()),
+      pre_host_classes_(), post_host_classes_() {
 }
 
 ClientClassDictionary::ClientClassDictionary(const ClientClassDictionary& rhs)
-    : map_(new ClientClassDefMap()), list_(new ClientClassDefList()) {
+    : map_(new ClientClassDefMap()), list_(new ClientClassDefList()),
+      pre_host_classes_(), post_host_classes_() {
     BOOST_FOREACH(ClientClassDefPtr cclass, *(rhs.list_)) {
         ClientClassDefPtr copy(new ClientClassDef(*cclass));
         addClass(copy);
@@ -387,8 +461,34 @@ ClientClassDictionary::addClass(ClientClassDefPtr& class_def) {
                   << class_def->getName() << " has already been defined");
     }
 
+    if (class_def->getMatchExpr()) {
+        shareTokens(*class_def->getMatchExpr(), shared_tokens_);
+    }
     list_->push_back(class_def);
     (*map_)[class_def->getName()] = class_def;
+    addEvaluatedClass(class_def);
+}
+
+void
+ClientClassDictionary::addEvaluatedClass(const ClientClassDefPtr& class_def) {
+    // Nothing to evaluate without an expression nor before it is required.
+    if (!class_def->getMatchExpr() || class_def->getRequired()) {
+        return;
+    }
+    if (class_def->getDependOnKnown()) {
+        post_host_classes_.push_back(class_def);
+    } else {
+        pre_host_classes_.push_back(class_def);
+    }
+}
+
+void
+ClientClassDictionary::updateEvaluatedClasses() {
+    pre_host_classes_.clear();
+    post_host_classes_.clear();
+    for (auto const& c : *list_) {
+        addEvaluatedClass(c);
+    }
 }
 
 ClientClassDefPtr
@@ -411,6 +511,7 @@ ClientClassDictionary::removeClass(const std::string& name) {
         }
     }
     map_->erase(name);
+    updateEvaluatedClasses();
 }
 
 void
@@ -427,6 +528,7 @@ ClientClassDictionary::removeClass(const uint64_t id) {
             break;
         }
     }
+    updateEvaluatedClasses();
 }
 
 const ClientClassDefListPtr&
@@ -502,10 +604,12 @@ ClientClassDictionary::initMatchExpr(uint16_t family) {
     // client classes in the dictionary.
     for (auto c : *list_) {
         if (!c->getTest().empty()) {
+            shareTokens(*expressions.front(), shared_tokens_);
             c->setMatchExpr(expressions.front());
             expressions.pop();
         }
     }
+    updateEvaluatedClasses();
 }
 
 void
@@ -564,6 +668,9 @@ ClientClassDictionary::operator=(const ClientClassDictionary& rhs) {
     if (this != &rhs) {
         list_->clear();
         map_->clear();
+        shared_tokens_.clear();
+        pre_host_classes_.clear();
+        post_host_classes_.clear();
         for (auto cclass : *(rhs.list_)) {
             ClientClassDefPtr copy(new ClientClassDef(*cclass));
             addClass(copy);
@@ -12,11 +12,13 @@
 #include <cc/user_context.h>
 #include <dhcpsrv/cfg_option.h>
 #include <dhcpsrv/cfg_option_def.h>
+#include <eval/evaluate.h>
 #include <eval/token.h>
 #include <exceptions/exceptions.h>
 #include <util/triplet.h>
 #include <util/optional.h>
 
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <list>
@@ -239,9 +241,15 @@ public:
     /// @brief Test method which checks if the packet belongs to the class
     ///
     /// If the packet belongs to the class, the class is added to the packet.
+    /// The match expression is not evaluated when the packet is not a member
+    /// of a class the expression needs to match.
     ///
     /// @param pkt The packet checked if it belongs to the class.
-    virtual void test(PktPtr pkt, const ExpressionPtr& expr_ptr);
+    /// @param expr_ptr The expression to evaluate.
+    /// @param cache The values of the option tokens already evaluated for
+    /// the packet (optional).
+    virtual void test(PktPtr pkt, const ExpressionPtr& expr_ptr,
+                      EvalCache* cache = 0);
 
     /// @brief Unparse a configuration object
     ///
@@ -256,6 +264,10 @@ private:
     /// this class.
     ExpressionPtr match_expr_;
 
+    /// @brief The classes the packet must be a member of for the match
+    /// expression to be true.
+    std::set<std::string> member_prerequisites_;
+
     /// @brief The original expression which determines membership in
     /// this class.
     std::string test_;
@@ -324,7 +336,11 @@ public:
     /// If the packet belongs to the class, the class is added to the packet.
     ///
     /// @param pkt The packet checked if it belongs to the class.
-    virtual void test(PktPtr pkt, const ExpressionPtr& expr_ptr) override;
+    /// @param expr_ptr The expression to evaluate.
+    /// @param cache The values of the option tokens already evaluated for
+    /// the packet (optional).
+    virtual void test(PktPtr pkt, const ExpressionPtr& expr_ptr,
+                      EvalCache* cache = 0) override;
 
     /// @brief Unparse a configuration object
     ///
@@ -434,6 +450,21 @@ public:
     /// @return ClientClassDefListPtr to the list of classes
     const ClientClassDefListPtr& getClasses() const;
 
+    /// @brief Returns the classes evaluated by a classification pass.
+    ///
+    /// The classes with a match expression which are not only evaluated
+    /// when required are split, in their definition order, between the
+    /// pass before the host reservation lookup and the pass after it for
+    /// the classes depending on KNOWN or UNKNOWN. The lists are updated
+    /// when the dictionary is modified so the packet processing only scans
+    /// the classes of the current pass.
+    ///
+    /// @param depend_on_known true for the pass after the host lookup.
+    /// @return the classes of the pass in their definition order.
+    const ClientClassDefList& getEvaluatedClasses(bool depend_on_known) const {
+        return (depend_on_known ? post_host_classes_ : pre_host_classes_);
+    }
+
     /// @brief Checks if the class dictionary is empty.
     ///
     /// @return true if there are no classes, false otherwise.
@@ -498,11 +529,28 @@ public:
 
 private:
 
+    /// @brief Adds a class to the list of its classification pass.
+    ///
+    /// @param class_def the class definition.
+    void addEvaluatedClass(const ClientClassDefPtr& class_def);
+
+    /// @brief Rebuilds the lists of the classification passes.
+    void updateEvaluatedClasses();
+
     /// @brief Map of the class definitions
     ClientClassDefMapPtr map_;
 
     /// @brief List of the class definitions
     ClientClassDefListPtr list_;
+
+    /// @brief Classes evaluated before the host reservation lookup.
+    ClientClassDefList pre_host_classes_;
+
+    /// @brief Classes evaluated after the host reservation lookup.
+    ClientClassDefList post_host_classes_;
+
+    /// @brief Option tokens shared by the match expressions
+    SharedTokens shared_tokens_;
 };
 
 /// @brief Defines a pointer to a ClientClassDictionary
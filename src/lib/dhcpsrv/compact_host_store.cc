@@ -0,0 +1,720 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/compact_host_store.h>
+#include <exceptions/exceptions.h>
+
+#include <boost/algorithm/string.hpp>
+#include <cstring>
+#include <limits>
+
+using namespace isc::asiolink;
+using namespace isc::data;
+
+namespace isc {
+namespace dhcp {
+
+namespace {
+
+/// @brief Mixes the bits of a hash so the low order bits can be used
+/// as a slot index.
+///
+/// @param hash the hash.
+/// @return the mixed hash.
+uint32_t
+mix(uint32_t hash) {
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return (hash);
+}
+
+/// @brief Returns the text representation of an option set.
+///
+/// @param cfg_option the option set.
+/// @return empty string for an empty option set, JSON otherwise.
+std::string
+optionsToText(const ConstCfgOptionPtr& cfg_option) {
+    if (!cfg_option || cfg_option->empty()) {
+        return ("");
+    }
+    return (cfg_option->toElement()->str());
+}
+
+/// @brief Copies an option set.
+///
+/// @param cfg_option the option set, possibly null.
+/// @return a new option set.
+CfgOptionPtr
+copyOptions(const ConstCfgOptionPtr& cfg_option) {
+    CfgOptionPtr copy(new CfgOption());
+    if (cfg_option) {
+        cfg_option->copyTo(*copy);
+    }
+    return (copy);
+}
+
+}
+
+void
+CompactHostStore::Index::insert(uint32_t hash, uint32_t record) {
+    // Keep the load factor under 3/4.
+    if ((count_ + 1) * 4 > slots_.size() * 3) {
+        rehash(slots_.empty() ? 16 : slots_.size() * 2);
+    }
+    size_t mask = slots_.size() - 1;
+    size_t pos = hash & mask;
+    while (slots_[pos].record_ != EMPTY) {
+        pos = (pos + 1) & mask;
+    }
+    slots_[pos].hash_ = hash;
+    slots_[pos].record_ = record;
+    ++count_;
+}
+
+void
+CompactHostStore::Index::find(uint32_t hash,
+                              std::vector<uint32_t>& records) const {
+    if (slots_.empty()) {
+        return;
+    }
+    size_t mask = slots_.size() - 1;
+    for (size_t pos = hash & mask; slots_[pos].record_ != EMPTY;
+         pos = (pos + 1) & mask) {
+        if (slots_[pos].hash_ == hash) {
+            records.push_back(slots_[pos].record_);
+        }
+    }
+}
+
+void
+CompactHostStore::Index::rehash(size_t size) {
+    std::vector<Slot> old;
+    old.swap(slots_);
+    slots_.assign(size, Slot{0, EMPTY});
+    count_ = 0;
+    for (auto const& slot : old) {
+        if (slot.record_ != EMPTY) {
+            insert(slot.hash_, slot.record_);
+        }
+    }
+}
+
+CompactHostStore::CompactHostStore()
+    : deleted_(0), ip_reservations_unique_(true) {
+    static_assert(sizeof(Record) == 28, "unexpected host record size");
+}
+
+uint32_t
+CompactHostStore::hashIdentifier(const uint8_t* identifier_begin,
+                                 const size_t identifier_len) {
+    // FNV-1a.
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < identifier_len; ++i) {
+        hash ^= identifier_begin[i];
+        hash *= 16777619U;
+    }
+    return (mix(hash));
+}
+
+uint32_t
+CompactHostStore::hashAddress(uint32_t address) {
+    return (mix(address));
+}
+
+uint32_t
+CompactHostStore::getProfile(const Host& host) {
+    std::string classes4 = host.getClientClasses4().toText(",");
+    std::string classes6 = host.getClientClasses6().toText(",");
+    std::string key = optionsToText(host.getCfgOption4());
+    key.push_back('\0');
+    key += optionsToText(host.getCfgOption6());
+    key.push_back('\0');
+    key += classes4;
+    key.push_back('\0');
+    key += classes6;
+    key.push_back('\0');
+    key += host.getNextServer().toText();
+    key.push_back('\0');
+    key += host.getServerHostname();
+    key.push_back('\0');
+    key += host.getBootFileName();
+
+    auto it = profile_index_.find(key);
+    if (it != profile_index_.end()) {
+        const Profile& profile = profiles_[it->second];
+        // The text representation is not guaranteed to be exact so
+        // check the options too.
+        if ((!host.getCfgOption4() ||
+             host.getCfgOption4()->equals(*profile.cfg_option4_)) &&
+            (!host.getCfgOption6() ||
+             host.getCfgOption6()->equals(*profile.cfg_option6_))) {
+            return (it->second);
+        }
+    }
+
+    if (profiles_.size() >= std::numeric_limits<uint32_t>::max()) {
+        isc_throw(BadValue, "too many host profiles in the compact store");
+    }
+    uint32_t index = static_cast<uint32_t>(profiles_.size());
+    profiles_.push_back(Profile{copyOptions(host.getCfgOption4()),
+                                copyOptions(host.getCfgOption6()),
+                                classes4, classes6, host.getNextServer(),
+                                host.getServerHostname(),
+                                host.getBootFileName()});
+    if (it == profile_index_.end()) {
+        profile_index_.insert(std::make_pair(key, index));
+    }
+    return (index);
+}
+
+void
+CompactHostStore::add(const HostPtr& host) {
+    // Sanity check that the host is non-null.
+    if (!host) {
+        isc_throw(BadValue, "specified host object must not be NULL when it"
+                  " is added to the compact host store");
+    }
+
+    // At least one subnet ID must be used
+    if (host->getIPv4SubnetID() == SUBNET_ID_UNUSED &&
+        host->getIPv6SubnetID() == SUBNET_ID_UNUSED) {
+        isc_throw(BadValue, "must not use both IPv4 and IPv6 subnet ids of"
+                  " 0 when adding new host reservation");
+    }
+
+    const std::vector<uint8_t>& id = host->getIdentifier();
+    const std::string& hostname = host->getHostname();
+    if (hostname.size() > std::numeric_limits<uint16_t>::max()) {
+        isc_throw(BadValue, "hostname of the host " << host->toText()
+                  << " is too long");
+    }
+    if ((records_.size() >= std::numeric_limits<uint32_t>::max() - 1) ||
+        (arena_.size() + id.size() + hostname.size() >
+         std::numeric_limits<uint32_t>::max())) {
+        isc_throw(BadValue, "compact host store is full");
+    }
+
+    // Check if the (identifier type, identifier) tuple is already used.
+    for (auto index : findIdentifier(host->getIdentifierType(), id.data(),
+                                     id.size())) {
+        const Record& record = records_[index];
+        if ((host->getIPv4SubnetID() != SUBNET_ID_UNUSED) &&
+            (record.ipv4_subnet_id_ == host->getIPv4SubnetID())) {
+            isc_throw(DuplicateHost, "failed to add duplicate IPv4 host using identifier: "
+                      << Host::getIdentifierAsText(host->getIdentifierType(),
+                                                   id.data(), id.size()));
+        }
+        if ((host->getIPv6SubnetID() != SUBNET_ID_UNUSED) &&
+            (record.ipv6_subnet_id_ == host->getIPv6SubnetID())) {
+            isc_throw(DuplicateHost, "failed to add duplicate IPv6 host using identifier: "
+                      << Host::getIdentifierAsText(host->getIdentifierType(),
+                                                   id.data(), id.size()));
+        }
+    }
+
+    // Check the uniqueness of the reservations.
+    const IOAddress& address = host->getIPv4Reservation();
+    if (ip_reservations_unique_ && !address.isV4Zero() &&
+        (host->getIPv4SubnetID() != SUBNET_ID_UNUSED)) {
+        for (auto index : findAddress(address)) {
+            if (records_[index].ipv4_subnet_id_ == host->getIPv4SubnetID()) {
+                isc_throw(ReservedAddress, "failed to add new host "
+                          << host->getIdentifierAsText()
+                          << " to the IPv4 subnet id '" << host->getIPv4SubnetID()
+                          << "' for the address " << address
+                          << ": There's already a reservation for this address");
+            }
+        }
+    }
+    IPv6ResrvRange reservations = host->getIPv6Reservations();
+    if (host->getIPv6SubnetID() == SUBNET_ID_UNUSED) {
+        // IPv6 reservations are ignored for IPv4-only hosts.
+        reservations.second = reservations.first;
+    }
+    if (ip_reservations_unique_) {
+        for (auto resrv = reservations.first; resrv != reservations.second;
+             ++resrv) {
+            for (auto index : findAddress6(resrv->second.getPrefix())) {
+                if (records_[index].ipv6_subnet_id_ == host->getIPv6SubnetID()) {
+                    isc_throw(DuplicateHost, "failed to add address reservation for "
+                              << "host " << host->getIdentifierAsText()
+                              << " to the IPv6 subnet id '" << host->getIPv6SubnetID()
+                              << "' for address/prefix " << resrv->second.getPrefix()
+                              << ": There's already reservation for this address/prefix");
+                }
+            }
+        }
+    }
+
+    // All checks passed: copy the host into the columns.
+    Record record;
+    record.identifier_offset_ = static_cast<uint32_t>(arena_.size());
+    record.identifier_len_ = static_cast<uint8_t>(id.size());
+    record.identifier_type_ = static_cast<uint8_t>(host->getIdentifierType());
+    arena_.insert(arena_.end(), id.begin(), id.end());
+    record.hostname_len_ = static_cast<uint16_t>(hostname.size());
+    arena_.insert(arena_.end(), hostname.begin(), hostname.end());
+    record.ipv4_subnet_id_ = host->getIPv4SubnetID();
+    record.ipv6_subnet_id_ = host->getIPv6SubnetID();
+    record.ipv4_reservation_ = address.toUint32();
+    record.profile_ = getProfile(*host);
+    record.extra_ = 0;
+    if ((reservations.first != reservations.second) ||
+        !host->getKey().getAuthKey().empty() || host->getContext()) {
+        extras_.push_back(Extra{IPv6ResrvCollection(reservations.first,
+                                                    reservations.second),
+                                host->getKey(), host->getContext()});
+        record.extra_ = static_cast<uint32_t>(extras_.size());
+    }
+
+    uint32_t index = static_cast<uint32_t>(records_.size());
+    records_.push_back(record);
+    identifier_index_[record.identifier_type_].insert(hashIdentifier(id.data(),
+                                                                     id.size()),
+                                                      index);
+    if (record.ipv4_reservation_ != 0) {
+        address_index_.insert(hashAddress(record.ipv4_reservation_), index);
+    }
+    for (auto resrv = reservations.first; resrv != reservations.second;
+         ++resrv) {
+        address6_index_.insert(std::make_pair(resrv->second.getPrefix(), index));
+    }
+    host->setHostId(index + 1);
+}
+
+std::vector<uint32_t>
+CompactHostStore::findIdentifier(const Host::IdentifierType& identifier_type,
+                                 const uint8_t* identifier_begin,
+                                 const size_t identifier_len) const {
+    std::vector<uint32_t> candidates;
+    if ((identifier_type > Host::LAST_IDENTIFIER_TYPE) ||
+        (identifier_len == 0)) {
+        return (candidates);
+    }
+    identifier_index_[identifier_type].find(hashIdentifier(identifier_begin,
+                                                           identifier_len),
+                                            candidates);
+    std::vector<uint32_t> result;
+    for (auto index : candidates) {
+        const Record& record = records_[index];
+        if ((record.identifier_type_ == identifier_type) &&
+            (record.identifier_len_ == identifier_len) &&
+            (memcmp(&arena_[record.identifier_offset_], identifier_begin,
+                    identifier_len) == 0)) {
+            result.push_back(index);
+        }
+    }
+    return (result);
+}
+
+std::vector<uint32_t>
+CompactHostStore::findAddress(const IOAddress& address) const {
+    uint32_t value = address.toUint32();
+    std::vector<uint32_t> candidates;
+    address_index_.find(hashAddress(value), candidates);
+    std::vector<uint32_t> result;
+    for (auto index : candidates) {
+        const Record& record = records_[index];
+        if ((record.identifier_type_ != DELETED) &&
+            (record.ipv4_reservation_ == value)) {
+            result.push_back(index);
+        }
+    }
+    return (result);
+}
+
+std::vector<uint32_t>
+CompactHostStore::findAddress6(const IOAddress& address) const {
+    std::vector<uint32_t> result;
+    auto range = address6_index_.equal_range(address);
+    for (auto it = range.first; it != range.second; ++it) {
+        result.push_back(it->second);
+    }
+    return (result);
+}
+
+HostPtr
+CompactHostStore::makeHost(uint32_t index) const {
+    const Record& record = records_[index];
+    const Profile& profile = profiles_[record.profile_];
+    const Extra* extra = (record.extra_ ? &extras_[record.extra_ - 1] : 0);
+    std::string hostname;
+    if (record.hostname_len_ > 0) {
+        size_t offset = record.identifier_offset_ + record.identifier_len_;
+        hostname.assign(reinterpret_cast<const char*>(&arena_[offset]),
+                        record.hostname_len_);
+    }
+    HostPtr host(new Host(&arena_[record.identifier_offset_],
+                          record.identifier_len_,
+                          static_cast<Host::IdentifierType>(record.identifier_type_),
+                          record.ipv4_subnet_id_, record.ipv6_subnet_id_,
+                          IOAddress(record.ipv4_reservation_), hostname,
+                          profile.client_classes4_, profile.client_classes6_,
+                          profile.next_server_, profile.server_hostname_,
+                          profile.boot_file_name_,
+                          (extra ? extra->key_ : AuthKey(""))));
+    host->setCfgOption4(profile.cfg_option4_);
+    host->setCfgOption6(profile.cfg_option6_);
+    if (extra) {
+        for (auto const& resrv : extra->ipv6_reservations_) {
+            host->addReservation(resrv.second);
+        }
+        host->setContext(extra->context_);
+    }
+    host->setHostId(index + 1);
+    return (host);
+}
+
+void
+CompactHostStore::remove(uint32_t index) {
+    Record& record = records_[index];
+    if (record.extra_) {
+        for (auto const& resrv : extras_[record.extra_ - 1].ipv6_reservations_) {
+            auto range = address6_index_.equal_range(resrv.second.getPrefix());
+            for (auto it = range.first; it != range.second; ) {
+                if (it->second == index) {
+                    it = address6_index_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+    record.identifier_type_ = DELETED;
+    ++deleted_;
+}
+
+ConstHostCollection
+CompactHostStore::getAll(const Host::IdentifierType& identifier_type,
+                         const uint8_t* identifier_begin,
+                         const size_t identifier_len) const {
+    ConstHostCollection hosts;
+    for (auto index : findIdentifier(identifier_type, identifier_begin,
+                                     identifier_len)) {
+        hosts.push_back(makeHost(index));
+    }
+    return (hosts);
+}
+
+ConstHostCollection
+CompactHostStore::getAll4(const SubnetID& subnet_id) const {
+    ConstHostCollection hosts;
+    for (uint32_t index = 0; index < records_.size(); ++index) {
+        const Record& record = records_[index];
+        if ((record.identifier_type_ != DELETED) &&
+            (record.ipv4_subnet_id_ == subnet_id)) {
+            hosts.push_back(makeHost(index));
+        }
+    }
+    return (hosts);
+}
+
+ConstHostCollection
+CompactHostStore::getAll6(const SubnetID& subnet_id) const {
+    ConstHostCollection hosts;
+    for (uint32_t index = 0; index < records_.size(); ++index) {
+        const Record& record = records_[index];
+        if ((record.identifier_type_ != DELETED) &&
+            (record.ipv6_subnet_id_ == subnet_id)) {
+            hosts.push_back(makeHost(index));
+        }
+    }
+    return (hosts);
+}
+
+template<typename Filter>
+ConstHostCollection
+CompactHostStore::getAllbyHostname(const std::string& hostname,
+                                   Filter filter) const {
+    ConstHostCollection hosts;
+    for (uint32_t index = 0; index < records_.size(); ++index) {
+        const Record& record = records_[index];
+        if ((record.identifier_type_ == DELETED) ||
+            (record.hostname_len_ != hostname.size()) || !filter(record)) {
+            continue;
+        }
+        size_t offset = record.identifier_offset_ + record.identifier_len_;
+        std::string stored(reinterpret_cast<const char*>(&arena_[offset]),
+                           record.hostname_len_);
+        if (boost::algorithm::to_lower_copy(stored) == hostname) {
+            hosts.push_back(makeHost(index));
+        }
+    }
+    return (hosts);
+}
+
+ConstHostCollection
+CompactHostStore::getAllbyHostname(const std::string& hostname) const {
+    return (getAllbyHostname(hostname, [](const Record&) { return (true); }));
+}
+
+ConstHostCollection
+CompactHostStore::getAllbyHostname4(const std::string& hostname,
+                                    const SubnetID& subnet_id) const {
+    return (getAllbyHostname(hostname, [subnet_id](const Record& record) {
+                return (record.ipv4_subnet_id_ == subnet_id);
+            }));
+}
+
+ConstHostCollection
+CompactHostStore::getAllbyHostname6(const std::string& hostname,
+                                    const SubnetID& subnet_id) const {
+    return (getAllbyHostname(hostname, [subnet_id](const Record& record) {
+                return (record.ipv6_subnet_id_ == subnet_id);
+            }));
+}
+
+template<typename Filter>
+ConstHostCollection
+CompactHostStore::getPage(Filter filter, uint64_t lower_host_id,
+                          const HostPageSize& page_size) const {
+    ConstHostCollection hosts;
+    // The host identifier is the record index plus 1 so the first record
+    // after the lower bound is at the lower bound index.
+    for (uint64_t index = lower_host_id; index < records_.size(); ++index) {
+        const Record& record = records_[index];
+        if ((record.identifier_type_ == DELETED) || !filter(record)) {
+            continue;
+        }
+        hosts.push_back(makeHost(static_cast<uint32_t>(index)));
+        if (hosts.size() >= page_size.page_size_) {
+            break;
+        }
+    }
+    return (hosts);
+}
+
+ConstHostCollection
+CompactHostStore::getPage4(const SubnetID& subnet_id,
+                           size_t& /*source_index*/,
+                           uint64_t lower_host_id,
+                           const HostPageSize& page_size) const {
+    return (getPage([subnet_id](const Record& record) {
+                return (record.ipv4_subnet_id_ == subnet_id);
+            }, lower_host_id, page_size));
+}
+
+ConstHostCollection
+CompactHostStore::getPage6(const SubnetID& subnet_id,
+                           size_t& /*source_index*/,
+                           uint64_t lower_host_id,
+                           const HostPageSize& page_size) const {
+    return (getPage([subnet_id](const Record& record) {
+                return (record.ipv6_subnet_id_ == subnet_id);
+            }, lower_host_id, page_size));
+}
+
+ConstHostCollection
+CompactHostStore::getPage4(size_t& /*source_index*/,
+                           uint64_t lower_host_id,
+                           const HostPageSize& page_size) const {
+    return (getPage([](const Record&) { return (true); },
+                    lower_host_id, page_size));
+}
+
+ConstHostCollection
+CompactHostStore::getPage6(size_t& /*source_index*/,
+                           uint64_t lower_host_id,
+                           const HostPageSize& page_size) const {
+    return (getPage([](const Record&) { return (true); },
+                    lower_host_id, page_size));
+}
+
+ConstHostCollection
+CompactHostStore::getAll4(const IOAddress& address) const {
+    // Must not specify address other than IPv4.
+    if (!address.isV4()) {
+        isc_throw(BadHostAddress, "must specify an IPv4 address when searching"
+                  " for a host, specified address was " << address);
+    }
+    ConstHostCollection hosts;
+    for (auto index : findAddress(address)) {
+        hosts.push_back(makeHost(index));
+    }
+    return (hosts);
+}
+
+ConstHostPtr
+CompactHostStore::get4(const SubnetID& subnet_id,
+                       const Host::IdentifierType& identifier_type,
+                       const uint8_t* identifier_begin,
+                       const size_t identifier_len) const {
+    for (auto index : findIdentifier(identifier_type, identifier_begin,
+                                     identifier_len)) {
+        if (records_[index].ipv4_subnet_id_ == subnet_id) {
+            return (makeHost(index));
+        }
+    }
+    return (ConstHostPtr());
+}
+
+ConstHostPtr
+CompactHostStore::get4(const SubnetID& subnet_id,
+                       const IOAddress& address) const {
+    ConstHostCollection hosts = getAll4(subnet_id, address);
+    return (hosts.empty() ? ConstHostPtr() : hosts.front());
+}
+
+ConstHostCollection
+CompactHostStore::getAll4(const SubnetID& subnet_id,
+                          const IOAddress& address) const {
+    if (!address.isV4()) {
+        isc_throw(BadHostAddress, "must specify an IPv4 address when searching"
+                  " for a host, specified address was " << address);
+    }
+    ConstHostCollection hosts;
+    for (auto index : findAddress(address)) {
+        if (records_[index].ipv4_subnet_id_ == subnet_id) {
+            hosts.push_back(makeHost(index));
+        }
+    }
+    return (hosts);
+}
+
+ConstHostPtr
+CompactHostStore::get6(const SubnetID& subnet_id,
+                       const Host::IdentifierType& identifier_type,
+                       const uint8_t* identifier_begin,
+                       const size_t identifier_len) const {
+    for (auto index : findIdentifier(identifier_type, identifier_begin,
+                                     identifier_len)) {
+        if (records_[index].ipv6_subnet_id_ == subnet_id) {
+            return (makeHost(index));
+        }
+    }
+    return (ConstHostPtr());
+}
+
+ConstHostPtr
+CompactHostStore::get6(const IOAddress& prefix,
+                       const uint8_t prefix_len) const {
+    if (!prefix.isV6()) {
+        isc_throw(BadHostAddress, "must specify an IPv6 address when searching"
+                  " for a host, specified address was " << prefix);
+    }
+    for (auto index : findAddress6(prefix)) {
+        const Record& record = records_[index];
+        for (auto const& resrv : extras_[record.extra_ - 1].ipv6_reservations_) {
+            if ((resrv.second.getPrefix() == prefix) &&
+                (resrv.second.getPrefixLen() == prefix_len)) {
+                return (makeHost(index));
+            }
+        }
+    }
+    return (ConstHostPtr());
+}
+
+ConstHostPtr
+CompactHostStore::get6(const SubnetID& subnet_id,
+                       const IOAddress& address) const {
+    ConstHostCollection hosts = getAll6(subnet_id, address);
+    return (hosts.empty() ? ConstHostPtr() : hosts.front());
+}
+
+ConstHostCollection
+CompactHostStore::getAll6(const SubnetID& subnet_id,
+                          const IOAddress& address) const {
+    if (!address.isV6()) {
+        isc_throw(BadHostAddress, "must specify an IPv6 address when searching"
+                  " for a host, specified address was " << address);
+    }
+    ConstHostCollection hosts;
+    for (auto index : findAddress6(address)) {
+        if (records_[index].ipv6_subnet_id_ == subnet_id) {
+            hosts.push_back(makeHost(index));
+        }
+    }
+    return (hosts);
+}
+
+bool
+CompactHostStore::del(const SubnetID& subnet_id, const IOAddress& addr) {
+    std::vector<uint32_t> removed;
+    if (addr.isV4()) {
+        for (auto index : findAddress(addr)) {
+            if (records_[index].ipv4_subnet_id_ == subnet_id) {
+                removed.push_back(index);
+            }
+        }
+    } else {
+        for (auto index : findAddress6(addr)) {
+            if (records_[index].ipv6_subnet_id_ == subnet_id) {
+                removed.push_back(index);
+            }
+        }
+    }
+    for (auto index : removed) {
+        remove(index);
+    }
+    return (!removed.empty());
+}
+
+bool
+CompactHostStore::del4(const SubnetID& subnet_id,
+                       const Host::IdentifierType& identifier_type,
+                       const uint8_t* identifier_begin,
+                       const size_t identifier_len) {
+    for (auto index : findIdentifier(identifier_type, identifier_begin,
+                                     identifier_len)) {
+        if (records_[index].ipv4_subnet_id_ == subnet_id) {
+            remove(index);
+            return (true);
+        }
+    }
+    return (false);
+}
+
+bool
+CompactHostStore::del6(const SubnetID& subnet_id,
+                       const Host::IdentifierType& identifier_type,
+                       const uint8_t* identifier_begin,
+                       const size_t identifier_len) {
+    for (auto index : findIdentifier(identifier_type, identifier_begin,
+                                     identifier_len)) {
+        if (records_[index].ipv6_subnet_id_ == subnet_id) {
+            remove(index);
+            return (true);
+        }
+    }
+    return (false);
+}
+
+void
+CompactHostStore::reserve(size_t count) {
+    records_.reserve(count);
+}
+
+void
+CompactHostStore::shrink() {
+    records_.shrink_to_fit();
+    arena_.shrink_to_fit();
+    profiles_.shrink_to_fit();
+    extras_.shrink_to_fit();
+}
+
+size_t
+CompactHostStore::getMemoryUsage() const {
+    size_t usage = records_.capacity() * sizeof(Record);
+    usage += arena_.capacity();
+    usage += profiles_.capacity() * sizeof(Profile);
+    usage += extras_.capacity() * sizeof(Extra);
+    for (auto const& index : identifier_index_) {
+        usage += index.getMemoryUsage();
+    }
+    usage += address_index_.getMemoryUsage();
+    usage += address6_index_.bucket_count() * sizeof(void*);
+    usage += address6_index_.size() *
+        (sizeof(std::pair<IOAddress, uint32_t>) + 2 * sizeof(void*));
+    return (usage);
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
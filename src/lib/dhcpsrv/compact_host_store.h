@@ -0,0 +1,603 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef COMPACT_HOST_STORE_H
+#define COMPACT_HOST_STORE_H
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/base_host_data_source.h>
+#include <dhcpsrv/host.h>
+#include <dhcpsrv/subnet_id.h>
+
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Compact in-memory store of host reservations.
+///
+/// The @c CfgHosts class keeps full @c Host objects, each with its own
+/// pair of @c CfgOption trees, in a multi-index container. With millions
+/// of reservations this costs several kilobytes per host. This store
+/// keeps the reservations in columns instead:
+/// - a fixed size record per host holding the subnet identifiers, the
+///   IPv4 reservation and offsets into the other columns,
+/// - a byte arena holding the identifiers and hostnames,
+/// - a table of profiles, i.e. the option sets, client classes and boot
+///   parameters, shared by all the hosts with the same values,
+/// - a table of the rarely used per host values (IPv6 reservations,
+///   authentication key and user context),
+/// - an open addressing hash index per identifier type and one for the
+///   IPv4 reservations, each slot taking 8 bytes.
+///
+/// A host with an identifier, a hostname and an IPv4 reservation sharing
+/// its options with the other hosts takes less than a hundred bytes.
+///
+/// The lookups build a new @c Host object from the columns, the built
+/// hosts of a profile share the same @c CfgOption objects so they must
+/// not be modified. The deletions only mark the records as deleted,
+/// the space is not reclaimed.
+///
+/// Like @c CfgHosts the store must not be modified while it is used for
+/// lookups from several threads.
+class CompactHostStore : public BaseHostDataSource {
+public:
+
+    /// @brief Constructor.
+    CompactHostStore();
+
+    /// @brief Destructor.
+    virtual ~CompactHostStore() = default;
+
+    /// @brief Return all hosts connected to any subnet for which
+    /// reservations have been made using a specified identifier.
+    ///
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAll(const Host::IdentifierType& identifier_type,
+           const uint8_t* identifier_begin,
+           const size_t identifier_len) const;
+
+    /// @brief Return all hosts in a DHCPv4 subnet.
+    ///
+    /// @param subnet_id Subnet identifier.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAll4(const SubnetID& subnet_id) const;
+
+    /// @brief Return all hosts in a DHCPv6 subnet.
+    ///
+    /// @param subnet_id Subnet identifier.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAll6(const SubnetID& subnet_id) const;
+
+    /// @brief Return all hosts with a hostname.
+    ///
+    /// @param hostname The lower case hostname.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAllbyHostname(const std::string& hostname) const;
+
+    /// @brief Return all hosts with a hostname in a DHCPv4 subnet.
+    ///
+    /// @param hostname The lower case hostname.
+    /// @param subnet_id Subnet identifier.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAllbyHostname4(const std::string& hostname,
+                      const SubnetID& subnet_id) const;
+
+    /// @brief Return all hosts with a hostname in a DHCPv6 subnet.
+    ///
+    /// @param hostname The lower case hostname.
+    /// @param subnet_id Subnet identifier.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAllbyHostname6(const std::string& hostname,
+                      const SubnetID& subnet_id) const;
+
+    /// @brief Returns range of hosts in a DHCPv4 subnet.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param source_index Index of the source (unused).
+    /// @param lower_host_id Host identifier used as lower bound for the
+    /// returned range.
+    /// @param page_size maximum size of the page returned.
+    ///
+    /// @return Collection of const @c Host objects (may be empty).
+    virtual ConstHostCollection
+    getPage4(const SubnetID& subnet_id,
+             size_t& source_index,
+             uint64_t lower_host_id,
+             const HostPageSize& page_size) const;
+
+    /// @brief Returns range of hosts in a DHCPv6 subnet.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param source_index Index of the source (unused).
+    /// @param lower_host_id Host identifier used as lower bound for the
+    /// returned range.
+    /// @param page_size maximum size of the page returned.
+    ///
+    /// @return Collection of const @c Host objects (may be empty).
+    virtual ConstHostCollection
+    getPage6(const SubnetID& subnet_id,
+             size_t& source_index,
+             uint64_t lower_host_id,
+             const HostPageSize& page_size) const;
+
+    /// @brief Returns range of hosts.
+    ///
+    /// @param source_index Index of the source (unused).
+    /// @param lower_host_id Host identifier used as lower bound for the
+    /// returned range.
+    /// @param page_size maximum size of the page returned.
+    ///
+    /// @return Collection of const @c Host objects (may be empty).
+    virtual ConstHostCollection
+    getPage4(size_t& source_index,
+             uint64_t lower_host_id,
+             const HostPageSize& page_size) const;
+
+    /// @brief Returns range of hosts.
+    ///
+    /// @param source_index Index of the source (unused).
+    /// @param lower_host_id Host identifier used as lower bound for the
+    /// returned range.
+    /// @param page_size maximum size of the page returned.
+    ///
+    /// @return Collection of const @c Host objects (may be empty).
+    virtual ConstHostCollection
+    getPage6(size_t& source_index,
+             uint64_t lower_host_id,
+             const HostPageSize& page_size) const;
+
+    /// @brief Returns a collection of hosts using the specified IPv4 address.
+    ///
+    /// @param address IPv4 address for which the @c Host object is searched.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAll4(const asiolink::IOAddress& address) const;
+
+    /// @brief Returns a host connected to the IPv4 subnet.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    ///
+    /// @return Const @c Host object for which reservation has been made using
+    /// the specified identifier.
+    virtual ConstHostPtr
+    get4(const SubnetID& subnet_id,
+         const Host::IdentifierType& identifier_type,
+         const uint8_t* identifier_begin,
+         const size_t identifier_len) const;
+
+    /// @brief Returns a host connected to the IPv4 subnet and having
+    /// a reservation for a specified IPv4 address.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param address reserved IPv4 address.
+    ///
+    /// @return Const @c Host object using a specified IPv4 address.
+    virtual ConstHostPtr
+    get4(const SubnetID& subnet_id,
+         const asiolink::IOAddress& address) const;
+
+    /// @brief Returns all hosts connected to the IPv4 subnet and having
+    /// a reservation for a specified address.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param address reserved IPv4 address.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAll4(const SubnetID& subnet_id,
+            const asiolink::IOAddress& address) const;
+
+    /// @brief Returns a host connected to the IPv6 subnet.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    ///
+    /// @return Const @c Host object for which reservation has been made using
+    /// the specified identifier.
+    virtual ConstHostPtr
+    get6(const SubnetID& subnet_id,
+         const Host::IdentifierType& identifier_type,
+         const uint8_t* identifier_begin,
+         const size_t identifier_len) const;
+
+    /// @brief Returns a host using the specified IPv6 prefix.
+    ///
+    /// @param prefix IPv6 prefix for which the @c Host object is searched.
+    /// @param prefix_len IPv6 prefix length.
+    ///
+    /// @return Const @c Host object using a specified IPv6 prefix.
+    virtual ConstHostPtr
+    get6(const asiolink::IOAddress& prefix, const uint8_t prefix_len) const;
+
+    /// @brief Returns a host connected to the IPv6 subnet and having
+    /// a reservation for a specified IPv6 address or prefix.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param address reserved IPv6 address/prefix.
+    ///
+    /// @return Const @c Host object using a specified IPv6 address/prefix.
+    virtual ConstHostPtr
+    get6(const SubnetID& subnet_id, const asiolink::IOAddress& address) const;
+
+    /// @brief Returns all hosts connected to the IPv6 subnet and having
+    /// a reservation for a specified address or prefix.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param address reserved IPv6 address/prefix.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAll6(const SubnetID& subnet_id,
+            const asiolink::IOAddress& address) const;
+
+    /// @brief Adds a new host to the store.
+    ///
+    /// The host is copied into the columns and the object itself is not
+    /// kept. Its host identifier is set to the index of the record plus 1.
+    ///
+    /// @param host Pointer to the new @c Host object being added.
+    /// @throw BadValue when the host is null or connected to no subnet.
+    /// @throw DuplicateHost when a host with the same identifier already
+    /// exists in one of its subnets.
+    /// @throw ReservedAddress when the IPv4 reservations must be unique
+    /// and there is already one for the address in the IPv4 subnet.
+    virtual void add(const HostPtr& host);
+
+    /// @brief Attempts to delete hosts by (subnet-id, address).
+    ///
+    /// @param subnet_id subnet identifier.
+    /// @param addr specified address.
+    /// @return true if deletion was successful, false otherwise.
+    virtual bool del(const SubnetID& subnet_id, const asiolink::IOAddress& addr);
+
+    /// @brief Attempts to delete a host by (subnet4-id, identifier type,
+    /// identifier).
+    ///
+    /// @param subnet_id IPv4 Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    /// @return true if deletion was successful, false otherwise.
+    virtual bool del4(const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len);
+
+    /// @brief Attempts to delete a host by (subnet6-id, identifier type,
+    /// identifier).
+    ///
+    /// @param subnet_id IPv6 Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    /// @return true if deletion was successful, false otherwise.
+    virtual bool del6(const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len);
+
+    /// @brief Return backend type
+    ///
+    /// @return "compact".
+    virtual std::string getType() const {
+        return ("compact");
+    }
+
+    /// @brief Controls whether IP reservations are unique or non-unique.
+    ///
+    /// @param unique boolean flag indicating if the IP reservations must be
+    /// unique or can be non-unique.
+    /// @return always true.
+    virtual bool setIPReservationsUnique(const bool unique) {
+        ip_reservations_unique_ = unique;
+        return (true);
+    }
+
+    /// @brief Reserves space for a number of hosts.
+    ///
+    /// This avoids the reallocations when the number of hosts to be added
+    /// is known, e.g. when loading a configuration.
+    ///
+    /// @param count expected number of hosts.
+    void reserve(size_t count);
+
+    /// @brief Releases the unused capacity of the columns.
+    void shrink();
+
+    /// @brief Returns the number of hosts, not including the deleted ones.
+    size_t size() const {
+        return (records_.size() - deleted_);
+    }
+
+    /// @brief Returns the number of distinct profiles.
+    ///
+    /// A profile holds the values shared between the hosts: the option
+    /// sets, the client classes and the boot parameters.
+    size_t getProfileCount() const {
+        return (profiles_.size());
+    }
+
+    /// @brief Returns an estimation of the memory used by the store.
+    ///
+    /// The shared profiles and the rarely used per host values are not
+    /// fully accounted.
+    ///
+    /// @return the number of bytes.
+    size_t getMemoryUsage() const;
+
+private:
+
+    /// @brief An open addressing hash index of records.
+    ///
+    /// A slot holds a 32 bit hash and a record index, the keys are not
+    /// stored so the caller checks the records of the slots matching the
+    /// hash. The index is multi-valued.
+    class Index {
+    public:
+
+        /// @brief Constructor.
+        Index() : count_(0) {
+        }
+
+        /// @brief Inserts a record.
+        ///
+        /// @param hash the hash of the record key.
+        /// @param record the record index.
+        void insert(uint32_t hash, uint32_t record);
+
+        /// @brief Returns the records with a hash.
+        ///
+        /// @param hash the hash of the key.
+        /// @param records the record indexes are appended to this vector.
+        void find(uint32_t hash, std::vector<uint32_t>& records) const;
+
+        /// @brief Returns the memory used by the slots.
+        size_t getMemoryUsage() const {
+            return (slots_.capacity() * sizeof(Slot));
+        }
+
+    private:
+
+        /// @brief Rebuilds the index with a number of slots.
+        ///
+        /// @param size the number of slots, a power of 2.
+        void rehash(size_t size);
+
+        /// @brief A slot of the index.
+        struct Slot {
+            /// @brief The hash of the record key.
+            uint32_t hash_;
+
+            /// @brief The record index, EMPTY when the slot is unused.
+            uint32_t record_;
+        };
+
+        /// @brief The record index of an unused slot.
+        static const uint32_t EMPTY = 0xffffffff;
+
+        /// @brief The slots.
+        std::vector<Slot> slots_;
+
+        /// @brief The number of used slots.
+        size_t count_;
+    };
+
+    /// @brief The fixed size record of a host.
+    struct Record {
+        /// @brief Offset of the identifier in the arena, the hostname
+        /// follows the identifier.
+        uint32_t identifier_offset_;
+
+        /// @brief Length of the identifier.
+        uint8_t identifier_len_;
+
+        /// @brief Type of the identifier, DELETED for deleted records.
+        uint8_t identifier_type_;
+
+        /// @brief Length of the hostname.
+        uint16_t hostname_len_;
+
+        /// @brief IPv4 subnet identifier.
+        SubnetID ipv4_subnet_id_;
+
+        /// @brief IPv6 subnet identifier.
+        SubnetID ipv6_subnet_id_;
+
+        /// @brief IPv4 reservation, 0 when none.
+        uint32_t ipv4_reservation_;
+
+        /// @brief Index of the profile.
+        uint32_t profile_;
+
+        /// @brief Index of the extra values plus 1, 0 when none.
+        uint32_t extra_;
+    };
+
+    /// @brief The values shared between hosts.
+    struct Profile {
+        /// @brief DHCPv4 options.
+        CfgOptionPtr cfg_option4_;
+
+        /// @brief DHCPv6 options.
+        CfgOptionPtr cfg_option6_;
+
+        /// @brief DHCPv4 client classes as comma separated text.
+        std::string client_classes4_;
+
+        /// @brief DHCPv6 client classes as comma separated text.
+        std::string client_classes6_;
+
+        /// @brief Next server address.
+        asiolink::IOAddress next_server_;
+
+        /// @brief Server hostname.
+        std::string server_hostname_;
+
+        /// @brief Boot file name.
+        std::string boot_file_name_;
+    };
+
+    /// @brief The rarely used per host values.
+    struct Extra {
+        /// @brief IPv6 reservations.
+        IPv6ResrvCollection ipv6_reservations_;
+
+        /// @brief Authentication key.
+        AuthKey key_;
+
+        /// @brief User context.
+        data::ConstElementPtr context_;
+    };
+
+    /// @brief The identifier type of deleted records.
+    static const uint8_t DELETED = 0xff;
+
+    /// @brief Returns the hash of an identifier.
+    ///
+    /// @param identifier_begin pointer to the identifier.
+    /// @param identifier_len identifier length.
+    /// @return the hash.
+    static uint32_t hashIdentifier(const uint8_t* identifier_begin,
+                                   const size_t identifier_len);
+
+    /// @brief Returns the hash of an IPv4 address.
+    ///
+    /// @param address the address as an integer.
+    /// @return the hash.
+    static uint32_t hashAddress(uint32_t address);
+
+    /// @brief Returns the index of the profile of a host, adding one
+    /// when needed.
+    ///
+    /// @param host the host.
+    /// @return the profile index.
+    uint32_t getProfile(const Host& host);
+
+    /// @brief Returns the records of the hosts with an identifier.
+    ///
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to the identifier.
+    /// @param identifier_len Identifier length.
+    /// @return the record indexes of the matching live hosts.
+    std::vector<uint32_t>
+    findIdentifier(const Host::IdentifierType& identifier_type,
+                   const uint8_t* identifier_begin,
+                   const size_t identifier_len) const;
+
+    /// @brief Returns the records of the hosts with an IPv4 reservation.
+    ///
+    /// @param address the reserved address.
+    /// @return the record indexes of the matching live hosts.
+    std::vector<uint32_t> findAddress(const asiolink::IOAddress& address) const;
+
+    /// @brief Returns the records of the hosts with an IPv6 reservation.
+    ///
+    /// @param address the reserved address or prefix.
+    /// @return the record indexes of the matching live hosts.
+    std::vector<uint32_t> findAddress6(const asiolink::IOAddress& address) const;
+
+    /// @brief Builds a host from its record.
+    ///
+    /// @param index the record index.
+    /// @return the host.
+    HostPtr makeHost(uint32_t index) const;
+
+    /// @brief Marks a record as deleted.
+    ///
+    /// @param index the record index.
+    void remove(uint32_t index);
+
+    /// @brief Returns the hosts with a hostname.
+    ///
+    /// @tparam Filter type of the record filter.
+    /// @param hostname The lower case hostname.
+    /// @param filter the record filter.
+    /// @return Collection of const @c Host objects.
+    template<typename Filter>
+    ConstHostCollection getAllbyHostname(const std::string& hostname,
+                                         Filter filter) const;
+
+    /// @brief Returns a page of hosts.
+    ///
+    /// @tparam Filter type of the record filter.
+    /// @param filter the record filter.
+    /// @param lower_host_id Host identifier used as lower bound.
+    /// @param page_size maximum size of the page returned.
+    /// @return Collection of const @c Host objects.
+    template<typename Filter>
+    ConstHostCollection getPage(Filter filter, uint64_t lower_host_id,
+                                const HostPageSize& page_size) const;
+
+    /// @brief The host records, the host identifier is the index plus 1.
+    std::vector<Record> records_;
+
+    /// @brief The identifiers and hostnames.
+    std::vector<uint8_t> arena_;
+
+    /// @brief The profiles.
+    std::vector<Profile> profiles_;
+
+    /// @brief The profile indexes by the profile text representation.
+    std::unordered_map<std::string, uint32_t> profile_index_;
+
+    /// @brief The extra values.
+    std::vector<Extra> extras_;
+
+    /// @brief The hash indexes by identifier type.
+    Index identifier_index_[Host::LAST_IDENTIFIER_TYPE + 1];
+
+    /// @brief The hash index of IPv4 reservations.
+    Index address_index_;
+
+    /// @brief The index of IPv6 reservations.
+    std::unordered_multimap<asiolink::IOAddress, uint32_t,
+                            asiolink::IOAddress::Hash> address6_index_;
+
+    /// @brief The number of deleted records.
+    size_t deleted_;
+
+    /// @brief Holds the setting whether the IP reservations must be unique
+    /// or may be non-unique.
+    bool ip_reservations_unique_;
+};
+
+/// @brief Pointer to a compact host store.
+typedef boost::shared_ptr<CompactHostStore> CompactHostStorePtr;
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // COMPACT_HOST_STORE_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2019-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -20,6 +20,7 @@
 #include <dhcpsrv/shared_network.h>
 #include <dhcpsrv/subnet.h>
 #include <boost/date_time/posix_time/ptime.hpp>
+#include <boost/shared_ptr.hpp>
 #include <string>
 
 namespace isc {
@@ -646,6 +647,9 @@ public:
     deleteAllServers6(const db::BackendSelector& backend_selector);
 };
 
+/// @brief Pointer to the @c ConfigBackendPoolDHCPv6.
+typedef boost::shared_ptr<ConfigBackendPoolDHCPv6> ConfigBackendPoolDHCPv6Ptr;
+
 
 } // end of namespace isc::dhcp
 } // end of namespace isc
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -34,6 +34,9 @@ namespace dhcp {
 class CSVLeaseFile4 : public isc::util::VersionedCSVFile, public LeaseFileStats {
 public:
 
+    /// @brief Type of a row read from the lease file.
+    typedef util::CSVRow RowType;
+
     /// @brief Constructor.
     ///
     /// Initializes columns of the lease file.
@@ -85,6 +88,39 @@ public:
     /// ticket http://oldkea.isc.org/ticket/2405 is implemented.
     bool next(Lease4Ptr& lease);
 
+    /// @brief Reads next row of the CSV file.
+    ///
+    /// This function and @c parse read leases in two steps, so the rows
+    /// can be parsed by many threads while this file is read by one
+    /// thread. It bumps the number of read attempts. The caller should
+    /// then report the outcome of parsing the row with @c updateReadStats.
+    ///
+    /// This function is exception safe.
+    ///
+    /// @param [out] row Row read from the file or the @c EMPTY_ROW at the
+    /// end of file.
+    ///
+    /// @return false if the row couldn't be read. The error message is set
+    /// using @c CSVFile::setReadMsg and the number of read errors is bumped.
+    bool nextRow(util::CSVRow& row);
+
+    /// @brief Creates a lease from a row read with @c nextRow.
+    ///
+    /// This function doesn't modify the lease file so it may be called
+    /// by many threads at the same time.
+    ///
+    /// @param row CSV file row holding lease information.
+    ///
+    /// @return Pointer to the lease.
+    /// @throw an exception if the row doesn't hold a valid lease.
+    Lease4Ptr parse(const util::CSVRow& row) const;
+
+    /// @brief Updates the read statistics after parsing a row.
+    ///
+    /// @param parsed true if the lease was parsed, false if the row
+    /// was found invalid.
+    void updateReadStats(const bool parsed);
+
 private:
 
     /// @brief Initializes columns of the CSV file holding leases.
@@ -111,59 +147,61 @@ private:
     /// @brief Reads lease address from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    asiolink::IOAddress readAddress(const util::CSVRow& row);
+    asiolink::IOAddress readAddress(const util::CSVRow& row) const;
 
     /// @brief Reads HW address from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    HWAddr readHWAddr(const util::CSVRow& row);
+    HWAddr readHWAddr(const util::CSVRow& row) const;
 
     /// @brief Reads client identifier from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    ClientIdPtr readClientId(const util::CSVRow& row);
+    ClientIdPtr readClientId(const util::CSVRow& row) const;
 
     /// @brief Reads valid lifetime from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    uint32_t readValid(const util::CSVRow& row);
+    uint32_t readValid(const util::CSVRow& row) const;
 
     /// @brief Reads cltt value from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    time_t readCltt(const util::CSVRow& row);
+    time_t readCltt(const util::CSVRow& row) const;
 
     /// @brief Reads subnet id from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    SubnetID readSubnetID(const util::CSVRow& row);
+    SubnetID readSubnetID(const util::CSVRow& row) const;
 
     /// @brief Reads the FQDN forward flag from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    bool readFqdnFwd(const util::CSVRow& row);
+    bool readFqdnFwd(const util::CSVRow& row) const;
 
     /// @brief Reads the FQDN reverse flag from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    bool readFqdnRev(const util::CSVRow& row);
+    bool readFqdnRev(const util::CSVRow& row) const;
 
     /// @brief Reads hostname from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    std::string readHostname(const util::CSVRow& row);
+    std::string readHostname(const util::CSVRow& row) const;
 
     /// @brief Reads lease state from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    uint32_t readState(const util::CSVRow& row);
+    uint32_t readState(const util::CSVRow& row) const;
 
     /// @brief Reads lease user context from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    data::ConstElementPtr readContext(const util::CSVRow& row);
+    data::ConstElementPtr readContext(const util::CSVRow& row) const;
     //@}
 
+    /// @brief Row reused by @c next to read the leases.
+    util::CSVRow row_;
 };
 
 } // namespace isc::dhcp
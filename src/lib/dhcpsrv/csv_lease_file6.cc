@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -91,35 +91,17 @@ CSVLeaseFile6::next(Lease6Ptr& lease) {
     // to throw exceptions, so we catch them all and rather return the
     // false value.
     try {
-        // Get the row of CSV values.
-        CSVRow row;
-        VersionedCSVFile::next(row);
+        // Get the row of CSV values. The row is reused from one lease to
+        // the next so its storage is reused too.
+        VersionedCSVFile::next(row_);
         // The empty row signals EOF.
-        if (row == CSVFile::EMPTY_ROW()) {
+        if (row_ == CSVFile::EMPTY_ROW()) {
             lease.reset();
             return (true);
         }
 
-        lease.reset(new Lease6(readType(row), readAddress(row), readDUID(row),
-                               readIAID(row), readPreferred(row),
-                               readValid(row),
-                               readSubnetID(row),
-                               readHWAddr(row),
-                               readPrefixLen(row)));
-        lease->cltt_ = readCltt(row);
-        lease->fqdn_fwd_ = readFqdnFwd(row);
-        lease->fqdn_rev_ = readFqdnRev(row);
-        lease->hostname_ = readHostname(row);
-        lease->state_ = readState(row);
-        if ((*lease->duid_ == DUID::EMPTY())
-            && lease->state_ != Lease::STATE_DECLINED) {
-            isc_throw(isc::BadValue,
-                      "The Empty DUID is only valid for declined leases");
-        }
-        ConstElementPtr ctx = readContext(row);
-        if (ctx) {
-            lease->setContext(ctx);
-        }
+        lease = parse(row_);
+
     } catch (const std::exception& ex) {
         // bump the read error count
         ++read_errs_;
@@ -137,6 +119,56 @@ CSVLeaseFile6::next(Lease6Ptr& lease) {
     return (true);
 }
 
+bool
+CSVLeaseFile6::nextRow(CSVRow& row) {
+    // Bump the number of read attempts
+    ++reads_;
+
+    try {
+        VersionedCSVFile::next(row);
+
+    } catch (const std::exception& ex) {
+        ++read_errs_;
+        setReadMsg(ex.what());
+        return (false);
+    }
+    return (true);
+}
+
+Lease6Ptr
+CSVLeaseFile6::parse(const CSVRow& row) const {
+    Lease6Ptr lease(new Lease6(readType(row), readAddress(row), readDUID(row),
+                               readIAID(row), readPreferred(row),
+                               readValid(row),
+                               readSubnetID(row),
+                               readHWAddr(row),
+                               readPrefixLen(row)));
+    lease->cltt_ = readCltt(row);
+    lease->fqdn_fwd_ = readFqdnFwd(row);
+    lease->fqdn_rev_ = readFqdnRev(row);
+    lease->hostname_ = readHostname(row);
+    lease->state_ = readState(row);
+    if ((*lease->duid_ == DUID::EMPTY())
+        && lease->state_ != Lease::STATE_DECLINED) {
+        isc_throw(isc::BadValue,
+                  "The Empty DUID is only valid for declined leases");
+    }
+    ConstElementPtr ctx = readContext(row);
+    if (ctx) {
+        lease->setContext(ctx);
+    }
+    return (lease);
+}
+
+void
+CSVLeaseFile6::updateReadStats(const bool parsed) {
+    if (parsed) {
+        ++read_leases_;
+    } else {
+        ++read_errs_;
+    }
+}
+
 void
 CSVLeaseFile6::initColumns() {
     addColumn("address", "1.0");
@@ -167,45 +199,45 @@ CSVLeaseFile6::initColumns() {
 }
 
 Lease::Type
-CSVLeaseFile6::readType(const CSVRow& row) {
+CSVLeaseFile6::readType(const CSVRow& row) const {
     return (static_cast<Lease::Type>
             (row.readAndConvertAt<int>(getColumnIndex("lease_type"))));
 }
 
 IOAddress
-CSVLeaseFile6::readAddress(const CSVRow& row) {
+CSVLeaseFile6::readAddress(const CSVRow& row) const {
     IOAddress address(row.readAt(getColumnIndex("address")));
     return (address);
 }
 
 DuidPtr
-CSVLeaseFile6::readDUID(const util::CSVRow& row) {
+CSVLeaseFile6::readDUID(const util::CSVRow& row) const {
     DuidPtr duid(new DUID(DUID::fromText(row.readAt(getColumnIndex("duid")))));
     return (duid);
 }
 
 uint32_t
-CSVLeaseFile6::readIAID(const CSVRow& row) {
+CSVLeaseFile6::readIAID(const CSVRow& row) const {
     uint32_t iaid = row.readAndConvertAt<uint32_t>(getColumnIndex("iaid"));
     return (iaid);
 }
 
 uint32_t
-CSVLeaseFile6::readPreferred(const CSVRow& row) {
+CSVLeaseFile6::readPreferred(const CSVRow& row) const {
     uint32_t pref =
         row.readAndConvertAt<uint32_t>(getColumnIndex("pref_lifetime"));
     return (pref);
 }
 
 uint32_t
-CSVLeaseFile6::readValid(const CSVRow& row) {
+CSVLeaseFile6::readValid(const CSVRow& row) const {
     uint32_t valid =
         row.readAndConvertAt<uint32_t>(getColumnIndex("valid_lifetime"));
     return (valid);
 }
 
 uint32_t
-CSVLeaseFile6::readCltt(const CSVRow& row) {
+CSVLeaseFile6::readCltt(const CSVRow& row) const {
     time_t cltt =
         static_cast<time_t>(row.readAndConvertAt<uint64_t>(getColumnIndex("expire"))
                             - readValid(row));
@@ -213,38 +245,38 @@ CSVLeaseFile6::readCltt(const CSVRow& row) {
 }
 
 SubnetID
-CSVLeaseFile6::readSubnetID(const CSVRow& row) {
+CSVLeaseFile6::readSubnetID(const CSVRow& row) const {
     SubnetID subnet_id =
         row.readAndConvertAt<SubnetID>(getColumnIndex("subnet_id"));
     return (subnet_id);
 }
 
 uint8_t
-CSVLeaseFile6::readPrefixLen(const CSVRow& row) {
+CSVLeaseFile6::readPrefixLen(const CSVRow& row) const {
     int prefixlen = row.readAndConvertAt<int>(getColumnIndex("prefix_len"));
     return (static_cast<uint8_t>(prefixlen));
 }
 
 bool
-CSVLeaseFile6::readFqdnFwd(const CSVRow& row) {
+CSVLeaseFile6::readFqdnFwd(const CSVRow& row) const {
     bool fqdn_fwd = row.readAndConvertAt<bool>(getColumnIndex("fqdn_fwd"));
     return (fqdn_fwd);
 }
 
 bool
-CSVLeaseFile6::readFqdnRev(const CSVRow& row) {
+CSVLeaseFile6::readFqdnRev(const CSVRow& row) const {
     bool fqdn_rev = row.readAndConvertAt<bool>(getColumnIndex("fqdn_rev"));
     return (fqdn_rev);
 }
 
 std::string
-CSVLeaseFile6::readHostname(const CSVRow& row) {
+CSVLeaseFile6::readHostname(const CSVRow& row) const {
     std::string hostname = row.readAtEscaped(getColumnIndex("hostname"));
     return (hostname);
 }
 
 HWAddrPtr
-CSVLeaseFile6::readHWAddr(const CSVRow& row) {
+CSVLeaseFile6::readHWAddr(const CSVRow& row) const {
 
     try {
         uint16_t const hwtype(readHWType(row).valueOr(HTYPE_ETHER));
@@ -273,13 +305,13 @@ CSVLeaseFile6::readHWAddr(const CSVRow& row) {
 }
 
 uint32_t
-CSVLeaseFile6::readState(const util::CSVRow& row) {
+CSVLeaseFile6::readState(const util::CSVRow& row) const {
     uint32_t state = row.readAndConvertAt<uint32_t>(getColumnIndex("state"));
     return (state);
 }
 
 ConstElementPtr
-CSVLeaseFile6::readContext(const util::CSVRow& row) {
+CSVLeaseFile6::readContext(const util::CSVRow& row) const {
     std::string user_context = row.readAtEscaped(getColumnIndex("user_context"));
     if (user_context.empty()) {
         return (ConstElementPtr());
@@ -293,7 +325,7 @@ CSVLeaseFile6::readContext(const util::CSVRow& row) {
 }
 
 Optional<uint16_t>
-CSVLeaseFile6::readHWType(const CSVRow& row) {
+CSVLeaseFile6::readHWType(const CSVRow& row) const {
     size_t const index(getColumnIndex("hwtype"));
     if (row.readAt(index).empty()) {
         return Optional<uint16_t>();
@@ -302,7 +334,7 @@ CSVLeaseFile6::readHWType(const CSVRow& row) {
 }
 
 Optional<uint32_t>
-CSVLeaseFile6::readHWAddrSource(const CSVRow& row) {
+CSVLeaseFile6::readHWAddrSource(const CSVRow& row) const {
     size_t const index(getColumnIndex("hwaddr_source"));
     if (row.readAt(index).empty()) {
         return Optional<uint16_t>();
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -91,7 +91,7 @@ public:
     /// @param ncr_protocol Socket protocol to use with kea-dhcp-ddns
     /// Currently only UDP is supported.
     /// @param ncr_format Format of the kea-dhcp-ddns requests.
-    /// Currently only JSON format is supported.
+    /// Currently JSON and BINARY formats are supported.
     /// @c enable_updates is mandatory, other parameters are optional.
     ///
     /// @throw D2ClientError if given an invalid protocol or format.
@@ -225,7 +225,7 @@ private:
     dhcp_ddns::NameChangeProtocol ncr_protocol_;
 
     /// @brief Format of the kea-dhcp-ddns requests.
-    /// Currently only JSON format is supported.
+    /// Currently JSON and BINARY formats are supported.
     dhcp_ddns::NameChangeFormat ncr_format_;
 };
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,6 +14,7 @@
 #include <functional>
 #include <string>
 
+using namespace isc::asiolink;
 using namespace std;
 
 namespace isc {
@@ -21,7 +22,8 @@ namespace dhcp {
 
 D2ClientMgr::D2ClientMgr() : d2_client_config_(new D2ClientConfig()),
     name_change_sender_(), private_io_service_(),
-    registered_select_fd_(util::WatchSocket::SOCKET_NOT_VALID) {
+    registered_select_fd_(util::WatchSocket::SOCKET_NOT_VALID),
+    sender_thread_(), defer_(false), deferred_(), deferred_mutex_() {
     // Default constructor initializes with a disabled configuration.
 }
 
@@ -256,6 +258,10 @@ D2ClientMgr::startSender(D2ClientErrorHandler error_handler) {
         return;
     }
 
+    // The thread may still run the previous service when it stopped the
+    // sender itself.
+    stopSenderThread();
+
     // Create a our own service instance when we are not being multiplexed
     // into an external service..
     private_io_service_.reset(new asiolink::IOService());
@@ -299,8 +305,67 @@ D2ClientMgr::amSending() const {
     return (name_change_sender_ && name_change_sender_->amSending());
 }
 
+void
+D2ClientMgr::startSenderThread() {
+    if (sender_thread_ || !amSending() || !private_io_service_) {
+        return;
+    }
+
+    // The main loop no longer processes the sender IO.
+    if (registered_select_fd_ != util::WatchSocket::SOCKET_NOT_VALID) {
+        IfaceMgr::instance().deleteExternalSocket(registered_select_fd_);
+        registered_select_fd_ = util::WatchSocket::SOCKET_NOT_VALID;
+    }
+
+    sender_thread_.reset(new IoServiceThreadPool(private_io_service_, 1));
+    {
+        lock_guard<mutex> lock(deferred_mutex_);
+        defer_ = true;
+    }
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_DHCP_DDNS_SENDER_THREAD_STARTED);
+}
+
+void
+D2ClientMgr::stopSenderThread() {
+    if (!sender_thread_) {
+        return;
+    }
+
+    sender_thread_->stop();
+    sender_thread_.reset();
+    // The stop leaves the service stopped: restart it so the main loop
+    // can poll it.
+    private_io_service_->restart();
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_DHCP_DDNS_SENDER_THREAD_STOPPED);
+
+    // Build and send the requests queued before the thread stopped.
+    {
+        lock_guard<mutex> lock(deferred_mutex_);
+        defer_ = false;
+    }
+    sendDeferredBatch();
+
+    // Give the sender IO back to the main loop.
+    if (amSending()) {
+        registered_select_fd_ = name_change_sender_->getSelectFd();
+        IfaceMgr::instance().addExternalSocket(registered_select_fd_,
+                                               std::bind(&D2ClientMgr::runReadyIO,
+                                                         this));
+    }
+}
+
 void
 D2ClientMgr::stopSender() {
+    // Stop the thread processing the sender IO. When the sender is
+    // stopped by this thread, e.g. from the error handler, the thread
+    // can't stop itself: it stays idle until the main thread starts
+    // the sender again or destroys the manager.
+    try {
+        stopSenderThread();
+    } catch (const MultiThreadingInvalidOperation&) {
+        // Called by the sender thread.
+    }
+
     /// Unregister sender's select-fd.
     if (registered_select_fd_ != util::WatchSocket::SOCKET_NOT_VALID) {
         IfaceMgr::instance().deleteExternalSocket(registered_select_fd_);
@@ -330,6 +395,80 @@ D2ClientMgr::sendRequest(dhcp_ddns::NameChangeRequestPtr& ncr) {
     }
 }
 
+void
+D2ClientMgr::sendRequests(const vector<dhcp_ddns::NameChangeRequestPtr>& ncrs) {
+    if (!amSending()) {
+        // This is programmatic error so bust them for it.
+        isc_throw(D2ClientError, "D2ClientMgr::sendRequests not in send mode");
+    }
+
+    size_t queued = 0;
+    string error = "send queue has reached maximum capacity";
+    try {
+        queued = name_change_sender_->sendRequests(ncrs);
+    } catch (const std::exception& ex) {
+        error = ex.what();
+    }
+    for (size_t i = queued; i < ncrs.size(); ++i) {
+        dhcp_ddns::NameChangeRequestPtr ncr = ncrs[i];
+        LOG_ERROR(dhcpsrv_logger, DHCPSRV_DHCP_DDNS_NCR_REJECTED)
+                  .arg(error).arg((ncr ? ncr->toText() : " NULL "));
+        invokeClientErrorHandler(dhcp_ddns::NameChangeSender::ERROR, ncr);
+    }
+}
+
+void
+D2ClientMgr::sendDeferred(const NcrBuilder& builder) {
+    {
+        lock_guard<mutex> lock(deferred_mutex_);
+        if (defer_) {
+            // The first queued builder schedules the batch.
+            if (deferred_.empty()) {
+                private_io_service_->post(std::bind(&D2ClientMgr::sendDeferredBatch,
+                                                    this));
+            }
+            deferred_.push_back(builder);
+            return;
+        }
+    }
+
+    dhcp_ddns::NameChangeRequestPtr ncr = builder();
+    if (ncr) {
+        sendRequest(ncr);
+    }
+}
+
+void
+D2ClientMgr::sendDeferredBatch() {
+    vector<NcrBuilder> builders;
+    {
+        lock_guard<mutex> lock(deferred_mutex_);
+        builders.swap(deferred_);
+    }
+    if (builders.empty()) {
+        return;
+    }
+
+    // The builders log their own errors.
+    vector<dhcp_ddns::NameChangeRequestPtr> ncrs;
+    ncrs.reserve(builders.size());
+    for (auto const& builder : builders) {
+        dhcp_ddns::NameChangeRequestPtr ncr = builder();
+        if (ncr) {
+            ncrs.push_back(ncr);
+        }
+    }
+
+    try {
+        sendRequests(ncrs);
+    } catch (const std::exception& ex) {
+        for (auto const& ncr : ncrs) {
+            LOG_ERROR(dhcpsrv_logger, DHCPSRV_DHCP_DDNS_NCR_REJECTED)
+                      .arg(ex.what()).arg(ncr->toText());
+        }
+    }
+}
+
 void
 D2ClientMgr::invokeClientErrorHandler(const dhcp_ddns::NameChangeSender::
                                       Result result,
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,6 +12,7 @@
 /// kea-dhcp-ddns module (aka D2).
 ///
 #include <asiolink/io_address.h>
+#include <asiolink/io_service_thread_pool.h>
 #include <dhcp_ddns/ncr_io.h>
 #include <dhcpsrv/d2_client_cfg.h>
 #include <dhcpsrv/srv_config.h>
@@ -21,6 +22,8 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/noncopyable.hpp>
 
+#include <functional>
+#include <mutex>
 #include <stdint.h>
 #include <string>
 #include <vector>
@@ -312,6 +315,33 @@ public:
     /// messages for transmission, false otherwise.
     bool amSending() const;
 
+    /// @brief Processes the sender IO in a dedicated thread.
+    ///
+    /// The sender IO is normally processed by the main loop of the server
+    /// through the select-fd registered with IfaceMgr, so a slow timer
+    /// callback or command delays the completion of the sends. In
+    /// multi-threading mode a dedicated thread can run the private
+    /// IOService of the sender instead: the select-fd is then unregistered.
+    /// Does nothing if the sender is not in send mode with its private
+    /// IOService or if the thread is already running.
+    ///
+    /// @note The sender must be thread safe, i.e. the multi-threading mode
+    /// must be enabled, while the thread is running.
+    void startSenderThread();
+
+    /// @brief Stops the thread processing the sender IO.
+    ///
+    /// The select-fd is registered with IfaceMgr again so the main loop
+    /// processes the sender IO. Does nothing if the thread is not running.
+    /// This method must not be called by the thread itself.
+    void stopSenderThread();
+
+    /// @brief Returns true if the sender IO is processed by a dedicated
+    /// thread, false otherwise.
+    bool isSenderThreadRunning() const {
+        return (static_cast<bool>(sender_thread_));
+    }
+
     /// @brief Disables sending NameChangeRequests to kea-dhcp-ddns
     ///
     /// Takes the NameChangeSender out of send mode.  The sender will stop
@@ -335,6 +365,38 @@ public:
     /// mode.  Either of these represents a programmatic error.
     void sendRequest(dhcp_ddns::NameChangeRequestPtr& ncr);
 
+    /// @brief Send the given NameChangeRequests to kea-dhcp-ddns
+    ///
+    /// Passes the NameChangeRequests to the NCR sender at once. The client's
+    /// error handler is invoked for each rejected request.
+    ///
+    /// @param ncrs NameChangeRequests to send
+    ///
+    /// @throw D2ClientError if sender instance is null or not in send
+    /// mode.
+    void sendRequests(const std::vector<dhcp_ddns::NameChangeRequestPtr>& ncrs);
+
+    /// @brief Type of the functions building a NameChangeRequest.
+    ///
+    /// A builder returns null when the request could not be built.
+    typedef std::function<dhcp_ddns::NameChangeRequestPtr()> NcrBuilder;
+
+    /// @brief Builds and sends a NameChangeRequest, in the sender thread
+    /// when it is running.
+    ///
+    /// Building a request includes the computation of the DHCID, a SHA-256
+    /// digest, so the packet processing threads only queue the builder
+    /// while the sender thread builds the queued requests and passes them
+    /// to the sender by batches. When the sender thread is not running
+    /// the request is built and sent at once.
+    ///
+    /// @param builder Function building the request. It must not throw
+    /// nor depend on objects changed after the call, e.g. a lease.
+    ///
+    /// @throw D2ClientError if the sender thread is not running and the
+    /// sender is null or not in send mode.
+    void sendDeferred(const NcrBuilder& builder);
+
     /// @brief Calls the client's error handler.
     ///
     /// Calls the error handler method set by startSender() when an
@@ -444,6 +506,24 @@ private:
 
     /// @brief Remembers the select-fd registered with IfaceMgr.
     int registered_select_fd_;
+
+    /// @brief Builds and sends the deferred requests.
+    ///
+    /// This method is exception safe.
+    void sendDeferredBatch();
+
+    /// @brief The thread processing the sender IO, null when the sender
+    /// IO is processed by the main loop.
+    asiolink::IoServiceThreadPoolPtr sender_thread_;
+
+    /// @brief Set when the requests are built by the sender thread.
+    bool defer_;
+
+    /// @brief Builders of the requests not yet built by the sender thread.
+    std::vector<NcrBuilder> deferred_;
+
+    /// @brief Mutex protecting the deferred builders.
+    std::mutex deferred_mutex_;
 };
 
 template <class T>
@@ -0,0 +1,140 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/decline_probation.h>
+#include <dhcpsrv/timer_mgr.h>
+#include <util/multi_threading_mgr.h>
+
+using namespace isc::asiolink;
+using namespace isc::util;
+using namespace std;
+
+namespace isc {
+namespace dhcp {
+
+void
+DeclineProbation::Table::expire(uint32_t address, time_t expire) {
+    MultiThreadingLock lock(mutex_);
+    auto entry = entries_.find(address);
+    // The address may have been declined again in the meantime.
+    if ((entry != entries_.end()) && (entry->second.expire_ == expire)) {
+        entry->second.timer_id_ = 0;
+        erase(entry);
+    }
+}
+
+void
+DeclineProbation::Table::erase(unordered_map<uint32_t, Entry>::iterator entry) {
+    if (entry->second.timer_id_ != 0) {
+        TimerWheelPtr wheel = wheel_.lock();
+        if (wheel) {
+            wheel->cancel(entry->second.timer_id_);
+        }
+    }
+    entries_.erase(entry);
+    size_ = entries_.size();
+}
+
+DeclineProbation::DeclineProbation() : table_(new Table()) {
+}
+
+DeclineProbation::~DeclineProbation() {
+    clear();
+}
+
+void
+DeclineProbation::add(const IOAddress& address, uint32_t period) {
+    uint32_t key = address.toUint32();
+    time_t expire = time(0) + period;
+
+    // The timer holds a weak pointer so it does not keep the table alive.
+    TimerWheelPtr wheel;
+    TimerWheel::TimerId timer_id = 0;
+    try {
+        wheel = TimerMgr::instance()->getTimerWheel();
+        boost::weak_ptr<Table> weak_table(table_);
+        timer_id = wheel->schedule(static_cast<long>(period) * 1000,
+                                   [weak_table, key, expire]() {
+            boost::shared_ptr<Table> table = weak_table.lock();
+            if (table) {
+                table->expire(key, expire);
+            }
+        });
+    } catch (...) {
+        // No timing wheel: the entry expires at the first lookup after
+        // the end of the probation period.
+        wheel.reset();
+    }
+
+    MultiThreadingLock lock(table_->mutex_);
+    auto entry = table_->entries_.find(key);
+    if (entry != table_->entries_.end()) {
+        table_->erase(entry);
+    }
+    if (wheel) {
+        table_->wheel_ = wheel;
+    }
+    table_->entries_[key] = Entry{expire, timer_id};
+    table_->size_ = table_->entries_.size();
+}
+
+bool
+DeclineProbation::isOnProbation(const IOAddress& address) {
+    if (table_->size_ == 0) {
+        return (false);
+    }
+    uint32_t key = address.toUint32();
+    MultiThreadingLock lock(table_->mutex_);
+    auto entry = table_->entries_.find(key);
+    if (entry == table_->entries_.end()) {
+        return (false);
+    }
+    if (entry->second.expire_ <= time(0)) {
+        table_->erase(entry);
+        return (false);
+    }
+    return (true);
+}
+
+bool
+DeclineProbation::remove(const IOAddress& address) {
+    if (table_->size_ == 0) {
+        return (false);
+    }
+    uint32_t key = address.toUint32();
+    MultiThreadingLock lock(table_->mutex_);
+    auto entry = table_->entries_.find(key);
+    if (entry == table_->entries_.end()) {
+        return (false);
+    }
+    table_->erase(entry);
+    return (true);
+}
+
+void
+DeclineProbation::clear() {
+    MultiThreadingLock lock(table_->mutex_);
+    TimerWheelPtr wheel = table_->wheel_.lock();
+    if (wheel) {
+        for (auto const& entry : table_->entries_) {
+            if (entry.second.timer_id_ != 0) {
+                wheel->cancel(entry.second.timer_id_);
+            }
+        }
+    }
+    table_->entries_.clear();
+    table_->size_ = 0;
+}
+
+size_t
+DeclineProbation::size() const {
+    return (table_->size_);
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
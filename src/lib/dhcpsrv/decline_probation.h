@@ -0,0 +1,123 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef DECLINE_PROBATION_H
+#define DECLINE_PROBATION_H
+
+#include <asiolink/io_address.h>
+#include <asiolink/timer_wheel.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <atomic>
+#include <ctime>
+#include <mutex>
+#include <unordered_map>
+
+#include <stdint.h>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief In-memory table of the IPv4 addresses on decline probation.
+///
+/// A declined lease is written to the lease database which remains the
+/// reference: the table only remembers the addresses declined by this
+/// server until the end of their probation period, so a repeated
+/// DHCPDECLINE for such an address and the allocation candidates on
+/// probation are rejected without a lease database lookup.
+///
+/// The entries are removed by timers of the server timing wheel when
+/// their probation period ends, or at the first lookup after the end
+/// when the timing wheel is not available. The table is thread safe.
+class DeclineProbation : public boost::noncopyable {
+public:
+
+    /// @brief Constructor.
+    DeclineProbation();
+
+    /// @brief Destructor.
+    ///
+    /// Cancels the expiration timers.
+    ~DeclineProbation();
+
+    /// @brief Puts an address on probation.
+    ///
+    /// @param address the declined address.
+    /// @param period the probation period in seconds.
+    void add(const asiolink::IOAddress& address, uint32_t period);
+
+    /// @brief Checks if an address is on probation.
+    ///
+    /// @param address the address.
+    /// @return true if the address was declined and its probation period
+    /// has not ended yet.
+    bool isOnProbation(const asiolink::IOAddress& address);
+
+    /// @brief Removes an address, e.g. when its declined lease is reclaimed.
+    ///
+    /// @param address the address.
+    /// @return true if the address was on probation.
+    bool remove(const asiolink::IOAddress& address);
+
+    /// @brief Removes all the addresses.
+    void clear();
+
+    /// @brief Returns the number of addresses in the table.
+    size_t size() const;
+
+private:
+
+    /// @brief An address on probation.
+    struct Entry {
+        /// @brief The end of the probation period.
+        time_t expire_;
+
+        /// @brief The expiration timer, 0 when none.
+        asiolink::TimerWheel::TimerId timer_id_;
+    };
+
+    /// @brief The table shared with the expiration timers.
+    struct Table {
+        /// @brief Constructor.
+        Table() : entries_(), size_(0), wheel_(), mutex_() {
+        }
+
+        /// @brief Removes an entry when its timer expires.
+        ///
+        /// @param address the address.
+        /// @param expire the end of the probation period of the entry.
+        void expire(uint32_t address, time_t expire);
+
+        /// @brief Removes an entry.
+        ///
+        /// Must be called with the mutex held.
+        ///
+        /// @param entry the entry.
+        void erase(std::unordered_map<uint32_t, Entry>::iterator entry);
+
+        /// @brief The entries by address.
+        std::unordered_map<uint32_t, Entry> entries_;
+
+        /// @brief Number of entries, read without the mutex.
+        std::atomic<size_t> size_;
+
+        /// @brief The timing wheel running the expiration timers.
+        boost::weak_ptr<asiolink::TimerWheel> wheel_;
+
+        /// @brief The mutex protecting the entries.
+        std::mutex mutex_;
+    };
+
+    /// @brief The table.
+    boost::shared_ptr<Table> table_;
+};
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // DECLINE_PROBATION_H
@@ -6,22 +6,17 @@
 
 #include <config.h>
 
-#include <dhcp/dhcp6.h>
 #include <dhcp/iface_mgr.h>
-#include <dhcp/option6_addrlst.h>
-#include <dhcp/option_custom.h>
-#include <dhcp/option_int.h>
-#include <dhcp/option_string.h>
-#include <dhcp/option_vendor.h>
 #include <dhcpsrv/dhcp4o6_ipc.h>
 #include <dhcpsrv/dhcpsrv_log.h>
-
-#include <boost/pointer_cast.hpp>
+#include <util/io_utilities.h>
 
 #include <errno.h>
 #include <netinet/in.h>
 #include <fcntl.h>
 #include <string>
+#include <sys/uio.h>
+#include <vector>
 
 using namespace isc::asiolink;
 using namespace isc::util;
@@ -30,6 +25,14 @@ using namespace std;
 namespace isc {
 namespace dhcp {
 
+const uint32_t Dhcp4o6IpcBase::HEADER_MAGIC;
+const size_t Dhcp4o6IpcBase::IFACE_NAME_SIZE;
+const size_t Dhcp4o6IpcBase::HEADER_ADDR_OFFSET;
+const size_t Dhcp4o6IpcBase::HEADER_PORT_OFFSET;
+const size_t Dhcp4o6IpcBase::HEADER_IFACE_OFFSET;
+const size_t Dhcp4o6IpcBase::HEADER_SIZE;
+const size_t Dhcp4o6IpcBase::MAX_BATCH_SIZE;
+
 Dhcp4o6IpcBase::Dhcp4o6IpcBase() : port_(0), socket_fd_(-1) {}
 
 Dhcp4o6IpcBase::~Dhcp4o6IpcBase() {
@@ -128,98 +131,47 @@ Pkt6Ptr Dhcp4o6IpcBase::receive() {
     uint8_t buf[65536];
     ssize_t cc = recv(socket_fd_, buf, sizeof(buf), 0);
     if (cc < 0) {
-        isc_throw(Dhcp4o6IpcError, "Failed to receive on DHCP4o6 socket.");
-    }
-    Pkt6Ptr pkt = Pkt6Ptr(new Pkt6(buf, cc));
-    pkt->updateTimestamp();
-
-    // Get interface name and remote address
-    pkt->unpack();
-
-    // Vendor option is initially NULL. If we find the instance of the vendor
-    // option with the ISC enterprise id this pointer will point to it.
-    OptionVendorPtr option_vendor;
-
-    // Get all vendor option and look for the one with the ISC enterprise id.
-    OptionCollection vendor_options = pkt->getOptions(D6O_VENDOR_OPTS);
-    for (OptionCollection::const_iterator opt = vendor_options.begin();
-         opt != vendor_options.end(); ++opt) {
-        option_vendor = boost::dynamic_pointer_cast<OptionVendor>(opt->second);
-        if (option_vendor) {
-            if (option_vendor->getVendorId() == ENTERPRISE_ID_ISC) {
-                break;
-            }
-            option_vendor.reset();
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            // No more queued message.
+            return (Pkt6Ptr());
         }
+        isc_throw(Dhcp4o6IpcError, "Failed to receive on DHCP4o6 socket.");
     }
 
-    // Vendor option must exist.
-    if (!option_vendor) {
+    // The header must be complete.
+    if (static_cast<size_t>(cc) < HEADER_SIZE) {
         LOG_WARN(dhcpsrv_logger, DHCPSRV_DHCP4O6_RECEIVED_BAD_PACKET)
-            .arg("no ISC vendor option");
-        isc_throw(Dhcp4o6IpcError, "malformed packet (no ISC vendor option)");
+            .arg("truncated header");
+        isc_throw(Dhcp4o6IpcError, "malformed packet (truncated header)");
     }
-
-    // The option carrying interface name is required.
-    OptionStringPtr ifname = boost::dynamic_pointer_cast<
-        OptionString>(option_vendor->getOption(ISC_V6_4O6_INTERFACE));
-    if (!ifname) {
+    if (readUint32(buf, HEADER_SIZE) != HEADER_MAGIC) {
         LOG_WARN(dhcpsrv_logger, DHCPSRV_DHCP4O6_RECEIVED_BAD_PACKET)
-            .arg("no interface suboption");
-        isc_throw(Dhcp4o6IpcError,
-                  "malformed packet (interface suboption missing "
-                  "or has incorrect type)");
+            .arg("bad header magic");
+        isc_throw(Dhcp4o6IpcError, "malformed packet (bad header magic)");
     }
 
     // Check if this interface is present in the system.
-    IfacePtr iface = IfaceMgr::instance().getIface(ifname->getValue());
+    const char* name = reinterpret_cast<const char*>(buf + HEADER_IFACE_OFFSET);
+    string ifname(name, strnlen(name, IFACE_NAME_SIZE));
+    IfacePtr iface = IfaceMgr::instance().getIface(ifname);
     if (!iface) {
         LOG_WARN(dhcpsrv_logger, DHCPSRV_DHCP4O6_RECEIVED_BAD_PACKET)
-            .arg("can't get interface " + ifname->getValue());
-        isc_throw(Dhcp4o6IpcError,
-                  "malformed packet (unknown interface "
-                  + ifname->getValue() + ")");
-    }
-
-    // Get the option holding source IPv6 address.
-    OptionCustomPtr srcs = boost::dynamic_pointer_cast<
-        OptionCustom>(option_vendor->getOption(ISC_V6_4O6_SRC_ADDRESS));
-    if (!srcs) {
-        LOG_WARN(dhcpsrv_logger, DHCPSRV_DHCP4O6_RECEIVED_BAD_PACKET)
-            .arg("no source address suboption");
+            .arg("can't get interface " + ifname);
         isc_throw(Dhcp4o6IpcError,
-                  "malformed packet (source address suboption missing "
-                  "or has incorrect type)");
+                  "malformed packet (unknown interface " + ifname + ")");
     }
 
-    // Get the option holding source port.
-    OptionUint16Ptr sport = boost::dynamic_pointer_cast<
-        OptionUint16>(option_vendor->getOption(ISC_V6_4O6_SRC_PORT));
-    if (!sport) {
-        LOG_WARN(dhcpsrv_logger, DHCPSRV_DHCP4O6_RECEIVED_BAD_PACKET)
-            .arg("no source port suboption");
-        isc_throw(Dhcp4o6IpcError,
-                  "malformed packet (source port suboption missing "
-                  "or has incorrect type)");
-    }
+    Pkt6Ptr pkt = Pkt6Ptr(new Pkt6(buf + HEADER_SIZE, cc - HEADER_SIZE));
+    pkt->updateTimestamp();
+    pkt->unpack();
 
     // Update the packet.
-    pkt->setRemoteAddr(srcs->readAddress());
-    pkt->setRemotePort(sport->getValue());
+    pkt->setRemoteAddr(IOAddress::fromBytes(AF_INET6,
+                                            buf + HEADER_ADDR_OFFSET));
+    pkt->setRemotePort(readUint16(buf + HEADER_PORT_OFFSET, sizeof(uint16_t)));
     pkt->setIface(iface->getName());
     pkt->setIndex(iface->getIndex());
 
-    // Remove options that have been added by the IPC sender.
-    static_cast<void>(option_vendor->delOption(ISC_V6_4O6_INTERFACE));
-    static_cast<void>(option_vendor->delOption(ISC_V6_4O6_SRC_ADDRESS));
-    static_cast<void>(option_vendor->delOption(ISC_V6_4O6_SRC_PORT));
-
-    // If there are no more options, the IPC sender has probably created the
-    // vendor option, in which case we should remove it here.
-    if (option_vendor->getOptions().empty()) {
-        static_cast<void>(pkt->delOption(D6O_VENDOR_OPTS));
-    }
-
     return (pkt);
 }
 
@@ -237,51 +189,47 @@ void Dhcp4o6IpcBase::send(const Pkt6Ptr& pkt) {
                   " IPC socket is closed");
     }
 
-    // Check if vendor option exists.
-    // Vendor option is initially NULL. If we find the instance of the vendor
-    // option with the ISC enterprise id this pointer will point to it.
-    OptionVendorPtr option_vendor;
-
-    // Get all vendor option and look for the one with the ISC enterprise id.
-    OptionCollection vendor_options = pkt->getOptions(D6O_VENDOR_OPTS);
-    for (OptionCollection::const_iterator opt = vendor_options.begin();
-         opt != vendor_options.end(); ++opt) {
-        option_vendor = boost::dynamic_pointer_cast<OptionVendor>(opt->second);
-        if (option_vendor) {
-            if (option_vendor->getVendorId() == ENTERPRISE_ID_ISC) {
-                break;
-            }
-            option_vendor.reset();
-        }
-    }
-
-    // If vendor option doesn't exist or its enterprise id is not ISC's
-    // enterprise id, let's create it.
-    if (!option_vendor) {
-        option_vendor.reset(new OptionVendor(Option::V6, ENTERPRISE_ID_ISC));
-        pkt->addOption(option_vendor);
+    // Build the header.
+    const string& ifname = pkt->getIface();
+    if (ifname.size() >= IFACE_NAME_SIZE) {
+        isc_throw(Dhcp4o6IpcError, "unable to send DHCP4o6 message because"
+                  " the interface name '" << ifname << "' is too long");
     }
+    if (!pkt->getRemoteAddr().isV6()) {
+        isc_throw(Dhcp4o6IpcError, "unable to send DHCP4o6 message because"
+                  " the remote address " << pkt->getRemoteAddr()
+                  << " is not an IPv6 address");
+    }
+    uint8_t header[HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    writeUint32(HEADER_MAGIC, header, sizeof(header));
+    const vector<uint8_t>& addr = pkt->getRemoteAddr().toBytes();
+    memcpy(header + HEADER_ADDR_OFFSET, &addr[0], addr.size());
+    writeUint16(pkt->getRemotePort(), header + HEADER_PORT_OFFSET,
+                sizeof(uint16_t));
+    memcpy(header + HEADER_IFACE_OFFSET, ifname.c_str(), ifname.size());
 
-    // Push interface name and source address in it
-    option_vendor->addOption(OptionStringPtr(new OptionString(Option::V6,
-                                                              ISC_V6_4O6_INTERFACE,
-                                                              pkt->getIface())));
-    option_vendor->addOption(Option6AddrLstPtr(new Option6AddrLst(ISC_V6_4O6_SRC_ADDRESS,
-                                                                  pkt->getRemoteAddr())));
-    option_vendor->addOption(OptionUint16Ptr(new OptionUint16(Option::V6,
-                                                              ISC_V6_4O6_SRC_PORT,
-                                                              pkt->getRemotePort())));
     // Get packet content
     OutputBuffer& buf = pkt->getBuffer();
     buf.clear();
     pkt->pack();
 
-    // Try to send the message.
-   if (::send(socket_fd_, buf.getData(), buf.getLength(), 0) < 0) {
-       isc_throw(Dhcp4o6IpcError,
-                 "failed to send DHCP4o6 message over the IPC: "
-                 << strerror(errno));
-   }
+    // Try to send the message: the header and the content are gathered
+    // in the datagram without a copy.
+    struct iovec iov[2];
+    iov[0].iov_base = header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = const_cast<void*>(buf.getData());
+    iov[1].iov_len = buf.getLength();
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+    if (::sendmsg(socket_fd_, &msg, 0) < 0) {
+        isc_throw(Dhcp4o6IpcError,
+                  "failed to send DHCP4o6 message over the IPC: "
+                  << strerror(errno));
+    }
 }
 
 }  // namespace dhcp
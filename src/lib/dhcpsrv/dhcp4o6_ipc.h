@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -53,11 +53,18 @@ public:
 /// requires information about the interface and the source address of
 /// the original DHCPv4 query message sent by the client. This
 /// information is known by the DHCPv6 server and needs to be conveyed
-/// to the DHCPv4 server. The IPC conveys it in the
-/// @c ISC_V6_4O6_INTERFACE, @c ISC_V6_4O6_SRC_ADDRESS and @c
-/// ISC_V6_4O6_SRC_PORT options within the Vendor Specific Information
-/// option, with ISC enterprise id. These options are added by the IPC
-/// sender and removed by the IPC receiver.
+/// to the DHCPv4 server. The IPC conveys it in a fixed size binary
+/// header preceding the DHCPv6 message in the datagram, so neither side
+/// has to build or search options to get it:
+///
+/// - a 32 bit magic number (@c HEADER_MAGIC) in network byte order,
+/// - the 16 bytes of the remote IPv6 address,
+/// - the remote port in network byte order,
+/// - the interface name padded with zeros to @c IFACE_NAME_SIZE bytes.
+///
+/// The receiver processes the messages already queued on the socket at
+/// once, up to @c MAX_BATCH_SIZE messages each time the socket becomes
+/// readable.
 class Dhcp4o6IpcBase : public boost::noncopyable {
 public:
 
@@ -67,6 +74,28 @@ public:
         ENDPOINT_TYPE_V6 = 6
     };
 
+    /// @brief Magic number starting the header ("K4o6").
+    static const uint32_t HEADER_MAGIC = 0x4b346f36;
+
+    /// @brief Size of the interface name field of the header.
+    static const size_t IFACE_NAME_SIZE = 16;
+
+    /// @brief Offset of the remote address in the header.
+    static const size_t HEADER_ADDR_OFFSET = 4;
+
+    /// @brief Offset of the remote port in the header.
+    static const size_t HEADER_PORT_OFFSET = HEADER_ADDR_OFFSET + 16;
+
+    /// @brief Offset of the interface name in the header.
+    static const size_t HEADER_IFACE_OFFSET = HEADER_PORT_OFFSET + 2;
+
+    /// @brief Size of the header.
+    static const size_t HEADER_SIZE = HEADER_IFACE_OFFSET + IFACE_NAME_SIZE;
+
+    /// @brief Maximum number of messages processed each time the socket
+    /// becomes readable.
+    static const size_t MAX_BATCH_SIZE = 32;
+
 protected:
     /// @brief Constructor
     ///
@@ -98,18 +127,17 @@ public:
     /// @brief Receive message over IPC.
     ///
     /// @return a pointer to a DHCPv6 message with interface and remote
-    /// address set from the IPC message
+    /// address set from the IPC message header or null when no message
+    /// is queued on the socket
     /// @throw isc::dhcp::Dhcp4o6IpcError on system call error or
     /// malformed packets.
     Pkt6Ptr receive();
 
     /// @brief Send message over IPC.
     ///
-    /// The IPC uses @c ISC_V6_4O6_INTERFACE, @c ISC_V6_4O6_SRC_ADDRESS
-    /// and @c ISC_V6_4O6_SRC_PORT options conveyed within the Vendor
-    /// Specific Information option, with ISC enterprise id, to communicate
-    /// the client remote address and the interface on which the DHCPv4 query
-    /// was received. These options will be removed by the receiver.
+    /// The IPC prepends to the message a header carrying the client
+    /// remote address and port and the interface on which the DHCPv4
+    /// query was received. The message itself is not modified.
     ///
     /// @param pkt Pointer to a DHCPv6 message with interface and remote
     /// address.
@@ -10,6 +10,59 @@
 
 using namespace isc::asiolink;
 
+namespace {
+
+/// @brief Buckets of the hash indexes never considered fragmented.
+const size_t MIN_FRAGMENTED_BUCKETS = 1024;
+
+/// @brief Returns an estimate of the memory used by a queue.
+///
+/// @param queue the queue.
+/// @tparam QueueType type of the queue.
+template<typename QueueType>
+size_t
+queueMemoryUsage(const QueueType& queue) {
+    return (queue.size() * sizeof(typename QueueType::node_type) +
+            queue.template get<1>().bucket_count() * sizeof(void*));
+}
+
+/// @brief Returns the fragmentation of a queue.
+///
+/// @param queue the queue.
+/// @tparam QueueType type of the queue.
+template<typename QueueType>
+double
+queueFragmentation(const QueueType& queue) {
+    auto const& idx = queue.template get<1>();
+    size_t buckets = idx.bucket_count();
+    if (buckets <= MIN_FRAGMENTED_BUCKETS) {
+        return (0.);
+    }
+    double needed = 1. + queue.size() / idx.max_load_factor();
+    if (needed >= buckets) {
+        return (0.);
+    }
+    return (1. - needed / buckets);
+}
+
+/// @brief Rebuilds a queue.
+///
+/// @param queue the queue.
+/// @tparam QueueType type of the queue.
+/// @return the estimated number of released bytes.
+template<typename QueueType>
+size_t
+compactQueue(QueueType& queue) {
+    size_t before = queueMemoryUsage(queue);
+    // The hash index never shrinks: rebuild the queue in the same order.
+    QueueType compacted(queue.begin(), queue.end());
+    queue.swap(compacted);
+    size_t after = queueMemoryUsage(queue);
+    return (before > after ? before - after : 0);
+}
+
+}
+
 namespace isc {
 namespace dhcp {
 
@@ -19,11 +72,12 @@ PoolFreeLeaseQueueAllocationState::create(const PoolPtr& pool) {
 }
 
 PoolFreeLeaseQueueAllocationState::PoolFreeLeaseQueueAllocationState(Lease::Type type)
-    : AllocationState(), free_lease4_queue_(), free_lease6_queue_() {
+    : AllocationState(), free_lease4_queue_(), free_lease6_queue_(),
+      populated_(false) {
     if (type == Lease::TYPE_V4) {
         free_lease4_queue_ = boost::make_shared<FreeLeaseQueue<uint32_t>>();
     } else {
-        free_lease6_queue_ = boost::make_shared<FreeLeaseQueue<IOAddress>>();
+        free_lease6_queue_ = boost::make_shared<FreeLeaseQueue<CompactAddress>>();
     }
 }
 
@@ -38,7 +92,7 @@ PoolFreeLeaseQueueAllocationState::addFreeLease(const asiolink::IOAddress& addre
     if (free_lease4_queue_) {
         free_lease4_queue_->push_back(address.toUint32());
     } else {
-        free_lease6_queue_->push_back(address);
+        free_lease6_queue_->push_back(CompactAddress(address));
     }
 }
 
@@ -49,7 +103,7 @@ PoolFreeLeaseQueueAllocationState::deleteFreeLease(const asiolink::IOAddress& ad
         idx.erase(address.toUint32());
     } else {
         auto& idx = free_lease6_queue_->get<1>();
-        idx.erase(address);
+        idx.erase(CompactAddress(address));
     }
 }
 
@@ -68,10 +122,10 @@ PoolFreeLeaseQueueAllocationState::offerFreeLease() {
     if (free_lease6_queue_->empty()) {
         return (IOAddress::IPV6_ZERO_ADDRESS());
     }
-    IOAddress lease = free_lease6_queue_->front();
+    CompactAddress lease = free_lease6_queue_->front();
     free_lease6_queue_->pop_front();
     free_lease6_queue_->push_back(lease);
-    return (lease);
+    return (lease.toIOAddress());
 }
 
 size_t
@@ -82,6 +136,30 @@ PoolFreeLeaseQueueAllocationState::getFreeLeaseCount() const {
     return (free_lease6_queue_->size());
 }
 
+size_t
+PoolFreeLeaseQueueAllocationState::getMemoryUsage() const {
+    if (free_lease4_queue_) {
+        return (queueMemoryUsage(*free_lease4_queue_));
+    }
+    return (queueMemoryUsage(*free_lease6_queue_));
+}
+
+double
+PoolFreeLeaseQueueAllocationState::getFragmentation() const {
+    if (free_lease4_queue_) {
+        return (queueFragmentation(*free_lease4_queue_));
+    }
+    return (queueFragmentation(*free_lease6_queue_));
+}
+
+size_t
+PoolFreeLeaseQueueAllocationState::compact() {
+    if (free_lease4_queue_) {
+        return (compactQueue(*free_lease4_queue_));
+    }
+    return (compactQueue(*free_lease6_queue_));
+}
+
 } // end of namespace isc::dhcp
 } // end of namespace isc
 
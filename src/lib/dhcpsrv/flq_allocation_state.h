@@ -7,6 +7,7 @@
 #ifndef FLQ_ALLOCATION_STATE_H
 #define FLQ_ALLOCATION_STATE_H
 
+#include <asiolink/compact_address.h>
 #include <dhcpsrv/allocation_state.h>
 #include <dhcpsrv/pool.h>
 #include <dhcpsrv/subnet.h>
@@ -66,15 +67,54 @@ public:
     /// @return the number of free leases in the queue.
     size_t getFreeLeaseCount() const;
 
+    /// @brief Returns an estimate of the memory used by the queue.
+    ///
+    /// @return the size of the queue nodes and of the hash index buckets
+    /// in bytes.
+    size_t getMemoryUsage() const;
+
+    /// @brief Returns the fragmentation of the queue.
+    ///
+    /// The hash index of the queue never releases its buckets when the
+    /// number of free leases decreases, e.g. after the pool was filled.
+    /// The fragmentation is the fraction of the buckets which are not
+    /// needed for the current number of free leases. The small indexes
+    /// are not considered fragmented.
+    ///
+    /// @return the fragmentation between 0 and 1.
+    double getFragmentation() const;
+
+    /// @brief Rebuilds the queue for the current number of free leases.
+    ///
+    /// The order of the free leases is not changed. The queue is copied
+    /// so the compaction takes a time proportional to the number of free
+    /// leases.
+    ///
+    /// @return the estimated number of released bytes.
+    size_t compact();
+
+    /// @brief Checks if the queue was populated from the lease database.
+    ///
+    /// @return true if the queue was populated.
+    bool isPopulated() const {
+        return (populated_);
+    }
+
+    /// @brief Marks the queue as populated from the lease database.
+    void setPopulated() {
+        populated_ = true;
+    }
+
 private:
 
     /// @brief A multi-index container holding free leases.
     ///
     /// When it is used as a storage for IPv4 leases, the @c AddressType
-    /// should be @c uint32_t. For IPv6 leases, it should be @c IOAddress.
-    /// Note that using the @c uint32_t for the IPv4 case significantly reduces
-    /// the amount of memory occupied by the container by removing the overhead
-    /// of holding the entire IOAddress instance.
+    /// should be @c uint32_t. For IPv6 leases, it should be @c CompactAddress.
+    /// Note that using the @c uint32_t for the IPv4 case and the
+    /// @c CompactAddress for the IPv6 case significantly reduces the amount
+    /// of memory occupied by the container by removing the overhead of
+    /// holding the entire IOAddress instance.
     template<typename AddressType>
     using FreeLeaseQueue = boost::multi_index_container<
         AddressType,
@@ -90,7 +130,7 @@ private:
     typedef boost::shared_ptr<FreeLeaseQueue<uint32_t>> FreeLease4QueuePtr;
 
     /// @brief A multi-index container holding free IPv6 leases.
-    typedef boost::shared_ptr<FreeLeaseQueue<asiolink::IOAddress>> FreeLease6QueuePtr;
+    typedef boost::shared_ptr<FreeLeaseQueue<asiolink::CompactAddress>> FreeLease6QueuePtr;
 
     /// @brief An instance of the multi-index container holding
     /// free IPv4 leases.
@@ -99,6 +139,12 @@ private:
     /// @brief An instance of the multi-index container holding
     /// free IPv6 leases.
     FreeLease6QueuePtr free_lease6_queue_;
+
+    /// @brief Flag indicating if the queue was populated.
+    ///
+    /// A populated queue taken over by a new subnet instance after a
+    /// reconfiguration is not populated again.
+    bool populated_;
 };
 
 
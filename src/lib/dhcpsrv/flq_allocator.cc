@@ -11,9 +11,17 @@
 #include <dhcpsrv/flq_allocator.h>
 #include <dhcpsrv/ip_range_permutation.h>
 #include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/memfile_lease_mgr.h>
 #include <dhcpsrv/subnet.h>
 #include <util/stopwatch.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
 using namespace isc::asiolink;
 using namespace isc::util;
@@ -92,8 +100,13 @@ FreeLeaseQueueAllocator::pickPrefixInternal(const ClientClasses& client_classes,
         return (IOAddress::IPV6_ZERO_ADDRESS());
     }
     // Let's first iterate over the pools and identify the ones that
-    // meet client class criteria and are not exhausted.
+    // meet client class criteria and are not exhausted. When the client
+    // hints a prefix length and accepts shorter or longer prefixes, only
+    // keep the pools with the delegated length closest to the hint, so
+    // the client does not get a much larger or smaller prefix than it
+    // asked for while a better fitting pool has free prefixes.
     std::vector<uint64_t> available;
+    uint8_t best_length = 0;
     for (auto i = 0; i < pools.size(); ++i) {
         // Check if the pool is allowed for the client's classes.
         if (pools[i]->clientSupported(client_classes)) {
@@ -103,10 +116,23 @@ FreeLeaseQueueAllocator::pickPrefixInternal(const ClientClasses& client_classes,
             }
             // Get or create the pool state.
             auto pool_state = getPoolState(pools[i]);
-            if (!pool_state->exhausted()) {
-                // There are still available prefixes in this pool.
-                available.push_back(i);
+            if (pool_state->exhausted()) {
+                continue;
+            }
+            // There are still available prefixes in this pool.
+            if (hint_prefix_length && (prefix_length_match != PREFIX_LEN_EQUAL)) {
+                auto length = boost::dynamic_pointer_cast<Pool6>(pools[i])->getLength();
+                if (!available.empty() && (length != best_length)) {
+                    bool better = (prefix_length_match == PREFIX_LEN_LOWER ?
+                                   length > best_length : length < best_length);
+                    if (!better) {
+                        continue;
+                    }
+                    available.clear();
+                }
+                best_length = length;
             }
+            available.push_back(i);
         }
     }
     if (available.empty()) {
@@ -134,6 +160,41 @@ FreeLeaseQueueAllocator::pickPrefixInternal(const ClientClasses& client_classes,
     return (IOAddress::IPV6_ZERO_ADDRESS());
 }
 
+uint64_t
+FreeLeaseQueueAllocator::getFreeLeaseCountInternal(const ClientClasses& client_classes) const {
+    auto subnet = subnet_.lock();
+    if (!subnet) {
+        return (0);
+    }
+    uint64_t free_lease_count = 0;
+    for (auto const& pool : subnet->getPools(pool_type_)) {
+        if (pool->clientSupported(client_classes)) {
+            free_lease_count += getPoolState(pool)->getFreeLeaseCount();
+        }
+    }
+    return (free_lease_count);
+}
+
+size_t
+FreeLeaseQueueAllocator::getMemoryUsageInternal(const PoolPtr& pool) const {
+    auto pool_state = boost::dynamic_pointer_cast<PoolFreeLeaseQueueAllocationState>
+        (pool->getAllocationState());
+    if (!pool_state) {
+        return (0);
+    }
+    return (pool_state->getMemoryUsage());
+}
+
+size_t
+FreeLeaseQueueAllocator::compactInternal(const PoolPtr& pool, double threshold) {
+    auto pool_state = boost::dynamic_pointer_cast<PoolFreeLeaseQueueAllocationState>
+        (pool->getAllocationState());
+    if (!pool_state || (pool_state->getFragmentation() <= threshold)) {
+        return (0);
+    }
+    return (pool_state->compact());
+}
+
 void
 FreeLeaseQueueAllocator::initAfterConfigureInternal() {
     auto subnet = subnet_.lock();
@@ -142,28 +203,50 @@ FreeLeaseQueueAllocator::initAfterConfigureInternal() {
         // If there are no pools there is nothing to do.
         return;
     }
-    Lease4Collection leases4;
-    Lease6Collection leases6;
-    switch (pool_type_) {
-    case Lease::TYPE_V4:
-        leases4 = LeaseMgrFactory::instance().getLeases4(subnet->getID());
-        populateFreeAddressLeases(leases4, pools);
-        break;
-    case Lease::TYPE_NA:
-    case Lease::TYPE_TA:
-        leases6 = LeaseMgrFactory::instance().getLeases6(subnet->getID());
-        populateFreeAddressLeases(leases6, pools);
-        break;
-    case Lease::TYPE_PD:
-        leases6 = LeaseMgrFactory::instance().getLeases6(subnet->getID());
-        populateFreePrefixDelegationLeases(leases6, pools);
-        break;
-    default:
-        ;
+    // The queues taken over from the previous instance of the subnet
+    // are up to date.
+    PoolCollection unpopulated;
+    for (auto const& pool : pools) {
+        if (!getPoolState(pool)->isPopulated()) {
+            unpopulated.push_back(pool);
+        }
+    }
+    auto& lease_mgr = LeaseMgrFactory::instance();
+    if (!unpopulated.empty()) {
+        // Collect the leased addresses or prefixes. The memfile backend
+        // scans its lease storage in place instead of copying the leases,
+        // e.g. the leases restored from the lease snapshot at startup.
+        LeasedAddresses leased;
+        auto memfile = dynamic_cast<const Memfile_LeaseMgr*>(&lease_mgr);
+        switch (pool_type_) {
+        case Lease::TYPE_V4:
+            if (memfile) {
+                memfile->getLeasedAddresses(subnet->getID(), pool_type_, leased);
+            } else {
+                collectLeased(lease_mgr.getLeases4(subnet->getID()), leased);
+            }
+            populateFreeAddressLeases(leased, unpopulated);
+            break;
+        case Lease::TYPE_NA:
+        case Lease::TYPE_TA:
+        case Lease::TYPE_PD:
+            if (memfile) {
+                memfile->getLeasedAddresses(subnet->getID(), pool_type_, leased);
+            } else {
+                collectLeased(lease_mgr.getLeases6(subnet->getID()), leased);
+            }
+            if (pool_type_ == Lease::TYPE_PD) {
+                populateFreePrefixDelegationLeases(leased, unpopulated);
+            } else {
+                populateFreeAddressLeases(leased, unpopulated);
+            }
+            break;
+        default:
+            ;
+        }
     }
     // Install the callbacks for lease add, update and delete in the interface manager.
     // These callbacks will ensure that we have up-to-date free lease queue.
-    auto& lease_mgr = LeaseMgrFactory::instance();
     lease_mgr.registerCallback(TrackingLeaseMgr::TRACK_ADD_LEASE, FLQ_OWNER, subnet->getID(), pool_type_,
                                std::bind(&FreeLeaseQueueAllocator::addLeaseCallback, this,
                                          std::placeholders::_1,
@@ -180,25 +263,28 @@ FreeLeaseQueueAllocator::initAfterConfigureInternal() {
 
 template<typename LeaseCollectionType>
 void
-FreeLeaseQueueAllocator::populateFreeAddressLeases(const LeaseCollectionType& leases, const PoolCollection& pools) {
+FreeLeaseQueueAllocator::collectLeased(const LeaseCollectionType& leases,
+                                       LeasedAddresses& leased) const {
+    // Eliminate the leases of other types, the expired leases and those
+    // in the expired-reclaimed state.
+    for (auto const& lease : leases) {
+        if ((lease->getType() == pool_type_) && (!lease->expired()) && (!lease->stateExpiredReclaimed())) {
+            leased.insert(lease->addr_);
+        }
+    }
+}
+
+void
+FreeLeaseQueueAllocator::populateFreeAddressLeases(const LeasedAddresses& leased_addresses,
+                                                   const PoolCollection& pools) {
     auto subnet = subnet_.lock();
     LOG_INFO(dhcpsrv_logger, DHCPSRV_CFGMGR_FLQ_POPULATE_FREE_ADDRESS_LEASES)
         .arg(subnet->toText());
 
     Stopwatch stopwatch;
 
-    // Let's iterate over the lease queue and index them with the
-    // unordered_set. Also, elminate the expired leases and those
-    // in the expired-reclaimed state.
-    unordered_set<IOAddress, IOAddress::Hash> leased_addresses;
-    for (auto lease : leases) {
-        if ((lease->getType() == pool_type_) && (!lease->expired()) && (!lease->stateExpiredReclaimed())) {
-            leased_addresses.insert(lease->addr_);
-        }
-    }
     // For each pool, check if the address is in the leases list.
-    size_t free_lease_count = 0;
-    for (auto pool : pools) {
+    populatePools(pools, [this, &leased_addresses](const PoolPtr& pool) {
         // Create the pool permutation so the resulting lease queue is no
         // particular order.
         IPRangePermutation perm(AddressRange(pool->getFirstAddress(), pool->getLastAddress()));
@@ -214,7 +300,10 @@ FreeLeaseQueueAllocator::populateFreeAddressLeases(const LeaseCollectionType& le
                 pool_state->addFreeLease(address);
             }
         }
-        free_lease_count += pool_state->getFreeLeaseCount();
+    });
+    size_t free_lease_count = 0;
+    for (auto const& pool : pools) {
+        free_lease_count += getPoolState(pool)->getFreeLeaseCount();
     }
 
     stopwatch.stop();
@@ -226,28 +315,19 @@ FreeLeaseQueueAllocator::populateFreeAddressLeases(const LeaseCollectionType& le
 }
 
 void
-FreeLeaseQueueAllocator::populateFreePrefixDelegationLeases(const Lease6Collection& leases, const PoolCollection& pools) {
+FreeLeaseQueueAllocator::populateFreePrefixDelegationLeases(const LeasedAddresses& leased_prefixes,
+                                                            const PoolCollection& pools) {
     auto subnet = subnet_.lock();
     LOG_INFO(dhcpsrv_logger, DHCPSRV_CFGMGR_FLQ_POPULATE_FREE_PREFIX_LEASES)
         .arg(subnet->toText());
 
     Stopwatch stopwatch;
 
-    // Let's iterate over the lease queue and index them with the
-    // unordered_set. Also, elminate the expired leases and those
-    // in the expired-reclaimed state.
-    unordered_set<IOAddress, IOAddress::Hash> leased_prefixes;
-    for (auto lease : leases) {
-        if ((lease->getType() == Lease::TYPE_PD) && (!lease->expired()) && (!lease->stateExpiredReclaimed())) {
-            leased_prefixes.insert(lease->addr_);
-        }
-    }
     // For each pool, check if the prefix is in the leases list.
-    size_t free_lease_count = 0;
-    for (auto pool : pools) {
+    populatePools(pools, [this, &leased_prefixes](const PoolPtr& pool) {
         auto pool6 = boost::dynamic_pointer_cast<Pool6>(pool);
         if (!pool6) {
-            continue;
+            return;
         }
         // Create the pool permutation so the resulting lease queue is no
         // particular order.
@@ -264,7 +344,10 @@ FreeLeaseQueueAllocator::populateFreePrefixDelegationLeases(const Lease6Collecti
                 pool_state->addFreeLease(prefix);
             }
         }
-        free_lease_count += pool_state->getFreeLeaseCount();
+    });
+    size_t free_lease_count = 0;
+    for (auto const& pool : pools) {
+        free_lease_count += getPoolState(pool)->getFreeLeaseCount();
     }
 
     stopwatch.stop();
@@ -275,6 +358,52 @@ FreeLeaseQueueAllocator::populateFreePrefixDelegationLeases(const Lease6Collecti
         .arg(stopwatch.logFormatLastDuration());
 }
 
+void
+FreeLeaseQueueAllocator::populatePools(const PoolCollection& pools,
+                                       const function<void(const PoolPtr&)>& populate) {
+    // Create the pool states before the worker threads are started.
+    for (auto const& pool : pools) {
+        getPoolState(pool)->setPopulated();
+    }
+    size_t threads = min(static_cast<size_t>(max(thread::hardware_concurrency(), 1U)),
+                         pools.size());
+    if (threads <= 1) {
+        for (auto const& pool : pools) {
+            populate(pool);
+        }
+        return;
+    }
+
+    // Each pool has its own queue so the pools are populated in parallel,
+    // the set of the leased addresses being only read.
+    atomic<size_t> next(0);
+    exception_ptr error;
+    mutex error_mutex;
+    auto worker = [&pools, &populate, &next, &error, &error_mutex]() {
+        for (size_t i = next++; i < pools.size(); i = next++) {
+            try {
+                populate(pools[i]);
+            } catch (...) {
+                lock_guard<mutex> lock(error_mutex);
+                if (!error) {
+                    error = current_exception();
+                }
+            }
+        }
+    };
+    vector<thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.push_back(thread(worker));
+    }
+    worker();
+    for (auto& t : workers) {
+        t.join();
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
 PoolFreeLeaseQueueAllocationStatePtr
 FreeLeaseQueueAllocator::getPoolState(const PoolPtr& pool) const {
     if (!pool->getAllocationState()) {
@@ -11,6 +11,8 @@
 #include <dhcpsrv/flq_allocation_state.h>
 #include <dhcpsrv/lease.h>
 #include <cstdint>
+#include <functional>
+#include <unordered_set>
 
 namespace isc {
 namespace dhcp {
@@ -51,36 +53,71 @@ public:
         return ("flq");
     }
 
+    /// @brief Checks if the allocation states can be reused.
+    ///
+    /// The free lease queues are kept up to date by the callbacks so they
+    /// can be reused when the lease database did not change. The reused
+    /// queues are not populated again by @c initAfterConfigure.
+    ///
+    /// @param same_leases true when the lease database is the same as in
+    /// the previous configuration.
+    /// @return true when the lease database is the same.
+    virtual bool canReuseStates(bool same_leases) const {
+        return (same_leases);
+    }
+
 private:
 
+    /// @brief Type of the set of the leased addresses or prefixes.
+    typedef std::unordered_set<asiolink::IOAddress, asiolink::IOAddress::Hash> LeasedAddresses;
+
     /// @brief Performs allocator initialization after server's reconfiguration.
     ///
     /// The allocator installs the callbacks in the lease manager to keep track of
     /// the lease allocations and maintain the free leases queue.
     virtual void initAfterConfigureInternal();
 
-    /// @brief Populates the queue of free addresses (IPv4 and IPv6).
+    /// @brief Collects the leased addresses or prefixes of a lease collection.
     ///
-    /// It adds each address in the subnet pools that does not exist in the
-    /// list of leases to the free leases queue. The addresses are added
-    /// in a random order.
+    /// The leases of other types, the expired and the reclaimed leases are
+    /// not collected.
     ///
-    /// @param lease collection of leases in the database for a subnet.
-    /// @param pools collection of pools in the subnet.
+    /// @param leases collection of leases in the database for a subnet.
+    /// @param [out] leased set of the leased addresses or prefixes.
     /// @tparam LeaseCollectionType Type of the lease collection returned from the
     /// database (i.e., @c Lease4Collection or @c Lease6Collection).
     template<typename LeaseCollectionType>
-    void populateFreeAddressLeases(const LeaseCollectionType& leases, const PoolCollection& pools);
+    void collectLeased(const LeaseCollectionType& leases, LeasedAddresses& leased) const;
+
+    /// @brief Populates the queue of free addresses (IPv4 and IPv6).
+    ///
+    /// It adds each address in the subnet pools that is not leased to
+    /// the free leases queue. The addresses are added in a random order.
+    ///
+    /// @param leased set of the leased addresses in the subnet.
+    /// @param pools collection of pools in the subnet.
+    void populateFreeAddressLeases(const LeasedAddresses& leased, const PoolCollection& pools);
 
     /// @brief Populates the queue of free delegated prefixes.
     ///
-    /// It adds each delegated prefix in the subnet pools that does not exist in the
-    /// list of leases to the free leases queue. The delegated prefixes are added
-    /// in a random order.
+    /// It adds each delegated prefix in the subnet pools that is not leased
+    /// to the free leases queue. The delegated prefixes are added in a random
+    /// order.
     ///
-    /// @param lease collection of delegated prefixes in the database for a subnet.
+    /// @param leased set of the delegated prefixes in the subnet.
     /// @param pools collection of prefix delegation pools in the subnet.
-    void populateFreePrefixDelegationLeases(const Lease6Collection& leases, const PoolCollection& pools);
+    void populateFreePrefixDelegationLeases(const LeasedAddresses& leased, const PoolCollection& pools);
+
+    /// @brief Populates the queues of pools.
+    ///
+    /// The pools are marked as populated and are populated in parallel
+    /// using up to one thread per pool and per hardware thread.
+    ///
+    /// @param pools collection of pools to populate.
+    /// @param populate function populating the queue of a pool.
+    /// @throw the first exception thrown by @c populate.
+    void populatePools(const PoolCollection& pools,
+                       const std::function<void(const PoolPtr&)>& populate);
 
     /// @brief Returns next available address from the queue.
     ///
@@ -99,6 +136,10 @@ private:
     ///
     /// Internal thread-unsafe implementation of the @c pickPrefix.
     ///
+    /// When the client hints a prefix length and lower or higher lengths
+    /// are accepted, the prefix is picked from the pools with the delegated
+    /// length closest to the hint which have free prefixes.
+    ///
     /// @param client_classes list of classes client belongs to.
     /// @param pool the selected pool satisfying all required conditions.
     /// @param duid Client's DUID.
@@ -118,6 +159,37 @@ private:
                        const isc::asiolink::IOAddress& hint,
                        uint8_t hint_prefix_length);
 
+    /// @brief Returns the number of free leases in the pools allowed for
+    /// the client classes.
+    ///
+    /// Internal thread-unsafe implementation of the @c getFreeLeaseCount.
+    ///
+    /// @param client_classes list of classes client belongs to.
+    ///
+    /// @return the sum of the free leases in the pool queues.
+    virtual uint64_t
+    getFreeLeaseCountInternal(const ClientClasses& client_classes) const;
+
+    /// @brief Returns an estimate of the memory used by the free lease
+    /// queue of a pool.
+    ///
+    /// Internal thread-unsafe implementation of the @c getMemoryUsage.
+    ///
+    /// @param pool pool of the subnet.
+    ///
+    /// @return the memory used by the queue in bytes.
+    virtual size_t getMemoryUsageInternal(const PoolPtr& pool) const;
+
+    /// @brief Rebuilds the free lease queue of a pool when it is fragmented.
+    ///
+    /// Internal thread-unsafe implementation of the @c compact for a pool.
+    ///
+    /// @param pool pool of the subnet.
+    /// @param threshold fragmentation above which the queue is rebuilt.
+    ///
+    /// @return the estimated number of released bytes.
+    virtual size_t compactInternal(const PoolPtr& pool, double threshold);
+
     /// @brief Convenience function returning pool allocation state instance.
     ///
     /// It creates a new pool state instance and assigns it to the pool
@@ -0,0 +1,178 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/cache_host_data_source.h>
+#include <dhcpsrv/global_host_replica.h>
+#include <dhcpsrv/subnet_id.h>
+#include <util/multi_threading_mgr.h>
+
+#include <boost/make_shared.hpp>
+
+using namespace isc::util;
+using namespace std;
+
+namespace isc {
+namespace dhcp {
+
+GlobalHostReplica::GlobalHostReplica() : mutex_(new mutex()) {
+}
+
+void
+GlobalHostReplica::load(const HostDataSourceList& sources) {
+    auto hosts = boost::make_shared<Hosts>();
+    const HostPageSize page_size(PAGE_SIZE);
+    for (auto const& source : sources) {
+        if (boost::dynamic_pointer_cast<CacheHostDataSource>(source)) {
+            continue;
+        }
+
+        // The source index is ignored by the backends.
+        size_t index = 0;
+        uint64_t lower_host_id = 0;
+        for (;;) {
+            ConstHostCollection page = source->getPage4(SUBNET_ID_GLOBAL, index,
+                                                        lower_host_id, page_size);
+            if (page.empty()) {
+                break;
+            }
+            for (auto const& host : page) {
+                hosts->hosts4_.emplace(makeKey(host), host);
+            }
+            lower_host_id = page.back()->getHostId();
+        }
+
+        lower_host_id = 0;
+        for (;;) {
+            ConstHostCollection page = source->getPage6(SUBNET_ID_GLOBAL, index,
+                                                        lower_host_id, page_size);
+            if (page.empty()) {
+                break;
+            }
+            for (auto const& host : page) {
+                hosts->hosts6_.emplace(makeKey(host), host);
+            }
+            lower_host_id = page.back()->getHostId();
+        }
+    }
+
+    MultiThreadingLock lock(*mutex_);
+    hosts_ = hosts;
+}
+
+bool
+GlobalHostReplica::isLoaded() const {
+    MultiThreadingLock lock(*mutex_);
+    return (static_cast<bool>(hosts_));
+}
+
+ConstHostPtr
+GlobalHostReplica::get4(const Host::IdentifierType& identifier_type,
+                        const uint8_t* identifier_begin,
+                        const size_t identifier_len) const {
+    string key = makeKey(identifier_type, identifier_begin, identifier_len);
+    MultiThreadingLock lock(*mutex_);
+    if (!hosts_) {
+        return (ConstHostPtr());
+    }
+    return (getInternal(hosts_->hosts4_, key));
+}
+
+ConstHostPtr
+GlobalHostReplica::get6(const Host::IdentifierType& identifier_type,
+                        const uint8_t* identifier_begin,
+                        const size_t identifier_len) const {
+    string key = makeKey(identifier_type, identifier_begin, identifier_len);
+    MultiThreadingLock lock(*mutex_);
+    if (!hosts_) {
+        return (ConstHostPtr());
+    }
+    return (getInternal(hosts_->hosts6_, key));
+}
+
+void
+GlobalHostReplica::add(const ConstHostPtr& host) {
+    if (!host) {
+        return;
+    }
+    string key = makeKey(host);
+    MultiThreadingLock lock(*mutex_);
+    if (!hosts_) {
+        return;
+    }
+    if (host->getIPv4SubnetID() == SUBNET_ID_GLOBAL) {
+        hosts_->hosts4_[key] = host;
+    }
+    if (host->getIPv6SubnetID() == SUBNET_ID_GLOBAL) {
+        hosts_->hosts6_[key] = host;
+    }
+}
+
+bool
+GlobalHostReplica::del4(const Host::IdentifierType& identifier_type,
+                        const uint8_t* identifier_begin,
+                        const size_t identifier_len) {
+    string key = makeKey(identifier_type, identifier_begin, identifier_len);
+    MultiThreadingLock lock(*mutex_);
+    return (hosts_ && (hosts_->hosts4_.erase(key) > 0));
+}
+
+bool
+GlobalHostReplica::del6(const Host::IdentifierType& identifier_type,
+                        const uint8_t* identifier_begin,
+                        const size_t identifier_len) {
+    string key = makeKey(identifier_type, identifier_begin, identifier_len);
+    MultiThreadingLock lock(*mutex_);
+    return (hosts_ && (hosts_->hosts6_.erase(key) > 0));
+}
+
+size_t
+GlobalHostReplica::size4() const {
+    MultiThreadingLock lock(*mutex_);
+    return (hosts_ ? hosts_->hosts4_.size() : 0);
+}
+
+size_t
+GlobalHostReplica::size6() const {
+    MultiThreadingLock lock(*mutex_);
+    return (hosts_ ? hosts_->hosts6_.size() : 0);
+}
+
+string
+GlobalHostReplica::makeKey(const Host::IdentifierType& identifier_type,
+                           const uint8_t* identifier_begin,
+                           const size_t identifier_len) {
+    string key;
+    key.reserve(identifier_len + 1);
+    key.push_back(static_cast<char>(identifier_type));
+    if (identifier_len > 0) {
+        key.append(reinterpret_cast<const char*>(identifier_begin),
+                   identifier_len);
+    }
+    return (key);
+}
+
+string
+GlobalHostReplica::makeKey(const ConstHostPtr& host) {
+    const vector<uint8_t>& identifier = host->getIdentifier();
+    return (makeKey(host->getIdentifierType(),
+                    identifier.empty() ? 0 : &identifier[0],
+                    identifier.size()));
+}
+
+ConstHostPtr
+GlobalHostReplica::getInternal(const HostMap& hosts,
+                               const string& key) const {
+    auto it = hosts.find(key);
+    if (it == hosts.end()) {
+        return (ConstHostPtr());
+    }
+    return (it->second);
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
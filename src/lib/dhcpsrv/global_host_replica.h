@@ -0,0 +1,170 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef GLOBAL_HOST_REPLICA_H
+#define GLOBAL_HOST_REPLICA_H
+
+#include <dhcpsrv/base_host_data_source.h>
+#include <dhcpsrv/host.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief In-memory replica of the global host reservations.
+///
+/// When global reservations are enabled the servers look for a global
+/// reservation of each client in addition to the subnet level lookups,
+/// so a SQL host backend is queried at least once more per packet. The
+/// global reservations are usually few, so they can be kept in memory:
+/// the replica loads all of them from the host backends and answers the
+/// lookups of the global reservations by identifier with a hash table,
+/// including the negative answers.
+///
+/// The replica is filled by @c load, which fetches the global
+/// reservations page by page and replaces the content at once, so the
+/// lookups are never blocked by the reload. The host manager updates it
+/// when reservations are added or deleted through it and reloads it
+/// periodically to see the changes made in the database by others.
+///
+/// The replica is thread safe.
+class GlobalHostReplica : public boost::noncopyable {
+public:
+
+    /// @brief Number of reservations fetched by query during a load.
+    static const size_t PAGE_SIZE = 1024;
+
+    /// @brief Constructor.
+    GlobalHostReplica();
+
+    /// @brief Loads the global reservations.
+    ///
+    /// The cache host backends are skipped. When several backends hold
+    /// a reservation for the same identifier the first one wins, as for
+    /// the lookups by the host manager.
+    ///
+    /// @param sources the host backends.
+    /// @throw any exception thrown by the backends, in which case the
+    /// content of the replica is left unchanged.
+    void load(const HostDataSourceList& sources);
+
+    /// @brief Checks if the replica was loaded.
+    ///
+    /// @return true when the replica can answer the lookups.
+    bool isLoaded() const;
+
+    /// @brief Returns the global host with IPv4 reservations.
+    ///
+    /// @param identifier_type identifier type.
+    /// @param identifier_begin pointer to the identifier.
+    /// @param identifier_len identifier length.
+    /// @return the host or null.
+    ConstHostPtr get4(const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len) const;
+
+    /// @brief Returns the global host with IPv6 reservations.
+    ///
+    /// @param identifier_type identifier type.
+    /// @param identifier_begin pointer to the identifier.
+    /// @param identifier_len identifier length.
+    /// @return the host or null.
+    ConstHostPtr get6(const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len) const;
+
+    /// @brief Adds or replaces a host.
+    ///
+    /// The host is added for the families in which it is global, i.e. a
+    /// host which is not global is ignored.
+    ///
+    /// @param host the host.
+    void add(const ConstHostPtr& host);
+
+    /// @brief Removes the global host with IPv4 reservations.
+    ///
+    /// @param identifier_type identifier type.
+    /// @param identifier_begin pointer to the identifier.
+    /// @param identifier_len identifier length.
+    /// @return true when a host was removed.
+    bool del4(const Host::IdentifierType& identifier_type,
+              const uint8_t* identifier_begin,
+              const size_t identifier_len);
+
+    /// @brief Removes the global host with IPv6 reservations.
+    ///
+    /// @param identifier_type identifier type.
+    /// @param identifier_begin pointer to the identifier.
+    /// @param identifier_len identifier length.
+    /// @return true when a host was removed.
+    bool del6(const Host::IdentifierType& identifier_type,
+              const uint8_t* identifier_begin,
+              const size_t identifier_len);
+
+    /// @brief Returns the number of global hosts with IPv4 reservations.
+    size_t size4() const;
+
+    /// @brief Returns the number of global hosts with IPv6 reservations.
+    size_t size6() const;
+
+private:
+
+    /// @brief Type of the hosts indexed by identifier.
+    typedef std::unordered_map<std::string, ConstHostPtr> HostMap;
+
+    /// @brief The replicated hosts of both families.
+    struct Hosts {
+        /// @brief The global hosts with IPv4 reservations.
+        HostMap hosts4_;
+
+        /// @brief The global hosts with IPv6 reservations.
+        HostMap hosts6_;
+    };
+
+    /// @brief Builds the key of a host.
+    ///
+    /// @param identifier_type identifier type.
+    /// @param identifier_begin pointer to the identifier.
+    /// @param identifier_len identifier length.
+    /// @return the key.
+    static std::string makeKey(const Host::IdentifierType& identifier_type,
+                               const uint8_t* identifier_begin,
+                               const size_t identifier_len);
+
+    /// @brief Builds the key of a host.
+    ///
+    /// @param host the host.
+    /// @return the key.
+    static std::string makeKey(const ConstHostPtr& host);
+
+    /// @brief Looks for a host.
+    ///
+    /// @param hosts the hosts of a family.
+    /// @param key the key.
+    /// @return the host or null.
+    ConstHostPtr getInternal(const HostMap& hosts,
+                             const std::string& key) const;
+
+    /// @brief The replicated hosts, null until the first load.
+    boost::shared_ptr<Hosts> hosts_;
+
+    /// @brief The mutex protecting the hosts.
+    boost::scoped_ptr<std::mutex> mutex_;
+};
+
+/// @brief Pointer to a global host replica.
+typedef boost::shared_ptr<GlobalHostReplica> GlobalHostReplicaPtr;
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // GLOBAL_HOST_REPLICA_H
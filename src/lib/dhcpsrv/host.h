@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -669,6 +669,26 @@ public:
         return (cfg_option6_);
     }
 
+    /// @brief Sets the DHCPv4 option data configuration for this host.
+    ///
+    /// The configuration may be shared with other hosts, e.g. by the
+    /// compact host store.
+    ///
+    /// @param cfg_option DHCPv4 option data configuration, not null.
+    void setCfgOption4(const CfgOptionPtr& cfg_option) {
+        cfg_option4_ = cfg_option;
+    }
+
+    /// @brief Sets the DHCPv6 option data configuration for this host.
+    ///
+    /// The configuration may be shared with other hosts, e.g. by the
+    /// compact host store.
+    ///
+    /// @param cfg_option DHCPv6 option data configuration, not null.
+    void setCfgOption6(const CfgOptionPtr& cfg_option) {
+        cfg_option6_ = cfg_option;
+    }
+
     /// @brief Returns information about the host in the textual format.
     std::string toText() const;
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,6 +10,12 @@
 #include <dhcpsrv/host_mgr.h>
 #include <dhcpsrv/hosts_log.h>
 #include <dhcpsrv/host_data_source_factory.h>
+#include <dhcpsrv/lru_host_cache.h>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+
+#include <iterator>
 
 namespace {
 
@@ -46,7 +52,55 @@ HostMgr::create() {
 
 void
 HostMgr::addBackend(const std::string& access) {
-    HostDataSourceFactory::add(getHostMgrPtr()->alternate_sources_, access);
+    HostDataSourceList& sources = getHostMgrPtr()->alternate_sources_;
+    HostDataSourceFactory::add(sources, access);
+
+    DatabaseConnection::ParameterMap parameters =
+        DatabaseConnection::parse(access);
+
+    // Replicate the global reservations when the host database requires it.
+    auto replica = parameters.find("global-hosts-in-memory");
+    if ((replica != parameters.end()) && (replica->second == "true")) {
+        uint32_t refresh = 0;
+        auto refresh_it = parameters.find("global-hosts-refresh");
+        if (refresh_it != parameters.end()) {
+            try {
+                refresh = boost::lexical_cast<uint32_t>(refresh_it->second);
+            } catch (const boost::bad_lexical_cast&) {
+                isc_throw(BadValue, "invalid global replica parameters in "
+                          << access);
+            }
+        }
+        getHostMgrPtr()->enableGlobalReplica(refresh);
+    }
+
+    // Put the built-in cache in front of the host backends when the
+    // host database requires it and no other cache is first.
+    auto size = parameters.find("cache-size");
+    if ((size == parameters.end()) ||
+        boost::dynamic_pointer_cast<CacheHostDataSource>(sources[0])) {
+        return;
+    }
+    size_t capacity = 0;
+    uint32_t ttl = 0;
+    try {
+        capacity = boost::lexical_cast<size_t>(size->second);
+        auto ttl_it = parameters.find("cache-ttl");
+        if (ttl_it != parameters.end()) {
+            ttl = boost::lexical_cast<uint32_t>(ttl_it->second);
+        }
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(BadValue, "invalid host cache parameters in " << access);
+    }
+    if (capacity == 0) {
+        return;
+    }
+    sources.insert(sources.begin(),
+                   boost::make_shared<LruHostCache>(capacity, ttl));
+    auto negative = parameters.find("cache-negative");
+    if ((negative != parameters.end()) && (negative->second == "true")) {
+        getHostMgrPtr()->setNegativeCaching(true);
+    }
 }
 
 bool
@@ -69,6 +123,8 @@ HostMgr::delBackend(const std::string& db_type, const std::string& access,
 void
 HostMgr::delAllBackends() {
     getHostMgrPtr()->alternate_sources_.clear();
+    getHostMgrPtr()->global_replica_timer_.reset();
+    getHostMgrPtr()->global_replica_.reset();
 }
 
 HostDataSourcePtr
@@ -328,6 +384,12 @@ HostMgr::get4Any(const SubnetID& subnet_id,
         return (host);
     }
 
+    // The replica holds all the global reservations of the backends.
+    if (useGlobalReplica(subnet_id)) {
+        return (global_replica_->get4(identifier_type, identifier_begin,
+                                      identifier_len));
+    }
+
     LOG_DEBUG(hosts_logger, HOSTS_DBG_TRACE,
               HOSTS_MGR_ALTERNATE_GET4_SUBNET_ID_IDENTIFIER)
         .arg(subnet_id)
@@ -373,13 +435,91 @@ HostMgr::get4(const SubnetID& subnet_id,
                                 identifier_begin, identifier_len);
     if (host && host->getNegative()) {
         return (ConstHostPtr());
-    } else if (!host && negative_caching_) {
+    } else if (!host && negative_caching_ && !useGlobalReplica(subnet_id)) {
         cacheNegative(subnet_id, SubnetID(SUBNET_ID_UNUSED),
                       identifier_type, identifier_begin, identifier_len);
     }
     return (host);
 }
 
+ConstHostPtr
+HostMgr::get4(const SubnetID& subnet_id,
+              const HostIdentifierList& identifiers) const {
+    // Look for the identifiers one by one when a single lookup saves
+    // nothing or when the cache must see each lookup.
+    if (cache_ptr_ || alternate_sources_.empty() || (identifiers.size() < 2) ||
+        useGlobalReplica(subnet_id)) {
+        for (auto const& identifier : identifiers) {
+            ConstHostPtr host = get4(subnet_id, identifier.first,
+                                     identifier.second.data(),
+                                     identifier.second.size());
+            if (host) {
+                return (host);
+            }
+        }
+        return (ConstHostPtr());
+    }
+
+    // Only the identifiers preferred to the first one with a reservation
+    // in the configuration file must be looked for in the host backends.
+    // They are copied only when they are not all looked for.
+    size_t preferred = 0;
+    ConstHostPtr cfg_host;
+    for (auto const& identifier : identifiers) {
+        cfg_host = getCfgHosts()->get4(subnet_id, identifier.first,
+                                       identifier.second.data(),
+                                       identifier.second.size());
+        if (cfg_host) {
+            break;
+        }
+        ++preferred;
+    }
+    if (preferred == 0) {
+        return (cfg_host);
+    }
+    HostIdentifierList preferred_identifiers;
+    if (preferred < identifiers.size()) {
+        auto last = identifiers.begin();
+        std::advance(last, preferred);
+        preferred_identifiers.assign(identifiers.begin(), last);
+    }
+    const HostIdentifierList& lookup =
+        (preferred < identifiers.size() ? preferred_identifiers : identifiers);
+
+    LOG_DEBUG(hosts_logger, HOSTS_DBG_TRACE,
+              HOSTS_MGR_ALTERNATE_GET4_SUBNET_ID_IDENTIFIERS)
+        .arg(subnet_id)
+        .arg(lookup.size());
+
+    std::vector<ConstHostCollection> found;
+    for (auto source : alternate_sources_) {
+        found.push_back(source->getAllbyIdentifiers4(subnet_id, lookup));
+    }
+
+    // Return the host of the preferred identifier, the backends being
+    // searched in order for each identifier.
+    for (auto const& identifier : lookup) {
+        for (size_t i = 0; i < found.size(); ++i) {
+            for (auto const& host : found[i]) {
+                if ((host->getIdentifierType() != identifier.first) ||
+                    (host->getIdentifier() != identifier.second)) {
+                    continue;
+                }
+                LOG_DEBUG(hosts_logger, HOSTS_DBG_RESULTS,
+                          HOSTS_MGR_ALTERNATE_GET4_SUBNET_ID_IDENTIFIER_HOST)
+                    .arg(subnet_id)
+                    .arg(Host::getIdentifierAsText(identifier.first,
+                                                   identifier.second.data(),
+                                                   identifier.second.size()))
+                    .arg(alternate_sources_[i]->getType())
+                    .arg(host->toText());
+                return (host);
+            }
+        }
+    }
+    return (cfg_host);
+}
+
 ConstHostPtr
 HostMgr::get4(const SubnetID& subnet_id,
               const asiolink::IOAddress& address) const {
@@ -458,6 +598,12 @@ HostMgr::get6Any(const SubnetID& subnet_id,
         return (host);
     }
 
+    // The replica holds all the global reservations of the backends.
+    if (useGlobalReplica(subnet_id)) {
+        return (global_replica_->get6(identifier_type, identifier_begin,
+                                      identifier_len));
+    }
+
     LOG_DEBUG(hosts_logger, HOSTS_DBG_TRACE,
               HOSTS_MGR_ALTERNATE_GET6_SUBNET_ID_IDENTIFIER)
         .arg(subnet_id)
@@ -503,13 +649,91 @@ HostMgr::get6(const SubnetID& subnet_id,
                                 identifier_begin, identifier_len);
     if (host && host->getNegative()) {
         return (ConstHostPtr());
-    } else if (!host && negative_caching_) {
+    } else if (!host && negative_caching_ && !useGlobalReplica(subnet_id)) {
         cacheNegative(SubnetID(SUBNET_ID_UNUSED), subnet_id,
                       identifier_type, identifier_begin, identifier_len);
     }
     return (host);
 }
 
+ConstHostPtr
+HostMgr::get6(const SubnetID& subnet_id,
+              const HostIdentifierList& identifiers) const {
+    // Look for the identifiers one by one when a single lookup saves
+    // nothing or when the cache must see each lookup.
+    if (cache_ptr_ || alternate_sources_.empty() || (identifiers.size() < 2) ||
+        useGlobalReplica(subnet_id)) {
+        for (auto const& identifier : identifiers) {
+            ConstHostPtr host = get6(subnet_id, identifier.first,
+                                     identifier.second.data(),
+                                     identifier.second.size());
+            if (host) {
+                return (host);
+            }
+        }
+        return (ConstHostPtr());
+    }
+
+    // Only the identifiers preferred to the first one with a reservation
+    // in the configuration file must be looked for in the host backends.
+    // They are copied only when they are not all looked for.
+    size_t preferred = 0;
+    ConstHostPtr cfg_host;
+    for (auto const& identifier : identifiers) {
+        cfg_host = getCfgHosts()->get6(subnet_id, identifier.first,
+                                       identifier.second.data(),
+                                       identifier.second.size());
+        if (cfg_host) {
+            break;
+        }
+        ++preferred;
+    }
+    if (preferred == 0) {
+        return (cfg_host);
+    }
+    HostIdentifierList preferred_identifiers;
+    if (preferred < identifiers.size()) {
+        auto last = identifiers.begin();
+        std::advance(last, preferred);
+        preferred_identifiers.assign(identifiers.begin(), last);
+    }
+    const HostIdentifierList& lookup =
+        (preferred < identifiers.size() ? preferred_identifiers : identifiers);
+
+    LOG_DEBUG(hosts_logger, HOSTS_DBG_TRACE,
+              HOSTS_MGR_ALTERNATE_GET6_SUBNET_ID_IDENTIFIERS)
+        .arg(subnet_id)
+        .arg(lookup.size());
+
+    std::vector<ConstHostCollection> found;
+    for (auto source : alternate_sources_) {
+        found.push_back(source->getAllbyIdentifiers6(subnet_id, lookup));
+    }
+
+    // Return the host of the preferred identifier, the backends being
+    // searched in order for each identifier.
+    for (auto const& identifier : lookup) {
+        for (size_t i = 0; i < found.size(); ++i) {
+            for (auto const& host : found[i]) {
+                if ((host->getIdentifierType() != identifier.first) ||
+                    (host->getIdentifier() != identifier.second)) {
+                    continue;
+                }
+                LOG_DEBUG(hosts_logger, HOSTS_DBG_RESULTS,
+                          HOSTS_MGR_ALTERNATE_GET6_SUBNET_ID_IDENTIFIER_HOST)
+                    .arg(subnet_id)
+                    .arg(Host::getIdentifierAsText(identifier.first,
+                                                   identifier.second.data(),
+                                                   identifier.second.size()))
+                    .arg(alternate_sources_[i]->getType())
+                    .arg(host->toText());
+                return (host);
+            }
+        }
+    }
+    return (cfg_host);
+}
+
 ConstHostPtr
 HostMgr::get6(const SubnetID& subnet_id,
               const asiolink::IOAddress& addr) const {
@@ -566,6 +790,28 @@ HostMgr::add(const HostPtr& host) {
     if (cache_ptr_) {
         cache(host);
     }
+    if (global_replica_) {
+        global_replica_->add(host);
+    }
+}
+
+void
+HostMgr::addHosts(const HostCollection& hosts) {
+    if (alternate_sources_.empty()) {
+        isc_throw(NoHostDataSourceManager, "Unable to add new hosts because there is "
+                  "no hosts-database configured.");
+    }
+    for (auto source : alternate_sources_) {
+        source->addHosts(hosts);
+    }
+    for (auto const& host : hosts) {
+        if (cache_ptr_) {
+            cache(host);
+        }
+        if (global_replica_) {
+            global_replica_->add(host);
+        }
+    }
 }
 
 bool
@@ -577,6 +823,10 @@ HostMgr::del(const SubnetID& subnet_id, const asiolink::IOAddress& addr) {
 
     for (auto source : alternate_sources_) {
         if (source->del(subnet_id, addr)) {
+            // The replica is not indexed by address.
+            if (global_replica_ && (subnet_id == SUBNET_ID_GLOBAL)) {
+                loadGlobalReplica();
+            }
             return (true);
         }
     }
@@ -594,6 +844,10 @@ HostMgr::del4(const SubnetID& subnet_id, const Host::IdentifierType& identifier_
     for (auto source : alternate_sources_) {
         if (source->del4(subnet_id, identifier_type,
                          identifier_begin, identifier_len)) {
+            if (global_replica_ && (subnet_id == SUBNET_ID_GLOBAL)) {
+                global_replica_->del4(identifier_type, identifier_begin,
+                                       identifier_len);
+            }
             return (true);
         }
     }
@@ -611,12 +865,63 @@ HostMgr::del6(const SubnetID& subnet_id, const Host::IdentifierType& identifier_
     for (auto source : alternate_sources_) {
         if (source->del6(subnet_id, identifier_type,
                          identifier_begin, identifier_len)) {
+            if (global_replica_ && (subnet_id == SUBNET_ID_GLOBAL)) {
+                global_replica_->del6(identifier_type, identifier_begin,
+                                       identifier_len);
+            }
             return (true);
         }
     }
     return (false);
 }
 
+void
+HostMgr::enableGlobalReplica(uint32_t refresh) {
+    if (!global_replica_) {
+        global_replica_.reset(new GlobalHostReplica());
+    }
+    loadGlobalReplica();
+
+    global_replica_timer_.reset();
+    if ((refresh > 0) && io_service_) {
+        global_replica_timer_.reset(new IntervalTimer(*io_service_));
+        global_replica_timer_->setup([]() {
+                                         HostMgr::instance().loadGlobalReplica();
+                                     },
+                                     static_cast<long>(refresh) * 1000);
+    }
+}
+
+void
+HostMgr::loadGlobalReplica() {
+    if (!global_replica_) {
+        return;
+    }
+    try {
+        global_replica_->load(alternate_sources_);
+        LOG_DEBUG(hosts_logger, HOSTS_DBG_RESULTS,
+                  HOSTS_MGR_GLOBAL_REPLICA_LOADED)
+            .arg(global_replica_->size4())
+            .arg(global_replica_->size6());
+    } catch (const std::exception& ex) {
+        LOG_ERROR(hosts_logger, HOSTS_MGR_GLOBAL_REPLICA_LOAD_FAILED)
+            .arg(ex.what());
+    }
+}
+
+bool
+HostMgr::useGlobalReplica(const SubnetID& subnet_id) const {
+    return ((subnet_id == SUBNET_ID_GLOBAL) && global_replica_ &&
+            global_replica_->isLoaded());
+}
+
+void
+HostMgr::flushCache() {
+    if (cache_ptr_) {
+        cache_ptr_->flush(0);
+    }
+}
+
 void
 HostMgr::cache(ConstHostPtr host) const {
     if (cache_ptr_) {
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,10 +7,12 @@
 #ifndef HOST_MGR_H
 #define HOST_MGR_H
 
+#include <asiolink/interval_timer.h>
 #include <asiolink/io_service.h>
 #include <database/database_connection.h>
 #include <dhcpsrv/base_host_data_source.h>
 #include <dhcpsrv/cache_host_data_source.h>
+#include <dhcpsrv/global_host_replica.h>
 #include <dhcpsrv/host.h>
 #include <dhcpsrv/subnet_id.h>
 #include <boost/noncopyable.hpp>
@@ -72,6 +74,18 @@ public:
     /// However, the "type" parameter will be common and it will specify which
     /// backend is to be used. Currently, no parameters are supported
     /// and the parameter is ignored.
+    ///
+    /// When the access string includes a non-zero "cache-size" and the
+    /// first host backend is not a cache, a @c LruHostCache is inserted in
+    /// front of the host backends. The "cache-ttl" parameter gives the
+    /// lifetime of its entries and the "cache-negative" parameter enables
+    /// the negative caching.
+    ///
+    /// When the access string sets "global-hosts-in-memory" to true the global
+    /// reservations are loaded in a @c GlobalHostReplica which answers the
+    /// lookups of the global reservations by identifier. The
+    /// "global-hosts-refresh" parameter gives the period in seconds of
+    /// the reload of the replica.
     static void addBackend(const std::string& access);
 
     /// @brief Delete an alternate host backend (aka host data source).
@@ -378,6 +392,24 @@ public:
     get4(const SubnetID& subnet_id, const Host::IdentifierType& identifier_type,
          const uint8_t* identifier_begin, const size_t identifier_len) const;
 
+    /// @brief Returns a host connected to the IPv4 subnet using the first
+    /// identifier with a reservation.
+    ///
+    /// This method returns the same reservation as calling @c get4 for each
+    /// identifier in the order of preference until a host is found, but it
+    /// looks for all identifiers not found in the configuration file with
+    /// a single @c BaseHostDataSource::getAllbyIdentifiers4 call per host
+    /// backend. When a cache host backend is used the identifiers are
+    /// looked for one by one to keep the cache up to date.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Identifiers in the order of preference.
+    ///
+    /// @return Const @c Host object for which reservation has been made using
+    /// the first identifier with a reservation.
+    ConstHostPtr
+    get4(const SubnetID& subnet_id, const HostIdentifierList& identifiers) const;
+
     /// @brief Returns a host connected to the IPv4 subnet and having
     /// a reservation for a specified IPv4 address.
     ///
@@ -457,6 +489,24 @@ public:
     get6(const SubnetID& subnet_id, const Host::IdentifierType& identifier_type,
          const uint8_t* identifier_begin, const size_t identifier_len) const;
 
+    /// @brief Returns a host connected to the IPv6 subnet using the first
+    /// identifier with a reservation.
+    ///
+    /// This method returns the same reservation as calling @c get6 for each
+    /// identifier in the order of preference until a host is found, but it
+    /// looks for all identifiers not found in the configuration file with
+    /// a single @c BaseHostDataSource::getAllbyIdentifiers6 call per host
+    /// backend. When a cache host backend is used the identifiers are
+    /// looked for one by one to keep the cache up to date.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Identifiers in the order of preference.
+    ///
+    /// @return Const @c Host object for which reservation has been made using
+    /// the first identifier with a reservation.
+    ConstHostPtr
+    get6(const SubnetID& subnet_id, const HostIdentifierList& identifiers) const;
+
     /// @brief Returns a host using the specified IPv6 prefix.
     ///
     /// This method returns a host using specified IPv6 prefix, as described
@@ -513,6 +563,14 @@ public:
     /// @param host Pointer to the new @c Host object being added.
     virtual void add(const HostPtr& host);
 
+    /// @brief Adds a collection of new hosts to the alternate data source.
+    ///
+    /// This method will throw an exception if no alternate data source is
+    /// in use.
+    ///
+    /// @param hosts Collection of the new @c Host objects being added.
+    virtual void addHosts(const HostCollection& hosts);
+
     /// @brief Attempts to delete hosts by address.
     ///
     /// It deletes hosts from the first alternate source in which at least
@@ -577,6 +635,27 @@ public:
     /// @return pointer to the first host data source (or NULL).
     HostDataSourcePtr getHostDataSource() const;
 
+    /// @brief Removes all entries from the cache host backend.
+    ///
+    /// Called when the configuration the cached reservations depend on,
+    /// e.g. the subnets received from the configuration backend, changes.
+    /// Does nothing when there is no cache.
+    void flushCache();
+
+    /// @brief Returns the replica of the global reservations.
+    ///
+    /// @return the replica or null when it is not enabled.
+    GlobalHostReplicaPtr getGlobalReplica() const {
+        return (global_replica_);
+    }
+
+    /// @brief Reloads the replica of the global reservations.
+    ///
+    /// A failure is logged and the replica keeps its content, or is not
+    /// used when it was never loaded. Does nothing when there is no
+    /// replica.
+    void loadGlobalReplica();
+
     /// @brief Returns the negative caching flag.
     ///
     /// @return the negative caching flag.
@@ -603,6 +682,13 @@ public:
         disable_single_query_ = disable_single_query;
     }
 
+    /// @brief Returns the number of entries in the cache host backend.
+    ///
+    /// @return the size of the cache or 0 when there is no cache.
+    size_t getCacheSize() const {
+        return (cache_ptr_ ? cache_ptr_->size() : 0);
+    }
+
     /// @brief Controls whether IP reservations are unique or non-unique.
     ///
     /// In a typical case, the IP reservations are unique and backends verify
@@ -692,6 +778,26 @@ private:
     HostMgr() : negative_caching_(false), disable_single_query_(false),
                 ip_reservations_unique_(true) { }
 
+    /// @brief Enables the replica of the global reservations.
+    ///
+    /// Creates and loads the replica and starts its periodic reload.
+    ///
+    /// @param refresh the period of the reload in seconds, 0 disables it.
+    void enableGlobalReplica(uint32_t refresh);
+
+    /// @brief Checks if a lookup is answered by the global replica.
+    ///
+    /// @param subnet_id the subnet of the lookup.
+    /// @return true when the lookup is for the global reservations and
+    /// the replica is loaded.
+    bool useGlobalReplica(const SubnetID& subnet_id) const;
+
+    /// @brief The replica of the global reservations.
+    GlobalHostReplicaPtr global_replica_;
+
+    /// @brief The timer of the reload of the global replica.
+    asiolink::IntervalTimerPtr global_replica_timer_;
+
     /// @brief List of alternate host data sources.
     HostDataSourceList alternate_sources_;
 
@@ -0,0 +1,179 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef IDENTIFIER_POOL_H
+#define IDENTIFIER_POOL_H
+
+#include <dhcp/duid.h>
+#include <dhcp/hwaddr.h>
+#include <boost/functional/hash.hpp>
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
+#include <unordered_set>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Returns the hash of a hardware address.
+///
+/// @param hwaddr hardware address.
+/// @return hash of the hardware address, its type and source.
+inline size_t
+identifierHash(const HWAddr& hwaddr) {
+    size_t hash = boost::hash_range(hwaddr.hwaddr_.begin(), hwaddr.hwaddr_.end());
+    boost::hash_combine(hash, hwaddr.htype_);
+    boost::hash_combine(hash, hwaddr.source_);
+    return (hash);
+}
+
+/// @brief Checks if two hardware addresses can be shared.
+///
+/// @param first first hardware address.
+/// @param second second hardware address.
+/// @return true if the addresses, their types and sources are equal.
+inline bool
+identifierEquals(const HWAddr& first, const HWAddr& second) {
+    return ((first == second) && (first.source_ == second.source_));
+}
+
+/// @brief Returns the hash of a DUID or client identifier.
+///
+/// @param duid DUID or client identifier.
+/// @return hash of the identifier.
+inline size_t
+identifierHash(const DUID& duid) {
+    auto const& value = duid.getDuid();
+    return (boost::hash_range(value.begin(), value.end()));
+}
+
+/// @brief Checks if two DUIDs or client identifiers are equal.
+///
+/// @param first first identifier.
+/// @param second second identifier.
+/// @return true if the identifiers are equal.
+inline bool
+identifierEquals(const DUID& first, const DUID& second) {
+    return (first.getDuid() == second.getDuid());
+}
+
+/// @brief Pool of interned client identifiers.
+///
+/// The leases of the same client hold equal identifiers, e.g. the leases
+/// of the several IAs of a DHCPv6 client or the leases renewed from a
+/// copy. The lease backends holding many leases in memory intern the
+/// identifiers of the stored leases so equal identifiers are held once
+/// and shared by the leases.
+///
+/// The pool holds a reference to each interned identifier. The
+/// identifiers no longer referenced by any lease are purged when the
+/// pool size doubles since the last purge, so the purge cost is
+/// amortized over the interned identifiers.
+///
+/// The interned identifiers are shared and must not be modified. The
+/// pool is not thread safe: the lease backend must hold its lock.
+///
+/// @tparam Identifier identifier type, i.e. @c HWAddr, @c DUID or
+/// @c ClientId.
+template<typename Identifier>
+class IdentifierPool {
+public:
+
+    /// @brief Pointer to the identifier.
+    typedef boost::shared_ptr<Identifier> IdentifierPtr;
+
+    /// @brief Minimal size of the pool triggering a purge.
+    static const size_t MIN_PURGE_SIZE = 1024;
+
+    /// @brief Constructor.
+    IdentifierPool() : pool_(), purge_size_(MIN_PURGE_SIZE) {
+    }
+
+    /// @brief Interns an identifier.
+    ///
+    /// @param identifier identifier to intern.
+    /// @return the pooled identifier equal to the specified one, the
+    /// specified identifier when it was not in the pool or null pointer
+    /// when the identifier is null.
+    IdentifierPtr intern(const IdentifierPtr& identifier) {
+        if (!identifier) {
+            return (identifier);
+        }
+        auto it = pool_.find(identifier);
+        if (it != pool_.end()) {
+            return (*it);
+        }
+        if (pool_.size() >= purge_size_) {
+            purge();
+            purge_size_ = std::max(MIN_PURGE_SIZE, 2 * pool_.size());
+        }
+        pool_.insert(identifier);
+        return (identifier);
+    }
+
+    /// @brief Removes the identifiers referenced only by the pool.
+    void purge() {
+        for (auto it = pool_.begin(); it != pool_.end(); ) {
+            if (it->use_count() == 1) {
+                it = pool_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /// @brief Removes all the identifiers.
+    void clear() {
+        pool_.clear();
+        purge_size_ = MIN_PURGE_SIZE;
+    }
+
+    /// @brief Returns the number of identifiers in the pool.
+    ///
+    /// @return the number of identifiers including the ones not yet purged.
+    size_t size() const {
+        return (pool_.size());
+    }
+
+private:
+
+    /// @brief Hashes the identifiers by value.
+    struct Hash {
+        /// @brief A hashing operator.
+        ///
+        /// @param identifier identifier to hash.
+        /// @return hash of the identifier value.
+        size_t operator()(const IdentifierPtr& identifier) const {
+            return (identifierHash(*identifier));
+        }
+    };
+
+    /// @brief Compares the identifiers by value.
+    struct Equal {
+        /// @brief An equality operator.
+        ///
+        /// @param first first identifier.
+        /// @param second second identifier.
+        /// @return true if the identifiers are equal.
+        bool operator()(const IdentifierPtr& first,
+                        const IdentifierPtr& second) const {
+            return (identifierEquals(*first, *second));
+        }
+    };
+
+    /// @brief The interned identifiers.
+    std::unordered_set<IdentifierPtr, Hash, Equal> pool_;
+
+    /// @brief Pool size triggering the next purge.
+    size_t purge_size_;
+};
+
+template<typename Identifier>
+const size_t IdentifierPool<Identifier>::MIN_PURGE_SIZE;
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // IDENTIFIER_POOL_H
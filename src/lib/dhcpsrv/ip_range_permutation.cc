@@ -15,17 +15,66 @@ using namespace isc::asiolink;
 namespace isc {
 namespace dhcp {
 
-IPRangePermutation::IPRangePermutation(const AddressRange& range)
-    : range_start_(range.start_), step_(1), cursor_(addrsInRange(range_start_, range.end_) - 1),
-      initial_cursor_(cursor_), state_(), done_(false), generator_() {
+IPRangePermutation::IPRangePermutation(const AddressRange& range, const Mode mode)
+    : mode_(mode), range_start_(range.start_), step_(1),
+      cursor_(addrsInRange(range_start_, range.end_) - 1),
+      initial_cursor_(cursor_), state_(), done_(false), generator_(),
+      half_bits_(0), keys_() {
     std::random_device rd;
     generator_.seed(rd());
+    if (mode_ == FEISTEL) {
+        initFeistel();
+    }
 }
 
-IPRangePermutation::IPRangePermutation(const PrefixRange& range)
-    : range_start_(range.start_), step_(static_cast<uint64_t>(1) << (128 - range.delegated_length_)),
+IPRangePermutation::IPRangePermutation(const PrefixRange& range, const Mode mode)
+    : mode_(mode), range_start_(range.start_),
+      step_(static_cast<uint64_t>(1) << (128 - range.delegated_length_)),
       cursor_(prefixesInRange(range.prefix_length_, range.delegated_length_) - 1),
-      initial_cursor_(cursor_), state_(), done_(false), generator_() {
+      initial_cursor_(cursor_), state_(), done_(false), generator_(),
+      half_bits_(0), keys_() {
+    if (mode_ == FEISTEL) {
+        initFeistel();
+    }
+}
+
+void
+IPRangePermutation::initFeistel() {
+    // Get the number of bits required to represent the largest position
+    // in the range and round it up to an even number so the network is
+    // balanced. The domain is at most four times larger than the range.
+    uint8_t bits = 0;
+    for (auto last = initial_cursor_; last != 0; last >>= 1) {
+        ++bits;
+    }
+    half_bits_ = (bits + 1) / 2;
+    if (half_bits_ == 0) {
+        half_bits_ = 1;
+    }
+    // New keys yield a new permutation.
+    std::uniform_int_distribution<uint64_t> dist;
+    for (auto& key : keys_) {
+        key = dist(generator_);
+    }
+}
+
+uint64_t
+IPRangePermutation::encrypt(uint64_t value) const {
+    const uint64_t mask = (static_cast<uint64_t>(1) << half_bits_) - 1;
+    uint64_t left = (value >> half_bits_) & mask;
+    uint64_t right = value & mask;
+    for (auto const& key : keys_) {
+        // The round function is the splitmix64 finalizer of the keyed
+        // right half. It does not need to be invertible.
+        uint64_t mixed = right ^ key;
+        mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebULL;
+        mixed ^= (mixed >> 31);
+        uint64_t next_right = left ^ (mixed & mask);
+        left = right;
+        right = next_right;
+    }
+    return ((left << half_bits_) | right);
 }
 
 IOAddress
@@ -37,14 +86,35 @@ IPRangePermutation::next(bool& done) {
         return (range_start_.isV4() ? IOAddress::IPV4_ZERO_ADDRESS() : IOAddress::IPV6_ZERO_ADDRESS());
     }
 
-    // If there is one address left, return this address.
+    auto next_address = (mode_ == FEISTEL ? nextFeistel() : nextShuffle());
+    done = done_;
+    return (next_address);
+}
+
+IOAddress
+IPRangePermutation::nextFeistel() {
+    // The cursor counts down the remaining positions. Encrypt the number
+    // of already returned positions and walk the cycle until the value
+    // falls within the range.
+    auto position = encrypt(initial_cursor_ - cursor_);
+    while (position > initial_cursor_) {
+        position = encrypt(position);
+    }
     if (cursor_ == 0) {
-        done = done_ = true;
-        return (state_.at(0));
+        done_ = true;
+    } else {
+        --cursor_;
     }
+    return (offsetAddress(range_start_, position * step_));
+}
 
-    // We're not done.
-    done = false;
+IOAddress
+IPRangePermutation::nextShuffle() {
+    // If there is one address left, return this address.
+    if (cursor_ == 0) {
+        done_ = true;
+        return (state_.at(0).toIOAddress());
+    }
 
     // The cursor indicates where we're in the range starting from its end. The
     // addresses between the cursor and the end of the range have been already
@@ -61,7 +131,7 @@ IPRangePermutation::next(bool& done) {
     auto next_loc_existing = state_.find(next_loc);
     if (next_loc_existing != state_.end()) {
         // Address exists, so let's record it.
-        next_loc_address = next_loc_existing->second;
+        next_loc_address = next_loc_existing->second.toIOAddress();
     } else {
         // Address does not exist on this position. We infer this address from
         // its position by advancing the range start by position. For example,
@@ -75,7 +145,7 @@ IPRangePermutation::next(bool& done) {
     IOAddress cursor_address = IOAddress::IPV4_ZERO_ADDRESS();
     auto cursor_existing = state_.find(cursor_);
     if (cursor_existing != state_.end()) {
-        cursor_address = cursor_existing->second;
+        cursor_address = cursor_existing->second.toIOAddress();
     } else {
         cursor_address = offsetAddress(range_start_, cursor_ * step_);
     }
@@ -86,9 +156,9 @@ IPRangePermutation::next(bool& done) {
     // position. This address will be returned in the future if we get back
     // to this position as a result of randomization.
     if (next_loc_existing == state_.end()) {
-        state_.insert(std::make_pair(next_loc, cursor_address));
+        state_.insert(std::make_pair(next_loc, CompactAddress(cursor_address)));
     } else {
-        state_.at(next_loc) = cursor_address;
+        state_.at(next_loc) = CompactAddress(cursor_address);
     }
     // Move the cursor one position backwards.
     --cursor_;
@@ -102,6 +172,9 @@ IPRangePermutation::reset() {
     state_.clear();
     cursor_ = initial_cursor_;
     done_ = false;
+    if (mode_ == FEISTEL) {
+        initFeistel();
+    }
 }
 
 } // end of namespace isc::dhcp
@@ -7,11 +7,13 @@
 #ifndef IP_RANGE_PERMUTATION_H
 #define IP_RANGE_PERMUTATION_H
 
+#include <asiolink/compact_address.h>
 #include <asiolink/io_address.h>
 #include <dhcpsrv/ip_range.h>
 
 #include <boost/shared_ptr.hpp>
 
+#include <array>
 #include <unordered_map>
 #include <random>
 
@@ -61,21 +63,51 @@ namespace dhcp {
 /// belonging to the given range are returned and no duplicates are returned.
 /// The addresses or delegated prefixes are returned in a random order.
 ///
+/// The state of the shuffle grows with the number of returned addresses or
+/// prefixes and eventually holds an entry for most of the positions in the
+/// range. It is unsuitable for very large ranges, e.g. the /64 address pools
+/// or large delegated prefix pools. For these ranges the class provides the
+/// @c FEISTEL mode. In this mode the position of the next returned address
+/// or prefix is computed by encrypting a counter with a keyed Feistel network
+/// over the smallest domain of an even number of bits covering the range.
+/// The values falling out of the range are encrypted again (cycle walking)
+/// until they fall within the range. Because the network is a bijection of
+/// its domain, the counter values 0..size-1 produce all positions in the
+/// range exactly once, using constant memory and, on average, fewer than
+/// four encryptions per call.
+///
 /// @todo Methods of this class should be called in thread safe context. Otherwise
 /// they should be made thread safe.
 class IPRangePermutation {
 public:
 
+    /// @brief Permutation generation modes.
+    enum Mode {
+        /// Fisher-Yates shuffle storing the swapped positions.
+        SHUFFLE,
+        /// Stateless Feistel network with cycle walking.
+        FEISTEL
+    };
+
     /// @brief Constructor for address ranges.
     ///
     /// @param range address range for which the permutation will be generated.
-    IPRangePermutation(const AddressRange& range);
+    /// @param mode permutation generation mode.
+    IPRangePermutation(const AddressRange& range, const Mode mode = SHUFFLE);
 
     /// @brief Constructor for prefix ranges.
     ///
     /// @param range range of delegated prefixes for which the permutation will
     /// be generated.
-    IPRangePermutation(const PrefixRange& range);
+    /// @param mode permutation generation mode.
+    IPRangePermutation(const PrefixRange& range, const Mode mode = SHUFFLE);
+
+    /// @brief Returns the permutation generation mode.
+    ///
+    /// @return permutation generation mode.
+    Mode getMode() const {
+        return (mode_);
+    }
 
     /// @brief Checks if the range has been exhausted.
     ///
@@ -108,6 +140,31 @@ public:
 
 private:
 
+    /// @brief Initializes the Feistel network.
+    ///
+    /// It computes the half width of the network domain from the range
+    /// size and draws new round keys.
+    void initFeistel();
+
+    /// @brief Returns next position in the permutation in the @c SHUFFLE mode.
+    ///
+    /// @return next address or prefix from the range.
+    asiolink::IOAddress nextShuffle();
+
+    /// @brief Returns next position in the permutation in the @c FEISTEL mode.
+    ///
+    /// @return next address or prefix from the range.
+    asiolink::IOAddress nextFeistel();
+
+    /// @brief Encrypts a value with the Feistel network.
+    ///
+    /// @param value value from the network domain.
+    /// @return encrypted value from the network domain.
+    uint64_t encrypt(uint64_t value) const;
+
+    /// Permutation generation mode.
+    Mode mode_;
+
     /// Beginning of the range.
     asiolink::IOAddress range_start_;
 
@@ -127,14 +184,20 @@ private:
 
     /// Keeps the current permutation state. The state associates the
     /// swapped IP addresses or delegated prefixes with their positions in
-    /// the permutation.
-    std::unordered_map<uint64_t, asiolink::IOAddress> state_;
+    /// the permutation. The compact addresses keep the state small.
+    std::unordered_map<uint64_t, asiolink::CompactAddress> state_;
 
     /// Indicates if the addresses or delegated prefixes are exhausted.
     bool done_;
 
     /// Random generator.
     std::mt19937 generator_;
+
+    /// Number of bits of each half of the Feistel network domain.
+    uint8_t half_bits_;
+
+    /// Round keys of the Feistel network.
+    std::array<uint64_t, 4> keys_;
 };
 
 /// @brief Pointer to the @c IPRangePermutation.
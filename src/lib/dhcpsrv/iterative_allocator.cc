@@ -7,6 +7,7 @@
 #include <config.h>
 
 #include <dhcpsrv/iterative_allocator.h>
+#include <dhcpsrv/lease_mgr_factory.h>
 #include <exceptions/exceptions.h>
 #include <boost/pointer_cast.hpp>
 #include <cstring>
@@ -22,6 +23,15 @@ IterativeAllocator::IterativeAllocator(Lease::Type type,
     : Allocator(type, subnet) {
 }
 
+void
+IterativeAllocator::initAfterConfigureInternal() {
+    // The memfile lookups are in memory so the filter would not help.
+    if (LeaseMgrFactory::haveInstance() &&
+        (LeaseMgrFactory::instance().getType() != "memfile")) {
+        initOccupancyFilter();
+    }
+}
+
 isc::asiolink::IOAddress
 IterativeAllocator::increasePrefix(const IOAddress& prefix,
                                    const uint8_t prefix_len) {
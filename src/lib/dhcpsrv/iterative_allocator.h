@@ -40,6 +40,13 @@ public:
 
 private:
 
+    /// @brief Performs allocator initialization after server's reconfiguration.
+    ///
+    /// The allocator populates the occupancy filter of the IPv4 pools
+    /// for the SQL lease backends so the candidates known to be in use
+    /// are skipped without the lease database lookups.
+    virtual void initAfterConfigureInternal();
+
     /// @brief Returns the next address from the pools in the subnet.
     ///
     /// Internal thread-unsafe implementation of the @c pickAddress.
@@ -10,6 +10,7 @@
 #include <util/pointer_util.h>
 #include <util/strutil.h>
 #include <boost/algorithm/string.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <sstream>
 #include <iostream>
@@ -191,8 +192,8 @@ Lease::fromElementCommon(const LeasePtr& lease, const data::ConstElementPtr& ele
         }
 
         try {
-            HWAddr parsed_hw_address = HWAddr::fromText(hw_address->stringValue());
-            lease->hwaddr_.reset(new HWAddr(parsed_hw_address.hwaddr_, HTYPE_ETHER));
+            lease->hwaddr_ = boost::make_shared<HWAddr>(HWAddr::fromText(hw_address->stringValue(),
+                                                                         HTYPE_ETHER));
 
         } catch (const std::exception& ex) {
             isc_throw(BadValue, "invalid hardware address "
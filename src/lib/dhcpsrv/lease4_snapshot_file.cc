@@ -0,0 +1,237 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcpsrv/lease4_snapshot_file.h>
+#include <dhcpsrv/lease_journal.h>
+#include <exceptions/exceptions.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace isc::util;
+
+namespace {
+
+/// @brief Magic bytes starting the file.
+const uint8_t SNAPSHOT_MAGIC[] = { 'K', 'E', 'A', 'S' };
+
+/// @brief Size of the output buffer written to the file at once.
+const size_t WRITE_CHUNK_SIZE = 64 * 1024;
+
+/// @brief Writes a 64 bits integer.
+void
+writeUint64(OutputBuffer& buf, uint64_t value) {
+    buf.writeUint32(static_cast<uint32_t>(value >> 32));
+    buf.writeUint32(static_cast<uint32_t>(value));
+}
+
+/// @brief Read-only memory mapping of a file.
+///
+/// The mapping is removed and the file closed by the destructor.
+class MappedFile {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param filename Name of the file.
+    explicit MappedFile(const std::string& filename)
+        : fd_(-1), data_(0), size_(0) {
+        fd_ = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            return;
+        }
+        struct stat st;
+        if ((fstat(fd_, &st) != 0) || (st.st_size <= 0)) {
+            return;
+        }
+        void* data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (data == MAP_FAILED) {
+            return;
+        }
+        // The leases are decoded in the file order.
+        static_cast<void>(madvise(data, st.st_size, MADV_SEQUENTIAL));
+        data_ = static_cast<const uint8_t*>(data);
+        size_ = static_cast<size_t>(st.st_size);
+    }
+
+    /// @brief Destructor.
+    ~MappedFile() {
+        if (data_) {
+            static_cast<void>(munmap(const_cast<uint8_t*>(data_), size_));
+        }
+        if (fd_ >= 0) {
+            static_cast<void>(::close(fd_));
+        }
+    }
+
+    /// @brief Checks if the file was opened.
+    bool isOpen() const {
+        return (fd_ >= 0);
+    }
+
+    /// @brief Returns the mapped content or null.
+    const uint8_t* getData() const {
+        return (data_);
+    }
+
+    /// @brief Returns the size of the mapped content.
+    size_t getSize() const {
+        return (size_);
+    }
+
+private:
+
+    /// @brief File descriptor or -1.
+    int fd_;
+
+    /// @brief Mapped content or null.
+    const uint8_t* data_;
+
+    /// @brief Size of the mapped content.
+    size_t size_;
+};
+
+} // end of anonymous namespace
+
+namespace isc {
+namespace dhcp {
+
+const uint8_t Lease4SnapshotFile::FORMAT_VERSION;
+
+Lease4SnapshotFile::Lease4SnapshotFile(const std::string& filename,
+                                       const std::vector<std::string>& sources)
+    : filename_(filename), sources_(sources), read_msg_() {
+}
+
+void
+Lease4SnapshotFile::writeFingerprints(OutputBuffer& buf) const {
+    buf.writeData(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    buf.writeUint8(FORMAT_VERSION);
+    buf.writeUint8(static_cast<uint8_t>(sources_.size()));
+    for (auto const& source : sources_) {
+        struct stat st;
+        if (stat(source.c_str(), &st) != 0) {
+            buf.writeUint8(0);
+            writeUint64(buf, 0);
+            writeUint64(buf, 0);
+            writeUint64(buf, 0);
+            continue;
+        }
+        buf.writeUint8(1);
+        writeUint64(buf, static_cast<uint64_t>(st.st_ino));
+        writeUint64(buf, static_cast<uint64_t>(st.st_size));
+        writeUint64(buf, static_cast<uint64_t>(st.st_mtime));
+    }
+}
+
+void
+Lease4SnapshotFile::write(const Lease4Storage& storage) const {
+    std::string tmp_filename = filename_ + ".tmp";
+    {
+        std::ofstream os(tmp_filename.c_str(),
+                         std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!os.is_open()) {
+            isc_throw(Unexpected, "unable to open '" << tmp_filename << "'");
+        }
+
+        OutputBuffer buf(WRITE_CHUNK_SIZE);
+        writeFingerprints(buf);
+        buf.writeUint32(static_cast<uint32_t>(storage.size()));
+        OutputBuffer payload(128);
+        for (auto const& lease : storage) {
+            payload.clear();
+            LeaseJournal4::encode(*lease, payload);
+            buf.writeUint32(static_cast<uint32_t>(payload.getLength()));
+            buf.writeData(payload.getData(), payload.getLength());
+            if (buf.getLength() >= WRITE_CHUNK_SIZE) {
+                os.write(static_cast<const char*>(buf.getData()),
+                         buf.getLength());
+                buf.clear();
+            }
+        }
+        os.write(static_cast<const char*>(buf.getData()), buf.getLength());
+        os.close();
+        if (os.fail()) {
+            static_cast<void>(::remove(tmp_filename.c_str()));
+            isc_throw(Unexpected, "unable to write '" << tmp_filename << "'");
+        }
+    }
+    if (rename(tmp_filename.c_str(), filename_.c_str()) != 0) {
+        char const* reason = strerror(errno);
+        static_cast<void>(::remove(tmp_filename.c_str()));
+        isc_throw(Unexpected, "unable to rename '" << tmp_filename << "' to '"
+                  << filename_ << "': " << reason);
+    }
+}
+
+bool
+Lease4SnapshotFile::read(Lease4Storage& storage) {
+    storage.clear();
+    read_msg_.clear();
+
+    MappedFile file(filename_);
+    if (!file.isOpen()) {
+        read_msg_ = "no such file";
+        return (false);
+    }
+    if (!file.getData()) {
+        read_msg_ = "unable to map the file";
+        return (false);
+    }
+
+    // The fingerprints of the source lease files must be the same as
+    // when the snapshot was written.
+    OutputBuffer expected(0);
+    writeFingerprints(expected);
+    if ((file.getSize() < expected.getLength()) ||
+        (memcmp(file.getData(), expected.getData(), expected.getLength()) != 0)) {
+        read_msg_ = "the lease files were modified";
+        return (false);
+    }
+
+    try {
+        InputBuffer buf(file.getData(), file.getSize());
+        buf.setPosition(expected.getLength());
+        uint32_t count = buf.readUint32();
+        for (uint32_t i = 0; i < count; ++i) {
+            size_t len = buf.readUint32();
+            if (len > buf.getLength() - buf.getPosition()) {
+                isc_throw(BadValue, "truncated lease");
+            }
+            Lease4Ptr lease = LeaseJournal4::decode(file.getData() +
+                                                    buf.getPosition(), len);
+            buf.setPosition(buf.getPosition() + len);
+            if (!storage.insert(lease).second) {
+                isc_throw(BadValue, "duplicate lease "
+                          << lease->addr_.toText());
+            }
+        }
+        if (buf.getPosition() != buf.getLength()) {
+            isc_throw(BadValue, "trailing data");
+        }
+    } catch (const std::exception& ex) {
+        storage.clear();
+        read_msg_ = std::string("invalid content: ") + ex.what();
+        return (false);
+    }
+    return (true);
+}
+
+void
+Lease4SnapshotFile::remove() const {
+    static_cast<void>(::remove(filename_.c_str()));
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
@@ -0,0 +1,106 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE4_SNAPSHOT_FILE_H
+#define LEASE4_SNAPSHOT_FILE_H
+
+#include <dhcpsrv/memfile_lease_storage.h>
+#include <util/buffer.h>
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Binary file holding a snapshot of the DHCPv4 lease storage.
+///
+/// The memfile backend rebuilds the lease storage by parsing the
+/// lease files, their copy and their previous version, and by replaying
+/// the lease changes they record. This file saves the leases of the
+/// storage when the backend is closed so the next load can insert them
+/// directly instead. The lease files remain the durable log of the lease
+/// changes: the snapshot is only a cache of their content.
+///
+/// The snapshot is only valid for the lease files it was taken from.
+/// Like the @c Lease6ExtendedInfoFile it records the fingerprint, i.e.
+/// the inode, size and modification time, of each source lease file and
+/// it is discarded when a fingerprint does not match, e.g. after a crash
+/// leaving lease changes appended after the snapshot or after a lease file
+/// cleanup.
+///
+/// The file starts with the "KEAS" magic and the format version. It is
+/// followed by the fingerprints, the number of leases and the leases,
+/// each encoded as a payload of the @c LeaseJournal4 preceded by its 32
+/// bits length. All integers are stored in network byte order. The file
+/// is read through a read-only memory mapping so the leases are decoded
+/// in place, without copying the file content.
+class Lease4SnapshotFile {
+public:
+
+    /// @brief Version of the format of the file.
+    static const uint8_t FORMAT_VERSION = 1;
+
+    /// @brief Constructor.
+    ///
+    /// @param filename Name of the snapshot file.
+    /// @param sources Names of the lease files the snapshot is taken from.
+    Lease4SnapshotFile(const std::string& filename,
+                       const std::vector<std::string>& sources);
+
+    /// @brief Returns the name of the file.
+    std::string getFilename() const {
+        return (filename_);
+    }
+
+    /// @brief Writes the leases to the file.
+    ///
+    /// The leases are written to a temporary file which is renamed to
+    /// the file name, so an interrupted write does not leave a truncated
+    /// file.
+    ///
+    /// @param storage The lease storage.
+    /// @throw Unexpected if the file can't be written.
+    void write(const Lease4Storage& storage) const;
+
+    /// @brief Reads the leases from the file.
+    ///
+    /// This function is exception safe.
+    ///
+    /// @param [out] storage The lease storage.
+    /// @return true if the leases were restored, false if the file does
+    /// not exist, is invalid or does not match the source lease files.
+    /// The storage is cleared when false is returned.
+    bool read(Lease4Storage& storage);
+
+    /// @brief Removes the file.
+    void remove() const;
+
+    /// @brief Returns the reason why the last read failed.
+    std::string getReadMsg() const {
+        return (read_msg_);
+    }
+
+private:
+
+    /// @brief Writes the fingerprints of the source lease files.
+    ///
+    /// @param buf Output buffer.
+    void writeFingerprints(util::OutputBuffer& buf) const;
+
+    /// @brief Name of the file.
+    std::string filename_;
+
+    /// @brief Names of the source lease files.
+    std::vector<std::string> sources_;
+
+    /// @brief Reason why the last read failed.
+    std::string read_msg_;
+};
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // LEASE4_SNAPSHOT_FILE_H
@@ -0,0 +1,197 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcpsrv/lease6_extended_info_file.h>
+#include <exceptions/exceptions.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+using namespace isc::asiolink;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Magic bytes starting the file.
+const uint8_t EXTENDED_INFO_MAGIC[] = { 'K', 'E', 'A', 'X' };
+
+/// @brief Length of an IPv6 address.
+const size_t V6ADDRESS_LEN = 16;
+
+/// @brief Writes a 64 bits integer.
+void
+writeUint64(OutputBuffer& buf, uint64_t value) {
+    buf.writeUint32(static_cast<uint32_t>(value >> 32));
+    buf.writeUint32(static_cast<uint32_t>(value));
+}
+
+/// @brief Writes the entries of a table.
+///
+/// @tparam TableType Type of the extended info table.
+/// @param buf Output buffer.
+/// @param table The table.
+template<typename TableType>
+void
+writeEntries(OutputBuffer& buf, const TableType& table) {
+    buf.writeUint32(static_cast<uint32_t>(table.size()));
+    for (auto const& ex_info : table) {
+        if (!ex_info->lease_addr_.isV6() || (ex_info->id_.size() > 0xFFFF)) {
+            isc_throw(isc::BadValue, "invalid extended info entry for "
+                      << ex_info->lease_addr_.toText());
+        }
+        std::vector<uint8_t> addr = ex_info->lease_addr_.toBytes();
+        buf.writeData(&addr[0], addr.size());
+        buf.writeUint16(static_cast<uint16_t>(ex_info->id_.size()));
+        if (!ex_info->id_.empty()) {
+            buf.writeData(&ex_info->id_[0], ex_info->id_.size());
+        }
+    }
+}
+
+/// @brief Reads the entries of a table.
+///
+/// @tparam TableType Type of the extended info table.
+/// @param buf Input buffer.
+/// @param [out] table The table.
+template<typename TableType>
+void
+readEntries(InputBuffer& buf, TableType& table) {
+    uint32_t count = buf.readUint32();
+    uint8_t addr[V6ADDRESS_LEN];
+    for (uint32_t i = 0; i < count; ++i) {
+        buf.readData(addr, sizeof(addr));
+        std::vector<uint8_t> id;
+        buf.readVector(id, buf.readUint16());
+        isc::dhcp::Lease6ExtendedInfoPtr ex_info;
+        ex_info.reset(new isc::dhcp::Lease6ExtendedInfo(
+            IOAddress::fromBytes(AF_INET6, addr), id));
+        table.insert(ex_info);
+    }
+}
+
+} // end of anonymous namespace
+
+namespace isc {
+namespace dhcp {
+
+const uint8_t Lease6ExtendedInfoFile::FORMAT_VERSION;
+
+Lease6ExtendedInfoFile::Lease6ExtendedInfoFile(const std::string& filename,
+                                               const std::vector<std::string>& sources)
+    : filename_(filename), sources_(sources), read_msg_() {
+}
+
+void
+Lease6ExtendedInfoFile::writeFingerprints(OutputBuffer& buf) const {
+    buf.writeData(EXTENDED_INFO_MAGIC, sizeof(EXTENDED_INFO_MAGIC));
+    buf.writeUint8(FORMAT_VERSION);
+    buf.writeUint8(static_cast<uint8_t>(sources_.size()));
+    for (auto const& source : sources_) {
+        struct stat st;
+        if (stat(source.c_str(), &st) != 0) {
+            buf.writeUint8(0);
+            writeUint64(buf, 0);
+            writeUint64(buf, 0);
+            writeUint64(buf, 0);
+            continue;
+        }
+        buf.writeUint8(1);
+        writeUint64(buf, static_cast<uint64_t>(st.st_ino));
+        writeUint64(buf, static_cast<uint64_t>(st.st_size));
+        writeUint64(buf, static_cast<uint64_t>(st.st_mtime));
+    }
+}
+
+void
+Lease6ExtendedInfoFile::write(const Lease6ExtendedInfoRelayIdTable& relay_id6,
+                              const Lease6ExtendedInfoRemoteIdTable& remote_id6) const {
+    OutputBuffer buf(0);
+    writeFingerprints(buf);
+    writeEntries(buf, relay_id6);
+    writeEntries(buf, remote_id6);
+
+    std::string tmp_filename = filename_ + ".tmp";
+    {
+        std::ofstream os(tmp_filename.c_str(),
+                         std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!os.is_open()) {
+            isc_throw(Unexpected, "unable to open '" << tmp_filename << "'");
+        }
+        os.write(static_cast<const char*>(buf.getData()), buf.getLength());
+        os.close();
+        if (os.fail()) {
+            static_cast<void>(::remove(tmp_filename.c_str()));
+            isc_throw(Unexpected, "unable to write '" << tmp_filename << "'");
+        }
+    }
+    if (rename(tmp_filename.c_str(), filename_.c_str()) != 0) {
+        char const* reason = strerror(errno);
+        static_cast<void>(::remove(tmp_filename.c_str()));
+        isc_throw(Unexpected, "unable to rename '" << tmp_filename << "' to '"
+                  << filename_ << "': " << reason);
+    }
+}
+
+bool
+Lease6ExtendedInfoFile::read(Lease6ExtendedInfoRelayIdTable& relay_id6,
+                             Lease6ExtendedInfoRemoteIdTable& remote_id6) {
+    relay_id6.clear();
+    remote_id6.clear();
+    read_msg_.clear();
+
+    std::ifstream is(filename_.c_str(), std::ios::in | std::ios::binary);
+    if (!is.is_open()) {
+        read_msg_ = "no such file";
+        return (false);
+    }
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(is)),
+                                 std::istreambuf_iterator<char>());
+    if (is.bad()) {
+        read_msg_ = "unable to read the file";
+        return (false);
+    }
+
+    // The fingerprints of the source lease files must be the same as
+    // when the tables were written.
+    OutputBuffer expected(0);
+    writeFingerprints(expected);
+    if ((content.size() < expected.getLength()) ||
+        (memcmp(&content[0], expected.getData(), expected.getLength()) != 0)) {
+        read_msg_ = "the lease files were modified";
+        return (false);
+    }
+
+    try {
+        InputBuffer buf(&content[0], content.size());
+        buf.setPosition(expected.getLength());
+        readEntries(buf, relay_id6);
+        readEntries(buf, remote_id6);
+        if (buf.getPosition() != buf.getLength()) {
+            isc_throw(BadValue, "trailing data");
+        }
+    } catch (const std::exception& ex) {
+        relay_id6.clear();
+        remote_id6.clear();
+        read_msg_ = std::string("invalid content: ") + ex.what();
+        return (false);
+    }
+    return (true);
+}
+
+void
+Lease6ExtendedInfoFile::remove() const {
+    static_cast<void>(::remove(filename_.c_str()));
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
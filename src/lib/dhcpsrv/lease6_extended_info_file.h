@@ -0,0 +1,107 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE6_EXTENDED_INFO_FILE_H
+#define LEASE6_EXTENDED_INFO_FILE_H
+
+#include <dhcpsrv/memfile_lease_storage.h>
+#include <util/buffer.h>
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Binary file holding the DHCPv6 extended info tables.
+///
+/// The memfile backend builds the relay id and remote id tables used by
+/// the Bulk Lease Query from the user context of all the DHCPv6 leases
+/// when the lease file is loaded. This file saves the tables when the
+/// backend is closed so the next load can restore them instead of
+/// walking the user contexts again.
+///
+/// The tables are only valid for the lease files they were built from.
+/// The file records the fingerprint, i.e. the inode, size and
+/// modification time, of each source lease file. The saved tables are
+/// discarded when a fingerprint does not match, e.g. after a lease was
+/// appended or after a lease file cleanup.
+///
+/// The file starts with the "KEAX" magic and the format version. It is
+/// followed by the fingerprints, the relay id entries, the remote id
+/// entries and an end marker. Each entry holds the lease address (16
+/// bytes) and the identifier preceded by its 16 bits length. All integers
+/// are stored in network byte order.
+class Lease6ExtendedInfoFile {
+public:
+
+    /// @brief Version of the format of the file.
+    static const uint8_t FORMAT_VERSION = 1;
+
+    /// @brief Constructor.
+    ///
+    /// @param filename Name of the extended info tables file.
+    /// @param sources Names of the lease files the tables are built from.
+    Lease6ExtendedInfoFile(const std::string& filename,
+                           const std::vector<std::string>& sources);
+
+    /// @brief Returns the name of the file.
+    std::string getFilename() const {
+        return (filename_);
+    }
+
+    /// @brief Writes the tables to the file.
+    ///
+    /// The tables are written to a temporary file which is renamed to
+    /// the file name, so an interrupted write does not leave a truncated
+    /// file.
+    ///
+    /// @param relay_id6 The by-relay-id table.
+    /// @param remote_id6 The by-remote-id table.
+    /// @throw Unexpected if the file can't be written.
+    void write(const Lease6ExtendedInfoRelayIdTable& relay_id6,
+               const Lease6ExtendedInfoRemoteIdTable& remote_id6) const;
+
+    /// @brief Reads the tables from the file.
+    ///
+    /// This function is exception safe.
+    ///
+    /// @param [out] relay_id6 The by-relay-id table.
+    /// @param [out] remote_id6 The by-remote-id table.
+    /// @return true if the tables were restored, false if the file does
+    /// not exist, is invalid or does not match the source lease files.
+    /// The tables are cleared when false is returned.
+    bool read(Lease6ExtendedInfoRelayIdTable& relay_id6,
+              Lease6ExtendedInfoRemoteIdTable& remote_id6);
+
+    /// @brief Removes the file.
+    void remove() const;
+
+    /// @brief Returns the reason why the last read failed.
+    std::string getReadMsg() const {
+        return (read_msg_);
+    }
+
+private:
+
+    /// @brief Writes the fingerprints of the source lease files.
+    ///
+    /// @param buf Output buffer.
+    void writeFingerprints(util::OutputBuffer& buf) const;
+
+    /// @brief Name of the file.
+    std::string filename_;
+
+    /// @brief Names of the source lease files.
+    std::vector<std::string> sources_;
+
+    /// @brief Reason why the last read failed.
+    std::string read_msg_;
+};
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // LEASE6_EXTENDED_INFO_FILE_H
@@ -0,0 +1,172 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/lease_affinity.h>
+#include <util/hash.h>
+#include <util/multi_threading_mgr.h>
+
+#include <vector>
+
+using namespace isc::asiolink;
+using namespace isc::util;
+using namespace std;
+
+namespace {
+
+/// @brief The minimum size of the index triggering a sweep.
+const size_t MIN_SWEEP_SIZE = 1024;
+
+/// @brief Tags of the hashed identifiers.
+const uint8_t CLIENT_ID_TAG = 1;
+const uint8_t HWADDR_TAG = 2;
+
+}
+
+namespace isc {
+namespace dhcp {
+
+LeaseAffinity4::LeaseAffinity4()
+    : entries_(), sweep_size_(MIN_SWEEP_SIZE), size_(0), mutex_() {
+}
+
+uint64_t
+LeaseAffinity4::hashClientId(const ClientId& client_id) {
+    const vector<uint8_t>& id = client_id.getClientId();
+    vector<uint8_t> data;
+    data.reserve(id.size() + 1);
+    data.push_back(CLIENT_ID_TAG);
+    data.insert(data.end(), id.begin(), id.end());
+    return (Hash64::hash(&data[0], data.size()));
+}
+
+uint64_t
+LeaseAffinity4::hashHWAddr(const HWAddr& hwaddr) {
+    vector<uint8_t> data;
+    data.reserve(hwaddr.hwaddr_.size() + 3);
+    data.push_back(HWADDR_TAG);
+    data.push_back(static_cast<uint8_t>(hwaddr.htype_ >> 8));
+    data.push_back(static_cast<uint8_t>(hwaddr.htype_));
+    data.insert(data.end(), hwaddr.hwaddr_.begin(), hwaddr.hwaddr_.end());
+    return (Hash64::hash(&data[0], data.size()));
+}
+
+void
+LeaseAffinity4::add(const Lease4& lease, uint32_t period) {
+    bool has_client_id = lease.client_id_ &&
+        !lease.client_id_->getClientId().empty();
+    bool has_hwaddr = lease.hwaddr_ && !lease.hwaddr_->hwaddr_.empty();
+    if (!has_client_id && !has_hwaddr) {
+        return;
+    }
+    time_t now = time(0);
+    Entry entry{ lease.addr_.toUint32(), lease.subnet_id_, now + period };
+
+    MultiThreadingLock lock(mutex_);
+    if (has_client_id) {
+        entries_[hashClientId(*lease.client_id_)] = entry;
+    }
+    if (has_hwaddr) {
+        entries_[hashHWAddr(*lease.hwaddr_)] = entry;
+    }
+    if (entries_.size() >= sweep_size_) {
+        sweep(now);
+    }
+    size_ = entries_.size();
+}
+
+const LeaseAffinity4::Entry*
+LeaseAffinity4::find(uint64_t key, time_t now) {
+    auto entry = entries_.find(key);
+    if (entry == entries_.end()) {
+        return (0);
+    }
+    if (entry->second.expire_ <= now) {
+        entries_.erase(entry);
+        size_ = entries_.size();
+        return (0);
+    }
+    return (&entry->second);
+}
+
+IOAddress
+LeaseAffinity4::get(const ClientIdPtr& client_id, const HWAddrPtr& hwaddr,
+                    SubnetID& subnet_id) {
+    if (size_ == 0) {
+        return (IOAddress::IPV4_ZERO_ADDRESS());
+    }
+    // Compute the hashes before taking the lock.
+    bool has_client_id = client_id && !client_id->getClientId().empty();
+    bool has_hwaddr = hwaddr && !hwaddr->hwaddr_.empty();
+    uint64_t client_id_key = (has_client_id ? hashClientId(*client_id) : 0);
+    uint64_t hwaddr_key = (has_hwaddr ? hashHWAddr(*hwaddr) : 0);
+    time_t now = time(0);
+
+    MultiThreadingLock lock(mutex_);
+    const Entry* entry = 0;
+    if (has_client_id) {
+        entry = find(client_id_key, now);
+    }
+    if (!entry && has_hwaddr) {
+        entry = find(hwaddr_key, now);
+    }
+    if (!entry) {
+        return (IOAddress::IPV4_ZERO_ADDRESS());
+    }
+    subnet_id = entry->subnet_id_;
+    return (IOAddress(entry->address_));
+}
+
+void
+LeaseAffinity4::remove(const ClientIdPtr& client_id, const HWAddrPtr& hwaddr) {
+    if (size_ == 0) {
+        return;
+    }
+    bool has_client_id = client_id && !client_id->getClientId().empty();
+    bool has_hwaddr = hwaddr && !hwaddr->hwaddr_.empty();
+    uint64_t client_id_key = (has_client_id ? hashClientId(*client_id) : 0);
+    uint64_t hwaddr_key = (has_hwaddr ? hashHWAddr(*hwaddr) : 0);
+
+    MultiThreadingLock lock(mutex_);
+    if (has_client_id) {
+        entries_.erase(client_id_key);
+    }
+    if (has_hwaddr) {
+        entries_.erase(hwaddr_key);
+    }
+    size_ = entries_.size();
+}
+
+void
+LeaseAffinity4::sweep(time_t now) {
+    for (auto entry = entries_.begin(); entry != entries_.end(); ) {
+        if (entry->second.expire_ <= now) {
+            entry = entries_.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+    // The next sweep happens when the index doubled in size so the cost
+    // of the sweeps is amortized over the additions.
+    sweep_size_ = max(MIN_SWEEP_SIZE, 2 * entries_.size());
+}
+
+void
+LeaseAffinity4::clear() {
+    MultiThreadingLock lock(mutex_);
+    entries_.clear();
+    sweep_size_ = MIN_SWEEP_SIZE;
+    size_ = 0;
+}
+
+size_t
+LeaseAffinity4::size() const {
+    return (size_);
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
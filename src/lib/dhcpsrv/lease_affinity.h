@@ -0,0 +1,137 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_AFFINITY_H
+#define LEASE_AFFINITY_H
+
+#include <asiolink/io_address.h>
+#include <dhcp/duid.h>
+#include <dhcp/hwaddr.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/subnet_id.h>
+
+#include <boost/noncopyable.hpp>
+#include <atomic>
+#include <ctime>
+#include <mutex>
+#include <unordered_map>
+
+#include <stdint.h>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Compact in-memory index of the reclaimed IPv4 leases.
+///
+/// The lease affinity relies on the reclaimed leases kept in the lease
+/// database for @c hold-reclaimed-time seconds. The index remembers for
+/// each reclaimed lease only the hash of the client identifier and of
+/// the hardware address, the address, the subnet and the end of the
+/// affinity period, so a returning client can be offered its previous
+/// address after the full lease record was removed.
+///
+/// The index only gives hints: a hash collision or an address assigned
+/// to another client in the meantime is caught by the allocation engine
+/// which checks the lease database before offering the address. The
+/// expired entries are removed at lookup and by a sweep when the index
+/// doubles in size. The index is thread safe.
+class LeaseAffinity4 : public boost::noncopyable {
+public:
+
+    /// @brief Constructor.
+    LeaseAffinity4();
+
+    /// @brief Remembers the address of a reclaimed lease.
+    ///
+    /// The leases without a client identifier nor a hardware address
+    /// are ignored.
+    ///
+    /// @param lease the reclaimed lease.
+    /// @param period the affinity period in seconds from now.
+    void add(const Lease4& lease, uint32_t period);
+
+    /// @brief Looks for the previous address of a client.
+    ///
+    /// @param client_id the client identifier or null.
+    /// @param hwaddr the hardware address or null.
+    /// @param [out] subnet_id set to the subnet of the address.
+    /// @return the previous address or the zero address when none.
+    asiolink::IOAddress get(const ClientIdPtr& client_id,
+                            const HWAddrPtr& hwaddr,
+                            SubnetID& subnet_id);
+
+    /// @brief Forgets the previous address of a client.
+    ///
+    /// @param client_id the client identifier or null.
+    /// @param hwaddr the hardware address or null.
+    void remove(const ClientIdPtr& client_id, const HWAddrPtr& hwaddr);
+
+    /// @brief Removes all the entries.
+    void clear();
+
+    /// @brief Returns the number of entries in the index.
+    size_t size() const;
+
+private:
+
+    /// @brief A reclaimed lease.
+    struct Entry {
+        /// @brief The address.
+        uint32_t address_;
+
+        /// @brief The subnet of the address.
+        SubnetID subnet_id_;
+
+        /// @brief The end of the affinity period.
+        time_t expire_;
+    };
+
+    /// @brief Returns the hash of a client identifier.
+    ///
+    /// @param client_id the client identifier.
+    /// @return the hash.
+    static uint64_t hashClientId(const ClientId& client_id);
+
+    /// @brief Returns the hash of a hardware address.
+    ///
+    /// @param hwaddr the hardware address.
+    /// @return the hash.
+    static uint64_t hashHWAddr(const HWAddr& hwaddr);
+
+    /// @brief Looks for a key.
+    ///
+    /// Must be called with the mutex held. An expired entry is removed.
+    ///
+    /// @param key the hash of a client identifier or a hardware address.
+    /// @param now the current time.
+    /// @return the entry or null when none.
+    const Entry* find(uint64_t key, time_t now);
+
+    /// @brief Removes the expired entries.
+    ///
+    /// Must be called with the mutex held.
+    ///
+    /// @param now the current time.
+    void sweep(time_t now);
+
+    /// @brief The entries by the hash of the client identifier or of the
+    /// hardware address.
+    std::unordered_map<uint64_t, Entry> entries_;
+
+    /// @brief The size triggering the next sweep.
+    size_t sweep_size_;
+
+    /// @brief Number of entries, read without the mutex.
+    std::atomic<size_t> size_;
+
+    /// @brief The mutex protecting the entries.
+    std::mutex mutex_;
+};
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // LEASE_AFFINITY_H
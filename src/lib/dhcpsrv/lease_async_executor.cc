@@ -0,0 +1,100 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcpsrv/lease_async_executor.h>
+#include <exceptions/exceptions.h>
+#include <boost/make_shared.hpp>
+
+using namespace isc::asiolink;
+
+namespace isc {
+namespace dhcp {
+
+LeaseAsyncExecutor::LeaseAsyncExecutor(uint32_t thread_count)
+    : thread_count_(thread_count), pool_(), waiting_(), pending_(0),
+      stopped_(false) {
+    pool_.start(thread_count);
+}
+
+LeaseAsyncExecutor::~LeaseAsyncExecutor() {
+    stop();
+}
+
+void
+LeaseAsyncExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_) {
+            return;
+        }
+        // The operations pushed from now on are executed by the caller.
+        stopped_ = true;
+    }
+    wait();
+    pool_.stop();
+}
+
+void
+LeaseAsyncExecutor::push(const IOAddress& address, const Operation& operation) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!stopped_) {
+            ++pending_;
+            auto it = waiting_.find(address);
+            if (it != waiting_.end()) {
+                // Wait for the previous operation on the address.
+                it->second.push_back(operation);
+                return;
+            }
+            waiting_[address];
+            schedule(address, operation);
+            return;
+        }
+    }
+    // The threads are gone: the caller executes the operation.
+    operation();
+}
+
+void
+LeaseAsyncExecutor::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return (pending_ == 0); });
+}
+
+size_t
+LeaseAsyncExecutor::getPending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (pending_);
+}
+
+void
+LeaseAsyncExecutor::run(const IOAddress& address, const Operation& operation) {
+    operation();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    --pending_;
+    auto it = waiting_.find(address);
+    if (it != waiting_.end()) {
+        if (it->second.empty()) {
+            waiting_.erase(it);
+        } else {
+            Operation next = it->second.front();
+            it->second.pop_front();
+            schedule(address, next);
+        }
+    }
+    cv_.notify_all();
+}
+
+void
+LeaseAsyncExecutor::schedule(const IOAddress& address, const Operation& operation) {
+    pool_.add(boost::make_shared<std::function<void()>>(
+        std::bind(&LeaseAsyncExecutor::run, this, address, operation)));
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
@@ -0,0 +1,122 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_ASYNC_EXECUTOR_H
+#define LEASE_ASYNC_EXECUTOR_H
+
+#include <asiolink/io_address.h>
+#include <util/thread_pool.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Executes the asynchronous lease operations.
+///
+/// The operations are executed by a pool of threads owned by the lease
+/// manager so the packet processing threads don't wait for the database.
+/// The operations on the same address are executed in the order they were
+/// pushed, one at a time: an operation waits in a per address queue while
+/// a previous operation on the address is executed.
+class LeaseAsyncExecutor : public boost::noncopyable {
+public:
+
+    /// @brief Operation on a lease.
+    typedef std::function<void()> Operation;
+
+    /// @brief Constructor.
+    ///
+    /// Starts the threads.
+    ///
+    /// @param thread_count Number of threads.
+    /// @throw InvalidParameter if the thread count is 0.
+    explicit LeaseAsyncExecutor(uint32_t thread_count);
+
+    /// @brief Destructor.
+    ///
+    /// Executes the pending operations and stops the threads.
+    ~LeaseAsyncExecutor();
+
+    /// @brief Executes the pending operations and stops the threads.
+    ///
+    /// The operations pushed after this call are executed by the caller.
+    void stop();
+
+    /// @brief Pushes an operation.
+    ///
+    /// @param address Address of the lease.
+    /// @param operation The operation. It must not throw.
+    void push(const asiolink::IOAddress& address, const Operation& operation);
+
+    /// @brief Waits until all the pushed operations are executed.
+    void wait();
+
+    /// @brief Returns the number of operations not yet executed.
+    size_t getPending() const;
+
+    /// @brief Returns the number of threads.
+    uint32_t getThreadCount() const {
+        return (thread_count_);
+    }
+
+private:
+
+    /// @brief Executes an operation and schedules the next operation on
+    /// the same address.
+    ///
+    /// @param address Address of the lease.
+    /// @param operation The operation.
+    void run(const asiolink::IOAddress& address, const Operation& operation);
+
+    /// @brief Schedules an operation on the thread pool.
+    ///
+    /// @param address Address of the lease.
+    /// @param operation The operation.
+    void schedule(const asiolink::IOAddress& address, const Operation& operation);
+
+    /// @brief Type of the thread pool.
+    typedef util::ThreadPool<std::function<void()>> ThreadPool;
+
+    /// @brief Number of threads.
+    uint32_t thread_count_;
+
+    /// @brief The thread pool.
+    ThreadPool pool_;
+
+    /// @brief Operations waiting for a previous operation on the same
+    /// address by address.
+    ///
+    /// An address is in the map while an operation on it is scheduled.
+    std::map<asiolink::IOAddress, std::deque<Operation>> waiting_;
+
+    /// @brief Number of operations not yet executed.
+    size_t pending_;
+
+    /// @brief Indicates that the threads were stopped.
+    bool stopped_;
+
+    /// @brief Mutex protecting the queues.
+    mutable std::mutex mutex_;
+
+    /// @brief Condition signaled when an operation was executed.
+    std::condition_variable cv_;
+};
+
+/// @brief Pointer to a @c LeaseAsyncExecutor.
+typedef boost::shared_ptr<LeaseAsyncExecutor> LeaseAsyncExecutorPtr;
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // LEASE_ASYNC_EXECUTOR_H
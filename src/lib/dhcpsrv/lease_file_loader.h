@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,14 +7,22 @@
 #ifndef LEASE_FILE_LOADER_H
 #define LEASE_FILE_LOADER_H
 
+#include <dhcpsrv/cfgmgr.h>
 #include <dhcpsrv/dhcpsrv_log.h>
 #include <dhcpsrv/memfile_lease_storage.h>
 #include <util/versioned_csv_file.h>
 #include <dhcpsrv/sanity_checker.h>
+#include <util/thread_pool.h>
 
+#include <boost/make_shared.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
 namespace isc {
 namespace dhcp {
 
@@ -67,8 +75,16 @@ public:
     /// One case when the file is not opened is when the server starts
     /// up, reads the leases in the file and then leaves the file open
     /// for writing future lease updates.
+    /// @param threads Number of threads parsing the rows of the lease file.
+    /// When it is greater than 1, the file is read by the calling thread
+    /// in chunks of rows which are parsed by a thread pool, while the
+    /// leases are inserted into the storage by the calling thread in the
+    /// order of the rows, so the last entry for a lease still wins.
+    /// The leases are sanity checked by the thread pool too.
+    /// The default value of 1 parses the rows by the calling thread.
     /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
-    /// @tparam LeaseFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam LeaseFileType A @c CSVLeaseFile4, @c CSVLeaseFile6,
+    /// @c LeaseJournal4 or @c LeaseJournal6.
     /// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
     ///
     /// @throw isc::util::CSVFileError when the maximum number of errors
@@ -77,7 +93,8 @@ public:
              typename StorageType>
     static void load(LeaseFileType& lease_file, StorageType& storage,
                      const uint32_t max_errors = 0,
-                     const bool close_file_on_exit = true) {
+                     const bool close_file_on_exit = true,
+                     const size_t threads = 1) {
 
         LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_LEASE_FILE_LOAD)
             .arg(lease_file.getFilename());
@@ -92,84 +109,36 @@ public:
         if (SanityChecker::leaseCheckingEnabled(false)) {
             // Since lease file is loaded during the configuration,
             // we have to use staging config, rather than current
-            // config for this (false = staging).
-            lease_checker.reset(new SanityChecker());
+            // config for this. It is given to the checker so the
+            // leases can be checked by the parsing threads.
+            lease_checker.reset(new SanityChecker(CfgMgr::instance().getStagingCfg()));
         }
 
-        boost::shared_ptr<LeaseObjectType> lease;
-        // Track the number of corrupted leases.
-        uint32_t errcnt = 0;
-        while (true) {
-            // Unable to parse the lease.
-            if (!lease_file.next(lease)) {
-                LOG_ERROR(dhcpsrv_logger, DHCPSRV_MEMFILE_LEASE_LOAD_ROW_ERROR)
-                            .arg(lease_file.getReads())
-                            .arg(lease_file.getReadMsg());
-
-                // A value of 0 indicates that we don't return
-                // until the whole file is parsed, even if errors occur.
-                // Otherwise, check if we have exceeded the maximum number
-                // of errors and throw an exception if we have.
-                if (max_errors && (++errcnt > max_errors)) {
-                    // If we break parsing the CSV file because of too many
-                    // errors, it doesn't make sense to keep the file open.
-                    // This is because the caller wouldn't know where we
-                    // stopped parsing and where the internal file pointer
-                    // is. So, there are probably no cases when the caller
-                    // would continue to use the open file.
-                    lease_file.close();
-                    isc_throw(util::CSVFileError, "exceeded maximum number of"
-                              " failures " << max_errors << " to read a lease"
-                              " from the lease file "
-                              << lease_file.getFilename());
+        if (threads > 1) {
+            loadInParallel<LeaseObjectType>(lease_file, storage, max_errors,
+                                            lease_checker.get(), threads);
+        } else {
+            boost::shared_ptr<LeaseObjectType> lease;
+            // Track the number of corrupted leases.
+            uint32_t errcnt = 0;
+            while (true) {
+                // Unable to parse the lease.
+                if (!lease_file.next(lease)) {
+                    handleRowError(lease_file, lease_file.getReads(),
+                                   lease_file.getReadMsg(), errcnt,
+                                   max_errors);
+                    // Skip the corrupted lease.
+                    continue;
                 }
-                // Skip the corrupted lease.
-                continue;
-            }
 
-            // Lease was found and we successfully parsed it.
-            if (lease) {
-                LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL_DATA,
-                          DHCPSRV_MEMFILE_LEASE_LOAD)
-                    .arg(lease->toText());
-
-                if (lease_checker)  {
-                    // If the lease is insane the checker will reset the lease pointer.
-                    // As lease file is loaded during the configuration, we have
-                    // to use staging config, rather than current config for this
-                    // (false = staging).
-                    lease_checker->checkLease(lease, false);
-                    if (!lease) {
-                        continue;
-                    }
+                // Being here with no lease means that we hit the end of file.
+                if (!lease) {
+                    break;
                 }
 
-                // Check if this lease exists.
-                typename StorageType::iterator lease_it =
-                    storage.find(lease->addr_);
-                // The lease doesn't exist yet. Insert the lease if
-                // it has a positive valid lifetime.
-                if (lease_it == storage.end()) {
-                    if (lease->valid_lft_ > 0) {
-                        storage.insert(lease);
-                    }
-                } else {
-                    // The lease exists. If the new entry has a valid
-                    // lifetime of 0 it is an indication to remove the
-                    // existing entry. Otherwise, we update the lease.
-                    if (lease->valid_lft_ == 0) {
-                        storage.erase(lease_it);
-
-                    } else {
-                        // Use replace to re-index leases on update.
-                        storage.replace(lease_it, lease);
-                    }
-                }
-
-            } else {
-                // Being here means that we hit the end of file.
-                break;
-
+                // Lease was found and we successfully parsed it.
+                storeLease(lease, storage, lease_checker.get());
+                logProgress(lease_file, lease_file.getReads());
             }
         }
 
@@ -212,7 +181,8 @@ public:
     /// should be written.
     ///
     /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
-    /// @tparam LeaseFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam LeaseFileType A @c CSVLeaseFile4, @c CSVLeaseFile6,
+    /// @c LeaseJournal4 or @c LeaseJournal6.
     /// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
     template<typename LeaseObjectType, typename LeaseFileType,
              typename StorageType>
@@ -238,6 +208,309 @@ public:
         // Close the file
         lease_file.close();
     }
+
+    /// @brief Number of rows read between the progress log messages.
+    static const uint32_t PROGRESS_ROWS = 1000000;
+
+    /// @brief Number of rows parsed by one work item of the thread pool.
+    static const size_t CHUNK_ROWS = 1024;
+
+private:
+
+    /// @brief Row of the lease file and the lease parsed from it.
+    ///
+    /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+    /// @tparam RowType A @c util::CSVRow or a lease journal record.
+    template<typename LeaseObjectType, typename RowType>
+    struct ParsedRow {
+        /// @brief Row of the lease file.
+        RowType row_;
+
+        /// @brief Number of the row used in the log messages.
+        uint32_t row_number_;
+
+        /// @brief Indicates if the row has been read successfully.
+        bool read_;
+
+        /// @brief Lease parsed from the row or null on error.
+        boost::shared_ptr<LeaseObjectType> lease_;
+
+        /// @brief Error message when the row couldn't be read or parsed.
+        std::string error_;
+
+        /// @brief Indicates that the lease was discarded by the sanity
+        /// checker.
+        bool discarded_;
+    };
+
+    /// @brief Logs a corrupted row and checks the number of errors.
+    ///
+    /// @param lease_file A reference to the lease file.
+    /// @param row_number Number of the corrupted row.
+    /// @param error Error message.
+    /// @param [in,out] errcnt Number of corrupted rows.
+    /// @param max_errors Maximum number of corrupted rows or 0 if there
+    /// is no limit.
+    /// @tparam LeaseFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    ///
+    /// @throw isc::util::CSVFileError when the maximum number of errors
+    /// has been exceeded.
+    template<typename LeaseFileType>
+    static void handleRowError(LeaseFileType& lease_file,
+                               const uint32_t row_number,
+                               const std::string& error,
+                               uint32_t& errcnt,
+                               const uint32_t max_errors) {
+        LOG_ERROR(dhcpsrv_logger, DHCPSRV_MEMFILE_LEASE_LOAD_ROW_ERROR)
+            .arg(row_number)
+            .arg(error);
+
+        // A value of 0 indicates that we don't return
+        // until the whole file is parsed, even if errors occur.
+        // Otherwise, check if we have exceeded the maximum number
+        // of errors and throw an exception if we have.
+        if (max_errors && (++errcnt > max_errors)) {
+            // If we break parsing the CSV file because of too many
+            // errors, it doesn't make sense to keep the file open.
+            // This is because the caller wouldn't know where we
+            // stopped parsing and where the internal file pointer
+            // is. So, there are probably no cases when the caller
+            // would continue to use the open file.
+            lease_file.close();
+            isc_throw(util::CSVFileError, "exceeded maximum number of"
+                      " failures " << max_errors << " to read a lease"
+                      " from the lease file "
+                      << lease_file.getFilename());
+        }
+    }
+
+    /// @brief Logs the loading progress periodically.
+    ///
+    /// @param lease_file A reference to the lease file.
+    /// @param row_number Number of the last processed row.
+    /// @tparam LeaseFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    template<typename LeaseFileType>
+    static void logProgress(const LeaseFileType& lease_file,
+                            const uint32_t row_number) {
+        if ((row_number % PROGRESS_ROWS) == 0) {
+            LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_LEASE_FILE_LOAD_PROGRESS)
+                .arg(row_number)
+                .arg(lease_file.getFilename());
+        }
+    }
+
+    /// @brief Inserts, replaces or removes a lease read from the file.
+    ///
+    /// @param lease Pointer to the lease. It may be reset by the sanity
+    /// checker.
+    /// @param storage A reference to the container to which leases
+    /// should be inserted.
+    /// @param lease_checker Pointer to the sanity checker or null if
+    /// the leases are not checked.
+    /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+    /// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
+    template<typename LeaseObjectType, typename StorageType>
+    static void storeLease(boost::shared_ptr<LeaseObjectType>& lease,
+                           StorageType& storage,
+                           SanityChecker* lease_checker) {
+        LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL_DATA,
+                  DHCPSRV_MEMFILE_LEASE_LOAD)
+            .arg(lease->toText());
+
+        if (lease_checker)  {
+            // If the lease is insane the checker will reset the lease pointer.
+            // As lease file is loaded during the configuration, we have
+            // to use staging config, rather than current config for this
+            // (false = staging).
+            lease_checker->checkLease(lease, false);
+            if (!lease) {
+                return;
+            }
+        }
+
+        // Check if this lease exists.
+        typename StorageType::iterator lease_it =
+            storage.find(lease->addr_);
+        // The lease doesn't exist yet. Insert the lease if
+        // it has a positive valid lifetime.
+        if (lease_it == storage.end()) {
+            if (lease->valid_lft_ > 0) {
+                storage.insert(lease);
+            }
+        } else {
+            // The lease exists. If the new entry has a valid
+            // lifetime of 0 it is an indication to remove the
+            // existing entry. Otherwise, we update the lease.
+            if (lease->valid_lft_ == 0) {
+                storage.erase(lease_it);
+            } else {
+                // Use replace to re-index leases on update.
+                storage.replace(lease_it, lease);
+            }
+        }
+    }
+
+    /// @brief Reads a batch of rows from the lease file.
+    ///
+    /// @param lease_file A reference to the lease file.
+    /// @param [out] rows Rows read from the file.
+    /// @param count Maximum number of rows to read.
+    /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+    /// @tparam LeaseFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    ///
+    /// @return false if the end of file has been reached.
+    template<typename LeaseObjectType, typename LeaseFileType>
+    static bool readRows(LeaseFileType& lease_file,
+                         std::vector<ParsedRow<LeaseObjectType,
+                                               typename LeaseFileType::RowType> >& rows,
+                         const size_t count) {
+        typedef ParsedRow<LeaseObjectType, typename LeaseFileType::RowType> Row;
+        rows.clear();
+        rows.reserve(count);
+        while (rows.size() < count) {
+            rows.push_back(Row());
+            Row& parsed = rows.back();
+            parsed.read_ = lease_file.nextRow(parsed.row_);
+            parsed.row_number_ = lease_file.getReads();
+            parsed.discarded_ = false;
+            if (!parsed.read_) {
+                parsed.error_ = lease_file.getReadMsg();
+            } else if (parsed.row_ == LeaseFileType::EMPTY_ROW()) {
+                // The empty row signals EOF.
+                rows.pop_back();
+                return (false);
+            }
+        }
+        return (true);
+    }
+
+    /// @brief Parses and checks a range of rows.
+    ///
+    /// It is called by the thread pool, so it only modifies the rows.
+    /// The sanity checks depend only on the lease and the configuration,
+    /// so they are done here rather than when the lease is stored.
+    ///
+    /// @param lease_file A reference to the lease file.
+    /// @param begin Iterator pointing to the first row.
+    /// @param end Iterator pointing past the last row.
+    /// @param lease_checker Pointer to the sanity checker or null if
+    /// the leases are not checked. It is copied so the threads don't
+    /// share its cache.
+    /// @tparam LeaseFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam IteratorType Iterator of the vector of rows.
+    template<typename LeaseFileType, typename IteratorType>
+    static void parseRows(const LeaseFileType& lease_file,
+                          IteratorType begin, IteratorType end,
+                          const SanityChecker* lease_checker) {
+        boost::scoped_ptr<SanityChecker> checker;
+        if (lease_checker) {
+            checker.reset(new SanityChecker(*lease_checker));
+        }
+        for (IteratorType it = begin; it != end; ++it) {
+            if (!it->read_) {
+                continue;
+            }
+            try {
+                it->lease_ = lease_file.parse(it->row_);
+                if (checker && it->lease_) {
+                    // If the lease is insane the checker will reset
+                    // the lease pointer.
+                    checker->checkLease(it->lease_, false);
+                    it->discarded_ = !it->lease_;
+                }
+            } catch (const std::exception& ex) {
+                it->error_ = ex.what();
+            }
+        }
+    }
+
+    /// @brief Loads leases from the lease file using a thread pool.
+    ///
+    /// While the thread pool parses a batch of rows, the calling thread
+    /// reads the next batch from the file and then stores the leases
+    /// of the parsed batch.
+    ///
+    /// @param lease_file A reference to the open lease file.
+    /// @param storage A reference to the container to which leases
+    /// should be inserted.
+    /// @param max_errors Maximum number of corrupted leases in the
+    /// lease file or 0 if there is no limit.
+    /// @param lease_checker Pointer to the sanity checker or null if
+    /// the leases are not checked.
+    /// @param threads Number of threads parsing the rows.
+    /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+    /// @tparam LeaseFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
+    ///
+    /// @throw isc::util::CSVFileError when the maximum number of errors
+    /// has been exceeded.
+    template<typename LeaseObjectType, typename LeaseFileType,
+             typename StorageType>
+    static void loadInParallel(LeaseFileType& lease_file, StorageType& storage,
+                               const uint32_t max_errors,
+                               SanityChecker* lease_checker,
+                               const size_t threads) {
+        LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_LEASE_FILE_LOAD_PARALLEL)
+            .arg(lease_file.getFilename())
+            .arg(threads);
+
+        typedef std::vector<ParsedRow<LeaseObjectType,
+                                      typename LeaseFileType::RowType> > Batch;
+        typedef std::function<void()> WorkItem;
+
+        // The batches must outlive the thread pool which may still be
+        // parsing one of them when an exception is thrown.
+        Batch current;
+        Batch next;
+        util::ThreadPool<WorkItem> pool;
+        pool.start(threads);
+
+        const size_t batch_size = threads * CHUNK_ROWS;
+        auto dispatch = [&pool, &lease_file, lease_checker](Batch& batch) {
+            for (size_t first = 0; first < batch.size(); first += CHUNK_ROWS) {
+                auto begin = batch.begin() + first;
+                auto end = batch.begin() + std::min(first + CHUNK_ROWS,
+                                                    batch.size());
+                pool.add(boost::make_shared<WorkItem>([&lease_file, begin, end,
+                                                       lease_checker]() {
+                    parseRows(lease_file, begin, end, lease_checker);
+                }));
+            }
+        };
+
+        // Track the number of corrupted leases.
+        uint32_t errcnt = 0;
+        bool more = readRows(lease_file, current, batch_size);
+        dispatch(current);
+        while (!current.empty()) {
+            if (more) {
+                more = readRows(lease_file, next, batch_size);
+            } else {
+                next.clear();
+            }
+            pool.wait();
+            dispatch(next);
+            for (auto& parsed : current) {
+                if (parsed.read_) {
+                    lease_file.updateReadStats(parsed.lease_ || parsed.discarded_);
+                }
+                if (parsed.discarded_) {
+                    logProgress(lease_file, parsed.row_number_);
+                    continue;
+                }
+                if (!parsed.lease_) {
+                    handleRowError(lease_file, parsed.row_number_,
+                                   parsed.error_, errcnt, max_errors);
+                    continue;
+                }
+                // The lease was checked by the thread pool.
+                storeLease(parsed.lease_, storage, nullptr);
+                logProgress(lease_file, parsed.row_number_);
+            }
+            current.swap(next);
+        }
+        pool.stop();
+    }
 };
 
 }  // namespace dhcp
@@ -0,0 +1,744 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcpsrv/lease_journal.h>
+#include <util/io_utilities.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Magic bytes starting the journal file.
+const uint8_t JOURNAL_MAGIC[] = { 'K', 'E', 'A', 'J' };
+
+/// @brief Length of the journal file header.
+const size_t HEADER_LENGTH = 8;
+
+/// @brief Length of the record header holding the length and the CRC.
+const size_t RECORD_HEADER_LENGTH = 8;
+
+/// @brief Size of the buffer used to read the journal.
+const size_t READ_BUFFER_SIZE = 65536;
+
+/// @brief Flag of the forward DNS update.
+const uint8_t FLAG_FQDN_FWD = 0x01;
+
+/// @brief Flag of the reverse DNS update.
+const uint8_t FLAG_FQDN_REV = 0x02;
+
+/// @brief Computes the CRC-32 (IEEE 802.3) of the data.
+///
+/// @param data Pointer to the data.
+/// @param len Length of the data.
+uint32_t
+crc32(const uint8_t* data, size_t len) {
+    static uint32_t table[256];
+    static bool initialized = false;
+    if (!initialized) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+            }
+            table[i] = value;
+        }
+        initialized = true;
+    }
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return (crc ^ 0xFFFFFFFF);
+}
+
+/// @brief Builds the CRC table before any thread uses it.
+const uint32_t CRC_INIT = crc32(0, 0);
+
+/// @brief Writes a byte string preceded by its 16 bits length.
+void
+writeBytes16(OutputBuffer& buf, const uint8_t* data, size_t len) {
+    if (len > 0xFFFF) {
+        isc_throw(isc::BadValue, "value of " << len << " bytes is too long"
+                  " for the lease journal");
+    }
+    buf.writeUint16(static_cast<uint16_t>(len));
+    if (len > 0) {
+        buf.writeData(data, len);
+    }
+}
+
+/// @brief Writes a string preceded by its 32 bits length.
+void
+writeString32(OutputBuffer& buf, const std::string& value) {
+    buf.writeUint32(static_cast<uint32_t>(value.size()));
+    if (!value.empty()) {
+        buf.writeData(value.c_str(), value.size());
+    }
+}
+
+/// @brief Reads a 64 bits integer.
+uint64_t
+readUint64(InputBuffer& buf) {
+    uint64_t value = buf.readUint32();
+    value <<= 32;
+    value |= buf.readUint32();
+    return (value);
+}
+
+/// @brief Reads a byte string preceded by its 16 bits length.
+std::vector<uint8_t>
+readBytes16(InputBuffer& buf) {
+    std::vector<uint8_t> value;
+    buf.readVector(value, buf.readUint16());
+    return (value);
+}
+
+/// @brief Reads a string preceded by its 16 bits length.
+std::string
+readString16(InputBuffer& buf) {
+    std::vector<uint8_t> value = readBytes16(buf);
+    return (std::string(value.begin(), value.end()));
+}
+
+/// @brief Reads a string preceded by its 32 bits length.
+std::string
+readString32(InputBuffer& buf) {
+    std::vector<uint8_t> value;
+    buf.readVector(value, buf.readUint32());
+    return (std::string(value.begin(), value.end()));
+}
+
+/// @brief Writes the user context of a lease.
+void
+writeContext(OutputBuffer& buf, const isc::dhcp::Lease& lease) {
+    ConstElementPtr ctx = lease.getContext();
+    writeString32(buf, ctx ? ctx->str() : std::string());
+}
+
+/// @brief Reads the user context of a lease.
+///
+/// @return The user context or null if the lease has none.
+/// @throw BadValue if the user context is not a map.
+ConstElementPtr
+readContext(InputBuffer& buf) {
+    std::string text = readString32(buf);
+    if (text.empty()) {
+        return (ConstElementPtr());
+    }
+    ConstElementPtr ctx = Element::fromJSON(text);
+    if (!ctx || (ctx->getType() != Element::map)) {
+        isc_throw(isc::BadValue, "user context '" << text
+                  << "' is not a JSON map");
+    }
+    return (ctx);
+}
+
+/// @brief Checks that the whole payload has been parsed.
+void
+checkEnd(const InputBuffer& buf) {
+    if (buf.getPosition() != buf.getLength()) {
+        isc_throw(isc::BadValue, "unexpected " << (buf.getLength() - buf.getPosition())
+                  << " bytes at the end of the lease record");
+    }
+}
+
+}
+
+namespace isc {
+namespace dhcp {
+
+const uint8_t LeaseJournal::FORMAT_VERSION;
+const uint32_t LeaseJournal::MAX_RECORD_LENGTH;
+
+LeaseJournal::LeaseJournal(const std::string& filename, const uint8_t universe)
+    : LeaseFileStats(), filename_(filename), universe_(universe), fd_(-1),
+      read_buf_(), read_pos_(0), read_len_(0), valid_offset_(0),
+      sync_interval_(0), unsynced_(0), write_buf_(), read_msg_() {
+    static_cast<void>(CRC_INIT);
+}
+
+LeaseJournal::~LeaseJournal() {
+    try {
+        close();
+    } catch (...) {
+        // Don't throw from the destructor.
+    }
+}
+
+bool
+LeaseJournal::exists() const {
+    struct stat st;
+    return (::stat(filename_.c_str(), &st) == 0);
+}
+
+bool
+LeaseJournal::isJournal(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return (false);
+    }
+    uint8_t magic[sizeof(JOURNAL_MAGIC)];
+    ssize_t len = ::read(fd, magic, sizeof(magic));
+    static_cast<void>(::close(fd));
+    return ((len == static_cast<ssize_t>(sizeof(magic))) &&
+            (memcmp(magic, JOURNAL_MAGIC, sizeof(magic)) == 0));
+}
+
+std::string
+LeaseJournal::getSchemaVersion() const {
+    std::ostringstream s;
+    s << static_cast<unsigned>(FORMAT_VERSION);
+    return (s.str());
+}
+
+void
+LeaseJournal::open(const bool seek_to_end) {
+    close();
+    clearStatistics();
+    read_msg_.clear();
+    read_pos_ = 0;
+    read_len_ = 0;
+
+    fd_ = ::open(filename_.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC,
+                 S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd_ < 0) {
+        isc_throw(LeaseJournalError, "unable to open the lease journal '"
+                  << filename_ << "': " << strerror(errno));
+    }
+
+    try {
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+            isc_throw(LeaseJournalError, "unable to get the size of the lease"
+                      " journal '" << filename_ << "': " << strerror(errno));
+        }
+
+        if (static_cast<uint64_t>(st.st_size) < HEADER_LENGTH) {
+            // A new file or a file which was created when the server
+            // crashed: write the header.
+            if ((st.st_size > 0) && (::ftruncate(fd_, 0) != 0)) {
+                isc_throw(LeaseJournalError, "unable to truncate the lease"
+                          " journal '" << filename_ << "': " << strerror(errno));
+            }
+            uint8_t header[HEADER_LENGTH] = { 0 };
+            memcpy(header, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+            header[4] = FORMAT_VERSION;
+            header[5] = universe_;
+            write(header, sizeof(header));
+            flush();
+
+        } else {
+            uint8_t header[HEADER_LENGTH];
+            if (::pread(fd_, header, sizeof(header), 0) !=
+                static_cast<ssize_t>(sizeof(header))) {
+                isc_throw(LeaseJournalError, "unable to read the header of"
+                          " the lease journal '" << filename_ << "'");
+            }
+            if (memcmp(header, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+                isc_throw(LeaseJournalError, "the file '" << filename_
+                          << "' is not a lease journal");
+            }
+            if (header[4] != FORMAT_VERSION) {
+                isc_throw(LeaseJournalError, "unsupported version "
+                          << static_cast<unsigned>(header[4])
+                          << " of the lease journal '" << filename_ << "'");
+            }
+            if (header[5] != universe_) {
+                isc_throw(LeaseJournalError, "the lease journal '" << filename_
+                          << "' holds DHCPv" << static_cast<unsigned>(header[5])
+                          << " leases");
+            }
+        }
+
+        off_t offset = seek_to_end ? ::lseek(fd_, 0, SEEK_END) :
+                                     ::lseek(fd_, HEADER_LENGTH, SEEK_SET);
+        if (offset < 0) {
+            isc_throw(LeaseJournalError, "unable to seek in the lease"
+                      " journal '" << filename_ << "': " << strerror(errno));
+        }
+        valid_offset_ = static_cast<uint64_t>(offset);
+
+    } catch (...) {
+        static_cast<void>(::close(fd_));
+        fd_ = -1;
+        throw;
+    }
+}
+
+void
+LeaseJournal::close() {
+    if (fd_ < 0) {
+        return;
+    }
+    try {
+        flush();
+    } catch (...) {
+        static_cast<void>(::close(fd_));
+        fd_ = -1;
+        throw;
+    }
+    static_cast<void>(::close(fd_));
+    fd_ = -1;
+}
+
+void
+LeaseJournal::flush() {
+    if ((fd_ < 0) || (unsynced_ == 0)) {
+        return;
+    }
+    unsynced_ = 0;
+    if (::fsync(fd_) != 0) {
+        isc_throw(LeaseJournalError, "unable to synchronize the lease"
+                  " journal '" << filename_ << "': " << strerror(errno));
+    }
+}
+
+void
+LeaseJournal::appendRecord(const OutputBuffer& payload) {
+    if (fd_ < 0) {
+        isc_throw(LeaseJournalError, "unable to write to the lease journal '"
+                  << filename_ << "': the file is not open");
+    }
+    const size_t len = payload.getLength();
+    if (len > MAX_RECORD_LENGTH) {
+        isc_throw(BadValue, "lease record of " << len << " bytes is too"
+                  " long for the lease journal");
+    }
+    const uint8_t* data = static_cast<const uint8_t*>(payload.getData());
+
+    // Write the record with a single system call.
+    write_buf_.resize(RECORD_HEADER_LENGTH + len);
+    writeUint32(static_cast<uint32_t>(len), &write_buf_[0], 4);
+    writeUint32(crc32(data, len), &write_buf_[4], 4);
+    memcpy(&write_buf_[RECORD_HEADER_LENGTH], data, len);
+    write(&write_buf_[0], write_buf_.size());
+
+    if ((sync_interval_ > 0) && (unsynced_ >= sync_interval_)) {
+        flush();
+    }
+}
+
+void
+LeaseJournal::write(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        ssize_t written = ::write(fd_, data, len);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            isc_throw(LeaseJournalError, "unable to write to the lease"
+                      " journal '" << filename_ << "': " << strerror(errno));
+        }
+        data += written;
+        len -= static_cast<size_t>(written);
+    }
+    ++unsynced_;
+}
+
+size_t
+LeaseJournal::read(uint8_t* data, size_t len) {
+    size_t copied = 0;
+    while (copied < len) {
+        if (read_pos_ == read_len_) {
+            read_buf_.resize(READ_BUFFER_SIZE);
+            ssize_t got;
+            do {
+                got = ::read(fd_, &read_buf_[0], read_buf_.size());
+            } while ((got < 0) && (errno == EINTR));
+            if (got <= 0) {
+                break;
+            }
+            read_pos_ = 0;
+            read_len_ = static_cast<size_t>(got);
+        }
+        size_t chunk = std::min(len - copied, read_len_ - read_pos_);
+        memcpy(data + copied, &read_buf_[read_pos_], chunk);
+        read_pos_ += chunk;
+        copied += chunk;
+    }
+    return (copied);
+}
+
+void
+LeaseJournal::truncate() {
+    read_pos_ = 0;
+    read_len_ = 0;
+    if ((::ftruncate(fd_, static_cast<off_t>(valid_offset_)) != 0) ||
+        (::lseek(fd_, static_cast<off_t>(valid_offset_), SEEK_SET) < 0)) {
+        read_msg_ += std::string(", unable to truncate the file: ") +
+            strerror(errno);
+        // Make sure that the rest of the file is not read.
+        static_cast<void>(::lseek(fd_, 0, SEEK_END));
+    }
+}
+
+bool
+LeaseJournal::nextRow(RowType& row) {
+    // Bump the number of read attempts
+    ++reads_;
+    row.clear();
+
+    if (fd_ < 0) {
+        ++read_errs_;
+        setReadMsg("the lease journal is not open");
+        return (false);
+    }
+
+    uint8_t header[RECORD_HEADER_LENGTH];
+    size_t len = read(header, sizeof(header));
+    if (len == 0) {
+        // The end of file.
+        return (true);
+    }
+
+    std::ostringstream error;
+    if (len < sizeof(header)) {
+        error << "incomplete record header at offset " << valid_offset_;
+
+    } else {
+        uint32_t length = readUint32(header, 4);
+        uint32_t crc = readUint32(header + 4, 4);
+        if ((length == 0) || (length > MAX_RECORD_LENGTH)) {
+            error << "invalid record length " << length << " at offset "
+                  << valid_offset_;
+
+        } else {
+            row.resize(length);
+            if (read(&row[0], length) < length) {
+                error << "incomplete record at offset " << valid_offset_;
+
+            } else {
+                valid_offset_ += RECORD_HEADER_LENGTH + length;
+                if (crc32(&row[0], length) == crc) {
+                    return (true);
+                }
+                // The record is skipped but the following records can
+                // be read.
+                row.clear();
+                ++read_errs_;
+                error << "checksum mismatch of the record ending at offset "
+                      << valid_offset_;
+                setReadMsg(error.str());
+                return (false);
+            }
+        }
+    }
+
+    // The following data can't be interpreted, so drop it to append the
+    // new records after the last valid one.
+    row.clear();
+    ++read_errs_;
+    error << ", the rest of the file is dropped";
+    setReadMsg(error.str());
+    truncate();
+    return (false);
+}
+
+void
+LeaseJournal::updateReadStats(const bool parsed) {
+    if (parsed) {
+        ++read_leases_;
+    } else {
+        ++read_errs_;
+    }
+}
+
+LeaseJournal4::LeaseJournal4(const std::string& filename)
+    : LeaseJournal(filename, 4) {
+}
+
+void
+LeaseJournal4::append(const Lease4& lease) {
+    // Bump the number of write attempts
+    ++writes_;
+
+    if (((!lease.hwaddr_) || lease.hwaddr_->hwaddr_.empty()) &&
+        ((!lease.client_id_) || (lease.client_id_->getClientId().empty())) &&
+        (lease.state_ != Lease::STATE_DECLINED)) {
+        // Bump the error counter
+        ++write_errs_;
+
+        isc_throw(BadValue, "Lease4: " << lease.addr_.toText() << ", state: "
+                  << Lease::basicStatesToText(lease.state_)
+                  << " has neither hardware address or client id");
+    }
+
+    try {
+        OutputBuffer buf(128);
+        encode(lease, buf);
+        appendRecord(buf);
+
+    } catch (const std::exception&) {
+        // Catch any errors so we can bump the error counter than rethrow it
+        ++write_errs_;
+        throw;
+    }
+
+    // Bump the number of leases written
+    ++write_leases_;
+}
+
+void
+LeaseJournal4::encode(const Lease4& lease, OutputBuffer& buf) {
+    buf.writeUint32(lease.addr_.toUint32());
+    if (lease.hwaddr_) {
+        buf.writeUint16(lease.hwaddr_->htype_);
+        const std::vector<uint8_t>& hwaddr = lease.hwaddr_->hwaddr_;
+        writeBytes16(buf, hwaddr.empty() ? 0 : &hwaddr[0], hwaddr.size());
+    } else {
+        buf.writeUint16(HTYPE_ETHER);
+        buf.writeUint16(0);
+    }
+    if (lease.client_id_) {
+        const std::vector<uint8_t>& client_id = lease.client_id_->getClientId();
+        writeBytes16(buf, &client_id[0], client_id.size());
+    } else {
+        buf.writeUint16(0);
+    }
+    buf.writeUint32(lease.valid_lft_);
+    buf.writeUint64(static_cast<uint64_t>(lease.cltt_));
+    buf.writeUint32(lease.subnet_id_);
+    buf.writeUint8((lease.fqdn_fwd_ ? FLAG_FQDN_FWD : 0) |
+                   (lease.fqdn_rev_ ? FLAG_FQDN_REV : 0));
+    buf.writeUint32(lease.state_);
+    writeBytes16(buf, reinterpret_cast<const uint8_t*>(lease.hostname_.c_str()),
+                 lease.hostname_.size());
+    writeContext(buf, lease);
+}
+
+bool
+LeaseJournal4::next(Lease4Ptr& lease) {
+    lease.reset();
+    RowType row;
+    if (!nextRow(row)) {
+        return (false);
+    }
+    // The empty row signals EOF.
+    if (row.empty()) {
+        return (true);
+    }
+    try {
+        lease = parse(row);
+
+    } catch (const std::exception& ex) {
+        updateReadStats(false);
+        setReadMsg(ex.what());
+        return (false);
+    }
+    updateReadStats(true);
+    return (true);
+}
+
+Lease4Ptr
+LeaseJournal4::parse(const RowType& row) const {
+    return (decode(row.empty() ? 0 : &row[0], row.size()));
+}
+
+Lease4Ptr
+LeaseJournal4::decode(const uint8_t* data, size_t len) {
+    InputBuffer buf(data, len);
+    IOAddress addr(buf.readUint32());
+    uint16_t htype = buf.readUint16();
+    HWAddrPtr hwaddr(new HWAddr(readBytes16(buf), htype));
+    std::vector<uint8_t> client_id = readBytes16(buf);
+    uint32_t valid = buf.readUint32();
+    time_t cltt = static_cast<time_t>(readUint64(buf));
+    SubnetID subnet_id = buf.readUint32();
+    uint8_t flags = buf.readUint8();
+    uint32_t state = buf.readUint32();
+    std::string hostname = readString16(buf);
+    ConstElementPtr ctx = readContext(buf);
+    checkEnd(buf);
+
+    if (hwaddr->hwaddr_.empty() && client_id.empty() &&
+        (state != Lease::STATE_DECLINED)) {
+        isc_throw(BadValue, "Lease4: " << addr.toText() << ", state: "
+                  << Lease::basicStatesToText(state)
+                  << " has neither hardware address or client id");
+    }
+
+    Lease4Ptr lease(new Lease4(addr, hwaddr,
+                               client_id.empty() ? 0 : &client_id[0],
+                               client_id.size(), valid, cltt, subnet_id,
+                               (flags & FLAG_FQDN_FWD) != 0,
+                               (flags & FLAG_FQDN_REV) != 0,
+                               hostname));
+    lease->state_ = state;
+    if (ctx) {
+        lease->setContext(ctx);
+    }
+    return (lease);
+}
+
+LeaseJournal6::LeaseJournal6(const std::string& filename)
+    : LeaseJournal(filename, 6) {
+}
+
+void
+LeaseJournal6::append(const Lease6& lease) {
+    // Bump the number of write attempts
+    ++writes_;
+
+    if (((!(lease.duid_)) || (*(lease.duid_) == DUID::EMPTY())) &&
+        (lease.state_ != Lease::STATE_DECLINED)) {
+        ++write_errs_;
+        isc_throw(BadValue, "Lease6: " << lease.addr_.toText() << ", state: "
+                  << Lease::basicStatesToText(lease.state_) << ", has no DUID");
+    }
+
+    try {
+        OutputBuffer buf(160);
+        encode(lease, buf);
+        appendRecord(buf);
+
+    } catch (const std::exception&) {
+        // Catch any errors so we can bump the error counter than rethrow it
+        ++write_errs_;
+        throw;
+    }
+
+    // Bump the number of leases written
+    ++write_leases_;
+}
+
+void
+LeaseJournal6::encode(const Lease6& lease, OutputBuffer& buf) {
+    buf.writeUint8(static_cast<uint8_t>(lease.type_));
+    const std::vector<uint8_t>& addr = lease.addr_.toBytes();
+    if (addr.size() != 16) {
+        isc_throw(BadValue, "Lease6: " << lease.addr_.toText()
+                  << " is not an IPv6 address");
+    }
+    buf.writeData(&addr[0], addr.size());
+    buf.writeUint8(lease.prefixlen_);
+    buf.writeUint32(lease.iaid_);
+    if (lease.duid_) {
+        const std::vector<uint8_t>& duid = lease.duid_->getDuid();
+        writeBytes16(buf, &duid[0], duid.size());
+    } else {
+        buf.writeUint16(0);
+    }
+    buf.writeUint32(lease.preferred_lft_);
+    buf.writeUint32(lease.valid_lft_);
+    buf.writeUint64(static_cast<uint64_t>(lease.cltt_));
+    buf.writeUint32(lease.subnet_id_);
+    buf.writeUint8((lease.fqdn_fwd_ ? FLAG_FQDN_FWD : 0) |
+                   (lease.fqdn_rev_ ? FLAG_FQDN_REV : 0));
+    // We may not have hardware information.
+    if (lease.hwaddr_) {
+        buf.writeUint16(lease.hwaddr_->htype_);
+        buf.writeUint32(lease.hwaddr_->source_);
+        const std::vector<uint8_t>& hwaddr = lease.hwaddr_->hwaddr_;
+        writeBytes16(buf, hwaddr.empty() ? 0 : &hwaddr[0], hwaddr.size());
+    } else {
+        buf.writeUint16(HTYPE_ETHER);
+        buf.writeUint32(HWAddr::HWADDR_SOURCE_UNKNOWN);
+        buf.writeUint16(0);
+    }
+    buf.writeUint32(lease.state_);
+    writeBytes16(buf, reinterpret_cast<const uint8_t*>(lease.hostname_.c_str()),
+                 lease.hostname_.size());
+    writeContext(buf, lease);
+}
+
+bool
+LeaseJournal6::next(Lease6Ptr& lease) {
+    lease.reset();
+    RowType row;
+    if (!nextRow(row)) {
+        return (false);
+    }
+    // The empty row signals EOF.
+    if (row.empty()) {
+        return (true);
+    }
+    try {
+        lease = parse(row);
+
+    } catch (const std::exception& ex) {
+        updateReadStats(false);
+        setReadMsg(ex.what());
+        return (false);
+    }
+    updateReadStats(true);
+    return (true);
+}
+
+Lease6Ptr
+LeaseJournal6::parse(const RowType& row) const {
+    return (decode(row.empty() ? 0 : &row[0], row.size()));
+}
+
+Lease6Ptr
+LeaseJournal6::decode(const uint8_t* data, size_t len) {
+    InputBuffer buf(data, len);
+    Lease::Type type = static_cast<Lease::Type>(buf.readUint8());
+    std::vector<uint8_t> addr;
+    buf.readVector(addr, 16);
+    uint8_t prefixlen = buf.readUint8();
+    uint32_t iaid = buf.readUint32();
+    std::vector<uint8_t> duid_bytes = readBytes16(buf);
+    uint32_t preferred = buf.readUint32();
+    uint32_t valid = buf.readUint32();
+    time_t cltt = static_cast<time_t>(readUint64(buf));
+    SubnetID subnet_id = buf.readUint32();
+    uint8_t flags = buf.readUint8();
+    uint16_t htype = buf.readUint16();
+    uint32_t source = buf.readUint32();
+    std::vector<uint8_t> hwaddr_bytes = readBytes16(buf);
+    uint32_t state = buf.readUint32();
+    std::string hostname = readString16(buf);
+    ConstElementPtr ctx = readContext(buf);
+    checkEnd(buf);
+
+    if ((type != Lease::TYPE_NA) && (type != Lease::TYPE_TA) &&
+        (type != Lease::TYPE_PD)) {
+        isc_throw(BadValue, "invalid lease type "
+                  << static_cast<int>(type) << " in the lease record");
+    }
+
+    DuidPtr duid(duid_bytes.empty() ? new DUID(DUID::EMPTY()) :
+                                      new DUID(duid_bytes));
+    if ((*duid == DUID::EMPTY()) && (state != Lease::STATE_DECLINED)) {
+        isc_throw(isc::BadValue,
+                  "The Empty DUID is only valid for declined leases");
+    }
+
+    HWAddrPtr hwaddr;
+    if (!hwaddr_bytes.empty()) {
+        hwaddr.reset(new HWAddr(hwaddr_bytes, htype));
+        hwaddr->source_ = source;
+    }
+
+    Lease6Ptr lease(new Lease6(type, IOAddress::fromBytes(AF_INET6, &addr[0]),
+                               duid, iaid, preferred, valid, subnet_id,
+                               hwaddr, prefixlen));
+    lease->cltt_ = cltt;
+    lease->updateCurrentExpirationTime();
+    lease->fqdn_fwd_ = ((flags & FLAG_FQDN_FWD) != 0);
+    lease->fqdn_rev_ = ((flags & FLAG_FQDN_REV) != 0);
+    lease->hostname_ = hostname;
+    lease->state_ = state;
+    if (ctx) {
+        lease->setContext(ctx);
+    }
+    return (lease);
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
@@ -0,0 +1,357 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_JOURNAL_H
+#define LEASE_JOURNAL_H
+
+#include <exceptions/exceptions.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/lease_file_stats.h>
+#include <util/buffer.h>
+#include <util/versioned_csv_file.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Exception thrown when the lease journal can't be opened or
+/// written.
+class LeaseJournalError : public Exception {
+public:
+    LeaseJournalError(const char* file, size_t line, const char* what) :
+        isc::Exception(file, line, what) { };
+};
+
+/// @brief Binary append-only lease file.
+///
+/// The journal is an alternative to the CSV lease files which avoids
+/// formatting the lease values as text when the leases are written and
+/// parsing them when the leases are loaded. The file starts with an
+/// 8 bytes header holding the "KEAJ" magic, the format version and the
+/// universe (4 or 6). It is followed by records holding:
+/// - the length of the payload (32 bits),
+/// - the CRC-32 of the payload (32 bits),
+/// - the payload, i.e. the lease encoded by @c LeaseJournal4 or
+///   @c LeaseJournal6.
+///
+/// All integers are stored in network byte order. A record with a wrong
+/// checksum is reported as a read error and skipped. An incomplete record
+/// at the end of the file, e.g. after a crash during a write, or one with
+/// an invalid length is reported as a read error and the file is truncated
+/// to the last valid record so as the new records can be appended.
+///
+/// The file has the same interface as the CSV lease files so it can be
+/// used with the @c LeaseFileLoader. The records are written to the file
+/// by each call to the @c append function, but they are only synchronized
+/// to the disk, i.e. fsync is called, every @c getSyncInterval records,
+/// when @c flush is called and when the file is closed.
+class LeaseJournal : public LeaseFileStats {
+public:
+
+    /// @brief Type of a record read from the journal.
+    typedef std::vector<uint8_t> RowType;
+
+    /// @brief Version of the format of the journal.
+    static const uint8_t FORMAT_VERSION = 1;
+
+    /// @brief Maximum length of the record payload.
+    static const uint32_t MAX_RECORD_LENGTH = 1024 * 1024;
+
+    /// @brief Constructor.
+    ///
+    /// @param filename Name of the journal file.
+    /// @param universe 4 for a DHCPv4 journal or 6 for a DHCPv6 journal.
+    LeaseJournal(const std::string& filename, const uint8_t universe);
+
+    /// @brief Destructor.
+    ///
+    /// Closes the file.
+    virtual ~LeaseJournal();
+
+    /// @brief Returns the name of the journal file.
+    std::string getFilename() const {
+        return (filename_);
+    }
+
+    /// @brief Checks if the journal file exists.
+    bool exists() const;
+
+    /// @brief Opens or creates the journal file.
+    ///
+    /// The header is written to a new or empty file. Otherwise the header
+    /// is checked. The statistics are cleared.
+    ///
+    /// @param seek_to_end If true the records are not read and the file
+    /// is only used to append new records.
+    /// @throw LeaseJournalError if the file can't be opened or if it is
+    /// not a journal of the expected universe.
+    void open(const bool seek_to_end = false);
+
+    /// @brief Synchronizes the written records and closes the file.
+    ///
+    /// It does nothing if the file is not open.
+    void close();
+
+    /// @brief Synchronizes the written records to the disk.
+    ///
+    /// @throw LeaseJournalError if the file can't be synchronized.
+    void flush();
+
+    /// @brief Sets the number of records written between synchronizations.
+    ///
+    /// @param records Number of records. The value of 0 disables the
+    /// synchronizations by @c append. The default is 0.
+    void setSyncInterval(const uint32_t records) {
+        sync_interval_ = records;
+    }
+
+    /// @brief Returns the number of records written between
+    /// synchronizations.
+    uint32_t getSyncInterval() const {
+        return (sync_interval_);
+    }
+
+    /// @brief Returns the description of the last read error.
+    std::string getReadMsg() const {
+        return (read_msg_);
+    }
+
+    /// @brief Reads the payload of the next record.
+    ///
+    /// This function and the @c parse function of the derived classes
+    /// are used by the @c LeaseFileLoader to parse the records by many
+    /// threads. It bumps the number of read attempts.
+    ///
+    /// This function is exception safe.
+    ///
+    /// @param [out] row Payload of the record or the @c EMPTY_ROW at the
+    /// end of file.
+    ///
+    /// @return false if the record couldn't be read. The error message is
+    /// set and the number of read errors is bumped.
+    bool nextRow(RowType& row);
+
+    /// @brief Updates the read statistics after parsing a record.
+    ///
+    /// @param parsed true if the lease was parsed, false if the record
+    /// was found invalid.
+    void updateReadStats(const bool parsed);
+
+    /// @brief Returns the empty record signaling the end of file.
+    static const RowType& EMPTY_ROW() {
+        static RowType row;
+        return (row);
+    }
+
+    /// @brief Checks if the file is a lease journal.
+    ///
+    /// @param filename Name of the file.
+    ///
+    /// @return true if the file exists and starts with the journal magic.
+    static bool isJournal(const std::string& filename);
+
+    /// @name Functions used by the @c LeaseFileLoader for the CSV files.
+    ///
+    /// The journal has a single format version so it never needs to be
+    /// converted.
+    //@{
+    bool needsConversion() const {
+        return (false);
+    }
+
+    util::VersionedCSVFile::InputSchemaState getInputSchemaState() const {
+        return (util::VersionedCSVFile::CURRENT);
+    }
+
+    std::string getSchemaVersion() const;
+    //@}
+
+protected:
+
+    /// @brief Appends a record to the file.
+    ///
+    /// @param payload Encoded lease.
+    /// @throw LeaseJournalError if the file is not open or the record
+    /// can't be written.
+    void appendRecord(const util::OutputBuffer& payload);
+
+    /// @brief Sets the description of the last read error.
+    ///
+    /// @param read_msg Error message.
+    void setReadMsg(const std::string& read_msg) {
+        read_msg_ = read_msg;
+    }
+
+private:
+
+    /// @brief Reads bytes from the file through the read buffer.
+    ///
+    /// @param data Pointer to the destination.
+    /// @param len Number of bytes to read.
+    ///
+    /// @return Number of read bytes which is lower than @c len at the
+    /// end of file.
+    size_t read(uint8_t* data, size_t len);
+
+    /// @brief Writes all the bytes to the file.
+    ///
+    /// @param data Pointer to the data.
+    /// @param len Number of bytes to write.
+    /// @throw LeaseJournalError on error.
+    void write(const uint8_t* data, size_t len);
+
+    /// @brief Drops the end of the file after the last valid record.
+    void truncate();
+
+    /// @brief Name of the journal file.
+    std::string filename_;
+
+    /// @brief Universe stored in the header.
+    uint8_t universe_;
+
+    /// @brief File descriptor or -1 if the file is not open.
+    int fd_;
+
+    /// @brief Buffer of the data read from the file.
+    std::vector<uint8_t> read_buf_;
+
+    /// @brief Position of the next unread byte in the read buffer.
+    size_t read_pos_;
+
+    /// @brief Number of valid bytes in the read buffer.
+    size_t read_len_;
+
+    /// @brief Offset in the file of the end of the last valid record.
+    uint64_t valid_offset_;
+
+    /// @brief Number of records written between synchronizations.
+    uint32_t sync_interval_;
+
+    /// @brief Number of records written since the last synchronization.
+    uint32_t unsynced_;
+
+    /// @brief Buffer used to build the records.
+    std::vector<uint8_t> write_buf_;
+
+    /// @brief Description of the last read error.
+    std::string read_msg_;
+};
+
+/// @brief DHCPv4 lease journal.
+class LeaseJournal4 : public LeaseJournal {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param filename Name of the journal file.
+    explicit LeaseJournal4(const std::string& filename);
+
+    /// @brief Appends the lease to the journal.
+    ///
+    /// @param lease Structure representing a DHCPv4 lease.
+    /// @throw BadValue if the lease has no hardware address, no client id and
+    /// is not in STATE_DECLINED.
+    /// @throw LeaseJournalError if the record can't be written.
+    void append(const Lease4& lease);
+
+    /// @brief Reads the next lease from the journal.
+    ///
+    /// This function is exception safe.
+    ///
+    /// @param [out] lease Pointer to the lease read from the journal or
+    /// null at the end of file.
+    ///
+    /// @return false if the lease couldn't be read.
+    bool next(Lease4Ptr& lease);
+
+    /// @brief Creates a lease from a record read with @c nextRow.
+    ///
+    /// This function doesn't modify the journal so it may be called
+    /// by many threads at the same time.
+    ///
+    /// @param row Payload of the record.
+    ///
+    /// @return Pointer to the lease.
+    /// @throw an exception if the record doesn't hold a valid lease.
+    Lease4Ptr parse(const RowType& row) const;
+
+    /// @brief Encodes a lease as the payload of a record.
+    ///
+    /// @param lease Structure representing a DHCPv4 lease.
+    /// @param buf Output buffer.
+    static void encode(const Lease4& lease, util::OutputBuffer& buf);
+
+    /// @brief Creates a lease from the payload of a record.
+    ///
+    /// @param data Pointer to the payload.
+    /// @param len Length of the payload.
+    ///
+    /// @return Pointer to the lease.
+    /// @throw an exception if the payload doesn't hold a valid lease.
+    static Lease4Ptr decode(const uint8_t* data, size_t len);
+};
+
+/// @brief DHCPv6 lease journal.
+class LeaseJournal6 : public LeaseJournal {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param filename Name of the journal file.
+    explicit LeaseJournal6(const std::string& filename);
+
+    /// @brief Appends the lease to the journal.
+    ///
+    /// @param lease Structure representing a DHCPv6 lease.
+    /// @throw BadValue if the lease has no DUID and is not in
+    /// STATE_DECLINED.
+    /// @throw LeaseJournalError if the record can't be written.
+    void append(const Lease6& lease);
+
+    /// @brief Reads the next lease from the journal.
+    ///
+    /// This function is exception safe.
+    ///
+    /// @param [out] lease Pointer to the lease read from the journal or
+    /// null at the end of file.
+    ///
+    /// @return false if the lease couldn't be read.
+    bool next(Lease6Ptr& lease);
+
+    /// @brief Creates a lease from a record read with @c nextRow.
+    ///
+    /// This function doesn't modify the journal so it may be called
+    /// by many threads at the same time.
+    ///
+    /// @param row Payload of the record.
+    ///
+    /// @return Pointer to the lease.
+    /// @throw an exception if the record doesn't hold a valid lease.
+    Lease6Ptr parse(const RowType& row) const;
+
+    /// @brief Encodes a lease as the payload of a record.
+    ///
+    /// @param lease Structure representing a DHCPv6 lease.
+    /// @param buf Output buffer.
+    /// @throw BadValue if the lease address is not an IPv6 address.
+    static void encode(const Lease6& lease, util::OutputBuffer& buf);
+
+    /// @brief Creates a lease from the payload of a record.
+    ///
+    /// @param data Pointer to the payload.
+    /// @param len Length of the payload.
+    ///
+    /// @return Pointer to the lease.
+    /// @throw an exception if the payload doesn't hold a valid lease.
+    static Lease6Ptr decode(const uint8_t* data, size_t len);
+};
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // LEASE_JOURNAL_H
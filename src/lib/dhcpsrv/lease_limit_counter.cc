@@ -0,0 +1,133 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/lease_limit_counter.h>
+#include <exceptions/exceptions.h>
+#include <util/multi_threading_mgr.h>
+
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::util;
+
+namespace isc {
+namespace dhcp {
+
+LeaseLimitCounter::LeaseLimitCounter() : mutex_(new std::mutex) {
+}
+
+void
+LeaseLimitCounter::addLease(const LeasePtr& lease) {
+    if (!lease) {
+        isc_throw(BadValue, "addLease - lease cannot be empty");
+    }
+
+    MultiThreadingLock lock(*mutex_);
+    // The lease should not be counted yet but a stale entry must not be
+    // counted twice.
+    uncountInternal(lease);
+    countInternal(lease);
+}
+
+void
+LeaseLimitCounter::updateLease(const LeasePtr& lease) {
+    if (!lease) {
+        isc_throw(BadValue, "updateLease - lease cannot be empty");
+    }
+
+    MultiThreadingLock lock(*mutex_);
+    uncountInternal(lease);
+    countInternal(lease);
+}
+
+void
+LeaseLimitCounter::removeLease(const LeasePtr& lease) {
+    if (!lease) {
+        isc_throw(BadValue, "removeLease - lease cannot be empty");
+    }
+
+    MultiThreadingLock lock(*mutex_);
+    uncountInternal(lease);
+}
+
+size_t
+LeaseLimitCounter::getClassCount(const ClientClass& client_class,
+                                 const Lease::Type& ltype) const {
+    MultiThreadingLock lock(*mutex_);
+    if (ltype == Lease::TYPE_V4) {
+        return (counter4_.getClassCount(client_class, ltype));
+    }
+    return (counter6_.getClassCount(client_class, ltype));
+}
+
+size_t
+LeaseLimitCounter::getLeaseCount() const {
+    MultiThreadingLock lock(*mutex_);
+    return (leases_.size());
+}
+
+void
+LeaseLimitCounter::clear(uint16_t family) {
+    MultiThreadingLock lock(*mutex_);
+    for (auto it = leases_.begin(); it != leases_.end(); ) {
+        if (it->first.getFamily() == family) {
+            it = leases_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (family == AF_INET) {
+        counter4_.clear();
+    } else {
+        counter6_.clear();
+    }
+}
+
+void
+LeaseLimitCounter::clear() {
+    MultiThreadingLock lock(*mutex_);
+    leases_.clear();
+    counter4_.clear();
+    counter6_.clear();
+}
+
+void
+LeaseLimitCounter::countInternal(const LeasePtr& lease) {
+    if (lease->state_ != Lease::STATE_DEFAULT) {
+        return;
+    }
+
+    ConstElementPtr classes = ClassLeaseCounter::getLeaseClientClasses(lease);
+    if (!classes || classes->empty()) {
+        return; // Lease limits isn't loaded.
+    }
+
+    CountedLease counted{lease->getType(), std::vector<ClientClass>()};
+    ClassLeaseCounter& counter = getCounter(counted.type_);
+    for (size_t i = 0; i < classes->size(); ++i) {
+        counted.classes_.push_back(classes->get(i)->stringValue());
+        counter.adjustClassCount(counted.classes_.back(), 1, counted.type_);
+    }
+    leases_[lease->addr_] = counted;
+}
+
+void
+LeaseLimitCounter::uncountInternal(const LeasePtr& lease) {
+    auto it = leases_.find(lease->addr_);
+    if (it == leases_.end()) {
+        return;
+    }
+
+    ClassLeaseCounter& counter = getCounter(it->second.type_);
+    for (auto const& client_class : it->second.classes_) {
+        counter.adjustClassCount(client_class, -1, it->second.type_);
+    }
+    leases_.erase(it);
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
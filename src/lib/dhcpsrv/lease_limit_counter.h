@@ -0,0 +1,137 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_LIMIT_COUNTER_H
+#define LEASE_LIMIT_COUNTER_H
+
+#include <asiolink/io_address.h>
+#include <dhcp/classify.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/memfile_lease_limits.h>
+
+#include <boost/scoped_ptr.hpp>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Incrementally maintained lease counts per client class.
+///
+/// The SQL lease backends check the lease limits with queries counting
+/// the leases in the database, i.e. every lease allocation subject to
+/// a limit costs additional database round trips. This counter keeps the
+/// class lease counts in memory instead. It is updated by the
+/// @c TrackingLeaseMgr each time a lease is added, updated or deleted.
+///
+/// Unlike the @c ClassLeaseCounter used by the memfile backend, this
+/// counter is not given the previous version of an updated lease. It
+/// remembers the classes each counted lease contributed to, so an update
+/// or a deletion only needs the address of the lease to reverse the
+/// previous contribution. Only the leases in the default state and with
+/// client classes in their user context are remembered.
+///
+/// The counts reflect the lease changes made by this server only, so the
+/// counter must be used only when no other server writes the same leases.
+///
+/// The counter is thread safe.
+class LeaseLimitCounter {
+public:
+
+    /// @brief Constructor.
+    LeaseLimitCounter();
+
+    /// @brief Counts a new lease.
+    ///
+    /// @param lease lease which was added.
+    void addLease(const LeasePtr& lease);
+
+    /// @brief Recounts an updated lease.
+    ///
+    /// The previous contribution of the lease is reversed before the new
+    /// version of the lease is counted.
+    ///
+    /// @param lease new version of the lease.
+    void updateLease(const LeasePtr& lease);
+
+    /// @brief Stops counting a deleted lease.
+    ///
+    /// @param lease lease which was deleted.
+    void removeLease(const LeasePtr& lease);
+
+    /// @brief Fetches the lease count for the given class and lease type.
+    ///
+    /// @param client_class class for which the count is desired.
+    /// @param ltype lease type for which the count is desired, defaults to
+    /// Lease::TYPE_V4.
+    ///
+    /// @return Number of leases for the class and lease type.
+    size_t getClassCount(const ClientClass& client_class,
+                         const Lease::Type& ltype = Lease::TYPE_V4) const;
+
+    /// @brief Returns the number of counted leases.
+    size_t getLeaseCount() const;
+
+    /// @brief Removes the counts of the given family.
+    ///
+    /// @param family AF_INET or AF_INET6.
+    void clear(uint16_t family);
+
+    /// @brief Removes all counts.
+    void clear();
+
+private:
+
+    /// @brief Counts a lease, must be called with the mutex held.
+    ///
+    /// @param lease lease to count.
+    void countInternal(const LeasePtr& lease);
+
+    /// @brief Reverses the contribution of a lease, must be called with
+    /// the mutex held.
+    ///
+    /// @param lease lease to not count anymore.
+    void uncountInternal(const LeasePtr& lease);
+
+    /// @brief Returns the class counts for the lease type.
+    ///
+    /// @param ltype lease type.
+    /// @return the IPv4 counts for Lease::TYPE_V4, the IPv6 counts otherwise.
+    ClassLeaseCounter& getCounter(const Lease::Type& ltype) {
+        return (ltype == Lease::TYPE_V4 ? counter4_ : counter6_);
+    }
+
+    /// @brief A counted lease.
+    struct CountedLease {
+        /// @brief Lease type.
+        Lease::Type type_;
+
+        /// @brief Classes the lease was counted for.
+        ///
+        /// The names are copied because the user context of the lease
+        /// may be modified in place later.
+        std::vector<ClientClass> classes_;
+    };
+
+    /// @brief Counted leases by address.
+    std::unordered_map<asiolink::IOAddress, CountedLease,
+                       asiolink::IOAddress::Hash> leases_;
+
+    /// @brief Class counts of the IPv4 leases.
+    ClassLeaseCounter counter4_;
+
+    /// @brief Class counts of the IPv6 addresses and prefixes.
+    ClassLeaseCounter counter6_;
+
+    /// @brief The mutex protecting the counts.
+    boost::scoped_ptr<std::mutex> mutex_;
+};
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // LEASE_LIMIT_COUNTER_H
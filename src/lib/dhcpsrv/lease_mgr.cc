@@ -9,19 +9,26 @@
 #include <dhcp/libdhcp++.h>
 #include <dhcp/option_custom.h>
 #include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/dhcpsrv_exceptions.h>
 #include <dhcpsrv/dhcpsrv_log.h>
 #include <dhcpsrv/lease_mgr.h>
 #include <exceptions/exceptions.h>
 #include <stats/stats_mgr.h>
 #include <util/encode/hex.h>
+#include <util/multi_threading_mgr.h>
 
 #include <boost/foreach.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
 
 #include <algorithm>
+#include <condition_variable>
+#include <future>
 #include <iostream>
 #include <iterator>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
 
@@ -34,6 +41,74 @@ using namespace isc::dhcp;
 using namespace isc::util;
 using namespace std;
 
+namespace {
+
+/// @brief Asynchronous lease operations submitted by a thread.
+struct AsyncGroup {
+    /// @brief Constructor.
+    AsyncGroup() : pending_(0), failed_(false), callbacks_() {
+    }
+
+    /// @brief Records the completion of an operation.
+    ///
+    /// @param ok false if the operation failed.
+    void done(bool ok) {
+        std::vector<LeaseMgr::DurableCallback> callbacks;
+        bool durable;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!ok) {
+                failed_ = true;
+            }
+            if (--pending_ > 0) {
+                return;
+            }
+            durable = !failed_;
+            callbacks.swap(callbacks_);
+        }
+        cv_.notify_all();
+        for (auto const& callback : callbacks) {
+            try {
+                callback(durable);
+            } catch (const std::exception& ex) {
+                LOG_ERROR(dhcpsrv_logger, DHCPSRV_ASYNC_LEASE_CALLBACK_FAILED)
+                    .arg(ex.what());
+            }
+        }
+    }
+
+    /// @brief Number of operations not yet completed.
+    size_t pending_;
+
+    /// @brief Indicates that an operation failed.
+    bool failed_;
+
+    /// @brief Callbacks invoked when all the operations completed.
+    std::vector<LeaseMgr::DurableCallback> callbacks_;
+
+    /// @brief Mutex protecting the group.
+    std::mutex mutex_;
+
+    /// @brief Condition signaled when all the operations completed.
+    std::condition_variable cv_;
+};
+
+/// @brief Pointer to an @c AsyncGroup.
+typedef boost::shared_ptr<AsyncGroup> AsyncGroupPtr;
+
+/// @brief The asynchronous operations submitted by the current thread.
+thread_local AsyncGroupPtr async_group;
+
+/// @brief Indicates that the current thread executes an asynchronous
+/// operation.
+thread_local bool async_running = false;
+
+/// @brief Indicates that the current thread executes a delegated lease
+/// change.
+thread_local bool writer_running = false;
+
+}
+
 namespace isc {
 namespace dhcp {
 
@@ -52,6 +127,43 @@ LeasePageSize::LeasePageSize(const size_t page_size)
     }
 }
 
+bool
+LeasePageFilter::matches(const Lease& lease) const {
+    if ((subnet_id_ != 0) && (lease.subnet_id_ != subnet_id_)) {
+        return (false);
+    }
+    if (!state_.unspecified() && (lease.state_ != state_.get())) {
+        return (false);
+    }
+    if (!min_expire_.unspecified() || !max_expire_.unspecified()) {
+        const int64_t expire = lease.getExpirationTime();
+        if (!min_expire_.unspecified() && (expire < min_expire_.get())) {
+            return (false);
+        }
+        if (!max_expire_.unspecified() && (expire > max_expire_.get())) {
+            return (false);
+        }
+    }
+    if (!client_class_.empty()) {
+        ConstElementPtr ctx = lease.getContext();
+        ConstElementPtr classes;
+        if (ctx && (ctx->getType() == Element::map)) {
+            classes = ctx->find("ISC/client-classes");
+        }
+        if (!classes || (classes->getType() != Element::list)) {
+            return (false);
+        }
+        for (auto const& cclass : classes->listValue()) {
+            if ((cclass->getType() == Element::string) &&
+                (cclass->stringValue() == client_class_)) {
+                return (true);
+            }
+        }
+        return (false);
+    }
+    return (true);
+}
+
 Lease6Ptr
 LeaseMgr::getLease6(Lease::Type type, const DUID& duid,
                     uint32_t iaid, SubnetID subnet_id) const {
@@ -69,6 +181,438 @@ LeaseMgr::getLease6(Lease::Type type, const DUID& duid,
     return (*col.begin());
 }
 
+size_t
+LeaseMgr::addLeases4(const Lease4Collection& leases) {
+    size_t count = 0;
+    for (auto const& lease : leases) {
+        if (addLease(lease)) {
+            ++count;
+        }
+    }
+    return (count);
+}
+
+Lease6Collection
+LeaseMgr::getLeases6ByAddresses(Lease::Type type,
+                                const std::vector<IOAddress>& addresses) const {
+    Lease6Collection collection;
+    for (auto const& address : addresses) {
+        Lease6Ptr lease = getLease6(type, address);
+        if (lease) {
+            collection.push_back(lease);
+        }
+    }
+    return (collection);
+}
+
+size_t
+LeaseMgr::addLeases6(const Lease6Collection& leases) {
+    size_t count = 0;
+    for (auto const& lease : leases) {
+        if (addLease(lease)) {
+            ++count;
+        }
+    }
+    return (count);
+}
+
+size_t
+LeaseMgr::updateLeases4(const Lease4Collection& leases) {
+    size_t count = 0;
+    for (auto const& lease : leases) {
+        try {
+            updateLease4(lease);
+            ++count;
+        } catch (const NoSuchLease&) {
+            // Skip the lease.
+        }
+    }
+    return (count);
+}
+
+size_t
+LeaseMgr::updateLeases6(const Lease6Collection& leases) {
+    size_t count = 0;
+    for (auto const& lease : leases) {
+        try {
+            updateLease6(lease);
+            ++count;
+        } catch (const NoSuchLease&) {
+            // Skip the lease.
+        }
+    }
+    return (count);
+}
+
+size_t
+LeaseMgr::deleteLeases4(const Lease4Collection& leases) {
+    size_t count = 0;
+    for (auto const& lease : leases) {
+        if (deleteLease(lease)) {
+            ++count;
+        }
+    }
+    return (count);
+}
+
+size_t
+LeaseMgr::deleteLeases6(const Lease6Collection& leases) {
+    size_t count = 0;
+    for (auto const& lease : leases) {
+        if (deleteLease(lease)) {
+            ++count;
+        }
+    }
+    return (count);
+}
+
+bool
+LeaseMgr::canAddFreeLease4() const {
+    return (false);
+}
+
+bool
+LeaseMgr::addFreeLease4(const Lease4Ptr& /* lease */,
+                        const IOAddress& /* first_address */,
+                        const IOAddress& /* last_address */) {
+    return (false);
+}
+
+size_t
+LeaseMgr::reclaimExpiredLeases4(Lease4Collection& reclaimed_leases,
+                                const size_t max_leases,
+                                const bool remove_lease) {
+    Lease4Collection expired_leases;
+    getExpiredLeases4(expired_leases, max_leases);
+    size_t count = 0;
+    for (auto const& lease : expired_leases) {
+        // Keep the lease as it was before the reclamation.
+        Lease4Ptr reclaimed(new Lease4(*lease));
+        if (remove_lease) {
+            if (!deleteLease(reclaimed)) {
+                continue;
+            }
+        } else {
+            reclaimed->reuseable_valid_lft_ = 0;
+            reclaimed->hostname_.clear();
+            reclaimed->fqdn_fwd_ = false;
+            reclaimed->fqdn_rev_ = false;
+            reclaimed->state_ = Lease::STATE_EXPIRED_RECLAIMED;
+            try {
+                updateLease4(reclaimed);
+            } catch (const NoSuchLease&) {
+                // Skip the lease.
+                continue;
+            }
+        }
+        reclaimed_leases.push_back(lease);
+        ++count;
+    }
+    return (count);
+}
+
+ElementPtr
+LeaseMgr::getMemoryStats() const {
+    return (Element::createMap());
+}
+
+bool
+LeaseMgr::whenLeasesDurable(const DurableCallback& callback) {
+    AsyncGroupPtr group;
+    group.swap(async_group);
+    if (!group) {
+        return (false);
+    }
+    {
+        std::lock_guard<std::mutex> lock(group->mutex_);
+        if (group->pending_ > 0) {
+            group->callbacks_.push_back(callback);
+            return (true);
+        }
+        if (!group->failed_) {
+            return (false);
+        }
+    }
+    // An operation already failed.
+    callback(false);
+    return (true);
+}
+
+void
+LeaseMgr::addLeaseAsync(const Lease4Ptr& lease, const AsyncCallback& callback) {
+    Lease4Ptr copy(new Lease4(*lease));
+    lease->updateCurrentExpirationTime();
+    submitAsync(lease->addr_, [this, copy]() {
+        return (addLease(copy));
+    }, callback);
+}
+
+void
+LeaseMgr::addLeaseAsync(const Lease6Ptr& lease, const AsyncCallback& callback) {
+    Lease6Ptr copy(new Lease6(*lease));
+    lease->updateCurrentExpirationTime();
+    submitAsync(lease->addr_, [this, copy]() {
+        return (addLease(copy));
+    }, callback);
+}
+
+void
+LeaseMgr::updateLease4Async(const Lease4Ptr& lease, const AsyncCallback& callback) {
+    Lease4Ptr copy(new Lease4(*lease));
+    lease->updateCurrentExpirationTime();
+    submitAsync(lease->addr_, [this, copy]() {
+        updateLease4(copy);
+        return (true);
+    }, callback);
+}
+
+void
+LeaseMgr::updateLease6Async(const Lease6Ptr& lease, const AsyncCallback& callback) {
+    Lease6Ptr copy(new Lease6(*lease));
+    lease->updateCurrentExpirationTime();
+    submitAsync(lease->addr_, [this, copy]() {
+        updateLease6(copy);
+        return (true);
+    }, callback);
+}
+
+void
+LeaseMgr::deleteLeaseAsync(const Lease4Ptr& lease, const AsyncCallback& callback) {
+    Lease4Ptr copy(new Lease4(*lease));
+    submitAsync(lease->addr_, [this, copy]() {
+        return (deleteLease(copy));
+    }, callback);
+}
+
+void
+LeaseMgr::deleteLeaseAsync(const Lease6Ptr& lease, const AsyncCallback& callback) {
+    Lease6Ptr copy(new Lease6(*lease));
+    submitAsync(lease->addr_, [this, copy]() {
+        return (deleteLease(copy));
+    }, callback);
+}
+
+bool
+LeaseMgr::isAsync() const {
+    return (async_executor_ && MultiThreadingMgr::instance().getMode());
+}
+
+void
+LeaseMgr::waitForAsync() {
+    AsyncGroupPtr group = async_group;
+    if (!group || async_running) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(group->mutex_);
+    group->cv_.wait(lock, [&group]() { return (group->pending_ == 0); });
+}
+
+void
+LeaseMgr::startAsync(uint32_t thread_count) {
+    stopAsync();
+    if (thread_count > 0) {
+        async_executor_.reset(new LeaseAsyncExecutor(thread_count));
+        LOG_INFO(dhcpsrv_logger, DHCPSRV_ASYNC_LEASE_THREADS)
+            .arg(thread_count);
+    }
+}
+
+void
+LeaseMgr::stopAsync() {
+    if (async_executor_) {
+        async_executor_->stop();
+        async_executor_.reset();
+    }
+}
+
+uint32_t
+LeaseMgr::getAsyncThreads(const DatabaseConnection::ParameterMap& parameters) {
+    auto param = parameters.find("async-threads");
+    if (param == parameters.end()) {
+        return (0);
+    }
+    try {
+        return (boost::lexical_cast<uint32_t>(param->second));
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(BadValue, "invalid value of the async-threads "
+                  << param->second << " specified");
+    }
+}
+
+bool
+LeaseMgr::isWriteDelegated() const {
+    return (writer_executor_ && !writer_running && !async_running &&
+            MultiThreadingMgr::instance().getMode());
+}
+
+void
+LeaseMgr::startWriters(uint32_t thread_count) {
+    stopWriters();
+    if (thread_count > 0) {
+        writer_executor_.reset(new LeaseAsyncExecutor(thread_count));
+        LOG_INFO(dhcpsrv_logger, DHCPSRV_LEASE_WRITER_THREADS)
+            .arg(thread_count);
+    }
+}
+
+void
+LeaseMgr::stopWriters() {
+    if (writer_executor_) {
+        writer_executor_->stop();
+        writer_executor_.reset();
+    }
+}
+
+bool
+LeaseMgr::delegateWrite(const LeasePtr& lease,
+                        const std::function<bool()>& operation,
+                        bool& result) {
+    if (!isWriteDelegated()) {
+        return (false);
+    }
+
+    // Don't overtake the asynchronous changes submitted by this thread.
+    waitForAsync();
+
+    // The promise is shared as the writer thread may still use it when
+    // the caller gets the result.
+    auto promise = boost::make_shared<std::promise<bool>>();
+    std::future<bool> future = promise->get_future();
+    writer_executor_->push(lease->addr_, [operation, promise]() {
+        bool running = writer_running;
+        writer_running = true;
+        try {
+            promise->set_value(operation());
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+        writer_running = running;
+    });
+
+    // Block until the writer thread executed the change.
+    result = future.get();
+    return (true);
+}
+
+bool
+LeaseMgr::isWriterThread() {
+    return (writer_running);
+}
+
+uint32_t
+LeaseMgr::getWriterThreads(const DatabaseConnection::ParameterMap& parameters) {
+    auto param = parameters.find("writer-threads");
+    if (param == parameters.end()) {
+        return (0);
+    }
+    try {
+        return (boost::lexical_cast<uint32_t>(param->second));
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(BadValue, "invalid value of the writer-threads "
+                  << param->second << " specified");
+    }
+}
+
+uint32_t
+LeaseMgr::getPoolSize(const DatabaseConnection::ParameterMap& parameters) {
+    auto param = parameters.find("pool-size");
+    if (param == parameters.end()) {
+        return (0);
+    }
+    try {
+        return (boost::lexical_cast<uint32_t>(param->second));
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(BadValue, "invalid value of the pool-size "
+                  << param->second << " specified");
+    }
+}
+
+void
+LeaseMgr::submitAsync(const IOAddress& address,
+                      const std::function<bool()>& operation,
+                      const AsyncCallback& callback) {
+    if (!isAsync()) {
+        bool result = false;
+        std::exception_ptr error;
+        try {
+            result = operation();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        if (callback) {
+            callback(result, error);
+        }
+        return;
+    }
+
+    // Start a new group when the previous operations completed.
+    AsyncGroupPtr group = async_group;
+    {
+        bool idle = true;
+        if (group) {
+            std::lock_guard<std::mutex> lock(group->mutex_);
+            idle = (group->pending_ == 0);
+            if (!idle) {
+                ++group->pending_;
+            }
+        }
+        if (idle) {
+            group.reset(new AsyncGroup());
+            group->pending_ = 1;
+            async_group = group;
+        }
+    }
+
+    async_executor_->push(address, [operation, callback, group]() {
+        bool result = false;
+        std::exception_ptr error;
+        async_running = true;
+        try {
+            result = operation();
+        } catch (const std::exception& ex) {
+            LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+                      DHCPSRV_ASYNC_LEASE_OPERATION_FAILED)
+                .arg(ex.what());
+            error = std::current_exception();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        async_running = false;
+        if (callback) {
+            try {
+                callback(result, error);
+            } catch (const std::exception& ex) {
+                LOG_ERROR(dhcpsrv_logger, DHCPSRV_ASYNC_LEASE_CALLBACK_FAILED)
+                    .arg(ex.what());
+            }
+        }
+        group->done(!error);
+    });
+}
+
+Lease4Collection
+LeaseMgr::getFilteredLeases4(const LeasePageFilter& filter,
+                             const IOAddress& lower_bound_address,
+                             const LeasePageSize& page_size) const {
+    Lease4Collection collection;
+    IOAddress cursor = lower_bound_address;
+    for (;;) {
+        Lease4Collection page = getLeases4(cursor, page_size);
+        for (auto const& lease : page) {
+            if (filter.matches(*lease)) {
+                collection.push_back(lease);
+                if (collection.size() == page_size.page_size_) {
+                    return (collection);
+                }
+            }
+        }
+        if (page.size() < page_size.page_size_) {
+            return (collection);
+        }
+        cursor = page.back()->addr_;
+    }
+}
+
 void
 LeaseMgr::recountLeaseStats4() {
     using namespace stats;
@@ -164,6 +708,76 @@ LeaseMgr::recountLeaseStats4() {
     }
 }
 
+void
+LeaseMgr::recountLeaseStats4(const SubnetIDSet& subnet_ids) {
+    using namespace stats;
+
+    StatsMgr& stats_mgr = StatsMgr::instance();
+
+    int64_t zero = 0;
+    if (!stats_mgr.getObservation("declined-addresses")) {
+        stats_mgr.setValue("declined-addresses", zero);
+    }
+
+    for (auto const& subnet_id : subnet_ids) {
+        LeaseStatsQueryPtr query = startSubnetLeaseStatsQuery4(subnet_id);
+        if (!query) {
+            /// NULL means not backend does not support recounting.
+            return;
+        }
+
+        // Remove the old declined value from the global value.
+        const std::string declined_name =
+            StatsMgr::generateName("subnet", subnet_id, "declined-addresses");
+        ObservationPtr declined = stats_mgr.getObservation(declined_name);
+        if (declined) {
+            stats_mgr.addValue("declined-addresses",
+                               -declined->getInteger().first);
+        }
+
+        stats_mgr.setValue(StatsMgr::generateName("subnet", subnet_id,
+                                                  "assigned-addresses"),
+                           zero);
+        stats_mgr.setValue(declined_name, zero);
+
+        if (!stats_mgr.getObservation(
+                StatsMgr::generateName("subnet", subnet_id,
+                                       "reclaimed-declined-addresses"))) {
+            stats_mgr.setValue(
+                StatsMgr::generateName("subnet", subnet_id,
+                                       "reclaimed-declined-addresses"),
+                zero);
+        }
+
+        if (!stats_mgr.getObservation(
+                StatsMgr::generateName("subnet", subnet_id,
+                                       "reclaimed-leases"))) {
+            stats_mgr.setValue(
+                StatsMgr::generateName("subnet", subnet_id,
+                                       "reclaimed-leases"),
+                zero);
+        }
+
+        LeaseStatsRow row;
+        while (query->getNextRow(row)) {
+            if (row.lease_state_ == Lease::STATE_DEFAULT) {
+                stats_mgr.addValue(StatsMgr::generateName("subnet", subnet_id,
+                                                          "assigned-addresses"),
+                                   row.state_count_);
+            } else if (row.lease_state_ == Lease::STATE_DECLINED) {
+                stats_mgr.setValue(declined_name, row.state_count_);
+
+                stats_mgr.addValue("declined-addresses", row.state_count_);
+
+                // Declined leases also count as assigned.
+                stats_mgr.addValue(StatsMgr::generateName("subnet", subnet_id,
+                                                          "assigned-addresses"),
+                                   row.state_count_);
+            }
+        }
+    }
+}
+
 LeaseStatsQuery::LeaseStatsQuery()
     : first_subnet_id_(0), last_subnet_id_(0), select_mode_(ALL_SUBNETS) {
 }
@@ -340,6 +954,98 @@ LeaseMgr::recountLeaseStats6() {
     }
 }
 
+void
+LeaseMgr::recountLeaseStats6(const SubnetIDSet& subnet_ids) {
+    using namespace stats;
+
+    StatsMgr& stats_mgr = StatsMgr::instance();
+
+    int64_t zero = 0;
+    if (!stats_mgr.getObservation("declined-addresses")) {
+        stats_mgr.setValue("declined-addresses", zero);
+    }
+
+    for (auto const& subnet_id : subnet_ids) {
+        LeaseStatsQueryPtr query = startSubnetLeaseStatsQuery6(subnet_id);
+        if (!query) {
+            /// NULL means not backend does not support recounting.
+            return;
+        }
+
+        // Remove the old declined value from the global value.
+        const std::string declined_name =
+            StatsMgr::generateName("subnet", subnet_id, "declined-addresses");
+        ObservationPtr declined = stats_mgr.getObservation(declined_name);
+        if (declined) {
+            stats_mgr.addValue("declined-addresses",
+                               -declined->getInteger().first);
+        }
+
+        stats_mgr.setValue(StatsMgr::generateName("subnet", subnet_id,
+                                                  "assigned-nas"),
+                           zero);
+        stats_mgr.setValue(declined_name, zero);
+        stats_mgr.setValue(StatsMgr::generateName("subnet", subnet_id,
+                                                  "assigned-pds"),
+                           zero);
+
+        if (!stats_mgr.getObservation(
+                StatsMgr::generateName("subnet", subnet_id,
+                                       "reclaimed-declined-addresses"))) {
+            stats_mgr.setValue(
+                StatsMgr::generateName("subnet", subnet_id,
+                                       "reclaimed-declined-addresses"),
+                zero);
+        }
+
+        if (!stats_mgr.getObservation(
+                StatsMgr::generateName("subnet", subnet_id,
+                                       "reclaimed-leases"))) {
+            stats_mgr.setValue(
+                StatsMgr::generateName("subnet", subnet_id,
+                                       "reclaimed-leases"),
+                zero);
+        }
+
+        LeaseStatsRow row;
+        while (query->getNextRow(row)) {
+            switch(row.lease_type_) {
+            case Lease::TYPE_NA:
+                if (row.lease_state_ == Lease::STATE_DEFAULT) {
+                    stats_mgr.addValue(StatsMgr::
+                                       generateName("subnet", subnet_id,
+                                                    "assigned-nas"),
+                                       row.state_count_);
+                } else if (row.lease_state_ == Lease::STATE_DECLINED) {
+                    stats_mgr.setValue(declined_name, row.state_count_);
+
+                    stats_mgr.addValue("declined-addresses", row.state_count_);
+
+                    // Declined leases also count as assigned.
+                    stats_mgr.addValue(StatsMgr::
+                                       generateName("subnet", subnet_id,
+                                                    "assigned-nas"),
+                                       row.state_count_);
+                }
+                break;
+
+            case Lease::TYPE_PD:
+                if (row.lease_state_ == Lease::STATE_DEFAULT) {
+                    stats_mgr.setValue(StatsMgr::
+                                       generateName("subnet", subnet_id,
+                                                    "assigned-pds"),
+                                       row.state_count_);
+                }
+                break;
+
+            default:
+                // We dont' support TYPE_TAs yet
+                break;
+            }
+        }
+    }
+}
+
 LeaseStatsQueryPtr
 LeaseMgr::startLeaseStatsQuery6() {
     return(LeaseStatsQueryPtr());
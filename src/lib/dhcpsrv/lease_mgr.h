@@ -17,15 +17,20 @@
 #include <dhcp/hwaddr.h>
 #include <dhcpsrv/cfg_consistency.h>
 #include <dhcpsrv/lease.h>
+#include <dhcpsrv/lease_async_executor.h>
 #include <dhcpsrv/subnet.h>
+#include <util/optional.h>
 
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -56,6 +61,47 @@ public:
     const size_t page_size_; ///< Holds page size.
 };
 
+/// @brief Filter of the paged lease queries.
+///
+/// Each criterion is ignored when it is not specified. The lease
+/// backends apply the filter while they walk their index so a page
+/// is returned without retrieving the leases which don't match.
+class LeasePageFilter {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// All the leases match the default filter.
+    LeasePageFilter()
+        : subnet_id_(0), state_(), min_expire_(), max_expire_(),
+          client_class_() {
+    }
+
+    /// @brief Checks if a lease matches the filter.
+    ///
+    /// @param lease The lease to check.
+    /// @return true if the lease satisfies all the specified criteria.
+    bool matches(const Lease& lease) const;
+
+    /// @brief Subnet identifier of the leases (0 means any subnet).
+    SubnetID subnet_id_;
+
+    /// @brief State of the leases.
+    util::Optional<uint32_t> state_;
+
+    /// @brief Minimum expiration time of the leases (inclusive).
+    util::Optional<int64_t> min_expire_;
+
+    /// @brief Maximum expiration time of the leases (inclusive).
+    util::Optional<int64_t> max_expire_;
+
+    /// @brief Client class the leases were assigned for (empty means any).
+    ///
+    /// The classes are taken from the "ISC/client-classes" entry of the
+    /// lease user context.
+    std::string client_class_;
+};
+
 /// @brief Contains a single row of lease statistical data
 ///
 /// The contents of the row consist of a subnet ID, a lease
@@ -226,7 +272,8 @@ class LeaseMgr {
 public:
     /// @brief Constructor
     ///
-    LeaseMgr() : extended_info_tables_enabled_(false)
+    LeaseMgr() : extended_info_tables_enabled_(false), async_executor_(),
+                 writer_executor_()
     {}
 
     /// @brief Destructor
@@ -373,6 +420,28 @@ public:
     getLeases4(const asiolink::IOAddress& lower_bound_address,
                const LeasePageSize& page_size) const = 0;
 
+    /// @brief Returns a page of IPv4 leases matching a filter.
+    ///
+    /// It works as the previous method and only returns the leases which
+    /// match the filter. The last address of the returned page is the
+    /// cursor for the next page.
+    ///
+    /// The default implementation walks the pages returned by the previous
+    /// method. The backends which can apply the filter in their indexes
+    /// override it so the time per page does not depend on the number of
+    /// leases which don't match.
+    ///
+    /// @param filter the filter of the leases.
+    /// @param lower_bound_address IPv4 address used as lower bound for the
+    /// returned range.
+    /// @param page_size maximum size of the page returned.
+    ///
+    /// @return Lease collection (may be empty if no IPv4 lease found).
+    virtual Lease4Collection
+    getFilteredLeases4(const LeasePageFilter& filter,
+                       const asiolink::IOAddress& lower_bound_address,
+                       const LeasePageSize& page_size) const;
+
     /// @brief Returns existing IPv6 lease for a given IPv6 address.
     ///
     /// For a given address, we assume that there will be only one lease.
@@ -386,6 +455,20 @@ public:
     virtual Lease6Ptr getLease6(Lease::Type type,
                                 const isc::asiolink::IOAddress& addr) const = 0;
 
+    /// @brief Returns existing IPv6 leases for given IPv6 addresses.
+    ///
+    /// This function is used to check a batch of addresses or prefixes,
+    /// e.g. the reservations of a client, with a single call. The default
+    /// implementation calls @c getLease6 for each address.
+    ///
+    /// @param type specifies lease type: (NA, TA or PD)
+    /// @param addresses addresses or prefixes of the searched leases
+    ///
+    /// @return Lease collection holding the leases which were found.
+    virtual Lease6Collection
+    getLeases6ByAddresses(Lease::Type type,
+                          const std::vector<asiolink::IOAddress>& addresses) const;
+
     /// @brief Returns existing IPv6 leases for a given DUID+IA combination
     ///
     /// Although in the usual case there will be only one lease, for mobile
@@ -552,6 +635,107 @@ public:
     ///        failed.
     virtual bool deleteLease(const Lease6Ptr& lease) = 0;
 
+    /// @name Bulk lease operations.
+    ///
+    /// These functions apply the same operation to a collection of leases,
+    /// e.g. the leases received from the partner during the HA lease
+    /// synchronization. The default implementations call the per lease
+    /// functions. The SQL backends override them to perform all the
+    /// operations in a single transaction, so a database error rolls back
+    /// the whole batch.
+    ///@{
+
+    /// @brief Adds IPv4 leases.
+    ///
+    /// @param leases leases to be added.
+    ///
+    /// @return number of leases added. The leases which already exist are
+    /// not added.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual size_t addLeases4(const Lease4Collection& leases);
+
+    /// @brief Adds IPv6 leases.
+    ///
+    /// @param leases leases to be added.
+    ///
+    /// @return number of leases added. The leases which already exist are
+    /// not added.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual size_t addLeases6(const Lease6Collection& leases);
+
+    /// @brief Updates IPv4 leases.
+    ///
+    /// @param leases leases to be updated.
+    ///
+    /// @return number of leases updated. The leases which do not exist,
+    /// i.e. for which @c updateLease4 would throw @c NoSuchLease, are
+    /// skipped.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual size_t updateLeases4(const Lease4Collection& leases);
+
+    /// @brief Updates IPv6 leases.
+    ///
+    /// @param leases leases to be updated.
+    ///
+    /// @return number of leases updated. The leases which do not exist,
+    /// i.e. for which @c updateLease6 would throw @c NoSuchLease, are
+    /// skipped.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual size_t updateLeases6(const Lease6Collection& leases);
+
+    /// @brief Deletes IPv4 leases.
+    ///
+    /// @param leases leases to be deleted.
+    ///
+    /// @return number of leases deleted.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual size_t deleteLeases4(const Lease4Collection& leases);
+
+    /// @brief Deletes IPv6 leases.
+    ///
+    /// @param leases leases to be deleted.
+    ///
+    /// @return number of leases deleted.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual size_t deleteLeases6(const Lease6Collection& leases);
+
+    ///@}
+
+    /// @brief Checks if the backend can pick and insert a free DHCPv4 lease
+    /// in a single operation.
+    ///
+    /// The default implementation returns false.
+    ///
+    /// @return true if @c addFreeLease4 is supported and enabled.
+    virtual bool canAddFreeLease4() const;
+
+    /// @brief Picks and inserts a free DHCPv4 lease of an address range.
+    ///
+    /// Looks for the lowest address of the range which has no lease and
+    /// inserts the lease for this address atomically, in a single round
+    /// trip with the SQL backends. The address of the lease is replaced
+    /// by the picked address when the lease is inserted.
+    ///
+    /// The default implementation does not insert any lease.
+    ///
+    /// @param lease The lease to insert: all but its address is used.
+    /// @param first_address The first address of the range.
+    /// @param last_address The last address of the range.
+    /// @return true if the lease was inserted, false if the backend does
+    /// not support it, if all the addresses of the range have a lease or
+    /// if another client got the picked address first.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual bool addFreeLease4(const Lease4Ptr& lease,
+                               const isc::asiolink::IOAddress& first_address,
+                               const isc::asiolink::IOAddress& last_address);
+
     /// @brief Deletes all expired and reclaimed DHCPv4 leases.
     ///
     /// @param secs Number of seconds since expiration of leases before
@@ -561,6 +745,31 @@ public:
     /// @return Number of leases deleted.
     virtual uint64_t deleteExpiredReclaimedLeases4(const uint32_t secs) = 0;
 
+    /// @brief Reclaims a batch of expired DHCPv4 leases.
+    ///
+    /// Reclaims at most @c max_leases expired leases, from the most to the
+    /// least expired: the leases are deleted or their state is set to
+    /// expired-reclaimed and their DNS information is cleared. This is
+    /// intended to be used when no callouts has to be called for each
+    /// lease: the SQL backends reclaim the batch in the database rather
+    /// than with a statement per lease.
+    ///
+    /// The default implementation reclaims the leases one by one.
+    ///
+    /// @param [out] reclaimed_leases A container to which the reclaimed
+    /// leases are added, as they were before the reclamation.
+    /// @param max_leases A maximum number of leases to be reclaimed. If this
+    /// value is set to 0, all expired (but not reclaimed) leases are
+    /// reclaimed.
+    /// @param remove_lease Delete the leases rather than setting their state
+    /// to expired-reclaimed.
+    /// @return Number of reclaimed leases.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual size_t reclaimExpiredLeases4(Lease4Collection& reclaimed_leases,
+                                         const size_t max_leases,
+                                         const bool remove_lease);
+
     /// @brief Deletes all expired and reclaimed DHCPv6 leases.
     ///
     /// @param secs Number of seconds since expiration of leases before
@@ -589,6 +798,17 @@ public:
     /// adding to the appropriate global statistic.
     void recountLeaseStats4();
 
+    /// @brief Recalculates the stats of some IPv4 subnets
+    ///
+    /// It recalculates the same statistics as the previous method but only
+    /// for the listed subnets using one stats query per subnet. The global
+    /// declined-addresses statistic is adjusted by the difference between
+    /// the old and the new subnet values. It is used after a configuration
+    /// change to recount only the subnets the change introduced.
+    ///
+    /// @param subnet_ids identifiers of the subnets to recount.
+    void recountLeaseStats4(const SubnetIDSet& subnet_ids);
+
     /// @brief Creates and runs the IPv4 lease stats query for all subnets
     ///
     /// LeaseMgr derivations implement this method such that it creates and
@@ -646,6 +866,16 @@ public:
     /// per subnet and adding to the appropriate global statistic.
     void recountLeaseStats6();
 
+    /// @brief Recalculates the stats of some IPv6 subnets
+    ///
+    /// It recalculates the same statistics as the previous method but only
+    /// for the listed subnets using one stats query per subnet. The global
+    /// declined-addresses statistic is adjusted by the difference between
+    /// the old and the new subnet values.
+    ///
+    /// @param subnet_ids identifiers of the subnets to recount.
+    void recountLeaseStats6(const SubnetIDSet& subnet_ids);
+
     /// @brief Creates and runs the IPv6 lease stats query for all subnets
     ///
     /// LeaseMgr derivations implement this method such that it creates and
@@ -754,6 +984,14 @@ public:
     /// @return Description of the backend.
     virtual std::string getDescription() const = 0;
 
+    /// @brief Returns the memory usage of the backend.
+    ///
+    /// The default implementation returns an empty map: the backends
+    /// keeping the leases in a database server use little memory.
+    ///
+    /// @return A map with the numbers of the entries held in memory.
+    virtual data::ElementPtr getMemoryStats() const;
+
     /// @brief Returns backend version.
     ///
     /// @return Version number as a pair of unsigned integers.  "first" is the
@@ -977,8 +1215,232 @@ public:
     /// @return The number of updates in the database or 0.
     virtual size_t buildExtendedInfoTables6(bool update, bool current) = 0;
 
+    /// @brief Function invoked when lease changes are durable.
+    ///
+    /// The argument is false when the changes could not be written.
+    typedef std::function<void(bool)> DurableCallback;
+
+    /// @brief Registers a callback invoked when the lease changes made by
+    /// the current thread are durable.
+    ///
+    /// The backends writing the lease changes before the functions changing
+    /// the leases return don't register the callback.
+    ///
+    /// @param callback Function to invoke.
+    ///
+    /// @return true if the callback was registered, false if the changes
+    /// are already durable and the callback will not be invoked.
+    ///
+    /// The default implementation tracks the asynchronous lease operations
+    /// submitted by the current thread.
+    virtual bool whenLeasesDurable(const DurableCallback& callback);
+
+    /// @name Asynchronous lease operations.
+    ///
+    /// When the asynchronous operations are started and the multi-threading
+    /// is enabled these functions return immediately and the operation is
+    /// executed by a thread of the lease manager later. The operations on
+    /// the same address are executed in order. The lease passed to the
+    /// function is copied so the caller can use it. Its current expiration
+    /// time is updated as if the operation succeeded.
+    ///
+    /// Otherwise the operation is executed immediately and the callback is
+    /// invoked before the function returns.
+    ///
+    /// The caller can use @c whenLeasesDurable to wait for the completion of
+    /// the asynchronous operations it submitted, e.g. to park a DHCP query
+    /// until the database acknowledged the lease changes.
+    ///@{
+
+    /// @brief Function invoked when an asynchronous lease operation
+    /// completes.
+    ///
+    /// The first argument is the value returned by the synchronous
+    /// function (always true for the update). The second argument holds
+    /// the exception thrown by the synchronous function, null on success.
+    typedef std::function<void(bool, std::exception_ptr)> AsyncCallback;
+
+    /// @brief Adds an IPv4 lease asynchronously.
+    ///
+    /// @param lease Lease to be added.
+    /// @param callback Function invoked on completion (can be null).
+    void addLeaseAsync(const Lease4Ptr& lease, const AsyncCallback& callback);
+
+    /// @brief Adds an IPv6 lease asynchronously.
+    ///
+    /// @param lease Lease to be added.
+    /// @param callback Function invoked on completion (can be null).
+    void addLeaseAsync(const Lease6Ptr& lease, const AsyncCallback& callback);
+
+    /// @brief Updates an IPv4 lease asynchronously.
+    ///
+    /// @param lease Lease to be updated.
+    /// @param callback Function invoked on completion (can be null).
+    void updateLease4Async(const Lease4Ptr& lease, const AsyncCallback& callback);
+
+    /// @brief Updates an IPv6 lease asynchronously.
+    ///
+    /// @param lease Lease to be updated.
+    /// @param callback Function invoked on completion (can be null).
+    void updateLease6Async(const Lease6Ptr& lease, const AsyncCallback& callback);
+
+    /// @brief Deletes an IPv4 lease asynchronously.
+    ///
+    /// @param lease Lease to be deleted.
+    /// @param callback Function invoked on completion (can be null).
+    void deleteLeaseAsync(const Lease4Ptr& lease, const AsyncCallback& callback);
+
+    /// @brief Deletes an IPv6 lease asynchronously.
+    ///
+    /// @param lease Lease to be deleted.
+    /// @param callback Function invoked on completion (can be null).
+    void deleteLeaseAsync(const Lease6Ptr& lease, const AsyncCallback& callback);
+
+    /// @brief Checks if the lease operations are executed asynchronously.
+    ///
+    /// @return true if the asynchronous operations are started and the
+    /// multi-threading is enabled.
+    bool isAsync() const;
+
+    /// @brief Waits until the asynchronous operations submitted by the
+    /// current thread complete.
+    ///
+    /// The backends call it before a synchronous lease change so it is
+    /// not overtaken by an asynchronous change submitted before.
+    void waitForAsync();
+
+    ///@}
+
+    /// @brief Checks if the synchronous lease changes of the current
+    /// thread are executed by the writer threads.
+    ///
+    /// @return true if the writer threads are started, the
+    /// multi-threading is enabled and the current thread is neither a
+    /// writer thread nor an asynchronous operation thread.
+    bool isWriteDelegated() const;
+
 protected:
 
+    /// @brief Starts the threads executing the asynchronous operations.
+    ///
+    /// @param thread_count Number of threads, 0 to execute the operations
+    /// synchronously.
+    void startAsync(uint32_t thread_count);
+
+    /// @brief Executes the pending asynchronous operations and stops the
+    /// threads.
+    ///
+    /// The backends starting the asynchronous operations must call it in
+    /// their destructor before the resources used by the operations are
+    /// released.
+    void stopAsync();
+
+    /// @brief Returns the number of threads executing the asynchronous
+    /// operations configured in the parameters.
+    ///
+    /// @param parameters The parameter map.
+    /// @return The value of the async-threads parameter or 0.
+    /// @throw BadValue if the value is invalid.
+    static uint32_t getAsyncThreads(const db::DatabaseConnection::ParameterMap& parameters);
+
+    /// @brief Starts the threads executing the synchronous lease changes.
+    ///
+    /// The backends give the writer threads their own pool of database
+    /// contexts, filled with one context per writer thread, so the
+    /// number of connections writing to the database does not depend on
+    /// the number of packet processing threads.
+    ///
+    /// @param thread_count Number of threads, 0 to execute the changes
+    /// by the calling threads.
+    void startWriters(uint32_t thread_count);
+
+    /// @brief Executes the pending lease changes and stops the writer
+    /// threads.
+    ///
+    /// The backends starting the writer threads must call it in their
+    /// destructor before the resources used by the changes are released.
+    void stopWriters();
+
+    /// @brief Executes a synchronous lease change by a writer thread
+    /// when the changes of the current thread are delegated.
+    ///
+    /// The backends call it at the beginning of their lease changes and
+    /// return when it returns true. The call is synchronous: the calling
+    /// thread is blocked until the change and the asynchronous operations
+    /// it submitted before complete. The changes on the same address are
+    /// executed in order.
+    ///
+    /// @param lease The lease to change.
+    /// @param operation Function executing the change. It is called by
+    /// a writer thread so the change is not delegated again.
+    /// @param[out] result The value returned by the operation.
+    /// @return true if the change was executed by a writer thread, false
+    /// if it must be executed by the calling thread.
+    /// @throw The exception thrown by the operation.
+    bool delegateWrite(const LeasePtr& lease,
+                       const std::function<bool()>& operation,
+                       bool& result);
+
+    /// @brief Checks if the current thread is a writer thread.
+    ///
+    /// The backends use it to take the contexts of the writer threads.
+    ///
+    /// @return true if the current thread executes a delegated change.
+    static bool isWriterThread();
+
+    /// @brief Returns the number of threads executing the synchronous
+    /// lease changes configured in the parameters.
+    ///
+    /// @param parameters The parameter map.
+    /// @return The value of the writer-threads parameter or 0.
+    /// @throw BadValue if the value is invalid.
+    static uint32_t getWriterThreads(const db::DatabaseConnection::ParameterMap& parameters);
+
+    /// @brief Returns the number of database contexts to create when the
+    /// backend is opened, configured in the parameters.
+    ///
+    /// @param parameters The parameter map.
+    /// @return The value of the pool-size parameter or 0.
+    /// @throw BadValue if the value is invalid.
+    static uint32_t getPoolSize(const db::DatabaseConnection::ParameterMap& parameters);
+
+    /// @brief Creates database contexts in parallel.
+    ///
+    /// Each context is created by its own thread so the connections are
+    /// opened and the statements are prepared concurrently.
+    ///
+    /// @tparam ContextPtr Type of the pointers to contexts.
+    /// @param count Number of contexts to create.
+    /// @param create Function creating a context.
+    /// @return The created contexts.
+    /// @throw The first exception thrown by the create function.
+    template<typename ContextPtr>
+    static std::vector<ContextPtr>
+    createContexts(size_t count, const std::function<ContextPtr()>& create) {
+        std::vector<ContextPtr> contexts(count);
+        std::vector<std::exception_ptr> errors(count);
+        std::vector<std::thread> threads;
+        threads.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            threads.push_back(std::thread([&contexts, &errors, &create, i]() {
+                try {
+                    contexts[i] = create();
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (auto const& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        return (contexts);
+    }
+
     /// Extended information / Bulk Lease Query shared interface.
 
     /// @brief Modifies the setting whether the lease extended info tables
@@ -1029,9 +1491,24 @@ private:
     /// The IOService object, used for all ASIO operations.
     static isc::asiolink::IOServicePtr io_service_;
 
+    /// @brief Submits an asynchronous lease operation.
+    ///
+    /// @param address Address of the lease.
+    /// @param operation Function executing the synchronous operation.
+    /// @param callback Function invoked on completion (can be null).
+    void submitAsync(const asiolink::IOAddress& address,
+                     const std::function<bool()>& operation,
+                     const AsyncCallback& callback);
+
     /// @brief Holds the setting whether the lease extended info tables
     /// are enabled or disabled. The default is disabled.
     bool extended_info_tables_enabled_;
+
+    /// @brief Executes the asynchronous operations when started.
+    LeaseAsyncExecutorPtr async_executor_;
+
+    /// @brief Executes the synchronous lease changes when started.
+    LeaseAsyncExecutorPtr writer_executor_;
 };
 
 }  // namespace dhcp
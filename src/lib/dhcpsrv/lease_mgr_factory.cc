@@ -15,6 +15,9 @@
 #ifdef HAVE_PGSQL
 #include <dhcpsrv/pgsql_lease_mgr.h>
 #endif
+#ifdef HAVE_LMDB
+#include <dhcpsrv/lmdb_lease_mgr.h>
+#endif
 
 #include <boost/algorithm/string.hpp>
 #include <boost/foreach.hpp>
@@ -38,8 +41,8 @@ LeaseMgrFactory::getLeaseMgrPtr() {
     return (lease_mgr_ptr);
 }
 
-void
-LeaseMgrFactory::create(const std::string& dbaccess) {
+TrackingLeaseMgr*
+LeaseMgrFactory::newLeaseMgr(const std::string& dbaccess) {
     const std::string type = "type";
 
     // Parse the access string and create a redacted string for logging.
@@ -58,8 +61,7 @@ LeaseMgrFactory::create(const std::string& dbaccess) {
     if (parameters[type] == string("mysql")) {
 #ifdef HAVE_MYSQL
         LOG_INFO(dhcpsrv_logger, DHCPSRV_MYSQL_DB).arg(redacted);
-        getLeaseMgrPtr().reset(new MySqlLeaseMgr(parameters));
-        return;
+        return (new MySqlLeaseMgr(parameters));
 #else
         LOG_ERROR(dhcpsrv_logger, DHCPSRV_UNKNOWN_DB).arg("mysql");
         isc_throw(InvalidType, "The Kea server has not been compiled with "
@@ -70,18 +72,26 @@ LeaseMgrFactory::create(const std::string& dbaccess) {
     if (parameters[type] == string("postgresql")) {
 #ifdef HAVE_PGSQL
         LOG_INFO(dhcpsrv_logger, DHCPSRV_PGSQL_DB).arg(redacted);
-        getLeaseMgrPtr().reset(new PgSqlLeaseMgr(parameters));
-        return;
+        return (new PgSqlLeaseMgr(parameters));
 #else
         LOG_ERROR(dhcpsrv_logger, DHCPSRV_UNKNOWN_DB).arg("postgresql");
         isc_throw(InvalidType, "The Kea server has not been compiled with "
                   "support for database type: postgresql");
+#endif
+    }
+    if (parameters[type] == string("lmdb")) {
+#ifdef HAVE_LMDB
+        LOG_INFO(dhcpsrv_logger, DHCPSRV_LMDB_DB).arg(redacted);
+        return (new LmdbLeaseMgr(parameters));
+#else
+        LOG_ERROR(dhcpsrv_logger, DHCPSRV_UNKNOWN_DB).arg("lmdb");
+        isc_throw(InvalidType, "The Kea server has not been compiled with "
+                  "support for database type: lmdb");
 #endif
     }
     if (parameters[type] == string("memfile")) {
         LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_DB).arg(redacted);
-        getLeaseMgrPtr().reset(new Memfile_LeaseMgr(parameters));
-        return;
+        return (new Memfile_LeaseMgr(parameters));
     }
 
     // Get here on no match
@@ -90,6 +100,16 @@ LeaseMgrFactory::create(const std::string& dbaccess) {
               "not specify a supported database backend: " << parameters[type]);
 }
 
+void
+LeaseMgrFactory::create(const std::string& dbaccess) {
+    getLeaseMgrPtr().reset(newLeaseMgr(dbaccess));
+}
+
+TrackingLeaseMgrPtr
+LeaseMgrFactory::createLeaseMgr(const std::string& dbaccess) {
+    return (TrackingLeaseMgrPtr(newLeaseMgr(dbaccess)));
+}
+
 void
 LeaseMgrFactory::destroy() {
     // Destroy current lease manager.  This is a no-op if no lease manager
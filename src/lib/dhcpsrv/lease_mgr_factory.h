@@ -69,6 +69,22 @@ public:
     ///        identify a supported backend.
     static void create(const std::string& dbaccess);
 
+    /// @brief Create a lease manager which is not the current one.
+    ///
+    /// The lease manager is created as by @c create but it is returned
+    /// to the caller instead of becoming the current lease manager. It
+    /// is used by the tools which open several lease databases at once,
+    /// e.g. to migrate the leases from one backend to another.
+    ///
+    /// @param dbaccess Database access parameters.
+    ///
+    /// @return Pointer to the new lease manager.
+    /// @throw isc::InvalidParameter dbaccess string does not contain the "type"
+    ///        keyword.
+    /// @throw isc::dhcp::InvalidType The "type" keyword in dbaccess does not
+    ///        identify a supported backend.
+    static TrackingLeaseMgrPtr createLeaseMgr(const std::string& dbaccess);
+
     /// @brief Destroy lease manager
     ///
     /// Destroys the current lease manager object.  This should have the effect
@@ -111,6 +127,13 @@ private:
     /// fiasco" if defined in an external static variable.
     static boost::scoped_ptr<TrackingLeaseMgr>& getLeaseMgrPtr();
 
+    /// @brief Allocates a lease manager.
+    ///
+    /// @param dbaccess Database access parameters.
+    ///
+    /// @return Pointer to the new lease manager owned by the caller.
+    static TrackingLeaseMgr* newLeaseMgr(const std::string& dbaccess);
+
 };
 
 } // end of isc::dhcp namespace
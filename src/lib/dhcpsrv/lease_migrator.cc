@@ -0,0 +1,179 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/dhcpsrv_log.h>
+#include <dhcpsrv/lease_migrator.h>
+#include <exceptions/exceptions.h>
+#include <util/multi_threading_mgr.h>
+#include <util/thread_pool.h>
+
+#include <boost/make_shared.hpp>
+
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+using namespace isc::asiolink;
+using namespace isc::util;
+
+namespace isc {
+namespace dhcp {
+
+const size_t LeaseMigrator::DEFAULT_PAGE_SIZE;
+
+LeaseMigrator::LeaseMigrator(const LeaseMgr& source, LeaseMgr& destination,
+                             size_t page_size, size_t thread_count)
+    : source_(source), destination_(destination), page_size_(page_size),
+      thread_count_(thread_count), read_leases_(0), added_leases_(0) {
+    if ((page_size_ == 0) ||
+        (page_size_ > std::numeric_limits<uint32_t>::max())) {
+        isc_throw(BadValue, "invalid lease migration page size "
+                  << page_size_);
+    }
+    if (thread_count_ == 0) {
+        isc_throw(BadValue, "the lease migration requires at least one"
+                  " thread");
+    }
+    if ((thread_count_ > 1) && !MultiThreadingMgr::instance().getMode()) {
+        isc_throw(InvalidOperation, "the lease migration with "
+                  << thread_count_ << " threads requires the"
+                  " multi-threading mode");
+    }
+}
+
+size_t
+LeaseMigrator::migrate4() {
+    const LeaseMgr& source = source_;
+    LeaseMgr& destination = destination_;
+    const LeasePageSize page_size(page_size_);
+    return (migrate<Lease4Collection>(4, IOAddress::IPV4_ZERO_ADDRESS(),
+        [&source, &page_size](const IOAddress& lower_bound) {
+            return (source.getLeases4(lower_bound, page_size));
+        },
+        [&destination](const Lease4Collection& leases) {
+            return (destination.addLeases4(leases));
+        }));
+}
+
+size_t
+LeaseMigrator::migrate6() {
+    const LeaseMgr& source = source_;
+    LeaseMgr& destination = destination_;
+    const LeasePageSize page_size(page_size_);
+    return (migrate<Lease6Collection>(6, IOAddress::IPV6_ZERO_ADDRESS(),
+        [&source, &page_size](const IOAddress& lower_bound) {
+            return (source.getLeases6(lower_bound, page_size));
+        },
+        [&destination](const Lease6Collection& leases) {
+            return (destination.addLeases6(leases));
+        }));
+}
+
+template<typename CollectionType>
+size_t
+LeaseMigrator::migrate(const uint16_t universe,
+                       const IOAddress& first_address,
+                       const std::function<CollectionType(const IOAddress&)>& get_page,
+                       const std::function<size_t(const CollectionType&)>& add_leases) {
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_LEASE_MIGRATE_START)
+        .arg(universe)
+        .arg(source_.getType())
+        .arg(destination_.getType())
+        .arg(page_size_)
+        .arg(thread_count_);
+
+    typedef std::function<void()> WorkItem;
+
+    read_leases_ = 0;
+    added_leases_ = 0;
+
+    // The parts of the page and the results must outlive the thread pool
+    // which may still be adding them when an exception is thrown.
+    std::vector<CollectionType> parts(thread_count_);
+    std::atomic<size_t> added(0);
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    ThreadPool<WorkItem> pool;
+    pool.start(thread_count_);
+
+    // Splits the page between the threads. Each part is added in its
+    // own transaction by the SQL backends.
+    auto dispatch = [&](const CollectionType& page) {
+        const size_t part_size = (page.size() + thread_count_ - 1) / thread_count_;
+        for (size_t i = 0; i < thread_count_; ++i) {
+            const size_t first = i * part_size;
+            if (first >= page.size()) {
+                break;
+            }
+            const size_t last = std::min(first + part_size, page.size());
+            CollectionType& part = parts[i];
+            part.assign(page.begin() + first, page.begin() + last);
+            pool.add(boost::make_shared<WorkItem>([&, i]() {
+                try {
+                    added += add_leases(parts[i]);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            }));
+        }
+    };
+
+    try {
+        CollectionType current = get_page(first_address);
+        while (!current.empty()) {
+            dispatch(current);
+
+            // Read the next page while the current one is added. A short
+            // page is the last page.
+            CollectionType next;
+            if (current.size() >= page_size_) {
+                next = get_page(current.back()->addr_);
+            }
+
+            pool.wait();
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+            read_leases_ += current.size();
+            added_leases_ = added;
+
+            LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+                      DHCPSRV_LEASE_MIGRATE_PAGE)
+                .arg(current.size())
+                .arg(universe)
+                .arg(read_leases_);
+
+            current.swap(next);
+        }
+    } catch (...) {
+        pool.stop();
+        added_leases_ = added;
+        throw;
+    }
+    pool.stop();
+
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_LEASE_MIGRATE_COMPLETE)
+        .arg(universe)
+        .arg(source_.getType())
+        .arg(destination_.getType())
+        .arg(read_leases_)
+        .arg(added_leases_);
+
+    return (added_leases_);
+}
+
+} // namespace dhcp
+} // namespace isc
@@ -0,0 +1,115 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_MIGRATOR_H
+#define LEASE_MIGRATOR_H
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/lease_mgr.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <functional>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Copies the leases from one lease database to another.
+///
+/// The leases are read from the source lease manager by pages, using
+/// the paged @c getLeases4 and @c getLeases6 queries, and they are added
+/// to the destination lease manager with the bulk @c addLeases4 and
+/// @c addLeases6 operations. While the calling thread reads the next page
+/// a pool of threads adds the current page, each thread adding its own
+/// part of the page in a separate transaction.
+///
+/// The leases which already exist in the destination database are not
+/// added, so an interrupted migration can be run again.
+///
+/// @note When there are several threads the destination lease manager
+/// is used concurrently so the multi-threading mode must be enabled.
+class LeaseMigrator : public boost::noncopyable {
+public:
+
+    /// @brief Default number of leases read from the source at once.
+    static const size_t DEFAULT_PAGE_SIZE = 1000;
+
+    /// @brief Constructor.
+    ///
+    /// @param source Lease manager the leases are read from.
+    /// @param destination Lease manager the leases are added to.
+    /// @param page_size Number of leases read from the source at once.
+    /// @param thread_count Number of threads adding the leases.
+    /// @throw BadValue if the page size or the thread count is 0 or if
+    /// the page size is greater than the uint32_t numeric limit.
+    /// @throw InvalidOperation if there are several threads and the
+    /// multi-threading mode is not enabled.
+    LeaseMigrator(const LeaseMgr& source, LeaseMgr& destination,
+                  size_t page_size = DEFAULT_PAGE_SIZE,
+                  size_t thread_count = 1);
+
+    /// @brief Migrates the DHCPv4 leases.
+    ///
+    /// @return Number of leases added to the destination.
+    /// @throw The first exception thrown by the lease managers.
+    size_t migrate4();
+
+    /// @brief Migrates the DHCPv6 leases.
+    ///
+    /// @return Number of leases added to the destination.
+    /// @throw The first exception thrown by the lease managers.
+    size_t migrate6();
+
+    /// @brief Returns the number of leases read by the last migration.
+    size_t getReadLeases() const {
+        return (read_leases_);
+    }
+
+    /// @brief Returns the number of leases added by the last migration.
+    size_t getAddedLeases() const {
+        return (added_leases_);
+    }
+
+private:
+
+    /// @brief Migrates the leases of one family.
+    ///
+    /// @param universe DHCP version used for logging.
+    /// @param first_address The zero address of the family.
+    /// @param get_page Function reading the page following an address.
+    /// @param add_leases Function adding leases to the destination and
+    /// returning the number of leases added.
+    /// @tparam CollectionType A @c Lease4Collection or @c Lease6Collection.
+    /// @return Number of leases added to the destination.
+    template<typename CollectionType>
+    size_t migrate(const uint16_t universe,
+                   const asiolink::IOAddress& first_address,
+                   const std::function<CollectionType(const asiolink::IOAddress&)>& get_page,
+                   const std::function<size_t(const CollectionType&)>& add_leases);
+
+    /// @brief Source lease manager.
+    const LeaseMgr& source_;
+
+    /// @brief Destination lease manager.
+    LeaseMgr& destination_;
+
+    /// @brief Number of leases read from the source at once.
+    size_t page_size_;
+
+    /// @brief Number of threads adding the leases.
+    size_t thread_count_;
+
+    /// @brief Number of leases read by the last migration.
+    size_t read_leases_;
+
+    /// @brief Number of leases added by the last migration.
+    size_t added_leases_;
+};
+
+} // namespace dhcp
+} // namespace isc
+
+#endif // LEASE_MIGRATOR_H
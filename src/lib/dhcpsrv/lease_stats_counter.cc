@@ -0,0 +1,234 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/lease_stats_counter.h>
+#include <exceptions/exceptions.h>
+#include <util/multi_threading_mgr.h>
+
+#include <limits>
+
+using namespace isc::asiolink;
+using namespace isc::util;
+
+namespace isc {
+namespace dhcp {
+
+LeaseStatsCounter::LeaseStatsCounter() : mutex_(new std::mutex) {
+}
+
+void
+LeaseStatsCounter::addLease(const LeasePtr& lease) {
+    if (!lease) {
+        isc_throw(BadValue, "addLease - lease cannot be empty");
+    }
+
+    MultiThreadingLock lock(*mutex_);
+    // The lease should not be counted yet but a stale entry must not be
+    // counted twice.
+    uncountInternal(lease);
+    countInternal(lease);
+}
+
+void
+LeaseStatsCounter::updateLease(const LeasePtr& lease) {
+    if (!lease) {
+        isc_throw(BadValue, "updateLease - lease cannot be empty");
+    }
+
+    MultiThreadingLock lock(*mutex_);
+    uncountInternal(lease);
+    countInternal(lease);
+}
+
+void
+LeaseStatsCounter::removeLease(const LeasePtr& lease) {
+    if (!lease) {
+        isc_throw(BadValue, "removeLease - lease cannot be empty");
+    }
+
+    MultiThreadingLock lock(*mutex_);
+    uncountInternal(lease);
+}
+
+size_t
+LeaseStatsCounter::removeExpiredReclaimedLeases(uint16_t family,
+                                                int64_t expire_before) {
+    MultiThreadingLock lock(*mutex_);
+    size_t removed = 0;
+    for (auto it = leases_.begin(); it != leases_.end(); ) {
+        const CountedLease& counted = it->second;
+        if ((it->first.getFamily() == family) &&
+            (counted.state_ == Lease::STATE_EXPIRED_RECLAIMED) &&
+            (counted.expire_ < expire_before)) {
+            adjustCount(CountKey(counted.subnet_id_, counted.type_,
+                                 counted.state_), -1);
+            it = leases_.erase(it);
+            ++removed;
+        } else {
+            ++it;
+        }
+    }
+    return (removed);
+}
+
+std::vector<LeaseStatsRow>
+LeaseStatsCounter::getRows(uint16_t family, const SubnetID& first_subnet_id,
+                           const SubnetID& last_subnet_id) const {
+    std::vector<LeaseStatsRow> rows;
+    MultiThreadingLock lock(*mutex_);
+    const CountMap& counts = (family == AF_INET ? counts4_ : counts6_);
+    auto upper = counts.upper_bound(CountKey(last_subnet_id,
+                                             Lease::TYPE_V4,
+                                             std::numeric_limits<uint32_t>::max()));
+    for (auto it = counts.lower_bound(CountKey(first_subnet_id, Lease::TYPE_NA, 0));
+         it != upper; ++it) {
+        if (family == AF_INET) {
+            rows.push_back(LeaseStatsRow(std::get<0>(it->first),
+                                         std::get<2>(it->first),
+                                         it->second));
+        } else {
+            rows.push_back(LeaseStatsRow(std::get<0>(it->first),
+                                         std::get<1>(it->first),
+                                         std::get<2>(it->first),
+                                         it->second));
+        }
+    }
+    return (rows);
+}
+
+int64_t
+LeaseStatsCounter::getCount(const SubnetID& subnet_id, const Lease::Type& ltype,
+                            uint32_t state) const {
+    MultiThreadingLock lock(*mutex_);
+    const CountMap& counts = (ltype == Lease::TYPE_V4 ? counts4_ : counts6_);
+    auto it = counts.find(CountKey(subnet_id, ltype, state));
+    return (it == counts.end() ? 0 : it->second);
+}
+
+size_t
+LeaseStatsCounter::getLeaseCount() const {
+    MultiThreadingLock lock(*mutex_);
+    return (leases_.size());
+}
+
+void
+LeaseStatsCounter::clear(uint16_t family) {
+    MultiThreadingLock lock(*mutex_);
+    for (auto it = leases_.begin(); it != leases_.end(); ) {
+        if (it->first.getFamily() == family) {
+            it = leases_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (family == AF_INET) {
+        counts4_.clear();
+    } else {
+        counts6_.clear();
+    }
+}
+
+void
+LeaseStatsCounter::clear() {
+    MultiThreadingLock lock(*mutex_);
+    leases_.clear();
+    counts4_.clear();
+    counts6_.clear();
+}
+
+void
+LeaseStatsCounter::countInternal(const LeasePtr& lease) {
+    CountedLease counted{lease->getType(), lease->subnet_id_, lease->state_,
+                         lease->getExpirationTime()};
+    adjustCount(CountKey(counted.subnet_id_, counted.type_, counted.state_), 1);
+    leases_[lease->addr_] = counted;
+}
+
+void
+LeaseStatsCounter::uncountInternal(const LeasePtr& lease) {
+    auto it = leases_.find(lease->addr_);
+    if (it == leases_.end()) {
+        return;
+    }
+
+    const CountedLease& counted = it->second;
+    adjustCount(CountKey(counted.subnet_id_, counted.type_, counted.state_), -1);
+    leases_.erase(it);
+}
+
+void
+LeaseStatsCounter::adjustCount(const CountKey& key, int64_t offset) {
+    CountMap& counts = getCounts(std::get<1>(key));
+    int64_t& count = counts[key];
+    count += offset;
+    if (count <= 0) {
+        counts.erase(key);
+    }
+}
+
+LeaseStatsCounterQuery::LeaseStatsCounterQuery(const LeaseStatsCounter& counter,
+                                               uint16_t family)
+    : LeaseStatsQuery(), counter_(counter), family_(family), rows_(),
+      next_pos_(0) {
+}
+
+LeaseStatsCounterQuery::LeaseStatsCounterQuery(const LeaseStatsCounter& counter,
+                                               uint16_t family,
+                                               const SubnetID& subnet_id)
+    : LeaseStatsQuery(subnet_id), counter_(counter), family_(family), rows_(),
+      next_pos_(0) {
+}
+
+LeaseStatsCounterQuery::LeaseStatsCounterQuery(const LeaseStatsCounter& counter,
+                                               uint16_t family,
+                                               const SubnetID& first_subnet_id,
+                                               const SubnetID& last_subnet_id)
+    : LeaseStatsQuery(first_subnet_id, last_subnet_id), counter_(counter),
+      family_(family), rows_(), next_pos_(0) {
+}
+
+void
+LeaseStatsCounterQuery::start() {
+    std::vector<LeaseStatsRow> rows;
+    switch (getSelectMode()) {
+    case ALL_SUBNETS:
+        rows = counter_.getRows(family_, 0, std::numeric_limits<SubnetID>::max());
+        break;
+    case SINGLE_SUBNET:
+        rows = counter_.getRows(family_, first_subnet_id_, first_subnet_id_);
+        break;
+    default:
+        rows = counter_.getRows(family_, first_subnet_id_, last_subnet_id_);
+        break;
+    }
+
+    // As the other lease statistics queries only the assigned and declined
+    // leases are returned.
+    rows_.clear();
+    for (auto const& row : rows) {
+        if ((row.lease_state_ == Lease::STATE_DEFAULT) ||
+            (row.lease_state_ == Lease::STATE_DECLINED)) {
+            rows_.push_back(row);
+        }
+    }
+    next_pos_ = 0;
+}
+
+bool
+LeaseStatsCounterQuery::getNextRow(LeaseStatsRow& row) {
+    if (next_pos_ >= rows_.size()) {
+        return (false);
+    }
+
+    row = rows_[next_pos_];
+    ++next_pos_;
+    return (true);
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
@@ -0,0 +1,250 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_STATS_COUNTER_H
+#define LEASE_STATS_COUNTER_H
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/lease_mgr.h>
+#include <dhcpsrv/subnet_id.h>
+
+#include <boost/scoped_ptr.hpp>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Incrementally maintained lease counts per subnet, lease type
+/// and lease state.
+///
+/// The lease statistics queries (see @c LeaseStatsQuery) count the
+/// leases each time they are started, i.e. the backends scan the leases
+/// or query the database for every statistics request. This counter
+/// keeps the counts in memory instead. It is updated by the
+/// @c TrackingLeaseMgr each time a lease is added, updated or deleted,
+/// so a statistics query only has to copy the counts.
+///
+/// As the @c LeaseLimitCounter, this counter is not given the previous
+/// version of an updated lease. It remembers the subnet, type, state and
+/// expiration time each counted lease contributed with, so an update or
+/// a deletion only needs the address of the lease.
+///
+/// The counts reflect the lease changes made by this server only, so the
+/// counter must be used only when no other server writes the same leases.
+///
+/// The counter is thread safe.
+class LeaseStatsCounter {
+public:
+
+    /// @brief Constructor.
+    LeaseStatsCounter();
+
+    /// @brief Counts a new lease.
+    ///
+    /// @param lease lease which was added.
+    void addLease(const LeasePtr& lease);
+
+    /// @brief Recounts an updated lease.
+    ///
+    /// The previous contribution of the lease is reversed before the new
+    /// version of the lease is counted.
+    ///
+    /// @param lease new version of the lease.
+    void updateLease(const LeasePtr& lease);
+
+    /// @brief Stops counting a deleted lease.
+    ///
+    /// @param lease lease which was deleted.
+    void removeLease(const LeasePtr& lease);
+
+    /// @brief Stops counting the deleted expired-reclaimed leases.
+    ///
+    /// The backends delete the reclaimed leases in bulk without returning
+    /// them. This function mirrors the deletion using the remembered
+    /// states and expiration times.
+    ///
+    /// @param family AF_INET or AF_INET6.
+    /// @param expire_before the reclaimed leases which expired strictly
+    /// before this time are not counted anymore.
+    /// @return the number of leases not counted anymore.
+    size_t removeExpiredReclaimedLeases(uint16_t family, int64_t expire_before);
+
+    /// @brief Returns the lease counts of a range of subnets.
+    ///
+    /// Only the non-zero counts are returned. The IPv4 rows have the
+    /// @c Lease::TYPE_NA type as the rows of the other IPv4 queries.
+    ///
+    /// @param family AF_INET or AF_INET6.
+    /// @param first_subnet_id first subnet in the range.
+    /// @param last_subnet_id last subnet in the range.
+    /// @return the rows in ascending order of subnet id, lease type and
+    /// lease state.
+    std::vector<LeaseStatsRow> getRows(uint16_t family,
+                                       const SubnetID& first_subnet_id,
+                                       const SubnetID& last_subnet_id) const;
+
+    /// @brief Fetches the lease count for a subnet, lease type and state.
+    ///
+    /// @param subnet_id subnet for which the count is desired.
+    /// @param ltype lease type for which the count is desired.
+    /// @param state lease state for which the count is desired.
+    /// @return Number of leases.
+    int64_t getCount(const SubnetID& subnet_id, const Lease::Type& ltype,
+                     uint32_t state) const;
+
+    /// @brief Returns the number of counted leases.
+    size_t getLeaseCount() const;
+
+    /// @brief Removes the counts of the given family.
+    ///
+    /// @param family AF_INET or AF_INET6.
+    void clear(uint16_t family);
+
+    /// @brief Removes all counts.
+    void clear();
+
+private:
+
+    /// @brief Key of the counts: subnet id, lease type and lease state.
+    typedef std::tuple<SubnetID, Lease::Type, uint32_t> CountKey;
+
+    /// @brief Lease counts ordered by key.
+    typedef std::map<CountKey, int64_t> CountMap;
+
+    /// @brief Counts a lease, must be called with the mutex held.
+    ///
+    /// @param lease lease to count.
+    void countInternal(const LeasePtr& lease);
+
+    /// @brief Reverses the contribution of a lease, must be called with
+    /// the mutex held.
+    ///
+    /// @param lease lease to not count anymore.
+    void uncountInternal(const LeasePtr& lease);
+
+    /// @brief Adjusts a count, the zero counts are removed.
+    ///
+    /// @param key key of the count.
+    /// @param offset value to add to the count.
+    void adjustCount(const CountKey& key, int64_t offset);
+
+    /// @brief Returns the counts for the lease type.
+    ///
+    /// @param ltype lease type.
+    /// @return the IPv4 counts for Lease::TYPE_V4, the IPv6 counts otherwise.
+    CountMap& getCounts(const Lease::Type& ltype) {
+        return (ltype == Lease::TYPE_V4 ? counts4_ : counts6_);
+    }
+
+    /// @brief A counted lease.
+    struct CountedLease {
+        /// @brief Lease type.
+        Lease::Type type_;
+
+        /// @brief Subnet identifier.
+        SubnetID subnet_id_;
+
+        /// @brief Lease state.
+        uint32_t state_;
+
+        /// @brief Expiration time.
+        int64_t expire_;
+    };
+
+    /// @brief Counted leases by address.
+    std::unordered_map<asiolink::IOAddress, CountedLease,
+                       asiolink::IOAddress::Hash> leases_;
+
+    /// @brief Counts of the IPv4 leases.
+    CountMap counts4_;
+
+    /// @brief Counts of the IPv6 addresses and prefixes.
+    CountMap counts6_;
+
+    /// @brief The mutex protecting the counts.
+    boost::scoped_ptr<std::mutex> mutex_;
+};
+
+/// @brief Lease statistics query returning the counts of a
+/// @c LeaseStatsCounter.
+///
+/// The rows are copied from the counter when the query is started so
+/// the counter is not locked while they are fetched. As the other lease
+/// statistics queries, it returns the counts of the assigned and declined
+/// leases only. The counts of the other states are available from the
+/// counter.
+class LeaseStatsCounterQuery : public LeaseStatsQuery {
+public:
+
+    /// @brief Constructor for all subnets query.
+    ///
+    /// @param counter the lease statistics counter.
+    /// @param family AF_INET or AF_INET6.
+    LeaseStatsCounterQuery(const LeaseStatsCounter& counter, uint16_t family);
+
+    /// @brief Constructor for single subnet query.
+    ///
+    /// @param counter the lease statistics counter.
+    /// @param family AF_INET or AF_INET6.
+    /// @param subnet_id ID of the desired subnet.
+    LeaseStatsCounterQuery(const LeaseStatsCounter& counter, uint16_t family,
+                           const SubnetID& subnet_id);
+
+    /// @brief Constructor for subnet range query.
+    ///
+    /// @param counter the lease statistics counter.
+    /// @param family AF_INET or AF_INET6.
+    /// @param first_subnet_id ID of the first subnet in the desired range.
+    /// @param last_subnet_id ID of the last subnet in the desired range.
+    LeaseStatsCounterQuery(const LeaseStatsCounter& counter, uint16_t family,
+                           const SubnetID& first_subnet_id,
+                           const SubnetID& last_subnet_id);
+
+    /// @brief Destructor.
+    virtual ~LeaseStatsCounterQuery() {
+    }
+
+    /// @brief Copies the assigned and declined lease counts of the
+    /// selected subnets.
+    virtual void start();
+
+    /// @brief Fetches the next row in the result set.
+    ///
+    /// @param row Storage for the fetched row.
+    ///
+    /// @return True if the fetch succeeded, false if there are no more
+    /// rows to fetch.
+    virtual bool getNextRow(LeaseStatsRow& row);
+
+    /// @brief Returns the number of rows in the result set.
+    int getRowCount() const {
+        return (rows_.size());
+    }
+
+private:
+
+    /// @brief The lease statistics counter.
+    const LeaseStatsCounter& counter_;
+
+    /// @brief The family of the counted leases.
+    uint16_t family_;
+
+    /// @brief A vector containing the "result set".
+    std::vector<LeaseStatsRow> rows_;
+
+    /// @brief The index of the next row within the result set.
+    size_t next_pos_;
+};
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // LEASE_STATS_COUNTER_H
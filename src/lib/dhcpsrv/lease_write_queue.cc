@@ -0,0 +1,208 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcpsrv/dhcpsrv_log.h>
+#include <dhcpsrv/lease_write_queue.h>
+#include <exceptions/exceptions.h>
+#include <boost/make_shared.hpp>
+
+#include <signal.h>
+
+namespace isc {
+namespace dhcp {
+
+LeaseWriteQueue::LeaseWriteQueue(const size_t capacity,
+                                 const size_t batch_size,
+                                 const FlushCallback& flush)
+    : batch_size_(batch_size), flush_(flush), ring_(), callbacks_(),
+      last_sequence_(0), durable_sequence_(0), stopping_(false),
+      running_(false) {
+    if (capacity == 0) {
+        isc_throw(BadValue, "the capacity of the lease write queue must"
+                  " not be 0");
+    }
+    ring_.set_capacity(capacity);
+
+    // Protect the writer thread against signals as the thread pool does.
+    sigset_t sset;
+    sigset_t osset;
+    sigemptyset(&sset);
+    sigaddset(&sset, SIGCHLD);
+    sigaddset(&sset, SIGINT);
+    sigaddset(&sset, SIGHUP);
+    sigaddset(&sset, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &sset, &osset);
+    running_ = true;
+    try {
+        thread_ = boost::make_shared<std::thread>(&LeaseWriteQueue::run, this);
+    } catch (...) {
+        running_ = false;
+        pthread_sigmask(SIG_SETMASK, &osset, 0);
+        throw;
+    }
+    pthread_sigmask(SIG_SETMASK, &osset, 0);
+}
+
+LeaseWriteQueue::~LeaseWriteQueue() {
+    stop();
+}
+
+void
+LeaseWriteQueue::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    pushed_.notify_all();
+    if (thread_) {
+        thread_->join();
+        thread_.reset();
+    }
+}
+
+uint64_t
+LeaseWriteQueue::push(const WriteCallback& write) {
+    uint64_t sequence;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        written_.wait(lock, [this]() {
+            return (!running_ || (ring_.size() < ring_.capacity()));
+        });
+        if (running_) {
+            ring_.push_back(write);
+            sequence = ++last_sequence_;
+            lock.unlock();
+            pushed_.notify_one();
+            return (sequence);
+        }
+        // The writer thread is gone: the caller performs the write.
+        sequence = ++last_sequence_;
+        durable_sequence_ = sequence;
+    }
+    write();
+    return (sequence);
+}
+
+bool
+LeaseWriteQueue::whenDurable(const uint64_t sequence,
+                             const DurableCallback& callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if ((sequence <= durable_sequence_) || (sequence > last_sequence_)) {
+        return (false);
+    }
+    callbacks_.insert(std::make_pair(sequence, callback));
+    return (true);
+}
+
+void
+LeaseWriteQueue::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    written_.wait(lock, [this]() {
+        return (!running_ || (durable_sequence_ >= last_sequence_));
+    });
+}
+
+size_t
+LeaseWriteQueue::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (ring_.size());
+}
+
+uint64_t
+LeaseWriteQueue::getLastSequence() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (last_sequence_);
+}
+
+uint64_t
+LeaseWriteQueue::getDurableSequence() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (durable_sequence_);
+}
+
+void
+LeaseWriteQueue::run() {
+    for (;;) {
+        std::vector<WriteCallback> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            pushed_.wait(lock, [this]() {
+                return (stopping_ || !ring_.empty());
+            });
+            if (ring_.empty()) {
+                // Stopping and nothing left to write.
+                running_ = false;
+                break;
+            }
+            size_t count = ring_.size();
+            if ((batch_size_ > 0) && (count > batch_size_)) {
+                count = batch_size_;
+            }
+            batch.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                batch.push_back(ring_.front());
+                ring_.pop_front();
+            }
+        }
+        // Room was made in the ring.
+        written_.notify_all();
+
+        bool durable = writeBatch(batch);
+
+        std::vector<DurableCallback> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            durable_sequence_ += batch.size();
+            auto end = callbacks_.upper_bound(durable_sequence_);
+            for (auto cb = callbacks_.begin(); cb != end; ++cb) {
+                ready.push_back(cb->second);
+            }
+            callbacks_.erase(callbacks_.begin(), end);
+        }
+        written_.notify_all();
+
+        for (auto const& callback : ready) {
+            try {
+                callback(durable);
+            } catch (const std::exception& ex) {
+                LOG_ERROR(dhcpsrv_logger, DHCPSRV_MEMFILE_WRITE_BEHIND_CALLBACK_FAILED)
+                    .arg(ex.what());
+            } catch (...) {
+                LOG_ERROR(dhcpsrv_logger, DHCPSRV_MEMFILE_WRITE_BEHIND_CALLBACK_FAILED)
+                    .arg("unknown error");
+            }
+        }
+    }
+    written_.notify_all();
+}
+
+bool
+LeaseWriteQueue::writeBatch(std::vector<WriteCallback>& batch) {
+    bool durable = true;
+    for (auto const& write : batch) {
+        try {
+            write();
+        } catch (const std::exception& ex) {
+            LOG_ERROR(dhcpsrv_logger, DHCPSRV_MEMFILE_WRITE_BEHIND_FAILED)
+                .arg(ex.what());
+            durable = false;
+        }
+    }
+    try {
+        if (flush_) {
+            flush_();
+        }
+    } catch (const std::exception& ex) {
+        LOG_ERROR(dhcpsrv_logger, DHCPSRV_MEMFILE_WRITE_BEHIND_FAILED)
+            .arg(ex.what());
+        durable = false;
+    }
+    return (durable);
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
@@ -0,0 +1,173 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_WRITE_QUEUE_H
+#define LEASE_WRITE_QUEUE_H
+
+#include <boost/circular_buffer.hpp>
+#include <boost/shared_ptr.hpp>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Queue of the lease file writes performed by a writer thread.
+///
+/// The memfile backend uses this queue in the write-behind mode: instead
+/// of writing the lease changes to the lease file while holding the lock
+/// of the backend, the worker threads push the writes to this queue and
+/// the writer thread performs them in batches. Each batch is followed
+/// by a call to the flush callback, e.g. synchronizing the lease file to
+/// the disk, after which the writes of the batch are durable.
+///
+/// Each write gets a sequence number. The callers can register callbacks
+/// invoked when a given write is durable, e.g. to hold a DHCP response
+/// until the lease it carries is on the disk.
+///
+/// The queue is a ring of a fixed capacity: the push blocks while the ring
+/// is full so the writer thread slows down the producers rather than
+/// letting the memory grow.
+class LeaseWriteQueue {
+public:
+
+    /// @brief Function writing a lease change to the lease file.
+    typedef std::function<void()> WriteCallback;
+
+    /// @brief Function flushing the lease file after a batch.
+    typedef std::function<void()> FlushCallback;
+
+    /// @brief Function invoked when a write is durable.
+    ///
+    /// The argument is false when the batch holding the write failed.
+    typedef std::function<void(bool)> DurableCallback;
+
+    /// @brief Constructor.
+    ///
+    /// The writer thread is started by the constructor.
+    ///
+    /// @param capacity Maximum number of queued writes.
+    /// @param batch_size Maximum number of writes between two flushes.
+    /// The value of 0 means that all the queued writes are performed
+    /// before flushing.
+    /// @param flush Function invoked after each batch.
+    /// @throw BadValue if the capacity is 0.
+    LeaseWriteQueue(const size_t capacity, const size_t batch_size,
+                    const FlushCallback& flush);
+
+    /// @brief Destructor.
+    ///
+    /// Stops the writer thread after performing the queued writes.
+    ~LeaseWriteQueue();
+
+    /// @brief Stops the writer thread.
+    ///
+    /// The queued writes are performed and the registered callbacks
+    /// are invoked before the thread terminates. The writes pushed
+    /// after this call are performed by the calling thread.
+    void stop();
+
+    /// @brief Pushes a write to the queue.
+    ///
+    /// It blocks while the queue is full. When the writer thread is
+    /// stopped the write is performed immediately.
+    ///
+    /// @param write Function writing the lease change.
+    ///
+    /// @return Sequence number of the write.
+    uint64_t push(const WriteCallback& write);
+
+    /// @brief Registers a callback invoked when a write is durable.
+    ///
+    /// The callback is invoked by the writer thread.
+    ///
+    /// @param sequence Sequence number of the write.
+    /// @param callback Function to invoke.
+    ///
+    /// @return false if the write is already durable or the sequence
+    /// number is unknown, in which case the callback is not registered.
+    bool whenDurable(const uint64_t sequence, const DurableCallback& callback);
+
+    /// @brief Waits until all the pushed writes are durable.
+    void drain();
+
+    /// @brief Returns the number of queued writes.
+    size_t size() const;
+
+    /// @brief Returns the capacity of the queue.
+    size_t getCapacity() const {
+        return (ring_.capacity());
+    }
+
+    /// @brief Returns the sequence number of the last pushed write.
+    uint64_t getLastSequence() const;
+
+    /// @brief Returns the sequence number of the last durable write.
+    uint64_t getDurableSequence() const;
+
+private:
+
+    /// @brief Body of the writer thread.
+    void run();
+
+    /// @brief Performs a batch of writes and flushes them.
+    ///
+    /// @param batch Writes to perform.
+    ///
+    /// @return false if a write or the flush failed.
+    bool writeBatch(std::vector<WriteCallback>& batch);
+
+    /// @brief Maximum number of writes between two flushes.
+    size_t batch_size_;
+
+    /// @brief Function invoked after each batch.
+    FlushCallback flush_;
+
+    /// @brief Ring of the queued writes.
+    boost::circular_buffer<WriteCallback> ring_;
+
+    /// @brief Callbacks by sequence number of the awaited write.
+    std::multimap<uint64_t, DurableCallback> callbacks_;
+
+    /// @brief Sequence number of the last pushed write.
+    uint64_t last_sequence_;
+
+    /// @brief Sequence number of the last durable write.
+    uint64_t durable_sequence_;
+
+    /// @brief Indicates that the writer thread must terminate.
+    bool stopping_;
+
+    /// @brief Indicates that the writer thread performs the writes.
+    bool running_;
+
+    /// @brief Mutex protecting the queue.
+    mutable std::mutex mutex_;
+
+    /// @brief Condition signaled when writes are pushed or the thread
+    /// is stopped.
+    std::condition_variable pushed_;
+
+    /// @brief Condition signaled when writes are taken from the queue
+    /// or are durable.
+    std::condition_variable written_;
+
+    /// @brief The writer thread.
+    boost::shared_ptr<std::thread> thread_;
+};
+
+/// @brief Pointer to the @c LeaseWriteQueue.
+typedef boost::shared_ptr<LeaseWriteQueue> LeaseWriteQueuePtr;
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // LEASE_WRITE_QUEUE_H
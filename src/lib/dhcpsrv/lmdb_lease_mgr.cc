@@ -0,0 +1,1383 @@
+// Copyright (C) 2026 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcp/duid.h>
+#include <dhcp/hwaddr.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/dhcpsrv_log.h>
+#include <dhcpsrv/dhcpsrv_exceptions.h>
+#include <dhcpsrv/lease_journal.h>
+#include <dhcpsrv/lmdb_lease_mgr.h>
+#include <util/buffer.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <lmdb.h>
+
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <time.h>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::db;
+using namespace isc::dhcp;
+using namespace isc::data;
+using namespace isc::util;
+using namespace std;
+
+namespace {
+
+/// @brief Names of the named databases, in the order of their index.
+const char* DATABASE_NAMES[] = {
+    "lease4",
+    "lease4-hwaddr",
+    "lease4-client-id",
+    "lease4-subnet",
+    "lease4-expire",
+    "lease6",
+    "lease6-duid",
+    "lease6-subnet",
+    "lease6-expire",
+    "meta"
+};
+
+/// @brief Key of the layout version in the meta database.
+const char VERSION_KEY[] = "version";
+
+/// @brief Default maximum size of the database in MiB.
+const size_t DEFAULT_MAP_SIZE = 1024;
+
+/// @brief Appends a 32 bits integer in network order.
+void
+appendUint32(std::vector<uint8_t>& buf, uint32_t value) {
+    buf.push_back(static_cast<uint8_t>(value >> 24));
+    buf.push_back(static_cast<uint8_t>(value >> 16));
+    buf.push_back(static_cast<uint8_t>(value >> 8));
+    buf.push_back(static_cast<uint8_t>(value));
+}
+
+/// @brief Reads a 32 bits integer in network order.
+uint32_t
+readUint32(const uint8_t* data) {
+    return ((static_cast<uint32_t>(data[0]) << 24) |
+            (static_cast<uint32_t>(data[1]) << 16) |
+            (static_cast<uint32_t>(data[2]) << 8) |
+            static_cast<uint32_t>(data[3]));
+}
+
+/// @brief Returns an LMDB value pointing to a buffer.
+MDB_val
+toVal(const std::vector<uint8_t>& buf) {
+    MDB_val val;
+    val.mv_size = buf.size();
+    val.mv_data = buf.empty() ? 0 : const_cast<uint8_t*>(&buf[0]);
+    return (val);
+}
+
+/// @brief Checks if a key starts with a prefix.
+bool
+hasPrefix(const MDB_val& key, const std::vector<uint8_t>& prefix) {
+    return ((key.mv_size >= prefix.size()) &&
+            (prefix.empty() ||
+             (memcmp(key.mv_data, &prefix[0], prefix.size()) == 0)));
+}
+
+/// @brief RAII object closing an LMDB cursor.
+class Cursor : public boost::noncopyable {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param txn transaction.
+    /// @param dbi database.
+    /// @throw DbOperationError if the cursor can't be opened.
+    Cursor(MDB_txn* txn, MDB_dbi dbi) : cursor_(0) {
+        int status = mdb_cursor_open(txn, dbi, &cursor_);
+        if (status != MDB_SUCCESS) {
+            cursor_ = 0;
+            isc_throw(DbOperationError, "unable to open an LMDB cursor: "
+                      << mdb_strerror(status));
+        }
+    }
+
+    /// @brief Destructor.
+    ~Cursor() {
+        if (cursor_) {
+            mdb_cursor_close(cursor_);
+        }
+    }
+
+    /// @brief The LMDB cursor.
+    MDB_cursor* cursor_;
+};
+
+} // end of anonymous namespace
+
+namespace isc {
+namespace dhcp {
+
+// LmdbLeaseMgr::Transaction
+
+LmdbLeaseMgr::Transaction::Transaction(MDB_env* env, bool read_only)
+    : txn_(0) {
+    int status = mdb_txn_begin(env, 0, read_only ? MDB_RDONLY : 0, &txn_);
+    if (status != MDB_SUCCESS) {
+        txn_ = 0;
+        checkError(status, "begin transaction");
+    }
+}
+
+LmdbLeaseMgr::Transaction::~Transaction() {
+    if (txn_) {
+        mdb_txn_abort(txn_);
+    }
+}
+
+void
+LmdbLeaseMgr::Transaction::commit() {
+    // The transaction is freed even when the commit fails.
+    MDB_txn* txn = txn_;
+    txn_ = 0;
+    checkError(mdb_txn_commit(txn), "commit transaction");
+}
+
+// LmdbLeaseMgr Constructor and Destructor
+
+LmdbLeaseMgr::LmdbLeaseMgr(const DatabaseConnection::ParameterMap& parameters)
+    : TrackingLeaseMgr(), env_(0), filename_() {
+
+    // Check if the extended info tables are enabled.
+    LeaseMgr::setExtendedInfoTablesEnabled(parameters);
+
+    // The universe selects the default database file.
+    uint16_t universe = 4;
+    try {
+        std::string u = parameters.at("universe");
+        if (u == "6") {
+            universe = 6;
+        } else if (u != "4") {
+            isc_throw(BadValue, "invalid value " << u
+                      << " for the 'universe' parameter");
+        }
+    } catch (const std::out_of_range&) {
+        isc_throw(BadValue, "missing 'universe' parameter");
+    }
+
+    auto name = parameters.find("name");
+    if ((name == parameters.end()) || name->second.empty()) {
+        filename_ = getDefaultLeaseFilePath(universe);
+    } else {
+        filename_ = name->second;
+    }
+
+    size_t map_size = DEFAULT_MAP_SIZE;
+    auto map_size_param = parameters.find("map-size");
+    if (map_size_param != parameters.end()) {
+        try {
+            map_size = boost::lexical_cast<size_t>(map_size_param->second);
+        } catch (const boost::bad_lexical_cast&) {
+            isc_throw(BadValue, "invalid value " << map_size_param->second
+                      << " for the 'map-size' parameter");
+        }
+        // 0 selects the default.
+        if (map_size == 0) {
+            map_size = DEFAULT_MAP_SIZE;
+        }
+    }
+
+    // Open the environment. The threads of the server share the read
+    // transactions so the thread local storage is not used.
+    int status = mdb_env_create(&env_);
+    if (status != MDB_SUCCESS) {
+        env_ = 0;
+        isc_throw(DbOpenError, "unable to create the LMDB environment: "
+                  << mdb_strerror(status));
+    }
+    status = mdb_env_set_maxdbs(env_, NUM_DATABASES);
+    if (status == MDB_SUCCESS) {
+        status = mdb_env_set_mapsize(env_, map_size * 1024 * 1024);
+    }
+    if (status == MDB_SUCCESS) {
+        status = mdb_env_open(env_, filename_.c_str(),
+                              MDB_NOSUBDIR | MDB_NOTLS, 0644);
+    }
+    if (status != MDB_SUCCESS) {
+        mdb_env_close(env_);
+        env_ = 0;
+        isc_throw(DbOpenError, "unable to open the LMDB database "
+                  << filename_ << ": " << mdb_strerror(status));
+    }
+
+    // Open (or create) the named databases and check the layout version.
+    try {
+        Transaction txn(env_, false);
+        for (int i = 0; i < NUM_DATABASES; ++i) {
+            status = mdb_dbi_open(txn.get(), DATABASE_NAMES[i], MDB_CREATE,
+                                  &dbis_[i]);
+            if (status != MDB_SUCCESS) {
+                isc_throw(DbOpenError, "unable to open the LMDB database "
+                          << DATABASE_NAMES[i] << ": " << mdb_strerror(status));
+            }
+        }
+
+        const Key key(VERSION_KEY, VERSION_KEY + strlen(VERSION_KEY));
+        Key version;
+        if (!get(txn.get(), META, key, version)) {
+            // New database.
+            version.clear();
+            appendUint32(version, MAJOR_VERSION);
+            appendUint32(version, MINOR_VERSION);
+            put(txn.get(), META, key, version);
+        } else if ((version.size() != 8) ||
+                   (readUint32(&version[0]) != MAJOR_VERSION) ||
+                   (readUint32(&version[4]) != MINOR_VERSION)) {
+            std::pair<uint32_t, uint32_t> found(0, 0);
+            if (version.size() == 8) {
+                found.first = readUint32(&version[0]);
+                found.second = readUint32(&version[4]);
+            }
+            isc_throw(DbOpenError,
+                      "LMDB database layout version mismatch: need version: "
+                      << MAJOR_VERSION << "." << MINOR_VERSION
+                      << " found version: " << found.first << "."
+                      << found.second);
+        }
+        txn.commit();
+    } catch (...) {
+        mdb_env_close(env_);
+        env_ = 0;
+        throw;
+    }
+
+    // Count the leases for the lease limits and statistics in memory.
+    enableLimitCounter();
+    enableStatsCounter();
+}
+
+LmdbLeaseMgr::~LmdbLeaseMgr() {
+    if (env_) {
+        mdb_env_close(env_);
+    }
+}
+
+std::string
+LmdbLeaseMgr::getDBVersion() {
+    std::stringstream tmp;
+    tmp << "LMDB backend " << MAJOR_VERSION;
+    tmp << "." << MINOR_VERSION;
+    tmp << ", library " << mdb_version(0, 0, 0);
+    return (tmp.str());
+}
+
+std::string
+LmdbLeaseMgr::getDefaultLeaseFilePath(uint16_t u) {
+    std::ostringstream s;
+    s << CfgMgr::instance().getDataDir() << "/kea-leases";
+    s << (u == 4 ? "4" : "6");
+    s << ".mdb";
+    return (s.str());
+}
+
+// Keys and values
+
+LmdbLeaseMgr::Key
+LmdbLeaseMgr::addressKey(const IOAddress& addr) {
+    return (addr.toBytes());
+}
+
+LmdbLeaseMgr::Key
+LmdbLeaseMgr::identifierKey(const std::vector<uint8_t>& id) {
+    Key key;
+    key.reserve(id.size() + 1);
+    key.push_back(static_cast<uint8_t>(std::min(id.size(), size_t(255))));
+    key.insert(key.end(), id.begin(), id.end());
+    return (key);
+}
+
+LmdbLeaseMgr::Key
+LmdbLeaseMgr::subnetKey(SubnetID subnet_id) {
+    Key key;
+    appendUint32(key, subnet_id);
+    return (key);
+}
+
+LmdbLeaseMgr::Key
+LmdbLeaseMgr::expireKey(bool reclaimed, int64_t expire) {
+    Key key;
+    key.push_back(reclaimed ? 1 : 0);
+    uint64_t value = (expire < 0 ? 0 : static_cast<uint64_t>(expire));
+    appendUint32(key, static_cast<uint32_t>(value >> 32));
+    appendUint32(key, static_cast<uint32_t>(value));
+    return (key);
+}
+
+LmdbLeaseMgr::Key
+LmdbLeaseMgr::expireKey(const Lease& lease) {
+    return (expireKey(lease.stateExpiredReclaimed(), lease.getExpirationTime()));
+}
+
+LmdbLeaseMgr::Key
+LmdbLeaseMgr::indexKey(Key key, const Lease& lease) {
+    const Key& addr = addressKey(lease.addr_);
+    key.insert(key.end(), addr.begin(), addr.end());
+    return (key);
+}
+
+LmdbLeaseMgr::Key
+LmdbLeaseMgr::encode(const Lease4& lease) {
+    OutputBuffer buf(128);
+    LeaseJournal4::encode(lease, buf);
+    const uint8_t* data = static_cast<const uint8_t*>(buf.getData());
+    return (Key(data, data + buf.getLength()));
+}
+
+LmdbLeaseMgr::Key
+LmdbLeaseMgr::encode(const Lease6& lease) {
+    OutputBuffer buf(160);
+    LeaseJournal6::encode(lease, buf);
+    const uint8_t* data = static_cast<const uint8_t*>(buf.getData());
+    return (Key(data, data + buf.getLength()));
+}
+
+Lease4Ptr
+LmdbLeaseMgr::decode4(const uint8_t* data, size_t len) {
+    return (LeaseJournal4::decode(data, len));
+}
+
+Lease6Ptr
+LmdbLeaseMgr::decode6(const uint8_t* data, size_t len) {
+    return (LeaseJournal6::decode(data, len));
+}
+
+// Database primitives
+
+void
+LmdbLeaseMgr::checkError(int status, const char* what) {
+    if (status == MDB_SUCCESS) {
+        return;
+    }
+    if (status == MDB_MAP_FULL) {
+        isc_throw(DbOperationError, "unable to " << what
+                  << ": the LMDB database is full, increase the map-size");
+    }
+    isc_throw(DbOperationError, "unable to " << what << ": "
+              << mdb_strerror(status));
+}
+
+bool
+LmdbLeaseMgr::get(MDB_txn* txn, DatabaseIndex dbi, const Key& key,
+                  Key& value) const {
+    MDB_val k = toVal(key);
+    MDB_val v;
+    int status = mdb_get(txn, dbis_[dbi], &k, &v);
+    if (status == MDB_NOTFOUND) {
+        return (false);
+    }
+    checkError(status, "get from the LMDB database");
+    const uint8_t* data = static_cast<const uint8_t*>(v.mv_data);
+    value.assign(data, data + v.mv_size);
+    return (true);
+}
+
+bool
+LmdbLeaseMgr::put(MDB_txn* txn, DatabaseIndex dbi, const Key& key,
+                  const Key& value, bool no_overwrite) {
+    MDB_val k = toVal(key);
+    MDB_val v = toVal(value);
+    int status = mdb_put(txn, dbis_[dbi], &k, &v,
+                         no_overwrite ? MDB_NOOVERWRITE : 0);
+    if (status == MDB_KEYEXIST) {
+        return (false);
+    }
+    checkError(status, "put to the LMDB database");
+    return (true);
+}
+
+bool
+LmdbLeaseMgr::del(MDB_txn* txn, DatabaseIndex dbi, const Key& key) {
+    MDB_val k = toVal(key);
+    int status = mdb_del(txn, dbis_[dbi], &k, 0);
+    if (status == MDB_NOTFOUND) {
+        return (false);
+    }
+    checkError(status, "delete from the LMDB database");
+    return (true);
+}
+
+void
+LmdbLeaseMgr::scan(MDB_txn* txn, DatabaseIndex dbi, const Key& prefix,
+                   const ScanCallback& callback) const {
+    Cursor cursor(txn, dbis_[dbi]);
+    MDB_val k = toVal(prefix);
+    MDB_val v;
+    int status = mdb_cursor_get(cursor.cursor_, &k, &v,
+                                prefix.empty() ? MDB_FIRST : MDB_SET_RANGE);
+    while (status == MDB_SUCCESS) {
+        if (!hasPrefix(k, prefix) ||
+            !callback(static_cast<const uint8_t*>(k.mv_data), k.mv_size,
+                      static_cast<const uint8_t*>(v.mv_data), v.mv_size)) {
+            return;
+        }
+        status = mdb_cursor_get(cursor.cursor_, &k, &v, MDB_NEXT);
+    }
+    if (status != MDB_NOTFOUND) {
+        checkError(status, "scan the LMDB database");
+    }
+}
+
+void
+LmdbLeaseMgr::scanFrom(MDB_txn* txn, DatabaseIndex dbi, const Key& start,
+                       const ScanCallback& callback) const {
+    Cursor cursor(txn, dbis_[dbi]);
+    MDB_val k = toVal(start);
+    MDB_val v;
+    int status = mdb_cursor_get(cursor.cursor_, &k, &v, MDB_SET_RANGE);
+    while (status == MDB_SUCCESS) {
+        if (!callback(static_cast<const uint8_t*>(k.mv_data), k.mv_size,
+                      static_cast<const uint8_t*>(v.mv_data), v.mv_size)) {
+            return;
+        }
+        status = mdb_cursor_get(cursor.cursor_, &k, &v, MDB_NEXT);
+    }
+    if (status != MDB_NOTFOUND) {
+        checkError(status, "scan the LMDB database");
+    }
+}
+
+std::vector<LmdbLeaseMgr::Key>
+LmdbLeaseMgr::getIndexed(MDB_txn* txn, DatabaseIndex dbi, const Key& prefix,
+                         size_t addr_len) const {
+    std::vector<Key> addresses;
+    scan(txn, dbi, prefix,
+         [&addresses, &prefix, addr_len](const uint8_t* key, size_t key_len,
+                                         const uint8_t*, size_t) {
+        // The variable length identifiers are prefixed by their length so
+        // only the exact matches have the address right after the prefix.
+        if (key_len == prefix.size() + addr_len) {
+            addresses.push_back(Key(key + prefix.size(), key + key_len));
+        }
+        return (true);
+    });
+    return (addresses);
+}
+
+Lease4Ptr
+LmdbLeaseMgr::getLease4Internal(MDB_txn* txn, const Key& key) const {
+    Key value;
+    if (!get(txn, LEASE4, key, value)) {
+        return (Lease4Ptr());
+    }
+    return (decode4(&value[0], value.size()));
+}
+
+Lease6Ptr
+LmdbLeaseMgr::getLease6Internal(MDB_txn* txn, const Key& key) const {
+    Key value;
+    if (!get(txn, LEASE6, key, value)) {
+        return (Lease6Ptr());
+    }
+    return (decode6(&value[0], value.size()));
+}
+
+void
+LmdbLeaseMgr::getLeasesByIndex(DatabaseIndex dbi, const Key& prefix,
+                               Lease4Collection& collection) const {
+    Transaction txn(env_, true);
+    for (auto const& key : getIndexed(txn.get(), dbi, prefix, 4)) {
+        Lease4Ptr lease = getLease4Internal(txn.get(), key);
+        if (lease) {
+            collection.push_back(lease);
+        }
+    }
+}
+
+void
+LmdbLeaseMgr::getLeasesByIndex(DatabaseIndex dbi, const Key& prefix,
+                               Lease6Collection& collection) const {
+    Transaction txn(env_, true);
+    for (auto const& key : getIndexed(txn.get(), dbi, prefix, 16)) {
+        Lease6Ptr lease = getLease6Internal(txn.get(), key);
+        if (lease) {
+            collection.push_back(lease);
+        }
+    }
+}
+
+void
+LmdbLeaseMgr::putLease(MDB_txn* txn, const Lease4& lease) {
+    const Key empty;
+    put(txn, LEASE4, addressKey(lease.addr_), encode(lease));
+    if (lease.hwaddr_ && !lease.hwaddr_->hwaddr_.empty()) {
+        put(txn, LEASE4_HWADDR,
+            indexKey(identifierKey(lease.hwaddr_->hwaddr_), lease), empty);
+    }
+    if (lease.client_id_) {
+        put(txn, LEASE4_CLIENT_ID,
+            indexKey(identifierKey(lease.client_id_->getClientId()), lease),
+            empty);
+    }
+    put(txn, LEASE4_SUBNET, indexKey(subnetKey(lease.subnet_id_), lease), empty);
+    put(txn, LEASE4_EXPIRE, indexKey(expireKey(lease), lease), empty);
+}
+
+void
+LmdbLeaseMgr::putLease(MDB_txn* txn, const Lease6& lease) {
+    const Key empty;
+    put(txn, LEASE6, addressKey(lease.addr_), encode(lease));
+    if (lease.duid_) {
+        put(txn, LEASE6_DUID,
+            indexKey(identifierKey(lease.duid_->getDuid()), lease), empty);
+    }
+    put(txn, LEASE6_SUBNET, indexKey(subnetKey(lease.subnet_id_), lease), empty);
+    put(txn, LEASE6_EXPIRE, indexKey(expireKey(lease), lease), empty);
+}
+
+void
+LmdbLeaseMgr::deleteIndexes(MDB_txn* txn, const Lease4& lease) {
+    if (lease.hwaddr_ && !lease.hwaddr_->hwaddr_.empty()) {
+        del(txn, LEASE4_HWADDR,
+            indexKey(identifierKey(lease.hwaddr_->hwaddr_), lease));
+    }
+    if (lease.client_id_) {
+        del(txn, LEASE4_CLIENT_ID,
+            indexKey(identifierKey(lease.client_id_->getClientId()), lease));
+    }
+    del(txn, LEASE4_SUBNET, indexKey(subnetKey(lease.subnet_id_), lease));
+    del(txn, LEASE4_EXPIRE, indexKey(expireKey(lease), lease));
+}
+
+void
+LmdbLeaseMgr::deleteIndexes(MDB_txn* txn, const Lease6& lease) {
+    if (lease.duid_) {
+        del(txn, LEASE6_DUID,
+            indexKey(identifierKey(lease.duid_->getDuid()), lease));
+    }
+    del(txn, LEASE6_SUBNET, indexKey(subnetKey(lease.subnet_id_), lease));
+    del(txn, LEASE6_EXPIRE, indexKey(expireKey(lease), lease));
+}
+
+bool
+LmdbLeaseMgr::sameExpiration(const Lease& old_lease, const Lease& lease) {
+    return (old_lease.getExpirationTime() ==
+            static_cast<int64_t>(lease.current_cltt_) + lease.current_valid_lft_);
+}
+
+// Add operations
+
+bool
+LmdbLeaseMgr::addLease(const Lease4Ptr& lease) {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_ADD_ADDR4)
+        .arg(lease->addr_.toText());
+
+    Transaction txn(env_, false);
+    Key value;
+    if (get(txn.get(), LEASE4, addressKey(lease->addr_), value)) {
+        return (false);
+    }
+    putLease(txn.get(), *lease);
+    txn.commit();
+
+    // Update lease current expiration time (allows update between the creation
+    // of the Lease up to the point of insertion in the database).
+    lease->updateCurrentExpirationTime();
+
+    // Run installed callbacks.
+    if (hasCallbacks()) {
+        trackAddLease(lease, false);
+    }
+
+    return (true);
+}
+
+bool
+LmdbLeaseMgr::addLease(const Lease6Ptr& lease) {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_ADD_ADDR6)
+        .arg(lease->addr_.toText())
+        .arg(lease->type_);
+
+    Transaction txn(env_, false);
+    Key value;
+    if (get(txn.get(), LEASE6, addressKey(lease->addr_), value)) {
+        return (false);
+    }
+    putLease(txn.get(), *lease);
+    txn.commit();
+
+    // Update lease current expiration time (allows update between the creation
+    // of the Lease up to the point of insertion in the database).
+    lease->updateCurrentExpirationTime();
+
+    // Run installed callbacks.
+    if (hasCallbacks()) {
+        trackAddLease(lease, false);
+    }
+
+    return (true);
+}
+
+// IPv4 get operations
+
+Lease4Ptr
+LmdbLeaseMgr::getLease4(const IOAddress& addr) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_ADDR4)
+        .arg(addr.toText());
+
+    if (!addr.isV4()) {
+        return (Lease4Ptr());
+    }
+
+    Transaction txn(env_, true);
+    return (getLease4Internal(txn.get(), addressKey(addr)));
+}
+
+Lease4Collection
+LmdbLeaseMgr::getLease4(const HWAddr& hwaddr) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_HWADDR)
+        .arg(hwaddr.toText());
+
+    Lease4Collection result;
+    if (!hwaddr.hwaddr_.empty()) {
+        getLeasesByIndex(LEASE4_HWADDR, identifierKey(hwaddr.hwaddr_), result);
+    }
+    return (result);
+}
+
+Lease4Ptr
+LmdbLeaseMgr::getLease4(const HWAddr& hwaddr, SubnetID subnet_id) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_SUBID_HWADDR)
+        .arg(subnet_id)
+        .arg(hwaddr.toText());
+
+    Lease4Collection collection;
+    if (!hwaddr.hwaddr_.empty()) {
+        getLeasesByIndex(LEASE4_HWADDR, identifierKey(hwaddr.hwaddr_), collection);
+    }
+    for (auto const& lease : collection) {
+        if (lease->subnet_id_ == subnet_id) {
+            return (lease);
+        }
+    }
+    return (Lease4Ptr());
+}
+
+Lease4Collection
+LmdbLeaseMgr::getLease4(const ClientId& clientid) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_CLIENTID)
+        .arg(clientid.toText());
+
+    Lease4Collection result;
+    getLeasesByIndex(LEASE4_CLIENT_ID, identifierKey(clientid.getClientId()),
+                     result);
+    return (result);
+}
+
+Lease4Ptr
+LmdbLeaseMgr::getLease4(const ClientId& clientid, SubnetID subnet_id) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_SUBID_CLIENTID)
+        .arg(subnet_id)
+        .arg(clientid.toText());
+
+    Lease4Collection collection;
+    getLeasesByIndex(LEASE4_CLIENT_ID, identifierKey(clientid.getClientId()),
+                     collection);
+    for (auto const& lease : collection) {
+        if (lease->subnet_id_ == subnet_id) {
+            return (lease);
+        }
+    }
+    return (Lease4Ptr());
+}
+
+Lease4Collection
+LmdbLeaseMgr::getLeases4(SubnetID subnet_id) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_SUBID4)
+        .arg(subnet_id);
+
+    Lease4Collection result;
+    getLeasesByIndex(LEASE4_SUBNET, subnetKey(subnet_id), result);
+    return (result);
+}
+
+Lease4Collection
+LmdbLeaseMgr::getLeases4(const std::string& hostname) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_HOSTNAME4)
+        .arg(hostname);
+
+    Lease4Collection result;
+    Transaction txn(env_, true);
+    scan(txn.get(), LEASE4, Key(),
+         [&result, &hostname](const uint8_t*, size_t,
+                              const uint8_t* data, size_t data_len) {
+        Lease4Ptr lease = decode4(data, data_len);
+        if (lease->hostname_ == hostname) {
+            result.push_back(lease);
+        }
+        return (true);
+    });
+    return (result);
+}
+
+Lease4Collection
+LmdbLeaseMgr::getLeases4() const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET4);
+
+    Lease4Collection result;
+    Transaction txn(env_, true);
+    scan(txn.get(), LEASE4, Key(),
+         [&result](const uint8_t*, size_t, const uint8_t* data, size_t data_len) {
+        result.push_back(decode4(data, data_len));
+        return (true);
+    });
+    return (result);
+}
+
+Lease4Collection
+LmdbLeaseMgr::getLeases4(const IOAddress& lower_bound_address,
+                         const LeasePageSize& page_size) const {
+    // Expecting IPv4 address.
+    if (!lower_bound_address.isV4()) {
+        isc_throw(InvalidAddressFamily, "expected IPv4 address while "
+                  "retrieving leases from the lease database, got "
+                  << lower_bound_address);
+    }
+
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_PAGE4)
+        .arg(page_size.page_size_)
+        .arg(lower_bound_address.toText());
+
+    // The lower bound address is excluded.
+    const Key start = addressKey(lower_bound_address);
+    Lease4Collection result;
+    Transaction txn(env_, true);
+    scanFrom(txn.get(), LEASE4, start,
+             [&result, &start, &page_size](const uint8_t* key, size_t key_len,
+                                           const uint8_t* data, size_t data_len) {
+        if ((key_len == start.size()) &&
+            (memcmp(key, &start[0], key_len) == 0)) {
+            return (true);
+        }
+        result.push_back(decode4(data, data_len));
+        return (result.size() < page_size.page_size_);
+    });
+    return (result);
+}
+
+// IPv6 get operations
+
+Lease6Ptr
+LmdbLeaseMgr::getLease6(Lease::Type lease_type, const IOAddress& addr) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_ADDR6)
+        .arg(addr.toText())
+        .arg(lease_type);
+
+    if (!addr.isV6()) {
+        return (Lease6Ptr());
+    }
+
+    Transaction txn(env_, true);
+    Lease6Ptr lease = getLease6Internal(txn.get(), addressKey(addr));
+    if (lease && (lease->type_ != lease_type)) {
+        lease.reset();
+    }
+    return (lease);
+}
+
+Lease6Collection
+LmdbLeaseMgr::getLeases6(Lease::Type lease_type, const DUID& duid,
+                         uint32_t iaid) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_IAID_DUID)
+        .arg(iaid)
+        .arg(duid.toText())
+        .arg(lease_type);
+
+    Lease6Collection collection;
+    getLeasesByIndex(LEASE6_DUID, identifierKey(duid.getDuid()), collection);
+
+    Lease6Collection result;
+    for (auto const& lease : collection) {
+        if ((lease->type_ == lease_type) && (lease->iaid_ == iaid)) {
+            result.push_back(lease);
+        }
+    }
+    return (result);
+}
+
+Lease6Collection
+LmdbLeaseMgr::getLeases6(Lease::Type lease_type, const DUID& duid,
+                         uint32_t iaid, SubnetID subnet_id) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_IAID_SUBID_DUID)
+        .arg(iaid)
+        .arg(subnet_id)
+        .arg(duid.toText())
+        .arg(lease_type);
+
+    Lease6Collection collection;
+    getLeasesByIndex(LEASE6_DUID, identifierKey(duid.getDuid()), collection);
+
+    Lease6Collection result;
+    for (auto const& lease : collection) {
+        if ((lease->type_ == lease_type) && (lease->iaid_ == iaid) &&
+            (lease->subnet_id_ == subnet_id)) {
+            result.push_back(lease);
+        }
+    }
+    return (result);
+}
+
+Lease6Collection
+LmdbLeaseMgr::getLeases6(SubnetID subnet_id) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_SUBID6)
+        .arg(subnet_id);
+
+    Lease6Collection result;
+    getLeasesByIndex(LEASE6_SUBNET, subnetKey(subnet_id), result);
+    return (result);
+}
+
+Lease6Collection
+LmdbLeaseMgr::getLeases6(const std::string& hostname) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_HOSTNAME6)
+        .arg(hostname);
+
+    Lease6Collection result;
+    Transaction txn(env_, true);
+    scan(txn.get(), LEASE6, Key(),
+         [&result, &hostname](const uint8_t*, size_t,
+                              const uint8_t* data, size_t data_len) {
+        Lease6Ptr lease = decode6(data, data_len);
+        if (lease->hostname_ == hostname) {
+            result.push_back(lease);
+        }
+        return (true);
+    });
+    return (result);
+}
+
+Lease6Collection
+LmdbLeaseMgr::getLeases6() const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET6);
+
+    Lease6Collection result;
+    Transaction txn(env_, true);
+    scan(txn.get(), LEASE6, Key(),
+         [&result](const uint8_t*, size_t, const uint8_t* data, size_t data_len) {
+        result.push_back(decode6(data, data_len));
+        return (true);
+    });
+    return (result);
+}
+
+Lease6Collection
+LmdbLeaseMgr::getLeases6(const DUID& duid) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_DUID)
+        .arg(duid.toText());
+
+    Lease6Collection result;
+    getLeasesByIndex(LEASE6_DUID, identifierKey(duid.getDuid()), result);
+    return (result);
+}
+
+Lease6Collection
+LmdbLeaseMgr::getLeases6(const IOAddress& lower_bound_address,
+                         const LeasePageSize& page_size) const {
+    // Expecting IPv6 address.
+    if (!lower_bound_address.isV6()) {
+        isc_throw(InvalidAddressFamily, "expected IPv6 address while "
+                  "retrieving leases from the lease database, got "
+                  << lower_bound_address);
+    }
+
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_PAGE6)
+        .arg(page_size.page_size_)
+        .arg(lower_bound_address.toText());
+
+    // The lower bound address is excluded.
+    const Key start = addressKey(lower_bound_address);
+    Lease6Collection result;
+    Transaction txn(env_, true);
+    scanFrom(txn.get(), LEASE6, start,
+             [&result, &start, &page_size](const uint8_t* key, size_t key_len,
+                                           const uint8_t* data, size_t data_len) {
+        if ((key_len == start.size()) &&
+            (memcmp(key, &start[0], key_len) == 0)) {
+            return (true);
+        }
+        result.push_back(decode6(data, data_len));
+        return (result.size() < page_size.page_size_);
+    });
+    return (result);
+}
+
+// Expired leases
+
+void
+LmdbLeaseMgr::getExpiredLeases4(Lease4Collection& expired_leases,
+                                const size_t max_leases) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_EXPIRED4)
+        .arg(max_leases);
+
+    // The leases which are not reclaimed sort first, by expiration time.
+    const Key limit = expireKey(false, time(0));
+    std::vector<Key> addresses;
+    Transaction txn(env_, true);
+    scan(txn.get(), LEASE4_EXPIRE, Key(1, 0),
+         [&addresses, &limit, max_leases](const uint8_t* key, size_t key_len,
+                                          const uint8_t*, size_t) {
+        if (memcmp(key, &limit[0], limit.size()) >= 0) {
+            return (false);
+        }
+        addresses.push_back(Key(key + limit.size(), key + key_len));
+        return ((max_leases == 0) || (addresses.size() < max_leases));
+    });
+    for (auto const& key : addresses) {
+        Lease4Ptr lease = getLease4Internal(txn.get(), key);
+        if (lease) {
+            expired_leases.push_back(lease);
+        }
+    }
+}
+
+void
+LmdbLeaseMgr::getExpiredLeases6(Lease6Collection& expired_leases,
+                                const size_t max_leases) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_EXPIRED6)
+        .arg(max_leases);
+
+    // The leases which are not reclaimed sort first, by expiration time.
+    const Key limit = expireKey(false, time(0));
+    std::vector<Key> addresses;
+    Transaction txn(env_, true);
+    scan(txn.get(), LEASE6_EXPIRE, Key(1, 0),
+         [&addresses, &limit, max_leases](const uint8_t* key, size_t key_len,
+                                          const uint8_t*, size_t) {
+        if (memcmp(key, &limit[0], limit.size()) >= 0) {
+            return (false);
+        }
+        addresses.push_back(Key(key + limit.size(), key + key_len));
+        return ((max_leases == 0) || (addresses.size() < max_leases));
+    });
+    for (auto const& key : addresses) {
+        Lease6Ptr lease = getLease6Internal(txn.get(), key);
+        if (lease) {
+            expired_leases.push_back(lease);
+        }
+    }
+}
+
+// Update operations
+
+void
+LmdbLeaseMgr::updateLease4(const Lease4Ptr& lease) {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_UPDATE_ADDR4)
+        .arg(lease->addr_.toText());
+
+    Transaction txn(env_, false);
+    Lease4Ptr old_lease = getLease4Internal(txn.get(), addressKey(lease->addr_));
+    if (!old_lease || !sameExpiration(*old_lease, *lease)) {
+        isc_throw(NoSuchLease, "unable to update lease for address " <<
+                  lease->addr_.toText() << " either because the lease does not exist, "
+                  "it has been deleted or it has changed in the database.");
+    }
+    deleteIndexes(txn.get(), *old_lease);
+    putLease(txn.get(), *lease);
+    txn.commit();
+
+    // Update lease current expiration time.
+    lease->updateCurrentExpirationTime();
+
+    // Run installed callbacks.
+    if (hasCallbacks()) {
+        trackUpdateLease(lease, false);
+    }
+}
+
+void
+LmdbLeaseMgr::updateLease6(const Lease6Ptr& lease) {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_UPDATE_ADDR6)
+        .arg(lease->addr_.toText())
+        .arg(lease->type_);
+
+    Transaction txn(env_, false);
+    Lease6Ptr old_lease = getLease6Internal(txn.get(), addressKey(lease->addr_));
+    if (!old_lease || !sameExpiration(*old_lease, *lease)) {
+        isc_throw(NoSuchLease, "unable to update lease for address " <<
+                  lease->addr_.toText() << " either because the lease does not exist, "
+                  "it has been deleted or it has changed in the database.");
+    }
+    deleteIndexes(txn.get(), *old_lease);
+    putLease(txn.get(), *lease);
+    txn.commit();
+
+    // Update lease current expiration time.
+    lease->updateCurrentExpirationTime();
+
+    // Run installed callbacks.
+    if (hasCallbacks()) {
+        trackUpdateLease(lease, false);
+    }
+}
+
+// Delete operations
+
+bool
+LmdbLeaseMgr::deleteLease(const Lease4Ptr& lease) {
+    const IOAddress& addr = lease->addr_;
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_DELETE_ADDR)
+        .arg(addr.toText());
+
+    Transaction txn(env_, false);
+    const Key key = addressKey(addr);
+    Lease4Ptr old_lease = getLease4Internal(txn.get(), key);
+    if (!old_lease || !sameExpiration(*old_lease, *lease)) {
+        return (false);
+    }
+    deleteIndexes(txn.get(), *old_lease);
+    del(txn.get(), LEASE4, key);
+    txn.commit();
+
+    if (hasCallbacks()) {
+        trackDeleteLease(lease, false);
+    }
+    return (true);
+}
+
+bool
+LmdbLeaseMgr::deleteLease(const Lease6Ptr& lease) {
+    const IOAddress& addr = lease->addr_;
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_DELETE_ADDR)
+        .arg(addr.toText());
+
+    Transaction txn(env_, false);
+    const Key key = addressKey(addr);
+    Lease6Ptr old_lease = getLease6Internal(txn.get(), key);
+    if (!old_lease || !sameExpiration(*old_lease, *lease)) {
+        return (false);
+    }
+    deleteIndexes(txn.get(), *old_lease);
+    del(txn.get(), LEASE6, key);
+    txn.commit();
+
+    if (hasCallbacks()) {
+        trackDeleteLease(lease, false);
+    }
+    return (true);
+}
+
+uint64_t
+LmdbLeaseMgr::deleteExpiredReclaimedLeases4(const uint32_t secs) {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_DELETE_EXPIRED_RECLAIMED4)
+        .arg(secs);
+    return (deleteExpiredReclaimedLeasesCommon(secs, 4));
+}
+
+uint64_t
+LmdbLeaseMgr::deleteExpiredReclaimedLeases6(const uint32_t secs) {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_DELETE_EXPIRED_RECLAIMED6)
+        .arg(secs);
+    return (deleteExpiredReclaimedLeasesCommon(secs, 6));
+}
+
+uint64_t
+LmdbLeaseMgr::deleteExpiredReclaimedLeasesCommon(const uint32_t secs,
+                                                 uint16_t universe) {
+    const time_t expire_limit = time(0) - static_cast<time_t>(secs);
+    const Key limit = expireKey(true, expire_limit);
+    const DatabaseIndex expire_dbi = (universe == 4 ? LEASE4_EXPIRE : LEASE6_EXPIRE);
+
+    // Collect the expired-reclaimed leases which expired before the limit.
+    std::vector<Key> addresses;
+    Transaction txn(env_, false);
+    scan(txn.get(), expire_dbi, Key(1, 1),
+         [&addresses, &limit](const uint8_t* key, size_t key_len,
+                              const uint8_t*, size_t) {
+        if (memcmp(key, &limit[0], limit.size()) >= 0) {
+            return (false);
+        }
+        addresses.push_back(Key(key + limit.size(), key + key_len));
+        return (true);
+    });
+
+    uint64_t deleted_leases = 0;
+    for (auto const& key : addresses) {
+        if (universe == 4) {
+            Lease4Ptr lease = getLease4Internal(txn.get(), key);
+            if (lease) {
+                deleteIndexes(txn.get(), *lease);
+                del(txn.get(), LEASE4, key);
+                ++deleted_leases;
+            }
+        } else {
+            Lease6Ptr lease = getLease6Internal(txn.get(), key);
+            if (lease) {
+                deleteIndexes(txn.get(), *lease);
+                del(txn.get(), LEASE6, key);
+                ++deleted_leases;
+            }
+        }
+    }
+    txn.commit();
+
+    trackDeleteExpiredReclaimedLeases(universe == 4 ? AF_INET : AF_INET6,
+                                      expire_limit);
+
+    return (deleted_leases);
+}
+
+size_t
+LmdbLeaseMgr::wipeLeases4(const SubnetID& subnet_id) {
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_LMDB_WIPE_LEASES4)
+        .arg(subnet_id);
+
+    Lease4Collection leases;
+    {
+        Transaction txn(env_, false);
+        for (auto const& key : getIndexed(txn.get(), LEASE4_SUBNET,
+                                          subnetKey(subnet_id), 4)) {
+            Lease4Ptr lease = getLease4Internal(txn.get(), key);
+            if (lease) {
+                deleteIndexes(txn.get(), *lease);
+                del(txn.get(), LEASE4, key);
+                leases.push_back(lease);
+            }
+        }
+        txn.commit();
+    }
+
+    if (hasCallbacks()) {
+        for (auto const& lease : leases) {
+            trackDeleteLease(lease, false);
+        }
+    }
+    return (leases.size());
+}
+
+size_t
+LmdbLeaseMgr::wipeLeases6(const SubnetID& subnet_id) {
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_LMDB_WIPE_LEASES6)
+        .arg(subnet_id);
+
+    Lease6Collection leases;
+    {
+        Transaction txn(env_, false);
+        for (auto const& key : getIndexed(txn.get(), LEASE6_SUBNET,
+                                          subnetKey(subnet_id), 16)) {
+            Lease6Ptr lease = getLease6Internal(txn.get(), key);
+            if (lease) {
+                deleteIndexes(txn.get(), *lease);
+                del(txn.get(), LEASE6, key);
+                leases.push_back(lease);
+            }
+        }
+        txn.commit();
+    }
+
+    if (hasCallbacks()) {
+        for (auto const& lease : leases) {
+            trackDeleteLease(lease, false);
+        }
+    }
+    return (leases.size());
+}
+
+// Statistics
+
+LeaseStatsQueryPtr
+LmdbLeaseMgr::startLeaseStatsQuery4() {
+    return (startStatsCounterQuery(AF_INET));
+}
+
+LeaseStatsQueryPtr
+LmdbLeaseMgr::startSubnetLeaseStatsQuery4(const SubnetID& subnet_id) {
+    return (startStatsCounterQuery(AF_INET, subnet_id));
+}
+
+LeaseStatsQueryPtr
+LmdbLeaseMgr::startSubnetRangeLeaseStatsQuery4(const SubnetID& first_subnet_id,
+                                               const SubnetID& last_subnet_id) {
+    return (startStatsCounterQuery(AF_INET, first_subnet_id, last_subnet_id));
+}
+
+LeaseStatsQueryPtr
+LmdbLeaseMgr::startLeaseStatsQuery6() {
+    return (startStatsCounterQuery(AF_INET6));
+}
+
+LeaseStatsQueryPtr
+LmdbLeaseMgr::startSubnetLeaseStatsQuery6(const SubnetID& subnet_id) {
+    return (startStatsCounterQuery(AF_INET6, subnet_id));
+}
+
+LeaseStatsQueryPtr
+LmdbLeaseMgr::startSubnetRangeLeaseStatsQuery6(const SubnetID& first_subnet_id,
+                                               const SubnetID& last_subnet_id) {
+    return (startStatsCounterQuery(AF_INET6, first_subnet_id, last_subnet_id));
+}
+
+// Limits
+
+string
+LmdbLeaseMgr::checkLimits4(ConstElementPtr const& user_context) const {
+    return (checkLimitsInMemory4(user_context));
+}
+
+string
+LmdbLeaseMgr::checkLimits6(ConstElementPtr const& user_context) const {
+    return (checkLimitsInMemory6(user_context));
+}
+
+bool
+LmdbLeaseMgr::isJsonSupported() const {
+    return (true);
+}
+
+size_t
+LmdbLeaseMgr::getClassLeaseCount(const ClientClass& client_class,
+                                 const Lease::Type& ltype /* = Lease::TYPE_V4*/) const {
+    return (limit_counter_->getClassCount(client_class, ltype));
+}
+
+void
+LmdbLeaseMgr::recountClassLeases4() {
+    recountLimitCounter(AF_INET);
+}
+
+void
+LmdbLeaseMgr::recountClassLeases6() {
+    recountLimitCounter(AF_INET6);
+}
+
+void
+LmdbLeaseMgr::clearClassLeaseCounts() {
+    limit_counter_->clear();
+}
+
+// Miscellaneous database methods.
+
+std::string
+LmdbLeaseMgr::getName() const {
+    return (filename_);
+}
+
+std::string
+LmdbLeaseMgr::getDescription() const {
+    return (std::string("LMDB Database"));
+}
+
+std::pair<uint32_t, uint32_t>
+LmdbLeaseMgr::getVersion() const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_GET_VERSION);
+
+    Transaction txn(env_, true);
+    const Key key(VERSION_KEY, VERSION_KEY + strlen(VERSION_KEY));
+    Key version;
+    if (!get(txn.get(), META, key, version) || (version.size() != 8)) {
+        isc_throw(DbOperationError, "unable to find the layout version "
+                  "in the LMDB database " << filename_);
+    }
+    return (std::make_pair(readUint32(&version[0]), readUint32(&version[4])));
+}
+
+void
+LmdbLeaseMgr::commit() {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_COMMIT);
+}
+
+void
+LmdbLeaseMgr::rollback() {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_LMDB_ROLLBACK);
+}
+
+// Unsupported operations.
+
+void
+LmdbLeaseMgr::writeLeases4(const std::string&) {
+    isc_throw(NotImplemented, "LmdbLeaseMgr::writeLeases4() not implemented");
+}
+
+void
+LmdbLeaseMgr::writeLeases6(const std::string&) {
+    isc_throw(NotImplemented, "LmdbLeaseMgr::writeLeases6() not implemented");
+}
+
+void
+LmdbLeaseMgr::setExtendedInfoTablesEnabled(const db::DatabaseConnection::ParameterMap& parameters) {
+    LeaseMgr::setExtendedInfoTablesEnabled(parameters);
+}
+
+void
+LmdbLeaseMgr::deleteExtendedInfo6(const IOAddress& /* addr */) {
+    isc_throw(NotImplemented, "LmdbLeaseMgr::deleteExtendedInfo6 not implemented");
+}
+
+void
+LmdbLeaseMgr::addRelayId6(const IOAddress& /* lease_addr */,
+                          const vector<uint8_t>& /* relay_id */) {
+    isc_throw(NotImplemented, "LmdbLeaseMgr::addRelayId6 not implemented");
+}
+
+void
+LmdbLeaseMgr::addRemoteId6(const IOAddress& /* lease_addr */,
+                           const vector<uint8_t>& /* remote_id */) {
+    isc_throw(NotImplemented, "LmdbLeaseMgr::addRemoteId6 not implemented");
+}
+
+Lease4Collection
+LmdbLeaseMgr::getLeases4ByRelayId(const OptionBuffer& /* relay_id */,
+                                  const IOAddress& /* lower_bound_address */,
+                                  const LeasePageSize& /* page_size */,
+                                  const time_t& /* qry_start_time = 0 */,
+                                  const time_t& /* qry_end_time = 0 */) {
+    isc_throw(NotImplemented, "LmdbLeaseMgr::getLeases4ByRelayId not implemented");
+}
+
+Lease4Collection
+LmdbLeaseMgr::getLeases4ByRemoteId(const OptionBuffer& /* remote_id */,
+                                   const IOAddress& /* lower_bound_address */,
+                                   const LeasePageSize& /* page_size */,
+                                   const time_t& /* qry_start_time = 0 */,
+                                   const time_t& /* qry_end_time = 0 */) {
+    isc_throw(NotImplemented, "LmdbLeaseMgr::getLeases4ByRemoteId not implemented");
+}
+
+Lease6Collection
+LmdbLeaseMgr::getLeases6ByRelayId(const DUID& /* relay_id */,
+                                  const IOAddress& /* link_addr */,
+                                  uint8_t /* link_len */,
+                                  const IOAddress& /* lower_bound_address */,
+                                  const LeasePageSize& /* page_size */) {
+    isc_throw(NotImplemented, "LmdbLeaseMgr::getLeases6ByRelayId not implemented");
+}
+
+Lease6Collection
+LmdbLeaseMgr::getLeases6ByRemoteId(const OptionBuffer& /* remote_id */,
+                                   const IOAddress& /* link_addr */,
+                                   uint8_t /* link_len */,
+                                   const IOAddress& /* lower_bound_address */,
+                                   const LeasePageSize& /* page_size*/) {
+    isc_throw(NotImplemented, "LmdbLeaseMgr::getLeases6ByRemoteId not implemented");
+}
+
+Lease6Collection
+LmdbLeaseMgr::getLeases6ByLink(const IOAddress& /* link_addr */,
+                               uint8_t /* link_len */,
+                               const IOAddress& /* lower_bound_address */,
+                               const LeasePageSize& /* page_size */) {
+    isc_throw(NotImplemented, "LmdbLeaseMgr::getLeases6ByLink not implemented");
+}
+
+size_t
+LmdbLeaseMgr::buildExtendedInfoTables6(bool /* update */, bool /* current */) {
+    isc_throw(NotImplemented, "LmdbLeaseMgr::buildExtendedInfoTables6 not implemented");
+}
+
+} // namespace dhcp
+} // namespace isc
@@ -0,0 +1,869 @@
+// Copyright (C) 2026 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LMDB_LEASE_MGR_H
+#define LMDB_LEASE_MGR_H
+
+#include <asiolink/io_address.h>
+#include <dhcp/hwaddr.h>
+#include <dhcpsrv/dhcpsrv_exceptions.h>
+#include <dhcpsrv/lease_mgr.h>
+#include <dhcpsrv/tracking_lease_mgr.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// The LMDB types are declared here so the users of the lease manager
+// do not need the LMDB headers.
+struct MDB_env;
+struct MDB_txn;
+typedef unsigned int MDB_dbi;
+
+namespace isc {
+namespace dhcp {
+
+/// @brief LMDB Lease Manager
+///
+/// This class provides the @ref isc::dhcp::LeaseMgr interface to the
+/// Lightning Memory-Mapped Database (LMDB), an embedded key-value store.
+/// The leases are kept in a single memory-mapped file which is shared by
+/// the threads of the server, so the leases survive a restart without
+/// the reload of a lease file and without a database server.
+///
+/// The leases are stored in named databases of the LMDB environment:
+/// - "lease4" and "lease6" map the lease address to the lease, encoded
+///   like the records of the lease journal.
+/// - "lease4-hwaddr", "lease4-client-id", "lease6-duid" are the client
+///   identifier indexes.
+/// - "lease4-subnet", "lease6-subnet" are the subnet identifier indexes.
+/// - "lease4-expire", "lease6-expire" are the expiration indexes sorted
+///   by the reclaimed state and the expiration time.
+/// - "meta" holds the version of the layout.
+///
+/// The index keys end with the lease address so they are unique and the
+/// lookups are prefix scans. Each lease operation runs in its own LMDB
+/// transaction so the lease and its indexes are always consistent.
+///
+/// LMDB has no query engine so the lease limits and the lease statistics
+/// are always counted in memory.
+class LmdbLeaseMgr : public TrackingLeaseMgr {
+public:
+
+    /// @brief Major version of the database layout.
+    static const uint32_t MAJOR_VERSION = 1;
+
+    /// @brief Minor version of the database layout.
+    static const uint32_t MINOR_VERSION = 0;
+
+    /// @brief Constructor
+    ///
+    /// Uses the following keywords in the parameters passed to it:
+    /// - universe - "4" or "6" (mandatory), selects the default file name.
+    /// - name - Name of the database file (optional, defaults to
+    ///   kea-leases4.mdb or kea-leases6.mdb in the data directory).
+    /// - map-size - Maximum size of the database in MiB (optional,
+    ///   defaults to 1024, 0 selects the default).
+    ///
+    /// Open (or create) the database and check its layout version.
+    ///
+    /// @param parameters A data structure relating keywords and values
+    ///        concerned with the database.
+    ///
+    /// @throw isc::BadValue if the universe or the map size is invalid.
+    /// @throw isc::db::DbOpenError Error opening the database or the
+    ///        layout version is incorrect.
+    LmdbLeaseMgr(const db::DatabaseConnection::ParameterMap& parameters);
+
+    /// @brief Destructor (closes database)
+    virtual ~LmdbLeaseMgr();
+
+    /// @brief Local version of getDBVersion() class method
+    static std::string getDBVersion();
+
+    /// @brief Adds an IPv4 lease
+    ///
+    /// @param lease lease to be added
+    ///
+    /// @result true if the lease was added, false if not (because a lease
+    ///         with the same address was already there).
+    ///
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual bool addLease(const Lease4Ptr& lease) override;
+
+    /// @brief Adds an IPv6 lease
+    ///
+    /// @param lease lease to be added
+    ///
+    /// @result true if the lease was added, false if not (because a lease
+    ///         with the same address was already there).
+    ///
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual bool addLease(const Lease6Ptr& lease) override;
+
+    /// @brief Returns an IPv4 lease for specified IPv4 address
+    ///
+    /// @param addr address of the searched lease
+    ///
+    /// @return smart pointer to the lease (or NULL if a lease is not found)
+    virtual Lease4Ptr getLease4(const isc::asiolink::IOAddress& addr) const override;
+
+    /// @brief Returns existing IPv4 leases for specified hardware address.
+    ///
+    /// @param hwaddr hardware address of the client
+    ///
+    /// @return lease collection
+    virtual Lease4Collection getLease4(const isc::dhcp::HWAddr& hwaddr) const override;
+
+    /// @brief Returns existing IPv4 leases for specified hardware address
+    ///        and a subnet
+    ///
+    /// @param hwaddr hardware address of the client
+    /// @param subnet_id identifier of the subnet that lease must belong to
+    ///
+    /// @return a pointer to the lease (or NULL if a lease is not found)
+    virtual Lease4Ptr getLease4(const isc::dhcp::HWAddr& hwaddr,
+                                SubnetID subnet_id) const override;
+
+    /// @brief Returns existing IPv4 leases for specified client-id
+    ///
+    /// @param clientid client identifier
+    ///
+    /// @return lease collection
+    virtual Lease4Collection getLease4(const ClientId& clientid) const override;
+
+    /// @brief Returns IPv4 lease for the specified client-id and subnet
+    ///
+    /// @param clientid client identifier
+    /// @param subnet_id identifier of the subnet that lease must belong to
+    ///
+    /// @return a pointer to the lease (or NULL if a lease is not found)
+    virtual Lease4Ptr getLease4(const ClientId& clientid,
+                                SubnetID subnet_id) const override;
+
+    /// @brief Returns all IPv4 leases for the particular subnet identifier.
+    ///
+    /// @param subnet_id subnet identifier.
+    ///
+    /// @return Lease collection (may be empty if no IPv4 lease found).
+    virtual Lease4Collection getLeases4(SubnetID subnet_id) const override;
+
+    /// @brief Returns all IPv4 leases for the particular hostname.
+    ///
+    /// The hostname is not indexed so the database is scanned.
+    ///
+    /// @param hostname hostname in lower case.
+    ///
+    /// @return Lease collection (may be empty if no IPv4 lease found).
+    virtual Lease4Collection getLeases4(const std::string& hostname) const override;
+
+    /// @brief Returns all IPv4 leases.
+    ///
+    /// @return Lease collection (may be empty if no IPv4 lease found).
+    virtual Lease4Collection getLeases4() const override;
+
+    /// @brief Returns range of IPv4 leases using paging.
+    ///
+    /// @param lower_bound_address IPv4 address used as lower bound for the
+    /// returned range.
+    /// @param page_size maximum size of the page returned.
+    ///
+    /// @return Lease collection (may be empty if no IPv4 lease found).
+    virtual Lease4Collection
+    getLeases4(const asiolink::IOAddress& lower_bound_address,
+               const LeasePageSize& page_size) const override;
+
+    /// @brief Returns existing IPv6 lease for a given IPv6 address.
+    ///
+    /// @param type specifies lease type: (NA, TA or PD)
+    /// @param addr address of the searched lease
+    ///
+    /// @return smart pointer to the lease (or NULL if a lease is not found)
+    virtual Lease6Ptr getLease6(Lease::Type type,
+                                const isc::asiolink::IOAddress& addr) const override;
+
+    /// @brief Returns existing IPv6 leases for a given DUID+IA combination
+    ///
+    /// @param type specifies lease type: (NA, TA or PD)
+    /// @param duid client DUID
+    /// @param iaid IA identifier
+    ///
+    /// @return Lease collection (may be empty if no IPv6 lease found).
+    virtual Lease6Collection getLeases6(Lease::Type type, const DUID& duid,
+                                        uint32_t iaid) const override;
+
+    /// @brief Returns existing IPv6 lease for a given DUID+IA combination
+    ///
+    /// @param type specifies lease type: (NA, TA or PD)
+    /// @param duid client DUID
+    /// @param iaid IA identifier
+    /// @param subnet_id subnet id of the subnet the lease belongs to
+    ///
+    /// @return Lease collection (may be empty if no IPv6 lease found).
+    virtual Lease6Collection getLeases6(Lease::Type type, const DUID& duid,
+                                        uint32_t iaid, SubnetID subnet_id) const override;
+
+    /// @brief Returns all IPv6 leases for the particular subnet identifier.
+    ///
+    /// @param subnet_id subnet identifier.
+    ///
+    /// @return Lease collection (may be empty if no IPv6 lease found).
+    virtual Lease6Collection getLeases6(SubnetID subnet_id) const override;
+
+    /// @brief Returns all IPv6 leases for the particular hostname.
+    ///
+    /// The hostname is not indexed so the database is scanned.
+    ///
+    /// @param hostname hostname in lower case.
+    ///
+    /// @return Lease collection (may be empty if no IPv6 lease found).
+    virtual Lease6Collection getLeases6(const std::string& hostname) const override;
+
+    /// @brief Returns all IPv6 leases.
+    ///
+    /// @return Lease collection (may be empty if no IPv6 lease found).
+    virtual Lease6Collection getLeases6() const override;
+
+    /// @brief Returns IPv6 leases for the DUID.
+    ///
+    /// @param duid client DUID
+    ///
+    /// @return Lease collection (may be empty if no IPv6 lease found).
+    virtual Lease6Collection getLeases6(const DUID& duid) const override;
+
+    /// @brief Returns range of IPv6 leases using paging.
+    ///
+    /// @param lower_bound_address IPv6 address used as lower bound for the
+    /// returned range.
+    /// @param page_size maximum size of the page returned.
+    ///
+    /// @return Lease collection (may be empty if no IPv6 lease found).
+    virtual Lease6Collection
+    getLeases6(const asiolink::IOAddress& lower_bound_address,
+               const LeasePageSize& page_size) const override;
+
+    /// @brief Returns a collection of expired DHCPv4 leases.
+    ///
+    /// The leases are read from the expiration index, the leases which
+    /// expired first are returned first.
+    ///
+    /// @param [out] expired_leases A container to which expired leases returned
+    /// by the database backend are added.
+    /// @param max_leases A maximum number of leases to be returned. If this
+    /// value is set to 0, all expired (but not reclaimed) leases are returned.
+    virtual void getExpiredLeases4(Lease4Collection& expired_leases,
+                                   const size_t max_leases) const override;
+
+    /// @brief Returns a collection of expired DHCPv6 leases.
+    ///
+    /// The leases are read from the expiration index, the leases which
+    /// expired first are returned first.
+    ///
+    /// @param [out] expired_leases A container to which expired leases returned
+    /// by the database backend are added.
+    /// @param max_leases A maximum number of leases to be returned. If this
+    /// value is set to 0, all expired (but not reclaimed) leases are returned.
+    virtual void getExpiredLeases6(Lease6Collection& expired_leases,
+                                   const size_t max_leases) const override;
+
+    /// @brief Updates IPv4 lease.
+    ///
+    /// As for the SQL backends the lease is updated only when its
+    /// expiration time in the database is the current expiration time
+    /// of the lease.
+    ///
+    /// @param lease4 The lease to be updated.
+    ///
+    /// @throw NoSuchLease if the lease does not exist or was changed.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual void updateLease4(const Lease4Ptr& lease4) override;
+
+    /// @brief Updates IPv6 lease.
+    ///
+    /// As for the SQL backends the lease is updated only when its
+    /// expiration time in the database is the current expiration time
+    /// of the lease.
+    ///
+    /// @param lease6 The lease to be updated.
+    ///
+    /// @throw NoSuchLease if the lease does not exist or was changed.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual void updateLease6(const Lease6Ptr& lease6) override;
+
+    /// @brief Deletes an IPv4 lease.
+    ///
+    /// @param lease IPv4 lease being deleted.
+    ///
+    /// @return true if deletion was successful, false if no such lease exists
+    /// or the lease was changed.
+    ///
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual bool deleteLease(const Lease4Ptr& lease) override;
+
+    /// @brief Deletes an IPv6 lease.
+    ///
+    /// @param lease IPv6 lease being deleted.
+    ///
+    /// @return true if deletion was successful, false if no such lease exists
+    /// or the lease was changed.
+    ///
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual bool deleteLease(const Lease6Ptr& lease) override;
+
+    /// @brief Deletes all expired-reclaimed DHCPv4 leases.
+    ///
+    /// @param secs Number of seconds since expiration of leases before
+    /// they can be removed. Leases which have expired later than this
+    /// time will not be deleted.
+    ///
+    /// @return Number of leases deleted.
+    virtual uint64_t deleteExpiredReclaimedLeases4(const uint32_t secs) override;
+
+    /// @brief Deletes all expired-reclaimed DHCPv6 leases.
+    ///
+    /// @param secs Number of seconds since expiration of leases before
+    /// they can be removed. Leases which have expired later than this
+    /// time will not be deleted.
+    ///
+    /// @return Number of leases deleted.
+    virtual uint64_t deleteExpiredReclaimedLeases6(const uint32_t secs) override;
+
+    /// @brief Creates and runs the IPv4 lease stats query
+    ///
+    /// The statistics are served by the in-memory lease statistics
+    /// counter.
+    ///
+    /// @return The populated query as a pointer to an LeaseStatsQuery
+    virtual LeaseStatsQueryPtr startLeaseStatsQuery4() override;
+
+    /// @brief Creates and runs the IPv4 lease stats query for a single subnet
+    ///
+    /// @param subnet_id id of the subnet for which stats are desired
+    /// @return A populated LeaseStatsQuery
+    virtual LeaseStatsQueryPtr startSubnetLeaseStatsQuery4(const SubnetID& subnet_id) override;
+
+    /// @brief Creates and runs the IPv4 lease stats query for a single subnet
+    ///
+    /// @param first_subnet_id first subnet in the range of subnets
+    /// @param last_subnet_id last subnet in the range of subnets
+    /// @return A populated LeaseStatsQuery
+    virtual LeaseStatsQueryPtr startSubnetRangeLeaseStatsQuery4(const SubnetID& first_subnet_id,
+                                                                const SubnetID& last_subnet_id) override;
+
+    /// @brief Creates and runs the IPv6 lease stats query
+    ///
+    /// The statistics are served by the in-memory lease statistics
+    /// counter.
+    ///
+    /// @return The populated query as a pointer to an LeaseStatsQuery.
+    virtual LeaseStatsQueryPtr startLeaseStatsQuery6() override;
+
+    /// @brief Creates and runs the IPv6 lease stats query for a single subnet
+    ///
+    /// @param subnet_id id of the subnet for which stats are desired
+    /// @return A populated LeaseStatsQuery
+    virtual LeaseStatsQueryPtr startSubnetLeaseStatsQuery6(const SubnetID& subnet_id) override;
+
+    /// @brief Creates and runs the IPv6 lease stats query for a single subnet
+    ///
+    /// @param first_subnet_id first subnet in the range of subnets
+    /// @param last_subnet_id last subnet in the range of subnets
+    /// @return A populated LeaseStatsQuery
+    virtual LeaseStatsQueryPtr startSubnetRangeLeaseStatsQuery6(const SubnetID& first_subnet_id,
+                                                                const SubnetID& last_subnet_id) override;
+
+    /// @brief Removes specified IPv4 leases.
+    ///
+    /// @param subnet_id identifier of the subnet
+    /// @return number of leases removed.
+    virtual size_t wipeLeases4(const SubnetID& subnet_id) override;
+
+    /// @brief Removed specified IPv6 leases.
+    ///
+    /// @param subnet_id identifier of the subnet
+    /// @return number of leases removed.
+    virtual size_t wipeLeases6(const SubnetID& subnet_id) override;
+
+    /// @brief Checks if the IPv4 lease limits set in the given user context are
+    /// exceeded.
+    ///
+    /// The limits are checked by the in-memory lease limit counter.
+    ///
+    /// @param user_context all or part of the lease's user context which,
+    /// for the intents and purposes of lease limiting should have the
+    /// following format (not all nodes are mandatory and values are given
+    /// only as examples):
+    /// { "ISC": { "limits": { "client-classes": [
+    ///   { "name": "foo", "address-limit": 2 } ],
+    ///   "subnet": { "id": 1, "address-limit": 2 } } } }
+    ///
+    /// @return a string describing a limit that is being exceeded, or an empty
+    /// string if no limits are exceeded
+    virtual std::string
+    checkLimits4(isc::data::ConstElementPtr const& user_context) const override;
+
+    /// @brief Checks if the IPv6 lease limits set in the given user context are
+    /// exceeded.
+    ///
+    /// The limits are checked by the in-memory lease limit counter.
+    ///
+    /// @param user_context all or part of the lease's user context which,
+    /// for the intents and purposes of lease limiting should have the
+    /// following format (not all nodes are mandatory and values are given
+    /// only as examples):
+    /// { "ISC": { "limits": { "client-classes": [
+    ///   { "name": "foo", "address-limit": 2, "prefix-limit": 1 } ],
+    ///   "subnet": { "id": 1, "address-limit": 2, "prefix-limit": 1 } } } }
+    ///
+    /// @return a string describing a limit that is being exceeded, or an empty
+    /// string if no limits are exceeded
+    virtual std::string
+    checkLimits6(isc::data::ConstElementPtr const& user_context) const override;
+
+    /// @brief Checks if JSON support is enabled in the database.
+    ///
+    /// @return true, the user contexts are kept in the lease encoding.
+    virtual bool isJsonSupported() const override;
+
+    /// @brief Returns backend type.
+    ///
+    /// @return Type of the backend.
+    virtual std::string getType() const override {
+        return (std::string("lmdb"));
+    }
+
+    /// @brief Returns name of the database file.
+    ///
+    /// @return Name of the database file.
+    virtual std::string getName() const override;
+
+    /// @brief Returns description of the backend.
+    ///
+    /// @return Description of the backend.
+    virtual std::string getDescription() const override;
+
+    /// @brief Returns backend version.
+    ///
+    /// @return Version number as a pair of unsigned integers. "first" is the
+    ///         major version number, "second" the minor number.
+    ///
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual std::pair<uint32_t, uint32_t> getVersion() const override;
+
+    /// @brief Commit Transactions
+    ///
+    /// This is a no-op: each lease operation is committed by its own
+    /// transaction.
+    virtual void commit() override;
+
+    /// @brief Rollback Transactions
+    ///
+    /// This is a no-op: each lease operation is committed by its own
+    /// transaction.
+    virtual void rollback() override;
+
+    /// @brief Returns the class lease count for a given class and lease type.
+    ///
+    /// The count is kept by the in-memory lease limit counter.
+    ///
+    /// @param client_class client class for which the count is desired
+    /// @param ltype type of lease for which the count is desired. Defaults to
+    /// Lease::TYPE_V4.
+    ///
+    /// @return number of leases
+    virtual size_t getClassLeaseCount(const ClientClass& client_class,
+                                      const Lease::Type& ltype = Lease::TYPE_V4) const override;
+
+    /// @brief Recount the leases per class for V4 leases.
+    virtual void recountClassLeases4() override;
+
+    /// @brief Recount the leases per class for V6 leases.
+    virtual void recountClassLeases6() override;
+
+    /// @brief Clears the class-lease count map.
+    virtual void clearClassLeaseCounts() override;
+
+    /// @brief Returns existing IPv4 leases with a given relay-id.
+    ///
+    /// @throw NotImplemented, the extended info tables are not supported.
+    virtual Lease4Collection
+    getLeases4ByRelayId(const OptionBuffer& relay_id,
+                        const asiolink::IOAddress& lower_bound_address,
+                        const LeasePageSize& page_size,
+                        const time_t& qry_start_time = 0,
+                        const time_t& qry_end_time = 0) override;
+
+    /// @brief Returns existing IPv4 leases with a given remote-id.
+    ///
+    /// @throw NotImplemented, the extended info tables are not supported.
+    virtual Lease4Collection
+    getLeases4ByRemoteId(const OptionBuffer& remote_id,
+                         const asiolink::IOAddress& lower_bound_address,
+                         const LeasePageSize& page_size,
+                         const time_t& qry_start_time = 0,
+                         const time_t& qry_end_time = 0) override;
+
+    /// @brief Returns existing IPv6 leases with a given relay-id.
+    ///
+    /// @throw NotImplemented, the extended info tables are not supported.
+    virtual Lease6Collection
+    getLeases6ByRelayId(const DUID& relay_id,
+                        const asiolink::IOAddress& link_addr,
+                        uint8_t link_len,
+                        const asiolink::IOAddress& lower_bound_address,
+                        const LeasePageSize& page_size) override;
+
+    /// @brief Returns existing IPv6 leases with a given remote-id.
+    ///
+    /// @throw NotImplemented, the extended info tables are not supported.
+    virtual Lease6Collection
+    getLeases6ByRemoteId(const OptionBuffer& remote_id,
+                         const asiolink::IOAddress& link_addr,
+                         uint8_t link_len,
+                         const asiolink::IOAddress& lower_bound_address,
+                         const LeasePageSize& page_size) override;
+
+    /// @brief Returns existing IPv6 leases with on a given link.
+    ///
+    /// @throw NotImplemented, the extended info tables are not supported.
+    virtual Lease6Collection
+    getLeases6ByLink(const asiolink::IOAddress& link_addr,
+                     uint8_t link_len,
+                     const asiolink::IOAddress& lower_bound_address,
+                     const LeasePageSize& page_size) override;
+
+    /// @brief Extended information / Bulk Lease Query shared interface.
+    ///
+    /// @throw NotImplemented, the extended info tables are not supported.
+    virtual size_t buildExtendedInfoTables6(bool update, bool current) override;
+
+    /// @brief Write V4 leases to a file.
+    ///
+    /// @throw NotImplemented
+    virtual void writeLeases4(const std::string& /*filename*/) override;
+
+    /// @brief Write V6 leases to a file.
+    ///
+    /// @throw NotImplemented
+    virtual void writeLeases6(const std::string& /*filename*/) override;
+
+    /// @brief Modifies the setting whether the lease extended info tables
+    /// are enabled.
+    ///
+    /// @param enabled new setting.
+    /// @throw isc::NotImplemented when enabled is true.
+    virtual void setExtendedInfoTablesEnabled(const bool enabled) override {
+        if (enabled) {
+            isc_throw(isc::NotImplemented,
+                      "extended info tables are not supported by lmdb");
+        }
+    }
+
+    /// @brief Returns the name of the default database file.
+    ///
+    /// @param u Universe (4 or 6).
+    /// @return Full path to the default database file.
+    static std::string getDefaultLeaseFilePath(uint16_t u);
+
+protected:
+
+    /// @brief Modifies the setting whether the lease extended info tables
+    /// are enabled.
+    ///
+    /// @param parameters A data structure relating keywords and values
+    /// concerned with the database.
+    virtual void setExtendedInfoTablesEnabled(const db::DatabaseConnection::ParameterMap& parameters) override;
+
+    /// @brief Delete lease6 extended info from tables.
+    ///
+    /// @throw NotImplemented, the extended info tables are not supported.
+    virtual void deleteExtendedInfo6(const isc::asiolink::IOAddress& addr) override;
+
+    /// @brief Add lease6 extended info into by-relay-id table.
+    ///
+    /// @throw NotImplemented, the extended info tables are not supported.
+    virtual void addRelayId6(const isc::asiolink::IOAddress& lease_addr,
+                             const std::vector<uint8_t>& relay_id) override;
+
+    /// @brief Add lease6 extended info into by-remote-id table.
+    ///
+    /// @throw NotImplemented, the extended info tables are not supported.
+    virtual void addRemoteId6(const isc::asiolink::IOAddress& lease_addr,
+                              const std::vector<uint8_t>& remote_id) override;
+
+private:
+
+    /// @brief Named databases of the environment.
+    enum DatabaseIndex {
+        LEASE4,
+        LEASE4_HWADDR,
+        LEASE4_CLIENT_ID,
+        LEASE4_SUBNET,
+        LEASE4_EXPIRE,
+        LEASE6,
+        LEASE6_DUID,
+        LEASE6_SUBNET,
+        LEASE6_EXPIRE,
+        META,
+        NUM_DATABASES       // Number of named databases.
+    };
+
+    /// @brief Type of the database keys and values.
+    typedef std::vector<uint8_t> Key;
+
+    /// @brief An LMDB transaction.
+    ///
+    /// The transaction is aborted by the destructor when it was not
+    /// committed.
+    class Transaction : public boost::noncopyable {
+    public:
+
+        /// @brief Constructor.
+        ///
+        /// Begins the transaction.
+        ///
+        /// @param env LMDB environment.
+        /// @param read_only true for a read-only transaction.
+        /// @throw isc::db::DbOperationError if the transaction can't begin.
+        Transaction(MDB_env* env, bool read_only);
+
+        /// @brief Destructor.
+        ///
+        /// Aborts the transaction when it was not committed.
+        ~Transaction();
+
+        /// @brief Commits the transaction.
+        ///
+        /// @throw isc::db::DbOperationError if the commit failed.
+        void commit();
+
+        /// @brief Returns the LMDB transaction.
+        MDB_txn* get() const {
+            return (txn_);
+        }
+
+    private:
+
+        /// @brief LMDB transaction, null when committed.
+        MDB_txn* txn_;
+    };
+
+    /// @brief Callback invoked by the scans with a key and a value.
+    ///
+    /// The scan stops when the callback returns false.
+    typedef std::function<bool(const uint8_t* key, size_t key_len,
+                               const uint8_t* data, size_t data_len)> ScanCallback;
+
+    /// @brief Returns the key of an address.
+    ///
+    /// @param addr IPv4 or IPv6 address.
+    /// @return 4 or 16 bytes in network order.
+    static Key addressKey(const isc::asiolink::IOAddress& addr);
+
+    /// @brief Returns the key of a variable length identifier.
+    ///
+    /// The identifier is prefixed by its length so an identifier is not
+    /// the prefix of another one.
+    ///
+    /// @param id the identifier.
+    /// @return Key prefix.
+    static Key identifierKey(const std::vector<uint8_t>& id);
+
+    /// @brief Returns the key prefix of a subnet.
+    ///
+    /// @param subnet_id subnet identifier.
+    /// @return Key prefix.
+    static Key subnetKey(SubnetID subnet_id);
+
+    /// @brief Returns the key prefix in the expiration index.
+    ///
+    /// @param reclaimed true for the expired-reclaimed leases.
+    /// @param expire expiration time.
+    /// @return Key prefix.
+    static Key expireKey(bool reclaimed, int64_t expire);
+
+    /// @brief Returns the expiration index key of a lease.
+    ///
+    /// @param lease the lease.
+    /// @return Key.
+    static Key expireKey(const Lease& lease);
+
+    /// @brief Appends the lease address to an index key.
+    ///
+    /// @param key index key.
+    /// @param lease the lease.
+    /// @return Index key.
+    static Key indexKey(Key key, const Lease& lease);
+
+    /// @brief Throws a database error when a status is not MDB_SUCCESS.
+    ///
+    /// @param status status returned by an LMDB function.
+    /// @param what the failed operation.
+    /// @throw isc::db::DbOperationError if the status is an error.
+    static void checkError(int status, const char* what);
+
+    /// @brief Reads the value of a key.
+    ///
+    /// @param txn transaction.
+    /// @param dbi database.
+    /// @param key the key.
+    /// @param [out] value the value.
+    /// @return true if the key was found.
+    bool get(MDB_txn* txn, DatabaseIndex dbi, const Key& key, Key& value) const;
+
+    /// @brief Writes a key and a value.
+    ///
+    /// @param txn transaction.
+    /// @param dbi database.
+    /// @param key the key.
+    /// @param value the value.
+    /// @param no_overwrite true to not overwrite an existing key.
+    /// @return false if the key exists and no_overwrite is true.
+    bool put(MDB_txn* txn, DatabaseIndex dbi, const Key& key, const Key& value,
+             bool no_overwrite = false);
+
+    /// @brief Deletes a key.
+    ///
+    /// @param txn transaction.
+    /// @param dbi database.
+    /// @param key the key.
+    /// @return false if the key was not found.
+    bool del(MDB_txn* txn, DatabaseIndex dbi, const Key& key);
+
+    /// @brief Scans the keys starting with a prefix.
+    ///
+    /// @param txn transaction.
+    /// @param dbi database.
+    /// @param prefix key prefix, empty for all the keys.
+    /// @param callback callback invoked for each key.
+    void scan(MDB_txn* txn, DatabaseIndex dbi, const Key& prefix,
+              const ScanCallback& callback) const;
+
+    /// @brief Scans the keys starting at a key.
+    ///
+    /// @param txn transaction.
+    /// @param dbi database.
+    /// @param start first key.
+    /// @param callback callback invoked for each key.
+    void scanFrom(MDB_txn* txn, DatabaseIndex dbi, const Key& start,
+                  const ScanCallback& callback) const;
+
+    /// @brief Returns the addresses of the leases in an index.
+    ///
+    /// @param txn transaction.
+    /// @param dbi index database.
+    /// @param prefix key prefix.
+    /// @param addr_len length of the addresses (4 or 16).
+    /// @return address keys.
+    std::vector<Key> getIndexed(MDB_txn* txn, DatabaseIndex dbi,
+                                const Key& prefix, size_t addr_len) const;
+
+    /// @brief Encodes an IPv4 lease.
+    static Key encode(const Lease4& lease);
+
+    /// @brief Encodes an IPv6 lease.
+    static Key encode(const Lease6& lease);
+
+    /// @brief Decodes an IPv4 lease.
+    static Lease4Ptr decode4(const uint8_t* data, size_t len);
+
+    /// @brief Decodes an IPv6 lease.
+    static Lease6Ptr decode6(const uint8_t* data, size_t len);
+
+    /// @brief Reads an IPv4 lease.
+    ///
+    /// @param txn transaction.
+    /// @param key address key.
+    /// @return the lease or null.
+    Lease4Ptr getLease4Internal(MDB_txn* txn, const Key& key) const;
+
+    /// @brief Reads an IPv6 lease.
+    ///
+    /// @param txn transaction.
+    /// @param key address key.
+    /// @return the lease or null.
+    Lease6Ptr getLease6Internal(MDB_txn* txn, const Key& key) const;
+
+    /// @brief Reads the IPv4 leases of an index.
+    ///
+    /// @param dbi index database.
+    /// @param prefix key prefix.
+    /// @param collection [out] the leases.
+    void getLeasesByIndex(DatabaseIndex dbi, const Key& prefix,
+                          Lease4Collection& collection) const;
+
+    /// @brief Reads the IPv6 leases of an index.
+    ///
+    /// @param dbi index database.
+    /// @param prefix key prefix.
+    /// @param collection [out] the leases.
+    void getLeasesByIndex(DatabaseIndex dbi, const Key& prefix,
+                          Lease6Collection& collection) const;
+
+    /// @brief Writes an IPv4 lease and its index entries.
+    ///
+    /// @param txn transaction.
+    /// @param lease the lease.
+    void putLease(MDB_txn* txn, const Lease4& lease);
+
+    /// @brief Writes an IPv6 lease and its index entries.
+    ///
+    /// @param txn transaction.
+    /// @param lease the lease.
+    void putLease(MDB_txn* txn, const Lease6& lease);
+
+    /// @brief Deletes the index entries of an IPv4 lease.
+    ///
+    /// @param txn transaction.
+    /// @param lease the lease.
+    void deleteIndexes(MDB_txn* txn, const Lease4& lease);
+
+    /// @brief Deletes the index entries of an IPv6 lease.
+    ///
+    /// @param txn transaction.
+    /// @param lease the lease.
+    void deleteIndexes(MDB_txn* txn, const Lease6& lease);
+
+    /// @brief Checks the expiration time of a lease in the database.
+    ///
+    /// @param old_lease the lease in the database.
+    /// @param lease the lease being updated or deleted.
+    /// @return true if the lease in the database was not changed since
+    /// the lease was read.
+    static bool sameExpiration(const Lease& old_lease, const Lease& lease);
+
+    /// @brief Common part of the deletion of expired-reclaimed leases.
+    ///
+    /// @param secs Number of seconds since expiration of leases before
+    /// they can be removed.
+    /// @param universe 4 or 6.
+    /// @return Number of leases deleted.
+    uint64_t deleteExpiredReclaimedLeasesCommon(const uint32_t secs,
+                                                uint16_t universe);
+
+    /// @brief LMDB environment.
+    MDB_env* env_;
+
+    /// @brief Handles of the named databases.
+    MDB_dbi dbis_[NUM_DATABASES];
+
+    /// @brief Name of the database file.
+    std::string filename_;
+};
+
+} // namespace dhcp
+} // namespace isc
+
+#endif // LMDB_LEASE_MGR_H
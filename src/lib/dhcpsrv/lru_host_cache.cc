@@ -0,0 +1,353 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/lru_host_cache.h>
+#include <exceptions/exceptions.h>
+#include <stats/stats_mgr.h>
+#include <util/multi_threading_mgr.h>
+
+#include <vector>
+
+using namespace isc::asiolink;
+using namespace isc::stats;
+using namespace isc::util;
+
+namespace isc {
+namespace dhcp {
+
+LruHostCache::LruHostCache(size_t capacity, uint32_t ttl)
+    : capacity_(capacity), ttl_(ttl),
+      hits_(StatsMgr::instance().registerCounter("host-cache-hits")),
+      misses_(StatsMgr::instance().registerCounter("host-cache-misses")),
+      mutex_(new std::mutex) {
+    if (capacity_ == 0) {
+        isc_throw(BadValue, "LRU host cache capacity must not be 0");
+    }
+}
+
+ConstHostCollection
+LruHostCache::getAll(const Host::IdentifierType&, const uint8_t*,
+                     const size_t) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+LruHostCache::getAll4(const SubnetID&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+LruHostCache::getAll6(const SubnetID&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+LruHostCache::getAllbyHostname(const std::string&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+LruHostCache::getAllbyHostname4(const std::string&, const SubnetID&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+LruHostCache::getAllbyHostname6(const std::string&, const SubnetID&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+LruHostCache::getPage4(const SubnetID&, size_t&, uint64_t,
+                       const HostPageSize&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+LruHostCache::getPage6(const SubnetID&, size_t&, uint64_t,
+                       const HostPageSize&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+LruHostCache::getPage4(size_t&, uint64_t, const HostPageSize&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+LruHostCache::getPage6(size_t&, uint64_t, const HostPageSize&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+LruHostCache::getAll4(const IOAddress&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostPtr
+LruHostCache::get4(const SubnetID& subnet_id,
+                   const Host::IdentifierType& identifier_type,
+                   const uint8_t* identifier_begin,
+                   const size_t identifier_len) const {
+    std::string key = makeKey(AF_INET, subnet_id, identifier_type,
+                              identifier_begin, identifier_len);
+    MultiThreadingLock lock(*mutex_);
+    return (getInternal(key));
+}
+
+ConstHostPtr
+LruHostCache::get4(const SubnetID&, const IOAddress&) const {
+    return (ConstHostPtr());
+}
+
+ConstHostCollection
+LruHostCache::getAll4(const SubnetID&, const IOAddress&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostPtr
+LruHostCache::get6(const SubnetID& subnet_id,
+                   const Host::IdentifierType& identifier_type,
+                   const uint8_t* identifier_begin,
+                   const size_t identifier_len) const {
+    std::string key = makeKey(AF_INET6, subnet_id, identifier_type,
+                              identifier_begin, identifier_len);
+    MultiThreadingLock lock(*mutex_);
+    return (getInternal(key));
+}
+
+ConstHostPtr
+LruHostCache::get6(const IOAddress&, const uint8_t) const {
+    return (ConstHostPtr());
+}
+
+ConstHostPtr
+LruHostCache::get6(const SubnetID&, const IOAddress&) const {
+    return (ConstHostPtr());
+}
+
+ConstHostCollection
+LruHostCache::getAll6(const SubnetID&, const IOAddress&) const {
+    return (ConstHostCollection());
+}
+
+void
+LruHostCache::add(const HostPtr&) {
+}
+
+bool
+LruHostCache::del(const SubnetID& subnet_id, const IOAddress& addr) {
+    MultiThreadingLock lock(*mutex_);
+    for (auto it = entries_.begin(); it != entries_.end(); ) {
+        const ConstHostPtr& host = it->host_;
+        bool match = false;
+        if (!host->getNegative()) {
+            if (addr.isV4()) {
+                match = ((host->getIPv4SubnetID() == subnet_id) &&
+                         (host->getIPv4Reservation() == addr));
+            } else if (host->getIPv6SubnetID() == subnet_id) {
+                auto const& range = host->getIPv6Reservations();
+                for (auto resrv = range.first; resrv != range.second; ++resrv) {
+                    if (resrv->second.getPrefix() == addr) {
+                        match = true;
+                        break;
+                    }
+                }
+            }
+        }
+        if (match) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return (false);
+}
+
+bool
+LruHostCache::del4(const SubnetID& subnet_id,
+                   const Host::IdentifierType& identifier_type,
+                   const uint8_t* identifier_begin,
+                   const size_t identifier_len) {
+    std::string key = makeKey(AF_INET, subnet_id, identifier_type,
+                              identifier_begin, identifier_len);
+    MultiThreadingLock lock(*mutex_);
+    removeInternal(key);
+    return (false);
+}
+
+bool
+LruHostCache::del6(const SubnetID& subnet_id,
+                   const Host::IdentifierType& identifier_type,
+                   const uint8_t* identifier_begin,
+                   const size_t identifier_len) {
+    std::string key = makeKey(AF_INET6, subnet_id, identifier_type,
+                              identifier_begin, identifier_len);
+    MultiThreadingLock lock(*mutex_);
+    removeInternal(key);
+    return (false);
+}
+
+size_t
+LruHostCache::insert(const ConstHostPtr& host, bool overwrite) {
+    if (!host) {
+        isc_throw(BadValue, "LRU host cache can't insert a null host");
+    }
+
+    const std::vector<uint8_t>& identifier = host->getIdentifier();
+    std::vector<std::string> keys;
+    if (host->getIPv4SubnetID() != SUBNET_ID_UNUSED) {
+        keys.push_back(makeKey(AF_INET, host->getIPv4SubnetID(),
+                               host->getIdentifierType(),
+                               identifier.data(), identifier.size()));
+    }
+    if (host->getIPv6SubnetID() != SUBNET_ID_UNUSED) {
+        keys.push_back(makeKey(AF_INET6, host->getIPv6SubnetID(),
+                               host->getIdentifierType(),
+                               identifier.data(), identifier.size()));
+    }
+
+    MultiThreadingLock lock(*mutex_);
+    auto& index = entries_.get<KeyIndexTag>();
+    if (!overwrite) {
+        for (auto const& key : keys) {
+            if (index.find(key) != index.end()) {
+                return (1);
+            }
+        }
+    }
+    size_t conflicts = 0;
+    for (auto const& key : keys) {
+        conflicts += insertInternal(key, host, overwrite);
+    }
+    return (conflicts);
+}
+
+bool
+LruHostCache::remove(const HostPtr& host) {
+    if (!host) {
+        return (false);
+    }
+
+    const std::vector<uint8_t>& identifier = host->getIdentifier();
+    std::vector<std::string> keys;
+    keys.push_back(makeKey(AF_INET, host->getIPv4SubnetID(),
+                           host->getIdentifierType(),
+                           identifier.data(), identifier.size()));
+    keys.push_back(makeKey(AF_INET6, host->getIPv6SubnetID(),
+                           host->getIdentifierType(),
+                           identifier.data(), identifier.size()));
+
+    MultiThreadingLock lock(*mutex_);
+    auto& index = entries_.get<KeyIndexTag>();
+    bool removed = false;
+    for (auto const& key : keys) {
+        auto it = index.find(key);
+        // Remove only the cached object.
+        if ((it != index.end()) && (it->host_ == host)) {
+            index.erase(it);
+            removed = true;
+        }
+    }
+    return (removed);
+}
+
+void
+LruHostCache::flush(size_t count) {
+    MultiThreadingLock lock(*mutex_);
+    if ((count == 0) || (count >= entries_.size())) {
+        entries_.clear();
+        return;
+    }
+    for (; count > 0; --count) {
+        entries_.pop_back();
+    }
+}
+
+size_t
+LruHostCache::size() const {
+    MultiThreadingLock lock(*mutex_);
+    return (entries_.size());
+}
+
+std::string
+LruHostCache::makeKey(uint16_t family, const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len) {
+    std::string key;
+    key.reserve(6 + identifier_len);
+    key.push_back(family == AF_INET ? '4' : '6');
+    uint32_t id = subnet_id;
+    key.push_back(static_cast<char>(id >> 24));
+    key.push_back(static_cast<char>(id >> 16));
+    key.push_back(static_cast<char>(id >> 8));
+    key.push_back(static_cast<char>(id));
+    key.push_back(static_cast<char>(identifier_type));
+    if (identifier_len > 0) {
+        key.append(reinterpret_cast<const char*>(identifier_begin),
+                   identifier_len);
+    }
+    return (key);
+}
+
+ConstHostPtr
+LruHostCache::getInternal(const std::string& key) const {
+    auto& index = entries_.get<KeyIndexTag>();
+    auto it = index.find(key);
+    if (it == index.end()) {
+        misses_->add();
+        return (ConstHostPtr());
+    }
+    if ((ttl_ > 0) && (it->expire_ <= Clock::now())) {
+        index.erase(it);
+        misses_->add();
+        return (ConstHostPtr());
+    }
+    entries_.relocate(entries_.begin(), entries_.project<0>(it));
+    hits_->add();
+    return (it->host_);
+}
+
+size_t
+LruHostCache::insertInternal(const std::string& key, const ConstHostPtr& host,
+                             bool overwrite) {
+    Entry entry{key, host, Clock::time_point::max()};
+    if (ttl_ > 0) {
+        entry.expire_ = Clock::now() + std::chrono::seconds(ttl_);
+    }
+
+    auto& index = entries_.get<KeyIndexTag>();
+    auto it = index.find(key);
+    if (it != index.end()) {
+        if (overwrite) {
+            index.replace(it, entry);
+            entries_.relocate(entries_.begin(), entries_.project<0>(it));
+        }
+        return (1);
+    }
+
+    entries_.push_front(entry);
+    if (entries_.size() > capacity_) {
+        entries_.pop_back();
+    }
+    return (0);
+}
+
+bool
+LruHostCache::removeInternal(const std::string& key) {
+    auto& index = entries_.get<KeyIndexTag>();
+    auto it = index.find(key);
+    if (it == index.end()) {
+        return (false);
+    }
+    index.erase(it);
+    return (true);
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
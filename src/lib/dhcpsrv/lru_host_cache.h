@@ -0,0 +1,365 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LRU_HOST_CACHE_H
+#define LRU_HOST_CACHE_H
+
+#include <dhcpsrv/cache_host_data_source.h>
+#include <stats/stat_counter.h>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Bounded least recently used cache of host reservations.
+///
+/// The SQL host backends issue at least one query per packet to look
+/// for the reservations of the client, even when most of the clients
+/// have no reservation at all. This cache sits in front of the host
+/// backends and remembers the result of the lookups by subnet and
+/// identifier, including negative answers when the host manager
+/// negative caching is enabled.
+///
+/// The cache holds at most @c capacity entries and evicts the least
+/// recently used one when it is full. An entry older than the TTL is
+/// ignored and removed by the next lookup. Only the lookups by subnet and
+/// identifier are answered, all other lookups return nothing so the host
+/// manager falls through to the host backends.
+///
+/// The lookups update the "host-cache-hits" and "host-cache-misses"
+/// statistics.
+///
+/// The cache is thread safe.
+class LruHostCache : public CacheHostDataSource {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param capacity maximum number of entries, must not be 0.
+    /// @param ttl lifetime of an entry in seconds, 0 means unlimited.
+    /// @throw BadValue when the capacity is 0.
+    LruHostCache(size_t capacity, uint32_t ttl);
+
+    /// @brief Destructor.
+    virtual ~LruHostCache() = default;
+
+    /// @brief Returns nothing, the cache only answers lookups by
+    /// subnet and identifier.
+    virtual ConstHostCollection
+    getAll(const Host::IdentifierType& identifier_type,
+           const uint8_t* identifier_begin,
+           const size_t identifier_len) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostCollection
+    getAll4(const SubnetID& subnet_id) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostCollection
+    getAll6(const SubnetID& subnet_id) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostCollection
+    getAllbyHostname(const std::string& hostname) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostCollection
+    getAllbyHostname4(const std::string& hostname,
+                      const SubnetID& subnet_id) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostCollection
+    getAllbyHostname6(const std::string& hostname,
+                      const SubnetID& subnet_id) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostCollection
+    getPage4(const SubnetID& subnet_id,
+             size_t& source_index,
+             uint64_t lower_host_id,
+             const HostPageSize& page_size) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostCollection
+    getPage6(const SubnetID& subnet_id,
+             size_t& source_index,
+             uint64_t lower_host_id,
+             const HostPageSize& page_size) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostCollection
+    getPage4(size_t& source_index,
+             uint64_t lower_host_id,
+             const HostPageSize& page_size) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostCollection
+    getPage6(size_t& source_index,
+             uint64_t lower_host_id,
+             const HostPageSize& page_size) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostCollection
+    getAll4(const asiolink::IOAddress& address) const;
+
+    /// @brief Returns a cached host connected to the IPv4 subnet.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    ///
+    /// @return Const @c Host object, possibly negative, or null when
+    /// the lookup result is not cached.
+    virtual ConstHostPtr
+    get4(const SubnetID& subnet_id,
+         const Host::IdentifierType& identifier_type,
+         const uint8_t* identifier_begin,
+         const size_t identifier_len) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostPtr
+    get4(const SubnetID& subnet_id,
+         const asiolink::IOAddress& address) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostCollection
+    getAll4(const SubnetID& subnet_id,
+            const asiolink::IOAddress& address) const;
+
+    /// @brief Returns a cached host connected to the IPv6 subnet.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    ///
+    /// @return Const @c Host object, possibly negative, or null when
+    /// the lookup result is not cached.
+    virtual ConstHostPtr
+    get6(const SubnetID& subnet_id,
+         const Host::IdentifierType& identifier_type,
+         const uint8_t* identifier_begin,
+         const size_t identifier_len) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostPtr
+    get6(const asiolink::IOAddress& prefix, const uint8_t prefix_len) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostPtr
+    get6(const SubnetID& subnet_id, const asiolink::IOAddress& address) const;
+
+    /// @brief Returns nothing.
+    virtual ConstHostCollection
+    getAll6(const SubnetID& subnet_id,
+            const asiolink::IOAddress& address) const;
+
+    /// @brief Does nothing.
+    ///
+    /// The host manager inserts the added hosts with @c insert.
+    virtual void add(const HostPtr& host);
+
+    /// @brief Removes the cached hosts with the IPv4 or IPv6 reservation.
+    ///
+    /// @param subnet_id subnet identifier.
+    /// @param addr specified address.
+    /// @return always false so the host manager deletes the host from
+    /// the host backends.
+    virtual bool del(const SubnetID& subnet_id, const asiolink::IOAddress& addr);
+
+    /// @brief Removes the cached IPv4 host.
+    ///
+    /// @param subnet_id IPv4 Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    /// @return always false so the host manager deletes the host from
+    /// the host backends.
+    virtual bool del4(const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len);
+
+    /// @brief Removes the cached IPv6 host.
+    ///
+    /// @param subnet_id IPv6 Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    /// @return always false so the host manager deletes the host from
+    /// the host backends.
+    virtual bool del6(const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len);
+
+    /// @brief Return backend type
+    ///
+    /// @return "lru-cache".
+    virtual std::string getType() const {
+        return ("lru-cache");
+    }
+
+    /// @brief The cache does not check the reservations.
+    ///
+    /// @return always true.
+    virtual bool setIPReservationsUnique(const bool) {
+        return (true);
+    }
+
+    /// @brief Insert a host into the cache.
+    ///
+    /// A host with an IPv4 subnet identifier is cached for the IPv4
+    /// lookups, a host with an IPv6 subnet identifier for the IPv6
+    /// lookups, i.e. a host can take two entries.
+    ///
+    /// @param host Pointer to the new @c Host object being inserted.
+    /// @param overwrite false if doing nothing in case of conflicts
+    /// (and returning 1), true if removing conflicting entries
+    /// (and returning their number).
+    /// @return number of conflicts limited to one if overwrite is false.
+    virtual size_t insert(const ConstHostPtr& host, bool overwrite);
+
+    /// @brief Remove a host from the cache.
+    ///
+    /// @param host Pointer to the existing @c Host object being removed.
+    /// @return true when found and removed.
+    virtual bool remove(const HostPtr& host);
+
+    /// @brief Flush entries.
+    ///
+    /// @param count number of least recently used entries to remove,
+    /// 0 means all.
+    virtual void flush(size_t count);
+
+    /// @brief Return the number of entries.
+    ///
+    /// @return the current number of entries including the expired ones.
+    virtual size_t size() const;
+
+    /// @brief Return the maximum number of entries.
+    ///
+    /// @return the maximum number of entries.
+    virtual size_t capacity() const {
+        return (capacity_);
+    }
+
+    /// @brief Return the lifetime of the entries.
+    ///
+    /// @return the lifetime of the entries in seconds, 0 means unlimited.
+    uint32_t getTtl() const {
+        return (ttl_);
+    }
+
+private:
+
+    /// @brief Builds the key of an entry.
+    ///
+    /// @param family AF_INET or AF_INET6.
+    /// @param subnet_id subnet identifier.
+    /// @param identifier_type identifier type.
+    /// @param identifier_begin pointer to the identifier.
+    /// @param identifier_len identifier length.
+    /// @return the key.
+    static std::string makeKey(uint16_t family, const SubnetID& subnet_id,
+                               const Host::IdentifierType& identifier_type,
+                               const uint8_t* identifier_begin,
+                               const size_t identifier_len);
+
+    /// @brief Looks for an entry, must be called with the mutex held.
+    ///
+    /// A hit moves the entry to the front, an expired entry is removed.
+    ///
+    /// @param key the entry key.
+    /// @return the cached host or null.
+    ConstHostPtr getInternal(const std::string& key) const;
+
+    /// @brief Inserts an entry, must be called with the mutex held.
+    ///
+    /// @param key the entry key.
+    /// @param host the host.
+    /// @param overwrite true when an existing entry is replaced.
+    /// @return 1 when an entry existed, 0 otherwise.
+    size_t insertInternal(const std::string& key, const ConstHostPtr& host,
+                          bool overwrite);
+
+    /// @brief Removes an entry, must be called with the mutex held.
+    ///
+    /// @param key the entry key.
+    /// @return true when an entry was removed.
+    bool removeInternal(const std::string& key);
+
+    /// @brief Clock used for the entry expiration.
+    typedef std::chrono::steady_clock Clock;
+
+    /// @brief A cache entry.
+    struct Entry {
+        /// @brief The key built from the family, subnet and identifier.
+        std::string key_;
+
+        /// @brief The cached host, possibly negative.
+        ConstHostPtr host_;
+
+        /// @brief The expiration time.
+        Clock::time_point expire_;
+    };
+
+    /// @brief Tag for the key index.
+    struct KeyIndexTag { };
+
+    /// @brief The cache container.
+    ///
+    /// The sequenced index keeps the most recently used entry first.
+    typedef boost::multi_index_container<
+        Entry,
+        boost::multi_index::indexed_by<
+            boost::multi_index::sequenced<>,
+            boost::multi_index::hashed_unique<
+                boost::multi_index::tag<KeyIndexTag>,
+                boost::multi_index::member<Entry, std::string, &Entry::key_>
+            >
+        >
+    > EntryContainer;
+
+    /// @brief The entries, mutable as the lookups reorder them.
+    mutable EntryContainer entries_;
+
+    /// @brief The maximum number of entries.
+    size_t capacity_;
+
+    /// @brief The lifetime of the entries in seconds.
+    uint32_t ttl_;
+
+    /// @brief The "host-cache-hits" statistic.
+    stats::StatCounterPtr hits_;
+
+    /// @brief The "host-cache-misses" statistic.
+    stats::StatCounterPtr misses_;
+
+    /// @brief The mutex protecting the entries.
+    boost::scoped_ptr<std::mutex> mutex_;
+};
+
+/// @brief Pointer to a LRU host cache.
+typedef boost::shared_ptr<LruHostCache> LruHostCachePtr;
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // LRU_HOST_CACHE_H
@@ -20,12 +20,16 @@
 #include <util/multi_threading_mgr.h>
 #include <util/pid_file.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstring>
 #include <errno.h>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <sstream>
+#include <thread>
 
 namespace {
 
@@ -38,6 +42,26 @@ namespace {
 /// Kea installation directory.
 const char* KEA_LFC_EXECUTABLE_ENV_NAME = "KEA_LFC_EXECUTABLE";
 
+/// @brief Default maximum number of queued lease changes in the
+/// write-behind mode.
+const uint32_t DEFAULT_WRITE_BEHIND_QUEUE_SIZE = 4096;
+
+/// @brief Number of leases fetched at once by the in-process lease file
+/// cleanup.
+const size_t LFC_PAGE_SIZE = 1000;
+
+/// @brief Last lease change pushed to a write queue by a thread.
+struct LastWrite {
+    /// @brief The write queue.
+    const isc::dhcp::LeaseWriteQueue* queue_;
+
+    /// @brief The sequence number of the change.
+    uint64_t sequence_;
+};
+
+/// @brief Last lease change pushed to a write queue by the current thread.
+thread_local LastWrite last_write = { 0, 0 };
+
 }  // namespace
 
 using namespace isc::asiolink;
@@ -57,7 +81,8 @@ namespace dhcp {
 /// passed in the constructor), which will be called at the specified
 /// intervals to perform the cleanup. It is also responsible for creating
 /// and maintaining the object which is used to spawn the new process which
-/// executes the @c kea-lfc program.
+/// executes the @c kea-lfc program, or the thread which performs the
+/// in-process cleanup.
 ///
 /// This functionality is enclosed in a separate class so as the implementation
 /// details are not exposed in the @c Memfile_LeaseMgr header file and
@@ -84,31 +109,66 @@ public:
     ///
     /// @param lfc_interval An interval in seconds at which the cleanup should
     /// be performed.
-    /// @param lease_file4 A pointer to the DHCPv4 lease file to be cleaned up
-    /// or null. If this is null, the @c lease_file6 must be non-null.
-    /// @param lease_file6 A pointer to the DHCPv6 lease file to be cleaned up
-    /// or null. If this is null, the @c lease_file4 must be non-null.
+    /// @param lease_file Name of the CSV lease file or lease journal to be
+    /// cleaned up.
+    /// @param u Universe of the lease file (v4 or v6).
     /// @param run_once_now A flag that causes LFC to be invoked immediately,
     /// regardless of the value of lfc_interval.  This is primarily used to
     /// cause lease file schema upgrades upon startup.
+    /// @param compaction The function performing the in-process cleanup.
+    /// When it is specified it is run by a thread instead of spawning
+    /// the @c kea-lfc process.
+    /// @param max_leases The maximum number of leases held in memory by
+    /// the @c kea-lfc process or 0 when it loads all the leases.
     void setup(const uint32_t lfc_interval,
-               const boost::shared_ptr<CSVLeaseFile4>& lease_file4,
-               const boost::shared_ptr<CSVLeaseFile6>& lease_file6,
-               bool run_once_now = false);
+               const std::string& lease_file,
+               const Memfile_LeaseMgr::Universe u,
+               bool run_once_now = false,
+               const std::function<void()>& compaction = std::function<void()>(),
+               const uint32_t max_leases = 0);
 
-    /// @brief Spawns a new process.
+    /// @brief Spawns a new process or starts the in-process cleanup.
     void execute();
 
+    /// @brief Runs the cleanup now if requested and schedules it.
+    ///
+    /// @param lfc_interval An interval in seconds at which the cleanup should
+    /// be performed.
+    /// @param run_once_now A flag that causes LFC to be invoked immediately.
+    void start(const uint32_t lfc_interval, bool run_once_now);
+
     /// @brief Checks if the lease file cleanup is in progress.
     ///
     /// @return true if the lease file cleanup is being executed.
     bool isRunning() const;
 
+    /// @brief Checks if the in-process lease file cleanup is in progress.
+    ///
+    /// @return true if the thread performing the cleanup is running.
+    bool isCompacting() const {
+        return (compacting_);
+    }
+
     /// @brief Returns exit code of the last completed cleanup.
     int getExitStatus() const;
 
 private:
 
+    /// @brief Runs the in-process cleanup in the thread.
+    void compact();
+
+    /// @brief The function performing the in-process cleanup.
+    std::function<void()> compaction_;
+
+    /// @brief The thread performing the in-process cleanup.
+    boost::scoped_ptr<std::thread> thread_;
+
+    /// @brief Indicates that the in-process cleanup is running.
+    std::atomic<bool> compacting_;
+
+    /// @brief Exit code of the last completed in-process cleanup.
+    std::atomic<int> exit_status_;
+
     /// @brief A pointer to the @c ProcessSpawn object used to execute
     /// the LFC.
     boost::scoped_ptr<ProcessSpawn> process_;
@@ -127,11 +187,18 @@ private:
 };
 
 LFCSetup::LFCSetup(asiolink::IntervalTimer::Callback callback)
-    : process_(), callback_(callback), pid_(0),
+    : compaction_(), thread_(), compacting_(false), exit_status_(0),
+      process_(), callback_(callback), pid_(0),
       timer_mgr_(TimerMgr::instance()) {
 }
 
 LFCSetup::~LFCSetup() {
+    // The in-process cleanup uses the lease manager which is being
+    // destroyed: wait for it to notice the stop request.
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+
     try {
         // Remove the timer. This will throw an exception if the timer does not
         // exist.  There are several possible reasons for this:
@@ -156,15 +223,24 @@ LFCSetup::~LFCSetup() {
 
 void
 LFCSetup::setup(const uint32_t lfc_interval,
-                const boost::shared_ptr<CSVLeaseFile4>& lease_file4,
-                const boost::shared_ptr<CSVLeaseFile6>& lease_file6,
-                bool run_once_now) {
+                const std::string& lease_file,
+                const Memfile_LeaseMgr::Universe u,
+                bool run_once_now,
+                const std::function<void()>& compaction,
+                const uint32_t max_leases) {
 
     // If to nothing to do, punt
     if (lfc_interval == 0 && !run_once_now) {
         return;
     }
 
+    // The in-process cleanup doesn't need the kea-lfc command line.
+    compaction_ = compaction;
+    if (compaction_) {
+        start(lfc_interval, run_once_now);
+        return;
+    }
+
     // Start preparing the command line for kea-lfc.
     std::string executable;
     char* c_executable = getenv(KEA_LFC_EXECUTABLE_ENV_NAME);
@@ -174,14 +250,10 @@ LFCSetup::setup(const uint32_t lfc_interval,
         executable = c_executable;
     }
 
-    // Gather the base file name.
-    std::string lease_file = lease_file4 ? lease_file4->getFilename() :
-                                           lease_file6->getFilename();
-
     // Create the other names by appending suffixes to the base name.
     ProcessArgs args;
     // Universe: v4 or v6.
-    args.push_back(lease_file4 ? "-4" : "-6");
+    args.push_back(u == Memfile_LeaseMgr::V4 ? "-4" : "-6");
 
     // Previous file.
     args.push_back("-x");
@@ -208,9 +280,20 @@ LFCSetup::setup(const uint32_t lfc_interval,
     args.push_back("-c");
     args.push_back("ignored-path");
 
+    // Merge sorted runs of leases instead of loading all the leases.
+    if (max_leases > 0) {
+        args.push_back("-m");
+        args.push_back(boost::lexical_cast<std::string>(max_leases));
+    }
+
     // Create the process (do not start it yet).
-    process_.reset(new ProcessSpawn(LeaseMgr::getIOService(), executable, args));
+    process_.reset(new ProcessSpawn(executable, args));
+
+    start(lfc_interval, run_once_now);
+}
 
+void
+LFCSetup::start(const uint32_t lfc_interval, bool run_once_now) {
     // If we've been told to run it once now, invoke the callback directly.
     if (run_once_now) {
         callback_();
@@ -232,6 +315,21 @@ LFCSetup::setup(const uint32_t lfc_interval,
 
 void
 LFCSetup::execute() {
+    if (compaction_) {
+        if (compacting_) {
+            LOG_WARN(dhcpsrv_logger, DHCPSRV_MEMFILE_LFC_IN_PROCESS_BUSY);
+            return;
+        }
+        // Reap the thread of the previous cleanup.
+        if (thread_ && thread_->joinable()) {
+            thread_->join();
+        }
+        LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_LFC_IN_PROCESS_START);
+        compacting_ = true;
+        thread_.reset(new std::thread(std::bind(&LFCSetup::compact, this)));
+        return;
+    }
+
     try {
         LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_LFC_EXECUTE)
             .arg(process_->getCommandLine());
@@ -242,13 +340,32 @@ LFCSetup::execute() {
     }
 }
 
+void
+LFCSetup::compact() {
+    try {
+        compaction_();
+        exit_status_ = 0;
+    } catch (const std::exception& ex) {
+        LOG_ERROR(dhcpsrv_logger, DHCPSRV_MEMFILE_LFC_IN_PROCESS_FAIL)
+            .arg(ex.what());
+        exit_status_ = 1;
+    }
+    compacting_ = false;
+}
+
 bool
 LFCSetup::isRunning() const {
+    if (compaction_) {
+        return (compacting_);
+    }
     return (process_ && process_->isRunning(pid_));
 }
 
 int
 LFCSetup::getExitStatus() const {
+    if (compaction_) {
+        return (exit_status_);
+    }
     if (!process_) {
         isc_throw(InvalidOperation, "unable to obtain LFC process exit code: "
                   " the process is null");
@@ -388,13 +505,13 @@ public:
             break;
 
         case SINGLE_SUBNET:
-            lower = idx.lower_bound(getFirstSubnetID());
-            upper = idx.upper_bound(getFirstSubnetID());
+            lower = idx.lower_bound(boost::make_tuple(getFirstSubnetID()));
+            upper = idx.upper_bound(boost::make_tuple(getFirstSubnetID()));
             break;
 
         case SUBNET_RANGE:
-            lower = idx.lower_bound(getFirstSubnetID());
-            upper = idx.upper_bound(getLastSubnetID());
+            lower = idx.lower_bound(boost::make_tuple(getFirstSubnetID()));
+            upper = idx.upper_bound(boost::make_tuple(getLastSubnetID()));
             break;
         }
 
@@ -637,7 +754,8 @@ const int Memfile_LeaseMgr::MAJOR_VERSION_V6;
 const int Memfile_LeaseMgr::MINOR_VERSION_V6;
 
 Memfile_LeaseMgr::Memfile_LeaseMgr(const DatabaseConnection::ParameterMap& parameters)
-    : TrackingLeaseMgr(), lfc_setup_(), conn_(parameters), mutex_(new std::mutex) {
+    : TrackingLeaseMgr(), lfc_stop_(false), lfc_setup_(), conn_(parameters),
+      mutex_(new ReadWriteMutex()) {
     bool conversion_needed = false;
 
     // Check if the extended info tables are enabled.
@@ -648,20 +766,45 @@ Memfile_LeaseMgr::Memfile_LeaseMgr(const DatabaseConnection::ParameterMap& param
     if (universe == "4") {
         std::string file4 = initLeaseFilePath(V4);
         if (!file4.empty()) {
-            conversion_needed = loadLeasesFromFiles<Lease4,
-                                                 CSVLeaseFile4>(file4,
-                                                                lease_file4_,
-                                                                storage4_);
+            if (useLeaseJournal()) {
+                conversion_needed = loadLeasesFromFiles<Lease4,
+                                                     LeaseJournal4>(file4,
+                                                                    journal4_,
+                                                                    storage4_);
+                journal4_->setSyncInterval(getFsyncRecords());
+            } else {
+                conversion_needed = loadLeasesFromFiles<Lease4,
+                                                     CSVLeaseFile4>(file4,
+                                                                    lease_file4_,
+                                                                    storage4_);
+            }
+            for (auto const& lease : storage4_) {
+                internIdentifiers(lease);
+            }
             static_cast<void>(extractExtendedInfo4(false, false));
         }
     } else {
         std::string file6 = initLeaseFilePath(V6);
         if (!file6.empty()) {
-            conversion_needed = loadLeasesFromFiles<Lease6,
-                                                 CSVLeaseFile6>(file6,
-                                                                lease_file6_,
-                                                                storage6_);
-            static_cast<void>(buildExtendedInfoTables6Internal(false, false));
+            if (useLeaseJournal()) {
+                conversion_needed = loadLeasesFromFiles<Lease6,
+                                                     LeaseJournal6>(file6,
+                                                                    journal6_,
+                                                                    storage6_);
+                journal6_->setSyncInterval(getFsyncRecords());
+            } else {
+                conversion_needed = loadLeasesFromFiles<Lease6,
+                                                     CSVLeaseFile6>(file6,
+                                                                    lease_file6_,
+                                                                    storage6_);
+            }
+            for (auto const& lease : storage6_) {
+                internIdentifiers(lease);
+            }
+            bool loaded = (getExtendedInfoTablesEnabled() &&
+                           loadExtendedInfoTables6(file6));
+            static_cast<void>(buildExtendedInfoTables6Internal(false, false,
+                                                               !loaded));
         }
     }
 
@@ -672,6 +815,22 @@ Memfile_LeaseMgr::Memfile_LeaseMgr(const DatabaseConnection::ParameterMap& param
     if (!persistLeases(V4) && !persistLeases(V6)) {
         LOG_WARN(dhcpsrv_logger, DHCPSRV_MEMFILE_NO_STORAGE);
     } else  {
+        if (useWriteBehind()) {
+            // The journal is synchronized after each batch instead.
+            uint32_t fsync_records = getFsyncRecords();
+            if (journal4_) {
+                journal4_->setSyncInterval(0);
+            }
+            if (journal6_) {
+                journal6_->setSyncInterval(0);
+            }
+            uint32_t queue_size = getWriteBehindQueueSize();
+            write_queue_.reset(new LeaseWriteQueue(queue_size, fsync_records,
+                std::bind(&Memfile_LeaseMgr::flushLeaseFile, this,
+                          fsync_records > 0)));
+            LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_WRITE_BEHIND_ENABLED)
+                .arg(queue_size);
+        }
         if (conversion_needed) {
             auto const& version(getVersion());
             LOG_WARN(dhcpsrv_logger, DHCPSRV_MEMFILE_CONVERTING_LEASE_FILES)
@@ -679,17 +838,59 @@ Memfile_LeaseMgr::Memfile_LeaseMgr(const DatabaseConnection::ParameterMap& param
         }
         lfcSetup(conversion_needed);
     }
+
+    // Count the leases for the lease statistics in memory.
+    if (getInMemoryStats(parameters)) {
+        enableStatsCounter();
+    }
 }
 
 Memfile_LeaseMgr::~Memfile_LeaseMgr() {
+    // Stop the in-process lease file cleanup which uses the storage.
+    lfc_stop_ = true;
+    lfc_setup_.reset();
+
+    // Write the queued lease changes before closing the files.
+    if (write_queue_) {
+        write_queue_->stop();
+        write_queue_.reset();
+    }
+    std::string file4;
     if (lease_file4_) {
+        file4 = lease_file4_->getFilename();
         lease_file4_->close();
         lease_file4_.reset();
     }
+    std::string file6;
     if (lease_file6_) {
+        file6 = lease_file6_->getFilename();
         lease_file6_->close();
         lease_file6_.reset();
     }
+    try {
+        if (journal4_) {
+            file4 = journal4_->getFilename();
+            journal4_->close();
+            journal4_.reset();
+        }
+        if (journal6_) {
+            file6 = journal6_->getFilename();
+            journal6_->close();
+            journal6_.reset();
+        }
+    } catch (const std::exception&) {
+        // Don't throw from the destructor.
+    }
+
+    // Save the extended info tables now the lease file won't change.
+    if (!file6.empty() && getExtendedInfoTablesEnabled()) {
+        saveExtendedInfoTables6(file6);
+    }
+
+    // Save the lease snapshot for the same reason.
+    if (!file4.empty()) {
+        saveLeaseSnapshot4(file4);
+    }
 }
 
 std::string
@@ -704,6 +905,35 @@ Memfile_LeaseMgr::getDBVersion(Universe const& u) {
     return tmp.str();
 }
 
+void
+Memfile_LeaseMgr::internIdentifiers(const Lease4Ptr& lease) {
+    lease->hwaddr_ = hwaddr_pool_.intern(lease->hwaddr_);
+    lease->client_id_ = client_id_pool_.intern(lease->client_id_);
+}
+
+void
+Memfile_LeaseMgr::internIdentifiers(const Lease6Ptr& lease) {
+    lease->duid_ = duid_pool_.intern(lease->duid_);
+    lease->hwaddr_ = hwaddr_pool_.intern(lease->hwaddr_);
+}
+
+void
+Memfile_LeaseMgr::addExtendedInfo4(const Lease4Ptr& lease) {
+    if (!lease->relay_id_.empty() || !lease->remote_id_.empty()) {
+        static_cast<void>(extended_info4_.insert(lease));
+    }
+}
+
+void
+Memfile_LeaseMgr::deleteExtendedInfo4(const Lease4Ptr& lease) {
+    if (lease->relay_id_.empty() && lease->remote_id_.empty()) {
+        return;
+    }
+    Lease4ExtendedInfoRelayIdIndex& idx = extended_info4_.get<RelayIdIndexTag>();
+    auto range = idx.equal_range(boost::make_tuple(lease->relay_id_, lease->addr_));
+    static_cast<void>(idx.erase(range.first, range.second));
+}
+
 bool
 Memfile_LeaseMgr::addLeaseInternal(const Lease4Ptr& lease) {
     if (getLease4Internal(lease->addr_)) {
@@ -715,10 +945,12 @@ Memfile_LeaseMgr::addLeaseInternal(const Lease4Ptr& lease) {
     // not be inserted to the memory and the disk and in-memory data will
     // remain consistent.
     if (persistLeases(V4)) {
-        lease_file4_->append(*lease);
+        appendLease(*lease);
     }
 
+    internIdentifiers(lease);
     storage4_.insert(lease);
+    addExtendedInfo4(lease);
 
     // Update lease current expiration time (allows update between the creation
     // of the Lease up to the point of insertion in the database).
@@ -740,8 +972,8 @@ Memfile_LeaseMgr::addLease(const Lease4Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_ADD_ADDR4).arg(lease->addr_.toText());
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        WriteLockGuard write_lock(*mutex_);
         return (addLeaseInternal(lease));
     } else {
         return (addLeaseInternal(lease));
@@ -759,10 +991,11 @@ Memfile_LeaseMgr::addLeaseInternal(const Lease6Ptr& lease) {
     // not be inserted to the memory and the disk and in-memory data will
     // remain consistent.
     if (persistLeases(V6)) {
-        lease_file6_->append(*lease);
+        appendLease(*lease);
     }
 
     lease->extended_info_action_ = Lease6::ACTION_IGNORE;
+    internIdentifiers(lease);
     storage6_.insert(lease);
 
     // Update lease current expiration time (allows update between the creation
@@ -789,8 +1022,8 @@ Memfile_LeaseMgr::addLease(const Lease6Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_ADD_ADDR6).arg(lease->addr_.toText());
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        WriteLockGuard write_lock(*mutex_);
         return (addLeaseInternal(lease));
     } else {
         return (addLeaseInternal(lease));
@@ -813,8 +1046,8 @@ Memfile_LeaseMgr::getLease4(const isc::asiolink::IOAddress& addr) const {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_GET_ADDR4).arg(addr.toText());
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         return (getLease4Internal(addr));
     } else {
         return (getLease4Internal(addr));
@@ -843,8 +1076,8 @@ Memfile_LeaseMgr::getLease4(const HWAddr& hwaddr) const {
               DHCPSRV_MEMFILE_GET_HWADDR).arg(hwaddr.toText());
 
     Lease4Collection collection;
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getLease4Internal(hwaddr, collection);
     } else {
         getLease4Internal(hwaddr, collection);
@@ -878,8 +1111,8 @@ Memfile_LeaseMgr::getLease4(const HWAddr& hwaddr,
               DHCPSRV_MEMFILE_GET_SUBID_HWADDR).arg(subnet_id)
         .arg(hwaddr.toText());
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         return (getLease4Internal(hwaddr, subnet_id));
     } else {
         return (getLease4Internal(hwaddr, subnet_id));
@@ -908,8 +1141,8 @@ Memfile_LeaseMgr::getLease4(const ClientId& client_id) const {
               DHCPSRV_MEMFILE_GET_CLIENTID).arg(client_id.toText());
 
     Lease4Collection collection;
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getLease4Internal(client_id, collection);
     } else {
         getLease4Internal(client_id, collection);
@@ -942,8 +1175,8 @@ Memfile_LeaseMgr::getLease4(const ClientId& client_id,
               DHCPSRV_MEMFILE_GET_SUBID_CLIENTID).arg(subnet_id)
               .arg(client_id.toText());
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         return (getLease4Internal(client_id, subnet_id));
     } else {
         return (getLease4Internal(client_id, subnet_id));
@@ -956,7 +1189,7 @@ Memfile_LeaseMgr::getLeases4Internal(SubnetID subnet_id,
     const Lease4StorageSubnetIdIndex& idx = storage4_.get<SubnetIdIndexTag>();
     std::pair<Lease4StorageSubnetIdIndex::const_iterator,
               Lease4StorageSubnetIdIndex::const_iterator> l =
-        idx.equal_range(subnet_id);
+        idx.equal_range(boost::make_tuple(subnet_id));
 
     for (auto lease = l.first; lease != l.second; ++lease) {
         collection.push_back(Lease4Ptr(new Lease4(**lease)));
@@ -969,8 +1202,8 @@ Memfile_LeaseMgr::getLeases4(SubnetID subnet_id) const {
         .arg(subnet_id);
 
     Lease4Collection collection;
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getLeases4Internal(subnet_id, collection);
     } else {
         getLeases4Internal(subnet_id, collection);
@@ -979,6 +1212,79 @@ Memfile_LeaseMgr::getLeases4(SubnetID subnet_id) const {
     return (collection);
 }
 
+size_t
+Memfile_LeaseMgr::getLeaseMemoryUsage4Internal(SubnetID subnet_id) const {
+    const Lease4StorageSubnetIdIndex& idx = storage4_.get<SubnetIdIndexTag>();
+    std::pair<Lease4StorageSubnetIdIndex::const_iterator,
+              Lease4StorageSubnetIdIndex::const_iterator> l =
+        idx.equal_range(boost::make_tuple(subnet_id));
+
+    // The node holds the shared pointer, the lease is allocated with
+    // its reference counts.
+    const size_t fixed = sizeof(Lease4Storage::node_type) + sizeof(Lease4) +
+                         2 * sizeof(long);
+    size_t usage = 0;
+    for (auto lease = l.first; lease != l.second; ++lease) {
+        usage += fixed;
+        if ((*lease)->hwaddr_) {
+            usage += sizeof(HWAddr) + (*lease)->hwaddr_->hwaddr_.capacity();
+        }
+        if ((*lease)->client_id_) {
+            usage += sizeof(ClientId) + (*lease)->client_id_->getClientId().capacity();
+        }
+        if ((*lease)->hostname_.capacity() > std::string().capacity()) {
+            usage += (*lease)->hostname_.capacity() + 1;
+        }
+    }
+    return (usage);
+}
+
+size_t
+Memfile_LeaseMgr::getLeaseMemoryUsage4(SubnetID subnet_id) const {
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
+        return (getLeaseMemoryUsage4Internal(subnet_id));
+    } else {
+        return (getLeaseMemoryUsage4Internal(subnet_id));
+    }
+}
+
+void
+Memfile_LeaseMgr::getLeasedAddressesInternal(SubnetID subnet_id, Lease::Type type,
+                                             std::unordered_set<IOAddress,
+                                                                IOAddress::Hash>& addresses) const {
+    if (type == Lease::TYPE_V4) {
+        const Lease4StorageSubnetIdIndex& idx = storage4_.get<SubnetIdIndexTag>();
+        auto l = idx.equal_range(boost::make_tuple(subnet_id));
+        for (auto lease = l.first; lease != l.second; ++lease) {
+            if (!(*lease)->expired() && !(*lease)->stateExpiredReclaimed()) {
+                addresses.insert((*lease)->addr_);
+            }
+        }
+        return;
+    }
+    const Lease6StorageSubnetIdIndex& idx = storage6_.get<SubnetIdIndexTag>();
+    auto l = idx.equal_range(subnet_id);
+    for (auto lease = l.first; lease != l.second; ++lease) {
+        if (((*lease)->type_ == type) && !(*lease)->expired() &&
+            !(*lease)->stateExpiredReclaimed()) {
+            addresses.insert((*lease)->addr_);
+        }
+    }
+}
+
+void
+Memfile_LeaseMgr::getLeasedAddresses(SubnetID subnet_id, Lease::Type type,
+                                     std::unordered_set<IOAddress,
+                                                        IOAddress::Hash>& addresses) const {
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
+        getLeasedAddressesInternal(subnet_id, type, addresses);
+    } else {
+        getLeasedAddressesInternal(subnet_id, type, addresses);
+    }
+}
+
 void
 Memfile_LeaseMgr::getLeases4Internal(const std::string& hostname,
                                      Lease4Collection& collection) const {
@@ -998,8 +1304,8 @@ Memfile_LeaseMgr::getLeases4(const std::string& hostname) const {
         .arg(hostname);
 
     Lease4Collection collection;
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getLeases4Internal(hostname, collection);
     } else {
         getLeases4Internal(hostname, collection);
@@ -1020,8 +1326,8 @@ Memfile_LeaseMgr::getLeases4() const {
    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MEMFILE_GET4);
 
    Lease4Collection collection;
-   if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+   if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getLeases4Internal(collection);
    } else {
         getLeases4Internal(collection);
@@ -1044,7 +1350,7 @@ Memfile_LeaseMgr::getLeases4Internal(const asiolink::IOAddress& lower_bound_addr
 
     // Return all other leases being within the page size.
     for (auto lease = lb;
-         (lease != idx.end()) && (std::distance(lb, lease) < page_size.page_size_);
+         (lease != idx.end()) && (collection.size() < page_size.page_size_);
          ++lease) {
         collection.push_back(Lease4Ptr(new Lease4(**lease)));
     }
@@ -1065,8 +1371,8 @@ Memfile_LeaseMgr::getLeases4(const asiolink::IOAddress& lower_bound_address,
         .arg(lower_bound_address.toText());
 
     Lease4Collection collection;
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getLeases4Internal(lower_bound_address, page_size, collection);
     } else {
         getLeases4Internal(lower_bound_address, page_size, collection);
@@ -1075,6 +1381,65 @@ Memfile_LeaseMgr::getLeases4(const asiolink::IOAddress& lower_bound_address,
     return (collection);
 }
 
+void
+Memfile_LeaseMgr::getFilteredLeases4Internal(const LeasePageFilter& filter,
+                                             const asiolink::IOAddress& lower_bound_address,
+                                             const LeasePageSize& page_size,
+                                             Lease4Collection& collection) const {
+    if (filter.subnet_id_ != 0) {
+        // The leases of the subnet are sorted by address in the subnet
+        // index so the page starts right after the lower bound.
+        const Lease4StorageSubnetIdIndex& idx = storage4_.get<SubnetIdIndexTag>();
+        auto lease = idx.upper_bound(boost::make_tuple(filter.subnet_id_,
+                                                       lower_bound_address));
+        auto end = idx.upper_bound(boost::make_tuple(filter.subnet_id_));
+        for (; (lease != end) && (collection.size() < page_size.page_size_);
+             ++lease) {
+            if (filter.matches(**lease)) {
+                collection.push_back(Lease4Ptr(new Lease4(**lease)));
+            }
+        }
+        return;
+    }
+
+    const Lease4StorageAddressIndex& idx = storage4_.get<AddressIndexTag>();
+    auto lease = idx.upper_bound(lower_bound_address);
+    for (; (lease != idx.end()) && (collection.size() < page_size.page_size_);
+         ++lease) {
+        if (filter.matches(**lease)) {
+            collection.push_back(Lease4Ptr(new Lease4(**lease)));
+        }
+    }
+}
+
+Lease4Collection
+Memfile_LeaseMgr::getFilteredLeases4(const LeasePageFilter& filter,
+                                     const asiolink::IOAddress& lower_bound_address,
+                                     const LeasePageSize& page_size) const {
+    // Expecting IPv4 address.
+    if (!lower_bound_address.isV4()) {
+        isc_throw(InvalidAddressFamily, "expected IPv4 address while "
+                  "retrieving leases from the lease database, got "
+                  << lower_bound_address);
+    }
+
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MEMFILE_GET_PAGE4)
+        .arg(page_size.page_size_)
+        .arg(lower_bound_address.toText());
+
+    Lease4Collection collection;
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
+        getFilteredLeases4Internal(filter, lower_bound_address, page_size,
+                                   collection);
+    } else {
+        getFilteredLeases4Internal(filter, lower_bound_address, page_size,
+                                   collection);
+    }
+
+    return (collection);
+}
+
 Lease6Ptr
 Memfile_LeaseMgr::getLease6Internal(Lease::Type type,
                                     const isc::asiolink::IOAddress& addr) const {
@@ -1104,14 +1469,45 @@ Memfile_LeaseMgr::getLease6(Lease::Type type,
         .arg(addr.toText())
         .arg(Lease::typeToText(type));
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         return (getLease6Internal(type, addr));
     } else {
         return (getLease6Internal(type, addr));
     }
 }
 
+void
+Memfile_LeaseMgr::getLeases6ByAddressesInternal(Lease::Type type,
+                                                const std::vector<IOAddress>& addresses,
+                                                Lease6Collection& collection) const {
+    for (auto const& address : addresses) {
+        Lease6Ptr lease = getLease6Internal(type, address);
+        if (lease) {
+            collection.push_back(lease);
+        }
+    }
+}
+
+Lease6Collection
+Memfile_LeaseMgr::getLeases6ByAddresses(Lease::Type type,
+                                        const std::vector<IOAddress>& addresses) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+              DHCPSRV_MEMFILE_GET_ADDRESSES6)
+        .arg(addresses.size())
+        .arg(Lease::typeToText(type));
+
+    Lease6Collection collection;
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
+        getLeases6ByAddressesInternal(type, addresses, collection);
+    } else {
+        getLeases6ByAddressesInternal(type, addresses, collection);
+    }
+
+    return (collection);
+}
+
 void
 Memfile_LeaseMgr::getLeases6Internal(Lease::Type type,
                                      const DUID& duid,
@@ -1141,8 +1537,8 @@ Memfile_LeaseMgr::getLeases6(Lease::Type type,
         .arg(Lease::typeToText(type));
 
     Lease6Collection collection;
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getLeases6Internal(type, duid, iaid, collection);
     } else {
         getLeases6Internal(type, duid, iaid, collection);
@@ -1186,8 +1582,8 @@ Memfile_LeaseMgr::getLeases6(Lease::Type type,
         .arg(Lease::typeToText(type));
 
     Lease6Collection collection;
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getLeases6Internal(type, duid, iaid, subnet_id, collection);
     } else {
         getLeases6Internal(type, duid, iaid, subnet_id, collection);
@@ -1215,8 +1611,8 @@ Memfile_LeaseMgr::getLeases6(SubnetID subnet_id) const {
         .arg(subnet_id);
 
     Lease6Collection collection;
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getLeases6Internal(subnet_id, collection);
     } else {
         getLeases6Internal(subnet_id, collection);
@@ -1244,8 +1640,8 @@ Memfile_LeaseMgr::getLeases6(const std::string& hostname) const {
         .arg(hostname);
 
     Lease6Collection collection;
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getLeases6Internal(hostname, collection);
     } else {
         getLeases6Internal(hostname, collection);
@@ -1266,8 +1662,8 @@ Memfile_LeaseMgr::getLeases6() const {
    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MEMFILE_GET6);
 
    Lease6Collection collection;
-   if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+   if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getLeases6Internal(collection);
    } else {
         getLeases6Internal(collection);
@@ -1295,8 +1691,8 @@ Memfile_LeaseMgr::getLeases6(const DUID& duid) const {
        .arg(duid.toText());
 
     Lease6Collection collection;
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getLeases6Internal(duid, collection);
     } else {
         getLeases6Internal(duid, collection);
@@ -1319,7 +1715,7 @@ Memfile_LeaseMgr::getLeases6Internal(const asiolink::IOAddress& lower_bound_addr
 
     // Return all other leases being within the page size.
     for (auto lease = lb;
-         (lease != idx.end()) && (std::distance(lb, lease) < page_size.page_size_);
+         (lease != idx.end()) && (collection.size() < page_size.page_size_);
          ++lease) {
         collection.push_back(Lease6Ptr(new Lease6(**lease)));
     }
@@ -1340,8 +1736,8 @@ Memfile_LeaseMgr::getLeases6(const asiolink::IOAddress& lower_bound_address,
         .arg(lower_bound_address.toText());
 
     Lease6Collection collection;
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getLeases6Internal(lower_bound_address, page_size, collection);
     } else {
         getLeases6Internal(lower_bound_address, page_size, collection);
@@ -1350,25 +1746,119 @@ Memfile_LeaseMgr::getLeases6(const asiolink::IOAddress& lower_bound_address,
     return (collection);
 }
 
+namespace {
+
+/// @brief Collects the DHCPv4 leases of a bucket of the expiration timing
+/// wheel.
+///
+/// The non-empty buckets of the level below are walked in order so the
+/// leases are collected from the most expired to the least expired
+/// bucket. The walk stops after a level 0 bucket once enough leases were
+/// collected.
+///
+/// @tparam Level The level of the bucket.
+/// @param storage The DHCPv4 lease storage.
+/// @param reclaimed Collect the reclaimed or not reclaimed leases.
+/// @param bucket The bucket.
+/// @param limit Collect the leases which expired at or before this time.
+/// @param max_leases The number of leases to collect, 0 for all.
+/// @param [out] leases The collected leases.
+template<unsigned Level>
 void
-Memfile_LeaseMgr::getExpiredLeases4Internal(Lease4Collection& expired_leases,
-                                            const size_t max_leases) const {
-    // Obtain the index which segragates leases by state and time.
-    const Lease4StorageExpirationIndex& index = storage4_.get<ExpirationIndexTag>();
+collectExpiredLeases4(const Lease4Storage& storage, bool reclaimed,
+                      int64_t bucket, int64_t limit, size_t max_leases,
+                      std::vector<Lease4Ptr>& leases) {
+    const Lease4StorageExpirationWheelIndex<Level - 1>& index =
+        storage.get<ExpirationWheelIndexTag<Level - 1> >();
+    const int64_t first = bucket << ExpirationWheel::SHIFT;
+    const int64_t last = std::min(first + (1 << ExpirationWheel::SHIFT) - 1,
+                                  ExpirationWheel::getBucket(limit, Level - 1));
+    for (int64_t child = first; child <= last; ++child) {
+        if (index.find(boost::make_tuple(reclaimed, child)) == index.end()) {
+            continue;
+        }
+        collectExpiredLeases4<Level - 1>(storage, reclaimed, child, limit,
+                                         max_leases, leases);
+        if ((max_leases > 0) && (leases.size() >= max_leases)) {
+            return;
+        }
+    }
+}
 
-    // Retrieve leases which are not reclaimed and which haven't expired. The
-    // 'less-than' operator will be used for both components of the index. So,
-    // for the 'state' 'false' is less than 'true'. Also the leases with
-    // expiration time lower than current time will be returned.
-    Lease4StorageExpirationIndex::const_iterator ub =
-        index.upper_bound(boost::make_tuple(false, time(0)));
+/// @brief Collects the DHCPv4 leases of a level 0 bucket of the expiration
+/// timing wheel.
+template<>
+void
+collectExpiredLeases4<0>(const Lease4Storage& storage, bool reclaimed,
+                         int64_t bucket, int64_t limit, size_t,
+                         std::vector<Lease4Ptr>& leases) {
+    const Lease4StorageExpirationWheelIndex<0>& index =
+        storage.get<ExpirationWheelIndexTag<0> >();
+    auto range = index.equal_range(boost::make_tuple(reclaimed, bucket));
+    for (auto lease = range.first; lease != range.second; ++lease) {
+        // The last bucket holds leases which have not expired yet.
+        if ((*lease)->getExpirationTime() <= limit) {
+            leases.push_back(*lease);
+        }
+    }
+}
 
-    // Copy only the number of leases indicated by the max_leases parameter.
-    for (Lease4StorageExpirationIndex::const_iterator lease = index.begin();
-         (lease != ub) && ((max_leases == 0) || (std::distance(index.begin(), lease) <
-                                                 max_leases));
-         ++lease) {
-        expired_leases.push_back(Lease4Ptr(new Lease4(**lease)));
+/// @brief Collects the expired DHCPv4 leases from the expiration timing
+/// wheel.
+///
+/// @param storage The DHCPv4 lease storage.
+/// @param reclaimed Collect the reclaimed or not reclaimed leases.
+/// @param limit Collect the leases which expired at or before this time.
+/// @param max_leases The number of leases to collect, 0 for all.
+/// @return The collected leases sorted from the most expired to the
+/// least expired.
+std::vector<Lease4Ptr>
+getExpiredLeases4FromWheel(const Lease4Storage& storage, bool reclaimed,
+                           int64_t limit, size_t max_leases) {
+    std::vector<Lease4Ptr> leases;
+    const unsigned top = ExpirationWheel::TOP_LEVEL;
+    const Lease4StorageExpirationWheelIndex<top>& index =
+        storage.get<ExpirationWheelIndexTag<top> >();
+    // The top level buckets are walked from the epoch.
+    const int64_t last = ExpirationWheel::getBucket(limit, top);
+    for (int64_t bucket = 0; bucket <= last; ++bucket) {
+        if (index.find(boost::make_tuple(reclaimed, bucket)) == index.end()) {
+            continue;
+        }
+        collectExpiredLeases4<top>(storage, reclaimed, bucket, limit,
+                                   max_leases, leases);
+        if ((max_leases > 0) && (leases.size() >= max_leases)) {
+            break;
+        }
+    }
+
+    // The leases of a bucket are not ordered.
+    std::sort(leases.begin(), leases.end(),
+              [](const Lease4Ptr& first, const Lease4Ptr& second) {
+        const int64_t first_expire = first->getExpirationTime();
+        const int64_t second_expire = second->getExpirationTime();
+        if (first_expire != second_expire) {
+            return (first_expire < second_expire);
+        }
+        return (first->addr_ < second->addr_);
+    });
+    if ((max_leases > 0) && (leases.size() > max_leases)) {
+        leases.resize(max_leases);
+    }
+    return (leases);
+}
+
+}  // namespace
+
+void
+Memfile_LeaseMgr::getExpiredLeases4Internal(Lease4Collection& expired_leases,
+                                            const size_t max_leases) const {
+    // Walk the expiration timing wheel for the leases which are not
+    // reclaimed and which have expired.
+    auto leases = getExpiredLeases4FromWheel(storage4_, false, time(0),
+                                             max_leases);
+    for (auto const& lease : leases) {
+        expired_leases.push_back(Lease4Ptr(new Lease4(*lease)));
     }
 }
 
@@ -1378,8 +1868,8 @@ Memfile_LeaseMgr::getExpiredLeases4(Lease4Collection& expired_leases,
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MEMFILE_GET_EXPIRED4)
         .arg(max_leases);
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getExpiredLeases4Internal(expired_leases, max_leases);
     } else {
         getExpiredLeases4Internal(expired_leases, max_leases);
@@ -1414,8 +1904,8 @@ Memfile_LeaseMgr::getExpiredLeases6(Lease6Collection& expired_leases,
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MEMFILE_GET_EXPIRED6)
         .arg(max_leases);
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         getExpiredLeases6Internal(expired_leases, max_leases);
     } else {
         getExpiredLeases6Internal(expired_leases, max_leases);
@@ -1446,7 +1936,7 @@ Memfile_LeaseMgr::updateLease4Internal(const Lease4Ptr& lease) {
     // not be inserted to the memory and the disk and in-memory data will
     // remain consistent.
     if (persist) {
-        lease_file4_->append(*lease);
+        appendLease(*lease);
     }
 
     // Update lease current expiration time.
@@ -1457,7 +1947,11 @@ Memfile_LeaseMgr::updateLease4Internal(const Lease4Ptr& lease) {
     Lease4Ptr old_lease = *lease_it;
 
     // Use replace() to re-index leases.
-    index.replace(lease_it, Lease4Ptr(new Lease4(*lease)));
+    Lease4Ptr new_lease(new Lease4(*lease));
+    internIdentifiers(new_lease);
+    index.replace(lease_it, new_lease);
+    deleteExtendedInfo4(old_lease);
+    addExtendedInfo4(new_lease);
 
     // Adjust class lease counters.
     class_lease_counter_.updateLease(lease, old_lease);
@@ -1473,8 +1967,8 @@ Memfile_LeaseMgr::updateLease4(const Lease4Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_UPDATE_ADDR4).arg(lease->addr_.toText());
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        WriteLockGuard write_lock(*mutex_);
         updateLease4Internal(lease);
     } else {
         updateLease4Internal(lease);
@@ -1509,7 +2003,7 @@ Memfile_LeaseMgr::updateLease6Internal(const Lease6Ptr& lease) {
     // not be inserted to the memory and the disk and in-memory data will
     // remain consistent.
     if (persist) {
-        lease_file6_->append(*lease);
+        appendLease(*lease);
     }
 
     // Update lease current expiration time.
@@ -1520,7 +2014,9 @@ Memfile_LeaseMgr::updateLease6Internal(const Lease6Ptr& lease) {
     Lease6Ptr old_lease = *lease_it;
 
     // Use replace() to re-index leases.
-    index.replace(lease_it, Lease6Ptr(new Lease6(*lease)));
+    Lease6Ptr new_lease(new Lease6(*lease));
+    internIdentifiers(new_lease);
+    index.replace(lease_it, new_lease);
 
     // Adjust class lease counters.
     class_lease_counter_.updateLease(lease, old_lease);
@@ -1553,8 +2049,8 @@ Memfile_LeaseMgr::updateLease6(const Lease6Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_UPDATE_ADDR6).arg(lease->addr_.toText());
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        WriteLockGuard write_lock(*mutex_);
         updateLease6Internal(lease);
     } else {
         updateLease6Internal(lease);
@@ -1576,7 +2072,7 @@ Memfile_LeaseMgr::deleteLeaseInternal(const Lease4Ptr& lease) {
             // Setting valid lifetime to 0 means that lease is being
             // removed.
             lease_copy.valid_lft_ = 0;
-            lease_file4_->append(lease_copy);
+            appendLease(lease_copy);
         } else {
             // For test purpose only: check that the lease has not changed in
             // the database.
@@ -1586,6 +2082,7 @@ Memfile_LeaseMgr::deleteLeaseInternal(const Lease4Ptr& lease) {
             }
         }
 
+        deleteExtendedInfo4(*l);
         storage4_.erase(l);
 
         // Decrement class lease counters.
@@ -1605,8 +2102,8 @@ Memfile_LeaseMgr::deleteLease(const Lease4Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_DELETE_ADDR).arg(lease->addr_.toText());
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        WriteLockGuard write_lock(*mutex_);
         return (deleteLeaseInternal(lease));
     } else {
         return (deleteLeaseInternal(lease));
@@ -1630,7 +2127,7 @@ Memfile_LeaseMgr::deleteLeaseInternal(const Lease6Ptr& lease) {
             // Setting lifetimes to 0 means that lease is being removed.
             lease_copy.valid_lft_ = 0;
             lease_copy.preferred_lft_ = 0;
-            lease_file6_->append(lease_copy);
+            appendLease(lease_copy);
         } else {
             // For test purpose only: check that the lease has not changed in
             // the database.
@@ -1664,8 +2161,8 @@ Memfile_LeaseMgr::deleteLease(const Lease6Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_DELETE_ADDR).arg(lease->addr_.toText());
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        WriteLockGuard write_lock(*mutex_);
         return (deleteLeaseInternal(lease));
     } else {
         return (deleteLeaseInternal(lease));
@@ -1678,16 +2175,51 @@ Memfile_LeaseMgr::deleteExpiredReclaimedLeases4(const uint32_t secs) {
               DHCPSRV_MEMFILE_DELETE_EXPIRED_RECLAIMED4)
         .arg(secs);
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
-        return (deleteExpiredReclaimedLeases<
-                Lease4StorageExpirationIndex, Lease4
-                >(secs, V4, storage4_, lease_file4_));
+    if (lockNeeded()) {
+        WriteLockGuard write_lock(*mutex_);
+        return (deleteExpiredReclaimedLeases4Internal(secs));
     } else {
-        return (deleteExpiredReclaimedLeases<
-                Lease4StorageExpirationIndex, Lease4
-                >(secs, V4, storage4_, lease_file4_));
+        return (deleteExpiredReclaimedLeases4Internal(secs));
+    }
+}
+
+uint64_t
+Memfile_LeaseMgr::deleteExpiredReclaimedLeases4Internal(const uint32_t secs) {
+    // Walk the expiration timing wheel for the reclaimed leases which
+    // expired more than secs seconds ago.
+    const int64_t expire_limit = time(0) - secs;
+    auto leases = getExpiredLeases4FromWheel(storage4_, true, expire_limit, 0);
+
+    uint64_t num_leases = static_cast<uint64_t>(leases.size());
+    if (num_leases > 0) {
+
+        LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+                  DHCPSRV_MEMFILE_DELETE_EXPIRED_RECLAIMED_START)
+            .arg(num_leases);
+
+        bool persist = persistLeases(V4);
+        Lease4StorageAddressIndex& index = storage4_.get<AddressIndexTag>();
+        for (auto const& lease : leases) {
+            // If lease persistence is enabled, we also have to mark leases
+            // as deleted in the lease file. We do this by setting the
+            // lifetime to 0.
+            if (persist) {
+                // Copy lease to not affect the lease in the container.
+                Lease4 lease_copy(*lease);
+                lease_copy.valid_lft_ = 0;
+                appendLease(lease_copy);
+            }
+
+            // Erase the lease from memory.
+            deleteExtendedInfo4(lease);
+            index.erase(lease->addr_);
+        }
+
+        // The deleted leases expired at or before the limit.
+        trackDeleteExpiredReclaimedLeases(AF_INET, expire_limit + 1);
     }
+    // Return number of leases deleted.
+    return (num_leases);
 }
 
 uint64_t
@@ -1696,25 +2228,23 @@ Memfile_LeaseMgr::deleteExpiredReclaimedLeases6(const uint32_t secs) {
               DHCPSRV_MEMFILE_DELETE_EXPIRED_RECLAIMED6)
         .arg(secs);
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        WriteLockGuard write_lock(*mutex_);
         return (deleteExpiredReclaimedLeases<
                 Lease6StorageExpirationIndex, Lease6
-                >(secs, V6, storage6_, lease_file6_));
+                >(secs, V6, storage6_));
     } else {
         return (deleteExpiredReclaimedLeases<
                 Lease6StorageExpirationIndex, Lease6
-                >(secs, V6, storage6_, lease_file6_));
+                >(secs, V6, storage6_));
     }
 }
 
-template<typename IndexType, typename LeaseType, typename StorageType,
-         typename LeaseFileType>
+template<typename IndexType, typename LeaseType, typename StorageType>
 uint64_t
 Memfile_LeaseMgr::deleteExpiredReclaimedLeases(const uint32_t secs,
                                                const Universe& universe,
-                                               StorageType& storage,
-                                               LeaseFileType& lease_file) {
+                                               StorageType& storage) {
     // Obtain the index which segragates leases by state and time.
     IndexType& index = storage.template get<ExpirationIndexTag>();
 
@@ -1727,8 +2257,9 @@ Memfile_LeaseMgr::deleteExpiredReclaimedLeases(const uint32_t secs,
     // first value is true, represent the reclaimed leases which should
     // be deleted, because their expiration time + secs has occurred earlier
     // than current time.
+    const int64_t expire_limit = time(0) - secs;
     typename IndexType::const_iterator upper_limit =
-        index.upper_bound(boost::make_tuple(true, time(0) - secs));
+        index.upper_bound(boost::make_tuple(true, expire_limit));
 
     // Now, we have to exclude all elements of the index which represent
     // leases in the state other than reclaimed - with the first value
@@ -1759,7 +2290,7 @@ Memfile_LeaseMgr::deleteExpiredReclaimedLeases(const uint32_t secs,
                 // Set the valid lifetime to 0 to indicate the removal
                 // of the lease.
                 lease_copy.valid_lft_ = 0;
-                lease_file->append(lease_copy);
+                appendLease(lease_copy);
             }
         }
 
@@ -1777,6 +2308,10 @@ Memfile_LeaseMgr::deleteExpiredReclaimedLeases(const uint32_t secs,
         // Erase leases from memory.
         index.erase(lower_limit, upper_limit);
 
+        // The deleted leases expired at or before the limit.
+        trackDeleteExpiredReclaimedLeases(universe == V4 ? AF_INET : AF_INET6,
+                                          expire_limit + 1);
+
     }
     // Return number of leases deleted.
     return (num_leases);
@@ -1787,6 +2322,24 @@ Memfile_LeaseMgr::getDescription() const {
     return (std::string("In memory database with leases stored in a CSV file."));
 }
 
+ElementPtr
+Memfile_LeaseMgr::getMemoryStats() const {
+    size_t leases4;
+    size_t leases6;
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
+        leases4 = storage4_.size();
+        leases6 = storage6_.size();
+    } else {
+        leases4 = storage4_.size();
+        leases6 = storage6_.size();
+    }
+    ElementPtr stats = Element::createMap();
+    stats->set("leases4", Element::create(static_cast<int64_t>(leases4)));
+    stats->set("leases6", Element::create(static_cast<int64_t>(leases6)));
+    return (stats);
+}
+
 std::pair<uint32_t, uint32_t>
 Memfile_LeaseMgr::getVersion() const {
     std::string const& universe(conn_.getParameter("universe"));
@@ -1829,6 +2382,12 @@ Memfile_LeaseMgr::appendSuffix(const std::string& file_name,
     case FILE_PID:
         name += ".pid";
         break;
+    case FILE_EXTENDED_INFO:
+        name += ".xinfo";
+        break;
+    case FILE_SNAPSHOT:
+        name += ".snapshot";
+        break;
     default:
         // Do not append any suffix for the FILE_CURRENT.
         ;
@@ -1849,9 +2408,15 @@ Memfile_LeaseMgr::getDefaultLeaseFilePath(Universe u) const {
 std::string
 Memfile_LeaseMgr::getLeaseFilePath(Universe u) const {
     if (u == V4) {
+        if (journal4_) {
+            return (journal4_->getFilename());
+        }
         return (lease_file4_ ? lease_file4_->getFilename() : "");
     }
 
+    if (journal6_) {
+        return (journal6_->getFilename());
+    }
     return (lease_file6_ ? lease_file6_->getFilename() : "");
 }
 
@@ -1860,31 +2425,240 @@ Memfile_LeaseMgr::persistLeases(Universe u) const {
     // Currently, if the lease file IO is not created, it means that writes to
     // disk have been explicitly disabled by the administrator. At some point,
     // there may be a dedicated ON/OFF flag implemented to control this.
-    if (u == V4 && lease_file4_) {
+    if (u == V4 && (lease_file4_ || journal4_)) {
         return (true);
     }
 
-    return (u == V6 && lease_file6_);
+    return (u == V6 && (lease_file6_ || journal6_));
 }
 
-std::string
-Memfile_LeaseMgr::initLeaseFilePath(Universe u) {
-    std::string persist_val;
-    try {
-        persist_val = conn_.getParameter("persist");
-    } catch (const Exception&) {
-        // If parameter persist hasn't been specified, we use a default value
-        // 'yes'.
-        persist_val = "true";
+void
+Memfile_LeaseMgr::appendLease(const Lease4& lease) {
+    if (write_queue_ && MultiThreadingMgr::instance().getMode()) {
+        Lease4Ptr lease_copy(new Lease4(lease));
+        last_write.sequence_ = write_queue_->push([this, lease_copy]() {
+            writeLease(*lease_copy);
+        });
+        last_write.queue_ = write_queue_.get();
+        return;
     }
-    // If persist_val is 'false' we will not store leases to disk, so let's
-    // return empty file name.
-    if (persist_val == "false") {
-        return ("");
+    // Keep the order of the lease changes.
+    drainWriteQueue();
+    writeLease(lease);
+}
 
-    } else if (persist_val != "true") {
-        isc_throw(isc::BadValue, "invalid value 'persist="
-                  << persist_val << "'");
+void
+Memfile_LeaseMgr::appendLease(const Lease6& lease) {
+    if (write_queue_ && MultiThreadingMgr::instance().getMode()) {
+        Lease6Ptr lease_copy(new Lease6(lease));
+        last_write.sequence_ = write_queue_->push([this, lease_copy]() {
+            writeLease(*lease_copy);
+        });
+        last_write.queue_ = write_queue_.get();
+        return;
+    }
+    // Keep the order of the lease changes.
+    drainWriteQueue();
+    writeLease(lease);
+}
+
+void
+Memfile_LeaseMgr::writeLease(const Lease4& lease) {
+    if (journal4_) {
+        journal4_->append(lease);
+    } else {
+        lease_file4_->append(lease);
+    }
+}
+
+void
+Memfile_LeaseMgr::writeLease(const Lease6& lease) {
+    if (journal6_) {
+        journal6_->append(lease);
+    } else {
+        lease_file6_->append(lease);
+    }
+}
+
+void
+Memfile_LeaseMgr::flushLeaseFile(const bool sync) {
+    if (lease_file4_) {
+        lease_file4_->flush();
+    }
+    if (lease_file6_) {
+        lease_file6_->flush();
+    }
+    if (sync && journal4_) {
+        journal4_->flush();
+    }
+    if (sync && journal6_) {
+        journal6_->flush();
+    }
+}
+
+void
+Memfile_LeaseMgr::drainWriteQueue() {
+    if (write_queue_) {
+        write_queue_->drain();
+    }
+}
+
+bool
+Memfile_LeaseMgr::whenLeasesDurable(const DurableCallback& callback) {
+    if (!write_queue_ || (last_write.queue_ != write_queue_.get()) ||
+        !MultiThreadingMgr::instance().getMode()) {
+        return (false);
+    }
+    return (write_queue_->whenDurable(last_write.sequence_, callback));
+}
+
+bool
+Memfile_LeaseMgr::useWriteBehind() const {
+    std::string write_behind = "false";
+    try {
+        write_behind = conn_.getParameter("write-behind");
+    } catch (const std::exception&) {
+        // Ignore and default to false.
+    }
+
+    if (write_behind == "true") {
+        return (true);
+    } else if (write_behind != "false") {
+        isc_throw(isc::BadValue, "invalid value of the write-behind "
+                  << write_behind << " specified");
+    }
+    return (false);
+}
+
+bool
+Memfile_LeaseMgr::useLeaseSnapshot() const {
+    std::string lease_snapshot = "false";
+    try {
+        lease_snapshot = conn_.getParameter("lease-snapshot");
+    } catch (const std::exception&) {
+        // Ignore and default to false.
+    }
+
+    if (lease_snapshot == "true") {
+        return (true);
+    } else if (lease_snapshot != "false") {
+        isc_throw(isc::BadValue, "invalid value of the lease-snapshot "
+                  << lease_snapshot << " specified");
+    }
+    return (false);
+}
+
+uint32_t
+Memfile_LeaseMgr::getWriteBehindQueueSize() const {
+    std::string queue_size_str =
+        boost::lexical_cast<std::string>(DEFAULT_WRITE_BEHIND_QUEUE_SIZE);
+    try {
+        queue_size_str = conn_.getParameter("write-behind-queue-size");
+    } catch (const std::exception&) {
+        // Ignore and use the default.
+    }
+
+    int64_t queue_size;
+    try {
+        queue_size = boost::lexical_cast<int64_t>(queue_size_str);
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(isc::BadValue, "invalid value of the write-behind-queue-size "
+                  << queue_size_str << " specified");
+    }
+    if ((queue_size <= 0) ||
+        (queue_size > std::numeric_limits<uint32_t>::max())) {
+        isc_throw(isc::BadValue, "invalid value of the write-behind-queue-size "
+                  << queue_size_str << " specified");
+    }
+    return (static_cast<uint32_t>(queue_size));
+}
+
+bool
+Memfile_LeaseMgr::useLeaseJournal() const {
+    std::string format = "csv";
+    try {
+        format = conn_.getParameter("lease-file-format");
+    } catch (const std::exception&) {
+        // Ignore and default to csv.
+    }
+
+    if (format == "binary") {
+        return (true);
+    } else if (format != "csv") {
+        isc_throw(isc::BadValue, "invalid value of the lease-file-format "
+                  << format << " specified, expected csv or binary");
+    }
+    return (false);
+}
+
+bool
+Memfile_LeaseMgr::useInProcessLFC() const {
+    std::string mode = "kea-lfc";
+    try {
+        mode = conn_.getParameter("lfc-mode");
+    } catch (const std::exception&) {
+        // Ignore and default to kea-lfc.
+    }
+
+    if (mode == "in-process") {
+        return (true);
+    } else if (mode != "kea-lfc") {
+        isc_throw(isc::BadValue, "invalid value of the lfc-mode "
+                  << mode << " specified, expected kea-lfc or in-process");
+    }
+    return (false);
+}
+
+bool
+Memfile_LeaseMgr::lockNeeded() const {
+    // The in-process lease file cleanup reads the storage from another
+    // thread so the storage must be locked while it runs.
+    return (MultiThreadingMgr::instance().getMode() ||
+            (lfc_setup_ && lfc_setup_->isCompacting()));
+}
+
+uint32_t
+Memfile_LeaseMgr::getFsyncRecords() const {
+    std::string fsync_records_str = "0";
+    try {
+        fsync_records_str = conn_.getParameter("fsync-records");
+    } catch (const std::exception&) {
+        // Ignore and default to 0.
+    }
+
+    int64_t fsync_records;
+    try {
+        fsync_records = boost::lexical_cast<int64_t>(fsync_records_str);
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(isc::BadValue, "invalid value of the fsync-records "
+                  << fsync_records_str << " specified");
+    }
+    if ((fsync_records < 0) ||
+        (fsync_records > std::numeric_limits<uint32_t>::max())) {
+        isc_throw(isc::BadValue, "invalid value of the fsync-records "
+                  << fsync_records_str << " specified");
+    }
+    return (static_cast<uint32_t>(fsync_records));
+}
+
+std::string
+Memfile_LeaseMgr::initLeaseFilePath(Universe u) {
+    std::string persist_val;
+    try {
+        persist_val = conn_.getParameter("persist");
+    } catch (const Exception&) {
+        // If parameter persist hasn't been specified, we use a default value
+        // 'yes'.
+        persist_val = "true";
+    }
+    // If persist_val is 'false' we will not store leases to disk, so let's
+    // return empty file name.
+    if (persist_val == "false") {
+        return ("");
+
+    } else if (persist_val != "true") {
+        isc_throw(isc::BadValue, "invalid value 'persist="
+                  << persist_val << "'");
     }
 
     std::string lease_file;
@@ -1892,6 +2666,11 @@ Memfile_LeaseMgr::initLeaseFilePath(Universe u) {
         lease_file = conn_.getParameter("name");
     } catch (const Exception&) {
         lease_file = getDefaultLeaseFilePath(u);
+        // The default lease journal doesn't use the name of the default
+        // CSV lease file.
+        if (useLeaseJournal()) {
+            lease_file.replace(lease_file.size() - 4, 4, ".journal");
+        }
     }
     return (lease_file);
 }
@@ -1936,12 +2715,46 @@ Memfile_LeaseMgr::loadLeasesFromFiles(const std::string& filename,
     }
     uint32_t max_row_errors = static_cast<uint32_t>(max_row_errors64);
 
+    std::string load_threads_str = "1";
+    try {
+        load_threads_str = conn_.getParameter("load-threads");
+    } catch (const std::exception&) {
+        // Ignore and default to 1.
+    }
+
+    int64_t load_threads64;
+    try {
+        load_threads64 = boost::lexical_cast<int64_t>(load_threads_str);
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(isc::BadValue, "invalid value of the load-threads "
+                  << load_threads_str << " specified");
+    }
+    if ((load_threads64 < 0) ||
+        (load_threads64 > std::numeric_limits<uint16_t>::max())) {
+        isc_throw(isc::BadValue, "invalid value of the load-threads "
+                  << load_threads_str << " specified");
+    }
+    // A value of 0 selects the number of threads supported by the hardware.
+    size_t load_threads = static_cast<size_t>(load_threads64);
+    if (load_threads == 0) {
+        load_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    // Restore the leases from the snapshot when it matches the lease
+    // files. The lease file is still opened to record the lease updates.
+    lease_file.reset(new LeaseFileType(filename));
+    if (lease_file->exists() && restoreLeases(filename, storage)) {
+        lease_file->open(true);
+        return (lease_file->needsConversion());
+    }
+
     // Load the leasefile.completed, if exists.
     bool conversion_needed = false;
     lease_file.reset(new LeaseFileType(std::string(filename + ".completed")));
     if (lease_file->exists()) {
         LeaseFileLoader::load<LeaseObjectType>(*lease_file, storage,
-                                               max_row_errors);
+                                               max_row_errors, true,
+                                               load_threads);
         conversion_needed = conversion_needed || lease_file->needsConversion();
     } else {
         // If the leasefile.completed doesn't exist, let's load the leases
@@ -1949,14 +2762,16 @@ Memfile_LeaseMgr::loadLeasesFromFiles(const std::string& filename,
         lease_file.reset(new LeaseFileType(appendSuffix(filename, FILE_PREVIOUS)));
         if (lease_file->exists()) {
             LeaseFileLoader::load<LeaseObjectType>(*lease_file, storage,
-                                                   max_row_errors);
+                                                   max_row_errors, true,
+                                                   load_threads);
             conversion_needed =  conversion_needed || lease_file->needsConversion();
         }
 
         lease_file.reset(new LeaseFileType(appendSuffix(filename, FILE_INPUT)));
         if (lease_file->exists()) {
             LeaseFileLoader::load<LeaseObjectType>(*lease_file, storage,
-                                                   max_row_errors);
+                                                   max_row_errors, true,
+                                                   load_threads);
             conversion_needed =  conversion_needed || lease_file->needsConversion();
         }
     }
@@ -1969,7 +2784,8 @@ Memfile_LeaseMgr::loadLeasesFromFiles(const std::string& filename,
     // future lease updates.
     lease_file.reset(new LeaseFileType(filename));
     LeaseFileLoader::load<LeaseObjectType>(*lease_file, storage,
-                                           max_row_errors, false);
+                                           max_row_errors, false,
+                                           load_threads);
     conversion_needed =  conversion_needed || lease_file->needsConversion();
 
     return (conversion_needed);
@@ -1991,12 +2807,23 @@ Memfile_LeaseMgr::lfcCallback() {
     LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_LFC_START);
 
     // Check if we're in the v4 or v6 space and use the appropriate file.
+    // The queued lease changes must be in the file before it is rotated.
     if (lease_file4_) {
         MultiThreadingCriticalSection cs;
+        drainWriteQueue();
         lfcExecute(lease_file4_);
     } else if (lease_file6_) {
         MultiThreadingCriticalSection cs;
+        drainWriteQueue();
         lfcExecute(lease_file6_);
+    } else if (journal4_) {
+        MultiThreadingCriticalSection cs;
+        drainWriteQueue();
+        lfcExecute(journal4_);
+    } else if (journal6_) {
+        MultiThreadingCriticalSection cs;
+        drainWriteQueue();
+        lfcExecute(journal6_);
     }
 }
 
@@ -2018,8 +2845,55 @@ Memfile_LeaseMgr::lfcSetup(bool conversion_needed) {
     }
 
     if (lfc_interval > 0 || conversion_needed) {
+        Universe u = persistLeases(V4) ? V4 : V6;
+        std::string filename = getLeaseFilePath(u);
+
+        // The in-process cleanup writes the leases of the storage in the
+        // format of the current lease file.
+        std::function<void()> compaction;
+        if (useInProcessLFC()) {
+            bool journal = useLeaseJournal();
+            if ((u == V4) && journal) {
+                compaction = [this, filename]() {
+                    lfcCompact<LeaseJournal4, Lease4Collection>(filename,
+                        IOAddress::IPV4_ZERO_ADDRESS());
+                };
+            } else if (u == V4) {
+                compaction = [this, filename]() {
+                    lfcCompact<CSVLeaseFile4, Lease4Collection>(filename,
+                        IOAddress::IPV4_ZERO_ADDRESS());
+                };
+            } else if (journal) {
+                compaction = [this, filename]() {
+                    lfcCompact<LeaseJournal6, Lease6Collection>(filename,
+                        IOAddress::IPV6_ZERO_ADDRESS());
+                };
+            } else {
+                compaction = [this, filename]() {
+                    lfcCompact<CSVLeaseFile6, Lease6Collection>(filename,
+                        IOAddress::IPV6_ZERO_ADDRESS());
+                };
+            }
+        }
+
+        std::string max_leases_str = "0";
+        try {
+            max_leases_str = conn_.getParameter("lfc-max-leases");
+        } catch (const std::exception&) {
+            // Ignore and default to 0.
+        }
+
+        uint32_t max_leases = 0;
+        try {
+            max_leases = boost::lexical_cast<uint32_t>(max_leases_str);
+        } catch (const boost::bad_lexical_cast&) {
+            isc_throw(isc::BadValue, "invalid value of the lfc-max-leases "
+                      << max_leases_str << " specified");
+        }
+
         lfc_setup_.reset(new LFCSetup(std::bind(&Memfile_LeaseMgr::lfcCallback, this)));
-        lfc_setup_->setup(lfc_interval, lease_file4_, lease_file6_, conversion_needed);
+        lfc_setup_->setup(lfc_interval, filename, u, conversion_needed,
+                          compaction, max_leases);
     }
 }
 
@@ -2058,7 +2932,7 @@ Memfile_LeaseMgr::lfcExecute(boost::shared_ptr<LeaseFileType>& lease_file) {
         try {
             lease_file->open(true);
 
-        } catch (const CSVFileError& ex) {
+        } catch (const isc::Exception& ex) {
             // If we're unable to open the lease file this is a serious
             // error because the server will not be able to persist
             // leases.
@@ -2084,11 +2958,89 @@ Memfile_LeaseMgr::lfcExecute(boost::shared_ptr<LeaseFileType>& lease_file) {
     }
 }
 
+void
+Memfile_LeaseMgr::getLFCPage(const IOAddress& lower_bound_address,
+                             Lease4Collection& leases) const {
+    leases = getLeases4(lower_bound_address, LeasePageSize(LFC_PAGE_SIZE));
+}
+
+void
+Memfile_LeaseMgr::getLFCPage(const IOAddress& lower_bound_address,
+                             Lease6Collection& leases) const {
+    leases = getLeases6(lower_bound_address, LeasePageSize(LFC_PAGE_SIZE));
+}
+
+template<typename LeaseFileType, typename LeaseCollectionType>
+void
+Memfile_LeaseMgr::lfcCompact(const std::string& filename,
+                             const IOAddress& zero) {
+    // A previous kea-lfc run may have left its output file: as kea-lfc
+    // the leases would be appended to it.
+    std::string output_name = appendSuffix(filename, FILE_OUTPUT);
+    if ((remove(output_name.c_str()) != 0) && (errno != ENOENT)) {
+        isc_throw(DbOperationError, "unable to remove '" << output_name
+                  << "': " << strerror(errno));
+    }
+
+    // The leases are written in pages so the storage is only locked
+    // while a page is fetched. The snapshot needs not to be consistent:
+    // the changes made after the rotation are in the current lease file.
+    LeaseFileType output(output_name);
+    output.open();
+    size_t count = 0;
+    IOAddress lower_bound_address = zero;
+    for (;;) {
+        if (lfc_stop_) {
+            output.close();
+            return;
+        }
+        LeaseCollectionType leases;
+        getLFCPage(lower_bound_address, leases);
+        for (auto const& lease : leases) {
+            output.append(*lease);
+        }
+        count += leases.size();
+        if (leases.size() < LFC_PAGE_SIZE) {
+            break;
+        }
+        lower_bound_address = leases.back()->addr_;
+    }
+    output.close();
+
+    // Move the output to the finish file and then to the previous lease
+    // file after the files it replaces were removed, as kea-lfc does.
+    std::string finish_name = appendSuffix(filename, FILE_FINISH);
+    if (rename(output_name.c_str(), finish_name.c_str()) != 0) {
+        isc_throw(DbOperationError, "unable to move '" << output_name
+                  << "' to '" << finish_name << "': " << strerror(errno));
+    }
+    std::string previous_name = appendSuffix(filename, FILE_PREVIOUS);
+    std::string input_name = appendSuffix(filename, FILE_INPUT);
+    for (auto const& name : { previous_name, input_name }) {
+        if ((remove(name.c_str()) != 0) && (errno != ENOENT)) {
+            isc_throw(DbOperationError, "unable to remove '" << name
+                      << "': " << strerror(errno));
+        }
+    }
+    if (rename(finish_name.c_str(), previous_name.c_str()) != 0) {
+        isc_throw(DbOperationError, "unable to move '" << finish_name
+                  << "' to '" << previous_name << "': " << strerror(errno));
+    }
+
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_LFC_IN_PROCESS_COMPLETE)
+        .arg(filename)
+        .arg(count);
+}
+
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startLeaseStatsQuery4() {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET));
+    }
+
     LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(storage4_));
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         query->start();
     } else {
         query->start();
@@ -2099,9 +3051,13 @@ Memfile_LeaseMgr::startLeaseStatsQuery4() {
 
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startSubnetLeaseStatsQuery4(const SubnetID& subnet_id) {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET, subnet_id));
+    }
+
     LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(storage4_, subnet_id));
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         query->start();
     } else {
         query->start();
@@ -2113,10 +3069,14 @@ Memfile_LeaseMgr::startSubnetLeaseStatsQuery4(const SubnetID& subnet_id) {
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startSubnetRangeLeaseStatsQuery4(const SubnetID& first_subnet_id,
                                                    const SubnetID& last_subnet_id) {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET, first_subnet_id, last_subnet_id));
+    }
+
     LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(storage4_, first_subnet_id,
                                                          last_subnet_id));
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         query->start();
     } else {
         query->start();
@@ -2127,9 +3087,13 @@ Memfile_LeaseMgr::startSubnetRangeLeaseStatsQuery4(const SubnetID& first_subnet_
 
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startLeaseStatsQuery6() {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET6));
+    }
+
     LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(storage6_));
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         query->start();
     } else {
         query->start();
@@ -2140,9 +3104,13 @@ Memfile_LeaseMgr::startLeaseStatsQuery6() {
 
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startSubnetLeaseStatsQuery6(const SubnetID& subnet_id) {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET6, subnet_id));
+    }
+
     LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(storage6_, subnet_id));
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         query->start();
     } else {
         query->start();
@@ -2154,10 +3122,14 @@ Memfile_LeaseMgr::startSubnetLeaseStatsQuery6(const SubnetID& subnet_id) {
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startSubnetRangeLeaseStatsQuery6(const SubnetID& first_subnet_id,
                                                    const SubnetID& last_subnet_id) {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET6, first_subnet_id, last_subnet_id));
+    }
+
     LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(storage6_, first_subnet_id,
                                                          last_subnet_id));
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         query->start();
     } else {
         query->start();
@@ -2177,7 +3149,7 @@ Memfile_LeaseMgr::wipeLeases4(const SubnetID& subnet_id) {
     // Try to get the lease using the DUID, IAID and lease type.
     std::pair<Lease4StorageSubnetIdIndex::const_iterator,
               Lease4StorageSubnetIdIndex::const_iterator> l =
-        idx.equal_range(subnet_id);
+        idx.equal_range(boost::make_tuple(subnet_id));
 
     // Let's collect all leases.
     Lease4Collection leases;
@@ -2249,8 +3221,8 @@ Memfile_LeaseMgr::recountClassLeases6() {
 size_t
 Memfile_LeaseMgr::getClassLeaseCount(const ClientClass& client_class,
                                      const Lease::Type& ltype /* = Lease::TYPE_V4*/) const {
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         return(class_lease_counter_.getClassCount(client_class, ltype));
     } else {
         return(class_lease_counter_.getClassCount(client_class, ltype));
@@ -2264,189 +3236,12 @@ Memfile_LeaseMgr::clearClassLeaseCounts() {
 
 std::string
 Memfile_LeaseMgr::checkLimits4(isc::data::ConstElementPtr const& user_context) const {
-    if (!user_context) {
-        return ("");
-    }
-
-    ConstElementPtr limits = user_context->find("ISC/limits");
-    if (!limits) {
-        return ("");
-    }
-
-    // Iterate of the 'client-classes' list in 'limits'. For each class that specifies
-    // an "address-limit", check its value against the class's lease count.
-    ConstElementPtr classes = limits->get("client-classes");
-    if (classes) {
-        for (int i = 0; i < classes->size(); ++i) {
-            ConstElementPtr class_elem = classes->get(i);
-            // Get class name.
-            ConstElementPtr name_elem = class_elem->get("name");
-            if (!name_elem) {
-                isc_throw(BadValue, "checkLimits4 - client-class.name is missing: "
-                          << prettyPrint(limits));
-            }
-
-            std::string name = name_elem->stringValue();
-
-            // Now look for an address-limit
-            size_t limit;
-            if (!getLeaseLimit(class_elem, Lease::TYPE_V4, limit)) {
-                // No limit, go to the next class.
-                continue;
-            }
-
-            // If the limit is > 0 look up the class lease count.  Limit of 0 always
-            // denies the lease.
-            size_t lease_count = 0;
-            if (limit) {
-                lease_count = getClassLeaseCount(name);
-            }
-
-            // If we're over the limit, return the error, no need to evaluate any others.
-            if (lease_count >= limit) {
-                std::ostringstream ss;
-                ss << "address limit " << limit << " for client class \""
-                   << name << "\", current lease count " << lease_count;
-                return (ss.str());
-            }
-        }
-    }
-
-    // If there were class limits we passed them, now look for a subnet limit.
-    ConstElementPtr subnet_elem = limits->get("subnet");
-    if (subnet_elem) {
-        // Get the subnet id.
-        ConstElementPtr id_elem = subnet_elem->get("id");
-        if (!id_elem) {
-            isc_throw(BadValue, "checkLimits4 - subnet.id is missing: "
-                      << prettyPrint(limits));
-        }
-
-        SubnetID subnet_id = id_elem->intValue();
-
-        // Now look for an address-limit.
-        size_t limit;
-        if (getLeaseLimit(subnet_elem, Lease::TYPE_V4, limit)) {
-            // If the limit is > 0 look up the subnet lease count. Limit of 0 always
-            // denies the lease.
-            int64_t lease_count = 0;
-            if (limit) {
-                lease_count = getSubnetStat(subnet_id, "assigned-addresses");
-            }
-
-            // If we're over the limit, return the error.
-            if (lease_count >= limit) {
-                std::ostringstream ss;
-                ss << "address limit " << limit << " for subnet ID " << subnet_id
-                   << ", current lease count " << lease_count;
-                return (ss.str());
-            }
-        }
-    }
-
-    // No limits exceeded!
-    return ("");
+    return (checkLimitsInMemory4(user_context));
 }
 
 std::string
 Memfile_LeaseMgr::checkLimits6(isc::data::ConstElementPtr const& user_context) const {
-    if (!user_context) {
-        return ("");
-    }
-
-    ConstElementPtr limits = user_context->find("ISC/limits");
-    if (!limits) {
-        return ("");
-    }
-
-    // Iterate over the 'client-classes' list in 'limits'. For each class that specifies
-    // limit (either "address-limit" or "prefix-limit", check its value against the appropriate
-    // class lease count.
-    ConstElementPtr classes = limits->get("client-classes");
-    if (classes) {
-        for (int i = 0; i < classes->size(); ++i) {
-            ConstElementPtr class_elem = classes->get(i);
-            // Get class name.
-            ConstElementPtr name_elem = class_elem->get("name");
-            if (!name_elem) {
-                isc_throw(BadValue, "checkLimits6 - client-class.name is missing: "
-                          << prettyPrint(limits));
-            }
-
-            std::string name = name_elem->stringValue();
-
-            // Now look for either address-limit or a prefix=limit.
-            size_t limit = 0;
-            Lease::Type ltype = Lease::TYPE_NA;
-            if (!getLeaseLimit(class_elem, ltype, limit)) {
-                ltype = Lease::TYPE_PD;
-                if (!getLeaseLimit(class_elem, ltype, limit)) {
-                    // No limits for this class, skip to the next.
-                    continue;
-                }
-            }
-
-            // If the limit is > 0 look up the class lease count.  Limit of 0 always
-            // denies the lease.
-            size_t lease_count = 0;
-            if (limit) {
-                lease_count = getClassLeaseCount(name, ltype);
-            }
-
-            // If we're over the limit, return the error, no need to evaluate any others.
-            if (lease_count >= limit) {
-                std::ostringstream ss;
-                ss << (ltype == Lease::TYPE_NA ? "address" : "prefix")
-                   << " limit " << limit << " for client class \""
-                   << name << "\", current lease count " << lease_count;
-                return (ss.str());
-            }
-        }
-    }
-
-    // If there were class limits we passed them, now look for a subnet limit.
-    ConstElementPtr subnet_elem = limits->get("subnet");
-    if (subnet_elem) {
-        // Get the subnet id.
-        ConstElementPtr id_elem = subnet_elem->get("id");
-        if (!id_elem) {
-            isc_throw(BadValue, "checkLimits6 - subnet.id is missing: "
-                      << prettyPrint(limits));
-        }
-
-        SubnetID subnet_id = id_elem->intValue();
-
-        // Now look for either address-limit or a prefix=limit.
-        size_t limit = 0;
-        Lease::Type ltype = Lease::TYPE_NA;
-        if (!getLeaseLimit(subnet_elem, ltype, limit)) {
-            ltype = Lease::TYPE_PD;
-            if (!getLeaseLimit(subnet_elem, ltype, limit)) {
-                // No limits for the subnet so none exceeded!
-                return ("");
-            }
-        }
-
-        // If the limit is > 0 look up the class lease count.  Limit of 0 always
-        // denies the lease.
-        int64_t lease_count = 0;
-        if (limit) {
-            lease_count = getSubnetStat(subnet_id, (ltype == Lease::TYPE_NA ?
-                                                    "assigned-nas" : "assigned-pds"));
-        }
-
-        // If we're over the limit, return the error.
-        if (lease_count >= limit) {
-            std::ostringstream ss;
-            ss << (ltype == Lease::TYPE_NA ? "address" : "prefix")
-               << " limit " << limit << " for subnet ID " << subnet_id
-               << ", current lease count " << lease_count;
-            return (ss.str());
-        }
-    }
-
-    // No limits exceeded!
-    return ("");
+    return (checkLimitsInMemory6(user_context));
 }
 
 bool
@@ -2454,36 +3249,6 @@ Memfile_LeaseMgr::isJsonSupported() const {
     return true;
 }
 
-int64_t
-Memfile_LeaseMgr::getSubnetStat(const SubnetID& subnet_id, const std::string& stat_label) const {
-    /// @todo This could be simplified if StatsMgr provided a mechanism to
-    /// return the most recent sample as an InterSample.
-    std::string stat_name = StatsMgr::generateName("subnet", subnet_id, stat_label);
-    ConstElementPtr stat = StatsMgr::instance().get(stat_name);
-    ConstElementPtr samples = stat->get(stat_name);
-    if (samples && samples->size()) {
-        auto sample = samples->get(0);
-        if (sample->size()) {
-            auto count_elem = sample->get(0);
-            return (count_elem->intValue());
-        }
-    }
-
-    return (0);
-}
-
-bool
-Memfile_LeaseMgr::getLeaseLimit(ConstElementPtr parent, Lease::Type ltype, size_t& limit) const {
-    ConstElementPtr limit_elem = parent->get(ltype == Lease::TYPE_PD ?
-                                             "prefix-limit" : "address-limit");
-    if (limit_elem) {
-        limit = limit_elem->intValue();
-        return (true);
-    }
-
-    return (false);
-}
-
 namespace {
 
 std::string
@@ -2537,8 +3302,8 @@ Memfile_LeaseMgr::getLeases4ByRelayId(const OptionBuffer& relay_id,
         .arg(qry_start_time)
         .arg(qry_end_time);
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         return (getLeases4ByRelayIdInternal(relay_id,
                                             lower_bound_address,
                                             page_size,
@@ -2560,8 +3325,9 @@ Memfile_LeaseMgr::getLeases4ByRelayIdInternal(const OptionBuffer& relay_id,
                                               const time_t& qry_start_time,
                                               const time_t& qry_end_time) {
     Lease4Collection collection;
-    const Lease4StorageRelayIdIndex& idx = storage4_.get<RelayIdIndexTag>();
-    Lease4StorageRelayIdIndex::const_iterator lb =
+    const Lease4ExtendedInfoRelayIdIndex& idx =
+        extended_info4_.get<RelayIdIndexTag>();
+    Lease4ExtendedInfoRelayIdIndex::const_iterator lb =
         idx.lower_bound(boost::make_tuple(relay_id, lower_bound_address));
     // Return all convenient leases being within the page size.
     IOAddress last_addr = lower_bound_address;
@@ -2623,8 +3389,8 @@ Memfile_LeaseMgr::getLeases4ByRemoteId(const OptionBuffer& remote_id,
         .arg(qry_start_time)
         .arg(qry_end_time);
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         return (getLeases4ByRemoteIdInternal(remote_id,
                                              lower_bound_address,
                                              page_size,
@@ -2647,8 +3413,9 @@ Memfile_LeaseMgr::getLeases4ByRemoteIdInternal(const OptionBuffer& remote_id,
                                                const time_t& qry_end_time) {
     Lease4Collection collection;
     std::map<IOAddress, Lease4Ptr> sorted;
-    const Lease4StorageRemoteIdIndex& idx = storage4_.get<RemoteIdIndexTag>();
-    Lease4StorageRemoteIdRange er = idx.equal_range(remote_id);
+    const Lease4ExtendedInfoRemoteIdIndex& idx =
+        extended_info4_.get<RemoteIdIndexTag>();
+    Lease4ExtendedInfoRemoteIdRange er = idx.equal_range(remote_id);
     // Store all convenient leases being within the page size.
     for (auto it = er.first; it != er.second; ++it) {
         const IOAddress& addr = (*it)->addr_;
@@ -2707,8 +3474,8 @@ Memfile_LeaseMgr::getLeases6ByRelayId(const DUID& relay_id,
         .arg(link_addr.toText())
         .arg(static_cast<unsigned>(link_len));
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         return (getLeases6ByRelayIdInternal(relay_id,
                                             link_addr,
                                             link_len,
@@ -2817,8 +3584,8 @@ Memfile_LeaseMgr::getLeases6ByRemoteId(const OptionBuffer& remote_id,
         .arg(link_addr.toText())
         .arg(static_cast<unsigned>(link_len));
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         return (getLeases6ByRemoteIdInternal(remote_id,
                                              link_addr,
                                              link_len,
@@ -2921,8 +3688,8 @@ Memfile_LeaseMgr::getLeases6ByLink(const IOAddress& link_addr,
         .arg(link_addr.toText())
         .arg(static_cast<unsigned>(link_len));
 
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        ReadLockGuard read_lock(*mutex_);
         return (getLeases6ByLinkInternal(link_addr,
                                          link_len,
                                          lower_bound_address,
@@ -2995,6 +3762,9 @@ Memfile_LeaseMgr::extractExtendedInfo4(bool update, bool current) {
     auto lease_it = index.begin();
     auto next_it = index.end();
 
+    // The extended info table is rebuilt from the stored leases.
+    extended_info4_.clear();
+
     for (; lease_it != index.end(); lease_it = next_it) {
         next_it = std::next(lease_it);
         Lease4Ptr lease = *lease_it;
@@ -3003,7 +3773,7 @@ Memfile_LeaseMgr::extractExtendedInfo4(bool update, bool current) {
             if (upgradeLease4ExtendedInfo(lease, check)) {
                 ++modified;
                 if (update && persistLeases(V4)) {
-                    lease_file4_->append(*lease);
+                    appendLease(*lease);
                     ++updated;
                 }
             }
@@ -3021,6 +3791,7 @@ Memfile_LeaseMgr::extractExtendedInfo4(bool update, bool current) {
                 .arg(lease->addr_.toText())
                 .arg(ex.what());
         }
+        addExtendedInfo4(*lease_it);
     }
 
     LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_EXTRACT_EXTENDED_INFO4)
@@ -3033,7 +3804,8 @@ Memfile_LeaseMgr::extractExtendedInfo4(bool update, bool current) {
 }
 
 size_t
-Memfile_LeaseMgr::buildExtendedInfoTables6Internal(bool update, bool current) {
+Memfile_LeaseMgr::buildExtendedInfoTables6Internal(bool update, bool current,
+                                                   bool rebuild) {
     CfgConsistencyPtr cfg;
     if (current) {
         cfg = CfgMgr::instance().getCurrentCfg()->getConsistency();
@@ -3045,7 +3817,12 @@ Memfile_LeaseMgr::buildExtendedInfoTables6Internal(bool update, bool current) {
                   << " consistency configuration is null");
     }
     auto check = cfg->getExtendedInfoSanityCheck();
-    bool enabled = getExtendedInfoTablesEnabled();
+    bool enabled = getExtendedInfoTablesEnabled() && rebuild;
+
+    // Nothing to do when the restored tables are kept without checks.
+    if (!rebuild && (check == CfgConsistency::EXTENDED_INFO_CHECK_NONE)) {
+        return (0);
+    }
 
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
               DHCPSRV_MEMFILE_BEGIN_BUILD_EXTENDED_INFO_TABLES6)
@@ -3070,7 +3847,7 @@ Memfile_LeaseMgr::buildExtendedInfoTables6Internal(bool update, bool current) {
             if (upgradeLease6ExtendedInfo(lease, check)) {
                 ++modified;
                 if (update && persistLeases(V6)) {
-                    lease_file6_->append(*lease);
+                    appendLease(*lease);
                     ++updated;
                 }
             }
@@ -3096,14 +3873,112 @@ Memfile_LeaseMgr::buildExtendedInfoTables6Internal(bool update, bool current) {
 
 size_t
 Memfile_LeaseMgr::buildExtendedInfoTables6(bool update, bool current) {
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        WriteLockGuard write_lock(*mutex_);
         return (buildExtendedInfoTables6Internal(update, current));
     } else {
         return (buildExtendedInfoTables6Internal(update, current));
     }
 }
 
+Lease4SnapshotFile
+Memfile_LeaseMgr::leaseSnapshotFile4(const std::string& filename) {
+    std::vector<std::string> sources;
+    sources.push_back(appendSuffix(filename, FILE_PREVIOUS));
+    sources.push_back(appendSuffix(filename, FILE_INPUT));
+    sources.push_back(appendSuffix(filename, FILE_FINISH));
+    sources.push_back(filename);
+    return (Lease4SnapshotFile(appendSuffix(filename, FILE_SNAPSHOT), sources));
+}
+
+bool
+Memfile_LeaseMgr::restoreLeases(const std::string& filename,
+                                Lease4Storage& storage) {
+    if (!useLeaseSnapshot()) {
+        return (false);
+    }
+    Lease4SnapshotFile file = leaseSnapshotFile4(filename);
+    if (!file.read(storage)) {
+        LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
+                  DHCPSRV_MEMFILE_LEASE_SNAPSHOT4_NOT_LOADED)
+            .arg(file.getFilename())
+            .arg(file.getReadMsg());
+        return (false);
+    }
+
+    // Apply the sanity checks of the loader to the restored leases. As
+    // the checker may change the subnet id they are inserted again.
+    if (SanityChecker::leaseCheckingEnabled(false)) {
+        SanityChecker lease_checker;
+        std::vector<Lease4Ptr> leases(storage.begin(), storage.end());
+        storage.clear();
+        for (auto lease : leases) {
+            lease_checker.checkLease(lease, false);
+            if (lease) {
+                storage.insert(lease);
+            }
+        }
+    }
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_LEASE_SNAPSHOT4_LOADED)
+        .arg(file.getFilename())
+        .arg(storage.size());
+    return (true);
+}
+
+void
+Memfile_LeaseMgr::saveLeaseSnapshot4(const std::string& filename) {
+    try {
+        if (useLeaseSnapshot()) {
+            leaseSnapshotFile4(filename).write(storage4_);
+        } else {
+            // Don't leave an outdated snapshot if it is enabled again.
+            leaseSnapshotFile4(filename).remove();
+        }
+    } catch (const std::exception& ex) {
+        LOG_WARN(dhcpsrv_logger, DHCPSRV_MEMFILE_LEASE_SNAPSHOT4_SAVE_FAILED)
+            .arg(filename)
+            .arg(ex.what());
+    }
+}
+
+Lease6ExtendedInfoFile
+Memfile_LeaseMgr::extendedInfoFile6(const std::string& filename) {
+    std::vector<std::string> sources;
+    sources.push_back(appendSuffix(filename, FILE_PREVIOUS));
+    sources.push_back(appendSuffix(filename, FILE_INPUT));
+    sources.push_back(filename);
+    return (Lease6ExtendedInfoFile(appendSuffix(filename, FILE_EXTENDED_INFO),
+                                   sources));
+}
+
+bool
+Memfile_LeaseMgr::loadExtendedInfoTables6(const std::string& filename) {
+    Lease6ExtendedInfoFile file = extendedInfoFile6(filename);
+    if (!file.read(relay_id6_, remote_id6_)) {
+        LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE,
+                  DHCPSRV_MEMFILE_EXTENDED_INFO_TABLES6_NOT_LOADED)
+            .arg(file.getFilename())
+            .arg(file.getReadMsg());
+        return (false);
+    }
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_EXTENDED_INFO_TABLES6_LOADED)
+        .arg(file.getFilename())
+        .arg(relay_id6_.size())
+        .arg(remote_id6_.size());
+    return (true);
+}
+
+void
+Memfile_LeaseMgr::saveExtendedInfoTables6(const std::string& filename) {
+    try {
+        extendedInfoFile6(filename).write(relay_id6_, remote_id6_);
+    } catch (const std::exception& ex) {
+        LOG_WARN(dhcpsrv_logger, DHCPSRV_MEMFILE_EXTENDED_INFO_TABLES6_SAVE_FAILED)
+            .arg(filename)
+            .arg(ex.what());
+    }
+}
+
 void
 Memfile_LeaseMgr::deleteExtendedInfo6(const IOAddress& addr) {
     LeaseAddressRelayIdIndex& relay_id_idx =
@@ -3132,8 +4007,8 @@ Memfile_LeaseMgr::addRemoteId6(const IOAddress& lease_addr,
 
 void
 Memfile_LeaseMgr::writeLeases4(const std::string& filename) {
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        WriteLockGuard write_lock(*mutex_);
         writeLeases4Internal(filename);
     } else {
         writeLeases4Internal(filename);
@@ -3142,35 +4017,18 @@ Memfile_LeaseMgr::writeLeases4(const std::string& filename) {
 
 void
 Memfile_LeaseMgr::writeLeases4Internal(const std::string& filename) {
-    bool overwrite = (lease_file4_ && lease_file4_->getFilename() == filename);
-    try {
-        if (overwrite) {
-            lease_file4_->close();
-        }
-        std::ostringstream old;
-        old << filename << ".bak" << getpid();
-        ::rename(filename.c_str(), old.str().c_str());
-        CSVLeaseFile4 backup(filename);
-        backup.open();
-        for (const auto& lease : storage4_) {
-            backup.append(*lease);
-        }
-        backup.close();
-        if (overwrite) {
-            lease_file4_->open(true);
-        }
-    } catch (const std::exception&) {
-        if (overwrite) {
-            lease_file4_->open(true);
-        }
-        throw;
+    drainWriteQueue();
+    if (journal4_) {
+        writeLeasesToFile(filename, journal4_, storage4_);
+    } else {
+        writeLeasesToFile(filename, lease_file4_, storage4_);
     }
 }
 
 void
 Memfile_LeaseMgr::writeLeases6(const std::string& filename) {
-    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+    if (lockNeeded()) {
+        WriteLockGuard write_lock(*mutex_);
         writeLeases6Internal(filename);
     } else {
         writeLeases6Internal(filename);
@@ -3179,26 +4037,39 @@ Memfile_LeaseMgr::writeLeases6(const std::string& filename) {
 
 void
 Memfile_LeaseMgr::writeLeases6Internal(const std::string& filename) {
-    bool overwrite = (lease_file6_ && lease_file6_->getFilename() == filename);
+    drainWriteQueue();
+    if (journal6_) {
+        writeLeasesToFile(filename, journal6_, storage6_);
+    } else {
+        writeLeasesToFile(filename, lease_file6_, storage6_);
+    }
+}
+
+template<typename LeaseFileType, typename StorageType>
+void
+Memfile_LeaseMgr::writeLeasesToFile(const std::string& filename,
+                                    boost::shared_ptr<LeaseFileType>& lease_file,
+                                    const StorageType& storage) {
+    bool overwrite = (lease_file && lease_file->getFilename() == filename);
     try {
         if (overwrite) {
-            lease_file6_->close();
+            lease_file->close();
         }
         std::ostringstream old;
         old << filename << ".bak" << getpid();
         ::rename(filename.c_str(), old.str().c_str());
-        CSVLeaseFile6 backup(filename);
+        LeaseFileType backup(filename);
         backup.open();
-        for (const auto& lease : storage6_) {
+        for (const auto& lease : storage) {
             backup.append(*lease);
         }
         backup.close();
         if (overwrite) {
-            lease_file6_->open(true);
+            lease_file->open(true);
         }
     } catch (const std::exception&) {
         if (overwrite) {
-            lease_file6_->open(true);
+            lease_file->open(true);
         }
         throw;
     }
@@ -13,14 +13,22 @@
 #include <dhcp/hwaddr.h>
 #include <dhcpsrv/csv_lease_file4.h>
 #include <dhcpsrv/csv_lease_file6.h>
+#include <dhcpsrv/identifier_pool.h>
+#include <dhcpsrv/lease4_snapshot_file.h>
+#include <dhcpsrv/lease6_extended_info_file.h>
+#include <dhcpsrv/lease_journal.h>
+#include <dhcpsrv/lease_write_queue.h>
 #include <dhcpsrv/memfile_lease_limits.h>
 #include <dhcpsrv/memfile_lease_storage.h>
 #include <dhcpsrv/tracking_lease_mgr.h>
+#include <util/readwrite_mutex.h>
 
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <atomic>
 #include <mutex>
+#include <unordered_set>
 
 namespace isc {
 namespace dhcp {
@@ -77,6 +85,33 @@ class LFCSetup;
 /// is not specified, the default location in the installation
 /// directory is used: <install-dir>/var/lib/kea/kea-leases4.csv and
 /// <install-dir>/var/lib/kea/kea-leases6.csv.
+///
+/// The "lease-file-format=binary" parameter selects the binary lease
+/// journal implemented by the @c LeaseJournal4 and @c LeaseJournal6 classes
+/// instead of the CSV files. The default journal locations use the
+/// ".journal" extension instead of ".csv". The "fsync-records=[n]"
+/// parameter specifies the number of records written to the journal
+/// between the synchronizations of the file to the disk. The default
+/// value of 0 only synchronizes the file when it is closed.
+///
+/// The "write-behind=true" parameter enables the write-behind mode used
+/// when the multi-threading is enabled: the lease changes are pushed to a
+/// @c LeaseWriteQueue of "write-behind-queue-size=[n]" entries (4096 by
+/// default) and a writer thread appends them to the lease file in batches,
+/// so the worker threads don't hold the backend lock during the file I/O.
+/// Each batch holds at most "fsync-records" changes and is followed by a
+/// synchronization of the lease journal when "fsync-records" is not 0.
+/// The @c whenLeasesDurable function allows the server to hold a response
+/// until the lease changes it depends on are durable.
+///
+/// The "lfc-mode=in-process" parameter replaces the @c kea-lfc process by
+/// a thread of the server. As the in-memory leases are authoritative, the
+/// thread doesn't read the lease files: it writes the leases to the output
+/// file by pages taken from the storage and then rotates the files the
+/// same way as @c kea-lfc. The lease changes made meanwhile are appended
+/// to the new current lease file, so the pages don't have to be a
+/// consistent snapshot. The storage is always locked while the thread
+/// runs, even when the multi-threading is disabled.
 class Memfile_LeaseMgr : public TrackingLeaseMgr {
 public:
 
@@ -238,6 +273,33 @@ public:
     /// @return Lease collection (may be empty if no IPv4 lease found).
     virtual Lease4Collection getLeases4(SubnetID subnet_id) const override;
 
+    /// @brief Returns an estimate of the memory used by the IPv4 leases
+    /// of a subnet.
+    ///
+    /// The estimate includes the leases, their hardware address, client
+    /// identifier and hostname, and the nodes of the lease container. It
+    /// does not include the user contexts and the buckets of the hash
+    /// indexes which are shared by all the subnets.
+    ///
+    /// @param subnet_id subnet identifier.
+    ///
+    /// @return the estimated memory in bytes.
+    size_t getLeaseMemoryUsage4(SubnetID subnet_id) const;
+
+    /// @brief Collects the addresses or prefixes leased in a subnet.
+    ///
+    /// Unlike @c getLeases4 and @c getLeases6 the leases are not copied,
+    /// so the allocators initialized after a restart scan the restored
+    /// lease storage in place. The expired and the reclaimed leases are
+    /// not collected.
+    ///
+    /// @param subnet_id subnet identifier.
+    /// @param type lease type.
+    /// @param [out] addresses the leased addresses or prefixes.
+    void getLeasedAddresses(SubnetID subnet_id, Lease::Type type,
+                            std::unordered_set<asiolink::IOAddress,
+                                               asiolink::IOAddress::Hash>& addresses) const;
+
     /// @brief Returns all IPv4 leases for the particular hostname.
     ///
     /// @param hostname hostname in lower case.
@@ -278,6 +340,24 @@ public:
     getLeases4(const asiolink::IOAddress& lower_bound_address,
                const LeasePageSize& page_size) const override;
 
+    /// @brief Returns a page of IPv4 leases matching a filter.
+    ///
+    /// When the filter specifies a subnet the page is read from the
+    /// index by subnet identifier and address so the leases of other
+    /// subnets are never visited. The other criteria are checked while
+    /// walking the index.
+    ///
+    /// @param filter the filter of the leases.
+    /// @param lower_bound_address IPv4 address used as lower bound for the
+    /// returned range.
+    /// @param page_size maximum size of the page returned.
+    ///
+    /// @return Lease collection (may be empty if no IPv4 lease found).
+    virtual Lease4Collection
+    getFilteredLeases4(const LeasePageFilter& filter,
+                       const asiolink::IOAddress& lower_bound_address,
+                       const LeasePageSize& page_size) const override;
+
     /// @brief Returns existing IPv6 lease for a given IPv6 address.
     ///
     /// This function returns a copy of the lease. The modification in the
@@ -290,6 +370,20 @@ public:
     virtual Lease6Ptr getLease6(Lease::Type type,
                                 const isc::asiolink::IOAddress& addr) const override;
 
+    /// @brief Returns existing IPv6 leases for given IPv6 addresses.
+    ///
+    /// The leases are looked up under a single acquisition of the lock.
+    ///
+    /// @param type specifies lease type: (NA, TA or PD)
+    /// @param addresses addresses or prefixes of the searched leases
+    ///
+    /// @return Lease collection holding the leases which were found.
+    virtual Lease6Collection
+    getLeases6ByAddresses(Lease::Type type,
+                          const std::vector<asiolink::IOAddress>& addresses) const override;
+
+    /// @brief Returns existing IPv6 lease for a given DUID + IA + lease type                                const isc::asiolink::IOAddress& addr) const override;
+
     /// @brief Returns existing IPv6 lease for a given DUID + IA + lease type
     /// combination
     ///
@@ -617,6 +711,23 @@ private:
     void getLeases4Internal(SubnetID subnet_id,
                             Lease4Collection& collection) const;
 
+    /// @brief Returns an estimate of the memory used by the IPv4 leases
+    /// of a subnet.
+    ///
+    /// @param subnet_id subnet identifier.
+    ///
+    /// @return the estimated memory in bytes.
+    size_t getLeaseMemoryUsage4Internal(SubnetID subnet_id) const;
+
+    /// @brief Collects the addresses or prefixes leased in a subnet.
+    ///
+    /// @param subnet_id subnet identifier.
+    /// @param type lease type.
+    /// @param [out] addresses the leased addresses or prefixes.
+    void getLeasedAddressesInternal(SubnetID subnet_id, Lease::Type type,
+                                    std::unordered_set<asiolink::IOAddress,
+                                                       asiolink::IOAddress::Hash>& addresses) const;
+
     /// @brief Returns all IPv4 leases for the particular hostname.
     ///
     /// @param hostname hostname in lower case.
@@ -639,6 +750,18 @@ private:
                             const LeasePageSize& page_size,
                             Lease4Collection& collection) const;
 
+    /// @brief Returns a page of IPv4 leases matching a filter.
+    ///
+    /// @param filter the filter of the leases.
+    /// @param lower_bound_address IPv4 address used as lower bound for the
+    /// returned range.
+    /// @param page_size maximum size of the page returned.
+    /// @param collection lease collection
+    void getFilteredLeases4Internal(const LeasePageFilter& filter,
+                                    const asiolink::IOAddress& lower_bound_address,
+                                    const LeasePageSize& page_size,
+                                    Lease4Collection& collection) const;
+
     /// @brief Returns existing IPv6 lease for a given IPv6 address and type.
     ///
     /// @param type specifies lease type: (NA, TA or PD)
@@ -648,6 +771,15 @@ private:
     Lease6Ptr getLease6Internal(Lease::Type type,
                                 const isc::asiolink::IOAddress& addr) const;
 
+    /// @brief Returns existing IPv6 leases for given IPv6 addresses.
+    ///
+    /// @param type specifies lease type: (NA, TA or PD)
+    /// @param addresses addresses or prefixes of the searched leases
+    /// @param collection lease collection where the leases are added
+    void getLeases6ByAddressesInternal(Lease::Type type,
+                                       const std::vector<asiolink::IOAddress>& addresses,
+                                       Lease6Collection& collection) const;
+
     /// @brief Returns existing IPv6 lease of any type for a given IPv6 address.
     ///
     /// @param addr An address of the searched lease.
@@ -816,56 +948,40 @@ private:
 
     /// @brief Deletes all expired-reclaimed leases.
     ///
-    /// This private method is called by both of the public methods:
-    /// @c deleteExpiredReclaimedLeases4 and
+    /// This private method is called by the public method
     /// @c deleteExpiredReclaimedLeases6 to remove all expired
-    /// reclaimed DHCPv4 or DHCPv6 leases respectively.
+    /// reclaimed DHCPv6 leases.
     ///
     /// @param secs Number of seconds since expiration of leases before
     /// they can be removed. Leases which have expired later than this
     /// time will not be deleted.
-    /// @param universe V4 or V6.
+    /// @param universe V6.
     /// @param storage Reference to the container where leases are held.
     /// Some expired-reclaimed leases will be removed from this container.
-    /// @param lease_file Reference to a DHCPv4 or DHCPv6 lease file
-    /// instance where leases should be marked as deleted.
     ///
     /// @return Number of leases deleted.
     ///
     /// @tparam IndexType Index type to be used to search for the
-    /// expired-reclaimed leases, i.e.
-    /// @c Lease4StorageExpirationIndex or @c Lease6StorageExpirationIndex.
+    /// expired-reclaimed leases, i.e. @c Lease6StorageExpirationIndex.
     /// @tparam LeaseType Lease type, i.e. @c Lease4 or @c Lease6.
     /// @tparam StorageType Type of storage where leases are held, i.e.
     /// @c Lease4Storage or @c Lease6Storage.
-    /// @tparam LeaseFileType Type of the lease file, i.e. DHCPv4 or
-    /// DHCPv6 lease file type.
-    template<typename IndexType, typename LeaseType, typename StorageType,
-             typename LeaseFileType>
+    template<typename IndexType, typename LeaseType, typename StorageType>
     uint64_t deleteExpiredReclaimedLeases(const uint32_t secs,
                                           const Universe& universe,
-                                          StorageType& storage,
-                                          LeaseFileType& lease_file);
+                                          StorageType& storage);
 
-    /// @brief Fetches the most recent value for a subnet statistic
-    ///
-    /// @param subnet_id subnet id of the subnet for which the stat is desired
-    /// @param stat_label name of the statistic desired (e.g. "assigned-addresses")
+    /// @brief Deletes all expired and reclaimed DHCPv4 leases.
     ///
-    /// @return Value of the statistic or zero if there are no entries found.
-    int64_t getSubnetStat(const SubnetID& subnet_id, const std::string& stat_label) const;
-
-    /// @brief Fetches the integer value of lease limit element from a parent element based
-    /// on Lease::Type.
+    /// The DHCPv4 leases are searched using the expiration timing wheel
+    /// of the @c Lease4Storage.
     ///
-    /// @param parent parent element (e.g. "client-class" or "subnet") in which to look for
-    /// the limit
-    /// @param ltype Lease::Type of the limit for which to look (one of Lease::TYPE_V4,
-    /// Lease::TYPE_NA, or Lease::TYPE_PD)
-    /// @param[out] limit contains the value of the limit if found
+    /// @param secs Number of seconds since expiration of leases before
+    /// they can be removed. Leases which have expired later than this
+    /// time will not be deleted.
     ///
-    /// @return bool true if a limit for the lease type was found, false otherwise.
-    bool getLeaseLimit(data::ConstElementPtr parent, Lease::Type ltype, size_t& limit) const;
+    /// @return Number of leases deleted.
+    uint64_t deleteExpiredReclaimedLeases4Internal(const uint32_t secs);
 
 public:
 
@@ -894,6 +1010,11 @@ public:
     /// @return Description of the backend.
     virtual std::string getDescription() const override;
 
+    /// @brief Returns the memory usage of the backend.
+    ///
+    /// @return A map with the numbers of IPv4 and IPv6 leases in memory.
+    virtual data::ElementPtr getMemoryStats() const override;
+
     /// @brief Returns backend version.
     ///
     /// @return Version number as a pair of unsigned integers.  "first" is the
@@ -927,7 +1048,9 @@ public:
         FILE_PREVIOUS, ///< Previous %Lease File
         FILE_OUTPUT,   ///< LFC Output File
         FILE_FINISH,   ///< LFC Finish File
-        FILE_PID       ///< PID File
+        FILE_PID,      ///< PID File
+        FILE_EXTENDED_INFO, ///< DHCPv6 Extended Info Tables File
+        FILE_SNAPSHOT  ///< DHCPv4 Lease Snapshot File
     };
 
     /// @brief Appends appropriate suffix to the file name.
@@ -940,6 +1063,8 @@ public:
     /// - LFC Output File: ".output"
     /// - LFC Finish File: ".completed"
     /// - LFC PID File: ".pid"
+    /// - DHCPv6 Extended Info Tables File: ".xinfo"
+    /// - DHCPv4 Lease Snapshot File: ".snapshot"
     ///
     /// See
     /// https://gitlab.isc.org/isc-projects/kea/wikis/designs/Lease-File-Cleanup-design
@@ -1005,6 +1130,93 @@ private:
     /// argument to this function.
     std::string initLeaseFilePath(Universe u);
 
+    /// @brief Checks if the lease journal is used instead of the CSV files.
+    ///
+    /// @return true if the "lease-file-format" parameter is "binary", false
+    /// if it is "csv" or not specified.
+    /// @throw BadValue if the parameter has another value.
+    bool useLeaseJournal() const;
+
+    /// @brief Returns the number of journal records written between the
+    /// synchronizations to the disk.
+    ///
+    /// @return The value of the "fsync-records" parameter or 0 if it is
+    /// not specified.
+    /// @throw BadValue if the parameter is not a 32 bits unsigned integer.
+    uint32_t getFsyncRecords() const;
+
+    /// @brief Checks if the lease changes are written by a writer thread.
+    ///
+    /// @return true if the "write-behind" parameter is "true", false if
+    /// it is "false" or not specified.
+    /// @throw BadValue if the parameter has another value.
+    bool useWriteBehind() const;
+
+    /// @brief Checks if the DHCPv4 lease storage is saved in a snapshot.
+    ///
+    /// @return true if the "lease-snapshot" parameter is "true", false if
+    /// it is "false" or not specified.
+    /// @throw BadValue if the parameter has another value.
+    bool useLeaseSnapshot() const;
+
+    /// @brief Returns the maximum number of queued lease changes in the
+    /// write-behind mode.
+    ///
+    /// @return The value of the "write-behind-queue-size" parameter or
+    /// 4096 if it is not specified.
+    /// @throw BadValue if the parameter is not a positive 32 bits integer.
+    uint32_t getWriteBehindQueueSize() const;
+
+    /// @brief Checks if the lease file cleanup is performed in-process.
+    ///
+    /// @return true if the "lfc-mode" parameter is "in-process", false if
+    /// it is "kea-lfc" or not specified.
+    /// @throw BadValue if the parameter has another value.
+    bool useInProcessLFC() const;
+
+    /// @brief Checks if the lease storage must be locked.
+    ///
+    /// @return true if the multi-threading is enabled or the in-process
+    /// lease file cleanup is running.
+    bool lockNeeded() const;
+
+    /// @brief Appends a lease to the lease file or to the lease journal.
+    ///
+    /// In the write-behind mode with the multi-threading enabled a copy
+    /// of the lease is pushed to the write queue instead.
+    ///
+    /// @param lease The lease to be written.
+    void appendLease(const Lease4& lease);
+
+    /// @brief Appends a lease to the lease file or to the lease journal.
+    ///
+    /// In the write-behind mode with the multi-threading enabled a copy
+    /// of the lease is pushed to the write queue instead.
+    ///
+    /// @param lease The lease to be written.
+    void appendLease(const Lease6& lease);
+
+    /// @brief Writes a lease to the lease file or to the lease journal.
+    ///
+    /// @param lease The lease to be written.
+    void writeLease(const Lease4& lease);
+
+    /// @brief Writes a lease to the lease file or to the lease journal.
+    ///
+    /// @param lease The lease to be written.
+    void writeLease(const Lease6& lease);
+
+    /// @brief Flushes the lease file after a batch of the write queue.
+    ///
+    /// @param sync Synchronize the lease journal to the disk.
+    void flushLeaseFile(const bool sync);
+
+    /// @brief Waits until the queued lease changes are written.
+    ///
+    /// It must be called before using the lease files from the current
+    /// thread, e.g. before rotating or rewriting them.
+    void drainWriteQueue();
+
     /// @brief Load leases from the persistent storage.
     ///
     /// This method loads DHCPv4 or DHCPv6 leases from lease files in the
@@ -1047,12 +1259,18 @@ private:
     /// @todo Consider implementing delaying the lease files loading when
     /// the LFC is in progress by the specified amount of time.
     ///
+    /// The rows of the lease files are parsed by the number of threads
+    /// specified with the @c load-threads parameter. It defaults to 1,
+    /// and the value of 0 selects the number of threads supported by the
+    /// hardware.
+    ///
     /// @param filename Name of the lease file.
     /// @param lease_file An object representing a lease file to which
     /// the server will store lease updates.
     /// @param storage A storage for leases read from the lease file.
     /// @tparam LeaseObjectType @c Lease4 or @c Lease6.
-    /// @tparam LeaseFileType @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam LeaseFileType @c CSVLeaseFile4, @c CSVLeaseFile6,
+    /// @c LeaseJournal4 or @c LeaseJournal6.
     /// @tparam StorageType @c Lease4Storage or @c Lease6Storage.
     ///
     /// @return Returns true if any of the files loaded need conversion from
@@ -1066,14 +1284,88 @@ private:
                              boost::shared_ptr<LeaseFileType>& lease_file,
                              StorageType& storage);
 
+    /// @brief Returns the lease snapshot file of a DHCPv4 lease file.
+    ///
+    /// @param filename Name of the DHCPv4 lease file.
+    /// @return The file holding the leases loaded from the lease file, its
+    /// copy, its previous version and the LFC finish file.
+    static Lease4SnapshotFile leaseSnapshotFile4(const std::string& filename);
+
+    /// @brief Restores the DHCPv4 leases from the lease snapshot.
+    ///
+    /// Called by @c loadLeasesFromFiles before the lease files are loaded.
+    ///
+    /// @param filename Name of the DHCPv4 lease file.
+    /// @param storage The lease storage.
+    /// @return true if the leases were restored and the lease files must
+    /// not be loaded.
+    bool restoreLeases(const std::string& filename, Lease4Storage& storage);
+
+    /// @brief DHCPv6 version of @c restoreLeases.
+    ///
+    /// There is no DHCPv6 lease snapshot so it always returns false.
+    ///
+    /// @return false.
+    bool restoreLeases(const std::string&, Lease6Storage&) {
+        return (false);
+    }
+
+    /// @brief Saves the DHCPv4 leases to the lease snapshot.
+    ///
+    /// Called when the lease files are closed. This function is exception
+    /// safe.
+    ///
+    /// @param filename Name of the DHCPv4 lease file.
+    void saveLeaseSnapshot4(const std::string& filename);
+
+    /// @brief Interns the identifiers of a stored IPv4 lease.
+    ///
+    /// The hardware address and the client identifier of the lease are
+    /// replaced with the equal pooled ones, if any.
+    ///
+    /// @param lease stored lease.
+    void internIdentifiers(const Lease4Ptr& lease);
+
+    /// @brief Interns the identifiers of a stored IPv6 lease.
+    ///
+    /// The DUID and the hardware address of the lease are replaced with
+    /// the equal pooled ones, if any.
+    ///
+    /// @param lease stored lease.
+    void internIdentifiers(const Lease6Ptr& lease);
+
+    /// @brief Adds a stored IPv4 lease to the extended info table.
+    ///
+    /// The lease is added only when it has a relay id or a remote id.
+    ///
+    /// @param lease stored lease.
+    void addExtendedInfo4(const Lease4Ptr& lease);
+
+    /// @brief Removes a stored IPv4 lease from the extended info table.
+    ///
+    /// @param lease stored lease.
+    void deleteExtendedInfo4(const Lease4Ptr& lease);
+
     /// @brief stores IPv4 leases
     Lease4Storage storage4_;
 
     /// @brief stores IPv6 leases
     Lease6Storage storage6_;
 
+    /// @brief Interned hardware addresses of the stored leases.
+    IdentifierPool<HWAddr> hwaddr_pool_;
+
+    /// @brief Interned client identifiers of the stored IPv4 leases.
+    IdentifierPool<ClientId> client_id_pool_;
+
+    /// @brief Interned DUIDs of the stored IPv6 leases.
+    IdentifierPool<DUID> duid_pool_;
+
 protected:
 
+    /// @brief stores IPv4 by-relay-id and by-remote-id cross-reference table
+    Lease4ExtendedInfoTable extended_info4_;
+
     /// @brief stores IPv6 by-relay-id cross-reference table
     Lease6ExtendedInfoRelayIdTable relay_id6_;
 
@@ -1086,6 +1378,25 @@ protected:
     /// @brief Holds the pointer to the DHCPv6 lease file IO.
     boost::shared_ptr<CSVLeaseFile6> lease_file6_;
 
+    /// @brief Holds the pointer to the DHCPv4 lease journal IO.
+    ///
+    /// It is used instead of the @c lease_file4_ when the lease file
+    /// format is binary.
+    boost::shared_ptr<LeaseJournal4> journal4_;
+
+    /// @brief Holds the pointer to the DHCPv6 lease journal IO.
+    ///
+    /// It is used instead of the @c lease_file6_ when the lease file
+    /// format is binary.
+    boost::shared_ptr<LeaseJournal6> journal6_;
+
+    /// @brief Holds the queue of the lease changes in the write-behind
+    /// mode.
+    ///
+    /// It is declared after the lease files so as it is destroyed, and
+    /// the queued changes are written, before them.
+    LeaseWriteQueuePtr write_queue_;
+
 public:
 
     /// @name Public methods to retrieve information about the LFC process state.
@@ -1231,10 +1542,47 @@ private:
     /// @param lease_file A pointer to the object representing the Current
     /// %Lease File (DHCPv4 or DHCPv6 lease file).
     ///
-    /// @tparam LeaseFileType One of @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam LeaseFileType One of @c CSVLeaseFile4, @c CSVLeaseFile6,
+    /// @c LeaseJournal4 or @c LeaseJournal6.
     template<typename LeaseFileType>
     void lfcExecute(boost::shared_ptr<LeaseFileType>& lease_file);
 
+    /// @brief Performs the in-process lease file cleanup.
+    ///
+    /// It is run by the thread started by the @c LFCSetup. The leases are
+    /// written to the %Lease File Output by pages, which is then moved to
+    /// the %Lease File Finish. The %Lease File Copy and %Lease File Previous
+    /// are removed and the %Lease File Finish becomes the new %Lease File
+    /// Previous.
+    ///
+    /// @param filename name of the Current %Lease File.
+    /// @param zero lowest address of the universe starting the first page.
+    /// @throw DbOperationError if a file can't be removed or renamed.
+    ///
+    /// @tparam LeaseFileType One of @c CSVLeaseFile4, @c CSVLeaseFile6,
+    /// @c LeaseJournal4 or @c LeaseJournal6.
+    /// @tparam LeaseCollectionType @c Lease4Collection or
+    /// @c Lease6Collection.
+    template<typename LeaseFileType, typename LeaseCollectionType>
+    void lfcCompact(const std::string& filename, const asiolink::IOAddress& zero);
+
+    /// @brief Fetches a page of IPv4 leases for the in-process cleanup.
+    ///
+    /// @param lower_bound_address the page starts after this address.
+    /// @param[out] leases the page of leases.
+    void getLFCPage(const asiolink::IOAddress& lower_bound_address,
+                    Lease4Collection& leases) const;
+
+    /// @brief Fetches a page of IPv6 leases for the in-process cleanup.
+    ///
+    /// @param lower_bound_address the page starts after this address.
+    /// @param[out] leases the page of leases.
+    void getLFCPage(const asiolink::IOAddress& lower_bound_address,
+                    Lease6Collection& leases) const;
+
+    /// @brief Requests the in-process lease file cleanup to stop.
+    std::atomic<bool> lfc_stop_;
+
     /// @brief A pointer to the Lease File Cleanup configuration.
     boost::scoped_ptr<LFCSetup> lfc_setup_;
 
@@ -1247,7 +1595,11 @@ private:
     //@}
 
     /// @brief Manager mutex
-    boost::scoped_ptr<std::mutex> mutex_;
+    ///
+    /// The lookups which don't modify the lease storage take it as
+    /// readers so they run concurrently. The other operations take
+    /// it as writers.
+    boost::scoped_ptr<util::ReadWriteMutex> mutex_;
 
     /// @brief Class lease counts container
     ClassLeaseCounter class_lease_counter_;
@@ -1399,6 +1751,19 @@ public:
     /// @return The number of updates in the database or 0.
     virtual size_t buildExtendedInfoTables6(bool update, bool current) override;
 
+    /// @brief Registers a callback invoked when the lease changes made by
+    /// the current thread are durable.
+    ///
+    /// In the write-behind mode the callback is invoked by the writer
+    /// thread when the last lease change pushed by the current thread has
+    /// been written to the lease file.
+    ///
+    /// @param callback Function to invoke.
+    ///
+    /// @return false if the write-behind mode is not in use or the changes
+    /// are already durable.
+    virtual bool whenLeasesDurable(const DurableCallback& callback) override;
+
 private:
 
     /// @brief Returns existing IPv4 leases with a given relay-id.
@@ -1493,8 +1858,33 @@ private:
     /// @param update Update extended info in database.
     /// @param current specify whether to use current (true) or staging
     /// (false) config.
+    /// @param rebuild when false the tables restored from the extended
+    /// info tables file are kept and only the sanity checks are done.
     /// @return The number of updates in the database or 0.
-    size_t buildExtendedInfoTables6Internal(bool update, bool current);
+    size_t buildExtendedInfoTables6Internal(bool update, bool current,
+                                            bool rebuild = true);
+
+    /// @brief Returns the extended info tables file of a DHCPv6 lease file.
+    ///
+    /// @param filename Name of the DHCPv6 lease file.
+    /// @return The file holding the tables built from the lease file, its
+    /// copy and its previous version.
+    static Lease6ExtendedInfoFile extendedInfoFile6(const std::string& filename);
+
+    /// @brief Restores the extended info v6 tables from their file.
+    ///
+    /// @param filename Name of the DHCPv6 lease file.
+    /// @return true if the tables were restored, false if they must be
+    /// built from the leases.
+    bool loadExtendedInfoTables6(const std::string& filename);
+
+    /// @brief Saves the extended info v6 tables to their file.
+    ///
+    /// Called when the lease files are closed. This function is exception
+    /// safe.
+    ///
+    /// @param filename Name of the DHCPv6 lease file.
+    void saveExtendedInfoTables6(const std::string& filename);
 
 public:
 
@@ -1543,6 +1933,22 @@ private:
     /// @param filename File name to write leases.
     /// Must be called from a thread-safe context.
     virtual void writeLeases6Internal(const std::string& filename);
+
+    /// @brief Write leases to a file in the format of the lease file.
+    ///
+    /// If the file is the lease file it is replaced by the new file which
+    /// is then used to record the lease updates.
+    ///
+    /// @param filename File name to write leases.
+    /// @param lease_file Pointer to the lease file or null.
+    /// @param storage Leases to be written.
+    /// @tparam LeaseFileType @c CSVLeaseFile4, @c CSVLeaseFile6,
+    /// @c LeaseJournal4 or @c LeaseJournal6.
+    /// @tparam StorageType @c Lease4Storage or @c Lease6Storage.
+    template<typename LeaseFileType, typename StorageType>
+    void writeLeasesToFile(const std::string& filename,
+                           boost::shared_ptr<LeaseFileType>& lease_file,
+                           const StorageType& storage);
 };
 
 }  // namespace dhcp
@@ -34,6 +34,12 @@ struct DuidIaidTypeIndexTag { };
 /// @brief Tag for indexes by expiration time.
 struct ExpirationIndexTag { };
 
+/// @brief Tag for the indexes of the levels of the expiration timing wheel.
+///
+/// @tparam Level The level of the timing wheel.
+template<unsigned Level>
+struct ExpirationWheelIndexTag { };
+
 /// @brief Tag for indexes by HW address, subnet identifier tuple.
 struct HWAddressSubnetIdIndexTag { };
 
@@ -55,6 +61,51 @@ struct RemoteIdIndexTag { };
 /// @brief Tag for index using relay-id.
 struct RelayIdIndexTag { };
 
+/// @brief Hierarchical timing wheel of the DHCPv4 lease expiration times.
+///
+/// The leases are put in coarse buckets by their expiration time at each
+/// level of the wheel: a bucket at a level spans 2^SHIFT buckets of the
+/// level below. The buckets are hashed indexes of the lease storage so
+/// adding or renewing a lease costs O(1) instead of rebalancing an
+/// ordered index. The expired leases are collected by walking the
+/// non-empty buckets from the top level down to the level 0.
+struct ExpirationWheel {
+    /// @brief The number of bits of the expiration time per level.
+    static const unsigned SHIFT = 8;
+
+    /// @brief The top level of the wheel.
+    ///
+    /// A level 0 bucket spans 256 seconds, a level 1 bucket about 18
+    /// hours and a level 2 bucket about 194 days.
+    static const unsigned TOP_LEVEL = 2;
+
+    /// @brief Returns the bucket of an expiration time at a level.
+    ///
+    /// @param expire The expiration time.
+    /// @param level The level.
+    /// @return The bucket of the expiration time.
+    static int64_t getBucket(int64_t expire, unsigned level) {
+        return (expire >> (SHIFT * (level + 1)));
+    }
+};
+
+/// @brief Key extractor of the bucket of the expiration time of a lease
+/// at a level of the expiration timing wheel.
+///
+/// @tparam Level The level of the timing wheel.
+template<unsigned Level>
+struct ExpirationWheelBucket {
+    /// @brief The type of the key.
+    typedef int64_t result_type;
+
+    /// @brief Returns the bucket of the lease.
+    ///
+    /// @param lease The lease.
+    int64_t operator()(const Lease& lease) const {
+        return (ExpirationWheel::getBucket(lease.getExpirationTime(), Level));
+    }
+};
+
 /// @name Multi index containers holding DHCPv4 and DHCPv6 leases.
 ///
 //@{
@@ -152,14 +203,16 @@ typedef boost::multi_index_container<
 /// - IPv4 address,
 /// - composite index: hardware address and subnet id,
 /// - composite index: client id and subnet id,
-/// - using a composite index: boolean flag indicating if the state is
-///   "expired-reclaimed" and expiration time.
+/// - using three composite indexes: boolean flag indicating if the state
+///   is "expired-reclaimed" and expiration time bucket at a level of the
+///   @c ExpirationWheel.
 /// - using subnet id.
 /// - using hostname.
-/// - using remote id.
-/// - using a composite index:
 ///
-/// Indexes can be accessed using the index number (from 0 to 5) or a
+/// The leases with a relay id or a remote id are also held in the
+/// @c Lease4ExtendedInfoTable.
+///
+/// Indexes can be accessed using the index number (from 0 to 7) or a
 /// name tag. It is recommended to use the tags to access indexes as
 /// they do not depend on the order of indexes in the container.
 typedef boost::multi_index_container<
@@ -215,38 +268,84 @@ typedef boost::multi_index_container<
         >,
 
         // Specification of the fourth index starts here.
-        boost::multi_index::ordered_non_unique<
-            boost::multi_index::tag<ExpirationIndexTag>,
-            // This is a composite index that will be used to search for
-            // the expired leases. Depending on the value of the first component
-            // of the search key, the reclaimed or not reclaimed leases will can
-            // be searched.
+        // The fourth, fifth and sixth indexes are the levels 0, 1 and 2
+        // of the expiration timing wheel. They are used to search for the
+        // expired leases. Depending on the value of the first component
+        // of the search key, the reclaimed or not reclaimed leases can
+        // be searched.
+        boost::multi_index::hashed_non_unique<
+            boost::multi_index::tag<ExpirationWheelIndexTag<0> >,
             boost::multi_index::composite_key<
                 Lease4,
                 // The boolean value specifying if lease is reclaimed or not.
                 boost::multi_index::const_mem_fun<Lease, bool,
                                                   &Lease::stateExpiredReclaimed>,
-                // Lease expiration time.
-                boost::multi_index::const_mem_fun<Lease, int64_t,
-                                                  &Lease::getExpirationTime>
+                // Level 0 bucket of the lease expiration time.
+                ExpirationWheelBucket<0>
             >
         >,
 
         // Specification of the fifth index starts here.
-        // This index sorts leases by SubnetID.
+        boost::multi_index::hashed_non_unique<
+            boost::multi_index::tag<ExpirationWheelIndexTag<1> >,
+            boost::multi_index::composite_key<
+                Lease4,
+                boost::multi_index::const_mem_fun<Lease, bool,
+                                                  &Lease::stateExpiredReclaimed>,
+                // Level 1 bucket of the lease expiration time.
+                ExpirationWheelBucket<1>
+            >
+        >,
+
+        // Specification of the sixth index starts here.
+        boost::multi_index::hashed_non_unique<
+            boost::multi_index::tag<ExpirationWheelIndexTag<2> >,
+            boost::multi_index::composite_key<
+                Lease4,
+                boost::multi_index::const_mem_fun<Lease, bool,
+                                                  &Lease::stateExpiredReclaimed>,
+                // Level 2 bucket of the lease expiration time.
+                ExpirationWheelBucket<2>
+            >
+        >,
+
+        // Specification of the seventh index starts here.
+        // This index sorts leases by SubnetID and then by address so
+        // the leases of a subnet can be paged in the address order.
         boost::multi_index::ordered_non_unique<
             boost::multi_index::tag<SubnetIdIndexTag>,
-            boost::multi_index::member<Lease, isc::dhcp::SubnetID, &Lease::subnet_id_>
+            boost::multi_index::composite_key<
+                Lease4,
+                boost::multi_index::member<Lease, isc::dhcp::SubnetID,
+                                           &Lease::subnet_id_>,
+                boost::multi_index::member<Lease, isc::asiolink::IOAddress,
+                                           &Lease::addr_>
+            >
         >,
 
-        // Specification of the sixth index starts here.
+        // Specification of the eighth index starts here.
         // This index is used to retrieve leases for matching hostname.
         boost::multi_index::ordered_non_unique<
             boost::multi_index::tag<HostnameIndexTag>,
             boost::multi_index::member<Lease, std::string, &Lease::hostname_>
-        >,
+        >
+    >
+> Lease4Storage; // Specify the type name for this container.
 
-        // Specification of the seventh index starts here.
+/// @brief A multi index container holding DHCPv4 leases with a relay id
+/// or a remote id for Bulk Lease Query.
+///
+/// Only the leases with a relay id or a remote id are held, so the other
+/// leases take no room in these indexes.
+///
+/// The leases in the container may be accessed using different indexes:
+/// - using remote id.
+/// - using a composite index: relay id and IPv4 address.
+typedef boost::multi_index_container<
+    // It holds pointers to Lease4 objects.
+    Lease4Ptr,
+    boost::multi_index::indexed_by<
+        // Specification of the first index starts here.
         // This index is used to retrieve leases for matching remote id
         // for Bulk Lease Query.
         boost::multi_index::hashed_non_unique<
@@ -256,7 +355,7 @@ typedef boost::multi_index_container<
                                        &Lease4::remote_id_>
         >,
 
-        // Specification of the eighth index starts here.
+        // Specification of the second index starts here.
         // This index is used to retrieve leases for matching relay id
         // for Bulk Lease Query.
         boost::multi_index::ordered_non_unique<
@@ -274,7 +373,7 @@ typedef boost::multi_index_container<
             >
         >
     >
-> Lease4Storage; // Specify the type name for this container.
+> Lease4ExtendedInfoTable;
 
 //@}
 
@@ -303,8 +402,12 @@ typedef Lease6Storage::index<HostnameIndexTag>::type Lease6StorageHostnameIndex;
 /// @brief DHCPv4 lease storage index by address.
 typedef Lease4Storage::index<AddressIndexTag>::type Lease4StorageAddressIndex;
 
-/// @brief DHCPv4 lease storage index by expiration time.
-typedef Lease4Storage::index<ExpirationIndexTag>::type Lease4StorageExpirationIndex;
+/// @brief DHCPv4 lease storage index by expiration timing wheel bucket.
+///
+/// @tparam Level The level of the timing wheel.
+template<unsigned Level>
+using Lease4StorageExpirationWheelIndex =
+    typename Lease4Storage::index<ExpirationWheelIndexTag<Level> >::type;
 
 /// @brief DHCPv4 lease storage index by HW address and subnet identifier.
 typedef Lease4Storage::index<HWAddressSubnetIdIndexTag>::type
@@ -320,15 +423,18 @@ typedef Lease4Storage::index<SubnetIdIndexTag>::type Lease4StorageSubnetIdIndex;
 /// @brief DHCPv4 lease storage index by hostname.
 typedef Lease4Storage::index<HostnameIndexTag>::type Lease4StorageHostnameIndex;
 
-/// @brief DHCPv4 lease storage index by remote identifier.
-typedef Lease4Storage::index<RemoteIdIndexTag>::type Lease4StorageRemoteIdIndex;
+/// @brief DHCPv4 lease extended info index by remote identifier.
+typedef Lease4ExtendedInfoTable::index<RemoteIdIndexTag>::type
+Lease4ExtendedInfoRemoteIdIndex;
 
-/// @brief DHCPv4 lease storage range by remote identifier.
-typedef std::pair<Lease4StorageRemoteIdIndex::const_iterator,
-                  Lease4StorageRemoteIdIndex::const_iterator> Lease4StorageRemoteIdRange;
+/// @brief DHCPv4 lease extended info range by remote identifier.
+typedef std::pair<Lease4ExtendedInfoRemoteIdIndex::const_iterator,
+                  Lease4ExtendedInfoRemoteIdIndex::const_iterator>
+Lease4ExtendedInfoRemoteIdRange;
 
-/// @brief DHCPv4 lease storage index by relay identifier.
-typedef Lease4Storage::index<RelayIdIndexTag>::type Lease4StorageRelayIdIndex;
+/// @brief DHCPv4 lease extended info index by relay identifier.
+typedef Lease4ExtendedInfoTable::index<RelayIdIndexTag>::type
+Lease4ExtendedInfoRelayIdIndex;
 
 //@}
 
@@ -33,6 +33,7 @@
 #include <mysqld_error.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <mutex>
 #include <string>
 
@@ -2041,6 +2042,8 @@ public:
         GET_HOST_ADDR,             // Gets hosts by IPv4 address
         GET_HOST_SUBID4_DHCPID,    // Gets host by IPv4 SubnetID, HW address/DUID
         GET_HOST_SUBID6_DHCPID,    // Gets host by IPv6 SubnetID, HW address/DUID
+        GET_HOST_SUBID4_DHCPIDS,   // Gets hosts by IPv4 SubnetID and identifiers
+        GET_HOST_SUBID6_DHCPIDS,   // Gets hosts by IPv6 SubnetID and identifiers
         GET_HOST_SUBID_ADDR,       // Gets host by IPv4 SubnetID and IPv4 address
         GET_HOST_PREFIX,           // Gets host by IPv6 prefix
         GET_HOST_SUBID6_ADDR,      // Gets host by IPv6 SubnetID and IPv6 prefix
@@ -2073,6 +2076,10 @@ public:
     /// such as INSERT, DELETE, UPDATE.
     static const StatementIndex WRITE_STMTS_BEGIN = INSERT_HOST_NON_UNIQUE_IP;
 
+    /// @brief Number of identifiers looked for by the GET_HOST_SUBID4_DHCPIDS
+    /// and GET_HOST_SUBID6_DHCPIDS statements.
+    static const size_t MAX_IDENTIFIERS = Host::LAST_IDENTIFIER_TYPE + 1;
+
     /// @brief Constructor.
     ///
     /// This constructor opens database connection and initializes prepared
@@ -2191,6 +2198,14 @@ public:
                     const ConstCfgOptionPtr& options_cfg,
                     const uint64_t host_id);
 
+    /// @brief Inserts a host with its options and IPv6 reservations.
+    ///
+    /// The caller is in charge of the transaction.
+    ///
+    /// @param ctx Context
+    /// @param host Pointer to the new @c Host object being added.
+    void addHost(MySqlHostContextPtr& ctx, const HostPtr& host);
+
     /// @brief Check Error and Throw Exception
     ///
     /// This method invokes @ref db::MySqlConnection::checkError.
@@ -2257,6 +2272,24 @@ public:
                          StatementIndex stindex,
                          boost::shared_ptr<MySqlHostExchange> exchange) const;
 
+    /// @brief Retrieves the hosts connected to a subnet using any of the
+    /// identifiers.
+    ///
+    /// @param ctx Context
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Identifiers, not more than @c MAX_IDENTIFIERS.
+    /// @param stindex Statement index.
+    /// @param exchange Pointer to the exchange object used for the
+    /// particular query.
+    ///
+    /// @return Collection of const @c Host objects.
+    ConstHostCollection
+    getHostsByIdentifiers(MySqlHostContextPtr& ctx,
+                          const SubnetID& subnet_id,
+                          const HostIdentifierList& identifiers,
+                          StatementIndex stindex,
+                          boost::shared_ptr<MySqlHostExchange> exchange) const;
+
     /// @brief Throws exception if database is read only.
     ///
     /// This method should be called by the methods which write to the
@@ -2380,6 +2413,55 @@ TaggedStatementArray tagged_statements = { {
                 "AND h.dhcp_identifier = ? "
             "ORDER BY h.host_id, o.option_id, r.reservation_id"},
 
+    // Retrieves host information and DHCPv4 options using subnet identifier
+    // and any of the client's identifiers. The unused identifier slots must
+    // repeat one of the identifiers.
+    {MySqlHostDataSourceImpl::GET_HOST_SUBID4_DHCPIDS,
+            "SELECT h.host_id, h.dhcp_identifier, h.dhcp_identifier_type, "
+                "h.dhcp4_subnet_id, h.dhcp6_subnet_id, h.ipv4_address, h.hostname, "
+                "h.dhcp4_client_classes, h.dhcp6_client_classes, h.user_context, "
+                "h.dhcp4_next_server, h.dhcp4_server_hostname, "
+                "h.dhcp4_boot_file_name, h.auth_key, "
+                "o.option_id, o.code, o.value, o.formatted_value, o.space, "
+                "o.persistent, o.cancelled, o.user_context "
+            "FROM hosts AS h "
+            "LEFT JOIN dhcp4_options AS o "
+                "ON h.host_id = o.host_id "
+            "WHERE h.dhcp4_subnet_id = ? "
+                "AND ((h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) "
+                "OR (h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) "
+                "OR (h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) "
+                "OR (h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) "
+                "OR (h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?)) "
+            "ORDER BY h.host_id, o.option_id"},
+
+    // Retrieves host information, IPv6 reservations and DHCPv6 options
+    // using subnet identifier and any of the client's identifiers. The
+    // unused identifier slots must repeat one of the identifiers.
+    {MySqlHostDataSourceImpl::GET_HOST_SUBID6_DHCPIDS,
+            "SELECT h.host_id, h.dhcp_identifier, "
+                "h.dhcp_identifier_type, h.dhcp4_subnet_id, "
+                "h.dhcp6_subnet_id, h.ipv4_address, h.hostname, "
+                "h.dhcp4_client_classes, h.dhcp6_client_classes, h.user_context, "
+                "h.dhcp4_next_server, h.dhcp4_server_hostname, "
+                "h.dhcp4_boot_file_name, h.auth_key, "
+                "o.option_id, o.code, o.value, o.formatted_value, o.space, "
+                "o.persistent, o.cancelled, o.user_context, "
+                "r.reservation_id, r.address, r.prefix_len, r.type, "
+                "r.dhcp6_iaid "
+            "FROM hosts AS h "
+            "LEFT JOIN dhcp6_options AS o "
+                "ON h.host_id = o.host_id "
+            "LEFT JOIN ipv6_reservations AS r "
+                "ON h.host_id = r.host_id "
+            "WHERE h.dhcp6_subnet_id = ? "
+                "AND ((h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) "
+                "OR (h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) "
+                "OR (h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) "
+                "OR (h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) "
+                "OR (h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?)) "
+            "ORDER BY h.host_id, o.option_id, r.reservation_id"},
+
     // Retrieves host information and DHCPv4 options for the host using subnet
     // identifier and IPv4 reservation. Left joining the dhcp4_options table
     // results in multiple rows being returned for the host. The number of
@@ -3055,6 +3137,49 @@ MySqlHostDataSourceImpl::addOptions(MySqlHostContextPtr& ctx,
     }
 }
 
+void
+MySqlHostDataSourceImpl::addHost(MySqlHostContextPtr& ctx, const HostPtr& host) {
+    // If we're configured to check that an IP reservation within a given subnet
+    // is unique, the IP reservation exists and the subnet is actually set
+    // we will be using a special query that checks for uniqueness. Otherwise,
+    // we will use a regular insert statement.
+    bool unique_ip = ip_reservations_unique_ && !host->getIPv4Reservation().isV4Zero()
+        && host->getIPv4SubnetID() != SUBNET_ID_UNUSED;
+
+    // Create the MYSQL_BIND array for the host
+    std::vector<MYSQL_BIND> bind = ctx->host_ipv4_exchange_->createBindForSend(host, unique_ip);
+
+    // ... and insert the host.
+    addStatement(ctx, unique_ip ? INSERT_HOST_UNIQUE_IP :
+                 INSERT_HOST_NON_UNIQUE_IP, bind);
+
+    // Gets the last inserted hosts id
+    uint64_t host_id = mysql_insert_id(ctx->conn_.mysql_);
+
+    // Insert DHCPv4 options.
+    ConstCfgOptionPtr cfg_option4 = host->getCfgOption4();
+    if (cfg_option4) {
+        addOptions(ctx, INSERT_V4_HOST_OPTION,
+                   cfg_option4, host_id);
+    }
+
+    // Insert DHCPv6 options.
+    ConstCfgOptionPtr cfg_option6 = host->getCfgOption6();
+    if (cfg_option6) {
+        addOptions(ctx, INSERT_V6_HOST_OPTION,
+                   cfg_option6, host_id);
+    }
+
+    // Insert IPv6 reservations.
+    IPv6ResrvRange v6resv = host->getIPv6Reservations();
+    if (std::distance(v6resv.first, v6resv.second) > 0) {
+        for (IPv6ResrvIterator resv = v6resv.first; resv != v6resv.second;
+             ++resv) {
+            addResv(ctx, resv->second, host_id);
+        }
+    }
+}
+
 void
 MySqlHostDataSourceImpl::checkError(MySqlHostContextPtr& ctx,
                                     const int status,
@@ -3172,6 +3297,61 @@ MySqlHostDataSourceImpl::getHost(MySqlHostContextPtr& ctx,
     return (result);
 }
 
+ConstHostCollection
+MySqlHostDataSourceImpl::getHostsByIdentifiers(MySqlHostContextPtr& ctx,
+                                               const SubnetID& subnet_id,
+                                               const HostIdentifierList& identifiers,
+                                               StatementIndex stindex,
+                                               boost::shared_ptr<MySqlHostExchange> exchange) const {
+    if (identifiers.empty() || (identifiers.size() > MAX_IDENTIFIERS)) {
+        isc_throw(BadValue, "expected 1 to " << MAX_IDENTIFIERS
+                  << " identifiers, got " << identifiers.size());
+    }
+
+    // Set up the WHERE clause value
+    MYSQL_BIND inbind[1 + 2 * MAX_IDENTIFIERS];
+    memset(inbind, 0, sizeof(inbind));
+
+    uint32_t subnet_buffer = static_cast<uint32_t>(subnet_id);
+    inbind[0].buffer_type = MYSQL_TYPE_LONG;
+    inbind[0].buffer = reinterpret_cast<char*>(&subnet_buffer);
+    inbind[0].is_unsigned = MLM_TRUE;
+
+    // Identifier types and values, the unused slots repeating the last
+    // identifier.
+    char identifier_types[MAX_IDENTIFIERS];
+    std::vector<char> identifier_vecs[MAX_IDENTIFIERS];
+    unsigned long lengths[MAX_IDENTIFIERS];
+    auto identifier = identifiers.begin();
+    for (size_t i = 0; i < MAX_IDENTIFIERS; ++i) {
+        if (identifier != identifiers.end()) {
+            identifier_types[i] = static_cast<char>(identifier->first);
+            identifier_vecs[i].assign(identifier->second.begin(),
+                                      identifier->second.end());
+            ++identifier;
+        } else {
+            identifier_types[i] = identifier_types[i - 1];
+            identifier_vecs[i] = identifier_vecs[i - 1];
+        }
+        lengths[i] = identifier_vecs[i].size();
+
+        MYSQL_BIND& type_bind = inbind[1 + 2 * i];
+        type_bind.buffer_type = MYSQL_TYPE_TINY;
+        type_bind.buffer = &identifier_types[i];
+        type_bind.is_unsigned = MLM_TRUE;
+
+        MYSQL_BIND& value_bind = inbind[2 + 2 * i];
+        value_bind.buffer_type = MYSQL_TYPE_BLOB;
+        value_bind.buffer = &identifier_vecs[i][0];
+        value_bind.buffer_length = lengths[i];
+        value_bind.length = &lengths[i];
+    }
+
+    ConstHostCollection collection;
+    getHostCollection(ctx, stindex, inbind, exchange, collection, false);
+    return (collection);
+}
+
 void
 MySqlHostDataSourceImpl::checkReadOnly(MySqlHostContextPtr& ctx) const {
     if (ctx->is_readonly_) {
@@ -3207,48 +3387,31 @@ MySqlHostDataSource::add(const HostPtr& host) {
     // the MySqlTransaction class.
     MySqlTransaction transaction(ctx->conn_);
 
-    // If we're configured to check that an IP reservation within a given subnet
-    // is unique, the IP reservation exists and the subnet is actually set
-    // we will be using a special query that checks for uniqueness. Otherwise,
-    // we will use a regular insert statement.
-    bool unique_ip = impl_->ip_reservations_unique_ && !host->getIPv4Reservation().isV4Zero()
-        && host->getIPv4SubnetID() != SUBNET_ID_UNUSED;
-
-    // Create the MYSQL_BIND array for the host
-    std::vector<MYSQL_BIND> bind = ctx->host_ipv4_exchange_->createBindForSend(host, unique_ip);
+    impl_->addHost(ctx, host);
 
-    // ... and insert the host.
-    impl_->addStatement(ctx, unique_ip ? MySqlHostDataSourceImpl::INSERT_HOST_UNIQUE_IP :
-                        MySqlHostDataSourceImpl::INSERT_HOST_NON_UNIQUE_IP, bind);
-
-    // Gets the last inserted hosts id
-    uint64_t host_id = mysql_insert_id(ctx->conn_.mysql_);
+    // Everything went fine, so explicitly commit the transaction.
+    transaction.commit();
+}
 
-    // Insert DHCPv4 options.
-    ConstCfgOptionPtr cfg_option4 = host->getCfgOption4();
-    if (cfg_option4) {
-        impl_->addOptions(ctx, MySqlHostDataSourceImpl::INSERT_V4_HOST_OPTION,
-                          cfg_option4, host_id);
-    }
+void
+MySqlHostDataSource::addHosts(const HostCollection& hosts) {
+    // Get a context
+    MySqlHostContextAlloc get_context(*impl_);
+    MySqlHostContextPtr ctx = get_context.ctx_;
 
-    // Insert DHCPv6 options.
-    ConstCfgOptionPtr cfg_option6 = host->getCfgOption6();
-    if (cfg_option6) {
-        impl_->addOptions(ctx, MySqlHostDataSourceImpl::INSERT_V6_HOST_OPTION,
-                          cfg_option6, host_id);
-    }
+    // If operating in read-only mode, throw exception.
+    impl_->checkReadOnly(ctx);
 
-    // Insert IPv6 reservations.
-    IPv6ResrvRange v6resv = host->getIPv6Reservations();
-    if (std::distance(v6resv.first, v6resv.second) > 0) {
-        for (IPv6ResrvIterator resv = v6resv.first; resv != v6resv.second;
-             ++resv) {
-            impl_->addResv(ctx, resv->second, host_id);
+    // Insert the hosts by batches, each in its own transaction, so a
+    // bulk import does not pay for one commit per host.
+    for (size_t first = 0; first < hosts.size(); first += HOSTS_BATCH_SIZE) {
+        size_t last = std::min(hosts.size(), first + HOSTS_BATCH_SIZE);
+        MySqlTransaction transaction(ctx->conn_);
+        for (size_t i = first; i < last; ++i) {
+            impl_->addHost(ctx, hosts[i]);
         }
+        transaction.commit();
     }
-
-    // Everything went fine, so explicitly commit the transaction.
-    transaction.commit();
 }
 
 bool
@@ -3716,6 +3879,25 @@ MySqlHostDataSource::get4(const SubnetID& subnet_id,
                            ctx->host_ipv4_exchange_));
 }
 
+ConstHostCollection
+MySqlHostDataSource::getAllbyIdentifiers4(const SubnetID& subnet_id,
+                                         const HostIdentifierList& identifiers) const {
+    if (identifiers.empty()) {
+        return (ConstHostCollection());
+    }
+    if (identifiers.size() > MySqlHostDataSourceImpl::MAX_IDENTIFIERS) {
+        return (BaseHostDataSource::getAllbyIdentifiers4(subnet_id, identifiers));
+    }
+
+    // Get a context
+    MySqlHostContextAlloc get_context(*impl_);
+    MySqlHostContextPtr ctx = get_context.ctx_;
+
+    return (impl_->getHostsByIdentifiers(ctx, subnet_id, identifiers,
+                                         MySqlHostDataSourceImpl::GET_HOST_SUBID4_DHCPIDS,
+                                         ctx->host_ipv4_exchange_));
+}
+
 ConstHostPtr
 MySqlHostDataSource::get4(const SubnetID& subnet_id,
                           const asiolink::IOAddress& address) const {
@@ -3799,6 +3981,25 @@ MySqlHostDataSource::get6(const SubnetID& subnet_id,
                            ctx->host_ipv6_exchange_));
 }
 
+ConstHostCollection
+MySqlHostDataSource::getAllbyIdentifiers6(const SubnetID& subnet_id,
+                                         const HostIdentifierList& identifiers) const {
+    if (identifiers.empty()) {
+        return (ConstHostCollection());
+    }
+    if (identifiers.size() > MySqlHostDataSourceImpl::MAX_IDENTIFIERS) {
+        return (BaseHostDataSource::getAllbyIdentifiers6(subnet_id, identifiers));
+    }
+
+    // Get a context
+    MySqlHostContextAlloc get_context(*impl_);
+    MySqlHostContextPtr ctx = get_context.ctx_;
+
+    return (impl_->getHostsByIdentifiers(ctx, subnet_id, identifiers,
+                                         MySqlHostDataSourceImpl::GET_HOST_SUBID6_DHCPIDS,
+                                         ctx->host_ipv6_exchange_));
+}
+
 ConstHostPtr
 MySqlHostDataSource::get6(const asiolink::IOAddress& prefix,
                           const uint8_t prefix_len) const {
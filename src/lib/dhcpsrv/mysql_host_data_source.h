@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -89,6 +89,18 @@ public:
     /// @param host Pointer to the new @c Host object being added.
     virtual void add(const HostPtr& host);
 
+    /// @brief Adds a collection of new hosts.
+    ///
+    /// The hosts are inserted by batches of @c HOSTS_BATCH_SIZE, each
+    /// batch in its own transaction. When a host can't be inserted the
+    /// exception is propagated, the batch of this host is rolled back
+    /// and the hosts of the previous batches stay in the database.
+    ///
+    /// @param hosts Collection of the new @c Host objects being added.
+    /// @throw DuplicateEntry or DbOperationError dependent on the constraint
+    /// violation
+    virtual void addHosts(const HostCollection& hosts);
+
     /// @brief Attempts to delete hosts by (subnet-id, address)
     ///
     /// This method supports both v4 and v6.
@@ -296,6 +308,20 @@ public:
                               const uint8_t* identifier_begin,
                               const size_t identifier_len) const;
 
+    /// @brief Returns the hosts connected to the IPv4 subnet using any of
+    /// the identifiers.
+    ///
+    /// Looks for all identifiers with a single query when there are not
+    /// more identifiers than identifier types.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Identifiers to look for.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAllbyIdentifiers4(const SubnetID& subnet_id,
+                         const HostIdentifierList& identifiers) const;
+
     /// @brief Returns a host connected to the IPv4 subnet and having
     /// a reservation for a specified IPv4 address.
     ///
@@ -357,6 +383,20 @@ public:
                               const uint8_t* identifier_begin,
                               const size_t identifier_len) const;
 
+    /// @brief Returns the hosts connected to the IPv6 subnet using any of
+    /// the identifiers.
+    ///
+    /// Looks for all identifiers with a single query when there are not
+    /// more identifiers than identifier types.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Identifiers to look for.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAllbyIdentifiers6(const SubnetID& subnet_id,
+                         const HostIdentifierList& identifiers) const;
+
     /// @brief Returns a host using the specified IPv6 prefix.
     ///
     /// @param prefix IPv6 prefix for which the @c Host object is searched.
@@ -107,11 +107,19 @@ tagged_statements = { {
     {MySqlLeaseMgr::DELETE_LEASE4_STATE_EXPIRED,
                     "DELETE FROM lease4 "
                         "WHERE state = ? AND expire < ?"},
+    {MySqlLeaseMgr::DELETE_LEASE4_SUBID,
+                    "DELETE FROM lease4 WHERE subnet_id = ?"},
+    {MySqlLeaseMgr::DELETE_LEASE4_ALL,
+                    "DELETE FROM lease4"},
     {MySqlLeaseMgr::DELETE_LEASE6,
                     "DELETE FROM lease6 WHERE address = ? AND expire = ?"},
     {MySqlLeaseMgr::DELETE_LEASE6_STATE_EXPIRED,
                     "DELETE FROM lease6 "
                         "WHERE state = ? AND expire < ?"},
+    {MySqlLeaseMgr::DELETE_LEASE6_SUBID,
+                    "DELETE FROM lease6 WHERE subnet_id = ?"},
+    {MySqlLeaseMgr::DELETE_LEASE6_ALL,
+                    "DELETE FROM lease6"},
     {MySqlLeaseMgr::GET_LEASE4,
                     "SELECT address, hwaddr, client_id, "
                         "valid_lifetime, expire, subnet_id, "
@@ -437,6 +445,31 @@ tagged_statements = { {
                     "SELECT leases "
                         "FROM lease6_stat_by_client_class "
                         "WHERE client_class = ? AND lease_type = ?"},
+    {MySqlLeaseMgr::GET_LEASE4_EXPIRE_FOR_UPDATE,
+                    "SELECT address, hwaddr, client_id, "
+                        "valid_lifetime, expire, subnet_id, "
+                        "fqdn_fwd, fqdn_rev, hostname, "
+                        "state, user_context, relay_id, remote_id "
+                            "FROM lease4 "
+                            "WHERE state != ? "
+                            "AND valid_lifetime != 4294967295 "
+                            "AND expire < ? "
+                            "ORDER BY expire ASC, address ASC "
+                            "LIMIT ? "
+                            "FOR UPDATE"},
+    {MySqlLeaseMgr::RECLAIM_LEASE4_EXPIRE,
+                    "UPDATE lease4 SET "
+                        "state = ?, hostname = '', fqdn_fwd = 0, fqdn_rev = 0 "
+                            "WHERE state != ? "
+                            "AND valid_lifetime != 4294967295 "
+                            "AND expire < ? "
+                            "AND (expire, address) <= (?, ?)"},
+    {MySqlLeaseMgr::DELETE_LEASE4_EXPIRE,
+                    "DELETE FROM lease4 "
+                        "WHERE state != ? "
+                        "AND valid_lifetime != 4294967295 "
+                        "AND expire < ? "
+                        "AND (expire, address) <= (?, ?)"},
 } };  // tagged_statements
 
 }  // namespace
@@ -1936,10 +1969,11 @@ MySqlLeaseMgr::MySqlLeaseContextAlloc::MySqlLeaseContextAlloc(
         // multi-threaded
         {
             // we need to protect the whole pool_ operation, hence extra scope {}
-            lock_guard<mutex> lock(mgr_.pool_->mutex_);
-            if (!mgr_.pool_->pool_.empty()) {
-                ctx_ = mgr_.pool_->pool_.back();
-                mgr_.pool_->pool_.pop_back();
+            MySqlLeaseContextPoolPtr pool = mgr_.getContextPool();
+            lock_guard<mutex> lock(pool->mutex_);
+            if (!pool->pool_.empty()) {
+                ctx_ = pool->pool_.back();
+                pool->pool_.pop_back();
             }
         }
         if (!ctx_) {
@@ -1957,8 +1991,9 @@ MySqlLeaseMgr::MySqlLeaseContextAlloc::MySqlLeaseContextAlloc(
 MySqlLeaseMgr::MySqlLeaseContextAlloc::~MySqlLeaseContextAlloc() {
     if (MultiThreadingMgr::instance().getMode()) {
         // multi-threaded
-        lock_guard<mutex> lock(mgr_.pool_->mutex_);
-        mgr_.pool_->pool_.push_back(ctx_);
+        MySqlLeaseContextPoolPtr pool = mgr_.getContextPool();
+        lock_guard<mutex> lock(pool->mutex_);
+        pool->pool_.push_back(ctx_);
     }
     // If running in single-threaded mode, there's nothing to do here.
 }
@@ -1968,17 +2003,25 @@ MySqlLeaseMgr::MySqlLeaseContextAlloc::~MySqlLeaseContextAlloc() {
 MySqlLeaseMgr::MySqlLeaseTrackingContextAlloc::MySqlLeaseTrackingContextAlloc(
     MySqlLeaseMgr& mgr, const LeasePtr& lease) : ctx_(), mgr_(mgr), lease_(lease) {
 
+    // Don't overtake the asynchronous changes submitted by this thread.
+    mgr_.waitForAsync();
+
     if (MultiThreadingMgr::instance().getMode()) {
         // multi-threaded
         {
-            // we need to protect the whole pool_ operation, hence extra scope {}
+            // The lease locks are protected by the mutex of the shared pool.
             lock_guard<mutex> lock(mgr_.pool_->mutex_);
             if (mgr_.hasCallbacks() && !mgr_.tryLock(lease)) {
                 isc_throw(DbOperationError, "unable to lock the lease " << lease->addr_);
             }
-            if (!mgr_.pool_->pool_.empty()) {
-                ctx_ = mgr_.pool_->pool_.back();
-                mgr_.pool_->pool_.pop_back();
+        }
+        {
+            // we need to protect the whole pool_ operation, hence extra scope {}
+            MySqlLeaseContextPoolPtr pool = mgr_.getContextPool();
+            lock_guard<mutex> lock(pool->mutex_);
+            if (!pool->pool_.empty()) {
+                ctx_ = pool->pool_.back();
+                pool->pool_.pop_back();
             }
         }
         if (!ctx_) {
@@ -1996,11 +2039,16 @@ MySqlLeaseMgr::MySqlLeaseTrackingContextAlloc::MySqlLeaseTrackingContextAlloc(
 MySqlLeaseMgr::MySqlLeaseTrackingContextAlloc::~MySqlLeaseTrackingContextAlloc() {
     if (MultiThreadingMgr::instance().getMode()) {
         // multi-threaded
-        lock_guard<mutex> lock(mgr_.pool_->mutex_);
-        if (mgr_.hasCallbacks()) {
-            mgr_.unlock(lease_);
+        {
+            // The lease locks are protected by the mutex of the shared pool.
+            lock_guard<mutex> lock(mgr_.pool_->mutex_);
+            if (mgr_.hasCallbacks()) {
+                mgr_.unlock(lease_);
+            }
         }
-        mgr_.pool_->pool_.push_back(ctx_);
+        MySqlLeaseContextPoolPtr pool = mgr_.getContextPool();
+        lock_guard<mutex> lock(pool->mutex_);
+        pool->pool_.push_back(ctx_);
     }
     // If running in single-threaded mode, there's nothing to do here.
 }
@@ -2038,9 +2086,53 @@ MySqlLeaseMgr::MySqlLeaseMgr(const DatabaseConnection::ParameterMap& parameters)
     // Create an initial context.
     pool_.reset(new MySqlLeaseContextPool());
     pool_->pool_.push_back(createContext());
+
+    // Create the contexts of the packet processing threads in advance so
+    // the first packets do not wait for the connections to be opened and
+    // the statements to be prepared.
+    uint32_t pool_size = getPoolSize(parameters);
+    if (pool_size > 0) {
+        auto contexts = createContexts<MySqlLeaseContextPtr>(pool_size,
+            [this]() { return (createContext()); });
+        pool_->pool_.insert(pool_->pool_.end(), contexts.begin(),
+                            contexts.end());
+    }
+
+    // Start the threads executing the asynchronous lease operations.
+    startAsync(getAsyncThreads(parameters));
+
+    // Start the threads writing the leases for the packet processing threads
+    // with one context per writer thread.
+    uint32_t writer_threads = getWriterThreads(parameters);
+    writer_pool_.reset(new MySqlLeaseContextPool());
+    if (writer_threads > 0) {
+        auto contexts = createContexts<MySqlLeaseContextPtr>(writer_threads,
+            [this]() { return (createContext()); });
+        writer_pool_->pool_.insert(writer_pool_->pool_.end(), contexts.begin(),
+                                   contexts.end());
+    }
+    startWriters(writer_threads);
+
+    // Count the leases for the lease limits in memory.
+    if (getInMemoryLimits(parameters)) {
+        enableLimitCounter();
+    }
+
+    // Count the leases for the lease statistics in memory.
+    if (getInMemoryStats(parameters)) {
+        enableStatsCounter();
+    }
 }
 
 MySqlLeaseMgr::~MySqlLeaseMgr() {
+    // The asynchronous operations and the writer threads use the contexts.
+    stopWriters();
+    stopAsync();
+}
+
+MySqlLeaseContextPoolPtr
+MySqlLeaseMgr::getContextPool() const {
+    return (isWriterThread() ? writer_pool_ : pool_);
 }
 
 bool
@@ -2186,8 +2278,36 @@ MySqlLeaseMgr::addLeaseCommon(MySqlLeaseContextPtr& ctx,
     return (true);
 }
 
+bool
+MySqlLeaseMgr::addLeaseInternal(MySqlLeaseContextPtr& ctx,
+                                const Lease4Ptr& lease) {
+    // Create the MYSQL_BIND array for the lease
+    std::vector<MYSQL_BIND> bind = ctx->exchange4_->createBindForSend(lease);
+
+    // ... and drop to common code.
+    return (addLeaseCommon(ctx, INSERT_LEASE4, bind));
+}
+
+bool
+MySqlLeaseMgr::addLeaseInternal(MySqlLeaseContextPtr& ctx,
+                                const Lease6Ptr& lease) {
+    // Create the MYSQL_BIND array for the lease
+    std::vector<MYSQL_BIND> bind = ctx->exchange6_->createBindForSend(lease);
+
+    // ... and drop to common code.
+    return (addLeaseCommon(ctx, INSERT_LEASE6, bind));
+}
+
 bool
 MySqlLeaseMgr::addLease(const Lease4Ptr& lease) {
+    // Let a writer thread write the lease with its own context.
+    bool outcome = false;
+    if (delegateWrite(lease, [this, &lease]() {
+            return (addLease(lease));
+        }, outcome)) {
+        return (outcome);
+    }
+
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_ADD_ADDR4)
         .arg(lease->addr_.toText());
 
@@ -2195,11 +2315,7 @@ MySqlLeaseMgr::addLease(const Lease4Ptr& lease) {
     MySqlLeaseTrackingContextAlloc get_context(*this, lease);
     MySqlLeaseContextPtr ctx = get_context.ctx_;
 
-    // Create the MYSQL_BIND array for the lease
-    std::vector<MYSQL_BIND> bind = ctx->exchange4_->createBindForSend(lease);
-
-    // ... and drop to common code.
-    auto result = addLeaseCommon(ctx, INSERT_LEASE4, bind);
+    auto result = addLeaseInternal(ctx, lease);
 
     // Update lease current expiration time (allows update between the creation
     // of the Lease up to the point of insertion in the database).
@@ -2215,6 +2331,14 @@ MySqlLeaseMgr::addLease(const Lease4Ptr& lease) {
 
 bool
 MySqlLeaseMgr::addLease(const Lease6Ptr& lease) {
+    // Let a writer thread write the lease with its own context.
+    bool outcome = false;
+    if (delegateWrite(lease, [this, &lease]() {
+            return (addLease(lease));
+        }, outcome)) {
+        return (outcome);
+    }
+
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_ADD_ADDR6)
         .arg(lease->addr_.toText())
         .arg(lease->type_);
@@ -2223,11 +2347,7 @@ MySqlLeaseMgr::addLease(const Lease6Ptr& lease) {
     MySqlLeaseTrackingContextAlloc get_context(*this, lease);
     MySqlLeaseContextPtr ctx = get_context.ctx_;
 
-    // Create the MYSQL_BIND array for the lease
-    std::vector<MYSQL_BIND> bind = ctx->exchange6_->createBindForSend(lease);
-
-    // ... and drop to common code.
-    auto result = addLeaseCommon(ctx, INSERT_LEASE6, bind);
+    auto result = addLeaseInternal(ctx, lease);
 
     // Update lease current expiration time (allows update between the creation
     // of the Lease up to the point of insertion in the database).
@@ -3065,16 +3185,10 @@ MySqlLeaseMgr::updateLeaseCommon(MySqlLeaseContextPtr& ctx,
 }
 
 void
-MySqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
+MySqlLeaseMgr::updateLeaseInternal(MySqlLeaseContextPtr& ctx,
+                                   const Lease4Ptr& lease) {
     const StatementIndex stindex = UPDATE_LEASE4;
 
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_UPDATE_ADDR4)
-        .arg(lease->addr_.toText());
-
-    // Get a context
-    MySqlLeaseTrackingContextAlloc get_context(*this, lease);
-    MySqlLeaseContextPtr ctx = get_context.ctx_;
-
     // Create the MYSQL_BIND array for the data being updated
     std::vector<MYSQL_BIND> bind = ctx->exchange4_->createBindForSend(lease);
 
@@ -3106,6 +3220,27 @@ MySqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
 
     // Drop to common update code
     updateLeaseCommon(ctx, stindex, &bind[0], lease);
+}
+
+void
+MySqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
+    // Let a writer thread write the lease with its own context.
+    bool outcome = false;
+    if (delegateWrite(lease, [this, &lease]() {
+            updateLease4(lease);
+            return (true);
+        }, outcome)) {
+        return;
+    }
+
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_UPDATE_ADDR4)
+        .arg(lease->addr_.toText());
+
+    // Get a context
+    MySqlLeaseTrackingContextAlloc get_context(*this, lease);
+    MySqlLeaseContextPtr ctx = get_context.ctx_;
+
+    updateLeaseInternal(ctx, lease);
 
     // Update lease current expiration time.
     lease->updateCurrentExpirationTime();
@@ -3117,17 +3252,10 @@ MySqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
 }
 
 void
-MySqlLeaseMgr::updateLease6(const Lease6Ptr& lease) {
+MySqlLeaseMgr::updateLeaseInternal(MySqlLeaseContextPtr& ctx,
+                                   const Lease6Ptr& lease) {
     const StatementIndex stindex = UPDATE_LEASE6;
 
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_UPDATE_ADDR6)
-        .arg(lease->addr_.toText())
-        .arg(lease->type_);
-
-    // Get a context
-    MySqlLeaseTrackingContextAlloc get_context(*this, lease);
-    MySqlLeaseContextPtr ctx = get_context.ctx_;
-
     // Create the MYSQL_BIND array for the data being updated
     std::vector<MYSQL_BIND> bind = ctx->exchange6_->createBindForSend(lease);
 
@@ -3164,6 +3292,28 @@ MySqlLeaseMgr::updateLease6(const Lease6Ptr& lease) {
 
     // Drop to common update code
     updateLeaseCommon(ctx, stindex, &bind[0], lease);
+}
+
+void
+MySqlLeaseMgr::updateLease6(const Lease6Ptr& lease) {
+    // Let a writer thread write the lease with its own context.
+    bool outcome = false;
+    if (delegateWrite(lease, [this, &lease]() {
+            updateLease6(lease);
+            return (true);
+        }, outcome)) {
+        return;
+    }
+
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_UPDATE_ADDR6)
+        .arg(lease->addr_.toText())
+        .arg(lease->type_);
+
+    // Get a context
+    MySqlLeaseTrackingContextAlloc get_context(*this, lease);
+    MySqlLeaseContextPtr ctx = get_context.ctx_;
+
+    updateLeaseInternal(ctx, lease);
 
     // Update lease current expiration time.
     lease->updateCurrentExpirationTime();
@@ -3183,9 +3333,13 @@ uint64_t
 MySqlLeaseMgr::deleteLeaseCommon(MySqlLeaseContextPtr& ctx,
                                  StatementIndex stindex,
                                  MYSQL_BIND* bind) {
-    // Bind the input parameters to the statement
-    int status = mysql_stmt_bind_param(ctx->conn_.statements_[stindex], bind);
-    checkError(ctx, status, stindex, "unable to bind WHERE clause parameter");
+    int status;
+
+    if (bind) {
+        // Bind the input parameters to the statement
+        status = mysql_stmt_bind_param(ctx->conn_.statements_[stindex], bind);
+        checkError(ctx, status, stindex, "unable to bind WHERE clause parameter");
+    }
 
     // Execute
     status = MysqlExecuteStatement(ctx->conn_.statements_[stindex]);
@@ -3197,10 +3351,9 @@ MySqlLeaseMgr::deleteLeaseCommon(MySqlLeaseContextPtr& ctx,
 }
 
 bool
-MySqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
+MySqlLeaseMgr::deleteLeaseInternal(MySqlLeaseContextPtr& ctx,
+                                   const Lease4Ptr& lease) {
     const IOAddress& addr = lease->addr_;
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_DELETE_ADDR)
-        .arg(addr.toText());
 
     // Set up the WHERE clause value
     MYSQL_BIND inbind[2];
@@ -3225,17 +3378,10 @@ MySqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
     inbind[1].buffer = reinterpret_cast<char*>(&expire);
     inbind[1].buffer_length = sizeof(expire);
 
-    // Get a context
-    MySqlLeaseTrackingContextAlloc get_context(*this, lease);
-    MySqlLeaseContextPtr ctx = get_context.ctx_;
-
     auto affected_rows = deleteLeaseCommon(ctx, DELETE_LEASE4, inbind);
 
     // Check success case first as it is the most likely outcome.
     if (affected_rows == 1) {
-        if (hasCallbacks()) {
-            trackDeleteLease(lease, false);
-        }
         return (true);
     }
 
@@ -3251,12 +3397,38 @@ MySqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
 }
 
 bool
-MySqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
+MySqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
+    // Let a writer thread write the lease with its own context.
+    bool outcome = false;
+    if (delegateWrite(lease, [this, &lease]() {
+            return (deleteLease(lease));
+        }, outcome)) {
+        return (outcome);
+    }
+
     const IOAddress& addr = lease->addr_;
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
-              DHCPSRV_MYSQL_DELETE_ADDR)
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_DELETE_ADDR)
         .arg(addr.toText());
 
+    // Get a context
+    MySqlLeaseTrackingContextAlloc get_context(*this, lease);
+    MySqlLeaseContextPtr ctx = get_context.ctx_;
+
+    if (!deleteLeaseInternal(ctx, lease)) {
+        return (false);
+    }
+
+    if (hasCallbacks()) {
+        trackDeleteLease(lease, false);
+    }
+    return (true);
+}
+
+bool
+MySqlLeaseMgr::deleteLeaseInternal(MySqlLeaseContextPtr& ctx,
+                                   const Lease6Ptr& lease) {
+    const IOAddress& addr = lease->addr_;
+
     // Set up the WHERE clause value
     MYSQL_BIND inbind[2];
     memset(inbind, 0, sizeof(inbind));
@@ -3284,17 +3456,10 @@ MySqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
     inbind[1].buffer = reinterpret_cast<char*>(&expire);
     inbind[1].buffer_length = sizeof(expire);
 
-    // Get a context
-    MySqlLeaseTrackingContextAlloc get_context(*this, lease);
-    MySqlLeaseContextPtr ctx = get_context.ctx_;
-
     auto affected_rows = deleteLeaseCommon(ctx, DELETE_LEASE6, inbind);
 
     // Check success case first as it is the most likely outcome.
     if (affected_rows == 1) {
-        if (hasCallbacks()) {
-            trackDeleteLease(lease, false);
-        }
         return (true);
     }
 
@@ -3309,6 +3474,261 @@ MySqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
               "that had the address " << lease->addr_.toText());
 }
 
+bool
+MySqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
+    // Let a writer thread write the lease with its own context.
+    bool outcome = false;
+    if (delegateWrite(lease, [this, &lease]() {
+            return (deleteLease(lease));
+        }, outcome)) {
+        return (outcome);
+    }
+
+    const IOAddress& addr = lease->addr_;
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+              DHCPSRV_MYSQL_DELETE_ADDR)
+        .arg(addr.toText());
+
+    // Get a context
+    MySqlLeaseTrackingContextAlloc get_context(*this, lease);
+    MySqlLeaseContextPtr ctx = get_context.ctx_;
+
+    if (!deleteLeaseInternal(ctx, lease)) {
+        return (false);
+    }
+
+    if (hasCallbacks()) {
+        trackDeleteLease(lease, false);
+    }
+    return (true);
+}
+
+// Bulk lease methods. They perform the per lease statements in a single
+// transaction so the database commits the changes once. When callbacks
+// are installed the leases must be locked one by one so the per lease
+// methods are called instead.
+
+template <typename LeaseCollection>
+size_t
+MySqlLeaseMgr::addLeasesCommon(const LeaseCollection& leases) {
+    // Get a context
+    MySqlLeaseContextAlloc get_context(*this);
+    MySqlLeaseContextPtr ctx = get_context.ctx_;
+
+    LeaseCollection added;
+    MySqlTransaction transaction(ctx->conn_);
+    for (auto const& lease : leases) {
+        if (addLeaseInternal(ctx, lease)) {
+            added.push_back(lease);
+        }
+    }
+    transaction.commit();
+
+    // Update lease current expiration time only after the commit.
+    for (auto const& lease : added) {
+        lease->updateCurrentExpirationTime();
+    }
+    return (added.size());
+}
+
+template <typename LeaseCollection>
+size_t
+MySqlLeaseMgr::updateLeasesCommon(const LeaseCollection& leases) {
+    // Get a context
+    MySqlLeaseContextAlloc get_context(*this);
+    MySqlLeaseContextPtr ctx = get_context.ctx_;
+
+    LeaseCollection updated;
+    MySqlTransaction transaction(ctx->conn_);
+    for (auto const& lease : leases) {
+        try {
+            updateLeaseInternal(ctx, lease);
+            updated.push_back(lease);
+        } catch (const NoSuchLease&) {
+            // Skip the lease.
+        }
+    }
+    transaction.commit();
+
+    // Update lease current expiration time only after the commit.
+    for (auto const& lease : updated) {
+        lease->updateCurrentExpirationTime();
+    }
+    return (updated.size());
+}
+
+template <typename LeaseCollection>
+size_t
+MySqlLeaseMgr::deleteLeasesCommon(const LeaseCollection& leases) {
+    // Get a context
+    MySqlLeaseContextAlloc get_context(*this);
+    MySqlLeaseContextPtr ctx = get_context.ctx_;
+
+    size_t count = 0;
+    MySqlTransaction transaction(ctx->conn_);
+    for (auto const& lease : leases) {
+        if (deleteLeaseInternal(ctx, lease)) {
+            ++count;
+        }
+    }
+    transaction.commit();
+    return (count);
+}
+
+size_t
+MySqlLeaseMgr::addLeases4(const Lease4Collection& leases) {
+    if (leases.empty() || hasCallbacks()) {
+        return (LeaseMgr::addLeases4(leases));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_ADD_LEASES)
+        .arg(leases.size());
+    return (addLeasesCommon(leases));
+}
+
+size_t
+MySqlLeaseMgr::addLeases6(const Lease6Collection& leases) {
+    if (leases.empty() || hasCallbacks()) {
+        return (LeaseMgr::addLeases6(leases));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_ADD_LEASES)
+        .arg(leases.size());
+    return (addLeasesCommon(leases));
+}
+
+size_t
+MySqlLeaseMgr::updateLeases4(const Lease4Collection& leases) {
+    if (leases.empty() || hasCallbacks()) {
+        return (LeaseMgr::updateLeases4(leases));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_UPDATE_LEASES)
+        .arg(leases.size());
+    return (updateLeasesCommon(leases));
+}
+
+size_t
+MySqlLeaseMgr::updateLeases6(const Lease6Collection& leases) {
+    if (leases.empty() || hasCallbacks()) {
+        return (LeaseMgr::updateLeases6(leases));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_UPDATE_LEASES)
+        .arg(leases.size());
+    return (updateLeasesCommon(leases));
+}
+
+size_t
+MySqlLeaseMgr::deleteLeases4(const Lease4Collection& leases) {
+    if (leases.empty() || hasCallbacks()) {
+        return (LeaseMgr::deleteLeases4(leases));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_DELETE_LEASES)
+        .arg(leases.size());
+    return (deleteLeasesCommon(leases));
+}
+
+size_t
+MySqlLeaseMgr::deleteLeases6(const Lease6Collection& leases) {
+    if (leases.empty() || hasCallbacks()) {
+        return (LeaseMgr::deleteLeases6(leases));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_DELETE_LEASES)
+        .arg(leases.size());
+    return (deleteLeasesCommon(leases));
+}
+
+size_t
+MySqlLeaseMgr::reclaimExpiredLeases4(Lease4Collection& reclaimed_leases,
+                                     const size_t max_leases,
+                                     const bool remove_lease) {
+    if (hasCallbacks()) {
+        return (LeaseMgr::reclaimExpiredLeases4(reclaimed_leases, max_leases,
+                                                remove_lease));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_RECLAIM_EXPIRED4)
+        .arg(max_leases);
+
+    // Set up the WHERE clause values of the select.
+    MYSQL_BIND inbind[3];
+    memset(inbind, 0, sizeof(inbind));
+
+    // Exclude reclaimed leases.
+    uint32_t state = static_cast<uint32_t>(Lease::STATE_EXPIRED_RECLAIMED);
+    inbind[0].buffer_type = MYSQL_TYPE_LONG;
+    inbind[0].buffer = reinterpret_cast<char*>(&state);
+    inbind[0].is_unsigned = MLM_TRUE;
+
+    // Expiration timestamp, the same for both statements.
+    MYSQL_TIME expire_time;
+    MySqlConnection::convertToDatabaseTime(time(0), expire_time);
+    inbind[1].buffer_type = MYSQL_TYPE_TIMESTAMP;
+    inbind[1].buffer = reinterpret_cast<char*>(&expire_time);
+    inbind[1].buffer_length = sizeof(expire_time);
+
+    // If the number of leases is 0, we will reclaim all leases. This is
+    // achieved by setting the limit to a very high value.
+    uint32_t limit = max_leases > 0 ? static_cast<uint32_t>(max_leases) :
+        std::numeric_limits<uint32_t>::max();
+    inbind[2].buffer_type = MYSQL_TYPE_LONG;
+    inbind[2].buffer = reinterpret_cast<char*>(&limit);
+    inbind[2].is_unsigned = MLM_TRUE;
+
+    // Get a context
+    MySqlLeaseContextAlloc get_context(*this);
+    MySqlLeaseContextPtr ctx = get_context.ctx_;
+
+    // MySQL has no RETURNING clause: the batch is locked and returned by
+    // the select then reclaimed by a single statement bounded by the last
+    // lease of the batch, in the same transaction.
+    Lease4Collection expired_leases;
+    MySqlTransaction transaction(ctx->conn_);
+    getLeaseCollection(ctx, GET_LEASE4_EXPIRE_FOR_UPDATE, inbind, expired_leases);
+    if (expired_leases.empty()) {
+        transaction.commit();
+        return (0);
+    }
+
+    const Lease4Ptr& last = expired_leases.back();
+    MYSQL_TIME last_expire;
+    MySqlConnection::convertToDatabaseTime(last->cltt_, last->valid_lft_,
+                                           last_expire);
+    uint32_t last_addr4 = last->addr_.toUint32();
+
+    MYSQL_BIND bind[5];
+    memset(bind, 0, sizeof(bind));
+    size_t i = 0;
+    StatementIndex stindex = DELETE_LEASE4_EXPIRE;
+    if (!remove_lease) {
+        stindex = RECLAIM_LEASE4_EXPIRE;
+        // The new state.
+        bind[i].buffer_type = MYSQL_TYPE_LONG;
+        bind[i].buffer = reinterpret_cast<char*>(&state);
+        bind[i].is_unsigned = MLM_TRUE;
+        ++i;
+    }
+    bind[i].buffer_type = MYSQL_TYPE_LONG;
+    bind[i].buffer = reinterpret_cast<char*>(&state);
+    bind[i].is_unsigned = MLM_TRUE;
+    ++i;
+    bind[i].buffer_type = MYSQL_TYPE_TIMESTAMP;
+    bind[i].buffer = reinterpret_cast<char*>(&expire_time);
+    bind[i].buffer_length = sizeof(expire_time);
+    ++i;
+    bind[i].buffer_type = MYSQL_TYPE_TIMESTAMP;
+    bind[i].buffer = reinterpret_cast<char*>(&last_expire);
+    bind[i].buffer_length = sizeof(last_expire);
+    ++i;
+    bind[i].buffer_type = MYSQL_TYPE_LONG;
+    bind[i].buffer = reinterpret_cast<char*>(&last_addr4);
+    bind[i].is_unsigned = MLM_TRUE;
+
+    // The statement affects the rows locked by the select.
+    deleteLeaseCommon(ctx, stindex, bind);
+    transaction.commit();
+
+    reclaimed_leases.insert(reclaimed_leases.end(), expired_leases.begin(),
+                            expired_leases.end());
+    return (expired_leases.size());
+}
+
 uint64_t
 MySqlLeaseMgr::deleteExpiredReclaimedLeases4(const uint32_t secs) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_DELETE_EXPIRED_RECLAIMED4)
@@ -3337,8 +3757,9 @@ MySqlLeaseMgr::deleteExpiredReclaimedLeasesCommon(const uint32_t secs,
     inbind[0].is_unsigned = MLM_TRUE;
 
     // Expiration timestamp.
+    const time_t expire_limit = time(0) - static_cast<time_t>(secs);
     MYSQL_TIME expire_time;
-    MySqlConnection::convertToDatabaseTime(time(0) - static_cast<time_t>(secs), expire_time);
+    MySqlConnection::convertToDatabaseTime(expire_limit, expire_time);
     inbind[1].buffer_type = MYSQL_TYPE_TIMESTAMP;
     inbind[1].buffer = reinterpret_cast<char*>(&expire_time);
     inbind[1].buffer_length = sizeof(expire_time);
@@ -3352,6 +3773,9 @@ MySqlLeaseMgr::deleteExpiredReclaimedLeasesCommon(const uint32_t secs,
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_DELETED_EXPIRED_RECLAIMED)
         .arg(deleted_leases);
 
+    trackDeleteExpiredReclaimedLeases(statement_index == DELETE_LEASE4_STATE_EXPIRED ?
+                                      AF_INET : AF_INET6, expire_limit);
+
     return (deleted_leases);
 }
 
@@ -3386,11 +3810,17 @@ MySqlLeaseMgr::checkLimits(ConstElementPtr const& user_context, StatementIndex c
 
 string
 MySqlLeaseMgr::checkLimits4(ConstElementPtr const& user_context) const {
+    if (hasLimitCounter()) {
+        return (checkLimitsInMemory4(user_context));
+    }
     return checkLimits(user_context, CHECK_LEASE4_LIMITS);
 }
 
 string
 MySqlLeaseMgr::checkLimits6(ConstElementPtr const& user_context) const {
+    if (hasLimitCounter()) {
+        return (checkLimitsInMemory6(user_context));
+    }
     return checkLimits(user_context, CHECK_LEASE6_LIMITS);
 }
 
@@ -3419,6 +3849,10 @@ MySqlLeaseMgr::isJsonSupported() const {
 size_t
 MySqlLeaseMgr::getClassLeaseCount(const ClientClass& client_class,
                                   const Lease::Type& ltype /* = Lease::TYPE_V4*/) const {
+    if (hasLimitCounter()) {
+        return (limit_counter_->getClassCount(client_class, ltype));
+    }
+
     // Get a context.
     MySqlLeaseContextAlloc get_context(*this);
     MySqlLeaseContextPtr ctx = get_context.ctx_;
@@ -3448,16 +3882,28 @@ MySqlLeaseMgr::getClassLeaseCount(const ClientClass& client_class,
 
 void
 MySqlLeaseMgr::recountClassLeases4() {
+    if (hasLimitCounter()) {
+        recountLimitCounter(AF_INET);
+        return;
+    }
     isc_throw(NotImplemented, "MySqlLeaseMgr::recountClassLeases4() not implemented");
 }
 
 void
 MySqlLeaseMgr::recountClassLeases6() {
+    if (hasLimitCounter()) {
+        recountLimitCounter(AF_INET6);
+        return;
+    }
     isc_throw(NotImplemented, "MySqlLeaseMgr::recountClassLeases6() not implemented");
 }
 
 void
 MySqlLeaseMgr::clearClassLeaseCounts() {
+    if (hasLimitCounter()) {
+        limit_counter_->clear();
+        return;
+    }
     isc_throw(NotImplemented, "MySqlLeaseMgr::clearClassLeaseCounts() not implemented");
 }
 
@@ -3473,6 +3919,10 @@ MySqlLeaseMgr::writeLeases6(const std::string&) {
 
 LeaseStatsQueryPtr
 MySqlLeaseMgr::startLeaseStatsQuery4() {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET));
+    }
+
     // Get a context
     MySqlLeaseContextAlloc get_context(*this);
     MySqlLeaseContextPtr ctx = get_context.ctx_;
@@ -3486,6 +3936,10 @@ MySqlLeaseMgr::startLeaseStatsQuery4() {
 
 LeaseStatsQueryPtr
 MySqlLeaseMgr::startSubnetLeaseStatsQuery4(const SubnetID& subnet_id) {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET, subnet_id));
+    }
+
     // Get a context
     MySqlLeaseContextAlloc get_context(*this);
     MySqlLeaseContextPtr ctx = get_context.ctx_;
@@ -3501,6 +3955,10 @@ MySqlLeaseMgr::startSubnetLeaseStatsQuery4(const SubnetID& subnet_id) {
 LeaseStatsQueryPtr
 MySqlLeaseMgr::startSubnetRangeLeaseStatsQuery4(const SubnetID& first_subnet_id,
                                                 const SubnetID& last_subnet_id) {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET, first_subnet_id, last_subnet_id));
+    }
+
     // Get a context
     MySqlLeaseContextAlloc get_context(*this);
     MySqlLeaseContextPtr ctx = get_context.ctx_;
@@ -3516,6 +3974,10 @@ MySqlLeaseMgr::startSubnetRangeLeaseStatsQuery4(const SubnetID& first_subnet_id,
 
 LeaseStatsQueryPtr
 MySqlLeaseMgr::startLeaseStatsQuery6() {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET6));
+    }
+
     // Get a context
     MySqlLeaseContextAlloc get_context(*this);
     MySqlLeaseContextPtr ctx = get_context.ctx_;
@@ -3529,6 +3991,10 @@ MySqlLeaseMgr::startLeaseStatsQuery6() {
 
 LeaseStatsQueryPtr
 MySqlLeaseMgr::startSubnetLeaseStatsQuery6(const SubnetID& subnet_id) {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET6, subnet_id));
+    }
+
     // Get a context
     MySqlLeaseContextAlloc get_context(*this);
     MySqlLeaseContextPtr ctx = get_context.ctx_;
@@ -3544,6 +4010,10 @@ MySqlLeaseMgr::startSubnetLeaseStatsQuery6(const SubnetID& subnet_id) {
 LeaseStatsQueryPtr
 MySqlLeaseMgr::startSubnetRangeLeaseStatsQuery6(const SubnetID& first_subnet_id,
                                                 const SubnetID& last_subnet_id) {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET6, first_subnet_id, last_subnet_id));
+    }
+
     // Get a context
     MySqlLeaseContextAlloc get_context(*this);
     MySqlLeaseContextPtr ctx = get_context.ctx_;
@@ -3558,13 +4028,62 @@ MySqlLeaseMgr::startSubnetRangeLeaseStatsQuery6(const SubnetID& first_subnet_id,
 }
 
 size_t
-MySqlLeaseMgr::wipeLeases4(const SubnetID& /*subnet_id*/) {
-    isc_throw(NotImplemented, "wipeLeases4 is not implemented for MySQL backend");
+MySqlLeaseMgr::wipeLeases4(const SubnetID& subnet_id) {
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_MYSQL_WIPE_LEASES4)
+        .arg(subnet_id);
+
+    // The lease tracking needs the deleted leases.
+    if (hasCallbacks()) {
+        Lease4Collection leases;
+        if (subnet_id == 0) {
+            leases = getLeases4();
+        } else {
+            leases = getLeases4(subnet_id);
+        }
+        return (deleteLeases4(leases));
+    }
+    return (wipeLeasesCommon(subnet_id, subnet_id == 0 ?
+                             DELETE_LEASE4_ALL : DELETE_LEASE4_SUBID));
 }
 
 size_t
-MySqlLeaseMgr::wipeLeases6(const SubnetID& /*subnet_id*/) {
-    isc_throw(NotImplemented, "wipeLeases6 is not implemented for MySQL backend");
+MySqlLeaseMgr::wipeLeases6(const SubnetID& subnet_id) {
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_MYSQL_WIPE_LEASES6)
+        .arg(subnet_id);
+
+    // The lease tracking needs the deleted leases.
+    if (hasCallbacks()) {
+        Lease6Collection leases;
+        if (subnet_id == 0) {
+            leases = getLeases6();
+        } else {
+            leases = getLeases6(subnet_id);
+        }
+        return (deleteLeases6(leases));
+    }
+    return (wipeLeasesCommon(subnet_id, subnet_id == 0 ?
+                             DELETE_LEASE6_ALL : DELETE_LEASE6_SUBID));
+}
+
+uint64_t
+MySqlLeaseMgr::wipeLeasesCommon(const SubnetID& subnet_id,
+                                StatementIndex statement_index) {
+    // Set up the WHERE clause value
+    MYSQL_BIND inbind[1];
+    memset(inbind, 0, sizeof(inbind));
+
+    uint32_t subnet = static_cast<uint32_t>(subnet_id);
+    inbind[0].buffer_type = MYSQL_TYPE_LONG;
+    inbind[0].buffer = reinterpret_cast<char*>(&subnet);
+    inbind[0].is_unsigned = MLM_TRUE;
+
+    // Get a context
+    MySqlLeaseContextAlloc get_context(*this);
+    MySqlLeaseContextPtr ctx = get_context.ctx_;
+
+    // Deleting all leases takes no parameter.
+    return (deleteLeaseCommon(ctx, statement_index,
+                              subnet_id == 0 ? 0 : inbind));
 }
 
 // Miscellaneous database methods.
@@ -534,6 +534,88 @@ public:
     /// different expiration time.
     virtual bool deleteLease(const Lease6Ptr& lease) override;
 
+    /// @name Bulk lease operations.
+    ///
+    /// The statements are executed in a single transaction. When lease
+    /// callbacks are installed the per lease functions are called
+    /// instead.
+    ///@{
+
+    /// @brief Adds IPv4 leases.
+    ///
+    /// @param leases leases to be added.
+    ///
+    /// @return number of leases added.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed. No lease is added.
+    virtual size_t addLeases4(const Lease4Collection& leases) override;
+
+    /// @brief Adds IPv6 leases.
+    ///
+    /// @param leases leases to be added.
+    ///
+    /// @return number of leases added.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed. No lease is added.
+    virtual size_t addLeases6(const Lease6Collection& leases) override;
+
+    /// @brief Updates IPv4 leases.
+    ///
+    /// @param leases leases to be updated.
+    ///
+    /// @return number of leases updated.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed. No lease is updated.
+    virtual size_t updateLeases4(const Lease4Collection& leases) override;
+
+    /// @brief Updates IPv6 leases.
+    ///
+    /// @param leases leases to be updated.
+    ///
+    /// @return number of leases updated.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed. No lease is updated.
+    virtual size_t updateLeases6(const Lease6Collection& leases) override;
+
+    /// @brief Deletes IPv4 leases.
+    ///
+    /// @param leases leases to be deleted.
+    ///
+    /// @return number of leases deleted.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed. No lease is deleted.
+    virtual size_t deleteLeases4(const Lease4Collection& leases) override;
+
+    /// @brief Deletes IPv6 leases.
+    ///
+    /// @param leases leases to be deleted.
+    ///
+    /// @return number of leases deleted.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed. No lease is deleted.
+    virtual size_t deleteLeases6(const Lease6Collection& leases) override;
+
+    ///@}
+
+    /// @brief Reclaims a batch of expired DHCPv4 leases.
+    ///
+    /// The batch is selected and locked, then reclaimed by a single
+    /// statement in the same transaction.
+    ///
+    /// @param [out] reclaimed_leases A container to which the reclaimed
+    /// leases are added, as they were before the reclamation.
+    /// @param max_leases A maximum number of leases to be reclaimed. If this
+    /// value is set to 0, all expired (but not reclaimed) leases are
+    /// reclaimed.
+    /// @param remove_lease Delete the leases rather than setting their state
+    /// to expired-reclaimed.
+    /// @return Number of reclaimed leases.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual size_t reclaimExpiredLeases4(Lease4Collection& reclaimed_leases,
+                                         const size_t max_leases,
+                                         const bool remove_lease) override;
+
     /// @brief Deletes all expired-reclaimed DHCPv4 leases.
     ///
     /// @param secs Number of seconds since expiration of leases before
@@ -621,9 +703,10 @@ public:
     /// This rather dangerous method is able to remove all leases from specified
     /// subnet.
     ///
-    /// @todo: Not implemented yet.
+    /// The leases are deleted by a single statement, or fetched and deleted
+    /// in a single transaction when the deleted leases are tracked.
     ///
-    /// @param subnet_id identifier of the subnet
+    /// @param subnet_id identifier of the subnet (or 0 for all subnets)
     /// @return number of leases removed.
     virtual size_t wipeLeases4(const SubnetID& subnet_id) override;
 
@@ -632,9 +715,10 @@ public:
     /// This rather dangerous method is able to remove all leases from specified
     /// subnet.
     ///
-    /// @todo: Not implemented yet.
+    /// The leases are deleted by a single statement, or fetched and deleted
+    /// in a single transaction when the deleted leases are tracked.
     ///
-    /// @param subnet_id identifier of the subnet
+    /// @param subnet_id identifier of the subnet (or 0 for all subnets)
     /// @return number of leases removed.
     virtual size_t wipeLeases6(const SubnetID& subnet_id) override;
 
@@ -693,8 +777,12 @@ public:
     enum StatementIndex {
         DELETE_LEASE4,               // Delete from lease4 by address
         DELETE_LEASE4_STATE_EXPIRED, // Delete expired lease4 in a given state
+        DELETE_LEASE4_SUBID,         // Delete lease4 by subnet ID
+        DELETE_LEASE4_ALL,           // Delete all lease4
         DELETE_LEASE6,               // Delete from lease6 by address
         DELETE_LEASE6_STATE_EXPIRED, // Delete expired lease6 in a given state
+        DELETE_LEASE6_SUBID,         // Delete lease6 by subnet ID
+        DELETE_LEASE6_ALL,           // Delete all lease6
         GET_LEASE4,                  // Get all IPv4 leases
         GET_LEASE4_ADDR,             // Get lease4 by address
         GET_LEASE4_CLIENTID,         // Get lease4 by client ID
@@ -737,6 +825,9 @@ public:
         IS_JSON_SUPPORTED,           // Checks if JSON support is enabled in the database.
         GET_LEASE4_COUNT_BY_CLASS,   // Fetches the IPv4 lease count for a given class.
         GET_LEASE6_COUNT_BY_CLASS,   // Fetches the IPv6 lease count for given class and lease type.
+        GET_LEASE4_EXPIRE_FOR_UPDATE, // Get and lock lease4 by expiration.
+        RECLAIM_LEASE4_EXPIRE,       // Reclaim expired lease4 up to a bound.
+        DELETE_LEASE4_EXPIRE,        // Delete expired lease4 up to a bound.
         NUM_STATEMENTS               // Number of statements
     };
 
@@ -761,6 +852,32 @@ private:
     bool addLeaseCommon(MySqlLeaseContextPtr& ctx,
                         StatementIndex stindex, std::vector<MYSQL_BIND>& bind);
 
+    /// @brief Add IPv4 lease using a context
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be added
+    ///
+    /// @return true if the lease was added, false if it already exists.
+    bool addLeaseInternal(MySqlLeaseContextPtr& ctx, const Lease4Ptr& lease);
+
+    /// @brief Add IPv6 lease using a context
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be added
+    ///
+    /// @return true if the lease was added, false if it already exists.
+    bool addLeaseInternal(MySqlLeaseContextPtr& ctx, const Lease6Ptr& lease);
+
+    /// @brief Add leases in a single transaction
+    ///
+    /// @tparam LeaseCollection One of the @c Lease4Collection or
+    /// @c Lease6Collection.
+    /// @param leases Leases to be added
+    ///
+    /// @return Number of added leases.
+    template <typename LeaseCollection>
+    size_t addLeasesCommon(const LeaseCollection& leases);
+
     /// @brief Get Lease Collection Common Code
     ///
     /// This method performs the common actions for obtaining multiple leases
@@ -908,6 +1025,38 @@ private:
                            MYSQL_BIND* bind,
                            const LeasePtr& lease);
 
+    /// @brief Update IPv4 lease using a context
+    ///
+    /// The current expiration time of the lease is not updated.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be updated
+    ///
+    /// @throw NoSuchLease Could not update a lease because no lease matches
+    ///        the address given.
+    void updateLeaseInternal(MySqlLeaseContextPtr& ctx, const Lease4Ptr& lease);
+
+    /// @brief Update IPv6 lease using a context
+    ///
+    /// The current expiration time of the lease is not updated.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be updated
+    ///
+    /// @throw NoSuchLease Could not update a lease because no lease matches
+    ///        the address given.
+    void updateLeaseInternal(MySqlLeaseContextPtr& ctx, const Lease6Ptr& lease);
+
+    /// @brief Update leases in a single transaction
+    ///
+    /// @tparam LeaseCollection One of the @c Lease4Collection or
+    /// @c Lease6Collection.
+    /// @param leases Leases to be updated
+    ///
+    /// @return Number of updated leases.
+    template <typename LeaseCollection>
+    size_t updateLeasesCommon(const LeaseCollection& leases);
+
     /// @brief Delete lease common code
     ///
     /// Holds the common code for deleting a lease.  It binds the parameters
@@ -928,6 +1077,43 @@ private:
                                StatementIndex stindex,
                                MYSQL_BIND* bind);
 
+    /// @brief Delete IPv4 lease using a context
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be deleted
+    ///
+    /// @return true if the lease was deleted, false if no such lease exists.
+    bool deleteLeaseInternal(MySqlLeaseContextPtr& ctx, const Lease4Ptr& lease);
+
+    /// @brief Delete IPv6 lease using a context
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be deleted
+    ///
+    /// @return true if the lease was deleted, false if no such lease exists.
+    bool deleteLeaseInternal(MySqlLeaseContextPtr& ctx, const Lease6Ptr& lease);
+
+    /// @brief Delete leases in a single transaction
+    ///
+    /// @tparam LeaseCollection One of the @c Lease4Collection or
+    /// @c Lease6Collection.
+    /// @param leases Leases to be deleted
+    ///
+    /// @return Number of deleted leases.
+    template <typename LeaseCollection>
+    size_t deleteLeasesCommon(const LeaseCollection& leases);
+
+    /// @brief Delete the leases of a subnet or all leases
+    ///
+    /// @param subnet_id Identifier of the subnet (or 0 for all subnets)
+    /// @param statement_index One of the @c DELETE_LEASE4_SUBID,
+    ///        @c DELETE_LEASE4_ALL, @c DELETE_LEASE6_SUBID or
+    ///        @c DELETE_LEASE6_ALL.
+    ///
+    /// @return Number of deleted leases.
+    uint64_t wipeLeasesCommon(const SubnetID& subnet_id,
+                              StatementIndex statement_index);
+
     /// @brief Delete expired-reclaimed leases.
     ///
     /// @param secs Number of seconds since expiration of leases before
@@ -963,6 +1149,9 @@ private:
     /// { "ISC": { "limits": { "client-classes": [ { "name": "foo", "address-limit": 2 } ],
     ///                        "subnet": { "id": 1, "address-limit": 2 } } } }
     ///
+    /// The limits are checked in memory when the lease limit counter is
+    /// enabled by the in-memory-limits parameter.
+    ///
     /// @return a string describing a limit that is being exceeded, or an empty
     /// string if no limits are exceeded
     virtual std::string
@@ -977,6 +1166,9 @@ private:
     /// { "ISC": { "limits": { "client-classes": [ { "name": "foo", "address-limit": 2, "prefix-limit": 1 } ],
     ///                        "subnet": { "id": 1, "address-limit": 2, "prefix-limit": 1 } } } }
     ///
+    /// The limits are checked in memory when the lease limit counter is
+    /// enabled by the in-memory-limits parameter.
+    ///
     /// @return a string describing a limit that is being exceeded, or an empty
     /// string if no limits are exceeded
     virtual std::string
@@ -994,17 +1186,25 @@ private:
     /// @param ltype type of lease for which the count is desired. Defaults to
     /// Lease::TYPE_V4.
     ///
+    /// The count is taken from the lease limit counter when it is enabled.
+    ///
     /// @return number of leases
     virtual size_t getClassLeaseCount(const ClientClass& client_class,
                                       const Lease::Type& ltype = Lease::TYPE_V4) const override;
 
     /// @brief Recount the leases per class for V4 leases.
+    ///
+    /// @throw NotImplemented if the lease limit counter is not enabled.
     virtual void recountClassLeases4() override;
 
     /// @brief Recount the leases per class for V6 leases.
+    ///
+    /// @throw NotImplemented if the lease limit counter is not enabled.
     virtual void recountClassLeases6() override;
 
     /// @brief Clears the class-lease count map.
+    ///
+    /// @throw NotImplemented if the lease limit counter is not enabled.
     virtual void clearClassLeaseCounts() override;
 
     /// @brief Write V4 leases to a file.
@@ -1231,6 +1431,12 @@ protected:
 
 private:
 
+    /// @brief Returns the pool of contexts of the current thread.
+    ///
+    /// @return The pool of the writer threads when called by a writer
+    /// thread, the shared pool otherwise.
+    MySqlLeaseContextPoolPtr getContextPool() const;
+
     // Members
 
     /// @brief The parameters
@@ -1239,6 +1445,9 @@ private:
     /// @brief The pool of contexts
     MySqlLeaseContextPoolPtr pool_;
 
+    /// @brief The pool of contexts of the writer threads
+    MySqlLeaseContextPoolPtr writer_pool_;
+
     /// @brief Timer name used to register database reconnect timer.
     std::string timer_name_;
 };
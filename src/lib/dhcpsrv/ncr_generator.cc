@@ -22,6 +22,10 @@ namespace {
 
 /// @brief Sends name change request to D2 using lease information.
 ///
+/// The DHCID computation and the creation of the name change request are
+/// deferred to the sender thread of the D2 client manager when it runs, so
+/// only the lease information the request is built from is copied here.
+///
 /// This method is exception safe.
 ///
 /// @param chg_type type of change to create CHG_ADD or CHG_REMOVE
@@ -29,22 +33,23 @@ namespace {
 /// @param identifier Identifier to be used to generate DHCID for
 /// the DNS update. For DHCPv4 it will be hardware address or client
 /// identifier. For DHCPv6 it will be a DUID.
-/// @param label Client identification information in the textual format.
-/// This is used for logging purposes.
+/// @param label Function returning the client identification information
+/// in the textual format. This is used for logging purposes.
 /// @param subnet subnet to which the lease belongs.
 ///
 /// @tparam LeasePtrType Pointer to a lease.
 /// @tparam IdentifierType HW Address, Client Identifier or DUID.
-template<typename LeasePtrType, typename IdentifierType>
+/// @tparam LabelType Function returning a string.
+template<typename LeasePtrType, typename IdentifierType, typename LabelType>
 void queueNCRCommon(const NameChangeType& chg_type, const LeasePtrType& lease,
-                    const IdentifierType& identifier, const std::string& label,
-                    NetworkPtr subnet) {
+                    const IdentifierType& identifier, const LabelType& label,
+                    boost::shared_ptr<const Network> subnet) {
     // Check if there is a need for update.
     if (lease->hostname_.empty() || (!lease->fqdn_fwd_ && !lease->fqdn_rev_)
         || !CfgMgr::instance().getD2ClientMgr().ddnsEnabled()) {
         LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
                   DHCPSRV_QUEUE_NCR_SKIP)
-            .arg(label)
+            .arg(label())
             .arg(lease->addr_.toText());
 
         return;
@@ -57,35 +62,57 @@ void queueNCRCommon(const NameChangeType& chg_type, const LeasePtrType& lease,
         ddns_ttl_percent = subnet->getDdnsTtlPercent();
     }
 
-    try {
-        // Create DHCID
-        std::vector<uint8_t> hostname_wire;
-        OptionDataTypeUtil::writeFqdn(lease->hostname_, hostname_wire, true);
-        D2Dhcid dhcid = D2Dhcid(identifier, hostname_wire);
-
-        // Calculate the TTL based on lease life time.
-        uint32_t ttl = calculateDdnsTtl(lease->valid_lft_, ddns_ttl_percent);
-
-        // Create name change request.
-        NameChangeRequestPtr ncr
-            (new NameChangeRequest(chg_type, lease->fqdn_fwd_, lease->fqdn_rev_,
-                                   lease->hostname_, lease->addr_.toText(),
-                                   dhcid, lease->cltt_ + ttl,
-                                   ttl, use_conflict_resolution));
-
-        LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL_DATA, DHCPSRV_QUEUE_NCR)
-            .arg(label)
-            .arg(chg_type == CHG_ADD ? "add" : "remove")
-            .arg(ncr->toText());
+    // Copy the lease information as the lease may be updated before the
+    // request is built.
+    const std::string hostname = lease->hostname_;
+    const bool fqdn_fwd = lease->fqdn_fwd_;
+    const bool fqdn_rev = lease->fqdn_rev_;
+    const std::string address = lease->addr_.toText();
+    const uint32_t valid_lft = lease->valid_lft_;
+    const time_t cltt = lease->cltt_;
+
+    auto builder = [=]() -> NameChangeRequestPtr {
+        try {
+            // Create DHCID
+            std::vector<uint8_t> hostname_wire;
+            OptionDataTypeUtil::writeFqdn(hostname, hostname_wire, true);
+            D2Dhcid dhcid = D2Dhcid(identifier, hostname_wire);
+
+            // Calculate the TTL based on lease life time.
+            uint32_t ttl = calculateDdnsTtl(valid_lft, ddns_ttl_percent);
+
+            // Create name change request.
+            NameChangeRequestPtr ncr
+                (new NameChangeRequest(chg_type, fqdn_fwd, fqdn_rev,
+                                       hostname, address, dhcid, cltt + ttl,
+                                       ttl, use_conflict_resolution));
+
+            LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL_DATA, DHCPSRV_QUEUE_NCR)
+                .arg(label())
+                .arg(chg_type == CHG_ADD ? "add" : "remove")
+                .arg(ncr->toText());
+
+            return (ncr);
+
+        } catch (const std::exception& ex) {
+            LOG_ERROR(dhcpsrv_logger, DHCPSRV_QUEUE_NCR_FAILED)
+                .arg(label())
+                .arg(chg_type == CHG_ADD ? "add" : "remove")
+                .arg(address)
+                .arg(ex.what());
+        }
+        return (NameChangeRequestPtr());
+    };
 
+    try {
         // Send name change request.
-        CfgMgr::instance().getD2ClientMgr().sendRequest(ncr);
+        CfgMgr::instance().getD2ClientMgr().sendDeferred(builder);
 
     } catch (const std::exception& ex) {
         LOG_ERROR(dhcpsrv_logger, DHCPSRV_QUEUE_NCR_FAILED)
-            .arg(label)
+            .arg(label())
             .arg(chg_type == CHG_ADD ? "add" : "remove")
-            .arg(lease->addr_.toText())
+            .arg(address)
             .arg(ex.what());
     }
 }
@@ -99,18 +126,24 @@ void queueNCR(const NameChangeType& chg_type, const Lease4Ptr& lease) {
     if (lease) {
         // Figure out from the lease's subnet if we should use conflict resolution.
         // If there's no subnet, something hinky is going on so we'll set it true.
-        Subnet4Ptr subnet = CfgMgr::instance().getCurrentCfg()
-                            ->getCfgSubnets4()->getSubnet(lease->subnet_id_);
+        ConstSubnet4Ptr subnet = CfgMgr::instance().getCurrentCfg()
+                                 ->getCfgSubnets4()->getBySubnetId(lease->subnet_id_);
+
+        // The label is only built when logged.
+        HWAddrPtr hwaddr = lease->hwaddr_;
+        ClientIdPtr client_id = lease->client_id_;
+        auto label = [hwaddr, client_id]() {
+            return (Pkt4::makeLabel(hwaddr, client_id));
+        };
 
         // Client id takes precedence over HW address.
-        if (lease->client_id_) {
-            queueNCRCommon(chg_type, lease, lease->client_id_->getClientId(),
-                           Pkt4::makeLabel(lease->hwaddr_, lease->client_id_), subnet);
+        if (client_id) {
+            queueNCRCommon(chg_type, lease, client_id->getClientId(), label,
+                           subnet);
         } else {
             // Client id is not specified for the lease. Use HW address
             // instead.
-            queueNCRCommon(chg_type, lease, lease->hwaddr_,
-                           Pkt4::makeLabel(lease->hwaddr_, lease->client_id_), subnet);
+            queueNCRCommon(chg_type, lease, hwaddr, label, subnet);
         }
     }
 }
@@ -120,10 +153,16 @@ void queueNCR(const NameChangeType& chg_type, const Lease6Ptr& lease) {
     if (lease && (lease->type_ != Lease::TYPE_PD) && lease->duid_) {
         // Figure out from the lease's subnet if we should use conflict resolution.
         // If there's no subnet, something hinky is going on so we'll set it true.
-        Subnet6Ptr subnet = CfgMgr::instance().getCurrentCfg()
-                            ->getCfgSubnets6()->getSubnet(lease->subnet_id_);
-        queueNCRCommon(chg_type, lease, *(lease->duid_),
-                       Pkt6::makeLabel(lease->duid_, lease->hwaddr_), subnet);
+        ConstSubnet6Ptr subnet = CfgMgr::instance().getCurrentCfg()
+                                 ->getCfgSubnets6()->getBySubnetId(lease->subnet_id_);
+
+        // The label is only built when logged.
+        DuidPtr duid = lease->duid_;
+        HWAddrPtr hwaddr = lease->hwaddr_;
+        auto label = [duid, hwaddr]() {
+            return (Pkt6::makeLabel(duid, hwaddr));
+        };
+        queueNCRCommon(chg_type, lease, *duid, label, subnet);
     }
 }
 
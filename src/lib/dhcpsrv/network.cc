@@ -19,6 +19,8 @@ using namespace isc::util;
 namespace isc {
 namespace dhcp {
 
+std::atomic<uint64_t> Network::properties_generation_(0);
+
 void
 Network::RelayInfo::addAddress(const asiolink::IOAddress& addr) {
     if (containsAddress(addr)) {
@@ -73,12 +75,13 @@ Network::clientSupported(const isc::dhcp::ClientClasses& classes) const {
         return (true);
     }
 
-    return (classes.contains(client_class_));
+    return (classes.contains(client_class_id_));
 }
 
 void
 Network::allowClientClass(const isc::dhcp::ClientClass& class_name) {
     client_class_ = class_name;
+    client_class_id_ = ClientClasses::intern(class_name);
 }
 
 void
@@ -93,6 +96,33 @@ Network::getRequiredClasses() const {
     return (required_classes_);
 }
 
+void
+Network::resolveProperties() {
+    // Read the generation first so a change made while the values are
+    // resolved invalidates them.
+    boost::shared_ptr<ResolvedProperties> properties(new ResolvedProperties());
+    properties->generation_ = properties_generation_.load();
+    resolved_properties_.reset();
+    fillResolvedProperties(*properties);
+    resolved_properties_ = properties;
+}
+
+void
+Network::fillResolvedProperties(ResolvedProperties& properties) const {
+    properties.valid_ = getValid();
+    properties.t1_ = getT1();
+    properties.t2_ = getT2();
+    properties.reservations_global_ = getReservationsGlobal();
+    properties.reservations_in_subnet_ = getReservationsInSubnet();
+    properties.reservations_out_of_pool_ = getReservationsOutOfPool();
+    properties.calculate_tee_times_ = getCalculateTeeTimes();
+    properties.t1_percent_ = getT1Percent();
+    properties.t2_percent_ = getT2Percent();
+    properties.store_extended_info_ = getStoreExtendedInfo();
+    properties.cache_threshold_ = getCacheThreshold();
+    properties.cache_max_age_ = getCacheMaxAge();
+}
+
 Optional<IOAddress>
 Network::getGlobalProperty(Optional<IOAddress> property,
                            const int global_index,
@@ -332,6 +362,14 @@ Network4::toElement() const {
     return (map);
 }
 
+void
+Network4::fillResolvedProperties(ResolvedProperties& properties) const {
+    Network::fillResolvedProperties(properties);
+    properties.match_client_id_ = getMatchClientId();
+    properties.authoritative_ = getAuthoritative();
+    properties.offer_lft_ = getOfferLft();
+}
+
 IOAddress
 Network4::getServerId() const {
     try {
@@ -347,6 +385,13 @@ Network4::getServerId() const {
     return (IOAddress::IPV4_ZERO_ADDRESS());
 }
 
+void
+Network6::fillResolvedProperties(ResolvedProperties& properties) const {
+    Network::fillResolvedProperties(properties);
+    properties.preferred_ = getPreferred();
+    properties.rapid_commit_ = getRapidCommit();
+}
+
 ElementPtr
 Network6::toElement() const {
     ElementPtr map = Network::toElement();
@@ -29,6 +29,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <string>
@@ -211,7 +212,7 @@ public:
 
     /// @brief Constructor.
     Network()
-        : iface_name_(), client_class_(), t1_(), t2_(), valid_(),
+        : iface_name_(), client_class_(), client_class_id_(0), t1_(), t2_(), valid_(),
           reservations_global_(false, true), reservations_in_subnet_(true, true),
           reservations_out_of_pool_(false, true), cfg_option_(new CfgOption()),
           calculate_tee_times_(), t1_percent_(), t2_percent_(),
@@ -220,7 +221,7 @@ public:
           hostname_char_set_(), hostname_char_replacement_(), store_extended_info_(),
           cache_threshold_(), cache_max_age_(), ddns_update_on_renew_(),
           ddns_use_conflict_resolution_(), ddns_ttl_percent_(), allocator_type_(),
-          default_allocator_type_() {
+          default_allocator_type_(), ddns_params_version_(0) {
     }
 
     /// @brief Virtual destructor.
@@ -228,12 +229,123 @@ public:
     /// Does nothing at the moment.
     virtual ~Network() { };
 
+    /// @brief Returns the version of the DDNS parameters.
+    ///
+    /// The version is incremented each time one of the DDNS parameters of
+    /// this network is set. It allows for checking whether the DDNS
+    /// parameters resolved for a subnet are still current.
+    ///
+    /// @return The version of the DDNS parameters.
+    uint64_t getDdnsParamsVersion() const {
+        return (ddns_params_version_);
+    }
+
+    /// @brief Returns the objects the DDNS parameters are inherited from.
+    ///
+    /// @param [out] parent The parent network or null.
+    /// @param [out] globals The globally configured parameters or null.
+    void getDdnsParamsSources(NetworkPtr& parent,
+                              ConstCfgGlobalsPtr& globals) const {
+        parent = parent_network_.lock();
+        if (fetch_globals_fn_) {
+            globals = fetch_globals_fn_();
+        } else {
+            globals.reset();
+        }
+    }
+
+    /// @brief Values of the frequently used properties resolved using
+    /// the inheritance on all levels.
+    ///
+    /// The fields specific to DHCPv4 or DHCPv6 are left unspecified
+    /// for the networks of the other family.
+    struct ResolvedProperties {
+        /// @brief Generation of the properties the values were resolved at.
+        uint64_t generation_;
+
+        /// @brief Valid lifetime.
+        isc::util::Triplet<uint32_t> valid_;
+
+        /// @brief Renew timer.
+        isc::util::Triplet<uint32_t> t1_;
+
+        /// @brief Rebind timer.
+        isc::util::Triplet<uint32_t> t2_;
+
+        /// @brief Fetch global reservations.
+        util::Optional<bool> reservations_global_;
+
+        /// @brief Fetch subnet reservations.
+        util::Optional<bool> reservations_in_subnet_;
+
+        /// @brief Only out-of-pool reservations are allowed.
+        util::Optional<bool> reservations_out_of_pool_;
+
+        /// @brief Calculate the T1 and T2 timers.
+        util::Optional<bool> calculate_tee_times_;
+
+        /// @brief Percentage of the valid lifetime used for T1.
+        util::Optional<double> t1_percent_;
+
+        /// @brief Percentage of the valid lifetime used for T2.
+        util::Optional<double> t2_percent_;
+
+        /// @brief Store the extended info in the leases.
+        util::Optional<bool> store_extended_info_;
+
+        /// @brief Lease cache threshold.
+        util::Optional<double> cache_threshold_;
+
+        /// @brief Lease cache maximum age.
+        util::Optional<uint32_t> cache_max_age_;
+
+        /// @brief Use the client identifiers to identify the leases (DHCPv4).
+        util::Optional<bool> match_client_id_;
+
+        /// @brief Reject the requests for unknown addresses (DHCPv4).
+        util::Optional<bool> authoritative_;
+
+        /// @brief Offer lifetime (DHCPv4).
+        util::Optional<uint32_t> offer_lft_;
+
+        /// @brief Preferred lifetime (DHCPv6).
+        isc::util::Triplet<uint32_t> preferred_;
+
+        /// @brief Rapid Commit support (DHCPv6).
+        util::Optional<bool> rapid_commit_;
+    };
+
+    /// @brief Resolves the frequently used properties of the network.
+    ///
+    /// The values returned by the accessors of these properties in the
+    /// @c Inheritance::ALL mode are computed once and stored in a flat
+    /// structure, so the accessors called for each packet read them
+    /// instead of walking the parent network and the global parameters.
+    /// The stored values are used until the properties are invalidated
+    /// by @c invalidateResolvedProperties.
+    ///
+    /// @note This method must not be called while other threads read the
+    /// properties of the network. It is called when the configuration
+    /// is committed.
+    void resolveProperties();
+
+    /// @brief Invalidates the properties resolved for all networks.
+    ///
+    /// It is called by the setters of the resolved properties, when the
+    /// parent network or the global parameters change and when another
+    /// configuration becomes current. The accessors return to the
+    /// inheritance lookup until the next @c resolveProperties.
+    static void invalidateResolvedProperties() {
+        ++properties_generation_;
+    }
+
     /// @brief Sets the optional callback function used to fetch globally
     /// configured parameters.
     ///
     /// @param fetch_globals_fn Pointer to the function.
     void setFetchGlobalsFn(FetchNetworkGlobalsFn fetch_globals_fn) {
         fetch_globals_fn_ = fetch_globals_fn;
+        invalidateResolvedProperties();
     }
 
     /// @brief Checks if the network is associated with a function used to
@@ -374,6 +486,10 @@ public:
     ///
     /// @param inheritance inheritance mode to be used.
     isc::util::Triplet<uint32_t> getValid(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->valid_);
+        }
         return (getProperty<Network>(&Network::getValid, valid_, inheritance,
                                      CfgGlobals::VALID_LIFETIME,
                                      CfgGlobals::MIN_VALID_LIFETIME,
@@ -385,12 +501,17 @@ public:
     /// @param valid New valid lifetime in seconds.
     void setValid(const isc::util::Triplet<uint32_t>& valid) {
         valid_ = valid;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns T1 (renew timer), expressed in seconds
     ///
     /// @param inheritance inheritance mode to be used.
     isc::util::Triplet<uint32_t> getT1(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->t1_);
+        }
         return (getProperty<Network>(&Network::getT1, t1_, inheritance,
                                      CfgGlobals::RENEW_TIMER));
     }
@@ -400,12 +521,17 @@ public:
     /// @param t1 New renew timer value in seconds.
     void setT1(const isc::util::Triplet<uint32_t>& t1) {
         t1_ = t1;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns T2 (rebind timer), expressed in seconds
     ///
     /// @param inheritance inheritance mode to be used.
     isc::util::Triplet<uint32_t> getT2(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->t2_);
+        }
         return (getProperty<Network>(&Network::getT2, t2_, inheritance,
                                      CfgGlobals::REBIND_TIMER));
     }
@@ -415,6 +541,7 @@ public:
     /// @param t2 New rebind timer value in seconds.
     void setT2(const isc::util::Triplet<uint32_t>& t2) {
         t2_ = t2;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns whether global reservations should be fetched.
@@ -422,6 +549,10 @@ public:
     /// @param inheritance inheritance mode to be used.
     util::Optional<bool>
     getReservationsGlobal(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->reservations_global_);
+        }
         return (getProperty<Network>(&Network::getReservationsGlobal,
                                      reservations_global_,
                                      inheritance,
@@ -433,6 +564,7 @@ public:
     /// @param reservations_global new value of enabled/disabled.
     void setReservationsGlobal(const util::Optional<bool>& reservations_global) {
         reservations_global_ = reservations_global;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns whether subnet reservations should be fetched.
@@ -440,6 +572,10 @@ public:
     /// @param inheritance inheritance mode to be used.
     util::Optional<bool>
     getReservationsInSubnet(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->reservations_in_subnet_);
+        }
         return (getProperty<Network>(&Network::getReservationsInSubnet,
                                      reservations_in_subnet_,
                                      inheritance,
@@ -451,6 +587,7 @@ public:
     /// @param reservations_in_subnet new value of enabled/disabled.
     void setReservationsInSubnet(const util::Optional<bool>& reservations_in_subnet) {
         reservations_in_subnet_ = reservations_in_subnet;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns whether only out-of-pool reservations are allowed.
@@ -458,6 +595,10 @@ public:
     /// @param inheritance inheritance mode to be used.
     util::Optional<bool>
     getReservationsOutOfPool(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->reservations_out_of_pool_);
+        }
         return (getProperty<Network>(&Network::getReservationsOutOfPool,
                                      reservations_out_of_pool_,
                                      inheritance,
@@ -469,6 +610,7 @@ public:
     /// @param reservations_out_of_pool new value of enabled/disabled.
     void setReservationsOutOfPool(const util::Optional<bool>& reservations_out_of_pool) {
         reservations_out_of_pool_ = reservations_out_of_pool;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns pointer to the option data configuration for this network.
@@ -487,6 +629,10 @@ public:
     /// @param inheritance inheritance mode to be used.
     util::Optional<bool>
     getCalculateTeeTimes(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->calculate_tee_times_);
+        }
         return (getProperty<Network>(&Network::getCalculateTeeTimes,
                                      calculate_tee_times_,
                                      inheritance,
@@ -498,6 +644,7 @@ public:
     /// @param calculate_tee_times new value of enabled/disabled.
     void setCalculateTeeTimes(const util::Optional<bool>& calculate_tee_times) {
         calculate_tee_times_ = calculate_tee_times;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns percentage to use when calculating the T1 (renew timer).
@@ -505,6 +652,10 @@ public:
     /// @param inheritance inheritance mode to be used.
     util::Optional<double>
     getT1Percent(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->t1_percent_);
+        }
         return (getProperty<Network>(&Network::getT1Percent, t1_percent_,
                                      inheritance, CfgGlobals::T1_PERCENT));
     }
@@ -514,6 +665,7 @@ public:
     /// @param t1_percent New percentage to use.
     void setT1Percent(const util::Optional<double>& t1_percent) {
         t1_percent_ = t1_percent;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns percentage to use when calculating the T2 (rebind timer).
@@ -521,6 +673,10 @@ public:
     /// @param inheritance inheritance mode to be used.
     util::Optional<double>
     getT2Percent(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->t2_percent_);
+        }
         return (getProperty<Network>(&Network::getT2Percent, t2_percent_,
                                      inheritance, CfgGlobals::T2_PERCENT));
     }
@@ -530,6 +686,7 @@ public:
     /// @param t2_percent New percentage to use.
     void setT2Percent(const util::Optional<double>& t2_percent) {
         t2_percent_ = t2_percent;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns ddns-send-updates
@@ -547,6 +704,7 @@ public:
     /// @param ddns_send_updates New value to use.
     void setDdnsSendUpdates(const util::Optional<bool>& ddns_send_updates) {
         ddns_send_updates_ = ddns_send_updates;
+        ++ddns_params_version_;
     }
 
     /// @brief Returns ddns-override-no-update
@@ -564,6 +722,7 @@ public:
     /// @param ddns_override_no_update New value to use.
     void setDdnsOverrideNoUpdate(const util::Optional<bool>& ddns_override_no_update) {
         ddns_override_no_update_ = ddns_override_no_update;
+        ++ddns_params_version_;
     }
 
     /// @brief Returns ddns-override-client-update
@@ -582,6 +741,7 @@ public:
     void setDdnsOverrideClientUpdate(const util::Optional<bool>&
                                      ddns_override_client_update) {
         ddns_override_client_update_ = ddns_override_client_update;
+        ++ddns_params_version_;
     }
 
     /// @brief Returns ddns-replace-client-name-mode
@@ -628,6 +788,7 @@ public:
     setDdnsReplaceClientNameMode(const util::Optional<D2ClientConfig::ReplaceClientNameMode>&
                                  ddns_replace_client_name_mode) {
         ddns_replace_client_name_mode_ = ddns_replace_client_name_mode;
+        ++ddns_params_version_;
     }
 
     /// @brief Returns ddns-generated-prefix
@@ -645,6 +806,7 @@ public:
     /// @param ddns_generated_prefix New value to use.
     void setDdnsGeneratedPrefix(const util::Optional<std::string>& ddns_generated_prefix) {
         ddns_generated_prefix_ = ddns_generated_prefix;
+        ++ddns_params_version_;
     }
 
     /// @brief Returns ddns-qualifying-suffix
@@ -662,6 +824,7 @@ public:
     /// @param ddns_qualifying_suffix New value to use.
     void setDdnsQualifyingSuffix(const util::Optional<std::string>& ddns_qualifying_suffix) {
         ddns_qualifying_suffix_ = ddns_qualifying_suffix;
+        ++ddns_params_version_;
     }
 
     /// @brief Returns ddns-ttl-percent
@@ -679,6 +842,7 @@ public:
     /// @param ddns_ttl_percent New value to use.
     void setDdnsTtlPercent(const util::Optional<double>& ddns_ttl_percent) {
         ddns_ttl_percent_ = ddns_ttl_percent;
+        ++ddns_params_version_;
     }
 
     /// @brief Return the char set regexp used to sanitize client hostnames.
@@ -694,6 +858,7 @@ public:
     /// @param hostname_char_set New value to use.
     void setHostnameCharSet(const util::Optional<std::string>& hostname_char_set) {
         hostname_char_set_ = hostname_char_set;
+        ++ddns_params_version_;
     }
 
     /// @brief Return the invalid char replacement used to sanitize client hostnames.
@@ -710,6 +875,7 @@ public:
     void setHostnameCharReplacement(const util::Optional<std::string>&
                                     hostname_char_replacement) {
         hostname_char_replacement_ = hostname_char_replacement;
+        ++ddns_params_version_;
     }
 
     /// @brief Returns store-extended-info
@@ -717,6 +883,10 @@ public:
     /// @param inheritance inheritance mode to be used.
     util::Optional<bool>
     getStoreExtendedInfo(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->store_extended_info_);
+        }
         return (getProperty<Network>(&Network::getStoreExtendedInfo,
                                      store_extended_info_, inheritance,
                                      CfgGlobals::STORE_EXTENDED_INFO));
@@ -727,6 +897,7 @@ public:
     /// @param store_extended_info New value to use.
     void setStoreExtendedInfo(const util::Optional<bool>& store_extended_info) {
         store_extended_info_ = store_extended_info;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns percentage to use as cache threshold.
@@ -734,6 +905,10 @@ public:
     /// @param inheritance inheritance mode to be used.
     util::Optional<double>
     getCacheThreshold(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->cache_threshold_);
+        }
         return (getProperty<Network>(&Network::getCacheThreshold,
                                      cache_threshold_, inheritance,
                                      CfgGlobals::CACHE_THRESHOLD));
@@ -744,6 +919,7 @@ public:
     /// @param cache_threshold New cache threshold percentage to use.
     void setCacheThreshold(const util::Optional<double>& cache_threshold) {
         cache_threshold_ = cache_threshold;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns value in seconds to use as cache maximum age.
@@ -751,6 +927,10 @@ public:
     /// @param inheritance inheritance mode to be used.
     util::Optional<uint32_t>
     getCacheMaxAge(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->cache_max_age_);
+        }
         return (getProperty<Network>(&Network::getCacheMaxAge, cache_max_age_,
                                      inheritance, CfgGlobals::CACHE_MAX_AGE));
     }
@@ -760,6 +940,7 @@ public:
     /// @param cache_max_age New cache maximum value in seconds to use.
     void setCacheMaxAge(const util::Optional<uint32_t>& cache_max_age) {
         cache_max_age_ = cache_max_age;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns ddns-update-on-renew
@@ -777,6 +958,7 @@ public:
     /// @param ddns_update_on_renew New value to use.
     void setDdnsUpdateOnRenew(const util::Optional<bool>& ddns_update_on_renew) {
         ddns_update_on_renew_ = ddns_update_on_renew;
+        ++ddns_params_version_;
     }
 
     /// @brief Returns ddns-use-conflict-resolution
@@ -795,6 +977,7 @@ public:
     /// @param ddns_use_conflict_resolution New value to use.
     void setDdnsUseConflictResolution(const util::Optional<bool>& ddns_use_conflict_resolution) {
         ddns_use_conflict_resolution_ = ddns_use_conflict_resolution;
+        ++ddns_params_version_;
     }
 
     /// @brief Returns allocator type.
@@ -861,6 +1044,28 @@ protected:
         return (fetch_globals_fn_);
     }
 
+    /// @brief Fills the resolved values of the properties.
+    ///
+    /// The derived classes fill their own properties.
+    ///
+    /// @param [out] properties The structure to fill.
+    virtual void fillResolvedProperties(ResolvedProperties& properties) const;
+
+    /// @brief Returns the resolved properties if they can be used.
+    ///
+    /// @param inheritance inheritance mode used by the accessor.
+    /// @return Pointer to the resolved properties when the mode is
+    /// @c Inheritance::ALL and they are still valid, null otherwise.
+    const ResolvedProperties*
+    getResolvedProperties(const Inheritance& inheritance) const {
+        if ((inheritance == Inheritance::ALL) && resolved_properties_ &&
+            (resolved_properties_->generation_ ==
+             properties_generation_.load(std::memory_order_relaxed))) {
+            return (resolved_properties_.get());
+        }
+        return (0);
+    }
+
     /// @brief Returns a value of global configuration parameter with
     /// a given index.
     ///
@@ -1146,6 +1351,9 @@ protected:
     /// which means that any client is allowed, regardless of its class.
     util::Optional<ClientClass> client_class_;
 
+    /// @brief Interned identifier of the client class
+    ClientClassId client_class_id_;
+
     /// @brief Required classes
     ///
     /// If the network is selected these classes will be added to the
@@ -1253,6 +1461,15 @@ protected:
     /// @brief Pointer to the optional callback used to fetch globally
     /// configured parameters inherited to the @c Network object.
     FetchNetworkGlobalsFn fetch_globals_fn_;
+
+    /// @brief Version of the DDNS parameters.
+    uint64_t ddns_params_version_;
+
+    /// @brief Resolved values of the frequently used properties or null.
+    boost::shared_ptr<const ResolvedProperties> resolved_properties_;
+
+    /// @brief Generation of the properties of all networks.
+    static std::atomic<uint64_t> properties_generation_;
 };
 
 /// @brief Specialization of the @ref Network object for DHCPv4 case.
@@ -1272,6 +1489,10 @@ public:
     /// @return true if client identifiers should be used, false otherwise.
     util::Optional<bool>
     getMatchClientId(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->match_client_id_);
+        }
         return (getProperty<Network4>(&Network4::getMatchClientId,
                                       match_client_id_,
                                       inheritance,
@@ -1285,6 +1506,7 @@ public:
     /// used for lease lookup.
     void setMatchClientId(const util::Optional<bool>& match) {
         match_client_id_ = match;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns the flag indicating if requests for unknown IP addresses
@@ -1295,6 +1517,10 @@ public:
     /// false otherwise.
     util::Optional<bool>
     getAuthoritative(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->authoritative_);
+        }
         return (getProperty<Network4>(&Network4::getAuthoritative,
                                       authoritative_, inheritance,
                                       CfgGlobals::AUTHORITATIVE));
@@ -1307,6 +1533,7 @@ public:
     /// addresses will be rejected with DHCPNAK messages
     void setAuthoritative(const util::Optional<bool>& authoritative) {
         authoritative_ = authoritative;
+        invalidateResolvedProperties();
     }
 
     /// @brief Sets siaddr for the network.
@@ -1362,6 +1589,7 @@ public:
     /// @param offer_lft the offer lifetime assigned to the class (may be empty if not defined)
     void setOfferLft(const util::Optional<uint32_t>& offer_lft) {
         offer_lft_ = offer_lft;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns offer lifetime for the network
@@ -1370,6 +1598,10 @@ public:
     /// @return offer lifetime value
     util::Optional<uint32_t>
     getOfferLft(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->offer_lft_);
+        }
         return (getProperty<Network4>(&Network4::getOfferLft, offer_lft_,
                                       inheritance,
                                       CfgGlobals::OFFER_LIFETIME));
@@ -1386,6 +1618,13 @@ public:
     /// indicates that server identifier hasn't been specified.
     virtual asiolink::IOAddress getServerId() const;
 
+protected:
+
+    /// @brief Fills the resolved values of the properties.
+    ///
+    /// @param [out] properties The structure to fill.
+    virtual void fillResolvedProperties(ResolvedProperties& properties) const;
+
 private:
 
     /// @brief Should server use client identifiers for client lease
@@ -1432,6 +1671,10 @@ public:
     /// @return a triplet with preferred lifetime
     isc::util::Triplet<uint32_t>
     getPreferred(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->preferred_);
+        }
         return (getProperty<Network6>(&Network6::getPreferred, preferred_,
                                       inheritance,
                                       CfgGlobals::PREFERRED_LIFETIME,
@@ -1444,6 +1687,7 @@ public:
     /// @param preferred New preferred lifetime in seconds.
     void setPreferred(const isc::util::Triplet<uint32_t>& preferred) {
         preferred_ = preferred;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns interface-id value (if specified)
@@ -1471,6 +1715,10 @@ public:
     /// @return true if the Rapid Commit option is supported, false otherwise.
     util::Optional<bool>
     getRapidCommit(const Inheritance& inheritance = Inheritance::ALL) const {
+        const ResolvedProperties* resolved = getResolvedProperties(inheritance);
+        if (resolved) {
+            return (resolved->rapid_commit_);
+        }
 
         return (getProperty<Network6>(&Network6::getRapidCommit, rapid_commit_,
                                       inheritance));
@@ -1482,6 +1730,7 @@ public:
     /// option support is enabled (if true), or disabled (if false).
     void setRapidCommit(const util::Optional<bool>& rapid_commit) {
         rapid_commit_ = rapid_commit;
+        invalidateResolvedProperties();
     };
 
     /// @brief Returns allocator type for prefix delegation.
@@ -1531,6 +1780,13 @@ public:
     /// @return A pointer to unparsed network configuration.
     virtual data::ElementPtr toElement() const;
 
+protected:
+
+    /// @brief Fills the resolved values of the properties.
+    ///
+    /// @param [out] properties The structure to fill.
+    virtual void fillResolvedProperties(ResolvedProperties& properties) const;
+
 private:
 
     /// @brief a triplet with preferred lifetime (in seconds)
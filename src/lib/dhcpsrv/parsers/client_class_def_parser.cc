@@ -13,6 +13,7 @@
 #include <dhcpsrv/parsers/simple_parser4.h>
 #include <dhcpsrv/parsers/simple_parser6.h>
 #include <eval/eval_context.h>
+#include <eval/evaluate.h>
 #include <asiolink/io_address.h>
 #include <asiolink/io_error.h>
 
@@ -61,7 +62,7 @@ ExpressionParser::parse(ExpressionPtr& expression,
                              check_defined);
         eval_ctx.parseString(value, parser_type);
         expression.reset(new Expression());
-        *expression = eval_ctx.expression;
+        *expression = compileExpression(eval_ctx.expression);
     } catch (const std::exception& ex) {
         // Append position if there is a failure.
         isc_throw(DhcpConfigError,
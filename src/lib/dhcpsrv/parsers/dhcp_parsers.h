@@ -105,7 +105,7 @@ public:
     /// @return Position of the data element or the position holding empty
     /// file name and two zeros if the position hasn't been specified for the
     /// particular value.
-    const data::Element::Position&
+    data::Element::Position
     getPosition(const std::string& name, const data::ConstElementPtr parent =
                 data::ConstElementPtr()) const {
         typename std::map<std::string, data::Element::Position>::const_iterator
@@ -0,0 +1,161 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef HOST_RESERVATIONS_BULK_PARSER_H
+#define HOST_RESERVATIONS_BULK_PARSER_H
+
+#include <cc/data.h>
+#include <cc/dhcp_config_error.h>
+#include <cc/simple_parser.h>
+#include <dhcpsrv/host.h>
+#include <dhcpsrv/subnet_id.h>
+
+#include <algorithm>
+#include <istream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Parser for a bulk import of host reservations.
+///
+/// The input holds one host reservation per line in the JSON lines
+/// format: each line is a map with the same parameters as the entries
+/// of the "reservations" lists, plus an optional "subnet-id" giving the
+/// subnet of the reservation (global when absent). Blank lines and lines
+/// starting with '#' are ignored.
+///
+/// Parsing the JSON and building the hosts is the bulk of the import
+/// cost, so the lines are parsed concurrently by several threads. No
+/// host is returned when a line is invalid: the error names the first
+/// invalid line. The resulting collection is meant to be given to
+/// @c HostMgr::addHosts, which writes it by batches.
+///
+/// @tparam HostReservationParserType Host reservation parser to be used to
+/// parse individual reservations: @c HostReservationParser4 or
+/// @c HostReservationParser6.
+template<typename HostReservationParserType>
+class HostReservationsBulkParser : public isc::data::SimpleParser {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param thread_count number of parsing threads, 0 meaning the
+    /// number of processors.
+    explicit HostReservationsBulkParser(size_t thread_count = 0)
+        : thread_count_(thread_count) {
+        if (thread_count_ == 0) {
+            thread_count_ = std::max(1U, std::thread::hardware_concurrency());
+        }
+    }
+
+    /// @brief Parses host reservations in the JSON lines format.
+    ///
+    /// @param input the stream holding the reservations.
+    /// @param [out] hosts_list Hosts representing parsed reservations are
+    /// stored in this list, in the order of the input.
+    ///
+    /// @throw DhcpConfigError If any of the reservations is invalid.
+    void parse(std::istream& input, HostCollection& hosts_list) const {
+        std::vector<std::string> lines;
+        std::vector<size_t> line_numbers;
+        std::string line;
+        size_t line_number = 0;
+        while (std::getline(input, line)) {
+            ++line_number;
+            size_t first = line.find_first_not_of(" \t\r");
+            if ((first == std::string::npos) || (line[first] == '#')) {
+                continue;
+            }
+            lines.push_back(line);
+            line_numbers.push_back(line_number);
+        }
+
+        HostCollection hosts(lines.size());
+        std::vector<std::string> errors(lines.size());
+        size_t thread_count = std::min(thread_count_, lines.size());
+
+        // Each thread parses a contiguous range of lines into its own
+        // slots so no synchronization is needed.
+        auto parse_range = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                try {
+                    hosts[i] = parseLine(lines[i]);
+                } catch (const std::exception& ex) {
+                    errors[i] = ex.what();
+                }
+            }
+        };
+        if (thread_count <= 1) {
+            parse_range(0, lines.size());
+        } else {
+            std::vector<std::thread> threads;
+            size_t range = (lines.size() + thread_count - 1) / thread_count;
+            for (size_t begin = 0; begin < lines.size(); begin += range) {
+                threads.emplace_back(parse_range, begin,
+                                     std::min(lines.size(), begin + range));
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+
+        for (size_t i = 0; i < errors.size(); ++i) {
+            if (!errors[i].empty()) {
+                isc_throw(DhcpConfigError, "invalid host reservation at line "
+                          << line_numbers[i] << ": " << errors[i]);
+            }
+        }
+        hosts_list.swap(hosts);
+    }
+
+    /// @brief Returns the number of parsing threads.
+    size_t getThreadCount() const {
+        return (thread_count_);
+    }
+
+private:
+
+    /// @brief Parses a host reservation.
+    ///
+    /// @param line the JSON map of the reservation.
+    /// @return the host.
+    /// @throw DhcpConfigError or JSONError If the reservation is invalid.
+    static HostPtr parseLine(const std::string& line) {
+        isc::data::ElementPtr reservation = isc::data::Element::fromJSON(line);
+        if (reservation->getType() != isc::data::Element::map) {
+            isc_throw(DhcpConfigError, "a host reservation must be a map");
+        }
+
+        SubnetID subnet_id = SUBNET_ID_GLOBAL;
+        isc::data::ConstElementPtr id = reservation->get("subnet-id");
+        if (id) {
+            if (id->getType() != isc::data::Element::integer) {
+                isc_throw(DhcpConfigError, "'subnet-id' must be an integer");
+            }
+            int64_t value = id->intValue();
+            if ((value < 0) || (value > SUBNET_ID_MAX)) {
+                isc_throw(DhcpConfigError, "'subnet-id' value " << value
+                          << " is out of range");
+            }
+            subnet_id = static_cast<SubnetID>(value);
+            reservation->remove("subnet-id");
+        }
+
+        HostReservationParserType parser;
+        return (parser.parse(subnet_id, reservation));
+    }
+
+    /// @brief Number of parsing threads.
+    size_t thread_count_;
+};
+
+}
+}
+
+#endif // HOST_RESERVATIONS_BULK_PARSER_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,7 +9,9 @@
 #include <dhcpsrv/cfgmgr.h>
 #include <dhcpsrv/dhcpsrv_log.h>
 #include <dhcpsrv/parsers/ifaces_config_parser.h>
+#include <util/fd_event_handler_factory.h>
 #include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
 #include <string>
 #include <sys/types.h>
 
@@ -33,6 +35,35 @@ IfacesConfigParser::parseInterfacesList(const CfgIfacePtr& cfg_iface,
     }
 }
 
+void
+IfacesConfigParser::parseAcceptedRelays(const CfgIfacePtr& cfg_iface,
+                                        ConstElementPtr relays_list) {
+    BOOST_FOREACH(ConstElementPtr relay, relays_list->listValue()) {
+        std::string prefix = relay->stringValue();
+        try {
+            size_t slash = prefix.find('/');
+            if ((slash == std::string::npos) || (slash + 1 == prefix.size())) {
+                isc_throw(BadValue, "a prefix must be given as address/length");
+            }
+            asiolink::IOAddress addr(prefix.substr(0, slash));
+            int len = boost::lexical_cast<int>(prefix.substr(slash + 1));
+            if ((len < 0) || (len > 32)) {
+                isc_throw(BadValue, "invalid prefix length " << len);
+            }
+            cfg_iface->addAcceptedRelay(addr, static_cast<uint8_t>(len));
+
+        } catch (const boost::bad_lexical_cast&) {
+            isc_throw(DhcpConfigError, "Failed to add accepted relay '"
+                      << prefix << "': invalid prefix length ("
+                      << relay->getPosition() << ")");
+        } catch (const std::exception& ex) {
+            isc_throw(DhcpConfigError, "Failed to add accepted relay '"
+                      << prefix << "': " << ex.what() << " ("
+                      << relay->getPosition() << ")");
+        }
+    }
+}
+
 IfacesConfigParser::IfacesConfigParser(const uint16_t protocol, bool test_mode)
     : protocol_(protocol), test_mode_(test_mode) {
 }
@@ -85,6 +116,23 @@ IfacesConfigParser::parse(const CfgIfacePtr& cfg,
                 }
             }
 
+            if (element.first == "accepted-relays") {
+                if (protocol_ == AF_INET) {
+                    parseAcceptedRelays(cfg, element.second);
+                    continue;
+                } else {
+                    isc_throw(DhcpConfigError,
+                              "accepted-relays is not supported in DHCPv6");
+                }
+            }
+
+            if (element.first == "event-handler-type") {
+                util::FDEventHandler::HandlerType type =
+                    util::FDEventHandlerFactory::typeFromText(element.second->stringValue());
+                cfg->setEventHandlerType(type);
+                continue;
+            }
+
             if (element.first == "service-sockets-require-all") {
                 cfg->setServiceSocketsRequireAll(element.second->boolValue());
                 continue;
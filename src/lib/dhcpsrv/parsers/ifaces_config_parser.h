@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -57,6 +57,17 @@ private:
     void parseInterfacesList(const CfgIfacePtr& cfg_iface,
                              isc::data::ConstElementPtr ifaces_list);
 
+    /// @brief parses accepted-relays structure
+    ///
+    /// This method adds the prefixes of the accepted relays, given as
+    /// "address/length" strings, to the specified configuration structure.
+    ///
+    /// @param cfg_iface parsed prefixes will be specified here
+    /// @param relays_list accepted-relays to be parsed
+    /// @throw DhcpConfigError if a prefix is invalid.
+    void parseAcceptedRelays(const CfgIfacePtr& cfg_iface,
+                             isc::data::ConstElementPtr relays_list);
+
     /// @brief AF_INET for DHCPv4 and AF_INET6 for DHCPv6.
     int protocol_;
 
@@ -9,8 +9,11 @@
 #include <cc/data.h>
 #include <dhcpsrv/srv_config.h>
 #include <dhcpsrv/parsers/multi_threading_config_parser.h>
+#include <util/cpu_affinity.h>
 #include <util/multi_threading_mgr.h>
 
+#include <algorithm>
+
 using namespace isc::data;
 using namespace isc::util;
 
@@ -64,6 +67,35 @@ MultiThreadingConfigParser::parse(SrvConfig& srv_cfg,
         }
     }
 
+    // cpu-affinity and receiver-cpu-affinity are not mandatory
+    for (auto const& name : { "cpu-affinity", "receiver-cpu-affinity" }) {
+        if (!value->get(name)) {
+            continue;
+        }
+        CpuList cpus;
+        try {
+            cpus = parseCpuList(getString(value, name));
+        } catch (const BadValue& ex) {
+            isc_throw(DhcpConfigError, ex.what() << " ("
+                      << getPosition(name, value) << ")");
+        }
+        if (cpus.empty()) {
+            continue;
+        }
+        if (!isCpuAffinitySupported()) {
+            isc_throw(DhcpConfigError, name << " is not supported on this"
+                      << " system (" << getPosition(name, value) << ")");
+        }
+        CpuList available = getAvailableCpus();
+        for (auto cpu : cpus) {
+            if (!std::binary_search(available.begin(), available.end(), cpu)) {
+                isc_throw(DhcpConfigError, "CPU " << cpu << " of " << name
+                          << " is not available to the server ("
+                          << getPosition(name, value) << ")");
+            }
+        }
+    }
+
     srv_cfg.setDHCPMultiThreading(value);
 }
 
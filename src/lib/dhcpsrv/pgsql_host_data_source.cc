@@ -31,6 +31,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <mutex>
 #include <string>
 
@@ -1402,6 +1403,8 @@ public:
         GET_HOST_ADDR,             // Gets hosts by IPv4 address
         GET_HOST_SUBID4_DHCPID,    // Gets host by IPv4 SubnetID, HW address/DUID
         GET_HOST_SUBID6_DHCPID,    // Gets host by IPv6 SubnetID, HW address/DUID
+        GET_HOST_SUBID4_DHCPIDS,   // Gets hosts by IPv4 SubnetID and identifiers
+        GET_HOST_SUBID6_DHCPIDS,   // Gets hosts by IPv6 SubnetID and identifiers
         GET_HOST_SUBID_ADDR,       // Gets host by IPv4 SubnetID and IPv4 address
         GET_HOST_PREFIX,           // Gets host by IPv6 prefix
         GET_HOST_SUBID6_ADDR,      // Gets host by IPv6 SubnetID and IPv6 prefix
@@ -1434,6 +1437,10 @@ public:
     /// such as INSERT, DELETE, UPDATE.
     static const StatementIndex WRITE_STMTS_BEGIN = INSERT_HOST_NON_UNIQUE_IP;
 
+    /// @brief Number of identifiers looked for by the GET_HOST_SUBID4_DHCPIDS
+    /// and GET_HOST_SUBID6_DHCPIDS statements.
+    static const size_t MAX_IDENTIFIERS = Host::LAST_IDENTIFIER_TYPE + 1;
+
     /// @brief Constructor.
     ///
     /// This constructor opens database connection and initializes prepared
@@ -1478,6 +1485,36 @@ public:
     /// failed.
     PgSqlHostContextPtr createContext() const;
 
+    /// @brief Create a new context connected to the read replica.
+    ///
+    /// Only the statements reading the database are prepared. The replica
+    /// connection has no recovery: when it is lost the context is dropped
+    /// and the lookups use the primary database until a new replica
+    /// context can be created.
+    ///
+    /// @return A new (never null) context.
+    ///
+    /// @throw isc::dhcp::NoDatabaseName Mandatory database name not given.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    /// failed.
+    PgSqlHostContextPtr createReplicaContext() const;
+
+    /// @brief Takes a context of the read replica.
+    ///
+    /// The context is taken from the replica pool or created. When the
+    /// replica-max-lag parameter is set the replication lag is checked.
+    ///
+    /// @return A replica context or null when no read replica is configured,
+    /// when it is not available or when it lags behind the primary.
+    PgSqlHostContextPtr getReplicaContext();
+
+    /// @brief Puts back a context in the replica pool.
+    ///
+    /// The context is dropped when its connection is no longer usable.
+    ///
+    /// @param ctx The replica context.
+    void releaseReplicaContext(const PgSqlHostContextPtr& ctx);
+
     /// @brief Executes statements which insert a row into one of the tables.
     ///
     /// @param ctx Context
@@ -1548,6 +1585,14 @@ public:
                     const ConstCfgOptionPtr& options_cfg,
                     const uint64_t host_id);
 
+    /// @brief Inserts a host with its options and IPv6 reservations.
+    ///
+    /// The caller is in charge of the transaction.
+    ///
+    /// @param ctx Context
+    /// @param host Pointer to the new @c Host object being added.
+    void addHost(PgSqlHostContextPtr& ctx, const HostPtr& host);
+
     /// @brief Creates collection of @ref Host objects with associated
     /// information such as IPv6 reservations and/or DHCP options.
     ///
@@ -1598,6 +1643,24 @@ public:
                          StatementIndex stindex,
                          boost::shared_ptr<PgSqlHostExchange> exchange) const;
 
+    /// @brief Retrieves the hosts connected to a subnet using any of the
+    /// identifiers.
+    ///
+    /// @param ctx Context
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Identifiers, not more than @c MAX_IDENTIFIERS.
+    /// @param stindex Statement index.
+    /// @param exchange Pointer to the exchange object used for the
+    /// particular query.
+    ///
+    /// @return Collection of const @c Host objects.
+    ConstHostCollection
+    getHostsByIdentifiers(PgSqlHostContextPtr& ctx,
+                          const SubnetID& subnet_id,
+                          const HostIdentifierList& identifiers,
+                          StatementIndex stindex,
+                          boost::shared_ptr<PgSqlHostExchange> exchange) const;
+
     /// @brief Throws exception if database is read only.
     ///
     /// This method should be called by the methods which write to the
@@ -1629,6 +1692,20 @@ public:
     /// @brief The pool of contexts
     PgSqlHostContextPoolPtr pool_;
 
+    /// @brief The parameters of the read replica (empty when none).
+    DatabaseConnection::ParameterMap replica_parameters_;
+
+    /// @brief The maximum replication lag of the read replica in seconds
+    /// (0 when not checked).
+    uint32_t replica_max_lag_;
+
+    /// @brief The pool of read replica contexts (null when no replica).
+    PgSqlHostContextPoolPtr replica_pool_;
+
+    /// @brief The time before which the read replica is not retried after
+    /// a failure (protected by the replica pool mutex).
+    time_t replica_retry_time_;
+
     /// @brief Indicates if there is at least one connection that can no longer
     /// be used for normal operations.
     bool unusable_;
@@ -1738,6 +1815,61 @@ TaggedStatementArray tagged_statements = { {
      "ORDER BY h.host_id, o.option_id, r.reservation_id"
     },
 
+    // PgSqlHostDataSourceImpl::GET_HOST_SUBID4_DHCPIDS
+    // Retrieves host information and DHCPv4 options using subnet identifier
+    // and any of the client's identifiers. The unused identifier slots must
+    // repeat one of the identifiers.
+    {11,
+     { OID_INT8, OID_INT2, OID_BYTEA, OID_INT2, OID_BYTEA, OID_INT2, OID_BYTEA,
+       OID_INT2, OID_BYTEA, OID_INT2, OID_BYTEA },
+     "get_host_subid4_dhcpids",
+     "SELECT h.host_id, h.dhcp_identifier, h.dhcp_identifier_type, "
+     "  h.dhcp4_subnet_id, h.dhcp6_subnet_id, h.ipv4_address, h.hostname, "
+     "  h.dhcp4_client_classes, h.dhcp6_client_classes, h.user_context, "
+     "  h.dhcp4_next_server, h.dhcp4_server_hostname, "
+     "  h.dhcp4_boot_file_name, h.auth_key, "
+     "  o.option_id, o.code, o.value, o.formatted_value, o.space, "
+     "  o.persistent, o.cancelled, o.user_context "
+     "FROM hosts AS h "
+     "LEFT JOIN dhcp4_options AS o ON h.host_id = o.host_id "
+     "WHERE h.dhcp4_subnet_id = $1 "
+     "  AND ((h.dhcp_identifier_type = $2 AND h.dhcp_identifier = $3) "
+     "  OR (h.dhcp_identifier_type = $4 AND h.dhcp_identifier = $5) "
+     "  OR (h.dhcp_identifier_type = $6 AND h.dhcp_identifier = $7) "
+     "  OR (h.dhcp_identifier_type = $8 AND h.dhcp_identifier = $9) "
+     "  OR (h.dhcp_identifier_type = $10 AND h.dhcp_identifier = $11)) "
+     "ORDER BY h.host_id, o.option_id"
+    },
+
+    // PgSqlHostDataSourceImpl::GET_HOST_SUBID6_DHCPIDS
+    // Retrieves host information, IPv6 reservations and DHCPv6 options
+    // using subnet identifier and any of the client's identifiers. The
+    // unused identifier slots must repeat one of the identifiers.
+    {11,
+     { OID_INT8, OID_INT2, OID_BYTEA, OID_INT2, OID_BYTEA, OID_INT2, OID_BYTEA,
+       OID_INT2, OID_BYTEA, OID_INT2, OID_BYTEA },
+     "get_host_subid6_dhcpids",
+     "SELECT h.host_id, h.dhcp_identifier, "
+     "  h.dhcp_identifier_type, h.dhcp4_subnet_id, "
+     "  h.dhcp6_subnet_id, h.ipv4_address, h.hostname, "
+     "  h.dhcp4_client_classes, h.dhcp6_client_classes, h.user_context, "
+     "  h.dhcp4_next_server, h.dhcp4_server_hostname, "
+     "  h.dhcp4_boot_file_name, h.auth_key, "
+     "  o.option_id, o.code, o.value, o.formatted_value, o.space, "
+     "  o.persistent, o.cancelled, o.user_context, "
+     "  r.reservation_id, r.address, r.prefix_len, r.type, r.dhcp6_iaid "
+     "FROM hosts AS h "
+     "LEFT JOIN dhcp6_options AS o ON h.host_id = o.host_id "
+     "LEFT JOIN ipv6_reservations AS r ON h.host_id = r.host_id "
+     "WHERE h.dhcp6_subnet_id = $1 "
+     "  AND ((h.dhcp_identifier_type = $2 AND h.dhcp_identifier = $3) "
+     "  OR (h.dhcp_identifier_type = $4 AND h.dhcp_identifier = $5) "
+     "  OR (h.dhcp_identifier_type = $6 AND h.dhcp_identifier = $7) "
+     "  OR (h.dhcp_identifier_type = $8 AND h.dhcp_identifier = $9) "
+     "  OR (h.dhcp_identifier_type = $10 AND h.dhcp_identifier = $11)) "
+     "ORDER BY h.host_id, o.option_id, r.reservation_id"
+    },
+
     // PgSqlHostDataSourceImpl::GET_HOST_SUBID_ADDR
     // Retrieves host information and DHCPv4 options for the host using subnet
     // identifier and IPv4 reservation. Left joining the dhcp4_options table
@@ -2231,9 +2363,30 @@ PgSqlHostDataSource::PgSqlHostContextAlloc::~PgSqlHostContextAlloc() {
     }
 }
 
+// PgSqlHostReadContextAlloc Constructor and Destructor
+
+PgSqlHostDataSource::PgSqlHostReadContextAlloc::PgSqlHostReadContextAlloc(
+    PgSqlHostDataSourceImpl& mgr) : ctx_(), mgr_(mgr), primary_() {
+
+    ctx_ = mgr_.getReplicaContext();
+    if (!ctx_) {
+        primary_.reset(new PgSqlHostContextAlloc(mgr_));
+        ctx_ = primary_->ctx_;
+    }
+}
+
+PgSqlHostDataSource::PgSqlHostReadContextAlloc::~PgSqlHostReadContextAlloc() {
+    // The primary context is put back by its allocator.
+    if (!primary_) {
+        mgr_.releaseReplicaContext(ctx_);
+    }
+}
+
 PgSqlHostDataSourceImpl::PgSqlHostDataSourceImpl(const DatabaseConnection::ParameterMap& parameters)
-    : parameters_(parameters), ip_reservations_unique_(true), unusable_(false),
-      timer_name_("") {
+    : parameters_(parameters), ip_reservations_unique_(true),
+      replica_parameters_(DatabaseConnection::getReplicaParameters(parameters)),
+      replica_max_lag_(DatabaseConnection::getReplicaMaxLag(parameters)),
+      replica_retry_time_(0), unusable_(false), timer_name_("") {
 
     // Create unique timer name per instance.
     timer_name_ = "PgSqlHostMgr[";
@@ -2277,6 +2430,12 @@ PgSqlHostDataSourceImpl::PgSqlHostDataSourceImpl(const DatabaseConnection::Param
     // Create an initial context.
     pool_.reset(new PgSqlHostContextPool());
     pool_->pool_.push_back(createContext());
+
+    // The read replica contexts are created on demand: an unavailable
+    // replica must not prevent the server from starting.
+    if (!replica_parameters_.empty()) {
+        replica_pool_.reset(new PgSqlHostContextPool());
+    }
 }
 
 // Create context.
@@ -2319,6 +2478,82 @@ PgSqlHostDataSourceImpl::createContext() const {
     return (ctx);
 }
 
+PgSqlHostContextPtr
+PgSqlHostDataSourceImpl::createReplicaContext() const {
+    // The losses of the replica connection do not trigger the recovery
+    // of the host database: no callback.
+    PgSqlHostContextPtr ctx(new PgSqlHostContext(replica_parameters_,
+        IOServiceAccessorPtr(), db::DbCallback()));
+
+    // Open the database.
+    ctx->conn_.openDatabase();
+
+    // Only the lookups are sent to the read replica.
+    ctx->conn_.prepareStatements(tagged_statements.begin(),
+                                 tagged_statements.begin() + WRITE_STMTS_BEGIN);
+    ctx->is_readonly_ = true;
+
+    ctx->host_ipv4_exchange_.reset(new PgSqlHostWithOptionsExchange(PgSqlHostWithOptionsExchange::DHCP4_ONLY));
+    ctx->host_ipv6_exchange_.reset(new PgSqlHostIPv6Exchange(PgSqlHostWithOptionsExchange::DHCP6_ONLY));
+    ctx->host_ipv46_exchange_.reset(new PgSqlHostIPv6Exchange(PgSqlHostWithOptionsExchange::DHCP4_AND_DHCP6));
+    ctx->host_ipv6_reservation_exchange_.reset(new PgSqlIPv6ReservationExchange());
+    ctx->host_option_exchange_.reset(new PgSqlOptionExchange());
+
+    return (ctx);
+}
+
+PgSqlHostContextPtr
+PgSqlHostDataSourceImpl::getReplicaContext() {
+    PgSqlHostContextPtr ctx;
+    if (!replica_pool_) {
+        return (ctx);
+    }
+    {
+        // we need to protect the whole pool_ operation, hence extra scope {}
+        lock_guard<mutex> lock(replica_pool_->mutex_);
+        if (time(0) < replica_retry_time_) {
+            return (ctx);
+        }
+        if (!replica_pool_->pool_.empty()) {
+            ctx = replica_pool_->pool_.back();
+            replica_pool_->pool_.pop_back();
+        }
+    }
+    try {
+        if (!ctx) {
+            ctx = createReplicaContext();
+        }
+        if (replica_max_lag_ > 0) {
+            int64_t lag = ctx->conn_.getReplicationLag();
+            if ((lag < 0) || (lag > replica_max_lag_)) {
+                LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+                          DHCPSRV_PGSQL_REPLICA_LAG)
+                    .arg(lag)
+                    .arg(replica_max_lag_);
+                releaseReplicaContext(ctx);
+                return (PgSqlHostContextPtr());
+            }
+        }
+    } catch (const std::exception& ex) {
+        LOG_WARN(dhcpsrv_logger, DHCPSRV_PGSQL_REPLICA_UNAVAILABLE)
+            .arg(ex.what());
+        lock_guard<mutex> lock(replica_pool_->mutex_);
+        replica_retry_time_ = time(0) +
+            DatabaseConnection::REPLICA_RETRY_INTERVAL;
+        return (PgSqlHostContextPtr());
+    }
+    return (ctx);
+}
+
+void
+PgSqlHostDataSourceImpl::releaseReplicaContext(const PgSqlHostContextPtr& ctx) {
+    if (ctx->conn_.isUnusable()) {
+        return;
+    }
+    lock_guard<mutex> lock(replica_pool_->mutex_);
+    replica_pool_->pool_.push_back(ctx);
+}
+
 PgSqlHostDataSourceImpl::~PgSqlHostDataSourceImpl() {
 }
 
@@ -2519,6 +2754,48 @@ PgSqlHostDataSourceImpl::addOptions(PgSqlHostContextPtr& ctx,
     }
 }
 
+void
+PgSqlHostDataSourceImpl::addHost(PgSqlHostContextPtr& ctx, const HostPtr& host) {
+    // If we're configured to check that an IP reservation within a given subnet
+    // is unique, the IP reservation exists and the subnet is actually set
+    // we will be using a special query that checks for uniqueness. Otherwise,
+    // we will use a regular insert statement.
+    bool unique_ip = ip_reservations_unique_ && !host->getIPv4Reservation().isV4Zero()
+        && host->getIPv4SubnetID() != SUBNET_ID_UNUSED;
+
+    // Create the PgSQL Bind array for the host
+    PsqlBindArrayPtr bind_array = ctx->host_ipv4_exchange_->createBindForSend(host, unique_ip);
+
+    // ... and insert the host.
+    uint32_t host_id = addStatement(ctx,
+                                    unique_ip ? INSERT_HOST_UNIQUE_IP :
+                                    INSERT_HOST_NON_UNIQUE_IP,
+                                    bind_array, true);
+
+    // Insert DHCPv4 options.
+    ConstCfgOptionPtr cfg_option4 = host->getCfgOption4();
+    if (cfg_option4) {
+        addOptions(ctx, INSERT_V4_HOST_OPTION,
+                   cfg_option4, host_id);
+    }
+
+    // Insert DHCPv6 options.
+    ConstCfgOptionPtr cfg_option6 = host->getCfgOption6();
+    if (cfg_option6) {
+        addOptions(ctx, INSERT_V6_HOST_OPTION,
+                   cfg_option6, host_id);
+    }
+
+    // Insert IPv6 reservations.
+    IPv6ResrvRange v6resv = host->getIPv6Reservations();
+    if (std::distance(v6resv.first, v6resv.second) > 0) {
+        for (IPv6ResrvIterator resv = v6resv.first; resv != v6resv.second;
+             ++resv) {
+            addResv(ctx, resv->second, host_id);
+        }
+    }
+}
+
 void
 PgSqlHostDataSourceImpl::getHostCollection(PgSqlHostContextPtr& ctx,
                                            StatementIndex stindex,
@@ -2581,6 +2858,42 @@ PgSqlHostDataSourceImpl::getHost(PgSqlHostContextPtr& ctx,
     return (result);
 }
 
+ConstHostCollection
+PgSqlHostDataSourceImpl::getHostsByIdentifiers(PgSqlHostContextPtr& ctx,
+                                               const SubnetID& subnet_id,
+                                               const HostIdentifierList& identifiers,
+                                               StatementIndex stindex,
+                                               boost::shared_ptr<PgSqlHostExchange> exchange) const {
+    if (identifiers.empty() || (identifiers.size() > MAX_IDENTIFIERS)) {
+        isc_throw(BadValue, "expected 1 to " << MAX_IDENTIFIERS
+                  << " identifiers, got " << identifiers.size());
+    }
+
+    // Set up the WHERE clause value
+    PsqlBindArrayPtr bind_array(new PsqlBindArray());
+
+    // Add the subnet id.
+    bind_array->add(subnet_id);
+
+    // Add the identifier types and values, the unused slots repeating
+    // the last identifier. The values are not copied, they remain in
+    // scope until the query is done.
+    auto identifier = identifiers.begin();
+    const HostIdentifier* last = 0;
+    for (size_t i = 0; i < MAX_IDENTIFIERS; ++i) {
+        if (identifier != identifiers.end()) {
+            last = &(*identifier);
+            ++identifier;
+        }
+        bind_array->add(static_cast<uint8_t>(last->first));
+        bind_array->add(last->second);
+    }
+
+    ConstHostCollection collection;
+    getHostCollection(ctx, stindex, bind_array, exchange, collection, false);
+    return (collection);
+}
+
 std::pair<uint32_t, uint32_t>
 PgSqlHostDataSourceImpl::getVersion() const {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
@@ -2625,47 +2938,31 @@ PgSqlHostDataSource::add(const HostPtr& host) {
     // the PgSqlTransaction class.
     PgSqlTransaction transaction(ctx->conn_);
 
-    // If we're configured to check that an IP reservation within a given subnet
-    // is unique, the IP reservation exists and the subnet is actually set
-    // we will be using a special query that checks for uniqueness. Otherwise,
-    // we will use a regular insert statement.
-    bool unique_ip = impl_->ip_reservations_unique_ && !host->getIPv4Reservation().isV4Zero()
-        && host->getIPv4SubnetID() != SUBNET_ID_UNUSED;
-
-    // Create the PgSQL Bind array for the host
-    PsqlBindArrayPtr bind_array = ctx->host_ipv4_exchange_->createBindForSend(host, unique_ip);
+    impl_->addHost(ctx, host);
 
-    // ... and insert the host.
-    uint32_t host_id = impl_->addStatement(ctx,
-                                           unique_ip ? PgSqlHostDataSourceImpl::INSERT_HOST_UNIQUE_IP :
-                                           PgSqlHostDataSourceImpl::INSERT_HOST_NON_UNIQUE_IP,
-                                           bind_array, true);
+    // Everything went fine, so explicitly commit the transaction.
+    transaction.commit();
+}
 
-    // Insert DHCPv4 options.
-    ConstCfgOptionPtr cfg_option4 = host->getCfgOption4();
-    if (cfg_option4) {
-        impl_->addOptions(ctx, PgSqlHostDataSourceImpl::INSERT_V4_HOST_OPTION,
-                          cfg_option4, host_id);
-    }
+void
+PgSqlHostDataSource::addHosts(const HostCollection& hosts) {
+    // Get a context
+    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostContextPtr ctx = get_context.ctx_;
 
-    // Insert DHCPv6 options.
-    ConstCfgOptionPtr cfg_option6 = host->getCfgOption6();
-    if (cfg_option6) {
-        impl_->addOptions(ctx, PgSqlHostDataSourceImpl::INSERT_V6_HOST_OPTION,
-                          cfg_option6, host_id);
-    }
+    // If operating in read-only mode, throw exception.
+    impl_->checkReadOnly(ctx);
 
-    // Insert IPv6 reservations.
-    IPv6ResrvRange v6resv = host->getIPv6Reservations();
-    if (std::distance(v6resv.first, v6resv.second) > 0) {
-        for (IPv6ResrvIterator resv = v6resv.first; resv != v6resv.second;
-             ++resv) {
-            impl_->addResv(ctx, resv->second, host_id);
+    // Insert the hosts by batches, each in its own transaction, so a
+    // bulk import does not pay for one commit per host.
+    for (size_t first = 0; first < hosts.size(); first += HOSTS_BATCH_SIZE) {
+        size_t last = std::min(hosts.size(), first + HOSTS_BATCH_SIZE);
+        PgSqlTransaction transaction(ctx->conn_);
+        for (size_t i = first; i < last; ++i) {
+            impl_->addHost(ctx, hosts[i]);
         }
+        transaction.commit();
     }
-
-    // Everything went fine, so explicitly commit the transaction.
-    transaction.commit();
 }
 
 bool
@@ -2754,7 +3051,7 @@ PgSqlHostDataSource::getAll(const Host::IdentifierType& identifier_type,
                             const uint8_t* identifier_begin,
                             const size_t identifier_len) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -2776,7 +3073,7 @@ PgSqlHostDataSource::getAll(const Host::IdentifierType& identifier_type,
 ConstHostCollection
 PgSqlHostDataSource::getAll4(const SubnetID& subnet_id) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -2795,7 +3092,7 @@ PgSqlHostDataSource::getAll4(const SubnetID& subnet_id) const {
 ConstHostCollection
 PgSqlHostDataSource::getAll6(const SubnetID& subnet_id) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -2814,7 +3111,7 @@ PgSqlHostDataSource::getAll6(const SubnetID& subnet_id) const {
 ConstHostCollection
 PgSqlHostDataSource::getAllbyHostname(const std::string& hostname) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -2834,7 +3131,7 @@ ConstHostCollection
 PgSqlHostDataSource::getAllbyHostname4(const std::string& hostname,
                                        const SubnetID& subnet_id) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -2857,7 +3154,7 @@ ConstHostCollection
 PgSqlHostDataSource::getAllbyHostname6(const std::string& hostname,
                                        const SubnetID& subnet_id) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -2882,7 +3179,7 @@ PgSqlHostDataSource::getPage4(const SubnetID& subnet_id,
                               uint64_t lower_host_id,
                               const HostPageSize& page_size) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -2912,7 +3209,7 @@ PgSqlHostDataSource::getPage6(const SubnetID& subnet_id,
                               uint64_t lower_host_id,
                               const HostPageSize& page_size) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -2941,7 +3238,7 @@ PgSqlHostDataSource::getPage4(size_t& /*source_index*/,
                               uint64_t lower_host_id,
                               const HostPageSize& page_size) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -2967,7 +3264,7 @@ PgSqlHostDataSource::getPage6(size_t& /*source_index*/,
                               uint64_t lower_host_id,
                               const HostPageSize& page_size) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -2991,7 +3288,7 @@ PgSqlHostDataSource::getPage6(size_t& /*source_index*/,
 ConstHostCollection
 PgSqlHostDataSource::getAll4(const asiolink::IOAddress& address) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -3013,7 +3310,7 @@ PgSqlHostDataSource::get4(const SubnetID& subnet_id,
                           const uint8_t* identifier_begin,
                           const size_t identifier_len) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     return (impl_->getHost(ctx, subnet_id, identifier_type, identifier_begin, identifier_len,
@@ -3021,11 +3318,30 @@ PgSqlHostDataSource::get4(const SubnetID& subnet_id,
                            ctx->host_ipv4_exchange_));
 }
 
+ConstHostCollection
+PgSqlHostDataSource::getAllbyIdentifiers4(const SubnetID& subnet_id,
+                                         const HostIdentifierList& identifiers) const {
+    if (identifiers.empty()) {
+        return (ConstHostCollection());
+    }
+    if (identifiers.size() > PgSqlHostDataSourceImpl::MAX_IDENTIFIERS) {
+        return (BaseHostDataSource::getAllbyIdentifiers4(subnet_id, identifiers));
+    }
+
+    // Get a context
+    PgSqlHostReadContextAlloc get_context(*impl_);
+    PgSqlHostContextPtr ctx = get_context.ctx_;
+
+    return (impl_->getHostsByIdentifiers(ctx, subnet_id, identifiers,
+                                         PgSqlHostDataSourceImpl::GET_HOST_SUBID4_DHCPIDS,
+                                         ctx->host_ipv4_exchange_));
+}
+
 ConstHostPtr
 PgSqlHostDataSource::get4(const SubnetID& subnet_id,
                           const asiolink::IOAddress& address) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     if (!address.isV4()) {
@@ -3059,7 +3375,7 @@ ConstHostCollection
 PgSqlHostDataSource::getAll4(const SubnetID& subnet_id,
                              const asiolink::IOAddress& address) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     if (!address.isV4()) {
@@ -3088,7 +3404,7 @@ PgSqlHostDataSource::get6(const SubnetID& subnet_id,
                           const uint8_t* identifier_begin,
                           const size_t identifier_len) const {
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     return (impl_->getHost(ctx, subnet_id, identifier_type, identifier_begin, identifier_len,
@@ -3096,6 +3412,25 @@ PgSqlHostDataSource::get6(const SubnetID& subnet_id,
                            ctx->host_ipv6_exchange_));
 }
 
+ConstHostCollection
+PgSqlHostDataSource::getAllbyIdentifiers6(const SubnetID& subnet_id,
+                                         const HostIdentifierList& identifiers) const {
+    if (identifiers.empty()) {
+        return (ConstHostCollection());
+    }
+    if (identifiers.size() > PgSqlHostDataSourceImpl::MAX_IDENTIFIERS) {
+        return (BaseHostDataSource::getAllbyIdentifiers6(subnet_id, identifiers));
+    }
+
+    // Get a context
+    PgSqlHostReadContextAlloc get_context(*impl_);
+    PgSqlHostContextPtr ctx = get_context.ctx_;
+
+    return (impl_->getHostsByIdentifiers(ctx, subnet_id, identifiers,
+                                         PgSqlHostDataSourceImpl::GET_HOST_SUBID6_DHCPIDS,
+                                         ctx->host_ipv6_exchange_));
+}
+
 ConstHostPtr
 PgSqlHostDataSource::get6(const asiolink::IOAddress& prefix,
                           const uint8_t prefix_len) const {
@@ -3105,7 +3440,7 @@ PgSqlHostDataSource::get6(const asiolink::IOAddress& prefix,
     }
 
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -3139,7 +3474,7 @@ PgSqlHostDataSource::get6(const SubnetID& subnet_id,
     }
 
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -3173,7 +3508,7 @@ PgSqlHostDataSource::getAll6(const SubnetID& subnet_id,
     }
 
     // Get a context
-    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostReadContextAlloc get_context(*impl_);
     PgSqlHostContextPtr ctx = get_context.ctx_;
 
     // Set up the WHERE clause value
@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,6 +12,8 @@
 #include <pgsql/pgsql_connection.h>
 #include <pgsql/pgsql_exchange.h>
 
+#include <memory>
+
 namespace isc {
 namespace dhcp {
 
@@ -117,6 +119,18 @@ public:
     /// violation
     virtual void add(const HostPtr& host);
 
+    /// @brief Adds a collection of new hosts.
+    ///
+    /// The hosts are inserted by batches of @c HOSTS_BATCH_SIZE, each
+    /// batch in its own transaction. When a host can't be inserted the
+    /// exception is propagated, the batch of this host is rolled back
+    /// and the hosts of the previous batches stay in the database.
+    ///
+    /// @param hosts Collection of the new @c Host objects being added.
+    /// @throw DuplicateEntry or DbOperationError dependent on the constraint
+    /// violation
+    virtual void addHosts(const HostCollection& hosts);
+
     /// @brief Attempts to delete hosts by (subnet-id, address)
     ///
     /// This method supports both v4 and v6.
@@ -346,6 +360,20 @@ public:
                               const uint8_t* identifier_begin,
                               const size_t identifier_len) const;
 
+    /// @brief Returns the hosts connected to the IPv4 subnet using any of
+    /// the identifiers.
+    ///
+    /// Looks for all identifiers with a single query when there are not
+    /// more identifiers than identifier types.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Identifiers to look for.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAllbyIdentifiers4(const SubnetID& subnet_id,
+                         const HostIdentifierList& identifiers) const;
+
     /// @brief Returns a host connected to the IPv4 subnet and having
     /// a reservation for a specified IPv4 address.
     ///
@@ -405,6 +433,20 @@ public:
                               const uint8_t* identifier_begin,
                               const size_t identifier_len) const;
 
+    /// @brief Returns the hosts connected to the IPv6 subnet using any of
+    /// the identifiers.
+    ///
+    /// Looks for all identifiers with a single query when there are not
+    /// more identifiers than identifier types.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Identifiers to look for.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAllbyIdentifiers6(const SubnetID& subnet_id,
+                         const HostIdentifierList& identifiers) const;
+
     /// @brief Returns a host using the specified IPv6 prefix.
     ///
     /// @param prefix IPv6 prefix for which the @c Host object is searched.
@@ -547,6 +589,38 @@ public:
         PgSqlHostDataSourceImpl& mgr_;
     };
 
+    /// @brief Context RAII Allocator for the host lookups.
+    ///
+    /// The host lookups can tolerate the replication lag of the read
+    /// replica so they use it when it is configured and available.
+    class PgSqlHostReadContextAlloc {
+    public:
+
+        /// @brief Constructor
+        ///
+        /// This constructor takes a context of the read replica when it is
+        /// available or falls back to a context of the primary pool.
+        ///
+        /// @param mgr A parent instance
+        PgSqlHostReadContextAlloc(PgSqlHostDataSourceImpl& mgr);
+
+        /// @brief Destructor
+        ///
+        /// This destructor puts back the context in its pool.
+        ~PgSqlHostReadContextAlloc();
+
+        /// @brief The context
+        PgSqlHostContextPtr ctx_;
+
+    private:
+        /// @brief The manager
+        PgSqlHostDataSourceImpl& mgr_;
+
+        /// @brief The allocator of the primary context when the replica
+        /// is not used.
+        std::unique_ptr<PgSqlHostContextAlloc> primary_;
+    };
+
 private:
     /// @brief Pointer to the implementation of the @ref PgSqlHostDataSource.
     PgSqlHostDataSourceImplPtr impl_;
@@ -52,6 +52,16 @@ PgSqlTaggedStatement tagged_statements[] = {
       "DELETE FROM lease4 "
           "WHERE state = $1 AND expire < $2"},
 
+    // DELETE_LEASE4_SUBID
+    { 1, { OID_INT8 },
+      "delete_lease4_subid",
+      "DELETE FROM lease4 WHERE subnet_id = $1"},
+
+    // DELETE_LEASE4_ALL
+    { 0, { OID_NONE },
+      "delete_lease4_all",
+      "DELETE FROM lease4"},
+
     // DELETE_LEASE6
     { 2, { OID_VARCHAR, OID_TIMESTAMP },
       "delete_lease6",
@@ -63,6 +73,16 @@ PgSqlTaggedStatement tagged_statements[] = {
       "DELETE FROM lease6 "
           "WHERE state = $1 AND expire < $2"},
 
+    // DELETE_LEASE6_SUBID
+    { 1, { OID_INT8 },
+      "delete_lease6_subid",
+      "DELETE FROM lease6 WHERE subnet_id = $1"},
+
+    // DELETE_LEASE6_ALL
+    { 0, { OID_NONE },
+      "delete_lease6_all",
+      "DELETE FROM lease6"},
+
     // GET_LEASE4
     { 0, { OID_NONE },
       "get_lease4",
@@ -502,6 +522,66 @@ PgSqlTaggedStatement tagged_statements[] = {
           "FROM lease6_stat_by_client_class "
           "WHERE client_class = $1 AND lease_type = $2"},
 
+    // RECLAIM_LEASE4_EXPIRE
+    { 3, { OID_INT8, OID_TIMESTAMP, OID_INT8 },
+      "reclaim_lease4_expire",
+      "WITH expired AS ("
+        "SELECT address, hwaddr, client_id, "
+          "valid_lifetime, expire, subnet_id, "
+          "fqdn_fwd, fqdn_rev, hostname, "
+          "state, user_context, relay_id, remote_id "
+        "FROM lease4 "
+        "WHERE state != $1 AND valid_lifetime != 4294967295 AND expire < $2 "
+        "ORDER BY expire "
+        "LIMIT $3 "
+        "FOR UPDATE SKIP LOCKED) "
+      "UPDATE lease4 SET "
+        "state = $1, hostname = '', fqdn_fwd = FALSE, fqdn_rev = FALSE "
+      "FROM expired "
+      "WHERE lease4.address = expired.address "
+      "RETURNING expired.address, expired.hwaddr, expired.client_id, "
+        "expired.valid_lifetime, extract(epoch from expired.expire)::bigint, "
+        "expired.subnet_id, expired.fqdn_fwd, expired.fqdn_rev, "
+        "expired.hostname, expired.state, expired.user_context, "
+        "expired.relay_id, expired.remote_id"},
+
+    // DELETE_LEASE4_EXPIRE
+    { 3, { OID_INT8, OID_TIMESTAMP, OID_INT8 },
+      "delete_lease4_expire",
+      "DELETE FROM lease4 "
+      "WHERE address IN ("
+        "SELECT address FROM lease4 "
+        "WHERE state != $1 AND valid_lifetime != 4294967295 AND expire < $2 "
+        "ORDER BY expire "
+        "LIMIT $3 "
+        "FOR UPDATE SKIP LOCKED) "
+      "RETURNING address, hwaddr, client_id, "
+        "valid_lifetime, extract(epoch from expire)::bigint, subnet_id, "
+        "fqdn_fwd, fqdn_rev, hostname, "
+        "state, user_context, relay_id, remote_id"},
+
+    // INSERT_FREE_LEASE4
+    // The candidates are the first address of the range and the addresses
+    // following a lease of the range: the lowest of them without a lease
+    // is the first free address. The address parameter ($1) is unused.
+    { 15, { OID_INT8, OID_BYTEA, OID_BYTEA, OID_INT8, OID_TIMESTAMP, OID_INT8,
+            OID_BOOL, OID_BOOL, OID_VARCHAR, OID_INT8, OID_TEXT, OID_BYTEA,
+            OID_BYTEA, OID_INT8, OID_INT8 },
+      "insert_free_lease4",
+      "INSERT INTO lease4(address, hwaddr, client_id, "
+        "valid_lifetime, expire, subnet_id, fqdn_fwd, fqdn_rev, hostname, "
+        "state, user_context, relay_id, remote_id) "
+      "SELECT c.address, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12, $13 "
+      "FROM ("
+        "SELECT $14::BIGINT AS address "
+        "UNION ALL "
+        "SELECT l.address + 1 FROM lease4 AS l "
+          "WHERE l.address >= $14 AND l.address < $15) AS c "
+      "WHERE NOT EXISTS (SELECT 1 FROM lease4 AS u WHERE u.address = c.address) "
+      "ORDER BY c.address "
+      "LIMIT 1 "
+      "RETURNING address"},
+
     // End of list sentinel
     { 0,  { 0 }, NULL, NULL}
 };
@@ -1365,7 +1445,8 @@ bool PgSqlLeaseStatsQuery::negative_count_ = false;
 PgSqlLeaseContext::PgSqlLeaseContext(const DatabaseConnection::ParameterMap& parameters,
                                      IOServiceAccessorPtr io_service_accessor,
                                      DbCallback db_reconnect_callback)
-    : conn_(parameters, io_service_accessor, db_reconnect_callback) {
+    : conn_(parameters, io_service_accessor, db_reconnect_callback),
+      is_replica_(false) {
 }
 
 // PgSqlLeaseContextAlloc Constructor and Destructor
@@ -1377,10 +1458,11 @@ PgSqlLeaseMgr::PgSqlLeaseContextAlloc::PgSqlLeaseContextAlloc(
         // multi-threaded
         {
             // we need to protect the whole pool_ operation, hence extra scope {}
-            lock_guard<mutex> lock(mgr_.pool_->mutex_);
-            if (!mgr_.pool_->pool_.empty()) {
-                ctx_ = mgr_.pool_->pool_.back();
-                mgr_.pool_->pool_.pop_back();
+            PgSqlLeaseContextPoolPtr pool = mgr_.getContextPool();
+            lock_guard<mutex> lock(pool->mutex_);
+            if (!pool->pool_.empty()) {
+                ctx_ = pool->pool_.back();
+                pool->pool_.pop_back();
             }
         }
         if (!ctx_) {
@@ -1398,28 +1480,56 @@ PgSqlLeaseMgr::PgSqlLeaseContextAlloc::PgSqlLeaseContextAlloc(
 PgSqlLeaseMgr::PgSqlLeaseContextAlloc::~PgSqlLeaseContextAlloc() {
     if (MultiThreadingMgr::instance().getMode()) {
         // multi-threaded
-        lock_guard<mutex> lock(mgr_.pool_->mutex_);
-        mgr_.pool_->pool_.push_back(ctx_);
+        PgSqlLeaseContextPoolPtr pool = mgr_.getContextPool();
+        lock_guard<mutex> lock(pool->mutex_);
+        pool->pool_.push_back(ctx_);
     }
     // If running in single-threaded mode, there's nothing to do here.
 }
 
+// PgSqlLeaseReadContextAlloc Constructor and Destructor
+
+PgSqlLeaseMgr::PgSqlLeaseReadContextAlloc::PgSqlLeaseReadContextAlloc(
+    const PgSqlLeaseMgr& mgr) : ctx_(), mgr_(mgr), primary_() {
+
+    ctx_ = mgr_.getReplicaContext();
+    if (!ctx_) {
+        primary_.reset(new PgSqlLeaseContextAlloc(mgr_));
+        ctx_ = primary_->ctx_;
+    }
+}
+
+PgSqlLeaseMgr::PgSqlLeaseReadContextAlloc::~PgSqlLeaseReadContextAlloc() {
+    // The primary context is put back by its allocator.
+    if (!primary_) {
+        mgr_.releaseReplicaContext(ctx_);
+    }
+}
+
 // PgSqlLeaseTrackingContextAlloc Constructor and Destructor
 
 PgSqlLeaseMgr::PgSqlLeaseTrackingContextAlloc::PgSqlLeaseTrackingContextAlloc(
     PgSqlLeaseMgr& mgr, const LeasePtr& lease) : ctx_(), mgr_(mgr), lease_(lease) {
 
+    // Don't overtake the asynchronous changes submitted by this thread.
+    mgr_.waitForAsync();
+
     if (MultiThreadingMgr::instance().getMode()) {
         // multi-threaded
         {
-            // we need to protect the whole pool_ operation, hence extra scope {}
+            // The lease locks are protected by the mutex of the shared pool.
             lock_guard<mutex> lock(mgr_.pool_->mutex_);
             if (mgr_.hasCallbacks() && !mgr_.tryLock(lease)) {
                 isc_throw(DbOperationError, "unable to lock the lease " << lease->addr_);
             }
-            if (!mgr_.pool_->pool_.empty()) {
-                ctx_ = mgr_.pool_->pool_.back();
-                mgr_.pool_->pool_.pop_back();
+        }
+        {
+            // we need to protect the whole pool_ operation, hence extra scope {}
+            PgSqlLeaseContextPoolPtr pool = mgr_.getContextPool();
+            lock_guard<mutex> lock(pool->mutex_);
+            if (!pool->pool_.empty()) {
+                ctx_ = pool->pool_.back();
+                pool->pool_.pop_back();
             }
         }
         if (!ctx_) {
@@ -1437,11 +1547,16 @@ PgSqlLeaseMgr::PgSqlLeaseTrackingContextAlloc::PgSqlLeaseTrackingContextAlloc(
 PgSqlLeaseMgr::PgSqlLeaseTrackingContextAlloc::~PgSqlLeaseTrackingContextAlloc() {
     if (MultiThreadingMgr::instance().getMode()) {
         // multi-threaded
-        lock_guard<mutex> lock(mgr_.pool_->mutex_);
-        if (mgr_.hasCallbacks()) {
-            mgr_.unlock(lease_);
+        {
+            // The lease locks are protected by the mutex of the shared pool.
+            lock_guard<mutex> lock(mgr_.pool_->mutex_);
+            if (mgr_.hasCallbacks()) {
+                mgr_.unlock(lease_);
+            }
         }
-        mgr_.pool_->pool_.push_back(ctx_);
+        PgSqlLeaseContextPoolPtr pool = mgr_.getContextPool();
+        lock_guard<mutex> lock(pool->mutex_);
+        pool->pool_.push_back(ctx_);
     }
     // If running in single-threaded mode, there's nothing to do here.
 }
@@ -1454,7 +1569,10 @@ PgSqlLeaseMgr::setExtendedInfoTablesEnabled(const db::DatabaseConnection::Parame
 // PgSqlLeaseMgr Constructor and Destructor
 
 PgSqlLeaseMgr::PgSqlLeaseMgr(const DatabaseConnection::ParameterMap& parameters)
-    : TrackingLeaseMgr(), parameters_(parameters), timer_name_("") {
+    : TrackingLeaseMgr(), parameters_(parameters), single_query_allocation_(false),
+      replica_parameters_(DatabaseConnection::getReplicaParameters(parameters)),
+      replica_max_lag_(DatabaseConnection::getReplicaMaxLag(parameters)),
+      replica_retry_time_(0), timer_name_("") {
 
     // Check if the extended info tables are enabled.
     LeaseMgr::setExtendedInfoTablesEnabled(parameters);
@@ -1501,9 +1619,73 @@ PgSqlLeaseMgr::PgSqlLeaseMgr(const DatabaseConnection::ParameterMap& parameters)
     // Create an initial context.
     pool_.reset(new PgSqlLeaseContextPool());
     pool_->pool_.push_back(createContext());
+
+    // Create the contexts of the packet processing threads in advance so
+    // the first packets do not wait for the connections to be opened and
+    // the statements to be prepared.
+    uint32_t pool_size = getPoolSize(parameters);
+    if (pool_size > 0) {
+        auto contexts = createContexts<PgSqlLeaseContextPtr>(pool_size,
+            [this]() { return (createContext()); });
+        pool_->pool_.insert(pool_->pool_.end(), contexts.begin(),
+                            contexts.end());
+    }
+
+    // The read replica contexts are created on demand: an unavailable
+    // replica must not prevent the server from starting.
+    if (!replica_parameters_.empty()) {
+        replica_pool_.reset(new PgSqlLeaseContextPool());
+    }
+
+    // Create the pipeline shared by the threads.
+    if (usePipeline()) {
+        if (!PgSqlPipeline::isSupported()) {
+            isc_throw(DbOpenError, "Attempt to configure the pipeline mode for"
+                      " PostgreSQL backend (libpq does not support it)");
+        }
+        pipeline_ctx_ = createContext();
+        pipeline_.reset(new PgSqlPipeline(pipeline_ctx_->conn_));
+        LOG_INFO(dhcpsrv_logger, DHCPSRV_PGSQL_PIPELINE_MODE);
+    }
+
+    // Pick and insert the free leases in a single query.
+    single_query_allocation_ = useSingleQueryAllocation();
+
+    // Start the threads executing the asynchronous lease operations.
+    startAsync(getAsyncThreads(parameters));
+
+    // Start the threads writing the leases for the packet processing threads
+    // with one context per writer thread.
+    uint32_t writer_threads = getWriterThreads(parameters);
+    writer_pool_.reset(new PgSqlLeaseContextPool());
+    if (writer_threads > 0) {
+        auto contexts = createContexts<PgSqlLeaseContextPtr>(writer_threads,
+            [this]() { return (createContext()); });
+        writer_pool_->pool_.insert(writer_pool_->pool_.end(), contexts.begin(),
+                                   contexts.end());
+    }
+    startWriters(writer_threads);
+
+    // Count the leases for the lease limits in memory.
+    if (getInMemoryLimits(parameters)) {
+        enableLimitCounter();
+    }
+
+    // Count the leases for the lease statistics in memory.
+    if (getInMemoryStats(parameters)) {
+        enableStatsCounter();
+    }
 }
 
 PgSqlLeaseMgr::~PgSqlLeaseMgr() {
+    // The asynchronous operations and the writer threads use the contexts.
+    stopWriters();
+    stopAsync();
+}
+
+PgSqlLeaseContextPoolPtr
+PgSqlLeaseMgr::getContextPool() const {
+    return (isWriterThread() ? writer_pool_ : pool_);
 }
 
 bool
@@ -1573,6 +1755,40 @@ PgSqlLeaseMgr::dbReconnect(ReconnectCtlPtr db_reconnect_ctl) {
     return (true);
 }
 
+bool
+PgSqlLeaseMgr::usePipeline() const {
+    std::string pipeline = "false";
+    auto param = parameters_.find("pipeline");
+    if (param != parameters_.end()) {
+        pipeline = param->second;
+    }
+
+    if (pipeline == "true") {
+        return (true);
+    } else if (pipeline != "false") {
+        isc_throw(isc::BadValue, "invalid value of the pipeline "
+                  << pipeline << " specified");
+    }
+    return (false);
+}
+
+bool
+PgSqlLeaseMgr::useSingleQueryAllocation() const {
+    std::string single_query = "false";
+    auto param = parameters_.find("single-query-allocation");
+    if (param != parameters_.end()) {
+        single_query = param->second;
+    }
+
+    if (single_query == "true") {
+        return (true);
+    } else if (single_query != "false") {
+        isc_throw(isc::BadValue, "invalid value of the single-query-allocation "
+                  << single_query << " specified");
+    }
+    return (false);
+}
+
 // Create context.
 
 PgSqlLeaseContextPtr
@@ -1581,6 +1797,29 @@ PgSqlLeaseMgr::createContext() const {
         IOServiceAccessorPtr(new IOServiceAccessor(&LeaseMgr::getIOService)),
         &PgSqlLeaseMgr::dbReconnect));
 
+    openContext(ctx);
+
+    // Create ReconnectCtl for this connection.
+    ctx->conn_.makeReconnectCtl(timer_name_);
+
+    return (ctx);
+}
+
+PgSqlLeaseContextPtr
+PgSqlLeaseMgr::createReplicaContext() const {
+    // The losses of the replica connection do not trigger the recovery
+    // of the lease database: no callback.
+    PgSqlLeaseContextPtr ctx(new PgSqlLeaseContext(replica_parameters_,
+        IOServiceAccessorPtr(), DbCallback()));
+    ctx->is_replica_ = true;
+
+    openContext(ctx);
+
+    return (ctx);
+}
+
+void
+PgSqlLeaseMgr::openContext(PgSqlLeaseContextPtr& ctx) const {
     // Open the database.
     ctx->conn_.openDatabase();
 
@@ -1600,13 +1839,60 @@ PgSqlLeaseMgr::createContext() const {
     // program and the database.
     ctx->exchange4_.reset(new PgSqlLease4Exchange());
     ctx->exchange6_.reset(new PgSqlLease6Exchange());
+}
 
-    // Create ReconnectCtl for this connection.
-    ctx->conn_.makeReconnectCtl(timer_name_);
-
+PgSqlLeaseContextPtr
+PgSqlLeaseMgr::getReplicaContext() const {
+    PgSqlLeaseContextPtr ctx;
+    if (!replica_pool_) {
+        return (ctx);
+    }
+    {
+        // we need to protect the whole pool_ operation, hence extra scope {}
+        lock_guard<mutex> lock(replica_pool_->mutex_);
+        if (time(0) < replica_retry_time_) {
+            return (ctx);
+        }
+        if (!replica_pool_->pool_.empty()) {
+            ctx = replica_pool_->pool_.back();
+            replica_pool_->pool_.pop_back();
+        }
+    }
+    try {
+        if (!ctx) {
+            ctx = createReplicaContext();
+        }
+        if (replica_max_lag_ > 0) {
+            int64_t lag = ctx->conn_.getReplicationLag();
+            if ((lag < 0) || (lag > replica_max_lag_)) {
+                LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+                          DHCPSRV_PGSQL_REPLICA_LAG)
+                    .arg(lag)
+                    .arg(replica_max_lag_);
+                releaseReplicaContext(ctx);
+                return (PgSqlLeaseContextPtr());
+            }
+        }
+    } catch (const std::exception& ex) {
+        LOG_WARN(dhcpsrv_logger, DHCPSRV_PGSQL_REPLICA_UNAVAILABLE)
+            .arg(ex.what());
+        lock_guard<mutex> lock(replica_pool_->mutex_);
+        replica_retry_time_ = time(0) +
+            DatabaseConnection::REPLICA_RETRY_INTERVAL;
+        return (PgSqlLeaseContextPtr());
+    }
     return (ctx);
 }
 
+void
+PgSqlLeaseMgr::releaseReplicaContext(const PgSqlLeaseContextPtr& ctx) const {
+    if (ctx->conn_.isUnusable()) {
+        return;
+    }
+    lock_guard<mutex> lock(replica_pool_->mutex_);
+    replica_pool_->pool_.push_back(ctx);
+}
+
 std::string
 PgSqlLeaseMgr::getDBVersion() {
     std::stringstream tmp;
@@ -1616,33 +1902,69 @@ PgSqlLeaseMgr::getDBVersion() {
     return (tmp.str());
 }
 
+PgSqlResultPtr
+PgSqlLeaseMgr::executeStatement(PgSqlLeaseContextPtr& ctx,
+                                StatementIndex stindex,
+                                PsqlBindArray& bind_array) const {
+    // The statements of a transaction and the read-only queries sent
+    // to the replica must use the connection of the context.
+    if (pipeline_ && !ctx->is_replica_ && !ctx->conn_.isTransactionStarted()) {
+        return (pipeline_->executePreparedStatement(tagged_statements[stindex],
+                                                    bind_array));
+    }
+
+    const int n = tagged_statements[stindex].nbparams;
+    PgSqlResultPtr r(new PgSqlResult(PQexecPrepared(ctx->conn_,
+                                                    tagged_statements[stindex].name, n,
+                                                    n > 0 ? &bind_array.values_[0] : NULL,
+                                                    n > 0 ? &bind_array.lengths_[0] : NULL,
+                                                    n > 0 ? &bind_array.formats_[0] : NULL, 0)));
+
+    ctx->conn_.checkStatementError(*r, tagged_statements[stindex]);
+    return (r);
+}
+
 bool
 PgSqlLeaseMgr::addLeaseCommon(PgSqlLeaseContextPtr& ctx,
                               StatementIndex stindex,
                               PsqlBindArray& bind_array) {
-    PgSqlResult r(PQexecPrepared(ctx->conn_, tagged_statements[stindex].name,
-                                 tagged_statements[stindex].nbparams,
-                                 &bind_array.values_[0],
-                                 &bind_array.lengths_[0],
-                                 &bind_array.formats_[0], 0));
-
-    int s = PQresultStatus(r);
-
-    if (s != PGRES_COMMAND_OK) {
+    try {
+        executeStatement(ctx, stindex, bind_array);
+    } catch (const DuplicateEntry&) {
         // Failure: check for the special case of duplicate entry.  If this is
         // the case, we return false to indicate that the row was not added.
-        // Otherwise we throw an exception.
-        if (ctx->conn_.compareError(r, PgSqlConnection::DUPLICATE_KEY)) {
-            return (false);
-        }
-        ctx->conn_.checkStatementError(r, tagged_statements[stindex]);
+        return (false);
     }
 
     return (true);
 }
 
+bool
+PgSqlLeaseMgr::addLeaseInternal(PgSqlLeaseContextPtr& ctx,
+                                const Lease4Ptr& lease) {
+    PsqlBindArray bind_array;
+    ctx->exchange4_->createBindForSend(lease, bind_array);
+    return (addLeaseCommon(ctx, INSERT_LEASE4, bind_array));
+}
+
+bool
+PgSqlLeaseMgr::addLeaseInternal(PgSqlLeaseContextPtr& ctx,
+                                const Lease6Ptr& lease) {
+    PsqlBindArray bind_array;
+    ctx->exchange6_->createBindForSend(lease, bind_array);
+    return (addLeaseCommon(ctx, INSERT_LEASE6, bind_array));
+}
+
 bool
 PgSqlLeaseMgr::addLease(const Lease4Ptr& lease) {
+    // Let a writer thread write the lease with its own context.
+    bool outcome = false;
+    if (delegateWrite(lease, [this, &lease]() {
+            return (addLease(lease));
+        }, outcome)) {
+        return (outcome);
+    }
+
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_ADD_ADDR4)
         .arg(lease->addr_.toText());
 
@@ -1650,9 +1972,7 @@ PgSqlLeaseMgr::addLease(const Lease4Ptr& lease) {
     PgSqlLeaseTrackingContextAlloc get_context(*this, lease);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
-    PsqlBindArray bind_array;
-    ctx->exchange4_->createBindForSend(lease, bind_array);
-    auto result = addLeaseCommon(ctx, INSERT_LEASE4, bind_array);
+    auto result = addLeaseInternal(ctx, lease);
 
     // Update lease current expiration time (allows update between the creation
     // of the Lease up to the point of insertion in the database).
@@ -1668,6 +1988,14 @@ PgSqlLeaseMgr::addLease(const Lease4Ptr& lease) {
 
 bool
 PgSqlLeaseMgr::addLease(const Lease6Ptr& lease) {
+    // Let a writer thread write the lease with its own context.
+    bool outcome = false;
+    if (delegateWrite(lease, [this, &lease]() {
+            return (addLease(lease));
+        }, outcome)) {
+        return (outcome);
+    }
+
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_ADD_ADDR6)
         .arg(lease->addr_.toText())
         .arg(lease->type_);
@@ -1676,10 +2004,7 @@ PgSqlLeaseMgr::addLease(const Lease6Ptr& lease) {
     PgSqlLeaseTrackingContextAlloc get_context(*this, lease);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
-    PsqlBindArray bind_array;
-    ctx->exchange6_->createBindForSend(lease, bind_array);
-
-    auto result = addLeaseCommon(ctx, INSERT_LEASE6, bind_array);
+    auto result = addLeaseInternal(ctx, lease);
 
     // Update lease current expiration time (allows update between the creation
     // of the Lease up to the point of insertion in the database).
@@ -1701,16 +2026,9 @@ PgSqlLeaseMgr::getLeaseCollection(PgSqlLeaseContextPtr& ctx,
                                   Exchange& exchange,
                                   LeaseCollection& result,
                                   bool single) const {
-    const int n = tagged_statements[stindex].nbparams;
-    PgSqlResult r(PQexecPrepared(ctx->conn_,
-                                 tagged_statements[stindex].name, n,
-                                 n > 0 ? &bind_array.values_[0] : NULL,
-                                 n > 0 ? &bind_array.lengths_[0] : NULL,
-                                 n > 0 ? &bind_array.formats_[0] : NULL, 0));
+    PgSqlResultPtr r = executeStatement(ctx, stindex, bind_array);
 
-    ctx->conn_.checkStatementError(r, tagged_statements[stindex]);
-
-    int rows = PQntuples(r);
+    int rows = r->getRows();
     if (single && rows > 1) {
         isc_throw(MultipleRecords, "multiple records were found in the "
                       "database where only one was expected for query "
@@ -1718,7 +2036,7 @@ PgSqlLeaseMgr::getLeaseCollection(PgSqlLeaseContextPtr& ctx,
     }
 
     for(int i = 0; i < rows; ++ i) {
-        result.push_back(exchange->convertFromDatabase(r, i));
+        result.push_back(exchange->convertFromDatabase(*r, i));
     }
 }
 
@@ -1914,7 +2232,7 @@ PgSqlLeaseMgr::getLeases4(SubnetID subnet_id) const {
     Lease4Collection result;
 
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     getLeaseCollection(ctx, GET_LEASE4_SUBID, bind_array, result);
@@ -1937,7 +2255,7 @@ PgSqlLeaseMgr::getLeases4(const std::string& hostname) const {
     Lease4Collection result;
 
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     getLeaseCollection(ctx, GET_LEASE4_HOSTNAME, bind_array, result);
@@ -1955,7 +2273,7 @@ PgSqlLeaseMgr::getLeases4() const {
     Lease4Collection result;
 
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     getLeaseCollection(ctx, GET_LEASE4, bind_array, result);
@@ -1992,7 +2310,7 @@ PgSqlLeaseMgr::getLeases4(const IOAddress& lower_bound_address,
     Lease4Collection result;
 
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     getLeaseCollection(ctx, GET_LEASE4_PAGE, bind_array, result);
@@ -2119,7 +2437,7 @@ PgSqlLeaseMgr::getLeases6(SubnetID subnet_id) const {
     Lease6Collection result;
 
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     getLeaseCollection(ctx, GET_LEASE6_SUBID, bind_array, result);
@@ -2140,7 +2458,7 @@ PgSqlLeaseMgr::getLeases6(const DUID& duid) const {
     Lease6Collection result;
 
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     // query to fetch the data
@@ -2164,7 +2482,7 @@ PgSqlLeaseMgr::getLeases6(const std::string& hostname) const {
     Lease6Collection result;
 
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     getLeaseCollection(ctx, GET_LEASE6_HOSTNAME, bind_array, result);
@@ -2182,7 +2500,7 @@ PgSqlLeaseMgr::getLeases6() const {
     Lease6Collection result;
 
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     getLeaseCollection(ctx, GET_LEASE6, bind_array, result);
@@ -2226,7 +2544,7 @@ PgSqlLeaseMgr::getLeases6(const IOAddress& lower_bound_address,
     Lease6Collection result;
 
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     getLeaseCollection(ctx, GET_LEASE6_PAGE, bind_array, result);
@@ -2286,15 +2604,9 @@ PgSqlLeaseMgr::updateLeaseCommon(PgSqlLeaseContextPtr& ctx,
                                  StatementIndex stindex,
                                  PsqlBindArray& bind_array,
                                  const LeasePtr& lease) {
-    PgSqlResult r(PQexecPrepared(ctx->conn_, tagged_statements[stindex].name,
-                                 tagged_statements[stindex].nbparams,
-                                 &bind_array.values_[0],
-                                 &bind_array.lengths_[0],
-                                 &bind_array.formats_[0], 0));
+    PgSqlResultPtr r = executeStatement(ctx, stindex, bind_array);
 
-    ctx->conn_.checkStatementError(r, tagged_statements[stindex]);
-
-    int affected_rows = boost::lexical_cast<int>(PQcmdTuples(r));
+    int affected_rows = boost::lexical_cast<int>(PQcmdTuples(*r));
 
     // Check success case first as it is the most likely outcome.
     if (affected_rows == 1) {
@@ -2314,16 +2626,10 @@ PgSqlLeaseMgr::updateLeaseCommon(PgSqlLeaseContextPtr& ctx,
 }
 
 void
-PgSqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
+PgSqlLeaseMgr::updateLeaseInternal(PgSqlLeaseContextPtr& ctx,
+                                   const Lease4Ptr& lease) {
     const StatementIndex stindex = UPDATE_LEASE4;
 
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_UPDATE_ADDR4)
-        .arg(lease->addr_.toText());
-
-    // Get a context
-    PgSqlLeaseTrackingContextAlloc get_context(*this, lease);
-    PgSqlLeaseContextPtr ctx = get_context.ctx_;
-
     // Create the BIND array for the data being updated
     PsqlBindArray bind_array;
     ctx->exchange4_->createBindForSend(lease, bind_array);
@@ -2344,6 +2650,27 @@ PgSqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
 
     // Drop to common update code
     updateLeaseCommon(ctx, stindex, bind_array, lease);
+}
+
+void
+PgSqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
+    // Let a writer thread write the lease with its own context.
+    bool outcome = false;
+    if (delegateWrite(lease, [this, &lease]() {
+            updateLease4(lease);
+            return (true);
+        }, outcome)) {
+        return;
+    }
+
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_UPDATE_ADDR4)
+        .arg(lease->addr_.toText());
+
+    // Get a context
+    PgSqlLeaseTrackingContextAlloc get_context(*this, lease);
+    PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
+    updateLeaseInternal(ctx, lease);
 
     // Update lease current expiration time.
     lease->updateCurrentExpirationTime();
@@ -2355,17 +2682,10 @@ PgSqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
 }
 
 void
-PgSqlLeaseMgr::updateLease6(const Lease6Ptr& lease) {
+PgSqlLeaseMgr::updateLeaseInternal(PgSqlLeaseContextPtr& ctx,
+                                   const Lease6Ptr& lease) {
     const StatementIndex stindex = UPDATE_LEASE6;
 
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_UPDATE_ADDR6)
-        .arg(lease->addr_.toText())
-        .arg(lease->type_);
-
-    // Get a context
-    PgSqlLeaseTrackingContextAlloc get_context(*this, lease);
-    PgSqlLeaseContextPtr ctx = get_context.ctx_;
-
     // Create the BIND array for the data being updated
     PsqlBindArray bind_array;
     ctx->exchange6_->createBindForSend(lease, bind_array);
@@ -2386,6 +2706,28 @@ PgSqlLeaseMgr::updateLease6(const Lease6Ptr& lease) {
 
     // Drop to common update code
     updateLeaseCommon(ctx, stindex, bind_array, lease);
+}
+
+void
+PgSqlLeaseMgr::updateLease6(const Lease6Ptr& lease) {
+    // Let a writer thread write the lease with its own context.
+    bool outcome = false;
+    if (delegateWrite(lease, [this, &lease]() {
+            updateLease6(lease);
+            return (true);
+        }, outcome)) {
+        return;
+    }
+
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_UPDATE_ADDR6)
+        .arg(lease->addr_.toText())
+        .arg(lease->type_);
+
+    // Get a context
+    PgSqlLeaseTrackingContextAlloc get_context(*this, lease);
+    PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
+    updateLeaseInternal(ctx, lease);
 
     // Update lease current expiration time.
     lease->updateCurrentExpirationTime();
@@ -2400,23 +2742,16 @@ uint64_t
 PgSqlLeaseMgr::deleteLeaseCommon(PgSqlLeaseContextPtr& ctx,
                                  StatementIndex stindex,
                                  PsqlBindArray& bind_array) {
-    PgSqlResult r(PQexecPrepared(ctx->conn_, tagged_statements[stindex].name,
-                                 tagged_statements[stindex].nbparams,
-                                 &bind_array.values_[0],
-                                 &bind_array.lengths_[0],
-                                 &bind_array.formats_[0], 0));
-
-    ctx->conn_.checkStatementError(r, tagged_statements[stindex]);
-    int affected_rows = boost::lexical_cast<int>(PQcmdTuples(r));
+    PgSqlResultPtr r = executeStatement(ctx, stindex, bind_array);
+    int affected_rows = boost::lexical_cast<int>(PQcmdTuples(*r));
 
     return (affected_rows);
 }
 
 bool
-PgSqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
+PgSqlLeaseMgr::deleteLeaseInternal(PgSqlLeaseContextPtr& ctx,
+                                   const Lease4Ptr& lease) {
     const IOAddress& addr = lease->addr_;
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_DELETE_ADDR)
-        .arg(addr.toText());
 
     // Set up the WHERE clause value
     PsqlBindArray bind_array;
@@ -2434,17 +2769,10 @@ PgSqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
     }
     bind_array.add(expire_str);
 
-    // Get a context
-    PgSqlLeaseTrackingContextAlloc get_context(*this, lease);
-    PgSqlLeaseContextPtr ctx = get_context.ctx_;
-
     auto affected_rows = deleteLeaseCommon(ctx, DELETE_LEASE4, bind_array);
 
     // Check success case first as it is the most likely outcome.
     if (affected_rows == 1) {
-        if (hasCallbacks()) {
-            trackDeleteLease(lease, false);
-        }
         return (true);
     }
 
@@ -2460,12 +2788,38 @@ PgSqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
 }
 
 bool
-PgSqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
+PgSqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
+    // Let a writer thread write the lease with its own context.
+    bool outcome = false;
+    if (delegateWrite(lease, [this, &lease]() {
+            return (deleteLease(lease));
+        }, outcome)) {
+        return (outcome);
+    }
+
     const IOAddress& addr = lease->addr_;
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
-              DHCPSRV_PGSQL_DELETE_ADDR)
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_DELETE_ADDR)
         .arg(addr.toText());
 
+    // Get a context
+    PgSqlLeaseTrackingContextAlloc get_context(*this, lease);
+    PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
+    if (!deleteLeaseInternal(ctx, lease)) {
+        return (false);
+    }
+
+    if (hasCallbacks()) {
+        trackDeleteLease(lease, false);
+    }
+    return (true);
+}
+
+bool
+PgSqlLeaseMgr::deleteLeaseInternal(PgSqlLeaseContextPtr& ctx,
+                                   const Lease6Ptr& lease) {
+    const IOAddress& addr = lease->addr_;
+
     // Set up the WHERE clause value
     PsqlBindArray bind_array;
 
@@ -2482,17 +2836,10 @@ PgSqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
     }
     bind_array.add(expire_str);
 
-    // Get a context
-    PgSqlLeaseTrackingContextAlloc get_context(*this, lease);
-    PgSqlLeaseContextPtr ctx = get_context.ctx_;
-
     auto affected_rows = deleteLeaseCommon(ctx, DELETE_LEASE6, bind_array);
 
     // Check success case first as it is the most likely outcome.
     if (affected_rows == 1) {
-        if (hasCallbacks()) {
-            trackDeleteLease(lease, false);
-        }
         return (true);
     }
 
@@ -2507,6 +2854,274 @@ PgSqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
               "that had the address " << lease->addr_.toText());
 }
 
+bool
+PgSqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
+    // Let a writer thread write the lease with its own context.
+    bool outcome = false;
+    if (delegateWrite(lease, [this, &lease]() {
+            return (deleteLease(lease));
+        }, outcome)) {
+        return (outcome);
+    }
+
+    const IOAddress& addr = lease->addr_;
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+              DHCPSRV_PGSQL_DELETE_ADDR)
+        .arg(addr.toText());
+
+    // Get a context
+    PgSqlLeaseTrackingContextAlloc get_context(*this, lease);
+    PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
+    if (!deleteLeaseInternal(ctx, lease)) {
+        return (false);
+    }
+
+    if (hasCallbacks()) {
+        trackDeleteLease(lease, false);
+    }
+    return (true);
+}
+
+// Bulk lease methods. They perform the per lease statements in a single
+// transaction so the database commits the changes once. When callbacks
+// are installed the leases must be locked one by one so the per lease
+// methods are called instead.
+
+template <typename LeaseCollection>
+bool
+PgSqlLeaseMgr::addLeasesCommon(const LeaseCollection& leases, size_t& count) {
+    // Get a context
+    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
+    PgSqlTransaction transaction(ctx->conn_);
+    for (auto const& lease : leases) {
+        if (!addLeaseInternal(ctx, lease)) {
+            // A duplicate entry aborts the transaction: roll it back.
+            return (false);
+        }
+    }
+    transaction.commit();
+
+    // Update lease current expiration time only after the commit.
+    for (auto const& lease : leases) {
+        lease->updateCurrentExpirationTime();
+    }
+    count = leases.size();
+    return (true);
+}
+
+template <typename LeaseCollection>
+size_t
+PgSqlLeaseMgr::updateLeasesCommon(const LeaseCollection& leases) {
+    // Get a context
+    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
+    LeaseCollection updated;
+    PgSqlTransaction transaction(ctx->conn_);
+    for (auto const& lease : leases) {
+        try {
+            updateLeaseInternal(ctx, lease);
+            updated.push_back(lease);
+        } catch (const NoSuchLease&) {
+            // Skip the lease.
+        }
+    }
+    transaction.commit();
+
+    // Update lease current expiration time only after the commit.
+    for (auto const& lease : updated) {
+        lease->updateCurrentExpirationTime();
+    }
+    return (updated.size());
+}
+
+template <typename LeaseCollection>
+size_t
+PgSqlLeaseMgr::deleteLeasesCommon(const LeaseCollection& leases) {
+    // Get a context
+    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
+    size_t count = 0;
+    PgSqlTransaction transaction(ctx->conn_);
+    for (auto const& lease : leases) {
+        if (deleteLeaseInternal(ctx, lease)) {
+            ++count;
+        }
+    }
+    transaction.commit();
+    return (count);
+}
+
+size_t
+PgSqlLeaseMgr::addLeases4(const Lease4Collection& leases) {
+    if (leases.empty() || hasCallbacks()) {
+        return (LeaseMgr::addLeases4(leases));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_ADD_LEASES)
+        .arg(leases.size());
+    size_t count = 0;
+    if (!addLeasesCommon(leases, count)) {
+        // Some leases already exist: add the leases one by one.
+        return (LeaseMgr::addLeases4(leases));
+    }
+    return (count);
+}
+
+size_t
+PgSqlLeaseMgr::addLeases6(const Lease6Collection& leases) {
+    if (leases.empty() || hasCallbacks()) {
+        return (LeaseMgr::addLeases6(leases));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_ADD_LEASES)
+        .arg(leases.size());
+    size_t count = 0;
+    if (!addLeasesCommon(leases, count)) {
+        // Some leases already exist: add the leases one by one.
+        return (LeaseMgr::addLeases6(leases));
+    }
+    return (count);
+}
+
+size_t
+PgSqlLeaseMgr::updateLeases4(const Lease4Collection& leases) {
+    if (leases.empty() || hasCallbacks()) {
+        return (LeaseMgr::updateLeases4(leases));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_UPDATE_LEASES)
+        .arg(leases.size());
+    return (updateLeasesCommon(leases));
+}
+
+size_t
+PgSqlLeaseMgr::updateLeases6(const Lease6Collection& leases) {
+    if (leases.empty() || hasCallbacks()) {
+        return (LeaseMgr::updateLeases6(leases));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_UPDATE_LEASES)
+        .arg(leases.size());
+    return (updateLeasesCommon(leases));
+}
+
+size_t
+PgSqlLeaseMgr::deleteLeases4(const Lease4Collection& leases) {
+    if (leases.empty() || hasCallbacks()) {
+        return (LeaseMgr::deleteLeases4(leases));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_DELETE_LEASES)
+        .arg(leases.size());
+    return (deleteLeasesCommon(leases));
+}
+
+size_t
+PgSqlLeaseMgr::deleteLeases6(const Lease6Collection& leases) {
+    if (leases.empty() || hasCallbacks()) {
+        return (LeaseMgr::deleteLeases6(leases));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_DELETE_LEASES)
+        .arg(leases.size());
+    return (deleteLeasesCommon(leases));
+}
+
+size_t
+PgSqlLeaseMgr::reclaimExpiredLeases4(Lease4Collection& reclaimed_leases,
+                                     const size_t max_leases,
+                                     const bool remove_lease) {
+    if (hasCallbacks()) {
+        return (LeaseMgr::reclaimExpiredLeases4(reclaimed_leases, max_leases,
+                                                remove_lease));
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_RECLAIM_EXPIRED4)
+        .arg(max_leases);
+
+    PsqlBindArray bind_array;
+
+    // Exclude reclaimed leases, it is also the new state.
+    std::string state_str = boost::lexical_cast<std::string>(Lease::STATE_EXPIRED_RECLAIMED);
+    bind_array.add(state_str);
+
+    // Expiration timestamp.
+    std::string timestamp_str = PgSqlLeaseExchange::convertToDatabaseTime(time(0));
+    bind_array.add(timestamp_str);
+
+    // If the number of leases is 0, we will reclaim all leases. This is
+    // achieved by setting the limit to a very high value.
+    uint32_t limit = max_leases > 0 ? static_cast<uint32_t>(max_leases) :
+        std::numeric_limits<uint32_t>::max();
+    std::string limit_str = boost::lexical_cast<std::string>(limit);
+    bind_array.add(limit_str);
+
+    // Get a context
+    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
+    // The leases locked by another transaction are skipped: they will be
+    // reclaimed by a later batch.
+    Lease4Collection expired_leases;
+    getLeaseCollection(ctx, remove_lease ? DELETE_LEASE4_EXPIRE : RECLAIM_LEASE4_EXPIRE,
+                       bind_array, expired_leases);
+
+    reclaimed_leases.insert(reclaimed_leases.end(), expired_leases.begin(),
+                            expired_leases.end());
+    return (expired_leases.size());
+}
+
+bool
+PgSqlLeaseMgr::canAddFreeLease4() const {
+    return (single_query_allocation_ && !hasCallbacks());
+}
+
+bool
+PgSqlLeaseMgr::addFreeLease4(const Lease4Ptr& lease,
+                             const IOAddress& first_address,
+                             const IOAddress& last_address) {
+    if (!canAddFreeLease4()) {
+        return (false);
+    }
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_ADD_FREE_ADDR4)
+        .arg(first_address.toText())
+        .arg(last_address.toText());
+
+    // Get a context
+    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
+    PsqlBindArray bind_array;
+    ctx->exchange4_->createBindForSend(lease, bind_array);
+
+    // The range.
+    std::string first_str = boost::lexical_cast<std::string>(first_address.toUint32());
+    bind_array.add(first_str);
+    std::string last_str = boost::lexical_cast<std::string>(last_address.toUint32());
+    bind_array.add(last_str);
+
+    PgSqlResultPtr r;
+    try {
+        r = executeStatement(ctx, INSERT_FREE_LEASE4, bind_array);
+    } catch (const DuplicateEntry&) {
+        // Another client got the picked address first.
+        return (false);
+    }
+
+    // No free address in the range.
+    if (r->getRows() != 1) {
+        return (false);
+    }
+
+    uint32_t addr;
+    PgSqlExchange::getColumnValue(*r, 0, 0, addr);
+    lease->addr_ = IOAddress(addr);
+
+    // Update lease current expiration time (allows update between the creation
+    // of the Lease up to the point of insertion in the database).
+    lease->updateCurrentExpirationTime();
+
+    return (true);
+}
+
 uint64_t
 PgSqlLeaseMgr::deleteExpiredReclaimedLeases4(const uint32_t secs) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_DELETE_EXPIRED_RECLAIMED4)
@@ -2531,8 +3146,8 @@ PgSqlLeaseMgr::deleteExpiredReclaimedLeasesCommon(const uint32_t secs,
     bind_array.add(state_str);
 
     // Expiration timestamp.
-    std::string expiration_str = PgSqlLeaseExchange::convertToDatabaseTime(time(0) -
-        static_cast<time_t>(secs));
+    const time_t expire_limit = time(0) - static_cast<time_t>(secs);
+    std::string expiration_str = PgSqlLeaseExchange::convertToDatabaseTime(expire_limit);
     bind_array.add(expiration_str);
 
     // Get a context
@@ -2540,7 +3155,12 @@ PgSqlLeaseMgr::deleteExpiredReclaimedLeasesCommon(const uint32_t secs,
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     // Delete leases.
-    return (deleteLeaseCommon(ctx, statement_index, bind_array));
+    uint64_t deleted_leases = deleteLeaseCommon(ctx, statement_index, bind_array);
+
+    trackDeleteExpiredReclaimedLeases(statement_index == DELETE_LEASE4_STATE_EXPIRED ?
+                                      AF_INET : AF_INET6, expire_limit);
+
+    return (deleted_leases);
 }
 
 string
@@ -2575,11 +3195,17 @@ PgSqlLeaseMgr::checkLimits(ConstElementPtr const& user_context, StatementIndex c
 
 string
 PgSqlLeaseMgr::checkLimits4(ConstElementPtr const& user_context) const {
+    if (hasLimitCounter()) {
+        return (checkLimitsInMemory4(user_context));
+    }
     return checkLimits(user_context, CHECK_LEASE4_LIMITS);
 }
 
 string
 PgSqlLeaseMgr::checkLimits6(ConstElementPtr const& user_context) const {
+    if (hasLimitCounter()) {
+        return (checkLimitsInMemory6(user_context));
+    }
     return checkLimits(user_context, CHECK_LEASE6_LIMITS);
 }
 
@@ -2603,6 +3229,10 @@ PgSqlLeaseMgr::isJsonSupported() const {
 size_t
 PgSqlLeaseMgr::getClassLeaseCount(const ClientClass& client_class,
                                   const Lease::Type& ltype /* = Lease::TYPE_V4*/) const {
+    if (hasLimitCounter()) {
+        return (limit_counter_->getClassCount(client_class, ltype));
+    }
+
     // Get a context.
     PgSqlLeaseContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx(get_context.ctx_);
@@ -2638,16 +3268,28 @@ PgSqlLeaseMgr::getClassLeaseCount(const ClientClass& client_class,
 
 void
 PgSqlLeaseMgr::recountClassLeases4() {
+    if (hasLimitCounter()) {
+        recountLimitCounter(AF_INET);
+        return;
+    }
     isc_throw(NotImplemented, "PgSqlLeaseMgr::recountClassLeases4() not implemented");
 }
 
 void
 PgSqlLeaseMgr::recountClassLeases6() {
+    if (hasLimitCounter()) {
+        recountLimitCounter(AF_INET6);
+        return;
+    }
     isc_throw(NotImplemented, "PgSqlLeaseMgr::recountClassLeases6() not implemented");
 }
 
 void
 PgSqlLeaseMgr::clearClassLeaseCounts() {
+    if (hasLimitCounter()) {
+        limit_counter_->clear();
+        return;
+    }
     isc_throw(NotImplemented, "PgSqlLeaseMgr::clearClassLeaseCounts() not implemented");
 }
 
@@ -2663,8 +3305,12 @@ PgSqlLeaseMgr::writeLeases6(const std::string&) {
 
 LeaseStatsQueryPtr
 PgSqlLeaseMgr::startLeaseStatsQuery4() {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET));
+    }
+
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     LeaseStatsQueryPtr query(new PgSqlLeaseStatsQuery(ctx->conn_,
@@ -2676,8 +3322,12 @@ PgSqlLeaseMgr::startLeaseStatsQuery4() {
 
 LeaseStatsQueryPtr
 PgSqlLeaseMgr::startSubnetLeaseStatsQuery4(const SubnetID& subnet_id) {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET, subnet_id));
+    }
+
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     LeaseStatsQueryPtr query(new PgSqlLeaseStatsQuery(ctx->conn_,
@@ -2691,8 +3341,12 @@ PgSqlLeaseMgr::startSubnetLeaseStatsQuery4(const SubnetID& subnet_id) {
 LeaseStatsQueryPtr
 PgSqlLeaseMgr::startSubnetRangeLeaseStatsQuery4(const SubnetID& first_subnet_id,
                                                 const SubnetID& last_subnet_id) {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET, first_subnet_id, last_subnet_id));
+    }
+
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     LeaseStatsQueryPtr query(new PgSqlLeaseStatsQuery(ctx->conn_,
@@ -2706,8 +3360,12 @@ PgSqlLeaseMgr::startSubnetRangeLeaseStatsQuery4(const SubnetID& first_subnet_id,
 
 LeaseStatsQueryPtr
 PgSqlLeaseMgr::startLeaseStatsQuery6() {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET6));
+    }
+
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     LeaseStatsQueryPtr query(new PgSqlLeaseStatsQuery(ctx->conn_,
@@ -2719,8 +3377,12 @@ PgSqlLeaseMgr::startLeaseStatsQuery6() {
 
 LeaseStatsQueryPtr
 PgSqlLeaseMgr::startSubnetLeaseStatsQuery6(const SubnetID& subnet_id) {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET6, subnet_id));
+    }
+
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     LeaseStatsQueryPtr query(new PgSqlLeaseStatsQuery(ctx->conn_,
@@ -2734,8 +3396,12 @@ PgSqlLeaseMgr::startSubnetLeaseStatsQuery6(const SubnetID& subnet_id) {
 LeaseStatsQueryPtr
 PgSqlLeaseMgr::startSubnetRangeLeaseStatsQuery6(const SubnetID& first_subnet_id,
                                                 const SubnetID& last_subnet_id) {
+    if (hasStatsCounter()) {
+        return (startStatsCounterQuery(AF_INET6, first_subnet_id, last_subnet_id));
+    }
+
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     LeaseStatsQueryPtr query(new PgSqlLeaseStatsQuery(ctx->conn_,
@@ -2748,13 +3414,58 @@ PgSqlLeaseMgr::startSubnetRangeLeaseStatsQuery6(const SubnetID& first_subnet_id,
 }
 
 size_t
-PgSqlLeaseMgr::wipeLeases4(const SubnetID& /*subnet_id*/) {
-    isc_throw(NotImplemented, "wipeLeases4 is not implemented for PostgreSQL backend");
+PgSqlLeaseMgr::wipeLeases4(const SubnetID& subnet_id) {
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_PGSQL_WIPE_LEASES4)
+        .arg(subnet_id);
+
+    // The lease tracking needs the deleted leases.
+    if (hasCallbacks()) {
+        Lease4Collection leases;
+        if (subnet_id == 0) {
+            leases = getLeases4();
+        } else {
+            leases = getLeases4(subnet_id);
+        }
+        return (deleteLeases4(leases));
+    }
+    return (wipeLeasesCommon(subnet_id, subnet_id == 0 ?
+                             DELETE_LEASE4_ALL : DELETE_LEASE4_SUBID));
 }
 
 size_t
-PgSqlLeaseMgr::wipeLeases6(const SubnetID& /*subnet_id*/) {
-    isc_throw(NotImplemented, "wipeLeases6 is not implemented for PostgreSQL backend");
+PgSqlLeaseMgr::wipeLeases6(const SubnetID& subnet_id) {
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_PGSQL_WIPE_LEASES6)
+        .arg(subnet_id);
+
+    // The lease tracking needs the deleted leases.
+    if (hasCallbacks()) {
+        Lease6Collection leases;
+        if (subnet_id == 0) {
+            leases = getLeases6();
+        } else {
+            leases = getLeases6(subnet_id);
+        }
+        return (deleteLeases6(leases));
+    }
+    return (wipeLeasesCommon(subnet_id, subnet_id == 0 ?
+                             DELETE_LEASE6_ALL : DELETE_LEASE6_SUBID));
+}
+
+uint64_t
+PgSqlLeaseMgr::wipeLeasesCommon(const SubnetID& subnet_id,
+                                StatementIndex statement_index) {
+    // Set up the WHERE clause value, deleting all leases takes no parameter.
+    PsqlBindArray bind_array;
+    std::string subnet_id_str = boost::lexical_cast<std::string>(subnet_id);
+    if (subnet_id != 0) {
+        bind_array.add(subnet_id_str);
+    }
+
+    // Get a context
+    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
+    return (deleteLeaseCommon(ctx, statement_index, bind_array));
 }
 
 std::string
@@ -2913,7 +3624,7 @@ PgSqlLeaseMgr::getLeases4ByRelayId(const OptionBuffer& relay_id,
     Lease4Collection result;
 
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     getLeaseCollection(ctx, stindex, bind_array, result);
@@ -3002,7 +3713,7 @@ PgSqlLeaseMgr::getLeases4ByRemoteId(const OptionBuffer& remote_id,
     Lease4Collection result;
 
     // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseReadContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
     getLeaseCollection(ctx, stindex, bind_array, result);
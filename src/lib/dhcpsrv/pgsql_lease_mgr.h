@@ -14,10 +14,13 @@
 #include <dhcpsrv/tracking_lease_mgr.h>
 #include <pgsql/pgsql_connection.h>
 #include <pgsql/pgsql_exchange.h>
+#include <pgsql/pgsql_pipeline.h>
 
 #include <boost/scoped_ptr.hpp>
 #include <boost/utility.hpp>
 
+#include <ctime>
+#include <memory>
 #include <vector>
 #include <mutex>
 
@@ -59,6 +62,9 @@ public:
 
     /// @brief PostgreSQL connection
     db::PgSqlConnection conn_;
+
+    /// @brief Indicates if the connection is opened to the read replica.
+    bool is_replica_;
 };
 
 /// @brief Type of pointers to contexts.
@@ -126,6 +132,18 @@ public:
     /// failed.
     PgSqlLeaseContextPtr createContext() const;
 
+    /// @brief Create a new context connected to the read replica.
+    ///
+    /// The replica connection has no recovery: when it is lost the
+    /// context is dropped and the read-only queries use the primary
+    /// database until a new replica context can be created.
+    ///
+    /// @return A new (never null) context.
+    /// @throw isc::dhcp::NoDatabaseName Mandatory database name not given.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    /// failed.
+    PgSqlLeaseContextPtr createReplicaContext() const;
+
     /// @brief Attempts to reconnect the server to the lease DB backend manager.
     ///
     /// This is a self-rescheduling function that attempts to reconnect to the
@@ -510,6 +528,120 @@ public:
     /// different expiration time.
     virtual bool deleteLease(const Lease6Ptr& lease) override;
 
+    /// @name Bulk lease operations.
+    ///
+    /// The statements are executed in a single transaction. When lease
+    /// callbacks are installed the per lease functions are called
+    /// instead.
+    ///@{
+
+    /// @brief Adds IPv4 leases.
+    ///
+    /// A duplicate entry aborts the transaction so when some leases already
+    /// exist the transaction is rolled back and the leases are added one by
+    /// one.
+    ///
+    /// @param leases leases to be added.
+    ///
+    /// @return number of leases added.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual size_t addLeases4(const Lease4Collection& leases) override;
+
+    /// @brief Adds IPv6 leases.
+    ///
+    /// A duplicate entry aborts the transaction so when some leases already
+    /// exist the transaction is rolled back and the leases are added one by
+    /// one.
+    ///
+    /// @param leases leases to be added.
+    ///
+    /// @return number of leases added.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual size_t addLeases6(const Lease6Collection& leases) override;
+
+    /// @brief Updates IPv4 leases.
+    ///
+    /// @param leases leases to be updated.
+    ///
+    /// @return number of leases updated.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed. No lease is updated.
+    virtual size_t updateLeases4(const Lease4Collection& leases) override;
+
+    /// @brief Updates IPv6 leases.
+    ///
+    /// @param leases leases to be updated.
+    ///
+    /// @return number of leases updated.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed. No lease is updated.
+    virtual size_t updateLeases6(const Lease6Collection& leases) override;
+
+    /// @brief Deletes IPv4 leases.
+    ///
+    /// @param leases leases to be deleted.
+    ///
+    /// @return number of leases deleted.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed. No lease is deleted.
+    virtual size_t deleteLeases4(const Lease4Collection& leases) override;
+
+    /// @brief Deletes IPv6 leases.
+    ///
+    /// @param leases leases to be deleted.
+    ///
+    /// @return number of leases deleted.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed. No lease is deleted.
+    virtual size_t deleteLeases6(const Lease6Collection& leases) override;
+
+    ///@}
+
+    /// @brief Reclaims a batch of expired DHCPv4 leases.
+    ///
+    /// The batch is reclaimed by a single statement returning the leases
+    /// as they were before the reclamation.
+    ///
+    /// @param [out] reclaimed_leases A container to which the reclaimed
+    /// leases are added, as they were before the reclamation.
+    /// @param max_leases A maximum number of leases to be reclaimed. If this
+    /// value is set to 0, all expired (but not reclaimed) leases are
+    /// reclaimed.
+    /// @param remove_lease Delete the leases rather than setting their state
+    /// to expired-reclaimed.
+    /// @return Number of reclaimed leases.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual size_t reclaimExpiredLeases4(Lease4Collection& reclaimed_leases,
+                                         const size_t max_leases,
+                                         const bool remove_lease) override;
+
+    /// @brief Checks if the backend can pick and insert a free DHCPv4 lease
+    /// in a single operation.
+    ///
+    /// @return true if the single-query-allocation parameter is set to
+    /// true and no lease tracking callback is installed.
+    virtual bool canAddFreeLease4() const override;
+
+    /// @brief Picks and inserts a free DHCPv4 lease of an address range.
+    ///
+    /// A single INSERT statement selects the lowest address of the range
+    /// without a lease and returns it. The lease is not inserted when the
+    /// lease tracking callbacks are installed: they have to lock the lease
+    /// address before the insertion.
+    ///
+    /// @param lease The lease to insert: all but its address is used.
+    /// @param first_address The first address of the range.
+    /// @param last_address The last address of the range.
+    /// @return true if the lease was inserted, false otherwise.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    virtual bool addFreeLease4(const Lease4Ptr& lease,
+                               const isc::asiolink::IOAddress& first_address,
+                               const isc::asiolink::IOAddress& last_address) override;
+
     /// @brief Deletes all expired-reclaimed DHCPv4 leases.
     ///
     /// @param secs Number of seconds since expiration of leases before
@@ -597,9 +729,10 @@ public:
     /// This rather dangerous method is able to remove all leases from specified
     /// subnet.
     ///
-    /// @todo: Not implemented yet.
+    /// The leases are deleted by a single statement, or fetched and deleted
+    /// in a single transaction when the deleted leases are tracked.
     ///
-    /// @param subnet_id identifier of the subnet
+    /// @param subnet_id identifier of the subnet (or 0 for all subnets)
     /// @return number of leases removed.
     virtual size_t wipeLeases4(const SubnetID& subnet_id) override;
 
@@ -608,9 +741,10 @@ public:
     /// This rather dangerous method is able to remove all leases from specified
     /// subnet.
     ///
-    /// @todo: Not implemented yet.
+    /// The leases are deleted by a single statement, or fetched and deleted
+    /// in a single transaction when the deleted leases are tracked.
     ///
-    /// @param subnet_id identifier of the subnet
+    /// @param subnet_id identifier of the subnet (or 0 for all subnets)
     /// @return number of leases removed.
     virtual size_t wipeLeases6(const SubnetID& subnet_id) override;
 
@@ -669,8 +803,12 @@ public:
     enum StatementIndex {
         DELETE_LEASE4,               // Delete from lease4 by address
         DELETE_LEASE4_STATE_EXPIRED, // Delete expired lease4 in a given state
+        DELETE_LEASE4_SUBID,         // Delete lease4 by subnet ID
+        DELETE_LEASE4_ALL,           // Delete all lease4
         DELETE_LEASE6,               // Delete from lease6 by address
         DELETE_LEASE6_STATE_EXPIRED, // Delete expired lease6 in a given state
+        DELETE_LEASE6_SUBID,         // Delete lease6 by subnet ID
+        DELETE_LEASE6_ALL,           // Delete all lease6
         GET_LEASE4,                  // Get all IPv4 leases
         GET_LEASE4_ADDR,             // Get lease4 by address
         GET_LEASE4_CLIENTID,         // Get lease4 by client ID
@@ -713,11 +851,69 @@ public:
         IS_JSON_SUPPORTED,           // Checks if JSON support is enabled in the database.
         GET_LEASE4_COUNT_BY_CLASS,   // Fetches the IPv4 lease count for a given class.
         GET_LEASE6_COUNT_BY_CLASS,   // Fetches the IPv6 lease count for given class and lease type.
+        RECLAIM_LEASE4_EXPIRE,       // Reclaim expired lease4 returning them.
+        DELETE_LEASE4_EXPIRE,        // Delete expired lease4 returning them.
+        INSERT_FREE_LEASE4,          // Insert lease4 of the first free address of a range.
         NUM_STATEMENTS               // Number of statements
     };
 
 private:
 
+    /// @brief Checks if the pipeline mode is configured.
+    ///
+    /// @return true if the pipeline parameter is set to true.
+    /// @throw BadValue if the value of the pipeline parameter is invalid.
+    bool usePipeline() const;
+
+    /// @brief Checks if the single query allocation is configured.
+    ///
+    /// @return true if the single-query-allocation parameter is set to true.
+    /// @throw BadValue if the value of the single-query-allocation parameter
+    /// is invalid.
+    bool useSingleQueryAllocation() const;
+
+    /// @brief Opens the database of a context and prepares its statements.
+    ///
+    /// @param ctx Context
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    void openContext(PgSqlLeaseContextPtr& ctx) const;
+
+    /// @brief Takes a context of the read replica.
+    ///
+    /// The context is taken from the replica pool or created. When the
+    /// replica-max-lag parameter is set the replication lag is checked.
+    ///
+    /// @return A replica context or null when no read replica is configured,
+    /// when it is not available or when it lags behind the primary.
+    PgSqlLeaseContextPtr getReplicaContext() const;
+
+    /// @brief Puts back a context in the replica pool.
+    ///
+    /// The context is dropped when its connection is no longer usable.
+    ///
+    /// @param ctx The replica context.
+    void releaseReplicaContext(const PgSqlLeaseContextPtr& ctx) const;
+
+    /// @brief Executes a prepared statement.
+    ///
+    /// When the pipeline mode is enabled and the connection of the context
+    /// is a primary one not in a transaction the statement is executed by
+    /// the pipeline.
+    /// Otherwise it is executed using the connection of the context.
+    ///
+    /// @param ctx Context
+    /// @param stindex Index of statement being executed
+    /// @param bind_array array containing the statement parameters
+    ///
+    /// @return Result of the statement.
+    /// @throw isc::db::DuplicateEntry A row with the same key exists.
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    db::PgSqlResultPtr executeStatement(PgSqlLeaseContextPtr& ctx,
+                                        StatementIndex stindex,
+                                        db::PsqlBindArray& bind_array) const;
+
     /// @brief Add Lease Common Code
     ///
     /// This method performs the common actions for both flavours (V4 and V6)
@@ -738,6 +934,34 @@ private:
                         StatementIndex stindex,
                         db::PsqlBindArray& bind_array);
 
+    /// @brief Add IPv4 lease using a context
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be added
+    ///
+    /// @return true if the lease was added, false if it already exists.
+    bool addLeaseInternal(PgSqlLeaseContextPtr& ctx, const Lease4Ptr& lease);
+
+    /// @brief Add IPv6 lease using a context
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be added
+    ///
+    /// @return true if the lease was added, false if it already exists.
+    bool addLeaseInternal(PgSqlLeaseContextPtr& ctx, const Lease6Ptr& lease);
+
+    /// @brief Add leases in a single transaction
+    ///
+    /// @tparam LeaseCollection One of the @c Lease4Collection or
+    /// @c Lease6Collection.
+    /// @param leases Leases to be added
+    /// @param [out] count Number of added leases
+    ///
+    /// @return false if a lease already exists, in which case the
+    /// transaction is rolled back.
+    template <typename LeaseCollection>
+    bool addLeasesCommon(const LeaseCollection& leases, size_t& count);
+
     /// @brief Get Lease Collection Common Code
     ///
     /// This method performs the common actions for obtaining multiple leases
@@ -884,6 +1108,38 @@ private:
                            db::PsqlBindArray& bind_array,
                            const LeasePtr& lease);
 
+    /// @brief Update IPv4 lease using a context
+    ///
+    /// The current expiration time of the lease is not updated.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be updated
+    ///
+    /// @throw NoSuchLease Could not update a lease because no lease matches
+    ///        the address given.
+    void updateLeaseInternal(PgSqlLeaseContextPtr& ctx, const Lease4Ptr& lease);
+
+    /// @brief Update IPv6 lease using a context
+    ///
+    /// The current expiration time of the lease is not updated.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be updated
+    ///
+    /// @throw NoSuchLease Could not update a lease because no lease matches
+    ///        the address given.
+    void updateLeaseInternal(PgSqlLeaseContextPtr& ctx, const Lease6Ptr& lease);
+
+    /// @brief Update leases in a single transaction
+    ///
+    /// @tparam LeaseCollection One of the @c Lease4Collection or
+    /// @c Lease6Collection.
+    /// @param leases Leases to be updated
+    ///
+    /// @return Number of updated leases.
+    template <typename LeaseCollection>
+    size_t updateLeasesCommon(const LeaseCollection& leases);
+
     /// @brief Delete lease common code
     ///
     /// Holds the common code for deleting a lease.  It binds the parameters
@@ -903,6 +1159,43 @@ private:
                                StatementIndex stindex,
                                db::PsqlBindArray& bind_array);
 
+    /// @brief Delete IPv4 lease using a context
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be deleted
+    ///
+    /// @return true if the lease was deleted, false if no such lease exists.
+    bool deleteLeaseInternal(PgSqlLeaseContextPtr& ctx, const Lease4Ptr& lease);
+
+    /// @brief Delete IPv6 lease using a context
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be deleted
+    ///
+    /// @return true if the lease was deleted, false if no such lease exists.
+    bool deleteLeaseInternal(PgSqlLeaseContextPtr& ctx, const Lease6Ptr& lease);
+
+    /// @brief Delete leases in a single transaction
+    ///
+    /// @tparam LeaseCollection One of the @c Lease4Collection or
+    /// @c Lease6Collection.
+    /// @param leases Leases to be deleted
+    ///
+    /// @return Number of deleted leases.
+    template <typename LeaseCollection>
+    size_t deleteLeasesCommon(const LeaseCollection& leases);
+
+    /// @brief Delete the leases of a subnet or all leases
+    ///
+    /// @param subnet_id Identifier of the subnet (or 0 for all subnets)
+    /// @param statement_index One of the @c DELETE_LEASE4_SUBID,
+    ///        @c DELETE_LEASE4_ALL, @c DELETE_LEASE6_SUBID or
+    ///        @c DELETE_LEASE6_ALL.
+    ///
+    /// @return Number of deleted leases.
+    uint64_t wipeLeasesCommon(const SubnetID& subnet_id,
+                              StatementIndex statement_index);
+
     /// @brief Delete expired-reclaimed leases.
     ///
     /// @param secs Number of seconds since expiration of leases before
@@ -938,6 +1231,9 @@ private:
     /// { "ISC": { "limits": { "client-classes": [ { "name": "foo", "address-limit": 2 } ],
     ///                        "subnet": { "id": 1, "address-limit": 2 } } } }
     ///
+    /// The limits are checked in memory when the lease limit counter is
+    /// enabled by the in-memory-limits parameter.
+    ///
     /// @return a string describing a limit that is being exceeded, or an empty
     /// string if no limits are exceeded
     virtual std::string
@@ -952,6 +1248,9 @@ private:
     /// { "ISC": { "limits": { "client-classes": [ { "name": "foo", "address-limit": 2, "prefix-limit": 1 } ],
     ///                        "subnet": { "id": 1, "address-limit": 2, "prefix-limit": 1 } } } }
     ///
+    /// The limits are checked in memory when the lease limit counter is
+    /// enabled by the in-memory-limits parameter.
+    ///
     /// @return a string describing a limit that is being exceeded, or an empty
     /// string if no limits are exceeded
     virtual std::string
@@ -969,17 +1268,25 @@ private:
     /// @param ltype type of lease for which the count is desired. Defaults to
     /// Lease::TYPE_V4.
     ///
+    /// The count is taken from the lease limit counter when it is enabled.
+    ///
     /// @return number of leases
     virtual size_t getClassLeaseCount(const ClientClass& client_class,
                                       const Lease::Type& ltype = Lease::TYPE_V4) const override;
 
     /// @brief Recount the leases per class for V4 leases.
+    ///
+    /// @throw NotImplemented if the lease limit counter is not enabled.
     virtual void recountClassLeases4() override;
 
     /// @brief Recount the leases per class for V6 leases.
+    ///
+    /// @throw NotImplemented if the lease limit counter is not enabled.
     virtual void recountClassLeases6() override;
 
     /// @brief Clears the class-lease count map.
+    ///
+    /// @throw NotImplemented if the lease limit counter is not enabled.
     virtual void clearClassLeaseCounts() override;
 
     /// The following queries are used to fulfill Bulk Lease Query
@@ -1113,6 +1420,42 @@ private:
         const PgSqlLeaseMgr& mgr_;
     };
 
+    /// @brief Context RAII allocator for read-only queries.
+    ///
+    /// This context should be used in the queries which can tolerate
+    /// the replication lag of the read replica: full and paged dumps,
+    /// lookups by subnet, hostname or relay information, and statistics.
+    /// The queries used by the lease allocation must stay on the primary
+    /// database and use @c PgSqlLeaseContextAlloc.
+    class PgSqlLeaseReadContextAlloc {
+    public:
+
+        /// @brief Constructor
+        ///
+        /// This constructor takes a context of the read replica when it is
+        /// available or falls back to a context of the primary pool.
+        ///
+        /// @param mgr A parent instance
+        PgSqlLeaseReadContextAlloc(const PgSqlLeaseMgr& mgr);
+
+        /// @brief Destructor
+        ///
+        /// This destructor puts back the context in its pool.
+        ~PgSqlLeaseReadContextAlloc();
+
+        /// @brief The context
+        PgSqlLeaseContextPtr ctx_;
+
+    private:
+
+        /// @brief The manager
+        const PgSqlLeaseMgr& mgr_;
+
+        /// @brief The allocator of the primary context when the replica
+        /// is not used.
+        std::unique_ptr<PgSqlLeaseContextAlloc> primary_;
+    };
+
     /// @brief Context RAII allocator for lease tracking.
     ///
     /// This context should be used in the non-const calls that
@@ -1191,6 +1534,12 @@ protected:
 
 private:
 
+    /// @brief Returns the pool of contexts of the current thread.
+    ///
+    /// @return The pool of the writer threads when called by a writer
+    /// thread, the shared pool otherwise.
+    PgSqlLeaseContextPoolPtr getContextPool() const;
+
     // Members
 
     /// @brief The parameters
@@ -1199,8 +1548,35 @@ private:
     /// @brief The pool of contexts
     PgSqlLeaseContextPoolPtr pool_;
 
+    /// @brief The pool of contexts of the writer threads
+    PgSqlLeaseContextPoolPtr writer_pool_;
+
+    /// @brief Indicates if the free leases are picked and inserted by
+    /// a single query.
+    bool single_query_allocation_;
+
+    /// @brief The parameters of the read replica (empty when none).
+    db::DatabaseConnection::ParameterMap replica_parameters_;
+
+    /// @brief The maximum replication lag of the read replica in seconds
+    /// (0 when not checked).
+    uint32_t replica_max_lag_;
+
+    /// @brief The pool of read replica contexts (null when no replica).
+    PgSqlLeaseContextPoolPtr replica_pool_;
+
+    /// @brief The time before which the read replica is not retried after
+    /// a failure (protected by the replica pool mutex).
+    mutable time_t replica_retry_time_;
+
     /// @brief Timer name used to register database reconnect timer.
     std::string timer_name_;
+
+    /// @brief The context owning the connection of the pipeline.
+    PgSqlLeaseContextPtr pipeline_ctx_;
+
+    /// @brief The pipeline shared by the threads in the pipeline mode.
+    db::PgSqlPipelinePtr pipeline_;
 };
 
 }  // namespace dhcp
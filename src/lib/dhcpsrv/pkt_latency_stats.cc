@@ -0,0 +1,55 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/pkt_latency_stats.h>
+#include <stats/stats_mgr.h>
+
+using namespace isc::stats;
+
+namespace isc {
+namespace dhcp {
+
+PktLatencyStats::PktLatencyStats(const std::string& prefix) {
+    StatsMgr& stats_mgr = StatsMgr::instance();
+    queue_     = stats_mgr.registerHistogram(prefix + "-queue-latency");
+    pre_alloc_ = stats_mgr.registerHistogram(prefix + "-pre-alloc-latency");
+    alloc_     = stats_mgr.registerHistogram(prefix + "-alloc-latency");
+    response_  = stats_mgr.registerHistogram(prefix + "-response-latency");
+    total_     = stats_mgr.registerHistogram(prefix + "-total-latency");
+}
+
+void
+PktLatencyStats::record(const LatencyHistogramPtr& histogram,
+                        const Pkt::EventTime& from, const Pkt::EventTime& to) {
+    const Pkt::EventTime unset;
+    if ((from != unset) && (to != unset)) {
+        histogram->record(to - from);
+    }
+}
+
+void
+PktLatencyStats::record(const Pkt& pkt) const {
+    const Pkt::EventTime& received = pkt.getEventTime(Pkt::EVENT_RECEIVED);
+    const Pkt::EventTime& dequeued = pkt.getEventTime(Pkt::EVENT_DEQUEUED);
+    const Pkt::EventTime& alloc_started = pkt.getEventTime(Pkt::EVENT_ALLOC_STARTED);
+    const Pkt::EventTime& alloc_finished = pkt.getEventTime(Pkt::EVENT_ALLOC_FINISHED);
+    const Pkt::EventTime& sent = pkt.getEventTime(Pkt::EVENT_SENT);
+
+    record(queue_, received, dequeued);
+    record(pre_alloc_, dequeued, alloc_started);
+    record(alloc_, alloc_started, alloc_finished);
+    if (alloc_finished != Pkt::EventTime()) {
+        record(response_, alloc_finished, sent);
+    } else {
+        record(response_, dequeued, sent);
+    }
+    record(total_, received, sent);
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
@@ -0,0 +1,82 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PKT_LATENCY_STATS_H
+#define PKT_LATENCY_STATS_H
+
+#include <dhcp/pkt.h>
+#include <stats/latency_histogram.h>
+
+#include <string>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Latency histograms of the packet processing stages.
+///
+/// The servers record the time of the processing events on the queries
+/// (see @ref Pkt::Event), pass them to the responses and record the
+/// latencies of the stages when a response was sent:
+/// - "<prefix>-queue-latency": from the reception to the start of the
+///   processing, i.e. the time spent in the thread pool queue,
+/// - "<prefix>-pre-alloc-latency": from the start of the processing to
+///   the lease allocation, i.e. the unpacking, the classification, the
+///   subnet selection, the host lookups and the callouts before the
+///   allocation,
+/// - "<prefix>-alloc-latency": the lease allocation including the lease
+///   backend,
+/// - "<prefix>-response-latency": from the end of the allocation, or
+///   from the start of the processing when no lease was allocated, to the
+///   response being sent,
+/// - "<prefix>-total-latency": from the reception to the response being
+///   sent.
+///
+/// A stage is recorded only when both its events occurred.
+class PktLatencyStats {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Registers the histograms in the statistics manager.
+    ///
+    /// @param prefix prefix of the histogram names, e.g. "pkt4".
+    explicit PktLatencyStats(const std::string& prefix);
+
+    /// @brief Records the latencies of a response which was sent.
+    ///
+    /// @param pkt response with the event times of its query.
+    void record(const Pkt& pkt) const;
+
+private:
+
+    /// @brief Records the latency between two events when both occurred.
+    ///
+    /// @param histogram histogram of the stage.
+    /// @param from start of the stage.
+    /// @param to end of the stage.
+    static void record(const stats::LatencyHistogramPtr& histogram,
+                       const Pkt::EventTime& from, const Pkt::EventTime& to);
+
+    /// @brief Reception to start of the processing.
+    stats::LatencyHistogramPtr queue_;
+
+    /// @brief Start of the processing to start of the allocation.
+    stats::LatencyHistogramPtr pre_alloc_;
+
+    /// @brief Lease allocation.
+    stats::LatencyHistogramPtr alloc_;
+
+    /// @brief End of the allocation to response sent.
+    stats::LatencyHistogramPtr response_;
+
+    /// @brief Reception to response sent.
+    stats::LatencyHistogramPtr total_;
+};
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // PKT_LATENCY_STATS_H
@@ -218,6 +218,9 @@ protected:
     /// @ref Network::client_class_
     ClientClass client_class_;
 
+    /// @brief Interned identifier of the client class
+    ClientClassId client_class_id_;
+
     /// @brief Required classes
     ///
     /// @ref isc::dhcp::Network::required_classes_
@@ -5,11 +5,29 @@
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include <config.h>
+#include <asiolink/addr_utilities.h>
 #include <dhcpsrv/random_allocation_state.h>
 #include <boost/make_shared.hpp>
 
 using namespace isc::asiolink;
 
+namespace {
+
+/// @brief Selects the permutation mode for a range size.
+///
+/// @param size number of addresses or delegated prefixes in the range.
+/// @return @c IPRangePermutation::FEISTEL for the ranges for which the
+/// shuffle state could grow too large, @c IPRangePermutation::SHUFFLE
+/// otherwise.
+isc::dhcp::IPRangePermutation::Mode
+selectMode(uint64_t size) {
+    return (size > isc::dhcp::PoolRandomAllocationState::MAX_SHUFFLE_SIZE ?
+            isc::dhcp::IPRangePermutation::FEISTEL :
+            isc::dhcp::IPRangePermutation::SHUFFLE);
+}
+
+}
+
 namespace isc {
 namespace dhcp {
 
@@ -28,12 +46,19 @@ PoolRandomAllocationState::create(const PoolPtr& pool) {
 }
 
 PoolRandomAllocationState::PoolRandomAllocationState(const IOAddress& first, const IOAddress& last)
-    : permutation_(new IPRangePermutation(AddressRange(first, last))) {
+    : permutation_() {
+    AddressRange range(first, last);
+    permutation_.reset(new IPRangePermutation(range,
+                                              selectMode(addrsInRange(first, last))));
 }
 
 PoolRandomAllocationState::PoolRandomAllocationState(const IOAddress& first, const IOAddress& last,
                                                      const uint8_t delegated)
-    : permutation_(new IPRangePermutation(PrefixRange(first, last, delegated))) {
+    : permutation_() {
+    PrefixRange range(first, last, delegated);
+    permutation_.reset(new IPRangePermutation(range,
+                                              selectMode(prefixesInRange(range.prefix_length_,
+                                                                         range.delegated_length_))));
 }
 
 } // end of namespace isc::dhcp
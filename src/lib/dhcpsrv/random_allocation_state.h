@@ -27,9 +27,16 @@ typedef boost::shared_ptr<PoolRandomAllocationState> PoolRandomAllocationStatePt
 /// It extends the base class with the mechanism that maintains
 /// an address or delegated prefix pool permutation. The
 /// permutation serves random, non-repeating leases.
+///
+/// The pools with more than @c MAX_SHUFFLE_SIZE addresses or delegated
+/// prefixes use the stateless @c IPRangePermutation::FEISTEL mode, so the
+/// permutation memory does not grow with the pool size.
 class PoolRandomAllocationState : public AllocationState {
 public:
 
+    /// @brief Maximum pool size using the shuffle permutation.
+    static const uint64_t MAX_SHUFFLE_SIZE = 65536;
+
     /// @brief Factory function creating the state instance from pool.
     ///
     /// @param pool instance of the pool for which the allocation state
@@ -6,6 +6,7 @@
 
 #include <config.h>
 
+#include <dhcpsrv/lease_mgr_factory.h>
 #include <dhcpsrv/random_allocator.h>
 #include <dhcpsrv/subnet.h>
 #include <algorithm>
@@ -23,6 +24,15 @@ RandomAllocator::RandomAllocator(Lease::Type type, const WeakSubnetPtr& subnet)
     generator_.seed(rd());
 }
 
+void
+RandomAllocator::initAfterConfigureInternal() {
+    // The memfile lookups are in memory so the filter would not help.
+    if (LeaseMgrFactory::haveInstance() &&
+        (LeaseMgrFactory::instance().getType() != "memfile")) {
+        initOccupancyFilter();
+    }
+}
+
 IOAddress
 RandomAllocator::pickAddressInternal(const ClientClasses& client_classes,
                                      const DuidPtr&,
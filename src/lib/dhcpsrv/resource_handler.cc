@@ -1,4 +1,4 @@
-// Copyright (C) 2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -18,6 +18,10 @@ namespace dhcp {
 
 mutex ResourceHandler::mutex_;
 
+condition_variable ResourceHandler::cv_;
+
+size_t ResourceHandler::waiters_ = 0;
+
 ResourceHandler::ResourceContainer ResourceHandler::resources_;
 
 ResourceHandler::ResourceHandler() : owned_() {
@@ -58,6 +62,9 @@ ResourceHandler::unLockInternal(Lease::Type type,
         return;
     }
     resources_.erase(it);
+    if (waiters_ > 0) {
+        cv_.notify_all();
+    }
 }
 
 bool
@@ -73,6 +80,25 @@ ResourceHandler::tryLock(Lease::Type type, const asiolink::IOAddress& addr) {
     return (true);
 }
 
+bool
+ResourceHandler::lockOrWait(Lease::Type type, const asiolink::IOAddress& addr) {
+    unique_lock<mutex> lock_(mutex_);
+    for (;;) {
+        ResourcePtr holder = lookup(type, addr);
+        if (!holder) {
+            break;
+        }
+        if (holder->thread_ == this_thread::get_id()) {
+            return (false);
+        }
+        ++waiters_;
+        cv_.wait(lock_);
+        --waiters_;
+    }
+    lock(type, addr);
+    return (true);
+}
+
 bool
 ResourceHandler::isLocked(Lease::Type type, const asiolink::IOAddress& addr) {
     auto key = boost::make_tuple(type, addr.toBytes());
@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -18,7 +18,9 @@
 #include <boost/multi_index/mem_fun.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 
 namespace isc {
 namespace dhcp {
@@ -53,6 +55,19 @@ public:
     /// busy i.e. owned by a handler.
     bool tryLock(Lease::Type type, const asiolink::IOAddress& addr);
 
+    /// @brief Acquires a resource, waiting for its release when it is
+    /// owned by a handler of another thread.
+    ///
+    /// Handlers must not wait while they own resources other threads can
+    /// wait for, except the resource they wait for when it is owned by the
+    /// current thread.
+    ///
+    /// @param type Type of the resource, member of @c Lease::Type enum.
+    /// @param addr The address or prefix aka the resource.
+    /// @return true if the resource was acquired, false if the resource is
+    /// already owned by a handler of the current thread.
+    bool lockOrWait(Lease::Type type, const asiolink::IOAddress& addr);
+
     /// @brief Checks if a resource is owned by this handler.
     ///
     /// @param type Type of the resource, member of @c Lease::Type enum.
@@ -81,7 +96,7 @@ private:
         ///
         /// @param addr The address or prefix aka the resource..
         Resource(Lease::Type type, const asiolink::IOAddress& addr)
-            : type_(type), addr_(addr) {
+            : type_(type), addr_(addr), thread_(std::this_thread::get_id()) {
         }
 
         /// @brief The type.
@@ -90,6 +105,9 @@ private:
         /// @brief The resource.
         asiolink::IOAddress addr_;
 
+        /// @brief The ID of the thread which acquired the resource.
+        std::thread::id thread_;
+
         /// @brief The key extractor.
         std::vector<uint8_t> toBytes() const {
             return (addr_.toBytes());
@@ -136,6 +154,12 @@ private:
     /// @brief Mutex to protect the resource container.
     static std::mutex mutex_;
 
+    /// @brief Condition variable to wait for the release of resources.
+    static std::condition_variable cv_;
+
+    /// @brief The number of handlers waiting for the release of resources.
+    static size_t waiters_;
+
     /// @brief Lookup a resource.
     ///
     /// The mutex must be held by the caller.
@@ -196,6 +220,16 @@ public:
         return (tryLock(Lease::TYPE_V4, addr));
     }
 
+    /// @brief Acquires a resource, waiting for its release when it is
+    /// owned by a handler of another thread.
+    ///
+    /// @param addr The address aka the resource.
+    /// @return true if the resource was acquired, false if the resource is
+    /// already owned by a handler of the current thread.
+    bool lockOrWait4(const asiolink::IOAddress& addr) {
+        return (lockOrWait(Lease::TYPE_V4, addr));
+    }
+
     /// @brief Checks if a resource is owned by this handler.
     ///
     /// @param addr The address aka the resource.
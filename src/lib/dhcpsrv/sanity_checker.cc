@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,6 +15,27 @@
 namespace isc {
 namespace dhcp {
 
+SanityChecker::SanityChecker(const SrvConfigPtr& cfg)
+    : cfg_(cfg) {
+}
+
+SrvConfigPtr SanityChecker::getConfig(bool current) {
+    SrvConfigPtr cfg = cfg_;
+    if (!cfg) {
+        if (current) {
+            cfg = CfgMgr::instance().getCurrentCfg();
+        } else {
+            cfg = CfgMgr::instance().getStagingCfg();
+        }
+    }
+    if (cfg != last_cfg_) {
+        last_cfg_ = cfg;
+        last_subnet4_.reset();
+        last_subnet6_.reset();
+    }
+    return (cfg);
+}
+
 bool SanityChecker::leaseCheckingEnabled(bool current) {
     SrvConfigPtr cfg;
     if (current) {
@@ -32,13 +53,7 @@ bool SanityChecker::leaseCheckingEnabled(bool current) {
 }
 
 void SanityChecker::checkLease(Lease4Ptr& lease, bool current) {
-    SrvConfigPtr cfg;
-    if (current) {
-        cfg = CfgMgr::instance().getCurrentCfg();
-    } else {
-        cfg = CfgMgr::instance().getStagingCfg();
-    }
-
+    SrvConfigPtr cfg = getConfig(current);
     CfgConsistencyPtr sanity = cfg->getConsistency();
     if (sanity->getLeaseSanityCheck() == CfgConsistency::LEASE_CHECK_NONE) {
         // No sense going farther.
@@ -46,7 +61,7 @@ void SanityChecker::checkLease(Lease4Ptr& lease, bool current) {
     }
 
     CfgSubnets4Ptr subnets = cfg->getCfgSubnets4();
-    checkLeaseInternal(lease, sanity, subnets);
+    checkLeaseInternal(lease, sanity, subnets, last_subnet4_);
 }
 
 void SanityChecker::checkLease(Lease6Ptr& lease, bool current) {
@@ -55,12 +70,7 @@ void SanityChecker::checkLease(Lease6Ptr& lease, bool current) {
         return;
     }
 
-    SrvConfigPtr cfg;
-    if (current) {
-        cfg = CfgMgr::instance().getCurrentCfg();
-    } else {
-        cfg = CfgMgr::instance().getStagingCfg();
-    }
+    SrvConfigPtr cfg = getConfig(current);
     CfgConsistencyPtr sanity = cfg->getConsistency();
     if (sanity->getLeaseSanityCheck() == CfgConsistency::LEASE_CHECK_NONE) {
         // No sense going farther.
@@ -68,18 +78,26 @@ void SanityChecker::checkLease(Lease6Ptr& lease, bool current) {
     }
 
     CfgSubnets6Ptr subnets = cfg->getCfgSubnets6();
-    checkLeaseInternal(lease, sanity, subnets);
+    checkLeaseInternal(lease, sanity, subnets, last_subnet6_);
 }
 
-template<typename LeasePtrType, typename SubnetsType>
+template<typename LeasePtrType, typename SubnetsType, typename SubnetPtrType>
 void SanityChecker::checkLeaseInternal(LeasePtrType& lease, const CfgConsistencyPtr& checks,
-                               const SubnetsType& subnets) {
+                                       const SubnetsType& subnets,
+                                       SubnetPtrType& last_subnet) {
+
+    // Leases are mostly stored by address so a run of leases often
+    // belongs to the same subnet.
+    if (last_subnet && (last_subnet->getID() == lease->subnet_id_) &&
+        last_subnet->inRange(lease->addr_)) {
+        return;
+    }
 
     auto subnet = subnets->getBySubnetId(lease->subnet_id_);
     if (subnet && subnet->inRange(lease->addr_)) {
 
         // If the subnet is defined and the address is in range, we're good.
-
+        last_subnet = subnet;
         return;
     }
 
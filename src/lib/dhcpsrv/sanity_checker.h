@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,6 +9,8 @@
 
 #include <dhcpsrv/lease.h>
 #include <dhcpsrv/cfg_consistency.h>
+#include <dhcpsrv/srv_config.h>
+#include <dhcpsrv/subnet.h>
 
 namespace isc {
 namespace dhcp {
@@ -20,9 +22,29 @@ namespace dhcp {
 /// checking and correction for subnet-id parameter in leases.
 ///
 /// @note: the extended info checker for leases is in the lease manager.
+///
+/// The checker remembers the last subnet a lease was found in range for, so
+/// the leases of a run of addresses in the same subnet are checked without
+/// a lookup. An instance must not be shared between threads: a copy can be
+/// used by each thread instead.
 class SanityChecker {
 public:
 
+    /// @brief Constructor.
+    ///
+    /// The configuration is retrieved from the configuration manager for
+    /// each check.
+    SanityChecker() = default;
+
+    /// @brief Constructor using a given configuration.
+    ///
+    /// The configuration manager is not used so the checks can be done by
+    /// other threads, e.g. by the threads parsing a lease file.
+    ///
+    /// @param cfg The configuration used by all checks in place of the
+    /// current or staging configuration.
+    explicit SanityChecker(const SrvConfigPtr& cfg);
+
     /// @brief Sanity checks and possibly corrects an IPv4 lease
     ///
     /// Depending on the sanity-checks/lease-checks parameter value (see
@@ -61,13 +83,27 @@ public:
     /// @tparam LeaseType type of the lease (Lease4Ptr or Lease6Ptr)
     /// @tparam SubnetsType type of the subnets container (CfgSubnets4Ptr or
     ///         CfgSubnets6Ptr)
+    /// @tparam SubnetPtrType type of the subnet pointer (ConstSubnet4Ptr or
+    ///         ConstSubnet6Ptr)
     /// @param lease a lease to be checked/corrected
     /// @param checks a pointer to CfgConsistency structure (type of checks
     ///        specified here)
     /// @param subnets configuration structure with subnets
-    template<typename LeaseType, typename SubnetsType>
+    /// @param last_subnet the last subnet a lease was found in range for
+    template<typename LeaseType, typename SubnetsType, typename SubnetPtrType>
     void checkLeaseInternal(LeaseType& lease, const CfgConsistencyPtr& checks,
-                            const SubnetsType& subnets);
+                            const SubnetsType& subnets,
+                            SubnetPtrType& last_subnet);
+
+    /// @brief Returns the configuration to use.
+    ///
+    /// The cached subnets are forgotten when the configuration changes.
+    ///
+    /// @param current specify whether to use current (true) or staging
+    ///        (false) config when no configuration was given to the
+    ///        constructor
+    /// @return the configuration
+    SrvConfigPtr getConfig(bool current);
 
     /// @brief Internal method for finding appropriate subnet-id
     ///
@@ -78,6 +114,18 @@ public:
     /// @param subnets configuration structure with subnets
     template<typename LeaseType, typename SubnetsType>
     SubnetID findSubnetId(const LeaseType& lease, const SubnetsType& subnets);
+
+    /// @brief The configuration given to the constructor.
+    SrvConfigPtr cfg_;
+
+    /// @brief The configuration of the cached subnets.
+    SrvConfigPtr last_cfg_;
+
+    /// @brief The last subnet an IPv4 lease was found in range for.
+    ConstSubnet4Ptr last_subnet4_;
+
+    /// @brief The last subnet an IPv6 lease was found in range for.
+    ConstSubnet6Ptr last_subnet6_;
 };
 
 }
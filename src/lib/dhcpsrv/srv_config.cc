@@ -288,6 +288,70 @@ SrvConfig::removeStatistics() {
 
 void
 SrvConfig::updateStatistics() {
+    updateSampleLimits();
+
+    // Updating subnet statistics involves updating lease statistics, which
+    // is done by the LeaseMgr.  Since servers with subnets, must have a
+    // LeaseMgr, we do not bother updating subnet stats for servers without
+    // a lease manager, such as D2. @todo We should probably examine why
+    // "SrvConfig" is being used by D2.
+    if (LeaseMgrFactory::haveInstance()) {
+        // Updates  statistics for v4 and v6 subnets
+        getCfgSubnets4()->updateStatistics();
+
+        getCfgSubnets6()->updateStatistics();
+    }
+}
+
+void
+SrvConfig::updateStatistics(SrvConfig& previous) {
+    if (!LeaseMgrFactory::haveInstance() || !sameLeaseDatabase(previous)) {
+        previous.removeStatistics();
+        updateStatistics();
+        return;
+    }
+
+    updateSampleLimits();
+    getCfgSubnets4()->updateStatistics(*previous.getCfgSubnets4()->getAll());
+    getCfgSubnets6()->updateStatistics(*previous.getCfgSubnets6()->getAll());
+}
+
+void
+SrvConfig::updateStatistics(const Subnet4Collection& subnets4,
+                            const Subnet6Collection& subnets6) {
+    updateSampleLimits();
+    if (LeaseMgrFactory::haveInstance()) {
+        getCfgSubnets4()->updateStatistics(subnets4);
+        getCfgSubnets6()->updateStatistics(subnets6);
+    }
+}
+
+bool
+SrvConfig::sameLeaseDatabase(const SrvConfig& other) const {
+    const std::string access = getCfgDbAccess()->getLeaseDbAccessString();
+    if (access != other.getCfgDbAccess()->getLeaseDbAccessString()) {
+        return (false);
+    }
+
+    // A non persistent memfile database loses its leases when the lease
+    // manager is recreated.
+    try {
+        db::DatabaseConnection::ParameterMap parameters =
+            db::DatabaseConnection::parse(access);
+        auto type = parameters.find("type");
+        auto persist = parameters.find("persist");
+        if ((type != parameters.end()) && (type->second == "memfile") &&
+            (persist != parameters.end()) && (persist->second == "false")) {
+            return (false);
+        }
+    } catch (const std::exception&) {
+        return (false);
+    }
+    return (true);
+}
+
+void
+SrvConfig::updateSampleLimits() {
     // Update default sample limits.
     stats::StatsMgr& stats_mgr = stats::StatsMgr::instance();
     ConstElementPtr samples =
@@ -310,18 +374,6 @@ SrvConfig::updateStatistics() {
             stats_mgr.setMaxSampleAgeAll(max_age);
         }
     }
-
-    // Updating subnet statistics involves updating lease statistics, which
-    // is done by the LeaseMgr.  Since servers with subnets, must have a
-    // LeaseMgr, we do not bother updating subnet stats for servers without
-    // a lease manager, such as D2. @todo We should probably examine why
-    // "SrvConfig" is being used by D2.
-    if (LeaseMgrFactory::haveInstance()) {
-        // Updates  statistics for v4 and v6 subnets
-        getCfgSubnets4()->updateStatistics();
-
-        getCfgSubnets6()->updateStatistics();
-    }
 }
 
 void
@@ -849,14 +901,59 @@ SrvConfig::toElement() const {
 
 DdnsParamsPtr
 SrvConfig::getDdnsParams(const Subnet4Ptr& subnet) const {
-    return (DdnsParamsPtr(new DdnsParams(subnet,
-                                         getD2ClientConfig()->getEnableUpdates())));
+    bool d2_client_enabled = getD2ClientConfig()->getEnableUpdates();
+    if (subnet) {
+        auto it = resolved_ddns_params_.find(subnet.get());
+        if ((it != resolved_ddns_params_.end()) &&
+            it->second->isCurrent(subnet, d2_client_enabled)) {
+            return (it->second);
+        }
+    }
+    return (DdnsParamsPtr(new DdnsParams(subnet, d2_client_enabled)));
 }
 
 DdnsParamsPtr
 SrvConfig::getDdnsParams(const Subnet6Ptr& subnet) const {
-   return(DdnsParamsPtr(new DdnsParams(subnet,
-                                       getD2ClientConfig()->getEnableUpdates())));
+    bool d2_client_enabled = getD2ClientConfig()->getEnableUpdates();
+    if (subnet) {
+        auto it = resolved_ddns_params_.find(subnet.get());
+        if ((it != resolved_ddns_params_.end()) &&
+            it->second->isCurrent(subnet, d2_client_enabled)) {
+            return (it->second);
+        }
+    }
+    return (DdnsParamsPtr(new DdnsParams(subnet, d2_client_enabled)));
+}
+
+void
+SrvConfig::resolveDdnsParams() {
+    resolved_ddns_params_.clear();
+    bool d2_client_enabled = getD2ClientConfig()->getEnableUpdates();
+    DdnsParams::SanitizerMap sanitizers;
+    for (auto const& subnet : *getCfgSubnets4()->getAll()) {
+        resolved_ddns_params_[subnet.get()] =
+            DdnsParams::resolve(subnet, d2_client_enabled, sanitizers);
+    }
+    for (auto const& subnet : *getCfgSubnets6()->getAll()) {
+        resolved_ddns_params_[subnet.get()] =
+            DdnsParams::resolve(subnet, d2_client_enabled, sanitizers);
+    }
+}
+
+void
+SrvConfig::resolveNetworkProperties() {
+    for (auto const& network : *getCfgSharedNetworks4()->getAll()) {
+        network->resolveProperties();
+    }
+    for (auto const& subnet : *getCfgSubnets4()->getAll()) {
+        subnet->resolveProperties();
+    }
+    for (auto const& network : *getCfgSharedNetworks6()->getAll()) {
+        network->resolveProperties();
+    }
+    for (auto const& subnet : *getCfgSubnets6()->getAll()) {
+        subnet->resolveProperties();
+    }
 }
 
 void
@@ -925,6 +1022,10 @@ SrvConfig::configureLowerLevelLibraries() const {
 
 bool
 DdnsParams::getEnableUpdates() const {
+    if (resolved_) {
+        return (resolved_->enable_updates_);
+    }
+
     if (!subnet_) {
         return (false);
     }
@@ -934,6 +1035,10 @@ DdnsParams::getEnableUpdates() const {
 
 bool
 DdnsParams::getOverrideNoUpdate() const {
+    if (resolved_) {
+        return (resolved_->override_no_update_);
+    }
+
     if (!subnet_) {
         return (false);
     }
@@ -942,6 +1047,10 @@ DdnsParams::getOverrideNoUpdate() const {
 }
 
 bool DdnsParams::getOverrideClientUpdate() const {
+    if (resolved_) {
+        return (resolved_->override_client_update_);
+    }
+
     if (!subnet_) {
         return (false);
     }
@@ -951,6 +1060,10 @@ bool DdnsParams::getOverrideClientUpdate() const {
 
 D2ClientConfig::ReplaceClientNameMode
 DdnsParams::getReplaceClientNameMode() const {
+    if (resolved_) {
+        return (resolved_->replace_client_name_mode_);
+    }
+
     if (!subnet_) {
         return (D2ClientConfig::RCM_NEVER);
     }
@@ -960,6 +1073,10 @@ DdnsParams::getReplaceClientNameMode() const {
 
 std::string
 DdnsParams::getGeneratedPrefix() const {
+    if (resolved_) {
+        return (resolved_->generated_prefix_);
+    }
+
     if (!subnet_) {
         return ("");
     }
@@ -969,6 +1086,10 @@ DdnsParams::getGeneratedPrefix() const {
 
 std::string
 DdnsParams::getQualifyingSuffix() const {
+    if (resolved_) {
+        return (resolved_->qualifying_suffix_);
+    }
+
     if (!subnet_) {
         return ("");
     }
@@ -978,6 +1099,10 @@ DdnsParams::getQualifyingSuffix() const {
 
 std::string
 DdnsParams::getHostnameCharSet() const {
+    if (resolved_) {
+        return (resolved_->hostname_char_set_);
+    }
+
     if (!subnet_) {
         return ("");
     }
@@ -987,6 +1112,10 @@ DdnsParams::getHostnameCharSet() const {
 
 std::string
 DdnsParams::getHostnameCharReplacement() const {
+    if (resolved_) {
+        return (resolved_->hostname_char_replacement_);
+    }
+
     if (!subnet_) {
         return ("");
     }
@@ -996,6 +1125,10 @@ DdnsParams::getHostnameCharReplacement() const {
 
 util::str::StringSanitizerPtr
 DdnsParams::getHostnameSanitizer() const {
+    if (resolved_) {
+        return (resolved_->hostname_sanitizer_);
+    }
+
     util::str::StringSanitizerPtr sanitizer;
     if (subnet_) {
         std::string char_set = getHostnameCharSet();
@@ -1015,6 +1148,10 @@ DdnsParams::getHostnameSanitizer() const {
 
 bool
 DdnsParams::getUpdateOnRenew() const {
+    if (resolved_) {
+        return (resolved_->update_on_renew_);
+    }
+
     if (!subnet_) {
         return (false);
     }
@@ -1024,6 +1161,10 @@ DdnsParams::getUpdateOnRenew() const {
 
 bool
 DdnsParams::getUseConflictResolution() const {
+    if (resolved_) {
+        return (resolved_->use_conflict_resolution_);
+    }
+
     if (!subnet_) {
         return (true);
     }
@@ -1033,6 +1174,10 @@ DdnsParams::getUseConflictResolution() const {
 
 util::Optional<double>
 DdnsParams::getTtlPercent() const {
+    if (resolved_) {
+        return (resolved_->ttl_percent_);
+    }
+
     if (!subnet_) {
         return (util::Optional<double>());
     }
@@ -1040,5 +1185,79 @@ DdnsParams::getTtlPercent() const {
     return (subnet_->getDdnsTtlPercent());
 }
 
+DdnsParamsPtr
+DdnsParams::resolve(const SubnetPtr& subnet, bool d2_client_enabled,
+                    SanitizerMap& sanitizers) {
+    DdnsParamsPtr params(new DdnsParams());
+    params->subnet_ = subnet;
+    params->d2_client_enabled_ = d2_client_enabled;
+
+    // The versions are fetched before the values: a change made in
+    // between makes the resolved values not current rather than stale.
+    boost::shared_ptr<Resolved> resolved(new Resolved());
+    resolved->subnet_version_ = subnet->getDdnsParamsVersion();
+    subnet->getDdnsParamsSources(resolved->parent_, resolved->globals_);
+    resolved->parent_version_ = (resolved->parent_ ?
+                                 resolved->parent_->getDdnsParamsVersion() : 0);
+    resolved->globals_version_ = (resolved->globals_ ?
+                                  resolved->globals_->getVersion() : 0);
+
+    resolved->enable_updates_ = params->getEnableUpdates();
+    resolved->override_no_update_ = params->getOverrideNoUpdate();
+    resolved->override_client_update_ = params->getOverrideClientUpdate();
+    resolved->replace_client_name_mode_ = params->getReplaceClientNameMode();
+    resolved->generated_prefix_ = params->getGeneratedPrefix();
+    resolved->qualifying_suffix_ = params->getQualifyingSuffix();
+    resolved->hostname_char_set_ = params->getHostnameCharSet();
+    resolved->hostname_char_replacement_ = params->getHostnameCharReplacement();
+    resolved->update_on_renew_ = params->getUpdateOnRenew();
+    resolved->use_conflict_resolution_ = params->getUseConflictResolution();
+    resolved->ttl_percent_ = params->getTtlPercent();
+
+    if (!resolved->hostname_char_set_.empty()) {
+        auto key = std::make_pair(resolved->hostname_char_set_,
+                                  resolved->hostname_char_replacement_);
+        auto it = sanitizers.find(key);
+        if (it != sanitizers.end()) {
+            resolved->hostname_sanitizer_ = it->second;
+        } else {
+            try {
+                resolved->hostname_sanitizer_ = params->getHostnameSanitizer();
+            } catch (const std::exception&) {
+                // Keep fetching the values from the subnet so the error
+                // is reported when the sanitizer is requested.
+                return (params);
+            }
+            sanitizers[key] = resolved->hostname_sanitizer_;
+        }
+    }
+
+    params->resolved_ = resolved;
+    return (params);
+}
+
+bool
+DdnsParams::isCurrent(const SubnetPtr& subnet, bool d2_client_enabled) const {
+    if (!resolved_ || (subnet != subnet_) ||
+        (d2_client_enabled != d2_client_enabled_) ||
+        (subnet->getDdnsParamsVersion() != resolved_->subnet_version_)) {
+        return (false);
+    }
+
+    NetworkPtr parent;
+    ConstCfgGlobalsPtr globals;
+    subnet->getDdnsParamsSources(parent, globals);
+    if ((parent != resolved_->parent_) || (globals != resolved_->globals_)) {
+        return (false);
+    }
+    if (parent && (parent->getDdnsParamsVersion() != resolved_->parent_version_)) {
+        return (false);
+    }
+    if (globals && (globals->getVersion() != resolved_->globals_version_)) {
+        return (false);
+    }
+    return (true);
+}
+
 } // namespace dhcp
 } // namespace isc
@@ -34,6 +34,10 @@
 #include <util/strutil.h>
 
 #include <boost/shared_ptr.hpp>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <stdint.h>
 
@@ -42,11 +46,26 @@ namespace dhcp {
 
 class CfgMgr;
 
+class DdnsParams;
+
+/// @brief Defines a pointer for DdnsParams instances.
+typedef boost::shared_ptr<DdnsParams> DdnsParamsPtr;
+
 /// @brief Convenience container for conveying DDNS behavioral parameters
 /// It is intended to be created per Packet exchange using the selected
 /// subnet passed into functions that require them
+///
+/// The instances created by the constructors fetch the values from the
+/// subnet each time they are called. The instances created by @c resolve
+/// hold the values resolved for the subnet and a compiled hostname
+/// sanitizer: they are immutable and shared by the packets processed
+/// with the same configuration.
 class DdnsParams {
 public:
+    /// @brief Hostname sanitizers indexed by char set and replacement.
+    typedef std::map<std::pair<std::string, std::string>,
+                     isc::util::str::StringSanitizerPtr> SanitizerMap;
+
     /// @brief Default constructor
     DdnsParams() : subnet_(), d2_client_enabled_(false) {};
 
@@ -72,6 +91,33 @@ public:
         : subnet_(boost::dynamic_pointer_cast<Subnet>(subnet)),
           d2_client_enabled_(d2_client_enabled) {}
 
+    /// @brief Creates an instance holding the values resolved for a subnet.
+    ///
+    /// @param subnet Pointer to the subnet.
+    /// @param d2_client_enabled flag which indicates whether or not
+    /// D2Client is enabled.
+    /// @param sanitizers Hostname sanitizers shared by the subnets using
+    /// the same char set and replacement. The sanitizer compiled for the
+    /// subnet is added to it.
+    /// @return Pointer to the instance.
+    static DdnsParamsPtr resolve(const SubnetPtr& subnet,
+                                 bool d2_client_enabled,
+                                 SanitizerMap& sanitizers);
+
+    /// @brief Checks whether the resolved values are still current.
+    ///
+    /// The values are current when they were resolved for the subnet
+    /// and neither the DDNS parameters of the subnet, of its shared
+    /// network and the global ones nor the D2Client enabled flag have
+    /// changed since.
+    ///
+    /// @param subnet Pointer to the subnet.
+    /// @param d2_client_enabled flag which indicates whether or not
+    /// D2Client is enabled.
+    /// @return true if this instance holds resolved values which are
+    /// still current, false otherwise.
+    bool isCurrent(const SubnetPtr& subnet, bool d2_client_enabled) const;
+
     /// @brief Returns whether or not DHCP DDNS updating is enabled.
     /// The value is the logical AND of d2_client_enabled_ and
     /// the value returned by subnet_'s getDdnsSendUpdates().
@@ -170,15 +216,69 @@ public:
     }
 
 private:
+    /// @brief Values resolved for the subnet.
+    struct Resolved {
+        /// @brief Value returned by @c getEnableUpdates.
+        bool enable_updates_;
+
+        /// @brief Value returned by @c getOverrideNoUpdate.
+        bool override_no_update_;
+
+        /// @brief Value returned by @c getOverrideClientUpdate.
+        bool override_client_update_;
+
+        /// @brief Value returned by @c getReplaceClientNameMode.
+        D2ClientConfig::ReplaceClientNameMode replace_client_name_mode_;
+
+        /// @brief Value returned by @c getGeneratedPrefix.
+        std::string generated_prefix_;
+
+        /// @brief Value returned by @c getQualifyingSuffix.
+        std::string qualifying_suffix_;
+
+        /// @brief Value returned by @c getHostnameCharSet.
+        std::string hostname_char_set_;
+
+        /// @brief Value returned by @c getHostnameCharReplacement.
+        std::string hostname_char_replacement_;
+
+        /// @brief Value returned by @c getHostnameSanitizer.
+        isc::util::str::StringSanitizerPtr hostname_sanitizer_;
+
+        /// @brief Value returned by @c getUpdateOnRenew.
+        bool update_on_renew_;
+
+        /// @brief Value returned by @c getUseConflictResolution.
+        bool use_conflict_resolution_;
+
+        /// @brief Value returned by @c getTtlPercent.
+        util::Optional<double> ttl_percent_;
+
+        /// @brief Version of the subnet DDNS parameters.
+        uint64_t subnet_version_;
+
+        /// @brief Shared network of the subnet.
+        NetworkPtr parent_;
+
+        /// @brief Version of the shared network DDNS parameters.
+        uint64_t parent_version_;
+
+        /// @brief Global parameters.
+        ConstCfgGlobalsPtr globals_;
+
+        /// @brief Version of the global parameters.
+        uint64_t globals_version_;
+    };
+
     /// @brief Subnet from which values should be fetched.
     SubnetPtr subnet_;
 
     /// @brief Flag indicating whether or not the D2Client is enabled.
     bool d2_client_enabled_;
-};
 
-/// @brief Defines a pointer for DdnsParams instances.
-typedef boost::shared_ptr<DdnsParams> DdnsParamsPtr;
+    /// @brief Values resolved for the subnet or null.
+    boost::shared_ptr<const Resolved> resolved_;
+};
 
 /// @brief Specifies current DHCP configuration
 ///
@@ -613,7 +713,9 @@ public:
 
     /// @brief Fetches the DDNS parameters for a given DHCPv4 subnet.
     ///
-    /// Creates a DdnsParams structure which retain and thereafter
+    /// Returns the DDNS parameters resolved for the subnet by
+    /// @c resolveDdnsParams when they are still current. Otherwise
+    /// creates a DdnsParams structure which retain and thereafter
     /// use the given subnet to fetch DDNS behavioral parameters.
     /// The values are fetched with the inheritance scope mode
     /// of Network::ALL.
@@ -624,7 +726,9 @@ public:
 
     /// @brief Fetches the DDNS parameters for a given DHCPv6 subnet.
     ///
-    /// Creates a DdnsParams structure which retain and thereafter
+    /// Returns the DDNS parameters resolved for the subnet by
+    /// @c resolveDdnsParams when they are still current. Otherwise
+    /// creates a DdnsParams structure which retain and thereafter
     /// use the given subnet to fetch DDNS behavioral parameters.
     /// The values are fetched with the inheritance scope mode
     /// of Network::ALL.
@@ -633,6 +737,25 @@ public:
     /// @return pointer to DddnParams instance
     DdnsParamsPtr getDdnsParams(const Subnet6Ptr& subnet) const;
 
+    /// @brief Resolves the DDNS parameters of all the subnets.
+    ///
+    /// It is called when the configuration becomes the current one and
+    /// after a configuration is merged into it. The resolved parameters
+    /// are only read afterwards, so they are shared by the packet
+    /// processing threads without locking. The subnets using the same
+    /// hostname char set and replacement share the compiled sanitizer.
+    void resolveDdnsParams();
+
+    /// @brief Resolves the frequently used properties of the shared
+    /// networks and subnets.
+    ///
+    /// It is called with @c resolveDdnsParams. The subnet accessors
+    /// called for each packet then read the resolved values instead of
+    /// walking the shared network and the global parameters.
+    ///
+    /// @ref Network::resolveProperties
+    void resolveNetworkProperties();
+
     /// @brief Copies the current configuration to a new configuration.
     ///
     /// This method copies the parameters stored in the configuration to
@@ -766,6 +889,29 @@ public:
     /// @ref CfgSubnets6::updateStatistics for details.
     void updateStatistics();
 
+    /// @brief Updates statistics after a configuration change.
+    ///
+    /// When the lease database is the same persistent database as the
+    /// one of the previous configuration, the lease statistics of the
+    /// subnets which did not change are kept and only the new or changed
+    /// subnets are recounted. Otherwise the statistics of the previous
+    /// configuration are removed and all the subnets are recounted.
+    ///
+    /// @param previous the previous configuration.
+    void updateStatistics(SrvConfig& previous);
+
+    /// @brief Updates statistics after a merge of subnets.
+    ///
+    /// The merge does not change the lease database so only the new or
+    /// changed subnets are recounted. See
+    /// @ref CfgSubnets4::updateStatistics(const Subnet4Collection&) and
+    /// @ref CfgSubnets6::updateStatistics(const Subnet6Collection&).
+    ///
+    /// @param subnets4 the IPv4 subnets before the merge.
+    /// @param subnets6 the IPv6 subnets before the merge.
+    void updateStatistics(const Subnet4Collection& subnets4,
+                          const Subnet6Collection& subnets6);
+
     /// @brief Removes statistics.
     ///
     /// This method calls appropriate methods in child objects that remove
@@ -1054,8 +1200,22 @@ public:
     /// Happens on configuration commit.
     void configureLowerLevelLibraries() const;
 
+    /// @brief Checks if the leases are the same as with another configuration.
+    ///
+    /// It is the case when both configurations use the same lease database
+    /// access string and the database keeps the leases when the lease
+    /// manager is recreated, i.e. it is not a non persistent memfile.
+    ///
+    /// @param other the other configuration.
+    /// @return true if the lease statistics and allocation states of other
+    /// remain valid.
+    bool sameLeaseDatabase(const SrvConfig& other) const;
+
 private:
 
+    /// @brief Updates the default sample limits of the statistics.
+    void updateSampleLimits();
+
     /// @brief Merges the DHCPv4 configuration specified as a parameter into
     /// this configuration.
     ///
@@ -1225,6 +1385,9 @@ private:
     /// reservations lookup is always performed first.
     /// It default to false when multi-threading is disabled.
     bool reservations_lookup_first_;
+
+    /// @brief DDNS parameters resolved for the subnets.
+    std::unordered_map<const Subnet*, DdnsParamsPtr> resolved_ddns_params_;
 };
 
 /// @name Pointers to the @c SrvConfig object.
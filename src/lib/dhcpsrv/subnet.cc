@@ -9,6 +9,8 @@
 #include <asiolink/io_address.h>
 #include <asiolink/addr_utilities.h>
 #include <dhcp/option_space.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
+#include <dhcpsrv/bitmap_allocator.h>
 #include <dhcpsrv/flq_allocation_state.h>
 #include <dhcpsrv/flq_allocator.h>
 #include <dhcpsrv/iterative_allocation_state.h>
@@ -17,6 +19,7 @@
 #include <dhcpsrv/random_allocator.h>
 #include <dhcpsrv/shared_network.h>
 #include <dhcpsrv/subnet.h>
+#include <stats/stats_mgr.h>
 #include <util/multi_threading_mgr.h>
 
 #include <boost/lexical_cast.hpp>
@@ -28,10 +31,33 @@
 using namespace isc::asiolink;
 using namespace isc::data;
 using namespace isc::dhcp;
+using namespace isc::stats;
 using namespace isc::util;
 
 namespace {
 
+/// @brief Names of the lease statistics of the IPv4 and IPv6 subnets.
+const char* const LEASE_STAT_NAMES[2][Subnet::STAT_COUNT] = {
+    {
+        "assigned-addresses",
+        "",
+        "cumulative-assigned-addresses",
+        "",
+        "declined-addresses",
+        "reclaimed-leases",
+        "reclaimed-declined-addresses"
+    },
+    {
+        "assigned-nas",
+        "assigned-pds",
+        "cumulative-assigned-nas",
+        "cumulative-assigned-pds",
+        "declined-addresses",
+        "reclaimed-leases",
+        "reclaimed-declined-addresses"
+    }
+};
+
 /// @brief Function used in calls to std::upper_bound to check
 /// if the specified prefix is lower than the first address a pool.
 ///
@@ -435,6 +461,80 @@ Subnet::initAllocatorsAfterConfigure() {
     }
 }
 
+std::string
+Subnet::getLeaseStatName(LeaseStat stat) const {
+    return (LEASE_STAT_NAMES[prefix_.isV4() ? 0 : 1][stat]);
+}
+
+void
+Subnet::bindLeaseStats() {
+    StatsMgr& stats_mgr = StatsMgr::instance();
+    for (int stat = 0; stat < STAT_COUNT; ++stat) {
+        std::string name = getLeaseStatName(static_cast<LeaseStat>(stat));
+        if (name.empty()) {
+            lease_stats_[stat].reset();
+            continue;
+        }
+        lease_stats_[stat] =
+            stats_mgr.registerCounter(StatsMgr::generateName("subnet", id_, name));
+    }
+}
+
+void
+Subnet::addLeaseStatByName(LeaseStat stat, int64_t value) const {
+    StatsMgr::instance().addValue(StatsMgr::generateName("subnet", id_,
+                                                         getLeaseStatName(stat)),
+                                  value);
+}
+
+bool
+Subnet::reuseAllocationStates(const Subnet& previous, bool same_leases) {
+    if ((previous.getID() != getID()) ||
+        (previous.allocators_.size() != allocators_.size())) {
+        return (false);
+    }
+    for (auto const& allocator : allocators_) {
+        auto prev = previous.allocators_.find(allocator.first);
+        if ((prev == previous.allocators_.end()) ||
+            (prev->second->getType() != allocator.second->getType()) ||
+            !allocator.second->canReuseStates(same_leases)) {
+            return (false);
+        }
+    }
+
+    // The pools are compared by the full subnet comparison but check
+    // their ranges to be safe when pairing their states.
+    for (auto const& allocator : allocators_) {
+        const PoolCollection& pools = getPools(allocator.first);
+        const PoolCollection& prev_pools = previous.getPools(allocator.first);
+        if (pools.size() != prev_pools.size()) {
+            return (false);
+        }
+        for (size_t i = 0; i < pools.size(); ++i) {
+            if ((pools[i]->getFirstAddress() != prev_pools[i]->getFirstAddress()) ||
+                (pools[i]->getLastAddress() != prev_pools[i]->getLastAddress())) {
+                return (false);
+            }
+        }
+    }
+    if (!previous.toElement()->equals(*toElement())) {
+        return (false);
+    }
+
+    for (auto const& allocator : allocators_) {
+        auto state = previous.allocation_states_.find(allocator.first);
+        if (state != previous.allocation_states_.end()) {
+            setAllocationState(allocator.first, state->second);
+        }
+        const PoolCollection& pools = getPools(allocator.first);
+        const PoolCollection& prev_pools = previous.getPools(allocator.first);
+        for (size_t i = 0; i < pools.size(); ++i) {
+            pools[i]->setAllocationState(prev_pools[i]->getAllocationState());
+        }
+    }
+    return (true);
+}
+
 const PoolPtr Subnet::getPool(Lease::Type type,
                               const ClientClasses& client_classes,
                               const isc::asiolink::IOAddress& hint) const {
@@ -772,6 +872,14 @@ Subnet4::createAllocators() {
             pool->setAllocationState(PoolFreeLeaseQueueAllocationState::create(pool));
         }
 
+    } else if (allocator_type == "bitmap") {
+        setAllocator(Lease::TYPE_V4,
+                     boost::make_shared<BitmapAllocator>
+                     (Lease::TYPE_V4, shared_from_this()));
+        for (auto pool : pools_) {
+            pool->setAllocationState(PoolBitmapAllocationState::create(pool));
+        }
+
     } else {
         setAllocator(Lease::TYPE_V4,
                      boost::make_shared<IterativeAllocator>
@@ -835,6 +943,9 @@ Subnet6::createAllocators() {
     } else if (allocator_type == "flq") {
         isc_throw(BadValue, "Free Lease Queue allocator is not supported for IPv6 address pools");
 
+    } else if (allocator_type == "bitmap") {
+        isc_throw(BadValue, "Bitmap allocator is not supported for IPv6 address pools");
+
     } else {
         setAllocator(Lease::TYPE_NA,
                      boost::make_shared<IterativeAllocator>
@@ -17,6 +17,7 @@
 #include <dhcpsrv/network.h>
 #include <dhcpsrv/pool.h>
 #include <dhcpsrv/subnet_id.h>
+#include <stats/stat_counter.h>
 #include <util/dhcp_space.h>
 #include <util/triplet.h>
 
@@ -31,6 +32,7 @@
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <array>
 #include <cstdint>
 #include <map>
 #include <utility>
@@ -41,6 +43,26 @@ namespace dhcp {
 class Subnet : public virtual Network {
 public:
 
+    /// @brief Lease statistics of the subnet updated for the lease events.
+    enum LeaseStat {
+        /// @brief assigned-addresses or assigned-nas.
+        STAT_ASSIGNED,
+        /// @brief assigned-pds, IPv6 only.
+        STAT_ASSIGNED_PDS,
+        /// @brief cumulative-assigned-addresses or cumulative-assigned-nas.
+        STAT_CUMULATIVE_ASSIGNED,
+        /// @brief cumulative-assigned-pds, IPv6 only.
+        STAT_CUMULATIVE_ASSIGNED_PDS,
+        /// @brief declined-addresses.
+        STAT_DECLINED,
+        /// @brief reclaimed-leases.
+        STAT_RECLAIMED,
+        /// @brief reclaimed-declined-addresses.
+        STAT_RECLAIMED_DECLINED,
+        /// @brief Number of lease statistics.
+        STAT_COUNT
+    };
+
     /// @brief checks if specified address is in range.
     ///
     /// @param addr this address will be checked if it is included in a specific
@@ -249,6 +271,7 @@ public:
     /// with the subnet.
     void setSharedNetwork(const NetworkPtr& shared_network) {
         parent_network_ = shared_network;
+        invalidateResolvedProperties();
     }
 
     /// @brief Returns shared network name.
@@ -329,6 +352,50 @@ public:
     /// @brief Calls @c initAfterConfigure for each allocator.
     void initAllocatorsAfterConfigure();
 
+    /// @brief Returns the name of a lease statistic.
+    ///
+    /// @param stat the lease statistic.
+    /// @return the name without the subnet prefix, e.g. "assigned-nas".
+    std::string getLeaseStatName(LeaseStat stat) const;
+
+    /// @brief Binds the lease statistics to counters.
+    ///
+    /// It is called when the configuration is committed so the lease
+    /// events update the statistics without building their names.
+    void bindLeaseStats();
+
+    /// @brief Adds a value to a lease statistic.
+    ///
+    /// When the statistic is not bound it is updated by name.
+    ///
+    /// @param stat the lease statistic.
+    /// @param value the value to add.
+    void addLeaseStat(LeaseStat stat, int64_t value) const {
+        const stats::StatCounterPtr& counter = lease_stats_[stat];
+        if (counter) {
+            counter->add(value);
+        } else {
+            addLeaseStatByName(stat, value);
+        }
+    }
+
+    /// @brief Reuses the allocation states of the previous instance of
+    /// the subnet.
+    ///
+    /// When the subnet configuration including the pools and the
+    /// allocator types is the same as the previous one, the subnet and
+    /// pool allocation states are moved from the previous instance so the
+    /// allocation goes on where it was, e.g. the random allocator keeps
+    /// its permutations. This must be called after @c createAllocators
+    /// and before @c initAllocatorsAfterConfigure.
+    ///
+    /// @param previous the subnet instance from the current configuration.
+    /// @param same_leases true when the lease database is the same as in
+    /// the current configuration.
+    /// @return true when the states were reused, false when the subnets
+    /// differ or an allocator can't reuse the states.
+    bool reuseAllocationStates(const Subnet& previous, bool same_leases = false);
+
 protected:
 
     /// @brief Protected constructor.
@@ -481,6 +548,17 @@ protected:
 
     /// @brief Holds subnet-specific allocation state.
     std::map<Lease::Type, SubnetAllocationStatePtr> allocation_states_;
+
+private:
+
+    /// @brief Adds a value to a lease statistic by name.
+    ///
+    /// @param stat the lease statistic.
+    /// @param value the value to add.
+    void addLeaseStatByName(LeaseStat stat, int64_t value) const;
+
+    /// @brief Counters of the lease statistics, null when not bound.
+    std::array<stats::StatCounterPtr, STAT_COUNT> lease_stats_;
 };
 
 /// @brief A generic pointer to either Subnet4 or Subnet6 object
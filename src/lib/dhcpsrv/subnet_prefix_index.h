@@ -0,0 +1,174 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SUBNET_PREFIX_INDEX_H
+#define SUBNET_PREFIX_INDEX_H
+
+#include <asiolink/addr_utilities.h>
+#include <asiolink/io_address.h>
+#include <exceptions/exceptions.h>
+#include <boost/functional/hash.hpp>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Index of the subnets by prefix.
+///
+/// This index finds the subnets an address belongs to without a full
+/// scan of the subnets. It holds one hash table per prefix length, each
+/// table mapping the first address of a prefix to the subnets having this
+/// prefix. A lookup masks the address once for each prefix length in use,
+/// so its cost depends on the number of distinct prefix lengths rather
+/// than on the number of subnets.
+///
+/// The subnet prefixes are not changed after the subnet is created so the
+/// index only has to be updated when subnets are added or removed.
+///
+/// @tparam SubnetPtrType Type of the pointer to a subnet, e.g.
+/// @c Subnet4Ptr or @c Subnet6Ptr.
+template<typename SubnetPtrType>
+class SubnetPrefixIndex {
+public:
+
+    /// @brief Collection of subnets.
+    typedef std::vector<SubnetPtrType> SubnetVector;
+
+    /// @brief Constructor.
+    ///
+    /// @param family Address family of the indexed subnets, AF_INET or
+    /// AF_INET6.
+    explicit SubnetPrefixIndex(const uint16_t family)
+        : v4_(family == AF_INET),
+          tables_(v4_ ? 33 : 129) {
+    }
+
+    /// @brief Adds a subnet to the index.
+    ///
+    /// @param subnet Pointer to the subnet.
+    void add(const SubnetPtrType& subnet) {
+        auto const& prefix = subnet->get();
+        if (prefix.second >= tables_.size()) {
+            isc_throw(BadValue, "invalid prefix length "
+                      << static_cast<unsigned>(prefix.second));
+        }
+        Table& table = tables_[prefix.second];
+        SubnetVector& subnets = table[getKey(prefix.first, prefix.second)];
+        // Subnets are kept in the order of their identifiers so the lookups
+        // return the same subnet as a scan of the subnets.
+        auto it = std::lower_bound(subnets.begin(), subnets.end(), subnet,
+                                   lessById);
+        subnets.insert(it, subnet);
+        updateLengths();
+    }
+
+    /// @brief Removes a subnet from the index.
+    ///
+    /// It does nothing if the subnet is not in the index.
+    ///
+    /// @param subnet Pointer to the subnet.
+    void del(const SubnetPtrType& subnet) {
+        auto const& prefix = subnet->get();
+        if (prefix.second >= tables_.size()) {
+            return;
+        }
+        Table& table = tables_[prefix.second];
+        auto bucket = table.find(getKey(prefix.first, prefix.second));
+        if (bucket == table.end()) {
+            return;
+        }
+        SubnetVector& subnets = bucket->second;
+        subnets.erase(std::remove(subnets.begin(), subnets.end(), subnet),
+                      subnets.end());
+        if (subnets.empty()) {
+            table.erase(bucket);
+        }
+        updateLengths();
+    }
+
+    /// @brief Removes all subnets from the index.
+    void clear() {
+        for (auto& table : tables_) {
+            table.clear();
+        }
+        lengths_.clear();
+    }
+
+    /// @brief Returns the subnets the address belongs to.
+    ///
+    /// @param address Address to be matched with the subnet prefixes.
+    ///
+    /// @return The subnets the address belongs to, ordered by identifier.
+    SubnetVector getAll(const asiolink::IOAddress& address) const {
+        SubnetVector result;
+        if (address.isV4() != v4_) {
+            return (result);
+        }
+        for (auto len : lengths_) {
+            const Table& table = tables_[len];
+            auto bucket = table.find(getKey(address, len));
+            if (bucket != table.end()) {
+                result.insert(result.end(), bucket->second.begin(),
+                              bucket->second.end());
+            }
+        }
+        if (lengths_.size() > 1) {
+            std::sort(result.begin(), result.end(), lessById);
+        }
+        return (result);
+    }
+
+private:
+
+    /// @brief Subnets by first address of their prefix.
+    typedef std::unordered_map<asiolink::IOAddress, SubnetVector,
+                               boost::hash<asiolink::IOAddress> > Table;
+
+    /// @brief Returns the first address of a prefix.
+    ///
+    /// @param address Address within the prefix.
+    /// @param len Prefix length.
+    asiolink::IOAddress getKey(const asiolink::IOAddress& address,
+                               const uint8_t len) const {
+        if (v4_) {
+            uint32_t mask = (len == 0 ? 0 : (0xFFFFFFFFu << (32 - len)));
+            return (asiolink::IOAddress(address.toUint32() & mask));
+        }
+        return (asiolink::firstAddrInPrefix(address, len));
+    }
+
+    /// @brief Collects the prefix lengths which have subnets.
+    void updateLengths() {
+        lengths_.clear();
+        for (size_t len = 0; len < tables_.size(); ++len) {
+            if (!tables_[len].empty()) {
+                lengths_.push_back(static_cast<uint8_t>(len));
+            }
+        }
+    }
+
+    /// @brief Compares subnets by identifier.
+    static bool lessById(const SubnetPtrType& first,
+                         const SubnetPtrType& second) {
+        return (first->getID() < second->getID());
+    }
+
+    /// @brief Indicates that the index holds IPv4 subnets.
+    bool v4_;
+
+    /// @brief Tables indexed by prefix length.
+    std::vector<Table> tables_;
+
+    /// @brief Prefix lengths which have subnets.
+    std::vector<uint8_t> lengths_;
+};
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // SUBNET_PREFIX_INDEX_H
@@ -449,6 +449,54 @@ TEST_F(AllocEngine4Test, allocWithUsedHint4) {
     ASSERT_FALSE(from_mgr);
 }
 
+// This test checks that the context caches the lease lookups of the
+// exchange until the end of the allocation.
+TEST_F(AllocEngine4Test, leaseCache4) {
+    boost::scoped_ptr<AllocEngine> engine;
+    ASSERT_NO_THROW(engine.reset(new AllocEngine(0)));
+    ASSERT_TRUE(engine);
+
+    time_t now = time(NULL);
+    Lease4Ptr used(new Lease4(IOAddress("192.0.2.106"), hwaddr_, clientid_,
+                              100, now, subnet_->getID()));
+    ASSERT_TRUE(LeaseMgrFactory::instance().addLease(used));
+
+    AllocEngine::ClientContext4 ctx(subnet_, clientid_, hwaddr_,
+                                    IOAddress("192.0.2.106"), false, false,
+                                    "", false);
+    ctx.query_.reset(new Pkt4(DHCPREQUEST, 1234));
+
+    EXPECT_EQ(1, ctx.getLeases4ByClientId().size());
+    EXPECT_EQ(1, ctx.getLeases4ByHWAddr().size());
+    Lease4Ptr cached = ctx.getLease4(IOAddress("192.0.2.106"));
+    ASSERT_TRUE(cached);
+    EXPECT_FALSE(ctx.getLease4(IOAddress("192.0.2.107")));
+
+    // The next lookups don't query the lease database.
+    ASSERT_TRUE(LeaseMgrFactory::instance().deleteLease(used));
+    EXPECT_EQ(1, ctx.getLeases4ByClientId().size());
+    EXPECT_EQ(1, ctx.getLeases4ByHWAddr().size());
+    EXPECT_EQ(cached, ctx.getLease4(IOAddress("192.0.2.106")));
+
+    // The leases of another client identifier are fetched.
+    ctx.clientid_ = clientid2_;
+    EXPECT_TRUE(ctx.getLeases4ByClientId().empty());
+    ctx.clientid_ = clientid_;
+
+    ctx.clearLeaseCache();
+    EXPECT_TRUE(ctx.getLeases4ByClientId().empty());
+    EXPECT_TRUE(ctx.getLeases4ByHWAddr().empty());
+    EXPECT_FALSE(ctx.getLease4(IOAddress("192.0.2.106")));
+
+    // The allocation uses the cached lookup and clears the cache.
+    Lease4Ptr lease = engine->allocateLease4(ctx);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("192.0.2.106", lease->addr_.toText());
+    Lease4Ptr from_cache = ctx.getLease4(lease->addr_);
+    ASSERT_TRUE(from_cache);
+    detailCompareLease(lease, from_cache);
+}
+
 // This test checks if an allocation with a hint that is out of the blue
 // can succeed. The invalid hint should be ignored completely.
 TEST_F(AllocEngine4Test, allocBogusHint4) {
@@ -1450,6 +1498,36 @@ TEST_F(SharedNetworkAlloc4Test, requestSharedNetwork) {
     EXPECT_EQ("192.0.2.17", lease2->addr_.toText());
 }
 
+// This test verifies that a client renewing the lease of the requested
+// address gets this lease even when it has other leases in the shared
+// network.
+TEST_F(SharedNetworkAlloc4Test, requestSharedNetworkRenewRequested) {
+    // The client has a lease in each subnet.
+    Lease4Ptr lease1 = insertLease("192.0.2.17", subnet1_->getID());
+    Lease4Ptr lease2 = insertLease("10.1.2.25", subnet2_->getID());
+
+    // The client renews the lease of the second subnet starting from
+    // the first subnet.
+    AllocEngine::ClientContext4 ctx(subnet1_, ClientIdPtr(), hwaddr2_,
+                                    IOAddress("10.1.2.25"), false, false,
+                                    "host.example.com.", false);
+    ctx.query_.reset(new Pkt4(DHCPREQUEST, 1234));
+    Lease4Ptr lease = engine_.allocateLease4(ctx);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("10.1.2.25", lease->addr_.toText());
+    ASSERT_TRUE(ctx.subnet_);
+    EXPECT_EQ(subnet2_->getID(), ctx.subnet_->getID());
+    ASSERT_TRUE(ctx.old_lease_);
+    EXPECT_EQ("10.1.2.25", ctx.old_lease_->addr_.toText());
+
+    // Another client can't get this lease.
+    AllocEngine::ClientContext4 ctx2(subnet1_, ClientIdPtr(), hwaddr_,
+                                     IOAddress("10.1.2.25"), false, false,
+                                     "host.example.com.", false);
+    ctx2.query_.reset(new Pkt4(DHCPREQUEST, 1234));
+    EXPECT_FALSE(engine_.allocateLease4(ctx2));
+}
+
 // This test verifies that the server can assign an address from a
 // different subnet than orginally selected, when the address pool in
 // the first subnet is exhausted.
@@ -11,10 +11,12 @@
 #include <dhcpsrv/parsers/client_class_def_parser.h>
 #include <dhcpsrv/tests/alloc_engine_utils.h>
 #include <dhcpsrv/allocator.h>
+#include <dhcpsrv/flq_allocator.h>
 #include <dhcpsrv/testutils/test_utils.h>
 #include <eval/eval_context.h>
 #include <stats/stats_mgr.h>
 #include <testutils/gtest_utils.h>
+#include <boost/make_shared.hpp>
 #include <boost/pointer_cast.hpp>
 
 using namespace std;
@@ -2033,6 +2035,97 @@ TEST_F(AllocEngine6Test, reserved2Addresses) {
     EXPECT_EQ("2001:db8:1::cafe", leases3[0]->addr_.toText());
 }
 
+// Checks that the leases of the reserved addresses are fetched once and
+// cached in the context.
+TEST_F(AllocEngine6Test, reserved2AddressesCached) {
+    HostPtr host = createHost6(true, IPv6Resrv::TYPE_NA,
+                               IOAddress("2001:db8:1::babe"), 128);
+
+    IPv6Resrv resv2(IPv6Resrv::TYPE_NA, IOAddress("2001:db8:1::cafe"), 128);
+    host->addReservation(resv2);
+    CfgMgr::instance().getStagingCfg()->getCfgHosts()->add(host);
+    CfgMgr::instance().commit();
+
+    // The first reserved address is used by another client.
+    DuidPtr other_duid = DuidPtr(new DUID(vector<uint8_t>(12, 0xff)));
+    Lease6Ptr used(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8:1::babe"),
+                              other_duid, 3568, 501, 502, subnet_->getID(),
+                              HWAddrPtr(), 0));
+    ASSERT_TRUE(LeaseMgrFactory::instance().addLease(used));
+
+    AllocEngine engine(100);
+
+    AllocEngine::ClientContext6 ctx(subnet_, duid_, false, false, "", false,
+                                    Pkt6Ptr(new Pkt6(DHCPV6_REQUEST, 1234)));
+    ctx.currentIA().iaid_ = iaid_;
+    ctx.currentIA().type_ = pool_->getType();
+
+    Lease6Collection leases;
+    findReservation(engine, ctx);
+    EXPECT_NO_THROW(leases = engine.allocateLeases6(ctx));
+    ASSERT_EQ(1, leases.size());
+    EXPECT_EQ("2001:db8:1::cafe", leases[0]->addr_.toText());
+
+    // The lease of the used address is cached and the allocated address
+    // is no longer cached as free.
+    ASSERT_EQ(1, ctx.reserved_leases_.count(Lease::TYPE_NA));
+    auto const& cached = ctx.reserved_leases_[Lease::TYPE_NA];
+    ASSERT_EQ(1, cached.size());
+    auto it = cached.find(IOAddress("2001:db8:1::babe"));
+    ASSERT_TRUE(it != cached.end());
+    ASSERT_TRUE(it->second);
+    EXPECT_TRUE(*other_duid == *it->second->duid_);
+}
+
+// Checks that the leases of a client sending several IAs are fetched
+// once and dispatched to the IAs.
+TEST_F(AllocEngine6Test, multipleIAsClientLeases) {
+    Lease6Ptr lease1(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8:1::15"),
+                                duid_, iaid_, 501, 502, subnet_->getID(),
+                                HWAddrPtr(), 0));
+    Lease6Ptr lease2(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8:1::16"),
+                                duid_, iaid_ + 1, 501, 502, subnet_->getID(),
+                                HWAddrPtr(), 0));
+    ASSERT_TRUE(LeaseMgrFactory::instance().addLease(lease1));
+    ASSERT_TRUE(LeaseMgrFactory::instance().addLease(lease2));
+
+    AllocEngine engine(100);
+
+    Pkt6Ptr query(new Pkt6(DHCPV6_REQUEST, 1234));
+    query->addOption(OptionPtr(new Option6IA(D6O_IA_NA, iaid_)));
+    query->addOption(OptionPtr(new Option6IA(D6O_IA_NA, iaid_ + 1)));
+    AllocEngine::ClientContext6 ctx(subnet_, duid_, false, false, "", false,
+                                    query);
+    ctx.currentIA().iaid_ = iaid_;
+    ctx.currentIA().type_ = Lease::TYPE_NA;
+
+    Lease6Collection leases;
+    findReservation(engine, ctx);
+    EXPECT_NO_THROW(leases = engine.allocateLeases6(ctx));
+    ASSERT_EQ(1, leases.size());
+    EXPECT_EQ("2001:db8:1::15", leases[0]->addr_.toText());
+    ASSERT_TRUE(ctx.client_leases_);
+    EXPECT_EQ(2, ctx.client_leases_->size());
+
+    ctx.createIAContext();
+    ctx.currentIA().iaid_ = iaid_ + 1;
+    ctx.currentIA().type_ = Lease::TYPE_NA;
+    EXPECT_NO_THROW(leases = engine.allocateLeases6(ctx));
+    ASSERT_EQ(1, leases.size());
+    EXPECT_EQ("2001:db8:1::16", leases[0]->addr_.toText());
+
+    // A single IA does not fetch all the leases of the client.
+    AllocEngine::ClientContext6 ctx1(subnet_, duid_, false, false, "", false,
+                                     Pkt6Ptr(new Pkt6(DHCPV6_REQUEST, 1235)));
+    ctx1.currentIA().iaid_ = iaid_;
+    ctx1.currentIA().type_ = Lease::TYPE_NA;
+    findReservation(engine, ctx1);
+    EXPECT_NO_THROW(leases = engine.allocateLeases6(ctx1));
+    ASSERT_EQ(1, leases.size());
+    EXPECT_EQ("2001:db8:1::15", leases[0]->addr_.toText());
+    EXPECT_FALSE(ctx1.client_leases_);
+}
+
 // Checks whether address can change during renew (if there is a new
 // reservation for this client)
 TEST_F(AllocEngine6Test, reservedAddressRenewChange) {
@@ -2854,6 +2947,47 @@ TEST_F(SharedNetworkAlloc6Test, solicitSharedNetworkOutOfAddresses) {
     ASSERT_TRUE(subnet1_->inRange(lease2->addr_));
 }
 
+// This test verifies that the client is offered an address from an
+// alternative subnet within shared network when the free lease queue
+// allocator of the first subnet knows that its pool is exhausted.
+TEST_F(SharedNetworkAlloc6Test, solicitSharedNetworkExhaustedFlq) {
+
+    // Create a lease for a single address in the first address pool. The
+    // pool is now exhausted.
+    DuidPtr other_duid(new DUID(vector<uint8_t>(12, 0xff)));
+    const uint32_t other_iaid = 3568;
+    Lease6Ptr lease(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8:1::1"),
+                               other_duid, other_iaid, 501, 502,
+                               subnet1_->getID(),
+                               HWAddrPtr(), 0));
+    lease->cltt_ = time(NULL) - 10; // Allocated 10 seconds ago
+    ASSERT_TRUE(LeaseMgrFactory::instance().addLease(lease));
+
+    // Use the free lease queue allocators which get the free leases
+    // from the lease database.
+    subnet1_->setAllocator(Lease::TYPE_NA,
+                           boost::make_shared<FreeLeaseQueueAllocator>
+                           (Lease::TYPE_NA, subnet1_));
+    subnet2_->setAllocator(Lease::TYPE_NA,
+                           boost::make_shared<FreeLeaseQueueAllocator>
+                           (Lease::TYPE_NA, subnet2_));
+    subnet1_->initAllocatorsAfterConfigure();
+    subnet2_->initAllocatorsAfterConfigure();
+    ClientClasses classes;
+    EXPECT_EQ(0, subnet1_->getAllocator(Lease::TYPE_NA)->getFreeLeaseCount(classes));
+
+    // The first subnet is skipped.
+    Pkt6Ptr query(new Pkt6(DHCPV6_SOLICIT, 1234));
+    AllocEngine::ClientContext6 ctx(subnet1_, duid_, false, false, "", true,
+                                    query);
+    ctx.currentIA().iaid_ = iaid_;
+
+    Lease6Ptr lease2;
+    ASSERT_NO_THROW(lease2 = expectOneLease(engine_.allocateLeases6(ctx)));
+    ASSERT_TRUE(lease2);
+    ASSERT_TRUE(subnet2_->inRange(lease2->addr_));
+}
+
 // This test verifies that the server can offer an address from a
 // different subnet than orginally selected, when the address pool in
 // the first subnet is exhausted.
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,6 +12,7 @@
 #include <dhcpsrv/testutils/test_utils.h>
 #include <hooks/hooks_manager.h>
 #include <stats/stats_mgr.h>
+#include <util/multi_threading_mgr.h>
 #include <gtest/gtest.h>
 #include <boost/static_assert.hpp>
 #include <functional>
@@ -30,6 +31,7 @@ using namespace isc::dhcp::test;
 using namespace isc::dhcp_ddns;
 using namespace isc::hooks;
 using namespace isc::stats;
+using namespace isc::util;
 namespace ph = std::placeholders;
 
 namespace {
@@ -2169,6 +2171,29 @@ TEST_F(ExpirationAllocEngine4Test, reclaimExpiredLeasesDelete) {
     testReclaimExpiredLeasesDelete();
 }
 
+// This test verifies that the leases are reclaimed by the threads of the
+// thread pool when the parallel reclamation is requested.
+TEST_F(ExpirationAllocEngine4Test, reclaimExpiredLeasesParallel) {
+    for (unsigned int i = 0; i < TEST_LEASES_NUM; ++i) {
+        // Spread the leases over several subnets.
+        setSubnetId(i, SubnetID(1 + i % 4));
+        // Mark leases with even indexes as expired.
+        if (evenLeaseIndex(i)) {
+            expire(i, 10 + i);
+        }
+    }
+
+    MultiThreadingMgr::instance().apply(true, 4, 0);
+    ASSERT_NO_THROW(engine_->reclaimExpiredLeases4(0, 0, false, 0, true));
+    ASSERT_TRUE(MultiThreadingMgr::instance().getThreadPool().wait(10));
+    MultiThreadingMgr::instance().apply(false, 0, 0);
+
+    // Leases with even indexes should be marked as reclaimed.
+    EXPECT_TRUE(testLeases(&leaseReclaimed, &evenLeaseIndex));
+    // Leases with odd indexes shouldn't be marked as reclaimed.
+    EXPECT_TRUE(testLeases(&leaseNotReclaimed, &oddLeaseIndex));
+}
+
 // This test verifies that it is possible to specify the limit for the
 // number of reclaimed leases.
 TEST_F(ExpirationAllocEngine4Test, reclaimExpiredLeasesLimit) {
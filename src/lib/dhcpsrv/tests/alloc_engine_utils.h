@@ -69,6 +69,7 @@ public:
 
     using IterativeAllocator::increaseAddress;
     using IterativeAllocator::increasePrefix;
+    using IterativeAllocator::initOccupancyFilter;
 };
 
 /// @brief Allocation engine with some internal methods exposed
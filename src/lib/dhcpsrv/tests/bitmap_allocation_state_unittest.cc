@@ -0,0 +1,112 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/pool.h>
+#include <boost/make_shared.hpp>
+#include <gtest/gtest.h>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+// Test creating a new bitmap allocation state for an IPv4 address pool.
+TEST(PoolBitmapAllocationStateTest, createV4) {
+    auto pool = boost::make_shared<Pool4>(IOAddress("192.0.2.1"), IOAddress("192.0.2.10"));
+    auto state = PoolBitmapAllocationState::create(pool);
+    ASSERT_TRUE(state);
+    EXPECT_TRUE(state->exhausted());
+    EXPECT_EQ(0, state->getFreeLeaseCount());
+}
+
+// Test that the bitmap allocation state can't be created for IPv6 pools.
+TEST(PoolBitmapAllocationStateTest, createV6) {
+    auto pool = boost::make_shared<Pool6>(Lease::TYPE_NA, IOAddress("2001:db8:1::1"),
+                                          IOAddress("2001:db8:1::10"));
+    EXPECT_THROW(PoolBitmapAllocationState::create(pool), BadValue);
+}
+
+// Test adding and deleting free IPv4 leases.
+TEST(PoolBitmapAllocationStateTest, addDeleteFreeLease) {
+    PoolBitmapAllocationState state(IOAddress("192.0.2.1"), IOAddress("192.0.2.10"));
+
+    // Add the first free lease. It is always offered.
+    state.addFreeLease(IOAddress("192.0.2.1"));
+    EXPECT_FALSE(state.exhausted());
+    EXPECT_EQ(1, state.getFreeLeaseCount());
+    EXPECT_EQ("192.0.2.1", state.offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.1", state.offerFreeLease().toText());
+
+    // Adding the same lease again doesn't change anything.
+    state.addFreeLease(IOAddress("192.0.2.1"));
+    EXPECT_EQ(1, state.getFreeLeaseCount());
+
+    // Addresses out of the pool are ignored.
+    state.addFreeLease(IOAddress("192.0.2.11"));
+    state.addFreeLease(IOAddress("192.0.2.0"));
+    EXPECT_EQ(1, state.getFreeLeaseCount());
+
+    // Add another free lease. The leases are offered in turns.
+    state.addFreeLease(IOAddress("192.0.2.3"));
+    EXPECT_EQ(2, state.getFreeLeaseCount());
+    EXPECT_EQ("192.0.2.3", state.offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.1", state.offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.3", state.offerFreeLease().toText());
+
+    // Deleting a lease which is not free doesn't change anything.
+    state.deleteFreeLease(IOAddress("192.0.2.2"));
+    EXPECT_EQ(2, state.getFreeLeaseCount());
+
+    // Delete one of the free leases.
+    state.deleteFreeLease(IOAddress("192.0.2.1"));
+    EXPECT_EQ(1, state.getFreeLeaseCount());
+    EXPECT_EQ("192.0.2.3", state.offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.3", state.offerFreeLease().toText());
+
+    // Delete the remaining lease. The pool is now exhausted.
+    state.deleteFreeLease(IOAddress("192.0.2.3"));
+    EXPECT_TRUE(state.exhausted());
+    EXPECT_TRUE(state.offerFreeLease().isV4Zero());
+}
+
+// Test that all addresses of a large pool can be marked free and that the
+// free addresses are found across the summary levels.
+TEST(PoolBitmapAllocationStateTest, largePool) {
+    // This pool has 2^20 + 3 addresses, requiring four levels.
+    PoolBitmapAllocationState state(IOAddress("10.0.0.0"), IOAddress("10.16.0.2"));
+    state.addAllFreeLeases();
+    EXPECT_EQ(1048579, state.getFreeLeaseCount());
+    EXPECT_EQ("10.0.0.0", state.offerFreeLease().toText());
+    EXPECT_EQ("10.0.0.1", state.offerFreeLease().toText());
+
+    // Mark in use all the addresses except the last one and one in the
+    // middle of the pool.
+    for (uint32_t address = IOAddress("10.0.0.0").toUint32();
+         address <= IOAddress("10.16.0.1").toUint32(); ++address) {
+        state.deleteFreeLease(IOAddress(address));
+    }
+    EXPECT_EQ(1, state.getFreeLeaseCount());
+    EXPECT_EQ("10.16.0.2", state.offerFreeLease().toText());
+    state.addFreeLease(IOAddress("10.8.1.2"));
+    EXPECT_EQ(2, state.getFreeLeaseCount());
+
+    // The search wraps around at the end of the pool.
+    EXPECT_EQ("10.8.1.2", state.offerFreeLease().toText());
+    EXPECT_EQ("10.16.0.2", state.offerFreeLease().toText());
+    EXPECT_EQ("10.8.1.2", state.offerFreeLease().toText());
+
+    state.deleteFreeLease(IOAddress("10.8.1.2"));
+    state.deleteFreeLease(IOAddress("10.16.0.2"));
+    EXPECT_TRUE(state.exhausted());
+    EXPECT_TRUE(state.offerFreeLease().isV4Zero());
+}
+
+} // end of anonymous namespace
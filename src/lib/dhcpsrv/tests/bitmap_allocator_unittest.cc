@@ -0,0 +1,357 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcp/hwaddr.h>
+#include <dhcpsrv/bitmap_allocator.h>
+#include <dhcpsrv/tests/alloc_engine_utils.h>
+#include <boost/make_shared.hpp>
+#include <gtest/gtest.h>
+
+using namespace isc::asiolink;
+using namespace std;
+
+namespace isc {
+namespace dhcp {
+namespace test {
+
+/// @brief Test fixture class for the DHCPv4 bitmap allocator.
+class BitmapAllocatorTest4 : public AllocEngine4Test {
+public:
+
+    /// @brief Creates a DHCPv4 lease for an address and MAC address.
+    ///
+    /// @param address Lease address.
+    /// @param hw_address_seed a seed from which the hardware address is generated.
+    /// @return Created lease pointer.
+    Lease4Ptr
+    createLease4(const IOAddress& address, uint64_t hw_address_seed) const {
+        vector<uint8_t> hw_address_vec(sizeof(hw_address_seed));
+        for (auto i = 0; i < sizeof(hw_address_seed); ++i) {
+            hw_address_vec[i] = (hw_address_seed >> i) & 0xFF;
+        }
+        auto hw_address = boost::make_shared<HWAddr>(hw_address_vec, HTYPE_ETHER);
+        auto lease = boost::make_shared<Lease4>(address, hw_address, ClientIdPtr(),
+                                                3600, time(0), subnet_->getID());
+        return (lease);
+    }
+};
+
+// Test that the allocator returns the correct type.
+TEST_F(BitmapAllocatorTest4, getType) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+    EXPECT_EQ("bitmap", alloc.getType());
+}
+
+// Test that the allocator can't be created for IPv6 leases.
+TEST_F(BitmapAllocatorTest4, unsupportedType) {
+    EXPECT_THROW(BitmapAllocator(Lease::TYPE_NA, subnet_), BadValue);
+    EXPECT_THROW(BitmapAllocator(Lease::TYPE_PD, subnet_), BadValue);
+}
+
+// Test populating free DHCPv4 leases to the bitmap.
+TEST_F(BitmapAllocatorTest4, populateFreeAddressLeases) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.100"), 0))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.102"), 1))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.104"), 2))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.106"), 3))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.108"), 4))));
+
+    EXPECT_NO_THROW(alloc.initAfterConfigure());
+
+    auto pool_state = boost::dynamic_pointer_cast<PoolBitmapAllocationState>(pool_->getAllocationState());
+    ASSERT_TRUE(pool_state);
+    EXPECT_FALSE(pool_state->exhausted());
+
+    std::set<IOAddress> addresses;
+    for (auto i = 0; i < 5; ++i) {
+        auto lease = pool_state->offerFreeLease();
+        ASSERT_FALSE(lease.isV4Zero());
+        addresses.insert(lease);
+    }
+    ASSERT_EQ(5, addresses.size());
+    EXPECT_EQ(1, addresses.count(IOAddress("192.0.2.101")));
+    EXPECT_EQ(1, addresses.count(IOAddress("192.0.2.103")));
+    EXPECT_EQ(1, addresses.count(IOAddress("192.0.2.105")));
+    EXPECT_EQ(1, addresses.count(IOAddress("192.0.2.107")));
+    EXPECT_EQ(1, addresses.count(IOAddress("192.0.2.109")));
+}
+
+// Test allocating IPv4 addresses when a subnet has a single pool.
+TEST_F(BitmapAllocatorTest4, singlePool) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    // Remember returned addresses, so we can verify that unique addresses
+    // are returned.
+    std::set<IOAddress> addresses;
+    for (auto i = 0; i < 1000; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        addresses.insert(candidate);
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate, cc_));
+    }
+    // The pool comprises 10 addresses. All should be returned.
+    EXPECT_EQ(10, addresses.size());
+}
+
+// Test allocating IPv4 addresses and re-allocating these that are
+// deleted (released).
+TEST_F(BitmapAllocatorTest4, singlePoolWithAllocations) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    // Remember returned addresses, so we can verify that unique addresses
+    // are returned.
+    std::map<IOAddress, Lease4Ptr> leases;
+    for (auto i = 0; i < 10; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        auto lease = createLease4(candidate, i);
+        leases[candidate] = lease;
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate, cc_));
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+    }
+    // The pool comprises 10 addresses. All should be returned.
+    EXPECT_EQ(10, leases.size());
+
+    IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+
+    auto i = 0;
+    for (auto address_lease : leases) {
+        if (i % 2) {
+            EXPECT_TRUE(lease_mgr.deleteLease(address_lease.second));
+        }
+        ++i;
+    }
+
+    for (auto i = 0; i < 5; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate, cc_));
+        auto lease = createLease4(candidate, i);
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+    }
+
+    candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+}
+
+// Test allocating IPv4 addresses and re-allocating these that are
+// reclaimed.
+TEST_F(BitmapAllocatorTest4, singlePoolWithReclamations) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    // Remember returned addresses, so we can verify that unique addresses
+    // are returned.
+    std::map<IOAddress, Lease4Ptr> leases;
+    for (auto i = 0; i < 10; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        auto lease = createLease4(candidate, i);
+        leases[candidate] = lease;
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate, cc_));
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+    }
+    // The pool comprises 10 addresses. All should be returned.
+    EXPECT_EQ(10, leases.size());
+
+    IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+
+    auto i = 0;
+    for (auto address_lease : leases) {
+        if (i % 2) {
+            auto lease = address_lease.second;
+            lease->state_ = Lease::STATE_EXPIRED_RECLAIMED;
+            EXPECT_NO_THROW(lease_mgr.updateLease4(lease));
+        }
+        ++i;
+    }
+    for (auto i = 0; i < 5; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate, cc_));
+        auto lease = lease_mgr.getLease4(candidate);
+        lease->state_ = Lease::STATE_DEFAULT;
+        EXPECT_NO_THROW(lease_mgr.updateLease4(lease));
+    }
+
+    candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+}
+
+// Test allocating DHCPv4 leases for many pools in a subnet.
+TEST_F(BitmapAllocatorTest4, manyPools) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    // Add several more pools.
+    for (int i = 1; i < 10; ++i) {
+        stringstream min, max;
+        min << "192.0.2." << i * 10;
+        max << "192.0.2." << i * 10 + 9;
+        auto pool = boost::make_shared<Pool4>(IOAddress(min.str()),
+                                              IOAddress(max.str()));
+        subnet_->addPool(pool);
+    }
+
+    // There are ten pools with 10 addresses each.
+    int total = 100;
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    std::set<IOAddress> addresses_set;
+
+    // Pick addresses the number of times equal to the
+    // subnet capacity to ensure that all addresses are returned.
+    for (auto i = 0; i < total; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        addresses_set.insert(candidate);
+        auto lease = createLease4(candidate, i);
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate, cc_));
+    }
+    // Make sure that unique addresses have been returned.
+    EXPECT_EQ(total, addresses_set.size());
+
+    // All addresses have been allocated.
+    IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+}
+
+// Test that the allocator returns a zero address when there are no pools
+// in a subnet.
+TEST_F(BitmapAllocatorTest4, noPools) {
+   BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+   subnet_->delPools(Lease::TYPE_V4);
+
+   IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+   EXPECT_TRUE(candidate.isV4Zero());
+}
+
+// Test that the allocator returns the number of free addresses in the
+// pools allowed for the client classes.
+TEST_F(BitmapAllocatorTest4, getFreeLeaseCount) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    // Second pool. It only allows client class bar.
+    auto pool1 = boost::make_shared<Pool4>(IOAddress("192.0.2.120"),
+                                           IOAddress("192.0.2.129"));
+    pool1->allowClientClass("bar");
+    subnet_->addPool(pool1);
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    EXPECT_EQ(10, alloc.getFreeLeaseCount(cc_));
+
+    cc_.insert("bar");
+    EXPECT_EQ(20, alloc.getFreeLeaseCount(cc_));
+
+    // Allocate all addresses from the first pool.
+    cc_.clear();
+    for (auto i = 0; i < 10; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        EXPECT_TRUE(lease_mgr.addLease(createLease4(candidate, i)));
+        EXPECT_EQ(9 - i, alloc.getFreeLeaseCount(cc_));
+    }
+
+    // The client belonging to the class bar can still get the addresses
+    // from the second pool.
+    cc_.insert("bar");
+    EXPECT_EQ(10, alloc.getFreeLeaseCount(cc_));
+
+    // Releasing a lease gives the address back.
+    cc_.clear();
+    EXPECT_TRUE(lease_mgr.deleteLease(lease_mgr.getLease4(IOAddress("192.0.2.100"))));
+    EXPECT_EQ(1, alloc.getFreeLeaseCount(cc_));
+}
+
+// Test that the allocator respects client class guards.
+TEST_F(BitmapAllocatorTest4, clientClasses) {
+   BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+   // First pool only allows the client class foo.
+   pool_->allowClientClass("foo");
+
+   // Second pool. It only allows client class bar.
+   auto pool1 = boost::make_shared<Pool4>(IOAddress("192.0.2.120"),
+                                         IOAddress("192.0.2.129"));
+   pool1->allowClientClass("bar");
+   subnet_->addPool(pool1);
+
+   // Third pool. It only allows client class foo.
+   auto pool2 = boost::make_shared<Pool4>(IOAddress("192.0.2.140"),
+                                          IOAddress("192.0.2.149"));
+   pool2->allowClientClass("foo");
+   subnet_->addPool(pool2);
+
+   // Forth pool. It only allows client class bar.
+   auto pool3 = boost::make_shared<Pool4>(IOAddress("192.0.2.160"),
+                                          IOAddress("192.0.2.169"));
+   pool3->allowClientClass("bar");
+   subnet_->addPool(pool3);
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+   // Remember offered addresses.
+   std::set<IOAddress> addresses_set;
+
+   // Simulate client's request belonging to the class bar.
+   cc_.insert("bar");
+   for (auto i = 0; i < 20; ++i) {
+       // Allocate addresses and make sure they belong to the
+       // pools associated with the class bar.
+       IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+       EXPECT_FALSE(candidate.isV4Zero());
+       EXPECT_TRUE(lease_mgr.addLease(createLease4(candidate, i+50)));
+       addresses_set.insert(candidate);
+       EXPECT_TRUE(pool1->inRange(candidate) || pool3->inRange(candidate));
+   }
+   EXPECT_EQ(20, addresses_set.size());
+
+   addresses_set.clear();
+
+   // Simulate the case that the client also belongs to the class foo.
+   // All pools should now be available.
+   cc_.insert("foo");
+   for (auto i = 0; i < 20; ++i) {
+       IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+       addresses_set.insert(candidate);
+       EXPECT_TRUE(lease_mgr.addLease(createLease4(candidate, i+100)));
+       EXPECT_TRUE(subnet_->inRange(candidate));
+   }
+   EXPECT_EQ(20, addresses_set.size());
+
+   // When the client does not belong to any client class the allocator
+   // can't offer any address to the client.
+   cc_.clear();
+   IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+   EXPECT_TRUE(candidate.isV4Zero());
+}
+
+} // end of isc::dhcp::test namespace
+} // end of isc::dhcp namespace
+} // end of isc namespace
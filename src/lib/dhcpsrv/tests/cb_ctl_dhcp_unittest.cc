@@ -23,6 +23,7 @@
 #include <hooks/callout_manager.h>
 #include <hooks/hooks_manager.h>
 #include <testutils/gtest_utils.h>
+#include <util/multi_threading_mgr.h>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/make_shared.hpp>
 #include <gtest/gtest.h>
@@ -37,6 +38,7 @@ using namespace isc::dhcp;
 using namespace isc::dhcp::test;
 using namespace isc::process;
 using namespace isc::hooks;
+using namespace isc::util;
 
 namespace {
 
@@ -71,6 +73,7 @@ public:
         initTimestamps();
         callback_name_ = std::string("");
         callback_audit_entries_.reset();
+        callback_in_cs_ = false;
         HostMgr::create();
     }
 
@@ -214,6 +217,7 @@ public:
     cb4_updated_callout(CalloutHandle& callout_handle) {
         callback_name_ = std::string("cb4_updated");
         callout_handle.getArgument("audit_entries", callback_audit_entries_);
+        callback_in_cs_ = MultiThreadingMgr::instance().isInCriticalSection();
         return (0);
     }
 
@@ -224,6 +228,7 @@ public:
     cb6_updated_callout(CalloutHandle& callout_handle) {
         callback_name_ = std::string("cb6_updated");
         callout_handle.getArgument("audit_entries", callback_audit_entries_);
+        callback_in_cs_ = MultiThreadingMgr::instance().isInCriticalSection();
         return (0);
     }
 
@@ -244,10 +249,14 @@ public:
 
     /// @brief Callback value.
     static AuditEntryCollectionPtr callback_audit_entries_;
+
+    /// @brief Flag set when the callback is called in a critical section.
+    static bool callback_in_cs_;
 };
 
 std::string CBControlDHCPTest::callback_name_;
 AuditEntryCollectionPtr CBControlDHCPTest::callback_audit_entries_;
+bool CBControlDHCPTest::callback_in_cs_;
 
 // ************************ V4 tests *********************
 
@@ -975,6 +984,42 @@ TEST_F(CBControlDHCPv4Test, databaseConfigApplySubnetNotFetched) {
     testDatabaseConfigApply(getTimestamp(-3));
 }
 
+// This test verifies that a subnet fetched again without changes is not
+// merged again into the current configuration.
+TEST_F(CBControlDHCPv4Test, databaseConfigApplySubnetUnchanged) {
+    remoteStoreTestConfiguration();
+    addCreateAuditEntry("dhcp4_shared_network", 1);
+    addCreateAuditEntry("dhcp4_shared_network", 2);
+    addCreateAuditEntry("dhcp4_subnet", 1);
+    addCreateAuditEntry("dhcp4_subnet", 2);
+    ASSERT_NO_THROW_LOG(ctl_.databaseConfigApply(BackendSelector::UNSPEC(), ServerSelector::ALL(),
+                                                 getTimestamp(-5), audit_entries_));
+
+    auto subnets = CfgMgr::instance().getCurrentCfg()->getCfgSubnets4();
+    auto subnet = subnets->getBySubnetId(SubnetID(2));
+    ASSERT_TRUE(subnet);
+
+    // The same subnet is fetched again: the current subnet is kept.
+    ASSERT_NO_THROW_LOG(ctl_.databaseConfigApply(BackendSelector::UNSPEC(), ServerSelector::ALL(),
+                                                 getTimestamp(-5), audit_entries_));
+    subnets = CfgMgr::instance().getCurrentCfg()->getCfgSubnets4();
+    EXPECT_TRUE(subnet == subnets->getBySubnetId(SubnetID(2)));
+
+    // The subnet is modified: the current subnet is replaced.
+    Subnet4Ptr modified(new Subnet4(IOAddress("192.0.4.0"), 26, 1, 2, 4, SubnetID(2)));
+    modified->setModificationTime(getTimestamp(-3));
+    auto& mgr = ConfigBackendDHCPv4Mgr::instance();
+    mgr.getPool()->createUpdateSubnet4(BackendSelector::UNSPEC(), ServerSelector::ALL(),
+                                       modified);
+    ASSERT_NO_THROW_LOG(ctl_.databaseConfigApply(BackendSelector::UNSPEC(), ServerSelector::ALL(),
+                                                 getTimestamp(-5), audit_entries_));
+    subnets = CfgMgr::instance().getCurrentCfg()->getCfgSubnets4();
+    auto current = subnets->getBySubnetId(SubnetID(2));
+    ASSERT_TRUE(current);
+    EXPECT_FALSE(subnet == current);
+    EXPECT_EQ(4, current->getValid().get());
+}
+
 // This test verifies that only client classes are merged into the current
 // configuration.
 TEST_F(CBControlDHCPv4Test, databaseConfigApplyClientClasses) {
@@ -1020,6 +1065,11 @@ TEST_F(CBControlDHCPv4Test, databaseConfigApplyHook) {
     EXPECT_EQ("cb4_updated", callback_name_);
     ASSERT_TRUE(callback_audit_entries_);
     EXPECT_TRUE(audit_entries_ == *callback_audit_entries_);
+
+    // The updates are applied in a critical section which ends with the
+    // apply.
+    EXPECT_TRUE(callback_in_cs_);
+    EXPECT_FALSE(MultiThreadingMgr::instance().isInCriticalSection());
 }
 
 // This test verifies that it is possible to set ip-reservations-unique
@@ -1911,6 +1961,11 @@ TEST_F(CBControlDHCPv6Test, databaseConfigApplyHook) {
     EXPECT_EQ("cb6_updated", callback_name_);
     ASSERT_TRUE(callback_audit_entries_);
     EXPECT_TRUE(audit_entries_ == *callback_audit_entries_);
+
+    // The updates are applied in a critical section which ends with the
+    // apply.
+    EXPECT_TRUE(callback_in_cs_);
+    EXPECT_FALSE(MultiThreadingMgr::instance().isInCriticalSection());
 }
 
 // This test verifies that it is possible to set ip-reservations-unique
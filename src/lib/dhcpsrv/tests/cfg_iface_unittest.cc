@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,8 +15,11 @@
 #include <asiolink/interval_timer.h>
 #include <dhcpsrv/timer_mgr.h>
 #include <testutils/test_to_element.h>
+#include <util/fd_event_handler_factory.h>
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+
 using namespace isc;
 using namespace isc::dhcp;
 using namespace isc::dhcp::test;
@@ -354,6 +357,38 @@ TEST_F(CfgIfaceTest, wildcardV4) {
     EXPECT_FALSE(socketOpen("lo", AF_INET6));
 }
 
+// This test checks that the event handler type is applied when the
+// sockets are opened and that the environment variable overrides it.
+TEST_F(CfgIfaceTest, eventHandlerType) {
+    unsetenv("KEA_EVENT_HANDLER_TYPE");
+    CfgIface cfg;
+    ASSERT_NO_THROW(cfg.use(AF_INET, "*"));
+    cfg.setEventHandlerType(FDEventHandler::TYPE_EPOLL);
+
+    // The epoll handler is not available on all systems.
+    FDEventHandler::HandlerType epoll_type =
+        FDEventHandlerFactory::factoryFDEventHandler(FDEventHandler::TYPE_EPOLL)->type();
+    ASSERT_NO_THROW(cfg.openSockets(AF_INET, DHCP4_SERVER_PORT));
+    EXPECT_EQ(epoll_type, IfaceMgr::instance().getEventHandlerType());
+    EXPECT_TRUE(socketOpen("eth0", AF_INET));
+
+    // The environment variable overrides the configured type.
+    setenv("KEA_EVENT_HANDLER_TYPE", "select", 1);
+    ASSERT_NO_THROW(cfg.openSockets(AF_INET, DHCP4_SERVER_PORT));
+    EXPECT_EQ(FDEventHandler::TYPE_SELECT,
+              IfaceMgr::instance().getEventHandlerType());
+    unsetenv("KEA_EVENT_HANDLER_TYPE");
+    ASSERT_NO_THROW(cfg.openSockets(AF_INET, DHCP4_SERVER_PORT));
+    EXPECT_EQ(epoll_type, IfaceMgr::instance().getEventHandlerType());
+
+    // The select handler is used when no type is configured.
+    CfgIface cfg_default;
+    ASSERT_NO_THROW(cfg_default.use(AF_INET, "*"));
+    ASSERT_NO_THROW(cfg_default.openSockets(AF_INET, DHCP4_SERVER_PORT));
+    EXPECT_EQ(FDEventHandler::TYPE_SELECT,
+              IfaceMgr::instance().getEventHandlerType());
+}
+
 // This test checks that the wildcard interface name can be specified to
 // select all interfaces to open IPv6 sockets.
 TEST_F(CfgIfaceTest, wildcardV6) {
@@ -522,6 +557,15 @@ TEST_F(CfgIfaceTest, equality) {
     cfg2.useSocketType(AF_INET, "udp");
     EXPECT_TRUE(cfg1 == cfg2);
     EXPECT_FALSE(cfg1 != cfg2);
+
+    // Differ by event handler type.
+    cfg1.setEventHandlerType(FDEventHandler::TYPE_EPOLL);
+    EXPECT_FALSE(cfg1 == cfg2);
+    EXPECT_TRUE(cfg1 != cfg2);
+
+    cfg2.setEventHandlerType(FDEventHandler::TYPE_EPOLL);
+    EXPECT_TRUE(cfg1 == cfg2);
+    EXPECT_FALSE(cfg1 != cfg2);
 }
 
 // This test verifies that it is possible to unparse the interface config.
@@ -112,6 +112,37 @@ TEST_F(CfgMultiThreadingTest, apply) {
     EXPECT_EQ(MultiThreadingMgr::instance().getThreadPoolSize(), 4);
     EXPECT_EQ(MultiThreadingMgr::instance().getPacketQueueSize(), 64);
     EXPECT_EQ(MultiThreadingMgr::instance().getThreadPool().getMaxQueueSize(), 64);
+    EXPECT_TRUE(MultiThreadingMgr::instance().getCpuAffinity().empty());
+}
+
+/// @brief Verifies that extracting CPU affinity settings works
+TEST_F(CfgMultiThreadingTest, extractCpuAffinity) {
+    std::string content_json =
+        "{"
+        "    \"enable-multi-threading\": true,\n"
+        "    \"cpu-affinity\": \"0-3,8\",\n"
+        "    \"receiver-cpu-affinity\": \"4\"\n"
+        "}";
+    ConstElementPtr param;
+    ASSERT_NO_THROW(param = Element::fromJSON(content_json))
+                            << "invalid context_json, test is broken";
+    EXPECT_EQ(CfgMultiThreading::extractCpuAffinity(param, "cpu-affinity"),
+              CpuList({ 0, 1, 2, 3, 8 }));
+    EXPECT_EQ(CfgMultiThreading::extractCpuAffinity(param, "receiver-cpu-affinity"),
+              CpuList({ 4 }));
+
+    // the thread pool affinity is applied
+    CfgMultiThreading::apply(param);
+    EXPECT_EQ(MultiThreadingMgr::instance().getCpuAffinity(),
+              CpuList({ 0, 1, 2, 3, 8 }));
+
+    // check missing parameters
+    EXPECT_TRUE(CfgMultiThreading::extractCpuAffinity(Element::createMap(),
+                                                      "cpu-affinity").empty());
+    EXPECT_TRUE(CfgMultiThreading::extractCpuAffinity(ConstElementPtr(),
+                                                      "cpu-affinity").empty());
+    CfgMultiThreading::apply(Element::createMap());
+    EXPECT_TRUE(MultiThreadingMgr::instance().getCpuAffinity().empty());
 }
 
 }  // namespace
@@ -32,6 +32,7 @@
 #include <util/doubles.h>
 
 #include <gtest/gtest.h>
+#include <sstream>
 #include <vector>
 
 using namespace isc;
@@ -455,6 +456,38 @@ TEST(CfgSubnets4Test, selectSubnetByCiaddr) {
     EXPECT_FALSE(cfg.selectSubnet(selector));
 }
 
+// This test verifies that the selection by address returns the subnet
+// with the lowest identifier among the subnets the address belongs to,
+// and that the selection follows the subnet removals and replacements.
+TEST(CfgSubnets4Test, selectSubnetByAddressOverlapping) {
+    CfgSubnets4 cfg;
+
+    Subnet4Ptr subnet1(new Subnet4(IOAddress("10.0.0.0"), 8, 1, 2, 3, 20));
+    Subnet4Ptr subnet2(new Subnet4(IOAddress("10.1.0.0"), 16, 1, 2, 3, 10));
+    Subnet4Ptr subnet3(new Subnet4(IOAddress("10.1.2.0"), 24, 1, 2, 3, 30));
+    cfg.add(subnet1);
+    cfg.add(subnet2);
+    cfg.add(subnet3);
+
+    ClientClasses classes;
+    EXPECT_EQ(subnet2, cfg.selectSubnet(IOAddress("10.1.2.3"), classes));
+    EXPECT_EQ(subnet1, cfg.selectSubnet(IOAddress("10.2.0.1"), classes));
+    EXPECT_FALSE(cfg.selectSubnet(IOAddress("11.0.0.1"), classes));
+
+    // The subnets rejecting the client are skipped.
+    subnet2->allowClientClass("foo");
+    EXPECT_EQ(subnet1, cfg.selectSubnet(IOAddress("10.1.2.3"), classes));
+
+    cfg.del(subnet1);
+    EXPECT_EQ(subnet3, cfg.selectSubnet(IOAddress("10.1.2.3"), classes));
+
+    // Replace the subnet with a subnet having another prefix.
+    Subnet4Ptr subnet4(new Subnet4(IOAddress("192.0.2.0"), 24, 1, 2, 3, 30));
+    ASSERT_EQ(subnet3, cfg.replace(subnet4));
+    EXPECT_FALSE(cfg.selectSubnet(IOAddress("10.1.2.3"), classes));
+    EXPECT_EQ(subnet4, cfg.selectSubnet(IOAddress("192.0.2.1"), classes));
+}
+
 // This test verifies that it is possible to select a subnet by
 // matching an interface name.
 TEST(CfgSubnets4Test, selectSubnetByIface) {
@@ -2242,6 +2275,40 @@ TEST(CfgSubnets4Test, initAllocatorsAfterConfigure) {
     EXPECT_EQ(1, allocator2->callcount_);
 }
 
+// This test verifies that the unchanged subnets reuse the allocation
+// states of the previous configuration.
+TEST(CfgSubnets4Test, initAllocatorsAfterConfigureReuse) {
+    auto create = [](SubnetID id, uint32_t valid) {
+        std::ostringstream prefix;
+        prefix << "192.0." << id << ".0";
+        Subnet4Ptr subnet(new Subnet4(IOAddress(prefix.str()), 24, 1, 2,
+                                      valid, id));
+        subnet->addPool(boost::make_shared<Pool4>(IOAddress(prefix.str()), 24));
+        subnet->createAllocators();
+        return (subnet);
+    };
+    CfgSubnets4Ptr previous(new CfgSubnets4());
+    previous->add(create(SubnetID(1), 3));
+    previous->add(create(SubnetID(2), 3));
+    previous->initAllocatorsAfterConfigure();
+
+    // Subnet 1 is unchanged, subnet 2 changed and subnet 3 is new.
+    CfgSubnets4 cfg;
+    cfg.add(create(SubnetID(1), 3));
+    cfg.add(create(SubnetID(2), 4));
+    cfg.add(create(SubnetID(3), 3));
+    EXPECT_EQ(1, cfg.initAllocatorsAfterConfigure(previous));
+    EXPECT_EQ(previous->getBySubnetId(1)->getAllocationState(Lease::TYPE_V4),
+              cfg.getBySubnetId(1)->getAllocationState(Lease::TYPE_V4));
+    EXPECT_NE(previous->getBySubnetId(2)->getAllocationState(Lease::TYPE_V4),
+              cfg.getBySubnetId(2)->getAllocationState(Lease::TYPE_V4));
+
+    // Without a previous configuration nothing is reused.
+    CfgSubnets4 cfg2;
+    cfg2.add(create(SubnetID(1), 3));
+    EXPECT_EQ(0, cfg2.initAllocatorsAfterConfigure(ConstCfgSubnets4Ptr()));
+}
+
 /// @brief Test fixture for parsing v4 Subnets that can verify log output.
 class Subnet4ParserTest : public LogContentTest {
 public:
@@ -405,6 +405,44 @@ TEST(CfgSubnets6Test, selectSubnetByInterfaceName) {
     EXPECT_FALSE(cfg.selectSubnet(selector));
 }
 
+// This test checks that the selection by interface name follows the
+// changes of the subnets.
+TEST(CfgSubnets6Test, selectSubnetByInterfaceNameUpdated) {
+    CfgSubnets6 cfg;
+
+    Subnet6Ptr subnet1(new Subnet6(IOAddress("2000::"), 48, 1, 2, 3, 4, 1));
+    Subnet6Ptr subnet2(new Subnet6(IOAddress("3000::"), 48, 1, 2, 3, 4, 2));
+    subnet1->setIface("foo");
+    subnet2->setIface("foo");
+    cfg.add(subnet2);
+    cfg.add(subnet1);
+
+    // The subnet with the lowest identifier is returned first.
+    SubnetSelector selector;
+    selector.iface_name_ = "foo";
+    EXPECT_EQ(subnet1, cfg.selectSubnet(selector));
+
+    cfg.del(subnet1);
+    EXPECT_EQ(subnet2, cfg.selectSubnet(selector));
+
+    // A replaced subnet is selected by its new interface.
+    Subnet6Ptr subnet3(new Subnet6(IOAddress("3000::"), 48, 1, 2, 3, 4, 2));
+    subnet3->setIface("bar");
+    ASSERT_EQ(subnet2, cfg.replace(subnet3));
+    EXPECT_FALSE(cfg.selectSubnet(selector));
+    selector.iface_name_ = "bar";
+    EXPECT_EQ(subnet3, cfg.selectSubnet(selector));
+
+    // The interface may be inherited from the shared network.
+    SharedNetwork6Ptr network(new SharedNetwork6("frog"));
+    network->setIface("baz");
+    Subnet6Ptr subnet4(new Subnet6(IOAddress("4000::"), 48, 1, 2, 3, 4, 4));
+    network->add(subnet4);
+    cfg.add(subnet4);
+    selector.iface_name_ = "baz";
+    EXPECT_EQ(subnet4, cfg.selectSubnet(selector));
+}
+
 // This test checks that the subnet can be selected using an Interface ID
 // option inserted by a relay.
 TEST(CfgSubnets6Test, selectSubnetByInterfaceId) {
@@ -568,6 +568,31 @@ TEST_F(CfgMgrTest, revert) {
     EXPECT_EQ(12, cfg_mgr.getCurrentCfg()->getLoggingInfo()[0].debuglevel_);
 }
 
+// This test verifies that the version of the current configuration changes
+// when the current configuration changes.
+TEST_F(CfgMgrTest, currentCfgVersion) {
+    CfgMgr& cfg_mgr = CfgMgr::instance();
+    uint64_t version = cfg_mgr.getCurrentCfgVersion();
+
+    // Getting the configurations does not change it.
+    ASSERT_TRUE(cfg_mgr.getCurrentCfg());
+    ASSERT_TRUE(cfg_mgr.getStagingCfg());
+    EXPECT_EQ(version, cfg_mgr.getCurrentCfgVersion());
+
+    cfg_mgr.commit();
+    EXPECT_NE(version, cfg_mgr.getCurrentCfgVersion());
+    version = cfg_mgr.getCurrentCfgVersion();
+
+    // Merging an external configuration changes it.
+    SrvConfigPtr external_cfg = cfg_mgr.createExternalCfg();
+    ASSERT_NO_THROW(cfg_mgr.mergeIntoCurrentCfg(external_cfg->getSequence()));
+    EXPECT_NE(version, cfg_mgr.getCurrentCfgVersion());
+    version = cfg_mgr.getCurrentCfgVersion();
+
+    cfg_mgr.clear();
+    EXPECT_NE(version, cfg_mgr.getCurrentCfgVersion());
+}
+
 // This test verifies that the address family can be set and obtained
 // from the configuration manager.
 TEST_F(CfgMgrTest, family) {
@@ -693,6 +718,74 @@ TEST_F(CfgMgrTest, mergeIntoCurrentStats4) {
     EXPECT_EQ(128, total_addrs->getInteger().first);
 }
 
+// This test verifies that the lease statistics of the unchanged subnets are
+// kept and only the new subnets are recounted when the lease database does
+// not change.
+TEST_F(CfgMgrTest, commitRecountChangedStats4) {
+    CfgMgr& cfg_mgr = CfgMgr::instance();
+    StatsMgr& stats_mgr = StatsMgr::instance();
+    startBackend(AF_INET);
+
+    // Add a lease in the subnet 42.
+    HWAddrPtr hwaddr(new HWAddr(std::vector<uint8_t>(6, 1), HTYPE_ETHER));
+    Lease4Ptr lease(new Lease4(IOAddress("192.1.3.1"), hwaddr, ClientIdPtr(),
+                               3600, time(0), 42));
+    ASSERT_TRUE(LeaseMgrFactory::instance().addLease(lease));
+
+    // Let's prepare the "old" configuration: a subnet with id 123
+    // and pretend there were addresses assigned, so statistics are non-zero.
+    Subnet4Ptr subnet1(new Subnet4(IOAddress("192.1.2.0"), 24, 1, 2, 3, 123));
+    cfg_mgr.getStagingCfg()->getCfgSubnets4()->add(subnet1);
+    cfg_mgr.commit();
+    stats_mgr.setValue("subnet[123].assigned-addresses", static_cast<int64_t>(150));
+
+    // The new configuration keeps the subnet 123 and adds the subnet 42.
+    subnet1.reset(new Subnet4(IOAddress("192.1.2.0"), 24, 1, 2, 3, 123));
+    Subnet4Ptr subnet2(new Subnet4(IOAddress("192.1.3.0"), 24, 1, 2, 3, 42));
+    CfgSubnets4Ptr subnets = cfg_mgr.getStagingCfg()->getCfgSubnets4();
+    subnets->add(subnet1);
+    subnets->add(subnet2);
+    cfg_mgr.commit();
+
+    // The subnet 123 was not recounted.
+    ObservationPtr assigned = stats_mgr.getObservation("subnet[123].assigned-addresses");
+    ASSERT_TRUE(assigned);
+    EXPECT_EQ(150, assigned->getInteger().first);
+
+    // The subnet 42 was counted.
+    assigned = stats_mgr.getObservation("subnet[42].assigned-addresses");
+    ASSERT_TRUE(assigned);
+    EXPECT_EQ(1, assigned->getInteger().first);
+
+    // A change of the prefix makes the subnet 123 recounted.
+    subnet1.reset(new Subnet4(IOAddress("192.1.4.0"), 24, 1, 2, 3, 123));
+    subnet2.reset(new Subnet4(IOAddress("192.1.3.0"), 24, 1, 2, 3, 42));
+    subnets = cfg_mgr.getStagingCfg()->getCfgSubnets4();
+    subnets->add(subnet1);
+    subnets->add(subnet2);
+    cfg_mgr.commit();
+
+    assigned = stats_mgr.getObservation("subnet[123].assigned-addresses");
+    ASSERT_TRUE(assigned);
+    EXPECT_EQ(0, assigned->getInteger().first);
+    stats_mgr.setValue("subnet[123].assigned-addresses", static_cast<int64_t>(150));
+
+    // A non persistent memfile database loses the leases when it is
+    // recreated so all the subnets are recounted.
+    subnet1.reset(new Subnet4(IOAddress("192.1.4.0"), 24, 1, 2, 3, 123));
+    subnet2.reset(new Subnet4(IOAddress("192.1.3.0"), 24, 1, 2, 3, 42));
+    subnets = cfg_mgr.getStagingCfg()->getCfgSubnets4();
+    subnets->add(subnet1);
+    subnets->add(subnet2);
+    cfg_mgr.getStagingCfg()->getCfgDbAccess()->
+        setLeaseDbAccessString("type=memfile persist=false");
+    cfg_mgr.commit();
+
+    assigned = stats_mgr.getObservation("subnet[123].assigned-addresses");
+    ASSERT_TRUE(assigned);
+    EXPECT_EQ(0, assigned->getInteger().first);
+}
+
 // This test verifies that once the configuration is cleared, the statistics
 // are removed.
 TEST_F(CfgMgrTest, clearStats4) {
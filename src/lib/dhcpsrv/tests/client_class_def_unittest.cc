@@ -8,7 +8,9 @@
 #include <cc/data.h>
 #include <dhcpsrv/client_class_def.h>
 #include <dhcpsrv/cfgmgr.h>
+#include <dhcp/dhcp4.h>
 #include <dhcp/libdhcp++.h>
+#include <dhcp/pkt4.h>
 #include <dhcp/option_space.h>
 #include <testutils/test_to_element.h>
 #include <exceptions/exceptions.h>
@@ -581,6 +583,51 @@ TEST(ClientClassDictionary, initMatchExpr) {
     EXPECT_EQ(6, classes[2]->getMatchExpr()->size());
 }
 
+// Tests that the classes are split between the classification passes.
+TEST(ClientClassDictionary, evaluatedClasses) {
+    ClientClassDictionaryPtr dictionary(new ClientClassDictionary());
+    ExpressionPtr expr;
+    CfgOptionPtr cfg_option;
+
+    ASSERT_NO_THROW(dictionary->addClass("none", expr, "", false,
+                                         false, cfg_option));
+    ASSERT_NO_THROW(dictionary->addClass("pre", expr, "option[61].exists", false,
+                                         false, cfg_option));
+    ASSERT_NO_THROW(dictionary->addClass("post", expr, "member('KNOWN')", false,
+                                         true, cfg_option));
+    ASSERT_NO_THROW(dictionary->addClass("required", expr, "option[61].exists", true,
+                                         false, cfg_option));
+    ASSERT_NO_THROW(dictionary->addClass("pre2", expr, "option[60].exists", false,
+                                         false, cfg_option));
+
+    // No expression is parsed yet.
+    EXPECT_TRUE(dictionary->getEvaluatedClasses(false).empty());
+    EXPECT_TRUE(dictionary->getEvaluatedClasses(true).empty());
+
+    ASSERT_NO_THROW(dictionary->initMatchExpr(AF_INET));
+    auto pre = dictionary->getEvaluatedClasses(false);
+    ASSERT_EQ(2, pre.size());
+    EXPECT_EQ("pre", pre[0]->getName());
+    EXPECT_EQ("pre2", pre[1]->getName());
+    auto post = dictionary->getEvaluatedClasses(true);
+    ASSERT_EQ(1, post.size());
+    EXPECT_EQ("post", post[0]->getName());
+
+    // The lists follow the changes of the dictionary.
+    dictionary->removeClass("pre");
+    pre = dictionary->getEvaluatedClasses(false);
+    ASSERT_EQ(1, pre.size());
+    EXPECT_EQ("pre2", pre[0]->getName());
+
+    ClientClassDictionary copy(*dictionary);
+    EXPECT_EQ(1, copy.getEvaluatedClasses(false).size());
+    EXPECT_EQ(1, copy.getEvaluatedClasses(true).size());
+    ClientClassDictionary assigned;
+    assigned = *dictionary;
+    EXPECT_EQ(1, assigned.getEvaluatedClasses(false).size());
+    EXPECT_EQ(1, assigned.getEvaluatedClasses(true).size());
+}
+
 // Tests that an error is returned when any of the test expressions is
 // invalid, and that no expressions are initialized if there is an error
 // for a single expression.
@@ -607,6 +654,64 @@ TEST(ClientClassDictionary, initMatchExprError) {
     }
 }
 
+// Tests that the match expressions share their option tokens.
+TEST(ClientClassDictionary, initMatchExprShareTokens) {
+    ClientClassDictionaryPtr dictionary(new ClientClassDictionary());
+    ExpressionPtr expr;
+    CfgOptionPtr cfg_option;
+
+    ASSERT_NO_THROW(dictionary->addClass("foo", expr, "substring(option[61].hex,0,3) == 'foo'",
+                                         false, false, cfg_option));
+    ASSERT_NO_THROW(dictionary->addClass("bar", expr, "substring(option[61].hex,0,3) == 'bar'",
+                                         false, false, cfg_option));
+    ASSERT_NO_THROW(dictionary->initMatchExpr(AF_INET));
+
+    auto classes = *(dictionary->getClasses());
+    ASSERT_TRUE(classes[0]->getMatchExpr());
+    ASSERT_TRUE(classes[1]->getMatchExpr());
+    EXPECT_EQ(classes[0]->getMatchExpr()->front(),
+              classes[1]->getMatchExpr()->front());
+
+    // The option is evaluated once for both classes.
+    Pkt4Ptr pkt(new Pkt4(DHCPDISCOVER, 1234));
+    pkt->addOption(OptionPtr(new Option(Option::V4, 61,
+                                        OptionBuffer({ 0x66, 0x6f, 0x6f }))));
+    EvalCache cache;
+    classes[0]->test(pkt, classes[0]->getMatchExpr(), &cache);
+    classes[1]->test(pkt, classes[1]->getMatchExpr(), &cache);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_TRUE(pkt->inClass("foo"));
+    EXPECT_FALSE(pkt->inClass("bar"));
+}
+
+// Tests that the match expression is not evaluated when the packet is not
+// a member of a class it needs.
+TEST(ClientClassDef, memberPrerequisites) {
+    ClientClassDictionaryPtr dictionary(new ClientClassDictionary());
+    ExpressionPtr expr;
+    CfgOptionPtr cfg_option;
+
+    ASSERT_NO_THROW(dictionary->addClass("foo", expr, "member('bar') and option[61].exists",
+                                         false, false, cfg_option));
+    ASSERT_NO_THROW(dictionary->initMatchExpr(AF_INET));
+    ClientClassDefPtr cclass = dictionary->findClass("foo");
+    ASSERT_TRUE(cclass);
+
+    Pkt4Ptr pkt(new Pkt4(DHCPDISCOVER, 1234));
+    pkt->addOption(OptionPtr(new Option(Option::V4, 61)));
+
+    // The option token is not evaluated without the bar class.
+    EvalCache cache;
+    cclass->test(pkt, cclass->getMatchExpr(), &cache);
+    EXPECT_TRUE(cache.empty());
+    EXPECT_FALSE(pkt->inClass("foo"));
+
+    pkt->addClass("bar");
+    cclass->test(pkt, cclass->getMatchExpr(), &cache);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_TRUE(pkt->inClass("foo"));
+}
+
 // Tests the default constructor regarding fixed fields
 TEST(ClientClassDef, fixedFieldsDefaults) {
     boost::scoped_ptr<ClientClassDef> cclass;
@@ -1414,8 +1519,9 @@ TEST(ClientClassDictionary, templateInitMatchExpr) {
     EXPECT_TRUE(classes[1]->getMatchExpr());
     EXPECT_EQ(1, classes[1]->getMatchExpr()->size());
 
+    // The constant concatenation is folded into a string.
     EXPECT_TRUE(classes[2]->getMatchExpr());
-    EXPECT_EQ(3, classes[2]->getMatchExpr()->size());
+    EXPECT_EQ(1, classes[2]->getMatchExpr()->size());
 }
 
 // Tests that an error is returned when any of the test expressions is
@@ -0,0 +1,244 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/option_space.h>
+#include <dhcp/option_string.h>
+#include <dhcpsrv/compact_host_store.h>
+#include <exceptions/exceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture for exercising CompactHostStore.
+class CompactHostStoreTest : public ::testing::Test {
+public:
+
+    /// @brief Creates an IPv4 host reservation using a HW address.
+    ///
+    /// @param index used to build the HW address, the address and the
+    /// hostname of the host.
+    /// @param subnet_id IPv4 subnet identifier.
+    HostPtr createHost4(uint32_t index, SubnetID subnet_id = SubnetID(1)) {
+        ostringstream hwaddr;
+        hwaddr << "01:02:03:" << hex << ((index >> 16) & 0xff) << ":"
+               << ((index >> 8) & 0xff) << ":" << (index & 0xff);
+        ostringstream hostname;
+        hostname << "host-" << index << ".example.org";
+        return (HostPtr(new Host(hwaddr.str(), "hw-address", subnet_id,
+                                 SUBNET_ID_UNUSED,
+                                 IOAddress(0x0a000000 + index),
+                                 hostname.str())));
+    }
+
+    /// @brief Looks for an IPv4 host by the identifier of another host.
+    ///
+    /// @param host the host.
+    ConstHostPtr get4(const ConstHostPtr& host) {
+        return (store_.get4(host->getIPv4SubnetID(), host->getIdentifierType(),
+                            &host->getIdentifier()[0],
+                            host->getIdentifier().size()));
+    }
+
+    /// @brief The store under test.
+    CompactHostStore store_;
+};
+
+// Verifies that the hosts are added and found by identifier and address.
+TEST_F(CompactHostStoreTest, add4) {
+    EXPECT_EQ("compact", store_.getType());
+    EXPECT_THROW(store_.add(HostPtr()), BadValue);
+
+    HostPtr host1 = createHost4(1);
+    HostPtr host2 = createHost4(2);
+    host2->addClientClass4("foo");
+    host2->setNextServer(IOAddress("192.0.2.1"));
+    host2->setBootFileName("boot.efi");
+    ASSERT_NO_THROW(store_.add(host1));
+    ASSERT_NO_THROW(store_.add(host2));
+    EXPECT_EQ(2, store_.size());
+    EXPECT_EQ(2, store_.getProfileCount());
+    EXPECT_EQ(1, host1->getHostId());
+    EXPECT_EQ(2, host2->getHostId());
+
+    ConstHostPtr got = get4(host1);
+    ASSERT_TRUE(got);
+    EXPECT_EQ(host1->toText(), got->toText());
+    got = get4(host2);
+    ASSERT_TRUE(got);
+    EXPECT_EQ(host2->toText(), got->toText());
+    EXPECT_TRUE(got->getClientClasses4().contains("foo"));
+    EXPECT_EQ("boot.efi", got->getBootFileName());
+
+    // Not in another subnet.
+    EXPECT_FALSE(store_.get4(SubnetID(2), host1->getIdentifierType(),
+                             &host1->getIdentifier()[0],
+                             host1->getIdentifier().size()));
+    EXPECT_EQ(1, store_.getAll(host1->getIdentifierType(),
+                               &host1->getIdentifier()[0],
+                               host1->getIdentifier().size()).size());
+
+    // By address.
+    got = store_.get4(SubnetID(1), host2->getIPv4Reservation());
+    ASSERT_TRUE(got);
+    EXPECT_EQ(2, got->getHostId());
+    EXPECT_EQ(1, store_.getAll4(host1->getIPv4Reservation()).size());
+    EXPECT_FALSE(store_.get4(SubnetID(2), host2->getIPv4Reservation()));
+    EXPECT_THROW(store_.getAll4(IOAddress("2001:db8::1")), BadHostAddress);
+
+    // By subnet and hostname.
+    EXPECT_EQ(2, store_.getAll4(SubnetID(1)).size());
+    EXPECT_TRUE(store_.getAll6(SubnetID(1)).empty());
+    EXPECT_EQ(1, store_.getAllbyHostname("host-1.example.org").size());
+    EXPECT_EQ(1, store_.getAllbyHostname4("host-2.example.org",
+                                          SubnetID(1)).size());
+    EXPECT_TRUE(store_.getAllbyHostname4("host-2.example.org",
+                                         SubnetID(2)).empty());
+}
+
+// Verifies the checks of the added hosts.
+TEST_F(CompactHostStoreTest, duplicates) {
+    HostPtr host = createHost4(1);
+    ASSERT_NO_THROW(store_.add(host));
+
+    // Same identifier in the same subnet.
+    HostPtr dup = createHost4(1);
+    dup->setIPv4Reservation(IOAddress("10.1.0.1"));
+    EXPECT_THROW(store_.add(dup), DuplicateHost);
+
+    // Same address in the same subnet.
+    HostPtr other = createHost4(2);
+    other->setIPv4Reservation(host->getIPv4Reservation());
+    EXPECT_THROW(store_.add(other), ReservedAddress);
+
+    // Unless non-unique reservations are allowed.
+    EXPECT_TRUE(store_.setIPReservationsUnique(false));
+    EXPECT_NO_THROW(store_.add(other));
+    EXPECT_EQ(2, store_.getAll4(SubnetID(1), host->getIPv4Reservation()).size());
+
+    // Same identifier in another subnet.
+    EXPECT_NO_THROW(store_.add(createHost4(1, SubnetID(2))));
+    EXPECT_EQ(3, store_.size());
+}
+
+// Verifies that the option sets are shared between the hosts.
+TEST_F(CompactHostStoreTest, profiles) {
+    for (uint32_t i = 0; i < 10; ++i) {
+        HostPtr host = createHost4(i);
+        OptionPtr option(new OptionString(Option::V4, DHO_BOOT_FILE_NAME,
+                                          (i % 2 ? "odd" : "even")));
+        host->getCfgOption4()->add(option, false, false, DHCP4_OPTION_SPACE);
+        ASSERT_NO_THROW(store_.add(host));
+    }
+    EXPECT_EQ(2, store_.getProfileCount());
+
+    ConstHostPtr host1 = get4(createHost4(1));
+    ConstHostPtr host3 = get4(createHost4(3));
+    ASSERT_TRUE(host1);
+    ASSERT_TRUE(host3);
+    EXPECT_EQ(host1->getCfgOption4(), host3->getCfgOption4());
+    OptionDescriptor desc = host1->getCfgOption4()->get(DHCP4_OPTION_SPACE,
+                                                        DHO_BOOT_FILE_NAME);
+    ASSERT_TRUE(desc.option_);
+    EXPECT_EQ("odd", desc.option_->toString());
+}
+
+// Verifies the IPv6 reservations.
+TEST_F(CompactHostStoreTest, add6) {
+    HostPtr host(new Host("01:02:03:04:05:06", "duid", SUBNET_ID_UNUSED,
+                          SubnetID(2), IOAddress::IPV4_ZERO_ADDRESS(),
+                          "host6"));
+    host->addReservation(IPv6Resrv(IPv6Resrv::TYPE_NA, IOAddress("2001:db8::1")));
+    host->addReservation(IPv6Resrv(IPv6Resrv::TYPE_PD, IOAddress("3000::"), 64));
+    host->setKey(AuthKey("0123456789abcdef"));
+    ASSERT_NO_THROW(store_.add(host));
+
+    ConstHostPtr got = store_.get6(SubnetID(2), host->getIdentifierType(),
+                                   &host->getIdentifier()[0],
+                                   host->getIdentifier().size());
+    ASSERT_TRUE(got);
+    EXPECT_EQ(host->toText(), got->toText());
+    EXPECT_TRUE(got->getKey() == host->getKey());
+
+    EXPECT_TRUE(store_.get6(SubnetID(2), IOAddress("2001:db8::1")));
+    EXPECT_FALSE(store_.get6(SubnetID(1), IOAddress("2001:db8::1")));
+    EXPECT_TRUE(store_.get6(IOAddress("3000::"), 64));
+    EXPECT_FALSE(store_.get6(IOAddress("3000::"), 56));
+    EXPECT_EQ(1, store_.getAllbyHostname6("host6", SubnetID(2)).size());
+
+    // The same prefix can't be reserved twice in a subnet.
+    HostPtr other(new Host("01:02:03:04:05:07", "duid", SUBNET_ID_UNUSED,
+                           SubnetID(2), IOAddress::IPV4_ZERO_ADDRESS()));
+    other->addReservation(IPv6Resrv(IPv6Resrv::TYPE_PD, IOAddress("3000::"), 64));
+    EXPECT_THROW(store_.add(other), DuplicateHost);
+}
+
+// Verifies the deletions and the pages.
+TEST_F(CompactHostStoreTest, delAndPage) {
+    for (uint32_t i = 0; i < 10; ++i) {
+        ASSERT_NO_THROW(store_.add(createHost4(i)));
+    }
+    HostPtr host3 = createHost4(3);
+    EXPECT_TRUE(store_.del4(SubnetID(1), host3->getIdentifierType(),
+                            &host3->getIdentifier()[0],
+                            host3->getIdentifier().size()));
+    EXPECT_FALSE(get4(host3));
+    EXPECT_TRUE(store_.del(SubnetID(1), createHost4(4)->getIPv4Reservation()));
+    EXPECT_FALSE(store_.del(SubnetID(1), createHost4(4)->getIPv4Reservation()));
+    EXPECT_EQ(8, store_.size());
+
+    // A deleted host can be added again.
+    EXPECT_NO_THROW(store_.add(host3));
+    EXPECT_EQ(11, host3->getHostId());
+
+    size_t source_index = 0;
+    ConstHostCollection page = store_.getPage4(SubnetID(1), source_index, 0,
+                                               HostPageSize(4));
+    ASSERT_EQ(4, page.size());
+    EXPECT_EQ(1, page[0]->getHostId());
+    EXPECT_EQ(6, page[3]->getHostId());
+    page = store_.getPage4(source_index, page.back()->getHostId(),
+                           HostPageSize(10));
+    ASSERT_EQ(5, page.size());
+    EXPECT_EQ(7, page[0]->getHostId());
+    EXPECT_EQ(11, page[4]->getHostId());
+    EXPECT_TRUE(store_.getPage6(SubnetID(1), source_index, 0,
+                                HostPageSize(10)).empty());
+}
+
+// Verifies that the hosts sharing a profile take less than 100 bytes.
+TEST_F(CompactHostStoreTest, memoryUsage) {
+    const size_t count = 150000;
+    store_.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        ASSERT_NO_THROW(store_.add(createHost4(i)));
+    }
+    store_.shrink();
+    EXPECT_EQ(count, store_.size());
+    EXPECT_EQ(1, store_.getProfileCount());
+    EXPECT_GT(100 * count, store_.getMemoryUsage());
+
+    // All the hosts are still found.
+    for (uint32_t i = 0; i < count; i += 997) {
+        ConstHostPtr host = get4(createHost4(i));
+        ASSERT_TRUE(host);
+        EXPECT_EQ(i + 1, host->getHostId());
+    }
+}
+
+} // end of anonymous namespace
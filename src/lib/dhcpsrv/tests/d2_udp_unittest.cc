@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,15 +14,19 @@
 #include <dhcp/iface_mgr.h>
 #include <dhcpsrv/d2_client_mgr.h>
 #include <exceptions/exceptions.h>
+#include <util/multi_threading_mgr.h>
 
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <functional>
+#include <thread>
 #include <sys/select.h>
 
 using namespace std;
 using namespace isc::dhcp;
 using namespace isc;
+using namespace isc::util;
 namespace ph = std::placeholders;
 
 namespace {
@@ -51,6 +55,8 @@ public:
 
     /// @brief virtual Destructor
     virtual ~D2ClientMgrTest(){
+        stopSenderThread();
+        MultiThreadingMgr::instance().setMode(false);
     }
 
     /// @brief Updates the D2ClientMgr's configuration to DDNS enabled.
@@ -289,6 +295,87 @@ TEST_F(D2ClientMgrTest, udpSend) {
     selectCheck(false);
 }
 
+/// @brief Checks that the sender IO can be processed by a dedicated thread.
+TEST_F(D2ClientMgrTest, udpSendThread) {
+    // The sender must be thread safe.
+    MultiThreadingMgr::instance().setMode(true);
+
+    // Enable DDNS with server at 127.0.0.1/prot 53001 via UDP.
+    enableDdns("127.0.0.1", 530001, dhcp_ddns::NCR_UDP);
+
+    // The thread requires the sender to be started.
+    ASSERT_NO_THROW(startSenderThread());
+    EXPECT_FALSE(isSenderThreadRunning());
+
+    // Place sender in send mode and start the thread.
+    ASSERT_NO_THROW(startSender(getErrorHandler()));
+    ASSERT_NO_THROW(startSenderThread());
+    EXPECT_TRUE(isSenderThreadRunning());
+
+    // Queue three messages.
+    for (unsigned i = 0; i < 3; ++i) {
+        dhcp_ddns::NameChangeRequestPtr ncr = buildTestNcr();
+        ASSERT_NO_THROW(sendRequest(ncr));
+    }
+
+    // The thread should send them without any call to runReadyIO.
+    for (unsigned i = 0; (i < 100) && (getQueueSize() > 0); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(0, getQueueSize());
+
+    // Stopping the thread gives the sender back to the main loop.
+    ASSERT_NO_THROW(stopSenderThread());
+    EXPECT_FALSE(isSenderThreadRunning());
+    EXPECT_TRUE(amSending());
+    EXPECT_EQ(3, callback_count_);
+    EXPECT_EQ(0, error_handler_count_);
+
+    // The main loop can send again.
+    dhcp_ddns::NameChangeRequestPtr ncr = buildTestNcr();
+    ASSERT_NO_THROW(sendRequest(ncr));
+    selectCheck(true);
+    runReadyIO();
+    EXPECT_EQ(4, callback_count_);
+
+    ASSERT_NO_THROW(stopSender());
+}
+
+/// @brief Checks that the deferred requests are built by the sender thread
+/// when it runs and at once otherwise.
+TEST_F(D2ClientMgrTest, udpSendDeferred) {
+    MultiThreadingMgr::instance().setMode(true);
+    enableDdns("127.0.0.1", 530001, dhcp_ddns::NCR_UDP);
+    ASSERT_NO_THROW(startSender(getErrorHandler()));
+    ASSERT_NO_THROW(startSenderThread());
+    ASSERT_TRUE(isSenderThreadRunning());
+
+    // A builder failing to build a request is skipped.
+    D2ClientMgr::NcrBuilder builder = std::bind(&D2ClientMgrTest::buildTestNcr,
+                                                this);
+    ASSERT_NO_THROW(sendDeferred(builder));
+    ASSERT_NO_THROW(sendDeferred([]() {
+        return (dhcp_ddns::NameChangeRequestPtr());
+    }));
+    ASSERT_NO_THROW(sendDeferred(builder));
+
+    for (unsigned i = 0; (i < 100) && (callback_count_ < 2); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_NO_THROW(stopSenderThread());
+    EXPECT_EQ(2, callback_count_);
+    EXPECT_EQ(0, error_handler_count_);
+
+    // Without the thread the request is queued at once.
+    ASSERT_NO_THROW(sendDeferred(builder));
+    EXPECT_EQ(1, getQueueSize());
+
+    ASSERT_NO_THROW(stopSender());
+
+    // Not in send mode.
+    EXPECT_THROW(sendDeferred(builder), D2ClientError);
+}
+
 /// @brief Checks that D2ClientMgr can send with a UDP sender and
 /// an external IOService.
 TEST_F(D2ClientMgrTest, udpSendExternalIOService) {
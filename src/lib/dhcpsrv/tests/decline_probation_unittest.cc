@@ -0,0 +1,104 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/decline_probation.h>
+#include <dhcpsrv/timer_mgr.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture for exercising DeclineProbation.
+class DeclineProbationTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    DeclineProbationTest() : wheel_(TimerMgr::instance()->getTimerWheel()) {
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Destroys the timing wheel.
+    ~DeclineProbationTest() {
+        wheel_.reset();
+        TimerMgr::instance()->unregisterTimers();
+    }
+
+    /// @brief The timing wheel of the timer manager.
+    TimerWheelPtr wheel_;
+};
+
+// Verifies the basic operations of the table.
+TEST_F(DeclineProbationTest, basic) {
+    DeclineProbation probation;
+    IOAddress addr("192.0.2.1");
+    EXPECT_FALSE(probation.isOnProbation(addr));
+
+    probation.add(addr, 3600);
+    EXPECT_EQ(1, probation.size());
+    EXPECT_EQ(1, wheel_->size());
+    EXPECT_TRUE(probation.isOnProbation(addr));
+    EXPECT_FALSE(probation.isOnProbation(IOAddress("192.0.2.2")));
+
+    // A new decline replaces the entry and its timer.
+    probation.add(addr, 7200);
+    EXPECT_EQ(1, probation.size());
+    EXPECT_EQ(1, wheel_->size());
+
+    EXPECT_TRUE(probation.remove(addr));
+    EXPECT_FALSE(probation.remove(addr));
+    EXPECT_FALSE(probation.isOnProbation(addr));
+    EXPECT_EQ(0, probation.size());
+    EXPECT_EQ(0, wheel_->size());
+
+    probation.add(addr, 3600);
+    probation.add(IOAddress("192.0.2.2"), 3600);
+    EXPECT_EQ(2, probation.size());
+    probation.clear();
+    EXPECT_EQ(0, probation.size());
+    EXPECT_EQ(0, wheel_->size());
+}
+
+// Verifies that the entries expire at the end of the probation period.
+TEST_F(DeclineProbationTest, expire) {
+    DeclineProbation probation;
+    IOAddress addr("192.0.2.1");
+
+    // A null period ends at the first lookup.
+    probation.add(addr, 0);
+    EXPECT_FALSE(probation.isOnProbation(addr));
+    EXPECT_EQ(0, probation.size());
+
+    // The timer removes the entry.
+    probation.add(addr, 1);
+    EXPECT_TRUE(probation.isOnProbation(addr));
+    EXPECT_EQ(1, wheel_->advance(TimerWheel::Clock::now() +
+                                 std::chrono::seconds(2)));
+    EXPECT_EQ(0, probation.size());
+    EXPECT_FALSE(probation.isOnProbation(addr));
+}
+
+// Verifies that the timers do not outlive the table.
+TEST_F(DeclineProbationTest, destroy) {
+    {
+        DeclineProbation probation;
+        probation.add(IOAddress("192.0.2.1"), 1);
+        EXPECT_EQ(1, wheel_->size());
+    }
+    EXPECT_EQ(0, wheel_->size());
+    EXPECT_EQ(0, wheel_->advance(TimerWheel::Clock::now() +
+                                 std::chrono::seconds(2)));
+}
+
+} // end of anonymous namespace
@@ -9,17 +9,18 @@
 #include <dhcp/iface_mgr.h>
 #include <dhcp/pkt6.h>
 #include <dhcp/tests/iface_mgr_test_config.h>
-#include <dhcp/option6_addrlst.h>
-#include <dhcp/option_string.h>
 #include <dhcp/option_vendor.h>
-#include <dhcp/option_int.h>
 #include <dhcpsrv/dhcp4o6_ipc.h>
 #include <dhcpsrv/testutils/dhcp4o6_test_ipc.h>
 
+#include <util/io_utilities.h>
+
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <functional>
 #include <sstream>
 #include <string>
+#include <vector>
 
 using namespace isc::asiolink;
 using namespace isc::dhcp;
@@ -131,10 +132,20 @@ protected:
                          TestIpc::EndpointType dest,
                          const CreateMsgFun& create_msg_fun);
 
+    /// @brief Creates the wire representation of a DHCPv4o6 message
+    /// with its IPC header.
+    ///
+    /// @param ifname Interface name carried in the header.
+    /// @param magic Magic number carried in the header.
+    /// @return The datagram.
+    static std::vector<uint8_t> createDatagram(const std::string& ifname,
+                                               uint32_t magic =
+                                               TestIpc::HEADER_MAGIC);
+
     /// @brief Tests that error is reported when invalid message is received.
     ///
-    /// @param pkt Pointer to the invalid message.
-    void testReceiveError(const Pkt6Ptr& pkt);
+    /// @param data The invalid datagram.
+    void testReceiveError(const std::vector<uint8_t>& data);
 
 private:
 
@@ -319,8 +330,31 @@ Dhcp4o6IpcBaseTest::testSendReceive(uint16_t iterations_num,
     }
 }
 
+std::vector<uint8_t>
+Dhcp4o6IpcBaseTest::createDatagram(const std::string& ifname,
+                                   uint32_t magic) {
+    Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 0));
+    pkt->addOption(createDHCPv4MsgOption(TestIpc::ENDPOINT_TYPE_V6));
+    OutputBuffer& buf = pkt->getBuffer();
+    buf.clear();
+    pkt->pack();
+
+    std::vector<uint8_t> data(TestIpc::HEADER_SIZE, 0);
+    writeUint32(magic, &data[0], data.size());
+    std::vector<uint8_t> addr = IOAddress("2001:db8:1::1").toBytes();
+    std::copy(addr.begin(), addr.end(),
+              data.begin() + TestIpc::HEADER_ADDR_OFFSET);
+    writeUint16(TEST_PORT, &data[TestIpc::HEADER_PORT_OFFSET],
+                sizeof(uint16_t));
+    std::copy(ifname.begin(), ifname.end(),
+              data.begin() + TestIpc::HEADER_IFACE_OFFSET);
+    const uint8_t* content = static_cast<const uint8_t*>(buf.getData());
+    data.insert(data.end(), content, content + buf.getLength());
+    return (data);
+}
+
 void
-Dhcp4o6IpcBaseTest::testReceiveError(const Pkt6Ptr& pkt) {
+Dhcp4o6IpcBaseTest::testReceiveError(const std::vector<uint8_t>& data) {
     TestIpc ipc_src(TEST_PORT, TestIpc::ENDPOINT_TYPE_V6);
     TestIpc ipc_dest(TEST_PORT, TestIpc::ENDPOINT_TYPE_V4);
 
@@ -328,25 +362,13 @@ Dhcp4o6IpcBaseTest::testReceiveError(const Pkt6Ptr& pkt) {
     ASSERT_NO_THROW(ipc_src.open());
     ASSERT_NO_THROW(ipc_dest.open());
 
-    pkt->setIface("eth0");
-    pkt->setIndex(ETH0_INDEX);
-    pkt->setRemoteAddr(IOAddress("2001:db8:1::1"));
-    pkt->setRemotePort(TEST_PORT);
-    pkt->addOption(createDHCPv4MsgOption(TestIpc::ENDPOINT_TYPE_V6));
-
-    OutputBuffer& buf = pkt->getBuffer();
-    buf.clear();
-    ASSERT_NO_THROW(pkt->pack());
-
-    ASSERT_NE(-1, ::send(ipc_src.getSocketFd(), buf.getData(),
-                         buf.getLength(), 0));
+    ASSERT_NE(-1, ::send(ipc_src.getSocketFd(), &data[0], data.size(), 0));
 
     // Call receive with a timeout. The data should appear on the socket
     // within this time.
     ASSERT_THROW(IfaceMgr::instance().receive6(1, 0), Dhcp4o6IpcError);
 }
 
-
 // This test verifies that the IPC can transmit messages between the
 // DHCPv4 and DHCPv6 server.
 TEST_F(Dhcp4o6IpcBaseTest, send4To6) {
@@ -454,92 +476,93 @@ TEST_F(Dhcp4o6IpcBaseTest, openError) {
     EXPECT_EQ(TEST_PORT + 10, ipc.getPort());
 }
 
-// This test verifies that receiving packet over the IPC fails when there
-// is no vendor option present.
-TEST_F(Dhcp4o6IpcBaseTest, receiveWithoutVendorOption) {
-    Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 0));
-    testReceiveError(pkt);
+// This test verifies that a well formed datagram is received.
+TEST_F(Dhcp4o6IpcBaseTest, receiveDatagram) {
+    TestIpc ipc_src(TEST_PORT, TestIpc::ENDPOINT_TYPE_V6);
+    TestIpc ipc_dest(TEST_PORT, TestIpc::ENDPOINT_TYPE_V4);
+    ASSERT_NO_THROW(ipc_src.open());
+    ASSERT_NO_THROW(ipc_dest.open());
+
+    std::vector<uint8_t> data = createDatagram("eth1");
+    ASSERT_NE(-1, ::send(ipc_src.getSocketFd(), &data[0], data.size(), 0));
+    ASSERT_NO_THROW(IfaceMgr::instance().receive6(1, 0));
+
+    Pkt6Ptr pkt_received = ipc_dest.popPktReceived();
+    ASSERT_TRUE(pkt_received);
+    EXPECT_EQ(DHCPV6_DHCPV4_QUERY, pkt_received->getType());
+    EXPECT_EQ("eth1", pkt_received->getIface());
+    EXPECT_EQ(ETH1_INDEX, pkt_received->getIndex());
+    EXPECT_EQ("2001:db8:1::1", pkt_received->getRemoteAddr().toText());
+    EXPECT_EQ(TEST_PORT, pkt_received->getRemotePort());
+    EXPECT_TRUE(pkt_received->getOption(D6O_DHCPV4_MSG));
 }
 
-// This test verifies that receiving packet over the IPC fails when the
-// enterprise ID carried in the vendor option is invalid.
-TEST_F(Dhcp4o6IpcBaseTest, receiveInvalidEnterpriseId) {
-    Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 0));
-    OptionVendorPtr option_vendor(new OptionVendor(Option::V6, 1));
-    option_vendor->addOption(OptionStringPtr(new OptionString(Option::V6,
-                                                              ISC_V6_4O6_INTERFACE,
-                                                              "eth0")));
-    option_vendor->addOption(Option6AddrLstPtr(new Option6AddrLst(ISC_V6_4O6_SRC_ADDRESS,
-                                                                  IOAddress("2001:db8:1::1"))));
+// This test verifies that the queued messages can be received in a row
+// and that receive returns null when no message is left.
+TEST_F(Dhcp4o6IpcBaseTest, receiveBatch) {
+    TestIpc ipc_src(TEST_PORT, TestIpc::ENDPOINT_TYPE_V4);
+    TestIpc ipc_dest(TEST_PORT, TestIpc::ENDPOINT_TYPE_V6);
+    ASSERT_NO_THROW(ipc_src.open());
+    ASSERT_NO_THROW(ipc_dest.open());
 
-    pkt->addOption(option_vendor);
-    testReceiveError(pkt);
-}
+    // Nothing was sent yet.
+    Pkt6Ptr pkt_received;
+    ASSERT_NO_THROW(pkt_received = ipc_dest.receive());
+    EXPECT_FALSE(pkt_received);
 
-// This test verifies that receiving packet over the IPC fails when the
-// interface option is not present.
-TEST_F(Dhcp4o6IpcBaseTest, receiveWithoutInterfaceOption) {
-    Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 0));
-    OptionVendorPtr option_vendor(new OptionVendor(Option::V6, ENTERPRISE_ID_ISC));
-    option_vendor->addOption(Option6AddrLstPtr(new Option6AddrLst(ISC_V6_4O6_SRC_ADDRESS,
-                                                                  IOAddress("2001:db8:1::1"))));
-    option_vendor->addOption(OptionUint16Ptr(new OptionUint16(Option::V6,
-                                                              ISC_V6_4O6_SRC_PORT,
-                                                              TEST_PORT)));
+    for (uint16_t i = 1; i <= TEST_ITERATIONS; ++i) {
+        ASSERT_NO_THROW(ipc_src.send(createDHCPv4o6Message(DHCPV6_DHCPV4_RESPONSE,
+                                                           i)));
+    }
 
-    pkt->addOption(option_vendor);
-    testReceiveError(pkt);
+    // Wait for the first message.
+    ASSERT_NO_THROW(IfaceMgr::instance().receive6(1, 0));
+    pkt_received = ipc_dest.popPktReceived();
+    ASSERT_TRUE(pkt_received);
+    EXPECT_EQ("2001:db8:1::1", pkt_received->getRemoteAddr().toText());
+
+    // The others are already queued.
+    for (uint16_t i = 2; i <= TEST_ITERATIONS; ++i) {
+        ASSERT_NO_THROW(pkt_received = ipc_dest.receive());
+        ASSERT_TRUE(pkt_received);
+        EXPECT_EQ(concatenate("2001:db8:1::", i),
+                  pkt_received->getRemoteAddr().toText());
+        EXPECT_EQ(concatenate("eth", i % 2), pkt_received->getIface());
+    }
+    ASSERT_NO_THROW(pkt_received = ipc_dest.receive());
+    EXPECT_FALSE(pkt_received);
 }
 
 // This test verifies that receiving packet over the IPC fails when the
-// interface which name is carried in the option is not present in the
-// system.
-TEST_F(Dhcp4o6IpcBaseTest, receiveWithInvalidInterface) {
-    Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 0));
-    OptionVendorPtr option_vendor(new OptionVendor(Option::V6, ENTERPRISE_ID_ISC));
-    option_vendor->addOption(OptionStringPtr(new OptionString(Option::V6,
-                                                              ISC_V6_4O6_INTERFACE,
-                                                              "ethX")));
-    option_vendor->addOption(Option6AddrLstPtr(new Option6AddrLst(ISC_V6_4O6_SRC_ADDRESS,
-                                                                  IOAddress("2001:db8:1::1"))));
-    option_vendor->addOption(OptionUint16Ptr(new OptionUint16(Option::V6,
-                                                              ISC_V6_4O6_SRC_PORT,
-                                                              TEST_PORT)));
-
-    pkt->addOption(option_vendor);
-    testReceiveError(pkt);
+// header is truncated.
+TEST_F(Dhcp4o6IpcBaseTest, receiveTruncatedHeader) {
+    std::vector<uint8_t> data = createDatagram("eth0");
+    data.resize(TestIpc::HEADER_SIZE - 1);
+    testReceiveError(data);
 }
 
-
 // This test verifies that receiving packet over the IPC fails when the
-// source address option is not present.
-TEST_F(Dhcp4o6IpcBaseTest, receiveWithoutSourceAddressOption) {
-    Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 0));
-    OptionVendorPtr option_vendor(new OptionVendor(Option::V6, ENTERPRISE_ID_ISC));
-    option_vendor->addOption(OptionStringPtr(new OptionString(Option::V6,
-                                             ISC_V6_4O6_INTERFACE,
-                                             "eth0")));
-    option_vendor->addOption(OptionUint16Ptr(new OptionUint16(Option::V6,
-                                                              ISC_V6_4O6_SRC_PORT,
-                                                              TEST_PORT)));
-
-    pkt->addOption(option_vendor);
-    testReceiveError(pkt);
+// header does not start with the magic number.
+TEST_F(Dhcp4o6IpcBaseTest, receiveBadMagic) {
+    testReceiveError(createDatagram("eth0", 0x12345678));
 }
 
 // This test verifies that receiving packet over the IPC fails when the
-// source port option is not present.
-TEST_F(Dhcp4o6IpcBaseTest, receiveWithoutSourcePortOption) {
-    Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 0));
-    OptionVendorPtr option_vendor(new OptionVendor(Option::V6, ENTERPRISE_ID_ISC));
-    option_vendor->addOption(OptionStringPtr(new OptionString(Option::V6,
-                                                              ISC_V6_4O6_INTERFACE,
-                                                              "eth0")));
-    option_vendor->addOption(Option6AddrLstPtr(new Option6AddrLst(ISC_V6_4O6_SRC_ADDRESS,
-                                                                  IOAddress("2001:db8:1::1"))));
+// interface which name is carried in the header is not present in the
+// system.
+TEST_F(Dhcp4o6IpcBaseTest, receiveWithInvalidInterface) {
+    testReceiveError(createDatagram("ethX"));
+}
 
-    pkt->addOption(option_vendor);
-    testReceiveError(pkt);
+// This test verifies that send method throws exception when the interface
+// name does not fit in the header.
+TEST_F(Dhcp4o6IpcBaseTest, sendLongInterfaceName) {
+    TestIpc ipc(TEST_PORT, TestIpc::ENDPOINT_TYPE_V4);
+    ASSERT_NO_THROW(ipc.open());
+
+    Pkt6Ptr pkt(createDHCPv4o6Message(DHCPV6_DHCPV4_RESPONSE));
+    pkt->setIface("a-very-long-interface-name");
+    EXPECT_THROW(ipc.send(pkt), Dhcp4o6IpcError);
 }
 
 // This test verifies that send method throws exception when the packet
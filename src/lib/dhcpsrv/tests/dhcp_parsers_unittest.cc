@@ -18,6 +18,7 @@
 #include <dhcpsrv/cfgmgr.h>
 #include <dhcpsrv/subnet.h>
 #include <dhcpsrv/cfg_mac_source.h>
+#include <dhcpsrv/bitmap_allocator.h>
 #include <dhcpsrv/flq_allocator.h>
 #include <dhcpsrv/flq_allocation_state.h>
 #include <dhcpsrv/iterative_allocator.h>
@@ -3268,6 +3269,34 @@ TEST_F(ParseConfigTest, flqSubnetAllocator4) {
     EXPECT_TRUE(boost::dynamic_pointer_cast<FreeLeaseQueueAllocator>(allocator));
 }
 
+// This test verifies that the bitmap allocator can be selected for
+// a subnet.
+TEST_F(ParseConfigTest, bitmapSubnetAllocator4) {
+    std::string config =
+        "{"
+        "    \"subnet4\": [ {"
+        "        \"subnet\": \"192.0.2.0/24\","
+        "        \"id\": 1,"
+        "        \"allocator\": \"bitmap\""
+        "    } ]"
+        "}";
+
+    ElementPtr json = Element::fromJSON(config);
+    EXPECT_TRUE(json);
+    ConstElementPtr status = parseElementSet(json, false);
+    int rcode = 0;
+    ConstElementPtr comment = parseAnswer(rcode, status);
+    ASSERT_EQ(0, rcode);
+
+    auto subnet = CfgMgr::instance().getStagingCfg()->getCfgSubnets4()->getBySubnetId(1);
+    ASSERT_TRUE(subnet);
+
+    EXPECT_EQ("bitmap", subnet->getAllocatorType().get());
+    auto allocator = subnet->getAllocator(Lease::TYPE_V4);
+    ASSERT_TRUE(allocator);
+    EXPECT_TRUE(boost::dynamic_pointer_cast<BitmapAllocator>(allocator));
+}
+
 // This test verifies that unknown allocator is rejected.
 TEST_F(ParseConfigTest, invalidSubnetAllocator4) {
     std::string config =
@@ -3288,7 +3317,7 @@ TEST_F(ParseConfigTest, invalidSubnetAllocator4) {
     ASSERT_EQ(comment->getType(), Element::string);
     EXPECT_EQ(1, rcode);
     std::string expected = "Configuration parsing failed: ";
-    expected += "supported allocators are: iterative, random and flq";
+    expected += "supported allocators are: iterative, random, flq and bitmap";
     EXPECT_EQ(expected, comment->stringValue());
 }
 
@@ -3352,6 +3381,31 @@ TEST_F(ParseConfigTest, flqSubnetAllocator6) {
     EXPECT_EQ(expected, comment->stringValue());
 }
 
+// This test verifies that the bitmap allocator is not supported for
+// IPv6 address pools.
+TEST_F(ParseConfigTest, bitmapSubnetAllocator6) {
+    std::string config =
+        "{"
+        "    \"subnet6\": [ {"
+        "        \"subnet\": \"2001:db8:1::/64\","
+        "        \"id\": 1,"
+        "        \"allocator\": \"bitmap\""
+        "    } ]"
+        "}";
+
+    ElementPtr json = Element::fromJSON(config);
+    EXPECT_TRUE(json);
+    ConstElementPtr status = parseElementSet(json, false);
+    int rcode = 0;
+    ConstElementPtr comment = parseAnswer(rcode, status);
+    ASSERT_TRUE(comment);
+    ASSERT_EQ(comment->getType(), Element::string);
+    EXPECT_EQ(1, rcode);
+    std::string expected = "Configuration parsing failed: ";
+    expected += "Bitmap allocator is not supported for IPv6 address pools";
+    EXPECT_EQ(expected, comment->stringValue());
+}
+
 // This test verifies that unknown allocator is rejected.
 TEST_F(ParseConfigTest, invalidSubnetAllocator6) {
     std::string config =
@@ -3372,7 +3426,7 @@ TEST_F(ParseConfigTest, invalidSubnetAllocator6) {
     ASSERT_EQ(comment->getType(), Element::string);
     EXPECT_EQ(1, rcode);
     std::string expected = "Configuration parsing failed: ";
-    expected += "supported allocators are: iterative, random and flq";
+    expected += "supported allocators are: iterative, random, flq and bitmap";
     EXPECT_EQ(expected, comment->stringValue());
 }
 
@@ -104,6 +104,46 @@ TEST(PoolFreeLeaseAllocationState, addFreeLeaseV4SeveralTimes) {
     EXPECT_EQ(0, state->getFreeLeaseCount());
 }
 
+// Test that a queue fragmented by the removal of most of its free leases
+// is compacted without changing the order of the free leases.
+TEST(PoolFreeLeaseAllocationState, compactV4) {
+    auto pool = boost::make_shared<Pool4>(IOAddress("10.0.0.0"), IOAddress("10.0.255.255"));
+    auto state = PoolFreeLeaseQueueAllocationState::create(pool);
+    ASSERT_TRUE(state);
+    // A small queue is not fragmented.
+    EXPECT_EQ(0.0, state->getFragmentation());
+    EXPECT_EQ(0, state->compact());
+
+    // Fill the queue.
+    for (uint32_t i = 0; i < 65536; ++i) {
+        state->addFreeLease(IOAddress(0x0a000000 + i));
+    }
+    size_t filled = state->getMemoryUsage();
+    EXPECT_GT(filled, 0);
+    EXPECT_LT(state->getFragmentation(), 0.5);
+
+    // Allocate most of the free leases.
+    for (uint32_t i = 10; i < 65536; ++i) {
+        state->deleteFreeLease(IOAddress(0x0a000000 + i));
+    }
+    ASSERT_EQ(10, state->getFreeLeaseCount());
+    EXPECT_GT(state->getFragmentation(), 0.5);
+    size_t fragmented = state->getMemoryUsage();
+    EXPECT_LT(fragmented, filled);
+
+    // Compact the queue.
+    size_t released = state->compact();
+    EXPECT_GT(released, 0);
+    EXPECT_EQ(fragmented - released, state->getMemoryUsage());
+    EXPECT_EQ(0.0, state->getFragmentation());
+    EXPECT_EQ(10, state->getFreeLeaseCount());
+
+    // The order of the free leases is kept.
+    for (uint32_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(IOAddress(0x0a000000 + i), state->offerFreeLease());
+    }
+    EXPECT_FALSE(state->exhausted());
+}
 
 // Test creating a new free lease queue allocation state for an IPv6
 // address pool.
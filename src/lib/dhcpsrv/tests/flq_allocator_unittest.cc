@@ -79,6 +79,28 @@ TEST_F(FreeLeaseQueueAllocatorTest4, populateFreeAddressLeases) {
     EXPECT_EQ(1, addresses.count(IOAddress("192.0.2.109")));
 }
 
+// Test that a populated queue is not populated again.
+TEST_F(FreeLeaseQueueAllocatorTest4, populatedStateKept) {
+    FreeLeaseQueueAllocator alloc(Lease::TYPE_V4, subnet_);
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    auto pool_state = boost::dynamic_pointer_cast<PoolFreeLeaseQueueAllocationState>(pool_->getAllocationState());
+    ASSERT_TRUE(pool_state);
+    EXPECT_TRUE(pool_state->isPopulated());
+    EXPECT_EQ(10, pool_state->getFreeLeaseCount());
+
+    // A new allocator taking over the state, e.g. after a reconfiguration,
+    // keeps the queue as is.
+    auto lease = pool_state->offerFreeLease();
+    ASSERT_FALSE(lease.isV4Zero());
+    EXPECT_EQ(9, pool_state->getFreeLeaseCount());
+    LeaseMgrFactory::instance().unregisterAllCallbacks();
+    FreeLeaseQueueAllocator alloc2(Lease::TYPE_V4, subnet_);
+    ASSERT_NO_THROW(alloc2.initAfterConfigure());
+    EXPECT_EQ(pool_state, pool_->getAllocationState());
+    EXPECT_EQ(9, pool_state->getFreeLeaseCount());
+}
+
 // Test allocating IPv4 addresses when a subnet has a single pool.
 TEST_F(FreeLeaseQueueAllocatorTest4, singlePool) {
     FreeLeaseQueueAllocator alloc(Lease::TYPE_V4, subnet_);
@@ -271,6 +293,44 @@ TEST_F(FreeLeaseQueueAllocatorTest4, noPools) {
    EXPECT_TRUE(candidate.isV4Zero());
 }
 
+// Test that the allocator returns the number of free addresses in the
+// pools allowed for the client classes.
+TEST_F(FreeLeaseQueueAllocatorTest4, getFreeLeaseCount) {
+    FreeLeaseQueueAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    // Second pool. It only allows client class bar.
+    auto pool1 = boost::make_shared<Pool4>(IOAddress("192.0.2.120"),
+                                           IOAddress("192.0.2.129"));
+    pool1->allowClientClass("bar");
+    subnet_->addPool(pool1);
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    EXPECT_EQ(10, alloc.getFreeLeaseCount(cc_));
+
+    cc_.insert("bar");
+    EXPECT_EQ(20, alloc.getFreeLeaseCount(cc_));
+
+    // Allocate all addresses from the first pool.
+    cc_.clear();
+    for (auto i = 0; i < 10; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        EXPECT_TRUE(lease_mgr.addLease(createLease4(candidate, i)));
+        EXPECT_EQ(9 - i, alloc.getFreeLeaseCount(cc_));
+    }
+
+    // The client belonging to the class bar can still get the addresses
+    // from the second pool.
+    cc_.insert("bar");
+    EXPECT_EQ(10, alloc.getFreeLeaseCount(cc_));
+
+    // Releasing a lease gives the address back.
+    cc_.clear();
+    EXPECT_TRUE(lease_mgr.deleteLease(lease_mgr.getLease4(IOAddress("192.0.2.100"))));
+    EXPECT_EQ(1, alloc.getFreeLeaseCount(cc_));
+}
+
 // Test that the allocator respects client class guards.
 TEST_F(FreeLeaseQueueAllocatorTest4, clientClasses) {
    FreeLeaseQueueAllocator alloc(Lease::TYPE_V4, subnet_);
@@ -974,6 +1034,47 @@ TEST_F(FreeLeaseQueueAllocatorTest6, manyPdPoolsPreferHigher) {
     EXPECT_EQ(total, prefixes.size());
 }
 
+// Test that the allocator picks the delegated prefixes from the pools
+// with the length closest to the hint first.
+TEST_F(FreeLeaseQueueAllocatorTest6, manyPdPoolsBestFit) {
+    FreeLeaseQueueAllocator alloc(Lease::TYPE_PD, subnet_);
+
+    // The default pool delegates /80 prefixes. Add pools delegating
+    // 4 /58 prefixes, 16 /60 prefixes and 16 /68 prefixes.
+    subnet_->addPool(boost::make_shared<Pool6>(Lease::TYPE_PD, IOAddress("3001::"), 56, 58));
+    subnet_->addPool(boost::make_shared<Pool6>(Lease::TYPE_PD, IOAddress("3002::"), 56, 60));
+    subnet_->addPool(boost::make_shared<Pool6>(Lease::TYPE_PD, IOAddress("3003::"), 64, 68));
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    Pool6Ptr pool;
+
+    // The /60 prefixes are the closest shorter ones, then the /58 prefixes.
+    for (auto i = 0; i < 20; ++i) {
+        IOAddress candidate = alloc.pickPrefix(cc_, pool, duid_, Allocator::PREFIX_LEN_LOWER, IOAddress("::"), 64);
+        ASSERT_FALSE(candidate.isV6Zero());
+        ASSERT_TRUE(pool);
+        EXPECT_EQ(i < 16 ? 60 : 58, pool->getLength());
+        EXPECT_TRUE(lease_mgr.addLease(createLease6(Lease::TYPE_PD, candidate, i)));
+    }
+    IOAddress candidate = alloc.pickPrefix(cc_, pool, duid_, Allocator::PREFIX_LEN_LOWER, IOAddress("::"), 64);
+    EXPECT_TRUE(candidate.isV6Zero());
+
+    // The /68 prefixes are the closest longer ones, then the /80 prefixes.
+    for (auto i = 0; i < 16; ++i) {
+        candidate = alloc.pickPrefix(cc_, pool, duid_, Allocator::PREFIX_LEN_HIGHER, IOAddress("::"), 64);
+        ASSERT_FALSE(candidate.isV6Zero());
+        ASSERT_TRUE(pool);
+        EXPECT_EQ(68, pool->getLength());
+        EXPECT_TRUE(lease_mgr.addLease(createLease6(Lease::TYPE_PD, candidate, 20 + i)));
+    }
+    candidate = alloc.pickPrefix(cc_, pool, duid_, Allocator::PREFIX_LEN_HIGHER, IOAddress("::"), 64);
+    EXPECT_FALSE(candidate.isV6Zero());
+    ASSERT_TRUE(pool);
+    EXPECT_EQ(80, pool->getLength());
+}
+
 // Test that the allocator respects client class guards.
 TEST_F(FreeLeaseQueueAllocatorTest6, pdPoolsClientClasses) {
     FreeLeaseQueueAllocator alloc(Lease::TYPE_PD, subnet_);
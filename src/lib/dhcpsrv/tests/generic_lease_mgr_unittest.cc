@@ -25,6 +25,7 @@
 
 #include <functional>
 #include <limits>
+#include <set>
 #include <sstream>
 
 using namespace std;
@@ -1366,6 +1367,82 @@ GenericLeaseMgrTest::testGetLeases4Paged() {
                  InvalidAddressFamily);
 }
 
+void
+GenericLeaseMgrTest::testGetLeases4PagedFilter() {
+    // Get the leases to be used for the test and add to the database.
+    vector<Lease4Ptr> leases = createLeases4();
+    leases[1]->state_ = Lease::STATE_DECLINED;
+    leases[2]->setContext(Element::fromJSON("{ \"ISC\": "
+                                            "{ \"client-classes\": [ \"foo\" ] } }"));
+    leases[3]->setContext(Element::fromJSON("{ \"ISC\": "
+                                            "{ \"client-classes\": [ \"bar\", \"foo\" ] } }"));
+    for (size_t i = 0; i < leases.size(); ++i) {
+        EXPECT_TRUE(lmptr_->addLease(leases[i]));
+    }
+
+    // Walk the pages of the leases matching the filter and returns
+    // their addresses.
+    auto walk = [this](const LeasePageFilter& filter) -> std::set<std::string> {
+        std::set<std::string> addresses;
+        IOAddress last_address = IOAddress("0.0.0.0");
+        for (auto i = 0; i < 10; ++i) {
+            Lease4Collection page =
+                lmptr_->getFilteredLeases4(filter, last_address,
+                                           LeasePageSize(1));
+            if (page.empty()) {
+                break;
+            }
+            EXPECT_EQ(1, page.size());
+            EXPECT_TRUE(filter.matches(*page[0]));
+            addresses.insert(page[0]->addr_.toText());
+            last_address = page[0]->addr_;
+        }
+        return (addresses);
+    };
+
+    // The default filter returns all the leases.
+    LeasePageFilter filter;
+    EXPECT_EQ(leases.size(), walk(filter).size());
+
+    // Leases 1 and 2 belong to the subnet 73.
+    filter.subnet_id_ = 73;
+    std::set<std::string> expected = { straddress4_[1], straddress4_[2] };
+    EXPECT_EQ(expected, walk(filter));
+
+    // Only the lease 1 is declined.
+    filter.state_ = Lease::STATE_DECLINED;
+    expected = { straddress4_[1] };
+    EXPECT_EQ(expected, walk(filter));
+
+    // The leases 2 and 3 were assigned for the foo class.
+    filter = LeasePageFilter();
+    filter.client_class_ = "foo";
+    expected = { straddress4_[2], straddress4_[3] };
+    EXPECT_EQ(expected, walk(filter));
+    filter.client_class_ = "bar";
+    expected = { straddress4_[3] };
+    EXPECT_EQ(expected, walk(filter));
+
+    // Check the expiration range.
+    filter = LeasePageFilter();
+    filter.min_expire_ = leases[0]->getExpirationTime();
+    filter.max_expire_ = leases[0]->getExpirationTime();
+    for (auto const& address : walk(filter)) {
+        Lease4Ptr lease = lmptr_->getLease4(IOAddress(address));
+        ASSERT_TRUE(lease);
+        EXPECT_EQ(leases[0]->getExpirationTime(), lease->getExpirationTime());
+    }
+    EXPECT_EQ(1, walk(filter).count(straddress4_[0]));
+    filter.min_expire_ = filter.max_expire_.get() + 1;
+    EXPECT_TRUE(walk(filter).empty());
+
+    // Only IPv4 address can be used.
+    EXPECT_THROW(lmptr_->getFilteredLeases4(LeasePageFilter(),
+                                            IOAddress("2001:db8::1"),
+                                            LeasePageSize(3)),
+                 InvalidAddressFamily);
+}
+
 void
 GenericLeaseMgrTest::testGetLeases6SubnetId() {
     // Get the leases to be used for the test and add to the database.
@@ -2459,6 +2536,80 @@ GenericLeaseMgrTest::testDeleteExpiredReclaimedLeases4() {
     }
 }
 
+void
+GenericLeaseMgrTest::testReclaimExpiredLeases4() {
+    // Get the leases to be used for the test.
+    vector<Lease4Ptr> leases = createLeases4();
+    // Make sure we have at least 6 leases there.
+    ASSERT_GE(leases.size(), 6);
+
+    // Use the same current time for all leases.
+    time_t current_time = time(NULL);
+
+    // Add them to the database, marking every other lease as expired.
+    // The most expired lease is the first one.
+    for (size_t i = 0; i < leases.size(); ++i) {
+        if (i % 2 == 0) {
+            leases[i]->cltt_ = current_time - leases[i]->valid_lft_ - 100 + i;
+        } else {
+            leases[i]->cltt_ = current_time;
+        }
+        ASSERT_TRUE(lmptr_->addLease(leases[i]));
+    }
+
+    // Reclaim the two most expired leases.
+    Lease4Collection reclaimed_leases;
+    ASSERT_EQ(2, lmptr_->reclaimExpiredLeases4(reclaimed_leases, 2, false));
+    ASSERT_EQ(2, reclaimed_leases.size());
+    for (auto const& reclaimed : reclaimed_leases) {
+        // The leases are returned as they were before the reclamation.
+        bool found = false;
+        for (size_t i = 0; i < 3; i += 2) {
+            if (reclaimed->addr_ == leases[i]->addr_) {
+                found = true;
+                EXPECT_EQ(leases[i]->hostname_, reclaimed->hostname_);
+                EXPECT_EQ(leases[i]->fqdn_fwd_, reclaimed->fqdn_fwd_);
+                EXPECT_EQ(leases[i]->fqdn_rev_, reclaimed->fqdn_rev_);
+                EXPECT_FALSE(reclaimed->stateExpiredReclaimed());
+            }
+        }
+        EXPECT_TRUE(found) << reclaimed->addr_.toText();
+
+        // The leases are reclaimed in the database.
+        Lease4Ptr lease = lmptr_->getLease4(reclaimed->addr_);
+        ASSERT_TRUE(lease);
+        EXPECT_TRUE(lease->stateExpiredReclaimed());
+        EXPECT_TRUE(lease->hostname_.empty());
+        EXPECT_FALSE(lease->fqdn_fwd_);
+        EXPECT_FALSE(lease->fqdn_rev_);
+    }
+
+    // Remove all the remaining expired leases.
+    const size_t remaining = (leases.size() + 1) / 2 - 2;
+    reclaimed_leases.clear();
+    ASSERT_EQ(remaining, lmptr_->reclaimExpiredLeases4(reclaimed_leases, 0, true));
+    ASSERT_EQ(remaining, reclaimed_leases.size());
+    for (size_t i = 0; i < leases.size(); ++i) {
+        Lease4Ptr lease = lmptr_->getLease4(leases[i]->addr_);
+        if (i % 2 != 0) {
+            // The leases which have not expired are left unchanged.
+            ASSERT_TRUE(lease);
+            EXPECT_FALSE(lease->stateExpiredReclaimed());
+        } else if (i < 3) {
+            // The reclaimed leases are kept.
+            ASSERT_TRUE(lease);
+            EXPECT_TRUE(lease->stateExpiredReclaimed());
+        } else {
+            EXPECT_FALSE(lease);
+        }
+    }
+
+    // There is nothing left to reclaim.
+    reclaimed_leases.clear();
+    EXPECT_EQ(0, lmptr_->reclaimExpiredLeases4(reclaimed_leases, 0, false));
+    EXPECT_TRUE(reclaimed_leases.empty());
+}
+
 void
 GenericLeaseMgrTest::testDeleteExpiredReclaimedLeases6() {
     // Get the leases to be used for the test.
@@ -3253,6 +3404,165 @@ GenericLeaseMgrTest::testWipeLeases4() {
     EXPECT_EQ(0, lmptr_->wipeLeases4(333));
 }
 
+void
+GenericLeaseMgrTest::testWipeAllLeases4() {
+    // Get the leases to be used for the test and add to the database
+    vector<Lease4Ptr> leases = createLeases4();
+    for (size_t i = 0; i < leases.size(); ++i) {
+        leases[i]->subnet_id_ = (i % 2 ? 1 : 22);
+        EXPECT_TRUE(lmptr_->addLease(leases[i]));
+    }
+
+    // The subnet 0 stands for all subnets.
+    EXPECT_EQ(leases.size(), lmptr_->wipeLeases4(0));
+    EXPECT_TRUE(lmptr_->getLeases4().empty());
+    EXPECT_EQ(0, lmptr_->wipeLeases4(0));
+}
+
+void
+GenericLeaseMgrTest::testWipeAllLeases6() {
+    // Get the leases to be used for the test and add to the database
+    vector<Lease6Ptr> leases = createLeases6();
+    for (size_t i = 0; i < leases.size(); ++i) {
+        leases[i]->subnet_id_ = (i % 2 ? 1 : 22);
+        EXPECT_TRUE(lmptr_->addLease(leases[i]));
+    }
+
+    // The subnet 0 stands for all subnets.
+    EXPECT_EQ(leases.size(), lmptr_->wipeLeases6(0));
+    EXPECT_TRUE(lmptr_->getLeases6().empty());
+    EXPECT_EQ(0, lmptr_->wipeLeases6(0));
+}
+
+void
+GenericLeaseMgrTest::testBulkLeases4() {
+    vector<Lease4Ptr> leases = createLeases4();
+
+    // Nothing to do.
+    EXPECT_EQ(0, lmptr_->addLeases4(Lease4Collection()));
+    EXPECT_EQ(0, lmptr_->updateLeases4(Lease4Collection()));
+    EXPECT_EQ(0, lmptr_->deleteLeases4(Lease4Collection()));
+
+    // Add some of the leases individually: they must be skipped.
+    EXPECT_TRUE(lmptr_->addLease(leases[0]));
+    EXPECT_TRUE(lmptr_->addLease(leases[3]));
+    Lease4Collection collection(leases.begin(), leases.end());
+    EXPECT_EQ(leases.size() - 2, lmptr_->addLeases4(collection));
+    EXPECT_EQ(0, lmptr_->addLeases4(collection));
+    for (auto const& lease : leases) {
+        Lease4Ptr l_returned = lmptr_->getLease4(lease->addr_);
+        ASSERT_TRUE(l_returned);
+        detailCompareLease(lease, l_returned);
+    }
+
+    // Remove one of the leases individually: it must be skipped by
+    // the update.
+    EXPECT_TRUE(lmptr_->deleteLease(leases[1]));
+    for (auto const& lease : leases) {
+        lease->valid_lft_ *= 2;
+        lease->hostname_ = "modified.hostname.";
+    }
+    EXPECT_EQ(leases.size() - 1, lmptr_->updateLeases4(collection));
+    EXPECT_FALSE(lmptr_->getLease4(leases[1]->addr_));
+    for (size_t i = 0; i < leases.size(); ++i) {
+        if (i == 1) {
+            continue;
+        }
+        Lease4Ptr l_returned = lmptr_->getLease4(leases[i]->addr_);
+        ASSERT_TRUE(l_returned);
+        detailCompareLease(leases[i], l_returned);
+    }
+
+    // Delete all the leases: the removed lease must be skipped.
+    EXPECT_EQ(leases.size() - 1, lmptr_->deleteLeases4(collection));
+    EXPECT_EQ(0, lmptr_->deleteLeases4(collection));
+    for (auto const& lease : leases) {
+        EXPECT_FALSE(lmptr_->getLease4(lease->addr_));
+    }
+}
+
+void
+GenericLeaseMgrTest::testGetLeases6ByAddresses() {
+    vector<Lease6Ptr> leases = createLeases6();
+    leases[1]->type_ = Lease::TYPE_PD;
+
+    // Nothing to do.
+    EXPECT_TRUE(lmptr_->getLeases6ByAddresses(Lease::TYPE_NA,
+                                              vector<IOAddress>()).empty());
+
+    for (auto const& lease : leases) {
+        EXPECT_TRUE(lmptr_->addLease(lease));
+    }
+
+    // The leases of other types and the unknown addresses are skipped.
+    vector<IOAddress> addresses;
+    size_t count = 0;
+    for (auto const& lease : leases) {
+        addresses.push_back(lease->addr_);
+        if (lease->type_ == Lease::TYPE_NA) {
+            ++count;
+        }
+    }
+    addresses.push_back(IOAddress("3001::1"));
+    Lease6Collection returned =
+        lmptr_->getLeases6ByAddresses(Lease::TYPE_NA, addresses);
+    ASSERT_EQ(count, returned.size());
+    for (auto const& lease : returned) {
+        EXPECT_EQ(Lease::TYPE_NA, lease->type_);
+        Lease6Ptr l_returned = lmptr_->getLease6(Lease::TYPE_NA, lease->addr_);
+        ASSERT_TRUE(l_returned);
+        detailCompareLease(l_returned, lease);
+    }
+}
+
+void
+GenericLeaseMgrTest::testBulkLeases6() {
+    vector<Lease6Ptr> leases = createLeases6();
+
+    // Nothing to do.
+    EXPECT_EQ(0, lmptr_->addLeases6(Lease6Collection()));
+    EXPECT_EQ(0, lmptr_->updateLeases6(Lease6Collection()));
+    EXPECT_EQ(0, lmptr_->deleteLeases6(Lease6Collection()));
+
+    // Add some of the leases individually: they must be skipped.
+    EXPECT_TRUE(lmptr_->addLease(leases[0]));
+    EXPECT_TRUE(lmptr_->addLease(leases[3]));
+    Lease6Collection collection(leases.begin(), leases.end());
+    EXPECT_EQ(leases.size() - 2, lmptr_->addLeases6(collection));
+    EXPECT_EQ(0, lmptr_->addLeases6(collection));
+    for (auto const& lease : leases) {
+        Lease6Ptr l_returned = lmptr_->getLease6(lease->type_, lease->addr_);
+        ASSERT_TRUE(l_returned);
+        detailCompareLease(lease, l_returned);
+    }
+
+    // Remove one of the leases individually: it must be skipped by
+    // the update.
+    EXPECT_TRUE(lmptr_->deleteLease(leases[1]));
+    for (auto const& lease : leases) {
+        lease->valid_lft_ *= 2;
+        lease->hostname_ = "modified.hostname.v6.";
+    }
+    EXPECT_EQ(leases.size() - 1, lmptr_->updateLeases6(collection));
+    EXPECT_FALSE(lmptr_->getLease6(leases[1]->type_, leases[1]->addr_));
+    for (size_t i = 0; i < leases.size(); ++i) {
+        if (i == 1) {
+            continue;
+        }
+        Lease6Ptr l_returned = lmptr_->getLease6(leases[i]->type_,
+                                                 leases[i]->addr_);
+        ASSERT_TRUE(l_returned);
+        detailCompareLease(leases[i], l_returned);
+    }
+
+    // Delete all the leases: the removed lease must be skipped.
+    EXPECT_EQ(leases.size() - 1, lmptr_->deleteLeases6(collection));
+    EXPECT_EQ(0, lmptr_->deleteLeases6(collection));
+    for (auto const& lease : leases) {
+        EXPECT_FALSE(lmptr_->getLease6(lease->type_, lease->addr_));
+    }
+}
+
 void
 LeaseMgrDbLostCallbackTest::SetUp() {
     destroySchema();
@@ -263,6 +263,10 @@ public:
     /// @brief Test method which returns range of IPv4 leases with paging.
     void testGetLeases4Paged();
 
+    /// @brief Test that a range of IPv4 leases matching a filter is
+    /// returned with paging.
+    void testGetLeases4PagedFilter();
+
     /// @brief Test method which returns all IPv6 leases for Subnet ID.
     void testGetLeases6SubnetId();
 
@@ -460,6 +464,14 @@ public:
     /// leases can be removed.
     void testDeleteExpiredReclaimedLeases4();
 
+    /// @brief Checks that a batch of expired IPv4 leases is reclaimed.
+    ///
+    /// This creates a number of DHCPv4 leases and marks some of them as
+    /// expired. It verifies that the most expired leases are returned as
+    /// they were before their reclamation, then that they are either
+    /// reclaimed or removed.
+    void testReclaimExpiredLeases4();
+
     /// @brief Check that the IPv4 lease statistics can be recounted
     ///
     /// This test creates two subnets and several leases associated with
@@ -487,6 +499,38 @@ public:
     /// attempts to delete them, one subnet at a time.
     void testWipeLeases6();
 
+    /// @brief Check if wipeLeases4 removes all leases for subnet 0.
+    ///
+    /// This test creates a bunch of leases in several subnets and then
+    /// attempts to delete them all at once.
+    void testWipeAllLeases4();
+
+    /// @brief Check if wipeLeases6 removes all leases for subnet 0.
+    ///
+    /// This test creates a bunch of leases in several subnets and then
+    /// attempts to delete them all at once.
+    void testWipeAllLeases6();
+
+    /// @brief Check the bulk operations on IPv4 leases.
+    ///
+    /// This test adds, updates and deletes a bunch of leases at once
+    /// and checks that the existing leases are skipped by the add and
+    /// the missing leases are skipped by the update and the delete.
+    void testBulkLeases4();
+
+    /// @brief Check the lookup of IPv6 leases by a batch of addresses.
+    ///
+    /// This test checks that the leases of other types and the unknown
+    /// addresses are skipped.
+    void testGetLeases6ByAddresses();
+
+    /// @brief Check the bulk operations on IPv6 leases.
+    ///
+    /// This test adds, updates and deletes a bunch of leases at once
+    /// and checks that the existing leases are skipped by the add and
+    /// the missing leases are skipped by the update and the delete.
+    void testBulkLeases6();
+
     /// @brief Checks operation of v4 LeaseStatsQuery variants
     ///
     /// It creates three subnets with leases in various states in
@@ -0,0 +1,138 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/global_host_replica.h>
+#include <dhcpsrv/subnet_id.h>
+#include <dhcpsrv/testutils/host_data_source_utils.h>
+#include <dhcpsrv/testutils/memory_host_data_source.h>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace isc;
+using namespace isc::dhcp;
+using namespace isc::dhcp::test;
+
+namespace {
+
+/// @brief Test fixture for exercising GlobalHostReplica.
+class GlobalHostReplicaTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    GlobalHostReplicaTest() : source_(new MemHostDataSource()) {
+        sources_.push_back(source_);
+    }
+
+    /// @brief Creates a host with an IPv4 reservation.
+    ///
+    /// @param address the reserved address.
+    /// @param subnet_id the IPv4 subnet identifier.
+    HostPtr createHost4(const string& address, SubnetID subnet_id) {
+        HostPtr host = HostDataSourceUtils::initializeHost4(address,
+                                                            Host::IDENT_HWADDR);
+        host->setIPv4SubnetID(subnet_id);
+        host->setIPv6SubnetID(SUBNET_ID_UNUSED);
+        return (host);
+    }
+
+    /// @brief Looks for the IPv4 reservation of a host in the replica.
+    ///
+    /// @param replica the replica.
+    /// @param host the host to look for.
+    ConstHostPtr get4(const GlobalHostReplica& replica,
+                      const ConstHostPtr& host) {
+        return (replica.get4(host->getIdentifierType(),
+                             &host->getIdentifier()[0],
+                             host->getIdentifier().size()));
+    }
+
+    /// @brief The host backend.
+    MemHostDataSourcePtr source_;
+
+    /// @brief The host backends given to the replica.
+    HostDataSourceList sources_;
+};
+
+// Verifies that only the global reservations are loaded, through as
+// many pages as needed.
+TEST_F(GlobalHostReplicaTest, load) {
+    GlobalHostReplica replica;
+    EXPECT_FALSE(replica.isLoaded());
+
+    HostPtr subnet_host = createHost4("192.0.2.1", 1);
+    source_->add(subnet_host);
+    vector<HostPtr> hosts;
+    for (size_t i = 0; i < GlobalHostReplica::PAGE_SIZE + 2; ++i) {
+        HostPtr host = createHost4("10.0.0.1", SUBNET_ID_GLOBAL);
+        source_->add(host);
+        hosts.push_back(host);
+    }
+
+    // Nothing is answered before the load.
+    EXPECT_FALSE(get4(replica, hosts[0]));
+
+    ASSERT_NO_THROW(replica.load(sources_));
+    EXPECT_TRUE(replica.isLoaded());
+    EXPECT_EQ(hosts.size(), replica.size4());
+    EXPECT_EQ(0, replica.size6());
+    EXPECT_EQ(hosts[0], get4(replica, hosts[0]));
+    EXPECT_EQ(hosts.back(), get4(replica, hosts.back()));
+    EXPECT_FALSE(get4(replica, subnet_host));
+
+    // The IPv6 lookups do not see the IPv4 only hosts.
+    EXPECT_FALSE(replica.get6(hosts[0]->getIdentifierType(),
+                              &hosts[0]->getIdentifier()[0],
+                              hosts[0]->getIdentifier().size()));
+
+    // A reload replaces the content.
+    source_->del4(SUBNET_ID_GLOBAL, hosts[0]->getIdentifierType(),
+                  &hosts[0]->getIdentifier()[0],
+                  hosts[0]->getIdentifier().size());
+    ASSERT_NO_THROW(replica.load(sources_));
+    EXPECT_EQ(hosts.size() - 1, replica.size4());
+    EXPECT_FALSE(get4(replica, hosts[0]));
+}
+
+// Verifies the updates of the replica.
+TEST_F(GlobalHostReplicaTest, addDel) {
+    GlobalHostReplica replica;
+    HostPtr host = createHost4("192.0.2.1", SUBNET_ID_GLOBAL);
+
+    // Updates are ignored until the replica is loaded.
+    replica.add(host);
+    EXPECT_FALSE(get4(replica, host));
+
+    ASSERT_NO_THROW(replica.load(sources_));
+    EXPECT_EQ(0, replica.size4());
+    replica.add(host);
+    EXPECT_EQ(host, get4(replica, host));
+
+    // A host which is not global is ignored.
+    HostPtr subnet_host = createHost4("192.0.2.2", 1);
+    replica.add(subnet_host);
+    EXPECT_FALSE(get4(replica, subnet_host));
+    EXPECT_EQ(1, replica.size4());
+
+    // The host is replaced.
+    HostPtr copy(new Host(*host));
+    replica.add(copy);
+    EXPECT_EQ(1, replica.size4());
+    EXPECT_EQ(copy, get4(replica, host));
+
+    EXPECT_FALSE(replica.del6(host->getIdentifierType(),
+                              &host->getIdentifier()[0],
+                              host->getIdentifier().size()));
+    EXPECT_TRUE(replica.del4(host->getIdentifierType(),
+                             &host->getIdentifier()[0],
+                             host->getIdentifier().size()));
+    EXPECT_FALSE(get4(replica, host));
+    EXPECT_EQ(0, replica.size4());
+}
+
+} // end of anonymous namespace
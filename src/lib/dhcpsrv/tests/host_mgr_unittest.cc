@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -128,6 +128,13 @@ TEST_F(HostMgrTest, get4) {
     testGet4(*getCfgHosts());
 }
 
+// This test verifies that HostMgr returns the reservation of the most
+// preferred identifier. The reservations are specified in the server's
+// configuration.
+TEST_F(HostMgrTest, get4ByIdentifiers) {
+    testGet4ByIdentifiers(*getCfgHosts());
+}
+
 // This test verifies handling of negative caching by get4/get4Any.
 TEST_F(HostMgrTest, get4Any) {
     testGet4Any();
@@ -140,6 +147,13 @@ TEST_F(HostMgrTest, get6) {
     testGet6(*getCfgHosts());
 }
 
+// This test verifies that HostMgr returns the IPv6 reservation of the most
+// preferred identifier. The reservations are specified in the server's
+// configuration.
+TEST_F(HostMgrTest, get6ByIdentifiers) {
+    testGet6ByIdentifiers(*getCfgHosts());
+}
+
 // This test verifies handling of negative caching by get4/get4Any.
 TEST_F(HostMgrTest, get6Any) {
     testGet6Any();
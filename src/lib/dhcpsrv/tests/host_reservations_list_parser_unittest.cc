@@ -16,10 +16,12 @@
 #include <dhcpsrv/subnet_id.h>
 #include <dhcpsrv/parsers/dhcp_parsers.h>
 #include <dhcpsrv/parsers/host_reservation_parser.h>
+#include <dhcpsrv/parsers/host_reservations_bulk_parser.h>
 #include <dhcpsrv/parsers/host_reservations_list_parser.h>
 #include <testutils/test_to_element.h>
 #include <boost/algorithm/string.hpp>
 #include <gtest/gtest.h>
+#include <iomanip>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -385,4 +387,64 @@ TEST_F(HostReservationsListParserTest, duplicatedIdentifierValue6) {
     }
 }
 
+// This test verifies that the bulk parser parses the reservations in the
+// JSON lines format with several threads and keeps the input order.
+TEST_F(HostReservationsListParserTest, bulkReservations4) {
+    CfgMgr::instance().setFamily(AF_INET);
+    std::ostringstream input;
+    input << "# comment\n"
+          << "{ \"hw-address\": \"01:02:03:04:05:06\","
+          << "  \"ip-address\": \"192.0.2.134\", \"subnet-id\": 1 }\n"
+          << "\n";
+    for (int i = 0; i < 100; ++i) {
+        input << "{ \"duid\": \"01:02:03:04:05:" << std::hex << std::setw(2)
+              << std::setfill('0') << i << std::dec
+              << "\", \"hostname\": \"host" << i << "\" }\n";
+    }
+
+    HostCollection hosts;
+    HostReservationsBulkParser<HostReservationParser4> parser(4);
+    EXPECT_EQ(4, parser.getThreadCount());
+    std::istringstream stream(input.str());
+    ASSERT_NO_THROW(parser.parse(stream, hosts));
+    ASSERT_EQ(101, hosts.size());
+
+    EXPECT_EQ(1, hosts[0]->getIPv4SubnetID());
+    EXPECT_EQ("192.0.2.134", hosts[0]->getIPv4Reservation().toText());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(hosts[i + 1]);
+        EXPECT_EQ(SUBNET_ID_GLOBAL, hosts[i + 1]->getIPv4SubnetID());
+        EXPECT_EQ("host" + std::to_string(i), hosts[i + 1]->getHostname());
+    }
+}
+
+// This test verifies that the bulk parser reports the first invalid line
+// and returns no host.
+TEST_F(HostReservationsListParserTest, bulkReservationsInvalid6) {
+    CfgMgr::instance().setFamily(AF_INET6);
+    HostReservationsBulkParser<HostReservationParser6> parser(2);
+
+    std::istringstream stream("{ \"duid\": \"01:02:03\" }\n"
+                              "{ \"duid\": \"01:02:04\", \"foo\": 1 }\n"
+                              "[ 1 ]\n");
+    HostCollection hosts;
+    try {
+        parser.parse(stream, hosts);
+        ADD_FAILURE() << "expected DhcpConfigError";
+    } catch (const DhcpConfigError& ex) {
+        EXPECT_NE(std::string::npos,
+                  std::string(ex.what()).find("at line 2:"));
+    }
+    EXPECT_TRUE(hosts.empty());
+
+    std::istringstream bad_subnet("{ \"duid\": \"01:02:03\","
+                                  " \"subnet-id\": -1 }\n");
+    EXPECT_THROW(parser.parse(bad_subnet, hosts), DhcpConfigError);
+
+    // An empty input gives no host.
+    std::istringstream empty("\n# nothing\n");
+    EXPECT_NO_THROW(parser.parse(empty, hosts));
+    EXPECT_TRUE(hosts.empty());
+}
+
 } // end of anonymous namespace
@@ -0,0 +1,92 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcpsrv/identifier_pool.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace isc;
+using namespace isc::dhcp;
+
+namespace {
+
+// Test that equal DUIDs are interned once.
+TEST(IdentifierPoolTest, duid) {
+    IdentifierPool<DUID> pool;
+
+    DuidPtr duid(new DUID(std::vector<uint8_t>(8, 1)));
+    DuidPtr duid_copy(new DUID(std::vector<uint8_t>(8, 1)));
+    DuidPtr other(new DUID(std::vector<uint8_t>(8, 2)));
+
+    EXPECT_EQ(duid, pool.intern(duid));
+    EXPECT_EQ(duid, pool.intern(duid_copy));
+    EXPECT_EQ(other, pool.intern(other));
+    EXPECT_EQ(2, pool.size());
+
+    // Null pointers are not interned.
+    EXPECT_FALSE(pool.intern(DuidPtr()));
+    EXPECT_EQ(2, pool.size());
+}
+
+// Test that equal client identifiers are interned once.
+TEST(IdentifierPoolTest, clientId) {
+    IdentifierPool<ClientId> pool;
+
+    ClientIdPtr client_id(new ClientId(std::vector<uint8_t>(4, 1)));
+    ClientIdPtr client_id_copy(new ClientId(std::vector<uint8_t>(4, 1)));
+
+    EXPECT_EQ(client_id, pool.intern(client_id));
+    EXPECT_EQ(client_id, pool.intern(client_id_copy));
+    EXPECT_EQ(1, pool.size());
+}
+
+// Test that the hardware addresses are shared only when their types
+// and sources are equal.
+TEST(IdentifierPoolTest, hwaddr) {
+    IdentifierPool<HWAddr> pool;
+
+    std::vector<uint8_t> mac(6, 1);
+    HWAddrPtr hwaddr(new HWAddr(mac, HTYPE_ETHER));
+    HWAddrPtr hwaddr_copy(new HWAddr(mac, HTYPE_ETHER));
+    HWAddrPtr other_type(new HWAddr(mac, HTYPE_FDDI));
+    HWAddrPtr other_source(new HWAddr(mac, HTYPE_ETHER));
+    other_source->source_ = HWAddr::HWADDR_SOURCE_RAW;
+
+    EXPECT_EQ(hwaddr, pool.intern(hwaddr));
+    EXPECT_EQ(hwaddr, pool.intern(hwaddr_copy));
+    EXPECT_EQ(other_type, pool.intern(other_type));
+    EXPECT_EQ(other_source, pool.intern(other_source));
+    EXPECT_EQ(3, pool.size());
+}
+
+// Test that the identifiers referenced only by the pool are purged.
+TEST(IdentifierPoolTest, purge) {
+    IdentifierPool<DUID> pool;
+
+    DuidPtr duid(new DUID(std::vector<uint8_t>(8, 1)));
+    static_cast<void>(pool.intern(duid));
+    static_cast<void>(pool.intern(DuidPtr(new DUID(std::vector<uint8_t>(8, 2)))));
+    EXPECT_EQ(2, pool.size());
+
+    pool.purge();
+    EXPECT_EQ(1, pool.size());
+    EXPECT_EQ(duid, pool.intern(DuidPtr(new DUID(std::vector<uint8_t>(8, 1)))));
+
+    // The pool purges itself when it grows.
+    for (size_t i = 0; i < 4 * IdentifierPool<DUID>::MIN_PURGE_SIZE; ++i) {
+        std::vector<uint8_t> value(8, 3);
+        value[0] = static_cast<uint8_t>(i);
+        value[1] = static_cast<uint8_t>(i >> 8);
+        static_cast<void>(pool.intern(DuidPtr(new DUID(value))));
+    }
+    EXPECT_LE(pool.size(), IdentifierPool<DUID>::MIN_PURGE_SIZE + 1);
+
+    pool.clear();
+    EXPECT_EQ(0, pool.size());
+}
+
+} // end of anonymous namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,12 +11,14 @@
 #include <dhcpsrv/cfgmgr.h>
 #include <dhcpsrv/parsers/ifaces_config_parser.h>
 #include <testutils/test_to_element.h>
+#include <util/fd_event_handler.h>
 #include <gtest/gtest.h>
 
 using namespace isc::data;
 using namespace isc::dhcp;
 using namespace isc::dhcp::test;
 using namespace isc::test;
+using namespace isc::util;
 
 namespace {
 
@@ -389,4 +391,80 @@ TEST_F(IfacesConfigParserTest, serviceSocketRetryWaitTimeWithoutMaxRetries) {
     runToElementTest<CfgIface>(expected_config, *cfg_iface);
 }
 
+// Tests that accepted-relays is parsed properly.
+TEST_F(IfacesConfigParserTest, acceptedRelays) {
+    std::string config = "{ \"interfaces\": [ ],"
+        " \"re-detect\": false,"
+        " \"accepted-relays\": [ \"192.0.2.0/24\", \"10.0.0.0/8\" ] }";
+
+    ElementPtr config_element = Element::fromJSON(config);
+
+    // Parse the configuration.
+    IfacesConfigParser parser(AF_INET, false);
+    CfgIfacePtr cfg_iface = CfgMgr::instance().getStagingCfg()->getCfgIface();
+    ASSERT_TRUE(cfg_iface);
+    ASSERT_NO_THROW(parser.parse(cfg_iface, config_element));
+    const RelayPrefixes& relays = cfg_iface->getAcceptedRelays();
+    ASSERT_EQ(2, relays.size());
+    EXPECT_EQ("192.0.2.0", relays[0].first.toText());
+    EXPECT_EQ(24, relays[0].second);
+    EXPECT_EQ("10.0.0.0", relays[1].first.toText());
+    EXPECT_EQ(8, relays[1].second);
+
+    // Check it can be unparsed.
+    runToElementTest<CfgIface>(config, *cfg_iface);
+
+    // DHCPv6 does not support it.
+    IfacesConfigParser parser6(AF_INET6, false);
+    cfg_iface.reset(new CfgIface());
+    EXPECT_THROW(parser6.parse(cfg_iface, config_element), DhcpConfigError);
+
+    // Invalid prefixes are rejected.
+    std::vector<std::string> invalid = { "\"192.0.2.0\"", "\"192.0.2.0/\"",
+                                         "\"192.0.2.0/33\"", "\"192.0.2.0/x\"",
+                                         "\"foo/24\"", "\"2001:db8::/32\"" };
+    for (auto const& prefix : invalid) {
+        SCOPED_TRACE(prefix);
+        config = "{ \"interfaces\": [ ],"
+            " \"re-detect\": false,"
+            " \"accepted-relays\": [ " + prefix + " ] }";
+        config_element = Element::fromJSON(config);
+        cfg_iface.reset(new CfgIface());
+        EXPECT_THROW(parser.parse(cfg_iface, config_element), DhcpConfigError);
+    }
+}
+
+// Tests that event-handler-type is parsed properly.
+TEST_F(IfacesConfigParserTest, eventHandlerType) {
+    std::string config = "{ \"interfaces\": [ ],"
+        " \"re-detect\": false,"
+        " \"event-handler-type\": \"epoll\" }";
+
+    ElementPtr config_element = Element::fromJSON(config);
+
+    // Parse the configuration for both families.
+    IfacesConfigParser parser(AF_INET, false);
+    CfgIfacePtr cfg_iface = CfgMgr::instance().getStagingCfg()->getCfgIface();
+    ASSERT_TRUE(cfg_iface);
+    EXPECT_EQ(FDEventHandler::TYPE_UNKNOWN, cfg_iface->getEventHandlerType());
+    ASSERT_NO_THROW(parser.parse(cfg_iface, config_element));
+    EXPECT_EQ(FDEventHandler::TYPE_EPOLL, cfg_iface->getEventHandlerType());
+
+    // Check it can be unparsed.
+    runToElementTest<CfgIface>(config, *cfg_iface);
+
+    IfacesConfigParser parser6(AF_INET6, false);
+    cfg_iface.reset(new CfgIface());
+    ASSERT_NO_THROW(parser6.parse(cfg_iface, config_element));
+    EXPECT_EQ(FDEventHandler::TYPE_EPOLL, cfg_iface->getEventHandlerType());
+
+    // Unsupported types are rejected.
+    config = "{ \"interfaces\": [ ],"
+        " \"re-detect\": false,"
+        " \"event-handler-type\": \"poll\" }";
+    config_element = Element::fromJSON(config);
+    cfg_iface.reset(new CfgIface());
+    EXPECT_THROW(parser.parse(cfg_iface, config_element), DhcpConfigError);
+}
+
 } // end of anonymous namespace
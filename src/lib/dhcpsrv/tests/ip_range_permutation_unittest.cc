@@ -5,6 +5,7 @@
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include <config.h>
+#include <asiolink/addr_utilities.h>
 #include <dhcpsrv/ip_range_permutation.h>
 
 #include <gtest/gtest.h>
@@ -201,4 +202,129 @@ TEST(IPRangePermutationTest, reset) {
     EXPECT_EQ(11, addrs.size());
 }
 
+// This test verifies that a permutation of IPv4 address range can
+// be generated in the Feistel mode.
+TEST(IPRangePermutationTest, feistelIpv4) {
+    // Create address range with 91 addresses.
+    AddressRange range(IOAddress("192.0.2.10"), IOAddress("192.0.2.100"));
+    IPRangePermutation perm(range, IPRangePermutation::FEISTEL);
+    EXPECT_EQ(IPRangePermutation::FEISTEL, perm.getMode());
+
+    std::set<IOAddress> addrs;
+    bool done = false;
+    for (auto i = 0; i < 95; ++i) {
+        auto next = perm.next(done);
+        if (!next.isV4Zero()) {
+            EXPECT_LE(range.start_, next);
+            EXPECT_LE(next, range.end_);
+        }
+        if (i >= 90) {
+            EXPECT_TRUE(done);
+            EXPECT_TRUE(perm.exhausted());
+        } else {
+            EXPECT_FALSE(done);
+            EXPECT_FALSE(perm.exhausted());
+        }
+        addrs.insert(next);
+    }
+
+    // We should have recorded 92 unique addresses, including the zero address.
+    EXPECT_EQ(92, addrs.size());
+    EXPECT_TRUE(addrs.begin()->isV4Zero());
+}
+
+// This test verifies that the Feistel mode covers the ranges with a size
+// being a power of two and the ranges with a single address.
+TEST(IPRangePermutationTest, feistelSizes) {
+    for (auto last : { "192.0.2.0", "192.0.2.1", "192.0.2.2", "192.0.2.255", "192.0.3.255" }) {
+        AddressRange range(IOAddress("192.0.2.0"), IOAddress(last));
+        IPRangePermutation perm(range, IPRangePermutation::FEISTEL);
+        auto size = addrsInRange(range.start_, range.end_);
+
+        std::set<IOAddress> addrs;
+        bool done = false;
+        while (!done) {
+            auto next = perm.next(done);
+            ASSERT_FALSE(next.isV4Zero()) << last;
+            EXPECT_LE(range.start_, next);
+            EXPECT_LE(next, range.end_);
+            addrs.insert(next);
+            ASSERT_LE(addrs.size(), size) << last;
+        }
+        EXPECT_EQ(size, addrs.size()) << last;
+    }
+}
+
+// This test verifies that a permutation of delegated prefixes can be
+// generated in the Feistel mode.
+TEST(IPRangePermutationTest, feistelPd) {
+    PrefixRange range(IOAddress("3000::"), 112, 120);
+    IPRangePermutation perm(range, IPRangePermutation::FEISTEL);
+
+    std::set<IOAddress> addrs;
+    bool done = false;
+    for (auto i = 0; i < 257; ++i) {
+        auto next = perm.next(done);
+        if (!next.isV6Zero()) {
+            EXPECT_LE(range.start_, next);
+            EXPECT_LE(next, range.end_);
+        }
+        if (i >= 255) {
+            EXPECT_TRUE(done);
+            EXPECT_TRUE(perm.exhausted());
+        } else {
+            EXPECT_FALSE(done);
+            EXPECT_FALSE(perm.exhausted());
+        }
+        addrs.insert(next);
+    }
+
+    // We should have recorded 257 unique prefixes, including the zero address.
+    EXPECT_EQ(257, addrs.size());
+    EXPECT_TRUE(addrs.begin()->isV6Zero());
+}
+
+// This test verifies that the Feistel mode can serve addresses from a
+// /64 range.
+TEST(IPRangePermutationTest, feistelHuge) {
+    AddressRange range(IOAddress("2001:db8:1::"), IOAddress("2001:db8:1::ffff:ffff:ffff:ffff"));
+    IPRangePermutation perm(range, IPRangePermutation::FEISTEL);
+
+    std::set<IOAddress> addrs;
+    bool done = false;
+    for (auto i = 0; i < 10000; ++i) {
+        auto next = perm.next(done);
+        EXPECT_FALSE(done);
+        EXPECT_LE(range.start_, next);
+        EXPECT_LE(next, range.end_);
+        addrs.insert(next);
+    }
+    EXPECT_EQ(10000, addrs.size());
+}
+
+// This test verifies that it is possible to reset the permutation state
+// in the Feistel mode.
+TEST(IPRangePermutationTest, feistelReset) {
+    // Create address range with 11 addresses.
+    AddressRange range(IOAddress("192.0.2.10"), IOAddress("192.0.2.20"));
+    IPRangePermutation perm(range, IPRangePermutation::FEISTEL);
+
+    bool done = false;
+    for (auto i = 0; i < 5; ++i) {
+        EXPECT_FALSE(perm.next(done).isV4Zero());
+    }
+
+    // Reset the permutation. We should be able to get all addresses again.
+    perm.reset();
+
+    std::set<IOAddress> addrs;
+    for (auto i = 0; i < 11; ++i) {
+        auto next = perm.next(done);
+        EXPECT_FALSE(next.isV4Zero());
+        addrs.insert(next);
+    }
+    EXPECT_TRUE(done);
+    EXPECT_EQ(11, addrs.size());
+}
+
 } // end of anonymous namespace
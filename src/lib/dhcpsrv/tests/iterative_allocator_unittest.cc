@@ -7,6 +7,7 @@
 #include <config.h>
 #include <asiolink/io_address.h>
 #include <dhcpsrv/iterative_allocator.h>
+#include <dhcpsrv/lease_mgr_factory.h>
 #include <dhcpsrv/tests/alloc_engine_utils.h>
 #include <gtest/gtest.h>
 #include <sstream>
@@ -115,6 +116,43 @@ TEST_F(IterativeAllocatorTest4, manyPools) {
     }
 }
 
+// This test verifies that the occupancy filter tracks the addresses
+// of the valid leases.
+TEST_F(IterativeAllocatorTest4, occupancyFilter) {
+    NakedIterativeAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    // Without the filter no address is known to be in use.
+    Lease4Ptr lease(new Lease4(IOAddress("192.0.2.105"), hwaddr_, ClientIdPtr(),
+                               3600, time(0), subnet_->getID()));
+    EXPECT_TRUE(lease_mgr.addLease(lease));
+    EXPECT_FALSE(alloc.isInUse(IOAddress("192.0.2.105")));
+
+    // The filter is populated from the lease database.
+    ASSERT_NO_THROW(alloc.initOccupancyFilter());
+    EXPECT_TRUE(alloc.isInUse(IOAddress("192.0.2.105")));
+    EXPECT_FALSE(alloc.isInUse(IOAddress("192.0.2.106")));
+
+    // The filter is updated when leases are added.
+    Lease4Ptr lease2(new Lease4(IOAddress("192.0.2.106"), hwaddr2_, ClientIdPtr(),
+                                3600, time(0), subnet_->getID()));
+    EXPECT_TRUE(lease_mgr.addLease(lease2));
+    EXPECT_TRUE(alloc.isInUse(IOAddress("192.0.2.106")));
+
+    // Reclaimed leases are free.
+    lease->state_ = Lease::STATE_EXPIRED_RECLAIMED;
+    EXPECT_NO_THROW(lease_mgr.updateLease4(lease));
+    EXPECT_FALSE(alloc.isInUse(IOAddress("192.0.2.105")));
+
+    // Deleted leases are free.
+    EXPECT_TRUE(lease_mgr.deleteLease(lease2));
+    EXPECT_FALSE(alloc.isInUse(IOAddress("192.0.2.106")));
+
+    // Addresses out of the pools are never known to be in use.
+    EXPECT_FALSE(alloc.isInUse(IOAddress("192.0.2.1")));
+}
+
 using IterativeAllocatorTest6 = AllocEngine6Test;
 
 // Test that the allocator returns the correct type.
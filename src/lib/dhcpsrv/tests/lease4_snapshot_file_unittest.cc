@@ -0,0 +1,161 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcpsrv/lease4_snapshot_file.h>
+#include <dhcpsrv/testutils/lease_file_io.h>
+#include <dhcpsrv/testutils/test_utils.h>
+#include <gtest/gtest.h>
+#include <boost/scoped_ptr.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::dhcp::test;
+
+namespace {
+
+/// @brief Test fixture class for @c Lease4SnapshotFile.
+class Lease4SnapshotFileTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Creates the source lease file and fills the storage.
+    Lease4SnapshotFileTest()
+        : source_(absolutePath("leases4.csv")), source_io_(source_),
+          filename_(absolutePath("leases4.csv.snapshot")), io_(filename_) {
+        source_io_.writeFile("address,hwaddr\n");
+        std::vector<std::string> sources;
+        sources.push_back(absolutePath("leases4.csv.1"));
+        sources.push_back(source_);
+        file_.reset(new Lease4SnapshotFile(filename_, sources));
+
+        addLease("192.0.2.1", 1);
+        addLease("192.0.2.2", 2);
+        Lease4Ptr lease = addLease("192.0.2.3", 3);
+        lease->client_id_ = ClientId::fromText("01:02:03:04");
+        lease->hostname_ = "host.example.org";
+        lease->fqdn_fwd_ = true;
+        lease->state_ = Lease::STATE_DECLINED;
+        lease->setContext(Element::fromJSON("{ \"foo\": \"bar\" }"));
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Removes the files.
+    virtual ~Lease4SnapshotFileTest() {
+        source_io_.removeFile();
+        io_.removeFile();
+    }
+
+    /// @brief Prepends the directory of the test data to a file name.
+    ///
+    /// @param filename Name of the file.
+    static std::string absolutePath(const std::string& filename) {
+        std::ostringstream s;
+        s << DHCP_DATA_DIR << "/" << filename;
+        return (s.str());
+    }
+
+    /// @brief Adds a lease to the storage.
+    ///
+    /// @param addr Lease address.
+    /// @param subnet_id Subnet identifier.
+    /// @return The added lease.
+    Lease4Ptr addLease(const std::string& addr, SubnetID subnet_id) {
+        HWAddrPtr hwaddr(new HWAddr(std::vector<uint8_t>(6, subnet_id),
+                                    HTYPE_ETHER));
+        Lease4Ptr lease(new Lease4(IOAddress(addr), hwaddr, ClientIdPtr(),
+                                   3600, 1000, subnet_id));
+        storage_.insert(lease);
+        return (lease);
+    }
+
+    /// @brief Name of the source lease file.
+    std::string source_;
+
+    /// @brief Source lease file IO.
+    LeaseFileIO source_io_;
+
+    /// @brief Name of the lease snapshot file.
+    std::string filename_;
+
+    /// @brief Lease snapshot file IO.
+    LeaseFileIO io_;
+
+    /// @brief The lease snapshot file.
+    boost::scoped_ptr<Lease4SnapshotFile> file_;
+
+    /// @brief The lease storage.
+    Lease4Storage storage_;
+};
+
+// Checks that the leases are restored from the file.
+TEST_F(Lease4SnapshotFileTest, writeRead) {
+    ASSERT_NO_THROW(file_->write(storage_));
+
+    Lease4Storage storage;
+    ASSERT_TRUE(file_->read(storage)) << file_->getReadMsg();
+    ASSERT_EQ(storage_.size(), storage.size());
+    for (auto const& lease : storage_) {
+        auto it = storage.find(lease->addr_);
+        ASSERT_TRUE(it != storage.end()) << lease->addr_.toText();
+        detailCompareLease(lease, *it);
+    }
+
+    // The subnet index is usable.
+    const Lease4StorageSubnetIdIndex& idx = storage.get<SubnetIdIndexTag>();
+    EXPECT_EQ(1, idx.count(2));
+
+    // An empty storage is restored too.
+    ASSERT_NO_THROW(file_->write(Lease4Storage()));
+    storage_.clear();
+    EXPECT_TRUE(file_->read(storage_)) << file_->getReadMsg();
+    EXPECT_TRUE(storage_.empty());
+}
+
+// Checks that the leases are not restored when the file is missing.
+TEST_F(Lease4SnapshotFileTest, missing) {
+    EXPECT_FALSE(file_->read(storage_));
+    EXPECT_EQ("no such file", file_->getReadMsg());
+    EXPECT_TRUE(storage_.empty());
+}
+
+// Checks that the leases are not restored when a lease file changed.
+TEST_F(Lease4SnapshotFileTest, stale) {
+    ASSERT_NO_THROW(file_->write(storage_));
+    source_io_.writeFile("address,hwaddr\n192.0.2.4,01:02:03:04:05:06\n");
+
+    EXPECT_FALSE(file_->read(storage_));
+    EXPECT_EQ("the lease files were modified", file_->getReadMsg());
+    EXPECT_TRUE(storage_.empty());
+
+    // A source file that appeared since the write also invalidates the file.
+    source_io_.writeFile("address,hwaddr\n");
+    ASSERT_NO_THROW(file_->write(storage_));
+    LeaseFileIO copy_io(absolutePath("leases4.csv.1"));
+    copy_io.writeFile("address,hwaddr\n");
+    EXPECT_FALSE(file_->read(storage_));
+    copy_io.removeFile();
+}
+
+// Checks that a truncated file is rejected.
+TEST_F(Lease4SnapshotFileTest, truncated) {
+    ASSERT_NO_THROW(file_->write(storage_));
+    std::string content = io_.readFile();
+    io_.writeFile(content.substr(0, content.size() - 3));
+
+    EXPECT_FALSE(file_->read(storage_));
+    EXPECT_TRUE(storage_.empty());
+}
+
+} // end of anonymous namespace
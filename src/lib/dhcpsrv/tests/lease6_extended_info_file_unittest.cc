@@ -0,0 +1,156 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcpsrv/lease6_extended_info_file.h>
+#include <dhcpsrv/testutils/lease_file_io.h>
+#include <gtest/gtest.h>
+#include <boost/scoped_ptr.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+using namespace isc::dhcp::test;
+
+namespace {
+
+/// @brief Test fixture class for @c Lease6ExtendedInfoFile.
+class Lease6ExtendedInfoFileTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Creates the source lease file and fills the tables.
+    Lease6ExtendedInfoFileTest()
+        : source_(absolutePath("leases6.csv")), source_io_(source_),
+          filename_(absolutePath("leases6.csv.xinfo")), io_(filename_) {
+        source_io_.writeFile("address,duid\n");
+        std::vector<std::string> sources;
+        sources.push_back(absolutePath("leases6.csv.1"));
+        sources.push_back(source_);
+        file_.reset(new Lease6ExtendedInfoFile(filename_, sources));
+
+        addEntry(relay_id6_, "2001:db8::1", std::vector<uint8_t>(8, 1));
+        addEntry(relay_id6_, "2001:db8::2", std::vector<uint8_t>(8, 1));
+        addEntry(remote_id6_, "2001:db8::1", std::vector<uint8_t>(4, 2));
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Removes the files.
+    virtual ~Lease6ExtendedInfoFileTest() {
+        source_io_.removeFile();
+        io_.removeFile();
+    }
+
+    /// @brief Prepends the directory of the test data to a file name.
+    ///
+    /// @param filename Name of the file.
+    static std::string absolutePath(const std::string& filename) {
+        std::ostringstream s;
+        s << DHCP_DATA_DIR << "/" << filename;
+        return (s.str());
+    }
+
+    /// @brief Adds an entry to a table.
+    ///
+    /// @param table The table.
+    /// @param addr Lease address.
+    /// @param id Identifier.
+    template<typename TableType>
+    static void addEntry(TableType& table, const std::string& addr,
+                         const std::vector<uint8_t>& id) {
+        Lease6ExtendedInfoPtr ex_info(new Lease6ExtendedInfo(IOAddress(addr), id));
+        table.insert(ex_info);
+    }
+
+    /// @brief Name of the source lease file.
+    std::string source_;
+
+    /// @brief Source lease file IO.
+    LeaseFileIO source_io_;
+
+    /// @brief Name of the extended info tables file.
+    std::string filename_;
+
+    /// @brief Extended info tables file IO.
+    LeaseFileIO io_;
+
+    /// @brief The extended info tables file.
+    boost::scoped_ptr<Lease6ExtendedInfoFile> file_;
+
+    /// @brief The by-relay-id table.
+    Lease6ExtendedInfoRelayIdTable relay_id6_;
+
+    /// @brief The by-remote-id table.
+    Lease6ExtendedInfoRemoteIdTable remote_id6_;
+};
+
+// Checks that the tables are restored from the file.
+TEST_F(Lease6ExtendedInfoFileTest, writeRead) {
+    ASSERT_NO_THROW(file_->write(relay_id6_, remote_id6_));
+
+    Lease6ExtendedInfoRelayIdTable relay_id6;
+    Lease6ExtendedInfoRemoteIdTable remote_id6;
+    ASSERT_TRUE(file_->read(relay_id6, remote_id6)) << file_->getReadMsg();
+    ASSERT_EQ(2, relay_id6.size());
+    ASSERT_EQ(1, remote_id6.size());
+
+    const RelayIdIndex& relay_idx = relay_id6.get<RelayIdIndexTag>();
+    auto it = relay_idx.begin();
+    EXPECT_EQ("2001:db8::1", (*it)->lease_addr_.toText());
+    EXPECT_EQ(std::vector<uint8_t>(8, 1), (*it)->id_);
+    ++it;
+    EXPECT_EQ("2001:db8::2", (*it)->lease_addr_.toText());
+
+    const RemoteIdIndex& remote_idx = remote_id6.get<RemoteIdIndexTag>();
+    RemoteIdIndexRange range = remote_idx.equal_range(std::vector<uint8_t>(4, 2));
+    ASSERT_EQ(1, std::distance(range.first, range.second));
+    EXPECT_EQ("2001:db8::1", (*range.first)->lease_addr_.toText());
+}
+
+// Checks that the tables are not restored when the file is missing.
+TEST_F(Lease6ExtendedInfoFileTest, missing) {
+    EXPECT_FALSE(file_->read(relay_id6_, remote_id6_));
+    EXPECT_TRUE(relay_id6_.empty());
+    EXPECT_TRUE(remote_id6_.empty());
+}
+
+// Checks that the tables are not restored when a lease file changed.
+TEST_F(Lease6ExtendedInfoFileTest, stale) {
+    ASSERT_NO_THROW(file_->write(relay_id6_, remote_id6_));
+    source_io_.writeFile("address,duid\n2001:db8::3,01:02\n");
+
+    EXPECT_FALSE(file_->read(relay_id6_, remote_id6_));
+    EXPECT_EQ("the lease files were modified", file_->getReadMsg());
+    EXPECT_TRUE(relay_id6_.empty());
+    EXPECT_TRUE(remote_id6_.empty());
+
+    // A source file that appeared since the write also invalidates the file.
+    source_io_.writeFile("address,duid\n");
+    ASSERT_NO_THROW(file_->write(relay_id6_, remote_id6_));
+    LeaseFileIO copy_io(absolutePath("leases6.csv.1"));
+    copy_io.writeFile("address,duid\n");
+    EXPECT_FALSE(file_->read(relay_id6_, remote_id6_));
+    copy_io.removeFile();
+}
+
+// Checks that a truncated file is rejected.
+TEST_F(Lease6ExtendedInfoFileTest, truncated) {
+    ASSERT_NO_THROW(file_->write(relay_id6_, remote_id6_));
+    std::string content = io_.readFile();
+    io_.writeFile(content.substr(0, content.size() - 3));
+
+    EXPECT_FALSE(file_->read(relay_id6_, remote_id6_));
+    EXPECT_TRUE(relay_id6_.empty());
+    EXPECT_TRUE(remote_id6_.empty());
+}
+
+} // end of anonymous namespace
@@ -0,0 +1,106 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/lease_affinity.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+using namespace std;
+
+namespace {
+
+/// @brief Returns a hardware address.
+///
+/// @param last the last byte of the address.
+HWAddrPtr
+makeHWAddr(uint8_t last) {
+    vector<uint8_t> mac = { 0, 1, 2, 3, 4, last };
+    return (HWAddrPtr(new HWAddr(mac, HTYPE_ETHER)));
+}
+
+/// @brief Returns a client identifier.
+///
+/// @param last the last byte of the identifier.
+ClientIdPtr
+makeClientId(uint8_t last) {
+    vector<uint8_t> id = { 1, 0, 1, 2, 3, 4, last };
+    return (ClientIdPtr(new ClientId(id)));
+}
+
+// Verifies the basic operations of the index.
+TEST(LeaseAffinity4Test, basic) {
+    LeaseAffinity4 affinity;
+    SubnetID subnet_id = 0;
+    EXPECT_TRUE(affinity.get(makeClientId(1), makeHWAddr(1), subnet_id).isV4Zero());
+
+    Lease4 lease(IOAddress("192.0.2.1"), makeHWAddr(1), makeClientId(1),
+                 3600, time(0) - 4000, 7);
+    affinity.add(lease, 3600);
+    EXPECT_EQ(2, affinity.size());
+
+    // The client is found by its client identifier or by its hardware
+    // address.
+    EXPECT_EQ("192.0.2.1",
+              affinity.get(makeClientId(1), HWAddrPtr(), subnet_id).toText());
+    EXPECT_EQ(7, subnet_id);
+    EXPECT_EQ("192.0.2.1",
+              affinity.get(ClientIdPtr(), makeHWAddr(1), subnet_id).toText());
+    EXPECT_TRUE(affinity.get(makeClientId(2), makeHWAddr(2), subnet_id).isV4Zero());
+
+    // A later lease replaces the entry.
+    Lease4 lease2(IOAddress("192.0.2.2"), makeHWAddr(1), makeClientId(1),
+                  3600, time(0) - 4000, 8);
+    affinity.add(lease2, 3600);
+    EXPECT_EQ(2, affinity.size());
+    EXPECT_EQ("192.0.2.2",
+              affinity.get(makeClientId(1), makeHWAddr(1), subnet_id).toText());
+    EXPECT_EQ(8, subnet_id);
+
+    affinity.remove(makeClientId(1), makeHWAddr(1));
+    EXPECT_EQ(0, affinity.size());
+    EXPECT_TRUE(affinity.get(makeClientId(1), makeHWAddr(1), subnet_id).isV4Zero());
+
+    // A lease without identifiers is ignored.
+    Lease4 anonymous(IOAddress("192.0.2.3"), HWAddrPtr(), ClientIdPtr(),
+                     3600, time(0) - 4000, 7);
+    affinity.add(anonymous, 3600);
+    EXPECT_EQ(0, affinity.size());
+
+    affinity.add(lease, 3600);
+    affinity.clear();
+    EXPECT_EQ(0, affinity.size());
+}
+
+// Verifies that the expired entries are not returned and are removed.
+TEST(LeaseAffinity4Test, expire) {
+    LeaseAffinity4 affinity;
+    SubnetID subnet_id = 0;
+    Lease4 lease(IOAddress("192.0.2.1"), makeHWAddr(1), ClientIdPtr(),
+                 3600, time(0) - 4000, 7);
+    affinity.add(lease, 0);
+    EXPECT_EQ(1, affinity.size());
+    EXPECT_TRUE(affinity.get(ClientIdPtr(), makeHWAddr(1), subnet_id).isV4Zero());
+    EXPECT_EQ(0, affinity.size());
+
+    // The expired entries are swept when the index grows.
+    for (unsigned i = 0; i < 2000; ++i) {
+        HWAddrPtr hwaddr = makeHWAddr(static_cast<uint8_t>(i));
+        hwaddr->hwaddr_[4] = static_cast<uint8_t>(i >> 8);
+        Lease4 other(IOAddress(0xc0000000 + i), hwaddr, ClientIdPtr(),
+                     3600, time(0) - 4000, 7);
+        affinity.add(other, 0);
+    }
+    EXPECT_GT(1024, affinity.size());
+}
+
+} // end of anonymous namespace
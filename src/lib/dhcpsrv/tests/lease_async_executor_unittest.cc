@@ -0,0 +1,157 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcpsrv/lease_async_executor.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture class for @c LeaseAsyncExecutor.
+class LeaseAsyncExecutorTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    LeaseAsyncExecutorTest() : executed_(0), blocked_(false), released_(false) {
+    }
+
+    /// @brief Operation recording its execution order.
+    ///
+    /// @param address Address of the operation.
+    /// @param index Index of the operation on the address.
+    void record(const IOAddress& address, int index) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        order_[address].push_back(index);
+        ++executed_;
+    }
+
+    /// @brief Operation blocking its thread until @c release is called.
+    void block() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        blocked_ = true;
+        cv_.notify_all();
+        cv_.wait(lock, [this]() { return (released_); });
+    }
+
+    /// @brief Waits until an operation is blocked.
+    void waitBlocked() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return (blocked_); });
+    }
+
+    /// @brief Unblocks the blocked operation.
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        released_ = true;
+        cv_.notify_all();
+    }
+
+    /// @brief Execution order of the operations by address.
+    std::map<IOAddress, std::vector<int>> order_;
+
+    /// @brief Number of executed operations.
+    std::atomic<int> executed_;
+
+    /// @brief Indicates that an operation is blocked.
+    bool blocked_;
+
+    /// @brief Indicates that the blocked operation can return.
+    bool released_;
+
+    /// @brief Mutex protecting the test state.
+    std::mutex mutex_;
+
+    /// @brief Condition signaled when the test state changes.
+    std::condition_variable cv_;
+};
+
+// Verifies that the operations on the same address are executed in order.
+TEST_F(LeaseAsyncExecutorTest, order) {
+    LeaseAsyncExecutor executor(4);
+    EXPECT_EQ(4, executor.getThreadCount());
+
+    const int addresses = 8;
+    const int operations = 100;
+    for (int i = 0; i < operations; ++i) {
+        for (int a = 0; a < addresses; ++a) {
+            IOAddress address(0xc0000200 + a);
+            executor.push(address, [this, address, i]() { record(address, i); });
+        }
+    }
+    executor.wait();
+    EXPECT_EQ(0, executor.getPending());
+    EXPECT_EQ(addresses * operations, executed_);
+
+    ASSERT_EQ(addresses, order_.size());
+    for (auto const& it : order_) {
+        ASSERT_EQ(operations, it.second.size()) << it.first;
+        for (int i = 0; i < operations; ++i) {
+            EXPECT_EQ(i, it.second[i]) << it.first;
+        }
+    }
+}
+
+// Verifies that an operation waiting for a previous operation on the same
+// address does not block the operations on other addresses.
+TEST_F(LeaseAsyncExecutorTest, otherAddresses) {
+    LeaseAsyncExecutor executor(2);
+    IOAddress blocked("192.0.2.1");
+    IOAddress other("192.0.2.2");
+
+    executor.push(blocked, [this]() { block(); });
+    waitBlocked();
+    executor.push(blocked, [this, blocked]() { record(blocked, 1); });
+    executor.push(other, [this, other]() { record(other, 1); });
+
+    // Only the operation on the other address can be executed.
+    while (executed_ == 0) {
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        EXPECT_EQ(0, order_.count(blocked));
+        EXPECT_EQ(1, order_.count(other));
+    }
+
+    release();
+    executor.wait();
+    EXPECT_EQ(2, executed_);
+}
+
+// Verifies that stop executes the pending operations and that the
+// operations pushed after stop are executed by the caller.
+TEST_F(LeaseAsyncExecutorTest, stop) {
+    LeaseAsyncExecutor executor(1);
+    IOAddress address("192.0.2.1");
+
+    for (int i = 0; i < 10; ++i) {
+        executor.push(address, [this, address, i]() { record(address, i); });
+    }
+    executor.stop();
+    EXPECT_EQ(10, executed_);
+    EXPECT_EQ(0, executor.getPending());
+
+    executor.push(address, [this, address]() { record(address, 10); });
+    EXPECT_EQ(11, executed_);
+    ASSERT_EQ(11, order_[address].size());
+    EXPECT_EQ(10, order_[address].back());
+
+    // Stop can be called again.
+    EXPECT_NO_THROW(executor.stop());
+}
+
+}  // namespace
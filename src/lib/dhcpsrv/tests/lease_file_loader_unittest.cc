@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,6 +15,7 @@
 #include <dhcpsrv/cfg_consistency.h>
 #include <boost/scoped_ptr.hpp>
 #include <gtest/gtest.h>
+#include <iomanip>
 #include <sstream>
 #include <string>
 
@@ -705,6 +706,218 @@ TEST_F(LeaseFileLoaderTest, maxRowErrors6) {
     }
 }
 
+// This test verifies that the leases are loaded from the IPv4 lease file
+// using a thread pool and that the last entry for a lease wins.
+TEST_F(LeaseFileLoaderTest, loadParallel4) {
+    std::string a_1 = "192.0.2.1,06:07:08:09:0a:bc,,"
+                      "200,200,8,1,1,host.example.com,1,"
+                      "{ \"foobar\": true }\n";
+    std::string a_2 = "192.0.2.1,06:07:08:09:0a:bc,,"
+                      "200,500,8,1,1,host.example.com,1,"
+                      "{ \"foobar\": true }\n";
+    std::string b_1 = "192.0.3.15,dd:de:ba:0d:1b:2e:3e:4f,0a:00:01:04,"
+                      "100,100,7,0,0,,1,\n";
+    std::string b_2 = "192.0.3.15,dd:de:ba:0d:1b:2e:3e:4f,0a:00:01:04,"
+                      "100,135,7,0,0,,1,\n";
+    std::string c_1 = "192.0.2.3,,,"
+                      "200,200,8,1,1,host.example.com,0,\n";
+
+    io_.writeFile(v4_hdr_ + a_1 + b_1 + c_1 + b_2 + a_2);
+
+    boost::scoped_ptr<CSVLeaseFile4> lf(new CSVLeaseFile4(filename_));
+    ASSERT_NO_THROW(lf->open());
+
+    // Load leases from the lease file using 4 threads.
+    Lease4Storage storage;
+    ASSERT_NO_THROW(LeaseFileLoader::load<Lease4>(*lf, storage, 10, true, 4));
+
+    // The statistics should be the same as for the sequential load.
+    {
+    SCOPED_TRACE("Read leases");
+    checkStats(*lf, 6, 4, 1, 0, 0, 0);
+    }
+
+    ASSERT_EQ(2, storage.size());
+
+    Lease4Ptr lease = getLease<Lease4Ptr>("192.0.2.1", storage);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(300, lease->cltt_);
+
+    lease = getLease<Lease4Ptr>("192.0.3.15", storage);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(35, lease->cltt_);
+}
+
+// This test verifies that the leases are sanity checked when the IPv4
+// lease file is loaded using a thread pool.
+TEST_F(LeaseFileLoaderTest, sanityCheckerParallel4) {
+    Subnet4Ptr subnet1 = createSubnet4("192.0.2.0/24", 1);
+    Subnet4Ptr subnet2 = createSubnet4("192.0.3.0/24", 2);
+    ASSERT_NO_THROW(CfgMgr::instance().getStagingCfg()->getCfgSubnets4()->add(subnet1));
+    ASSERT_NO_THROW(CfgMgr::instance().getStagingCfg()->getCfgSubnets4()->add(subnet2));
+    ASSERT_NO_THROW(CfgMgr::instance().getStagingCfg()->getConsistency()
+                    ->setLeaseSanityCheck(CfgConsistency::LEASE_CHECK_FIX_DEL));
+
+    // Leases in the right subnet, in the wrong subnet and in no subnet.
+    std::ostringstream os;
+    os << v4_hdr_;
+    for (int i = 1; i <= 100; ++i) {
+        os << "192.0.2." << i << ",dd:de:ba:0d:1b:2e,0a:00:01:04,100,100,1,0,0,,1,\n";
+    }
+    os << "192.0.3.1,dd:de:ba:0d:1b:2e,0a:00:01:04,100,100,1,0,0,,1,\n";
+    os << "192.0.4.1,dd:de:ba:0d:1b:2e,0a:00:01:04,100,100,1,0,0,,1,\n";
+    io_.writeFile(os.str());
+
+    boost::scoped_ptr<CSVLeaseFile4> lf(new CSVLeaseFile4(filename_));
+    ASSERT_NO_THROW(lf->open());
+
+    // Load leases from the lease file using 4 threads.
+    Lease4Storage storage;
+    ASSERT_NO_THROW(LeaseFileLoader::load<Lease4>(*lf, storage, 10, true, 4));
+
+    // The discarded lease is not a read error.
+    {
+    SCOPED_TRACE("Read leases");
+    checkStats(*lf, 103, 102, 0, 0, 0, 0);
+    }
+
+    ASSERT_EQ(101, storage.size());
+    Lease4Ptr lease = getLease<Lease4Ptr>("192.0.2.100", storage);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(1, lease->subnet_id_);
+    lease = getLease<Lease4Ptr>("192.0.3.1", storage);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(2, lease->subnet_id_);
+    EXPECT_FALSE(getLease<Lease4Ptr>("192.0.4.1", storage));
+}
+
+// This test verifies that the maximum number of errors is honored when
+// the IPv4 lease file is loaded using a thread pool.
+TEST_F(LeaseFileLoaderTest, maxRowErrorsParallel4) {
+    // We have 9 rows: 2 that are good, 7 that are flawed (too few fields).
+    std::ostringstream os;
+    os << v4_hdr_
+       << "192.0.2.100,08:00:27:25:d3:f4,31:31:31:31,3600,1565356064,1,0,0,,0,\n";
+    for (int i = 1; i <= 7; ++i) {
+        os << "192.0.2.10" << i << ",FF:FF:FF:FF:FF:0" << i
+           << ",32:32:32:3" << i << ",3600,1565356073,1,0,0\n";
+    }
+    os << "192.0.2.108,08:00:27:25:d3:f4,32:32:32:32,3600,1565356073,1,0,0,,0,\n";
+
+    io_.writeFile(os.str());
+
+    boost::scoped_ptr<CSVLeaseFile4> lf(new CSVLeaseFile4(filename_));
+    ASSERT_NO_THROW(lf->open());
+
+    // Let's limit the number of errors to 5 (we have 7 in the data).
+    Lease4Storage storage;
+    ASSERT_THROW(LeaseFileLoader::load<Lease4>(*lf, storage, 5, true, 2),
+                 util::CSVFileError);
+
+    // Now let's disable the error limit and try again.
+    ASSERT_NO_THROW(lf->open());
+    ASSERT_NO_THROW(LeaseFileLoader::load<Lease4>(*lf, storage, 0, true, 2));
+
+    // We should have made 10 reads, with 2 leases read, and 7 errors.
+    {
+        SCOPED_TRACE("Good load stats");
+        checkStats(*lf, 10, 2, 7, 0, 0, 0);
+    }
+    EXPECT_EQ(2, storage.size());
+}
+
+// This test verifies that a lease file holding more rows than a single
+// batch of the thread pool is loaded the same way as by a single thread.
+TEST_F(LeaseFileLoaderTest, loadParallelManyRows4) {
+    // Each of the 256 addresses appears 20 times with an increasing
+    // expiration time, and every 10th entry of an address removes it.
+    const size_t rows = 256 * 20;
+    std::ostringstream os;
+    os << v4_hdr_;
+    for (size_t i = 0; i < rows; ++i) {
+        size_t host = i % 256;
+        size_t entry = i / 256;
+        os << "192.0.2." << host << ",06:07:08:09:0a:" << std::hex
+           << std::setw(2) << std::setfill('0') << host << std::dec << ",,"
+           << (((entry + host) % 10 == 9) ? 0 : 100) << ","
+           << (1000 + i) << ",1,0,0,,0,\n";
+    }
+    io_.writeFile(os.str());
+
+    // Load the file by a single thread.
+    boost::scoped_ptr<CSVLeaseFile4> lf(new CSVLeaseFile4(filename_));
+    ASSERT_NO_THROW(lf->open());
+    Lease4Storage expected;
+    ASSERT_NO_THROW(LeaseFileLoader::load<Lease4>(*lf, expected, 0));
+
+    // Load it again using 3 threads.
+    lf.reset(new CSVLeaseFile4(filename_));
+    ASSERT_NO_THROW(lf->open());
+    Lease4Storage storage;
+    ASSERT_NO_THROW(LeaseFileLoader::load<Lease4>(*lf, storage, 0, true, 3));
+
+    {
+    SCOPED_TRACE("Read leases");
+    checkStats(*lf, rows + 1, rows, 0, 0, 0, 0);
+    }
+
+    ASSERT_EQ(expected.size(), storage.size());
+    for (auto const& lease : expected) {
+        Lease4Ptr loaded = getLease<Lease4Ptr>(lease->addr_.toText(), storage);
+        ASSERT_TRUE(loaded) << lease->addr_;
+        EXPECT_EQ(lease->cltt_, loaded->cltt_) << lease->addr_;
+    }
+}
+
+// This test verifies that the leases are loaded from the IPv6 lease file
+// using a thread pool and that the last entry for a lease wins.
+TEST_F(LeaseFileLoaderTest, loadParallel6) {
+    std::string a_1 = "2001:db8:1::1,00:01:02:03:04:05:06:0a:0b:0c:0d:0e:0f,"
+                      "200,200,8,100,0,7,0,1,1,host.example.com,,1,"
+                      "{ \"foobar\": true },,\n";
+    std::string a_2 = "2001:db8:1::1,,"
+                      "200,200,8,100,0,7,0,1,1,host.example.com,,1,"
+                      "{ \"foobar\": true },,\n";
+    std::string a_3 = "2001:db8:1::1,00:01:02:03:04:05:06:0a:0b:0c:0d:0e:0f,"
+                      "200,400,8,100,0,7,0,1,1,host.example.com,,1,"
+                      "{ \"foobar\": true },,\n";
+    std::string b_1 = "2001:db8:2::10,01:01:01:01:0a:01:02:03:04:05,"
+                      "300,300,6,150,0,8,0,0,0,,,1,,,\n";
+    std::string b_2 = "2001:db8:2::10,01:01:01:01:0a:01:02:03:04:05,"
+                      "300,800,6,150,0,8,0,0,0,,,1,,,\n";
+    std::string c_1 = "3000:1::,00:01:02:03:04:05:06:0a:0b:0c:0d:0e:0f,"
+                      "100,200,8,0,2,16,64,0,0,,,1,,,\n";
+
+    io_.writeFile(v6_hdr_ + a_1 + a_2 + b_1 + c_1 + b_2 + a_3);
+
+    boost::scoped_ptr<CSVLeaseFile6> lf(new CSVLeaseFile6(filename_));
+    ASSERT_NO_THROW(lf->open());
+
+    // Load leases from the lease file using 4 threads.
+    Lease6Storage storage;
+    ASSERT_NO_THROW(LeaseFileLoader::load<Lease6>(*lf, storage, 10, true, 4));
+
+    // The statistics should be the same as for the sequential load.
+    {
+    SCOPED_TRACE("Read leases");
+    checkStats(*lf, 7, 5, 1, 0, 0, 0);
+    }
+
+    ASSERT_EQ(3, storage.size());
+
+    Lease6Ptr lease = getLease<Lease6Ptr>("2001:db8:1::1", storage);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(200, lease->cltt_);
+
+    lease = getLease<Lease6Ptr>("3000:1::", storage);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(100, lease->cltt_);
+
+    lease = getLease<Lease6Ptr>("2001:db8:2::10", storage);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(500, lease->cltt_);
+}
+
 // This test verifies that the lease with a valid lifetime set to 0 is
 // not loaded if there are no previous entries for this lease in the
 // lease file.
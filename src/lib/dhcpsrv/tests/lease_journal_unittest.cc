@@ -0,0 +1,328 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcp/duid.h>
+#include <dhcpsrv/lease_file_loader.h>
+#include <dhcpsrv/lease_journal.h>
+#include <dhcpsrv/memfile_lease_storage.h>
+#include <dhcpsrv/testutils/lease_file_io.h>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::dhcp::test;
+
+namespace {
+
+// HWADDR values used by unit tests.
+const uint8_t HWADDR0[] = { 0, 1, 2, 3, 4, 5 };
+const uint8_t HWADDR1[] = { 0xd, 0xe, 0xa, 0xd, 0xb, 0xe, 0xe, 0xf };
+
+const uint8_t CLIENTID[] = { 1, 2, 3, 4 };
+
+// DUID values used by unit tests.
+const uint8_t DUID0[] = { 0, 1, 2, 3, 4, 5, 6, 0xa, 0xb, 0xc, 0xd, 0xe, 0xf };
+const uint8_t DUID1[] = { 1, 1, 1, 1, 0xa, 1, 2, 3, 4, 5 };
+
+/// @brief Test fixture class for @c LeaseJournal validation.
+class LeaseJournalTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Removes the journal files left by a previous test.
+    LeaseJournalTest()
+        : filename4_(absolutePath("leases4.journal")), io4_(filename4_),
+          filename6_(absolutePath("leases6.journal")), io6_(filename6_) {
+        hwaddr0_.reset(new HWAddr(HWADDR0, sizeof(HWADDR0), HTYPE_ETHER));
+        hwaddr1_.reset(new HWAddr(HWADDR1, sizeof(HWADDR1), HTYPE_ETHER));
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Removes the journal files.
+    virtual ~LeaseJournalTest() {
+        io4_.removeFile();
+        io6_.removeFile();
+    }
+
+    /// @brief Prepends the absolute path to the file specified
+    /// as an argument.
+    ///
+    /// @param filename Name of the file.
+    /// @return Absolute path to the test file.
+    static std::string absolutePath(const std::string& filename) {
+        std::ostringstream s;
+        s << DHCP_DATA_DIR << "/" << filename;
+        return (s.str());
+    }
+
+    /// @brief Returns the size of a file.
+    ///
+    /// @param filename Name of the file.
+    static off_t fileSize(const std::string& filename) {
+        struct stat st;
+        if (stat(filename.c_str(), &st) != 0) {
+            return (-1);
+        }
+        return (st.st_size);
+    }
+
+    /// @brief Overwrites a byte of a file.
+    ///
+    /// @param filename Name of the file.
+    /// @param offset Offset of the byte.
+    /// @param value New value of the byte.
+    static void corrupt(const std::string& filename, const off_t offset,
+                        const uint8_t value) {
+        int fd = open(filename.c_str(), O_WRONLY);
+        ASSERT_GE(fd, 0);
+        EXPECT_EQ(1, pwrite(fd, &value, 1, offset));
+        close(fd);
+    }
+
+    /// @brief Creates the DHCPv4 journal holding two leases.
+    void writeSampleJournal4() {
+        LeaseJournal4 journal(filename4_);
+        ASSERT_NO_THROW(journal.open());
+        Lease4Ptr lease(new Lease4(IOAddress("192.0.3.2"), hwaddr0_,
+                                   0, 0, 200, 0, 8, true, true,
+                                   "host.example.com"));
+        lease->state_ = Lease::STATE_EXPIRED_RECLAIMED;
+        ASSERT_NO_THROW(journal.append(*lease));
+        leases4_.push_back(lease);
+        lease.reset(new Lease4(IOAddress("192.0.3.10"), hwaddr1_,
+                               CLIENTID, sizeof(CLIENTID), 100, 0, 7));
+        lease->setContext(Element::fromJSON("{ \"foobar\": true }"));
+        ASSERT_NO_THROW(journal.append(*lease));
+        leases4_.push_back(lease);
+        journal.close();
+    }
+
+    /// @brief Name of the DHCPv4 test journal.
+    std::string filename4_;
+
+    /// @brief Object providing access to the DHCPv4 journal IO.
+    LeaseFileIO io4_;
+
+    /// @brief Name of the DHCPv6 test journal.
+    std::string filename6_;
+
+    /// @brief Object providing access to the DHCPv6 journal IO.
+    LeaseFileIO io6_;
+
+    /// @brief hardware address 0 (corresponds to HWADDR0 const)
+    HWAddrPtr hwaddr0_;
+
+    /// @brief hardware address 1 (corresponds to HWADDR1 const)
+    HWAddrPtr hwaddr1_;
+
+    /// @brief Leases written by @c writeSampleJournal4.
+    std::vector<Lease4Ptr> leases4_;
+};
+
+// This test checks that the DHCPv4 leases are read as they were written.
+TEST_F(LeaseJournalTest, appendNext4) {
+    writeSampleJournal4();
+    EXPECT_TRUE(LeaseJournal::isJournal(filename4_));
+
+    LeaseJournal4 journal(filename4_);
+    ASSERT_NO_THROW(journal.open());
+    for (auto const& expected : leases4_) {
+        Lease4Ptr lease;
+        ASSERT_TRUE(journal.next(lease)) << journal.getReadMsg();
+        ASSERT_TRUE(lease);
+        EXPECT_TRUE(*expected == *lease) << lease->toText();
+    }
+    Lease4Ptr lease;
+    EXPECT_TRUE(journal.next(lease));
+    EXPECT_FALSE(lease);
+    EXPECT_EQ(3, journal.getReads());
+    EXPECT_EQ(2, journal.getReadLeases());
+    EXPECT_EQ(0, journal.getReadErrs());
+}
+
+// This test checks that the DHCPv6 leases are read as they were written.
+TEST_F(LeaseJournalTest, appendNext6) {
+    std::vector<Lease6Ptr> leases;
+    Lease6Ptr lease(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8:1::1"),
+                               DuidPtr(new DUID(DUID0, sizeof(DUID0))),
+                               7, 100, 200, 8, true, true,
+                               "host.example.com"));
+    lease->cltt_ = 0;
+    lease->updateCurrentExpirationTime();
+    leases.push_back(lease);
+    lease.reset(new Lease6(Lease::TYPE_PD, IOAddress("3000:1:1::"),
+                           DuidPtr(new DUID(DUID1, sizeof(DUID1))),
+                           8, 150, 300, 10, false, false,
+                           "", hwaddr0_, 64));
+    lease->setContext(Element::fromJSON("{ \"foobar\": true }"));
+    leases.push_back(lease);
+    lease.reset(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8:1::2"),
+                           DuidPtr(new DUID(DUID::EMPTY())),
+                           0, 0, 0, 8));
+    lease->state_ = Lease::STATE_DECLINED;
+    leases.push_back(lease);
+
+    {
+        LeaseJournal6 journal(filename6_);
+        ASSERT_NO_THROW(journal.open());
+        for (auto const& l : leases) {
+            ASSERT_NO_THROW(journal.append(*l));
+        }
+        EXPECT_EQ(3, journal.getWriteLeases());
+    }
+
+    LeaseJournal6 journal(filename6_);
+    ASSERT_NO_THROW(journal.open());
+    for (auto const& expected : leases) {
+        ASSERT_TRUE(journal.next(lease)) << journal.getReadMsg();
+        ASSERT_TRUE(lease);
+        EXPECT_TRUE(*expected == *lease) << lease->toText();
+    }
+    EXPECT_TRUE(journal.next(lease));
+    EXPECT_FALSE(lease);
+}
+
+// This test checks that a lease without identifier is rejected.
+TEST_F(LeaseJournalTest, appendInvalid) {
+    LeaseJournal4 journal(filename4_);
+    ASSERT_NO_THROW(journal.open());
+    Lease4 lease(IOAddress("192.0.3.2"), HWAddrPtr(), 0, 0, 200, 0, 8);
+    EXPECT_THROW(journal.append(lease), BadValue);
+    EXPECT_EQ(1, journal.getWrites());
+    EXPECT_EQ(1, journal.getWriteErrs());
+}
+
+// This test checks that a record with a wrong checksum is skipped.
+TEST_F(LeaseJournalTest, wrongChecksum) {
+    writeSampleJournal4();
+
+    // Modify the first byte of the first record payload.
+    corrupt(filename4_, 8 + 8, 0xFF);
+
+    LeaseJournal4 journal(filename4_);
+    ASSERT_NO_THROW(journal.open());
+    Lease4Ptr lease;
+    EXPECT_FALSE(journal.next(lease));
+    EXPECT_FALSE(journal.getReadMsg().empty());
+    ASSERT_TRUE(journal.next(lease)) << journal.getReadMsg();
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("192.0.3.10", lease->addr_.toText());
+    EXPECT_TRUE(journal.next(lease));
+    EXPECT_FALSE(lease);
+    EXPECT_EQ(1, journal.getReadErrs());
+}
+
+// This test checks that an incomplete record at the end of the journal
+// is dropped and that new records can be appended.
+TEST_F(LeaseJournalTest, tornRecord) {
+    writeSampleJournal4();
+    off_t size = fileSize(filename4_);
+    ASSERT_GT(size, 0);
+    ASSERT_EQ(0, truncate(filename4_.c_str(), size - 3));
+
+    {
+        LeaseJournal4 journal(filename4_);
+        ASSERT_NO_THROW(journal.open());
+        Lease4Ptr lease;
+        ASSERT_TRUE(journal.next(lease));
+        ASSERT_TRUE(lease);
+        EXPECT_FALSE(journal.next(lease));
+        EXPECT_EQ(1, journal.getReadErrs());
+
+        // Append a lease after the first valid record.
+        ASSERT_NO_THROW(journal.append(*leases4_[1]));
+    }
+
+    LeaseJournal4 journal(filename4_);
+    ASSERT_NO_THROW(journal.open());
+    Lease4Ptr lease;
+    for (auto const& expected : leases4_) {
+        ASSERT_TRUE(journal.next(lease)) << journal.getReadMsg();
+        ASSERT_TRUE(lease);
+        EXPECT_TRUE(*expected == *lease);
+    }
+    EXPECT_TRUE(journal.next(lease));
+    EXPECT_FALSE(lease);
+    EXPECT_EQ(0, journal.getReadErrs());
+}
+
+// This test checks that a file which is not a journal of the expected
+// universe is rejected.
+TEST_F(LeaseJournalTest, wrongHeader) {
+    writeSampleJournal4();
+
+    LeaseJournal6 journal6(filename4_);
+    EXPECT_THROW(journal6.open(), LeaseJournalError);
+
+    io6_.writeFile("address,duid,valid_lifetime,expire,subnet_id\n");
+    EXPECT_FALSE(LeaseJournal::isJournal(filename6_));
+    LeaseJournal6 csv(filename6_);
+    EXPECT_THROW(csv.open(), LeaseJournalError);
+
+    EXPECT_FALSE(LeaseJournal::isJournal(absolutePath("nonexisting.journal")));
+}
+
+// This test checks that the records are synchronized to disk on close
+// and that the sync interval can be set.
+TEST_F(LeaseJournalTest, syncInterval) {
+    LeaseJournal4 journal(filename4_);
+    EXPECT_EQ(0, journal.getSyncInterval());
+    journal.setSyncInterval(1);
+    EXPECT_EQ(1, journal.getSyncInterval());
+    ASSERT_NO_THROW(journal.open());
+    Lease4 lease(IOAddress("192.0.3.2"), hwaddr0_, 0, 0, 200, 0, 8);
+    ASSERT_NO_THROW(journal.append(lease));
+    ASSERT_NO_THROW(journal.flush());
+    ASSERT_NO_THROW(journal.close());
+    EXPECT_GT(fileSize(filename4_), 8);
+}
+
+// This test checks that the journal can be loaded by the LeaseFileLoader
+// with and without threads.
+TEST_F(LeaseJournalTest, loader) {
+    {
+        LeaseJournal4 journal(filename4_);
+        ASSERT_NO_THROW(journal.open());
+        for (unsigned i = 1; i <= 250; ++i) {
+            std::ostringstream addr;
+            addr << "192.0.2." << i;
+            Lease4 lease(IOAddress(addr.str()), hwaddr0_, 0, 0, 200, 0, 8);
+            ASSERT_NO_THROW(journal.append(lease));
+        }
+        // Update the first lease.
+        Lease4 lease(IOAddress("192.0.2.1"), hwaddr1_, 0, 0, 300, 0, 8);
+        ASSERT_NO_THROW(journal.append(lease));
+    }
+
+    for (size_t threads : { 1, 4 }) {
+        SCOPED_TRACE(threads);
+        boost::shared_ptr<LeaseJournal4> journal(new LeaseJournal4(filename4_));
+        ASSERT_NO_THROW(journal->open());
+        Lease4Storage storage;
+        ASSERT_NO_THROW(LeaseFileLoader::load<Lease4>(*journal, storage, 0,
+                                                      true, threads));
+        EXPECT_EQ(250, storage.size());
+        auto lease = storage.get<AddressIndexTag>().find(IOAddress("192.0.2.1"));
+        ASSERT_TRUE(lease != storage.end());
+        EXPECT_EQ(300, (*lease)->valid_lft_);
+        EXPECT_EQ(252, journal->getReads());
+        EXPECT_EQ(251, journal->getReadLeases());
+    }
+}
+
+} // end of anonymous namespace
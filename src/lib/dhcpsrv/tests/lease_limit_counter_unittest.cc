@@ -0,0 +1,153 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <cc/data.h>
+#include <dhcpsrv/lease_limit_counter.h>
+#include <exceptions/exceptions.h>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture for exercising LeaseLimitCounter.
+class LeaseLimitCounterTest : public ::testing::Test {
+public:
+
+    /// @brief Sets the client classes in the user context of a lease.
+    ///
+    /// @param lease lease to modify.
+    /// @param classes classes in JSON, e.g. [ "foo", "bar" ].
+    void setClasses(const LeasePtr& lease, const std::string& classes) {
+        ElementPtr ctx = Element::createMap();
+        ElementPtr isc = Element::createMap();
+        isc->set("client-classes", Element::fromJSON(classes));
+        ctx->set("ISC", isc);
+        lease->setContext(ctx);
+    }
+
+    /// @brief Creates an IPv4 lease with the given classes.
+    ///
+    /// @param address lease address.
+    /// @param classes classes in JSON.
+    LeasePtr createLease4(const std::string& address, const std::string& classes) {
+        LeasePtr lease(new Lease4(IOAddress(address), HWAddrPtr(), ClientIdPtr(),
+                                  60, 0, 1));
+        setClasses(lease, classes);
+        return (lease);
+    }
+
+    /// @brief Creates an IPv6 lease with the given classes.
+    ///
+    /// @param ltype lease type.
+    /// @param address lease address.
+    /// @param classes classes in JSON.
+    LeasePtr createLease6(Lease::Type ltype, const std::string& address,
+                          const std::string& classes) {
+        DuidPtr duid(new DUID(std::vector<uint8_t>(8, 0x77)));
+        LeasePtr lease(new Lease6(ltype, IOAddress(address), duid, 1, 30, 60, 1,
+                                  HWAddrPtr(), (ltype == Lease::TYPE_PD ? 64 : 128)));
+        setClasses(lease, classes);
+        return (lease);
+    }
+
+    /// @brief The counter under test.
+    LeaseLimitCounter counter_;
+};
+
+// Verifies that the added and removed leases are counted.
+TEST_F(LeaseLimitCounterTest, addRemove) {
+    LeasePtr lease1 = createLease4("192.0.2.1", "[ \"foo\", \"bar\" ]");
+    LeasePtr lease2 = createLease4("192.0.2.2", "[ \"foo\" ]");
+    ASSERT_NO_THROW(counter_.addLease(lease1));
+    ASSERT_NO_THROW(counter_.addLease(lease2));
+    EXPECT_EQ(2, counter_.getLeaseCount());
+    EXPECT_EQ(2, counter_.getClassCount("foo"));
+    EXPECT_EQ(1, counter_.getClassCount("bar"));
+    EXPECT_EQ(0, counter_.getClassCount("baz"));
+
+    // Adding the same lease again must not count it twice.
+    ASSERT_NO_THROW(counter_.addLease(lease1));
+    EXPECT_EQ(2, counter_.getClassCount("foo"));
+
+    ASSERT_NO_THROW(counter_.removeLease(lease1));
+    EXPECT_EQ(1, counter_.getLeaseCount());
+    EXPECT_EQ(1, counter_.getClassCount("foo"));
+    EXPECT_EQ(0, counter_.getClassCount("bar"));
+
+    // Removing a lease which is not counted is a no-op.
+    ASSERT_NO_THROW(counter_.removeLease(lease1));
+    EXPECT_EQ(1, counter_.getClassCount("foo"));
+
+    EXPECT_THROW(counter_.addLease(LeasePtr()), BadValue);
+    EXPECT_THROW(counter_.updateLease(LeasePtr()), BadValue);
+    EXPECT_THROW(counter_.removeLease(LeasePtr()), BadValue);
+}
+
+// Verifies that an update reverses the previous contribution of the lease
+// even when the lease object was modified in place.
+TEST_F(LeaseLimitCounterTest, update) {
+    LeasePtr lease = createLease4("192.0.2.1", "[ \"foo\" ]");
+    ASSERT_NO_THROW(counter_.addLease(lease));
+    EXPECT_EQ(1, counter_.getClassCount("foo"));
+
+    setClasses(lease, "[ \"bar\" ]");
+    ASSERT_NO_THROW(counter_.updateLease(lease));
+    EXPECT_EQ(0, counter_.getClassCount("foo"));
+    EXPECT_EQ(1, counter_.getClassCount("bar"));
+
+    // Only the leases in the default state are counted.
+    lease->state_ = Lease::STATE_EXPIRED_RECLAIMED;
+    ASSERT_NO_THROW(counter_.updateLease(lease));
+    EXPECT_EQ(0, counter_.getClassCount("bar"));
+    EXPECT_EQ(0, counter_.getLeaseCount());
+
+    lease->state_ = Lease::STATE_DEFAULT;
+    ASSERT_NO_THROW(counter_.updateLease(lease));
+    EXPECT_EQ(1, counter_.getClassCount("bar"));
+
+    // A lease without classes is not counted.
+    lease->setContext(ElementPtr());
+    ASSERT_NO_THROW(counter_.updateLease(lease));
+    EXPECT_EQ(0, counter_.getClassCount("bar"));
+    EXPECT_EQ(0, counter_.getLeaseCount());
+}
+
+// Verifies that the lease types are counted separately and each family
+// can be cleared on its own.
+TEST_F(LeaseLimitCounterTest, typesAndClear) {
+    ASSERT_NO_THROW(counter_.addLease(createLease4("192.0.2.1", "[ \"foo\" ]")));
+    ASSERT_NO_THROW(counter_.addLease(createLease6(Lease::TYPE_NA, "2001:db8::1",
+                                                   "[ \"foo\" ]")));
+    ASSERT_NO_THROW(counter_.addLease(createLease6(Lease::TYPE_NA, "2001:db8::2",
+                                                   "[ \"foo\" ]")));
+    ASSERT_NO_THROW(counter_.addLease(createLease6(Lease::TYPE_PD, "3001::",
+                                                   "[ \"foo\" ]")));
+    EXPECT_EQ(4, counter_.getLeaseCount());
+    EXPECT_EQ(1, counter_.getClassCount("foo", Lease::TYPE_V4));
+    EXPECT_EQ(2, counter_.getClassCount("foo", Lease::TYPE_NA));
+    EXPECT_EQ(1, counter_.getClassCount("foo", Lease::TYPE_PD));
+
+    ASSERT_NO_THROW(counter_.clear(AF_INET6));
+    EXPECT_EQ(1, counter_.getLeaseCount());
+    EXPECT_EQ(1, counter_.getClassCount("foo", Lease::TYPE_V4));
+    EXPECT_EQ(0, counter_.getClassCount("foo", Lease::TYPE_NA));
+    EXPECT_EQ(0, counter_.getClassCount("foo", Lease::TYPE_PD));
+
+    ASSERT_NO_THROW(counter_.clear());
+    EXPECT_EQ(0, counter_.getLeaseCount());
+    EXPECT_EQ(0, counter_.getClassCount("foo", Lease::TYPE_V4));
+}
+
+} // end of anonymous namespace
@@ -7,16 +7,22 @@
 #include <config.h>
 
 #include <asiolink/io_address.h>
+#include <dhcpsrv/dhcpsrv_exceptions.h>
 #include <dhcpsrv/lease_mgr.h>
 #include <dhcpsrv/memfile_lease_mgr.h>
 #include <dhcpsrv/testutils/test_utils.h>
 #include <dhcpsrv/testutils/concrete_lease_mgr.h>
 #include <dhcpsrv/tests/generic_lease_mgr_unittest.h>
 #include <testutils/gtest_utils.h>
+#include <testutils/multi_threading_utils.h>
 
+#include <atomic>
 #include <iostream>
 #include <list>
+#include <mutex>
+#include <set>
 #include <sstream>
+#include <thread>
 
 #include <time.h>
 
@@ -27,6 +33,7 @@ using namespace isc::data;
 using namespace isc::db;
 using namespace isc::dhcp;
 using namespace isc::dhcp::test;
+using namespace isc::test;
 
 class LeaseMgrTest : public GenericLeaseMgrTest {
 public:
@@ -44,6 +51,114 @@ public:
 
 namespace {
 
+/// @brief Lease manager counting the IPv4 lease updates which can be
+/// executed asynchronously.
+class AsyncLeaseMgr : public ConcreteLeaseMgr {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param thread_count Number of threads executing the asynchronous
+    /// operations.
+    AsyncLeaseMgr(uint32_t thread_count)
+        : ConcreteLeaseMgr(DatabaseConnection::ParameterMap()), updates_(0) {
+        startAsync(thread_count);
+    }
+
+    /// @brief Destructor.
+    virtual ~AsyncLeaseMgr() {
+        stopAsync();
+    }
+
+    /// @brief Counts the update and fails for the 192.0.2.99 address.
+    ///
+    /// @param lease The lease.
+    virtual void updateLease4(const Lease4Ptr& lease) override {
+        if (lease->addr_ == IOAddress("192.0.2.99")) {
+            isc_throw(NoSuchLease, "no such lease " << lease->addr_);
+        }
+        ++updates_;
+    }
+
+    /// @brief Number of updates.
+    std::atomic<int> updates_;
+};
+
+/// @brief Lease manager exposing the creation of the context pool.
+class PoolLeaseMgr : public ConcreteLeaseMgr {
+public:
+
+    /// @brief Constructor.
+    PoolLeaseMgr() : ConcreteLeaseMgr(DatabaseConnection::ParameterMap()) {
+    }
+
+    using LeaseMgr::getPoolSize;
+    using LeaseMgr::createContexts;
+};
+
+/// @brief Lease manager delegating the IPv4 lease updates to its writer
+/// threads.
+class WriterLeaseMgr : public ConcreteLeaseMgr {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param thread_count Number of writer threads.
+    WriterLeaseMgr(uint32_t thread_count)
+        : ConcreteLeaseMgr(DatabaseConnection::ParameterMap()), writers_(),
+          delegated_(0), mutex_() {
+        startWriters(thread_count);
+    }
+
+    /// @brief Destructor.
+    virtual ~WriterLeaseMgr() {
+        stopWriters();
+    }
+
+    /// @brief Records the thread writing the lease and fails for the
+    /// 192.0.2.99 address.
+    ///
+    /// @param lease The lease.
+    virtual void updateLease4(const Lease4Ptr& lease) override {
+        bool outcome = false;
+        if (delegateWrite(lease, [this, &lease]() {
+                updateLease4(lease);
+                return (true);
+            }, outcome)) {
+            return;
+        }
+        if (lease->addr_ == IOAddress("192.0.2.99")) {
+            isc_throw(NoSuchLease, "no such lease " << lease->addr_);
+        }
+        if (isWriterThread()) {
+            ++delegated_;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        writers_.insert(std::this_thread::get_id());
+    }
+
+    using LeaseMgr::getWriterThreads;
+
+    /// @brief The threads which wrote the leases.
+    std::set<std::thread::id> writers_;
+
+    /// @brief Number of leases written by the writer threads.
+    std::atomic<int> delegated_;
+
+    /// @brief Mutex protecting the threads.
+    std::mutex mutex_;
+};
+
+/// @brief Creates an IPv4 lease.
+///
+/// @param address Address of the lease.
+Lease4Ptr
+createAsyncLease4(const std::string& address) {
+    HWAddrPtr hwaddr(new HWAddr(std::vector<uint8_t>(6, 1), HTYPE_ETHER));
+    return (Lease4Ptr(new Lease4(IOAddress(address), hwaddr, ClientIdPtr(),
+                                 3600, time(0), 1)));
+}
+
 // This test checks if getLease6() method is working properly for 0 (NULL),
 // 1 (return the lease) and more than 1 leases (throw).
 TEST_F(LeaseMgrTest, getLease6) {
@@ -82,6 +197,179 @@ TEST_F(LeaseMgrTest, getLease6) {
                  MultipleRecords);
 }
 
+// Verifies that the asynchronous operations are executed synchronously
+// when the multi-threading is disabled.
+TEST(LeaseMgrAsyncTest, synchronous) {
+    AsyncLeaseMgr mgr(2);
+    EXPECT_FALSE(mgr.isAsync());
+
+    bool called = false;
+    bool failed = true;
+    mgr.updateLease4Async(createAsyncLease4("192.0.2.1"),
+                          [&called, &failed](bool, std::exception_ptr error) {
+        called = true;
+        failed = static_cast<bool>(error);
+    });
+    EXPECT_TRUE(called);
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(1, mgr.updates_);
+
+    // The exception is passed to the callback.
+    called = false;
+    mgr.updateLease4Async(createAsyncLease4("192.0.2.99"),
+                          [&called, &failed](bool, std::exception_ptr error) {
+        called = true;
+        failed = static_cast<bool>(error);
+    });
+    EXPECT_TRUE(called);
+    EXPECT_TRUE(failed);
+
+    // Nothing to wait for.
+    EXPECT_FALSE(mgr.whenLeasesDurable([](bool) {}));
+}
+
+// Verifies that the asynchronous operations are tracked per thread and
+// that the callbacks registered by whenLeasesDurable are invoked when
+// they complete.
+TEST(LeaseMgrAsyncTest, asynchronous) {
+    MultiThreadingTest mt(true);
+    AsyncLeaseMgr mgr(2);
+    ASSERT_TRUE(mgr.isAsync());
+
+    // No operation was submitted.
+    EXPECT_FALSE(mgr.whenLeasesDurable([](bool) {}));
+
+    for (int i = 1; i <= 10; ++i) {
+        mgr.updateLease4Async(createAsyncLease4("192.0.2." + std::to_string(i)),
+                              LeaseMgr::AsyncCallback());
+    }
+    std::atomic<int> durable(-1);
+    bool registered = mgr.whenLeasesDurable([&durable](bool ok) {
+        durable = (ok ? 1 : 0);
+    });
+    if (registered) {
+        while (durable < 0) {
+            std::this_thread::yield();
+        }
+    } else {
+        // All the updates already completed.
+        durable = 1;
+    }
+    EXPECT_EQ(1, durable);
+    EXPECT_EQ(10, mgr.updates_);
+
+    // A failure is reported to the durable callback.
+    mgr.updateLease4Async(createAsyncLease4("192.0.2.99"),
+                          LeaseMgr::AsyncCallback());
+    durable = -1;
+    ASSERT_TRUE(mgr.whenLeasesDurable([&durable](bool ok) {
+        durable = (ok ? 1 : 0);
+    }));
+    while (durable < 0) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(0, durable);
+}
+
+// Verifies that the pool-size parameter is decoded.
+TEST(LeaseMgrPoolTest, getPoolSize) {
+    DatabaseConnection::ParameterMap parameters;
+    EXPECT_EQ(0, PoolLeaseMgr::getPoolSize(parameters));
+
+    parameters["pool-size"] = "8";
+    EXPECT_EQ(8, PoolLeaseMgr::getPoolSize(parameters));
+
+    parameters["pool-size"] = "foo";
+    EXPECT_THROW(PoolLeaseMgr::getPoolSize(parameters), BadValue);
+}
+
+// Verifies that the contexts are created by parallel threads and that
+// a failure is reported.
+TEST(LeaseMgrPoolTest, createContexts) {
+    typedef boost::shared_ptr<std::thread::id> ContextPtr;
+    std::function<ContextPtr()> create = []() {
+        return (ContextPtr(new std::thread::id(std::this_thread::get_id())));
+    };
+    std::vector<ContextPtr> contexts;
+    ASSERT_NO_THROW(contexts = PoolLeaseMgr::createContexts(4, create));
+    ASSERT_EQ(4, contexts.size());
+    for (auto const& context : contexts) {
+        ASSERT_TRUE(context);
+        EXPECT_NE(std::this_thread::get_id(), *context);
+    }
+
+    std::atomic<int> count(0);
+    std::function<ContextPtr()> fail = [&count]() -> ContextPtr {
+        if (++count == 2) {
+            isc_throw(DbOpenError, "unable to connect");
+        }
+        return (ContextPtr(new std::thread::id()));
+    };
+    EXPECT_THROW(PoolLeaseMgr::createContexts(4, fail), DbOpenError);
+    EXPECT_EQ(4, count);
+}
+
+// Verifies that the writer-threads parameter is decoded.
+TEST(LeaseMgrWriterTest, getWriterThreads) {
+    DatabaseConnection::ParameterMap parameters;
+    EXPECT_EQ(0, WriterLeaseMgr::getWriterThreads(parameters));
+
+    parameters["writer-threads"] = "2";
+    EXPECT_EQ(2, WriterLeaseMgr::getWriterThreads(parameters));
+
+    parameters["writer-threads"] = "foo";
+    EXPECT_THROW(WriterLeaseMgr::getWriterThreads(parameters), BadValue);
+}
+
+// Verifies that the lease changes are written by the calling thread when
+// the multi-threading is disabled.
+TEST(LeaseMgrWriterTest, singleThreaded) {
+    WriterLeaseMgr mgr(2);
+    EXPECT_FALSE(mgr.isWriteDelegated());
+    EXPECT_NO_THROW(mgr.updateLease4(createAsyncLease4("192.0.2.1")));
+    ASSERT_EQ(1, mgr.writers_.size());
+    EXPECT_EQ(std::this_thread::get_id(), *mgr.writers_.begin());
+    EXPECT_EQ(0, mgr.delegated_);
+}
+
+// Verifies that the lease changes of the packet processing threads are
+// written by the writer threads and that the errors are reported to the
+// callers.
+TEST(LeaseMgrWriterTest, delegated) {
+    MultiThreadingTest mt(true);
+    WriterLeaseMgr mgr(2);
+    ASSERT_TRUE(mgr.isWriteDelegated());
+
+    std::vector<std::thread> threads;
+    std::atomic<int> failures(0);
+    for (int i = 0; i < 8; ++i) {
+        threads.push_back(std::thread([&mgr, &failures, i]() {
+            for (int j = 1; j <= 10; ++j) {
+                try {
+                    // The addresses are 192.0.2.20 to 192.0.2.99.
+                    mgr.updateLease4(createAsyncLease4("192.0.2." +
+                                                       std::to_string(19 + i * 10 + j)));
+                } catch (const NoSuchLease&) {
+                    ++failures;
+                }
+            }
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(1, failures);
+
+    // Only the writer threads wrote the leases.
+    EXPECT_LE(mgr.writers_.size(), 2);
+    EXPECT_EQ(0, mgr.writers_.count(std::this_thread::get_id()));
+    EXPECT_EQ(79, mgr.delegated_);
+
+    // Without writer threads the caller writes the lease.
+    WriterLeaseMgr local(0);
+    EXPECT_FALSE(local.isWriteDelegated());
+}
+
 // Verify LeaseStatsQuery default construction
 TEST (LeaseStatsQueryTest, defaultCtor) {
     LeaseStatsQueryPtr qry;
@@ -0,0 +1,185 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/lease_migrator.h>
+#include <exceptions/exceptions.h>
+#include <util/multi_threading_mgr.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Test fixture for the lease migration.
+///
+/// The leases are migrated between two non persistent memfile lease
+/// managers.
+class LeaseMigratorTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    LeaseMigratorTest() {
+        MultiThreadingMgr::instance().setMode(false);
+    }
+
+    /// @brief Destructor.
+    virtual ~LeaseMigratorTest() {
+        MultiThreadingMgr::instance().setMode(false);
+    }
+
+    /// @brief Creates the source and destination lease managers.
+    ///
+    /// @param universe DHCP version.
+    void createLeaseMgrs(const uint16_t universe) {
+        std::ostringstream access;
+        access << "type=memfile persist=false universe=" << universe;
+        source_ = LeaseMgrFactory::createLeaseMgr(access.str());
+        destination_ = LeaseMgrFactory::createLeaseMgr(access.str());
+    }
+
+    /// @brief Adds DHCPv4 leases to a lease manager.
+    ///
+    /// @param lease_mgr The lease manager.
+    /// @param first Index of the first lease.
+    /// @param count Number of leases.
+    void addLeases4(LeaseMgr& lease_mgr, const size_t first,
+                    const size_t count) {
+        for (size_t i = first; i < first + count; ++i) {
+            uint8_t hwaddr_data[] = { 0, 1, 2, 3,
+                                      static_cast<uint8_t>(i >> 8),
+                                      static_cast<uint8_t>(i) };
+            HWAddrPtr hwaddr(new HWAddr(hwaddr_data, sizeof(hwaddr_data),
+                                        HTYPE_ETHER));
+            Lease4Ptr lease(new Lease4(IOAddress(0x0a000001 + i), hwaddr,
+                                       ClientIdPtr(), 3600, time(0), 1));
+            ASSERT_TRUE(lease_mgr.addLease(lease));
+        }
+    }
+
+    /// @brief Adds DHCPv6 leases to a lease manager.
+    ///
+    /// @param lease_mgr The lease manager.
+    /// @param first Index of the first lease.
+    /// @param count Number of leases.
+    void addLeases6(LeaseMgr& lease_mgr, const size_t first,
+                    const size_t count) {
+        for (size_t i = first; i < first + count; ++i) {
+            std::vector<uint8_t> duid_data = { 0, 1, 2, 3,
+                                               static_cast<uint8_t>(i >> 8),
+                                               static_cast<uint8_t>(i) };
+            DuidPtr duid(new DUID(duid_data));
+            std::ostringstream address;
+            address << "2001:db8::" << std::hex << (i + 1);
+            Lease6Ptr lease(new Lease6(Lease::TYPE_NA, IOAddress(address.str()),
+                                       duid, 1, 1800, 3600, 1));
+            ASSERT_TRUE(lease_mgr.addLease(lease));
+        }
+    }
+
+    /// @brief Source lease manager.
+    TrackingLeaseMgrPtr source_;
+
+    /// @brief Destination lease manager.
+    TrackingLeaseMgrPtr destination_;
+};
+
+// Verifies that the constructor checks its parameters.
+TEST_F(LeaseMigratorTest, constructor) {
+    createLeaseMgrs(4);
+    EXPECT_THROW(LeaseMigrator(*source_, *destination_, 0), BadValue);
+    EXPECT_THROW(LeaseMigrator(*source_, *destination_, 10, 0), BadValue);
+    EXPECT_THROW(LeaseMigrator(*source_, *destination_, 10, 4),
+                 InvalidOperation);
+    EXPECT_NO_THROW(LeaseMigrator(*source_, *destination_, 10, 1));
+
+    MultiThreadingMgr::instance().setMode(true);
+    EXPECT_NO_THROW(LeaseMigrator(*source_, *destination_, 10, 4));
+}
+
+// Verifies that the DHCPv4 leases are migrated over several pages.
+TEST_F(LeaseMigratorTest, migrate4) {
+    createLeaseMgrs(4);
+    addLeases4(*source_, 0, 95);
+
+    LeaseMigrator migrator(*source_, *destination_, 10);
+    EXPECT_EQ(95, migrator.migrate4());
+    EXPECT_EQ(95, migrator.getReadLeases());
+    EXPECT_EQ(95, migrator.getAddedLeases());
+
+    Lease4Collection leases = destination_->getLeases4();
+    ASSERT_EQ(95, leases.size());
+    for (auto const& lease : leases) {
+        Lease4Ptr original = source_->getLease4(lease->addr_);
+        ASSERT_TRUE(original);
+        EXPECT_TRUE(*original == *lease);
+    }
+}
+
+// Verifies that the DHCPv6 leases are migrated over several pages.
+TEST_F(LeaseMigratorTest, migrate6) {
+    createLeaseMgrs(6);
+    addLeases6(*source_, 0, 95);
+
+    LeaseMigrator migrator(*source_, *destination_, 10);
+    EXPECT_EQ(95, migrator.migrate6());
+    EXPECT_EQ(95, migrator.getReadLeases());
+
+    Lease6Collection leases = destination_->getLeases6();
+    ASSERT_EQ(95, leases.size());
+    for (auto const& lease : leases) {
+        Lease6Ptr original = source_->getLease6(Lease::TYPE_NA, lease->addr_);
+        ASSERT_TRUE(original);
+        EXPECT_TRUE(*original == *lease);
+    }
+}
+
+// Verifies that the leases which already exist in the destination are
+// skipped so an interrupted migration can be run again.
+TEST_F(LeaseMigratorTest, existingLeases) {
+    createLeaseMgrs(4);
+    addLeases4(*source_, 0, 50);
+    addLeases4(*destination_, 10, 20);
+
+    LeaseMigrator migrator(*source_, *destination_, 16);
+    EXPECT_EQ(30, migrator.migrate4());
+    EXPECT_EQ(50, migrator.getReadLeases());
+    EXPECT_EQ(30, migrator.getAddedLeases());
+    EXPECT_EQ(50, destination_->getLeases4().size());
+}
+
+// Verifies that an empty source is handled.
+TEST_F(LeaseMigratorTest, emptySource) {
+    createLeaseMgrs(6);
+
+    LeaseMigrator migrator(*source_, *destination_);
+    EXPECT_EQ(0, migrator.migrate6());
+    EXPECT_EQ(0, migrator.getReadLeases());
+    EXPECT_TRUE(destination_->getLeases6().empty());
+}
+
+// Verifies that the leases are migrated by several threads.
+TEST_F(LeaseMigratorTest, migrateMultiThreading) {
+    MultiThreadingMgr::instance().setMode(true);
+    createLeaseMgrs(4);
+    addLeases4(*source_, 0, 1000);
+
+    LeaseMigrator migrator(*source_, *destination_, 64, 4);
+    EXPECT_EQ(1000, migrator.migrate4());
+    EXPECT_EQ(1000, migrator.getReadLeases());
+    EXPECT_EQ(1000, destination_->getLeases4().size());
+}
+
+} // end of anonymous namespace
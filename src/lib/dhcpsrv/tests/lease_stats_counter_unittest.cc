@@ -0,0 +1,230 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/lease_stats_counter.h>
+#include <exceptions/exceptions.h>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture for exercising LeaseStatsCounter.
+class LeaseStatsCounterTest : public ::testing::Test {
+public:
+
+    /// @brief Creates an IPv4 lease.
+    ///
+    /// @param address lease address.
+    /// @param subnet_id subnet identifier.
+    /// @param state lease state.
+    LeasePtr createLease4(const std::string& address, SubnetID subnet_id,
+                          uint32_t state = Lease::STATE_DEFAULT) {
+        LeasePtr lease(new Lease4(IOAddress(address), HWAddrPtr(), ClientIdPtr(),
+                                  60, 1000, subnet_id));
+        lease->state_ = state;
+        return (lease);
+    }
+
+    /// @brief Creates an IPv6 lease.
+    ///
+    /// @param ltype lease type.
+    /// @param address lease address.
+    /// @param subnet_id subnet identifier.
+    /// @param state lease state.
+    LeasePtr createLease6(Lease::Type ltype, const std::string& address,
+                          SubnetID subnet_id,
+                          uint32_t state = Lease::STATE_DEFAULT) {
+        DuidPtr duid(new DUID(std::vector<uint8_t>(8, 0x77)));
+        LeasePtr lease(new Lease6(ltype, IOAddress(address), duid, 1, 30, 60,
+                                  subnet_id, HWAddrPtr(),
+                                  (ltype == Lease::TYPE_PD ? 64 : 128)));
+        lease->state_ = state;
+        return (lease);
+    }
+
+    /// @brief The counter under test.
+    LeaseStatsCounter counter_;
+};
+
+// Verifies that the added and removed leases are counted.
+TEST_F(LeaseStatsCounterTest, addRemove) {
+    LeasePtr lease1 = createLease4("192.0.2.1", 1);
+    LeasePtr lease2 = createLease4("192.0.2.2", 1, Lease::STATE_DECLINED);
+    LeasePtr lease3 = createLease4("192.0.3.1", 2);
+    ASSERT_NO_THROW(counter_.addLease(lease1));
+    ASSERT_NO_THROW(counter_.addLease(lease2));
+    ASSERT_NO_THROW(counter_.addLease(lease3));
+    EXPECT_EQ(3, counter_.getLeaseCount());
+    EXPECT_EQ(1, counter_.getCount(1, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+    EXPECT_EQ(1, counter_.getCount(1, Lease::TYPE_V4, Lease::STATE_DECLINED));
+    EXPECT_EQ(1, counter_.getCount(2, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+    EXPECT_EQ(0, counter_.getCount(3, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+
+    // Adding the same lease again must not count it twice.
+    ASSERT_NO_THROW(counter_.addLease(lease1));
+    EXPECT_EQ(1, counter_.getCount(1, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+
+    ASSERT_NO_THROW(counter_.removeLease(lease1));
+    EXPECT_EQ(2, counter_.getLeaseCount());
+    EXPECT_EQ(0, counter_.getCount(1, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+    EXPECT_EQ(1, counter_.getCount(1, Lease::TYPE_V4, Lease::STATE_DECLINED));
+
+    // Removing an unknown lease is a no-op.
+    ASSERT_NO_THROW(counter_.removeLease(lease1));
+    EXPECT_EQ(2, counter_.getLeaseCount());
+
+    // Null leases are rejected.
+    EXPECT_THROW(counter_.addLease(LeasePtr()), BadValue);
+    EXPECT_THROW(counter_.updateLease(LeasePtr()), BadValue);
+    EXPECT_THROW(counter_.removeLease(LeasePtr()), BadValue);
+}
+
+// Verifies that an update moves the lease between the states and subnets
+// without the previous version of the lease.
+TEST_F(LeaseStatsCounterTest, update) {
+    LeasePtr lease = createLease4("192.0.2.1", 1);
+    ASSERT_NO_THROW(counter_.addLease(lease));
+
+    // Change the state in a copy as the backends do.
+    LeasePtr declined(new Lease4(*boost::dynamic_pointer_cast<Lease4>(lease)));
+    declined->state_ = Lease::STATE_DECLINED;
+    ASSERT_NO_THROW(counter_.updateLease(declined));
+    EXPECT_EQ(0, counter_.getCount(1, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+    EXPECT_EQ(1, counter_.getCount(1, Lease::TYPE_V4, Lease::STATE_DECLINED));
+
+    // Move the lease to another subnet.
+    LeasePtr moved = createLease4("192.0.2.1", 2);
+    ASSERT_NO_THROW(counter_.updateLease(moved));
+    EXPECT_EQ(0, counter_.getCount(1, Lease::TYPE_V4, Lease::STATE_DECLINED));
+    EXPECT_EQ(1, counter_.getCount(2, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+    EXPECT_EQ(1, counter_.getLeaseCount());
+}
+
+// Verifies that the rows are returned in order for the subnet ranges.
+TEST_F(LeaseStatsCounterTest, getRows) {
+    ASSERT_NO_THROW(counter_.addLease(createLease4("192.0.3.1", 3)));
+    ASSERT_NO_THROW(counter_.addLease(createLease4("192.0.1.1", 1)));
+    ASSERT_NO_THROW(counter_.addLease(createLease4("192.0.1.2", 1,
+                                                   Lease::STATE_DECLINED)));
+    ASSERT_NO_THROW(counter_.addLease(createLease4("192.0.2.1", 2,
+                                                   Lease::STATE_EXPIRED_RECLAIMED)));
+    ASSERT_NO_THROW(counter_.addLease(createLease6(Lease::TYPE_NA, "2001:db8::1", 1)));
+
+    std::vector<LeaseStatsRow> rows = counter_.getRows(AF_INET, 1, 3);
+    ASSERT_EQ(4, rows.size());
+    EXPECT_EQ(1, rows[0].subnet_id_);
+    EXPECT_EQ(Lease::TYPE_NA, rows[0].lease_type_);
+    EXPECT_EQ(Lease::STATE_DEFAULT, rows[0].lease_state_);
+    EXPECT_EQ(1, rows[0].state_count_);
+    EXPECT_EQ(1, rows[1].subnet_id_);
+    EXPECT_EQ(Lease::STATE_DECLINED, rows[1].lease_state_);
+    EXPECT_EQ(2, rows[2].subnet_id_);
+    EXPECT_EQ(Lease::STATE_EXPIRED_RECLAIMED, rows[2].lease_state_);
+    EXPECT_EQ(3, rows[3].subnet_id_);
+
+    rows = counter_.getRows(AF_INET, 2, 2);
+    ASSERT_EQ(1, rows.size());
+    EXPECT_EQ(2, rows[0].subnet_id_);
+
+    rows = counter_.getRows(AF_INET, 4, 10);
+    EXPECT_TRUE(rows.empty());
+
+    rows = counter_.getRows(AF_INET6, 1, 1);
+    ASSERT_EQ(1, rows.size());
+    EXPECT_EQ(Lease::TYPE_NA, rows[0].lease_type_);
+}
+
+// Verifies that the IPv6 addresses and prefixes are counted separately.
+TEST_F(LeaseStatsCounterTest, leaseTypes) {
+    ASSERT_NO_THROW(counter_.addLease(createLease6(Lease::TYPE_NA, "2001:db8::1", 1)));
+    ASSERT_NO_THROW(counter_.addLease(createLease6(Lease::TYPE_NA, "2001:db8::2", 1,
+                                                   Lease::STATE_DECLINED)));
+    ASSERT_NO_THROW(counter_.addLease(createLease6(Lease::TYPE_PD, "3001::", 1)));
+    EXPECT_EQ(1, counter_.getCount(1, Lease::TYPE_NA, Lease::STATE_DEFAULT));
+    EXPECT_EQ(1, counter_.getCount(1, Lease::TYPE_NA, Lease::STATE_DECLINED));
+    EXPECT_EQ(1, counter_.getCount(1, Lease::TYPE_PD, Lease::STATE_DEFAULT));
+
+    std::vector<LeaseStatsRow> rows = counter_.getRows(AF_INET6, 1, 1);
+    ASSERT_EQ(3, rows.size());
+    EXPECT_EQ(Lease::TYPE_NA, rows[0].lease_type_);
+    EXPECT_EQ(Lease::TYPE_NA, rows[1].lease_type_);
+    EXPECT_EQ(Lease::TYPE_PD, rows[2].lease_type_);
+}
+
+// Verifies that the deletion of the expired reclaimed leases is mirrored.
+TEST_F(LeaseStatsCounterTest, removeExpiredReclaimedLeases) {
+    // The leases expire at 1060.
+    ASSERT_NO_THROW(counter_.addLease(createLease4("192.0.2.1", 1,
+                                                   Lease::STATE_EXPIRED_RECLAIMED)));
+    ASSERT_NO_THROW(counter_.addLease(createLease4("192.0.2.2", 1)));
+    ASSERT_NO_THROW(counter_.addLease(createLease6(Lease::TYPE_NA, "2001:db8::1", 1,
+                                                   Lease::STATE_EXPIRED_RECLAIMED)));
+
+    // The lease did not expire strictly before.
+    EXPECT_EQ(0, counter_.removeExpiredReclaimedLeases(AF_INET, 1060));
+
+    EXPECT_EQ(1, counter_.removeExpiredReclaimedLeases(AF_INET, 1061));
+    EXPECT_EQ(0, counter_.getCount(1, Lease::TYPE_V4, Lease::STATE_EXPIRED_RECLAIMED));
+    EXPECT_EQ(1, counter_.getCount(1, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+    EXPECT_EQ(1, counter_.getCount(1, Lease::TYPE_NA, Lease::STATE_EXPIRED_RECLAIMED));
+    EXPECT_EQ(2, counter_.getLeaseCount());
+}
+
+// Verifies that the counts of a family are cleared.
+TEST_F(LeaseStatsCounterTest, clear) {
+    ASSERT_NO_THROW(counter_.addLease(createLease4("192.0.2.1", 1)));
+    ASSERT_NO_THROW(counter_.addLease(createLease6(Lease::TYPE_NA, "2001:db8::1", 1)));
+
+    ASSERT_NO_THROW(counter_.clear(AF_INET));
+    EXPECT_EQ(1, counter_.getLeaseCount());
+    EXPECT_EQ(0, counter_.getCount(1, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+    EXPECT_EQ(1, counter_.getCount(1, Lease::TYPE_NA, Lease::STATE_DEFAULT));
+
+    ASSERT_NO_THROW(counter_.clear());
+    EXPECT_EQ(0, counter_.getLeaseCount());
+    EXPECT_EQ(0, counter_.getCount(1, Lease::TYPE_NA, Lease::STATE_DEFAULT));
+}
+
+// Verifies that the queries return the assigned and declined counts of
+// the selected subnets.
+TEST_F(LeaseStatsCounterTest, query) {
+    ASSERT_NO_THROW(counter_.addLease(createLease4("192.0.1.1", 1)));
+    ASSERT_NO_THROW(counter_.addLease(createLease4("192.0.1.2", 1,
+                                                   Lease::STATE_EXPIRED_RECLAIMED)));
+    ASSERT_NO_THROW(counter_.addLease(createLease4("192.0.2.1", 2,
+                                                   Lease::STATE_DECLINED)));
+    ASSERT_NO_THROW(counter_.addLease(createLease4("192.0.3.1", 3)));
+
+    LeaseStatsCounterQuery all(counter_, AF_INET);
+    ASSERT_NO_THROW(all.start());
+    EXPECT_EQ(3, all.getRowCount());
+
+    LeaseStatsCounterQuery single(counter_, AF_INET, 2);
+    ASSERT_NO_THROW(single.start());
+    LeaseStatsRow row;
+    ASSERT_TRUE(single.getNextRow(row));
+    EXPECT_EQ(2, row.subnet_id_);
+    EXPECT_EQ(Lease::STATE_DECLINED, row.lease_state_);
+    EXPECT_EQ(1, row.state_count_);
+    EXPECT_FALSE(single.getNextRow(row));
+
+    LeaseStatsCounterQuery range(counter_, AF_INET, 2, 3);
+    ASSERT_NO_THROW(range.start());
+    EXPECT_EQ(2, range.getRowCount());
+
+    // The subnet ID is checked by the base class.
+    EXPECT_THROW(LeaseStatsCounterQuery(counter_, AF_INET, 0), BadValue);
+}
+
+} // end of anonymous namespace
@@ -0,0 +1,231 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcpsrv/lease_write_queue.h>
+#include <exceptions/exceptions.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace isc;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture class for @c LeaseWriteQueue.
+class LeaseWriteQueueTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    LeaseWriteQueueTest() : flushes_(0), blocked_(false), released_(false) {
+    }
+
+    /// @brief Flush callback counting the flushes.
+    void flush() {
+        ++flushes_;
+    }
+
+    /// @brief Write blocking the writer thread until @c release is called.
+    void block() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        blocked_ = true;
+        cv_.notify_all();
+        cv_.wait(lock, [this]() { return (released_); });
+    }
+
+    /// @brief Waits until the writer thread is blocked.
+    void waitBlocked() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return (blocked_); });
+    }
+
+    /// @brief Unblocks the writer thread.
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        released_ = true;
+        cv_.notify_all();
+    }
+
+    /// @brief Creates a queue.
+    ///
+    /// @param capacity Capacity of the queue.
+    /// @param batch_size Maximum number of writes between two flushes.
+    LeaseWriteQueuePtr createQueue(const size_t capacity,
+                                   const size_t batch_size) {
+        return (LeaseWriteQueuePtr(new LeaseWriteQueue(capacity, batch_size,
+            std::bind(&LeaseWriteQueueTest::flush, this))));
+    }
+
+    /// @brief Number of flushes.
+    std::atomic<size_t> flushes_;
+
+    /// @brief Indicates that the writer thread is blocked.
+    bool blocked_;
+
+    /// @brief Indicates that the writer thread can continue.
+    bool released_;
+
+    /// @brief Mutex protecting the flags.
+    std::mutex mutex_;
+
+    /// @brief Condition signaled when a flag changes.
+    std::condition_variable cv_;
+};
+
+// Checks that the capacity must not be 0.
+TEST_F(LeaseWriteQueueTest, zeroCapacity) {
+    EXPECT_THROW(createQueue(0, 0), BadValue);
+}
+
+// Checks that the writes are performed in order.
+TEST_F(LeaseWriteQueueTest, pushAndDrain) {
+    LeaseWriteQueuePtr queue = createQueue(16, 0);
+    EXPECT_EQ(16, queue->getCapacity());
+    EXPECT_EQ(0, queue->getLastSequence());
+    EXPECT_EQ(0, queue->getDurableSequence());
+
+    // The written values are only accessed by the writer thread before
+    // the drain.
+    std::vector<int> written;
+    for (int i = 1; i <= 10; ++i) {
+        EXPECT_EQ(i, queue->push([&written, i]() { written.push_back(i); }));
+    }
+    EXPECT_EQ(10, queue->getLastSequence());
+
+    ASSERT_NO_THROW(queue->drain());
+    EXPECT_EQ(10, queue->getDurableSequence());
+    EXPECT_EQ(0, queue->size());
+    ASSERT_EQ(10, written.size());
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(i + 1, written[i]);
+    }
+    EXPECT_LE(1, flushes_);
+}
+
+// Checks that the callbacks are invoked when the writes are durable.
+TEST_F(LeaseWriteQueueTest, whenDurable) {
+    LeaseWriteQueuePtr queue = createQueue(16, 0);
+
+    // Hold the writer thread so the next write is not durable.
+    queue->push(std::bind(&LeaseWriteQueueTest::block, this));
+    waitBlocked();
+    uint64_t sequence = queue->push([]() { });
+
+    std::atomic<int> durable(0);
+    std::atomic<int> failed(0);
+    EXPECT_TRUE(queue->whenDurable(sequence, [&](bool ok) {
+        ok ? ++durable : ++failed;
+    }));
+
+    // The sequence number must be known.
+    EXPECT_FALSE(queue->whenDurable(sequence + 1, [](bool) { }));
+
+    release();
+    ASSERT_NO_THROW(queue->drain());
+    queue->stop();
+    EXPECT_EQ(1, durable);
+    EXPECT_EQ(0, failed);
+
+    // The write is already durable.
+    EXPECT_FALSE(queue->whenDurable(sequence, [](bool) { }));
+}
+
+// Checks that the flushes follow batches of the configured size.
+TEST_F(LeaseWriteQueueTest, batchSize) {
+    LeaseWriteQueuePtr queue = createQueue(16, 2);
+
+    // The first batch holds only the blocking write.
+    queue->push(std::bind(&LeaseWriteQueueTest::block, this));
+    waitBlocked();
+    for (int i = 0; i < 5; ++i) {
+        queue->push([]() { });
+    }
+    EXPECT_EQ(5, queue->size());
+
+    release();
+    ASSERT_NO_THROW(queue->drain());
+
+    // The 5 writes are split into batches of 2, 2 and 1.
+    EXPECT_EQ(4, flushes_);
+}
+
+// Checks that a failed write is reported to the callbacks.
+TEST_F(LeaseWriteQueueTest, failedWrite) {
+    LeaseWriteQueuePtr queue = createQueue(16, 0);
+
+    queue->push(std::bind(&LeaseWriteQueueTest::block, this));
+    waitBlocked();
+    uint64_t sequence = queue->push([]() {
+        isc_throw(Unexpected, "disk full");
+    });
+
+    std::atomic<int> durable(0);
+    std::atomic<int> failed(0);
+    EXPECT_TRUE(queue->whenDurable(sequence, [&](bool ok) {
+        ok ? ++durable : ++failed;
+    }));
+
+    release();
+    ASSERT_NO_THROW(queue->drain());
+    queue->stop();
+    EXPECT_EQ(0, durable);
+    EXPECT_EQ(1, failed);
+}
+
+// Checks that the push blocks while the queue is full.
+TEST_F(LeaseWriteQueueTest, full) {
+    LeaseWriteQueuePtr queue = createQueue(1, 0);
+
+    // The blocking write is taken from the queue so one write fits.
+    queue->push(std::bind(&LeaseWriteQueueTest::block, this));
+    waitBlocked();
+    queue->push([]() { });
+    EXPECT_EQ(1, queue->size());
+
+    std::atomic<bool> pushed(false);
+    std::thread pusher([&queue, &pushed]() {
+        queue->push([]() { });
+        pushed = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(pushed);
+
+    release();
+    pusher.join();
+    EXPECT_TRUE(pushed);
+    ASSERT_NO_THROW(queue->drain());
+    EXPECT_EQ(3, queue->getDurableSequence());
+}
+
+// Checks that the writes are performed by the caller after stop.
+TEST_F(LeaseWriteQueueTest, stop) {
+    LeaseWriteQueuePtr queue = createQueue(16, 0);
+
+    int written = 0;
+    queue->push([&written]() { ++written; });
+
+    // The queued writes are performed before the thread terminates.
+    queue->stop();
+    EXPECT_EQ(1, written);
+    EXPECT_EQ(1, queue->getDurableSequence());
+
+    // The write is performed immediately.
+    uint64_t sequence = queue->push([&written]() { ++written; });
+    EXPECT_EQ(2, written);
+    EXPECT_EQ(2, sequence);
+    EXPECT_FALSE(queue->whenDurable(sequence, [](bool) { }));
+
+    // Drain doesn't wait.
+    ASSERT_NO_THROW(queue->drain());
+}
+
+}  // namespace
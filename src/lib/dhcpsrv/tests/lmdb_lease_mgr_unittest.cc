@@ -0,0 +1,466 @@
+// Copyright (C) 2026 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/lmdb_lease_mgr.h>
+#include <dhcpsrv/testutils/test_utils.h>
+#include <dhcpsrv/tests/generic_lease_mgr_unittest.h>
+#include <exceptions/exceptions.h>
+#include <testutils/gtest_utils.h>
+#include <testutils/multi_threading_utils.h>
+#include <util/multi_threading_mgr.h>
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <stdio.h>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::db;
+using namespace isc::dhcp;
+using namespace isc::dhcp::test;
+using namespace isc::test;
+using namespace isc::util;
+using namespace std;
+
+namespace {
+
+/// @brief Returns the path of the test database file.
+std::string
+getDatabasePath() {
+    std::ostringstream s;
+    s << TEST_DATA_BUILDDIR << "/leases.mdb";
+    return (s.str());
+}
+
+/// @brief Removes the test database file and its lock file.
+void
+removeDatabase() {
+    static_cast<void>(remove(getDatabasePath().c_str()));
+    static_cast<void>(remove((getDatabasePath() + "-lock").c_str()));
+}
+
+/// @brief Returns the access string of the test database.
+std::string
+validLmdbConnectionString() {
+    return ("type=lmdb universe=4 name=" + getDatabasePath());
+}
+
+/// @brief Test fixture class for testing LMDB Lease Manager
+///
+/// Creates an empty database prior to each test and removes it afterwards.
+class LmdbLeaseMgrTest : public GenericLeaseMgrTest {
+public:
+
+    /// @brief Constructor
+    ///
+    /// Removes the database and opens a new one.
+    LmdbLeaseMgrTest() {
+        MultiThreadingMgr::instance().setMode(false);
+        removeDatabase();
+        LeaseMgrFactory::create(validLmdbConnectionString());
+        lmptr_ = &(LeaseMgrFactory::instance());
+    }
+
+    /// @brief Destructor
+    ///
+    /// Closes and removes the database.
+    virtual ~LmdbLeaseMgrTest() {
+        LeaseMgrFactory::destroy();
+        removeDatabase();
+        MultiThreadingMgr::instance().setMode(false);
+    }
+
+    /// @brief Reopen the database
+    ///
+    /// Closes the database and re-open it. Anything committed should be
+    /// visible.
+    ///
+    /// Parameter is ignored for LMDB backend as the v4 and v6 leases share
+    /// the same database.
+    void reopen(Universe) {
+        LeaseMgrFactory::destroy();
+        LeaseMgrFactory::create(validLmdbConnectionString());
+        lmptr_ = &(LeaseMgrFactory::instance());
+    }
+};
+
+/// @brief Check that the database can be opened with its parameters.
+TEST(LmdbOpenTest, OpenDatabase) {
+    MultiThreadingMgr::instance().setMode(false);
+    removeDatabase();
+
+    EXPECT_NO_THROW_LOG(LeaseMgrFactory::create(validLmdbConnectionString() +
+                                                " map-size=16"));
+    LeaseMgrFactory::destroy();
+
+    // Invalid map size.
+    EXPECT_THROW(LeaseMgrFactory::create(validLmdbConnectionString() +
+                                         " map-size=foo"), BadValue);
+
+    // The extended info tables are not supported.
+    EXPECT_THROW(LeaseMgrFactory::create(validLmdbConnectionString() +
+                                         " extended-info-tables=true"),
+                 NotImplemented);
+
+    // The database can't be created in a missing directory.
+    EXPECT_THROW(LeaseMgrFactory::create("type=lmdb universe=4 "
+                                         "name=/this/does/not/exist.mdb"),
+                 DbOpenError);
+
+    removeDatabase();
+}
+
+/// @brief Check the getType() method
+TEST_F(LmdbLeaseMgrTest, getType) {
+    EXPECT_EQ(std::string("lmdb"), lmptr_->getType());
+}
+
+/// @brief Check getName() returns the database file name
+TEST_F(LmdbLeaseMgrTest, getName) {
+    EXPECT_EQ(getDatabasePath(), lmptr_->getName());
+}
+
+/// @brief Check that getVersion() returns the expected version
+TEST_F(LmdbLeaseMgrTest, checkVersion) {
+    pair<uint32_t, uint32_t> version;
+    ASSERT_NO_THROW(version = lmptr_->getVersion());
+    EXPECT_EQ(LmdbLeaseMgr::MAJOR_VERSION, version.first);
+    EXPECT_EQ(LmdbLeaseMgr::MINOR_VERSION, version.second);
+}
+
+/// @brief Check that the leases persist when the database is reopened.
+TEST_F(LmdbLeaseMgrTest, persistLeases) {
+    Lease4Ptr lease4 = initializeLease4(straddress4_[1]);
+    EXPECT_TRUE(lmptr_->addLease(lease4));
+    Lease6Ptr lease6 = initializeLease6(straddress6_[1]);
+    EXPECT_TRUE(lmptr_->addLease(lease6));
+
+    reopen(V4);
+
+    Lease4Ptr l_returned4 = lmptr_->getLease4(ioaddress4_[1]);
+    ASSERT_TRUE(l_returned4);
+    detailCompareLease(lease4, l_returned4);
+
+    Lease6Ptr l_returned6 = lmptr_->getLease6(leasetype6_[1], ioaddress6_[1]);
+    ASSERT_TRUE(l_returned6);
+    detailCompareLease(lease6, l_returned6);
+
+    // The index entries persist too.
+    ASSERT_TRUE(lease4->hwaddr_);
+    EXPECT_EQ(1, lmptr_->getLease4(*lease4->hwaddr_).size());
+    EXPECT_EQ(1, lmptr_->getLeases4(lease4->subnet_id_).size());
+    ASSERT_TRUE(lease6->duid_);
+    EXPECT_EQ(1, lmptr_->getLeases6(*lease6->duid_).size());
+}
+
+/// @brief Check that an update moves the index entries of a lease.
+TEST_F(LmdbLeaseMgrTest, updateIndexes) {
+    Lease4Ptr lease = initializeLease4(straddress4_[1]);
+    ASSERT_TRUE(lmptr_->addLease(lease));
+    SubnetID old_subnet_id = lease->subnet_id_;
+    ASSERT_TRUE(lease->hwaddr_);
+    HWAddr old_hwaddr = *lease->hwaddr_;
+
+    lease->subnet_id_ = old_subnet_id + 1;
+    lease->hwaddr_.reset(new HWAddr(vector<uint8_t>(6, 0x42), HTYPE_ETHER));
+    ASSERT_NO_THROW(lmptr_->updateLease4(lease));
+
+    EXPECT_TRUE(lmptr_->getLeases4(old_subnet_id).empty());
+    EXPECT_EQ(1, lmptr_->getLeases4(old_subnet_id + 1).size());
+    EXPECT_TRUE(lmptr_->getLease4(old_hwaddr).empty());
+    EXPECT_EQ(1, lmptr_->getLease4(*lease->hwaddr_).size());
+
+    // A stale lease can't be updated or deleted.
+    Lease4Ptr stale(new Lease4(*lease));
+    stale->current_cltt_ -= 10;
+    EXPECT_THROW(lmptr_->updateLease4(stale), NoSuchLease);
+    EXPECT_FALSE(lmptr_->deleteLease(stale));
+
+    EXPECT_TRUE(lmptr_->deleteLease(lease));
+    EXPECT_TRUE(lmptr_->getLeases4(old_subnet_id + 1).empty());
+    EXPECT_TRUE(lmptr_->getLease4(*lease->hwaddr_).empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// LEASE4 /////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Basic Lease4 Checks
+TEST_F(LmdbLeaseMgrTest, basicLease4) {
+    testBasicLease4();
+}
+
+/// @brief Basic Lease4 Checks
+TEST_F(LmdbLeaseMgrTest, basicLease4MultiThreading) {
+    MultiThreadingTest mt(true);
+    testBasicLease4();
+}
+
+/// @brief Checks that the lease can be updated.
+TEST_F(LmdbLeaseMgrTest, updateLease4) {
+    testUpdateLease4();
+}
+
+/// @brief Checks that a changed lease is not updated.
+TEST_F(LmdbLeaseMgrTest, concurrentUpdateLease4) {
+    testConcurrentUpdateLease4();
+}
+
+/// @brief Check GetLease4 methods - access by Hardware Address
+TEST_F(LmdbLeaseMgrTest, getLease4HWAddr1) {
+    testGetLease4HWAddr1();
+}
+
+/// @brief Check GetLease4 methods - access by Hardware Address
+TEST_F(LmdbLeaseMgrTest, getLease4HWAddr2) {
+    testGetLease4HWAddr2();
+}
+
+/// @brief Check GetLease4 methods - access by Hardware Address & Subnet ID
+TEST_F(LmdbLeaseMgrTest, getLease4HwaddrSubnetId) {
+    testGetLease4HWAddrSubnetId();
+}
+
+/// @brief Check GetLease4 methods - access by Client ID
+TEST_F(LmdbLeaseMgrTest, getLease4ClientId) {
+    testGetLease4ClientId();
+}
+
+/// @brief Check GetLease4 methods - access by Client ID
+TEST_F(LmdbLeaseMgrTest, getLease4ClientId2) {
+    testGetLease4ClientId2();
+}
+
+/// @brief Check GetLease4 methods - access by Client ID & Subnet ID
+TEST_F(LmdbLeaseMgrTest, getLease4ClientIdSubnetId) {
+    testGetLease4ClientIdSubnetId();
+}
+
+/// @brief Verifies that IPv4 leases can be retrieved by subnet identifier.
+TEST_F(LmdbLeaseMgrTest, getLeases4SubnetId) {
+    testGetLeases4SubnetId();
+}
+
+/// @brief Verifies that IPv4 leases can be retrieved by hostname.
+TEST_F(LmdbLeaseMgrTest, getLeases4Hostname) {
+    testGetLeases4Hostname();
+}
+
+/// @brief Verifies that all IPv4 leases can be retrieved.
+TEST_F(LmdbLeaseMgrTest, getLeases4) {
+    testGetLeases4();
+}
+
+/// @brief Test that a range of IPv4 leases is returned with paging.
+TEST_F(LmdbLeaseMgrTest, getLeases4Paged) {
+    testGetLeases4Paged();
+}
+
+/// @brief Test that a range of IPv4 leases is returned with paging.
+TEST_F(LmdbLeaseMgrTest, getLeases4PagedMultiThreading) {
+    MultiThreadingTest mt(true);
+    testGetLeases4Paged();
+}
+
+/// @brief Checks that a lease with a null client identifier is handled.
+TEST_F(LmdbLeaseMgrTest, lease4NullClientId) {
+    testLease4NullClientId();
+}
+
+/// @brief Check that the expired DHCPv4 leases can be retrieved.
+TEST_F(LmdbLeaseMgrTest, getExpiredLeases4) {
+    testGetExpiredLeases4();
+}
+
+/// @brief Check that the infinite lifetime leases are not expired.
+TEST_F(LmdbLeaseMgrTest, infiniteAreNotExpired4) {
+    testInfiniteAreNotExpired4();
+}
+
+/// @brief Check that expired reclaimed DHCPv4 leases are removed.
+TEST_F(LmdbLeaseMgrTest, deleteExpiredReclaimedLeases4) {
+    testDeleteExpiredReclaimedLeases4();
+}
+
+/// @brief Tests that leases from specific subnet can be removed.
+TEST_F(LmdbLeaseMgrTest, wipeLeases4) {
+    testWipeLeases4();
+}
+
+/// @brief Tests the bulk operations on IPv4 leases.
+TEST_F(LmdbLeaseMgrTest, bulkLeases4) {
+    testBulkLeases4();
+}
+
+/// @brief Verifies that IPv4 lease statistics can be recalculated.
+TEST_F(LmdbLeaseMgrTest, recountLeaseStats4) {
+    testRecountLeaseStats4();
+}
+
+/// @brief Tests v4 lease stats query variants.
+TEST_F(LmdbLeaseMgrTest, leaseStatsQuery4) {
+    testLeaseStatsQuery4();
+}
+
+/// @brief Verifies that v4 class lease counts are correctly adjusted
+/// when leases have class lists.
+TEST_F(LmdbLeaseMgrTest, classLeaseCount4) {
+    testClassLeaseCount4();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// LEASE6 /////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Test checks whether simple add, get and delete operations
+/// are possible on Lease6
+TEST_F(LmdbLeaseMgrTest, testAddGetDelete6) {
+    testAddGetDelete6();
+}
+
+/// @brief Basic Lease6 Checks
+TEST_F(LmdbLeaseMgrTest, basicLease6) {
+    testBasicLease6();
+}
+
+/// @brief Basic Lease6 Checks
+TEST_F(LmdbLeaseMgrTest, basicLease6MultiThreading) {
+    MultiThreadingTest mt(true);
+    testBasicLease6();
+}
+
+/// @brief Check that the IAID is stored as an unsigned value.
+TEST_F(LmdbLeaseMgrTest, leases6LargeIaidCheck) {
+    testLease6LargeIaidCheck();
+}
+
+/// @brief Check GetLease6 methods - access by DUID/IAID
+TEST_F(LmdbLeaseMgrTest, getLeases6DuidIaid) {
+    testGetLeases6DuidIaid();
+}
+
+/// @brief Check that the lease type is checked.
+TEST_F(LmdbLeaseMgrTest, lease6LeaseTypeCheck) {
+    testLease6LeaseTypeCheck();
+}
+
+/// @brief Check GetLease6 methods - access by DUID/IAID/SubnetID
+TEST_F(LmdbLeaseMgrTest, getLease6DuidIaidSubnetId) {
+    testGetLease6DuidIaidSubnetId();
+}
+
+/// @brief Verifies that IPv6 leases can be retrieved by DUID.
+TEST_F(LmdbLeaseMgrTest, getLeases6Duid) {
+    testGetLeases6Duid();
+}
+
+/// @brief Verifies that IPv6 leases can be retrieved by subnet identifier.
+TEST_F(LmdbLeaseMgrTest, getLeases6SubnetId) {
+    testGetLeases6SubnetId();
+}
+
+/// @brief Verifies that IPv6 leases can be retrieved by hostname.
+TEST_F(LmdbLeaseMgrTest, getLeases6Hostname) {
+    testGetLeases6Hostname();
+}
+
+/// @brief Verifies that all IPv6 leases can be retrieved.
+TEST_F(LmdbLeaseMgrTest, getLeases6) {
+    testGetLeases6();
+}
+
+/// @brief Test that a range of IPv6 leases is returned with paging.
+TEST_F(LmdbLeaseMgrTest, getLeases6Paged) {
+    testGetLeases6Paged();
+}
+
+/// @brief Checks that the lease can be updated.
+TEST_F(LmdbLeaseMgrTest, updateLease6) {
+    testUpdateLease6();
+}
+
+/// @brief Checks that a changed lease is not updated.
+TEST_F(LmdbLeaseMgrTest, concurrentUpdateLease6) {
+    testConcurrentUpdateLease6();
+}
+
+/// @brief Check that the expired DHCPv6 leases can be retrieved.
+TEST_F(LmdbLeaseMgrTest, getExpiredLeases6) {
+    testGetExpiredLeases6();
+}
+
+/// @brief Check that the infinite lifetime leases are not expired.
+TEST_F(LmdbLeaseMgrTest, infiniteAreNotExpired6) {
+    testInfiniteAreNotExpired6();
+}
+
+/// @brief Check that expired reclaimed DHCPv6 leases are removed.
+TEST_F(LmdbLeaseMgrTest, deleteExpiredReclaimedLeases6) {
+    testDeleteExpiredReclaimedLeases6();
+}
+
+/// @brief Tests that leases from specific subnet can be removed.
+TEST_F(LmdbLeaseMgrTest, wipeLeases6) {
+    testWipeLeases6();
+}
+
+/// @brief Tests the bulk operations on IPv6 leases.
+TEST_F(LmdbLeaseMgrTest, bulkLeases6) {
+    testBulkLeases6();
+}
+
+/// @brief Verifies that IPv6 lease statistics can be recalculated.
+TEST_F(LmdbLeaseMgrTest, recountLeaseStats6) {
+    testRecountLeaseStats6();
+}
+
+/// @brief Tests v6 lease stats query variants.
+TEST_F(LmdbLeaseMgrTest, leaseStatsQuery6) {
+    testLeaseStatsQuery6();
+}
+
+/// @brief Verifies that v6 IA_NA class lease counts are correctly adjusted
+/// when leases have class lists.
+TEST_F(LmdbLeaseMgrTest, classLeaseCount6_NA) {
+    testClassLeaseCount6(Lease::TYPE_NA);
+}
+
+/// @brief Verifies that v6 IA_PD class lease counts are correctly adjusted
+/// when leases have class lists.
+TEST_F(LmdbLeaseMgrTest, classLeaseCount6_PD) {
+    testClassLeaseCount6(Lease::TYPE_PD);
+}
+
+/// @brief Checks that a null user context allows allocation.
+TEST_F(LmdbLeaseMgrTest, checkLimitsNull) {
+    std::string text;
+    ASSERT_NO_THROW_LOG(text = LeaseMgrFactory::instance().checkLimits4(nullptr));
+    EXPECT_TRUE(text.empty());
+    ASSERT_NO_THROW_LOG(text = LeaseMgrFactory::instance().checkLimits6(nullptr));
+    EXPECT_TRUE(text.empty());
+}
+
+/// @brief Checks that the extended info queries are not supported.
+TEST_F(LmdbLeaseMgrTest, extendedInfoNotImplemented) {
+    LeasePageSize page_size(10);
+    EXPECT_THROW(lmptr_->getLeases4ByRelayId(vector<uint8_t>(1, 1),
+                                             IOAddress::IPV4_ZERO_ADDRESS(),
+                                             page_size),
+                 NotImplemented);
+    EXPECT_THROW(lmptr_->buildExtendedInfoTables6(false, false),
+                 NotImplemented);
+}
+
+} // namespace
@@ -0,0 +1,233 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/host_data_source_factory.h>
+#include <dhcpsrv/host_mgr.h>
+#include <dhcpsrv/lru_host_cache.h>
+#include <dhcpsrv/testutils/host_data_source_utils.h>
+#include <dhcpsrv/testutils/memory_host_data_source.h>
+#include <exceptions/exceptions.h>
+#include <stats/stats_mgr.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::db;
+using namespace isc::dhcp;
+using namespace isc::dhcp::test;
+using namespace isc::stats;
+
+namespace {
+
+/// @brief Test fixture for exercising LruHostCache.
+class LruHostCacheTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    LruHostCacheTest() {
+        StatsMgr::instance().removeAll();
+    }
+
+    /// @brief Destructor.
+    virtual ~LruHostCacheTest() {
+        StatsMgr::instance().removeAll();
+    }
+
+    /// @brief Creates an IPv4 host reservation.
+    ///
+    /// The host is not connected to an IPv6 subnet so it takes only one
+    /// cache entry.
+    ///
+    /// @param address reserved address.
+    HostPtr createHost4(const std::string& address) {
+        HostPtr host = HostDataSourceUtils::initializeHost4(address,
+                                                            Host::IDENT_HWADDR);
+        host->setIPv6SubnetID(SUBNET_ID_UNUSED);
+        return (host);
+    }
+
+    /// @brief Looks for an IPv4 host in the cache.
+    ///
+    /// @param cache the cache.
+    /// @param host the host to look for.
+    ConstHostPtr get4(const LruHostCache& cache, const ConstHostPtr& host) {
+        return (cache.get4(host->getIPv4SubnetID(), host->getIdentifierType(),
+                           &host->getIdentifier()[0],
+                           host->getIdentifier().size()));
+    }
+
+    /// @brief Returns the value of a statistic.
+    ///
+    /// @param name statistic name.
+    int64_t getStat(const std::string& name) {
+        ObservationPtr obs = StatsMgr::instance().getObservation(name);
+        return (obs ? obs->getInteger().first : 0);
+    }
+};
+
+// Verifies that the hosts are cached and the least recently used one is
+// evicted when the cache is full.
+TEST_F(LruHostCacheTest, lru) {
+    EXPECT_THROW(LruHostCache(0, 0), BadValue);
+
+    LruHostCache cache(2, 0);
+    EXPECT_EQ("lru-cache", cache.getType());
+    EXPECT_EQ(2, cache.capacity());
+    HostPtr host1 = createHost4("192.0.2.1");
+    HostPtr host2 = createHost4("192.0.2.2");
+    HostPtr host3 = createHost4("192.0.2.3");
+
+    EXPECT_FALSE(get4(cache, host1));
+    EXPECT_EQ(0, cache.insert(host1, true));
+    EXPECT_EQ(0, cache.insert(host2, true));
+    EXPECT_EQ(2, cache.size());
+
+    // Use the first host so the second is evicted by the third.
+    EXPECT_EQ(host1, get4(cache, host1));
+    EXPECT_EQ(0, cache.insert(host3, true));
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(host1, get4(cache, host1));
+    EXPECT_FALSE(get4(cache, host2));
+    EXPECT_EQ(host3, get4(cache, host3));
+
+    EXPECT_EQ(3, getStat("host-cache-hits"));
+    EXPECT_EQ(2, getStat("host-cache-misses"));
+
+    // Other lookups are not answered.
+    EXPECT_FALSE(cache.get4(host1->getIPv4SubnetID(),
+                            host1->getIPv4Reservation()));
+    EXPECT_TRUE(cache.getAll4(host1->getIPv4Reservation()).empty());
+
+    cache.flush(1);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_EQ(host3, get4(cache, host3));
+    cache.flush(0);
+    EXPECT_EQ(0, cache.size());
+}
+
+// Verifies the conflict handling and the removal of cached hosts.
+TEST_F(LruHostCacheTest, insertRemove) {
+    LruHostCache cache(10, 0);
+    HostPtr host = createHost4("192.0.2.1");
+    HostPtr negative(new Host(*host));
+    negative->setNegative(true);
+
+    // A negative answer does not replace a cached host.
+    EXPECT_EQ(0, cache.insert(host, true));
+    EXPECT_EQ(1, cache.insert(negative, false));
+    EXPECT_EQ(host, get4(cache, host));
+
+    // A host replaces a negative answer.
+    cache.flush(0);
+    EXPECT_EQ(0, cache.insert(negative, false));
+    EXPECT_TRUE(get4(cache, host)->getNegative());
+    EXPECT_EQ(1, cache.insert(host, true));
+    EXPECT_EQ(1, cache.size());
+    EXPECT_EQ(host, get4(cache, host));
+
+    // A copy does not remove the object.
+    EXPECT_FALSE(cache.remove(negative));
+    EXPECT_TRUE(cache.remove(host));
+    EXPECT_EQ(0, cache.size());
+
+    // The deletions remove the entries but let the host backends be called.
+    cache.insert(host, true);
+    EXPECT_FALSE(cache.del(host->getIPv4SubnetID(), host->getIPv4Reservation()));
+    EXPECT_EQ(0, cache.size());
+    cache.insert(host, true);
+    EXPECT_FALSE(cache.del4(host->getIPv4SubnetID(), host->getIdentifierType(),
+                            &host->getIdentifier()[0],
+                            host->getIdentifier().size()));
+    EXPECT_EQ(0, cache.size());
+}
+
+// Verifies that the entries expire.
+TEST_F(LruHostCacheTest, ttl) {
+    LruHostCache cache(10, 1);
+    EXPECT_EQ(1, cache.getTtl());
+    HostPtr host = createHost4("192.0.2.1");
+    cache.insert(host, true);
+    EXPECT_EQ(host, get4(cache, host));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    EXPECT_FALSE(get4(cache, host));
+    EXPECT_EQ(0, cache.size());
+}
+
+/// @brief Test host data source.
+class TestHostDataSource : public MemHostDataSource {
+public:
+
+    /// Type
+    string getType() const {
+        return ("test");
+    }
+};
+
+// Verifies that the host manager puts the cache in front of a host
+// backend configured with a cache size.
+TEST_F(LruHostCacheTest, hostMgr) {
+    boost::shared_ptr<TestHostDataSource> memptr(new TestHostDataSource());
+    auto testFactory = [memptr](const DatabaseConnection::ParameterMap&) {
+        return (memptr);
+    };
+    HostDataSourceFactory::registerFactory("test", testFactory);
+
+    HostMgr::create();
+    HostMgr::addBackend("type=test cache-size=10 cache-ttl=60 cache-negative=true");
+    ASSERT_TRUE(HostMgr::checkCacheBackend());
+    EXPECT_TRUE(HostMgr::instance().getNegativeCaching());
+    LruHostCachePtr cache = boost::dynamic_pointer_cast<LruHostCache>(
+        HostMgr::instance().getHostDataSource());
+    ASSERT_TRUE(cache);
+    EXPECT_EQ(10, cache->capacity());
+    EXPECT_EQ(60, cache->getTtl());
+
+    // The host is found once in the host backend and then in the cache.
+    HostPtr host = createHost4("192.0.2.1");
+    memptr->add(host);
+    for (int i = 0; i < 2; ++i) {
+        ConstHostPtr got = HostMgr::instance().get4(host->getIPv4SubnetID(),
+                                                    host->getIdentifierType(),
+                                                    &host->getIdentifier()[0],
+                                                    host->getIdentifier().size());
+        ASSERT_TRUE(got);
+        HostDataSourceUtils::compareHosts(got, host);
+    }
+    EXPECT_EQ(1, getStat("host-cache-hits"));
+    EXPECT_EQ(1, getStat("host-cache-misses"));
+
+    // The absence of a reservation is cached too.
+    HostPtr other = createHost4("192.0.2.2");
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_FALSE(HostMgr::instance().get4(other->getIPv4SubnetID(),
+                                              other->getIdentifierType(),
+                                              &other->getIdentifier()[0],
+                                              other->getIdentifier().size()));
+    }
+    EXPECT_EQ(2, cache->size());
+    EXPECT_EQ(2, getStat("host-cache-hits"));
+
+    // The deletion reaches the host backend.
+    EXPECT_TRUE(HostMgr::instance().del(host->getIPv4SubnetID(),
+                                        host->getIPv4Reservation()));
+    EXPECT_EQ(1, cache->size());
+
+    HostMgr::instance().flushCache();
+    EXPECT_EQ(0, cache->size());
+
+    HostMgr::create();
+    HostDataSourceFactory::deregisterFactory("test");
+}
+
+} // end of anonymous namespace
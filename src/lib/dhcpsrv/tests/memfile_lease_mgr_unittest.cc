@@ -29,11 +29,17 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib>
 #include <iostream>
+#include <mutex>
 #include <fstream>
 #include <queue>
 #include <sstream>
+#include <thread>
+#include <unordered_set>
 
 #include <unistd.h>
 
@@ -98,6 +104,7 @@ public:
 
     using Memfile_LeaseMgr::lfcCallback;
     using Memfile_LeaseMgr::setExtendedInfoTablesEnabled;
+    using Memfile_LeaseMgr::extended_info4_;
     using Memfile_LeaseMgr::relay_id6_;
     using Memfile_LeaseMgr::remote_id6_;
 };
@@ -183,6 +190,12 @@ public:
             LeaseFileIO io(Memfile_LeaseMgr::appendSuffix(base_name, type));
             io.removeFile();
         }
+        LeaseFileIO io(Memfile_LeaseMgr::appendSuffix(base_name,
+            Memfile_LeaseMgr::FILE_EXTENDED_INFO));
+        io.removeFile();
+        LeaseFileIO snapshot_io(Memfile_LeaseMgr::appendSuffix(base_name,
+            Memfile_LeaseMgr::FILE_SNAPSHOT));
+        snapshot_io.removeFile();
     }
 
     /// @brief Remove other files.
@@ -456,6 +469,23 @@ TEST_F(MemfileLeaseMgrTest, getTypeAndName) {
     EXPECT_EQ(std::string("memory"),  lmptr_->getName());
 }
 
+/// @brief Checks that the memory statistics report the lease counts.
+TEST_F(MemfileLeaseMgrTest, getMemoryStats) {
+    startBackend(V4);
+    ConstElementPtr stats = lmptr_->getMemoryStats();
+    ASSERT_TRUE(stats);
+    ASSERT_TRUE(stats->get("leases4"));
+    EXPECT_EQ(0, stats->get("leases4")->intValue());
+
+    vector<Lease4Ptr> leases = createLeases4();
+    EXPECT_TRUE(lmptr_->addLease(leases[1]));
+    EXPECT_TRUE(lmptr_->addLease(leases[2]));
+    stats = lmptr_->getMemoryStats();
+    EXPECT_EQ(2, stats->get("leases4")->intValue());
+    ASSERT_TRUE(stats->get("leases6"));
+    EXPECT_EQ(0, stats->get("leases6")->intValue());
+}
+
 /// @brief Checks if the path to the lease files is initialized correctly.
 TEST_F(MemfileLeaseMgrTest, getLeaseFilePath) {
     // Initialize IO objects, so as the test csv files get removed after the
@@ -509,6 +539,150 @@ TEST_F(MemfileLeaseMgrTest, persistLeases) {
     EXPECT_FALSE(lease_mgr->persistLeases(Memfile_LeaseMgr::V6));
 }
 
+/// @brief Check that the leases are persisted in the binary lease journal.
+TEST_F(MemfileLeaseMgrTest, leaseJournal) {
+    LeaseFileIO io4(getLeaseFilePath("leasefile4_0.journal"));
+
+    DatabaseConnection::ParameterMap pmap;
+    pmap["universe"] = "4";
+    pmap["lfc-interval"] = "0";
+    pmap["name"] = getLeaseFilePath("leasefile4_0.journal");
+    pmap["lease-file-format"] = "binary";
+    pmap["fsync-records"] = "1";
+    boost::scoped_ptr<Memfile_LeaseMgr> lease_mgr(new Memfile_LeaseMgr(pmap));
+    EXPECT_TRUE(lease_mgr->persistLeases(Memfile_LeaseMgr::V4));
+    EXPECT_EQ(pmap["name"], lease_mgr->getLeaseFilePath(Memfile_LeaseMgr::V4));
+
+    uint8_t hwaddr_data[] = { 0, 1, 2, 3, 4, 5 };
+    HWAddrPtr hwaddr(new HWAddr(hwaddr_data, sizeof(hwaddr_data), HTYPE_ETHER));
+    Lease4Ptr lease(new Lease4(IOAddress("192.0.2.1"), hwaddr, 0, 0,
+                               200, time(0), 1));
+    ASSERT_TRUE(lease_mgr->addLease(lease));
+    lease->valid_lft_ = 300;
+    ASSERT_NO_THROW(lease_mgr->updateLease4(lease));
+    lease_mgr.reset();
+    EXPECT_TRUE(LeaseJournal::isJournal(pmap["name"]));
+
+    // The leases are loaded from the journal.
+    lease_mgr.reset(new Memfile_LeaseMgr(pmap));
+    Lease4Ptr loaded = lease_mgr->getLease4(IOAddress("192.0.2.1"));
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(300, loaded->valid_lft_);
+    lease_mgr.reset();
+
+    // An unknown format is rejected.
+    pmap["lease-file-format"] = "xml";
+    EXPECT_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)), BadValue);
+}
+
+/// @brief Checks that the leases are written in background in the
+/// write-behind mode.
+TEST_F(MemfileLeaseMgrTest, writeBehind) {
+    MultiThreadingMgr::instance().setMode(true);
+    LeaseFileIO io4(getLeaseFilePath("leasefile4_0.journal"));
+
+    DatabaseConnection::ParameterMap pmap;
+    pmap["universe"] = "4";
+    pmap["lfc-interval"] = "0";
+    pmap["name"] = getLeaseFilePath("leasefile4_0.journal");
+    pmap["lease-file-format"] = "binary";
+    pmap["fsync-records"] = "16";
+    pmap["write-behind"] = "true";
+    pmap["write-behind-queue-size"] = "8";
+    boost::scoped_ptr<Memfile_LeaseMgr> lease_mgr(new Memfile_LeaseMgr(pmap));
+
+    uint8_t hwaddr_data[] = { 0, 1, 2, 3, 4, 5 };
+    HWAddrPtr hwaddr(new HWAddr(hwaddr_data, sizeof(hwaddr_data), HTYPE_ETHER));
+    for (uint8_t i = 1; i <= 20; ++i) {
+        Lease4Ptr lease(new Lease4(IOAddress(0xc0000200 + i), hwaddr, 0, 0,
+                                   200, time(0), 1));
+        ASSERT_TRUE(lease_mgr->addLease(lease));
+    }
+
+    // The callback is invoked by the writer thread when the last lease
+    // written by this thread is durable, unless it is already durable.
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool invoked = false;
+    bool durable = false;
+    bool registered = lease_mgr->whenLeasesDurable([&](bool ok) {
+        std::lock_guard<std::mutex> lock(mutex);
+        invoked = true;
+        durable = ok;
+        cv.notify_all();
+    });
+    if (registered) {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5),
+                                [&invoked]() { return (invoked); }));
+        EXPECT_TRUE(durable);
+    }
+
+    // The queued writes are performed before the backend is destroyed.
+    lease_mgr.reset();
+    MultiThreadingMgr::instance().setMode(false);
+    lease_mgr.reset(new Memfile_LeaseMgr(pmap));
+    for (uint8_t i = 1; i <= 20; ++i) {
+        EXPECT_TRUE(lease_mgr->getLease4(IOAddress(0xc0000200 + i)));
+    }
+
+    // Without multi-threading the leases are written immediately.
+    EXPECT_FALSE(lease_mgr->whenLeasesDurable([](bool) { }));
+    lease_mgr.reset();
+
+    // Invalid values are rejected.
+    pmap["write-behind"] = "maybe";
+    EXPECT_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)), BadValue);
+    pmap["write-behind"] = "true";
+    pmap["write-behind-queue-size"] = "0";
+    EXPECT_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)), BadValue);
+}
+
+/// @brief Checks that the lookups run concurrently with the updates in
+/// multi-threading mode.
+TEST_F(MemfileLeaseMgrTest, concurrentLookups) {
+    MultiThreadingMgr::instance().setMode(true);
+
+    DatabaseConnection::ParameterMap pmap;
+    pmap["universe"] = "4";
+    pmap["persist"] = "false";
+    pmap["lfc-interval"] = "0";
+    boost::scoped_ptr<Memfile_LeaseMgr> lease_mgr(new Memfile_LeaseMgr(pmap));
+
+    const uint32_t count = 1000;
+    uint8_t hwaddr_data[] = { 0, 1, 2, 3, 4, 5 };
+    HWAddrPtr hwaddr(new HWAddr(hwaddr_data, sizeof(hwaddr_data), HTYPE_ETHER));
+
+    // The readers look up the leases while the writer adds them.
+    std::atomic<bool> done(false);
+    std::atomic<size_t> found(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.push_back(std::thread([&]() {
+            while (!done) {
+                for (uint32_t j = 1; j <= count; j += 97) {
+                    if (lease_mgr->getLease4(IOAddress(0xc0000000 + j))) {
+                        ++found;
+                    }
+                }
+                lease_mgr->getLeases4(SubnetID(1));
+            }
+        }));
+    }
+    for (uint32_t j = 1; j <= count; ++j) {
+        Lease4Ptr lease(new Lease4(IOAddress(0xc0000000 + j), hwaddr, 0, 0,
+                                   200, time(0), 1));
+        ASSERT_TRUE(lease_mgr->addLease(lease));
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(count, lease_mgr->getLeases4(SubnetID(1)).size());
+    EXPECT_EQ(count, lease_mgr->getLease4(*hwaddr).size());
+}
+
 /// @brief Check if it is possible to schedule the timer to perform the Lease
 /// File Cleanup periodically.
 TEST_F(MemfileLeaseMgrTest, lfcTimer) {
@@ -625,6 +799,77 @@ TEST_F(MemfileLeaseMgrTest, leaseFileCleanup4) {
     EXPECT_EQ(result_file_contents, input_file.readFile());
 }
 
+/// @brief This test checks that the in-process cleanup of the DHCPv4 lease
+/// file works as expected.
+TEST_F(MemfileLeaseMgrTest, leaseFileCleanupInProcess4) {
+    std::string new_file_contents =
+        "address,hwaddr,client_id,valid_lifetime,expire,"
+        "subnet_id,fqdn_fwd,fqdn_rev,hostname,state,user_context\n";
+
+    std::string current_file_contents = new_file_contents +
+        "192.0.2.2,02:02:02:02:02:02,,200,200,8,1,1,,1,{ \"foo\": true }\n"
+        "192.0.2.2,02:02:02:02:02:02,,200,800,8,1,1,,1,\n";
+    LeaseFileIO current_file(getLeaseFilePath("leasefile4_0.csv"));
+    current_file.writeFile(current_file_contents);
+
+    std::string previous_file_contents = new_file_contents +
+        "192.0.2.3,03:03:03:03:03:03,,200,200,8,1,1,,1,\n"
+        "192.0.2.3,03:03:03:03:03:03,,200,800,8,1,1,,1,{ \"bar\": true }\n";
+    LeaseFileIO previous_file(getLeaseFilePath("leasefile4_0.csv.2"));
+    previous_file.writeFile(previous_file_contents);
+
+    // Create the backend using the in-process cleanup.
+    DatabaseConnection::ParameterMap pmap;
+    pmap["type"] = "memfile";
+    pmap["universe"] = "4";
+    pmap["name"] = getLeaseFilePath("leasefile4_0.csv");
+    pmap["lfc-interval"] = "1";
+    pmap["lfc-mode"] = "in-process";
+    boost::scoped_ptr<NakedMemfileLeaseMgr> lease_mgr(new NakedMemfileLeaseMgr(pmap));
+
+    // Run the lease file cleanup.
+    ASSERT_NO_THROW(lease_mgr->lfcCallback());
+
+    // The new lease file should have been created and it should contain
+    // no leases.
+    ASSERT_TRUE(current_file.exists());
+    EXPECT_EQ(new_file_contents, current_file.readFile());
+
+    // Wait for the cleanup thread to complete.
+    ASSERT_TRUE(waitForProcess(*lease_mgr, 2));
+    EXPECT_EQ(0, lease_mgr->getLFCExitStatus());
+
+    // Check if we can still write to the lease file.
+    std::vector<uint8_t> hwaddr_vec(6);
+    HWAddrPtr hwaddr(new HWAddr(hwaddr_vec, HTYPE_ETHER));
+    Lease4Ptr new_lease(new Lease4(IOAddress("192.0.2.45"), hwaddr,
+                                   static_cast<const uint8_t*>(0), 0,
+                                   100, 0, 1));
+    ASSERT_NO_THROW(lease_mgr->addLease(new_lease));
+
+    std::string updated_file_contents = new_file_contents +
+        "192.0.2.45,00:00:00:00:00:00,,100,100,1,0,0,,0,\n";
+    EXPECT_EQ(updated_file_contents, current_file.readFile());
+
+    // The leases held by the server are written in address order, which
+    // is the kea-lfc result.
+    std::string result_file_contents = new_file_contents +
+        "192.0.2.2,02:02:02:02:02:02,,200,800,8,1,1,,1,\n"
+        "192.0.2.3,03:03:03:03:03:03,,200,800,8,1,1,,1,{ \"bar\": true }\n";
+
+    LeaseFileIO input_file(getLeaseFilePath("leasefile4_0.csv.2"), false);
+    ASSERT_TRUE(input_file.exists());
+    EXPECT_EQ(result_file_contents, input_file.readFile());
+
+    // The rotated and the intermediate files should have been removed.
+    EXPECT_FALSE(LeaseFileIO(getLeaseFilePath("leasefile4_0.csv.1"),
+                             false).exists());
+    EXPECT_FALSE(LeaseFileIO(getLeaseFilePath("leasefile4_0.csv.output"),
+                             false).exists());
+    EXPECT_FALSE(LeaseFileIO(getLeaseFilePath("leasefile4_0.csv.completed"),
+                             false).exists());
+}
+
 /// @brief This test checks that the callback function executing the cleanup of the
 /// DHCPv6 lease file works as expected.
 TEST_F(MemfileLeaseMgrTest, leaseFileCleanup6) {
@@ -899,6 +1144,100 @@ TEST_F(MemfileLeaseMgrTest, basicLease4MultiThread) {
     testBasicLease4();
 }
 
+/// @brief Checks that the stored leases share equal identifiers.
+TEST_F(MemfileLeaseMgrTest, internIdentifiers4) {
+    startBackend(V4);
+
+    std::vector<uint8_t> mac(6, 1);
+    std::vector<uint8_t> client_id(8, 2);
+    Lease4Ptr lease1(new Lease4(IOAddress("192.0.2.1"),
+                                HWAddrPtr(new HWAddr(mac, HTYPE_ETHER)),
+                                ClientIdPtr(new ClientId(client_id)),
+                                3600, time(0), 1));
+    Lease4Ptr lease2(new Lease4(IOAddress("192.0.2.2"),
+                                HWAddrPtr(new HWAddr(mac, HTYPE_ETHER)),
+                                ClientIdPtr(new ClientId(client_id)),
+                                3600, time(0), 1));
+    ASSERT_TRUE(lmptr_->addLease(lease1));
+    ASSERT_TRUE(lmptr_->addLease(lease2));
+    EXPECT_EQ(lease1->hwaddr_, lease2->hwaddr_);
+    EXPECT_EQ(lease1->client_id_, lease2->client_id_);
+
+    // The updated lease is stored with the pooled identifiers.
+    Lease4Ptr updated(new Lease4(*lease2));
+    EXPECT_NE(lease1->hwaddr_, updated->hwaddr_);
+    ASSERT_NO_THROW(lmptr_->updateLease4(updated));
+    Lease4Ptr stored = lmptr_->getLease4(IOAddress("192.0.2.2"));
+    ASSERT_TRUE(stored);
+    EXPECT_EQ(*lease1->hwaddr_, *stored->hwaddr_);
+    EXPECT_EQ(*lease1->client_id_, *stored->client_id_);
+}
+
+/// @brief Checks that only the leases with a relay id or a remote id
+/// are held in the IPv4 extended info table.
+TEST_F(MemfileLeaseMgrTest, extendedInfoTable4) {
+    DatabaseConnection::ParameterMap pmap;
+    pmap["type"] = "memfile";
+    pmap["universe"] = "4";
+    pmap["name"] = getLeaseFilePath("leasefile4_0.csv");
+    pmap["lfc-interval"] = "0";
+    boost::scoped_ptr<NakedMemfileLeaseMgr> lease_mgr;
+    ASSERT_NO_THROW(lease_mgr.reset(new NakedMemfileLeaseMgr(pmap)));
+
+    std::vector<uint8_t> mac(6, 1);
+    Lease4Ptr lease1(new Lease4(IOAddress("192.0.2.1"),
+                                HWAddrPtr(new HWAddr(mac, HTYPE_ETHER)),
+                                ClientIdPtr(), 3600, time(0), 1));
+    Lease4Ptr lease2(new Lease4(IOAddress("192.0.2.2"),
+                                HWAddrPtr(new HWAddr(mac, HTYPE_ETHER)),
+                                ClientIdPtr(), 3600, time(0), 1));
+    lease2->relay_id_ = std::vector<uint8_t>(4, 0xaa);
+    ASSERT_TRUE(lease_mgr->addLease(lease1));
+    ASSERT_TRUE(lease_mgr->addLease(lease2));
+    EXPECT_EQ(1, lease_mgr->extended_info4_.size());
+
+    // An updated lease with a remote id is added to the table.
+    Lease4Ptr updated(new Lease4(*lease1));
+    updated->remote_id_ = std::vector<uint8_t>(4, 0xbb);
+    ASSERT_NO_THROW(lease_mgr->updateLease4(updated));
+    EXPECT_EQ(2, lease_mgr->extended_info4_.size());
+    Lease4Collection leases =
+        lease_mgr->getLeases4ByRemoteId(updated->remote_id_,
+                                        IOAddress::IPV4_ZERO_ADDRESS(),
+                                        LeasePageSize(10));
+    ASSERT_EQ(1, leases.size());
+    EXPECT_EQ(IOAddress("192.0.2.1"), leases[0]->addr_);
+
+    // An updated lease without ids is removed from the table.
+    updated.reset(new Lease4(*lease2));
+    updated->relay_id_.clear();
+    ASSERT_NO_THROW(lease_mgr->updateLease4(updated));
+    EXPECT_EQ(1, lease_mgr->extended_info4_.size());
+    leases = lease_mgr->getLeases4ByRelayId(lease2->relay_id_,
+                                            IOAddress::IPV4_ZERO_ADDRESS(),
+                                            LeasePageSize(10));
+    EXPECT_TRUE(leases.empty());
+
+    // A deleted lease is removed from the table.
+    ASSERT_TRUE(lease_mgr->deleteLease(lease_mgr->getLease4(IOAddress("192.0.2.1"))));
+    EXPECT_TRUE(lease_mgr->extended_info4_.empty());
+}
+
+/// @brief Checks that the stored leases share equal DUIDs.
+TEST_F(MemfileLeaseMgrTest, internIdentifiers6) {
+    startBackend(V6);
+
+    std::vector<uint8_t> duid(8, 3);
+    Lease6Ptr lease1(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8::1"),
+                                DuidPtr(new DUID(duid)), 1, 1800, 3600, 1));
+    Lease6Ptr lease2(new Lease6(Lease::TYPE_PD, IOAddress("2001:db8:1::"),
+                                DuidPtr(new DUID(duid)), 2, 1800, 3600, 1,
+                                HWAddrPtr(), 64));
+    ASSERT_TRUE(lmptr_->addLease(lease1));
+    ASSERT_TRUE(lmptr_->addLease(lease2));
+    EXPECT_EQ(lease1->duid_, lease2->duid_);
+}
+
 /// @todo Write more memfile tests
 
 /// @brief Simple test about lease4 retrieval through client id method
@@ -1090,6 +1429,21 @@ TEST_F(MemfileLeaseMgrTest, getLeases4PagedMultiThread) {
     testGetLeases4Paged();
 }
 
+/// @brief Test that a range of IPv4 leases matching a filter is returned
+/// with paging.
+TEST_F(MemfileLeaseMgrTest, getLeases4PagedFilter) {
+    startBackend(V4);
+    testGetLeases4PagedFilter();
+}
+
+/// @brief Test that a range of IPv4 leases matching a filter is returned
+/// with paging.
+TEST_F(MemfileLeaseMgrTest, getLeases4PagedFilterMultiThread) {
+    startBackend(V4);
+    MultiThreadingMgr::instance().setMode(true);
+    testGetLeases4PagedFilter();
+}
+
 /// @brief This test checks that all IPv6 leases for a specified subnet id are returned.
 TEST_F(MemfileLeaseMgrTest, getLeases6SubnetId) {
     startBackend(V6);
@@ -1222,6 +1576,65 @@ TEST_F(MemfileLeaseMgrTest, getExpiredLeases4MultiThread) {
     testGetExpiredLeases4();
 }
 
+/// @brief Check that the expiration timing wheel returns the expired DHCPv4
+/// leases spread over distant buckets in the expiration order, and follows
+/// the renewals.
+TEST_F(MemfileLeaseMgrTest, getExpiredLeases4Wheel) {
+    startBackend(V4);
+
+    uint8_t hwaddr_data[] = { 0, 1, 2, 3, 4, 5 };
+    HWAddrPtr hwaddr(new HWAddr(hwaddr_data, sizeof(hwaddr_data), HTYPE_ETHER));
+    const time_t now = time(0);
+    // The leases expire from years ago to a few seconds ago, in the
+    // reverse order of their addresses.
+    const time_t ages[] = { 400000000, 20000000, 100000, 5000, 300, 10 };
+    const size_t count = sizeof(ages) / sizeof(ages[0]);
+    for (size_t i = 0; i < count; ++i) {
+        Lease4Ptr lease(new Lease4(IOAddress(0xc0000210 - i), hwaddr, 0, 0,
+                                   100, now - ages[i] - 100, 1));
+        ASSERT_TRUE(lmptr_->addLease(lease));
+    }
+    // This lease has not expired.
+    Lease4Ptr valid(new Lease4(IOAddress("192.0.2.1"), hwaddr, 0, 0,
+                               1000, now, 1));
+    ASSERT_TRUE(lmptr_->addLease(valid));
+
+    Lease4Collection expired;
+    ASSERT_NO_THROW(lmptr_->getExpiredLeases4(expired, 0));
+    ASSERT_EQ(count, expired.size());
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(IOAddress(0xc0000210 - i), expired[i]->addr_);
+    }
+
+    // The limit returns the most expired leases.
+    expired.clear();
+    ASSERT_NO_THROW(lmptr_->getExpiredLeases4(expired, 2));
+    ASSERT_EQ(2, expired.size());
+    EXPECT_EQ(IOAddress(0xc0000210), expired[0]->addr_);
+    EXPECT_EQ(IOAddress(0xc000020f), expired[1]->addr_);
+
+    // Renew the most expired lease: it moves to the bucket of now.
+    Lease4Ptr renewed = lmptr_->getLease4(IOAddress(0xc0000210));
+    ASSERT_TRUE(renewed);
+    renewed->cltt_ = now;
+    renewed->valid_lft_ = 1000;
+    ASSERT_NO_THROW(lmptr_->updateLease4(renewed));
+    expired.clear();
+    ASSERT_NO_THROW(lmptr_->getExpiredLeases4(expired, 1));
+    ASSERT_EQ(1, expired.size());
+    EXPECT_EQ(IOAddress(0xc000020f), expired[0]->addr_);
+
+    // Let the lease expire again.
+    renewed = lmptr_->getLease4(IOAddress(0xc0000210));
+    ASSERT_TRUE(renewed);
+    renewed->cltt_ = now - 2000;
+    ASSERT_NO_THROW(lmptr_->updateLease4(renewed));
+    expired.clear();
+    ASSERT_NO_THROW(lmptr_->getExpiredLeases4(expired, 0));
+    ASSERT_EQ(count, expired.size());
+    EXPECT_EQ(IOAddress(0xc0000210), expired[count - 3]->addr_);
+}
+
 /// @brief Check that the expired DHCPv6 leases can be retrieved.
 ///
 /// This test adds a number of leases to the lease database and marks
@@ -1267,6 +1680,19 @@ TEST_F(MemfileLeaseMgrTest, deleteExpiredReclaimedLeases4MultiThread) {
     testDeleteExpiredReclaimedLeases4();
 }
 
+/// @brief Check that a batch of expired DHCPv4 leases is reclaimed.
+TEST_F(MemfileLeaseMgrTest, reclaimExpiredLeases4) {
+    startBackend(V4);
+    testReclaimExpiredLeases4();
+}
+
+/// @brief Check that a batch of expired DHCPv4 leases is reclaimed.
+TEST_F(MemfileLeaseMgrTest, reclaimExpiredLeases4MultiThread) {
+    startBackend(V4);
+    MultiThreadingMgr::instance().setMode(true);
+    testReclaimExpiredLeases4();
+}
+
 /// @brief Check that getLease6 methods discriminate by lease type.
 ///
 /// Adds six leases, two per lease type all with the same duid and iad but
@@ -2276,6 +2702,24 @@ TEST_F(MemfileLeaseMgrTest, wipeLeases6) {
     testWipeLeases6();
 }
 
+/// @brief Tests the bulk operations on IPv4 leases.
+TEST_F(MemfileLeaseMgrTest, bulkLeases4) {
+    startBackend(V4);
+    testBulkLeases4();
+}
+
+/// @brief Tests the lookup of IPv6 leases by a batch of addresses.
+TEST_F(MemfileLeaseMgrTest, getLeases6ByAddresses) {
+    startBackend(V6);
+    testGetLeases6ByAddresses();
+}
+
+/// @brief Tests the bulk operations on IPv6 leases.
+TEST_F(MemfileLeaseMgrTest, bulkLeases6) {
+    startBackend(V6);
+    testBulkLeases6();
+}
+
 /// @brief Tests v4 lease stats query variants.
 TEST_F(MemfileLeaseMgrTest, leaseStatsQuery4) {
     startBackend(V4);
@@ -2288,6 +2732,22 @@ TEST_F(MemfileLeaseMgrTest, leaseStatsQuery6) {
     testLeaseStatsQuery6();
 }
 
+/// @brief Tests v4 lease stats query variants served by the in-memory
+/// lease statistics counter.
+TEST_F(MemfileLeaseMgrTest, leaseStatsQueryInMemory4) {
+    LeaseMgrFactory::create(getConfigString(V4) + " in-memory-stats=true");
+    lmptr_ = &(LeaseMgrFactory::instance());
+    testLeaseStatsQuery4();
+}
+
+/// @brief Tests v6 lease stats query variants served by the in-memory
+/// lease statistics counter.
+TEST_F(MemfileLeaseMgrTest, leaseStatsQueryInMemory6) {
+    LeaseMgrFactory::create(getConfigString(V6) + " in-memory-stats=true");
+    lmptr_ = &(LeaseMgrFactory::instance());
+    testLeaseStatsQuery6();
+}
+
 /// @brief Tests v4 lease stats to be attributed to the wrong subnet.
 TEST_F(MemfileLeaseMgrTest, leaseStatsQueryAttribution4) {
     startBackend(V4);
@@ -4011,6 +4471,186 @@ TEST_F(MemfileLeaseMgrTest, buildExtendedInfoTables6enabled) {
     EXPECT_EQ(exp_remote_id, ex_info->id_);
 }
 
+/// @brief Checks that the leased addresses and prefixes of a subnet are
+/// collected without the expired and the reclaimed leases.
+TEST_F(MemfileLeaseMgrTest, getLeasedAddresses) {
+    DatabaseConnection::ParameterMap pmap;
+    pmap["type"] = "memfile";
+    pmap["universe"] = "6";
+    pmap["persist"] = "false";
+    pmap["lfc-interval"] = "0";
+    boost::scoped_ptr<Memfile_LeaseMgr> lease_mgr(new Memfile_LeaseMgr(pmap));
+
+    DuidPtr duid(new DUID(vector<uint8_t>(8, 1)));
+    Lease6Ptr lease(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8:1::1"),
+                               duid, 1, 100, 200, 1));
+    ASSERT_TRUE(lease_mgr->addLease(lease));
+    lease.reset(new Lease6(Lease::TYPE_PD, IOAddress("3000::"), duid, 2,
+                           100, 200, 1, HWAddrPtr(), 64));
+    ASSERT_TRUE(lease_mgr->addLease(lease));
+    lease.reset(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8:1::2"),
+                           duid, 3, 100, 200, 1));
+    lease->cltt_ = time(0) - 300;
+    lease->current_cltt_ = lease->cltt_;
+    ASSERT_TRUE(lease_mgr->addLease(lease));
+    lease.reset(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8:1::3"),
+                           duid, 4, 100, 200, 1));
+    lease->state_ = Lease::STATE_EXPIRED_RECLAIMED;
+    ASSERT_TRUE(lease_mgr->addLease(lease));
+    lease.reset(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8:2::1"),
+                           duid, 5, 100, 200, 2));
+    ASSERT_TRUE(lease_mgr->addLease(lease));
+
+    std::unordered_set<IOAddress, IOAddress::Hash> leased;
+    lease_mgr->getLeasedAddresses(1, Lease::TYPE_NA, leased);
+    ASSERT_EQ(1, leased.size());
+    EXPECT_EQ(1, leased.count(IOAddress("2001:db8:1::1")));
+
+    leased.clear();
+    lease_mgr->getLeasedAddresses(1, Lease::TYPE_PD, leased);
+    ASSERT_EQ(1, leased.size());
+    EXPECT_EQ(1, leased.count(IOAddress("3000::")));
+}
+
+/// @brief Checks that the DHCPv4 leases are saved in the lease snapshot
+/// when the lease manager is closed and restored while the lease file is
+/// unchanged.
+TEST_F(MemfileLeaseMgrTest, leaseSnapshot4) {
+    string lease_file = getLeaseFilePath("leasefile4_0.csv");
+    LeaseFileIO io(lease_file);
+    io.writeFile(
+        "address,hwaddr,client_id,valid_lifetime,expire,"
+        "subnet_id,fqdn_fwd,fqdn_rev,hostname,state,user_context\n"
+        "192.0.2.2,02:02:02:02:02:02,,200,200,8,1,1,,1,\n");
+    LeaseFileIO snapshot_io(Memfile_LeaseMgr::appendSuffix(lease_file,
+        Memfile_LeaseMgr::FILE_SNAPSHOT));
+
+    DatabaseConnection::ParameterMap pmap;
+    pmap["type"] = "memfile";
+    pmap["universe"] = "4";
+    pmap["name"] = lease_file;
+    pmap["lfc-interval"] = "0";
+    pmap["lease-snapshot"] = "true";
+    boost::scoped_ptr<NakedMemfileLeaseMgr> lease_mgr;
+    ASSERT_NO_THROW(lease_mgr.reset(new NakedMemfileLeaseMgr(pmap)));
+    EXPECT_TRUE(lease_mgr->getLease4(IOAddress("192.0.2.2")));
+
+    // Closing the lease manager saves the snapshot.
+    lease_mgr.reset();
+    ASSERT_TRUE(snapshot_io.exists());
+
+    // Replace the saved snapshot by leases which are not in the lease
+    // file to check they are restored.
+    std::vector<std::string> sources;
+    sources.push_back(Memfile_LeaseMgr::appendSuffix(lease_file,
+        Memfile_LeaseMgr::FILE_PREVIOUS));
+    sources.push_back(Memfile_LeaseMgr::appendSuffix(lease_file,
+        Memfile_LeaseMgr::FILE_INPUT));
+    sources.push_back(Memfile_LeaseMgr::appendSuffix(lease_file,
+        Memfile_LeaseMgr::FILE_FINISH));
+    sources.push_back(lease_file);
+    Lease4SnapshotFile snapshot(snapshot_io.testfile_, sources);
+    Lease4Storage storage;
+    HWAddrPtr hwaddr(new HWAddr(vector<uint8_t>(6, 3), HTYPE_ETHER));
+    storage.insert(Lease4Ptr(new Lease4(IOAddress("192.0.2.3"), hwaddr,
+                                        ClientIdPtr(), 200, time(0), 8)));
+    ASSERT_NO_THROW(snapshot.write(storage));
+
+    ASSERT_NO_THROW(lease_mgr.reset(new NakedMemfileLeaseMgr(pmap)));
+    EXPECT_FALSE(lease_mgr->getLease4(IOAddress("192.0.2.2")));
+    Lease4Ptr lease = lease_mgr->getLease4(IOAddress("192.0.2.3"));
+    ASSERT_TRUE(lease);
+
+    // The lease file still records the lease updates.
+    lease->valid_lft_ = 400;
+    ASSERT_NO_THROW(lease_mgr->updateLease4(lease));
+    lease_mgr.reset();
+    EXPECT_NE(string::npos, io.readFile().find("192.0.2.3,03:03:03:03:03:03"));
+
+    // The saved snapshot is discarded when the lease file was modified.
+    ASSERT_NO_THROW(snapshot.write(storage));
+    io.writeFile(io.readFile() +
+        "192.0.2.4,04:04:04:04:04:04,,200,200,8,1,1,,1,\n");
+    ASSERT_NO_THROW(lease_mgr.reset(new NakedMemfileLeaseMgr(pmap)));
+    EXPECT_TRUE(lease_mgr->getLease4(IOAddress("192.0.2.2")));
+    lease = lease_mgr->getLease4(IOAddress("192.0.2.3"));
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(400, lease->valid_lft_);
+    EXPECT_TRUE(lease_mgr->getLease4(IOAddress("192.0.2.4")));
+    lease_mgr.reset();
+    snapshot_io.removeFile();
+}
+
+/// @brief Checks that the extended info tables are saved when the lease
+/// manager is closed and restored while the lease file is unchanged.
+TEST_F(MemfileLeaseMgrTest, extendedInfoTables6saved) {
+    string lease_file = getLeaseFilePath("leasefile6_0.csv");
+    LeaseFileIO io(lease_file);
+    io.writeFile(
+        "address,duid,valid_lifetime,expire,subnet_id,pref_lifetime,"
+        "lease_type,iaid,prefix_len,fqdn_fwd,fqdn_rev,hostname,"
+        "hwaddr,state,user_context,hwtype,hwaddr_source\n"
+
+        "2001:db8:1::2,02:02:02:02:02:02:02:02:02:02:02:02:02,"
+        "200,200,8,100,0,7,0,1,1,,,1,"
+        "{ \"ISC\": { \"relay-info\": [ { \"hop\": 44&#x2c"
+        " \"link\": \"2001:db8::4\"&#x2c \"peer\": \"2001:db8::5\"&#x2c"
+        " \"remote-id\": \"010203040506\"&#x2c"
+        " \"relay-id\": \"6464646464646464\""
+        " } ] } },,\n"
+    );
+    LeaseFileIO xinfo_io(Memfile_LeaseMgr::appendSuffix(lease_file,
+        Memfile_LeaseMgr::FILE_EXTENDED_INFO));
+
+    DatabaseConnection::ParameterMap pmap;
+    pmap["type"] = "memfile";
+    pmap["universe"] = "6";
+    pmap["name"] = lease_file;
+    pmap["lfc-interval"] = "0";
+    pmap["extended-info-tables"] = "true";
+    boost::scoped_ptr<NakedMemfileLeaseMgr> lease_mgr;
+    ASSERT_NO_THROW(lease_mgr.reset(new NakedMemfileLeaseMgr(pmap)));
+    EXPECT_EQ(1, lease_mgr->relay_id6_.size());
+    EXPECT_EQ(1, lease_mgr->remote_id6_.size());
+
+    // Closing the lease manager saves the tables.
+    lease_mgr.reset();
+    ASSERT_TRUE(xinfo_io.exists());
+
+    // Replace the saved tables by tables which can't be built from the
+    // lease file to check they are restored.
+    std::vector<std::string> sources;
+    sources.push_back(Memfile_LeaseMgr::appendSuffix(lease_file,
+        Memfile_LeaseMgr::FILE_PREVIOUS));
+    sources.push_back(Memfile_LeaseMgr::appendSuffix(lease_file,
+        Memfile_LeaseMgr::FILE_INPUT));
+    sources.push_back(lease_file);
+    Lease6ExtendedInfoFile xinfo(xinfo_io.testfile_, sources);
+    Lease6ExtendedInfoRelayIdTable relay_id6;
+    Lease6ExtendedInfoRemoteIdTable remote_id6;
+    relay_id6.insert(Lease6ExtendedInfoPtr(
+        new Lease6ExtendedInfo(IOAddress("2001:db8:1::2"), vector<uint8_t>(4, 0xaa))));
+    ASSERT_NO_THROW(xinfo.write(relay_id6, remote_id6));
+
+    ASSERT_NO_THROW(lease_mgr.reset(new NakedMemfileLeaseMgr(pmap)));
+    ASSERT_EQ(1, lease_mgr->relay_id6_.size());
+    EXPECT_EQ(vector<uint8_t>(4, 0xaa), (*lease_mgr->relay_id6_.cbegin())->id_);
+    EXPECT_TRUE(lease_mgr->remote_id6_.empty());
+    lease_mgr.reset();
+
+    // The saved tables are discarded when the lease file was modified.
+    ASSERT_NO_THROW(xinfo.write(relay_id6, remote_id6));
+    io.writeFile(io.readFile() +
+        "2001:db8:1::3,03:03:03:03:03:03:03:03:03:03:03:03:03,"
+        "200,200,8,100,0,7,0,1,1,,,1,,,\n");
+    ASSERT_NO_THROW(lease_mgr.reset(new NakedMemfileLeaseMgr(pmap)));
+    ASSERT_EQ(1, lease_mgr->relay_id6_.size());
+    EXPECT_EQ(vector<uint8_t>(8, 0x64), (*lease_mgr->relay_id6_.cbegin())->id_);
+    EXPECT_EQ(1, lease_mgr->remote_id6_.size());
+    lease_mgr.reset();
+    xinfo_io.removeFile();
+}
+
 /// @brief Checks that buildExtendedInfoTables6 does not add extended info
 /// to tables when disabled.
 TEST_F(MemfileLeaseMgrTest, buildExtendedInfoTables6disabled) {
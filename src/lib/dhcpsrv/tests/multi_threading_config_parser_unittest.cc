@@ -78,6 +78,14 @@ TEST_F(MultiThreadingConfigParserTest, validContent) {
         "   \"thread-pool-size\": 4, \n"
         "   \"packet-queue-size\": 64 \n"
         "} \n"
+        },
+        {
+        "enable-multi-threading, with empty cpu affinities",
+        "{ \n"
+        "   \"enable-multi-threading\": true, \n"
+        "   \"cpu-affinity\": \"\", \n"
+        "   \"receiver-cpu-affinity\": \"\" \n"
+        "} \n"
         }
     };
 
@@ -166,6 +174,27 @@ TEST_F(MultiThreadingConfigParserTest, invalidContent) {
         "{ \n"
         "   \"packet-queue-size\": 200000 \n"
         "} \n"
+        },
+        {
+        "cpu-affinity not string",
+        "{ \n"
+        "   \"enable-multi-threading\": true, \n"
+        "   \"cpu-affinity\": 1 \n"
+        "} \n"
+        },
+        {
+        "cpu-affinity invalid",
+        "{ \n"
+        "   \"enable-multi-threading\": true, \n"
+        "   \"cpu-affinity\": \"3-1\" \n"
+        "} \n"
+        },
+        {
+        "receiver-cpu-affinity not available",
+        "{ \n"
+        "   \"enable-multi-threading\": true, \n"
+        "   \"receiver-cpu-affinity\": \"1023\" \n"
+        "} \n"
         }
     };
 
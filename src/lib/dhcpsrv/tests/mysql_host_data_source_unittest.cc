@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -1624,12 +1624,24 @@ TEST_F(MySQLHostMgrTest, get4) {
     testGet4(HostMgr::instance());
 }
 
+// This test verifies that the reservation of the most preferred identifier
+// is retrieved from the database and the server's configuration.
+TEST_F(MySQLHostMgrTest, get4ByIdentifiers) {
+    testGet4ByIdentifiers(HostMgr::instance());
+}
+
 // This test verifies that the IPv6 reservation can be retrieved from a
 // database.
 TEST_F(MySQLHostMgrTest, get6) {
     testGet6(HostMgr::instance());
 }
 
+// This test verifies that the reservation of the most preferred identifier
+// is retrieved from the database and the server's configuration.
+TEST_F(MySQLHostMgrTest, get6ByIdentifiers) {
+    testGet6ByIdentifiers(HostMgr::instance());
+}
+
 // This test verifies that the IPv6 prefix reservation can be retrieved
 // from a configuration file and a database.
 TEST_F(MySQLHostMgrTest, get6ByPrefix) {
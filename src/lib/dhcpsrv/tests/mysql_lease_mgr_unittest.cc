@@ -630,6 +630,17 @@ TEST_F(MySqlLeaseMgrTest, deleteExpiredReclaimedLeases4MultiThreading) {
     testDeleteExpiredReclaimedLeases4();
 }
 
+/// @brief Check that a batch of expired DHCPv4 leases is reclaimed.
+TEST_F(MySqlLeaseMgrTest, reclaimExpiredLeases4) {
+    testReclaimExpiredLeases4();
+}
+
+/// @brief Check that a batch of expired DHCPv4 leases is reclaimed.
+TEST_F(MySqlLeaseMgrTest, reclaimExpiredLeases4MultiThreading) {
+    MultiThreadingTest mt(true);
+    testReclaimExpiredLeases4();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// LEASE6 /////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -933,27 +944,76 @@ TEST_F(MySqlLeaseMgrTest, recountLeaseStats6MultiThreading) {
 }
 
 /// @brief Tests that leases from specific subnet can be removed.
-TEST_F(MySqlLeaseMgrTest, DISABLED_wipeLeases4) {
+TEST_F(MySqlLeaseMgrTest, wipeLeases4) {
     testWipeLeases4();
 }
 
 /// @brief Tests that leases from specific subnet can be removed.
-TEST_F(MySqlLeaseMgrTest, DISABLED_wipeLeases4MultiThreading) {
+TEST_F(MySqlLeaseMgrTest, wipeLeases4MultiThreading) {
     MultiThreadingTest mt(true);
     testWipeLeases4();
 }
 
 /// @brief Tests that leases from specific subnet can be removed.
-TEST_F(MySqlLeaseMgrTest, DISABLED_wipeLeases6) {
+TEST_F(MySqlLeaseMgrTest, wipeLeases6) {
     testWipeLeases6();
 }
 
 /// @brief Tests that leases from specific subnet can be removed.
-TEST_F(MySqlLeaseMgrTest, DISABLED_wipeLeases6MultiThreading) {
+TEST_F(MySqlLeaseMgrTest, wipeLeases6MultiThreading) {
     MultiThreadingTest mt(true);
     testWipeLeases6();
 }
 
+/// @brief Tests that the leases of all subnets can be removed.
+TEST_F(MySqlLeaseMgrTest, wipeAllLeases4) {
+    testWipeAllLeases4();
+}
+
+/// @brief Tests that the leases of all subnets can be removed.
+TEST_F(MySqlLeaseMgrTest, wipeAllLeases4MultiThreading) {
+    MultiThreadingTest mt(true);
+    testWipeAllLeases4();
+}
+
+/// @brief Tests that the leases of all subnets can be removed.
+TEST_F(MySqlLeaseMgrTest, wipeAllLeases6) {
+    testWipeAllLeases6();
+}
+
+/// @brief Tests that the leases of all subnets can be removed.
+TEST_F(MySqlLeaseMgrTest, wipeAllLeases6MultiThreading) {
+    MultiThreadingTest mt(true);
+    testWipeAllLeases6();
+}
+
+/// @brief Tests the bulk operations on IPv4 leases.
+TEST_F(MySqlLeaseMgrTest, bulkLeases4) {
+    testBulkLeases4();
+}
+
+/// @brief Tests the bulk operations on IPv4 leases.
+TEST_F(MySqlLeaseMgrTest, bulkLeases4MultiThreading) {
+    MultiThreadingTest mt(true);
+    testBulkLeases4();
+}
+
+/// @brief Tests the lookup of IPv6 leases by a batch of addresses.
+TEST_F(MySqlLeaseMgrTest, getLeases6ByAddresses) {
+    testGetLeases6ByAddresses();
+}
+
+/// @brief Tests the bulk operations on IPv6 leases.
+TEST_F(MySqlLeaseMgrTest, bulkLeases6) {
+    testBulkLeases6();
+}
+
+/// @brief Tests the bulk operations on IPv6 leases.
+TEST_F(MySqlLeaseMgrTest, bulkLeases6MultiThreading) {
+    MultiThreadingTest mt(true);
+    testBulkLeases6();
+}
+
 /// @brief Test fixture class for validating @c LeaseMgr using
 /// MySQL as back end and MySQL connectivity loss.
 class MySqlLeaseMgrDbLostCallbackTest : public LeaseMgrDbLostCallbackTest {
@@ -629,6 +629,59 @@ TEST_F(NetworkTest, getPropertyGlobalNoParentNoChild) {
     EXPECT_EQ(34567, net_child->getValid().get());
 }
 
+// Test that the resolved properties are returned until they are
+// invalidated.
+TEST_F(NetworkTest, resolveProperties) {
+    boost::shared_ptr<TestNetwork4> net_child(new TestNetwork4());
+    boost::shared_ptr<TestNetwork4> net_parent(new TestNetwork4());
+    net_parent->setT1(100);
+    net_child->setParent(net_parent);
+
+    // Count the calls fetching the global parameters.
+    size_t fetch_count = 0;
+    auto fetch_globals = [this, &fetch_count]() -> ConstCfgGlobalsPtr {
+        ++fetch_count;
+        return (globals_);
+    };
+    net_child->setFetchGlobalsFn(fetch_globals);
+    net_parent->setFetchGlobalsFn(fetch_globals);
+    globals_->set("valid-lifetime", Element::create(34567));
+    globals_->set("authoritative", Element::create(true));
+
+    ASSERT_NO_THROW(net_parent->resolveProperties());
+    ASSERT_NO_THROW(net_child->resolveProperties());
+
+    // The resolved values are returned without fetching the globals.
+    fetch_count = 0;
+    EXPECT_EQ(34567, net_child->getValid().get());
+    EXPECT_EQ(100, net_child->getT1().get());
+    EXPECT_TRUE(net_child->getAuthoritative().get());
+    EXPECT_TRUE(net_child->getMatchClientId().get());
+    EXPECT_TRUE(net_child->getCacheThreshold().unspecified());
+    EXPECT_EQ(0, fetch_count);
+
+    // The other inheritance modes are not resolved.
+    EXPECT_TRUE(net_child->getValid(Network::Inheritance::NONE).unspecified());
+    EXPECT_EQ(34567, net_child->getValid(Network::Inheritance::GLOBAL).get());
+    EXPECT_EQ(1, fetch_count);
+
+    // A change of the parent network is seen.
+    net_parent->setT1(200);
+    EXPECT_EQ(200, net_child->getT1().get());
+
+    // Resolve again and change a global parameter.
+    ASSERT_NO_THROW(net_parent->resolveProperties());
+    ASSERT_NO_THROW(net_child->resolveProperties());
+    globals_->set("valid-lifetime", Element::create(45678));
+    EXPECT_EQ(45678, net_child->getValid().get());
+
+    // Resolve again and change a value of the network.
+    ASSERT_NO_THROW(net_parent->resolveProperties());
+    ASSERT_NO_THROW(net_child->resolveProperties());
+    net_child->setAuthoritative(false);
+    EXPECT_FALSE(net_child->getAuthoritative().get());
+}
+
 // Test that getSiaddr() never fails.
 TEST_F(NetworkTest, getSiaddrNeverFail) {
     TestNetworkPtr net_child(new TestNetwork4());
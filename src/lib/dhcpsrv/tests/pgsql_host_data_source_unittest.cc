@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -544,6 +544,44 @@ TEST_F(PgSqlHostDataSourceTest, getPage4MultiThreading) {
     testGetPage4();
 }
 
+/// @brief Test fixture class for the host lookups through a read replica.
+///
+/// The test database is its own replica: it is not a standby server so
+/// its replication lag is always 0.
+class PgSqlHostDataSourceReplicaTest : public PgSqlHostDataSourceTest {
+public:
+
+    /// @brief Constructor
+    ///
+    /// Reopens the database with the read replica.
+    PgSqlHostDataSourceReplicaTest() {
+        HostMgr::delAllBackends();
+        HostMgr::addBackend(validPgSQLConnectionString() +
+                            " replica-host=localhost replica-max-lag=10");
+        hdsptr_ = HostMgr::instance().getHostDataSource();
+        hdsptr_->setIPReservationsUnique(true);
+    }
+};
+
+/// @brief Verifies that a host reservation added to the primary can be
+/// retrieved through the read replica.
+TEST_F(PgSqlHostDataSourceReplicaTest, basic4HWAddr) {
+    testBasic4(Host::IDENT_HWADDR);
+}
+
+/// @brief Verifies that a host reservation added to the primary can be
+/// retrieved through the read replica.
+TEST_F(PgSqlHostDataSourceReplicaTest, basic4HWAddrMultiThreading) {
+    MultiThreadingTest mt(true);
+    testBasic4(Host::IDENT_HWADDR);
+}
+
+/// @brief Verifies that the host reservations can be paged through the
+/// read replica.
+TEST_F(PgSqlHostDataSourceReplicaTest, getPage4) {
+    testGetPage4();
+}
+
 /// @brief Verifies that IPv6 host reservations in the same subnet can be retrieved
 /// by pages.
 TEST_F(PgSqlHostDataSourceTest, getPage6) {
@@ -1592,12 +1630,24 @@ TEST_F(PgSQLHostMgrTest, get4) {
     testGet4(HostMgr::instance());
 }
 
+// This test verifies that the reservation of the most preferred identifier
+// is retrieved from the database and the server's configuration.
+TEST_F(PgSQLHostMgrTest, get4ByIdentifiers) {
+    testGet4ByIdentifiers(HostMgr::instance());
+}
+
 // This test verifies that the IPv6 reservation can be retrieved from a
 // database.
 TEST_F(PgSQLHostMgrTest, get6) {
     testGet6(HostMgr::instance());
 }
 
+// This test verifies that the reservation of the most preferred identifier
+// is retrieved from the database and the server's configuration.
+TEST_F(PgSQLHostMgrTest, get6ByIdentifiers) {
+    testGet6ByIdentifiers(HostMgr::instance());
+}
+
 // This test verifies that the IPv6 prefix reservation can be retrieved
 // from a configuration file and a database.
 TEST_F(PgSQLHostMgrTest, get6ByPrefix) {
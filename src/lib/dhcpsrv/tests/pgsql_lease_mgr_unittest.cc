@@ -14,6 +14,7 @@
 #include <dhcpsrv/tests/generic_lease_mgr_unittest.h>
 #include <exceptions/exceptions.h>
 #include <pgsql/pgsql_connection.h>
+#include <pgsql/pgsql_pipeline.h>
 #include <pgsql/testutils/pgsql_schema.h>
 #include <testutils/gtest_utils.h>
 #include <testutils/multi_threading_utils.h>
@@ -597,6 +598,17 @@ TEST_F(PgSqlLeaseMgrTest, deleteExpiredReclaimedLeases4MultiThreading) {
     testDeleteExpiredReclaimedLeases4();
 }
 
+/// @brief Check that a batch of expired DHCPv4 leases is reclaimed.
+TEST_F(PgSqlLeaseMgrTest, reclaimExpiredLeases4) {
+    testReclaimExpiredLeases4();
+}
+
+/// @brief Check that a batch of expired DHCPv4 leases is reclaimed.
+TEST_F(PgSqlLeaseMgrTest, reclaimExpiredLeases4MultiThreading) {
+    MultiThreadingTest mt(true);
+    testReclaimExpiredLeases4();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// LEASE6 /////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -900,27 +912,227 @@ TEST_F(PgSqlLeaseMgrTest, recountLeaseStats6MultiThreading) {
 }
 
 /// @brief Tests that leases from specific subnet can be removed.
-TEST_F(PgSqlLeaseMgrTest, DISABLED_wipeLeases4) {
+TEST_F(PgSqlLeaseMgrTest, wipeLeases4) {
     testWipeLeases4();
 }
 
 /// @brief Tests that leases from specific subnet can be removed.
-TEST_F(PgSqlLeaseMgrTest, DISABLED_wipeLeases4MultiThreading) {
+TEST_F(PgSqlLeaseMgrTest, wipeLeases4MultiThreading) {
     MultiThreadingTest mt(true);
     testWipeLeases4();
 }
 
 /// @brief Tests that leases from specific subnet can be removed.
-TEST_F(PgSqlLeaseMgrTest, DISABLED_wipeLeases6) {
+TEST_F(PgSqlLeaseMgrTest, wipeLeases6) {
     testWipeLeases6();
 }
 
 /// @brief Tests that leases from specific subnet can be removed.
-TEST_F(PgSqlLeaseMgrTest, DISABLED_wipeLeases6MultiThreading) {
+TEST_F(PgSqlLeaseMgrTest, wipeLeases6MultiThreading) {
     MultiThreadingTest mt(true);
     testWipeLeases6();
 }
 
+/// @brief Tests that the leases of all subnets can be removed.
+TEST_F(PgSqlLeaseMgrTest, wipeAllLeases4) {
+    testWipeAllLeases4();
+}
+
+/// @brief Tests that the leases of all subnets can be removed.
+TEST_F(PgSqlLeaseMgrTest, wipeAllLeases4MultiThreading) {
+    MultiThreadingTest mt(true);
+    testWipeAllLeases4();
+}
+
+/// @brief Tests that the leases of all subnets can be removed.
+TEST_F(PgSqlLeaseMgrTest, wipeAllLeases6) {
+    testWipeAllLeases6();
+}
+
+/// @brief Tests that the leases of all subnets can be removed.
+TEST_F(PgSqlLeaseMgrTest, wipeAllLeases6MultiThreading) {
+    MultiThreadingTest mt(true);
+    testWipeAllLeases6();
+}
+
+/// @brief Tests the bulk operations on IPv4 leases.
+TEST_F(PgSqlLeaseMgrTest, bulkLeases4) {
+    testBulkLeases4();
+}
+
+/// @brief Tests the bulk operations on IPv4 leases.
+TEST_F(PgSqlLeaseMgrTest, bulkLeases4MultiThreading) {
+    MultiThreadingTest mt(true);
+    testBulkLeases4();
+}
+
+/// @brief Tests the lookup of IPv6 leases by a batch of addresses.
+TEST_F(PgSqlLeaseMgrTest, getLeases6ByAddresses) {
+    testGetLeases6ByAddresses();
+}
+
+/// @brief Tests the bulk operations on IPv6 leases.
+TEST_F(PgSqlLeaseMgrTest, bulkLeases6) {
+    testBulkLeases6();
+}
+
+/// @brief Tests the bulk operations on IPv6 leases.
+TEST_F(PgSqlLeaseMgrTest, bulkLeases6MultiThreading) {
+    MultiThreadingTest mt(true);
+    testBulkLeases6();
+}
+
+/// @brief Test fixture class for testing PostgreSQL Lease Manager in
+/// the pipeline mode.
+class PgSqlLeaseMgrPipelineTest : public PgSqlLeaseMgrTest {
+public:
+
+    /// @brief Constructor
+    ///
+    /// Reopens the database in the pipeline mode.
+    PgSqlLeaseMgrPipelineTest() {
+        LeaseMgrFactory::destroy();
+        if (!PgSqlPipeline::isSupported()) {
+            EXPECT_THROW(LeaseMgrFactory::create(validPgSQLConnectionString() +
+                                                 " pipeline=true"),
+                         DbOpenError);
+            LeaseMgrFactory::create(validPgSQLConnectionString());
+        } else {
+            LeaseMgrFactory::create(validPgSQLConnectionString() +
+                                    " pipeline=true");
+        }
+        lmptr_ = &(LeaseMgrFactory::instance());
+    }
+};
+
+/// @brief Basic Lease4 Checks in the pipeline mode.
+TEST_F(PgSqlLeaseMgrPipelineTest, basicLease4MultiThreading) {
+    MultiThreadingTest mt(true);
+    testBasicLease4();
+}
+
+/// @brief Lease4 update tests in the pipeline mode.
+TEST_F(PgSqlLeaseMgrPipelineTest, updateLease4MultiThreading) {
+    MultiThreadingTest mt(true);
+    testUpdateLease4();
+}
+
+/// @brief Lease6 add, get and delete in the pipeline mode.
+TEST_F(PgSqlLeaseMgrPipelineTest, testAddGetDelete6MultiThreading) {
+    MultiThreadingTest mt(true);
+    testAddGetDelete6();
+}
+
+/// @brief Tests the bulk operations, which use transactions, in the
+/// pipeline mode.
+TEST_F(PgSqlLeaseMgrPipelineTest, bulkLeases4MultiThreading) {
+    MultiThreadingTest mt(true);
+    testBulkLeases4();
+}
+
+/// @brief Test fixture class for testing PostgreSQL Lease Manager with
+/// a read replica.
+///
+/// The test database is its own replica: it is not a standby server so
+/// its replication lag is always 0.
+class PgSqlLeaseMgrReplicaTest : public PgSqlLeaseMgrTest {
+public:
+
+    /// @brief Constructor
+    ///
+    /// Reopens the database with the read replica.
+    PgSqlLeaseMgrReplicaTest() {
+        LeaseMgrFactory::destroy();
+        LeaseMgrFactory::create(validPgSQLConnectionString() +
+                                " replica-host=localhost replica-max-lag=10");
+        lmptr_ = &(LeaseMgrFactory::instance());
+    }
+};
+
+/// @brief Lease4 paged gets through the read replica.
+TEST_F(PgSqlLeaseMgrReplicaTest, getLeases4Paged) {
+    testGetLeases4Paged();
+}
+
+/// @brief Lease4 paged gets through the read replica.
+TEST_F(PgSqlLeaseMgrReplicaTest, getLeases4PagedMultiThreading) {
+    MultiThreadingTest mt(true);
+    testGetLeases4Paged();
+}
+
+/// @brief Lease6 paged gets through the read replica.
+TEST_F(PgSqlLeaseMgrReplicaTest, getLeases6Paged) {
+    testGetLeases6Paged();
+}
+
+/// @brief Lease4 gets by subnet through the read replica.
+TEST_F(PgSqlLeaseMgrReplicaTest, getLeases4SubnetId) {
+    testGetLeases4SubnetId();
+}
+
+/// @brief Lease4 statistics through the read replica.
+TEST_F(PgSqlLeaseMgrReplicaTest, leaseStatsQuery4) {
+    testLeaseStatsQuery4();
+}
+
+/// @brief Lease6 statistics through the read replica.
+TEST_F(PgSqlLeaseMgrReplicaTest, leaseStatsQuery6MultiThreading) {
+    MultiThreadingTest mt(true);
+    testLeaseStatsQuery6();
+}
+
+/// @brief Checks that the queries use the primary database when the read
+/// replica is not available.
+TEST_F(PgSqlLeaseMgrTest, unavailableReplica) {
+    LeaseMgrFactory::destroy();
+    ASSERT_NO_THROW(LeaseMgrFactory::create(validPgSQLConnectionString() +
+                                            " replica-host=invalidhost"));
+    lmptr_ = &(LeaseMgrFactory::instance());
+    testGetLeases4Paged();
+}
+
+/// @brief Verifies that the lowest free address of a range is allocated
+/// in a single query when single-query-allocation is enabled.
+TEST_F(PgSqlLeaseMgrTest, addFreeLease4) {
+    // Disabled by default.
+    EXPECT_FALSE(lmptr_->canAddFreeLease4());
+    Lease4Ptr lease(new Lease4(IOAddress("192.0.2.1"),
+                               HWAddrPtr(new HWAddr(vector<uint8_t>(6, 1),
+                                                    HTYPE_ETHER)),
+                               ClientIdPtr(), 3600, time(0), 1));
+    EXPECT_FALSE(lmptr_->addFreeLease4(lease, IOAddress("192.0.2.1"),
+                                       IOAddress("192.0.2.3")));
+
+    LeaseMgrFactory::destroy();
+    ASSERT_NO_THROW(LeaseMgrFactory::create(validPgSQLConnectionString() +
+                                            " single-query-allocation=true"));
+    lmptr_ = &(LeaseMgrFactory::instance());
+    ASSERT_TRUE(lmptr_->canAddFreeLease4());
+
+    // Take the second address of the range.
+    Lease4Ptr taken(new Lease4(*lease));
+    taken->addr_ = IOAddress("192.0.2.2");
+    taken->hwaddr_.reset(new HWAddr(vector<uint8_t>(6, 2), HTYPE_ETHER));
+    ASSERT_TRUE(lmptr_->addLease(taken));
+
+    // The free addresses are allocated from the lowest.
+    vector<string> expected = { "192.0.2.1", "192.0.2.3" };
+    for (auto const& address : expected) {
+        Lease4Ptr added(new Lease4(*lease));
+        added->addr_ = IOAddress("0.0.0.0");
+        ASSERT_TRUE(lmptr_->addFreeLease4(added, IOAddress("192.0.2.1"),
+                                          IOAddress("192.0.2.3")));
+        EXPECT_EQ(address, added->addr_.toText());
+        Lease4Ptr fetched = lmptr_->getLease4(IOAddress(address));
+        ASSERT_TRUE(fetched);
+        detailCompareLease(added, fetched);
+    }
+
+    // The range is full.
+    EXPECT_FALSE(lmptr_->addFreeLease4(lease, IOAddress("192.0.2.1"),
+                                       IOAddress("192.0.2.3")));
+}
+
 /// @brief Test fixture class for validating @c LeaseMgr using
 /// PostgreSQL as back end and PostgreSQL connectivity loss.
 class PgSqlLeaseMgrDbLostCallbackTest : public LeaseMgrDbLostCallbackTest {
@@ -0,0 +1,73 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcp/dhcp4.h>
+#include <dhcp/pkt4.h>
+#include <dhcpsrv/pkt_latency_stats.h>
+#include <stats/stats_mgr.h>
+
+#include <gtest/gtest.h>
+
+using namespace isc;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::stats;
+
+namespace {
+
+/// @brief Returns the number of latencies recorded in a histogram.
+///
+/// @param name name of the histogram.
+int64_t
+getCount(const std::string& name) {
+    ConstElementPtr latencies = StatsMgr::instance().getLatencies(name);
+    if (!latencies->contains(name)) {
+        return (-1);
+    }
+    return (latencies->get(name)->get("count")->intValue());
+}
+
+// Verifies that the stages are recorded when both their events occurred.
+TEST(PktLatencyStatsTest, record) {
+    StatsMgr::instance().resetAll();
+    PktLatencyStats stats("pkt9");
+    EXPECT_EQ(0, getCount("pkt9-queue-latency"));
+    EXPECT_EQ(0, getCount("pkt9-pre-alloc-latency"));
+    EXPECT_EQ(0, getCount("pkt9-alloc-latency"));
+    EXPECT_EQ(0, getCount("pkt9-response-latency"));
+    EXPECT_EQ(0, getCount("pkt9-total-latency"));
+
+    // All events occurred.
+    Pkt4 query(DHCPDISCOVER, 1234);
+    query.setEventTime(Pkt::EVENT_RECEIVED);
+    query.setEventTime(Pkt::EVENT_DEQUEUED);
+    query.setEventTime(Pkt::EVENT_ALLOC_STARTED);
+    query.setEventTime(Pkt::EVENT_ALLOC_FINISHED);
+    Pkt4 response(DHCPOFFER, 1234);
+    response.copyEventTimes(query);
+    response.setEventTime(Pkt::EVENT_SENT);
+    stats.record(response);
+    EXPECT_EQ(1, getCount("pkt9-queue-latency"));
+    EXPECT_EQ(1, getCount("pkt9-pre-alloc-latency"));
+    EXPECT_EQ(1, getCount("pkt9-alloc-latency"));
+    EXPECT_EQ(1, getCount("pkt9-response-latency"));
+    EXPECT_EQ(1, getCount("pkt9-total-latency"));
+
+    // No lease was allocated: the response stage starts with the processing.
+    Pkt4 inform(DHCPINFORM, 1235);
+    inform.setEventTime(Pkt::EVENT_DEQUEUED);
+    inform.setEventTime(Pkt::EVENT_SENT);
+    stats.record(inform);
+    EXPECT_EQ(1, getCount("pkt9-queue-latency"));
+    EXPECT_EQ(1, getCount("pkt9-pre-alloc-latency"));
+    EXPECT_EQ(1, getCount("pkt9-alloc-latency"));
+    EXPECT_EQ(2, getCount("pkt9-response-latency"));
+    EXPECT_EQ(1, getCount("pkt9-total-latency"));
+}
+
+} // end of anonymous namespace
@@ -33,6 +33,7 @@ TEST(PoolRandomAllocationStateTest, ipv4Pool) {
     // Make sure that the permutation has been initialized.
     auto permutation = state->getPermutation();
     ASSERT_TRUE(permutation);
+    EXPECT_EQ(IPRangePermutation::SHUFFLE, permutation->getMode());
 
     // Keep the record of the addresses returned by the permutation
     // to ensure it returns unique addresses.
@@ -61,6 +62,7 @@ TEST(PoolRandomAllocationStateTest, ipv6AddressPool) {
     // Make sure that the permutation has been initialized.
     auto permutation = state->getPermutation();
     ASSERT_TRUE(permutation);
+    EXPECT_EQ(IPRangePermutation::SHUFFLE, permutation->getMode());
 
     // Keep the record of the addresses returned by the permutation
     // to ensure it returns unique addresses.
@@ -87,6 +89,7 @@ TEST(PoolRandomAllocationStateTest, ipv6PrefixPool) {
     // Make sure that the permutation has been initialized.
     auto permutation = state->getPermutation();
     ASSERT_TRUE(permutation);
+    EXPECT_EQ(IPRangePermutation::FEISTEL, permutation->getMode());
 
     // Keep the record of the addresses returned by the permutation
     // to ensure it returns unique prefixes.
@@ -1,4 +1,4 @@
-// Copyright (C) 2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -6,8 +6,13 @@
 
 #include <config.h>
 #include <dhcpsrv/resource_handler.h>
+
+#include <boost/scoped_ptr.hpp>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>
+
 using namespace isc;
 using namespace isc::asiolink;
 using namespace isc::dhcp;
@@ -506,4 +511,38 @@ TEST(ResourceHandleTest, unLock4) {
     }
 }
 
+// Verifies behavior of the lockOrWait method.
+TEST(ResourceHandleTest, lockOrWait4) {
+    IOAddress addr("192.0.2.1");
+
+    try {
+        // A free resource is acquired.
+        boost::scoped_ptr<ResourceHandler4> resource_handler(new ResourceHandler4());
+        EXPECT_TRUE(resource_handler->lockOrWait4(addr));
+        EXPECT_TRUE(resource_handler->isLocked4(addr));
+
+        // A resource owned by the current thread is not waited for.
+        ResourceHandler4 resource_handler2;
+        EXPECT_FALSE(resource_handler2.lockOrWait4(addr));
+        EXPECT_FALSE(resource_handler2.isLocked4(addr));
+
+        // Another thread waits for the release.
+        std::atomic<bool> acquired(false);
+        std::thread thread([&addr, &acquired]() {
+            ResourceHandler4 resource_handler3;
+            acquired = resource_handler3.lockOrWait4(addr);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_FALSE(acquired);
+        resource_handler.reset();
+        thread.join();
+        EXPECT_TRUE(acquired);
+
+        // The resource was released by the thread.
+        EXPECT_TRUE(resource_handler2.tryLock4(addr));
+    } catch (const std::exception& ex) {
+        ADD_FAILURE() << "unexpected exception: " << ex.what();
+    }
+}
+
 } // end of anonymous namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -440,6 +440,80 @@ TEST_F(SanityChecksTest, guardOnly6) {
     EXPECT_EQ(subnet->getID(), lease->subnet_id_);
 }
 
+// Verify that a checker reused for many leases gives the same results.
+TEST_F(SanityChecksTest, reuse4) {
+    CfgMgr::instance().setFamily(AF_INET);
+    Subnet4Ptr subnet1 = createSubnet4("192.168.1.0/24", 1);
+    Subnet4Ptr subnet2 = createSubnet4("192.168.2.0/24", 2);
+    CfgMgr::instance().getCurrentCfg()->getCfgSubnets4()->add(subnet1);
+    CfgMgr::instance().getCurrentCfg()->getCfgSubnets4()->add(subnet2);
+    setLeaseCheck(CfgConsistency::LEASE_CHECK_FIX_DEL);
+    SanityChecker checker;
+
+    // A run of leases in the first subnet.
+    for (int i = 1; i < 10; ++i) {
+        Lease4Ptr lease = newLease4(IOAddress(0xc0a80100 + i), 1);
+        checker.checkLease(lease);
+        ASSERT_TRUE(lease);
+        EXPECT_EQ(1, lease->subnet_id_);
+    }
+
+    // A lease with the same subnet-id outside of the first subnet.
+    Lease4Ptr lease = newLease4(IOAddress("192.168.2.1"), 1);
+    checker.checkLease(lease);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(2, lease->subnet_id_);
+
+    lease = newLease4(IOAddress("192.168.3.1"), 1);
+    checker.checkLease(lease);
+    EXPECT_FALSE(lease);
+}
+
+// Verify that a checker reused for many leases gives the same results.
+TEST_F(SanityChecksTest, reuse6) {
+    CfgMgr::instance().setFamily(AF_INET6);
+    Subnet6Ptr subnet1 = createSubnet6("2001:db8:1::/64", 1);
+    Subnet6Ptr subnet2 = createSubnet6("2001:db8:2::/64", 2);
+    CfgMgr::instance().getCurrentCfg()->getCfgSubnets6()->add(subnet1);
+    CfgMgr::instance().getCurrentCfg()->getCfgSubnets6()->add(subnet2);
+    setLeaseCheck(CfgConsistency::LEASE_CHECK_FIX_DEL);
+    SanityChecker checker;
+
+    Lease6Ptr lease = newLease6(IOAddress("2001:db8:1::1"), 1);
+    checker.checkLease(lease);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(1, lease->subnet_id_);
+
+    lease = newLease6(IOAddress("2001:db8:1::2"), 1);
+    checker.checkLease(lease);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(1, lease->subnet_id_);
+
+    lease = newLease6(IOAddress("2001:db8:2::1"), 1);
+    checker.checkLease(lease);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(2, lease->subnet_id_);
+}
+
+// Verify that the configuration given to the constructor is used.
+TEST_F(SanityChecksTest, givenConfig4) {
+    CfgMgr::instance().setFamily(AF_INET);
+    SrvConfigPtr cfg(new SrvConfig());
+    cfg->getCfgSubnets4()->add(createSubnet4("192.168.1.0/24", 1));
+    cfg->getConsistency()->setLeaseSanityCheck(CfgConsistency::LEASE_CHECK_FIX_DEL);
+
+    // The current configuration has no subnet and does not check.
+    SanityChecker checker(cfg);
+    Lease4Ptr lease = newLease4(IOAddress("192.168.1.1"), 2);
+    checker.checkLease(lease);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(1, lease->subnet_id_);
+
+    lease = newLease4(IOAddress("192.168.2.1"), 1);
+    checker.checkLease(lease, false);
+    EXPECT_FALSE(lease);
+}
+
 class ExtendedInfoChecksTest : public LogContentTest {
 public:
 
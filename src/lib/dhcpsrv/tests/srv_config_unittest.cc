@@ -1611,6 +1611,97 @@ TEST_F(SrvConfigTest, getDdnsParamsNoSubnetTest4) {
     EXPECT_TRUE(params->getTtlPercent().unspecified());
 }
 
+// Verifies that the DDNS parameters resolved for the subnets are shared
+// until the parameters they were resolved from change.
+TEST_F(SrvConfigTest, resolveDdnsParams4) {
+    CfgMgr::instance().setFamily(AF_INET);
+    enableD2Client(false);
+
+    conf_.addConfiguredGlobal("ddns-send-updates", Element::create(true));
+    conf_.addConfiguredGlobal("hostname-char-set", Element::create("[^A-Z]"));
+    conf_.addConfiguredGlobal("hostname-char-replacement", Element::create("x"));
+
+    // Add a plain subnet and a subnet in a shared network.
+    Triplet<uint32_t> def_triplet;
+    Subnet4Ptr subnet1(new Subnet4(IOAddress("192.0.1.0"), 24,
+                                   def_triplet, def_triplet, 4000, SubnetID(1)));
+    subnet1->setFetchGlobalsFn([this]() -> ConstCfgGlobalsPtr {
+        return (conf_.getConfiguredGlobals());
+    });
+    conf_.getCfgSubnets4()->add(subnet1);
+
+    SharedNetwork4Ptr frognet(new SharedNetwork4("frog"));
+    conf_.getCfgSharedNetworks4()->add(frognet);
+    Subnet4Ptr subnet2(new Subnet4(IOAddress("192.0.2.0"), 24,
+                                   def_triplet, def_triplet, 4000, SubnetID(2)));
+    subnet2->setFetchGlobalsFn([this]() -> ConstCfgGlobalsPtr {
+        return (conf_.getConfiguredGlobals());
+    });
+    frognet->add(subnet2);
+    conf_.getCfgSubnets4()->add(subnet2);
+
+    // Without resolution new instances are returned.
+    DdnsParamsPtr params1 = conf_.getDdnsParams(subnet1);
+    EXPECT_NE(params1, conf_.getDdnsParams(subnet1));
+
+    // Resolved parameters are shared.
+    ASSERT_NO_THROW(conf_.resolveDdnsParams());
+    params1 = conf_.getDdnsParams(subnet1);
+    EXPECT_EQ(params1, conf_.getDdnsParams(subnet1));
+    DdnsParamsPtr params2 = conf_.getDdnsParams(subnet2);
+    EXPECT_EQ(params2, conf_.getDdnsParams(subnet2));
+    EXPECT_FALSE(params1->getEnableUpdates());
+    EXPECT_EQ("[^A-Z]", params1->getHostnameCharSet());
+    EXPECT_EQ("x", params1->getHostnameCharReplacement());
+
+    // The subnets using the same char set share the sanitizer.
+    ASSERT_TRUE(params1->getHostnameSanitizer());
+    EXPECT_EQ(params1->getHostnameSanitizer(), params2->getHostnameSanitizer());
+    EXPECT_EQ("xBC", params1->getHostnameSanitizer()->scrub("aBC"));
+
+    // A change in the subnet is seen.
+    subnet1->setDdnsQualifyingSuffix("example.org.");
+    DdnsParamsPtr params = conf_.getDdnsParams(subnet1);
+    EXPECT_NE(params1, params);
+    EXPECT_EQ("example.org.", params->getQualifyingSuffix());
+    EXPECT_EQ(params2, conf_.getDdnsParams(subnet2));
+
+    // A change in the shared network is seen.
+    frognet->setDdnsGeneratedPrefix("frog");
+    params = conf_.getDdnsParams(subnet2);
+    EXPECT_NE(params2, params);
+    EXPECT_EQ("frog", params->getGeneratedPrefix());
+
+    // Resolve again.
+    ASSERT_NO_THROW(conf_.resolveDdnsParams());
+    params1 = conf_.getDdnsParams(subnet1);
+    EXPECT_EQ(params1, conf_.getDdnsParams(subnet1));
+    EXPECT_EQ("example.org.", params1->getQualifyingSuffix());
+
+    // A change in the global parameters is seen.
+    conf_.addConfiguredGlobal("ddns-update-on-renew", Element::create(true));
+    params = conf_.getDdnsParams(subnet1);
+    EXPECT_NE(params1, params);
+    EXPECT_TRUE(params->getUpdateOnRenew());
+
+    // A change of the D2 client enabled flag is seen.
+    ASSERT_NO_THROW(conf_.resolveDdnsParams());
+    params1 = conf_.getDdnsParams(subnet1);
+    EXPECT_FALSE(params1->getEnableUpdates());
+    enableD2Client(true);
+    params = conf_.getDdnsParams(subnet1);
+    EXPECT_NE(params1, params);
+    EXPECT_TRUE(params->getEnableUpdates());
+
+    subnet1->setFetchGlobalsFn([]() -> ConstCfgGlobalsPtr {
+        return (ConstCfgGlobalsPtr());
+    });
+
+    subnet2->setFetchGlobalsFn([]() -> ConstCfgGlobalsPtr {
+        return (ConstCfgGlobalsPtr());
+    });
+}
+
 // Verifies that the scoped values for DDNS parameters can be fetched
 // for a given Subnet6.
 TEST_F(SrvConfigTest, getDdnsParamsTest6) {
@@ -0,0 +1,115 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/subnet.h>
+#include <dhcpsrv/subnet_prefix_index.h>
+
+#include <gtest/gtest.h>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+// This test verifies that the IPv4 index returns the subnets an address
+// belongs to ordered by subnet identifier.
+TEST(SubnetPrefixIndexTest, getAll4) {
+    SubnetPrefixIndex<Subnet4Ptr> index(AF_INET);
+
+    Subnet4Ptr subnet1(new Subnet4(IOAddress("10.0.0.0"), 8, 1, 2, 3, 30));
+    Subnet4Ptr subnet2(new Subnet4(IOAddress("10.1.0.0"), 16, 1, 2, 3, 20));
+    Subnet4Ptr subnet3(new Subnet4(IOAddress("10.1.2.0"), 24, 1, 2, 3, 10));
+    Subnet4Ptr subnet4(new Subnet4(IOAddress("192.0.2.0"), 24, 1, 2, 3, 40));
+
+    EXPECT_TRUE(index.getAll(IOAddress("10.1.2.3")).empty());
+
+    index.add(subnet1);
+    index.add(subnet2);
+    index.add(subnet3);
+    index.add(subnet4);
+
+    auto subnets = index.getAll(IOAddress("10.1.2.3"));
+    ASSERT_EQ(3, subnets.size());
+    EXPECT_EQ(subnet3, subnets[0]);
+    EXPECT_EQ(subnet2, subnets[1]);
+    EXPECT_EQ(subnet1, subnets[2]);
+
+    subnets = index.getAll(IOAddress("10.1.3.3"));
+    ASSERT_EQ(2, subnets.size());
+    EXPECT_EQ(subnet2, subnets[0]);
+    EXPECT_EQ(subnet1, subnets[1]);
+
+    subnets = index.getAll(IOAddress("192.0.2.255"));
+    ASSERT_EQ(1, subnets.size());
+    EXPECT_EQ(subnet4, subnets[0]);
+
+    EXPECT_TRUE(index.getAll(IOAddress("192.0.3.0")).empty());
+
+    // Addresses of the other family never match.
+    EXPECT_TRUE(index.getAll(IOAddress("2001:db8::1")).empty());
+
+    // Removed subnets are no longer returned.
+    index.del(subnet2);
+    subnets = index.getAll(IOAddress("10.1.2.3"));
+    ASSERT_EQ(2, subnets.size());
+    EXPECT_EQ(subnet3, subnets[0]);
+    EXPECT_EQ(subnet1, subnets[1]);
+
+    index.clear();
+    EXPECT_TRUE(index.getAll(IOAddress("10.1.2.3")).empty());
+}
+
+// This test verifies that a subnet defined by an address which is not
+// the first address of its prefix is found.
+TEST(SubnetPrefixIndexTest, notAlignedPrefix) {
+    SubnetPrefixIndex<Subnet4Ptr> index(AF_INET);
+
+    Subnet4Ptr subnet(new Subnet4(IOAddress("192.0.2.5"), 24, 1, 2, 3, 1));
+    index.add(subnet);
+
+    auto subnets = index.getAll(IOAddress("192.0.2.200"));
+    ASSERT_EQ(1, subnets.size());
+    EXPECT_EQ(subnet, subnets[0]);
+
+    index.del(subnet);
+    EXPECT_TRUE(index.getAll(IOAddress("192.0.2.200")).empty());
+}
+
+// This test verifies that the IPv6 index returns the subnets an address
+// belongs to ordered by subnet identifier.
+TEST(SubnetPrefixIndexTest, getAll6) {
+    SubnetPrefixIndex<Subnet6Ptr> index(AF_INET6);
+
+    Subnet6Ptr subnet1(new Subnet6(IOAddress("2001:db8::"), 32, 1, 2, 3, 4, 2));
+    Subnet6Ptr subnet2(new Subnet6(IOAddress("2001:db8:1::"), 48, 1, 2, 3, 4, 1));
+    Subnet6Ptr subnet3(new Subnet6(IOAddress("3000::"), 64, 1, 2, 3, 4, 3));
+
+    index.add(subnet1);
+    index.add(subnet2);
+    index.add(subnet3);
+
+    auto subnets = index.getAll(IOAddress("2001:db8:1::1"));
+    ASSERT_EQ(2, subnets.size());
+    EXPECT_EQ(subnet2, subnets[0]);
+    EXPECT_EQ(subnet1, subnets[1]);
+
+    subnets = index.getAll(IOAddress("2001:db8:2::1"));
+    ASSERT_EQ(1, subnets.size());
+    EXPECT_EQ(subnet1, subnets[0]);
+
+    subnets = index.getAll(IOAddress("3000::ffff"));
+    ASSERT_EQ(1, subnets.size());
+    EXPECT_EQ(subnet3, subnets[0]);
+
+    EXPECT_TRUE(index.getAll(IOAddress("3000:0:0:1::")).empty());
+    EXPECT_TRUE(index.getAll(IOAddress("10.0.0.1")).empty());
+}
+
+} // end of anonymous namespace
@@ -23,6 +23,7 @@
 #include <dhcpsrv/shared_network.h>
 #include <dhcpsrv/subnet.h>
 #include <exceptions/exceptions.h>
+#include <stats/stats_mgr.h>
 
 #include <boost/pointer_cast.hpp>
 #include <boost/scoped_ptr.hpp>
@@ -36,6 +37,7 @@ using boost::scoped_ptr;
 using namespace isc;
 using namespace isc::dhcp;
 using namespace isc::asiolink;
+using namespace isc::stats;
 using namespace isc::util;
 
 namespace {
@@ -791,6 +793,59 @@ TEST(Subnet4Test, createAllocatorsIterative) {
                 (pool->getAllocationState()));
 }
 
+// This test verifies that the allocation states of an identical subnet
+// are reused.
+TEST(Subnet4Test, reuseAllocationStates) {
+    auto create = [](const std::string& allocator_type, uint8_t pool_len) {
+        auto subnet = Subnet4::create(IOAddress("192.2.0.0"), 16, 1, 2, 3,
+                                      SubnetID(1));
+        subnet->addPool(boost::make_shared<Pool4>(IOAddress("192.2.0.0"),
+                                                  pool_len));
+        subnet->setAllocatorType(allocator_type);
+        subnet->createAllocators();
+        return (subnet);
+    };
+    auto previous = create("iterative", 16);
+    auto subnet = create("iterative", 16);
+    ASSERT_NE(previous->getAllocationState(Lease::TYPE_V4),
+              subnet->getAllocationState(Lease::TYPE_V4));
+    EXPECT_TRUE(subnet->reuseAllocationStates(*previous));
+    EXPECT_EQ(previous->getAllocationState(Lease::TYPE_V4),
+              subnet->getAllocationState(Lease::TYPE_V4));
+    EXPECT_EQ(previous->getPools(Lease::TYPE_V4)[0]->getAllocationState(),
+              subnet->getPools(Lease::TYPE_V4)[0]->getAllocationState());
+
+    // The random allocator states are reused too.
+    previous = create("random", 16);
+    subnet = create("random", 16);
+    EXPECT_TRUE(subnet->reuseAllocationStates(*previous));
+    EXPECT_EQ(previous->getPools(Lease::TYPE_V4)[0]->getAllocationState(),
+              subnet->getPools(Lease::TYPE_V4)[0]->getAllocationState());
+
+    // Not when the pools or the allocator type differ.
+    subnet = create("random", 17);
+    EXPECT_FALSE(subnet->reuseAllocationStates(*previous));
+    EXPECT_NE(previous->getPools(Lease::TYPE_V4)[0]->getAllocationState(),
+              subnet->getPools(Lease::TYPE_V4)[0]->getAllocationState());
+    subnet = create("iterative", 16);
+    EXPECT_FALSE(subnet->reuseAllocationStates(*previous));
+
+    // Nor when the allocator rebuilds its states from another lease
+    // database.
+    previous = create("flq", 16);
+    subnet = create("flq", 16);
+    EXPECT_FALSE(subnet->reuseAllocationStates(*previous));
+    EXPECT_TRUE(subnet->reuseAllocationStates(*previous, true));
+    EXPECT_EQ(previous->getPools(Lease::TYPE_V4)[0]->getAllocationState(),
+              subnet->getPools(Lease::TYPE_V4)[0]->getAllocationState());
+
+    // Nor when another parameter changed.
+    previous = create("iterative", 16);
+    subnet = create("iterative", 16);
+    subnet->setValid(Triplet<uint32_t>(100));
+    EXPECT_FALSE(subnet->reuseAllocationStates(*previous));
+}
+
 // This test verifies that a random allocator and the corresponding
 // states are instantiated for a subnet.
 TEST(Subnet4Test, createAllocatorsRandom) {
@@ -833,6 +888,42 @@ TEST(Subnet4Test, createAllocatorsFreeLeaseQueue) {
                 (pool->getAllocationState()));
 }
 
+// Checks that the lease statistics are updated with or without counters.
+TEST(Subnet4Test, leaseStats) {
+    StatsMgr::instance().removeAll();
+    Subnet4Ptr subnet(new Subnet4(IOAddress("192.0.2.0"), 24, 1, 2, 3, 7));
+    EXPECT_EQ("assigned-addresses", subnet->getLeaseStatName(Subnet::STAT_ASSIGNED));
+    EXPECT_EQ("", subnet->getLeaseStatName(Subnet::STAT_ASSIGNED_PDS));
+    EXPECT_EQ("reclaimed-leases", subnet->getLeaseStatName(Subnet::STAT_RECLAIMED));
+
+    // Not bound: updated by name.
+    subnet->addLeaseStat(Subnet::STAT_ASSIGNED, 2);
+    ObservationPtr obs =
+        StatsMgr::instance().getObservation("subnet[7].assigned-addresses");
+    ASSERT_TRUE(obs);
+    EXPECT_EQ(2, obs->getInteger().first);
+
+    // Bound: updated by the counter and seen when read.
+    subnet->bindLeaseStats();
+    subnet->addLeaseStat(Subnet::STAT_ASSIGNED, 3);
+    subnet->addLeaseStat(Subnet::STAT_ASSIGNED, -1);
+    subnet->addLeaseStat(Subnet::STAT_CUMULATIVE_ASSIGNED, 1);
+    obs = StatsMgr::instance().getObservation("subnet[7].assigned-addresses");
+    ASSERT_TRUE(obs);
+    EXPECT_EQ(4, obs->getInteger().first);
+    obs = StatsMgr::instance().getObservation("subnet[7].cumulative-assigned-addresses");
+    ASSERT_TRUE(obs);
+    EXPECT_EQ(1, obs->getInteger().first);
+
+    // Setting a statistic by name overrides the pending increments.
+    subnet->addLeaseStat(Subnet::STAT_ASSIGNED, 5);
+    StatsMgr::instance().setValue("subnet[7].assigned-addresses", int64_t(10));
+    obs = StatsMgr::instance().getObservation("subnet[7].assigned-addresses");
+    ASSERT_TRUE(obs);
+    EXPECT_EQ(10, obs->getInteger().first);
+    StatsMgr::instance().removeAll();
+}
+
 // Tests for Subnet6
 
 TEST(Subnet6Test, constructor) {
@@ -846,6 +937,24 @@ TEST(Subnet6Test, constructor) {
                 BadValue); // IPv4 addresses are not allowed in Subnet6
 }
 
+// Checks the names of the IPv6 lease statistics.
+TEST(Subnet6Test, leaseStats) {
+    StatsMgr::instance().removeAll();
+    Subnet6Ptr subnet(new Subnet6(IOAddress("2001:db8:1::"), 64, 1, 2, 3, 4, 7));
+    EXPECT_EQ("assigned-nas", subnet->getLeaseStatName(Subnet::STAT_ASSIGNED));
+    EXPECT_EQ("assigned-pds", subnet->getLeaseStatName(Subnet::STAT_ASSIGNED_PDS));
+    EXPECT_EQ("cumulative-assigned-pds",
+              subnet->getLeaseStatName(Subnet::STAT_CUMULATIVE_ASSIGNED_PDS));
+
+    subnet->bindLeaseStats();
+    subnet->addLeaseStat(Subnet::STAT_ASSIGNED_PDS, 1);
+    ObservationPtr obs =
+        StatsMgr::instance().getObservation("subnet[7].assigned-pds");
+    ASSERT_TRUE(obs);
+    EXPECT_EQ(1, obs->getInteger().first);
+    StatsMgr::instance().removeAll();
+}
+
 // This test verifies that the Subnet6 factory function creates a
 // valid subnet instance.
 TEST(Subnet6Test, create) {
@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -481,4 +481,26 @@ TEST_F(TimerMgrTest, setIOService) {
                  BadValue);
 }
 
+// This test verifies that the timing wheel runs on the IO service of
+// the TimerMgr and is destroyed with the timers.
+TEST_F(TimerMgrTest, timerWheel) {
+    TimerWheelPtr wheel = timer_mgr_->getTimerWheel();
+    ASSERT_TRUE(wheel);
+    EXPECT_EQ(wheel, timer_mgr_->getTimerWheel());
+
+    // The timer should run during the wait.
+    bool fired = false;
+    ASSERT_NO_THROW(wheel->schedule(1, [&fired]() { fired = true; }));
+    doWait(500);
+    EXPECT_TRUE(fired);
+    EXPECT_EQ(0, wheel->size());
+
+    // Unregistering the timers destroys the timing wheel.
+    ASSERT_NO_THROW(wheel->schedule(10000, [&fired]() { fired = false; }));
+    timer_mgr_->unregisterTimers();
+    EXPECT_EQ(0, wheel->size());
+    EXPECT_NE(wheel, timer_mgr_->getTimerWheel());
+    EXPECT_TRUE(fired);
+}
+
 } // end of anonymous namespace
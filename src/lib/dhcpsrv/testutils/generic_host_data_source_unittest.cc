@@ -3639,6 +3639,48 @@ HostMgrTest::testGet4(BaseHostDataSource& data_source) {
     EXPECT_EQ("192.0.2.5", host->getIPv4Reservation().toText());
 }
 
+void
+HostMgrTest::testGet4ByIdentifiers(BaseHostDataSource& data_source) {
+    HostIdentifierList identifiers;
+    identifiers.push_back(HostIdentifier(Host::IDENT_HWADDR, hwaddrs_[0]->hwaddr_));
+    identifiers.push_back(HostIdentifier(Host::IDENT_DUID, duids_[0]->getDuid()));
+
+    // Initially, no host should be present.
+    ASSERT_FALSE(HostMgr::instance().get4(SubnetID(1), identifiers));
+
+    // Add a host identified by the HW address to the database and a host
+    // identified by the DUID to the server's configuration.
+    addHost4(data_source, hwaddrs_[0], SubnetID(1), IOAddress("192.0.2.5"));
+    HostPtr new_host(new Host(duids_[0]->toText(), "duid", SubnetID(1),
+                              SUBNET_ID_UNUSED, IOAddress("192.0.2.6")));
+    getCfgHosts()->add(new_host);
+
+    CfgMgr::instance().commit();
+
+    // The HW address is preferred.
+    ConstHostPtr host = HostMgr::instance().get4(SubnetID(1), identifiers);
+    ASSERT_TRUE(host);
+    EXPECT_EQ("192.0.2.5", host->getIPv4Reservation().toText());
+
+    // The DUID is preferred.
+    identifiers.reverse();
+    host = HostMgr::instance().get4(SubnetID(1), identifiers);
+    ASSERT_TRUE(host);
+    EXPECT_EQ("192.0.2.6", host->getIPv4Reservation().toText());
+
+    // The identifiers without reservation are skipped.
+    identifiers.clear();
+    identifiers.push_back(HostIdentifier(Host::IDENT_DUID, duids_[1]->getDuid()));
+    identifiers.push_back(HostIdentifier(Host::IDENT_CLIENT_ID, duids_[2]->getDuid()));
+    identifiers.push_back(HostIdentifier(Host::IDENT_HWADDR, hwaddrs_[0]->hwaddr_));
+    host = HostMgr::instance().get4(SubnetID(1), identifiers);
+    ASSERT_TRUE(host);
+    EXPECT_EQ("192.0.2.5", host->getIPv4Reservation().toText());
+
+    // Not in another subnet.
+    EXPECT_FALSE(HostMgr::instance().get4(SubnetID(2), identifiers));
+}
+
 void
 HostMgrTest::testGet4Any() {
     // Initially, no host should be present.
@@ -3717,6 +3759,54 @@ HostMgrTest::testGet6(BaseHostDataSource& data_source) {
                                                IOAddress("2001:db8:1::1"))));
 }
 
+void
+HostMgrTest::testGet6ByIdentifiers(BaseHostDataSource& data_source) {
+    HostIdentifierList identifiers;
+    identifiers.push_back(HostIdentifier(Host::IDENT_DUID, duids_[0]->getDuid()));
+    identifiers.push_back(HostIdentifier(Host::IDENT_HWADDR, hwaddrs_[0]->hwaddr_));
+
+    // Initially, no host should be present.
+    ASSERT_FALSE(HostMgr::instance().get6(SubnetID(2), identifiers));
+
+    // Add a host identified by the DUID to the database and a host
+    // identified by the HW address to the server's configuration.
+    addHost6(data_source, duids_[0], SubnetID(2), IOAddress("2001:db8:1::1"));
+    HostPtr new_host(new Host(hwaddrs_[0]->toText(false), "hw-address",
+                              SUBNET_ID_UNUSED, SubnetID(2),
+                              IOAddress::IPV4_ZERO_ADDRESS()));
+    new_host->addReservation(IPv6Resrv(IPv6Resrv::TYPE_NA,
+                                       IOAddress("2001:db8:1::2")));
+    getCfgHosts()->add(new_host);
+
+    CfgMgr::instance().commit();
+
+    // The DUID is preferred.
+    ConstHostPtr host = HostMgr::instance().get6(SubnetID(2), identifiers);
+    ASSERT_TRUE(host);
+    EXPECT_TRUE(host->hasReservation(IPv6Resrv(IPv6Resrv::TYPE_NA,
+                                               IOAddress("2001:db8:1::1"))));
+
+    // The HW address is preferred.
+    identifiers.reverse();
+    host = HostMgr::instance().get6(SubnetID(2), identifiers);
+    ASSERT_TRUE(host);
+    EXPECT_TRUE(host->hasReservation(IPv6Resrv(IPv6Resrv::TYPE_NA,
+                                               IOAddress("2001:db8:1::2"))));
+
+    // The identifiers without reservation are skipped.
+    identifiers.clear();
+    identifiers.push_back(HostIdentifier(Host::IDENT_HWADDR, hwaddrs_[1]->hwaddr_));
+    identifiers.push_back(HostIdentifier(Host::IDENT_FLEX, duids_[2]->getDuid()));
+    identifiers.push_back(HostIdentifier(Host::IDENT_DUID, duids_[0]->getDuid()));
+    host = HostMgr::instance().get6(SubnetID(2), identifiers);
+    ASSERT_TRUE(host);
+    EXPECT_TRUE(host->hasReservation(IPv6Resrv(IPv6Resrv::TYPE_NA,
+                                               IOAddress("2001:db8:1::1"))));
+
+    // Not in another subnet.
+    EXPECT_FALSE(HostMgr::instance().get6(SubnetID(1), identifiers));
+}
+
 void
 HostMgrTest::testGet6Any() {
     // Initially, no host should be present.
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -877,6 +877,13 @@ protected:
     /// cached reservation with and only with get4Any.
     void testGet4Any();
 
+    /// @brief This test verifies that the IPv4 reservation of the most
+    /// preferred identifier is retrieved using HostMgr.
+    ///
+    /// @param data_source Host data source to which a reservation is
+    /// inserted, the other being inserted in the server's configuration.
+    void testGet4ByIdentifiers(BaseHostDataSource& data_source);
+
     /// @brief This test verifies that it is possible to retrieve an IPv6
     /// reservation for the particular host using HostMgr.
     ///
@@ -888,6 +895,13 @@ protected:
     /// cached reservation with and only with get6Any.
     void testGet6Any();
 
+    /// @brief This test verifies that the IPv6 reservation of the most
+    /// preferred identifier is retrieved using HostMgr.
+    ///
+    /// @param data_source Host data source to which a reservation is
+    /// inserted, the other being inserted in the server's configuration.
+    void testGet6ByIdentifiers(BaseHostDataSource& data_source);
+
     /// @brief This test verifies that it is possible to retrieve an IPv6
     /// prefix reservation for the particular host using HostMgr.
     ///
@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -91,6 +91,9 @@ public:
     /// @param io_service Pointer to the new IO service.
     void setIOService(const IOServicePtr& io_service);
 
+    /// @brief Returns the timing wheel, creating it when needed.
+    TimerWheelPtr getTimerWheel();
+
     /// @brief Registers new timer in the @c TimerMgr.
     ///
     /// @param timer_name Unique name for the timer.
@@ -227,12 +230,15 @@ private:
     /// parameters pertaining to the timer.
     TimerInfoMap registered_timers_;
 
+    /// @brief The timing wheel.
+    TimerWheelPtr timer_wheel_;
+
     /// @brief The mutex to protect the timer manager.
     boost::scoped_ptr<std::mutex> mutex_;
 };
 
 TimerMgrImpl::TimerMgrImpl() : io_service_(new IOService()),
-    registered_timers_(), mutex_(new std::mutex) {
+    registered_timers_(), timer_wheel_(), mutex_(new std::mutex) {
 }
 
 void
@@ -242,6 +248,23 @@ TimerMgrImpl::setIOService(const IOServicePtr& io_service) {
     }
 
     io_service_ = io_service;
+    timer_wheel_.reset();
+}
+
+TimerWheelPtr
+TimerMgrImpl::getTimerWheel() {
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        if (!timer_wheel_) {
+            timer_wheel_.reset(new TimerWheel(io_service_));
+        }
+        return (timer_wheel_);
+    } else {
+        if (!timer_wheel_) {
+            timer_wheel_.reset(new TimerWheel(io_service_));
+        }
+        return (timer_wheel_);
+    }
 }
 
 void
@@ -340,6 +363,13 @@ TimerMgrImpl::unregisterTimersInternal() {
          timer_info_it != registered_timers_copy.end(); ++timer_info_it) {
         unregisterTimerInternal(timer_info_it->first);
     }
+
+    // Cancel the timers of the timing wheel which must not survive the
+    // IO service.
+    if (timer_wheel_) {
+        timer_wheel_->clear();
+        timer_wheel_.reset();
+    }
 }
 
 bool
@@ -459,6 +489,11 @@ TimerMgr::~TimerMgr() {
     impl_->unregisterTimers();
 }
 
+TimerWheelPtr
+TimerMgr::getTimerWheel() {
+    return (impl_->getTimerWheel());
+}
+
 void
 TimerMgr::registerTimer(const std::string& timer_name,
                         const IntervalTimer::Callback& callback,
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,6 +8,7 @@
 #define TIMER_MGR_H
 
 #include <asiolink/interval_timer.h>
+#include <asiolink/timer_wheel.h>
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
 #include <string>
@@ -73,9 +74,24 @@ public:
 
     /// @brief Sets IO service to be used by the Timer Manager.
     ///
+    /// The timers of the timing wheel are cancelled.
+    ///
     /// @param io_service Pointer to the new IO service.
     void setIOService(const asiolink::IOServicePtr& io_service);
 
+    /// @brief Returns the timing wheel.
+    ///
+    /// The named timers are meant to run periodic tasks. The timing wheel
+    /// runs on the same IO service and scales to millions of short lived
+    /// timers, e.g. per lease or per client timers. It is created with
+    /// the default tick and number of slots at the first call. It is
+    /// destroyed, and its timers cancelled, when all the timers are
+    /// unregistered or the IO service is changed: the callers should not
+    /// keep the returned pointer beyond that.
+    ///
+    /// @return The timing wheel.
+    asiolink::TimerWheelPtr getTimerWheel();
+
     /// @name Registering, unregistering and scheduling the timers.
     //@{
 
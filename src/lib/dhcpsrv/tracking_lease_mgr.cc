@@ -9,12 +9,23 @@
 #include <exceptions/exceptions.h>
 #include <dhcpsrv/dhcpsrv_log.h>
 #include <dhcpsrv/tracking_lease_mgr.h>
+#include <stats/stats_mgr.h>
 #include <util/multi_threading_mgr.h>
 #include <boost/tuple/tuple.hpp>
 
 using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::db;
+using namespace isc::stats;
 using namespace isc::util;
 
+namespace {
+
+/// @brief Number of leases fetched at once when recounting the leases.
+const size_t COUNTER_PAGE_SIZE = 1000;
+
+}
+
 namespace isc {
 namespace dhcp {
 
@@ -42,16 +53,34 @@ TrackingLeaseMgr::isLocked(const LeasePtr& lease) {
 
 void
 TrackingLeaseMgr::trackAddLease(const LeasePtr& lease, bool mt_safe) {
+    if (limit_counter_) {
+        limit_counter_->addLease(lease);
+    }
+    if (stats_counter_) {
+        stats_counter_->addLease(lease);
+    }
     runCallbacks(TRACK_ADD_LEASE, lease, mt_safe);
 }
 
 void
 TrackingLeaseMgr::trackUpdateLease(const LeasePtr& lease, bool mt_safe) {
+    if (limit_counter_) {
+        limit_counter_->updateLease(lease);
+    }
+    if (stats_counter_) {
+        stats_counter_->updateLease(lease);
+    }
     runCallbacks(TRACK_UPDATE_LEASE, lease, mt_safe);
 }
 
 void
 TrackingLeaseMgr::trackDeleteLease(const LeasePtr& lease, bool mt_safe) {
+    if (limit_counter_) {
+        limit_counter_->removeLease(lease);
+    }
+    if (stats_counter_) {
+        stats_counter_->removeLease(lease);
+    }
     runCallbacks(TRACK_DELETE_LEASE, lease, mt_safe);
 }
 
@@ -106,7 +135,354 @@ TrackingLeaseMgr::unregisterAllCallbacks() {
 
 bool
 TrackingLeaseMgr::hasCallbacks() const {
-    return (!callbacks_->empty());
+    return (!callbacks_->empty() || limit_counter_ || stats_counter_);
+}
+
+bool
+TrackingLeaseMgr::getInMemoryLimits(const DatabaseConnection::ParameterMap& parameters) {
+    auto param = parameters.find("in-memory-limits");
+    if ((param == parameters.end()) || (param->second == "false")) {
+        return (false);
+    }
+    if (param->second != "true") {
+        isc_throw(BadValue, "invalid value of the in-memory-limits "
+                  << param->second << " specified");
+    }
+    return (true);
+}
+
+void
+TrackingLeaseMgr::enableLimitCounter() {
+    limit_counter_.reset(new LeaseLimitCounter());
+    recountLimitCounter(AF_INET);
+    recountLimitCounter(AF_INET6);
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_LEASE_LIMIT_COUNTER_ENABLED)
+        .arg(limit_counter_->getLeaseCount());
+}
+
+void
+TrackingLeaseMgr::recountLimitCounter(uint16_t family) {
+    if (!limit_counter_) {
+        isc_throw(InvalidOperation, "the lease limit counter is not enabled");
+    }
+    limit_counter_->clear(family);
+    LeaseLimitCounter& counter = *limit_counter_;
+    countLeases(family, [&counter](const LeasePtr& lease) {
+        counter.addLease(lease);
+    });
+}
+
+bool
+TrackingLeaseMgr::getInMemoryStats(const DatabaseConnection::ParameterMap& parameters) {
+    auto param = parameters.find("in-memory-stats");
+    if ((param == parameters.end()) || (param->second == "false")) {
+        return (false);
+    }
+    if (param->second != "true") {
+        isc_throw(BadValue, "invalid value of the in-memory-stats "
+                  << param->second << " specified");
+    }
+    return (true);
+}
+
+void
+TrackingLeaseMgr::enableStatsCounter() {
+    stats_counter_.reset(new LeaseStatsCounter());
+    recountStatsCounter(AF_INET);
+    recountStatsCounter(AF_INET6);
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_LEASE_STATS_COUNTER_ENABLED)
+        .arg(stats_counter_->getLeaseCount());
+}
+
+void
+TrackingLeaseMgr::recountStatsCounter(uint16_t family) {
+    if (!stats_counter_) {
+        isc_throw(InvalidOperation, "the lease statistics counter is not enabled");
+    }
+    stats_counter_->clear(family);
+    LeaseStatsCounter& counter = *stats_counter_;
+    countLeases(family, [&counter](const LeasePtr& lease) {
+        counter.addLease(lease);
+    });
+}
+
+LeaseStatsQueryPtr
+TrackingLeaseMgr::startStatsCounterQuery(uint16_t family,
+                                         const SubnetID& first_subnet_id,
+                                         const SubnetID& last_subnet_id) {
+    if (!stats_counter_) {
+        isc_throw(InvalidOperation, "the lease statistics counter is not enabled");
+    }
+    LeaseStatsQueryPtr query;
+    if (first_subnet_id == 0) {
+        query.reset(new LeaseStatsCounterQuery(*stats_counter_, family));
+    } else if (last_subnet_id == 0) {
+        query.reset(new LeaseStatsCounterQuery(*stats_counter_, family,
+                                               first_subnet_id));
+    } else {
+        query.reset(new LeaseStatsCounterQuery(*stats_counter_, family,
+                                               first_subnet_id,
+                                               last_subnet_id));
+    }
+    query->start();
+    return (query);
+}
+
+void
+TrackingLeaseMgr::trackDeleteExpiredReclaimedLeases(uint16_t family,
+                                                    int64_t expire_before) {
+    if (stats_counter_) {
+        static_cast<void>(stats_counter_->removeExpiredReclaimedLeases(family,
+                                                                       expire_before));
+    }
+}
+
+void
+TrackingLeaseMgr::countLeases(uint16_t family,
+                              const std::function<void(const LeasePtr&)>& count) {
+    LeasePageSize page_size(COUNTER_PAGE_SIZE);
+    if (family == AF_INET) {
+        IOAddress lower_bound = IOAddress::IPV4_ZERO_ADDRESS();
+        for (;;) {
+            Lease4Collection leases = getLeases4(lower_bound, page_size);
+            for (auto const& lease : leases) {
+                count(lease);
+            }
+            if (leases.size() < page_size.page_size_) {
+                break;
+            }
+            lower_bound = leases.back()->addr_;
+        }
+    } else {
+        IOAddress lower_bound = IOAddress::IPV6_ZERO_ADDRESS();
+        for (;;) {
+            Lease6Collection leases = getLeases6(lower_bound, page_size);
+            for (auto const& lease : leases) {
+                count(lease);
+            }
+            if (leases.size() < page_size.page_size_) {
+                break;
+            }
+            lower_bound = leases.back()->addr_;
+        }
+    }
+}
+
+std::string
+TrackingLeaseMgr::checkLimitsInMemory4(isc::data::ConstElementPtr const& user_context) const {
+    if (!user_context) {
+        return ("");
+    }
+
+    ConstElementPtr limits = user_context->find("ISC/limits");
+    if (!limits) {
+        return ("");
+    }
+
+    // Iterate of the 'client-classes' list in 'limits'. For each class that specifies
+    // an "address-limit", check its value against the class's lease count.
+    ConstElementPtr classes = limits->get("client-classes");
+    if (classes) {
+        for (int i = 0; i < classes->size(); ++i) {
+            ConstElementPtr class_elem = classes->get(i);
+            // Get class name.
+            ConstElementPtr name_elem = class_elem->get("name");
+            if (!name_elem) {
+                isc_throw(BadValue, "checkLimits4 - client-class.name is missing: "
+                          << prettyPrint(limits));
+            }
+
+            std::string name = name_elem->stringValue();
+
+            // Now look for an address-limit
+            size_t limit;
+            if (!getLeaseLimit(class_elem, Lease::TYPE_V4, limit)) {
+                // No limit, go to the next class.
+                continue;
+            }
+
+            // If the limit is > 0 look up the class lease count.  Limit of 0 always
+            // denies the lease.
+            size_t lease_count = 0;
+            if (limit) {
+                lease_count = getClassLeaseCount(name);
+            }
+
+            // If we're over the limit, return the error, no need to evaluate any others.
+            if (lease_count >= limit) {
+                std::ostringstream ss;
+                ss << "address limit " << limit << " for client class \""
+                   << name << "\", current lease count " << lease_count;
+                return (ss.str());
+            }
+        }
+    }
+
+    // If there were class limits we passed them, now look for a subnet limit.
+    ConstElementPtr subnet_elem = limits->get("subnet");
+    if (subnet_elem) {
+        // Get the subnet id.
+        ConstElementPtr id_elem = subnet_elem->get("id");
+        if (!id_elem) {
+            isc_throw(BadValue, "checkLimits4 - subnet.id is missing: "
+                      << prettyPrint(limits));
+        }
+
+        SubnetID subnet_id = id_elem->intValue();
+
+        // Now look for an address-limit.
+        size_t limit;
+        if (getLeaseLimit(subnet_elem, Lease::TYPE_V4, limit)) {
+            // If the limit is > 0 look up the subnet lease count. Limit of 0 always
+            // denies the lease.
+            int64_t lease_count = 0;
+            if (limit) {
+                lease_count = getSubnetStat(subnet_id, "assigned-addresses");
+            }
+
+            // If we're over the limit, return the error.
+            if (lease_count >= limit) {
+                std::ostringstream ss;
+                ss << "address limit " << limit << " for subnet ID " << subnet_id
+                   << ", current lease count " << lease_count;
+                return (ss.str());
+            }
+        }
+    }
+
+    // No limits exceeded!
+    return ("");
+}
+
+std::string
+TrackingLeaseMgr::checkLimitsInMemory6(isc::data::ConstElementPtr const& user_context) const {
+    if (!user_context) {
+        return ("");
+    }
+
+    ConstElementPtr limits = user_context->find("ISC/limits");
+    if (!limits) {
+        return ("");
+    }
+
+    // Iterate over the 'client-classes' list in 'limits'. For each class that specifies
+    // limit (either "address-limit" or "prefix-limit", check its value against the appropriate
+    // class lease count.
+    ConstElementPtr classes = limits->get("client-classes");
+    if (classes) {
+        for (int i = 0; i < classes->size(); ++i) {
+            ConstElementPtr class_elem = classes->get(i);
+            // Get class name.
+            ConstElementPtr name_elem = class_elem->get("name");
+            if (!name_elem) {
+                isc_throw(BadValue, "checkLimits6 - client-class.name is missing: "
+                          << prettyPrint(limits));
+            }
+
+            std::string name = name_elem->stringValue();
+
+            // Now look for either address-limit or a prefix=limit.
+            size_t limit = 0;
+            Lease::Type ltype = Lease::TYPE_NA;
+            if (!getLeaseLimit(class_elem, ltype, limit)) {
+                ltype = Lease::TYPE_PD;
+                if (!getLeaseLimit(class_elem, ltype, limit)) {
+                    // No limits for this class, skip to the next.
+                    continue;
+                }
+            }
+
+            // If the limit is > 0 look up the class lease count.  Limit of 0 always
+            // denies the lease.
+            size_t lease_count = 0;
+            if (limit) {
+                lease_count = getClassLeaseCount(name, ltype);
+            }
+
+            // If we're over the limit, return the error, no need to evaluate any others.
+            if (lease_count >= limit) {
+                std::ostringstream ss;
+                ss << (ltype == Lease::TYPE_NA ? "address" : "prefix")
+                   << " limit " << limit << " for client class \""
+                   << name << "\", current lease count " << lease_count;
+                return (ss.str());
+            }
+        }
+    }
+
+    // If there were class limits we passed them, now look for a subnet limit.
+    ConstElementPtr subnet_elem = limits->get("subnet");
+    if (subnet_elem) {
+        // Get the subnet id.
+        ConstElementPtr id_elem = subnet_elem->get("id");
+        if (!id_elem) {
+            isc_throw(BadValue, "checkLimits6 - subnet.id is missing: "
+                      << prettyPrint(limits));
+        }
+
+        SubnetID subnet_id = id_elem->intValue();
+
+        // Now look for either address-limit or a prefix=limit.
+        size_t limit = 0;
+        Lease::Type ltype = Lease::TYPE_NA;
+        if (!getLeaseLimit(subnet_elem, ltype, limit)) {
+            ltype = Lease::TYPE_PD;
+            if (!getLeaseLimit(subnet_elem, ltype, limit)) {
+                // No limits for the subnet so none exceeded!
+                return ("");
+            }
+        }
+
+        // If the limit is > 0 look up the class lease count.  Limit of 0 always
+        // denies the lease.
+        int64_t lease_count = 0;
+        if (limit) {
+            lease_count = getSubnetStat(subnet_id, (ltype == Lease::TYPE_NA ?
+                                                    "assigned-nas" : "assigned-pds"));
+        }
+
+        // If we're over the limit, return the error.
+        if (lease_count >= limit) {
+            std::ostringstream ss;
+            ss << (ltype == Lease::TYPE_NA ? "address" : "prefix")
+               << " limit " << limit << " for subnet ID " << subnet_id
+               << ", current lease count " << lease_count;
+            return (ss.str());
+        }
+    }
+
+    // No limits exceeded!
+    return ("");
+}
+
+int64_t
+TrackingLeaseMgr::getSubnetStat(const SubnetID& subnet_id, const std::string& stat_label) const {
+    /// @todo This could be simplified if StatsMgr provided a mechanism to
+    /// return the most recent sample as an InterSample.
+    std::string stat_name = StatsMgr::generateName("subnet", subnet_id, stat_label);
+    ConstElementPtr stat = StatsMgr::instance().get(stat_name);
+    ConstElementPtr samples = stat->get(stat_name);
+    if (samples && samples->size()) {
+        auto sample = samples->get(0);
+        if (sample->size()) {
+            auto count_elem = sample->get(0);
+            return (count_elem->intValue());
+        }
+    }
+
+    return (0);
+}
+
+bool
+TrackingLeaseMgr::getLeaseLimit(ConstElementPtr parent, Lease::Type ltype, size_t& limit) const {
+    ConstElementPtr limit_elem = parent->get(ltype == Lease::TYPE_PD ?
+                                             "prefix-limit" : "address-limit");
+    if (limit_elem) {
+        limit = limit_elem->intValue();
+        return (true);
+    }
+
+    return (false);
 }
 
 std::string
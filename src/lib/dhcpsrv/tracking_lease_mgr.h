@@ -8,6 +8,10 @@
 #define TRACKING_LEASE_MGR_H
 
 #include <asiolink/io_address.h>
+#include <cc/data.h>
+#include <database/database_connection.h>
+#include <dhcpsrv/lease_limit_counter.h>
+#include <dhcpsrv/lease_stats_counter.h>
 #include <dhcpsrv/lease_mgr.h>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/composite_key.hpp>
@@ -16,6 +20,7 @@
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/sequenced_index.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 #include <functional>
 #include <string>
@@ -73,6 +78,13 @@ namespace dhcp {
 /// but two concurrent threads extremely rarely work on allocating a lease for
 /// the same client. A passive wait could be another option here, but it is a
 /// much more complicated solution for a bit of gain.
+///
+/// The tracking functions also maintain the optional in-memory lease
+/// limit counter (see @c LeaseLimitCounter). When it is enabled the
+/// lease limits are checked against the counter rather than with
+/// queries to the database. They similarly maintain the optional in-memory
+/// lease statistics counter (see @c LeaseStatsCounter) serving the lease
+/// statistics queries without scanning the leases.
 class TrackingLeaseMgr : public LeaseMgr {
 public:
 
@@ -263,13 +275,150 @@ public:
     /// @brief Checks if any callbacks have been registered.
     ///
     /// It is a quick check to be performed by the backends whether or not
-    /// the callbacks mechanism is used.
+    /// the callbacks mechanism is used. The in-memory lease limit counter
+    /// relies on the same mechanism as the in-memory lease statistics
+    /// counter, so it is also true when a counter is enabled.
     ///
-    /// @return true if any callbacks have been registered.
+    /// @return true if any callbacks have been registered or a lease
+    /// counter is enabled.
     bool hasCallbacks() const;
 
+    /// @brief Checks if the in-memory lease limit counter is enabled.
+    ///
+    /// @return true if the lease limits are checked in memory.
+    bool hasLimitCounter() const {
+        return (static_cast<bool>(limit_counter_));
+    }
+
+    /// @brief Checks if the in-memory lease statistics counter is enabled.
+    ///
+    /// @return true if the lease statistics are counted in memory.
+    bool hasStatsCounter() const {
+        return (static_cast<bool>(stats_counter_));
+    }
+
 protected:
 
+    /// @brief Returns the value of the in-memory-limits parameter.
+    ///
+    /// @param parameters lease database access parameters.
+    /// @return true if the in-memory-limits parameter is "true".
+    /// @throw BadValue if the parameter is neither "true" nor "false".
+    static bool getInMemoryLimits(const db::DatabaseConnection::ParameterMap& parameters);
+
+    /// @brief Enables the in-memory lease limit counter.
+    ///
+    /// The existing leases of both families are counted. It must be
+    /// called from a thread-safe context, e.g. by the backend constructor.
+    void enableLimitCounter();
+
+    /// @brief Recounts the leases of a family in the lease limit counter.
+    ///
+    /// The leases are fetched by pages.
+    ///
+    /// @param family AF_INET or AF_INET6.
+    /// @throw InvalidOperation if the lease limit counter is not enabled.
+    void recountLimitCounter(uint16_t family);
+
+    /// @brief Returns the value of the in-memory-stats parameter.
+    ///
+    /// @param parameters lease database access parameters.
+    /// @return true if the in-memory-stats parameter is "true".
+    /// @throw BadValue if the parameter is neither "true" nor "false".
+    static bool getInMemoryStats(const db::DatabaseConnection::ParameterMap& parameters);
+
+    /// @brief Enables the in-memory lease statistics counter.
+    ///
+    /// The existing leases of both families are counted. It must be
+    /// called from a thread-safe context, e.g. by the backend constructor.
+    void enableStatsCounter();
+
+    /// @brief Recounts the leases of a family in the lease statistics
+    /// counter.
+    ///
+    /// The leases are fetched by pages.
+    ///
+    /// @param family AF_INET or AF_INET6.
+    /// @throw InvalidOperation if the lease statistics counter is not
+    /// enabled.
+    void recountStatsCounter(uint16_t family);
+
+    /// @brief Creates and starts a lease statistics query served by the
+    /// lease statistics counter.
+    ///
+    /// The select mode of the query follows the arguments as for the
+    /// @c LeaseStatsQuery constructors: all subnets when the first subnet
+    /// ID is 0, a single subnet when only the last subnet ID is 0 and
+    /// a range of subnets otherwise.
+    ///
+    /// @param family AF_INET or AF_INET6.
+    /// @param first_subnet_id first (or only) subnet ID.
+    /// @param last_subnet_id last subnet ID of a range.
+    /// @return the started query.
+    /// @throw InvalidOperation if the lease statistics counter is not
+    /// enabled.
+    LeaseStatsQueryPtr startStatsCounterQuery(uint16_t family,
+                                              const SubnetID& first_subnet_id = 0,
+                                              const SubnetID& last_subnet_id = 0);
+
+    /// @brief Invoked by the backends after deleting the expired-reclaimed
+    /// leases.
+    ///
+    /// The deleted leases are not returned by the backends, so the lease
+    /// statistics counter mirrors the deletion. It does nothing when the
+    /// counter is not enabled.
+    ///
+    /// @param family AF_INET or AF_INET6.
+    /// @param expire_before the deleted leases expired strictly before
+    /// this time.
+    void trackDeleteExpiredReclaimedLeases(uint16_t family, int64_t expire_before);
+
+    /// @brief Fetches the leases of a family by pages and passes them to
+    /// a function.
+    ///
+    /// @param family AF_INET or AF_INET6.
+    /// @param count function called for each lease.
+    void countLeases(uint16_t family,
+                     const std::function<void(const LeasePtr&)>& count);
+
+    /// @brief Checks the IPv4 lease limits against the class lease counts
+    /// returned by @c getClassLeaseCount and the subnet statistics.
+    ///
+    /// @param user_context all or part of the lease's user context, see
+    /// @c LeaseMgr::checkLimits4.
+    /// @return a string describing a limit that is being exceeded, or an empty
+    /// string if no limits are exceeded
+    std::string checkLimitsInMemory4(isc::data::ConstElementPtr const& user_context) const;
+
+    /// @brief Checks the IPv6 lease limits against the class lease counts
+    /// returned by @c getClassLeaseCount and the subnet statistics.
+    ///
+    /// @param user_context all or part of the lease's user context, see
+    /// @c LeaseMgr::checkLimits6.
+    /// @return a string describing a limit that is being exceeded, or an empty
+    /// string if no limits are exceeded
+    std::string checkLimitsInMemory6(isc::data::ConstElementPtr const& user_context) const;
+
+    /// @brief Fetches the most recent value for a subnet statistic
+    ///
+    /// @param subnet_id subnet id of the subnet for which the stat is desired
+    /// @param stat_label name of the statistic desired (e.g. "assigned-addresses")
+    ///
+    /// @return Value of the statistic or zero if there are no entries found.
+    int64_t getSubnetStat(const SubnetID& subnet_id, const std::string& stat_label) const;
+
+    /// @brief Fetches the integer value of lease limit element from a parent element based
+    /// on Lease::Type.
+    ///
+    /// @param parent parent element (e.g. "client-class" or "subnet") in which to look for
+    /// the limit
+    /// @param ltype Lease::Type of the limit for which to look (one of Lease::TYPE_V4,
+    /// Lease::TYPE_NA, or Lease::TYPE_PD)
+    /// @param[out] limit contains the value of the limit if found
+    ///
+    /// @return bool true if a limit for the lease type was found, false otherwise.
+    bool getLeaseLimit(data::ConstElementPtr parent, Lease::Type ltype, size_t& limit) const;
+
     /// @brief Converts callback type to string for logging purposes.
     ///
     /// @param type callback type.
@@ -307,8 +456,21 @@ protected:
     /// It is empty if locking is not used (e.g. Memfile backend) or when there
     /// are no ongoing allocations.
     std::unordered_set<asiolink::IOAddress, asiolink::IOAddress::Hash> locked_leases_;
+
+    /// @brief The in-memory lease limit counter.
+    ///
+    /// It is null unless enabled by the backend.
+    boost::scoped_ptr<LeaseLimitCounter> limit_counter_;
+
+    /// @brief The in-memory lease statistics counter.
+    ///
+    /// It is null unless enabled by the backend.
+    boost::scoped_ptr<LeaseStatsCounter> stats_counter_;
 };
 
+/// @brief Pointer to a tracking lease manager.
+typedef boost::shared_ptr<TrackingLeaseMgr> TrackingLeaseMgrPtr;
+
 } // end of namespace isc::dhcp
 } // end of namespace isc
 
@@ -13,6 +13,7 @@
 #include <exceptions/exceptions.h>
 
 #include <cryptolink/cryptolink.h>
+#include <cryptolink/crypto_hmac.h>
 
 #include <dns/tsigkey.h>
 
@@ -158,6 +159,38 @@ TEST_F(TSIGKeyTest, assignment) {
     compareTSIGKeys(original, copy);
 }
 
+// Checks that the HMAC objects are recycled by the key and its copies.
+TEST_F(TSIGKeyTest, createHMAC) {
+    const TSIGKey key(key_name, TSIGKey::HMACSHA256_NAME(),
+                      secret.c_str(), secret.size());
+    boost::shared_ptr<isc::cryptolink::HMAC> hmac = key.createHMAC();
+    ASSERT_TRUE(hmac);
+    EXPECT_EQ(isc::cryptolink::SHA256, hmac->getHashAlgorithm());
+    hmac->update("data", 4);
+    const vector<uint8_t> sig = hmac->sign(32);
+
+    // A second object is created while the first one is used.
+    boost::shared_ptr<isc::cryptolink::HMAC> other = key.createHMAC();
+    EXPECT_NE(hmac, other);
+    other.reset();
+
+    // The released object is reset and returned by a copy of the key.
+    isc::cryptolink::HMAC* raw = hmac.get();
+    hmac.reset();
+    const TSIGKey copy(key);
+    hmac = copy.createHMAC();
+    EXPECT_EQ(raw, hmac.get());
+    hmac->update("data", 4);
+    EXPECT_TRUE(sig == hmac->sign(32));
+
+    // The objects can outlive their key.
+    TSIGKey* key2 = new TSIGKey(key_name, TSIGKey::HMACSHA256_NAME(),
+                                secret.c_str(), secret.size());
+    other = key2->createHMAC();
+    delete key2;
+    EXPECT_NO_THROW(other.reset());
+}
+
 class TSIGKeyRingTest : public ::testing::Test {
 protected:
     TSIGKeyRingTest() :
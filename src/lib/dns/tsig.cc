@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -68,10 +68,7 @@ struct TSIGContext::TSIGContextImpl {
             // it at this moment; a subsequent sign/verify operation will try
             // to create the HMAC, which would also fail.
             try {
-                hmac_.reset(CryptoLink::getCryptoLink().createHMAC(
-                                key_.getSecret(), key_.getSecretLength(),
-                                key_.getAlgorithm()),
-                                deleteHMAC);
+                hmac_ = key_.createHMAC();
             } catch (const isc::Exception&) {
                 return;
             }
@@ -118,17 +115,14 @@ struct TSIGContext::TSIGContextImpl {
     // has been successfully created in the constructor, return it; otherwise
     // create a new one and return it.  In the former case, the ownership is
     // transferred to the caller; the stored HMAC will be reset after the
-    // call.
+    // call.  The key recycles the released HMAC objects.
     HMACPtr createHMAC() {
         if (hmac_) {
             HMACPtr ret = HMACPtr();
             ret.swap(hmac_);
             return (ret);
         }
-        return (HMACPtr(CryptoLink::getCryptoLink().createHMAC(
-                            key_.getSecret(), key_.getSecretLength(),
-                            key_.getAlgorithm()),
-                        deleteHMAC));
+        return (key_.createHMAC());
     }
 
     // The following three are helper methods to compute the digest for
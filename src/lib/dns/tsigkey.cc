@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,6 +7,7 @@
 #include <config.h>
 
 #include <map>
+#include <mutex>
 #include <utility>
 #include <vector>
 #include <sstream>
@@ -14,12 +15,14 @@
 #include <exceptions/exceptions.h>
 
 #include <cryptolink/cryptolink.h>
+#include <cryptolink/crypto_hmac.h>
 
 #include <dns/name.h>
 #include <util/encode/base64.h>
 #include <dns/tsigkey.h>
 
 #include <boost/lexical_cast.hpp>
+#include <boost/weak_ptr.hpp>
 
 using namespace std;
 using namespace isc::cryptolink;
@@ -53,6 +56,59 @@ namespace {
 
         return (isc::cryptolink::UNKNOWN_HASH);
     }
+
+    /// \brief Pool of reset HMAC objects shared by the copies of a key.
+    struct HMACPool {
+        /// \brief The maximum number of kept objects.
+        static const size_t MAX_SIZE = 16;
+
+        /// \brief Destructor.
+        ~HMACPool() {
+            for (auto hmac : hmacs_) {
+                deleteHMAC(hmac);
+            }
+        }
+
+        /// \brief The mutex protecting the objects.
+        std::mutex mutex_;
+
+        /// \brief The objects.
+        vector<HMAC*> hmacs_;
+    };
+
+    /// \brief Deleter giving the HMAC objects back to their pool.
+    struct HMACRecycler {
+        /// \brief Constructor.
+        ///
+        /// \param pool The pool.
+        explicit HMACRecycler(const boost::shared_ptr<HMACPool>& pool)
+            : pool_(pool) {
+        }
+
+        /// \brief Resets the object and puts it in the pool, or deletes
+        /// it when the pool is full or gone.
+        ///
+        /// \param hmac The object.
+        void operator()(HMAC* hmac) const {
+            boost::shared_ptr<HMACPool> pool = pool_.lock();
+            if (pool) {
+                try {
+                    hmac->reset();
+                    std::lock_guard<std::mutex> lock(pool->mutex_);
+                    if (pool->hmacs_.size() < HMACPool::MAX_SIZE) {
+                        pool->hmacs_.push_back(hmac);
+                        return;
+                    }
+                } catch (...) {
+                    // Delete the object.
+                }
+            }
+            deleteHMAC(hmac);
+        }
+
+        /// \brief The pool which does not outlive the key.
+        boost::weak_ptr<HMACPool> pool_;
+    };
 }
 
 struct
@@ -63,7 +119,8 @@ TSIGKey::TSIGKeyImpl {
 
         key_name_(key_name), algorithm_name_(algorithm_name),
         algorithm_(algorithm), digestbits_(digestbits),
-        secret_()
+        secret_(),
+        hmacs_(new HMACPool())
     {
         // Convert the key and algorithm names to the canonical form.
         key_name_.downcase();
@@ -80,7 +137,8 @@ TSIGKey::TSIGKeyImpl {
         key_name_(key_name), algorithm_name_(algorithm_name),
         algorithm_(algorithm), digestbits_(digestbits),
         secret_(static_cast<const uint8_t*>(secret),
-                static_cast<const uint8_t*>(secret) + secret_len)
+                static_cast<const uint8_t*>(secret) + secret_len),
+        hmacs_(new HMACPool())
     {
         // Convert the key and algorithm names to the canonical form.
         key_name_.downcase();
@@ -94,6 +152,8 @@ TSIGKey::TSIGKeyImpl {
     const isc::cryptolink::HashAlgorithm algorithm_;
     size_t digestbits_;
     const vector<uint8_t> secret_;
+    // Shared by the copies of the key.
+    boost::shared_ptr<HMACPool> hmacs_;
 };
 
 TSIGKey::TSIGKey(const Name& key_name, const Name& algorithm_name,
@@ -239,6 +299,23 @@ TSIGKey::getSecretLength() const {
     return (impl_->secret_.size());
 }
 
+boost::shared_ptr<HMAC>
+TSIGKey::createHMAC() const {
+    {
+        std::lock_guard<std::mutex> lock(impl_->hmacs_->mutex_);
+        if (!impl_->hmacs_->hmacs_.empty()) {
+            HMAC* hmac = impl_->hmacs_->hmacs_.back();
+            impl_->hmacs_->hmacs_.pop_back();
+            return (boost::shared_ptr<HMAC>(hmac, HMACRecycler(impl_->hmacs_)));
+        }
+    }
+    return (boost::shared_ptr<HMAC>(
+                CryptoLink::getCryptoLink().createHMAC(getSecret(),
+                                                       getSecretLength(),
+                                                       getAlgorithm()),
+                HMACRecycler(impl_->hmacs_)));
+}
+
 std::string
 TSIGKey::toText() const {
     size_t digestbits = getDigestbits();
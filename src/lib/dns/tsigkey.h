@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,6 +9,8 @@
 
 #include <cryptolink/cryptolink.h>
 
+#include <boost/shared_ptr.hpp>
+
 namespace isc {
 namespace dns {
 
@@ -190,6 +192,19 @@ public:
     const void* getSecret() const;
     //@}
 
+    /// \brief Create an HMAC object for the key.
+    ///
+    /// The HMAC objects are recycled: when the returned object is released
+    /// it is reset and kept by the key, and its copies, for the next call.
+    /// This avoids deriving the key again for each signed or verified
+    /// message.
+    ///
+    /// \exception isc::cryptolink::CryptoLinkError if the HMAC object can't
+    /// be created, e.g. the algorithm is not supported.
+    ///
+    /// \return A pointer to an HMAC object.
+    boost::shared_ptr<isc::cryptolink::HMAC> createHMAC() const;
+
     /// \brief Converts the TSIGKey to a string value
     ///
     /// The resulting string will be of the form
@@ -7,7 +7,9 @@
 #include <config.h>
 
 #include <eval/dependency.h>
+#include <eval/evaluate.h>
 #include <boost/pointer_cast.hpp>
+#include <vector>
 
 namespace isc {
 namespace dhcp {
@@ -33,5 +35,40 @@ bool dependOnClass(const ExpressionPtr& expr, const std::string& name) {
     return (false);
 }
 
+std::set<std::string> getMemberPrerequisites(const Expression& expr) {
+    // The prerequisites of the values of the stack.
+    std::vector<std::set<std::string> > stack;
+    for (auto const& token : expr) {
+        int arity = getTokenArity(token);
+        if ((arity < 0) || (stack.size() < static_cast<size_t>(arity))) {
+            return (std::set<std::string>());
+        }
+        std::set<std::string> prerequisites;
+        boost::shared_ptr<TokenMember> member =
+            boost::dynamic_pointer_cast<TokenMember>(token);
+        if (member) {
+            prerequisites.insert(member->getClientClass());
+        } else if (dynamic_cast<TokenAnd*>(token.get())) {
+            // Both operands must be true.
+            prerequisites = stack[stack.size() - 2];
+            prerequisites.insert(stack.back().begin(), stack.back().end());
+        } else if (dynamic_cast<TokenOr*>(token.get())) {
+            // One of the operands must be true.
+            const std::set<std::string>& left = stack[stack.size() - 2];
+            for (auto const& name : stack.back()) {
+                if (left.count(name) > 0) {
+                    prerequisites.insert(name);
+                }
+            }
+        }
+        stack.resize(stack.size() - arity);
+        stack.push_back(prerequisites);
+    }
+    if (stack.size() != 1) {
+        return (std::set<std::string>());
+    }
+    return (stack.back());
+}
+
 }; // end of isc::dhcp namespace
 }; // end of isc namespace
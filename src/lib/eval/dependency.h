@@ -8,6 +8,7 @@
 #define DEPENDENCY_H
 
 #include <eval/token.h>
+#include <set>
 #include <string>
 
 namespace isc {
@@ -31,6 +32,17 @@ bool dependOnClass(const TokenPtr& token, const std::string& name);
 /// @return true if a member of expr depends on name, false if not.
 bool dependOnClass(const ExpressionPtr& expr, const std::string& name);
 
+/// @brief Returns the classes a boolean expression needs to match.
+///
+/// The expression can't evaluate to true when the packet is not a member
+/// of one of these classes, e.g. member('foo') and option[12].exists needs
+/// 'foo' and member('foo') or member('bar') needs nothing.
+///
+/// @param expr A boolean expression.
+/// @return The names of the classes the packet must be a member of for
+/// the expression to be true (empty when unknown).
+std::set<std::string> getMemberPrerequisites(const Expression& expr);
+
 }; // end of isc::dhcp namespace
 }; // end of isc namespace
 
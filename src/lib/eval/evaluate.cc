@@ -6,17 +6,200 @@
 
 #include <config.h>
 
+#include <dhcp/dhcp4.h>
+#include <dhcp/pkt4.h>
 #include <eval/evaluate.h>
 
+#include <boost/pointer_cast.hpp>
+
+#include <utility>
+
 namespace isc {
 namespace dhcp {
 
-bool evaluateBool(const Expression& expr, Pkt& pkt) {
-    ValueStack values;
-    for (Expression::const_iterator it = expr.begin();
-         it != expr.end(); ++it) {
-        (*it)->evaluate(pkt, values);
+namespace {
+
+/// @brief Creates an empty value stack able to hold the values of an
+/// expression without reallocation.
+///
+/// @param expr the RPN expression
+/// @return the value stack
+ValueStack
+createValueStack(const Expression& expr) {
+    std::vector<std::string> storage;
+    storage.reserve(expr.size());
+    return (ValueStack(std::move(storage)));
+}
+
+/// @brief Checks if a token is a literal.
+///
+/// @param token the token
+/// @return true for a string (or integer), hexstring or IP address token.
+bool
+isLiteral(const TokenPtr& token) {
+    Token* t = token.get();
+    // TokenInteger derives from TokenString.
+    return (dynamic_cast<TokenString*>(t) || dynamic_cast<TokenHexString*>(t) ||
+            dynamic_cast<TokenIpAddress*>(t));
+}
+
+/// @brief Evaluates the tokens of an expression.
+///
+/// @param expr the RPN expression
+/// @param pkt the packet
+/// @param values the value stack
+/// @param cache the values of the option tokens already evaluated for
+/// the packet (may be null)
+void
+evaluateTokens(const Expression& expr, Pkt& pkt, ValueStack& values,
+               EvalCache* cache) {
+    for (auto const& token : expr) {
+        if (!cache || !dynamic_cast<TokenOption*>(token.get())) {
+            token->evaluate(pkt, values);
+            continue;
+        }
+        auto it = cache->find(token.get());
+        if (it != cache->end()) {
+            values.push(it->second);
+            continue;
+        }
+        token->evaluate(pkt, values);
+        if (!values.empty()) {
+            cache->insert(std::make_pair(token.get(), values.top()));
+        }
+    }
+}
+
+}
+
+int
+getTokenArity(const TokenPtr& token) {
+    Token* t = token.get();
+    // Literals and tokens reading the packet (TokenRelay4Option,
+    // TokenRelay6Option, TokenVendor, TokenVendorClass and TokenSubOption
+    // derive from TokenOption).
+    if (isLiteral(token) || dynamic_cast<TokenOption*>(t) ||
+        dynamic_cast<TokenPkt*>(t) || dynamic_cast<TokenPkt4*>(t) ||
+        dynamic_cast<TokenPkt6*>(t) || dynamic_cast<TokenRelay6Field*>(t) ||
+        dynamic_cast<TokenMember*>(t)) {
+        return (0);
+    }
+    // Unary operators.
+    if (dynamic_cast<TokenIpAddressToText*>(t) ||
+        dynamic_cast<TokenInt8ToText*>(t) ||
+        dynamic_cast<TokenInt16ToText*>(t) ||
+        dynamic_cast<TokenInt32ToText*>(t) ||
+        dynamic_cast<TokenUInt8ToText*>(t) ||
+        dynamic_cast<TokenUInt16ToText*>(t) ||
+        dynamic_cast<TokenUInt32ToText*>(t) ||
+        dynamic_cast<TokenNot*>(t)) {
+        return (1);
     }
+    // Binary operators.
+    if (dynamic_cast<TokenEqual*>(t) || dynamic_cast<TokenConcat*>(t) ||
+        dynamic_cast<TokenToHexString*>(t) || dynamic_cast<TokenAnd*>(t) ||
+        dynamic_cast<TokenOr*>(t)) {
+        return (2);
+    }
+    // Ternary operators.
+    if (dynamic_cast<TokenSubstring*>(t) || dynamic_cast<TokenSplit*>(t) ||
+        dynamic_cast<TokenIfElse*>(t)) {
+        return (3);
+    }
+    return (-1);
+}
+
+Expression
+compileExpression(const Expression& expr) {
+    // A value of the simulated stack: the tokens computing it and, when
+    // they do not read the packet, its value.
+    struct Value {
+        Expression tokens_;
+        bool constant_;
+        std::string value_;
+    };
+    std::vector<Value> stack;
+
+    // The constant operators don't read the packet.
+    Pkt4 pkt(DHCPDISCOVER, 0);
+
+    for (auto const& token : expr) {
+        int arity = getTokenArity(token);
+        if (arity < 0) {
+            return (expr);
+        }
+        if ((arity == 0) && !isLiteral(token)) {
+            // The token reads the packet.
+            Value value;
+            value.tokens_.push_back(token);
+            value.constant_ = false;
+            stack.push_back(value);
+            continue;
+        }
+        if (stack.size() < static_cast<size_t>(arity)) {
+            // Let the evaluation report the error.
+            return (expr);
+        }
+
+        // Merge the operands.
+        Value result;
+        result.constant_ = true;
+        ValueStack values;
+        for (size_t i = stack.size() - arity; i < stack.size(); ++i) {
+            Value& operand = stack[i];
+            result.tokens_.insert(result.tokens_.end(), operand.tokens_.begin(),
+                                  operand.tokens_.end());
+            result.constant_ = result.constant_ && operand.constant_;
+            values.push(operand.value_);
+        }
+        result.tokens_.push_back(token);
+        stack.resize(stack.size() - arity);
+
+        if (result.constant_) {
+            try {
+                token->evaluate(pkt, values);
+            } catch (...) {
+                // E.g. not 'foo': keep the error for the evaluation.
+                result.constant_ = false;
+            }
+        }
+        if (result.constant_ && (values.size() == 1)) {
+            result.value_ = values.top();
+            if (arity > 0) {
+                // Replace the subexpression by its value.
+                result.tokens_.clear();
+                result.tokens_.push_back(TokenPtr(new TokenString(result.value_)));
+            }
+        } else {
+            result.constant_ = false;
+        }
+        stack.push_back(result);
+    }
+
+    Expression compiled;
+    for (auto const& value : stack) {
+        compiled.insert(compiled.end(), value.tokens_.begin(),
+                        value.tokens_.end());
+    }
+    return (compiled);
+}
+
+bool
+evaluateConstant(const Expression& expr, std::string& value) {
+    if ((expr.size() != 1) || !isLiteral(expr[0])) {
+        return (false);
+    }
+    // The literals don't read the packet.
+    Pkt4 pkt(DHCPDISCOVER, 0);
+    ValueStack values;
+    expr[0]->evaluate(pkt, values);
+    value = values.top();
+    return (true);
+}
+
+bool evaluateBool(const Expression& expr, Pkt& pkt, EvalCache* cache) {
+    ValueStack values = createValueStack(expr);
+    evaluateTokens(expr, pkt, values, cache);
     if (values.size() != 1) {
         isc_throw(EvalBadStack, "Incorrect stack order. Expected exactly "
                   "1 value at the end of evaluation, got " << values.size());
@@ -25,11 +208,9 @@ bool evaluateBool(const Expression& expr, Pkt& pkt) {
 }
 
 std::string
-evaluateString(const Expression& expr, Pkt& pkt) {
-    ValueStack values;
-    for (auto it = expr.begin(); it != expr.end(); ++it) {
-        (*it)->evaluate(pkt, values);
-    }
+evaluateString(const Expression& expr, Pkt& pkt, EvalCache* cache) {
+    ValueStack values = createValueStack(expr);
+    evaluateTokens(expr, pkt, values, cache);
     if (values.size() != 1) {
         isc_throw(EvalBadStack, "Incorrect stack order. Expected exactly "
                   "1 value at the end of evaluation, got " << values.size());
@@ -37,6 +218,26 @@ evaluateString(const Expression& expr, Pkt& pkt) {
     return (values.top());
 }
 
+void
+shareTokens(Expression& expr, SharedTokens& tokens) {
+    for (auto& token : expr) {
+        boost::shared_ptr<TokenOption> option =
+            boost::dynamic_pointer_cast<TokenOption>(token);
+        if (!option) {
+            continue;
+        }
+        std::string key = option->getCacheKey();
+        if (key.empty()) {
+            continue;
+        }
+        auto it = tokens.find(key);
+        if (it == tokens.end()) {
+            tokens[key] = token;
+        } else {
+            token = it->second;
+        }
+    }
+}
 
 }; // end of isc::dhcp namespace
 }; // end of isc namespace
@@ -8,25 +8,94 @@
 #define EVALUATE_H
 
 #include <eval/token.h>
+#include <map>
 #include <string>
+#include <unordered_map>
 
 namespace isc {
 namespace dhcp {
 
+/// @brief Values of the option tokens evaluated for a packet
+///
+/// When several expressions are evaluated for the same packet, e.g. the
+/// client class expressions, the value of an option token (including
+/// relay, vendor and sub-option tokens) is computed once and reused by
+/// the next evaluations of the same token. The cache must not be used
+/// after the options of the packet were changed.
+typedef std::unordered_map<const Token*, std::string> EvalCache;
+
+/// @brief Option tokens shared between expressions by cache key
+typedef std::map<std::string, TokenPtr> SharedTokens;
+
 /// @brief Evaluate a RPN expression for a v4 or v6 packet and return
 ///        a true or false decision
 ///
 /// @param expr the RPN expression, i.e., a vector of parsed tokens
 /// @param pkt  The v4 or v6 packet
+/// @param cache the values of option tokens already evaluated for the
+///        packet (optional)
 /// @return the boolean decision
 /// @throw EvalStackError if there is not exactly one element on the value
 ///        stack at the end of the evaluation
 /// @throw EvalTypeError if the value at the top of the stack at the
 ///        end of the evaluation is not "false" or "true"
-bool evaluateBool(const Expression& expr, Pkt& pkt);
+bool evaluateBool(const Expression& expr, Pkt& pkt, EvalCache* cache = 0);
+
+/// @brief Evaluate a RPN expression for a v4 or v6 packet and return
+///        a string value
+///
+/// @param expr the RPN expression, i.e., a vector of parsed tokens
+/// @param pkt  The v4 or v6 packet
+/// @param cache the values of option tokens already evaluated for the
+///        packet (optional)
+/// @return the string value
+/// @throw EvalStackError if there is not exactly one element on the value
+///        stack at the end of the evaluation
+std::string evaluateString(const Expression& expr, Pkt& pkt,
+                           EvalCache* cache = 0);
 
+/// @brief Shares the option tokens of an expression
+///
+/// The option tokens of the expression are replaced by the equal tokens
+/// already shared by other expressions so an @c EvalCache computes their
+/// values only once for all the expressions. The option tokens without
+/// an equal shared token are added to the shared tokens.
+///
+/// @param expr the RPN expression
+/// @param tokens the shared tokens
+void shareTokens(Expression& expr, SharedTokens& tokens);
+
+/// @brief Returns the number of values a token pops from the value stack
+///
+/// @param token the token
+/// @return the number of operands of the token or -1 for an unknown
+///         token, e.g. a token made by a hook library
+int getTokenArity(const TokenPtr& token);
+
+/// @brief Compiles a RPN expression
+///
+/// The subexpressions which do not depend on the packet, e.g.
+/// concat('foo', 'bar') or ifelse('true', 'a', 'b'), are evaluated once
+/// and replaced by their value so they are not evaluated again for each
+/// packet. The tokens which can't be compiled, i.e. the tokens reading
+/// the packet and the tokens made by hook libraries, are kept as they are
+/// and interpreted when the expression is evaluated. An expression with
+/// unknown tokens is returned unchanged.
+///
+/// @param expr the RPN expression, i.e., a vector of parsed tokens
+/// @return the compiled expression, which evaluates to the same value
+Expression compileExpression(const Expression& expr);
 
-std::string evaluateString(const Expression& expr, Pkt& pkt);
+/// @brief Returns the value of a constant expression
+///
+/// A compiled expression which does not read the packet is reduced to
+/// a literal. Its value is returned so the users of the expression can
+/// prepare what they build from the value once.
+///
+/// @param expr the compiled RPN expression
+/// @param [out] value the value of the expression when it is constant
+/// @return true if the expression is constant, false otherwise
+bool evaluateConstant(const Expression& expr, std::string& value);
 
 }; // end of isc::dhcp namespace
 }; // end of isc namespace
@@ -100,4 +100,41 @@ TEST_F(DependencyTest, matching) {
     EXPECT_TRUE(result_);
 }
 
+/// @brief Returns the member prerequisites of an expression as a string.
+///
+/// @param expr The text of a boolean expression.
+/// @return The names of the classes separated by spaces.
+string prerequisites(const string& expr) {
+    EvalContext eval(Option::V4);
+    EXPECT_NO_THROW(eval.parseString(expr)) << expr;
+    string result;
+    for (auto const& name : getMemberPrerequisites(eval.expression)) {
+        if (!result.empty()) {
+            result += " ";
+        }
+        result += name;
+    }
+    return (result);
+}
+
+// This checks the classes an expression needs to match.
+TEST_F(DependencyTest, memberPrerequisites) {
+    EXPECT_EQ("", prerequisites("option[12].exists"));
+    EXPECT_EQ("foo", prerequisites("member('foo')"));
+    EXPECT_EQ("foo", prerequisites("member('foo') and option[12].exists"));
+    EXPECT_EQ("bar foo", prerequisites("member('foo') and member('bar')"));
+    EXPECT_EQ("", prerequisites("member('foo') or member('bar')"));
+    EXPECT_EQ("foo", prerequisites("(member('foo') and member('bar')) or "
+                                   "(member('foo') and option[12].exists)"));
+    EXPECT_EQ("", prerequisites("not member('foo')"));
+    EXPECT_EQ("bar", prerequisites("not member('foo') and member('bar')"));
+    EXPECT_EQ("", prerequisites("substring(option[61].hex,0,3) == 'foo'"));
+
+    // An expression leaving several values on the stack gives nothing.
+    Expression expr;
+    expr.push_back(TokenPtr(new TokenMember("foo")));
+    expr.push_back(TokenPtr(new TokenMember("bar")));
+    EXPECT_TRUE(getMemberPrerequisites(expr).empty());
+}
+
 };
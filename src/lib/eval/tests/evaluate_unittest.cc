@@ -512,4 +512,141 @@ TEST_F(ExpressionsTest, evaluateString) {
     testExpressionString(Option::V4, "hexstring(0xf01234,'..')", "f0..12..34");
 }
 
+// The values of the option tokens are memoized by the cache.
+TEST_F(EvaluateTest, cache) {
+    TokenPtr option(new TokenOption(100, TokenOption::TEXTUAL));
+    TokenPtr hundred4(new TokenString("hundred4"));
+    e_.push_back(option);
+    e_.push_back(hundred4);
+    e_.push_back(TokenPtr(new TokenEqual()));
+
+    EvalCache cache;
+    ASSERT_NO_THROW(result_ = evaluateBool(e_, *pkt4_, &cache));
+    EXPECT_TRUE(result_);
+    ASSERT_EQ(1, cache.size());
+    EXPECT_EQ("hundred4", cache[option.get()]);
+
+    // The cached value is used even when the packet changes.
+    pkt4_->delOption(100);
+    ASSERT_NO_THROW(result_ = evaluateBool(e_, *pkt4_, &cache));
+    EXPECT_TRUE(result_);
+    EXPECT_EQ("hundred4", evaluateString(Expression(1, option), *pkt4_, &cache));
+
+    // But not without the cache.
+    ASSERT_NO_THROW(result_ = evaluateBool(e_, *pkt4_));
+    EXPECT_FALSE(result_);
+}
+
+// Equal option tokens are shared between expressions.
+TEST_F(EvaluateTest, shareTokens) {
+    Expression e1;
+    e1.push_back(TokenPtr(new TokenOption(100, TokenOption::TEXTUAL)));
+    e1.push_back(TokenPtr(new TokenRelay4Option(1, TokenOption::HEXADECIMAL)));
+    Expression e2;
+    e2.push_back(TokenPtr(new TokenString("foo")));
+    e2.push_back(TokenPtr(new TokenOption(100, TokenOption::TEXTUAL)));
+    e2.push_back(TokenPtr(new TokenOption(100, TokenOption::HEXADECIMAL)));
+    e2.push_back(TokenPtr(new TokenRelay4Option(1, TokenOption::HEXADECIMAL)));
+    Expression e3 = e2;
+
+    SharedTokens tokens;
+    shareTokens(e1, tokens);
+    EXPECT_EQ(2, tokens.size());
+    shareTokens(e2, tokens);
+    EXPECT_EQ(3, tokens.size());
+
+    // The string token is not shared.
+    EXPECT_EQ(e3[0], e2[0]);
+    // The equal option tokens are replaced.
+    EXPECT_EQ(e1[0], e2[1]);
+    EXPECT_EQ(e1[1], e2[3]);
+    // Other option tokens are kept.
+    EXPECT_EQ(e3[2], e2[2]);
+}
+
+/// @brief Test fixture for testing the compilation of expressions.
+class CompileTest : public EvaluateTest {
+public:
+
+    /// @brief Parses and compiles an expression.
+    ///
+    /// @param expr expression to be parsed and compiled
+    /// @param type type of the expression
+    /// @return the compiled expression
+    Expression compile(const string& expr,
+                       EvalContext::ParserType type = EvalContext::PARSER_BOOL) {
+        EvalContext eval(Option::V4);
+        EXPECT_NO_THROW(eval.parseString(expr, type))
+            << " while parsing expression " << expr;
+        parsed_ = eval.expression;
+        return (compileExpression(parsed_));
+    }
+
+    Expression parsed_; ///< The parsed expression
+};
+
+// A constant boolean expression is folded into one token.
+TEST_F(CompileTest, constantBool) {
+    Expression compiled = compile("('foo' + 'bar' == 'foobar') and not ('a' == 'b')");
+    ASSERT_EQ(1, compiled.size());
+    EXPECT_TRUE(boost::dynamic_pointer_cast<TokenString>(compiled[0]));
+    EXPECT_TRUE(evaluateBool(compiled, *pkt4_));
+    EXPECT_TRUE(evaluateBool(parsed_, *pkt4_));
+}
+
+// A constant string expression is folded into one token.
+TEST_F(CompileTest, constantString) {
+    Expression compiled = compile("ifelse('a' == 'a', hexstring(0x1234, ':'), 'no')",
+                                  EvalContext::PARSER_STRING);
+    ASSERT_EQ(1, compiled.size());
+    EXPECT_EQ("12:34", evaluateString(compiled, *pkt4_));
+}
+
+// Only the subexpressions which do not read the packet are folded.
+TEST_F(CompileTest, partial) {
+    Expression compiled = compile("option[100].text == 'hun' + 'dred4'");
+    // The option token, the folded concatenation and the equal token.
+    ASSERT_EQ(5, parsed_.size());
+    ASSERT_EQ(3, compiled.size());
+    EXPECT_TRUE(evaluateBool(compiled, *pkt4_));
+
+    pkt4_->delOption(100);
+    EXPECT_FALSE(evaluateBool(compiled, *pkt4_));
+}
+
+// An expression reading the packet is not changed.
+TEST_F(CompileTest, packet) {
+    Expression compiled = compile("pkt4.msgtype == 1");
+    ASSERT_EQ(parsed_.size(), compiled.size());
+    for (size_t i = 0; i < parsed_.size(); ++i) {
+        EXPECT_EQ(parsed_[i], compiled[i]);
+    }
+}
+
+// Subexpressions which fail to evaluate are not folded so the error is
+// raised by the evaluation.
+TEST_F(CompileTest, error) {
+    // The parser does not accept not 'foo'.
+    e_.push_back(TokenPtr(new TokenString("foo")));
+    e_.push_back(TokenPtr(new TokenNot()));
+    Expression compiled = compileExpression(e_);
+    EXPECT_EQ(2, compiled.size());
+    EXPECT_THROW(evaluateBool(compiled, *pkt4_), EvalTypeError);
+}
+
+// The value of a constant expression is returned.
+TEST_F(CompileTest, evaluateConstant) {
+    string value;
+    Expression compiled = compile("'foo' + 0x6261 + 'r'",
+                                  EvalContext::PARSER_STRING);
+    EXPECT_TRUE(evaluateConstant(compiled, value));
+    EXPECT_EQ("foobar", value);
+
+    compiled = compile("substring(option[100].text, 0, 3)",
+                       EvalContext::PARSER_STRING);
+    EXPECT_FALSE(evaluateConstant(compiled, value));
+    EXPECT_EQ("foobar", value);
+}
+
+
 };
@@ -27,6 +27,8 @@
 #include <boost/scoped_ptr.hpp>
 #include <gtest/gtest.h>
 
+#include <set>
+
 #include <arpa/inet.h>
 
 using namespace std;
@@ -3476,4 +3478,32 @@ TEST_F(TokenTest, splitMultipleDelims) {
     EXPECT_TRUE(checkFile());
 }
 
+// Verifies the cache keys of the option tokens.
+TEST_F(TokenTest, cacheKey) {
+    TokenOption option(100, TokenOption::TEXTUAL);
+    TokenOption option_hex(100, TokenOption::HEXADECIMAL);
+    TokenRelay4Option relay4(100, TokenOption::TEXTUAL);
+    TokenRelay6Option relay6(0, 100, TokenOption::TEXTUAL);
+    TokenRelay6Option relay6_outer(-1, 100, TokenOption::TEXTUAL);
+    TokenVendor vendor(Option::V4, 4491, TokenOption::HEXADECIMAL, 100);
+    TokenVendor vendor_any(Option::V4, 0, TokenOption::HEXADECIMAL, 100);
+    TokenVendorClass vendor_class(Option::V4, 4491, TokenVendor::DATA, 1);
+    TokenSubOption sub_option(100, 1, TokenOption::TEXTUAL);
+
+    std::vector<const TokenOption*> tokens = {
+        &option, &option_hex, &relay4, &relay6, &relay6_outer, &vendor,
+        &vendor_any, &vendor_class, &sub_option
+    };
+    std::set<std::string> keys;
+    for (const TokenOption* token : tokens) {
+        std::string key = token->getCacheKey();
+        EXPECT_FALSE(key.empty());
+        EXPECT_TRUE(keys.insert(key).second) << key;
+    }
+
+    // Equal tokens have the same key.
+    TokenOption other(100, TokenOption::TEXTUAL);
+    EXPECT_EQ(option.getCacheKey(), other.getCacheKey());
+}
+
 };
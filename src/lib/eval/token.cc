@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -27,6 +27,7 @@
 #include <string>
 #include <iomanip>
 #include <sstream>
+#include <typeinfo>
 
 using namespace isc::asiolink;
 using namespace isc::dhcp;
@@ -377,12 +378,38 @@ TokenOption::pushFailure(ValueStack& values) {
     return (txt);
 }
 
+std::string
+TokenOption::getCacheKey() const {
+    if (typeid(*this) != typeid(TokenOption)) {
+        return ("");
+    }
+    ostringstream key;
+    key << "option:" << option_code_ << ":" << representation_type_;
+    return (key.str());
+}
+
 TokenRelay4Option::TokenRelay4Option(const uint16_t option_code,
                                      const RepresentationType& rep_type)
     :TokenOption(option_code, rep_type) {
 }
 
+std::string
+TokenRelay4Option::getCacheKey() const {
+    if (typeid(*this) != typeid(TokenRelay4Option)) {
+        return ("");
+    }
+    ostringstream key;
+    key << "relay4:" << option_code_ << ":" << representation_type_;
+    return (key.str());
+}
+
 OptionPtr TokenRelay4Option::getOption(Pkt& pkt) {
+    // Use the index of the sub-options of a DHCPv4 packet.
+    Pkt4* pkt4 = dynamic_cast<Pkt4*>(&pkt);
+    if (pkt4) {
+        return (pkt4->getRAISubOption(option_code_));
+    }
+
     // Check if there is Relay Agent Option.
     OptionPtr rai = pkt.getOption(DHO_DHCP_AGENT_OPTIONS);
     if (!rai) {
@@ -393,6 +420,17 @@ OptionPtr TokenRelay4Option::getOption(Pkt& pkt) {
     return (rai->getOption(option_code_));
 }
 
+std::string
+TokenRelay6Option::getCacheKey() const {
+    if (typeid(*this) != typeid(TokenRelay6Option)) {
+        return ("");
+    }
+    ostringstream key;
+    key << "relay6:" << static_cast<int>(nest_level_) << ":" << option_code_
+        << ":" << representation_type_;
+    return (key.str());
+}
+
 OptionPtr TokenRelay6Option::getOption(Pkt& pkt) {
     try {
         // Check if it's a Pkt6.  If it's not the dynamic_cast will
@@ -1059,6 +1097,17 @@ uint32_t TokenVendor::getVendorId() const {
     return (vendor_id_);
 }
 
+std::string
+TokenVendor::getCacheKey() const {
+    if (typeid(*this) != typeid(TokenVendor)) {
+        return ("");
+    }
+    ostringstream key;
+    key << "vendor:" << universe_ << ":" << vendor_id_ << ":" << field_
+        << ":" << option_code_ << ":" << representation_type_;
+    return (key.str());
+}
+
 TokenVendor::FieldType TokenVendor::getField() const {
     return (field_);
 }
@@ -1168,6 +1217,17 @@ uint16_t TokenVendorClass::getDataIndex() const {
     return (index_);
 }
 
+std::string
+TokenVendorClass::getCacheKey() const {
+    if (typeid(*this) != typeid(TokenVendorClass)) {
+        return ("");
+    }
+    ostringstream key;
+    key << "vendor-class:" << universe_ << ":" << vendor_id_ << ":" << field_
+        << ":" << index_ << ":" << representation_type_;
+    return (key.str());
+}
+
 void TokenVendorClass::evaluate(Pkt& pkt, ValueStack& values) {
     // Get the option first.
     uint16_t code = 0;
@@ -1264,6 +1324,17 @@ TokenInteger::TokenInteger(const uint32_t value)
     :TokenString(EvalContext::fromUint32(value)), int_value_(value) {
 }
 
+std::string
+TokenSubOption::getCacheKey() const {
+    if (typeid(*this) != typeid(TokenSubOption)) {
+        return ("");
+    }
+    ostringstream key;
+    key << "sub-option:" << option_code_ << ":" << sub_option_code_ << ":"
+        << representation_type_;
+    return (key.str());
+}
+
 OptionPtr
 TokenSubOption::getSubOption(const OptionPtr& parent) {
     if (!parent) {
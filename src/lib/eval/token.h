@@ -10,6 +10,8 @@
 #include <exceptions/exceptions.h>
 #include <dhcp/pkt.h>
 #include <stack>
+#include <string>
+#include <vector>
 
 namespace isc {
 namespace dhcp {
@@ -30,7 +32,10 @@ typedef std::vector<TokenPtr> Expression;
 typedef boost::shared_ptr<Expression> ExpressionPtr;
 
 /// Evaluated values are stored as a stack of strings
-typedef std::stack<std::string> ValueStack;
+///
+/// The stack is backed by a vector so its storage can be allocated once
+/// for an evaluation.
+typedef std::stack<std::string, std::vector<std::string> > ValueStack;
 
 /// @brief EvalBadStack is thrown when more or less parameters are on the
 ///        stack than expected.
@@ -397,6 +402,15 @@ public:
         return (representation_type_);
     }
 
+    /// @brief Returns the key identifying the value of the token
+    ///
+    /// Tokens with the same key push the same value for a packet so they
+    /// can share an @c EvalCache entry.
+    ///
+    /// @return the key or an empty string when the token can't be shared,
+    /// e.g. for a class derived from this one by a hook library.
+    virtual std::string getCacheKey() const;
+
 protected:
     /// @brief Attempts to retrieve an option
     ///
@@ -442,6 +456,11 @@ public:
     TokenRelay4Option(const uint16_t option_code,
                       const RepresentationType& rep_type);
 
+    /// @brief Returns the key identifying the value of the token
+    ///
+    /// @return the key or an empty string when the token can't be shared.
+    virtual std::string getCacheKey() const;
+
 protected:
     /// @brief Attempts to obtain specified sub-option of option 82 from the packet
     /// @param pkt DHCPv4 packet (that hopefully contains option 82)
@@ -487,6 +506,11 @@ public:
         return (nest_level_);
     }
 
+    /// @brief Returns the key identifying the value of the token
+    ///
+    /// @return the key or an empty string when the token can't be shared.
+    virtual std::string getCacheKey() const;
+
 protected:
     /// @brief Attempts to obtain specified option from the specified relay block
     /// @param pkt DHCPv6 packet that hopefully contains the proper relay block
@@ -1103,6 +1127,11 @@ public:
     /// @return field type.
     FieldType getField() const;
 
+    /// @brief Returns the key identifying the value of the token
+    ///
+    /// @return the key or an empty string when the token can't be shared.
+    virtual std::string getCacheKey() const;
+
     /// @brief This is a method for evaluating a packet.
     ///
     /// Depending on the value of vendor_id, field type, representation and
@@ -1196,6 +1225,11 @@ public:
     /// @return data index (specifies which data chunk to retrieve)
     uint16_t getDataIndex() const;
 
+    /// @brief Returns the key identifying the value of the token
+    ///
+    /// @return the key or an empty string when the token can't be shared.
+    virtual std::string getCacheKey() const;
+
 protected:
 
     /// @brief This is a method for evaluating a packet.
@@ -1284,6 +1318,11 @@ public:
         return (sub_option_code_);
     }
 
+    /// @brief Returns the key identifying the value of the token
+    ///
+    /// @return the key or an empty string when the token can't be shared.
+    virtual std::string getCacheKey() const;
+
 protected:
     /// @brief Attempts to retrieve a sub-option.
     ///
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -27,6 +27,10 @@ CalloutHandle::CalloutHandle(const boost::shared_ptr<CalloutManager>& manager,
       manager_(manager), server_hooks_(ServerHooks::getServerHooks()),
       current_library_(-1), current_hook_(-1), next_step_(NEXT_STEP_CONTINUE) {
 
+    // Reserve a context slot for each library index including the -1
+    // index and the pre- and post-library callouts.
+    context_collection_.resize(manager_->getNumLibraries() + 3);
+
     // Call the "context_create" hook.  We should be OK doing this - although
     // the constructor has not finished running, all the member variables
     // have been created.
@@ -64,14 +68,48 @@ CalloutHandle::~CalloutHandle() {
 vector<string>
 CalloutHandle::getArgumentNames() const {
     vector<string> names;
-    for (ElementCollection::const_iterator i = arguments_.begin();
+    for (ArgumentCollection::const_iterator i = arguments_.begin();
          i != arguments_.end(); ++i) {
-        names.push_back(i->first);
+        if (i->second.set_) {
+            names.push_back(i->first);
+        }
     }
 
     return (names);
 }
 
+// Delete an argument, keeping its storage for the next value.
+
+void
+CalloutHandle::deleteArgument(const std::string& name) {
+    ArgumentCollection::iterator i = arguments_.find(name);
+    if (i != arguments_.end()) {
+        clearArgument(i->second);
+    }
+}
+
+void
+CalloutHandle::deleteAllArguments() {
+    for (auto& argument : arguments_) {
+        clearArgument(argument.second);
+    }
+}
+
+void
+CalloutHandle::clearArgument(Argument& argument) {
+    if (!argument.set_) {
+        return;
+    }
+    // The value is released now: the argument may be the last reference
+    // to e.g. a packet or a lease.
+    if (argument.clear_) {
+        (*argument.clear_)(argument.value_);
+    } else {
+        argument.value_ = boost::any();
+    }
+    argument.set_ = false;
+}
+
 ParkingLotHandlePtr
 CalloutHandle::getParkingLotHandlePtr() const {
     return (boost::make_shared<ParkingLotHandle>(server_hooks_.getParkingLotPtr(current_hook_)));
@@ -85,7 +123,19 @@ CalloutHandle::ElementCollection&
 CalloutHandle::getContextForLibrary() {
     // Access a reference to the element collection for the given index,
     // creating a new element collection if necessary, and return it.
-    return (context_collection_[current_library_]);
+    if (current_library_ < -1) {
+        isc_throw(NoSuchLibrary, "invalid library index "
+                  << current_library_ << " for a callout context");
+    }
+    size_t slot = static_cast<size_t>(current_library_ + 1);
+    if (slot >= context_collection_.size()) {
+        context_collection_.resize(slot + 1);
+    }
+    boost::shared_ptr<ElementCollection>& libcontext = context_collection_[slot];
+    if (!libcontext) {
+        libcontext.reset(new ElementCollection());
+    }
+    return (*libcontext);
 }
 
 // The "const" version of the above, used by the "getContext()" method.  If
@@ -93,15 +143,16 @@ CalloutHandle::getContextForLibrary() {
 
 const CalloutHandle::ElementCollection&
 CalloutHandle::getContextForLibrary() const {
-    auto libcontext = context_collection_.find(current_library_);
-    if (libcontext == context_collection_.end()) {
+    size_t slot = static_cast<size_t>(current_library_ + 1);
+    if ((current_library_ < -1) || (slot >= context_collection_.size()) ||
+        !context_collection_[slot]) {
         isc_throw(NoSuchCalloutContext, "unable to find callout context "
                   "associated with the current library index (" << current_library_ <<
                   ")");
     }
 
     // Return a reference to the context's element collection.
-    return (libcontext->second);
+    return (*context_collection_[slot]);
 }
 
 // Return the name of all items in the context associated with the current]
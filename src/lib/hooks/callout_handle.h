@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -17,6 +17,7 @@
 
 #include <map>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace isc {
@@ -98,15 +99,15 @@ public:
 
     /// Typedef to allow abbreviations in specifications when accessing
     /// context.  The ElementCollection is the name/value collection for
-    /// a particular context.  The "int" corresponds to the index of an
-    /// associated library - there is a 1:1 correspondence between libraries
-    /// and a name.value collection.
+    /// a particular context.  There is one slot per library index, from
+    /// -1 (no current library) to the index of the post-library callouts,
+    /// and a slot is null until the library creates its context.
     ///
-    /// The collection of contexts is stored in a map, as not every library
-    /// will require creation of a context associated with each packet.  In
-    /// addition, the structure is more flexible in that the size does not
-    /// need to be set when the CalloutHandle is constructed.
-    typedef std::map<int, ElementCollection> ContextCollection;
+    /// The slots are sized when the CalloutHandle is constructed so the
+    /// context of the current library is found without a lookup: not
+    /// every library will require creation of a context associated with
+    /// each packet, so the collections are only allocated on demand.
+    typedef std::vector<boost::shared_ptr<ElementCollection> > ContextCollection;
 
     /// @brief Constructor
     ///
@@ -141,11 +142,19 @@ public:
     /// Sets the value of an argument.  The argument is created if it does not
     /// already exist.
     ///
+    /// The storage of an argument is kept when it is deleted, so setting an
+    /// argument again with a value of the same type, as the server does on
+    /// each hook point for the packet being processed, assigns the value in
+    /// place without any memory allocation.
+    ///
     /// @param name Name of the argument.
     /// @param value Value to set.  That can be of any data type.
     template <typename T>
     void setArgument(const std::string& name, T value) {
-        arguments_[name] = value;
+        Argument& argument = arguments_[name];
+        assignValue(argument.value_, value, IsReusable<T>());
+        argument.clear_ = getClearer<T>(IsReusable<T>());
+        argument.set_ = true;
     }
 
     /// @brief Get argument
@@ -162,13 +171,13 @@ public:
     ///        the variable provided to receive the value.
     template <typename T>
     void getArgument(const std::string& name, T& value) const {
-        ElementCollection::const_iterator element_ptr = arguments_.find(name);
-        if (element_ptr == arguments_.end()) {
+        ArgumentCollection::const_iterator element_ptr = arguments_.find(name);
+        if ((element_ptr == arguments_.end()) || !element_ptr->second.set_) {
             isc_throw(NoSuchArgument, "unable to find argument with name " <<
                       name);
         }
 
-        value = boost::any_cast<T>(element_ptr->second);
+        value = boost::any_cast<T>(element_ptr->second.value_);
     }
 
     /// @brief Get argument names
@@ -182,25 +191,23 @@ public:
     /// @brief Delete argument
     ///
     /// Deletes an argument of the given name.  If an argument of that name
-    /// does not exist, the method is a no-op.
+    /// does not exist, the method is a no-op.  The value is released but the
+    /// storage of the argument is kept for a next value.
     ///
     /// N.B. If the element is a raw pointer, the pointed-to data is NOT deleted
     /// by this method.
     ///
     /// @param name Name of the element in the argument list to set.
-    void deleteArgument(const std::string& name) {
-        static_cast<void>(arguments_.erase(name));
-    }
+    void deleteArgument(const std::string& name);
 
     /// @brief Delete all arguments
     ///
-    /// Deletes all arguments associated with this context.
+    /// Deletes all arguments associated with this context.  As for
+    /// @ref deleteArgument, the values are released but the storage is kept.
     ///
     /// N.B. If any elements are raw pointers, the pointed-to data is NOT
     /// deleted by this method.
-    void deleteAllArguments() {
-        arguments_.clear();
-    }
+    void deleteAllArguments();
 
     /// @brief Sets the next processing step.
     ///
@@ -378,8 +385,8 @@ private:
     /// @return Reference to the collection of name/value pairs associated
     ///         with the current library.
     ///
-    /// @throw InvalidIndex current library index is not valid for the library
-    ///        handle collection.
+    /// @throw NoSuchLibrary current library index is not valid for the
+    ///        library handle collection.
     ElementCollection& getContextForLibrary();
 
     /// @brief Return reference to context for current library (const version)
@@ -397,12 +404,93 @@ private:
 
     // Member variables
 
+    /// @brief Function releasing the value of a deleted argument in place.
+    typedef void (*Clearer)(boost::any& value);
+
+    /// @brief Argument value with its deletion state.
+    struct Argument {
+        /// @brief Constructor.
+        Argument() : value_(), clear_(0), set_(false) {
+        }
+
+        /// @brief Value of the argument.
+        boost::any value_;
+
+        /// @brief Function releasing the value in place, null when the
+        /// type of the value has no default to assign.
+        Clearer clear_;
+
+        /// @brief Flag indicating if the argument is set or deleted.
+        bool set_;
+    };
+
+    /// @brief Arguments by name.
+    typedef std::map<std::string, Argument> ArgumentCollection;
+
+    /// @brief Tells if the values of a type can be assigned and released in
+    /// place.
+    ///
+    /// @tparam T type of the value.
+    template <typename T>
+    using IsReusable =
+        std::integral_constant<bool, std::is_default_constructible<T>::value &&
+                                     std::is_copy_assignable<T>::value>;
+
+    /// @brief Assigns a value in place when the argument holds a value of
+    /// the same type.
+    ///
+    /// @param argument value of the argument.
+    /// @param value new value.
+    template <typename T>
+    static void assignValue(boost::any& argument, const T& value, std::true_type) {
+        T* current = boost::any_cast<T>(&argument);
+        if (current) {
+            *current = value;
+        } else {
+            argument = value;
+        }
+    }
+
+    /// @brief Assigns a value of a type which cannot be assigned in place.
+    ///
+    /// @param argument value of the argument.
+    /// @param value new value.
+    template <typename T>
+    static void assignValue(boost::any& argument, const T& value, std::false_type) {
+        argument = value;
+    }
+
+    /// @brief Releases a value in place by assigning the default value.
+    ///
+    /// @param argument value of the argument.
+    template <typename T>
+    static void clearValue(boost::any& argument) {
+        *boost::any_cast<T>(&argument) = T();
+    }
+
+    /// @brief Returns the function releasing the values of a type in place.
+    template <typename T>
+    static Clearer getClearer(std::true_type) {
+        return (&clearValue<T>);
+    }
+
+    /// @brief Returns no function for the types without default values.
+    template <typename T>
+    static Clearer getClearer(std::false_type) {
+        return (0);
+    }
+
+    /// @brief Releases the value of an argument and marks it deleted.
+    ///
+    /// @param argument argument to delete.
+    void clearArgument(Argument& argument);
+
     /// Pointer to the collection of libraries for which this handle has been
     /// created.
     boost::shared_ptr<LibraryManagerCollection> lm_collection_;
 
     /// Collection of arguments passed to the callouts
-    ElementCollection arguments_;
+    ArgumentCollection arguments_;
 
     /// Context collection - there is one entry per library context.
     ContextCollection context_collection_;
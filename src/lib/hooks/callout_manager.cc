@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -19,11 +19,15 @@
 #include <functional>
 #include <utility>
 
+using namespace isc::data;
+using namespace isc::stats;
 using namespace std;
 
 namespace isc {
 namespace hooks {
 
+std::atomic<bool> CalloutManager::timing_enabled_(false);
+
 // Constructor
 CalloutManager::CalloutManager(int num_libraries)
     : server_hooks_(ServerHooks::getServerHooks()), current_library_(-1),
@@ -73,6 +77,12 @@ CalloutManager::registerCallout(const std::string& name,
     // process).
     int hook_index = server_hooks_.getIndex(name);
 
+    // The timing of the callouts registered after it was enabled starts
+    // right away.
+    if (isTimingEnabled()) {
+        createTiming(hook_index, library_index);
+    }
+
     // Iterate through the callout vector for the hook from start to end,
     // looking for the first entry where the library index is greater than
     // the present index.
@@ -153,9 +163,14 @@ CalloutManager::callCallouts(int hook_index, CalloutHandle& callout_handle) {
         LOG_DEBUG(callouts_logger, HOOKS_DBG_CALLS, HOOKS_CALLOUTS_BEGIN)
             .arg(server_hooks_.getName(callout_handle.getCurrentHook()));
 
+        // The callouts are bound to the hook when the libraries are loaded:
+        // take the vector and the timing flag only once for all of them.
+        const CalloutVector& callouts = hook_vector_[hook_index];
+        const bool timing = isTimingEnabled();
+
         // Call all the callouts.
-        for (CalloutVector::const_iterator i = hook_vector_[hook_index].begin();
-             i != hook_vector_[hook_index].end(); ++i) {
+        for (CalloutVector::const_iterator i = callouts.begin();
+             i != callouts.end(); ++i) {
             // In case the callout requires access to the context associated
             // with the library, set the current library index to the index
             // associated with the library that registered the callout being
@@ -194,6 +209,9 @@ CalloutManager::callCallouts(int hook_index, CalloutHandle& callout_handle) {
                     .arg(stopwatch.logFormatLastDuration());
             }
 
+            if (timing) {
+                recordTiming(hook_index, i->first, stopwatch.getLastMicroseconds());
+            }
         }
 
         // Mark end of callout execution. Include the total execution
@@ -209,6 +227,55 @@ CalloutManager::callCallouts(int hook_index, CalloutHandle& callout_handle) {
     }
 }
 
+void
+CalloutManager::setTimingEnabled(bool enabled) {
+    if (enabled) {
+        for (size_t hook_index = 0; hook_index < hook_vector_.size(); ++hook_index) {
+            for (auto const& entry : hook_vector_[hook_index]) {
+                createTiming(hook_index, entry.first);
+            }
+        }
+    }
+    timing_enabled_.store(enabled);
+}
+
+ElementPtr
+CalloutManager::getTimings() const {
+    ElementPtr timings = Element::createList();
+    for (auto const& timing : timings_) {
+        ElementPtr summary = isc::data::copy(timing.second->toElement());
+        summary->set("library-index", Element::create(timing.first.second));
+        summary->set("hook", Element::create(server_hooks_.getName(timing.first.first)));
+        summary->set("total",
+                     Element::create(static_cast<int64_t>(timing.second->getSum())));
+        timings->add(summary);
+    }
+    return (timings);
+}
+
+void
+CalloutManager::resetTimings() {
+    for (auto const& timing : timings_) {
+        timing.second->reset();
+    }
+}
+
+void
+CalloutManager::createTiming(int hook_index, int library_index) {
+    auto key = make_pair(hook_index, library_index);
+    if (timings_.count(key) == 0) {
+        timings_[key].reset(new LatencyHistogram(server_hooks_.getName(hook_index)));
+    }
+}
+
+void
+CalloutManager::recordTiming(int hook_index, int library_index, long usecs) {
+    auto timing = timings_.find(make_pair(hook_index, library_index));
+    if (timing != timings_.end()) {
+        timing->second->record(static_cast<uint64_t>(usecs > 0 ? usecs : 0));
+    }
+}
+
 void
 CalloutManager::callCommandHandlers(const std::string& command_name,
                                     CalloutHandle& callout_handle) {
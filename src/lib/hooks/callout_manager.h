@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,9 +10,11 @@
 #include <exceptions/exceptions.h>
 #include <hooks/library_handle.h>
 #include <hooks/server_hooks.h>
+#include <stats/latency_histogram.h>
 
 #include <boost/shared_ptr.hpp>
 
+#include <atomic>
 #include <climits>
 #include <map>
 #include <string>
@@ -120,6 +122,12 @@ public:
 /// @ref LibraryHandle::registerCommandCallout can install callouts on this
 /// hook point.
 ///
+/// The execution time of the callouts can be recorded in latency histograms,
+/// one per library and hook point. The timing is disabled by default and
+/// is enabled with @ref CalloutManager::setTimingEnabled. As the setting is
+/// shared by all callout managers, it is kept when the libraries are
+/// reloaded, but the recorded timings are not.
+///
 /// Note that the callout functions do not access the CalloutManager: instead,
 /// they use a LibraryHandle object.  This contains an internal pointer to
 /// the CalloutManager, but provides a restricted interface.  In that way,
@@ -264,6 +272,38 @@ public:
     ///        registered.
     void registerCommandHook(const std::string& command_name);
 
+    /// @brief Enables or disables the callout timing.
+    ///
+    /// Enabling the timing creates a latency histogram for each library
+    /// and hook point with registered callouts. The callouts registered
+    /// later get their histogram at registration time. Disabling the timing
+    /// keeps the recorded timings.
+    ///
+    /// @note The histograms are created without locking so this must not
+    /// be called while other threads call the callouts, i.e. it must be
+    /// called in a multi-threading critical section.
+    ///
+    /// @param enabled true to enable the callout timing, false to disable it.
+    void setTimingEnabled(bool enabled);
+
+    /// @brief Checks if the callout timing is enabled.
+    ///
+    /// @return true if the callout timing is enabled, false otherwise.
+    static bool isTimingEnabled() {
+        return (timing_enabled_.load(std::memory_order_relaxed));
+    }
+
+    /// @brief Returns the callout timings.
+    ///
+    /// @return A list with a map per library and hook point with recorded
+    /// timings. Each map has the "library-index", "hook" and "total"
+    /// (microseconds) entries added to the summary of the histogram, see
+    /// @ref isc::stats::LatencyHistogram::toElement.
+    isc::data::ElementPtr getTimings() const;
+
+    /// @brief Resets the callout timings.
+    void resetTimings();
+
     /// @brief Get number of libraries
     ///
     /// Returns the number of libraries that this CalloutManager is expected
@@ -397,6 +437,21 @@ private:
     /// @throw NoSuchLibrary Library index is not valid.
     void checkLibraryIndex(int library_index) const;
 
+    /// @brief Creates the latency histogram of a library and hook point.
+    ///
+    /// Does nothing when the histogram already exists.
+    ///
+    /// @param hook_index Index of the hook point.
+    /// @param library_index Index of the library.
+    void createTiming(int hook_index, int library_index);
+
+    /// @brief Records the execution time of a callout.
+    ///
+    /// @param hook_index Index of the hook point.
+    /// @param library_index Index of the library which registered the callout.
+    /// @param usecs Execution time in microseconds.
+    void recordTiming(int hook_index, int library_index, long usecs);
+
     // Member variables
 
     /// Reference to the singleton ServerHooks object.  See the
@@ -430,6 +485,15 @@ private:
 
     /// Number of libraries.
     int num_libraries_;
+
+    /// Latency histograms by hook point and library indexes.
+    ///
+    /// The map is modified only when the callouts are not called so it is
+    /// read without locking.
+    std::map<std::pair<int, int>, isc::stats::LatencyHistogramPtr> timings_;
+
+    /// Flag indicating if the callout timing is enabled.
+    static std::atomic<bool> timing_enabled_;
 };
 
 }  // namespace util
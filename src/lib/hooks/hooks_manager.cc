@@ -6,12 +6,15 @@
 
 #include <config.h>
 
+#include <cc/command_interpreter.h>
 #include <hooks/callout_handle.h>
 #include <hooks/callout_manager.h>
 #include <hooks/library_handle.h>
 #include <hooks/library_manager_collection.h>
 #include <hooks/hooks_manager.h>
 #include <hooks/server_hooks.h>
+#include <util/multi_threading_mgr.h>
+#include <util/recycling_allocator.h>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
@@ -19,6 +22,9 @@
 #include <string>
 #include <vector>
 
+using namespace isc::config;
+using namespace isc::data;
+using namespace isc::util;
 using namespace std;
 
 namespace isc {
@@ -196,7 +202,7 @@ HooksManager::prepareUnloadLibraries() {
 
 boost::shared_ptr<CalloutHandle>
 HooksManager::createCalloutHandleInternal() {
-    return (boost::make_shared<CalloutHandle>(callout_manager_, lm_collection_));
+    return (makeRecycled<CalloutHandle>(callout_manager_, lm_collection_));
 }
 
 boost::shared_ptr<CalloutHandle>
@@ -226,6 +232,87 @@ HooksManager::getLibraryInfo() {
     return (getHooksManager().getLibraryInfoInternal());
 }
 
+// Callout timing
+
+void
+HooksManager::setCalloutTimingInternal(bool enabled) {
+    // The histograms are created when the timing is enabled.
+    MultiThreadingCriticalSection cs;
+    callout_manager_->setTimingEnabled(enabled);
+}
+
+void
+HooksManager::setCalloutTiming(bool enabled) {
+    getHooksManager().setCalloutTimingInternal(enabled);
+}
+
+ElementPtr
+HooksManager::getCalloutTimingsInternal() const {
+    std::vector<std::string> names = lm_collection_->getLibraryNames();
+    ElementPtr timings = callout_manager_->getTimings();
+    for (auto const& timing : timings->listValue()) {
+        int index = timing->get("library-index")->intValue();
+        ElementPtr mutable_timing = boost::const_pointer_cast<Element>(timing);
+        if ((index > 0) && (index <= static_cast<int>(names.size()))) {
+            mutable_timing->set("library", Element::create(names[index - 1]));
+        } else {
+            mutable_timing->set("library", Element::create("server"));
+        }
+        mutable_timing->remove("library-index");
+    }
+    return (timings);
+}
+
+ElementPtr
+HooksManager::getCalloutTimings() {
+    return (getHooksManager().getCalloutTimingsInternal());
+}
+
+void
+HooksManager::resetCalloutTimingsInternal() {
+    callout_manager_->resetTimings();
+}
+
+void
+HooksManager::resetCalloutTimings() {
+    getHooksManager().resetCalloutTimingsInternal();
+}
+
+ConstElementPtr
+HooksManager::calloutTimingGetHandler(const std::string& /*name*/,
+                                      const ConstElementPtr& /*params*/) {
+    ElementPtr result = Element::createMap();
+    result->set("enabled", Element::create(CalloutManager::isTimingEnabled()));
+    result->set("timings", getCalloutTimings());
+    return (createAnswer(CONTROL_RESULT_SUCCESS, result));
+}
+
+ConstElementPtr
+HooksManager::calloutTimingSetHandler(const std::string& /*name*/,
+                                      const ConstElementPtr& params) {
+    if (!params || (params->getType() != Element::map)) {
+        return (createAnswer(CONTROL_RESULT_ERROR, "Missing mandatory 'enable' parameter."));
+    }
+    ConstElementPtr enable = params->get("enable");
+    if (!enable) {
+        return (createAnswer(CONTROL_RESULT_ERROR, "Missing mandatory 'enable' parameter."));
+    }
+    if (enable->getType() != Element::boolean) {
+        return (createAnswer(CONTROL_RESULT_ERROR, "'enable' parameter expected to be a boolean."));
+    }
+    setCalloutTiming(enable->boolValue());
+    return (createAnswer(CONTROL_RESULT_SUCCESS,
+                         enable->boolValue() ? "Callout timing enabled." :
+                         "Callout timing disabled."));
+}
+
+ConstElementPtr
+HooksManager::calloutTimingResetHandler(const std::string& /*name*/,
+                                        const ConstElementPtr& /*params*/) {
+    resetCalloutTimings();
+    return (createAnswer(CONTROL_RESULT_SUCCESS, "Callout timings reset."));
+}
+
 // Shell around ServerHooks::registerHook()
 
 int
@@ -7,6 +7,7 @@
 #ifndef HOOKS_MANAGER_H
 #define HOOKS_MANAGER_H
 
+#include <cc/data.h>
 #include <hooks/server_hooks.h>
 #include <hooks/libinfo.h>
 
@@ -239,6 +240,55 @@ public:
     /// @return List of loaded libraries (names + parameters)
     static HookLibsCollection getLibraryInfo();
 
+    /// @brief Enables or disables the callout timing.
+    ///
+    /// The execution time of the callouts is recorded per library and
+    /// hook point when enabled, see @ref CalloutManager::setTimingEnabled.
+    /// The packet processing threads are stopped while the setting is
+    /// changed.
+    ///
+    /// @param enabled true to enable the callout timing, false to disable it.
+    static void setCalloutTiming(bool enabled);
+
+    /// @brief Returns the callout timings.
+    ///
+    /// @return A list with a map per library and hook point, holding the
+    /// name of the library in "library" ("server" for the callouts
+    /// registered by the server), the hook point in "hook" and the
+    /// summary of the execution times in microseconds.
+    static isc::data::ElementPtr getCalloutTimings();
+
+    /// @brief Resets the callout timings.
+    static void resetCalloutTimings();
+
+    /// @brief Handles callout-timing-get command
+    ///
+    /// @param name name of the command (ignored, should be "callout-timing-get")
+    /// @param params parameters of the command (ignored)
+    /// @return answer with the "enabled" flag and the "timings" list.
+    static isc::data::ConstElementPtr
+    calloutTimingGetHandler(const std::string& name,
+                            const isc::data::ConstElementPtr& params);
+
+    /// @brief Handles callout-timing-set command
+    ///
+    /// @param name name of the command (ignored, should be "callout-timing-set")
+    /// @param params parameters of the command: a map with the mandatory
+    /// "enable" boolean.
+    /// @return answer indicating the outcome.
+    static isc::data::ConstElementPtr
+    calloutTimingSetHandler(const std::string& name,
+                            const isc::data::ConstElementPtr& params);
+
+    /// @brief Handles callout-timing-reset command
+    ///
+    /// @param name name of the command (ignored, should be "callout-timing-reset")
+    /// @param params parameters of the command (ignored)
+    /// @return answer indicating the outcome.
+    static isc::data::ConstElementPtr
+    calloutTimingResetHandler(const std::string& name,
+                              const isc::data::ConstElementPtr& params);
+
     /// @brief Validate library list
     ///
     /// For each library passed to it, checks that the library can be opened
@@ -469,6 +519,19 @@ private:
     /// @brief Return a collection of library names with parameters.
     HookLibsCollection getLibraryInfoInternal() const;
 
+    /// @brief Enables or disables the callout timing.
+    ///
+    /// @param enabled true to enable the callout timing, false to disable it.
+    void setCalloutTimingInternal(bool enabled);
+
+    /// @brief Returns the callout timings.
+    ///
+    /// @return A list with a map per library and hook point.
+    isc::data::ElementPtr getCalloutTimingsInternal() const;
+
+    /// @brief Resets the callout timings.
+    void resetCalloutTimingsInternal();
+
     //@}
 
     // Members
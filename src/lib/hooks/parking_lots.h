@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,14 +8,13 @@
 #define PARKING_LOTS_H
 
 #include <exceptions/exceptions.h>
-#include <boost/any.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <chrono>
 #include <functional>
 #include <iostream>
 #include <sstream>
-#include <list>
 #include <unordered_map>
 #include <mutex>
 #include <thread>
@@ -70,8 +69,21 @@ namespace hooks {
 /// functions are most often shared pointers. One should not use references
 /// to parked objects nor references to shared pointers to avoid premature
 /// destruction of the parked objects.
+///
+/// The parked objects are indexed by a hash table and the table is split
+/// into shards, each with its own mutex, so the packets parked by the
+/// different threads, e.g. while the HA hook library waits for the partner
+/// acknowledgements, seldom contend for the same lock. The objects given by
+/// shared pointers, i.e. the packets, are identified by their address.
 class ParkingLot {
 public:
+
+    /// @brief Number of shards of the parked objects.
+    static const size_t SHARDS = 16;
+
+    /// @brief Type of the durations of the wait time statistics.
+    typedef std::chrono::steady_clock::duration Duration;
+
     /// @brief Parks an object.
     ///
     /// @tparam Type of the parked object.
@@ -81,15 +93,18 @@ public:
     /// @throw InvalidOperation if this object has already been parked.
     template<typename T>
     void park(T parked_object, std::function<void()> unpark_callback) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = find(parked_object);
-        if (it != parking_.end()) {
+        std::string key = makeKey(parked_object);
+        Shard& shard = getShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        auto it = shard.parking_.find(key);
+        if (it != shard.parking_.end()) {
             isc_throw(InvalidOperation, "object is already parked!");
         }
 
         // Add the object to the parking lot. At this point refcount = 0.
-        ParkingInfo pinfo(parked_object, unpark_callback);
-        parking_[makeKey(parked_object)] = pinfo;
+        shard.parking_.emplace(key, ParkingInfo(hold(parked_object),
+                                                unpark_callback));
+        ++shard.parked_;
     }
 
     /// @brief Increases reference counter for the parked object.
@@ -103,9 +118,11 @@ public:
     /// @return the integer number of references for this object.
     template<typename T>
     int reference(T parked_object) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = find(parked_object);
-        if (it == parking_.end()) {
+        std::string key = makeKey(parked_object);
+        Shard& shard = getShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        auto it = shard.parking_.find(key);
+        if (it == shard.parking_.end()) {
             isc_throw(InvalidOperation, "cannot reference an object"
                       " that has not been parked.");
         }
@@ -124,9 +141,11 @@ public:
     /// @return the integer number of references for this object.
     template<typename T>
     int dereference(T parked_object) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = find(parked_object);
-        if (it == parking_.end()) {
+        std::string key = makeKey(parked_object);
+        Shard& shard = getShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        auto it = shard.parking_.find(key);
+        if (it == shard.parking_.end()) {
             isc_throw(InvalidOperation, "cannot dereference an object"
                       " that has not been parked.");
         }
@@ -150,12 +169,14 @@ public:
     /// no such object, true otherwise.
     template<typename T>
     bool unpark(T parked_object, bool force = false) {
+        std::string key = makeKey(parked_object);
+        Shard& shard = getShard(key);
         // Initialize as the empty function.
         std::function<void()> cb;
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto it = find(parked_object);
-            if (it == parking_.end()) {
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            auto it = shard.parking_.find(key);
+            if (it == shard.parking_.end()) {
                 // No such parked object.
                 return (false);
             }
@@ -169,7 +190,14 @@ public:
             if (it->second.refcount_ <= 0) {
                 // Unpark the packet and set the callback.
                 cb = it->second.unpark_callback_;
-                parking_.erase(it);
+                Duration wait = std::chrono::steady_clock::now() -
+                    it->second.parked_at_;
+                ++shard.unparked_;
+                shard.wait_time_ += wait;
+                if (wait > shard.max_wait_time_) {
+                    shard.max_wait_time_ = wait;
+                }
+                shard.parking_.erase(it);
             }
         }
 
@@ -193,22 +221,77 @@ public:
     /// no such object, true otherwise.
     template<typename T>
     bool drop(T parked_object) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = find(parked_object);
-        if (it != parking_.end()) {
-            // Parked object found.
-            parking_.erase(it);
-            return (true);
-        }
-
-        // No such object.
-        return (false);
+        std::string key = makeKey(parked_object);
+        Shard& shard = getShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        // Returns true when the parked object was found.
+        return (shard.parking_.erase(key) > 0);
     }
 
     /// @brief Returns the current number of objects.
     size_t size() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return (parking_.size());
+        size_t count = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            count += shard.parking_.size();
+        }
+        return (count);
+    }
+
+    /// @brief Removes all parked objects.
+    ///
+    /// It doesn't invoke callbacks associated with the removed objects.
+    void clear() {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            shard.parking_.clear();
+        }
+    }
+
+    /// @brief Returns the number of objects parked since the creation.
+    uint64_t getParkedTotal() {
+        uint64_t count = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            count += shard.parked_;
+        }
+        return (count);
+    }
+
+    /// @brief Returns the number of objects unparked since the creation.
+    ///
+    /// The dropped objects are not counted.
+    uint64_t getUnparkedTotal() {
+        uint64_t count = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            count += shard.unparked_;
+        }
+        return (count);
+    }
+
+    /// @brief Returns the total time the unparked objects were parked.
+    ///
+    /// Divided by @c getUnparkedTotal it gives the average wait time.
+    Duration getWaitTime() {
+        Duration wait = Duration::zero();
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            wait += shard.wait_time_;
+        }
+        return (wait);
+    }
+
+    /// @brief Returns the longest time an unparked object was parked.
+    Duration getMaxWaitTime() {
+        Duration wait = Duration::zero();
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            if (shard.max_wait_time_ > wait) {
+                wait = shard.max_wait_time_;
+            }
+        }
+        return (wait);
     }
 
 public:
@@ -216,7 +299,9 @@ public:
     /// @brief Holds information about parked object.
     struct ParkingInfo {
         /// @brief The parked object.
-        boost::any parked_object_;
+        ///
+        /// The object is only held to not be destroyed while parked.
+        boost::shared_ptr<const void> parked_object_;
 
         /// @brief The pointer to callback.
         std::function<void()> unpark_callback_;
@@ -224,6 +309,9 @@ public:
         /// @brief The current reference count.
         int refcount_;
 
+        /// @brief The time the object was parked.
+        std::chrono::steady_clock::time_point parked_at_;
+
         /// @brief Constructor.
         ///
         /// Default constructor.
@@ -233,16 +321,16 @@ public:
         ///
         /// @param parked_object object being parked.
         /// @param callback pointer to the callback.
-        ParkingInfo(const boost::any& parked_object,
+        ParkingInfo(const boost::shared_ptr<const void>& parked_object,
                     std::function<void()> callback = 0)
             : parked_object_(parked_object), unpark_callback_(callback),
-              refcount_(0) {}
+              refcount_(0), parked_at_(std::chrono::steady_clock::now()) {}
 
         /// @brief Update parking information.
         ///
         /// @param parked_object parked object.
         /// @param callback pointer to the callback.
-        void update(const boost::any& parked_object,
+        void update(const boost::shared_ptr<const void>& parked_object,
                     std::function<void()> callback) {
             parked_object_ = parked_object;
             unpark_callback_ = callback;
@@ -254,40 +342,93 @@ private:
     /// @brief Map which stores parked objects.
     typedef std::unordered_map<std::string, ParkingInfo> ParkingInfoList;
 
-    /// @brief Type of the iterator in the list of parked objects.
-    typedef ParkingInfoList::iterator ParkingInfoListIterator;
+    /// @brief A shard of the parked objects.
+    struct Shard {
+        /// @brief Constructor.
+        Shard() : parked_(0), unparked_(0), wait_time_(Duration::zero()),
+                  max_wait_time_(Duration::zero()) {
+        }
+
+        /// @brief The mutex protecting the shard.
+        std::mutex mutex_;
 
-    /// @brief Container holding parked objects for this parking lot.
-    ParkingInfoList parking_;
+        /// @brief Container holding parked objects of the shard.
+        ParkingInfoList parking_;
+
+        /// @brief Number of objects parked in the shard.
+        uint64_t parked_;
+
+        /// @brief Number of objects unparked from the shard.
+        uint64_t unparked_;
+
+        /// @brief Total wait time of the objects unparked from the shard.
+        Duration wait_time_;
+
+        /// @brief Longest wait time of an object unparked from the shard.
+        Duration max_wait_time_;
+    };
 
     /// @brief Construct the key for a given parked object.
     ///
+    /// The key of an object given by a shared pointer is the address of
+    /// the object, which is short enough to not allocate any memory.
+    ///
     /// @tparam T parked object type.
     /// @param parked_object object from which the key should be constructed.
     /// @return string containing the object's key.
     template<typename T>
-    std::string makeKey(T parked_object) {
+    static std::string makeKey(const boost::shared_ptr<T>& parked_object) {
+        const void* address = parked_object.get();
+        return (std::string(reinterpret_cast<const char*>(&address),
+                            sizeof(address)));
+    }
+
+    /// @brief Construct the key for a given parked object.
+    ///
+    /// @tparam T parked object type.
+    /// @param parked_object object from which the key should be constructed.
+    /// @return string containing the object's key.
+    template<typename T>
+    static std::string makeKey(const T& parked_object) {
         std::stringstream ss;
-        ss << boost::any_cast<T>(parked_object);
+        ss << parked_object;
         return (ss.str());
     }
 
-    /// @brief Search for the information about the parked object.
+    /// @brief Returns the holder of a parked object.
     ///
     /// @tparam T parked object type.
-    /// @param parked_object object for which to search.
-    /// @return Iterator pointing to the parked object, or @c parking_.end()
-    /// if no such object found.
+    /// @param parked_object the parked object given by a shared pointer.
+    /// @return the shared pointer.
     template<typename T>
-    ParkingInfoListIterator find(T parked_object) {
-        return (parking_.find(makeKey(parked_object)));
+    static boost::shared_ptr<const void>
+    hold(const boost::shared_ptr<T>& parked_object) {
+        return (parked_object);
     }
 
-    /// @brief The mutex to protect parking lot internal state.
+    /// @brief Returns the holder of a parked object.
+    ///
+    /// @tparam T parked object type.
+    /// @param parked_object the parked object given by value.
+    /// @return a shared pointer to a copy of the object.
+    template<typename T>
+    static boost::shared_ptr<const void> hold(const T& parked_object) {
+        return (boost::make_shared<T>(parked_object));
+    }
+
+    /// @brief Returns the shard of a key.
+    ///
+    /// @param key the key of a parked object.
+    /// @return the shard.
+    Shard& getShard(const std::string& key) {
+        return (shards_[std::hash<std::string>()(key) % SHARDS]);
+    }
+
+    /// @brief The shards of the parked objects.
     ///
     /// All public methods must enter of lock guard with the mutex
-    /// before any access to the @c parking_ member.
-    std::mutex mutex_;
+    /// of a shard before any access to its members.
+    Shard shards_[SHARDS];
 };
 
 /// @brief Type of the pointer to the parking lot.
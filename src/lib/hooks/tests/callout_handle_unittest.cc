@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -232,6 +232,50 @@ TEST_F(CalloutHandleTest, ContextItemNames) {
     EXPECT_TRUE(expected_names == actual_names);
 }
 
+// Check that each library has its own context, including the libraries
+// with an index beyond the ones known when the handle was created.
+
+TEST_F(CalloutHandleTest, ContextSlots) {
+    CalloutHandle handle(getCalloutManager());
+
+    // No library has a context yet.
+    int value = 0;
+    EXPECT_THROW(handle.getContext("item", value), NoSuchCalloutContext);
+    EXPECT_THROW(handle.getContextNames(), NoSuchCalloutContext);
+
+    // Set a context item for the "no current library" index, for each
+    // library and for an index larger than the number of libraries.
+    const int indexes[] = { -1, 0, 1, 2, 3, 4, 5, 10 };
+    for (auto const& index : indexes) {
+        handle.setCurrentLibrary(index);
+        handle.setContext("item", index * 10);
+    }
+
+    // Each library gets its own value back.
+    for (auto const& index : indexes) {
+        handle.setCurrentLibrary(index);
+        ASSERT_NO_THROW(handle.getContext("item", value));
+        EXPECT_EQ(index * 10, value);
+        EXPECT_EQ(1, handle.getContextNames().size());
+    }
+
+    // A library between the ones with a context has none.
+    handle.setCurrentLibrary(7);
+    EXPECT_THROW(handle.getContext("item", value), NoSuchCalloutContext);
+
+    // A deleted context still exists but is empty.
+    handle.setCurrentLibrary(2);
+    handle.deleteAllContext();
+    EXPECT_TRUE(handle.getContextNames().empty());
+    EXPECT_THROW(handle.getContext("item", value), NoSuchCalloutContext);
+
+    // Other libraries are not affected.
+    handle.setCurrentLibrary(3);
+    ASSERT_NO_THROW(handle.getContext("item", value));
+    EXPECT_EQ(30, value);
+    handle.setCurrentLibrary(-1);
+}
+
 // Test that we can delete an argument.
 
 TEST_F(CalloutHandleTest, DeleteArgument) {
@@ -301,6 +345,54 @@ TEST_F(CalloutHandleTest, DeleteAllArguments) {
     EXPECT_THROW(handle.getArgument("four", value), NoSuchArgument);
 }
 
+// Test that the deleted arguments release their values and can be set again
+// with values of the same or of different types.
+
+/// @brief Type without a default constructor.
+struct NoDefault {
+    explicit NoDefault(int value) : value_(value) {
+    }
+    int value_;
+};
+
+TEST_F(CalloutHandleTest, ReuseDeletedArguments) {
+    CalloutHandle handle(getCalloutManager());
+
+    boost::shared_ptr<int> one(new int(1));
+    handle.setArgument("one", one);
+    handle.setArgument("two", NoDefault(2));
+    EXPECT_EQ(2, one.use_count());
+    EXPECT_EQ(2, handle.getArgumentNames().size());
+
+    // The deleted arguments no longer reference their values.
+    handle.deleteAllArguments();
+    EXPECT_EQ(1, one.use_count());
+    EXPECT_TRUE(handle.getArgumentNames().empty());
+    boost::shared_ptr<int> value;
+    EXPECT_THROW(handle.getArgument("one", value), NoSuchArgument);
+    NoDefault no_default(0);
+    EXPECT_THROW(handle.getArgument("two", no_default), NoSuchArgument);
+
+    // The arguments can be set again.
+    handle.setArgument("one", one);
+    handle.setArgument("two", NoDefault(3));
+    ASSERT_NO_THROW(handle.getArgument("one", value));
+    EXPECT_EQ(one, value);
+    ASSERT_NO_THROW(handle.getArgument("two", no_default));
+    EXPECT_EQ(3, no_default.value_);
+    value.reset();
+
+    // Setting a value of another type replaces the previous one.
+    handle.deleteArgument("one");
+    handle.setArgument("one", string("one"));
+    EXPECT_EQ(1, one.use_count());
+    string text;
+    ASSERT_NO_THROW(handle.getArgument("one", text));
+    EXPECT_EQ("one", text);
+    EXPECT_THROW(handle.getArgument("one", value), boost::bad_any_cast);
+    EXPECT_EQ(2, handle.getArgumentNames().size());
+}
+
 // Test the "status" field.
 TEST_F(CalloutHandleTest, StatusField) {
     CalloutHandle handle(getCalloutManager());
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -870,6 +870,47 @@ TEST_F(CalloutManagerTest, VectorSize) {
 }
 
 
+// This test checks that the execution times of the callouts are recorded
+// per library and hook point when the timing is enabled.
+TEST_F(CalloutManagerTest, Timing) {
+    EXPECT_FALSE(CalloutManager::isTimingEnabled());
+    getCalloutManager()->registerCallout("alpha", callout_one, 1);
+    getCalloutManager()->callCallouts(alpha_index_, getCalloutHandle());
+    EXPECT_TRUE(getCalloutManager()->getTimings()->empty());
+
+    // Enabling the timing creates the histograms of the registered callouts
+    // and the callouts registered later get theirs at registration time.
+    getCalloutManager()->setTimingEnabled(true);
+    EXPECT_TRUE(CalloutManager::isTimingEnabled());
+    getCalloutManager()->registerCallout("alpha", callout_two, 1);
+    getCalloutManager()->registerCallout("beta", callout_three, 2);
+    getCalloutManager()->callCallouts(alpha_index_, getCalloutHandle());
+    getCalloutManager()->callCallouts(beta_index_, getCalloutHandle());
+    getCalloutManager()->callCallouts(beta_index_, getCalloutHandle());
+
+    isc::data::ConstElementPtr timings = getCalloutManager()->getTimings();
+    ASSERT_EQ(2, timings->size());
+    // Both callouts of the first library on alpha share a histogram.
+    EXPECT_EQ(1, timings->get(0)->get("library-index")->intValue());
+    EXPECT_EQ("alpha", timings->get(0)->get("hook")->stringValue());
+    EXPECT_EQ(2, timings->get(0)->get("count")->intValue());
+    EXPECT_EQ(2, timings->get(1)->get("library-index")->intValue());
+    EXPECT_EQ("beta", timings->get(1)->get("hook")->stringValue());
+    EXPECT_EQ(2, timings->get(1)->get("count")->intValue());
+    EXPECT_TRUE(timings->get(1)->get("total"));
+    EXPECT_TRUE(timings->get(1)->get("p50"));
+
+    getCalloutManager()->resetTimings();
+    timings = getCalloutManager()->getTimings();
+    ASSERT_EQ(2, timings->size());
+    EXPECT_EQ(0, timings->get(0)->get("count")->intValue());
+
+    getCalloutManager()->setTimingEnabled(false);
+    EXPECT_FALSE(CalloutManager::isTimingEnabled());
+    getCalloutManager()->callCallouts(alpha_index_, getCalloutHandle());
+    EXPECT_EQ(0, getCalloutManager()->getTimings()->get(0)->get("count")->intValue());
+}
+
 // The setting of the hook index is checked in the handles_unittest
 // set of tests, as access restrictions mean it is not easily tested
 // on its own.
@@ -13,6 +13,7 @@
 #include <hooks/tests/common_test_class.h>
 #define TEST_ASYNC_CALLOUT
 #include <hooks/tests/test_libraries.h>
+#include <cc/command_interpreter.h>
 #include <cc/data.h>
 
 #include <boost/shared_ptr.hpp>
@@ -487,6 +488,85 @@ TEST_F(HooksManagerTest, PrePostCalloutTest) {
     EXPECT_EQ(-15, result);
 }
 
+// Checks that the callout timing commands enable, report and reset the
+// execution times of the callouts.
+
+TEST_F(HooksManagerTest, CalloutTiming) {
+    HookLibsCollection library_names;
+    library_names.push_back(make_pair(std::string(FULL_CALLOUT_LIBRARY),
+                                      data::ConstElementPtr()));
+    EXPECT_TRUE(HooksManager::loadLibraries(library_names));
+    HooksManager::preCalloutsLibraryHandle().registerCallout("hookpt_two",
+                                                             testPreCallout);
+
+    // The enable parameter is mandatory.
+    int rcode = -1;
+    ConstElementPtr answer = HooksManager::calloutTimingSetHandler("callout-timing-set",
+                                                                   ConstElementPtr());
+    config::parseAnswer(rcode, answer);
+    EXPECT_EQ(config::CONTROL_RESULT_ERROR, rcode);
+    answer = HooksManager::calloutTimingSetHandler("callout-timing-set",
+                                                   Element::fromJSON("{ \"enable\": 1 }"));
+    config::parseAnswer(rcode, answer);
+    EXPECT_EQ(config::CONTROL_RESULT_ERROR, rcode);
+
+    // Nothing is recorded while the timing is disabled.
+    CalloutHandlePtr handle = HooksManager::createCalloutHandle();
+    handle->setArgument("result", static_cast<int>(0));
+    handle->setArgument("data_2", static_cast<int>(15));
+    HooksManager::callCallouts(hookpt_two_index_, *handle);
+    EXPECT_TRUE(HooksManager::getCalloutTimings()->empty());
+
+    answer = HooksManager::calloutTimingSetHandler("callout-timing-set",
+                                                   Element::fromJSON("{ \"enable\": true }"));
+    config::parseAnswer(rcode, answer);
+    EXPECT_EQ(config::CONTROL_RESULT_SUCCESS, rcode);
+    HooksManager::callCallouts(hookpt_two_index_, *handle);
+    HooksManager::callCallouts(hookpt_two_index_, *handle);
+
+    answer = HooksManager::calloutTimingGetHandler("callout-timing-get",
+                                                   ConstElementPtr());
+    ConstElementPtr result = config::parseAnswer(rcode, answer);
+    EXPECT_EQ(config::CONTROL_RESULT_SUCCESS, rcode);
+    ASSERT_TRUE(result);
+    ASSERT_TRUE(result->get("enabled"));
+    EXPECT_TRUE(result->get("enabled")->boolValue());
+    ConstElementPtr timings = result->get("timings");
+    ASSERT_TRUE(timings);
+    ASSERT_EQ(2, timings->size());
+    bool library_found = false;
+    bool server_found = false;
+    for (auto const& timing : timings->listValue()) {
+        EXPECT_EQ("hookpt_two", timing->get("hook")->stringValue());
+        EXPECT_EQ(2, timing->get("count")->intValue());
+        EXPECT_TRUE(timing->get("total"));
+        EXPECT_TRUE(timing->get("p99"));
+        EXPECT_FALSE(timing->get("library-index"));
+        if (timing->get("library")->stringValue() == FULL_CALLOUT_LIBRARY) {
+            library_found = true;
+        } else if (timing->get("library")->stringValue() == "server") {
+            server_found = true;
+        }
+    }
+    EXPECT_TRUE(library_found);
+    EXPECT_TRUE(server_found);
+
+    // The timings are kept when the timing is disabled and cleared by a reset.
+    HooksManager::setCalloutTiming(false);
+    HooksManager::callCallouts(hookpt_two_index_, *handle);
+    timings = HooksManager::getCalloutTimings();
+    ASSERT_EQ(2, timings->size());
+    EXPECT_EQ(2, timings->get(0)->get("count")->intValue());
+
+    answer = HooksManager::calloutTimingResetHandler("callout-timing-reset",
+                                                     ConstElementPtr());
+    config::parseAnswer(rcode, answer);
+    EXPECT_EQ(config::CONTROL_RESULT_SUCCESS, rcode);
+    timings = HooksManager::getCalloutTimings();
+    ASSERT_EQ(2, timings->size());
+    EXPECT_EQ(0, timings->get(0)->get("count")->intValue());
+}
+
 // Test with test mode enabled and the pre- and post- callout functions survive
 // a reload
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,6 +12,7 @@
 #include <testutils/gtest_utils.h>
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
 
 using namespace isc;
 using namespace isc::hooks;
@@ -222,6 +223,34 @@ TEST(ParkingLotsTest, clear) {
     EXPECT_TRUE(weak_parked_object.expired());
 }
 
+// Test that a parking lot can be cleared.
+TEST(ParkingLotsTest, clearParkingLot) {
+    ParkingLotPtr parking_lot = boost::make_shared<ParkingLot>();
+
+    StringPtr object_one(new std::string("one"));
+    StringPtr object_two(new std::string("two"));
+
+    // This counter will indicate if the callbacks have been called.
+    int unparked = 0;
+    ASSERT_NO_THROW(parking_lot->park(object_one, [&unparked] {
+        ++unparked;
+    }));
+    ASSERT_NO_THROW(parking_lot->park(object_two, [&unparked] {
+        ++unparked;
+    }));
+    EXPECT_EQ(2, parking_lot->size());
+
+    // Clear the parking lot. The callbacks should not be invoked.
+    ASSERT_NO_THROW(parking_lot->clear());
+    EXPECT_EQ(0, parking_lot->size());
+    EXPECT_EQ(0, unparked);
+
+    // The objects are no longer parked.
+    EXPECT_FALSE(parking_lot->unpark(object_one));
+    EXPECT_FALSE(parking_lot->drop(object_two));
+    EXPECT_EQ(0, unparked);
+}
+
 // Verify that an object can be dereferenced.
 TEST(ParkingLotsTest, dereference) {
     ParkingLotPtr parking_lot = boost::make_shared<ParkingLot>();
@@ -336,4 +365,60 @@ TEST(ParkingLotsTest, multipleObjects) {
     EXPECT_EQ(0, parking_lot->size());
 }
 
+// Test that many objects can be parked and unparked, and that they
+// are identified by their address rather than by their value.
+TEST(ParkingLotsTest, manyObjects) {
+    ParkingLotPtr parking_lot = boost::make_shared<ParkingLot>();
+
+    std::vector<StringPtr> objects;
+    int unparked = 0;
+    for (size_t i = 0; i < 10 * ParkingLot::SHARDS; ++i) {
+        // All the objects have the same value.
+        StringPtr object(new std::string("foo"));
+        ASSERT_NO_THROW(parking_lot->park(object, [&unparked] {
+            ++unparked;
+        }));
+        objects.push_back(object);
+    }
+    EXPECT_EQ(objects.size(), parking_lot->size());
+
+    for (auto const& object : objects) {
+        EXPECT_TRUE(parking_lot->unpark(object));
+    }
+    EXPECT_EQ(objects.size(), unparked);
+    EXPECT_EQ(0, parking_lot->size());
+}
+
+// Test the statistics of the parking lot.
+TEST(ParkingLotsTest, statistics) {
+    ParkingLotPtr parking_lot = boost::make_shared<ParkingLot>();
+    EXPECT_EQ(0, parking_lot->getParkedTotal());
+    EXPECT_EQ(0, parking_lot->getUnparkedTotal());
+    EXPECT_EQ(ParkingLot::Duration::zero(), parking_lot->getWaitTime());
+    EXPECT_EQ(ParkingLot::Duration::zero(), parking_lot->getMaxWaitTime());
+
+    StringPtr object_one(new std::string("one"));
+    StringPtr object_two(new std::string("two"));
+    ASSERT_NO_THROW(parking_lot->park(object_one, [] {}));
+    ASSERT_NO_THROW(parking_lot->park(object_two, [] {}));
+    EXPECT_EQ(2, parking_lot->getParkedTotal());
+    EXPECT_EQ(0, parking_lot->getUnparkedTotal());
+
+    // A dropped object is not unparked.
+    EXPECT_TRUE(parking_lot->drop(object_two));
+    EXPECT_EQ(0, parking_lot->getUnparkedTotal());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_TRUE(parking_lot->unpark(object_one));
+    EXPECT_EQ(2, parking_lot->getParkedTotal());
+    EXPECT_EQ(1, parking_lot->getUnparkedTotal());
+    EXPECT_GE(parking_lot->getWaitTime(), std::chrono::milliseconds(10));
+    EXPECT_EQ(parking_lot->getWaitTime(), parking_lot->getMaxWaitTime());
+
+    // Clearing the parking lot does not reset the statistics.
+    parking_lot->clear();
+    EXPECT_EQ(2, parking_lot->getParkedTotal());
+    EXPECT_EQ(1, parking_lot->getUnparkedTotal());
+}
+
 }
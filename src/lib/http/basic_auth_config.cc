@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,7 +9,8 @@
 #include <http/auth_log.h>
 #include <http/basic_auth_config.h>
 #include <util/file_utilities.h>
-#include <util/strutil.h>
+
+#include <strings.h>
 
 using namespace isc;
 using namespace isc::data;
@@ -20,6 +21,20 @@ using namespace std;
 namespace isc {
 namespace http {
 
+bool
+BasicHttpAuthCredentialEqual::operator()(const string& first,
+                                         const string& second) const {
+    if (first.size() != second.size()) {
+        return (false);
+    }
+    // Do not stop at the first difference.
+    unsigned char diff = 0;
+    for (size_t i = 0; i < first.size(); ++i) {
+        diff |= static_cast<unsigned char>(first[i] ^ second[i]);
+    }
+    return (diff == 0);
+}
+
 BasicHttpAuthClient::BasicHttpAuthClient(const std::string& user,
                                          const std::string& password,
                                          const isc::data::ConstElementPtr& user_context)
@@ -347,20 +362,23 @@ BasicHttpAuthConfig::checkAuth(const HttpResponseCreator& creator,
         authentic = true;
     } else try {
         string value = request->getHeaderValue("Authorization");
-        // Trim space characters.
-        value = str::trim(value);
-        if (value.size() < 8) {
+        // Locate the content without the space characters.
+        static const char* blanks = " \t\n";
+        size_t first = value.find_first_not_of(blanks);
+        size_t last = value.find_last_not_of(blanks);
+        if ((first == string::npos) || (last - first + 1 < 8)) {
             isc_throw(BadValue, "header content is too short");
         }
-        // Get the authentication scheme which must be "basic".
-        string scheme = value.substr(0, 5);
-        str::lowercase(scheme);
-        if (scheme != "basic") {
+        // Check the authentication scheme which must be "basic".
+        if (strncasecmp(value.c_str() + first, "basic", 5) != 0) {
             isc_throw(BadValue, "not basic authentication");
         }
-        // Skip the authentication scheme name and space characters.
-        value = value.substr(5);
-        value = str::trim(value);
+        // Skip the authentication scheme name and space characters. The
+        // content is at least 8 characters long and ends with a non-space
+        // one so the credential is not empty.
+        first = value.find_first_not_of(blanks, first + 5);
+        value.erase(last + 1);
+        value.erase(0, first);
         // Verify the credential is in the list.
         const auto it = credentials.find(value);
         if (it != credentials.end()) {
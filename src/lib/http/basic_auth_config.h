@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,12 +15,30 @@
 namespace isc {
 namespace http {
 
+/// @brief Constant time comparison of basic HTTP authentication credentials.
+///
+/// The comparison time depends only on the length of the credentials,
+/// not on the position of the first difference, so a client measuring
+/// the response time learns nothing about the configured credentials.
+struct BasicHttpAuthCredentialEqual {
+    /// @brief Compares two credentials.
+    ///
+    /// @param first The first credential.
+    /// @param second The second credential.
+    /// @return true if the credentials are equal, false otherwise.
+    bool operator()(const std::string& first, const std::string& second) const;
+};
+
 /// @brief Type of basic HTTP authentication credential and user id map,
 /// e.g. map["am9obmRvZTpzZWNyZXQx"] = "johndoe".
 ///
 /// The map is used to verify a received credential: if it is not in it
 /// the authentication fails, if it is in it the user id is logged.
-typedef std::unordered_map<std::string, std::string> BasicHttpAuthMap;
+/// The credentials are encoded once when the configuration is parsed
+/// so the verification is a lookup of the received header value.
+typedef std::unordered_map<std::string, std::string,
+                           std::hash<std::string>,
+                           BasicHttpAuthCredentialEqual> BasicHttpAuthMap;
 
 /// @brief Basic HTTP authentication client configuration.
 class BasicHttpAuthClient : public isc::data::UserContext,
@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -34,7 +34,7 @@ HttpConnection::Transaction::Transaction(const HttpResponseCreatorPtr& response_
     : request_(request ? request : response_creator->createNewHttpRequest()),
       parser_(new HttpRequestParser(*request_)),
       input_buf_(),
-      output_buf_() {
+      output_buf_(), output_buf_offset_(0) {
     parser_->initModel();
 }
 
@@ -79,7 +79,7 @@ HttpConnection::HttpConnection(asiolink::IOService& io_service,
       acceptor_(acceptor),
       connection_pool_(connection_pool),
       response_creator_(response_creator),
-      acceptor_callback_(callback) {
+      acceptor_callback_(callback), pending_input_() {
     if (!tls_context) {
         tcp_socket_.reset(new asiolink::TCPSocket<SocketCallback>(io_service));
     } else {
@@ -247,6 +247,19 @@ HttpConnection::doRead(TransactionPtr transaction) {
         if (!transaction) {
             transaction = Transaction::create(response_creator_);
             recordParameters(transaction->getRequest());
+
+            // Parse the pipelined data received with the previous request.
+            if (!pending_input_.empty()) {
+                std::string pending_input;
+                pending_input.swap(pending_input_);
+                transaction->getParser()->postBuffer(pending_input.data(),
+                                                     pending_input.size());
+                transaction->getParser()->poll();
+                if (!transaction->getParser()->needData()) {
+                    socketReadCallback(transaction, boost::system::error_code(), 0);
+                    return;
+                }
+            }
         }
 
         // Create instance of the callback. It is safe to pass the local instance
@@ -418,6 +431,12 @@ HttpConnection::socketReadCallback(HttpConnection::TransactionPtr transaction,
         doRead(transaction);
 
     } else {
+        // Keep the data following the request: they belong to the next
+        // request when the client pipelines its requests.
+        if (transaction->getParser()->httpParseOk()) {
+            pending_input_ = transaction->getParser()->getUnparsedData();
+        }
+
         try {
             // The whole message has been received, so let's finalize it.
             transaction->getRequest()->finalize();
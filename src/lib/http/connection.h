@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -183,31 +183,41 @@ protected:
         /// @return true if the output buffer contains data to be sent,
         /// false otherwise.
         bool outputDataAvail() const {
-            return (!output_buf_.empty());
+            return (output_buf_offset_ < output_buf_.size());
         }
 
-        /// @brief Returns pointer to the first byte of the output buffer.
+        /// @brief Returns pointer to the first byte of the output buffer
+        /// which hasn't been sent.
         const char* getOutputBufData() const {
-            return (output_buf_.data());
+            return (output_buf_.data() + output_buf_offset_);
         }
 
-        /// @brief Returns size of the output buffer.
+        /// @brief Returns size of the output buffer which hasn't been sent.
         size_t getOutputBufSize() const {
-            return (output_buf_.size());
+            return (output_buf_.size() - output_buf_offset_);
         }
 
         /// @brief Replaces output buffer contents with new contents.
         ///
         /// @param response New contents for the output buffer.
-        void setOutputBuf(const std::string& response) {
-            output_buf_ = response;
+        void setOutputBuf(std::string response) {
+            output_buf_.swap(response);
+            output_buf_offset_ = 0;
         }
 
-        /// @brief Erases n bytes from the beginning of the output buffer.
+        /// @brief Consumes n bytes from the beginning of the output buffer.
         ///
-        /// @param length Number of bytes to be erased.
+        /// The consumed bytes are skipped rather than erased so that sending
+        /// a large response doesn't move its remaining part after each
+        /// write. The buffer is released once it has been entirely consumed.
+        ///
+        /// @param length Number of bytes to be consumed.
         void consumeOutputBuf(const size_t length) {
-            output_buf_.erase(0, length);
+            output_buf_offset_ += length;
+            if (output_buf_offset_ >= output_buf_.size()) {
+                std::string().swap(output_buf_);
+                output_buf_offset_ = 0;
+            }
         }
 
     private:
@@ -223,6 +233,10 @@ protected:
 
         /// @brief Buffer used for outbound data.
         std::string output_buf_;
+
+        /// @brief Offset of the first byte of the output buffer which
+        /// hasn't been sent.
+        size_t output_buf_offset_;
     };
 
 public:
@@ -287,6 +301,9 @@ public:
     ///
     /// In case of error the connection is stopped.
     ///
+    /// When a new transaction is created the data received after the end
+    /// of the previous request, if any, are parsed first.
+    ///
     /// @param transaction Pointer to the transaction for which the read
     /// operation should be performed. It defaults to null pointer which
     /// indicates that this function should create new transaction.
@@ -424,6 +441,13 @@ protected:
 
     /// @brief External TCP acceptor callback.
     HttpAcceptorCallback acceptor_callback_;
+
+    /// @brief Data received after the end of the last request.
+    ///
+    /// A client pipelining its requests sends the next requests without
+    /// waiting for the responses: these data are parsed as the beginning
+    /// of the next request when the response has been sent.
+    std::string pending_input_;
 };
 
 } // end of namespace isc::http
@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -78,6 +78,14 @@ HttpMessageParserBase::getBufferAsString(const size_t limit) const {
     return (logFormatHttpMessage(message, limit));
 }
 
+std::string
+HttpMessageParserBase::getUnparsedData() const {
+    if (buffer_pos_ >= buffer_.size()) {
+        return (std::string());
+    }
+    return (buffer_.substr(buffer_pos_));
+}
+
 std::string
 HttpMessageParserBase::logFormatHttpMessage(const std::string& message,
                                             const size_t limit) {
@@ -154,9 +162,10 @@ HttpMessageParserBase::stateWithReadHandler(const std::string& handler_name,
 void
 HttpMessageParserBase::stateWithMultiReadHandler(const std::string& handler_name,
                                                  std::function<void(const std::string&)>
-                                                 after_read_logic) {
+                                                 after_read_logic,
+                                                 const size_t limit) {
     std::string bytes;
-    getNextFromBuffer(bytes, 0);
+    getNextFromBuffer(bytes, limit);
     // Do nothing if we reached the end of buffer.
     if (getNextEvent() != NEED_MORE_DATA_EVT) {
         switch(getNextEvent()) {
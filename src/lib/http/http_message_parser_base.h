@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -148,6 +148,15 @@ public:
     /// @return Textual representation of the input buffer.
     std::string getBufferAsString(const size_t limit = 0) const;
 
+    /// @brief Returns the data of the input buffer which were not parsed.
+    ///
+    /// The parser stops at the end of the message, so when the peer sends
+    /// several messages without waiting for the responses (pipelining) the
+    /// unparsed data are the beginning of the next messages.
+    ///
+    /// @return The unparsed data.
+    std::string getUnparsedData() const;
+
     /// @brief Formats provided HTTP message for logging.
     ///
     /// This method is useful in cases when there is a need to log a HTTP message
@@ -212,11 +221,14 @@ protected:
     /// method.
     /// @param after_read_logic Callback function to parse multiple bytes of
     /// data. This callback function implements state specific logic.
+    /// @param limit Maximum number of bytes to be read. If the limit is 0,
+    /// all the bytes of the buffer are read.
     ///
     /// @throw HttpRequestParserError when invalid event occurred.
     void stateWithMultiReadHandler(const std::string& handler_name,
                                    std::function<void(const std::string&)>
-                                   after_read_logic);
+                                   after_read_logic,
+                                   const size_t limit = 0);
 
     /// @brief Transition parser to failure state.
     ///
@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2018 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -210,23 +210,24 @@ HttpResponse::toBriefString() const {
 
 std::string
 HttpResponse::toString() const {
-
-    std::ostringstream s;
-    // HTTP version number and status code.
-    s << toBriefString() << crlf;
+    // Build the response in a string rather than in a stream to avoid
+    // extra copies of a large body.
+    const std::string body = getBody();
+    std::string s = toBriefString() + crlf;
 
     for (auto header_it = headers_.cbegin(); header_it != headers_.cend();
          ++header_it) {
-        s << header_it->second->getName() << ": " << header_it->second->getValue()
-          << crlf;
+        s += header_it->second->getName() + ": " +
+            header_it->second->getValue() + crlf;
     }
 
-    s << crlf;
+    s += crlf;
+    s.reserve(s.size() + body.size());
 
     // Include message body.
-    s << getBody();
+    s += body;
 
-    return (s.str());
+    return (s);
 }
 
 } // namespace http
@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -438,11 +438,17 @@ HttpResponseParser::headerValueHandler() {
 
 void
 HttpResponseParser::bodyHandler() {
-    stateWithMultiReadHandler("bodyHandler", [this](const std::string& body) {
+    // Do not read past the body: the next bytes belong to the next
+    // message when messages are pipelined.
+    size_t content_length = response_.getHeaderValueAsUint64("Content-Length");
+    size_t limit = 0;
+    if (context_->body_.length() < content_length) {
+        limit = content_length - context_->body_.length();
+    }
+    stateWithMultiReadHandler("bodyHandler", [this, content_length](const std::string& body) {
         // We don't validate the body at this stage. Simply record the
         // number of characters specified within "Content-Length".
         context_->body_ += body;
-        size_t content_length = response_.getHeaderValueAsUint64("Content-Length");
         if (context_->body_.length() < content_length) {
             transition(HTTP_BODY_ST, DATA_READ_OK_EVT);
 
@@ -453,7 +459,7 @@ HttpResponseParser::bodyHandler() {
             }
             transition(HTTP_PARSE_OK_ST, HTTP_PARSE_OK_EVT);
         }
-    });
+    }, limit);
 }
 
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -86,6 +86,17 @@ TEST(BasicHttpAuthClientTest, basicOneFile) {
     runToElementTest<BasicHttpAuthClient>(expected, client);
 }
 
+// Test that the credential comparison works as expected.
+TEST(BasicHttpAuthCredentialEqualTest, compare) {
+    BasicHttpAuthCredentialEqual equal;
+    EXPECT_TRUE(equal("", ""));
+    EXPECT_TRUE(equal("Zm9vOmJhcg==", "Zm9vOmJhcg=="));
+    EXPECT_FALSE(equal("Zm9vOmJhcg==", "Zm9vOmJhcg="));
+    EXPECT_FALSE(equal("Zm9vOmJhcg==", "Zm9vOmJhcG=="));
+    EXPECT_FALSE(equal("Zm9vOmJhcg==", "zm9vOmJhcg=="));
+    EXPECT_FALSE(equal("", "Zm9vOmJhcg=="));
+}
+
 // Test that basic auth configuration works as expected.
 TEST(BasicHttpAuthConfigTest, basic) {
     // Create a configuration.
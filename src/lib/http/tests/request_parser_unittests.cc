@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -172,6 +172,49 @@ TEST_F(HttpRequestParserTest, extraneousDataInRequest) {
 }
 
 
+// This test verifies that the parser stops at the end of the request so
+// the pipelined requests following it can be parsed.
+TEST_F(HttpRequestParserTest, pipelinedRequests) {
+    std::string preamble = "POST /foo/bar HTTP/1.1\r\n"
+        "Content-Type: application/json\r\n";
+    std::string json1 = "{ \"service\": \"dhcp4\", \"command\": \"shutdown\" }";
+    std::string json2 = "{ \"command\": \"list-commands\" }";
+    std::string http_req1 = createRequestString(preamble, json1);
+    std::string http_req2 = createRequestString(preamble, json2);
+    std::string http_req = http_req1 + http_req2;
+
+    PostHttpRequestJson request1;
+    HttpRequestParser parser1(request1);
+    ASSERT_NO_THROW(parser1.initModel());
+
+    // Feed the parser with the first request and a part of the second.
+    size_t split = http_req1.size() + http_req2.size() / 2;
+    parser1.postBuffer(&http_req[0], split);
+    ASSERT_NO_THROW(parser1.poll());
+    ASSERT_FALSE(parser1.needData());
+    ASSERT_TRUE(parser1.httpParseOk());
+    EXPECT_EQ(json1, request1.getBody());
+
+    // The part of the second request was not parsed.
+    std::string unparsed = parser1.getUnparsedData();
+    EXPECT_EQ(http_req.substr(http_req1.size(), split - http_req1.size()),
+              unparsed);
+
+    // Parse the second request.
+    PostHttpRequestJson request2;
+    HttpRequestParser parser2(request2);
+    ASSERT_NO_THROW(parser2.initModel());
+    parser2.postBuffer(&unparsed[0], unparsed.size());
+    ASSERT_NO_THROW(parser2.poll());
+    ASSERT_TRUE(parser2.needData());
+    parser2.postBuffer(&http_req[split], http_req.size() - split);
+    ASSERT_NO_THROW(parser2.poll());
+    ASSERT_FALSE(parser2.needData());
+    ASSERT_TRUE(parser2.httpParseOk());
+    EXPECT_EQ(json2, request2.getBody());
+    EXPECT_TRUE(parser2.getUnparsedData().empty());
+}
+
 // This test verifies that LWS is parsed correctly. The LWS marks line breaks
 // in the HTTP header values.
 TEST_F(HttpRequestParserTest, getLWS) {
@@ -388,6 +388,14 @@ public:
     }
 };
 
+/// @brief Implementation of the @c HttpConnection exposing its
+/// transactions.
+class HttpConnectionTransactions : public HttpConnection {
+public:
+    using HttpConnection::Transaction;
+    using HttpConnection::TransactionPtr;
+};
+
 /// @brief Pointer to the TestHttpClient.
 typedef boost::shared_ptr<TestHttpClient> TestHttpClientPtr;
 
@@ -995,6 +1003,56 @@ TEST_F(HttpListenerTest, transactionChangeDuringWrite) {
     testWriteBufferIssues<HttpConnectionTransactionChange>();
 }
 
+// This test verifies that the output buffer of a transaction is sent
+// in several parts and released once it has been entirely sent.
+TEST(HttpConnectionTransactionTest, partialSends) {
+    HttpResponseCreatorPtr creator(new TestHttpResponseCreator());
+    HttpConnectionTransactions::TransactionPtr transaction =
+        HttpConnectionTransactions::Transaction::create(creator);
+    EXPECT_FALSE(transaction->outputDataAvail());
+    EXPECT_EQ(0, transaction->getOutputBufSize());
+
+    // Use a response too large to be stored in the string object.
+    std::string response(1000, 'a');
+    response += std::string(1000, 'b');
+    transaction->setOutputBuf(response);
+    ASSERT_TRUE(transaction->outputDataAvail());
+    ASSERT_EQ(2000, transaction->getOutputBufSize());
+    const char* data = transaction->getOutputBufData();
+    EXPECT_EQ(response, std::string(data, 2000));
+
+    // The consumed data is skipped, not erased.
+    transaction->consumeOutputBuf(999);
+    ASSERT_TRUE(transaction->outputDataAvail());
+    EXPECT_EQ(1001, transaction->getOutputBufSize());
+    EXPECT_EQ(data + 999, transaction->getOutputBufData());
+    EXPECT_EQ("ab", std::string(transaction->getOutputBufData(), 2));
+
+    transaction->consumeOutputBuf(1000);
+    ASSERT_TRUE(transaction->outputDataAvail());
+    EXPECT_EQ(1, transaction->getOutputBufSize());
+    EXPECT_EQ(data + 1999, transaction->getOutputBufData());
+    EXPECT_EQ('b', *transaction->getOutputBufData());
+
+    // The buffer is released when all the data has been consumed: it no
+    // longer points to the response.
+    transaction->consumeOutputBuf(1);
+    EXPECT_FALSE(transaction->outputDataAvail());
+    EXPECT_EQ(0, transaction->getOutputBufSize());
+    EXPECT_NE(data, transaction->getOutputBufData());
+    EXPECT_NE(data + 2000, transaction->getOutputBufData());
+
+    // The next response is sent from its beginning, and consuming more
+    // than its length releases it.
+    transaction->setOutputBuf("next");
+    ASSERT_TRUE(transaction->outputDataAvail());
+    EXPECT_EQ("next", std::string(transaction->getOutputBufData(),
+                                  transaction->getOutputBufSize()));
+    transaction->consumeOutputBuf(5);
+    EXPECT_FALSE(transaction->outputDataAvail());
+    EXPECT_EQ(0, transaction->getOutputBufSize());
+}
+
 /// @brief Test fixture class for testing HTTP client.
 class HttpClientTest : public HttpListenerTest {
 public:
@@ -0,0 +1,301 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <log/async_log_sink.h>
+#include <log/log_messages.h>
+#include <log/logger_impl.h>
+#include <log/logger_manager.h>
+#include <log/logger_name.h>
+#include <log/macros.h>
+#include <log/interprocess/interprocess_sync_file.h>
+#include <log/interprocess/interprocess_sync_null.h>
+
+#include <log4cplus/loggingmacros.h>
+
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+namespace {
+
+// Logger used to report the dropped messages.
+isc::log::Logger logger("log");
+
+} // Anonymous namespace
+
+namespace isc {
+namespace log {
+
+AsyncLogSink::Entry::Entry(const log4cplus::Logger& logger,
+                           log4cplus::LogLevel level,
+                           const string& message,
+                           const DeferredMessagePtr& deferred) :
+    logger_(logger), event_(logger.getName(), level, message),
+    deferred_(deferred) {
+    // The thread name, the NDC and the MDC are lazily set by log4cplus when
+    // the layout asks for them, i.e. in the writer thread: get them now.
+    event_.gatherThreadSpecificData();
+}
+
+AsyncLogSink&
+AsyncLogSink::instance() {
+    static AsyncLogSink sink;
+    return (sink);
+}
+
+AsyncLogSink::AsyncLogSink() :
+    running_(false), stopping_(false), sleeping_(false), dropped_(0),
+    reported_(0), capacity_(0), generation_(0), flush_requested_(0),
+    flush_done_(0) {
+}
+
+AsyncLogSink::~AsyncLogSink() {
+    stop();
+}
+
+void
+AsyncLogSink::start(size_t capacity) {
+    if (running_) {
+        isc_throw(isc::InvalidOperation, "asynchronous logging is already"
+                  " running");
+    }
+    if (capacity == 0) {
+        isc_throw(isc::BadValue, "size of the asynchronous logging buffer"
+                  " must be greater than 0");
+    }
+
+    capacity_ = capacity;
+    if (lockfileEnabled()) {
+        sync_.reset(new interprocess::InterprocessSyncFile("logger"));
+    } else {
+        sync_.reset(new interprocess::InterprocessSyncNull("logger"));
+    }
+    dropped_ = 0;
+    reported_ = 0;
+    stopping_ = false;
+    {
+        lock_guard<mutex> lk(rings_mutex_);
+        rings_.clear();
+    }
+    // The threads still holding a ring of a previous run get a new one.
+    ++generation_;
+
+    thread_.reset(new thread(&AsyncLogSink::run, this));
+    running_ = true;
+}
+
+void
+AsyncLogSink::stop() {
+    if (!thread_) {
+        return;
+    }
+
+    // The messages logged from now are written synchronously.
+    running_ = false;
+    stopping_ = true;
+    {
+        lock_guard<mutex> lk(mutex_);
+        wake_cv_.notify_one();
+    }
+    thread_->join();
+    thread_.reset();
+}
+
+AsyncLogSink::Ring&
+AsyncLogSink::getLocalRing() {
+    static thread_local RingPtr ring;
+    static thread_local uint64_t generation = 0;
+
+    const uint64_t current = generation_;
+    if (!ring || (generation != current)) {
+        ring.reset(new Ring(capacity_));
+        generation = current;
+        lock_guard<mutex> lk(rings_mutex_);
+        rings_.push_back(ring);
+    }
+    return (*ring);
+}
+
+bool
+AsyncLogSink::push(const log4cplus::Logger& logger, log4cplus::LogLevel level,
+                   const string& message) {
+    if (!logger.isEnabledFor(level)) {
+        return (true);
+    }
+
+    EntryPtr entry(new Entry(logger, level, message));
+    return (push(entry));
+}
+
+bool
+AsyncLogSink::push(const log4cplus::Logger& logger, log4cplus::LogLevel level,
+                   const DeferredMessagePtr& message) {
+    if (!logger.isEnabledFor(level)) {
+        return (true);
+    }
+
+    EntryPtr entry(new Entry(logger, level, string(), message));
+    return (push(entry));
+}
+
+bool
+AsyncLogSink::push(EntryPtr& entry) {
+    bool queued = getLocalRing().push(entry);
+    if (!queued) {
+        ++dropped_;
+    }
+    notify();
+    return (queued);
+}
+
+void
+AsyncLogSink::flush() {
+    if (!running_) {
+        return;
+    }
+
+    unique_lock<mutex> lk(mutex_);
+    const uint64_t requested = ++flush_requested_;
+    wake_cv_.notify_one();
+    flushed_cv_.wait(lk, [this, requested]() {
+        return (flush_done_ >= requested);
+    });
+}
+
+void
+AsyncLogSink::notify() {
+    // Pairs with the fence in run(): either the writer thread sees the
+    // new message or this thread sees that the writer thread sleeps.
+    atomic_thread_fence(memory_order_seq_cst);
+    if (sleeping_) {
+        lock_guard<mutex> lk(mutex_);
+        wake_cv_.notify_one();
+    }
+}
+
+bool
+AsyncLogSink::allEmpty() {
+    lock_guard<mutex> lk(rings_mutex_);
+    for (auto const& ring : rings_) {
+        if (!ring->empty()) {
+            return (false);
+        }
+    }
+    return (true);
+}
+
+size_t
+AsyncLogSink::drain() {
+    vector<RingPtr> rings;
+    {
+        lock_guard<mutex> lk(rings_mutex_);
+        // The rings only referenced here belong to exited threads.
+        rings_.erase(remove_if(rings_.begin(), rings_.end(),
+                               [](const RingPtr& ring) {
+                                   return ((ring.use_count() == 1) &&
+                                           ring->empty());
+                               }),
+                     rings_.end());
+        for (auto const& ring : rings_) {
+            if (!ring->empty()) {
+                rings.push_back(ring);
+            }
+        }
+    }
+    if (rings.empty()) {
+        return (0);
+    }
+
+    // Take the locks once for the whole batch.
+    size_t count = 0;
+    lock_guard<mutex> mutex_locker(LoggerManager::getMutex());
+    interprocess::InterprocessSyncLocker locker(*sync_);
+    bool locked = locker.lock();
+    for (auto const& ring : rings) {
+        // A ring holds at most its capacity messages: all the messages
+        // queued before this pass are written and a busy thread can't
+        // delay the others.
+        EntryPtr entry;
+        for (size_t i = 0; (i < ring->getCapacity()) && ring->pop(entry); ++i) {
+            try {
+                if (entry->deferred_) {
+                    entry->event_.setMessage(entry->deferred_->toText());
+                }
+                entry->logger_.forcedLog(entry->event_);
+            } catch (...) {
+                // Nowhere to report it: the message is lost.
+            }
+            ++count;
+        }
+    }
+    if (locked) {
+        locker.unlock();
+    } else {
+        LOG4CPLUS_ERROR(log4cplus::Logger::getInstance(getRootLoggerName()),
+                        "Unable to lock logger lockfile");
+    }
+    return (count);
+}
+
+void
+AsyncLogSink::run() {
+    for (;;) {
+        uint64_t requested;
+        {
+            lock_guard<mutex> lk(mutex_);
+            requested = flush_requested_;
+        }
+
+        drain();
+
+        const uint64_t dropped = dropped_;
+        if (dropped > reported_) {
+            LOG_WARN(logger, LOG_ASYNC_MESSAGES_DROPPED).arg(dropped - reported_);
+            reported_ = dropped;
+        }
+
+        {
+            lock_guard<mutex> lk(mutex_);
+            if (flush_done_ < requested) {
+                flush_done_ = requested;
+                flushed_cv_.notify_all();
+            }
+            if (flush_done_ != flush_requested_) {
+                continue;
+            }
+        }
+
+        if (stopping_) {
+            if (allEmpty()) {
+                break;
+            }
+            continue;
+        }
+
+        // Wait for messages. The timeout is only a safety net.
+        sleeping_ = true;
+        atomic_thread_fence(memory_order_seq_cst);
+        {
+            unique_lock<mutex> lk(mutex_);
+            if (allEmpty() && !stopping_ &&
+                (flush_done_ == flush_requested_)) {
+                wake_cv_.wait_for(lk, chrono::milliseconds(100));
+            }
+        }
+        sleeping_ = false;
+    }
+
+    // Release the threads waiting in flush().
+    lock_guard<mutex> lk(mutex_);
+    flush_done_ = flush_requested_;
+    flushed_cv_.notify_all();
+}
+
+} // namespace log
+} // namespace isc
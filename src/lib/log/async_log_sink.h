@@ -0,0 +1,255 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef ASYNC_LOG_SINK_H
+#define ASYNC_LOG_SINK_H
+
+#include <log/log_formatter.h>
+#include <log/log_ring.h>
+#include <log/interprocess/interprocess_sync.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <log4cplus/logger.h>
+#include <log4cplus/spi/loggingevent.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace isc {
+namespace log {
+
+/// \brief Asynchronous Log Sink
+///
+/// By default each log message is written by the thread logging it, with
+/// the logger mutex and the interprocess lock file held: the threads wait
+/// for each other and for the outputs, which limits the throughput when
+/// many messages are logged (e.g. at the packet debug levels).
+///
+/// When the sink is running, the threads logging messages only create the
+/// log4cplus events (so the time stamp and the thread name are the ones
+/// of the logging thread) and push them to their own lock-free ring. A
+/// writer thread pops the events from all the rings and passes them to the
+/// configured appenders, taking the logger mutex and the lock file once
+/// per batch of messages.
+///
+/// The formatters created while the sink is running do not format the
+/// messages: they capture the arguments in a \c DeferredMessage which is
+/// rendered by the writer thread.
+///
+/// Logging never blocks: when the ring of a thread is full the message is
+/// dropped and counted. The writer thread reports the dropped messages
+/// with a warning.
+///
+/// The sink is a singleton: it is started by the logger manager when the
+/// KEA_LOGGER_ASYNC environment variable gives the size of the rings.
+class AsyncLogSink : public boost::noncopyable {
+public:
+
+    /// \brief Returns the sink
+    static AsyncLogSink& instance();
+
+    /// \brief Destructor
+    ///
+    /// Stops the sink.
+    ~AsyncLogSink();
+
+    /// \brief Starts the writer thread
+    ///
+    /// \param capacity Maximum number of messages held for each thread.
+    ///
+    /// \throw isc::BadValue if the capacity is 0.
+    /// \throw isc::InvalidOperation if the sink is already running.
+    void start(size_t capacity);
+
+    /// \brief Writes the pending messages and stops the writer thread
+    ///
+    /// Does nothing if the sink is not running. The messages logged after
+    /// this call are written synchronously.
+    void stop();
+
+    /// \brief Checks if the sink is running
+    bool isRunning() const {
+        return (running_);
+    }
+
+    /// \brief Queues a message
+    ///
+    /// Called by the logging thread instead of writing the message.
+    ///
+    /// \param logger The log4cplus logger of the message.
+    /// \param level The log4cplus level of the message.
+    /// \param message Text of the message.
+    ///
+    /// \return false if the message was dropped because the ring of the
+    /// calling thread is full.
+    bool push(const log4cplus::Logger& logger, log4cplus::LogLevel level,
+              const std::string& message);
+
+    /// \brief Queues a message which is not formatted yet
+    ///
+    /// The message is rendered by the writer thread.
+    ///
+    /// \param logger The log4cplus logger of the message.
+    /// \param level The log4cplus level of the message.
+    /// \param message The message with its arguments.
+    ///
+    /// \return false if the message was dropped because the ring of the
+    /// calling thread is full.
+    bool push(const log4cplus::Logger& logger, log4cplus::LogLevel level,
+              const DeferredMessagePtr& message);
+
+    /// \brief Waits for the messages queued before this call to be written
+    ///
+    /// Returns immediately if the sink is not running. Must not be called
+    /// by the writer thread.
+    void flush();
+
+    /// \brief Returns the number of dropped messages since the sink started
+    uint64_t getDroppedCount() const {
+        return (dropped_);
+    }
+
+    /// \brief Returns the maximum number of messages held for each thread
+    size_t getCapacity() const {
+        return (capacity_);
+    }
+
+private:
+
+    /// \brief The event passed to the appenders
+    ///
+    /// The text of a deferred message is set by the writer thread.
+    class Event : public log4cplus::spi::InternalLoggingEvent {
+    public:
+        /// \brief Constructor
+        Event(const log4cplus::tstring& logger, log4cplus::LogLevel level,
+              const log4cplus::tstring& message) :
+            log4cplus::spi::InternalLoggingEvent(logger, level, message,
+                                                 0, 0) {
+        }
+
+        /// \brief Sets the text of the message
+        void setMessage(const log4cplus::tstring& message) {
+            this->message = message;
+        }
+    };
+
+    /// \brief A queued message
+    struct Entry {
+        /// \brief Constructor
+        ///
+        /// Gathers the thread specific data of the event.
+        Entry(const log4cplus::Logger& logger, log4cplus::LogLevel level,
+              const std::string& message,
+              const DeferredMessagePtr& deferred = DeferredMessagePtr());
+
+        /// \brief The logger of the message
+        log4cplus::Logger logger_;
+
+        /// \brief The event passed to the appenders
+        Event event_;
+
+        /// \brief The message to render, null when already formatted
+        DeferredMessagePtr deferred_;
+    };
+
+    /// \brief Queues an entry
+    ///
+    /// \param entry The entry.
+    /// \return false if the entry was dropped.
+    bool push(std::unique_ptr<Entry>& entry);
+
+    /// \brief Pointer to a queued message
+    typedef std::unique_ptr<Entry> EntryPtr;
+
+    /// \brief Ring of queued messages of a thread
+    typedef LogRing<EntryPtr> Ring;
+
+    /// \brief Pointer to a ring of queued messages
+    typedef boost::shared_ptr<Ring> RingPtr;
+
+    /// \brief Constructor
+    AsyncLogSink();
+
+    /// \brief Returns the ring of the calling thread, creating it if needed
+    Ring& getLocalRing();
+
+    /// \brief The writer thread
+    void run();
+
+    /// \brief Writes the messages queued in all rings
+    ///
+    /// \return the number of written messages.
+    size_t drain();
+
+    /// \brief Checks if all rings are empty
+    bool allEmpty();
+
+    /// \brief Wakes up the writer thread if it waits for messages
+    void notify();
+
+    /// \brief Flag set when the sink is running
+    std::atomic<bool> running_;
+
+    /// \brief Flag set when the writer thread must exit
+    std::atomic<bool> stopping_;
+
+    /// \brief Flag set when the writer thread waits for messages
+    std::atomic<bool> sleeping_;
+
+    /// \brief Number of dropped messages
+    std::atomic<uint64_t> dropped_;
+
+    /// \brief Number of dropped messages already reported
+    uint64_t reported_;
+
+    /// \brief Maximum number of messages held for each thread
+    size_t capacity_;
+
+    /// \brief Incremented at each start so the threads get new rings
+    std::atomic<uint64_t> generation_;
+
+    /// \brief The rings of all threads
+    std::vector<RingPtr> rings_;
+
+    /// \brief Protects \c rings_
+    std::mutex rings_mutex_;
+
+    /// \brief Protects the flush counters and the waits
+    std::mutex mutex_;
+
+    /// \brief Wakes up the writer thread
+    std::condition_variable wake_cv_;
+
+    /// \brief Wakes up the threads waiting in \c flush
+    std::condition_variable flushed_cv_;
+
+    /// \brief Number of flush requests
+    uint64_t flush_requested_;
+
+    /// \brief Number of flush requests served by the writer thread
+    uint64_t flush_done_;
+
+    /// \brief Interprocess synchronization of the writer thread
+    boost::scoped_ptr<isc::log::interprocess::InterprocessSync> sync_;
+
+    /// \brief The writer thread
+    boost::scoped_ptr<std::thread> thread_;
+};
+
+} // namespace log
+} // namespace isc
+
+#endif // ASYNC_LOG_SINK_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -6,6 +6,7 @@
 
 #include <config.h>
 #include <log/log_formatter.h>
+#include <log/message_dictionary.h>
 
 #include <cassert>
 
@@ -64,5 +65,17 @@ checkExcessPlaceholders(std::string& message,
     }
 }
 
+string
+DeferredMessage::toText() const {
+    string message(string(ident_) + " " +
+                   MessageDictionary::globalDictionary()->getText(ident_));
+    unsigned placeholder = 0;
+    for (auto const& arg : args_) {
+        replacePlaceholder(message, arg.toText(), ++placeholder);
+    }
+    checkExcessPlaceholders(message, ++placeholder);
+    return (message);
+}
+
 } // namespace log
 } // namespace isc
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,11 +8,17 @@
 #define LOG_FORMATTER_H
 
 #include <cstddef>
+#include <cstring>
 #include <string>
 #include <iostream>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <exceptions/exceptions.h>
 #include <log/logger_level.h>
+#include <log/message_types.h>
 
 #include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
@@ -65,6 +71,126 @@ void
 replacePlaceholder(std::string& message, const std::string& replacement,
                    const unsigned placeholder);
 
+///
+/// \brief Captured argument of a deferred message
+///
+/// Holds either the text of an argument, or a copy of an arithmetic value
+/// which is converted to text only when the message is rendered.
+class FormatterArg {
+public:
+    /// \brief Checks if a value of the given type can be captured
+    template<class T> struct Capturable :
+        std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                               (sizeof(T) <= sizeof(uint64_t))> {
+    };
+
+    /// \brief Constructor from an arithmetic value
+    ///
+    /// \param value The value to capture.
+    template<class T>
+    explicit FormatterArg(const T& value,
+                          typename std::enable_if<Capturable<T>::value>::type* = 0) :
+        value_(0), render_(&renderValue<T>) {
+        std::memcpy(&value_, &value, sizeof(T));
+    }
+
+    /// \brief Constructor from a text
+    ///
+    /// \param text The text of the argument.
+    explicit FormatterArg(std::string&& text) :
+        text_(std::move(text)), value_(0), render_(0) {
+    }
+
+    /// \brief Returns the text of the argument
+    std::string toText() const {
+        return (render_ ? render_(value_) : text_);
+    }
+
+private:
+    /// \brief Converts a captured value to text
+    template<class T>
+    static std::string renderValue(uint64_t storage) {
+        T value;
+        std::memcpy(&value, &storage, sizeof(T));
+        return (boost::lexical_cast<std::string>(value));
+    }
+
+    /// \brief The text of the argument when it is not a captured value
+    std::string text_;
+
+    /// \brief The bytes of the captured value
+    uint64_t value_;
+
+    /// \brief The conversion of the captured value, null for a text
+    std::string (*render_)(uint64_t);
+};
+
+///
+/// \brief A log message with its arguments, rendered later
+///
+/// When the formatting is deferred the formatter does not look up the
+/// message text nor replace the placeholders: it only records the message
+/// identifier and captures the arguments. The message is rendered by
+/// \c toText, e.g. by the writer thread of the asynchronous sink, with the
+/// same result as the immediate formatting.
+class DeferredMessage {
+public:
+    /// \brief Constructor
+    ///
+    /// \param ident Identifier of the message.
+    explicit DeferredMessage(const MessageID& ident) : ident_(ident) {
+    }
+
+    /// \brief Captures an arithmetic value
+    ///
+    /// \param value The value to capture.
+    /// \return true: the value was captured.
+    template<class Arg>
+    typename std::enable_if<FormatterArg::Capturable<Arg>::value, bool>::type
+    capture(const Arg& value) {
+        args_.push_back(FormatterArg(value));
+        return (true);
+    }
+
+    /// \brief Does not capture a value which is not arithmetic
+    ///
+    /// \return false: the value must be converted to text by the caller.
+    template<class Arg>
+    typename std::enable_if<!FormatterArg::Capturable<Arg>::value, bool>::type
+    capture(const Arg&) {
+        return (false);
+    }
+
+    /// \brief Adds the text of an argument
+    ///
+    /// \param text The text of the argument.
+    void addText(std::string&& text) {
+        args_.push_back(FormatterArg(std::move(text)));
+    }
+
+    /// \brief Returns the number of arguments
+    size_t getArgCount() const {
+        return (args_.size());
+    }
+
+    /// \brief Renders the message
+    ///
+    /// Looks up the message text and replaces the placeholders.
+    ///
+    /// \return The text of the message.
+    std::string toText() const;
+
+private:
+    /// \brief Identifier of the message
+    MessageID ident_;
+
+    /// \brief The arguments
+    std::vector<FormatterArg> args_;
+};
+
+/// \brief Pointer to a deferred message
+typedef boost::shared_ptr<DeferredMessage> DeferredMessagePtr;
+
 ///
 /// \brief The log message formatter
 ///
@@ -102,6 +228,10 @@ replacePlaceholder(std::string& message, const std::string& replacement,
 /// destroyed before any call to .arg, producing an output, and then the one
 /// the .arg calls are called on would get destroyed as well, producing output
 /// again. So, think of this behavior as soul moving from one to another.
+///
+/// A formatter created with a \c DeferredMessage does no formatting: the
+/// arithmetic arguments are copied and the other ones converted to text,
+/// and the message is passed to the logger which renders it in its sink.
 template<class Logger> class Formatter {
 private:
     /// \brief The logger we will use to output the final message.
@@ -118,6 +248,8 @@ private:
     /// \brief Which will be the next placeholder to replace
     unsigned nextPlaceholder_;
 
+    /// \brief The deferred message, null when formatting immediately
+    DeferredMessagePtr deferred_;
 
 public:
     /// \brief Constructor of "active" formatter
@@ -141,6 +273,18 @@ public:
         nextPlaceholder_(0) {
     }
 
+    /// \brief Constructor of "active" deferred formatter
+    ///
+    /// \param severity The severity of the message (DEBUG, ERROR etc.)
+    /// \param deferred The message which will hold the arguments. Must
+    ///     not be NULL, but it's not checked.
+    /// \param logger The logger where the final output will go.
+    Formatter(const Severity& severity, const DeferredMessagePtr& deferred,
+              Logger* logger) :
+        logger_(logger), severity_(severity), nextPlaceholder_(0),
+        deferred_(deferred) {
+    }
+
     /// \brief Copy constructor
     ///
     /// "Control" is passed to the created object in that it is the created object
@@ -148,7 +292,8 @@ public:
     /// object being copied relinquishes that responsibility.
     Formatter(const Formatter& other) :
         logger_(other.logger_), severity_(other.severity_),
-        message_(other.message_), nextPlaceholder_(other.nextPlaceholder_) {
+        message_(other.message_), nextPlaceholder_(other.nextPlaceholder_),
+        deferred_(other.deferred_) {
         other.logger_ = NULL;
     }
 
@@ -158,6 +303,10 @@ public:
     ~Formatter() {
         if (logger_) {
             try {
+                if (deferred_) {
+                    logger_->output(severity_, deferred_);
+                    return;
+                }
                 checkExcessPlaceholders(*message_, ++nextPlaceholder_);
                 logger_->output(severity_, *message_);
             } catch (...) {
@@ -176,6 +325,7 @@ public:
             severity_ = other.severity_;
             message_ = other.message_;
             nextPlaceholder_ = other.nextPlaceholder_;
+            deferred_ = other.deferred_;
             other.logger_ = NULL;
         }
 
@@ -191,6 +341,9 @@ public:
     /// \param value The argument to place into the placeholder.
     template<class Arg> Formatter& arg(const Arg& value) {
         if (logger_) {
+            if (deferred_ && deferred_->capture(value)) {
+                return (*this);
+            }
             try {
                 return (arg(boost::lexical_cast<std::string>(value)));
             } catch (const boost::bad_lexical_cast& ex) {
@@ -217,6 +370,10 @@ public:
     ///
     /// \param arg The text to place into the placeholder.
     Formatter& arg(const std::string& arg) {
+        if (logger_ && deferred_) {
+            deferred_->addText(std::string(arg));
+            return (*this);
+        }
         if (logger_) {
             // Note that this method does a replacement and returns the
             // modified string. If there are multiple invocations of arg() (e.g.
@@ -241,6 +398,19 @@ public:
         return (*this);
     }
 
+    /// \brief Temporary string version of arg.
+    ///
+    /// Moves the text into a deferred message.
+    ///
+    /// \param arg The text to place into the placeholder.
+    Formatter& arg(std::string&& arg) {
+        if (logger_ && deferred_) {
+            deferred_->addText(std::move(arg));
+            return (*this);
+        }
+        return (this->arg(static_cast<const std::string&>(arg)));
+    }
+
     /// \brief Turn off the output of this logger.
     ///
     /// If the logger would output anything at the end, now it won't.
@@ -252,6 +422,7 @@ public:
     void deactivate() {
         if (logger_) {
             message_.reset();
+            deferred_.reset();
             logger_ = NULL;
         }
     }
@@ -0,0 +1,126 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <exceptions/exceptions.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace isc {
+namespace log {
+
+/// \brief Lock-free single producer single consumer ring buffer
+///
+/// The ring is used by the asynchronous logging: each thread logging
+/// messages pushes them to its own ring and the logging thread pops them.
+/// Neither side ever blocks: \c push returns false when the ring is full
+/// and \c pop returns false when it is empty.
+///
+/// Only one thread may call \c push and only one thread may call \c pop
+/// at a given time. The other methods may be called by any thread.
+///
+/// \tparam T The type of the elements. It must be default constructible
+/// and move assignable.
+template <typename T>
+class LogRing : public boost::noncopyable {
+public:
+
+    /// \brief Constructor
+    ///
+    /// \param capacity Maximum number of elements held by the ring. It is
+    /// rounded up to the next power of two.
+    ///
+    /// \throw isc::BadValue if the capacity is 0.
+    explicit LogRing(size_t capacity) {
+        head_.value_ = 0;
+        tail_.value_ = 0;
+        if (capacity == 0) {
+            isc_throw(isc::BadValue, "capacity of the log ring must be"
+                      " greater than 0");
+        }
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    /// \brief Appends an element (producer side)
+    ///
+    /// \param value The element, moved in the ring on success.
+    ///
+    /// \return true if the element was appended, false if the ring is full.
+    bool push(T& value) {
+        const size_t tail = tail_.value_.load(std::memory_order_relaxed);
+        if (tail - head_.value_.load(std::memory_order_acquire) > mask_) {
+            return (false);
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.value_.store(tail + 1, std::memory_order_release);
+        return (true);
+    }
+
+    /// \brief Removes the oldest element (consumer side)
+    ///
+    /// \param value Filled with the element on success.
+    ///
+    /// \return true if an element was removed, false if the ring is empty.
+    bool pop(T& value) {
+        const size_t head = head_.value_.load(std::memory_order_relaxed);
+        if (head == tail_.value_.load(std::memory_order_acquire)) {
+            return (false);
+        }
+        value = std::move(slots_[head & mask_]);
+        head_.value_.store(head + 1, std::memory_order_release);
+        return (true);
+    }
+
+    /// \brief Checks if the ring is empty
+    bool empty() const {
+        return (head_.value_.load(std::memory_order_acquire) ==
+                tail_.value_.load(std::memory_order_acquire));
+    }
+
+    /// \brief Returns the maximum number of elements held by the ring
+    size_t getCapacity() const {
+        return (mask_ + 1);
+    }
+
+private:
+    /// \brief Position in the ring, alone in its cache line
+    struct Position {
+        /// \brief The position
+        std::atomic<size_t> value_;
+
+        /// \brief Keeps the next position in a different cache line
+        char padding_[64 - sizeof(std::atomic<size_t>)];
+    };
+
+    /// \brief The elements
+    std::vector<T> slots_;
+
+    /// \brief Mask applied to the positions to get the slot index
+    size_t mask_;
+
+    /// \brief Position of the next element to pop, written by the consumer
+    Position head_;
+
+    /// \brief Position of the next element to push, written by the producer
+    Position tail_;
+};
+
+} // namespace log
+} // namespace isc
+
+#endif // LOG_RING_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,6 +9,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 
+#include <log/async_log_sink.h>
 #include <log/logger.h>
 #include <log/logger_impl.h>
 #include <log/logger_name.h>
@@ -147,11 +148,28 @@ Logger::output(const Severity& severity, const std::string& message) {
     getLoggerPtr()->outputRaw(severity, message);
 }
 
+void
+Logger::output(const Severity& severity, const DeferredMessagePtr& message) {
+    getLoggerPtr()->outputRaw(severity, message);
+}
+
+Logger::Formatter
+Logger::createFormatter(const Severity& severity, const MessageID& ident) {
+#ifndef ENABLE_LOGGER_CHECKS
+    // The placeholder checks throw when the arguments are given so they
+    // can't be deferred.
+    if (AsyncLogSink::instance().isRunning()) {
+        return (Formatter(severity, boost::make_shared<DeferredMessage>(ident),
+                          this));
+    }
+#endif
+    return (Formatter(severity, getLoggerPtr()->lookupMessage(ident), this));
+}
+
 Logger::Formatter
 Logger::debug(int dbglevel, const isc::log::MessageID& ident) {
     if (isDebugEnabled(dbglevel)) {
-        return (Formatter(DEBUG, getLoggerPtr()->lookupMessage(ident),
-                          this));
+        return (createFormatter(DEBUG, ident));
     } else {
         return (Formatter());
     }
@@ -160,8 +178,7 @@ Logger::debug(int dbglevel, const isc::log::MessageID& ident) {
 Logger::Formatter
 Logger::info(const isc::log::MessageID& ident) {
     if (isInfoEnabled()) {
-        return (Formatter(INFO, getLoggerPtr()->lookupMessage(ident),
-                          this));
+        return (createFormatter(INFO, ident));
     } else {
         return (Formatter());
     }
@@ -170,8 +187,7 @@ Logger::info(const isc::log::MessageID& ident) {
 Logger::Formatter
 Logger::warn(const isc::log::MessageID& ident) {
     if (isWarnEnabled()) {
-        return (Formatter(WARN, getLoggerPtr()->lookupMessage(ident),
-                          this));
+        return (createFormatter(WARN, ident));
     } else {
         return (Formatter());
     }
@@ -180,8 +196,7 @@ Logger::warn(const isc::log::MessageID& ident) {
 Logger::Formatter
 Logger::error(const isc::log::MessageID& ident) {
     if (isErrorEnabled()) {
-        return (Formatter(ERROR, getLoggerPtr()->lookupMessage(ident),
-                          this));
+        return (createFormatter(ERROR, ident));
     } else {
         return (Formatter());
     }
@@ -190,8 +205,7 @@ Logger::error(const isc::log::MessageID& ident) {
 Logger::Formatter
 Logger::fatal(const isc::log::MessageID& ident) {
     if (isFatalEnabled()) {
-        return (Formatter(FATAL, getLoggerPtr()->lookupMessage(ident),
-                          this));
+        return (createFormatter(FATAL, ident));
     } else {
         return (Formatter());
     }
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -320,6 +320,25 @@ private:
     /// \param message Text of the message to be output.
     void output(const Severity& severity, const std::string& message);
 
+    /// \brief Deferred output function
+    ///
+    /// This is used by the formatter to output a message which is not
+    /// formatted yet.
+    ///
+    /// \param severity Severity of the message being output.
+    /// \param message The message with its arguments.
+    void output(const Severity& severity, const DeferredMessagePtr& message);
+
+    /// \brief Creates an active formatter
+    ///
+    /// The formatting is deferred to the writer thread when the
+    /// asynchronous sink is running.
+    ///
+    /// \param severity Severity of the message.
+    /// \param ident Message identification.
+    Formatter createFormatter(const Severity& severity,
+                              const MessageID& ident);
+
     /// \brief Copy Constructor
     ///
     /// Disabled (marked private) as it makes no sense to copy the logger -
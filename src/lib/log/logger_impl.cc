@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -27,6 +27,7 @@
 #include <log4cplus/syslogappender.h>
 #include <log4cplus/version.h>
 
+#include <log/async_log_sink.h>
 #include <log/logger.h>
 #include <log/logger_impl.h>
 #include <log/logger_level.h>
@@ -46,14 +47,49 @@
 
 using namespace std;
 
+namespace {
+
+/// \brief Gets the log4cplus level used to queue a message
+///
+/// \param severity Severity of the message.
+/// \param level Set to the log4cplus level of the severity.
+///
+/// \return false if the message must not be queued to the asynchronous
+/// sink, i.e. for NONE or an unsupported severity.
+bool
+getSinkLevel(const isc::log::Severity& severity, log4cplus::LogLevel& level) {
+    switch (severity) {
+        case isc::log::DEBUG:
+            level = log4cplus::DEBUG_LOG_LEVEL;
+            return (true);
+
+        case isc::log::INFO:
+            level = log4cplus::INFO_LOG_LEVEL;
+            return (true);
+
+        case isc::log::WARN:
+            level = log4cplus::WARN_LOG_LEVEL;
+            return (true);
+
+        case isc::log::ERROR:
+            level = log4cplus::ERROR_LOG_LEVEL;
+            return (true);
+
+        case isc::log::FATAL:
+            level = log4cplus::FATAL_LOG_LEVEL;
+            return (true);
+
+        default:
+            return (false);
+    }
+}
+
+} // Anonymous namespace
+
 namespace isc {
 namespace log {
 
-/// @brief detects whether file locking is enabled or disabled
-///
-/// The lockfile is enabled by default. The only way to disable it is to
-/// set KEA_LOCKFILE_DIR variable to 'none'.
-/// @return true if lockfile is enabled, false otherwise
+// Detects whether file locking is enabled or disabled.
 bool lockfileEnabled() {
     const char* const env = getenv("KEA_LOCKFILE_DIR");
     if (env && boost::iequals(string(env), string("none"))) {
@@ -154,6 +190,18 @@ LoggerImpl::setInterprocessSync(interprocess::InterprocessSync* sync) {
 
 void
 LoggerImpl::outputRaw(const Severity& severity, const string& message) {
+    // When the asynchronous logging is running the message is written by
+    // its thread.
+    AsyncLogSink& sink = AsyncLogSink::instance();
+    if (sink.isRunning()) {
+        log4cplus::LogLevel level;
+        if (getSinkLevel(severity, level)) {
+            sink.push(logger_, level, message);
+            return;
+        }
+        // The other severities are handled below.
+    }
+
     // Use a mutex locker for mutual exclusion from other threads in
     // this process.
     std::lock_guard<std::mutex> mutex_locker(LoggerManager::getMutex());
@@ -201,6 +249,22 @@ LoggerImpl::outputRaw(const Severity& severity, const string& message) {
     }
 }
 
+void
+LoggerImpl::outputRaw(const Severity& severity,
+                      const DeferredMessagePtr& message) {
+    AsyncLogSink& sink = AsyncLogSink::instance();
+    if (sink.isRunning()) {
+        log4cplus::LogLevel level;
+        if (getSinkLevel(severity, level)) {
+            sink.push(logger_, level, message);
+            return;
+        }
+    }
+
+    // The sink was stopped after the formatter was created.
+    outputRaw(severity, message->toText());
+}
+
 bool
 LoggerImpl::hasAppender(OutputOption::Destination const destination) {
     // Get the appender for the name under which this logger is registered.
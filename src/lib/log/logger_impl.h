@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -23,6 +23,7 @@
 #include <log4cplus/logger.h>
 
 // Kea logger files
+#include <log/log_formatter.h>
 #include <log/logger_level_impl.h>
 #include <log/message_types.h>
 #include <log/interprocess/interprocess_sync.h>
@@ -31,6 +32,13 @@
 namespace isc {
 namespace log {
 
+/// \brief Detects whether file locking is enabled or disabled
+///
+/// The lockfile is enabled by default. The only way to disable it is to
+/// set KEA_LOCKFILE_DIR variable to 'none'.
+/// \return true if lockfile is enabled, false otherwise
+bool lockfileEnabled();
+
 /// \brief Console Logger Implementation
 ///
 /// The logger uses a "pimpl" idiom for implementation, where the base logger
@@ -162,6 +170,15 @@ public:
     /// \param message Text of the message.
     void outputRaw(const Severity& severity, const std::string& message);
 
+    /// \brief Deferred output
+    ///
+    /// Queues the message to the asynchronous sink which renders it, or
+    /// renders and writes it when the sink is not running.
+    ///
+    /// \param severity Severity of the message.
+    /// \param message The message with its arguments.
+    void outputRaw(const Severity& severity, const DeferredMessagePtr& message);
+
     /// \brief Look up message text in dictionary
     ///
     /// This gets you the unformatted text of message for given ID.
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,8 +7,13 @@
 #include <config.h>
 
 #include <algorithm>
+#include <cstdlib>
+#include <iostream>
 #include <vector>
 
+#include <boost/lexical_cast.hpp>
+
+#include <log/async_log_sink.h>
 #include <log/logger.h>
 #include <log/logger_manager.h>
 #include <log/logger_manager_impl.h>
@@ -78,6 +83,8 @@ LoggerManager::~LoggerManager() {
 // Initialize processing
 void
 LoggerManager::processInit() {
+    // The queued messages are written before the outputs are replaced.
+    AsyncLogSink::instance().flush();
     impl_->processInit();
 }
 
@@ -134,6 +141,24 @@ LoggerManager::init(const std::string& root, isc::log::Severity severity,
 
     // Ensure that the mutex is constructed and ready at this point.
     (void) getMutex();
+
+    // Start the asynchronous logging if the KEA_LOGGER_ASYNC environment
+    // variable gives the number of messages buffered for each thread.
+    const char* async = getenv("KEA_LOGGER_ASYNC");
+    if (async && !AsyncLogSink::instance().isRunning()) {
+        int capacity = 0;
+        try {
+            capacity = boost::lexical_cast<int>(async);
+        } catch (...) {
+            // Checked below.
+        }
+        if (capacity > 0) {
+            AsyncLogSink::instance().start(capacity);
+        } else {
+            std::cerr << "**ERROR** Unable to translate KEA_LOGGER_ASYNC"
+                         " - the messages will be written synchronously\n";
+        }
+    }
 }
 
 void
@@ -0,0 +1,237 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <gtest/gtest.h>
+
+#include <exceptions/exceptions.h>
+#include <log/async_log_sink.h>
+#include <log/message_dictionary.h>
+
+#include <log4cplus/appender.h>
+#include <log4cplus/logger.h>
+#include <log4cplus/spi/loggingevent.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace isc;
+using namespace isc::log;
+
+namespace {
+
+/// \brief Appender storing the messages
+///
+/// The appender can block the writer thread of the sink to fill the rings.
+class StoringAppender : public log4cplus::Appender {
+public:
+    /// \brief Constructor
+    StoringAppender() : block_(false), blocked_(false) {}
+
+    /// \brief Destructor
+    virtual ~StoringAppender() {
+        destructorImpl();
+    }
+
+    /// \brief Close the appender
+    virtual void close() {}
+
+    /// \brief Blocks the next append until \c release is called
+    void block() {
+        std::lock_guard<std::mutex> lk(mutex_);
+        block_ = true;
+    }
+
+    /// \brief Waits until an append is blocked
+    void waitBlocked() {
+        std::unique_lock<std::mutex> lk(mutex_);
+        cv_.wait(lk, [this]() { return (blocked_); });
+    }
+
+    /// \brief Releases the blocked append
+    void release() {
+        std::lock_guard<std::mutex> lk(mutex_);
+        block_ = false;
+        cv_.notify_all();
+    }
+
+    /// \brief Returns the stored messages
+    std::vector<std::string> getMessages() {
+        std::lock_guard<std::mutex> lk(mutex_);
+        return (messages_);
+    }
+
+protected:
+    virtual void append(const log4cplus::spi::InternalLoggingEvent& event) {
+        std::unique_lock<std::mutex> lk(mutex_);
+        messages_.push_back(event.getMessage());
+        if (block_) {
+            blocked_ = true;
+            cv_.notify_all();
+            cv_.wait(lk, [this]() { return (!block_); });
+            blocked_ = false;
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool block_;
+    bool blocked_;
+    std::vector<std::string> messages_;
+};
+
+/// \brief Test fixture for the asynchronous log sink
+class AsyncLogSinkTest : public ::testing::Test {
+protected:
+    /// \brief Constructor
+    ///
+    /// Sets a logger writing to the storing appender only.
+    AsyncLogSinkTest() : appender_(new StoringAppender()),
+                         shared_appender_(appender_),
+                         logger_(log4cplus::Logger::getInstance("asyncsink")) {
+        logger_.setLogLevel(log4cplus::TRACE_LOG_LEVEL);
+        logger_.setAdditivity(false);
+        logger_.addAppender(shared_appender_);
+    }
+
+    /// \brief Destructor
+    ///
+    /// Stops the sink.
+    ~AsyncLogSinkTest() {
+        appender_->release();
+        AsyncLogSink::instance().stop();
+        logger_.removeAllAppenders();
+    }
+
+    StoringAppender* appender_;
+    log4cplus::SharedAppenderPtr shared_appender_;
+    log4cplus::Logger logger_;
+};
+
+// Check the start and stop of the sink.
+TEST_F(AsyncLogSinkTest, startStop) {
+    AsyncLogSink& sink = AsyncLogSink::instance();
+    EXPECT_FALSE(sink.isRunning());
+    EXPECT_THROW(sink.start(0), isc::BadValue);
+    EXPECT_FALSE(sink.isRunning());
+
+    ASSERT_NO_THROW(sink.start(16));
+    EXPECT_TRUE(sink.isRunning());
+    EXPECT_EQ(16, sink.getCapacity());
+    EXPECT_THROW(sink.start(16), isc::InvalidOperation);
+
+    sink.stop();
+    EXPECT_FALSE(sink.isRunning());
+    // Stopping a stopped sink does nothing.
+    EXPECT_NO_THROW(sink.stop());
+    // Flushing a stopped sink does nothing.
+    EXPECT_NO_THROW(sink.flush());
+
+    // The sink can be restarted.
+    ASSERT_NO_THROW(sink.start(4));
+    EXPECT_EQ(4, sink.getCapacity());
+}
+
+// Check that the queued messages are written in order.
+TEST_F(AsyncLogSinkTest, write) {
+    AsyncLogSink& sink = AsyncLogSink::instance();
+    ASSERT_NO_THROW(sink.start(8));
+
+    EXPECT_TRUE(sink.push(logger_, log4cplus::INFO_LOG_LEVEL, "first"));
+    EXPECT_TRUE(sink.push(logger_, log4cplus::WARN_LOG_LEVEL, "second"));
+    sink.flush();
+    std::vector<std::string> messages = appender_->getMessages();
+    ASSERT_EQ(2, messages.size());
+    EXPECT_EQ("first", messages[0]);
+    EXPECT_EQ("second", messages[1]);
+
+    // The messages below the level of the logger are ignored.
+    logger_.setLogLevel(log4cplus::WARN_LOG_LEVEL);
+    EXPECT_TRUE(sink.push(logger_, log4cplus::INFO_LOG_LEVEL, "ignored"));
+
+    // Stopping writes the pending messages.
+    EXPECT_TRUE(sink.push(logger_, log4cplus::ERROR_LOG_LEVEL, "third"));
+    sink.stop();
+    messages = appender_->getMessages();
+    ASSERT_EQ(3, messages.size());
+    EXPECT_EQ("third", messages[2]);
+    EXPECT_EQ(0, sink.getDroppedCount());
+}
+
+// Check that the messages are dropped and counted when the ring of the
+// logging thread is full.
+TEST_F(AsyncLogSinkTest, drop) {
+    AsyncLogSink& sink = AsyncLogSink::instance();
+    ASSERT_NO_THROW(sink.start(8));
+
+    // Block the writer thread in the appender.
+    appender_->block();
+    EXPECT_TRUE(sink.push(logger_, log4cplus::INFO_LOG_LEVEL, "blocking"));
+    appender_->waitBlocked();
+
+    // Fill the ring, the following messages are dropped.
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(sink.push(logger_, log4cplus::INFO_LOG_LEVEL, "queued"));
+    }
+    EXPECT_FALSE(sink.push(logger_, log4cplus::INFO_LOG_LEVEL, "dropped"));
+    EXPECT_FALSE(sink.push(logger_, log4cplus::INFO_LOG_LEVEL, "dropped"));
+    EXPECT_EQ(2, sink.getDroppedCount());
+
+    appender_->release();
+    sink.flush();
+    std::vector<std::string> messages = appender_->getMessages();
+    ASSERT_EQ(9, messages.size());
+    for (auto const& message : messages) {
+        EXPECT_NE("dropped", message);
+    }
+}
+
+// Check that the messages of several threads are all written.
+TEST_F(AsyncLogSinkTest, threads) {
+    AsyncLogSink& sink = AsyncLogSink::instance();
+    ASSERT_NO_THROW(sink.start(1024));
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.push_back(std::thread([this, &sink]() {
+            for (int j = 0; j < 100; ++j) {
+                sink.push(logger_, log4cplus::INFO_LOG_LEVEL, "message");
+            }
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    sink.flush();
+    EXPECT_EQ(400, appender_->getMessages().size());
+    EXPECT_EQ(0, sink.getDroppedCount());
+}
+
+// Check that the deferred messages are rendered by the writer thread.
+TEST_F(AsyncLogSinkTest, deferred) {
+    AsyncLogSink& sink = AsyncLogSink::instance();
+    ASSERT_NO_THROW(sink.start(8));
+
+    const char* ident = "ASYNC_SINK_TEST_DEFERRED";
+    MessageDictionary::globalDictionary()->add(ident, "%1 of %2");
+    DeferredMessagePtr message(new DeferredMessage(ident));
+    EXPECT_TRUE(message->capture(4));
+    message->addText("text");
+    EXPECT_TRUE(sink.push(logger_, log4cplus::INFO_LOG_LEVEL, message));
+    sink.flush();
+    MessageDictionary::globalDictionary()->erase(ident, "%1 of %2");
+
+    std::vector<std::string> messages = appender_->getMessages();
+    ASSERT_EQ(1, messages.size());
+    EXPECT_EQ("ASYNC_SINK_TEST_DEFERRED 4 of text", messages[0]);
+}
+
+} // end of anonymous namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,6 +12,7 @@
 
 #include <log/log_formatter.h>
 #include <log/logger_level.h>
+#include <log/message_dictionary.h>
 
 #include <vector>
 #include <string>
@@ -29,6 +30,13 @@ public:
     void output(const isc::log::Severity& prefix, const string& message) {
         outputs.push_back(Output(prefix, message));
     }
+    // Deferred messages are kept to be rendered by the test
+    void output(const isc::log::Severity& prefix,
+                const isc::log::DeferredMessagePtr& message) {
+        deferred.push_back(message);
+        outputs.push_back(Output(prefix, string()));
+    }
+    vector<isc::log::DeferredMessagePtr> deferred;
     // Just shortcut for new string
     boost::shared_ptr<string> s(const char* text) {
         return (boost::make_shared<string>(text));
@@ -178,4 +186,56 @@ TEST_F(FormatterTest, noRecurse) {
     EXPECT_EQ("%1 %1", outputs[0].second);
 }
 
+// Check the arguments of a deferred message are captured and rendered
+// as by the immediate formatting
+TEST_F(FormatterTest, deferred) {
+    const char* ident = "FORMATTER_TEST_DEFERRED";
+    isc::log::MessageDictionary::globalDictionary()->
+        add(ident, "The %2 are %1, %3 %4 %5");
+    string name("switches");
+    Formatter(isc::log::INFO,
+              boost::make_shared<isc::log::DeferredMessage>(ident), this).
+        arg("switched").arg(name).arg(42).arg(2.5).arg(string("off"));
+    isc::log::MessageDictionary::globalDictionary()->
+        erase(ident, "The %2 are %1, %3 %4 %5");
+
+    ASSERT_EQ(1, outputs.size());
+    EXPECT_EQ(isc::log::INFO, outputs[0].first);
+    ASSERT_EQ(1, deferred.size());
+    EXPECT_EQ(5, deferred[0]->getArgCount());
+
+    Formatter(isc::log::INFO, s("FORMATTER_TEST_DEFERRED The %2 are %1, %3 %4 %5"),
+              this).arg("switched").arg(name).arg(42).arg(2.5).arg("off");
+    ASSERT_EQ(2, outputs.size());
+    EXPECT_EQ("FORMATTER_TEST_DEFERRED The switches are switched, 42 2.5 off",
+              outputs[1].second);
+
+    // The message text is looked up at rendering.
+    isc::log::MessageDictionary::globalDictionary()->
+        add(ident, "The %2 are %1, %3 %4 %5");
+    EXPECT_EQ(outputs[1].second, deferred[0]->toText());
+    isc::log::MessageDictionary::globalDictionary()->
+        erase(ident, "The %2 are %1, %3 %4 %5");
+}
+
+// Check the arithmetic arguments keep their value
+TEST_F(FormatterTest, deferredValues) {
+    const char* ident = "FORMATTER_TEST_VALUES";
+    isc::log::MessageDictionary::globalDictionary()->
+        add(ident, "%1 %2 %3 %4 %5");
+    isc::log::DeferredMessage message(ident);
+    EXPECT_TRUE(message.capture(-1));
+    EXPECT_TRUE(message.capture(static_cast<uint64_t>(0xffffffffffffffffULL)));
+    EXPECT_TRUE(message.capture(true));
+    EXPECT_TRUE(message.capture('x'));
+    EXPECT_TRUE(message.capture(0.1));
+    EXPECT_FALSE(message.capture(string("text")));
+    EXPECT_FALSE(message.capture("text"));
+    EXPECT_EQ(5, message.getArgCount());
+    EXPECT_EQ("FORMATTER_TEST_VALUES -1 18446744073709551615 1 x " +
+              boost::lexical_cast<string>(0.1), message.toText());
+    isc::log::MessageDictionary::globalDictionary()->
+        erase(ident, "%1 %2 %3 %4 %5");
+}
+
 }
@@ -0,0 +1,112 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <gtest/gtest.h>
+
+#include <log/log_ring.h>
+
+#include <memory>
+#include <thread>
+
+using namespace isc;
+using namespace isc::log;
+
+namespace {
+
+// Check that the capacity is rounded up to a power of two.
+TEST(LogRingTest, capacity) {
+    EXPECT_THROW(LogRing<int>(0), isc::BadValue);
+    EXPECT_EQ(1, LogRing<int>(1).getCapacity());
+    EXPECT_EQ(8, LogRing<int>(5).getCapacity());
+    EXPECT_EQ(8, LogRing<int>(8).getCapacity());
+}
+
+// Check that the elements are popped in order and that a full ring
+// rejects new elements.
+TEST(LogRingTest, pushPop) {
+    LogRing<int> ring(4);
+    EXPECT_TRUE(ring.empty());
+    int value = 0;
+    EXPECT_FALSE(ring.pop(value));
+
+    for (int i = 1; i <= 4; ++i) {
+        value = i;
+        EXPECT_TRUE(ring.push(value));
+    }
+    EXPECT_FALSE(ring.empty());
+    value = 5;
+    EXPECT_FALSE(ring.push(value));
+
+    for (int i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(ring.pop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_TRUE(ring.empty());
+    EXPECT_FALSE(ring.pop(value));
+
+    // The positions wrap around.
+    for (int i = 0; i < 10; ++i) {
+        value = i;
+        ASSERT_TRUE(ring.push(value));
+        ASSERT_TRUE(ring.pop(value));
+        EXPECT_EQ(i, value);
+    }
+}
+
+// Check that the elements are moved in and out of the ring.
+TEST(LogRingTest, move) {
+    LogRing<std::unique_ptr<int> > ring(2);
+    std::unique_ptr<int> value(new int(1));
+    ASSERT_TRUE(ring.push(value));
+    EXPECT_FALSE(value);
+
+    value.reset(new int(2));
+    ASSERT_TRUE(ring.push(value));
+    value.reset(new int(3));
+    // A rejected element is left untouched.
+    EXPECT_FALSE(ring.push(value));
+    ASSERT_TRUE(value);
+    EXPECT_EQ(3, *value);
+
+    ASSERT_TRUE(ring.pop(value));
+    ASSERT_TRUE(value);
+    EXPECT_EQ(1, *value);
+}
+
+// Check that a producer and a consumer running in different threads
+// exchange all elements in order.
+TEST(LogRingTest, threads) {
+    const int count = 100000;
+    LogRing<int> ring(16);
+    std::thread producer([&ring, count]() {
+        for (int i = 0; i < count; ++i) {
+            int value = i;
+            while (!ring.push(value)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int popped = 0;
+    int unordered = 0;
+    while (popped < count) {
+        int value;
+        if (!ring.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (value != popped) {
+            ++unordered;
+        }
+        ++popped;
+    }
+    producer.join();
+    EXPECT_EQ(0, unordered);
+    EXPECT_TRUE(ring.empty());
+}
+
+} // end of anonymous namespace
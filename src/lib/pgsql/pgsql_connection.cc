@@ -157,6 +157,24 @@ PgSqlConnection::getVersion(const ParameterMap& parameters) {
     return (make_pair(version, minor));
 }
 
+int64_t
+PgSqlConnection::getReplicationLag() {
+    const char* lag_sql =
+        "SELECT CASE WHEN NOT pg_is_in_recovery() OR "
+        "  pg_last_wal_receive_lsn() = pg_last_wal_replay_lsn() THEN 0 "
+        "  ELSE COALESCE(CEIL(EXTRACT(EPOCH FROM "
+        "    now() - pg_last_xact_replay_timestamp())), -1) END::BIGINT;";
+    PgSqlResult r(PQexec(conn_, lag_sql));
+    if (PQresultStatus(r) != PGRES_TUPLES_OK) {
+        isc_throw(DbOperationError, "unable to execute PostgreSQL statement <"
+                  << lag_sql << ", reason: " << PQerrorMessage(conn_));
+    }
+
+    int64_t lag;
+    PgSqlExchange::getColumnValue(r, 0, 0, lag);
+    return (lag);
+}
+
 void
 PgSqlConnection::prepareStatement(const PgSqlTaggedStatement& statement) {
     // Prepare all statements queries with all known fields datatype
@@ -314,6 +332,13 @@ PgSqlConnection::checkStatementError(const PgSqlResult& r,
                                      PgSqlTaggedStatement& statement) {
     int s = PQresultStatus(r);
     if (s != PGRES_COMMAND_OK && s != PGRES_TUPLES_OK) {
+        // Prefer the error of the result as the connection may be shared
+        // by several statements in pipeline mode.
+        const char* error_message = PQresultErrorMessage(r);
+        if (!error_message || !*error_message) {
+            error_message = PQerrorMessage(conn_);
+        }
+
         // We're testing the first two chars of SQLSTATE, as this is the
         // error class. Note, there is a severity field, but it can be
         // misleadingly returned as fatal. However, a loss of connectivity
@@ -327,7 +352,7 @@ PgSqlConnection::checkStatementError(const PgSqlResult& r,
              (memcmp(sqlstate, "58", 2) == 0))) { // System error
             DB_LOG_ERROR(PGSQL_FATAL_ERROR)
                 .arg(statement.name)
-                .arg(PQerrorMessage(conn_))
+                .arg(error_message)
                 .arg(sqlstate ? sqlstate : "<sqlstate null>");
 
             // Mark this connection as no longer usable.
@@ -345,17 +370,16 @@ PgSqlConnection::checkStatementError(const PgSqlResult& r,
         // Failure: check for the special case of duplicate entry.
         if (compareError(r, PgSqlConnection::DUPLICATE_KEY)) {
             isc_throw(DuplicateEntry, "statement: " << statement.name
-                      << ", reason: " << PQerrorMessage(conn_));
+                      << ", reason: " << error_message);
         }
 
         // Failure: check for the special case of null key violation.
         if (compareError(r, PgSqlConnection::NULL_KEY)) {
             isc_throw(NullKeyError, "statement: " << statement.name
-                      << ", reason: " << PQerrorMessage(conn_));
+                      << ", reason: " << error_message);
         }
 
         // Apparently it wasn't fatal, so we throw with a helpful message.
-        const char* error_message = PQerrorMessage(conn_);
         isc_throw(DbOperationError, "Statement exec failed for: "
                   << statement.name << ", status: " << s
                   << "sqlstate:[ " << (sqlstate ? sqlstate : "<null>")
@@ -239,6 +239,19 @@ public:
     static std::pair<uint32_t, uint32_t>
     getVersion(const ParameterMap& parameters);
 
+    /// @brief Get the replication lag.
+    ///
+    /// Returns the time since the last transaction replayed by a hot
+    /// standby server, 0 when the standby has replayed all the received
+    /// changes or when the server is not a standby.
+    ///
+    /// @return The replication lag in seconds or -1 when the standby has
+    /// not replayed any transaction yet.
+    ///
+    /// @throw isc::db::DbOperationError An operation on the open database has
+    ///        failed.
+    int64_t getReplicationLag();
+
     /// @brief Prepare Single Statement
     ///
     /// Creates a prepared statement from the text given and adds it to the
@@ -0,0 +1,264 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <database/db_exceptions.h>
+#include <exceptions/exceptions.h>
+#include <pgsql/pgsql_pipeline.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <poll.h>
+
+namespace {
+
+/// @brief Maximum time in milliseconds the reader waits for the socket
+/// before checking the results again.
+const int POLL_TIMEOUT = 100;
+
+}
+
+namespace isc {
+namespace db {
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+PgSqlPipeline::PgSqlPipeline(PgSqlConnection& conn)
+    : conn_(conn), pending_(), reading_(false) {
+    if (PQenterPipelineMode(conn_) != 1) {
+        isc_throw(DbOperationError, "unable to enter the pipeline mode: "
+                  << PQerrorMessage(conn_));
+    }
+    // Sending must not block while the server is sending results.
+    if (PQsetnonblocking(conn_, 1) != 0) {
+        PQexitPipelineMode(conn_);
+        isc_throw(DbOperationError, "unable to set the connection to the"
+                  " non-blocking mode: " << PQerrorMessage(conn_));
+    }
+}
+
+PgSqlPipeline::~PgSqlPipeline() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_.empty()) {
+        PQsetnonblocking(conn_, 0);
+        PQexitPipelineMode(conn_);
+    }
+}
+
+bool
+PgSqlPipeline::isSupported() {
+    return (true);
+}
+
+PgSqlResultPtr
+PgSqlPipeline::executePreparedStatement(PgSqlTaggedStatement& statement,
+                                        const PsqlBindArray& in_bindings) {
+    conn_.checkUnusable();
+
+    if (statement.nbparams != in_bindings.size()) {
+        isc_throw (InvalidOperation, "executePreparedStatement:"
+                   << " expected: " << statement.nbparams
+                   << " parameters, given: " << in_bindings.size()
+                   << ", statement: " << statement.name
+                   << ", SQL: " << statement.text);
+    }
+
+    const char* const* values = 0;
+    const int* lengths = 0;
+    const int* formats = 0;
+    if (statement.nbparams > 0) {
+        values = static_cast<const char* const*>(&in_bindings.values_[0]);
+        lengths = static_cast<const int *>(&in_bindings.lengths_[0]);
+        formats = static_cast<const int *>(&in_bindings.formats_[0]);
+    }
+
+    PendingPtr pending(new Pending());
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        // Each statement is followed by a synchronization point so that
+        // its failure doesn't abort the statements of the other threads.
+        bool sent = (PQsendQueryPrepared(conn_, statement.name,
+                                         statement.nbparams, values,
+                                         lengths, formats, 0) == 1);
+        if (sent) {
+            pending_.push_back(pending);
+            if ((PQpipelineSync(conn_) != 1) || !flush()) {
+                failPending();
+            }
+        }
+
+        while (sent && !pending->done_) {
+            if (reading_) {
+                cv_.wait(lock);
+                continue;
+            }
+
+            // Become the reader until our result is received.
+            reading_ = true;
+            while (!pending->done_) {
+                if (!readResults()) {
+                    failPending();
+                    break;
+                }
+                cv_.notify_all();
+                if (pending->done_) {
+                    break;
+                }
+                int fd = PQsocket(conn_);
+                lock.unlock();
+                struct pollfd pfd;
+                pfd.fd = fd;
+                pfd.events = POLLIN;
+                pfd.revents = 0;
+                // The input can be consumed by a thread flushing its
+                // statement so don't wait forever.
+                static_cast<void>(poll(&pfd, 1, POLL_TIMEOUT));
+                lock.lock();
+            }
+            reading_ = false;
+            cv_.notify_all();
+        }
+    }
+
+    // A null result is reported as a connection failure.
+    if (!pending->result_) {
+        pending->result_.reset(new PgSqlResult(0));
+    }
+    conn_.checkStatementError(*pending->result_, statement);
+    return (pending->result_);
+}
+
+uint64_t
+PgSqlPipeline::updateDeleteQuery(PgSqlTaggedStatement& statement,
+                                 const PsqlBindArray& in_bindings) {
+    PgSqlResultPtr result_set = executePreparedStatement(statement, in_bindings);
+    return (boost::lexical_cast<int>(PQcmdTuples(*result_set)));
+}
+
+size_t
+PgSqlPipeline::getPending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (pending_.size());
+}
+
+bool
+PgSqlPipeline::flush() {
+    for (;;) {
+        int ret = PQflush(conn_);
+        if (ret == 0) {
+            return (true);
+        }
+        if (ret < 0) {
+            return (false);
+        }
+        // The server may wait for us to read its results before reading
+        // more statements, so read while waiting to send.
+        struct pollfd pfd;
+        pfd.fd = PQsocket(conn_);
+        pfd.events = POLLIN | POLLOUT;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, -1) < 0) {
+            return (false);
+        }
+        if (((pfd.revents & POLLIN) != 0) && !readResults()) {
+            return (false);
+        }
+        cv_.notify_all();
+    }
+}
+
+bool
+PgSqlPipeline::readResults() {
+    if (PQconsumeInput(conn_) != 1) {
+        return (false);
+    }
+    while (!pending_.empty() && !PQisBusy(conn_)) {
+        PendingPtr head = pending_.front();
+        PGresult* result = PQgetResult(conn_);
+        if (!result) {
+            // End of the results of the statement.
+            head->ended_ = true;
+            continue;
+        }
+        if (PQresultStatus(result) == PGRES_PIPELINE_SYNC) {
+            PQclear(result);
+            head->done_ = true;
+            pending_.pop_front();
+            continue;
+        }
+        if (head->ended_ || head->result_) {
+            // Only the first result of a statement is kept.
+            PQclear(result);
+            continue;
+        }
+        head->result_.reset(new PgSqlResult(result));
+    }
+    return (true);
+}
+
+void
+PgSqlPipeline::failPending() {
+    for (auto const& pending : pending_) {
+        pending->result_.reset();
+        pending->done_ = true;
+    }
+    pending_.clear();
+    cv_.notify_all();
+}
+
+#else
+
+PgSqlPipeline::PgSqlPipeline(PgSqlConnection& conn)
+    : conn_(conn), pending_(), reading_(false) {
+    isc_throw(NotImplemented, "the pipeline mode is not supported by this"
+              " version of libpq");
+}
+
+PgSqlPipeline::~PgSqlPipeline() {
+}
+
+bool
+PgSqlPipeline::isSupported() {
+    return (false);
+}
+
+PgSqlResultPtr
+PgSqlPipeline::executePreparedStatement(PgSqlTaggedStatement& statement,
+                                        const PsqlBindArray& in_bindings) {
+    return (conn_.executePreparedStatement(statement, in_bindings));
+}
+
+uint64_t
+PgSqlPipeline::updateDeleteQuery(PgSqlTaggedStatement& statement,
+                                 const PsqlBindArray& in_bindings) {
+    return (conn_.updateDeleteQuery(statement, in_bindings));
+}
+
+size_t
+PgSqlPipeline::getPending() const {
+    return (0);
+}
+
+bool
+PgSqlPipeline::flush() {
+    return (true);
+}
+
+bool
+PgSqlPipeline::readResults() {
+    return (true);
+}
+
+void
+PgSqlPipeline::failPending() {
+}
+
+#endif // LIBPQ_HAS_PIPELINING
+
+} // end of isc::db namespace
+} // end of isc namespace
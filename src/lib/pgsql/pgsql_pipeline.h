@@ -0,0 +1,168 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PGSQL_PIPELINE_H
+#define PGSQL_PIPELINE_H
+
+#include <pgsql/pgsql_connection.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace isc {
+namespace db {
+
+/// @brief Executes prepared statements over a connection in pipeline mode.
+///
+/// In the default mode each statement is sent to the server and the caller
+/// waits for its result before the connection can be used again, so each
+/// statement costs a full round trip. In the libpq pipeline mode several
+/// statements can be sent before their results are received: this class
+/// lets several threads share a connection, each of them sending its
+/// statement as soon as it is ready and waiting for its own result.
+///
+/// A synchronization point follows each statement so an error aborts only
+/// the statement which caused it and is reported to its caller only.
+///
+/// The results are read by one of the waiting threads, the reader, which
+/// hands the results to their callers in the order the statements were
+/// sent. The reader waits for the socket without holding the lock so the
+/// other threads can send their statements in the meantime.
+///
+/// The statements which must be executed inside a transaction can't be
+/// sent to a pipeline shared by several threads: they must use another
+/// connection.
+class PgSqlPipeline : public boost::noncopyable {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Switches the connection to the pipeline mode. The statements must
+    /// be already prepared.
+    ///
+    /// @param conn Connection to be used by the pipeline. It must outlive
+    /// the pipeline.
+    /// @throw DbOperationError if the pipeline mode can't be entered.
+    /// @throw NotImplemented if the libpq doesn't support the pipeline mode.
+    explicit PgSqlPipeline(PgSqlConnection& conn);
+
+    /// @brief Destructor.
+    ///
+    /// Leaves the pipeline mode when no statement is pending.
+    ~PgSqlPipeline();
+
+    /// @brief Indicates if the libpq supports the pipeline mode.
+    ///
+    /// @return true if the pipeline mode is supported, false otherwise.
+    static bool isSupported();
+
+    /// @brief Executes a prepared statement in the pipeline.
+    ///
+    /// The function returns when the result of the statement is received.
+    /// It has the same semantics as the
+    /// @c PgSqlConnection::executePreparedStatement.
+    ///
+    /// @param statement Statement to execute.
+    /// @param in_bindings Input parameters of the statement.
+    ///
+    /// @return Result of the statement.
+    /// @throw InvalidOperation if the number of parameters doesn't match.
+    /// @throw DbConnectionUnusable if the connection is lost.
+    /// @throw DuplicateEntry, NullKeyError or DbOperationError if the
+    /// statement failed.
+    PgSqlResultPtr executePreparedStatement(PgSqlTaggedStatement& statement,
+                                            const PsqlBindArray& in_bindings =
+                                            PsqlBindArray());
+
+    /// @brief Executes an insert or update or delete statement.
+    ///
+    /// @param statement Statement to execute.
+    /// @param in_bindings Input parameters of the statement.
+    ///
+    /// @return Number of affected rows.
+    uint64_t updateDeleteQuery(PgSqlTaggedStatement& statement,
+                               const PsqlBindArray& in_bindings);
+
+    /// @brief Returns the number of statements awaiting their result.
+    size_t getPending() const;
+
+    /// @brief Returns the connection of the pipeline.
+    PgSqlConnection& getConnection() {
+        return (conn_);
+    }
+
+private:
+
+    /// @brief Statement awaiting its result.
+    struct Pending {
+        /// @brief Constructor.
+        Pending() : result_(), done_(false), ended_(false) {
+        }
+
+        /// @brief Result of the statement.
+        PgSqlResultPtr result_;
+
+        /// @brief Indicates that the synchronization point following
+        /// the statement was received.
+        bool done_;
+
+        /// @brief Indicates that all the results of the statement were
+        /// received.
+        bool ended_;
+    };
+
+    /// @brief Pointer to a pending statement.
+    typedef boost::shared_ptr<Pending> PendingPtr;
+
+    /// @brief Sends the buffered data to the server.
+    ///
+    /// Must be called with the mutex locked.
+    ///
+    /// @return false if the connection failed.
+    bool flush();
+
+    /// @brief Reads the available results and hands them to the pending
+    /// statements.
+    ///
+    /// Must be called with the mutex locked.
+    ///
+    /// @return false if the connection failed.
+    bool readResults();
+
+    /// @brief Completes all the pending statements with no result.
+    ///
+    /// Called when the connection failed. Must be called with the mutex
+    /// locked.
+    void failPending();
+
+    /// @brief Connection in pipeline mode.
+    PgSqlConnection& conn_;
+
+    /// @brief Statements awaiting their result in the sending order.
+    std::deque<PendingPtr> pending_;
+
+    /// @brief Indicates that a thread reads the results.
+    bool reading_;
+
+    /// @brief Mutex protecting the connection and the pending statements.
+    mutable std::mutex mutex_;
+
+    /// @brief Condition signaled when results were handed or the reader
+    /// changes.
+    std::condition_variable cv_;
+};
+
+/// @brief Pointer to a @c PgSqlPipeline.
+typedef boost::shared_ptr<PgSqlPipeline> PgSqlPipelinePtr;
+
+} // end of isc::db namespace
+} // end of isc namespace
+
+#endif // PGSQL_PIPELINE_H
@@ -0,0 +1,191 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <database/db_exceptions.h>
+#include <pgsql/pgsql_connection.h>
+#include <pgsql/pgsql_exchange.h>
+#include <pgsql/pgsql_pipeline.h>
+#include <pgsql/tests/pgsql_basics.h>
+#include <testutils/gtest_utils.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace isc;
+using namespace isc::db;
+using namespace isc::db::test;
+
+namespace {
+
+/// @brief Test fixture for exercising the @c PgSqlPipeline.
+class PgSqlPipelineTest : public PgSqlBasicsTest {
+public:
+
+    /// @brief Indexes of prepared statements used within the tests.
+    enum StatementIndex {
+        INSERT_ID_VALUE,
+        GET_BY_INT_VALUE,
+        UPDATE_BY_INT_VALUE,
+        NUM_STATEMENTS
+    };
+
+    /// @brief Array of tagged PgSql statements.
+    typedef std::array<PgSqlTaggedStatement, NUM_STATEMENTS> TaggedStatementArray;
+
+    /// @brief Prepared PgSql statements used in the tests.
+    TaggedStatementArray tagged_statements = {{
+        { 2, { OID_INT4, OID_INT4 }, "INSERT_ID_VALUE",
+          "INSERT INTO basics (id, int_col) VALUES ($1, $2)" },
+
+        { 1, { OID_INT4 }, "GET_BY_INT_VALUE",
+          "SELECT int_col FROM basics WHERE int_col = $1" },
+
+        { 2, { OID_INT4, OID_TEXT }, "UPDATE_BY_INT_VALUE",
+          "UPDATE basics SET text_col = $2 WHERE int_col = $1" }
+    }};
+
+    /// @brief Constructor.
+    PgSqlPipelineTest() : PgSqlBasicsTest() {
+    }
+
+    /// @brief Destructor.
+    ///
+    /// The pipeline is destroyed before the schema.
+    virtual ~PgSqlPipelineTest() {
+        pipeline_.reset();
+    }
+
+    /// @brief SetUp function which prepares the tagged statements and
+    /// creates the pipeline.
+    virtual void SetUp() {
+        if (!PgSqlPipeline::isSupported()) {
+            return;
+        }
+        ASSERT_NO_THROW_LOG(conn_->prepareStatements(tagged_statements.begin(),
+                                                     tagged_statements.end()));
+        ASSERT_NO_THROW_LOG(pipeline_.reset(new PgSqlPipeline(*conn_)));
+    }
+
+    /// @brief Inserts a row.
+    ///
+    /// @param id Value of the id column.
+    /// @param value Value of the int_col column.
+    void insert(int id, int value) {
+        PsqlBindArray in_bindings;
+        in_bindings.add(id);
+        in_bindings.add(value);
+        pipeline_->executePreparedStatement(tagged_statements[INSERT_ID_VALUE],
+                                            in_bindings);
+    }
+
+    /// @brief Counts the rows with a value.
+    ///
+    /// @param value Value of the int_col column.
+    /// @return Number of rows.
+    int count(int value) {
+        PsqlBindArray in_bindings;
+        in_bindings.add(value);
+        PgSqlResultPtr r =
+            pipeline_->executePreparedStatement(tagged_statements[GET_BY_INT_VALUE],
+                                                in_bindings);
+        return (r->getRows());
+    }
+
+    /// @brief The pipeline.
+    PgSqlPipelinePtr pipeline_;
+};
+
+/// @brief Verifies that the statements are executed in the pipeline.
+TEST_F(PgSqlPipelineTest, executePreparedStatement) {
+    if (!pipeline_) {
+        return;
+    }
+
+    // The number of parameters is checked.
+    PsqlBindArray in_bindings;
+    EXPECT_THROW(pipeline_->executePreparedStatement(tagged_statements[INSERT_ID_VALUE],
+                                                     in_bindings),
+                 InvalidOperation);
+
+    ASSERT_NO_THROW_LOG(insert(1, 10));
+    ASSERT_NO_THROW_LOG(insert(2, 20));
+    EXPECT_EQ(1, count(10));
+    EXPECT_EQ(1, count(20));
+    EXPECT_EQ(0, count(30));
+
+    in_bindings.add(20);
+    in_bindings.add("twenty");
+    uint64_t affected_rows = 0;
+    ASSERT_NO_THROW_LOG(affected_rows =
+        pipeline_->updateDeleteQuery(tagged_statements[UPDATE_BY_INT_VALUE],
+                                     in_bindings));
+    EXPECT_EQ(1, affected_rows);
+    EXPECT_EQ(0, pipeline_->getPending());
+}
+
+/// @brief Verifies that an error is reported to the statement which
+/// caused it only.
+TEST_F(PgSqlPipelineTest, error) {
+    if (!pipeline_) {
+        return;
+    }
+
+    ASSERT_NO_THROW_LOG(insert(1, 10));
+    EXPECT_THROW(insert(1, 20), DuplicateEntry);
+
+    // The next statements are not aborted.
+    ASSERT_NO_THROW_LOG(insert(2, 20));
+    EXPECT_EQ(1, count(10));
+    EXPECT_EQ(1, count(20));
+}
+
+/// @brief Verifies that several threads can share the pipeline.
+TEST_F(PgSqlPipelineTest, threads) {
+    if (!pipeline_) {
+        return;
+    }
+
+    const int thread_count = 8;
+    const int rows_per_thread = 50;
+    std::atomic<int> errors(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.push_back(std::thread([this, t, &errors]() {
+            for (int i = 0; i < rows_per_thread; ++i) {
+                int id = t * rows_per_thread + i + 1;
+                try {
+                    insert(id, id);
+                    if (count(id) != 1) {
+                        ++errors;
+                    }
+                    // Every thread hits a duplicate from time to time.
+                    if ((i % 10) == 0) {
+                        try {
+                            insert(id, id);
+                            ++errors;
+                        } catch (const DuplicateEntry&) {
+                        }
+                    }
+                } catch (const std::exception&) {
+                    ++errors;
+                }
+            }
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(0, errors);
+    EXPECT_EQ(0, pipeline_->getPending());
+}
+
+}  // namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2019-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -16,6 +16,12 @@
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <process/d_log.h>
 
+#include <exception>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <vector>
+
 namespace isc {
 namespace process {
 
@@ -313,6 +319,54 @@ protected:
         return (ConfigBackendMgrType::instance());
     }
 
+    /// @brief Type of a configuration fetch run by @c parallelConfigFetch.
+    typedef std::function<void(const typename ConfigBackendMgrType::ConfigBackendPoolPtr&)>
+    ConfigFetch;
+
+    /// @brief Runs configuration fetches in parallel.
+    ///
+    /// Each fetch runs in its own thread with a pool of new instances of
+    /// the backends, i.e. over its own database connections, so the
+    /// independent configuration elements are fetched concurrently rather
+    /// than one after another. The caller must check that the backends
+    /// support it with @c supportsParallelFetch.
+    ///
+    /// @param fetches Fetches to run.
+    /// @throw The first exception thrown by a fetch, rethrown when all
+    /// fetches have completed.
+    void parallelConfigFetch(const std::vector<ConfigFetch>& fetches) const {
+        std::vector<std::exception_ptr> errors(fetches.size());
+        auto run = [this, &fetches, &errors](size_t i) {
+            try {
+                // The backends are created and destroyed by the thread
+                // using them.
+                auto pool = getMgr().createPool();
+                fetches[i](pool);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < fetches.size(); ++i) {
+            try {
+                threads.push_back(std::thread(run, i));
+            } catch (const std::system_error&) {
+                // No more threads: run the fetch here.
+                run(i);
+            }
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (auto const& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
     /// @brief Convenience method returning initial timestamp to set the
     /// @c last_audit_revision_time_ to.
     ///
@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -33,7 +33,7 @@ ConfigControlParser::parse(const data::ConstElementPtr& config_control) {
 
             const std::vector<data::ElementPtr>& db_list = elem->listValue();
             for (auto db = db_list.cbegin(); db != db_list.end(); ++db) {
-                db::DbAccessParser parser;
+                db::DbAccessParser parser(db::DbAccessParser::CONFIG_DB);
                 std::string access_string;
                 parser.parse(access_string, *db);
                 /// @todo do we still need access_string for this at all?
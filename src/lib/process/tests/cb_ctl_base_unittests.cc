@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2019-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 #include <map>
 #include <string>
+#include <vector>
 
 using namespace isc;
 using namespace isc::cb;
@@ -33,7 +34,10 @@ class CBControlBackend : BaseConfigBackend {
 public:
 
     /// @brief Constructor.
-    CBControlBackend(const db::DatabaseConnection::ParameterMap&) {
+    ///
+    /// @param parameters Backend parameters.
+    CBControlBackend(const db::DatabaseConnection::ParameterMap& parameters)
+        : parameters_(parameters) {
     }
 
     /// @brief Retrieves the audit entries later than specified time.
@@ -120,6 +124,20 @@ public:
         return (0);
     }
 
+    /// @brief Return backend parameters.
+    ///
+    /// @return Parameters of the backend.
+    virtual db::DatabaseConnection::ParameterMap getParameters() const {
+        return (parameters_);
+    }
+
+    /// @brief Checks if the configuration can be fetched in parallel.
+    ///
+    /// @return true, the audit entries are shared by the instances.
+    virtual bool supportsParallelFetch() const {
+        return (true);
+    }
+
     /// @brief Removes audit entries.
     static void clearAuditEntries() {
         audit_entries_.clear();
@@ -127,6 +145,9 @@ public:
 
 private:
 
+    /// @brief Backend parameters.
+    db::DatabaseConnection::ParameterMap parameters_;
+
     /// @brief Static collection of audit entries.
     ///
     /// Thanks to storing them in the static member they are preserved
@@ -238,6 +259,8 @@ public:
     using CBControlBase<CBControlBackendMgr>::fetchConfigElement;
     using CBControlBase<CBControlBackendMgr>::getMgr;
     using CBControlBase<CBControlBackendMgr>::getInitialAuditRevisionTime;
+    using CBControlBase<CBControlBackendMgr>::parallelConfigFetch;
+    using CBControlBase<CBControlBackendMgr>::ConfigFetch;
 
     /// @brief Constructor.
     CBControl()
@@ -715,4 +738,50 @@ TEST_F(CBControlBaseTest, fetchFailure) {
     EXPECT_EQ(0, cb_ctl_.getLastAuditRevisionId());
 }
 
+// This test verifies that the parallel fetches use new instances of
+// the backends and that their errors are reported.
+TEST_F(CBControlBaseTest, parallelConfigFetch) {
+    EXPECT_FALSE(cb_ctl_.getMgr().getPool()->supportsParallelFetch());
+    ASSERT_TRUE(cb_ctl_.databaseConfigConnect(makeConfigBase("type=db1")));
+    EXPECT_TRUE(cb_ctl_.getMgr().getPool()->supportsParallelFetch());
+
+    cb_ctl_.getMgr().getPool()->addAuditEntry(BackendSelector::UNSPEC(),
+                                              ServerSelector::ALL(),
+                                              "sql_table_1",
+                                              1234,
+                                              timestamps_["yesterday"],
+                                              2345);
+
+    auto main_pool = cb_ctl_.getMgr().getPool();
+    auto since = timestamps_["two days ago"];
+    std::vector<size_t> counts(4, 0);
+    std::vector<CBControlBackendMgr::ConfigBackendPoolPtr> pools(counts.size());
+    std::vector<CBControl::ConfigFetch> fetches;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        fetches.push_back([since, &counts, &pools, i]
+                          (const CBControlBackendMgr::ConfigBackendPoolPtr& pool) {
+            pools[i] = pool;
+            counts[i] = pool->getRecentAuditEntries(BackendSelector::UNSPEC(),
+                                                    ServerSelector::ALL(),
+                                                    since, 0).size();
+        });
+    }
+    ASSERT_NO_THROW(cb_ctl_.parallelConfigFetch(fetches));
+    for (size_t i = 0; i < counts.size(); ++i) {
+        EXPECT_EQ(1, counts[i]);
+        ASSERT_TRUE(pools[i]);
+        EXPECT_NE(main_pool, pools[i]);
+    }
+
+    // The error of a fetch is rethrown when all fetches have completed.
+    fetches.push_back([](const CBControlBackendMgr::ConfigBackendPoolPtr&) {
+        isc_throw(Unexpected, "fetch failed");
+    });
+    counts.assign(counts.size(), 0);
+    EXPECT_THROW(cb_ctl_.parallelConfigFetch(fetches), Unexpected);
+    for (auto count : counts) {
+        EXPECT_EQ(1, count);
+    }
+}
+
 }
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -77,6 +77,13 @@ StatContext::getAll() const {
     return (map);
 }
 
+void
+StatContext::addOpenMetrics(OpenMetricsWriter& writer) const {
+    for (auto const& s : stats_) {
+        writer.add(*s.second);
+    }
+}
+
 void
 StatContext::setMaxSampleCountAll(uint32_t max_samples) {
     // Let's iterate over all stored statistics...
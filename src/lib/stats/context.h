@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,6 +8,7 @@
 #define CONTEXT_H
 
 #include <stats/observation.h>
+#include <stats/open_metrics.h>
 #include <boost/shared_ptr.hpp>
 #include <mutex>
 #include <string>
@@ -75,6 +76,11 @@ public:
     /// @return map with all observations
     isc::data::ConstElementPtr getAll() const;
 
+    /// @brief Adds all observations to an OpenMetrics writer
+    ///
+    /// @param writer writer to which the observations are added
+    void addOpenMetrics(OpenMetricsWriter& writer) const;
+
 private:
 
     /// @brief Statistics container
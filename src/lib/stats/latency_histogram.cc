@@ -0,0 +1,215 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <stats/latency_histogram.h>
+
+using namespace isc::data;
+
+namespace {
+
+/// @brief Number of buckets per power of two.
+const size_t SUB_BUCKETS = 16;
+
+/// @brief Latencies below this value have their own bucket.
+const uint64_t LINEAR_LIMIT = 2 * SUB_BUCKETS;
+
+/// @brief Shard index of the next thread using a histogram.
+std::atomic<size_t> next_shard(0);
+
+/// @brief Returns the index of the highest bit set.
+///
+/// @param value non zero value.
+size_t
+highestBit(uint64_t value) {
+    size_t bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return (bit);
+}
+
+/// @brief Raises a maximum to a value.
+///
+/// @param max the maximum.
+/// @param value the value.
+void
+raiseMax(std::atomic<uint64_t>& max, uint64_t value) {
+    uint64_t current = max.load(std::memory_order_relaxed);
+    while ((value > current) &&
+           !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+}
+
+namespace isc {
+namespace stats {
+
+const size_t LatencyHistogram::SHARDS;
+const size_t LatencyHistogram::BUCKETS;
+
+LatencyHistogram::Shard::Shard() : sum_(0), max_(0) {
+    for (auto& count : counts_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+LatencyHistogram::LatencyHistogram(const std::string& name)
+    : shards_(), name_(name) {
+}
+
+size_t
+LatencyHistogram::getBucket(uint64_t usecs) {
+    if (usecs < LINEAR_LIMIT) {
+        return (usecs);
+    }
+    // The bucket is given by the highest bit and the 4 following bits.
+    size_t bit = highestBit(usecs);
+    size_t bucket = (bit - 3) * SUB_BUCKETS + ((usecs >> (bit - 4)) - SUB_BUCKETS);
+    return (bucket < BUCKETS ? bucket : BUCKETS - 1);
+}
+
+uint64_t
+LatencyHistogram::getBucketUpperBound(size_t bucket) {
+    if (bucket < LINEAR_LIMIT) {
+        return (bucket);
+    }
+    size_t shift = bucket / SUB_BUCKETS - 1;
+    uint64_t lower = static_cast<uint64_t>(bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+    return (lower + (static_cast<uint64_t>(1) << shift) - 1);
+}
+
+void
+LatencyHistogram::record(uint64_t usecs) {
+    Shard& shard = shards_[getShard()];
+    shard.counts_[getBucket(usecs)].fetch_add(1, std::memory_order_relaxed);
+    shard.sum_.fetch_add(usecs, std::memory_order_relaxed);
+    raiseMax(shard.max_, usecs);
+}
+
+uint64_t
+LatencyHistogram::getCounts(Counts& counts) const {
+    counts.fill(0);
+    uint64_t total = 0;
+    for (auto const& shard : shards_) {
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            uint64_t count = shard.counts_[i].load(std::memory_order_relaxed);
+            counts[i] += count;
+            total += count;
+        }
+    }
+    return (total);
+}
+
+uint64_t
+LatencyHistogram::getCount() const {
+    Counts counts;
+    return (getCounts(counts));
+}
+
+uint64_t
+LatencyHistogram::getMax() const {
+    uint64_t max = 0;
+    for (auto const& shard : shards_) {
+        uint64_t value = shard.max_.load(std::memory_order_relaxed);
+        if (value > max) {
+            max = value;
+        }
+    }
+    return (max);
+}
+
+uint64_t
+LatencyHistogram::getSum() const {
+    uint64_t sum = 0;
+    for (auto const& shard : shards_) {
+        sum += shard.sum_.load(std::memory_order_relaxed);
+    }
+    return (sum);
+}
+
+uint64_t
+LatencyHistogram::getPercentile(const Counts& counts, uint64_t total,
+                                uint64_t max, double percent) {
+    if (total == 0) {
+        return (0);
+    }
+    // Rank of the percentile, at least the first latency.
+    double rank = percent / 100.0 * static_cast<double>(total);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if ((seen > 0) && (static_cast<double>(seen) >= rank)) {
+            uint64_t bound = getBucketUpperBound(i);
+            return (bound < max ? bound : max);
+        }
+    }
+    return (max);
+}
+
+uint64_t
+LatencyHistogram::getPercentile(double percent) const {
+    Counts counts;
+    uint64_t total = getCounts(counts);
+    return (getPercentile(counts, total, getMax(), percent));
+}
+
+void
+LatencyHistogram::reset() {
+    for (auto& shard : shards_) {
+        for (auto& count : shard.counts_) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        shard.sum_.store(0, std::memory_order_relaxed);
+        shard.max_.store(0, std::memory_order_relaxed);
+    }
+}
+
+void
+LatencyHistogram::merge(const LatencyHistogram& other) {
+    Counts counts;
+    if (other.getCounts(counts) == 0) {
+        return;
+    }
+    Shard& shard = shards_[getShard()];
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        if (counts[i] > 0) {
+            shard.counts_[i].fetch_add(counts[i], std::memory_order_relaxed);
+        }
+    }
+    shard.sum_.fetch_add(other.getSum(), std::memory_order_relaxed);
+    raiseMax(shard.max_, other.getMax());
+}
+
+ConstElementPtr
+LatencyHistogram::toElement() const {
+    Counts counts;
+    uint64_t total = getCounts(counts);
+    uint64_t sum = getSum();
+    uint64_t max = getMax();
+
+    ElementPtr map = Element::createMap();
+    map->set("count", Element::create(static_cast<int64_t>(total)));
+    map->set("mean", Element::create(total ? static_cast<double>(sum) / total : 0.0));
+    map->set("max", Element::create(static_cast<int64_t>(max)));
+    map->set("p50", Element::create(static_cast<int64_t>(getPercentile(counts, total, max, 50.0))));
+    map->set("p90", Element::create(static_cast<int64_t>(getPercentile(counts, total, max, 90.0))));
+    map->set("p99", Element::create(static_cast<int64_t>(getPercentile(counts, total, max, 99.0))));
+    map->set("p99.9", Element::create(static_cast<int64_t>(getPercentile(counts, total, max, 99.9))));
+    return (map);
+}
+
+size_t
+LatencyHistogram::getShard() {
+    // The threads are given the shards in turn on their first use.
+    thread_local size_t shard = next_shard.fetch_add(1) % SHARDS;
+    return (shard);
+}
+
+} // end of namespace isc::stats
+} // end of namespace isc
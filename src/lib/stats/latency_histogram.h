@@ -0,0 +1,174 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cc/data.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace isc {
+namespace stats {
+
+/// @brief Distribution of latencies recorded without locking.
+///
+/// The latencies are counted in microseconds in log-linear buckets, in the
+/// way of the HDR histograms: the values below 32 have their own bucket,
+/// and each higher power of two is split in 16 buckets, so a bucket covers
+/// at most 1/16 of its lower bound. The reported percentiles are the upper
+/// bounds of the buckets, i.e. they overestimate the latency by less than
+/// 6.25%. The values above 2^36 microseconds (about 19 hours) are counted
+/// in the last bucket.
+///
+/// As for the @ref StatCounter, the counts are spread over shards, each
+/// thread recording in its own shard, and the shards are summed when the
+/// histogram is read.
+class LatencyHistogram : public boost::noncopyable {
+public:
+
+    /// @brief Number of shards.
+    static const size_t SHARDS = 8;
+
+    /// @brief Number of buckets.
+    static const size_t BUCKETS = 528;
+
+    /// @brief Constructor.
+    ///
+    /// @param name name of the histogram.
+    explicit LatencyHistogram(const std::string& name);
+
+    /// @brief Returns the name of the histogram.
+    const std::string& getName() const {
+        return (name_);
+    }
+
+    /// @brief Records a latency.
+    ///
+    /// @param usecs latency in microseconds.
+    void record(uint64_t usecs);
+
+    /// @brief Records a latency.
+    ///
+    /// @param latency latency, negative values are recorded as 0.
+    void record(const std::chrono::steady_clock::duration& latency) {
+        auto usecs = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+        record(static_cast<uint64_t>(usecs > 0 ? usecs : 0));
+    }
+
+    /// @brief Returns the number of recorded latencies.
+    uint64_t getCount() const;
+
+    /// @brief Returns the highest recorded latency in microseconds.
+    uint64_t getMax() const;
+
+    /// @brief Returns the sum of the recorded latencies in microseconds.
+    uint64_t getSum() const;
+
+    /// @brief Returns a percentile of the recorded latencies.
+    ///
+    /// @param percent percentile between 0 and 100.
+    /// @return the upper bound of the bucket holding the percentile in
+    /// microseconds, not more than the highest latency, 0 when no latency
+    /// was recorded.
+    uint64_t getPercentile(double percent) const;
+
+    /// @brief Discards the recorded latencies.
+    void reset();
+
+    /// @brief Adds the latencies recorded by another histogram.
+    ///
+    /// The latencies are added to the shard of the calling thread.
+    ///
+    /// @param other the other histogram.
+    void merge(const LatencyHistogram& other);
+
+    /// @brief Returns the summary of the histogram.
+    ///
+    /// The summary is a map with the number of recorded latencies
+    /// ("count"), and the mean, the highest latency and the 50th, 90th,
+    /// 99th and 99.9th percentiles in microseconds ("mean", "max", "p50",
+    /// "p90", "p99" and "p99.9").
+    ///
+    /// @return the summary of the histogram.
+    isc::data::ConstElementPtr toElement() const;
+
+    /// @brief Returns the bucket of a latency.
+    ///
+    /// @param usecs latency in microseconds.
+    /// @return the index of the bucket.
+    static size_t getBucket(uint64_t usecs);
+
+    /// @brief Returns the highest latency of a bucket.
+    ///
+    /// @param bucket index of the bucket.
+    /// @return the highest latency counted in the bucket in microseconds.
+    static uint64_t getBucketUpperBound(size_t bucket);
+
+private:
+
+    /// @brief Returns the shard index of the calling thread.
+    static size_t getShard();
+
+    /// @brief Counts of all the shards.
+    typedef std::array<uint64_t, BUCKETS> Counts;
+
+    /// @brief Sums the counts of the shards.
+    ///
+    /// @param [out] counts the summed counts.
+    /// @return the number of recorded latencies.
+    uint64_t getCounts(Counts& counts) const;
+
+    /// @brief Returns a percentile of summed counts.
+    ///
+    /// @param counts the summed counts.
+    /// @param total the number of recorded latencies.
+    /// @param max the highest recorded latency.
+    /// @param percent percentile between 0 and 100.
+    /// @return the percentile in microseconds.
+    static uint64_t getPercentile(const Counts& counts, uint64_t total,
+                                  uint64_t max, double percent);
+
+    /// @brief The counts of a thread.
+    struct Shard {
+        /// @brief Constructor.
+        Shard();
+
+        /// @brief Counts by bucket.
+        std::array<std::atomic<uint64_t>, BUCKETS> counts_;
+
+        /// @brief Sum of the recorded latencies.
+        std::atomic<uint64_t> sum_;
+
+        /// @brief Highest recorded latency.
+        std::atomic<uint64_t> max_;
+
+        /// @brief Padding keeping the sum and the maximum of consecutive
+        /// shards in distinct cache lines.
+        char padding_[64];
+    };
+
+    /// @brief The shards.
+    std::array<Shard, SHARDS> shards_;
+
+    /// @brief Name of the histogram.
+    std::string name_;
+};
+
+/// @brief Pointer to a latency histogram.
+typedef boost::shared_ptr<LatencyHistogram> LatencyHistogramPtr;
+
+} // end of namespace isc::stats
+} // end of namespace isc
+
+#endif // LATENCY_HISTOGRAM_H
@@ -9,6 +9,7 @@
 #include <stats/observation.h>
 #include <util/chrono_time_utils.h>
 #include <cc/data.h>
+#include <algorithm>
 #include <chrono>
 #include <utility>
 
@@ -193,28 +194,29 @@ void Observation::setValueInternal(SampleType value, StorageType& storage,
                   << typeToText(type_));
     }
 
-    if (storage.empty()) {
-        storage.push_back(make_pair(value, SampleClock::now()));
+    if (max_sample_count_.first) {
+        // The storage capacity is the count limit so pushing a sample
+        // to a full storage overwrites the oldest one in place.
+        size_t capacity = max(max_sample_count_.second, static_cast<uint32_t>(1));
+        if (storage.capacity() != capacity) {
+            storage.set_capacity(capacity);
+        }
+        storage.push_front(make_pair(value, SampleClock::now()));
     } else {
-        // Storing of more than one sample
+        // There is no count limit: grow the storage when it is full.
+        if (storage.full()) {
+            storage.set_capacity(max(storage.capacity() * 2, static_cast<size_t>(1)));
+        }
         storage.push_front(make_pair(value, SampleClock::now()));
 
-        if (max_sample_count_.first) {
-            // if max_sample_count_ is set to true
-            // and size of storage is equal to max_sample_count_
-            if (storage.size() > max_sample_count_.second) {
-                storage.pop_back(); // removing the last element
-            }
-        } else {
-            StatsDuration range_of_storage =
+        StatsDuration range_of_storage =
+            storage.front().second - storage.back().second;
+        // removing samples until the range_of_storage
+        // stops exceeding the duration limit
+        while (range_of_storage > max_sample_age_.second) {
+            storage.pop_back();
+            range_of_storage =
                 storage.front().second - storage.back().second;
-            // removing samples until the range_of_storage
-            // stops exceeding the duration limit
-            while (range_of_storage > max_sample_age_.second) {
-                storage.pop_back();
-                range_of_storage =
-                    storage.front().second - storage.back().second;
-            }
         }
     }
 }
@@ -283,7 +285,7 @@ std::list<SampleType> Observation::getValuesInternal(Storage& storage,
         // still be there.
         isc_throw(Unexpected, "Observation storage container empty");
     }
-    return (storage);
+    return (std::list<SampleType>(storage.begin(), storage.end()));
 }
 
 template<typename StorageType>
@@ -331,6 +333,8 @@ void Observation::setMaxSampleCountInternal(StorageType& storage,
         // deleting elements which are exceeding the max_samples limit
         storage.pop_back();
     }
+    // The storage may be empty only until the next sample.
+    storage.set_capacity(max(max_samples, static_cast<uint32_t>(1)));
 }
 
 void Observation::setMaxSampleAgeDefault(const StatsDuration& duration) {
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,6 +9,7 @@
 
 #include <cc/data.h>
 #include <exceptions/exceptions.h>
+#include <boost/circular_buffer.hpp>
 #include <boost/shared_ptr.hpp>
 #include <chrono>
 #include <list>
@@ -81,6 +82,11 @@ typedef std::pair<std::string, SampleClock::time_point> StringSample;
 /// @ref getJSON, which is generic and can be used for all types.
 ///
 /// Since Kea 1.6 multiple samples are stored for the same observation.
+/// The samples are kept in circular buffers, newest first. With a count
+/// limit the buffer capacity is the limit, so recording a sample reuses
+/// the slot of the oldest one instead of allocating. A count limit of 1
+/// keeps no history, only the current value. With an age limit the buffer
+/// grows as needed.
 class Observation {
 public:
 
@@ -313,7 +319,7 @@ private:
     /// This method returns size of observed storage.
     /// It is used by public methods to return size of
     /// available storages.
-    /// @tparam Storage type of storage (e.g. list<IntegerSample>)
+    /// @tparam Storage type of storage (e.g. circular_buffer<IntegerSample>)
     /// @param storage storage which size will be returned
     /// @param exp_type expected observation type (used for sanity checking)
     /// @return size of storage
@@ -327,7 +333,7 @@ private:
     /// available storages.
     ///
     /// @tparam SampleType type of sample (e.g. IntegerSample)
-    /// @tparam StorageType type of storage (e.g. list<IntegerSample>)
+    /// @tparam StorageType type of storage (e.g. circular_buffer<IntegerSample>)
     /// @param value observation to be recorded
     /// @param storage observation will be stored here
     /// @param exp_type expected observation type (used for sanity checking)
@@ -339,7 +345,7 @@ private:
     /// @brief Returns a sample (internal version)
     ///
     /// @tparam SampleType type of sample (e.g. IntegerSample)
-    /// @tparam StorageType type of storage (e.g. list<IntegerSample>)
+    /// @tparam StorageType type of storage (e.g. circular_buffer<IntegerSample>)
     /// @param observation storage
     /// @param exp_type expected observation type (used for sanity checking)
     /// @throw InvalidStatType if observation type mismatches
@@ -350,7 +356,7 @@ private:
     /// @brief Returns samples (internal version)
     ///
     /// @tparam SampleType type of samples (e.g. IntegerSample)
-    /// @tparam Storage type of storage (e.g. list<IntegerSample>)
+    /// @tparam Storage type of storage (e.g. circular_buffer<IntegerSample>)
     /// @param observation storage
     /// @param exp_type expected observation type (used for sanity checking)
     /// @throw InvalidStatType if observation type mismatches
@@ -361,7 +367,7 @@ private:
 
     /// @brief Determines maximum age of samples.
     ///
-    /// @tparam Storage type of storage (e.g. list<IntegerSample>)
+    /// @tparam Storage type of storage (e.g. circular_buffer<IntegerSample>)
     /// @param storage storage on which limit will be set
     /// @param duration determines maximum age of samples
     /// @param exp_type expected observation type (used for sanity checking)
@@ -371,7 +377,7 @@ private:
 
     /// @brief Determines how many samples of a given statistic should be kept.
     ///
-    /// @tparam Storage type of storage (e.g. list<IntegerSample>)
+    /// @tparam Storage type of storage (e.g. circular_buffer<IntegerSample>)
     /// @param storage storage on which limit will be set
     /// @param max_samples determines maximum number of samples
     /// @param exp_type expected observation type (used for sanity checking)
@@ -423,16 +429,16 @@ private:
     /// @{
 
     /// @brief Storage for integer samples
-    std::list<IntegerSample> integer_samples_;
+    boost::circular_buffer<IntegerSample> integer_samples_;
 
     /// @brief Storage for floating point samples
-    std::list<FloatSample> float_samples_;
+    boost::circular_buffer<FloatSample> float_samples_;
 
     /// @brief Storage for time duration samples
-    std::list<DurationSample> duration_samples_;
+    boost::circular_buffer<DurationSample> duration_samples_;
 
     /// @brief Storage for string samples
-    std::list<StringSample> string_samples_;
+    boost::circular_buffer<StringSample> string_samples_;
     /// @}
 };
 
@@ -0,0 +1,167 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <stats/open_metrics.h>
+
+#include <chrono>
+#include <limits>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+
+/// @brief Appends a name part replacing the characters not allowed in a
+/// metric name with underscores.
+///
+/// @param part name part.
+/// @param [out] family metric family name to append to.
+void
+appendNamePart(const string& part, string& family) {
+    if (part.empty()) {
+        return;
+    }
+    family += '_';
+    for (char c : part) {
+        if (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+            ((c >= '0') && (c <= '9')) || (c == '_') || (c == ':')) {
+            family += c;
+        } else {
+            family += '_';
+        }
+    }
+}
+
+/// @brief Appends a label escaping its value.
+///
+/// @param name label name.
+/// @param value label value.
+/// @param [out] labels labels to append to.
+void
+appendLabel(const string& name, const string& value, string& labels) {
+    if (!labels.empty()) {
+        labels += ',';
+    }
+    string label_name;
+    appendNamePart(name, label_name);
+    labels += label_name.substr(1);
+    labels += "=\"";
+    for (char c : value) {
+        switch (c) {
+        case '\\':
+            labels += "\\\\";
+            break;
+        case '"':
+            labels += "\\\"";
+            break;
+        case '\n':
+            labels += "\\n";
+            break;
+        default:
+            labels += c;
+        }
+    }
+    labels += '"';
+}
+
+}
+
+namespace isc {
+namespace stats {
+
+const char* OpenMetricsWriter::CONTENT_TYPE =
+    "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+OpenMetricsWriter::OpenMetricsWriter(const string& prefix)
+    : prefix_(prefix), families_() {
+}
+
+void
+OpenMetricsWriter::convertName(const string& prefix, const string& name,
+                               string& family, string& labels) {
+    family = prefix;
+    labels.clear();
+    string part;
+    size_t pos = 0;
+    while (pos < name.size()) {
+        char c = name[pos];
+        if (c == '[') {
+            // The index may contain dots so look for the closing bracket.
+            size_t end = name.find(']', pos);
+            if (end == string::npos) {
+                part += name.substr(pos);
+                break;
+            }
+            appendNamePart(part, family);
+            appendLabel(part.empty() ? "index" : part,
+                        name.substr(pos + 1, end - pos - 1), labels);
+            part.clear();
+            pos = end + 1;
+            continue;
+        }
+        if (c == '.') {
+            appendNamePart(part, family);
+            part.clear();
+        } else {
+            part += c;
+        }
+        ++pos;
+    }
+    appendNamePart(part, family);
+    if (family.empty()) {
+        family = "_";
+    } else if ((family[0] >= '0') && (family[0] <= '9')) {
+        family.insert(0, 1, '_');
+    }
+}
+
+void
+OpenMetricsWriter::add(const Observation& obs) {
+    ostringstream value;
+    switch (obs.getType()) {
+    case Observation::STAT_INTEGER:
+        value << obs.getInteger().first;
+        break;
+    case Observation::STAT_FLOAT:
+        value.precision(numeric_limits<double>::max_digits10);
+        value << obs.getFloat().first;
+        break;
+    case Observation::STAT_DURATION:
+        value.precision(numeric_limits<double>::max_digits10);
+        value << chrono::duration<double>(obs.getDuration().first).count();
+        break;
+    default:
+        // The string statistics have no numeric value.
+        return;
+    }
+
+    string family;
+    string labels;
+    convertName(prefix_, obs.getName(), family, labels);
+    string& lines = families_[family];
+    lines += family;
+    if (!labels.empty()) {
+        lines += '{';
+        lines += labels;
+        lines += '}';
+    }
+    lines += ' ';
+    lines += value.str();
+    lines += '\n';
+}
+
+void
+OpenMetricsWriter::write(ostream& out) const {
+    for (auto const& family : families_) {
+        out << "# TYPE " << family.first << " unknown\n" << family.second;
+    }
+    out << "# EOF\n";
+}
+
+} // end of namespace isc::stats
+} // end of namespace isc
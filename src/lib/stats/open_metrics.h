@@ -0,0 +1,81 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPEN_METRICS_H
+#define OPEN_METRICS_H
+
+#include <stats/observation.h>
+
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace isc {
+namespace stats {
+
+/// @brief Writes statistics in the OpenMetrics text format.
+///
+/// The statistics are written directly as text, without building the
+/// @c isc::data::Element tree returned by the statistic-get-all command.
+/// Only the most recent sample of each statistic is written.
+///
+/// The statistic names are converted to metric family names and labels:
+/// each "context[index]" component becomes a part of the family name and
+/// a label, the other characters not allowed in a metric name are replaced
+/// with underscores. For instance, with the "kea_dhcp4" prefix,
+/// "subnet[1].pool[0].assigned-addresses" becomes:
+///
+/// @code
+/// kea_dhcp4_subnet_pool_assigned_addresses{subnet="1",pool="0"}
+/// @endcode
+///
+/// The samples of a family are written together as required by the format,
+/// under a "# TYPE" line with the unknown type because the statistics do
+/// not tell counters and gauges apart. The durations are written in
+/// seconds and the string statistics are skipped.
+class OpenMetricsWriter {
+public:
+
+    /// @brief Content type of the OpenMetrics text format.
+    static const char* CONTENT_TYPE;
+
+    /// @brief Constructor.
+    ///
+    /// @param prefix prefix of the metric family names, e.g. "kea_dhcp4".
+    explicit OpenMetricsWriter(const std::string& prefix);
+
+    /// @brief Adds the most recent sample of a statistic.
+    ///
+    /// @param obs statistic to add.
+    void add(const Observation& obs);
+
+    /// @brief Writes the added samples followed by the "# EOF" marker.
+    ///
+    /// @param out stream to which the metrics are written.
+    void write(std::ostream& out) const;
+
+    /// @brief Converts a statistic name to a metric family name and labels.
+    ///
+    /// @param prefix prefix of the family name.
+    /// @param name statistic name.
+    /// @param [out] family metric family name.
+    /// @param [out] labels labels without the braces, empty if none.
+    static void convertName(const std::string& prefix, const std::string& name,
+                            std::string& family, std::string& labels);
+
+private:
+
+    /// @brief Prefix of the metric family names.
+    std::string prefix_;
+
+    /// @brief Sample lines by metric family name.
+    std::map<std::string, std::string> families_;
+};
+
+} // end of namespace isc::stats
+} // end of namespace isc
+
+#endif // OPEN_METRICS_H
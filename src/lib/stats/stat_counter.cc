@@ -0,0 +1,52 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <stats/stat_counter.h>
+
+namespace {
+
+/// @brief Shard index of the next thread using a counter.
+std::atomic<size_t> next_shard(0);
+
+}
+
+namespace isc {
+namespace stats {
+
+const size_t StatCounter::SHARDS;
+
+StatCounter::StatCounter(const std::string& name) : shards_(), name_(name) {
+}
+
+int64_t
+StatCounter::getPending() const {
+    int64_t sum = 0;
+    for (auto const& shard : shards_) {
+        sum += shard.value_.load(std::memory_order_relaxed);
+    }
+    return (sum);
+}
+
+int64_t
+StatCounter::drain() {
+    int64_t sum = 0;
+    for (auto& shard : shards_) {
+        sum += shard.value_.exchange(0, std::memory_order_relaxed);
+    }
+    return (sum);
+}
+
+size_t
+StatCounter::getShard() {
+    // The threads are given the shards in turn on their first use.
+    thread_local size_t shard = next_shard.fetch_add(1) % SHARDS;
+    return (shard);
+}
+
+} // end of namespace isc::stats
+} // end of namespace isc
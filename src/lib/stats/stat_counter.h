@@ -0,0 +1,97 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef STAT_COUNTER_H
+#define STAT_COUNTER_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace isc {
+namespace stats {
+
+/// @brief Pre-registered integer statistic incremented without locking.
+///
+/// Incrementing a statistic by name with @c StatsMgr::addValue takes the
+/// global mutex of the statistics manager, looks the name up and records
+/// a sample. For the counters incremented for each packet this costs more
+/// than the increment itself. A counter is registered once with
+/// @c StatsMgr::registerCounter and the returned handle is incremented
+/// with @ref add.
+///
+/// The value is spread over a fixed number of shards, each thread adding
+/// to its own shard, so the threads do not contend on a cache line. The
+/// statistics manager drains the shards into the observation of the same
+/// name when the statistic is read, so at most one sample is recorded per
+/// read instead of one per increment.
+class StatCounter : public boost::noncopyable {
+public:
+
+    /// @brief Number of shards.
+    static const size_t SHARDS = 16;
+
+    /// @brief Constructor.
+    ///
+    /// @param name name of the statistic.
+    explicit StatCounter(const std::string& name);
+
+    /// @brief Returns the name of the statistic.
+    const std::string& getName() const {
+        return (name_);
+    }
+
+    /// @brief Adds a value to the counter.
+    ///
+    /// @param value value to add, 1 by default.
+    void add(int64_t value = 1) {
+        shards_[getShard()].value_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the sum of the values added since the last drain.
+    int64_t getPending() const;
+
+    /// @brief Takes the values added since the last drain.
+    ///
+    /// @return the sum of the values added since the last drain.
+    int64_t drain();
+
+private:
+
+    /// @brief Returns the shard index of the calling thread.
+    static size_t getShard();
+
+    /// @brief A shard padded to a cache line.
+    struct Shard {
+        /// @brief Constructor.
+        Shard() : value_(0) {
+        }
+
+        /// @brief The value.
+        std::atomic<int64_t> value_;
+
+        /// @brief Padding keeping consecutive values in distinct cache lines.
+        char padding_[64 - sizeof(std::atomic<int64_t>)];
+    };
+
+    /// @brief The shards.
+    std::array<Shard, SHARDS> shards_;
+
+    /// @brief Name of the statistic.
+    std::string name_;
+};
+
+/// @brief Pointer to a counter.
+typedef boost::shared_ptr<StatCounter> StatCounterPtr;
+
+} // end of namespace isc::stats
+} // end of namespace isc
+
+#endif // STAT_COUNTER_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -113,6 +113,103 @@ StatsMgr::addValue(const string& name, const string& value) {
     }
 }
 
+StatCounterPtr
+StatsMgr::registerCounter(const string& name) {
+    if (MultiThreadingMgr::instance().getMode()) {
+        lock_guard<mutex> lock(*mutex_);
+        return (registerCounterInternal(name));
+    } else {
+        return (registerCounterInternal(name));
+    }
+}
+
+StatCounterPtr
+StatsMgr::registerCounterInternal(const string& name) {
+    auto it = counters_.find(name);
+    if (it != counters_.end()) {
+        return (it->second);
+    }
+    StatCounterPtr counter = boost::make_shared<StatCounter>(name);
+    counters_[name] = counter;
+    return (counter);
+}
+
+LatencyHistogramPtr
+StatsMgr::registerHistogram(const string& name) {
+    if (MultiThreadingMgr::instance().getMode()) {
+        lock_guard<mutex> lock(*mutex_);
+        return (registerHistogramInternal(name));
+    } else {
+        return (registerHistogramInternal(name));
+    }
+}
+
+LatencyHistogramPtr
+StatsMgr::registerHistogramInternal(const string& name) {
+    auto it = histograms_.find(name);
+    if (it != histograms_.end()) {
+        return (it->second);
+    }
+    LatencyHistogramPtr histogram = boost::make_shared<LatencyHistogram>(name);
+    histograms_[name] = histogram;
+    return (histogram);
+}
+
+ConstElementPtr
+StatsMgr::getLatencies(const string& name) const {
+    if (MultiThreadingMgr::instance().getMode()) {
+        lock_guard<mutex> lock(*mutex_);
+        return (getLatenciesInternal(name));
+    } else {
+        return (getLatenciesInternal(name));
+    }
+}
+
+ConstElementPtr
+StatsMgr::getLatenciesInternal(const string& name) const {
+    ElementPtr map = Element::createMap();
+    for (auto const& it : histograms_) {
+        if (name.empty() || (it.first == name)) {
+            map->set(it.first, it.second->toElement());
+        }
+    }
+    return (map);
+}
+
+void
+StatsMgr::flushCounterInternal(const string& name) const {
+    auto it = counters_.find(name);
+    if (it == counters_.end()) {
+        return;
+    }
+    int64_t value = it->second->drain();
+    if (value == 0) {
+        return;
+    }
+    ObservationPtr obs = global_->get(name);
+    if (!obs) {
+        global_->add(boost::make_shared<Observation>(name, value));
+    } else if (obs->getType() == Observation::STAT_INTEGER) {
+        obs->addValue(value);
+    }
+    // A statistic of another type set by name shadows the counter.
+}
+
+void
+StatsMgr::flushCountersInternal() const {
+    for (auto const& it : counters_) {
+        flushCounterInternal(it.first);
+    }
+}
+
+void
+StatsMgr::dropCounterInternal(const string& name) {
+    auto it = counters_.find(name);
+    if (it != counters_.end()) {
+        it->second->drain();
+    }
+}
+
 ObservationPtr
 StatsMgr::getObservation(const string& name) const {
     if (MultiThreadingMgr::instance().getMode()) {
@@ -125,6 +222,7 @@ StatsMgr::getObservation(const string& name) const {
 
 ObservationPtr
 StatsMgr::getObservationInternal(const string& name) const {
+    flushCounterInternal(name);
     /// @todo: Implement contexts.
     // Currently we keep everything in a global context.
     return (global_->get(name));
@@ -159,6 +257,7 @@ StatsMgr::deleteObservation(const string& name) {
 
 bool
 StatsMgr::deleteObservationInternal(const string& name) {
+    dropCounterInternal(name);
     /// @todo: Implement contexts.
     // Currently we keep everything in a global context.
     return (global_->del(name));
@@ -328,6 +427,7 @@ StatsMgr::del(const string& name) {
 
 bool
 StatsMgr::delInternal(const string& name) {
+    dropCounterInternal(name);
     return (global_->del(name));
 }
 
@@ -343,6 +443,9 @@ StatsMgr::removeAll() {
 
 void
 StatsMgr::removeAllInternal() {
+    for (auto const& it : counters_) {
+        it.second->drain();
+    }
     global_->clear();
 }
 
@@ -378,9 +481,29 @@ StatsMgr::getAll() const {
 
 ConstElementPtr
 StatsMgr::getAllInternal() const {
+    flushCountersInternal();
     return (global_->getAll());
 }
 
+void
+StatsMgr::writeOpenMetrics(std::ostream& out, const string& prefix) const {
+    OpenMetricsWriter writer(prefix);
+    if (MultiThreadingMgr::instance().getMode()) {
+        lock_guard<mutex> lock(*mutex_);
+        addOpenMetricsInternal(writer);
+    } else {
+        addOpenMetricsInternal(writer);
+    }
+    // The text is written without holding the lock.
+    writer.write(out);
+}
+
+void
+StatsMgr::addOpenMetricsInternal(OpenMetricsWriter& writer) const {
+    flushCountersInternal();
+    global_->addOpenMetrics(writer);
+}
+
 void
 StatsMgr::resetAll() {
     if (MultiThreadingMgr::instance().getMode()) {
@@ -393,7 +516,11 @@ StatsMgr::resetAll() {
 
 void
 StatsMgr::resetAllInternal() {
+    flushCountersInternal();
     global_->resetAll();
+    for (auto const& it : histograms_) {
+        it.second->reset();
+    }
 }
 
 size_t
@@ -427,6 +554,7 @@ StatsMgr::count() const {
 
 size_t
 StatsMgr::countInternal() const {
+    flushCountersInternal();
     return (global_->size());
 }
 
@@ -530,6 +658,26 @@ StatsMgr::statisticGetAllHandler(const string& /*name*/,
     return (createAnswer(CONTROL_RESULT_SUCCESS, all_stats));
 }
 
+ConstElementPtr
+StatsMgr::statisticLatencyGetHandler(const string& /*name*/,
+                                     const ConstElementPtr& params) {
+    // The name is optional: all histograms are returned without it.
+    string name, error;
+    if (params && (params->getType() == Element::map) && params->contains("name")) {
+        if (!StatsMgr::getStatName(params, name, error)) {
+            return (createAnswer(CONTROL_RESULT_ERROR, error));
+        }
+        ConstElementPtr latencies = StatsMgr::instance().getLatencies(name);
+        if (name.empty() || latencies->empty()) {
+            return (createAnswer(CONTROL_RESULT_ERROR,
+                                 "No '" + name + "' latency histogram found"));
+        }
+        return (createAnswer(CONTROL_RESULT_SUCCESS, latencies));
+    }
+    return (createAnswer(CONTROL_RESULT_SUCCESS,
+                         StatsMgr::instance().getLatencies()));
+}
+
 ConstElementPtr
 StatsMgr::statisticResetAllHandler(const string& /*name*/,
                                    const ConstElementPtr& /*params*/) {
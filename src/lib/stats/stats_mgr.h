@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,6 +9,8 @@
 
 #include <stats/observation.h>
 #include <stats/context.h>
+#include <stats/latency_histogram.h>
+#include <stats/stat_counter.h>
 #include <boost/noncopyable.hpp>
 #include <boost/scoped_ptr.hpp>
 
@@ -44,6 +46,17 @@ namespace stats {
 /// this approach is how to extract data, but that will remain unsolvable
 /// until we get the control socket implementation.
 ///
+/// The integer statistics incremented on each packet can instead be
+/// registered as counters with @ref registerCounter. The returned
+/// @ref StatCounter is incremented without taking the mutex, and the
+/// accumulated value is added to the observation of the same name only
+/// when the statistic is read, reset or removed.
+///
+/// The latency distributions are recorded in the histograms registered
+/// with @ref registerHistogram. They are recorded without locking too
+/// but are kept apart from the statistics: they are returned by the
+/// statistic-latency-get command and are only reset with all statistics.
+///
 /// Statistics Manager does not use logging by design. The reasons are:
 /// - performance impact (logging every observation would degrade performance
 ///   significantly. While it's possible to log on sufficiently high debug
@@ -128,6 +141,36 @@ public:
     /// @throw InvalidStatType if statistic is not a string
     void addValue(const std::string& name, const std::string& value);
 
+    /// @brief Registers a counter for an integer statistic.
+    ///
+    /// The counter is incremented without locking and its value is
+    /// added to the statistic when the statistic is read. The statistic
+    /// is created by the first read after an increment, as it would be by
+    /// @ref addValue. Registering the same name again returns the same
+    /// counter. The counters stay registered when the statistics are
+    /// removed, so the handles held by the producers remain valid.
+    ///
+    /// @param name name of the statistic
+    /// @return the counter of the statistic
+    StatCounterPtr registerCounter(const std::string& name);
+
+    /// @brief Registers a latency histogram.
+    ///
+    /// Registering the same name again returns the same histogram. The
+    /// histograms stay registered when the statistics are removed.
+    ///
+    /// @param name name of the histogram
+    /// @return the histogram
+    LatencyHistogramPtr registerHistogram(const std::string& name);
+
+    /// @brief Returns the summaries of latency histograms.
+    ///
+    /// @param name name of the histogram, all histograms when empty
+    /// @return map of the summaries by histogram name, see
+    /// @ref LatencyHistogram::toElement, empty if there is no histogram
+    /// of this name
+    isc::data::ConstElementPtr getLatencies(const std::string& name = "") const;
+
     /// @brief Determines maximum age of samples.
     ///
     /// Specifies that statistic name should be stored not as a single value,
@@ -243,6 +286,15 @@ public:
     /// @return JSON structures representing all statistics
     isc::data::ConstElementPtr getAll() const;
 
+    /// @brief Writes all statistics in the OpenMetrics text format.
+    ///
+    /// Unlike @ref getAll the statistics are written directly as text
+    /// without building JSON structures.
+    ///
+    /// @param out stream to which the statistics are written
+    /// @param prefix prefix of the metric family names, e.g. "kea_dhcp4"
+    void writeOpenMetrics(std::ostream& out, const std::string& prefix) const;
+
     /// @}
 
     /// @brief Returns an observation.
@@ -259,6 +311,8 @@ public:
     ///
     /// Used in testing only. Production code should use @ref get() method
     /// when the value is dereferenced. Should be called in a thread safe context.
+    /// The value of the counter of the statistic, if any, is added to the
+    /// observation first.
     ///
     /// @param name name of the statistic
     /// @return Pointer to the Observation object
@@ -402,6 +456,24 @@ public:
     statisticGetAllHandler(const std::string& name,
                            const isc::data::ConstElementPtr& params);
 
+    /// @brief Handles statistic-latency-get command
+    ///
+    /// This method handles statistic-latency-get command, which returns
+    /// the summaries of the latency histograms. The name of a histogram
+    /// may be specified, all histograms are returned otherwise.
+    ///
+    /// Example params structure:
+    /// {
+    ///     "name": "pkt4-total-latency"
+    /// }
+    ///
+    /// @param name name of the command (ignored, should be "statistic-latency-get")
+    /// @param params optional structure containing a map that contains "name"
+    /// @return answer containing the summaries of the histograms
+    static isc::data::ConstElementPtr
+    statisticLatencyGetHandler(const std::string& name,
+                               const isc::data::ConstElementPtr& params);
+
     /// @brief Handles statistic-reset-all command
     ///
     /// This method handles statistic-reset-all command, which sets values of
@@ -717,6 +789,15 @@ private:
 
     /// @private
 
+    /// @brief Adds all statistics to an OpenMetrics writer.
+    ///
+    /// Should be called in a thread safe context.
+    ///
+    /// @param writer writer to which the statistics are added
+    void addOpenMetricsInternal(OpenMetricsWriter& writer) const;
+
+    /// @private
+
     /// @brief Utility method that attempts to extract statistic name
     ///
     /// This method attempts to extract statistic name from the params
@@ -776,9 +857,71 @@ private:
                                   uint32_t& max_samples,
                                   std::string& reason);
 
+    /// @private
+
+    /// @brief Registers a counter for an integer statistic.
+    ///
+    /// Should be called in a thread safe context.
+    ///
+    /// @param name name of the statistic.
+    /// @return the counter of the statistic.
+    StatCounterPtr registerCounterInternal(const std::string& name);
+
+    /// @private
+
+    /// @brief Registers a latency histogram.
+    ///
+    /// Should be called in a thread safe context.
+    ///
+    /// @param name name of the histogram.
+    /// @return the histogram.
+    LatencyHistogramPtr registerHistogramInternal(const std::string& name);
+
+    /// @private
+
+    /// @brief Returns the summaries of latency histograms.
+    ///
+    /// Should be called in a thread safe context.
+    ///
+    /// @param name name of the histogram, all histograms when empty.
+    /// @return map of the summaries by histogram name.
+    isc::data::ConstElementPtr getLatenciesInternal(const std::string& name) const;
+
+    /// @private
+
+    /// @brief Adds the value of the counter of a statistic to its observation.
+    ///
+    /// The observation is created if it does not exist. Should be called in
+    /// a thread safe context.
+    ///
+    /// @param name name of the statistic.
+    void flushCounterInternal(const std::string& name) const;
+
+    /// @private
+
+    /// @brief Adds the values of all counters to their observations.
+    ///
+    /// Should be called in a thread safe context.
+    void flushCountersInternal() const;
+
+    /// @private
+
+    /// @brief Discards the value of the counter of a statistic.
+    ///
+    /// Should be called in a thread safe context.
+    ///
+    /// @param name name of the statistic.
+    void dropCounterInternal(const std::string& name);
+
     /// @brief This is a global context. All statistics will initially be stored here.
     StatContextPtr global_;
 
+    /// @brief Registered counters by statistic name.
+    std::map<std::string, StatCounterPtr> counters_;
+
+    /// @brief Registered latency histograms by name.
+    std::map<std::string, LatencyHistogramPtr> histograms_;
+
     /// @brief The mutex used to protect internal state.
     const boost::scoped_ptr<std::mutex> mutex_;
 };
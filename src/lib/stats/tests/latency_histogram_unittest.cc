@@ -0,0 +1,146 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <stats/latency_histogram.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace isc::data;
+using namespace isc::stats;
+
+namespace {
+
+// Test checks that the buckets are contiguous and their bounds do not
+// exceed the relative error.
+TEST(LatencyHistogramTest, buckets) {
+    for (uint64_t value = 0; value < 32; ++value) {
+        EXPECT_EQ(value, LatencyHistogram::getBucket(value));
+        EXPECT_EQ(value, LatencyHistogram::getBucketUpperBound(value));
+    }
+    EXPECT_EQ(32, LatencyHistogram::getBucket(32));
+    EXPECT_EQ(32, LatencyHistogram::getBucket(33));
+    EXPECT_EQ(33, LatencyHistogram::getBucket(34));
+    EXPECT_EQ(33, LatencyHistogram::getBucketUpperBound(32));
+
+    for (size_t bucket = 1; bucket < LatencyHistogram::BUCKETS; ++bucket) {
+        uint64_t lower = LatencyHistogram::getBucketUpperBound(bucket - 1) + 1;
+        uint64_t upper = LatencyHistogram::getBucketUpperBound(bucket);
+        ASSERT_LE(lower, upper);
+        EXPECT_EQ(bucket, LatencyHistogram::getBucket(lower));
+        EXPECT_EQ(bucket, LatencyHistogram::getBucket(upper));
+        EXPECT_LE(upper - lower, lower / 16);
+    }
+
+    // The highest values are counted in the last bucket.
+    EXPECT_EQ(LatencyHistogram::BUCKETS - 1,
+              LatencyHistogram::getBucket(0xFFFFFFFFFFFFFFFFULL));
+}
+
+// Test checks the percentiles of the recorded latencies.
+TEST(LatencyHistogramTest, percentiles) {
+    LatencyHistogram histogram("alpha");
+    EXPECT_EQ("alpha", histogram.getName());
+    EXPECT_EQ(0, histogram.getCount());
+    EXPECT_EQ(0, histogram.getPercentile(50));
+
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+    EXPECT_EQ(1000, histogram.getCount());
+    EXPECT_EQ(1000, histogram.getMax());
+    EXPECT_EQ(500500, histogram.getSum());
+    EXPECT_EQ(1, histogram.getPercentile(0));
+    EXPECT_EQ(1000, histogram.getPercentile(100));
+
+    // The percentiles overestimate by less than 1/16.
+    uint64_t p50 = histogram.getPercentile(50);
+    EXPECT_GE(p50, 500);
+    EXPECT_LE(p50, 500 + 500 / 16);
+    uint64_t p99 = histogram.getPercentile(99);
+    EXPECT_GE(p99, 990);
+    EXPECT_LE(p99, 1000);
+
+    histogram.record(std::chrono::milliseconds(2));
+    EXPECT_EQ(2000, histogram.getMax());
+    // Negative durations are recorded as 0.
+    histogram.record(std::chrono::steady_clock::duration(-5));
+    EXPECT_EQ(0, histogram.getPercentile(0));
+
+    ConstElementPtr summary = histogram.toElement();
+    ASSERT_TRUE(summary);
+    ASSERT_TRUE(summary->get("count"));
+    EXPECT_EQ(1002, summary->get("count")->intValue());
+    EXPECT_EQ(2000, summary->get("max")->intValue());
+    ASSERT_TRUE(summary->get("mean"));
+    EXPECT_DOUBLE_EQ((500500.0 + 2000.0) / 1002, summary->get("mean")->doubleValue());
+    EXPECT_TRUE(summary->get("p50"));
+    EXPECT_TRUE(summary->get("p90"));
+    EXPECT_TRUE(summary->get("p99"));
+    EXPECT_TRUE(summary->get("p99.9"));
+
+    histogram.reset();
+    EXPECT_EQ(0, histogram.getCount());
+    EXPECT_EQ(0, histogram.getMax());
+    EXPECT_EQ(0, histogram.getSum());
+}
+
+// Test checks that the latencies of another histogram are merged.
+TEST(LatencyHistogramTest, merge) {
+    LatencyHistogram histogram("alpha");
+    LatencyHistogram other("beta");
+    for (uint64_t value = 1; value <= 500; ++value) {
+        histogram.record(value);
+        other.record(value + 500);
+    }
+    histogram.merge(other);
+    EXPECT_EQ(1000, histogram.getCount());
+    EXPECT_EQ(1000, histogram.getMax());
+    EXPECT_EQ(500500, histogram.getSum());
+    EXPECT_EQ(1, histogram.getPercentile(0));
+    EXPECT_EQ(1000, histogram.getPercentile(100));
+    uint64_t p50 = histogram.getPercentile(50);
+    EXPECT_GE(p50, 500);
+    EXPECT_LE(p50, 500 + 500 / 16);
+
+    // The other histogram is unchanged.
+    EXPECT_EQ(500, other.getCount());
+
+    // Merging an empty histogram changes nothing.
+    LatencyHistogram empty("gamma");
+    histogram.merge(empty);
+    EXPECT_EQ(1000, histogram.getCount());
+    EXPECT_EQ(1000, histogram.getMax());
+
+    // The merged latencies are cleared by a reset.
+    histogram.reset();
+    EXPECT_EQ(0, histogram.getCount());
+    EXPECT_EQ(0, histogram.getSum());
+}
+
+// Test checks that the latencies recorded by concurrent threads are all
+// counted.
+TEST(LatencyHistogramTest, threads) {
+    LatencyHistogram histogram("alpha");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.push_back(std::thread([&histogram, i]() {
+            for (uint64_t j = 0; j < 10000; ++j) {
+                histogram.record(i * 100 + j % 100);
+            }
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(40000, histogram.getCount());
+    EXPECT_EQ(399, histogram.getMax());
+}
+
+} // end of anonymous namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -443,6 +443,49 @@ TEST_F(ObservationTest, setAgeLimit) {
     }
 }
 
+// Checks that a count limit of one keeps only the current value and
+// that the samples survive changes of the limits.
+TEST_F(ObservationTest, noHistory) {
+    ASSERT_NO_THROW(a.setMaxSampleCount(1));
+    for (int64_t i = 0; i < 100; ++i) {
+        a.addValue(i);
+    }
+    ASSERT_EQ(1, a.getSize());
+    EXPECT_EQ(1234 + 4950, a.getInteger().first);
+
+    // Keeping more samples starts from the current value.
+    ASSERT_NO_THROW(a.setMaxSampleCount(3));
+    for (int64_t i = 1; i <= 5; ++i) {
+        a.setValue(i);
+    }
+    std::list<IntegerSample> samples = a.getIntegers();
+    ASSERT_EQ(3, samples.size());
+    int64_t expected = 5;
+    for (auto const& sample : samples) {
+        EXPECT_EQ(expected--, sample.first);
+    }
+
+    // Without a count limit the storage grows as needed.
+    ASSERT_NO_THROW(a.setMaxSampleAge(hours(1)));
+    for (int64_t i = 0; i < 50; ++i) {
+        a.setValue(i);
+    }
+    EXPECT_EQ(53, a.getSize());
+    EXPECT_EQ(49, a.getInteger().first);
+
+    // Restoring a count limit drops the oldest samples.
+    ASSERT_NO_THROW(a.setMaxSampleCount(2));
+    samples = a.getIntegers();
+    ASSERT_EQ(2, samples.size());
+    EXPECT_EQ(49, samples.front().first);
+    EXPECT_EQ(48, samples.back().first);
+
+    // Resetting keeps a single neutral sample.
+    a.reset();
+    ASSERT_EQ(1, a.getSize());
+    EXPECT_EQ(0, a.getInteger().first);
+}
+
 // Test checks whether we can get max_sample_age_ and max_sample_count_
 // properly.
 TEST_F(ObservationTest, getLimits) {
@@ -0,0 +1,90 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <stats/open_metrics.h>
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+using namespace isc::stats;
+using namespace std;
+
+namespace {
+
+/// @brief Converts a statistic name and returns the family and labels.
+///
+/// @param name statistic name.
+/// @return family followed by the labels in braces.
+string
+convert(const string& name) {
+    string family;
+    string labels;
+    OpenMetricsWriter::convertName("kea", name, family, labels);
+    return (family + "{" + labels + "}");
+}
+
+// Test checks that the statistic names are converted to metric family
+// names and labels.
+TEST(OpenMetricsWriterTest, convertName) {
+    EXPECT_EQ("kea_pkt4_received{}", convert("pkt4-received"));
+    EXPECT_EQ("kea_subnet_assigned_addresses{subnet=\"1\"}",
+              convert("subnet[1].assigned-addresses"));
+    EXPECT_EQ("kea_subnet_pool_assigned_nas{subnet=\"1\",pool=\"0\"}",
+              convert("subnet[1].pool[0].assigned-nas"));
+    // Dots in the index do not split the name.
+    EXPECT_EQ("kea_peer_sent{peer=\"192.0.2.1\"}",
+              convert("peer[192.0.2.1].sent"));
+    // The label values are escaped.
+    EXPECT_EQ("kea_ctx_x{ctx=\"a\\\"b\\\\c\"}", convert("ctx[a\"b\\c].x"));
+    // An index without a name gets a default label name.
+    EXPECT_EQ("kea_x{index=\"3\"}", convert("[3].x"));
+    // An unterminated bracket is part of the name.
+    EXPECT_EQ("kea_x_3{}", convert("x[3"));
+}
+
+// Test checks that the samples are grouped by family and the string
+// statistics are skipped.
+TEST(OpenMetricsWriterTest, write) {
+    OpenMetricsWriter writer("kea");
+    Observation a("subnet[1].assigned-addresses", static_cast<int64_t>(5));
+    Observation b("pkt4-received", static_cast<int64_t>(7));
+    Observation c("subnet[2].assigned-addresses", static_cast<int64_t>(-1));
+    Observation d("ratio", 0.5);
+    Observation e("delay", StatsDuration(std::chrono::milliseconds(1500)));
+    Observation f("name", "foo");
+    writer.add(a);
+    writer.add(b);
+    writer.add(c);
+    writer.add(d);
+    writer.add(e);
+    writer.add(f);
+
+    ostringstream out;
+    writer.write(out);
+    EXPECT_EQ("# TYPE kea_delay unknown\n"
+              "kea_delay 1.5\n"
+              "# TYPE kea_pkt4_received unknown\n"
+              "kea_pkt4_received 7\n"
+              "# TYPE kea_ratio unknown\n"
+              "kea_ratio 0.5\n"
+              "# TYPE kea_subnet_assigned_addresses unknown\n"
+              "kea_subnet_assigned_addresses{subnet=\"1\"} 5\n"
+              "kea_subnet_assigned_addresses{subnet=\"2\"} -1\n"
+              "# EOF\n", out.str());
+}
+
+// Test checks that an empty writer only writes the end marker.
+TEST(OpenMetricsWriterTest, empty) {
+    OpenMetricsWriter writer("kea");
+    ostringstream out;
+    writer.write(out);
+    EXPECT_EQ("# EOF\n", out.str());
+}
+
+} // end of anonymous namespace
@@ -0,0 +1,60 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <stats/stat_counter.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace isc::stats;
+
+namespace {
+
+// Test checks that the added values are accumulated until drained.
+TEST(StatCounterTest, addDrain) {
+    StatCounter counter("alpha");
+    EXPECT_EQ("alpha", counter.getName());
+    EXPECT_EQ(0, counter.getPending());
+
+    counter.add();
+    counter.add(5);
+    counter.add(-2);
+    EXPECT_EQ(4, counter.getPending());
+    EXPECT_EQ(4, counter.drain());
+    EXPECT_EQ(0, counter.getPending());
+    EXPECT_EQ(0, counter.drain());
+}
+
+// Test checks that no increment is lost when several threads add
+// concurrently, including while the counter is drained.
+TEST(StatCounterTest, threads) {
+    StatCounter counter("alpha");
+    const int threads = 2 * StatCounter::SHARDS + 1;
+    const int cycles = 10000;
+
+    int64_t drained = 0;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.push_back(std::thread([&counter, cycles] () {
+            for (int j = 0; j < cycles; ++j) {
+                counter.add();
+            }
+        }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        drained += counter.drain();
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    drained += counter.drain();
+    EXPECT_EQ(threads * cycles, drained);
+}
+
+} // end of anonymous namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -521,6 +521,144 @@ TEST_F(StatsMgrTest, removeAll) {
     EXPECT_FALSE(StatsMgr::instance().getObservation("delta"));
 }
 
+// Test checks that the value of a registered counter is added to the
+// statistic when the statistic is read.
+TEST_F(StatsMgrTest, counter) {
+    StatCounterPtr counter;
+    ASSERT_NO_THROW(counter = StatsMgr::instance().registerCounter("alpha"));
+    ASSERT_TRUE(counter);
+    EXPECT_EQ(counter, StatsMgr::instance().registerCounter("alpha"));
+
+    // The statistic does not exist until the counter was incremented.
+    EXPECT_EQ(0, StatsMgr::instance().count());
+    EXPECT_FALSE(StatsMgr::instance().getObservation("alpha"));
+
+    counter->add();
+    counter->add(2);
+    ObservationPtr alpha = StatsMgr::instance().getObservation("alpha");
+    ASSERT_TRUE(alpha);
+    EXPECT_EQ(3, alpha->getInteger().first);
+    EXPECT_EQ(0, counter->getPending());
+
+    // The counter adds to the value set by name and only one sample is
+    // recorded per read.
+    StatsMgr::instance().addValue("alpha", static_cast<int64_t>(10));
+    EXPECT_EQ(2, StatsMgr::instance().getSize("alpha"));
+    for (int i = 0; i < 5; ++i) {
+        counter->add();
+    }
+    ConstElementPtr all = StatsMgr::instance().getAll();
+    ASSERT_TRUE(all && all->get("alpha"));
+    EXPECT_EQ(18, alpha->getInteger().first);
+    EXPECT_EQ(3, StatsMgr::instance().getSize("alpha"));
+
+    // Resetting the statistic discards the pending value.
+    counter->add();
+    EXPECT_TRUE(StatsMgr::instance().reset("alpha"));
+    EXPECT_EQ(0, alpha->getInteger().first);
+
+    // Removing the statistic discards the pending value but the counter
+    // stays registered.
+    counter->add();
+    EXPECT_TRUE(StatsMgr::instance().del("alpha"));
+    EXPECT_FALSE(StatsMgr::instance().getObservation("alpha"));
+    counter->add(7);
+    EXPECT_NO_THROW(StatsMgr::instance().removeAll());
+    EXPECT_EQ(0, StatsMgr::instance().count());
+    counter->add(4);
+    EXPECT_EQ(1, StatsMgr::instance().count());
+    alpha = StatsMgr::instance().getObservation("alpha");
+    ASSERT_TRUE(alpha);
+    EXPECT_EQ(4, alpha->getInteger().first);
+}
+
+// Test checks that the latency histograms are registered, reported and
+// reset.
+TEST_F(StatsMgrTest, histogram) {
+    // The histograms registered by other tests are still registered.
+    StatsMgr::instance().resetAll();
+    LatencyHistogramPtr histogram;
+    ASSERT_NO_THROW(histogram = StatsMgr::instance().registerHistogram("alpha"));
+    ASSERT_TRUE(histogram);
+    EXPECT_EQ(histogram, StatsMgr::instance().registerHistogram("alpha"));
+    StatsMgr::instance().registerHistogram("beta");
+
+    histogram->record(10);
+    ConstElementPtr latencies = StatsMgr::instance().getLatencies();
+    ASSERT_TRUE(latencies);
+    EXPECT_EQ(2, latencies->size());
+    ASSERT_TRUE(latencies->get("alpha"));
+    EXPECT_EQ(1, latencies->get("alpha")->get("count")->intValue());
+    EXPECT_EQ(1, StatsMgr::instance().getLatencies("beta")->size());
+    EXPECT_EQ(0, StatsMgr::instance().getLatencies("gamma")->size());
+
+    // The histograms are not statistics.
+    EXPECT_EQ(0, StatsMgr::instance().count());
+
+    // The histograms are reset with all statistics and stay registered
+    // when the statistics are removed.
+    StatsMgr::instance().resetAll();
+    EXPECT_EQ(0, histogram->getCount());
+    StatsMgr::instance().removeAll();
+    EXPECT_EQ(2, StatsMgr::instance().getLatencies()->size());
+}
+
+// Test checks that the statistic-latency-get command returns one or all
+// latency histograms.
+TEST_F(StatsMgrTest, commandLatencyGet) {
+    StatsMgr::instance().resetAll();
+    StatsMgr::instance().registerHistogram("alpha")->record(5);
+    StatsMgr::instance().registerHistogram("beta");
+
+    int status_code;
+    ConstElementPtr rsp = StatsMgr::instance().statisticLatencyGetHandler(
+        "statistic-latency-get", ElementPtr());
+    ConstElementPtr rep = parseAnswer(status_code, rsp);
+    ASSERT_EQ(CONTROL_RESULT_SUCCESS, status_code);
+    ASSERT_TRUE(rep);
+    EXPECT_EQ(2, rep->size());
+
+    ElementPtr params = Element::createMap();
+    params->set("name", Element::create("alpha"));
+    rsp = StatsMgr::instance().statisticLatencyGetHandler("statistic-latency-get",
+                                                          params);
+    rep = parseAnswer(status_code, rsp);
+    ASSERT_EQ(CONTROL_RESULT_SUCCESS, status_code);
+    ASSERT_TRUE(rep && rep->get("alpha"));
+    EXPECT_EQ(1, rep->size());
+    EXPECT_EQ(5, rep->get("alpha")->get("max")->intValue());
+
+    params->set("name", Element::create("gamma"));
+    rsp = StatsMgr::instance().statisticLatencyGetHandler("statistic-latency-get",
+                                                          params);
+    rep = parseAnswer(status_code, rsp);
+    EXPECT_EQ(CONTROL_RESULT_ERROR, status_code);
+
+    params->set("name", Element::create(1));
+    rsp = StatsMgr::instance().statisticLatencyGetHandler("statistic-latency-get",
+                                                          params);
+    rep = parseAnswer(status_code, rsp);
+    EXPECT_EQ(CONTROL_RESULT_ERROR, status_code);
+}
+
+// Test checks that the statistics and the pending counter values are
+// written in the OpenMetrics text format.
+TEST_F(StatsMgrTest, writeOpenMetrics) {
+    StatsMgr::instance().setValue("subnet[1].assigned-addresses",
+                                  static_cast<int64_t>(12));
+    StatsMgr::instance().setValue("name", "foo");
+    StatCounterPtr counter = StatsMgr::instance().registerCounter("pkt4-received");
+    counter->add(3);
+
+    std::ostringstream out;
+    ASSERT_NO_THROW(StatsMgr::instance().writeOpenMetrics(out, "kea_dhcp4"));
+    EXPECT_EQ("# TYPE kea_dhcp4_pkt4_received unknown\n"
+              "kea_dhcp4_pkt4_received 3\n"
+              "# TYPE kea_dhcp4_subnet_assigned_addresses unknown\n"
+              "kea_dhcp4_subnet_assigned_addresses{subnet=\"1\"} 12\n"
+              "# EOF\n", out.str());
+}
+
 // This is a performance benchmark that checks how long does it take
 // to increment a single statistic million times.
 //
@@ -543,6 +681,26 @@ TEST_F(StatsMgrTest, DISABLED_performanceSingleAdd) {
               << isc::util::durationToText(dur) << std::endl;
 }
 
+// This is a performance benchmark that checks how long does it take
+// to increment a single registered counter million times.
+TEST_F(StatsMgrTest, DISABLED_performanceSingleCounterAdd) {
+    StatsMgr::instance().removeAll();
+
+    uint32_t cycles = 1000000;
+    StatCounterPtr counter = StatsMgr::instance().registerCounter("metric1");
+
+    auto before = SampleClock::now();
+    for (uint32_t i = 0; i < cycles; ++i) {
+        counter->add();
+    }
+    auto after = SampleClock::now();
+
+    auto dur = after - before;
+
+    std::cout << "Incrementing a single counter " << cycles << " times took: "
+              << isc::util::durationToText(dur) << std::endl;
+}
+
 // This is a performance benchmark that checks how long does it take
 // to set absolute value of a single statistic million times.
 //
@@ -390,8 +390,7 @@ TcpConnection::socketReadCallback(TcpRequestPtr request,
                   TCP_DATA_RECEIVED)
             .arg(length)
             .arg(getRemoteEndpointAddressAsText());
-        WireData input_data(input_buf_.begin(), input_buf_.begin() + length);
-        next_request = postData(request, input_data);
+        next_request = postData(request, input_buf_.data(), length);
     }
 
     // Start next read.
@@ -399,48 +398,49 @@ TcpConnection::socketReadCallback(TcpRequestPtr request,
 }
 
 TcpRequestPtr
-TcpConnection::postData(TcpRequestPtr request, WireData& input_data) {
-    size_t bytes_left = 0;
-    size_t length = input_data.size();
-    if (length) {
-        // Add data to the current request.
-        size_t bytes_used = request->postBuffer(static_cast<void*>(input_data.data()), length);
-        // Remove bytes used.
-        bytes_left = length - bytes_used;
-        input_data.erase(input_data.begin(), input_data.begin() + length);
-    }
+TcpConnection::postData(TcpRequestPtr request, const uint8_t* data,
+                        size_t length) {
+    for (;;) {
+        if (length) {
+            // Add data to the current request.
+            size_t bytes_used = request->postBuffer(static_cast<const void*>(data),
+                                                    length);
+            // Skip bytes used.
+            data += bytes_used;
+            length -= bytes_used;
+        }
 
-    if (request->needData()) {
-        // Current request is incomplete and we're out of data
-        // return the incomplete request and we'll read again.
-        return (request);
-    }
+        if (request->needData()) {
+            // Current request is incomplete and we're out of data
+            // return the incomplete request and we'll read again.
+            return (request);
+        }
 
-    try {
-        LOG_DEBUG(tcp_logger, isc::log::DBGLVL_TRACE_BASIC,
-                  TCP_CLIENT_REQUEST_RECEIVED)
-                .arg(getRemoteEndpointAddressAsText());
+        try {
+            LOG_DEBUG(tcp_logger, isc::log::DBGLVL_TRACE_BASIC,
+                      TCP_CLIENT_REQUEST_RECEIVED)
+                    .arg(getRemoteEndpointAddressAsText());
 
-        // Request complete, stop the timer.
-        idle_timer_.cancel();
+            // Request complete, stop the timer.
+            idle_timer_.cancel();
 
-        // Process the completed request.
-        requestReceived(request);
-    } catch (const std::exception& ex) {
-        LOG_ERROR(tcp_logger, TCP_REQUEST_RECEIVED_FAILED)
-                .arg(getRemoteEndpointAddressAsText())
-                .arg(ex.what());
-    }
+            // Process the completed request.
+            requestReceived(request);
+        } catch (const std::exception& ex) {
+            LOG_ERROR(tcp_logger, TCP_REQUEST_RECEIVED_FAILED)
+                    .arg(getRemoteEndpointAddressAsText())
+                    .arg(ex.what());
+        }
+
+        // Create a new, empty request.
+        request = createRequest();
+        if (!length) {
+            return (request);
+        }
 
-    // Create a new, empty request.
-    request = createRequest();
-    if (bytes_left) {
-        // The input buffer spanned messages. Recurse to post the remainder to the
+        // The input buffer spanned messages. Post the remainder to the
         // new request.
-        request = postData(request, input_data);
     }
-
-    return (request);
 }
 
 void
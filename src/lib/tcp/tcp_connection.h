@@ -1,4 +1,4 @@
-// Copyright (C) 2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2022-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -260,14 +260,20 @@ public:
     /// If the request is still incomplete, we return it and wait for more
     /// data to post.  Otherwise, the request is complete and it is passed into
     /// @ref TcpConnection::requestReceived() to be processed.  Upon return from
-    /// that, a new request is created and returned to be used for the next
-    /// read cycle.
+    /// that, a new request is created and the rest of the data, which can
+    /// hold any number of requests, is posted to it. The last request is
+    /// returned to be used for the next read cycle.
+    ///
+    /// The data is not copied so it can be the input buffer of the
+    /// connection.
     ///
     /// @param request request to which data should be posted.
-    /// @param input_data raw data to post.
+    /// @param data pointer to the raw data to post.
+    /// @param length length of the raw data.
     ///
     /// @return Pointer to the request to use for the next read.
-    TcpRequestPtr postData(TcpRequestPtr request, WireData& input_data);
+    TcpRequestPtr postData(TcpRequestPtr request, const uint8_t* data,
+                           size_t length);
 
     /// @brief Processes a request once it has been completely received.
     ///
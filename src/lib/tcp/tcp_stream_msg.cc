@@ -1,4 +1,4 @@
-// Copyright (C) 2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2022-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -58,6 +58,8 @@ TcpStreamRequest::postBuffer(const void* buf, const size_t nbytes) {
             uint16_t len = static_cast<unsigned int>(cp[0]) << 8;
             len |= static_cast<unsigned int>(cp[1]);
             expected_size_ = len + sizeof(len);
+            // Allocate the whole message at once.
+            wire_data_.reserve(expected_size_);
         }
     }
 
@@ -90,7 +92,7 @@ void TcpStreamRequest::unpack() {
         isc_throw(Unexpected, "Request is malformed, too short");
     }
 
-    request_ = std::vector<uint8_t>(wire_data_.begin() + sizeof(uint16_t), wire_data_.end());
+    request_size_ = wire_data_.size() - sizeof(uint16_t);
 }
 
 void
@@ -116,6 +118,7 @@ TcpStreamResponse::appendResponseData(const std::string& str) {
 void
 TcpStreamResponse::pack() {
     wire_data_.clear();
+    wire_data_.reserve(response_.size() + sizeof(uint16_t));
     // Prepend the length of the request.
     uint16_t size = static_cast<uint16_t>(response_.size());
     wire_data_.push_back(static_cast<uint8_t>((size & 0xff00U) >> 8));
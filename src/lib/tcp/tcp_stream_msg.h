@@ -1,4 +1,4 @@
-// Copyright (C) 2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2022-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -25,7 +25,7 @@ namespace tcp {
 class TcpStreamRequest : public TcpRequest {
 public:
     /// @brief Constructor.
-    TcpStreamRequest() : expected_size_(0) {
+    TcpStreamRequest() : expected_size_(0), request_size_(0) {
     }
 
     /// @brief Destructor
@@ -51,41 +51,49 @@ public:
     /// @return Textual representation of the input buffer.
     virtual std::string logFormatRequest(const size_t limit = 0) const;
 
-    /// @brief Unpacks the wire data into a string request.
+    /// @brief Unpacks the wire data into a request.
+    ///
+    /// The request is not copied: it is the part of the wire data
+    /// following the length.
     virtual void unpack();
 
     /// @brief Returns size of the unpacked request.
     size_t getRequestSize() const {
-        return (request_.size());
+        return (request_size_);
     }
 
     /// @brief Returns pointer to the first byte of the unpacked request data.
     ///
+    /// With @ref getRequestSize it gives the request without copying it.
+    ///
     /// @return Constant raw pointer to the data.
     /// @throw InvalidOperation if request data is empty (i.e. getRequestSize() == 0).
     const uint8_t* getRequest() const {
-        if (request_.empty()) {
+        if (!request_size_) {
             isc_throw(InvalidOperation, "TcpStreamRequest::getRequest()"
                                         " - cannot access empty request");
         }
 
-        return (request_.data());
+        return (wire_data_.data() + sizeof(uint16_t));
     }
 
     /// @brief Fetches the unpacked request as a string.
     ///
     /// @return String containing the unpacked contents.
     std::string getRequestString() const {
-        return (std::string(request_.begin(), request_.end()));
+        if (!request_size_) {
+            return (std::string());
+        }
+        return (std::string(reinterpret_cast<const char*>(getRequest()),
+                            request_size_));
     };
 
-protected:
-    /// @brief Unpacked request content
-    std::vector<uint8_t> request_;
-
 private:
     /// @brief Expected size of the current message.
     size_t expected_size_;
+
+    /// @brief Size of the unpacked request.
+    size_t request_size_;
 };
 
 /// @brief Pointer to a TcpStreamRequest.
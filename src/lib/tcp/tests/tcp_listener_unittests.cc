@@ -12,6 +12,7 @@
 
 #include <gtest/gtest.h>
 
+#include <list>
 #include <sstream>
 
 using namespace boost::asio::ip;
@@ -600,4 +601,93 @@ TEST(TcpStreamRequst, postBufferTest) {
     }
 }
 
+/// @brief Connection collecting the received requests.
+class TcpCollectConnection : public TcpConnection {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param io_service IO service to be used by the connection.
+    /// @param connection_pool Connection pool in which the connection is
+    /// stored.
+    TcpCollectConnection(IOService& io_service,
+                         TcpConnectionPool& connection_pool)
+        : TcpConnection(io_service, TcpConnectionAcceptorPtr(),
+                        TlsContextPtr(), connection_pool,
+                        TcpConnectionAcceptorCallback(),
+                        TcpConnectionFilterCallback(), IDLE_TIMEOUT) {
+    }
+
+    /// @brief Creates a new empty request ready to receive data.
+    virtual TcpRequestPtr createRequest() {
+        return (TcpStreamRequestPtr(new TcpStreamRequest()));
+    }
+
+    /// @brief Collects a completely received request.
+    ///
+    /// @param request Request to collect.
+    virtual void requestReceived(TcpRequestPtr request) {
+        TcpStreamRequestPtr stream_req =
+            boost::dynamic_pointer_cast<TcpStreamRequest>(request);
+        ASSERT_TRUE(stream_req);
+        stream_req->unpack();
+        requests_.push_back(stream_req->getRequestString());
+    }
+
+    /// @brief Determines behavior after a response has been sent.
+    ///
+    /// @return Always true.
+    virtual bool responseSent(TcpResponsePtr) {
+        return (true);
+    }
+
+    /// @brief Collected requests.
+    std::list<std::string> requests_;
+};
+
+// Verifies that all the requests of a read are posted.
+TEST(TcpConnection, postDataMultipleRequests) {
+    IOService io_service;
+    TcpConnectionPool connection_pool;
+    TcpCollectConnection connection(io_service, connection_pool);
+
+    // Three messages and the beginning of a fourth one.
+    std::vector<uint8_t> buffer = {
+         0x00, 0x04, 0x31, 0x32, 0x33, 0x34,
+         0x00, 0x02, 0x35, 0x36,
+         0x00, 0x03, 0x37, 0x38, 0x39,
+         0x00, 0x02, 0x30
+    };
+    TcpRequestPtr request = connection.createRequest();
+    request = connection.postData(request, buffer.data(), buffer.size());
+    ASSERT_TRUE(request);
+    EXPECT_TRUE(request->needData());
+    std::list<std::string> expected = { "1234", "56", "789" };
+    EXPECT_EQ(expected, connection.requests_);
+
+    // The end of the fourth message.
+    std::vector<uint8_t> end = { 0x31 };
+    request = connection.postData(request, end.data(), end.size());
+    ASSERT_TRUE(request);
+    EXPECT_TRUE(request->needData());
+    expected.push_back("01");
+    EXPECT_EQ(expected, connection.requests_);
+}
+
+// Verifies that the unpacked request is the wire data without the length.
+TEST(TcpStreamRequst, unpack) {
+    TcpStreamRequest request;
+    std::vector<uint8_t> buffer = { 0x00, 0x03, 0x31, 0x32, 0x33 };
+    EXPECT_EQ(buffer.size(), request.postBuffer(buffer.data(), buffer.size()));
+    ASSERT_FALSE(request.needData());
+    EXPECT_EQ(0, request.getRequestSize());
+    EXPECT_THROW(request.getRequest(), isc::InvalidOperation);
+    EXPECT_EQ("", request.getRequestString());
+
+    ASSERT_NO_THROW(request.unpack());
+    ASSERT_EQ(3, request.getRequestSize());
+    EXPECT_EQ(request.getWireData() + 2, request.getRequest());
+    EXPECT_EQ("123", request.getRequestString());
+}
+
 }
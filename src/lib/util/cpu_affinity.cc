@@ -0,0 +1,150 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <util/cpu_affinity.h>
+#include <util/strutil.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+#include <pthread.h>
+#include <sched.h>
+
+using namespace std;
+
+namespace isc {
+namespace util {
+
+namespace {
+
+/// @brief Parses a CPU number.
+///
+/// @param text The CPU number.
+/// @param cpus The CPU list for error messages.
+/// @return The CPU number.
+/// @throw BadValue if the text is not a valid CPU number.
+unsigned
+parseCpu(const string& text, const string& cpus) {
+    if (text.empty() ||
+        (text.find_first_not_of("0123456789") != string::npos)) {
+        isc_throw(BadValue, "invalid CPU '" << text << "' in CPU list '"
+                  << cpus << "'");
+    }
+    unsigned cpu = 0;
+    try {
+        cpu = boost::lexical_cast<unsigned>(text);
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(BadValue, "invalid CPU '" << text << "' in CPU list '"
+                  << cpus << "'");
+    }
+#if defined(OS_LINUX)
+    if (cpu >= CPU_SETSIZE) {
+        isc_throw(BadValue, "CPU " << cpu << " in CPU list '" << cpus
+                  << "' is greater than the maximum " << (CPU_SETSIZE - 1));
+    }
+#endif
+    return (cpu);
+}
+
+} // end of anonymous namespace
+
+bool
+isCpuAffinitySupported() {
+#if defined(OS_LINUX)
+    return (true);
+#else
+    return (false);
+#endif
+}
+
+CpuList
+parseCpuList(const string& text) {
+    CpuList cpus;
+    string trimmed = str::trim(text);
+    if (trimmed.empty()) {
+        return (cpus);
+    }
+    for (auto const& token : str::tokens(trimmed, ",")) {
+        string range = str::trim(token);
+        size_t dash = range.find('-');
+        if (dash == string::npos) {
+            cpus.push_back(parseCpu(range, text));
+            continue;
+        }
+        unsigned first = parseCpu(str::trim(range.substr(0, dash)), text);
+        unsigned last = parseCpu(str::trim(range.substr(dash + 1)), text);
+        if (first > last) {
+            isc_throw(BadValue, "invalid CPU range '" << range
+                      << "' in CPU list '" << text << "'");
+        }
+        for (unsigned cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    sort(cpus.begin(), cpus.end());
+    cpus.erase(unique(cpus.begin(), cpus.end()), cpus.end());
+    return (cpus);
+}
+
+string
+cpuListToText(const CpuList& cpus) {
+    ostringstream s;
+    for (size_t i = 0; i < cpus.size(); ) {
+        size_t j = i;
+        while ((j + 1 < cpus.size()) && (cpus[j + 1] == cpus[j] + 1)) {
+            ++j;
+        }
+        if (i != 0) {
+            s << ",";
+        }
+        s << cpus[i];
+        if (j != i) {
+            s << "-" << cpus[j];
+        }
+        i = j + 1;
+    }
+    return (s.str());
+}
+
+CpuList
+getAvailableCpus() {
+    CpuList cpus;
+#if defined(OS_LINUX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return (cpus);
+}
+
+bool
+setThreadCpuAffinity(unsigned cpu) {
+#if defined(OS_LINUX)
+    if (cpu >= CPU_SETSIZE) {
+        return (false);
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0);
+#else
+    static_cast<void>(cpu);
+    return (false);
+#endif
+}
+
+} // namespace util
+} // namespace isc
@@ -0,0 +1,62 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef CPU_AFFINITY_H
+#define CPU_AFFINITY_H
+
+#include <exceptions/exceptions.h>
+
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace util {
+
+/// @brief Type of CPU lists.
+///
+/// A CPU list holds CPU numbers in increasing order without duplicates.
+typedef std::vector<unsigned> CpuList;
+
+/// @brief Checks if the threads can be bound to CPUs.
+///
+/// @return true on Linux, false on other systems.
+bool isCpuAffinitySupported();
+
+/// @brief Parses a CPU list.
+///
+/// The CPU list is given in the format used by the Linux kernel and the
+/// taskset command, e.g. "0-3,8,10-11". An empty string gives an empty
+/// list.
+///
+/// @param text The CPU list.
+/// @return The parsed CPU list.
+/// @throw BadValue if the text is not a valid CPU list.
+CpuList parseCpuList(const std::string& text);
+
+/// @brief Returns the textual representation of a CPU list.
+///
+/// @param cpus The CPU list.
+/// @return The CPU list in the format accepted by @ref parseCpuList.
+std::string cpuListToText(const CpuList& cpus);
+
+/// @brief Returns the CPUs the process is allowed to run on.
+///
+/// @return The CPU list, empty when CPU affinity is not supported.
+CpuList getAvailableCpus();
+
+/// @brief Binds the calling thread to a CPU.
+///
+/// The thread is bound before it allocates its resources so that the
+/// memory pages it touches first are taken from the local NUMA node.
+///
+/// @param cpu The CPU number.
+/// @return true if the thread was bound, false otherwise.
+bool setThreadCpuAffinity(unsigned cpu);
+
+} // namespace util
+} // namespace isc
+
+#endif // CPU_AFFINITY_H
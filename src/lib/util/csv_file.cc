@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -31,21 +31,30 @@ CSVRow::parse(const std::string& line) {
     size_t sep_pos = 0;
     size_t prev_pos = 0;
     size_t len = 0;
+    size_t count = 0;
 
-    // In case someone is reusing the row.
-    values_.clear();
+    // In case someone is reusing the row, the values are assigned in
+    // place so their storage is reused.
+    auto set_value = [this, &line, &count](size_t pos, size_t length) {
+        if (count < values_.size()) {
+            values_[count].assign(line, pos, length);
+        } else {
+            values_.push_back(line.substr(pos, length));
+        }
+        ++count;
+    };
 
     // Iterate over line, splitting on separators.
     while (prev_pos < line.size()) {
         // Find the next separator.
-        sep_pos = line.find_first_of(separator_, prev_pos);
+        sep_pos = line.find(separator_[0], prev_pos);
         if (sep_pos == std::string::npos) {
             break;
         }
 
         // Extract the value for the previous column.
         len = sep_pos - prev_pos;
-        values_.push_back(line.substr(prev_pos, len));
+        set_value(prev_pos, len);
 
         // Move past the separator.
         prev_pos = sep_pos + 1;
@@ -53,10 +62,11 @@ CSVRow::parse(const std::string& line) {
 
     // Extract the last column.
     len = line.size() - prev_pos;
-    values_.push_back(line.substr(prev_pos, len));
+    set_value(prev_pos, len);
+    values_.resize(count);
 }
 
-std::string
+const std::string&
 CSVRow::readAt(const size_t at) const {
     checkIndex(at);
     return (values_[at]);
@@ -69,15 +79,28 @@ CSVRow::readAtEscaped(const size_t at) const {
 
 std::string
 CSVRow::render() const {
-    std::ostringstream s;
+    std::string s;
+    s.reserve(getRenderedSize());
     for (size_t i = 0; i < values_.size(); ++i) {
         // Do not put separator before the first value.
         if (i > 0) {
-            s << separator_;
+            s += separator_;
         }
-        s << values_[i];
+        s += values_[i];
+    }
+    return (s);
+}
+
+size_t
+CSVRow::getRenderedSize() const {
+    if (values_.empty()) {
+        return (0);
+    }
+    size_t size = (values_.size() - 1) * separator_.size();
+    for (auto const& value : values_) {
+        size += value.size();
     }
-    return (s.str());
+    return (size);
 }
 
 void
@@ -112,7 +135,7 @@ CSVRow::checkIndex(const size_t at) const {
 }
 
 CSVFile::CSVFile(const std::string& filename)
-    : filename_(filename), fs_(), cols_(0), read_msg_() {
+    : filename_(filename), fs_(), cols_(0), read_msg_(), line_() {
 }
 
 CSVFile::~CSVFile() {
@@ -269,8 +292,10 @@ CSVFile::next(CSVRow& row, const bool skip_validation) {
         return (false);
     }
 
-    // Get the next non-blank line from the file.
-    std::string line;
+    // Get the next non-blank line from the file. The buffer is reused
+    // from one line to the next.
+    std::string& line = line_;
+    line.clear();
     while (fs_->good() && line.empty()) {
         std::getline(*fs_, line);
     }
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -92,7 +92,9 @@ public:
     /// to the @c values_ private container. These values can be retrieved
     /// from the container by calling @c CSVRow::readAt function.
     ///
-    /// This function is exception-free.
+    /// This function is exception-free. When the row is reused to parse
+    /// the lines of a file the storage of the values is reused as well,
+    /// so the parsing does not allocate memory once the row is warm.
     ///
     /// @param line String holding a row of comma separated values.
     void parse(const std::string& line);
@@ -102,12 +104,13 @@ public:
     /// @param at Index of the value in the container. The values are indexed
     /// from 0, where 0 corresponds to the left-most value in the CSV file row.
     ///
-    /// @return Value at specified index in the text form.
+    /// @return Reference to the value at specified index in the text form,
+    /// valid until the row is modified.
     ///
     /// @throw CSVFileError if the index is out of range. The number of elements
     /// being held by the container can be obtained using
     /// @c CSVRow::getValuesCount.
-    std::string readAt(const size_t at) const;
+    const std::string& readAt(const size_t at) const;
 
     /// @brief Retrieves a value from the internal container, free of escaped
     /// characters.
@@ -156,7 +159,7 @@ public:
     T readAndConvertAt(const size_t at) const {
         T cast_value;
         try {
-            cast_value = boost::lexical_cast<T>(readAt(at).c_str());
+            cast_value = boost::lexical_cast<T>(readAt(at));
 
         } catch (const boost::bad_lexical_cast& ex) {
             isc_throw(CSVFileError, ex.what());
@@ -251,10 +254,17 @@ public:
     /// @brief Equality operator.
     ///
     /// Two CSV rows are equal when their string representation is equal. This
-    /// includes the order of fields, separator etc.
+    /// includes the order of fields, separator etc. The representations are
+    /// built only when their lengths are equal.
     ///
     /// @param other Object to compare to.
     bool operator==(const CSVRow& other) const {
+        if (getRenderedSize() != other.getRenderedSize()) {
+            return (false);
+        }
+        if ((separator_ == other.separator_) && (values_ == other.values_)) {
+            return (true);
+        }
         return (render() == other.render());
     }
 
@@ -265,7 +275,7 @@ public:
     ///
     /// @param other Object to compare to.
     bool operator!=(const CSVRow& other) const {
-        return (render() != other.render());
+        return (!(*this == other));
     }
 
     /// @brief Returns a copy of a string with special characters escaped
@@ -309,6 +319,9 @@ private:
     /// @throw CSVFileError if specified index is not in range.
     void checkIndex(const size_t at) const;
 
+    /// @brief Returns the length of the text representation of the row.
+    size_t getRenderedSize() const;
+
     /// @brief Separator character specified in the constructor.
     ///
     /// @note Separator is held as a string object (one character long),
@@ -567,6 +580,9 @@ private:
 
     /// @brief Holds last error during row reading or validation.
     std::string read_msg_;
+
+    /// @brief Buffer of the last line read by @c next.
+    std::string line_;
 };
 
 } // namespace isc::util
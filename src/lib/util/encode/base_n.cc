@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -25,6 +25,7 @@
 #include <boost/math/common_factor.hpp>
 #endif
 
+#include <cctype>
 #include <stdint.h>
 #include <stdexcept>
 #include <iterator>
@@ -457,16 +458,179 @@ typedef
 transform_width<binary_from_base16<DecodeNormalizer>, 8, 4> base16_decoder;
 typedef BaseNTransformer<4, '0', base16_encoder, base16_decoder>
 Base16Transformer;
+
+// The transformers above handle one bit group per iterator step, which is
+// slow for the long texts of the lease files and of the JSON commands.
+// The functions below encode and decode the most common texts with lookup
+// tables, i.e. texts without spaces for the decoding; the other texts are
+// left to the transformers so the checks and the errors are unchanged.
+
+// Characters of the base16 and base64 encodings.
+const char BASE16_CHARS[] = "0123456789ABCDEF";
+const char BASE64_CHARS[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Decoding table: the value of a character or -1 if it is not in the base.
+class DecodeTable {
+public:
+    DecodeTable(const char* chars, size_t size, bool any_case) {
+        for (size_t i = 0; i < sizeof(values_); ++i) {
+            values_[i] = -1;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            const uint8_t ch = static_cast<uint8_t>(chars[i]);
+            values_[ch] = static_cast<int8_t>(i);
+            if (any_case) {
+                values_[tolower(ch)] = static_cast<int8_t>(i);
+            }
+        }
+    }
+    int8_t operator[](char ch) const {
+        return (values_[static_cast<uint8_t>(ch)]);
+    }
+private:
+    int8_t values_[256];
+};
+
+// The tables are built at first use, as encoding functions may be called
+// during the static initialization.
+const DecodeTable&
+base16Values() {
+    static const DecodeTable table(BASE16_CHARS, 16, true);
+    return (table);
+}
+
+const DecodeTable&
+base64Values() {
+    static const DecodeTable table(BASE64_CHARS, 64, false);
+    return (table);
+}
+
+string
+fastEncodeBase16(const vector<uint8_t>& binary) {
+    string result(binary.size() * 2, '0');
+    char* out = &result[0];
+    for (auto byte : binary) {
+        *out++ = BASE16_CHARS[byte >> 4];
+        *out++ = BASE16_CHARS[byte & 0x0f];
+    }
+    return (result);
+}
+
+// Returns false when the text must be decoded by the transformer.
+bool
+fastDecodeBase16(const string& input, vector<uint8_t>& result) {
+    const size_t size = input.size();
+    if ((size % 2) != 0) {
+        return (false);
+    }
+    const DecodeTable& values = base16Values();
+    vector<uint8_t> binary(size / 2);
+    for (size_t i = 0; i < size; i += 2) {
+        const int8_t high = values[input[i]];
+        const int8_t low = values[input[i + 1]];
+        if ((high < 0) || (low < 0)) {
+            return (false);
+        }
+        binary[i / 2] = static_cast<uint8_t>((high << 4) | low);
+    }
+    result.swap(binary);
+    return (true);
+}
+
+string
+fastEncodeBase64(const vector<uint8_t>& binary) {
+    const size_t size = binary.size();
+    string result(((size + 2) / 3) * 4, BASE_PADDING_CHAR);
+    char* out = &result[0];
+    size_t i = 0;
+    for (; i + 3 <= size; i += 3) {
+        const uint32_t group = (binary[i] << 16) | (binary[i + 1] << 8) |
+            binary[i + 2];
+        *out++ = BASE64_CHARS[(group >> 18) & 0x3f];
+        *out++ = BASE64_CHARS[(group >> 12) & 0x3f];
+        *out++ = BASE64_CHARS[(group >> 6) & 0x3f];
+        *out++ = BASE64_CHARS[group & 0x3f];
+    }
+    if (i < size) {
+        // The last 1 or 2 bytes, followed by padding characters.
+        uint32_t group = binary[i] << 16;
+        if (i + 1 < size) {
+            group |= binary[i + 1] << 8;
+        }
+        *out++ = BASE64_CHARS[(group >> 18) & 0x3f];
+        *out++ = BASE64_CHARS[(group >> 12) & 0x3f];
+        if (i + 1 < size) {
+            *out = BASE64_CHARS[(group >> 6) & 0x3f];
+        }
+    }
+    return (result);
+}
+
+// Returns false when the text must be decoded by the transformer.
+bool
+fastDecodeBase64(const string& input, vector<uint8_t>& result) {
+    const size_t size = input.size();
+    if ((size % 4) != 0) {
+        return (false);
+    }
+    size_t padchars = 0;
+    if ((size > 0) && (input[size - 1] == BASE_PADDING_CHAR)) {
+        ++padchars;
+        if (input[size - 2] == BASE_PADDING_CHAR) {
+            ++padchars;
+        }
+    }
+    const DecodeTable& values = base64Values();
+    vector<uint8_t> binary;
+    binary.reserve((size / 4) * 3);
+    for (size_t i = 0; i < size; i += 4) {
+        // The padding characters are decoded as zeros.
+        const bool last = (i + 4 == size);
+        uint32_t group = 0;
+        for (size_t j = 0; j < 4; ++j) {
+            int8_t value = 0;
+            if (!last || (j < 4 - padchars)) {
+                value = values[input[i + j]];
+                if (value < 0) {
+                    return (false);
+                }
+            }
+            group = (group << 6) | value;
+        }
+        binary.push_back(static_cast<uint8_t>(group >> 16));
+        if (last && (padchars == 2)) {
+            if ((group & 0xffff) != 0) {
+                // Non canonical padding.
+                return (false);
+            }
+            break;
+        }
+        binary.push_back(static_cast<uint8_t>(group >> 8));
+        if (last && (padchars == 1)) {
+            if ((group & 0xff) != 0) {
+                // Non canonical padding.
+                return (false);
+            }
+            break;
+        }
+        binary.push_back(static_cast<uint8_t>(group));
+    }
+    result.swap(binary);
+    return (true);
+}
 }
 
 string
 encodeBase64(const vector<uint8_t>& binary) {
-    return (Base64Transformer::encode(binary));
+    return (fastEncodeBase64(binary));
 }
 
 void
 decodeBase64(const string& input, vector<uint8_t>& result) {
-    Base64Transformer::decode("base64", input, result);
+    if (!fastDecodeBase64(input, result)) {
+        Base64Transformer::decode("base64", input, result);
+    }
 }
 
 string
@@ -481,12 +645,14 @@ decodeBase32Hex(const string& input, vector<uint8_t>& result) {
 
 string
 encodeHex(const vector<uint8_t>& binary) {
-    return (Base16Transformer::encode(binary));
+    return (fastEncodeBase16(binary));
 }
 
 void
 decodeHex(const string& input, vector<uint8_t>& result) {
-    Base16Transformer::decode("base16", input, result);
+    if (!fastDecodeBase16(input, result)) {
+        Base16Transformer::decode("base16", input, result);
+    }
 }
 
 } // namespace encode
@@ -0,0 +1,156 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <util/epoll_event_handler.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#include <unistd.h>
+
+using namespace std;
+
+namespace isc {
+namespace util {
+
+EPollEventHandler::EPollEventHandler() : FDEventHandler(TYPE_EPOLL),
+    epoll_fd_(-1) {
+    open();
+}
+
+EPollEventHandler::~EPollEventHandler() {
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+    }
+}
+
+void
+EPollEventHandler::open() {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        isc_throw(Unexpected, "error creating epoll instance: "
+                  << strerror(errno));
+    }
+}
+
+void
+EPollEventHandler::add(int fd) {
+    if (fd < 0) {
+        isc_throw(BadValue, "invalid negative value for fd");
+    }
+    fds_.push_back(fd);
+}
+
+bool
+EPollEventHandler::sync() {
+    sort(fds_.begin(), fds_.end());
+    fds_.erase(unique(fds_.begin(), fds_.end()), fds_.end());
+    if (fds_ == registered_) {
+        return (true);
+    }
+
+    vector<int> removed;
+    set_difference(registered_.begin(), registered_.end(),
+                   fds_.begin(), fds_.end(), back_inserter(removed));
+    for (auto fd : removed) {
+        // The descriptor may already be closed which removes it from
+        // the set, so the error is ignored.
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, 0);
+    }
+
+    vector<int> added;
+    set_difference(fds_.begin(), fds_.end(),
+                   registered_.begin(), registered_.end(),
+                   back_inserter(added));
+    // Keep the descriptors which were already in the set.
+    registered_.clear();
+    set_difference(fds_.begin(), fds_.end(), added.begin(), added.end(),
+                   back_inserter(registered_));
+
+    bool result = true;
+    int saved_errno = 0;
+    for (auto fd : added) {
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if ((epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) &&
+            (errno != EEXIST)) {
+            if (result) {
+                saved_errno = errno;
+                result = false;
+            }
+            continue;
+        }
+        registered_.push_back(fd);
+    }
+    sort(registered_.begin(), registered_.end());
+    if (!result) {
+        errno = saved_errno;
+    }
+    return (result);
+}
+
+int
+EPollEventHandler::waitEvent(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */,
+                             bool use_timeout /* = true */) {
+    // Sanity check for microsecond timeout.
+    if (timeout_usec >= 1000000) {
+        isc_throw(BadValue, "fractional timeout must be shorter than"
+                  " one million microseconds");
+    }
+    ready_.clear();
+    if (!sync()) {
+        return (-1);
+    }
+
+    int timeout = -1;
+    if (use_timeout) {
+        uint64_t timeout_ms = static_cast<uint64_t>(timeout_sec) * 1000 +
+                              (timeout_usec + 999) / 1000;
+        timeout = static_cast<int>(min(timeout_ms,
+            static_cast<uint64_t>(numeric_limits<int>::max())));
+    }
+
+    events_.resize(max(registered_.size(), static_cast<size_t>(1)));
+    int result = epoll_wait(epoll_fd_, &events_[0], events_.size(), timeout);
+    for (int i = 0; i < result; ++i) {
+        if (events_[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+            ready_.insert(events_[i].data.fd);
+        }
+    }
+    return (result);
+}
+
+bool
+EPollEventHandler::readReady(int fd) {
+    return (ready_.count(fd) > 0);
+}
+
+void
+EPollEventHandler::clear() {
+    fds_.clear();
+    ready_.clear();
+}
+
+void
+EPollEventHandler::reset() {
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+        epoll_fd_ = -1;
+    }
+    registered_.clear();
+    ready_.clear();
+    open();
+}
+
+} // end of namespace isc::util
+} // end of namespace isc
@@ -0,0 +1,115 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EPOLL_EVENT_HANDLER_H
+#define EPOLL_EVENT_HANDLER_H
+
+#include <util/fd_event_handler.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <unordered_set>
+#include <vector>
+
+#include <sys/epoll.h>
+
+namespace isc {
+namespace util {
+
+/// @brief File descriptor event handler class handles events for registered
+/// file descriptors. This class uses a persistent epoll set to wait for
+/// events.
+///
+/// The file descriptors added between two calls to @c waitEvent are
+/// compared with the ones registered in the epoll set and only the
+/// difference is applied, so the cost of a wait does not depend on the
+/// number of watched descriptors when the set does not change. Unlike
+/// select() there is no limit on the file descriptor values.
+///
+/// @note The kernel silently drops a closed file descriptor from the
+/// epoll set so @c reset must be called when descriptors may have been
+/// closed and reopened under the same number.
+class EPollEventHandler : public FDEventHandler, public boost::noncopyable {
+public:
+    /// @brief Constructor.
+    ///
+    /// @throw Unexpected if the epoll instance can not be created.
+    EPollEventHandler();
+
+    /// @brief Destructor.
+    ///
+    /// Closes the epoll instance.
+    virtual ~EPollEventHandler();
+
+    /// @brief Add file descriptor to watch for read events.
+    ///
+    /// @param fd The file descriptor.
+    /// @throw BadValue if the file descriptor is negative.
+    void add(int fd);
+
+    /// @brief Wait for events on registered file descriptors.
+    ///
+    /// The sub-millisecond part of the timeout is rounded up to a full
+    /// millisecond.
+    ///
+    /// @param timeout_sec The wait timeout in seconds.
+    /// @param timeout_usec The wait timeout in micro seconds.
+    /// @param use_timeout Flag which indicates if the function should wait
+    /// with no timeout (wait forever).
+    /// @return -1 on error, 0 if no data is available (timeout expired),
+    /// greater than 0 if data is available. The errno is set to EBADF if
+    /// one of the added file descriptors is not valid.
+    /// @throw BadValue if timeout_usec is greater than one million.
+    int waitEvent(uint32_t timeout_sec, uint32_t timeout_usec = 0,
+                  bool use_timeout = true);
+
+    /// @brief Check if file descriptor is ready for read operation.
+    ///
+    /// @param fd The file descriptor.
+    ///
+    /// @return True if file descriptor is ready for reading.
+    bool readReady(int fd);
+
+    /// @brief Clear registered file descriptors.
+    ///
+    /// The epoll set is not modified until the next call to @c waitEvent.
+    void clear();
+
+    /// @brief Recreate the epoll instance.
+    ///
+    /// @throw Unexpected if the epoll instance can not be created.
+    void reset();
+
+private:
+    /// @brief Updates the epoll set to match the added file descriptors.
+    ///
+    /// @return false if a file descriptor could not be added, the errno
+    /// is set by the failed epoll_ctl() call.
+    bool sync();
+
+    /// @brief Opens the epoll instance.
+    void open();
+
+    /// @brief The epoll file descriptor.
+    int epoll_fd_;
+
+    /// @brief The file descriptors added since the last @c clear.
+    std::vector<int> fds_;
+
+    /// @brief The sorted file descriptors registered in the epoll set.
+    std::vector<int> registered_;
+
+    /// @brief The buffer for events returned by epoll_wait().
+    std::vector<struct epoll_event> events_;
+
+    /// @brief The file descriptors ready for read after the last wait.
+    std::unordered_set<int> ready_;
+};
+
+} // end of namespace isc::util
+} // end of namespace isc
+
+#endif // EPOLL_EVENT_HANDLER_H
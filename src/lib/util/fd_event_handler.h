@@ -0,0 +1,100 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef FD_EVENT_HANDLER_H
+#define FD_EVENT_HANDLER_H
+
+#include <boost/shared_ptr.hpp>
+
+#include <stdint.h>
+
+namespace isc {
+namespace util {
+
+/// @brief File descriptor event handler class handles events for registered
+/// file descriptors.
+///
+/// The handler is used to wait for read readiness on a set of file
+/// descriptors. The typical usage is to call @c clear, @c add for each
+/// file descriptor of interest, @c waitEvent and then @c readReady to
+/// find out which descriptors have data to read.
+///
+/// Implementations which keep some state in the kernel between calls
+/// (e.g. an epoll set) reuse this state as long as the set of added
+/// descriptors does not change. The @c reset function must be called
+/// when any of the descriptors may have been closed and reopened under
+/// the same number.
+class FDEventHandler {
+public:
+    /// @brief The types of event handlers.
+    enum HandlerType : uint16_t {
+        TYPE_UNKNOWN = 0,
+        TYPE_SELECT = 1,
+        TYPE_EPOLL = 2,
+    };
+
+    /// @brief Constructor.
+    ///
+    /// @param type The event handler type.
+    FDEventHandler(HandlerType type = TYPE_UNKNOWN) : type_(type) {
+    }
+
+    /// @brief Destructor.
+    virtual ~FDEventHandler() = default;
+
+    /// @brief Return the event handler type.
+    HandlerType type() const {
+        return (type_);
+    }
+
+    /// @brief Add file descriptor to watch for read events.
+    ///
+    /// @param fd The file descriptor.
+    virtual void add(int fd) = 0;
+
+    /// @brief Wait for events on registered file descriptors.
+    ///
+    /// @param timeout_sec The wait timeout in seconds.
+    /// @param timeout_usec The wait timeout in micro seconds.
+    /// @param use_timeout Flag which indicates if the function should wait
+    /// with no timeout (wait forever).
+    /// @return -1 on error, 0 if no data is available (timeout expired),
+    /// greater than 0 if data is available. On error the errno is set to
+    /// the error code returned by the underlying system call.
+    virtual int waitEvent(uint32_t timeout_sec, uint32_t timeout_usec = 0,
+                          bool use_timeout = true) = 0;
+
+    /// @brief Check if file descriptor is ready for read operation.
+    ///
+    /// @param fd The file descriptor.
+    ///
+    /// @return True if file descriptor is ready for reading.
+    virtual bool readReady(int fd) = 0;
+
+    /// @brief Clear registered file descriptors.
+    ///
+    /// The set of watched file descriptors is emptied so that a new set
+    /// can be built with @c add before the next call to @c waitEvent.
+    virtual void clear() = 0;
+
+    /// @brief Drop any state cached between the calls to @c waitEvent.
+    ///
+    /// The default implementation does nothing.
+    virtual void reset() {
+    }
+
+private:
+    /// @brief The event handler type.
+    HandlerType type_;
+};
+
+/// @brief Shared pointer to an event handler.
+typedef boost::shared_ptr<FDEventHandler> FDEventHandlerPtr;
+
+} // end of namespace isc::util
+} // end of namespace isc
+
+#endif // FD_EVENT_HANDLER_H
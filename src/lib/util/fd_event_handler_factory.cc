@@ -0,0 +1,93 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <util/fd_event_handler_factory.h>
+#include <util/select_event_handler.h>
+#if defined(OS_LINUX)
+#include <util/epoll_event_handler.h>
+#endif
+
+#include <atomic>
+#include <cstdlib>
+
+using namespace std;
+
+namespace isc {
+namespace util {
+
+namespace {
+
+/// @brief The configured type.
+atomic<uint16_t> default_type(FDEventHandler::TYPE_UNKNOWN);
+
+}
+
+FDEventHandler::HandlerType
+FDEventHandlerFactory::getDefaultType() {
+    const char* env = getenv("KEA_EVENT_HANDLER_TYPE");
+    if (env) {
+        try {
+            return (typeFromText(env));
+        } catch (const BadValue&) {
+            // Fall back to the configured type.
+        }
+    }
+    FDEventHandler::HandlerType type =
+        static_cast<FDEventHandler::HandlerType>(default_type.load());
+    if (type != FDEventHandler::TYPE_UNKNOWN) {
+        return (type);
+    }
+    return (FDEventHandler::TYPE_SELECT);
+}
+
+void
+FDEventHandlerFactory::setDefaultType(FDEventHandler::HandlerType type) {
+    default_type = type;
+}
+
+FDEventHandlerPtr
+FDEventHandlerFactory::factoryFDEventHandler() {
+    return (factoryFDEventHandler(getDefaultType()));
+}
+
+FDEventHandlerPtr
+FDEventHandlerFactory::factoryFDEventHandler(FDEventHandler::HandlerType type) {
+#if defined(OS_LINUX)
+    if (type == FDEventHandler::TYPE_EPOLL) {
+        return (FDEventHandlerPtr(new EPollEventHandler()));
+    }
+#endif
+    return (FDEventHandlerPtr(new SelectEventHandler()));
+}
+
+FDEventHandler::HandlerType
+FDEventHandlerFactory::typeFromText(const string& name) {
+    if (name == "select") {
+        return (FDEventHandler::TYPE_SELECT);
+    } else if (name == "epoll") {
+        return (FDEventHandler::TYPE_EPOLL);
+    }
+    isc_throw(BadValue, "unsupported event handler type '" << name
+              << "', expected 'select' or 'epoll'");
+}
+
+string
+FDEventHandlerFactory::typeToText(FDEventHandler::HandlerType type) {
+    switch (type) {
+    case FDEventHandler::TYPE_SELECT:
+        return ("select");
+    case FDEventHandler::TYPE_EPOLL:
+        return ("epoll");
+    default:
+        return ("unknown");
+    }
+}
+
+} // end of namespace isc::util
+} // end of namespace isc
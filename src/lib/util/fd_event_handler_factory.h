@@ -0,0 +1,69 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef FD_EVENT_HANDLER_FACTORY_H
+#define FD_EVENT_HANDLER_FACTORY_H
+
+#include <util/fd_event_handler.h>
+
+#include <string>
+
+namespace isc {
+namespace util {
+
+/// @brief File descriptor event handler factory class handles the creation
+/// of event handlers.
+///
+/// The handler type is the configured type, "select" by default. The
+/// KEA_EVENT_HANDLER_TYPE environment variable, when set to "select" or
+/// "epoll", overrides it. The epoll handler is only available on Linux: on
+/// other systems the select handler is always used.
+class FDEventHandlerFactory {
+public:
+    /// @brief Return the event handler type selected for this process.
+    ///
+    /// @return The type taken from the environment, else the configured
+    /// type, else TYPE_SELECT.
+    static FDEventHandler::HandlerType getDefaultType();
+
+    /// @brief Set the configured event handler type.
+    ///
+    /// The value of the environment variable overrides this type.
+    ///
+    /// @param type The event handler type, TYPE_UNKNOWN restores the
+    /// default TYPE_SELECT.
+    static void setDefaultType(FDEventHandler::HandlerType type);
+
+    /// @brief Return an event handler of the default type.
+    ///
+    /// @return The new event handler.
+    static FDEventHandlerPtr factoryFDEventHandler();
+
+    /// @brief Return an event handler of the specified type.
+    ///
+    /// @param type The event handler type.
+    /// @return The new event handler, a select handler if the type is
+    /// not supported on this system.
+    static FDEventHandlerPtr factoryFDEventHandler(FDEventHandler::HandlerType type);
+
+    /// @brief Convert a handler type name to the handler type.
+    ///
+    /// @param name The handler type name, "select" or "epoll".
+    /// @return The handler type.
+    /// @throw BadValue if the name is not recognized.
+    static FDEventHandler::HandlerType typeFromText(const std::string& name);
+
+    /// @brief Convert a handler type to its name.
+    ///
+    /// @param type The handler type.
+    /// @return The handler type name, "unknown" for TYPE_UNKNOWN.
+    static std::string typeToText(FDEventHandler::HandlerType type);
+};
+
+} // end of namespace isc::util
+} // end of namespace isc
+
+#endif // FD_EVENT_HANDLER_FACTORY_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2019-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,11 +8,21 @@
 
 #include <util/multi_threading_mgr.h>
 
+#include <cstdlib>
+#include <cstring>
+
 namespace isc {
 namespace util {
 
 MultiThreadingMgr::MultiThreadingMgr()
     : enabled_(false), critical_section_count_(0), thread_pool_size_(0) {
+    // The KEA_THREAD_POOL_WORK_STEALING environment variable selects the
+    // work stealing mode of the thread pool.
+    const char* work_stealing = getenv("KEA_THREAD_POOL_WORK_STEALING");
+    if (work_stealing && ((strcmp(work_stealing, "true") == 0) ||
+                          (strcmp(work_stealing, "1") == 0))) {
+        thread_pool_.setWorkStealing(true);
+    }
 }
 
 MultiThreadingMgr::~MultiThreadingMgr() {
@@ -104,6 +114,33 @@ MultiThreadingMgr::setPacketQueueSize(uint32_t size) {
     thread_pool_.setMaxQueueSize(size);
 }
 
+bool
+MultiThreadingMgr::getWorkStealing() const {
+    return (thread_pool_.getWorkStealing());
+}
+
+void
+MultiThreadingMgr::setWorkStealing(bool work_stealing) {
+    bool running = (thread_pool_.size() != 0);
+    if (running) {
+        thread_pool_.stop();
+    }
+    thread_pool_.setWorkStealing(work_stealing);
+    if (running) {
+        thread_pool_.start(getThreadPoolSize());
+    }
+}
+
+CpuList
+MultiThreadingMgr::getCpuAffinity() const {
+    return (thread_pool_.getCpuAffinity());
+}
+
+void
+MultiThreadingMgr::setCpuAffinity(const CpuList& cpus) {
+    thread_pool_.setCpuAffinity(cpus);
+}
+
 uint32_t
 MultiThreadingMgr::detectThreadCount() {
     return (std::thread::hardware_concurrency());
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2019-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -212,6 +212,32 @@ public:
     /// @param size The dhcp packet queue size.
     void setPacketQueueSize(uint32_t size);
 
+    /// @brief Get the dhcp thread pool work stealing mode.
+    ///
+    /// @return true if the threads have their own queue and steal work
+    /// from each other, false if they share a single queue.
+    bool getWorkStealing() const;
+
+    /// @brief Set the dhcp thread pool work stealing mode.
+    ///
+    /// The thread pool is restarted when it is running.
+    ///
+    /// @param work_stealing The work stealing mode.
+    void setWorkStealing(bool work_stealing);
+
+    /// @brief Get the CPUs the dhcp thread pool threads are bound to.
+    ///
+    /// @return The CPU list, empty when the threads are not bound.
+    CpuList getCpuAffinity() const;
+
+    /// @brief Set the CPUs the dhcp thread pool threads are bound to.
+    ///
+    /// The setting is applied when the thread pool is (re)started, e.g. by
+    /// @ref apply.
+    ///
+    /// @param cpus The CPU list, empty to not bind the threads.
+    void setCpuAffinity(const CpuList& cpus);
+
     /// @brief The system current detected hardware concurrency thread count.
     ///
     /// This function will return 0 if the value can not be determined.
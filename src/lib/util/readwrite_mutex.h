@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,14 +10,18 @@
 /// @file readwrite_mutex.h
 ///
 /// Standard implementation of read-write mutexes with writer preference
-/// using C++11 mutex and condition variable.
+/// using C++11 mutex and condition variable, and a reader biased path
+/// using per slot reader counters.
 /// As we need only the RAII wrappers implement only used methods.
 
 #include <exceptions/exceptions.h>
 #include <boost/noncopyable.hpp>
+#include <atomic>
+#include <chrono>
 #include <climits>
 #include <condition_variable>
 #include <mutex>
+#include <thread>
 
 namespace isc {
 namespace util {
@@ -26,6 +30,15 @@ namespace util {
 ///
 /// The code is based on Howard Hinnant's reference implementation
 /// for C++17 shared_mutex.
+///
+/// To avoid all the readers to serialize on the mutex, the readers use
+/// a reader biased path when no writer took the lock recently: each
+/// reader thread increments a counter of its own slot, on its own cache
+/// line. A writer disables the bias and waits for the counters to drop
+/// to zero, then the bias stays disabled for some time proportional to
+/// this wait, so the frequent writers do not pay it each time (the BRAVO
+/// design: "BRAVO - Biased Locking for Reader-Writer Locks" by Dice and
+/// Kogan).
 class ReadWriteMutex : public boost::noncopyable {
 public:
 
@@ -38,8 +51,23 @@ public:
     /// @brief The maximum number of readers (flag complement so 2^31 - 1).
     static const unsigned MAX_READERS = ~WRITE_ENTERED;
 
+    /// @brief The number of reader slots.
+    static const size_t READER_SLOTS = 64;
+
+    /// @brief The size of a reader slot (a cache line).
+    static const size_t READER_SLOT_SIZE = 64;
+
+    /// @brief The multiplier of the time the reader bias stays disabled.
+    ///
+    /// The time is this multiplier times the time spent by the last
+    /// writer waiting for the readers of the biased path.
+    static const unsigned INHIBIT_MULTIPLIER = 9;
+
     /// @brief Constructor.
-    ReadWriteMutex() : state_(0) {
+    ReadWriteMutex() : state_(0), rbias_(true), inhibit_until_() {
+        for (auto& slot : slots_) {
+            slot.readers_ = 0;
+        }
     }
 
     /// @brief Destructor.
@@ -56,8 +84,29 @@ public:
         // Wait until the write entered flag can be set.
         gate1_.wait(lk, [&]() { return (!writeEntered()); });
         state_ |= WRITE_ENTERED;
+        // New readers now take the mutex and wait.
+        bool revoked = rbias_.load();
+        if (revoked) {
+            rbias_.store(false);
+        }
         // Wait until there are no more readers.
         gate2_.wait(lk, [&]() { return (readers() == 0); });
+        lk.unlock();
+        if (revoked) {
+            // Wait until there are no more readers on the biased path.
+            auto start = std::chrono::steady_clock::now();
+            for (auto& slot : slots_) {
+                while (slot.readers_.load() != 0) {
+                    std::this_thread::yield();
+                }
+            }
+            auto now = std::chrono::steady_clock::now();
+            // The readers see the new value after taking the mutex
+            // in writeUnlock.
+            // The multiplier is copied to avoid an ODR-use.
+            const unsigned multiplier = INHIBIT_MULTIPLIER;
+            inhibit_until_ = now + (now - start) * multiplier;
+        }
     }
 
     /// @brief Unlock write.
@@ -71,17 +120,41 @@ public:
     }
 
     /// @brief Lock read.
-    void readLock() {
+    ///
+    /// @return true if the lock was taken on the reader biased path.
+    bool readLock() {
+        if (rbias_.load()) {
+            std::atomic<unsigned>& readers = slots_[slotIndex()].readers_;
+            ++readers;
+            // The writers disable the bias before checking the counters.
+            if (rbias_.load()) {
+                return (true);
+            }
+            --readers;
+        }
         std::unique_lock<std::mutex> lk(mutex_);
         // Wait if there is a writer or if readers overflow.
         gate1_.wait(lk, [&]() { return (state_ < MAX_READERS); });
         ++state_;
+        // No writer holds the lock: enable the bias again when the last
+        // writer is old enough.
+        if (!rbias_.load() &&
+            (std::chrono::steady_clock::now() >= inhibit_until_)) {
+            rbias_.store(true);
+        }
+        return (false);
     }
 
     /// @brief Unlock read.
     ///
     /// @note: do not check that there is a least one reader.
-    void readUnlock() {
+    ///
+    /// @param biased The value returned by @ref readLock.
+    void readUnlock(bool biased) {
+        if (biased) {
+            --slots_[slotIndex()].readers_;
+            return;
+        }
         std::lock_guard<std::mutex> lk(mutex_);
         unsigned prev = state_--;
         if (writeEntered()) {
@@ -97,6 +170,13 @@ public:
         }
     }
 
+    /// @brief Check if the readers can use the biased path.
+    ///
+    /// @note: used by tests.
+    bool isReaderBiased() const {
+        return (rbias_.load());
+    }
+
 private:
 
     /// Helpers.
@@ -107,10 +187,30 @@ private:
     }
 
     /// @brief Return the number of readers.
+    ///
+    /// The readers on the biased path are not counted.
     unsigned readers() const {
         return (state_ & MAX_READERS);
     }
 
+    /// @brief Return the reader slot of the current thread.
+    ///
+    /// The slots are given to the threads in turn.
+    static size_t slotIndex() {
+        static std::atomic<size_t> next_slot(0);
+        thread_local size_t slot = next_slot++ % READER_SLOTS;
+        return (slot);
+    }
+
+    /// @brief Reader slot.
+    struct ReaderSlot {
+        /// @brief The number of readers on the biased path.
+        std::atomic<unsigned> readers_;
+
+        /// @brief Padding to the size of a cache line.
+        char padding_[READER_SLOT_SIZE - sizeof(std::atomic<unsigned>)];
+    };
+
     /// Members.
 
     /// @brief Mutex.
@@ -132,6 +232,17 @@ private:
     ///
     /// Used to handle the write entered flag and the reader count.
     unsigned state_;
+
+    /// @brief Reader bias flag.
+    ///
+    /// Set when the readers can use the biased path.
+    std::atomic<bool> rbias_;
+
+    /// @brief Time before which the bias is not enabled again.
+    std::chrono::steady_clock::time_point inhibit_until_;
+
+    /// @brief Reader slots.
+    ReaderSlot slots_[READER_SLOTS];
 };
 
 /// @brief Read mutex RAII handler.
@@ -143,19 +254,22 @@ public:
     /// @brief Constructor.
     ///
     /// @param rw_mutex The read mutex.
-    ReadLockGuard(ReadWriteMutex& rw_mutex) : rw_mutex_(rw_mutex) {
-        rw_mutex_.readLock();
+    ReadLockGuard(ReadWriteMutex& rw_mutex)
+        : rw_mutex_(rw_mutex), biased_(rw_mutex_.readLock()) {
     }
 
     /// @brief Destructor.
     virtual ~ReadLockGuard() {
-        rw_mutex_.readUnlock();
+        rw_mutex_.readUnlock(biased_);
     }
 
 private:
     /// @brief The read-write mutex.
     ReadWriteMutex& rw_mutex_;
 
+    /// @brief The flag set when the lock was taken on the biased path.
+    bool biased_;
+
 };
 
 /// @brief Write mutex RAII handler.
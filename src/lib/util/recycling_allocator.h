@@ -0,0 +1,206 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef RECYCLING_ALLOCATOR_H
+#define RECYCLING_ALLOCATOR_H
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace isc {
+namespace util {
+
+/// @brief Per thread cache of released memory blocks of a type.
+///
+/// The blocks released by a thread are kept in the cache of this thread
+/// and handed out to the next allocations of the same type by this
+/// thread. The cache holds at most @c MAX_SIZE blocks: the blocks
+/// released when the cache is full are returned to the heap. The cached
+/// blocks are returned to the heap when the thread exits: the blocks
+/// released after are directly returned to the heap.
+///
+/// @tparam T Type of the objects allocated in the blocks.
+template<typename T>
+class RecyclingCache {
+public:
+
+    /// @brief Maximum number of blocks held by the cache of a thread.
+    static const size_t MAX_SIZE = 256;
+
+    /// @brief Destructor.
+    ///
+    /// Returns the cached blocks to the heap.
+    ~RecyclingCache() {
+        destroyed() = true;
+        for (void* block : blocks_) {
+            ::operator delete(block);
+        }
+    }
+
+    /// @brief Returns the cache of the current thread.
+    ///
+    /// @return The cache or null when the cache of the thread was
+    /// destroyed, i.e. when the thread is exiting.
+    static RecyclingCache* instance() {
+        if (destroyed()) {
+            return (0);
+        }
+        static thread_local RecyclingCache cache;
+        return (&cache);
+    }
+
+    /// @brief Returns a block.
+    ///
+    /// @return A block cached by the current thread or a block allocated
+    /// from the heap.
+    /// @throw std::bad_alloc if the allocation fails.
+    static void* get() {
+        RecyclingCache* cache = instance();
+        if (!cache || cache->blocks_.empty()) {
+            return (::operator new(sizeof(T)));
+        }
+        void* block = cache->blocks_.back();
+        cache->blocks_.pop_back();
+        return (block);
+    }
+
+    /// @brief Releases a block.
+    ///
+    /// @param block Block returned by @c get, possibly by another thread.
+    static void put(void* block) {
+        RecyclingCache* cache = instance();
+        if (!cache || (cache->blocks_.size() >= MAX_SIZE)) {
+            ::operator delete(block);
+            return;
+        }
+        cache->blocks_.push_back(block);
+    }
+
+    /// @brief Returns the number of blocks cached by the current thread.
+    static size_t size() {
+        RecyclingCache* cache = instance();
+        return (cache ? cache->blocks_.size() : 0);
+    }
+
+private:
+
+    /// @brief Constructor.
+    RecyclingCache() : blocks_() {
+        blocks_.reserve(MAX_SIZE);
+    }
+
+    /// @brief Returns the flag set when the cache of the current thread
+    /// is destroyed.
+    ///
+    /// The flag is trivially destructible so it can be checked while the
+    /// thread local objects are destroyed.
+    static bool& destroyed() {
+        static thread_local bool flag = false;
+        return (flag);
+    }
+
+    /// @brief The cached blocks.
+    std::vector<void*> blocks_;
+};
+
+template<typename T>
+const size_t RecyclingCache<T>::MAX_SIZE;
+
+/// @brief Allocator recycling the memory of single objects.
+///
+/// This allocator is used with @c boost::allocate_shared to recycle the
+/// blocks of the short lived objects created for each processed packet,
+/// e.g. the packets, their callout handles and the client contexts. The
+/// object and its reference counter are allocated in one block which is
+/// recycled when the last reference is released, so the allocator does
+/// not churn when a packet is processed.
+///
+/// The allocations of arrays are forwarded to the heap.
+///
+/// @tparam T Type of the allocated objects.
+template<typename T>
+class RecyclingAllocator {
+public:
+
+    /// @brief Type of the allocated objects.
+    typedef T value_type;
+
+    /// @brief Rebinds the allocator to another type.
+    template<typename U>
+    struct rebind {
+        /// The allocator of the other type.
+        typedef RecyclingAllocator<U> other;
+    };
+
+    /// @brief Constructor.
+    RecyclingAllocator() {
+    }
+
+    /// @brief Conversion constructor.
+    template<typename U>
+    RecyclingAllocator(const RecyclingAllocator<U>&) {
+    }
+
+    /// @brief Allocates objects.
+    ///
+    /// @param n Number of objects.
+    /// @return Pointer to the uninitialized objects.
+    /// @throw std::bad_alloc if the allocation fails.
+    T* allocate(size_t n) {
+        if (n == 1) {
+            return (static_cast<T*>(RecyclingCache<T>::get()));
+        }
+        return (static_cast<T*>(::operator new(n * sizeof(T))));
+    }
+
+    /// @brief Deallocates objects.
+    ///
+    /// @param p Pointer to the destroyed objects.
+    /// @param n Number of objects.
+    void deallocate(T* p, size_t n) {
+        if (n == 1) {
+            RecyclingCache<T>::put(p);
+            return;
+        }
+        ::operator delete(p);
+    }
+};
+
+/// @brief Equality operator: all the recycling allocators are equal.
+template<typename T, typename U>
+bool
+operator==(const RecyclingAllocator<T>&, const RecyclingAllocator<U>&) {
+    return (true);
+}
+
+/// @brief Inequality operator: all the recycling allocators are equal.
+template<typename T, typename U>
+bool
+operator!=(const RecyclingAllocator<T>&, const RecyclingAllocator<U>&) {
+    return (false);
+}
+
+/// @brief Creates a shared object with a recycled block.
+///
+/// @tparam T Type of the object.
+/// @tparam Args Types of the constructor arguments.
+/// @param args Constructor arguments.
+/// @return Pointer to the object.
+template<typename T, typename... Args>
+boost::shared_ptr<T>
+makeRecycled(Args&&... args) {
+    return (boost::allocate_shared<T>(RecyclingAllocator<T>(),
+                                      std::forward<Args>(args)...));
+}
+
+} // namespace isc::util
+} // namespace isc
+
+#endif // RECYCLING_ALLOCATOR_H
@@ -0,0 +1,72 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SELECT_EVENT_HANDLER_H
+#define SELECT_EVENT_HANDLER_H
+
+#include <util/fd_event_handler.h>
+
+#include <sys/select.h>
+
+namespace isc {
+namespace util {
+
+/// @brief File descriptor event handler class handles events for registered
+/// file descriptors. This class uses select() to wait for events.
+///
+/// @note The file descriptors must be lower than FD_SETSIZE.
+class SelectEventHandler : public FDEventHandler {
+public:
+    /// @brief Constructor.
+    SelectEventHandler();
+
+    /// @brief Destructor.
+    virtual ~SelectEventHandler() = default;
+
+    /// @brief Add file descriptor to watch for read events.
+    ///
+    /// @param fd The file descriptor.
+    /// @throw BadValue if the file descriptor is negative or does not fit
+    /// in the fd_set.
+    void add(int fd);
+
+    /// @brief Wait for events on registered file descriptors.
+    ///
+    /// @param timeout_sec The wait timeout in seconds.
+    /// @param timeout_usec The wait timeout in micro seconds.
+    /// @param use_timeout Flag which indicates if the function should wait
+    /// with no timeout (wait forever).
+    /// @return -1 on error, 0 if no data is available (timeout expired),
+    /// greater than 0 if data is available.
+    /// @throw BadValue if timeout_usec is greater than one million.
+    int waitEvent(uint32_t timeout_sec, uint32_t timeout_usec = 0,
+                  bool use_timeout = true);
+
+    /// @brief Check if file descriptor is ready for read operation.
+    ///
+    /// @param fd The file descriptor.
+    ///
+    /// @return True if file descriptor is ready for reading.
+    bool readReady(int fd);
+
+    /// @brief Clear registered file descriptors.
+    void clear();
+
+private:
+    /// @brief The maximum value of registered file descriptors.
+    int max_fd_;
+
+    /// @brief The read event FD set.
+    fd_set read_fd_set_;
+
+    /// @brief The read event FD set as updated by the last select() call.
+    fd_set read_fd_set_data_;
+};
+
+} // end of namespace isc::util
+} // end of namespace isc
+
+#endif // SELECT_EVENT_HANDLER_H
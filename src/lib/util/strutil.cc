@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,6 +13,7 @@
 #include <boost/algorithm/string/constants.hpp>
 #include <boost/algorithm/string/split.hpp>
 
+#include <bitset>
 #include <numeric>
 #include <iostream>
 #include <sstream>
@@ -220,55 +221,60 @@ decodeColonSeparatedHexString(const std::string& hex_string,
 void
 decodeSeparatedHexString(const std::string& hex_string, const std::string& sep,
                          std::vector<uint8_t>& binary) {
-    std::vector<std::string> split_text;
-    boost::split(split_text, hex_string, boost::is_any_of(sep),
-                 boost::algorithm::token_compress_off);
-
     std::vector<uint8_t> binary_vec;
-    for (size_t i = 0; i < split_text.size(); ++i) {
+    binary_vec.reserve(hex_string.size() / 3 + 1);
+    size_t tokens = 0;
+    size_t pos = 0;
+    for (;;) {
+        size_t end = hex_string.find_first_of(sep, pos);
+        if (end == std::string::npos) {
+            end = hex_string.size();
+        }
+        ++tokens;
+        const size_t length = end - pos;
 
         // If there are multiple tokens and the current one is empty, it
         // means that two consecutive colons were specified. This is not
         // allowed.
-        if ((split_text.size() > 1) && split_text[i].empty()) {
+        if ((length == 0) && ((tokens > 1) || (end < hex_string.size()))) {
             isc_throw(isc::BadValue, "two consecutive separators ('" << sep << "') specified in"
                       " a decoded string '" << hex_string << "'");
 
         // Between a colon we expect at most two characters.
-        } else if (split_text[i].size() > 2) {
+        } else if (length > 2) {
             isc_throw(isc::BadValue, "invalid format of the decoded string"
                       << " '" << hex_string << "'");
 
-        } else if (!split_text[i].empty()) {
-            std::stringstream s;
-            s << "0x";
-
-            for (unsigned int j = 0; j < split_text[i].length(); ++j) {
+        } else if (length > 0) {
+            uint8_t binary_value = 0;
+            for (size_t j = pos; j < end; ++j) {
                 // Check if we're dealing with hexadecimal digit.
-                if (!isxdigit(split_text[i][j])) {
-                    isc_throw(isc::BadValue, "'" << split_text[i][j]
+                const char ch = hex_string[j];
+                if (!isxdigit(ch)) {
+                    isc_throw(isc::BadValue, "'" << ch
                               << "' is not a valid hexadecimal digit in"
                               << " decoded string '" << hex_string << "'");
                 }
-                s << split_text[i][j];
+                binary_value <<= 4;
+                if (isdigit(ch)) {
+                    binary_value |= ch - '0';
+                } else {
+                    binary_value |= toLower(ch) - 'a' + 10;
+                }
             }
-
-            // The stream should now have one or two hexadecimal digits.
-            // Let's convert it to a number and store in a temporary
-            // vector.
-            unsigned int binary_value;
-            s >> std::hex >> binary_value;
-
-            binary_vec.push_back(static_cast<uint8_t>(binary_value));
+            binary_vec.push_back(binary_value);
         }
 
+        if (end == hex_string.size()) {
+            break;
+        }
+        pos = end + 1;
     }
 
     // All ok, replace the data in the output vector with a result.
     binary.swap(binary_vec);
 }
 
-
 void
 decodeFormattedHexString(const std::string& hex_string,
                          std::vector<uint8_t>& binary) {
@@ -311,7 +317,8 @@ class StringSanitizerImpl {
 public:
     /// @brief Constructor.
     StringSanitizerImpl(const std::string& char_set, const std::string& char_replacement)
-        : char_set_(char_set), char_replacement_(char_replacement) {
+        : char_set_(char_set), char_replacement_(char_replacement),
+          compiled_(false), invalid_chars_() {
         if (char_set.size() > StringSanitizer::MAX_DATA_SIZE) {
             isc_throw(isc::BadValue, "char set size: '" << char_set.size()
                       << "' exceeds max size: '"
@@ -323,6 +330,13 @@ public:
                       << char_replacement.size() << "' exceeds max size: '"
                       << StringSanitizer::MAX_DATA_SIZE << "'");
         }
+
+        // The usual char sets are a single bracket expression which is
+        // compiled into a lookup table, avoiding the regex engine.
+        compiled_ = compileCharSet();
+        if (compiled_) {
+            return;
+        }
 #ifdef USE_REGEX
         try {
             scrub_exp_ = std::regex(char_set, std::regex::extended);
@@ -344,11 +358,25 @@ public:
     /// @brief Destructor.
     ~StringSanitizerImpl() {
 #ifndef USE_REGEX
-        regfree(&scrub_exp_);
+        if (!compiled_) {
+            regfree(&scrub_exp_);
+        }
 #endif
     }
 
     std::string scrub(const std::string& original) {
+        if (compiled_) {
+            std::string result;
+            result.reserve(original.size());
+            for (auto const& ch : original) {
+                if (invalid_chars_[static_cast<uint8_t>(ch)]) {
+                    result += char_replacement_;
+                } else {
+                    result.push_back(ch);
+                }
+            }
+            return (result);
+        }
 #ifdef USE_REGEX
         std::stringstream result;
         try {
@@ -417,12 +445,74 @@ public:
     }
 
 private:
+    /// @brief Compiles the char set into the lookup table.
+    ///
+    /// Only a char set made of one bracket expression of ASCII characters
+    /// and ranges, optionally negated, e.g. "[^A-Za-z0-9.-]", is compiled.
+    /// The character classes, the collating elements, the backslashes and
+    /// the other regular expressions are left to the regex engine.
+    ///
+    /// Embedded nulls are always invalid as with the regcomp/regexec
+    /// implementation.
+    ///
+    /// @return true if the char set was compiled, false otherwise.
+    bool compileCharSet() {
+        const std::string& cs = char_set_;
+        if ((cs.size() < 3) || (cs[0] != '[') || (cs[cs.size() - 1] != ']')) {
+            return (false);
+        }
+        std::bitset<256> chars;
+        size_t i = 1;
+        bool negated = false;
+        if (cs[i] == '^') {
+            negated = true;
+            ++i;
+        }
+        // A closing bracket at the beginning of the list is a literal.
+        size_t first = i;
+        for (; i < cs.size() - 1; ++i) {
+            uint8_t start = static_cast<uint8_t>(cs[i]);
+            if ((start >= 0x80) || (start == '\\') || (start == '[') ||
+                ((start == ']') && (i != first))) {
+                return (false);
+            }
+            // A hyphen at the beginning or at the end of the list is a
+            // literal, otherwise it denotes a range.
+            if ((i + 2 < cs.size() - 1) && (cs[i + 1] == '-')) {
+                uint8_t end = static_cast<uint8_t>(cs[i + 2]);
+                if ((end >= 0x80) || (end < start) || (end == '\\') ||
+                    (end == '[') || (end == ']')) {
+                    return (false);
+                }
+                for (unsigned c = start; c <= end; ++c) {
+                    chars.set(c);
+                }
+                i += 2;
+                continue;
+            }
+            chars.set(start);
+        }
+        if (i == first) {
+            // Empty list.
+            return (false);
+        }
+        invalid_chars_ = (negated ? ~chars : chars);
+        invalid_chars_.set(0);
+        return (true);
+    }
+
     /// @brief The char set data for regex.
     std::string char_set_;
 
     /// @brief The char replacement data for regex.
     std::string char_replacement_;
 
+    /// @brief True when the char set is compiled into the lookup table.
+    bool compiled_;
+
+    /// @brief The lookup table of the invalid characters.
+    std::bitset<256> invalid_chars_;
+
 #ifdef USE_REGEX
     regex scrub_exp_;
 #else
@@ -449,17 +539,20 @@ StringSanitizer::scrub(const std::string& original) {
 }
 
 std::string dumpAsHex(const uint8_t* data, size_t length) {
-    std::stringstream output;
-    for (unsigned int i = 0; i < length; i++) {
-        if (i) {
-            output << ":";
-        }
-
-        output << std::setfill('0') << std::setw(2) << std::hex
-               << static_cast<unsigned short>(data[i]);
+    // The identifiers of the leases are dumped for each lease sent
+    // to a peer or returned by a command, so the digits are written
+    // directly rather than through a stream.
+    static const char digits[] = "0123456789abcdef";
+    std::string output;
+    if (length == 0) {
+        return (output);
     }
-
-    return (output.str());
+    output.resize(3 * length - 1, ':');
+    for (size_t i = 0; i < length; ++i) {
+        output[3 * i] = digits[data[i] >> 4];
+        output[3 * i + 1] = digits[data[i] & 0x0f];
+    }
+    return (output);
 }
 
 } // namespace str
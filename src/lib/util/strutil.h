@@ -308,6 +308,10 @@ typedef boost::shared_ptr<StringSanitizerImpl> StringSanitizerImplPtr;
 /// (tested in configure.ac). If not it falls back to C lib regcomp/regexec.
 /// Older compilers, such as pre Gnu g++ 4.9.0, provided only experimental
 /// implementations of regex which are recognized as buggy.
+///
+/// A character set which is a single bracket expression of ASCII characters
+/// and ranges, e.g. "[^A-Za-z0-9.-]", is compiled into a lookup table and
+/// the strings are scrubbed in a single pass without the regex engine.
 class StringSanitizer {
 public:
 
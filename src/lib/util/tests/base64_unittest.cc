@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -90,4 +90,26 @@ TEST_F(Base64Test, encode) {
         EXPECT_EQ((*it).second, encodeBase64(decoded_data));
     }
 }
+
+// Verifies that long data is encoded and decoded as the short data.
+TEST_F(Base64Test, roundTrip) {
+    for (size_t size = 250; size < 253; ++size) {
+        vector<uint8_t> data;
+        for (size_t i = 0; i < size; ++i) {
+            data.push_back(static_cast<uint8_t>(i * 7));
+        }
+        const string encoded = encodeBase64(data);
+        EXPECT_EQ(((size + 2) / 3) * 4, encoded.size());
+        decodeBase64(encoded, decoded_data);
+        EXPECT_TRUE(data == decoded_data);
+
+        // The same text with spaces.
+        decoded_data.clear();
+        decodeBase64(" " + encoded + "\n", decoded_data);
+        EXPECT_TRUE(data == decoded_data);
+    }
+
+    // Intermediate padding in a long text.
+    EXPECT_THROW(decodeBase64("Zm9vYmFyYmE=Zm9vYmFy", decoded_data), BadValue);
+}
 }
@@ -0,0 +1,78 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <util/cpu_affinity.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace isc;
+using namespace isc::util;
+using namespace std;
+
+namespace {
+
+// Verifies that valid CPU lists are parsed.
+TEST(CpuAffinityTest, parseCpuList) {
+    EXPECT_TRUE(parseCpuList("").empty());
+    EXPECT_TRUE(parseCpuList(" ").empty());
+    EXPECT_EQ(CpuList({ 0 }), parseCpuList("0"));
+    EXPECT_EQ(CpuList({ 0, 1, 2, 3 }), parseCpuList("0-3"));
+    EXPECT_EQ(CpuList({ 0, 1, 2, 3, 8, 10, 11 }), parseCpuList("0-3,8,10-11"));
+    EXPECT_EQ(CpuList({ 1, 2, 3, 5 }), parseCpuList(" 5 , 3, 1-3 "));
+    EXPECT_EQ(CpuList({ 4 }), parseCpuList("4-4"));
+}
+
+// Verifies that invalid CPU lists are rejected.
+TEST(CpuAffinityTest, badCpuList) {
+    EXPECT_THROW(parseCpuList("a"), BadValue);
+    EXPECT_THROW(parseCpuList("-1"), BadValue);
+    EXPECT_THROW(parseCpuList("1-"), BadValue);
+    EXPECT_THROW(parseCpuList("3-1"), BadValue);
+    EXPECT_THROW(parseCpuList("1-2-3"), BadValue);
+    EXPECT_THROW(parseCpuList("1.5"), BadValue);
+    EXPECT_THROW(parseCpuList("99999999999"), BadValue);
+#if defined(OS_LINUX)
+    EXPECT_THROW(parseCpuList("100000"), BadValue);
+#endif
+}
+
+// Verifies the textual representation of CPU lists.
+TEST(CpuAffinityTest, cpuListToText) {
+    EXPECT_EQ("", cpuListToText(CpuList()));
+    EXPECT_EQ("0", cpuListToText(CpuList({ 0 })));
+    EXPECT_EQ("0-3,8,10-11", cpuListToText(CpuList({ 0, 1, 2, 3, 8, 10, 11 })));
+    EXPECT_EQ(CpuList({ 1, 3, 4, 5 }), parseCpuList(cpuListToText(CpuList({ 1, 3, 4, 5 }))));
+}
+
+// Verifies that a thread can be bound to an available CPU.
+TEST(CpuAffinityTest, setThreadCpuAffinity) {
+    CpuList cpus = getAvailableCpus();
+    if (!isCpuAffinitySupported()) {
+        EXPECT_TRUE(cpus.empty());
+        EXPECT_FALSE(setThreadCpuAffinity(0));
+        return;
+    }
+    ASSERT_FALSE(cpus.empty());
+    unsigned cpu = cpus.back();
+    bool bound = false;
+    // Use another thread to keep the affinity of the test process.
+    thread t([&]() {
+        bound = setThreadCpuAffinity(cpu);
+        if (bound) {
+            EXPECT_EQ(CpuList({ cpu }), getAvailableCpus());
+        }
+    });
+    t.join();
+    EXPECT_TRUE(bound);
+    EXPECT_EQ(cpus, getAvailableCpus());
+}
+
+} // end of anonymous namespace
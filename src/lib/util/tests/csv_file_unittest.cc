@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -120,6 +120,28 @@ TEST(CSVRow, render) {
     EXPECT_TRUE(text.empty());
 }
 
+// This test checks that the rows are compared by their text representation.
+TEST(CSVRow, equality) {
+    CSVRow row0("foo,bar");
+    CSVRow row1(2);
+    row1.writeAt(0, "foo");
+    row1.writeAt(1, "bar");
+    EXPECT_TRUE(row0 == row1);
+    EXPECT_FALSE(row0 != row1);
+
+    // Same representation with different values.
+    CSVRow row2(1);
+    row2.writeAt(0, "foo,bar");
+    EXPECT_TRUE(row0 == row2);
+
+    // Different lengths or contents.
+    CSVRow row3("foo,baz");
+    EXPECT_TRUE(row0 != row3);
+    EXPECT_TRUE(row0 != CSVRow(0));
+    EXPECT_TRUE(CSVRow(0) == CSVRow(0));
+    EXPECT_TRUE(CSVRow("foo;bar", ';') != row0);
+}
+
 // This test checks that the data values can be set for the CSV row.
 TEST(CSVRow, writeAt) {
     CSVRow row(4);
@@ -0,0 +1,238 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <util/fd_event_handler_factory.h>
+#include <util/select_event_handler.h>
+
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <cstdlib>
+
+#include <unistd.h>
+
+using namespace isc;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Test fixture class for the event handlers.
+///
+/// The tests are run for all supported handler types.
+class FDEventHandlerTest : public ::testing::TestWithParam<FDEventHandler::HandlerType> {
+public:
+    /// @brief Constructor.
+    ///
+    /// Creates the handler and two pipes.
+    FDEventHandlerTest() {
+        handler_ = FDEventHandlerFactory::factoryFDEventHandler(GetParam());
+        EXPECT_EQ(0, pipe(pipe1_));
+        EXPECT_EQ(0, pipe(pipe2_));
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Closes the pipes.
+    ~FDEventHandlerTest() {
+        close(pipe1_[0]);
+        close(pipe1_[1]);
+        close(pipe2_[0]);
+        close(pipe2_[1]);
+        FDEventHandlerFactory::setDefaultType(FDEventHandler::TYPE_UNKNOWN);
+    }
+
+    /// @brief Writes one byte to a pipe.
+    ///
+    /// @param fd The write end of the pipe.
+    void writeByte(int fd) {
+        char c = 'x';
+        ASSERT_EQ(1, write(fd, &c, 1));
+    }
+
+    /// @brief Reads one byte from a pipe.
+    ///
+    /// @param fd The read end of the pipe.
+    void readByte(int fd) {
+        char c;
+        ASSERT_EQ(1, read(fd, &c, 1));
+    }
+
+    /// @brief The event handler.
+    FDEventHandlerPtr handler_;
+
+    /// @brief The first pipe.
+    int pipe1_[2];
+
+    /// @brief The second pipe.
+    int pipe2_[2];
+};
+
+// Verifies that a handler of the requested type is created.
+TEST_P(FDEventHandlerTest, type) {
+#if defined(OS_LINUX)
+    EXPECT_EQ(GetParam(), handler_->type());
+#else
+    EXPECT_EQ(FDEventHandler::TYPE_SELECT, handler_->type());
+#endif
+}
+
+// Verifies that negative descriptors and bad timeouts are rejected.
+TEST_P(FDEventHandlerTest, badValues) {
+    EXPECT_THROW(handler_->add(-1), BadValue);
+    EXPECT_THROW(handler_->waitEvent(0, 1000000), BadValue);
+}
+
+// Verifies that waiting with no data returns on timeout.
+TEST_P(FDEventHandlerTest, timeout) {
+    handler_->add(pipe1_[0]);
+    EXPECT_EQ(0, handler_->waitEvent(0, 1000));
+    EXPECT_FALSE(handler_->readReady(pipe1_[0]));
+}
+
+// Verifies that read events are reported for the right descriptors.
+TEST_P(FDEventHandlerTest, readReady) {
+    handler_->add(pipe1_[0]);
+    handler_->add(pipe2_[0]);
+
+    writeByte(pipe2_[1]);
+    EXPECT_EQ(1, handler_->waitEvent(0, 0));
+    EXPECT_FALSE(handler_->readReady(pipe1_[0]));
+    EXPECT_TRUE(handler_->readReady(pipe2_[0]));
+
+    writeByte(pipe1_[1]);
+    EXPECT_EQ(2, handler_->waitEvent(0, 0));
+    EXPECT_TRUE(handler_->readReady(pipe1_[0]));
+    EXPECT_TRUE(handler_->readReady(pipe2_[0]));
+
+    readByte(pipe1_[0]);
+    readByte(pipe2_[0]);
+    EXPECT_EQ(0, handler_->waitEvent(0, 0));
+    EXPECT_FALSE(handler_->readReady(pipe1_[0]));
+    EXPECT_FALSE(handler_->readReady(pipe2_[0]));
+}
+
+// Verifies that the watched set follows clear and add calls.
+TEST_P(FDEventHandlerTest, clear) {
+    handler_->add(pipe1_[0]);
+    handler_->add(pipe2_[0]);
+    writeByte(pipe1_[1]);
+    writeByte(pipe2_[1]);
+    EXPECT_EQ(2, handler_->waitEvent(0, 0));
+
+    // Watch only the second pipe.
+    handler_->clear();
+    handler_->add(pipe2_[0]);
+    EXPECT_EQ(1, handler_->waitEvent(0, 0));
+    EXPECT_FALSE(handler_->readReady(pipe1_[0]));
+    EXPECT_TRUE(handler_->readReady(pipe2_[0]));
+
+    // Nothing is watched.
+    handler_->clear();
+    EXPECT_EQ(0, handler_->waitEvent(0, 0));
+    EXPECT_FALSE(handler_->readReady(pipe2_[0]));
+
+    // Adding the same descriptor twice is harmless.
+    handler_->add(pipe1_[0]);
+    handler_->add(pipe1_[0]);
+    EXPECT_EQ(1, handler_->waitEvent(0, 0));
+    EXPECT_TRUE(handler_->readReady(pipe1_[0]));
+}
+
+// Verifies that a descriptor reopened under the same number is watched
+// after a reset.
+TEST_P(FDEventHandlerTest, reset) {
+    handler_->add(pipe1_[0]);
+    EXPECT_EQ(0, handler_->waitEvent(0, 0));
+
+    // Replace the first pipe by a new one using the same numbers.
+    int fd0 = pipe1_[0];
+    close(pipe1_[0]);
+    close(pipe1_[1]);
+    ASSERT_EQ(0, pipe(pipe1_));
+    ASSERT_EQ(fd0, pipe1_[0]);
+    writeByte(pipe1_[1]);
+
+    handler_->reset();
+    handler_->clear();
+    handler_->add(pipe1_[0]);
+    EXPECT_EQ(1, handler_->waitEvent(0, 0));
+    EXPECT_TRUE(handler_->readReady(pipe1_[0]));
+}
+
+// Verifies that closed descriptors are reported with EBADF.
+TEST_P(FDEventHandlerTest, badFd) {
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    close(fds[0]);
+    close(fds[1]);
+    handler_->add(fds[0]);
+    errno = 0;
+    EXPECT_EQ(-1, handler_->waitEvent(0, 0));
+    EXPECT_EQ(EBADF, errno);
+}
+
+/// Define the parameterized test loop.
+#ifdef INSTANTIATE_TEST_SUITE_P
+INSTANTIATE_TEST_SUITE_P(FDEventHandlerTypes, FDEventHandlerTest,
+                         ::testing::Values(FDEventHandler::TYPE_SELECT,
+                                           FDEventHandler::TYPE_EPOLL));
+#else
+INSTANTIATE_TEST_CASE_P(FDEventHandlerTypes, FDEventHandlerTest,
+                        ::testing::Values(FDEventHandler::TYPE_SELECT,
+                                          FDEventHandler::TYPE_EPOLL));
+#endif
+
+// Verifies the conversion of the handler type names.
+TEST(FDEventHandlerFactoryTest, typeFromText) {
+    EXPECT_EQ(FDEventHandler::TYPE_SELECT,
+              FDEventHandlerFactory::typeFromText("select"));
+    EXPECT_EQ(FDEventHandler::TYPE_EPOLL,
+              FDEventHandlerFactory::typeFromText("epoll"));
+    EXPECT_THROW(FDEventHandlerFactory::typeFromText("poll"), BadValue);
+
+    EXPECT_EQ("select",
+              FDEventHandlerFactory::typeToText(FDEventHandler::TYPE_SELECT));
+    EXPECT_EQ("epoll",
+              FDEventHandlerFactory::typeToText(FDEventHandler::TYPE_EPOLL));
+    EXPECT_EQ("unknown",
+              FDEventHandlerFactory::typeToText(FDEventHandler::TYPE_UNKNOWN));
+}
+
+// Verifies that the environment variable overrides the configured type.
+TEST(FDEventHandlerFactoryTest, defaultType) {
+    unsetenv("KEA_EVENT_HANDLER_TYPE");
+    EXPECT_EQ(FDEventHandler::TYPE_SELECT,
+              FDEventHandlerFactory::getDefaultType());
+
+    FDEventHandlerFactory::setDefaultType(FDEventHandler::TYPE_EPOLL);
+    EXPECT_EQ(FDEventHandler::TYPE_EPOLL,
+              FDEventHandlerFactory::getDefaultType());
+
+    setenv("KEA_EVENT_HANDLER_TYPE", "select", 1);
+    EXPECT_EQ(FDEventHandler::TYPE_SELECT,
+              FDEventHandlerFactory::getDefaultType());
+    EXPECT_EQ(FDEventHandler::TYPE_SELECT,
+              FDEventHandlerFactory::factoryFDEventHandler()->type());
+
+    // An invalid value is ignored.
+    setenv("KEA_EVENT_HANDLER_TYPE", "bogus", 1);
+    EXPECT_EQ(FDEventHandler::TYPE_EPOLL,
+              FDEventHandlerFactory::getDefaultType());
+
+    FDEventHandlerFactory::setDefaultType(FDEventHandler::TYPE_UNKNOWN);
+    EXPECT_EQ(FDEventHandler::TYPE_SELECT,
+              FDEventHandlerFactory::getDefaultType());
+
+    setenv("KEA_EVENT_HANDLER_TYPE", "epoll", 1);
+    EXPECT_EQ(FDEventHandler::TYPE_EPOLL,
+              FDEventHandlerFactory::getDefaultType());
+    unsetenv("KEA_EVENT_HANDLER_TYPE");
+}
+
+}
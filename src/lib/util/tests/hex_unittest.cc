@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -111,4 +111,34 @@ TEST_F(HexTest, encodeMap) {
     }
 }
 
+// Verifies that long data is encoded and decoded as the short data.
+TEST_F(HexTest, roundTrip) {
+    vector<uint8_t> data;
+    for (int i = 0; i < 256; ++i) {
+        data.push_back(i);
+    }
+    const string encoded = encodeHex(data);
+    ASSERT_EQ(512, encoded.size());
+    for (int i = 0; i < 256; ++i) {
+        EXPECT_EQ(encoding_chars[i >> 4], encoded[2 * i]);
+        EXPECT_EQ(encoding_chars[i & 0x0f], encoded[2 * i + 1]);
+    }
+    decodeHex(encoded, decoded_data);
+    EXPECT_TRUE(data == decoded_data);
+
+    // The same text with spaces and in lower case.
+    string text;
+    for (size_t i = 0; i < encoded.size(); i += 2) {
+        text += " ";
+        text += static_cast<char>(tolower(encoded[i]));
+        text += static_cast<char>(tolower(encoded[i + 1]));
+    }
+    decoded_data.clear();
+    decodeHex(text, decoded_data);
+    EXPECT_TRUE(data == decoded_data);
+
+    // An invalid character at the end.
+    EXPECT_THROW(decodeHex(encoded + "0x", decoded_data), BadValue);
+}
+
 }
@@ -80,6 +80,44 @@ TEST_F(MultiThreadingMgrTest, packetQueueSize) {
     EXPECT_EQ(MultiThreadingMgr::instance().getThreadPool().getMaxQueueSize(), 0);
 }
 
+/// @brief Verifies that the work stealing mode can be changed.
+TEST_F(MultiThreadingMgrTest, workStealing) {
+    auto& thread_pool = MultiThreadingMgr::instance().getThreadPool();
+    // default mode uses a single queue
+    EXPECT_FALSE(MultiThreadingMgr::instance().getWorkStealing());
+    // enable MT with 4 threads
+    EXPECT_NO_THROW(MultiThreadingMgr::instance().apply(true, 4, 16));
+    EXPECT_EQ(thread_pool.size(), 4);
+    // enable the work stealing mode: the thread pool is restarted
+    EXPECT_NO_THROW(MultiThreadingMgr::instance().setWorkStealing(true));
+    EXPECT_TRUE(MultiThreadingMgr::instance().getWorkStealing());
+    EXPECT_TRUE(thread_pool.getWorkStealing());
+    EXPECT_EQ(thread_pool.size(), 4);
+    EXPECT_EQ(thread_pool.getQueueDepths().size(), 4);
+    EXPECT_EQ(thread_pool.getMaxQueueSize(), 16);
+    // disable the work stealing mode
+    EXPECT_NO_THROW(MultiThreadingMgr::instance().setWorkStealing(false));
+    EXPECT_FALSE(MultiThreadingMgr::instance().getWorkStealing());
+    EXPECT_EQ(thread_pool.size(), 4);
+    // disable MT
+    EXPECT_NO_THROW(MultiThreadingMgr::instance().apply(false, 0, 0));
+    EXPECT_EQ(thread_pool.size(), 0);
+}
+
+/// @brief Verifies that the CPU affinity can be changed.
+TEST_F(MultiThreadingMgrTest, cpuAffinity) {
+    auto& thread_pool = MultiThreadingMgr::instance().getThreadPool();
+    // default is no affinity
+    EXPECT_TRUE(MultiThreadingMgr::instance().getCpuAffinity().empty());
+    // set the affinity
+    EXPECT_NO_THROW(MultiThreadingMgr::instance().setCpuAffinity(CpuList({ 0, 1 })));
+    EXPECT_EQ(MultiThreadingMgr::instance().getCpuAffinity(), CpuList({ 0, 1 }));
+    EXPECT_EQ(thread_pool.getCpuAffinity(), CpuList({ 0, 1 }));
+    // reset the affinity
+    EXPECT_NO_THROW(MultiThreadingMgr::instance().setCpuAffinity(CpuList()));
+    EXPECT_TRUE(MultiThreadingMgr::instance().getCpuAffinity().empty());
+}
+
 /// @brief Verifies that detecting thread count works.
 TEST_F(MultiThreadingMgrTest, detectThreadCount) {
     // detecting thread count should work
@@ -1,4 +1,4 @@
-// Copyright (C) 2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,10 +13,12 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 
 using namespace isc::util;
 using namespace std;
@@ -467,4 +469,59 @@ TEST_F(ReadWriteMutexTest, readWriteRead) {
     threadr->join();
 }
 
+// Verify that a writer disables the reader bias which is enabled again
+// by a later reader.
+TEST_F(ReadWriteMutexTest, readerBias) {
+    EXPECT_TRUE(rw_mutex_.isReaderBiased());
+    {
+        ReadLockGuard lock(rw_mutex_);
+        EXPECT_TRUE(rw_mutex_.isReaderBiased());
+    }
+    {
+        WriteLockGuard lock(rw_mutex_);
+        EXPECT_FALSE(rw_mutex_.isReaderBiased());
+    }
+    EXPECT_FALSE(rw_mutex_.isReaderBiased());
+
+    // The writer did not wait for readers: the bias is quickly enabled
+    // again.
+    this_thread::sleep_for(chrono::milliseconds(100));
+    {
+        ReadLockGuard lock(rw_mutex_);
+    }
+    EXPECT_TRUE(rw_mutex_.isReaderBiased());
+}
+
+// Verify that concurrent readers and writers exclude each other.
+TEST_F(ReadWriteMutexTest, concurrent) {
+    atomic<unsigned> readers(0);
+    atomic<unsigned> writers(0);
+    atomic<unsigned> errors(0);
+    vector<boost::shared_ptr<std::thread>> threads;
+    for (unsigned i = 0; i < 8; ++i) {
+        threads.push_back(boost::make_shared<std::thread>([&]() {
+            for (unsigned j = 0; j < 10000; ++j) {
+                if ((j % 100) == 0) {
+                    WriteLockGuard lock(rw_mutex_);
+                    if ((++writers != 1) || (readers != 0)) {
+                        ++errors;
+                    }
+                    --writers;
+                } else {
+                    ReadLockGuard lock(rw_mutex_);
+                    ++readers;
+                    if (writers != 0) {
+                        ++errors;
+                    }
+                    --readers;
+                }
+            }
+        }));
+    }
+    for (auto const& thread : threads) {
+        thread->join();
+    }
+    EXPECT_EQ(0, errors);
+}
+
 }
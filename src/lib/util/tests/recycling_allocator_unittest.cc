@@ -0,0 +1,97 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <util/recycling_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+using namespace isc::util;
+
+namespace {
+
+/// @brief Object counting its instances.
+struct Counted {
+    /// @brief Constructor.
+    Counted(int value, const std::string& name) : value_(value), name_(name) {
+        ++count_;
+    }
+
+    /// @brief Destructor.
+    ~Counted() {
+        --count_;
+    }
+
+    int value_;
+    std::string name_;
+    static int count_;
+};
+
+int Counted::count_ = 0;
+
+// Check that the released blocks are recycled by the thread.
+TEST(RecyclingAllocatorTest, recycle) {
+    boost::shared_ptr<Counted> obj = makeRecycled<Counted>(1, "foo");
+    ASSERT_TRUE(obj);
+    EXPECT_EQ(1, obj->value_);
+    EXPECT_EQ("foo", obj->name_);
+    EXPECT_EQ(1, Counted::count_);
+    const void* block = obj.get();
+
+    // The object is destroyed when the last reference is released.
+    obj.reset();
+    EXPECT_EQ(0, Counted::count_);
+
+    // The next object reuses the block.
+    obj = makeRecycled<Counted>(2, "bar");
+    EXPECT_EQ(block, obj.get());
+    EXPECT_EQ(2, obj->value_);
+    EXPECT_EQ("bar", obj->name_);
+    obj.reset();
+    EXPECT_EQ(0, Counted::count_);
+}
+
+// Check that the cache is bounded.
+TEST(RecyclingAllocatorTest, bounded) {
+    RecyclingAllocator<Counted> alloc;
+    size_t cached = RecyclingCache<Counted>::size();
+    std::vector<Counted*> blocks;
+    for (size_t i = 0; i < cached + RecyclingCache<Counted>::MAX_SIZE + 10; ++i) {
+        blocks.push_back(alloc.allocate(1));
+    }
+    EXPECT_EQ(0, RecyclingCache<Counted>::size());
+    for (auto block : blocks) {
+        alloc.deallocate(block, 1);
+    }
+    EXPECT_EQ(RecyclingCache<Counted>::MAX_SIZE, RecyclingCache<Counted>::size());
+}
+
+// Check that the arrays are not cached.
+TEST(RecyclingAllocatorTest, array) {
+    RecyclingAllocator<Counted> alloc;
+    size_t cached = RecyclingCache<Counted>::size();
+    Counted* array = alloc.allocate(4);
+    ASSERT_TRUE(array);
+    alloc.deallocate(array, 4);
+    EXPECT_EQ(cached, RecyclingCache<Counted>::size());
+}
+
+// Check that the objects can be released by another thread.
+TEST(RecyclingAllocatorTest, otherThread) {
+    boost::shared_ptr<Counted> obj = makeRecycled<Counted>(3, "baz");
+    std::thread thread([&obj]() {
+        obj.reset();
+    });
+    thread.join();
+    EXPECT_FALSE(obj);
+    EXPECT_EQ(0, Counted::count_);
+}
+
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -561,6 +561,30 @@ TEST(StringUtilTest, stringSanitizer) {
                        "*ab*c.12*3");
 }
 
+// Verifies the char sets compiled into a lookup table and the ones left
+// to the regex engine.
+TEST(StringUtilTest, stringSanitizerCharSets) {
+    // A closing bracket first in the list is a literal.
+    sanitizeStringTest("a]b[c", "[]a]", "*", "**b[c");
+    sanitizeStringTest("a]b[c", "[^]a]", "*", "a]***");
+
+    // A hyphen first or last in the list is a literal.
+    sanitizeStringTest("a-b", "[-a]", "*", "**b");
+    sanitizeStringTest("a-b", "[a-]", "*", "**b");
+    sanitizeStringTest("a-b", "[^a-]", "*", "a-*");
+
+    // Non ASCII characters are not valid hostname characters.
+    sanitizeStringTest("a\xc3\xa9" "b", "[^A-Za-z0-9.-]", "", "ab");
+
+    // Embedded nulls are always replaced.
+    std::string withNulls("a\000b", 3);
+    sanitizeStringTest(withNulls, "[b]", "*", "a**");
+
+    // The other regular expressions are left to the regex engine.
+    sanitizeStringTest("a1b2", "[[:digit:]]", "*", "a*b*");
+    sanitizeStringTest("abcd", "b|d", "*", "a*c*");
+}
+
 // Verifies templated buffer iterator seekTrimmed() function
 TEST(StringUtilTest, seekTrimmed) {
 
@@ -639,4 +663,22 @@ TEST(StringUtilTest, vectorIsPrintable) {
     EXPECT_FALSE(isPrintable(content));
 }
 
+// Verifies the hexadecimal dump of byte buffers.
+TEST(StringUtilTest, dumpAsHex) {
+    vector<uint8_t> content;
+    EXPECT_EQ("", dumpAsHex(content.data(), content.size()));
+
+    content = { 0x0a };
+    EXPECT_EQ("0a", dumpAsHex(content.data(), content.size()));
+
+    content = { 0x00, 0x01, 0xab, 0xcd, 0xef, 0xff };
+    EXPECT_EQ("00:01:ab:cd:ef:ff", dumpAsHex(content.data(), content.size()));
+
+    // The dump is decoded back to the same bytes.
+    vector<uint8_t> decoded;
+    decodeColonSeparatedHexString(dumpAsHex(content.data(), content.size()),
+                                  decoded);
+    EXPECT_TRUE(decoded == content);
+}
+
 } // end of anonymous namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -646,6 +646,189 @@ TEST_F(ThreadPoolTest, addFront) {
     EXPECT_EQ(thread_pool.count(), items_count);
 }
 
+/// @brief test ThreadPool work stealing mode settings.
+TEST_F(ThreadPoolTest, workStealingMode) {
+    CallBack call_back;
+    ThreadPool<CallBack> thread_pool;
+    // the default mode uses a single queue
+    EXPECT_FALSE(thread_pool.getWorkStealing());
+    ASSERT_EQ(thread_pool.getQueueDepths().size(), 1);
+
+    call_back = std::bind(&ThreadPoolTest::run, this);
+
+    // add items to stopped thread pool
+    for (uint32_t i = 0; i < 8; ++i) {
+        EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(call_back)));
+    }
+
+    // switching the mode should keep the queued items
+    EXPECT_NO_THROW(thread_pool.setWorkStealing(true));
+    EXPECT_TRUE(thread_pool.getWorkStealing());
+    EXPECT_EQ(thread_pool.count(), 8);
+    ASSERT_EQ(thread_pool.getQueueDepths().size(), 1);
+    EXPECT_EQ(thread_pool.getQueueDepths()[0], 8);
+
+    // adding an item should squeeze the queues
+    thread_pool.setMaxQueueSize(4);
+    EXPECT_EQ(thread_pool.getMaxQueueSize(), 4);
+    EXPECT_FALSE(thread_pool.add(boost::make_shared<CallBack>(call_back)));
+    EXPECT_EQ(thread_pool.count(), 4);
+    // adding an item at front should change nothing
+    EXPECT_FALSE(thread_pool.addFront(boost::make_shared<CallBack>(call_back)));
+    EXPECT_EQ(thread_pool.count(), 4);
+    thread_pool.setMaxQueueSize(0);
+
+    // the mode can't be changed when started
+    EXPECT_NO_THROW(thread_pool.start(4));
+    EXPECT_THROW(thread_pool.setWorkStealing(false), InvalidOperation);
+    ASSERT_EQ(thread_pool.getQueueDepths().size(), 4);
+    EXPECT_NO_THROW(thread_pool.wait());
+    EXPECT_EQ(thread_pool.count(), 0);
+    EXPECT_EQ(count(), 4);
+    EXPECT_NO_THROW(thread_pool.stop());
+
+    // switching back to a single queue should work
+    EXPECT_NO_THROW(thread_pool.setWorkStealing(false));
+    EXPECT_FALSE(thread_pool.getWorkStealing());
+    EXPECT_NO_THROW(thread_pool.getQueueStat(10));
+    EXPECT_NO_THROW(thread_pool.getQueueStat(100));
+    EXPECT_NO_THROW(thread_pool.getQueueStat(1000));
+}
+
+/// @brief test ThreadPool work stealing mode processing.
+TEST_F(ThreadPoolTest, workStealingWait) {
+    uint32_t items_count;
+    uint32_t thread_count;
+    CallBack call_back;
+    ThreadPool<CallBack> thread_pool;
+    thread_pool.setWorkStealing(true);
+
+    items_count = 16;
+    thread_count = 16;
+    // prepare setup
+    reset(thread_count);
+
+    // create tasks which block thread pool threads until signaled by main
+    // thread to force all threads of the thread pool to run exactly one task
+    call_back = std::bind(&ThreadPoolTest::runAndWait, this);
+
+    // add items to stopped thread pool
+    for (uint32_t i = 0; i < items_count; ++i) {
+        EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(call_back)));
+    }
+
+    // calling start should create the threads and should spread the queued
+    // items
+    EXPECT_NO_THROW(thread_pool.start(thread_count));
+    ASSERT_EQ(thread_pool.size(), thread_count);
+
+    // wait for all items to be processed
+    waitTasks(thread_count, items_count);
+    ASSERT_EQ(thread_pool.count(), 0);
+    checkIds(items_count);
+    checkRunHistory(items_count);
+
+    // check that waiting on tasks does timeout
+    ASSERT_FALSE(thread_pool.wait(1));
+
+    // signal thread pool tasks to continue
+    signalThreads();
+    ASSERT_TRUE(thread_pool.wait(10));
+    EXPECT_NO_THROW(thread_pool.stop());
+
+    items_count = 64;
+    thread_count = 16;
+    // prepare setup
+    reset(thread_count);
+
+    // create tasks which do not block the thread pool threads
+    call_back = std::bind(&ThreadPoolTest::run, this);
+
+    EXPECT_NO_THROW(thread_pool.start(thread_count));
+
+    // add items to started thread pool
+    for (uint32_t i = 0; i < items_count; ++i) {
+        EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(call_back)));
+    }
+
+    // wait for all items to be processed
+    thread_pool.wait();
+    ASSERT_EQ(thread_pool.count(), 0);
+    ASSERT_EQ(count(), items_count);
+    checkRunHistory(items_count);
+}
+
+/// @brief test ThreadPool work stealing between threads.
+TEST_F(ThreadPoolTest, workStealingSteal) {
+    uint32_t items_count;
+    uint32_t thread_count;
+    ThreadPool<CallBack> thread_pool;
+    thread_pool.setWorkStealing(true);
+    EXPECT_EQ(thread_pool.getStealCount(), 0);
+    EXPECT_EQ(thread_pool.getStolenCount(), 0);
+
+    items_count = 32;
+    thread_count = 2;
+    // prepare setup
+    reset(thread_count);
+
+    // the first item blocks a thread so the items queued behind it can
+    // only be processed by the other thread stealing them
+    EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(std::bind(&ThreadPoolTest::runAndWait, this))));
+    for (uint32_t i = 1; i < items_count; ++i) {
+        EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(std::bind(&ThreadPoolTest::run, this))));
+    }
+
+    EXPECT_NO_THROW(thread_pool.start(thread_count));
+
+    // wait for all items to be processed
+    waitTasks(thread_count, items_count);
+    ASSERT_EQ(thread_pool.count(), 0);
+    checkRunHistory(items_count);
+    EXPECT_GT(thread_pool.getStealCount(), 0);
+    EXPECT_GE(thread_pool.getStolenCount(), thread_pool.getStealCount());
+
+    // signal thread pool tasks to continue
+    signalThreads();
+    thread_pool.wait();
+    EXPECT_NO_THROW(thread_pool.stop());
+}
+
+/// @brief test ThreadPool CPU affinity.
+TEST_F(ThreadPoolTest, cpuAffinity) {
+    ThreadPool<CallBack> thread_pool;
+    EXPECT_TRUE(thread_pool.getCpuAffinity().empty());
+    CpuList cpus = getAvailableCpus();
+    if (!isCpuAffinitySupported() || cpus.empty()) {
+        return;
+    }
+    CpuList affinity({ cpus.back() });
+    thread_pool.setCpuAffinity(affinity);
+    EXPECT_EQ(thread_pool.getCpuAffinity(), affinity);
+
+    // the threads should run on the CPU
+    mutex lock;
+    list<CpuList> seen;
+    CallBack call_back = [&]() {
+        lock_guard<mutex> lk(lock);
+        seen.push_back(getAvailableCpus());
+    };
+    for (auto work_stealing : { false, true }) {
+        seen.clear();
+        thread_pool.setWorkStealing(work_stealing);
+        EXPECT_NO_THROW(thread_pool.start(2));
+        for (uint32_t i = 0; i < 8; ++i) {
+            EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(call_back)));
+        }
+        thread_pool.wait();
+        EXPECT_NO_THROW(thread_pool.stop());
+        ASSERT_EQ(seen.size(), 8);
+        for (auto const& used : seen) {
+            EXPECT_EQ(used, affinity);
+        }
+    }
+}
+
 /// @brief test ThreadPool get queue statistics.
 TEST_F(ThreadPoolTest, getQueueStat) {
     ThreadPool<CallBack> thread_pool;
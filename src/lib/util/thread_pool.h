@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,6 +8,7 @@
 #define THREAD_POOL_H
 
 #include <exceptions/exceptions.h>
+#include <util/cpu_affinity.h>
 #include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
 
@@ -15,10 +16,12 @@
 #include <chrono>
 #include <cmath>
 #include <condition_variable>
+#include <deque>
 #include <list>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <vector>
 
 #include <signal.h>
 
@@ -28,6 +31,12 @@ namespace util {
 /// @brief Defines a thread pool which uses a thread pool queue for managing
 /// work items. Each work item is a 'functor' object.
 ///
+/// By default all threads share a single queue. In the work stealing mode
+/// each thread has its own queue: work items are spread over the queues,
+/// a thread running out of work steals half of the items of another
+/// thread and spins for a while before blocking when there is nothing to
+/// steal, so the threads do not contend on a single mutex.
+///
 /// @tparam WorkItem a functor
 /// @tparam Container a 'queue like' container
 template <typename WorkItem, typename Container = std::deque<boost::shared_ptr<WorkItem>>>
@@ -41,11 +50,15 @@ struct ThreadPool {
     /// @brief Rounding value for 1000 packet statistic.
     static const double CEXP1000;
 
+    /// @brief Number of attempts to find work before blocking in the work
+    /// stealing mode.
+    static const size_t SPIN_COUNT = 64;
+
     /// @brief Type of shared pointers to work items.
     typedef typename boost::shared_ptr<WorkItem> WorkItemPtr;
 
     /// @brief Constructor
-    ThreadPool() {
+    ThreadPool() : work_stealing_(false) {
     }
 
     /// @brief Destructor
@@ -60,6 +73,58 @@ struct ThreadPool {
     void reset() {
         stopInternal();
         queue_.clear();
+        stealing_queue_.clear();
+    }
+
+    /// @brief set the work stealing mode
+    ///
+    /// The work items already queued are moved to the queue(s) of the new
+    /// mode.
+    ///
+    /// @param work_stealing true to use per thread queues and work
+    /// stealing, false to use a single queue
+    /// @throw InvalidOperation if thread pool already started
+    void setWorkStealing(bool work_stealing) {
+        if (queue_.enabled() || stealing_queue_.enabled()) {
+            isc_throw(InvalidOperation, "thread pool already started");
+        }
+        if (work_stealing == work_stealing_) {
+            return;
+        }
+        if (work_stealing) {
+            for (auto const& item : queue_.takeAll()) {
+                stealing_queue_.pushBack(item);
+            }
+        } else {
+            for (auto const& item : stealing_queue_.takeAll()) {
+                queue_.pushBack(item);
+            }
+        }
+        work_stealing_ = work_stealing;
+    }
+
+    /// @brief get the work stealing mode
+    ///
+    /// @return true if the work stealing mode is used, false otherwise
+    bool getWorkStealing() const {
+        return (work_stealing_);
+    }
+
+    /// @brief set the CPUs the threads are bound to
+    ///
+    /// The thread of index i is bound to the CPU of index i modulo the
+    /// number of CPUs. The setting is applied when the threads are started.
+    ///
+    /// @param cpus the CPU list, empty to not bind the threads
+    void setCpuAffinity(const CpuList& cpus) {
+        cpus_ = cpus;
+    }
+
+    /// @brief get the CPUs the threads are bound to
+    ///
+    /// @return the CPU list, empty when the threads are not bound
+    const CpuList& getCpuAffinity() const {
+        return (cpus_);
     }
 
     /// @brief start all the threads
@@ -73,7 +138,7 @@ struct ThreadPool {
         if (!thread_count) {
             isc_throw(InvalidParameter, "thread count is 0");
         }
-        if (queue_.enabled()) {
+        if (queue_.enabled() || stealing_queue_.enabled()) {
             isc_throw(InvalidOperation, "thread pool already started");
         }
         startInternal(thread_count);
@@ -83,7 +148,7 @@ struct ThreadPool {
     ///
     /// @throw InvalidOperation if thread pool already stopped
     void stop() {
-        if (!queue_.enabled()) {
+        if (!queue_.enabled() && !stealing_queue_.enabled()) {
             isc_throw(InvalidOperation, "thread pool already stopped");
         }
         stopInternal();
@@ -95,14 +160,23 @@ struct ThreadPool {
     /// @return false if the queue was full and oldest item(s) was dropped,
     /// true otherwise.
     bool add(const WorkItemPtr& item) {
+        if (work_stealing_) {
+            return (stealing_queue_.pushBack(item));
+        }
         return (queue_.pushBack(item));
     }
 
     /// @brief add a work item to the thread pool at front
     ///
+    /// In the work stealing mode an item added by a worker thread goes to
+    /// the front of the queue of this thread.
+    ///
     /// @param item the 'functor' object to be added to the queue
     /// @return false if the queue was full, true otherwise.
     bool addFront(const WorkItemPtr& item) {
+        if (work_stealing_) {
+            return (stealing_queue_.pushFront(item));
+        }
         return (queue_.pushFront(item));
     }
 
@@ -110,6 +184,9 @@ struct ThreadPool {
     ///
     /// @return the number of work items in the queue
     size_t count() {
+        if (work_stealing_) {
+            return (stealing_queue_.count());
+        }
         return (queue_.count());
     }
 
@@ -122,6 +199,10 @@ struct ThreadPool {
         if (checkThreadId(id)) {
             isc_throw(MultiThreadingInvalidOperation, "thread pool wait called by worker thread");
         }
+        if (work_stealing_) {
+            stealing_queue_.wait();
+            return;
+        }
         queue_.wait();
     }
 
@@ -137,6 +218,9 @@ struct ThreadPool {
         if (checkThreadId(id)) {
             isc_throw(MultiThreadingInvalidOperation, "thread pool wait with timeout called by worker thread");
         }
+        if (work_stealing_) {
+            return (stealing_queue_.wait(seconds));
+        }
         return (queue_.wait(seconds));
     }
 
@@ -145,6 +229,7 @@ struct ThreadPool {
     /// @param max_queue_size the maximum size (0 means unlimited)
     void setMaxQueueSize(size_t max_queue_size) {
         queue_.setMaxQueueSize(max_queue_size);
+        stealing_queue_.setMaxQueueSize(max_queue_size);
     }
 
     /// @brief get maximum number of work items in the queue
@@ -167,9 +252,39 @@ struct ThreadPool {
     /// @return the queue length statistic
     /// @throw InvalidParameter if which is not 10 and 100 and 1000.
     double getQueueStat(size_t which) {
+        if (work_stealing_) {
+            return (stealing_queue_.getQueueStat(which));
+        }
         return (queue_.getQueueStat(which));
     }
 
+    /// @brief get the number of work items in the queue of each thread
+    ///
+    /// @return the queue depths in the work stealing mode, the depth of
+    /// the single queue otherwise
+    std::vector<size_t> getQueueDepths() {
+        if (work_stealing_) {
+            return (stealing_queue_.getQueueDepths());
+        }
+        return (std::vector<size_t>(1, queue_.count()));
+    }
+
+    /// @brief get the number of successful steals
+    ///
+    /// @return the number of times a thread stole work items from another
+    /// thread since the construction of the thread pool
+    uint64_t getStealCount() {
+        return (stealing_queue_.getStealCount());
+    }
+
+    /// @brief get the number of stolen work items
+    ///
+    /// @return the number of work items moved by steals since the
+    /// construction of the thread pool
+    uint64_t getStolenCount() {
+        return (stealing_queue_.getStolenCount());
+    }
+
 private:
     /// @brief start all the threads
     ///
@@ -185,10 +300,18 @@ private:
         sigaddset(&sset, SIGHUP);
         sigaddset(&sset, SIGTERM);
         pthread_sigmask(SIG_BLOCK, &sset, &osset);
-        queue_.enable(thread_count);
+        if (work_stealing_) {
+            stealing_queue_.enable(thread_count);
+        } else {
+            queue_.enable(thread_count);
+        }
         try {
             for (uint32_t i = 0; i < thread_count; ++i) {
-                threads_.push_back(boost::make_shared<std::thread>(&ThreadPool::run, this));
+                if (work_stealing_) {
+                    threads_.push_back(boost::make_shared<std::thread>(&ThreadPool::runStealing, this, i));
+                } else {
+                    threads_.push_back(boost::make_shared<std::thread>(&ThreadPool::run, this, i));
+                }
             }
         } catch (...) {
             // Restore signal mask.
@@ -206,6 +329,7 @@ private:
             isc_throw(MultiThreadingInvalidOperation, "thread pool stop called by worker thread");
         }
         queue_.disable();
+        stealing_queue_.disable();
         for (auto thread : threads_) {
             thread->join();
         }
@@ -421,6 +545,17 @@ private:
             wait_cv_.notify_all();
         }
 
+        /// @brief remove and return all work items
+        ///
+        /// @return the queued work items in queue order
+        std::vector<Item> takeAll() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::vector<Item> items(queue_.begin(), queue_.end());
+            queue_ = QueueContainer();
+            wait_cv_.notify_all();
+            return (items);
+        }
+
         /// @brief enable the queue
         ///
         /// Sets the queue state to 'enabled'
@@ -488,8 +623,536 @@ private:
         double stat1000;
     };
 
+    /// @brief Defines a work stealing thread pool queue.
+    ///
+    /// The work items are held in one queue per thread, each protected by
+    /// its own mutex. Work items added by other threads are spread over
+    /// the queues in round robin order. A thread takes work items from the
+    /// front of its own queue and, when it is empty, steals the newest half
+    /// of the work items of another thread. A thread finding no work spins
+    /// for @c SPIN_COUNT attempts and then blocks until a work item is
+    /// added.
+    /// As the thread pool queue, the work stealing queue can be 'disabled'
+    /// or 'enabled'.
+    ///
+    /// @tparam Item a 'smart pointer' to a functor
+    template <typename Item>
+    struct WorkStealingQueue {
+        /// @brief Constructor
+        ///
+        /// Creates the work stealing queue in 'disabled' state with one
+        /// queue for work items added before it is enabled.
+        WorkStealingQueue()
+            : enabled_(false), max_queue_size_(0), queued_(0), pending_(0),
+              sleepers_(0), next_(0), steals_(0), stolen_(0) {
+            workers_.push_back(boost::make_shared<Worker>());
+        }
+
+        /// @brief Destructor
+        ///
+        /// Destroys the work stealing queue
+        ~WorkStealingQueue() {
+            disable();
+            clear();
+        }
+
+        /// @brief set maximum number of work items in the queues
+        ///
+        /// @param max_queue_size the maximum size (0 means unlimited)
+        void setMaxQueueSize(size_t max_queue_size) {
+            max_queue_size_ = max_queue_size;
+        }
+
+        /// @brief get maximum number of work items in the queues
+        ///
+        /// @return the maximum size (0 means unlimited)
+        size_t getMaxQueueSize() {
+            return (max_queue_size_);
+        }
+
+        /// @brief push work item to the queues
+        ///
+        /// Used to add work items to the queue of the next thread in
+        /// round robin order.
+        /// When the queues are full oldest items of this queue are removed
+        /// and false is returned.
+        ///
+        /// @param item the new item to be added to the queues
+        /// @return false if the queues were full and oldest item(s) dropped,
+        /// true otherwise
+        bool pushBack(const Item& item) {
+            bool ret = true;
+            if (!item) {
+                return (ret);
+            }
+            Worker& worker = *workers_[next_++ % workers_.size()];
+            {
+                std::lock_guard<std::mutex> lock(worker.mutex_);
+                size_t max_queue_size = max_queue_size_;
+                if (max_queue_size != 0) {
+                    while ((queued_ >= max_queue_size) && !worker.items_.empty()) {
+                        worker.items_.pop_front();
+                        --queued_;
+                        --pending_;
+                        ret = false;
+                    }
+                }
+                worker.items_.push_back(item);
+                worker.size_ = worker.items_.size();
+                ++queued_;
+                ++pending_;
+            }
+            wakeUp();
+            return (ret);
+        }
+
+        /// @brief push work item to the queues at front.
+        ///
+        /// Used to add work items at the front of the queue of the calling
+        /// thread or of the next thread in round robin order when the
+        /// calling thread is not a thread of the pool.
+        /// When the queues are full the item is not added.
+        ///
+        /// @param item the new item to be added to the queues
+        /// @return false if the queues were full, true otherwise
+        bool pushFront(const Item& item) {
+            if (!item) {
+                return (true);
+            }
+            size_t max_queue_size = max_queue_size_;
+            if ((max_queue_size != 0) && (queued_ >= max_queue_size)) {
+                return (false);
+            }
+            size_t index = getLocalIndex();
+            if (index >= workers_.size()) {
+                index = next_++ % workers_.size();
+            }
+            Worker& worker = *workers_[index];
+            {
+                std::lock_guard<std::mutex> lock(worker.mutex_);
+                worker.items_.push_front(item);
+                worker.size_ = worker.items_.size();
+                ++queued_;
+                ++pending_;
+            }
+            wakeUp();
+            return (true);
+        }
+
+        /// @brief pop work item from the queues or block waiting
+        ///
+        /// Used by a thread of the pool to retrieve and remove a work item
+        /// from its queue or from the queue of another thread.
+        /// If the queue is 'disabled', this function returns immediately an
+        /// empty element.
+        /// If the queue is 'enabled', this function returns a work item or
+        /// blocks the calling thread if there are no work items available.
+        /// Before a work item is returned statistics are updated.
+        ///
+        /// @param index the index of the calling thread
+        /// @return a work item from the queues or an empty element.
+        Item pop(size_t index) {
+            for (;;) {
+                for (size_t spin = 0; ; ++spin) {
+                    if (!enabled_) {
+                        return (Item());
+                    }
+                    Item item;
+                    if (popLocal(index, item) || steal(index, item)) {
+                        return (item);
+                    }
+                    if (spin >= SPIN_COUNT) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+                // Wait for push or disable functions.
+                std::unique_lock<std::mutex> lock(park_mutex_);
+                ++sleepers_;
+                park_cv_.wait(lock, [&]() {return (!enabled_ || (queued_ != 0));});
+                --sleepers_;
+            }
+        }
+
+        /// @brief signal a work item returned by pop was processed
+        void done() {
+            if (--pending_ == 0) {
+                std::lock_guard<std::mutex> lock(wait_mutex_);
+                wait_cv_.notify_all();
+            }
+        }
+
+        /// @brief count number of work items in the queues
+        ///
+        /// @return the number of work items
+        size_t count() {
+            return (queued_);
+        }
+
+        /// @brief wait for current items to be processed
+        ///
+        /// Used to block the calling thread until all items in the queues
+        /// have been processed
+        void wait() {
+            std::unique_lock<std::mutex> lock(wait_mutex_);
+            wait_cv_.wait(lock, [&]() {return (pending_ == 0);});
+        }
+
+        /// @brief wait for items to be processed or return after timeout
+        ///
+        /// Used to block the calling thread until all items in the queues
+        /// have been processed or return after timeout
+        ///
+        /// @param seconds the time in seconds to wait for tasks to finish
+        /// @return true if all tasks finished, false on timeout
+        bool wait(uint32_t seconds) {
+            std::unique_lock<std::mutex> lock(wait_mutex_);
+            return (wait_cv_.wait_for(lock, std::chrono::seconds(seconds),
+                                      [&]() {return (pending_ == 0);}));
+        }
+
+        /// @brief get queue length statistic
+        ///
+        /// The statistic is the average of the statistic of each thread.
+        ///
+        /// @param which select the statistic (10, 100 or 1000)
+        /// @return the queue length statistic
+        /// @throw InvalidParameter if which is not 10 and 100 and 1000.
+        double getQueueStat(size_t which) {
+            if ((which != 10) && (which != 100) && (which != 1000)) {
+                isc_throw(InvalidParameter, "supported statistic for "
+                          << "10/100/1000 only, not " << which);
+            }
+            double stat = 0.;
+            for (auto const& worker : workers_) {
+                std::lock_guard<std::mutex> lock(worker->mutex_);
+                stat += worker->getStat(which);
+            }
+            return (stat / workers_.size());
+        }
+
+        /// @brief get the number of work items in the queue of each thread
+        ///
+        /// @return the queue depths
+        std::vector<size_t> getQueueDepths() {
+            std::vector<size_t> depths;
+            for (auto const& worker : workers_) {
+                depths.push_back(worker->size_);
+            }
+            return (depths);
+        }
+
+        /// @brief get the number of successful steals
+        ///
+        /// @return the number of steals
+        uint64_t getStealCount() {
+            return (steals_);
+        }
+
+        /// @brief get the number of stolen work items
+        ///
+        /// @return the number of stolen work items
+        uint64_t getStolenCount() {
+            return (stolen_);
+        }
+
+        /// @brief clear remove all work items
+        ///
+        /// Removes all queued work items
+        void clear() {
+            takeAll();
+            pending_ = 0;
+            std::lock_guard<std::mutex> lock(wait_mutex_);
+            wait_cv_.notify_all();
+        }
+
+        /// @brief remove and return all work items
+        ///
+        /// @return the queued work items, thread queue after thread queue
+        std::vector<Item> takeAll() {
+            std::vector<Item> items;
+            for (auto const& worker : workers_) {
+                std::lock_guard<std::mutex> lock(worker->mutex_);
+                items.insert(items.end(), worker->items_.begin(), worker->items_.end());
+                queued_ -= worker->items_.size();
+                pending_ -= worker->items_.size();
+                worker->items_.clear();
+                worker->size_ = 0;
+            }
+            if (pending_ == 0) {
+                std::lock_guard<std::mutex> lock(wait_mutex_);
+                wait_cv_.notify_all();
+            }
+            return (items);
+        }
+
+        /// @brief enable the queue
+        ///
+        /// Sets the queue state to 'enabled' and creates one queue per
+        /// thread. Queued work items are spread over the new queues.
+        /// Must not be called concurrently with other functions.
+        ///
+        /// @param thread_count number of working threads
+        void enable(uint32_t thread_count) {
+            double stat10 = getQueueStat(10);
+            double stat100 = getQueueStat(100);
+            double stat1000 = getQueueStat(1000);
+            std::vector<Item> items;
+            for (auto const& worker : workers_) {
+                items.insert(items.end(), worker->items_.begin(), worker->items_.end());
+            }
+            std::vector<WorkerPtr> workers;
+            for (uint32_t i = 0; i < thread_count; ++i) {
+                WorkerPtr worker(boost::make_shared<Worker>());
+                worker->stat10 = stat10;
+                worker->stat100 = stat100;
+                worker->stat1000 = stat1000;
+                workers.push_back(worker);
+            }
+            for (size_t i = 0; i < items.size(); ++i) {
+                Worker& worker = *workers[i % thread_count];
+                worker.items_.push_back(items[i]);
+                worker.size_ = worker.items_.size();
+            }
+            workers_.swap(workers);
+            enabled_ = true;
+        }
+
+        /// @brief disable the queue
+        ///
+        /// Sets the queue state to 'disabled'
+        void disable() {
+            {
+                std::lock_guard<std::mutex> lock(park_mutex_);
+                enabled_ = false;
+            }
+            // Notify pop so that it can exit.
+            park_cv_.notify_all();
+        }
+
+        /// @brief return the state of the queue
+        ///
+        /// @return the state
+        bool enabled() {
+            return (enabled_);
+        }
+
+        /// @brief set the index of the calling thread
+        ///
+        /// @param index the index of the thread in the pool
+        void setLocalIndex(size_t index) {
+            LocalIndex& local = getLocal();
+            local.queue_ = this;
+            local.index_ = index;
+        }
+
+    private:
+        /// @brief Structure holding the queue of a thread.
+        struct Worker {
+            /// @brief Constructor
+            Worker() : size_(0), stat10(0.), stat100(0.), stat1000(0.) {
+            }
+
+            /// @brief get queue length statistic
+            ///
+            /// @param which select the statistic (10, 100 or 1000)
+            /// @return the queue length statistic
+            double getStat(size_t which) const {
+                switch (which) {
+                case 10:
+                    return (stat10);
+                case 100:
+                    return (stat100);
+                default:
+                    return (stat1000);
+                }
+            }
+
+            /// @brief mutex used for critical sections
+            std::mutex mutex_;
+
+            /// @brief the work items of the thread
+            std::deque<Item> items_;
+
+            /// @brief the number of work items, readable without the mutex
+            std::atomic<size_t> size_;
+
+            /// @brief queue length statistic for 10 packets
+            double stat10;
+
+            /// @brief queue length statistic for 100 packets
+            double stat100;
+
+            /// @brief queue length statistic for 1000 packets
+            double stat1000;
+        };
+
+        /// @brief Type of shared pointers to thread queues.
+        typedef boost::shared_ptr<Worker> WorkerPtr;
+
+        /// @brief Structure identifying the thread pool thread.
+        struct LocalIndex {
+            /// @brief the queue of the thread pool of the thread
+            const void* queue_;
+
+            /// @brief the index of the thread in the pool
+            size_t index_;
+        };
+
+        /// @brief get the thread local index
+        ///
+        /// @return the thread local index structure
+        static LocalIndex& getLocal() {
+            static thread_local LocalIndex local = { 0, 0 };
+            return (local);
+        }
+
+        /// @brief get the index of the calling thread
+        ///
+        /// @return the index of the calling thread or the number of
+        /// threads when it is not a thread of the pool
+        size_t getLocalIndex() {
+            LocalIndex& local = getLocal();
+            if (local.queue_ != this) {
+                return (workers_.size());
+            }
+            return (local.index_);
+        }
+
+        /// @brief wake up a blocked thread if any
+        void wakeUp() {
+            if (sleepers_ != 0) {
+                std::lock_guard<std::mutex> lock(park_mutex_);
+                park_cv_.notify_one();
+            }
+        }
+
+        /// @brief pop a work item from the queue of a thread
+        ///
+        /// @param index the index of the thread
+        /// @param item the work item
+        /// @return true if a work item was found, false otherwise
+        bool popLocal(size_t index, Item& item) {
+            Worker& worker = *workers_[index];
+            if (worker.size_ == 0) {
+                return (false);
+            }
+            std::lock_guard<std::mutex> lock(worker.mutex_);
+            if (worker.items_.empty()) {
+                return (false);
+            }
+            size_t length = queued_;
+            worker.stat10 = worker.stat10 * CEXP10 + (1 - CEXP10) * length;
+            worker.stat100 = worker.stat100 * CEXP100 + (1 - CEXP100) * length;
+            worker.stat1000 = worker.stat1000 * CEXP1000 + (1 - CEXP1000) * length;
+            item = worker.items_.front();
+            worker.items_.pop_front();
+            worker.size_ = worker.items_.size();
+            --queued_;
+            return (true);
+        }
+
+        /// @brief steal half of the work items of another thread
+        ///
+        /// The first stolen work item is returned, the others are moved to
+        /// the queue of the thief.
+        ///
+        /// @param index the index of the thief thread
+        /// @param item the work item
+        /// @return true if work items were stolen, false otherwise
+        bool steal(size_t index, Item& item) {
+            size_t count = workers_.size();
+            for (size_t i = 1; (i < count) && (queued_ != 0); ++i) {
+                Worker& victim = *workers_[(index + i) % count];
+                if (victim.size_ == 0) {
+                    continue;
+                }
+                std::vector<Item> items;
+                {
+                    std::lock_guard<std::mutex> lock(victim.mutex_);
+                    size_t half = (victim.items_.size() + 1) / 2;
+                    if (half == 0) {
+                        continue;
+                    }
+                    items.assign(victim.items_.end() - half, victim.items_.end());
+                    victim.items_.erase(victim.items_.end() - half, victim.items_.end());
+                    victim.size_ = victim.items_.size();
+                }
+                ++steals_;
+                stolen_ += items.size();
+                item = items.front();
+                --queued_;
+                if (items.size() > 1) {
+                    Worker& worker = *workers_[index];
+                    {
+                        std::lock_guard<std::mutex> lock(worker.mutex_);
+                        worker.items_.insert(worker.items_.end(), items.begin() + 1, items.end());
+                        worker.size_ = worker.items_.size();
+                    }
+                    // Let another blocked thread steal from the thief.
+                    wakeUp();
+                }
+                return (true);
+            }
+            return (false);
+        }
+
+        /// @brief the queues of the threads
+        std::vector<WorkerPtr> workers_;
+
+        /// @brief mutex used to block threads with nothing to do
+        std::mutex park_mutex_;
+
+        /// @brief condition variable used to signal blocked threads
+        std::condition_variable park_cv_;
+
+        /// @brief mutex used to wait for all items to be processed
+        std::mutex wait_mutex_;
+
+        /// @brief condition variable used to wait for all items to be processed
+        std::condition_variable wait_cv_;
+
+        /// @brief the sate of the queue
+        std::atomic<bool> enabled_;
+
+        /// @brief maximum number of work items in the queues
+        /// (0 means unlimited)
+        std::atomic<size_t> max_queue_size_;
+
+        /// @brief number of queued work items
+        std::atomic<size_t> queued_;
+
+        /// @brief number of queued or being processed work items
+        std::atomic<size_t> pending_;
+
+        /// @brief number of blocked threads
+        std::atomic<size_t> sleepers_;
+
+        /// @brief round robin counter of the thread queues
+        std::atomic<size_t> next_;
+
+        /// @brief number of successful steals
+        std::atomic<uint64_t> steals_;
+
+        /// @brief number of stolen work items
+        std::atomic<uint64_t> stolen_;
+    };
+
+    /// @brief bind the calling thread to its CPU if any
+    ///
+    /// @param index the index of the thread
+    void bindThread(size_t index) {
+        if (!cpus_.empty()) {
+            // The thread runs on any CPU when it can't be bound.
+            static_cast<void>(setThreadCpuAffinity(cpus_[index % cpus_.size()]));
+        }
+    }
+
     /// @brief run function of each thread
-    void run() {
+    ///
+    /// @param index the index of the thread
+    void run(size_t index) {
+        bindThread(index);
         while (queue_.enabled()) {
             WorkItemPtr item = queue_.pop();
             if (item) {
@@ -502,11 +1165,39 @@ private:
         }
     }
 
+    /// @brief run function of each thread in the work stealing mode
+    ///
+    /// @param index the index of the thread
+    void runStealing(size_t index) {
+        bindThread(index);
+        stealing_queue_.setLocalIndex(index);
+        while (stealing_queue_.enabled()) {
+            WorkItemPtr item = stealing_queue_.pop(index);
+            if (item) {
+                try {
+                    (*item)();
+                } catch (...) {
+                    // catch all exceptions
+                }
+                stealing_queue_.done();
+            }
+        }
+    }
+
     /// @brief list of worker threads
     std::vector<boost::shared_ptr<std::thread>> threads_;
 
     /// @brief underlying work items queue
     ThreadPoolQueue<WorkItemPtr, Container> queue_;
+
+    /// @brief underlying work items queues in the work stealing mode
+    WorkStealingQueue<WorkItemPtr> stealing_queue_;
+
+    /// @brief the work stealing mode
+    bool work_stealing_;
+
+    /// @brief the CPUs the threads are bound to
+    CpuList cpus_;
 };
 
 /// Initialize the 10 packet rounding to exp(-.1)
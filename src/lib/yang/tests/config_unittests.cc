@@ -17,6 +17,7 @@
 #include <yang/yang_models.h>
 
 #include <iostream>
+#include <set>
 #include <vector>
 
 #include <boost/algorithm/string.hpp>
@@ -376,6 +377,93 @@ TEST_F(ConfigTestKeaV6, examples6) {
     }
 }
 
+// Check the xpaths of the subnet entries holding changed nodes.
+TEST(ConfigXpathTest, getSubnetXpath) {
+    string xpath;
+    EXPECT_TRUE(TranslatorConfig::getSubnetXpath(KEA_DHCP4_SERVER,
+        "/kea-dhcp4-server:config/subnet4[id='1']", xpath));
+    EXPECT_EQ("/kea-dhcp4-server:config/subnet4[id='1']", xpath);
+    EXPECT_TRUE(TranslatorConfig::getSubnetXpath(KEA_DHCP4_SERVER,
+        "/kea-dhcp4-server:config/subnet4[id='12']/pool"
+        "[start-address='192.0.2.1'][end-address='192.0.2.10']/pool-prefix",
+        xpath));
+    EXPECT_EQ("/kea-dhcp4-server:config/subnet4[id='12']", xpath);
+    EXPECT_TRUE(TranslatorConfig::getSubnetXpath(KEA_DHCP6_SERVER,
+        "/kea-dhcp6-server:config/shared-network[name='foo']"
+        "/subnet6[id='3']/valid-lifetime", xpath));
+    EXPECT_EQ("/kea-dhcp6-server:config/shared-network[name='foo']"
+              "/subnet6[id='3']", xpath);
+
+    // Not in a subnet entry.
+    EXPECT_FALSE(TranslatorConfig::getSubnetXpath(KEA_DHCP4_SERVER,
+        "/kea-dhcp4-server:config/valid-lifetime", xpath));
+    EXPECT_FALSE(TranslatorConfig::getSubnetXpath(KEA_DHCP4_SERVER,
+        "/kea-dhcp4-server:config/shared-network[name='foo']/valid-lifetime",
+        xpath));
+    // Wrong model or family.
+    EXPECT_FALSE(TranslatorConfig::getSubnetXpath(KEA_DHCP6_SERVER,
+        "/kea-dhcp6-server:config/subnet4[id='1']", xpath));
+    EXPECT_FALSE(TranslatorConfig::getSubnetXpath(IETF_DHCPV6_SERVER,
+        "/ietf-dhcpv6-server:server/server-config", xpath));
+}
+
+// Check the incremental translation of changed subnets.
+TEST_F(ConfigTestKeaV4, updateSubnets) {
+    string const before = R"({
+        "Dhcp4": {
+            "subnet4": [
+                { "id": 1, "subnet": "192.0.2.0/24" },
+                { "id": 2, "subnet": "192.0.3.0/24" }
+            ],
+            "shared-networks": [
+                {
+                    "name": "foo",
+                    "subnet4": [ { "id": 10, "subnet": "10.0.0.0/24" } ]
+                }
+            ]
+        }
+    })";
+    ASSERT_NO_THROW_LOG(load(before));
+    ConstElementPtr applied;
+    ASSERT_NO_THROW_LOG(applied = getJSON());
+    ASSERT_TRUE(applied);
+
+    // Change the first subnet, remove the second, add a third and empty
+    // the shared network.
+    resetSession();
+    string const after = R"({
+        "Dhcp4": {
+            "subnet4": [
+                { "id": 1, "subnet": "192.0.2.0/24", "valid-lifetime": 100 },
+                { "id": 3, "subnet": "192.0.4.0/24" }
+            ],
+            "shared-networks": [ { "name": "foo" } ]
+        }
+    })";
+    ASSERT_NO_THROW_LOG(load(after));
+    set<string> const xpaths = {
+        "/kea-dhcp4-server:config/subnet4[id='1']",
+        "/kea-dhcp4-server:config/subnet4[id='2']",
+        "/kea-dhcp4-server:config/subnet4[id='3']",
+        "/kea-dhcp4-server:config/shared-network[name='foo']/subnet4[id='10']"
+    };
+    TranslatorConfig tc(session_, model_);
+    ElementPtr config;
+    ASSERT_NO_THROW_LOG(config = tc.updateSubnets(applied, xpaths));
+    ASSERT_TRUE(config);
+    EXPECT_TRUE(verify(config));
+
+    // The applied configuration is not modified.
+    EXPECT_EQ(2, applied->get("Dhcp4")->get("subnet4")->size());
+
+    // An unknown shared network requires the full translation.
+    set<string> const unknown = {
+        "/kea-dhcp4-server:config/shared-network[name='bar']/subnet4[id='1']"
+    };
+    ASSERT_NO_THROW_LOG(config = tc.updateSubnets(applied, unknown));
+    EXPECT_FALSE(config);
+}
+
 // Check the example in the design document.
 TEST_F(ConfigTestIetfV6, designExample) {
     ASSERT_NO_THROW_LOG(load(designExampleTree));
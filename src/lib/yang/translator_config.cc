@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,6 +10,7 @@
 #include <yang/translator_config.h>
 #include <yang/yang_models.h>
 
+#include <regex>
 #include <sstream>
 
 using namespace std;
@@ -62,6 +63,155 @@ TranslatorConfig::getConfig() {
               "getConfig not implemented for the model: " << model_);
 }
 
+namespace {
+
+/// @brief Parse the xpath of a node in a subnet entry.
+///
+/// @param model The model name.
+/// @param path The xpath of the node.
+/// @param xpath Set to the xpath of the subnet entry.
+/// @param network Set to the name of the shared network, empty for a
+/// top level subnet.
+/// @param id Set to the subnet identifier.
+/// @return true if the node belongs to a subnet entry.
+bool
+parseSubnetXpath(string const& model, string const& path, string& xpath,
+                 string& network, int64_t& id) {
+    string subnet;
+    if (model == KEA_DHCP4_SERVER) {
+        subnet = "subnet4";
+    } else if (model == KEA_DHCP6_SERVER) {
+        subnet = "subnet6";
+    } else {
+        return (false);
+    }
+    // Names holding quotes are quoted differently: they are not handled.
+    regex const expr("^(/" + model + ":config"
+                     "(?:/shared-network\\[name='([^']*)'\\])?"
+                     "/" + subnet + "\\[id='([0-9]+)'\\])(?:/.*)?$");
+    smatch match;
+    if (!regex_match(path, match, expr)) {
+        return (false);
+    }
+    try {
+        id = stoll(match[3].str());
+    } catch (...) {
+        return (false);
+    }
+    xpath = match[1].str();
+    network = match[2].str();
+    return (true);
+}
+
+/// @brief Find a map by the value of an entry in a list.
+///
+/// @param list The list.
+/// @param name The name of the entry.
+/// @param value The value of the entry.
+/// @return The index of the map or -1 when not found.
+template <typename T>
+int
+findInList(ConstElementPtr list, string const& name, T const& value);
+
+template <>
+int
+findInList(ConstElementPtr list, string const& name, string const& value) {
+    for (size_t i = 0; i < list->size(); ++i) {
+        ConstElementPtr entry = list->get(i)->get(name);
+        if (entry && (entry->getType() == Element::string) &&
+            (entry->stringValue() == value)) {
+            return (static_cast<int>(i));
+        }
+    }
+    return (-1);
+}
+
+template <>
+int
+findInList(ConstElementPtr list, string const& name, int64_t const& value) {
+    for (size_t i = 0; i < list->size(); ++i) {
+        ConstElementPtr entry = list->get(i)->get(name);
+        if (entry && (entry->getType() == Element::integer) &&
+            (entry->intValue() == value)) {
+            return (static_cast<int>(i));
+        }
+    }
+    return (-1);
+}
+
+}  // namespace
+
+bool
+TranslatorConfig::getSubnetXpath(string const& model, string const& path,
+                                 string& xpath) {
+    string network;
+    int64_t id;
+    return (parseSubnetXpath(model, path, xpath, network, id));
+}
+
+ElementPtr
+TranslatorConfig::updateSubnets(ConstElementPtr config,
+                                set<string> const& xpaths) {
+    string const dhcp_name((model_ == KEA_DHCP4_SERVER) ? "Dhcp4" : "Dhcp6");
+    string const subnet_name((model_ == KEA_DHCP4_SERVER) ? "subnet4" : "subnet6");
+    if (!config || (config->getType() != Element::map)) {
+        return (ElementPtr());
+    }
+    ElementPtr result = copy(config);
+    ElementPtr dhcp = boost::const_pointer_cast<Element>(result->get(dhcp_name));
+    if (!dhcp || (dhcp->getType() != Element::map)) {
+        return (ElementPtr());
+    }
+    for (string const& path : xpaths) {
+        string xpath;
+        string network;
+        int64_t id;
+        if (!parseSubnetXpath(model_, path, xpath, network, id)) {
+            return (ElementPtr());
+        }
+
+        // Get the map holding the subnet list.
+        ElementPtr parent = dhcp;
+        if (!network.empty()) {
+            ConstElementPtr networks = dhcp->get("shared-networks");
+            if (!networks || (networks->getType() != Element::list)) {
+                return (ElementPtr());
+            }
+            int index = findInList(networks, "name", network);
+            if (index < 0) {
+                return (ElementPtr());
+            }
+            parent = boost::const_pointer_cast<Element>(networks->get(index));
+        }
+        ElementPtr subnets =
+            boost::const_pointer_cast<Element>(parent->get(subnet_name));
+        if (subnets && (subnets->getType() != Element::list)) {
+            return (ElementPtr());
+        }
+
+        ElementPtr subnet = getSubnetFromAbsoluteXpath(xpath);
+        int index = (subnets ? findInList(subnets, "id", id) : -1);
+        if (subnet) {
+            if (!subnets) {
+                subnets = Element::createList();
+                parent->set(subnet_name, subnets);
+            }
+            if (index < 0) {
+                subnets->add(subnet);
+            } else {
+                subnets->set(index, subnet);
+            }
+        } else if (index >= 0) {
+            subnets->remove(index);
+            // The full translation does not produce empty lists.
+            if (subnets->empty()) {
+                parent->remove(subnet_name);
+            }
+        }
+    }
+    return (result);
+}
+
 ElementPtr
 TranslatorConfig::getConfigIetf6() {
     ElementPtr result = Element::createMap();
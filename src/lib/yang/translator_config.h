@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,6 +14,9 @@
 #include <yang/translator_logger.h>
 #include <yang/translator_shared_network.h>
 
+#include <set>
+#include <string>
+
 namespace isc {
 namespace yang {
 
@@ -429,6 +432,37 @@ public:
     /// @param elem The JSON element.
     void setConfig(isc::data::ElementPtr elem);
 
+    /// @brief Translate the changed subnets of a configuration.
+    ///
+    /// Only the given subnet entries are translated from YANG and patched
+    /// into a copy of a configuration translated before the changes: the
+    /// rest of the datastore is not read. A subnet entry which no longer
+    /// exists is removed.
+    ///
+    /// @param config The JSON configuration translated before the changes.
+    /// @param xpaths The xpaths of the changed subnet entries, as returned
+    /// by @ref getSubnetXpath.
+    /// @return The updated JSON configuration, or null when it can't be
+    /// updated incrementally, e.g. the shared network of a subnet is not
+    /// in the configuration.
+    /// @throw NetconfError when sysrepo raises an error.
+    isc::data::ElementPtr updateSubnets(isc::data::ConstElementPtr config,
+                                        std::set<std::string> const& xpaths);
+
+    /// @brief Get the xpath of the subnet entry holding a node.
+    ///
+    /// Only kea-dhcp4-server and kea-dhcp6-server are supported.
+    ///
+    /// @param model The model name.
+    /// @param path The xpath of a node, e.g. of a changed leaf.
+    /// @param xpath Set to the xpath of the subnet entry, e.g.
+    /// "/kea-dhcp4-server:config/subnet4[id='1']".
+    /// @return true if the node belongs to a subnet entry, at the top level
+    /// or in a shared network.
+    static bool getSubnetXpath(std::string const& model,
+                               std::string const& path,
+                               std::string& xpath);
+
 protected:
     /// @brief getConfig for ietf-dhcpv6-server.
     ///
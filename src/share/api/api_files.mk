@@ -8,6 +8,9 @@ api_files += $(top_srcdir)/src/share/api/cache-load.json
 api_files += $(top_srcdir)/src/share/api/cache-remove.json
 api_files += $(top_srcdir)/src/share/api/cache-size.json
 api_files += $(top_srcdir)/src/share/api/cache-write.json
+api_files += $(top_srcdir)/src/share/api/callout-timing-get.json
+api_files += $(top_srcdir)/src/share/api/callout-timing-reset.json
+api_files += $(top_srcdir)/src/share/api/callout-timing-set.json
 api_files += $(top_srcdir)/src/share/api/class-add.json
 api_files += $(top_srcdir)/src/share/api/class-del.json
 api_files += $(top_srcdir)/src/share/api/class-get.json
@@ -40,8 +43,11 @@ api_files += $(top_srcdir)/src/share/api/ha-reset.json
 api_files += $(top_srcdir)/src/share/api/ha-scopes.json
 api_files += $(top_srcdir)/src/share/api/ha-sync-complete-notify.json
 api_files += $(top_srcdir)/src/share/api/ha-sync.json
+api_files += $(top_srcdir)/src/share/api/lease-export-status.json
 api_files += $(top_srcdir)/src/share/api/lease4-add.json
+api_files += $(top_srcdir)/src/share/api/lease4-bulk-apply.json
 api_files += $(top_srcdir)/src/share/api/lease4-del.json
+api_files += $(top_srcdir)/src/share/api/lease4-export.json
 api_files += $(top_srcdir)/src/share/api/lease4-get-all.json
 api_files += $(top_srcdir)/src/share/api/lease4-get-by-client-id.json
 api_files += $(top_srcdir)/src/share/api/lease4-get-by-hostname.json
@@ -55,6 +61,7 @@ api_files += $(top_srcdir)/src/share/api/lease4-write.json
 api_files += $(top_srcdir)/src/share/api/lease6-add.json
 api_files += $(top_srcdir)/src/share/api/lease6-bulk-apply.json
 api_files += $(top_srcdir)/src/share/api/lease6-del.json
+api_files += $(top_srcdir)/src/share/api/lease6-export.json
 api_files += $(top_srcdir)/src/share/api/lease6-get-all.json
 api_files += $(top_srcdir)/src/share/api/lease6-get-by-duid.json
 api_files += $(top_srcdir)/src/share/api/lease6-get-by-hostname.json
@@ -67,6 +74,7 @@ api_files += $(top_srcdir)/src/share/api/lease6-write.json
 api_files += $(top_srcdir)/src/share/api/leases-reclaim.json
 api_files += $(top_srcdir)/src/share/api/libreload.json
 api_files += $(top_srcdir)/src/share/api/list-commands.json
+api_files += $(top_srcdir)/src/share/api/memory-stats.json
 api_files += $(top_srcdir)/src/share/api/network4-add.json
 api_files += $(top_srcdir)/src/share/api/network4-del.json
 api_files += $(top_srcdir)/src/share/api/network4-get.json
@@ -166,6 +174,7 @@ api_files += $(top_srcdir)/src/share/api/stat-lease4-get.json
 api_files += $(top_srcdir)/src/share/api/stat-lease6-get.json
 api_files += $(top_srcdir)/src/share/api/statistic-get-all.json
 api_files += $(top_srcdir)/src/share/api/statistic-get.json
+api_files += $(top_srcdir)/src/share/api/statistic-latency-get.json
 api_files += $(top_srcdir)/src/share/api/statistic-remove-all.json
 api_files += $(top_srcdir)/src/share/api/statistic-remove.json
 api_files += $(top_srcdir)/src/share/api/statistic-reset-all.json